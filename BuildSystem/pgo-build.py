@@ -0,0 +1,226 @@
+#!/usr/bin/env python
+
+"""Builds the libraries with profile-guided optimization, using the benchmark
+executables as training workloads.
+
+    python BuildSystem/pgo-build.py [scons arguments...]
+
+Runs three steps for each project in dependency order:
+
+  1. Build with PGO=instrument, which produces binaries that record execution counts
+  2. Run all benchmark executables so the hot paths of the libraries get counted
+  3. Rebuild with PGO=optimize, letting the compiler lay out code by those counts
+
+Additional arguments (such as -j8 or TARGET_ARCH=amd64) are passed through to SCons."""
+
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Projects in the order they need to be built (Nuclex.Storage links Nuclex.Support)
+projects = [
+    'Nuclex.Support.Native',
+    'Nuclex.Storage.Native',
+    'Nuclex.Pixels.Native'
+]
+
+# Arguments the benchmarks are run with. The training run only needs to visit
+# the hot paths often enough, not produce reliable timings.
+benchmark_arguments = [ '--min-time=0.05' ]
+
+# ----------------------------------------------------------------------------------------------- #
+
+def get_scons_command():
+    """Determines the command through which SCons can be invoked
+
+    @returns A list holding the SCons executable or Python with the SCons module"""
+
+    scons_path = shutil.which('scons')
+    if scons_path is None:
+        return [ sys.executable, '-m', 'SCons' ]
+    else:
+        return [ scons_path ]
+
+# ----------------------------------------------------------------------------------------------- #
+
+def build_projects(root_directory, pgo_mode, profile_directory, arguments):
+    """Builds all projects with the specified profile-guided optimization step
+
+    @param  root_directory     Directory holding the project directories
+    @param  pgo_mode           Either 'instrument' or 'optimize'
+    @param  profile_directory  Absolute path of the directory for clang's profiles
+    @param  arguments          Additional arguments that will be passed to SCons"""
+
+    for project in projects:
+        print('Building ' + project + ' with PGO=' + pgo_mode)
+        subprocess.check_call(
+            get_scons_command() + [
+                'PGO=' + pgo_mode,
+                'PGO_DIRECTORY=' + profile_directory
+            ] + arguments,
+            cwd = os.path.join(root_directory, project)
+        )
+
+# ----------------------------------------------------------------------------------------------- #
+
+def delete_profiles(root_directory, profile_directory):
+    """Deletes the execution counts collected so far
+
+    @param  root_directory     Directory holding the project directories
+    @param  profile_directory  Directory in which clang's profiles are collected
+    @remarks
+        The unit tests run as part of each build. They exercise error paths far more
+        often than real use does, so their counts would mislead the optimizer."""
+
+    for project in projects:
+        for directory, subdirectories, files in os.walk(os.path.join(root_directory, project)):
+            for file in files:
+                if file.endswith('.gcda'):
+                    os.remove(os.path.join(directory, file))
+
+    if os.path.isdir(profile_directory):
+        for file in os.listdir(profile_directory):
+            if file.endswith('.profraw') or file.endswith('.profdata'):
+                os.remove(os.path.join(profile_directory, file))
+
+# ----------------------------------------------------------------------------------------------- #
+
+def run_benchmarks(root_directory):
+    """Runs the benchmark executables produced by the instrumented build
+
+    @param  root_directory  Directory holding the project directories"""
+
+    for project in projects:
+        artifact_directory = os.path.join(root_directory, project, 'bin')
+        if not os.path.isdir(artifact_directory):
+            continue
+
+        for build_directory in os.listdir(artifact_directory):
+            build_path = os.path.join(artifact_directory, build_directory)
+            if not (build_directory.endswith('-release') and os.path.isdir(build_path)):
+                continue
+
+            for file in os.listdir(build_path):
+                file_path = os.path.join(build_path, file)
+                if ('Benchmarks' in file) and os.access(file_path, os.X_OK):
+                    print('Training with ' + file_path)
+                    subprocess.check_call(
+                        [ file_path ] + benchmark_arguments, cwd = build_path
+                    )
+
+# ----------------------------------------------------------------------------------------------- #
+
+def merge_gcda_file(source_path, target_path):
+    """Adds the execution counts from one GCC profile into another
+
+    @param  source_path  Path of the .gcda file whose counts will be added
+    @param  target_path  Path of the .gcda file receiving the counts"""
+
+    if not os.path.exists(target_path):
+        os.makedirs(os.path.dirname(target_path), exist_ok = True)
+        shutil.copyfile(source_path, target_path)
+        return
+
+    # gcov-tool only merges whole directories, so give each file its own
+    with tempfile.TemporaryDirectory() as temporary_directory:
+        file_name = os.path.basename(target_path)
+        first_directory = os.path.join(temporary_directory, 'first')
+        second_directory = os.path.join(temporary_directory, 'second')
+        merged_directory = os.path.join(temporary_directory, 'merged')
+        os.makedirs(first_directory)
+        os.makedirs(second_directory)
+        shutil.copyfile(source_path, os.path.join(first_directory, file_name))
+        shutil.copyfile(target_path, os.path.join(second_directory, file_name))
+
+        subprocess.check_call(
+            [ 'gcov-tool', 'merge', '-o', merged_directory, first_directory, second_directory ]
+        )
+        shutil.copyfile(os.path.join(merged_directory, file_name), target_path)
+
+# ----------------------------------------------------------------------------------------------- #
+
+def merge_gcc_profiles(root_directory):
+    """Carries the execution counts GCC recorded for the benchmarks over to the libraries
+
+    @param  root_directory  Directory holding the project directories
+    @remarks
+        The benchmarks compile the library's sources into their own intermediate
+        directory (obj/<build>-benchmarks), so GCC writes the counts next to those
+        object files. The library is compiled in obj/<build>, where -fprofile-use
+        will look for them."""
+
+    for project in projects:
+        intermediate_directory = os.path.join(root_directory, project, 'obj')
+        if not os.path.isdir(intermediate_directory):
+            continue
+
+        for variant_directory in os.listdir(intermediate_directory):
+            build_directory, separator, suffix = variant_directory.partition('-release-')
+            if not suffix.endswith('benchmarks'):
+                continue
+
+            # Only the library's sources are shared, the benchmark's own code isn't
+            source_root = os.path.join(intermediate_directory, variant_directory)
+            target_root = os.path.join(intermediate_directory, build_directory + '-release')
+            for directory, subdirectories, files in os.walk(os.path.join(source_root, 'Source')):
+                for file in files:
+                    if file.endswith('.gcda'):
+                        source_path = os.path.join(directory, file)
+                        target_path = os.path.join(
+                            target_root, os.path.relpath(source_path, source_root)
+                        )
+                        merge_gcda_file(source_path, target_path)
+
+# ----------------------------------------------------------------------------------------------- #
+
+def merge_clang_profiles(profile_directory):
+    """Combines the raw profiles clang recorded into the file -fprofile-use reads
+
+    @param  profile_directory  Directory in which clang's profiles were collected"""
+
+    if not os.path.isdir(profile_directory):
+        return
+
+    raw_profiles = [
+        os.path.join(profile_directory, file)
+        for file in os.listdir(profile_directory) if file.endswith('.profraw')
+    ]
+    if len(raw_profiles) > 0:
+        subprocess.check_call(
+            [
+                'llvm-profdata', 'merge',
+                '-output=' + os.path.join(profile_directory, 'default.profdata')
+            ] + raw_profiles
+        )
+
+# ----------------------------------------------------------------------------------------------- #
+
+def main(arguments):
+    """Runs the instrument, train and optimize steps
+
+    @param  arguments  Command line arguments that will be passed through to SCons"""
+
+    if platform.system() == 'Windows':
+        print('Profile-guided optimization builds are only supported with GCC and clang')
+        return 1
+
+    root_directory = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    profile_directory = os.path.join(root_directory, 'pgo')
+
+    build_projects(root_directory, 'instrument', profile_directory, arguments)
+    delete_profiles(root_directory, profile_directory)
+    run_benchmarks(root_directory)
+
+    merge_gcc_profiles(root_directory)
+    merge_clang_profiles(profile_directory)
+
+    build_projects(root_directory, 'optimize', profile_directory, arguments)
+    return 0
+
+# ----------------------------------------------------------------------------------------------- #
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -246,6 +246,35 @@ def _parse_default_command_line_options():
         )
     )
 
+    # Link-time optimization for release builds
+    command_line_variables.Add(
+        BoolVariable(
+            'LTO',
+            'Whether to optimize across compilation units when linking release builds',
+            True
+        )
+    )
+
+    # Profile-guided optimization for release builds
+    command_line_variables.Add(
+        EnumVariable(
+            'PGO',
+            'Whether to build with profiling instrumentation or optimize using a profile',
+            'off',
+            allowed_values=('off', 'instrument', 'optimize')
+        )
+    )
+
+    # Directory for clang's execution profiles (GCC writes them next to the object files)
+    command_line_variables.Add(
+        PathVariable(
+            'PGO_DIRECTORY',
+            'Directory in which clang execution profiles will be collected',
+            'pgo',
+            PathVariable.PathAccept
+        )
+    )
+
     return command_line_variables
 
 # ----------------------------------------------------------------------------------------------- #
@@ -318,6 +347,100 @@ def _is_debug_build(environment):
 
 # ----------------------------------------------------------------------------------------------- #
 
+def _is_lto_build(environment):
+    """Checks whether link-time optimization should be used
+
+    @param  environment  Environment whose settings will be checked for link-time optimization
+    @returns True if this is a release build with link-time optimization enabled"""
+
+    if _is_debug_build(environment):
+        return False
+    elif 'LTO' in environment:
+        return environment['LTO']
+    else:
+        return True
+
+# ----------------------------------------------------------------------------------------------- #
+
+def _get_pgo_mode(environment):
+    """Looks up the profile-guided optimization step that has been requested
+
+    @param  environment  Environment whose settings will be checked for the PGO step
+    @returns 'off', 'instrument' or 'optimize'"""
+
+    if _is_debug_build(environment):
+        return 'off'
+    elif 'PGO' in environment:
+        return environment['PGO']
+    else:
+        return 'off'
+
+# ----------------------------------------------------------------------------------------------- #
+
+def _set_profile_guided_optimization_flags(environment):
+    """Sets up the compiler and linker flags for profile-guided optimization
+
+    @param  environment  Environment in which the PGO flags will be set
+    @remarks
+        With PGO=instrument, the binaries count how often each branch and function
+        is taken and write the counts to disk when they exit. With PGO=optimize,
+        the counts are used to lay out and inline code for the paths that are hot.
+
+        GCC keeps the counts in a .gcda file next to each object file. Executables
+        that compile the library's sources into their own intermediate directory
+        (the benchmarks) thus produce counts that need to be merged into the library's
+        intermediate directory before the optimize step. BuildSystem/pgo-build.py
+        automates the whole cycle."""
+
+    pgo_mode = _get_pgo_mode(environment)
+    if pgo_mode == 'off':
+        return
+
+    compiler_name = cplusplus.get_compiler_name(environment)
+    if compiler_name == 'clang':
+        profile_directory = Dir(environment['PGO_DIRECTORY']).abspath
+        if pgo_mode == 'instrument':
+            generate_flag = '-fprofile-generate=' + profile_directory
+            environment.Append(CFLAGS=generate_flag) # Record execution counts
+            environment.Append(CXXFLAGS=generate_flag) # Record execution counts
+            environment.Append(LINKFLAGS=generate_flag) # Link the profiling runtime
+        else:
+            use_flag = '-fprofile-use=' + os.path.join(profile_directory, 'default.profdata')
+            environment.Append(CFLAGS=use_flag) # Optimize using execution counts
+            environment.Append(CXXFLAGS=use_flag) # Optimize using execution counts
+            environment.Append(LINKFLAGS=use_flag) # Optimize using execution counts
+            environment.Append(CFLAGS='-Wno-profile-instr-unprofiled') # Untrained files are fine
+            environment.Append(CXXFLAGS='-Wno-profile-instr-unprofiled') # Untrained files are fine
+            environment.Append(CFLAGS='-Wno-profile-instr-out-of-date') # Edits since training
+            environment.Append(CXXFLAGS='-Wno-profile-instr-out-of-date') # Edits since training
+
+    elif compiler_name == 'gcc':
+        if pgo_mode == 'instrument':
+            environment.Append(CFLAGS='-fprofile-generate') # Record execution counts
+            environment.Append(CXXFLAGS='-fprofile-generate') # Record execution counts
+            environment.Append(LINKFLAGS='-fprofile-generate') # Link the profiling runtime
+        else:
+            environment.Append(CFLAGS='-fprofile-use') # Optimize using execution counts
+            environment.Append(CXXFLAGS='-fprofile-use') # Optimize using execution counts
+            environment.Append(LINKFLAGS='-fprofile-use') # Optimize using execution counts
+            environment.Append(CFLAGS='-fprofile-correction') # Tolerate racy multithreaded counts
+            environment.Append(CXXFLAGS='-fprofile-correction') # Tolerate racy threaded counts
+            environment.Append(CFLAGS='-Wno-missing-profile') # Untrained files are fine
+            environment.Append(CXXFLAGS='-Wno-missing-profile') # Untrained files are fine
+            environment.Append(CFLAGS='-Wno-coverage-mismatch') # Edits since training
+            environment.Append(CXXFLAGS='-Wno-coverage-mismatch') # Edits since training
+
+    else:
+        print('Profile-guided optimization is not supported for this compiler, ignoring PGO')
+        return
+
+    # Lets executables flush their execution counts from processes that end without
+    # running the exit handlers (such as forked children calling _exit())
+    if pgo_mode == 'instrument':
+        environment.Append(CPPDEFINES=['NUCLEX_PGO_INSTRUMENTED'])
+
+# ----------------------------------------------------------------------------------------------- #
+
 def _set_standard_cplusplus_compiler_flags(environment):
     """Sets up standard flags for the compiler
 
@@ -359,7 +482,6 @@ def _set_standard_cplusplus_compiler_flags(environment):
             environment.Append(CFLAGS='/Oy') # Omit frame pointers
             environment.Append(CFLAGS='/Oi') # Enable intrinsic functions
             environment.Append(CFLAGS='/Gy') # Function-level linking for better trimming
-            environment.Append(CFLAGS='/GL') # Whole program optimizaton (merged build)
             environment.Append(CFLAGS='/MD') # Link shared multithreaded release runtime
             environment.Append(CFLAGS='/Gw') # Enable whole-program *data* optimization
 
@@ -367,10 +489,18 @@ def _set_standard_cplusplus_compiler_flags(environment):
             environment.Append(CXXFLAGS='/Oy') # Omit frame pointers
             environment.Append(CXXFLAGS='/Oi') # Enable intrinsic functions
             environment.Append(CXXFLAGS='/Gy') # Function-level linking for better trimming
-            environment.Append(CXXFLAGS='/GL') # Whole program optimizaton (merged build)
             environment.Append(CXXFLAGS='/MD') # Link shared multithreaded release runtime
             environment.Append(CXXFLAGS='/Gw') # Enable whole-program *data* optimization
 
+            if _is_lto_build(environment):
+                environment.Append(CFLAGS='/GL') # Whole program optimizaton (merged build)
+                environment.Append(CXXFLAGS='/GL') # Whole program optimizaton (merged build)
+
+            # The benchmarks compile the library sources into themselves, so MSVC's .pgd
+            # databases, which belong to the linked binary, can't be carried over
+            if _get_pgo_mode(environment) != 'off':
+                print('Profile-guided optimization is not supported with MSVC, ignoring PGO')
+
     else:
         environment.Append(CFLAGS='-fvisibility=hidden') # Default visibility: don't export
         environment.Append(CFLAGS='-Wpedantic') # Enable all ISO C++ deviation warnings
@@ -408,10 +538,13 @@ def _set_standard_cplusplus_compiler_flags(environment):
             environment.Append(CXXFLAGS='-ggdb') # Target the GDB debugger
         else:
             environment.Append(CFLAGS='-O3') # Optimize for speed
-            environment.Append(CFLAGS='-flto') # Merge all code before compiling
-
             environment.Append(CXXFLAGS='-O3') # Optimize for speed
-            environment.Append(CXXFLAGS='-flto') # Merge all code before compiling
+
+            if _is_lto_build(environment):
+                environment.Append(CFLAGS='-flto') # Merge all code before compiling
+                environment.Append(CXXFLAGS='-flto') # Merge all code before compiling
+
+            _set_profile_guided_optimization_flags(environment)
 
 # ----------------------------------------------------------------------------------------------- #
 
@@ -421,16 +554,15 @@ def _set_standard_cplusplus_linker_flags(environment):
     @param  environment  Environment in which the C++ compiler linker wlll be set."""
 
     if platform.system() == 'Windows':
-        if _is_debug_build(environment):
-            pass
-        else:
+        if _is_lto_build(environment):
             environment.Append(LINKFLAGS='/LTCG') # Merge all code before compiling
             environment.Append(LIBFLAGS='/LTCG') # Merge all code before compiling
 
     else:
         environment.Append(LINKFLAGS='-z defs') # Detect unresolved symbols in shared object
         environment.Append(LINKFLAGS='-Bsymbolic') # Prevent replacement on shared object syms
-        environment.Append(LINKFLAGS='-flto') # Compile all code in one unit at link time
+        if _is_lto_build(environment):
+            environment.Append(LINKFLAGS='-flto') # Compile all code in one unit at link time
         #environment.Append(LINKFLAGS='--gc-sections') # Remove unused code and data sections
 
 # ----------------------------------------------------------------------------------------------- #
@@ -0,0 +1,737 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "BenchmarkRunner.h"
+
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/BitmapSampler.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/PixelIterator.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Storage/LoadOptions.h"
+#include "Nuclex/Pixels/Storage/SaveOptions.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+
+#include <cstdint> // for std::uint8_t, std::uint32_t
+#include <cstdio> // for std::printf()
+#include <cstdlib> // for std::atof()
+#include <cstring> // for std::memcpy(), std::strcmp(), std::strncmp()
+#include <exception> // for std::exception
+#include <memory> // for std::unique_ptr
+#include <random> // for std::mt19937
+#include <stdexcept> // for std::out_of_range
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Image size in the benchmark corpus</summary>
+  struct CorpusSize {
+
+    /// <summary>Width of the images in pixels</summary>
+    public: std::size_t Width;
+    /// <summary>Height of the images in pixels</summary>
+    public: std::size_t Height;
+    /// <summary>Name under which the size appears in the results</summary>
+    public: const char *Name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>File format in the benchmark corpus</summary>
+  struct CorpusFileFormat {
+
+    /// <summary>File extension that selects the codec</summary>
+    public: const char *Extension;
+    /// <summary>Pixel format the bitmaps will be saved in</summary>
+    public: Nuclex::Pixels::PixelFormat PixelFormat;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel format conversion that will be measured</summary>
+  struct CorpusConversion {
+
+    /// <summary>Pixel format the pixels are converted from</summary>
+    public: Nuclex::Pixels::PixelFormat SourcePixelFormat;
+    /// <summary>Pixel format the pixels are converted to</summary>
+    public: Nuclex::Pixels::PixelFormat TargetPixelFormat;
+    /// <summary>Name under which the conversion appears in the results</summary>
+    public: const char *Name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Image sizes all benchmarks are run with, from icons to 8K video frames</summary>
+  const CorpusSize CorpusSizes[] = {
+    { 16, 16, u8"16x16" },
+    { 256, 256, u8"256x256" },
+    { 1024, 1024, u8"1024x1024" },
+    { 3840, 2160, u8"3840x2160" },
+    { 7680, 4320, u8"7680x4320" }
+  };
+
+  /// <summary>Number of image sizes that are used in quick runs</summary>
+  const std::size_t QuickCorpusSizeCount = 3;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>File formats the load and save benchmarks are run with</summary>
+  const CorpusFileFormat CorpusFileFormats[] = {
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+    { u8"png", Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned },
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+    { u8"jpg", Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned },
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_OPENEXR)
+    { u8"exr", Nuclex::Pixels::PixelFormat::R16_G16_B16_A16_Float_Native16 },
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+    { u8"webp", Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned },
+#endif
+    { u8"qoi", Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned },
+    { u8"dds", Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned },
+    { u8"tga", Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned },
+    { u8"bmp", Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned },
+    { u8"ppm", Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned },
+    { u8"pfm", Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32 }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel format conversions that will be measured</summary>
+  const CorpusConversion CorpusConversions[] = {
+    {
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+      Nuclex::Pixels::PixelFormat::B8_G8_R8_A8_Unsigned,
+      u8"RGBA8->BGRA8"
+    },
+    {
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned,
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+      u8"RGB8->RGBA8"
+    },
+    {
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+      Nuclex::Pixels::PixelFormat::R8_Unsigned,
+      u8"RGBA8->R8"
+    },
+    {
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+      Nuclex::Pixels::PixelFormat::R5_G6_B5_Unsigned_Native16,
+      u8"RGBA8->R5G6B5"
+    },
+    {
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+      Nuclex::Pixels::PixelFormat::R16_G16_B16_A16_Float_Native16,
+      u8"RGBA8->RGBA16F"
+    },
+    {
+      Nuclex::Pixels::PixelFormat::R16_G16_B16_A16_Float_Native16,
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+      u8"RGBA16F->RGBA8"
+    },
+    {
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+      Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32,
+      u8"RGBA8->RGBA32F"
+    },
+    {
+      Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32,
+      Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+      u8"RGBA32F->RGBA8"
+    }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Growable file kept in memory that saved images are written into</summary>
+  class MemoryBufferFile : public Nuclex::Pixels::Storage::VirtualFile {
+
+    /// <summary>Initializes a new, empty memory buffer file</summary>
+    public: MemoryBufferFile() :
+      contents() {}
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: virtual ~MemoryBufferFile() = default;
+
+    /// <summary>Provides access to the contents of the file</summary>
+    /// <returns>A vector holding the bytes written into the file</returns>
+    public: const std::vector<std::uint8_t> &GetContents() const { return this->contents; }
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override {
+      if((start > this->contents.size()) || (byteCount > this->contents.size() - start)) {
+        throw std::out_of_range(u8"Attempted to read beyond the end of the file");
+      }
+      if(byteCount > 0) {
+        std::memcpy(buffer, this->contents.data() + start, byteCount);
+      }
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Attempted to write beyond the end of the file");
+      }
+      std::size_t end = static_cast<std::size_t>(start) + byteCount;
+      if(end > this->contents.size()) {
+        this->contents.resize(end);
+      }
+      if(byteCount > 0) {
+        std::memcpy(this->contents.data() + start, buffer, byteCount);
+      }
+    }
+
+    /// <summary>Bytes that have been written into the file</summary>
+    private: std::vector<std::uint8_t> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates an image for the benchmark corpus</summary>
+  /// <param name="width">Width of the image in pixels</param>
+  /// <param name="height">Height of the image in pixels</param>
+  /// <param name="pixelFormat">Pixel format the image will have</param>
+  /// <returns>The new image</returns>
+  /// <remarks>
+  ///   The images are smooth gradients with a bit of noise, which gives compressing codecs
+  ///   about as much work as a photo. The noise is generated with a fixed seed, so all
+  ///   runs of the benchmark work on the same pixels.
+  /// </remarks>
+  Nuclex::Pixels::Bitmap createCorpusImage(
+    std::size_t width, std::size_t height, Nuclex::Pixels::PixelFormat pixelFormat
+  ) {
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::BitmapMemory;
+
+    Bitmap image(width, height, Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned);
+    const BitmapMemory &memory = image.Access();
+
+    std::uint32_t noise = 2463534242U;
+    for(std::size_t y = 0; y < height; ++y) {
+      std::uint8_t *pixel = static_cast<std::uint8_t *>(memory.Pixels) + (y * memory.Stride);
+      for(std::size_t x = 0; x < width; ++x) {
+        noise ^= noise << 13;
+        noise ^= noise >> 17;
+        noise ^= noise << 5;
+
+        pixel[0] = static_cast<std::uint8_t>((x * 255 / width) ^ (noise & 7));
+        pixel[1] = static_cast<std::uint8_t>((y * 255 / height) ^ ((noise >> 3) & 7));
+        pixel[2] = static_cast<std::uint8_t>(((x + y) * 127 / (width + height)) + (noise >> 28));
+        pixel[3] = 255;
+        pixel += 4;
+      }
+    }
+
+    if(pixelFormat == Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned) {
+      return image;
+    }
+
+    Bitmap converted(width, height, pixelFormat);
+    Nuclex::Pixels::PixelFormatConverter::Convert(image.Access(), converted.Access());
+    return converted;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the bytes the pixels of a bitmap occupy</summary>
+  /// <param name="bitmap">Bitmap whose pixels will be counted</param>
+  /// <returns>The number of bytes the bitmap's pixels occupy without padding</returns>
+  std::size_t countPixelBytes(const Nuclex::Pixels::Bitmap &bitmap) {
+    return (
+      Nuclex::Pixels::CountRequiredBytes(bitmap.GetPixelFormat(), bitmap.GetWidth()) *
+      bitmap.GetHeight()
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures loading, saving and identifying images in all file formats</summary>
+  /// <param name="runner">Benchmark runner that will take the measurements</param>
+  /// <param name="sizeCount">Number of corpus sizes that will be measured</param>
+  void measureSerializer(
+    Nuclex::Pixels::Benchmarks::BenchmarkRunner &runner, std::size_t sizeCount
+  ) {
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::Storage::BitmapSerializer;
+    using Nuclex::Pixels::Storage::VirtualFile;
+
+    BitmapSerializer serializer;
+
+    for(const CorpusFileFormat &fileFormat : CorpusFileFormats) {
+      std::string extension(fileFormat.Extension);
+
+      for(std::size_t sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex) {
+        const CorpusSize &size = CorpusSizes[sizeIndex];
+        std::string suffix = u8" " + extension + u8" " + size.Name;
+        if(
+          !runner.IsSelected(u8"Save" + suffix) &&
+          !runner.IsSelected(u8"Load" + suffix) &&
+          !runner.IsSelected(u8"TryReadInfo" + suffix)
+        ) {
+          continue;
+        }
+
+        Bitmap image = createCorpusImage(size.Width, size.Height, fileFormat.PixelFormat);
+        std::size_t pixelCount = size.Width * size.Height;
+        std::size_t pixelByteCount = countPixelBytes(image);
+
+        // Saving once up front both provides the file for the load benchmarks
+        // and finds out whether the codec can save this image at all
+        MemoryBufferFile savedFile;
+        try {
+          serializer.Save(image, savedFile, extension);
+        }
+        catch(const std::exception &error) {
+          std::printf(u8"  Skipping%s: %s\n", suffix.c_str(), error.what());
+          continue;
+        }
+
+        runner.Measure(
+          u8"Save" + suffix, pixelCount, pixelByteCount,
+          [&serializer, &image, &extension]() {
+            MemoryBufferFile file;
+            serializer.Save(image, file, extension);
+          }
+        );
+
+        const std::vector<std::uint8_t> &contents = savedFile.GetContents();
+        std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(
+          contents.data(), contents.size()
+        );
+
+        runner.Measure(
+          u8"Load" + suffix, pixelCount, pixelByteCount,
+          [&serializer, &file, &extension]() {
+            Bitmap loaded = serializer.Load(*file, extension);
+            (void)loaded;
+          }
+        );
+
+        runner.Measure(
+          u8"TryReadInfo" + suffix, 0, 0, // Only reads the header, independent of size
+          [&serializer, &file, &extension]() {
+            serializer.TryReadInfo(*file, extension);
+          }
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures decoding PNG images with and without checksum verification</summary>
+  /// <param name="runner">Benchmark runner that will take the measurements</param>
+  /// <param name="sizeCount">Number of corpus sizes that will be measured</param>
+  /// <remarks>
+  ///   The images are saved with maximum compression, like texture atlases shipped with
+  ///   an application would be, so decoding them is dominated by inflating the data.
+  ///   This shows the effect of skipping the checksums and of building against a faster
+  ///   zlib (such as zlib-ng) when compared to a baseline.
+  /// </remarks>
+  void measurePngDecode(
+    Nuclex::Pixels::Benchmarks::BenchmarkRunner &runner, std::size_t sizeCount
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::Storage::BitmapSerializer;
+    using Nuclex::Pixels::Storage::LoadOptions;
+    using Nuclex::Pixels::Storage::SaveOptions;
+    using Nuclex::Pixels::Storage::VirtualFile;
+
+    BitmapSerializer serializer;
+
+    for(std::size_t sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex) {
+      const CorpusSize &size = CorpusSizes[sizeIndex];
+      std::string verifiedName = std::string(u8"PngDecode verified ") + size.Name;
+      std::string trustedName = std::string(u8"PngDecode trusted ") + size.Name;
+      if(!runner.IsSelected(verifiedName) && !runner.IsSelected(trustedName)) {
+        continue;
+      }
+
+      Bitmap image = createCorpusImage(
+        size.Width, size.Height, Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned
+      );
+      std::size_t pixelCount = size.Width * size.Height;
+      std::size_t pixelByteCount = countPixelBytes(image);
+
+      MemoryBufferFile savedFile;
+      {
+        SaveOptions saveOptions;
+        saveOptions.Png = Nuclex::Pixels::Storage::PngSaveOptions::Small();
+        serializer.Save(image, savedFile, u8"png", saveOptions);
+      }
+
+      const std::vector<std::uint8_t> &contents = savedFile.GetContents();
+      std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(
+        contents.data(), contents.size()
+      );
+
+      LoadOptions verifiedOptions;
+      runner.Measure(
+        verifiedName, pixelCount, pixelByteCount,
+        [&serializer, &file, &verifiedOptions]() {
+          Bitmap loaded = serializer.Load(*file, u8"png", verifiedOptions);
+          (void)loaded;
+        }
+      );
+
+      LoadOptions trustedOptions;
+      trustedOptions.Png.VerifyChecksums = false;
+      runner.Measure(
+        trustedName, pixelCount, pixelByteCount,
+        [&serializer, &file, &trustedOptions]() {
+          Bitmap loaded = serializer.Load(*file, u8"png", trustedOptions);
+          (void)loaded;
+        }
+      );
+    }
+#else
+    (void)runner;
+    (void)sizeCount;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures encoding PNG images with libpng and on a thread pool</summary>
+  /// <param name="runner">Benchmark runner that will take the measurements</param>
+  /// <param name="sizeCount">Number of corpus sizes that will be measured</param>
+  /// <remarks>
+  ///   Images too small to be split into several strips are written by libpng
+  ///   either way, so only the larger corpus sizes show a difference.
+  /// </remarks>
+  void measurePngEncode(
+    Nuclex::Pixels::Benchmarks::BenchmarkRunner &runner, std::size_t sizeCount
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::ThreadPool;
+    using Nuclex::Pixels::Storage::BitmapSerializer;
+    using Nuclex::Pixels::Storage::SaveOptions;
+
+    BitmapSerializer serializer;
+    ThreadPool threadPool;
+
+    for(std::size_t sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex) {
+      const CorpusSize &size = CorpusSizes[sizeIndex];
+      std::string serialName = std::string(u8"PngEncode serial ") + size.Name;
+      std::string parallelName = std::string(u8"PngEncode parallel ") + size.Name;
+      if(!runner.IsSelected(serialName) && !runner.IsSelected(parallelName)) {
+        continue;
+      }
+
+      Bitmap image = createCorpusImage(
+        size.Width, size.Height, Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned
+      );
+      std::size_t pixelCount = size.Width * size.Height;
+      std::size_t pixelByteCount = countPixelBytes(image);
+
+      SaveOptions serialOptions;
+      runner.Measure(
+        serialName, pixelCount, pixelByteCount,
+        [&serializer, &image, &serialOptions]() {
+          MemoryBufferFile file;
+          serializer.Save(image, file, u8"png", serialOptions);
+        }
+      );
+
+      SaveOptions parallelOptions;
+      parallelOptions.Png.ThreadPool = &threadPool;
+      runner.Measure(
+        parallelName, pixelCount, pixelByteCount,
+        [&serializer, &image, &parallelOptions]() {
+          MemoryBufferFile file;
+          serializer.Save(image, file, u8"png", parallelOptions);
+        }
+      );
+    }
+#else
+    (void)runner;
+    (void)sizeCount;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures converting between pixel formats</summary>
+  /// <param name="runner">Benchmark runner that will take the measurements</param>
+  /// <param name="sizeCount">Number of corpus sizes that will be measured</param>
+  void measureConversions(
+    Nuclex::Pixels::Benchmarks::BenchmarkRunner &runner, std::size_t sizeCount
+  ) {
+    using Nuclex::Pixels::Bitmap;
+
+    for(const CorpusConversion &conversion : CorpusConversions) {
+      for(std::size_t sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex) {
+        const CorpusSize &size = CorpusSizes[sizeIndex];
+        std::string name = std::string(u8"Convert ") + conversion.Name + u8" " + size.Name;
+        if(!runner.IsSelected(name)) {
+          continue;
+        }
+
+        Bitmap source = createCorpusImage(
+          size.Width, size.Height, conversion.SourcePixelFormat
+        );
+        Bitmap target(size.Width, size.Height, conversion.TargetPixelFormat);
+
+        runner.Measure(
+          name, size.Width * size.Height, countPixelBytes(source),
+          [&source, &target]() {
+            Nuclex::Pixels::PixelFormatConverter::Convert(source.Access(), target.Access());
+          }
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures visiting all pixels of a bitmap with the pixel iterator</summary>
+  /// <param name="runner">Benchmark runner that will take the measurements</param>
+  /// <param name="sizeCount">Number of corpus sizes that will be measured</param>
+  void measurePixelIterator(
+    Nuclex::Pixels::Benchmarks::BenchmarkRunner &runner, std::size_t sizeCount
+  ) {
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::PixelIterator;
+
+    for(std::size_t sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex) {
+      const CorpusSize &size = CorpusSizes[sizeIndex];
+      std::string name = std::string(u8"PixelIterator RGBA8 ") + size.Name;
+      if(!runner.IsSelected(name)) {
+        continue;
+      }
+
+      Bitmap image = createCorpusImage(
+        size.Width, size.Height, Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned
+      );
+
+      // The sum goes into a volatile so the compiler can't optimize the traversal away
+      volatile std::uint32_t checksum = 0;
+      runner.Measure(
+        name, size.Width * size.Height, countPixelBytes(image),
+        [&image, &checksum]() {
+          const Nuclex::Pixels::BitmapMemory &memory = image.Access();
+          PixelIterator iterator = PixelIterator::GetBegin(memory);
+          PixelIterator end = PixelIterator::GetEnd(memory);
+
+          std::uint32_t sum = 0;
+          while(iterator != end) {
+            sum += *static_cast<const std::uint8_t *>(*iterator);
+            ++iterator;
+          }
+          checksum = sum;
+        }
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures sampling a bitmap at scattered coordinates</summary>
+  /// <param name="runner">Benchmark runner that will take the measurements</param>
+  /// <param name="sizeCount">Number of corpus sizes that will be measured</param>
+  void measureSampler(
+    Nuclex::Pixels::Benchmarks::BenchmarkRunner &runner, std::size_t sizeCount
+  ) {
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::BitmapSampler;
+    using Nuclex::Pixels::SamplingFilter;
+
+    // Random coordinates defeat the caches like a rasterizer drawing rotated,
+    // perspective-distorted triangles would
+    const std::size_t sampleCount = 65536;
+    std::vector<float> u(sampleCount), v(sampleCount);
+    {
+      std::mt19937 randomNumberGenerator(1234);
+      std::uniform_real_distribution<float> coordinates(0.0f, 1.0f);
+      for(std::size_t index = 0; index < sampleCount; ++index) {
+        u[index] = coordinates(randomNumberGenerator);
+        v[index] = coordinates(randomNumberGenerator);
+      }
+    }
+    std::vector<std::uint8_t> rgba(sampleCount * 4);
+
+    for(std::size_t sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex) {
+      const CorpusSize &size = CorpusSizes[sizeIndex];
+      std::string nearestName = std::string(u8"Sample nearest RGBA8 ") + size.Name;
+      std::string bilinearName = std::string(u8"Sample bilinear RGBA8 ") + size.Name;
+      if(!runner.IsSelected(nearestName) && !runner.IsSelected(bilinearName)) {
+        continue;
+      }
+
+      Bitmap image = createCorpusImage(
+        size.Width, size.Height, Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned
+      );
+
+      if(runner.IsSelected(nearestName)) {
+        BitmapSampler sampler(image.Access(), SamplingFilter::Nearest);
+        runner.Measure(
+          nearestName, sampleCount, sampleCount * 4,
+          [&sampler, &u, &v, &rgba]() {
+            sampler.Sample(u.data(), v.data(), u.size(), rgba.data());
+          }
+        );
+      }
+      if(runner.IsSelected(bilinearName)) {
+        BitmapSampler sampler(image.Access(), SamplingFilter::Bilinear);
+        runner.Measure(
+          bilinearName, sampleCount, sampleCount * 4,
+          [&sampler, &u, &v, &rgba]() {
+            sampler.Sample(u.data(), v.data(), u.size(), rgba.data());
+          }
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a command line argument is an option and extracts its value</summary>
+  /// <param name="argument">Command line argument that will be checked</param>
+  /// <param name="option">Option including the equals sign, i.e. "--save="</param>
+  /// <param name="value">Receives the value of the option if the argument is the option</param>
+  /// <returns>True if the argument was the specified option</returns>
+  bool tryGetOption(const char *argument, const char *option, std::string &value) {
+    std::size_t optionLength = std::strlen(option);
+    if(std::strncmp(argument, option, optionLength) != 0) {
+      return false;
+    }
+
+    value.assign(argument + optionLength);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints the command line options of the benchmark executable</summary>
+  void printUsage() {
+    std::printf(
+      u8"Measures the throughput of Nuclex.Pixels on a generated image corpus\n"
+      u8"\n"
+      u8"Options:\n"
+      u8"  --quick               Only use images up to 1024x1024\n"
+      u8"  --filter=<text>       Only run benchmarks whose name contains the text\n"
+      u8"  --min-time=<seconds>  Minimum time to repeat each benchmark for (default 0.5)\n"
+      u8"  --save=<path>         Save the results for later comparison\n"
+      u8"  --baseline=<path>     Compare against results saved by an earlier run\n"
+      u8"  --tolerance=<percent> Slowdown above which a result counts as regression\n"
+      u8"                        (default 10)\n"
+      u8"\n"
+      u8"Exits with 1 if any benchmark regressed compared to the baseline.\n"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+int main(int argumentCount, char *arguments[]) {
+  bool quick = false;
+  std::string filter;
+  double minimumSeconds = 0.5;
+  std::string savePath;
+  std::string baselinePath;
+  double tolerancePercent = 10.0;
+
+  for(int index = 1; index < argumentCount; ++index) {
+    std::string value;
+    if(std::strcmp(arguments[index], u8"--quick") == 0) {
+      quick = true;
+    } else if(tryGetOption(arguments[index], u8"--filter=", value)) {
+      filter = value;
+    } else if(tryGetOption(arguments[index], u8"--min-time=", value)) {
+      minimumSeconds = std::atof(value.c_str());
+    } else if(tryGetOption(arguments[index], u8"--save=", value)) {
+      savePath = value;
+    } else if(tryGetOption(arguments[index], u8"--baseline=", value)) {
+      baselinePath = value;
+    } else if(tryGetOption(arguments[index], u8"--tolerance=", value)) {
+      tolerancePercent = std::atof(value.c_str());
+    } else {
+      printUsage();
+      return 2;
+    }
+  }
+
+  std::size_t sizeCount = sizeof(CorpusSizes) / sizeof(CorpusSizes[0]);
+  if(quick) {
+    sizeCount = QuickCorpusSizeCount;
+  }
+
+  try {
+    Nuclex::Pixels::Benchmarks::BenchmarkRunner runner(minimumSeconds, filter);
+
+    measureSerializer(runner, sizeCount);
+    measurePngDecode(runner, sizeCount);
+    measurePngEncode(runner, sizeCount);
+    measureConversions(runner, sizeCount);
+    measurePixelIterator(runner, sizeCount);
+    measureSampler(runner, sizeCount);
+
+    runner.PrintResults(stdout);
+
+    if(!savePath.empty()) {
+      runner.SaveResults(savePath);
+    }
+    if(!baselinePath.empty()) {
+      std::size_t regressionCount = runner.CompareToBaseline(
+        baselinePath, tolerancePercent / 100.0, stdout
+      );
+      if(regressionCount > 0) {
+        std::printf(u8"\n%u benchmark(s) regressed\n", static_cast<unsigned>(regressionCount));
+        return 1;
+      }
+    }
+  }
+  catch(const std::exception &error) {
+    std::fprintf(stderr, u8"Benchmark failed: %s\n", error.what());
+    return 2;
+  }
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_ALPHACOMPOSITOR_H
+#define NUCLEX_PIXELS_ALPHACOMPOSITOR_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Premultiplies bitmaps by their alpha channel and composites them</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Works on the <see cref="PixelFormat.R8_G8_B8_A8_Unsigned" />,
+  ///     <see cref="PixelFormat.B8_G8_R8_A8_Unsigned" /> and
+  ///     <see cref="PixelFormat.R32_G32_B32_A32_Float" /> pixel formats. Pixels are
+  ///     processed as they are stored, no gamma correction happens.
+  ///   </para>
+  ///   <para>
+  ///     For 8 bit channels, results are rounded exactly as if they had been calculated
+  ///     with real numbers, so premultiplying is equivalent to round(color * alpha / 255).
+  ///     The division by 255 is done with a multiply and shift on four (SSE2) or eight
+  ///     (NEON) pixels at once. Unpremultiplying looks up a fixed point reciprocal of
+  ///     the alpha value instead of dividing.
+  ///   </para>
+  ///   <para>
+  ///     Compositing uses the Porter-Duff "over" operator and expects both bitmaps to
+  ///     be premultiplied. The composited result is premultiplied as well.
+  ///   </para>
+  /// </remarks>
+  class AlphaCompositor {
+
+    /// <summary>Checks whether bitmaps in a pixel format can be processed</summary>
+    /// <param name="pixelFormat">Pixel format that will be checked</param>
+    /// <returns>True if bitmaps using the pixel format can be processed</returns>
+    public: NUCLEX_PIXELS_API static bool CanComposite(PixelFormat pixelFormat);
+
+    /// <summary>Multiplies the color channels of a row of pixels by their alpha</summary>
+    /// <param name="pixelFormat">Pixel format the pixels are stored in</param>
+    /// <param name="pixels">Address of the first pixel that will be premultiplied</param>
+    /// <param name="pixelCount">Number of pixels that will be premultiplied</param>
+    public: NUCLEX_PIXELS_API static void PremultiplyRow(
+      PixelFormat pixelFormat, void *pixels, std::size_t pixelCount
+    );
+
+    /// <summary>Divides the color channels of a row of pixels by their alpha</summary>
+    /// <param name="pixelFormat">Pixel format the pixels are stored in</param>
+    /// <param name="pixels">Address of the first pixel that will be unpremultiplied</param>
+    /// <param name="pixelCount">Number of pixels that will be unpremultiplied</param>
+    /// <remarks>
+    ///   Fully transparent pixels become black. Color channels larger than the alpha
+    ///   channel (which a premultiplied pixel can't have) end up at full intensity.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void UnpremultiplyRow(
+      PixelFormat pixelFormat, void *pixels, std::size_t pixelCount
+    );
+
+    /// <summary>Composites a row of pixels over another row of pixels</summary>
+    /// <param name="pixelFormat">Pixel format both rows are stored in</param>
+    /// <param name="sourcePixels">Address of the first pixel that will be drawn</param>
+    /// <param name="targetPixels">Address of the first pixel that will be drawn onto</param>
+    /// <param name="pixelCount">Number of pixels that will be composited</param>
+    public: NUCLEX_PIXELS_API static void CompositeRowOver(
+      PixelFormat pixelFormat, const void *sourcePixels, void *targetPixels,
+      std::size_t pixelCount
+    );
+
+    /// <summary>Multiplies the color channels of a bitmap by its alpha channel</summary>
+    /// <param name="memory">Bitmap memory that will be premultiplied</param>
+    public: NUCLEX_PIXELS_API static void Premultiply(const BitmapMemory &memory);
+
+    /// <summary>Multiplies the color channels of a bitmap by its alpha in parallel</summary>
+    /// <param name="memory">Bitmap memory that will be premultiplied</param>
+    /// <param name="threadPool">Thread pool that will share the work</param>
+    public: NUCLEX_PIXELS_API static void Premultiply(
+      const BitmapMemory &memory, ThreadPool &threadPool
+    );
+
+    /// <summary>Divides the color channels of a bitmap by its alpha channel</summary>
+    /// <param name="memory">Bitmap memory that will be unpremultiplied</param>
+    public: NUCLEX_PIXELS_API static void Unpremultiply(const BitmapMemory &memory);
+
+    /// <summary>Divides the color channels of a bitmap by its alpha in parallel</summary>
+    /// <param name="memory">Bitmap memory that will be unpremultiplied</param>
+    /// <param name="threadPool">Thread pool that will share the work</param>
+    public: NUCLEX_PIXELS_API static void Unpremultiply(
+      const BitmapMemory &memory, ThreadPool &threadPool
+    );
+
+    /// <summary>Composites a bitmap over another bitmap</summary>
+    /// <param name="source">Bitmap memory that will be drawn</param>
+    /// <param name="target">Bitmap memory that will be drawn onto</param>
+    /// <remarks>
+    ///   Both bitmaps must have the same dimensions and pixel format. To composite
+    ///   a smaller bitmap onto part of a larger one, pass a view of the larger bitmap
+    ///   (see <see cref="Bitmap.GetView" />).
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void CompositeOver(
+      const BitmapMemory &source, const BitmapMemory &target
+    );
+
+    /// <summary>Composites a bitmap over another bitmap in parallel</summary>
+    /// <param name="source">Bitmap memory that will be drawn</param>
+    /// <param name="target">Bitmap memory that will be drawn onto</param>
+    /// <param name="threadPool">Thread pool that will share the work</param>
+    public: NUCLEX_PIXELS_API static void CompositeOver(
+      const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_ALPHACOMPOSITOR_H
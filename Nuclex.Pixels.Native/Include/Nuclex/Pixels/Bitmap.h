@@ -23,8 +23,11 @@ License along with this library
 
 #include "Nuclex/Pixels/Config.h"
 #include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/BitmapAllocator.h"
+#include "Nuclex/Pixels/DirtyRegionTracker.h"
 
 #include <cstddef>
+#include <vector>
 
 namespace Nuclex { namespace Pixels {
 
@@ -50,6 +53,16 @@ namespace Nuclex { namespace Pixels {
   ///     system allows a bitmaps to make itself autonomous, allocating its own memory
   ///     block and storing a unique copy of all pixels it was referencing.
   ///   </para>
+  ///   <para>
+  ///     The memory of bitmaps is obtained from a <see cref="BitmapAllocator" />. Copies
+  ///     of a bitmap and autonomized views use the same allocator as the original.
+  ///   </para>
+  ///   <para>
+  ///     Bitmaps sharing memory keep track of their owners with an atomic counter,
+  ///     so views can be handed to other threads and created or destroyed there
+  ///     without copying any pixels. Each individual bitmap instance, like any other
+  ///     object, must not be modified by multiple threads at once.
+  ///   </para>
   /// </remarks>
   class Bitmap {
 
@@ -66,6 +79,21 @@ namespace Nuclex { namespace Pixels {
     /// </remarks>
     public: NUCLEX_PIXELS_API static Bitmap FromExistingMemory(const BitmapMemory &bitmapMemory);
 
+    /// <summary>Calculates the stride a bitmap with the specified layout would use</summary>
+    /// <param name="width">Width of the bitmap in pixels</param>
+    /// <param name="pixelFormat">Pixel format in which the pixels will be stored</param>
+    /// <param name="rowAlignment">Alignment of each row in bytes, 0 for none</param>
+    /// <returns>The number of bytes from the start of one row to the next</returns>
+    /// <remarks>
+    ///   Useful for setting up externally allocated memory, for example an upload buffer
+    ///   whose rows have to satisfy the graphics API's pitch alignment, that images are
+    ///   then loaded into via <see cref="FromExistingMemory" />. Like with the constructor,
+    ///   the row alignment is ignored for block-compressed pixel formats.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static int CalculateStride(
+      std::size_t width, PixelFormat pixelFormat, std::size_t rowAlignment = 0
+    );
+
     /// <summary>Initializes a new bitmap</summary>
     /// <param name="width">Width of the bitmap in pixels</param>
     /// <param name="height">Height of the bitmap in pixels</param>
@@ -76,6 +104,43 @@ namespace Nuclex { namespace Pixels {
       PixelFormat pixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned
     );
 
+    /// <summary>Initializes a new bitmap using memory from the specified allocator</summary>
+    /// <param name="width">Width of the bitmap in pixels</param>
+    /// <param name="height">Height of the bitmap in pixels</param>
+    /// <param name="pixelFormat">Pixel format in which the pixels will be stored</param>
+    /// <param name="allocator">
+    ///   Allocator that will provide the bitmap's memory. Needs to outlive the bitmap
+    ///   and all views, copies or autonomized views created from it.
+    /// </param>
+    /// <param name="rowAlignment">
+    ///   Number of bytes the address of each row will be aligned to, 0 to store
+    ///   rows tightly packed. Must be a power of two.
+    /// </param>
+    /// <remarks>
+    ///   <para>
+    ///     By default, rows are tightly packed and only the first row is aligned
+    ///     to 16 bytes. When processing bitmaps with SIMD code, aligning each row to
+    ///     a cache line (<see cref="CacheLineByteCount" />) pads the stride so that
+    ///     no row starts in the middle of a cache line and aligned loads can be used.
+    ///   </para>
+    ///   <para>
+    ///     Copies and autonomized views of the bitmap keep the row alignment. Views
+    ///     (see <see cref="GetView" />) that do not start at the left border of
+    ///     the bitmap are, naturally, not aligned.
+    ///   </para>
+    ///   <para>
+    ///     Block-compressed bitmaps (see <see cref="GetBlockSize" />) are always stored
+    ///     tightly packed, the row alignment is ignored for them.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_PIXELS_API Bitmap(
+      std::size_t width,
+      std::size_t height,
+      PixelFormat pixelFormat,
+      BitmapAllocator &allocator,
+      std::size_t rowAlignment = 0
+    );
+
     /// <summary>Constructs an bitmap as a copy of an existing bitmap</summary>
     /// <param name="other">Bitmap that will be copied</param>
     public: NUCLEX_PIXELS_API Bitmap(const Bitmap &other);
@@ -111,6 +176,114 @@ namespace Nuclex { namespace Pixels {
       return this->memory;
     }
 
+    /// <summary>Accesses the bitmap's pixels with the intent to modify them</summary>
+    /// <returns>A description of the bitmap's memory layout</returns>
+    /// <remarks>
+    ///   If the bitmap is in copy-on-write mode (see <see cref="EnableCopyOnWrite" />)
+    ///   and shares its memory with other bitmaps, it will be autonomized before its
+    ///   memory is returned, so changes to the pixels do not affect the other bitmaps.
+    ///   Otherwise this is identical to <see cref="Access" />.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API const BitmapMemory &AccessMutable();
+
+    /// <summary>Accesses the bitmap's pixels with the intent to modify a region</summary>
+    /// <param name="region">Region of the bitmap whose pixels will be modified</param>
+    /// <returns>A description of the bitmap's memory layout</returns>
+    /// <remarks>
+    ///   Behaves like <see cref="AccessMutable" />, but if the bitmap is tracking dirty
+    ///   regions (see <see cref="EnableDirtyTracking" />), only the specified region is
+    ///   marked as modified rather than the whole bitmap.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API const BitmapMemory &AccessMutable(const Rectangle &region);
+
+    /// <summary>Starts remembering which regions of the bitmap are modified</summary>
+    /// <param name="tileSize">
+    ///   Width and height of the tiles in which modifications are tracked
+    /// </param>
+    /// <remarks>
+    ///   <para>
+    ///     Once enabled, <see cref="AccessMutable" /> and the <see cref="BitmapBlitter" />
+    ///     methods taking a bitmap mark the regions they hand out or write to as dirty.
+    ///     Consumers such as a remote display or a texture streamer can then encode or
+    ///     upload only the regions returned by <see cref="GetDirtyRegions" /> and call
+    ///     <see cref="ClearDirtyRegions" /> afterwards.
+    ///   </para>
+    ///   <para>
+    ///     Tracking starts with all tiles clean. Copies of the bitmap take over its dirty
+    ///     regions, views (see <see cref="GetView" />) do not track anything on their own,
+    ///     so modifications through a view have to be marked on the parent bitmap via
+    ///     <see cref="MarkDirty" />. Writes through <see cref="Access" /> are not noticed.
+    ///   </para>
+    ///   <para>
+    ///     Image file codecs and row streams (see <see cref="RowSource" />) always process
+    ///     whole images and ignore the tracking. <see cref="FrameDelta.Encode" /> accepts
+    ///     the tracker from <see cref="GetDirtyRegionTracker" /> and only encodes dirty tiles.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_PIXELS_API void EnableDirtyTracking(
+      std::size_t tileSize = DirtyRegionTracker::DefaultTileSize
+    );
+
+    /// <summary>Stops remembering which regions of the bitmap are modified</summary>
+    public: NUCLEX_PIXELS_API void DisableDirtyTracking();
+
+    /// <summary>Checks whether the bitmap is remembering which regions are modified</summary>
+    /// <returns>True if dirty region tracking is enabled</returns>
+    public: bool IsTrackingDirtyRegions() const {
+      return (this->dirtyRegionTracker != nullptr);
+    }
+
+    /// <summary>Accesses the tracker that remembers the modified regions</summary>
+    /// <returns>The dirty region tracker or a null pointer if tracking is disabled</returns>
+    /// <remarks>
+    ///   Useful for consumers that process the bitmap tile by tile and want to skip
+    ///   unmodified tiles rather than work with merged rectangles.
+    /// </remarks>
+    public: const DirtyRegionTracker *GetDirtyRegionTracker() const {
+      return this->dirtyRegionTracker;
+    }
+
+    /// <summary>Marks a region of the bitmap as modified</summary>
+    /// <param name="region">Region whose pixels have been modified</param>
+    /// <remarks>Does nothing if dirty region tracking is disabled</remarks>
+    public: NUCLEX_PIXELS_API void MarkDirty(const Rectangle &region);
+
+    /// <summary>Returns the regions of the bitmap that have been modified</summary>
+    /// <returns>
+    ///   Non-overlapping rectangles covering all modified pixels, empty if nothing has
+    ///   been modified or dirty region tracking is disabled
+    /// </returns>
+    public: NUCLEX_PIXELS_API std::vector<Rectangle> GetDirtyRegions() const;
+
+    /// <summary>Forgets all regions that have been marked as modified so far</summary>
+    public: NUCLEX_PIXELS_API void ClearDirtyRegions();
+
+    /// <summary>Switches the bitmap into or out of copy-on-write mode</summary>
+    /// <param name="enable">True to enable copy-on-write mode, false to disable it</param>
+    /// <remarks>
+    ///   <para>
+    ///     Bitmaps in copy-on-write mode share their memory with copies made of them
+    ///     instead of cloning their pixels right away. The first bitmap that modifies
+    ///     the shared pixels through <see cref="AccessMutable" /> receives its own copy,
+    ///     making it cheap to pass bitmaps by value through stages that only read them.
+    ///   </para>
+    ///   <para>
+    ///     Copies inherit the mode of the bitmap they were copied from. Views (see
+    ///     <see cref="GetView" />) do not because they are meant to modify their parent.
+    ///     Writing to a bitmap's memory through <see cref="Access" /> bypasses
+    ///     copy-on-write and changes the pixels of all bitmaps sharing it.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_PIXELS_API void EnableCopyOnWrite(bool enable = true) {
+      this->copyOnWrite = enable;
+    }
+
+    /// <summary>Checks whether the bitmap is in copy-on-write mode</summary>
+    /// <returns>True if copies of the bitmap share its memory until modified</returns>
+    public: NUCLEX_PIXELS_API bool IsCopyOnWrite() const {
+      return this->copyOnWrite;
+    }
+
     /// <summary>
     ///   If the bitmap is sharing memory with another bitmap, forces it to create
     ///   its own copy of the image data
@@ -176,7 +349,6 @@ namespace Nuclex { namespace Pixels {
     public: NUCLEX_PIXELS_API Bitmap GetView(
       std::size_t x, std::size_t y, std::size_t width, std::size_t height
     );
-#if 0
     /// <summary>Returns the amount of memory used by the bitmap</summary>
     /// <returns>The number of bytes used to store the bitmap's pixels</returns>
     /// <remarks>
@@ -186,11 +358,51 @@ namespace Nuclex { namespace Pixels {
     ///     due to alignment and a header, or much higher if the bitmap is a region
     ///     within a larger bitmap.
     ///   </para>
+    ///   <para>
+    ///     Bitmaps accessing externally managed memory only report the size of
+    ///     the header they allocated to keep track of the external memory.
+    ///   </para>
     /// </remarks>
     public: NUCLEX_PIXELS_API std::size_t GetMemoryUsed() const;
 
-    public: NUCLEX_PIXELS_API bool IsWastingMemory() const;
-#endif
+    /// <summary>Checks whether the bitmap is holding onto more memory than it needs</summary>
+    /// <param name="toleratedByteCount">
+    ///   Number of bytes the bitmap may use above a tight fit before it counts as wasting
+    /// </param>
+    /// <returns>True if the bitmap is the sole owner of an oversized memory buffer</returns>
+    /// <remarks>
+    ///   This happens to views that outlive the bitmap they were created from. As long
+    ///   as other bitmaps share the memory buffer, it is still put to use and the view is
+    ///   not considered to be wasting memory. Bitmaps accessing externally managed memory
+    ///   never are, either.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API bool IsWastingMemory(std::size_t toleratedByteCount = 0) const;
+
+    /// <summary>Moves the bitmap into a right-sized buffer if it is wasting memory</summary>
+    /// <param name="toleratedByteCount">
+    ///   Number of bytes the bitmap may use above a tight fit before it is compacted
+    /// </param>
+    /// <returns>True if the bitmap was compacted, false if it was left as it is</returns>
+    /// <remarks>
+    ///   Uses the same check as <see cref="IsWastingMemory" />. If it says the bitmap
+    ///   is wasting memory, its pixels are copied into a new buffer just large enough to
+    ///   hold them (as <see cref="Autonomize" /> would do) and the oversized buffer is freed.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API bool CompactIfWasting(std::size_t toleratedByteCount = 0);
+
+    /// <summary>Counts the bytes currently allocated by all bitmaps</summary>
+    /// <returns>The number of bytes held by the memory buffers of all live bitmaps</returns>
+    /// <remarks>
+    ///   Buffers shared by several bitmaps are only counted once. Intended for
+    ///   monitoring, the value is updated with relaxed atomics and may lag behind
+    ///   allocations happening on other threads at the time it is read.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::size_t GetLiveByteCount();
+
+    /// <summary>Counts the memory buffers currently held by bitmaps</summary>
+    /// <returns>The number of memory buffers owned by live bitmaps</returns>
+    public: NUCLEX_PIXELS_API static std::size_t GetLiveBufferCount();
+
     /// <summary>Copies another bitmap instance into this one</summary>
     /// <param name="other">Other bitmap instance that will be copied</param>
     /// <returns>This bitmap instance</returns>
@@ -201,6 +413,13 @@ namespace Nuclex { namespace Pixels {
     /// <returns>This bitmap instance</returns>
     public: NUCLEX_PIXELS_API Bitmap &operator =(Bitmap &&other);
 
+    /// <summary>Size of a cache line on current CPUs in bytes</summary>
+    /// <remarks>
+    ///   Suitable as row alignment for bitmaps that will be processed by SIMD code
+    ///   and large enough for the aligned loads of all current SIMD extensions.
+    /// </remarks>
+    public: static const std::size_t CacheLineByteCount = 64;
+
     /// <summary>Detachable memory buffer that allows for shared ownership</summary>
     private: struct SharedBuffer;
 
@@ -212,14 +431,21 @@ namespace Nuclex { namespace Pixels {
     /// <summary>Creates a new detachable buffer for a bitmap of the specified size</summary>
     /// <param name="resolution">Resolution for which a buffer will be created</param>
     /// <param name="pixelFormat">Pixel format usd by the bitmap</param>
+    /// <param name="allocator">Allocator that will provide the buffer's memory</param>
+    /// <param name="rowAlignment">Alignment of each row in bytes, 0 for none</param>
     private: static SharedBuffer *newSharedBuffer(
-      const Size &resolution, PixelFormat pixelFormat
+      const Size &resolution, PixelFormat pixelFormat,
+      BitmapAllocator &allocator, std::size_t rowAlignment
     );
 
     /// <summary>Creates a new detachable buffer by copying an existing buffer</summary>
     /// <param name="memory">Existing bitmap memory that will be copied</param>
+    /// <param name="allocator">Allocator that will provide the buffer's memory</param>
+    /// <param name="rowAlignment">Alignment of each row in bytes, 0 for none</param>
     /// <returns>A new detachable buffer with a copy of the existing buffer's contents</returns>
-    private: static SharedBuffer *newSharedBuffer(const BitmapMemory &memory);
+    private: static SharedBuffer *newSharedBuffer(
+      const BitmapMemory &memory, BitmapAllocator &allocator, std::size_t rowAlignment
+    );
 
     /// <summary>Releases a shared buffer, freeing its memory if possible</summary>
     /// <param name="buffer">Buffer that will be released</param>
@@ -229,6 +455,10 @@ namespace Nuclex { namespace Pixels {
     private: BitmapMemory memory; 
     /// <summary>Memory buffer holding or accessing the bitmap's pixels</summary>
     private: SharedBuffer *buffer;
+    /// <summary>Whether copies share memory until either one is modified</summary>
+    private: bool copyOnWrite;
+    /// <summary>Remembers the modified regions, null if tracking is disabled</summary>
+    private: DirtyRegionTracker *dirtyRegionTracker;
 
   };
 
@@ -0,0 +1,86 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BITMAPALLOCATOR_H
+#define NUCLEX_PIXELS_BITMAPALLOCATOR_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides the memory in which bitmaps store their pixels</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each bitmap that owns its pixels obtains a single memory block from an allocator,
+  ///     holding a small header followed by the pixels. Unless a bitmap is constructed with
+  ///     a specific allocator, the default allocator (see <see cref="GetDefault" />) is used.
+  ///   </para>
+  ///   <para>
+  ///     The memory block is returned to the same allocator it was obtained from when
+  ///     the last bitmap sharing it is destroyed, so an allocator has to outlive all bitmaps
+  ///     that are using it. Allocators can be called from multiple threads at once.
+  ///   </para>
+  /// </remarks>
+  class BitmapAllocator {
+
+    /// <summary>Returns the allocator bitmaps use when none is specified</summary>
+    /// <returns>The current default allocator</returns>
+    public: NUCLEX_PIXELS_API static BitmapAllocator &GetDefault();
+
+    /// <summary>Changes the allocator bitmaps use when none is specified</summary>
+    /// <param name="allocator">
+    ///   Allocator that will be used from now on, null to use plain new[] and delete[]
+    /// </param>
+    /// <remarks>
+    ///   Bitmaps that have already been created keep using the allocator they obtained
+    ///   their memory from, so the previous default allocator may not be destroyed
+    ///   until all bitmaps created through it are gone.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void SetDefault(BitmapAllocator *allocator);
+
+    /// <summary>Frees all resources owned by the allocator</summary>
+    public: NUCLEX_PIXELS_API virtual ~BitmapAllocator() = default;
+
+    /// <summary>Allocates a memory block for a bitmap</summary>
+    /// <param name="byteCount">Number of bytes the memory block needs to have</param>
+    /// <returns>
+    ///   The address of the memory block, aligned at least as well as memory from new[]
+    /// </returns>
+    /// <remarks>
+    ///   If no memory can be allocated, an exception (usually std::bad_alloc) is thrown.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API virtual void *Allocate(std::size_t byteCount) = 0;
+
+    /// <summary>Frees a memory block that has been obtained from the allocator</summary>
+    /// <param name="memory">Address of the memory block that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were requested for the block</param>
+    public: NUCLEX_PIXELS_API virtual void Free(void *memory, std::size_t byteCount) throw() = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPALLOCATOR_H
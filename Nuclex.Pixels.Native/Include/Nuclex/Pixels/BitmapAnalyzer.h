@@ -0,0 +1,167 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BITMAPANALYZER_H
+#define NUCLEX_PIXELS_BITMAPANALYZER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/BitmapStatistics.h"
+
+#include <cstddef>
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>
+  ///   Gathers statistics, builds histograms and computes perceptual hashes of bitmaps
+  /// </summary>
+  /// <remarks>
+  ///   <para>
+  ///     Supports the pixel formats with 8 bit unsigned, 16 bit unsigned, half or float
+  ///     channels in the platform's native byte order. The statistics for 8 bit channels
+  ///     and float channels (half channels are converted to floats in small chunks) are
+  ///     gathered with SSE2 or NEON instructions.
+  ///   </para>
+  ///   <para>
+  ///     Histograms are counted into four interleaved sub-histograms, so consecutive
+  ///     pixels falling into the same bin do not have to wait for each other's increment
+  ///     to reach memory. With a thread pool, bitmaps are split into bands of rows that
+  ///     are processed in parallel and the results of all bands are combined afterwards.
+  ///     The results are identical to those of single-threaded processing.
+  ///   </para>
+  ///   <para>
+  ///     The perceptual hashes summarize what an image looks like in 64 bits, so images
+  ///     that were resized, recompressed or slightly adjusted end up with hashes that only
+  ///     differ in a few bits. They work on any pixel format the pixel format converter
+  ///     can turn into floats (see <see cref="PixelFormatConverter" />). To hash JPEG files
+  ///     without decoding them at full resolution, use <see cref="Storage.ImageHasher" />.
+  ///   </para>
+  /// </remarks>
+  class BitmapAnalyzer {
+
+    /// <summary>Checks whether bitmaps in the specified pixel format can be analyzed</summary>
+    /// <param name="pixelFormat">Pixel format that will be checked</param>
+    /// <returns>True if statistics and histograms can be made for the pixel format</returns>
+    public: NUCLEX_PIXELS_API static bool CanAnalyze(PixelFormat pixelFormat);
+
+    /// <summary>Determines the minimum, maximum, sum and mean of each channel</summary>
+    /// <param name="memory">Bitmap memory holding the pixels that will be analyzed</param>
+    /// <returns>The statistics of all channels in the bitmap</returns>
+    public: NUCLEX_PIXELS_API static BitmapStatistics GatherStatistics(
+      const BitmapMemory &memory
+    );
+
+    /// <summary>Determines the minimum, maximum, sum and mean of each channel</summary>
+    /// <param name="memory">Bitmap memory holding the pixels that will be analyzed</param>
+    /// <param name="threadPool">Thread pool that will process bands of rows</param>
+    /// <returns>The statistics of all channels in the bitmap</returns>
+    public: NUCLEX_PIXELS_API static BitmapStatistics GatherStatistics(
+      const BitmapMemory &memory, ThreadPool &threadPool
+    );
+
+    /// <summary>Counts how many pixels fall into each value range of a channel</summary>
+    /// <param name="memory">Bitmap memory holding the pixels that will be counted</param>
+    /// <param name="channelIndex">
+    ///   Index of the channel that will be counted in the order the channels are stored
+    /// </param>
+    /// <param name="bins">Receives the number of pixels in each value range</param>
+    /// <param name="binCount">Number of value ranges the channel will be split into</param>
+    /// <param name="minimum">Lower end of the first value range</param>
+    /// <param name="maximum">Upper end of the last value range</param>
+    /// <remarks>
+    ///   The ranges between the minimum and maximum are evenly sized, values outside
+    ///   are counted in the first or last bin. Integer channels are normalized to 0.0
+    ///   to 1.0 first, so with the defaults and 256 bins, each value of an 8 bit channel
+    ///   gets a bin of its own.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void BuildHistogram(
+      const BitmapMemory &memory, std::size_t channelIndex,
+      std::size_t *bins, std::size_t binCount,
+      float minimum = 0.0f, float maximum = 1.0f
+    );
+
+    /// <summary>Counts how many pixels fall into each value range of a channel</summary>
+    /// <param name="memory">Bitmap memory holding the pixels that will be counted</param>
+    /// <param name="channelIndex">
+    ///   Index of the channel that will be counted in the order the channels are stored
+    /// </param>
+    /// <param name="bins">Receives the number of pixels in each value range</param>
+    /// <param name="binCount">Number of value ranges the channel will be split into</param>
+    /// <param name="threadPool">Thread pool that will process bands of rows</param>
+    /// <param name="minimum">Lower end of the first value range</param>
+    /// <param name="maximum">Upper end of the last value range</param>
+    public: NUCLEX_PIXELS_API static void BuildHistogram(
+      const BitmapMemory &memory, std::size_t channelIndex,
+      std::size_t *bins, std::size_t binCount, ThreadPool &threadPool,
+      float minimum = 0.0f, float maximum = 1.0f
+    );
+
+    /// <summary>Computes a difference hash (dHash) of a bitmap</summary>
+    /// <param name="memory">Bitmap memory holding the pixels that will be hashed</param>
+    /// <returns>A 64 bit hash describing the brightness gradients in the bitmap</returns>
+    /// <remarks>
+    ///   The bitmap is reduced to 9 by 8 luminance values by averaging areas of pixels.
+    ///   Each bit of the hash tells whether one of these values is brighter than its
+    ///   right neighbor, starting with the top left one in the most significant bit.
+    ///   Fast and robust against scaling and brightness or contrast changes.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::uint64_t ComputeDifferenceHash(
+      const BitmapMemory &memory
+    );
+
+    /// <summary>Computes a DCT-based perceptual hash (pHash) of a bitmap</summary>
+    /// <param name="memory">Bitmap memory holding the pixels that will be hashed</param>
+    /// <returns>A 64 bit hash describing the low frequencies in the bitmap</returns>
+    /// <remarks>
+    ///   The bitmap is reduced to 32 by 32 luminance values, then a discrete cosine
+    ///   transform is done on these. Each bit of the hash tells whether one of the 8 by 8
+    ///   lowest frequencies (leaving out the constant terms) is above their median.
+    ///   Slower than the difference hash, but also tolerates blurring, noise and
+    ///   compression artifacts much better.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::uint64_t ComputePerceptualHash(
+      const BitmapMemory &memory
+    );
+
+    /// <summary>Counts the bits in which two hashes differ (their hamming distance)</summary>
+    /// <param name="hash">Hash that will be compared</param>
+    /// <param name="otherHash">Other hash the first will be compared against</param>
+    /// <returns>The number of bits that are different between the two hashes</returns>
+    /// <remarks>
+    ///   Images whose hashes differ in up to about 10 bits are usually duplicates.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::size_t CountDifferentBits(
+      std::uint64_t hash, std::uint64_t otherHash
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPANALYZER_H
@@ -0,0 +1,186 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BITMAPBLITTER_H
+#define NUCLEX_PIXELS_BITMAPBLITTER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/Rectangle.h"
+#include "Nuclex/Pixels/ColorModels/RgbColor.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Bitmap;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies, fills and compares rectangular areas of pixels</summary>
+  /// <remarks>
+  ///   <para>
+  ///     If both bitmaps use the same pixel format, each row is copied with a single
+  ///     memcpy(). If, in addition, the rows of both bitmaps lie back to back without
+  ///     any padding (which is the case when whole bitmaps without row alignment are
+  ///     copied), the entire area is copied in one memcpy().
+  ///   </para>
+  ///   <para>
+  ///     Otherwise the pixels are converted by the <see cref="PixelFormatConverter" />
+  ///     while being copied, which uses SIMD kernels for the common format combinations.
+  ///     The source and target areas must not overlap.
+  ///   </para>
+  ///   <para>
+  ///     Filling encodes the color once and then writes whole rows with memset() if all
+  ///     bytes of the pixel are identical or with memcpy() from a row built in advance
+  ///     otherwise. Comparisons use memcmp() on each row. All of these respect the stride,
+  ///     so they work on views into larger bitmaps without touching the pixels around them.
+  ///   </para>
+  ///   <para>
+  ///     The overloads writing into a <see cref="Bitmap" /> instead of bitmap memory
+  ///     obtain the memory via <see cref="Bitmap.AccessMutable" />, so copy-on-write
+  ///     bitmaps are detached and, if the bitmap tracks dirty regions, exactly the pixels
+  ///     written are marked as modified.
+  ///   </para>
+  /// </remarks>
+  class BitmapBlitter {
+
+    /// <summary>Copies all pixels of a bitmap into another bitmap</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the pixels will be written to</param>
+    /// <param name="targetX">X coordinate in the target bitmap of the first pixel</param>
+    /// <param name="targetY">Y coordinate in the target bitmap of the first pixel</param>
+    public: NUCLEX_PIXELS_API static void Blit(
+      const BitmapMemory &source,
+      const BitmapMemory &target, std::size_t targetX = 0, std::size_t targetY = 0
+    );
+
+    /// <summary>Copies a rectangular area of pixels from one bitmap into another</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="sourceRegion">Area in the source bitmap that will be copied</param>
+    /// <param name="target">Bitmap memory the pixels will be written to</param>
+    /// <param name="targetX">X coordinate in the target bitmap of the first pixel</param>
+    /// <param name="targetY">Y coordinate in the target bitmap of the first pixel</param>
+    /// <remarks>
+    ///   The area has to lie inside the source bitmap and fit into the target bitmap
+    ///   at the specified position, otherwise an exception is thrown.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Blit(
+      const BitmapMemory &source, const Rectangle &sourceRegion,
+      const BitmapMemory &target, std::size_t targetX, std::size_t targetY
+    );
+
+    /// <summary>Copies all pixels of a bitmap into another bitmap</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap the pixels will be written to</param>
+    /// <param name="targetX">X coordinate in the target bitmap of the first pixel</param>
+    /// <param name="targetY">Y coordinate in the target bitmap of the first pixel</param>
+    public: NUCLEX_PIXELS_API static void Blit(
+      const BitmapMemory &source,
+      Bitmap &target, std::size_t targetX = 0, std::size_t targetY = 0
+    );
+
+    /// <summary>Copies a rectangular area of pixels from one bitmap into another</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="sourceRegion">Area in the source bitmap that will be copied</param>
+    /// <param name="target">Bitmap the pixels will be written to</param>
+    /// <param name="targetX">X coordinate in the target bitmap of the first pixel</param>
+    /// <param name="targetY">Y coordinate in the target bitmap of the first pixel</param>
+    public: NUCLEX_PIXELS_API static void Blit(
+      const BitmapMemory &source, const Rectangle &sourceRegion,
+      Bitmap &target, std::size_t targetX, std::size_t targetY
+    );
+
+    /// <summary>Sets all pixels of a bitmap to the specified color</summary>
+    /// <param name="target">Bitmap memory whose pixels will be overwritten</param>
+    /// <param name="color">Color the pixels will be set to</param>
+    /// <remarks>
+    ///   The color is converted into the bitmap's pixel format (see
+    ///   <see cref="PixelFormatConverter.EncodeColor" />), so block-compressed pixel
+    ///   formats are not supported.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Fill(
+      const BitmapMemory &target, const ColorModels::RgbColor &color
+    );
+
+    /// <summary>Sets all pixels of a bitmap to an already encoded pixel</summary>
+    /// <param name="target">Bitmap memory whose pixels will be overwritten</param>
+    /// <param name="pixel">
+    ///   Pixel in the bitmap's pixel format that will be copied into every pixel
+    /// </param>
+    public: NUCLEX_PIXELS_API static void Fill(const BitmapMemory &target, const void *pixel);
+
+    /// <summary>Sets all pixels of a bitmap to the specified color</summary>
+    /// <param name="target">Bitmap whose pixels will be overwritten</param>
+    /// <param name="color">Color the pixels will be set to</param>
+    public: NUCLEX_PIXELS_API static void Fill(
+      Bitmap &target, const ColorModels::RgbColor &color
+    );
+
+    /// <summary>Sets all bytes of a bitmap's pixels to zero</summary>
+    /// <param name="target">Bitmap memory whose pixels will be cleared</param>
+    /// <remarks>
+    ///   For all pixel formats offered by the library, this results in black pixels
+    ///   (transparent black if the pixel format has an alpha channel).
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Clear(const BitmapMemory &target);
+
+    /// <summary>Sets all bytes of a bitmap's pixels to zero</summary>
+    /// <param name="target">Bitmap whose pixels will be cleared</param>
+    public: NUCLEX_PIXELS_API static void Clear(Bitmap &target);
+
+    /// <summary>Checks whether two bitmaps contain exactly the same pixels</summary>
+    /// <param name="bitmap">Bitmap memory that will be compared</param>
+    /// <param name="otherBitmap">Other bitmap memory the first will be compared to</param>
+    /// <returns>
+    ///   True if both bitmaps have the same size, pixel format and pixel bytes
+    /// </returns>
+    /// <remarks>
+    ///   Only the bytes of the pixels are compared, any padding at the end of
+    ///   the rows is ignored.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static bool AreEqual(
+      const BitmapMemory &bitmap, const BitmapMemory &otherBitmap
+    );
+
+    /// <summary>Looks for the first pixel in which two bitmaps differ</summary>
+    /// <param name="bitmap">Bitmap memory that will be compared</param>
+    /// <param name="otherBitmap">Other bitmap memory the first will be compared to</param>
+    /// <param name="x">Receives the X coordinate of the first differing pixel</param>
+    /// <param name="y">Receives the Y coordinate of the first differing pixel</param>
+    /// <returns>True if a differing pixel was found, false if the bitmaps are equal</returns>
+    /// <remarks>
+    ///   Pixels are searched row by row from the top. Both bitmaps need to have the same
+    ///   size and pixel format, otherwise an exception is thrown.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static bool FindFirstDifference(
+      const BitmapMemory &bitmap, const BitmapMemory &otherBitmap,
+      std::size_t &x, std::size_t &y
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPBLITTER_H
@@ -0,0 +1,225 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BITMAPFILTER_H
+#define NUCLEX_PIXELS_BITMAPFILTER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/Rectangle.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Convolution kernel that can be applied to rows and columns separately</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A separable kernel is the product of a horizontal and a vertical kernel, so
+  ///     instead of visiting width * height pixels for each filtered pixel, the filter
+  ///     only needs to visit width + height pixels. Box and Gaussian blurs are separable.
+  ///   </para>
+  ///   <para>
+  ///     Box kernels are not stored as weights. The filter runs them as a sliding window,
+  ///     which costs the same per pixel no matter how large the radius is. Gaussian
+  ///     kernels are approximated by three box passes of slightly different radii.
+  ///   </para>
+  /// </remarks>
+  class SeparableKernel {
+
+    /// <summary>Creates a kernel that applies the same weights in both directions</summary>
+    /// <param name="weights">
+    ///   Weights of the pixels covered by the kernel. Needs an odd number of weights,
+    ///   the weight in the middle is applied to the pixel being filtered.
+    /// </param>
+    /// <returns>A kernel applying the specified weights</returns>
+    /// <remarks>
+    ///   The weights are used as provided. If they do not sum up to one, the filter
+    ///   will change the brightness of the bitmap.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static SeparableKernel FromWeights(
+      const std::vector<float> &weights
+    );
+
+    /// <summary>Creates a kernel from separate horizontal and vertical weights</summary>
+    /// <param name="horizontalWeights">
+    ///   Weights applied to the pixels in a row, needs to be an odd number of weights
+    /// </param>
+    /// <param name="verticalWeights">
+    ///   Weights applied to the pixels in a column, needs to be an odd number of weights
+    /// </param>
+    /// <returns>A kernel applying the specified weights</returns>
+    public: NUCLEX_PIXELS_API static SeparableKernel FromWeights(
+      const std::vector<float> &horizontalWeights, const std::vector<float> &verticalWeights
+    );
+
+    /// <summary>Creates a kernel that averages all pixels in a square</summary>
+    /// <param name="radius">
+    ///   Number of pixels to the left, right, top and bottom of the filtered pixel
+    ///   that will be averaged with it
+    /// </param>
+    /// <param name="passCount">Number of times the box filter will be applied</param>
+    /// <returns>A box blur kernel with the specified radius</returns>
+    public: NUCLEX_PIXELS_API static SeparableKernel Box(
+      std::size_t radius, std::size_t passCount = 1
+    );
+
+    /// <summary>Creates a kernel approximating a Gaussian blur</summary>
+    /// <param name="sigma">Standard deviation of the Gaussian bell curve in pixels</param>
+    /// <returns>A kernel approximating a Gaussian blur of the specified strength</returns>
+    /// <remarks>
+    ///   Three successive box passes are very close to a true Gaussian, the remaining
+    ///   difference is invisible for blurs (bloom, depth of field, shadows) but should
+    ///   be kept in mind if the result needs to match another implementation exactly.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static SeparableKernel Gaussian(float sigma);
+
+    /// <summary>Number of pixels the kernel reaches to the left and right</summary>
+    /// <returns>The horizontal reach of the kernel in pixels</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetHorizontalRadius() const;
+
+    /// <summary>Number of pixels the kernel reaches to the top and bottom</summary>
+    /// <returns>The vertical reach of the kernel in pixels</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetVerticalRadius() const;
+
+    /// <summary>Weights the kernel applies to the pixels of a row</summary>
+    /// <returns>The horizontal weights, empty if the kernel consists of box passes</returns>
+    public: NUCLEX_PIXELS_API const std::vector<float> &GetHorizontalWeights() const {
+      return this->horizontalWeights;
+    }
+
+    /// <summary>Weights the kernel applies to the pixels of a column</summary>
+    /// <returns>The vertical weights, empty if the kernel consists of box passes</returns>
+    public: NUCLEX_PIXELS_API const std::vector<float> &GetVerticalWeights() const {
+      return this->verticalWeights;
+    }
+
+    /// <summary>Radii of the box passes the kernel consists of</summary>
+    /// <returns>The radius of each box pass, empty if the kernel uses weights</returns>
+    public: NUCLEX_PIXELS_API const std::vector<std::size_t> &GetBoxRadii() const {
+      return this->boxRadii;
+    }
+
+    /// <summary>Initializes a new kernel that leaves all pixels unchanged</summary>
+    private: SeparableKernel() = default;
+
+    /// <summary>Weights applied to the pixels of a row</summary>
+    private: std::vector<float> horizontalWeights;
+    /// <summary>Weights applied to the pixels of a column</summary>
+    private: std::vector<float> verticalWeights;
+    /// <summary>Radius of each box pass if the kernel consists of box passes</summary>
+    private: std::vector<std::size_t> boxRadii;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Blurs, sharpens or otherwise convolves bitmaps</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Like the <see cref="BitmapResampler" />, the filter first convolves each row of
+  ///     the source bitmap horizontally and then convolves the columns of the intermediate
+  ///     result vertically. Pixels are processed as four floats at a time with SIMD
+  ///     instructions (SSE2 or NEON) when the compiler targets them.
+  ///   </para>
+  ///   <para>
+  ///     Any pixel format supported by the <see cref="PixelFormatConverter" /> can be
+  ///     filtered. Color channels are weighted by alpha (premultiplied) while filtering.
+  ///     Pixels beyond the borders of the source bitmap are treated as repeating the pixels
+  ///     on the border. When only a region of the source bitmap is filtered, the pixels
+  ///     around the region are used as the kernel reaches them, so a bitmap can be filtered
+  ///     in tiles without any seams showing.
+  ///   </para>
+  ///   <para>
+  ///     All source pixels have been read before the first target pixel is written,
+  ///     thus the target may be the source bitmap itself (or overlap it).
+  ///   </para>
+  /// </remarks>
+  class BitmapFilter {
+
+    /// <summary>Checks whether pixels of the specified format can be filtered</summary>
+    /// <param name="pixelFormat">Pixel format that will be checked</param>
+    /// <returns>True if bitmaps using the pixel format can be filtered</returns>
+    public: NUCLEX_PIXELS_API static bool CanFilter(PixelFormat pixelFormat);
+
+    /// <summary>Convolves a bitmap with a separable kernel</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the filtered pixels will be written to</param>
+    /// <param name="kernel">Kernel the bitmap will be convolved with</param>
+    /// <remarks>
+    ///   The target needs to have the same size as the source, but may use a different
+    ///   pixel format.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Convolve(
+      const BitmapMemory &source, const BitmapMemory &target, const SeparableKernel &kernel
+    );
+
+    /// <summary>Convolves a bitmap with a separable kernel in parallel</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the filtered pixels will be written to</param>
+    /// <param name="threadPool">Thread pool that will share the work of filtering</param>
+    /// <param name="kernel">Kernel the bitmap will be convolved with</param>
+    public: NUCLEX_PIXELS_API static void Convolve(
+      const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool,
+      const SeparableKernel &kernel
+    );
+
+    /// <summary>Convolves a region within a bitmap with a separable kernel</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="sourceRegion">Region in the source bitmap that will be filtered</param>
+    /// <param name="target">Bitmap memory the filtered pixels will be written to</param>
+    /// <param name="kernel">Kernel the bitmap will be convolved with</param>
+    /// <remarks>
+    ///   The target needs to have the size of the region. Pixels of the source bitmap
+    ///   outside the region are read as far as the kernel reaches. To filter a view
+    ///   (see <see cref="Bitmap.GetView" />) while taking its surroundings into account,
+    ///   pass the view's parent bitmap and the view's position and size as region.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Convolve(
+      const BitmapMemory &source, const Rectangle &sourceRegion,
+      const BitmapMemory &target, const SeparableKernel &kernel
+    );
+
+    /// <summary>Convolves a region within a bitmap with a separable kernel in parallel</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="sourceRegion">Region in the source bitmap that will be filtered</param>
+    /// <param name="target">Bitmap memory the filtered pixels will be written to</param>
+    /// <param name="threadPool">Thread pool that will share the work of filtering</param>
+    /// <param name="kernel">Kernel the bitmap will be convolved with</param>
+    public: NUCLEX_PIXELS_API static void Convolve(
+      const BitmapMemory &source, const Rectangle &sourceRegion,
+      const BitmapMemory &target, ThreadPool &threadPool,
+      const SeparableKernel &kernel
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPFILTER_H
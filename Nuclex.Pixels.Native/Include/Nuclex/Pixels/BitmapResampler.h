@@ -0,0 +1,155 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BITMAPRESAMPLER_H
+#define NUCLEX_PIXELS_BITMAPRESAMPLER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/RowStream.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Filters that can be used to calculate the pixels of a resized bitmap</summary>
+  enum class ResamplingFilter {
+
+    /// <summary>Averages all source pixels covered by a target pixel</summary>
+    /// <remarks>
+    ///   Fastest filter. Good for downscaling by integer factors, blocky when upscaling.
+    /// </remarks>
+    Box,
+
+    /// <summary>Interpolates linearly between the nearest source pixels</summary>
+    /// <remarks>
+    ///   Also known as the triangle or tent filter. A bit soft, but free of ringing.
+    /// </remarks>
+    Bilinear,
+
+    /// <summary>Windowed sinc filter reaching three source pixels in each direction</summary>
+    /// <remarks>
+    ///   Sharpest filter, but may produce slight ringing (halos) around hard edges.
+    /// </remarks>
+    Lanczos3,
+
+    /// <summary>Mitchell-Netravali cubic filter with B = C = 1/3</summary>
+    /// <remarks>
+    ///   A good compromise between sharpness, ringing and aliasing, well suited
+    ///   as a general purpose filter and for thumbnails.
+    /// </remarks>
+    Mitchell
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Resizes bitmaps using high quality filters</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The resampler is separable: it first filters each row of the source bitmap
+  ///     horizontally and then filters the columns of the intermediate result vertically.
+  ///     The filter weights for each target column and row are calculated once per
+  ///     resize and pixels are processed as four floats at a time with SIMD instructions
+  ///     (SSE2 or NEON) when the compiler targets them.
+  ///   </para>
+  ///   <para>
+  ///     Any pixel format supported by the <see cref="PixelFormatConverter" /> can be
+  ///     resampled and the source and target bitmaps may use different pixel formats,
+  ///     converting them in the same pass. Color channels are weighted by alpha while
+  ///     filtering (premultiplied), so transparent pixels do not bleed their color into
+  ///     their neighbours. Channels are filtered as stored, no gamma correction happens.
+  ///   </para>
+  /// </remarks>
+  class BitmapResampler {
+
+    /// <summary>Checks whether pixels of the specified format can be resampled</summary>
+    /// <param name="pixelFormat">Pixel format that will be checked</param>
+    /// <returns>True if bitmaps using the pixel format can be resampled</returns>
+    public: NUCLEX_PIXELS_API static bool CanResample(PixelFormat pixelFormat);
+
+    /// <summary>Resamples a bitmap into another bitmap of a different size</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the resampled pixels will be written to</param>
+    /// <param name="filter">Filter that will be used to calculate the target pixels</param>
+    /// <remarks>
+    ///   The source bitmap is stretched to cover the whole target bitmap. To keep
+    ///   the aspect ratio or to resize only part of a bitmap, pass a view of the source
+    ///   bitmap (see <see cref="Bitmap.GetView" />). The source and target bitmaps
+    ///   must not overlap.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Resample(
+      const BitmapMemory &source, const BitmapMemory &target,
+      ResamplingFilter filter = ResamplingFilter::Mitchell
+    );
+
+    /// <summary>Resamples a bitmap into another bitmap of a different size in parallel</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the resampled pixels will be written to</param>
+    /// <param name="threadPool">Thread pool that will share the work of resampling</param>
+    /// <param name="filter">Filter that will be used to calculate the target pixels</param>
+    /// <remarks>
+    ///   Works like the single-threaded <see cref="Resample" /> but splits both filter
+    ///   passes into horizontal bands that are processed by the threads of the thread pool.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Resample(
+      const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool,
+      ResamplingFilter filter = ResamplingFilter::Mitchell
+    );
+
+    /// <summary>Wraps a row source so that its rows are resampled as they are read</summary>
+    /// <param name="source">Row source whose image will be resampled</param>
+    /// <param name="targetWidth">Width the image will be resampled to</param>
+    /// <param name="targetHeight">Height the image will be resampled to</param>
+    /// <param name="filter">Filter that will be used to calculate the target pixels</param>
+    /// <returns>A row source providing the resampled rows</returns>
+    /// <remarks>
+    ///   <para>
+    ///     The returned row source takes ownership of the wrapped row source and provides
+    ///     its rows in the same pixel format. Produces exactly the same pixels as
+    ///     <see cref="Resample" />, but only keeps the source rows in memory that
+    ///     the filter currently reaches, so images too large to fit in memory can be
+    ///     scaled down while they are being decoded.
+    ///   </para>
+    ///   <para>
+    ///     The rows are filtered in the row source's pixel format. Wrap the source in
+    ///     <see cref="PixelFormatConverter.ConvertRows" /> first if the resampled rows
+    ///     should keep more precision than it provides.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::unique_ptr<RowSource> ResampleRows(
+      std::unique_ptr<RowSource> &&source, std::size_t targetWidth, std::size_t targetHeight,
+      ResamplingFilter filter = ResamplingFilter::Mitchell
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPRESAMPLER_H
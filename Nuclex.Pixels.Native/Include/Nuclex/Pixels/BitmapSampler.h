@@ -0,0 +1,176 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BITMAPSAMPLER_H
+#define NUCLEX_PIXELS_BITMAPSAMPLER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ways in which a sampled color can be calculated from nearby pixels</summary>
+  enum class SamplingFilter {
+
+    /// <summary>Takes the color of the pixel the coordinate falls into</summary>
+    Nearest,
+
+    /// <summary>Interpolates linearly between the four pixels closest to the coordinate</summary>
+    Bilinear
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ways in which coordinates outside of the bitmap are handled</summary>
+  enum class TextureAddressing {
+
+    /// <summary>Coordinates outside of the bitmap take the color of its closest edge</summary>
+    Clamp,
+
+    /// <summary>The bitmap repeats endlessly in all directions</summary>
+    Wrap
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the colors of a bitmap at arbitrary coordinates</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Meant for software rasterizers and texture mapping, where each pixel drawn reads
+  ///     the bitmap at some coordinate that is unrelated to the previous one. Coordinates
+  ///     are normalized like a GPU's texture coordinates: (0, 0) is the top left corner of
+  ///     the top left pixel, (1, 1) the bottom right corner of the bottom right pixel and
+  ///     pixel centers lie at (x + 0.5) / width and (y + 0.5) / height.
+  ///   </para>
+  ///   <para>
+  ///     Coordinates are processed in batches of eight: their pixel positions and filter
+  ///     weights are calculated with SIMD instructions, the pixels are fetched with
+  ///     AVX2 gathers for 32 bit formats (when the compiler targets AVX2) and
+  ///     interpolated with SIMD instructions, too. Unsigned 8 bit formats have kernels
+  ///     specialized for their channel layout and, when sampled into 8 bit colors,
+  ///     are interpolated in fixed point with 8 bit weights. All other formats supported
+  ///     by the <see cref="PixelFormatConverter" /> are decoded into floats first.
+  ///   </para>
+  ///   <para>
+  ///     Channels are interpolated as stored, just like a GPU does it. Bitmaps with
+  ///     transparent pixels should use premultiplied alpha to avoid colors bleeding
+  ///     in from fully transparent neighbours. Channels the bitmap does not have are
+  ///     sampled as zero, except for alpha, which is sampled as fully opaque.
+  ///   </para>
+  ///   <para>
+  ///     The sampler only remembers the bitmap's memory, so the bitmap needs to stay
+  ///     alive for as long as the sampler is used. Sampling does not change the sampler,
+  ///     thus any number of threads can sample through the same sampler at once.
+  ///   </para>
+  /// </remarks>
+  class BitmapSampler {
+
+    /// <summary>Checks whether pixels of the specified format can be sampled</summary>
+    /// <param name="pixelFormat">Pixel format that will be checked</param>
+    /// <returns>True if bitmaps using the pixel format can be sampled</returns>
+    public: NUCLEX_PIXELS_API static bool CanSample(PixelFormat pixelFormat);
+
+    /// <summary>Initializes a new sampler for the specified bitmap</summary>
+    /// <param name="memory">Bitmap memory the sampler will read pixels from</param>
+    /// <param name="filter">Filter used to calculate colors from the nearby pixels</param>
+    /// <param name="addressing">How coordinates outside of the bitmap are handled</param>
+    public: NUCLEX_PIXELS_API explicit BitmapSampler(
+      const BitmapMemory &memory,
+      SamplingFilter filter = SamplingFilter::Bilinear,
+      TextureAddressing addressing = TextureAddressing::Clamp
+    );
+
+    /// <summary>Samples the bitmap at the specified coordinates as float colors</summary>
+    /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+    /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+    /// <param name="count">Number of coordinates that will be sampled</param>
+    /// <param name="rgba">
+    ///   Receives the sampled colors as four floats each (red, green, blue, alpha)
+    /// </param>
+    /// <remarks>
+    ///   Unsigned integer channels are sampled in the range of 0.0 to 1.0, float channels
+    ///   are sampled as they are. Sampling 8 or more coordinates per call is fastest.
+    /// </remarks>
+    public: void Sample(
+      const float *u, const float *v, std::size_t count, float *rgba
+    ) const {
+      this->sampleFloats(this->memory, u, v, count, rgba);
+    }
+
+    /// <summary>Samples the bitmap at the specified coordinates as 8 bit colors</summary>
+    /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+    /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+    /// <param name="count">Number of coordinates that will be sampled</param>
+    /// <param name="rgba">
+    ///   Receives the sampled colors as four bytes each (red, green, blue, alpha)
+    /// </param>
+    /// <remarks>
+    ///   Channels are saturated to the range of 0.0 to 1.0 and rounded to the nearest
+    ///   8 bit value. Sampling 8 or more coordinates per call is fastest.
+    /// </remarks>
+    public: void Sample(
+      const float *u, const float *v, std::size_t count, std::uint8_t *rgba
+    ) const {
+      this->sampleBytes(this->memory, u, v, count, rgba);
+    }
+
+    /// <summary>Samples the bitmap as float colors</summary>
+    /// <param name="memory">Bitmap memory that will be sampled</param>
+    /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+    /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+    /// <param name="count">Number of coordinates that will be sampled</param>
+    /// <param name="rgba">Receives the sampled colors as four floats each</param>
+    private: typedef void SampleFloatsFunction(
+      const BitmapMemory &memory,
+      const float *u, const float *v, std::size_t count, float *rgba
+    );
+
+    /// <summary>Samples the bitmap as 8 bit colors</summary>
+    /// <param name="memory">Bitmap memory that will be sampled</param>
+    /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+    /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+    /// <param name="count">Number of coordinates that will be sampled</param>
+    /// <param name="rgba">Receives the sampled colors as four bytes each</param>
+    private: typedef void SampleBytesFunction(
+      const BitmapMemory &memory,
+      const float *u, const float *v, std::size_t count, std::uint8_t *rgba
+    );
+
+    /// <summary>Bitmap memory the sampler reads pixels from</summary>
+    private: BitmapMemory memory;
+    /// <summary>Kernel sampling the bitmap as float colors</summary>
+    private: SampleFloatsFunction *sampleFloats;
+    /// <summary>Kernel sampling the bitmap as 8 bit colors</summary>
+    private: SampleBytesFunction *sampleBytes;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPSAMPLER_H
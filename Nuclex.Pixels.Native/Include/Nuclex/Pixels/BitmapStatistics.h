@@ -0,0 +1,79 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BITMAPSTATISTICS_H
+#define NUCLEX_PIXELS_BITMAPSTATISTICS_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Statistics about the values of one channel in a bitmap</summary>
+  /// <remarks>
+  ///   Values of integer channels are normalized, so 0 to 255 in an 8 bit channel and
+  ///   0 to 65535 in a 16 bit channel both become 0.0 to 1.0. Floating point channels
+  ///   are reported as they are.
+  /// </remarks>
+  struct ChannelStatistics {
+
+    /// <summary>Smallest value found in the channel</summary>
+    public: double Minimum;
+
+    /// <summary>Largest value found in the channel</summary>
+    public: double Maximum;
+
+    /// <summary>Sum of the values of all pixels in the channel</summary>
+    public: double Sum;
+
+    /// <summary>Average value of the channel over all pixels</summary>
+    public: double Mean;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Statistics about the values of all channels in a bitmap</summary>
+  struct BitmapStatistics {
+
+    /// <summary>Number of pixels that have been looked at</summary>
+    public: std::size_t PixelCount;
+
+    /// <summary>Number of channels the statistics have been gathered for</summary>
+    public: std::size_t ChannelCount;
+
+    /// <summary>Statistics for each channel in the order they're stored in memory</summary>
+    /// <remarks>
+    ///   Like with planar bitmaps, the channels of
+    ///   <see cref="PixelFormat.B8_G8_R8_A8_Unsigned" /> are blue, green, red and alpha.
+    ///   If the bitmap does not contain any pixels, all values are zero.
+    /// </remarks>
+    public: ChannelStatistics Channels[4];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPSTATISTICS_H
@@ -0,0 +1,108 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BITMAPTRANSFORMER_H
+#define NUCLEX_PIXELS_BITMAPTRANSFORMER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Flips, rotates and transposes the pixels of bitmaps</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Intended for putting camera images into their upright orientation and similar
+  ///     jobs. All methods move whole pixels around without looking at their contents,
+  ///     so any pixel format with a whole number of bytes per pixel is supported.
+  ///     Block-compressed pixel formats cause an exception to be thrown.
+  ///   </para>
+  ///   <para>
+  ///     Flips only swap pixels within rows or swap whole rows and are always done in
+  ///     place. Transposing and rotating by 90 degrees walks over the bitmap in small tiles
+  ///     that fit into the L1 cache together with their target tiles; inside each tile,
+  ///     pixels of 8, 16, 32 or 64 bits are transposed in SIMD registers.
+  ///   </para>
+  ///   <para>
+  ///     Turning a bitmap by 90 degrees swaps its width and height, so it can only be
+  ///     done in place for square bitmaps. The other overloads write into a target bitmap
+  ///     that needs to use the same pixel format and have the swapped dimensions.
+  ///     The source and target bitmaps must not overlap.
+  ///   </para>
+  /// </remarks>
+  class BitmapTransformer {
+
+    /// <summary>Mirrors a bitmap along its horizontal axis, swapping top and bottom</summary>
+    /// <param name="memory">Bitmap memory that will be flipped</param>
+    public: NUCLEX_PIXELS_API static void FlipVertical(const BitmapMemory &memory);
+
+    /// <summary>Mirrors a bitmap along its vertical axis, swapping left and right</summary>
+    /// <param name="memory">Bitmap memory that will be flipped</param>
+    public: NUCLEX_PIXELS_API static void FlipHorizontal(const BitmapMemory &memory);
+
+    /// <summary>Turns a bitmap upside down</summary>
+    /// <param name="memory">Bitmap memory that will be rotated</param>
+    public: NUCLEX_PIXELS_API static void Rotate180(const BitmapMemory &memory);
+
+    /// <summary>Mirrors a square bitmap along its diagonal</summary>
+    /// <param name="memory">Bitmap memory that will be transposed</param>
+    public: NUCLEX_PIXELS_API static void Transpose(const BitmapMemory &memory);
+
+    /// <summary>Mirrors a bitmap along its diagonal into another bitmap</summary>
+    /// <param name="source">Bitmap memory that will be transposed</param>
+    /// <param name="target">Bitmap memory that will receive the transposed pixels</param>
+    /// <remarks>
+    ///   The pixel at (x, y) in the source bitmap will end up at (y, x) in the target.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Transpose(
+      const BitmapMemory &source, const BitmapMemory &target
+    );
+
+    /// <summary>Rotates a square bitmap clockwise by 90 degrees</summary>
+    /// <param name="memory">Bitmap memory that will be rotated</param>
+    public: NUCLEX_PIXELS_API static void Rotate90(const BitmapMemory &memory);
+
+    /// <summary>Rotates a bitmap clockwise by 90 degrees into another bitmap</summary>
+    /// <param name="source">Bitmap memory that will be rotated</param>
+    /// <param name="target">Bitmap memory that will receive the rotated pixels</param>
+    public: NUCLEX_PIXELS_API static void Rotate90(
+      const BitmapMemory &source, const BitmapMemory &target
+    );
+
+    /// <summary>Rotates a square bitmap clockwise by 270 degrees</summary>
+    /// <param name="memory">Bitmap memory that will be rotated</param>
+    public: NUCLEX_PIXELS_API static void Rotate270(const BitmapMemory &memory);
+
+    /// <summary>Rotates a bitmap clockwise by 270 degrees into another bitmap</summary>
+    /// <param name="source">Bitmap memory that will be rotated</param>
+    /// <param name="target">Bitmap memory that will receive the rotated pixels</param>
+    public: NUCLEX_PIXELS_API static void Rotate270(
+      const BitmapMemory &source, const BitmapMemory &target
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPTRANSFORMER_H
@@ -0,0 +1,86 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_BLOCKCOMPRESSOR_H
+#define NUCLEX_PIXELS_BLOCKCOMPRESSOR_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes bitmaps into the block-compressed formats used by GPUs</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Compresses bitmaps in the <see cref="PixelFormat.R8_G8_B8_A8_Unsigned" /> pixel
+  ///     format into <see cref="PixelFormat.BC1_Compressed" />,
+  ///     <see cref="PixelFormat.BC3_Compressed" />, <see cref="PixelFormat.BC4_Compressed" />
+  ///     (from the red channel), <see cref="PixelFormat.BC5_Compressed" /> (from the red
+  ///     and green channels) or <see cref="PixelFormat.BC7_Compressed" />.
+  ///   </para>
+  ///   <para>
+  ///     Both bitmaps must have the same dimensions. The compressed bitmap's memory has
+  ///     to cover whole blocks, which is the case for any <see cref="Bitmap" /> created
+  ///     in a block-compressed pixel format. Blocks extending past the right or bottom
+  ///     border of the source bitmap are filled by repeating the border pixels.
+  ///   </para>
+  ///   <para>
+  ///     Color endpoints are found along the principal axis of each block's colors,
+  ///     projecting the pixels onto it with SIMD instructions, then refined with a least
+  ///     squares fit for BC1 and BC3. BC7 blocks are always encoded in mode 6 (a single
+  ///     pair of RGBA endpoints with 16 interpolation steps). This favors speed over
+  ///     the last bit of quality an exhaustive search over all modes could provide.
+  ///   </para>
+  /// </remarks>
+  class BlockCompressor {
+
+    /// <summary>Checks whether bitmaps can be compressed into a pixel format</summary>
+    /// <param name="pixelFormat">Block-compressed pixel format that will be checked</param>
+    /// <returns>True if bitmaps can be compressed into the pixel format</returns>
+    public: NUCLEX_PIXELS_API static bool CanCompress(PixelFormat pixelFormat);
+
+    /// <summary>Compresses a bitmap into a block-compressed pixel format</summary>
+    /// <param name="source">Bitmap memory holding the pixels that will be compressed</param>
+    /// <param name="target">Bitmap memory that will receive the compressed blocks</param>
+    public: NUCLEX_PIXELS_API static void Compress(
+      const BitmapMemory &source, const BitmapMemory &target
+    );
+
+    /// <summary>Compresses a bitmap into a block-compressed pixel format in parallel</summary>
+    /// <param name="source">Bitmap memory holding the pixels that will be compressed</param>
+    /// <param name="target">Bitmap memory that will receive the compressed blocks</param>
+    /// <param name="threadPool">Thread pool that will share the work</param>
+    public: NUCLEX_PIXELS_API static void Compress(
+      const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BLOCKCOMPRESSOR_H
@@ -0,0 +1,134 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_COLORMODELS_SRGBTRANSFER_H
+#define NUCLEX_PIXELS_COLORMODELS_SRGBTRANSFER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+namespace Nuclex { namespace Pixels { namespace ColorModels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts color values between the sRGB and linear color spaces</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Pixels stored in 8 bit formats encode their colors in sRGB almost always, while
+  ///     filtering, blending and lighting should happen on linear light intensities.
+  ///     Only the color channels are converted, alpha is always linear.
+  ///   </para>
+  ///   <para>
+  ///     The bitmap conversions accept any pixel formats the <see cref="PixelFormatConverter" />
+  ///     understands and change both the pixel format and the color space in one pass.
+  ///     8 bit sRGB pixels are decoded through a 256 entry table and encoded back through
+  ///     a 4096 entry table. The latter may be off by one step for colors close to
+  ///     a rounding boundary, but decoding and encoding 8 bit sRGB pixels again always
+  ///     yields the original pixels. All other pixel formats, including half and single
+  ///     precision floats, are converted with polynomial approximations that process
+  ///     four channels at a time with SSE2 and stay within 0.00001 of the exact
+  ///     transfer functions.
+  ///   </para>
+  /// </remarks>
+  class SrgbTransfer {
+
+    /// <summary>Converts a single sRGB color value into linear color space</summary>
+    /// <param name="srgb">sRGB color value that will be converted</param>
+    /// <returns>The exact linear equivalent of the sRGB color value</returns>
+    public: NUCLEX_PIXELS_API static float ToLinear(float srgb);
+
+    /// <summary>Converts a single linear color value into sRGB color space</summary>
+    /// <param name="linear">Linear color value that will be converted</param>
+    /// <returns>The exact sRGB equivalent of the linear color value</returns>
+    public: NUCLEX_PIXELS_API static float ToSrgb(float linear);
+
+    /// <summary>Converts a row of float RGBA pixels from sRGB to linear in place</summary>
+    /// <param name="rgba">Address of the first pixel's red channel</param>
+    /// <param name="pixelCount">Number of pixels that will be converted</param>
+    /// <remarks>
+    ///   Color values are clamped to the range of 0.0 to 1.0.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void ToLinearRow(float *rgba, std::size_t pixelCount);
+
+    /// <summary>Converts a row of float RGBA pixels from linear to sRGB in place</summary>
+    /// <param name="rgba">Address of the first pixel's red channel</param>
+    /// <param name="pixelCount">Number of pixels that will be converted</param>
+    /// <remarks>
+    ///   Color values are clamped to the range of 0.0 to 1.0.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void ToSrgbRow(float *rgba, std::size_t pixelCount);
+
+    /// <summary>Converts an sRGB bitmap into a linear bitmap</summary>
+    /// <param name="source">Bitmap memory holding the sRGB pixels</param>
+    /// <param name="target">Bitmap memory that will receive the linear pixels</param>
+    /// <remarks>
+    ///   Both bitmaps must have the same dimensions but can use different pixel formats.
+    ///   The source and target bitmaps must not overlap.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void ToLinear(
+      const BitmapMemory &source, const BitmapMemory &target
+    );
+
+    /// <summary>Converts an sRGB bitmap into a linear bitmap in parallel</summary>
+    /// <param name="source">Bitmap memory holding the sRGB pixels</param>
+    /// <param name="target">Bitmap memory that will receive the linear pixels</param>
+    /// <param name="threadPool">Thread pool that will share the work of converting</param>
+    public: NUCLEX_PIXELS_API static void ToLinear(
+      const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+    );
+
+    /// <summary>Converts a linear bitmap into an sRGB bitmap</summary>
+    /// <param name="source">Bitmap memory holding the linear pixels</param>
+    /// <param name="target">Bitmap memory that will receive the sRGB pixels</param>
+    /// <remarks>
+    ///   Both bitmaps must have the same dimensions but can use different pixel formats.
+    ///   The source and target bitmaps must not overlap.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void ToSrgb(
+      const BitmapMemory &source, const BitmapMemory &target
+    );
+
+    /// <summary>Converts a linear bitmap into an sRGB bitmap in parallel</summary>
+    /// <param name="source">Bitmap memory holding the linear pixels</param>
+    /// <param name="target">Bitmap memory that will receive the sRGB pixels</param>
+    /// <param name="threadPool">Thread pool that will share the work of converting</param>
+    public: NUCLEX_PIXELS_API static void ToSrgb(
+      const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::ColorModels
+
+#endif // NUCLEX_PIXELS_COLORMODELS_SRGBTRANSFER_H
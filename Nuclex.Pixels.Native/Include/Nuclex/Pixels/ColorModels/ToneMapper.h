@@ -0,0 +1,148 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_COLORMODELS_TONEMAPPER_H
+#define NUCLEX_PIXELS_COLORMODELS_TONEMAPPER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/DitheringMethod.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+namespace Nuclex { namespace Pixels { namespace ColorModels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Curves by which high dynamic range colors can be brought into 0.0 to 1.0</summary>
+  enum class ToneMappingOperator {
+
+    /// <summary>Colors are scaled by the exposure and everything above 1.0 is clipped</summary>
+    Clamp,
+    /// <summary>Each channel is compressed by the Reinhard curve x / (1 + x)</summary>
+    Reinhard,
+    /// <summary>Krzysztof Narkowicz' fit of the ACES filmic reference curve</summary>
+    AcesFit
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how a high dynamic range bitmap is tone mapped</summary>
+  struct ToneMappingOptions {
+
+    /// <summary>Initializes new tone mapping options with the default settings</summary>
+    public: ToneMappingOptions() :
+      Operator(ToneMappingOperator::AcesFit),
+      Exposure(0.0f),
+      Dithering(DitheringMethod::Ordered) {}
+
+    /// <summary>Curve that compresses the colors into the displayable range</summary>
+    public: ToneMappingOperator Operator;
+    /// <summary>Exposure adjustment in stops that is applied before the curve</summary>
+    /// <remarks>
+    ///   Colors are multiplied by two to the power of this value, so +1.0 doubles
+    ///   the brightness of the image and -1.0 halves it.
+    /// </remarks>
+    public: float Exposure;
+    /// <summary>Dithering that is applied when the colors are quantized to bytes</summary>
+    public: DitheringMethod Dithering;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns high dynamic range bitmaps into displayable 8 bit sRGB bitmaps</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Bitmaps loaded from OpenEXR files or rendered into float buffers hold linear
+  ///     color values that can go far above 1.0. The tone mapper applies the exposure,
+  ///     compresses the colors with the selected curve, encodes them to sRGB and quantizes
+  ///     them to bytes in a single pass over the bitmap. Rows are processed in chunks that
+  ///     stay in the L1 cache and each step handles a whole pixel at once with SSE2.
+  ///   </para>
+  ///   <para>
+  ///     The source can be in any pixel format the <see cref="PixelFormatConverter" />
+  ///     can turn into floats. The target must be an R8-G8-B8, B8-G8-R8, R8-G8-B8-A8 or
+  ///     B8-G8-R8-A8 bitmap. Alpha is neither tone mapped nor dithered, only clamped.
+  ///   </para>
+  ///   <para>
+  ///     Dithering patterns are anchored to the bitmap's pixel coordinates, so tone
+  ///     mapping a bitmap in parallel yields exactly the same result as doing it on
+  ///     a single thread.
+  ///   </para>
+  /// </remarks>
+  class ToneMapper {
+
+    /// <summary>Applies a tone mapping operator to a single linear color value</summary>
+    /// <param name="linear">Linear color value, already scaled by the exposure</param>
+    /// <param name="mappingOperator">Tone mapping operator that will be applied</param>
+    /// <returns>The tone mapped linear color value in the range of 0.0 to 1.0</returns>
+    public: NUCLEX_PIXELS_API static float Apply(
+      float linear, ToneMappingOperator mappingOperator
+    );
+
+    /// <summary>Checks whether a bitmap can be tone mapped into another</summary>
+    /// <param name="sourcePixelFormat">Pixel format of the high dynamic range bitmap</param>
+    /// <param name="targetPixelFormat">Pixel format of the 8 bit bitmap</param>
+    /// <returns>True if the tone mapper supports the combination of pixel formats</returns>
+    public: NUCLEX_PIXELS_API static bool CanToneMap(
+      PixelFormat sourcePixelFormat, PixelFormat targetPixelFormat
+    );
+
+    /// <summary>Tone maps a high dynamic range bitmap into an 8 bit sRGB bitmap</summary>
+    /// <param name="source">Bitmap memory holding the linear high dynamic range pixels</param>
+    /// <param name="target">Bitmap memory that will receive the sRGB bytes</param>
+    /// <param name="options">Settings controlling the exposure, curve and dithering</param>
+    /// <remarks>
+    ///   Both bitmaps must have the same dimensions and must not overlap.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void ToneMap(
+      const BitmapMemory &source, const BitmapMemory &target,
+      const ToneMappingOptions &options = ToneMappingOptions()
+    );
+
+    /// <summary>Tone maps a high dynamic range bitmap into an 8 bit bitmap in parallel</summary>
+    /// <param name="source">Bitmap memory holding the linear high dynamic range pixels</param>
+    /// <param name="target">Bitmap memory that will receive the sRGB bytes</param>
+    /// <param name="options">Settings controlling the exposure, curve and dithering</param>
+    /// <param name="threadPool">Thread pool that will share the work of tone mapping</param>
+    public: NUCLEX_PIXELS_API static void ToneMap(
+      const BitmapMemory &source, const BitmapMemory &target,
+      const ToneMappingOptions &options, ThreadPool &threadPool
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::ColorModels
+
+#endif // NUCLEX_PIXELS_COLORMODELS_TONEMAPPER_H
@@ -66,9 +66,26 @@ License along with this library
 
 // --------------------------------------------------------------------------------------------- //
 
-//#if defined(__clang__) || (defined(__GNUC__) || defined(__GNUG__))
-//  #define NUCLEX_PIXELS_HAVE_BUILTIN_INT128
-//#endif
+// Native 128 bit integers (GCC and clang on 64 bit targets, MSVC has no equivalent)
+#if defined(__SIZEOF_INT128__)
+  #define NUCLEX_PIXELS_HAVE_BUILTIN_INT128 1
+#endif
+
+// --------------------------------------------------------------------------------------------- //
+
+// SIMD instruction sets the compiler has been allowed to generate code for
+#if defined(__AVX2__)
+  #define NUCLEX_PIXELS_HAVE_AVX2 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+  #define NUCLEX_PIXELS_HAVE_SSSE3 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+  #define NUCLEX_PIXELS_HAVE_SSE2 1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM) || defined(_M_ARM64)
+  #define NUCLEX_PIXELS_HAVE_NEON 1
+#endif
 
 // --------------------------------------------------------------------------------------------- //
 
@@ -0,0 +1,154 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_DIRTYREGIONTRACKER_H
+#define NUCLEX_PIXELS_DIRTYREGIONTRACKER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Rectangle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Remembers which parts of a bitmap have been modified</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The bitmap is divided into square tiles and one bit is kept per tile, so marking
+  ///     a region costs a few bit operations no matter how many pixels it covers and
+  ///     the tracker for a 4K frame with the default tile size fits into 256 bytes.
+  ///     Changes are tracked at tile granularity: touching a single pixel marks the whole
+  ///     tile it lies in.
+  ///   </para>
+  ///   <para>
+  ///     Consumers such as a remote display or a texture streamer can either walk over
+  ///     the dirty tiles (see <see cref="IsTileDirty" />) or ask for the dirty tiles merged
+  ///     into a short list of rectangles (see <see cref="GetDirtyRegions" />) and only
+  ///     encode or upload those, then <see cref="Clear" /> the tracker.
+  ///   </para>
+  ///   <para>
+  ///     The tracker is not thread safe, just like writing pixels into a bitmap
+  ///     from multiple threads needs outside coordination.
+  ///   </para>
+  /// </remarks>
+  class DirtyRegionTracker {
+
+    /// <summary>Width and height of the tiles used unless told otherwise</summary>
+    /// <remarks>
+    ///   Small enough that typical UI changes (a blinking cursor, a progress bar) don't
+    ///   drag large areas along, large enough that the list of regions stays short.
+    /// </remarks>
+    public: static const std::size_t DefaultTileSize = 64;
+
+    /// <summary>Initializes a new dirty region tracker with all tiles clean</summary>
+    /// <param name="width">Width of the tracked bitmap in pixels</param>
+    /// <param name="height">Height of the tracked bitmap in pixels</param>
+    /// <param name="tileSize">Width and height of each tile in pixels</param>
+    public: NUCLEX_PIXELS_API DirtyRegionTracker(
+      std::size_t width, std::size_t height, std::size_t tileSize = DefaultTileSize
+    );
+
+    /// <summary>Returns the width of the tracked bitmap</summary>
+    /// <returns>The width of the tracked bitmap in pixels</returns>
+    public: std::size_t GetWidth() const { return this->width; }
+
+    /// <summary>Returns the height of the tracked bitmap</summary>
+    /// <returns>The height of the tracked bitmap in pixels</returns>
+    public: std::size_t GetHeight() const { return this->height; }
+
+    /// <summary>Returns the width and height of the tiles</summary>
+    /// <returns>The width and height of each tile in pixels</returns>
+    public: std::size_t GetTileSize() const { return this->tileSize; }
+
+    /// <summary>Counts the tiles in the horizontal direction</summary>
+    /// <returns>The number of tiles in each row of tiles</returns>
+    public: std::size_t CountHorizontalTiles() const { return this->horizontalTileCount; }
+
+    /// <summary>Counts the tiles in the vertical direction</summary>
+    /// <returns>The number of tiles in each column of tiles</returns>
+    public: std::size_t CountVerticalTiles() const { return this->verticalTileCount; }
+
+    /// <summary>Marks all tiles overlapping the specified region as dirty</summary>
+    /// <param name="region">Region in pixels that has been modified</param>
+    /// <remarks>Parts of the region outside of the bitmap are ignored</remarks>
+    public: NUCLEX_PIXELS_API void MarkDirty(const Rectangle &region);
+
+    /// <summary>Marks the whole bitmap as dirty</summary>
+    public: NUCLEX_PIXELS_API void MarkAllDirty();
+
+    /// <summary>Marks all tiles as clean again</summary>
+    public: NUCLEX_PIXELS_API void Clear();
+
+    /// <summary>Checks whether any tile is dirty</summary>
+    /// <returns>True if at least one tile has been marked dirty</returns>
+    public: NUCLEX_PIXELS_API bool IsAnyDirty() const;
+
+    /// <summary>Checks whether the specified tile is dirty</summary>
+    /// <param name="tileX">Horizontal index of the tile that will be checked</param>
+    /// <param name="tileY">Vertical index of the tile that will be checked</param>
+    /// <returns>True if the tile has been marked dirty</returns>
+    public: bool IsTileDirty(std::size_t tileX, std::size_t tileY) const {
+      std::size_t tileIndex = tileY * this->horizontalTileCount + tileX;
+      return ((this->dirtyBits[tileIndex / 64] >> (tileIndex % 64)) & 1) != 0;
+    }
+
+    /// <summary>Counts the tiles that are dirty</summary>
+    /// <returns>The number of tiles that have been marked dirty</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountDirtyTiles() const;
+
+    /// <summary>Merges the dirty tiles into rectangles</summary>
+    /// <returns>Non-overlapping rectangles in pixels that cover all dirty tiles</returns>
+    /// <remarks>
+    ///   Neighbouring dirty tiles in a row are joined and rows of the same extent
+    ///   that lie on top of each other are joined, so a changed area results in one
+    ///   rectangle. The rectangles are clipped to the bitmap and sorted top to bottom.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API std::vector<Rectangle> GetDirtyRegions() const;
+
+    /// <summary>Sets a range of tiles in one row of tiles to dirty</summary>
+    /// <param name="tileY">Vertical index of the row of tiles</param>
+    /// <param name="firstTileX">Horizontal index of the first tile that will be set</param>
+    /// <param name="endTileX">Horizontal index one past the last tile that will be set</param>
+    private: void markTiles(std::size_t tileY, std::size_t firstTileX, std::size_t endTileX);
+
+    /// <summary>Width of the tracked bitmap in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the tracked bitmap in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Width and height of each tile in pixels</summary>
+    private: std::size_t tileSize;
+    /// <summary>Number of tiles in each row of tiles</summary>
+    private: std::size_t horizontalTileCount;
+    /// <summary>Number of tiles in each column of tiles</summary>
+    private: std::size_t verticalTileCount;
+    /// <summary>One bit per tile, row by row, set if the tile is dirty</summary>
+    private: std::vector<std::uint64_t> dirtyBits;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_DIRTYREGIONTRACKER_H
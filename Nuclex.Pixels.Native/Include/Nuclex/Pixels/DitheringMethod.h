@@ -0,0 +1,52 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_DITHERINGMETHOD_H
+#define NUCLEX_PIXELS_DITHERINGMETHOD_H
+
+#include "Nuclex/Pixels/Config.h"
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ways to hide banding when colors are reduced to a lower precision</summary>
+  /// <remarks>
+  ///   Both dithering patterns are anchored to the pixel coordinates of the bitmap, so
+  ///   processing a bitmap in parallel yields exactly the same result as doing it on
+  ///   a single thread. Unlike error diffusion, each pixel is quantized independently
+  ///   of its neighbours, which costs barely more than rounding.
+  /// </remarks>
+  enum class DitheringMethod {
+
+    /// <summary>Colors are rounded to the nearest representable value</summary>
+    None,
+    /// <summary>Colors are offset by an 8x8 Bayer matrix before being quantized</summary>
+    Ordered,
+    /// <summary>Colors are offset by a tiled 64x64 blue noise mask before quantizing</summary>
+    BlueNoise
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_DITHERINGMETHOD_H
@@ -0,0 +1,114 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_FRAMEDELTA_H
+#define NUCLEX_PIXELS_FRAMEDELTA_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/DirtyRegionTracker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds and transmits the differences between two frames</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Intended for remote displays and screen recording where consecutive frames
+  ///     mostly stay the same. <see cref="FindChangedTiles" /> compares two frames tile by
+  ///     tile in 32 byte blocks (with SSE2 or AVX2 when the compiler targets them) and stops
+  ///     looking at a tile as soon as one block differs.
+  ///   </para>
+  ///   <para>
+  ///     <see cref="Encode" /> turns the changed tiles into a delta holding, for each
+  ///     changed tile, the previous frame's pixels XORed with the current frame's.
+  ///     Pixels that stayed the same become zero bytes, so the delta compresses very well
+  ///     with general purpose compressors such as the ones in Nuclex.Storage.
+  ///     <see cref="Apply" /> XORs a delta into a copy of the previous frame, turning it
+  ///     into the current frame.
+  ///   </para>
+  ///   <para>
+  ///     A delta starts with four little endian 32 bit integers (frame width, frame height,
+  ///     tile size and number of tiles), followed by each changed tile's index as
+  ///     a little endian 32 bit integer and the XORed bytes of the tile's rows.
+  ///     Tiles at the right and bottom borders only contain the pixels inside the frame.
+  ///   </para>
+  ///   <para>
+  ///     Block-compressed pixel formats are not supported and, for pixel formats with
+  ///     less than 8 bits per pixel, each tile row has to end on a byte boundary.
+  ///   </para>
+  /// </remarks>
+  class FrameDelta {
+
+    /// <summary>Marks all tiles in which two frames differ</summary>
+    /// <param name="previousFrame">Frame the current frame will be compared to</param>
+    /// <param name="currentFrame">Frame that will be checked for changes</param>
+    /// <param name="changedTiles">Tracker in which the differing tiles will be marked</param>
+    /// <returns>The number of tiles that were found to differ</returns>
+    /// <remarks>
+    ///   Tiles that are already marked in the tracker are not compared again, so
+    ///   a tracker obtained from <see cref="Bitmap.GetDirtyRegionTracker" /> can be
+    ///   used to skip regions known to have been modified.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::size_t FindChangedTiles(
+      const BitmapMemory &previousFrame, const BitmapMemory &currentFrame,
+      DirtyRegionTracker &changedTiles
+    );
+
+    /// <summary>Encodes the differences in the changed tiles of two frames</summary>
+    /// <param name="previousFrame">Frame the receiver of the delta already has</param>
+    /// <param name="currentFrame">Frame the receiver should end up with</param>
+    /// <param name="changedTiles">Tiles that will be included in the delta</param>
+    /// <returns>A delta that turns the previous frame into the current frame</returns>
+    public: NUCLEX_PIXELS_API static std::vector<std::uint8_t> Encode(
+      const BitmapMemory &previousFrame, const BitmapMemory &currentFrame,
+      const DirtyRegionTracker &changedTiles
+    );
+
+    /// <summary>Encodes the differences between two frames</summary>
+    /// <param name="previousFrame">Frame the receiver of the delta already has</param>
+    /// <param name="currentFrame">Frame the receiver should end up with</param>
+    /// <param name="tileSize">Width and height of the tiles that will be compared</param>
+    /// <returns>A delta that turns the previous frame into the current frame</returns>
+    public: NUCLEX_PIXELS_API static std::vector<std::uint8_t> Encode(
+      const BitmapMemory &previousFrame, const BitmapMemory &currentFrame,
+      std::size_t tileSize = DirtyRegionTracker::DefaultTileSize
+    );
+
+    /// <summary>Turns the previous frame into the current frame using a delta</summary>
+    /// <param name="frame">Previous frame that will be updated in place</param>
+    /// <param name="delta">Delta produced by <see cref="Encode" /></param>
+    /// <param name="deltaByteCount">Length of the delta in bytes</param>
+    public: NUCLEX_PIXELS_API static void Apply(
+      const BitmapMemory &frame, const std::uint8_t *delta, std::size_t deltaByteCount
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_FRAMEDELTA_H
@@ -23,6 +23,7 @@ License along with this library
 
 #include "Nuclex/Pixels/Config.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -77,29 +78,55 @@ namespace Nuclex { namespace Pixels {
       return this->bits;
     }
 
-    // CHECK: Find method to convert a normalized byte to half without converting to float
     /// <summary>Converts a byte into a half precision float</summary>
     /// <param name="value">Byte that will be converted</param>
     /// <returns>The half-precision float equivalent to the byte</returns>
+    /// <remarks>
+    ///   Looks up the result in a table holding the half equivalent to value / 255.0f
+    ///   for each possible byte.
+    /// </remarks>
     public: NUCLEX_PIXELS_API static Half FromNormalizedByte(std::uint8_t value) {
-      float valueAsFloat = static_cast<float>(value) / 255.0f;
-      return Half(valueAsFloat);
+      return FromBits(normalizedByteBits[value]);
     }
 
-    // CHECK: Find method to convert a half to normalized byte without converting to float
     /// <summary>Converts the half precision float into a normalized byte</summary>
     /// <returns>The equivalent normalized byte to the input half-precision float</returns>
+    /// <remarks>
+    ///   Works directly on the bits of the half. Multiplying the half's 11 bit mantissa
+    ///   by 255 is exact, so this gives the same results as truncating the half
+    ///   multiplied by 255.0f as a float and adding one. Negative values become 0,
+    ///   values of one and above become 255 and NaNs become 0.
+    /// </remarks>
     public: NUCLEX_PIXELS_API std::uint8_t ToNormalizedByte() const {
-      float valueAsFloat = FloatFromBits(this->bits);
-      if(valueAsFloat <= 0.0f) {
-        return 0;
-      } else if(valueAsFloat >= 1.0f) {
-        return 255;
-      } else {
-        return static_cast<std::uint8_t>(valueAsFloat * 255.0f) + 1;
+      if(this->bits >= 0x3C00) { // Negative, one or more, infinity or NaN
+        return (((this->bits & 0x8000) != 0) || (this->bits > 0x7C00)) ? 0 : 255;
       }
+
+      std::uint32_t exponent = this->bits >> 10;
+      if(exponent == 0) { // Zero or subnormal, too small for anything but 0 or 1
+        return (this->bits == 0) ? 0 : 1;
+      }
+
+      std::uint32_t mantissa = (this->bits & 0x3FF) | 0x400;
+      return static_cast<std::uint8_t>(((mantissa * 255) >> (25 - exponent)) + 1);
     }
 
+    /// <summary>Converts an array of normalized bytes into half-precision floats</summary>
+    /// <param name="bytes">Normalized bytes that will be converted</param>
+    /// <param name="halfs">Receives the half-precision floating point values</param>
+    /// <param name="count">Number of bytes that will be converted</param>
+    public: NUCLEX_PIXELS_API static void ConvertFromNormalizedBytes(
+      const std::uint8_t *bytes, Half *halfs, std::size_t count
+    );
+
+    /// <summary>Converts an array of half-precision floats into normalized bytes</summary>
+    /// <param name="halfs">Half-precision floating point values that will be converted</param>
+    /// <param name="bytes">Receives the normalized bytes</param>
+    /// <param name="count">Number of values that will be converted</param>
+    public: NUCLEX_PIXELS_API static void ConvertToNormalizedBytes(
+      const Half *halfs, std::uint8_t *bytes, std::size_t count
+    );
+
     /// <summary>
     ///   Converts a floating point value into a half-precision floating point value
     /// </summary>
@@ -124,6 +151,37 @@ namespace Nuclex { namespace Pixels {
     /// </remarks>
     public: NUCLEX_PIXELS_API static float FloatFromBits(std::uint16_t bits);
 
+    /// <summary>Converts an array of floating point values into half-precision floats</summary>
+    /// <param name="values">Floating point values that will be converted</param>
+    /// <param name="halfs">Receives the half-precision floating point values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    /// <remarks>
+    ///   Uses the F16C instructions on x86 CPUs that support them (checked at runtime)
+    ///   and the half-precision conversion instructions on ARM CPUs with NEON. Results
+    ///   are identical to calling <see cref="BitsFromFloat" /> on each value, except that
+    ///   signaling NaNs may turn into quiet NaNs.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void ConvertFromFloats(
+      const float *values, Half *halfs, std::size_t count
+    );
+
+    /// <summary>Converts an array of half-precision floats into floating point values</summary>
+    /// <param name="halfs">Half-precision floating point values that will be converted</param>
+    /// <param name="values">Receives the floating point values</param>
+    /// <param name="count">Number of values that will be converted</param>
+    /// <remarks>
+    ///   Uses the F16C instructions on x86 CPUs that support them (checked at runtime)
+    ///   and the half-precision conversion instructions on ARM CPUs with NEON. Results
+    ///   are identical to calling <see cref="FloatFromBits" /> on each value, except that
+    ///   signaling NaNs may turn into quiet NaNs.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void ConvertToFloats(
+      const Half *halfs, float *values, std::size_t count
+    );
+
+    /// <summary>Bits of the half equivalent to each normalized byte</summary>
+    private: NUCLEX_PIXELS_API static const std::uint16_t normalizedByteBits[256];
+
     /// <summary>Stores the bits of the half-precision floating point value</summary>
     private: std::uint16_t bits;
 
@@ -0,0 +1,167 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_MIPMAPCHAIN_H
+#define NUCLEX_PIXELS_MIPMAPCHAIN_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BitmapAllocator;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How the color channels of a bitmap relate to the light they represent</summary>
+  enum class MipmapColorSpace {
+
+    /// <summary>Channels are proportional to light intensity and averaged as-is</summary>
+    /// <remarks>
+    ///   Appropriate for floating point formats, normal maps and other non-color data.
+    /// </remarks>
+    Linear,
+
+    /// <summary>Color channels are sRGB-encoded and linearized before averaging</summary>
+    /// <remarks>
+    ///   Appropriate for almost all 8 bit color images (photos, albedo textures). Without
+    ///   this, smaller mipmap levels come out darker than they should be. The alpha
+    ///   channel is always averaged as-is.
+    /// </remarks>
+    Srgb
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a bitmap together with all of its successively halved versions</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each level is half the width and height of the previous one (but at least one
+  ///     pixel) and computed with a box filter that averages 2x2 pixels. Where a level
+  ///     has an odd width or height, the last column or row does not contribute to
+  ///     the next level.
+  ///   </para>
+  ///   <para>
+  ///     All levels are built in a single pass over the source bitmap: as soon as two
+  ///     rows of a level are complete, the next level's row is computed from them, so
+  ///     the pixels are still in the cache when they are needed again. Averaging happens
+  ///     in floating point (which is native for half and float pixel formats) and each
+  ///     level is computed from the unquantized previous level.
+  ///   </para>
+  ///   <para>
+  ///     The levels are stored in the pixel format of the source bitmap, tightly packed
+  ///     and one after another in a single memory block obtained from the default
+  ///     <see cref="BitmapAllocator" />, with each level starting on a 16 byte boundary.
+  ///     Any pixel format supported by the <see cref="PixelFormatConverter" /> can be used.
+  ///   </para>
+  /// </remarks>
+  class MipmapChain {
+
+    /// <summary>Counts the levels of a full mipmap chain for the specified size</summary>
+    /// <param name="width">Width of the largest level in pixels</param>
+    /// <param name="height">Height of the largest level in pixels</param>
+    /// <returns>The number of levels down to (and including) the 1x1 level</returns>
+    public: NUCLEX_PIXELS_API static std::size_t CountLevels(
+      std::size_t width, std::size_t height
+    );
+
+    /// <summary>Builds a mipmap chain from the specified bitmap</summary>
+    /// <param name="source">Bitmap memory holding the largest level</param>
+    /// <param name="colorSpace">Color space of the bitmap's color channels</param>
+    /// <param name="maximumLevelCount">
+    ///   Maximum number of levels to build (including the largest one), 0 to build
+    ///   the full chain down to a single pixel
+    /// </param>
+    public: NUCLEX_PIXELS_API explicit MipmapChain(
+      const BitmapMemory &source,
+      MipmapColorSpace colorSpace = MipmapColorSpace::Linear,
+      std::size_t maximumLevelCount = 0
+    );
+
+    /// <summary>Constructs a mipmap chain by taking over an existing one</summary>
+    /// <param name="other">Mipmap chain that will be taken over</param>
+    public: NUCLEX_PIXELS_API MipmapChain(MipmapChain &&other);
+
+    /// <summary>Frees the memory holding the levels</summary>
+    public: NUCLEX_PIXELS_API ~MipmapChain();
+
+    /// <summary>Counts the levels stored in the mipmap chain</summary>
+    /// <returns>The number of levels in the mipmap chain</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountLevels() const {
+      return this->levels.size();
+    }
+
+    /// <summary>Accesses the pixels of a level</summary>
+    /// <param name="levelIndex">Index of the level, 0 being the largest one</param>
+    /// <returns>A description of the level's memory layout</returns>
+    public: NUCLEX_PIXELS_API const BitmapMemory &GetLevel(std::size_t levelIndex) const {
+      return this->levels.at(levelIndex);
+    }
+
+    /// <summary>Returns the address of the memory block holding all levels</summary>
+    /// <returns>The address of the first level's first pixel</returns>
+    /// <remarks>
+    ///   Useful for uploading all levels to the GPU in one go.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API const void *GetPixels() const {
+      return this->levels.front().Pixels;
+    }
+
+    /// <summary>Counts the bytes in the memory block holding all levels</summary>
+    /// <returns>The number of bytes from the first level's first pixel to the end</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountBytes() const {
+      return this->pixelByteCount;
+    }
+
+    /// <summary>Takes over another mipmap chain</summary>
+    /// <param name="other">Other mipmap chain that will be taken over</param>
+    /// <returns>This mipmap chain</returns>
+    public: NUCLEX_PIXELS_API MipmapChain &operator =(MipmapChain &&other);
+
+    private: MipmapChain(const MipmapChain &) = delete;
+    private: MipmapChain &operator =(const MipmapChain &) = delete;
+
+    /// <summary>Frees the memory block holding the levels, if any</summary>
+    private: void free();
+
+    /// <summary>Memory layouts of all levels, starting with the largest one</summary>
+    private: std::vector<BitmapMemory> levels;
+    /// <summary>Allocator the memory block holding the levels was obtained from</summary>
+    private: BitmapAllocator *allocator;
+    /// <summary>Memory block holding the levels as returned by the allocator</summary>
+    private: void *memory;
+    /// <summary>Number of bytes that were requested from the allocator</summary>
+    private: std::size_t allocatedByteCount;
+    /// <summary>Number of bytes from the first level's first pixel to the end</summary>
+    private: std::size_t pixelByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_MIPMAPCHAIN_H
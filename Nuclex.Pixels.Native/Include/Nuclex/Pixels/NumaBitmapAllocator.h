@@ -0,0 +1,111 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_NUMABITMAPALLOCATOR_H
+#define NUCLEX_PIXELS_NUMABITMAPALLOCATOR_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapAllocator.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocator that spreads the pixels of large bitmaps over NUMA nodes</summary>
+  /// <remarks>
+  ///   <para>
+  ///     On systems with several NUMA nodes, memory is local to one node and accessing
+  ///     it from the cores of another node costs extra latency and interconnect bandwidth.
+  ///     A thread pool created with NUMA pinning hands the first share of each batch to
+  ///     the first node, the second share to the second node and so on. This allocator
+  ///     places the memory of a bitmap the same way: the rows in the first share of the
+  ///     bitmap are placed on the first node, the next share on the second node, so that
+  ///     the band-parallel kernels (<see cref="ForEachBandInParallel" />) mostly touch
+  ///     memory local to the cores they are running on.
+  ///   </para>
+  ///   <para>
+  ///     Each part is bound to its node explicitly where the system supports it. Otherwise
+  ///     the pages are left untouched and the system places each page on the node of
+  ///     the thread that writes to it first, which, if the first thing done with the
+  ///     bitmap is running a band-parallel kernel on the same thread pool, has the same
+  ///     effect. Small bitmaps and thread pools spanning only one node use plain heap
+  ///     memory, so this allocator can be used unconditionally.
+  ///   </para>
+  /// </remarks>
+  class NumaBitmapAllocator : public BitmapAllocator {
+
+    /// <summary>Initializes a new NUMA bitmap allocator</summary>
+    /// <param name="threadPool">
+    ///   Thread pool whose NUMA nodes the memory of large bitmaps will be spread over
+    /// </param>
+    /// <param name="bindToNodes">
+    ///   Whether to bind memory to the nodes explicitly rather than relying on
+    ///   the system placing pages on the node that touches them first
+    /// </param>
+    /// <remarks>
+    ///   The thread pool needs to stay alive for as long as the allocator is used.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API explicit NumaBitmapAllocator(
+      const ThreadPool &threadPool, bool bindToNodes = true
+    );
+
+    /// <summary>Destroys the allocator</summary>
+    /// <remarks>
+    ///   All bitmaps using memory from the allocator need to be destroyed before
+    ///   the allocator itself is destroyed.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API ~NumaBitmapAllocator() override = default;
+
+    /// <summary>Allocates a memory block for a bitmap</summary>
+    /// <param name="byteCount">Number of bytes the memory block needs to have</param>
+    /// <returns>The address of the memory block</returns>
+    public: NUCLEX_PIXELS_API void *Allocate(std::size_t byteCount) override;
+
+    /// <summary>Frees a memory block that was allocated for a bitmap</summary>
+    /// <param name="memory">Address of the memory block that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were requested for the block</param>
+    public: NUCLEX_PIXELS_API void Free(void *memory, std::size_t byteCount) throw() override;
+
+    /// <summary>Checks whether a memory block of the specified size is spread</summary>
+    /// <param name="byteCount">Number of bytes in the memory block</param>
+    /// <returns>True if memory blocks of this size are spread over the NUMA nodes</returns>
+    public: NUCLEX_PIXELS_API bool IsSpread(std::size_t byteCount) const;
+
+    private: NumaBitmapAllocator(const NumaBitmapAllocator &) = delete;
+    private: NumaBitmapAllocator &operator =(const NumaBitmapAllocator &) = delete;
+
+    /// <summary>Thread pool whose NUMA nodes the memory is spread over</summary>
+    private: const ThreadPool &threadPool;
+    /// <summary>Whether memory is explicitly bound to the NUMA nodes</summary>
+    private: bool bindToNodes;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_NUMABITMAPALLOCATOR_H
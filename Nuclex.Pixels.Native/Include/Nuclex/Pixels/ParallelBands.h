@@ -0,0 +1,195 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_PARALLELBANDS_H
+#define NUCLEX_PIXELS_PARALLELBANDS_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of bytes a horizontal band processed by one thread should cover</summary>
+  /// <remarks>
+  ///   Small enough that the pixels a thread works on fit into its share of the L2 cache,
+  ///   large enough that the overhead of handing out bands disappears next to the work.
+  /// </remarks>
+  const std::size_t PreferredBandByteCount = 256 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates how many rows the horizontal bands of a bitmap should have</summary>
+  /// <param name="rowByteCount">Number of bytes occupied by the pixels in one row</param>
+  /// <returns>The number of rows each band should have</returns>
+  inline std::size_t GetBandHeight(std::size_t rowByteCount) {
+    if(rowByteCount >= PreferredBandByteCount) {
+      return 1;
+    } else {
+      return PreferredBandByteCount / rowByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a horizontal band of rows inside a bitmap</summary>
+  /// <param name="memory">Bitmap memory the band will be taken from</param>
+  /// <param name="y">Index of the first row in the band</param>
+  /// <param name="height">Number of rows in the band</param>
+  /// <returns>Bitmap memory covering only the rows of the band</returns>
+  inline BitmapMemory GetBand(const BitmapMemory &memory, std::size_t y, std::size_t height) {
+    BitmapMemory band(memory);
+    band.Height = height;
+    band.Pixels = static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    );
+    return band;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splits a bitmap into horizontal bands and processes them in parallel</summary>
+  /// <typeparam name="TCallback">Callback that will be invoked on each band</typeparam>
+  /// <param name="threadPool">Thread pool that will process the bands</param>
+  /// <param name="memory">Bitmap memory that will be split into bands</param>
+  /// <param name="callback">
+  ///   Callback that will be invoked with the <see cref="BitmapMemory" /> of each band
+  ///   and the index of the band's first row in the bitmap
+  /// </param>
+  /// <remarks>
+  ///   <para>
+  ///     Each band is a bitmap memory of its own that shares the width, stride and pixel
+  ///     format of the original bitmap, so anything that works on bitmap memory (for
+  ///     example <see cref="ForEachRow" /> or <see cref="PixelFormatConverter.Convert" />)
+  ///     can be used to process a band. Views (as returned by
+  ///     <see cref="Bitmap.GetView" />) and negative strides are supported.
+  ///   </para>
+  ///   <para>
+  ///     The callback will be invoked from multiple threads at once, but each band
+  ///     is handed to exactly one thread.
+  ///   </para>
+  /// </remarks>
+  template<typename TCallback>
+  inline void ForEachBandInParallel(
+    ThreadPool &threadPool, const BitmapMemory &memory, TCallback &&callback
+  ) {
+    if(memory.Height == 0) {
+      return;
+    }
+
+    std::size_t rowByteCount = CountRequiredBytes(memory.PixelFormat, memory.Width);
+    if(rowByteCount == 0) {
+      return;
+    }
+
+    std::size_t bandHeight = GetBandHeight(rowByteCount);
+    std::size_t bandCount = (memory.Height + bandHeight - 1) / bandHeight;
+
+    threadPool.ForEach(
+      bandCount,
+      [&memory, &callback, bandHeight](std::size_t bandIndex) {
+        std::size_t y = bandIndex * bandHeight;
+        std::size_t height = memory.Height - y;
+        if(height > bandHeight) {
+          height = bandHeight;
+        }
+
+        BitmapMemory band = GetBand(memory, y, height);
+        callback(static_cast<const BitmapMemory &>(band), y);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>
+  ///   Splits two bitmaps of equal size into matching horizontal bands and processes
+  ///   them in parallel
+  /// </summary>
+  /// <typeparam name="TCallback">Callback that will be invoked on each pair of bands</typeparam>
+  /// <param name="threadPool">Thread pool that will process the bands</param>
+  /// <param name="source">Bitmap memory that will be split into source bands</param>
+  /// <param name="target">Bitmap memory that will be split into target bands</param>
+  /// <param name="callback">
+  ///   Callback that will be invoked with the source and target <see cref="BitmapMemory" />
+  ///   of each band and the index of the band's first row in the bitmaps
+  /// </param>
+  /// <remarks>
+  ///   The band height is chosen by the bitmap with the larger rows. Both bitmaps need
+  ///   to have the same height, otherwise an exception is thrown.
+  /// </remarks>
+  template<typename TCallback>
+  inline void ForEachBandInParallel(
+    ThreadPool &threadPool,
+    const BitmapMemory &source, const BitmapMemory &target,
+    TCallback &&callback
+  ) {
+    if(source.Height != target.Height) {
+      throw std::runtime_error(u8"Provided bitmaps do not have the same height");
+    }
+    if(source.Height == 0) {
+      return;
+    }
+
+    std::size_t rowByteCount = CountRequiredBytes(source.PixelFormat, source.Width);
+    {
+      std::size_t targetRowByteCount = CountRequiredBytes(target.PixelFormat, target.Width);
+      if(targetRowByteCount > rowByteCount) {
+        rowByteCount = targetRowByteCount;
+      }
+    }
+    if(rowByteCount == 0) {
+      return;
+    }
+
+    std::size_t bandHeight = GetBandHeight(rowByteCount);
+    std::size_t bandCount = (source.Height + bandHeight - 1) / bandHeight;
+
+    threadPool.ForEach(
+      bandCount,
+      [&source, &target, &callback, bandHeight](std::size_t bandIndex) {
+        std::size_t y = bandIndex * bandHeight;
+        std::size_t height = source.Height - y;
+        if(height > bandHeight) {
+          height = bandHeight;
+        }
+
+        BitmapMemory sourceBand = GetBand(source, y, height);
+        BitmapMemory targetBand = GetBand(target, y, height);
+        callback(
+          static_cast<const BitmapMemory &>(sourceBand),
+          static_cast<const BitmapMemory &>(targetBand),
+          y
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_PARALLELBANDS_H
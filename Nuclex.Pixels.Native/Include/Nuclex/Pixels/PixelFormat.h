@@ -191,7 +191,7 @@ namespace Nuclex { namespace Pixels {
 #if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
     R32_Float_Native32 = (4 << 24) | (32 << 16) | 16 | 7,
 #else
-    R32_Float_Native32 = (4 << 24) | (23 << 16) | 16 | 3,
+    R32_Float_Native32 = (4 << 24) | (32 << 16) | 16 | 3,
 #endif
 
     /// <summary>16 bits total with unsigned red and green channels</summary>
@@ -836,7 +836,7 @@ namespace Nuclex { namespace Pixels {
     ///   </para>
     /// </remarks>
 #if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
-    A32_B32_G32_R32_Float_Native32 = (16 << 24) | (64 << 16) | 4120 | 7,
+    A32_B32_G32_R32_Float_Native32 = (16 << 24) | (128 << 16) | 4120 | 7,
 #else
     A32_B32_G32_R32_Float_Native32 = A32_B32_G32_R32_Float,
 #endif
@@ -869,7 +869,7 @@ namespace Nuclex { namespace Pixels {
 #if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
     A32_B32_G32_R32_Float_Flipped32 = A32_B32_G32_R32_Float,
 #else
-    A32_B32_G32_R32_Float_Flipped32 = (16 << 24) | (64 << 16) | 4120 | 7,
+    A32_B32_G32_R32_Float_Flipped32 = (16 << 24) | (128 << 16) | 4120 | 7,
 #endif
 
     /// <summary>32 bit color with alpha using 8 bits for each channel</summary>
@@ -916,7 +916,7 @@ namespace Nuclex { namespace Pixels {
     ///   </para>
     /// </remarks>
 #if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
-    R32_G32_B32_A32_Float_Native32 = (16 << 24) | (64 << 16) | 4128 | 7,
+    R32_G32_B32_A32_Float_Native32 = (16 << 24) | (128 << 16) | 4128 | 7,
 #else
     R32_G32_B32_A32_Float_Native32 = R32_G32_B32_A32_Float,
 #endif
@@ -949,7 +949,7 @@ namespace Nuclex { namespace Pixels {
 #if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
     R32_G32_B32_A32_Float_Flipped32 = R32_G32_B32_A32_Float,
 #else
-    R32_G32_B32_A32_Float_Flipped32 = (16 << 24) | (64 << 16) | 4128 | 7,
+    R32_G32_B32_A32_Float_Flipped32 = (16 << 24) | (128 << 16) | 4128 | 7,
 #endif
 
     #pragma endregion // A32_B32_G32_R32 and R32_G32_B32_A32 float formats
@@ -1365,6 +1365,75 @@ namespace Nuclex { namespace Pixels {
 
     #pragma endregion // A2_R10_G10_B10 and A2_B10_G10_R10 formats
 
+    #pragma region BCn block-compressed formats
+
+    /// <summary>4x4 pixel blocks of 64 bits with RGB and optional 1 bit alpha<summary>
+    /// <remarks>
+    ///   <para>
+    ///     Also known as DXT1. Each block stores two R5-G6-B5 colors and a 2 bit index
+    ///     per pixel selecting one of four colors interpolated between them.
+    ///   </para>
+    ///   <para>
+    ///     Compatible with DXGI_FORMAT_BC1_UNORM, VK_FORMAT_BC1_RGBA_UNORM_BLOCK and
+    ///     GL_COMPRESSED_RGBA_S3TC_DXT1_EXT.
+    ///   </para>
+    /// </remarks>
+    BC1_Compressed = (8 << 24) | (4 << 16) | 16384 | 0,
+
+    /// <summary>4x4 pixel blocks of 128 bits with RGB and interpolated alpha<summary>
+    /// <remarks>
+    ///   <para>
+    ///     Also known as DXT5. Each block stores a BC4 block for the alpha channel
+    ///     followed by a BC1 block for the color channels.
+    ///   </para>
+    ///   <para>
+    ///     Compatible with DXGI_FORMAT_BC3_UNORM, VK_FORMAT_BC3_UNORM_BLOCK and
+    ///     GL_COMPRESSED_RGBA_S3TC_DXT5_EXT.
+    ///   </para>
+    /// </remarks>
+    BC3_Compressed = (16 << 24) | (8 << 16) | 16392 | 0,
+
+    /// <summary>4x4 pixel blocks of 64 bits with a single channel<summary>
+    /// <remarks>
+    ///   <para>
+    ///     Each block stores two 8 bit values and a 3 bit index per pixel selecting
+    ///     one of eight values interpolated between them.
+    ///   </para>
+    ///   <para>
+    ///     Compatible with DXGI_FORMAT_BC4_UNORM, VK_FORMAT_BC4_UNORM_BLOCK and
+    ///     GL_COMPRESSED_RED_RGTC1.
+    ///   </para>
+    /// </remarks>
+    BC4_Compressed = (8 << 24) | (4 << 16) | 16400 | 0,
+
+    /// <summary>4x4 pixel blocks of 128 bits with two channels<summary>
+    /// <remarks>
+    ///   <para>
+    ///     Each block stores two BC4 blocks, one for red and one for green. Commonly
+    ///     used for normal maps.
+    ///   </para>
+    ///   <para>
+    ///     Compatible with DXGI_FORMAT_BC5_UNORM, VK_FORMAT_BC5_UNORM_BLOCK and
+    ///     GL_COMPRESSED_RG_RGTC2.
+    ///   </para>
+    /// </remarks>
+    BC5_Compressed = (16 << 24) | (8 << 16) | 16408 | 0,
+
+    /// <summary>4x4 pixel blocks of 128 bits with high quality RGBA<summary>
+    /// <remarks>
+    ///   <para>
+    ///     Each block can use one of eight modes with different partitionings and
+    ///     endpoint precisions.
+    ///   </para>
+    ///   <para>
+    ///     Compatible with DXGI_FORMAT_BC7_UNORM, VK_FORMAT_BC7_UNORM_BLOCK and
+    ///     GL_COMPRESSED_RGBA_BPTC_UNORM.
+    ///   </para>
+    /// </remarks>
+    BC7_Compressed = (16 << 24) | (8 << 16) | 16416 | 0,
+
+    #pragma endregion // BCn block-compressed formats
+
   };
 
   //#define SMALLEST_UNIT(size) (size << 24)
@@ -1416,22 +1485,20 @@ namespace Nuclex { namespace Pixels {
   ///   Pixel format whose smallest interdependent block size will be returned
   /// </param>
   /// <returns>The size fo the smallest interdependent block in the pixel format</returns>
+  /// <remarks>
+  ///   Block-compressed pixel formats store their blocks one after another. The stride
+  ///   of bitmaps in those formats still counts the bytes per row of pixels, so a row
+  ///   of blocks spans the stride multiplied by the block height.
+  /// </remarks>
   inline NUCLEX_PIXELS_API Size GetBlockSize(PixelFormat pixelFormat) {
     switch(pixelFormat) {
-#if 0
-      case OldPixelFormat::BC1_Compressed:
-      case OldPixelFormat::BC2_Compressed:
-      case OldPixelFormat::BC3_Compressed:
-      case OldPixelFormat::BC4_Compressed:
-      case OldPixelFormat::BC5_Compressed:
-      case OldPixelFormat::BC6_Compressed:
-      case OldPixelFormat::BC7_Compressed: {
+      case PixelFormat::BC1_Compressed:
+      case PixelFormat::BC3_Compressed:
+      case PixelFormat::BC4_Compressed:
+      case PixelFormat::BC5_Compressed:
+      case PixelFormat::BC7_Compressed: {
         return Size(4, 4);
       }
-#endif
-      case PixelFormat::R8_Unsigned: { // Shut up compiler warnings until BCx reintroduced
-        return Size(1, 1);
-      }
       default: {
         return Size(1, 1);
       }
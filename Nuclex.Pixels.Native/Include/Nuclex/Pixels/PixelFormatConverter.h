@@ -0,0 +1,183 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_PIXELFORMATCONVERTER_H
+#define NUCLEX_PIXELS_PIXELFORMATCONVERTER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/PixelFormat.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/DitheringMethod.h"
+#include "Nuclex/Pixels/RowStream.h"
+#include "Nuclex/Pixels/ColorModels/RgbColor.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts pixels from one pixel format into another</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The converter looks at the layout of the source and target pixel formats and
+  ///     picks the fastest row kernel it has for the combination. Byte reordering between
+  ///     the 32 bit RGBA, BGRA, ABGR and ARGB formats as well as packing and unpacking of
+  ///     R5-G6-B5 formats use SIMD instructions (SSE2, SSSE3, AVX2 or NEON, depending on
+  ///     what the compiler targets). Anything else goes through a generic path that
+  ///     decodes pixels into normalized floating point RGBA and encodes them again.
+  ///   </para>
+  ///   <para>
+  ///     Channels missing in the source pixel format are set to zero in the target pixel
+  ///     format, except for alpha, which is set to fully opaque. Channels missing in
+  ///     the target pixel format are simply dropped, so converting R8-G8-B8-A8 to
+  ///     R8 will keep only the red channel (no luminance calculation is performed).
+  ///   </para>
+  ///   <para>
+  ///     Reducing the precision of a channel rounds to the nearest representable value
+  ///     unless dithering is requested. Converting from a lower precision to a higher
+  ///     precision and back is lossless, so R5-G6-B5 to R8-G8-B8-A8 and back again yields
+  ///     the original pixels.
+  ///   </para>
+  ///   <para>
+  ///     Dithering only applies to the color channels and only when the target pixel
+  ///     format stores them as unsigned integers with less precision than the source
+  ///     pixel format has. Otherwise the conversion is exactly the same as without.
+  ///   </para>
+  /// </remarks>
+  class PixelFormatConverter {
+
+    /// <summary>Checks whether pixels can be converted between two pixel formats</summary>
+    /// <param name="sourcePixelFormat">Pixel format of the pixels being converted</param>
+    /// <param name="targetPixelFormat">Pixel format the pixels would be converted to</param>
+    /// <returns>True if converting between the two pixel formats is supported</returns>
+    public: NUCLEX_PIXELS_API static bool CanConvert(
+      PixelFormat sourcePixelFormat, PixelFormat targetPixelFormat
+    );
+
+    /// <summary>Converts a continuous row of pixels into another pixel format</summary>
+    /// <param name="sourcePixelFormat">Pixel format the source pixels are stored in</param>
+    /// <param name="sourcePixels">Address of the first pixel that will be converted</param>
+    /// <param name="targetPixelFormat">Pixel format the pixels will be converted to</param>
+    /// <param name="targetPixels">Address at which the converted pixels will be stored</param>
+    /// <param name="pixelCount">Number of pixels that will be converted</param>
+    /// <remarks>
+    ///   The source and target memory areas must not overlap. If many rows need to
+    ///   be converted, prefer <see cref="Convert" /> since it selects the row kernel
+    ///   only once for the whole bitmap.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void ConvertRow(
+      PixelFormat sourcePixelFormat, const void *sourcePixels,
+      PixelFormat targetPixelFormat, void *targetPixels,
+      std::size_t pixelCount
+    );
+
+    /// <summary>Encodes a color as a single pixel in the specified pixel format</summary>
+    /// <param name="color">Color that will be encoded</param>
+    /// <param name="pixelFormat">Pixel format the pixel will be stored in</param>
+    /// <param name="pixel">
+    ///   Address at which the pixel will be stored, needs room for one pixel
+    /// </param>
+    /// <remarks>
+    ///   Channels the pixel format does not have are dropped and integer channels are
+    ///   rounded to the nearest value they can represent, exactly as when converting
+    ///   pixels from <see cref="PixelFormat.R32_G32_B32_A32_Float_Native32" />.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void EncodeColor(
+      const ColorModels::RgbColor &color, PixelFormat pixelFormat, void *pixel
+    );
+
+    /// <summary>Converts all pixels of a bitmap into another bitmap</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the converted pixels will be written to</param>
+    /// <remarks>
+    ///   Both bitmaps must have the same dimensions. The pixel formats of the bitmaps
+    ///   decide the conversion that will take place, strides (including negative ones)
+    ///   are respected for both bitmaps.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Convert(
+      const BitmapMemory &source, const BitmapMemory &target
+    );
+
+    /// <summary>Converts all pixels of a bitmap into another bitmap in parallel</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the converted pixels will be written to</param>
+    /// <param name="threadPool">Thread pool that will share the work of converting</param>
+    /// <remarks>
+    ///   Works like the single-threaded <see cref="Convert" /> but splits the bitmaps
+    ///   into horizontal bands that are converted by the threads of the thread pool.
+    ///   The source and target bitmaps must not overlap.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Convert(
+      const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+    );
+
+    /// <summary>Converts all pixels of a bitmap into another bitmap with dithering</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the converted pixels will be written to</param>
+    /// <param name="dithering">Dithering that is applied when precision is reduced</param>
+    /// <remarks>
+    ///   Useful when converting float or 16 bit pixels into 8 bit or R5-G6-B5 pixels,
+    ///   where rounding would produce visible bands in smooth gradients.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Convert(
+      const BitmapMemory &source, const BitmapMemory &target, DitheringMethod dithering
+    );
+
+    /// <summary>Converts all pixels of a bitmap into another bitmap with dithering</summary>
+    /// <param name="source">Bitmap memory the pixels will be read from</param>
+    /// <param name="target">Bitmap memory the converted pixels will be written to</param>
+    /// <param name="dithering">Dithering that is applied when precision is reduced</param>
+    /// <param name="threadPool">Thread pool that will share the work of converting</param>
+    /// <remarks>
+    ///   The dithering patterns are tied to the pixel coordinates, so the result is
+    ///   identical to that of the single-threaded conversion.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Convert(
+      const BitmapMemory &source, const BitmapMemory &target,
+      DitheringMethod dithering, ThreadPool &threadPool
+    );
+
+    /// <summary>Wraps a row source so that its rows are converted as they are read</summary>
+    /// <param name="source">Row source whose rows will be converted</param>
+    /// <param name="targetPixelFormat">Pixel format the rows will be converted to</param>
+    /// <returns>A row source providing the converted rows</returns>
+    /// <remarks>
+    ///   The returned row source takes ownership of the wrapped row source. Rows are
+    ///   read from it in bands of a few hundred kilobytes at most, so converting images
+    ///   too large to fit in memory works. If the row source already provides the requested
+    ///   pixel format, it is returned as it is.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::unique_ptr<RowSource> ConvertRows(
+      std::unique_ptr<RowSource> &&source, PixelFormat targetPixelFormat
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_PIXELFORMATCONVERTER_H
@@ -0,0 +1,527 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_PIXELFORMATTRAITS_H
+#define NUCLEX_PIXELS_PIXELFORMATTRAITS_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/PixelFormat.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  namespace Private {
+
+    /// <summary>Layout of a pixel format's channels as decoded from the enum value</summary>
+    struct PixelFormatDescription {
+
+      /// <summary>Whether the enum value describes a pixel format that exists</summary>
+      public: bool IsSupported;
+      /// <summary>Number of channels present in the pixel format</summary>
+      public: std::size_t ChannelCount;
+      /// <summary>Whether the channels are floating point values</summary>
+      public: bool IsFloat;
+      /// <summary>Whether the channels are signed integers</summary>
+      public: bool IsSigned;
+      /// <summary>Whether all channels are packed together into one word</summary>
+      public: bool IsPacked;
+      /// <summary>Whether words use the opposite of the platform's byte order</summary>
+      public: bool HasFlippedWords;
+      /// <summary>Offset of the red, green, blue and alpha channels in bits</summary>
+      public: int BitOffsets[4];
+      /// <summary>Number of bits in the red, green, blue and alpha channels</summary>
+      public: int BitCounts[4];
+
+    };
+
+    /// <summary>Creates a description of a pixel format's channels</summary>
+    /// <param name="channelBitCount">Number of bits in each channel</param>
+    /// <param name="red">Index of the red channel inside the pixel, -1 if missing</param>
+    /// <param name="green">Index of the green channel inside the pixel, -1 if missing</param>
+    /// <param name="blue">Index of the blue channel inside the pixel, -1 if missing</param>
+    /// <param name="alpha">Index of the alpha channel inside the pixel, -1 if missing</param>
+    /// <returns>A description of a pixel format with equally sized channels</returns>
+    constexpr PixelFormatDescription DescribeChannels(
+      int channelBitCount, int red, int green, int blue, int alpha
+    ) {
+      PixelFormatDescription description = {};
+      const int indices[4] = { red, green, blue, alpha };
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        if(indices[channel] >= 0) {
+          description.BitOffsets[channel] = indices[channel] * channelBitCount;
+          description.BitCounts[channel] = channelBitCount;
+          ++description.ChannelCount;
+        } else {
+          description.BitOffsets[channel] = -1;
+          description.BitCounts[channel] = 0;
+        }
+      }
+
+      return description;
+    }
+
+    /// <summary>Creates a description of a pixel format with packed channels</summary>
+    /// <param name="offsets">Shift of the red, green, blue and alpha bits in the word</param>
+    /// <param name="counts">Number of bits in the red, green, blue and alpha channels</param>
+    /// <returns>A description of a pixel format whose channels are packed into a word</returns>
+    constexpr PixelFormatDescription DescribePackedChannels(
+      int redOffset, int redCount, int greenOffset, int greenCount,
+      int blueOffset, int blueCount, int alphaOffset, int alphaCount
+    ) {
+      PixelFormatDescription description = {};
+      description.IsPacked = true;
+      description.BitOffsets[0] = redOffset;
+      description.BitOffsets[1] = greenOffset;
+      description.BitOffsets[2] = blueOffset;
+      description.BitOffsets[3] = alphaOffset;
+      description.BitCounts[0] = redCount;
+      description.BitCounts[1] = greenCount;
+      description.BitCounts[2] = blueCount;
+      description.BitCounts[3] = alphaCount;
+      description.ChannelCount = (alphaCount > 0) ? 4 : 3;
+      return description;
+    }
+
+    /// <summary>Decodes the layout of a pixel format's channels from its enum value</summary>
+    /// <param name="pixelFormat">Pixel format whose channel layout will be decoded</param>
+    /// <returns>A description of the channel layout</returns>
+    /// <remarks>
+    ///   The lower 16 bits of a pixel format identify its channel order and data type
+    ///   (see the PixelFormat enumeration). The lowest 3 bits hold the data type variant
+    ///   where bit 2 indicates little endian words. For the 8 bit RGBA formats, this bit
+    ///   is used to express the byte-reversed format.
+    /// </remarks>
+    constexpr PixelFormatDescription DescribePixelFormat(PixelFormat pixelFormat) {
+      std::size_t format = static_cast<std::size_t>(pixelFormat);
+      std::size_t id = format & 0xFFF8;
+      std::size_t variant = format & 7;
+
+      PixelFormatDescription description = {};
+      switch(id) {
+        case 0: { // R8
+          description = DescribeChannels(8, 0, -1, -1, -1);
+          description.IsSupported = (variant == 0);
+          break;
+        }
+        case 8: { // R16
+          description = DescribeChannels(16, 0, -1, -1, -1);
+          description.IsFloat = ((variant & 3) == 3);
+          description.IsSupported = ((variant & 3) == 0) || ((variant & 3) == 3);
+          break;
+        }
+        case 16: { // R32
+          description = DescribeChannels(32, 0, -1, -1, -1);
+          description.IsFloat = true;
+          description.IsSupported = ((variant & 3) == 3);
+          break;
+        }
+        case 1024: { // R8-G8
+          description = DescribeChannels(8, 0, 1, -1, -1);
+          description.IsSupported = (variant == 0);
+          break;
+        }
+        case 1032: { // R16-G16
+          description = DescribeChannels(16, 0, 1, -1, -1);
+          description.IsFloat = ((variant & 3) == 3);
+          description.IsSupported = ((variant & 3) == 0) || ((variant & 3) == 3);
+          break;
+        }
+        case 2048: { // R5-G6-B5
+          description = DescribePackedChannels(11, 5, 5, 6, 0, 5, -1, 0);
+          description.IsSupported = ((variant & 3) == 0);
+          break;
+        }
+        case 2056: { // B5-G6-R5
+          description = DescribePackedChannels(0, 5, 5, 6, 11, 5, -1, 0);
+          description.IsSupported = ((variant & 3) == 0);
+          break;
+        }
+        case 3072: { // R8-G8-B8
+          description = DescribeChannels(8, 0, 1, 2, -1);
+          description.IsSigned = (variant == 1);
+          description.IsSupported = (variant < 2);
+          break;
+        }
+        case 3080: { // B8-G8-R8
+          description = DescribeChannels(8, 2, 1, 0, -1);
+          description.IsSigned = (variant == 1);
+          description.IsSupported = (variant < 2);
+          break;
+        }
+        case 4096: { // A8-B8-G8-R8 and the byte-reversed R8-G8-B8-A8
+          if((variant & 4) == 0) {
+            description = DescribeChannels(8, 3, 2, 1, 0);
+          } else {
+            description = DescribeChannels(8, 0, 1, 2, 3);
+          }
+          description.IsSigned = ((variant & 1) != 0);
+          description.IsSupported = ((variant & 3) < 2);
+          break;
+        }
+        case 5120: // B8-G8-R8-A8 and the byte-reversed A8-R8-G8-B8
+        case 5128: { // Signed variants of the above
+          if((variant & 4) == 0) {
+            description = DescribeChannels(8, 2, 1, 0, 3);
+          } else {
+            description = DescribeChannels(8, 1, 2, 3, 0);
+          }
+          description.IsSigned = (id == 5128);
+          description.IsSupported = ((variant & 3) == (description.IsSigned ? 1U : 0U));
+          break;
+        }
+        case 4104: { // A16-B16-G16-R16
+          description = DescribeChannels(16, 3, 2, 1, 0);
+          description.IsFloat = true;
+          description.IsSupported = ((variant & 3) == 3);
+          break;
+        }
+        case 4112: { // R16-G16-B16-A16
+          description = DescribeChannels(16, 0, 1, 2, 3);
+          description.IsFloat = true;
+          description.IsSupported = ((variant & 3) == 3);
+          break;
+        }
+        case 8192: { // B16-G16-R16-A16
+          description = DescribeChannels(16, 2, 1, 0, 3);
+          description.IsFloat = true;
+          description.IsSupported = ((variant & 3) == 3);
+          break;
+        }
+        case 8200: { // A16-R16-G16-B16
+          description = DescribeChannels(16, 1, 2, 3, 0);
+          description.IsFloat = true;
+          description.IsSupported = ((variant & 3) == 3);
+          break;
+        }
+        case 4120: { // A32-B32-G32-R32
+          description = DescribeChannels(32, 3, 2, 1, 0);
+          description.IsFloat = true;
+          description.IsSupported = ((variant & 3) == 3);
+          break;
+        }
+        case 4128: { // R32-G32-B32-A32
+          description = DescribeChannels(32, 0, 1, 2, 3);
+          description.IsFloat = true;
+          description.IsSupported = ((variant & 3) == 3);
+          break;
+        }
+        case 6144: { // A2-R10-G10-B10
+          description = DescribePackedChannels(20, 10, 10, 10, 0, 10, 30, 2);
+          description.IsSupported = ((variant & 3) == 0);
+          break;
+        }
+        case 6152: { // A2-B10-G10-R10
+          description = DescribePackedChannels(0, 10, 10, 10, 20, 10, 30, 2);
+          description.IsSupported = ((variant & 3) == 0);
+          break;
+        }
+        default: {
+          description.IsSupported = false;
+          break;
+        }
+      }
+
+      // Byte order only matters for channels made of words and packed channels
+      if(description.IsPacked || (description.BitCounts[0] >= 16)) {
+#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+        description.HasFlippedWords = ((variant & 4) == 0);
+#else
+        description.HasFlippedWords = ((variant & 4) != 0);
+#endif
+      }
+
+      return description;
+    }
+
+  } // namespace Private
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the layout of a pixel format at compile time</summary>
+  /// <typeparam name="TPixelFormat">Pixel format that will be described</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Everything that <see cref="CountBitsPerPixel" /> and friends decode from the enum
+  ///     at runtime is available here as a compile-time constant, so kernels taking
+  ///     the traits as a template argument compile into loops specialized for exactly
+  ///     one pixel format. Use <see cref="VisitPixelFormat" /> to pick the right
+  ///     instantiation for a pixel format only known at runtime.
+  ///   </para>
+  ///   <para>
+  ///     For pixel formats made up of bytes or words, the bit offsets count from the start
+  ///     of the pixel in memory, so the channel at bit offset 16 of an R8-G8-B8-A8 pixel
+  ///     is the third byte. For packed pixel formats (such as R5-G6-B5), they are the
+  ///     number of bits the channel is shifted to the left inside the native word after
+  ///     correcting the byte order (if <see cref="HasFlippedWords" /> is set).
+  ///   </para>
+  /// </remarks>
+  template<PixelFormat TPixelFormat>
+  struct PixelFormatTraits {
+
+    /// <summary>Full description of the pixel format decoded at compile time</summary>
+    private: static constexpr Private::PixelFormatDescription description = (
+      Private::DescribePixelFormat(TPixelFormat)
+    );
+
+    static_assert(description.IsSupported, u8"Pixel format must be a valid pixel format");
+
+    /// <summary>The pixel format being described</summary>
+    public: static constexpr PixelFormat Format = TPixelFormat;
+    /// <summary>Number of bits each pixel occupies</summary>
+    public: static constexpr std::size_t BitsPerPixel = CountBitsPerPixel(TPixelFormat);
+    /// <summary>Number of bytes each pixel occupies</summary>
+    public: static constexpr std::size_t BytesPerPixel = CountBytesPerBlock(TPixelFormat);
+    /// <summary>Number of channels present in each pixel</summary>
+    public: static constexpr std::size_t ChannelCount = description.ChannelCount;
+
+    /// <summary>Whether the channels are floating point values</summary>
+    public: static constexpr bool IsFloat = description.IsFloat;
+    /// <summary>Whether the channels are signed integers</summary>
+    public: static constexpr bool IsSigned = description.IsSigned;
+    /// <summary>Whether all channels are packed together into one word</summary>
+    public: static constexpr bool IsPacked = description.IsPacked;
+    /// <summary>Whether words use the opposite of the platform's byte order</summary>
+    public: static constexpr bool HasFlippedWords = description.HasFlippedWords;
+    /// <summary>Whether the pixel format has an alpha channel</summary>
+    public: static constexpr bool HasAlpha = (description.BitCounts[3] > 0);
+
+    /// <summary>Offset of the red channel in bits, -1 if not present</summary>
+    public: static constexpr int RedBitOffset = description.BitOffsets[0];
+    /// <summary>Number of bits in the red channel</summary>
+    public: static constexpr int RedBitCount = description.BitCounts[0];
+    /// <summary>Offset of the green channel in bits, -1 if not present</summary>
+    public: static constexpr int GreenBitOffset = description.BitOffsets[1];
+    /// <summary>Number of bits in the green channel, 0 if not present</summary>
+    public: static constexpr int GreenBitCount = description.BitCounts[1];
+    /// <summary>Offset of the blue channel in bits, -1 if not present</summary>
+    public: static constexpr int BlueBitOffset = description.BitOffsets[2];
+    /// <summary>Number of bits in the blue channel, 0 if not present</summary>
+    public: static constexpr int BlueBitCount = description.BitCounts[2];
+    /// <summary>Offset of the alpha channel in bits, -1 if not present</summary>
+    public: static constexpr int AlphaBitOffset = description.BitOffsets[3];
+    /// <summary>Number of bits in the alpha channel, 0 if not present</summary>
+    public: static constexpr int AlphaBitCount = description.BitCounts[3];
+
+  };
+
+  // Out-of-class definitions so the constants can be bound to references (C++14)
+  template<PixelFormat TPixelFormat>
+  constexpr Private::PixelFormatDescription PixelFormatTraits<TPixelFormat>::description;
+  template<PixelFormat TPixelFormat>
+  constexpr PixelFormat PixelFormatTraits<TPixelFormat>::Format;
+  template<PixelFormat TPixelFormat>
+  constexpr std::size_t PixelFormatTraits<TPixelFormat>::BitsPerPixel;
+  template<PixelFormat TPixelFormat>
+  constexpr std::size_t PixelFormatTraits<TPixelFormat>::BytesPerPixel;
+  template<PixelFormat TPixelFormat>
+  constexpr std::size_t PixelFormatTraits<TPixelFormat>::ChannelCount;
+  template<PixelFormat TPixelFormat>
+  constexpr bool PixelFormatTraits<TPixelFormat>::IsFloat;
+  template<PixelFormat TPixelFormat>
+  constexpr bool PixelFormatTraits<TPixelFormat>::IsSigned;
+  template<PixelFormat TPixelFormat>
+  constexpr bool PixelFormatTraits<TPixelFormat>::IsPacked;
+  template<PixelFormat TPixelFormat>
+  constexpr bool PixelFormatTraits<TPixelFormat>::HasFlippedWords;
+  template<PixelFormat TPixelFormat>
+  constexpr bool PixelFormatTraits<TPixelFormat>::HasAlpha;
+  template<PixelFormat TPixelFormat>
+  constexpr int PixelFormatTraits<TPixelFormat>::RedBitOffset;
+  template<PixelFormat TPixelFormat>
+  constexpr int PixelFormatTraits<TPixelFormat>::RedBitCount;
+  template<PixelFormat TPixelFormat>
+  constexpr int PixelFormatTraits<TPixelFormat>::GreenBitOffset;
+  template<PixelFormat TPixelFormat>
+  constexpr int PixelFormatTraits<TPixelFormat>::GreenBitCount;
+  template<PixelFormat TPixelFormat>
+  constexpr int PixelFormatTraits<TPixelFormat>::BlueBitOffset;
+  template<PixelFormat TPixelFormat>
+  constexpr int PixelFormatTraits<TPixelFormat>::BlueBitCount;
+  template<PixelFormat TPixelFormat>
+  constexpr int PixelFormatTraits<TPixelFormat>::AlphaBitOffset;
+  template<PixelFormat TPixelFormat>
+  constexpr int PixelFormatTraits<TPixelFormat>::AlphaBitCount;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Invokes a templated kernel specialized for a pixel format known at runtime</summary>
+  /// <typeparam name="TVisitor">Callable object that accepts any pixel format's traits</typeparam>
+  /// <param name="pixelFormat">Pixel format the visitor will be specialized for</param>
+  /// <param name="visitor">
+  ///   Visitor that will be invoked with a <see cref="PixelFormatTraits" /> instance
+  ///   of the pixel format, usually a generic lambda (taking an <code>auto</code>)
+  /// </param>
+  /// <returns>Whatever the visitor returns</returns>
+  /// <remarks>
+  ///   <para>
+  ///     The visitor is instantiated once for every pixel format, so it should be
+  ///     a small dispatcher into the actual kernel, which can use
+  ///     <code>decltype(traits)</code> to access the compile-time constants:
+  ///   </para>
+  ///   <code>
+  ///     VisitPixelFormat(
+  ///       memory.PixelFormat,
+  ///       [&amp;](auto traits) { invertRows&lt;decltype(traits)&gt;(memory); }
+  ///     );
+  ///   </code>
+  ///   <para>
+  ///     Pixel formats that are aliases of each other (such as the native or flipped
+  ///     variants matching the platform's byte order) share one instantiation.
+  ///     An exception is thrown for values that do not describe a valid pixel format.
+  ///   </para>
+  /// </remarks>
+  template<typename TVisitor>
+  inline auto VisitPixelFormat(PixelFormat pixelFormat, TVisitor &&visitor) -> decltype(
+    std::forward<TVisitor>(visitor)(PixelFormatTraits<PixelFormat::R8_Unsigned>())
+  ) {
+    switch(pixelFormat) {
+      case PixelFormat::R8_Unsigned: {
+        return visitor(PixelFormatTraits<PixelFormat::R8_Unsigned>());
+      }
+      case PixelFormat::R16_Unsigned_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::R16_Unsigned_Native16>());
+      }
+      case PixelFormat::R16_Float_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::R16_Float_Native16>());
+      }
+      case PixelFormat::R32_Float_Native32: {
+        return visitor(PixelFormatTraits<PixelFormat::R32_Float_Native32>());
+      }
+      case PixelFormat::R8_G8_Unsigned: {
+        return visitor(PixelFormatTraits<PixelFormat::R8_G8_Unsigned>());
+      }
+      case PixelFormat::R16_G16_Unsigned_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::R16_G16_Unsigned_Native16>());
+      }
+      case PixelFormat::R16_G16_Float_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::R16_G16_Float_Native16>());
+      }
+      case PixelFormat::R5_G6_B5_Unsigned_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::R5_G6_B5_Unsigned_Native16>());
+      }
+      case PixelFormat::R5_G6_B5_Unsigned_Flipped16: {
+        return visitor(PixelFormatTraits<PixelFormat::R5_G6_B5_Unsigned_Flipped16>());
+      }
+      case PixelFormat::B5_G6_R5_Unsigned_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::B5_G6_R5_Unsigned_Native16>());
+      }
+      case PixelFormat::B5_G6_R5_Unsigned_Flipped16: {
+        return visitor(PixelFormatTraits<PixelFormat::B5_G6_R5_Unsigned_Flipped16>());
+      }
+      case PixelFormat::R8_G8_B8_Unsigned: {
+        return visitor(PixelFormatTraits<PixelFormat::R8_G8_B8_Unsigned>());
+      }
+      case PixelFormat::R8_G8_B8_Signed: {
+        return visitor(PixelFormatTraits<PixelFormat::R8_G8_B8_Signed>());
+      }
+      case PixelFormat::B8_G8_R8_Unsigned: {
+        return visitor(PixelFormatTraits<PixelFormat::B8_G8_R8_Unsigned>());
+      }
+      case PixelFormat::B8_G8_R8_Signed: {
+        return visitor(PixelFormatTraits<PixelFormat::B8_G8_R8_Signed>());
+      }
+      case PixelFormat::R8_G8_B8_A8_Unsigned: {
+        return visitor(PixelFormatTraits<PixelFormat::R8_G8_B8_A8_Unsigned>());
+      }
+      case PixelFormat::R8_G8_B8_A8_Signed: {
+        return visitor(PixelFormatTraits<PixelFormat::R8_G8_B8_A8_Signed>());
+      }
+      case PixelFormat::A8_B8_G8_R8_Unsigned: {
+        return visitor(PixelFormatTraits<PixelFormat::A8_B8_G8_R8_Unsigned>());
+      }
+      case PixelFormat::A8_B8_G8_R8_Signed: {
+        return visitor(PixelFormatTraits<PixelFormat::A8_B8_G8_R8_Signed>());
+      }
+      case PixelFormat::B8_G8_R8_A8_Unsigned: {
+        return visitor(PixelFormatTraits<PixelFormat::B8_G8_R8_A8_Unsigned>());
+      }
+      case PixelFormat::B8_G8_R8_A8_Signed: {
+        return visitor(PixelFormatTraits<PixelFormat::B8_G8_R8_A8_Signed>());
+      }
+      case PixelFormat::A8_R8_G8_B8_Unsigned: {
+        return visitor(PixelFormatTraits<PixelFormat::A8_R8_G8_B8_Unsigned>());
+      }
+      case PixelFormat::A8_R8_G8_B8_Signed: {
+        return visitor(PixelFormatTraits<PixelFormat::A8_R8_G8_B8_Signed>());
+      }
+      case PixelFormat::R16_G16_B16_A16_Float_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::R16_G16_B16_A16_Float_Native16>());
+      }
+      case PixelFormat::R16_G16_B16_A16_Float_Flipped16: {
+        return visitor(PixelFormatTraits<PixelFormat::R16_G16_B16_A16_Float_Flipped16>());
+      }
+      case PixelFormat::A16_B16_G16_R16_Float_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::A16_B16_G16_R16_Float_Native16>());
+      }
+      case PixelFormat::A16_B16_G16_R16_Float_Flipped16: {
+        return visitor(PixelFormatTraits<PixelFormat::A16_B16_G16_R16_Float_Flipped16>());
+      }
+      case PixelFormat::B16_G16_R16_A16_Float_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::B16_G16_R16_A16_Float_Native16>());
+      }
+      case PixelFormat::B16_G16_R16_A16_Float_Flipped16: {
+        return visitor(PixelFormatTraits<PixelFormat::B16_G16_R16_A16_Float_Flipped16>());
+      }
+      case PixelFormat::A16_R16_G16_B16_Float_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::A16_R16_G16_B16_Float_Native16>());
+      }
+      case PixelFormat::A16_R16_G16_B16_Float_Flipped16: {
+        return visitor(PixelFormatTraits<PixelFormat::A16_R16_G16_B16_Float_Flipped16>());
+      }
+      case PixelFormat::R32_G32_B32_A32_Float_Native32: {
+        return visitor(PixelFormatTraits<PixelFormat::R32_G32_B32_A32_Float_Native32>());
+      }
+      case PixelFormat::R32_G32_B32_A32_Float_Flipped32: {
+        return visitor(PixelFormatTraits<PixelFormat::R32_G32_B32_A32_Float_Flipped32>());
+      }
+      case PixelFormat::A32_B32_G32_R32_Float_Native32: {
+        return visitor(PixelFormatTraits<PixelFormat::A32_B32_G32_R32_Float_Native32>());
+      }
+      case PixelFormat::A32_B32_G32_R32_Float_Flipped32: {
+        return visitor(PixelFormatTraits<PixelFormat::A32_B32_G32_R32_Float_Flipped32>());
+      }
+      case PixelFormat::A2_R10_G10_B10_Unsigned_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::A2_R10_G10_B10_Unsigned_Native16>());
+      }
+      case PixelFormat::A2_R10_G10_B10_Unsigned_Flipped16: {
+        return visitor(PixelFormatTraits<PixelFormat::A2_R10_G10_B10_Unsigned_Flipped16>());
+      }
+      case PixelFormat::A2_B10_G10_R10_Unsigned_Native16: {
+        return visitor(PixelFormatTraits<PixelFormat::A2_B10_G10_R10_Unsigned_Native16>());
+      }
+      case PixelFormat::A2_B10_G10_R10_Unsigned_Flipped16: {
+        return visitor(PixelFormatTraits<PixelFormat::A2_B10_G10_R10_Unsigned_Flipped16>());
+      }
+      default: {
+        throw std::runtime_error(u8"Provided value is not a valid pixel format");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_PIXELFORMATTRAITS_H
@@ -249,7 +249,11 @@ namespace Nuclex { namespace Pixels {
           ++this->y;
         } else { // We're on the last line already
           enforceIteratorCanAdvance(); // Checks and triggers an assertion if needed
-          ++this->x; // Go to special iterator end position (or commence undefined behavior)
+
+          // Go to the special iterator end position, the same one GetEnd() produces
+          this->current += this->memory.Stride + this->bytesPerPixel;
+          this->x = this->memory.Width;
+          ++this->y;
         }
 
       }
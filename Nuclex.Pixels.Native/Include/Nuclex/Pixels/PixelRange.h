@@ -0,0 +1,413 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_PIXELRANGE_H
+#define NUCLEX_PIXELS_PIXELRANGE_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Random access iterator over the pixels of a bitmap that jumps in O(1)</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Unlike the <see cref="PixelIterator" />, this iterator keeps the linear index of
+  ///     its pixel, so jumping any distance costs a single division to find the new row
+  ///     and comparing or subtracting iterators is a plain integer operation. This is what
+  ///     the standard library's parallel algorithms need to partition a range efficiently.
+  ///   </para>
+  ///   <para>
+  ///     Stepping to the next pixel is as cheap as with the pixel iterator: the address
+  ///     is incremented and only at the end of a row is it recalculated from the stride,
+  ///     so views and negative strides are supported.
+  ///   </para>
+  /// </remarks>
+  class IndexedPixelIterator {
+
+    /// <summary>Type that results when the distance of two iterators is calculated</summary>
+    public: typedef std::ptrdiff_t difference_type;
+
+    /// <summary>Type of the values this iterator iterates over</summary>
+    public: typedef void *value_type;
+
+    /// <summary>Reference to an element addressed by this iterator</summary>
+    public: typedef void *reference;
+
+    /// <summary>Type of pointer this iterator emulates</summary>
+    public: typedef void **pointer;
+
+    /// <summary>Which type of iterator this is</summary>
+    public: typedef std::random_access_iterator_tag iterator_category;
+
+    /// <summary>Initializes an iterator that is not associated with any bitmap</summary>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator() :
+      pixels(nullptr),
+      stride(0),
+      width(0),
+      bytesPerPixel(0),
+      index(0),
+      x(0),
+      y(0),
+      current(nullptr) {}
+
+    /// <summary>Initializes a new iterator at the specified pixel of a bitmap</summary>
+    /// <param name="memory">Bitmap memory whose pixels will be iterated over</param>
+    /// <param name="index">Linear index of the pixel the iterator will start at</param>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator(
+      const BitmapMemory &memory, std::size_t index = 0
+    ) :
+      pixels(static_cast<std::uint8_t *>(memory.Pixels)),
+      stride(static_cast<std::ptrdiff_t>(memory.Stride)),
+      width(memory.Width),
+      bytesPerPixel(CountBitsPerPixel(memory.PixelFormat) / 8) {
+      moveToIndex(static_cast<std::ptrdiff_t>(index));
+    }
+
+    /// <summary>Returns the memory address of the iterator's current pixel</summary>
+    /// <returns>The memory address of the current pixel</returns>
+    public: NUCLEX_PIXELS_API void *operator *() const {
+      return this->current;
+    }
+
+    /// <summary>Returns the memory address of a pixel relative to the iterator</summary>
+    /// <param name="offset">Number of pixels from the iterator's current pixel</param>
+    /// <returns>The memory address of the pixel at the specified offset</returns>
+    public: NUCLEX_PIXELS_API void *operator [](difference_type offset) const {
+      return *(IndexedPixelIterator(*this) += offset);
+    }
+
+    /// <summary>Looks up the X coordinate of the iterator's current pixel</summary>
+    /// <returns>The X coordinate of the current pixel</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetX() const { return this->x; }
+
+    /// <summary>Looks up the Y coordinate of the iterator's current pixel</summary>
+    /// <returns>The Y coordinate of the current pixel</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetY() const { return this->y; }
+
+    /// <summary>Looks up the linear index of the iterator's current pixel</summary>
+    /// <returns>The index of the current pixel counted row by row</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetIndex() const {
+      return static_cast<std::size_t>(this->index);
+    }
+
+    /// <summary>Moves the iterator to the next pixel</summary>
+    /// <returns>The iterator</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator &operator ++() {
+      ++this->index;
+      ++this->x;
+      this->current += this->bytesPerPixel;
+      if(this->x >= this->width) { // Only happens once per row, so it is well predicted
+        this->x = 0;
+        ++this->y;
+        this->current = getRowAddress(this->y);
+      }
+      return *this;
+    }
+
+    /// <summary>Moves the iterator to the next pixel</summary>
+    /// <returns>The iterator with its state before it was advanced</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator operator ++(int) {
+      IndexedPixelIterator previous(*this);
+      ++(*this);
+      return previous;
+    }
+
+    /// <summary>Moves the iterator to the previous pixel</summary>
+    /// <returns>The iterator</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator &operator --() {
+      --this->index;
+      if(this->x > 0) {
+        --this->x;
+        this->current -= this->bytesPerPixel;
+      } else {
+        this->x = this->width - 1;
+        --this->y;
+        this->current = getRowAddress(this->y) + this->x * this->bytesPerPixel;
+      }
+      return *this;
+    }
+
+    /// <summary>Moves the iterator to the previous pixel</summary>
+    /// <returns>The iterator with its state before it was moved back</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator operator --(int) {
+      IndexedPixelIterator previous(*this);
+      --(*this);
+      return previous;
+    }
+
+    /// <summary>Moves the iterator forward by the specified number of pixels</summary>
+    /// <param name="offset">Number of pixels the iterator will be moved</param>
+    /// <returns>The iterator</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator &operator +=(difference_type offset) {
+      moveToIndex(this->index + offset);
+      return *this;
+    }
+
+    /// <summary>Moves the iterator back by the specified number of pixels</summary>
+    /// <param name="offset">Number of pixels the iterator will be moved</param>
+    /// <returns>The iterator</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator &operator -=(difference_type offset) {
+      moveToIndex(this->index - offset);
+      return *this;
+    }
+
+    /// <summary>Creates an iterator that is ahead by the specified number of pixels</summary>
+    /// <param name="offset">Number of pixels the new iterator will be ahead</param>
+    /// <returns>The new iterator</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator operator +(difference_type offset) const {
+      return IndexedPixelIterator(*this) += offset;
+    }
+
+    /// <summary>Creates an iterator that is behind by the specified number of pixels</summary>
+    /// <param name="offset">Number of pixels the new iterator will be behind</param>
+    /// <returns>The new iterator</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator operator -(difference_type offset) const {
+      return IndexedPixelIterator(*this) -= offset;
+    }
+
+    /// <summary>Calculates the number of pixels between two iterators</summary>
+    /// <param name="other">Iterator whose distance to this one will be calculated</param>
+    /// <returns>The number of pixels the other iterator is behind this one</returns>
+    public: NUCLEX_PIXELS_API difference_type operator -(
+      const IndexedPixelIterator &other
+    ) const {
+      return this->index - other.index;
+    }
+
+    /// <summary>Checks whether another iterator is at the same pixel</summary>
+    /// <param name="other">Other iterator that will be compared</param>
+    /// <returns>True if the other iterator is at the same pixel</returns>
+    public: NUCLEX_PIXELS_API bool operator ==(const IndexedPixelIterator &other) const {
+      return (this->index == other.index);
+    }
+
+    /// <summary>Checks whether another iterator is at a different pixel</summary>
+    /// <param name="other">Other iterator that will be compared</param>
+    /// <returns>True if the other iterator is at a different pixel</returns>
+    public: NUCLEX_PIXELS_API bool operator !=(const IndexedPixelIterator &other) const {
+      return (this->index != other.index);
+    }
+
+    /// <summary>Checks whether this iterator is before another iterator</summary>
+    /// <param name="other">Other iterator that will be compared</param>
+    /// <returns>True if this iterator is before the other iterator</returns>
+    public: NUCLEX_PIXELS_API bool operator <(const IndexedPixelIterator &other) const {
+      return (this->index < other.index);
+    }
+
+    /// <summary>Checks whether this iterator is after another iterator</summary>
+    /// <param name="other">Other iterator that will be compared</param>
+    /// <returns>True if this iterator is after the other iterator</returns>
+    public: NUCLEX_PIXELS_API bool operator >(const IndexedPixelIterator &other) const {
+      return (this->index > other.index);
+    }
+
+    /// <summary>Checks whether this iterator is before or at another iterator</summary>
+    /// <param name="other">Other iterator that will be compared</param>
+    /// <returns>True if this iterator is before or at the other iterator</returns>
+    public: NUCLEX_PIXELS_API bool operator <=(const IndexedPixelIterator &other) const {
+      return (this->index <= other.index);
+    }
+
+    /// <summary>Checks whether this iterator is after or at another iterator</summary>
+    /// <param name="other">Other iterator that will be compared</param>
+    /// <returns>True if this iterator is after or at the other iterator</returns>
+    public: NUCLEX_PIXELS_API bool operator >=(const IndexedPixelIterator &other) const {
+      return (this->index >= other.index);
+    }
+
+    /// <summary>Calculates the address of the first pixel in a row</summary>
+    /// <param name="row">Index of the row whose address will be calculated</param>
+    /// <returns>The address of the first pixel in the row</returns>
+    private: std::uint8_t *getRowAddress(std::size_t row) const {
+      return this->pixels + this->stride * static_cast<std::ptrdiff_t>(row);
+    }
+
+    /// <summary>Moves the iterator to the pixel with the specified linear index</summary>
+    /// <param name="newIndex">Linear index of the pixel the iterator will move to</param>
+    private: void moveToIndex(std::ptrdiff_t newIndex) {
+      this->index = newIndex;
+      if(this->width == 0) {
+        this->x = 0;
+        this->y = 0;
+      } else {
+        std::size_t unsignedIndex = static_cast<std::size_t>(newIndex);
+        this->y = unsignedIndex / this->width;
+        this->x = unsignedIndex - this->y * this->width;
+      }
+      this->current = getRowAddress(this->y) + this->x * this->bytesPerPixel;
+    }
+
+    /// <summary>Address of the first pixel in the bitmap</summary>
+    private: std::uint8_t *pixels;
+    /// <summary>Offset in bytes from one row to the next</summary>
+    private: std::ptrdiff_t stride;
+    /// <summary>Number of pixels in one row of the bitmap</summary>
+    private: std::size_t width;
+    /// <summary>Number of bytes in a single pixel</summary>
+    private: std::size_t bytesPerPixel;
+    /// <summary>Linear index of the current pixel</summary>
+    private: std::ptrdiff_t index;
+    /// <summary>X coordinate of the current pixel</summary>
+    private: std::size_t x;
+    /// <summary>Y coordinate of the current pixel</summary>
+    private: std::size_t y;
+    /// <summary>Address of the current pixel</summary>
+    private: std::uint8_t *current;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates an iterator that is ahead of another by a number of pixels</summary>
+  /// <param name="offset">Number of pixels the new iterator will be ahead</param>
+  /// <param name="iterator">Iterator the new iterator will be based on</param>
+  /// <returns>The new iterator</returns>
+  inline IndexedPixelIterator operator +(
+    IndexedPixelIterator::difference_type offset, const IndexedPixelIterator &iterator
+  ) {
+    return iterator + offset;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Range of whole rows in a bitmap whose pixels can be iterated over</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A pixel range works in range-based for loops and with standard algorithms,
+  ///     including the parallel ones of C++17, which can partition it cheaply because
+  ///     its iterators are <see cref="IndexedPixelIterator" />s:
+  ///   </para>
+  ///   <para>
+  ///     <example>
+  ///       <code>
+  ///         PixelRange pixels(myBitmapMemory);
+  ///         std::for_each(
+  ///           std::execution::par, pixels.begin(), pixels.end(),
+  ///           [](void *pixel) { *static_cast<std::uint32_t *>(pixel) |= 0xFF000000; }
+  ///         );
+  ///       </code>
+  ///     </example>
+  ///   </para>
+  ///   <para>
+  ///     Work can also be split by hand, for example over a <see cref="ThreadPool" />.
+  ///     <see cref="GetPart" /> cuts the range into sub-ranges along row boundaries,
+  ///     so no two threads ever touch the same row.
+  ///   </para>
+  /// </remarks>
+  class PixelRange {
+
+    /// <summary>Initializes a new pixel range covering all pixels of a bitmap</summary>
+    /// <param name="memory">Bitmap memory whose pixels the range will cover</param>
+    public: NUCLEX_PIXELS_API PixelRange(const BitmapMemory &memory) :
+      memory(memory),
+      firstRow(0),
+      rowCount(memory.Height) {}
+
+    /// <summary>Initializes a new pixel range covering some rows of a bitmap</summary>
+    /// <param name="memory">Bitmap memory whose pixels the range will cover</param>
+    /// <param name="firstRow">Index of the first row in the range</param>
+    /// <param name="rowCount">Number of rows in the range</param>
+    public: NUCLEX_PIXELS_API PixelRange(
+      const BitmapMemory &memory, std::size_t firstRow, std::size_t rowCount
+    ) :
+      memory(memory),
+      firstRow(firstRow),
+      rowCount(rowCount) {}
+
+    /// <summary>Returns an iterator to the first pixel in the range</summary>
+    /// <returns>An iterator to the first pixel</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator begin() const {
+      return IndexedPixelIterator(this->memory, this->firstRow * this->memory.Width);
+    }
+
+    /// <summary>Returns an iterator one past the last pixel in the range</summary>
+    /// <returns>An iterator one past the last pixel</returns>
+    public: NUCLEX_PIXELS_API IndexedPixelIterator end() const {
+      return IndexedPixelIterator(
+        this->memory, (this->firstRow + this->rowCount) * this->memory.Width
+      );
+    }
+
+    /// <summary>Retrieves the index of the first row in the range</summary>
+    /// <returns>The index of the range's first row in the bitmap</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetFirstRow() const { return this->firstRow; }
+
+    /// <summary>Retrieves the number of rows in the range</summary>
+    /// <returns>The number of rows the range covers</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetRowCount() const { return this->rowCount; }
+
+    /// <summary>Counts the pixels in the range</summary>
+    /// <returns>The number of pixels the range covers</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetPixelCount() const {
+      return this->rowCount * this->memory.Width;
+    }
+
+    /// <summary>Cuts the range into parts of whole rows and returns one of them</summary>
+    /// <param name="partIndex">Index of the part that will be returned</param>
+    /// <param name="partCount">Number of parts the range is cut into</param>
+    /// <returns>The requested part of the range</returns>
+    /// <remarks>
+    ///   Rows are distributed as evenly as possible, so parts differ by one row at most.
+    ///   If there are more parts than rows, the excess parts are empty.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API PixelRange GetPart(
+      std::size_t partIndex, std::size_t partCount
+    ) const {
+      std::size_t partFirstRow = this->rowCount * partIndex / partCount;
+      std::size_t partEndRow = this->rowCount * (partIndex + 1) / partCount;
+      return PixelRange(
+        this->memory, this->firstRow + partFirstRow, partEndRow - partFirstRow
+      );
+    }
+
+    /// <summary>Describes the pixels in the range as bitmap memory of their own</summary>
+    /// <returns>Bitmap memory covering only the rows of the range</returns>
+    public: NUCLEX_PIXELS_API BitmapMemory GetMemory() const {
+      BitmapMemory rows(this->memory);
+      rows.Height = this->rowCount;
+      rows.Pixels = static_cast<std::uint8_t *>(this->memory.Pixels) + (
+        static_cast<std::ptrdiff_t>(this->memory.Stride) *
+        static_cast<std::ptrdiff_t>(this->firstRow)
+      );
+      return rows;
+    }
+
+    /// <summary>Bitmap memory whose pixels are covered by the range</summary>
+    private: BitmapMemory memory;
+    /// <summary>Index of the first row in the range</summary>
+    private: std::size_t firstRow;
+    /// <summary>Number of rows in the range</summary>
+    private: std::size_t rowCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_PIXELRANGE_H
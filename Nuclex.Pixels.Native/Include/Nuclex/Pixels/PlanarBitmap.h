@@ -0,0 +1,117 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_PLANARBITMAP_H
+#define NUCLEX_PIXELS_PLANARBITMAP_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/PlanarBitmapMemory.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BitmapAllocator;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Bitmap that stores each channel of its pixels in a separate plane</summary>
+  /// <remarks>
+  ///   <para>
+  ///     All planes are stored one after another in a single memory block obtained from
+  ///     the default <see cref="BitmapAllocator" />. Each plane and each line within
+  ///     a plane start on a 16 byte boundary, so kernels working on a single channel
+  ///     can use aligned SIMD loads at the start of each line.
+  ///   </para>
+  ///   <para>
+  ///     Use the <see cref="PlanarConverter" /> to split interleaved pixels into
+  ///     the planes of a planar bitmap and to interleave them again.
+  ///   </para>
+  /// </remarks>
+  class PlanarBitmap {
+
+    /// <summary>Initializes a new planar bitmap</summary>
+    /// <param name="width">Width of the bitmap in pixels</param>
+    /// <param name="height">Height of the bitmap in pixels</param>
+    /// <param name="pixelFormat">
+    ///   Interleaved pixel format whose channels will be stored in the planes
+    /// </param>
+    /// <remarks>
+    ///   The pixel format needs to be supported by the <see cref="PlanarConverter" />,
+    ///   otherwise an exception is thrown.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API PlanarBitmap(
+      std::size_t width, std::size_t height, PixelFormat pixelFormat
+    );
+
+    /// <summary>Constructs a planar bitmap by taking over an existing one</summary>
+    /// <param name="other">Planar bitmap that will be taken over</param>
+    public: NUCLEX_PIXELS_API PlanarBitmap(PlanarBitmap &&other);
+
+    /// <summary>Frees the memory holding the planes</summary>
+    public: NUCLEX_PIXELS_API ~PlanarBitmap();
+
+    /// <summary>Returns the width of the bitmap in pixels</summary>
+    /// <returns>The width of the bitmap</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetWidth() const {
+      return this->memory.Width;
+    }
+
+    /// <summary>Returns the height of the bitmap in pixels</summary>
+    /// <returns>The height of the bitmap</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetHeight() const {
+      return this->memory.Height;
+    }
+
+    /// <summary>Accesses the planes of the bitmap</summary>
+    /// <returns>A description of the planes' memory layout</returns>
+    public: NUCLEX_PIXELS_API const PlanarBitmapMemory &Access() const {
+      return this->memory;
+    }
+
+    /// <summary>Takes over another planar bitmap</summary>
+    /// <param name="other">Other planar bitmap that will be taken over</param>
+    /// <returns>This planar bitmap</returns>
+    public: NUCLEX_PIXELS_API PlanarBitmap &operator =(PlanarBitmap &&other);
+
+    private: PlanarBitmap(const PlanarBitmap &) = delete;
+    private: PlanarBitmap &operator =(const PlanarBitmap &) = delete;
+
+    /// <summary>Frees the memory block holding the planes, if any</summary>
+    private: void free();
+
+    /// <summary>Memory layout of the planes</summary>
+    private: PlanarBitmapMemory memory;
+    /// <summary>Allocator the memory block holding the planes was obtained from</summary>
+    private: BitmapAllocator *allocator;
+    /// <summary>Memory block holding the planes as returned by the allocator</summary>
+    private: void *allocatedMemory;
+    /// <summary>Number of bytes that were requested from the allocator</summary>
+    private: std::size_t allocatedByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_PLANARBITMAP_H
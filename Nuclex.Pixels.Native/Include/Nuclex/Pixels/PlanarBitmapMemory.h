@@ -0,0 +1,84 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_PLANARBITMAPMEMORY_H
+#define NUCLEX_PIXELS_PLANARBITMAPMEMORY_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/PixelFormat.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Largest number of planes a planar bitmap can consist of</summary>
+  const std::size_t MaximumPlaneCount = 4;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the memory layout of a bitmap storing each channel separately</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Instead of storing all channels of a pixel next to each other, a planar bitmap
+  ///     stores each channel in a plane of its own (all red values, then all green values
+  ///     and so on). This is what you want for kernels that work on one channel at a time,
+  ///     such as histograms or per-channel filters, because they can then process
+  ///     a channel with straight SIMD instructions.
+  ///   </para>
+  ///   <para>
+  ///     The pixel format is that of the interleaved pixels the planes correspond to. It
+  ///     tells the type of the values in the planes, while the planes appear in the same
+  ///     order as the channels are stored in memory by that pixel format, so the planes of
+  ///     <see cref="PixelFormat.B8_G8_R8_A8_Unsigned" /> are blue, green, red and alpha.
+  ///   </para>
+  /// </remarks>
+  struct PlanarBitmapMemory {
+
+    /// <summary>Width of the bitmap in pixels</summary>
+    public: std::size_t Width;
+
+    /// <summary>Height of the bitmap in pixels</summary>
+    public: std::size_t Height;
+
+    /// <summary>Interleaved pixel format whose channels are stored in the planes</summary>
+    public: enum PixelFormat PixelFormat;
+
+    /// <summary>Number of planes, one for each channel of the pixel format</summary>
+    public: std::size_t PlaneCount;
+
+    /// <summary>Offset in bytes to go from one line to the next in each plane</summary>
+    /// <remarks>
+    ///   Like with <see cref="BitmapMemory.Stride" />, strides can be larger than needed
+    ///   for the values in a line and can be negative to put a plane upside-down.
+    /// </remarks>
+    public: int Strides[MaximumPlaneCount];
+
+    /// <summary>Memory areas storing the values of each plane</summary>
+    public: void *Planes[MaximumPlaneCount];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_PLANARBITMAPMEMORY_H
@@ -0,0 +1,113 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_PLANARCONVERTER_H
+#define NUCLEX_PIXELS_PLANARCONVERTER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/PlanarBitmapMemory.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splits interleaved pixels into planes and interleaves planes again</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Any pixel format whose channels each occupy the same whole number of bytes
+  ///     can be split into planes, that is all formats with 8 bit channels, those with
+  ///     16 bit unsigned or half channels and those with 32 bit float channels. Packed
+  ///     formats such as R5-G6-B5 or A2-R10-G10-B10 are not supported.
+  ///   </para>
+  ///   <para>
+  ///     The values are copied as they are, planes have the same type and byte order as
+  ///     the channels in the interleaved pixel format. To obtain planes in a different
+  ///     type, convert the interleaved pixels with the <see cref="PixelFormatConverter" />
+  ///     first. The common cases (two or four channels of 8, 16 or 32 bits) are handled
+  ///     by SSE2 or NEON kernels, NEON also handles three 8 bit channels.
+  ///   </para>
+  /// </remarks>
+  class PlanarConverter {
+
+    /// <summary>Checks whether the pixels of a pixel format can be split into planes</summary>
+    /// <param name="pixelFormat">Pixel format that will be checked</param>
+    /// <returns>True if bitmaps in the pixel format can be split into planes</returns>
+    public: NUCLEX_PIXELS_API static bool CanSplit(PixelFormat pixelFormat);
+
+    /// <summary>Counts the planes the pixels of a pixel format are split into</summary>
+    /// <param name="pixelFormat">Pixel format whose planes will be counted</param>
+    /// <returns>The number of channels in the pixel format, 0 if it can not be split</returns>
+    public: NUCLEX_PIXELS_API static std::size_t CountPlanes(PixelFormat pixelFormat);
+
+    /// <summary>Counts the bytes each value occupies in the planes of a pixel format</summary>
+    /// <param name="pixelFormat">Pixel format whose channel size will be determined</param>
+    /// <returns>The number of bytes per channel, 0 if it can not be split</returns>
+    public: NUCLEX_PIXELS_API static std::size_t CountBytesPerChannel(PixelFormat pixelFormat);
+
+    /// <summary>Splits the interleaved pixels of a bitmap into planes</summary>
+    /// <param name="source">Bitmap memory holding the interleaved pixels</param>
+    /// <param name="target">Planar bitmap memory that will receive the channels</param>
+    /// <remarks>
+    ///   Both bitmaps need to have the same size and pixel format.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Deinterleave(
+      const BitmapMemory &source, const PlanarBitmapMemory &target
+    );
+
+    /// <summary>Splits the interleaved pixels of a bitmap into planes in parallel</summary>
+    /// <param name="source">Bitmap memory holding the interleaved pixels</param>
+    /// <param name="target">Planar bitmap memory that will receive the channels</param>
+    /// <param name="threadPool">Thread pool that will process bands of rows</param>
+    public: NUCLEX_PIXELS_API static void Deinterleave(
+      const BitmapMemory &source, const PlanarBitmapMemory &target, ThreadPool &threadPool
+    );
+
+    /// <summary>Combines the planes of a bitmap into interleaved pixels</summary>
+    /// <param name="source">Planar bitmap memory holding the channels</param>
+    /// <param name="target">Bitmap memory that will receive the interleaved pixels</param>
+    /// <remarks>
+    ///   Both bitmaps need to have the same size and pixel format.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Interleave(
+      const PlanarBitmapMemory &source, const BitmapMemory &target
+    );
+
+    /// <summary>Combines the planes of a bitmap into interleaved pixels in parallel</summary>
+    /// <param name="source">Planar bitmap memory holding the channels</param>
+    /// <param name="target">Bitmap memory that will receive the interleaved pixels</param>
+    /// <param name="threadPool">Thread pool that will process bands of rows</param>
+    public: NUCLEX_PIXELS_API static void Interleave(
+      const PlanarBitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_PLANARCONVERTER_H
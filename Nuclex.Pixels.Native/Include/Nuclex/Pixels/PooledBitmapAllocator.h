@@ -0,0 +1,120 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_POOLEDBITMAPALLOCATOR_H
+#define NUCLEX_PIXELS_POOLEDBITMAPALLOCATOR_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapAllocator.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocator that recycles the memory of bitmaps which have been destroyed</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Applications that keep creating bitmaps of the same size (video frames, tiles,
+  ///     thumbnails, scratch buffers) spend a surprising amount of time in the system's
+  ///     allocator and, for large bitmaps, in the kernel handing out fresh pages. This
+  ///     allocator keeps the memory of destroyed bitmaps around and hands it to the next
+  ///     bitmap of the same resolution and pixel format (or, more precisely, the same
+  ///     number of bytes).
+  ///   </para>
+  ///   <para>
+  ///     To prevent it from hoarding memory indefinitely, the allocator stops keeping
+  ///     memory blocks once the idle blocks add up to the configured limit. Idle blocks
+  ///     can also be released at any time by calling <see cref="Trim" />.
+  ///   </para>
+  /// </remarks>
+  class PooledBitmapAllocator : public BitmapAllocator {
+
+    #pragma region struct Statistics
+
+    /// <summary>Statistics about the memory managed by the allocator</summary>
+    public: struct Statistics {
+
+      /// <summary>Total number of memory blocks that have been requested</summary>
+      public: std::size_t AllocationCount;
+      /// <summary>Number of requests that were served with a recycled memory block</summary>
+      public: std::size_t HitCount;
+      /// <summary>Number of bytes in all memory blocks the allocator is holding</summary>
+      /// <remarks>
+      ///   This includes the memory blocks currently in use by bitmaps as well as
+      ///   the idle memory blocks waiting to be recycled.
+      /// </remarks>
+      public: std::size_t ResidentByteCount;
+      /// <summary>Number of bytes in the idle memory blocks waiting to be recycled</summary>
+      public: std::size_t PooledByteCount;
+
+    };
+
+    #pragma endregion // struct Statistics
+
+    /// <summary>Initializes a new pooled bitmap allocator</summary>
+    /// <param name="maximumPooledByteCount">
+    ///   Maximum number of bytes the idle memory blocks waiting to be recycled may add up to
+    /// </param>
+    public: NUCLEX_PIXELS_API explicit PooledBitmapAllocator(
+      std::size_t maximumPooledByteCount = 64 * 1024 * 1024
+    );
+
+    /// <summary>Frees all idle memory blocks</summary>
+    /// <remarks>
+    ///   All bitmaps using memory from the allocator need to be destroyed before
+    ///   the allocator itself is destroyed.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API ~PooledBitmapAllocator() override;
+
+    /// <summary>Allocates a memory block for a bitmap</summary>
+    /// <param name="byteCount">Number of bytes the memory block needs to have</param>
+    /// <returns>The address of the memory block</returns>
+    public: NUCLEX_PIXELS_API void *Allocate(std::size_t byteCount) override;
+
+    /// <summary>Returns a memory block to the pool or frees it</summary>
+    /// <param name="memory">Address of the memory block that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were requested for the block</param>
+    public: NUCLEX_PIXELS_API void Free(void *memory, std::size_t byteCount) throw() override;
+
+    /// <summary>Frees all idle memory blocks that are waiting to be recycled</summary>
+    public: NUCLEX_PIXELS_API void Trim();
+
+    /// <summary>Retrieves statistics about the memory managed by the allocator</summary>
+    /// <returns>The current statistics of the allocator</returns>
+    public: NUCLEX_PIXELS_API Statistics GetStatistics() const;
+
+    private: PooledBitmapAllocator(const PooledBitmapAllocator &) = delete;
+    private: PooledBitmapAllocator &operator =(const PooledBitmapAllocator &) = delete;
+
+    /// <summary>Structure holding the idle memory blocks and the statistics</summary>
+    private: struct Implementation;
+
+    /// <summary>Idle memory blocks and statistics, protected by a mutex</summary>
+    private: Implementation *implementation;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_POOLEDBITMAPALLOCATOR_H
@@ -0,0 +1,221 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_ROWITERATOR_H
+#define NUCLEX_PIXELS_ROWITERATOR_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Continuous span of pixels forming one row of a bitmap</summary>
+  /// <remarks>
+  ///   All pixels between <see cref="Begin" /> and <see cref="End" /> are stored
+  ///   back-to-back in memory, so an inner loop over them needs no stride calculations
+  ///   and can be vectorized by the compiler.
+  /// </remarks>
+  struct PixelRow {
+
+    /// <summary>Address of the first pixel in the row</summary>
+    public: void *Begin;
+
+    /// <summary>Address one byte past the last pixel in the row</summary>
+    public: void *End;
+
+    /// <summary>Index of the row inside the bitmap</summary>
+    public: std::size_t Y;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Steps through the rows of a bitmap</summary>
+  class RowIterator {
+
+    /// <summary>Type that results when the distance of two iterators is calculated</summary>
+    public: typedef std::ptrdiff_t difference_type;
+
+    /// <summary>Type of the values this iterator iterates over</summary>
+    public: typedef PixelRow value_type;
+
+    /// <summary>Reference to an element addressed by this iterator</summary>
+    public: typedef PixelRow reference;
+
+    /// <summary>Type of pointer this iterator emulates</summary>
+    public: typedef const PixelRow *pointer;
+
+    /// <summary>Which type of iterator this is</summary>
+    public: typedef std::input_iterator_tag iterator_category;
+
+    /// <summary>Initializes a new row iterator</summary>
+    /// <param name="memory">Bitmap memory whose rows will be iterated over</param>
+    /// <param name="y">Index of the row the iterator will start at</param>
+    public: NUCLEX_PIXELS_API RowIterator(const BitmapMemory &memory, std::size_t y = 0) :
+      pixels(static_cast<std::uint8_t *>(memory.Pixels)),
+      rowByteCount(CountRequiredBytes(memory.PixelFormat, memory.Width)),
+      stride(memory.Stride),
+      y(y) {}
+
+    /// <summary>Returns the row the iterator is currently at</summary>
+    /// <returns>The pixels in the iterator's current row</returns>
+    public: NUCLEX_PIXELS_API PixelRow operator *() const {
+      std::uint8_t *begin = this->pixels + (
+        static_cast<std::ptrdiff_t>(this->stride) * static_cast<std::ptrdiff_t>(this->y)
+      );
+
+      PixelRow row;
+      row.Begin = begin;
+      row.End = begin + this->rowByteCount;
+      row.Y = this->y;
+      return row;
+    }
+
+    /// <summary>Moves the iterator to the next row</summary>
+    /// <returns>The row iterator</returns>
+    public: NUCLEX_PIXELS_API RowIterator &operator ++() {
+      ++this->y;
+      return *this;
+    }
+
+    /// <summary>Moves the iterator to the next row</summary>
+    /// <returns>The row iterator with its state before it was advanced</returns>
+    public: NUCLEX_PIXELS_API RowIterator operator ++(int) {
+      RowIterator previous(*this);
+      ++(*this);
+      return previous;
+    }
+
+    /// <summary>Checks whether another row iterator is at the same row</summary>
+    /// <param name="other">Other row iterator that will be compared</param>
+    /// <returns>True if the other row iterator is at the same row</returns>
+    public: NUCLEX_PIXELS_API bool operator ==(const RowIterator &other) const {
+      return (this->y == other.y);
+    }
+
+    /// <summary>Checks whether another row iterator is at a different row</summary>
+    /// <param name="other">Other row iterator that will be compared</param>
+    /// <returns>True if the other row iterator is at a different row</returns>
+    public: NUCLEX_PIXELS_API bool operator !=(const RowIterator &other) const {
+      return (this->y != other.y);
+    }
+
+    /// <summary>Address of the first pixel in the bitmap</summary>
+    private: std::uint8_t *pixels;
+    /// <summary>Number of bytes occupied by the pixels in one row</summary>
+    private: std::size_t rowByteCount;
+    /// <summary>Offset in bytes from one row to the next</summary>
+    private: int stride;
+    /// <summary>Index of the current row</summary>
+    private: std::size_t y;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Range of rows in a bitmap that can be used in a range-based for loop</summary>
+  /// <remarks>
+  ///   <para>
+  ///     <example>
+  ///       <code>
+  ///         for(PixelRow row : GetRows(myBitmapMemory)) {
+  ///           std::uint32_t *pixel = static_cast<std::uint32_t *>(row.Begin);
+  ///           std::uint32_t *end = static_cast<std::uint32_t *>(row.End);
+  ///           for(; pixel < end; ++pixel) {
+  ///             *pixel |= 0xFF000000; // do something with the pixel
+  ///           }
+  ///         }
+  ///       </code>
+  ///     </example>
+  ///   </para>
+  /// </remarks>
+  class RowRange {
+
+    /// <summary>Initializes a new row range covering all rows of a bitmap</summary>
+    /// <param name="memory">Bitmap memory whose rows the range will cover</param>
+    public: NUCLEX_PIXELS_API RowRange(const BitmapMemory &memory) :
+      memory(memory) {}
+
+    /// <summary>Returns an iterator to the first row in the range</summary>
+    /// <returns>An iterator to the first row</returns>
+    public: NUCLEX_PIXELS_API RowIterator begin() const {
+      return RowIterator(this->memory, 0);
+    }
+
+    /// <summary>Returns an iterator one past the last row in the range</summary>
+    /// <returns>An iterator one past the last row</returns>
+    public: NUCLEX_PIXELS_API RowIterator end() const {
+      return RowIterator(this->memory, this->memory.Height);
+    }
+
+    /// <summary>Bitmap memory whose rows are covered by the range</summary>
+    private: BitmapMemory memory;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the rows of a bitmap for use in a range-based for loop</summary>
+  /// <param name="memory">Bitmap memory whose rows will be returned</param>
+  /// <returns>A range covering all rows of the bitmap</returns>
+  inline RowRange GetRows(const BitmapMemory &memory) {
+    return RowRange(memory);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Invokes a callback for each row of a bitmap</summary>
+  /// <typeparam name="TCallback">Callback that will be invoked on each row</typeparam>
+  /// <param name="memory">Bitmap memory whose rows will be processed</param>
+  /// <param name="callback">
+  ///   Callback that will be invoked with the <see cref="PixelRow" /> of each row
+  /// </param>
+  /// <remarks>
+  ///   Rows are processed from top to bottom. The stride of the bitmap memory is
+  ///   respected, so this works for views into other bitmaps (as returned by
+  ///   <see cref="Bitmap.GetView" />) and for upside-down bitmaps with negative strides.
+  /// </remarks>
+  template<typename TCallback>
+  inline void ForEachRow(const BitmapMemory &memory, TCallback &&callback) {
+    std::size_t rowByteCount = CountRequiredBytes(memory.PixelFormat, memory.Width);
+
+    std::uint8_t *pixels = static_cast<std::uint8_t *>(memory.Pixels);
+    std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(memory.Stride);
+
+    PixelRow row;
+    for(row.Y = 0; row.Y < memory.Height; ++row.Y) {
+      std::uint8_t *begin = pixels + stride * static_cast<std::ptrdiff_t>(row.Y);
+      row.Begin = begin;
+      row.End = begin + rowByteCount;
+      callback(static_cast<const PixelRow &>(row));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_ROWITERATOR_H
@@ -0,0 +1,135 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_ROWSTREAM_H
+#define NUCLEX_PIXELS_ROWSTREAM_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides the rows of an image from top to bottom, a few at a time</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Row sources let images be processed that are too large to be held in memory
+  ///     as a whole. Codecs provide row sources that decode the rows of an image file
+  ///     as they are requested (see <see cref="Storage.BitmapSerializer.OpenRowSource" />)
+  ///     and transforms such as <see cref="PixelFormatConverter.ConvertRows" /> or
+  ///     <see cref="BitmapResampler.ResampleRows" /> wrap another row source and
+  ///     process its rows on the fly.
+  ///   </para>
+  ///   <para>
+  ///     Rows can only be read once and in order. Each call to <see cref="ReadRows" />
+  ///     continues where the previous one stopped.
+  ///   </para>
+  ///   <para>
+  ///     Row streams always carry every row because the sinks at their end (such as the
+  ///     codecs writing an image file) need complete images. They thus can't skip the
+  ///     clean tiles of a bitmap tracking dirty regions, use <see cref="FrameDelta" />
+  ///     or views of the rectangles from <see cref="Bitmap.GetDirtyRegions" /> for that.
+  ///   </para>
+  /// </remarks>
+  class RowSource {
+
+    /// <summary>Frees all resources owned by the row source</summary>
+    public: virtual ~RowSource() = default;
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: virtual std::size_t GetWidth() const = 0;
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: virtual std::size_t GetHeight() const = 0;
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: virtual PixelFormat GetPixelFormat() const = 0;
+
+    /// <summary>Reads the next rows of the image</summary>
+    /// <param name="rows">
+    ///   Bitmap memory that will receive as many rows as it is high. Its width and pixel
+    ///   format must match the row source's and it must not be higher than the number
+    ///   of rows remaining in the row source.
+    /// </param>
+    public: virtual void ReadRows(const BitmapMemory &rows) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Accepts the rows of an image from top to bottom, a few at a time</summary>
+  /// <remarks>
+  ///   Counterpart to the <see cref="RowSource" />. Codecs provide row sinks that encode
+  ///   rows into an image file as they are written (see
+  ///   <see cref="Storage.BitmapSerializer.OpenRowSink" />). Once the last row has been
+  ///   written, the file is complete. Destroying a row sink before that leaves behind
+  ///   a truncated file.
+  /// </remarks>
+  class RowSink {
+
+    /// <summary>Frees all resources owned by the row sink</summary>
+    public: virtual ~RowSink() = default;
+
+    /// <summary>Retrieves the width of the rows the row sink accepts</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: virtual std::size_t GetWidth() const = 0;
+
+    /// <summary>Retrieves the number of rows the row sink accepts in total</summary>
+    /// <returns>The height of the image written into the row sink</returns>
+    public: virtual std::size_t GetHeight() const = 0;
+
+    /// <summary>Retrieves the pixel format the row sink accepts rows in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: virtual PixelFormat GetPixelFormat() const = 0;
+
+    /// <summary>Writes the next rows of the image</summary>
+    /// <param name="rows">
+    ///   Bitmap memory holding as many rows as it is high. Its width and pixel format must
+    ///   match the row sink's and it must not be higher than the number of rows that
+    ///   remain to be written.
+    /// </param>
+    public: virtual void WriteRows(const BitmapMemory &rows) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Moves all remaining rows from a row source into a row sink</summary>
+  /// <param name="source">Row source that will be read until it has no rows left</param>
+  /// <param name="sink">Row sink the rows will be written into</param>
+  /// <remarks>
+  ///   The rows are moved in bands sized like those of <see cref="ForEachBandInParallel" />,
+  ///   so no more than a few hundred kilobytes are buffered no matter how large the image
+  ///   is. If the pixel formats of the row source and the row sink differ, the rows
+  ///   are converted on the way. Both need to have the same width and height.
+  /// </remarks>
+  NUCLEX_PIXELS_API void TransferRows(RowSource &source, RowSink &sink);
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_ROWSTREAM_H
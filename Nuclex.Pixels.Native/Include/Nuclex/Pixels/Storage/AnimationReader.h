@@ -0,0 +1,123 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_ANIMATIONREADER_H
+#define NUCLEX_PIXELS_STORAGE_ANIMATIONREADER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Rectangle.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Informations about a single frame of an animated image</summary>
+  struct AnimationFrameInfo {
+
+    /// <summary>Region of the animation's canvas the frame draws into</summary>
+    public: Rectangle Region;
+
+    /// <summary>Number of seconds the frame should be shown for</summary>
+    public: double Duration;
+
+    /// <summary>Whether the frame can be decoded without decoding earlier frames</summary>
+    /// <remarks>
+    ///   Frames of animated images usually only draw the part of the canvas that changed
+    ///   since the previous frame. Key frames either replace the whole canvas or follow
+    ///   a frame that cleared it, so seeking can start decoding at them.
+    /// </remarks>
+    public: bool IsKeyFrame;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes the frames of an animated image one at a time</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Animation readers are provided by codecs whose file format can store animations
+  ///     (see <see cref="BitmapSerializer.OpenAnimation" />). Frames are decoded into
+  ///     a bitmap the caller provides, so playing back an animation of any length needs
+  ///     no more memory than a single frame.
+  ///   </para>
+  ///   <para>
+  ///     Because frames build on the frames before them, the reader remembers which
+  ///     frame the bitmap last passed to <see cref="ReloadFrame" /> holds. Asking it for
+  ///     the next frame in the same bitmap only decodes that frame, any other request
+  ///     decodes from the nearest key frame onward.
+  ///   </para>
+  /// </remarks>
+  class AnimationReader {
+
+    /// <summary>Frees all resources owned by the animation reader</summary>
+    public: virtual ~AnimationReader() = default;
+
+    /// <summary>Retrieves the width of the animation's canvas</summary>
+    /// <returns>The width of the bitmaps the frames are decoded into</returns>
+    public: virtual std::size_t GetWidth() const = 0;
+
+    /// <summary>Retrieves the height of the animation's canvas</summary>
+    /// <returns>The height of the bitmaps the frames are decoded into</returns>
+    public: virtual std::size_t GetHeight() const = 0;
+
+    /// <summary>Retrieves the pixel format the frames are decoded in</summary>
+    /// <returns>The pixel format of the bitmaps the frames are decoded into</returns>
+    public: virtual PixelFormat GetPixelFormat() const = 0;
+
+    /// <summary>Counts the number of frames in the animation</summary>
+    /// <returns>The number of frames the animation consists of</returns>
+    public: virtual std::size_t CountFrames() const = 0;
+
+    /// <summary>Retrieves how often the animation should be played</summary>
+    /// <returns>The number of times the animation is played or 0 to loop forever</returns>
+    public: virtual std::size_t GetLoopCount() const = 0;
+
+    /// <summary>Retrieves informations about a frame of the animation</summary>
+    /// <param name="frameIndex">Index of the frame whose informations will be returned</param>
+    /// <returns>The region, duration and key frame flag of the frame</returns>
+    public: virtual const AnimationFrameInfo &GetFrameInfo(std::size_t frameIndex) const = 0;
+
+    /// <summary>Decodes a frame of the animation into an existing bitmap</summary>
+    /// <param name="exactlyFittingBitmap">
+    ///   Bitmap matching the animation's canvas size and pixel format
+    /// </param>
+    /// <param name="frameIndex">Index of the frame that will be decoded</param>
+    /// <remarks>
+    ///   The bitmap receives the whole canvas as it looks while the frame is shown.
+    ///   When playing an animation, keep passing the same bitmap without modifying it
+    ///   in between, that way each frame is drawn on top of the one before it.
+    /// </remarks>
+    public: virtual void ReloadFrame(Bitmap &exactlyFittingBitmap, std::size_t frameIndex) = 0;
+
+    /// <summary>Looks for the key frame decoding of a frame has to start at</summary>
+    /// <param name="frameIndex">Index of the frame that would be decoded</param>
+    /// <returns>The index of the nearest key frame at or before the frame</returns>
+    public: NUCLEX_PIXELS_API std::size_t FindKeyFrame(std::size_t frameIndex) const;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_ANIMATIONREADER_H
@@ -0,0 +1,141 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_BITMAPCACHE_H
+#define NUCLEX_PIXELS_STORAGE_BITMAPCACHE_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Storage/LoadOptions.h"
+
+#include <cstddef>
+#include <string>
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BitmapSerializer;
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps recently loaded bitmaps around so they don't have to be decoded again</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Sits in front of a <see cref="BitmapSerializer" /> and remembers the bitmaps it
+  ///     loaded until their combined size exceeds the configured budget, at which point
+  ///     the least recently used bitmaps are dropped. Files loaded by path are identified
+  ///     by their path, size and modification time, so a file that is replaced on disk
+  ///     is decoded again. For other files, the caller supplies the key.
+  ///   </para>
+  ///   <para>
+  ///     Bitmaps returned from the cache share their pixels with the cached bitmap
+  ///     (and with each other), so a cache hit doesn't copy any pixels. Because of this,
+  ///     call <see cref="Bitmap.Autonomize" /> on a returned bitmap before modifying it.
+  ///     Dropping a bitmap from the cache does not affect bitmaps that were handed out.
+  ///   </para>
+  ///   <para>
+  ///     The cache can be used by multiple threads at once. Decoding happens outside of
+  ///     the cache's lock, so threads requesting the same uncached file at the same time
+  ///     may both decode it. Progressive loading callbacks set in the load options are
+  ///     only invoked when a file is actually decoded.
+  ///   </para>
+  /// </remarks>
+  class BitmapCache {
+
+    #pragma region struct Statistics
+
+    /// <summary>Statistics about the bitmaps held by the cache</summary>
+    public: struct Statistics {
+
+      /// <summary>Number of requests that were served with a cached bitmap</summary>
+      public: std::size_t HitCount;
+      /// <summary>Number of requests for which the bitmap had to be decoded</summary>
+      public: std::size_t MissCount;
+      /// <summary>Number of bitmaps the cache is currently holding</summary>
+      public: std::size_t CachedBitmapCount;
+      /// <summary>Number of bytes occupied by the pixels of all cached bitmaps</summary>
+      public: std::size_t CachedByteCount;
+
+    };
+
+    #pragma endregion // struct Statistics
+
+    /// <summary>Initializes a new bitmap cache</summary>
+    /// <param name="serializer">Serializer that will be used to load the bitmaps</param>
+    /// <param name="maximumByteCount">
+    ///   Maximum number of bytes the pixels of all cached bitmaps may add up to
+    /// </param>
+    /// <remarks>
+    ///   The serializer needs to stay alive for as long as the cache exists.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API explicit BitmapCache(
+      const BitmapSerializer &serializer, std::size_t maximumByteCount = 256 * 1024 * 1024
+    );
+
+    /// <summary>Frees all bitmaps held by the cache</summary>
+    public: NUCLEX_PIXELS_API ~BitmapCache();
+
+    /// <summary>Loads a file from disk or returns the cached bitmap for it</summary>
+    /// <param name="path">Path of the file that will be loaded</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>The bitmap loaded from the specified file</returns>
+    public: NUCLEX_PIXELS_API Bitmap Load(
+      const std::string &path, const LoadOptions &options = LoadOptions()
+    );
+
+    /// <summary>Loads a file or returns the cached bitmap for the specified key</summary>
+    /// <param name="key">Key uniquely identifying the contents of the file</param>
+    /// <param name="file">File that will be loaded if it isn't cached yet</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>The bitmap loaded from the specified file</returns>
+    public: NUCLEX_PIXELS_API Bitmap Load(
+      const std::string &key, const VirtualFile &file,
+      const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    );
+
+    /// <summary>Drops all bitmaps from the cache</summary>
+    public: NUCLEX_PIXELS_API void Clear();
+
+    /// <summary>Retrieves statistics about the bitmaps held by the cache</summary>
+    /// <returns>The current statistics of the cache</returns>
+    public: NUCLEX_PIXELS_API Statistics GetStatistics() const;
+
+    private: BitmapCache(const BitmapCache &) = delete;
+    private: BitmapCache &operator =(const BitmapCache &) = delete;
+
+    /// <summary>Structure holding the cached bitmaps and the statistics</summary>
+    private: struct Implementation;
+
+    /// <summary>Cached bitmaps in least recently used order, protected by a mutex</summary>
+    private: Implementation *implementation;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_BITMAPCACHE_H
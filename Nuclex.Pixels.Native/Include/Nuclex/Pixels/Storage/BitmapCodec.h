@@ -23,8 +23,15 @@ License along with this library
 
 #include "Nuclex/Pixels/Config.h"
 #include "Nuclex/Pixels/Storage/OptionalBitmap.h"
+#include "Nuclex/Pixels/Storage/LoadOptions.h"
+#include "Nuclex/Pixels/Storage/SaveOptions.h"
+#include "Nuclex/Pixels/Storage/AnimationReader.h"
 #include "Nuclex/Pixels/BitmapInfo.h"
+#include "Nuclex/Pixels/RowStream.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -36,6 +43,15 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Number of bytes from the start of a file codecs are shown to identify it</summary>
+  /// <remarks>
+  ///   Enough for the signatures of all common image file formats. Files can be shorter,
+  ///   so codecs must check the length of the header they're given.
+  /// </remarks>
+  const std::size_t FileHeaderSampleByteCount = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Codec that loads and saves bitmaps in a predefined file format</summary>
   class BitmapCodec {
 
@@ -53,14 +69,37 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     /// <summary>Tries to read informations for a bitmap</summary>
     /// <param name="source">Source data from which the informations should be extracted</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>
     ///   Informations about the bitmap, if the codec is able to load it, otherwise
     ///   a BitmapInfo structure with 'Loadable' set to false.
     /// </returns>
     public: virtual BitmapInfo TryReadInfo(
-      const VirtualFile &source, const std::string &extensionHint = std::string()
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const = 0;
 
+    /// <summary>Checks whether a file header looks like it's in the codec's file format</summary>
+    /// <param name="fileHeader">The first bytes of the file that will be checked</param>
+    /// <param name="fileHeaderByteCount">
+    ///   Number of bytes in the file header, at most <see cref="FileHeaderSampleByteCount" />.
+    ///   Less if the file is shorter than that.
+    /// </param>
+    /// <returns>False if the codec is certain not to be able to load the file</returns>
+    /// <remarks>
+    ///   The bitmap serializer reads the file header once and lets all codecs look at it
+    ///   before it tries to load the file with them, so codecs that can tell by the file's
+    ///   signature that the file is not theirs don't have to read from the file at all.
+    ///   Codecs whose files can not be identified this way should return true.
+    /// </remarks>
+    public: virtual bool IsValidFileHeader(
+      const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+    ) const {
+      (void)fileHeader;
+      (void)fileHeaderByteCount;
+      return true;
+    }
+
     /// <summary>Checks if the codec is able to load the specified file</summary>
     /// <param name="source">Source data that will be checked for loadbility</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
@@ -76,6 +115,7 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     /// <summary>Tries to load the specified file as a bitmap</summary>
     /// <param name="source">Source data the bitmap will be loaded from</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>
     ///   The bitmap loaded from the specified file data or an empty value if the file format
     ///   is not supported by the codec
@@ -94,7 +134,8 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     ///   </para>
     /// </remarks>
     public: virtual OptionalBitmap TryLoad(
-      const VirtualFile &source, const std::string &extensionHint = std::string()
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const = 0;
 
     /// <summary>Tries to load the specified file into an exciting bitmap</summary>
@@ -103,6 +144,7 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     /// </param>
     /// <param name="source">Source data the bitmap will be loaded from</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>True if the codec was able to load the bitmap, false otherwise</returns>
     /// <remarks>
     ///   <para>
@@ -121,13 +163,138 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     /// </remarks>
     public: virtual bool TryReload(
       Bitmap &exactlyFittingBitmap,
-      const VirtualFile &source, const std::string &extensionHint = std::string()
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const = 0;
 
     /// <summary>Saves the specified bitmap into a file</summary>
     /// <param name="bitmap">Bitmap that will be saved into a file</param>
     /// <param name="target">File into which the bitmap will be saved</param>
-    public: virtual void Save(const Bitmap &bitmap, VirtualFile &target) const = 0;
+    /// <param name="options">Settings controlling how the file will be written</param>
+    public: virtual void Save(
+      const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options = SaveOptions()
+    ) const = 0;
+
+    /// <summary>Tries to open the specified file for reading its rows one by one</summary>
+    /// <param name="source">Source data the rows will be decoded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   A row source decoding the image's rows as they are read or a null pointer if
+    ///   the file format is not supported by the codec or the codec can not stream rows
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     The row source keeps reading from the file while rows are requested, so
+    ///     the file has to stay alive until the row source is destroyed. Like with
+    ///     TryLoad(), any error besides the file being in another format must be
+    ///     reported by throwing an exception.
+    ///   </para>
+    ///   <para>
+    ///     Codecs that can only decode whole images keep the default implementation,
+    ///     which returns a null pointer.
+    ///   </para>
+    /// </remarks>
+    public: virtual std::unique_ptr<RowSource> TryOpenRowSource(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const {
+      (void)source;
+      (void)extensionHint;
+      (void)options;
+      return std::unique_ptr<RowSource>();
+    }
+
+    /// <summary>Tries to open the specified file for decoding its animation frames</summary>
+    /// <param name="source">Source data the frames will be decoded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   An animation reader decoding the frames of the file or a null pointer if
+    ///   the file format is not supported by the codec or can not store animations
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     Like row sources, the animation reader keeps reading from the file whenever
+    ///     a frame is decoded, so the file has to stay alive until the animation reader
+    ///     is destroyed. Codecs whose format also stores still images should provide
+    ///     a reader with a single frame for those.
+    ///   </para>
+    ///   <para>
+    ///     Codecs for file formats without animations keep the default implementation,
+    ///     which returns a null pointer.
+    ///   </para>
+    /// </remarks>
+    public: virtual std::unique_ptr<AnimationReader> TryOpenAnimation(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const {
+      (void)source;
+      (void)extensionHint;
+      (void)options;
+      return std::unique_ptr<AnimationReader>();
+    }
+
+    /// <summary>Opens a file for writing an image into it row by row</summary>
+    /// <param name="target">File into which the image will be written</param>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="pixelFormat">Pixel format the rows will be written in</param>
+    /// <param name="options">Settings controlling how the file will be written</param>
+    /// <returns>
+    ///   A row sink encoding the rows written into it or a null pointer if the codec
+    ///   can not stream rows
+    /// </returns>
+    /// <remarks>
+    ///   The file has to stay alive until the row sink is destroyed. Codecs that can only
+    ///   encode whole images keep the default implementation, which returns a null pointer.
+    /// </remarks>
+    public: virtual std::unique_ptr<RowSink> OpenRowSink(
+      VirtualFile &target, std::size_t width, std::size_t height, PixelFormat pixelFormat,
+      const SaveOptions &options = SaveOptions()
+    ) const {
+      (void)target;
+      (void)width;
+      (void)height;
+      (void)pixelFormat;
+      (void)options;
+      return std::unique_ptr<RowSink>();
+    }
+
+    /// <summary>Determines the region of an image that should be loaded</summary>
+    /// <param name="options">Load options that may select a region of the image</param>
+    /// <param name="imageWidth">Width of the whole image in pixels</param>
+    /// <param name="imageHeight">Height of the whole image in pixels</param>
+    /// <returns>
+    ///   The region selected in the load options clipped to the image or, if the load
+    ///   options select no region, a rectangle covering the whole image
+    /// </returns>
+    /// <remarks>
+    ///   Helper for codec implementations so all codecs treat
+    ///   <see cref="LoadOptions.Region" /> the same way. Throws an exception if
+    ///   the region lies completely outside of the image.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static Rectangle GetLoadRegion(
+      const LoadOptions &options, std::size_t imageWidth, std::size_t imageHeight
+    );
+
+    /// <summary>Checks whether a file extension hint rules out a codec</summary>
+    /// <param name="extensionHint">
+    ///   File extension hint passed to the codec, with or without a leading dot
+    /// </param>
+    /// <param name="knownFileExtensions">
+    ///   File extensions used by the codec's file format in lower case without a dot
+    /// </param>
+    /// <returns>
+    ///   True if the extension hint is empty or matches one of the known file extensions
+    /// </returns>
+    /// <remarks>
+    ///   Helper for codec implementations whose <see cref="CanLoad" /> method wants to
+    ///   exit early if the file extension doesn't fit. The comparison ignores case.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static bool MightHaveFileExtension(
+      const std::string &extensionHint, const std::vector<std::string> &knownFileExtensions
+    );
 
   };
 
@@ -23,11 +23,21 @@ License along with this library
 
 #include "Nuclex/Pixels/Config.h"
 #include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/BitmapInfo.h"
+#include "Nuclex/Pixels/RowStream.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include "Nuclex/Pixels/Storage/AnimationReader.h"
+#include "Nuclex/Pixels/Storage/LoadOptions.h"
+#include "Nuclex/Pixels/Storage/LazyBitmap.h"
+#include "Nuclex/Pixels/Storage/SaveOptions.h"
 
 #include <string>
 #include <vector>
 #include <memory>
 #include <map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 namespace Nuclex { namespace Pixels { namespace Storage {
 
@@ -58,9 +68,89 @@ namespace Nuclex { namespace Pixels { namespace Storage {
   ///     recently used codecs first (assuming that if your game or application commonly
   ///     uses only one or two file formats)
   ///   </para>
+  ///   <para>
+  ///     Once all codecs have been registered, a single serializer can be shared by
+  ///     any number of threads loading and saving bitmaps at the same time. The list of
+  ///     most recently used codecs is updated lock-free. Registering codecs is not
+  ///     safe while other threads are using the serializer.
+  ///   </para>
   /// </remarks>
   class BitmapSerializer {
 
+    #pragma region struct CodecStatistics
+
+    /// <summary>Statistics about how the serializer has used one of its codecs</summary>
+    /// <remarks>
+    ///   Times are estimates accurate to about a fifth of their value, they are collected
+    ///   into buckets so that recording them never needs a lock.
+    /// </remarks>
+    public: struct CodecStatistics {
+
+      /// <summary>Name of the codec the statistics are for</summary>
+      public: std::string Name;
+      /// <summary>Number of times the codec was tried on a file</summary>
+      public: std::uint64_t ProbeCount;
+      /// <summary>Number of tries in which the codec rejected the file header</summary>
+      public: std::uint64_t HeaderRejectionCount;
+      /// <summary>Number of tries in which the codec read the file</summary>
+      public: std::uint64_t HitCount;
+      /// <summary>Number of tries in which the codec threw an exception</summary>
+      public: std::uint64_t FailureCount;
+      /// <summary>Number of bitmaps the codec has loaded</summary>
+      public: std::uint64_t LoadCount;
+      /// <summary>Total size of the files the codec has loaded bitmaps from</summary>
+      public: std::uint64_t LoadedByteCount;
+      /// <summary>Time half of the loads took at most, in microseconds</summary>
+      public: std::uint64_t MedianLoadMicroseconds;
+      /// <summary>Time 90 percent of the loads took at most, in microseconds</summary>
+      public: std::uint64_t Percentile90LoadMicroseconds;
+      /// <summary>Time 99 percent of the loads took at most, in microseconds</summary>
+      public: std::uint64_t Percentile99LoadMicroseconds;
+      /// <summary>Number of bitmaps the codec has saved</summary>
+      public: std::uint64_t SaveCount;
+      /// <summary>Number of saves in which the codec threw an exception</summary>
+      public: std::uint64_t SaveFailureCount;
+      /// <summary>Time half of the saves took at most, in microseconds</summary>
+      public: std::uint64_t MedianSaveMicroseconds;
+
+    };
+
+    #pragma endregion // struct CodecStatistics
+
+    #pragma region struct Statistics
+
+    /// <summary>Statistics about the files the serializer has identified and saved</summary>
+    /// <remarks>
+    ///   <para>
+    ///     Each time the serializer looks for the codec that can read a file, the search
+    ///     ends in one of the counters below. If most searches end up scanning through
+    ///     all codecs, the most recently used codecs are a poor prediction for the files
+    ///     being loaded and passing an extension hint would help.
+    ///   </para>
+    ///   <para>
+    ///     All counters are updated with relaxed atomic operations, so a snapshot taken
+    ///     while other threads are loading files may be off by the loads in progress.
+    ///   </para>
+    /// </remarks>
+    public: struct Statistics {
+
+      /// <summary>Statistics for each registered codec in order of registration</summary>
+      public: std::vector<CodecStatistics> Codecs;
+      /// <summary>Number of files read by the codec the extension hint pointed to</summary>
+      public: std::uint64_t HintHitCount;
+      /// <summary>Number of files read by the most recently used codec</summary>
+      public: std::uint64_t MostRecentHitCount;
+      /// <summary>Number of files read by the second most recently used codec</summary>
+      public: std::uint64_t SecondMostRecentHitCount;
+      /// <summary>Number of files for which all codecs had to be tried</summary>
+      public: std::uint64_t ScanHitCount;
+      /// <summary>Number of files no codec could read</summary>
+      public: std::uint64_t MissCount;
+
+    };
+
+    #pragma endregion // struct Statistics
+
     /// <summary>Initializes a new bitmap serializer</summary>
     public: NUCLEX_PIXELS_API BitmapSerializer();
 
@@ -102,75 +192,394 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     /// <returns>True if the bitmap store thinks it can load the file</returns>
     public: NUCLEX_PIXELS_API bool CanLoad(const std::string &path) const;
 
+    /// <summary>Reads the dimensions and pixel format of a bitmap without loading it</summary>
+    /// <param name="file">File whose header the bitmap store will read</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <param name="options">Settings controlling how the file would be read</param>
+    /// <returns>
+    ///   Informations about the bitmap or a BitmapInfo structure with 'Loadable' set
+    ///   to false if no registered codec can load the file
+    /// </returns>
+    public: NUCLEX_PIXELS_API BitmapInfo TryReadInfo(
+      const VirtualFile &file, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Reads the dimensions and pixel format of a bitmap without loading it</summary>
+    /// <param name="path">Path of the file whose header the bitmap store will read</param>
+    /// <param name="options">Settings controlling how the file would be read</param>
+    /// <returns>
+    ///   Informations about the bitmap or a BitmapInfo structure with 'Loadable' set
+    ///   to false if no registered codec can load the file
+    /// </returns>
+    public: NUCLEX_PIXELS_API BitmapInfo TryReadInfo(
+      const std::string &path, const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Identifies a file and returns a bitmap that decodes it on first access</summary>
+    /// <param name="file">File the bitmap will be decoded from</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>A lazy bitmap that knows the bitmap's dimensions and pixel format</returns>
+    /// <remarks>
+    ///   Only the file header is read here. The lazy bitmap takes ownership of the file
+    ///   and keeps it until it is destroyed. The bitmap serializer has to stay alive
+    ///   for as long as the lazy bitmap exists.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API LazyBitmap LoadLazily(
+      std::unique_ptr<const VirtualFile> &&file,
+      const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Identifies a file and returns a bitmap that decodes it on first access</summary>
+    /// <param name="path">Path of the file the bitmap will be decoded from</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>A lazy bitmap that knows the bitmap's dimensions and pixel format</returns>
+    /// <remarks>
+    ///   Only the file header is read here, then the file is closed again and reopened
+    ///   when the pixels are accessed. This makes it possible to index huge numbers of
+    ///   images without keeping a file handle open for each. The bitmap serializer has
+    ///   to stay alive for as long as the lazy bitmap exists.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API LazyBitmap LoadLazily(
+      const std::string &path, const LoadOptions &options = LoadOptions()
+    ) const;
+
     /// <summary>Loads the specified file into a new Bitmap</summary>
     /// <param name="file">File the bitmap store will load</param>
     /// <param name="extensionHint">
     ///   Optional file extension to help detection (may speed things up)
     /// </param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>The bitmap loaded from the specified file</returns>
     public: NUCLEX_PIXELS_API Bitmap Load(
-      const VirtualFile &file, const std::string &extensionHint = std::string()
+      const VirtualFile &file, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const;
 
     /// <summary>Loads the specified file into a new Bitmap</summary>
     /// <param name="path">Path of the file the bitmap store will load</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>The bitmap loaded from the specified file</returns>
-    public: NUCLEX_PIXELS_API Bitmap Load(const std::string &path) const;
+    public: NUCLEX_PIXELS_API Bitmap Load(
+      const std::string &path, const LoadOptions &options = LoadOptions()
+    ) const;
 
-    /// <summary>Loads the specified file into a new Bitmap</summary>
+    /// <summary>Loads the specified file into an existing Bitmap</summary>
+    /// <param name="exactFittingBitmap">
+    ///   Bitmap matching the size (of the region) and pixel format of the image
+    /// </param>
     /// <param name="file">File the bitmap store will load</param>
     /// <param name="extensionHint">
     ///   Optional file extension to help detection (may speed things up)
     /// </param>
-    /// <returns>The bitmap loaded from the specified file</returns>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <remarks>
+    ///   The bitmap can be a view into a larger bitmap (see <see cref="Bitmap.GetView" />),
+    ///   so images can be decoded straight into the cells of a texture atlas. Together with
+    ///   <see cref="LoadOptions.Region" />, only part of an image is decoded.
+    /// </remarks>
     public: NUCLEX_PIXELS_API void Reload(
       Bitmap &exactFittingBitmap,
-      const VirtualFile &file, const std::string &extensionHint = std::string()
+      const VirtualFile &file, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const;
 
-    /// <summary>Loads the specified file into a new Bitmap</summary>
+    /// <summary>Loads the specified file into an existing Bitmap</summary>
+    /// <param name="exactFittingBitmap">
+    ///   Bitmap matching the size (of the region) and pixel format of the image
+    /// </param>
     /// <param name="path">Path of the file the bitmap store will load</param>
-    /// <returns>The bitmap loaded from the specified file</returns>
+    /// <param name="options">Settings controlling how the file will be read</param>
     public: NUCLEX_PIXELS_API void Reload(
-      Bitmap &exactFittingBitmap, const std::string &path
+      Bitmap &exactFittingBitmap, const std::string &path,
+      const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Loads the specified file into externally provided memory</summary>
+    /// <param name="target">
+    ///   Memory matching the size (of the region) and pixel format of the image
+    /// </param>
+    /// <param name="file">File the bitmap store will load</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <remarks>
+    ///   <para>
+    ///     Meant for memory owned by someone else, such as a graphics API's upload buffer.
+    ///     The codec decodes rows straight into the memory using its stride, so the image
+    ///     is not copied again after loading. Use <see cref="TryReadInfo" /> to learn
+    ///     the size and pixel format of the image and <see cref="Bitmap.CalculateStride" />
+    ///     to lay out rows with the alignment the graphics API requires.
+    ///   </para>
+    ///   <para>
+    ///     Memory with a null address or with rows too short for its width is rejected
+    ///     with an std::invalid_argument before any codec looks at the file. If the image
+    ///     does not have the size or pixel format of the memory, the codec throws.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_PIXELS_API void LoadInto(
+      const BitmapMemory &target,
+      const VirtualFile &file, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const;
 
+    /// <summary>Loads the specified file into externally provided memory</summary>
+    /// <param name="target">
+    ///   Memory matching the size (of the region) and pixel format of the image
+    /// </param>
+    /// <param name="path">Path of the file the bitmap store will load</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    public: NUCLEX_PIXELS_API void LoadInto(
+      const BitmapMemory &target, const std::string &path,
+      const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Loads a batch of files in parallel</summary>
+    /// <typeparam name="TCallback">Callable object that receives the loaded bitmaps</typeparam>
+    /// <param name="threadPool">Thread pool on which the files will be loaded</param>
+    /// <param name="paths">Paths of the files that will be loaded</param>
+    /// <param name="callback">
+    ///   Callback that will be invoked with the index of each path and its loaded bitmap
+    /// </param>
+    /// <param name="options">Settings controlling how the files will be read</param>
+    /// <remarks>
+    ///   <para>
+    ///     Each file is opened, identified and decoded on one of the thread pool's threads,
+    ///     which then hands the bitmap to the callback right away. The callback is invoked
+    ///     from multiple threads at once, but exactly once per successfully loaded file.
+    ///     Returns when all files have been loaded.
+    ///   </para>
+    ///   <para>
+    ///     Because each thread only moves to the next file once the callback returns,
+    ///     no more bitmaps than the thread pool has threads are in flight at any time
+    ///     and a slow consumer (say, one uploading textures) throttles the loading.
+    ///   </para>
+    ///   <para>
+    ///     Before decoding a file, each thread asks the OS to read the file it will
+    ///     probably pick up next into its cache, so the disk is busy while the CPU
+    ///     decodes and files are rarely waited for.
+    ///   </para>
+    ///   <para>
+    ///     If a file can't be loaded, the files that haven't been started are skipped
+    ///     and the error is rethrown once all threads have finished.
+    ///   </para>
+    /// </remarks>
+    public: template<typename TCallback>
+    void LoadMany(
+      ThreadPool &threadPool, const std::vector<std::string> &paths, TCallback &&callback,
+      const LoadOptions &options = LoadOptions()
+    ) const {
+      std::size_t prefetchDistance = threadPool.CountThreads();
+      threadPool.ForEach(
+        paths.size(),
+        [this, &paths, &callback, &options, prefetchDistance](std::size_t index) {
+          std::size_t prefetchIndex = index + prefetchDistance;
+          if(prefetchIndex < paths.size()) {
+            prefetchFile(paths[prefetchIndex]);
+          }
+
+          Bitmap bitmap = Load(paths[index], options);
+          callback(index, bitmap);
+        }
+      );
+    }
+
     /// <summary>Saves a bitmap into the specified file</summary>
     /// <param name="bitmap">Bitmap that will be saved into a file</param>
     /// <param name="file">File the bitmap will be saved into</param>
     /// <param name="extension">File extension used to select the file format</param>
+    /// <param name="options">Settings controlling how the file will be written</param>
     public: NUCLEX_PIXELS_API void Save(
-      const Bitmap &bitmap, VirtualFile &file, const std::string &extension
+      const Bitmap &bitmap, VirtualFile &file, const std::string &extension,
+      const SaveOptions &options = SaveOptions()
     ) const;
 
     /// <summary>Saves a bitmap into the specified file</summary>
     /// <param name="bitmap">Bitmap that will be saved into a file</param>
     /// <param name="path">Path under which the file will be saved</param>
-    /// <param name="extension">File extension used to select the file format</param>
+    /// <param name="extension">
+    ///   File extension used to select the file format. If empty, the extension
+    ///   of the path is used.
+    /// </param>
+    /// <param name="options">Settings controlling how the file will be written</param>
     public: NUCLEX_PIXELS_API void Save(
-      const Bitmap &bitmap, const std::string &path, const std::string &extension
+      const Bitmap &bitmap, const std::string &path,
+      const std::string &extension = std::string(),
+      const SaveOptions &options = SaveOptions()
     ) const;
 
+    /// <summary>Identifies a file and opens it for reading its rows one by one</summary>
+    /// <param name="file">File the rows will be decoded from</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>A row source that decodes the image's rows as they are read</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Only the rows currently being read have to fit in memory, so images far
+    ///     larger than a bitmap could hold can be streamed through
+    ///     <see cref="PixelFormatConverter.ConvertRows" /> or
+    ///     <see cref="BitmapResampler.ResampleRows" /> into a row sink
+    ///     (see <see cref="OpenRowSink" /> and <see cref="TransferRows" />).
+    ///   </para>
+    ///   <para>
+    ///     The row source takes ownership of the file. Not all codecs can stream rows,
+    ///     if the file is in a format whose codec can't, an exception is thrown.
+    ///     <see cref="LoadOptions.Region" /> is not supported by row sources.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_PIXELS_API std::unique_ptr<RowSource> OpenRowSource(
+      std::unique_ptr<const VirtualFile> &&file,
+      const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Identifies a file and opens it for reading its rows one by one</summary>
+    /// <param name="path">Path of the file the rows will be decoded from</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>A row source that decodes the image's rows as they are read</returns>
+    public: NUCLEX_PIXELS_API std::unique_ptr<RowSource> OpenRowSource(
+      const std::string &path, const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Identifies a file and opens it for decoding its animation frames</summary>
+    /// <param name="file">File the frames will be decoded from</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>An animation reader that decodes frames into bitmaps you provide</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Frames are decoded one at a time from the file, which stays open, into the same
+    ///     bitmap (see <see cref="AnimationReader.ReloadFrame" />), so animations can be
+    ///     processed like video without the memory usage growing with their length.
+    ///   </para>
+    ///   <para>
+    ///     The animation reader takes ownership of the file. Codecs for formats that can
+    ///     also hold still images (such as PNG) open those as animations with one frame.
+    ///     If no codec can read the file as an animation, an exception is thrown.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_PIXELS_API std::unique_ptr<AnimationReader> OpenAnimation(
+      std::unique_ptr<const VirtualFile> &&file,
+      const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Identifies a file and opens it for decoding its animation frames</summary>
+    /// <param name="path">Path of the file the frames will be decoded from</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>An animation reader that decodes frames into bitmaps you provide</returns>
+    public: NUCLEX_PIXELS_API std::unique_ptr<AnimationReader> OpenAnimation(
+      const std::string &path, const LoadOptions &options = LoadOptions()
+    ) const;
+
+    /// <summary>Opens a file for writing an image into it row by row</summary>
+    /// <param name="file">File the image will be written into</param>
+    /// <param name="extension">File extension used to select the file format</param>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="pixelFormat">Pixel format the rows will be written in</param>
+    /// <param name="options">Settings controlling how the file will be written</param>
+    /// <returns>A row sink that encodes the rows written into it</returns>
+    /// <remarks>
+    ///   The row sink takes ownership of the file. The file is complete once the last row
+    ///   has been written into the row sink.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API std::unique_ptr<RowSink> OpenRowSink(
+      std::unique_ptr<VirtualFile> &&file, const std::string &extension,
+      std::size_t width, std::size_t height, PixelFormat pixelFormat,
+      const SaveOptions &options = SaveOptions()
+    ) const;
+
+    /// <summary>Opens a file for writing an image into it row by row</summary>
+    /// <param name="path">Path under which the file will be saved</param>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="pixelFormat">Pixel format the rows will be written in</param>
+    /// <param name="extension">
+    ///   File extension used to select the file format. If empty, the extension
+    ///   of the path is used.
+    /// </param>
+    /// <param name="options">Settings controlling how the file will be written</param>
+    /// <returns>A row sink that encodes the rows written into it</returns>
+    public: NUCLEX_PIXELS_API std::unique_ptr<RowSink> OpenRowSink(
+      const std::string &path,
+      std::size_t width, std::size_t height, PixelFormat pixelFormat,
+      const std::string &extension = std::string(),
+      const SaveOptions &options = SaveOptions()
+    ) const;
+
+    /// <summary>Retrieves statistics about the codecs the serializer has used</summary>
+    /// <returns>The statistics collected since the serializer was created</returns>
+    public: NUCLEX_PIXELS_API Statistics GetStatistics() const;
+
     /// <summary>Builds a new iterator that checks the codecs in most likely order</summary>
+    /// <param name="file">File the codecs will be tried on</param>
     /// <param name="extension">File extension, if known</param>
     /// <returns>An iterator that returns the codec indices to try in order</returns>
     /// <remarks>
-    ///   This is only a template so I don't have do expose the iterator implementation
-    ///   in a public header. There's exactly one specialization of the method.
+    ///   <para>
+    ///     This is only a template so I don't have do expose the iterator implementation
+    ///     in a public header. There's exactly one specialization of the method.
+    ///   </para>
+    ///   <para>
+    ///     The file header is read once up front and codecs that reject it are skipped,
+    ///     so a file with a missing or wrong extension doesn't get read by every codec.
+    ///   </para>
     /// </remarks>
     private: template<typename TOutput>
     bool tryCodecsInOptimalOrder(
-      const std::string &extension,
+      const VirtualFile &file, const std::string &extension,
       bool (*tryCodecCallback)(
         const BitmapCodec &codec, const std::string &extension, TOutput &result
       ),
       TOutput &result
     ) const;
     
+    /// <summary>Looks up the codec that saves files with the specified extension</summary>
+    /// <param name="extension">File extension, with or without a leading dot</param>
+    /// <returns>The codec that saves files with the specified extension</returns>
+    private: const BitmapCodec &getCodecForSaving(const std::string &extension) const;
+
+    /// <summary>Atomic counters for how one codec has been used</summary>
+    private: struct CodecCounters;
+
+    /// <summary>Looks up the counters for a registered codec</summary>
+    /// <param name="codec">Codec whose counters will be looked up</param>
+    /// <returns>The counters for the specified codec</returns>
+    private: CodecCounters &getCodecCounters(const BitmapCodec &codec) const;
+
+    /// <summary>Records the time a codec took to load or save a bitmap</summary>
+    /// <param name="codec">Codec that loaded or saved the bitmap</param>
+    /// <param name="startTime">Time at which loading or saving began</param>
+    /// <param name="fileByteCount">Size of the file the bitmap was loaded from</param>
+    /// <param name="wasSaved">True if the bitmap was saved rather than loaded</param>
+    private: void recordTransfer(
+      const BitmapCodec &codec, std::chrono::steady_clock::time_point startTime,
+      std::uint64_t fileByteCount, bool wasSaved
+    ) const;
+
     /// <summary>Updates the list of most recently used codecs</summary>
     /// <param name="codecIndex">Index of the codec that was most recently used</param>
     private: void updateMostRecentCodecIndex(std::size_t codecIndex) const;
 
+    /// <summary>Asks the OS to read a file into its cache in the background</summary>
+    /// <param name="path">Path of the file that will be prefetched</param>
+    /// <remarks>
+    ///   Any errors are ignored, they will be reported when the file is loaded.
+    /// </remarks>
+    private: NUCLEX_PIXELS_API static void prefetchFile(const std::string &path);
+
     /// <summary>Maps file extensions to codecs</summary>
     private: typedef std::map<std::string, std::size_t> ExtensionCodecIndexMap;
     /// <summary>Stores a sequential list of codecs</summary>
@@ -180,10 +589,19 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     private: ExtensionCodecIndexMap codecsByExtension;
     /// <summary>Codecs that have been registered with the bitmap store</summary>
     private: CodecVector codecs;
-    /// <summary>Codec that was most recently accessed, -1 if none</summary>
-    private: mutable std::size_t mostRecentCodecIndex;
-    /// <summary>Codec that was second-most recently accessed, -1 if none</summary>
-    private: mutable std::size_t secondMostRecentCodecIndex;
+    /// <summary>Indices of the two most recently used codecs</summary>
+    /// <remarks>
+    ///   The most recently used codec is stored in the lower 32 bits, the second-most
+    ///   recently used one in the upper 32 bits (all bits set if none). Keeping both
+    ///   in one atomic variable lets concurrent loads update them without locking
+    ///   and without ever observing a half-updated pair.
+    /// </remarks>
+    private: mutable std::atomic<std::uint64_t> mostRecentCodecIndices;
+
+    /// <summary>Atomic counters from which the statistics are compiled</summary>
+    private: struct Counters;
+    /// <summary>Counters for the codec lookups and for each registered codec</summary>
+    private: std::unique_ptr<Counters> counters;
 
   };
 
@@ -0,0 +1,144 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_BLOBFILE_H
+#define NUCLEX_PIXELS_STORAGE_BLOBFILE_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileAccessError.h"
+
+#include <memory> // for std::shared_ptr
+#include <system_error> // for std::make_error_code()
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Exposes a blob from Nuclex.Storage as a virtual file</summary>
+  /// <typeparam name="TBlob">
+  ///   Type of blob that will be adapted, usually <code>Nuclex::Storage::Blob</code>
+  /// </typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Lets the <see cref="BitmapSerializer" /> load images stored in pack files,
+  ///     slices of other blobs or memory-mapped files managed by Nuclex.Storage.
+  ///     Requests for contiguous spans are forwarded to the blob, so if it keeps its
+  ///     contents in memory (such as a MemoryBlob, a MappedFileBlob or a BlobSlice
+  ///     of either), codecs decode straight from the blob's memory without copying it.
+  ///   </para>
+  ///   <para>
+  ///     Nuclex.Pixels does not link against Nuclex.Storage, so this adapter is
+  ///     a template that only needs the blob's GetSize(), ReadAt(), WriteAt() and
+  ///     TryGetContiguousSpan() methods. Include Nuclex.Storage's Blob.h before
+  ///     instantiating it with its blob class.
+  ///   </para>
+  ///   <para>
+  ///     The blob is either borrowed (it has to outlive the file) or shared via
+  ///     std::shared_ptr. Files adapting a const blob can not be written to.
+  ///   </para>
+  /// </remarks>
+  template<typename TBlob>
+  class BlobFile : public VirtualFile {
+
+    /// <summary>Initializes a new read-only file accessing a borrowed blob</summary>
+    /// <param name="blob">Blob that will be accessed, has to outlive the file</param>
+    public: explicit BlobFile(const TBlob &blob) :
+      owner(),
+      readableBlob(&blob),
+      writableBlob(nullptr) {}
+
+    /// <summary>Initializes a new file accessing a borrowed blob</summary>
+    /// <param name="blob">Blob that will be accessed, has to outlive the file</param>
+    public: explicit BlobFile(TBlob &blob) :
+      owner(),
+      readableBlob(&blob),
+      writableBlob(&blob) {}
+
+    /// <summary>Initializes a new file sharing ownership of a blob</summary>
+    /// <param name="blob">Blob that will be accessed</param>
+    public: explicit BlobFile(const std::shared_ptr<TBlob> &blob) :
+      owner(blob),
+      readableBlob(blob.get()),
+      writableBlob(blob.get()) {}
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: virtual ~BlobFile() = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override {
+      return this->readableBlob->GetSize();
+    }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <param name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override {
+      this->readableBlob->ReadAt(start, buffer, byteCount);
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override {
+      if(this->writableBlob == nullptr) {
+        throw Errors::FileAccessError(
+          std::make_error_code(std::errc::permission_denied),
+          u8"Files accessing a const blob can not be written to"
+        );
+      }
+
+      this->writableBlob->WriteAt(start, buffer, byteCount);
+    }
+
+    /// <summary>Tries to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes the range should cover</param>
+    /// <returns>
+    ///   The address of the first byte in the range or null if the blob can not provide
+    ///   its contents without copying them
+    /// </returns>
+    public: const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      return this->readableBlob->TryGetContiguousSpan(start, byteCount);
+    }
+
+    /// <summary>Keeps the blob alive if the file shares ownership of it</summary>
+    private: std::shared_ptr<TBlob> owner;
+    /// <summary>Blob that will be read from</summary>
+    private: const TBlob *readableBlob;
+    /// <summary>Blob that will be written to, null if the blob is const</summary>
+    private: TBlob *writableBlob;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_BLOBFILE_H
@@ -0,0 +1,119 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_DECODECONTEXT_H
+#define NUCLEX_PIXELS_STORAGE_DECODECONTEXT_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include <memory> // for std::unique_ptr
+#include <utility> // for std::pair
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BitmapCodec;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps the decoder state of codecs alive between loads</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Setting up an image library's decoder can cost as much as decoding a small image
+  ///     (libjpeg allocates its memory pools and Huffman tables, libpng and zlib allocate
+  ///     their structures and inflate window). If you load lots of small images, create
+  ///     one decode context and hand it to each load via <see cref="LoadOptions.Context" />.
+  ///     Codecs that support it will then keep their decoder state in the context, reset
+  ///     it after each load and reuse it for the next load instead of setting it up again.
+  ///   </para>
+  ///   <para>
+  ///     A decode context is not thread-safe. Use one decode context per thread, it can
+  ///     be shared between any number of bitmap serializers used on that thread.
+  ///   </para>
+  /// </remarks>
+  class DecodeContext {
+
+    /// <summary>Decoder state a codec keeps in the decode context</summary>
+    public: class State {
+
+      /// <summary>Frees all resources owned by the decoder state</summary>
+      public: virtual ~State() = default;
+
+    };
+
+    /// <summary>Initializes a new, empty decode context</summary>
+    public: NUCLEX_PIXELS_API DecodeContext();
+
+    /// <summary>Frees the decoder states of all codecs</summary>
+    public: NUCLEX_PIXELS_API ~DecodeContext();
+
+    /// <summary>Looks up the decoder state stored for a codec</summary>
+    /// <param name="codec">Codec whose decoder state will be looked up</param>
+    /// <returns>The codec's decoder state or a null pointer if it has none yet</returns>
+    public: NUCLEX_PIXELS_API State *GetState(const BitmapCodec &codec) const;
+
+    /// <summary>Stores the decoder state for a codec</summary>
+    /// <param name="codec">Codec whose decoder state will be stored</param>
+    /// <param name="state">
+    ///   Decoder state that will be stored, replaces any state the codec stored before
+    /// </param>
+    public: NUCLEX_PIXELS_API void SetState(
+      const BitmapCodec &codec, std::unique_ptr<State> &&state
+    );
+
+    /// <summary>Provides the decoder state of a codec, creating it if needed</summary>
+    /// <typeparam name="TState">Type of decoder state the codec uses</typeparam>
+    /// <param name="codec">Codec whose decoder state will be provided</param>
+    /// <returns>The codec's decoder state</returns>
+    public: template<typename TState>
+    TState &Acquire(const BitmapCodec &codec) {
+      State *state = GetState(codec);
+      if(state == nullptr) {
+        std::unique_ptr<State> newState(new TState());
+        state = newState.get();
+        SetState(codec, std::move(newState));
+      }
+      return *static_cast<TState *>(state);
+    }
+
+    /// <summary>Frees the decoder states of all codecs</summary>
+    /// <remarks>
+    ///   The codecs will set up their decoders from scratch the next time they
+    ///   use the decode context.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API void Clear();
+
+    private: DecodeContext(const DecodeContext &) = delete;
+    private: DecodeContext &operator =(const DecodeContext &) = delete;
+
+    /// <summary>Decoder states stored by the codecs</summary>
+    private: std::vector<
+      std::pair<const BitmapCodec *, std::unique_ptr<State>>
+    > states;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_DECODECONTEXT_H
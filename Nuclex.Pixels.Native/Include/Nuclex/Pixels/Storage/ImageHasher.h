@@ -0,0 +1,76 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_IMAGEHASHER_H
+#define NUCLEX_PIXELS_STORAGE_IMAGEHASHER_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include <cstdint> // for std::uint64_t
+#include <string> // for std::string
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BitmapSerializer;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Computes perceptual hashes of image files to find duplicates</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Produces the same kind of hashes as <see cref="BitmapAnalyzer.ComputePerceptualHash" />
+  ///     and <see cref="BitmapAnalyzer.ComputeDifferenceHash" />, but decodes only as much
+  ///     of the file as the hash needs. JPEG files are decoded at the smallest scale that
+  ///     still leaves enough pixels for the hash (down to an eighth of their size, which
+  ///     skips most of the inverse DCT). The hash is computed from the luminance
+  ///     component alone, so neither chroma upsampling nor color conversion take place.
+  ///   </para>
+  ///   <para>
+  ///     Other file formats are loaded completely through the bitmap serializer.
+  ///     The hashes of a JPEG file obtained either way only differ in a few bits.
+  ///   </para>
+  /// </remarks>
+  class ImageHasher {
+
+    /// <summary>Computes a difference hash (dHash) of an image file</summary>
+    /// <param name="serializer">Bitmap serializer used to load files other than JPEG</param>
+    /// <param name="path">Path of the image file that will be hashed</param>
+    /// <returns>A 64 bit hash describing the brightness gradients in the image</returns>
+    public: NUCLEX_PIXELS_API static std::uint64_t ComputeDifferenceHash(
+      const BitmapSerializer &serializer, const std::string &path
+    );
+
+    /// <summary>Computes a DCT-based perceptual hash (pHash) of an image file</summary>
+    /// <param name="serializer">Bitmap serializer used to load files other than JPEG</param>
+    /// <param name="path">Path of the image file that will be hashed</param>
+    /// <returns>A 64 bit hash describing the low frequencies in the image</returns>
+    public: NUCLEX_PIXELS_API static std::uint64_t ComputePerceptualHash(
+      const BitmapSerializer &serializer, const std::string &path
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_IMAGEHASHER_H
@@ -0,0 +1,123 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_JPEGPLANES_H
+#define NUCLEX_PIXELS_STORAGE_JPEGPLANES_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Storage/LoadOptions.h"
+
+#include <cstddef> // for std::size_t
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Color components of a JPEG file, decoded without any color conversion</summary>
+  /// <remarks>
+  ///   <para>
+  ///     JPEG files usually store their pixels as Y, Cb and Cr components, with the two
+  ///     chroma components at half or a quarter of the luminance component's resolution.
+  ///     Loading a JPEG file into a <see cref="Bitmap" /> upsamples the chroma components
+  ///     and converts everything to RGB, which is wasted work if the pixels will be turned
+  ///     into YCbCr again right away, i.e. by a video encoder.
+  ///   </para>
+  ///   <para>
+  ///     This class decodes the components exactly as they are stored in the file and
+  ///     provides each as an 8 bit bitmap in <see cref="PixelFormat.R8_Unsigned" />.
+  ///     The planes appear in the order the file stores the components in, which is
+  ///     Y, Cb and Cr for color images and a single Y plane for grayscale images.
+  ///     The scale set in the load options is honored, selecting a region is not supported.
+  ///   </para>
+  /// </remarks>
+  class JpegPlanes {
+
+    /// <summary>Decodes the color components of a JPEG file</summary>
+    /// <param name="path">Path of the JPEG file that will be decoded</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>The decoded color components of the JPEG file</returns>
+    public: NUCLEX_PIXELS_API static JpegPlanes Load(
+      const std::string &path, const LoadOptions &options = LoadOptions()
+    );
+
+    /// <summary>Decodes the color components of a JPEG file</summary>
+    /// <param name="file">JPEG file that will be decoded</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>The decoded color components of the JPEG file</returns>
+    public: NUCLEX_PIXELS_API static JpegPlanes Load(
+      const VirtualFile &file, const LoadOptions &options = LoadOptions()
+    );
+
+    /// <summary>Constructs JPEG planes by taking over existing ones</summary>
+    /// <param name="other">JPEG planes that will be taken over</param>
+    public: NUCLEX_PIXELS_API JpegPlanes(JpegPlanes &&other) = default;
+
+    /// <summary>Frees the memory holding the planes</summary>
+    public: NUCLEX_PIXELS_API ~JpegPlanes() = default;
+
+    /// <summary>Returns the width of the decoded image in pixels</summary>
+    /// <returns>The width of the decoded image</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetWidth() const { return this->width; }
+
+    /// <summary>Returns the height of the decoded image in pixels</summary>
+    /// <returns>The height of the decoded image</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetHeight() const { return this->height; }
+
+    /// <summary>Counts the color components that have been decoded</summary>
+    /// <returns>The number of planes, 3 for color images and 1 for grayscale images</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountPlanes() const { return this->planes.size(); }
+
+    /// <summary>Provides access to the pixels of a color component</summary>
+    /// <param name="planeIndex">Index of the color component in the file</param>
+    /// <returns>A bitmap holding the color component at its stored resolution</returns>
+    public: NUCLEX_PIXELS_API const Bitmap &GetPlane(std::size_t planeIndex) const;
+
+    /// <summary>Takes over other JPEG planes</summary>
+    /// <param name="other">Other JPEG planes that will be taken over</param>
+    /// <returns>These JPEG planes</returns>
+    public: NUCLEX_PIXELS_API JpegPlanes &operator =(JpegPlanes &&other) = default;
+
+    /// <summary>Initializes new, empty JPEG planes</summary>
+    private: JpegPlanes();
+
+    private: JpegPlanes(const JpegPlanes &) = delete;
+    private: JpegPlanes &operator =(const JpegPlanes &) = delete;
+
+    /// <summary>Width of the decoded image in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the decoded image in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Bitmaps holding the decoded color components</summary>
+    private: std::vector<Bitmap> planes;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_JPEGPLANES_H
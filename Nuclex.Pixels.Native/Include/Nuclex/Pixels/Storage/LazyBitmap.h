@@ -0,0 +1,168 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_LAZYBITMAP_H
+#define NUCLEX_PIXELS_STORAGE_LAZYBITMAP_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/BitmapInfo.h"
+#include "Nuclex/Pixels/Storage/LoadOptions.h"
+
+#include <memory>
+#include <string>
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BitmapCodec;
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Bitmap whose pixels are only decoded when they are first accessed</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Obtained from <see cref="BitmapSerializer.LoadLazily" />, which identifies the file
+  ///     and reads only its header. The dimensions and pixel format are available right
+  ///     away, the pixels are decoded on the first call to <see cref="Access" /> (or
+  ///     <see cref="GetBitmap" />) and kept until <see cref="Unload" /> is called.
+  ///   </para>
+  ///   <para>
+  ///     Lazy bitmaps created from a path do not keep the file open between loads,
+  ///     so any number of them can exist without running out of file handles.
+  ///   </para>
+  ///   <para>
+  ///     The codec that identified the file is used to decode it, so the bitmap
+  ///     serializer that created a lazy bitmap has to outlive it. A lazy bitmap must not
+  ///     be accessed by multiple threads at once.
+  ///   </para>
+  /// </remarks>
+  class LazyBitmap {
+
+    /// <summary>Initializes a lazy bitmap that will decode an already opened file</summary>
+    /// <param name="codec">Codec that will decode the file</param>
+    /// <param name="info">Informations about the bitmap as read by the codec</param>
+    /// <param name="file">File the bitmap will be decoded from</param>
+    /// <param name="extensionHint">File extension that will be passed to the codec</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    public: NUCLEX_PIXELS_API LazyBitmap(
+      const BitmapCodec &codec, const BitmapInfo &info,
+      std::unique_ptr<const VirtualFile> &&file, const std::string &extensionHint,
+      const LoadOptions &options
+    );
+
+    /// <summary>Initializes a lazy bitmap that will open and decode a file on disk</summary>
+    /// <param name="codec">Codec that will decode the file</param>
+    /// <param name="info">Informations about the bitmap as read by the codec</param>
+    /// <param name="path">Path of the file the bitmap will be decoded from</param>
+    /// <param name="extensionHint">File extension that will be passed to the codec</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    public: NUCLEX_PIXELS_API LazyBitmap(
+      const BitmapCodec &codec, const BitmapInfo &info,
+      const std::string &path, const std::string &extensionHint,
+      const LoadOptions &options
+    );
+
+    /// <summary>Constructs a lazy bitmap by taking over an existing one</summary>
+    /// <param name="other">Lazy bitmap that will be taken over</param>
+    public: NUCLEX_PIXELS_API LazyBitmap(LazyBitmap &&other);
+
+    /// <summary>Frees all resources owned by the lazy bitmap</summary>
+    public: NUCLEX_PIXELS_API ~LazyBitmap();
+
+    /// <summary>Returns informations about the bitmap read from the file header</summary>
+    /// <returns>The informations about the bitmap</returns>
+    public: NUCLEX_PIXELS_API const BitmapInfo &GetInfo() const {
+      return this->info;
+    }
+
+    /// <summary>Returns the width of the bitmap in pixels</summary>
+    /// <returns>The width of the bitmap in pixels</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetWidth() const {
+      return this->info.Width;
+    }
+
+    /// <summary>Returns the height of the bitmap in pixels</summary>
+    /// <returns>The height of the bitmap in pixels</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetHeight() const {
+      return this->info.Height;
+    }
+
+    /// <summary>Returns the pixel format in which the pixels will be stored</summary>
+    /// <returns>The pixel format the bitmap's pixels will be decoded into</returns>
+    public: NUCLEX_PIXELS_API PixelFormat GetPixelFormat() const {
+      return this->info.PixelFormat;
+    }
+
+    /// <summary>Checks whether the pixels have already been decoded</summary>
+    /// <returns>True if the pixels are in memory, false otherwise</returns>
+    public: NUCLEX_PIXELS_API bool IsLoaded() const {
+      return static_cast<bool>(this->bitmap);
+    }
+
+    /// <summary>Returns the bitmap, decoding its pixels if needed</summary>
+    /// <returns>The bitmap holding the decoded pixels</returns>
+    public: NUCLEX_PIXELS_API const Bitmap &GetBitmap() const;
+
+    /// <summary>Accesses the bitmap's pixels, decoding them if needed</summary>
+    /// <returns>A description of the bitmap's memory layout</returns>
+    public: NUCLEX_PIXELS_API const BitmapMemory &Access() const {
+      return GetBitmap().Access();
+    }
+
+    /// <summary>Frees the decoded pixels</summary>
+    /// <remarks>
+    ///   The pixels will be decoded again on the next access. Bitmaps that have been
+    ///   handed out by <see cref="GetBitmap" /> and copied or viewed keep their pixels.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API void Unload();
+
+    /// <summary>Takes over another lazy bitmap</summary>
+    /// <param name="other">Other lazy bitmap that will be taken over</param>
+    /// <returns>This lazy bitmap</returns>
+    public: NUCLEX_PIXELS_API LazyBitmap &operator =(LazyBitmap &&other);
+
+    private: LazyBitmap(const LazyBitmap &) = delete;
+    private: LazyBitmap &operator =(const LazyBitmap &) = delete;
+
+    /// <summary>Codec that identified the file and will decode it</summary>
+    private: const BitmapCodec *codec;
+    /// <summary>Informations about the bitmap as read by the codec</summary>
+    private: BitmapInfo info;
+    /// <summary>File the bitmap will be decoded from, null if it's opened by path</summary>
+    private: std::unique_ptr<const VirtualFile> file;
+    /// <summary>Path of the file the bitmap will be decoded from, if opened by path</summary>
+    private: std::string path;
+    /// <summary>File extension that will be passed to the codec</summary>
+    private: std::string extensionHint;
+    /// <summary>Settings controlling how the file will be read</summary>
+    private: LoadOptions options;
+    /// <summary>Bitmap holding the decoded pixels, null until they're accessed</summary>
+    private: mutable std::unique_ptr<Bitmap> bitmap;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_LAZYBITMAP_H
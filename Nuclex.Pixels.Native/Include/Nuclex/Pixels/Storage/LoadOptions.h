@@ -0,0 +1,271 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_LOADOPTIONS_H
+#define NUCLEX_PIXELS_STORAGE_LOADOPTIONS_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/Rectangle.h"
+
+#include <cstddef> // for std::size_t
+#include <functional> // for std::function
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class DecodeContext;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sizes at which JPEG files can be decoded</summary>
+  /// <remarks>
+  ///   JPEG stores pixels as frequencies in blocks of 8x8 pixels. Decoding only
+  ///   the lower frequencies directly yields a smaller image, which is several times
+  ///   faster than decoding the full image and shrinking it afterwards.
+  /// </remarks>
+  enum class JpegLoadScale {
+
+    /// <summary>The image is decoded at its full size</summary>
+    Full,
+    /// <summary>The image is decoded at half its width and height</summary>
+    Half,
+    /// <summary>The image is decoded at a quarter of its width and height</summary>
+    Quarter,
+    /// <summary>The image is decoded at an eighth of its width and height</summary>
+    Eighth
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how JPEG files are read</summary>
+  struct JpegLoadOptions {
+
+    /// <summary>Initializes new JPEG load options decoding images at full size</summary>
+    public: JpegLoadOptions() :
+      Scale(JpegLoadScale::Full),
+      PixelFormat(PixelFormat::R8_G8_B8_Unsigned) {}
+
+    /// <summary>Size at which the image will be decoded</summary>
+    /// <remarks>
+    ///   The width and height of the image are rounded up when they are not evenly
+    ///   divisible. Information read about the image reports the scaled size, so
+    ///   bitmaps passed to Reload() have to be of the scaled size, too.
+    /// </remarks>
+    public: JpegLoadScale Scale;
+
+    /// <summary>Pixel format the decoded image will be delivered in</summary>
+    /// <remarks>
+    ///   <para>
+    ///     libjpeg writes <see cref="PixelFormat.R8_G8_B8_Unsigned" /> and
+    ///     <see cref="PixelFormat.R8_Unsigned" /> directly, the latter receiving the luminance
+    ///     of color images without any color conversion taking place. When
+    ///     built against libjpeg-turbo, it also writes
+    ///     <see cref="PixelFormat.B8_G8_R8_Unsigned" /> and the four 32 bit RGBA orderings
+    ///     (such as <see cref="PixelFormat.R8_G8_B8_A8_Unsigned" />) directly, with an opaque
+    ///     alpha channel. Any other pixel format is converted to a batch of scanlines at a time
+    ///     while decoding, so the image is never held in two pixel formats at once.
+    ///   </para>
+    ///   <para>
+    ///     Information read about the image reports this pixel format, so bitmaps passed
+    ///     to Reload() have to be in this pixel format, too.
+    ///   </para>
+    /// </remarks>
+    public: enum PixelFormat PixelFormat;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how PNG files are read</summary>
+  struct PngLoadOptions {
+
+    /// <summary>Initializes new PNG load options reading the whole image at once</summary>
+    public: PngLoadOptions() :
+      ChunkSize(65536),
+      VerifyChecksums(true) {}
+
+    /// <summary>Number of bytes that will be fed to the progressive reader at a time</summary>
+    /// <remarks>
+    ///   Only used when <see cref="RowDecoded" /> is set or the file is memory-mapped.
+    ///   Smaller chunks report rows sooner, larger chunks cause fewer reads on the file.
+    /// </remarks>
+    public: std::size_t ChunkSize;
+
+    /// <summary>Whether the checksums of the chunks and the image data are verified</summary>
+    /// <remarks>
+    ///   libpng computes a CRC-32 over each chunk and zlib an Adler-32 over the inflated
+    ///   image data, which is a noticeable part of the decoding time for images that
+    ///   compress well. Only turn this off for files from trusted sources (such as your
+    ///   own texture atlases), corrupted files will then decode into garbage pixels
+    ///   instead of being reported as errors.
+    /// </remarks>
+    public: bool VerifyChecksums;
+
+    /// <summary>Called each time a row of the image has been decoded</summary>
+    /// <remarks>
+    ///   <para>
+    ///     If set, the PNG is decoded with libpng's progressive reader, which is fed
+    ///     the file in chunks of <see cref="ChunkSize" /> bytes and hands out rows
+    ///     as soon as the data for them has arrived. The callback receives the memory
+    ///     of the bitmap being loaded, the index of the row that has changed and
+    ///     the interlace pass (always 0 for images that are not interlaced).
+    ///   </para>
+    ///   <para>
+    ///     Interlaced images deliver each row several times with increasing detail,
+    ///     the rows below the reported one may still be empty or incomplete.
+    ///   </para>
+    /// </remarks>
+    public: std::function<
+      void(const BitmapMemory &memory, std::size_t row, int pass)
+    > RowDecoded;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how EXR files are read</summary>
+  struct ExrLoadOptions {
+
+    /// <summary>Initializes new EXR load options using OpenEXR's thread pool as it is</summary>
+    public: ExrLoadOptions() :
+      ThreadCount(-1),
+      Part(0),
+      Layer(),
+      Channels() {}
+
+    /// <summary>Number of worker threads in OpenEXR's global thread pool</summary>
+    /// <remarks>
+    ///   OpenEXR decompresses blocks of scanlines or tiles in parallel on its own global
+    ///   thread pool. If this is zero or more, the thread pool will be resized to
+    ///   the specified number of threads before loading (zero decompresses on the calling
+    ///   thread only), which affects all other users of OpenEXR in the process, too.
+    ///   A negative value leaves the thread pool the way it is.
+    /// </remarks>
+    public: int ThreadCount;
+
+    /// <summary>Index of the part that will be loaded from multi-part EXR files</summary>
+    /// <remarks>
+    ///   Multi-part files store several independent images, for example one per render
+    ///   pass, and OpenEXR only reads the blocks belonging to the selected part.
+    ///   Single-part files only have part 0.
+    /// </remarks>
+    public: std::size_t Part;
+
+    /// <summary>Name of the layer whose R, G, B and A channels will be loaded</summary>
+    /// <remarks>
+    ///   Renderers store additional passes (AOVs) as layers whose channels are named
+    ///   &quot;layer.R&quot;, &quot;layer.G&quot; and so on. If this is empty, the channels
+    ///   without a layer prefix are loaded. Ignored if <see cref="Channels" /> is set.
+    /// </remarks>
+    public: std::string Layer;
+
+    /// <summary>Names of up to four individual channels that will be loaded</summary>
+    /// <remarks>
+    ///   <para>
+    ///     If set, only these channels are handed to the bitmap, in the order listed.
+    ///     OpenEXR skips converting and copying all other channels and the bitmap only
+    ///     needs room for the selected ones: a single channel is loaded as
+    ///     <see cref="PixelFormat.R16_Float_Native16" /> or
+    ///     <see cref="PixelFormat.R32_Float_Native32" />, two half precision channels as
+    ///     <see cref="PixelFormat.R16_G16_Float_Native16" />. Anything else is loaded as
+    ///     half or float RGBA with unselected color channels set to 0 and alpha to 1.
+    ///   </para>
+    ///   <para>
+    ///     Selecting a channel the file does not contain is reported as an error.
+    ///   </para>
+    /// </remarks>
+    public: std::vector<std::string> Channels;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how bitmaps are read by the codecs</summary>
+  /// <remarks>
+  ///   Each codec only looks at the settings for its own file format, so a single
+  ///   instance can be used no matter which format a file turns out to be in.
+  /// </remarks>
+  struct LoadOptions {
+
+    /// <summary>Initializes new load options with the default read-ahead window</summary>
+    public: LoadOptions() :
+      ReadAheadByteCount(262144),
+      Region(0, 0, 0, 0),
+      Context(nullptr) {}
+
+    /// <summary>Number of bytes read ahead when loading an image by its path</summary>
+    /// <remarks>
+    ///   The image libraries read files in small pieces. When a bitmap is loaded from
+    ///   a path, the file is read in windows of this size instead and the pieces are
+    ///   served from memory, which avoids a system call for each piece (very noticeable
+    ///   on network file systems). Zero disables the read-ahead buffer. Files passed
+    ///   to the bitmap serializer directly are used as they are.
+    /// </remarks>
+    public: std::size_t ReadAheadByteCount;
+
+    /// <summary>Region of the image that will be loaded</summary>
+    /// <remarks>
+    ///   <para>
+    ///     Coordinates are relative to the upper left corner of the image (or, for EXR
+    ///     files, of its data window, and for JPEG files loaded at a reduced scale, of
+    ///     the scaled image). The region is clipped to the image and the loaded bitmap
+    ///     will only be as large as the clipped region. Information read about the image
+    ///     reports the size of the region, so bitmaps passed to Reload() have to be of
+    ///     that size, too. An empty rectangle (the default) loads the whole image.
+    ///   </para>
+    ///   <para>
+    ///     Together with Reload() and <see cref="Bitmap.GetView" />, this can decode parts
+    ///     of images straight into a texture atlas. The codecs skip as much work as their
+    ///     file format allows: JPEG files only decode the blocks overlapping the region
+    ///     (when built against libjpeg-turbo, otherwise all rows above it are decoded
+    ///     to be discarded), PNG files stop decoding after the region's last row and
+    ///     tiled EXR files only decompress the tiles overlapping the region.
+    ///   </para>
+    /// </remarks>
+    public: Rectangle Region;
+
+    /// <summary>Settings used when a JPEG file is loaded</summary>
+    public: JpegLoadOptions Jpeg;
+    /// <summary>Settings used when a PNG file is loaded</summary>
+    public: PngLoadOptions Png;
+    /// <summary>Settings used when an EXR file is loaded</summary>
+    public: ExrLoadOptions Exr;
+
+    /// <summary>Decode context in which codecs can keep their decoder state</summary>
+    /// <remarks>
+    ///   Optional. If set, the JPEG and PNG codecs reuse the decoder state kept in
+    ///   the context instead of setting up their decoder anew for each image, which
+    ///   helps when loading many small images. The context is not owned by the load
+    ///   options and must only be used by one thread at a time.
+    /// </remarks>
+    public: DecodeContext *Context;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_LOADOPTIONS_H
@@ -0,0 +1,323 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_SAVEOPTIONS_H
+#define NUCLEX_PIXELS_STORAGE_SAVEOPTIONS_H
+
+#include "Nuclex/Pixels/Config.h"
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class ThreadPool;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Strategies zlib can use to compress the pixels of a PNG file</summary>
+  enum class PngCompressionStrategy {
+
+    /// <summary>Normal deflate compression, best for most images</summary>
+    Default,
+    /// <summary>Favors huffman coding over string matching, for filtered images</summary>
+    Filtered,
+    /// <summary>Only uses huffman coding, fast but compresses poorly</summary>
+    HuffmanOnly,
+    /// <summary>Only matches runs of identical bytes, good for flat artwork</summary>
+    RunLength,
+    /// <summary>Uses fixed huffman codes, saving the code tables on tiny images</summary>
+    Fixed
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Filters PNG can apply to each row to make the pixels compress better</summary>
+  enum class PngRowFilter {
+
+    /// <summary>Rows are stored as they are, fastest to write</summary>
+    None,
+    /// <summary>Each pixel is stored as the difference to its left neighbour</summary>
+    Sub,
+    /// <summary>Each pixel is stored as the difference to the pixel above it</summary>
+    Up,
+    /// <summary>Each pixel is stored as the difference to its left and upper neighbours</summary>
+    Average,
+    /// <summary>Each pixel is predicted from its left, upper and upper left neighbours</summary>
+    Paeth,
+    /// <summary>All filters are tried on each row and the most promising one is used</summary>
+    Adaptive
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how PNG files are written</summary>
+  struct PngSaveOptions {
+
+    /// <summary>Initializes new PNG save options with the libpng default settings</summary>
+    public: PngSaveOptions() :
+      CompressionLevel(6),
+      Strategy(PngCompressionStrategy::Default),
+      Filter(PngRowFilter::Adaptive),
+      ThreadPool(nullptr) {}
+
+    /// <summary>Provides settings that prefer writing speed over file size</summary>
+    /// <returns>Save options for writing PNG files as fast as possible</returns>
+    public: static PngSaveOptions Fast() {
+      PngSaveOptions options;
+      options.CompressionLevel = 1;
+      options.Filter = PngRowFilter::None;
+      return options;
+    }
+
+    /// <summary>Provides settings that prefer small files over writing speed</summary>
+    /// <returns>Save options for writing PNG files as small as possible</returns>
+    public: static PngSaveOptions Small() {
+      PngSaveOptions options;
+      options.CompressionLevel = 9;
+      options.Filter = PngRowFilter::Adaptive;
+      return options;
+    }
+
+    /// <summary>zlib compression level from 0 (store only) to 9 (best compression)</summary>
+    public: int CompressionLevel;
+
+    /// <summary>Strategy zlib will use to compress the filtered rows</summary>
+    public: PngCompressionStrategy Strategy;
+
+    /// <summary>Filter that will be applied to each row before compression</summary>
+    public: PngRowFilter Filter;
+
+    /// <summary>Thread pool on which large images are filtered and compressed</summary>
+    /// <remarks>
+    ///   Optional. If set, images of more than about a megabyte are split into strips
+    ///   of rows that are filtered and deflated in parallel, then stitched into a single
+    ///   valid PNG file. Files come out slightly larger than when written by libpng on
+    ///   a single thread. The thread pool is not owned by the save options.
+    /// </remarks>
+    public: Pixels::ThreadPool *ThreadPool;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How much the color information in a JPEG file is reduced</summary>
+  /// <remarks>
+  ///   The eye is less sensitive to color than to brightness, so JPEG can store the color
+  ///   channels at a lower resolution than the brightness channel. This makes compression
+  ///   faster and the files smaller.
+  /// </remarks>
+  enum class JpegChromaSubsampling {
+
+    /// <summary>Color is stored in full resolution (4:4:4)</summary>
+    None,
+    /// <summary>Color is stored in half the horizontal resolution (4:2:2)</summary>
+    Horizontal,
+    /// <summary>Color is stored in half the horizontal and vertical resolution (4:2:0)</summary>
+    HorizontalAndVertical
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how JPEG files are written</summary>
+  struct JpegSaveOptions {
+
+    /// <summary>Initializes new JPEG save options with balanced default settings</summary>
+    public: JpegSaveOptions() :
+      Quality(90),
+      ChromaSubsampling(JpegChromaSubsampling::HorizontalAndVertical),
+      OptimizeHuffmanTables(true),
+      Progressive(false) {}
+
+    /// <summary>Provides settings that prefer writing speed over file size</summary>
+    /// <returns>Save options for writing JPEG files as fast as possible</returns>
+    public: static JpegSaveOptions Fast() {
+      JpegSaveOptions options;
+      options.OptimizeHuffmanTables = false;
+      return options;
+    }
+
+    /// <summary>Provides settings that prefer small files over writing speed</summary>
+    /// <returns>Save options for writing JPEG files as small as possible</returns>
+    public: static JpegSaveOptions Small() {
+      JpegSaveOptions options;
+      options.OptimizeHuffmanTables = true;
+      options.Progressive = true;
+      return options;
+    }
+
+    /// <summary>Image quality from 1 (smallest file) to 100 (best quality)</summary>
+    public: int Quality;
+
+    /// <summary>Resolution at which the color channels will be stored</summary>
+    /// <remarks>Only used for color images, grayscale images have no color channels</remarks>
+    public: JpegChromaSubsampling ChromaSubsampling;
+
+    /// <summary>Whether huffman tables are calculated for each image</summary>
+    /// <remarks>
+    ///   Computing optimal huffman tables requires an additional pass over the image data,
+    ///   but usually makes the file a few percent smaller. Turn this off for speed.
+    /// </remarks>
+    public: bool OptimizeHuffmanTables;
+
+    /// <summary>Whether the image will be stored in multiple passes of increasing detail</summary>
+    /// <remarks>
+    ///   Progressive files can be displayed before they are fully downloaded and are often
+    ///   a bit smaller, but they take considerably longer to write and to read.
+    /// </remarks>
+    public: bool Progressive;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compression methods OpenEXR can use to store the pixels of an EXR file</summary>
+  enum class ExrCompression {
+
+    /// <summary>Pixels are stored uncompressed, fastest to write but huge</summary>
+    None,
+    /// <summary>Lossless deflate compression of blocks of 16 scanlines</summary>
+    Zip,
+    /// <summary>Lossless wavelet compression, usually best for grainy photographic images</summary>
+    Piz,
+    /// <summary>Lossy DCT-based compression of blocks of 32 scanlines</summary>
+    Dwaa,
+    /// <summary>Lossy DCT-based compression of blocks of 256 scanlines</summary>
+    Dwab
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how EXR files are written</summary>
+  struct ExrSaveOptions {
+
+    /// <summary>Initializes new EXR save options with lossless compression</summary>
+    public: ExrSaveOptions() :
+      Compression(ExrCompression::Zip),
+      DwaCompressionLevel(45.0f),
+      ThreadCount(-1) {}
+
+    /// <summary>Method that will be used to compress the pixels</summary>
+    public: ExrCompression Compression;
+
+    /// <summary>How strongly the lossy DWA compression methods will quantize</summary>
+    /// <remarks>
+    ///   Only used for <see cref="ExrCompression.Dwaa" /> and
+    ///   <see cref="ExrCompression.Dwab" />. Higher values produce smaller files with
+    ///   more artifacts, 45 is OpenEXR's default and visually lossless for most images.
+    /// </remarks>
+    public: float DwaCompressionLevel;
+
+    /// <summary>Number of worker threads in OpenEXR's global thread pool</summary>
+    /// <remarks>
+    ///   OpenEXR compresses blocks of scanlines in parallel on its own global thread pool.
+    ///   If this is zero or more, the thread pool will be resized to the specified number
+    ///   of threads before saving (zero compresses on the calling thread only), which
+    ///   affects all other users of OpenEXR in the process, too. A negative value leaves
+    ///   the thread pool the way it is.
+    /// </remarks>
+    public: int ThreadCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how WebP files are written</summary>
+  struct WebPSaveOptions {
+
+    /// <summary>Initializes new WebP save options with balanced default settings</summary>
+    public: WebPSaveOptions() :
+      Lossless(false),
+      Quality(80),
+      Method(4) {}
+
+    /// <summary>Provides settings that prefer writing speed over file size</summary>
+    /// <returns>Save options for writing WebP files as fast as possible</returns>
+    public: static WebPSaveOptions Fast() {
+      WebPSaveOptions options;
+      options.Method = 0;
+      return options;
+    }
+
+    /// <summary>Provides settings that prefer small files over writing speed</summary>
+    /// <returns>Save options for writing WebP files as small as possible</returns>
+    public: static WebPSaveOptions Small() {
+      WebPSaveOptions options;
+      options.Method = 6;
+      return options;
+    }
+
+    /// <summary>Whether the pixels will be stored without any loss of quality</summary>
+    /// <remarks>
+    ///   Lossless WebP files are usually a good deal smaller than PNG files of the same
+    ///   image. Lossy WebP files are much smaller still, but alter the image like JPEG does.
+    /// </remarks>
+    public: bool Lossless;
+
+    /// <summary>Image quality from 0 (smallest file) to 100 (best quality)</summary>
+    /// <remarks>Only used for lossy compression</remarks>
+    public: int Quality;
+
+    /// <summary>Effort spent to make the file smaller from 0 (fastest) to 6 (smallest)</summary>
+    /// <remarks>
+    ///   This is the most important setting for the time it takes to save an image.
+    ///   It applies to both lossy and lossless compression.
+    /// </remarks>
+    public: int Method;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings controlling how bitmaps are written by the codecs</summary>
+  /// <remarks>
+  ///   Each codec only looks at the settings for its own file format, so a single
+  ///   instance can be used no matter which format a bitmap ends up being saved in.
+  /// </remarks>
+  struct SaveOptions {
+
+    /// <summary>Settings used when a bitmap is saved as a PNG file</summary>
+    public: PngSaveOptions Png;
+
+    /// <summary>Settings used when a bitmap is saved as a JPEG file</summary>
+    public: JpegSaveOptions Jpeg;
+
+    /// <summary>Settings used when a bitmap is saved as an EXR file</summary>
+    public: ExrSaveOptions Exr;
+
+    /// <summary>Settings used when a bitmap is saved as a WebP file</summary>
+    public: WebPSaveOptions WebP;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_SAVEOPTIONS_H
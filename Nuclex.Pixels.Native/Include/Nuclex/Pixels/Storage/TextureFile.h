@@ -0,0 +1,136 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_TEXTUREFILE_H
+#define NUCLEX_PIXELS_STORAGE_TEXTUREFILE_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::unique_ptr
+#include <string> // for std::string
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Texture file (DDS or KTX2) whose mip levels are accessed in place</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Texture containers store their pixels exactly the way GPUs expect them, including
+  ///     block-compressed formats. Instead of loading the pixels into a <see cref="Bitmap" />,
+  ///     a texture file keeps the file mapped into memory and hands out the location of
+  ///     each mip level inside the mapping, so the pixels can be uploaded to the GPU
+  ///     straight from the file without being decoded or copied.
+  ///   </para>
+  ///   <para>
+  ///     The bitmap memory returned by <see cref="GetLevel" /> points into the file's
+  ///     contents and must only be read from. It stays valid until the texture file is
+  ///     destroyed. Only two-dimensional textures are supported, cube maps, volume
+  ///     textures and texture arrays are rejected.
+  ///   </para>
+  /// </remarks>
+  class TextureFile {
+
+    /// <summary>Maps a texture file into memory and locates its mip levels</summary>
+    /// <param name="path">Path of the DDS or KTX2 file that will be opened</param>
+    /// <returns>The texture file providing access to the mip levels</returns>
+    public: NUCLEX_PIXELS_API static TextureFile Open(const std::string &path);
+
+    /// <summary>Locates the mip levels in a texture file that has already been opened</summary>
+    /// <param name="file">DDS or KTX2 file the texture file will take ownership of</param>
+    /// <returns>The texture file providing access to the mip levels</returns>
+    /// <remarks>
+    ///   If the file can not provide its contents in memory (see
+    ///   <see cref="VirtualFile.TryGetContiguousSpan" />), it is read into memory once.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static TextureFile Open(
+      std::unique_ptr<const VirtualFile> &&file
+    );
+
+    /// <summary>Constructs a texture file by taking over an existing one</summary>
+    /// <param name="other">Texture file that will be taken over</param>
+    public: NUCLEX_PIXELS_API TextureFile(TextureFile &&other);
+
+    /// <summary>Frees all resources owned by the texture file</summary>
+    public: NUCLEX_PIXELS_API ~TextureFile();
+
+    /// <summary>Returns the width of the largest mip level in pixels</summary>
+    /// <returns>The width of the largest mip level in pixels</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetWidth() const;
+
+    /// <summary>Returns the height of the largest mip level in pixels</summary>
+    /// <returns>The height of the largest mip level in pixels</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetHeight() const;
+
+    /// <summary>Returns the pixel format all mip levels are stored in</summary>
+    /// <returns>The pixel format of the mip levels</returns>
+    public: NUCLEX_PIXELS_API PixelFormat GetPixelFormat() const;
+
+    /// <summary>Counts the mip levels stored in the file</summary>
+    /// <returns>The number of mip levels, at least one</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountLevels() const;
+
+    /// <summary>Provides access to the pixels of a mip level</summary>
+    /// <param name="levelIndex">Index of the mip level, zero being the largest</param>
+    /// <returns>The memory layout of the mip level inside the file's contents</returns>
+    /// <remarks>
+    ///   For block-compressed formats, the stride covers a single row of pixels, so
+    ///   a row of blocks is the stride times the block height, like in a
+    ///   <see cref="Bitmap" />.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API BitmapMemory GetLevel(std::size_t levelIndex) const;
+
+    /// <summary>Counts the bytes a mip level occupies in the file</summary>
+    /// <param name="levelIndex">Index of the mip level, zero being the largest</param>
+    /// <returns>The number of bytes starting at the mip level's first pixel</returns>
+    public: NUCLEX_PIXELS_API std::uint64_t CountLevelBytes(std::size_t levelIndex) const;
+
+    /// <summary>Takes over another texture file</summary>
+    /// <param name="other">Other texture file that will be taken over</param>
+    /// <returns>This texture file</returns>
+    public: NUCLEX_PIXELS_API TextureFile &operator =(TextureFile &&other);
+
+    /// <summary>Structure holding the file and the locations of its mip levels</summary>
+    private: struct Implementation;
+
+    /// <summary>Initializes a new texture file from its implementation</summary>
+    /// <param name="implementation">Implementation the texture file will take over</param>
+    private: explicit TextureFile(Implementation *implementation);
+
+    private: TextureFile(const TextureFile &) = delete;
+    private: TextureFile &operator =(const TextureFile &) = delete;
+
+    /// <summary>File contents and the locations of the mip levels</summary>
+    private: Implementation *implementation;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_TEXTUREFILE_H
@@ -25,6 +25,8 @@ License along with this library
 
 #include <string>
 #include <memory>
+#include <cstddef>
+#include <cstdint>
 
 namespace Nuclex { namespace Pixels { namespace Storage {
 
@@ -47,6 +49,54 @@ namespace Nuclex { namespace Pixels { namespace Storage {
       const std::string &path, bool promiseSequentialAccess = false
     );
 
+    /// <summary>Maps a real file stored in the OS' file system into memory for reading</summary>
+    /// <param name="path">Path of the file that will be mapped into memory</param>
+    /// <param name="promiseSequentialAccess">
+    ///   Whether you promise to read from the file sequentially only
+    /// </param>
+    /// <returns>The file at the specified path, mapped into memory in read-only mode</returns>
+    /// <remarks>
+    ///   Instead of reading the file through system calls, the whole file is mapped into
+    ///   the address space of the process and paged in by the OS as it is accessed.
+    ///   Mapped files support <see cref="TryGetContiguousSpan" />, allowing codecs to
+    ///   decode directly from the file's contents without copying them.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::unique_ptr<const VirtualFile>
+    OpenMemoryMappedFileForReading(
+      const std::string &path, bool promiseSequentialAccess = false
+    );
+
+    /// <summary>Provides a read-only file accessing a block of memory</summary>
+    /// <param name="contents">Memory holding the contents of the file</param>
+    /// <param name="length">Length of the file in bytes</param>
+    /// <returns>A file that reads from the specified memory</returns>
+    /// <remarks>
+    ///   The memory is not copied and has to stay valid until the returned file has
+    ///   been destroyed. Codecs decode directly from the memory, so if you already have
+    ///   an image file in a buffer (for example because you received it over the network),
+    ///   this is the fastest way to load it.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::unique_ptr<const VirtualFile> FromMemory(
+      const void *contents, std::size_t length
+    );
+
+    /// <summary>Wraps a file in a buffer that reads ahead on sequential reads</summary>
+    /// <param name="file">File that will be read from through the buffer</param>
+    /// <param name="readAheadByteCount">
+    ///   Number of bytes that will be read ahead at once, between 64 KiB and 1 MiB is
+    ///   a good choice for files on disk
+    /// </param>
+    /// <returns>A file that reads from the wrapped file through the buffer</returns>
+    /// <remarks>
+    ///   Useful when a file is read in many small pieces, which is what the image
+    ///   libraries do. Whenever a read continues where the previous one ended, a whole
+    ///   window of data is read from the wrapped file and subsequent reads are served
+    ///   from memory. Other reads go directly to the wrapped file.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static std::unique_ptr<const VirtualFile> AddReadAheadBuffer(
+      std::unique_ptr<const VirtualFile> file, std::size_t readAheadByteCount = 262144
+    );
+
     /// <summary>Opens a real file stored in the OS' file system for writing</summary>
     /// <param name="path">Path of the file that will be opened for writing</param>
     /// <param name="promiseSequentialAccess">
@@ -96,6 +146,49 @@ namespace Nuclex { namespace Pixels { namespace Storage {
       std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
     ) = 0;
 
+    /// <summary>Tries to provide direct access to a range of the file's contents</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes the range should cover</param>
+    /// <returns>
+    ///   The address of the first byte in the range or null if the file can not provide
+    ///   its contents without copying them
+    /// </returns>
+    /// <remarks>
+    ///   The returned memory stays valid until the file is destroyed or written to.
+    ///   Files which are not held in memory return null, in which case you have to
+    ///   fall back to <see cref="ReadAt" />. Requesting a range that extends beyond
+    ///   the end of the file also returns null.
+    /// </remarks>
+    public: virtual const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t start, std::size_t byteCount
+    ) const {
+      (void)start;
+      (void)byteCount;
+      return nullptr;
+    }
+
+    /// <summary>Tells the file that it will be read from start to end</summary>
+    /// <remarks>
+    ///   This is only a hint, allowing files on disk to let the OS read ahead more
+    ///   aggressively and drop pages behind the reader sooner. Files that have no use
+    ///   for it ignore it.
+    /// </remarks>
+    public: virtual void AdviseSequential() const {}
+
+    /// <summary>Asks the file to load a range of its contents in the background</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes the range covers</param>
+    /// <remarks>
+    ///   Returns right away. Files on disk have the OS read the range into its cache,
+    ///   so it can be read without waiting for the disk later, even after the file has
+    ///   been closed and opened again. This is only a hint and never fails, files that
+    ///   have no use for it ignore it.
+    /// </remarks>
+    public: virtual void Prefetch(std::uint64_t start, std::uint64_t byteCount) const {
+      (void)start;
+      (void)byteCount;
+    }
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,186 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_TEXTUREATLAS_H
+#define NUCLEX_PIXELS_TEXTUREATLAS_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Rectangle.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BitmapSerializer;
+  class VirtualFile;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs many small bitmaps into one large bitmap</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Places rectangles with a skyline packer: the atlas remembers the top edge of
+  ///     the occupied area as a list of horizontal segments and puts each new rectangle
+  ///     where its bottom edge ends up lowest. This is fast enough for thousands of
+  ///     sprites and, if the sprites are added from tallest to shortest, wastes little
+  ///     space in the atlas.
+  ///   </para>
+  ///   <para>
+  ///     Pixels are written straight into the atlas, either by blitting a bitmap into
+  ///     its slot (converting the pixel format if needed) or by letting the
+  ///     <see cref="Storage.BitmapSerializer" /> decode an image file into a view of
+  ///     the slot, so no intermediate bitmap is created per sprite. If dirty region
+  ///     tracking is enabled on the atlas bitmap, the slots written are marked dirty.
+  ///   </para>
+  ///   <para>
+  ///     Padding keeps sprites from bleeding into each other when the atlas is sampled
+  ///     with filtering. It is only inserted between sprites, not at the atlas borders.
+  ///   </para>
+  /// </remarks>
+  class TextureAtlas {
+
+    /// <summary>Initializes a new, empty texture atlas</summary>
+    /// <param name="width">Width of the atlas in pixels</param>
+    /// <param name="height">Height of the atlas in pixels</param>
+    /// <param name="pixelFormat">Pixel format of the atlas bitmap</param>
+    /// <param name="padding">Number of pixels left free between sprites</param>
+    public: NUCLEX_PIXELS_API TextureAtlas(
+      std::size_t width, std::size_t height, PixelFormat pixelFormat,
+      std::size_t padding = 0
+    );
+
+    /// <summary>Returns the width of the atlas</summary>
+    /// <returns>The width of the atlas in pixels</returns>
+    public: std::size_t GetWidth() const { return this->bitmap.GetWidth(); }
+
+    /// <summary>Returns the height of the atlas</summary>
+    /// <returns>The height of the atlas in pixels</returns>
+    public: std::size_t GetHeight() const { return this->bitmap.GetHeight(); }
+
+    /// <summary>Returns the number of pixels left free between sprites</summary>
+    /// <returns>The padding between sprites in pixels</returns>
+    public: std::size_t GetPadding() const { return this->padding; }
+
+    /// <summary>Accesses the bitmap holding the sprites</summary>
+    /// <returns>The atlas bitmap</returns>
+    public: const Bitmap &GetBitmap() const { return this->bitmap; }
+
+    /// <summary>Accesses the bitmap holding the sprites</summary>
+    /// <returns>The atlas bitmap</returns>
+    public: Bitmap &GetBitmap() { return this->bitmap; }
+
+    /// <summary>Counts the pixels occupied by sprites</summary>
+    /// <returns>The number of pixels in all slots reserved so far, without padding</returns>
+    public: std::size_t CountOccupiedPixels() const { return this->occupiedPixelCount; }
+
+    /// <summary>Reserves a slot for a sprite without writing any pixels</summary>
+    /// <param name="width">Width of the sprite in pixels</param>
+    /// <param name="height">Height of the sprite in pixels</param>
+    /// <param name="placement">Receives the area of the atlas reserved for the sprite</param>
+    /// <returns>True if the sprite fit, false if the atlas is too full</returns>
+    public: NUCLEX_PIXELS_API bool TryReserve(
+      std::size_t width, std::size_t height, Rectangle &placement
+    );
+
+    /// <summary>Provides a bitmap through which a slot's pixels can be written</summary>
+    /// <param name="placement">Area of the atlas that has been reserved</param>
+    /// <returns>A view into the atlas bitmap covering the slot</returns>
+    /// <remarks>
+    ///   Writes through the view are not seen by the atlas bitmap's dirty region
+    ///   tracking, mark the slot via <see cref="Bitmap.MarkDirty" /> if needed.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API Bitmap GetSlot(const Rectangle &placement);
+
+    /// <summary>Reserves a slot for a sprite and copies its pixels into the atlas</summary>
+    /// <param name="sprite">Bitmap memory holding the sprite's pixels</param>
+    /// <param name="placement">Receives the area of the atlas the sprite was placed in</param>
+    /// <returns>True if the sprite fit, false if the atlas is too full</returns>
+    public: NUCLEX_PIXELS_API bool TryAdd(const BitmapMemory &sprite, Rectangle &placement);
+
+    /// <summary>Reserves a slot for an image file and decodes the image into it</summary>
+    /// <param name="serializer">Bitmap serializer that will decode the image</param>
+    /// <param name="file">File holding the image</param>
+    /// <param name="extensionHint">
+    ///   Optional file extension to help detection (may speed things up)
+    /// </param>
+    /// <param name="placement">Receives the area of the atlas the image was placed in</param>
+    /// <returns>True if the image fit, false if the atlas is too full</returns>
+    /// <remarks>
+    ///   Only the image's header is read to find out how large a slot is needed. If the
+    ///   image does not fit, the file is not decoded.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API bool TryLoad(
+      const Storage::BitmapSerializer &serializer,
+      const Storage::VirtualFile &file, const std::string &extensionHint,
+      Rectangle &placement
+    );
+
+    /// <summary>Reserves a slot for an image file and decodes the image into it</summary>
+    /// <param name="serializer">Bitmap serializer that will decode the image</param>
+    /// <param name="path">Path of the image file</param>
+    /// <param name="placement">Receives the area of the atlas the image was placed in</param>
+    /// <returns>True if the image fit, false if the atlas is too full</returns>
+    public: NUCLEX_PIXELS_API bool TryLoad(
+      const Storage::BitmapSerializer &serializer, const std::string &path,
+      Rectangle &placement
+    );
+
+    /// <summary>Removes all sprites and clears the atlas bitmap</summary>
+    public: NUCLEX_PIXELS_API void Clear();
+
+    /// <summary>Horizontal segment of the top edge of the occupied area</summary>
+    private: struct SkylineSegment {
+
+      /// <summary>X coordinate at which the segment starts</summary>
+      public: std::size_t X;
+      /// <summary>Y coordinate at which free space begins above the segment</summary>
+      public: std::size_t Y;
+      /// <summary>Width of the segment in pixels</summary>
+      public: std::size_t Width;
+
+    };
+
+    /// <summary>Bitmap holding the sprites</summary>
+    private: Bitmap bitmap;
+    /// <summary>Number of pixels left free between sprites</summary>
+    private: std::size_t padding;
+    /// <summary>Number of pixels in all slots reserved so far</summary>
+    private: std::size_t occupiedPixelCount;
+    /// <summary>Top edge of the occupied area from left to right</summary>
+    private: std::vector<SkylineSegment> skyline;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_TEXTUREATLAS_H
@@ -0,0 +1,156 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_THREADPOOL_H
+#define NUCLEX_PIXELS_THREADPOOL_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class NumaBitmapAllocator;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of worker threads that process batches of tasks in parallel</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The thread pool is owned by whoever creates it, Nuclex.Pixels never creates
+  ///     threads on its own. Operations that can make use of multiple cores accept
+  ///     a reference to a thread pool, so you stay in control of how many threads
+  ///     are working on pixels and can share one thread pool between all of them.
+  ///   </para>
+  ///   <para>
+  ///     Work is submitted in batches via <see cref="ForEach" />, which blocks until
+  ///     all tasks in the batch have completed. The calling thread processes tasks
+  ///     alongside the worker threads. Batches submitted from different threads are
+  ///     processed one after another. Do not submit a batch from inside a task.
+  ///   </para>
+  ///   <para>
+  ///     On systems with multiple CPU sockets, the worker threads can be spread over
+  ///     the NUMA nodes. Each batch is then divided into contiguous parts, one per node,
+  ///     and threads work on their own node's part before helping out with the others.
+  ///     Bitmaps processed with <see cref="ForEachBandInParallel" /> thus have the same
+  ///     rows processed on the same node each time, and a <see cref="NumaBitmapAllocator" />
+  ///     can place those rows in that node's memory. The NUMA topology is looked up
+  ///     through Nuclex.Support, so this requires a build with NUCLEX_PIXELS_NUMA defined;
+  ///     other builds see every system as a single NUMA node.
+  ///   </para>
+  /// </remarks>
+  class ThreadPool {
+
+    /// <summary>Initializes a new thread pool</summary>
+    /// <param name="threadCount">
+    ///   Total number of threads that will process tasks, including the thread submitting
+    ///   a batch. Zero uses one thread per CPU core the system reports.
+    /// </param>
+    /// <param name="pinThreadsToNumaNodes">
+    ///   Whether to divide the threads into contiguous groups, one per NUMA node, and
+    ///   bind each worker thread to the cores of its node. The thread submitting a batch
+    ///   is counted towards the first node but not bound to it. Has no effect on systems
+    ///   with a single NUMA node.
+    /// </param>
+    public: NUCLEX_PIXELS_API explicit ThreadPool(
+      std::size_t threadCount = 0, bool pinThreadsToNumaNodes = false
+    );
+
+    /// <summary>Stops all worker threads and frees all resources</summary>
+    public: NUCLEX_PIXELS_API ~ThreadPool();
+
+    /// <summary>Counts the threads that will be processing a batch of tasks</summary>
+    /// <returns>The number of threads including the thread submitting a batch</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountThreads() const;
+
+    /// <summary>Counts the NUMA nodes the worker threads have been spread over</summary>
+    /// <returns>The number of NUMA nodes, 1 unless the threads are pinned to nodes</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountNumaNodes() const;
+
+    /// <summary>Runs a task for each index in the specified range in parallel</summary>
+    /// <typeparam name="TTask">Callable object that will be run for each index</typeparam>
+    /// <param name="taskCount">Number of times the task will be run</param>
+    /// <param name="task">Task that will be invoked with each index</param>
+    /// <remarks>
+    ///   <para>
+    ///     If any invocation of the task throws an exception, the remaining indices are
+    ///     skipped and the first exception is rethrown once all threads have stopped
+    ///     working on the batch.
+    ///   </para>
+    ///   <para>
+    ///     With the threads pinned to N NUMA nodes, the indices from
+    ///     taskCount * n / N up to taskCount * (n + 1) / N are preferably processed
+    ///     by the threads on node n.
+    ///   </para>
+    /// </remarks>
+    public: template<typename TTask>
+    void ForEach(std::size_t taskCount, TTask &&task) {
+      runTasks(taskCount, &invokeTask<typename std::remove_reference<TTask>::type>, &task);
+    }
+
+    /// <summary>Signature of a function that invokes a task with an index</summary>
+    /// <param name="task">Task that will be invoked</param>
+    /// <param name="taskIndex">Index the task will be invoked with</param>
+    private: typedef void TaskFunction(void *task, std::size_t taskIndex);
+
+    /// <summary>Invokes a callable object as task</summary>
+    /// <typeparam name="TTask">Type of callable object that will be invoked</typeparam>
+    /// <param name="task">Address of the callable object</param>
+    /// <param name="taskIndex">Index the task will be invoked with</param>
+    private: template<typename TTask>
+    static void invokeTask(void *task, std::size_t taskIndex) {
+      (*static_cast<TTask *>(task))(taskIndex);
+    }
+
+    /// <summary>Runs a batch of tasks on the thread pool and the calling thread</summary>
+    /// <param name="taskCount">Number of tasks in the batch</param>
+    /// <param name="function">Function that will invoke the task for each index</param>
+    /// <param name="task">Task that will be passed to the function</param>
+    private: NUCLEX_PIXELS_API void runTasks(
+      std::size_t taskCount, TaskFunction *function, void *task
+    );
+
+    /// <summary>Looks up the operating system's id of a NUMA node the pool uses</summary>
+    /// <param name="nodeIndex">Index of the node within the thread pool</param>
+    /// <returns>The id the operating system uses for the NUMA node</returns>
+    private: std::size_t getNumaNodeId(std::size_t nodeIndex) const;
+
+    private: ThreadPool(const ThreadPool &) = delete;
+    private: ThreadPool &operator =(const ThreadPool &) = delete;
+
+    /// <summary>Places bitmap memory on the nodes the pool's threads are pinned to</summary>
+    friend class NumaBitmapAllocator;
+
+    /// <summary>Structure holding the threads and synchronization primitives</summary>
+    private: struct Implementation;
+
+    /// <summary>Worker threads and the state of the current batch of tasks</summary>
+    private: Implementation *implementation;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_THREADPOOL_H
@@ -0,0 +1,123 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_TILEPYRAMID_H
+#define NUCLEX_PIXELS_TILEPYRAMID_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/RowStream.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives the tiles of an image pyramid as they are completed</summary>
+  /// <remarks>
+  ///   Implementations typically encode each tile via
+  ///   <see cref="Storage.BitmapSerializer.Save" /> into a file named after its level and
+  ///   position. Tiles are handed to the sink from multiple threads at the same time,
+  ///   so encoding happens in parallel and the sink has to be thread safe.
+  /// </remarks>
+  class TileSink {
+
+    /// <summary>Frees all resources owned by the tile sink</summary>
+    public: virtual ~TileSink() = default;
+
+    /// <summary>Accepts a completed tile</summary>
+    /// <param name="level">
+    ///   Level the tile belongs to, where level 0 is a single pixel and the highest level
+    ///   holds the image at its full resolution
+    /// </param>
+    /// <param name="tileX">Horizontal index of the tile within its level</param>
+    /// <param name="tileY">Vertical index of the tile within its level</param>
+    /// <param name="tile">
+    ///   Pixels of the tile. Tiles at the right and bottom borders of a level are smaller
+    ///   than the tile size. The pixels are only valid until the method returns.
+    /// </param>
+    public: virtual void WriteTile(
+      std::size_t level, std::size_t tileX, std::size_t tileY, const Bitmap &tile
+    ) = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Cuts huge images into tiles at decreasing resolutions for deep zooming</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Map viewers and deep zoom viewers display huge images by loading only the tiles
+  ///     visible at the current zoom level. This class produces those tiles in the layout
+  ///     used by Deep Zoom: each level is half the size (rounded up) of the level above it
+  ///     and level 0 is a single pixel. Tiles do not overlap.
+  ///   </para>
+  ///   <para>
+  ///     The image is consumed from a <see cref="RowSource" />, typically obtained via
+  ///     <see cref="Storage.BitmapSerializer.OpenRowSource" />, in a single pass. Each level
+  ///     only keeps one row of tiles in memory, which is handed to the
+  ///     <see cref="TileSink" /> on the thread pool once it is complete, and downsamples
+  ///     its rows into the next level as they arrive. Memory use depends on the width
+  ///     of the image, not its height: a 40'000 pixel wide R8-G8-B8-A8 image needs
+  ///     about 80 MiB with the default tile size.
+  ///   </para>
+  ///   <para>
+  ///     Each pixel of a level is the average of a 2x2 block of pixels in the level
+  ///     above it. Rows are downsampled in the row source's pixel format if its channels
+  ///     are all 8 bit unsigned integers and converted to R8-G8-B8-A8 otherwise.
+  ///   </para>
+  /// </remarks>
+  class TilePyramid {
+
+    /// <summary>Width and height of the tiles used unless told otherwise</summary>
+    public: static const std::size_t DefaultTileSize = 256;
+
+    /// <summary>Counts the levels of the image pyramid for an image</summary>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <returns>The number of levels from a single pixel to the full resolution</returns>
+    public: NUCLEX_PIXELS_API static std::size_t CountLevels(
+      std::size_t width, std::size_t height
+    );
+
+    /// <summary>Reads an image and writes its tiles at all levels into a tile sink</summary>
+    /// <param name="source">Row source providing the image at full resolution</param>
+    /// <param name="sink">Tile sink that will receive the tiles</param>
+    /// <param name="threadPool">Thread pool on which the tile sink will be invoked</param>
+    /// <param name="tileSize">Width and height of the tiles in pixels</param>
+    /// <remarks>
+    ///   If the tile sink throws, generation stops and the first exception is rethrown
+    ///   once all threads have finished.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API static void Generate(
+      std::unique_ptr<RowSource> &&source, TileSink &sink, ThreadPool &threadPool,
+      std::size_t tileSize = DefaultTileSize
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_TILEPYRAMID_H
@@ -0,0 +1,213 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_TILEDBITMAP_H
+#define NUCLEX_PIXELS_TILEDBITMAP_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+#include <string>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Width and height of the tiles a tiled bitmap uses unless told otherwise</summary>
+  /// <remarks>
+  ///   A 256x256 tile of 32 bit pixels takes 256 KiB, so a renderer working on one tile
+  ///   per thread keeps its pixels in the L2 cache.
+  /// </remarks>
+  const std::size_t DefaultTileSize = 256;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Bitmap that stores its pixels in square tiles allocated on demand</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A <see cref="Bitmap" /> needs a single memory block holding all of its pixels,
+  ///     which rules out images like a 100'000 x 100'000 pixel map. A tiled bitmap only
+  ///     keeps a table of its tiles and allocates each tile when it is first accessed.
+  ///     Tiles that were never accessed read as zero-filled pixels.
+  ///   </para>
+  ///   <para>
+  ///     Each tile is handed out as <see cref="BitmapMemory" />, so everything working on
+  ///     bitmap memory (the <see cref="PixelFormatConverter" />, the
+  ///     <see cref="BitmapResampler" />, codecs via <see cref="Bitmap.FromExistingMemory" />
+  ///     and so on) can work on a tile directly. Tiles along the right and bottom borders
+  ///     are clipped to the image.
+  ///   </para>
+  ///   <para>
+  ///     If the image doesn't fit in memory even when only the tiles that are used get
+  ///     allocated, the tiles can be stored in a scratch file that is mapped into memory.
+  ///     The file is created sparse, so only tiles that have been written take up disk
+  ///     space, and the OS pages tiles in and out as they are used. It is deleted when
+  ///     the tiled bitmap is destroyed.
+  ///   </para>
+  ///   <para>
+  ///     Different tiles can be accessed from different threads at the same time.
+  ///   </para>
+  /// </remarks>
+  class TiledBitmap {
+
+    /// <summary>Initializes a new tiled bitmap that keeps its tiles in memory</summary>
+    /// <param name="width">Width of the bitmap in pixels</param>
+    /// <param name="height">Height of the bitmap in pixels</param>
+    /// <param name="pixelFormat">Pixel format of the bitmap</param>
+    /// <param name="tileSize">Width and height of each tile in pixels</param>
+    /// <remarks>
+    ///   Tiles are obtained from the default <see cref="BitmapAllocator" />.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API TiledBitmap(
+      std::size_t width, std::size_t height, PixelFormat pixelFormat,
+      std::size_t tileSize = DefaultTileSize
+    );
+
+    /// <summary>Initializes a new tiled bitmap that keeps its tiles in a scratch file</summary>
+    /// <param name="width">Width of the bitmap in pixels</param>
+    /// <param name="height">Height of the bitmap in pixels</param>
+    /// <param name="pixelFormat">Pixel format of the bitmap</param>
+    /// <param name="scratchDirectory">
+    ///   Directory in which the scratch file will be created. If empty, the system's
+    ///   temporary directory is used.
+    /// </param>
+    /// <param name="tileSize">Width and height of each tile in pixels</param>
+    /// <remarks>
+    ///   The whole scratch file is mapped into the address space of the process, so on
+    ///   32 bit systems, this only works for images of up to around a gigabyte.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API TiledBitmap(
+      std::size_t width, std::size_t height, PixelFormat pixelFormat,
+      const std::string &scratchDirectory, std::size_t tileSize = DefaultTileSize
+    );
+
+    /// <summary>Constructs a tiled bitmap by taking over an existing one</summary>
+    /// <param name="other">Tiled bitmap that will be taken over</param>
+    public: NUCLEX_PIXELS_API TiledBitmap(TiledBitmap &&other);
+
+    /// <summary>Frees all tiles and deletes the scratch file, if any</summary>
+    public: NUCLEX_PIXELS_API ~TiledBitmap();
+
+    /// <summary>Returns the width of the bitmap in pixels</summary>
+    /// <returns>The width of the bitmap</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetWidth() const;
+
+    /// <summary>Returns the height of the bitmap in pixels</summary>
+    /// <returns>The height of the bitmap</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetHeight() const;
+
+    /// <summary>Returns the pixel format of the bitmap</summary>
+    /// <returns>The pixel format as which the bitmap's pixels are stored</returns>
+    public: NUCLEX_PIXELS_API PixelFormat GetPixelFormat() const;
+
+    /// <summary>Returns the width and height of the tiles</summary>
+    /// <returns>The width and height of each tile in pixels</returns>
+    public: NUCLEX_PIXELS_API std::size_t GetTileSize() const;
+
+    /// <summary>Counts the tiles in each row of tiles</summary>
+    /// <returns>The number of tiles needed to cover the width of the bitmap</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountHorizontalTiles() const;
+
+    /// <summary>Counts the tiles in each column of tiles</summary>
+    /// <returns>The number of tiles needed to cover the height of the bitmap</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountVerticalTiles() const;
+
+    /// <summary>Counts the tiles that have been allocated so far</summary>
+    /// <returns>The number of tiles that have been accessed and not released</returns>
+    public: NUCLEX_PIXELS_API std::size_t CountAllocatedTiles() const;
+
+    /// <summary>Checks whether a tile has been allocated</summary>
+    /// <param name="tileX">Horizontal index of the tile</param>
+    /// <param name="tileY">Vertical index of the tile</param>
+    /// <returns>True if the tile has been accessed and not released</returns>
+    public: NUCLEX_PIXELS_API bool IsTileAllocated(std::size_t tileX, std::size_t tileY) const;
+
+    /// <summary>Accesses the pixels of a tile, allocating it if necessary</summary>
+    /// <param name="tileX">Horizontal index of the tile</param>
+    /// <param name="tileY">Vertical index of the tile</param>
+    /// <returns>The memory holding the pixels of the tile</returns>
+    /// <remarks>
+    ///   The tile's memory stays at the same address until the tile is released
+    ///   or the tiled bitmap is destroyed.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API BitmapMemory AccessTile(std::size_t tileX, std::size_t tileY);
+
+    /// <summary>Frees the memory of a tile so that it reads as zero again</summary>
+    /// <param name="tileX">Horizontal index of the tile</param>
+    /// <param name="tileY">Vertical index of the tile</param>
+    /// <remarks>
+    ///   Useful to bound the working set when tiles are processed one after another,
+    ///   for example after a tile has been written into a file. Must not be called while
+    ///   another thread is accessing the same tile.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API void ReleaseTile(std::size_t tileX, std::size_t tileY);
+
+    /// <summary>Copies a region of the tiled bitmap into bitmap memory</summary>
+    /// <param name="x">X coordinate of the region's left border in the tiled bitmap</param>
+    /// <param name="y">Y coordinate of the region's upper border in the tiled bitmap</param>
+    /// <param name="target">
+    ///   Bitmap memory the region will be copied into. Its size decides the size of
+    ///   the region and its pixel format has to match the tiled bitmap's.
+    /// </param>
+    /// <remarks>
+    ///   The region can span any number of tiles. Tiles that have not been allocated
+    ///   are read as zeros without allocating them.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API void ReadRegion(
+      std::size_t x, std::size_t y, const BitmapMemory &target
+    ) const;
+
+    /// <summary>Copies bitmap memory into a region of the tiled bitmap</summary>
+    /// <param name="x">X coordinate of the region's left border in the tiled bitmap</param>
+    /// <param name="y">Y coordinate of the region's upper border in the tiled bitmap</param>
+    /// <param name="source">
+    ///   Bitmap memory holding the pixels that will be copied into the region. Its size
+    ///   decides the size of the region and its pixel format has to match the tiled
+    ///   bitmap's.
+    /// </param>
+    /// <remarks>
+    ///   The region can span any number of tiles, which will be allocated as needed.
+    /// </remarks>
+    public: NUCLEX_PIXELS_API void WriteRegion(
+      std::size_t x, std::size_t y, const BitmapMemory &source
+    );
+
+    /// <summary>Takes over another tiled bitmap</summary>
+    /// <param name="other">Other tiled bitmap that will be taken over</param>
+    /// <returns>This tiled bitmap</returns>
+    public: NUCLEX_PIXELS_API TiledBitmap &operator =(TiledBitmap &&other);
+
+    private: TiledBitmap(const TiledBitmap &) = delete;
+    private: TiledBitmap &operator =(const TiledBitmap &) = delete;
+
+    /// <summary>Structure holding the tile table and the tile storage</summary>
+    private: struct Implementation;
+
+    /// <summary>Tile table and storage of the tiles, null if taken over</summary>
+    private: Implementation *implementation;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_TILEDBITMAP_H
@@ -24,14 +24,35 @@ License along with this library
 #include "Nuclex/Pixels/Config.h"
 
 #include <cstdint>
+#include <cstring> // for std::memcpy()
 #include <limits>
 #include <type_traits>
 
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+
 namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+  /// <summary>Native 128 bit integer of GCC and clang</summary>
+  /// <remarks>
+  ///   Declared as an extension so -Wpedantic builds don't warn about the non-ISO type
+  /// </remarks>
+  __extension__ typedef unsigned __int128 NativeUInt128;
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>128 bit unsigned intgeer</summary>
+  /// <remarks>
+  ///   On compilers that provide a native 128 bit integer type (GCC and clang on 64 bit
+  ///   targets), the value is stored as such and all operations map directly onto it,
+  ///   letting the compiler use double-register shifts and SSE moves. Elsewhere, the value
+  ///   is emulated with two 64 bit halves laid out in the platform's byte order.
+  /// </remarks>
   class UInt128 {
 
     /// <summary>Initializes a new 128 bit unsigned integer</summary>
@@ -41,7 +62,9 @@ namespace Nuclex { namespace Pixels {
     ///   the variable is accessed.
     /// </remarks>
     public: constexpr NUCLEX_PIXELS_API UInt128() :
-#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      value(0) {}
+#elif defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
       leastSignificant(0),
       mostSignificant(0) {}
 #else
@@ -59,7 +82,9 @@ namespace Nuclex { namespace Pixels {
     public: constexpr NUCLEX_PIXELS_API explicit UInt128(
       std::uint64_t mostSignificant, std::uint64_t leastSignificant
     ) :
-#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      value((static_cast<NativeUInt128>(mostSignificant) << 64) | leastSignificant) {}
+#elif defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
       leastSignificant(leastSignificant),
       mostSignificant(mostSignificant) {}
 #else
@@ -70,7 +95,9 @@ namespace Nuclex { namespace Pixels {
     /// <summary>Initializes a new 128 bit unsigned integer from an 8 bit integer</summary>
     /// <param name="value">Value with which the 128 bit integer will be initialized</param>
     public: constexpr NUCLEX_PIXELS_API UInt128(std::uint8_t value) :
-#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      value(value) {}
+#elif defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
       leastSignificant(value),
       mostSignificant(0) {}
 #else
@@ -81,7 +108,9 @@ namespace Nuclex { namespace Pixels {
     /// <summary>Initializes a new 128 bit unsigned integer from a 16 bit integer</summary>
     /// <param name="value">Value with which the 128 bit integer will be initialized</param>
     public: constexpr NUCLEX_PIXELS_API UInt128(std::uint16_t value) :
-#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      value(value) {}
+#elif defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
       leastSignificant(value),
       mostSignificant(0) {}
 #else
@@ -92,7 +121,9 @@ namespace Nuclex { namespace Pixels {
     /// <summary>Initializes a new 128 bit unsigned integer from a 32 bit integer</summary>
     /// <param name="value">Value with which the 128 bit integer will be initialized</param>
     public: constexpr NUCLEX_PIXELS_API UInt128(std::uint32_t value) :
-#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      value(value) {}
+#elif defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
       leastSignificant(value),
       mostSignificant(0) {}
 #else
@@ -103,7 +134,9 @@ namespace Nuclex { namespace Pixels {
     /// <summary>Initializes a new 128 bit unsigned integer from a 64 bit integer</summary>
     /// <param name="value">Value with which the 128 bit integer will be initialized</param>
     public: constexpr NUCLEX_PIXELS_API UInt128(std::uint64_t value) :
-#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      value(value) {}
+#elif defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
       leastSignificant(value),
       mostSignificant(0) {}
 #else
@@ -114,140 +147,121 @@ namespace Nuclex { namespace Pixels {
 #if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
     /// <summary>Initializes a new 128 bit unsigned integer from a 128 bit integer</summary>
     /// <param name="value">Value with which the 128 bit integer will be initialized</param>
-    public: constexpr NUCLEX_PIXELS_API UInt128(unsigned __int128 value) :
-#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
-      leastSignificant(static_cast<std::uint64_t>(value)),
-      mostSignificant(static_cast<std::uint64_t>(value >> 64)) {}
-#else
-      mostSignificant(static_cast<std::uint64_t>(value >> 64)),
-      leastSignificant(static_cast<std::uint64_t>(value)) {}
-#endif
+    public: constexpr NUCLEX_PIXELS_API UInt128(NativeUInt128 value) :
+      value(value) {}
+
+    /// <summary>Returns the value as the compiler's native 128 bit integer</summary>
+    /// <returns>The native 128 bit integer holding the same value</returns>
+    public: constexpr NUCLEX_PIXELS_API explicit operator NativeUInt128() const {
+      return this->value;
+    }
 #endif // defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
 
     /// <summary>Returns only the lower 8 bits of the 128 bit integer</summary>
     /// <returns>The lower 8 bits of the 128 bit integer</returns>
-    public: NUCLEX_PIXELS_API explicit operator std::uint8_t() const {
-      return static_cast<std::uint8_t>(this->leastSignificant);
+    public: constexpr NUCLEX_PIXELS_API explicit operator std::uint8_t() const {
+      return static_cast<std::uint8_t>(lower64());
     }
 
     /// <summary>Returns only the lower 16 bits of the 128 bit integer</summary>
     /// <returns>The lower 16 bits of the 128 bit integer</returns>
-    public: NUCLEX_PIXELS_API explicit operator std::uint16_t() const {
-      return static_cast<std::uint16_t>(this->leastSignificant);
+    public: constexpr NUCLEX_PIXELS_API explicit operator std::uint16_t() const {
+      return static_cast<std::uint16_t>(lower64());
     }
 
     /// <summary>Returns only the lower 32 bits of the 128 bit integer</summary>
     /// <returns>The lower 32 bits of the 128 bit integer</returns>
-    public: NUCLEX_PIXELS_API explicit operator std::uint32_t() const {
-      return static_cast<std::uint32_t>(this->leastSignificant);
+    public: constexpr NUCLEX_PIXELS_API explicit operator std::uint32_t() const {
+      return static_cast<std::uint32_t>(lower64());
     }
 
     /// <summary>Returns only the lower 64 bits of the 128 bit integer</summary>
     /// <returns>The lower 64 bits of the 128 bit integer</returns>
-    public: NUCLEX_PIXELS_API explicit operator std::uint64_t() const {
-      return this->leastSignificant;
+    public: constexpr NUCLEX_PIXELS_API explicit operator std::uint64_t() const {
+      return lower64();
     }
 
     /// <summary>Initializes the 128 bit integer from an 8 bit integer</summary>
     /// <param name="value">8 bit integer the 128 integer will be initialized from</parma>
     /// <returns>The 128 bit integer</returns>
     public: NUCLEX_PIXELS_API UInt128 &operator =(std::uint8_t value) {
-      this->mostSignificant = 0;
-      this->leastSignificant = value;
-      return *this;
+      return operator =(static_cast<std::uint64_t>(value));
     }
 
     /// <summary>Initializes the 128 bit integer from a 16 bit integer</summary>
     /// <param name="value">16 bit integer the 128 integer will be initialized from</parma>
     /// <returns>The 128 bit integer</returns>
     public: NUCLEX_PIXELS_API UInt128 &operator =(std::uint16_t value) {
-      this->mostSignificant = 0;
-      this->leastSignificant = value;
-      return *this;
+      return operator =(static_cast<std::uint64_t>(value));
     }
 
     /// <summary>Initializes the 128 bit integer from a 32 bit integer</summary>
     /// <param name="value">32 bit integer the 128 integer will be initialized from</parma>
     /// <returns>The 128 bit integer</returns>
     public: NUCLEX_PIXELS_API UInt128 &operator =(std::uint32_t value) {
-      this->mostSignificant = 0;
-      this->leastSignificant = value;
-      return *this;
+      return operator =(static_cast<std::uint64_t>(value));
     }
 
     /// <summary>Initializes the 128 bit integer from a 64 bit integer</summary>
     /// <param name="value">64 bit integer the 128 integer will be initialized from</parma>
     /// <returns>The 128 bit integer</returns>
     public: NUCLEX_PIXELS_API UInt128 &operator =(std::uint64_t value) {
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      this->value = value;
+#else
       this->mostSignificant = 0;
       this->leastSignificant = value;
+#endif
       return *this;
     }
 
     /// <summary>Checks whether another 128 bit integer is equal to this one</summary>
     /// <param name="other">Other 128 bit integer that will be compared</param>
     /// <returns>True if the other 128 bit integer has the same value as this</returns>
-    public: NUCLEX_PIXELS_API bool operator ==(const UInt128 &other) const {
+    public: constexpr NUCLEX_PIXELS_API bool operator ==(const UInt128 &other) const {
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      return (this->value == other.value);
+#else
       return (
         (this->leastSignificant == other.leastSignificant) &&
         (this->mostSignificant == other.mostSignificant)
       );
+#endif
     }
 
     /// <summary>Checks whether another 128 bit integer is different from this one</summary>
     /// <param name="other">Other 128 bit integer that will be compared</param>
     /// <returns>True if the other 128 bit integer has a different value to this</returns>
-    public: NUCLEX_PIXELS_API bool operator !=(const UInt128 &other) const {
-      return (
-        (this->leastSignificant != other.leastSignificant) ||
-        (this->mostSignificant != other.mostSignificant)
-      );
+    public: constexpr NUCLEX_PIXELS_API bool operator !=(const UInt128 &other) const {
+      return !(*this == other);
     }
 
     /// <summary>Returns the integer bit-shifted to the right</summary>
     /// <param name="bitOffset">Number of bits the integer will be shifted</param>
     /// <returns>The bit-shifted copy of the integer</summary>
     public: NUCLEX_PIXELS_API UInt128 operator <<(int bitOffset) const {
-      if(bitOffset == 0) { // Using <64 case would result in undefined behavior
-        return *this;
-      } else if(bitOffset < 64) {
-        UInt128 shifted;
-        shifted.mostSignificant = (this->mostSignificant << bitOffset);
-        shifted.mostSignificant |= (this->leastSignificant >> (64 - bitOffset));
-        shifted.leastSignificant = this->leastSignificant << bitOffset;
-        return shifted;
-      } else {
-        UInt128 shifted;
-        shifted.mostSignificant = (this->leastSignificant << (bitOffset - 64));
-        shifted.leastSignificant = 0;
-        return shifted;
-      }
+      UInt128 shifted(*this);
+      shifted <<= bitOffset;
+      return shifted;
     }
 
     /// <summary>Returns the integer bit-shifted to the left</summary>
     /// <param name="bitOffset">Number of bits the integer will be shifted</param>
     /// <returns>The bit-shifted copy of the integer</summary>
     public: NUCLEX_PIXELS_API UInt128 operator >>(int bitOffset) const {
-      if(bitOffset == 0) { // Using <64 case would result in undefined behavior
-        return *this;
-      } else if(bitOffset < 64) {
-        UInt128 shifted;
-        shifted.leastSignificant = (this->leastSignificant >> bitOffset);
-        shifted.leastSignificant |= (this->mostSignificant << (64 - bitOffset));
-        shifted.mostSignificant = this->mostSignificant >> bitOffset;
-        return shifted;
-      } else {
-        UInt128 shifted;
-        shifted.leastSignificant = (this->mostSignificant >> (bitOffset - 64));
-        shifted.mostSignificant = 0;
-        return shifted;
-      }
+      UInt128 shifted(*this);
+      shifted >>= bitOffset;
+      return shifted;
     }
 
     /// <summary>Bit shifts the integer to the left</summary>
     /// <param name="bitOffset">Number of bits the integer will be shifted</param>
     /// <returns>The bit-shifted integer</summary>
     public: NUCLEX_PIXELS_API UInt128 &operator <<=(int bitOffset) {
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      this->value <<= bitOffset;
+      return *this;
+#else
       if(bitOffset == 0) { // Can't use generic method because shift by 64 is undefined
         return *this;
       } else if(bitOffset < 64) {
@@ -260,12 +274,17 @@ namespace Nuclex { namespace Pixels {
         this->leastSignificant = 0;
         return *this;
       }
+#endif
     }
 
     /// <summary>Bit shifts the integer to the right</summary>
     /// <param name="bitOffset">Number of bits the integer will be shifted</param>
     /// <returns>The bit-shifted integer</summary>
     public: NUCLEX_PIXELS_API UInt128 &operator >>=(int bitOffset) {
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      this->value >>= bitOffset;
+      return *this;
+#else
       if(bitOffset == 0) {
         return *this; // Can't use generic method because shift by 64 is undefined
       } else if(bitOffset < 64) {
@@ -278,15 +297,15 @@ namespace Nuclex { namespace Pixels {
         this->mostSignificant = 0;
         return *this;
       }
+#endif
     }
 
     /// <summary>Returns the integer ORed with another integer</summary>
     /// <param name="other">Other integer that will be ORed with this one</param>
     /// <returns>The ORed copy of the integer</summary>
     public: NUCLEX_PIXELS_API UInt128 operator |(const UInt128 &other) const {
-      UInt128 combined;
-      combined.mostSignificant = this->mostSignificant | other.mostSignificant;
-      combined.leastSignificant = this->leastSignificant | other.leastSignificant;
+      UInt128 combined(*this);
+      combined |= other;
       return combined;
     }
 
@@ -294,9 +313,8 @@ namespace Nuclex { namespace Pixels {
     /// <param name="other">Other integer that will be ANDed with this one</param>
     /// <returns>The ANDed copy of the integer</summary>
     public: NUCLEX_PIXELS_API UInt128 operator &(const UInt128 &other) const {
-      UInt128 combined;
-      combined.mostSignificant = this->mostSignificant & other.mostSignificant;
-      combined.leastSignificant = this->leastSignificant & other.leastSignificant;
+      UInt128 combined(*this);
+      combined &= other;
       return combined;
     }
 
@@ -304,8 +322,12 @@ namespace Nuclex { namespace Pixels {
     /// <param name="other">Other integer that will be ORed with this one</param>
     /// <returns>The ORed copy of the integer</summary>
     public: NUCLEX_PIXELS_API UInt128 &operator |=(const UInt128 &other) {
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      this->value |= other.value;
+#else
       this->mostSignificant |= other.mostSignificant;
       this->leastSignificant |= other.leastSignificant;
+#endif
       return *this;
     }
 
@@ -313,11 +335,38 @@ namespace Nuclex { namespace Pixels {
     /// <param name="other">Other integer that will be ANDed with this one</param>
     /// <returns>The ANDed copy of the integer</summary>
     public: NUCLEX_PIXELS_API UInt128 &operator &=(const UInt128 &other) {
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      this->value &= other.value;
+#else
       this->mostSignificant &= other.mostSignificant;
       this->leastSignificant &= other.leastSignificant;
+#endif
       return *this;
     }
 
+    /// <summary>Extracts a group of bits, such as a pixel's color channel</summary>
+    /// <typeparam name="LowestBitIndex">Index of the lowest bit that will be extracted</typeparam>
+    /// <typeparam name="BitCount">Number of bits that will be extracted, up to 64</typeparam>
+    /// <returns>The extracted bits, moved down to start at bit 0</returns>
+    /// <remarks>
+    ///   Lets 128 bit pixel formats read a channel without materializing a shifted 128 bit
+    ///   copy. Fields that sit entirely in one 64 bit half become a single shift and mask.
+    /// </remarks>
+    public: template<int LowestBitIndex, int BitCount>
+    NUCLEX_PIXELS_API constexpr std::uint64_t ExtractBits() const {
+      static_assert(
+        (LowestBitIndex >= 0) && (BitCount > 0) && (BitCount <= 64) &&
+        (LowestBitIndex + BitCount <= 128),
+        u8"Extracted bits must fit into 64 bits and lie within the 128 bit integer"
+      );
+      return (
+        static_cast<std::uint64_t>(BitShift<LowestBitIndex>(*this)) &
+        (std::uint64_t(-1) >> (64 - BitCount))
+      );
+    }
+
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+
     /// <summary>Bit-shifts the value by the specified number of bits</summary>
     /// <typeparam name="ShiftOffset">Number of bits the value will be shifted</typeparam>
     /// <returns>The bit-shifted 128 bit integer</returns>
@@ -330,10 +379,52 @@ namespace Nuclex { namespace Pixels {
     >
     NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
       (void)integer;
-      UInt128 shifted;
-      shifted.mostSignificant = 0;
-      shifted.leastSignificant = 0;
-      return shifted;
+      return UInt128();
+    }
+
+    /// <summary>Bit-shifts the value by the specified number of bits</summary>
+    /// <typeparam name="ShiftOffset">Number of bits the value will be shifted</typeparam>
+    /// <returns>The bit-shifted 128 bit integer</returns>
+    /// <remarks>
+    ///   Specialization for shifts to the left
+    /// </remarks>
+    public: template<
+      int ShiftOffset,
+      typename std::enable_if_t<(ShiftOffset > -128) && (ShiftOffset < 0)> * = nullptr
+    >
+    NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
+      return UInt128(integer.value << (-ShiftOffset));
+    }
+
+    /// <summary>Bit-shifts the value by the specified number of bits</summary>
+    /// <typeparam name="ShiftOffset">Number of bits the value will be shifted</typeparam>
+    /// <returns>The bit-shifted 128 bit integer</returns>
+    /// <remarks>
+    ///   Specialization for shifts to the right
+    /// </remarks>
+    public: template<
+      int ShiftOffset,
+      typename std::enable_if_t<(ShiftOffset >= 0) && (ShiftOffset < 128)> * = nullptr
+    >
+    NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
+      return UInt128(integer.value >> ShiftOffset);
+    }
+
+#else // defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+
+    /// <summary>Bit-shifts the value by the specified number of bits</summary>
+    /// <typeparam name="ShiftOffset">Number of bits the value will be shifted</typeparam>
+    /// <returns>The bit-shifted 128 bit integer</returns>
+    /// <remarks>
+    ///   Specialization for shifts that result in shifting all bits away
+    /// </remarks>
+    public: template<
+      int ShiftOffset,
+      typename std::enable_if_t<(ShiftOffset <= -128) || (ShiftOffset >= 128)> * = nullptr
+    >
+    NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
+      (void)integer;
+      return UInt128();
     }
 
     /// <summary>Bit-shifts the value by the specified number of bits</summary>
@@ -347,10 +438,7 @@ namespace Nuclex { namespace Pixels {
       typename std::enable_if_t<(ShiftOffset > -128) && (ShiftOffset < -64)> * = nullptr
     >
     NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
-      UInt128 shifted;
-      shifted.mostSignificant = (integer.leastSignificant << (-64 - ShiftOffset));
-      shifted.leastSignificant = 0;
-      return shifted;
+      return UInt128(integer.leastSignificant << (-64 - ShiftOffset), 0);
     }
 
     /// <summary>Bit-shifts the value by the specified number of bits</summary>
@@ -364,10 +452,7 @@ namespace Nuclex { namespace Pixels {
       typename std::enable_if_t<(ShiftOffset == -64)> * = nullptr
     >
     NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
-      UInt128 shifted;
-      shifted.mostSignificant = integer.leastSignificant;
-      shifted.leastSignificant = 0;
-      return shifted;
+      return UInt128(integer.leastSignificant, 0);
     }
 
     /// <summary>Bit-shifts the value by the specified number of bits</summary>
@@ -380,12 +465,12 @@ namespace Nuclex { namespace Pixels {
       int ShiftOffset,
       typename std::enable_if_t<((ShiftOffset > -64) && (ShiftOffset < 0))> * = nullptr
     >
-    NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) { // TODO: Unfinished
-      UInt128 shifted;
-      shifted.mostSignificant = (integer.mostSignificant << (-ShiftOffset));
-      shifted.mostSignificant |= (integer.leastSignificant >> (64 + ShiftOffset));
-      shifted.leastSignificant = integer.leastSignificant << (-ShiftOffset);
-      return shifted;
+    NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
+      return UInt128(
+        (integer.mostSignificant << (-ShiftOffset)) |
+        (integer.leastSignificant >> (64 + ShiftOffset)),
+        integer.leastSignificant << (-ShiftOffset)
+      );
     }
 
     /// <summary>Bit-shifts the value by the specified number of bits</summary>
@@ -411,11 +496,11 @@ namespace Nuclex { namespace Pixels {
       typename std::enable_if_t<((ShiftOffset > 0) && (ShiftOffset < 64))> * = nullptr
     >
     NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
-      UInt128 shifted;
-      shifted.leastSignificant = (integer.leastSignificant >> ShiftOffset);
-      shifted.leastSignificant |= (integer.mostSignificant << (64 - ShiftOffset));
-      shifted.mostSignificant = integer.mostSignificant >> ShiftOffset;
-      return shifted;
+      return UInt128(
+        integer.mostSignificant >> ShiftOffset,
+        (integer.leastSignificant >> ShiftOffset) |
+        (integer.mostSignificant << (64 - ShiftOffset))
+      );
     }
 
     /// <summary>Bit-shifts the value by the specified number of bits</summary>
@@ -429,10 +514,7 @@ namespace Nuclex { namespace Pixels {
       typename std::enable_if_t<(ShiftOffset == 64)> * = nullptr
     >
     NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
-      UInt128 shifted;
-      shifted.mostSignificant = 0;
-      shifted.leastSignificant = integer.mostSignificant;
-      return shifted;
+      return UInt128(0, integer.mostSignificant);
     }
 
     /// <summary>Bit-shifts the value by the specified number of bits</summary>
@@ -446,13 +528,25 @@ namespace Nuclex { namespace Pixels {
       typename std::enable_if_t<(ShiftOffset > 64) && (ShiftOffset < 128)> * = nullptr
     >
     NUCLEX_PIXELS_API static constexpr UInt128 BitShift(UInt128 integer) {
-      UInt128 shifted;
-      shifted.mostSignificant = 0;
-      shifted.leastSignificant = (integer.mostSignificant >> (ShiftOffset - 64));
-      return shifted;
+      return UInt128(0, integer.mostSignificant >> (ShiftOffset - 64));
+    }
+
+#endif // defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+
+    /// <summary>Returns the lower 64 bits of the 128 bit integer</summary>
+    /// <returns>The lower 64 bits of the integer</returns>
+    private: constexpr std::uint64_t lower64() const {
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+      return static_cast<std::uint64_t>(this->value);
+#else
+      return this->leastSignificant;
+#endif
     }
 
-#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
+    /// <summary>Stores the value as the compiler's native 128 bit integer</summary>
+    private: NativeUInt128 value;
+#elif defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
     /// <summary>Stores the least signifcant 64 bits of the 128 bit integer</summary>
     private: std::uint64_t leastSignificant;
     /// <summary>Stores the most signifcant 64 bits of the 128 bit integer</summary>
@@ -467,65 +561,69 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
-#if defined(NUCLEX_PIXELS_HAVE_BUILTIN_INT128)
-
   /// <summary>Alias for the best 128 bit integer implementation to use</summary>
-  typedef unsigned __int128 uint128_t;
+  typedef UInt128 uint128_t;
+
+  // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Shifts the specified 128 bit integer bitwise to the left</summary>
+  /// <summary>Shifts the specified 128 bit integer bitwise</summary>
   /// <typeparam name="ShiftOffset">Number of bits the integer will be shifted</typeparam>
   /// <returns>The bit-shifted 128 bit integer</returns>
-  /// <remarks>
-  ///   Specialization for shifts that clear out all the bits
-  /// </remarks>
-  public: template<
-    int ShiftOffset,
-    typename std::enable_if_t<(ShiftOffset <= -128) || (ShiftOffset >= 128)> * = nullptr
-  >
+  template<int ShiftOffset>
   NUCLEX_PIXELS_API inline constexpr uint128_t BitShift(uint128_t integer) {
-    (void)uint128_t;
-    return 0;
+    return uint128_t::BitShift<ShiftOffset>(integer);
   }
 
-  /// <summary>Shifts the specified 128 bit integer bitwise to the left</summary>
-  /// <typeparam name="ShiftOffset">Number of bits the integer will be shifted</typeparam>
-  /// <returns>The bit-shifted 128 bit integer</returns>
-  public: template<
-    int ShiftOffset,
-    typename std::enable_if_t<(ShiftOffset > -128) && (ShiftOffset < 0)> * = nullptr
-  >
-  NUCLEX_PIXELS_API inline constexpr uint128_t BitShift(uint128_t integer) {
-    return integer << (-ShiftOffset);
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 128 bit integer from memory that may be unaligned</summary>
+  /// <param name="address">Address from which the integer will be read</param>
+  /// <returns>The 128 bit integer stored at the specified address</returns>
+  /// <remarks>
+  ///   The integer is read in the platform's native byte order, just like a 128 bit pixel
+  ///   would be. The memcpy() is turned into a single unaligned 16 byte load.
+  /// </remarks>
+  NUCLEX_PIXELS_API inline uint128_t LoadUInt128(const void *address) {
+    uint128_t integer;
+    std::memcpy(&integer, address, sizeof(integer));
+    return integer;
   }
 
-  /// <summary>Shifts the specified 128 bit integer bitwise to the right</summary>
-  /// <typeparam name="ShiftOffset">Number of bits the integer will be shifted</typeparam>
-  /// <returns>The bit-shifted 128 bit integer</returns>
-  public: template<
-    int ShiftOffset,
-    typename std::enable_if_t<(ShiftOffset >= 0) && (ShiftOffset < 128)> * = nullptr
-  >
-  NUCLEX_PIXELS_API inline constexpr uint128_t BitShift(uint128_t integer) {
-    return integer >> ShiftOffset;
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 128 bit integer into memory that may be unaligned</summary>
+  /// <param name="address">Address at which the integer will be stored</param>
+  /// <param name="integer">128 bit integer that will be stored</param>
+  NUCLEX_PIXELS_API inline void StoreUInt128(void *address, const uint128_t &integer) {
+    std::memcpy(address, &integer, sizeof(integer));
   }
 
-#else
+  // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Alias for the best 128 bit integer implementation to use</summary>
-  typedef UInt128 uint128_t;
+#if defined(NUCLEX_PIXELS_HAVE_SSE2) && defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
 
-  /// <summary>Shifts the specified 128 bit integer bitwise</summary>
-  /// <typeparam name="ShiftOffset">Number of bits the integer will be shifted</typeparam>
-  /// <returns>The bit-shifted 128 bit integer</returns>
-  template<int ShiftOffset>
-  NUCLEX_PIXELS_API inline constexpr uint128_t BitShift(uint128_t integer) {
-    return uint128_t::BitShift<ShiftOffset>(integer);
+  /// <summary>Moves a 128 bit integer into an SSE2 register</summary>
+  /// <param name="integer">128 bit integer that will be moved into the register</param>
+  /// <returns>An SSE2 register holding the 128 bit integer</returns>
+  NUCLEX_PIXELS_API inline __m128i ToM128i(const uint128_t &integer) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(&integer));
   }
 
-#endif
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Moves the contents of an SSE2 register into a 128 bit integer</summary>
+  /// <param name="vector">SSE2 register whose contents will be moved</param>
+  /// <returns>A 128 bit integer holding the register's contents</returns>
+  NUCLEX_PIXELS_API inline uint128_t FromM128i(__m128i vector) {
+    uint128_t integer;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&integer), vector);
+    return integer;
+  }
 
   // ------------------------------------------------------------------------------------------- //
 
+#endif // defined(NUCLEX_PIXELS_HAVE_SSE2) && defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+
 }} // namespace Nuclex::Pixels
 
 namespace std {
@@ -0,0 +1,590 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/AlphaCompositor.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+
+#include <cstdint>
+#include <stdexcept> // for std::runtime_error
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Function that premultiplies or unpremultiplies a row of pixels</summary>
+  /// <param name="pixels">Address of the first pixel in the row</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  typedef void ModifyRowFunction(void *pixels, std::size_t pixelCount);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Function that composites a row of pixels over another row</summary>
+  /// <param name="sourcePixels">Address of the first pixel that will be drawn</param>
+  /// <param name="targetPixels">Address of the first pixel that will be drawn onto</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  typedef void CompositeRowFunction(
+    const void *sourcePixels, void *targetPixels, std::size_t pixelCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies two normalized bytes with exact rounding</summary>
+  /// <param name="first">First byte that will be multiplied</param>
+  /// <param name="second">Second byte that will be multiplied</param>
+  /// <returns>The product of both bytes, equal to round(first * second / 255)</returns>
+  inline std::uint8_t multiplyNormalized(std::uint32_t first, std::uint32_t second) {
+    std::uint32_t product = first * second + 128;
+    return static_cast<std::uint8_t>((product + (product >> 8)) >> 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+  /// <summary>Divides the 16 bit products of two normalized bytes by 255</summary>
+  /// <param name="products">Eight products of two bytes each</param>
+  /// <returns>The products divided by 255 and rounded to the nearest integer</returns>
+  inline __m128i divideBy255(__m128i products) {
+    products = _mm_add_epi16(products, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(products, _mm_srli_epi16(products, 8)), 8);
+  }
+
+  /// <summary>Copies the alpha channel of two pixels into all of their channels</summary>
+  /// <param name="pixels">Two pixels with 16 bits per channel</param>
+  /// <returns>Two pixels where each channel holds the pixel's alpha value</returns>
+  inline __m128i broadcastAlpha(__m128i pixels) {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+  /// <summary>Divides the 16 bit products of two normalized bytes by 255</summary>
+  /// <param name="products">Eight products of two bytes each</param>
+  /// <returns>The products divided by 255 and rounded to the nearest integer</returns>
+  inline uint8x8_t divideBy255(uint16x8_t products) {
+    return vrshrn_n_u16(vrsraq_n_u16(products, products, 8), 8);
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fixed point reciprocals used to divide color channels by alpha</summary>
+  struct AlphaReciprocals {
+
+    /// <summary>Calculates the reciprocals for all possible alpha values</summary>
+    /// <remarks>
+    ///   Each reciprocal is 255 / alpha with 24 fractional bits, rounded up. The error
+    ///   this introduces is far smaller than the distance of any possible quotient to
+    ///   a rounding boundary, so the results are identical to a real division.
+    /// </remarks>
+    public: AlphaReciprocals() {
+      this->Values[0] = 0;
+      for(std::uint32_t alpha = 1; alpha < 256; ++alpha) {
+        this->Values[alpha] = static_cast<std::uint32_t>(
+          ((255ULL << 24) + alpha - 1) / alpha
+        );
+      }
+    }
+
+    /// <summary>Reciprocal of each alpha value times 255 in 8.24 fixed point</summary>
+    public: std::uint32_t Values[256];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the fixed point reciprocals for all alpha values</summary>
+  /// <returns>The fixed point reciprocals, calculated on first use</returns>
+  const AlphaReciprocals &getAlphaReciprocals() {
+    static const AlphaReciprocals reciprocals;
+    return reciprocals;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Premultiplies a row of pixels with 8 bit channels and alpha last</summary>
+  /// <param name="pixels">Address of the first pixel in the row</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  void premultiplyBytes(void *pixels, std::size_t pixelCount) {
+    std::uint8_t *bytes = static_cast<std::uint8_t *>(pixels);
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i alphaFactors = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+      while(pixelCount >= 4) {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+        __m128i low = _mm_unpacklo_epi8(packed, zero);
+        __m128i high = _mm_unpackhi_epi8(packed, zero);
+
+        // Alpha is multiplied by 255, so it stays unchanged
+        __m128i lowFactors = _mm_or_si128(broadcastAlpha(low), alphaFactors);
+        __m128i highFactors = _mm_or_si128(broadcastAlpha(high), alphaFactors);
+        low = divideBy255(_mm_mullo_epi16(low, lowFactors));
+        high = divideBy255(_mm_mullo_epi16(high, highFactors));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes), _mm_packus_epi16(low, high));
+        bytes += 16;
+        pixelCount -= 4;
+      }
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    while(pixelCount >= 8) {
+      uint8x8x4_t channels = vld4_u8(bytes);
+      channels.val[0] = divideBy255(vmull_u8(channels.val[0], channels.val[3]));
+      channels.val[1] = divideBy255(vmull_u8(channels.val[1], channels.val[3]));
+      channels.val[2] = divideBy255(vmull_u8(channels.val[2], channels.val[3]));
+      vst4_u8(bytes, channels);
+      bytes += 32;
+      pixelCount -= 8;
+    }
+#endif
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    while(pixelCount > 0) {
+      std::uint32_t alpha = bytes[3];
+      bytes[0] = multiplyNormalized(bytes[0], alpha);
+      bytes[1] = multiplyNormalized(bytes[1], alpha);
+      bytes[2] = multiplyNormalized(bytes[2], alpha);
+      bytes += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpremultiplies a row of pixels with 8 bit channels and alpha last</summary>
+  /// <param name="pixels">Address of the first pixel in the row</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  void unpremultiplyBytes(void *pixels, std::size_t pixelCount) {
+    const std::uint32_t *reciprocals = getAlphaReciprocals().Values;
+
+    std::uint8_t *bytes = static_cast<std::uint8_t *>(pixels);
+    while(pixelCount > 0) {
+      std::uint32_t alpha = bytes[3];
+      std::uint32_t reciprocal = reciprocals[alpha];
+      for(std::size_t index = 0; index < 3; ++index) {
+        std::uint32_t color = bytes[index];
+        if(color > alpha) {
+          color = alpha;
+        }
+        bytes[index] = static_cast<std::uint8_t>((color * reciprocal + (1U << 23)) >> 24);
+      }
+      bytes += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Composites a row of pixels with 8 bit channels and alpha last</summary>
+  /// <param name="sourcePixels">Address of the first pixel that will be drawn</param>
+  /// <param name="targetPixels">Address of the first pixel that will be drawn onto</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  void compositeBytesOver(
+    const void *sourcePixels, void *targetPixels, std::size_t pixelCount
+  ) {
+    const std::uint8_t *source = static_cast<const std::uint8_t *>(sourcePixels);
+    std::uint8_t *target = static_cast<std::uint8_t *>(targetPixels);
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i opaque = _mm_set1_epi16(255);
+      while(pixelCount >= 4) {
+        __m128i sourcePacked = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+        __m128i targetPacked = _mm_loadu_si128(reinterpret_cast<const __m128i *>(target));
+
+        // Scale the target by the source's transparency (255 - alpha) and add the source
+        __m128i lowFactors = _mm_sub_epi16(
+          opaque, broadcastAlpha(_mm_unpacklo_epi8(sourcePacked, zero))
+        );
+        __m128i highFactors = _mm_sub_epi16(
+          opaque, broadcastAlpha(_mm_unpackhi_epi8(sourcePacked, zero))
+        );
+        __m128i low = divideBy255(
+          _mm_mullo_epi16(_mm_unpacklo_epi8(targetPacked, zero), lowFactors)
+        );
+        __m128i high = divideBy255(
+          _mm_mullo_epi16(_mm_unpackhi_epi8(targetPacked, zero), highFactors)
+        );
+
+        _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(target),
+          _mm_adds_epu8(sourcePacked, _mm_packus_epi16(low, high))
+        );
+        source += 16;
+        target += 16;
+        pixelCount -= 4;
+      }
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    while(pixelCount >= 8) {
+      uint8x8x4_t sourceChannels = vld4_u8(source);
+      uint8x8x4_t targetChannels = vld4_u8(target);
+      uint8x8_t transparency = vmvn_u8(sourceChannels.val[3]);
+      for(std::size_t index = 0; index < 4; ++index) {
+        targetChannels.val[index] = vqadd_u8(
+          sourceChannels.val[index],
+          divideBy255(vmull_u8(targetChannels.val[index], transparency))
+        );
+      }
+      vst4_u8(target, targetChannels);
+      source += 32;
+      target += 32;
+      pixelCount -= 8;
+    }
+#endif
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    while(pixelCount > 0) {
+      std::uint32_t transparency = 255U - source[3];
+      for(std::size_t index = 0; index < 4; ++index) {
+        std::uint32_t result = source[index] + multiplyNormalized(target[index], transparency);
+        target[index] = static_cast<std::uint8_t>((result > 255U) ? 255U : result);
+      }
+      source += 4;
+      target += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Premultiplies a row of pixels with float channels and alpha last</summary>
+  /// <param name="pixels">Address of the first pixel in the row</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  void premultiplyFloats(void *pixels, std::size_t pixelCount) {
+    float *channels = static_cast<float *>(pixels);
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+      while(pixelCount > 0) {
+        __m128 pixel = _mm_loadu_ps(channels);
+        __m128 premultiplied = _mm_mul_ps(pixel, _mm_shuffle_ps(pixel, pixel, 0xFF));
+        _mm_storeu_ps(
+          channels,
+          _mm_or_ps(_mm_and_ps(colorMask, premultiplied), _mm_andnot_ps(colorMask, pixel))
+        );
+        channels += 4;
+        --pixelCount;
+      }
+    }
+#endif
+
+    // Scalar loop if no SIMD instructions are available
+    while(pixelCount > 0) {
+      float alpha = channels[3];
+      channels[0] *= alpha;
+      channels[1] *= alpha;
+      channels[2] *= alpha;
+      channels += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpremultiplies a row of pixels with float channels and alpha last</summary>
+  /// <param name="pixels">Address of the first pixel in the row</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  void unpremultiplyFloats(void *pixels, std::size_t pixelCount) {
+    float *channels = static_cast<float *>(pixels);
+    while(pixelCount > 0) {
+      float alpha = channels[3];
+      if(alpha > 0.0f) {
+        float reciprocal = 1.0f / alpha;
+        channels[0] *= reciprocal;
+        channels[1] *= reciprocal;
+        channels[2] *= reciprocal;
+      } else {
+        channels[0] = channels[1] = channels[2] = 0.0f;
+      }
+      channels += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Composites a row of pixels with float channels and alpha last</summary>
+  /// <param name="sourcePixels">Address of the first pixel that will be drawn</param>
+  /// <param name="targetPixels">Address of the first pixel that will be drawn onto</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  void compositeFloatsOver(
+    const void *sourcePixels, void *targetPixels, std::size_t pixelCount
+  ) {
+    const float *source = static_cast<const float *>(sourcePixels);
+    float *target = static_cast<float *>(targetPixels);
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128 one = _mm_set1_ps(1.0f);
+      while(pixelCount > 0) {
+        __m128 sourcePixel = _mm_loadu_ps(source);
+        __m128 transparency = _mm_sub_ps(
+          one, _mm_shuffle_ps(sourcePixel, sourcePixel, 0xFF)
+        );
+        _mm_storeu_ps(
+          target, _mm_add_ps(sourcePixel, _mm_mul_ps(_mm_loadu_ps(target), transparency))
+        );
+        source += 4;
+        target += 4;
+        --pixelCount;
+      }
+    }
+#endif
+
+    // Scalar loop if no SIMD instructions are available
+    while(pixelCount > 0) {
+      float transparency = 1.0f - source[3];
+      for(std::size_t index = 0; index < 4; ++index) {
+        target[index] = source[index] + target[index] * transparency;
+      }
+      source += 4;
+      target += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if a pixel format can't be composited</summary>
+  /// <param name="pixelFormat">Pixel format that will be checked</param>
+  void requireCompositablePixelFormat(Nuclex::Pixels::PixelFormat pixelFormat) {
+    if(!Nuclex::Pixels::AlphaCompositor::CanComposite(pixelFormat)) {
+      throw std::runtime_error(u8"Pixel format not supported for alpha compositing");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a pixel format stores its channels as floats</summary>
+  /// <param name="pixelFormat">Pixel format that will be checked</param>
+  /// <returns>True if the pixel format uses float channels</returns>
+  bool isFloatPixelFormat(Nuclex::Pixels::PixelFormat pixelFormat) {
+    return (pixelFormat == Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs a row function on all rows of a bitmap</summary>
+  /// <param name="memory">Bitmap memory whose rows will be processed</param>
+  /// <param name="modifyRow">Function that will be called on each row</param>
+  void modifyRows(
+    const Nuclex::Pixels::BitmapMemory &memory, ModifyRowFunction *modifyRow
+  ) {
+    std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels);
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      modifyRow(row, memory.Width);
+      row += memory.Stride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs a compositing function on all rows of two bitmaps</summary>
+  /// <param name="source">Bitmap memory that will be drawn</param>
+  /// <param name="target">Bitmap memory that will be drawn onto</param>
+  /// <param name="compositeRow">Function that will be called on each pair of rows</param>
+  void compositeRows(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target,
+    CompositeRowFunction *compositeRow
+  ) {
+    const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(source.Pixels);
+    std::uint8_t *targetRow = static_cast<std::uint8_t *>(target.Pixels);
+    for(std::size_t y = 0; y < source.Height; ++y) {
+      compositeRow(sourceRow, targetRow, source.Width);
+      sourceRow += source.Stride;
+      targetRow += target.Stride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if two bitmaps can't be composited</summary>
+  /// <param name="source">Bitmap memory that will be drawn</param>
+  /// <param name="target">Bitmap memory that will be drawn onto</param>
+  void requireCompositableBitmaps(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    if((source.Width != target.Width) || (source.Height != target.Height)) {
+      throw std::runtime_error(u8"Provided bitmap does not have the correct dimensions");
+    }
+    if(source.PixelFormat != target.PixelFormat) {
+      throw std::runtime_error(u8"Provided bitmaps do not use the same pixel format");
+    }
+    requireCompositablePixelFormat(source.PixelFormat);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AlphaCompositor::CanComposite(PixelFormat pixelFormat) {
+    return (
+      (pixelFormat == PixelFormat::R8_G8_B8_A8_Unsigned) ||
+      (pixelFormat == PixelFormat::B8_G8_R8_A8_Unsigned) ||
+      (pixelFormat == PixelFormat::R32_G32_B32_A32_Float)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::PremultiplyRow(
+    PixelFormat pixelFormat, void *pixels, std::size_t pixelCount
+  ) {
+    requireCompositablePixelFormat(pixelFormat);
+    if(isFloatPixelFormat(pixelFormat)) {
+      premultiplyFloats(pixels, pixelCount);
+    } else {
+      premultiplyBytes(pixels, pixelCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::UnpremultiplyRow(
+    PixelFormat pixelFormat, void *pixels, std::size_t pixelCount
+  ) {
+    requireCompositablePixelFormat(pixelFormat);
+    if(isFloatPixelFormat(pixelFormat)) {
+      unpremultiplyFloats(pixels, pixelCount);
+    } else {
+      unpremultiplyBytes(pixels, pixelCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::CompositeRowOver(
+    PixelFormat pixelFormat, const void *sourcePixels, void *targetPixels,
+    std::size_t pixelCount
+  ) {
+    requireCompositablePixelFormat(pixelFormat);
+    if(isFloatPixelFormat(pixelFormat)) {
+      compositeFloatsOver(sourcePixels, targetPixels, pixelCount);
+    } else {
+      compositeBytesOver(sourcePixels, targetPixels, pixelCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::Premultiply(const BitmapMemory &memory) {
+    requireCompositablePixelFormat(memory.PixelFormat);
+    if(isFloatPixelFormat(memory.PixelFormat)) {
+      modifyRows(memory, &premultiplyFloats);
+    } else {
+      modifyRows(memory, &premultiplyBytes);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::Premultiply(const BitmapMemory &memory, ThreadPool &threadPool) {
+    requireCompositablePixelFormat(memory.PixelFormat);
+
+    ModifyRowFunction *premultiplyRow = (
+      isFloatPixelFormat(memory.PixelFormat) ? &premultiplyFloats : &premultiplyBytes
+    );
+    ForEachBandInParallel(
+      threadPool, memory,
+      [premultiplyRow](const BitmapMemory &band, std::size_t) {
+        modifyRows(band, premultiplyRow);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::Unpremultiply(const BitmapMemory &memory) {
+    requireCompositablePixelFormat(memory.PixelFormat);
+    if(isFloatPixelFormat(memory.PixelFormat)) {
+      modifyRows(memory, &unpremultiplyFloats);
+    } else {
+      modifyRows(memory, &unpremultiplyBytes);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::Unpremultiply(const BitmapMemory &memory, ThreadPool &threadPool) {
+    requireCompositablePixelFormat(memory.PixelFormat);
+
+    ModifyRowFunction *unpremultiplyRow = (
+      isFloatPixelFormat(memory.PixelFormat) ? &unpremultiplyFloats : &unpremultiplyBytes
+    );
+    ForEachBandInParallel(
+      threadPool, memory,
+      [unpremultiplyRow](const BitmapMemory &band, std::size_t) {
+        modifyRows(band, unpremultiplyRow);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::CompositeOver(const BitmapMemory &source, const BitmapMemory &target) {
+    requireCompositableBitmaps(source, target);
+    if(isFloatPixelFormat(source.PixelFormat)) {
+      compositeRows(source, target, &compositeFloatsOver);
+    } else {
+      compositeRows(source, target, &compositeBytesOver);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AlphaCompositor::CompositeOver(
+    const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+  ) {
+    requireCompositableBitmaps(source, target);
+
+    CompositeRowFunction *compositeRow = (
+      isFloatPixelFormat(source.PixelFormat) ? &compositeFloatsOver : &compositeBytesOver
+    );
+    ForEachBandInParallel(
+      threadPool, source, target,
+      [compositeRow](const BitmapMemory &sourceBand, const BitmapMemory &targetBand, std::size_t) {
+        compositeRows(sourceBand, targetBand, compositeRow);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -24,9 +24,11 @@ License along with this library
 #include "Nuclex/Pixels/Bitmap.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cassert>
 #include <memory>
+#include <stdexcept>
 
 namespace {
 
@@ -69,11 +71,25 @@ namespace {
   /// <summary>Determines the stride (bytes per line) required for a bitmap</summary>
   /// <param name="width">Desired width of the bitmap in pixels</param>
   /// <param name="pixelFormat">Pixel format used by the bitmap</param>
+  /// <param name="rowAlignment">
+  ///   Alignment of each row in bytes, 0 for none. Ignored for block-compressed formats.
+  /// </param>
   /// <returns>The number of bytes required to store one line of the bitmap</returns>
-  int determineStride(std::size_t width, Nuclex::Pixels::PixelFormat pixelFormat) {
+  int determineStride(
+    std::size_t width, Nuclex::Pixels::PixelFormat pixelFormat, std::size_t rowAlignment
+  ) {
     Nuclex::Pixels::Size blockSize = Nuclex::Pixels::GetBlockSize(pixelFormat);
     width = nextMultiple(width, blockSize.Width);
-    return static_cast<int>(Nuclex::Pixels::CountRequiredBytes(pixelFormat, width));
+
+    std::size_t stride = Nuclex::Pixels::CountRequiredBytes(pixelFormat, width);
+
+    // Rows of a block-compressed bitmap are slices of a row of blocks, padding
+    // them would tear the blocks apart
+    if((rowAlignment > 1) && (blockSize.Height == 1)) {
+      stride = nextMultiple(stride, rowAlignment);
+    }
+
+    return static_cast<int>(stride);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -102,6 +118,41 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Calculates the number of bytes a buffer needs for a bitmap's pixels</summary>
+  /// <param name="resolution">Resolution of the buffer that will be allocated</param>
+  /// <param name="pixelFormat">Pixel format used to store the bitmap's pixels</param>
+  /// <param name="rowAlignment">Alignment of each row in bytes, 0 for none</param>
+  /// <returns>
+  ///   The number of bytes required for the pixels, including the slack needed to
+  ///   align the first pixel
+  /// </returns>
+  std::size_t countRequiredPixelBytes(
+    const Nuclex::Pixels::Size &resolution, Nuclex::Pixels::PixelFormat pixelFormat,
+    std::size_t rowAlignment
+  ) {
+
+    // The first pixel is always aligned to at least 16 bytes. Allocators only guarantee
+    // the alignment of new[], so reserve enough space to move the pixels up to it.
+    const std::size_t MinimumAlignment = 16;
+    std::size_t alignment = std::max(rowAlignment, MinimumAlignment);
+
+    return (alignment - 1) + (
+      static_cast<std::size_t>(determineStride(resolution.Width, pixelFormat, rowAlignment)) *
+      resolution.Height
+    );
+
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of bytes held by the shared buffers of all live bitmaps</summary>
+  std::atomic<std::size_t> liveByteCount(0);
+
+  /// <summary>Number of shared buffers currently held by bitmaps</summary>
+  std::atomic<std::size_t> liveBufferCount(0);
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Pixels {
@@ -109,22 +160,49 @@ namespace Nuclex { namespace Pixels {
   /// <summary>Detachable memory buffer that allows for shared ownership</summary>
   struct Bitmap::SharedBuffer {
     /// <summary>Number of owners that are holding onto the bitmap's memory</summary>
-    public: mutable std::size_t OwnerCount;
+    /// <remarks>
+    ///   Atomic so that bitmaps sharing the buffer can be created and destroyed on
+    ///   different threads. New owners only need a relaxed increment because they are
+    ///   always created from an existing owner; the last owner to leave needs to see
+    ///   all writes of the others before the memory is freed, hence acquire-release.
+    /// </remarks>
+    public: mutable std::atomic<std::size_t> OwnerCount;
     /// <summary>Memory the buffer is managing</summary>
     public: void *Memory;
+    /// <summary>Allocator the buffer (and the memory behind it) was obtained from</summary>
+    public: BitmapAllocator *Allocator;
+    /// <summary>Number of bytes that were requested from the allocator</summary>
+    public: std::size_t ByteCount;
+    /// <summary>Alignment of each row in bytes, 0 if rows are tightly packed</summary>
+    public: std::size_t RowAlignment;
     // This structure is followed by the actual bitmap data if created by this library
   };
 
   // ------------------------------------------------------------------------------------------- //
 
+  int Bitmap::CalculateStride(
+    std::size_t width, PixelFormat pixelFormat, std::size_t rowAlignment /* = 0 */
+  ) {
+    return determineStride(width, pixelFormat, rowAlignment);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   Bitmap Bitmap::FromExistingMemory(const BitmapMemory &bitmapMemory) {
 
-    // Allocate the shared buffer this way because it's released via delete[]
+    // Allocate the shared buffer through an allocator because that's how it's released
     // (other constructors allocate the shared buffer + bitmap memory in one block)
-    std::uint8_t *memory = new std::uint8_t[sizeof(SharedBuffer)];
+    BitmapAllocator &allocator = BitmapAllocator::GetDefault();
+    void *memory = allocator.Allocate(sizeof(SharedBuffer));
     SharedBuffer *buffer = new(memory) SharedBuffer();
-    buffer->OwnerCount = 1;
+    buffer->OwnerCount.store(1, std::memory_order_relaxed);
     buffer->Memory = bitmapMemory.Pixels;
+    buffer->Allocator = &allocator;
+    buffer->ByteCount = sizeof(SharedBuffer);
+    buffer->RowAlignment = 0;
+
+    liveByteCount.fetch_add(buffer->ByteCount, std::memory_order_relaxed);
+    liveBufferCount.fetch_add(1, std::memory_order_relaxed);
 
     return Bitmap(buffer, bitmapMemory);
 
@@ -138,9 +216,39 @@ namespace Nuclex { namespace Pixels {
     PixelFormat pixelFormat /* = PixelFormat::R8_G8_B8_A8_Unsigned */
   ) :
     memory(makeBitmapMemory(width, height, pixelFormat)),
-    buffer(newSharedBuffer(getRequiredBufferSize(width, height, pixelFormat), pixelFormat)) {
+    buffer(
+      newSharedBuffer(
+        getRequiredBufferSize(width, height, pixelFormat), pixelFormat,
+        BitmapAllocator::GetDefault(), 0
+      )
+    ),
+    copyOnWrite(false),
+    dirtyRegionTracker(nullptr) {
+
+    this->memory.Stride = determineStride(width, pixelFormat, 0);
+    this->memory.Pixels = this->buffer->Memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    this->memory.Stride = determineStride(width, pixelFormat);
+  Bitmap::Bitmap(
+    std::size_t width,
+    std::size_t height,
+    PixelFormat pixelFormat,
+    BitmapAllocator &allocator,
+    std::size_t rowAlignment /* = 0 */
+  ) :
+    memory(makeBitmapMemory(width, height, pixelFormat)),
+    buffer(
+      newSharedBuffer(
+        getRequiredBufferSize(width, height, pixelFormat), pixelFormat,
+        allocator, rowAlignment
+      )
+    ),
+    copyOnWrite(false),
+    dirtyRegionTracker(nullptr) {
+
+    this->memory.Stride = determineStride(width, pixelFormat, rowAlignment);
     this->memory.Pixels = this->buffer->Memory;
   }
 
@@ -148,18 +256,38 @@ namespace Nuclex { namespace Pixels {
 
   Bitmap::Bitmap(const Bitmap &other) :
     memory(other.memory),
-    buffer(newSharedBuffer(other.memory)) {
+    buffer(other.buffer),
+    copyOnWrite(other.copyOnWrite),
+    dirtyRegionTracker(nullptr) {
 
-    this->memory.Stride = determineStride(this->memory.Width, this->memory.PixelFormat);
-    this->memory.Pixels = this->buffer->Memory;
+    // In copy-on-write mode, the pixels are only cloned once either bitmap is modified
+    if(this->copyOnWrite) {
+      this->buffer->OwnerCount.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      this->buffer = newSharedBuffer(
+        other.memory, *other.buffer->Allocator, other.buffer->RowAlignment
+      );
+      this->memory.Stride = determineStride(
+        this->memory.Width, this->memory.PixelFormat, this->buffer->RowAlignment
+      );
+      this->memory.Pixels = this->buffer->Memory;
+    }
+
+    // The copy has the same pixels, so it has the same regions left to process
+    if(other.dirtyRegionTracker != nullptr) {
+      this->dirtyRegionTracker = new DirtyRegionTracker(*other.dirtyRegionTracker);
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   Bitmap::Bitmap(Bitmap &&other) :
     memory(other.memory),
-    buffer(other.buffer) {
+    buffer(other.buffer),
+    copyOnWrite(other.copyOnWrite),
+    dirtyRegionTracker(other.dirtyRegionTracker) {
     other.buffer = nullptr;
+    other.dirtyRegionTracker = nullptr;
 #if _DEBUG
     other.memory.Pixels = nullptr;
 #endif
@@ -168,6 +296,7 @@ namespace Nuclex { namespace Pixels {
   // ------------------------------------------------------------------------------------------- //
 
   Bitmap::~Bitmap() {
+    delete this->dirtyRegionTracker;
     if(this->buffer != nullptr) {
       releaseSharedBuffer(this->buffer);
     }
@@ -181,23 +310,109 @@ namespace Nuclex { namespace Pixels {
 
   Bitmap::Bitmap(SharedBuffer *buffer, const BitmapMemory &memory) :
     memory(memory),
-    buffer(buffer) {}
+    buffer(buffer),
+    copyOnWrite(false),
+    dirtyRegionTracker(nullptr) {}
 
   // ------------------------------------------------------------------------------------------- //
 
   void Bitmap::Autonomize() {
-    if(this->buffer->OwnerCount > 1) { // Only autonomize if the bitmap still has other owners
+    // Only autonomize if the bitmap still has other owners
+    if(this->buffer->OwnerCount.load(std::memory_order_acquire) > 1) {
       Bitmap::SharedBuffer *oldBuffer = this->buffer;
-      this->buffer = newSharedBuffer(this->memory);
-      --oldBuffer->OwnerCount;
+      this->buffer = newSharedBuffer(
+        this->memory, *oldBuffer->Allocator, oldBuffer->RowAlignment
+      );
+
+      // The other owners may have gone away in the meantime, so this can be the last one
+      releaseSharedBuffer(oldBuffer);
 
-      this->memory.Stride = determineStride(this->memory.Width, this->memory.PixelFormat);
+      this->memory.Stride = determineStride(
+        this->memory.Width, this->memory.PixelFormat, this->buffer->RowAlignment
+      );
       this->memory.Pixels = this->buffer->Memory;
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  const BitmapMemory &Bitmap::AccessMutable() {
+    if(this->copyOnWrite) {
+      Autonomize();
+    }
+    if(this->dirtyRegionTracker != nullptr) {
+      this->dirtyRegionTracker->MarkAllDirty();
+    }
+
+    return this->memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const BitmapMemory &Bitmap::AccessMutable(const Rectangle &region) {
+    if(this->copyOnWrite) {
+      Autonomize();
+    }
+    if(this->dirtyRegionTracker != nullptr) {
+      this->dirtyRegionTracker->MarkDirty(region);
+    }
+
+    return this->memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Bitmap::EnableDirtyTracking(
+    std::size_t tileSize /* = DirtyRegionTracker::DefaultTileSize */
+  ) {
+    if(this->dirtyRegionTracker != nullptr) {
+      if(this->dirtyRegionTracker->GetTileSize() == tileSize) {
+        return; // Already tracking at this granularity, keep what was recorded
+      }
+    }
+
+    DirtyRegionTracker *newTracker = new DirtyRegionTracker(
+      this->memory.Width, this->memory.Height, tileSize
+    );
+    delete this->dirtyRegionTracker;
+    this->dirtyRegionTracker = newTracker;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Bitmap::DisableDirtyTracking() {
+    delete this->dirtyRegionTracker;
+    this->dirtyRegionTracker = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Bitmap::MarkDirty(const Rectangle &region) {
+    if(this->dirtyRegionTracker != nullptr) {
+      this->dirtyRegionTracker->MarkDirty(region);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<Rectangle> Bitmap::GetDirtyRegions() const {
+    if(this->dirtyRegionTracker == nullptr) {
+      return std::vector<Rectangle>();
+    } else {
+      return this->dirtyRegionTracker->GetDirtyRegions();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Bitmap::ClearDirtyRegions() {
+    if(this->dirtyRegionTracker != nullptr) {
+      this->dirtyRegionTracker->Clear();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   Bitmap Bitmap::GetView(
     std::size_t x, std::size_t y, std::size_t width, std::size_t height
   ) {
@@ -213,7 +428,7 @@ namespace Nuclex { namespace Pixels {
     );
 
     // Assumption: allocation-free Bitmap constructor will not throw.
-    ++this->buffer->OwnerCount;
+    this->buffer->OwnerCount.fetch_add(1, std::memory_order_relaxed);
     return Bitmap(this->buffer, viewMemory);
   }
 
@@ -234,21 +449,96 @@ namespace Nuclex { namespace Pixels {
     );
 
     // Assumption: allocation-free Bitmap constructor will not throw.
-    ++this->buffer->OwnerCount;
+    this->buffer->OwnerCount.fetch_add(1, std::memory_order_relaxed);
     return Bitmap(this->buffer, viewMemory);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::size_t Bitmap::GetMemoryUsed() const {
+    return this->buffer->ByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Bitmap::IsWastingMemory(std::size_t toleratedByteCount /* = 0 */) const {
+
+    // Other bitmaps sharing the buffer still make use of the rest of it
+    if(this->buffer->OwnerCount.load(std::memory_order_acquire) > 1) {
+      return false;
+    }
+
+    // Buffers accessing external memory only consist of the header
+    if(this->buffer->ByteCount == sizeof(SharedBuffer)) {
+      return false;
+    }
+
+    Size requiredSize = getRequiredBufferSize(
+      this->memory.Width, this->memory.Height, this->memory.PixelFormat
+    );
+    std::size_t requiredByteCount = sizeof(SharedBuffer) + countRequiredPixelBytes(
+      requiredSize, this->memory.PixelFormat, this->buffer->RowAlignment
+    );
+
+    return (this->buffer->ByteCount > requiredByteCount + toleratedByteCount);
+
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Bitmap::CompactIfWasting(std::size_t toleratedByteCount /* = 0 */) {
+    if(!IsWastingMemory(toleratedByteCount)) {
+      return false;
+    }
+
+    Bitmap::SharedBuffer *oldBuffer = this->buffer;
+    this->buffer = newSharedBuffer(
+      this->memory, *oldBuffer->Allocator, oldBuffer->RowAlignment
+    );
+    releaseSharedBuffer(oldBuffer);
+
+    this->memory.Stride = determineStride(
+      this->memory.Width, this->memory.PixelFormat, this->buffer->RowAlignment
+    );
+    this->memory.Pixels = this->buffer->Memory;
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Bitmap::GetLiveByteCount() {
+    return liveByteCount.load(std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Bitmap::GetLiveBufferCount() {
+    return liveBufferCount.load(std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   Bitmap &Bitmap::operator =(const Bitmap &other) {
+    // Join the other buffer first in case both bitmaps are already sharing it
+    other.buffer->OwnerCount.fetch_add(1, std::memory_order_relaxed);
     if(this->buffer != nullptr) {
       releaseSharedBuffer(this->buffer);
     }
 
     this->buffer = other.buffer;
-    ++this->buffer->OwnerCount;
 
     this->memory = other.memory;
+    this->copyOnWrite = other.copyOnWrite;
+
+    if(&other != this) {
+      DirtyRegionTracker *newTracker = nullptr;
+      if(other.dirtyRegionTracker != nullptr) {
+        newTracker = new DirtyRegionTracker(*other.dirtyRegionTracker);
+      }
+      delete this->dirtyRegionTracker;
+      this->dirtyRegionTracker = newTracker;
+    }
 
     return *this;
   }
@@ -262,8 +552,13 @@ namespace Nuclex { namespace Pixels {
 
     this->buffer = other.buffer;
     this->memory = other.memory;
+    this->copyOnWrite = other.copyOnWrite;
+
+    delete this->dirtyRegionTracker;
+    this->dirtyRegionTracker = other.dirtyRegionTracker;
 
     other.buffer = nullptr;
+    other.dirtyRegionTracker = nullptr;
     #if _DEBUG
     other.memory.Pixels = nullptr;
     #endif
@@ -273,23 +568,39 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
-  Bitmap::SharedBuffer *Bitmap::newSharedBuffer(const Size &resolution, PixelFormat pixelFormat) {
-
-    // Calculate the (aligned) space reserved for the detachable buffer structure
-    const std::size_t Alignment = 16;
-    std::size_t headerSize = nextMultiple(sizeof(SharedBuffer), Alignment);
+  Bitmap::SharedBuffer *Bitmap::newSharedBuffer(
+    const Size &resolution, PixelFormat pixelFormat,
+    BitmapAllocator &allocator, std::size_t rowAlignment
+  ) {
+    if((rowAlignment & (rowAlignment - 1)) != 0) {
+      throw std::invalid_argument(u8"Row alignment must be a power of two");
+    }
 
     // Add the amount of memory required to store the bitmap
-    std::size_t byteCount = headerSize;
-    byteCount += CountRequiredBytes(pixelFormat, resolution.Width) * resolution.Height;
+    std::size_t byteCount = (
+      sizeof(SharedBuffer) + countRequiredPixelBytes(resolution, pixelFormat, rowAlignment)
+    );
 
     // Allocate memory to hold the detachable buffer AND the pixel data,
     // then construct the detachable buffer in it and set the address of the first pixel
-    // to the memory behind the detachable buffer.
-    std::uint8_t *memory = new std::uint8_t[byteCount];
+    // to the (aligned) memory behind the detachable buffer.
+    std::uint8_t *memory = static_cast<std::uint8_t *>(allocator.Allocate(byteCount));
     SharedBuffer *buffer = new(memory) SharedBuffer();
-    buffer->OwnerCount = 1;
-    buffer->Memory = memory + headerSize;
+    buffer->OwnerCount.store(1, std::memory_order_relaxed);
+    {
+      const std::size_t MinimumAlignment = 16;
+      std::size_t alignment = std::max(rowAlignment, MinimumAlignment);
+
+      std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory + sizeof(SharedBuffer));
+      std::uintptr_t padding = nextMultiple(address, alignment) - address;
+      buffer->Memory = memory + sizeof(SharedBuffer) + padding;
+    }
+    buffer->Allocator = &allocator;
+    buffer->ByteCount = byteCount;
+    buffer->RowAlignment = rowAlignment;
+
+    liveByteCount.fetch_add(byteCount, std::memory_order_relaxed);
+    liveBufferCount.fetch_add(1, std::memory_order_relaxed);
 
     return buffer;
 
@@ -297,22 +608,26 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
-  Bitmap::SharedBuffer *Bitmap::newSharedBuffer(const BitmapMemory &memory) {
+  Bitmap::SharedBuffer *Bitmap::newSharedBuffer(
+    const BitmapMemory &memory, BitmapAllocator &allocator, std::size_t rowAlignment
+  ) {
     Size bufferSize = getRequiredBufferSize(memory.Width, memory.Height, memory.PixelFormat);
     std::unique_ptr<Bitmap::SharedBuffer, void(*)(Bitmap::SharedBuffer *)> newBuffer(
-      newSharedBuffer(bufferSize, memory.PixelFormat), releaseSharedBuffer
+      newSharedBuffer(bufferSize, memory.PixelFormat, allocator, rowAlignment),
+      releaseSharedBuffer
     );
 
     // Copy all pixels into the new buffer
     {
-      int newStride = static_cast<int>(CountRequiredBytes(memory.PixelFormat, bufferSize.Width));
+      std::size_t rowByteCount = CountRequiredBytes(memory.PixelFormat, bufferSize.Width);
+      int newStride = determineStride(bufferSize.Width, memory.PixelFormat, rowAlignment);
 
       const std::uint8_t *source = reinterpret_cast<std::uint8_t *>(memory.Pixels);
       std::uint8_t *target = reinterpret_cast<std::uint8_t *>(newBuffer->Memory);
 
       // Do the copy line-by-line because stride may be different
       for(std::size_t index = 0; index < bufferSize.Height; ++index) {
-        std::copy_n(source, newStride, target);
+        std::copy_n(source, rowByteCount, target);
         source += memory.Stride;
         target += newStride;
       }
@@ -324,12 +639,14 @@ namespace Nuclex { namespace Pixels {
   // ------------------------------------------------------------------------------------------- //
 
   void Bitmap::releaseSharedBuffer(Bitmap::SharedBuffer *sharedBuffer) throw() {
-    if(sharedBuffer->OwnerCount == 1) {
-      std::uint8_t *memory = reinterpret_cast<std::uint8_t *>(sharedBuffer);
+    if(sharedBuffer->OwnerCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      BitmapAllocator *allocator = sharedBuffer->Allocator;
+      std::size_t byteCount = sharedBuffer->ByteCount;
       sharedBuffer->~SharedBuffer();
-      delete memory;
-    } else {
-      --sharedBuffer->OwnerCount;
+      allocator->Free(sharedBuffer, byteCount);
+
+      liveByteCount.fetch_sub(byteCount, std::memory_order_relaxed);
+      liveBufferCount.fetch_sub(1, std::memory_order_relaxed);
     }
   }
 
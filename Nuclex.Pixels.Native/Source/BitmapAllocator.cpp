@@ -0,0 +1,99 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapAllocator.h"
+
+#include <atomic> // for std::atomic
+#include <cstdint> // for std::uint8_t
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocator that simply uses new[] and delete[]</summary>
+  class HeapBitmapAllocator : public Nuclex::Pixels::BitmapAllocator {
+
+    /// <summary>Frees all resources owned by the allocator</summary>
+    public: ~HeapBitmapAllocator() override = default;
+
+    /// <summary>Allocates a memory block for a bitmap</summary>
+    /// <param name="byteCount">Number of bytes the memory block needs to have</param>
+    /// <returns>The address of the memory block</returns>
+    public: void *Allocate(std::size_t byteCount) override {
+      return new std::uint8_t[byteCount];
+    }
+
+    /// <summary>Frees a memory block that has been obtained from the allocator</summary>
+    /// <param name="memory">Address of the memory block that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were requested for the block</param>
+    public: void Free(void *memory, std::size_t byteCount) throw() override {
+      (void)byteCount;
+      delete[] static_cast<std::uint8_t *>(memory);
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the allocator used when no default allocator has been set</summary>
+  /// <returns>The allocator using new[] and delete[]</returns>
+  /// <remarks>
+  ///   Constructed on first use so that bitmaps can safely be created from
+  ///   the constructors of global objects.
+  /// </remarks>
+  Nuclex::Pixels::BitmapAllocator &getHeapAllocator() {
+    static HeapBitmapAllocator heapAllocator;
+    return heapAllocator;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocator bitmaps use when none is specified, null for the heap allocator</summary>
+  std::atomic<Nuclex::Pixels::BitmapAllocator *> defaultAllocator(nullptr);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapAllocator &BitmapAllocator::GetDefault() {
+    BitmapAllocator *allocator = defaultAllocator.load(std::memory_order_acquire);
+    if(allocator == nullptr) {
+      return getHeapAllocator();
+    } else {
+      return *allocator;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapAllocator::SetDefault(BitmapAllocator *allocator) {
+    defaultAllocator.store(allocator, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,1135 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapAnalyzer.h"
+#include "Nuclex/Pixels/Half.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/PixelFormatTraits.h"
+
+#include <algorithm> // for std::min(), std::max(), std::nth_element()
+#include <bitset> // for std::bitset
+#include <cmath> // for std::cos()
+#include <cstdint>
+#include <limits> // for std::numeric_limits
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+#include <vector> // for std::vector
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2 intrinsics
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON intrinsics
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of pixels that are converted from half to float at once</summary>
+  const std::size_t ChunkSize = 256;
+
+  /// <summary>Number of sub-histograms pixels are counted into in turns</summary>
+  const std::size_t SubHistogramCount = 4;
+
+  /// <summary>Width and height of the luminance grid the perceptual hash transforms</summary>
+  const std::size_t PerceptualHashGridSize = 32;
+
+  /// <summary>Number of frequencies per axis that go into the perceptual hash</summary>
+  const std::size_t PerceptualHashFrequencyCount = 8;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Data types the channels of an analyzable pixel format can have</summary>
+  enum class ChannelType {
+
+    /// <summary>8 bit unsigned integer</summary>
+    UnsignedByte,
+    /// <summary>16 bit unsigned integer in the platform's byte order</summary>
+    UnsignedShort,
+    /// <summary>Half-precision floating point value in the platform's byte order</summary>
+    Half,
+    /// <summary>Full precision floating point value in the platform's byte order</summary>
+    Float
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the channels of a pixel format that can be analyzed</summary>
+  struct AnalysisLayout {
+
+    /// <summary>Pixel format the layout applies to</summary>
+    public: Nuclex::Pixels::PixelFormat PixelFormat;
+    /// <summary>Number of channels in each pixel</summary>
+    public: std::size_t ChannelCount;
+    /// <summary>Data type of all channels</summary>
+    public: ChannelType Type;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>All pixel formats that can be analyzed</summary>
+  const AnalysisLayout AnalysisLayouts[] = {
+    { Nuclex::Pixels::PixelFormat::R8_Unsigned, 1, ChannelType::UnsignedByte },
+    { Nuclex::Pixels::PixelFormat::R8_G8_Unsigned, 2, ChannelType::UnsignedByte },
+    { Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned, 3, ChannelType::UnsignedByte },
+    { Nuclex::Pixels::PixelFormat::B8_G8_R8_Unsigned, 3, ChannelType::UnsignedByte },
+    { Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned, 4, ChannelType::UnsignedByte },
+    { Nuclex::Pixels::PixelFormat::A8_B8_G8_R8_Unsigned, 4, ChannelType::UnsignedByte },
+    { Nuclex::Pixels::PixelFormat::B8_G8_R8_A8_Unsigned, 4, ChannelType::UnsignedByte },
+    { Nuclex::Pixels::PixelFormat::A8_R8_G8_B8_Unsigned, 4, ChannelType::UnsignedByte },
+    { Nuclex::Pixels::PixelFormat::R16_Unsigned_Native16, 1, ChannelType::UnsignedShort },
+    { Nuclex::Pixels::PixelFormat::R16_G16_Unsigned_Native16, 2, ChannelType::UnsignedShort },
+    { Nuclex::Pixels::PixelFormat::R16_Float_Native16, 1, ChannelType::Half },
+    { Nuclex::Pixels::PixelFormat::R16_G16_Float_Native16, 2, ChannelType::Half },
+    { Nuclex::Pixels::PixelFormat::R16_G16_B16_A16_Float_Native16, 4, ChannelType::Half },
+    { Nuclex::Pixels::PixelFormat::A16_B16_G16_R16_Float_Native16, 4, ChannelType::Half },
+    { Nuclex::Pixels::PixelFormat::B16_G16_R16_A16_Float_Native16, 4, ChannelType::Half },
+    { Nuclex::Pixels::PixelFormat::A16_R16_G16_B16_Float_Native16, 4, ChannelType::Half },
+    { Nuclex::Pixels::PixelFormat::R32_Float_Native32, 1, ChannelType::Float },
+    { Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32, 4, ChannelType::Float },
+    { Nuclex::Pixels::PixelFormat::A32_B32_G32_R32_Float_Native32, 4, ChannelType::Float }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the channel layout of a pixel format that can be analyzed</summary>
+  /// <param name="pixelFormat">Pixel format whose channel layout will be looked up</param>
+  /// <returns>The channel layout of the pixel format or null if it can not be analyzed</returns>
+  const AnalysisLayout *findAnalysisLayout(Nuclex::Pixels::PixelFormat pixelFormat) {
+    const std::size_t layoutCount = sizeof(AnalysisLayouts) / sizeof(AnalysisLayout);
+    for(std::size_t index = 0; index < layoutCount; ++index) {
+      if(AnalysisLayouts[index].PixelFormat == pixelFormat) {
+        return &AnalysisLayouts[index];
+      }
+    }
+
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the channel layout of a bitmap's pixel format or throws</summary>
+  /// <param name="pixelFormat">Pixel format whose channel layout will be looked up</param>
+  /// <returns>The channel layout of the pixel format</returns>
+  const AnalysisLayout &requireAnalysisLayout(Nuclex::Pixels::PixelFormat pixelFormat) {
+    const AnalysisLayout *layout = findAnalysisLayout(pixelFormat);
+    if(layout == nullptr) {
+      throw std::runtime_error(u8"Analyzing bitmaps in this pixel format is not supported");
+    }
+
+    return *layout;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the factor that normalizes the values of a channel type</summary>
+  /// <param name="type">Channel type whose normalization factor will be returned</param>
+  /// <returns>The factor by which values need to be multiplied to normalize them</returns>
+  double getNormalizationFactor(ChannelType type) {
+    switch(type) {
+      case ChannelType::UnsignedByte: { return 1.0 / 255.0; }
+      case ChannelType::UnsignedShort: { return 1.0 / 65535.0; }
+      default: { return 1.0; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Running minimum, maximum and sum of up to four channels</summary>
+  struct Totals {
+
+    /// <summary>Smallest value seen in each channel so far</summary>
+    public: double Minimum[4];
+    /// <summary>Largest value seen in each channel so far</summary>
+    public: double Maximum[4];
+    /// <summary>Sum of all values seen in each channel so far</summary>
+    public: double Sum[4];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Resets running totals to the state before any values were seen</summary>
+  /// <param name="totals">Running totals that will be reset</param>
+  void resetTotals(Totals &totals) {
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      totals.Minimum[channel] = std::numeric_limits<double>::infinity();
+      totals.Maximum[channel] = -std::numeric_limits<double>::infinity();
+      totals.Sum[channel] = 0.0;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Merges the running totals of one channel with new values</summary>
+  /// <param name="totals">Running totals that will be updated</param>
+  /// <param name="channel">Index of the channel that will be updated</param>
+  /// <param name="minimum">Smallest of the new values</param>
+  /// <param name="maximum">Largest of the new values</param>
+  /// <param name="sum">Sum of the new values</param>
+  inline void mergeChannel(
+    Totals &totals, std::size_t channel, double minimum, double maximum, double sum
+  ) {
+    totals.Minimum[channel] = std::min(totals.Minimum[channel], minimum);
+    totals.Maximum[channel] = std::max(totals.Maximum[channel], maximum);
+    totals.Sum[channel] += sum;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Updates the running totals with some pixels</summary>
+  /// <typeparam name="TValue">Type of the values in each channel</typeparam>
+  /// <typeparam name="TSum">Type that is used to sum up the values</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels in each pixel</typeparam>
+  /// <param name="values">Values of the pixels' channels</param>
+  /// <param name="start">Index of the first pixel that will be looked at</param>
+  /// <param name="width">Number of pixels in total</param>
+  /// <param name="totals">Running totals that will be updated</param>
+  template<typename TValue, typename TSum, std::size_t ChannelCount>
+  void accumulateScalar(
+    const TValue *values, std::size_t start, std::size_t width, Totals &totals
+  ) {
+    if(start >= width) {
+      return;
+    }
+
+    TValue minimum[ChannelCount], maximum[ChannelCount];
+    TSum sums[ChannelCount];
+    for(std::size_t channel = 0; channel < ChannelCount; ++channel) {
+      minimum[channel] = maximum[channel] = values[start * ChannelCount + channel];
+      sums[channel] = TSum(0);
+    }
+
+    for(std::size_t x = start; x < width; ++x) {
+      for(std::size_t channel = 0; channel < ChannelCount; ++channel) {
+        TValue value = values[x * ChannelCount + channel];
+        minimum[channel] = std::min(minimum[channel], value);
+        maximum[channel] = std::max(maximum[channel], value);
+        sums[channel] += value;
+      }
+    }
+
+    for(std::size_t channel = 0; channel < ChannelCount; ++channel) {
+      mergeChannel(
+        totals, channel,
+        static_cast<double>(minimum[channel]),
+        static_cast<double>(maximum[channel]),
+        static_cast<double>(sums[channel])
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Updates the running totals with some pixels of any channel count</summary>
+  /// <typeparam name="TValue">Type of the values in each channel</typeparam>
+  /// <typeparam name="TSum">Type that is used to sum up the values</typeparam>
+  /// <param name="values">Values of the pixels' channels</param>
+  /// <param name="start">Index of the first pixel that will be looked at</param>
+  /// <param name="width">Number of pixels in total</param>
+  /// <param name="channelCount">Number of channels in each pixel</param>
+  /// <param name="totals">Running totals that will be updated</param>
+  template<typename TValue, typename TSum>
+  void accumulateValues(
+    const TValue *values, std::size_t start, std::size_t width, std::size_t channelCount,
+    Totals &totals
+  ) {
+    switch(channelCount) {
+      case 1: { accumulateScalar<TValue, TSum, 1>(values, start, width, totals); break; }
+      case 2: { accumulateScalar<TValue, TSum, 2>(values, start, width, totals); break; }
+      case 3: { accumulateScalar<TValue, TSum, 3>(values, start, width, totals); break; }
+      default: { accumulateScalar<TValue, TSum, 4>(values, start, width, totals); break; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Updates the running totals with a row of 8 bit pixels using SIMD</summary>
+  /// <param name="pixels">Pixels whose channels will be looked at</param>
+  /// <param name="width">Number of pixels in the row</param>
+  /// <param name="channelCount">Number of channels in each pixel</param>
+  /// <param name="totals">Running totals that will be updated</param>
+  /// <returns>The number of pixels that have been processed</returns>
+  /// <remarks>
+  ///   With 1, 2 or 4 channels, each lane of a 16 byte register always holds the same
+  ///   channel, so minimum and maximum can be tracked per lane and only need to be
+  ///   combined by channel at the end of the row.
+  /// </remarks>
+  std::size_t accumulateBytesSimd(
+    const std::uint8_t *pixels, std::size_t width, std::size_t channelCount, Totals &totals
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2) || defined(NUCLEX_PIXELS_HAVE_NEON)
+    if(channelCount == 3) {
+      return 0;
+    }
+
+    std::uint8_t lanes[4][16];
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      for(std::size_t lane = 0; lane < 16; ++lane) {
+        lanes[channel][lane] = ((lane % channelCount) == channel) ? 0xFF : 0x00;
+      }
+    }
+
+    std::size_t byteCount = width * channelCount;
+    std::size_t index = 0;
+
+    std::uint8_t minimumLanes[16], maximumLanes[16];
+    std::uint64_t sums[4] = { 0, 0, 0, 0 };
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      __m128i masks[4];
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        masks[channel] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes[channel]));
+      }
+
+      // The sum of absolute differences against zero adds up 8 bytes into a 64 bit lane,
+      // masking the other channels away first gives the sum of one channel
+      const __m128i zero = _mm_setzero_si128();
+      __m128i minimum = _mm_set1_epi8(static_cast<char>(0xFF));
+      __m128i maximum = zero;
+      __m128i channelSums[4] = { zero, zero, zero, zero };
+      for(; index + 16 <= byteCount; index += 16) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + index));
+        minimum = _mm_min_epu8(minimum, values);
+        maximum = _mm_max_epu8(maximum, values);
+        for(std::size_t channel = 0; channel < channelCount; ++channel) {
+          channelSums[channel] = _mm_add_epi64(
+            channelSums[channel], _mm_sad_epu8(_mm_and_si128(values, masks[channel]), zero)
+          );
+        }
+      }
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(minimumLanes), minimum);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(maximumLanes), maximum);
+      for(std::size_t channel = 0; channel < channelCount; ++channel) {
+        std::uint64_t halves[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(halves), channelSums[channel]);
+        sums[channel] = halves[0] + halves[1];
+      }
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    {
+      uint8x16_t masks[4];
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        masks[channel] = vld1q_u8(lanes[channel]);
+      }
+
+      // Pairwise additions widen the bytes of each channel into 32 bit lanes. A lane
+      // receives at most 1020 per iteration, so rows would need billions of pixels
+      // to overflow it.
+      uint8x16_t minimum = vdupq_n_u8(0xFF);
+      uint8x16_t maximum = vdupq_n_u8(0x00);
+      uint32x4_t channelSums[4] = {
+        vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0)
+      };
+      for(; index + 16 <= byteCount; index += 16) {
+        uint8x16_t values = vld1q_u8(pixels + index);
+        minimum = vminq_u8(minimum, values);
+        maximum = vmaxq_u8(maximum, values);
+        for(std::size_t channel = 0; channel < channelCount; ++channel) {
+          channelSums[channel] = vpadalq_u16(
+            channelSums[channel], vpaddlq_u8(vandq_u8(values, masks[channel]))
+          );
+        }
+      }
+
+      vst1q_u8(minimumLanes, minimum);
+      vst1q_u8(maximumLanes, maximum);
+      for(std::size_t channel = 0; channel < channelCount; ++channel) {
+        std::uint32_t quarters[4];
+        vst1q_u32(quarters, channelSums[channel]);
+        sums[channel] = (
+          static_cast<std::uint64_t>(quarters[0]) + quarters[1] + quarters[2] + quarters[3]
+        );
+      }
+    }
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_SSE2) || defined(NUCLEX_PIXELS_HAVE_NEON)
+    if(index == 0) {
+      return 0;
+    }
+
+    for(std::size_t channel = 0; channel < channelCount; ++channel) {
+      std::uint8_t minimum = 0xFF, maximum = 0x00;
+      for(std::size_t lane = channel; lane < 16; lane += channelCount) {
+        minimum = std::min(minimum, minimumLanes[lane]);
+        maximum = std::max(maximum, maximumLanes[lane]);
+      }
+      mergeChannel(
+        totals, channel,
+        static_cast<double>(minimum), static_cast<double>(maximum),
+        static_cast<double>(sums[channel])
+      );
+    }
+
+    return index / channelCount;
+#else
+    (void)pixels;
+    (void)width;
+    (void)channelCount;
+    (void)totals;
+    return 0;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Updates the running totals with a row of float pixels using SIMD</summary>
+  /// <param name="values">Values of the pixels' channels</param>
+  /// <param name="width">Number of pixels in the row</param>
+  /// <param name="channelCount">Number of channels in each pixel</param>
+  /// <param name="totals">Running totals that will be updated</param>
+  /// <returns>The number of pixels that have been processed</returns>
+  std::size_t accumulateFloatsSimd(
+    const float *values, std::size_t width, std::size_t channelCount, Totals &totals
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2) || defined(NUCLEX_PIXELS_HAVE_NEON)
+    if(channelCount == 3) {
+      return 0;
+    }
+
+    std::size_t valueCount = width * channelCount;
+    std::size_t index = 0;
+
+    float minimumLanes[4], maximumLanes[4];
+    double sumLanes[4];
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      __m128 minimum = _mm_set1_ps(std::numeric_limits<float>::infinity());
+      __m128 maximum = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+      __m128d lowerSums = _mm_setzero_pd();
+      __m128d upperSums = _mm_setzero_pd();
+      for(; index + 4 <= valueCount; index += 4) {
+        __m128 four = _mm_loadu_ps(values + index);
+        minimum = _mm_min_ps(minimum, four);
+        maximum = _mm_max_ps(maximum, four);
+        lowerSums = _mm_add_pd(lowerSums, _mm_cvtps_pd(four));
+        upperSums = _mm_add_pd(upperSums, _mm_cvtps_pd(_mm_movehl_ps(four, four)));
+      }
+
+      _mm_storeu_ps(minimumLanes, minimum);
+      _mm_storeu_ps(maximumLanes, maximum);
+      _mm_storeu_pd(sumLanes, lowerSums);
+      _mm_storeu_pd(sumLanes + 2, upperSums);
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    {
+      // Sums are added up in single precision for a limited number of iterations
+      // at a time, then carried over into double precision
+      const std::size_t FlushInterval = 256 * 4;
+
+      float32x4_t minimum = vdupq_n_f32(std::numeric_limits<float>::infinity());
+      float32x4_t maximum = vdupq_n_f32(-std::numeric_limits<float>::infinity());
+      for(std::size_t lane = 0; lane < 4; ++lane) {
+        sumLanes[lane] = 0.0;
+      }
+      while(index + 4 <= valueCount) {
+        std::size_t end = std::min(index + FlushInterval, valueCount);
+        float32x4_t sums = vdupq_n_f32(0.0f);
+        for(; index + 4 <= end; index += 4) {
+          float32x4_t four = vld1q_f32(values + index);
+          minimum = vminq_f32(minimum, four);
+          maximum = vmaxq_f32(maximum, four);
+          sums = vaddq_f32(sums, four);
+        }
+
+        float partialSums[4];
+        vst1q_f32(partialSums, sums);
+        for(std::size_t lane = 0; lane < 4; ++lane) {
+          sumLanes[lane] += static_cast<double>(partialSums[lane]);
+        }
+      }
+
+      vst1q_f32(minimumLanes, minimum);
+      vst1q_f32(maximumLanes, maximum);
+    }
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_SSE2) || defined(NUCLEX_PIXELS_HAVE_NEON)
+    if(index == 0) {
+      return 0;
+    }
+
+    for(std::size_t lane = 0; lane < 4; ++lane) {
+      mergeChannel(
+        totals, lane % channelCount,
+        static_cast<double>(minimumLanes[lane]), static_cast<double>(maximumLanes[lane]),
+        sumLanes[lane]
+      );
+    }
+
+    return index / channelCount;
+#else
+    (void)values;
+    (void)width;
+    (void)channelCount;
+    (void)totals;
+    return 0;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Updates the running totals with a row of float pixels</summary>
+  /// <param name="values">Values of the pixels' channels</param>
+  /// <param name="width">Number of pixels in the row</param>
+  /// <param name="channelCount">Number of channels in each pixel</param>
+  /// <param name="totals">Running totals that will be updated</param>
+  void accumulateFloats(
+    const float *values, std::size_t width, std::size_t channelCount, Totals &totals
+  ) {
+    std::size_t x = accumulateFloatsSimd(values, width, channelCount, totals);
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    accumulateValues<float, double>(values, x, width, channelCount, totals);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Updates the running totals with all rows of a bitmap</summary>
+  /// <param name="layout">Channel layout of the bitmap's pixel format</param>
+  /// <param name="memory">Bitmap memory whose pixels will be looked at</param>
+  /// <param name="totals">Running totals that will be updated</param>
+  void accumulateRows(
+    const AnalysisLayout &layout, const Nuclex::Pixels::BitmapMemory &memory, Totals &totals
+  ) {
+    std::vector<float> chunk;
+    if(layout.Type == ChannelType::Half) {
+      chunk.resize(ChunkSize * layout.ChannelCount);
+    }
+
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(memory.Pixels) + (
+        static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+      );
+
+      switch(layout.Type) {
+        case ChannelType::UnsignedByte: {
+          std::size_t x = accumulateBytesSimd(row, memory.Width, layout.ChannelCount, totals);
+
+          // Scalar loop for the remaining pixels or if no SIMD instructions are available
+          accumulateValues<std::uint8_t, std::uint64_t>(
+            row, x, memory.Width, layout.ChannelCount, totals
+          );
+          break;
+        }
+        case ChannelType::UnsignedShort: {
+          accumulateValues<std::uint16_t, std::uint64_t>(
+            reinterpret_cast<const std::uint16_t *>(row), 0, memory.Width, layout.ChannelCount,
+            totals
+          );
+          break;
+        }
+        case ChannelType::Half: {
+          const Nuclex::Pixels::Half *halfs = reinterpret_cast<const Nuclex::Pixels::Half *>(row);
+          for(std::size_t x = 0; x < memory.Width; x += ChunkSize) {
+            std::size_t chunkWidth = std::min(ChunkSize, memory.Width - x);
+            Nuclex::Pixels::Half::ConvertToFloats(
+              halfs + x * layout.ChannelCount, chunk.data(), chunkWidth * layout.ChannelCount
+            );
+            accumulateFloats(chunk.data(), chunkWidth, layout.ChannelCount, totals);
+          }
+          break;
+        }
+        case ChannelType::Float: {
+          accumulateFloats(
+            reinterpret_cast<const float *>(row), memory.Width, layout.ChannelCount, totals
+          );
+          break;
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns the running totals of all bands into the statistics of a bitmap</summary>
+  /// <param name="layout">Channel layout of the bitmap's pixel format</param>
+  /// <param name="pixelCount">Number of pixels in the bitmap</param>
+  /// <param name="bandTotals">Running totals of each band in the bitmap</param>
+  /// <returns>The statistics of the bitmap</returns>
+  Nuclex::Pixels::BitmapStatistics summarize(
+    const AnalysisLayout &layout, std::size_t pixelCount, const std::vector<Totals> &bandTotals
+  ) {
+    Nuclex::Pixels::BitmapStatistics statistics = Nuclex::Pixels::BitmapStatistics();
+    statistics.PixelCount = pixelCount;
+    statistics.ChannelCount = layout.ChannelCount;
+    if(pixelCount == 0) {
+      return statistics;
+    }
+
+    // Merge the bands in order so that the sums do not depend on the order in
+    // which the bands have been processed
+    Totals totals;
+    resetTotals(totals);
+    for(std::size_t index = 0; index < bandTotals.size(); ++index) {
+      for(std::size_t channel = 0; channel < layout.ChannelCount; ++channel) {
+        mergeChannel(
+          totals, channel,
+          bandTotals[index].Minimum[channel],
+          bandTotals[index].Maximum[channel],
+          bandTotals[index].Sum[channel]
+        );
+      }
+    }
+
+    double factor = getNormalizationFactor(layout.Type);
+    for(std::size_t channel = 0; channel < layout.ChannelCount; ++channel) {
+      Nuclex::Pixels::ChannelStatistics &channelStatistics = statistics.Channels[channel];
+      channelStatistics.Minimum = totals.Minimum[channel] * factor;
+      channelStatistics.Maximum = totals.Maximum[channel] * factor;
+      channelStatistics.Sum = totals.Sum[channel] * factor;
+      channelStatistics.Mean = channelStatistics.Sum / static_cast<double>(pixelCount);
+    }
+
+    return statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the bin of a histogram a value falls into</summary>
+  /// <param name="value">Value whose bin will be determined</param>
+  /// <param name="minimum">Lower end of the first bin's value range</param>
+  /// <param name="scale">Number of bins per unit of value</param>
+  /// <param name="binCount">Total number of bins in the histogram</param>
+  /// <returns>The index of the bin the value falls into</returns>
+  inline std::size_t getBin(float value, float minimum, float scale, std::size_t binCount) {
+    float position = (value - minimum) * scale;
+    if(!(position > 0.0f)) { // Also catches NaNs
+      return 0;
+    } else if(position >= static_cast<float>(binCount)) {
+      return binCount - 1;
+    } else {
+      return static_cast<std::size_t>(position);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the values of one channel in a row into interleaved sub-histograms</summary>
+  /// <typeparam name="TValue">Type of the values in each channel</typeparam>
+  /// <typeparam name="TGetBin">Callback that returns the bin of a value</typeparam>
+  /// <param name="values">First value of the channel that will be counted</param>
+  /// <param name="width">Number of pixels in the row</param>
+  /// <param name="channelCount">Number of channels in each pixel</param>
+  /// <param name="subHistograms">Sub-histograms that will be counted into</param>
+  /// <param name="binCount">Number of bins in each sub-histogram</param>
+  /// <param name="getBin">Callback that will be invoked to look up each value's bin</param>
+  template<typename TValue, typename TGetBin>
+  void countValues(
+    const TValue *values, std::size_t width, std::size_t channelCount,
+    std::size_t *subHistograms, std::size_t binCount, TGetBin getBin
+  ) {
+    std::size_t *first = subHistograms;
+    std::size_t *second = first + binCount;
+    std::size_t *third = second + binCount;
+    std::size_t *fourth = third + binCount;
+
+    std::size_t x = 0;
+    for(; x + SubHistogramCount <= width; x += SubHistogramCount) {
+      const TValue *four = values + x * channelCount;
+      ++first[getBin(four[0])];
+      ++second[getBin(four[channelCount])];
+      ++third[getBin(four[channelCount * 2])];
+      ++fourth[getBin(four[channelCount * 3])];
+    }
+    for(; x < width; ++x) {
+      ++first[getBin(values[x * channelCount])];
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the bins a histogram is built from</summary>
+  struct HistogramSetup {
+
+    /// <summary>Channel layout of the bitmap's pixel format</summary>
+    public: const AnalysisLayout *Layout;
+    /// <summary>Index of the channel that will be counted</summary>
+    public: std::size_t ChannelIndex;
+    /// <summary>Number of bins in the histogram</summary>
+    public: std::size_t BinCount;
+    /// <summary>Lower end of the first bin's value range</summary>
+    public: float Minimum;
+    /// <summary>Number of bins per unit of value</summary>
+    public: float Scale;
+    /// <summary>Bin of each value for integer channels</summary>
+    public: std::vector<std::size_t> BinLookup;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks the histogram parameters and prepares the bins</summary>
+  /// <param name="pixelFormat">Pixel format of the bitmap the histogram is built for</param>
+  /// <param name="channelIndex">Index of the channel that will be counted</param>
+  /// <param name="binCount">Number of bins in the histogram</param>
+  /// <param name="minimum">Lower end of the first bin's value range</param>
+  /// <param name="maximum">Upper end of the last bin's value range</param>
+  /// <returns>The setup describing the bins of the histogram</returns>
+  HistogramSetup setUpHistogram(
+    Nuclex::Pixels::PixelFormat pixelFormat, std::size_t channelIndex,
+    std::size_t binCount, float minimum, float maximum
+  ) {
+    HistogramSetup setup;
+    setup.Layout = &requireAnalysisLayout(pixelFormat);
+    if(channelIndex >= setup.Layout->ChannelCount) {
+      throw std::invalid_argument(u8"Channel index is outside of the pixel format's channels");
+    }
+    if(binCount == 0) {
+      throw std::invalid_argument(u8"Histogram needs to have at least one bin");
+    }
+    if(!(maximum > minimum)) {
+      throw std::invalid_argument(u8"Histogram maximum needs to be larger than its minimum");
+    }
+
+    setup.ChannelIndex = channelIndex;
+    setup.BinCount = binCount;
+    setup.Minimum = minimum;
+    setup.Scale = static_cast<float>(binCount) / (maximum - minimum);
+
+    // Integer channels have few enough different values to look their bins up
+    std::size_t valueCount = 0;
+    if(setup.Layout->Type == ChannelType::UnsignedByte) {
+      valueCount = 256;
+    } else if(setup.Layout->Type == ChannelType::UnsignedShort) {
+      valueCount = 65536;
+    }
+    if(valueCount > 0) {
+      float factor = static_cast<float>(getNormalizationFactor(setup.Layout->Type));
+      setup.BinLookup.resize(valueCount);
+      for(std::size_t value = 0; value < valueCount; ++value) {
+        setup.BinLookup[value] = getBin(
+          static_cast<float>(value) * factor, setup.Minimum, setup.Scale, setup.BinCount
+        );
+      }
+    }
+
+    return setup;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the values of all rows of a bitmap into a histogram</summary>
+  /// <param name="setup">Setup describing the bins of the histogram</param>
+  /// <param name="memory">Bitmap memory whose pixels will be counted</param>
+  /// <param name="bins">Bins that will receive the counts</param>
+  void countRows(
+    const HistogramSetup &setup, const Nuclex::Pixels::BitmapMemory &memory, std::size_t *bins
+  ) {
+    const std::size_t channelCount = setup.Layout->ChannelCount;
+    const std::size_t binCount = setup.BinCount;
+    std::vector<std::size_t> subHistograms(binCount * SubHistogramCount, 0);
+
+    const std::size_t *binLookup = setup.BinLookup.data();
+    auto lookUpBin = [binLookup](std::size_t value) { return binLookup[value]; };
+    auto calculateBin = [&setup](float value) {
+      return getBin(value, setup.Minimum, setup.Scale, setup.BinCount);
+    };
+
+    std::vector<float> chunk;
+    if(setup.Layout->Type == ChannelType::Half) {
+      chunk.resize(ChunkSize * channelCount);
+    }
+
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(memory.Pixels) + (
+        static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+      );
+
+      switch(setup.Layout->Type) {
+        case ChannelType::UnsignedByte: {
+          countValues(
+            row + setup.ChannelIndex, memory.Width, channelCount,
+            subHistograms.data(), binCount, lookUpBin
+          );
+          break;
+        }
+        case ChannelType::UnsignedShort: {
+          countValues(
+            reinterpret_cast<const std::uint16_t *>(row) + setup.ChannelIndex,
+            memory.Width, channelCount, subHistograms.data(), binCount, lookUpBin
+          );
+          break;
+        }
+        case ChannelType::Half: {
+          const Nuclex::Pixels::Half *halfs = reinterpret_cast<const Nuclex::Pixels::Half *>(row);
+          for(std::size_t x = 0; x < memory.Width; x += ChunkSize) {
+            std::size_t chunkWidth = std::min(ChunkSize, memory.Width - x);
+            Nuclex::Pixels::Half::ConvertToFloats(
+              halfs + x * channelCount, chunk.data(), chunkWidth * channelCount
+            );
+            countValues(
+              chunk.data() + setup.ChannelIndex, chunkWidth, channelCount,
+              subHistograms.data(), binCount, calculateBin
+            );
+          }
+          break;
+        }
+        case ChannelType::Float: {
+          countValues(
+            reinterpret_cast<const float *>(row) + setup.ChannelIndex,
+            memory.Width, channelCount, subHistograms.data(), binCount, calculateBin
+          );
+          break;
+        }
+      }
+    }
+
+    for(std::size_t bin = 0; bin < binCount; ++bin) {
+      bins[bin] += (
+        subHistograms[bin] +
+        subHistograms[binCount + bin] +
+        subHistograms[binCount * 2 + bin] +
+        subHistograms[binCount * 3 + bin]
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the luminance of a row of pixels</summary>
+  /// <param name="pixels">Pixels in R32_G32_B32_A32_Float_Native32 format</param>
+  /// <param name="luminances">Receives the luminance of each pixel</param>
+  /// <param name="count">Number of pixels whose luminance will be calculated</param>
+  /// <param name="weights">Weights of the red, green and blue channels</param>
+  void calculateLuminances(
+    const float *pixels, float *luminances, std::size_t count, const float weights[3]
+  ) {
+    std::size_t index = 0;
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    const __m128 redWeight = _mm_set1_ps(weights[0]);
+    const __m128 greenWeight = _mm_set1_ps(weights[1]);
+    const __m128 blueWeight = _mm_set1_ps(weights[2]);
+    for(; index + 4 <= count; index += 4) {
+      __m128 red = _mm_loadu_ps(pixels + index * 4);
+      __m128 green = _mm_loadu_ps(pixels + index * 4 + 4);
+      __m128 blue = _mm_loadu_ps(pixels + index * 4 + 8);
+      __m128 alpha = _mm_loadu_ps(pixels + index * 4 + 12);
+      _MM_TRANSPOSE4_PS(red, green, blue, alpha);
+
+      __m128 luminance = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(red, redWeight), _mm_mul_ps(green, greenWeight)),
+        _mm_mul_ps(blue, blueWeight)
+      );
+      _mm_storeu_ps(luminances + index, luminance);
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    for(; index + 4 <= count; index += 4) {
+      float32x4x4_t channels = vld4q_f32(pixels + index * 4);
+      float32x4_t luminance = vmulq_n_f32(channels.val[0], weights[0]);
+      luminance = vmlaq_n_f32(luminance, channels.val[1], weights[1]);
+      luminance = vmlaq_n_f32(luminance, channels.val[2], weights[2]);
+      vst1q_f32(luminances + index, luminance);
+    }
+#endif
+    for(; index < count; ++index) {
+      luminances[index] = (
+        pixels[index * 4] * weights[0] +
+        pixels[index * 4 + 1] * weights[1] +
+        pixels[index * 4 + 2] * weights[2]
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reduces a bitmap to a small grid of average luminance values</summary>
+  /// <param name="memory">Bitmap memory whose pixels will be reduced</param>
+  /// <param name="grid">Receives the average luminance of each grid cell</param>
+  /// <param name="gridWidth">Number of grid cells horizontally</param>
+  /// <param name="gridHeight">Number of grid cells vertically</param>
+  /// <remarks>
+  ///   Each grid cell averages the pixels that fall into it. If the bitmap is smaller
+  ///   than the grid, neighboring cells will share the same pixels.
+  /// </remarks>
+  void reduceToLuminanceGrid(
+    const Nuclex::Pixels::BitmapMemory &memory,
+    float *grid, std::size_t gridWidth, std::size_t gridHeight
+  ) {
+    using Nuclex::Pixels::PixelFormat;
+
+    const PixelFormat floatFormat = PixelFormat::R32_G32_B32_A32_Float_Native32;
+    if(!Nuclex::Pixels::PixelFormatConverter::CanConvert(memory.PixelFormat, floatFormat)) {
+      throw std::invalid_argument(u8"Bitmaps in this pixel format can not be hashed");
+    }
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"Empty bitmaps can not be hashed");
+    }
+
+    // Pixel formats with a single channel are grayscale and hold the luminance already
+    Nuclex::Pixels::Private::PixelFormatDescription description = (
+      Nuclex::Pixels::Private::DescribePixelFormat(memory.PixelFormat)
+    );
+    float weights[3] = { 0.299f, 0.587f, 0.114f };
+    if((description.BitCounts[1] == 0) && (description.BitCounts[2] == 0)) {
+      weights[0] = 1.0f;
+      weights[1] = 0.0f;
+      weights[2] = 0.0f;
+    }
+
+    std::vector<float> rowPixels(memory.Width * 4);
+    std::vector<float> rowLuminances(memory.Width);
+
+    for(std::size_t cellY = 0; cellY < gridHeight; ++cellY) {
+      std::size_t startY = cellY * memory.Height / gridHeight;
+      std::size_t endY = std::max(startY + 1, (cellY + 1) * memory.Height / gridHeight);
+
+      float *cells = grid + cellY * gridWidth;
+      std::fill(cells, cells + gridWidth, 0.0f);
+
+      for(std::size_t y = startY; y < endY; ++y) {
+        const std::uint8_t *row = static_cast<const std::uint8_t *>(memory.Pixels) + (
+          static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+        );
+        Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+          memory.PixelFormat, row, floatFormat, rowPixels.data(), memory.Width
+        );
+        calculateLuminances(rowPixels.data(), rowLuminances.data(), memory.Width, weights);
+
+        for(std::size_t cellX = 0; cellX < gridWidth; ++cellX) {
+          std::size_t startX = cellX * memory.Width / gridWidth;
+          std::size_t endX = std::max(startX + 1, (cellX + 1) * memory.Width / gridWidth);
+          for(std::size_t x = startX; x < endX; ++x) {
+            cells[cellX] += rowLuminances[x];
+          }
+        }
+      }
+
+      for(std::size_t cellX = 0; cellX < gridWidth; ++cellX) {
+        std::size_t startX = cellX * memory.Width / gridWidth;
+        std::size_t endX = std::max(startX + 1, (cellX + 1) * memory.Width / gridWidth);
+        cells[cellX] /= static_cast<float>((endX - startX) * (endY - startY));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BitmapAnalyzer::CanAnalyze(PixelFormat pixelFormat) {
+    return (findAnalysisLayout(pixelFormat) != nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapStatistics BitmapAnalyzer::GatherStatistics(const BitmapMemory &memory) {
+    const AnalysisLayout &layout = requireAnalysisLayout(memory.PixelFormat);
+
+    std::size_t pixelCount = memory.Width * memory.Height;
+    if(pixelCount == 0) {
+      return summarize(layout, 0, std::vector<Totals>());
+    }
+
+    // Go through the bitmap in the same bands as the multi-threaded variant so
+    // both produce exactly the same sums
+    std::size_t bandHeight = GetBandHeight(CountRequiredBytes(memory.PixelFormat, memory.Width));
+    std::size_t bandCount = (memory.Height + bandHeight - 1) / bandHeight;
+
+    std::vector<Totals> bandTotals(bandCount);
+    for(std::size_t index = 0; index < bandCount; ++index) {
+      std::size_t y = index * bandHeight;
+      std::size_t height = std::min(bandHeight, memory.Height - y);
+
+      resetTotals(bandTotals[index]);
+      accumulateRows(layout, GetBand(memory, y, height), bandTotals[index]);
+    }
+
+    return summarize(layout, pixelCount, bandTotals);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapStatistics BitmapAnalyzer::GatherStatistics(
+    const BitmapMemory &memory, ThreadPool &threadPool
+  ) {
+    const AnalysisLayout &layout = requireAnalysisLayout(memory.PixelFormat);
+
+    std::size_t pixelCount = memory.Width * memory.Height;
+    if(pixelCount == 0) {
+      return summarize(layout, 0, std::vector<Totals>());
+    }
+
+    std::size_t bandHeight = GetBandHeight(CountRequiredBytes(memory.PixelFormat, memory.Width));
+    std::size_t bandCount = (memory.Height + bandHeight - 1) / bandHeight;
+
+    std::vector<Totals> bandTotals(bandCount);
+    ForEachBandInParallel(
+      threadPool, memory,
+      [&layout, &bandTotals, bandHeight](const BitmapMemory &band, std::size_t y) {
+        Totals &totals = bandTotals[y / bandHeight];
+        resetTotals(totals);
+        accumulateRows(layout, band, totals);
+      }
+    );
+
+    return summarize(layout, pixelCount, bandTotals);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapAnalyzer::BuildHistogram(
+    const BitmapMemory &memory, std::size_t channelIndex,
+    std::size_t *bins, std::size_t binCount,
+    float minimum /* = 0.0f */, float maximum /* = 1.0f */
+  ) {
+    HistogramSetup setup = setUpHistogram(
+      memory.PixelFormat, channelIndex, binCount, minimum, maximum
+    );
+
+    std::fill(bins, bins + binCount, 0);
+    countRows(setup, memory, bins);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapAnalyzer::BuildHistogram(
+    const BitmapMemory &memory, std::size_t channelIndex,
+    std::size_t *bins, std::size_t binCount, ThreadPool &threadPool,
+    float minimum /* = 0.0f */, float maximum /* = 1.0f */
+  ) {
+    HistogramSetup setup = setUpHistogram(
+      memory.PixelFormat, channelIndex, binCount, minimum, maximum
+    );
+
+    std::fill(bins, bins + binCount, 0);
+
+    // Each band is counted into histograms of its own that are then added up under
+    // a lock. Additions of integers are exact, so the order does not matter.
+    std::mutex binMutex;
+    ForEachBandInParallel(
+      threadPool, memory,
+      [&setup, &binMutex, bins, binCount](const BitmapMemory &band, std::size_t) {
+        std::vector<std::size_t> bandBins(binCount, 0);
+        countRows(setup, band, bandBins.data());
+
+        std::lock_guard<std::mutex> binLock(binMutex);
+        for(std::size_t bin = 0; bin < binCount; ++bin) {
+          bins[bin] += bandBins[bin];
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t BitmapAnalyzer::ComputeDifferenceHash(const BitmapMemory &memory) {
+    float grid[9 * 8];
+    reduceToLuminanceGrid(memory, grid, 9, 8);
+
+    std::uint64_t hash = 0;
+    for(std::size_t y = 0; y < 8; ++y) {
+      for(std::size_t x = 0; x < 8; ++x) {
+        hash <<= 1;
+        if(grid[y * 9 + x] > grid[y * 9 + x + 1]) {
+          hash |= 1;
+        }
+      }
+    }
+
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t BitmapAnalyzer::ComputePerceptualHash(const BitmapMemory &memory) {
+    const std::size_t gridSize = PerceptualHashGridSize;
+    const std::size_t frequencyCount = PerceptualHashFrequencyCount;
+
+    std::vector<float> grid(gridSize * gridSize);
+    reduceToLuminanceGrid(memory, grid.data(), gridSize, gridSize);
+
+    // Cosine terms of the DCT-II for frequencies 1 to 8. Frequency 0 is the average
+    // brightness, which only adds an offset to everything and is skipped.
+    const double pi = 3.14159265358979323846;
+    float cosines[PerceptualHashFrequencyCount][PerceptualHashGridSize];
+    for(std::size_t frequency = 0; frequency < frequencyCount; ++frequency) {
+      for(std::size_t index = 0; index < gridSize; ++index) {
+        cosines[frequency][index] = static_cast<float>(
+          std::cos(pi * static_cast<double>((2 * index + 1) * (frequency + 1)) / (2 * gridSize))
+        );
+      }
+    }
+
+    // The DCT is separable, so transform the rows first and the columns of
+    // the results after that. Only the needed frequencies are calculated.
+    float rowFrequencies[PerceptualHashGridSize][PerceptualHashFrequencyCount];
+    for(std::size_t y = 0; y < gridSize; ++y) {
+      for(std::size_t frequency = 0; frequency < frequencyCount; ++frequency) {
+        float sum = 0.0f;
+        for(std::size_t x = 0; x < gridSize; ++x) {
+          sum += grid[y * gridSize + x] * cosines[frequency][x];
+        }
+        rowFrequencies[y][frequency] = sum;
+      }
+    }
+
+    float coefficients[PerceptualHashFrequencyCount * PerceptualHashFrequencyCount];
+    for(std::size_t frequencyY = 0; frequencyY < frequencyCount; ++frequencyY) {
+      for(std::size_t frequencyX = 0; frequencyX < frequencyCount; ++frequencyX) {
+        float sum = 0.0f;
+        for(std::size_t y = 0; y < gridSize; ++y) {
+          sum += rowFrequencies[y][frequencyX] * cosines[frequencyY][y];
+        }
+        coefficients[frequencyY * frequencyCount + frequencyX] = sum;
+      }
+    }
+
+    // Threshold the coefficients at their median so that about half of the bits are set
+    const std::size_t coefficientCount = frequencyCount * frequencyCount;
+    float sorted[PerceptualHashFrequencyCount * PerceptualHashFrequencyCount];
+    std::copy(coefficients, coefficients + coefficientCount, sorted);
+    std::nth_element(sorted, sorted + coefficientCount / 2, sorted + coefficientCount);
+    float upperMedian = sorted[coefficientCount / 2];
+    float lowerMedian = *std::max_element(sorted, sorted + coefficientCount / 2);
+    float median = (lowerMedian + upperMedian) / 2.0f;
+
+    std::uint64_t hash = 0;
+    for(std::size_t index = 0; index < coefficientCount; ++index) {
+      hash <<= 1;
+      if(coefficients[index] > median) {
+        hash |= 1;
+      }
+    }
+
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t BitmapAnalyzer::CountDifferentBits(std::uint64_t hash, std::uint64_t otherHash) {
+    return std::bitset<64>(hash ^ otherHash).count();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
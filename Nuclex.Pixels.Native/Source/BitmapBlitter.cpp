@@ -0,0 +1,357 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapBlitter.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+
+#include <algorithm> // for std::min()
+#include <cstdint>
+#include <cstring> // for std::memcpy(), std::memset(), std::memcmp()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a rectangular area within a bitmap as bitmap memory</summary>
+  /// <param name="memory">Bitmap memory the area will be taken from</param>
+  /// <param name="x">X coordinate of the area's left border</param>
+  /// <param name="y">Y coordinate of the area's upper border</param>
+  /// <param name="width">Width of the area in pixels</param>
+  /// <param name="height">Height of the area in pixels</param>
+  /// <returns>Bitmap memory covering only the pixels inside the area</returns>
+  Nuclex::Pixels::BitmapMemory getArea(
+    const Nuclex::Pixels::BitmapMemory &memory,
+    std::size_t x, std::size_t y, std::size_t width, std::size_t height
+  ) {
+    Nuclex::Pixels::BitmapMemory area(memory);
+    area.Width = width;
+    area.Height = height;
+    area.Pixels = static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    ) + Nuclex::Pixels::CountRequiredBytes(memory.PixelFormat, x);
+    return area;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the rows of a bitmap lie back to back in memory</summary>
+  /// <param name="memory">Bitmap memory that will be checked</param>
+  /// <returns>True if the bitmap's rows have no padding between them</returns>
+  bool hasUnpaddedRows(const Nuclex::Pixels::BitmapMemory &memory) {
+    return (
+      memory.Stride == static_cast<int>(
+        Nuclex::Pixels::CountRequiredBytes(memory.PixelFormat, memory.Width)
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Retrieves the address of a row in a bitmap</summary>
+  /// <param name="memory">Bitmap memory holding the row</param>
+  /// <param name="y">Index of the row whose address will be returned</param>
+  /// <returns>The address of the first pixel in the row</returns>
+  std::uint8_t *getRow(const Nuclex::Pixels::BitmapMemory &memory, std::size_t y) {
+    return static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sets all bytes of a bitmap's pixels to the same value</summary>
+  /// <param name="memory">Bitmap memory whose pixels will be overwritten</param>
+  /// <param name="value">Value all bytes will be set to</param>
+  void setAllBytes(const Nuclex::Pixels::BitmapMemory &memory, std::uint8_t value) {
+    std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+      memory.PixelFormat, memory.Width
+    );
+    if(hasUnpaddedRows(memory)) {
+      std::memset(memory.Pixels, value, rowByteCount * memory.Height);
+      return;
+    }
+
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::memset(getRow(memory, y), value, rowByteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks that two bitmaps can be compared pixel by pixel</summary>
+  /// <param name="bitmap">Bitmap memory that will be compared</param>
+  /// <param name="otherBitmap">Other bitmap memory the first will be compared to</param>
+  /// <returns>True if both bitmaps have the same size and pixel format</returns>
+  bool haveSameLayout(
+    const Nuclex::Pixels::BitmapMemory &bitmap, const Nuclex::Pixels::BitmapMemory &otherBitmap
+  ) {
+    return (
+      (bitmap.Width == otherBitmap.Width) &&
+      (bitmap.Height == otherBitmap.Height) &&
+      (bitmap.PixelFormat == otherBitmap.PixelFormat)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks for the first row in which two bitmaps differ</summary>
+  /// <param name="bitmap">Bitmap memory that will be compared</param>
+  /// <param name="otherBitmap">Other bitmap memory the first will be compared to</param>
+  /// <returns>The index of the first differing row or the height if there is none</returns>
+  std::size_t findFirstDifferentRow(
+    const Nuclex::Pixels::BitmapMemory &bitmap, const Nuclex::Pixels::BitmapMemory &otherBitmap
+  ) {
+    std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+      bitmap.PixelFormat, bitmap.Width
+    );
+    for(std::size_t y = 0; y < bitmap.Height; ++y) {
+      if(std::memcmp(getRow(bitmap, y), getRow(otherBitmap, y), rowByteCount) != 0) {
+        return y;
+      }
+    }
+
+    return bitmap.Height;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Blit(
+    const BitmapMemory &source,
+    const BitmapMemory &target, std::size_t targetX /* = 0 */, std::size_t targetY /* = 0 */
+  ) {
+    Blit(source, Rectangle(0, 0, source.Width, source.Height), target, targetX, targetY);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Blit(
+    const BitmapMemory &source, const Rectangle &sourceRegion,
+    const BitmapMemory &target, std::size_t targetX, std::size_t targetY
+  ) {
+    bool isInsideSource = (
+      (sourceRegion.MinX <= sourceRegion.MaxX) && (sourceRegion.MaxX <= source.Width) &&
+      (sourceRegion.MinY <= sourceRegion.MaxY) && (sourceRegion.MaxY <= source.Height)
+    );
+    if(!isInsideSource) {
+      throw std::invalid_argument(u8"Region to copy lies outside of the source bitmap");
+    }
+
+    std::size_t width = sourceRegion.MaxX - sourceRegion.MinX;
+    std::size_t height = sourceRegion.MaxY - sourceRegion.MinY;
+    bool fitsIntoTarget = (
+      (targetX <= target.Width) && (width <= target.Width - targetX) &&
+      (targetY <= target.Height) && (height <= target.Height - targetY)
+    );
+    if(!fitsIntoTarget) {
+      throw std::invalid_argument(u8"Region to copy does not fit into the target bitmap");
+    }
+    if((width == 0) || (height == 0)) {
+      return;
+    }
+
+    BitmapMemory sourceArea = getArea(
+      source, sourceRegion.MinX, sourceRegion.MinY, width, height
+    );
+    BitmapMemory targetArea = getArea(target, targetX, targetY, width, height);
+
+    // Different pixel formats need to be converted, the converter picks the fastest
+    // kernel for the combination and walks over the rows itself
+    if(source.PixelFormat != target.PixelFormat) {
+      PixelFormatConverter::Convert(sourceArea, targetArea);
+      return;
+    }
+
+    // If the rows are back to back in both bitmaps, all of them can be copied at once
+    std::size_t rowByteCount = CountRequiredBytes(source.PixelFormat, width);
+    bool isContiguous = (
+      (source.Stride == target.Stride) &&
+      (source.Stride == static_cast<int>(rowByteCount))
+    );
+    if(isContiguous) {
+      std::memcpy(targetArea.Pixels, sourceArea.Pixels, rowByteCount * height);
+      return;
+    }
+
+    const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(sourceArea.Pixels);
+    std::uint8_t *targetRow = static_cast<std::uint8_t *>(targetArea.Pixels);
+    for(std::size_t y = 0; y < height; ++y) {
+      std::memcpy(targetRow, sourceRow, rowByteCount);
+      sourceRow += source.Stride;
+      targetRow += target.Stride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Blit(
+    const BitmapMemory &source,
+    Bitmap &target, std::size_t targetX /* = 0 */, std::size_t targetY /* = 0 */
+  ) {
+    Blit(source, Rectangle(0, 0, source.Width, source.Height), target, targetX, targetY);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Blit(
+    const BitmapMemory &source, const Rectangle &sourceRegion,
+    Bitmap &target, std::size_t targetX, std::size_t targetY
+  ) {
+    Rectangle targetRegion = Rectangle::FromPositionAndSize(
+      targetX, targetY,
+      sourceRegion.MaxX - sourceRegion.MinX, sourceRegion.MaxY - sourceRegion.MinY
+    );
+    Blit(source, sourceRegion, target.AccessMutable(targetRegion), targetX, targetY);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Fill(const BitmapMemory &target, const ColorModels::RgbColor &color) {
+    std::uint8_t pixel[16];
+    PixelFormatConverter::EncodeColor(color, target.PixelFormat, pixel);
+    Fill(target, pixel);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Fill(const BitmapMemory &target, const void *pixel) {
+    std::size_t bitsPerPixel = CountBitsPerPixel(target.PixelFormat);
+    if((bitsPerPixel % 8) != 0) {
+      throw std::invalid_argument(u8"Bitmaps in this pixel format can not be filled");
+    }
+    if((target.Width == 0) || (target.Height == 0)) {
+      return;
+    }
+
+    // If all bytes of the pixel are the same (black, white, fully transparent or
+    // any gray in 8 bit formats), memset() can do the work
+    const std::uint8_t *pixelBytes = static_cast<const std::uint8_t *>(pixel);
+    std::size_t bytesPerPixel = bitsPerPixel / 8;
+    bool isUniform = true;
+    for(std::size_t index = 1; index < bytesPerPixel; ++index) {
+      if(pixelBytes[index] != pixelBytes[0]) {
+        isUniform = false;
+        break;
+      }
+    }
+    if(isUniform) {
+      setAllBytes(target, pixelBytes[0]);
+      return;
+    }
+
+    // Build one row of pixels by doubling the filled area until the row is complete,
+    // then copy the finished row into all rows of the bitmap
+    std::size_t rowByteCount = bytesPerPixel * target.Width;
+    std::vector<std::uint8_t> row(rowByteCount);
+    std::memcpy(row.data(), pixelBytes, bytesPerPixel);
+    for(std::size_t filled = bytesPerPixel; filled < rowByteCount; filled *= 2) {
+      std::memcpy(row.data() + filled, row.data(), std::min(filled, rowByteCount - filled));
+    }
+
+    for(std::size_t y = 0; y < target.Height; ++y) {
+      std::memcpy(getRow(target, y), row.data(), rowByteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Fill(Bitmap &target, const ColorModels::RgbColor &color) {
+    Fill(target.AccessMutable(), color);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Clear(const BitmapMemory &target) {
+    setAllBytes(target, 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapBlitter::Clear(Bitmap &target) {
+    Clear(target.AccessMutable());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BitmapBlitter::AreEqual(const BitmapMemory &bitmap, const BitmapMemory &otherBitmap) {
+    if(!haveSameLayout(bitmap, otherBitmap)) {
+      return false;
+    }
+
+    // Without padding and with both bitmaps facing the same way, one memcmp() will do
+    bool bothContiguous = (
+      (bitmap.Stride == otherBitmap.Stride) && hasUnpaddedRows(bitmap)
+    );
+    if(bothContiguous) {
+      return (
+        std::memcmp(
+          bitmap.Pixels, otherBitmap.Pixels,
+          CountRequiredBytes(bitmap.PixelFormat, bitmap.Width) * bitmap.Height
+        ) == 0
+      );
+    }
+
+    return (findFirstDifferentRow(bitmap, otherBitmap) == bitmap.Height);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BitmapBlitter::FindFirstDifference(
+    const BitmapMemory &bitmap, const BitmapMemory &otherBitmap,
+    std::size_t &x, std::size_t &y
+  ) {
+    if(!haveSameLayout(bitmap, otherBitmap)) {
+      throw std::invalid_argument(
+        u8"Bitmaps need to have the same size and pixel format to be compared"
+      );
+    }
+
+    std::size_t row = findFirstDifferentRow(bitmap, otherBitmap);
+    if(row == bitmap.Height) {
+      return false;
+    }
+
+    // Look for the byte that differs, then work out which pixel it belongs to
+    const std::uint8_t *bytes = getRow(bitmap, row);
+    const std::uint8_t *otherBytes = getRow(otherBitmap, row);
+    std::size_t index = 0;
+    while(bytes[index] == otherBytes[index]) {
+      ++index;
+    }
+
+    x = index * 8 / CountBitsPerPixel(bitmap.PixelFormat);
+    y = row;
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,673 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapFilter.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "FilterHelpers.h"
+
+#include <algorithm> // for std::copy_n(), std::fill(), std::min(), std::max(), std::swap()
+#include <cmath> // for std::sqrt(), std::floor(), std::round()
+#include <cstdint>
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+#include <vector> // for std::vector
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of box passes used to approximate a Gaussian blur</summary>
+  const std::size_t GaussianBoxPassCount = 3;
+
+  /// <summary>Width of the column strips the vertical box passes run in, in pixels</summary>
+  /// <remarks>
+  ///   The sliding window walks down each strip, keeping the running sum and the rows
+  ///   it touches (one kilobyte per row at this width) in the L1 cache.
+  /// </remarks>
+  const std::size_t StripWidth = 64;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that a list of kernel weights has a center weight</summary>
+  /// <param name="weights">Weights that will be checked</param>
+  void requireOddWeightCount(const std::vector<float> &weights) {
+    if((weights.size() % 2) == 0) {
+      throw std::invalid_argument(u8"Kernel weights need to be an odd number of weights");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs a task for each index, in parallel if a thread pool is provided</summary>
+  /// <typeparam name="TTask">Callable object that will be run for each index</typeparam>
+  /// <param name="threadPool">Thread pool that will run the tasks, can be null</param>
+  /// <param name="taskCount">Number of times the task will be run</param>
+  /// <param name="task">Task that will be invoked with each index</param>
+  template<typename TTask>
+  void forEachTask(
+    Nuclex::Pixels::ThreadPool *threadPool, std::size_t taskCount, TTask &&task
+  ) {
+    if(threadPool == nullptr) {
+      for(std::size_t index = 0; index < taskCount; ++index) {
+        task(index);
+      }
+    } else {
+      threadPool->ForEach(taskCount, task);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splits a number of rows into bands and runs a task for each band</summary>
+  /// <typeparam name="TTask">Callable object that will be run for each band</typeparam>
+  /// <param name="threadPool">Thread pool that will process the bands, can be null</param>
+  /// <param name="rowCount">Total number of rows that will be processed</param>
+  /// <param name="rowByteCount">Number of bytes each row occupies</param>
+  /// <param name="task">Task that will be invoked with the first and end row of each band</param>
+  template<typename TTask>
+  void forEachBand(
+    Nuclex::Pixels::ThreadPool *threadPool,
+    std::size_t rowCount, std::size_t rowByteCount, TTask &&task
+  ) {
+    std::size_t bandHeight = Nuclex::Pixels::GetBandHeight(rowByteCount);
+    std::size_t bandCount = (rowCount + bandHeight - 1) / bandHeight;
+    forEachTask(
+      threadPool, bandCount,
+      [rowCount, bandHeight, &task](std::size_t bandIndex) {
+        std::size_t firstRow = bandIndex * bandHeight;
+        task(firstRow, std::min(firstRow + bandHeight, rowCount));
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the address of a row in a bitmap</summary>
+  /// <param name="memory">Bitmap memory in which the row will be looked up</param>
+  /// <param name="y">Index of the row whose address will be returned</param>
+  /// <returns>The address of the first pixel in the requested row</returns>
+  std::uint8_t *getRow(const Nuclex::Pixels::BitmapMemory &memory, std::size_t y) {
+    return static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a row of pixels, repeating the border pixels outside the bitmap</summary>
+  /// <param name="source">Bitmap memory the row will be read from</param>
+  /// <param name="y">Index of the row that will be read</param>
+  /// <param name="startX">X coordinate of the first pixel to read, can be negative</param>
+  /// <param name="pixelCount">Number of pixels that will be read</param>
+  /// <param name="row">Receives the premultiplied pixels as RGBA floats</param>
+  /// <remarks>
+  ///   The range of pixels needs to overlap the bitmap by at least one pixel.
+  /// </remarks>
+  void readPaddedRow(
+    const Nuclex::Pixels::BitmapMemory &source, std::size_t y,
+    std::ptrdiff_t startX, std::size_t pixelCount, float *row
+  ) {
+    std::ptrdiff_t endX = startX + static_cast<std::ptrdiff_t>(pixelCount);
+    std::ptrdiff_t firstX = std::max<std::ptrdiff_t>(startX, 0);
+    std::ptrdiff_t lastX = std::min<std::ptrdiff_t>(
+      endX, static_cast<std::ptrdiff_t>(source.Width)
+    );
+    std::size_t insideCount = static_cast<std::size_t>(lastX - firstX);
+
+    float *inside = row + (firstX - startX) * 4;
+    Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+      source.PixelFormat,
+      getRow(source, y) + Nuclex::Pixels::CountRequiredBytes(
+        source.PixelFormat, static_cast<std::size_t>(firstX)
+      ),
+      Nuclex::Pixels::FilterPixelFormat, inside,
+      insideCount
+    );
+    Nuclex::Pixels::PremultiplyAlpha(inside, insideCount);
+
+    // Repeat the border pixels for the parts of the row outside of the bitmap
+    for(float *pixel = row; pixel < inside; pixel += 4) {
+      std::copy_n(inside, 4, pixel);
+    }
+    const float *lastPixel = inside + (insideCount - 1) * 4;
+    for(float *pixel = inside + insideCount * 4; pixel < row + pixelCount * 4; pixel += 4) {
+      std::copy_n(lastPixel, 4, pixel);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Convolves a row of RGBA pixels with a list of weights</summary>
+  /// <param name="source">
+  ///   Source pixels that will be filtered, including the pixels the kernel reaches
+  ///   beyond the first and last target pixel
+  /// </param>
+  /// <param name="target">Receives the filtered pixels</param>
+  /// <param name="weights">Weights the source pixels will be multiplied with</param>
+  /// <param name="tapCount">Number of weights in the kernel</param>
+  /// <param name="pixelCount">Number of target pixels that will be calculated</param>
+  void convolveRow(
+    const float *source, float *target,
+    const float *weights, std::size_t tapCount, std::size_t pixelCount
+  ) {
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      const float *tapPixels = source + index * 4;
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+      __m128 sum = _mm_setzero_ps();
+      for(std::size_t tap = 0; tap < tapCount; ++tap) {
+        sum = _mm_add_ps(
+          sum, _mm_mul_ps(_mm_set1_ps(weights[tap]), _mm_loadu_ps(tapPixels + tap * 4))
+        );
+      }
+      _mm_storeu_ps(target, sum);
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+      float32x4_t sum = vdupq_n_f32(0.0f);
+      for(std::size_t tap = 0; tap < tapCount; ++tap) {
+        sum = vmlaq_n_f32(sum, vld1q_f32(tapPixels + tap * 4), weights[tap]);
+      }
+      vst1q_f32(target, sum);
+#else
+      float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      for(std::size_t tap = 0; tap < tapCount; ++tap) {
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          sum[channel] += weights[tap] * tapPixels[tap * 4 + channel];
+        }
+      }
+      std::copy_n(sum, 4, target);
+#endif
+      target += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Averages the pixels in a window sliding along a row of RGBA pixels</summary>
+  /// <param name="source">
+  ///   Source pixels that will be filtered, including the pixels the window reaches
+  ///   beyond the first and last target pixel
+  /// </param>
+  /// <param name="target">Receives the filtered pixels</param>
+  /// <param name="pixelCount">Number of target pixels that will be calculated</param>
+  /// <param name="radius">Number of pixels the window reaches to either side</param>
+  /// <remarks>
+  ///   Instead of summing up the whole window for each pixel, the pixel entering
+  ///   the window is added and the pixel leaving it is subtracted, so each target pixel
+  ///   costs the same no matter how large the window is.
+  /// </remarks>
+  void slideBoxAlongRow(
+    const float *source, float *target, std::size_t pixelCount, std::size_t radius
+  ) {
+    std::size_t windowSize = radius * 2 + 1;
+    float scale = 1.0f / static_cast<float>(windowSize);
+    const float *leaving = source;
+    const float *entering = source + windowSize * 4;
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    __m128 scales = _mm_set1_ps(scale);
+    __m128 sum = _mm_setzero_ps();
+    for(std::size_t index = 0; index < windowSize; ++index) {
+      sum = _mm_add_ps(sum, _mm_loadu_ps(source + index * 4));
+    }
+    _mm_storeu_ps(target, _mm_mul_ps(sum, scales));
+    for(std::size_t index = 1; index < pixelCount; ++index) {
+      sum = _mm_sub_ps(_mm_add_ps(sum, _mm_loadu_ps(entering)), _mm_loadu_ps(leaving));
+      entering += 4;
+      leaving += 4;
+      target += 4;
+      _mm_storeu_ps(target, _mm_mul_ps(sum, scales));
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    for(std::size_t index = 0; index < windowSize; ++index) {
+      sum = vaddq_f32(sum, vld1q_f32(source + index * 4));
+    }
+    vst1q_f32(target, vmulq_n_f32(sum, scale));
+    for(std::size_t index = 1; index < pixelCount; ++index) {
+      sum = vsubq_f32(vaddq_f32(sum, vld1q_f32(entering)), vld1q_f32(leaving));
+      entering += 4;
+      leaving += 4;
+      target += 4;
+      vst1q_f32(target, vmulq_n_f32(sum, scale));
+    }
+#else
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for(std::size_t index = 0; index < windowSize; ++index) {
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        sum[channel] += source[index * 4 + channel];
+      }
+    }
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      target[channel] = sum[channel] * scale;
+    }
+    for(std::size_t index = 1; index < pixelCount; ++index) {
+      target += 4;
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        sum[channel] += entering[channel] - leaving[channel];
+        target[channel] = sum[channel] * scale;
+      }
+      entering += 4;
+      leaving += 4;
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a scaled copy of a row of floats</summary>
+  /// <param name="source">Row that will be scaled</param>
+  /// <param name="target">Receives the scaled row</param>
+  /// <param name="scale">Factor the row will be scaled by</param>
+  /// <param name="floatCount">Number of floats in each row, a multiple of 4</param>
+  void scaleRow(const float *source, float *target, float scale, std::size_t floatCount) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    __m128 scales = _mm_set1_ps(scale);
+    for(std::size_t index = 0; index < floatCount; index += 4) {
+      _mm_storeu_ps(target + index, _mm_mul_ps(_mm_loadu_ps(source + index), scales));
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    for(std::size_t index = 0; index < floatCount; index += 4) {
+      vst1q_f32(target + index, vmulq_n_f32(vld1q_f32(source + index), scale));
+    }
+#else
+    for(std::size_t index = 0; index < floatCount; ++index) {
+      target[index] = source[index] * scale;
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Averages the rows in a window sliding down a strip of columns in place</summary>
+  /// <param name="rows">Address of the strip in the first row</param>
+  /// <param name="rowFloatStride">Number of floats between two rows</param>
+  /// <param name="floatCount">Number of floats in each row of the strip</param>
+  /// <param name="rowCount">Number of rows that will be calculated</param>
+  /// <param name="radius">Number of rows the window reaches upwards and downwards</param>
+  /// <param name="sum">Buffer for the running sum, needs to hold a row of the strip</param>
+  /// <param name="leaving">Buffer for the original contents of the row leaving the window</param>
+  /// <remarks>
+  ///   Each result replaces the first row of its window. The rows after it are
+  ///   still needed and the original contents of the replaced row are kept until
+  ///   they are subtracted from the running sum.
+  /// </remarks>
+  void slideBoxDownStrip(
+    float *rows, std::size_t rowFloatStride, std::size_t floatCount,
+    std::size_t rowCount, std::size_t radius, float *sum, float *leaving
+  ) {
+    std::size_t windowSize = radius * 2 + 1;
+    float scale = 1.0f / static_cast<float>(windowSize);
+
+    std::fill(sum, sum + floatCount, 0.0f);
+    for(std::size_t index = 0; index < windowSize; ++index) {
+      Nuclex::Pixels::AccumulateRow(rows + index * rowFloatStride, sum, 1.0f, floatCount);
+    }
+
+    for(std::size_t index = 0; index < rowCount; ++index) {
+      float *row = rows + index * rowFloatStride;
+      if(index > 0) {
+        Nuclex::Pixels::AccumulateRow(
+          row + (windowSize - 1) * rowFloatStride, sum, 1.0f, floatCount
+        );
+        Nuclex::Pixels::AccumulateRow(leaving, sum, -1.0f, floatCount);
+      }
+
+      std::copy_n(row, floatCount, leaving);
+      scaleRow(sum, row, scale, floatCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a row of filtered pixels into the target bitmap's pixel format</summary>
+  /// <param name="row">Premultiplied RGBA floats, will be modified</param>
+  /// <param name="target">Bitmap memory the row will be written to</param>
+  /// <param name="y">Index of the row in the target bitmap</param>
+  void writeRow(float *row, const Nuclex::Pixels::BitmapMemory &target, std::size_t y) {
+    Nuclex::Pixels::UnpremultiplyAlpha(row, target.Width);
+    Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+      Nuclex::Pixels::FilterPixelFormat, row,
+      target.PixelFormat, getRow(target, y),
+      target.Width
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that a region of a bitmap can be filtered into another bitmap</summary>
+  /// <param name="source">Bitmap memory the pixels will be read from</param>
+  /// <param name="sourceRegion">Region in the source bitmap that will be filtered</param>
+  /// <param name="target">Bitmap memory the filtered pixels will be written to</param>
+  /// <returns>True if there are any pixels to filter, false otherwise</returns>
+  bool requireFilterableBitmaps(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::Rectangle &sourceRegion,
+    const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    bool canFilter = (
+      Nuclex::Pixels::BitmapFilter::CanFilter(source.PixelFormat) &&
+      Nuclex::Pixels::BitmapFilter::CanFilter(target.PixelFormat)
+    );
+    if(!canFilter) {
+      throw std::runtime_error(u8"Filtering bitmaps of this pixel format is not supported");
+    }
+
+    bool isInsideSource = (
+      (sourceRegion.MinX <= sourceRegion.MaxX) && (sourceRegion.MaxX <= source.Width) &&
+      (sourceRegion.MinY <= sourceRegion.MaxY) && (sourceRegion.MaxY <= source.Height)
+    );
+    if(!isInsideSource) {
+      throw std::invalid_argument(u8"Region to filter lies outside of the source bitmap");
+    }
+
+    bool fitsTarget = (
+      (sourceRegion.MaxX - sourceRegion.MinX == target.Width) &&
+      (sourceRegion.MaxY - sourceRegion.MinY == target.Height)
+    );
+    if(!fitsTarget) {
+      throw std::invalid_argument(u8"Target bitmap needs to have the size of the region");
+    }
+
+    return (target.Width > 0) && (target.Height > 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Convolves a region of a bitmap with a separable kernel</summary>
+  /// <param name="source">Bitmap memory the pixels will be read from</param>
+  /// <param name="sourceRegion">Region in the source bitmap that will be filtered</param>
+  /// <param name="target">Bitmap memory the filtered pixels will be written to</param>
+  /// <param name="kernel">Kernel the bitmap will be convolved with</param>
+  /// <param name="threadPool">Thread pool sharing the work, null to filter serially</param>
+  void convolve(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::Rectangle &sourceRegion,
+    const Nuclex::Pixels::BitmapMemory &target, const Nuclex::Pixels::SeparableKernel &kernel,
+    Nuclex::Pixels::ThreadPool *threadPool
+  ) {
+    if(!requireFilterableBitmaps(source, sourceRegion, target)) {
+      return;
+    }
+
+    const std::vector<std::size_t> &boxRadii = kernel.GetBoxRadii();
+    bool isBoxKernel = !boxRadii.empty();
+
+    std::size_t horizontalRadius = kernel.GetHorizontalRadius();
+    std::size_t verticalRadius = kernel.GetVerticalRadius();
+    std::size_t width = target.Width;
+    std::size_t height = target.Height;
+    std::size_t paddedWidth = width + horizontalRadius * 2;
+    std::size_t paddedHeight = height + verticalRadius * 2;
+    std::size_t rowFloatCount = width * 4;
+
+    // Filter each source row the vertical pass will reach horizontally. Rows above and
+    // below the source bitmap repeat its first and last rows.
+    std::vector<float> intermediate(paddedHeight * rowFloatCount);
+    forEachBand(
+      threadPool, paddedHeight, paddedWidth * 4 * sizeof(float),
+      [&](std::size_t firstRow, std::size_t endRow) {
+        std::vector<float> paddedRow(paddedWidth * 4);
+        std::vector<float> scratchRow(isBoxKernel ? paddedWidth * 4 : 0);
+        for(std::size_t row = firstRow; row < endRow; ++row) {
+          std::ptrdiff_t sourceY = (
+            static_cast<std::ptrdiff_t>(sourceRegion.MinY + row) -
+            static_cast<std::ptrdiff_t>(verticalRadius)
+          );
+          sourceY = std::max<std::ptrdiff_t>(
+            0, std::min<std::ptrdiff_t>(sourceY, static_cast<std::ptrdiff_t>(source.Height) - 1)
+          );
+          readPaddedRow(
+            source, static_cast<std::size_t>(sourceY),
+            static_cast<std::ptrdiff_t>(sourceRegion.MinX) -
+            static_cast<std::ptrdiff_t>(horizontalRadius),
+            paddedWidth, paddedRow.data()
+          );
+
+          float *intermediateRow = intermediate.data() + row * rowFloatCount;
+          if(isBoxKernel) {
+            float *passSource = paddedRow.data();
+            float *passTarget = scratchRow.data();
+            std::size_t length = paddedWidth;
+            for(std::size_t radius : boxRadii) {
+              length -= radius * 2;
+              slideBoxAlongRow(passSource, passTarget, length, radius);
+              std::swap(passSource, passTarget);
+            }
+            std::copy_n(passSource, rowFloatCount, intermediateRow);
+          } else {
+            const std::vector<float> &weights = kernel.GetHorizontalWeights();
+            convolveRow(
+              paddedRow.data(), intermediateRow, weights.data(), weights.size(), width
+            );
+          }
+        }
+      }
+    );
+
+    // The box passes slide down strips of columns in place, leaving the finished rows
+    // at the top of the intermediate buffer
+    if(isBoxKernel) {
+      std::size_t stripCount = (width + StripWidth - 1) / StripWidth;
+      forEachTask(
+        threadPool, stripCount,
+        [&](std::size_t stripIndex) {
+          std::size_t firstColumn = stripIndex * StripWidth;
+          std::size_t stripFloatCount = std::min(StripWidth, width - firstColumn) * 4;
+          std::vector<float> sum(stripFloatCount);
+          std::vector<float> leaving(stripFloatCount);
+
+          std::size_t length = paddedHeight;
+          for(std::size_t radius : boxRadii) {
+            length -= radius * 2;
+            slideBoxDownStrip(
+              intermediate.data() + firstColumn * 4, rowFloatCount, stripFloatCount,
+              length, radius, sum.data(), leaving.data()
+            );
+          }
+        }
+      );
+      forEachBand(
+        threadPool, height, rowFloatCount * sizeof(float),
+        [&](std::size_t firstRow, std::size_t endRow) {
+          for(std::size_t row = firstRow; row < endRow; ++row) {
+            writeRow(intermediate.data() + row * rowFloatCount, target, row);
+          }
+        }
+      );
+    } else {
+      const std::vector<float> &weights = kernel.GetVerticalWeights();
+      forEachBand(
+        threadPool, height, rowFloatCount * weights.size() * sizeof(float),
+        [&](std::size_t firstRow, std::size_t endRow) {
+          std::vector<float> targetRow(rowFloatCount);
+          for(std::size_t row = firstRow; row < endRow; ++row) {
+            const float *tapRows = intermediate.data() + row * rowFloatCount;
+
+            std::fill(targetRow.begin(), targetRow.end(), 0.0f);
+            for(std::size_t tap = 0; tap < weights.size(); ++tap) {
+              if(weights[tap] != 0.0f) {
+                Nuclex::Pixels::AccumulateRow(
+                  tapRows + tap * rowFloatCount, targetRow.data(), weights[tap], rowFloatCount
+                );
+              }
+            }
+
+            writeRow(targetRow.data(), target, row);
+          }
+        }
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeparableKernel SeparableKernel::FromWeights(const std::vector<float> &weights) {
+    return FromWeights(weights, weights);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeparableKernel SeparableKernel::FromWeights(
+    const std::vector<float> &horizontalWeights, const std::vector<float> &verticalWeights
+  ) {
+    requireOddWeightCount(horizontalWeights);
+    requireOddWeightCount(verticalWeights);
+
+    SeparableKernel kernel;
+    kernel.horizontalWeights = horizontalWeights;
+    kernel.verticalWeights = verticalWeights;
+    return kernel;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeparableKernel SeparableKernel::Box(std::size_t radius, std::size_t passCount /* = 1 */) {
+    if(passCount == 0) {
+      throw std::invalid_argument(u8"Box kernels need at least one pass");
+    }
+
+    SeparableKernel kernel;
+    kernel.boxRadii.assign(passCount, radius);
+    return kernel;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  SeparableKernel SeparableKernel::Gaussian(float sigma) {
+    if(!(sigma >= 0.0f)) {
+      throw std::invalid_argument(u8"Standard deviation of a Gaussian can not be negative");
+    }
+
+    // Pick the odd box widths lower and upper so that the variance of the box passes
+    // (each contributing (width^2 - 1) / 12) adds up to the Gaussian's variance.
+    // This is the construction from Kovesi's "Fast Almost-Gaussian Filtering".
+    double variance = static_cast<double>(sigma) * static_cast<double>(sigma);
+    double passCount = static_cast<double>(GaussianBoxPassCount);
+    double idealWidth = std::sqrt(12.0 * variance / passCount + 1.0);
+
+    std::size_t lowerWidth = static_cast<std::size_t>(std::floor(idealWidth));
+    if((lowerWidth % 2) == 0) {
+      --lowerWidth;
+    }
+    double lower = static_cast<double>(lowerWidth);
+    double idealLowerCount = (
+      (12.0 * variance - passCount * lower * lower - 4.0 * passCount * lower - 3.0 * passCount) /
+      (-4.0 * lower - 4.0)
+    );
+    std::size_t lowerCount = static_cast<std::size_t>(
+      std::max(0.0, std::min(passCount, std::round(idealLowerCount)))
+    );
+
+    SeparableKernel kernel;
+    kernel.boxRadii.resize(GaussianBoxPassCount);
+    for(std::size_t index = 0; index < GaussianBoxPassCount; ++index) {
+      std::size_t boxWidth = (index < lowerCount) ? lowerWidth : (lowerWidth + 2);
+      kernel.boxRadii[index] = boxWidth / 2;
+    }
+    return kernel;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SeparableKernel::GetHorizontalRadius() const {
+    if(this->boxRadii.empty()) {
+      return this->horizontalWeights.size() / 2;
+    }
+
+    std::size_t radius = 0;
+    for(std::size_t boxRadius : this->boxRadii) {
+      radius += boxRadius;
+    }
+    return radius;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t SeparableKernel::GetVerticalRadius() const {
+    if(this->boxRadii.empty()) {
+      return this->verticalWeights.size() / 2;
+    } else {
+      return GetHorizontalRadius();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BitmapFilter::CanFilter(PixelFormat pixelFormat) {
+    return (
+      PixelFormatConverter::CanConvert(pixelFormat, FilterPixelFormat) &&
+      PixelFormatConverter::CanConvert(FilterPixelFormat, pixelFormat)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapFilter::Convolve(
+    const BitmapMemory &source, const BitmapMemory &target, const SeparableKernel &kernel
+  ) {
+    convolve(source, Rectangle(0, 0, source.Width, source.Height), target, kernel, nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapFilter::Convolve(
+    const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool,
+    const SeparableKernel &kernel
+  ) {
+    convolve(
+      source, Rectangle(0, 0, source.Width, source.Height), target, kernel, &threadPool
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapFilter::Convolve(
+    const BitmapMemory &source, const Rectangle &sourceRegion,
+    const BitmapMemory &target, const SeparableKernel &kernel
+  ) {
+    convolve(source, sourceRegion, target, kernel, nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapFilter::Convolve(
+    const BitmapMemory &source, const Rectangle &sourceRegion,
+    const BitmapMemory &target, ThreadPool &threadPool,
+    const SeparableKernel &kernel
+  ) {
+    convolve(source, sourceRegion, target, kernel, &threadPool);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,630 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapResampler.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "RowStreamHelpers.h"
+#include "FilterHelpers.h"
+
+#include <algorithm> // for std::max(), std::min(), std::fill()
+#include <cmath> // for std::floor(), std::ceil(), std::sin()
+#include <cstdint>
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+#include <vector> // for std::vector
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>The ratio of a circle's circumference to its diameter</summary>
+  const double Pi = 3.14159265358979323846;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the shape of a resampling filter</summary>
+  struct FilterKernel {
+
+    /// <summary>Distance from the center beyond which the filter is zero</summary>
+    public: double Radius;
+    /// <summary>Calculates the filter's weight at the specified distance</summary>
+    public: double (*Evaluate)(double x);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Precalculated filter weights for each pixel along one axis</summary>
+  struct WeightTable {
+
+    /// <summary>Number of source pixels contributing to each target pixel</summary>
+    /// <remarks>
+    ///   This is the same for all target pixels so the filter loops have a fixed length.
+    ///   Target pixels near the edges simply have zero weights for some of their taps.
+    /// </remarks>
+    public: std::size_t TapCount;
+    /// <summary>Index of the first contributing source pixel for each target pixel</summary>
+    public: std::vector<std::size_t> FirstTaps;
+    /// <summary>Weights of the contributing source pixels, TapCount per target pixel</summary>
+    public: std::vector<float> Weights;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Evaluates the box filter</summary>
+  /// <param name="x">Distance from the filter's center</param>
+  /// <returns>The filter's weight at the specified distance</returns>
+  double evaluateBox(double x) {
+    return ((x >= -0.5) && (x < 0.5)) ? 1.0 : 0.0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Evaluates the linear (triangle) filter</summary>
+  /// <param name="x">Distance from the filter's center</param>
+  /// <returns>The filter's weight at the specified distance</returns>
+  double evaluateBilinear(double x) {
+    x = std::abs(x);
+    return (x < 1.0) ? (1.0 - x) : 0.0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Evaluates the normalized sinc function</summary>
+  /// <param name="x">Value for which the sinc function will be evaluated</param>
+  /// <returns>The value of the sinc function at the specified position</returns>
+  double sinc(double x) {
+    if(x == 0.0) {
+      return 1.0;
+    }
+
+    x *= Pi;
+    return std::sin(x) / x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Evaluates the Lanczos filter with a window of 3 lobes</summary>
+  /// <param name="x">Distance from the filter's center</param>
+  /// <returns>The filter's weight at the specified distance</returns>
+  double evaluateLanczos3(double x) {
+    if(std::abs(x) < 3.0) {
+      return sinc(x) * sinc(x / 3.0);
+    } else {
+      return 0.0;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Evaluates the Mitchell-Netravali filter with B = C = 1/3</summary>
+  /// <param name="x">Distance from the filter's center</param>
+  /// <returns>The filter's weight at the specified distance</returns>
+  double evaluateMitchell(double x) {
+    const double B = 1.0 / 3.0;
+    const double C = 1.0 / 3.0;
+
+    x = std::abs(x);
+    if(x < 1.0) {
+      return (
+        ((12.0 - 9.0 * B - 6.0 * C) * x * x * x) +
+        ((-18.0 + 12.0 * B + 6.0 * C) * x * x) +
+        (6.0 - 2.0 * B)
+      ) / 6.0;
+    } else if(x < 2.0) {
+      return (
+        ((-B - 6.0 * C) * x * x * x) +
+        ((6.0 * B + 30.0 * C) * x * x) +
+        ((-12.0 * B - 48.0 * C) * x) +
+        (8.0 * B + 24.0 * C)
+      ) / 6.0;
+    } else {
+      return 0.0;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the kernel of the specified resampling filter</summary>
+  /// <param name="filter">Filter whose kernel will be returned</param>
+  /// <returns>The kernel of the specified filter</returns>
+  FilterKernel getFilterKernel(Nuclex::Pixels::ResamplingFilter filter) {
+    switch(filter) {
+      case Nuclex::Pixels::ResamplingFilter::Box: {
+        return FilterKernel { 0.5, &evaluateBox };
+      }
+      case Nuclex::Pixels::ResamplingFilter::Bilinear: {
+        return FilterKernel { 1.0, &evaluateBilinear };
+      }
+      case Nuclex::Pixels::ResamplingFilter::Lanczos3: {
+        return FilterKernel { 3.0, &evaluateLanczos3 };
+      }
+      case Nuclex::Pixels::ResamplingFilter::Mitchell: {
+        return FilterKernel { 2.0, &evaluateMitchell };
+      }
+      default: {
+        throw std::invalid_argument(u8"Unknown resampling filter");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the filter weights for resampling along one axis</summary>
+  /// <param name="sourceLength">Number of pixels along the axis in the source bitmap</param>
+  /// <param name="targetLength">Number of pixels along the axis in the target bitmap</param>
+  /// <param name="kernel">Kernel of the filter that will be used</param>
+  /// <returns>A table with the filter weights for each target pixel</returns>
+  /// <remarks>
+  ///   When downscaling, the filter is stretched to cover all source pixels that fall
+  ///   into a target pixel, otherwise the result would alias. Source pixels beyond
+  ///   the edges are treated as repeating the edge pixel.
+  /// </remarks>
+  WeightTable calculateWeights(
+    std::size_t sourceLength, std::size_t targetLength, const FilterKernel &kernel
+  ) {
+    double scale = static_cast<double>(sourceLength) / static_cast<double>(targetLength);
+    double filterScale = std::max(scale, 1.0);
+    double support = kernel.Radius * filterScale;
+
+    WeightTable table;
+    table.TapCount = std::min(
+      static_cast<std::size_t>(std::ceil(support * 2.0)) + 2, sourceLength
+    );
+    table.FirstTaps.resize(targetLength);
+    table.Weights.resize(targetLength * table.TapCount);
+
+    std::vector<double> weights(table.TapCount);
+    for(std::size_t index = 0; index < targetLength; ++index) {
+      double center = (static_cast<double>(index) + 0.5) * scale;
+
+      std::ptrdiff_t left = static_cast<std::ptrdiff_t>(std::floor(center - support));
+      std::ptrdiff_t right = static_cast<std::ptrdiff_t>(std::ceil(center + support));
+
+      // Place the contributing pixels so that all of them fall inside the source bitmap
+      std::ptrdiff_t lastTap = static_cast<std::ptrdiff_t>(sourceLength - table.TapCount);
+      std::ptrdiff_t firstTap = std::max<std::ptrdiff_t>(0, std::min(left, lastTap));
+
+      // Evaluate the filter for all source pixels in reach, folding pixels beyond
+      // the edges of the source bitmap onto the edge pixels
+      std::fill(weights.begin(), weights.end(), 0.0);
+      double totalWeight = 0.0;
+      for(std::ptrdiff_t tap = left; tap < right; ++tap) {
+        double weight = kernel.Evaluate(
+          (static_cast<double>(tap) + 0.5 - center) / filterScale
+        );
+        if(weight == 0.0) {
+          continue;
+        }
+
+        std::ptrdiff_t clampedTap = std::max<std::ptrdiff_t>(
+          0, std::min<std::ptrdiff_t>(tap, static_cast<std::ptrdiff_t>(sourceLength) - 1)
+        );
+        weights[static_cast<std::size_t>(clampedTap - firstTap)] += weight;
+        totalWeight += weight;
+      }
+
+      // Normalize the weights so a constant color stays the same color
+      float *tableWeights = &table.Weights[index * table.TapCount];
+      if(totalWeight == 0.0) { // Can't happen with the built-in filters, but be safe
+        std::size_t nearestTap = std::min(
+          static_cast<std::size_t>(center) - static_cast<std::size_t>(firstTap),
+          table.TapCount - 1
+        );
+        weights[nearestTap] = 1.0;
+        totalWeight = 1.0;
+      }
+      for(std::size_t tap = 0; tap < table.TapCount; ++tap) {
+        tableWeights[tap] = static_cast<float>(weights[tap] / totalWeight);
+      }
+
+      table.FirstTaps[index] = static_cast<std::size_t>(firstTap);
+    }
+
+    return table;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Filters a row of RGBA pixels horizontally</summary>
+  /// <param name="source">Source pixels that will be filtered</param>
+  /// <param name="target">Receives the filtered pixels</param>
+  /// <param name="weights">Filter weights for each target pixel</param>
+  void filterRow(const float *source, float *target, const WeightTable &weights) {
+    std::size_t targetCount = weights.FirstTaps.size();
+    const float *tapWeights = weights.Weights.data();
+
+    for(std::size_t index = 0; index < targetCount; ++index) {
+      const float *tapPixels = source + weights.FirstTaps[index] * 4;
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+      __m128 sum = _mm_setzero_ps();
+      for(std::size_t tap = 0; tap < weights.TapCount; ++tap) {
+        sum = _mm_add_ps(
+          sum, _mm_mul_ps(_mm_set1_ps(tapWeights[tap]), _mm_loadu_ps(tapPixels + tap * 4))
+        );
+      }
+      _mm_storeu_ps(target, sum);
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+      float32x4_t sum = vdupq_n_f32(0.0f);
+      for(std::size_t tap = 0; tap < weights.TapCount; ++tap) {
+        sum = vmlaq_n_f32(sum, vld1q_f32(tapPixels + tap * 4), tapWeights[tap]);
+      }
+      vst1q_f32(target, sum);
+#else
+      float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      for(std::size_t tap = 0; tap < weights.TapCount; ++tap) {
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          sum[channel] += tapWeights[tap] * tapPixels[tap * 4 + channel];
+        }
+      }
+      std::copy_n(sum, 4, target);
+#endif
+      tapWeights += weights.TapCount;
+      target += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Filters a band of source rows horizontally into the intermediate buffer</summary>
+  /// <param name="sourceBand">Band of rows in the source bitmap</param>
+  /// <param name="y">Index of the band's first row in the source bitmap</param>
+  /// <param name="weights">Horizontal filter weights</param>
+  /// <param name="intermediate">Buffer receiving the horizontally filtered rows</param>
+  void resampleHorizontally(
+    const Nuclex::Pixels::BitmapMemory &sourceBand, std::size_t y,
+    const WeightTable &weights, float *intermediate
+  ) {
+    std::size_t intermediateFloatCount = weights.FirstTaps.size() * 4;
+    intermediate += y * intermediateFloatCount;
+
+    std::vector<float> sourceRow(sourceBand.Width * 4);
+    const std::uint8_t *sourcePixels = static_cast<const std::uint8_t *>(sourceBand.Pixels);
+    for(std::size_t row = 0; row < sourceBand.Height; ++row) {
+      Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+        sourceBand.PixelFormat, sourcePixels,
+        Nuclex::Pixels::FilterPixelFormat, sourceRow.data(),
+        sourceBand.Width
+      );
+      Nuclex::Pixels::PremultiplyAlpha(sourceRow.data(), sourceBand.Width);
+      filterRow(sourceRow.data(), intermediate, weights);
+
+      sourcePixels += sourceBand.Stride;
+      intermediate += intermediateFloatCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Filters the intermediate buffer vertically into a band of target rows</summary>
+  /// <param name="targetBand">Band of rows in the target bitmap</param>
+  /// <param name="y">Index of the band's first row in the target bitmap</param>
+  /// <param name="weights">Vertical filter weights</param>
+  /// <param name="intermediate">Buffer holding the horizontally filtered rows</param>
+  void resampleVertically(
+    const Nuclex::Pixels::BitmapMemory &targetBand, std::size_t y,
+    const WeightTable &weights, const float *intermediate
+  ) {
+    std::size_t intermediateFloatCount = targetBand.Width * 4;
+
+    std::vector<float> targetRow(intermediateFloatCount);
+    std::uint8_t *targetPixels = static_cast<std::uint8_t *>(targetBand.Pixels);
+    for(std::size_t row = 0; row < targetBand.Height; ++row) {
+      std::size_t index = y + row;
+      const float *tapRows = intermediate + weights.FirstTaps[index] * intermediateFloatCount;
+      const float *tapWeights = &weights.Weights[index * weights.TapCount];
+
+      std::fill(targetRow.begin(), targetRow.end(), 0.0f);
+      for(std::size_t tap = 0; tap < weights.TapCount; ++tap) {
+        if(tapWeights[tap] != 0.0f) {
+          Nuclex::Pixels::AccumulateRow(
+            tapRows + tap * intermediateFloatCount, targetRow.data(),
+            tapWeights[tap], intermediateFloatCount
+          );
+        }
+      }
+
+      Nuclex::Pixels::UnpremultiplyAlpha(targetRow.data(), targetBand.Width);
+      Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+        Nuclex::Pixels::FilterPixelFormat, targetRow.data(),
+        targetBand.PixelFormat, targetPixels,
+        targetBand.Width
+      );
+
+      targetPixels += targetBand.Stride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that a bitmap can be resampled into another bitmap</summary>
+  /// <param name="source">Bitmap memory the pixels will be read from</param>
+  /// <param name="target">Bitmap memory the resampled pixels will be written to</param>
+  /// <returns>True if there are any pixels to resample, false otherwise</returns>
+  bool requireResamplableBitmaps(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    bool canResample = (
+      Nuclex::Pixels::BitmapResampler::CanResample(source.PixelFormat) &&
+      Nuclex::Pixels::BitmapResampler::CanResample(target.PixelFormat)
+    );
+    if(!canResample) {
+      throw std::runtime_error(u8"Resampling bitmaps of this pixel format is not supported");
+    }
+
+    if((target.Width == 0) || (target.Height == 0)) {
+      return false;
+    }
+    if((source.Width == 0) || (source.Height == 0)) {
+      throw std::runtime_error(u8"Provided source bitmap does not contain any pixels");
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row source that resamples the rows of another row source</summary>
+  /// <remarks>
+  ///   Works like the bitmap resampler, but instead of filtering the whole source bitmap
+  ///   horizontally up front, only the source rows the vertical filter currently reaches
+  ///   are kept in a ring buffer. Each source row is read once, when the first target row
+  ///   whose filter reaches it is requested.
+  /// </remarks>
+  class ResamplingRowSource : public Nuclex::Pixels::RowSource {
+
+    /// <summary>Initializes a new resampling row source</summary>
+    /// <param name="source">Row source whose rows will be resampled</param>
+    /// <param name="targetWidth">Width the rows will be resampled to</param>
+    /// <param name="targetHeight">Number of rows the image will be resampled to</param>
+    /// <param name="kernel">Kernel of the filter that will be used</param>
+    public: ResamplingRowSource(
+      std::unique_ptr<Nuclex::Pixels::RowSource> &&source,
+      std::size_t targetWidth, std::size_t targetHeight,
+      const FilterKernel &kernel
+    ) :
+      source(std::move(source)),
+      targetWidth(targetWidth),
+      targetHeight(targetHeight),
+      nextSourceRowIndex(0),
+      nextTargetRowIndex(0) {
+      if((targetWidth == 0) || (targetHeight == 0)) {
+        return;
+      }
+
+      std::size_t sourceWidth = this->source->GetWidth();
+      std::size_t sourceHeight = this->source->GetHeight();
+      if((sourceWidth == 0) || (sourceHeight == 0)) {
+        throw std::runtime_error(u8"Provided row source does not contain any pixels");
+      }
+
+      this->horizontalWeights = calculateWeights(sourceWidth, targetWidth, kernel);
+      this->verticalWeights = calculateWeights(sourceHeight, targetHeight, kernel);
+
+      this->sourceRow.resize(
+        Nuclex::Pixels::CountRequiredBytes(this->source->GetPixelFormat(), sourceWidth)
+      );
+      this->convertedRow.resize(sourceWidth * 4);
+      this->targetRow.resize(targetWidth * 4);
+      this->ring.resize(this->verticalWeights.TapCount * targetWidth * 4);
+    }
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->targetWidth; }
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: std::size_t GetHeight() const override { return this->targetHeight; }
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->source->GetPixelFormat();
+    }
+
+    /// <summary>Calculates the next resampled rows of the image</summary>
+    /// <param name="rows">Bitmap memory that will receive the resampled rows</param>
+    public: void ReadRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      Nuclex::Pixels::RequireFittingRows(
+        rows, this->targetWidth, GetPixelFormat(),
+        this->targetHeight - this->nextTargetRowIndex
+      );
+      if(rows.Width == 0) {
+        this->nextTargetRowIndex += rows.Height;
+        return;
+      }
+
+      std::size_t tapCount = this->verticalWeights.TapCount;
+      std::size_t intermediateFloatCount = this->targetWidth * 4;
+
+      std::uint8_t *targetPixels = static_cast<std::uint8_t *>(rows.Pixels);
+      for(std::size_t row = 0; row < rows.Height; ++row) {
+        std::size_t index = this->nextTargetRowIndex;
+        std::size_t firstTap = this->verticalWeights.FirstTaps[index];
+
+        // Pull in the source rows the filter reaches for this target row. The first
+        // taps never move backwards, so the ring always holds the rows still needed.
+        while(this->nextSourceRowIndex < firstTap + tapCount) {
+          readSourceRow(
+            &this->ring[(this->nextSourceRowIndex % tapCount) * intermediateFloatCount]
+          );
+          ++this->nextSourceRowIndex;
+        }
+
+        const float *tapWeights = &this->verticalWeights.Weights[index * tapCount];
+        std::fill(this->targetRow.begin(), this->targetRow.end(), 0.0f);
+        for(std::size_t tap = 0; tap < tapCount; ++tap) {
+          if(tapWeights[tap] != 0.0f) {
+            Nuclex::Pixels::AccumulateRow(
+              &this->ring[((firstTap + tap) % tapCount) * intermediateFloatCount],
+              this->targetRow.data(), tapWeights[tap], intermediateFloatCount
+            );
+          }
+        }
+
+        Nuclex::Pixels::UnpremultiplyAlpha(this->targetRow.data(), this->targetWidth);
+        Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+          Nuclex::Pixels::FilterPixelFormat, this->targetRow.data(),
+          rows.PixelFormat, targetPixels,
+          this->targetWidth
+        );
+
+        targetPixels += rows.Stride;
+        ++this->nextTargetRowIndex;
+      }
+    }
+
+    /// <summary>Reads the next source row and filters it horizontally</summary>
+    /// <param name="intermediate">Receives the horizontally filtered row</param>
+    private: void readSourceRow(float *intermediate) {
+      Nuclex::Pixels::BitmapMemory sourceMemory;
+      sourceMemory.Width = this->source->GetWidth();
+      sourceMemory.Height = 1;
+      sourceMemory.Stride = static_cast<int>(this->sourceRow.size());
+      sourceMemory.PixelFormat = this->source->GetPixelFormat();
+      sourceMemory.Pixels = this->sourceRow.data();
+      this->source->ReadRows(sourceMemory);
+
+      Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+        sourceMemory.PixelFormat, this->sourceRow.data(),
+        Nuclex::Pixels::FilterPixelFormat, this->convertedRow.data(),
+        sourceMemory.Width
+      );
+      Nuclex::Pixels::PremultiplyAlpha(this->convertedRow.data(), sourceMemory.Width);
+      filterRow(this->convertedRow.data(), intermediate, this->horizontalWeights);
+    }
+
+    /// <summary>Row source that provides the rows before resampling</summary>
+    private: std::unique_ptr<Nuclex::Pixels::RowSource> source;
+    /// <summary>Width the rows are resampled to</summary>
+    private: std::size_t targetWidth;
+    /// <summary>Number of rows the image is resampled to</summary>
+    private: std::size_t targetHeight;
+    /// <summary>Index of the next row that will be read from the source row source</summary>
+    private: std::size_t nextSourceRowIndex;
+    /// <summary>Index of the next resampled row that will be provided</summary>
+    private: std::size_t nextTargetRowIndex;
+    /// <summary>Horizontal filter weights</summary>
+    private: WeightTable horizontalWeights;
+    /// <summary>Vertical filter weights</summary>
+    private: WeightTable verticalWeights;
+    /// <summary>Receives a row read from the source row source</summary>
+    private: std::vector<std::uint8_t> sourceRow;
+    /// <summary>Source row converted and premultiplied for filtering</summary>
+    private: std::vector<float> convertedRow;
+    /// <summary>Accumulates the vertically filtered target row</summary>
+    private: std::vector<float> targetRow;
+    /// <summary>Horizontally filtered source rows the vertical filter reaches</summary>
+    private: std::vector<float> ring;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BitmapResampler::CanResample(PixelFormat pixelFormat) {
+    return PixelFormatConverter::CanConvert(pixelFormat, FilterPixelFormat);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapResampler::Resample(
+    const BitmapMemory &source, const BitmapMemory &target,
+    ResamplingFilter filter /* = ResamplingFilter::Mitchell */
+  ) {
+    if(!requireResamplableBitmaps(source, target)) {
+      return;
+    }
+
+    FilterKernel kernel = getFilterKernel(filter);
+    WeightTable horizontalWeights = calculateWeights(source.Width, target.Width, kernel);
+    WeightTable verticalWeights = calculateWeights(source.Height, target.Height, kernel);
+
+    std::vector<float> intermediate(source.Height * target.Width * 4);
+    resampleHorizontally(source, 0, horizontalWeights, intermediate.data());
+    resampleVertically(target, 0, verticalWeights, intermediate.data());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapResampler::Resample(
+    const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool,
+    ResamplingFilter filter /* = ResamplingFilter::Mitchell */
+  ) {
+    if(!requireResamplableBitmaps(source, target)) {
+      return;
+    }
+
+    FilterKernel kernel = getFilterKernel(filter);
+    WeightTable horizontalWeights = calculateWeights(source.Width, target.Width, kernel);
+    WeightTable verticalWeights = calculateWeights(source.Height, target.Height, kernel);
+
+    std::vector<float> intermediate(source.Height * target.Width * 4);
+    ForEachBandInParallel(
+      threadPool, source,
+      [&horizontalWeights, &intermediate](const BitmapMemory &sourceBand, std::size_t y) {
+        resampleHorizontally(sourceBand, y, horizontalWeights, intermediate.data());
+      }
+    );
+    ForEachBandInParallel(
+      threadPool, target,
+      [&verticalWeights, &intermediate](const BitmapMemory &targetBand, std::size_t y) {
+        resampleVertically(targetBand, y, verticalWeights, intermediate.data());
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSource> BitmapResampler::ResampleRows(
+    std::unique_ptr<RowSource> &&source, std::size_t targetWidth, std::size_t targetHeight,
+    ResamplingFilter filter /* = ResamplingFilter::Mitchell */
+  ) {
+    if(!CanResample(source->GetPixelFormat())) {
+      throw std::runtime_error(u8"Resampling bitmaps of this pixel format is not supported");
+    }
+
+    return std::unique_ptr<RowSource>(
+      new ResamplingRowSource(
+        std::move(source), targetWidth, targetHeight, getFilterKernel(filter)
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
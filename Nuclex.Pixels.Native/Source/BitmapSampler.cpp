@@ -0,0 +1,1049 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapSampler.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/PixelFormatTraits.h"
+#include "FilterHelpers.h"
+
+#include <algorithm> // for std::copy()
+#include <cmath> // for std::floor()
+#include <cstdint>
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+
+#if defined(NUCLEX_PIXELS_HAVE_AVX2)
+#include <immintrin.h> // for AVX2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of coordinates that are sampled together</summary>
+  const std::size_t BatchSize = 8;
+
+  /// <summary>Largest number of bytes a pixel of any samplable pixel format has</summary>
+  const std::size_t MaximumBytesPerPixel = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Samples a bitmap as float colors</summary>
+  typedef void SampleFloatsFunction(
+    const Nuclex::Pixels::BitmapMemory &memory,
+    const float *u, const float *v, std::size_t count, float *rgba
+  );
+
+  /// <summary>Samples a bitmap as 8 bit colors</summary>
+  typedef void SampleBytesFunction(
+    const Nuclex::Pixels::BitmapMemory &memory,
+    const float *u, const float *v, std::size_t count, std::uint8_t *rgba
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel positions and filter weights for a batch of coordinates</summary>
+  struct TexelBatch {
+
+    /// <summary>Left and right column of the pixels each coordinate reads</summary>
+    /// <remarks>Only the left column is used when sampling the nearest pixel</remarks>
+    public: std::int32_t Columns[2][BatchSize];
+    /// <summary>Top and bottom row of the pixels each coordinate reads</summary>
+    /// <remarks>Only the top row is used when sampling the nearest pixel</remarks>
+    public: std::int32_t Rows[2][BatchSize];
+    /// <summary>Weights of the right column, from 0.0 to 1.0</summary>
+    public: float HorizontalWeights[BatchSize];
+    /// <summary>Weights of the bottom row, from 0.0 to 1.0</summary>
+    public: float VerticalWeights[BatchSize];
+    /// <summary>Weights of the right column in fixed point, from 0 to 256</summary>
+    public: std::int32_t HorizontalFixedWeights[BatchSize];
+    /// <summary>Weights of the bottom row in fixed point, from 0 to 256</summary>
+    public: std::int32_t VerticalFixedWeights[BatchSize];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits a value to the specified range, turning NaNs into the minimum</summary>
+  /// <param name="value">Value that will be limited</param>
+  /// <param name="minimum">Smallest value that will be returned</param>
+  /// <param name="maximum">Largest value that will be returned</param>
+  /// <returns>The value limited to the specified range</returns>
+  inline float clampToRange(float value, float minimum, float maximum) {
+    return (value > minimum) ? ((value < maximum) ? value : maximum) : minimum;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+  /// <summary>Rounds four floats down to the next integer</summary>
+  /// <param name="values">Values that will be rounded down</param>
+  /// <returns>The rounded values</returns>
+  /// <remarks>
+  ///   SSE2 has no floor instruction (that came with SSE4.1), so this truncates and
+  ///   subtracts one where truncating rounded up. Only valid within the range of int32.
+  /// </remarks>
+  inline __m128 floor4(__m128 values) {
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(values));
+    return _mm_sub_ps(
+      truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, values), _mm_set1_ps(1.0f))
+    );
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the pixels and weights along one axis for a batch</summary>
+  /// <typeparam name="TFilter">Filter that will be used to sample the pixels</typeparam>
+  /// <typeparam name="TAddressing">How coordinates outside the bitmap are handled</typeparam>
+  /// <param name="coordinates">Normalized coordinates along the axis</param>
+  /// <param name="size">Number of pixels along the axis</param>
+  /// <param name="indices">Receives the first and second pixel index for each coordinate</param>
+  /// <param name="weights">Receives the weight of the second pixel</param>
+  /// <param name="fixedWeights">Receives the weight of the second pixel in fixed point</param>
+  template<Nuclex::Pixels::SamplingFilter TFilter, Nuclex::Pixels::TextureAddressing TAddressing>
+  void calculateAxis(
+    const float *coordinates, std::size_t size,
+    std::int32_t (&indices)[2][BatchSize],
+    float (&weights)[BatchSize], std::int32_t (&fixedWeights)[BatchSize]
+  ) {
+    using Nuclex::Pixels::SamplingFilter;
+    using Nuclex::Pixels::TextureAddressing;
+
+    const bool isBilinear = (TFilter == SamplingFilter::Bilinear);
+    const bool isWrapping = (TAddressing == TextureAddressing::Wrap);
+    const float sizeAsFloat = static_cast<float>(size);
+    const float limit = static_cast<float>(size - 1);
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    const __m128 sizes = _mm_set1_ps(sizeAsFloat);
+    const __m128 limits = _mm_set1_ps(limit);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    // Note that _mm_max_ps() returns its second argument if the first is a NaN,
+    // so the clamping below also keeps invalid coordinates inside the bitmap
+    for(std::size_t index = 0; index < BatchSize; index += 4) {
+      __m128 position = _mm_mul_ps(_mm_loadu_ps(coordinates + index), sizes);
+      if(isBilinear) {
+        position = _mm_sub_ps(position, _mm_set1_ps(0.5f));
+      }
+      if(isWrapping) {
+        position = _mm_sub_ps(
+          position, _mm_mul_ps(floor4(_mm_div_ps(position, sizes)), sizes)
+        );
+      } else {
+        position = _mm_min_ps(_mm_max_ps(position, _mm_set1_ps(-1.0f)), sizes);
+      }
+
+      __m128 first = floor4(position);
+      if(isBilinear) {
+        __m128 weight = _mm_min_ps(_mm_max_ps(_mm_sub_ps(position, first), zero), one);
+        _mm_storeu_ps(weights + index, weight);
+        _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(fixedWeights + index),
+          _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(weight, _mm_set1_ps(256.0f)), _mm_set1_ps(0.5f)))
+        );
+
+        __m128 second = _mm_add_ps(first, one);
+        if(isWrapping) {
+          second = _mm_sub_ps(second, _mm_and_ps(_mm_cmpge_ps(second, sizes), sizes));
+        }
+        second = _mm_min_ps(_mm_max_ps(second, zero), limits);
+        _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(indices[1] + index), _mm_cvttps_epi32(second)
+        );
+      }
+
+      if(isWrapping) {
+        first = _mm_sub_ps(first, _mm_and_ps(_mm_cmpge_ps(first, sizes), sizes));
+      }
+      first = _mm_min_ps(_mm_max_ps(first, zero), limits);
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(indices[0] + index), _mm_cvttps_epi32(first)
+      );
+    }
+#else
+    for(std::size_t index = 0; index < BatchSize; ++index) {
+      float position = coordinates[index] * sizeAsFloat;
+      if(isBilinear) {
+        position -= 0.5f;
+      }
+      if(isWrapping) {
+        position -= std::floor(position / sizeAsFloat) * sizeAsFloat;
+      } else {
+        position = clampToRange(position, -1.0f, sizeAsFloat);
+      }
+
+      float first = std::floor(position);
+      if(isBilinear) {
+        float weight = clampToRange(position - first, 0.0f, 1.0f);
+        weights[index] = weight;
+        fixedWeights[index] = static_cast<std::int32_t>(weight * 256.0f + 0.5f);
+
+        float second = first + 1.0f;
+        if(isWrapping && (second >= sizeAsFloat)) {
+          second -= sizeAsFloat;
+        }
+        indices[1][index] = static_cast<std::int32_t>(clampToRange(second, 0.0f, limit));
+      }
+
+      if(isWrapping && (first >= sizeAsFloat)) {
+        first -= sizeAsFloat;
+      }
+      indices[0][index] = static_cast<std::int32_t>(clampToRange(first, 0.0f, limit));
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the pixels and weights needed to sample a batch</summary>
+  /// <typeparam name="TFilter">Filter that will be used to sample the pixels</typeparam>
+  /// <typeparam name="TAddressing">How coordinates outside the bitmap are handled</typeparam>
+  /// <param name="memory">Bitmap memory that will be sampled</param>
+  /// <param name="u">Horizontal coordinates of the batch</param>
+  /// <param name="v">Vertical coordinates of the batch</param>
+  /// <param name="batch">Receives the pixel positions and weights</param>
+  template<Nuclex::Pixels::SamplingFilter TFilter, Nuclex::Pixels::TextureAddressing TAddressing>
+  void calculateTexels(
+    const Nuclex::Pixels::BitmapMemory &memory,
+    const float *u, const float *v, TexelBatch &batch
+  ) {
+    calculateAxis<TFilter, TAddressing>(
+      u, memory.Width, batch.Columns, batch.HorizontalWeights, batch.HorizontalFixedWeights
+    );
+    calculateAxis<TFilter, TAddressing>(
+      v, memory.Height, batch.Rows, batch.VerticalWeights, batch.VerticalFixedWeights
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs a batch kernel over all coordinates, padding the last batch</summary>
+  /// <typeparam name="TChannel">Type in which the color channels are stored</typeparam>
+  /// <typeparam name="TBatchKernel">Kernel that samples a full batch</typeparam>
+  /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+  /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+  /// <param name="count">Number of coordinates that will be sampled</param>
+  /// <param name="rgba">Receives the sampled colors</param>
+  /// <param name="sampleBatch">Kernel that will be invoked for each batch</param>
+  template<typename TChannel, typename TBatchKernel>
+  void forEachBatch(
+    const float *u, const float *v, std::size_t count, TChannel *rgba,
+    TBatchKernel &&sampleBatch
+  ) {
+    while(count >= BatchSize) {
+      sampleBatch(u, v, rgba);
+      u += BatchSize;
+      v += BatchSize;
+      rgba += BatchSize * 4;
+      count -= BatchSize;
+    }
+
+    // The kernels always process full batches, so run the rest through a scratch area
+    if(count > 0) {
+      float paddedU[BatchSize] = {};
+      float paddedV[BatchSize] = {};
+      TChannel paddedRgba[BatchSize * 4];
+      std::copy(u, u + count, paddedU);
+      std::copy(v, v + count, paddedV);
+
+      sampleBatch(paddedU, paddedV, paddedRgba);
+      std::copy(paddedRgba, paddedRgba + count * 4, rgba);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether all pixels can be addressed by 32 bit gather offsets</summary>
+  /// <param name="memory">Bitmap memory that will be sampled</param>
+  /// <returns>True if the byte offset of every pixel fits into an int32</returns>
+  bool canGatherFrom(const Nuclex::Pixels::BitmapMemory &memory) {
+    std::uint64_t stride = static_cast<std::uint64_t>(
+      (memory.Stride < 0) ? -static_cast<std::int64_t>(memory.Stride) : memory.Stride
+    );
+    std::uint64_t furthestOffset = (
+      stride * static_cast<std::uint64_t>(memory.Height - 1) +
+      static_cast<std::uint64_t>(memory.Width) * 4
+    );
+    return (furthestOffset <= 0x7FFFFFFFU);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a pixel format's bytes are laid out as unsigned 8 bit</summary>
+  /// <typeparam name="TTraits">Traits of the pixel format that will be checked</typeparam>
+  template<typename TTraits>
+  struct IsRgba8Format {
+
+    /// <summary>Whether the pixel format stores its channels as unsigned bytes</summary>
+    public: static constexpr bool Value = (
+      (!TTraits::IsFloat) && (!TTraits::IsSigned) && (!TTraits::IsPacked) &&
+      (TTraits::RedBitCount == 8) && (TTraits::BytesPerPixel <= 4)
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the shift that moves a channel into the lowest byte</summary>
+  /// <param name="bitOffset">Bit offset of the channel, -1 if missing</param>
+  /// <returns>The number of bits the pixel needs to be shifted right</returns>
+  constexpr int getChannelShift(int bitOffset) {
+    return (bitOffset < 0) ? 0 : bitOffset;
+  }
+
+  /// <summary>Calculates the mask that isolates a channel in the lowest byte</summary>
+  /// <param name="bitOffset">Bit offset of the channel, -1 if missing</param>
+  /// <returns>The mask that keeps only the channel's bits</returns>
+  constexpr std::uint32_t getChannelMask(int bitOffset) {
+    return (bitOffset < 0) ? 0U : 0xFFU;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a pixel of an 8 bit format with its first byte in the lowest bits</summary>
+  /// <typeparam name="TBytesPerPixel">Number of bytes in each pixel</typeparam>
+  /// <param name="pixel">Address of the pixel that will be read</param>
+  /// <returns>The pixel's bytes, the first byte in the lowest 8 bits</returns>
+  template<std::size_t TBytesPerPixel>
+  NUCLEX_PIXELS_ALWAYS_INLINE inline std::uint32_t loadTexel(const std::uint8_t *pixel) {
+    std::uint32_t texel = 0;
+    for(std::size_t index = 0; index < TBytesPerPixel; ++index) {
+      texel |= static_cast<std::uint32_t>(pixel[index]) << (index * 8);
+    }
+    return texel;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reorders the bytes of pixels into red, green, blue and alpha</summary>
+  /// <typeparam name="TTraits">Traits of the pixel format the pixels are stored in</typeparam>
+  /// <param name="texels">Pixels that will be reordered in place</param>
+  /// <param name="count">Number of pixels, a multiple of 4</param>
+  template<typename TTraits>
+  void swizzleToRgba8(std::uint32_t *texels, std::size_t count) {
+    const int redShift = getChannelShift(TTraits::RedBitOffset);
+    const int greenShift = getChannelShift(TTraits::GreenBitOffset);
+    const int blueShift = getChannelShift(TTraits::BlueBitOffset);
+    const int alphaShift = getChannelShift(TTraits::AlphaBitOffset);
+    const std::uint32_t redMask = getChannelMask(TTraits::RedBitOffset);
+    const std::uint32_t greenMask = getChannelMask(TTraits::GreenBitOffset);
+    const std::uint32_t blueMask = getChannelMask(TTraits::BlueBitOffset);
+
+    // Pixels that already are in RGBA order (or just red) need no reordering
+    const bool isRgbaOrder = (
+      (TTraits::RedBitOffset == 0) && (TTraits::GreenBitOffset == 8) &&
+      (TTraits::BlueBitOffset == 16) && (TTraits::AlphaBitOffset == 24)
+    );
+    if(isRgbaOrder) {
+      return;
+    }
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+    for(std::size_t index = 0; index < count; index += 4) {
+      __m128i *address = reinterpret_cast<__m128i *>(texels + index);
+      __m128i pixels = _mm_loadu_si128(address);
+
+      __m128i red = _mm_and_si128(
+        _mm_srli_epi32(pixels, redShift), _mm_set1_epi32(static_cast<int>(redMask))
+      );
+      __m128i green = _mm_slli_epi32(
+        _mm_and_si128(
+          _mm_srli_epi32(pixels, greenShift), _mm_set1_epi32(static_cast<int>(greenMask))
+        ),
+        8
+      );
+      __m128i blue = _mm_slli_epi32(
+        _mm_and_si128(
+          _mm_srli_epi32(pixels, blueShift), _mm_set1_epi32(static_cast<int>(blueMask))
+        ),
+        16
+      );
+      __m128i alpha = opaque;
+      if(TTraits::HasAlpha) {
+        alpha = _mm_slli_epi32(_mm_srli_epi32(pixels, alphaShift), 24);
+      }
+
+      _mm_storeu_si128(
+        address, _mm_or_si128(_mm_or_si128(red, green), _mm_or_si128(blue, alpha))
+      );
+    }
+#else
+    for(std::size_t index = 0; index < count; ++index) {
+      std::uint32_t pixel = texels[index];
+      texels[index] = (
+        ((pixel >> redShift) & redMask) |
+        (((pixel >> greenShift) & greenMask) << 8) |
+        (((pixel >> blueShift) & blueMask) << 16) |
+        (TTraits::HasAlpha ? (((pixel >> alphaShift) & 0xFFU) << 24) : 0xFF000000U)
+      );
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fetches a batch of pixels from a bitmap with an 8 bit format</summary>
+  /// <typeparam name="TTraits">Traits of the pixel format the bitmap is stored in</typeparam>
+  /// <param name="memory">Bitmap memory the pixels will be fetched from</param>
+  /// <param name="canGather">Whether the pixels can be addressed by gather offsets</param>
+  /// <param name="columns">Column of each pixel that will be fetched</param>
+  /// <param name="rows">Row of each pixel that will be fetched</param>
+  /// <param name="texels">Receives the pixels with their first byte in the lowest bits</param>
+  template<typename TTraits>
+  void fetchRgba8Texels(
+    const Nuclex::Pixels::BitmapMemory &memory, bool canGather,
+    const std::int32_t *columns, const std::int32_t *rows, std::uint32_t *texels
+  ) {
+    const std::uint8_t *pixels = static_cast<const std::uint8_t *>(memory.Pixels);
+
+#if defined(NUCLEX_PIXELS_HAVE_AVX2)
+    if((TTraits::BytesPerPixel == 4) && canGather) {
+      __m256i offsets = _mm256_add_epi32(
+        _mm256_mullo_epi32(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows)),
+          _mm256_set1_epi32(memory.Stride)
+        ),
+        _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns)), 2)
+      );
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(texels),
+        _mm256_i32gather_epi32(reinterpret_cast<const int *>(pixels), offsets, 1)
+      );
+      return;
+    }
+#else
+    (void)canGather;
+#endif
+
+    for(std::size_t index = 0; index < BatchSize; ++index) {
+      const std::uint8_t *pixel = (
+        pixels +
+        static_cast<std::ptrdiff_t>(rows[index]) * memory.Stride +
+        static_cast<std::size_t>(columns[index]) * TTraits::BytesPerPixel
+      );
+      texels[index] = loadTexel<TTraits::BytesPerPixel>(pixel);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fetches a batch of pixels and decodes them into float RGBA</summary>
+  /// <param name="memory">Bitmap memory the pixels will be fetched from</param>
+  /// <param name="batch">Positions of the pixels that will be fetched</param>
+  /// <param name="cornerCount">Number of pixels needed per coordinate, 1 or 4</param>
+  /// <param name="texels">Receives the pixels as four floats each</param>
+  void fetchFloatTexels(
+    const Nuclex::Pixels::BitmapMemory &memory, const TexelBatch &batch,
+    std::size_t cornerCount, float (&texels)[4][BatchSize * 4]
+  ) {
+    const std::uint8_t *pixels = static_cast<const std::uint8_t *>(memory.Pixels);
+    const std::size_t bytesPerPixel = Nuclex::Pixels::CountBitsPerPixel(memory.PixelFormat) / 8;
+
+    // Gather the raw pixels first so they can be decoded with a single call
+    std::uint8_t rawTexels[4 * BatchSize * MaximumBytesPerPixel];
+    std::uint8_t *rawTexel = rawTexels;
+    for(std::size_t corner = 0; corner < cornerCount; ++corner) {
+      const std::int32_t *columns = batch.Columns[corner & 1];
+      const std::int32_t *rows = batch.Rows[corner >> 1];
+      for(std::size_t index = 0; index < BatchSize; ++index) {
+        const std::uint8_t *pixel = (
+          pixels +
+          static_cast<std::ptrdiff_t>(rows[index]) * memory.Stride +
+          static_cast<std::size_t>(columns[index]) * bytesPerPixel
+        );
+        std::memcpy(rawTexel, pixel, bytesPerPixel);
+        rawTexel += bytesPerPixel;
+      }
+    }
+
+    Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+      memory.PixelFormat, rawTexels,
+      Nuclex::Pixels::FilterPixelFormat, texels[0],
+      cornerCount * BatchSize
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a batch of RGBA pixels as bytes</summary>
+  /// <param name="texels">Pixels with red in the lowest and alpha in the highest bits</param>
+  /// <param name="rgba">Receives the pixels as four bytes each</param>
+  void storeRgba8(const std::uint32_t *texels, std::uint8_t *rgba) {
+    for(std::size_t index = 0; index < BatchSize; ++index) {
+      std::uint32_t texel = texels[index];
+      rgba[0] = static_cast<std::uint8_t>(texel);
+      rgba[1] = static_cast<std::uint8_t>(texel >> 8);
+      rgba[2] = static_cast<std::uint8_t>(texel >> 16);
+      rgba[3] = static_cast<std::uint8_t>(texel >> 24);
+      rgba += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Expands RGBA pixels stored as bytes into floats</summary>
+  /// <param name="texels">Pixels with red in the lowest and alpha in the highest bits</param>
+  /// <param name="count">Number of pixels that will be expanded</param>
+  /// <param name="rgba">Receives the pixels as four floats each</param>
+  void expandRgba8(const std::uint32_t *texels, std::size_t count, float *rgba) {
+    const float scale = 1.0f / 255.0f;
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 scales = _mm_set1_ps(scale);
+    for(std::size_t index = 0; index < count; ++index) {
+      __m128i channels = _mm_unpacklo_epi16(
+        _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(texels[index])), zero), zero
+      );
+      _mm_storeu_ps(rgba, _mm_mul_ps(_mm_cvtepi32_ps(channels), scales));
+      rgba += 4;
+    }
+#else
+    for(std::size_t index = 0; index < count; ++index) {
+      std::uint32_t texel = texels[index];
+      rgba[0] = static_cast<float>(texel & 0xFF) * scale;
+      rgba[1] = static_cast<float>((texel >> 8) & 0xFF) * scale;
+      rgba[2] = static_cast<float>((texel >> 16) & 0xFF) * scale;
+      rgba[3] = static_cast<float>(texel >> 24) * scale;
+      rgba += 4;
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a batch of float colors into bytes</summary>
+  /// <param name="colors">Colors as four floats each</param>
+  /// <param name="rgba">Receives the colors as four bytes each</param>
+  void quantizeToRgba8(const float *colors, std::uint8_t *rgba) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    __m128i quantized[4];
+    for(std::size_t index = 0; index < BatchSize * 4; index += 16) {
+      for(std::size_t part = 0; part < 4; ++part) {
+        __m128 color = _mm_loadu_ps(colors + index + part * 4);
+        color = _mm_min_ps(_mm_max_ps(color, zero), one); // NaNs become zero
+        quantized[part] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(color, scale), half));
+      }
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(rgba + index),
+        _mm_packus_epi16(
+          _mm_packs_epi32(quantized[0], quantized[1]),
+          _mm_packs_epi32(quantized[2], quantized[3])
+        )
+      );
+    }
+#else
+    for(std::size_t index = 0; index < BatchSize * 4; ++index) {
+      rgba[index] = static_cast<std::uint8_t>(
+        clampToRange(colors[index], 0.0f, 1.0f) * 255.0f + 0.5f
+      );
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+  /// <summary>Interpolates between two sets of 16 bit channels in fixed point</summary>
+  /// <param name="first">Channels the interpolation starts at</param>
+  /// <param name="second">Channels the interpolation ends at</param>
+  /// <param name="weights">Weights of the second channels, from 0 to 256</param>
+  /// <returns>The interpolated channels</returns>
+  inline __m128i lerpFixed(__m128i first, __m128i second, __m128i weights) {
+    __m128i inverseWeights = _mm_sub_epi16(_mm_set1_epi16(256), weights);
+
+    // At most 255 * 256 + 128, so the sum never leaves the unsigned 16 bit range
+    return _mm_srli_epi16(
+      _mm_add_epi16(
+        _mm_add_epi16(
+          _mm_mullo_epi16(first, inverseWeights), _mm_mullo_epi16(second, weights)
+        ),
+        _mm_set1_epi16(128)
+      ),
+      8
+    );
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Interpolates a batch of RGBA byte pixels bilinearly in fixed point</summary>
+  /// <param name="texels">Top left, top right, bottom left and bottom right pixels</param>
+  /// <param name="batch">Filter weights for each coordinate</param>
+  /// <param name="rgba">Receives the interpolated colors as four bytes each</param>
+  void blendRgba8(
+    const std::uint32_t (&texels)[4][BatchSize], const TexelBatch &batch, std::uint8_t *rgba
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for(std::size_t index = 0; index < BatchSize; index += 4) {
+
+      // Repeat each pixel's weight in the four 16 bit slots of its channels
+      __m128i horizontal = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(batch.HorizontalFixedWeights + index)
+      );
+      horizontal = _mm_or_si128(horizontal, _mm_slli_epi32(horizontal, 16));
+      __m128i vertical = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(batch.VerticalFixedWeights + index)
+      );
+      vertical = _mm_or_si128(vertical, _mm_slli_epi32(vertical, 16));
+
+      __m128i corners[4];
+      for(std::size_t corner = 0; corner < 4; ++corner) {
+        corners[corner] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(texels[corner] + index)
+        );
+      }
+
+      __m128i low = lerpFixed(
+        lerpFixed(
+          _mm_unpacklo_epi8(corners[0], zero), _mm_unpacklo_epi8(corners[1], zero),
+          _mm_unpacklo_epi32(horizontal, horizontal)
+        ),
+        lerpFixed(
+          _mm_unpacklo_epi8(corners[2], zero), _mm_unpacklo_epi8(corners[3], zero),
+          _mm_unpacklo_epi32(horizontal, horizontal)
+        ),
+        _mm_unpacklo_epi32(vertical, vertical)
+      );
+      __m128i high = lerpFixed(
+        lerpFixed(
+          _mm_unpackhi_epi8(corners[0], zero), _mm_unpackhi_epi8(corners[1], zero),
+          _mm_unpackhi_epi32(horizontal, horizontal)
+        ),
+        lerpFixed(
+          _mm_unpackhi_epi8(corners[2], zero), _mm_unpackhi_epi8(corners[3], zero),
+          _mm_unpackhi_epi32(horizontal, horizontal)
+        ),
+        _mm_unpackhi_epi32(vertical, vertical)
+      );
+
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(rgba + index * 4), _mm_packus_epi16(low, high)
+      );
+    }
+#else
+    for(std::size_t index = 0; index < BatchSize; ++index) {
+      std::uint32_t horizontal = static_cast<std::uint32_t>(batch.HorizontalFixedWeights[index]);
+      std::uint32_t vertical = static_cast<std::uint32_t>(batch.VerticalFixedWeights[index]);
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        std::size_t shift = channel * 8;
+        std::uint32_t top = (
+          ((texels[0][index] >> shift) & 0xFF) * (256 - horizontal) +
+          ((texels[1][index] >> shift) & 0xFF) * horizontal +
+          128
+        ) >> 8;
+        std::uint32_t bottom = (
+          ((texels[2][index] >> shift) & 0xFF) * (256 - horizontal) +
+          ((texels[3][index] >> shift) & 0xFF) * horizontal +
+          128
+        ) >> 8;
+        rgba[index * 4 + channel] = static_cast<std::uint8_t>(
+          (top * (256 - vertical) + bottom * vertical + 128) >> 8
+        );
+      }
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Interpolates a batch of float RGBA pixels bilinearly</summary>
+  /// <param name="texels">Top left, top right, bottom left and bottom right pixels</param>
+  /// <param name="batch">Filter weights for each coordinate</param>
+  /// <param name="rgba">Receives the interpolated colors as four floats each</param>
+  void blendFloats(
+    const float (&texels)[4][BatchSize * 4], const TexelBatch &batch, float *rgba
+  ) {
+    for(std::size_t index = 0; index < BatchSize; ++index) {
+      const std::size_t offset = index * 4;
+      const float horizontal = batch.HorizontalWeights[index];
+      const float vertical = batch.VerticalWeights[index];
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+      __m128 topLeft = _mm_loadu_ps(texels[0] + offset);
+      __m128 bottomLeft = _mm_loadu_ps(texels[2] + offset);
+      __m128 horizontals = _mm_set1_ps(horizontal);
+      __m128 top = _mm_add_ps(
+        topLeft,
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(texels[1] + offset), topLeft), horizontals)
+      );
+      __m128 bottom = _mm_add_ps(
+        bottomLeft,
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(texels[3] + offset), bottomLeft), horizontals)
+      );
+      _mm_storeu_ps(
+        rgba + offset,
+        _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), _mm_set1_ps(vertical)))
+      );
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+      float32x4_t topLeft = vld1q_f32(texels[0] + offset);
+      float32x4_t bottomLeft = vld1q_f32(texels[2] + offset);
+      float32x4_t top = vmlaq_n_f32(
+        topLeft, vsubq_f32(vld1q_f32(texels[1] + offset), topLeft), horizontal
+      );
+      float32x4_t bottom = vmlaq_n_f32(
+        bottomLeft, vsubq_f32(vld1q_f32(texels[3] + offset), bottomLeft), horizontal
+      );
+      vst1q_f32(rgba + offset, vmlaq_n_f32(top, vsubq_f32(bottom, top), vertical));
+#else
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        float top = texels[0][offset + channel] + (
+          (texels[1][offset + channel] - texels[0][offset + channel]) * horizontal
+        );
+        float bottom = texels[2][offset + channel] + (
+          (texels[3][offset + channel] - texels[2][offset + channel]) * horizontal
+        );
+        rgba[offset + channel] = top + (bottom - top) * vertical;
+      }
+#endif
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sampling kernels specialized for a pixel format with 8 bit channels</summary>
+  /// <typeparam name="TTraits">Traits of the pixel format the bitmap is stored in</typeparam>
+  /// <typeparam name="TFilter">Filter that will be used to sample the pixels</typeparam>
+  /// <typeparam name="TAddressing">How coordinates outside the bitmap are handled</typeparam>
+  template<
+    typename TTraits,
+    Nuclex::Pixels::SamplingFilter TFilter,
+    Nuclex::Pixels::TextureAddressing TAddressing
+  >
+  struct Rgba8Kernels {
+
+    /// <summary>Whether the four closest pixels are interpolated</summary>
+    public: static constexpr bool IsBilinear = (
+      TFilter == Nuclex::Pixels::SamplingFilter::Bilinear
+    );
+
+    /// <summary>Fetches the pixels needed to sample a batch as RGBA bytes</summary>
+    /// <param name="memory">Bitmap memory that will be sampled</param>
+    /// <param name="canGather">Whether the pixels can be addressed by gather offsets</param>
+    /// <param name="u">Horizontal coordinates of the batch</param>
+    /// <param name="v">Vertical coordinates of the batch</param>
+    /// <param name="batch">Receives the pixel positions and weights</param>
+    /// <param name="texels">Receives the pixels with red in the lowest bits</param>
+    public: static void FetchBatch(
+      const Nuclex::Pixels::BitmapMemory &memory, bool canGather,
+      const float *u, const float *v, TexelBatch &batch, std::uint32_t (&texels)[4][BatchSize]
+    ) {
+      calculateTexels<TFilter, TAddressing>(memory, u, v, batch);
+
+      std::size_t cornerCount = IsBilinear ? 4 : 1;
+      for(std::size_t corner = 0; corner < cornerCount; ++corner) {
+        fetchRgba8Texels<TTraits>(
+          memory, canGather, batch.Columns[corner & 1], batch.Rows[corner >> 1], texels[corner]
+        );
+      }
+      swizzleToRgba8<TTraits>(texels[0], cornerCount * BatchSize);
+    }
+
+    /// <summary>Samples a bitmap as float colors</summary>
+    /// <param name="memory">Bitmap memory that will be sampled</param>
+    /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+    /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+    /// <param name="count">Number of coordinates that will be sampled</param>
+    /// <param name="rgba">Receives the sampled colors as four floats each</param>
+    public: static void SampleFloats(
+      const Nuclex::Pixels::BitmapMemory &memory,
+      const float *u, const float *v, std::size_t count, float *rgba
+    ) {
+      bool canGather = canGatherFrom(memory);
+      forEachBatch(
+        u, v, count, rgba,
+        [&memory, canGather](const float *batchU, const float *batchV, float *batchRgba) {
+          TexelBatch batch;
+          std::uint32_t texels[4][BatchSize];
+          FetchBatch(memory, canGather, batchU, batchV, batch, texels);
+
+          if(IsBilinear) {
+            float expanded[4][BatchSize * 4];
+            expandRgba8(texels[0], 4 * BatchSize, expanded[0]);
+            blendFloats(expanded, batch, batchRgba);
+          } else {
+            expandRgba8(texels[0], BatchSize, batchRgba);
+          }
+        }
+      );
+    }
+
+    /// <summary>Samples a bitmap as 8 bit colors</summary>
+    /// <param name="memory">Bitmap memory that will be sampled</param>
+    /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+    /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+    /// <param name="count">Number of coordinates that will be sampled</param>
+    /// <param name="rgba">Receives the sampled colors as four bytes each</param>
+    public: static void SampleBytes(
+      const Nuclex::Pixels::BitmapMemory &memory,
+      const float *u, const float *v, std::size_t count, std::uint8_t *rgba
+    ) {
+      bool canGather = canGatherFrom(memory);
+      forEachBatch(
+        u, v, count, rgba,
+        [&memory, canGather](const float *batchU, const float *batchV, std::uint8_t *batchRgba) {
+          TexelBatch batch;
+          std::uint32_t texels[4][BatchSize];
+          FetchBatch(memory, canGather, batchU, batchV, batch, texels);
+
+          if(IsBilinear) {
+            blendRgba8(texels, batch, batchRgba);
+          } else {
+            storeRgba8(texels[0], batchRgba);
+          }
+        }
+      );
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sampling kernels for any pixel format the converter can decode</summary>
+  /// <typeparam name="TFilter">Filter that will be used to sample the pixels</typeparam>
+  /// <typeparam name="TAddressing">How coordinates outside the bitmap are handled</typeparam>
+  template<Nuclex::Pixels::SamplingFilter TFilter, Nuclex::Pixels::TextureAddressing TAddressing>
+  struct GenericKernels {
+
+    /// <summary>Whether the four closest pixels are interpolated</summary>
+    public: static constexpr bool IsBilinear = (
+      TFilter == Nuclex::Pixels::SamplingFilter::Bilinear
+    );
+
+    /// <summary>Samples a batch of coordinates as float colors</summary>
+    /// <param name="memory">Bitmap memory that will be sampled</param>
+    /// <param name="u">Horizontal coordinates of the batch</param>
+    /// <param name="v">Vertical coordinates of the batch</param>
+    /// <param name="rgba">Receives the sampled colors as four floats each</param>
+    public: static void SampleBatch(
+      const Nuclex::Pixels::BitmapMemory &memory, const float *u, const float *v, float *rgba
+    ) {
+      TexelBatch batch;
+      calculateTexels<TFilter, TAddressing>(memory, u, v, batch);
+
+      float texels[4][BatchSize * 4];
+      if(IsBilinear) {
+        fetchFloatTexels(memory, batch, 4, texels);
+        blendFloats(texels, batch, rgba);
+      } else {
+        fetchFloatTexels(memory, batch, 1, texels);
+        std::copy(texels[0], texels[0] + BatchSize * 4, rgba);
+      }
+    }
+
+    /// <summary>Samples a bitmap as float colors</summary>
+    /// <param name="memory">Bitmap memory that will be sampled</param>
+    /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+    /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+    /// <param name="count">Number of coordinates that will be sampled</param>
+    /// <param name="rgba">Receives the sampled colors as four floats each</param>
+    public: static void SampleFloats(
+      const Nuclex::Pixels::BitmapMemory &memory,
+      const float *u, const float *v, std::size_t count, float *rgba
+    ) {
+      forEachBatch(
+        u, v, count, rgba,
+        [&memory](const float *batchU, const float *batchV, float *batchRgba) {
+          SampleBatch(memory, batchU, batchV, batchRgba);
+        }
+      );
+    }
+
+    /// <summary>Samples a bitmap as 8 bit colors</summary>
+    /// <param name="memory">Bitmap memory that will be sampled</param>
+    /// <param name="u">Horizontal coordinates at which the bitmap will be sampled</param>
+    /// <param name="v">Vertical coordinates at which the bitmap will be sampled</param>
+    /// <param name="count">Number of coordinates that will be sampled</param>
+    /// <param name="rgba">Receives the sampled colors as four bytes each</param>
+    public: static void SampleBytes(
+      const Nuclex::Pixels::BitmapMemory &memory,
+      const float *u, const float *v, std::size_t count, std::uint8_t *rgba
+    ) {
+      forEachBatch(
+        u, v, count, rgba,
+        [&memory](const float *batchU, const float *batchV, std::uint8_t *batchRgba) {
+          float colors[BatchSize * 4];
+          SampleBatch(memory, batchU, batchV, colors);
+          quantizeToRgba8(colors, batchRgba);
+        }
+      );
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the family of sampling kernels suited to a pixel format</summary>
+  /// <typeparam name="TTraits">Traits of the pixel format that will be sampled</typeparam>
+  /// <typeparam name="TIsRgba8">Whether the pixel format has unsigned 8 bit channels</typeparam>
+  template<typename TTraits, bool TIsRgba8 = IsRgba8Format<TTraits>::Value>
+  struct KernelFamily {
+
+    /// <summary>Kernels for the specified filter and addressing mode</summary>
+    template<
+      Nuclex::Pixels::SamplingFilter TFilter, Nuclex::Pixels::TextureAddressing TAddressing
+    >
+    using Kernels = Rgba8Kernels<TTraits, TFilter, TAddressing>;
+
+  };
+
+  /// <summary>Picks the generic sampling kernels for other pixel formats</summary>
+  /// <typeparam name="TTraits">Traits of the pixel format that will be sampled</typeparam>
+  template<typename TTraits>
+  struct KernelFamily<TTraits, false> {
+
+    /// <summary>Kernels for the specified filter and addressing mode</summary>
+    template<
+      Nuclex::Pixels::SamplingFilter TFilter, Nuclex::Pixels::TextureAddressing TAddressing
+    >
+    using Kernels = GenericKernels<TFilter, TAddressing>;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Selects the kernels for an addressing mode known at runtime</summary>
+  /// <typeparam name="TKernels">Kernels specialized for a filter and addressing mode</typeparam>
+  /// <typeparam name="TFilter">Filter that will be used to sample the pixels</typeparam>
+  /// <param name="addressing">How coordinates outside the bitmap are handled</param>
+  /// <param name="sampleFloats">Receives the kernel sampling float colors</param>
+  /// <param name="sampleBytes">Receives the kernel sampling 8 bit colors</param>
+  template<
+    template<Nuclex::Pixels::SamplingFilter, Nuclex::Pixels::TextureAddressing> class TKernels,
+    Nuclex::Pixels::SamplingFilter TFilter
+  >
+  void selectKernels(
+    Nuclex::Pixels::TextureAddressing addressing,
+    SampleFloatsFunction *&sampleFloats, SampleBytesFunction *&sampleBytes
+  ) {
+    using Nuclex::Pixels::TextureAddressing;
+
+    switch(addressing) {
+      case TextureAddressing::Clamp: {
+        sampleFloats = &TKernels<TFilter, TextureAddressing::Clamp>::SampleFloats;
+        sampleBytes = &TKernels<TFilter, TextureAddressing::Clamp>::SampleBytes;
+        break;
+      }
+      case TextureAddressing::Wrap: {
+        sampleFloats = &TKernels<TFilter, TextureAddressing::Wrap>::SampleFloats;
+        sampleBytes = &TKernels<TFilter, TextureAddressing::Wrap>::SampleBytes;
+        break;
+      }
+      default: {
+        throw std::invalid_argument(u8"Unknown texture addressing mode");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Selects the kernels for a filter and addressing mode known at runtime</summary>
+  /// <typeparam name="TKernels">Kernels specialized for a filter and addressing mode</typeparam>
+  /// <param name="filter">Filter that will be used to sample the pixels</param>
+  /// <param name="addressing">How coordinates outside the bitmap are handled</param>
+  /// <param name="sampleFloats">Receives the kernel sampling float colors</param>
+  /// <param name="sampleBytes">Receives the kernel sampling 8 bit colors</param>
+  template<
+    template<Nuclex::Pixels::SamplingFilter, Nuclex::Pixels::TextureAddressing> class TKernels
+  >
+  void selectKernels(
+    Nuclex::Pixels::SamplingFilter filter, Nuclex::Pixels::TextureAddressing addressing,
+    SampleFloatsFunction *&sampleFloats, SampleBytesFunction *&sampleBytes
+  ) {
+    using Nuclex::Pixels::SamplingFilter;
+
+    switch(filter) {
+      case SamplingFilter::Nearest: {
+        selectKernels<TKernels, SamplingFilter::Nearest>(addressing, sampleFloats, sampleBytes);
+        break;
+      }
+      case SamplingFilter::Bilinear: {
+        selectKernels<TKernels, SamplingFilter::Bilinear>(addressing, sampleFloats, sampleBytes);
+        break;
+      }
+      default: {
+        throw std::invalid_argument(u8"Unknown sampling filter");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BitmapSampler::CanSample(PixelFormat pixelFormat) {
+    return PixelFormatConverter::CanConvert(pixelFormat, FilterPixelFormat);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapSampler::BitmapSampler(
+    const BitmapMemory &memory,
+    SamplingFilter filter /* = SamplingFilter::Bilinear */,
+    TextureAddressing addressing /* = TextureAddressing::Clamp */
+  ) :
+    memory(memory),
+    sampleFloats(nullptr),
+    sampleBytes(nullptr) {
+
+    if(!CanSample(memory.PixelFormat)) {
+      throw std::runtime_error(u8"Sampling bitmaps of this pixel format is not supported");
+    }
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::runtime_error(u8"Provided bitmap does not contain any pixels");
+    }
+
+    // Unsigned 8 bit formats get kernels specialized for their channel layout,
+    // all other formats are decoded into floats by the pixel format converter
+    VisitPixelFormat(
+      memory.PixelFormat,
+      [&](auto traits) {
+        selectKernels<KernelFamily<decltype(traits)>::template Kernels>(
+          filter, addressing, this->sampleFloats, this->sampleBytes
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
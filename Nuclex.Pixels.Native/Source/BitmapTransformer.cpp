@@ -0,0 +1,702 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapTransformer.h"
+
+#include <algorithm> // for std::reverse(), std::swap(), std::swap_ranges()
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Width and height of the tiles bitmaps are transposed in, in pixels</summary>
+  /// <remarks>
+  ///   A source tile and its target tile of 32 pixels with 4 bytes each occupy 8 KiB,
+  ///   leaving plenty of the L1 cache for the rows' neighbouring cache lines. Needs to
+  ///   be a multiple of the largest SIMD kernel size.
+  /// </remarks>
+  const std::size_t TileSize = 32;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel without an integer type of matching size</summary>
+  /// <typeparam name="ByteCount">Number of bytes in the pixel</typeparam>
+  template<std::size_t ByteCount>
+  struct PixelBytes {
+    /// <summary>Contents of the pixel</summary>
+    public: std::uint8_t Bytes[ByteCount];
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Passes a pixel type to a generic lambda</summary>
+  /// <typeparam name="TPixel">Type that will be passed on</typeparam>
+  template<typename TPixel>
+  struct PixelTag {
+    /// <summary>Type representing a single pixel</summary>
+    typedef TPixel Type;
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Invokes a callback with a type whose size matches the pixel format's pixels</summary>
+  /// <typeparam name="TCallback">Callback that will be invoked with a pixel tag</typeparam>
+  /// <param name="pixelFormat">Pixel format whose pixel size will be looked up</param>
+  /// <param name="callback">Callback that will be invoked with the matching pixel tag</param>
+  template<typename TCallback>
+  void dispatchByPixelSize(Nuclex::Pixels::PixelFormat pixelFormat, TCallback &&callback) {
+    Nuclex::Pixels::Size blockSize = Nuclex::Pixels::GetBlockSize(pixelFormat);
+    std::size_t bitCount = Nuclex::Pixels::CountBitsPerPixel(pixelFormat);
+    if((blockSize.Width != 1) || (blockSize.Height != 1) || ((bitCount % 8) != 0)) {
+      throw std::invalid_argument(u8"Pixels of block-compressed formats can not be moved");
+    }
+
+    switch(bitCount / 8) {
+      case 1: { callback(PixelTag<std::uint8_t>()); break; }
+      case 2: { callback(PixelTag<std::uint16_t>()); break; }
+      case 3: { callback(PixelTag<PixelBytes<3>>()); break; }
+      case 4: { callback(PixelTag<std::uint32_t>()); break; }
+      case 8: { callback(PixelTag<std::uint64_t>()); break; }
+      case 16: { callback(PixelTag<PixelBytes<16>>()); break; }
+      default: {
+        throw std::invalid_argument(u8"Pixel format uses an unsupported number of bytes");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the address of a row in a bitmap</summary>
+  /// <param name="memory">Bitmap memory in which the row will be looked up</param>
+  /// <param name="y">Index of the row whose address will be returned</param>
+  /// <returns>The address of the first pixel in the requested row</returns>
+  std::uint8_t *getRow(const Nuclex::Pixels::BitmapMemory &memory, std::size_t y) {
+    return static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Transposes a square block of pixels</summary>
+  /// <typeparam name="TPixel">Type representing a single pixel</typeparam>
+  /// <remarks>
+  ///   The general case moves a single pixel, specializations transpose larger blocks
+  ///   with SIMD instructions. Size is the width and height of the block.
+  /// </remarks>
+  template<typename TPixel>
+  struct TransposeKernel {
+
+    /// <summary>Width and height of the block the kernel transposes</summary>
+    public: static const std::size_t Size = 1;
+
+    /// <summary>Transposes a block of pixels</summary>
+    /// <param name="source">Address of the block's upper left pixel in the source</param>
+    /// <param name="sourceStride">Distance between two rows in the source</param>
+    /// <param name="target">Address of the block's upper left pixel in the target</param>
+    /// <param name="targetStride">Distance between two rows in the target</param>
+    public: static void Transpose(
+      const std::uint8_t *source, std::ptrdiff_t sourceStride,
+      std::uint8_t *target, std::ptrdiff_t targetStride
+    ) {
+      (void)sourceStride;
+      (void)targetStride;
+      *reinterpret_cast<TPixel *>(target) = *reinterpret_cast<const TPixel *>(source);
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+
+  /// <summary>Transposes blocks of 8x8 pixels with 8 bits each</summary>
+  template<>
+  struct TransposeKernel<std::uint8_t> {
+
+    /// <summary>Width and height of the block the kernel transposes</summary>
+    public: static const std::size_t Size = 8;
+
+    /// <summary>Transposes a block of pixels</summary>
+    /// <param name="source">Address of the block's upper left pixel in the source</param>
+    /// <param name="sourceStride">Distance between two rows in the source</param>
+    /// <param name="target">Address of the block's upper left pixel in the target</param>
+    /// <param name="targetStride">Distance between two rows in the target</param>
+    public: static void Transpose(
+      const std::uint8_t *source, std::ptrdiff_t sourceStride,
+      std::uint8_t *target, std::ptrdiff_t targetStride
+    ) {
+      __m128i rows[8];
+      for(std::size_t index = 0; index < 8; ++index) {
+        rows[index] = _mm_loadl_epi64(
+          reinterpret_cast<const __m128i *>(source + sourceStride * std::ptrdiff_t(index))
+        );
+      }
+
+      // Interleave bytes, then pairs, then quads of rows until each 8 byte half
+      // of a register holds one column
+      __m128i pairs[4];
+      for(std::size_t index = 0; index < 4; ++index) {
+        pairs[index] = _mm_unpacklo_epi8(rows[index * 2], rows[index * 2 + 1]);
+      }
+      __m128i quads[4];
+      quads[0] = _mm_unpacklo_epi16(pairs[0], pairs[1]);
+      quads[1] = _mm_unpackhi_epi16(pairs[0], pairs[1]);
+      quads[2] = _mm_unpacklo_epi16(pairs[2], pairs[3]);
+      quads[3] = _mm_unpackhi_epi16(pairs[2], pairs[3]);
+      __m128i columns[4];
+      columns[0] = _mm_unpacklo_epi32(quads[0], quads[2]);
+      columns[1] = _mm_unpackhi_epi32(quads[0], quads[2]);
+      columns[2] = _mm_unpacklo_epi32(quads[1], quads[3]);
+      columns[3] = _mm_unpackhi_epi32(quads[1], quads[3]);
+
+      for(std::size_t index = 0; index < 4; ++index) {
+        _mm_storel_epi64(
+          reinterpret_cast<__m128i *>(target + targetStride * std::ptrdiff_t(index * 2)),
+          columns[index]
+        );
+        _mm_storel_epi64(
+          reinterpret_cast<__m128i *>(target + targetStride * std::ptrdiff_t(index * 2 + 1)),
+          _mm_unpackhi_epi64(columns[index], columns[index])
+        );
+      }
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Transposes blocks of 8x8 pixels with 16 bits each</summary>
+  template<>
+  struct TransposeKernel<std::uint16_t> {
+
+    /// <summary>Width and height of the block the kernel transposes</summary>
+    public: static const std::size_t Size = 8;
+
+    /// <summary>Transposes a block of pixels</summary>
+    /// <param name="source">Address of the block's upper left pixel in the source</param>
+    /// <param name="sourceStride">Distance between two rows in the source</param>
+    /// <param name="target">Address of the block's upper left pixel in the target</param>
+    /// <param name="targetStride">Distance between two rows in the target</param>
+    public: static void Transpose(
+      const std::uint8_t *source, std::ptrdiff_t sourceStride,
+      std::uint8_t *target, std::ptrdiff_t targetStride
+    ) {
+      __m128i rows[8];
+      for(std::size_t index = 0; index < 8; ++index) {
+        rows[index] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(source + sourceStride * std::ptrdiff_t(index))
+        );
+      }
+
+      __m128i pairs[8];
+      for(std::size_t index = 0; index < 4; ++index) {
+        pairs[index * 2] = _mm_unpacklo_epi16(rows[index * 2], rows[index * 2 + 1]);
+        pairs[index * 2 + 1] = _mm_unpackhi_epi16(rows[index * 2], rows[index * 2 + 1]);
+      }
+      __m128i quads[8];
+      quads[0] = _mm_unpacklo_epi32(pairs[0], pairs[2]);
+      quads[1] = _mm_unpackhi_epi32(pairs[0], pairs[2]);
+      quads[2] = _mm_unpacklo_epi32(pairs[1], pairs[3]);
+      quads[3] = _mm_unpackhi_epi32(pairs[1], pairs[3]);
+      quads[4] = _mm_unpacklo_epi32(pairs[4], pairs[6]);
+      quads[5] = _mm_unpackhi_epi32(pairs[4], pairs[6]);
+      quads[6] = _mm_unpacklo_epi32(pairs[5], pairs[7]);
+      quads[7] = _mm_unpackhi_epi32(pairs[5], pairs[7]);
+
+      for(std::size_t index = 0; index < 4; ++index) {
+        _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(target + targetStride * std::ptrdiff_t(index * 2)),
+          _mm_unpacklo_epi64(quads[index], quads[index + 4])
+        );
+        _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(target + targetStride * std::ptrdiff_t(index * 2 + 1)),
+          _mm_unpackhi_epi64(quads[index], quads[index + 4])
+        );
+      }
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Transposes blocks of 4x4 pixels with 32 bits each</summary>
+  template<>
+  struct TransposeKernel<std::uint32_t> {
+
+    /// <summary>Width and height of the block the kernel transposes</summary>
+    public: static const std::size_t Size = 4;
+
+    /// <summary>Transposes a block of pixels</summary>
+    /// <param name="source">Address of the block's upper left pixel in the source</param>
+    /// <param name="sourceStride">Distance between two rows in the source</param>
+    /// <param name="target">Address of the block's upper left pixel in the target</param>
+    /// <param name="targetStride">Distance between two rows in the target</param>
+    public: static void Transpose(
+      const std::uint8_t *source, std::ptrdiff_t sourceStride,
+      std::uint8_t *target, std::ptrdiff_t targetStride
+    ) {
+      __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+      __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + sourceStride));
+      __m128i row2 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(source + sourceStride * 2)
+      );
+      __m128i row3 = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(source + sourceStride * 3)
+      );
+
+      __m128i low01 = _mm_unpacklo_epi32(row0, row1);
+      __m128i low23 = _mm_unpacklo_epi32(row2, row3);
+      __m128i high01 = _mm_unpackhi_epi32(row0, row1);
+      __m128i high23 = _mm_unpackhi_epi32(row2, row3);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_unpacklo_epi64(low01, low23));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(target + targetStride), _mm_unpackhi_epi64(low01, low23)
+      );
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(target + targetStride * 2),
+        _mm_unpacklo_epi64(high01, high23)
+      );
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(target + targetStride * 3),
+        _mm_unpackhi_epi64(high01, high23)
+      );
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Transposes blocks of 2x2 pixels with 64 bits each</summary>
+  template<>
+  struct TransposeKernel<std::uint64_t> {
+
+    /// <summary>Width and height of the block the kernel transposes</summary>
+    public: static const std::size_t Size = 2;
+
+    /// <summary>Transposes a block of pixels</summary>
+    /// <param name="source">Address of the block's upper left pixel in the source</param>
+    /// <param name="sourceStride">Distance between two rows in the source</param>
+    /// <param name="target">Address of the block's upper left pixel in the target</param>
+    /// <param name="targetStride">Distance between two rows in the target</param>
+    public: static void Transpose(
+      const std::uint8_t *source, std::ptrdiff_t sourceStride,
+      std::uint8_t *target, std::ptrdiff_t targetStride
+    ) {
+      __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+      __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + sourceStride));
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_unpacklo_epi64(row0, row1));
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(target + targetStride), _mm_unpackhi_epi64(row0, row1)
+      );
+    }
+
+  };
+
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+
+  /// <summary>Transposes blocks of 4x4 pixels with 32 bits each</summary>
+  template<>
+  struct TransposeKernel<std::uint32_t> {
+
+    /// <summary>Width and height of the block the kernel transposes</summary>
+    public: static const std::size_t Size = 4;
+
+    /// <summary>Transposes a block of pixels</summary>
+    /// <param name="source">Address of the block's upper left pixel in the source</param>
+    /// <param name="sourceStride">Distance between two rows in the source</param>
+    /// <param name="target">Address of the block's upper left pixel in the target</param>
+    /// <param name="targetStride">Distance between two rows in the target</param>
+    public: static void Transpose(
+      const std::uint8_t *source, std::ptrdiff_t sourceStride,
+      std::uint8_t *target, std::ptrdiff_t targetStride
+    ) {
+      uint32x4x2_t rows01 = vtrnq_u32(
+        vld1q_u32(reinterpret_cast<const std::uint32_t *>(source)),
+        vld1q_u32(reinterpret_cast<const std::uint32_t *>(source + sourceStride))
+      );
+      uint32x4x2_t rows23 = vtrnq_u32(
+        vld1q_u32(reinterpret_cast<const std::uint32_t *>(source + sourceStride * 2)),
+        vld1q_u32(reinterpret_cast<const std::uint32_t *>(source + sourceStride * 3))
+      );
+
+      vst1q_u32(
+        reinterpret_cast<std::uint32_t *>(target),
+        vcombine_u32(vget_low_u32(rows01.val[0]), vget_low_u32(rows23.val[0]))
+      );
+      vst1q_u32(
+        reinterpret_cast<std::uint32_t *>(target + targetStride),
+        vcombine_u32(vget_low_u32(rows01.val[1]), vget_low_u32(rows23.val[1]))
+      );
+      vst1q_u32(
+        reinterpret_cast<std::uint32_t *>(target + targetStride * 2),
+        vcombine_u32(vget_high_u32(rows01.val[0]), vget_high_u32(rows23.val[0]))
+      );
+      vst1q_u32(
+        reinterpret_cast<std::uint32_t *>(target + targetStride * 3),
+        vcombine_u32(vget_high_u32(rows01.val[1]), vget_high_u32(rows23.val[1]))
+      );
+    }
+
+  };
+
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Transposes a tile of pixels</summary>
+  /// <typeparam name="TPixel">Type representing a single pixel</typeparam>
+  /// <param name="source">Address of the tile's upper left pixel in the source</param>
+  /// <param name="sourceStride">Distance between two rows in the source</param>
+  /// <param name="target">Address of the tile's upper left pixel in the target</param>
+  /// <param name="targetStride">Distance between two rows in the target</param>
+  /// <param name="width">Width of the tile in the source</param>
+  /// <param name="height">Height of the tile in the source</param>
+  template<typename TPixel>
+  void transposeTile(
+    const std::uint8_t *source, std::ptrdiff_t sourceStride,
+    std::uint8_t *target, std::ptrdiff_t targetStride,
+    std::size_t width, std::size_t height
+  ) {
+    typedef TransposeKernel<TPixel> Kernel;
+
+    // Transpose as much of the tile as possible in blocks the kernel can handle
+    std::size_t blockedWidth = width - (width % Kernel::Size);
+    std::size_t blockedHeight = height - (height % Kernel::Size);
+    for(std::size_t y = 0; y < blockedHeight; y += Kernel::Size) {
+      for(std::size_t x = 0; x < blockedWidth; x += Kernel::Size) {
+        Kernel::Transpose(
+          source + sourceStride * std::ptrdiff_t(y) + x * sizeof(TPixel), sourceStride,
+          target + targetStride * std::ptrdiff_t(x) + y * sizeof(TPixel), targetStride
+        );
+      }
+    }
+
+    // Move the pixels on the right and bottom borders individually
+    for(std::size_t y = 0; y < height; ++y) {
+      const TPixel *sourceRow = reinterpret_cast<const TPixel *>(
+        source + sourceStride * std::ptrdiff_t(y)
+      );
+      std::uint8_t *targetColumn = target + y * sizeof(TPixel);
+
+      std::size_t x = (y < blockedHeight) ? blockedWidth : 0;
+      for(; x < width; ++x) {
+        *reinterpret_cast<TPixel *>(targetColumn + targetStride * std::ptrdiff_t(x)) = (
+          sourceRow[x]
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Transposes a bitmap into another bitmap tile by tile</summary>
+  /// <typeparam name="TPixel">Type representing a single pixel</typeparam>
+  /// <param name="source">Address of the upper left pixel in the source</param>
+  /// <param name="sourceStride">Distance between two rows in the source</param>
+  /// <param name="target">Address of the upper left pixel in the target</param>
+  /// <param name="targetStride">Distance between two rows in the target</param>
+  /// <param name="width">Width of the source bitmap</param>
+  /// <param name="height">Height of the source bitmap</param>
+  /// <remarks>
+  ///   Rotations are done by passing in negative strides, so that the transposed
+  ///   pixels end up in their rotated places.
+  /// </remarks>
+  template<typename TPixel>
+  void transposeTiled(
+    const std::uint8_t *source, std::ptrdiff_t sourceStride,
+    std::uint8_t *target, std::ptrdiff_t targetStride,
+    std::size_t width, std::size_t height
+  ) {
+    for(std::size_t tileY = 0; tileY < height; tileY += TileSize) {
+      std::size_t tileHeight = std::min(TileSize, height - tileY);
+      for(std::size_t tileX = 0; tileX < width; tileX += TileSize) {
+        transposeTile<TPixel>(
+          source + sourceStride * std::ptrdiff_t(tileY) + tileX * sizeof(TPixel), sourceStride,
+          target + targetStride * std::ptrdiff_t(tileX) + tileY * sizeof(TPixel), targetStride,
+          std::min(TileSize, width - tileX), tileHeight
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies a tile of pixels</summary>
+  /// <param name="source">Address of the tile's upper left pixel in the source</param>
+  /// <param name="sourceStride">Distance between two rows in the source</param>
+  /// <param name="target">Address of the tile's upper left pixel in the target</param>
+  /// <param name="targetStride">Distance between two rows in the target</param>
+  /// <param name="rowByteCount">Number of bytes in each row of the tile</param>
+  /// <param name="height">Number of rows in the tile</param>
+  void copyTile(
+    const std::uint8_t *source, std::ptrdiff_t sourceStride,
+    std::uint8_t *target, std::ptrdiff_t targetStride,
+    std::size_t rowByteCount, std::size_t height
+  ) {
+    for(std::size_t y = 0; y < height; ++y) {
+      std::memcpy(target, source, rowByteCount);
+      source += sourceStride;
+      target += targetStride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Transposes a square bitmap in place tile by tile</summary>
+  /// <typeparam name="TPixel">Type representing a single pixel</typeparam>
+  /// <param name="memory">Bitmap memory that will be transposed</param>
+  /// <remarks>
+  ///   Tiles on opposite sides of the diagonal trade places, so one of them is
+  ///   parked in a temporary tile while the other one is transposed into its place.
+  /// </remarks>
+  template<typename TPixel>
+  void transposeSquareInPlace(const Nuclex::Pixels::BitmapMemory &memory) {
+    TPixel temporaryTile[TileSize * TileSize];
+    std::uint8_t *temporary = reinterpret_cast<std::uint8_t *>(temporaryTile);
+    const std::ptrdiff_t temporaryStride = TileSize * sizeof(TPixel);
+
+    std::uint8_t *pixels = static_cast<std::uint8_t *>(memory.Pixels);
+    std::ptrdiff_t stride = memory.Stride;
+    std::size_t size = memory.Width;
+
+    for(std::size_t tileY = 0; tileY < size; tileY += TileSize) {
+      std::size_t tileHeight = std::min(TileSize, size - tileY);
+
+      // The tile on the diagonal is its own partner
+      std::uint8_t *diagonal = pixels + stride * std::ptrdiff_t(tileY) + tileY * sizeof(TPixel);
+      transposeTile<TPixel>(
+        diagonal, stride, temporary, temporaryStride, tileHeight, tileHeight
+      );
+      copyTile(
+        temporary, temporaryStride, diagonal, stride, tileHeight * sizeof(TPixel), tileHeight
+      );
+
+      for(std::size_t tileX = tileY + TileSize; tileX < size; tileX += TileSize) {
+        std::size_t tileWidth = std::min(TileSize, size - tileX);
+
+        std::uint8_t *upper = pixels + stride * std::ptrdiff_t(tileY) + tileX * sizeof(TPixel);
+        std::uint8_t *lower = pixels + stride * std::ptrdiff_t(tileX) + tileY * sizeof(TPixel);
+        transposeTile<TPixel>(upper, stride, temporary, temporaryStride, tileWidth, tileHeight);
+        transposeTile<TPixel>(lower, stride, upper, stride, tileHeight, tileWidth);
+        copyTile(temporary, temporaryStride, lower, stride, tileHeight * sizeof(TPixel), tileWidth);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that a transposition target fits the source bitmap</summary>
+  /// <param name="source">Bitmap memory that will be transposed</param>
+  /// <param name="target">Bitmap memory that will receive the transposed pixels</param>
+  void requireTransposedDimensions(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    if(source.PixelFormat != target.PixelFormat) {
+      throw std::invalid_argument(u8"Source and target bitmaps must use the same pixel format");
+    }
+    if((source.Width != target.Height) || (source.Height != target.Width)) {
+      throw std::invalid_argument(
+        u8"Target bitmap needs to have the width and height of the source bitmap swapped"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that a bitmap that will be transposed in place is square</summary>
+  /// <param name="memory">Bitmap memory that will be transposed in place</param>
+  void requireSquare(const Nuclex::Pixels::BitmapMemory &memory) {
+    if(memory.Width != memory.Height) {
+      throw std::invalid_argument(u8"Only square bitmaps can be transposed in place");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::FlipVertical(const BitmapMemory &memory) {
+    dispatchByPixelSize(
+      memory.PixelFormat,
+      [&memory](auto pixelTag) {
+        typedef typename decltype(pixelTag)::Type PixelType;
+        std::size_t rowByteCount = memory.Width * sizeof(PixelType);
+
+        for(std::size_t y = 0; y < memory.Height / 2; ++y) {
+          std::uint8_t *top = getRow(memory, y);
+          std::swap_ranges(top, top + rowByteCount, getRow(memory, memory.Height - y - 1));
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::FlipHorizontal(const BitmapMemory &memory) {
+    dispatchByPixelSize(
+      memory.PixelFormat,
+      [&memory](auto pixelTag) {
+        typedef typename decltype(pixelTag)::Type PixelType;
+
+        for(std::size_t y = 0; y < memory.Height; ++y) {
+          PixelType *row = reinterpret_cast<PixelType *>(getRow(memory, y));
+          std::reverse(row, row + memory.Width);
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::Rotate180(const BitmapMemory &memory) {
+    dispatchByPixelSize(
+      memory.PixelFormat,
+      [&memory](auto pixelTag) {
+        typedef typename decltype(pixelTag)::Type PixelType;
+
+        // Swap each row in the upper half with its mirrored counterpart in the lower half
+        for(std::size_t y = 0; y < memory.Height / 2; ++y) {
+          PixelType *top = reinterpret_cast<PixelType *>(getRow(memory, y));
+          PixelType *bottom = reinterpret_cast<PixelType *>(
+            getRow(memory, memory.Height - y - 1)
+          ) + memory.Width;
+          for(std::size_t x = 0; x < memory.Width; ++x) {
+            --bottom;
+            std::swap(top[x], *bottom);
+          }
+        }
+
+        // If the height is odd, the row in the middle is only mirrored
+        if((memory.Height % 2) != 0) {
+          PixelType *middle = reinterpret_cast<PixelType *>(getRow(memory, memory.Height / 2));
+          std::reverse(middle, middle + memory.Width);
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::Transpose(const BitmapMemory &memory) {
+    requireSquare(memory);
+    dispatchByPixelSize(
+      memory.PixelFormat,
+      [&memory](auto pixelTag) {
+        transposeSquareInPlace<typename decltype(pixelTag)::Type>(memory);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::Transpose(const BitmapMemory &source, const BitmapMemory &target) {
+    requireTransposedDimensions(source, target);
+    dispatchByPixelSize(
+      source.PixelFormat,
+      [&source, &target](auto pixelTag) {
+        transposeTiled<typename decltype(pixelTag)::Type>(
+          static_cast<const std::uint8_t *>(source.Pixels), source.Stride,
+          static_cast<std::uint8_t *>(target.Pixels), target.Stride,
+          source.Width, source.Height
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::Rotate90(const BitmapMemory &memory) {
+    Transpose(memory);
+    FlipHorizontal(memory);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::Rotate90(const BitmapMemory &source, const BitmapMemory &target) {
+    requireTransposedDimensions(source, target);
+    if(source.Height == 0) {
+      return;
+    }
+
+    // Transposing the source bottom-up turns it clockwise
+    dispatchByPixelSize(
+      source.PixelFormat,
+      [&source, &target](auto pixelTag) {
+        transposeTiled<typename decltype(pixelTag)::Type>(
+          getRow(source, source.Height - 1), -static_cast<std::ptrdiff_t>(source.Stride),
+          static_cast<std::uint8_t *>(target.Pixels), target.Stride,
+          source.Width, source.Height
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::Rotate270(const BitmapMemory &memory) {
+    Transpose(memory);
+    FlipVertical(memory);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapTransformer::Rotate270(const BitmapMemory &source, const BitmapMemory &target) {
+    requireTransposedDimensions(source, target);
+    if(target.Height == 0) {
+      return;
+    }
+
+    // Transposing the source into the target bottom-up turns it counter-clockwise
+    dispatchByPixelSize(
+      source.PixelFormat,
+      [&source, &target](auto pixelTag) {
+        transposeTiled<typename decltype(pixelTag)::Type>(
+          static_cast<const std::uint8_t *>(source.Pixels), source.Stride,
+          getRow(target, target.Height - 1), -static_cast<std::ptrdiff_t>(target.Stride),
+          source.Width, source.Height
+        );
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,933 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BlockCompressor.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+
+#include <cmath> // for std::floor()
+#include <cstdint>
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::runtime_error
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+// Block layouts are described in the Direct3D documentation:
+// https://docs.microsoft.com/windows/win32/direct3d11/texture-block-compression-in-direct3d-11
+// https://docs.microsoft.com/windows/win32/direct3d11/bc7-format-mode-reference
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Signature of a function that encodes a block of 4x4 pixels</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format, row by row</param>
+  /// <param name="block">Memory that will receive the encoded block</param>
+  typedef void BlockEncodeFunction(const std::uint8_t *pixels, std::uint8_t *block);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Interpolation weights (out of 64) for the 16 steps of BC7 mode 6</summary>
+  const int Bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds a floating point color channel and clamps it to 0..255</summary>
+  /// <param name="value">Value that will be rounded and clamped</param>
+  /// <returns>The rounded and clamped value</returns>
+  inline int roundToByte(float value) {
+    int rounded = static_cast<int>(std::floor(value + 0.5f));
+    if(rounded < 0) {
+      return 0;
+    } else if(rounded > 255) {
+      return 255;
+    } else {
+      return rounded;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies a block of 4x4 pixels out of a bitmap</summary>
+  /// <param name="source">Bitmap memory the pixels will be copied from</param>
+  /// <param name="blockX">Horizontal index of the block</param>
+  /// <param name="blockY">Vertical index of the block</param>
+  /// <param name="pixels">Receives the 16 pixels in R8-G8-B8-A8 format, row by row</param>
+  /// <remarks>
+  ///   Pixels outside of the bitmap are filled by repeating the last column or row.
+  /// </remarks>
+  void loadBlock(
+    const Nuclex::Pixels::BitmapMemory &source,
+    std::size_t blockX, std::size_t blockY,
+    std::uint8_t *pixels
+  ) {
+    std::size_t left = blockX * 4;
+    bool isWholeRow = (left + 4 <= source.Width);
+
+    for(std::size_t y = 0; y < 4; ++y) {
+      std::size_t sourceY = blockY * 4 + y;
+      if(sourceY >= source.Height) {
+        sourceY = source.Height - 1;
+      }
+
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(source.Pixels) + (
+        static_cast<std::ptrdiff_t>(source.Stride) * static_cast<std::ptrdiff_t>(sourceY)
+      );
+      if(isWholeRow) {
+        std::memcpy(pixels + y * 16, row + left * 4, 16);
+      } else {
+        for(std::size_t x = 0; x < 4; ++x) {
+          std::size_t sourceX = left + x;
+          if(sourceX >= source.Width) {
+            sourceX = source.Width - 1;
+          }
+          std::memcpy(pixels + y * 16 + x * 4, row + sourceX * 4, 4);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the dot product of each pixel in a block with an axis</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="axis">Axis the pixels will be projected onto, components within ±255</param>
+  /// <param name="dots">Receives the dot product of each pixel with the axis</param>
+  void projectPixels(const std::uint8_t *pixels, const int *axis, int *dots) {
+    std::size_t index = 0;
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i weights = _mm_setr_epi16(
+        static_cast<short>(axis[0]), static_cast<short>(axis[1]),
+        static_cast<short>(axis[2]), static_cast<short>(axis[3]),
+        static_cast<short>(axis[0]), static_cast<short>(axis[1]),
+        static_cast<short>(axis[2]), static_cast<short>(axis[3])
+      );
+
+      // Each madd yields R*x+G*y and B*z+A*w for two pixels, the halves are then
+      // separated with a shuffle so one add completes the dot products of four pixels
+      for(; index < 16; index += 4) {
+        __m128i four = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + index * 4));
+        __m128 low = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(four, zero), weights));
+        __m128 high = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(four, zero), weights));
+        __m128i even = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i odd = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dots + index), _mm_add_epi32(even, odd));
+      }
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    {
+      const std::int16_t components[4] = {
+        static_cast<std::int16_t>(axis[0]), static_cast<std::int16_t>(axis[1]),
+        static_cast<std::int16_t>(axis[2]), static_cast<std::int16_t>(axis[3])
+      };
+      const int16x4_t weights = vld1_s16(components);
+
+      for(; index < 16; index += 2) {
+        int16x8_t two = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pixels + index * 4)));
+        int32x4_t first = vmull_s16(vget_low_s16(two), weights);
+        int32x4_t second = vmull_s16(vget_high_s16(two), weights);
+        int32x2_t sums = vpadd_s32(
+          vpadd_s32(vget_low_s32(first), vget_high_s32(first)),
+          vpadd_s32(vget_low_s32(second), vget_high_s32(second))
+        );
+        vst1_s32(dots + index, sums);
+      }
+    }
+#endif
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    for(; index < 16; ++index) {
+      const std::uint8_t *pixel = pixels + index * 4;
+      dots[index] = (
+        pixel[0] * axis[0] + pixel[1] * axis[1] + pixel[2] * axis[2] + pixel[3] * axis[3]
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the axis along which the colors in a block vary the most</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="mask">Bit mask of the pixels that will be considered</param>
+  /// <param name="channelCount">Number of channels (3 for RGB, 4 for RGBA)</param>
+  /// <param name="axis">Receives the axis scaled to components within ±255</param>
+  /// <returns>True if an axis was found, false if all pixels have the same color</returns>
+  bool findPrincipalAxis(
+    const std::uint8_t *pixels, std::uint16_t mask, std::size_t channelCount, int *axis
+  ) {
+    float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    std::size_t count = 0;
+    for(std::size_t index = 0; index < 16; ++index) {
+      if((mask & (1U << index)) != 0) {
+        for(std::size_t channel = 0; channel < channelCount; ++channel) {
+          mean[channel] += static_cast<float>(pixels[index * 4 + channel]);
+        }
+        ++count;
+      }
+    }
+    for(std::size_t channel = 0; channel < channelCount; ++channel) {
+      mean[channel] /= static_cast<float>(count);
+    }
+
+    float covariance[4][4] = {};
+    for(std::size_t index = 0; index < 16; ++index) {
+      if((mask & (1U << index)) != 0) {
+        float delta[4];
+        for(std::size_t channel = 0; channel < channelCount; ++channel) {
+          delta[channel] = static_cast<float>(pixels[index * 4 + channel]) - mean[channel];
+        }
+        for(std::size_t row = 0; row < channelCount; ++row) {
+          for(std::size_t column = 0; column < channelCount; ++column) {
+            covariance[row][column] += delta[row] * delta[column];
+          }
+        }
+      }
+    }
+
+    // Power iteration, starting with the channel of largest variance
+    float vector[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    {
+      std::size_t largestRow = 0;
+      for(std::size_t row = 1; row < channelCount; ++row) {
+        if(covariance[row][row] > covariance[largestRow][largestRow]) {
+          largestRow = row;
+        }
+      }
+      if(covariance[largestRow][largestRow] <= 0.0f) {
+        return false;
+      }
+      for(std::size_t channel = 0; channel < channelCount; ++channel) {
+        vector[channel] = covariance[largestRow][channel];
+      }
+    }
+
+    float largest = 0.0f;
+    for(std::size_t iteration = 0; iteration < 8; ++iteration) {
+      float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      largest = 0.0f;
+      for(std::size_t row = 0; row < channelCount; ++row) {
+        for(std::size_t column = 0; column < channelCount; ++column) {
+          next[row] += covariance[row][column] * vector[column];
+        }
+        float magnitude = (next[row] < 0.0f) ? -next[row] : next[row];
+        if(magnitude > largest) {
+          largest = magnitude;
+        }
+      }
+      if(largest <= 0.0f) {
+        return false;
+      }
+      for(std::size_t channel = 0; channel < channelCount; ++channel) {
+        vector[channel] = next[channel] / largest;
+      }
+    }
+
+    bool hasDirection = false;
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      if(channel < channelCount) {
+        axis[channel] = static_cast<int>(std::floor(vector[channel] * 255.0f + 0.5f));
+        hasDirection |= (axis[channel] != 0);
+      } else {
+        axis[channel] = 0;
+      }
+    }
+
+    return hasDirection;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the initial endpoints for the colors in a block</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="mask">Bit mask of the pixels that will be considered</param>
+  /// <param name="channelCount">Number of channels (3 for RGB, 4 for RGBA)</param>
+  /// <param name="endpoints">Receives the endpoints</param>
+  /// <remarks>
+  ///   The endpoints are the two pixels lying furthest apart along the principal axis.
+  /// </remarks>
+  void findEndpoints(
+    const std::uint8_t *pixels, std::uint16_t mask, std::size_t channelCount,
+    float (*endpoints)[4]
+  ) {
+    std::size_t lowest = 0;
+    while((mask & (1U << lowest)) == 0) {
+      ++lowest;
+    }
+    std::size_t highest = lowest;
+
+    int axis[4];
+    if(findPrincipalAxis(pixels, mask, channelCount, axis)) {
+      int dots[16];
+      projectPixels(pixels, axis, dots);
+
+      for(std::size_t index = lowest + 1; index < 16; ++index) {
+        if((mask & (1U << index)) != 0) {
+          if(dots[index] < dots[lowest]) {
+            lowest = index;
+          }
+          if(dots[index] > dots[highest]) {
+            highest = index;
+          }
+        }
+      }
+    }
+
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      endpoints[0][channel] = static_cast<float>(pixels[lowest * 4 + channel]);
+      endpoints[1][channel] = static_cast<float>(pixels[highest * 4 + channel]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fits endpoints to the pixels of a block via least squares</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="mask">Bit mask of the pixels that will be considered</param>
+  /// <param name="weights">Weight of the second endpoint for each pixel (0..1)</param>
+  /// <param name="channelCount">Number of channels (3 for RGB, 4 for RGBA)</param>
+  /// <param name="endpoints">Receives the fitted endpoints</param>
+  /// <returns>True if the endpoints could be fitted, false if the system is singular</returns>
+  bool refineEndpoints(
+    const std::uint8_t *pixels, std::uint16_t mask, const float *weights,
+    std::size_t channelCount, float (*endpoints)[4]
+  ) {
+    float firstSquared = 0.0f, crossed = 0.0f, secondSquared = 0.0f;
+    float firstSums[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    float secondSums[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    for(std::size_t index = 0; index < 16; ++index) {
+      if((mask & (1U << index)) != 0) {
+        float second = weights[index];
+        float first = 1.0f - second;
+        firstSquared += first * first;
+        crossed += first * second;
+        secondSquared += second * second;
+        for(std::size_t channel = 0; channel < channelCount; ++channel) {
+          float value = static_cast<float>(pixels[index * 4 + channel]);
+          firstSums[channel] += first * value;
+          secondSums[channel] += second * value;
+        }
+      }
+    }
+
+    float determinant = firstSquared * secondSquared - crossed * crossed;
+    if(determinant < 0.0001f) {
+      return false;
+    }
+
+    for(std::size_t channel = 0; channel < channelCount; ++channel) {
+      float first = (
+        (secondSquared * firstSums[channel] - crossed * secondSums[channel]) / determinant
+      );
+      float second = (
+        (firstSquared * secondSums[channel] - crossed * firstSums[channel]) / determinant
+      );
+      endpoints[0][channel] = static_cast<float>(roundToByte(first));
+      endpoints[1][channel] = static_cast<float>(roundToByte(second));
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Quantizes an RGB color to R5-G6-B5</summary>
+  /// <param name="color">Color that will be quantized</param>
+  /// <returns>The quantized color</returns>
+  std::uint16_t packR5G6B5(const float *color) {
+    int red = (roundToByte(color[0]) * 31 + 127) / 255;
+    int green = (roundToByte(color[1]) * 63 + 127) / 255;
+    int blue = (roundToByte(color[2]) * 31 + 127) / 255;
+    return static_cast<std::uint16_t>((red << 11) | (green << 5) | blue);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Expands an R5-G6-B5 color to 8 bits per channel</summary>
+  /// <param name="packed">Color that will be expanded</param>
+  /// <param name="color">Receives the red, green and blue channels</param>
+  void unpackR5G6B5(std::uint16_t packed, int *color) {
+    int red = (packed >> 11) & 31;
+    int green = (packed >> 5) & 63;
+    int blue = packed & 31;
+    color[0] = (red << 3) | (red >> 2);
+    color[1] = (green << 2) | (green >> 4);
+    color[2] = (blue << 3) | (blue >> 2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the closest palette entry of a BC1 block for each pixel</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="colors">The block's two endpoint colors in R5-G6-B5 format</param>
+  /// <param name="transparentMask">Bit mask of pixels that should become transparent</param>
+  /// <param name="indices">Receives the palette index of each pixel</param>
+  /// <returns>The sum of squared differences between the pixels and the palette</returns>
+  /// <remarks>
+  ///   The palette has four colors if the first endpoint is larger than the second,
+  ///   otherwise it has three colors and transparent black.
+  /// </remarks>
+  std::uint32_t selectBc1Indices(
+    const std::uint8_t *pixels, const std::uint16_t *colors, std::uint16_t transparentMask,
+    std::uint8_t *indices
+  ) {
+    int palette[4][3];
+    unpackR5G6B5(colors[0], palette[0]);
+    unpackR5G6B5(colors[1], palette[1]);
+
+    bool hasFourColors = (colors[0] > colors[1]);
+    std::size_t colorCount = hasFourColors ? 4 : 3;
+    for(std::size_t channel = 0; channel < 3; ++channel) {
+      if(hasFourColors) {
+        palette[2][channel] = (palette[0][channel] * 2 + palette[1][channel]) / 3;
+        palette[3][channel] = (palette[0][channel] + palette[1][channel] * 2) / 3;
+      } else {
+        palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+        palette[3][channel] = 0;
+      }
+    }
+
+    std::uint32_t totalError = 0;
+    for(std::size_t index = 0; index < 16; ++index) {
+      if((transparentMask & (1U << index)) != 0) {
+        indices[index] = 3;
+        continue;
+      }
+
+      const std::uint8_t *pixel = pixels + index * 4;
+      std::uint32_t bestError = 0xFFFFFFFFU;
+      for(std::size_t entry = 0; entry < colorCount; ++entry) {
+        std::uint32_t error = 0;
+        for(std::size_t channel = 0; channel < 3; ++channel) {
+          int difference = static_cast<int>(pixel[channel]) - palette[entry][channel];
+          error += static_cast<std::uint32_t>(difference * difference);
+        }
+        if(error < bestError) {
+          bestError = error;
+          indices[index] = static_cast<std::uint8_t>(entry);
+        }
+      }
+
+      totalError += bestError;
+    }
+
+    return totalError;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Quantizes a pair of endpoints for a BC1 block and selects the indices</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="endpoints">Endpoints that will be quantized</param>
+  /// <param name="transparentMask">Bit mask of pixels that should become transparent</param>
+  /// <param name="colors">Receives the endpoints in R5-G6-B5 format</param>
+  /// <param name="indices">Receives the palette index of each pixel</param>
+  /// <returns>The sum of squared differences between the pixels and the palette</returns>
+  std::uint32_t fitBc1Endpoints(
+    const std::uint8_t *pixels, const float (*endpoints)[4], std::uint16_t transparentMask,
+    std::uint16_t *colors, std::uint8_t *indices
+  ) {
+    colors[0] = packR5G6B5(endpoints[0]);
+    colors[1] = packR5G6B5(endpoints[1]);
+
+    // The order of the endpoints selects between the four color and the three color
+    // plus transparency palettes
+    bool needsFourColors = (transparentMask == 0);
+    if(needsFourColors == (colors[0] < colors[1])) {
+      std::uint16_t temp = colors[0];
+      colors[0] = colors[1];
+      colors[1] = temp;
+    }
+
+    return selectBc1Indices(pixels, colors, transparentMask, indices);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes the colors of a block in BC1 format</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="allowTransparency">Whether pixels with low alpha become transparent</param>
+  /// <param name="block">Receives the 8 byte BC1 block</param>
+  void encodeColorBlock(const std::uint8_t *pixels, bool allowTransparency, std::uint8_t *block) {
+    std::uint16_t transparentMask = 0;
+    if(allowTransparency) {
+      for(std::size_t index = 0; index < 16; ++index) {
+        if(pixels[index * 4 + 3] < 128) {
+          transparentMask |= static_cast<std::uint16_t>(1U << index);
+        }
+      }
+    }
+    std::uint16_t opaqueMask = static_cast<std::uint16_t>(~transparentMask);
+
+    std::uint16_t colors[2] = { 0, 0 };
+    std::uint8_t indices[16];
+    if(opaqueMask == 0) {
+      for(std::size_t index = 0; index < 16; ++index) {
+        indices[index] = 3;
+      }
+    } else {
+      float endpoints[2][4];
+      findEndpoints(pixels, opaqueMask, 3, endpoints);
+      std::uint32_t error = fitBc1Endpoints(
+        pixels, endpoints, transparentMask, colors, indices
+      );
+
+      // One least squares pass to move the endpoints closer to the pixels
+      float weights[16];
+      bool hasFourColors = (colors[0] > colors[1]);
+      for(std::size_t index = 0; index < 16; ++index) {
+        switch(indices[index]) {
+          case 0: { weights[index] = 0.0f; break; }
+          case 1: { weights[index] = 1.0f; break; }
+          case 2: { weights[index] = hasFourColors ? (1.0f / 3.0f) : 0.5f; break; }
+          default: { weights[index] = (2.0f / 3.0f); break; }
+        }
+      }
+      if(refineEndpoints(pixels, opaqueMask, weights, 3, endpoints)) {
+        std::uint16_t refinedColors[2];
+        std::uint8_t refinedIndices[16];
+        std::uint32_t refinedError = fitBc1Endpoints(
+          pixels, endpoints, transparentMask, refinedColors, refinedIndices
+        );
+        if(refinedError < error) {
+          colors[0] = refinedColors[0];
+          colors[1] = refinedColors[1];
+          std::memcpy(indices, refinedIndices, 16);
+        }
+      }
+    }
+
+    std::uint32_t packedIndices = 0;
+    for(std::size_t index = 0; index < 16; ++index) {
+      packedIndices |= static_cast<std::uint32_t>(indices[index]) << (index * 2);
+    }
+
+    block[0] = static_cast<std::uint8_t>(colors[0]);
+    block[1] = static_cast<std::uint8_t>(colors[0] >> 8);
+    block[2] = static_cast<std::uint8_t>(colors[1]);
+    block[3] = static_cast<std::uint8_t>(colors[1] >> 8);
+    for(std::size_t byteIndex = 0; byteIndex < 4; ++byteIndex) {
+      block[4 + byteIndex] = static_cast<std::uint8_t>(packedIndices >> (byteIndex * 8));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a single channel of a block in BC4 format</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="channel">Index of the channel that will be encoded</param>
+  /// <param name="block">Receives the 8 byte BC4 block</param>
+  void encodeChannelBlock(const std::uint8_t *pixels, std::size_t channel, std::uint8_t *block) {
+    int highest = pixels[channel];
+    int lowest = highest;
+    for(std::size_t index = 1; index < 16; ++index) {
+      int value = pixels[index * 4 + channel];
+      if(value > highest) {
+        highest = value;
+      }
+      if(value < lowest) {
+        lowest = value;
+      }
+    }
+
+    block[0] = static_cast<std::uint8_t>(highest);
+    block[1] = static_cast<std::uint8_t>(lowest);
+
+    // With a larger first endpoint, the palette has six interpolated values in between.
+    // If both endpoints are equal, index 0 (all bits cleared) decodes to that value.
+    std::uint64_t packedIndices = 0;
+    if(highest > lowest) {
+      int palette[8];
+      palette[0] = highest;
+      palette[1] = lowest;
+      for(int entry = 2; entry < 8; ++entry) {
+        palette[entry] = ((8 - entry) * highest + (entry - 1) * lowest + 3) / 7;
+      }
+
+      for(std::size_t index = 0; index < 16; ++index) {
+        int value = pixels[index * 4 + channel];
+        std::uint64_t bestEntry = 0;
+        int bestError = 256;
+        for(std::size_t entry = 0; entry < 8; ++entry) {
+          int error = value - palette[entry];
+          if(error < 0) {
+            error = -error;
+          }
+          if(error < bestError) {
+            bestError = error;
+            bestEntry = entry;
+          }
+        }
+        packedIndices |= bestEntry << (index * 3);
+      }
+    }
+
+    for(std::size_t byteIndex = 0; byteIndex < 6; ++byteIndex) {
+      block[2 + byteIndex] = static_cast<std::uint8_t>(packedIndices >> (byteIndex * 8));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Endpoints and indices of a block encoded in BC7 mode 6</summary>
+  struct Bc7Mode6Block {
+
+    /// <summary>Endpoints with 7 bits per channel, without the parity bit</summary>
+    public: int Endpoints[2][4];
+    /// <summary>Parity bits appended to the endpoints as their least significant bit</summary>
+    public: int ParityBits[2];
+    /// <summary>Palette index of each pixel</summary>
+    public: std::uint8_t Indices[16];
+    /// <summary>Sum of squared differences between the pixels and the palette</summary>
+    public: std::uint32_t Error;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Quantizes both endpoints of a BC7 mode 6 block and selects the indices</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="endpoints">Endpoints that will be quantized</param>
+  /// <param name="block">Receives the quantized endpoints, indices and error</param>
+  void fitBc7Endpoints(
+    const std::uint8_t *pixels, const float (*endpoints)[4], Bc7Mode6Block &block
+  ) {
+    int expanded[2][4];
+
+    // Each endpoint gets the parity bit that lets its channels come closest
+    for(std::size_t endpoint = 0; endpoint < 2; ++endpoint) {
+      float bestError = 0.0f;
+      for(int parityBit = 0; parityBit < 2; ++parityBit) {
+        int quantized[4];
+        float error = 0.0f;
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          int value = (roundToByte(endpoints[endpoint][channel]) - parityBit + 1) / 2;
+          quantized[channel] = (value > 127) ? 127 : value;
+
+          float difference = static_cast<float>(quantized[channel] * 2 + parityBit) - (
+            endpoints[endpoint][channel]
+          );
+          error += difference * difference;
+        }
+        if((parityBit == 0) || (error < bestError)) {
+          bestError = error;
+          block.ParityBits[endpoint] = parityBit;
+          for(std::size_t channel = 0; channel < 4; ++channel) {
+            block.Endpoints[endpoint][channel] = quantized[channel];
+            expanded[endpoint][channel] = quantized[channel] * 2 + parityBit;
+          }
+        }
+      }
+    }
+
+    int palette[16][4];
+    for(std::size_t entry = 0; entry < 16; ++entry) {
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        palette[entry][channel] = (
+          (64 - Bc7Weights[entry]) * expanded[0][channel] +
+          Bc7Weights[entry] * expanded[1][channel] +
+          32
+        ) >> 6;
+      }
+    }
+
+    block.Error = 0;
+    for(std::size_t index = 0; index < 16; ++index) {
+      const std::uint8_t *pixel = pixels + index * 4;
+      std::uint32_t bestError = 0xFFFFFFFFU;
+      for(std::size_t entry = 0; entry < 16; ++entry) {
+        std::uint32_t error = 0;
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          int difference = static_cast<int>(pixel[channel]) - palette[entry][channel];
+          error += static_cast<std::uint32_t>(difference * difference);
+        }
+        if(error < bestError) {
+          bestError = error;
+          block.Indices[index] = static_cast<std::uint8_t>(entry);
+        }
+      }
+      block.Error += bestError;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends bits to a 128 bit block, least significant bit first</summary>
+  class BitWriter {
+
+    /// <summary>Initializes a new bit writer with all bits cleared</summary>
+    public: BitWriter() :
+      low(0),
+      high(0),
+      position(0) {}
+
+    /// <summary>Appends the specified number of bits</summary>
+    /// <param name="value">Value whose lowest bits will be appended</param>
+    /// <param name="bitCount">Number of bits that will be appended</param>
+    public: void Write(std::uint32_t value, std::size_t bitCount) {
+      std::uint64_t bits = value & ((1U << bitCount) - 1);
+      if(this->position >= 64) {
+        this->high |= bits << (this->position - 64);
+      } else {
+        this->low |= bits << this->position;
+        if(this->position + bitCount > 64) {
+          this->high |= bits >> (64 - this->position);
+        }
+      }
+      this->position += bitCount;
+    }
+
+    /// <summary>Stores the 128 bits in little endian byte order</summary>
+    /// <param name="block">Memory that will receive the bits</param>
+    public: void Store(std::uint8_t *block) const {
+      for(std::size_t byteIndex = 0; byteIndex < 8; ++byteIndex) {
+        block[byteIndex] = static_cast<std::uint8_t>(this->low >> (byteIndex * 8));
+        block[byteIndex + 8] = static_cast<std::uint8_t>(this->high >> (byteIndex * 8));
+      }
+    }
+
+    /// <summary>The lower 64 bits of the block</summary>
+    private: std::uint64_t low;
+    /// <summary>The upper 64 bits of the block</summary>
+    private: std::uint64_t high;
+    /// <summary>Index of the next bit that will be written</summary>
+    private: std::size_t position;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a block in BC1 format with 1 bit transparency</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="block">Receives the 8 byte BC1 block</param>
+  void encodeBc1Block(const std::uint8_t *pixels, std::uint8_t *block) {
+    encodeColorBlock(pixels, true, block);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a block in BC3 format</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="block">Receives the 16 byte BC3 block</param>
+  void encodeBc3Block(const std::uint8_t *pixels, std::uint8_t *block) {
+    encodeChannelBlock(pixels, 3, block);
+    encodeColorBlock(pixels, false, block + 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes the red channel of a block in BC4 format</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="block">Receives the 8 byte BC4 block</param>
+  void encodeBc4Block(const std::uint8_t *pixels, std::uint8_t *block) {
+    encodeChannelBlock(pixels, 0, block);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes the red and green channels of a block in BC5 format</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="block">Receives the 16 byte BC5 block</param>
+  void encodeBc5Block(const std::uint8_t *pixels, std::uint8_t *block) {
+    encodeChannelBlock(pixels, 0, block);
+    encodeChannelBlock(pixels, 1, block + 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a block in BC7 format using mode 6</summary>
+  /// <param name="pixels">The block's 16 pixels in R8-G8-B8-A8 format</param>
+  /// <param name="block">Receives the 16 byte BC7 block</param>
+  void encodeBc7Block(const std::uint8_t *pixels, std::uint8_t *block) {
+    float endpoints[2][4];
+    findEndpoints(pixels, 0xFFFF, 4, endpoints);
+
+    Bc7Mode6Block encoded;
+    fitBc7Endpoints(pixels, endpoints, encoded);
+
+    // One least squares pass to move the endpoints closer to the pixels
+    {
+      float weights[16];
+      for(std::size_t index = 0; index < 16; ++index) {
+        weights[index] = static_cast<float>(Bc7Weights[encoded.Indices[index]]) / 64.0f;
+      }
+      if(refineEndpoints(pixels, 0xFFFF, weights, 4, endpoints)) {
+        Bc7Mode6Block refined;
+        fitBc7Endpoints(pixels, endpoints, refined);
+        if(refined.Error < encoded.Error) {
+          encoded = refined;
+        }
+      }
+    }
+
+    // The first pixel's index is stored without its most significant bit,
+    // so if it is set, the endpoints are swapped and all indices inverted
+    std::size_t first = 0, second = 1;
+    bool isInverted = ((encoded.Indices[0] & 8) != 0);
+    if(isInverted) {
+      first = 1;
+      second = 0;
+    }
+
+    BitWriter writer;
+    writer.Write(1U << 6, 7); // Mode 6: six cleared bits followed by one set bit
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      writer.Write(static_cast<std::uint32_t>(encoded.Endpoints[first][channel]), 7);
+      writer.Write(static_cast<std::uint32_t>(encoded.Endpoints[second][channel]), 7);
+    }
+    writer.Write(static_cast<std::uint32_t>(encoded.ParityBits[first]), 1);
+    writer.Write(static_cast<std::uint32_t>(encoded.ParityBits[second]), 1);
+    for(std::size_t index = 0; index < 16; ++index) {
+      std::uint32_t paletteIndex = encoded.Indices[index];
+      if(isInverted) {
+        paletteIndex = 15 - paletteIndex;
+      }
+      writer.Write(paletteIndex, (index == 0) ? 3 : 4);
+    }
+
+    writer.Store(block);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the function that encodes blocks in a pixel format</summary>
+  /// <param name="pixelFormat">Block-compressed pixel format blocks will be encoded in</param>
+  /// <returns>The function encoding blocks or null if the format is not supported</returns>
+  BlockEncodeFunction *getBlockEncoder(Nuclex::Pixels::PixelFormat pixelFormat) {
+    switch(pixelFormat) {
+      case Nuclex::Pixels::PixelFormat::BC1_Compressed: { return &encodeBc1Block; }
+      case Nuclex::Pixels::PixelFormat::BC3_Compressed: { return &encodeBc3Block; }
+      case Nuclex::Pixels::PixelFormat::BC4_Compressed: { return &encodeBc4Block; }
+      case Nuclex::Pixels::PixelFormat::BC5_Compressed: { return &encodeBc5Block; }
+      case Nuclex::Pixels::PixelFormat::BC7_Compressed: { return &encodeBc7Block; }
+      default: { return nullptr; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Verifies that a bitmap can be compressed into another bitmap</summary>
+  /// <param name="source">Bitmap memory holding the pixels that will be compressed</param>
+  /// <param name="target">Bitmap memory that will receive the compressed blocks</param>
+  /// <returns>The function that will encode the blocks</returns>
+  BlockEncodeFunction *validateBitmaps(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    if(source.PixelFormat != Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned) {
+      throw std::runtime_error(u8"Source bitmap must use the R8_G8_B8_A8_Unsigned format");
+    }
+
+    BlockEncodeFunction *encoder = getBlockEncoder(target.PixelFormat);
+    if(encoder == nullptr) {
+      throw std::runtime_error(u8"Bitmaps can not be compressed into the target pixel format");
+    }
+
+    if((source.Width != target.Width) || (source.Height != target.Height)) {
+      throw std::runtime_error(u8"Provided bitmaps do not have the same dimensions");
+    }
+
+    return encoder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses a single row of blocks</summary>
+  /// <param name="source">Bitmap memory holding the pixels that will be compressed</param>
+  /// <param name="target">Bitmap memory that will receive the compressed blocks</param>
+  /// <param name="encoder">Function that will encode the blocks</param>
+  /// <param name="blockY">Index of the row of blocks that will be compressed</param>
+  void compressBlockRow(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target,
+    BlockEncodeFunction *encoder, std::size_t blockY
+  ) {
+    std::size_t blockByteCount = Nuclex::Pixels::CountBytesPerBlock(target.PixelFormat);
+    std::size_t blockCount = (target.Width + 3) / 4;
+
+    // The stride counts the bytes in a row of pixels, a row of blocks covers four of them
+    std::uint8_t *targetRow = static_cast<std::uint8_t *>(target.Pixels) + (
+      static_cast<std::ptrdiff_t>(target.Stride) * static_cast<std::ptrdiff_t>(blockY * 4)
+    );
+
+    std::uint8_t pixels[64];
+    for(std::size_t blockX = 0; blockX < blockCount; ++blockX) {
+      loadBlock(source, blockX, blockY, pixels);
+      encoder(pixels, targetRow + blockX * blockByteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BlockCompressor::CanCompress(PixelFormat pixelFormat) {
+    return (getBlockEncoder(pixelFormat) != nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCompressor::Compress(const BitmapMemory &source, const BitmapMemory &target) {
+    BlockEncodeFunction *encoder = validateBitmaps(source, target);
+    if(source.Width == 0) {
+      return;
+    }
+
+    std::size_t blockRowCount = (target.Height + 3) / 4;
+    for(std::size_t blockY = 0; blockY < blockRowCount; ++blockY) {
+      compressBlockRow(source, target, encoder, blockY);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCompressor::Compress(
+    const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+  ) {
+    BlockEncodeFunction *encoder = validateBitmaps(source, target);
+    if(source.Width == 0) {
+      return;
+    }
+
+    // Encoding spends so much time on each pixel that even one row of blocks
+    // dwarfs the cost of handing it out, so each row of blocks is its own task
+    threadPool.ForEach(
+      (target.Height + 3) / 4,
+      [&source, &target, encoder](std::size_t blockY) {
+        compressBlockRow(source, target, encoder, blockY);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,574 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/ColorModels/SrgbTransfer.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+
+#include <algorithm> // for std::min(), std::copy_n()
+#include <cmath> // for std::pow()
+#include <cstdint>
+#include <stdexcept> // for std::runtime_error
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel format in which pixels are converted between color spaces</summary>
+  const Nuclex::Pixels::PixelFormat IntermediatePixelFormat = (
+    Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32
+  );
+
+  /// <summary>Number of pixels that are converted in one go</summary>
+  const std::size_t ChunkSize = 256;
+
+  /// <summary>Number of entries in the table encoding linear colors as sRGB bytes</summary>
+  const std::size_t EncodingTableSize = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Coefficients of the polynomial approximating sRGB to linear</summary>
+  /// <remarks>
+  ///   Chebyshev fit of ((x + 0.055) / 1.055) ^ 2.4 for x from 0.04045 to 1.0,
+  ///   lowest order first. The maximum error is below 0.00001.
+  /// </remarks>
+  const float ToLinearCoefficients[7] = {
+    9.311454393e-04f, 3.263252975e-02f, 5.158576898e-01f, 7.008707547e-01f,
+    -4.062709499e-01f, 2.031365960e-01f, -4.716058174e-02f
+  };
+
+  /// <summary>Coefficients of the polynomial approximating linear to sRGB</summary>
+  /// <remarks>
+  ///   Chebyshev fit of 1.055 * t ^ (4 / 2.4) - 0.055 with t being the fourth root
+  ///   of the linear value, for linear values from 0.0031308 to 1.0, lowest order first.
+  ///   Fitting on the fourth root tames the steep start of the curve, the maximum
+  ///   error is below 0.000003.
+  /// </remarks>
+  const float ToSrgbCoefficients[7] = {
+    -5.973901136e-02f, 1.419582632e-01f, 1.354572649e+00f, -8.252800166e-01f,
+    6.210022841e-01f, -2.942476372e-01f, 6.173430755e-02f
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes where the channels of a pixel format using bytes are stored</summary>
+  struct ByteLayout {
+
+    /// <summary>Number of bytes each pixel occupies</summary>
+    public: std::size_t BytesPerPixel;
+    /// <summary>Byte offsets of the red, green, blue and alpha channels</summary>
+    /// <remarks>
+    ///   The alpha channel's offset is -1 if the pixel format has no alpha channel
+    /// </remarks>
+    public: int Channels[4];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the byte layout of 8 bit RGB(A) pixel formats</summary>
+  /// <param name="pixelFormat">Pixel format whose layout will be looked up</param>
+  /// <param name="layout">Receives the layout of the pixel format</param>
+  /// <returns>True if the pixel format uses one byte per color channel</returns>
+  bool getByteLayout(Nuclex::Pixels::PixelFormat pixelFormat, ByteLayout &layout) {
+    using Nuclex::Pixels::PixelFormat;
+
+    switch(pixelFormat) {
+      case PixelFormat::R8_G8_B8_Unsigned: { layout = { 3, { 0, 1, 2, -1 } }; return true; }
+      case PixelFormat::B8_G8_R8_Unsigned: { layout = { 3, { 2, 1, 0, -1 } }; return true; }
+      case PixelFormat::R8_G8_B8_A8_Unsigned: { layout = { 4, { 0, 1, 2, 3 } }; return true; }
+      case PixelFormat::B8_G8_R8_A8_Unsigned: { layout = { 4, { 2, 1, 0, 3 } }; return true; }
+      default: { return false; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lookup tables for converting sRGB bytes</summary>
+  struct SrgbTables {
+
+    /// <summary>Calculates the lookup tables with the exact transfer functions</summary>
+    public: SrgbTables() {
+      using Nuclex::Pixels::ColorModels::SrgbTransfer;
+
+      for(std::size_t index = 0; index < 256; ++index) {
+        this->ToLinear[index] = SrgbTransfer::ToLinear(static_cast<float>(index) / 255.0f);
+      }
+      for(std::size_t index = 0; index < EncodingTableSize; ++index) {
+        float linear = static_cast<float>(index) / static_cast<float>(EncodingTableSize - 1);
+        this->ToSrgb[index] = static_cast<std::uint8_t>(
+          SrgbTransfer::ToSrgb(linear) * 255.0f + 0.5f
+        );
+      }
+    }
+
+    /// <summary>Linear color values for each possible sRGB byte</summary>
+    public: float ToLinear[256];
+    /// <summary>sRGB bytes for evenly spaced linear color values from 0.0 to 1.0</summary>
+    public: std::uint8_t ToSrgb[EncodingTableSize];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the lookup tables for converting sRGB bytes</summary>
+  /// <returns>The lookup tables, which are calculated on first use</returns>
+  const SrgbTables &getSrgbTables() {
+    static const SrgbTables tables;
+    return tables;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits a color value to the range of 0.0 to 1.0</summary>
+  /// <param name="value">Color value that will be limited</param>
+  /// <returns>The color value limited to the range of 0.0 to 1.0, 0.0 for NaNs</returns>
+  inline float saturate(float value) {
+    if(!(value > 0.0f)) { // also catches NaNs
+      return 0.0f;
+    } else if(value > 1.0f) {
+      return 1.0f;
+    } else {
+      return value;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Evaluates one of the transfer function polynomials</summary>
+  /// <param name="coefficients">Coefficients of the polynomial, lowest order first</param>
+  /// <param name="value">Value at which the polynomial will be evaluated</param>
+  /// <returns>The result of the polynomial</returns>
+  inline float evaluatePolynomial(const float (&coefficients)[7], float value) {
+    float result = coefficients[6];
+    for(std::size_t index = 6; index > 0; --index) {
+      result = result * value + coefficients[index - 1];
+    }
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts an sRGB color value to linear with the polynomial</summary>
+  /// <param name="srgb">sRGB color value that will be converted</param>
+  /// <returns>The approximated linear color value</returns>
+  inline float approximateToLinear(float srgb) {
+    srgb = saturate(srgb);
+    if(srgb <= 0.04045f) {
+      return srgb / 12.92f;
+    } else {
+      return evaluatePolynomial(ToLinearCoefficients, srgb);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a linear color value to sRGB with the polynomial</summary>
+  /// <param name="linear">Linear color value that will be converted</param>
+  /// <returns>The approximated sRGB color value</returns>
+  inline float approximateToSrgb(float linear) {
+    linear = saturate(linear);
+    if(linear <= 0.0031308f) {
+      return linear * 12.92f;
+    } else {
+      return evaluatePolynomial(ToSrgbCoefficients, std::sqrt(std::sqrt(linear)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+  /// <summary>Evaluates one of the transfer function polynomials on four values</summary>
+  /// <param name="coefficients">Coefficients of the polynomial, lowest order first</param>
+  /// <param name="values">Values at which the polynomial will be evaluated</param>
+  /// <returns>The results of the polynomial</returns>
+  inline __m128 evaluatePolynomial(const float (&coefficients)[7], __m128 values) {
+    __m128 result = _mm_set1_ps(coefficients[6]);
+    for(std::size_t index = 6; index > 0; --index) {
+      result = _mm_add_ps(_mm_mul_ps(result, values), _mm_set1_ps(coefficients[index - 1]));
+    }
+    return result;
+  }
+
+  /// <summary>Limits four color values to the range of 0.0 to 1.0</summary>
+  /// <param name="values">Color values that will be limited</param>
+  /// <returns>The color values limited to the range of 0.0 to 1.0, 0.0 for NaNs</returns>
+  inline __m128 saturate(__m128 values) {
+    // If either operand is a NaN, the second one is returned
+    return _mm_min_ps(_mm_max_ps(values, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  }
+
+  /// <summary>Picks values from either of two registers</summary>
+  /// <param name="mask">Mask whose set bits select values from the first register</param>
+  /// <param name="first">Values that will be picked where the mask is set</param>
+  /// <param name="second">Values that will be picked where the mask is not set</param>
+  /// <returns>The values picked from both registers</returns>
+  inline __m128 select(__m128 mask, __m128 first, __m128 second) {
+    return _mm_or_ps(_mm_and_ps(mask, first), _mm_andnot_ps(mask, second));
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes sRGB pixels stored as bytes into linear float RGBA pixels</summary>
+  /// <param name="layout">Byte layout of the sRGB pixels</param>
+  /// <param name="sourcePixels">Address of the first sRGB pixel</param>
+  /// <param name="rgba">Receives the linear pixels</param>
+  /// <param name="pixelCount">Number of pixels that will be decoded</param>
+  void decodeSrgbBytes(
+    const ByteLayout &layout, const std::uint8_t *sourcePixels, float *rgba,
+    std::size_t pixelCount
+  ) {
+    const float *toLinear = getSrgbTables().ToLinear;
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      rgba[0] = toLinear[sourcePixels[layout.Channels[0]]];
+      rgba[1] = toLinear[sourcePixels[layout.Channels[1]]];
+      rgba[2] = toLinear[sourcePixels[layout.Channels[2]]];
+      if(layout.Channels[3] >= 0) {
+        rgba[3] = static_cast<float>(sourcePixels[layout.Channels[3]]) / 255.0f;
+      } else {
+        rgba[3] = 1.0f;
+      }
+      sourcePixels += layout.BytesPerPixel;
+      rgba += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes linear float RGBA pixels into sRGB pixels stored as bytes</summary>
+  /// <param name="layout">Byte layout of the sRGB pixels</param>
+  /// <param name="rgba">Linear pixels that will be encoded</param>
+  /// <param name="targetPixels">Receives the sRGB pixels</param>
+  /// <param name="pixelCount">Number of pixels that will be encoded</param>
+  void encodeSrgbBytes(
+    const ByteLayout &layout, const float *rgba, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  ) {
+    const std::uint8_t *toSrgb = getSrgbTables().ToSrgb;
+    const float tableScale = static_cast<float>(EncodingTableSize - 1);
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      for(std::size_t channel = 0; channel < 3; ++channel) {
+        std::size_t tableIndex = static_cast<std::size_t>(
+          saturate(rgba[channel]) * tableScale + 0.5f
+        );
+        targetPixels[layout.Channels[channel]] = toSrgb[tableIndex];
+      }
+      if(layout.Channels[3] >= 0) {
+        targetPixels[layout.Channels[3]] = static_cast<std::uint8_t>(
+          saturate(rgba[3]) * 255.0f + 0.5f
+        );
+      }
+      rgba += 4;
+      targetPixels += layout.BytesPerPixel;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts the rows of an sRGB bitmap into a linear bitmap</summary>
+  /// <param name="source">Bitmap memory holding the sRGB pixels</param>
+  /// <param name="target">Bitmap memory that will receive the linear pixels</param>
+  void convertRowsToLinear(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    using Nuclex::Pixels::ColorModels::SrgbTransfer;
+    using Nuclex::Pixels::PixelFormatConverter;
+    using Nuclex::Pixels::CountRequiredBytes;
+
+    ByteLayout sourceLayout = ByteLayout();
+    bool isSourceBytes = getByteLayout(source.PixelFormat, sourceLayout);
+    bool isTargetIntermediate = (target.PixelFormat == IntermediatePixelFormat);
+
+    float chunk[ChunkSize * 4];
+
+    const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(source.Pixels);
+    std::uint8_t *targetRow = static_cast<std::uint8_t *>(target.Pixels);
+    for(std::size_t y = 0; y < source.Height; ++y) {
+      for(std::size_t x = 0; x < source.Width; x += ChunkSize) {
+        std::size_t pixelCount = std::min(ChunkSize, source.Width - x);
+
+        // If the target is already in float RGBA, decode straight into its row
+        float *rgba = chunk;
+        if(isTargetIntermediate) {
+          rgba = reinterpret_cast<float *>(targetRow) + x * 4;
+        }
+
+        // 8 bit sRGB pixels can be looked up directly, anything else is first converted
+        // into float RGBA and then run through the polynomial
+        if(isSourceBytes) {
+          decodeSrgbBytes(
+            sourceLayout, sourceRow + x * sourceLayout.BytesPerPixel, rgba, pixelCount
+          );
+        } else {
+          PixelFormatConverter::ConvertRow(
+            source.PixelFormat, sourceRow + CountRequiredBytes(source.PixelFormat, x),
+            IntermediatePixelFormat, rgba,
+            pixelCount
+          );
+          SrgbTransfer::ToLinearRow(rgba, pixelCount);
+        }
+
+        if(!isTargetIntermediate) {
+          PixelFormatConverter::ConvertRow(
+            IntermediatePixelFormat, rgba,
+            target.PixelFormat, targetRow + CountRequiredBytes(target.PixelFormat, x),
+            pixelCount
+          );
+        }
+      }
+
+      sourceRow += source.Stride;
+      targetRow += target.Stride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts the rows of a linear bitmap into an sRGB bitmap</summary>
+  /// <param name="source">Bitmap memory holding the linear pixels</param>
+  /// <param name="target">Bitmap memory that will receive the sRGB pixels</param>
+  void convertRowsToSrgb(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    using Nuclex::Pixels::ColorModels::SrgbTransfer;
+    using Nuclex::Pixels::PixelFormatConverter;
+    using Nuclex::Pixels::CountRequiredBytes;
+
+    bool isSourceIntermediate = (source.PixelFormat == IntermediatePixelFormat);
+    ByteLayout targetLayout = ByteLayout();
+    bool isTargetBytes = getByteLayout(target.PixelFormat, targetLayout);
+
+    float chunk[ChunkSize * 4];
+
+    const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(source.Pixels);
+    std::uint8_t *targetRow = static_cast<std::uint8_t *>(target.Pixels);
+    for(std::size_t y = 0; y < source.Height; ++y) {
+      for(std::size_t x = 0; x < source.Width; x += ChunkSize) {
+        std::size_t pixelCount = std::min(ChunkSize, source.Width - x);
+
+        // Obtain the pixels in float RGBA. The source row must not be modified,
+        // so it can only be used directly if the pixels are encoded via the table.
+        const float *rgba = chunk;
+        if(isSourceIntermediate) {
+          const float *sourcePixels = reinterpret_cast<const float *>(sourceRow) + x * 4;
+          if(isTargetBytes) {
+            rgba = sourcePixels;
+          } else {
+            std::copy_n(sourcePixels, pixelCount * 4, chunk);
+          }
+        } else {
+          PixelFormatConverter::ConvertRow(
+            source.PixelFormat, sourceRow + CountRequiredBytes(source.PixelFormat, x),
+            IntermediatePixelFormat, chunk,
+            pixelCount
+          );
+        }
+
+        // 8 bit sRGB pixels can be looked up directly, anything else is run through
+        // the polynomial and then converted into the target pixel format
+        if(isTargetBytes) {
+          encodeSrgbBytes(
+            targetLayout, rgba, targetRow + x * targetLayout.BytesPerPixel, pixelCount
+          );
+        } else {
+          SrgbTransfer::ToSrgbRow(chunk, pixelCount);
+          PixelFormatConverter::ConvertRow(
+            IntermediatePixelFormat, chunk,
+            target.PixelFormat, targetRow + CountRequiredBytes(target.PixelFormat, x),
+            pixelCount
+          );
+        }
+      }
+
+      sourceRow += source.Stride;
+      targetRow += target.Stride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if two bitmaps can't be converted into each other</summary>
+  /// <param name="source">Bitmap memory the pixels will be read from</param>
+  /// <param name="target">Bitmap memory the converted pixels will be written to</param>
+  void requireConvertibleBitmaps(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    using Nuclex::Pixels::PixelFormatConverter;
+
+    if((source.Width != target.Width) || (source.Height != target.Height)) {
+      throw std::runtime_error(u8"Provided bitmap does not have the correct dimensions");
+    }
+
+    bool canConvert = (
+      PixelFormatConverter::CanConvert(source.PixelFormat, IntermediatePixelFormat) &&
+      PixelFormatConverter::CanConvert(IntermediatePixelFormat, target.PixelFormat)
+    );
+    if(!canConvert) {
+      throw std::runtime_error(u8"Conversion between these pixel formats is not supported");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace ColorModels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float SrgbTransfer::ToLinear(float srgb) {
+    if(srgb <= 0.04045f) {
+      return srgb / 12.92f;
+    } else {
+      return static_cast<float>(std::pow((static_cast<double>(srgb) + 0.055) / 1.055, 2.4));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float SrgbTransfer::ToSrgb(float linear) {
+    if(linear <= 0.0031308f) {
+      return linear * 12.92f;
+    } else {
+      return static_cast<float>(
+        1.055 * std::pow(static_cast<double>(linear), 1.0 / 2.4) - 0.055
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SrgbTransfer::ToLinearRow(float *rgba, std::size_t pixelCount) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+      const __m128 threshold = _mm_set1_ps(0.04045f);
+      const __m128 slope = _mm_set1_ps(1.0f / 12.92f);
+      while(pixelCount > 0) {
+        __m128 pixel = _mm_loadu_ps(rgba);
+        __m128 srgb = saturate(pixel);
+        __m128 linear = select(
+          _mm_cmple_ps(srgb, threshold),
+          _mm_mul_ps(srgb, slope),
+          evaluatePolynomial(ToLinearCoefficients, srgb)
+        );
+        _mm_storeu_ps(rgba, select(colorMask, linear, pixel));
+        rgba += 4;
+        --pixelCount;
+      }
+    }
+#endif
+
+    // Scalar loop if no SIMD instructions are available
+    while(pixelCount > 0) {
+      rgba[0] = approximateToLinear(rgba[0]);
+      rgba[1] = approximateToLinear(rgba[1]);
+      rgba[2] = approximateToLinear(rgba[2]);
+      rgba += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SrgbTransfer::ToSrgbRow(float *rgba, std::size_t pixelCount) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+      const __m128 threshold = _mm_set1_ps(0.0031308f);
+      const __m128 slope = _mm_set1_ps(12.92f);
+      while(pixelCount > 0) {
+        __m128 pixel = _mm_loadu_ps(rgba);
+        __m128 linear = saturate(pixel);
+        __m128 srgb = select(
+          _mm_cmple_ps(linear, threshold),
+          _mm_mul_ps(linear, slope),
+          evaluatePolynomial(ToSrgbCoefficients, _mm_sqrt_ps(_mm_sqrt_ps(linear)))
+        );
+        _mm_storeu_ps(rgba, select(colorMask, srgb, pixel));
+        rgba += 4;
+        --pixelCount;
+      }
+    }
+#endif
+
+    // Scalar loop if no SIMD instructions are available
+    while(pixelCount > 0) {
+      rgba[0] = approximateToSrgb(rgba[0]);
+      rgba[1] = approximateToSrgb(rgba[1]);
+      rgba[2] = approximateToSrgb(rgba[2]);
+      rgba += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SrgbTransfer::ToLinear(const BitmapMemory &source, const BitmapMemory &target) {
+    requireConvertibleBitmaps(source, target);
+    convertRowsToLinear(source, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SrgbTransfer::ToLinear(
+    const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+  ) {
+    requireConvertibleBitmaps(source, target);
+    ForEachBandInParallel(
+      threadPool, source, target,
+      [](const BitmapMemory &sourceBand, const BitmapMemory &targetBand, std::size_t) {
+        convertRowsToLinear(sourceBand, targetBand);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SrgbTransfer::ToSrgb(const BitmapMemory &source, const BitmapMemory &target) {
+    requireConvertibleBitmaps(source, target);
+    convertRowsToSrgb(source, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void SrgbTransfer::ToSrgb(
+    const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+  ) {
+    requireConvertibleBitmaps(source, target);
+    ForEachBandInParallel(
+      threadPool, source, target,
+      [](const BitmapMemory &sourceBand, const BitmapMemory &targetBand, std::size_t) {
+        convertRowsToSrgb(sourceBand, targetBand);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::ColorModels
@@ -0,0 +1,372 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/ColorModels/ToneMapper.h"
+#include "Nuclex/Pixels/ColorModels/SrgbTransfer.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "../DitherPatterns.h"
+
+#include <algorithm> // for std::min()
+#include <cmath> // for std::exp2()
+#include <cstdint>
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::runtime_error
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel format in which pixels are tone mapped</summary>
+  const Nuclex::Pixels::PixelFormat IntermediatePixelFormat = (
+    Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32
+  );
+
+  /// <summary>Number of pixels that are tone mapped in one go</summary>
+  const std::size_t ChunkSize = 256;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes where the channels of a pixel format using bytes are stored</summary>
+  struct ByteLayout {
+
+    /// <summary>Number of bytes each pixel occupies</summary>
+    public: std::size_t BytesPerPixel;
+    /// <summary>Byte offsets of the red, green, blue and alpha channels</summary>
+    /// <remarks>
+    ///   The alpha channel's offset is -1 if the pixel format has no alpha channel
+    /// </remarks>
+    public: int Channels[4];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the byte layout of 8 bit RGB(A) pixel formats</summary>
+  /// <param name="pixelFormat">Pixel format whose layout will be looked up</param>
+  /// <param name="layout">Receives the layout of the pixel format</param>
+  /// <returns>True if the pixel format uses one byte per color channel</returns>
+  bool getByteLayout(Nuclex::Pixels::PixelFormat pixelFormat, ByteLayout &layout) {
+    using Nuclex::Pixels::PixelFormat;
+
+    switch(pixelFormat) {
+      case PixelFormat::R8_G8_B8_Unsigned: { layout = { 3, { 0, 1, 2, -1 } }; return true; }
+      case PixelFormat::B8_G8_R8_Unsigned: { layout = { 3, { 2, 1, 0, -1 } }; return true; }
+      case PixelFormat::R8_G8_B8_A8_Unsigned: { layout = { 4, { 0, 1, 2, 3 } }; return true; }
+      case PixelFormat::B8_G8_R8_A8_Unsigned: { layout = { 4, { 2, 1, 0, 3 } }; return true; }
+      default: { return false; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Applies the exposure and a tone mapping curve to float RGBA pixels</summary>
+  /// <param name="rgba">Address of the first pixel's red channel</param>
+  /// <param name="pixelCount">Number of pixels that will be tone mapped</param>
+  /// <param name="exposureFactor">Factor by which colors will be multiplied</param>
+  /// <param name="mappingOperator">Tone mapping curve that will be applied</param>
+  void applyCurve(
+    float *rgba, std::size_t pixelCount, float exposureFactor,
+    Nuclex::Pixels::ColorModels::ToneMappingOperator mappingOperator
+  ) {
+    using Nuclex::Pixels::ColorModels::ToneMappingOperator;
+    using Nuclex::Pixels::ColorModels::ToneMapper;
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128 exposure = _mm_set_ps(1.0f, exposureFactor, exposureFactor, exposureFactor);
+      const __m128 colorMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 one = _mm_set1_ps(1.0f);
+      switch(mappingOperator) {
+        case ToneMappingOperator::Reinhard: {
+          while(pixelCount > 0) {
+            __m128 pixel = _mm_mul_ps(_mm_loadu_ps(rgba), exposure);
+            __m128 color = _mm_max_ps(pixel, zero);
+            color = _mm_div_ps(color, _mm_add_ps(color, one));
+            _mm_storeu_ps(
+              rgba, _mm_or_ps(_mm_and_ps(colorMask, color), _mm_andnot_ps(colorMask, pixel))
+            );
+            rgba += 4;
+            --pixelCount;
+          }
+          break;
+        }
+        case ToneMappingOperator::AcesFit: {
+          const __m128 a = _mm_set1_ps(2.51f), b = _mm_set1_ps(0.03f);
+          const __m128 c = _mm_set1_ps(2.43f), d = _mm_set1_ps(0.59f), e = _mm_set1_ps(0.14f);
+          while(pixelCount > 0) {
+            __m128 pixel = _mm_mul_ps(_mm_loadu_ps(rgba), exposure);
+            __m128 color = _mm_max_ps(pixel, zero);
+            color = _mm_div_ps(
+              _mm_mul_ps(color, _mm_add_ps(_mm_mul_ps(color, a), b)),
+              _mm_add_ps(_mm_mul_ps(color, _mm_add_ps(_mm_mul_ps(color, c), d)), e)
+            );
+            _mm_storeu_ps(
+              rgba, _mm_or_ps(_mm_and_ps(colorMask, color), _mm_andnot_ps(colorMask, pixel))
+            );
+            rgba += 4;
+            --pixelCount;
+          }
+          break;
+        }
+        default: { // Clamping happens when the colors are encoded to sRGB
+          while(pixelCount > 0) {
+            _mm_storeu_ps(rgba, _mm_mul_ps(_mm_loadu_ps(rgba), exposure));
+            rgba += 4;
+            --pixelCount;
+          }
+          break;
+        }
+      }
+    }
+#endif
+
+    // Scalar loop if no SIMD instructions are available
+    while(pixelCount > 0) {
+      rgba[0] = ToneMapper::Apply(rgba[0] * exposureFactor, mappingOperator);
+      rgba[1] = ToneMapper::Apply(rgba[1] * exposureFactor, mappingOperator);
+      rgba[2] = ToneMapper::Apply(rgba[2] * exposureFactor, mappingOperator);
+      rgba += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Quantizes sRGB encoded float RGBA pixels to bytes</summary>
+  /// <param name="rgba">Address of the first pixel's red channel</param>
+  /// <param name="quantized">Receives the quantized R8-G8-B8-A8 pixels</param>
+  /// <param name="pixelCount">Number of pixels that will be quantized</param>
+  /// <param name="thresholds">Row of dithering thresholds from 0.0 to 1.0</param>
+  /// <param name="thresholdMask">Mask that wraps pixel indices into the thresholds row</param>
+  /// <param name="x">X coordinate of the first pixel in the bitmap</param>
+  void quantizeRow(
+    const float *rgba, std::uint8_t *quantized, std::size_t pixelCount,
+    const float *thresholds, std::size_t thresholdMask, std::size_t x
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 one = _mm_set1_ps(1.0f);
+      const __m128 scale = _mm_set1_ps(255.0f);
+      const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+      const __m128 half = _mm_set1_ps(0.5f);
+      for(std::size_t index = 0; index < pixelCount; ++index) {
+        __m128 pixel = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(rgba), zero), one);
+        __m128 threshold = _mm_or_ps(
+          _mm_and_ps(alphaMask, half),
+          _mm_andnot_ps(alphaMask, _mm_set1_ps(thresholds[(x + index) & thresholdMask]))
+        );
+
+        // Values are positive and stay below 256, so truncation floors them safely
+        __m128i integers = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(pixel, scale), threshold));
+        integers = _mm_packs_epi32(integers, integers);
+        integers = _mm_packus_epi16(integers, integers);
+        std::int32_t packed = _mm_cvtsi128_si32(integers);
+        std::memcpy(quantized, &packed, 4);
+
+        rgba += 4;
+        quantized += 4;
+      }
+      pixelCount = 0;
+    }
+#endif
+
+    // Scalar loop if no SIMD instructions are available
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      float threshold = thresholds[(x + index) & thresholdMask];
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        float value = rgba[channel];
+        if(!(value > 0.0f)) { // also catches NaNs
+          value = 0.0f;
+        } else if(value > 1.0f) {
+          value = 1.0f;
+        }
+        quantized[channel] = static_cast<std::uint8_t>(
+          value * 255.0f + ((channel == 3) ? 0.5f : threshold)
+        );
+      }
+      rgba += 4;
+      quantized += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tone maps the rows of a high dynamic range bitmap into 8 bit sRGB</summary>
+  /// <param name="source">Bitmap memory holding the linear pixels</param>
+  /// <param name="target">Bitmap memory that will receive the sRGB bytes</param>
+  /// <param name="options">Settings controlling the exposure, curve and dithering</param>
+  /// <param name="firstRow">Index of the first row in the whole bitmap</param>
+  void toneMapRows(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target,
+    const Nuclex::Pixels::ColorModels::ToneMappingOptions &options, std::size_t firstRow
+  ) {
+    using Nuclex::Pixels::ColorModels::SrgbTransfer;
+    using Nuclex::Pixels::PixelFormatConverter;
+    using Nuclex::Pixels::CountRequiredBytes;
+
+    ByteLayout targetLayout = ByteLayout();
+    getByteLayout(target.PixelFormat, targetLayout);
+    bool isTargetRgba = (target.PixelFormat == Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    // Without dithering, the pattern is a single threshold of 0.5, so the same
+    // quantization code handles rounding, too
+    Nuclex::Pixels::DitherPattern pattern = Nuclex::Pixels::GetDitherPattern(options.Dithering);
+
+    float exposureFactor = std::exp2(options.Exposure);
+
+    float chunk[ChunkSize * 4];
+    std::uint8_t quantized[ChunkSize * 4];
+
+    const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(source.Pixels);
+    std::uint8_t *targetRow = static_cast<std::uint8_t *>(target.Pixels);
+    for(std::size_t y = 0; y < source.Height; ++y) {
+      const float *thresholds = pattern.GetRow(firstRow + y);
+
+      for(std::size_t x = 0; x < source.Width; x += ChunkSize) {
+        std::size_t pixelCount = std::min(ChunkSize, source.Width - x);
+
+        // All steps work on a chunk that stays in the L1 cache, so the pixels
+        // are only loaded from and stored to memory once
+        PixelFormatConverter::ConvertRow(
+          source.PixelFormat, sourceRow + CountRequiredBytes(source.PixelFormat, x),
+          IntermediatePixelFormat, chunk,
+          pixelCount
+        );
+        applyCurve(chunk, pixelCount, exposureFactor, options.Operator);
+        SrgbTransfer::ToSrgbRow(chunk, pixelCount);
+
+        std::uint8_t *targetPixels = targetRow + x * targetLayout.BytesPerPixel;
+        if(isTargetRgba) {
+          quantizeRow(chunk, targetPixels, pixelCount, thresholds, pattern.Mask, x);
+        } else {
+          quantizeRow(chunk, quantized, pixelCount, thresholds, pattern.Mask, x);
+          const std::uint8_t *quantizedPixel = quantized;
+          for(std::size_t index = 0; index < pixelCount; ++index) {
+            targetPixels[targetLayout.Channels[0]] = quantizedPixel[0];
+            targetPixels[targetLayout.Channels[1]] = quantizedPixel[1];
+            targetPixels[targetLayout.Channels[2]] = quantizedPixel[2];
+            if(targetLayout.Channels[3] >= 0) {
+              targetPixels[targetLayout.Channels[3]] = quantizedPixel[3];
+            }
+            quantizedPixel += 4;
+            targetPixels += targetLayout.BytesPerPixel;
+          }
+        }
+      }
+
+      sourceRow += source.Stride;
+      targetRow += target.Stride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if a bitmap can't be tone mapped into another</summary>
+  /// <param name="source">Bitmap memory the pixels will be read from</param>
+  /// <param name="target">Bitmap memory the tone mapped pixels will be written to</param>
+  void requireToneMappableBitmaps(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    using Nuclex::Pixels::ColorModels::ToneMapper;
+
+    if((source.Width != target.Width) || (source.Height != target.Height)) {
+      throw std::runtime_error(u8"Provided bitmap does not have the correct dimensions");
+    }
+    if(!ToneMapper::CanToneMap(source.PixelFormat, target.PixelFormat)) {
+      throw std::runtime_error(u8"Tone mapping between these pixel formats is not supported");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace ColorModels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float ToneMapper::Apply(float linear, ToneMappingOperator mappingOperator) {
+    if(!(linear > 0.0f)) { // also catches NaNs
+      return 0.0f;
+    }
+
+    switch(mappingOperator) {
+      case ToneMappingOperator::Reinhard: {
+        return linear / (linear + 1.0f);
+      }
+      case ToneMappingOperator::AcesFit: {
+        linear = (linear * (linear * 2.51f + 0.03f)) / (linear * (linear * 2.43f + 0.59f) + 0.14f);
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+
+    return std::min(linear, 1.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool ToneMapper::CanToneMap(PixelFormat sourcePixelFormat, PixelFormat targetPixelFormat) {
+    ByteLayout layout;
+    return (
+      getByteLayout(targetPixelFormat, layout) &&
+      PixelFormatConverter::CanConvert(sourcePixelFormat, IntermediatePixelFormat)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ToneMapper::ToneMap(
+    const BitmapMemory &source, const BitmapMemory &target, const ToneMappingOptions &options
+  ) {
+    requireToneMappableBitmaps(source, target);
+    toneMapRows(source, target, options, 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ToneMapper::ToneMap(
+    const BitmapMemory &source, const BitmapMemory &target,
+    const ToneMappingOptions &options, ThreadPool &threadPool
+  ) {
+    requireToneMappableBitmaps(source, target);
+    ForEachBandInParallel(
+      threadPool, source, target,
+      [&options](const BitmapMemory &sourceBand, const BitmapMemory &targetBand, std::size_t y) {
+        toneMapRows(sourceBand, targetBand, options, y);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::ColorModels
@@ -0,0 +1,231 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/DirtyRegionTracker.h"
+
+#include <algorithm> // for std::min(), std::sort()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Run of neighbouring dirty tiles in one or more rows of tiles</summary>
+  struct TileRun {
+
+    /// <summary>Horizontal index of the first tile in the run</summary>
+    public: std::size_t FirstTileX;
+    /// <summary>Horizontal index one past the last tile in the run</summary>
+    public: std::size_t EndTileX;
+    /// <summary>Vertical index of the first row of tiles the run covers</summary>
+    public: std::size_t FirstTileY;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether one rectangle comes before another top to bottom</summary>
+  /// <param name="left">Rectangle that will be checked for coming first</param>
+  /// <param name="right">Rectangle the first rectangle will be compared to</param>
+  /// <returns>True if the left rectangle comes before the right one</returns>
+  bool isAboveOrLeftOf(
+    const Nuclex::Pixels::Rectangle &left, const Nuclex::Pixels::Rectangle &right
+  ) {
+    if(left.MinY == right.MinY) {
+      return (left.MinX < right.MinX);
+    } else {
+      return (left.MinY < right.MinY);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DirtyRegionTracker::DirtyRegionTracker(
+    std::size_t width, std::size_t height, std::size_t tileSize /* = DefaultTileSize */
+  ) :
+    width(width),
+    height(height),
+    tileSize(tileSize),
+    horizontalTileCount(0),
+    verticalTileCount(0),
+    dirtyBits() {
+
+    if(tileSize == 0) {
+      throw std::invalid_argument(u8"Tile size for dirty region tracking must not be zero");
+    }
+
+    this->horizontalTileCount = (width + tileSize - 1) / tileSize;
+    this->verticalTileCount = (height + tileSize - 1) / tileSize;
+
+    std::size_t tileCount = this->horizontalTileCount * this->verticalTileCount;
+    this->dirtyBits.resize((tileCount + 63) / 64, 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DirtyRegionTracker::MarkDirty(const Rectangle &region) {
+    std::size_t maxX = std::min(region.MaxX, this->width);
+    std::size_t maxY = std::min(region.MaxY, this->height);
+    if((region.MinX >= maxX) || (region.MinY >= maxY)) {
+      return;
+    }
+
+    std::size_t firstTileX = region.MinX / this->tileSize;
+    std::size_t endTileX = (maxX + this->tileSize - 1) / this->tileSize;
+    std::size_t endTileY = (maxY + this->tileSize - 1) / this->tileSize;
+    for(std::size_t tileY = region.MinY / this->tileSize; tileY < endTileY; ++tileY) {
+      markTiles(tileY, firstTileX, endTileX);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DirtyRegionTracker::MarkAllDirty() {
+    MarkDirty(Rectangle(0, 0, this->width, this->height));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DirtyRegionTracker::Clear() {
+    std::fill(this->dirtyBits.begin(), this->dirtyBits.end(), std::uint64_t(0));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool DirtyRegionTracker::IsAnyDirty() const {
+    for(std::size_t index = 0; index < this->dirtyBits.size(); ++index) {
+      if(this->dirtyBits[index] != 0) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t DirtyRegionTracker::CountDirtyTiles() const {
+    std::size_t dirtyTileCount = 0;
+    for(std::size_t index = 0; index < this->dirtyBits.size(); ++index) {
+      for(std::uint64_t bits = this->dirtyBits[index]; bits != 0; bits &= (bits - 1)) {
+        ++dirtyTileCount;
+      }
+    }
+
+    return dirtyTileCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<Rectangle> DirtyRegionTracker::GetDirtyRegions() const {
+    std::vector<Rectangle> regions;
+
+    // Runs of dirty tiles that continue down into the current row of tiles unless
+    // the current row has no run with exactly the same horizontal extent
+    std::vector<TileRun> openRuns;
+    std::vector<TileRun> currentRuns;
+
+    for(std::size_t tileY = 0; tileY <= this->verticalTileCount; ++tileY) {
+      currentRuns.clear();
+
+      // Collect the runs of dirty tiles in this row. The row after the last one
+      // has no runs, which closes whatever is still open.
+      if(tileY < this->verticalTileCount) {
+        std::size_t tileX = 0;
+        while(tileX < this->horizontalTileCount) {
+          if(!IsTileDirty(tileX, tileY)) {
+            ++tileX;
+            continue;
+          }
+
+          TileRun run;
+          run.FirstTileX = tileX;
+          run.FirstTileY = tileY;
+          do {
+            ++tileX;
+          } while((tileX < this->horizontalTileCount) && IsTileDirty(tileX, tileY));
+          run.EndTileX = tileX;
+
+          currentRuns.push_back(run);
+        }
+      }
+
+      // Both lists are sorted by their horizontal position, so walk them side by side,
+      // carrying runs with a matching extent over and closing all others
+      std::size_t currentIndex = 0;
+      for(std::size_t openIndex = 0; openIndex < openRuns.size(); ++openIndex) {
+        const TileRun &openRun = openRuns[openIndex];
+        while(
+          (currentIndex < currentRuns.size()) &&
+          (currentRuns[currentIndex].FirstTileX < openRun.FirstTileX)
+        ) {
+          ++currentIndex;
+        }
+
+        bool continuesDown = (
+          (currentIndex < currentRuns.size()) &&
+          (currentRuns[currentIndex].FirstTileX == openRun.FirstTileX) &&
+          (currentRuns[currentIndex].EndTileX == openRun.EndTileX)
+        );
+        if(continuesDown) {
+          currentRuns[currentIndex].FirstTileY = openRun.FirstTileY;
+        } else {
+          regions.push_back(
+            Rectangle(
+              openRun.FirstTileX * this->tileSize,
+              openRun.FirstTileY * this->tileSize,
+              std::min(openRun.EndTileX * this->tileSize, this->width),
+              std::min(tileY * this->tileSize, this->height)
+            )
+          );
+        }
+      }
+
+      openRuns.swap(currentRuns);
+    }
+
+    std::sort(regions.begin(), regions.end(), &isAboveOrLeftOf);
+    return regions;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DirtyRegionTracker::markTiles(
+    std::size_t tileY, std::size_t firstTileX, std::size_t endTileX
+  ) {
+    std::size_t rowStartIndex = tileY * this->horizontalTileCount;
+    for(std::size_t tileX = firstTileX; tileX < endTileX; ++tileX) {
+      std::size_t tileIndex = rowStartIndex + tileX;
+      this->dirtyBits[tileIndex / 64] |= (std::uint64_t(1) << (tileIndex % 64));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,237 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "DitherPatterns.h"
+
+#include <cmath> // for std::exp()
+#include <cstdint>
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Width and height of the Bayer matrix used for ordered dithering</summary>
+  const std::size_t BayerMatrixSize = 8;
+
+  /// <summary>Width and height of the tiled blue noise mask</summary>
+  const std::size_t BlueNoiseSize = 64;
+
+  /// <summary>Standard deviation of the filter used to find voids and clusters</summary>
+  const float BlueNoiseSigma = 1.5f;
+
+  /// <summary>Distance in pixels up to which the void and cluster filter is evaluated</summary>
+  const int BlueNoiseFilterRadius = 6;
+
+  /// <summary>Threshold used when no dithering is requested</summary>
+  const float RoundingThreshold = 0.5f;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a blue noise mask with Ulichney's void and cluster method</summary>
+  /// <param name="ranks">Receives the rank of each pixel in the mask</param>
+  /// <remarks>
+  ///   The mask wraps around at its edges, so it can be tiled without visible seams.
+  ///   Each pixel receives a unique rank from 0 to the number of pixels in the mask.
+  /// </remarks>
+  void generateBlueNoise(std::vector<std::size_t> &ranks) {
+    const std::size_t area = BlueNoiseSize * BlueNoiseSize;
+    const std::size_t mask = BlueNoiseSize - 1;
+    const int filterSize = BlueNoiseFilterRadius * 2 + 1;
+
+    std::vector<float> filter(filterSize * filterSize);
+    for(int y = -BlueNoiseFilterRadius; y <= BlueNoiseFilterRadius; ++y) {
+      for(int x = -BlueNoiseFilterRadius; x <= BlueNoiseFilterRadius; ++x) {
+        filter[(y + BlueNoiseFilterRadius) * filterSize + (x + BlueNoiseFilterRadius)] = (
+          std::exp(-static_cast<float>(x * x + y * y) / (2.0f * BlueNoiseSigma * BlueNoiseSigma))
+        );
+      }
+    }
+
+    std::vector<float> energy(area, 0.0f);
+    std::vector<bool> pattern(area, false);
+
+    // Adds or removes a pixel and updates the energy of its neighbourhood
+    auto toggle = [&](std::size_t index, bool set) {
+      pattern[index] = set;
+      float sign = set ? 1.0f : -1.0f;
+      std::size_t pixelX = index % BlueNoiseSize;
+      std::size_t pixelY = index / BlueNoiseSize;
+      for(int y = -BlueNoiseFilterRadius; y <= BlueNoiseFilterRadius; ++y) {
+        std::size_t rowIndex = ((pixelY + BlueNoiseSize + y) & mask) * BlueNoiseSize;
+        const float *filterRow = &filter[(y + BlueNoiseFilterRadius) * filterSize];
+        for(int x = -BlueNoiseFilterRadius; x <= BlueNoiseFilterRadius; ++x) {
+          energy[rowIndex + ((pixelX + BlueNoiseSize + x) & mask)] += (
+            sign * filterRow[x + BlueNoiseFilterRadius]
+          );
+        }
+      }
+    };
+
+    // Set pixel with the most set pixels around it
+    auto findTightestCluster = [&]() {
+      std::size_t best = area;
+      for(std::size_t index = 0; index < area; ++index) {
+        if(pattern[index] && ((best == area) || (energy[index] > energy[best]))) {
+          best = index;
+        }
+      }
+      return best;
+    };
+
+    // Unset pixel with the fewest set pixels around it
+    auto findLargestVoid = [&]() {
+      std::size_t best = area;
+      for(std::size_t index = 0; index < area; ++index) {
+        if(!pattern[index] && ((best == area) || (energy[index] < energy[best]))) {
+          best = index;
+        }
+      }
+      return best;
+    };
+
+    // Scatter an initial tenth of the pixels with a fixed pseudo-random sequence,
+    // then move pixels from the tightest clusters into the largest voids until
+    // the distribution no longer changes
+    std::size_t initialCount = area / 10;
+    {
+      std::uint32_t seed = 0x12345678U;
+      std::size_t placedCount = 0;
+      while(placedCount < initialCount) {
+        seed = seed * 1664525U + 1013904223U;
+        std::size_t index = (seed >> 8) % area;
+        if(!pattern[index]) {
+          toggle(index, true);
+          ++placedCount;
+        }
+      }
+      for(std::size_t iteration = 0; iteration < area; ++iteration) {
+        std::size_t cluster = findTightestCluster();
+        toggle(cluster, false);
+        std::size_t largestVoid = findLargestVoid();
+        toggle(largestVoid, true);
+        if(largestVoid == cluster) {
+          break;
+        }
+      }
+    }
+
+    ranks.resize(area);
+
+    // Ranks below the initial pattern are assigned by removing the tightest clusters
+    {
+      std::vector<float> initialEnergy(energy);
+      std::vector<bool> initialPattern(pattern);
+
+      for(std::size_t rank = initialCount; rank > 0; --rank) {
+        std::size_t cluster = findTightestCluster();
+        toggle(cluster, false);
+        ranks[cluster] = rank - 1;
+      }
+
+      energy.swap(initialEnergy);
+      pattern.swap(initialPattern);
+    }
+
+    // Ranks above are assigned by filling the largest voids. Past the half-way point,
+    // Ulichney looks for the tightest cluster of unset pixels instead, but on a wrapping
+    // mask that is the same pixel as the largest void of the set ones.
+    for(std::size_t rank = initialCount; rank < area; ++rank) {
+      std::size_t largestVoid = findLargestVoid();
+      toggle(largestVoid, true);
+      ranks[largestVoid] = rank;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Thresholds added to the colors before they are truncated to bytes</summary>
+  struct DitherTables {
+
+    /// <summary>Calculates the Bayer matrix and the blue noise mask</summary>
+    public: DitherTables() {
+      const float bayerScale = 1.0f / static_cast<float>(BayerMatrixSize * BayerMatrixSize);
+      for(std::size_t y = 0; y < BayerMatrixSize; ++y) {
+        for(std::size_t x = 0; x < BayerMatrixSize; ++x) {
+
+          // The Bayer index interleaves the bits of (x xor y) and y in reverse order
+          std::size_t index = 0;
+          for(std::size_t bit = 1; bit < BayerMatrixSize; bit <<= 1) {
+            index = (index << 2) | (((x ^ y) & bit) ? 2 : 0) | ((y & bit) ? 1 : 0);
+          }
+          this->Ordered[y * BayerMatrixSize + x] = (
+            (static_cast<float>(index) + 0.5f) * bayerScale
+          );
+
+        }
+      }
+
+      std::vector<std::size_t> ranks;
+      generateBlueNoise(ranks);
+      const float blueNoiseScale = 1.0f / static_cast<float>(ranks.size());
+      for(std::size_t index = 0; index < ranks.size(); ++index) {
+        this->BlueNoise[index] = (static_cast<float>(ranks[index]) + 0.5f) * blueNoiseScale;
+      }
+    }
+
+    /// <summary>Thresholds of the 8x8 Bayer matrix from 0.0 to 1.0</summary>
+    public: float Ordered[BayerMatrixSize * BayerMatrixSize];
+    /// <summary>Thresholds of the 64x64 blue noise mask from 0.0 to 1.0</summary>
+    public: float BlueNoise[BlueNoiseSize * BlueNoiseSize];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns the dithering thresholds</summary>
+  /// <returns>The dithering thresholds, which are calculated on first use</returns>
+  const DitherTables &getDitherTables() {
+    static const DitherTables tables;
+    return tables;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DitherPattern GetDitherPattern(DitheringMethod method) {
+    switch(method) {
+      case DitheringMethod::Ordered: {
+        return DitherPattern { getDitherTables().Ordered, BayerMatrixSize - 1 };
+      }
+      case DitheringMethod::BlueNoise: {
+        return DitherPattern { getDitherTables().BlueNoise, BlueNoiseSize - 1 };
+      }
+      default: {
+        return DitherPattern { &RoundingThreshold, 0 };
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,73 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_DITHERPATTERNS_H
+#define NUCLEX_PIXELS_DITHERPATTERNS_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/DitheringMethod.h"
+
+#include <cstddef>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Square, tileable matrix of thresholds used for ordered dithering</summary>
+  /// <remarks>
+  ///   Thresholds lie between 0.0 and 1.0 and are added to a scaled color value before it
+  ///   is truncated, so a threshold of 0.5 everywhere is the same as rounding. The size of
+  ///   the pattern is always a power of two, so coordinates can be wrapped with a mask.
+  /// </remarks>
+  struct DitherPattern {
+
+    /// <summary>Looks up the thresholds for a row of pixels</summary>
+    /// <param name="y">Y coordinate of the row in the bitmap</param>
+    /// <returns>The thresholds for the row, to be indexed with <see cref="Mask" /></returns>
+    public: const float *GetRow(std::size_t y) const {
+      return this->Thresholds + (y & this->Mask) * (this->Mask + 1);
+    }
+
+    /// <summary>Thresholds of all pixels in the pattern, row by row</summary>
+    public: const float *Thresholds;
+    /// <summary>Mask that wraps a coordinate into the pattern (its size minus one)</summary>
+    public: std::size_t Mask;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides the threshold pattern of a dithering method</summary>
+  /// <param name="method">Dithering method whose pattern will be provided</param>
+  /// <returns>
+  ///   The threshold pattern of the dithering method. For <see cref="DitheringMethod.None" />,
+  ///   this is a single threshold of 0.5, so callers don't need a separate rounding path.
+  /// </returns>
+  /// <remarks>
+  ///   The blue noise mask is generated with Ulichney's void and cluster method when
+  ///   it is requested for the first time, which takes a few dozen milliseconds.
+  /// </remarks>
+  DitherPattern GetDitherPattern(DitheringMethod method);
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_DITHERPATTERNS_H
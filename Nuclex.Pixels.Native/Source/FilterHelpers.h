@@ -0,0 +1,116 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_FILTERHELPERS_H
+#define NUCLEX_PIXELS_FILTERHELPERS_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/PixelFormat.h"
+
+#include <cstddef>
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel format in which the resampler and the filters process pixels</summary>
+  const PixelFormat FilterPixelFormat = PixelFormat::R32_G32_B32_A32_Float_Native32;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies the color channels of RGBA pixels with their alpha channel</summary>
+  /// <param name="rgba">Pixels that will be premultiplied</param>
+  /// <param name="pixelCount">Number of pixels that will be premultiplied</param>
+  inline void PremultiplyAlpha(float *rgba, std::size_t pixelCount) {
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      float alpha = rgba[3];
+      rgba[0] *= alpha;
+      rgba[1] *= alpha;
+      rgba[2] *= alpha;
+      rgba += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Divides the color channels of RGBA pixels by their alpha channel</summary>
+  /// <param name="rgba">Pixels whose premultiplication will be undone</param>
+  /// <param name="pixelCount">Number of pixels that will be processed</param>
+  inline void UnpremultiplyAlpha(float *rgba, std::size_t pixelCount) {
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      float alpha = rgba[3];
+      if(alpha > 0.0f) {
+        float inverseAlpha = 1.0f / alpha;
+        rgba[0] *= inverseAlpha;
+        rgba[1] *= inverseAlpha;
+        rgba[2] *= inverseAlpha;
+      } else {
+        rgba[0] = rgba[1] = rgba[2] = 0.0f;
+      }
+      rgba += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a weighted row of floats to another row</summary>
+  /// <param name="source">Row that will be weighted and added to the target row</param>
+  /// <param name="target">Row the weighted source row will be added to</param>
+  /// <param name="weight">Weight the source row will be multiplied with</param>
+  /// <param name="floatCount">Number of floats in each row, a multiple of 4</param>
+  inline void AccumulateRow(
+    const float *source, float *target, float weight, std::size_t floatCount
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    __m128 weights = _mm_set1_ps(weight);
+    for(std::size_t index = 0; index < floatCount; index += 4) {
+      _mm_storeu_ps(
+        target + index,
+        _mm_add_ps(
+          _mm_loadu_ps(target + index), _mm_mul_ps(weights, _mm_loadu_ps(source + index))
+        )
+      );
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    for(std::size_t index = 0; index < floatCount; index += 4) {
+      vst1q_f32(
+        target + index,
+        vmlaq_n_f32(vld1q_f32(target + index), vld1q_f32(source + index), weight)
+      );
+    }
+#else
+    for(std::size_t index = 0; index < floatCount; ++index) {
+      target[index] += weight * source[index];
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_FILTERHELPERS_H
@@ -0,0 +1,375 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/FrameDelta.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcmp()
+#include <stdexcept> // for std::invalid_argument
+
+#if defined(NUCLEX_PIXELS_HAVE_AVX2)
+#include <immintrin.h> // for AVX2
+#elif defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of bytes in the header at the beginning of each delta</summary>
+  const std::size_t HeaderByteCount = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Retrieves the address of a row in a bitmap</summary>
+  /// <param name="memory">Bitmap memory holding the row</param>
+  /// <param name="y">Index of the row whose address will be returned</param>
+  /// <returns>The address of the first pixel in the row</returns>
+  std::uint8_t *getRow(const Nuclex::Pixels::BitmapMemory &memory, std::size_t y) {
+    return static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that the differences in a frame can be tracked per tile</summary>
+  /// <param name="frame">Frame that will be checked</param>
+  /// <param name="tileSize">Width and height of the tiles</param>
+  void requireTileableFrame(const Nuclex::Pixels::BitmapMemory &frame, std::size_t tileSize) {
+    if(Nuclex::Pixels::GetBlockSize(frame.PixelFormat).Height != 1) {
+      throw std::invalid_argument(u8"Frame deltas do not support block-compressed formats");
+    }
+    if((tileSize * Nuclex::Pixels::CountBitsPerPixel(frame.PixelFormat)) % 8 != 0) {
+      throw std::invalid_argument(u8"Tiles need to start and end on a byte boundary");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that two frames can be compared with each other</summary>
+  /// <param name="previousFrame">Frame the current frame will be compared to</param>
+  /// <param name="currentFrame">Frame that will be checked for changes</param>
+  /// <param name="changedTiles">Tracker holding the changed tiles</param>
+  void requireComparableFrames(
+    const Nuclex::Pixels::BitmapMemory &previousFrame,
+    const Nuclex::Pixels::BitmapMemory &currentFrame,
+    const Nuclex::Pixels::DirtyRegionTracker &changedTiles
+  ) {
+    bool haveSameLayout = (
+      (previousFrame.Width == currentFrame.Width) &&
+      (previousFrame.Height == currentFrame.Height) &&
+      (previousFrame.PixelFormat == currentFrame.PixelFormat)
+    );
+    if(!haveSameLayout) {
+      throw std::invalid_argument(
+        u8"Frames need to have the same size and pixel format to be compared"
+      );
+    }
+
+    bool trackerMatches = (
+      (changedTiles.GetWidth() == currentFrame.Width) &&
+      (changedTiles.GetHeight() == currentFrame.Height)
+    );
+    if(!trackerMatches) {
+      throw std::invalid_argument(u8"Tracker for changed tiles needs to match the frame size");
+    }
+
+    requireTileableFrame(currentFrame, changedTiles.GetTileSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether two runs of bytes are identical</summary>
+  /// <param name="bytes">First run of bytes that will be compared</param>
+  /// <param name="otherBytes">Second run of bytes that will be compared</param>
+  /// <param name="count">Number of bytes that will be compared</param>
+  /// <returns>True if both runs of bytes are identical</returns>
+  /// <remarks>
+  ///   Compares 32 bytes at a time and stops at the first block that differs. Runs
+  ///   are mostly a few hundred bytes (one row of a tile), too short for memcmp()'s
+  ///   setup to pay off and long enough to keep the vector units busy.
+  /// </remarks>
+  bool areBytesEqual(
+    const std::uint8_t *bytes, const std::uint8_t *otherBytes, std::size_t count
+  ) {
+    std::size_t blockEndIndex = count - (count % 32);
+    std::size_t index = 0;
+#if defined(NUCLEX_PIXELS_HAVE_AVX2)
+    for(; index < blockEndIndex; index += 32) {
+      __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + index));
+      __m256i otherBlock = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(otherBytes + index)
+      );
+      if(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, otherBlock)) != -1) {
+        return false;
+      }
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_SSE2)
+    for(; index < blockEndIndex; index += 32) {
+      const __m128i *block = reinterpret_cast<const __m128i *>(bytes + index);
+      const __m128i *otherBlock = reinterpret_cast<const __m128i *>(otherBytes + index);
+      __m128i equalBytes = _mm_and_si128(
+        _mm_cmpeq_epi8(_mm_loadu_si128(block), _mm_loadu_si128(otherBlock)),
+        _mm_cmpeq_epi8(_mm_loadu_si128(block + 1), _mm_loadu_si128(otherBlock + 1))
+      );
+      if(_mm_movemask_epi8(equalBytes) != 0xFFFF) {
+        return false;
+      }
+    }
+#else
+    for(; index < blockEndIndex; index += 32) {
+      if(std::memcmp(bytes + index, otherBytes + index, 32) != 0) {
+        return false;
+      }
+    }
+#endif
+    return (std::memcmp(bytes + index, otherBytes + index, count - index) == 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the pixel area covered by a tile</summary>
+  /// <param name="frame">Frame that has been divided into tiles</param>
+  /// <param name="tileSize">Width and height of the tiles</param>
+  /// <param name="tileX">Horizontal index of the tile</param>
+  /// <param name="tileY">Vertical index of the tile</param>
+  /// <returns>The area of the tile, clipped to the frame</returns>
+  Nuclex::Pixels::Rectangle getTileArea(
+    const Nuclex::Pixels::BitmapMemory &frame,
+    std::size_t tileSize, std::size_t tileX, std::size_t tileY
+  ) {
+    return Nuclex::Pixels::Rectangle(
+      tileX * tileSize, tileY * tileSize,
+      std::min(tileX * tileSize + tileSize, frame.Width),
+      std::min(tileY * tileSize + tileSize, frame.Height)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a 32 bit integer in little endian byte order to a delta</summary>
+  /// <param name="delta">Delta the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  void appendUInt32(std::vector<std::uint8_t> &delta, std::size_t value) {
+    delta.push_back(static_cast<std::uint8_t>(value));
+    delta.push_back(static_cast<std::uint8_t>(value >> 8));
+    delta.push_back(static_cast<std::uint8_t>(value >> 16));
+    delta.push_back(static_cast<std::uint8_t>(value >> 24));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 32 bit integer in little endian byte order from a delta</summary>
+  /// <param name="bytes">Address at which the integer is stored</param>
+  /// <returns>The integer stored at the specified address</returns>
+  std::size_t readUInt32(const std::uint8_t *bytes) {
+    return (
+      static_cast<std::size_t>(bytes[0]) |
+      (static_cast<std::size_t>(bytes[1]) << 8) |
+      (static_cast<std::size_t>(bytes[2]) << 16) |
+      (static_cast<std::size_t>(bytes[3]) << 24)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t FrameDelta::FindChangedTiles(
+    const BitmapMemory &previousFrame, const BitmapMemory &currentFrame,
+    DirtyRegionTracker &changedTiles
+  ) {
+    requireComparableFrames(previousFrame, currentFrame, changedTiles);
+
+    std::size_t tileSize = changedTiles.GetTileSize();
+    std::size_t horizontalTileCount = changedTiles.CountHorizontalTiles();
+    std::size_t verticalTileCount = changedTiles.CountVerticalTiles();
+    std::size_t tileRowByteCount = CountRequiredBytes(currentFrame.PixelFormat, tileSize);
+    std::size_t frameRowByteCount = CountRequiredBytes(
+      currentFrame.PixelFormat, currentFrame.Width
+    );
+
+    // Walk through the frame row by row rather than tile by tile, so the memory
+    // is read front to back. Tiles already known to differ are skipped.
+    std::vector<bool> isTileChanged(horizontalTileCount);
+    std::size_t changedTileCount = 0;
+    for(std::size_t tileY = 0; tileY < verticalTileCount; ++tileY) {
+      std::size_t remainingTileCount = 0;
+      for(std::size_t tileX = 0; tileX < horizontalTileCount; ++tileX) {
+        isTileChanged[tileX] = changedTiles.IsTileDirty(tileX, tileY);
+        if(!isTileChanged[tileX]) {
+          ++remainingTileCount;
+        }
+      }
+
+      std::size_t endY = std::min(tileY * tileSize + tileSize, currentFrame.Height);
+      for(std::size_t y = tileY * tileSize; (y < endY) && (remainingTileCount > 0); ++y) {
+        const std::uint8_t *previousRow = getRow(previousFrame, y);
+        const std::uint8_t *currentRow = getRow(currentFrame, y);
+        for(std::size_t tileX = 0; tileX < horizontalTileCount; ++tileX) {
+          if(isTileChanged[tileX]) {
+            continue;
+          }
+
+          std::size_t offset = tileX * tileRowByteCount;
+          std::size_t count = std::min(tileRowByteCount, frameRowByteCount - offset);
+          if(!areBytesEqual(previousRow + offset, currentRow + offset, count)) {
+            isTileChanged[tileX] = true;
+            changedTiles.MarkDirty(getTileArea(currentFrame, tileSize, tileX, tileY));
+            --remainingTileCount;
+            ++changedTileCount;
+          }
+        }
+      }
+    }
+
+    return changedTileCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::uint8_t> FrameDelta::Encode(
+    const BitmapMemory &previousFrame, const BitmapMemory &currentFrame,
+    const DirtyRegionTracker &changedTiles
+  ) {
+    requireComparableFrames(previousFrame, currentFrame, changedTiles);
+
+    std::size_t tileSize = changedTiles.GetTileSize();
+    std::size_t horizontalTileCount = changedTiles.CountHorizontalTiles();
+    std::size_t verticalTileCount = changedTiles.CountVerticalTiles();
+
+    std::vector<std::uint8_t> delta;
+    delta.reserve(HeaderByteCount);
+    appendUInt32(delta, currentFrame.Width);
+    appendUInt32(delta, currentFrame.Height);
+    appendUInt32(delta, tileSize);
+    appendUInt32(delta, changedTiles.CountDirtyTiles());
+
+    for(std::size_t tileY = 0; tileY < verticalTileCount; ++tileY) {
+      for(std::size_t tileX = 0; tileX < horizontalTileCount; ++tileX) {
+        if(!changedTiles.IsTileDirty(tileX, tileY)) {
+          continue;
+        }
+
+        Rectangle area = getTileArea(currentFrame, tileSize, tileX, tileY);
+        std::size_t offset = CountRequiredBytes(currentFrame.PixelFormat, area.MinX);
+        std::size_t count = CountRequiredBytes(
+          currentFrame.PixelFormat, area.MaxX - area.MinX
+        );
+
+        appendUInt32(delta, tileY * horizontalTileCount + tileX);
+
+        std::size_t index = delta.size();
+        delta.resize(index + count * (area.MaxY - area.MinY));
+        for(std::size_t y = area.MinY; y < area.MaxY; ++y) {
+          const std::uint8_t *previousRow = getRow(previousFrame, y) + offset;
+          const std::uint8_t *currentRow = getRow(currentFrame, y) + offset;
+          for(std::size_t byteIndex = 0; byteIndex < count; ++byteIndex) {
+            delta[index + byteIndex] = previousRow[byteIndex] ^ currentRow[byteIndex];
+          }
+          index += count;
+        }
+      }
+    }
+
+    return delta;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::uint8_t> FrameDelta::Encode(
+    const BitmapMemory &previousFrame, const BitmapMemory &currentFrame,
+    std::size_t tileSize /* = DirtyRegionTracker::DefaultTileSize */
+  ) {
+    DirtyRegionTracker changedTiles(currentFrame.Width, currentFrame.Height, tileSize);
+    FindChangedTiles(previousFrame, currentFrame, changedTiles);
+    return Encode(previousFrame, currentFrame, changedTiles);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FrameDelta::Apply(
+    const BitmapMemory &frame, const std::uint8_t *delta, std::size_t deltaByteCount
+  ) {
+    if(deltaByteCount < HeaderByteCount) {
+      throw std::invalid_argument(u8"Frame delta is truncated");
+    }
+
+    bool frameMatches = (
+      (readUInt32(delta) == frame.Width) &&
+      (readUInt32(delta + 4) == frame.Height)
+    );
+    if(!frameMatches) {
+      throw std::invalid_argument(u8"Frame delta was encoded for a frame of different size");
+    }
+
+    std::size_t tileSize = readUInt32(delta + 8);
+    if(tileSize == 0) {
+      throw std::invalid_argument(u8"Frame delta specifies an invalid tile size");
+    }
+    requireTileableFrame(frame, tileSize);
+
+    std::size_t horizontalTileCount = (frame.Width + tileSize - 1) / tileSize;
+    std::size_t totalTileCount = horizontalTileCount * ((frame.Height + tileSize - 1) / tileSize);
+    std::size_t changedTileCount = readUInt32(delta + 12);
+
+    std::size_t index = HeaderByteCount;
+    for(std::size_t tileIndex = 0; tileIndex < changedTileCount; ++tileIndex) {
+      if(deltaByteCount - index < 4) {
+        throw std::invalid_argument(u8"Frame delta is truncated");
+      }
+      std::size_t changedTileIndex = readUInt32(delta + index);
+      if(changedTileIndex >= totalTileCount) {
+        throw std::invalid_argument(u8"Frame delta contains a tile outside of the frame");
+      }
+      index += 4;
+
+      Rectangle area = getTileArea(
+        frame, tileSize,
+        changedTileIndex % horizontalTileCount, changedTileIndex / horizontalTileCount
+      );
+      std::size_t offset = CountRequiredBytes(frame.PixelFormat, area.MinX);
+      std::size_t count = CountRequiredBytes(frame.PixelFormat, area.MaxX - area.MinX);
+      if(deltaByteCount - index < count * (area.MaxY - area.MinY)) {
+        throw std::invalid_argument(u8"Frame delta is truncated");
+      }
+
+      for(std::size_t y = area.MinY; y < area.MaxY; ++y) {
+        std::uint8_t *row = getRow(frame, y) + offset;
+        for(std::size_t byteIndex = 0; byteIndex < count; ++byteIndex) {
+          row[byteIndex] ^= delta[index + byteIndex];
+        }
+        index += count;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
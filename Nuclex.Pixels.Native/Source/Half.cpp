@@ -23,6 +23,29 @@ License along with this library
 
 #include "Nuclex/Pixels/Half.h"
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define NUCLEX_PIXELS_HALF_USE_F16C 1
+  #include <immintrin.h> // for F16C
+  #if defined(_MSC_VER)
+    #include <intrin.h> // for __cpuid() and _xgetbv()
+  #else
+    #include <cpuid.h> // for __get_cpuid()
+  #endif
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+  #if defined(__aarch64__) || (defined(__ARM_FP) && (__ARM_FP & 2))
+    #define NUCLEX_PIXELS_HALF_USE_NEON 1
+    #include <arm_neon.h> // for NEON
+  #endif
+#endif
+
+// The F16C code is compiled even if the compiler isn't told to target F16C and
+// the CPU is checked at runtime. GCC and clang need the functions marked for this.
+#if defined(NUCLEX_PIXELS_HALF_USE_F16C) && (defined(__GNUC__) || defined(__clang__))
+  #define NUCLEX_PIXELS_HALF_F16C_FUNCTION __attribute__((target("avx,f16c")))
+#else
+  #define NUCLEX_PIXELS_HALF_F16C_FUNCTION
+#endif
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
@@ -59,6 +82,170 @@ namespace {
   const std::int32_t minD = minC - subC - 1;
 
   // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HALF_USE_F16C)
+  /// <summary>Checks whether the CPU and operating system support the F16C instructions</summary>
+  /// <returns>True if the F16C instructions can be used</returns>
+  bool detectF16c() {
+#if defined(__F16C__)
+    return true;
+#else
+    unsigned int ecx;
+#if defined(_MSC_VER)
+    int cpuInfo[4];
+    __cpuid(cpuInfo, 1);
+    ecx = static_cast<unsigned int>(cpuInfo[2]);
+#else
+    unsigned int eax, ebx, edx;
+    if(__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+      return false;
+    }
+#endif
+
+    // F16C is VEX-encoded, so the operating system also needs to save the AVX registers
+    const unsigned int osxsaveBit = (1U << 27), avxBit = (1U << 28), f16cBit = (1U << 29);
+    if((ecx & (osxsaveBit | avxBit | f16cBit)) != (osxsaveBit | avxBit | f16cBit)) {
+      return false;
+    }
+
+#if defined(_MSC_VER)
+    unsigned long long enabledStates = _xgetbv(0);
+#else
+    unsigned int enabledStatesLow, enabledStatesHigh;
+    __asm__("xgetbv" : "=a"(enabledStatesLow), "=d"(enabledStatesHigh) : "c"(0));
+    unsigned int enabledStates = enabledStatesLow;
+#endif
+    return ((enabledStates & 6) == 6); // SSE and AVX register states
+#endif
+  }
+#endif // defined(NUCLEX_PIXELS_HALF_USE_F16C)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HALF_USE_F16C)
+  /// <summary>Converts floating point values into half-precision floats using F16C</summary>
+  /// <param name="values">Floating point values that will be converted</param>
+  /// <param name="bits">Receives the bits of the half-precision floats</param>
+  /// <param name="count">Number of values that will be converted</param>
+  NUCLEX_PIXELS_HALF_F16C_FUNCTION void convertFromFloatsF16c(
+    const float *values, std::uint16_t *bits, std::size_t count
+  ) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 largestHalf = _mm256_set1_ps(65504.0f);
+    const __m256 infinity = _mm256_castsi256_ps(_mm256_set1_epi32(infN));
+
+    std::size_t index = 0;
+    for(; index + 8 <= count; index += 8) {
+      __m256 value = _mm256_loadu_ps(values + index);
+
+      // Rounding towards zero matches the scalar conversion, except for values too large
+      // for a half: these would become the largest half, but the scalar code turns
+      // them into infinity, so do the same before converting.
+      __m256 sign = _mm256_and_ps(value, signMask);
+      __m256 isTooLarge = _mm256_cmp_ps(
+        _mm256_andnot_ps(signMask, value), largestHalf, _CMP_GT_OQ
+      );
+      value = _mm256_blendv_ps(value, _mm256_or_ps(infinity, sign), isTooLarge);
+
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(bits + index), _mm256_cvtps_ph(value, _MM_FROUND_TO_ZERO)
+      );
+    }
+
+    for(; index < count; ++index) {
+      bits[index] = Nuclex::Pixels::Half::BitsFromFloat(values[index]);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HALF_USE_F16C)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HALF_USE_F16C)
+  /// <summary>Converts half-precision floats into floating point values using F16C</summary>
+  /// <param name="bits">Bits of the half-precision floats that will be converted</param>
+  /// <param name="values">Receives the floating point values</param>
+  /// <param name="count">Number of values that will be converted</param>
+  NUCLEX_PIXELS_HALF_F16C_FUNCTION void convertToFloatsF16c(
+    const std::uint16_t *bits, float *values, std::size_t count
+  ) {
+    std::size_t index = 0;
+    for(; index + 8 <= count; index += 8) {
+      __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bits + index));
+      _mm256_storeu_ps(values + index, _mm256_cvtph_ps(half));
+    }
+
+    for(; index < count; ++index) {
+      values[index] = Nuclex::Pixels::Half::FloatFromBits(bits[index]);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HALF_USE_F16C)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HALF_USE_NEON)
+  /// <summary>Converts floating point values into half-precision floats using NEON</summary>
+  /// <param name="values">Floating point values that will be converted</param>
+  /// <param name="bits">Receives the bits of the half-precision floats</param>
+  /// <param name="count">Number of values that will be converted</param>
+  /// <remarks>
+  ///   The conversion instruction rounds according to the FPU's rounding mode while
+  ///   the scalar code always rounds towards zero. Dropping the mantissa bits a half
+  ///   cannot store before converting makes the conversion exact, so the rounding mode
+  ///   doesn't matter. Results that would be subnormal halfs are calculated with
+  ///   integer truncation instead, just like the scalar code does.
+  /// </remarks>
+  void convertFromFloatsNeon(const float *values, std::uint16_t *bits, std::size_t count) {
+    const uint32x4_t signMask = vdupq_n_u32(0x80000000U);
+    const uint32x4_t truncationMask = vdupq_n_u32(0xFFFFE000U);
+    const float32x4_t largestHalf = vdupq_n_f32(65504.0f);
+    const float32x4_t smallestNormalHalf = vdupq_n_f32(6.103515625e-05f); // 2^-14
+    const float32x4_t subnormalScale = vdupq_n_f32(16777216.0f); // 2^24
+    const uint32x4_t infinity = vdupq_n_u32(static_cast<std::uint32_t>(infN));
+
+    std::size_t index = 0;
+    for(; index + 4 <= count; index += 4) {
+      uint32x4_t value = vreinterpretq_u32_f32(vld1q_f32(values + index));
+      uint32x4_t sign = vandq_u32(value, signMask);
+      float32x4_t magnitude = vreinterpretq_f32_u32(vbicq_u32(value, signMask));
+
+      // Too large values become infinity, NaNs are left alone so they stay NaNs
+      uint32x4_t isNumber = vceqq_f32(magnitude, magnitude);
+      uint32x4_t isTooLarge = vcgtq_f32(magnitude, largestHalf);
+      uint32x4_t truncated = vbslq_u32(
+        isNumber, vandq_u32(vreinterpretq_u32_f32(magnitude), truncationMask),
+        vreinterpretq_u32_f32(magnitude)
+      );
+      truncated = vbslq_u32(isTooLarge, infinity, truncated);
+      uint16x4_t normal = vreinterpret_u16_f16(
+        vcvt_f16_f32(vreinterpretq_f32_u32(truncated))
+      );
+
+      uint16x4_t subnormal = vmovn_u32(vcvtq_u32_f32(vmulq_f32(magnitude, subnormalScale)));
+      uint16x4_t isSubnormal = vmovn_u32(vcltq_f32(magnitude, smallestNormalHalf));
+
+      uint16x4_t half = vorr_u16(
+        vbsl_u16(isSubnormal, subnormal, normal), vshrn_n_u32(sign, 16)
+      );
+      vst1_u16(bits + index, half);
+    }
+
+    for(; index < count; ++index) {
+      bits[index] = Nuclex::Pixels::Half::BitsFromFloat(values[index]);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HALF_USE_NEON)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HALF_USE_NEON)
+  /// <summary>Converts half-precision floats into floating point values using NEON</summary>
+  /// <param name="bits">Bits of the half-precision floats that will be converted</param>
+  /// <param name="values">Receives the floating point values</param>
+  /// <param name="count">Number of values that will be converted</param>
+  void convertToFloatsNeon(const std::uint16_t *bits, float *values, std::size_t count) {
+    std::size_t index = 0;
+    for(; index + 4 <= count; index += 4) {
+      float16x4_t half = vreinterpret_f16_u16(vld1_u16(bits + index));
+      vst1q_f32(values + index, vcvt_f32_f16(half));
+    }
+
+    for(; index < count; ++index) {
+      values[index] = Nuclex::Pixels::Half::FloatFromBits(bits[index]);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HALF_USE_NEON)
+  // ------------------------------------------------------------------------------------------- //
 
 } // anonymous namespace
 
@@ -74,6 +261,38 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
+  // Generated by storing BitsFromFloat(static_cast<float>(index) / 255.0f) for each index
+  const std::uint16_t Half::normalizedByteBits[256] = {
+    0x0000, 0x1c04, 0x2004, 0x2206, 0x2404, 0x2505, 0x2606, 0x2707, 0x2804, 0x2884,
+    0x2905, 0x2985, 0x2a06, 0x2a86, 0x2b07, 0x2b87, 0x2c04, 0x2c44, 0x2c84, 0x2cc4,
+    0x2d05, 0x2d45, 0x2d85, 0x2dc5, 0x2e06, 0x2e46, 0x2e86, 0x2ec6, 0x2f07, 0x2f47,
+    0x2f87, 0x2fc7, 0x3004, 0x3024, 0x3044, 0x3064, 0x3084, 0x30a4, 0x30c4, 0x30e4,
+    0x3105, 0x3125, 0x3145, 0x3165, 0x3185, 0x31a5, 0x31c5, 0x31e5, 0x3206, 0x3226,
+    0x3246, 0x3266, 0x3286, 0x32a6, 0x32c6, 0x32e6, 0x3307, 0x3327, 0x3347, 0x3367,
+    0x3387, 0x33a7, 0x33c7, 0x33e7, 0x3404, 0x3414, 0x3424, 0x3434, 0x3444, 0x3454,
+    0x3464, 0x3474, 0x3484, 0x3494, 0x34a4, 0x34b4, 0x34c4, 0x34d4, 0x34e4, 0x34f4,
+    0x3505, 0x3515, 0x3525, 0x3535, 0x3545, 0x3555, 0x3565, 0x3575, 0x3585, 0x3595,
+    0x35a5, 0x35b5, 0x35c5, 0x35d5, 0x35e5, 0x35f5, 0x3606, 0x3616, 0x3626, 0x3636,
+    0x3646, 0x3656, 0x3666, 0x3676, 0x3686, 0x3696, 0x36a6, 0x36b6, 0x36c6, 0x36d6,
+    0x36e6, 0x36f6, 0x3707, 0x3717, 0x3727, 0x3737, 0x3747, 0x3757, 0x3767, 0x3777,
+    0x3787, 0x3797, 0x37a7, 0x37b7, 0x37c7, 0x37d7, 0x37e7, 0x37f7, 0x3804, 0x380c,
+    0x3814, 0x381c, 0x3824, 0x382c, 0x3834, 0x383c, 0x3844, 0x384c, 0x3854, 0x385c,
+    0x3864, 0x386c, 0x3874, 0x387c, 0x3884, 0x388c, 0x3894, 0x389c, 0x38a4, 0x38ac,
+    0x38b4, 0x38bc, 0x38c4, 0x38cc, 0x38d4, 0x38dc, 0x38e4, 0x38ec, 0x38f4, 0x38fc,
+    0x3905, 0x390d, 0x3915, 0x391d, 0x3925, 0x392d, 0x3935, 0x393d, 0x3945, 0x394d,
+    0x3955, 0x395d, 0x3965, 0x396d, 0x3975, 0x397d, 0x3985, 0x398d, 0x3995, 0x399d,
+    0x39a5, 0x39ad, 0x39b5, 0x39bd, 0x39c5, 0x39cd, 0x39d5, 0x39dd, 0x39e5, 0x39ed,
+    0x39f5, 0x39fd, 0x3a06, 0x3a0e, 0x3a16, 0x3a1e, 0x3a26, 0x3a2e, 0x3a36, 0x3a3e,
+    0x3a46, 0x3a4e, 0x3a56, 0x3a5e, 0x3a66, 0x3a6e, 0x3a76, 0x3a7e, 0x3a86, 0x3a8e,
+    0x3a96, 0x3a9e, 0x3aa6, 0x3aae, 0x3ab6, 0x3abe, 0x3ac6, 0x3ace, 0x3ad6, 0x3ade,
+    0x3ae6, 0x3aee, 0x3af6, 0x3afe, 0x3b07, 0x3b0f, 0x3b17, 0x3b1f, 0x3b27, 0x3b2f,
+    0x3b37, 0x3b3f, 0x3b47, 0x3b4f, 0x3b57, 0x3b5f, 0x3b67, 0x3b6f, 0x3b77, 0x3b7f,
+    0x3b87, 0x3b8f, 0x3b97, 0x3b9f, 0x3ba7, 0x3baf, 0x3bb7, 0x3bbf, 0x3bc7, 0x3bcf,
+    0x3bd7, 0x3bdf, 0x3be7, 0x3bef, 0x3bf7, 0x3c00
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::uint16_t Half::BitsFromFloat(float value) {
     Bits v, s;
     v.f = value;
@@ -123,4 +342,67 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void Half::ConvertFromFloats(const float *values, Half *halfs, std::size_t count) {
+    static_assert(sizeof(Half) == sizeof(std::uint16_t), u8"Half must be stored as 16 bits");
+    std::uint16_t *bits = reinterpret_cast<std::uint16_t *>(halfs);
+
+#if defined(NUCLEX_PIXELS_HALF_USE_F16C)
+    static const bool isF16cSupported = detectF16c();
+    if(isF16cSupported) {
+      convertFromFloatsF16c(values, bits, count);
+      return;
+    }
+#elif defined(NUCLEX_PIXELS_HALF_USE_NEON)
+    convertFromFloatsNeon(values, bits, count);
+    return;
+#endif
+
+    for(std::size_t index = 0; index < count; ++index) {
+      bits[index] = BitsFromFloat(values[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Half::ConvertToFloats(const Half *halfs, float *values, std::size_t count) {
+    const std::uint16_t *bits = reinterpret_cast<const std::uint16_t *>(halfs);
+
+#if defined(NUCLEX_PIXELS_HALF_USE_F16C)
+    static const bool isF16cSupported = detectF16c();
+    if(isF16cSupported) {
+      convertToFloatsF16c(bits, values, count);
+      return;
+    }
+#elif defined(NUCLEX_PIXELS_HALF_USE_NEON)
+    convertToFloatsNeon(bits, values, count);
+    return;
+#endif
+
+    for(std::size_t index = 0; index < count; ++index) {
+      values[index] = FloatFromBits(bits[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Half::ConvertFromNormalizedBytes(
+    const std::uint8_t *bytes, Half *halfs, std::size_t count
+  ) {
+    for(std::size_t index = 0; index < count; ++index) {
+      halfs[index].bits = normalizedByteBits[bytes[index]];
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Half::ConvertToNormalizedBytes(
+    const Half *halfs, std::uint8_t *bytes, std::size_t count
+  ) {
+    for(std::size_t index = 0; index < count; ++index) {
+      bytes[index] = halfs[index].ToNormalizedByte();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Pixels
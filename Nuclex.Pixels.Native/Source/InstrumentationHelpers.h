@@ -0,0 +1,54 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_INSTRUMENTATIONHELPERS_H
+#define NUCLEX_PIXELS_INSTRUMENTATIONHELPERS_H
+
+#include "Nuclex/Pixels/Config.h"
+
+// Nuclex.Pixels does not depend on Nuclex.Support. Only builds that define
+// NUCLEX_PIXELS_INSTRUMENTATION (and then have to link Nuclex.Support) report how long
+// loading and saving takes to the instrumentation sink installed through Nuclex.Support.
+// In all other builds, the macros expand to nothing.
+#if defined(NUCLEX_PIXELS_INSTRUMENTATION)
+
+  #if !defined(NUCLEX_SUPPORT_INSTRUMENTATION)
+    #define NUCLEX_SUPPORT_INSTRUMENTATION 1
+  #endif
+  #include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+  /// <summary>Measures the time until the end of the enclosing scope</summary>
+  /// <param name="name">String literal naming the zone</param>
+  #define NUCLEX_PIXELS_INSTRUMENT_ZONE(name) NUCLEX_SUPPORT_INSTRUMENT_ZONE(name)
+
+  /// <summary>Adds an amount to a counter that is created on first use</summary>
+  /// <param name="name">String literal naming the counter</param>
+  /// <param name="amount">Amount that will be added to the counter</param>
+  #define NUCLEX_PIXELS_INSTRUMENT_COUNT(name, amount) \
+    NUCLEX_SUPPORT_INSTRUMENT_COUNT(name, amount)
+
+#else
+
+  #define NUCLEX_PIXELS_INSTRUMENT_ZONE(name) static_cast<void>(0)
+  #define NUCLEX_PIXELS_INSTRUMENT_COUNT(name, amount) static_cast<void>(0)
+
+#endif
+
+#endif // NUCLEX_PIXELS_INSTRUMENTATIONHELPERS_H
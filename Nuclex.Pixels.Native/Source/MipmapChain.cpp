@@ -0,0 +1,321 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/MipmapChain.h"
+#include "Nuclex/Pixels/BitmapAllocator.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/ColorModels/SrgbTransfer.h"
+
+#include <algorithm> // for std::min(), std::copy_n()
+#include <cstdint>
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::runtime_error
+#include <utility> // for std::move()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel format in which the levels are averaged</summary>
+  const Nuclex::Pixels::PixelFormat FilterPixelFormat = (
+    Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32
+  );
+
+  /// <summary>Number of bytes each level's first pixel is aligned to</summary>
+  const std::size_t LevelAlignment = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds the specified value to the next multiple of a factor</summary>
+  /// <param name="value">Value that will be rounded up</param>
+  /// <param name="factor">Factor to which the value will be rounded up</param>
+  /// <returns>The next multiple of the specified factor</returns>
+  std::size_t nextMultiple(std::size_t value, std::size_t factor) {
+    std::size_t remainder = value % factor;
+    if(remainder > 0) {
+      value += (factor - remainder);
+    }
+
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Computes all levels of a mipmap chain as rows of the first level arrive</summary>
+  class MipmapBuilder {
+
+    /// <summary>Initializes a new mipmap builder</summary>
+    /// <param name="levels">Levels that will be filled by the builder</param>
+    /// <param name="isSrgb">Whether the color channels are sRGB-encoded</param>
+    public: MipmapBuilder(const std::vector<Nuclex::Pixels::BitmapMemory> &levels, bool isSrgb) :
+      levels(levels),
+      isSrgb(isSrgb),
+      previousRows(levels.size()),
+      averagedRows(levels.size()),
+      encodedRow(levels.front().Width * 4) {
+      for(std::size_t index = 0; index < levels.size(); ++index) {
+        this->previousRows[index].resize(levels[index].Width * 4);
+        this->averagedRows[index].resize(levels[index].Width * 4);
+      }
+    }
+
+    /// <summary>Processes the rows of the first level</summary>
+    /// <param name="source">Bitmap memory holding the pixels of the first level</param>
+    public: void Build(const Nuclex::Pixels::BitmapMemory &source) {
+      const Nuclex::Pixels::BitmapMemory &firstLevel = this->levels.front();
+      std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+        firstLevel.PixelFormat, firstLevel.Width
+      );
+
+      std::vector<float> row(firstLevel.Width * 4);
+      const std::uint8_t *sourcePixels = static_cast<const std::uint8_t *>(source.Pixels);
+      std::uint8_t *targetPixels = static_cast<std::uint8_t *>(firstLevel.Pixels);
+      for(std::size_t y = 0; y < firstLevel.Height; ++y) {
+        std::memcpy(targetPixels, sourcePixels, rowByteCount);
+
+        Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+          source.PixelFormat, sourcePixels, FilterPixelFormat, row.data(), source.Width
+        );
+        if(this->isSrgb) {
+          Nuclex::Pixels::ColorModels::SrgbTransfer::ToLinearRow(row.data(), source.Width);
+        }
+        addRow(0, y, row.data());
+
+        sourcePixels += source.Stride;
+        targetPixels += firstLevel.Stride;
+      }
+    }
+
+    /// <summary>Stores a completed row and computes the next level's row if possible</summary>
+    /// <param name="levelIndex">Index of the level the row belongs to</param>
+    /// <param name="y">Index of the row within the level</param>
+    /// <param name="row">Linear RGBA pixels of the row</param>
+    private: void addRow(std::size_t levelIndex, std::size_t y, const float *row) {
+      const Nuclex::Pixels::BitmapMemory &level = this->levels[levelIndex];
+
+      // The first level is copied unmodified, all others need to be encoded
+      if(levelIndex > 0) {
+        const float *rgba = row;
+        if(this->isSrgb) {
+          std::copy_n(row, level.Width * 4, this->encodedRow.data());
+          Nuclex::Pixels::ColorModels::SrgbTransfer::ToSrgbRow(
+            this->encodedRow.data(), level.Width
+          );
+          rgba = this->encodedRow.data();
+        }
+
+        Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+          FilterPixelFormat, rgba,
+          level.PixelFormat, static_cast<std::uint8_t *>(level.Pixels) + y * level.Stride,
+          level.Width
+        );
+      }
+
+      if(levelIndex + 1 >= this->levels.size()) {
+        return;
+      }
+
+      // Rows of the next level are computed from pairs of rows, single-row levels
+      // are paired with themselves. Wait for the second row of each pair.
+      bool completesPair = ((y % 2) == 1) || (level.Height == 1);
+      if(!completesPair) {
+        std::copy_n(row, level.Width * 4, this->previousRows[levelIndex].data());
+        return;
+      }
+
+      const Nuclex::Pixels::BitmapMemory &nextLevel = this->levels[levelIndex + 1];
+      std::size_t nextY = y / 2;
+      if(nextY >= nextLevel.Height) {
+        return; // Last row of a level with odd height
+      }
+
+      const float *upperRow = (level.Height == 1) ? row : this->previousRows[levelIndex].data();
+      float *averagedRow = this->averagedRows[levelIndex + 1].data();
+      for(std::size_t x = 0; x < nextLevel.Width; ++x) {
+        std::size_t left = x * 8;
+        std::size_t right = std::min(x * 2 + 1, level.Width - 1) * 4;
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          averagedRow[x * 4 + channel] = 0.25f * (
+            upperRow[left + channel] + upperRow[right + channel] +
+            row[left + channel] + row[right + channel]
+          );
+        }
+      }
+
+      addRow(levelIndex + 1, nextY, averagedRow);
+    }
+
+    /// <summary>Levels that are being filled by the builder</summary>
+    private: const std::vector<Nuclex::Pixels::BitmapMemory> &levels;
+    /// <summary>Whether the color channels are sRGB-encoded</summary>
+    private: bool isSrgb;
+    /// <summary>Even row of each level waiting for the odd row to complete the pair</summary>
+    private: std::vector<std::vector<float>> previousRows;
+    /// <summary>Row of each level that has been averaged from the previous level</summary>
+    private: std::vector<std::vector<float>> averagedRows;
+    /// <summary>Scratch space for re-encoding a row to sRGB</summary>
+    private: std::vector<float> encodedRow;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t MipmapChain::CountLevels(std::size_t width, std::size_t height) {
+    std::size_t size = std::max(width, height);
+
+    std::size_t levelCount = 1;
+    while(size > 1) {
+      size /= 2;
+      ++levelCount;
+    }
+
+    return levelCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MipmapChain::MipmapChain(
+    const BitmapMemory &source,
+    MipmapColorSpace colorSpace /* = MipmapColorSpace::Linear */,
+    std::size_t maximumLevelCount /* = 0 */
+  ) :
+    allocator(&BitmapAllocator::GetDefault()),
+    memory(nullptr),
+    allocatedByteCount(0),
+    pixelByteCount(0) {
+
+    if((source.Width == 0) || (source.Height == 0)) {
+      throw std::runtime_error(u8"Provided source bitmap does not contain any pixels");
+    }
+    if(!PixelFormatConverter::CanConvert(source.PixelFormat, FilterPixelFormat)) {
+      throw std::runtime_error(u8"Building mipmaps in this pixel format is not supported");
+    }
+
+    std::size_t levelCount = CountLevels(source.Width, source.Height);
+    if((maximumLevelCount > 0) && (maximumLevelCount < levelCount)) {
+      levelCount = maximumLevelCount;
+    }
+
+    // Lay out the levels one after another
+    std::vector<std::size_t> offsets(levelCount);
+    {
+      BitmapMemory level;
+      level.Width = source.Width;
+      level.Height = source.Height;
+      level.PixelFormat = source.PixelFormat;
+
+      this->levels.reserve(levelCount);
+      for(std::size_t index = 0; index < levelCount; ++index) {
+        std::size_t rowByteCount = CountRequiredBytes(level.PixelFormat, level.Width);
+        level.Stride = static_cast<int>(rowByteCount);
+        level.Pixels = nullptr;
+        this->levels.push_back(level);
+        offsets[index] = this->pixelByteCount;
+
+        this->pixelByteCount += rowByteCount * level.Height;
+        if(index + 1 < levelCount) {
+          this->pixelByteCount = nextMultiple(this->pixelByteCount, LevelAlignment);
+        }
+
+        level.Width = std::max<std::size_t>(level.Width / 2, 1);
+        level.Height = std::max<std::size_t>(level.Height / 2, 1);
+      }
+    }
+
+    // Allocate a single memory block for all levels with room to align the first one
+    this->allocatedByteCount = this->pixelByteCount + (LevelAlignment - 1);
+    this->memory = this->allocator->Allocate(this->allocatedByteCount);
+    {
+      std::uintptr_t address = reinterpret_cast<std::uintptr_t>(this->memory);
+      std::uint8_t *firstPixel = static_cast<std::uint8_t *>(this->memory) + (
+        nextMultiple(address, LevelAlignment) - address
+      );
+      for(std::size_t index = 0; index < levelCount; ++index) {
+        this->levels[index].Pixels = firstPixel + offsets[index];
+      }
+    }
+
+    try {
+      MipmapBuilder builder(this->levels, (colorSpace == MipmapColorSpace::Srgb));
+      builder.Build(source);
+    }
+    catch(...) {
+      free();
+      throw;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MipmapChain::MipmapChain(MipmapChain &&other) :
+    levels(std::move(other.levels)),
+    allocator(other.allocator),
+    memory(other.memory),
+    allocatedByteCount(other.allocatedByteCount),
+    pixelByteCount(other.pixelByteCount) {
+    other.memory = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MipmapChain::~MipmapChain() {
+    free();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MipmapChain &MipmapChain::operator =(MipmapChain &&other) {
+    if(this != &other) {
+      free();
+
+      this->levels = std::move(other.levels);
+      this->allocator = other.allocator;
+      this->memory = other.memory;
+      this->allocatedByteCount = other.allocatedByteCount;
+      this->pixelByteCount = other.pixelByteCount;
+
+      other.memory = nullptr;
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MipmapChain::free() {
+    if(this->memory != nullptr) {
+      this->allocator->Free(this->memory, this->allocatedByteCount);
+      this->memory = nullptr;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
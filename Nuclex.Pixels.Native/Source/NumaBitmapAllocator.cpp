@@ -0,0 +1,225 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/NumaBitmapAllocator.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+
+#include <cstdint> // for std::uint8_t
+#include <new> // for std::bad_alloc
+
+#if defined(NUCLEX_PIXELS_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h> // for VirtualAlloc(), VirtualAllocExNuma()
+#else
+#include <sys/mman.h> // for mmap(), munmap()
+#include <sys/syscall.h> // for SYS_mbind
+#include <unistd.h> // for syscall(), sysconf()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory blocks smaller than this are not worth spreading over nodes</summary>
+  /// <remarks>
+  ///   Below this, a bitmap's rows fit into the caches of a single core anyway and
+  ///   mapping fresh pages for each one would cost more than it saves.
+  /// </remarks>
+  const std::size_t MinimumSpreadByteCount = 1024 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the size of a memory page</summary>
+  /// <returns>The size of a memory page in bytes</returns>
+  std::size_t getPageSize() {
+#if defined(NUCLEX_PIXELS_WIN32)
+    ::SYSTEM_INFO systemInfo;
+    ::GetSystemInfo(&systemInfo);
+    return static_cast<std::size_t>(systemInfo.dwPageSize);
+#else
+    long pageSize = ::sysconf(_SC_PAGESIZE);
+    return (pageSize > 0) ? static_cast<std::size_t>(pageSize) : 4096;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reserves address space for a memory block without committing pages</summary>
+  /// <param name="byteCount">Number of bytes the memory block needs to have</param>
+  /// <returns>The address of the memory block</returns>
+  void *reservePages(std::size_t byteCount) {
+#if defined(NUCLEX_PIXELS_WIN32)
+    void *memory = ::VirtualAlloc(nullptr, byteCount, MEM_RESERVE, PAGE_NOACCESS);
+    if(memory == nullptr) {
+      throw std::bad_alloc();
+    }
+    return memory;
+#else
+    // Linux hands out untouched pages lazily, so mapping them is the same as reserving
+    void *memory = ::mmap(
+      nullptr, byteCount, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if(memory == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    return memory;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Releases a memory block obtained via <see cref="reservePages" /></summary>
+  /// <param name="memory">Address of the memory block</param>
+  /// <param name="byteCount">Number of bytes in the memory block</param>
+  void releasePages(void *memory, std::size_t byteCount) {
+#if defined(NUCLEX_PIXELS_WIN32)
+    (void)byteCount;
+    ::VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    ::munmap(memory, byteCount);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Makes part of a reserved memory block usable and prefers a NUMA node</summary>
+  /// <param name="memory">Address at which the part begins, page-aligned</param>
+  /// <param name="byteCount">Number of bytes in the part, a multiple of the page size</param>
+  /// <param name="nodeId">Id of the NUMA node the pages should be placed on</param>
+  /// <param name="bindToNode">Whether the part should be bound to the node</param>
+  /// <remarks>
+  ///   Binding is only a performance hint. If the system refuses it, the pages are
+  ///   placed on the node of the thread that touches them first.
+  /// </remarks>
+  void commitPages(void *memory, std::size_t byteCount, std::size_t nodeId, bool bindToNode) {
+#if defined(NUCLEX_PIXELS_WIN32)
+    void *committed = nullptr;
+    if(bindToNode) {
+      committed = ::VirtualAllocExNuma(
+        ::GetCurrentProcess(), memory, byteCount,
+        MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>(nodeId)
+      );
+    }
+    if(committed == nullptr) {
+      committed = ::VirtualAlloc(memory, byteCount, MEM_COMMIT, PAGE_READWRITE);
+      if(committed == nullptr) {
+        throw std::bad_alloc();
+      }
+    }
+#elif defined(SYS_mbind)
+    // Calls mbind() directly so the library doesn't have to link libnuma
+    if(bindToNode) {
+      const std::size_t bitsPerWord = sizeof(unsigned long) * 8;
+      const std::size_t maskWordCount = 1024 / bitsPerWord;
+      if(nodeId < maskWordCount * bitsPerWord) {
+        unsigned long nodeMask[maskWordCount] = {};
+        nodeMask[nodeId / bitsPerWord] = 1UL << (nodeId % bitsPerWord);
+
+        const int preferredPolicy = 1; // MPOL_PREFERRED
+        ::syscall(
+          SYS_mbind, memory, byteCount, preferredPolicy,
+          nodeMask, maskWordCount * bitsPerWord + 1, 0
+        );
+      }
+    }
+#else
+    (void)memory;
+    (void)byteCount;
+    (void)nodeId;
+    (void)bindToNode;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  NumaBitmapAllocator::NumaBitmapAllocator(
+    const ThreadPool &threadPool, bool bindToNodes /* = true */
+  ) :
+    threadPool(threadPool),
+    bindToNodes(bindToNodes) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void *NumaBitmapAllocator::Allocate(std::size_t byteCount) {
+    if(!IsSpread(byteCount)) {
+      return new std::uint8_t[byteCount];
+    }
+
+    void *memory = reservePages(byteCount);
+
+    // Split the block at page boundaries the same way the thread pool splits batches,
+    // the first share goes to the first node, the second share to the second node...
+    try {
+      std::size_t pageSize = getPageSize();
+      std::size_t pageCount = (byteCount + pageSize - 1) / pageSize;
+      std::size_t nodeCount = this->threadPool.CountNumaNodes();
+      for(std::size_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+        std::size_t startPage = pageCount * nodeIndex / nodeCount;
+        std::size_t endPage = pageCount * (nodeIndex + 1) / nodeCount;
+        if(startPage < endPage) {
+          commitPages(
+            static_cast<std::uint8_t *>(memory) + startPage * pageSize,
+            (endPage - startPage) * pageSize,
+            this->threadPool.getNumaNodeId(nodeIndex),
+            this->bindToNodes
+          );
+        }
+      }
+    }
+    catch(...) {
+      releasePages(memory, byteCount);
+      throw;
+    }
+
+    return memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void NumaBitmapAllocator::Free(void *memory, std::size_t byteCount) throw() {
+    if(IsSpread(byteCount)) {
+      releasePages(memory, byteCount);
+    } else {
+      delete[] static_cast<std::uint8_t *>(memory);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool NumaBitmapAllocator::IsSpread(std::size_t byteCount) const {
+    return (
+      (byteCount >= MinimumSpreadByteCount) &&
+      (this->threadPool.CountNumaNodes() > 1)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
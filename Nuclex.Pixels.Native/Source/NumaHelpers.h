@@ -0,0 +1,93 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+
+#ifndef NUCLEX_PIXELS_NUMAHELPERS_H
+#define NUCLEX_PIXELS_NUMAHELPERS_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include <cstddef> // for std::size_t
+
+// Nuclex.Pixels does not depend on Nuclex.Support. Only builds that define
+// NUCLEX_PIXELS_NUMA (and then have to link Nuclex.Support) look up the NUMA topology
+// through Nuclex.Support. All other builds treat the system as a single NUMA node,
+// so thread pools never pin their threads and bitmaps are allocated normally.
+#if defined(NUCLEX_PIXELS_NUMA)
+  #include <Nuclex/Support/Threading/NumaTopology.h> // for NumaTopology
+#endif
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the NUMA nodes that have CPU cores</summary>
+  /// <returns>The number of NUMA nodes, at least one</returns>
+  inline std::size_t CountNumaNodes() {
+#if defined(NUCLEX_PIXELS_NUMA)
+    return Nuclex::Support::Threading::NumaTopology::Get().CountNodes();
+#else
+    return 1;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the number the operating system uses to identify a NUMA node</summary>
+  /// <param name="nodeIndex">Index of the node in the list of nodes with CPU cores</param>
+  /// <returns>The id of the NUMA node</returns>
+  inline std::size_t GetNumaNodeId(std::size_t nodeIndex) {
+#if defined(NUCLEX_PIXELS_NUMA)
+    return Nuclex::Support::Threading::NumaTopology::Get().Nodes[nodeIndex].Id;
+#else
+    return nodeIndex;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up which NUMA node the calling thread is currently running on</summary>
+  /// <returns>The index of the node in the list of nodes with CPU cores, 0 if unknown</returns>
+  inline std::size_t GetCurrentNumaNodeIndex() {
+#if defined(NUCLEX_PIXELS_NUMA)
+    return Nuclex::Support::Threading::NumaTopology::Get().GetCurrentNodeIndex();
+#else
+    return 0;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Binds the calling thread to the cores of the specified NUMA node</summary>
+  /// <param name="nodeIndex">Index of the node in the list of nodes with CPU cores</param>
+  inline void PinCallingThreadToNumaNode(std::size_t nodeIndex) {
+#if defined(NUCLEX_PIXELS_NUMA)
+    using Nuclex::Support::Threading::NumaTopology;
+    NumaTopology::PinCallingThreadToCores(NumaTopology::Get().Nodes[nodeIndex].Cores);
+#else
+    static_cast<void>(nodeIndex);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_NUMAHELPERS_H
@@ -0,0 +1,1409 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/Half.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "RowStreamHelpers.h"
+#include "DitherPatterns.h"
+
+#include <algorithm> // for std::min()
+#include <cstdint>
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+#if defined(NUCLEX_PIXELS_HAVE_AVX2)
+#include <immintrin.h> // for AVX2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_SSSE3)
+#include <tmmintrin.h> // for SSSE3
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of pixels the generic conversion path processes in one go</summary>
+  const std::size_t GenericChunkSize = 64;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Data types in which the channels of a pixel can be stored</summary>
+  enum class ChannelType {
+
+    /// <summary>Each channel is an unsigned, normalized byte</summary>
+    UnsignedByte,
+    /// <summary>Each channel is a signed, normalized byte</summary>
+    SignedByte,
+    /// <summary>Each channel is an unsigned, normalized 16 bit integer</summary>
+    UnsignedShort,
+    /// <summary>Each channel is a 16 bit floating point value</summary>
+    Half,
+    /// <summary>Each channel is a 32 bit floating point value</summary>
+    Float,
+    /// <summary>Red, green and blue channels are packed into one 16 bit word</summary>
+    Packed565
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes where the channels of a pixel format are stored</summary>
+  struct PixelLayout {
+
+    /// <summary>Data type used to store each channel</summary>
+    public: ChannelType Type;
+    /// <summary>Number of bytes a single pixel occupies</summary>
+    public: std::size_t BytesPerPixel;
+    /// <summary>Whether channel words use the opposite of the platform's byte order</summary>
+    public: bool FlipWords;
+    /// <summary>Position of the red, green, blue and alpha channels</summary>
+    /// <remarks>
+    ///   For byte and word formats, this is the index of the channel inside the pixel,
+    ///   in units of the channel size. For packed formats, it is the number of bits
+    ///   the channel is shifted to the left inside the packed word. Channels that
+    ///   are not present in a pixel format are set to -1.
+    /// </remarks>
+    public: int Channels[4];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Signature of a function performing conversion of a row of pixels</summary>
+  /// <param name="source">Layout of the pixels that are being converted</param>
+  /// <param name="target">Layout the pixels are being converted into</param>
+  /// <param name="sourcePixels">Address of the first source pixel</param>
+  /// <param name="targetPixels">Address at which the first target pixel will be written</param>
+  /// <param name="pixelCount">Number of pixels that will be converted</param>
+  typedef void ConvertRowFunction(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Assigns the positions of the red, green, blue and alpha channels</summary>
+  /// <param name="layout">Layout whose channel positions will be assigned</param>
+  /// <param name="red">Position of the red channel</param>
+  /// <param name="green">Position of the green channel</param>
+  /// <param name="blue">Position of the blue channel</param>
+  /// <param name="alpha">Position of the alpha channel</param>
+  void setChannels(PixelLayout &layout, int red, int green, int blue, int alpha) {
+    layout.Channels[0] = red;
+    layout.Channels[1] = green;
+    layout.Channels[2] = blue;
+    layout.Channels[3] = alpha;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the channel layout of a pixel format</summary>
+  /// <param name="pixelFormat">Pixel format whose layout will be determined</param>
+  /// <param name="layout">Receives the layout of the pixel format</param>
+  /// <returns>True if the layout was determined, false if the format is unsupported</returns>
+  /// <remarks>
+  ///   The lower 16 bits of a pixel format identify its channel order and data type
+  ///   (see the PixelFormat enumeration). The lowest 3 bits hold the data type variant
+  ///   where bit 2 indicates little endian words. For the 8 bit RGBA formats, this bit
+  ///   is used to express the byte-reversed format.
+  /// </remarks>
+  bool describePixelFormat(Nuclex::Pixels::PixelFormat pixelFormat, PixelLayout &layout) {
+    std::size_t format = static_cast<std::size_t>(pixelFormat);
+    std::size_t id = format & 0xFFF8;
+    std::size_t variant = format & 7;
+
+    layout.BytesPerPixel = Nuclex::Pixels::CountBytesPerBlock(pixelFormat);
+#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+    layout.FlipWords = ((variant & 4) == 0);
+#else
+    layout.FlipWords = ((variant & 4) != 0);
+#endif
+
+    switch(id) {
+      case 0: { // R8
+        layout.Type = ChannelType::UnsignedByte;
+        setChannels(layout, 0, -1, -1, -1);
+        return (variant == 0);
+      }
+      case 8: { // R16
+        layout.Type = ((variant & 3) == 3) ? ChannelType::Half : ChannelType::UnsignedShort;
+        setChannels(layout, 0, -1, -1, -1);
+        return ((variant & 3) == 0) || ((variant & 3) == 3);
+      }
+      case 16: { // R32
+        layout.Type = ChannelType::Float;
+        setChannels(layout, 0, -1, -1, -1);
+        return ((variant & 3) == 3);
+      }
+      case 1024: { // R8-G8
+        layout.Type = ChannelType::UnsignedByte;
+        setChannels(layout, 0, 1, -1, -1);
+        return (variant == 0);
+      }
+      case 1032: { // R16-G16
+        layout.Type = ((variant & 3) == 3) ? ChannelType::Half : ChannelType::UnsignedShort;
+        setChannels(layout, 0, 1, -1, -1);
+        return ((variant & 3) == 0) || ((variant & 3) == 3);
+      }
+      case 2048: { // R5-G6-B5
+        layout.Type = ChannelType::Packed565;
+        setChannels(layout, 11, 5, 0, -1);
+        return ((variant & 3) == 0);
+      }
+      case 2056: { // B5-G6-R5
+        layout.Type = ChannelType::Packed565;
+        setChannels(layout, 0, 5, 11, -1);
+        return ((variant & 3) == 0);
+      }
+      case 3072: { // R8-G8-B8
+        layout.Type = (variant == 1) ? ChannelType::SignedByte : ChannelType::UnsignedByte;
+        setChannels(layout, 0, 1, 2, -1);
+        return (variant < 2);
+      }
+      case 3080: { // B8-G8-R8
+        layout.Type = (variant == 1) ? ChannelType::SignedByte : ChannelType::UnsignedByte;
+        setChannels(layout, 2, 1, 0, -1);
+        return (variant < 2);
+      }
+      case 4096: { // A8-B8-G8-R8 and the byte-reversed R8-G8-B8-A8
+        layout.Type = ((variant & 1) != 0) ? ChannelType::SignedByte : ChannelType::UnsignedByte;
+        if((variant & 4) == 0) {
+          setChannels(layout, 3, 2, 1, 0);
+        } else {
+          setChannels(layout, 0, 1, 2, 3);
+        }
+        return ((variant & 3) < 2);
+      }
+      case 5120: // B8-G8-R8-A8 and the byte-reversed A8-R8-G8-B8
+      case 5128: { // Signed variants of the above
+        bool isSigned = (id == 5128);
+        layout.Type = isSigned ? ChannelType::SignedByte : ChannelType::UnsignedByte;
+        if((variant & 4) == 0) {
+          setChannels(layout, 2, 1, 0, 3);
+        } else {
+          setChannels(layout, 1, 2, 3, 0);
+        }
+        return ((variant & 3) == (isSigned ? 1U : 0U));
+      }
+      case 4104: { // A16-B16-G16-R16
+        layout.Type = ChannelType::Half;
+        setChannels(layout, 3, 2, 1, 0);
+        return ((variant & 3) == 3);
+      }
+      case 4112: { // R16-G16-B16-A16
+        layout.Type = ChannelType::Half;
+        setChannels(layout, 0, 1, 2, 3);
+        return ((variant & 3) == 3);
+      }
+      case 8192: { // B16-G16-R16-A16
+        layout.Type = ChannelType::Half;
+        setChannels(layout, 2, 1, 0, 3);
+        return ((variant & 3) == 3);
+      }
+      case 8200: { // A16-R16-G16-B16
+        layout.Type = ChannelType::Half;
+        setChannels(layout, 1, 2, 3, 0);
+        return ((variant & 3) == 3);
+      }
+      case 4120: { // A32-B32-G32-R32
+        layout.Type = ChannelType::Float;
+        setChannels(layout, 3, 2, 1, 0);
+        return ((variant & 3) == 3);
+      }
+      case 4128: { // R32-G32-B32-A32
+        layout.Type = ChannelType::Float;
+        setChannels(layout, 0, 1, 2, 3);
+        return ((variant & 3) == 3);
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the bytes in a 16 bit word</summary>
+  /// <param name="word">Word whose bytes will be reversed</param>
+  /// <returns>The word with its bytes in reverse order</returns>
+  inline std::uint16_t flipBytes(std::uint16_t word) {
+    return static_cast<std::uint16_t>((word << 8) | (word >> 8));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the bytes in a 32 bit word</summary>
+  /// <param name="word">Word whose bytes will be reversed</param>
+  /// <returns>The word with its bytes in reverse order</returns>
+  inline std::uint32_t flipBytes(std::uint32_t word) {
+    return (
+      (word << 24) |
+      ((word & 0x0000FF00) << 8) |
+      ((word & 0x00FF0000) >> 8) |
+      (word >> 24)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 16 bit word that may be stored in non-native byte order</summary>
+  /// <param name="address">Address the word will be read from</param>
+  /// <param name="flip">Whether the byte order of the word should be flipped</param>
+  /// <returns>The word in native byte order</returns>
+  inline std::uint16_t readWord(const std::uint8_t *address, bool flip) {
+    std::uint16_t word;
+    std::memcpy(&word, address, sizeof(word));
+    return flip ? flipBytes(word) : word;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 16 bit word that may be stored in non-native byte order</summary>
+  /// <param name="address">Address the word will be written to</param>
+  /// <param name="word">Word in native byte order that will be written</param>
+  /// <param name="flip">Whether the byte order of the word should be flipped</param>
+  inline void writeWord(std::uint8_t *address, std::uint16_t word, bool flip) {
+    if(flip) {
+      word = flipBytes(word);
+    }
+    std::memcpy(address, &word, sizeof(word));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Clamps a floating point value into the range of 0.0 to 1.0</summary>
+  /// <param name="value">Value that will be clamped</param>
+  /// <returns>The clamped value, NaNs are turned into 0.0</returns>
+  inline float saturate(float value) {
+    return (value > 0.0f) ? ((value < 1.0f) ? value : 1.0f) : 0.0f;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns a normalized floating point value into an unsigned integer</summary>
+  /// <param name="value">Floating point value that will be converted</param>
+  /// <param name="maximum">Maximum integer value, equivalent to 1.0</param>
+  /// <returns>The integer value nearest to the normalized floating point value</returns>
+  inline std::uint32_t quantizeUnsigned(float value, float maximum) {
+    return static_cast<std::uint32_t>(saturate(value) * maximum + 0.5f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns a signed normalized floating point value into a signed byte</summary>
+  /// <param name="value">Floating point value that will be converted</param>
+  /// <returns>The signed byte nearest to the normalized floating point value</returns>
+  inline std::uint8_t quantizeSigned(float value) {
+    if(!(value > -1.0f)) { // also catches NaNs
+      value = -1.0f;
+    } else if(value > 1.0f) {
+      value = 1.0f;
+    }
+
+    int integer = static_cast<int>(value * 127.0f + ((value < 0.0f) ? -0.5f : 0.5f));
+    return static_cast<std::uint8_t>(static_cast<std::int8_t>(integer));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reduces an 8 bit channel to 5 bits, rounding to the nearest value</summary>
+  /// <param name="value">8 bit channel value that will be reduced</param>
+  /// <returns>The nearest equivalent 5 bit channel value</returns>
+  /// <remarks>
+  ///   Equivalent to (value * 31 + 127) / 255 for all inputs, replacing the division
+  ///   by a shift-and-add sequence that can also be done in SIMD registers.
+  /// </remarks>
+  inline std::uint32_t quantizeTo5Bits(std::uint32_t value) {
+    value = value * 31 + 128;
+    return (value + (value >> 8)) >> 8;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reduces an 8 bit channel to 6 bits, rounding to the nearest value</summary>
+  /// <param name="value">8 bit channel value that will be reduced</param>
+  /// <returns>The nearest equivalent 6 bit channel value</returns>
+  inline std::uint32_t quantizeTo6Bits(std::uint32_t value) {
+    value = value * 63 + 128;
+    return (value + (value >> 8)) >> 8;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Expands a 5 bit channel to 8 bits, rounding to the nearest value</summary>
+  /// <param name="value">5 bit channel value that will be expanded</param>
+  /// <returns>The nearest equivalent 8 bit channel value</returns>
+  /// <remarks>
+  ///   Equivalent to (value * 255 + 15) / 31. Bit replication, which is often used
+  ///   instead, is off by one for some inputs.
+  /// </remarks>
+  inline std::uint32_t expandFrom5Bits(std::uint32_t value) {
+    return (value * 527 + 23) >> 6;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Expands a 6 bit channel to 8 bits, rounding to the nearest value</summary>
+  /// <param name="value">6 bit channel value that will be expanded</param>
+  /// <returns>The nearest equivalent 8 bit channel value</returns>
+  inline std::uint32_t expandFrom6Bits(std::uint32_t value) {
+    return (value * 259 + 33) >> 6;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies pixels between identical pixel formats</summary>
+  void copyPixels(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  ) {
+    (void)target;
+    std::memcpy(targetPixels, sourcePixels, source.BytesPerPixel * pixelCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reorders the bytes of pixel formats using four 8 bit channels</summary>
+  void shuffleBytes(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  ) {
+
+    // For each target byte, figure out which source byte it will be taken from
+    std::uint8_t permutation[4];
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      permutation[target.Channels[channel]] = static_cast<std::uint8_t>(source.Channels[channel]);
+    }
+
+#if defined(NUCLEX_PIXELS_HAVE_AVX2)
+    if(pixelCount >= 8) {
+      std::uint8_t mask[32];
+      for(std::size_t index = 0; index < 32; ++index) {
+        mask[index] = static_cast<std::uint8_t>((index & 12) + permutation[index & 3]);
+      }
+      __m256i shuffleMask = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask));
+      while(pixelCount >= 8) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sourcePixels));
+        pixels = _mm256_shuffle_epi8(pixels, shuffleMask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(targetPixels), pixels);
+        sourcePixels += 32;
+        targetPixels += 32;
+        pixelCount -= 8;
+      }
+    }
+#endif
+#if defined(NUCLEX_PIXELS_HAVE_SSSE3)
+    if(pixelCount >= 4) {
+      std::uint8_t mask[16];
+      for(std::size_t index = 0; index < 16; ++index) {
+        mask[index] = static_cast<std::uint8_t>((index & 12) + permutation[index & 3]);
+      }
+      __m128i shuffleMask = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask));
+      while(pixelCount >= 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourcePixels));
+        pixels = _mm_shuffle_epi8(pixels, shuffleMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(targetPixels), pixels);
+        sourcePixels += 16;
+        targetPixels += 16;
+        pixelCount -= 4;
+      }
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_SSE2)
+    if(pixelCount >= 4) {
+      const __m128i byteMask = _mm_set1_epi32(0xFF);
+      __m128i rightShifts[4], leftShifts[4];
+      for(std::size_t index = 0; index < 4; ++index) {
+        rightShifts[index] = _mm_cvtsi32_si128(static_cast<int>(permutation[index]) * 8);
+        leftShifts[index] = _mm_cvtsi32_si128(static_cast<int>(index) * 8);
+      }
+      while(pixelCount >= 4) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourcePixels));
+        __m128i result = _mm_setzero_si128();
+        for(std::size_t index = 0; index < 4; ++index) {
+          __m128i channel = _mm_and_si128(_mm_srl_epi32(pixels, rightShifts[index]), byteMask);
+          result = _mm_or_si128(result, _mm_sll_epi32(channel, leftShifts[index]));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(targetPixels), result);
+        sourcePixels += 16;
+        targetPixels += 16;
+        pixelCount -= 4;
+      }
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    while(pixelCount >= 16) {
+      uint8x16x4_t pixels = vld4q_u8(sourcePixels);
+      uint8x16x4_t result;
+      result.val[0] = pixels.val[permutation[0]];
+      result.val[1] = pixels.val[permutation[1]];
+      result.val[2] = pixels.val[permutation[2]];
+      result.val[3] = pixels.val[permutation[3]];
+      vst4q_u8(targetPixels, result);
+      sourcePixels += 64;
+      targetPixels += 64;
+      pixelCount -= 16;
+    }
+#endif
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    while(pixelCount > 0) {
+      targetPixels[0] = sourcePixels[permutation[0]];
+      targetPixels[1] = sourcePixels[permutation[1]];
+      targetPixels[2] = sourcePixels[permutation[2]];
+      targetPixels[3] = sourcePixels[permutation[3]];
+      sourcePixels += 4;
+      targetPixels += 4;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Moves 8 bit channels between pixel formats of different sizes</summary>
+  void remapBytes(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  ) {
+    std::uint8_t opaque = (target.Type == ChannelType::SignedByte) ? 127 : 255;
+
+    // Collect the channels that need to be written into the target pixels. Channels
+    // missing in the source are set to zero, except for alpha which becomes opaque.
+    std::size_t channelCount = 0;
+    int sourceOffsets[4], targetOffsets[4];
+    std::uint8_t fillValues[4];
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      if(target.Channels[channel] >= 0) {
+        sourceOffsets[channelCount] = source.Channels[channel];
+        targetOffsets[channelCount] = target.Channels[channel];
+        fillValues[channelCount] = (channel == 3) ? opaque : 0;
+        ++channelCount;
+      }
+    }
+
+    while(pixelCount > 0) {
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        if(sourceOffsets[index] >= 0) {
+          targetPixels[targetOffsets[index]] = sourcePixels[sourceOffsets[index]];
+        } else {
+          targetPixels[targetOffsets[index]] = fillValues[index];
+        }
+      }
+      sourcePixels += source.BytesPerPixel;
+      targetPixels += target.BytesPerPixel;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packs pixels with 8 bit channels into R5-G6-B5 or B5-G6-R5</summary>
+  void packBytesTo565(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    if(source.BytesPerPixel == 4) {
+      const __m128i byteMask = _mm_set1_epi32(0xFF);
+      const __m128i lowByteMask = _mm_set1_epi32(0x00FF);
+      const __m128i roundingBias = _mm_set1_epi32(128);
+      const __m128i factor5 = _mm_set1_epi32(31);
+      const __m128i factor6 = _mm_set1_epi32(63);
+      const __m128i redRight = _mm_cvtsi32_si128(source.Channels[0] * 8);
+      const __m128i greenRight = _mm_cvtsi32_si128(source.Channels[1] * 8);
+      const __m128i blueRight = _mm_cvtsi32_si128(source.Channels[2] * 8);
+      const __m128i redLeft = _mm_cvtsi32_si128(target.Channels[0]);
+      const __m128i greenLeft = _mm_cvtsi32_si128(target.Channels[1]);
+      const __m128i blueLeft = _mm_cvtsi32_si128(target.Channels[2]);
+
+      __m128i packed[2];
+      while(pixelCount >= 8) {
+        for(std::size_t half = 0; half < 2; ++half) {
+          __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourcePixels));
+
+          // Extract the channels into the 32 bit lanes and quantize them. The upper
+          // 16 bits of each lane are zero, so 16 bit multiplications are sufficient.
+          __m128i red = _mm_and_si128(_mm_srl_epi32(pixels, redRight), byteMask);
+          __m128i green = _mm_and_si128(_mm_srl_epi32(pixels, greenRight), byteMask);
+          __m128i blue = _mm_and_si128(_mm_srl_epi32(pixels, blueRight), byteMask);
+          red = _mm_add_epi32(_mm_mullo_epi16(red, factor5), roundingBias);
+          green = _mm_add_epi32(_mm_mullo_epi16(green, factor6), roundingBias);
+          blue = _mm_add_epi32(_mm_mullo_epi16(blue, factor5), roundingBias);
+          red = _mm_srli_epi32(_mm_add_epi32(red, _mm_srli_epi32(red, 8)), 8);
+          green = _mm_srli_epi32(_mm_add_epi32(green, _mm_srli_epi32(green, 8)), 8);
+          blue = _mm_srli_epi32(_mm_add_epi32(blue, _mm_srli_epi32(blue, 8)), 8);
+
+          __m128i word = _mm_or_si128(
+            _mm_or_si128(_mm_sll_epi32(red, redLeft), _mm_sll_epi32(green, greenLeft)),
+            _mm_sll_epi32(blue, blueLeft)
+          );
+          if(target.FlipWords) {
+            word = _mm_or_si128(
+              _mm_slli_epi32(_mm_and_si128(word, lowByteMask), 8), _mm_srli_epi32(word, 8)
+            );
+          }
+
+          // Sign-extend so the saturating pack from 32 to 16 bits leaves the words intact
+          packed[half] = _mm_srai_epi32(_mm_slli_epi32(word, 16), 16);
+          sourcePixels += 16;
+        }
+
+        _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(targetPixels), _mm_packs_epi32(packed[0], packed[1])
+        );
+        targetPixels += 16;
+        pixelCount -= 8;
+      }
+    }
+#endif
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    while(pixelCount > 0) {
+      std::uint32_t red = quantizeTo5Bits(sourcePixels[source.Channels[0]]);
+      std::uint32_t green = quantizeTo6Bits(sourcePixels[source.Channels[1]]);
+      std::uint32_t blue = quantizeTo5Bits(sourcePixels[source.Channels[2]]);
+      std::uint16_t word = static_cast<std::uint16_t>(
+        (red << target.Channels[0]) | (green << target.Channels[1]) | (blue << target.Channels[2])
+      );
+      writeWord(targetPixels, word, target.FlipWords);
+
+      sourcePixels += source.BytesPerPixel;
+      targetPixels += 2;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unpacks R5-G6-B5 or B5-G6-R5 pixels into 8 bit channels</summary>
+  void unpack565ToBytes(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    if((target.BytesPerPixel == 4) && (target.Channels[3] >= 0)) {
+      const __m128i mask5 = _mm_set1_epi32(31);
+      const __m128i mask6 = _mm_set1_epi32(63);
+      const __m128i factor5 = _mm_set1_epi32(527);
+      const __m128i factor6 = _mm_set1_epi32(259);
+      const __m128i bias5 = _mm_set1_epi32(23);
+      const __m128i bias6 = _mm_set1_epi32(33);
+      const __m128i redRight = _mm_cvtsi32_si128(source.Channels[0]);
+      const __m128i greenRight = _mm_cvtsi32_si128(source.Channels[1]);
+      const __m128i blueRight = _mm_cvtsi32_si128(source.Channels[2]);
+      const __m128i redLeft = _mm_cvtsi32_si128(target.Channels[0] * 8);
+      const __m128i greenLeft = _mm_cvtsi32_si128(target.Channels[1] * 8);
+      const __m128i blueLeft = _mm_cvtsi32_si128(target.Channels[2] * 8);
+      const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFFU << (target.Channels[3] * 8)));
+      const __m128i zero = _mm_setzero_si128();
+
+      while(pixelCount >= 8) {
+        __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourcePixels));
+        if(source.FlipWords) {
+          words = _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8));
+        }
+
+        __m128i halves[2] = { _mm_unpacklo_epi16(words, zero), _mm_unpackhi_epi16(words, zero) };
+        for(std::size_t half = 0; half < 2; ++half) {
+          __m128i red = _mm_and_si128(_mm_srl_epi32(halves[half], redRight), mask5);
+          __m128i green = _mm_and_si128(_mm_srl_epi32(halves[half], greenRight), mask6);
+          __m128i blue = _mm_and_si128(_mm_srl_epi32(halves[half], blueRight), mask5);
+          red = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(red, factor5), bias5), 6);
+          green = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(green, factor6), bias6), 6);
+          blue = _mm_srli_epi32(_mm_add_epi32(_mm_mullo_epi16(blue, factor5), bias5), 6);
+
+          __m128i pixels = _mm_or_si128(
+            _mm_or_si128(_mm_sll_epi32(red, redLeft), _mm_sll_epi32(green, greenLeft)),
+            _mm_or_si128(_mm_sll_epi32(blue, blueLeft), alpha)
+          );
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(targetPixels), pixels);
+          targetPixels += 16;
+        }
+
+        sourcePixels += 16;
+        pixelCount -= 8;
+      }
+    }
+#endif
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    while(pixelCount > 0) {
+      std::uint32_t word = readWord(sourcePixels, source.FlipWords);
+      targetPixels[target.Channels[0]] = static_cast<std::uint8_t>(
+        expandFrom5Bits((word >> source.Channels[0]) & 31)
+      );
+      targetPixels[target.Channels[1]] = static_cast<std::uint8_t>(
+        expandFrom6Bits((word >> source.Channels[1]) & 63)
+      );
+      targetPixels[target.Channels[2]] = static_cast<std::uint8_t>(
+        expandFrom5Bits((word >> source.Channels[2]) & 31)
+      );
+      if(target.Channels[3] >= 0) {
+        targetPixels[target.Channels[3]] = 255;
+      }
+
+      sourcePixels += 2;
+      targetPixels += target.BytesPerPixel;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a layout stores RGBA halfs in the platform's byte order</summary>
+  /// <param name="layout">Layout that will be checked</param>
+  /// <returns>True if the layout's pixels can be treated as an array of halfs</returns>
+  bool isNativeRgbaHalfLayout(const PixelLayout &layout) {
+    return (
+      (layout.Type == ChannelType::Half) && (!layout.FlipWords) &&
+      (layout.BytesPerPixel == 8) &&
+      (layout.Channels[0] == 0) && (layout.Channels[1] == 1) &&
+      (layout.Channels[2] == 2) && (layout.Channels[3] == 3)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Expands pixels with unsigned 8 bit channels into half-precision floats</summary>
+  /// <remarks>
+  ///   Uses the byte-to-half lookup table, which gives exactly the same results as
+  ///   going through floats, but without any floating point math.
+  /// </remarks>
+  void expandBytesToHalfs(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  ) {
+    bool isSameOrder = (
+      (source.BytesPerPixel == 4) && isNativeRgbaHalfLayout(target) &&
+      (source.Channels[0] == 0) && (source.Channels[1] == 1) &&
+      (source.Channels[2] == 2) && (source.Channels[3] == 3)
+    );
+    if(isSameOrder) {
+      Nuclex::Pixels::Half::ConvertFromNormalizedBytes(
+        sourcePixels, reinterpret_cast<Nuclex::Pixels::Half *>(targetPixels), pixelCount * 4
+      );
+      return;
+    }
+
+    // Collect the channels that need to be written into the target pixels. Channels
+    // missing in the source are set to zero, except for alpha which becomes opaque.
+    std::size_t channelCount = 0;
+    int sourceOffsets[4], targetOffsets[4];
+    std::uint16_t fillValues[4];
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      if(target.Channels[channel] >= 0) {
+        sourceOffsets[channelCount] = source.Channels[channel];
+        targetOffsets[channelCount] = target.Channels[channel] * 2;
+        fillValues[channelCount] = (
+          (channel == 3) ? Nuclex::Pixels::Half::One.GetBits() : 0
+        );
+        ++channelCount;
+      }
+    }
+
+    while(pixelCount > 0) {
+      for(std::size_t index = 0; index < channelCount; ++index) {
+        std::uint16_t word;
+        if(sourceOffsets[index] >= 0) {
+          word = Nuclex::Pixels::Half::FromNormalizedByte(
+            sourcePixels[sourceOffsets[index]]
+          ).GetBits();
+        } else {
+          word = fillValues[index];
+        }
+        writeWord(targetPixels + targetOffsets[index], word, target.FlipWords);
+      }
+      sourcePixels += source.BytesPerPixel;
+      targetPixels += target.BytesPerPixel;
+      --pixelCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes pixels into normalized floating point RGBA values</summary>
+  /// <param name="layout">Layout of the pixels that will be decoded</param>
+  /// <param name="pixels">Address of the first pixel that will be decoded</param>
+  /// <param name="rgba">Receives 4 floating point values for each decoded pixel</param>
+  /// <param name="pixelCount">Number of pixels that will be decoded</param>
+  void decodeToFloats(
+    const PixelLayout &layout, const std::uint8_t *pixels, float *rgba, std::size_t pixelCount
+  ) {
+    static const float defaults[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    // RGBA halfs are already in the right order and can be converted in bulk
+    if(isNativeRgbaHalfLayout(layout)) {
+      Nuclex::Pixels::Half::ConvertToFloats(
+        reinterpret_cast<const Nuclex::Pixels::Half *>(pixels), rgba, pixelCount * 4
+      );
+      return;
+    }
+
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      if(layout.Type == ChannelType::Packed565) {
+        std::uint32_t word = readWord(pixels, layout.FlipWords);
+        rgba[0] = static_cast<float>((word >> layout.Channels[0]) & 31) / 31.0f;
+        rgba[1] = static_cast<float>((word >> layout.Channels[1]) & 63) / 63.0f;
+        rgba[2] = static_cast<float>((word >> layout.Channels[2]) & 31) / 31.0f;
+        rgba[3] = 1.0f;
+      } else {
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          int position = layout.Channels[channel];
+          if(position < 0) {
+            rgba[channel] = defaults[channel];
+            continue;
+          }
+
+          switch(layout.Type) {
+            case ChannelType::UnsignedByte: {
+              rgba[channel] = static_cast<float>(pixels[position]) / 255.0f;
+              break;
+            }
+            case ChannelType::SignedByte: {
+              float value = static_cast<float>(static_cast<std::int8_t>(pixels[position]));
+              rgba[channel] = (value < -127.0f) ? -1.0f : (value / 127.0f);
+              break;
+            }
+            case ChannelType::UnsignedShort: {
+              std::uint16_t word = readWord(pixels + position * 2, layout.FlipWords);
+              rgba[channel] = static_cast<float>(word) / 65535.0f;
+              break;
+            }
+            case ChannelType::Half: {
+              std::uint16_t word = readWord(pixels + position * 2, layout.FlipWords);
+              rgba[channel] = Nuclex::Pixels::Half::FloatFromBits(word);
+              break;
+            }
+            case ChannelType::Float: {
+              std::uint32_t bits;
+              std::memcpy(&bits, pixels + position * 4, sizeof(bits));
+              if(layout.FlipWords) {
+                bits = flipBytes(bits);
+              }
+              std::memcpy(&rgba[channel], &bits, sizeof(bits));
+              break;
+            }
+            default: { // Packed channel types are handled outside of the switch
+              break;
+            }
+          }
+        }
+      }
+
+      pixels += layout.BytesPerPixel;
+      rgba += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes normalized floating point RGBA values into pixels</summary>
+  /// <param name="layout">Layout of the pixels that will be encoded</param>
+  /// <param name="rgba">Four floating point values for each pixel that will be encoded</param>
+  /// <param name="pixels">Address at which the first pixel will be stored</param>
+  /// <param name="pixelCount">Number of pixels that will be encoded</param>
+  void encodeFromFloats(
+    const PixelLayout &layout, const float *rgba, std::uint8_t *pixels, std::size_t pixelCount
+  ) {
+
+    // RGBA halfs are stored in the same order as the floats and can be converted in bulk
+    if(isNativeRgbaHalfLayout(layout)) {
+      Nuclex::Pixels::Half::ConvertFromFloats(
+        rgba, reinterpret_cast<Nuclex::Pixels::Half *>(pixels), pixelCount * 4
+      );
+      return;
+    }
+
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      if(layout.Type == ChannelType::Packed565) {
+        std::uint16_t word = static_cast<std::uint16_t>(
+          (quantizeUnsigned(rgba[0], 31.0f) << layout.Channels[0]) |
+          (quantizeUnsigned(rgba[1], 63.0f) << layout.Channels[1]) |
+          (quantizeUnsigned(rgba[2], 31.0f) << layout.Channels[2])
+        );
+        writeWord(pixels, word, layout.FlipWords);
+      } else {
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          int position = layout.Channels[channel];
+          if(position < 0) {
+            continue;
+          }
+
+          switch(layout.Type) {
+            case ChannelType::UnsignedByte: {
+              pixels[position] = static_cast<std::uint8_t>(
+                quantizeUnsigned(rgba[channel], 255.0f)
+              );
+              break;
+            }
+            case ChannelType::SignedByte: {
+              pixels[position] = quantizeSigned(rgba[channel]);
+              break;
+            }
+            case ChannelType::UnsignedShort: {
+              std::uint16_t word = static_cast<std::uint16_t>(
+                quantizeUnsigned(rgba[channel], 65535.0f)
+              );
+              writeWord(pixels + position * 2, word, layout.FlipWords);
+              break;
+            }
+            case ChannelType::Half: {
+              std::uint16_t word = Nuclex::Pixels::Half::BitsFromFloat(rgba[channel]);
+              writeWord(pixels + position * 2, word, layout.FlipWords);
+              break;
+            }
+            case ChannelType::Float: {
+              std::uint32_t bits;
+              std::memcpy(&bits, &rgba[channel], sizeof(bits));
+              if(layout.FlipWords) {
+                bits = flipBytes(bits);
+              }
+              std::memcpy(pixels + position * 4, &bits, sizeof(bits));
+              break;
+            }
+            default: { // Packed channel types are handled outside of the switch
+              break;
+            }
+          }
+        }
+      }
+
+      rgba += 4;
+      pixels += layout.BytesPerPixel;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts pixels between any two formats by going through floats</summary>
+  void convertViaFloats(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount
+  ) {
+    float rgba[GenericChunkSize * 4];
+
+    while(pixelCount > 0) {
+      std::size_t chunkSize = (pixelCount < GenericChunkSize) ? pixelCount : GenericChunkSize;
+
+      decodeToFloats(source, sourcePixels, rgba, chunkSize);
+      encodeFromFloats(target, rgba, targetPixels, chunkSize);
+
+      sourcePixels += source.BytesPerPixel * chunkSize;
+      targetPixels += target.BytesPerPixel * chunkSize;
+      pixelCount -= chunkSize;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the number of bits the color channels of a layout can resolve</summary>
+  /// <param name="layout">Layout whose precision will be determined</param>
+  /// <returns>The number of bits in the least precise color channel</returns>
+  /// <remarks>
+  ///   Floating point formats count the bits of their mantissa, which is the precision
+  ///   they have for colors near 1.0.
+  /// </remarks>
+  std::size_t getColorPrecision(const PixelLayout &layout) {
+    switch(layout.Type) {
+      case ChannelType::Packed565: { return 5; }
+      case ChannelType::UnsignedByte: { return 8; }
+      case ChannelType::SignedByte: { return 7; }
+      case ChannelType::Half: { return 11; }
+      case ChannelType::UnsignedShort: { return 16; }
+      default: { return 24; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether dithering would change the result of a conversion</summary>
+  /// <param name="source">Layout of the pixels being converted</param>
+  /// <param name="target">Layout the pixels will be converted to</param>
+  /// <returns>
+  ///   True if the target stores colors as unsigned integers with less precision than
+  ///   the source has
+  /// </returns>
+  bool canDither(const PixelLayout &source, const PixelLayout &target) {
+    bool isTargetUnsigned = (
+      (target.Type == ChannelType::UnsignedByte) ||
+      (target.Type == ChannelType::UnsignedShort) ||
+      (target.Type == ChannelType::Packed565)
+    );
+    return isTargetUnsigned && (getColorPrecision(target) < getColorPrecision(source));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the normalized size of one quantization step for each channel</summary>
+  /// <param name="layout">Layout whose quantization steps will be determined</param>
+  /// <param name="steps">Receives the quantization step of each channel</param>
+  /// <remarks>
+  ///   The alpha channel's step is always zero, so it will not be dithered.
+  /// </remarks>
+  void getQuantizationSteps(const PixelLayout &layout, float (&steps)[4]) {
+    if(layout.Type == ChannelType::Packed565) {
+      steps[0] = 1.0f / 31.0f;
+      steps[1] = 1.0f / 63.0f;
+      steps[2] = 1.0f / 31.0f;
+    } else {
+      float step = (layout.Type == ChannelType::UnsignedShort) ? (1.0f / 65535.0f) : (
+        1.0f / 255.0f
+      );
+      steps[0] = steps[1] = steps[2] = step;
+    }
+    steps[3] = 0.0f;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Offsets floating point RGBA values by a row of dithering thresholds</summary>
+  /// <param name="rgba">Four floating point values for each pixel that will be offset</param>
+  /// <param name="pixelCount">Number of pixels that will be offset</param>
+  /// <param name="steps">Normalized quantization step of each channel</param>
+  /// <param name="thresholds">Dithering thresholds for the row the pixels are in</param>
+  /// <param name="thresholdMask">Mask that wraps pixel indices into the thresholds row</param>
+  /// <param name="x">X coordinate of the first pixel in the bitmap</param>
+  /// <remarks>
+  ///   Each channel is moved by up to half a quantization step, so that rounding it
+  ///   afterwards has the same effect as adding the threshold and truncating.
+  /// </remarks>
+  void offsetByThresholds(
+    float *rgba, std::size_t pixelCount, const float (&steps)[4],
+    const float *thresholds, std::size_t thresholdMask, std::size_t x
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+    {
+      const __m128 stepVector = _mm_loadu_ps(steps);
+      for(std::size_t index = 0; index < pixelCount; ++index) {
+        __m128 offset = _mm_set1_ps(thresholds[(x + index) & thresholdMask] - 0.5f);
+        _mm_storeu_ps(rgba, _mm_add_ps(_mm_loadu_ps(rgba), _mm_mul_ps(offset, stepVector)));
+        rgba += 4;
+      }
+      pixelCount = 0;
+    }
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+    {
+      const float32x4_t stepVector = vld1q_f32(steps);
+      for(std::size_t index = 0; index < pixelCount; ++index) {
+        float offset = thresholds[(x + index) & thresholdMask] - 0.5f;
+        vst1q_f32(rgba, vaddq_f32(vld1q_f32(rgba), vmulq_n_f32(stepVector, offset)));
+        rgba += 4;
+      }
+      pixelCount = 0;
+    }
+#endif
+
+    // Scalar loop if no SIMD instructions are available
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      float offset = thresholds[(x + index) & thresholdMask] - 0.5f;
+      rgba[0] += offset * steps[0];
+      rgba[1] += offset * steps[1];
+      rgba[2] += offset * steps[2];
+      rgba += 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a row of pixels through floats, dithering them on the way</summary>
+  /// <param name="source">Layout of the pixels that are being converted</param>
+  /// <param name="target">Layout the pixels are being converted into</param>
+  /// <param name="sourcePixels">Address of the first source pixel</param>
+  /// <param name="targetPixels">Address at which the first target pixel will be written</param>
+  /// <param name="pixelCount">Number of pixels that will be converted</param>
+  /// <param name="thresholds">Dithering thresholds for the row being converted</param>
+  /// <param name="thresholdMask">Mask that wraps pixel indices into the thresholds row</param>
+  void convertWithDithering(
+    const PixelLayout &source, const PixelLayout &target,
+    const std::uint8_t *sourcePixels, std::uint8_t *targetPixels,
+    std::size_t pixelCount, const float *thresholds, std::size_t thresholdMask
+  ) {
+    float steps[4];
+    getQuantizationSteps(target, steps);
+
+    float rgba[GenericChunkSize * 4];
+
+    std::size_t x = 0;
+    while(pixelCount > 0) {
+      std::size_t chunkSize = (pixelCount < GenericChunkSize) ? pixelCount : GenericChunkSize;
+
+      decodeToFloats(source, sourcePixels, rgba, chunkSize);
+      offsetByThresholds(rgba, chunkSize, steps, thresholds, thresholdMask, x);
+      encodeFromFloats(target, rgba, targetPixels, chunkSize);
+
+      sourcePixels += source.BytesPerPixel * chunkSize;
+      targetPixels += target.BytesPerPixel * chunkSize;
+      pixelCount -= chunkSize;
+      x += chunkSize;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a layout stores all three color channels in bytes</summary>
+  /// <param name="layout">Layout that will be checked</param>
+  /// <returns>True if the layout is an unsigned byte format with RGB channels</returns>
+  bool isRgbByteLayout(const PixelLayout &layout) {
+    return (
+      (layout.Type == ChannelType::UnsignedByte) &&
+      (layout.Channels[0] >= 0) && (layout.Channels[1] >= 0) && (layout.Channels[2] >= 0)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the fastest row conversion function for two pixel layouts</summary>
+  /// <param name="sourcePixelFormat">Pixel format of the pixels being converted</param>
+  /// <param name="source">Layout of the pixels being converted</param>
+  /// <param name="targetPixelFormat">Pixel format the pixels will be converted to</param>
+  /// <param name="target">Layout the pixels will be converted to</param>
+  /// <returns>The row conversion function that should be used</returns>
+  ConvertRowFunction *selectRowConverter(
+    Nuclex::Pixels::PixelFormat sourcePixelFormat, const PixelLayout &source,
+    Nuclex::Pixels::PixelFormat targetPixelFormat, const PixelLayout &target
+  ) {
+    if(sourcePixelFormat == targetPixelFormat) {
+      return &copyPixels;
+    }
+
+    bool sourceIsBytes = (
+      (source.Type == ChannelType::UnsignedByte) || (source.Type == ChannelType::SignedByte)
+    );
+    if(sourceIsBytes && (source.Type == target.Type)) {
+      bool isFourChannelSwizzle = (
+        (source.BytesPerPixel == 4) && (target.BytesPerPixel == 4) &&
+        (source.Channels[3] >= 0) && (target.Channels[3] >= 0)
+      );
+      if(isFourChannelSwizzle) {
+        return &shuffleBytes;
+      } else {
+        return &remapBytes;
+      }
+    }
+
+    if(isRgbByteLayout(source) && (target.Type == ChannelType::Packed565)) {
+      return &packBytesTo565;
+    }
+    if((source.Type == ChannelType::Packed565) && isRgbByteLayout(target)) {
+      return &unpack565ToBytes;
+    }
+    if((source.Type == ChannelType::UnsignedByte) && (target.Type == ChannelType::Half)) {
+      return &expandBytesToHalfs;
+    }
+
+    return &convertViaFloats;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the layouts of two pixel formats to convert between</summary>
+  /// <param name="sourcePixelFormat">Pixel format of the pixels being converted</param>
+  /// <param name="source">Receives the layout of the source pixel format</param>
+  /// <param name="targetPixelFormat">Pixel format the pixels will be converted to</param>
+  /// <param name="target">Receives the layout of the target pixel format</param>
+  void requireLayouts(
+    Nuclex::Pixels::PixelFormat sourcePixelFormat, PixelLayout &source,
+    Nuclex::Pixels::PixelFormat targetPixelFormat, PixelLayout &target
+  ) {
+    bool canConvert = (
+      describePixelFormat(sourcePixelFormat, source) &&
+      describePixelFormat(targetPixelFormat, target)
+    );
+    if(!canConvert) {
+      throw std::runtime_error(u8"Conversion between these pixel formats is not supported");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts the rows of a bitmap, dithering them if it makes a difference</summary>
+  /// <param name="sourceLayout">Layout of the pixels that are being converted</param>
+  /// <param name="targetLayout">Layout the pixels are being converted into</param>
+  /// <param name="source">Bitmap memory the pixels will be read from</param>
+  /// <param name="target">Bitmap memory the converted pixels will be written to</param>
+  /// <param name="dithering">Dithering method that will be applied</param>
+  /// <param name="firstRow">Index of the first row in the whole bitmap</param>
+  void convertRows(
+    const PixelLayout &sourceLayout, const PixelLayout &targetLayout,
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target,
+    Nuclex::Pixels::DitheringMethod dithering, std::size_t firstRow
+  ) {
+    const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(source.Pixels);
+    std::uint8_t *targetRow = static_cast<std::uint8_t *>(target.Pixels);
+
+    bool useDithering = (
+      (dithering != Nuclex::Pixels::DitheringMethod::None) &&
+      canDither(sourceLayout, targetLayout)
+    );
+    if(useDithering) {
+      Nuclex::Pixels::DitherPattern pattern = Nuclex::Pixels::GetDitherPattern(dithering);
+      for(std::size_t y = 0; y < source.Height; ++y) {
+        convertWithDithering(
+          sourceLayout, targetLayout, sourceRow, targetRow, source.Width,
+          pattern.GetRow(firstRow + y), pattern.Mask
+        );
+        sourceRow += source.Stride;
+        targetRow += target.Stride;
+      }
+    } else {
+      ConvertRowFunction *convertRow = selectRowConverter(
+        source.PixelFormat, sourceLayout, target.PixelFormat, targetLayout
+      );
+      for(std::size_t y = 0; y < source.Height; ++y) {
+        convertRow(sourceLayout, targetLayout, sourceRow, targetRow, source.Width);
+        sourceRow += source.Stride;
+        targetRow += target.Stride;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row source that converts the rows of another row source</summary>
+  class ConvertingRowSource : public Nuclex::Pixels::RowSource {
+
+    /// <summary>Initializes a new converting row source</summary>
+    /// <param name="source">Row source whose rows will be converted</param>
+    /// <param name="targetPixelFormat">Pixel format the rows will be converted to</param>
+    public: ConvertingRowSource(
+      std::unique_ptr<Nuclex::Pixels::RowSource> &&source,
+      Nuclex::Pixels::PixelFormat targetPixelFormat
+    ) :
+      source(std::move(source)),
+      targetPixelFormat(targetPixelFormat),
+      remainingRowCount(this->source->GetHeight()) {
+      requireLayouts(
+        this->source->GetPixelFormat(), this->sourceLayout,
+        targetPixelFormat, this->targetLayout
+      );
+      this->convertRow = selectRowConverter(
+        this->source->GetPixelFormat(), this->sourceLayout,
+        targetPixelFormat, this->targetLayout
+      );
+    }
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->source->GetWidth(); }
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: std::size_t GetHeight() const override { return this->source->GetHeight(); }
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->targetPixelFormat;
+    }
+
+    /// <summary>Reads and converts the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory that will receive the converted rows</param>
+    public: void ReadRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      Nuclex::Pixels::RequireFittingRows(
+        rows, GetWidth(), this->targetPixelFormat, this->remainingRowCount
+      );
+
+      // The rows are read in bands no larger than the buffer, which is only allocated
+      // when the first rows are requested and then kept for all following reads
+      Nuclex::Pixels::PixelFormat sourcePixelFormat = this->source->GetPixelFormat();
+      std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+        sourcePixelFormat, rows.Width
+      );
+      if(rowByteCount == 0) {
+        return;
+      }
+      std::size_t bandHeight = Nuclex::Pixels::GetBandHeight(rowByteCount);
+      if(this->buffer.empty()) {
+        this->buffer.resize(rowByteCount * std::min(bandHeight, this->remainingRowCount));
+      }
+      bandHeight = this->buffer.size() / rowByteCount;
+
+      Nuclex::Pixels::BitmapMemory band;
+      band.Width = rows.Width;
+      band.Stride = static_cast<int>(rowByteCount);
+      band.PixelFormat = sourcePixelFormat;
+      band.Pixels = this->buffer.data();
+
+      std::uint8_t *targetRow = static_cast<std::uint8_t *>(rows.Pixels);
+      for(std::size_t y = 0; y < rows.Height; y += bandHeight) {
+        band.Height = std::min(bandHeight, rows.Height - y);
+        this->source->ReadRows(band);
+
+        const std::uint8_t *sourceRow = this->buffer.data();
+        for(std::size_t row = 0; row < band.Height; ++row) {
+          this->convertRow(
+            this->sourceLayout, this->targetLayout, sourceRow, targetRow, rows.Width
+          );
+          sourceRow += rowByteCount;
+          targetRow += rows.Stride;
+        }
+      }
+
+      this->remainingRowCount -= rows.Height;
+    }
+
+    /// <summary>Row source that provides the rows before conversion</summary>
+    private: std::unique_ptr<Nuclex::Pixels::RowSource> source;
+    /// <summary>Pixel format the rows are converted to</summary>
+    private: Nuclex::Pixels::PixelFormat targetPixelFormat;
+    /// <summary>Number of rows that have not been read yet</summary>
+    private: std::size_t remainingRowCount;
+    /// <summary>Layout of the pixels in the source row source</summary>
+    private: PixelLayout sourceLayout;
+    /// <summary>Layout of the pixels after conversion</summary>
+    private: PixelLayout targetLayout;
+    /// <summary>Row kernel that converts between the two pixel formats</summary>
+    private: ConvertRowFunction *convertRow;
+    /// <summary>Holds a band of rows read from the source row source</summary>
+    private: std::vector<std::uint8_t> buffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PixelFormatConverter::CanConvert(
+    PixelFormat sourcePixelFormat, PixelFormat targetPixelFormat
+  ) {
+    PixelLayout source, target;
+    return (
+      describePixelFormat(sourcePixelFormat, source) &&
+      describePixelFormat(targetPixelFormat, target)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PixelFormatConverter::ConvertRow(
+    PixelFormat sourcePixelFormat, const void *sourcePixels,
+    PixelFormat targetPixelFormat, void *targetPixels,
+    std::size_t pixelCount
+  ) {
+    PixelLayout source, target;
+    requireLayouts(sourcePixelFormat, source, targetPixelFormat, target);
+
+    ConvertRowFunction *convertRow = selectRowConverter(
+      sourcePixelFormat, source, targetPixelFormat, target
+    );
+    convertRow(
+      source, target,
+      static_cast<const std::uint8_t *>(sourcePixels), static_cast<std::uint8_t *>(targetPixels),
+      pixelCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PixelFormatConverter::EncodeColor(
+    const ColorModels::RgbColor &color, PixelFormat pixelFormat, void *pixel
+  ) {
+    const float channels[4] = { color.Red, color.Green, color.Blue, color.Alpha };
+    ConvertRow(PixelFormat::R32_G32_B32_A32_Float_Native32, channels, pixelFormat, pixel, 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PixelFormatConverter::Convert(const BitmapMemory &source, const BitmapMemory &target) {
+    Convert(source, target, DitheringMethod::None);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PixelFormatConverter::Convert(
+    const BitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+  ) {
+    Convert(source, target, DitheringMethod::None, threadPool);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PixelFormatConverter::Convert(
+    const BitmapMemory &source, const BitmapMemory &target, DitheringMethod dithering
+  ) {
+    if((source.Width != target.Width) || (source.Height != target.Height)) {
+      throw std::runtime_error(u8"Provided bitmap does not have the correct dimensions");
+    }
+
+    PixelLayout sourceLayout, targetLayout;
+    requireLayouts(source.PixelFormat, sourceLayout, target.PixelFormat, targetLayout);
+
+    convertRows(sourceLayout, targetLayout, source, target, dithering, 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PixelFormatConverter::Convert(
+    const BitmapMemory &source, const BitmapMemory &target,
+    DitheringMethod dithering, ThreadPool &threadPool
+  ) {
+    if((source.Width != target.Width) || (source.Height != target.Height)) {
+      throw std::runtime_error(u8"Provided bitmap does not have the correct dimensions");
+    }
+
+    PixelLayout sourceLayout, targetLayout;
+    requireLayouts(source.PixelFormat, sourceLayout, target.PixelFormat, targetLayout);
+
+    ForEachBandInParallel(
+      threadPool, source, target,
+      [&](const BitmapMemory &sourceBand, const BitmapMemory &targetBand, std::size_t y) {
+        convertRows(sourceLayout, targetLayout, sourceBand, targetBand, dithering, y);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSource> PixelFormatConverter::ConvertRows(
+    std::unique_ptr<RowSource> &&source, PixelFormat targetPixelFormat
+  ) {
+    if(source->GetPixelFormat() == targetPixelFormat) {
+      return std::move(source);
+    }
+
+    return std::unique_ptr<RowSource>(
+      new ConvertingRowSource(std::move(source), targetPixelFormat)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,145 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PlanarBitmap.h"
+#include "Nuclex/Pixels/BitmapAllocator.h"
+#include "Nuclex/Pixels/PlanarConverter.h"
+
+#include <cstdint>
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of bytes each plane and each line within a plane is aligned to</summary>
+  const std::size_t PlaneAlignment = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds the specified value to the next multiple of a factor</summary>
+  /// <param name="value">Value that will be rounded up</param>
+  /// <param name="factor">Factor to which the value will be rounded up</param>
+  /// <returns>The next multiple of the specified factor</returns>
+  std::size_t nextMultiple(std::size_t value, std::size_t factor) {
+    std::size_t remainder = value % factor;
+    if(remainder > 0) {
+      value += (factor - remainder);
+    }
+
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PlanarBitmap::PlanarBitmap(std::size_t width, std::size_t height, PixelFormat pixelFormat) :
+    allocator(&BitmapAllocator::GetDefault()),
+    allocatedMemory(nullptr),
+    allocatedByteCount(0) {
+
+    std::size_t planeCount = PlanarConverter::CountPlanes(pixelFormat);
+    if(planeCount == 0) {
+      throw std::runtime_error(u8"Splitting this pixel format into planes is not supported");
+    }
+
+    std::size_t stride = nextMultiple(
+      width * PlanarConverter::CountBytesPerChannel(pixelFormat), PlaneAlignment
+    );
+    std::size_t planeByteCount = stride * height;
+
+    this->memory.Width = width;
+    this->memory.Height = height;
+    this->memory.PixelFormat = pixelFormat;
+    this->memory.PlaneCount = planeCount;
+
+    // Allocate a single memory block for all planes with room to align the first one
+    this->allocatedByteCount = planeByteCount * planeCount + (PlaneAlignment - 1);
+    this->allocatedMemory = this->allocator->Allocate(this->allocatedByteCount);
+    {
+      std::uintptr_t address = reinterpret_cast<std::uintptr_t>(this->allocatedMemory);
+      std::uint8_t *firstValue = static_cast<std::uint8_t *>(this->allocatedMemory) + (
+        nextMultiple(address, PlaneAlignment) - address
+      );
+      for(std::size_t index = 0; index < MaximumPlaneCount; ++index) {
+        if(index < planeCount) {
+          this->memory.Strides[index] = static_cast<int>(stride);
+          this->memory.Planes[index] = firstValue + planeByteCount * index;
+        } else {
+          this->memory.Strides[index] = 0;
+          this->memory.Planes[index] = nullptr;
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PlanarBitmap::PlanarBitmap(PlanarBitmap &&other) :
+    memory(other.memory),
+    allocator(other.allocator),
+    allocatedMemory(other.allocatedMemory),
+    allocatedByteCount(other.allocatedByteCount) {
+    other.allocatedMemory = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PlanarBitmap::~PlanarBitmap() {
+    free();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PlanarBitmap &PlanarBitmap::operator =(PlanarBitmap &&other) {
+    if(this != &other) {
+      free();
+
+      this->memory = other.memory;
+      this->allocator = other.allocator;
+      this->allocatedMemory = other.allocatedMemory;
+      this->allocatedByteCount = other.allocatedByteCount;
+
+      other.allocatedMemory = nullptr;
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlanarBitmap::free() {
+    if(this->allocatedMemory != nullptr) {
+      this->allocator->Free(this->allocatedMemory, this->allocatedByteCount);
+      this->allocatedMemory = nullptr;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,943 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PlanarConverter.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+
+#include <cstdint>
+#include <stdexcept> // for std::runtime_error
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2 intrinsics
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+#include <arm_neon.h> // for NEON intrinsics
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes how the pixels of a pixel format are split into planes</summary>
+  struct PlanarLayout {
+
+    /// <summary>Interleaved pixel format the layout applies to</summary>
+    public: Nuclex::Pixels::PixelFormat PixelFormat;
+    /// <summary>Number of planes, equal to the number of channels</summary>
+    public: std::size_t PlaneCount;
+    /// <summary>Number of bytes each channel occupies</summary>
+    public: std::size_t BytesPerChannel;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>All pixel formats that can be split into planes</summary>
+  /// <remarks>
+  ///   Some of the native and flipped pixel formats are aliases of others depending on
+  ///   the platform's byte order, so a list (rather than a switch statement) is used.
+  /// </remarks>
+  const PlanarLayout PlanarLayouts[] = {
+    { Nuclex::Pixels::PixelFormat::R8_Unsigned, 1, 1 },
+    { Nuclex::Pixels::PixelFormat::R8_G8_Unsigned, 2, 1 },
+    { Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned, 3, 1 },
+    { Nuclex::Pixels::PixelFormat::R8_G8_B8_Signed, 3, 1 },
+    { Nuclex::Pixels::PixelFormat::B8_G8_R8_Unsigned, 3, 1 },
+    { Nuclex::Pixels::PixelFormat::B8_G8_R8_Signed, 3, 1 },
+    { Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned, 4, 1 },
+    { Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Signed, 4, 1 },
+    { Nuclex::Pixels::PixelFormat::A8_B8_G8_R8_Unsigned, 4, 1 },
+    { Nuclex::Pixels::PixelFormat::A8_B8_G8_R8_Signed, 4, 1 },
+    { Nuclex::Pixels::PixelFormat::B8_G8_R8_A8_Unsigned, 4, 1 },
+    { Nuclex::Pixels::PixelFormat::B8_G8_R8_A8_Signed, 4, 1 },
+    { Nuclex::Pixels::PixelFormat::A8_R8_G8_B8_Unsigned, 4, 1 },
+    { Nuclex::Pixels::PixelFormat::A8_R8_G8_B8_Signed, 4, 1 },
+    { Nuclex::Pixels::PixelFormat::R16_Unsigned_Native16, 1, 2 },
+    { Nuclex::Pixels::PixelFormat::R16_Float_Native16, 1, 2 },
+    { Nuclex::Pixels::PixelFormat::R16_G16_Unsigned_Native16, 2, 2 },
+    { Nuclex::Pixels::PixelFormat::R16_G16_Float_Native16, 2, 2 },
+    { Nuclex::Pixels::PixelFormat::R16_G16_B16_A16_Float_Native16, 4, 2 },
+    { Nuclex::Pixels::PixelFormat::R16_G16_B16_A16_Float_Flipped16, 4, 2 },
+    { Nuclex::Pixels::PixelFormat::A16_B16_G16_R16_Float_Native16, 4, 2 },
+    { Nuclex::Pixels::PixelFormat::A16_B16_G16_R16_Float_Flipped16, 4, 2 },
+    { Nuclex::Pixels::PixelFormat::B16_G16_R16_A16_Float_Native16, 4, 2 },
+    { Nuclex::Pixels::PixelFormat::B16_G16_R16_A16_Float_Flipped16, 4, 2 },
+    { Nuclex::Pixels::PixelFormat::A16_R16_G16_B16_Float_Native16, 4, 2 },
+    { Nuclex::Pixels::PixelFormat::A16_R16_G16_B16_Float_Flipped16, 4, 2 },
+    { Nuclex::Pixels::PixelFormat::R32_Float_Native32, 1, 4 },
+    { Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32, 4, 4 },
+    { Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Flipped32, 4, 4 },
+    { Nuclex::Pixels::PixelFormat::A32_B32_G32_R32_Float_Native32, 4, 4 },
+    { Nuclex::Pixels::PixelFormat::A32_B32_G32_R32_Float_Flipped32, 4, 4 }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up how the pixels of a pixel format are split into planes</summary>
+  /// <param name="pixelFormat">Pixel format whose planar layout will be looked up</param>
+  /// <returns>The planar layout of the pixel format or null if it can not be split</returns>
+  const PlanarLayout *findPlanarLayout(Nuclex::Pixels::PixelFormat pixelFormat) {
+    for(std::size_t index = 0; index < sizeof(PlanarLayouts) / sizeof(PlanarLayout); ++index) {
+      if(PlanarLayouts[index].PixelFormat == pixelFormat) {
+        return &PlanarLayouts[index];
+      }
+    }
+
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splits a row of interleaved pixels into planes using SIMD instructions</summary>
+  /// <typeparam name="TValue">Type large enough to hold the value of a channel</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels in each pixel</typeparam>
+  /// <param name="pixels">Interleaved pixels that will be split</param>
+  /// <param name="planes">Planes that will receive the channels</param>
+  /// <param name="width">Number of pixels in the row</param>
+  /// <returns>The number of pixels that have been processed</returns>
+  template<typename TValue, std::size_t ChannelCount>
+  std::size_t deinterleaveSimd(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    (void)pixels;
+    (void)planes;
+    (void)width;
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Combines planes into a row of interleaved pixels using SIMD instructions</summary>
+  /// <typeparam name="TValue">Type large enough to hold the value of a channel</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels in each pixel</typeparam>
+  /// <param name="planes">Planes holding the channels</param>
+  /// <param name="pixels">Row that will receive the interleaved pixels</param>
+  /// <param name="width">Number of pixels in the row</param>
+  /// <returns>The number of pixels that have been processed</returns>
+  template<typename TValue, std::size_t ChannelCount>
+  std::size_t interleaveSimd(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    (void)planes;
+    (void)pixels;
+    (void)width;
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_SSE2)
+  /// <summary>Loads 16 bytes from the specified address</summary>
+  /// <param name="address">Address the bytes will be loaded from</param>
+  /// <returns>A register holding the loaded bytes</returns>
+  inline __m128i load(const std::uint8_t *address) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(address));
+  }
+
+  /// <summary>Stores 16 bytes at the specified address</summary>
+  /// <param name="address">Address the bytes will be stored at</param>
+  /// <param name="value">Register holding the bytes that will be stored</param>
+  inline void store(std::uint8_t *address, __m128i value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(address), value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint8_t, 2>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      __m128i first = load(pixels + x * 2);
+      __m128i second = load(pixels + x * 2 + 16);
+      store(
+        planes[0] + x,
+        _mm_packus_epi16(_mm_and_si128(first, lowBytes), _mm_and_si128(second, lowBytes))
+      );
+      store(
+        planes[1] + x,
+        _mm_packus_epi16(_mm_srli_epi16(first, 8), _mm_srli_epi16(second, 8))
+      );
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint8_t, 4>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      const std::uint8_t *source = pixels + x * 4;
+
+      // Each round of unpacking halves the distance between values of the same channel
+      // until each register holds 8 values each of two channels
+      __m128i pixels0to3 = load(source);
+      __m128i pixels4to7 = load(source + 16);
+      __m128i pixels8to11 = load(source + 32);
+      __m128i pixels12to15 = load(source + 48);
+
+      __m128i first = _mm_unpacklo_epi8(pixels0to3, pixels4to7);
+      __m128i second = _mm_unpackhi_epi8(pixels0to3, pixels4to7);
+      __m128i third = _mm_unpacklo_epi8(pixels8to11, pixels12to15);
+      __m128i fourth = _mm_unpackhi_epi8(pixels8to11, pixels12to15);
+
+      pixels0to3 = _mm_unpacklo_epi8(first, second);
+      pixels4to7 = _mm_unpackhi_epi8(first, second);
+      pixels8to11 = _mm_unpacklo_epi8(third, fourth);
+      pixels12to15 = _mm_unpackhi_epi8(third, fourth);
+
+      first = _mm_unpacklo_epi8(pixels0to3, pixels4to7);
+      second = _mm_unpackhi_epi8(pixels0to3, pixels4to7);
+      third = _mm_unpacklo_epi8(pixels8to11, pixels12to15);
+      fourth = _mm_unpackhi_epi8(pixels8to11, pixels12to15);
+
+      store(planes[0] + x, _mm_unpacklo_epi64(first, third));
+      store(planes[1] + x, _mm_unpackhi_epi64(first, third));
+      store(planes[2] + x, _mm_unpacklo_epi64(second, fourth));
+      store(planes[3] + x, _mm_unpackhi_epi64(second, fourth));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Moves the first of each pair of 16 bit values into the lower half</summary>
+  /// <param name="pairs">Register holding four pairs of 16 bit values</param>
+  /// <returns>A register with the first values in its lower half, the second in its upper</returns>
+  inline __m128i separatePairs(__m128i pairs) {
+    pairs = _mm_shufflelo_epi16(pairs, _MM_SHUFFLE(3, 1, 2, 0));
+    pairs = _mm_shufflehi_epi16(pairs, _MM_SHUFFLE(3, 1, 2, 0));
+    return _mm_shuffle_epi32(pairs, _MM_SHUFFLE(3, 1, 2, 0));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint16_t, 2>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 8 <= width; x += 8) {
+      __m128i first = separatePairs(load(pixels + x * 4));
+      __m128i second = separatePairs(load(pixels + x * 4 + 16));
+
+      store(planes[0] + x * 2, _mm_unpacklo_epi64(first, second));
+      store(planes[1] + x * 2, _mm_unpackhi_epi64(first, second));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint16_t, 4>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 8 <= width; x += 8) {
+      const std::uint8_t *source = pixels + x * 8;
+
+      __m128i pixels0to1 = load(source);
+      __m128i pixels2to3 = load(source + 16);
+      __m128i pixels4to5 = load(source + 32);
+      __m128i pixels6to7 = load(source + 48);
+
+      __m128i first = _mm_unpacklo_epi16(pixels0to1, pixels2to3);
+      __m128i second = _mm_unpackhi_epi16(pixels0to1, pixels2to3);
+      __m128i third = _mm_unpacklo_epi16(pixels4to5, pixels6to7);
+      __m128i fourth = _mm_unpackhi_epi16(pixels4to5, pixels6to7);
+
+      pixels0to1 = _mm_unpacklo_epi16(first, second);
+      pixels2to3 = _mm_unpackhi_epi16(first, second);
+      pixels4to5 = _mm_unpacklo_epi16(third, fourth);
+      pixels6to7 = _mm_unpackhi_epi16(third, fourth);
+
+      store(planes[0] + x * 2, _mm_unpacklo_epi64(pixels0to1, pixels4to5));
+      store(planes[1] + x * 2, _mm_unpackhi_epi64(pixels0to1, pixels4to5));
+      store(planes[2] + x * 2, _mm_unpacklo_epi64(pixels2to3, pixels6to7));
+      store(planes[3] + x * 2, _mm_unpackhi_epi64(pixels2to3, pixels6to7));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint32_t, 4>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 4 <= width; x += 4) {
+      const std::uint8_t *source = pixels + x * 16;
+
+      __m128i pixel0 = load(source);
+      __m128i pixel1 = load(source + 16);
+      __m128i pixel2 = load(source + 32);
+      __m128i pixel3 = load(source + 48);
+
+      __m128i first = _mm_unpacklo_epi32(pixel0, pixel1);
+      __m128i second = _mm_unpackhi_epi32(pixel0, pixel1);
+      __m128i third = _mm_unpacklo_epi32(pixel2, pixel3);
+      __m128i fourth = _mm_unpackhi_epi32(pixel2, pixel3);
+
+      store(planes[0] + x * 4, _mm_unpacklo_epi64(first, third));
+      store(planes[1] + x * 4, _mm_unpackhi_epi64(first, third));
+      store(planes[2] + x * 4, _mm_unpacklo_epi64(second, fourth));
+      store(planes[3] + x * 4, _mm_unpackhi_epi64(second, fourth));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint8_t, 2>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      __m128i first = load(planes[0] + x);
+      __m128i second = load(planes[1] + x);
+      store(pixels + x * 2, _mm_unpacklo_epi8(first, second));
+      store(pixels + x * 2 + 16, _mm_unpackhi_epi8(first, second));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint8_t, 4>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      __m128i first = load(planes[0] + x);
+      __m128i second = load(planes[1] + x);
+      __m128i third = load(planes[2] + x);
+      __m128i fourth = load(planes[3] + x);
+
+      __m128i lowerFirstPairs = _mm_unpacklo_epi8(first, second);
+      __m128i upperFirstPairs = _mm_unpackhi_epi8(first, second);
+      __m128i lowerSecondPairs = _mm_unpacklo_epi8(third, fourth);
+      __m128i upperSecondPairs = _mm_unpackhi_epi8(third, fourth);
+
+      std::uint8_t *target = pixels + x * 4;
+      store(target, _mm_unpacklo_epi16(lowerFirstPairs, lowerSecondPairs));
+      store(target + 16, _mm_unpackhi_epi16(lowerFirstPairs, lowerSecondPairs));
+      store(target + 32, _mm_unpacklo_epi16(upperFirstPairs, upperSecondPairs));
+      store(target + 48, _mm_unpackhi_epi16(upperFirstPairs, upperSecondPairs));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint16_t, 2>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 8 <= width; x += 8) {
+      __m128i first = load(planes[0] + x * 2);
+      __m128i second = load(planes[1] + x * 2);
+      store(pixels + x * 4, _mm_unpacklo_epi16(first, second));
+      store(pixels + x * 4 + 16, _mm_unpackhi_epi16(first, second));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint16_t, 4>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 8 <= width; x += 8) {
+      __m128i first = load(planes[0] + x * 2);
+      __m128i second = load(planes[1] + x * 2);
+      __m128i third = load(planes[2] + x * 2);
+      __m128i fourth = load(planes[3] + x * 2);
+
+      __m128i lowerFirstPairs = _mm_unpacklo_epi16(first, second);
+      __m128i upperFirstPairs = _mm_unpackhi_epi16(first, second);
+      __m128i lowerSecondPairs = _mm_unpacklo_epi16(third, fourth);
+      __m128i upperSecondPairs = _mm_unpackhi_epi16(third, fourth);
+
+      std::uint8_t *target = pixels + x * 8;
+      store(target, _mm_unpacklo_epi32(lowerFirstPairs, lowerSecondPairs));
+      store(target + 16, _mm_unpackhi_epi32(lowerFirstPairs, lowerSecondPairs));
+      store(target + 32, _mm_unpacklo_epi32(upperFirstPairs, upperSecondPairs));
+      store(target + 48, _mm_unpackhi_epi32(upperFirstPairs, upperSecondPairs));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint32_t, 4>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 4 <= width; x += 4) {
+      __m128i first = load(planes[0] + x * 4);
+      __m128i second = load(planes[1] + x * 4);
+      __m128i third = load(planes[2] + x * 4);
+      __m128i fourth = load(planes[3] + x * 4);
+
+      __m128i lowerFirstPairs = _mm_unpacklo_epi32(first, second);
+      __m128i upperFirstPairs = _mm_unpackhi_epi32(first, second);
+      __m128i lowerSecondPairs = _mm_unpacklo_epi32(third, fourth);
+      __m128i upperSecondPairs = _mm_unpackhi_epi32(third, fourth);
+
+      std::uint8_t *target = pixels + x * 16;
+      store(target, _mm_unpacklo_epi64(lowerFirstPairs, lowerSecondPairs));
+      store(target + 16, _mm_unpackhi_epi64(lowerFirstPairs, lowerSecondPairs));
+      store(target + 32, _mm_unpacklo_epi64(upperFirstPairs, upperSecondPairs));
+      store(target + 48, _mm_unpackhi_epi64(upperFirstPairs, upperSecondPairs));
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#elif defined(NUCLEX_PIXELS_HAVE_NEON)
+  template<>
+  std::size_t deinterleaveSimd<std::uint8_t, 2>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      uint8x16x2_t values = vld2q_u8(pixels + x * 2);
+      vst1q_u8(planes[0] + x, values.val[0]);
+      vst1q_u8(planes[1] + x, values.val[1]);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint8_t, 3>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      uint8x16x3_t values = vld3q_u8(pixels + x * 3);
+      vst1q_u8(planes[0] + x, values.val[0]);
+      vst1q_u8(planes[1] + x, values.val[1]);
+      vst1q_u8(planes[2] + x, values.val[2]);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint8_t, 4>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      uint8x16x4_t values = vld4q_u8(pixels + x * 4);
+      vst1q_u8(planes[0] + x, values.val[0]);
+      vst1q_u8(planes[1] + x, values.val[1]);
+      vst1q_u8(planes[2] + x, values.val[2]);
+      vst1q_u8(planes[3] + x, values.val[3]);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint16_t, 2>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 8 <= width; x += 8) {
+      uint16x8x2_t values = vld2q_u16(reinterpret_cast<const std::uint16_t *>(pixels) + x * 2);
+      vst1q_u16(reinterpret_cast<std::uint16_t *>(planes[0]) + x, values.val[0]);
+      vst1q_u16(reinterpret_cast<std::uint16_t *>(planes[1]) + x, values.val[1]);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint16_t, 4>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 8 <= width; x += 8) {
+      uint16x8x4_t values = vld4q_u16(reinterpret_cast<const std::uint16_t *>(pixels) + x * 4);
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        vst1q_u16(reinterpret_cast<std::uint16_t *>(planes[channel]) + x, values.val[channel]);
+      }
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t deinterleaveSimd<std::uint32_t, 4>(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 4 <= width; x += 4) {
+      uint32x4x4_t values = vld4q_u32(reinterpret_cast<const std::uint32_t *>(pixels) + x * 4);
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        vst1q_u32(reinterpret_cast<std::uint32_t *>(planes[channel]) + x, values.val[channel]);
+      }
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint8_t, 2>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      uint8x16x2_t values;
+      values.val[0] = vld1q_u8(planes[0] + x);
+      values.val[1] = vld1q_u8(planes[1] + x);
+      vst2q_u8(pixels + x * 2, values);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint8_t, 3>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      uint8x16x3_t values;
+      values.val[0] = vld1q_u8(planes[0] + x);
+      values.val[1] = vld1q_u8(planes[1] + x);
+      values.val[2] = vld1q_u8(planes[2] + x);
+      vst3q_u8(pixels + x * 3, values);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint8_t, 4>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 16 <= width; x += 16) {
+      uint8x16x4_t values;
+      values.val[0] = vld1q_u8(planes[0] + x);
+      values.val[1] = vld1q_u8(planes[1] + x);
+      values.val[2] = vld1q_u8(planes[2] + x);
+      values.val[3] = vld1q_u8(planes[3] + x);
+      vst4q_u8(pixels + x * 4, values);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint16_t, 2>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 8 <= width; x += 8) {
+      uint16x8x2_t values;
+      values.val[0] = vld1q_u16(reinterpret_cast<const std::uint16_t *>(planes[0]) + x);
+      values.val[1] = vld1q_u16(reinterpret_cast<const std::uint16_t *>(planes[1]) + x);
+      vst2q_u16(reinterpret_cast<std::uint16_t *>(pixels) + x * 2, values);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint16_t, 4>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 8 <= width; x += 8) {
+      uint16x8x4_t values;
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        values.val[channel] = vld1q_u16(
+          reinterpret_cast<const std::uint16_t *>(planes[channel]) + x
+        );
+      }
+      vst4q_u16(reinterpret_cast<std::uint16_t *>(pixels) + x * 4, values);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<>
+  std::size_t interleaveSimd<std::uint32_t, 4>(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = 0;
+    for(; x + 4 <= width; x += 4) {
+      uint32x4x4_t values;
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        values.val[channel] = vld1q_u32(
+          reinterpret_cast<const std::uint32_t *>(planes[channel]) + x
+        );
+      }
+      vst4q_u32(reinterpret_cast<std::uint32_t *>(pixels) + x * 4, values);
+    }
+
+    return x;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#endif
+  /// <summary>Splits a row of interleaved pixels into planes</summary>
+  /// <typeparam name="TValue">Type large enough to hold the value of a channel</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels in each pixel</typeparam>
+  /// <param name="pixels">Interleaved pixels that will be split</param>
+  /// <param name="planes">Planes that will receive the channels</param>
+  /// <param name="width">Number of pixels in the row</param>
+  template<typename TValue, std::size_t ChannelCount>
+  void deinterleaveRow(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  ) {
+    std::size_t x = deinterleaveSimd<TValue, ChannelCount>(pixels, planes, width);
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    const TValue *values = reinterpret_cast<const TValue *>(pixels);
+    for(; x < width; ++x) {
+      for(std::size_t channel = 0; channel < ChannelCount; ++channel) {
+        reinterpret_cast<TValue *>(planes[channel])[x] = values[x * ChannelCount + channel];
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Combines planes into a row of interleaved pixels</summary>
+  /// <typeparam name="TValue">Type large enough to hold the value of a channel</typeparam>
+  /// <typeparam name="ChannelCount">Number of channels in each pixel</typeparam>
+  /// <param name="planes">Planes holding the channels</param>
+  /// <param name="pixels">Row that will receive the interleaved pixels</param>
+  /// <param name="width">Number of pixels in the row</param>
+  template<typename TValue, std::size_t ChannelCount>
+  void interleaveRow(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  ) {
+    std::size_t x = interleaveSimd<TValue, ChannelCount>(planes, pixels, width);
+
+    // Scalar loop for the remaining pixels or if no SIMD instructions are available
+    TValue *values = reinterpret_cast<TValue *>(pixels);
+    for(; x < width; ++x) {
+      for(std::size_t channel = 0; channel < ChannelCount; ++channel) {
+        values[x * ChannelCount + channel] = (
+          reinterpret_cast<const TValue *>(planes[channel])[x]
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Function that splits a row of interleaved pixels into planes</summary>
+  typedef void DeinterleaveRowFunction(
+    const std::uint8_t *pixels, std::uint8_t *const *planes, std::size_t width
+  );
+
+  /// <summary>Function that combines planes into a row of interleaved pixels</summary>
+  typedef void InterleaveRowFunction(
+    const std::uint8_t *const *planes, std::uint8_t *pixels, std::size_t width
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row deinterleaving functions by channel size (1, 2, 4) and count</summary>
+  DeinterleaveRowFunction *const DeinterleaveRowFunctions[3][4] = {
+    {
+      &deinterleaveRow<std::uint8_t, 1>, &deinterleaveRow<std::uint8_t, 2>,
+      &deinterleaveRow<std::uint8_t, 3>, &deinterleaveRow<std::uint8_t, 4>
+    },
+    {
+      &deinterleaveRow<std::uint16_t, 1>, &deinterleaveRow<std::uint16_t, 2>,
+      &deinterleaveRow<std::uint16_t, 3>, &deinterleaveRow<std::uint16_t, 4>
+    },
+    {
+      &deinterleaveRow<std::uint32_t, 1>, &deinterleaveRow<std::uint32_t, 2>,
+      &deinterleaveRow<std::uint32_t, 3>, &deinterleaveRow<std::uint32_t, 4>
+    }
+  };
+
+  /// <summary>Row interleaving functions by channel size (1, 2, 4) and count</summary>
+  InterleaveRowFunction *const InterleaveRowFunctions[3][4] = {
+    {
+      &interleaveRow<std::uint8_t, 1>, &interleaveRow<std::uint8_t, 2>,
+      &interleaveRow<std::uint8_t, 3>, &interleaveRow<std::uint8_t, 4>
+    },
+    {
+      &interleaveRow<std::uint16_t, 1>, &interleaveRow<std::uint16_t, 2>,
+      &interleaveRow<std::uint16_t, 3>, &interleaveRow<std::uint16_t, 4>
+    },
+    {
+      &interleaveRow<std::uint32_t, 1>, &interleaveRow<std::uint32_t, 2>,
+      &interleaveRow<std::uint32_t, 3>, &interleaveRow<std::uint32_t, 4>
+    }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the index of a channel size in the row function tables</summary>
+  /// <param name="layout">Planar layout whose channel size will be looked up</param>
+  /// <returns>The index of the channel size in the row function tables</returns>
+  std::size_t getChannelSizeIndex(const PlanarLayout &layout) {
+    return (layout.BytesPerChannel == 4) ? 2 : (layout.BytesPerChannel - 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures an interleaved and a planar bitmap can be converted to each other</summary>
+  /// <param name="interleaved">Bitmap memory holding interleaved pixels</param>
+  /// <param name="planar">Planar bitmap memory holding the same pixels in planes</param>
+  /// <returns>The planar layout of the bitmaps' pixel format</returns>
+  const PlanarLayout &requireConvertibleBitmaps(
+    const Nuclex::Pixels::BitmapMemory &interleaved,
+    const Nuclex::Pixels::PlanarBitmapMemory &planar
+  ) {
+    if(interleaved.PixelFormat != planar.PixelFormat) {
+      throw std::runtime_error(u8"Provided bitmaps do not have the same pixel format");
+    }
+
+    const PlanarLayout *layout = findPlanarLayout(interleaved.PixelFormat);
+    if(layout == nullptr) {
+      throw std::runtime_error(u8"Splitting this pixel format into planes is not supported");
+    }
+    if(planar.PlaneCount != layout->PlaneCount) {
+      throw std::runtime_error(u8"Provided planar bitmap does not have the correct plane count");
+    }
+    if((interleaved.Width != planar.Width) || (interleaved.Height != planar.Height)) {
+      throw std::runtime_error(u8"Provided bitmap does not have the correct dimensions");
+    }
+
+    return *layout;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a horizontal band of rows inside a planar bitmap</summary>
+  /// <param name="memory">Planar bitmap memory the band will be taken from</param>
+  /// <param name="y">Index of the first row in the band</param>
+  /// <param name="height">Number of rows in the band</param>
+  /// <returns>Planar bitmap memory covering only the rows of the band</returns>
+  Nuclex::Pixels::PlanarBitmapMemory getPlanarBand(
+    const Nuclex::Pixels::PlanarBitmapMemory &memory, std::size_t y, std::size_t height
+  ) {
+    Nuclex::Pixels::PlanarBitmapMemory band(memory);
+    band.Height = height;
+    for(std::size_t index = 0; index < memory.PlaneCount; ++index) {
+      band.Planes[index] = static_cast<std::uint8_t *>(memory.Planes[index]) + (
+        static_cast<std::ptrdiff_t>(memory.Strides[index]) * static_cast<std::ptrdiff_t>(y)
+      );
+    }
+    return band;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splits all rows of an interleaved bitmap into planes</summary>
+  /// <param name="layout">Planar layout of the bitmaps' pixel format</param>
+  /// <param name="source">Bitmap memory holding the interleaved pixels</param>
+  /// <param name="target">Planar bitmap memory that will receive the channels</param>
+  void deinterleaveRows(
+    const PlanarLayout &layout,
+    const Nuclex::Pixels::BitmapMemory &source,
+    const Nuclex::Pixels::PlanarBitmapMemory &target
+  ) {
+    DeinterleaveRowFunction *deinterleave = (
+      DeinterleaveRowFunctions[getChannelSizeIndex(layout)][layout.PlaneCount - 1]
+    );
+
+    std::uint8_t *planes[Nuclex::Pixels::MaximumPlaneCount];
+    for(std::size_t y = 0; y < source.Height; ++y) {
+      const std::uint8_t *pixels = static_cast<const std::uint8_t *>(source.Pixels) + (
+        static_cast<std::ptrdiff_t>(source.Stride) * static_cast<std::ptrdiff_t>(y)
+      );
+      for(std::size_t index = 0; index < layout.PlaneCount; ++index) {
+        planes[index] = static_cast<std::uint8_t *>(target.Planes[index]) + (
+          static_cast<std::ptrdiff_t>(target.Strides[index]) * static_cast<std::ptrdiff_t>(y)
+        );
+      }
+
+      deinterleave(pixels, planes, source.Width);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Combines all rows of a planar bitmap into interleaved pixels</summary>
+  /// <param name="layout">Planar layout of the bitmaps' pixel format</param>
+  /// <param name="source">Planar bitmap memory holding the channels</param>
+  /// <param name="target">Bitmap memory that will receive the interleaved pixels</param>
+  void interleaveRows(
+    const PlanarLayout &layout,
+    const Nuclex::Pixels::PlanarBitmapMemory &source,
+    const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    InterleaveRowFunction *interleave = (
+      InterleaveRowFunctions[getChannelSizeIndex(layout)][layout.PlaneCount - 1]
+    );
+
+    const std::uint8_t *planes[Nuclex::Pixels::MaximumPlaneCount];
+    for(std::size_t y = 0; y < target.Height; ++y) {
+      for(std::size_t index = 0; index < layout.PlaneCount; ++index) {
+        planes[index] = static_cast<const std::uint8_t *>(source.Planes[index]) + (
+          static_cast<std::ptrdiff_t>(source.Strides[index]) * static_cast<std::ptrdiff_t>(y)
+        );
+      }
+      std::uint8_t *pixels = static_cast<std::uint8_t *>(target.Pixels) + (
+        static_cast<std::ptrdiff_t>(target.Stride) * static_cast<std::ptrdiff_t>(y)
+      );
+
+      interleave(planes, pixels, target.Width);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PlanarConverter::CanSplit(PixelFormat pixelFormat) {
+    return (findPlanarLayout(pixelFormat) != nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PlanarConverter::CountPlanes(PixelFormat pixelFormat) {
+    const PlanarLayout *layout = findPlanarLayout(pixelFormat);
+    if(layout == nullptr) {
+      return 0;
+    } else {
+      return layout->PlaneCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PlanarConverter::CountBytesPerChannel(PixelFormat pixelFormat) {
+    const PlanarLayout *layout = findPlanarLayout(pixelFormat);
+    if(layout == nullptr) {
+      return 0;
+    } else {
+      return layout->BytesPerChannel;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlanarConverter::Deinterleave(
+    const BitmapMemory &source, const PlanarBitmapMemory &target
+  ) {
+    const PlanarLayout &layout = requireConvertibleBitmaps(source, target);
+    deinterleaveRows(layout, source, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlanarConverter::Deinterleave(
+    const BitmapMemory &source, const PlanarBitmapMemory &target, ThreadPool &threadPool
+  ) {
+    const PlanarLayout &layout = requireConvertibleBitmaps(source, target);
+    ForEachBandInParallel(
+      threadPool, source,
+      [&layout, &target](const BitmapMemory &band, std::size_t y) {
+        deinterleaveRows(layout, band, getPlanarBand(target, y, band.Height));
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlanarConverter::Interleave(
+    const PlanarBitmapMemory &source, const BitmapMemory &target
+  ) {
+    const PlanarLayout &layout = requireConvertibleBitmaps(target, source);
+    interleaveRows(layout, source, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PlanarConverter::Interleave(
+    const PlanarBitmapMemory &source, const BitmapMemory &target, ThreadPool &threadPool
+  ) {
+    const PlanarLayout &layout = requireConvertibleBitmaps(target, source);
+    ForEachBandInParallel(
+      threadPool, target,
+      [&layout, &source](const BitmapMemory &band, std::size_t y) {
+        interleaveRows(layout, getPlanarBand(source, y, band.Height), band);
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
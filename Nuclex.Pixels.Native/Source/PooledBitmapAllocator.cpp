@@ -0,0 +1,159 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PooledBitmapAllocator.h"
+
+#include <cstdint> // for std::uint8_t
+#include <mutex> // for std::mutex
+#include <new> // for std::bad_alloc
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct PooledBitmapAllocator::Implementation {
+
+    /// <summary>Initializes a new pooled bitmap allocator implementation</summary>
+    /// <param name="maximumPooledByteCount">
+    ///   Maximum number of bytes the idle memory blocks may add up to
+    /// </param>
+    public: Implementation(std::size_t maximumPooledByteCount) :
+      MaximumPooledByteCount(maximumPooledByteCount) {
+      this->Statistics.AllocationCount = 0;
+      this->Statistics.HitCount = 0;
+      this->Statistics.ResidentByteCount = 0;
+      this->Statistics.PooledByteCount = 0;
+    }
+
+    /// <summary>Frees all idle memory blocks</summary>
+    /// <remarks>The caller needs to hold the mutex</remarks>
+    public: void FreeIdleBlocks() {
+      for(auto &sizeClass : this->IdleBlocks) {
+        for(void *memory : sizeClass.second) {
+          delete[] static_cast<std::uint8_t *>(memory);
+        }
+        this->Statistics.ResidentByteCount -= sizeClass.first * sizeClass.second.size();
+      }
+
+      this->IdleBlocks.clear();
+      this->Statistics.PooledByteCount = 0;
+    }
+
+    /// <summary>Maximum number of bytes the idle memory blocks may add up to</summary>
+    public: std::size_t MaximumPooledByteCount;
+    /// <summary>Protects the idle memory blocks and the statistics</summary>
+    public: mutable std::mutex Mutex;
+    /// <summary>Idle memory blocks waiting to be recycled, grouped by their size</summary>
+    public: std::unordered_map<std::size_t, std::vector<void *>> IdleBlocks;
+    /// <summary>Statistics about the memory managed by the allocator</summary>
+    public: PooledBitmapAllocator::Statistics Statistics;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PooledBitmapAllocator::PooledBitmapAllocator(
+    std::size_t maximumPooledByteCount /* = 64 * 1024 * 1024 */
+  ) :
+    implementation(new Implementation(maximumPooledByteCount)) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PooledBitmapAllocator::~PooledBitmapAllocator() {
+    this->implementation->FreeIdleBlocks();
+    delete this->implementation;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void *PooledBitmapAllocator::Allocate(std::size_t byteCount) {
+    {
+      std::lock_guard<std::mutex> poolLock(this->implementation->Mutex);
+      ++this->implementation->Statistics.AllocationCount;
+
+      auto sizeClass = this->implementation->IdleBlocks.find(byteCount);
+      if(sizeClass != this->implementation->IdleBlocks.end()) {
+        if(!sizeClass->second.empty()) {
+          void *memory = sizeClass->second.back();
+          sizeClass->second.pop_back();
+
+          ++this->implementation->Statistics.HitCount;
+          this->implementation->Statistics.PooledByteCount -= byteCount;
+          return memory;
+        }
+      }
+    }
+
+    // No idle block of the right size, allocate a new one without holding the lock
+    void *memory = new std::uint8_t[byteCount];
+    {
+      std::lock_guard<std::mutex> poolLock(this->implementation->Mutex);
+      this->implementation->Statistics.ResidentByteCount += byteCount;
+    }
+
+    return memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledBitmapAllocator::Free(void *memory, std::size_t byteCount) throw() {
+    {
+      std::lock_guard<std::mutex> poolLock(this->implementation->Mutex);
+
+      std::size_t pooledByteCount = this->implementation->Statistics.PooledByteCount + byteCount;
+      if(pooledByteCount <= this->implementation->MaximumPooledByteCount) {
+        try {
+          this->implementation->IdleBlocks[byteCount].push_back(memory);
+          this->implementation->Statistics.PooledByteCount = pooledByteCount;
+          return;
+        }
+        catch(const std::bad_alloc &) {
+          // Could not grow the pool, free the memory block instead
+        }
+      }
+
+      this->implementation->Statistics.ResidentByteCount -= byteCount;
+    }
+
+    delete[] static_cast<std::uint8_t *>(memory);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PooledBitmapAllocator::Trim() {
+    std::lock_guard<std::mutex> poolLock(this->implementation->Mutex);
+    this->implementation->FreeIdleBlocks();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PooledBitmapAllocator::Statistics PooledBitmapAllocator::GetStatistics() const {
+    std::lock_guard<std::mutex> poolLock(this->implementation->Mutex);
+    return this->implementation->Statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,92 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/RowStream.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TransferRows(RowSource &source, RowSink &sink) {
+    std::size_t width = source.GetWidth();
+    std::size_t height = source.GetHeight();
+    if((sink.GetWidth() != width) || (sink.GetHeight() != height)) {
+      throw std::runtime_error(u8"Row source and row sink do not have the same dimensions");
+    }
+
+    PixelFormat sourcePixelFormat = source.GetPixelFormat();
+    PixelFormat sinkPixelFormat = sink.GetPixelFormat();
+    bool needsConversion = (sourcePixelFormat != sinkPixelFormat);
+
+    std::size_t sourceRowByteCount = CountRequiredBytes(sourcePixelFormat, width);
+    std::size_t sinkRowByteCount = CountRequiredBytes(sinkPixelFormat, width);
+    if((height == 0) || (std::max(sourceRowByteCount, sinkRowByteCount) == 0)) {
+      return;
+    }
+
+    // One band of rows is read from the source at a time and, if the pixel formats
+    // differ, converted into a second band before it is handed to the sink
+    std::size_t bandHeight = std::min(
+      GetBandHeight(std::max(sourceRowByteCount, sinkRowByteCount)), height
+    );
+    std::vector<std::uint8_t> sourceBuffer(sourceRowByteCount * bandHeight);
+    std::vector<std::uint8_t> sinkBuffer;
+    if(needsConversion) {
+      sinkBuffer.resize(sinkRowByteCount * bandHeight);
+    }
+
+    BitmapMemory sourceBand;
+    sourceBand.Width = width;
+    sourceBand.PixelFormat = sourcePixelFormat;
+    sourceBand.Stride = static_cast<int>(sourceRowByteCount);
+    sourceBand.Pixels = sourceBuffer.data();
+
+    BitmapMemory sinkBand;
+    sinkBand.Width = width;
+    sinkBand.PixelFormat = sinkPixelFormat;
+    sinkBand.Stride = static_cast<int>(sinkRowByteCount);
+    sinkBand.Pixels = sinkBuffer.data();
+
+    for(std::size_t y = 0; y < height; y += bandHeight) {
+      sourceBand.Height = std::min(bandHeight, height - y);
+      source.ReadRows(sourceBand);
+
+      if(needsConversion) {
+        sinkBand.Height = sourceBand.Height;
+        PixelFormatConverter::Convert(sourceBand, sinkBand);
+        sink.WriteRows(sinkBand);
+      } else {
+        sink.WriteRows(sourceBand);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
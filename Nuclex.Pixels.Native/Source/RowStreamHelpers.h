@@ -0,0 +1,55 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_ROWSTREAMHELPERS_H
+#define NUCLEX_PIXELS_ROWSTREAMHELPERS_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/BitmapMemory.h"
+
+#include <cstddef>
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that rows handed to a row source or row sink fit it</summary>
+  /// <param name="rows">Rows that will be read or written</param>
+  /// <param name="width">Width of the rows the row source or row sink works with</param>
+  /// <param name="pixelFormat">Pixel format the row source or row sink works with</param>
+  /// <param name="remainingRowCount">Number of rows that have not been processed yet</param>
+  inline void RequireFittingRows(
+    const BitmapMemory &rows, std::size_t width, PixelFormat pixelFormat,
+    std::size_t remainingRowCount
+  ) {
+    if((rows.Width != width) || (rows.PixelFormat != pixelFormat)) {
+      throw std::runtime_error(u8"Rows do not match the width and pixel format of the stream");
+    }
+    if(rows.Height > remainingRowCount) {
+      throw std::runtime_error(u8"Row stream does not have that many rows remaining");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_ROWSTREAMHELPERS_H
@@ -0,0 +1,50 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/AnimationReader.h"
+
+#include <stdexcept> // for std::out_of_range
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t AnimationReader::FindKeyFrame(std::size_t frameIndex) const {
+    if(frameIndex >= CountFrames()) {
+      throw std::out_of_range(u8"Frame index lies outside of the animation");
+    }
+
+    // The first frame is always a key frame, so this ends there at the latest
+    while(frameIndex > 0) {
+      if(GetFrameInfo(frameIndex).IsKeyFrame) {
+        break;
+      }
+      --frameIndex;
+    }
+
+    return frameIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
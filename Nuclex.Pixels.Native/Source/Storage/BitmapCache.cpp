@@ -0,0 +1,324 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/BitmapCache.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Storage/OptionalBitmap.h"
+
+#include <cstdint> // for std::uint64_t
+#include <list> // for std::list
+#include <mutex> // for std::mutex
+#include <string> // for std::to_string()
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+// The Windows helpers for converting paths to UTF-16 are shared with the RealFile
+// implementation. They check for its header to be included first.
+#if defined(NUCLEX_PIXELS_WIN32)
+#include "RealFile.h"
+#include "RealFile.Windows.inl"
+#else
+#include <sys/stat.h> // stat()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends the load options that change the decoded pixels to a cache key</summary>
+  /// <param name="key">Key to which the load options will be appended</param>
+  /// <param name="options">Load options that will be appended</param>
+  /// <remarks>
+  ///   Options that only affect how the file is read (such as the read-ahead buffer) are
+  ///   left out, so a bitmap loaded with different settings of those is still a hit.
+  /// </remarks>
+  void appendLoadOptions(std::string &key, const Nuclex::Pixels::Storage::LoadOptions &options) {
+    key.push_back('\0');
+    key.append(std::to_string(static_cast<int>(options.Jpeg.Scale)));
+    key.push_back(':');
+    key.append(std::to_string(options.Region.MinX));
+    key.push_back(',');
+    key.append(std::to_string(options.Region.MinY));
+    key.push_back(',');
+    key.append(std::to_string(options.Region.MaxX));
+    key.push_back(',');
+    key.append(std::to_string(options.Region.MaxY));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the size and last modification time of a file</summary>
+  /// <param name="path">Path of the file that will be looked up</param>
+  /// <param name="size">Receives the size of the file in bytes</param>
+  /// <param name="modificationTime">Receives the time the file was last written to</param>
+  /// <returns>True if the file was found, false otherwise</returns>
+  bool tryGetFileStamp(
+    const std::string &path, std::uint64_t &size, std::uint64_t &modificationTime
+  ) {
+#if defined(NUCLEX_PIXELS_WIN32)
+    std::vector<wchar_t> utf16Path;
+    {
+      utf8ToUtf16Path(path, utf16Path);
+      utf16Path.push_back(0);
+    }
+
+    ::WIN32_FILE_ATTRIBUTE_DATA attributes;
+    BOOL result = ::GetFileAttributesExW(&utf16Path[0], ::GetFileExInfoStandard, &attributes);
+    if(result == FALSE) {
+      return false;
+    }
+
+    size = (
+      (static_cast<std::uint64_t>(attributes.nFileSizeHigh) << 32) |
+      static_cast<std::uint64_t>(attributes.nFileSizeLow)
+    );
+    modificationTime = (
+      (static_cast<std::uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+      static_cast<std::uint64_t>(attributes.ftLastWriteTime.dwLowDateTime)
+    );
+#else
+    struct stat fileStatus;
+    int failed = ::stat(path.c_str(), &fileStatus);
+    if(failed) {
+      return false;
+    }
+
+    size = static_cast<std::uint64_t>(fileStatus.st_size);
+#if defined(NUCLEX_PIXELS_LINUX)
+    modificationTime = (
+      static_cast<std::uint64_t>(fileStatus.st_mtim.tv_sec) * 1000000000ULL +
+      static_cast<std::uint64_t>(fileStatus.st_mtim.tv_nsec)
+    );
+#else
+    modificationTime = static_cast<std::uint64_t>(fileStatus.st_mtime);
+#endif
+#endif
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Bitmap stored in the cache together with the key it was stored under</summary>
+  struct CacheEntry {
+
+    /// <summary>Key under which the bitmap has been stored</summary>
+    public: std::string Key;
+    /// <summary>Cached bitmap, sharing its pixels with all bitmaps handed out for it</summary>
+    public: Nuclex::Pixels::Bitmap Bitmap;
+    /// <summary>Number of bytes occupied by the bitmap's pixels</summary>
+    public: std::size_t ByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct BitmapCache::Implementation {
+
+    /// <summary>Initializes a new bitmap cache implementation</summary>
+    /// <param name="serializer">Serializer that will be used to load the bitmaps</param>
+    /// <param name="maximumByteCount">
+    ///   Maximum number of bytes the pixels of all cached bitmaps may add up to
+    /// </param>
+    public: Implementation(const BitmapSerializer &serializer, std::size_t maximumByteCount) :
+      Serializer(serializer),
+      MaximumByteCount(maximumByteCount) {
+      this->Statistics.HitCount = 0;
+      this->Statistics.MissCount = 0;
+      this->Statistics.CachedBitmapCount = 0;
+      this->Statistics.CachedByteCount = 0;
+    }
+
+    /// <summary>Looks up a cached bitmap and marks it as the most recently used</summary>
+    /// <param name="key">Key under which the bitmap has been stored</param>
+    /// <param name="bitmap">Receives the cached bitmap if it was found</param>
+    /// <returns>True if the bitmap was cached, false otherwise</returns>
+    public: bool TryGet(const std::string &key, OptionalBitmap &bitmap) {
+      std::lock_guard<std::mutex> cacheLock(this->Mutex);
+
+      EntryMap::iterator iterator = this->EntriesByKey.find(key);
+      if(iterator == this->EntriesByKey.end()) {
+        ++this->Statistics.MissCount;
+        return false;
+      }
+
+      this->Entries.splice(this->Entries.begin(), this->Entries, iterator->second);
+      ++this->Statistics.HitCount;
+
+      // Copying a bitmap would copy its pixels, but a view spanning the whole bitmap
+      // only adds a reference to the shared buffer
+      Bitmap &cachedBitmap = iterator->second->Bitmap;
+      bitmap = OptionalBitmap(
+        cachedBitmap.GetView(0, 0, cachedBitmap.GetWidth(), cachedBitmap.GetHeight())
+      );
+      return true;
+    }
+
+    /// <summary>Stores a freshly loaded bitmap in the cache</summary>
+    /// <param name="key">Key under which the bitmap will be stored</param>
+    /// <param name="bitmap">Bitmap that will share its pixels with the cache</param>
+    public: void Add(const std::string &key, Bitmap &bitmap) {
+      const BitmapMemory &memory = bitmap.Access();
+      std::size_t byteCount = static_cast<std::size_t>(
+        (memory.Stride < 0) ? -memory.Stride : memory.Stride
+      ) * memory.Height;
+
+      // A bitmap that exceeds the whole budget would only flush the cache
+      if(byteCount > this->MaximumByteCount) {
+        return;
+      }
+
+      std::lock_guard<std::mutex> cacheLock(this->Mutex);
+
+      // Another thread may have loaded the same file in the meantime
+      if(this->EntriesByKey.find(key) != this->EntriesByKey.end()) {
+        return;
+      }
+
+      // Drop the least recently used bitmaps until the new bitmap fits
+      while(this->Statistics.CachedByteCount + byteCount > this->MaximumByteCount) {
+        this->Statistics.CachedByteCount -= this->Entries.back().ByteCount;
+        --this->Statistics.CachedBitmapCount;
+        this->EntriesByKey.erase(this->Entries.back().Key);
+        this->Entries.pop_back();
+      }
+
+      this->Entries.push_front(
+        CacheEntry {
+          key, bitmap.GetView(0, 0, bitmap.GetWidth(), bitmap.GetHeight()), byteCount
+        }
+      );
+      this->EntriesByKey.insert(EntryMap::value_type(key, this->Entries.begin()));
+      this->Statistics.CachedByteCount += byteCount;
+      ++this->Statistics.CachedBitmapCount;
+    }
+
+    /// <summary>List of cached bitmaps, ordered from most to least recently used</summary>
+    private: typedef std::list<CacheEntry> EntryList;
+    /// <summary>Maps the keys to the cached bitmaps</summary>
+    private: typedef std::unordered_map<std::string, EntryList::iterator> EntryMap;
+
+    /// <summary>Serializer that will be used to load the bitmaps</summary>
+    public: const BitmapSerializer &Serializer;
+    /// <summary>Maximum number of bytes the pixels of all cached bitmaps may add up to</summary>
+    public: std::size_t MaximumByteCount;
+    /// <summary>Protects the cached bitmaps and the statistics</summary>
+    public: mutable std::mutex Mutex;
+    /// <summary>Cached bitmaps, ordered from most to least recently used</summary>
+    public: EntryList Entries;
+    /// <summary>Allows cached bitmaps to be found by their key</summary>
+    public: EntryMap EntriesByKey;
+    /// <summary>Statistics about the bitmaps held by the cache</summary>
+    public: BitmapCache::Statistics Statistics;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapCache::BitmapCache(
+    const BitmapSerializer &serializer, std::size_t maximumByteCount /* = 256 * 1024 * 1024 */
+  ) :
+    implementation(new Implementation(serializer, maximumByteCount)) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapCache::~BitmapCache() {
+    delete this->implementation;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Bitmap BitmapCache::Load(
+    const std::string &path, const LoadOptions &options /* = LoadOptions() */
+  ) {
+    std::uint64_t size, modificationTime;
+
+    // If the file can't be looked up, let the serializer report the error
+    if(!tryGetFileStamp(path, size, modificationTime)) {
+      return this->implementation->Serializer.Load(path, options);
+    }
+
+    std::string key(path);
+    key.push_back('\0');
+    key.append(std::to_string(size));
+    key.push_back(':');
+    key.append(std::to_string(modificationTime));
+    appendLoadOptions(key, options);
+
+    OptionalBitmap cachedBitmap;
+    if(this->implementation->TryGet(key, cachedBitmap)) {
+      return cachedBitmap.Take();
+    }
+
+    Bitmap bitmap = this->implementation->Serializer.Load(path, options);
+    this->implementation->Add(key, bitmap);
+    return bitmap;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Bitmap BitmapCache::Load(
+    const std::string &key, const VirtualFile &file,
+    const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) {
+    std::string fullKey(key);
+    appendLoadOptions(fullKey, options);
+
+    OptionalBitmap cachedBitmap;
+    if(this->implementation->TryGet(fullKey, cachedBitmap)) {
+      return cachedBitmap.Take();
+    }
+
+    Bitmap bitmap = this->implementation->Serializer.Load(file, extensionHint, options);
+    this->implementation->Add(fullKey, bitmap);
+    return bitmap;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapCache::Clear() {
+    std::lock_guard<std::mutex> cacheLock(this->implementation->Mutex);
+
+    this->implementation->EntriesByKey.clear();
+    this->implementation->Entries.clear();
+    this->implementation->Statistics.CachedBitmapCount = 0;
+    this->implementation->Statistics.CachedByteCount = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapCache::Statistics BitmapCache::GetStatistics() const {
+    std::lock_guard<std::mutex> cacheLock(this->implementation->Mutex);
+    return this->implementation->Statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -23,9 +23,65 @@ License along with this library
 
 #include "Nuclex/Pixels/Storage/BitmapCodec.h"
 
-// --------------------------------------------------------------------------------------------- //
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::invalid_argument
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+namespace Nuclex { namespace Pixels { namespace Storage {
 
-// --------------------------------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
+
+  Rectangle BitmapCodec::GetLoadRegion(
+    const LoadOptions &options, std::size_t imageWidth, std::size_t imageHeight
+  ) {
+    const Rectangle &region = options.Region;
+    if((region.MaxX <= region.MinX) || (region.MaxY <= region.MinY)) {
+      return Rectangle(0, 0, imageWidth, imageHeight); // Empty region, load the whole image
+    }
+
+    std::size_t maxX = std::min(region.MaxX, imageWidth);
+    std::size_t maxY = std::min(region.MaxY, imageHeight);
+    if((region.MinX >= maxX) || (region.MinY >= maxY)) {
+      throw std::invalid_argument(u8"Region to load lies outside of the image");
+    }
+
+    return Rectangle(region.MinX, region.MinY, maxX, maxY);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BitmapCodec::MightHaveFileExtension(
+    const std::string &extensionHint, const std::vector<std::string> &knownFileExtensions
+  ) {
+    if(extensionHint.empty()) {
+      return true; // No extension provided, so it can't rule anything out
+    }
+
+    std::size_t start = (extensionHint[0] == '.') ? 1 : 0;
+    for(std::size_t index = 0; index < knownFileExtensions.size(); ++index) {
+      const std::string &extension = knownFileExtensions[index];
+      if(extensionHint.length() - start != extension.length()) {
+        continue;
+      }
+
+      bool matches = true;
+      for(std::size_t characterIndex = 0; characterIndex < extension.length(); ++characterIndex) {
+        char character = extensionHint[start + characterIndex];
+        if((character >= 'A') && (character <= 'Z')) {
+          character = static_cast<char>(character - 'A' + 'a');
+        }
+        if(character != extension[characterIndex]) {
+          matches = false;
+          break;
+        }
+      }
+      if(matches) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -27,6 +27,12 @@ License along with this library
 #include "Nuclex/Pixels/Errors/FileFormatError.h"
 
 #include "Utf8Fold/Utf8Fold.h"
+#include "WriteBufferedVirtualFile.h"
+#include "../InstrumentationHelpers.h"
+
+#include <algorithm> // for std::min()
+#include <cmath> // for std::ceil()
+#include <stdexcept> // for std::invalid_argument
 
 #if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
 #include "Png/PngBitmapCodec.h"
@@ -37,6 +43,16 @@ License along with this library
 #if defined(NUCLEX_PIXELS_HAVE_OPENEXR)
 #include "Exr/ExrBitmapCodec.h"
 #endif
+#if defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+#include "WebP/WebPBitmapCodec.h"
+#endif
+#include "Dds/DdsBitmapCodec.h"
+#include "Ktx/Ktx2BitmapCodec.h"
+#include "Qoi/QoiBitmapCodec.h"
+#include "Bmp/BmpBitmapCodec.h"
+#include "Netpbm/PnmBitmapCodec.h"
+#include "Netpbm/PfmBitmapCodec.h"
+#include "Tga/TgaBitmapCodec.h"
 
 namespace {
 
@@ -45,6 +61,104 @@ namespace {
   /// <summary>Invalid size marker for the most recent codec indices</summary>
   constexpr std::size_t InvalidIndex = std::size_t(-1);
 
+  /// <summary>Value of the packed most recent codec indices when no codec was used yet</summary>
+  constexpr std::uint64_t NoRecentCodecIndices = std::uint64_t(-1);
+
+  /// <summary>Marks an unused slot in the packed most recent codec indices</summary>
+  constexpr std::uint32_t InvalidPackedIndex = std::uint32_t(-1);
+
+  /// <summary>Number of bytes collected before they are written when saving to a path</summary>
+  constexpr std::size_t SaveWriteBufferByteCount = 1048576;
+
+  /// <summary>Number of buckets load and save times are sorted into</summary>
+  constexpr std::size_t TimeBucketCount = 256;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extracts a codec index from the packed most recent codec indices</summary>
+  /// <param name="packedIndices">Packed indices the codec index will be extracted from</param>
+  /// <param name="shift">Bit offset of the codec index within the packed indices</param>
+  /// <returns>The codec index or InvalidIndex if the slot is unused</returns>
+  std::size_t unpackCodecIndex(std::uint64_t packedIndices, int shift) {
+    std::uint32_t index = static_cast<std::uint32_t>(packedIndices >> shift);
+    if(index == InvalidPackedIndex) {
+      return InvalidIndex;
+    } else {
+      return static_cast<std::size_t>(index);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the bucket a time in microseconds is counted in</summary>
+  /// <param name="microseconds">Time whose bucket will be determined</param>
+  /// <returns>The index of the bucket counting the time</returns>
+  /// <remarks>
+  ///   Times below 8 have a bucket each, above that each power of two is split into
+  ///   four buckets, so a bucket's upper bound is at most 25% larger than its lower one.
+  /// </remarks>
+  std::size_t getTimeBucketIndex(std::uint64_t microseconds) {
+    if(microseconds < 8) {
+      return static_cast<std::size_t>(microseconds);
+    }
+
+    std::size_t bitCount = 0;
+    for(std::uint64_t remaining = microseconds; remaining != 0; remaining >>= 1) {
+      ++bitCount;
+    }
+
+    std::size_t quarter = static_cast<std::size_t>(microseconds >> (bitCount - 3)) & 3;
+    return (bitCount - 2) * 4 + quarter;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the largest time that is counted in a bucket</summary>
+  /// <param name="bucketIndex">Index of the bucket whose upper bound will be calculated</param>
+  /// <returns>The largest time in microseconds that falls into the bucket</returns>
+  std::uint64_t getTimeBucketUpperBound(std::size_t bucketIndex) {
+    if(bucketIndex < 8) {
+      return static_cast<std::uint64_t>(bucketIndex);
+    }
+
+    std::size_t shift = bucketIndex / 4 - 1;
+    std::uint64_t lowerBound = static_cast<std::uint64_t>(4 + bucketIndex % 4) << shift;
+    return lowerBound + ((std::uint64_t(1) << shift) - 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Estimates the time a given fraction of the recorded times stays below</summary>
+  /// <param name="buckets">Buckets into which the times have been counted</param>
+  /// <param name="fraction">Fraction of the times that should stay below the result</param>
+  /// <returns>The estimated time in microseconds, zero if no times were recorded</returns>
+  std::uint64_t estimatePercentile(
+    const std::atomic<std::uint64_t> (&buckets)[TimeBucketCount], double fraction
+  ) {
+    std::uint64_t counts[TimeBucketCount];
+    std::uint64_t totalCount = 0;
+    for(std::size_t index = 0; index < TimeBucketCount; ++index) {
+      counts[index] = buckets[index].load(std::memory_order_relaxed);
+      totalCount += counts[index];
+    }
+    if(totalCount == 0) {
+      return 0;
+    }
+
+    std::uint64_t targetCount = static_cast<std::uint64_t>(
+      std::ceil(static_cast<double>(totalCount) * fraction)
+    );
+    std::uint64_t runningCount = 0;
+    for(std::size_t index = 0; index < TimeBucketCount; ++index) {
+      runningCount += counts[index];
+      if((runningCount >= targetCount) && (runningCount > 0)) {
+        return getTimeBucketUpperBound(index);
+      }
+    }
+
+    return getTimeBucketUpperBound(TimeBucketCount - 1);
+  }
+
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Helper used to pass information through lambda methods</summary>
@@ -59,19 +173,364 @@ namespace {
     /// <summary>Bitmap into whih the TryLoad() methods will load the pixels</summary>
     public: Nuclex::Pixels::Bitmap *TargetBitmap;
 
+    /// <summary>Settings the codecs should use to read the file</summary>
+    public: const Nuclex::Pixels::Storage::LoadOptions *Options;
+
+    /// <summary>Receives the codec that was able to load the file</summary>
+    public: const Nuclex::Pixels::Storage::BitmapCodec *Codec;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Helper used to pass information through lambda methods</summary>
+  struct FileAndInfo {
+
+    /// <summary>File the bitmap serializer has been tasked with identifying</summary>
+    public: const Nuclex::Pixels::Storage::VirtualFile *File;
+
+    /// <summary>Settings the codecs should use to read the file</summary>
+    public: const Nuclex::Pixels::Storage::LoadOptions *Options;
+
+    /// <summary>Receives the informations read from the file if successful</summary>
+    public: Nuclex::Pixels::BitmapInfo Info;
+
+    /// <summary>Receives the codec that was able to read the file</summary>
+    public: const Nuclex::Pixels::Storage::BitmapCodec *Codec;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lets a codec try to read the informations about a bitmap</summary>
+  /// <param name="codec">Codec that will try to read the informations</param>
+  /// <param name="extension">File extension the file had, if known</param>
+  /// <param name="fileAndInfo">File that will be read and receiver for the results</param>
+  /// <returns>True if the codec was able to read the informations</returns>
+  bool tryReadInfo(
+    const Nuclex::Pixels::Storage::BitmapCodec &codec, const std::string &extension,
+    FileAndInfo &fileAndInfo
+  ) {
+    Nuclex::Pixels::BitmapInfo info = codec.TryReadInfo(
+      *fileAndInfo.File, extension, *fileAndInfo.Options
+    );
+    if(info.Loadable) {
+      fileAndInfo.Info = info;
+      fileAndInfo.Codec = &codec;
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a file on disk so its image can be loaded from it</summary>
+  /// <param name="path">Path of the file that will be opened</param>
+  /// <param name="options">Load options specifying the read-ahead window</param>
+  /// <returns>The opened file, with a read-ahead buffer if enabled</returns>
+  std::unique_ptr<const Nuclex::Pixels::Storage::VirtualFile> openFileForLoading(
+    const std::string &path, const Nuclex::Pixels::Storage::LoadOptions &options
+  ) {
+    using Nuclex::Pixels::Storage::VirtualFile;
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path, true);
+    if(options.ReadAheadByteCount == 0) {
+      return file;
+    } else {
+      return VirtualFile::AddReadAheadBuffer(std::move(file), options.ReadAheadByteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Helper used to pass information through lambda methods</summary>
+  struct FileAndRowSource {
+
+    /// <summary>File the bitmap serializer has been tasked with streaming</summary>
+    public: const Nuclex::Pixels::Storage::VirtualFile *File;
+
+    /// <summary>Settings the codecs should use to read the file</summary>
+    public: const Nuclex::Pixels::Storage::LoadOptions *Options;
+
+    /// <summary>Receives the row source opened on the file if successful</summary>
+    public: std::unique_ptr<Nuclex::Pixels::RowSource> RowSource;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row source that keeps the file it is reading from alive</summary>
+  class FileOwningRowSource : public Nuclex::Pixels::RowSource {
+
+    /// <summary>Initializes a new row source owning the file it is reading from</summary>
+    /// <param name="file">File the row source is reading from</param>
+    /// <param name="rowSource">Row source provided by the codec</param>
+    public: FileOwningRowSource(
+      std::unique_ptr<const Nuclex::Pixels::Storage::VirtualFile> &&file,
+      std::unique_ptr<Nuclex::Pixels::RowSource> &&rowSource
+    ) :
+      file(std::move(file)),
+      rowSource(std::move(rowSource)) {}
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->rowSource->GetWidth(); }
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: std::size_t GetHeight() const override { return this->rowSource->GetHeight(); }
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->rowSource->GetPixelFormat();
+    }
+
+    /// <summary>Reads the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory that will receive the rows</param>
+    public: void ReadRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      this->rowSource->ReadRows(rows);
+    }
+
+    /// <summary>File the row source is reading from</summary>
+    private: std::unique_ptr<const Nuclex::Pixels::Storage::VirtualFile> file;
+    /// <summary>Row source provided by the codec, destroyed before the file</summary>
+    private: std::unique_ptr<Nuclex::Pixels::RowSource> rowSource;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Helper used to pass information through lambda methods</summary>
+  struct FileAndAnimationReader {
+
+    /// <summary>File the bitmap serializer has been tasked with animating</summary>
+    public: const Nuclex::Pixels::Storage::VirtualFile *File;
+
+    /// <summary>Settings the codecs should use to read the file</summary>
+    public: const Nuclex::Pixels::Storage::LoadOptions *Options;
+
+    /// <summary>Receives the animation reader opened on the file if successful</summary>
+    public: std::unique_ptr<Nuclex::Pixels::Storage::AnimationReader> AnimationReader;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Animation reader that keeps the file it is reading from alive</summary>
+  class FileOwningAnimationReader : public Nuclex::Pixels::Storage::AnimationReader {
+
+    /// <summary>Initializes a new animation reader owning the file it is reading from</summary>
+    /// <param name="file">File the animation reader is reading from</param>
+    /// <param name="animationReader">Animation reader provided by the codec</param>
+    public: FileOwningAnimationReader(
+      std::unique_ptr<const Nuclex::Pixels::Storage::VirtualFile> &&file,
+      std::unique_ptr<Nuclex::Pixels::Storage::AnimationReader> &&animationReader
+    ) :
+      file(std::move(file)),
+      animationReader(std::move(animationReader)) {}
+
+    /// <summary>Retrieves the width of the animation's canvas</summary>
+    /// <returns>The width of the bitmaps the frames are decoded into</returns>
+    public: std::size_t GetWidth() const override { return this->animationReader->GetWidth(); }
+
+    /// <summary>Retrieves the height of the animation's canvas</summary>
+    /// <returns>The height of the bitmaps the frames are decoded into</returns>
+    public: std::size_t GetHeight() const override {
+      return this->animationReader->GetHeight();
+    }
+
+    /// <summary>Retrieves the pixel format the frames are decoded in</summary>
+    /// <returns>The pixel format of the bitmaps the frames are decoded into</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->animationReader->GetPixelFormat();
+    }
+
+    /// <summary>Counts the number of frames in the animation</summary>
+    /// <returns>The number of frames the animation consists of</returns>
+    public: std::size_t CountFrames() const override {
+      return this->animationReader->CountFrames();
+    }
+
+    /// <summary>Retrieves how often the animation should be played</summary>
+    /// <returns>The number of times the animation is played or 0 to loop forever</returns>
+    public: std::size_t GetLoopCount() const override {
+      return this->animationReader->GetLoopCount();
+    }
+
+    /// <summary>Retrieves informations about a frame of the animation</summary>
+    /// <param name="frameIndex">Index of the frame whose informations will be returned</param>
+    /// <returns>The region, duration and key frame flag of the frame</returns>
+    public: const Nuclex::Pixels::Storage::AnimationFrameInfo &GetFrameInfo(
+      std::size_t frameIndex
+    ) const override {
+      return this->animationReader->GetFrameInfo(frameIndex);
+    }
+
+    /// <summary>Decodes a frame of the animation into an existing bitmap</summary>
+    /// <param name="exactlyFittingBitmap">Bitmap matching the animation's canvas</param>
+    /// <param name="frameIndex">Index of the frame that will be decoded</param>
+    public: void ReloadFrame(
+      Nuclex::Pixels::Bitmap &exactlyFittingBitmap, std::size_t frameIndex
+    ) override {
+      this->animationReader->ReloadFrame(exactlyFittingBitmap, frameIndex);
+    }
+
+    /// <summary>File the animation reader is reading from</summary>
+    private: std::unique_ptr<const Nuclex::Pixels::Storage::VirtualFile> file;
+    /// <summary>Animation reader provided by the codec, destroyed before the file</summary>
+    private: std::unique_ptr<Nuclex::Pixels::Storage::AnimationReader> animationReader;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row sink that keeps the file it is writing into alive</summary>
+  class FileOwningRowSink : public Nuclex::Pixels::RowSink {
+
+    /// <summary>Initializes a new row sink owning the file it is writing into</summary>
+    /// <param name="file">File the row sink is writing into</param>
+    /// <param name="rowSink">Row sink provided by the codec</param>
+    public: FileOwningRowSink(
+      std::unique_ptr<Nuclex::Pixels::Storage::VirtualFile> &&file,
+      std::unique_ptr<Nuclex::Pixels::RowSink> &&rowSink
+    ) :
+      file(std::move(file)),
+      rowSink(std::move(rowSink)) {}
+
+    /// <summary>Retrieves the width of the rows the row sink accepts</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->rowSink->GetWidth(); }
+
+    /// <summary>Retrieves the number of rows the row sink accepts in total</summary>
+    /// <returns>The height of the image written into the row sink</returns>
+    public: std::size_t GetHeight() const override { return this->rowSink->GetHeight(); }
+
+    /// <summary>Retrieves the pixel format the row sink accepts rows in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->rowSink->GetPixelFormat();
+    }
+
+    /// <summary>Writes the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory holding the rows</param>
+    public: void WriteRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      this->rowSink->WriteRows(rows);
+    }
+
+    /// <summary>File the row sink is writing into</summary>
+    private: std::unique_ptr<Nuclex::Pixels::Storage::VirtualFile> file;
+    /// <summary>Row sink provided by the codec, destroyed before the file</summary>
+    private: std::unique_ptr<Nuclex::Pixels::RowSink> rowSink;
+
   };
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Extracts the file extension from a path</summary>
+  /// <param name="path">Path whose file extension will be extracted</param>
+  /// <returns>The file extension without the dot or an empty string if there is none</returns>
+  std::string getFileExtension(const std::string &path) {
+    std::string::size_type extensionDotIndex = path.find_last_of('.');
+#if defined(NUCLEX_PIXELS_WIN32)
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of('\\');
+#else
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of('/');
+#endif
+
+    if(extensionDotIndex != std::string::npos) {
+      bool dotBelongsToFilename = (
+        (lastPathSeparatorIndex == std::string::npos) ||
+        (extensionDotIndex > lastPathSeparatorIndex)
+      );
+      if(dotBelongsToFilename) {
+        return path.substr(extensionDotIndex + 1);
+      }
+    }
+
+    return std::string();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that externally provided memory can hold a bitmap</summary>
+  /// <param name="memory">Description of the memory that will be checked</param>
+  /// <remarks>
+  ///   The codecs check the size and pixel format against the image, but they trust
+  ///   the address and stride, so those are verified before decoding into them.
+  /// </remarks>
+  void requireUsableMemory(const Nuclex::Pixels::BitmapMemory &memory) {
+    if(memory.Pixels == nullptr) {
+      throw std::invalid_argument(u8"Memory to load the bitmap into has no address");
+    }
+
+    std::size_t absoluteStride = static_cast<std::size_t>(
+      (memory.Stride < 0) ? -memory.Stride : memory.Stride
+    );
+    std::size_t minimumStride = static_cast<std::size_t>(
+      Nuclex::Pixels::Bitmap::CalculateStride(memory.Width, memory.PixelFormat)
+    );
+    if((memory.Height > 1) && (absoluteStride < minimumStride)) {
+      throw std::invalid_argument(
+        u8"Stride of the memory to load the bitmap into is too short for its width"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Pixels { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  struct BitmapSerializer::CodecCounters {
+
+    /// <summary>Number of times the codec was tried on a file</summary>
+    public: std::atomic<std::uint64_t> ProbeCount;
+    /// <summary>Number of tries in which the codec rejected the file header</summary>
+    public: std::atomic<std::uint64_t> HeaderRejectionCount;
+    /// <summary>Number of tries in which the codec read the file</summary>
+    public: std::atomic<std::uint64_t> HitCount;
+    /// <summary>Number of tries in which the codec threw an exception</summary>
+    public: std::atomic<std::uint64_t> FailureCount;
+    /// <summary>Total size of the files the codec has loaded bitmaps from</summary>
+    public: std::atomic<std::uint64_t> LoadedByteCount;
+    /// <summary>Number of saves in which the codec threw an exception</summary>
+    public: std::atomic<std::uint64_t> SaveFailureCount;
+    /// <summary>Number of loads that took the time range of each bucket</summary>
+    public: std::atomic<std::uint64_t> LoadTimeBuckets[TimeBucketCount];
+    /// <summary>Number of saves that took the time range of each bucket</summary>
+    public: std::atomic<std::uint64_t> SaveTimeBuckets[TimeBucketCount];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct BitmapSerializer::Counters {
+
+    /// <summary>Number of files read by the codec the extension hint pointed to</summary>
+    public: std::atomic<std::uint64_t> HintHitCount;
+    /// <summary>Number of files read by the most recently used codec</summary>
+    public: std::atomic<std::uint64_t> MostRecentHitCount;
+    /// <summary>Number of files read by the second most recently used codec</summary>
+    public: std::atomic<std::uint64_t> SecondMostRecentHitCount;
+    /// <summary>Number of files for which all codecs had to be tried</summary>
+    public: std::atomic<std::uint64_t> ScanHitCount;
+    /// <summary>Number of files no codec could read</summary>
+    public: std::atomic<std::uint64_t> MissCount;
+    /// <summary>Counters for each codec, in the same order as the codecs</summary>
+    public: std::vector<std::unique_ptr<CodecCounters>> Codecs;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   BitmapSerializer::BitmapSerializer() :
-    mostRecentCodecIndex(InvalidIndex),
-    secondMostRecentCodecIndex(InvalidIndex) {
+    mostRecentCodecIndices(NoRecentCodecIndices),
+    counters(new Counters()) {
 #if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
     RegisterCodec(std::make_unique<Png::PngBitmapCodec>());
 #endif
@@ -81,6 +540,16 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 #if defined(NUCLEX_PIXELS_HAVE_OPENEXR)
     RegisterCodec(std::make_unique<Exr::ExrBitmapCodec>());
 #endif
+#if defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+    RegisterCodec(std::make_unique<WebP::WebPBitmapCodec>());
+#endif
+    RegisterCodec(std::make_unique<Dds::DdsBitmapCodec>());
+    RegisterCodec(std::make_unique<Ktx::Ktx2BitmapCodec>());
+    RegisterCodec(std::make_unique<Qoi::QoiBitmapCodec>());
+    RegisterCodec(std::make_unique<Bmp::BmpBitmapCodec>());
+    RegisterCodec(std::make_unique<Netpbm::PnmBitmapCodec>());
+    RegisterCodec(std::make_unique<Netpbm::PfmBitmapCodec>());
+    RegisterCodec(std::make_unique<Tga::TgaBitmapCodec>()); // No signature, keep it last
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -108,8 +577,12 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
     const std::vector<std::string> &extensions = codec->GetFileExtensions();
 
-    // Register the new codec into our list
+    // Register the new codec into our list. Value-initialization zeroes the counters
+    // and the reserve() ensures both lists end up with the same number of entries.
+    std::unique_ptr<CodecCounters> codecCounters(new CodecCounters());
+    this->counters->Codecs.reserve(codecCount + 1);
     this->codecs.push_back(std::move(codec));
+    this->counters->Codecs.push_back(std::move(codecCounters));
 
     // Update the extension lookup map for quick codec finding
     std::size_t extensionCount = extensions.size();
@@ -144,7 +617,7 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     fileProvider.File = &file;
 
     return tryCodecsInOptimalOrder<FileAndBitmap>(
-      extensionHint,
+      file, extensionHint,
       [](const BitmapCodec &codec, const std::string &extension, FileAndBitmap &fileAndBitmap) {
         return codec.CanLoad(*fileAndBitmap.File, extension);
       },
@@ -184,18 +657,162 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  BitmapInfo BitmapSerializer::TryReadInfo(
+    const VirtualFile &file, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    FileAndInfo fileProvider;
+    fileProvider.File = &file;
+    fileProvider.Options = &options;
+    fileProvider.Info.Loadable = false;
+    fileProvider.Codec = nullptr;
+
+    bool wasRead = tryCodecsInOptimalOrder<FileAndInfo>(
+      file, extensionHint,
+      &tryReadInfo,
+      fileProvider
+    );
+    if(wasRead) {
+      return fileProvider.Info;
+    } else {
+      BitmapInfo info;
+      info.Loadable = false;
+      info.Width = 0;
+      info.Height = 0;
+      info.PixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned;
+      info.MemoryUsage = 0;
+      return info;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapInfo BitmapSerializer::TryReadInfo(
+    const std::string &path, const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    std::string::size_type extensionDotIndex = path.find_last_of('.');
+#if defined(NUCLEX_PIXELS_WIN32)
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of('\\');
+#else
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of('/');
+#endif
+
+    // Check if the provided path contains a file extension and if so, pass it along to
+    // the TryReadInfo() method as a hint (this speeds up codec search)
+    if(extensionDotIndex != std::string::npos) {
+      bool dotBelongsToFilename = (
+        (lastPathSeparatorIndex == std::string::npos) ||
+        (extensionDotIndex > lastPathSeparatorIndex)
+      );
+      if(dotBelongsToFilename) {
+        std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path, true);
+        return TryReadInfo(*file.get(), path.substr(extensionDotIndex + 1), options);
+      }
+    }
+
+    // The specified file has no extension, so do not provide the extension hint
+    {
+      std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path, true);
+      return TryReadInfo(*file.get(), std::string(), options);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LazyBitmap BitmapSerializer::LoadLazily(
+    std::unique_ptr<const VirtualFile> &&file,
+    const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    FileAndInfo fileProvider;
+    fileProvider.File = file.get();
+    fileProvider.Options = &options;
+    fileProvider.Codec = nullptr;
+
+    bool wasRead = tryCodecsInOptimalOrder<FileAndInfo>(
+      *file.get(), extensionHint,
+      &tryReadInfo,
+      fileProvider
+    );
+    if(!wasRead) {
+      throw Errors::FileFormatError("File format not supported by any registered codec");
+    }
+
+    return LazyBitmap(
+      *fileProvider.Codec, fileProvider.Info, std::move(file), extensionHint, options
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LazyBitmap BitmapSerializer::LoadLazily(
+    const std::string &path, const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    std::string extension;
+    {
+      std::string::size_type extensionDotIndex = path.find_last_of('.');
+#if defined(NUCLEX_PIXELS_WIN32)
+      std::string::size_type lastPathSeparatorIndex = path.find_last_of('\\');
+#else
+      std::string::size_type lastPathSeparatorIndex = path.find_last_of('/');
+#endif
+
+      // Check if the provided path contains a file extension and if so, use it
+      // as a hint (this speeds up codec search)
+      if(extensionDotIndex != std::string::npos) {
+        bool dotBelongsToFilename = (
+          (lastPathSeparatorIndex == std::string::npos) ||
+          (extensionDotIndex > lastPathSeparatorIndex)
+        );
+        if(dotBelongsToFilename) {
+          extension = path.substr(extensionDotIndex + 1);
+        }
+      }
+    }
+
+    // Only the header is read, so the file is opened without a read-ahead buffer
+    // and closed again before returning. The lazy bitmap reopens it when needed.
+    FileAndInfo fileProvider;
+    std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path, true);
+    fileProvider.File = file.get();
+    fileProvider.Options = &options;
+    fileProvider.Codec = nullptr;
+
+    bool wasRead = tryCodecsInOptimalOrder<FileAndInfo>(
+      *file.get(), extension,
+      &tryReadInfo,
+      fileProvider
+    );
+    if(!wasRead) {
+      throw Errors::FileFormatError("File format not supported by any registered codec");
+    }
+
+    return LazyBitmap(*fileProvider.Codec, fileProvider.Info, path, extension, options);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   Bitmap BitmapSerializer::Load(
-    const VirtualFile &file, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &file, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.BitmapSerializer.Load");
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
     FileAndBitmap fileProvider;
     fileProvider.File = &file;
+    fileProvider.Options = &options;
 
     bool wasLoaded = tryCodecsInOptimalOrder<FileAndBitmap>(
-      extensionHint,
+      file, extensionHint,
       [](const BitmapCodec &codec, const std::string &extension, FileAndBitmap &fileAndBitmap) {
-        OptionalBitmap loadedBitmap = codec.TryLoad(*fileAndBitmap.File, extension);
+        OptionalBitmap loadedBitmap = codec.TryLoad(
+          *fileAndBitmap.File, extension, *fileAndBitmap.Options
+        );
         if(loadedBitmap.HasValue()) {
           fileAndBitmap.Bitmap = std::move(loadedBitmap);
+          fileAndBitmap.Codec = &codec;
           return true;
         } else {
           return false;
@@ -204,6 +821,7 @@ namespace Nuclex { namespace Pixels { namespace Storage {
       fileProvider
     );
     if(wasLoaded) {
+      recordTransfer(*fileProvider.Codec, startTime, file.GetSize(), false);
       return fileProvider.Bitmap.Take();
     } else {
       throw Errors::FileFormatError("File format not supported by any registered codec");
@@ -212,7 +830,9 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
-  Bitmap BitmapSerializer::Load(const std::string &path) const {
+  Bitmap BitmapSerializer::Load(
+    const std::string &path, const LoadOptions &options /* = LoadOptions() */
+  ) const {
     std::string::size_type extensionDotIndex = path.find_last_of('.');
 #if defined(NUCLEX_PIXELS_WIN32)
     std::string::size_type lastPathSeparatorIndex = path.find_last_of('\\');
@@ -228,15 +848,15 @@ namespace Nuclex { namespace Pixels { namespace Storage {
         (extensionDotIndex > lastPathSeparatorIndex)
       );
       if(dotBelongsToFilename) {
-        std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path, true);
-        return Load(*file.get(), path.substr(extensionDotIndex + 1));
+        std::unique_ptr<const VirtualFile> file = openFileForLoading(path, options);
+        return Load(*file.get(), path.substr(extensionDotIndex + 1), options);
       }
     }
 
     // The specified file has no extension, so do not provide the extension hint
     {
-      std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path, true);
-      return Load(*file.get());
+      std::unique_ptr<const VirtualFile> file = openFileForLoading(path, options);
+      return Load(*file.get(), std::string(), options);
     }
   }
 
@@ -244,16 +864,24 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
   void BitmapSerializer::Reload(
     Bitmap &exactFittingBitmap,
-    const VirtualFile &file, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &file, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
     FileAndBitmap fileProvider;
     fileProvider.File = &file;
     fileProvider.TargetBitmap = &exactFittingBitmap;
+    fileProvider.Options = &options;
 
     bool wasLoaded = tryCodecsInOptimalOrder<FileAndBitmap>(
-      extensionHint,
+      file, extensionHint,
       [](const BitmapCodec &codec, const std::string &extension, FileAndBitmap &fileAndBitmap) {
-        if(codec.TryReload(*fileAndBitmap.TargetBitmap, *fileAndBitmap.File, extension)) {
+        bool wasReloaded = codec.TryReload(
+          *fileAndBitmap.TargetBitmap, *fileAndBitmap.File, extension, *fileAndBitmap.Options
+        );
+        if(wasReloaded) {
+          fileAndBitmap.Codec = &codec;
           return true;
         } else {
           return false;
@@ -265,11 +893,16 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     if(!wasLoaded) {
       throw Errors::FileFormatError("File format not supported by any registered codec");
     }
+
+    recordTransfer(*fileProvider.Codec, startTime, file.GetSize(), false);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BitmapSerializer::Reload(Bitmap &exactFittingBitmap, const std::string &path) const {
+  void BitmapSerializer::Reload(
+    Bitmap &exactFittingBitmap, const std::string &path,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
     std::string::size_type extensionDotIndex = path.find_last_of('.');
 #if defined(NUCLEX_PIXELS_WIN32)
     std::string::size_type lastPathSeparatorIndex = path.find_last_of('\\');
@@ -285,52 +918,310 @@ namespace Nuclex { namespace Pixels { namespace Storage {
         (extensionDotIndex > lastPathSeparatorIndex)
       );
       if(dotBelongsToFilename) {
-        std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path, true);
-        Reload(exactFittingBitmap, *file.get(), path.substr(extensionDotIndex + 1));
+        std::unique_ptr<const VirtualFile> file = openFileForLoading(path, options);
+        Reload(exactFittingBitmap, *file.get(), path.substr(extensionDotIndex + 1), options);
         return;
       }
     }
 
     // The specified file has no extension, so do not provide the extension hint
     {
-      std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path, true);
-      Reload(exactFittingBitmap, *file.get());
+      std::unique_ptr<const VirtualFile> file = openFileForLoading(path, options);
+      Reload(exactFittingBitmap, *file.get(), std::string(), options);
       return;
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  void BitmapSerializer::LoadInto(
+    const BitmapMemory &target,
+    const VirtualFile &file, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    requireUsableMemory(target);
+
+    Bitmap targetBitmap = Bitmap::FromExistingMemory(target);
+    Reload(targetBitmap, file, extensionHint, options);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapSerializer::LoadInto(
+    const BitmapMemory &target, const std::string &path,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    requireUsableMemory(target);
+
+    Bitmap targetBitmap = Bitmap::FromExistingMemory(target);
+    Reload(targetBitmap, path, options);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void BitmapSerializer::Save(
-    const Bitmap &bitmap, VirtualFile &file, const std::string &extension
+    const Bitmap &bitmap, VirtualFile &file, const std::string &extension,
+    const SaveOptions &options /* = SaveOptions() */
   ) const {
-    (void)bitmap;
-    (void)file;
-    (void)extension;
-    throw std::runtime_error("Not implemented yet");
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.BitmapSerializer.Save");
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    const BitmapCodec &codec = getCodecForSaving(extension);
+    try {
+      codec.Save(bitmap, file, options);
+    }
+    catch(...) {
+      getCodecCounters(codec).SaveFailureCount.fetch_add(1, std::memory_order_relaxed);
+      throw;
+    }
+
+    recordTransfer(codec, startTime, 0, true);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void BitmapSerializer::Save(
-    const Bitmap &bitmap, const std::string &path, const std::string &extension
+    const Bitmap &bitmap, const std::string &path,
+    const std::string &extension /* = std::string() */,
+    const SaveOptions &options /* = SaveOptions() */
   ) const {
-    (void)bitmap;
-    (void)path;
-    (void)extension;
-    throw std::runtime_error("Not implemented yet");
+    // Codecs write their output in small pieces, the buffer turns them into a few
+    // large writes to the file
+    if(!extension.empty()) {
+      WriteBufferedVirtualFile file(
+        VirtualFile::OpenRealFileForWriting(path, true), SaveWriteBufferByteCount
+      );
+      Save(bitmap, file, extension, options);
+      file.Flush();
+      return;
+    }
+
+    std::string::size_type extensionDotIndex = path.find_last_of('.');
+#if defined(NUCLEX_PIXELS_WIN32)
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of('\\');
+#else
+    std::string::size_type lastPathSeparatorIndex = path.find_last_of('/');
+#endif
+
+    // No extension was specified, so the file format is chosen by the extension
+    // of the path. If the path has no extension either, there's nothing to go by.
+    if(extensionDotIndex != std::string::npos) {
+      bool dotBelongsToFilename = (
+        (lastPathSeparatorIndex == std::string::npos) ||
+        (extensionDotIndex > lastPathSeparatorIndex)
+      );
+      if(dotBelongsToFilename) {
+        WriteBufferedVirtualFile file(
+          VirtualFile::OpenRealFileForWriting(path, true), SaveWriteBufferByteCount
+        );
+        Save(bitmap, file, path.substr(extensionDotIndex + 1), options);
+        file.Flush();
+        return;
+      }
+    }
+
+    throw Errors::FileFormatError(u8"File format can not be chosen without a file extension");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSource> BitmapSerializer::OpenRowSource(
+    std::unique_ptr<const VirtualFile> &&file,
+    const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    FileAndRowSource fileProvider;
+    fileProvider.File = file.get();
+    fileProvider.Options = &options;
+
+    bool wasOpened = tryCodecsInOptimalOrder<FileAndRowSource>(
+      *file.get(), extensionHint,
+      [](const BitmapCodec &codec, const std::string &extension, FileAndRowSource &stream) {
+        stream.RowSource = codec.TryOpenRowSource(*stream.File, extension, *stream.Options);
+        return static_cast<bool>(stream.RowSource);
+      },
+      fileProvider
+    );
+    if(!wasOpened) {
+      throw Errors::FileFormatError(
+        u8"File format not supported by any registered codec that can stream rows"
+      );
+    }
+
+    return std::unique_ptr<RowSource>(
+      new FileOwningRowSource(std::move(file), std::move(fileProvider.RowSource))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSource> BitmapSerializer::OpenRowSource(
+    const std::string &path, const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    return OpenRowSource(openFileForLoading(path, options), getFileExtension(path), options);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<AnimationReader> BitmapSerializer::OpenAnimation(
+    std::unique_ptr<const VirtualFile> &&file,
+    const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    FileAndAnimationReader fileProvider;
+    fileProvider.File = file.get();
+    fileProvider.Options = &options;
+
+    bool wasOpened = tryCodecsInOptimalOrder<FileAndAnimationReader>(
+      *file.get(), extensionHint,
+      [](
+        const BitmapCodec &codec, const std::string &extension,
+        FileAndAnimationReader &animation
+      ) {
+        animation.AnimationReader = codec.TryOpenAnimation(
+          *animation.File, extension, *animation.Options
+        );
+        return static_cast<bool>(animation.AnimationReader);
+      },
+      fileProvider
+    );
+    if(!wasOpened) {
+      throw Errors::FileFormatError(
+        u8"File format not supported by any registered codec that can read animations"
+      );
+    }
+
+    return std::unique_ptr<AnimationReader>(
+      new FileOwningAnimationReader(std::move(file), std::move(fileProvider.AnimationReader))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<AnimationReader> BitmapSerializer::OpenAnimation(
+    const std::string &path, const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    return OpenAnimation(openFileForLoading(path, options), getFileExtension(path), options);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSink> BitmapSerializer::OpenRowSink(
+    std::unique_ptr<VirtualFile> &&file, const std::string &extension,
+    std::size_t width, std::size_t height, PixelFormat pixelFormat,
+    const SaveOptions &options /* = SaveOptions() */
+  ) const {
+    std::unique_ptr<RowSink> rowSink = getCodecForSaving(extension).OpenRowSink(
+      *file.get(), width, height, pixelFormat, options
+    );
+    if(!rowSink) {
+      throw Errors::FileFormatError(
+        u8"Codec for the requested file extension can not stream rows"
+      );
+    }
+
+    return std::unique_ptr<RowSink>(new FileOwningRowSink(std::move(file), std::move(rowSink)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSink> BitmapSerializer::OpenRowSink(
+    const std::string &path,
+    std::size_t width, std::size_t height, PixelFormat pixelFormat,
+    const std::string &extension /* = std::string() */,
+    const SaveOptions &options /* = SaveOptions() */
+  ) const {
+    std::string fileExtension = extension.empty() ? getFileExtension(path) : extension;
+    if(fileExtension.empty()) {
+      throw Errors::FileFormatError(u8"File format can not be chosen without a file extension");
+    }
+
+    // Look the codec up before creating the file so no empty file is left behind
+    // if the extension doesn't select a codec that can save
+    getCodecForSaving(fileExtension);
+
+    return OpenRowSink(
+      VirtualFile::OpenRealFileForWriting(path, true), fileExtension,
+      width, height, pixelFormat, options
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const BitmapCodec &BitmapSerializer::getCodecForSaving(const std::string &extension) const {
+
+    // Unlike loading, there is no file header to look at, so the file extension
+    // is the only thing that decides which codec will be used
+    std::string foldedLowercaseExtension;
+    if(!extension.empty() && (extension[0] == '.')) {
+      foldedLowercaseExtension = toFoldedLowercase(extension.substr(1));
+    } else {
+      foldedLowercaseExtension = toFoldedLowercase(extension);
+    }
+
+    ExtensionCodecIndexMap::const_iterator iterator = (
+      this->codecsByExtension.find(foldedLowercaseExtension)
+    );
+    if(iterator == this->codecsByExtension.end()) {
+      throw Errors::FileFormatError(u8"No codec registered for the requested file extension");
+    }
+
+    const BitmapCodec &codec = *this->codecs[iterator->second].get();
+    if(!codec.CanSave()) {
+      throw Errors::FileFormatError(u8"Codec for the requested file extension can not save");
+    }
+
+    return codec;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   template<typename TOutput>
   bool BitmapSerializer::tryCodecsInOptimalOrder(
-    const std::string &extension,
+    const VirtualFile &file, const std::string &extension,
     bool (*tryCodecCallback)(
       const BitmapCodec &codec, const std::string &extension, TOutput &result
     ),
     TOutput &result
   ) const {
+
+    // Read the file header once so the codecs can check the file signature without
+    // each of them having to read from the file on its own
+    std::uint8_t fileHeader[FileHeaderSampleByteCount];
+    std::size_t fileHeaderByteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(file.GetSize(), FileHeaderSampleByteCount)
+    );
+    if(fileHeaderByteCount > 0) {
+      file.ReadAt(0, fileHeaderByteCount, fileHeader);
+    }
+
+    // Only lets codecs attempt to load the file if they accept its file header
+    auto tryCodec = [&](std::size_t codecIndex) {
+      const BitmapCodec &codec = *this->codecs[codecIndex].get();
+      CodecCounters &codecCounters = *this->counters->Codecs[codecIndex].get();
+      codecCounters.ProbeCount.fetch_add(1, std::memory_order_relaxed);
+
+      if(!codec.IsValidFileHeader(fileHeader, fileHeaderByteCount)) {
+        codecCounters.HeaderRejectionCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      bool wasRead;
+      try {
+        wasRead = tryCodecCallback(codec, extension, result);
+      }
+      catch(...) {
+        codecCounters.FailureCount.fetch_add(1, std::memory_order_relaxed);
+        throw;
+      }
+      if(wasRead) {
+        codecCounters.HitCount.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      return wasRead;
+    };
+
     std::size_t hintCodecIndex;
 
     // If an extension hint was provided, try the codec registered for the extension first
@@ -345,23 +1236,25 @@ namespace Nuclex { namespace Pixels { namespace Storage {
         hintCodecIndex = InvalidIndex;
       } else {
         hintCodecIndex = iterator->second;
-        if(tryCodecCallback(*this->codecs[hintCodecIndex].get(), extension, result)) {
+        if(tryCodec(hintCodecIndex)) {
+          this->counters->HintHitCount.fetch_add(1, std::memory_order_relaxed);
           updateMostRecentCodecIndex(hintCodecIndex);
           return true;
         }
       }
     }
 
-    // Look up the two most recently used codecs (we don't care about race conditions here,
-    // in the rare case of one occurring, we'll simple be a little less efficient and not
-    // have the right codec in the MRU list...
-    std::size_t mostRecent = this->mostRecentCodecIndex;
-    std::size_t secondMostRecent = this->secondMostRecentCodecIndex;
+    // Look up the two most recently used codecs. Both are read in one atomic load,
+    // so even if other threads are updating the list, we get a consistent pair.
+    std::uint64_t packedIndices = this->mostRecentCodecIndices.load(std::memory_order_relaxed);
+    std::size_t mostRecent = unpackCodecIndex(packedIndices, 0);
+    std::size_t secondMostRecent = unpackCodecIndex(packedIndices, 32);
 
     // Try the most recently used codec. It may be set to 'InvalidIndex' if this
     // is the first call to Load(). Don't try if it's the same as the extension hint.
     if((mostRecent != InvalidIndex) && (mostRecent != hintCodecIndex)) {
-      if(tryCodecCallback(*this->codecs[mostRecentCodecIndex].get(), extension, result)) {
+      if(tryCodec(mostRecent)) {
+        this->counters->MostRecentHitCount.fetch_add(1, std::memory_order_relaxed);
         updateMostRecentCodecIndex(mostRecent);
         return true;
       }
@@ -374,7 +1267,8 @@ namespace Nuclex { namespace Pixels { namespace Storage {
       (secondMostRecent != mostRecent) &&
       (secondMostRecent != hintCodecIndex)
     ) {
-      if(tryCodecCallback(*this->codecs[secondMostRecent].get(), extension, result)) {
+      if(tryCodec(secondMostRecent)) {
+        this->counters->SecondMostRecentHitCount.fetch_add(1, std::memory_order_relaxed);
         updateMostRecentCodecIndex(secondMostRecent);
         return true;
       }
@@ -388,21 +1282,151 @@ namespace Nuclex { namespace Pixels { namespace Storage {
         continue;
       }
 
-      if(tryCodecCallback(*this->codecs[index].get(), extension, result)) {
-        updateMostRecentCodecIndex(secondMostRecent);
+      if(tryCodec(index)) {
+        this->counters->ScanHitCount.fetch_add(1, std::memory_order_relaxed);
+        updateMostRecentCodecIndex(index);
         return true;
       }
     }
 
     // No codec can load the file, we give up
+    this->counters->MissCount.fetch_add(1, std::memory_order_relaxed);
     return false;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  BitmapSerializer::Statistics BitmapSerializer::GetStatistics() const {
+    Statistics statistics;
+    statistics.HintHitCount = this->counters->HintHitCount.load(std::memory_order_relaxed);
+    statistics.MostRecentHitCount = (
+      this->counters->MostRecentHitCount.load(std::memory_order_relaxed)
+    );
+    statistics.SecondMostRecentHitCount = (
+      this->counters->SecondMostRecentHitCount.load(std::memory_order_relaxed)
+    );
+    statistics.ScanHitCount = this->counters->ScanHitCount.load(std::memory_order_relaxed);
+    statistics.MissCount = this->counters->MissCount.load(std::memory_order_relaxed);
+
+    std::size_t codecCount = this->codecs.size();
+    statistics.Codecs.resize(codecCount);
+    for(std::size_t index = 0; index < codecCount; ++index) {
+      const CodecCounters &codecCounters = *this->counters->Codecs[index].get();
+      CodecStatistics &codecStatistics = statistics.Codecs[index];
+
+      codecStatistics.Name = this->codecs[index]->GetName();
+      codecStatistics.ProbeCount = codecCounters.ProbeCount.load(std::memory_order_relaxed);
+      codecStatistics.HeaderRejectionCount = (
+        codecCounters.HeaderRejectionCount.load(std::memory_order_relaxed)
+      );
+      codecStatistics.HitCount = codecCounters.HitCount.load(std::memory_order_relaxed);
+      codecStatistics.FailureCount = codecCounters.FailureCount.load(std::memory_order_relaxed);
+      codecStatistics.LoadedByteCount = (
+        codecCounters.LoadedByteCount.load(std::memory_order_relaxed)
+      );
+      codecStatistics.SaveFailureCount = (
+        codecCounters.SaveFailureCount.load(std::memory_order_relaxed)
+      );
+
+      codecStatistics.LoadCount = 0;
+      codecStatistics.SaveCount = 0;
+      for(std::size_t bucketIndex = 0; bucketIndex < TimeBucketCount; ++bucketIndex) {
+        codecStatistics.LoadCount += (
+          codecCounters.LoadTimeBuckets[bucketIndex].load(std::memory_order_relaxed)
+        );
+        codecStatistics.SaveCount += (
+          codecCounters.SaveTimeBuckets[bucketIndex].load(std::memory_order_relaxed)
+        );
+      }
+
+      codecStatistics.MedianLoadMicroseconds = estimatePercentile(
+        codecCounters.LoadTimeBuckets, 0.5
+      );
+      codecStatistics.Percentile90LoadMicroseconds = estimatePercentile(
+        codecCounters.LoadTimeBuckets, 0.9
+      );
+      codecStatistics.Percentile99LoadMicroseconds = estimatePercentile(
+        codecCounters.LoadTimeBuckets, 0.99
+      );
+      codecStatistics.MedianSaveMicroseconds = estimatePercentile(
+        codecCounters.SaveTimeBuckets, 0.5
+      );
+    }
+
+    return statistics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapSerializer::CodecCounters &BitmapSerializer::getCodecCounters(
+    const BitmapCodec &codec
+  ) const {
+    std::size_t codecCount = this->codecs.size();
+    for(std::size_t index = 0; index < codecCount; ++index) {
+      if(this->codecs[index].get() == &codec) {
+        return *this->counters->Codecs[index].get();
+      }
+    }
+
+    throw std::logic_error(u8"Codec is not registered with the bitmap serializer");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapSerializer::recordTransfer(
+    const BitmapCodec &codec, std::chrono::steady_clock::time_point startTime,
+    std::uint64_t fileByteCount, bool wasSaved
+  ) const {
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+    std::uint64_t microseconds = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+    );
+
+    CodecCounters &codecCounters = getCodecCounters(codec);
+    std::size_t bucketIndex = getTimeBucketIndex(microseconds);
+    if(wasSaved) {
+      codecCounters.SaveTimeBuckets[bucketIndex].fetch_add(1, std::memory_order_relaxed);
+    } else {
+      codecCounters.LoadTimeBuckets[bucketIndex].fetch_add(1, std::memory_order_relaxed);
+      codecCounters.LoadedByteCount.fetch_add(fileByteCount, std::memory_order_relaxed);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void BitmapSerializer::updateMostRecentCodecIndex(std::size_t codecIndex) const {
-    this->secondMostRecentCodecIndex = this->mostRecentCodecIndex;
-    this->mostRecentCodecIndex = codecIndex;
+    std::uint64_t packedIndices = this->mostRecentCodecIndices.load(std::memory_order_relaxed);
+    for(;;) {
+      std::uint32_t mostRecent = static_cast<std::uint32_t>(packedIndices);
+      if(mostRecent == static_cast<std::uint32_t>(codecIndex)) {
+        return; // Codec already is the most recently used one, nothing to do
+      }
+
+      // Move the current most recently used codec into the second slot. If another
+      // thread updated the indices in the meantime, this fails and we try again.
+      std::uint64_t updatedIndices = (
+        (static_cast<std::uint64_t>(mostRecent) << 32) |
+        static_cast<std::uint64_t>(static_cast<std::uint32_t>(codecIndex))
+      );
+      bool wasUpdated = this->mostRecentCodecIndices.compare_exchange_weak(
+        packedIndices, updatedIndices, std::memory_order_relaxed
+      );
+      if(wasUpdated) {
+        return;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BitmapSerializer::prefetchFile(const std::string &path) {
+    try {
+      std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path);
+      file->Prefetch(0, file->GetSize());
+    }
+    catch(const std::exception &) {
+      // Missing or unreadable files will be reported by the load that follows
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,261 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "BmpBitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include "../ByteOrder.h"
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the file header at the start of each BMP file</summary>
+  const std::size_t BmpFileHeaderByteCount = 14;
+  /// <summary>Size of the original BITMAPINFOHEADER following the file header</summary>
+  const std::size_t BitmapInfoHeaderByteCount = 40;
+  /// <summary>Size of the BITMAPV4HEADER which adds channel masks and a color space</summary>
+  const std::size_t BitmapV4HeaderByteCount = 108;
+
+  /// <summary>Compression method of uncompressed images</summary>
+  const std::uint32_t BI_RGB = 0;
+  /// <summary>Compression method of uncompressed images with channel masks</summary>
+  const std::uint32_t BI_BITFIELDS = 3;
+
+  /// <summary>Color space identifier for sRGB ('sRGB' as a four character code)</summary>
+  const std::uint32_t LCS_sRGB = 0x73524742;
+
+  /// <summary>Resolution stored in saved files, 72 DPI in pixels per meter</summary>
+  const std::uint32_t PixelsPerMeter = 2835;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file begins with the BMP file signature</summary>
+  /// <param name="source">File whose header will be checked</param>
+  /// <returns>True if the file looks like a BMP file, false otherwise</returns>
+  bool hasBmpSignature(const Nuclex::Pixels::Storage::VirtualFile &source) {
+    if(source.GetSize() < BmpFileHeaderByteCount + BitmapInfoHeaderByteCount) {
+      return false; // File is too short to be a BMP file
+    }
+
+    std::uint8_t fileHeader[2];
+    source.ReadAt(0, 2, fileHeader);
+    return (fileHeader[0] == 'B') && (fileHeader[1] == 'M');
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Bmp {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BmpBitmapCodec::BmpBitmapCodec() :
+    name(u8"Windows Bitmap (.bmp) uncompressed") {
+    this->knownFileExtensions.push_back(u8"bmp");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BmpBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    if(fileHeaderByteCount < 16) {
+      return false; // Too short for the BMP signature, let alone a whole BMP file
+    }
+    if((fileHeader[0] != 'B') || (fileHeader[1] != 'M')) {
+      return false;
+    }
+
+    // Two letters are easily matched by accident, so also check that the pixels come
+    // after the headers and that the next header has the size of a known DIB header
+    // (only its lower 16 bits are in the sample, the larger sizes all fit in those).
+    std::uint32_t pixelOffset = ReadLittleEndianUInt32(fileHeader + 10);
+    std::uint16_t dibHeaderSize = ReadLittleEndianUInt16(fileHeader + 14);
+    switch(dibHeaderSize) {
+      case 12: case 16: case 40: case 52: case 56: case 64: case 108: case 124: {
+        return (pixelOffset >= BmpFileHeaderByteCount + dibHeaderSize);
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BmpBitmapCodec::CanSave() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BmpBitmapCodec::TryReadLayout(const VirtualFile &source, RawImageLayout &layout) const {
+    if(!hasBmpSignature(source)) {
+      return false;
+    }
+
+    std::uint64_t fileSize = source.GetSize();
+
+    // The channel masks directly follow the BITMAPINFOHEADER and are part
+    // of all newer header versions, so they're always at the same place
+    std::uint8_t header[BmpFileHeaderByteCount + BitmapInfoHeaderByteCount + 12] = { 0 };
+    source.ReadAt(
+      0,
+      static_cast<std::size_t>(std::min<std::uint64_t>(sizeof(header), fileSize)),
+      header
+    );
+
+    std::uint32_t dibHeaderSize = ReadLittleEndianUInt32(header + 14);
+    if(dibHeaderSize < BitmapInfoHeaderByteCount) {
+      throw Errors::FileFormatError(u8"BMP files with OS/2 headers are not supported");
+    }
+
+    std::int32_t width = static_cast<std::int32_t>(ReadLittleEndianUInt32(header + 18));
+    std::int32_t height = static_cast<std::int32_t>(ReadLittleEndianUInt32(header + 22));
+    std::uint16_t bitsPerPixel = ReadLittleEndianUInt16(header + 28);
+    std::uint32_t compression = ReadLittleEndianUInt32(header + 30);
+    if((width <= 0) || (height == 0)) {
+      throw Errors::FileFormatError(u8"BMP file contains an empty image");
+    }
+
+    if((bitsPerPixel == 24) && (compression == BI_RGB)) {
+      layout.PixelFormat = PixelFormat::B8_G8_R8_Unsigned;
+    } else if((bitsPerPixel == 32) && (compression == BI_RGB)) {
+      layout.PixelFormat = PixelFormat::B8_G8_R8_A8_Unsigned;
+    } else if((bitsPerPixel == 32) && (compression == BI_BITFIELDS)) {
+      std::uint32_t redMask = ReadLittleEndianUInt32(header + 54);
+      std::uint32_t greenMask = ReadLittleEndianUInt32(header + 58);
+      std::uint32_t blueMask = ReadLittleEndianUInt32(header + 62);
+      if((redMask == 0x00FF0000) && (greenMask == 0x0000FF00) && (blueMask == 0x000000FF)) {
+        layout.PixelFormat = PixelFormat::B8_G8_R8_A8_Unsigned;
+      } else if((redMask == 0x000000FF) && (greenMask == 0x0000FF00) && (blueMask == 0x00FF0000)) {
+        layout.PixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned;
+      } else {
+        throw Errors::FileFormatError(u8"BMP file uses unsupported channel masks");
+      }
+    } else {
+      throw Errors::FileFormatError(u8"Only uncompressed 24 and 32 bit BMP files are supported");
+    }
+
+    // Rows are padded to multiples of 4 bytes. A negative height means the rows
+    // are stored top to bottom, otherwise the bottommost row comes first.
+    layout.Width = static_cast<std::size_t>(width);
+    layout.IsBottomUp = (height > 0);
+    layout.Height = static_cast<std::size_t>(layout.IsBottomUp ? height : -height);
+    layout.Offset = ReadLittleEndianUInt32(header + 10);
+    layout.StoredBytesPerPixel = bitsPerPixel / 8;
+    layout.RowPitch = ((layout.StoredBytesPerPixel * layout.Width) + 3) & ~std::size_t(3);
+    layout.NeedsTransform = false;
+    layout.HasFlippedWords = false;
+
+    std::uint64_t imageByteCount = static_cast<std::uint64_t>(layout.RowPitch) * layout.Height;
+    if((imageByteCount > fileSize) || (layout.Offset > fileSize - imageByteCount)) {
+      throw Errors::FileFormatError(u8"BMP file is truncated");
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BmpBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    (void)options; // Unused
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"BMP files can not store empty bitmaps");
+    }
+
+    // Images without alpha are stored as 24 bit BGR with the original header,
+    // everything else is stored as 32 bit BGRA or RGBA, which needs the V4 header's
+    // channel masks. RGBA is kept as-is so it can be written without conversion.
+    PixelFormat storedPixelFormat;
+    if(
+      (memory.PixelFormat == PixelFormat::B8_G8_R8_Unsigned) ||
+      (memory.PixelFormat == PixelFormat::R8_G8_B8_Unsigned)
+    ) {
+      storedPixelFormat = PixelFormat::B8_G8_R8_Unsigned;
+    } else if(memory.PixelFormat == PixelFormat::R8_G8_B8_A8_Unsigned) {
+      storedPixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned;
+    } else {
+      storedPixelFormat = PixelFormat::B8_G8_R8_A8_Unsigned;
+    }
+
+    bool hasAlpha = (storedPixelFormat != PixelFormat::B8_G8_R8_Unsigned);
+    bool isRgba = (storedPixelFormat == PixelFormat::R8_G8_B8_A8_Unsigned);
+    std::size_t dibHeaderSize = hasAlpha ? BitmapV4HeaderByteCount : BitmapInfoHeaderByteCount;
+    std::size_t offset = BmpFileHeaderByteCount + dibHeaderSize;
+    std::size_t rowPitch = (
+      (CountRequiredBytes(storedPixelFormat, memory.Width) + 3) & ~std::size_t(3)
+    );
+    std::uint64_t fileSize = offset + (static_cast<std::uint64_t>(rowPitch) * memory.Height);
+    if(fileSize > 0xFFFFFFFF) {
+      throw std::invalid_argument(u8"Bitmap is too large to be stored in a BMP file");
+    }
+
+    std::uint8_t header[BmpFileHeaderByteCount + BitmapV4HeaderByteCount] = { 0 };
+    {
+      header[0] = 'B';
+      header[1] = 'M';
+      WriteLittleEndianUInt32(header + 2, static_cast<std::uint32_t>(fileSize));
+      WriteLittleEndianUInt32(header + 10, static_cast<std::uint32_t>(offset));
+
+      // Store the height as a negative number so the rows can be written top to bottom
+      WriteLittleEndianUInt32(header + 14, static_cast<std::uint32_t>(dibHeaderSize));
+      WriteLittleEndianUInt32(header + 18, static_cast<std::uint32_t>(memory.Width));
+      WriteLittleEndianUInt32(
+        header + 22, static_cast<std::uint32_t>(-static_cast<std::int32_t>(memory.Height))
+      );
+      WriteLittleEndianUInt16(header + 26, 1); // Planes
+      WriteLittleEndianUInt16(header + 28, hasAlpha ? 32 : 24);
+      WriteLittleEndianUInt32(header + 30, hasAlpha ? BI_BITFIELDS : BI_RGB);
+      WriteLittleEndianUInt32(
+        header + 34, static_cast<std::uint32_t>(rowPitch * memory.Height)
+      );
+      WriteLittleEndianUInt32(header + 38, PixelsPerMeter);
+      WriteLittleEndianUInt32(header + 42, PixelsPerMeter);
+      if(hasAlpha) {
+        WriteLittleEndianUInt32(header + 54, isRgba ? 0x000000FF : 0x00FF0000); // Red mask
+        WriteLittleEndianUInt32(header + 58, 0x0000FF00); // Green mask
+        WriteLittleEndianUInt32(header + 62, isRgba ? 0x00FF0000 : 0x000000FF); // Blue mask
+        WriteLittleEndianUInt32(header + 66, 0xFF000000); // Alpha mask
+        WriteLittleEndianUInt32(header + 70, LCS_sRGB);
+      }
+    }
+    target.WriteAt(0, offset, header);
+
+    WriteRows(memory, target, offset, storedPixelFormat, rowPitch, false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Bmp
@@ -0,0 +1,130 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "BufferedVirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileAccessError.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BufferedVirtualFile::BufferedVirtualFile(
+    std::unique_ptr<const VirtualFile> file, std::size_t readAheadByteCount
+  ) :
+    file(std::move(file)),
+    bufferStart(0),
+    bufferedByteCount(0),
+    sequentialStart(0) {
+
+    if(!this->file) {
+      throw std::invalid_argument(u8"File to read ahead on must not be null");
+    }
+    if(readAheadByteCount == 0) {
+      throw std::invalid_argument(u8"Read-ahead window must be larger than zero");
+    }
+
+    this->length = this->file->GetSize();
+
+    // No need to reserve a large window if the file is smaller than that anyway
+    this->readAheadBuffer.resize(
+      static_cast<std::size_t>(std::min<std::uint64_t>(readAheadByteCount, this->length))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BufferedVirtualFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+  ) const {
+    bool isSequential = (start == this->sequentialStart);
+    this->sequentialStart = start + byteCount;
+
+    while(byteCount > 0) {
+
+      // If the buffer holds data at the requested offset, serve the read from it.
+      // Continuing to read right after the buffer's end is sequential access, too.
+      std::uint64_t bufferEnd = this->bufferStart + this->bufferedByteCount;
+      if((start >= this->bufferStart) && (start < bufferEnd)) {
+        std::size_t chunkByteCount = static_cast<std::size_t>(
+          std::min<std::uint64_t>(byteCount, bufferEnd - start)
+        );
+        std::memcpy(
+          buffer,
+          &this->readAheadBuffer[static_cast<std::size_t>(start - this->bufferStart)],
+          chunkByteCount
+        );
+
+        start += chunkByteCount;
+        buffer += chunkByteCount;
+        byteCount -= chunkByteCount;
+        isSequential = true;
+        continue;
+      }
+
+      // Random accesses, reads that would not fit the window and reads beyond the end
+      // of the file are passed through to the wrapped file
+      bool canBuffer = (
+        isSequential &&
+        (byteCount < this->readAheadBuffer.size()) &&
+        (start <= this->length) &&
+        (byteCount <= this->length - start)
+      );
+      if(!canBuffer) {
+        this->file->ReadAt(start, byteCount, buffer);
+        return;
+      }
+
+      // Read ahead as far as the window allows and let the loop serve the read
+      this->bufferedByteCount = 0;
+      std::size_t readAheadByteCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(this->readAheadBuffer.size(), this->length - start)
+      );
+      this->file->ReadAt(start, readAheadByteCount, &this->readAheadBuffer[0]);
+      this->bufferStart = start;
+      this->bufferedByteCount = readAheadByteCount;
+
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BufferedVirtualFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+
+    throw Errors::FileAccessError(
+      std::make_error_code(std::errc::permission_denied),
+      u8"Buffered files can not be written to"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,121 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_BUFFEREDVIRTUALFILE_H
+#define NUCLEX_PIXELS_STORAGE_BUFFEREDVIRTUALFILE_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+
+#include <vector>
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads ahead on another file to serve many small reads from a buffer</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The image libraries request data in small pieces (libjpeg asks for 4 KiB at
+  ///     a time, for example). On a real file, each of these would become a system call.
+  ///     This wrapper reads a larger window of the file at once and serves the small
+  ///     reads from it.
+  ///   </para>
+  ///   <para>
+  ///     Reading ahead only pays off if the following reads are close by, so the window
+  ///     is only filled when a read continues where the previous one ended. Other reads
+  ///     and reads larger than the window go directly to the wrapped file.
+  ///   </para>
+  /// </remarks>
+  class BufferedVirtualFile : public VirtualFile {
+
+    /// <summary>Initializes a new read-ahead buffer for the specified file</summary>
+    /// <param name="file">File that will be read from through the buffer</param>
+    /// <param name="readAheadByteCount">Number of bytes that will be read ahead</param>
+    public: BufferedVirtualFile(
+      std::unique_ptr<const VirtualFile> file, std::size_t readAheadByteCount
+    );
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: virtual ~BufferedVirtualFile() = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override;
+
+    /// <summary>Always throws because buffered files are read-only</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override;
+
+    /// <summary>Provides direct access to the wrapped file's contents if possible</summary>
+    /// <param name="start">Offset in the file at which the span should begin</param>
+    /// <param name="byteCount">Number of bytes the span should cover</param>
+    /// <returns>The address of the requested bytes or null if not in memory</returns>
+    public: const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t start, std::size_t byteCount
+    ) const override {
+      return this->file->TryGetContiguousSpan(start, byteCount);
+    }
+
+    /// <summary>Tells the wrapped file that it will be read from start to end</summary>
+    public: void AdviseSequential() const override { this->file->AdviseSequential(); }
+
+    /// <summary>Asks the wrapped file to load a range of its contents in the background</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes the range covers</param>
+    public: void Prefetch(std::uint64_t start, std::uint64_t byteCount) const override {
+      this->file->Prefetch(start, byteCount);
+    }
+
+    private: BufferedVirtualFile(const BufferedVirtualFile &) = delete;
+    private: BufferedVirtualFile &operator =(const BufferedVirtualFile &) = delete;
+
+    /// <summary>File the buffer is reading ahead on</summary>
+    private: std::unique_ptr<const VirtualFile> file;
+    /// <summary>Length of the file in bytes</summary>
+    private: std::uint64_t length;
+    /// <summary>Holds the data that has been read ahead</summary>
+    private: mutable std::vector<std::uint8_t> readAheadBuffer;
+    /// <summary>Offset in the file the buffer's contents begin at</summary>
+    private: mutable std::uint64_t bufferStart;
+    /// <summary>Number of bytes currently held in the buffer</summary>
+    private: mutable std::size_t bufferedByteCount;
+    /// <summary>Offset a read has to start at to count as sequential</summary>
+    private: mutable std::uint64_t sequentialStart;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_BUFFEREDVIRTUALFILE_H
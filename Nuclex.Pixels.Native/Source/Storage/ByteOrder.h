@@ -0,0 +1,93 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_BYTEORDER_H
+#define NUCLEX_PIXELS_STORAGE_BYTEORDER_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include <cstdint> // for std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 16 bit little endian integer from a file header</summary>
+  /// <param name="bytes">Address of the integer's first byte</param>
+  /// <returns>The integer in native byte order</returns>
+  inline std::uint16_t ReadLittleEndianUInt16(const std::uint8_t *bytes) {
+    return static_cast<std::uint16_t>(
+      static_cast<std::uint16_t>(bytes[0]) | (static_cast<std::uint16_t>(bytes[1]) << 8)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 32 bit little endian integer from a file header</summary>
+  /// <param name="bytes">Address of the integer's first byte</param>
+  /// <returns>The integer in native byte order</returns>
+  inline std::uint32_t ReadLittleEndianUInt32(const std::uint8_t *bytes) {
+    return (
+      static_cast<std::uint32_t>(bytes[0]) |
+      (static_cast<std::uint32_t>(bytes[1]) << 8) |
+      (static_cast<std::uint32_t>(bytes[2]) << 16) |
+      (static_cast<std::uint32_t>(bytes[3]) << 24)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 64 bit little endian integer from a file header</summary>
+  /// <param name="bytes">Address of the integer's first byte</param>
+  /// <returns>The integer in native byte order</returns>
+  inline std::uint64_t ReadLittleEndianUInt64(const std::uint8_t *bytes) {
+    return (
+      static_cast<std::uint64_t>(ReadLittleEndianUInt32(bytes)) |
+      (static_cast<std::uint64_t>(ReadLittleEndianUInt32(bytes + 4)) << 32)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 32 bit little endian integer into a file header</summary>
+  /// <param name="bytes">Address at which the integer's first byte will be written</param>
+  /// <param name="value">Integer that will be written</param>
+  inline void WriteLittleEndianUInt32(std::uint8_t *bytes, std::uint32_t value) {
+    bytes[0] = static_cast<std::uint8_t>(value);
+    bytes[1] = static_cast<std::uint8_t>(value >> 8);
+    bytes[2] = static_cast<std::uint8_t>(value >> 16);
+    bytes[3] = static_cast<std::uint8_t>(value >> 24);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 16 bit little endian integer into a file header</summary>
+  /// <param name="bytes">Address at which the integer's first byte will be written</param>
+  /// <param name="value">Integer that will be written</param>
+  inline void WriteLittleEndianUInt16(std::uint8_t *bytes, std::uint16_t value) {
+    bytes[0] = static_cast<std::uint8_t>(value);
+    bytes[1] = static_cast<std::uint8_t>(value >> 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_BYTEORDER_H
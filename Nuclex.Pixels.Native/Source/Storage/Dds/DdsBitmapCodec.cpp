@@ -0,0 +1,530 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "DdsBitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+
+#include <cstring> // for std::memcmp()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+// Layout of the DDS header is documented at
+// https://docs.microsoft.com/windows/win32/direct3ddds/dds-header
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a four character code as used in the DDS pixel format</summary>
+  /// <param name="a">First character of the code</param>
+  /// <param name="b">Second character of the code</param>
+  /// <param name="c">Third character of the code</param>
+  /// <param name="d">Fourth character of the code</param>
+  /// <returns>The four character code as a 32 bit integer</returns>
+  constexpr std::uint32_t makeFourCc(char a, char b, char c, char d) {
+    return (
+      static_cast<std::uint32_t>(static_cast<std::uint8_t>(a)) |
+      (static_cast<std::uint32_t>(static_cast<std::uint8_t>(b)) << 8) |
+      (static_cast<std::uint32_t>(static_cast<std::uint8_t>(c)) << 16) |
+      (static_cast<std::uint32_t>(static_cast<std::uint8_t>(d)) << 24)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Magic bytes at the start of each DDS file</summary>
+  const std::uint8_t DdsMagic[4] = { 'D', 'D', 'S', ' ' };
+
+  /// <summary>Size of the magic bytes plus the DDS header</summary>
+  const std::size_t DdsHeaderByteCount = 128;
+  /// <summary>Size of the DX10 header extension following the DDS header</summary>
+  const std::size_t Dx10HeaderByteCount = 20;
+  /// <summary>Value the DDS header stores as its own size</summary>
+  const std::uint32_t DdsHeaderSize = 124;
+  /// <summary>Value the DDS pixel format stores as its own size</summary>
+  const std::uint32_t DdsPixelFormatSize = 32;
+
+  /// <summary>Header flag indicating that the caps field is valid</summary>
+  const std::uint32_t DDSD_CAPS = 0x1;
+  /// <summary>Header flag indicating that the height field is valid</summary>
+  const std::uint32_t DDSD_HEIGHT = 0x2;
+  /// <summary>Header flag indicating that the width field is valid</summary>
+  const std::uint32_t DDSD_WIDTH = 0x4;
+  /// <summary>Header flag indicating that the pitch field holds the row size</summary>
+  const std::uint32_t DDSD_PITCH = 0x8;
+  /// <summary>Header flag indicating that the pixel format is valid</summary>
+  const std::uint32_t DDSD_PIXELFORMAT = 0x1000;
+  /// <summary>Header flag indicating that the mip map count field is valid</summary>
+  const std::uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+  /// <summary>Header flag indicating that the pitch field holds the level size</summary>
+  const std::uint32_t DDSD_LINEARSIZE = 0x80000;
+
+  /// <summary>Pixel format flag indicating that the alpha mask is valid</summary>
+  const std::uint32_t DDPF_ALPHAPIXELS = 0x1;
+  /// <summary>Pixel format flag indicating that the four character code is valid</summary>
+  const std::uint32_t DDPF_FOURCC = 0x4;
+  /// <summary>Pixel format flag indicating uncompressed RGB data</summary>
+  const std::uint32_t DDPF_RGB = 0x40;
+  /// <summary>Pixel format flag indicating uncompressed luminance data</summary>
+  const std::uint32_t DDPF_LUMINANCE = 0x20000;
+
+  /// <summary>Caps flag required in all DDS files</summary>
+  const std::uint32_t DDSCAPS_TEXTURE = 0x1000;
+  /// <summary>Caps flag marking the texture as a cube map</summary>
+  const std::uint32_t DDSCAPS2_CUBEMAP = 0x200;
+  /// <summary>Caps flag marking the texture as a volume texture</summary>
+  const std::uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+  /// <summary>DX10 resource dimension of a two-dimensional texture</summary>
+  const std::uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+  /// <summary>DX10 misc flag marking the texture as a cube map</summary>
+  const std::uint32_t D3D10_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the pixel format equivalent to a DXGI format</summary>
+  /// <param name="dxgiFormat">DXGI format whose pixel format will be looked up</param>
+  /// <param name="pixelFormat">Receives the equivalent pixel format</param>
+  /// <returns>True if there is an equivalent pixel format, false otherwise</returns>
+  bool tryGetPixelFormatFromDxgi(
+    std::uint32_t dxgiFormat, Nuclex::Pixels::PixelFormat &pixelFormat
+  ) {
+    using Nuclex::Pixels::PixelFormat;
+    using Nuclex::Pixels::Storage::GetLittleEndianFormat;
+
+    switch(dxgiFormat) {
+      case 2: { // DXGI_FORMAT_R32G32B32A32_FLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R32_G32_B32_A32_Float);
+        return true;
+      }
+      case 10: { // DXGI_FORMAT_R16G16B16A16_FLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_G16_B16_A16_Float);
+        return true;
+      }
+      case 28: // DXGI_FORMAT_R8G8B8A8_UNORM
+      case 29: { // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+        pixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned;
+        return true;
+      }
+      case 34: { // DXGI_FORMAT_R16G16_FLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_G16_Float_Native16);
+        return true;
+      }
+      case 35: { // DXGI_FORMAT_R16G16_UNORM
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_G16_Unsigned_Native16);
+        return true;
+      }
+      case 41: { // DXGI_FORMAT_R32_FLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R32_Float_Native32);
+        return true;
+      }
+      case 49: { // DXGI_FORMAT_R8G8_UNORM
+        pixelFormat = PixelFormat::R8_G8_Unsigned;
+        return true;
+      }
+      case 54: { // DXGI_FORMAT_R16_FLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_Float_Native16);
+        return true;
+      }
+      case 56: { // DXGI_FORMAT_R16_UNORM
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_Unsigned_Native16);
+        return true;
+      }
+      case 61: { // DXGI_FORMAT_R8_UNORM
+        pixelFormat = PixelFormat::R8_Unsigned;
+        return true;
+      }
+      case 71: // DXGI_FORMAT_BC1_UNORM
+      case 72: { // DXGI_FORMAT_BC1_UNORM_SRGB
+        pixelFormat = PixelFormat::BC1_Compressed;
+        return true;
+      }
+      case 77: // DXGI_FORMAT_BC3_UNORM
+      case 78: { // DXGI_FORMAT_BC3_UNORM_SRGB
+        pixelFormat = PixelFormat::BC3_Compressed;
+        return true;
+      }
+      case 80: { // DXGI_FORMAT_BC4_UNORM
+        pixelFormat = PixelFormat::BC4_Compressed;
+        return true;
+      }
+      case 83: { // DXGI_FORMAT_BC5_UNORM
+        pixelFormat = PixelFormat::BC5_Compressed;
+        return true;
+      }
+      case 87: // DXGI_FORMAT_B8G8R8A8_UNORM
+      case 91: { // DXGI_FORMAT_B8G8R8A8_UNORM_SRGB
+        pixelFormat = PixelFormat::B8_G8_R8_A8_Unsigned;
+        return true;
+      }
+      case 98: // DXGI_FORMAT_BC7_UNORM
+      case 99: { // DXGI_FORMAT_BC7_UNORM_SRGB
+        pixelFormat = PixelFormat::BC7_Compressed;
+        return true;
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the DXGI format equivalent to a pixel format</summary>
+  /// <param name="pixelFormat">Pixel format whose DXGI format will be looked up</param>
+  /// <returns>The equivalent DXGI format or 0 (DXGI_FORMAT_UNKNOWN) if there is none</returns>
+  std::uint32_t getDxgiFormat(Nuclex::Pixels::PixelFormat pixelFormat) {
+    for(std::uint32_t dxgiFormat = 1; dxgiFormat < 100; ++dxgiFormat) {
+      Nuclex::Pixels::PixelFormat equivalentPixelFormat;
+      if(tryGetPixelFormatFromDxgi(dxgiFormat, equivalentPixelFormat)) {
+        if(equivalentPixelFormat == pixelFormat) {
+          return dxgiFormat;
+        }
+      }
+    }
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the pixel format equivalent to a legacy four character code</summary>
+  /// <param name="fourCc">Four character code whose pixel format will be looked up</param>
+  /// <param name="pixelFormat">Receives the equivalent pixel format</param>
+  /// <returns>True if there is an equivalent pixel format, false otherwise</returns>
+  bool tryGetPixelFormatFromFourCc(
+    std::uint32_t fourCc, Nuclex::Pixels::PixelFormat &pixelFormat
+  ) {
+    using Nuclex::Pixels::PixelFormat;
+    using Nuclex::Pixels::Storage::GetLittleEndianFormat;
+
+    if(fourCc == makeFourCc('D', 'X', 'T', '1')) {
+      pixelFormat = PixelFormat::BC1_Compressed;
+    } else if(fourCc == makeFourCc('D', 'X', 'T', '5')) {
+      pixelFormat = PixelFormat::BC3_Compressed;
+    } else if(
+      (fourCc == makeFourCc('A', 'T', 'I', '1')) || (fourCc == makeFourCc('B', 'C', '4', 'U'))
+    ) {
+      pixelFormat = PixelFormat::BC4_Compressed;
+    } else if(
+      (fourCc == makeFourCc('A', 'T', 'I', '2')) || (fourCc == makeFourCc('B', 'C', '5', 'U'))
+    ) {
+      pixelFormat = PixelFormat::BC5_Compressed;
+    } else if(fourCc == 113) { // D3DFMT_A16B16G16R16F
+      pixelFormat = GetLittleEndianFormat(PixelFormat::R16_G16_B16_A16_Float);
+    } else if(fourCc == 116) { // D3DFMT_A32B32G32R32F
+      pixelFormat = GetLittleEndianFormat(PixelFormat::R32_G32_B32_A32_Float);
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the pixel format equivalent to legacy channel bit masks</summary>
+  /// <param name="pixelFormatHeader">DDS pixel format structure inside the header</param>
+  /// <param name="pixelFormat">Receives the equivalent pixel format</param>
+  /// <returns>True if there is an equivalent pixel format, false otherwise</returns>
+  bool tryGetPixelFormatFromMasks(
+    const std::uint8_t *pixelFormatHeader, Nuclex::Pixels::PixelFormat &pixelFormat
+  ) {
+    using Nuclex::Pixels::PixelFormat;
+    using Nuclex::Pixels::Storage::ReadLittleEndianUInt32;
+
+    std::uint32_t flags = ReadLittleEndianUInt32(pixelFormatHeader + 4);
+    std::uint32_t bitCount = ReadLittleEndianUInt32(pixelFormatHeader + 12);
+    std::uint32_t redMask = ReadLittleEndianUInt32(pixelFormatHeader + 16);
+    std::uint32_t greenMask = ReadLittleEndianUInt32(pixelFormatHeader + 20);
+    std::uint32_t blueMask = ReadLittleEndianUInt32(pixelFormatHeader + 24);
+    std::uint32_t alphaMask = ReadLittleEndianUInt32(pixelFormatHeader + 28);
+
+    if((flags & DDPF_LUMINANCE) != 0) {
+      if((bitCount == 8) && (redMask == 0xFF) && ((flags & DDPF_ALPHAPIXELS) == 0)) {
+        pixelFormat = PixelFormat::R8_Unsigned;
+        return true;
+      }
+      return false;
+    }
+    if((flags & DDPF_RGB) == 0) {
+      return false;
+    }
+
+    bool hasAlpha = ((flags & DDPF_ALPHAPIXELS) != 0);
+    if((bitCount == 32) && hasAlpha && (alphaMask == 0xFF000000) && (greenMask == 0xFF00)) {
+      if((redMask == 0xFF) && (blueMask == 0xFF0000)) {
+        pixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned;
+        return true;
+      } else if((redMask == 0xFF0000) && (blueMask == 0xFF)) {
+        pixelFormat = PixelFormat::B8_G8_R8_A8_Unsigned;
+        return true;
+      }
+    } else if((bitCount == 24) && !hasAlpha && (greenMask == 0xFF00)) {
+      if((redMask == 0xFF) && (blueMask == 0xFF0000)) {
+        pixelFormat = PixelFormat::R8_G8_B8_Unsigned;
+        return true;
+      } else if((redMask == 0xFF0000) && (blueMask == 0xFF)) {
+        pixelFormat = PixelFormat::B8_G8_R8_Unsigned;
+        return true;
+      }
+    } else if((bitCount == 16) && !hasAlpha) {
+      if((redMask == 0xF800) && (greenMask == 0x07E0) && (blueMask == 0x001F)) {
+        pixelFormat = Nuclex::Pixels::Storage::GetLittleEndianFormat(
+          PixelFormat::R5_G6_B5_Unsigned
+        );
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file begins with the DDS magic bytes</summary>
+  /// <param name="source">File whose header will be checked</param>
+  /// <returns>True if the file looks like a DDS file, false otherwise</returns>
+  bool hasDdsMagic(const Nuclex::Pixels::Storage::VirtualFile &source) {
+    if(source.GetSize() < DdsHeaderByteCount) {
+      return false; // File is too short to be a DDS file
+    }
+
+    std::uint8_t fileHeader[4];
+    source.ReadAt(0, 4, fileHeader);
+    return (std::memcmp(fileHeader, DdsMagic, 4) == 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Dds {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DdsBitmapCodec::DdsBitmapCodec() :
+    name(u8"DirectDraw Surface (.dds) textures") {
+    this->knownFileExtensions.push_back(u8"dds");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool DdsBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    if(fileHeaderByteCount < 8) {
+      return false; // Too short for the magic bytes and header size
+    }
+
+    return (
+      (std::memcmp(fileHeader, DdsMagic, 4) == 0) &&
+      (ReadLittleEndianUInt32(fileHeader + 4) == DdsHeaderSize)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool DdsBitmapCodec::CanSave() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool DdsBitmapCodec::TryReadLayout(const VirtualFile &source, TextureLayout &layout) const {
+    if(!hasDdsMagic(source)) {
+      return false;
+    }
+
+    std::uint64_t fileSize = source.GetSize();
+
+    std::uint8_t header[DdsHeaderByteCount];
+    source.ReadAt(0, DdsHeaderByteCount, header);
+    if(ReadLittleEndianUInt32(header + 4) != DdsHeaderSize) {
+      throw Errors::FileFormatError(u8"DDS header has an invalid size");
+    }
+    if(ReadLittleEndianUInt32(header + 76) != DdsPixelFormatSize) {
+      throw Errors::FileFormatError(u8"DDS pixel format has an invalid size");
+    }
+
+    std::uint32_t flags = ReadLittleEndianUInt32(header + 8);
+    layout.Height = ReadLittleEndianUInt32(header + 12);
+    layout.Width = ReadLittleEndianUInt32(header + 16);
+    if((layout.Width == 0) || (layout.Height == 0)) {
+      throw Errors::FileFormatError(u8"DDS file contains an empty texture");
+    }
+
+    std::size_t levelCount = 1;
+    if((flags & DDSD_MIPMAPCOUNT) != 0) {
+      levelCount = ReadLittleEndianUInt32(header + 28);
+      if(levelCount == 0) {
+        levelCount = 1;
+      }
+    }
+
+    std::uint32_t caps2 = ReadLittleEndianUInt32(header + 112);
+    if((caps2 & DDSCAPS2_CUBEMAP) != 0) {
+      throw Errors::FileFormatError(u8"DDS cube maps are not supported");
+    }
+    if((caps2 & DDSCAPS2_VOLUME) != 0) {
+      throw Errors::FileFormatError(u8"DDS volume textures are not supported");
+    }
+
+    // The pixel format is either given as a four character code, which may indicate
+    // that a DX10 header extension with a DXGI format follows, or as channel bit masks
+    const std::uint8_t *pixelFormatHeader = header + 76;
+    std::uint32_t pixelFormatFlags = ReadLittleEndianUInt32(pixelFormatHeader + 4);
+    std::uint32_t fourCc = ReadLittleEndianUInt32(pixelFormatHeader + 8);
+
+    std::uint64_t dataOffset = DdsHeaderByteCount;
+    bool isSupported;
+    if(((pixelFormatFlags & DDPF_FOURCC) != 0) && (fourCc == makeFourCc('D', 'X', '1', '0'))) {
+      if(fileSize < DdsHeaderByteCount + Dx10HeaderByteCount) {
+        throw Errors::FileFormatError(u8"DDS file is truncated");
+      }
+
+      std::uint8_t dx10Header[Dx10HeaderByteCount];
+      source.ReadAt(DdsHeaderByteCount, Dx10HeaderByteCount, dx10Header);
+      if(ReadLittleEndianUInt32(dx10Header + 4) != D3D10_RESOURCE_DIMENSION_TEXTURE2D) {
+        throw Errors::FileFormatError(u8"Only two-dimensional DDS textures are supported");
+      }
+      if((ReadLittleEndianUInt32(dx10Header + 8) & D3D10_RESOURCE_MISC_TEXTURECUBE) != 0) {
+        throw Errors::FileFormatError(u8"DDS cube maps are not supported");
+      }
+      if(ReadLittleEndianUInt32(dx10Header + 12) > 1) {
+        throw Errors::FileFormatError(u8"DDS texture arrays are not supported");
+      }
+
+      isSupported = tryGetPixelFormatFromDxgi(
+        ReadLittleEndianUInt32(dx10Header), layout.PixelFormat
+      );
+      dataOffset += Dx10HeaderByteCount;
+    } else if((pixelFormatFlags & DDPF_FOURCC) != 0) {
+      isSupported = tryGetPixelFormatFromFourCc(fourCc, layout.PixelFormat);
+    } else {
+      isSupported = tryGetPixelFormatFromMasks(pixelFormatHeader, layout.PixelFormat);
+    }
+    if(!isSupported) {
+      throw Errors::FileFormatError(u8"DDS file uses an unsupported pixel format");
+    }
+
+    if(!IsValidTextureLevelCount(layout.Width, layout.Height, levelCount)) {
+      throw Errors::FileFormatError(u8"DDS file has an invalid number of mip levels");
+    }
+
+    // DDS files store their mip levels one after another, starting with the largest
+    AddSequentialTextureLevels(layout, levelCount, dataOffset, fileSize);
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DdsBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    (void)options; // Unused
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"DDS files can not store empty bitmaps");
+    }
+
+    // Pixel formats without a DXGI equivalent are converted to 8 bit RGBA while saving.
+    // All block-compressed formats have a DXGI equivalent.
+    PixelFormat pixelFormat = memory.PixelFormat;
+    std::uint32_t dxgiFormat = getDxgiFormat(pixelFormat);
+    if(dxgiFormat == 0) {
+      pixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned;
+      dxgiFormat = getDxgiFormat(pixelFormat);
+    }
+
+    Size blockSize = GetBlockSize(pixelFormat);
+    bool isBlockCompressed = (blockSize.Height != 1);
+    std::size_t rowByteCount = CountTextureRowBytes(pixelFormat, memory.Width);
+
+    std::uint8_t header[DdsHeaderByteCount + Dx10HeaderByteCount] = { 0 };
+    {
+      std::memcpy(header, DdsMagic, 4);
+      WriteLittleEndianUInt32(header + 4, DdsHeaderSize);
+      WriteLittleEndianUInt32(
+        header + 8,
+        DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | (
+          isBlockCompressed ? DDSD_LINEARSIZE : DDSD_PITCH
+        )
+      );
+      WriteLittleEndianUInt32(header + 12, static_cast<std::uint32_t>(memory.Height));
+      WriteLittleEndianUInt32(header + 16, static_cast<std::uint32_t>(memory.Width));
+      if(isBlockCompressed) {
+        WriteLittleEndianUInt32(
+          header + 20,
+          static_cast<std::uint32_t>(
+            CountTextureLevelBytes(pixelFormat, memory.Width, memory.Height)
+          )
+        );
+      } else {
+        WriteLittleEndianUInt32(header + 20, static_cast<std::uint32_t>(rowByteCount));
+      }
+      WriteLittleEndianUInt32(header + 28, 1); // Mip map count
+      WriteLittleEndianUInt32(header + 76, DdsPixelFormatSize);
+      WriteLittleEndianUInt32(header + 80, DDPF_FOURCC);
+      WriteLittleEndianUInt32(header + 84, makeFourCc('D', 'X', '1', '0'));
+      WriteLittleEndianUInt32(header + 108, DDSCAPS_TEXTURE);
+
+      std::uint8_t *dx10Header = header + DdsHeaderByteCount;
+      WriteLittleEndianUInt32(dx10Header, dxgiFormat);
+      WriteLittleEndianUInt32(dx10Header + 4, D3D10_RESOURCE_DIMENSION_TEXTURE2D);
+      WriteLittleEndianUInt32(dx10Header + 12, 1); // Array size
+    }
+    target.WriteAt(0, sizeof(header), header);
+
+    // Write the pixels one row (or one row of blocks) at a time. Like in the file,
+    // a row of blocks in a bitmap is the stride times the block height.
+    std::uint64_t position = sizeof(header);
+    std::size_t blockRowByteCount = rowByteCount * blockSize.Height;
+    const std::uint8_t *rowStartPointer = static_cast<const std::uint8_t *>(memory.Pixels);
+    if(pixelFormat == memory.PixelFormat) {
+      for(std::size_t y = 0; y < memory.Height; y += blockSize.Height) {
+        target.WriteAt(position, blockRowByteCount, rowStartPointer);
+        position += blockRowByteCount;
+        rowStartPointer += static_cast<std::ptrdiff_t>(memory.Stride) * blockSize.Height;
+      }
+    } else {
+      std::vector<std::uint8_t> convertedRow(rowByteCount);
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        PixelFormatConverter::ConvertRow(
+          memory.PixelFormat, rowStartPointer, pixelFormat, &convertedRow[0], memory.Width
+        );
+        target.WriteAt(position, rowByteCount, &convertedRow[0]);
+        position += rowByteCount;
+        rowStartPointer += memory.Stride;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Dds
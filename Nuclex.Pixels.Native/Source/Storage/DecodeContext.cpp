@@ -0,0 +1,71 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/DecodeContext.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodeContext::DecodeContext() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodeContext::~DecodeContext() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DecodeContext::State *DecodeContext::GetState(const BitmapCodec &codec) const {
+    std::size_t stateCount = this->states.size();
+    for(std::size_t index = 0; index < stateCount; ++index) {
+      if(this->states[index].first == &codec) {
+        return this->states[index].second.get();
+      }
+    }
+
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecodeContext::SetState(const BitmapCodec &codec, std::unique_ptr<State> &&state) {
+    std::size_t stateCount = this->states.size();
+    for(std::size_t index = 0; index < stateCount; ++index) {
+      if(this->states[index].first == &codec) {
+        this->states[index].second = std::move(state);
+        return;
+      }
+    }
+
+    this->states.emplace_back(&codec, std::move(state));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DecodeContext::Clear() {
+    this->states.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -35,12 +35,749 @@ License along with this library
 
 #include "Nuclex/Pixels/Storage/VirtualFile.h"
 #include "Nuclex/Pixels/Errors/FileFormatError.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/ParallelBands.h"
 #include "OpenExrHelpers.h"
+#include "../../RowStreamHelpers.h"
+#include "../../InstrumentationHelpers.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <cstring> // for std::memcpy()
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::invalid_argument
+#include <string> // for std::string
+#include <vector> // for std::vector
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Looks up the OpenEXR compression method for a compression setting</summary>
+  /// <param name="compression">Compression setting that will be looked up</param>
+  /// <returns>The matching OpenEXR compression method</returns>
+  Imf::Compression getExrCompression(Nuclex::Pixels::Storage::ExrCompression compression) {
+    using Nuclex::Pixels::Storage::ExrCompression;
+
+    switch(compression) {
+      case ExrCompression::None: { return Imf::NO_COMPRESSION; }
+      case ExrCompression::Zip: { return Imf::ZIP_COMPRESSION; }
+      case ExrCompression::Piz: { return Imf::PIZ_COMPRESSION; }
+      case ExrCompression::Dwaa: { return Imf::DWAA_COMPRESSION; }
+      case ExrCompression::Dwab: { return Imf::DWAB_COMPRESSION; }
+      default: {
+        throw std::invalid_argument(u8"Unsupported EXR compression method");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of rows decoded at once when only part of each row is needed</summary>
+  /// <remarks>
+  ///   Matches the block size of DWAA compression and is a multiple of the block size
+  ///   of ZIP compression, so no block is decoded more often than necessary.
+  /// </remarks>
+  const int CroppedScanlineBatchSize = 32;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a rectangular region within some bitmap memory</summary>
+  /// <param name="memory">Bitmap memory containing the region</param>
+  /// <param name="x">X coordinate of the region's left border</param>
+  /// <param name="y">Y coordinate of the region's top border</param>
+  /// <param name="width">Width of the region in pixels</param>
+  /// <param name="height">Height of the region in pixels</param>
+  /// <returns>Bitmap memory accessing only the pixels inside the region</returns>
+  Nuclex::Pixels::BitmapMemory getRegion(
+    const Nuclex::Pixels::BitmapMemory &memory,
+    std::size_t x, std::size_t y, std::size_t width, std::size_t height
+  ) {
+    Nuclex::Pixels::BitmapMemory region(memory);
+    region.Width = width;
+    region.Height = height;
+    region.Pixels = static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y) +
+      static_cast<std::ptrdiff_t>(Nuclex::Pixels::CountRequiredBytes(memory.PixelFormat, x))
+    );
+    return region;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies pixels between two bitmap memories of equal size and format</summary>
+  /// <param name="source">Bitmap memory the pixels will be copied from</param>
+  /// <param name="target">Bitmap memory the pixels will be copied into</param>
+  void copyPixels(
+    const Nuclex::Pixels::BitmapMemory &source, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+      source.PixelFormat, source.Width
+    );
+
+    const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(source.Pixels);
+    std::uint8_t *targetRow = static_cast<std::uint8_t *>(target.Pixels);
+    for(std::size_t y = 0; y < source.Height; ++y) {
+      std::memcpy(targetRow, sourceRow, rowByteCount);
+      sourceRow += source.Stride;
+      targetRow += target.Stride;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the window of absolute pixel coordinates that will be loaded</summary>
+  /// <param name="dataWindow">Data window of the image stored in the EXR file</param>
+  /// <param name="options">Load options that may select a smaller region</param>
+  /// <returns>The data window clipped to the region selected in the load options</returns>
+  Imath::Box2i getLoadWindow(
+    const Imath::Box2i &dataWindow, const Nuclex::Pixels::Storage::LoadOptions &options
+  ) {
+    Nuclex::Pixels::Rectangle region = Nuclex::Pixels::Storage::BitmapCodec::GetLoadRegion(
+      options,
+      static_cast<std::size_t>(dataWindow.max.x - dataWindow.min.x + 1),
+      static_cast<std::size_t>(dataWindow.max.y - dataWindow.min.y + 1)
+    );
+
+    return Imath::Box2i(
+      Imath::V2i(
+        dataWindow.min.x + static_cast<int>(region.MinX),
+        dataWindow.min.y + static_cast<int>(region.MinY)
+      ),
+      Imath::V2i(
+        dataWindow.min.x + static_cast<int>(region.MaxX) - 1,
+        dataWindow.min.y + static_cast<int>(region.MaxY) - 1
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the names of the channels that will be loaded</summary>
+  /// <param name="header">Header of the EXR image or part that will be loaded</param>
+  /// <param name="options">EXR load options that may select a layer or channels</param>
+  /// <returns>The names of the channels in the order they will be stored in the bitmap</returns>
+  std::vector<std::string> getChannelNames(
+    const Imf::Header &header, const Nuclex::Pixels::Storage::ExrLoadOptions &options
+  ) {
+    if(options.Channels.empty()) {
+      std::string prefix;
+      if(!options.Layer.empty()) {
+        prefix = options.Layer + u8".";
+      }
+
+      return std::vector<std::string> {
+        prefix + u8"R", prefix + u8"G", prefix + u8"B", prefix + u8"A"
+      };
+    }
+
+    if(options.Channels.size() > 4) {
+      throw std::invalid_argument(u8"At most four EXR channels can be loaded at once");
+    }
+    for(std::size_t index = 0; index < options.Channels.size(); ++index) {
+      if(header.channels().findChannel(options.Channels[index]) == nullptr) {
+        throw Nuclex::Pixels::Errors::FileFormatError(
+          u8"EXR file does not contain the channel selected for loading"
+        );
+      }
+    }
+
+    return options.Channels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the pixel format an EXR image will be loaded in</summary>
+  /// <param name="header">Header of the EXR image or part that will be loaded</param>
+  /// <param name="options">EXR load options that may select a layer or channels</param>
+  /// <returns>The pixel format that can hold the selected channels without loss</returns>
+  Nuclex::Pixels::PixelFormat getPixelFormat(
+    const Imf::Header &header, const Nuclex::Pixels::Storage::ExrLoadOptions &options
+  ) {
+    using Nuclex::Pixels::Storage::Exr::Helpers;
+
+    if(options.Channels.empty() && options.Layer.empty()) {
+      return Helpers::GetEquivalentPixelFormat(header);
+    } else {
+      return Helpers::GetEquivalentPixelFormat(header, getChannelNames(header, options));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks which part of an EXR file will be loaded</summary>
+  /// <param name="partCount">Number of parts the EXR file contains</param>
+  /// <param name="options">EXR load options selecting the part</param>
+  /// <returns>The index of the part that will be loaded</returns>
+  int getPartIndex(int partCount, const Nuclex::Pixels::Storage::ExrLoadOptions &options) {
+    if(options.Part >= static_cast<std::size_t>(partCount)) {
+      throw std::invalid_argument(u8"EXR file does not contain the part selected for loading");
+    }
+
+    return static_cast<int>(options.Part);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sets the channels of a bitmap that will not be loaded to defaults</summary>
+  /// <param name="target">Bitmap memory the selected channels will be loaded into</param>
+  /// <param name="selectedChannelCount">Number of channels that will be loaded</param>
+  /// <remarks>
+  ///   When fewer channels are selected than the pixel format has, OpenEXR doesn't
+  ///   touch the remaining ones. They become 0 or, for the alpha channel, opaque.
+  ///   This has to happen after decoding because cropped windows are copied over
+  ///   from temporary bitmaps pixel by pixel.
+  /// </remarks>
+  void fillUnselectedChannels(
+    const Nuclex::Pixels::BitmapMemory &target, std::size_t selectedChannelCount
+  ) {
+    using Nuclex::Pixels::Storage::Exr::Helpers;
+
+    bool isHalf = (Helpers::GetChannelType(target.PixelFormat) == Imf::HALF);
+    std::size_t channelSize = isHalf ? 2 : 4;
+    std::size_t channelCount = Nuclex::Pixels::CountBitsPerPixel(target.PixelFormat) / 8;
+    channelCount /= channelSize;
+    if(selectedChannelCount >= channelCount) {
+      return;
+    }
+
+    const float floatOne = 1.0f;
+    const std::uint16_t halfOne = 0x3C00; // 1.0 in half precision
+    const void *one = isHalf ? static_cast<const void *>(&halfOne) : &floatOne;
+    for(std::size_t y = 0; y < target.Height; ++y) {
+      std::uint8_t *pixel = (
+        static_cast<std::uint8_t *>(target.Pixels) +
+        static_cast<std::ptrdiff_t>(y) * target.Stride
+      );
+      for(std::size_t x = 0; x < target.Width; ++x) {
+        for(std::size_t index = selectedChannelCount; index < channelCount; ++index) {
+          std::uint8_t *channel = pixel + index * channelSize;
+          if(index == 3) {
+            std::memcpy(channel, one, channelSize);
+          } else {
+            std::memset(channel, 0, channelSize);
+          }
+        }
+        pixel += channelSize * channelCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a window of an EXR file stored as scanlines</summary>
+  /// <typeparam name="TScanlineInput">
+  ///   Either an OpenEXR input file or an input part of a multi-part file
+  /// </typeparam>
+  /// <param name="scanlineInput">OpenEXR file or part the pixels will be read from</param>
+  /// <param name="window">Window of absolute pixel coordinates that will be read</param>
+  /// <param name="channelNames">Names of the channels that will be read</param>
+  /// <param name="target">Bitmap memory matching the window's size</param>
+  template<typename TScanlineInput>
+  void readScanlines(
+    TScanlineInput &scanlineInput, const Imath::Box2i &window,
+    const std::vector<std::string> &channelNames, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    using Nuclex::Pixels::Storage::Exr::Helpers;
+
+    // If whole rows are needed, OpenEXR can decode straight into the target
+    const Imath::Box2i &dataWindow = scanlineInput.header().dataWindow();
+    if((window.min.x == dataWindow.min.x) && (window.max.x == dataWindow.max.x)) {
+      Imf::FrameBuffer frameBuffer;
+      Helpers::AddChannelsToFrameBuffer(
+        frameBuffer, target, channelNames, window.min.x, window.min.y
+      );
+      scanlineInput.setFrameBuffer(frameBuffer);
+      scanlineInput.readPixels(window.min.y, window.max.y);
+      return;
+    }
+
+    // OpenEXR always delivers complete rows, so decode batches of rows into
+    // a temporary bitmap and copy the part inside the window over to the target
+    Nuclex::Pixels::Bitmap batch(
+      static_cast<std::size_t>(dataWindow.max.x - dataWindow.min.x + 1),
+      CroppedScanlineBatchSize,
+      target.PixelFormat
+    );
+    const Nuclex::Pixels::BitmapMemory &batchMemory = batch.Access();
+
+    std::size_t regionX = static_cast<std::size_t>(window.min.x - dataWindow.min.x);
+    for(int y = window.min.y; y <= window.max.y; y += CroppedScanlineBatchSize) {
+      int lastY = std::min(y + CroppedScanlineBatchSize - 1, window.max.y);
+      std::size_t rowCount = static_cast<std::size_t>(lastY - y + 1);
+
+      Imf::FrameBuffer frameBuffer;
+      Helpers::AddChannelsToFrameBuffer(
+        frameBuffer, batchMemory, channelNames, dataWindow.min.x, y
+      );
+      scanlineInput.setFrameBuffer(frameBuffer);
+      scanlineInput.readPixels(y, lastY);
+
+      copyPixels(
+        getRegion(batchMemory, regionX, 0, target.Width, rowCount),
+        getRegion(target, 0, static_cast<std::size_t>(y - window.min.y), target.Width, rowCount)
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a window of an EXR file stored as tiles</summary>
+  /// <typeparam name="TTiledInput">
+  ///   Either an OpenEXR tiled input file or a tiled input part of a multi-part file
+  /// </typeparam>
+  /// <param name="tiledInput">OpenEXR file or part the tiles will be read from</param>
+  /// <param name="window">Window of absolute pixel coordinates that will be read</param>
+  /// <param name="channelNames">Names of the channels that will be read</param>
+  /// <param name="target">Bitmap memory matching the window's size</param>
+  /// <remarks>
+  ///   Only the tiles overlapping the window are decoded. Tiles lying completely inside
+  ///   the window are decoded straight into the target in a single call, allowing
+  ///   OpenEXR to decompress them in parallel. The tiles along the edges of the window
+  ///   go through a temporary bitmap one by one.
+  /// </remarks>
+  template<typename TTiledInput>
+  void readTiles(
+    TTiledInput &tiledInput, const Imath::Box2i &window,
+    const std::vector<std::string> &channelNames, const Nuclex::Pixels::BitmapMemory &target
+  ) {
+    using Nuclex::Pixels::Storage::Exr::Helpers;
+
+    const Imath::Box2i &dataWindow = tiledInput.header().dataWindow();
+    int tileWidth = static_cast<int>(tiledInput.tileXSize());
+    int tileHeight = static_cast<int>(tiledInput.tileYSize());
+
+    // Range of tiles overlapping the window at all
+    int firstTileX = (window.min.x - dataWindow.min.x) / tileWidth;
+    int lastTileX = (window.max.x - dataWindow.min.x) / tileWidth;
+    int firstTileY = (window.min.y - dataWindow.min.y) / tileHeight;
+    int lastTileY = (window.max.y - dataWindow.min.y) / tileHeight;
+
+    // Range of tiles lying completely inside the window. The tiles in the last
+    // column and row may be cut off by the data window, which is fine.
+    int firstInnerTileX = firstTileX;
+    if(tiledInput.dataWindowForTile(firstTileX, firstTileY).min.x < window.min.x) {
+      ++firstInnerTileX;
+    }
+    int lastInnerTileX = lastTileX;
+    if(tiledInput.dataWindowForTile(lastTileX, firstTileY).max.x > window.max.x) {
+      --lastInnerTileX;
+    }
+    int firstInnerTileY = firstTileY;
+    if(tiledInput.dataWindowForTile(firstTileX, firstTileY).min.y < window.min.y) {
+      ++firstInnerTileY;
+    }
+    int lastInnerTileY = lastTileY;
+    if(tiledInput.dataWindowForTile(firstTileX, lastTileY).max.y > window.max.y) {
+      --lastInnerTileY;
+    }
+
+    bool hasInnerTiles = (
+      (firstInnerTileX <= lastInnerTileX) && (firstInnerTileY <= lastInnerTileY)
+    );
+    if(hasInnerTiles) {
+      Imf::FrameBuffer frameBuffer;
+      Helpers::AddChannelsToFrameBuffer(
+        frameBuffer, target, channelNames, window.min.x, window.min.y
+      );
+      tiledInput.setFrameBuffer(frameBuffer);
+      tiledInput.readTiles(firstInnerTileX, lastInnerTileX, firstInnerTileY, lastInnerTileY);
+    }
+
+    // Decode the remaining tiles that are cut by the window's border
+    Nuclex::Pixels::Bitmap tile(
+      static_cast<std::size_t>(tileWidth), static_cast<std::size_t>(tileHeight),
+      target.PixelFormat
+    );
+    const Nuclex::Pixels::BitmapMemory &tileMemory = tile.Access();
+    for(int tileY = firstTileY; tileY <= lastTileY; ++tileY) {
+      for(int tileX = firstTileX; tileX <= lastTileX; ++tileX) {
+        bool isInnerTile = (
+          (tileX >= firstInnerTileX) && (tileX <= lastInnerTileX) &&
+          (tileY >= firstInnerTileY) && (tileY <= lastInnerTileY)
+        );
+        if(isInnerTile) {
+          continue;
+        }
+
+        Imath::Box2i tileWindow = tiledInput.dataWindowForTile(tileX, tileY);
+
+        Imf::FrameBuffer frameBuffer;
+        Helpers::AddChannelsToFrameBuffer(
+          frameBuffer, tileMemory, channelNames, tileWindow.min.x, tileWindow.min.y
+        );
+        tiledInput.setFrameBuffer(frameBuffer);
+        tiledInput.readTile(tileX, tileY);
+
+        Imath::V2i overlapMin(
+          std::max(tileWindow.min.x, window.min.x), std::max(tileWindow.min.y, window.min.y)
+        );
+        Imath::V2i overlapMax(
+          std::min(tileWindow.max.x, window.max.x), std::min(tileWindow.max.y, window.max.y)
+        );
+        std::size_t overlapWidth = static_cast<std::size_t>(overlapMax.x - overlapMin.x + 1);
+        std::size_t overlapHeight = static_cast<std::size_t>(overlapMax.y - overlapMin.y + 1);
+        copyPixels(
+          getRegion(
+            tileMemory,
+            static_cast<std::size_t>(overlapMin.x - tileWindow.min.x),
+            static_cast<std::size_t>(overlapMin.y - tileWindow.min.y),
+            overlapWidth, overlapHeight
+          ),
+          getRegion(
+            target,
+            static_cast<std::size_t>(overlapMin.x - window.min.x),
+            static_cast<std::size_t>(overlapMin.y - window.min.y),
+            overlapWidth, overlapHeight
+          )
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  #pragma region struct PixelSelection
+
+  /// <summary>Pixels and channels of an EXR image that will be loaded</summary>
+  struct PixelSelection {
+
+    /// <summary>Window of absolute pixel coordinates that will be read</summary>
+    public: Imath::Box2i Window;
+    /// <summary>Names of the channels that will be read, in bitmap channel order</summary>
+    public: std::vector<std::string> ChannelNames;
+    /// <summary>Bitmap memory matching the window's size</summary>
+    public: Nuclex::Pixels::BitmapMemory Target;
+
+  };
+
+  #pragma endregion // struct PixelSelection
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Selects the window and channels of an EXR image that will be loaded</summary>
+  /// <typeparam name="TGetTargetMethod">
+  ///   Method that will provide the bitmap memory the pixels will be decoded into
+  /// </typeparam>
+  /// <param name="header">Header of the EXR image or part that will be loaded</param>
+  /// <param name="options">Load options selecting the region and channels</param>
+  /// <param name="getTarget">
+  ///   Will be called with the EXR header and the window that will be loaded and must
+  ///   return bitmap memory matching the window's size
+  /// </param>
+  /// <returns>The window, channels and bitmap memory the image will be loaded into</returns>
+  template<typename TGetTargetMethod>
+  PixelSelection selectPixels(
+    const Imf::Header &header, const Nuclex::Pixels::Storage::LoadOptions &options,
+    TGetTargetMethod &getTarget
+  ) {
+    PixelSelection selection;
+    selection.ChannelNames = getChannelNames(header, options.Exr);
+    selection.Window = getLoadWindow(header.dataWindow(), options);
+    selection.Target = getTarget(header, selection.Window);
+
+    return selection;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens an EXR file and decodes the selected window of it</summary>
+  /// <typeparam name="TGetTargetMethod">
+  ///   Method that will provide the bitmap memory the pixels will be decoded into
+  /// </typeparam>
+  /// <param name="source">File the EXR image will be read from</param>
+  /// <param name="options">Load options selecting the threads, part, region and channels</param>
+  /// <param name="getTarget">
+  ///   Will be called with the EXR header and the window that will be loaded and must
+  ///   return bitmap memory matching the window's size
+  /// </param>
+  template<typename TGetTargetMethod>
+  void readExr(
+    const Nuclex::Pixels::Storage::VirtualFile &source,
+    const Nuclex::Pixels::Storage::LoadOptions &options,
+    TGetTargetMethod &&getTarget
+  ) {
+    using Nuclex::Pixels::Storage::Exr::Helpers;
+    using Nuclex::Pixels::Storage::Exr::VirtualFileInputStream;
+
+    // OpenEXR uses one global thread pool for all files. Only touch it if asked to.
+    if(options.Exr.ThreadCount >= 0) {
+      Imf::setGlobalThreadCount(options.Exr.ThreadCount);
+    }
+
+    std::uint8_t fileHeader[8];
+    source.ReadAt(0, 8, fileHeader);
+
+    PixelSelection selection;
+    VirtualFileInputStream inputStream(source);
+    if(Helpers::IsMultiPartExrHeader(fileHeader)) {
+      Imf::MultiPartInputFile multiPartFile(inputStream, Imf::globalThreadCount());
+      int part = getPartIndex(multiPartFile.parts(), options.Exr);
+
+      // Only the blocks of the selected part are read, the other parts are skipped
+      const Imf::Header &header = multiPartFile.header(part);
+      if(header.hasType() && Imf::isTiled(header.type())) {
+        Imf::TiledInputPart tiledPart(multiPartFile, part);
+        selection = selectPixels(tiledPart.header(), options, getTarget);
+        readTiles(tiledPart, selection.Window, selection.ChannelNames, selection.Target);
+      } else {
+        Imf::InputPart inputPart(multiPartFile, part);
+        selection = selectPixels(inputPart.header(), options, getTarget);
+        readScanlines(inputPart, selection.Window, selection.ChannelNames, selection.Target);
+      }
+    } else {
+      getPartIndex(1, options.Exr); // Single-part files only have part 0
+
+      if(Helpers::IsTiledExrHeader(fileHeader)) {
+        Imf::TiledInputFile tiledFile(inputStream, Imf::globalThreadCount());
+        selection = selectPixels(tiledFile.header(), options, getTarget);
+        readTiles(tiledFile, selection.Window, selection.ChannelNames, selection.Target);
+      } else {
+        Imf::InputFile inputFile(inputStream, Imf::globalThreadCount());
+        selection = selectPixels(inputFile.header(), options, getTarget);
+        readScanlines(inputFile, selection.Window, selection.ChannelNames, selection.Target);
+      }
+    }
+
+    fillUnselectedChannels(selection.Target, selection.ChannelNames.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row source that decodes the rows of an EXR file as they are read</summary>
+  /// <remarks>
+  ///   Tiled files are read through Imf::InputFile as well, which decodes the tiles
+  ///   covering the requested rows and hands them out as scanlines.
+  /// </remarks>
+  class ExrRowSource : public Nuclex::Pixels::RowSource {
+
+    /// <summary>Initializes a new EXR row source reading from the specified file</summary>
+    /// <param name="file">File the EXR image will be read from</param>
+    public: ExrRowSource(const Nuclex::Pixels::Storage::VirtualFile &file) :
+      inputStream(file),
+      inputFile(new Imf::InputFile(this->inputStream, Imf::globalThreadCount())) {
+      using Nuclex::Pixels::Storage::Exr::Helpers;
+
+      const Imath::Box2i &dataWindow = this->inputFile->header().dataWindow();
+      this->width = static_cast<std::size_t>(dataWindow.max.x - dataWindow.min.x + 1);
+      this->height = static_cast<std::size_t>(dataWindow.max.y - dataWindow.min.y + 1);
+      this->pixelFormat = Helpers::GetEquivalentPixelFormat(this->inputFile->header());
+      this->nextY = dataWindow.min.y;
+    }
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->width; }
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: std::size_t GetHeight() const override { return this->height; }
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->pixelFormat;
+    }
+
+    /// <summary>Decodes the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory that will receive the decoded rows</param>
+    public: void ReadRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      using Nuclex::Pixels::Storage::Exr::Helpers;
+
+      const Imath::Box2i &dataWindow = this->inputFile->header().dataWindow();
+      Nuclex::Pixels::RequireFittingRows(
+        rows, this->width, this->pixelFormat,
+        static_cast<std::size_t>(dataWindow.max.y - this->nextY + 1)
+      );
+      if(rows.Height == 0) {
+        return;
+      }
+
+      int lastY = this->nextY + static_cast<int>(rows.Height) - 1;
+      try {
+        Imf::FrameBuffer frameBuffer;
+        Helpers::AddChannelsToFrameBuffer(frameBuffer, rows, dataWindow.min.x, this->nextY);
+        this->inputFile->setFrameBuffer(frameBuffer);
+        this->inputFile->readPixels(this->nextY, lastY);
+      }
+      catch(const Iex::BaseExc &error) { // Convert exception to a FileFormatError
+        throw Nuclex::Pixels::Errors::FileFormatError(error.message());
+      }
+
+      this->nextY = lastY + 1;
+    }
+
+    /// <summary>Lets OpenEXR read from the virtual file</summary>
+    private: Nuclex::Pixels::Storage::Exr::VirtualFileInputStream inputStream;
+    /// <summary>OpenEXR file decoding the image</summary>
+    private: std::unique_ptr<Imf::InputFile> inputFile;
+    /// <summary>Width of the image in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the image in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Pixel format the rows are decoded in</summary>
+    private: Nuclex::Pixels::PixelFormat pixelFormat;
+    /// <summary>Absolute Y coordinate of the next row that will be decoded</summary>
+    private: int nextY;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row sink that compresses the rows written into it as an EXR file</summary>
+  class ExrRowSink : public Nuclex::Pixels::RowSink {
+
+    /// <summary>Initializes a new EXR row sink writing into the specified file</summary>
+    /// <param name="file">File the EXR image will be written into</param>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="pixelFormat">Pixel format the rows will be written in</param>
+    /// <param name="options">Options controlling how the image will be compressed</param>
+    public: ExrRowSink(
+      Nuclex::Pixels::Storage::VirtualFile &file,
+      std::size_t width, std::size_t height, Nuclex::Pixels::PixelFormat pixelFormat,
+      const Nuclex::Pixels::Storage::ExrSaveOptions &options
+    ) :
+      outputStream(file),
+      width(width),
+      height(height),
+      pixelFormat(pixelFormat),
+      nextY(0) {
+      using Nuclex::Pixels::PixelFormat;
+      using Nuclex::Pixels::Storage::Exr::Helpers;
+
+      // Like in Save(), half and float RGBA are written as they are, anything else
+      // is converted to half precision RGBA
+      bool isSupportedDirectly = (
+        (pixelFormat == PixelFormat::R16_G16_B16_A16_Float) ||
+        (pixelFormat == PixelFormat::R32_G32_B32_A32_Float)
+      );
+      if(isSupportedDirectly) {
+        this->channelPixelFormat = pixelFormat;
+      } else {
+        this->channelPixelFormat = PixelFormat::R16_G16_B16_A16_Float;
+      }
+
+      Imf::Compression compression = getExrCompression(options.Compression);
+      Imf::Header header(static_cast<int>(width), static_cast<int>(height));
+      header.compression() = compression;
+      if((compression == Imf::DWAA_COMPRESSION) || (compression == Imf::DWAB_COMPRESSION)) {
+        Imf::addDwaCompressionLevel(header, options.DwaCompressionLevel);
+      }
+
+      Imf::PixelType channelType = Helpers::GetChannelType(this->channelPixelFormat);
+      header.channels().insert("R", Imf::Channel(channelType));
+      header.channels().insert("G", Imf::Channel(channelType));
+      header.channels().insert("B", Imf::Channel(channelType));
+      header.channels().insert("A", Imf::Channel(channelType));
+
+      this->outputFile.reset(
+        new Imf::OutputFile(this->outputStream, header, Imf::globalThreadCount())
+      );
+    }
+
+    /// <summary>Retrieves the width of the rows the row sink accepts</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->width; }
+
+    /// <summary>Retrieves the number of rows the row sink accepts in total</summary>
+    /// <returns>The height of the image written into the row sink</returns>
+    public: std::size_t GetHeight() const override { return this->height; }
+
+    /// <summary>Retrieves the pixel format the row sink accepts rows in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->pixelFormat;
+    }
+
+    /// <summary>Compresses the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory holding the rows that will be compressed</param>
+    public: void WriteRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      Nuclex::Pixels::RequireFittingRows(
+        rows, this->width, this->pixelFormat,
+        this->height - static_cast<std::size_t>(this->nextY)
+      );
+      if(rows.Height == 0) {
+        return;
+      }
+
+      try {
+        if(this->channelPixelFormat == this->pixelFormat) {
+          writePixels(rows);
+        } else {
+          writeConvertedPixels(rows);
+        }
+
+        // OpenEXR writes the table of line offsets when the file is closed
+        if(static_cast<std::size_t>(this->nextY) == this->height) {
+          this->outputFile.reset();
+        }
+      }
+      catch(const Iex::BaseExc &error) { // Convert exception to a FileFormatError
+        throw Nuclex::Pixels::Errors::FileFormatError(error.message());
+      }
+    }
+
+    /// <summary>Hands rows in the channel pixel format over to OpenEXR</summary>
+    /// <param name="rows">Rows that will be written into the file</param>
+    private: void writePixels(const Nuclex::Pixels::BitmapMemory &rows) {
+      using Nuclex::Pixels::Storage::Exr::Helpers;
+
+      Imf::FrameBuffer frameBuffer;
+      Helpers::AddChannelsToFrameBuffer(frameBuffer, rows, 0, this->nextY);
+      this->outputFile->setFrameBuffer(frameBuffer);
+      this->outputFile->writePixels(static_cast<int>(rows.Height));
+
+      this->nextY += static_cast<int>(rows.Height);
+    }
+
+    /// <summary>Converts rows into the channel pixel format and writes them</summary>
+    /// <param name="rows">Rows that will be written into the file</param>
+    private: void writeConvertedPixels(const Nuclex::Pixels::BitmapMemory &rows) {
+      std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+        this->channelPixelFormat, this->width
+      );
+      if(this->buffer.empty()) {
+        std::size_t bandHeight = Nuclex::Pixels::GetBandHeight(rowByteCount);
+        this->buffer.resize(rowByteCount * std::min(bandHeight, this->height));
+      }
+      std::size_t bandHeight = this->buffer.size() / rowByteCount;
+
+      Nuclex::Pixels::BitmapMemory band;
+      band.Width = this->width;
+      band.Stride = static_cast<int>(rowByteCount);
+      band.PixelFormat = this->channelPixelFormat;
+      band.Pixels = this->buffer.data();
+
+      for(std::size_t y = 0; y < rows.Height; y += bandHeight) {
+        band.Height = std::min(bandHeight, rows.Height - y);
+        Nuclex::Pixels::PixelFormatConverter::Convert(
+          Nuclex::Pixels::GetBand(rows, y, band.Height), band
+        );
+        writePixels(band);
+      }
+    }
+
+    /// <summary>Lets OpenEXR write into the virtual file</summary>
+    private: Nuclex::Pixels::Storage::Exr::VirtualFileOutputStream outputStream;
+    /// <summary>OpenEXR file compressing the image, reset when it is complete</summary>
+    private: std::unique_ptr<Imf::OutputFile> outputFile;
+    /// <summary>Width of the image in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the image in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Pixel format the rows are written in</summary>
+    private: Nuclex::Pixels::PixelFormat pixelFormat;
+    /// <summary>Pixel format in which the channels are stored in the file</summary>
+    private: Nuclex::Pixels::PixelFormat channelPixelFormat;
+    /// <summary>Y coordinate of the next row that will be written</summary>
+    private: int nextY;
+    /// <summary>Holds a band of rows converted into the channel pixel format</summary>
+    private: std::vector<std::uint8_t> buffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
@@ -54,6 +791,18 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool ExrBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    if(fileHeaderByteCount < 8) {
+      return false; // Too short for the magic number and version field
+    }
+
+    return Helpers::IsValidExrHeader(fileHeader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   bool ExrBitmapCodec::CanLoad(
     const VirtualFile &source, const std::string &extensionHint /* = std::string() */
   ) const {
@@ -104,27 +853,32 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
   // ------------------------------------------------------------------------------------------- //
 
   bool ExrBitmapCodec::CanSave() const {
-    return false; // Still working in this...
+    return true;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   BitmapInfo ExrBitmapCodec::TryReadInfo(
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
     (void)extensionHint; // Unused
 
     VirtualFileInputStream inputStream(source);
     try {
-      Imf::InputFile inputFile(inputStream);
+      // Multi-part files are read through this as well as single-part files
+      Imf::MultiPartInputFile inputFile(inputStream);
+      const Imf::Header &header = inputFile.header(
+        getPartIndex(inputFile.parts(), options.Exr)
+      );
 
-      const Imath::Box2i &dataWindow = inputFile.header().dataWindow();
+      Imath::Box2i window = getLoadWindow(header.dataWindow(), options);
 
       BitmapInfo result;
       result.Loadable = true;
-      result.Width = static_cast<std::size_t>(dataWindow.max.x - dataWindow.min.x + 1);
-      result.Height = static_cast<std::size_t>(dataWindow.max.y - dataWindow.min.y + 1);
-      result.PixelFormat = PixelFormat::R16_G16_B16_A16_Float; // Always. See Imf::Rgba
+      result.Width = static_cast<std::size_t>(window.max.x - window.min.x + 1);
+      result.Height = static_cast<std::size_t>(window.max.y - window.min.y + 1);
+      result.PixelFormat = getPixelFormat(header, options.Exr);
       result.MemoryUsage = (
         (CountRequiredBytes(result.PixelFormat, result.Width) * result.Height) +
         (sizeof(std::intptr_t) * 3) +
@@ -142,86 +896,194 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
   // ------------------------------------------------------------------------------------------- //
 
   OptionalBitmap ExrBitmapCodec::TryLoad(
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.ExrBitmapCodec.TryLoad");
     (void)extensionHint; // Unused
 
-    VirtualFileInputStream inputStream(source);
+    OptionalBitmap result;
     try {
-      Imf::InputFile inputFile(inputStream);
-
-      const Imath::Box2i &dataWindow = inputFile.header().dataWindow();
-      std::size_t imageWidth = dataWindow.max.x - dataWindow.min.x + 1;
-      std::size_t imageHeight = dataWindow.max.y - dataWindow.min.y + 1;
-
-      // CHECK: OpenEXR has some intermedia 'YCA' format. When does this apply?
-
-      // TODO: Should be 16 bit float, not 8 bit signed integer
-      Bitmap result(imageWidth, imageHeight, PixelFormat::R16_G16_B16_A16_Float);
-      const BitmapMemory &memory = result.Access();
-
-      Imf::FrameBuffer frameBuffer;
-      Helpers::AddChannelsToFrameBuffer(frameBuffer, memory.PixelFormat, memory.Pixels);
-      inputFile.setFrameBuffer(frameBuffer);
-      inputFile.readPixels(dataWindow.min.y, dataWindow.max.y);
+      readExr(
+        source, options,
+        [&result, &options](const Imf::Header &header, const Imath::Box2i &window) {
+          Bitmap bitmap(
+            static_cast<std::size_t>(window.max.x - window.min.x + 1),
+            static_cast<std::size_t>(window.max.y - window.min.y + 1),
+            getPixelFormat(header, options.Exr)
+          );
 
-      return OptionalBitmap(std::move(result));
+          // The pixels stay where they are when the bitmap is moved into the optional
+          BitmapMemory memory = bitmap.Access();
+          result = OptionalBitmap(std::move(bitmap));
+          return memory;
+        }
+      );
     }
     catch(const Iex::BaseExc &error) { // Convert exception to a FileFormatError
       throw Errors::FileFormatError(error.message());
     }
+
+    return result;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   bool ExrBitmapCodec::TryReload(
     Bitmap &exactlyFittingBitmap,
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
-    (void)exactlyFittingBitmap;
-    (void)extensionHint;
-
     (void)extensionHint; // Unused
 
-    VirtualFileInputStream inputStream(source);
     try {
-      Imf::InputFile inputFile(inputStream);
+      readExr(
+        source, options,
+        [&exactlyFittingBitmap](const Imf::Header &header, const Imath::Box2i &window) {
+          (void)header;
 
-      const Imath::Box2i &dataWindow = inputFile.header().dataWindow();
-      std::size_t imageWidth = dataWindow.max.x - dataWindow.min.x + 1;
-      std::size_t imageHeight = dataWindow.max.y - dataWindow.min.y + 1;
+          // If OpenEXR works correctly, we can load:
+          // - Any R, G, B, A order or subset
+          // - UINT, HALF and FLOAT (8, 16, 32 bits)
+          const BitmapMemory &memory = exactlyFittingBitmap.Access();
+          bool sizeMatches = (
+            (static_cast<std::size_t>(window.max.x - window.min.x + 1) == memory.Width) &&
+            (static_cast<std::size_t>(window.max.y - window.min.y + 1) == memory.Height)
+          );
+          if(!sizeMatches) {
+            throw std::runtime_error(u8"Provided bitmap does not have the correct dimensions");
+          }
 
-      const BitmapMemory &memory = exactlyFittingBitmap.Access();
-      bool sizeMatches = (
-        (imageWidth == memory.Width) &&
-        (imageHeight == memory.Height)
+          return memory;
+        }
       );
-      if(!sizeMatches) {
-        throw std::runtime_error(u8"Provided bitmap does not have the correct dimensions");
+    }
+    catch(const Iex::BaseExc &error) { // Convert exception to a FileFormatError
+      throw Errors::FileFormatError(error.message());
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ExrBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    const ExrSaveOptions &exrOptions = options.Exr;
+    Imf::Compression compression = getExrCompression(exrOptions.Compression);
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"EXR files can not store empty bitmaps");
+    }
+
+    // Half and float RGBA bitmaps are handed to OpenEXR as they are. Anything else
+    // is converted to half precision RGBA first, which is what EXR files usually store.
+    Bitmap converted(1, 1, PixelFormat::R16_G16_B16_A16_Float);
+    const BitmapMemory *pixels = &memory;
+    {
+      bool isSupportedDirectly = (
+        (memory.PixelFormat == PixelFormat::R16_G16_B16_A16_Float) ||
+        (memory.PixelFormat == PixelFormat::R32_G32_B32_A32_Float)
+      );
+      if(!isSupportedDirectly) {
+        converted = Bitmap(memory.Width, memory.Height, PixelFormat::R16_G16_B16_A16_Float);
+        PixelFormatConverter::Convert(memory, converted.Access());
+        pixels = &converted.Access();
       }
+    }
+
+    // OpenEXR uses one global thread pool for all files. Only touch it if asked to.
+    if(exrOptions.ThreadCount >= 0) {
+      Imf::setGlobalThreadCount(exrOptions.ThreadCount);
+    }
 
-      // If OpenEXR works correctly, we can load:
-      // - Any R, G, B, A order or subset
-      // - UINT, HALF and FLOAT (8, 16, 32 bits)
+    try {
+      Imf::Header header(static_cast<int>(pixels->Width), static_cast<int>(pixels->Height));
+      header.compression() = compression;
+      if((compression == Imf::DWAA_COMPRESSION) || (compression == Imf::DWAB_COMPRESSION)) {
+        Imf::addDwaCompressionLevel(header, exrOptions.DwaCompressionLevel);
+      }
+
+      Imf::PixelType channelType = Helpers::GetChannelType(pixels->PixelFormat);
+      header.channels().insert("R", Imf::Channel(channelType));
+      header.channels().insert("G", Imf::Channel(channelType));
+      header.channels().insert("B", Imf::Channel(channelType));
+      header.channels().insert("A", Imf::Channel(channelType));
+
+      // The frame buffer points straight into the bitmap's memory, so OpenEXR picks
+      // up the pixels from where they are without any intermediate copies.
       Imf::FrameBuffer frameBuffer;
-      Helpers::AddChannelsToFrameBuffer(frameBuffer, memory.PixelFormat, memory.Pixels);
-      inputFile.setFrameBuffer(frameBuffer);
-      inputFile.readPixels(dataWindow.min.y, dataWindow.max.y);
+      Helpers::AddChannelsToFrameBuffer(frameBuffer, *pixels);
+
+      VirtualFileOutputStream outputStream(target);
+      Imf::OutputFile outputFile(outputStream, header, Imf::globalThreadCount());
+      outputFile.setFrameBuffer(frameBuffer);
+      outputFile.writePixels(static_cast<int>(pixels->Height));
     }
     catch(const Iex::BaseExc &error) { // Convert exception to a FileFormatError
       throw Errors::FileFormatError(error.message());
     }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSource> ExrBitmapCodec::TryOpenRowSource(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint;
+
+    bool selectsRegion = (
+      (options.Region.MaxX > options.Region.MinX) &&
+      (options.Region.MaxY > options.Region.MinY)
+    );
+    if(selectsRegion) {
+      throw std::invalid_argument(u8"Row sources can not be limited to a region of the image");
+    }
+
+    // Let OpenEXR only see files that are EXRs, it reports everything else by throwing
+    if(!CanLoad(source)) {
+      return std::unique_ptr<RowSource>();
+    }
+
+    // OpenEXR uses one global thread pool for all files. Only touch it if asked to.
+    if(options.Exr.ThreadCount >= 0) {
+      Imf::setGlobalThreadCount(options.Exr.ThreadCount);
+    }
 
-    throw std::runtime_error(u8"Not implemented yet");
+    try {
+      return std::unique_ptr<RowSource>(new ExrRowSource(source));
+    }
+    catch(const Iex::BaseExc &error) { // Convert exception to a FileFormatError
+      throw Errors::FileFormatError(error.message());
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void ExrBitmapCodec::Save(const Bitmap &bitmap, VirtualFile &target) const {
-    (void)bitmap;
-    (void)target;
+  std::unique_ptr<RowSink> ExrBitmapCodec::OpenRowSink(
+    VirtualFile &target, std::size_t width, std::size_t height, PixelFormat pixelFormat,
+    const SaveOptions &options /* = SaveOptions() */
+  ) const {
+    if((width == 0) || (height == 0)) {
+      throw std::invalid_argument(u8"EXR files can not store empty bitmaps");
+    }
+
+    // OpenEXR uses one global thread pool for all files. Only touch it if asked to.
+    if(options.Exr.ThreadCount >= 0) {
+      Imf::setGlobalThreadCount(options.Exr.ThreadCount);
+    }
 
-    throw std::runtime_error(u8"Not implemented yet");
+    try {
+      return std::unique_ptr<RowSink>(
+        new ExrRowSink(target, width, height, pixelFormat, options.Exr)
+      );
+    }
+    catch(const Iex::BaseExc &error) { // Convert exception to a FileFormatError
+      throw Errors::FileFormatError(error.message());
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
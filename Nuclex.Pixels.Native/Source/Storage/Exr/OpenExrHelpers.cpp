@@ -29,6 +29,7 @@ License along with this library
 
 #include <cassert>
 #include <algorithm>
+#include <stdexcept> // for std::invalid_argument
 
 namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
 
@@ -45,7 +46,7 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
       (fileHeader[3] == 0x01) &&         // 1
       (fileHeader[4] == 0x02) &&         // 2 EXR_VERSION (file format version)
       (
-        (fileHeader[5] == 0x00) &&       // 3 Flags
+        ((fileHeader[5] & 0xE9) == 0) && // 3 Flags (tiled, long names, multi-part okay)
         ((fileHeader[6] & 0xE1) == 0) && // 3
         (fileHeader[7] == 0x00)          // 3
       )
@@ -55,28 +56,75 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
 
   // ------------------------------------------------------------------------------------------- //
 
-  void Helpers::AddChannelsToFrameBuffer(
-    Imf::FrameBuffer &frameBuffer, PixelFormat pixelFormat, void *pixels
+  bool Helpers::IsTiledExrHeader(const std::uint8_t *fileHeader) {
+    return ((fileHeader[5] & 0x02) != 0); // Bit 9 of the version field, TILED_FLAG
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Helpers::IsMultiPartExrHeader(const std::uint8_t *fileHeader) {
+    return ((fileHeader[5] & 0x10) != 0); // Bit 12 of the version field, MULTI_PART_FILE_FLAG
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PixelFormat Helpers::GetEquivalentPixelFormat(const Imf::Header &header) {
+    const Imf::ChannelList &channels = header.channels();
+
+    // Half precision is enough unless any channel stores more than that
+    for(
+      Imf::ChannelList::ConstIterator iterator = channels.begin();
+      iterator != channels.end();
+      ++iterator
+    ) {
+      if(iterator.channel().type != Imf::HALF) {
+        return PixelFormat::R32_G32_B32_A32_Float;
+      }
+    }
+
+    return PixelFormat::R16_G16_B16_A16_Float;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PixelFormat Helpers::GetEquivalentPixelFormat(
+    const Imf::Header &header, const std::vector<std::string> &channelNames
   ) {
-    static const std::string redChannelName("R", 1);
-    static const std::string greenChannelName("G", 1);
-    static const std::string blueChannelName("B", 1);
-    static const std::string alphaChannelName("A", 1);
-    
-    // TODO: I haven't filled this yet because I'm remaking the whole PixelFormat enum
-    switch(pixelFormat) {
-      case PixelFormat::R16_G16_B16_A16_Float: {
-        std::uint16_t *pixelsAsHalf = reinterpret_cast<std::uint16_t *>(pixels);
-        char *redBaseAddress = reinterpret_cast<char *>(&pixelsAsHalf[0]);
-        char *greenBaseAddress = reinterpret_cast<char *>(&pixelsAsHalf[1]);
-        char *blueBaseAddress = reinterpret_cast<char *>(&pixelsAsHalf[2]);
-        char *alphaBaseAddress = reinterpret_cast<char *>(&pixelsAsHalf[3]);
-        frameBuffer.insert(redChannelName, Imf::Slice(Imf::HALF, redBaseAddress, 64, 0));
-        frameBuffer.insert(greenChannelName, Imf::Slice(Imf::HALF, greenBaseAddress, 64, 0));
-        frameBuffer.insert(blueChannelName, Imf::Slice(Imf::HALF, blueBaseAddress, 64, 0));
-        frameBuffer.insert(alphaChannelName, Imf::Slice(Imf::HALF, alphaBaseAddress, 64, 0));
-        return;
+    const Imf::ChannelList &channels = header.channels();
+
+    // Channels missing from the file are filled in by OpenEXR and don't count
+    bool needsFullPrecision = false;
+    for(std::size_t index = 0; index < channelNames.size(); ++index) {
+      const Imf::Channel *channel = channels.findChannel(channelNames[index]);
+      if((channel != nullptr) && (channel->type != Imf::HALF)) {
+        needsFullPrecision = true;
       }
+    }
+
+    if(channelNames.size() == 1) {
+      if(needsFullPrecision) {
+        return PixelFormat::R32_Float_Native32;
+      } else {
+        return PixelFormat::R16_Float_Native16;
+      }
+    } else if((channelNames.size() == 2) && !needsFullPrecision) {
+      return PixelFormat::R16_G16_Float_Native16;
+    } else if(needsFullPrecision) {
+      return PixelFormat::R32_G32_B32_A32_Float;
+    } else {
+      return PixelFormat::R16_G16_B16_A16_Float;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Imf::PixelType Helpers::GetChannelType(PixelFormat pixelFormat) {
+    switch(pixelFormat) {
+      case PixelFormat::R16_Float_Native16:
+      case PixelFormat::R16_G16_Float_Native16:
+      case PixelFormat::R16_G16_B16_A16_Float: { return Imf::HALF; }
+      case PixelFormat::R32_Float_Native32:
+      case PixelFormat::R32_G32_B32_A32_Float: { return Imf::FLOAT; }
       default: {
         throw Errors::FileFormatError(u8"Requested pixel format not supported by OpenEXR");
       }
@@ -85,6 +133,54 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void Helpers::AddChannelsToFrameBuffer(
+    Imf::FrameBuffer &frameBuffer, const BitmapMemory &memory,
+    int originX /* = 0 */, int originY /* = 0 */
+  ) {
+    static const std::vector<std::string> rgbaChannelNames = {
+      std::string("R", 1), std::string("G", 1), std::string("B", 1), std::string("A", 1)
+    };
+
+    AddChannelsToFrameBuffer(frameBuffer, memory, rgbaChannelNames, originX, originY);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Helpers::AddChannelsToFrameBuffer(
+    Imf::FrameBuffer &frameBuffer, const BitmapMemory &memory,
+    const std::vector<std::string> &channelNames,
+    int originX /* = 0 */, int originY /* = 0 */
+  ) {
+    Imf::PixelType channelType = GetChannelType(memory.PixelFormat);
+    std::size_t channelSize = (channelType == Imf::HALF) ? 2 : 4;
+    std::size_t pixelSize = CountBitsPerPixel(memory.PixelFormat) / 8;
+    std::size_t channelCount = pixelSize / channelSize;
+    std::size_t rowSize = static_cast<std::size_t>(memory.Stride);
+    if(channelNames.size() > channelCount) {
+      throw std::invalid_argument(u8"Bitmap has fewer channels than were selected for loading");
+    }
+
+    // Slices address pixel (x, y) as base + x * pixelSize + y * rowSize. Negative
+    // strides wrap around when converted to size_t, the multiplication then also
+    // wraps around and arrives at the correct address. OpenEXR uses absolute
+    // coordinates, so the base is moved to where pixel (0, 0) would be.
+    char *pixels = reinterpret_cast<char *>(memory.Pixels) - (
+      static_cast<std::ptrdiff_t>(originX) * static_cast<std::ptrdiff_t>(pixelSize) +
+      static_cast<std::ptrdiff_t>(originY) * static_cast<std::ptrdiff_t>(memory.Stride)
+    );
+    for(std::size_t index = 0; index < channelNames.size(); ++index) {
+      double fillValue = (index == 3) ? 1.0 : 0.0; // Images without alpha become opaque
+      frameBuffer.insert(
+        channelNames[index],
+        Imf::Slice(
+          channelType, pixels + channelSize * index, pixelSize, rowSize, 1, 1, fillValue
+        )
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Pixels::Storage::Exr
 
 #endif // defined(NUCLEX_PIXELS_HAVE_OPENEXR)
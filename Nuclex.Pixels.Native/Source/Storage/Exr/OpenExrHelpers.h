@@ -25,10 +25,15 @@ License along with this library
 
 #if defined(NUCLEX_PIXELS_HAVE_OPENEXR)
 
+#include "Nuclex/Pixels/BitmapMemory.h"
 #include "Nuclex/Pixels/PixelFormat.h"
 #include "Nuclex/Pixels/Storage/VirtualFile.h"
 
 #include <cstdint>
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::logic_error
+#include <string> // for std::string
+#include <vector> // for std::vector
 
 // Sadly, OpenEXR has lots of really poor programming practices and
 // also doesn't seem to care much about compiler warnings...
@@ -46,6 +51,17 @@ License along with this library
 #include <IlmImf/ImfIO.h>
 #include <IlmImf/ImfFrameBuffer.h>
 #include <IlmImf/ImfInputFile.h>
+#include <IlmImf/ImfTiledInputFile.h>
+#include <IlmImf/ImfMultiPartInputFile.h>
+#include <IlmImf/ImfInputPart.h>
+#include <IlmImf/ImfTiledInputPart.h>
+#include <IlmImf/ImfPartType.h>
+#include <IlmImf/ImfOutputFile.h>
+#include <IlmImf/ImfHeader.h>
+#include <IlmImf/ImfChannelList.h>
+#include <IlmImf/ImfCompression.h>
+#include <IlmImf/ImfStandardAttributes.h>
+#include <IlmImf/ImfThreading.h>
 #include <IlmImf/ImfArray.h>
 #include <IlmImf/ImfRgba.h>
 #if defined(_MSC_VER)
@@ -85,16 +101,79 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
     /// </remarks>
     public: static bool IsValidExrHeader(const std::uint8_t *fileHeader);
 
-    /// <summary>Sets up an OpenEXR frame buffer matching the specified pixel format</summary>
+    /// <summary>Checks whether an .exr file header indicates a tiled image</summary>
+    /// <param name="fileHeader">File header that will be checked</param>
+    /// <returns>True if the image is stored as tiles rather than scanlines</returns>
+    /// <remarks>
+    ///   The file header must contain at least the first 8 bytes of the file and
+    ///   should have been checked with <see cref="IsValidExrHeader" /> before.
+    /// </remarks>
+    public: static bool IsTiledExrHeader(const std::uint8_t *fileHeader);
+
+    /// <summary>Checks whether an .exr file header indicates a multi-part file</summary>
+    /// <param name="fileHeader">File header that will be checked</param>
+    /// <returns>True if the file stores several parts, each with its own header</returns>
+    /// <remarks>
+    ///   The file header must contain at least the first 8 bytes of the file and
+    ///   should have been checked with <see cref="IsValidExrHeader" /> before.
+    /// </remarks>
+    public: static bool IsMultiPartExrHeader(const std::uint8_t *fileHeader);
+
+    /// <summary>Finds the supported pixel format that is closest to the image's</summary>
+    /// <param name="header">Header of the EXR image</param>
+    /// <returns>The pixel format that can hold the image's channels without loss</returns>
+    public: static PixelFormat GetEquivalentPixelFormat(const Imf::Header &header);
+
+    /// <summary>Finds the supported pixel format that is closest to some channels</summary>
+    /// <param name="header">Header of the EXR image</param>
+    /// <param name="channelNames">Names of the channels that will be loaded</param>
+    /// <returns>
+    ///   The pixel format with the fewest channels that can hold the selected channels
+    ///   without loss
+    /// </returns>
+    public: static PixelFormat GetEquivalentPixelFormat(
+      const Imf::Header &header, const std::vector<std::string> &channelNames
+    );
+
+    /// <summary>Looks up the OpenEXR channel type for a pixel format</summary>
+    /// <param name="pixelFormat">Pixel format whose channel type will be returned</param>
+    /// <returns>The OpenEXR channel type matching the pixel format's channels</returns>
+    /// <remarks>
+    ///   Throws an exception if the pixel format can not be used with OpenEXR directly.
+    /// </remarks>
+    public: static Imf::PixelType GetChannelType(PixelFormat pixelFormat);
+
+    /// <summary>Sets up an OpenEXR frame buffer accessing the specified bitmap memory</summary>
     /// <param name="frameBuffer">Frame buffer that will be set up</param>
-    /// <param name="pixelFormat">Pixel format the frame buffer will be set to</param>
-    /// <param name="pixels">Address of the pixel buffer the frame buffer will use</param>
+    /// <param name="memory">Bitmap memory the frame buffer will access</param>
+    /// <param name="originX">Absolute X coordinate of the bitmap's left pixel column</param>
+    /// <param name="originY">Absolute Y coordinate of the bitmap's top pixel row</param>
     /// <remarks>
     ///   OpenEXR allows the frame buffer format to be set relatively freely (if one
     ///   foregoes the RgbaInputFile wrapper). This method makes use of that feature.
+    ///   The slices point directly into the bitmap memory, so OpenEXR reads or writes
+    ///   the pixels in place, honoring the bitmap's stride.
     /// </remarks>
     public: static void AddChannelsToFrameBuffer(
-      Imf::FrameBuffer &frameBuffer, PixelFormat pixelFormat, void *pixels
+      Imf::FrameBuffer &frameBuffer, const BitmapMemory &memory,
+      int originX = 0, int originY = 0
+    );
+
+    /// <summary>Sets up an OpenEXR frame buffer accessing the specified bitmap memory</summary>
+    /// <param name="frameBuffer">Frame buffer that will be set up</param>
+    /// <param name="memory">Bitmap memory the frame buffer will access</param>
+    /// <param name="channelNames">
+    ///   Names of the channels that will be stored in the bitmap's channels, in order
+    /// </param>
+    /// <param name="originX">Absolute X coordinate of the bitmap's left pixel column</param>
+    /// <param name="originY">Absolute Y coordinate of the bitmap's top pixel row</param>
+    /// <remarks>
+    ///   If fewer channel names than the bitmap has channels are provided, OpenEXR
+    ///   leaves the remaining channels of the bitmap untouched.
+    /// </remarks>
+    public: static void AddChannelsToFrameBuffer(
+      Imf::FrameBuffer &frameBuffer, const BitmapMemory &memory,
+      const std::vector<std::string> &channelNames, int originX = 0, int originY = 0
     );
 
   };
@@ -110,39 +189,61 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
       IStream(u8"VirtualFile adapter stream"),
       file(file),
       position(0),
-      length(file.GetSize()) {}
+      length(file.GetSize()) {
+      this->contents = file.TryGetContiguousSpan(0, static_cast<std::size_t>(this->length));
+    }
 
     /// <summary>Frees all resources owned by the virtual file steam</summary>
     public: virtual ~VirtualFileInputStream() = default;
 
     /// <summary>Does this input stream support memory-mapped IO?</summary>
-    public: bool isMemoryMapped() const override { return false; }
+    /// <remarks>
+    ///   If the virtual file provides its contents in memory, OpenEXR is allowed to
+    ///   decode straight from them instead of having data copied into its own buffers.
+    /// </remarks>
+    public: bool isMemoryMapped() const override { return (this->contents != nullptr); }
 
     /// <summary>Read from the stream</summary>
     /// <param name="buffer">Buffer in which the data will be stored</param>
     /// <param name="byteCount">Number of bytes that will be read</param>
     /// <returns>Whether more bytes are available from the file</returns>
     public: bool read(char buffer[/*byteCount*/], int byteCount) override {
-      this->file.ReadAt(
-        this->position, byteCount, reinterpret_cast<std::uint8_t *>(buffer)
-      );
-      this->position += byteCount;
+      if(this->contents == nullptr) {
+        this->file.ReadAt(
+          this->position, byteCount, reinterpret_cast<std::uint8_t *>(buffer)
+        );
+        this->position += byteCount;
+      } else { // readMemoryMapped() checks the bounds and advances the file cursor
+        std::memcpy(buffer, readMemoryMapped(byteCount), byteCount);
+      }
 
       return (this->position < this->length);
     }
 
-    /// <summary>Throws an exception if a memory-mapped read is attempted</summary>
+    /// <summary>Reads from the file's contents without copying them</summary>
     /// <param name="byteCount">Numeber of bytes to read from the file</param>
     /// <returns>Address containing the memory-mapped file's data</returns>
     public: char *readMemoryMapped(int byteCount) override {
-      (void)byteCount; // Unused
-      throw std::logic_error(u8"Stream is not memory mapped");
+      if(this->contents == nullptr) {
+        throw std::logic_error(u8"Stream is not memory mapped");
+      }
+      if(
+        (byteCount < 0) ||
+        (static_cast<std::uint64_t>(byteCount) > this->length - this->position)
+      ) {
+        throw std::runtime_error(u8"Attempt to read past end of file");
+      }
+
+      // OpenEXR's signature isn't const-correct, but it only reads from the memory
+      const std::uint8_t *data = this->contents + this->position;
+      this->position += byteCount;
+      return const_cast<char *>(reinterpret_cast<const char *>(data));
     }
 
     /// <summary>Looks up the current position of the file cursor</summary>
     /// <returns>The current position of the file cursor</returns>
     public: Imf::Int64 tellg() override { // Signed? Non-const? WTF?!
-      return static_cast<std::uint64_t>(this->length);
+      return static_cast<Imf::Int64>(this->position);
     }
 
     /// <summary>Moves the file cursor to the specified position</summary>
@@ -161,6 +262,56 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Exr {
     private: std::uint64_t position;
     /// <summary>Total length of the file in bytes</summary>
     private: std::uint64_t length;
+    /// <summary>Contents of the file if it is held in memory, otherwise null</summary>
+    private: const std::uint8_t *contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adapter that allows OpenEXR to write into a VirtualFile as an OStream</summary>
+  class VirtualFileOutputStream : public Imf::OStream {
+
+    /// <summary>Initializes a new VirtualFile OStream adapter</summary>
+    /// <param name="file">File into which the OStream adapter will write</param>
+    public: VirtualFileOutputStream(Nuclex::Pixels::Storage::VirtualFile &file) :
+      OStream(u8"VirtualFile adapter stream"),
+      file(file),
+      position(0) {}
+
+    /// <summary>Frees all resources owned by the virtual file steam</summary>
+    public: virtual ~VirtualFileOutputStream() = default;
+
+    /// <summary>Writes data into the stream</summary>
+    /// <param name="buffer">Buffer holding the data that will be written</param>
+    /// <param name="byteCount">Number of bytes that will be written</param>
+    public: void write(const char buffer[/*byteCount*/], int byteCount) override {
+      this->file.WriteAt(
+        this->position, byteCount, reinterpret_cast<const std::uint8_t *>(buffer)
+      );
+      this->position += byteCount;
+    }
+
+    /// <summary>Looks up the current position of the file cursor</summary>
+    /// <returns>The current position of the file cursor</returns>
+    public: Imf::Int64 tellp() override {
+      return static_cast<Imf::Int64>(this->position);
+    }
+
+    /// <summary>Moves the file cursor to the specified position</summary>
+    /// <param name="position">Position the file cursor will be moved to</param>
+    /// <remarks>
+    ///   OpenEXR seeks back to fill in the line offset table once all scanlines
+    ///   have been written.
+    /// </remarks>
+    public: void seekp(Imf::Int64 newPosition) override {
+      this->position = static_cast<std::uint64_t>(newPosition);
+    }
+
+    /// <summary>Virtual file into which the OStream adapter is writing</summary>
+    private: Nuclex::Pixels::Storage::VirtualFile &file;
+    /// <summary>Current position of the file pointer</summary>
+    private: std::uint64_t position;
 
   };
 
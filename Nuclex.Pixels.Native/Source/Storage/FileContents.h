@@ -0,0 +1,90 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_FILECONTENTS_H
+#define NUCLEX_PIXELS_STORAGE_FILECONTENTS_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint64_t
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides the whole contents of a file as a single block of memory</summary>
+  /// <remarks>
+  ///   For codecs of file formats that have to be decoded in one piece. Files that are
+  ///   held in memory (memory-mapped files and files wrapping a buffer) hand out their
+  ///   contents directly, all other files are read into a buffer once.
+  /// </remarks>
+  class FileContents {
+
+    /// <summary>Obtains the contents of the specified file</summary>
+    /// <param name="file">File whose contents will be provided</param>
+    public: explicit FileContents(const VirtualFile &file) :
+      data(nullptr),
+      size(0) {
+      std::uint64_t fileSize = file.GetSize();
+      if(fileSize > std::numeric_limits<std::size_t>::max()) {
+        throw std::runtime_error(u8"File is too large to be held in memory");
+      }
+
+      this->size = static_cast<std::size_t>(fileSize);
+      if(this->size > 0) {
+        this->data = file.TryGetContiguousSpan(0, this->size);
+        if(this->data == nullptr) {
+          this->buffer.resize(this->size);
+          file.ReadAt(0, this->size, &this->buffer[0]);
+          this->data = &this->buffer[0];
+        }
+      }
+    }
+
+    /// <summary>Retrieves the address of the file's first byte</summary>
+    /// <returns>The address of the first byte in the file, null if the file is empty</returns>
+    public: const std::uint8_t *GetData() const { return this->data; }
+
+    /// <summary>Retrieves the size of the file</summary>
+    /// <returns>The number of bytes in the file</returns>
+    public: std::size_t GetSize() const { return this->size; }
+
+    private: FileContents(const FileContents &) = delete;
+    private: FileContents &operator =(const FileContents &) = delete;
+
+    /// <summary>Address of the file's first byte</summary>
+    private: const std::uint8_t *data;
+    /// <summary>Number of bytes in the file</summary>
+    private: std::size_t size;
+    /// <summary>Copy of the file's contents if the file is not held in memory</summary>
+    private: std::vector<std::uint8_t> buffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_FILECONTENTS_H
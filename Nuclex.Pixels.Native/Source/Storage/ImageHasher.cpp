@@ -0,0 +1,157 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/ImageHasher.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Storage/JpegPlanes.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/BitmapAnalyzer.h"
+
+#include <algorithm> // for std::min()
+#include <memory> // for std::unique_ptr
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Width and height the perceptual hash reduces images to</summary>
+  const std::size_t PerceptualHashMinimumSize = 32;
+
+  /// <summary>Width and height the difference hash reduces images to (rounded up)</summary>
+  const std::size_t DifferenceHashMinimumSize = 9;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hashing method that reduces a bitmap to 64 bits</summary>
+  typedef std::uint64_t HashMethod(const Nuclex::Pixels::BitmapMemory &memory);
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  /// <summary>Checks whether a file starts with the signature of a JPEG file</summary>
+  /// <param name="file">File whose first bytes will be checked</param>
+  /// <returns>True if the file looks like a JPEG file</returns>
+  bool hasJpegSignature(const Nuclex::Pixels::Storage::VirtualFile &file) {
+    if(file.GetSize() < 3) {
+      return false;
+    }
+
+    std::uint8_t signature[3];
+    file.ReadAt(0, 3, signature);
+    return (signature[0] == 0xFF) && (signature[1] == 0xD8) && (signature[2] == 0xFF);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  /// <summary>Selects the smallest JPEG decoding scale that leaves enough pixels</summary>
+  /// <param name="width">Width of the image at full size</param>
+  /// <param name="height">Height of the image at full size</param>
+  /// <param name="minimumSize">Number of pixels the image should keep on each axis</param>
+  /// <returns>The JPEG decoding scale that should be used</returns>
+  Nuclex::Pixels::Storage::JpegLoadScale selectJpegScale(
+    std::size_t width, std::size_t height, std::size_t minimumSize
+  ) {
+    using Nuclex::Pixels::Storage::JpegLoadScale;
+
+    std::size_t smallerSide = std::min(width, height);
+    if(smallerSide >= minimumSize * 8) {
+      return JpegLoadScale::Eighth;
+    } else if(smallerSide >= minimumSize * 4) {
+      return JpegLoadScale::Quarter;
+    } else if(smallerSide >= minimumSize * 2) {
+      return JpegLoadScale::Half;
+    } else {
+      return JpegLoadScale::Full;
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes as much of an image file as needed and hashes it</summary>
+  /// <param name="serializer">Bitmap serializer used to load files other than JPEG</param>
+  /// <param name="path">Path of the image file that will be hashed</param>
+  /// <param name="hash">Hashing method that will be applied to the image</param>
+  /// <param name="minimumSize">Number of pixels the hash needs on each axis</param>
+  /// <returns>The hash of the image</returns>
+  std::uint64_t hashFile(
+    const Nuclex::Pixels::Storage::BitmapSerializer &serializer, const std::string &path,
+    HashMethod *hash, std::size_t minimumSize
+  ) {
+    using Nuclex::Pixels::Storage::VirtualFile;
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::OpenMemoryMappedFileForReading(path);
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+    if(hasJpegSignature(*file)) {
+      Nuclex::Pixels::BitmapInfo info = serializer.TryReadInfo(*file, u8"jpg");
+      if(info.Loadable) {
+        Nuclex::Pixels::Storage::LoadOptions options;
+        options.Jpeg.Scale = selectJpegScale(info.Width, info.Height, minimumSize);
+
+        // The first plane is the luminance (Y) component, which is all the hash looks at
+        Nuclex::Pixels::Storage::JpegPlanes planes = (
+          Nuclex::Pixels::Storage::JpegPlanes::Load(*file, options)
+        );
+        return hash(planes.GetPlane(0).Access());
+      }
+    }
+#else
+    (void)minimumSize;
+#endif
+
+    Nuclex::Pixels::Bitmap bitmap = serializer.Load(*file);
+    return hash(bitmap.Access());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t ImageHasher::ComputeDifferenceHash(
+    const BitmapSerializer &serializer, const std::string &path
+  ) {
+    return hashFile(
+      serializer, path, &BitmapAnalyzer::ComputeDifferenceHash, DifferenceHashMinimumSize
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t ImageHasher::ComputePerceptualHash(
+    const BitmapSerializer &serializer, const std::string &path
+  ) {
+    return hashFile(
+      serializer, path, &BitmapAnalyzer::ComputePerceptualHash, PerceptualHashMinimumSize
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
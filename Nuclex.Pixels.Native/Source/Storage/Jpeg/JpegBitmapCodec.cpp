@@ -26,11 +26,20 @@ License along with this library
 #if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
 
 #include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Storage/DecodeContext.h"
 #include "Nuclex/Pixels/Errors/FileFormatError.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
 #include "LibJpegHelpers.h"
+#include "../../RowStreamHelpers.h"
+#include "../../InstrumentationHelpers.h"
 
 #include <cassert>
 #include <algorithm>
+#include <csetjmp> // for std::jmp_buf, std::longjmp()
+#include <cstring> // for std::memcpy()
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
 
 #include <jpeglib.h>
 
@@ -69,21 +78,137 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>RAII helper that frees a JPEG decompression structure upon scope exit</summary>
-  class JpegDecompressStructScope {
+  /// <summary>Handles an error inside libjpeg while a file header is being probed</summary>
+  /// <param name="cinfo">Main structure containing all libjpeg configuration</param>
+  /// <remarks>
+  ///   Jumps back to the point set up by <see cref="tryReadJpegHeader" />, so that
+  ///   files which merely look like JPEGs are rejected without an exception.
+  /// </remarks>
+  void jumpOnJpegError(struct ::jpeg_common_struct *cinfo) {
+    std::longjmp(*static_cast<std::jmp_buf *>(cinfo->client_data), 1);
+  }
 
-    /// <summary>Frees a JPEG decompression structure upon termination</summary>
-    /// <param name="commonInfo">JPEG decompression structure that will be freed</summary>
-    public: JpegDecompressStructScope(::jpeg_decompress_struct *commonInfo) :
-      commonInfo(commonInfo) {}
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>RAII helper that lets libjpeg errors jump out instead of throwing</summary>
+  class JpegErrorJumpScope {
+
+    /// <summary>Redirects libjpeg errors to a jump buffer until the scope ends</summary>
+    /// <param name="commonInfo">JPEG decompression structure whose errors are redirected</param>
+    /// <param name="errorJump">Jump buffer the error handler will jump to</param>
+    public: JpegErrorJumpScope(::jpeg_decompress_struct &commonInfo, std::jmp_buf &errorJump) :
+      commonInfo(commonInfo),
+      previousErrorExit(commonInfo.err->error_exit) {
+      commonInfo.client_data = &errorJump;
+      commonInfo.err->error_exit = &jumpOnJpegError;
+    }
+
+    /// <summary>Lets libjpeg errors throw exceptions again</summary>
+    public: ~JpegErrorJumpScope() {
+      this->commonInfo.err->error_exit = this->previousErrorExit;
+      this->commonInfo.client_data = nullptr;
+    }
+
+    /// <summary>JPEG decompression structure whose errors are redirected</summary>
+    private: ::jpeg_decompress_struct &commonInfo;
+    /// <summary>Error handler that was installed before the scope began</summary>
+    private: void (*previousErrorExit)(struct ::jpeg_common_struct *);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the header of a JPEG file without throwing on errors</summary>
+  /// <param name="commonInfo">JPEG decompression structure set up to read the file</param>
+  /// <returns>True if the header was read, false if libjpeg could not read it</returns>
+  /// <remarks>
+  ///   When a directory of mixed files is scanned, files that look like JPEGs but are not
+  ///   are common enough that throwing and unwinding an exception for each of them shows.
+  ///   libjpeg's error handler is therefore set up to longjmp() back here, which is safe
+  ///   because only libjpeg's own C stack frames are skipped. Exceptions thrown by
+  ///   the data source (i.e. I/O errors) still pass through.
+  /// </remarks>
+  bool tryReadJpegHeader(::jpeg_decompress_struct &commonInfo) {
+    std::jmp_buf errorJump;
+    JpegErrorJumpScope errorJumpScope(commonInfo, errorJump);
+    if(setjmp(errorJump) != 0) {
+      return false;
+    }
+
+    return (::jpeg_read_header(&commonInfo, TRUE) == JPEG_HEADER_OK);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>JPEG decompression structure that can be kept in a decode context</summary>
+  class JpegDecodeState : public Nuclex::Pixels::Storage::DecodeContext::State {
+
+    /// <summary>Creates a new JPEG decompression structure</summary>
+    public: JpegDecodeState() {
+      // Set up a custom error manager that throws exceptions rather than exit().
+      // jpeg_create_decompress() already reports errors through it.
+      ::jpeg_std_error(&this->errorManager);
+      this->errorManager.error_exit = &handleJpegError;
+      this->CommonInfo.err = &this->errorManager;
+
+      ::jpeg_create_decompress(&this->CommonInfo);
+    }
 
     /// <summary>Frees the JPEG decompression structure</summary>
-    public: ~JpegDecompressStructScope() {
-      ::jpeg_destroy_decompress(this->commonInfo);
+    public: ~JpegDecodeState() override {
+      ::jpeg_destroy_decompress(&this->CommonInfo);
+    }
+
+    /// <summary>Main structure containing all libjpeg configuration</summary>
+    public: ::jpeg_decompress_struct CommonInfo;
+    /// <summary>Error manager that turns libjpeg errors into exceptions</summary>
+    private: ::jpeg_error_mgr errorManager;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>RAII helper that provides a JPEG decompression structure for one load</summary>
+  /// <remarks>
+  ///   If the load options carry a decode context, the decompression structure kept in
+  ///   the context is used and merely reset upon scope exit, so libjpeg can reuse its
+  ///   permanent memory pool and tables for the next image. Otherwise, a new structure
+  ///   is created and destroyed again upon scope exit.
+  /// </remarks>
+  class JpegDecompressScope {
+
+    /// <summary>Provides a JPEG decompression structure until the scope ends</summary>
+    /// <param name="codec">Codec under which the structure is kept in the context</param>
+    /// <param name="options">Load options that may provide a decode context</param>
+    public: JpegDecompressScope(
+      const Nuclex::Pixels::Storage::BitmapCodec &codec,
+      const Nuclex::Pixels::Storage::LoadOptions &options
+    ) {
+      if(options.Context == nullptr) {
+        this->ownedState.reset(new JpegDecodeState());
+        this->state = this->ownedState.get();
+      } else {
+        this->state = &options.Context->Acquire<JpegDecodeState>(codec);
+      }
+    }
+
+    /// <summary>Destroys or resets the JPEG decompression structure</summary>
+    public: ~JpegDecompressScope() {
+      if(!this->ownedState) {
+        ::jpeg_abort_decompress(&this->state->CommonInfo);
+      }
+    }
+
+    /// <summary>Accesses the JPEG decompression structure</summary>
+    /// <returns>The JPEG decompression structure for the current load</returns>
+    public: ::jpeg_decompress_struct &GetCommonInfo() {
+      return this->state->CommonInfo;
     }
 
-    /// <summary>JPEG decompression structure that will be freed</summary>
-    private: ::jpeg_decompress_struct *commonInfo;
+    /// <summary>Decompression structure created for this load only, if any</summary>
+    private: std::unique_ptr<JpegDecodeState> ownedState;
+    /// <summary>Decompression structure that is used for the load</summary>
+    private: JpegDecodeState *state;
 
   };
 
@@ -109,6 +234,764 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Sets up libjpeg to decode an image at the size requested in the options</summary>
+  /// <param name="commonInfo">JPEG decompression structure that will be set up</param>
+  /// <param name="options">Options specifying the size at which to decode the image</param>
+  /// <remarks>
+  ///   This has to be done after the file header has been read and before libjpeg
+  ///   calculates the output dimensions of the image.
+  /// </remarks>
+  void applyLoadScale(
+    ::jpeg_decompress_struct &commonInfo,
+    const Nuclex::Pixels::Storage::JpegLoadOptions &options
+  ) {
+    using Nuclex::Pixels::Storage::JpegLoadScale;
+
+    commonInfo.scale_num = 1;
+    switch(options.Scale) {
+      case JpegLoadScale::Full: { commonInfo.scale_denom = 1; break; }
+      case JpegLoadScale::Half: { commonInfo.scale_denom = 2; break; }
+      case JpegLoadScale::Quarter: { commonInfo.scale_denom = 4; break; }
+      case JpegLoadScale::Eighth: { commonInfo.scale_denom = 8; break; }
+      default: {
+        throw std::invalid_argument(u8"Unknown JPEG load scale");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sets up libjpeg to deliver scanlines in or close to a pixel format</summary>
+  /// <param name="commonInfo">JPEG decompression structure that will be set up</param>
+  /// <param name="pixelFormat">Pixel format the caller wants the image in</param>
+  /// <returns>The pixel format in which libjpeg will write the scanlines</returns>
+  /// <remarks>
+  ///   <para>
+  ///     Grayscale is simply the luminance channel of YCbCr images, so libjpeg can deliver
+  ///     it without any color conversion. libjpeg-turbo can also write BGR and all four
+  ///     orderings of RGBA with an opaque alpha channel directly, using its SIMD color
+  ///     converters when it was built with them. For all other pixel formats, libjpeg
+  ///     writes 24 bit RGB that has to be converted by the caller.
+  ///   </para>
+  ///   <para>
+  ///     This has to be done after the file header has been read and before libjpeg
+  ///     calculates the output dimensions of the image.
+  ///   </para>
+  /// </remarks>
+  Nuclex::Pixels::PixelFormat applyOutputPixelFormat(
+    ::jpeg_decompress_struct &commonInfo, Nuclex::Pixels::PixelFormat pixelFormat
+  ) {
+    using Nuclex::Pixels::PixelFormat;
+
+    if(pixelFormat == PixelFormat::R8_Unsigned) {
+      bool storesLuminance = (
+        (commonInfo.jpeg_color_space == JCS_GRAYSCALE) ||
+        (commonInfo.jpeg_color_space == JCS_YCbCr)
+      );
+      if(storesLuminance) {
+        commonInfo.output_components = 1;
+        commonInfo.out_color_space = JCS_GRAYSCALE;
+        return PixelFormat::R8_Unsigned;
+      }
+    }
+#if defined(JCS_EXTENSIONS)
+    if(pixelFormat == PixelFormat::B8_G8_R8_Unsigned) {
+      commonInfo.output_components = 3;
+      commonInfo.out_color_space = JCS_EXT_BGR;
+      return PixelFormat::B8_G8_R8_Unsigned;
+    }
+#endif
+#if defined(JCS_ALPHA_EXTENSIONS)
+    if(pixelFormat == PixelFormat::R8_G8_B8_A8_Unsigned) {
+      commonInfo.output_components = 4;
+      commonInfo.out_color_space = JCS_EXT_RGBA;
+      return PixelFormat::R8_G8_B8_A8_Unsigned;
+    }
+    if(pixelFormat == PixelFormat::B8_G8_R8_A8_Unsigned) {
+      commonInfo.output_components = 4;
+      commonInfo.out_color_space = JCS_EXT_BGRA;
+      return PixelFormat::B8_G8_R8_A8_Unsigned;
+    }
+    if(pixelFormat == PixelFormat::A8_B8_G8_R8_Unsigned) {
+      commonInfo.output_components = 4;
+      commonInfo.out_color_space = JCS_EXT_ABGR;
+      return PixelFormat::A8_B8_G8_R8_Unsigned;
+    }
+    if(pixelFormat == PixelFormat::A8_R8_G8_B8_Unsigned) {
+      commonInfo.output_components = 4;
+      commonInfo.out_color_space = JCS_EXT_ARGB;
+      return PixelFormat::A8_R8_G8_B8_Unsigned;
+    }
+#endif
+
+    if(pixelFormat != PixelFormat::R8_G8_B8_Unsigned) {
+      bool isConvertible = Nuclex::Pixels::PixelFormatConverter::CanConvert(
+        PixelFormat::R8_G8_B8_Unsigned, pixelFormat
+      );
+      if(!isConvertible) {
+        throw std::invalid_argument(u8"JPEG images can not be decoded into this pixel format");
+      }
+    }
+
+    commonInfo.output_components = 3;
+    commonInfo.out_color_space = JCS_RGB;
+    return PixelFormat::R8_G8_B8_Unsigned;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines how many scanlines to hand to libjpeg in one call</summary>
+  /// <param name="commonInfo">JPEG decompression structure that has been started</param>
+  /// <returns>The number of scanlines libjpeg should be asked for at once</returns>
+  std::size_t getScanlineBatchSize(const ::jpeg_decompress_struct &commonInfo) {
+    std::size_t batchSize = static_cast<std::size_t>(commonInfo.rec_outbuf_height);
+    if(batchSize < 1) {
+      return 1;
+    } else if(batchSize > MAX_SAMP_FACTOR) {
+      return MAX_SAMP_FACTOR;
+    } else {
+      return batchSize;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes all scanlines of a JPEG image into bitmap memory</summary>
+  /// <param name="commonInfo">JPEG decompression structure that has been started</param>
+  /// <param name="scanlinePixelFormat">Pixel format libjpeg writes the scanlines in</param>
+  /// <param name="memory">Bitmap memory that will receive the decoded scanlines</param>
+  /// <remarks>
+  ///   libjpeg decodes one row group (as many scanlines as it recommends in
+  ///   rec_outbuf_height) per call, so it is handed that many scanlines at once
+  ///   instead of requesting them one by one. If the bitmap memory is in another pixel
+  ///   format, each row group is decoded into a small buffer and converted from there
+  ///   while it is still in the cache.
+  /// </remarks>
+  void readScanlines(
+    ::jpeg_decompress_struct &commonInfo,
+    Nuclex::Pixels::PixelFormat scanlinePixelFormat,
+    const Nuclex::Pixels::BitmapMemory &memory
+  ) {
+    ::JSAMPROW scanlines[MAX_SAMP_FACTOR];
+    std::size_t batchSize = getScanlineBatchSize(commonInfo);
+
+    // If the pixel formats differ, let libjpeg decode into a buffer that can hold
+    // one row group, the scanlines will always be read from there
+    bool needsConversion = (memory.PixelFormat != scanlinePixelFormat);
+    std::vector<::JSAMPLE> batch;
+    if(needsConversion) {
+      std::size_t decodedRowByteCount = Nuclex::Pixels::CountRequiredBytes(
+        scanlinePixelFormat, static_cast<std::size_t>(commonInfo.output_width)
+      );
+      batch.resize(decodedRowByteCount * batchSize);
+      for(std::size_t index = 0; index < batchSize; ++index) {
+        scanlines[index] = &batch[decodedRowByteCount * index];
+      }
+    }
+
+    std::uint8_t *pixels = static_cast<std::uint8_t *>(memory.Pixels);
+    while(commonInfo.output_scanline < commonInfo.output_height) {
+      std::size_t firstScanline = static_cast<std::size_t>(commonInfo.output_scanline);
+      std::size_t scanlineCount = std::min<std::size_t>(
+        commonInfo.output_height - firstScanline, batchSize
+      );
+      if(!needsConversion) {
+        for(std::size_t index = 0; index < scanlineCount; ++index) {
+          scanlines[index] = pixels + (
+            static_cast<std::ptrdiff_t>(memory.Stride) *
+            static_cast<std::ptrdiff_t>(firstScanline + index)
+          );
+        }
+      }
+
+      JDIMENSION readScanlineCount = ::jpeg_read_scanlines(
+        &commonInfo, scanlines, static_cast<JDIMENSION>(scanlineCount)
+      );
+      if(readScanlineCount == 0) {
+        throw std::runtime_error(u8"Unknown error reading scanlines from jpeg");
+      }
+
+      if(needsConversion) {
+        for(std::size_t index = 0; index < readScanlineCount; ++index) {
+          Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+            scanlinePixelFormat, scanlines[index],
+            memory.PixelFormat, pixels + (
+              static_cast<std::ptrdiff_t>(memory.Stride) *
+              static_cast<std::ptrdiff_t>(firstScanline + index)
+            ),
+            memory.Width
+          );
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a region covers the whole output image of libjpeg</summary>
+  /// <param name="commonInfo">JPEG decompression structure that has been started</param>
+  /// <param name="region">Region that will be checked</param>
+  /// <returns>True if the region covers the whole image</returns>
+  bool coversWholeImage(
+    const ::jpeg_decompress_struct &commonInfo, const Nuclex::Pixels::Rectangle &region
+  ) {
+    return (
+      (region.MinX == 0) && (region.MinY == 0) &&
+      (region.MaxX == commonInfo.output_width) && (region.MaxY == commonInfo.output_height)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes the scanlines of a JPEG image that lie inside a region</summary>
+  /// <param name="commonInfo">JPEG decompression structure that has been started</param>
+  /// <param name="scanlinePixelFormat">Pixel format libjpeg writes the scanlines in</param>
+  /// <param name="region">Region of the image that will be decoded</param>
+  /// <param name="memory">Bitmap memory that will receive the region's pixels</param>
+  /// <remarks>
+  ///   <para>
+  ///     libjpeg-turbo can skip the rows above the region and only decode the blocks
+  ///     overlapping it horizontally. Plain libjpeg can't do either, so there, the rows
+  ///     above the region are decoded and discarded. With both, decoding stops after
+  ///     the region's last row.
+  ///   </para>
+  ///   <para>
+  ///     Because not all scanlines are read, the decompression has to be aborted rather
+  ///     than finished afterwards.
+  ///   </para>
+  /// </remarks>
+  void readScanlineRegion(
+    ::jpeg_decompress_struct &commonInfo,
+    Nuclex::Pixels::PixelFormat scanlinePixelFormat,
+    const Nuclex::Pixels::Rectangle &region,
+    const Nuclex::Pixels::BitmapMemory &memory
+  ) {
+    JDIMENSION firstDecodedColumn = 0;
+#if defined(LIBJPEG_TURBO_VERSION)
+    {
+      // Blocks can only be skipped whole, so the decoded rows may still begin
+      // a bit to the left of the region and end a bit to the right of it
+      firstDecodedColumn = static_cast<JDIMENSION>(region.MinX);
+      JDIMENSION decodedColumnCount = static_cast<JDIMENSION>(region.MaxX - region.MinX);
+      ::jpeg_crop_scanline(&commonInfo, &firstDecodedColumn, &decodedColumnCount);
+
+      if(region.MinY > 0) {
+        ::jpeg_skip_scanlines(&commonInfo, static_cast<JDIMENSION>(region.MinY));
+      }
+    }
+#endif
+
+    std::size_t batchSize = getScanlineBatchSize(commonInfo);
+
+    // The decoded rows are never larger than the whole output image's rows
+    std::size_t componentCount = static_cast<std::size_t>(commonInfo.output_components);
+    std::size_t decodedRowByteCount = (
+      static_cast<std::size_t>(commonInfo.output_width) * componentCount
+    );
+    std::vector<::JSAMPLE> batch(decodedRowByteCount * batchSize);
+    ::JSAMPROW scanlines[MAX_SAMP_FACTOR];
+    for(std::size_t index = 0; index < batchSize; ++index) {
+      scanlines[index] = &batch[decodedRowByteCount * index];
+    }
+
+    std::size_t regionOffset = (region.MinX - firstDecodedColumn) * componentCount;
+    std::size_t regionRowByteCount = (region.MaxX - region.MinX) * componentCount;
+
+    std::uint8_t *pixels = static_cast<std::uint8_t *>(memory.Pixels);
+    while(commonInfo.output_scanline < region.MaxY) {
+      std::size_t firstScanline = static_cast<std::size_t>(commonInfo.output_scanline);
+      std::size_t scanlineCount = std::min<std::size_t>(region.MaxY - firstScanline, batchSize);
+
+      JDIMENSION readScanlineCount = ::jpeg_read_scanlines(
+        &commonInfo, scanlines, static_cast<JDIMENSION>(scanlineCount)
+      );
+      if(readScanlineCount == 0) {
+        throw std::runtime_error(u8"Unknown error reading scanlines from jpeg");
+      }
+
+      // Only copy the part of the scanlines within the region (without libjpeg-turbo,
+      // the scanlines above the region end up here, too, and are discarded)
+      for(std::size_t index = 0; index < readScanlineCount; ++index) {
+        std::size_t y = firstScanline + index;
+        if(y >= region.MinY) {
+          std::uint8_t *target = pixels + (
+            static_cast<std::ptrdiff_t>(memory.Stride) *
+            static_cast<std::ptrdiff_t>(y - region.MinY)
+          );
+          if(memory.PixelFormat == scanlinePixelFormat) {
+            std::memcpy(target, scanlines[index] + regionOffset, regionRowByteCount);
+          } else {
+            Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+              scanlinePixelFormat, scanlines[index] + regionOffset,
+              memory.PixelFormat, target,
+              memory.Width
+            );
+          }
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes the color components of a JPEG image into separate planes</summary>
+  /// <param name="commonInfo">
+  ///   JPEG decompression structure that has been started in raw data mode
+  /// </param>
+  /// <param name="planes">Bitmaps that will receive the components, one per component</param>
+  /// <remarks>
+  ///   libjpeg's raw data interface hands out one row of MCUs per call and always writes
+  ///   whole blocks, which can reach beyond the right and bottom edges of a component.
+  ///   The blocks are therefore decoded into a buffer and only the part covering
+  ///   the component is copied into its plane.
+  /// </remarks>
+  void readRawComponents(
+    ::jpeg_decompress_struct &commonInfo, std::vector<Nuclex::Pixels::Bitmap> &planes
+  ) {
+    std::size_t componentCount = static_cast<std::size_t>(commonInfo.num_components);
+
+    // Work out how many rows of each component a single call delivers and how wide
+    // the blocks written for each component are in total
+    std::size_t rowGroupHeights[MAX_COMPONENTS];
+    std::size_t paddedWidths[MAX_COMPONENTS];
+    std::size_t totalRowCount = 0;
+    for(std::size_t index = 0; index < componentCount; ++index) {
+      const ::jpeg_component_info &component = commonInfo.comp_info[index];
+#if JPEG_LIB_VERSION >= 70
+      std::size_t blockWidth = static_cast<std::size_t>(component.DCT_h_scaled_size);
+      std::size_t blockHeight = static_cast<std::size_t>(component.DCT_v_scaled_size);
+#else
+      std::size_t blockWidth = static_cast<std::size_t>(component.DCT_scaled_size);
+      std::size_t blockHeight = static_cast<std::size_t>(component.DCT_scaled_size);
+#endif
+      rowGroupHeights[index] = static_cast<std::size_t>(component.v_samp_factor) * blockHeight;
+      paddedWidths[index] = static_cast<std::size_t>(component.width_in_blocks) * blockWidth;
+      totalRowCount += rowGroupHeights[index];
+    }
+
+    // Set up one buffer holding a row of MCUs for all components
+    std::vector<std::size_t> bufferOffsets(componentCount);
+    std::size_t bufferByteCount = 0;
+    for(std::size_t index = 0; index < componentCount; ++index) {
+      bufferOffsets[index] = bufferByteCount;
+      bufferByteCount += paddedWidths[index] * rowGroupHeights[index];
+    }
+    std::vector<::JSAMPLE> buffer(bufferByteCount);
+    std::vector<::JSAMPROW> rows(totalRowCount);
+    ::JSAMPARRAY componentRows[MAX_COMPONENTS];
+    {
+      std::size_t rowIndex = 0;
+      for(std::size_t index = 0; index < componentCount; ++index) {
+        componentRows[index] = &rows[rowIndex];
+        for(std::size_t row = 0; row < rowGroupHeights[index]; ++row) {
+          rows[rowIndex] = &buffer[bufferOffsets[index] + paddedWidths[index] * row];
+          ++rowIndex;
+        }
+      }
+    }
+
+#if JPEG_LIB_VERSION >= 70
+    JDIMENSION scanlinesPerCall = static_cast<JDIMENSION>(
+      commonInfo.max_v_samp_factor * commonInfo.min_DCT_v_scaled_size
+    );
+#else
+    JDIMENSION scanlinesPerCall = static_cast<JDIMENSION>(
+      commonInfo.max_v_samp_factor * commonInfo.min_DCT_scaled_size
+    );
+#endif
+
+    std::size_t rowGroupIndex = 0;
+    while(commonInfo.output_scanline < commonInfo.output_height) {
+      JDIMENSION readScanlineCount = ::jpeg_read_raw_data(
+        &commonInfo, componentRows, scanlinesPerCall
+      );
+      if(readScanlineCount == 0) {
+        throw std::runtime_error(u8"Unknown error reading raw data from jpeg");
+      }
+
+      // Copy the rows that lie within each component into its plane
+      for(std::size_t index = 0; index < componentCount; ++index) {
+        const Nuclex::Pixels::BitmapMemory &memory = planes[index].Access();
+        std::size_t firstRow = rowGroupIndex * rowGroupHeights[index];
+        if(firstRow < memory.Height) {
+          std::size_t rowCount = std::min(rowGroupHeights[index], memory.Height - firstRow);
+          for(std::size_t row = 0; row < rowCount; ++row) {
+            std::memcpy(
+              static_cast<std::uint8_t *>(memory.Pixels) + (
+                static_cast<std::ptrdiff_t>(memory.Stride) *
+                static_cast<std::ptrdiff_t>(firstRow + row)
+              ),
+              componentRows[index][row],
+              memory.Width
+            );
+          }
+        }
+      }
+
+      ++rowGroupIndex;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sets up libjpeg to compress an image as requested in the options</summary>
+  /// <param name="commonInfo">
+  ///   JPEG compression structure whose image dimensions and color space have been set
+  /// </param>
+  /// <param name="options">Options controlling how the image will be compressed</param>
+  void setupCompression(
+    ::jpeg_compress_struct &commonInfo,
+    const Nuclex::Pixels::Storage::JpegSaveOptions &options
+  ) {
+    using Nuclex::Pixels::Storage::JpegChromaSubsampling;
+
+    ::jpeg_set_defaults(&commonInfo);
+    ::jpeg_set_quality(&commonInfo, options.Quality, TRUE);
+    commonInfo.optimize_coding = options.OptimizeHuffmanTables ? TRUE : FALSE;
+
+    // The sampling factors of the luminance channel decide the resolution of the color
+    // channels. jpeg_set_defaults() selects 4:2:0, which is what most encoders use.
+    if(commonInfo.input_components == 3) {
+      switch(options.ChromaSubsampling) {
+        case JpegChromaSubsampling::None: {
+          commonInfo.comp_info[0].h_samp_factor = 1;
+          commonInfo.comp_info[0].v_samp_factor = 1;
+          break;
+        }
+        case JpegChromaSubsampling::Horizontal: {
+          commonInfo.comp_info[0].h_samp_factor = 2;
+          commonInfo.comp_info[0].v_samp_factor = 1;
+          break;
+        }
+        case JpegChromaSubsampling::HorizontalAndVertical: {
+          commonInfo.comp_info[0].h_samp_factor = 2;
+          commonInfo.comp_info[0].v_samp_factor = 2;
+          break;
+        }
+        default: {
+          throw std::invalid_argument(u8"Unknown JPEG chroma subsampling");
+        }
+      }
+    }
+
+    if(options.Progressive) {
+      ::jpeg_simple_progression(&commonInfo);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row source that decodes the scanlines of a JPEG file as they are read</summary>
+  class JpegRowSource : public Nuclex::Pixels::RowSource {
+
+    /// <summary>Initializes a new JPEG row source reading from the specified file</summary>
+    /// <param name="file">File the JPEG image will be read from</param>
+    public: JpegRowSource(const Nuclex::Pixels::Storage::VirtualFile &file) :
+      environment(file),
+      pixelFormat(Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned),
+      scanlinePixelFormat(Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned),
+      remainingRowCount(0) {
+      this->state.CommonInfo.src = &this->environment;
+    }
+
+    /// <summary>Reads the JPEG file header and starts decompressing the image</summary>
+    /// <param name="options">
+    ///   Options specifying the size and pixel format in which to decode the image
+    /// </param>
+    /// <returns>True if the header was read, false if the file is not a JPEG</returns>
+    public: bool TryStart(const Nuclex::Pixels::Storage::JpegLoadOptions &options) {
+      using Nuclex::Pixels::Storage::Jpeg::Helpers;
+
+      ::jpeg_decompress_struct &commonInfo = this->state.CommonInfo;
+
+      // Same checks as in TryLoad(): the file has to be large enough for the JPEG/JFIF
+      // header and has to begin with it before libjpeg is asked to read the header
+      if(this->environment.Length < 16) {
+        return false;
+      }
+      if(this->environment.bytes_in_buffer == 0) {
+        this->environment.fill_input_buffer(&commonInfo);
+      }
+      if(!Helpers::IsValidJpegHeader(this->environment.next_input_byte)) {
+        return false;
+      }
+      if(!tryReadJpegHeader(commonInfo)) {
+        return false;
+      }
+
+      this->pixelFormat = options.PixelFormat;
+      this->scanlinePixelFormat = applyOutputPixelFormat(commonInfo, options.PixelFormat);
+      applyLoadScale(commonInfo, options);
+
+      ::boolean startedWithoutSuspension = ::jpeg_start_decompress(&commonInfo);
+      if(startedWithoutSuspension == FALSE) {
+        throw std::runtime_error(u8"Input file truncated");
+      }
+
+      // If libjpeg can't write the requested pixel format, the scanlines are
+      // decoded into a buffer and converted from there as they are read
+      if(this->scanlinePixelFormat != this->pixelFormat) {
+        this->decodedScanlines.resize(
+          Nuclex::Pixels::CountRequiredBytes(
+            this->scanlinePixelFormat, static_cast<std::size_t>(commonInfo.output_width)
+          ) * Nuclex::Pixels::Storage::Jpeg::JpegScanlineBatchSize
+        );
+      }
+
+      this->remainingRowCount = static_cast<std::size_t>(commonInfo.output_height);
+      return true;
+    }
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override {
+      return static_cast<std::size_t>(this->state.CommonInfo.output_width);
+    }
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: std::size_t GetHeight() const override {
+      return static_cast<std::size_t>(this->state.CommonInfo.output_height);
+    }
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->pixelFormat;
+    }
+
+    /// <summary>Decodes the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory that will receive the decoded rows</param>
+    public: void ReadRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      Nuclex::Pixels::RequireFittingRows(
+        rows, GetWidth(), GetPixelFormat(), this->remainingRowCount
+      );
+
+      ::jpeg_decompress_struct &commonInfo = this->state.CommonInfo;
+      std::size_t width = GetWidth();
+      std::size_t scanlineByteCount = Nuclex::Pixels::CountRequiredBytes(
+        this->scanlinePixelFormat, width
+      );
+
+      // libjpeg may hand out fewer scanlines than requested per call,
+      // so keep asking until all rows the caller wanted have been filled
+      ::JSAMPROW scanlines[Nuclex::Pixels::Storage::Jpeg::JpegScanlineBatchSize];
+      std::uint8_t *row = static_cast<std::uint8_t *>(rows.Pixels);
+      std::size_t remainingBatchRowCount = rows.Height;
+      while(remainingBatchRowCount > 0) {
+        std::size_t scanlineCount = std::min(
+          remainingBatchRowCount, Nuclex::Pixels::Storage::Jpeg::JpegScanlineBatchSize
+        );
+        for(std::size_t index = 0; index < scanlineCount; ++index) {
+          if(this->decodedScanlines.empty()) {
+            scanlines[index] = row + (
+              static_cast<std::ptrdiff_t>(rows.Stride) * static_cast<std::ptrdiff_t>(index)
+            );
+          } else {
+            scanlines[index] = &this->decodedScanlines[scanlineByteCount * index];
+          }
+        }
+
+        JDIMENSION readScanlineCount = ::jpeg_read_scanlines(
+          &commonInfo, scanlines, static_cast<JDIMENSION>(scanlineCount)
+        );
+        if(readScanlineCount == 0) {
+          throw std::runtime_error(u8"Unknown error reading scanlines from jpeg");
+        }
+
+        if(!this->decodedScanlines.empty()) {
+          for(std::size_t index = 0; index < readScanlineCount; ++index) {
+            Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+              this->scanlinePixelFormat, scanlines[index],
+              this->pixelFormat, row + (
+                static_cast<std::ptrdiff_t>(rows.Stride) * static_cast<std::ptrdiff_t>(index)
+              ),
+              width
+            );
+          }
+        }
+
+        row += static_cast<std::ptrdiff_t>(rows.Stride) * readScanlineCount;
+        remainingBatchRowCount -= readScanlineCount;
+      }
+
+      this->remainingRowCount -= rows.Height;
+      if((rows.Height > 0) && (this->remainingRowCount == 0)) {
+        ::boolean endedWithoutSuspension = ::jpeg_finish_decompress(&commonInfo);
+        if(endedWithoutSuspension == FALSE) {
+          throw std::runtime_error(u8"Input file truncated");
+        }
+      }
+    }
+
+    /// <summary>JPEG decompression structure decoding the file</summary>
+    private: JpegDecodeState state;
+    /// <summary>Lets libjpeg read from the virtual file</summary>
+    private: Nuclex::Pixels::Storage::Jpeg::JpegReadEnvironment environment;
+    /// <summary>Pixel format the rows are provided in</summary>
+    private: Nuclex::Pixels::PixelFormat pixelFormat;
+    /// <summary>Pixel format in which libjpeg writes the scanlines</summary>
+    private: Nuclex::Pixels::PixelFormat scanlinePixelFormat;
+    /// <summary>Number of rows that have not been decoded yet</summary>
+    private: std::size_t remainingRowCount;
+    /// <summary>Receives a batch of scanlines if they need to be converted</summary>
+    private: std::vector<std::uint8_t> decodedScanlines;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row sink that compresses the rows written into it as a JPEG file</summary>
+  class JpegRowSink : public Nuclex::Pixels::RowSink {
+
+    /// <summary>Initializes a new JPEG row sink writing into the specified file</summary>
+    /// <param name="file">File the JPEG image will be written into</param>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="pixelFormat">Pixel format the rows will be written in</param>
+    /// <param name="options">Options controlling how the image will be compressed</param>
+    public: JpegRowSink(
+      Nuclex::Pixels::Storage::VirtualFile &file,
+      std::size_t width, std::size_t height, Nuclex::Pixels::PixelFormat pixelFormat,
+      const Nuclex::Pixels::Storage::JpegSaveOptions &options
+    ) :
+      environment(file),
+      width(width),
+      height(height),
+      pixelFormat(pixelFormat),
+      remainingRowCount(height) {
+
+      // Like in Save(), 8 bit grayscale is stored as it is, everything else as 24 bit RGB
+      int componentCount;
+      ::J_COLOR_SPACE colorSpace;
+      if(pixelFormat == Nuclex::Pixels::PixelFormat::R8_Unsigned) {
+        this->scanlinePixelFormat = Nuclex::Pixels::PixelFormat::R8_Unsigned;
+        componentCount = 1;
+        colorSpace = JCS_GRAYSCALE;
+      } else {
+        this->scanlinePixelFormat = Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned;
+        componentCount = 3;
+        colorSpace = JCS_RGB;
+      }
+
+      this->commonInfo.err = ::jpeg_std_error(&this->errorManager);
+      this->errorManager.error_exit = &handleJpegError;
+      ::jpeg_create_compress(&this->commonInfo);
+
+      try {
+        this->commonInfo.dest = &this->environment;
+        this->commonInfo.image_width = static_cast<JDIMENSION>(width);
+        this->commonInfo.image_height = static_cast<JDIMENSION>(height);
+        this->commonInfo.input_components = componentCount;
+        this->commonInfo.in_color_space = colorSpace;
+        setupCompression(this->commonInfo, options);
+
+        ::jpeg_start_compress(&this->commonInfo, TRUE);
+
+        if(this->scanlinePixelFormat != pixelFormat) {
+          this->convertedScanlines.resize(
+            Nuclex::Pixels::CountRequiredBytes(this->scanlinePixelFormat, width) *
+            Nuclex::Pixels::Storage::Jpeg::JpegScanlineBatchSize
+          );
+        }
+      }
+      catch(...) {
+        ::jpeg_destroy_compress(&this->commonInfo);
+        throw;
+      }
+    }
+
+    /// <summary>Frees the JPEG compression structure</summary>
+    public: ~JpegRowSink() override {
+      ::jpeg_destroy_compress(&this->commonInfo);
+    }
+
+    /// <summary>Retrieves the width of the rows the row sink accepts</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->width; }
+
+    /// <summary>Retrieves the number of rows the row sink accepts in total</summary>
+    /// <returns>The height of the image written into the row sink</returns>
+    public: std::size_t GetHeight() const override { return this->height; }
+
+    /// <summary>Retrieves the pixel format the row sink accepts rows in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->pixelFormat;
+    }
+
+    /// <summary>Compresses the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory holding the rows that will be compressed</param>
+    public: void WriteRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      Nuclex::Pixels::RequireFittingRows(
+        rows, this->width, this->pixelFormat, this->remainingRowCount
+      );
+
+      std::size_t scanlineByteCount = Nuclex::Pixels::CountRequiredBytes(
+        this->scanlinePixelFormat, this->width
+      );
+
+      ::JSAMPROW scanlines[Nuclex::Pixels::Storage::Jpeg::JpegScanlineBatchSize];
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(rows.Pixels);
+      std::size_t remainingBatchRowCount = rows.Height;
+      while(remainingBatchRowCount > 0) {
+        std::size_t batchSize = std::min(
+          remainingBatchRowCount, Nuclex::Pixels::Storage::Jpeg::JpegScanlineBatchSize
+        );
+        for(std::size_t index = 0; index < batchSize; ++index) {
+          if(this->convertedScanlines.empty()) {
+            // libjpeg's API is not const-correct, but it never writes to the scanlines
+            scanlines[index] = const_cast<::JSAMPLE *>(row);
+          } else {
+            scanlines[index] = &this->convertedScanlines[scanlineByteCount * index];
+            Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+              this->pixelFormat, row,
+              this->scanlinePixelFormat, scanlines[index],
+              this->width
+            );
+          }
+          row += rows.Stride;
+        }
+
+        JDIMENSION writtenScanlineCount = ::jpeg_write_scanlines(
+          &this->commonInfo, scanlines, static_cast<JDIMENSION>(batchSize)
+        );
+        if(writtenScanlineCount != batchSize) {
+          throw std::runtime_error(u8"Unknown error writing scanlines to jpeg");
+        }
+
+        remainingBatchRowCount -= batchSize;
+      }
+
+      this->remainingRowCount -= rows.Height;
+      if((rows.Height > 0) && (this->remainingRowCount == 0)) {
+        ::jpeg_finish_compress(&this->commonInfo);
+      }
+    }
+
+    /// <summary>Main structure containing all libjpeg configuration</summary>
+    private: ::jpeg_compress_struct commonInfo;
+    /// <summary>Error manager that turns libjpeg errors into exceptions</summary>
+    private: ::jpeg_error_mgr errorManager;
+    /// <summary>Lets libjpeg write into the virtual file</summary>
+    private: Nuclex::Pixels::Storage::Jpeg::JpegWriteEnvironment environment;
+    /// <summary>Width of the image in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the image in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Pixel format the rows are written in</summary>
+    private: Nuclex::Pixels::PixelFormat pixelFormat;
+    /// <summary>Pixel format in which the scanlines are handed to libjpeg</summary>
+    private: Nuclex::Pixels::PixelFormat scanlinePixelFormat;
+    /// <summary>Number of rows that have not been written yet</summary>
+    private: std::size_t remainingRowCount;
+    /// <summary>Receives a batch of scanlines if they need to be converted</summary>
+    private: std::vector<std::uint8_t> convertedScanlines;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
@@ -124,6 +1007,18 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool JpegBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    if(fileHeaderByteCount < 16) {
+      return false; // Too short to even recognize as a JPEG file
+    }
+
+    return Helpers::IsValidJpegHeader(fileHeader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   bool JpegBitmapCodec::CanLoad(
     const VirtualFile &source, const std::string &extensionHint /* = std::string() */
   ) const {
@@ -199,251 +1094,487 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
   // ------------------------------------------------------------------------------------------- //
 
   BitmapInfo JpegBitmapCodec::TryReadInfo(
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
     (void)extensionHint; // Unused
 
-    ::jpeg_decompress_struct commonInfo;
-    ::jpeg_create_decompress(&commonInfo);
-    {
-      JpegDecompressStructScope decompressScope(&commonInfo);
-
-      // Set up a custom error manager that throws exceptions rather than exit()
-      struct ::jpeg_error_mgr errorManager;
-      ::jpeg_std_error(&errorManager);
-      errorManager.error_exit = &handleJpegError;
-      commonInfo.err = &errorManager;
+    // Obtain a decompression structure with an error manager that throws exceptions
+    // rather than exit(), either a fresh one or the one kept in the decode context
+    JpegDecompressScope decompressScope(*this, options);
+    ::jpeg_decompress_struct &commonInfo = decompressScope.GetCommonInfo();
 
-      // Set up a custom data source that reads from a virtual file
-      JpegReadEnvironment virtualFileSource(source);
-      commonInfo.src = &virtualFileSource;
+    // Set up a custom data source that reads from a virtual file
+    JpegReadEnvironment virtualFileSource(source);
+    commonInfo.src = &virtualFileSource;
 
-      // If the file is too small for even the JPEG/JFIF header, bail out
-      if(virtualFileSource.Length < 16) {
-        BitmapInfo result;
-        result.Loadable = false;
-        return result; // Too small to even recognize as a JPEG file
-      }
+    // If the file is too small for even the JPEG/JFIF header, bail out
+    if(virtualFileSource.Length < 16) {
+      BitmapInfo result;
+      result.Loadable = false;
+      return result; // Too small to even recognize as a JPEG file
+    }
 
-      // Do the first fill ourselves so we can check the file's identity
-      // and exit early if it doesn't look like a JPEG file
+    // Do the first fill ourselves so we can check the file's identity
+    // and exit early if it doesn't look like a JPEG file. Memory-mapped files
+    // are handed to libjpeg in one piece and need no fill.
+    if(virtualFileSource.bytes_in_buffer == 0) {
       virtualFileSource.fill_input_buffer(&commonInfo);
-      if(!Helpers::IsValidJpegHeader(virtualFileSource.Buffer)) {
-        BitmapInfo result;
-        result.Loadable = false;
-        return result; // Too small to even recognize as a JPEG file
-      }
-
-      // Finally, we can read the JPEG file header to get file infos
-      int result = ::jpeg_read_header(&commonInfo, TRUE);
-      if(result != JPEG_HEADER_OK) {
-        throw std::runtime_error(u8"libjpeg failed to read the file header");
-      }
-
-      // Create an information structure holding the informations we found
-      BitmapInfo info;
-      info.Loadable = true;
-      info.Width = static_cast<std::size_t>(commonInfo.image_width);
-      info.Height = static_cast<std::size_t>(commonInfo.image_height);
-      info.PixelFormat = Helpers::GetEquivalentPixelFormat(commonInfo);
-      info.MemoryUsage = (
-        (CountRequiredBytes(info.PixelFormat, info.Width) * info.Height) +
-        (sizeof(std::intptr_t) * 3) +
-        (sizeof(std::size_t) * 3) +
-        (sizeof(int) * 2)
-      );
-      return info;
     }
+    if(!Helpers::IsValidJpegHeader(virtualFileSource.next_input_byte)) {
+      BitmapInfo result;
+      result.Loadable = false;
+      return result; // Too small to even recognize as a JPEG file
+    }
+
+    // Finally, we can read the JPEG file header to get file infos. A header libjpeg
+    // can not make sense of means the file is not loadable, which is no reason to throw.
+    if(!tryReadJpegHeader(commonInfo)) {
+      BitmapInfo result;
+      result.Loadable = false;
+      return result;
+    }
+
+    // Let libjpeg work out the size the image will have when it is decoded
+    // with the requested scale, the region to load is relative to that size.
+    // Color spaces that can't be decoded at all are rejected right here.
+    Helpers::GetEquivalentPixelFormat(commonInfo);
+    applyOutputPixelFormat(commonInfo, options.Jpeg.PixelFormat);
+    applyLoadScale(commonInfo, options.Jpeg);
+    ::jpeg_calc_output_dimensions(&commonInfo);
+    Rectangle region = GetLoadRegion(
+      options,
+      static_cast<std::size_t>(commonInfo.output_width),
+      static_cast<std::size_t>(commonInfo.output_height)
+    );
+
+    // Create an information structure holding the informations we found
+    BitmapInfo info;
+    info.Loadable = true;
+    info.Width = region.MaxX - region.MinX;
+    info.Height = region.MaxY - region.MinY;
+    info.PixelFormat = options.Jpeg.PixelFormat;
+    info.MemoryUsage = (
+      (CountRequiredBytes(info.PixelFormat, info.Width) * info.Height) +
+      (sizeof(std::intptr_t) * 3) +
+      (sizeof(std::size_t) * 3) +
+      (sizeof(int) * 2)
+    );
+    return info;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   OptionalBitmap JpegBitmapCodec::TryLoad(
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.JpegBitmapCodec.TryLoad");
     (void)extensionHint; // Unused
 
-    ::jpeg_decompress_struct commonInfo;
-    ::jpeg_create_decompress(&commonInfo);
-    {
-      JpegDecompressStructScope decompressScope(&commonInfo);
-
-      // Set up a custom error manager that throws exceptions rather than exit()
-      struct ::jpeg_error_mgr errorManager;
-      ::jpeg_std_error(&errorManager);
-      errorManager.error_exit = &handleJpegError;
-      commonInfo.err = &errorManager;
+    // Obtain a decompression structure with an error manager that throws exceptions
+    // rather than exit(), either a fresh one or the one kept in the decode context
+    JpegDecompressScope decompressScope(*this, options);
+    ::jpeg_decompress_struct &commonInfo = decompressScope.GetCommonInfo();
 
-      // Set up a custom data source that reads from a virtual file
-      JpegReadEnvironment virtualFileSource(source);
-      commonInfo.src = &virtualFileSource;
+    // Set up a custom data source that reads from a virtual file
+    JpegReadEnvironment virtualFileSource(source);
+    commonInfo.src = &virtualFileSource;
 
-      // If the file is too small for even the JPEG/JFIF header, bail out
-      if(virtualFileSource.Length < 16) {
-        return OptionalBitmap(); // Too small to even recognize as a JPEG file
-      }
+    // If the file is too small for even the JPEG/JFIF header, bail out
+    if(virtualFileSource.Length < 16) {
+      return OptionalBitmap(); // Too small to even recognize as a JPEG file
+    }
 
-      // Do the first fill ourselves so we can check the file's identity
-      // and exit early if it doesn't look like a JPEG file
+    // Do the first fill ourselves so we can check the file's identity
+    // and exit early if it doesn't look like a JPEG file. Memory-mapped files
+    // are handed to libjpeg in one piece and need no fill.
+    if(virtualFileSource.bytes_in_buffer == 0) {
       virtualFileSource.fill_input_buffer(&commonInfo);
-      if(!Helpers::IsValidJpegHeader(virtualFileSource.Buffer)) {
-        return OptionalBitmap(); // File header did not indicate a JPEG file
-      }
-
-      // Finally, we can read the JPEG file header to get file infos
-      int result = ::jpeg_read_header(&commonInfo, TRUE);
-      if(result != JPEG_HEADER_OK) {
-        throw std::runtime_error(u8"libjpeg failed to read the file header");
-      }
-
-      // TODO: Use fastest color space and copy/convert to Bitmap
-      //       Bitmap of type returned by TryReadInfo() MUST be able to hold this data!
-      // Force libjpeg to convert to 24 bit RGB for us
-      commonInfo.output_components = 3;
-      commonInfo.out_color_space = JCS_RGB;
-
-      // Begin decompression, this will update output_width and output_height,
-      // usually to the same as image_width, image_height unless scaling is set up.
-      ::boolean startedWithoutSuspension = ::jpeg_start_decompress(&commonInfo);
-      if(startedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
-        throw std::runtime_error(u8"Input file truncated");
-      }
+    }
+    if(!Helpers::IsValidJpegHeader(virtualFileSource.next_input_byte)) {
+      return OptionalBitmap(); // File header did not indicate a JPEG file
+    }
 
-      // Create the bitmap so we can directly decode into its pixel buffer 
-      Bitmap decodedBitmap(
-        static_cast<std::size_t>(commonInfo.output_width),
-        static_cast<std::size_t>(commonInfo.output_height),
-        PixelFormat::R8_G8_B8_Unsigned
-      );
-      const BitmapMemory &memory = decodedBitmap.Access();
-
-      // Read the bitmap scanline by scanline. The function can also take an array of
-      // scanlines, which may be faster than decoding line-by-line, but this is
-      // the most straightforward way to do it.
-      std::uint8_t *currentRowPointer = reinterpret_cast<std::uint8_t *>(memory.Pixels);
-      while(commonInfo.output_scanline < commonInfo.output_height) {
-        JDIMENSION readScanlineCount = ::jpeg_read_scanlines(&commonInfo, &currentRowPointer, 1);
-        if(readScanlineCount != 1) {
-          throw std::runtime_error(u8"Unknown error reading scanline from jpeg");
-        }
-        currentRowPointer += memory.Stride;
-      }
+    // Finally, we can read the JPEG file header to get file infos
+    int result = ::jpeg_read_header(&commonInfo, TRUE);
+    if(result != JPEG_HEADER_OK) {
+      throw std::runtime_error(u8"libjpeg failed to read the file header");
+    }
 
-      // Finish decompression. This does some additional sanity checks, verifying that
-      // the image was decompressed completely and reading the input stream up to the EOI
-      // market (in case it contains multiple images).
-      ::boolean endedWithoutSuspension = ::jpeg_finish_decompress(&commonInfo);
-      if(endedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
-        throw std::runtime_error(u8"Input file truncated");
-      }
+    // Let libjpeg write the requested pixel format if it can, otherwise it writes
+    // 24 bit RGB and the scanlines are converted in batches as they are decoded
+    PixelFormat scanlinePixelFormat = applyOutputPixelFormat(
+      commonInfo, options.Jpeg.PixelFormat
+    );
+
+    // If requested, decode the image at a reduced size. libjpeg does this by
+    // only evaluating the lower frequencies of each block, which is much faster.
+    applyLoadScale(commonInfo, options.Jpeg);
+
+    // Begin decompression, this will update output_width and output_height,
+    // usually to the same as image_width, image_height unless scaling is set up.
+    ::boolean startedWithoutSuspension = ::jpeg_start_decompress(&commonInfo);
+    if(startedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
+      throw std::runtime_error(u8"Input file truncated");
+    }
 
+    Rectangle region = GetLoadRegion(
+      options,
+      static_cast<std::size_t>(commonInfo.output_width),
+      static_cast<std::size_t>(commonInfo.output_height)
+    );
+
+    // Create the bitmap so we can directly decode into its pixel buffer 
+    Bitmap decodedBitmap(
+      region.MaxX - region.MinX, region.MaxY - region.MinY, options.Jpeg.PixelFormat
+    );
+    const BitmapMemory &memory = decodedBitmap.Access();
+
+    // If only a region was requested, stop decoding after its last row. Otherwise,
+    // read the bitmap in batches of scanlines straight into the bitmap's memory.
+    if(!coversWholeImage(commonInfo, region)) {
+      readScanlineRegion(commonInfo, scanlinePixelFormat, region, memory);
+      ::jpeg_abort_decompress(&commonInfo);
       return OptionalBitmap(std::move(decodedBitmap));
     }
+    readScanlines(commonInfo, scanlinePixelFormat, memory);
+
+    // Finish decompression. This does some additional sanity checks, verifying that
+    // the image was decompressed completely and reading the input stream up to the EOI
+    // market (in case it contains multiple images).
+    ::boolean endedWithoutSuspension = ::jpeg_finish_decompress(&commonInfo);
+    if(endedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
+      throw std::runtime_error(u8"Input file truncated");
+    }
+
+    return OptionalBitmap(std::move(decodedBitmap));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   bool JpegBitmapCodec::TryReload(
     Bitmap &exactlyFittingBitmap,
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
     (void)extensionHint;
 
-    ::jpeg_decompress_struct commonInfo;
-    ::jpeg_create_decompress(&commonInfo);
-    {
-      JpegDecompressStructScope decompressScope(&commonInfo);
-
-      // Set up a custom error manager that throws exceptions rather than exit()
-      struct ::jpeg_error_mgr errorManager;
-      ::jpeg_std_error(&errorManager);
-      errorManager.error_exit = &handleJpegError;
-      commonInfo.err = &errorManager;
+    // Obtain a decompression structure with an error manager that throws exceptions
+    // rather than exit(), either a fresh one or the one kept in the decode context
+    JpegDecompressScope decompressScope(*this, options);
+    ::jpeg_decompress_struct &commonInfo = decompressScope.GetCommonInfo();
 
-      // Set up a custom data source that reads from a virtual file
-      JpegReadEnvironment virtualFileSource(source);
-      commonInfo.src = &virtualFileSource;
+    // Set up a custom data source that reads from a virtual file
+    JpegReadEnvironment virtualFileSource(source);
+    commonInfo.src = &virtualFileSource;
 
-      // If the file is too small for even the JPEG/JFIF header, bail out
-      if(virtualFileSource.Length < 16) {
-        return false;
-      }
+    // If the file is too small for even the JPEG/JFIF header, bail out
+    if(virtualFileSource.Length < 16) {
+      return false;
+    }
 
-      // Do the first fill ourselves so we can check the file's identity
-      // and exit early if it doesn't look like a JPEG file
+    // Do the first fill ourselves so we can check the file's identity
+    // and exit early if it doesn't look like a JPEG file. Memory-mapped files
+    // are handed to libjpeg in one piece and need no fill.
+    if(virtualFileSource.bytes_in_buffer == 0) {
       virtualFileSource.fill_input_buffer(&commonInfo);
-      if(!Helpers::IsValidJpegHeader(virtualFileSource.Buffer)) {
-        return false;
-      }
-
-      // Finally, we can read the JPEG file header to get file infos
-      int result = ::jpeg_read_header(&commonInfo, TRUE);
-      if(result != JPEG_HEADER_OK) {
-        throw std::runtime_error(u8"libjpeg failed to read the file header");
-      }
+    }
+    if(!Helpers::IsValidJpegHeader(virtualFileSource.next_input_byte)) {
+      return false;
+    }
 
-      // TODO: Use fastest color space and copy/convert to Bitmap
-      //       Bitmap of type returned by TryReadInfo() MUST be able to hold this data!
-      // Force libjpeg to convert to 24 bit RGB for us
-      commonInfo.output_components = 3;
-      commonInfo.out_color_space = JCS_RGB;
+    // Finally, we can read the JPEG file header to get file infos
+    int result = ::jpeg_read_header(&commonInfo, TRUE);
+    if(result != JPEG_HEADER_OK) {
+      throw std::runtime_error(u8"libjpeg failed to read the file header");
+    }
 
-      // Begin decompression, this will update output_width and output_height,
-      // usually to the same as image_width, image_height unless scaling is set up.
-      ::boolean startedWithoutSuspension = ::jpeg_start_decompress(&commonInfo);
-      if(startedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
-        throw std::runtime_error(u8"Input file truncated");
-      }
+    // Let libjpeg write the requested pixel format if it can, otherwise it writes
+    // 24 bit RGB and the scanlines are converted in batches as they are decoded
+    PixelFormat scanlinePixelFormat = applyOutputPixelFormat(
+      commonInfo, options.Jpeg.PixelFormat
+    );
+
+    // If requested, decode the image at a reduced size. libjpeg does this by
+    // only evaluating the lower frequencies of each block, which is much faster.
+    applyLoadScale(commonInfo, options.Jpeg);
+
+    // Begin decompression, this will update output_width and output_height,
+    // usually to the same as image_width, image_height unless scaling is set up.
+    ::boolean startedWithoutSuspension = ::jpeg_start_decompress(&commonInfo);
+    if(startedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
+      throw std::runtime_error(u8"Input file truncated");
+    }
 
-      const BitmapMemory &memory = exactlyFittingBitmap.Access();
-      bool matchesExpectations = (
-        (memory.Width == commonInfo.output_width) &&
-        (memory.Height == commonInfo.output_height) &&
-        (memory.PixelFormat == PixelFormat::R8_G8_B8_Unsigned)
+    Rectangle region = GetLoadRegion(
+      options,
+      static_cast<std::size_t>(commonInfo.output_width),
+      static_cast<std::size_t>(commonInfo.output_height)
+    );
+
+    // The bitmap may be a view into a larger bitmap, only its size has to fit
+    const BitmapMemory &memory = exactlyFittingBitmap.Access();
+    bool matchesExpectations = (
+      (memory.Width == region.MaxX - region.MinX) &&
+      (memory.Height == region.MaxY - region.MinY) &&
+      (memory.PixelFormat == options.Jpeg.PixelFormat)
+    );
+    if(!matchesExpectations) {
+      throw std::runtime_error(
+        u8"Bitmap provided to Reload() does not have a correct dimensions and pixel format"
       );
-      if(!matchesExpectations) {
-        throw std::runtime_error(
-          u8"Bitmap provided to Reload() does not have a correct dimensions and pixel format"
-        );
-      }
-
-      // Read the bitmap scanline by scanline. The function can also take an array of
-      // scanlines, which may be faster than decoding line-by-line, but this is
-      // the most straightforward way to do it.
-      std::uint8_t *currentRowPointer = reinterpret_cast<std::uint8_t *>(memory.Pixels);
-      while(commonInfo.output_scanline < commonInfo.output_height) {
-        JDIMENSION readScanlineCount = ::jpeg_read_scanlines(&commonInfo, &currentRowPointer, 1);
-        if(readScanlineCount != 1) {
-          throw std::runtime_error(u8"Unknown error reading scanline from jpeg");
-        }
-        currentRowPointer += memory.Stride;
-      }
-
-      // Finish decompression. This does some additional sanity checks, verifying that
-      // the image was decompressed completely and reading the input stream up to the EOI
-      // market (in case it contains multiple images).
-      ::boolean endedWithoutSuspension = ::jpeg_finish_decompress(&commonInfo);
-      if(endedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
-        throw std::runtime_error(u8"Input file truncated");
-      }
+    }
 
+    // If only a region was requested, stop decoding after its last row. Otherwise,
+    // read the bitmap in batches of scanlines straight into the bitmap's memory.
+    if(!coversWholeImage(commonInfo, region)) {
+      readScanlineRegion(commonInfo, scanlinePixelFormat, region, memory);
+      ::jpeg_abort_decompress(&commonInfo);
       return true;
     }
+    readScanlines(commonInfo, scanlinePixelFormat, memory);
+
+    // Finish decompression. This does some additional sanity checks, verifying that
+    // the image was decompressed completely and reading the input stream up to the EOI
+    // market (in case it contains multiple images).
+    ::boolean endedWithoutSuspension = ::jpeg_finish_decompress(&commonInfo);
+    if(endedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
+      throw std::runtime_error(u8"Input file truncated");
+    }
+
+    return true;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void JpegBitmapCodec::Save(const Bitmap &bitmap, VirtualFile &target) const {
-    (void)bitmap;
-    (void)target;
+  void JpegBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    const JpegSaveOptions &jpegOptions = options.Jpeg;
+    if((jpegOptions.Quality < 1) || (jpegOptions.Quality > 100)) {
+      throw std::invalid_argument(u8"JPEG quality must be between 1 and 100");
+    }
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"JPEG files can not store empty bitmaps");
+    }
+
+    // JPEG can only store grayscale or color images. 8 bit grayscale and 24 bit RGB
+    // are handed to libjpeg as they are, everything else is converted to 24 bit RGB.
+    PixelFormat scanlinePixelFormat;
+    int componentCount;
+    ::J_COLOR_SPACE colorSpace;
+    if(memory.PixelFormat == PixelFormat::R8_Unsigned) {
+      scanlinePixelFormat = PixelFormat::R8_Unsigned;
+      componentCount = 1;
+      colorSpace = JCS_GRAYSCALE;
+    } else {
+      scanlinePixelFormat = PixelFormat::R8_G8_B8_Unsigned;
+      componentCount = 3;
+      colorSpace = JCS_RGB;
+    }
 
+    // Set up a custom error manager that throws exceptions rather than exit().
+    // This has to happen before the compression structure is created because
+    // jpeg_create_compress() already reports errors through it.
     ::jpeg_compress_struct commonInfo;
+    struct ::jpeg_error_mgr errorManager;
+    commonInfo.err = ::jpeg_std_error(&errorManager);
+    errorManager.error_exit = &handleJpegError;
+
     ::jpeg_create_compress(&commonInfo);
     {
-      JpegCompressStructScope decompressScope(&commonInfo);
+      JpegCompressStructScope compressScope(&commonInfo);
+
+      // Set up a custom data destination that writes into a virtual file
+      JpegWriteEnvironment virtualFileDestination(target);
+      commonInfo.dest = &virtualFileDestination;
+
+      commonInfo.image_width = static_cast<JDIMENSION>(memory.Width);
+      commonInfo.image_height = static_cast<JDIMENSION>(memory.Height);
+      commonInfo.input_components = componentCount;
+      commonInfo.in_color_space = colorSpace;
+      setupCompression(commonInfo, jpegOptions);
+
+      ::jpeg_start_compress(&commonInfo, TRUE);
+
+      // Hand the scanlines to libjpeg in batches so it can process whole rows of MCUs
+      // per call. If libjpeg can take the bitmap's pixel format as it is, the scanlines
+      // are passed straight from the bitmap's memory, otherwise each batch is converted
+      // into a buffer first.
+      ::JSAMPROW scanlines[JpegScanlineBatchSize];
+      const std::uint8_t *rowStartPointer = static_cast<const std::uint8_t *>(memory.Pixels);
+      if(scanlinePixelFormat == memory.PixelFormat) {
+        while(commonInfo.next_scanline < commonInfo.image_height) {
+          std::size_t batchSize = std::min<std::size_t>(
+            commonInfo.image_height - commonInfo.next_scanline, JpegScanlineBatchSize
+          );
+          for(std::size_t index = 0; index < batchSize; ++index) {
+            // libjpeg's API is not const-correct, but it never writes to the scanlines
+            scanlines[index] = const_cast<::JSAMPLE *>(rowStartPointer);
+            rowStartPointer += memory.Stride;
+          }
+
+          JDIMENSION writtenScanlineCount = ::jpeg_write_scanlines(
+            &commonInfo, scanlines, static_cast<JDIMENSION>(batchSize)
+          );
+          if(writtenScanlineCount != batchSize) {
+            throw std::runtime_error(u8"Unknown error writing scanlines to jpeg");
+          }
+        }
+      } else {
+        std::size_t scanlineByteCount = CountRequiredBytes(scanlinePixelFormat, memory.Width);
+        std::vector<std::uint8_t> convertedScanlines(scanlineByteCount * JpegScanlineBatchSize);
+        for(std::size_t index = 0; index < JpegScanlineBatchSize; ++index) {
+          scanlines[index] = &convertedScanlines[scanlineByteCount * index];
+        }
+
+        while(commonInfo.next_scanline < commonInfo.image_height) {
+          std::size_t batchSize = std::min<std::size_t>(
+            commonInfo.image_height - commonInfo.next_scanline, JpegScanlineBatchSize
+          );
+          for(std::size_t index = 0; index < batchSize; ++index) {
+            PixelFormatConverter::ConvertRow(
+              memory.PixelFormat, rowStartPointer,
+              scanlinePixelFormat, scanlines[index],
+              memory.Width
+            );
+            rowStartPointer += memory.Stride;
+          }
+
+          JDIMENSION writtenScanlineCount = ::jpeg_write_scanlines(
+            &commonInfo, scanlines, static_cast<JDIMENSION>(batchSize)
+          );
+          if(writtenScanlineCount != batchSize) {
+            throw std::runtime_error(u8"Unknown error writing scanlines to jpeg");
+          }
+        }
+      }
+
+      // Finish compression. This flushes the remaining data and writes the EOI marker.
+      ::jpeg_finish_compress(&commonInfo);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSource> JpegBitmapCodec::TryOpenRowSource(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint;
+
+    bool selectsRegion = (
+      (options.Region.MaxX > options.Region.MinX) &&
+      (options.Region.MaxY > options.Region.MinY)
+    );
+    if(selectsRegion) {
+      throw std::invalid_argument(u8"Row sources can not be limited to a region of the image");
+    }
+
+    JpegRowSource *jpegRowSource = new JpegRowSource(source);
+    std::unique_ptr<RowSource> rowSource(jpegRowSource);
+    if(!jpegRowSource->TryStart(options.Jpeg)) {
+      return std::unique_ptr<RowSource>();
     }
 
-    throw std::runtime_error(u8"Not implemented yet");
+    return rowSource;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSink> JpegBitmapCodec::OpenRowSink(
+    VirtualFile &target, std::size_t width, std::size_t height, PixelFormat pixelFormat,
+    const SaveOptions &options /* = SaveOptions() */
+  ) const {
+    const JpegSaveOptions &jpegOptions = options.Jpeg;
+    if((jpegOptions.Quality < 1) || (jpegOptions.Quality > 100)) {
+      throw std::invalid_argument(u8"JPEG quality must be between 1 and 100");
+    }
+    if((width == 0) || (height == 0)) {
+      throw std::invalid_argument(u8"JPEG files can not store empty bitmaps");
+    }
+
+    return std::unique_ptr<RowSink>(
+      new JpegRowSink(target, width, height, pixelFormat, jpegOptions)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool JpegBitmapCodec::TryLoadPlanes(
+    const VirtualFile &source, const LoadOptions &options,
+    Size &imageSize, std::vector<Bitmap> &planes
+  ) const {
+    bool selectsRegion = (
+      (options.Region.MaxX > options.Region.MinX) &&
+      (options.Region.MaxY > options.Region.MinY)
+    );
+    if(selectsRegion) {
+      throw std::invalid_argument(u8"Raw JPEG components can not be limited to a region");
+    }
+
+    // Obtain a decompression structure with an error manager that throws exceptions
+    // rather than exit(), either a fresh one or the one kept in the decode context
+    JpegDecompressScope decompressScope(*this, options);
+    ::jpeg_decompress_struct &commonInfo = decompressScope.GetCommonInfo();
+
+    // Set up a custom data source that reads from a virtual file
+    JpegReadEnvironment virtualFileSource(source);
+    commonInfo.src = &virtualFileSource;
+
+    // Same checks as in TryLoad(): the file has to be large enough for the JPEG/JFIF
+    // header and has to begin with it before libjpeg is asked to read the header
+    if(virtualFileSource.Length < 16) {
+      return false;
+    }
+    if(virtualFileSource.bytes_in_buffer == 0) {
+      virtualFileSource.fill_input_buffer(&commonInfo);
+    }
+    if(!Helpers::IsValidJpegHeader(virtualFileSource.next_input_byte)) {
+      return false;
+    }
+
+    int result = ::jpeg_read_header(&commonInfo, TRUE);
+    if(result != JPEG_HEADER_OK) {
+      throw std::runtime_error(u8"libjpeg failed to read the file header");
+    }
+
+    // Ask libjpeg to hand out the components exactly as they are stored,
+    // skipping upsampling and color conversion entirely
+    commonInfo.raw_data_out = TRUE;
+    commonInfo.do_fancy_upsampling = FALSE;
+    commonInfo.out_color_space = commonInfo.jpeg_color_space;
+    applyLoadScale(commonInfo, options.Jpeg);
+
+    ::boolean startedWithoutSuspension = ::jpeg_start_decompress(&commonInfo);
+    if(startedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
+      throw std::runtime_error(u8"Input file truncated");
+    }
+
+    // Each component is decoded at its stored resolution (scaled like the image)
+    planes.clear();
+    planes.reserve(static_cast<std::size_t>(commonInfo.num_components));
+    for(int index = 0; index < commonInfo.num_components; ++index) {
+      const ::jpeg_component_info &component = commonInfo.comp_info[index];
+      planes.emplace_back(
+        static_cast<std::size_t>(component.downsampled_width),
+        static_cast<std::size_t>(component.downsampled_height),
+        PixelFormat::R8_Unsigned
+      );
+    }
+    readRawComponents(commonInfo, planes);
+
+    ::boolean endedWithoutSuspension = ::jpeg_finish_decompress(&commonInfo);
+    if(endedWithoutSuspension == FALSE) { // decompressor was suspended -- we don't support this
+      throw std::runtime_error(u8"Input file truncated");
+    }
+
+    imageSize.Width = static_cast<std::size_t>(commonInfo.output_width);
+    imageSize.Height = static_cast<std::size_t>(commonInfo.output_height);
+    return true;
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -30,6 +30,8 @@ License along with this library
 #include <cassert>
 #include <algorithm>
 
+#include <jerror.h> // for WARNMS() and JWRN_JPEG_EOF
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
@@ -79,6 +81,16 @@ namespace {
     );
     readEnvironment.Position += targetByteCount;
 
+    // At the end of the file, insert a fake EOI marker like libjpeg's own data sources do.
+    // libjpeg expects at least one byte after each fill and would otherwise read past
+    // the buffer when given a truncated file.
+    if(targetByteCount == 0) {
+      WARNMS(commonInfo, JWRN_JPEG_EOF);
+      readEnvironment.Buffer[0] = 0xFF;
+      readEnvironment.Buffer[1] = JPEG_EOI;
+      targetByteCount = 2;
+    }
+
     // Update the libjpeg decoder's input counters
     readEnvironment.next_input_byte = readEnvironment.Buffer;
     readEnvironment.bytes_in_buffer = targetByteCount;
@@ -117,13 +129,30 @@ namespace {
       throw std::runtime_error(u8"libjpeg advance method was called on a write environment");
     }
 
-    if(readEnvironment.Position + byteCount > readEnvironment.Length) {
+    if(byteCount <= 0) {
+      return; // libjpeg documents that zero or negative skips should be ignored
+    }
+
+    // Skip over the data that is still waiting in libjpeg's input buffer first
+    std::size_t remainingByteCount = static_cast<std::size_t>(byteCount);
+    if(remainingByteCount <= readEnvironment.bytes_in_buffer) {
+      readEnvironment.next_input_byte += remainingByteCount;
+      readEnvironment.bytes_in_buffer -= remainingByteCount;
+      return;
+    }
+
+    remainingByteCount -= readEnvironment.bytes_in_buffer;
+    readEnvironment.next_input_byte = nullptr;
+    readEnvironment.bytes_in_buffer = 0;
+
+    // Anything beyond that is skipped by moving the file cursor, the next read
+    // will then fill libjpeg's input buffer from the new position.
+    if(remainingByteCount > readEnvironment.Length - readEnvironment.Position) {
       throw std::runtime_error(u8"Attempt to seek past end of file");
       //throw Nuclex::Pixels::Errors::FileAccessError(u8"Attempt to seek past end of file");
     }
-    //if(byteCount < 0)
 
-    readEnvironment.Position += byteCount;
+    readEnvironment.Position += remainingByteCount;
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -149,6 +178,105 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Obtains the write environment from a JPEG compression structure</summary>
+  /// <param name="commonInfo">
+  ///   JPEG common compression structure containing the write environment structure
+  /// </param>
+  /// <returns>The write environment set up as the compressor's destination</returns>
+  Nuclex::Pixels::Storage::Jpeg::JpegWriteEnvironment &getWriteEnvironment(
+    struct ::jpeg_compress_struct *commonInfo
+  ) {
+    assert(
+      (commonInfo != nullptr) &&
+      u8"Common compression info structure must always be provided"
+    );
+    assert(
+      (commonInfo->dest != nullptr) &&
+      u8"LibJPEG output data destination must be set up to a JpegWriteEnvironment"
+    );
+
+    Nuclex::Pixels::Storage::Jpeg::JpegWriteEnvironment &writeEnvironment = *static_cast<
+      Nuclex::Pixels::Storage::Jpeg::JpegWriteEnvironment *
+    >(commonInfo->dest);
+
+    if(writeEnvironment.IsReadOnly) {
+      throw std::runtime_error(u8"libjpeg write method was called on a read environment");
+    }
+
+    return writeEnvironment;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hands the empty output buffer to libjpeg before compression begins</summary>
+  /// <param name="commonInfo">
+  ///   JPEG common compression structure containing the write environment structure
+  /// </param>
+  void beginWritingVirtualFile(struct ::jpeg_compress_struct *commonInfo) {
+    Nuclex::Pixels::Storage::Jpeg::JpegWriteEnvironment &writeEnvironment = (
+      getWriteEnvironment(commonInfo)
+    );
+
+    writeEnvironment.next_output_byte = writeEnvironment.Buffer;
+    writeEnvironment.free_in_buffer = Nuclex::Pixels::Storage::Jpeg::JpegOutputBufferSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes the full output buffer into the virtual file</summary>
+  /// <param name="commonInfo">
+  ///   JPEG common compression structure containing the write environment structure
+  /// </param>
+  /// <returns>
+  ///   True if the output buffer has been emptied, false if the encoder should suspend
+  ///   (suspension is complex behavior not needed or implemented by this library!)
+  /// </returns>
+  /// <remarks>
+  ///   libjpeg calls this when the buffer is full, ignoring the free_in_buffer field,
+  ///   so the whole buffer needs to be written.
+  /// </remarks>
+  ::boolean writeVirtualFile(struct ::jpeg_compress_struct *commonInfo) {
+    Nuclex::Pixels::Storage::Jpeg::JpegWriteEnvironment &writeEnvironment = (
+      getWriteEnvironment(commonInfo)
+    );
+
+    writeEnvironment.File.WriteAt(
+      writeEnvironment.Position,
+      Nuclex::Pixels::Storage::Jpeg::JpegOutputBufferSize,
+      writeEnvironment.Buffer
+    );
+    writeEnvironment.Position += Nuclex::Pixels::Storage::Jpeg::JpegOutputBufferSize;
+
+    writeEnvironment.next_output_byte = writeEnvironment.Buffer;
+    writeEnvironment.free_in_buffer = Nuclex::Pixels::Storage::Jpeg::JpegOutputBufferSize;
+
+    return TRUE;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes the data remaining in the output buffer into the virtual file</summary>
+  /// <param name="commonInfo">
+  ///   JPEG common compression structure containing the write environment structure
+  /// </param>
+  void endWritingVirtualFile(struct ::jpeg_compress_struct *commonInfo) {
+    Nuclex::Pixels::Storage::Jpeg::JpegWriteEnvironment &writeEnvironment = (
+      getWriteEnvironment(commonInfo)
+    );
+
+    std::size_t remainingByteCount = (
+      Nuclex::Pixels::Storage::Jpeg::JpegOutputBufferSize - writeEnvironment.free_in_buffer
+    );
+    if(remainingByteCount > 0) {
+      writeEnvironment.File.WriteAt(
+        writeEnvironment.Position, remainingByteCount, writeEnvironment.Buffer
+      );
+      writeEnvironment.Position += remainingByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
@@ -271,14 +399,12 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
   // ------------------------------------------------------------------------------------------- //
 
   void JpegWriteEnvironment::SetupFunctionPointers(JpegWriteEnvironment &jpegWriteEnvironment) {
-    jpegWriteEnvironment.init_source = &doNothingWithDecompressStruct;
-    //jpegWriteEnvironment.fill_input_buffer = &readVirtualFile;
-    //jpegWriteEnvironment.skip_input_data = &advanceVirtualFileCursor;
-    //jpegWriteEnvironment.resync_to_restart = &throwResyncNotSupported;
-    jpegWriteEnvironment.term_source = &doNothingWithDecompressStruct;
-
-    jpegWriteEnvironment.next_input_byte = nullptr;
-    jpegWriteEnvironment.bytes_in_buffer = 0;
+    jpegWriteEnvironment.init_destination = &beginWritingVirtualFile;
+    jpegWriteEnvironment.empty_output_buffer = &writeVirtualFile;
+    jpegWriteEnvironment.term_destination = &endWritingVirtualFile;
+
+    jpegWriteEnvironment.next_output_byte = nullptr;
+    jpegWriteEnvironment.free_in_buffer = 0;
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -43,6 +43,21 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
   /// </remarks>
   constexpr const std::size_t JpegInputBufferSize = 4096;
 
+  /// <summary>Size of the output buffer for writing file data from libjpeg</summary>
+  /// <remarks>
+  ///   This is the same size as used by the (FILE *) implementation set up by
+  ///   the init_destination() function in jdatadst.c.
+  /// </remarks>
+  constexpr const std::size_t JpegOutputBufferSize = 4096;
+
+  /// <summary>Number of scanlines that are handed to libjpeg in one call</summary>
+  /// <remarks>
+  ///   libjpeg works on rows of MCUs, which are 16 scanlines high when the chroma channels
+  ///   are subsampled vertically. Handing it that many scanlines at once lets it process
+  ///   a full row of MCUs per call instead of buffering the scanlines one by one.
+  /// </remarks>
+  constexpr const std::size_t JpegScanlineBatchSize = 16;
+
   /// <summary>Size of the smallest valid JPEG file possible</summary>
   /// <remarks>
   ///   From https://stackoverflow.com/questions/2253404
@@ -87,6 +102,17 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
       Position(0) {
       this->Length = file.GetSize();
       SetupFunctionPointers(*this);
+
+      // If the whole file is available in memory (i.e. because it is a memory-mapped
+      // file), hand it to libjpeg in one piece and skip the intermediate buffer.
+      const std::uint8_t *contents = file.TryGetContiguousSpan(
+        0, static_cast<std::size_t>(this->Length)
+      );
+      if(contents != nullptr) {
+        this->next_input_byte = contents;
+        this->bytes_in_buffer = static_cast<std::size_t>(this->Length);
+        this->Position = this->Length;
+      }
     }
 
     /// <summary>Sets up the functions pointers used by libjpeg</summary>
@@ -111,7 +137,7 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Data required by the libjpeg IO functions to write to virtual files</summary>
-  struct JpegWriteEnvironment : public ::jpeg_source_mgr {
+  struct JpegWriteEnvironment : public ::jpeg_destination_mgr {
 
     /// <summary>Initializes a new libjpeg write  environment</summary>
     /// <param name="file">Virtual file into which data will be written</param>
@@ -130,10 +156,12 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Jpeg {
 
     /// <summary>Whether the virtual file is opened in read-only mode</summary>
     public: bool IsReadOnly;
-    /// <summary>Virtual file the read environment is taking data from</summary>
+    /// <summary>Virtual file the write environment is putting data into</summary>
     public: VirtualFile &File;
     /// <summary>Current position of the file cursor</summary>
     public: std::uint64_t Position;
+    /// <summary>Buffer in which libjpeg stores data before it is written</summary>
+    public: std::uint8_t Buffer[JpegOutputBufferSize];
 
   };
 
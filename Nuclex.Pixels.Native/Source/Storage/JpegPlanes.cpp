@@ -0,0 +1,87 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/JpegPlanes.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include "Jpeg/JpegBitmapCodec.h"
+
+#include <stdexcept> // for std::out_of_range
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  JpegPlanes JpegPlanes::Load(
+    const std::string &path, const LoadOptions &options /* = LoadOptions() */
+  ) {
+    std::unique_ptr<const VirtualFile> file = VirtualFile::OpenMemoryMappedFileForReading(path);
+    return Load(*file, options);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  JpegPlanes JpegPlanes::Load(
+    const VirtualFile &file, const LoadOptions &options /* = LoadOptions() */
+  ) {
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+    JpegPlanes jpegPlanes;
+
+    Size imageSize(0, 0);
+    bool isJpeg = Jpeg::JpegBitmapCodec().TryLoadPlanes(
+      file, options, imageSize, jpegPlanes.planes
+    );
+    if(!isJpeg) {
+      throw Errors::FileFormatError(u8"File is not a JPEG file");
+    }
+
+    jpegPlanes.width = imageSize.Width;
+    jpegPlanes.height = imageSize.Height;
+    return jpegPlanes;
+#else
+    (void)file;
+    (void)options;
+    throw std::runtime_error(u8"Nuclex.Pixels.Native was built without libjpeg");
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  JpegPlanes::JpegPlanes() :
+    width(0),
+    height(0) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Bitmap &JpegPlanes::GetPlane(std::size_t planeIndex) const {
+    if(planeIndex >= this->planes.size()) {
+      throw std::out_of_range(u8"Plane index is out of range");
+    }
+
+    return this->planes[planeIndex];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,294 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Ktx2BitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include <cstring> // for std::memcmp()
+#include <vector> // for std::vector
+
+// Layout of the KTX 2.0 header is documented at
+// https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifier at the start of each KTX 2.0 file</summary>
+  const std::uint8_t Ktx2Identifier[12] = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+  };
+
+  /// <summary>Size of the identifier, the header and the index</summary>
+  const std::size_t Ktx2HeaderByteCount = 80;
+  /// <summary>Size of each entry in the level index following the header</summary>
+  const std::size_t Ktx2LevelIndexEntryByteCount = 24;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the pixel format equivalent to a Vulkan format</summary>
+  /// <param name="vkFormat">Vulkan format whose pixel format will be looked up</param>
+  /// <param name="pixelFormat">Receives the equivalent pixel format</param>
+  /// <returns>True if there is an equivalent pixel format, false otherwise</returns>
+  bool tryGetPixelFormatFromVulkan(
+    std::uint32_t vkFormat, Nuclex::Pixels::PixelFormat &pixelFormat
+  ) {
+    using Nuclex::Pixels::PixelFormat;
+    using Nuclex::Pixels::Storage::GetLittleEndianFormat;
+
+    switch(vkFormat) {
+      case 4: { // VK_FORMAT_R5G6B5_UNORM_PACK16
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R5_G6_B5_Unsigned);
+        return true;
+      }
+      case 9: { // VK_FORMAT_R8_UNORM
+        pixelFormat = PixelFormat::R8_Unsigned;
+        return true;
+      }
+      case 16: { // VK_FORMAT_R8G8_UNORM
+        pixelFormat = PixelFormat::R8_G8_Unsigned;
+        return true;
+      }
+      case 23: // VK_FORMAT_R8G8B8_UNORM
+      case 29: { // VK_FORMAT_R8G8B8_SRGB
+        pixelFormat = PixelFormat::R8_G8_B8_Unsigned;
+        return true;
+      }
+      case 30: // VK_FORMAT_B8G8R8_UNORM
+      case 36: { // VK_FORMAT_B8G8R8_SRGB
+        pixelFormat = PixelFormat::B8_G8_R8_Unsigned;
+        return true;
+      }
+      case 37: // VK_FORMAT_R8G8B8A8_UNORM
+      case 43: { // VK_FORMAT_R8G8B8A8_SRGB
+        pixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned;
+        return true;
+      }
+      case 44: // VK_FORMAT_B8G8R8A8_UNORM
+      case 50: { // VK_FORMAT_B8G8R8A8_SRGB
+        pixelFormat = PixelFormat::B8_G8_R8_A8_Unsigned;
+        return true;
+      }
+      case 70: { // VK_FORMAT_R16_UNORM
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_Unsigned_Native16);
+        return true;
+      }
+      case 76: { // VK_FORMAT_R16_SFLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_Float_Native16);
+        return true;
+      }
+      case 77: { // VK_FORMAT_R16G16_UNORM
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_G16_Unsigned_Native16);
+        return true;
+      }
+      case 83: { // VK_FORMAT_R16G16_SFLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_G16_Float_Native16);
+        return true;
+      }
+      case 97: { // VK_FORMAT_R16G16B16A16_SFLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R16_G16_B16_A16_Float);
+        return true;
+      }
+      case 100: { // VK_FORMAT_R32_SFLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R32_Float_Native32);
+        return true;
+      }
+      case 109: { // VK_FORMAT_R32G32B32A32_SFLOAT
+        pixelFormat = GetLittleEndianFormat(PixelFormat::R32_G32_B32_A32_Float);
+        return true;
+      }
+      case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+      case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+      case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+      case 134: { // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+        pixelFormat = PixelFormat::BC1_Compressed;
+        return true;
+      }
+      case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+      case 138: { // VK_FORMAT_BC3_SRGB_BLOCK
+        pixelFormat = PixelFormat::BC3_Compressed;
+        return true;
+      }
+      case 139: { // VK_FORMAT_BC4_UNORM_BLOCK
+        pixelFormat = PixelFormat::BC4_Compressed;
+        return true;
+      }
+      case 141: { // VK_FORMAT_BC5_UNORM_BLOCK
+        pixelFormat = PixelFormat::BC5_Compressed;
+        return true;
+      }
+      case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+      case 146: { // VK_FORMAT_BC7_SRGB_BLOCK
+        pixelFormat = PixelFormat::BC7_Compressed;
+        return true;
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file begins with the KTX 2.0 identifier</summary>
+  /// <param name="source">File whose header will be checked</param>
+  /// <returns>True if the file looks like a KTX 2.0 file, false otherwise</returns>
+  bool hasKtx2Identifier(const Nuclex::Pixels::Storage::VirtualFile &source) {
+    if(source.GetSize() < Ktx2HeaderByteCount) {
+      return false; // File is too short to be a KTX 2.0 file
+    }
+
+    std::uint8_t fileHeader[sizeof(Ktx2Identifier)];
+    source.ReadAt(0, sizeof(fileHeader), fileHeader);
+    return (std::memcmp(fileHeader, Ktx2Identifier, sizeof(Ktx2Identifier)) == 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Ktx {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Ktx2BitmapCodec::Ktx2BitmapCodec() :
+    name(u8"Khronos Texture 2.0 (.ktx2) textures") {
+    this->knownFileExtensions.push_back(u8"ktx2");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Ktx2BitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    if(fileHeaderByteCount < sizeof(Ktx2Identifier)) {
+      return false; // Too short for the KTX 2.0 identifier
+    }
+
+    return (std::memcmp(fileHeader, Ktx2Identifier, sizeof(Ktx2Identifier)) == 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Ktx2BitmapCodec::CanSave() const {
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Ktx2BitmapCodec::TryReadLayout(const VirtualFile &source, TextureLayout &layout) const {
+    if(!hasKtx2Identifier(source)) {
+      return false;
+    }
+
+    std::uint64_t fileSize = source.GetSize();
+
+    std::uint8_t header[Ktx2HeaderByteCount];
+    source.ReadAt(0, Ktx2HeaderByteCount, header);
+
+    layout.Width = ReadLittleEndianUInt32(header + 20);
+    layout.Height = ReadLittleEndianUInt32(header + 24);
+    if(layout.Width == 0) {
+      throw Errors::FileFormatError(u8"KTX2 file contains an empty texture");
+    }
+    if(layout.Height == 0) {
+      layout.Height = 1; // One-dimensional textures store a height of zero
+    }
+    if(ReadLittleEndianUInt32(header + 28) != 0) {
+      throw Errors::FileFormatError(u8"KTX2 volume textures are not supported");
+    }
+    if(ReadLittleEndianUInt32(header + 32) != 0) {
+      throw Errors::FileFormatError(u8"KTX2 texture arrays are not supported");
+    }
+    if(ReadLittleEndianUInt32(header + 36) != 1) {
+      throw Errors::FileFormatError(u8"KTX2 cube maps are not supported");
+    }
+    if(ReadLittleEndianUInt32(header + 44) != 0) {
+      throw Errors::FileFormatError(u8"Supercompressed KTX2 files are not supported");
+    }
+
+    if(!tryGetPixelFormatFromVulkan(ReadLittleEndianUInt32(header + 12), layout.PixelFormat)) {
+      throw Errors::FileFormatError(u8"KTX2 file uses an unsupported pixel format");
+    }
+
+    // A level count of zero asks the loader to generate the mip levels, but only
+    // the largest one is stored in the file
+    std::size_t levelCount = ReadLittleEndianUInt32(header + 40);
+    if(levelCount == 0) {
+      levelCount = 1;
+    }
+    if(!IsValidTextureLevelCount(layout.Width, layout.Height, levelCount)) {
+      throw Errors::FileFormatError(u8"KTX2 file has an invalid number of mip levels");
+    }
+
+    std::size_t levelIndexByteCount = levelCount * Ktx2LevelIndexEntryByteCount;
+    if(fileSize < Ktx2HeaderByteCount + levelIndexByteCount) {
+      throw Errors::FileFormatError(u8"KTX2 file is truncated");
+    }
+    std::vector<std::uint8_t> levelIndex(levelIndexByteCount);
+    source.ReadAt(Ktx2HeaderByteCount, levelIndexByteCount, &levelIndex[0]);
+
+    // The level index always begins with the largest mip level, even though
+    // KTX 2.0 files store the smallest mip level first
+    layout.Levels.reserve(levelCount);
+    std::size_t width = layout.Width;
+    std::size_t height = layout.Height;
+    for(std::size_t index = 0; index < levelCount; ++index) {
+      const std::uint8_t *entry = &levelIndex[index * Ktx2LevelIndexEntryByteCount];
+
+      TextureLevelLayout level;
+      level.Width = width;
+      level.Height = height;
+      level.Offset = ReadLittleEndianUInt64(entry);
+      level.ByteCount = CountTextureLevelBytes(layout.PixelFormat, width, height);
+      if(ReadLittleEndianUInt64(entry + 8) < level.ByteCount) {
+        throw Errors::FileFormatError(u8"KTX2 mip level is smaller than its dimensions require");
+      }
+      if((level.ByteCount > fileSize) || (level.Offset > fileSize - level.ByteCount)) {
+        throw Errors::FileFormatError(u8"KTX2 file is truncated");
+      }
+      layout.Levels.push_back(level);
+
+      width = (width > 1) ? (width / 2) : 1;
+      height = (height > 1) ? (height / 2) : 1;
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Ktx2BitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    (void)bitmap;
+    (void)target;
+    (void)options;
+    throw Errors::FileFormatError(u8"Saving KTX2 files is not supported");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Ktx
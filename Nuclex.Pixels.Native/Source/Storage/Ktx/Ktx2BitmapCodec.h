@@ -0,0 +1,92 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_KTX_KTX2BITMAPCODEC_H
+#define NUCLEX_PIXELS_STORAGE_KTX_KTX2BITMAPCODEC_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include "../TextureBitmapCodec.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Ktx {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads textures in the Khronos KTX 2.0 format</summary>
+  /// <remarks>
+  ///   Only two-dimensional textures (with or without mip levels) are supported, cube maps,
+  ///   volume textures, texture arrays and supercompressed files are rejected. This codec
+  ///   can not save bitmaps.
+  /// </remarks>
+  class Ktx2BitmapCodec : public TextureBitmapCodec {
+
+    /// <summary>Initializes a new KTX2 bitmap codec</summary>
+    public: Ktx2BitmapCodec();
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~Ktx2BitmapCodec() = default;
+
+    /// <summary>Gives the name of the file format implemented by this codec</summary>
+    /// <returns>The name of the file format this codec implements</returns>
+    public: const std::string &GetName() const override { return this->name; }
+
+    /// <summary>Provides commonly used file extensions for this codec</summary>
+    /// <returns>The commonly used file extensions in order of preference</returns>
+    public: const std::vector<std::string> &GetFileExtensions() const override {
+      return this->knownFileExtensions;
+    }
+
+    /// <summary>Checks whether a file header looks like it's in the codec's file format</summary>
+    /// <param name="fileHeader">The first bytes of the file that will be checked</param>
+    /// <param name="fileHeaderByteCount">Number of bytes in the file header</param>
+    /// <returns>False if the codec is certain not to be able to load the file</returns>
+    public: bool IsValidFileHeader(
+      const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+    ) const override;
+
+    /// <summary>Checks if the codec is able to save bitmaps to storage</summary>
+    /// <returns>True if the codec supports saving bitmaps</returns>
+    public: bool CanSave() const override;
+
+    /// <summary>Saves the specified bitmap into a file</summary>
+    /// <param name="bitmap">Bitmap that will be saved into a file</param>
+    /// <param name="target">File into which the bitmap will be saved</param>
+    /// <param name="options">Settings controlling how the file will be written</param>
+    public: void Save(
+      const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options = SaveOptions()
+    ) const override;
+
+    /// <summary>Tries to locate the mip levels in a texture file</summary>
+    /// <param name="source">File in which the mip levels will be located</param>
+    /// <param name="layout">Receives the dimensions and locations of all mip levels</param>
+    /// <returns>True if the file was a KTX2 file, false otherwise</returns>
+    public: bool TryReadLayout(const VirtualFile &source, TextureLayout &layout) const override;
+
+    /// <summary>Human-readable name of the file format this codec implements</summary>
+    private: std::string name;
+    /// <summary>File extensions this file format is known to use</summary>
+    private: std::vector<std::string> knownFileExtensions;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Ktx
+
+#endif // NUCLEX_PIXELS_STORAGE_KTX_KTX2BITMAPCODEC_H
@@ -0,0 +1,125 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/LazyBitmap.h"
+#include "Nuclex/Pixels/Storage/BitmapCodec.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LazyBitmap::LazyBitmap(
+    const BitmapCodec &codec, const BitmapInfo &info,
+    std::unique_ptr<const VirtualFile> &&file, const std::string &extensionHint,
+    const LoadOptions &options
+  ) :
+    codec(&codec),
+    info(info),
+    file(std::move(file)),
+    extensionHint(extensionHint),
+    options(options) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LazyBitmap::LazyBitmap(
+    const BitmapCodec &codec, const BitmapInfo &info,
+    const std::string &path, const std::string &extensionHint,
+    const LoadOptions &options
+  ) :
+    codec(&codec),
+    info(info),
+    path(path),
+    extensionHint(extensionHint),
+    options(options) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LazyBitmap::LazyBitmap(LazyBitmap &&other) :
+    codec(other.codec),
+    info(other.info),
+    file(std::move(other.file)),
+    path(std::move(other.path)),
+    extensionHint(std::move(other.extensionHint)),
+    options(other.options),
+    bitmap(std::move(other.bitmap)) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LazyBitmap::~LazyBitmap() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Bitmap &LazyBitmap::GetBitmap() const {
+    if(this->bitmap) {
+      return *this->bitmap.get();
+    }
+
+    OptionalBitmap loadedBitmap;
+    if(this->file) {
+      loadedBitmap = this->codec->TryLoad(*this->file.get(), this->extensionHint, this->options);
+    } else {
+      std::unique_ptr<const VirtualFile> reopenedFile = (
+        VirtualFile::OpenRealFileForReading(this->path, true)
+      );
+      if(this->options.ReadAheadByteCount != 0) {
+        reopenedFile = VirtualFile::AddReadAheadBuffer(
+          std::move(reopenedFile), this->options.ReadAheadByteCount
+        );
+      }
+      loadedBitmap = this->codec->TryLoad(*reopenedFile.get(), this->extensionHint, this->options);
+    }
+
+    // The codec already accepted the file when its header was read, so if it refuses
+    // now, the file must have been changed or replaced in the meantime
+    if(!loadedBitmap.HasValue()) {
+      throw Errors::FileFormatError(u8"File can no longer be loaded by the codec that read it");
+    }
+
+    this->bitmap = std::make_unique<Bitmap>(loadedBitmap.Take());
+    return *this->bitmap.get();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LazyBitmap::Unload() {
+    this->bitmap.reset();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LazyBitmap &LazyBitmap::operator =(LazyBitmap &&other) {
+    this->codec = other.codec;
+    this->info = other.info;
+    this->file = std::move(other.file);
+    this->path = std::move(other.path);
+    this->extensionHint = std::move(other.extensionHint);
+    this->options = other.options;
+    this->bitmap = std::move(other.bitmap);
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,301 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "MappedFile.h"
+#include "Nuclex/Pixels/Errors/FileAccessError.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <vector>
+
+// The OS-specific helpers for opening files and reporting errors are shared with
+// the RealFile implementation. They check for its header to be included first.
+#include "RealFile.h"
+#include "RealFile.Windows.inl"
+#include "RealFile.Posix.inl"
+#include "RealFile.Linux.inl"
+
+#if !defined(NUCLEX_PIXELS_WIN32)
+#include <fcntl.h> // open()
+#include <sys/mman.h> // mmap(), munmap()
+#include <unistd.h> // close(), sysconf()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_PIXELS_WIN32)
+
+  /// <summary>RAII helper that closes a file descriptor when it goes out of scope</summary>
+  class FileDescriptorScope {
+
+    /// <summary>Initializes a new file descriptor closer</summary>
+    /// <param name="fileDescriptor">File descriptor that will be closed</param>
+    public: FileDescriptorScope(int fileDescriptor) :
+      fileDescriptor(fileDescriptor) {}
+
+    /// <summary>Closes the file descriptor</summary>
+    public: ~FileDescriptorScope() {
+      ::close(this->fileDescriptor);
+    }
+
+    /// <summary>File descriptor that will be closed</summary>
+    private: int fileDescriptor;
+
+  };
+
+#endif // !defined(NUCLEX_PIXELS_WIN32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_WIN32)
+
+  /// <summary>RAII helper that closes a Windows handle when it goes out of scope</summary>
+  class HandleScope {
+
+    /// <summary>Initializes a new handle closer</summary>
+    /// <param name="handle">Handle that will be closed</param>
+    public: HandleScope(HANDLE handle) :
+      handle(handle) {}
+
+    /// <summary>Closes the handle</summary>
+    public: ~HandleScope() {
+      ::CloseHandle(this->handle);
+    }
+
+    /// <summary>Handle that will be closed</summary>
+    private: HANDLE handle;
+
+  };
+
+#endif // defined(NUCLEX_PIXELS_WIN32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFile::MappedFile(const std::string &path, bool promiseSequentialAccess) :
+    contents(nullptr),
+    length(0) {
+#if defined(NUCLEX_PIXELS_WIN32)
+
+    HANDLE fileHandle = openWindowsFileForReading(path, promiseSequentialAccess);
+    HandleScope fileHandleScope(fileHandle);
+
+    this->length = getWindowsFileSize(fileHandle);
+    if(this->length == 0) {
+      return; // Empty files can not be mapped
+    }
+    if(this->length > static_cast<std::uint64_t>(static_cast<SIZE_T>(-1))) {
+      throwWindowsFileAccessError(ERROR_NOT_ENOUGH_MEMORY);
+    }
+
+    HANDLE mappingHandle = ::CreateFileMappingW(
+      fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr
+    );
+    if(mappingHandle == nullptr) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwWindowsFileAccessError(lastErrorCode);
+    }
+
+    // The view keeps the mapping and the file open, so both handles can be closed
+    HandleScope mappingHandleScope(mappingHandle);
+    void *view = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if(view == nullptr) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwWindowsFileAccessError(lastErrorCode);
+    }
+
+    this->contents = static_cast<const std::uint8_t *>(view);
+
+#else // Linux and Posix both offer mmap()
+
+#if defined(NUCLEX_PIXELS_LINUX)
+    int fileDescriptor = ::open(path.c_str(), O_RDONLY | O_NOATIME);
+#else
+    int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+#endif
+    if(fileDescriptor == -1) {
+      int errorNumber = errno;
+      throwPosixFileAccessError(errorNumber);
+    }
+    FileDescriptorScope fileDescriptorScope(fileDescriptor);
+
+#if defined(NUCLEX_PIXELS_LINUX)
+    this->length = getLinuxFileSize(fileDescriptor);
+#else
+    this->length = getPosixFileSize(path);
+#endif
+    if(this->length == 0) {
+      return; // Empty files can not be mapped
+    }
+    if(this->length > static_cast<std::uint64_t>(static_cast<std::size_t>(-1))) {
+      throwPosixFileAccessError(ENOMEM);
+    }
+
+    // The mapping keeps the file open, so the file descriptor can be closed
+    void *mapping = ::mmap(
+      nullptr, static_cast<std::size_t>(this->length), PROT_READ, MAP_PRIVATE, fileDescriptor, 0
+    );
+    if(mapping == MAP_FAILED) {
+      int errorNumber = errno;
+      throwPosixFileAccessError(errorNumber);
+    }
+
+    // Tell the OS how we intend to access the pages. This is only a hint,
+    // so there's no need to fail if the OS doesn't want to hear about it.
+    ::posix_madvise(
+      mapping,
+      static_cast<std::size_t>(this->length),
+      promiseSequentialAccess ? POSIX_MADV_SEQUENTIAL : POSIX_MADV_NORMAL
+    );
+
+    this->contents = static_cast<const std::uint8_t *>(mapping);
+
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFile::~MappedFile() {
+    if(this->contents != nullptr) {
+#if defined(NUCLEX_PIXELS_WIN32)
+      ::UnmapViewOfFile(this->contents);
+#else // Linux and Posix both offer mmap()
+      ::munmap(
+        const_cast<std::uint8_t *>(this->contents), static_cast<std::size_t>(this->length)
+      );
+#endif
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+  ) const {
+    const std::uint8_t *source = TryGetContiguousSpan(start, byteCount);
+    if(source == nullptr) {
+#if defined(NUCLEX_PIXELS_WIN32)
+      throwWindowsFileAccessError(ERROR_HANDLE_EOF);
+#else
+      throwPosixFileAccessError(EINVAL);
+#endif
+    }
+
+    std::memcpy(buffer, source, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+
+#if defined(NUCLEX_PIXELS_WIN32)
+    throwWindowsFileAccessError(ERROR_ACCESS_DENIED);
+#else
+    throwPosixFileAccessError(EBADF);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::AdviseSequential() const {
+#if defined(NUCLEX_PIXELS_WIN32)
+
+    // Windows only takes this hint when opening the file (FILE_FLAG_SEQUENTIAL_SCAN)
+
+#else // Linux and Posix both offer mmap()
+
+    if(this->contents != nullptr) {
+      ::posix_madvise(
+        const_cast<std::uint8_t *>(this->contents),
+        static_cast<std::size_t>(this->length),
+        POSIX_MADV_SEQUENTIAL
+      );
+    }
+
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFile::Prefetch(std::uint64_t start, std::uint64_t byteCount) const {
+    if((this->contents == nullptr) || (start >= this->length)) {
+      return;
+    }
+    byteCount = std::min(byteCount, this->length - start);
+
+#if defined(NUCLEX_PIXELS_WIN32)
+
+#if defined(_WIN32_WINNT_WIN8) && (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<std::uint8_t *>(this->contents + start);
+    range.NumberOfBytes = static_cast<SIZE_T>(byteCount);
+
+    // Pages the range in asynchronously. Only a hint, so errors are ignored.
+    ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+#endif
+
+#else // Linux and Posix both offer mmap()
+
+    // The address has to be page-aligned. The mapping itself starts on a page boundary.
+    std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t alignedStart = static_cast<std::size_t>(start) / pageSize * pageSize;
+    ::posix_madvise(
+      const_cast<std::uint8_t *>(this->contents + alignedStart),
+      static_cast<std::size_t>(start + byteCount) - alignedStart,
+      POSIX_MADV_WILLNEED
+    );
+
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::uint8_t *MappedFile::TryGetContiguousSpan(
+    std::uint64_t start, std::size_t byteCount
+  ) const {
+    if((start > this->length) || (byteCount > this->length - start)) {
+      return nullptr;
+    }
+    if(this->contents == nullptr) { // File is empty, there's no mapping to point into
+      static const std::uint8_t nothing = 0;
+      return &nothing;
+    }
+
+    return this->contents + start;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,100 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_MAPPEDFILE_H
+#define NUCLEX_PIXELS_STORAGE_MAPPEDFILE_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads data from a file in the OS' file system mapped into memory</summary>
+  /// <remarks>
+  ///   The whole file is mapped into the process' address space when it is opened and
+  ///   the OS pages its contents in on demand. Codecs can obtain the mapped contents
+  ///   via <see cref="TryGetContiguousSpan" /> and decode them without copying any
+  ///   data into intermediate buffers.
+  /// </remarks>
+  class MappedFile : public VirtualFile {
+
+    /// <summary>Initializes a new instance mapping the file at the specified path</summary>
+    /// <param name="path">Path of the file that will be mapped into memory</param>
+    /// <param name="promiseSequentialAccess">
+    ///   Whether you promise to read from the file sequentially only
+    /// </param>
+    public: MappedFile(const std::string &path, bool promiseSequentialAccess);
+
+    /// <summary>Unmaps the file and frees all memory used by the instance</summary>
+    public: virtual ~MappedFile();
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override;
+
+    /// <summary>Always throws because mapped files are read-only</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override;
+
+    /// <summary>Tells the file that it will be read from start to end</summary>
+    public: void AdviseSequential() const override;
+
+    /// <summary>Asks the file to load a range of its contents in the background</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes the range covers</param>
+    public: void Prefetch(std::uint64_t start, std::uint64_t byteCount) const override;
+
+    /// <summary>Provides direct access to the mapped contents of the file</summary>
+    /// <param name="start">Offset in the file at which the span should begin</param>
+    /// <param name="byteCount">Number of bytes the span should cover</param>
+    /// <returns>The address of the requested bytes in the file mapping</returns>
+    public: const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
+    private: MappedFile(const MappedFile &) = delete;
+    private: MappedFile &operator =(const MappedFile &) = delete;
+
+    /// <summary>Address at which the file has been mapped, null for empty files</summary>
+    private: const std::uint8_t *contents;
+    /// <summary>Length of the file in bytes</summary>
+    private: std::uint64_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_MAPPEDFILE_H
@@ -0,0 +1,80 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "MemoryFile.h"
+#include "Nuclex/Pixels/Errors/FileAccessError.h"
+
+#include <cstring> // for std::memcpy()
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+  ) const {
+    const std::uint8_t *source = TryGetContiguousSpan(start, byteCount);
+    if(source == nullptr) {
+      throw Errors::FileAccessError(
+        std::make_error_code(std::errc::invalid_argument),
+        u8"Attempted to read beyond the end of the memory file"
+      );
+    }
+
+    std::memcpy(buffer, source, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+  ) {
+    (void)start;
+    (void)byteCount;
+    (void)buffer;
+
+    throw Errors::FileAccessError(
+      std::make_error_code(std::errc::permission_denied),
+      u8"Memory files can not be written to"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::uint8_t *MemoryFile::TryGetContiguousSpan(
+    std::uint64_t start, std::size_t byteCount
+  ) const {
+    if((start > this->length) || (byteCount > this->length - start)) {
+      return nullptr;
+    }
+    if(this->contents == nullptr) { // Empty file, hand out something that's not null
+      static const std::uint8_t nothing = 0;
+      return &nothing;
+    }
+
+    return this->contents + start;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
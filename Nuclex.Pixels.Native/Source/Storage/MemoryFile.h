@@ -0,0 +1,88 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_MEMORYFILE_H
+#define NUCLEX_PIXELS_STORAGE_MEMORYFILE_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads data from a block of memory provided by the caller</summary>
+  /// <remarks>
+  ///   The memory is not copied, so it has to stay valid for as long as the file
+  ///   is in use. Codecs can obtain the memory via <see cref="TryGetContiguousSpan" />
+  ///   and hand it to the image libraries in one piece.
+  /// </remarks>
+  class MemoryFile : public VirtualFile {
+
+    /// <summary>Initializes a new memory file reading from the specified memory</summary>
+    /// <param name="contents">Memory holding the contents of the file</param>
+    /// <param name="length">Length of the file in bytes</param>
+    public: MemoryFile(const void *contents, std::size_t length) :
+      contents(static_cast<const std::uint8_t *>(contents)),
+      length(length) {}
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: virtual ~MemoryFile() = default;
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override;
+
+    /// <summary>Always throws because memory files are read-only</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override;
+
+    /// <summary>Provides direct access to the memory holding the file</summary>
+    /// <param name="start">Offset in the file at which the span should begin</param>
+    /// <param name="byteCount">Number of bytes the span should cover</param>
+    /// <returns>The address of the requested bytes in memory</returns>
+    public: const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t start, std::size_t byteCount
+    ) const override;
+
+    /// <summary>Memory holding the contents of the file</summary>
+    private: const std::uint8_t *contents;
+    /// <summary>Length of the file in bytes</summary>
+    private: std::size_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_MEMORYFILE_H
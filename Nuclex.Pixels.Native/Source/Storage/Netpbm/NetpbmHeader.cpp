@@ -0,0 +1,180 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "NetpbmHeader.h"
+
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include <algorithm> // for std::min()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Maximum number of bytes the text part of a Netpbm header may occupy</summary>
+  /// <remarks>
+  ///   The specification puts no limit on the length of comments, but the headers
+  ///   of any Netpbm file seen in practice are far shorter than this.
+  /// </remarks>
+  const std::size_t MaximumHeaderByteCount = 4096;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a character is whitespace according to the Netpbm spec</summary>
+  /// <param name="character">Character that will be checked</param>
+  /// <returns>True if the character is whitespace</returns>
+  bool isWhitespace(std::uint8_t character) {
+    return (
+      (character == ' ') || (character == '\t') || (character == '\n') ||
+      (character == '\r') || (character == '\v') || (character == '\f')
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the next whitespace-separated field from a Netpbm header</summary>
+  /// <param name="header">Text of the header the field will be read from</param>
+  /// <param name="length">Number of bytes in the header text</param>
+  /// <param name="position">Position at which reading begins, advanced past the field</param>
+  /// <returns>The field that was read</returns>
+  std::string readField(const std::uint8_t *header, std::size_t length, std::size_t &position) {
+
+    // Skip whitespace and comments, which run until the end of the line
+    while(position < length) {
+      if(header[position] == '#') {
+        while((position < length) && (header[position] != '\n') && (header[position] != '\r')) {
+          ++position;
+        }
+      } else if(isWhitespace(header[position])) {
+        ++position;
+      } else {
+        break;
+      }
+    }
+
+    std::size_t start = position;
+    while((position < length) && !isWhitespace(header[position]) && (header[position] != '#')) {
+      ++position;
+    }
+    if((position == start) || (position >= length)) {
+      throw Nuclex::Pixels::Errors::FileFormatError(u8"Netpbm header is malformed");
+    }
+
+    return std::string(reinterpret_cast<const char *>(header + start), position - start);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses the width or height field of a Netpbm header</summary>
+  /// <param name="field">Field that will be parsed</param>
+  /// <returns>The dimension stored in the field</returns>
+  std::size_t parseDimension(const std::string &field) {
+    std::size_t value = 0;
+    for(std::size_t index = 0; index < field.length(); ++index) {
+      if((field[index] < '0') || (field[index] > '9') || (value > 0xFFFFFF)) {
+        throw Nuclex::Pixels::Errors::FileFormatError(
+          u8"Netpbm header contains an invalid image size"
+        );
+      }
+      value = (value * 10) + static_cast<std::size_t>(field[index] - '0');
+    }
+    if(value == 0) {
+      throw Nuclex::Pixels::Errors::FileFormatError(u8"Netpbm file contains an empty image");
+    }
+
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Netpbm {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TryReadNetpbmHeader(
+    const VirtualFile &source, const char *types, NetpbmHeader &header
+  ) {
+    std::uint8_t text[MaximumHeaderByteCount];
+    std::size_t length = static_cast<std::size_t>(
+      std::min<std::uint64_t>(MaximumHeaderByteCount, source.GetSize())
+    );
+    if(length < 3) {
+      return false; // Too short for the magic number and a whitespace
+    }
+    source.ReadAt(0, length, text);
+    if(!HasNetpbmMagic(text, length, types)) {
+      return false;
+    }
+
+    std::size_t position = 2;
+    header.Type = static_cast<char>(text[1]);
+    header.Width = parseDimension(readField(text, length, position));
+    header.Height = parseDimension(readField(text, length, position));
+    header.Range = readField(text, length, position);
+
+    // Exactly one whitespace character separates the header from the pixels
+    header.DataOffset = position + 1;
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool HasNetpbmMagic(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount, const char *types
+  ) {
+    if(fileHeaderByteCount < 3) {
+      return false; // Too short for the magic number and a whitespace
+    }
+    if((fileHeader[0] != 'P') || !isWhitespace(fileHeader[2])) {
+      return false;
+    }
+
+    bool isKnownType = false;
+    for(const char *type = types; *type != '\0'; ++type) {
+      if(fileHeader[1] == static_cast<std::uint8_t>(*type)) {
+        isKnownType = true;
+        break;
+      }
+    }
+    if(!isKnownType) {
+      return false;
+    }
+
+    // The width follows the magic number, possibly after more whitespace or a comment
+    for(std::size_t index = 3; index < fileHeaderByteCount; ++index) {
+      if(!isWhitespace(fileHeader[index])) {
+        return (
+          ((fileHeader[index] >= '0') && (fileHeader[index] <= '9')) ||
+          (fileHeader[index] == '#')
+        );
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Netpbm
@@ -0,0 +1,88 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_NETPBM_NETPBMHEADER_H
+#define NUCLEX_PIXELS_STORAGE_NETPBM_NETPBMHEADER_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <string> // for std::string
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Netpbm {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Header of a Netpbm (PGM, PPM or PFM) file</summary>
+  /// <remarks>
+  ///   All Netpbm formats begin with a two character magic number followed by
+  ///   three whitespace-separated fields in text form: the width, the height and
+  ///   the maximum channel value (or, for PFM, the scale and byte order).
+  /// </remarks>
+  struct NetpbmHeader {
+
+    /// <summary>Second character of the magic number, for example '6' for "P6"</summary>
+    public: char Type;
+    /// <summary>Width of the image in pixels</summary>
+    public: std::size_t Width;
+    /// <summary>Height of the image in pixels</summary>
+    public: std::size_t Height;
+    /// <summary>Third field of the header, the maximum value or the PFM scale</summary>
+    public: std::string Range;
+    /// <summary>Offset of the first pixel from the start of the file</summary>
+    public: std::uint64_t DataOffset;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tries to read the header of a Netpbm file</summary>
+  /// <param name="source">File whose header will be read</param>
+  /// <param name="types">Characters that can follow the 'P' of the magic number</param>
+  /// <param name="header">Receives the fields of the header</param>
+  /// <returns>
+  ///   True if the file begins with one of the magic numbers, false otherwise. If it does
+  ///   but the header is malformed, a <see cref="FileFormatError" /> is thrown.
+  /// </returns>
+  bool TryReadNetpbmHeader(const VirtualFile &source, const char *types, NetpbmHeader &header);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file begins with one of the specified magic numbers</summary>
+  /// <param name="fileHeader">The first bytes of the file that will be checked</param>
+  /// <param name="fileHeaderByteCount">Number of bytes in the file header</param>
+  /// <param name="types">Characters that can follow the 'P' of the magic number</param>
+  /// <returns>True if the file begins with one of the magic numbers</returns>
+  /// <remarks>
+  ///   To turn away text files that happen to begin with a 'P' and a matching letter,
+  ///   the first header field (or comment) after the magic number has to begin with
+  ///   a digit (or '#') if it lies within the provided bytes.
+  /// </remarks>
+  bool HasNetpbmMagic(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount, const char *types
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Netpbm
+
+#endif // NUCLEX_PIXELS_STORAGE_NETPBM_NETPBMHEADER_H
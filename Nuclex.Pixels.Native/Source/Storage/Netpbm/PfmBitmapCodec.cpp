@@ -0,0 +1,228 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "PfmBitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/PixelFormatTraits.h"
+
+#include "NetpbmHeader.h"
+
+#include <cstdlib> // for std::strtod()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+#include <string> // for std::string, std::to_string()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Types of color (PF) and grayscale (Pf) float maps</summary>
+  const char *const PfmTypes = u8"Ff";
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 32 bit float from a PFM row, swapping its bytes if needed</summary>
+  /// <param name="bytes">Address of the float's first byte</param>
+  /// <param name="swapBytes">Whether the float is stored in the opposite byte order</param>
+  /// <returns>The float in native byte order</returns>
+  float readFloat(const std::uint8_t *bytes, bool swapBytes) {
+    std::uint8_t nativeBytes[4];
+    if(swapBytes) {
+      nativeBytes[0] = bytes[3];
+      nativeBytes[1] = bytes[2];
+      nativeBytes[2] = bytes[1];
+      nativeBytes[3] = bytes[0];
+    } else {
+      std::memcpy(nativeBytes, bytes, 4);
+    }
+
+    float value;
+    std::memcpy(&value, nativeBytes, 4);
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Netpbm {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PfmBitmapCodec::PfmBitmapCodec() :
+    name(u8"Portable Float Map (.pfm)") {
+    this->knownFileExtensions.push_back(u8"pfm");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PfmBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    return HasNetpbmMagic(fileHeader, fileHeaderByteCount, PfmTypes);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PfmBitmapCodec::CanSave() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PfmBitmapCodec::TryReadLayout(const VirtualFile &source, RawImageLayout &layout) const {
+    NetpbmHeader header;
+    if(!TryReadNetpbmHeader(source, PfmTypes, header)) {
+      return false;
+    }
+
+    // The sign of the scale tells the byte order, negative means little endian
+    char *end = nullptr;
+    double scale = std::strtod(header.Range.c_str(), &end);
+    if((end == header.Range.c_str()) || (*end != '\0') || (scale == 0.0)) {
+      throw Errors::FileFormatError(u8"PFM header contains an invalid scale");
+    }
+#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+    layout.HasFlippedWords = (scale > 0.0);
+#else
+    layout.HasFlippedWords = (scale < 0.0);
+#endif
+
+    // Grayscale float maps in native byte order can be read straight into the bitmap,
+    // color float maps lack an alpha channel and need to be expanded to RGBA
+    bool isColor = (header.Type == 'F');
+    layout.Width = header.Width;
+    layout.Height = header.Height;
+    layout.Offset = header.DataOffset;
+    layout.StoredBytesPerPixel = isColor ? 12 : 4;
+    layout.RowPitch = layout.StoredBytesPerPixel * layout.Width;
+    layout.IsBottomUp = true;
+    if(isColor) {
+      layout.PixelFormat = PixelFormat::R32_G32_B32_A32_Float_Native32;
+      layout.NeedsTransform = true;
+    } else {
+      layout.PixelFormat = PixelFormat::R32_Float_Native32;
+      layout.NeedsTransform = layout.HasFlippedWords;
+    }
+
+    std::uint64_t imageByteCount = static_cast<std::uint64_t>(layout.RowPitch) * layout.Height;
+    if(layout.Offset + imageByteCount > source.GetSize()) {
+      throw Errors::FileFormatError(u8"PFM file is truncated");
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PfmBitmapCodec::TransformRow(
+    const RawImageLayout &layout, const std::uint8_t *storedPixels, void *pixels,
+    std::size_t pixelCount
+  ) const {
+    float *target = static_cast<float *>(pixels);
+
+    if(layout.StoredBytesPerPixel == 4) { // Grayscale
+      for(std::size_t index = 0; index < pixelCount; ++index) {
+        target[index] = readFloat(storedPixels + (index * 4), layout.HasFlippedWords);
+      }
+    } else { // Color
+      for(std::size_t index = 0; index < pixelCount; ++index) {
+        const std::uint8_t *storedPixel = storedPixels + (index * 12);
+        target[index * 4 + 0] = readFloat(storedPixel, layout.HasFlippedWords);
+        target[index * 4 + 1] = readFloat(storedPixel + 4, layout.HasFlippedWords);
+        target[index * 4 + 2] = readFloat(storedPixel + 8, layout.HasFlippedWords);
+        target[index * 4 + 3] = 1.0f;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PfmBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    (void)options; // Unused
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"PFM files can not store empty bitmaps");
+    }
+
+    // Single-channel bitmaps become grayscale float maps, everything else color ones.
+    // Files are written in native byte order, so the sign of the scale gives it away.
+    bool isGray = (Private::DescribePixelFormat(memory.PixelFormat).ChannelCount == 1);
+    std::string header = (
+      std::string(isGray ? u8"Pf\n" : u8"PF\n") +
+      std::to_string(memory.Width) + u8" " + std::to_string(memory.Height) +
+#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+      u8"\n-1.0\n"
+#else
+      u8"\n1.0\n"
+#endif
+    );
+    target.WriteAt(0, header.length(), reinterpret_cast<const std::uint8_t *>(header.c_str()));
+
+    if(isGray) {
+      PixelFormat storedPixelFormat = PixelFormat::R32_Float_Native32;
+      WriteRows(
+        memory, target, header.length(),
+        storedPixelFormat, CountRequiredBytes(storedPixelFormat, memory.Width), true
+      );
+      return;
+    }
+
+    // Color float maps have no alpha channel, so convert each row to float RGBA
+    // and drop the alpha channel. Rows are stored from the bottom up.
+    std::vector<float> convertedRow(memory.Width * 4);
+    std::vector<float> storedRow(memory.Width * 3);
+    std::uint64_t position = header.length();
+    for(std::size_t y = memory.Height; y > 0; --y) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(memory.Pixels) + (
+        static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y - 1)
+      );
+      PixelFormatConverter::ConvertRow(
+        memory.PixelFormat, row,
+        PixelFormat::R32_G32_B32_A32_Float_Native32, &convertedRow[0],
+        memory.Width
+      );
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        storedRow[x * 3 + 0] = convertedRow[x * 4 + 0];
+        storedRow[x * 3 + 1] = convertedRow[x * 4 + 1];
+        storedRow[x * 3 + 2] = convertedRow[x * 4 + 2];
+      }
+
+      std::size_t storedRowByteCount = storedRow.size() * sizeof(float);
+      target.WriteAt(
+        position, storedRowByteCount, reinterpret_cast<const std::uint8_t *>(&storedRow[0])
+      );
+      position += storedRowByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Netpbm
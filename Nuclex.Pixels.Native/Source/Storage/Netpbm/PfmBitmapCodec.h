@@ -0,0 +1,104 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_NETPBM_PFMBITMAPCODEC_H
+#define NUCLEX_PIXELS_STORAGE_NETPBM_PFMBITMAPCODEC_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include "../RawBitmapCodec.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Netpbm {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads and saves floating point images in the Portable Float Map format</summary>
+  /// <remarks>
+  ///   Grayscale images are loaded as 32 bit float bitmaps directly. Color images have
+  ///   no alpha channel in the file and are loaded as 32 bit float RGBA bitmaps.
+  ///   Bitmaps in other pixel formats are converted to floating point when they are saved.
+  /// </remarks>
+  class PfmBitmapCodec : public RawBitmapCodec {
+
+    /// <summary>Initializes a new PFM bitmap codec</summary>
+    public: PfmBitmapCodec();
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~PfmBitmapCodec() = default;
+
+    /// <summary>Gives the name of the file format implemented by this codec</summary>
+    /// <returns>The name of the file format this codec implements</returns>
+    public: const std::string &GetName() const override { return this->name; }
+
+    /// <summary>Provides commonly used file extensions for this codec</summary>
+    /// <returns>The commonly used file extensions in order of preference</returns>
+    public: const std::vector<std::string> &GetFileExtensions() const override {
+      return this->knownFileExtensions;
+    }
+
+    /// <summary>Checks whether a file header looks like it's in the codec's file format</summary>
+    /// <param name="fileHeader">The first bytes of the file that will be checked</param>
+    /// <param name="fileHeaderByteCount">Number of bytes in the file header</param>
+    /// <returns>False if the codec is certain not to be able to load the file</returns>
+    public: bool IsValidFileHeader(
+      const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+    ) const override;
+
+    /// <summary>Checks if the codec is able to save bitmaps to storage</summary>
+    /// <returns>True if the codec supports saving bitmaps</returns>
+    public: bool CanSave() const override;
+
+    /// <summary>Saves the specified bitmap into a file</summary>
+    /// <param name="bitmap">Bitmap that will be saved into a file</param>
+    /// <param name="target">File into which the bitmap will be saved</param>
+    /// <param name="options">Settings controlling how the file will be written</param>
+    public: void Save(
+      const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options = SaveOptions()
+    ) const override;
+
+    /// <summary>Tries to locate the rows of the image in a file</summary>
+    /// <param name="source">File in which the rows will be located</param>
+    /// <param name="layout">Receives the dimensions and location of the rows</param>
+    /// <returns>True if the file was a PFM file, false otherwise</returns>
+    protected: bool TryReadLayout(
+      const VirtualFile &source, RawImageLayout &layout
+    ) const override;
+
+    /// <summary>Turns pixels as stored in the file into the layout's pixel format</summary>
+    /// <param name="layout">Layout of the image the pixels belong to</param>
+    /// <param name="storedPixels">Pixels as they are stored in the file</param>
+    /// <param name="pixels">Receives the pixels in the layout's pixel format</param>
+    /// <param name="pixelCount">Number of pixels that will be transformed</param>
+    protected: void TransformRow(
+      const RawImageLayout &layout, const std::uint8_t *storedPixels, void *pixels,
+      std::size_t pixelCount
+    ) const override;
+
+    /// <summary>Human-readable name of the file format this codec implements</summary>
+    private: std::string name;
+    /// <summary>File extensions this file format is known to use</summary>
+    private: std::vector<std::string> knownFileExtensions;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Netpbm
+
+#endif // NUCLEX_PIXELS_STORAGE_NETPBM_PFMBITMAPCODEC_H
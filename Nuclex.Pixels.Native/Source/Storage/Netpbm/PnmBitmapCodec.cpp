@@ -0,0 +1,132 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "PnmBitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include "NetpbmHeader.h"
+
+#include <stdexcept> // for std::invalid_argument
+#include <string> // for std::string, std::to_string()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Types of binary grayscale (P5) and color (P6) images</summary>
+  const char *const BinaryPnmTypes = u8"56";
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Netpbm {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PnmBitmapCodec::PnmBitmapCodec() :
+    name(u8"Netpbm graymap and pixmap (.pgm, .ppm) binary") {
+    this->knownFileExtensions.push_back(u8"ppm");
+    this->knownFileExtensions.push_back(u8"pgm");
+    this->knownFileExtensions.push_back(u8"pnm");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PnmBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    return HasNetpbmMagic(fileHeader, fileHeaderByteCount, BinaryPnmTypes);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PnmBitmapCodec::CanSave() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PnmBitmapCodec::TryReadLayout(const VirtualFile &source, RawImageLayout &layout) const {
+    NetpbmHeader header;
+    if(!TryReadNetpbmHeader(source, BinaryPnmTypes, header)) {
+      return false;
+    }
+    if(header.Range != u8"255") {
+      throw Errors::FileFormatError(u8"Only 8 bit PGM and PPM files are supported");
+    }
+
+    bool isColor = (header.Type == '6');
+    layout.Width = header.Width;
+    layout.Height = header.Height;
+    layout.PixelFormat = isColor ? PixelFormat::R8_G8_B8_Unsigned : PixelFormat::R8_Unsigned;
+    layout.Offset = header.DataOffset;
+    layout.StoredBytesPerPixel = isColor ? 3 : 1;
+    layout.RowPitch = layout.StoredBytesPerPixel * layout.Width;
+    layout.IsBottomUp = false;
+    layout.NeedsTransform = false;
+    layout.HasFlippedWords = false;
+
+    std::uint64_t imageByteCount = static_cast<std::uint64_t>(layout.RowPitch) * layout.Height;
+    if(layout.Offset + imageByteCount > source.GetSize()) {
+      throw Errors::FileFormatError(u8"Netpbm file is truncated");
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PnmBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    (void)options; // Unused
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"Netpbm files can not store empty bitmaps");
+    }
+
+    // Grayscale bitmaps become PGM files, everything else is converted to 8 bit RGB
+    bool isGray = (memory.PixelFormat == PixelFormat::R8_Unsigned);
+    PixelFormat storedPixelFormat = (
+      isGray ? PixelFormat::R8_Unsigned : PixelFormat::R8_G8_B8_Unsigned
+    );
+
+    std::string header = (
+      std::string(isGray ? u8"P5\n" : u8"P6\n") +
+      std::to_string(memory.Width) + u8" " + std::to_string(memory.Height) + u8"\n255\n"
+    );
+    target.WriteAt(0, header.length(), reinterpret_cast<const std::uint8_t *>(header.c_str()));
+
+    WriteRows(
+      memory, target, header.length(),
+      storedPixelFormat, CountRequiredBytes(storedPixelFormat, memory.Width), false
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Netpbm
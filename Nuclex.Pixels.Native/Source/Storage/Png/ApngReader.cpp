@@ -0,0 +1,557 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "ApngReader.h"
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include <png.h>
+#include <zlib.h> // for ::crc32()
+
+#include <cstring> // for std::memcpy(), std::memcmp(), std::memset()
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>The eight bytes every PNG file begins with</summary>
+  const std::uint8_t PngSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+
+  /// <summary>Leaves the frame's region of the canvas as it is</summary>
+  const std::uint8_t DisposeNone = 0;
+  /// <summary>Clears the frame's region of the canvas to transparent black</summary>
+  const std::uint8_t DisposeBackground = 1;
+  /// <summary>Restores the frame's region of the canvas to what it was before</summary>
+  const std::uint8_t DisposePrevious = 2;
+
+  /// <summary>Replaces the canvas pixels with the frame's pixels</summary>
+  const std::uint8_t BlendSource = 0;
+  /// <summary>Alpha-blends the frame's pixels over the canvas pixels</summary>
+  const std::uint8_t BlendOver = 1;
+
+  /// <summary>Number of bytes in each pixel of the canvas</summary>
+  const std::size_t BytesPerPixel = 4;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 32 bit integer stored in the big endian byte order PNG uses</summary>
+  /// <param name="source">Address the integer will be read from</param>
+  /// <returns>The integer read from the specified address</returns>
+  std::uint32_t readBigEndian32(const std::uint8_t *source) {
+    return (
+      (static_cast<std::uint32_t>(source[0]) << 24) |
+      (static_cast<std::uint32_t>(source[1]) << 16) |
+      (static_cast<std::uint32_t>(source[2]) << 8) |
+      static_cast<std::uint32_t>(source[3])
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 16 bit integer stored in the big endian byte order PNG uses</summary>
+  /// <param name="source">Address the integer will be read from</param>
+  /// <returns>The integer read from the specified address</returns>
+  std::uint16_t readBigEndian16(const std::uint8_t *source) {
+    return static_cast<std::uint16_t>((source[0] << 8) | source[1]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a 32 bit integer in the big endian byte order PNG uses</summary>
+  /// <param name="target">Address at which the integer will be stored</param>
+  /// <param name="value">Integer that will be stored</param>
+  void storeBigEndian32(std::uint8_t *target, std::uint32_t value) {
+    target[0] = static_cast<std::uint8_t>(value >> 24);
+    target[1] = static_cast<std::uint8_t>(value >> 16);
+    target[2] = static_cast<std::uint8_t>(value >> 8);
+    target[3] = static_cast<std::uint8_t>(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends the header of a chunk to a PNG stream</summary>
+  /// <param name="stream">PNG stream the chunk header will be appended to</param>
+  /// <param name="type">Four character type of the chunk</param>
+  /// <param name="byteCount">Number of bytes of data the chunk will hold</param>
+  /// <returns>The offset in the stream at which the chunk's data begins</returns>
+  std::size_t beginChunk(
+    std::vector<std::uint8_t> &stream, const char type[4], std::size_t byteCount
+  ) {
+    std::size_t start = stream.size();
+    stream.resize(start + 8 + byteCount);
+    storeBigEndian32(&stream[start], static_cast<std::uint32_t>(byteCount));
+    std::memcpy(&stream[start + 4], type, 4);
+    return start + 8;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends the CRC of the last chunk to a PNG stream</summary>
+  /// <param name="stream">PNG stream the chunk was appended to</param>
+  /// <param name="dataStart">Offset returned by beginChunk() for the chunk</param>
+  void endChunk(std::vector<std::uint8_t> &stream, std::size_t dataStart) {
+    std::size_t end = stream.size();
+    ::uLong crc = ::crc32(
+      0, &stream[dataStart - 4], static_cast<::uInt>(end - dataStart + 4)
+    );
+    stream.resize(end + 4);
+    storeBigEndian32(&stream[end], static_cast<std::uint32_t>(crc));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frees the memory libpng's simplified API allocated for an image</summary>
+  class PngImageScope {
+
+    /// <summary>Initializes a new PNG image scope</summary>
+    /// <param name="image">Image whose memory will be freed</param>
+    public: PngImageScope(::png_image &image) :
+      image(image) {}
+
+    /// <summary>Frees the image's memory</summary>
+    public: ~PngImageScope() {
+      ::png_image_free(&this->image);
+    }
+
+    /// <summary>Image whose memory will be freed</summary>
+    private: ::png_image &image;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Alpha-blends a row of pixels over another</summary>
+  /// <param name="target">Row of canvas pixels the source row will be blended onto</param>
+  /// <param name="source">Row of frame pixels that will be blended</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  /// <remarks>
+  ///   Both rows hold non-premultiplied 8 bit RGBA pixels. This is the blend operation
+  ///   given in the APNG specification.
+  /// </remarks>
+  void blendRowOver(std::uint8_t *target, const std::uint8_t *source, std::size_t pixelCount) {
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      int sourceAlpha = source[3];
+      if(sourceAlpha == 255) {
+        std::memcpy(target, source, BytesPerPixel);
+      } else if(sourceAlpha != 0) {
+        int sourceWeight = sourceAlpha * 255;
+        int targetWeight = (255 - sourceAlpha) * target[3];
+        int totalWeight = sourceWeight + targetWeight;
+        for(std::size_t channel = 0; channel < 3; ++channel) {
+          target[channel] = static_cast<std::uint8_t>(
+            (source[channel] * sourceWeight + target[channel] * targetWeight) / totalWeight
+          );
+        }
+        target[3] = static_cast<std::uint8_t>(totalWeight / 255);
+      }
+
+      target += BytesPerPixel;
+      source += BytesPerPixel;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ApngReader::ApngReader(const VirtualFile &file) :
+    file(file),
+    width(0),
+    height(0),
+    loopCount(0),
+    currentFrameIndex(0),
+    currentCanvasPixels(nullptr) {
+    indexChunks();
+    markKeyFrames();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ApngReader::ReloadFrame(Bitmap &exactlyFittingBitmap, std::size_t frameIndex) {
+    if(frameIndex >= this->frames.size()) {
+      throw std::out_of_range(u8"Frame index lies outside of the animation");
+    }
+
+    const BitmapMemory &canvas = exactlyFittingBitmap.AccessMutable();
+    bool bitmapFits = (
+      (canvas.Width == this->width) &&
+      (canvas.Height == this->height) &&
+      (canvas.PixelFormat == PixelFormat::R8_G8_B8_A8_Unsigned)
+    );
+    if(!bitmapFits) {
+      throw std::invalid_argument(
+        u8"Bitmap must match the size and pixel format of the animation's canvas"
+      );
+    }
+
+    // If the bitmap holds a frame between the key frame and the requested frame,
+    // the frames after it can be drawn on top. Otherwise start from the key frame.
+    std::size_t keyFrameIndex = FindKeyFrame(frameIndex);
+    bool canContinue = (
+      (this->currentCanvasPixels == canvas.Pixels) &&
+      (this->currentFrameIndex >= keyFrameIndex) &&
+      (this->currentFrameIndex <= frameIndex)
+    );
+
+    // Forget the canvas while drawing, if decoding fails it is left in an unknown state
+    std::size_t drawnFrameIndex = this->currentFrameIndex;
+    this->currentCanvasPixels = nullptr;
+
+    if(!canContinue) {
+      std::size_t rowByteCount = this->width * BytesPerPixel;
+      for(std::size_t y = 0; y < this->height; ++y) {
+        std::memset(
+          static_cast<std::uint8_t *>(canvas.Pixels) + canvas.Stride * y, 0, rowByteCount
+        );
+      }
+
+      drawFrame(canvas, this->frames[keyFrameIndex]);
+      drawnFrameIndex = keyFrameIndex;
+    }
+
+    while(drawnFrameIndex < frameIndex) {
+      disposeFrame(canvas, this->frames[drawnFrameIndex]);
+      ++drawnFrameIndex;
+      drawFrame(canvas, this->frames[drawnFrameIndex]);
+    }
+
+    this->currentFrameIndex = frameIndex;
+    this->currentCanvasPixels = canvas.Pixels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ApngReader::indexChunks() {
+    std::uint64_t fileSize = this->file.GetSize();
+
+    std::uint8_t buffer[26];
+    if(fileSize < 8 + 8 + 13 + 4) {
+      throw Errors::FileFormatError(u8"File is too small to be a PNG file");
+    }
+    this->file.ReadAt(0, 8, buffer);
+    if(std::memcmp(buffer, PngSignature, 8) != 0) {
+      throw Errors::FileFormatError(u8"File is not a PNG file");
+    }
+
+    bool isAnimated = false;
+    bool hasSeenImageData = false;
+    std::size_t declaredFrameCount = 0;
+
+    std::uint64_t position = 8;
+    for(;;) {
+      if(position + 12 > fileSize) {
+        throw Errors::FileFormatError(u8"PNG file ends before its IEND chunk");
+      }
+      this->file.ReadAt(position, 8, buffer);
+      std::uint32_t byteCount = readBigEndian32(buffer);
+      std::string type(reinterpret_cast<const char *>(buffer + 4), 4);
+      std::uint64_t dataPosition = position + 8;
+      if(dataPosition + byteCount + 4 > fileSize) {
+        throw Errors::FileFormatError(u8"PNG file ends in the middle of a chunk");
+      }
+
+      if(position == 8) {
+        if((type != u8"IHDR") || (byteCount != 13)) {
+          throw Errors::FileFormatError(u8"PNG file does not begin with an IHDR chunk");
+        }
+        this->file.ReadAt(dataPosition, 13, this->header);
+        this->width = readBigEndian32(this->header);
+        this->height = readBigEndian32(this->header + 4);
+        if((this->width == 0) || (this->height == 0)) {
+          throw Errors::FileFormatError(u8"PNG file has an empty image");
+        }
+      } else if(type == u8"acTL") {
+        if(byteCount != 8) {
+          throw Errors::FileFormatError(u8"APNG animation control chunk has the wrong size");
+        }
+        this->file.ReadAt(dataPosition, 8, buffer);
+        declaredFrameCount = readBigEndian32(buffer);
+        this->loopCount = readBigEndian32(buffer + 4);
+        isAnimated = true;
+      } else if(type == u8"fcTL") {
+        if(byteCount != 26) {
+          throw Errors::FileFormatError(u8"APNG frame control chunk has the wrong size");
+        }
+        this->file.ReadAt(dataPosition, 26, buffer);
+
+        std::size_t frameWidth = readBigEndian32(buffer + 4);
+        std::size_t frameHeight = readBigEndian32(buffer + 8);
+        std::size_t frameX = readBigEndian32(buffer + 12);
+        std::size_t frameY = readBigEndian32(buffer + 16);
+        bool fitsCanvas = (
+          (frameWidth > 0) && (frameHeight > 0) &&
+          (frameX + frameWidth <= this->width) && (frameY + frameHeight <= this->height)
+        );
+        if(!fitsCanvas) {
+          throw Errors::FileFormatError(u8"APNG frame lies outside of the canvas");
+        }
+
+        std::uint16_t delayNumerator = readBigEndian16(buffer + 20);
+        std::uint16_t delayDenominator = readBigEndian16(buffer + 22);
+        if(delayDenominator == 0) {
+          delayDenominator = 100; // As defined by the APNG specification
+        }
+
+        Frame frame = {
+          {
+            Rectangle::FromPositionAndSize(frameX, frameY, frameWidth, frameHeight),
+            static_cast<double>(delayNumerator) / static_cast<double>(delayDenominator),
+            false
+          },
+          buffer[24],
+          buffer[25],
+          std::vector<DataChunk>()
+        };
+        if((frame.DisposeOperation > DisposePrevious) || (frame.BlendOperation > BlendOver)) {
+          throw Errors::FileFormatError(u8"APNG frame uses an unknown dispose or blend operation");
+        }
+        this->frames.push_back(std::move(frame));
+      } else if(type == u8"IDAT") {
+        hasSeenImageData = true;
+
+        // Without animation control, the image data is the only frame. With animation
+        // control, it is the first frame only if a frame control chunk preceded it.
+        if(!isAnimated && this->frames.empty()) {
+          Frame frame = {
+            { Rectangle(0, 0, this->width, this->height), 0.0, true },
+            DisposeNone, BlendSource, std::vector<DataChunk>()
+          };
+          this->frames.push_back(std::move(frame));
+        }
+        if(!this->frames.empty()) {
+          DataChunk chunk = { dataPosition, byteCount };
+          this->frames.back().DataChunks.push_back(chunk);
+        }
+      } else if(type == u8"fdAT") {
+        if(this->frames.empty() || (byteCount < 4)) {
+          throw Errors::FileFormatError(u8"APNG frame data chunk without frame control chunk");
+        }
+        DataChunk chunk = { dataPosition + 4, byteCount - 4 };
+        this->frames.back().DataChunks.push_back(chunk);
+      } else if(type == u8"IEND") {
+        break;
+      } else if(!hasSeenImageData) {
+        bool affectsDecoding = (
+          (type == u8"PLTE") || (type == u8"tRNS") || (type == u8"gAMA") ||
+          (type == u8"cHRM") || (type == u8"sRGB") || (type == u8"iCCP") ||
+          (type == u8"sBIT")
+        );
+        if(affectsDecoding) {
+          std::size_t start = this->sharedChunks.size();
+          this->sharedChunks.resize(start + 12 + byteCount);
+          this->file.ReadAt(position, 12 + byteCount, &this->sharedChunks[start]);
+        }
+      }
+
+      position = dataPosition + byteCount + 4;
+    }
+
+    if(this->frames.empty()) {
+      throw Errors::FileFormatError(u8"PNG file contains no image data");
+    }
+    if(isAnimated && (this->frames.size() != declaredFrameCount)) {
+      throw Errors::FileFormatError(
+        u8"APNG file contains a different number of frames than it declares"
+      );
+    }
+    for(std::size_t index = 0; index < this->frames.size(); ++index) {
+      if(this->frames[index].DataChunks.empty()) {
+        throw Errors::FileFormatError(u8"APNG frame has no image data");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ApngReader::markKeyFrames() {
+    std::size_t frameCount = this->frames.size();
+
+    // The specification says to treat restoring the previous state on the first frame
+    // like clearing it because there is no previous state
+    if(this->frames[0].DisposeOperation == DisposePrevious) {
+      this->frames[0].DisposeOperation = DisposeBackground;
+    }
+
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      Frame &frame = this->frames[index];
+      const Rectangle &region = frame.Info.Region;
+      bool coversCanvas = (
+        (region.MinX == 0) && (region.MinY == 0) &&
+        (region.MaxX == this->width) && (region.MaxY == this->height)
+      );
+
+      // A frame is a key frame if the canvas it is drawn onto is known without decoding
+      // the frames before it. That is the case if the previous frame cleared the whole
+      // canvas or if the frame replaces the whole canvas. In the latter case, the frame
+      // must not restore the canvas afterwards, that would need the earlier frames again.
+      if(index == 0) {
+        frame.Info.IsKeyFrame = true;
+      } else {
+        const Frame &previousFrame = this->frames[index - 1];
+        const Rectangle &previousRegion = previousFrame.Info.Region;
+        bool previousClearedCanvas = (
+          (previousFrame.DisposeOperation == DisposeBackground) &&
+          (previousRegion.MinX == 0) && (previousRegion.MinY == 0) &&
+          (previousRegion.MaxX == this->width) && (previousRegion.MaxY == this->height)
+        );
+        bool replacesCanvas = (
+          coversCanvas &&
+          (frame.BlendOperation == BlendSource) &&
+          (frame.DisposeOperation != DisposePrevious)
+        );
+        frame.Info.IsKeyFrame = (previousClearedCanvas || replacesCanvas);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ApngReader::decodeFrame(const Frame &frame) {
+    const Rectangle &region = frame.Info.Region;
+    std::size_t frameWidth = region.MaxX - region.MinX;
+    std::size_t frameHeight = region.MaxY - region.MinY;
+
+    // Build a PNG stream holding only this frame. The buffer keeps its capacity,
+    // so after the largest frame has been decoded, no more allocations happen.
+    std::vector<std::uint8_t> &stream = this->frameStream;
+    stream.assign(PngSignature, PngSignature + sizeof(PngSignature));
+    {
+      std::size_t dataStart = beginChunk(stream, "IHDR", 13);
+      std::memcpy(&stream[dataStart], this->header, 13);
+      storeBigEndian32(&stream[dataStart], static_cast<std::uint32_t>(frameWidth));
+      storeBigEndian32(&stream[dataStart + 4], static_cast<std::uint32_t>(frameHeight));
+      endChunk(stream, dataStart);
+    }
+    stream.insert(stream.end(), this->sharedChunks.begin(), this->sharedChunks.end());
+    for(std::size_t index = 0; index < frame.DataChunks.size(); ++index) {
+      const DataChunk &chunk = frame.DataChunks[index];
+      std::size_t dataStart = beginChunk(stream, "IDAT", chunk.ByteCount);
+      if(chunk.ByteCount > 0) {
+        this->file.ReadAt(chunk.Offset, chunk.ByteCount, &stream[dataStart]);
+      }
+      endChunk(stream, dataStart);
+    }
+    endChunk(stream, beginChunk(stream, "IEND", 0));
+
+    // libpng's simplified API converts any PNG pixel format to 8 bit RGBA for us
+    ::png_image image;
+    std::memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    {
+      PngImageScope imageScope(image);
+
+      if(::png_image_begin_read_from_memory(&image, stream.data(), stream.size()) == 0) {
+        throw Errors::FileFormatError(image.message);
+      }
+
+      image.format = PNG_FORMAT_RGBA;
+      this->framePixels.resize(frameWidth * frameHeight * BytesPerPixel);
+      int result = ::png_image_finish_read(
+        &image, nullptr, this->framePixels.data(), 0, nullptr
+      );
+      if(result == 0) {
+        throw Errors::FileFormatError(image.message);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ApngReader::drawFrame(const BitmapMemory &canvas, const Frame &frame) {
+    const Rectangle &region = frame.Info.Region;
+    std::size_t frameWidth = region.MaxX - region.MinX;
+    std::size_t frameHeight = region.MaxY - region.MinY;
+    std::size_t rowByteCount = frameWidth * BytesPerPixel;
+
+    std::uint8_t *canvasRow = (
+      static_cast<std::uint8_t *>(canvas.Pixels) +
+      canvas.Stride * region.MinY + region.MinX * BytesPerPixel
+    );
+
+    // If the frame's region has to be restored afterwards, back it up before drawing
+    if(frame.DisposeOperation == DisposePrevious) {
+      this->previousPixels.resize(rowByteCount * frameHeight);
+      std::uint8_t *backupRow = this->previousPixels.data();
+      for(std::size_t y = 0; y < frameHeight; ++y) {
+        std::memcpy(backupRow, canvasRow + canvas.Stride * y, rowByteCount);
+        backupRow += rowByteCount;
+      }
+    }
+
+    decodeFrame(frame);
+
+    const std::uint8_t *frameRow = this->framePixels.data();
+    for(std::size_t y = 0; y < frameHeight; ++y) {
+      if(frame.BlendOperation == BlendSource) {
+        std::memcpy(canvasRow, frameRow, rowByteCount);
+      } else {
+        blendRowOver(canvasRow, frameRow, frameWidth);
+      }
+      canvasRow += canvas.Stride;
+      frameRow += rowByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ApngReader::disposeFrame(const BitmapMemory &canvas, const Frame &frame) {
+    if(frame.DisposeOperation == DisposeNone) {
+      return;
+    }
+
+    const Rectangle &region = frame.Info.Region;
+    std::size_t frameHeight = region.MaxY - region.MinY;
+    std::size_t rowByteCount = (region.MaxX - region.MinX) * BytesPerPixel;
+
+    std::uint8_t *canvasRow = (
+      static_cast<std::uint8_t *>(canvas.Pixels) +
+      canvas.Stride * region.MinY + region.MinX * BytesPerPixel
+    );
+    if(frame.DisposeOperation == DisposeBackground) {
+      for(std::size_t y = 0; y < frameHeight; ++y) {
+        std::memset(canvasRow, 0, rowByteCount);
+        canvasRow += canvas.Stride;
+      }
+    } else { // DisposePrevious
+      const std::uint8_t *backupRow = this->previousPixels.data();
+      for(std::size_t y = 0; y < frameHeight; ++y) {
+        std::memcpy(canvasRow, backupRow, rowByteCount);
+        canvasRow += canvas.Stride;
+        backupRow += rowByteCount;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Png
+
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
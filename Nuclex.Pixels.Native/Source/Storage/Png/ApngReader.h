@@ -0,0 +1,183 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_PNG_APNGREADER_H
+#define NUCLEX_PIXELS_STORAGE_PNG_APNGREADER_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+#include "Nuclex/Pixels/Storage/AnimationReader.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes the frames of animated PNG (APNG) files</summary>
+  /// <remarks>
+  ///   <para>
+  ///     libpng ignores the animation chunks of APNG files and only decodes the default
+  ///     image. This reader indexes the chunks of the file when it is opened and, for
+  ///     each frame, hands libpng a small PNG stream built from the file's header and
+  ///     the frame's data chunks. The decoded frame is then composited onto the canvas
+  ///     as the frame's disposal and blend operations dictate.
+  ///   </para>
+  ///   <para>
+  ///     Frames are always delivered as <see cref="PixelFormat.R8_G8_B8_A8_Unsigned" />.
+  ///     Plain PNG files are read as an animation with a single frame.
+  ///   </para>
+  /// </remarks>
+  class ApngReader : public AnimationReader {
+
+    /// <summary>Initializes a new APNG reader and indexes the frames of the file</summary>
+    /// <param name="file">PNG file the frames will be decoded from</param>
+    public: ApngReader(const VirtualFile &file);
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~ApngReader() override = default;
+
+    /// <summary>Retrieves the width of the animation's canvas</summary>
+    /// <returns>The width of the bitmaps the frames are decoded into</returns>
+    public: std::size_t GetWidth() const override { return this->width; }
+
+    /// <summary>Retrieves the height of the animation's canvas</summary>
+    /// <returns>The height of the bitmaps the frames are decoded into</returns>
+    public: std::size_t GetHeight() const override { return this->height; }
+
+    /// <summary>Retrieves the pixel format the frames are decoded in</summary>
+    /// <returns>The pixel format of the bitmaps the frames are decoded into</returns>
+    public: PixelFormat GetPixelFormat() const override {
+      return PixelFormat::R8_G8_B8_A8_Unsigned;
+    }
+
+    /// <summary>Counts the number of frames in the animation</summary>
+    /// <returns>The number of frames the animation consists of</returns>
+    public: std::size_t CountFrames() const override { return this->frames.size(); }
+
+    /// <summary>Retrieves how often the animation should be played</summary>
+    /// <returns>The number of times the animation is played or 0 to loop forever</returns>
+    public: std::size_t GetLoopCount() const override { return this->loopCount; }
+
+    /// <summary>Retrieves informations about a frame of the animation</summary>
+    /// <param name="frameIndex">Index of the frame whose informations will be returned</param>
+    /// <returns>The region, duration and key frame flag of the frame</returns>
+    public: const AnimationFrameInfo &GetFrameInfo(std::size_t frameIndex) const override {
+      return this->frames.at(frameIndex).Info;
+    }
+
+    /// <summary>Decodes a frame of the animation into an existing bitmap</summary>
+    /// <param name="exactlyFittingBitmap">
+    ///   Bitmap matching the animation's canvas size and pixel format
+    /// </param>
+    /// <param name="frameIndex">Index of the frame that will be decoded</param>
+    public: void ReloadFrame(Bitmap &exactlyFittingBitmap, std::size_t frameIndex) override;
+
+    #pragma region struct DataChunk
+
+    /// <summary>Location of an IDAT or fdAT chunk holding compressed frame data</summary>
+    private: struct DataChunk {
+
+      /// <summary>Offset of the compressed data in the file</summary>
+      public: std::uint64_t Offset;
+      /// <summary>Number of bytes of compressed data in the chunk</summary>
+      public: std::uint32_t ByteCount;
+
+    };
+
+    #pragma endregion // struct DataChunk
+
+    #pragma region struct Frame
+
+    /// <summary>Everything the reader needs to know to decode a frame</summary>
+    private: struct Frame {
+
+      /// <summary>Informations about the frame reported to the caller</summary>
+      public: AnimationFrameInfo Info;
+      /// <summary>How the frame's region is cleaned up before the next frame</summary>
+      public: std::uint8_t DisposeOperation;
+      /// <summary>How the frame's pixels are combined with the canvas</summary>
+      public: std::uint8_t BlendOperation;
+      /// <summary>Chunks holding the frame's compressed pixels</summary>
+      public: std::vector<DataChunk> DataChunks;
+
+    };
+
+    #pragma endregion // struct Frame
+
+    /// <summary>Reads the chunks of the file and builds the list of frames</summary>
+    private: void indexChunks();
+
+    /// <summary>Determines which frames can be decoded without their predecessors</summary>
+    private: void markKeyFrames();
+
+    /// <summary>Decodes the pixels of a frame into the frame buffer</summary>
+    /// <param name="frame">Frame that will be decoded</param>
+    private: void decodeFrame(const Frame &frame);
+
+    /// <summary>Decodes a frame and draws it onto the canvas</summary>
+    /// <param name="canvas">Bitmap memory holding the canvas</param>
+    /// <param name="frame">Frame that will be drawn</param>
+    private: void drawFrame(const BitmapMemory &canvas, const Frame &frame);
+
+    /// <summary>Cleans up the region of a frame as its disposal operation says</summary>
+    /// <param name="canvas">Bitmap memory holding the canvas</param>
+    /// <param name="frame">Frame whose region will be disposed</param>
+    private: void disposeFrame(const BitmapMemory &canvas, const Frame &frame);
+
+    /// <summary>File the frames are decoded from</summary>
+    private: const VirtualFile &file;
+    /// <summary>Width of the animation's canvas in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the animation's canvas in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Number of times the animation should be played, 0 for forever</summary>
+    private: std::size_t loopCount;
+    /// <summary>Contents of the file's IHDR chunk</summary>
+    private: std::uint8_t header[13];
+    /// <summary>Complete chunks such as PLTE and tRNS that all frames need</summary>
+    private: std::vector<std::uint8_t> sharedChunks;
+    /// <summary>Frames of the animation</summary>
+    private: std::vector<Frame> frames;
+
+    /// <summary>Buffer in which the PNG stream of a single frame is assembled</summary>
+    private: std::vector<std::uint8_t> frameStream;
+    /// <summary>Receives the decoded pixels of a frame</summary>
+    private: std::vector<std::uint8_t> framePixels;
+    /// <summary>Backup of the canvas region of a frame that restores the previous state</summary>
+    private: std::vector<std::uint8_t> previousPixels;
+
+    /// <summary>Index of the frame the canvas last decoded into is showing</summary>
+    private: std::size_t currentFrameIndex;
+    /// <summary>Pixels of the bitmap the last frame was decoded into</summary>
+    private: const void *currentCanvasPixels;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Png
+
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+#endif // NUCLEX_PIXELS_STORAGE_PNG_APNGREADER_H
@@ -29,6 +29,7 @@ License along with this library
 
 #include <cassert>
 #include <algorithm>
+#include <cstring> // for std::memcpy()
 
 namespace {
 
@@ -49,7 +50,20 @@ namespace {
       throw std::runtime_error(u8"libpng tried to read from a file opened for writing");
     }
 
-    readEnvironment.File.ReadAt(readEnvironment.Position, length, data);
+    // Reading past the end of the file is reported through libpng, so its error handler
+    // decides whether this throws an exception or, when a file is only being probed,
+    // jumps back out of libpng
+    if(length > readEnvironment.Length - readEnvironment.Position) {
+      ::png_error(pngRead, u8"Attempt to read past end of file");
+    }
+
+    // libpng always wants the data in its own buffer, but if the file is held in memory,
+    // we can at least skip the virtual method call and copy the data over directly
+    if(readEnvironment.Contents == nullptr) {
+      readEnvironment.File.ReadAt(readEnvironment.Position, length, data);
+    } else {
+      std::memcpy(data, readEnvironment.Contents + readEnvironment.Position, length);
+    }
     readEnvironment.Position += length;
     //}
     //catch(const std::exception &error) {
@@ -44,6 +44,24 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Describes how the rows of a bitmap will be handed to libpng</summary>
+  struct PngRowLayout {
+
+    /// <summary>Pixel format the rows need to be in when they are handed to libpng</summary>
+    public: Nuclex::Pixels::PixelFormat PixelFormat;
+    /// <summary>PNG color type the image will be stored as</summary>
+    public: int ColorType;
+    /// <summary>Number of bits each channel will have in the PNG file</summary>
+    public: int BitDepth;
+    /// <summary>Whether the rows store the blue channel before the red one</summary>
+    public: bool IsBgr;
+    /// <summary>Whether 16 bit channels are stored with the least significant byte first</summary>
+    public: bool IsLittleEndian16;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Helper class for reading JPEG files using libjpeg</summary>
   class Helpers {
 
@@ -71,6 +89,8 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
       IsReadOnly(true),
       File(file),
       Position(0) {
+      this->Length = file.GetSize();
+      this->Contents = file.TryGetContiguousSpan(0, static_cast<std::size_t>(this->Length));
       SetupFunctionPointers(*this, pngRead);
     }
 
@@ -88,6 +108,10 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
     public: const Nuclex::Pixels::Storage::VirtualFile &File;
     /// <summary>Current position of the file pointer</summary>
     public: std::uint64_t Position;
+    /// <summary>Total length of the file in bytes</summary>
+    public: std::uint64_t Length;
+    /// <summary>Contents of the file if it is held in memory, otherwise null</summary>
+    public: const std::uint8_t *Contents;
 
   };
 
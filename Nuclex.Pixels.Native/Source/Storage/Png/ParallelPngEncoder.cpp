@@ -0,0 +1,578 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "ParallelPngEncoder.h"
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+
+#include <zlib.h>
+
+#include <algorithm> // for std::min(), std::swap()
+#include <cstdint> // for std::uint8_t, std::uint32_t
+#include <cstdlib> // for std::abs()
+#include <cstring> // for std::memcpy(), std::memset()
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of filtered bytes each strip should roughly cover</summary>
+  /// <remarks>
+  ///   Large enough that the sync flush at the end of each strip and restarting
+  ///   the compressor barely affect the file size, small enough that a screenshot
+  ///   yields enough strips to keep all cores busy.
+  /// </remarks>
+  const std::size_t PreferredStripByteCount = 1024 * 1024;
+
+  /// <summary>Size of the deflate window, the maximum distance a match can reach back</summary>
+  const std::size_t DeflateWindowByteCount = 32768;
+
+  /// <summary>The eight bytes every PNG file begins with</summary>
+  const std::uint8_t PngSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ends a zlib deflate stream when the scope is left</summary>
+  class DeflateStreamScope {
+
+    /// <summary>Initializes a new deflate stream scope</summary>
+    /// <param name="stream">Initialized deflate stream that will be ended</param>
+    public: DeflateStreamScope(::z_stream &stream) :
+      stream(stream) {}
+
+    /// <summary>Ends the deflate stream, freeing the compressor's memory</summary>
+    public: ~DeflateStreamScope() {
+      ::deflateEnd(&this->stream);
+    }
+
+    /// <summary>Deflate stream that will be ended</summary>
+    private: ::z_stream &stream;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a 32 bit integer in the big endian byte order PNG uses</summary>
+  /// <param name="target">Address at which the integer will be stored</param>
+  /// <param name="value">Integer that will be stored</param>
+  void storeBigEndian(std::uint8_t *target, std::uint32_t value) {
+    target[0] = static_cast<std::uint8_t>(value >> 24);
+    target[1] = static_cast<std::uint8_t>(value >> 16);
+    target[2] = static_cast<std::uint8_t>(value >> 8);
+    target[3] = static_cast<std::uint8_t>(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a PNG chunk into a file</summary>
+  /// <param name="target">File the chunk will be written into</param>
+  /// <param name="position">Position in the file, advanced past the chunk</param>
+  /// <param name="type">Four character type of the chunk</param>
+  /// <param name="data">Data that will be stored in the chunk</param>
+  /// <param name="byteCount">Number of bytes of data in the chunk</param>
+  void writeChunk(
+    Nuclex::Pixels::Storage::VirtualFile &target, std::uint64_t &position,
+    const char type[4], const std::uint8_t *data, std::size_t byteCount
+  ) {
+    std::uint8_t header[8];
+    storeBigEndian(header, static_cast<std::uint32_t>(byteCount));
+    std::memcpy(header + 4, type, 4);
+
+    ::uLong crc = ::crc32(0, reinterpret_cast<const ::Bytef *>(type), 4);
+    if(byteCount > 0) {
+      crc = ::crc32(crc, data, static_cast<::uInt>(byteCount));
+    }
+
+    std::uint8_t footer[4];
+    storeBigEndian(footer, static_cast<std::uint32_t>(crc));
+
+    target.WriteAt(position, 8, header);
+    position += 8;
+    if(byteCount > 0) {
+      target.WriteAt(position, byteCount, data);
+      position += byteCount;
+    }
+    target.WriteAt(position, 4, footer);
+    position += 4;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds the two byte header zlib would write at the start of a stream</summary>
+  /// <param name="level">Compression level the stream is deflated with</param>
+  /// <param name="strategy">zlib strategy the stream is deflated with</param>
+  /// <param name="header">Receives the two header bytes</param>
+  void getZlibHeader(int level, int strategy, std::uint8_t header[2]) {
+    unsigned int levelFlags;
+    if((strategy >= Z_HUFFMAN_ONLY) || (level < 2)) {
+      levelFlags = 0;
+    } else if(level < 6) {
+      levelFlags = 1;
+    } else if(level == 6) {
+      levelFlags = 2;
+    } else {
+      levelFlags = 3;
+    }
+
+    // Deflate with a 32 KiB window, the check bits make the header divisible by 31
+    unsigned int value = (0x78 << 8) | (levelFlags << 6);
+    value += 31 - (value % 31);
+
+    header[0] = static_cast<std::uint8_t>(value >> 8);
+    header[1] = static_cast<std::uint8_t>(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the PNG filter type that will be applied to all rows</summary>
+  /// <param name="filter">Row filter selected in the save options</param>
+  /// <returns>The PNG filter type or -1 to pick the best filter for each row</returns>
+  int getFilterType(Nuclex::Pixels::Storage::PngRowFilter filter) {
+    using Nuclex::Pixels::Storage::PngRowFilter;
+
+    switch(filter) {
+      case PngRowFilter::None: { return 0; }
+      case PngRowFilter::Sub: { return 1; }
+      case PngRowFilter::Up: { return 2; }
+      case PngRowFilter::Average: { return 3; }
+      case PngRowFilter::Paeth: { return 4; }
+      case PngRowFilter::Adaptive: { return -1; }
+      default: {
+        throw std::invalid_argument(u8"Unknown PNG row filter");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fetches a row of the bitmap in the byte order it will have in the PNG</summary>
+  /// <param name="memory">Bitmap memory the row will be taken from</param>
+  /// <param name="y">Index of the row that will be fetched</param>
+  /// <param name="rowLayout">Layout in which the rows will be stored in the PNG</param>
+  /// <param name="rowByteCount">Number of bytes in one row of the PNG image</param>
+  /// <param name="row">Buffer that will receive the row</param>
+  /// <remarks>
+  ///   This does what libpng's png_set_bgr() and png_set_swap() transformations do
+  ///   when the rows are handed to libpng instead.
+  /// </remarks>
+  void fetchRow(
+    const Nuclex::Pixels::BitmapMemory &memory, std::size_t y,
+    const Nuclex::Pixels::Storage::Png::PngRowLayout &rowLayout,
+    std::size_t rowByteCount, std::uint8_t *row
+  ) {
+    const std::uint8_t *source = static_cast<const std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    );
+    if(memory.PixelFormat == rowLayout.PixelFormat) {
+      std::memcpy(row, source, rowByteCount);
+    } else {
+      Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+        memory.PixelFormat, source, rowLayout.PixelFormat, row, memory.Width
+      );
+    }
+
+    if(rowLayout.IsBgr) {
+      std::size_t bytesPerPixel = rowByteCount / memory.Width;
+      for(std::size_t index = 0; index < rowByteCount; index += bytesPerPixel) {
+        std::swap(row[index], row[index + 2]);
+      }
+    }
+    if(rowLayout.IsLittleEndian16) {
+      for(std::size_t index = 0; index < rowByteCount; index += 2) {
+        std::swap(row[index], row[index + 1]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Predicts a byte from its neighbours the way the Paeth filter does</summary>
+  /// <param name="left">Byte to the left of the predicted one</param>
+  /// <param name="above">Byte above the predicted one</param>
+  /// <param name="aboveLeft">Byte above and to the left of the predicted one</param>
+  /// <returns>The neighbour closest to the linear prediction from all three</returns>
+  inline std::uint8_t predictPaeth(int left, int above, int aboveLeft) {
+    int leftDistance = std::abs(above - aboveLeft);
+    int aboveDistance = std::abs(left - aboveLeft);
+    int aboveLeftDistance = std::abs(left + above - aboveLeft - aboveLeft);
+
+    if((leftDistance <= aboveDistance) && (leftDistance <= aboveLeftDistance)) {
+      return static_cast<std::uint8_t>(left);
+    } else if(aboveDistance <= aboveLeftDistance) {
+      return static_cast<std::uint8_t>(above);
+    } else {
+      return static_cast<std::uint8_t>(aboveLeft);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Applies a PNG filter to a row</summary>
+  /// <param name="filterType">PNG filter type that will be applied</param>
+  /// <param name="row">Row that will be filtered</param>
+  /// <param name="previousRow">Row above, all zeros for the first row of the image</param>
+  /// <param name="rowByteCount">Number of bytes in the row</param>
+  /// <param name="bytesPerPixel">Distance between a byte and its left neighbour</param>
+  /// <param name="target">Receives the filter type byte followed by the filtered row</param>
+  void filterRow(
+    int filterType, const std::uint8_t *row, const std::uint8_t *previousRow,
+    std::size_t rowByteCount, std::size_t bytesPerPixel, std::uint8_t *target
+  ) {
+    target[0] = static_cast<std::uint8_t>(filterType);
+    ++target;
+
+    switch(filterType) {
+      case 1: { // Sub
+        for(std::size_t index = 0; index < bytesPerPixel; ++index) {
+          target[index] = row[index];
+        }
+        for(std::size_t index = bytesPerPixel; index < rowByteCount; ++index) {
+          target[index] = static_cast<std::uint8_t>(row[index] - row[index - bytesPerPixel]);
+        }
+        break;
+      }
+      case 2: { // Up
+        for(std::size_t index = 0; index < rowByteCount; ++index) {
+          target[index] = static_cast<std::uint8_t>(row[index] - previousRow[index]);
+        }
+        break;
+      }
+      case 3: { // Average
+        for(std::size_t index = 0; index < bytesPerPixel; ++index) {
+          target[index] = static_cast<std::uint8_t>(row[index] - (previousRow[index] >> 1));
+        }
+        for(std::size_t index = bytesPerPixel; index < rowByteCount; ++index) {
+          int average = (row[index - bytesPerPixel] + previousRow[index]) >> 1;
+          target[index] = static_cast<std::uint8_t>(row[index] - average);
+        }
+        break;
+      }
+      case 4: { // Paeth
+        for(std::size_t index = 0; index < bytesPerPixel; ++index) {
+          target[index] = static_cast<std::uint8_t>(
+            row[index] - predictPaeth(0, previousRow[index], 0)
+          );
+        }
+        for(std::size_t index = bytesPerPixel; index < rowByteCount; ++index) {
+          std::uint8_t prediction = predictPaeth(
+            row[index - bytesPerPixel], previousRow[index], previousRow[index - bytesPerPixel]
+          );
+          target[index] = static_cast<std::uint8_t>(row[index] - prediction);
+        }
+        break;
+      }
+      default: { // None
+        std::memcpy(target, row, rowByteCount);
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Estimates how well a filtered row will compress</summary>
+  /// <param name="filteredRow">Filtered row without the filter type byte</param>
+  /// <param name="rowByteCount">Number of bytes in the row</param>
+  /// <returns>The sum of the bytes interpreted as signed distances, lower is better</returns>
+  /// <remarks>
+  ///   This is the heuristic libpng uses to pick a filter for each row. Filters that
+  ///   predict the pixels well leave lots of values close to zero behind.
+  /// </remarks>
+  std::size_t sumAbsoluteDistances(const std::uint8_t *filteredRow, std::size_t rowByteCount) {
+    std::size_t sum = 0;
+    for(std::size_t index = 0; index < rowByteCount; ++index) {
+      std::uint8_t value = filteredRow[index];
+      sum += (value < 128) ? value : (256 - value);
+    }
+    return sum;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tries all PNG filters on a row and keeps the most promising one</summary>
+  /// <param name="row">Row that will be filtered</param>
+  /// <param name="previousRow">Row above, all zeros for the first row of the image</param>
+  /// <param name="rowByteCount">Number of bytes in the row</param>
+  /// <param name="bytesPerPixel">Distance between a byte and its left neighbour</param>
+  /// <param name="candidate">Buffer the size of a filtered row to try filters in</param>
+  /// <param name="target">Receives the filter type byte followed by the filtered row</param>
+  void filterRowAdaptively(
+    const std::uint8_t *row, const std::uint8_t *previousRow,
+    std::size_t rowByteCount, std::size_t bytesPerPixel,
+    std::uint8_t *candidate, std::uint8_t *target
+  ) {
+    filterRow(0, row, previousRow, rowByteCount, bytesPerPixel, target);
+    std::size_t bestSum = sumAbsoluteDistances(target + 1, rowByteCount);
+
+    for(int filterType = 1; filterType <= 4; ++filterType) {
+      filterRow(filterType, row, previousRow, rowByteCount, bytesPerPixel, candidate);
+      std::size_t sum = sumAbsoluteDistances(candidate + 1, rowByteCount);
+      if(sum < bestSum) {
+        std::memcpy(target, candidate, rowByteCount + 1);
+        bestSum = sum;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Deflates one strip of filtered rows into a piece of a zlib stream</summary>
+  /// <param name="data">Filtered rows of the strip</param>
+  /// <param name="byteCount">Number of bytes in the strip</param>
+  /// <param name="dictionaryByteCount">
+  ///   Number of bytes directly in front of the strip that matches may refer to
+  /// </param>
+  /// <param name="isLastStrip">Whether this is the strip ending the deflate stream</param>
+  /// <param name="options">Options controlling the compression</param>
+  /// <param name="strategy">zlib strategy the strip will be deflated with</param>
+  /// <param name="output">Buffer the deflated data will be appended to</param>
+  /// <remarks>
+  ///   The strip is deflated as raw deflate data. All strips except the last end
+  ///   with a sync flush, which finishes the current block and pads it to a byte
+  ///   boundary, so the strips can simply be concatenated.
+  /// </remarks>
+  void deflateStrip(
+    const std::uint8_t *data, std::size_t byteCount, std::size_t dictionaryByteCount,
+    bool isLastStrip, int level, int strategy, std::vector<std::uint8_t> &output
+  ) {
+    ::z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+
+    int result = ::deflateInit2(&stream, level, Z_DEFLATED, -15, 8, strategy);
+    if(result != Z_OK) {
+      throw std::runtime_error(u8"Could not initialize zlib for compressing PNG data");
+    }
+    {
+      DeflateStreamScope deflateStreamScope(stream);
+
+      if(dictionaryByteCount > 0) {
+        result = ::deflateSetDictionary(
+          &stream, data - dictionaryByteCount, static_cast<::uInt>(dictionaryByteCount)
+        );
+        if(result != Z_OK) {
+          throw std::runtime_error(u8"Could not hand the previous strip to zlib as dictionary");
+        }
+      }
+
+      std::size_t outputStart = output.size();
+      output.resize(outputStart + ::deflateBound(&stream, static_cast<::uLong>(byteCount)) + 16);
+
+      stream.next_in = const_cast<::Bytef *>(data);
+      stream.avail_in = static_cast<::uInt>(byteCount);
+      stream.next_out = &output[outputStart];
+      stream.avail_out = static_cast<::uInt>(output.size() - outputStart);
+
+      int flush = isLastStrip ? Z_FINISH : Z_SYNC_FLUSH;
+      for(;;) {
+        result = ::deflate(&stream, flush);
+        if(result == Z_STREAM_END) {
+          break;
+        }
+        if((result != Z_OK) && (result != Z_BUF_ERROR)) {
+          throw std::runtime_error(u8"zlib failed to compress PNG data");
+        }
+
+        // A sync flush is complete when deflate() returns with output space left,
+        // a finish only when deflate() reports the end of the stream
+        if(stream.avail_out > 0) {
+          if(!isLastStrip && (stream.avail_in == 0)) {
+            break;
+          }
+        } else {
+          std::size_t usedByteCount = output.size();
+          output.resize(usedByteCount + (usedByteCount - outputStart) / 2 + 64);
+          stream.next_out = &output[usedByteCount];
+          stream.avail_out = static_cast<::uInt>(output.size() - usedByteCount);
+        }
+      }
+
+      output.resize(output.size() - stream.avail_out);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool ParallelPngEncoder::IsWorthwhile(
+    const BitmapMemory &memory, const PngRowLayout &rowLayout
+  ) {
+    std::size_t rowByteCount = CountRequiredBytes(rowLayout.PixelFormat, memory.Width);
+    return (memory.Height > getStripHeight(rowByteCount + 1));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ParallelPngEncoder::Encode(
+    ThreadPool &threadPool,
+    const BitmapMemory &memory, const PngRowLayout &rowLayout,
+    const PngSaveOptions &options, VirtualFile &target
+  ) {
+    int filterType = getFilterType(options.Filter);
+    int strategy;
+    switch(options.Strategy) {
+      case PngCompressionStrategy::Default: { strategy = Z_DEFAULT_STRATEGY; break; }
+      case PngCompressionStrategy::Filtered: { strategy = Z_FILTERED; break; }
+      case PngCompressionStrategy::HuffmanOnly: { strategy = Z_HUFFMAN_ONLY; break; }
+      case PngCompressionStrategy::RunLength: { strategy = Z_RLE; break; }
+      case PngCompressionStrategy::Fixed: { strategy = Z_FIXED; break; }
+      default: {
+        throw std::invalid_argument(u8"Unknown PNG compression strategy");
+      }
+    }
+
+    std::size_t rowByteCount = CountRequiredBytes(rowLayout.PixelFormat, memory.Width);
+    std::size_t bytesPerPixel = CountRequiredBytes(rowLayout.PixelFormat, 1);
+    std::size_t filteredRowByteCount = rowByteCount + 1;
+    std::size_t stripHeight = getStripHeight(filteredRowByteCount);
+    std::size_t stripCount = (memory.Height + stripHeight - 1) / stripHeight;
+    std::size_t stripByteCount = stripHeight * filteredRowByteCount;
+
+    // Filter all rows first. Each strip needs the filtered bytes in front of it
+    // as its dictionary, so deflating can only begin once all strips are filtered.
+    std::vector<std::uint8_t> filteredRows(filteredRowByteCount * memory.Height);
+    threadPool.ForEach(
+      stripCount,
+      [&](std::size_t stripIndex) {
+        std::size_t startY = stripIndex * stripHeight;
+        std::size_t endY = std::min(startY + stripHeight, memory.Height);
+
+        std::vector<std::uint8_t> rows(rowByteCount * 2 + filteredRowByteCount);
+        std::uint8_t *row = &rows[0];
+        std::uint8_t *previousRow = row + rowByteCount;
+        std::uint8_t *candidate = previousRow + rowByteCount;
+        if(startY > 0) {
+          fetchRow(memory, startY - 1, rowLayout, rowByteCount, previousRow);
+        }
+
+        for(std::size_t y = startY; y < endY; ++y) {
+          fetchRow(memory, y, rowLayout, rowByteCount, row);
+
+          std::uint8_t *filteredRow = &filteredRows[y * filteredRowByteCount];
+          if(filterType < 0) {
+            filterRowAdaptively(
+              row, previousRow, rowByteCount, bytesPerPixel, candidate, filteredRow
+            );
+          } else {
+            filterRow(filterType, row, previousRow, rowByteCount, bytesPerPixel, filteredRow);
+          }
+
+          std::swap(row, previousRow);
+        }
+      }
+    );
+
+    // Deflate the strips, each one seeing the end of the previous strip as dictionary
+    std::vector<std::vector<std::uint8_t>> deflatedStrips(stripCount);
+    std::vector<::uLong> stripChecksums(stripCount);
+    threadPool.ForEach(
+      stripCount,
+      [&](std::size_t stripIndex) {
+        std::size_t start = stripIndex * stripByteCount;
+        std::size_t byteCount = std::min(stripByteCount, filteredRows.size() - start);
+        std::size_t dictionaryByteCount = std::min(start, DeflateWindowByteCount);
+        const std::uint8_t *data = &filteredRows[start];
+
+        stripChecksums[stripIndex] = ::adler32(
+          ::adler32(0, nullptr, 0), data, static_cast<::uInt>(byteCount)
+        );
+
+        // The first strip also carries the zlib stream header
+        std::vector<std::uint8_t> &deflatedStrip = deflatedStrips[stripIndex];
+        if(stripIndex == 0) {
+          deflatedStrip.resize(2);
+          getZlibHeader(options.CompressionLevel, strategy, &deflatedStrip[0]);
+        }
+
+        deflateStrip(
+          data, byteCount, dictionaryByteCount, (stripIndex + 1 == stripCount),
+          options.CompressionLevel, strategy, deflatedStrip
+        );
+      }
+    );
+
+    // The zlib stream ends with the Adler-32 checksum of all the filtered rows,
+    // which can be calculated from the checksums of the individual strips
+    {
+      ::uLong checksum = stripChecksums[0];
+      for(std::size_t index = 1; index < stripCount; ++index) {
+        std::size_t byteCount = std::min(
+          stripByteCount, filteredRows.size() - (index * stripByteCount)
+        );
+        checksum = ::adler32_combine(
+          checksum, stripChecksums[index], static_cast<::z_off_t>(byteCount)
+        );
+      }
+
+      std::vector<std::uint8_t> &lastStrip = deflatedStrips[stripCount - 1];
+      std::size_t checksumOffset = lastStrip.size();
+      lastStrip.resize(checksumOffset + 4);
+      storeBigEndian(&lastStrip[checksumOffset], static_cast<std::uint32_t>(checksum));
+    }
+
+    // Now write the file: signature, header, one IDAT chunk per strip and the end marker
+    std::uint64_t position = 0;
+    target.WriteAt(position, sizeof(PngSignature), PngSignature);
+    position += sizeof(PngSignature);
+    {
+      std::uint8_t header[13];
+      storeBigEndian(header, static_cast<std::uint32_t>(memory.Width));
+      storeBigEndian(header + 4, static_cast<std::uint32_t>(memory.Height));
+      header[8] = static_cast<std::uint8_t>(rowLayout.BitDepth);
+      header[9] = static_cast<std::uint8_t>(rowLayout.ColorType);
+      header[10] = 0; // Compression method: deflate
+      header[11] = 0; // Filter method: adaptive with the five basic filters
+      header[12] = 0; // Interlace method: none
+      writeChunk(target, position, "IHDR", header, sizeof(header));
+    }
+    for(std::size_t index = 0; index < stripCount; ++index) {
+      const std::vector<std::uint8_t> &deflatedStrip = deflatedStrips[index];
+      writeChunk(target, position, "IDAT", deflatedStrip.data(), deflatedStrip.size());
+    }
+    writeChunk(target, position, "IEND", nullptr, 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ParallelPngEncoder::getStripHeight(std::size_t rowByteCount) {
+    if(rowByteCount >= PreferredStripByteCount) {
+      return 1;
+    } else {
+      return PreferredStripByteCount / rowByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Png
+
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
@@ -0,0 +1,90 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_PNG_PARALLELPNGENCODER_H
+#define NUCLEX_PIXELS_STORAGE_PNG_PARALLELPNGENCODER_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+#include "Nuclex/Pixels/BitmapMemory.h"
+#include "Nuclex/Pixels/Storage/SaveOptions.h" // also declares ThreadPool
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "LibPngHelpers.h"
+
+#include <cstddef> // for std::size_t
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes PNG files, filtering and deflating strips of rows in parallel</summary>
+  /// <remarks>
+  ///   <para>
+  ///     libpng filters and deflates the rows of an image one after another, so saving
+  ///     large images keeps a single core busy. This encoder splits the image into
+  ///     horizontal strips that are filtered and deflated on a thread pool, then stitched
+  ///     into a single zlib stream: each strip but the last one ends with a sync flush
+  ///     (which aligns it to a byte boundary without ending the deflate stream) and
+  ///     the Adler-32 checksums of the strips are combined into the stream's checksum.
+  ///   </para>
+  ///   <para>
+  ///     Each strip is deflated with the last 32 KiB of the strip before it as preset
+  ///     dictionary, so matches can still reach across strip boundaries and the file
+  ///     ends up only marginally larger than one written by libpng.
+  ///   </para>
+  /// </remarks>
+  class ParallelPngEncoder {
+
+    /// <summary>Checks whether an image is large enough to be split into strips</summary>
+    /// <param name="memory">Bitmap memory of the image that would be saved</param>
+    /// <param name="rowLayout">Layout in which the rows will be stored in the PNG</param>
+    /// <returns>True if the image would be encoded as more than one strip</returns>
+    public: static bool IsWorthwhile(
+      const BitmapMemory &memory, const PngRowLayout &rowLayout
+    );
+
+    /// <summary>Writes an image into a PNG file using multiple threads</summary>
+    /// <param name="threadPool">Thread pool that will filter and deflate the strips</param>
+    /// <param name="memory">Bitmap memory of the image that will be saved</param>
+    /// <param name="rowLayout">Layout in which the rows will be stored in the PNG</param>
+    /// <param name="options">Options controlling the filters and compression</param>
+    /// <param name="target">File the PNG image will be written into</param>
+    public: static void Encode(
+      ThreadPool &threadPool,
+      const BitmapMemory &memory, const PngRowLayout &rowLayout,
+      const PngSaveOptions &options, VirtualFile &target
+    );
+
+    /// <summary>Determines how many rows each strip should have</summary>
+    /// <param name="rowByteCount">Number of bytes in one row of the PNG image</param>
+    /// <returns>The number of rows that will be filtered and deflated together</returns>
+    private: static std::size_t getStripHeight(std::size_t rowByteCount);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Png
+
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+#endif // NUCLEX_PIXELS_STORAGE_PNG_PARALLELPNGENCODER_H
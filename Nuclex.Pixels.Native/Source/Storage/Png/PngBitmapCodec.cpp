@@ -26,10 +26,27 @@ License along with this library
 #if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
 
 #include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Storage/DecodeContext.h"
 #include "Nuclex/Pixels/Errors/FileFormatError.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/ThreadPool.h"
 #include "LibPngHelpers.h"
+#include "ParallelPngEncoder.h"
+#include "ApngReader.h"
+#include "../../RowStreamHelpers.h"
+#include "../../InstrumentationHelpers.h"
 
 #include <png.h>
+#include <zlib.h> // for the Z_* compression strategy constants
+
+#include <algorithm> // for std::min()
+#include <csetjmp> // for setjmp()
+#include <cstddef> // for std::max_align_t
+#include <cstdlib> // for std::malloc(), std::free()
+#include <cstring> // for std::memcpy()
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
 
 namespace {
 
@@ -67,6 +84,20 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Handles an error occuring while the header of a PNG is being probed</summary>
+  /// <param name="png">PNG main structure holding the jump buffer</param>
+  /// <param name="errorMessage">Describes the error that has occurred, unused</param>
+  /// <remarks>
+  ///   Jumps back to the point set up by <see cref="tryReadPngInfo" />, so that
+  ///   files which merely look like PNGs are rejected without an exception.
+  /// </remarks>
+  void jumpOnPngError(::png_struct *png, const char *errorMessage) {
+    (void)errorMessage;
+    ::png_longjmp(png, 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>RAII helper class that frees a PNG struct again</summary>
   class PngReadScope {
 
@@ -115,6 +146,876 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>RAII helper class that frees a PNG write struct again</summary>
+  class PngWriteScope {
+
+    /// <summary>Initializes a new png_struct deleter</summary>
+    /// <param name="pngStruct">
+    ///   PNG main structure that should be deleted on scope exit
+    /// </param>
+    public: PngWriteScope(::png_struct *pngStruct) :
+      pngStruct(pngStruct) {}
+
+    /// <summary>Frees the PNG main structure</summary>
+    public: ~PngWriteScope() {
+      ::png_destroy_write_struct(&this->pngStruct, nullptr);
+    }
+
+    /// <summary>PNG main structure that will be deleted</summary>
+    private: ::png_struct *pngStruct;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory blocks libpng and zlib used for earlier images</summary>
+  /// <remarks>
+  ///   libpng offers no way to reset a read structure for another image, so instead of
+  ///   the read structure, the decode context keeps the memory libpng and zlib allocate
+  ///   for it (the structures themselves, the inflate window and the row buffers).
+  ///   Blocks freed by libpng are recycled when the next image is read, so reading
+  ///   similar images one after another stops hitting the heap.
+  /// </remarks>
+  class PngDecodeState : public Nuclex::Pixels::Storage::DecodeContext::State {
+
+    /// <summary>Largest total size of the memory blocks kept for reuse</summary>
+    private: static const std::size_t MaximumCachedByteCount = 8 * 1024 * 1024;
+
+    /// <summary>Header in front of each memory block handed to libpng</summary>
+    private: struct BlockHeader {
+      /// <summary>Number of bytes usable in the memory block</summary>
+      public: std::size_t ByteCount;
+      /// <summary>Next memory block in the list of free blocks</summary>
+      public: BlockHeader *NextFreeBlock;
+    };
+
+    /// <summary>Size of the block header, padded to keep the memory aligned</summary>
+    private: static const std::size_t HeaderByteCount = (
+      (sizeof(BlockHeader) + alignof(std::max_align_t) - 1) /
+      alignof(std::max_align_t) * alignof(std::max_align_t)
+    );
+
+    /// <summary>Initializes a new PNG decode state without any memory blocks</summary>
+    public: PngDecodeState() :
+      firstFreeBlock(nullptr),
+      cachedByteCount(0) {}
+
+    /// <summary>Frees all memory blocks kept for reuse</summary>
+    public: ~PngDecodeState() override {
+      while(this->firstFreeBlock != nullptr) {
+        BlockHeader *block = this->firstFreeBlock;
+        this->firstFreeBlock = block->NextFreeBlock;
+        std::free(block);
+      }
+    }
+
+    /// <summary>Allocates memory for libpng</summary>
+    /// <param name="pngStruct">PNG main structure providing the decode state</param>
+    /// <param name="byteCount">Number of bytes libpng is asking for</param>
+    /// <returns>The allocated memory or a null pointer if the heap is exhausted</returns>
+    public: static ::png_voidp Allocate(::png_struct *pngStruct, ::png_alloc_size_t byteCount) {
+      PngDecodeState &self = *static_cast<PngDecodeState *>(::png_get_mem_ptr(pngStruct));
+
+      // Look for a free block that is large enough without wasting more than half of it
+      BlockHeader **link = &self.firstFreeBlock;
+      while(*link != nullptr) {
+        BlockHeader *block = *link;
+        if((block->ByteCount >= byteCount) && (block->ByteCount / 2 <= byteCount)) {
+          *link = block->NextFreeBlock;
+          self.cachedByteCount -= block->ByteCount;
+          return reinterpret_cast<std::uint8_t *>(block) + HeaderByteCount;
+        }
+        link = &block->NextFreeBlock;
+      }
+
+      BlockHeader *block = static_cast<BlockHeader *>(std::malloc(HeaderByteCount + byteCount));
+      if(block == nullptr) {
+        return nullptr; // libpng reports this as an out of memory error itself
+      }
+
+      block->ByteCount = static_cast<std::size_t>(byteCount);
+      return reinterpret_cast<std::uint8_t *>(block) + HeaderByteCount;
+    }
+
+    /// <summary>Takes back memory libpng no longer needs</summary>
+    /// <param name="pngStruct">PNG main structure providing the decode state</param>
+    /// <param name="memory">Memory that was allocated via <see cref="Allocate" /></param>
+    public: static void Free(::png_struct *pngStruct, ::png_voidp memory) {
+      if(memory == nullptr) {
+        return;
+      }
+
+      PngDecodeState &self = *static_cast<PngDecodeState *>(::png_get_mem_ptr(pngStruct));
+      BlockHeader *block = reinterpret_cast<BlockHeader *>(
+        static_cast<std::uint8_t *>(memory) - HeaderByteCount
+      );
+      if(self.cachedByteCount + block->ByteCount > MaximumCachedByteCount) {
+        std::free(block);
+      } else {
+        block->NextFreeBlock = self.firstFreeBlock;
+        self.firstFreeBlock = block;
+        self.cachedByteCount += block->ByteCount;
+      }
+    }
+
+    /// <summary>First memory block in the list of blocks kept for reuse</summary>
+    private: BlockHeader *firstFreeBlock;
+    /// <summary>Total number of bytes in the memory blocks kept for reuse</summary>
+    private: std::size_t cachedByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tells libpng whether to verify the checksums in a PNG file</summary>
+  /// <param name="pngRead">PNG main structure the file will be read with</param>
+  /// <param name="options">PNG load options stating whether the file is trusted</param>
+  /// <remarks>
+  ///   When checksums are not verified, libpng neither calculates the CRC-32 of
+  ///   the chunks nor lets zlib calculate the Adler-32 of the inflated image data
+  ///   (the latter requires libpng 1.6.26 or later).
+  /// </remarks>
+  void applyChecksumPolicy(
+    ::png_struct *pngRead, const Nuclex::Pixels::Storage::PngLoadOptions &options
+  ) {
+    if(options.VerifyChecksums) {
+      return;
+    }
+
+    ::png_set_crc_action(pngRead, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+#if defined(PNG_SET_OPTION_SUPPORTED) && defined(PNG_IGNORE_ADLER32)
+    ::png_set_option(pngRead, PNG_IGNORE_ADLER32, PNG_OPTION_ON);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a PNG main structure for reading an image</summary>
+  /// <param name="codec">Codec under which the decode state is kept in the context</param>
+  /// <param name="options">Load options that may provide a decode context</param>
+  /// <returns>The new PNG main structure or a null pointer if the heap is exhausted</returns>
+  /// <remarks>
+  ///   If the load options carry a decode context, libpng will allocate its memory
+  ///   through the context's <see cref="PngDecodeState" />.
+  /// </remarks>
+  ::png_struct *createPngReadStruct(
+    const Nuclex::Pixels::Storage::BitmapCodec &codec,
+    const Nuclex::Pixels::Storage::LoadOptions &options
+  ) {
+    ::png_struct *pngRead;
+    if(options.Context == nullptr) {
+      pngRead = ::png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    } else {
+      PngDecodeState &state = options.Context->Acquire<PngDecodeState>(codec);
+      pngRead = ::png_create_read_struct_2(
+        PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr,
+        &state, &PngDecodeState::Allocate, &PngDecodeState::Free
+      );
+    }
+
+    if(pngRead != nullptr) {
+      applyChecksumPolicy(pngRead, options.Png);
+    }
+
+    return pngRead;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>State shared with libpng's progressive reader callbacks</summary>
+  struct PngProgressiveReadState {
+
+    /// <summary>Initializes a new progressive read state</summary>
+    /// <param name="options">PNG load options with the row callback to invoke</param>
+    public: PngProgressiveReadState(const Nuclex::Pixels::Storage::PngLoadOptions &options) :
+      Options(options),
+      IsComplete(false) {}
+
+    /// <summary>Load options holding the row callback</summary>
+    public: const Nuclex::Pixels::Storage::PngLoadOptions &Options;
+    /// <summary>Bitmap the image is decoded into, created once the header is read</summary>
+    public: Nuclex::Pixels::Storage::OptionalBitmap Image;
+    /// <summary>Memory of the bitmap the rows are decoded into</summary>
+    public: Nuclex::Pixels::BitmapMemory Memory;
+    /// <summary>Whether libpng has reported the end of the image</summary>
+    public: bool IsComplete;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Called by the progressive reader once the PNG header has been read</summary>
+  /// <param name="pngRead">PNG main structure the reader is using</param>
+  /// <param name="pngInfo">PNG info structure describing the image</param>
+  void handleProgressiveInfo(::png_struct *pngRead, ::png_info *pngInfo) {
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::PixelFormat;
+
+    PngProgressiveReadState &state = *reinterpret_cast<PngProgressiveReadState *>(
+      ::png_get_progressive_ptr(pngRead)
+    );
+
+    // Let libpng deinterlace for us. Rows will then be delivered once per pass
+    // and have to be combined with what the previous passes left in the bitmap.
+    ::png_set_interlace_handling(pngRead);
+    ::png_read_update_info(pngRead, pngInfo);
+
+    std::size_t width = ::png_get_image_width(pngRead, pngInfo);
+    std::size_t height = ::png_get_image_height(pngRead, pngInfo);
+    PixelFormat pixelFormat = (
+      Nuclex::Pixels::Storage::Png::Helpers::GetEquivalentPixelFormat(*pngRead, *pngInfo)
+    );
+
+    // The pixels stay where they are when the bitmap is moved into the optional
+    Bitmap image(width, height, pixelFormat);
+    state.Memory = image.Access();
+    state.Image = Nuclex::Pixels::Storage::OptionalBitmap(std::move(image));
+
+    std::size_t bytesPerRow = ::png_get_rowbytes(pngRead, pngInfo);
+    if(bytesPerRow > static_cast<std::size_t>(std::abs(state.Memory.Stride))) {
+      throw std::runtime_error(u8"libpng row size unexpectedly large, wrong pixel format?");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Called by the progressive reader when a row has been decoded</summary>
+  /// <param name="pngRead">PNG main structure the reader is using</param>
+  /// <param name="newRow">Row data decoded by libpng, null if the row didn't change</param>
+  /// <param name="rowIndex">Index of the row that has been decoded</param>
+  /// <param name="pass">Interlace pass the row belongs to</param>
+  void handleProgressiveRow(
+    ::png_struct *pngRead, ::png_byte *newRow, ::png_uint_32 rowIndex, int pass
+  ) {
+    if(newRow == nullptr) {
+      return;
+    }
+
+    PngProgressiveReadState &state = *reinterpret_cast<PngProgressiveReadState *>(
+      ::png_get_progressive_ptr(pngRead)
+    );
+    if(rowIndex >= state.Memory.Height) {
+      throw std::runtime_error(u8"libpng delivered a row outside of the image");
+    }
+
+    // For interlaced images, this merges the pixels of the current pass into
+    // the row, otherwise it simply copies the row over
+    ::png_byte *rowAddress = static_cast<::png_byte *>(state.Memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(state.Memory.Stride) * static_cast<std::ptrdiff_t>(rowIndex)
+    );
+    ::png_progressive_combine_row(pngRead, rowAddress, newRow);
+
+    if(state.Options.RowDecoded) {
+      state.Options.RowDecoded(state.Memory, static_cast<std::size_t>(rowIndex), pass);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Called by the progressive reader when the end of the image is reached</summary>
+  /// <param name="pngRead">PNG main structure the reader is using</param>
+  /// <param name="pngInfo">PNG info structure describing the image, unused</param>
+  void handleProgressiveEnd(::png_struct *pngRead, ::png_info *pngInfo) {
+    (void)pngInfo;
+
+    PngProgressiveReadState &state = *reinterpret_cast<PngProgressiveReadState *>(
+      ::png_get_progressive_ptr(pngRead)
+    );
+    state.IsComplete = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a PNG file by feeding it to libpng's progressive reader</summary>
+  /// <param name="pngRead">PNG main structure set up for reading</param>
+  /// <param name="pngInfo">PNG info structure that will receive the image's header</param>
+  /// <param name="source">File the PNG image will be read from</param>
+  /// <param name="options">PNG load options with the row callback and chunk size</param>
+  /// <returns>The bitmap the PNG image has been decoded into</returns>
+  /// <remarks>
+  ///   If the file's contents are available in memory, they're handed to libpng directly,
+  ///   otherwise the file is read into a buffer one chunk at a time.
+  /// </remarks>
+  Nuclex::Pixels::Storage::OptionalBitmap readProgressively(
+    ::png_struct *pngRead, ::png_info *pngInfo,
+    const Nuclex::Pixels::Storage::VirtualFile &source,
+    const Nuclex::Pixels::Storage::PngLoadOptions &options
+  ) {
+    if(options.ChunkSize == 0) {
+      throw std::invalid_argument(u8"PNG chunk size must be larger than zero");
+    }
+
+    PngProgressiveReadState state(options);
+    ::png_set_progressive_read_fn(
+      pngRead, &state, &handleProgressiveInfo, &handleProgressiveRow, &handleProgressiveEnd
+    );
+
+    std::uint64_t fileLength = source.GetSize();
+
+    const std::uint8_t *contents = source.TryGetContiguousSpan(
+      0, static_cast<std::size_t>(fileLength)
+    );
+    std::vector<::png_byte> buffer;
+    if(contents == nullptr) {
+      buffer.resize(
+        static_cast<std::size_t>(std::min<std::uint64_t>(options.ChunkSize, fileLength))
+      );
+    }
+
+    // Feed the file to libpng chunk by chunk. libpng keeps whatever it can't
+    // process yet and calls our handlers as soon as there is something to report.
+    std::uint64_t position = 0;
+    while((position < fileLength) && !state.IsComplete) {
+      std::size_t chunkLength = static_cast<std::size_t>(
+        std::min<std::uint64_t>(options.ChunkSize, fileLength - position)
+      );
+
+      // libpng's signature isn't const-correct, but it never writes into the chunk
+      ::png_byte *chunk;
+      if(contents == nullptr) {
+        source.ReadAt(position, chunkLength, &buffer[0]);
+        chunk = &buffer[0];
+      } else {
+        chunk = const_cast<::png_byte *>(contents + position);
+      }
+
+      ::png_process_data(pngRead, pngInfo, chunk, chunkLength);
+      position += chunkLength;
+    }
+
+    if(!state.IsComplete) {
+      throw std::runtime_error(u8"PNG file ended before the image was complete");
+    }
+
+    return std::move(state.Image);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes only the rows and columns of a PNG image inside a region</summary>
+  /// <param name="pngRead">PNG main structure that has already read the PNG header</param>
+  /// <param name="pngInfo">PNG info structure describing the image</param>
+  /// <param name="region">Region of the image that will be decoded</param>
+  /// <param name="memory">Bitmap memory that will receive the region's pixels</param>
+  /// <param name="options">PNG load options with the row callback</param>
+  /// <remarks>
+  ///   <para>
+  ///     PNG rows are compressed as one stream, so the rows above the region still
+  ///     need to be decompressed, but decoding stops right after the region's last row.
+  ///   </para>
+  ///   <para>
+  ///     Interlaced images deliver each row once per pass. Their region rows are kept
+  ///     at full width until the last pass so libpng can merge the passes into them.
+  ///   </para>
+  /// </remarks>
+  void readRegion(
+    ::png_struct *pngRead, ::png_info *pngInfo,
+    const Nuclex::Pixels::Rectangle &region, const Nuclex::Pixels::BitmapMemory &memory,
+    const Nuclex::Pixels::Storage::PngLoadOptions &options
+  ) {
+    int passCount = ::png_set_interlace_handling(pngRead);
+    ::png_read_update_info(pngRead, pngInfo);
+
+    std::size_t bytesPerRow = ::png_get_rowbytes(pngRead, pngInfo);
+    std::size_t regionOffset = Nuclex::Pixels::CountRequiredBytes(
+      memory.PixelFormat, region.MinX
+    );
+    std::size_t regionRowByteCount = Nuclex::Pixels::CountRequiredBytes(
+      memory.PixelFormat, region.MaxX - region.MinX
+    );
+    if(regionOffset + regionRowByteCount > bytesPerRow) {
+      throw std::runtime_error(u8"libpng row size unexpectedly small, wrong pixel format?");
+    }
+
+    // Rows outside of the region are decoded into the scratch row and then forgotten.
+    // Interlaced images need to keep the region's rows at full width between passes.
+    std::vector<::png_byte> scratchRow(bytesPerRow);
+    std::vector<::png_byte> regionRows;
+    if(passCount > 1) {
+      regionRows.resize(bytesPerRow * (region.MaxY - region.MinY));
+    }
+
+    std::size_t height = ::png_get_image_height(pngRead, pngInfo);
+    for(int pass = 0; pass < passCount; ++pass) {
+      bool isLastPass = (pass == passCount - 1);
+      std::size_t rowCount = isLastPass ? region.MaxY : height;
+
+      for(std::size_t y = 0; y < rowCount; ++y) {
+        bool isInRegion = ((y >= region.MinY) && (y < region.MaxY));
+        ::png_byte *row;
+        if(isInRegion && (passCount > 1)) {
+          row = &regionRows[bytesPerRow * (y - region.MinY)];
+        } else {
+          row = &scratchRow[0];
+        }
+
+        ::png_read_row(pngRead, row, nullptr);
+
+        if(isInRegion) {
+          std::size_t targetY = y - region.MinY;
+          std::memcpy(
+            static_cast<std::uint8_t *>(memory.Pixels) + (
+              static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(targetY)
+            ),
+            row + regionOffset,
+            regionRowByteCount
+          );
+          if(options.RowDecoded) {
+            options.RowDecoded(memory, targetY, pass);
+          }
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  using Nuclex::Pixels::Storage::Png::PngRowLayout;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decides how the rows of a bitmap in a pixel format are stored in a PNG</summary>
+  /// <param name="pixelFormat">Pixel format of the bitmap that will be saved</param>
+  /// <returns>The PNG color type and the pixel format libpng needs the rows in</returns>
+  /// <remarks>
+  ///   Pixel formats libpng can take as they are are written straight from the bitmap.
+  ///   All others are converted to 8 bit RGBA row by row while saving.
+  /// </remarks>
+  PngRowLayout getRowLayout(Nuclex::Pixels::PixelFormat pixelFormat) {
+    using Nuclex::Pixels::PixelFormat;
+
+    PngRowLayout layout;
+    layout.PixelFormat = pixelFormat;
+    layout.BitDepth = 8;
+    layout.IsBgr = false;
+    layout.IsLittleEndian16 = false;
+
+    switch(pixelFormat) {
+      case PixelFormat::R8_Unsigned: {
+        layout.ColorType = PNG_COLOR_TYPE_GRAY;
+        break;
+      }
+      case PixelFormat::R16_Unsigned_Native16: {
+        layout.ColorType = PNG_COLOR_TYPE_GRAY;
+        layout.BitDepth = 16;
+#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+        layout.IsLittleEndian16 = true;
+#endif
+        break;
+      }
+      case PixelFormat::R8_G8_B8_Unsigned: {
+        layout.ColorType = PNG_COLOR_TYPE_RGB;
+        break;
+      }
+      case PixelFormat::B8_G8_R8_Unsigned: {
+        layout.ColorType = PNG_COLOR_TYPE_RGB;
+        layout.IsBgr = true;
+        break;
+      }
+      case PixelFormat::R8_G8_B8_A8_Unsigned: {
+        layout.ColorType = PNG_COLOR_TYPE_RGB_ALPHA;
+        break;
+      }
+      case PixelFormat::B8_G8_R8_A8_Unsigned: {
+        layout.ColorType = PNG_COLOR_TYPE_RGB_ALPHA;
+        layout.IsBgr = true;
+        break;
+      }
+      default: {
+        layout.PixelFormat = PixelFormat::R8_G8_B8_A8_Unsigned;
+        layout.ColorType = PNG_COLOR_TYPE_RGB_ALPHA;
+        break;
+      }
+    }
+
+    return layout;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the libpng filter flags equivalent to a row filter</summary>
+  /// <param name="filter">Row filter whose libpng flags will be looked up</param>
+  /// <returns>The libpng filter flags for the specified row filter</returns>
+  int getPngFilterFlags(Nuclex::Pixels::Storage::PngRowFilter filter) {
+    using Nuclex::Pixels::Storage::PngRowFilter;
+
+    switch(filter) {
+      case PngRowFilter::None: { return PNG_FILTER_NONE; }
+      case PngRowFilter::Sub: { return PNG_FILTER_SUB; }
+      case PngRowFilter::Up: { return PNG_FILTER_UP; }
+      case PngRowFilter::Average: { return PNG_FILTER_AVG; }
+      case PngRowFilter::Paeth: { return PNG_FILTER_PAETH; }
+      case PngRowFilter::Adaptive: { return PNG_ALL_FILTERS; }
+      default: {
+        throw std::invalid_argument(u8"Unknown PNG row filter");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the zlib strategy equivalent to a compression strategy</summary>
+  /// <param name="strategy">Compression strategy whose zlib equivalent will be looked up</param>
+  /// <returns>The zlib strategy for the specified compression strategy</returns>
+  int getZlibStrategy(Nuclex::Pixels::Storage::PngCompressionStrategy strategy) {
+    using Nuclex::Pixels::Storage::PngCompressionStrategy;
+
+    switch(strategy) {
+      case PngCompressionStrategy::Default: { return Z_DEFAULT_STRATEGY; }
+      case PngCompressionStrategy::Filtered: { return Z_FILTERED; }
+      case PngCompressionStrategy::HuffmanOnly: { return Z_HUFFMAN_ONLY; }
+      case PngCompressionStrategy::RunLength: { return Z_RLE; }
+      case PngCompressionStrategy::Fixed: { return Z_FIXED; }
+      default: {
+        throw std::invalid_argument(u8"Unknown PNG compression strategy");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file header begins like a PNG file</summary>
+  /// <param name="fileHeader">First 16 bytes of the file</param>
+  /// <returns>True if the file header looks like a PNG file header, false otherwise</returns>
+  /// <remarks>
+  ///   Besides the signature, this checks that the first chunk is the IHDR chunk
+  ///   (which the PNG specification demands), so files that only happen to start
+  ///   with the 8 signature bytes are turned away before libpng ever sees them.
+  /// </remarks>
+  bool isPngFileHeader(const std::uint8_t *fileHeader) {
+    const std::uint8_t headerChunkStart[8] = { 0, 0, 0, 13, 'I', 'H', 'D', 'R' };
+    return (
+      (::png_sig_cmp(fileHeader, 0, 8) == 0) &&
+      (std::memcmp(fileHeader + 8, headerChunkStart, 8) == 0)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes the header of a PNG file and prepares libpng for its rows</summary>
+  /// <param name="pngWrite">PNG main structure set up to write the file</param>
+  /// <param name="pngInfo">PNG info structure that will describe the image</param>
+  /// <param name="width">Width of the image in pixels</param>
+  /// <param name="height">Height of the image in pixels</param>
+  /// <param name="rowLayout">Layout in which the rows will be handed to libpng</param>
+  /// <param name="options">Options controlling the compression of the rows</param>
+  void writePngHeader(
+    ::png_struct *pngWrite, ::png_info *pngInfo,
+    std::size_t width, std::size_t height, const PngRowLayout &rowLayout,
+    const Nuclex::Pixels::Storage::PngSaveOptions &options
+  ) {
+    ::png_set_IHDR(
+      pngWrite, pngInfo,
+      static_cast<::png_uint_32>(width), static_cast<::png_uint_32>(height),
+      rowLayout.BitDepth, rowLayout.ColorType,
+      PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT
+    );
+
+    // Trade speed against file size as the caller requested. Skipping the row
+    // filters is what makes the biggest difference for the writing speed.
+    ::png_set_compression_level(pngWrite, options.CompressionLevel);
+    ::png_set_compression_strategy(pngWrite, getZlibStrategy(options.Strategy));
+    ::png_set_filter(pngWrite, PNG_FILTER_TYPE_BASE, getPngFilterFlags(options.Filter));
+
+    ::png_write_info(pngWrite, pngInfo);
+
+    // These transformations have to be set up after the header has been written
+    if(rowLayout.IsBgr) {
+      ::png_set_bgr(pngWrite);
+    }
+    if(rowLayout.IsLittleEndian16) {
+      ::png_set_swap(pngWrite);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file begins with the PNG file signature</summary>
+  /// <param name="source">File whose header will be checked</param>
+  /// <returns>True if the file looks like a PNG file, false otherwise</returns>
+  bool hasPngSignature(const Nuclex::Pixels::Storage::VirtualFile &source) {
+    std::uint64_t fileLength = source.GetSize();
+    if(fileLength < Nuclex::Pixels::Storage::Png::SmallestPossiblePngSize) {
+      return false; // File is too short to be a PNG
+    }
+
+    std::uint8_t fileHeader[16];
+    source.ReadAt(0, 16, fileHeader);
+    return isPngFileHeader(fileHeader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the header of a PNG file without throwing on errors</summary>
+  /// <param name="pngRead">PNG main structure set up to read the file</param>
+  /// <param name="pngInfo">PNG info structure that will receive the header</param>
+  /// <returns>True if the header was read, false if libpng could not read it</returns>
+  /// <remarks>
+  ///   When a directory of mixed files is scanned, files that look like PNGs but are not
+  ///   are common enough that throwing and unwinding an exception for each of them shows.
+  ///   libpng's error handler is therefore set up to longjmp() back here, which is safe
+  ///   because only libpng's own C stack frames and our read function (which holds no
+  ///   objects needing destruction) are skipped. Exceptions thrown by the file itself
+  ///   (i.e. I/O errors) still pass through.
+  /// </remarks>
+  bool tryReadPngInfo(::png_struct *pngRead, ::png_info *pngInfo) {
+    ::png_set_error_fn(pngRead, nullptr, &jumpOnPngError, &handlePngWarning);
+    if(setjmp(png_jmpbuf(pngRead)) != 0) {
+      return false;
+    }
+
+    ::png_read_info(pngRead, pngInfo);
+    ::png_set_error_fn(pngRead, nullptr, &handlePngError, &handlePngWarning);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row source that decodes the rows of a PNG file as they are read</summary>
+  class PngRowSource : public Nuclex::Pixels::RowSource {
+
+    /// <summary>Initializes a new PNG row source reading from the specified file</summary>
+    /// <param name="file">File the PNG image will be read from</param>
+    /// <param name="options">PNG load options controlling how the file is read</param>
+    public: PngRowSource(
+      const Nuclex::Pixels::Storage::VirtualFile &file,
+      const Nuclex::Pixels::Storage::PngLoadOptions &options
+    ) :
+      pngRead(::png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr)),
+      pngInfo(nullptr),
+      width(0),
+      height(0),
+      pixelFormat(Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned),
+      remainingRowCount(0) {
+      if(this->pngRead == nullptr) {
+        throw std::bad_alloc();
+      }
+
+      try {
+        ::png_set_error_fn(this->pngRead, nullptr, &handlePngError, &handlePngWarning);
+        applyChecksumPolicy(this->pngRead, options);
+
+        this->pngInfo = ::png_create_info_struct(this->pngRead);
+        if(this->pngInfo == nullptr) {
+          throw std::bad_alloc();
+        }
+
+        this->environment.reset(
+          new Nuclex::Pixels::Storage::Png::PngReadEnvironment(*this->pngRead, file)
+        );
+      }
+      catch(...) {
+        ::png_destroy_read_struct(&this->pngRead, &this->pngInfo, nullptr);
+        throw;
+      }
+    }
+
+    /// <summary>Frees all libpng structures</summary>
+    public: ~PngRowSource() override {
+      ::png_destroy_read_struct(&this->pngRead, &this->pngInfo, nullptr);
+    }
+
+    /// <summary>Reads the PNG file header and prepares the rows for decoding</summary>
+    /// <returns>True if the header was read, false if libpng could not read it</returns>
+    public: bool TryReadHeader() {
+      using Nuclex::Pixels::Storage::Png::Helpers;
+
+      if(!tryReadPngInfo(this->pngRead, this->pngInfo)) {
+        return false;
+      }
+
+      // Interlaced images deliver the rows in several passes over the whole image,
+      // so any row is only complete once all of the image has been decoded
+      if(::png_get_interlace_type(this->pngRead, this->pngInfo) != PNG_INTERLACE_NONE) {
+        throw Nuclex::Pixels::Errors::FileFormatError(
+          u8"Interlaced PNG files can not be read row by row"
+        );
+      }
+
+      this->width = ::png_get_image_width(this->pngRead, this->pngInfo);
+      this->height = ::png_get_image_height(this->pngRead, this->pngInfo);
+      this->pixelFormat = Helpers::GetEquivalentPixelFormat(*this->pngRead, *this->pngInfo);
+      this->remainingRowCount = this->height;
+
+      std::size_t bytesPerRow = ::png_get_rowbytes(this->pngRead, this->pngInfo);
+      if(bytesPerRow > Nuclex::Pixels::CountRequiredBytes(this->pixelFormat, this->width)) {
+        throw std::runtime_error(u8"libpng row size unexpectedly large, wrong pixel format?");
+      }
+
+      return true;
+    }
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->width; }
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: std::size_t GetHeight() const override { return this->height; }
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->pixelFormat;
+    }
+
+    /// <summary>Decodes the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory that will receive the decoded rows</param>
+    public: void ReadRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      Nuclex::Pixels::RequireFittingRows(
+        rows, this->width, this->pixelFormat, this->remainingRowCount
+      );
+
+      std::uint8_t *row = static_cast<std::uint8_t *>(rows.Pixels);
+      for(std::size_t index = 0; index < rows.Height; ++index) {
+        ::png_read_row(this->pngRead, row, nullptr);
+        row += rows.Stride;
+      }
+
+      this->remainingRowCount -= rows.Height;
+    }
+
+    /// <summary>PNG main structure decoding the file</summary>
+    private: ::png_struct *pngRead;
+    /// <summary>PNG info structure describing the image</summary>
+    private: ::png_info *pngInfo;
+    /// <summary>Lets libpng read from the virtual file</summary>
+    private: std::unique_ptr<Nuclex::Pixels::Storage::Png::PngReadEnvironment> environment;
+    /// <summary>Width of the image in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the image in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Pixel format the rows are decoded in</summary>
+    private: Nuclex::Pixels::PixelFormat pixelFormat;
+    /// <summary>Number of rows that have not been decoded yet</summary>
+    private: std::size_t remainingRowCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row sink that encodes the rows written into it as a PNG file</summary>
+  class PngRowSink : public Nuclex::Pixels::RowSink {
+
+    /// <summary>Initializes a new PNG row sink writing into the specified file</summary>
+    /// <param name="file">File the PNG image will be written into</param>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="pixelFormat">Pixel format the rows will be written in</param>
+    /// <param name="options">Options controlling the compression of the rows</param>
+    public: PngRowSink(
+      Nuclex::Pixels::Storage::VirtualFile &file,
+      std::size_t width, std::size_t height, Nuclex::Pixels::PixelFormat pixelFormat,
+      const Nuclex::Pixels::Storage::PngSaveOptions &options
+    ) :
+      pngWrite(::png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr)),
+      pngInfo(nullptr),
+      width(width),
+      height(height),
+      pixelFormat(pixelFormat),
+      rowLayout(getRowLayout(pixelFormat)),
+      remainingRowCount(height) {
+      if(this->pngWrite == nullptr) {
+        throw std::bad_alloc();
+      }
+
+      try {
+        ::png_set_error_fn(this->pngWrite, nullptr, &handlePngError, &handlePngWarning);
+
+        this->pngInfo = ::png_create_info_struct(this->pngWrite);
+        if(this->pngInfo == nullptr) {
+          throw std::bad_alloc();
+        }
+
+        this->environment.reset(
+          new Nuclex::Pixels::Storage::Png::PngWriteEnvironment(*this->pngWrite, file)
+        );
+        writePngHeader(this->pngWrite, this->pngInfo, width, height, this->rowLayout, options);
+
+        if(this->rowLayout.PixelFormat != pixelFormat) {
+          this->convertedRow.resize(
+            Nuclex::Pixels::CountRequiredBytes(this->rowLayout.PixelFormat, width)
+          );
+        }
+      }
+      catch(...) {
+        ::png_destroy_write_struct(&this->pngWrite, &this->pngInfo);
+        throw;
+      }
+    }
+
+    /// <summary>Frees all libpng structures</summary>
+    public: ~PngRowSink() override {
+      ::png_destroy_write_struct(&this->pngWrite, &this->pngInfo);
+    }
+
+    /// <summary>Retrieves the width of the rows the row sink accepts</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->width; }
+
+    /// <summary>Retrieves the number of rows the row sink accepts in total</summary>
+    /// <returns>The height of the image written into the row sink</returns>
+    public: std::size_t GetHeight() const override { return this->height; }
+
+    /// <summary>Retrieves the pixel format the row sink accepts rows in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->pixelFormat;
+    }
+
+    /// <summary>Encodes the next rows of the image</summary>
+    /// <param name="rows">Bitmap memory holding the rows that will be encoded</param>
+    public: void WriteRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      Nuclex::Pixels::RequireFittingRows(
+        rows, this->width, this->pixelFormat, this->remainingRowCount
+      );
+
+      // Like in Save(), rows libpng can take as they are are passed straight through,
+      // all others are converted into the single row buffer first
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(rows.Pixels);
+      for(std::size_t index = 0; index < rows.Height; ++index) {
+        if(this->convertedRow.empty()) {
+          ::png_write_row(this->pngWrite, row);
+        } else {
+          Nuclex::Pixels::PixelFormatConverter::ConvertRow(
+            this->pixelFormat, row,
+            this->rowLayout.PixelFormat, this->convertedRow.data(),
+            this->width
+          );
+          ::png_write_row(this->pngWrite, this->convertedRow.data());
+        }
+        row += rows.Stride;
+      }
+
+      this->remainingRowCount -= rows.Height;
+      if((rows.Height > 0) && (this->remainingRowCount == 0)) {
+        ::png_write_end(this->pngWrite, this->pngInfo);
+      }
+    }
+
+    /// <summary>PNG main structure encoding the file</summary>
+    private: ::png_struct *pngWrite;
+    /// <summary>PNG info structure describing the image</summary>
+    private: ::png_info *pngInfo;
+    /// <summary>Lets libpng write into the virtual file</summary>
+    private: std::unique_ptr<Nuclex::Pixels::Storage::Png::PngWriteEnvironment> environment;
+    /// <summary>Width of the image in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the image in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Pixel format the rows are written in</summary>
+    private: Nuclex::Pixels::PixelFormat pixelFormat;
+    /// <summary>Layout in which the rows are handed to libpng</summary>
+    private: PngRowLayout rowLayout;
+    /// <summary>Number of rows that have not been written yet</summary>
+    private: std::size_t remainingRowCount;
+    /// <summary>Receives each row if it needs to be converted for libpng</summary>
+    private: std::vector<std::uint8_t> convertedRow;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
@@ -129,24 +1030,28 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
   // ------------------------------------------------------------------------------------------- //
 
   BitmapInfo PngBitmapCodec::TryReadInfo(
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
     (void)extensionHint; // Unused
 
+    // Let libpng only see files that are PNGs. It would report anything else as an error,
+    // but other codecs still need to get their chance to look at the file.
+    if(!hasPngSignature(source)) {
+      BitmapInfo result;
+      result.Loadable = false;
+      return result;
+    }
+
     // Allocate the main LibPNG structure. It contains all pointers to user-defined
     // functions (IO, error handling and custom chunk processing, etc.)
-    ::png_struct *pngRead = ::png_create_read_struct(
-      PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr
-    );
+    ::png_struct *pngRead = createPngReadStruct(*this, options);
     if(pngRead == nullptr) {
       throw std::bad_alloc();
     }
     {
       PngReadScope pngReadScope(pngRead);
 
-      // Go with setjmp()/longjmp() here to avoid exceptions for TryReadInfo()?
-      // Probably better to just add the signature check here
-
       // Install a custom error handler function that simply throws a C++ exception.
       // LibPNG is one of the few C libraries designed to allow exceptions passing through.
       ::png_set_error_fn(pngRead, nullptr, &handlePngError, &handlePngWarning);
@@ -165,13 +1070,24 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
         PngReadEnvironment environment(*pngRead, source);
 
         // Now we're ready for actually accessing a PNG file, attempt to obtain the image's
-        // resolution, pixel format and so on
-        ::png_read_info(pngRead, pngInfo);
+        // resolution, pixel format and so on. A header libpng can not make sense of means
+        // the file is not loadable, which is no reason to throw.
+        if(!tryReadPngInfo(pngRead, pngInfo)) {
+          BitmapInfo result;
+          result.Loadable = false;
+          return result;
+        }
+
+        Rectangle region = GetLoadRegion(
+          options,
+          ::png_get_image_width(pngRead, pngInfo),
+          ::png_get_image_height(pngRead, pngInfo)
+        );
 
         BitmapInfo result;
         result.Loadable = true;
-        result.Width = ::png_get_image_width(pngRead, pngInfo);
-        result.Height = ::png_get_image_height(pngRead, pngInfo);
+        result.Width = region.MaxX - region.MinX;
+        result.Height = region.MaxY - region.MinY;
         result.PixelFormat = Helpers::GetEquivalentPixelFormat(*pngRead, *pngInfo);
         result.MemoryUsage = (
           (CountRequiredBytes(result.PixelFormat, result.Width) * result.Height) +
@@ -186,6 +1102,18 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
 
   // ------------------------------------------------------------------------------------------- //
 
+  bool PngBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    if(fileHeaderByteCount < 16) {
+      return false; // Too short for the PNG signature and the start of the IHDR chunk
+    }
+
+    return isPngFileHeader(fileHeader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   bool PngBitmapCodec::CanLoad(
     const VirtualFile &source, const std::string &extensionHint /* = std::string() */
   ) const {
@@ -219,14 +1147,7 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
     // If the extension indicates a PNG file (or no extension was provided),
     // check the file header to see if this is really a PNG file
     if(mightBePng) {
-      std::size_t fileLength = source.GetSize();
-      if(fileLength >= SmallestPossiblePngSize) {
-        std::uint8_t fileHeader[16];
-        source.ReadAt(0, 16, fileHeader);
-        return (::png_sig_cmp(fileHeader, 0, 16) == 0);
-      } else { // file is too short to be a PNG
-        return false;
-      }
+      return hasPngSignature(source);
     } else { // wrong file extension
       return false;
     }
@@ -236,21 +1157,26 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
   // ------------------------------------------------------------------------------------------- //
 
   bool PngBitmapCodec::CanSave() const {
-    return false; // Still working in this...
+    return true;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   OptionalBitmap PngBitmapCodec::TryLoad(
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.PngBitmapCodec.TryLoad");
     (void)extensionHint;
-    
+
+    // Let libpng only see files that are PNGs, see TryReadInfo()
+    if(!hasPngSignature(source)) {
+      return OptionalBitmap();
+    }
+
     // Allocate the main LibPNG structure. It contains all pointers to user-defined
     // functions (IO, error handling and custom chunk processing, etc.)
-    ::png_struct *pngRead = ::png_create_read_struct(
-      PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr
-    );
+    ::png_struct *pngRead = createPngReadStruct(*this, options);
     if(pngRead == nullptr) {
       throw std::bad_alloc();
     }
@@ -270,6 +1196,22 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
       {
         PngInfoScope pngInfoScope(pngRead, pngInfo);
 
+        // If the caller wants to see rows as they are decoded, push the file through
+        // libpng's progressive reader instead of letting libpng pull the data in.
+        // The same is done for files held in memory since the progressive reader
+        // can be fed from their contents directly without copying them first.
+        // Only whole images are loaded this way, for regions we need to stop early.
+        bool isInMemory = (
+          source.TryGetContiguousSpan(0, static_cast<std::size_t>(source.GetSize())) != nullptr
+        );
+        bool selectsRegion = (
+          (options.Region.MaxX > options.Region.MinX) &&
+          (options.Region.MaxY > options.Region.MinY)
+        );
+        if((options.Png.RowDecoded || isInMemory) && !selectsRegion) {
+          return readProgressively(pngRead, pngInfo, source, options.Png);
+        }
+
         // Install a custom read function. This is used to read data from the virtual
         // file. The read environment emulates a file cursor.
         PngReadEnvironment environment(*pngRead, source);
@@ -282,6 +1224,13 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
         std::size_t height = ::png_get_image_height(pngRead, pngInfo);
         PixelFormat pixelFormat = Helpers::GetEquivalentPixelFormat(*pngRead, *pngInfo);
 
+        if(selectsRegion) {
+          Rectangle region = GetLoadRegion(options, width, height);
+          Bitmap image(region.MaxX - region.MinX, region.MaxY - region.MinY, pixelFormat);
+          readRegion(pngRead, pngInfo, region, image.Access(), options.Png);
+          return OptionalBitmap(std::move(image));
+        }
+
         Bitmap image(width, height, pixelFormat);
         const BitmapMemory &memory = image.Access();
 
@@ -312,22 +1261,251 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
 
   bool PngBitmapCodec::TryReload(
     Bitmap &exactlyFittingBitmap,
-    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint;
+
+    // Let libpng only see files that are PNGs, see TryReadInfo()
+    if(!hasPngSignature(source)) {
+      return false;
+    }
+
+    // Allocate the main LibPNG structure. It contains all pointers to user-defined
+    // functions (IO, error handling and custom chunk processing, etc.)
+    ::png_struct *pngRead = createPngReadStruct(*this, options);
+    if(pngRead == nullptr) {
+      throw std::bad_alloc();
+    }
+    {
+      PngReadScope pngReadScope(pngRead);
+
+      // Install a custom error handler function that simply throws a C++ exception.
+      // LibPNG is one of the few C libraries designed to allow exceptions passing through.
+      ::png_set_error_fn(pngRead, nullptr, &handlePngError, &handlePngWarning);
+
+      // We also need the info structure. This holds all importing informations describing
+      // the image's dimensions, pixel format, palette, gamma etc.
+      ::png_info *pngInfo = ::png_create_info_struct(pngRead);
+      if(pngInfo == nullptr) {
+        throw std::bad_alloc();
+      }
+      {
+        PngInfoScope pngInfoScope(pngRead, pngInfo);
+
+        // Install a custom read function. This is used to read data from the virtual
+        // file. The read environment emulates a file cursor.
+        PngReadEnvironment environment(*pngRead, source);
+
+        // Now we're ready for actually accessing a PNG file, attempt to obtain the image's
+        // resolution, pixel format and so on
+        ::png_read_info(pngRead, pngInfo);
+
+        std::size_t width = ::png_get_image_width(pngRead, pngInfo);
+        std::size_t height = ::png_get_image_height(pngRead, pngInfo);
+        Rectangle region = GetLoadRegion(options, width, height);
+
+        // The bitmap may be a view into a larger bitmap, only its size has to fit
+        const BitmapMemory &memory = exactlyFittingBitmap.Access();
+        bool matchesExpectations = (
+          (memory.Width == region.MaxX - region.MinX) &&
+          (memory.Height == region.MaxY - region.MinY) &&
+          (memory.PixelFormat == Helpers::GetEquivalentPixelFormat(*pngRead, *pngInfo))
+        );
+        if(!matchesExpectations) {
+          throw std::runtime_error(
+            u8"Bitmap provided to Reload() does not have a correct dimensions and pixel format"
+          );
+        }
+
+        // Unless only a region was requested or the caller wants to see rows as they
+        // are decoded, let libpng write all rows straight into the bitmap's memory
+        bool coversWholeImage = (
+          (region.MinX == 0) && (region.MinY == 0) &&
+          (region.MaxX == width) && (region.MaxY == height)
+        );
+        if(!coversWholeImage || options.Png.RowDecoded) {
+          readRegion(pngRead, pngInfo, region, memory, options.Png);
+          return true;
+        }
+
+        std::size_t bytesPerRow = ::png_get_rowbytes(pngRead, pngInfo);
+        if(bytesPerRow > CountRequiredBytes(memory.PixelFormat, memory.Width)) {
+          throw std::runtime_error(u8"libpng row size unexpectedly large, wrong pixel format?");
+        }
+
+        std::vector<::png_byte *> rowAddresses;
+        {
+          rowAddresses.reserve(height);
+
+          std::uint8_t *rowStartPointer = reinterpret_cast<std::uint8_t *>(memory.Pixels);
+          for(std::size_t index = 0; index < height; ++index) {
+            rowAddresses.push_back(rowStartPointer);
+            rowStartPointer += memory.Stride;
+          }
+        }
+
+        ::png_read_image(pngRead, &rowAddresses[0]);
+
+        return true;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PngBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    const PngSaveOptions &pngOptions = options.Png;
+    if((pngOptions.CompressionLevel < 0) || (pngOptions.CompressionLevel > 9)) {
+      throw std::invalid_argument(u8"PNG compression level must be between 0 and 9");
+    }
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"PNG files can not store empty bitmaps");
+    }
+
+    PngRowLayout rowLayout = getRowLayout(memory.PixelFormat);
+
+    // Large images can be filtered and compressed in strips on several threads,
+    // which libpng can't do, so the PNG file is then assembled by our own encoder
+    if(pngOptions.ThreadPool != nullptr) {
+      using Nuclex::Pixels::Storage::Png::ParallelPngEncoder;
+
+      bool useParallelEncoder = (
+        (pngOptions.ThreadPool->CountThreads() > 1) &&
+        ParallelPngEncoder::IsWorthwhile(memory, rowLayout)
+      );
+      if(useParallelEncoder) {
+        ParallelPngEncoder::Encode(*pngOptions.ThreadPool, memory, rowLayout, pngOptions, target);
+        return;
+      }
+    }
+
+    // Allocate the main LibPNG structure. It contains all pointers to user-defined
+    // functions (IO, error handling and custom chunk processing, etc.)
+    ::png_struct *pngWrite = ::png_create_write_struct(
+      PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr
+    );
+    if(pngWrite == nullptr) {
+      throw std::bad_alloc();
+    }
+    {
+      PngWriteScope pngWriteScope(pngWrite);
+
+      // Install a custom error handler function that simply throws a C++ exception.
+      // LibPNG is one of the few C libraries designed to allow exceptions passing through.
+      ::png_set_error_fn(pngWrite, nullptr, &handlePngError, &handlePngWarning);
+
+      // The info structure holds the image's dimensions and pixel format,
+      // which libpng will write into the header of the PNG file
+      ::png_info *pngInfo = ::png_create_info_struct(pngWrite);
+      if(pngInfo == nullptr) {
+        throw std::bad_alloc();
+      }
+      {
+        PngInfoScope pngInfoScope(pngWrite, pngInfo);
+
+        // Install a custom write function. This is used to write data into the virtual
+        // file. The write environment emulates a file cursor.
+        PngWriteEnvironment environment(*pngWrite, target);
+
+        writePngHeader(pngWrite, pngInfo, memory.Width, memory.Height, rowLayout, pngOptions);
+
+        // Hand the rows to libpng one by one. If libpng can deal with the bitmap's
+        // pixel format, the rows are passed straight from the bitmap's memory,
+        // otherwise each row is converted into a single row buffer first.
+        const std::uint8_t *rowStartPointer = static_cast<const std::uint8_t *>(memory.Pixels);
+        if(rowLayout.PixelFormat == memory.PixelFormat) {
+          for(std::size_t index = 0; index < memory.Height; ++index) {
+            ::png_write_row(pngWrite, rowStartPointer);
+            rowStartPointer += memory.Stride;
+          }
+        } else {
+          std::vector<std::uint8_t> convertedRow(
+            CountRequiredBytes(rowLayout.PixelFormat, memory.Width)
+          );
+          for(std::size_t index = 0; index < memory.Height; ++index) {
+            PixelFormatConverter::ConvertRow(
+              memory.PixelFormat, rowStartPointer,
+              rowLayout.PixelFormat, &convertedRow[0],
+              memory.Width
+            );
+            ::png_write_row(pngWrite, &convertedRow[0]);
+            rowStartPointer += memory.Stride;
+          }
+        }
+
+        ::png_write_end(pngWrite, pngInfo);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSource> PngBitmapCodec::TryOpenRowSource(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
   ) const {
-    (void)exactlyFittingBitmap;
-    (void)source;
     (void)extensionHint;
 
-    throw std::runtime_error(u8"Not implemented yet");
+    bool selectsRegion = (
+      (options.Region.MaxX > options.Region.MinX) &&
+      (options.Region.MaxY > options.Region.MinY)
+    );
+    if(selectsRegion) {
+      throw std::invalid_argument(u8"Row sources can not be limited to a region of the image");
+    }
+
+    // Let libpng only see files that are PNGs, see TryReadInfo()
+    if(!hasPngSignature(source)) {
+      return std::unique_ptr<RowSource>();
+    }
+
+    PngRowSource *pngRowSource = new PngRowSource(source, options.Png);
+    std::unique_ptr<RowSource> rowSource(pngRowSource);
+    if(!pngRowSource->TryReadHeader()) {
+      return std::unique_ptr<RowSource>();
+    }
+
+    return rowSource;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void PngBitmapCodec::Save(const Bitmap &bitmap, VirtualFile &target) const {
-    (void)bitmap;
-    (void)target;
+  std::unique_ptr<AnimationReader> PngBitmapCodec::TryOpenAnimation(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint;
+    (void)options;
+
+    if(!hasPngSignature(source)) {
+      return std::unique_ptr<AnimationReader>();
+    }
 
-    throw std::runtime_error(u8"Not implemented yet");
+    return std::unique_ptr<AnimationReader>(new ApngReader(source));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<RowSink> PngBitmapCodec::OpenRowSink(
+    VirtualFile &target, std::size_t width, std::size_t height, PixelFormat pixelFormat,
+    const SaveOptions &options /* = SaveOptions() */
+  ) const {
+    const PngSaveOptions &pngOptions = options.Png;
+    if((pngOptions.CompressionLevel < 0) || (pngOptions.CompressionLevel > 9)) {
+      throw std::invalid_argument(u8"PNG compression level must be between 0 and 9");
+    }
+    if((width == 0) || (height == 0)) {
+      throw std::invalid_argument(u8"PNG files can not store empty bitmaps");
+    }
+
+    return std::unique_ptr<RowSink>(
+      new PngRowSink(target, width, height, pixelFormat, pngOptions)
+    );
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -49,6 +49,14 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
       return this->knownFileExtensions;
     }
 
+    /// <summary>Checks whether a file header looks like it's in the codec's file format</summary>
+    /// <param name="fileHeader">The first bytes of the file that will be checked</param>
+    /// <param name="fileHeaderByteCount">Number of bytes in the file header</param>
+    /// <returns>False if the codec is certain not to be able to load the file</returns>
+    public: bool IsValidFileHeader(
+      const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+    ) const override;
+
     /// <summary>Checks if the codec is able to load the specified file</summary>
     /// <param name="source">Source data that will be checked for loadbility</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
@@ -64,23 +72,27 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
     /// <summary>Tries to read informations for a bitmap</summary>
     /// <param name="source">Source data from which the informations should be extracted</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>
     ///   Informations about the bitmap, if the codec is able to load it, otherwise
     ///   a BitmapInfo structure with 'Loadable' set to false.
     /// </returns>
     public: BitmapInfo TryReadInfo(
-      const VirtualFile &source, const std::string &extensionHint = std::string()
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const override;
 
     /// <summary>Tries to load the specified file as a bitmap</summary>
     /// <param name="source">Source data the bitmap will be loaded from</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>
     ///   The bitmap loaded from the specified file data or an empty value if the file format
     ///   is not supported by the codec
     /// </returns>
     public: virtual OptionalBitmap TryLoad(
-      const VirtualFile &source, const std::string &extensionHint = std::string()
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const override;
 
     /// <summary>Tries to load the specified file into an exciting bitmap</summary>
@@ -89,16 +101,59 @@ namespace Nuclex { namespace Pixels { namespace Storage { namespace Png {
     /// </param>
     /// <param name="source">Source data the bitmap will be loaded from</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>True if the codec was able to load the bitmap, false otherwise</returns>
     public: bool TryReload(
       Bitmap &exactlyFittingBitmap,
-      const VirtualFile &source, const std::string &extensionHint = std::string()
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
     ) const override;
 
     /// <summary>Saves the specified bitmap into a file</summary>
     /// <param name="bitmap">Bitmap that will be saved into a file</param>
     /// <param name="target">File into which the bitmap will be saved</param>
-    public: void Save(const Bitmap &bitmap, VirtualFile &target) const override;
+    /// <param name="options">Settings controlling how the file will be written</param>
+    public: void Save(
+      const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options = SaveOptions()
+    ) const override;
+
+    /// <summary>Tries to open the specified file for reading its rows one by one</summary>
+    /// <param name="source">Source data the rows will be decoded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   A row source decoding the image's rows as they are read or a null pointer if
+    ///   the file is not in the codec's file format
+    /// </returns>
+    public: std::unique_ptr<RowSource> TryOpenRowSource(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to open the specified file for decoding its animation frames</summary>
+    /// <param name="source">Source data the frames will be decoded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   An animation reader decoding the frames of an APNG file (or the single frame
+    ///   of a plain PNG file) or a null pointer if the file is not a PNG file
+    /// </returns>
+    public: std::unique_ptr<AnimationReader> TryOpenAnimation(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Opens a file for writing an image into it row by row</summary>
+    /// <param name="target">File into which the image will be written</param>
+    /// <param name="width">Width of the image in pixels</param>
+    /// <param name="height">Height of the image in pixels</param>
+    /// <param name="pixelFormat">Pixel format the rows will be written in</param>
+    /// <param name="options">Settings controlling how the file will be written</param>
+    /// <returns>A row sink encoding the rows written into it</returns>
+    public: std::unique_ptr<RowSink> OpenRowSink(
+      VirtualFile &target, std::size_t width, std::size_t height, PixelFormat pixelFormat,
+      const SaveOptions &options = SaveOptions()
+    ) const override;
 
     /// <summary>Human-readable name of the file format this codec implements</summary>
     private: std::string name;
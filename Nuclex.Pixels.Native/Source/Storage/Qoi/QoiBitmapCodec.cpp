@@ -0,0 +1,697 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "QoiBitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/PixelFormatTraits.h"
+
+#include "../FileContents.h"
+#include "../../InstrumentationHelpers.h"
+
+#include <cstring> // for std::memset()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the header at the start of each QOI file</summary>
+  const std::size_t QoiHeaderByteCount = 14;
+
+  /// <summary>Bytes that mark the end of the pixel data in a QOI file</summary>
+  const std::uint8_t QoiEndMarker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+  /// <summary>Largest number of pixels the QOI specification allows in an image</summary>
+  const std::uint64_t QoiMaximumPixelCount = 400000000;
+
+  /// <summary>Operation storing the pixel as a full RGB value</summary>
+  const std::uint8_t QoiOpRgb = 0xFE;
+  /// <summary>Operation storing the pixel as a full RGBA value</summary>
+  const std::uint8_t QoiOpRgba = 0xFF;
+  /// <summary>Operation repeating a pixel from the table of recently seen pixels</summary>
+  const std::uint8_t QoiOpIndex = 0x00;
+  /// <summary>Operation storing the pixel as a small difference to the previous one</summary>
+  const std::uint8_t QoiOpDiff = 0x40;
+  /// <summary>Operation storing the pixel as a difference relative to the green channel</summary>
+  const std::uint8_t QoiOpLuma = 0x80;
+  /// <summary>Operation repeating the previous pixel up to 62 times</summary>
+  const std::uint8_t QoiOpRun = 0xC0;
+  /// <summary>Mask for the two bits that identify the short operations</summary>
+  const std::uint8_t QoiOpMask = 0xC0;
+
+  /// <summary>Number of bytes the encoder collects before writing them to the file</summary>
+  const std::size_t QoiWriteBufferByteCount = 65536;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a 32 bit big endian integer from a buffer</summary>
+  /// <param name="bytes">Address of the integer's first byte</param>
+  /// <returns>The integer in native byte order</returns>
+  std::uint32_t readBigEndianUInt32(const std::uint8_t *bytes) {
+    return (
+      (static_cast<std::uint32_t>(bytes[0]) << 24) |
+      (static_cast<std::uint32_t>(bytes[1]) << 16) |
+      (static_cast<std::uint32_t>(bytes[2]) << 8) |
+      static_cast<std::uint32_t>(bytes[3])
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 32 bit big endian integer into a buffer</summary>
+  /// <param name="bytes">Address at which the integer will be written</param>
+  /// <param name="value">Integer that will be written</param>
+  void writeBigEndianUInt32(std::uint8_t *bytes, std::uint32_t value) {
+    bytes[0] = static_cast<std::uint8_t>(value >> 24);
+    bytes[1] = static_cast<std::uint8_t>(value >> 16);
+    bytes[2] = static_cast<std::uint8_t>(value >> 8);
+    bytes[3] = static_cast<std::uint8_t>(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel as it is tracked by the QOI encoder and decoder</summary>
+  struct QoiPixel {
+
+    /// <summary>Checks whether two pixels are identical</summary>
+    /// <param name="other">Other pixel this pixel will be compared to</param>
+    /// <returns>True if the two pixels are identical</returns>
+    public: bool operator ==(const QoiPixel &other) const {
+      return (
+        (this->Red == other.Red) && (this->Green == other.Green) &&
+        (this->Blue == other.Blue) && (this->Alpha == other.Alpha)
+      );
+    }
+
+    /// <summary>Calculates the slot of the pixel in the table of recent pixels</summary>
+    /// <returns>The index of the slot the pixel is remembered in</returns>
+    public: std::size_t GetHash() const {
+      return (
+        (this->Red * 3) + (this->Green * 5) + (this->Blue * 7) + (this->Alpha * 11)
+      ) % 64;
+    }
+
+    /// <summary>Intensity of the pixel's red color channel</summary>
+    public: std::uint8_t Red;
+    /// <summary>Intensity of the pixel's green color channel</summary>
+    public: std::uint8_t Green;
+    /// <summary>Intensity of the pixel's blue color channel</summary>
+    public: std::uint8_t Blue;
+    /// <summary>Opacity of the pixel</summary>
+    public: std::uint8_t Alpha;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Informations stored in the header of a QOI file</summary>
+  struct QoiHeader {
+
+    /// <summary>Width of the image in pixels</summary>
+    public: std::size_t Width;
+    /// <summary>Height of the image in pixels</summary>
+    public: std::size_t Height;
+    /// <summary>Number of channels, 3 for RGB and 4 for RGBA</summary>
+    public: std::size_t ChannelCount;
+
+    /// <summary>Pixel format the image will be loaded in</summary>
+    /// <returns>The pixel format matching the channels stored in the image</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const {
+      if(this->ChannelCount == 4) {
+        return Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned;
+      } else {
+        return Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned;
+      }
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file starts with the QOI file signature</summary>
+  /// <param name="fileHeader">First bytes of the file that will be checked</param>
+  /// <param name="fileHeaderByteCount">Number of bytes available in the file header</param>
+  /// <returns>True if the file starts with the QOI file signature</returns>
+  bool hasQoiSignature(const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount) {
+    return (
+      (fileHeaderByteCount >= 4) &&
+      (fileHeader[0] == 'q') && (fileHeader[1] == 'o') &&
+      (fileHeader[2] == 'i') && (fileHeader[3] == 'f')
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file header looks like a valid QOI file header</summary>
+  /// <param name="fileHeader">First bytes of the file that will be checked</param>
+  /// <param name="fileHeaderByteCount">Number of bytes available in the file header</param>
+  /// <returns>True if the file header is a plausible QOI file header</returns>
+  /// <remarks>
+  ///   The whole QOI header fits into the header sample the bitmap serializer hands to
+  ///   the codecs, so files that only begin with the signature can be turned away
+  ///   without reading from them and without the exception reading them would cause.
+  /// </remarks>
+  bool isQoiFileHeader(const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount) {
+    if(!hasQoiSignature(fileHeader, fileHeaderByteCount)) {
+      return false;
+    }
+    if(fileHeaderByteCount < QoiHeaderByteCount) {
+      return false; // Too short for the header, let alone any pixels
+    }
+
+    return (
+      (readBigEndianUInt32(fileHeader + 4) > 0) &&
+      (readBigEndianUInt32(fileHeader + 8) > 0) &&
+      ((fileHeader[12] == 3) || (fileHeader[12] == 4)) &&
+      (fileHeader[13] <= 1)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tries to read the header of a QOI file</summary>
+  /// <param name="source">File whose header will be read</param>
+  /// <param name="header">Receives the informations stored in the header</param>
+  /// <returns>True if the file was a QOI file, false otherwise</returns>
+  bool tryReadQoiHeader(
+    const Nuclex::Pixels::Storage::VirtualFile &source, QoiHeader &header
+  ) {
+    if(source.GetSize() < QoiHeaderByteCount) {
+      return false;
+    }
+
+    std::uint8_t bytes[QoiHeaderByteCount];
+    source.ReadAt(0, QoiHeaderByteCount, bytes);
+    if(!hasQoiSignature(bytes, QoiHeaderByteCount)) {
+      return false;
+    }
+
+    header.Width = readBigEndianUInt32(bytes + 4);
+    header.Height = readBigEndianUInt32(bytes + 8);
+    header.ChannelCount = bytes[12];
+
+    bool isValid = (
+      (header.Width > 0) && (header.Height > 0) &&
+      ((header.ChannelCount == 3) || (header.ChannelCount == 4)) &&
+      (bytes[13] <= 1) // Color space, 0 is sRGB with linear alpha and 1 is all linear
+    );
+    if(!isValid) {
+      throw Nuclex::Pixels::Errors::FileFormatError(u8"QOI file header is invalid");
+    }
+
+    std::uint64_t pixelCount = static_cast<std::uint64_t>(header.Width) * header.Height;
+    if(pixelCount >= QoiMaximumPixelCount) {
+      throw Nuclex::Pixels::Errors::FileFormatError(u8"QOI image is too large");
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes the pixels of a QOI image into bitmap memory</summary>
+  /// <param name="header">Header of the QOI image that will be decoded</param>
+  /// <param name="contents">Contents of the whole QOI file</param>
+  /// <param name="region">Region of the image that will be decoded</param>
+  /// <param name="memory">Bitmap memory that will receive the decoded region</param>
+  /// <remarks>
+  ///   QOI has to be decoded from the start, but decoding stops after the last row of
+  ///   the region and only the pixels inside the region are stored.
+  /// </remarks>
+  void decodeQoiPixels(
+    const QoiHeader &header, const Nuclex::Pixels::Storage::FileContents &contents,
+    const Nuclex::Pixels::Rectangle &region, const Nuclex::Pixels::BitmapMemory &memory
+  ) {
+    const std::uint8_t *data = contents.GetData() + QoiHeaderByteCount;
+    const std::uint8_t *dataEnd = contents.GetData() + contents.GetSize();
+
+    std::size_t regionMinX = static_cast<std::size_t>(region.MinX);
+    std::size_t regionMaxX = static_cast<std::size_t>(region.MaxX);
+    std::size_t regionMinY = static_cast<std::size_t>(region.MinY);
+    std::size_t regionMaxY = static_cast<std::size_t>(region.MaxY);
+    std::size_t channelCount = header.ChannelCount;
+
+    QoiPixel recentPixels[64];
+    std::memset(recentPixels, 0, sizeof(recentPixels));
+    QoiPixel pixel = { 0, 0, 0, 255 };
+    std::size_t runLength = 0;
+
+    for(std::size_t y = 0; y < regionMaxY; ++y) {
+      std::uint8_t *row = nullptr;
+      if(y >= regionMinY) {
+        row = static_cast<std::uint8_t *>(memory.Pixels) + (
+          static_cast<std::ptrdiff_t>(memory.Stride) *
+          static_cast<std::ptrdiff_t>(y - regionMinY)
+        );
+      }
+
+      for(std::size_t x = 0; x < header.Width; ++x) {
+        if(runLength > 0) {
+          --runLength;
+        } else {
+          if(data >= dataEnd) {
+            throw Nuclex::Pixels::Errors::FileFormatError(u8"QOI file is truncated");
+          }
+
+          std::uint8_t operation = *data++;
+          if(operation == QoiOpRgb) {
+            if(dataEnd - data < 3) {
+              throw Nuclex::Pixels::Errors::FileFormatError(u8"QOI file is truncated");
+            }
+            pixel.Red = data[0];
+            pixel.Green = data[1];
+            pixel.Blue = data[2];
+            data += 3;
+          } else if(operation == QoiOpRgba) {
+            if(dataEnd - data < 4) {
+              throw Nuclex::Pixels::Errors::FileFormatError(u8"QOI file is truncated");
+            }
+            pixel.Red = data[0];
+            pixel.Green = data[1];
+            pixel.Blue = data[2];
+            pixel.Alpha = data[3];
+            data += 4;
+          } else {
+            switch(operation & QoiOpMask) {
+              case QoiOpIndex: {
+                pixel = recentPixels[operation];
+                break;
+              }
+              case QoiOpDiff: {
+                pixel.Red += static_cast<std::uint8_t>(((operation >> 4) & 3) - 2);
+                pixel.Green += static_cast<std::uint8_t>(((operation >> 2) & 3) - 2);
+                pixel.Blue += static_cast<std::uint8_t>((operation & 3) - 2);
+                break;
+              }
+              case QoiOpLuma: {
+                if(data >= dataEnd) {
+                  throw Nuclex::Pixels::Errors::FileFormatError(u8"QOI file is truncated");
+                }
+                int greenDifference = static_cast<int>(operation & 0x3F) - 32;
+                std::uint8_t redAndBlue = *data++;
+                pixel.Red += static_cast<std::uint8_t>(
+                  greenDifference + static_cast<int>(redAndBlue >> 4) - 8
+                );
+                pixel.Green += static_cast<std::uint8_t>(greenDifference);
+                pixel.Blue += static_cast<std::uint8_t>(
+                  greenDifference + static_cast<int>(redAndBlue & 0x0F) - 8
+                );
+                break;
+              }
+              default: { // QoiOpRun
+                runLength = operation & 0x3F;
+                break;
+              }
+            }
+          }
+
+          recentPixels[pixel.GetHash()] = pixel;
+        }
+
+        if((row != nullptr) && (x >= regionMinX) && (x < regionMaxX)) {
+          std::uint8_t *target = row + ((x - regionMinX) * channelCount);
+          target[0] = pixel.Red;
+          target[1] = pixel.Green;
+          target[2] = pixel.Blue;
+          if(channelCount == 4) {
+            target[3] = pixel.Alpha;
+          }
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects the bytes produced by the QOI encoder and writes them to a file</summary>
+  class QoiWriter {
+
+    /// <summary>Initializes a new QOI writer for the specified file</summary>
+    /// <param name="target">File the writer will write into</param>
+    public: explicit QoiWriter(Nuclex::Pixels::Storage::VirtualFile &target) :
+      target(target),
+      position(0),
+      buffer(QoiWriteBufferByteCount),
+      used(0) {}
+
+    /// <summary>Appends a byte to the file</summary>
+    /// <param name="value">Byte that will be appended</param>
+    public: void Write(std::uint8_t value) {
+      if(this->used == this->buffer.size()) {
+        Flush();
+      }
+      this->buffer[this->used++] = value;
+    }
+
+    /// <summary>Appends multiple bytes to the file</summary>
+    /// <param name="bytes">Bytes that will be appended</param>
+    /// <param name="count">Number of bytes that will be appended</param>
+    public: void Write(const std::uint8_t *bytes, std::size_t count) {
+      for(std::size_t index = 0; index < count; ++index) {
+        Write(bytes[index]);
+      }
+    }
+
+    /// <summary>Writes all collected bytes to the file</summary>
+    public: void Flush() {
+      if(this->used > 0) {
+        this->target.WriteAt(this->position, this->used, &this->buffer[0]);
+        this->position += this->used;
+        this->used = 0;
+      }
+    }
+
+    /// <summary>File the collected bytes will be written to</summary>
+    private: Nuclex::Pixels::Storage::VirtualFile &target;
+    /// <summary>Offset in the file at which the next bytes will be written</summary>
+    private: std::uint64_t position;
+    /// <summary>Bytes collected so far</summary>
+    private: std::vector<std::uint8_t> buffer;
+    /// <summary>Number of bytes in the buffer</summary>
+    private: std::size_t used;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes a row of pixels, continuing the state left by the previous row</summary>
+  /// <param name="writer">Writer that will receive the encoded bytes</param>
+  /// <param name="pixels">8 bit RGB or RGBA pixels that will be encoded</param>
+  /// <param name="pixelCount">Number of pixels in the row</param>
+  /// <param name="channelCount">Number of channels per pixel, 3 or 4</param>
+  /// <param name="recentPixels">Table of recently seen pixels</param>
+  /// <param name="previous">Previously encoded pixel</param>
+  /// <param name="runLength">Number of repetitions of the previous pixel not yet written</param>
+  void encodeQoiRow(
+    QoiWriter &writer, const std::uint8_t *pixels, std::size_t pixelCount,
+    std::size_t channelCount, QoiPixel *recentPixels, QoiPixel &previous,
+    std::size_t &runLength
+  ) {
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      const std::uint8_t *source = pixels + (index * channelCount);
+      QoiPixel pixel = {
+        source[0], source[1], source[2], (channelCount == 4) ? source[3] : previous.Alpha
+      };
+
+      if(pixel == previous) {
+        ++runLength;
+        if(runLength == 62) {
+          writer.Write(static_cast<std::uint8_t>(QoiOpRun | (runLength - 1)));
+          runLength = 0;
+        }
+        continue;
+      }
+
+      if(runLength > 0) {
+        writer.Write(static_cast<std::uint8_t>(QoiOpRun | (runLength - 1)));
+        runLength = 0;
+      }
+
+      std::size_t hash = pixel.GetHash();
+      if(recentPixels[hash] == pixel) {
+        writer.Write(static_cast<std::uint8_t>(QoiOpIndex | hash));
+      } else {
+        recentPixels[hash] = pixel;
+
+        if(pixel.Alpha == previous.Alpha) {
+          int redDifference = static_cast<std::int8_t>(pixel.Red - previous.Red);
+          int greenDifference = static_cast<std::int8_t>(pixel.Green - previous.Green);
+          int blueDifference = static_cast<std::int8_t>(pixel.Blue - previous.Blue);
+          int redToGreen = redDifference - greenDifference;
+          int blueToGreen = blueDifference - greenDifference;
+
+          bool fitsDiff = (
+            (redDifference >= -2) && (redDifference <= 1) &&
+            (greenDifference >= -2) && (greenDifference <= 1) &&
+            (blueDifference >= -2) && (blueDifference <= 1)
+          );
+          bool fitsLuma = (
+            (greenDifference >= -32) && (greenDifference <= 31) &&
+            (redToGreen >= -8) && (redToGreen <= 7) &&
+            (blueToGreen >= -8) && (blueToGreen <= 7)
+          );
+          if(fitsDiff) {
+            writer.Write(
+              static_cast<std::uint8_t>(
+                QoiOpDiff |
+                ((redDifference + 2) << 4) | ((greenDifference + 2) << 2) | (blueDifference + 2)
+              )
+            );
+          } else if(fitsLuma) {
+            writer.Write(static_cast<std::uint8_t>(QoiOpLuma | (greenDifference + 32)));
+            writer.Write(static_cast<std::uint8_t>(((redToGreen + 8) << 4) | (blueToGreen + 8)));
+          } else {
+            writer.Write(QoiOpRgb);
+            writer.Write(pixel.Red);
+            writer.Write(pixel.Green);
+            writer.Write(pixel.Blue);
+          }
+        } else {
+          writer.Write(QoiOpRgba);
+          writer.Write(pixel.Red);
+          writer.Write(pixel.Green);
+          writer.Write(pixel.Blue);
+          writer.Write(pixel.Alpha);
+        }
+      }
+
+      previous = pixel;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Qoi {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  QoiBitmapCodec::QoiBitmapCodec() :
+    name(u8"Quite OK Image (.qoi)") {
+    this->knownFileExtensions.push_back(u8"qoi");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool QoiBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    return isQoiFileHeader(fileHeader, fileHeaderByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool QoiBitmapCodec::CanLoad(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+  ) const {
+
+    // If a file extension is offered, do an early exit if it doesn't match
+    if(!MightHaveFileExtension(extensionHint, this->knownFileExtensions)) {
+      return false;
+    }
+
+    if(source.GetSize() < QoiHeaderByteCount) {
+      return false;
+    }
+
+    std::uint8_t fileHeader[4];
+    source.ReadAt(0, 4, fileHeader);
+    return hasQoiSignature(fileHeader, 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool QoiBitmapCodec::CanSave() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapInfo QoiBitmapCodec::TryReadInfo(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint; // Unused
+
+    QoiHeader header;
+    if(!tryReadQoiHeader(source, header)) {
+      BitmapInfo result;
+      result.Loadable = false;
+      return result;
+    }
+
+    Rectangle region = GetLoadRegion(options, header.Width, header.Height);
+
+    BitmapInfo result;
+    result.Loadable = true;
+    result.Width = region.MaxX - region.MinX;
+    result.Height = region.MaxY - region.MinY;
+    result.PixelFormat = header.GetPixelFormat();
+    result.MemoryUsage = (
+      (CountRequiredBytes(result.PixelFormat, result.Width) * result.Height) +
+      (sizeof(std::intptr_t) * 3) +
+      (sizeof(std::size_t) * 3) +
+      (sizeof(int) * 2)
+    );
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OptionalBitmap QoiBitmapCodec::TryLoad(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.QoiBitmapCodec.TryLoad");
+    (void)extensionHint; // Unused
+
+    QoiHeader header;
+    if(!tryReadQoiHeader(source, header)) {
+      return OptionalBitmap();
+    }
+
+    Rectangle region = GetLoadRegion(options, header.Width, header.Height);
+    Bitmap image(region.MaxX - region.MinX, region.MaxY - region.MinY, header.GetPixelFormat());
+
+    FileContents contents(source);
+    decodeQoiPixels(header, contents, region, image.Access());
+
+    return OptionalBitmap(std::move(image));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool QoiBitmapCodec::TryReload(
+    Bitmap &exactlyFittingBitmap,
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint; // Unused
+
+    QoiHeader header;
+    if(!tryReadQoiHeader(source, header)) {
+      return false;
+    }
+
+    Rectangle region = GetLoadRegion(options, header.Width, header.Height);
+
+    // The bitmap may be a view into a larger bitmap, only its size has to fit
+    const BitmapMemory &memory = exactlyFittingBitmap.Access();
+    bool matchesExpectations = (
+      (memory.Width == region.MaxX - region.MinX) &&
+      (memory.Height == region.MaxY - region.MinY) &&
+      (memory.PixelFormat == header.GetPixelFormat())
+    );
+    if(!matchesExpectations) {
+      throw std::runtime_error(
+        u8"Bitmap provided to Reload() does not have a correct dimensions and pixel format"
+      );
+    }
+
+    FileContents contents(source);
+    decodeQoiPixels(header, contents, region, memory);
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void QoiBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options /* = SaveOptions() */
+  ) const {
+    (void)options; // Unused
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"QOI files can not store empty bitmaps");
+    }
+    if(
+      (memory.Width > 0xFFFFFFFF) || (memory.Height > 0xFFFFFFFF) ||
+      (static_cast<std::uint64_t>(memory.Width) * memory.Height >= QoiMaximumPixelCount)
+    ) {
+      throw std::invalid_argument(u8"Bitmap is too large to be stored in a QOI file");
+    }
+
+    // QOI only stores 8 bit RGB and RGBA. Bitmaps in either of these pixel formats are
+    // encoded directly, all others are converted one row at a time.
+    bool hasAlpha = (Private::DescribePixelFormat(memory.PixelFormat).BitCounts[3] > 0);
+    PixelFormat storedPixelFormat = (
+      hasAlpha ? PixelFormat::R8_G8_B8_A8_Unsigned : PixelFormat::R8_G8_B8_Unsigned
+    );
+    std::size_t channelCount = hasAlpha ? 4 : 3;
+
+    std::vector<std::uint8_t> convertedRow;
+    if(memory.PixelFormat != storedPixelFormat) {
+      convertedRow.resize(memory.Width * channelCount);
+    }
+
+    QoiWriter writer(target);
+    {
+      std::uint8_t header[QoiHeaderByteCount];
+      header[0] = 'q';
+      header[1] = 'o';
+      header[2] = 'i';
+      header[3] = 'f';
+      writeBigEndianUInt32(header + 4, static_cast<std::uint32_t>(memory.Width));
+      writeBigEndianUInt32(header + 8, static_cast<std::uint32_t>(memory.Height));
+      header[12] = static_cast<std::uint8_t>(channelCount);
+      header[13] = 0; // sRGB with linear alpha
+      writer.Write(header, QoiHeaderByteCount);
+    }
+
+    QoiPixel recentPixels[64];
+    std::memset(recentPixels, 0, sizeof(recentPixels));
+    QoiPixel previous = { 0, 0, 0, 255 };
+    std::size_t runLength = 0;
+
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(memory.Pixels) + (
+        static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+      );
+      if(!convertedRow.empty()) {
+        PixelFormatConverter::ConvertRow(
+          memory.PixelFormat, row, storedPixelFormat, &convertedRow[0], memory.Width
+        );
+        row = &convertedRow[0];
+      }
+
+      encodeQoiRow(
+        writer, row, memory.Width, channelCount, recentPixels, previous, runLength
+      );
+    }
+
+    if(runLength > 0) {
+      writer.Write(static_cast<std::uint8_t>(QoiOpRun | (runLength - 1)));
+    }
+    writer.Write(QoiEndMarker, sizeof(QoiEndMarker));
+    writer.Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Qoi
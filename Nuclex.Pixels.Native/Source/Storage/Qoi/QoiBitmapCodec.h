@@ -0,0 +1,133 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_QOI_QOIBITMAPCODEC_H
+#define NUCLEX_PIXELS_STORAGE_QOI_QOIBITMAPCODEC_H
+
+#include "Nuclex/Pixels/Config.h"
+
+#include "Nuclex/Pixels/Storage/BitmapCodec.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Qoi {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads and saves images in the lossless QOI file format</summary>
+  /// <remarks>
+  ///   QOI (the "Quite OK Image" format) compresses a little worse than PNG, but encodes
+  ///   and decodes many times faster. Images are stored as 8 bit RGB or RGBA.
+  /// </remarks>
+  class QoiBitmapCodec : public BitmapCodec {
+
+    /// <summary>Initializes a new QOI bitmap codec</summary>
+    public: QoiBitmapCodec();
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~QoiBitmapCodec() = default;
+
+    /// <summary>Gives the name of the file format implemented by this codec</summary>
+    /// <returns>The name of the file format this codec implements</returns>
+    public: const std::string &GetName() const override { return this->name; }
+
+    /// <summary>Provides commonly used file extensions for this codec</summary>
+    /// <returns>The commonly used file extensions in order of preference</returns>
+    public: const std::vector<std::string> &GetFileExtensions() const override {
+      return this->knownFileExtensions;
+    }
+
+    /// <summary>Checks whether a file header looks like it's in the codec's file format</summary>
+    /// <param name="fileHeader">The first bytes of the file that will be checked</param>
+    /// <param name="fileHeaderByteCount">Number of bytes in the file header</param>
+    /// <returns>False if the codec is certain not to be able to load the file</returns>
+    public: bool IsValidFileHeader(
+      const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+    ) const override;
+
+    /// <summary>Checks if the codec is able to load the specified file</summary>
+    /// <param name="source">Source data that will be checked for loadbility</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <returns>True if the codec is able to load the specified file</returns>
+    public: bool CanLoad(
+      const VirtualFile &source, const std::string &extensionHint = std::string()
+    ) const override;
+
+    /// <summary>Checks if the codec is able to save bitmaps to storage</summary>
+    /// <returns>True if the codec supports saving bitmaps</returns>
+    public: bool CanSave() const override;
+
+    /// <summary>Tries to read informations for a bitmap</summary>
+    /// <param name="source">Source data from which the informations should be extracted</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   Informations about the bitmap, if the codec is able to load it, otherwise
+    ///   a BitmapInfo structure with 'Loadable' set to false.
+    /// </returns>
+    public: BitmapInfo TryReadInfo(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to load the specified file as a bitmap</summary>
+    /// <param name="source">Source data the bitmap will be loaded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   The bitmap loaded from the specified file data or an empty value if the file format
+    ///   is not supported by the codec
+    /// </returns>
+    public: OptionalBitmap TryLoad(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to load the specified file into an exciting bitmap</summary>
+    /// <param name="exactlyFittingBitmap">
+    ///   Bitmap matching the exact dimensions of the file to be loaded
+    /// </param>
+    /// <param name="source">Source data the bitmap will be loaded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>True if the codec was able to load the bitmap, false otherwise</returns>
+    public: bool TryReload(
+      Bitmap &exactlyFittingBitmap,
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Saves the specified bitmap into a file</summary>
+    /// <param name="bitmap">Bitmap that will be saved into a file</param>
+    /// <param name="target">File into which the bitmap will be saved</param>
+    /// <param name="options">Settings controlling how the file will be written</param>
+    public: void Save(
+      const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options = SaveOptions()
+    ) const override;
+
+    /// <summary>Human-readable name of the file format this codec implements</summary>
+    private: std::string name;
+    /// <summary>File extensions this file format is known to use</summary>
+    private: std::vector<std::string> knownFileExtensions;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Qoi
+
+#endif // NUCLEX_PIXELS_STORAGE_QOI_QOIBITMAPCODEC_H
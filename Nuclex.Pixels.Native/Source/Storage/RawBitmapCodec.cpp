@@ -0,0 +1,258 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "RawBitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "../InstrumentationHelpers.h"
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the address of a row in bitmap memory</summary>
+  /// <param name="memory">Bitmap memory containing the row</param>
+  /// <param name="y">Index of the row whose address will be calculated</param>
+  /// <returns>The address of the row's first pixel</returns>
+  std::uint8_t *getRowAddress(const Nuclex::Pixels::BitmapMemory &memory, std::size_t y) {
+    return static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool RawBitmapCodec::CanLoad(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+  ) const {
+
+    // If a file extension is offered, do an early exit if it doesn't match
+    if(!MightHaveFileExtension(extensionHint, GetFileExtensions())) {
+      return false;
+    }
+
+    RawImageLayout layout;
+    return TryReadLayout(source, layout);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapInfo RawBitmapCodec::TryReadInfo(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint; // Unused
+
+    RawImageLayout layout;
+    if(!TryReadLayout(source, layout)) {
+      BitmapInfo result;
+      result.Loadable = false;
+      return result;
+    }
+
+    Rectangle region = GetLoadRegion(options, layout.Width, layout.Height);
+
+    BitmapInfo result;
+    result.Loadable = true;
+    result.Width = region.MaxX - region.MinX;
+    result.Height = region.MaxY - region.MinY;
+    result.PixelFormat = layout.PixelFormat;
+    result.MemoryUsage = (
+      (CountRequiredBytes(result.PixelFormat, result.Width) * result.Height) +
+      (sizeof(std::intptr_t) * 3) +
+      (sizeof(std::size_t) * 3) +
+      (sizeof(int) * 2)
+    );
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OptionalBitmap RawBitmapCodec::TryLoad(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.RawBitmapCodec.TryLoad");
+    RawImageLayout layout;
+    if(!TryReadLayout(source, layout)) {
+      return OptionalBitmap();
+    }
+
+    Rectangle region = GetLoadRegion(options, layout.Width, layout.Height);
+    Bitmap image(region.MaxX - region.MinX, region.MaxY - region.MinY, layout.PixelFormat);
+    if(!TryReload(image, source, extensionHint, options)) {
+      throw std::runtime_error(u8"File changed while it was being loaded");
+    }
+
+    return OptionalBitmap(std::move(image));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool RawBitmapCodec::TryReload(
+    Bitmap &exactlyFittingBitmap,
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint; // Unused
+
+    RawImageLayout layout;
+    if(!TryReadLayout(source, layout)) {
+      return false;
+    }
+
+    Rectangle region = GetLoadRegion(options, layout.Width, layout.Height);
+
+    // The bitmap may be a view into a larger bitmap, only its size has to fit
+    const BitmapMemory &memory = exactlyFittingBitmap.Access();
+    bool matchesExpectations = (
+      (memory.Width == region.MaxX - region.MinX) &&
+      (memory.Height == region.MaxY - region.MinY) &&
+      (memory.PixelFormat == layout.PixelFormat)
+    );
+    if(!matchesExpectations) {
+      throw std::runtime_error(
+        u8"Bitmap provided to Reload() does not have a correct dimensions and pixel format"
+      );
+    }
+
+    std::size_t regionOffset = layout.StoredBytesPerPixel * region.MinX;
+    std::size_t regionRowByteCount = layout.StoredBytesPerPixel * memory.Width;
+
+    // If the stored rows are laid out exactly like the bitmap's rows, read all of them
+    // in one go. This is what makes loading a scratch file as fast as a memcpy. Rows
+    // with gaps between them are excluded because the bitmap may be a view whose gaps
+    // belong to the pixels of another bitmap.
+    bool canReadAllRowsAtOnce = (
+      !layout.NeedsTransform &&
+      !layout.IsBottomUp &&
+      (regionRowByteCount == layout.RowPitch) &&
+      (memory.Stride > 0) &&
+      (static_cast<std::size_t>(memory.Stride) == layout.RowPitch)
+    );
+    if(canReadAllRowsAtOnce) {
+      source.ReadAt(
+        layout.Offset + (layout.RowPitch * region.MinY) + regionOffset,
+        (layout.RowPitch * (memory.Height - 1)) + regionRowByteCount,
+        static_cast<std::uint8_t *>(memory.Pixels)
+      );
+      return true;
+    }
+
+    std::vector<std::uint8_t> storedRow;
+    if(layout.NeedsTransform) {
+      storedRow.resize(regionRowByteCount);
+    }
+
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::size_t storedY = region.MinY + y;
+      if(layout.IsBottomUp) {
+        storedY = layout.Height - storedY - 1;
+      }
+
+      std::uint64_t storedRowOffset = layout.Offset + (layout.RowPitch * storedY) + regionOffset;
+      if(layout.NeedsTransform) {
+        source.ReadAt(storedRowOffset, regionRowByteCount, &storedRow[0]);
+        TransformRow(layout, &storedRow[0], getRowAddress(memory, y), memory.Width);
+      } else {
+        source.ReadAt(storedRowOffset, regionRowByteCount, getRowAddress(memory, y));
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RawBitmapCodec::TransformRow(
+    const RawImageLayout &layout, const std::uint8_t *storedPixels, void *pixels,
+    std::size_t pixelCount
+  ) const {
+    (void)layout;
+    (void)storedPixels;
+    (void)pixels;
+    (void)pixelCount;
+    throw std::logic_error(u8"Codec requested a row transform but doesn't implement one");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RawBitmapCodec::WriteRows(
+    const BitmapMemory &memory, VirtualFile &target, std::uint64_t offset,
+    PixelFormat storedPixelFormat, std::size_t rowPitch, bool isBottomUp
+  ) {
+    std::size_t rowByteCount = CountRequiredBytes(storedPixelFormat, memory.Width);
+
+    // If the bitmap's rows are laid out exactly like the stored rows will be,
+    // write all of them in one go
+    bool canWriteAllRowsAtOnce = (
+      (memory.PixelFormat == storedPixelFormat) &&
+      !isBottomUp &&
+      (memory.Stride > 0) &&
+      (static_cast<std::size_t>(memory.Stride) == rowPitch)
+    );
+    if(canWriteAllRowsAtOnce) {
+      target.WriteAt(
+        offset,
+        (rowPitch * (memory.Height - 1)) + rowByteCount,
+        static_cast<const std::uint8_t *>(memory.Pixels)
+      );
+      if(rowPitch > rowByteCount) { // Pad the last row as well
+        std::vector<std::uint8_t> padding(rowPitch - rowByteCount, 0);
+        target.WriteAt(
+          offset + (rowPitch * (memory.Height - 1)) + rowByteCount, padding.size(), &padding[0]
+        );
+      }
+      return;
+    }
+
+    // Otherwise assemble each row, converted and padded, in a buffer and write that
+    std::vector<std::uint8_t> storedRow(rowPitch, 0);
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const std::uint8_t *row = getRowAddress(memory, isBottomUp ? (memory.Height - y - 1) : y);
+      if(memory.PixelFormat == storedPixelFormat) {
+        std::copy(row, row + rowByteCount, storedRow.begin());
+      } else {
+        PixelFormatConverter::ConvertRow(
+          memory.PixelFormat, row, storedPixelFormat, &storedRow[0], memory.Width
+        );
+      }
+
+      target.WriteAt(offset + (rowPitch * y), rowPitch, &storedRow[0]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
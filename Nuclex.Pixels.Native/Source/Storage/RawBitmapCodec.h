@@ -0,0 +1,176 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_RAWBITMAPCODEC_H
+#define NUCLEX_PIXELS_STORAGE_RAWBITMAPCODEC_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/BitmapCodec.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes where the rows of an uncompressed image are stored in a file</summary>
+  struct RawImageLayout {
+
+    /// <summary>Width of the image in pixels</summary>
+    public: std::size_t Width;
+    /// <summary>Height of the image in pixels</summary>
+    public: std::size_t Height;
+    /// <summary>Pixel format the image will be loaded in</summary>
+    public: enum PixelFormat PixelFormat;
+    /// <summary>Offset of the first stored row from the start of the file</summary>
+    public: std::uint64_t Offset;
+    /// <summary>Number of bytes each pixel occupies in the file</summary>
+    public: std::size_t StoredBytesPerPixel;
+    /// <summary>Number of bytes from the start of one stored row to the next</summary>
+    public: std::size_t RowPitch;
+    /// <summary>Whether the rows are stored starting with the bottommost one</summary>
+    public: bool IsBottomUp;
+    /// <summary>Whether stored rows need to be passed through TransformRow()</summary>
+    /// <remarks>
+    ///   If not set, the stored pixels already are in the layout's pixel format
+    ///   and the rows are read straight into the bitmap.
+    /// </remarks>
+    public: bool NeedsTransform;
+    /// <summary>Whether the words in the stored pixels use the opposite byte order</summary>
+    /// <remarks>
+    ///   Only for codecs that transform rows, the stored rows are otherwise read as they are.
+    /// </remarks>
+    public: bool HasFlippedWords;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Base class for codecs of trivial, uncompressed file formats</summary>
+  /// <remarks>
+  ///   These formats are meant for scratch files that only live between processing steps,
+  ///   where saving and loading should take no longer than copying the pixels. Whenever
+  ///   the stored rows match the bitmap's rows, the whole image is read with a single
+  ///   <see cref="VirtualFile.ReadAt" />, which for memory-mapped files is a memcpy.
+  /// </remarks>
+  class RawBitmapCodec : public BitmapCodec {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~RawBitmapCodec() = default;
+
+    /// <summary>Checks if the codec is able to load the specified file</summary>
+    /// <param name="source">Source data that will be checked for loadbility</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <returns>True if the codec is able to load the specified file</returns>
+    public: bool CanLoad(
+      const VirtualFile &source, const std::string &extensionHint = std::string()
+    ) const override;
+
+    /// <summary>Tries to read informations for a bitmap</summary>
+    /// <param name="source">Source data from which the informations should be extracted</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   Informations about the bitmap, if the codec is able to load it, otherwise
+    ///   a BitmapInfo structure with 'Loadable' set to false.
+    /// </returns>
+    public: BitmapInfo TryReadInfo(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to load the specified file as a bitmap</summary>
+    /// <param name="source">Source data the bitmap will be loaded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   The bitmap loaded from the specified file data or an empty value if the file format
+    ///   is not supported by the codec
+    /// </returns>
+    public: OptionalBitmap TryLoad(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to load the specified file into an exciting bitmap</summary>
+    /// <param name="exactlyFittingBitmap">
+    ///   Bitmap matching the exact dimensions of the file to be loaded
+    /// </param>
+    /// <param name="source">Source data the bitmap will be loaded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>True if the codec was able to load the bitmap, false otherwise</returns>
+    public: bool TryReload(
+      Bitmap &exactlyFittingBitmap,
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to locate the rows of the image in a file</summary>
+    /// <param name="source">File in which the rows will be located</param>
+    /// <param name="layout">Receives the dimensions and location of the rows</param>
+    /// <returns>True if the file was in the codec's file format, false otherwise</returns>
+    /// <remarks>
+    ///   Like <see cref="TryLoad" />, this should only return false if the file is in
+    ///   a different file format. Corrupt or unsupported files must cause an exception.
+    /// </remarks>
+    protected: virtual bool TryReadLayout(
+      const VirtualFile &source, RawImageLayout &layout
+    ) const = 0;
+
+    /// <summary>Turns pixels as stored in the file into the layout's pixel format</summary>
+    /// <param name="layout">Layout of the image the pixels belong to</param>
+    /// <param name="storedPixels">Pixels as they are stored in the file</param>
+    /// <param name="pixels">Receives the pixels in the layout's pixel format</param>
+    /// <param name="pixelCount">Number of pixels that will be transformed</param>
+    /// <remarks>
+    ///   Only called for layouts that have <see cref="RawImageLayout.NeedsTransform" /> set.
+    /// </remarks>
+    protected: virtual void TransformRow(
+      const RawImageLayout &layout, const std::uint8_t *storedPixels, void *pixels,
+      std::size_t pixelCount
+    ) const;
+
+    /// <summary>Writes the rows of a bitmap into a file</summary>
+    /// <param name="memory">Bitmap memory whose rows will be written</param>
+    /// <param name="target">File the rows will be written into</param>
+    /// <param name="offset">Offset in the file at which the first stored row begins</param>
+    /// <param name="storedPixelFormat">Pixel format the rows will be stored in</param>
+    /// <param name="rowPitch">
+    ///   Number of bytes from one stored row to the next, rows are padded with zeros
+    /// </param>
+    /// <param name="isBottomUp">Whether the bottommost row will be stored first</param>
+    /// <remarks>
+    ///   If the bitmap's pixel format differs from the stored pixel format, each row
+    ///   is converted while it's being written.
+    /// </remarks>
+    protected: static void WriteRows(
+      const BitmapMemory &memory, VirtualFile &target, std::uint64_t offset,
+      PixelFormat storedPixelFormat, std::size_t rowPitch, bool isBottomUp
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_RAWBITMAPCODEC_H
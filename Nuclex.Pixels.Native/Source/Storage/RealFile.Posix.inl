@@ -26,6 +26,7 @@ License along with this library
 #include <cerrno> // errno
 #include <cstring> // strerror()
 #include <sys/stat.h> // stat()
+#include <fcntl.h> // posix_fadvise()
 #endif
 
 namespace {
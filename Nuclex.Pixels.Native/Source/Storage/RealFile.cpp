@@ -27,6 +27,7 @@ License along with this library
 #include <vector>
 #include <limits>
 #include <cassert>
+#include <algorithm> // for std::min()
 
 #include "RealFile.Windows.inl"
 #include "RealFile.Posix.inl"
@@ -51,7 +52,6 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
 #elif defined(NUCLEX_PIXELS_LINUX)
 
-    (void)promiseSequentialAccess; // Not supported here.
     if(readOnly) {
       this->fileDescriptor = ::open(path.c_str(), O_RDONLY | O_NOATIME);
       if(this->fileDescriptor == -1) {
@@ -59,6 +59,9 @@ namespace Nuclex { namespace Pixels { namespace Storage {
         throwPosixFileAccessError(errorNumber);
       }
       this->length = getLinuxFileSize(this->fileDescriptor);
+      if(promiseSequentialAccess) {
+        AdviseSequential();
+      }
     } else {
       this->fileDescriptor = ::open(
         path.c_str(),
@@ -74,7 +77,6 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
 #else // No Windows, no Linux, let's try Posix
 
-    (void)promiseSequentialAccess; // Not supported here.
     if(readOnly) {
       this->filePointer = ::fopen(path.c_str(), "rb");
       if(this->filePointer == nullptr) {
@@ -82,6 +84,9 @@ namespace Nuclex { namespace Pixels { namespace Storage {
         throwPosixFileAccessError(errorNumber);
       }
       this->length = getPosixFileSize(path.c_str());
+      if(promiseSequentialAccess) {
+        AdviseSequential();
+      }
     } else {
       this->filePointer = ::fopen(path.c_str(), "wb");
       if(this->filePointer == nullptr) {
@@ -163,6 +168,7 @@ namespace Nuclex { namespace Pixels { namespace Storage {
         throwWindowsFileAccessError(ERROR_HANDLE_EOF);
       }
       moveWindowsFileCursor(this->fileHandle, start);
+      this->position = start;
     }
     writeWindowsFile(this->fileHandle, this->position, byteCount, buffer);
 
@@ -201,6 +207,66 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     }
     writePosixFile(this->filePointer, this->position, byteCount, buffer);
 
+#endif
+
+    // If the write extended the file, keep the cached length up to date
+    if(start + byteCount > this->length) {
+      this->length = start + byteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RealFile::AdviseSequential() const {
+#if defined(NUCLEX_PIXELS_WIN32)
+
+    // Windows only takes this hint when opening the file (FILE_FLAG_SEQUENTIAL_SCAN)
+
+#elif defined(NUCLEX_PIXELS_LINUX)
+
+    // Doubles the read-ahead window. This is only a hint, so errors are ignored.
+    ::posix_fadvise(this->fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+#elif defined(POSIX_FADV_SEQUENTIAL) // Not all Posix systems offer posix_fadvise()
+
+    ::posix_fadvise(::fileno(this->filePointer), 0, 0, POSIX_FADV_SEQUENTIAL);
+
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RealFile::Prefetch(std::uint64_t start, std::uint64_t byteCount) const {
+#if defined(NUCLEX_PIXELS_WIN32)
+
+    // Windows has no way to prefetch through a file handle, only for mapped memory
+    (void)start;
+    (void)byteCount;
+
+#elif defined(NUCLEX_PIXELS_LINUX) || defined(POSIX_FADV_WILLNEED)
+
+    // Unlike readahead(), this doesn't wait for the disk. The data goes into the OS'
+    // page cache, so it stays available after the file has been closed.
+    if(start >= this->length) {
+      return;
+    }
+    byteCount = std::min(byteCount, this->length - start);
+#if defined(NUCLEX_PIXELS_LINUX)
+    int fileDescriptor = this->fileDescriptor;
+#else
+    int fileDescriptor = ::fileno(this->filePointer);
+#endif
+    ::posix_fadvise(
+      fileDescriptor,
+      static_cast<off_t>(start), static_cast<off_t>(byteCount),
+      POSIX_FADV_WILLNEED
+    );
+
+#else // Posix system without posix_fadvise()
+
+    (void)start;
+    (void)byteCount;
+
 #endif
   }
 
@@ -87,6 +87,14 @@ namespace Nuclex { namespace Pixels { namespace Storage {
       std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
     ) override;
 
+    /// <summary>Tells the file that it will be read from start to end</summary>
+    public: void AdviseSequential() const override;
+
+    /// <summary>Asks the file to load a range of its contents in the background</summary>
+    /// <param name="start">Offset in the file at which the range begins</param>
+    /// <param name="byteCount">Number of bytes the range covers</param>
+    public: void Prefetch(std::uint64_t start, std::uint64_t byteCount) const override;
+
 #if defined(NUCLEX_PIXELS_WIN32)
     /// <summary>File handle returned by CreateFile() or OpenFile()</summary>
     private: HANDLE fileHandle;
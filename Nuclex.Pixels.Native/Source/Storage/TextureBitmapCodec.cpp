@@ -0,0 +1,221 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "TextureBitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "../InstrumentationHelpers.h"
+
+#include <algorithm> // for std::min()
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures a region can be read from a texture without splitting blocks</summary>
+  /// <param name="region">Region of the image that will be read</param>
+  /// <param name="layout">Layout of the texture the region will be read from</param>
+  void requireBlockAlignedRegion(
+    const Nuclex::Pixels::Rectangle &region, const Nuclex::Pixels::Storage::TextureLayout &layout
+  ) {
+    Nuclex::Pixels::Size blockSize = Nuclex::Pixels::GetBlockSize(layout.PixelFormat);
+    bool isAligned = (
+      (region.MinX % blockSize.Width == 0) &&
+      (region.MinY % blockSize.Height == 0) &&
+      ((region.MaxX % blockSize.Width == 0) || (region.MaxX == layout.Width)) &&
+      ((region.MaxY % blockSize.Height == 0) || (region.MaxY == layout.Height))
+    );
+    if(!isAligned) {
+      throw std::runtime_error(
+        u8"Regions of block-compressed images must be aligned to whole blocks"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Copies a region of the largest mip level into bitmap memory</summary>
+  /// <param name="source">File the texture is stored in</param>
+  /// <param name="layout">Layout of the texture in the file</param>
+  /// <param name="region">Region of the largest mip level that will be copied</param>
+  /// <param name="memory">Bitmap memory that will receive the pixels</param>
+  /// <remarks>
+  ///   Block-compressed formats are copied one row of blocks at a time. Since the stride
+  ///   of a block-compressed bitmap covers a single row of pixels, a row of blocks is
+  ///   the stride times the block height, as it is in the file.
+  /// </remarks>
+  void readRegion(
+    const Nuclex::Pixels::Storage::VirtualFile &source,
+    const Nuclex::Pixels::Storage::TextureLayout &layout,
+    const Nuclex::Pixels::Rectangle &region,
+    const Nuclex::Pixels::BitmapMemory &memory
+  ) {
+    using Nuclex::Pixels::Storage::CountTextureRowBytes;
+
+    Nuclex::Pixels::Size blockSize = Nuclex::Pixels::GetBlockSize(layout.PixelFormat);
+    const Nuclex::Pixels::Storage::TextureLevelLayout &level = layout.Levels[0];
+
+    std::uint64_t blockRowByteCount = (
+      static_cast<std::uint64_t>(CountTextureRowBytes(layout.PixelFormat, level.Width)) *
+      blockSize.Height
+    );
+    std::size_t regionOffset = (
+      CountTextureRowBytes(layout.PixelFormat, region.MinX) * blockSize.Height
+    );
+    std::size_t regionByteCount = (
+      CountTextureRowBytes(layout.PixelFormat, region.MaxX - region.MinX) * blockSize.Height
+    );
+
+    for(std::size_t y = region.MinY; y < region.MaxY; y += blockSize.Height) {
+      std::size_t targetY = y - region.MinY;
+      source.ReadAt(
+        level.Offset + (blockRowByteCount * (y / blockSize.Height)) + regionOffset,
+        regionByteCount,
+        static_cast<std::uint8_t *>(memory.Pixels) + (
+          static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(targetY)
+        )
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TextureBitmapCodec::CanLoad(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+  ) const {
+
+    // If a file extension is offered, do an early exit if it doesn't match
+    if(!MightHaveFileExtension(extensionHint, GetFileExtensions())) {
+      return false;
+    }
+
+    std::uint8_t fileHeader[FileHeaderSampleByteCount];
+    std::size_t fileHeaderByteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(FileHeaderSampleByteCount, source.GetSize())
+    );
+    source.ReadAt(0, fileHeaderByteCount, fileHeader);
+
+    return IsValidFileHeader(fileHeader, fileHeaderByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapInfo TextureBitmapCodec::TryReadInfo(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint; // Unused
+
+    TextureLayout layout;
+    if(!TryReadLayout(source, layout)) {
+      BitmapInfo result;
+      result.Loadable = false;
+      return result;
+    }
+
+    Rectangle region = GetLoadRegion(options, layout.Width, layout.Height);
+
+    BitmapInfo result;
+    result.Loadable = true;
+    result.Width = region.MaxX - region.MinX;
+    result.Height = region.MaxY - region.MinY;
+    result.PixelFormat = layout.PixelFormat;
+    result.MemoryUsage = (
+      static_cast<std::size_t>(
+        CountTextureLevelBytes(result.PixelFormat, result.Width, result.Height)
+      ) +
+      (sizeof(std::intptr_t) * 3) +
+      (sizeof(std::size_t) * 3) +
+      (sizeof(int) * 2)
+    );
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OptionalBitmap TextureBitmapCodec::TryLoad(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.TextureBitmapCodec.TryLoad");
+    (void)extensionHint; // Unused
+
+    TextureLayout layout;
+    if(!TryReadLayout(source, layout)) {
+      return OptionalBitmap();
+    }
+
+    Rectangle region = GetLoadRegion(options, layout.Width, layout.Height);
+    requireBlockAlignedRegion(region, layout);
+
+    Bitmap image(region.MaxX - region.MinX, region.MaxY - region.MinY, layout.PixelFormat);
+    readRegion(source, layout, region, image.Access());
+
+    return OptionalBitmap(std::move(image));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TextureBitmapCodec::TryReload(
+    Bitmap &exactlyFittingBitmap,
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint; // Unused
+
+    TextureLayout layout;
+    if(!TryReadLayout(source, layout)) {
+      return false;
+    }
+
+    Rectangle region = GetLoadRegion(options, layout.Width, layout.Height);
+    requireBlockAlignedRegion(region, layout);
+
+    // The bitmap may be a view into a larger bitmap, only its size has to fit
+    const BitmapMemory &memory = exactlyFittingBitmap.Access();
+    bool matchesExpectations = (
+      (memory.Width == region.MaxX - region.MinX) &&
+      (memory.Height == region.MaxY - region.MinY) &&
+      (memory.PixelFormat == layout.PixelFormat)
+    );
+    if(!matchesExpectations) {
+      throw std::runtime_error(
+        u8"Bitmap provided to Reload() does not have a correct dimensions and pixel format"
+      );
+    }
+
+    readRegion(source, layout, region, memory);
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
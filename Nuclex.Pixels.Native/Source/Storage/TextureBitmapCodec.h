@@ -0,0 +1,110 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_TEXTUREBITMAPCODEC_H
+#define NUCLEX_PIXELS_STORAGE_TEXTUREBITMAPCODEC_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/BitmapCodec.h"
+
+#include "TextureLayout.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Base class for codecs of texture container file formats</summary>
+  /// <remarks>
+  ///   Texture containers store their pixels exactly as they will end up in a bitmap, so
+  ///   no decoding is needed. Codecs deriving from this class only have to locate the mip
+  ///   levels in the file, loading the largest mip level into a bitmap is done here.
+  /// </remarks>
+  class TextureBitmapCodec : public BitmapCodec {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~TextureBitmapCodec() = default;
+
+    /// <summary>Checks if the codec is able to load the specified file</summary>
+    /// <param name="source">Source data that will be checked for loadbility</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <returns>True if the codec is able to load the specified file</returns>
+    public: bool CanLoad(
+      const VirtualFile &source, const std::string &extensionHint = std::string()
+    ) const override;
+
+    /// <summary>Tries to read informations for a bitmap</summary>
+    /// <param name="source">Source data from which the informations should be extracted</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   Informations about the bitmap, if the codec is able to load it, otherwise
+    ///   a BitmapInfo structure with 'Loadable' set to false.
+    /// </returns>
+    public: BitmapInfo TryReadInfo(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to load the specified file as a bitmap</summary>
+    /// <param name="source">Source data the bitmap will be loaded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>
+    ///   The bitmap loaded from the specified file data or an empty value if the file format
+    ///   is not supported by the codec
+    /// </returns>
+    public: OptionalBitmap TryLoad(
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to load the specified file into an exciting bitmap</summary>
+    /// <param name="exactlyFittingBitmap">
+    ///   Bitmap matching the exact dimensions of the file to be loaded
+    /// </param>
+    /// <param name="source">Source data the bitmap will be loaded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>True if the codec was able to load the bitmap, false otherwise</returns>
+    public: bool TryReload(
+      Bitmap &exactlyFittingBitmap,
+      const VirtualFile &source, const std::string &extensionHint = std::string(),
+      const LoadOptions &options = LoadOptions()
+    ) const override;
+
+    /// <summary>Tries to locate the mip levels in a texture file</summary>
+    /// <param name="source">File in which the mip levels will be located</param>
+    /// <param name="layout">Receives the dimensions and locations of all mip levels</param>
+    /// <returns>True if the file was in the codec's file format, false otherwise</returns>
+    /// <remarks>
+    ///   Like <see cref="TryLoad" />, this should only return false if the file is in
+    ///   a different file format. Corrupt or unsupported files must cause an exception.
+    /// </remarks>
+    public: virtual bool TryReadLayout(
+      const VirtualFile &source, TextureLayout &layout
+    ) const = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_TEXTUREBITMAPCODEC_H
@@ -0,0 +1,175 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/TextureFile.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include "TextureLayout.h"
+#include "Dds/DdsBitmapCodec.h"
+#include "Ktx/Ktx2BitmapCodec.h"
+
+#include <stdexcept> // for std::out_of_range
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct TextureFile::Implementation {
+
+    /// <summary>File the texture is stored in</summary>
+    public: std::unique_ptr<const VirtualFile> File;
+    /// <summary>Copy of the file's contents if the file can't provide them in memory</summary>
+    public: std::vector<std::uint8_t> Buffer;
+    /// <summary>Address of the file's first byte in memory</summary>
+    public: const std::uint8_t *Contents;
+    /// <summary>Dimensions, pixel format and locations of the mip levels</summary>
+    public: TextureLayout Layout;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TextureFile TextureFile::Open(const std::string &path) {
+    return Open(VirtualFile::OpenMemoryMappedFileForReading(path));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TextureFile TextureFile::Open(std::unique_ptr<const VirtualFile> &&file) {
+    std::unique_ptr<Implementation> implementation(new Implementation());
+
+    bool isTexture = Dds::DdsBitmapCodec().TryReadLayout(*file, implementation->Layout);
+    if(!isTexture) {
+      isTexture = Ktx::Ktx2BitmapCodec().TryReadLayout(*file, implementation->Layout);
+    }
+    if(!isTexture) {
+      throw Errors::FileFormatError(u8"File is neither a DDS nor a KTX2 texture");
+    }
+
+    // Memory-mapped files and files in memory hand out their contents directly,
+    // for anything else the contents are read into a buffer once
+    std::size_t fileSize = static_cast<std::size_t>(file->GetSize());
+    implementation->Contents = file->TryGetContiguousSpan(0, fileSize);
+    if(implementation->Contents == nullptr) {
+      implementation->Buffer.resize(fileSize);
+      file->ReadAt(0, fileSize, &implementation->Buffer[0]);
+      implementation->Contents = &implementation->Buffer[0];
+    }
+    implementation->File = std::move(file);
+
+    return TextureFile(implementation.release());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TextureFile::TextureFile(Implementation *implementation) :
+    implementation(implementation) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TextureFile::TextureFile(TextureFile &&other) :
+    implementation(other.implementation) {
+    other.implementation = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TextureFile::~TextureFile() {
+    delete this->implementation;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TextureFile::GetWidth() const {
+    return this->implementation->Layout.Width;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TextureFile::GetHeight() const {
+    return this->implementation->Layout.Height;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PixelFormat TextureFile::GetPixelFormat() const {
+    return this->implementation->Layout.PixelFormat;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TextureFile::CountLevels() const {
+    return this->implementation->Layout.Levels.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapMemory TextureFile::GetLevel(std::size_t levelIndex) const {
+    const TextureLayout &layout = this->implementation->Layout;
+    if(levelIndex >= layout.Levels.size()) {
+      throw std::out_of_range(u8"Mip level index is out of range");
+    }
+
+    const TextureLevelLayout &level = layout.Levels[levelIndex];
+
+    // The memory is handed out as mutable because that's what bitmap memory is,
+    // the documentation asks callers to only read from it
+    BitmapMemory memory;
+    memory.Width = level.Width;
+    memory.Height = level.Height;
+    memory.Stride = static_cast<int>(CountTextureRowBytes(layout.PixelFormat, level.Width));
+    memory.PixelFormat = layout.PixelFormat;
+    memory.Pixels = const_cast<std::uint8_t *>(
+      this->implementation->Contents + static_cast<std::size_t>(level.Offset)
+    );
+    return memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t TextureFile::CountLevelBytes(std::size_t levelIndex) const {
+    const TextureLayout &layout = this->implementation->Layout;
+    if(levelIndex >= layout.Levels.size()) {
+      throw std::out_of_range(u8"Mip level index is out of range");
+    }
+
+    return layout.Levels[levelIndex].ByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TextureFile &TextureFile::operator =(TextureFile &&other) {
+    if(&other != this) {
+      delete this->implementation;
+      this->implementation = other.implementation;
+      other.implementation = nullptr;
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,109 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "TextureLayout.h"
+
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds a value up to the next multiple of another value</summary>
+  /// <param name="value">Value that will be rounded up</param>
+  /// <param name="multiple">Multiple the value will be rounded up to</param>
+  /// <returns>The smallest multiple of the divisor that is larger or equal</returns>
+  std::size_t nextMultiple(std::size_t value, std::size_t multiple) {
+    return (value + (multiple - 1)) / multiple * multiple;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t CountTextureRowBytes(PixelFormat pixelFormat, std::size_t width) {
+    Size blockSize = GetBlockSize(pixelFormat);
+    return CountRequiredBytes(pixelFormat, nextMultiple(width, blockSize.Width));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t CountTextureLevelBytes(
+    PixelFormat pixelFormat, std::size_t width, std::size_t height
+  ) {
+    Size blockSize = GetBlockSize(pixelFormat);
+    return (
+      static_cast<std::uint64_t>(CountTextureRowBytes(pixelFormat, width)) *
+      nextMultiple(height, blockSize.Height)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AddSequentialTextureLevels(
+    TextureLayout &layout, std::size_t levelCount, std::uint64_t offset, std::uint64_t fileSize
+  ) {
+    layout.Levels.reserve(levelCount);
+
+    std::size_t width = layout.Width;
+    std::size_t height = layout.Height;
+    for(std::size_t index = 0; index < levelCount; ++index) {
+      TextureLevelLayout level;
+      level.Width = width;
+      level.Height = height;
+      level.Offset = offset;
+      level.ByteCount = CountTextureLevelBytes(layout.PixelFormat, width, height);
+      if((level.ByteCount > fileSize) || (level.Offset > fileSize - level.ByteCount)) {
+        throw Errors::FileFormatError(u8"Texture file is truncated");
+      }
+      layout.Levels.push_back(level);
+
+      offset += level.ByteCount;
+      width = (width > 1) ? (width / 2) : 1;
+      height = (height > 1) ? (height / 2) : 1;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool IsValidTextureLevelCount(
+    std::size_t width, std::size_t height, std::size_t levelCount
+  ) {
+    std::size_t largest = (width > height) ? width : height;
+
+    std::size_t possibleLevelCount = 1;
+    while(largest > 1) {
+      largest /= 2;
+      ++possibleLevelCount;
+    }
+
+    return (levelCount >= 1) && (levelCount <= possibleLevelCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,138 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_TEXTURELAYOUT_H
+#define NUCLEX_PIXELS_STORAGE_TEXTURELAYOUT_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/PixelFormat.h"
+
+#include "ByteOrder.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Location of a mip level inside a texture container file</summary>
+  struct TextureLevelLayout {
+
+    /// <summary>Width of the mip level in pixels</summary>
+    public: std::size_t Width;
+    /// <summary>Height of the mip level in pixels</summary>
+    public: std::size_t Height;
+    /// <summary>Offset of the mip level's first byte from the start of the file</summary>
+    public: std::uint64_t Offset;
+    /// <summary>Number of bytes the mip level occupies in the file</summary>
+    public: std::uint64_t ByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes the mip levels stored in a texture container file</summary>
+  /// <remarks>
+  ///   Texture containers (DDS and KTX2) store the pixels of each mip level exactly as
+  ///   GPUs expect them, with rows tightly packed and, for block-compressed formats,
+  ///   rows of blocks stored one after another.
+  /// </remarks>
+  struct TextureLayout {
+
+    /// <summary>Width of the largest mip level in pixels</summary>
+    public: std::size_t Width;
+    /// <summary>Height of the largest mip level in pixels</summary>
+    public: std::size_t Height;
+    /// <summary>Pixel format all mip levels are stored in</summary>
+    public: enum PixelFormat PixelFormat;
+    /// <summary>Mip levels in the file, starting with the largest one</summary>
+    public: std::vector<TextureLevelLayout> Levels;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the pixel format for little endian words stored in a file</summary>
+  /// <param name="pixelFormat">Pixel format made up of 16 or 32 bit words</param>
+  /// <returns>The variant of the pixel format that uses little endian words</returns>
+  /// <remarks>
+  ///   Texture files store all words in little endian byte order, no matter which
+  ///   platform they're loaded on. Only valid for pixel formats made up of 16 or 32 bit
+  ///   words, for the 8 bit RGBA formats the same bit selects the reversed channel order.
+  /// </remarks>
+  constexpr inline PixelFormat GetLittleEndianFormat(PixelFormat pixelFormat) {
+    // Bit 2 of the pixel format identifier selects little endian words
+    return static_cast<PixelFormat>(static_cast<int>(pixelFormat) | 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the number of bytes in a row of pixels in a texture file</summary>
+  /// <param name="pixelFormat">Pixel format the texture is stored in</param>
+  /// <param name="width">Width of the mip level in pixels</param>
+  /// <returns>
+  ///   The number of bytes in a row of pixels. For block-compressed formats, this is
+  ///   the share of one row of pixels in a row of blocks (matching the way
+  ///   <see cref="Bitmap" /> reports their stride).
+  /// </returns>
+  std::size_t CountTextureRowBytes(PixelFormat pixelFormat, std::size_t width);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the number of bytes a mip level occupies in a texture file</summary>
+  /// <param name="pixelFormat">Pixel format the texture is stored in</param>
+  /// <param name="width">Width of the mip level in pixels</param>
+  /// <param name="height">Height of the mip level in pixels</param>
+  /// <returns>The number of bytes the mip level occupies</returns>
+  std::uint64_t CountTextureLevelBytes(
+    PixelFormat pixelFormat, std::size_t width, std::size_t height
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds mip levels stored back to back to a texture layout</summary>
+  /// <param name="layout">Texture layout the mip levels will be added to</param>
+  /// <param name="levelCount">Number of mip levels in the file</param>
+  /// <param name="offset">Offset of the first mip level from the start of the file</param>
+  /// <param name="fileSize">Size of the file, used to check for truncation</param>
+  /// <remarks>
+  ///   The width, height and pixel format of the layout must already be set. Throws
+  ///   a <see cref="FileFormatError" /> if the levels extend beyond the end of the file.
+  /// </remarks>
+  void AddSequentialTextureLevels(
+    TextureLayout &layout, std::size_t levelCount, std::uint64_t offset, std::uint64_t fileSize
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a mip level count is possible for a texture</summary>
+  /// <param name="width">Width of the largest mip level in pixels</param>
+  /// <param name="height">Height of the largest mip level in pixels</param>
+  /// <param name="levelCount">Number of mip levels that will be checked</param>
+  /// <returns>True if the texture can have the specified number of mip levels</returns>
+  bool IsValidTextureLevelCount(std::size_t width, std::size_t height, std::size_t levelCount);
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_TEXTURELAYOUT_H
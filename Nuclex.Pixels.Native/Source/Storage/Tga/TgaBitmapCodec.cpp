@@ -0,0 +1,208 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "TgaBitmapCodec.h"
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include "../ByteOrder.h"
+
+#include <stdexcept> // for std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the header at the start of each TGA file</summary>
+  const std::size_t TgaHeaderByteCount = 18;
+
+  /// <summary>Image type of uncompressed true color images</summary>
+  const std::uint8_t UncompressedTrueColorImageType = 2;
+  /// <summary>Image type of uncompressed grayscale images</summary>
+  const std::uint8_t UncompressedGrayscaleImageType = 3;
+
+  /// <summary>Image descriptor bit indicating that rows are stored right to left</summary>
+  const std::uint8_t RightToLeftDescriptorBit = 0x10;
+  /// <summary>Image descriptor bit indicating that rows are stored top to bottom</summary>
+  const std::uint8_t TopToBottomDescriptorBit = 0x20;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the fields of a TGA header describe a supported image</summary>
+  /// <param name="header">First 16 bytes of the file that will be checked</param>
+  /// <returns>True if the header looks like a supported TGA file</returns>
+  /// <remarks>
+  ///   TGA files have no signature, so the only way to identify them is to check
+  ///   whether their header fields contain sensible values.
+  /// </remarks>
+  bool isSupportedTgaHeader(const std::uint8_t *header) {
+    bool hasSupportedImageType = (
+      (header[2] == UncompressedTrueColorImageType) ||
+      (header[2] == UncompressedGrayscaleImageType)
+    );
+    return (
+      (header[1] == 0) && // No color map
+      hasSupportedImageType &&
+      (Nuclex::Pixels::Storage::ReadLittleEndianUInt16(header + 12) != 0) && // Width
+      (Nuclex::Pixels::Storage::ReadLittleEndianUInt16(header + 14) != 0) // Height
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace Tga {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TgaBitmapCodec::TgaBitmapCodec() :
+    name(u8"Truevision TGA (.tga) uncompressed") {
+    this->knownFileExtensions.push_back(u8"tga");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TgaBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    if(fileHeaderByteCount < 16) {
+      return false; // Too short for the fields we can check
+    }
+
+    return isSupportedTgaHeader(fileHeader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TgaBitmapCodec::CanSave() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TgaBitmapCodec::TryReadLayout(const VirtualFile &source, RawImageLayout &layout) const {
+    std::uint64_t fileSize = source.GetSize();
+    if(fileSize < TgaHeaderByteCount) {
+      return false; // File is too short to be a TGA file
+    }
+
+    std::uint8_t header[TgaHeaderByteCount];
+    source.ReadAt(0, TgaHeaderByteCount, header);
+    if(!isSupportedTgaHeader(header)) {
+      return false;
+    }
+
+    // Anything we don't understand is treated as not being a TGA file,
+    // the header checks are all we have to tell TGA files apart from others
+    std::uint8_t bitsPerPixel = header[16];
+    std::uint8_t descriptor = header[17];
+    std::uint8_t alphaBitCount = descriptor & 0x0F;
+    if((descriptor & RightToLeftDescriptorBit) != 0) {
+      return false;
+    }
+    if(header[2] == UncompressedGrayscaleImageType) {
+      if((bitsPerPixel != 8) || (alphaBitCount != 0)) {
+        return false;
+      }
+      layout.PixelFormat = PixelFormat::R8_Unsigned;
+    } else if((bitsPerPixel == 24) && (alphaBitCount == 0)) {
+      layout.PixelFormat = PixelFormat::B8_G8_R8_Unsigned;
+    } else if((bitsPerPixel == 32) && ((alphaBitCount == 0) || (alphaBitCount == 8))) {
+      layout.PixelFormat = PixelFormat::B8_G8_R8_A8_Unsigned;
+    } else {
+      return false;
+    }
+
+    layout.Width = ReadLittleEndianUInt16(header + 12);
+    layout.Height = ReadLittleEndianUInt16(header + 14);
+    layout.Offset = TgaHeaderByteCount + header[0]; // Skip the image ID
+    layout.StoredBytesPerPixel = bitsPerPixel / 8;
+    layout.RowPitch = layout.StoredBytesPerPixel * layout.Width;
+    layout.IsBottomUp = ((descriptor & TopToBottomDescriptorBit) == 0);
+    layout.NeedsTransform = false;
+    layout.HasFlippedWords = false;
+
+    if(layout.Offset + (static_cast<std::uint64_t>(layout.RowPitch) * layout.Height) > fileSize) {
+      throw Errors::FileFormatError(u8"TGA file is truncated");
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TgaBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options
+  ) const {
+    (void)options; // Unused
+
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"TGA files can not store empty bitmaps");
+    }
+    if((memory.Width > 65535) || (memory.Height > 65535)) {
+      throw std::invalid_argument(u8"TGA files can not store bitmaps larger than 65535 pixels");
+    }
+
+    // Pixel formats TGA can store as they are are written straight from the bitmap,
+    // all others are converted to 32 bit BGRA while saving
+    std::uint8_t header[TgaHeaderByteCount] = { 0 };
+    PixelFormat storedPixelFormat;
+    switch(memory.PixelFormat) {
+      case PixelFormat::R8_Unsigned: {
+        storedPixelFormat = PixelFormat::R8_Unsigned;
+        header[2] = UncompressedGrayscaleImageType;
+        header[16] = 8;
+        break;
+      }
+      case PixelFormat::B8_G8_R8_Unsigned: {
+        storedPixelFormat = PixelFormat::B8_G8_R8_Unsigned;
+        header[2] = UncompressedTrueColorImageType;
+        header[16] = 24;
+        break;
+      }
+      default: {
+        storedPixelFormat = PixelFormat::B8_G8_R8_A8_Unsigned;
+        header[2] = UncompressedTrueColorImageType;
+        header[16] = 32;
+        header[17] = 8; // Alpha bits
+        break;
+      }
+    }
+
+    WriteLittleEndianUInt16(header + 12, static_cast<std::uint16_t>(memory.Width));
+    WriteLittleEndianUInt16(header + 14, static_cast<std::uint16_t>(memory.Height));
+    header[17] |= TopToBottomDescriptorBit;
+    target.WriteAt(0, TgaHeaderByteCount, header);
+
+    WriteRows(
+      memory, target, TgaHeaderByteCount,
+      storedPixelFormat, CountRequiredBytes(storedPixelFormat, memory.Width), false
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::Tga
@@ -23,6 +23,9 @@ License along with this library
 
 #include "Nuclex/Pixels/Storage/VirtualFile.h"
 #include "RealFile.h"
+#include "MappedFile.h"
+#include "MemoryFile.h"
+#include "BufferedVirtualFile.h"
 
 namespace Nuclex { namespace Pixels { namespace Storage {
 
@@ -36,6 +39,30 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::unique_ptr<const VirtualFile> VirtualFile::OpenMemoryMappedFileForReading(
+    const std::string &path, bool promiseSequentialAccess /* = false */
+  ) {
+    return std::make_unique<const MappedFile>(path, promiseSequentialAccess);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<const VirtualFile> VirtualFile::FromMemory(
+    const void *contents, std::size_t length
+  ) {
+    return std::make_unique<const MemoryFile>(contents, length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<const VirtualFile> VirtualFile::AddReadAheadBuffer(
+    std::unique_ptr<const VirtualFile> file, std::size_t readAheadByteCount /* = 262144 */
+  ) {
+    return std::make_unique<const BufferedVirtualFile>(std::move(file), readAheadByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::unique_ptr<VirtualFile> VirtualFile::OpenRealFileForWriting(
     const std::string &path, bool promiseSequentialAccess /* = false */
   ) {
@@ -0,0 +1,591 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "WebPBitmapCodec.h"
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/PixelFormatTraits.h"
+
+#include "../FileContents.h"
+#include "../../InstrumentationHelpers.h"
+
+#include <webp/decode.h>
+#include <webp/encode.h>
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <exception> // for std::exception_ptr
+#include <new> // for std::bad_alloc
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of bytes read from the start of a file to obtain its features</summary>
+  const std::size_t WebPFeatureHeaderByteCount = 64;
+
+  /// <summary>Largest width or height an image stored in a WebP file can have</summary>
+  const std::size_t WebPMaximumDimension = 16383;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a file starts with the WebP file signature</summary>
+  /// <param name="fileHeader">First bytes of the file that will be checked</param>
+  /// <param name="fileHeaderByteCount">Number of bytes available in the file header</param>
+  /// <returns>True if the file starts with the WebP file signature</returns>
+  bool hasWebPSignature(const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount) {
+    return (
+      (fileHeaderByteCount >= 12) &&
+      (std::memcmp(fileHeader, "RIFF", 4) == 0) &&
+      (std::memcmp(fileHeader + 8, "WEBP", 4) == 0)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides a human-readable description for a libwebp decoder status</summary>
+  /// <param name="status">Status code returned by the libwebp decoder</param>
+  /// <returns>A message describing the status code</returns>
+  const char *getDecoderErrorMessage(::VP8StatusCode status) {
+    switch(status) {
+      case VP8_STATUS_OUT_OF_MEMORY: { return u8"libwebp ran out of memory"; }
+      case VP8_STATUS_INVALID_PARAM: { return u8"libwebp was given an invalid parameter"; }
+      case VP8_STATUS_BITSTREAM_ERROR: { return u8"WebP file is corrupted"; }
+      case VP8_STATUS_UNSUPPORTED_FEATURE: { return u8"WebP file uses an unsupported feature"; }
+      case VP8_STATUS_NOT_ENOUGH_DATA: { return u8"WebP file is truncated"; }
+      default: { return u8"Error occurred in libwebp"; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides a human-readable description for a libwebp encoder error</summary>
+  /// <param name="error">Error code reported by the libwebp encoder</param>
+  /// <returns>A message describing the error code</returns>
+  const char *getEncoderErrorMessage(::WebPEncodingError error) {
+    switch(error) {
+      case VP8_ENC_ERROR_OUT_OF_MEMORY: { return u8"libwebp ran out of memory"; }
+      case VP8_ENC_ERROR_BITSTREAM_OUT_OF_MEMORY: { return u8"libwebp ran out of memory"; }
+      case VP8_ENC_ERROR_INVALID_CONFIGURATION: { return u8"Invalid WebP save options"; }
+      case VP8_ENC_ERROR_BAD_DIMENSION: { return u8"Bitmap can not be stored in a WebP file"; }
+      case VP8_ENC_ERROR_FILE_TOO_BIG: { return u8"Bitmap is too large for a WebP file"; }
+      default: { return u8"Error occurred in libwebp"; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tries to read the features of a WebP file</summary>
+  /// <param name="source">File whose features will be read</param>
+  /// <param name="features">Receives the features of the WebP file</param>
+  /// <returns>True if the file was a WebP file, false otherwise</returns>
+  bool tryReadWebPFeatures(
+    const Nuclex::Pixels::Storage::VirtualFile &source, ::WebPBitstreamFeatures &features
+  ) {
+    std::uint8_t fileHeader[WebPFeatureHeaderByteCount];
+    std::size_t fileHeaderByteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(source.GetSize(), WebPFeatureHeaderByteCount)
+    );
+    if(fileHeaderByteCount < 12) {
+      return false;
+    }
+
+    source.ReadAt(0, fileHeaderByteCount, fileHeader);
+    if(!hasWebPSignature(fileHeader, fileHeaderByteCount)) {
+      return false;
+    }
+
+    ::VP8StatusCode status = ::WebPGetFeatures(fileHeader, fileHeaderByteCount, &features);
+    if(status != VP8_STATUS_OK) {
+      throw Nuclex::Pixels::Errors::FileFormatError(getDecoderErrorMessage(status));
+    }
+    if(features.has_animation != 0) {
+      throw Nuclex::Pixels::Errors::FileFormatError(u8"Animated WebP files are not supported");
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel format a WebP image will be loaded in</summary>
+  /// <param name="features">Features of the WebP file that will be loaded</param>
+  /// <returns>The pixel format matching the channels stored in the image</returns>
+  Nuclex::Pixels::PixelFormat getPixelFormat(const ::WebPBitstreamFeatures &features) {
+    if(features.has_alpha != 0) {
+      return Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned;
+    } else {
+      return Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>RAII helper that frees the output buffer of a WebP decoder</summary>
+  class WebPDecBufferScope {
+
+    /// <summary>Frees a WebP decoder output buffer upon termination</summary>
+    /// <param name="buffer">Output buffer that will be freed</param>
+    public: WebPDecBufferScope(::WebPDecBuffer &buffer) :
+      buffer(buffer) {}
+
+    /// <summary>Frees the output buffer</summary>
+    public: ~WebPDecBufferScope() {
+      ::WebPFreeDecBuffer(&this->buffer);
+    }
+
+    /// <summary>Output buffer that will be freed</summary>
+    private: ::WebPDecBuffer &buffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>RAII helper that frees the memory of a WebP picture</summary>
+  class WebPPictureScope {
+
+    /// <summary>Frees a WebP picture upon termination</summary>
+    /// <param name="picture">Picture that will be freed</param>
+    public: WebPPictureScope(::WebPPicture &picture) :
+      picture(picture) {}
+
+    /// <summary>Frees the picture</summary>
+    public: ~WebPPictureScope() {
+      ::WebPPictureFree(&this->picture);
+    }
+
+    /// <summary>Picture that will be freed</summary>
+    private: ::WebPPicture &picture;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a WebP image into bitmap memory</summary>
+  /// <param name="contents">Contents of the whole WebP file</param>
+  /// <param name="features">Features of the WebP file</param>
+  /// <param name="region">Region of the image that will be decoded</param>
+  /// <param name="memory">Bitmap memory that will receive the decoded region</param>
+  /// <remarks>
+  ///   libwebp decodes straight into the bitmap's memory. Only when the region starts
+  ///   at odd coordinates (libwebp crops at even coordinates due to chroma subsampling)
+  ///   or the bitmap is stored upside down, a temporary buffer is needed.
+  /// </remarks>
+  void decodeWebP(
+    const Nuclex::Pixels::Storage::FileContents &contents,
+    const ::WebPBitstreamFeatures &features,
+    const Nuclex::Pixels::Rectangle &region,
+    const Nuclex::Pixels::BitmapMemory &memory
+  ) {
+    ::WebPDecoderConfig config;
+    if(!::WebPInitDecoderConfig(&config)) {
+      throw std::runtime_error(u8"libwebp version does not match the headers");
+    }
+
+    std::size_t bytesPerPixel = (features.has_alpha != 0) ? 4 : 3;
+    config.output.colorspace = (features.has_alpha != 0) ? MODE_RGBA : MODE_RGB;
+
+    std::size_t cropX = static_cast<std::size_t>(region.MinX) & ~std::size_t(1);
+    std::size_t cropY = static_cast<std::size_t>(region.MinY) & ~std::size_t(1);
+    std::size_t skipX = static_cast<std::size_t>(region.MinX) - cropX;
+    std::size_t skipY = static_cast<std::size_t>(region.MinY) - cropY;
+    std::size_t cropWidth = memory.Width + skipX;
+    std::size_t cropHeight = memory.Height + skipY;
+
+    bool isWholeImage = (
+      (cropWidth == static_cast<std::size_t>(features.width)) &&
+      (cropHeight == static_cast<std::size_t>(features.height))
+    );
+    if(!isWholeImage) {
+      config.options.use_cropping = 1;
+      config.options.crop_left = static_cast<int>(cropX);
+      config.options.crop_top = static_cast<int>(cropY);
+      config.options.crop_width = static_cast<int>(cropWidth);
+      config.options.crop_height = static_cast<int>(cropHeight);
+    }
+
+    std::size_t rowByteCount = memory.Width * bytesPerPixel;
+    bool canDecodeDirectly = (
+      (skipX == 0) && (skipY == 0) &&
+      (memory.Stride > 0) && (static_cast<std::size_t>(memory.Stride) >= rowByteCount)
+    );
+
+    std::vector<std::uint8_t> buffer;
+    config.output.is_external_memory = 1;
+    if(canDecodeDirectly) {
+      config.output.u.RGBA.rgba = static_cast<std::uint8_t *>(memory.Pixels);
+      config.output.u.RGBA.stride = static_cast<int>(memory.Stride);
+      config.output.u.RGBA.size = (
+        (static_cast<std::size_t>(memory.Stride) * (memory.Height - 1)) + rowByteCount
+      );
+    } else {
+      std::size_t bufferStride = cropWidth * bytesPerPixel;
+      buffer.resize(bufferStride * cropHeight);
+      config.output.u.RGBA.rgba = &buffer[0];
+      config.output.u.RGBA.stride = static_cast<int>(bufferStride);
+      config.output.u.RGBA.size = buffer.size();
+    }
+
+    {
+      WebPDecBufferScope outputScope(config.output);
+
+      ::VP8StatusCode status = ::WebPDecode(contents.GetData(), contents.GetSize(), &config);
+      if(status != VP8_STATUS_OK) {
+        throw Nuclex::Pixels::Errors::FileFormatError(getDecoderErrorMessage(status));
+      }
+    }
+
+    if(!canDecodeDirectly) {
+      std::size_t bufferStride = cropWidth * bytesPerPixel;
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + (
+          static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+        );
+        std::memcpy(
+          row, &buffer[((y + skipY) * bufferStride) + (skipX * bytesPerPixel)], rowByteCount
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Data passed along to the custom write function for libwebp</summary>
+  struct WebPWriteEnvironment {
+
+    /// <summary>Initializes a new libwebp write environment</summary>
+    /// <param name="file">File to which libwebp should be writing</param>
+    public: WebPWriteEnvironment(Nuclex::Pixels::Storage::VirtualFile &file) :
+      File(file),
+      Position(0) {}
+
+    /// <summary>File into which the write method is writing data</summary>
+    public: Nuclex::Pixels::Storage::VirtualFile &File;
+    /// <summary>Current position of the file pointer</summary>
+    public: std::uint64_t Position;
+    /// <summary>Exception that occurred while writing, if any</summary>
+    public: std::exception_ptr Error;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes data produced by the libwebp encoder into a virtual file</summary>
+  /// <param name="data">Data that will be written into the file</param>
+  /// <param name="dataSize">Number of bytes that will be written</param>
+  /// <param name="picture">Picture being encoded, carries the write environment</param>
+  /// <returns>1 if the data was written, 0 if an error occurred</returns>
+  /// <remarks>
+  ///   libwebp is a C library that does not expect exceptions to pass through it,
+  ///   so exceptions are captured here and rethrown once libwebp has returned.
+  /// </remarks>
+  int writeWebPData(const std::uint8_t *data, std::size_t dataSize, const ::WebPPicture *picture) {
+    WebPWriteEnvironment &environment = *static_cast<WebPWriteEnvironment *>(
+      picture->custom_ptr
+    );
+    try {
+      environment.File.WriteAt(environment.Position, dataSize, data);
+      environment.Position += dataSize;
+      return 1;
+    }
+    catch(...) {
+      environment.Error = std::current_exception();
+      return 0;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sets up the libwebp encoder configuration according to the save options</summary>
+  /// <param name="config">Encoder configuration that will be set up</param>
+  /// <param name="options">Save options the configuration will follow</param>
+  void configureEncoder(
+    ::WebPConfig &config, const Nuclex::Pixels::Storage::WebPSaveOptions &options
+  ) {
+    if(!::WebPConfigInit(&config)) {
+      throw std::runtime_error(u8"libwebp version does not match the headers");
+    }
+    if((options.Method < 0) || (options.Method > 6)) {
+      throw std::invalid_argument(u8"WebP compression method must be between 0 and 6");
+    }
+    if((options.Quality < 0) || (options.Quality > 100)) {
+      throw std::invalid_argument(u8"WebP quality must be between 0 and 100");
+    }
+
+    config.method = options.Method;
+    if(options.Lossless) {
+      config.lossless = 1;
+      config.exact = 1; // Keep the color of fully transparent pixels
+
+      // In lossless mode, libwebp uses the quality as another knob for its effort
+      config.quality = static_cast<float>(options.Method * 100) / 6.0f;
+    } else {
+      config.quality = static_cast<float>(options.Quality);
+    }
+
+    if(!::WebPValidateConfig(&config)) {
+      throw std::invalid_argument(u8"Invalid WebP save options");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hands the pixels of a bitmap over to libwebp</summary>
+  /// <param name="picture">Picture the pixels will be imported into</param>
+  /// <param name="memory">Bitmap memory holding 8 bit RGB, BGR, RGBA or BGRA pixels</param>
+  /// <returns>False if libwebp could not import the pixel format</returns>
+  bool tryImportPixels(::WebPPicture &picture, const Nuclex::Pixels::BitmapMemory &memory) {
+    using Nuclex::Pixels::PixelFormat;
+
+    const std::uint8_t *pixels = static_cast<const std::uint8_t *>(memory.Pixels);
+    int stride = static_cast<int>(memory.Stride);
+    int result;
+    switch(memory.PixelFormat) {
+      case PixelFormat::R8_G8_B8_Unsigned: {
+        result = ::WebPPictureImportRGB(&picture, pixels, stride);
+        break;
+      }
+      case PixelFormat::B8_G8_R8_Unsigned: {
+        result = ::WebPPictureImportBGR(&picture, pixels, stride);
+        break;
+      }
+      case PixelFormat::R8_G8_B8_A8_Unsigned: {
+        result = ::WebPPictureImportRGBA(&picture, pixels, stride);
+        break;
+      }
+      case PixelFormat::B8_G8_R8_A8_Unsigned: {
+        result = ::WebPPictureImportBGRA(&picture, pixels, stride);
+        break;
+      }
+      default: {
+        return false;
+      }
+    }
+
+    if(result == 0) {
+      throw std::bad_alloc();
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage { namespace WebP {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WebPBitmapCodec::WebPBitmapCodec() :
+    name(u8"WebP (.webp)") {
+    this->knownFileExtensions.push_back(u8"webp");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WebPBitmapCodec::IsValidFileHeader(
+    const std::uint8_t *fileHeader, std::size_t fileHeaderByteCount
+  ) const {
+    return hasWebPSignature(fileHeader, fileHeaderByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WebPBitmapCodec::CanLoad(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */
+  ) const {
+
+    // If a file extension is offered, do an early exit if it doesn't match
+    if(!MightHaveFileExtension(extensionHint, this->knownFileExtensions)) {
+      return false;
+    }
+
+    if(source.GetSize() < 12) {
+      return false;
+    }
+
+    std::uint8_t fileHeader[12];
+    source.ReadAt(0, 12, fileHeader);
+    return hasWebPSignature(fileHeader, 12);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WebPBitmapCodec::CanSave() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapInfo WebPBitmapCodec::TryReadInfo(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint; // Unused
+
+    ::WebPBitstreamFeatures features;
+    if(!tryReadWebPFeatures(source, features)) {
+      BitmapInfo result;
+      result.Loadable = false;
+      return result;
+    }
+
+    Rectangle region = GetLoadRegion(options, features.width, features.height);
+
+    BitmapInfo result;
+    result.Loadable = true;
+    result.Width = region.MaxX - region.MinX;
+    result.Height = region.MaxY - region.MinY;
+    result.PixelFormat = getPixelFormat(features);
+    result.MemoryUsage = (
+      (CountRequiredBytes(result.PixelFormat, result.Width) * result.Height) +
+      (sizeof(std::intptr_t) * 3) +
+      (sizeof(std::size_t) * 3) +
+      (sizeof(int) * 2)
+    );
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  OptionalBitmap WebPBitmapCodec::TryLoad(
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    NUCLEX_PIXELS_INSTRUMENT_ZONE(u8"Nuclex.Pixels.WebPBitmapCodec.TryLoad");
+    (void)extensionHint; // Unused
+
+    ::WebPBitstreamFeatures features;
+    if(!tryReadWebPFeatures(source, features)) {
+      return OptionalBitmap();
+    }
+
+    Rectangle region = GetLoadRegion(options, features.width, features.height);
+    Bitmap image(region.MaxX - region.MinX, region.MaxY - region.MinY, getPixelFormat(features));
+
+    FileContents contents(source);
+    decodeWebP(contents, features, region, image.Access());
+
+    return OptionalBitmap(std::move(image));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WebPBitmapCodec::TryReload(
+    Bitmap &exactlyFittingBitmap,
+    const VirtualFile &source, const std::string &extensionHint /* = std::string() */,
+    const LoadOptions &options /* = LoadOptions() */
+  ) const {
+    (void)extensionHint; // Unused
+
+    ::WebPBitstreamFeatures features;
+    if(!tryReadWebPFeatures(source, features)) {
+      return false;
+    }
+
+    Rectangle region = GetLoadRegion(options, features.width, features.height);
+
+    // The bitmap may be a view into a larger bitmap, only its size has to fit
+    const BitmapMemory &memory = exactlyFittingBitmap.Access();
+    bool matchesExpectations = (
+      (memory.Width == region.MaxX - region.MinX) &&
+      (memory.Height == region.MaxY - region.MinY) &&
+      (memory.PixelFormat == getPixelFormat(features))
+    );
+    if(!matchesExpectations) {
+      throw std::runtime_error(
+        u8"Bitmap provided to Reload() does not have a correct dimensions and pixel format"
+      );
+    }
+
+    FileContents contents(source);
+    decodeWebP(contents, features, region, memory);
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WebPBitmapCodec::Save(
+    const Bitmap &bitmap, VirtualFile &target, const SaveOptions &options /* = SaveOptions() */
+  ) const {
+    const BitmapMemory &memory = bitmap.Access();
+    if((memory.Width == 0) || (memory.Height == 0)) {
+      throw std::invalid_argument(u8"WebP files can not store empty bitmaps");
+    }
+    if((memory.Width > WebPMaximumDimension) || (memory.Height > WebPMaximumDimension)) {
+      throw std::invalid_argument(u8"Bitmap is too large to be stored in a WebP file");
+    }
+
+    ::WebPConfig config;
+    configureEncoder(config, options.WebP);
+
+    ::WebPPicture picture;
+    if(!::WebPPictureInit(&picture)) {
+      throw std::runtime_error(u8"libwebp version does not match the headers");
+    }
+    picture.use_argb = config.lossless;
+    picture.width = static_cast<int>(memory.Width);
+    picture.height = static_cast<int>(memory.Height);
+
+    {
+      WebPPictureScope pictureScope(picture);
+
+      // libwebp imports 8 bit RGB(A) and BGR(A) pixels on its own, all other
+      // pixel formats are converted to 8 bit RGB or RGBA first
+      bool isImported = (memory.Stride > 0) && tryImportPixels(picture, memory);
+      if(!isImported) {
+        bool hasAlpha = (Private::DescribePixelFormat(memory.PixelFormat).BitCounts[3] > 0);
+        Bitmap converted(
+          memory.Width, memory.Height,
+          hasAlpha ? PixelFormat::R8_G8_B8_A8_Unsigned : PixelFormat::R8_G8_B8_Unsigned
+        );
+        PixelFormatConverter::Convert(memory, converted.Access());
+        tryImportPixels(picture, converted.Access());
+      }
+
+      WebPWriteEnvironment environment(target);
+      picture.writer = &writeWebPData;
+      picture.custom_ptr = &environment;
+
+      if(!::WebPEncode(&config, &picture)) {
+        if(environment.Error) {
+          std::rethrow_exception(environment.Error);
+        }
+        throw std::runtime_error(getEncoderErrorMessage(picture.error_code));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Pixels::Storage::WebP
+
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
@@ -0,0 +1,133 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "WriteBufferedVirtualFile.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WriteBufferedVirtualFile::WriteBufferedVirtualFile(
+    std::unique_ptr<VirtualFile> file, std::size_t writeBufferByteCount
+  ) :
+    file(std::move(file)),
+    bufferStart(0),
+    bufferedByteCount(0) {
+
+    if(!this->file) {
+      throw std::invalid_argument(u8"File to buffer writes for must not be null");
+    }
+    if(writeBufferByteCount == 0) {
+      throw std::invalid_argument(u8"Write buffer must be larger than zero");
+    }
+
+    this->writeBuffer.resize(writeBufferByteCount);
+    this->bufferStart = this->file->GetSize();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WriteBufferedVirtualFile::~WriteBufferedVirtualFile() {
+    try {
+      flushBuffer();
+    }
+    catch(...) {
+      // Destructors can't throw. Callers who care have called Flush() before.
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t WriteBufferedVirtualFile::GetSize() const {
+    return std::max(this->file->GetSize(), this->bufferStart + this->bufferedByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteBufferedVirtualFile::ReadAt(
+    std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+  ) const {
+    flushBuffer();
+    this->file->ReadAt(start, byteCount, buffer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteBufferedVirtualFile::WriteAt(
+    std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+  ) {
+    while(byteCount > 0) {
+
+      // Writes overlapping the buffered data or continuing right after it are copied
+      // into the buffer for as long as there is room
+      std::uint64_t bufferEnd = this->bufferStart + this->bufferedByteCount;
+      if((start >= this->bufferStart) && (start <= bufferEnd)) {
+        std::size_t offset = static_cast<std::size_t>(start - this->bufferStart);
+        std::size_t chunkByteCount = std::min(byteCount, this->writeBuffer.size() - offset);
+        if(chunkByteCount > 0) {
+          std::memcpy(&this->writeBuffer[offset], buffer, chunkByteCount);
+          this->bufferedByteCount = std::max(this->bufferedByteCount, offset + chunkByteCount);
+
+          start += chunkByteCount;
+          buffer += chunkByteCount;
+          byteCount -= chunkByteCount;
+          continue;
+        }
+      }
+
+      // The buffer is full or the write goes elsewhere, so get rid of the buffered data
+      flushBuffer();
+
+      // Writes that would not fit the buffer go straight to the file. So do writes
+      // leaving a gap after the end of the file, which lets the file report the error.
+      bool canBuffer = (
+        (byteCount < this->writeBuffer.size()) &&
+        (start <= this->file->GetSize())
+      );
+      if(!canBuffer) {
+        this->file->WriteAt(start, byteCount, buffer);
+        return;
+      }
+
+      this->bufferStart = start;
+
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WriteBufferedVirtualFile::flushBuffer() const {
+    if(this->bufferedByteCount > 0) {
+      this->file->WriteAt(this->bufferStart, this->bufferedByteCount, &this->writeBuffer[0]);
+      this->bufferStart += this->bufferedByteCount;
+      this->bufferedByteCount = 0;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
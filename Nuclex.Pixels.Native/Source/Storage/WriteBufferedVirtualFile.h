@@ -0,0 +1,112 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_PIXELS_STORAGE_WRITEBUFFEREDVIRTUALFILE_H
+#define NUCLEX_PIXELS_STORAGE_WRITEBUFFEREDVIRTUALFILE_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+
+#include <vector>
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects many small writes to another file into few large ones</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The image libraries hand out their output in small pieces (libpng and libjpeg
+  ///     emit a few KiB at a time). On a real file, each of these would become a system
+  ///     call. This wrapper copies the writes into a large buffer and only writes to
+  ///     the wrapped file once the buffer is full or when it is flushed.
+  ///   </para>
+  ///   <para>
+  ///     Writes that land inside the buffered range (such as a header being patched
+  ///     after the data has been written) are applied to the buffer as well. Writes
+  ///     elsewhere flush the buffer first. Whatever would not fit into the emptied
+  ///     buffer goes directly to the wrapped file. Call <see cref="Flush" /> when done,
+  ///     the destructor only flushes as a last resort and can not report errors.
+  ///   </para>
+  /// </remarks>
+  class WriteBufferedVirtualFile : public VirtualFile {
+
+    /// <summary>Initializes a new write buffer for the specified file</summary>
+    /// <param name="file">File that will be written to through the buffer</param>
+    /// <param name="writeBufferByteCount">Number of bytes that will be collected</param>
+    public: WriteBufferedVirtualFile(
+      std::unique_ptr<VirtualFile> file, std::size_t writeBufferByteCount
+    );
+
+    /// <summary>Writes any data remaining in the buffer and frees all memory</summary>
+    public: virtual ~WriteBufferedVirtualFile();
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes, including data still in the buffer</returns>
+    public: std::uint64_t GetSize() const override;
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    /// <remarks>
+    ///   Buffered data is written to the wrapped file first, so reads always
+    ///   see what has been written before them.
+    /// </remarks>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override;
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override;
+
+    /// <summary>Writes any data remaining in the buffer to the wrapped file</summary>
+    public: void Flush() { flushBuffer(); }
+
+    private: WriteBufferedVirtualFile(const WriteBufferedVirtualFile &) = delete;
+    private: WriteBufferedVirtualFile &operator =(const WriteBufferedVirtualFile &) = delete;
+
+    /// <summary>Writes the buffered data to the wrapped file and empties the buffer</summary>
+    /// <remarks>
+    ///   Declared const so that <see cref="ReadAt" /> can flush before reading.
+    /// </remarks>
+    private: void flushBuffer() const;
+
+    /// <summary>File the buffer is writing to</summary>
+    private: std::unique_ptr<VirtualFile> file;
+    /// <summary>Holds the data that has not been written to the file yet</summary>
+    private: mutable std::vector<std::uint8_t> writeBuffer;
+    /// <summary>Offset in the file the buffer's contents begin at</summary>
+    private: mutable std::uint64_t bufferStart;
+    /// <summary>Number of bytes currently held in the buffer</summary>
+    private: mutable std::size_t bufferedByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // NUCLEX_PIXELS_STORAGE_WRITEBUFFEREDVIRTUALFILE_H
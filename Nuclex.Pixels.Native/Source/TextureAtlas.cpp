@@ -0,0 +1,203 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/TextureAtlas.h"
+#include "Nuclex/Pixels/BitmapBlitter.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include <algorithm> // for std::min(), std::max()
+#include <limits> // for std::numeric_limits
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TextureAtlas::TextureAtlas(
+    std::size_t width, std::size_t height, PixelFormat pixelFormat,
+    std::size_t padding /* = 0 */
+  ) :
+    bitmap(width, height, pixelFormat),
+    padding(padding),
+    occupiedPixelCount(0),
+    skyline() {
+    BitmapBlitter::Clear(this->bitmap.Access());
+    this->skyline.push_back(SkylineSegment { 0, 0, width });
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TextureAtlas::TryReserve(std::size_t width, std::size_t height, Rectangle &placement) {
+    std::size_t atlasWidth = this->bitmap.GetWidth();
+    std::size_t atlasHeight = this->bitmap.GetHeight();
+    if((width > atlasWidth) || (height > atlasHeight)) {
+      return false;
+    }
+    if((width == 0) || (height == 0)) {
+      placement = Rectangle(0, 0, 0, 0);
+      return true;
+    }
+
+    // Try each segment as the left end of the sprite and pick the position where
+    // the sprite's bottom edge ends up lowest. On ties, the leftmost one wins.
+    std::size_t segmentCount = this->skyline.size();
+    std::size_t bestIndex = segmentCount;
+    std::size_t bestY = 0;
+    std::size_t bestBottom = std::numeric_limits<std::size_t>::max();
+    for(std::size_t index = 0; index < segmentCount; ++index) {
+      std::size_t x = this->skyline[index].X;
+      if(width > atlasWidth - x) {
+        break; // Segments are sorted by X, so the ones after this won't fit either
+      }
+
+      // The sprite rests on the highest segment below it or its padding, so sprites
+      // placed earlier to the right keep their distance, too
+      std::size_t paddedWidth = std::min(width + this->padding, atlasWidth - x);
+      std::size_t y = 0;
+      std::size_t coveredWidth = 0;
+      for(std::size_t other = index; coveredWidth < paddedWidth; ++other) {
+        y = std::max(y, this->skyline[other].Y);
+        coveredWidth += this->skyline[other].Width;
+      }
+
+      if((y <= atlasHeight - height) && (y + height < bestBottom)) {
+        bestIndex = index;
+        bestY = y;
+        bestBottom = y + height;
+      }
+    }
+    if(bestIndex == segmentCount) {
+      return false;
+    }
+
+    // Raise the skyline above the sprite, including the padding to its right and bottom
+    std::size_t x = this->skyline[bestIndex].X;
+    std::size_t raisedWidth = std::min(width + this->padding, atlasWidth - x);
+    std::size_t raisedEndX = x + raisedWidth;
+
+    std::size_t endIndex = bestIndex;
+    while((endIndex < segmentCount) && (this->skyline[endIndex].X < raisedEndX)) {
+      SkylineSegment &segment = this->skyline[endIndex];
+      if(segment.X + segment.Width > raisedEndX) {
+        segment.Width -= raisedEndX - segment.X;
+        segment.X = raisedEndX;
+        break;
+      }
+      ++endIndex;
+    }
+
+    this->skyline.erase(this->skyline.begin() + bestIndex, this->skyline.begin() + endIndex);
+    this->skyline.insert(
+      this->skyline.begin() + bestIndex,
+      SkylineSegment { x, bestY + height + this->padding, raisedWidth }
+    );
+
+    // Join neighbouring segments of the same height so the list stays short
+    for(std::size_t index = 1; index < this->skyline.size();) {
+      if(this->skyline[index - 1].Y == this->skyline[index].Y) {
+        this->skyline[index - 1].Width += this->skyline[index].Width;
+        this->skyline.erase(this->skyline.begin() + index);
+      } else {
+        ++index;
+      }
+    }
+
+    this->occupiedPixelCount += width * height;
+    placement = Rectangle::FromPositionAndSize(x, bestY, width, height);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Bitmap TextureAtlas::GetSlot(const Rectangle &placement) {
+    return this->bitmap.GetView(
+      placement.MinX, placement.MinY,
+      placement.MaxX - placement.MinX, placement.MaxY - placement.MinY
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TextureAtlas::TryAdd(const BitmapMemory &sprite, Rectangle &placement) {
+    if(!TryReserve(sprite.Width, sprite.Height, placement)) {
+      return false;
+    }
+
+    BitmapBlitter::Blit(sprite, this->bitmap, placement.MinX, placement.MinY);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TextureAtlas::TryLoad(
+    const Storage::BitmapSerializer &serializer,
+    const Storage::VirtualFile &file, const std::string &extensionHint,
+    Rectangle &placement
+  ) {
+    BitmapInfo info = serializer.TryReadInfo(file, extensionHint);
+    if(!info.Loadable) {
+      throw Errors::FileFormatError(u8"File format not supported by any registered codec");
+    }
+    if(!TryReserve(info.Width, info.Height, placement)) {
+      return false;
+    }
+
+    Bitmap slot = GetSlot(placement);
+    serializer.Reload(slot, file, extensionHint);
+    this->bitmap.MarkDirty(placement);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TextureAtlas::TryLoad(
+    const Storage::BitmapSerializer &serializer, const std::string &path,
+    Rectangle &placement
+  ) {
+    BitmapInfo info = serializer.TryReadInfo(path);
+    if(!info.Loadable) {
+      throw Errors::FileFormatError(u8"File format not supported by any registered codec");
+    }
+    if(!TryReserve(info.Width, info.Height, placement)) {
+      return false;
+    }
+
+    Bitmap slot = GetSlot(placement);
+    serializer.Reload(slot, path);
+    this->bitmap.MarkDirty(placement);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TextureAtlas::Clear() {
+    BitmapBlitter::Clear(this->bitmap);
+
+    this->skyline.clear();
+    this->skyline.push_back(SkylineSegment { 0, 0, this->bitmap.GetWidth() });
+    this->occupiedPixelCount = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
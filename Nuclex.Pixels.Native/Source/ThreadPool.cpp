@@ -0,0 +1,351 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/ThreadPool.h"
+
+#include "NumaHelpers.h"
+
+#include <algorithm> // for std::min()
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <exception> // for std::exception_ptr
+#include <memory> // for std::unique_ptr
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Part of a batch that is preferably processed by one NUMA node</summary>
+  struct NodeRange {
+
+    /// <summary>Index that will be handed out to the next thread asking for work</summary>
+    public: std::atomic<std::size_t> NextTaskIndex;
+    /// <summary>Index one past the last task in the range</summary>
+    public: std::size_t EndIndex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Batch of tasks that is currently being processed by the thread pool</summary>
+  struct Batch {
+
+    /// <summary>Function that invokes the task with an index</summary>
+    public: void (*Function)(void *task, std::size_t taskIndex);
+    /// <summary>Task that will be passed to the function</summary>
+    public: void *Task;
+    /// <summary>Total number of times the task will be invoked</summary>
+    public: std::size_t TaskCount;
+    /// <summary>Index that will be handed out to the next thread asking for work</summary>
+    public: std::atomic<std::size_t> NextTaskIndex;
+    /// <summary>Parts of the batch for each NUMA node, null if not split by node</summary>
+    public: NodeRange *Ranges;
+    /// <summary>Number of parts the batch has been split into</summary>
+    public: std::size_t RangeCount;
+    /// <summary>Number of worker threads currently processing this batch</summary>
+    public: std::size_t ActiveWorkerCount;
+    /// <summary>First exception thrown by any of the tasks</summary>
+    public: std::exception_ptr Error;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct ThreadPool::Implementation {
+
+    /// <summary>Initializes a new thread pool implementation</summary>
+    public: Implementation() :
+      NodeCount(1),
+      Ranges(),
+      CurrentBatch(nullptr),
+      Generation(0),
+      ShuttingDown(false) {}
+
+    /// <summary>Keeps taking tasks from a batch until all have been handed out</summary>
+    /// <param name="batch">Batch whose tasks will be processed</param>
+    /// <param name="nodeIndex">NUMA node whose part of the batch will be processed first</param>
+    public: void ProcessTasks(Batch &batch, std::size_t nodeIndex) {
+      if(batch.Ranges == nullptr) {
+        ProcessRange(batch, batch.NextTaskIndex, batch.TaskCount);
+        return;
+      }
+
+      for(std::size_t offset = 0; offset < batch.RangeCount; ++offset) {
+        NodeRange &range = batch.Ranges[(nodeIndex + offset) % batch.RangeCount];
+        if(!ProcessRange(batch, range.NextTaskIndex, range.EndIndex)) {
+          return;
+        }
+      }
+    }
+
+    /// <summary>Keeps taking tasks from a range until all have been handed out</summary>
+    /// <param name="batch">Batch the range belongs to</param>
+    /// <param name="nextTaskIndex">Index of the next task in the range</param>
+    /// <param name="endIndex">Index one past the last task in the range</param>
+    /// <returns>False if a task has failed and the batch was cancelled</returns>
+    public: bool ProcessRange(
+      Batch &batch, std::atomic<std::size_t> &nextTaskIndex, std::size_t endIndex
+    ) {
+      for(;;) {
+        std::size_t taskIndex = nextTaskIndex.fetch_add(1, std::memory_order_relaxed);
+        if(taskIndex >= endIndex) {
+          return true;
+        }
+
+        try {
+          batch.Function(batch.Task, taskIndex);
+        }
+        catch(...) {
+          {
+            std::lock_guard<std::mutex> stateLock(this->StateMutex);
+            if(!batch.Error) {
+              batch.Error = std::current_exception();
+            }
+          }
+
+          // Skip all tasks that have not been handed out yet
+          batch.NextTaskIndex.store(batch.TaskCount, std::memory_order_relaxed);
+          for(std::size_t index = 0; index < batch.RangeCount; ++index) {
+            batch.Ranges[index].NextTaskIndex.store(
+              batch.Ranges[index].EndIndex, std::memory_order_relaxed
+            );
+          }
+          return false;
+        }
+      }
+    }
+
+    /// <summary>Main loop of the worker threads</summary>
+    /// <param name="nodeIndex">NUMA node the worker belongs to</param>
+    public: void RunWorker(std::size_t nodeIndex) {
+      if(this->NodeCount > 1) {
+        PinCallingThreadToNumaNode(nodeIndex);
+      }
+
+      std::size_t seenGeneration = 0;
+
+      std::unique_lock<std::mutex> stateLock(this->StateMutex);
+      for(;;) {
+        this->WorkAvailable.wait(
+          stateLock,
+          [this, seenGeneration] {
+            return (
+              this->ShuttingDown ||
+              ((this->CurrentBatch != nullptr) && (this->Generation != seenGeneration))
+            );
+          }
+        );
+        if(this->ShuttingDown) {
+          return;
+        }
+
+        // Join the batch. The submitting thread can only retire the batch while holding
+        // the state mutex, so the batch stays alive until we check out again.
+        seenGeneration = this->Generation;
+        Batch &batch = *this->CurrentBatch;
+        ++batch.ActiveWorkerCount;
+
+        stateLock.unlock();
+        ProcessTasks(batch, nodeIndex);
+        stateLock.lock();
+
+        --batch.ActiveWorkerCount;
+        if(batch.ActiveWorkerCount == 0) {
+          this->WorkFinished.notify_all();
+        }
+      }
+    }
+
+    /// <summary>Tells all worker threads to terminate and waits until they have</summary>
+    public: void StopWorkers() {
+      {
+        std::lock_guard<std::mutex> stateLock(this->StateMutex);
+        this->ShuttingDown = true;
+      }
+      this->WorkAvailable.notify_all();
+
+      for(std::size_t index = 0; index < this->Threads.size(); ++index) {
+        this->Threads[index].join();
+      }
+    }
+
+    /// <summary>Number of NUMA nodes the worker threads have been spread over</summary>
+    public: std::size_t NodeCount;
+    /// <summary>Parts of the current batch for each NUMA node</summary>
+    /// <remarks>Only touched by the thread holding the batch mutex</remarks>
+    public: std::unique_ptr<NodeRange[]> Ranges;
+    /// <summary>Worker threads that have been started by the thread pool</summary>
+    public: std::vector<std::thread> Threads;
+    /// <summary>Ensures that only one batch is processed at a time</summary>
+    public: std::mutex BatchMutex;
+    /// <summary>Protects the batch pointer, the worker counts and the shutdown flag</summary>
+    public: std::mutex StateMutex;
+    /// <summary>Signalled when a new batch has been submitted or on shutdown</summary>
+    public: std::condition_variable WorkAvailable;
+    /// <summary>Signalled when the last worker has checked out of a batch</summary>
+    public: std::condition_variable WorkFinished;
+    /// <summary>Batch that workers can currently join, null if none</summary>
+    public: Batch *CurrentBatch;
+    /// <summary>Incremented for each batch so workers join every batch only once</summary>
+    public: std::size_t Generation;
+    /// <summary>Whether the worker threads should terminate</summary>
+    public: bool ShuttingDown;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ThreadPool::ThreadPool(
+    std::size_t threadCount /* = 0 */, bool pinThreadsToNumaNodes /* = false */
+  ) :
+    implementation(new Implementation()) {
+
+    if(threadCount == 0) {
+      threadCount = std::thread::hardware_concurrency();
+    }
+
+    if(pinThreadsToNumaNodes && (threadCount > 1)) {
+      std::size_t nodeCount = std::min(Nuclex::Pixels::CountNumaNodes(), threadCount);
+      if(nodeCount > 1) {
+        this->implementation->NodeCount = nodeCount;
+        this->implementation->Ranges.reset(new NodeRange[nodeCount]);
+      }
+    }
+
+    // The thread submitting a batch also works on it, so start one thread less
+    try {
+      for(std::size_t index = 1; index < threadCount; ++index) {
+        std::size_t nodeIndex = index * this->implementation->NodeCount / threadCount;
+        this->implementation->Threads.emplace_back(
+          &Implementation::RunWorker, this->implementation, nodeIndex
+        );
+      }
+    }
+    catch(...) {
+      this->implementation->StopWorkers();
+      delete this->implementation;
+      throw;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ThreadPool::~ThreadPool() {
+    this->implementation->StopWorkers();
+    delete this->implementation;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ThreadPool::CountThreads() const {
+    return this->implementation->Threads.size() + 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ThreadPool::CountNumaNodes() const {
+    return this->implementation->NodeCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ThreadPool::getNumaNodeId(std::size_t nodeIndex) const {
+    return GetNumaNodeId(nodeIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ThreadPool::runTasks(std::size_t taskCount, TaskFunction *function, void *task) {
+
+    // If there's nothing to distribute, avoid waking up the worker threads
+    if((taskCount < 2) || this->implementation->Threads.empty()) {
+      for(std::size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex) {
+        function(task, taskIndex);
+      }
+      return;
+    }
+
+    Batch batch;
+    batch.Function = function;
+    batch.Task = task;
+    batch.TaskCount = taskCount;
+    batch.NextTaskIndex.store(0, std::memory_order_relaxed);
+    batch.Ranges = nullptr;
+    batch.RangeCount = 0;
+    batch.ActiveWorkerCount = 0;
+
+    std::lock_guard<std::mutex> batchLock(this->implementation->BatchMutex);
+
+    // Give each NUMA node a contiguous part of the batch. The ranges are reused by
+    // all batches, which is fine because only one batch runs at a time.
+    std::size_t nodeCount = this->implementation->NodeCount;
+    std::size_t nodeIndex = 0;
+    if(nodeCount > 1) {
+      NodeRange *ranges = this->implementation->Ranges.get();
+      for(std::size_t index = 0; index < nodeCount; ++index) {
+        ranges[index].NextTaskIndex.store(
+          taskCount * index / nodeCount, std::memory_order_relaxed
+        );
+        ranges[index].EndIndex = taskCount * (index + 1) / nodeCount;
+      }
+      batch.Ranges = ranges;
+      batch.RangeCount = nodeCount;
+
+      nodeIndex = GetCurrentNumaNodeIndex() % nodeCount;
+    }
+
+    {
+      std::lock_guard<std::mutex> stateLock(this->implementation->StateMutex);
+      this->implementation->CurrentBatch = &batch;
+      ++this->implementation->Generation;
+    }
+    this->implementation->WorkAvailable.notify_all();
+
+    this->implementation->ProcessTasks(batch, nodeIndex);
+
+    // Retire the batch so no more workers join it, then wait for the ones still in it
+    {
+      std::unique_lock<std::mutex> stateLock(this->implementation->StateMutex);
+      this->implementation->CurrentBatch = nullptr;
+      this->implementation->WorkFinished.wait(
+        stateLock, [&batch] { return (batch.ActiveWorkerCount == 0); }
+      );
+    }
+
+    if(batch.Error) {
+      std::rethrow_exception(batch.Error);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,324 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/TilePyramid.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether all channels of a pixel format are 8 bit unsigned integers</summary>
+  /// <param name="pixelFormat">Pixel format that will be checked</param>
+  /// <returns>True if the pixel format can be averaged byte by byte</returns>
+  bool hasOnlyUnsigned8BitChannels(Nuclex::Pixels::PixelFormat pixelFormat) {
+    using Nuclex::Pixels::PixelFormat;
+
+    switch(pixelFormat) {
+      case PixelFormat::R8_Unsigned:
+      case PixelFormat::R8_G8_Unsigned:
+      case PixelFormat::R8_G8_B8_Unsigned:
+      case PixelFormat::B8_G8_R8_Unsigned:
+      case PixelFormat::R8_G8_B8_A8_Unsigned:
+      case PixelFormat::A8_B8_G8_R8_Unsigned:
+      case PixelFormat::B8_G8_R8_A8_Unsigned:
+      case PixelFormat::A8_R8_G8_B8_Unsigned: {
+        return true;
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Averages two rows into one row of half the width</summary>
+  /// <param name="upperRow">Upper row of the pairs of rows that will be averaged</param>
+  /// <param name="lowerRow">Lower row of the pairs of rows that will be averaged</param>
+  /// <param name="width">Width of the rows that will be averaged in pixels</param>
+  /// <param name="bytesPerPixel">Number of bytes (and channels) in each pixel</param>
+  /// <param name="targetRow">Receives the averaged row</param>
+  /// <remarks>
+  ///   If the width is odd, the last pixel is averaged with itself.
+  /// </remarks>
+  void downsampleRows(
+    const std::uint8_t *upperRow, const std::uint8_t *lowerRow,
+    std::size_t width, std::size_t bytesPerPixel, std::uint8_t *targetRow
+  ) {
+    std::size_t targetWidth = (width + 1) / 2;
+    for(std::size_t x = 0; x < targetWidth; ++x) {
+      std::size_t left = x * 2 * bytesPerPixel;
+      std::size_t right = std::min(x * 2 + 1, width - 1) * bytesPerPixel;
+      for(std::size_t channel = 0; channel < bytesPerPixel; ++channel) {
+        unsigned int sum = (
+          static_cast<unsigned int>(upperRow[left + channel]) +
+          static_cast<unsigned int>(upperRow[right + channel]) +
+          static_cast<unsigned int>(lowerRow[left + channel]) +
+          static_cast<unsigned int>(lowerRow[right + channel])
+        );
+        targetRow[x * bytesPerPixel + channel] = static_cast<std::uint8_t>((sum + 2) / 4);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects the rows of one pyramid level and emits its tiles</summary>
+  class PyramidLevel {
+
+    /// <summary>Initializes a new pyramid level</summary>
+    /// <param name="level">Number of the level in Deep Zoom order</param>
+    /// <param name="width">Width of the level in pixels</param>
+    /// <param name="height">Height of the level in pixels</param>
+    /// <param name="pixelFormat">Pixel format of the level's rows</param>
+    /// <param name="tileSize">Width and height of the tiles</param>
+    public: PyramidLevel(
+      std::size_t level, std::size_t width, std::size_t height,
+      Nuclex::Pixels::PixelFormat pixelFormat, std::size_t tileSize
+    ) :
+      level(level),
+      width(width),
+      height(height),
+      tileSize(tileSize),
+      strip(width, std::min(tileSize, height), pixelFormat),
+      stripRowCount(0),
+      receivedRowCount(0),
+      pendingRow(Nuclex::Pixels::CountRequiredBytes(pixelFormat, width)),
+      hasPendingRow(false) {}
+
+    /// <summary>Width of the level in pixels</summary>
+    public: std::size_t GetWidth() const { return this->width; }
+
+    /// <summary>Height of the level in pixels</summary>
+    public: std::size_t GetHeight() const { return this->height; }
+
+    /// <summary>Adds the next row to the level</summary>
+    /// <param name="row">Row that will be added</param>
+    /// <returns>True if the row of tiles is complete and needs to be emitted</returns>
+    public: bool AddRow(const std::uint8_t *row) {
+      const Nuclex::Pixels::BitmapMemory &memory = this->strip.Access();
+      std::memcpy(
+        static_cast<std::uint8_t *>(memory.Pixels) + (memory.Stride * this->stripRowCount),
+        row, this->pendingRow.size()
+      );
+      ++this->stripRowCount;
+      ++this->receivedRowCount;
+
+      return (
+        (this->stripRowCount == this->tileSize) || (this->receivedRowCount == this->height)
+      );
+    }
+
+    /// <summary>Pairs a row with the previous one for downsampling</summary>
+    /// <param name="row">Row that will be paired up</param>
+    /// <param name="bytesPerPixel">Number of bytes in each pixel</param>
+    /// <param name="targetRow">Receives the downsampled row if one was produced</param>
+    /// <returns>True if a downsampled row was written into the target row</returns>
+    /// <remarks>
+    ///   Must be called after <see cref="AddRow" /> for the same row. The last row of
+    ///   a level with an odd height is averaged with itself.
+    /// </remarks>
+    public: bool Downsample(
+      const std::uint8_t *row, std::size_t bytesPerPixel, std::uint8_t *targetRow
+    ) {
+      if(this->hasPendingRow) {
+        downsampleRows(this->pendingRow.data(), row, this->width, bytesPerPixel, targetRow);
+        this->hasPendingRow = false;
+        return true;
+      }
+
+      if(this->receivedRowCount == this->height) {
+        downsampleRows(row, row, this->width, bytesPerPixel, targetRow);
+        return true;
+      }
+
+      std::memcpy(this->pendingRow.data(), row, this->pendingRow.size());
+      this->hasPendingRow = true;
+      return false;
+    }
+
+    /// <summary>Hands the completed row of tiles to a tile sink</summary>
+    /// <param name="sink">Tile sink that will receive the tiles</param>
+    /// <param name="threadPool">Thread pool on which the tile sink will be invoked</param>
+    public: void EmitTiles(Nuclex::Pixels::TileSink &sink, Nuclex::Pixels::ThreadPool &threadPool) {
+      std::size_t tileY = (this->receivedRowCount - 1) / this->tileSize;
+      std::size_t tileCount = (this->width + this->tileSize - 1) / this->tileSize;
+
+      // Views are set up front, creating them touches the strip's reference counter
+      std::vector<Nuclex::Pixels::Bitmap> tiles;
+      tiles.reserve(tileCount);
+      for(std::size_t tileX = 0; tileX < tileCount; ++tileX) {
+        std::size_t x = tileX * this->tileSize;
+        tiles.push_back(
+          this->strip.GetView(
+            x, 0, std::min(this->tileSize, this->width - x), this->stripRowCount
+          )
+        );
+      }
+
+      std::size_t level = this->level;
+      threadPool.ForEach(
+        tileCount,
+        [&sink, &tiles, level, tileY](std::size_t tileX) {
+          sink.WriteTile(level, tileX, tileY, tiles[tileX]);
+        }
+      );
+
+      this->stripRowCount = 0;
+    }
+
+    /// <summary>Number of the level in Deep Zoom order</summary>
+    private: std::size_t level;
+    /// <summary>Width of the level in pixels</summary>
+    private: std::size_t width;
+    /// <summary>Height of the level in pixels</summary>
+    private: std::size_t height;
+    /// <summary>Width and height of the tiles</summary>
+    private: std::size_t tileSize;
+    /// <summary>Rows of the row of tiles currently being collected</summary>
+    private: Nuclex::Pixels::Bitmap strip;
+    /// <summary>Number of rows collected in the strip so far</summary>
+    private: std::size_t stripRowCount;
+    /// <summary>Number of rows the level has received in total</summary>
+    private: std::size_t receivedRowCount;
+    /// <summary>Upper row of the pair of rows that will be downsampled next</summary>
+    private: std::vector<std::uint8_t> pendingRow;
+    /// <summary>Whether the pending row holds a row waiting for its partner</summary>
+    private: bool hasPendingRow;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TilePyramid::CountLevels(std::size_t width, std::size_t height) {
+    std::size_t levelCount = 1;
+    while((width > 1) || (height > 1)) {
+      width = (width + 1) / 2;
+      height = (height + 1) / 2;
+      ++levelCount;
+    }
+    return levelCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TilePyramid::Generate(
+    std::unique_ptr<RowSource> &&source, TileSink &sink, ThreadPool &threadPool,
+    std::size_t tileSize /* = DefaultTileSize */
+  ) {
+    if(tileSize == 0) {
+      throw std::invalid_argument(u8"Tile size must be larger than zero");
+    }
+
+    std::unique_ptr<RowSource> rows(std::move(source));
+    if(!hasOnlyUnsigned8BitChannels(rows->GetPixelFormat())) {
+      rows = PixelFormatConverter::ConvertRows(
+        std::move(rows), PixelFormat::R8_G8_B8_A8_Unsigned
+      );
+    }
+
+    std::size_t width = rows->GetWidth();
+    std::size_t height = rows->GetHeight();
+    if((width == 0) || (height == 0)) {
+      return;
+    }
+
+    PixelFormat pixelFormat = rows->GetPixelFormat();
+    std::size_t bytesPerPixel = CountBitsPerPixel(pixelFormat) / 8;
+
+    // Set up all levels from the full resolution down to a single pixel
+    std::size_t levelCount = CountLevels(width, height);
+    std::vector<std::unique_ptr<PyramidLevel>> levels;
+    levels.reserve(levelCount);
+    for(std::size_t index = 0; index < levelCount; ++index) {
+      levels.emplace_back(
+        new PyramidLevel(levelCount - 1 - index, width, height, pixelFormat, tileSize)
+      );
+      width = (width + 1) / 2;
+      height = (height + 1) / 2;
+    }
+
+    // Downsampled rows cascade through the levels, each level needs one row to build in
+    std::vector<std::vector<std::uint8_t>> downsampledRows(levelCount);
+    for(std::size_t index = 1; index < levelCount; ++index) {
+      downsampledRows[index].resize(
+        CountRequiredBytes(pixelFormat, levels[index]->GetWidth())
+      );
+    }
+
+    width = levels[0]->GetWidth();
+    height = levels[0]->GetHeight();
+    std::size_t rowByteCount = CountRequiredBytes(pixelFormat, width);
+    std::size_t bandHeight = std::min(GetBandHeight(rowByteCount), height);
+    std::vector<std::uint8_t> bandBuffer(rowByteCount * bandHeight);
+
+    BitmapMemory band;
+    band.Width = width;
+    band.PixelFormat = pixelFormat;
+    band.Stride = static_cast<int>(rowByteCount);
+    band.Pixels = bandBuffer.data();
+
+    for(std::size_t y = 0; y < height; y += bandHeight) {
+      band.Height = std::min(bandHeight, height - y);
+      rows->ReadRows(band);
+
+      for(std::size_t bandY = 0; bandY < band.Height; ++bandY) {
+        const std::uint8_t *row = bandBuffer.data() + (bandY * rowByteCount);
+
+        // Hand the row to the full resolution level, then keep feeding the downsampled
+        // row to the next level for as long as each level completes a pair of rows
+        for(std::size_t index = 0; index < levelCount; ++index) {
+          PyramidLevel &level = *levels[index];
+          if(level.AddRow(row)) {
+            level.EmitTiles(sink, threadPool);
+          }
+          if(index + 1 == levelCount) {
+            break;
+          }
+
+          std::uint8_t *downsampledRow = downsampledRows[index + 1].data();
+          if(!level.Downsample(row, bytesPerPixel, downsampledRow)) {
+            break;
+          }
+          row = downsampledRow;
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,767 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/TiledBitmap.h"
+#include "Nuclex/Pixels/BitmapAllocator.h"
+#include "Nuclex/Pixels/Errors/FileAccessError.h"
+
+#include <algorithm> // for std::min()
+#include <atomic> // for std::atomic
+#include <cstdint> // for std::uint8_t, std::uint64_t
+#include <cstdlib> // for std::getenv()
+#include <cstring> // for std::memcpy(), std::memset()
+#include <memory> // for std::unique_ptr
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+#include <vector> // for std::vector
+
+// The scratch file is opened and mapped with the same helpers the memory mapped
+// file uses. They check for the RealFile header to be included first.
+#include "Storage/RealFile.h"
+#include "Storage/RealFile.Windows.inl"
+#include "Storage/RealFile.Posix.inl"
+
+#if defined(NUCLEX_PIXELS_WIN32)
+#include <WinIoCtl.h> // for FSCTL_SET_SPARSE, FSCTL_SET_ZERO_DATA
+#else
+#include <fcntl.h> // open()
+#include <sys/mman.h> // mmap(), munmap(), madvise()
+#include <unistd.h> // close(), ftruncate(), unlink(), sysconf()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds the specified value to the next multiple of a factor</summary>
+  /// <param name="value">Value that will be rounded up</param>
+  /// <param name="factor">Factor to which the value will be rounded up</param>
+  /// <returns>The next multiple of the specified factor</returns>
+  std::size_t nextMultiple(std::size_t value, std::size_t factor) {
+    std::size_t remainder = value % factor;
+    if(remainder > 0) {
+      value += (factor - remainder);
+    }
+
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the size of the pages the OS maps files in</summary>
+  /// <returns>The size of a memory page in bytes</returns>
+  std::size_t getPageSize() {
+#if defined(NUCLEX_PIXELS_WIN32)
+    SYSTEM_INFO systemInfo;
+    ::GetSystemInfo(&systemInfo);
+    return static_cast<std::size_t>(systemInfo.dwPageSize);
+#else
+    long pageSize = ::sysconf(_SC_PAGESIZE);
+    if(pageSize <= 0) {
+      return 4096;
+    }
+    return static_cast<std::size_t>(pageSize);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_WIN32)
+
+  /// <summary>Creates a scratch file that is deleted when its handle is closed</summary>
+  /// <param name="directory">Directory in which the scratch file will be created</param>
+  /// <returns>The handle of the scratch file</returns>
+  HANDLE createWindowsScratchFile(const std::string &directory) {
+    static std::atomic<unsigned long> scratchFileCounter(0);
+
+    std::vector<wchar_t> utf16Path;
+    if(directory.empty()) {
+      utf16Path.resize(MAX_PATH + 1);
+      DWORD length = ::GetTempPathW(static_cast<DWORD>(utf16Path.size()), &utf16Path[0]);
+      if((length == 0) || (length > MAX_PATH)) {
+        DWORD lastErrorCode = ::GetLastError();
+        throwWindowsFileAccessError(lastErrorCode);
+      }
+      utf16Path.resize(length);
+    } else {
+      utf8ToUtf16Path(directory, utf16Path);
+      if((utf16Path.back() != L'\\') && (utf16Path.back() != L'/')) {
+        utf16Path.push_back(L'\\');
+      }
+    }
+
+    // Build a file name that's unlikely to be taken and retry with another one if it is
+    std::size_t directoryLength = utf16Path.size();
+    for(;;) {
+      wchar_t fileName[64];
+      ::swprintf(
+        fileName, 64, L"NuclexPixelsTiles-%lu-%lu.tmp",
+        static_cast<unsigned long>(::GetCurrentProcessId()), ++scratchFileCounter
+      );
+
+      utf16Path.resize(directoryLength);
+      for(const wchar_t *character = fileName; *character != 0; ++character) {
+        utf16Path.push_back(*character);
+      }
+      utf16Path.push_back(0);
+
+      HANDLE fileHandle = ::CreateFileW(
+        &utf16Path[0],
+        GENERIC_READ | GENERIC_WRITE,
+        0, // Nobody else has any business in our scratch file
+        nullptr,
+        CREATE_NEW,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+        nullptr
+      );
+      if(fileHandle != INVALID_HANDLE_VALUE) {
+        return fileHandle;
+      }
+
+      DWORD lastErrorCode = ::GetLastError();
+      if(lastErrorCode != ERROR_FILE_EXISTS) {
+        throwWindowsFileAccessError(lastErrorCode);
+      }
+    }
+  }
+
+#endif // defined(NUCLEX_PIXELS_WIN32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_PIXELS_WIN32)
+
+  /// <summary>Creates a scratch file that has already been removed from its directory</summary>
+  /// <param name="directory">Directory in which the scratch file will be created</param>
+  /// <returns>The file descriptor of the scratch file</returns>
+  int createPosixScratchFile(const std::string &directory) {
+    std::string path(directory);
+    if(path.empty()) {
+      const char *temporaryDirectory = std::getenv("TMPDIR");
+      if((temporaryDirectory != nullptr) && (temporaryDirectory[0] != 0)) {
+        path.assign(temporaryDirectory);
+      } else {
+        path.assign(u8"/tmp");
+      }
+    }
+    if(path.back() != '/') {
+      path.push_back('/');
+    }
+    path.append(u8"NuclexPixelsTiles-XXXXXX");
+
+    int fileDescriptor = ::mkstemp(&path[0]);
+    if(fileDescriptor == -1) {
+      int errorNumber = errno;
+      throwPosixFileAccessError(errorNumber);
+    }
+
+    // Once unlinked, the file disappears by itself when the file descriptor and
+    // the mapping are closed, even if the process crashes.
+    ::unlink(path.c_str());
+
+    return fileDescriptor;
+  }
+
+#endif // !defined(NUCLEX_PIXELS_WIN32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct TiledBitmap::Implementation {
+
+    /// <summary>Initializes the tile table for a tiled bitmap</summary>
+    /// <param name="width">Width of the bitmap in pixels</param>
+    /// <param name="height">Height of the bitmap in pixels</param>
+    /// <param name="pixelFormat">Pixel format of the bitmap</param>
+    /// <param name="tileSize">Width and height of each tile in pixels</param>
+    public: Implementation(
+      std::size_t width, std::size_t height, PixelFormat pixelFormat, std::size_t tileSize
+    );
+
+    /// <summary>Frees all tiles and closes the scratch file</summary>
+    public: ~Implementation();
+
+    /// <summary>Creates the scratch file and maps it into memory</summary>
+    /// <param name="scratchDirectory">Directory the scratch file will be created in</param>
+    public: void MapScratchFile(const std::string &scratchDirectory);
+
+    /// <summary>Looks up the entry for a tile in the tile table</summary>
+    /// <param name="tileX">Horizontal index of the tile</param>
+    /// <param name="tileY">Vertical index of the tile</param>
+    /// <returns>The tile table entry holding the tile's address</returns>
+    public: std::atomic<std::uint8_t *> &GetTileEntry(std::size_t tileX, std::size_t tileY);
+
+    /// <summary>Returns the address of a tile, allocating it if necessary</summary>
+    /// <param name="tileX">Horizontal index of the tile</param>
+    /// <param name="tileY">Vertical index of the tile</param>
+    /// <returns>The address of the tile's first pixel</returns>
+    public: std::uint8_t *GetOrAllocateTile(std::size_t tileX, std::size_t tileY);
+
+    /// <summary>Describes the memory of a tile</summary>
+    /// <param name="tileX">Horizontal index of the tile</param>
+    /// <param name="tileY">Vertical index of the tile</param>
+    /// <param name="pixels">Address of the tile's first pixel</param>
+    /// <returns>The bitmap memory of the tile clipped to the bitmap</returns>
+    public: BitmapMemory DescribeTile(
+      std::size_t tileX, std::size_t tileY, std::uint8_t *pixels
+    ) const;
+
+    /// <summary>Makes sure a region lies inside the bitmap and has its pixel format</summary>
+    /// <param name="x">X coordinate of the region's left border</param>
+    /// <param name="y">Y coordinate of the region's upper border</param>
+    /// <param name="memory">Bitmap memory the region is copied from or to</param>
+    public: void RequireValidRegion(
+      std::size_t x, std::size_t y, const BitmapMemory &memory
+    ) const;
+
+    /// <summary>Width of the bitmap in pixels</summary>
+    public: std::size_t Width;
+    /// <summary>Height of the bitmap in pixels</summary>
+    public: std::size_t Height;
+    /// <summary>Pixel format of the bitmap</summary>
+    public: Nuclex::Pixels::PixelFormat PixelFormat;
+    /// <summary>Width and height of each tile in pixels</summary>
+    public: std::size_t TileSize;
+    /// <summary>Number of tiles in each row of tiles</summary>
+    public: std::size_t HorizontalTileCount;
+    /// <summary>Number of tiles in each column of tiles</summary>
+    public: std::size_t VerticalTileCount;
+    /// <summary>Number of bytes in each pixel</summary>
+    public: std::size_t BytesPerPixel;
+    /// <summary>Number of bytes between the rows of a tile</summary>
+    public: std::size_t TileStride;
+    /// <summary>Number of bytes each tile occupies</summary>
+    public: std::size_t TileByteCount;
+
+    /// <summary>Address of each tile, null for tiles that have not been allocated</summary>
+    public: std::unique_ptr<std::atomic<std::uint8_t *>[]> Tiles;
+    /// <summary>Number of tiles that are currently allocated</summary>
+    public: std::atomic<std::size_t> AllocatedTileCount;
+    /// <summary>Held while a tile is being allocated or released</summary>
+    public: std::mutex AllocationMutex;
+
+    /// <summary>Allocator providing the memory of tiles if no scratch file is used</summary>
+    public: BitmapAllocator *Allocator;
+    /// <summary>Memory the scratch file is mapped to, null if there's no scratch file</summary>
+    public: std::uint8_t *ScratchMapping;
+    /// <summary>Number of bytes in the scratch file</summary>
+    public: std::size_t ScratchByteCount;
+#if defined(NUCLEX_PIXELS_WIN32)
+    /// <summary>Handle of the scratch file, deletes the file when closed</summary>
+    public: HANDLE ScratchFileHandle;
+#endif
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TiledBitmap::Implementation::Implementation(
+    std::size_t width, std::size_t height, Nuclex::Pixels::PixelFormat pixelFormat,
+    std::size_t tileSize
+  ) :
+    Width(width),
+    Height(height),
+    PixelFormat(pixelFormat),
+    TileSize(tileSize),
+    HorizontalTileCount((width + tileSize - 1) / tileSize),
+    VerticalTileCount((height + tileSize - 1) / tileSize),
+    BytesPerPixel(CountBitsPerPixel(pixelFormat) / 8),
+    TileStride(CountRequiredBytes(pixelFormat, tileSize)),
+    TileByteCount(TileStride * tileSize),
+    Tiles(),
+    AllocatedTileCount(0),
+    AllocationMutex(),
+    Allocator(&BitmapAllocator::GetDefault()),
+    ScratchMapping(nullptr),
+    ScratchByteCount(0) {
+#if defined(NUCLEX_PIXELS_WIN32)
+    this->ScratchFileHandle = INVALID_HANDLE_VALUE;
+#endif
+
+    std::size_t tileCount = this->HorizontalTileCount * this->VerticalTileCount;
+    this->Tiles.reset(new std::atomic<std::uint8_t *>[tileCount]);
+    for(std::size_t index = 0; index < tileCount; ++index) {
+      this->Tiles[index].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TiledBitmap::Implementation::~Implementation() {
+    if(this->ScratchMapping != nullptr) {
+#if defined(NUCLEX_PIXELS_WIN32)
+      ::UnmapViewOfFile(this->ScratchMapping);
+#else
+      ::munmap(this->ScratchMapping, this->ScratchByteCount);
+#endif
+    } else {
+      std::size_t tileCount = this->HorizontalTileCount * this->VerticalTileCount;
+      for(std::size_t index = 0; index < tileCount; ++index) {
+        std::uint8_t *tile = this->Tiles[index].load(std::memory_order_relaxed);
+        if(tile != nullptr) {
+          this->Allocator->Free(tile, this->TileByteCount);
+        }
+      }
+    }
+
+#if defined(NUCLEX_PIXELS_WIN32)
+    if(this->ScratchFileHandle != INVALID_HANDLE_VALUE) {
+      ::CloseHandle(this->ScratchFileHandle);
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TiledBitmap::Implementation::MapScratchFile(const std::string &scratchDirectory) {
+
+    // Tiles start on page boundaries so released tiles can be handed back to the OS
+    this->TileByteCount = nextMultiple(this->TileByteCount, getPageSize());
+
+    std::uint64_t tileCount = (
+      static_cast<std::uint64_t>(this->HorizontalTileCount) *
+      static_cast<std::uint64_t>(this->VerticalTileCount)
+    );
+    std::uint64_t scratchByteCount = tileCount * this->TileByteCount;
+    if(scratchByteCount == 0) {
+      return; // Empty files can not be mapped
+    }
+    if(scratchByteCount > static_cast<std::uint64_t>(static_cast<std::size_t>(-1))) {
+      throw std::runtime_error(
+        u8"Tiled bitmap is too large for the address space of the process"
+      );
+    }
+
+#if defined(NUCLEX_PIXELS_WIN32)
+
+    this->ScratchFileHandle = createWindowsScratchFile(scratchDirectory);
+
+    // Sparse files only occupy disk space for the parts that have been written. This is
+    // only an optimization, so there's no need to fail if the file system can't do it.
+    DWORD bytesReturned;
+    ::DeviceIoControl(
+      this->ScratchFileHandle, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytesReturned, nullptr
+    );
+
+    HANDLE mappingHandle = ::CreateFileMappingW(
+      this->ScratchFileHandle, nullptr, PAGE_READWRITE,
+      static_cast<DWORD>(scratchByteCount >> 32), static_cast<DWORD>(scratchByteCount),
+      nullptr
+    );
+    if(mappingHandle == nullptr) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwWindowsFileAccessError(lastErrorCode);
+    }
+
+    // The view keeps the mapping open, so its handle can be closed
+    void *view = ::MapViewOfFile(mappingHandle, FILE_MAP_WRITE, 0, 0, 0);
+    DWORD lastErrorCode = ::GetLastError();
+    ::CloseHandle(mappingHandle);
+    if(view == nullptr) {
+      throwWindowsFileAccessError(lastErrorCode);
+    }
+
+    this->ScratchMapping = static_cast<std::uint8_t *>(view);
+
+#else // Linux and Posix both offer mmap()
+
+    int fileDescriptor = createPosixScratchFile(scratchDirectory);
+
+    // Growing the file with ftruncate() leaves a hole that reads as zeros
+    // and takes up no disk space until it is written to.
+    if(::ftruncate(fileDescriptor, static_cast<off_t>(scratchByteCount)) == -1) {
+      int errorNumber = errno;
+      ::close(fileDescriptor);
+      throwPosixFileAccessError(errorNumber);
+    }
+
+    // The mapping keeps the file open, so the file descriptor can be closed
+    void *mapping = ::mmap(
+      nullptr, static_cast<std::size_t>(scratchByteCount),
+      PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0
+    );
+    int errorNumber = errno;
+    ::close(fileDescriptor);
+    if(mapping == MAP_FAILED) {
+      throwPosixFileAccessError(errorNumber);
+    }
+
+    this->ScratchMapping = static_cast<std::uint8_t *>(mapping);
+
+#endif
+
+    this->ScratchByteCount = static_cast<std::size_t>(scratchByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::atomic<std::uint8_t *> &TiledBitmap::Implementation::GetTileEntry(
+    std::size_t tileX, std::size_t tileY
+  ) {
+    if((tileX >= this->HorizontalTileCount) || (tileY >= this->VerticalTileCount)) {
+      throw std::out_of_range(u8"Tile index lies outside of the tiled bitmap");
+    }
+
+    return this->Tiles[tileY * this->HorizontalTileCount + tileX];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint8_t *TiledBitmap::Implementation::GetOrAllocateTile(
+    std::size_t tileX, std::size_t tileY
+  ) {
+    std::atomic<std::uint8_t *> &entry = GetTileEntry(tileX, tileY);
+
+    std::uint8_t *tile = entry.load(std::memory_order_acquire);
+    if(tile != nullptr) {
+      return tile;
+    }
+
+    // Another thread may be allocating the same tile, so check again under the lock
+    std::lock_guard<std::mutex> allocationScope(this->AllocationMutex);
+    tile = entry.load(std::memory_order_relaxed);
+    if(tile != nullptr) {
+      return tile;
+    }
+
+    if(this->ScratchMapping != nullptr) {
+      std::size_t index = tileY * this->HorizontalTileCount + tileX;
+      tile = this->ScratchMapping + (index * this->TileByteCount);
+    } else {
+      tile = static_cast<std::uint8_t *>(this->Allocator->Allocate(this->TileByteCount));
+      std::memset(tile, 0, this->TileByteCount);
+    }
+
+    entry.store(tile, std::memory_order_release);
+    this->AllocatedTileCount.fetch_add(1, std::memory_order_relaxed);
+
+    return tile;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapMemory TiledBitmap::Implementation::DescribeTile(
+    std::size_t tileX, std::size_t tileY, std::uint8_t *pixels
+  ) const {
+    BitmapMemory memory;
+    memory.Width = this->Width - (tileX * this->TileSize);
+    if(memory.Width > this->TileSize) {
+      memory.Width = this->TileSize;
+    }
+    memory.Height = this->Height - (tileY * this->TileSize);
+    if(memory.Height > this->TileSize) {
+      memory.Height = this->TileSize;
+    }
+    memory.Stride = static_cast<int>(this->TileStride);
+    memory.PixelFormat = this->PixelFormat;
+    memory.Pixels = pixels;
+
+    return memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TiledBitmap::Implementation::RequireValidRegion(
+    std::size_t x, std::size_t y, const BitmapMemory &memory
+  ) const {
+    if(memory.PixelFormat != this->PixelFormat) {
+      throw std::runtime_error(u8"Bitmap memory does not have the tiled bitmap's pixel format");
+    }
+    if(
+      (x > this->Width) || (memory.Width > this->Width - x) ||
+      (y > this->Height) || (memory.Height > this->Height - y)
+    ) {
+      throw std::invalid_argument(u8"Region does not lie inside the tiled bitmap");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TiledBitmap::TiledBitmap(
+    std::size_t width, std::size_t height, PixelFormat pixelFormat,
+    std::size_t tileSize /* = DefaultTileSize */
+  ) :
+    implementation(nullptr) {
+    if(tileSize == 0) {
+      throw std::invalid_argument(u8"Tile size must be at least one pixel");
+    }
+
+    this->implementation = new Implementation(width, height, pixelFormat, tileSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TiledBitmap::TiledBitmap(
+    std::size_t width, std::size_t height, PixelFormat pixelFormat,
+    const std::string &scratchDirectory, std::size_t tileSize /* = DefaultTileSize */
+  ) :
+    implementation(nullptr) {
+    if(tileSize == 0) {
+      throw std::invalid_argument(u8"Tile size must be at least one pixel");
+    }
+
+    std::unique_ptr<Implementation> newImplementation(
+      new Implementation(width, height, pixelFormat, tileSize)
+    );
+    newImplementation->MapScratchFile(scratchDirectory);
+
+    this->implementation = newImplementation.release();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TiledBitmap::TiledBitmap(TiledBitmap &&other) :
+    implementation(other.implementation) {
+    other.implementation = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TiledBitmap::~TiledBitmap() {
+    delete this->implementation;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TiledBitmap::GetWidth() const {
+    return this->implementation->Width;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TiledBitmap::GetHeight() const {
+    return this->implementation->Height;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PixelFormat TiledBitmap::GetPixelFormat() const {
+    return this->implementation->PixelFormat;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TiledBitmap::GetTileSize() const {
+    return this->implementation->TileSize;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TiledBitmap::CountHorizontalTiles() const {
+    return this->implementation->HorizontalTileCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TiledBitmap::CountVerticalTiles() const {
+    return this->implementation->VerticalTileCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t TiledBitmap::CountAllocatedTiles() const {
+    return this->implementation->AllocatedTileCount.load(std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool TiledBitmap::IsTileAllocated(std::size_t tileX, std::size_t tileY) const {
+    return (
+      this->implementation->GetTileEntry(tileX, tileY).load(std::memory_order_acquire) != nullptr
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BitmapMemory TiledBitmap::AccessTile(std::size_t tileX, std::size_t tileY) {
+    return this->implementation->DescribeTile(
+      tileX, tileY, this->implementation->GetOrAllocateTile(tileX, tileY)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TiledBitmap::ReleaseTile(std::size_t tileX, std::size_t tileY) {
+    std::atomic<std::uint8_t *> &entry = this->implementation->GetTileEntry(tileX, tileY);
+
+    std::lock_guard<std::mutex> allocationScope(this->implementation->AllocationMutex);
+    std::uint8_t *tile = entry.exchange(nullptr, std::memory_order_acq_rel);
+    if(tile == nullptr) {
+      return;
+    }
+
+    std::size_t tileByteCount = this->implementation->TileByteCount;
+    if(this->implementation->ScratchMapping == nullptr) {
+      this->implementation->Allocator->Free(tile, tileByteCount);
+    } else {
+
+      // Punch a hole into the scratch file so the tile takes neither memory nor disk
+      // space anymore. If the OS or file system can't do that, zero the tile manually.
+#if defined(NUCLEX_PIXELS_WIN32)
+      FILE_ZERO_DATA_INFORMATION zeroDataInformation;
+      std::uint64_t start = static_cast<std::uint64_t>(
+        tile - this->implementation->ScratchMapping
+      );
+      zeroDataInformation.FileOffset.QuadPart = static_cast<LONGLONG>(start);
+      zeroDataInformation.BeyondFinalZero.QuadPart = static_cast<LONGLONG>(
+        start + tileByteCount
+      );
+      DWORD bytesReturned;
+      BOOL result = ::DeviceIoControl(
+        this->implementation->ScratchFileHandle, FSCTL_SET_ZERO_DATA,
+        &zeroDataInformation, sizeof(zeroDataInformation), nullptr, 0, &bytesReturned, nullptr
+      );
+      if(result == FALSE) {
+        std::memset(tile, 0, tileByteCount);
+      }
+#elif defined(NUCLEX_PIXELS_LINUX) && defined(MADV_REMOVE)
+      if(::madvise(tile, tileByteCount, MADV_REMOVE) == -1) {
+        std::memset(tile, 0, tileByteCount);
+      }
+#else
+      std::memset(tile, 0, tileByteCount);
+#endif
+
+    }
+
+    this->implementation->AllocatedTileCount.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TiledBitmap::ReadRegion(std::size_t x, std::size_t y, const BitmapMemory &target) const {
+    this->implementation->RequireValidRegion(x, y, target);
+
+    std::size_t tileSize = this->implementation->TileSize;
+    std::size_t bytesPerPixel = this->implementation->BytesPerPixel;
+
+    // Go through the region in rectangles that lie within a single tile each
+    std::size_t endY = y + target.Height;
+    for(std::size_t currentY = y; currentY < endY;) {
+      std::size_t tileY = currentY / tileSize;
+      std::size_t rowInTile = currentY - (tileY * tileSize);
+      std::size_t rowCount = std::min(tileSize - rowInTile, endY - currentY);
+
+      std::size_t endX = x + target.Width;
+      for(std::size_t currentX = x; currentX < endX;) {
+        std::size_t tileX = currentX / tileSize;
+        std::size_t columnInTile = currentX - (tileX * tileSize);
+        std::size_t columnCount = std::min(tileSize - columnInTile, endX - currentX);
+        std::size_t byteCount = columnCount * bytesPerPixel;
+
+        std::uint8_t *targetRow = static_cast<std::uint8_t *>(target.Pixels) + (
+          static_cast<std::ptrdiff_t>(target.Stride) *
+          static_cast<std::ptrdiff_t>(currentY - y) +
+          static_cast<std::ptrdiff_t>((currentX - x) * bytesPerPixel)
+        );
+
+        const std::uint8_t *tile = this->implementation->GetTileEntry(tileX, tileY).load(
+          std::memory_order_acquire
+        );
+        if(tile == nullptr) {
+          for(std::size_t row = 0; row < rowCount; ++row) {
+            std::memset(targetRow, 0, byteCount);
+            targetRow += target.Stride;
+          }
+        } else {
+          const std::uint8_t *tileRow = tile + (
+            rowInTile * this->implementation->TileStride + columnInTile * bytesPerPixel
+          );
+          for(std::size_t row = 0; row < rowCount; ++row) {
+            std::memcpy(targetRow, tileRow, byteCount);
+            tileRow += this->implementation->TileStride;
+            targetRow += target.Stride;
+          }
+        }
+
+        currentX += columnCount;
+      }
+
+      currentY += rowCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TiledBitmap::WriteRegion(std::size_t x, std::size_t y, const BitmapMemory &source) {
+    this->implementation->RequireValidRegion(x, y, source);
+
+    std::size_t tileSize = this->implementation->TileSize;
+    std::size_t bytesPerPixel = this->implementation->BytesPerPixel;
+
+    // Go through the region in rectangles that lie within a single tile each
+    std::size_t endY = y + source.Height;
+    for(std::size_t currentY = y; currentY < endY;) {
+      std::size_t tileY = currentY / tileSize;
+      std::size_t rowInTile = currentY - (tileY * tileSize);
+      std::size_t rowCount = std::min(tileSize - rowInTile, endY - currentY);
+
+      std::size_t endX = x + source.Width;
+      for(std::size_t currentX = x; currentX < endX;) {
+        std::size_t tileX = currentX / tileSize;
+        std::size_t columnInTile = currentX - (tileX * tileSize);
+        std::size_t columnCount = std::min(tileSize - columnInTile, endX - currentX);
+        std::size_t byteCount = columnCount * bytesPerPixel;
+
+        const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(source.Pixels) + (
+          static_cast<std::ptrdiff_t>(source.Stride) *
+          static_cast<std::ptrdiff_t>(currentY - y) +
+          static_cast<std::ptrdiff_t>((currentX - x) * bytesPerPixel)
+        );
+
+        std::uint8_t *tileRow = this->implementation->GetOrAllocateTile(tileX, tileY) + (
+          rowInTile * this->implementation->TileStride + columnInTile * bytesPerPixel
+        );
+        for(std::size_t row = 0; row < rowCount; ++row) {
+          std::memcpy(tileRow, sourceRow, byteCount);
+          tileRow += this->implementation->TileStride;
+          sourceRow += source.Stride;
+        }
+
+        currentX += columnCount;
+      }
+
+      currentY += rowCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TiledBitmap &TiledBitmap::operator =(TiledBitmap &&other) {
+    if(this != &other) {
+      delete this->implementation;
+      this->implementation = other.implementation;
+      other.implementation = nullptr;
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,292 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/AlphaCompositor.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills an R8-G8-B8-A8 bitmap with all combinations of color and alpha</summary>
+  /// <param name="bitmap">Bitmap of 256 x 256 pixels that will be filled</param>
+  /// <remarks>
+  ///   The X coordinate is the color (with a different offset per channel),
+  ///   the Y coordinate is the alpha value
+  /// </remarks>
+  void fillWithAllCombinations(const Nuclex::Pixels::Bitmap &bitmap) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        row[x * 4 + 0] = static_cast<std::uint8_t>(x);
+        row[x * 4 + 1] = static_cast<std::uint8_t>(x + 85);
+        row[x * 4 + 2] = static_cast<std::uint8_t>(x + 170);
+        row[x * 4 + 3] = static_cast<std::uint8_t>(y);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates round(value / 255) the straightforward way</summary>
+  /// <param name="value">Value that will be divided by 255</param>
+  /// <returns>The value divided by 255 and rounded to the nearest integer</returns>
+  std::uint32_t divideBy255(std::uint32_t value) {
+    return (value * 2 + 255) / 510;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AlphaCompositorTest, PremultiplyingBytesRoundsExactly) {
+    Bitmap bitmap(256, 256, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithAllCombinations(bitmap);
+    Bitmap original(bitmap);
+
+    AlphaCompositor::Premultiply(bitmap.Access());
+
+    for(std::size_t y = 0; y < 256; ++y) {
+      for(std::size_t x = 0; x < 256; ++x) {
+        const std::uint8_t *originalPixel = GetPixelAddress(original, x, y);
+        const std::uint8_t *pixel = GetPixelAddress(bitmap, x, y);
+        for(std::size_t channel = 0; channel < 3; ++channel) {
+          ASSERT_EQ(pixel[channel], divideBy255(originalPixel[channel] * originalPixel[3]));
+        }
+        ASSERT_EQ(pixel[3], originalPixel[3]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AlphaCompositorTest, UnpremultiplyingBytesRoundsExactly) {
+    Bitmap bitmap(256, 256, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithAllCombinations(bitmap);
+    Bitmap original(bitmap);
+
+    AlphaCompositor::Unpremultiply(bitmap.Access());
+
+    for(std::size_t y = 0; y < 256; ++y) {
+      for(std::size_t x = 0; x < 256; ++x) {
+        const std::uint8_t *originalPixel = GetPixelAddress(original, x, y);
+        const std::uint8_t *pixel = GetPixelAddress(bitmap, x, y);
+        std::uint32_t alpha = originalPixel[3];
+        for(std::size_t channel = 0; channel < 3; ++channel) {
+          std::uint32_t color = originalPixel[channel];
+          if(alpha == 0) {
+            ASSERT_EQ(pixel[channel], 0);
+          } else if(color >= alpha) {
+            ASSERT_EQ(pixel[channel], 255);
+          } else {
+            ASSERT_EQ(pixel[channel], (color * 510 + alpha) / (alpha * 2));
+          }
+        }
+        ASSERT_EQ(pixel[3], alpha);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AlphaCompositorTest, PremultipliedOpaquePixelsSurviveRoundTrip) {
+    Bitmap bitmap(256, 1, PixelFormat::B8_G8_R8_A8_Unsigned);
+    {
+      std::uint8_t *pixels = static_cast<std::uint8_t *>(bitmap.Access().Pixels);
+      for(std::size_t x = 0; x < 256; ++x) {
+        pixels[x * 4 + 0] = static_cast<std::uint8_t>(x);
+        pixels[x * 4 + 1] = static_cast<std::uint8_t>(255 - x);
+        pixels[x * 4 + 2] = static_cast<std::uint8_t>(x * 3);
+        pixels[x * 4 + 3] = 255;
+      }
+    }
+    Bitmap original(bitmap);
+
+    AlphaCompositor::Premultiply(bitmap.Access());
+    AlphaCompositor::Unpremultiply(bitmap.Access());
+
+    for(std::size_t x = 0; x < 256; ++x) {
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        EXPECT_EQ(GetPixelAddress(bitmap, x, 0)[channel], GetPixelAddress(original, x, 0)[channel]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AlphaCompositorTest, BytesCanBeCompositedOver) {
+    Bitmap source(256, 256, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithAllCombinations(source);
+    AlphaCompositor::Premultiply(source.Access());
+
+    Bitmap target(256, 256, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = target.Access();
+      for(std::size_t y = 0; y < 256; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+        for(std::size_t x = 0; x < 256; ++x) {
+          row[x * 4 + 0] = static_cast<std::uint8_t>(255 - x);
+          row[x * 4 + 1] = static_cast<std::uint8_t>(x / 2);
+          row[x * 4 + 2] = static_cast<std::uint8_t>(y);
+          row[x * 4 + 3] = 255;
+        }
+      }
+    }
+    Bitmap original(target);
+
+    AlphaCompositor::CompositeOver(source.Access(), target.Access());
+
+    for(std::size_t y = 0; y < 256; ++y) {
+      for(std::size_t x = 0; x < 256; ++x) {
+        const std::uint8_t *sourcePixel = GetPixelAddress(source, x, y);
+        const std::uint8_t *originalPixel = GetPixelAddress(original, x, y);
+        const std::uint8_t *pixel = GetPixelAddress(target, x, y);
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          std::uint32_t expected = sourcePixel[channel] + divideBy255(
+            originalPixel[channel] * (255U - sourcePixel[3])
+          );
+          ASSERT_EQ(pixel[channel], (expected > 255) ? 255 : expected);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AlphaCompositorTest, RowsOfAnyLengthCanBeProcessed) {
+    std::uint8_t pixels[7 * 4];
+    for(std::size_t index = 0; index < 7; ++index) {
+      pixels[index * 4 + 0] = 200;
+      pixels[index * 4 + 1] = 100;
+      pixels[index * 4 + 2] = 50;
+      pixels[index * 4 + 3] = static_cast<std::uint8_t>(index * 40);
+    }
+
+    AlphaCompositor::PremultiplyRow(PixelFormat::R8_G8_B8_A8_Unsigned, pixels, 7);
+
+    for(std::size_t index = 0; index < 7; ++index) {
+      std::uint32_t alpha = static_cast<std::uint32_t>(index * 40);
+      EXPECT_EQ(pixels[index * 4 + 0], divideBy255(200 * alpha));
+      EXPECT_EQ(pixels[index * 4 + 1], divideBy255(100 * alpha));
+      EXPECT_EQ(pixels[index * 4 + 2], divideBy255(50 * alpha));
+      EXPECT_EQ(pixels[index * 4 + 3], alpha);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AlphaCompositorTest, FloatsCanBePremultipliedAndComposited) {
+    float source[3 * 4] = {
+      1.0f, 0.5f, 0.25f, 0.5f,
+      0.2f, 0.4f, 0.6f, 0.0f,
+      0.8f, 0.6f, 0.4f, 1.0f
+    };
+    float target[3 * 4] = {
+      0.0f, 0.0f, 1.0f, 1.0f,
+      0.1f, 0.2f, 0.3f, 1.0f,
+      1.0f, 1.0f, 1.0f, 0.5f
+    };
+
+    AlphaCompositor::PremultiplyRow(PixelFormat::R32_G32_B32_A32_Float, source, 3);
+    EXPECT_FLOAT_EQ(source[0], 0.5f);
+    EXPECT_FLOAT_EQ(source[1], 0.25f);
+    EXPECT_FLOAT_EQ(source[2], 0.125f);
+    EXPECT_FLOAT_EQ(source[3], 0.5f);
+    EXPECT_FLOAT_EQ(source[4], 0.0f);
+
+    AlphaCompositor::CompositeRowOver(PixelFormat::R32_G32_B32_A32_Float, source, target, 3);
+    EXPECT_FLOAT_EQ(target[0], 0.5f);
+    EXPECT_FLOAT_EQ(target[2], 0.625f);
+    EXPECT_FLOAT_EQ(target[3], 1.0f);
+    EXPECT_FLOAT_EQ(target[5], 0.2f);
+    EXPECT_FLOAT_EQ(target[8], 0.8f);
+    EXPECT_FLOAT_EQ(target[11], 1.0f);
+
+    AlphaCompositor::UnpremultiplyRow(PixelFormat::R32_G32_B32_A32_Float, source, 3);
+    EXPECT_FLOAT_EQ(source[0], 1.0f);
+    EXPECT_FLOAT_EQ(source[1], 0.5f);
+    EXPECT_FLOAT_EQ(source[4], 0.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AlphaCompositorTest, ParallelCompositingMatchesSingleThreaded) {
+    ThreadPool threadPool(4);
+
+    Bitmap source(256, 256, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithAllCombinations(source);
+    Bitmap parallelSource(source);
+
+    AlphaCompositor::Premultiply(source.Access());
+    AlphaCompositor::Premultiply(parallelSource.Access(), threadPool);
+
+    Bitmap target(256, 256, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithAllCombinations(target);
+    Bitmap parallelTarget(target);
+
+    AlphaCompositor::CompositeOver(source.Access(), target.Access());
+    AlphaCompositor::CompositeOver(parallelSource.Access(), parallelTarget.Access(), threadPool);
+    AlphaCompositor::Unpremultiply(target.Access());
+    AlphaCompositor::Unpremultiply(parallelTarget.Access(), threadPool);
+
+    for(std::size_t y = 0; y < 256; ++y) {
+      for(std::size_t x = 0; x < 256; ++x) {
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          ASSERT_EQ(
+            GetPixelAddress(parallelTarget, x, y)[channel], GetPixelAddress(target, x, y)[channel]
+          );
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AlphaCompositorTest, UnsupportedPixelFormatsThrowException) {
+    EXPECT_FALSE(AlphaCompositor::CanComposite(PixelFormat::R8_G8_B8_Unsigned));
+
+    Bitmap bitmap(4, 4, PixelFormat::R8_G8_B8_Unsigned);
+    EXPECT_THROW(AlphaCompositor::Premultiply(bitmap.Access()), std::runtime_error);
+
+    Bitmap source(4, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap target(4, 4, PixelFormat::B8_G8_R8_A8_Unsigned);
+    EXPECT_THROW(
+      AlphaCompositor::CompositeOver(source.Access(), target.Access()), std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,379 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapAnalyzer.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Half.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates a pseudo-random byte for each channel of each pixel</summary>
+  /// <param name="x">X coordinate of the pixel</param>
+  /// <param name="y">Y coordinate of the pixel</param>
+  /// <param name="channel">Index of the channel</param>
+  /// <returns>The value the channel of the pixel should have</returns>
+  std::uint8_t getTestByte(std::size_t x, std::size_t y, std::size_t channel) {
+    return static_cast<std::uint8_t>((x * 37 + y * 101 + channel * 59 + (x * y) % 13) % 251);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills an 8 bit bitmap with pseudo-random bytes</summary>
+  /// <param name="memory">Bitmap memory that will be filled</param>
+  /// <param name="channelCount">Number of channels in each pixel</param>
+  void fillWithTestBytes(const Nuclex::Pixels::BitmapMemory &memory, std::size_t channelCount) {
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        for(std::size_t channel = 0; channel < channelCount; ++channel) {
+          row[x * channelCount + channel] = getTestByte(x, y, channel);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks the statistics of an 8 bit bitmap against a simple calculation</summary>
+  /// <param name="pixelFormat">Pixel format of the bitmap that will be checked</param>
+  /// <param name="channelCount">Number of channels in the pixel format</param>
+  void checkByteStatistics(Nuclex::Pixels::PixelFormat pixelFormat, std::size_t channelCount) {
+    using Nuclex::Pixels::BitmapAnalyzer;
+
+    // Odd width so both the SIMD and the scalar loop get some pixels
+    Nuclex::Pixels::Bitmap bitmap(37, 5, pixelFormat);
+    fillWithTestBytes(bitmap.Access(), channelCount);
+
+    Nuclex::Pixels::BitmapStatistics statistics = BitmapAnalyzer::GatherStatistics(
+      bitmap.Access()
+    );
+    EXPECT_EQ(37U * 5U, statistics.PixelCount);
+    ASSERT_EQ(channelCount, statistics.ChannelCount);
+
+    for(std::size_t channel = 0; channel < channelCount; ++channel) {
+      std::uint8_t minimum = 255, maximum = 0;
+      std::size_t sum = 0;
+      for(std::size_t y = 0; y < 5; ++y) {
+        for(std::size_t x = 0; x < 37; ++x) {
+          std::uint8_t value = getTestByte(x, y, channel);
+          minimum = std::min(minimum, value);
+          maximum = std::max(maximum, value);
+          sum += value;
+        }
+      }
+
+      EXPECT_DOUBLE_EQ(statistics.Channels[channel].Minimum, minimum / 255.0);
+      EXPECT_DOUBLE_EQ(statistics.Channels[channel].Maximum, maximum / 255.0);
+      EXPECT_DOUBLE_EQ(statistics.Channels[channel].Sum, sum / 255.0);
+      EXPECT_DOUBLE_EQ(statistics.Channels[channel].Mean, sum / 255.0 / (37.0 * 5.0));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Draws one of two smooth test patterns into an 8 bit RGBA bitmap</summary>
+  /// <param name="memory">Bitmap memory the pattern will be drawn into</param>
+  /// <param name="variant">Which of the two test patterns will be drawn</param>
+  /// <remarks>
+  ///   The patterns are drawn relative to the bitmap size, so bitmaps of different
+  ///   sizes show the same image.
+  /// </remarks>
+  void drawHashPattern(const Nuclex::Pixels::BitmapMemory &memory, int variant) {
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      double v = (static_cast<double>(y) + 0.5) / static_cast<double>(memory.Height);
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        double u = (static_cast<double>(x) + 0.5) / static_cast<double>(memory.Width);
+        double value;
+        if(variant == 0) {
+          value = 128.0 + 60.0 * std::sin(u * 6.0) * std::cos(v * 4.0) + (
+            30.0 * std::sin(u * 11.0 + v * 3.0) + 20.0 * std::cos(v * 17.0 - u * 5.0)
+          );
+        } else {
+          value = 128.0 + 60.0 * std::sin(u * 3.0 + v * 9.0) + (
+            30.0 * std::cos(u * 13.0) * std::sin(v * 7.0) + 20.0 * std::sin(u * 19.0)
+          );
+        }
+        row[x * 4 + 0] = static_cast<std::uint8_t>(value);
+        row[x * 4 + 1] = static_cast<std::uint8_t>(255.0 - value);
+        row[x * 4 + 2] = static_cast<std::uint8_t>(value / 2.0);
+        row[x * 4 + 3] = 255;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, PackedPixelFormatsCanNotBeAnalyzed) {
+    EXPECT_TRUE(BitmapAnalyzer::CanAnalyze(PixelFormat::R8_G8_B8_A8_Unsigned));
+    EXPECT_TRUE(BitmapAnalyzer::CanAnalyze(PixelFormat::R16_G16_B16_A16_Float_Native16));
+    EXPECT_FALSE(BitmapAnalyzer::CanAnalyze(PixelFormat::R5_G6_B5_Unsigned));
+
+    Bitmap bitmap(4, 4, PixelFormat::R5_G6_B5_Unsigned);
+    EXPECT_THROW(BitmapAnalyzer::GatherStatistics(bitmap.Access()), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, StatisticsOfEightBitChannelsCanBeGathered) {
+    checkByteStatistics(PixelFormat::R8_Unsigned, 1);
+    checkByteStatistics(PixelFormat::R8_G8_Unsigned, 2);
+    checkByteStatistics(PixelFormat::B8_G8_R8_Unsigned, 3);
+    checkByteStatistics(PixelFormat::R8_G8_B8_A8_Unsigned, 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, SixteenBitChannelsAreNormalized) {
+    Bitmap bitmap(3, 1, PixelFormat::R16_G16_Unsigned_Native16);
+    std::uint16_t *values = static_cast<std::uint16_t *>(bitmap.Access().Pixels);
+    const std::uint16_t pixels[] = { 0, 65535, 65535, 65535, 13107, 0 };
+    std::copy(pixels, pixels + 6, values);
+
+    BitmapStatistics statistics = BitmapAnalyzer::GatherStatistics(bitmap.Access());
+    EXPECT_DOUBLE_EQ(0.0, statistics.Channels[0].Minimum);
+    EXPECT_DOUBLE_EQ(1.0, statistics.Channels[0].Maximum);
+    EXPECT_DOUBLE_EQ(1.2, statistics.Channels[0].Sum);
+    EXPECT_DOUBLE_EQ(0.4, statistics.Channels[0].Mean);
+    EXPECT_DOUBLE_EQ(0.0, statistics.Channels[1].Minimum);
+    EXPECT_DOUBLE_EQ(2.0 / 3.0, statistics.Channels[1].Mean);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, FloatChannelsAreReportedAsTheyAre) {
+    Bitmap floats(9, 2, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    Bitmap halfs(9, 2, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    for(std::size_t y = 0; y < 2; ++y) {
+      float *floatRow = reinterpret_cast<float *>(
+        static_cast<std::uint8_t *>(floats.Access().Pixels) + y * floats.Access().Stride
+      );
+      Half *halfRow = reinterpret_cast<Half *>(
+        static_cast<std::uint8_t *>(halfs.Access().Pixels) + y * halfs.Access().Stride
+      );
+      for(std::size_t index = 0; index < 9 * 4; ++index) {
+        float value = static_cast<float>(index % 4) * 4.0f - static_cast<float>(index / 4) * 0.5f;
+        floatRow[index] = value;
+        halfRow[index] = Half(value);
+      }
+    }
+
+    BitmapStatistics floatStatistics = BitmapAnalyzer::GatherStatistics(floats.Access());
+    BitmapStatistics halfStatistics = BitmapAnalyzer::GatherStatistics(halfs.Access());
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      double expectedMaximum = static_cast<double>(channel) * 4.0;
+      double expectedMean = expectedMaximum - 2.0;
+      EXPECT_DOUBLE_EQ(expectedMaximum - 4.0, floatStatistics.Channels[channel].Minimum);
+      EXPECT_DOUBLE_EQ(expectedMaximum, floatStatistics.Channels[channel].Maximum);
+      EXPECT_DOUBLE_EQ(expectedMean, floatStatistics.Channels[channel].Mean);
+      EXPECT_DOUBLE_EQ(expectedMaximum - 4.0, halfStatistics.Channels[channel].Minimum);
+      EXPECT_DOUBLE_EQ(expectedMaximum, halfStatistics.Channels[channel].Maximum);
+      EXPECT_DOUBLE_EQ(expectedMean, halfStatistics.Channels[channel].Mean);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, EmptyBitmapHasZeroStatistics) {
+    Bitmap bitmap(0, 0, PixelFormat::R8_G8_B8_A8_Unsigned);
+    BitmapStatistics statistics = BitmapAnalyzer::GatherStatistics(bitmap.Access());
+    EXPECT_EQ(0U, statistics.PixelCount);
+    EXPECT_EQ(4U, statistics.ChannelCount);
+    EXPECT_EQ(0.0, statistics.Channels[0].Minimum);
+    EXPECT_EQ(0.0, statistics.Channels[3].Mean);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, EightBitHistogramHasOneBinPerValue) {
+    Bitmap bitmap(256, 3, PixelFormat::B8_G8_R8_A8_Unsigned);
+    for(std::size_t y = 0; y < 3; ++y) {
+      std::uint8_t *row = (
+        static_cast<std::uint8_t *>(bitmap.Access().Pixels) + y * bitmap.Access().Stride
+      );
+      for(std::size_t x = 0; x < 256; ++x) {
+        row[x * 4 + 0] = 0;
+        row[x * 4 + 1] = static_cast<std::uint8_t>(x);
+        row[x * 4 + 2] = 0;
+        row[x * 4 + 3] = 0;
+      }
+    }
+
+    std::vector<std::size_t> bins(256, 12345);
+    BitmapAnalyzer::BuildHistogram(bitmap.Access(), 1, bins.data(), bins.size());
+    for(std::size_t bin = 0; bin < 256; ++bin) {
+      EXPECT_EQ(3U, bins[bin]);
+    }
+
+    BitmapAnalyzer::BuildHistogram(bitmap.Access(), 0, bins.data(), 4);
+    EXPECT_EQ(256U * 3U, bins[0]);
+    EXPECT_EQ(0U, bins[3]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, ValuesOutsideOfHistogramRangeLandInOuterBins) {
+    Bitmap bitmap(5, 1, PixelFormat::R32_Float_Native32);
+    float *values = static_cast<float *>(bitmap.Access().Pixels);
+    const float pixels[] = { -10.0f, 0.25f, 1.25f, 1.75f, 100.0f };
+    std::copy(pixels, pixels + 5, values);
+
+    std::size_t bins[4];
+    BitmapAnalyzer::BuildHistogram(bitmap.Access(), 0, bins, 4, 0.0f, 2.0f);
+    EXPECT_EQ(2U, bins[0]);
+    EXPECT_EQ(0U, bins[1]);
+    EXPECT_EQ(1U, bins[2]);
+    EXPECT_EQ(2U, bins[3]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, ParallelResultsMatchSingleThreaded) {
+    ThreadPool threadPool(4);
+
+    Bitmap bitmap(500, 300, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    for(std::size_t y = 0; y < 300; ++y) {
+      float *row = reinterpret_cast<float *>(
+        static_cast<std::uint8_t *>(bitmap.Access().Pixels) + y * bitmap.Access().Stride
+      );
+      for(std::size_t x = 0; x < 500; ++x) {
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          row[x * 4 + channel] = static_cast<float>(getTestByte(x, y, channel)) / 97.0f;
+        }
+      }
+    }
+
+    BitmapStatistics statistics = BitmapAnalyzer::GatherStatistics(bitmap.Access());
+    BitmapStatistics parallelStatistics = BitmapAnalyzer::GatherStatistics(
+      bitmap.Access(), threadPool
+    );
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      EXPECT_EQ(statistics.Channels[channel].Minimum, parallelStatistics.Channels[channel].Minimum);
+      EXPECT_EQ(statistics.Channels[channel].Maximum, parallelStatistics.Channels[channel].Maximum);
+      EXPECT_EQ(statistics.Channels[channel].Sum, parallelStatistics.Channels[channel].Sum);
+    }
+
+    std::vector<std::size_t> bins(64), parallelBins(64);
+    BitmapAnalyzer::BuildHistogram(bitmap.Access(), 2, bins.data(), 64, 0.0f, 3.0f);
+    BitmapAnalyzer::BuildHistogram(
+      bitmap.Access(), 2, parallelBins.data(), 64, threadPool, 0.0f, 3.0f
+    );
+    EXPECT_EQ(bins, parallelBins);
+
+    std::size_t total = 0;
+    for(std::size_t bin = 0; bin < 64; ++bin) {
+      total += bins[bin];
+    }
+    EXPECT_EQ(500U * 300U, total);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, InvalidHistogramParametersCauseException) {
+    Bitmap bitmap(4, 4, PixelFormat::R8_G8_Unsigned);
+    std::size_t bins[16];
+    EXPECT_THROW(
+      BitmapAnalyzer::BuildHistogram(bitmap.Access(), 2, bins, 16), std::invalid_argument
+    );
+    EXPECT_THROW(
+      BitmapAnalyzer::BuildHistogram(bitmap.Access(), 0, bins, 0), std::invalid_argument
+    );
+    EXPECT_THROW(
+      BitmapAnalyzer::BuildHistogram(bitmap.Access(), 0, bins, 16, 1.0f, 1.0f),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, DifferentBitsOfHashesCanBeCounted) {
+    EXPECT_EQ(BitmapAnalyzer::CountDifferentBits(0x1234U, 0x1234U), 0U);
+    EXPECT_EQ(BitmapAnalyzer::CountDifferentBits(0U, 0xFFFFFFFFFFFFFFFFULL), 64U);
+    EXPECT_EQ(BitmapAnalyzer::CountDifferentBits(0x8000000000000001ULL, 0U), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, ResizedImagesHaveSimilarHashes) {
+    Bitmap large(256, 192, PixelFormat::R8_G8_B8_A8_Unsigned);
+    drawHashPattern(large.Access(), 0);
+    Bitmap small(100, 75, PixelFormat::R8_G8_B8_A8_Unsigned);
+    drawHashPattern(small.Access(), 0);
+
+    std::uint64_t largeHash = BitmapAnalyzer::ComputePerceptualHash(large.Access());
+    std::uint64_t smallHash = BitmapAnalyzer::ComputePerceptualHash(small.Access());
+    EXPECT_LE(BitmapAnalyzer::CountDifferentBits(largeHash, smallHash), 6U);
+
+    largeHash = BitmapAnalyzer::ComputeDifferenceHash(large.Access());
+    smallHash = BitmapAnalyzer::ComputeDifferenceHash(small.Access());
+    EXPECT_LE(BitmapAnalyzer::CountDifferentBits(largeHash, smallHash), 6U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, DifferentImagesHaveDistantHashes) {
+    Bitmap first(128, 96, PixelFormat::R8_G8_B8_A8_Unsigned);
+    drawHashPattern(first.Access(), 0);
+    Bitmap second(128, 96, PixelFormat::R8_G8_B8_A8_Unsigned);
+    drawHashPattern(second.Access(), 1);
+
+    std::uint64_t firstHash = BitmapAnalyzer::ComputePerceptualHash(first.Access());
+    std::uint64_t secondHash = BitmapAnalyzer::ComputePerceptualHash(second.Access());
+    EXPECT_GE(BitmapAnalyzer::CountDifferentBits(firstHash, secondHash), 16U);
+
+    firstHash = BitmapAnalyzer::ComputeDifferenceHash(first.Access());
+    secondHash = BitmapAnalyzer::ComputeDifferenceHash(second.Access());
+    EXPECT_GE(BitmapAnalyzer::CountDifferentBits(firstHash, secondHash), 16U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapAnalyzerTest, EmptyBitmapsCanNotBeHashed) {
+    Bitmap bitmap(0, 0, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_THROW(
+      BitmapAnalyzer::ComputePerceptualHash(bitmap.Access()), std::invalid_argument
+    );
+    EXPECT_THROW(
+      BitmapAnalyzer::ComputeDifferenceHash(bitmap.Access()), std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
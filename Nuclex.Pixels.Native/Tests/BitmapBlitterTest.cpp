@@ -0,0 +1,265 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapBlitter.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sets all bytes of a bitmap to zero</summary>
+  /// <param name="bitmap">Bitmap that will be cleared</param>
+  void clear(const Nuclex::Pixels::Bitmap &bitmap) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+        row[x] = 0;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, WholeBitmapsCanBeCopied) {
+    Bitmap source(17, 9, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(source);
+    Bitmap target(17, 9, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    BitmapBlitter::Blit(source.Access(), target.Access());
+
+    for(std::size_t y = 0; y < 9; ++y) {
+      for(std::size_t x = 0; x < 17; ++x) {
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          EXPECT_EQ(GetPixelAddress(target, x, y)[channel], GetPixelAddress(source, x, y)[channel]);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, RegionsCanBeCopiedIntoLargerBitmap) {
+    Bitmap source(20, 12, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(source);
+    Bitmap target(32, 32, PixelFormat::R8_G8_B8_A8_Unsigned);
+    clear(target);
+
+    BitmapBlitter::Blit(
+      source.Access(), Rectangle::FromPositionAndSize(3, 2, 10, 8), target.Access(), 21, 24
+    );
+
+    for(std::size_t y = 0; y < 32; ++y) {
+      for(std::size_t x = 0; x < 32; ++x) {
+        bool isInside = ((x >= 21) && (x < 31) && (y >= 24));
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          if(isInside) {
+            const std::uint8_t *sourcePixel = GetPixelAddress(source, x - 18, y - 22);
+            EXPECT_EQ(GetPixelAddress(target, x, y)[channel], sourcePixel[channel]);
+          } else {
+            EXPECT_EQ(GetPixelAddress(target, x, y)[channel], 0);
+          }
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, PixelFormatIsConvertedWhileCopying) {
+    Bitmap source(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(source);
+    Bitmap target(16, 16, PixelFormat::B8_G8_R8_A8_Unsigned);
+    clear(target);
+
+    BitmapBlitter::Blit(source.Access(), target.Access(), 4, 5);
+
+    for(std::size_t y = 0; y < 8; ++y) {
+      for(std::size_t x = 0; x < 8; ++x) {
+        const std::uint8_t *sourcePixel = GetPixelAddress(source, x, y);
+        const std::uint8_t *targetPixel = GetPixelAddress(target, x + 4, y + 5);
+        EXPECT_EQ(targetPixel[0], sourcePixel[2]);
+        EXPECT_EQ(targetPixel[1], sourcePixel[1]);
+        EXPECT_EQ(targetPixel[2], sourcePixel[0]);
+        EXPECT_EQ(targetPixel[3], sourcePixel[3]);
+      }
+    }
+    EXPECT_EQ(GetPixelAddress(target, 3, 5)[3], 0);
+    EXPECT_EQ(GetPixelAddress(target, 12, 5)[3], 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, CopyingOutsideOfBitmapsThrowsException) {
+    Bitmap source(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap target(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    EXPECT_THROW(
+      BitmapBlitter::Blit(
+        source.Access(), Rectangle::FromPositionAndSize(4, 4, 5, 4), target.Access(), 0, 0
+      ),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      BitmapBlitter::Blit(source.Access(), target.Access(), 1, 0),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, ViewsCanBeFilledWithColors) {
+    Bitmap bitmap(16, 12, PixelFormat::R8_G8_B8_A8_Unsigned);
+    BitmapBlitter::Clear(bitmap.Access());
+
+    Bitmap view = bitmap.GetView(3, 2, 9, 7);
+    ColorModels::RgbColor orange = { 1.0f, 0.5f, 0.0f, 1.0f };
+    BitmapBlitter::Fill(view.Access(), orange);
+
+    for(std::size_t y = 0; y < 12; ++y) {
+      for(std::size_t x = 0; x < 16; ++x) {
+        const std::uint8_t *pixel = GetPixelAddress(bitmap, x, y);
+        bool isInside = ((x >= 3) && (x < 12) && (y >= 2) && (y < 9));
+        if(isInside) {
+          EXPECT_EQ(pixel[0], 255);
+          EXPECT_EQ(pixel[1], 128);
+          EXPECT_EQ(pixel[2], 0);
+          EXPECT_EQ(pixel[3], 255);
+        } else {
+          EXPECT_EQ(pixel[0] | pixel[1] | pixel[2] | pixel[3], 0);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, ColorsCanBeEncodedInAnyPixelFormat) {
+    ColorModels::RgbColor color = { 1.0f, 0.0f, 1.0f, 0.0f };
+
+    std::uint16_t packed;
+    PixelFormatConverter::EncodeColor(color, PixelFormat::R5_G6_B5_Unsigned_Native16, &packed);
+    EXPECT_EQ(packed, 0xF81F);
+
+    float floats[4];
+    PixelFormatConverter::EncodeColor(color, PixelFormat::R32_G32_B32_A32_Float_Native32, floats);
+    EXPECT_EQ(floats[0], 1.0f);
+    EXPECT_EQ(floats[1], 0.0f);
+    EXPECT_EQ(floats[2], 1.0f);
+    EXPECT_EQ(floats[3], 0.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, FirstDifferenceBetweenBitmapsCanBeFound) {
+    Bitmap bitmap(17, 9, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(bitmap);
+    Bitmap other(17, 9, PixelFormat::R8_G8_B8_A8_Unsigned);
+    BitmapBlitter::Blit(bitmap.Access(), other.Access());
+
+    std::size_t x = 0, y = 0;
+    EXPECT_TRUE(BitmapBlitter::AreEqual(bitmap.Access(), other.Access()));
+    EXPECT_FALSE(BitmapBlitter::FindFirstDifference(bitmap.Access(), other.Access(), x, y));
+
+    const BitmapMemory &memory = other.Access();
+    static_cast<std::uint8_t *>(memory.Pixels)[memory.Stride * 5 + 11 * 4 + 2] ^= 1;
+    EXPECT_FALSE(BitmapBlitter::AreEqual(bitmap.Access(), other.Access()));
+    ASSERT_TRUE(BitmapBlitter::FindFirstDifference(bitmap.Access(), other.Access(), x, y));
+    EXPECT_EQ(x, 11U);
+    EXPECT_EQ(y, 5U);
+
+    // Views compare only their own pixels
+    EXPECT_TRUE(
+      BitmapBlitter::AreEqual(
+        bitmap.GetView(0, 0, 11, 9).Access(), other.GetView(0, 0, 11, 9).Access()
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, BlittingIntoBitmapMarksOnlyTargetRegionDirty) {
+    Bitmap source(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(source);
+
+    Bitmap target(256, 256, PixelFormat::R8_G8_B8_A8_Unsigned);
+    BitmapBlitter::Clear(target);
+    target.EnableDirtyTracking(32);
+
+    BitmapBlitter::Blit(source.Access(), Rectangle(0, 0, 8, 8), target, 100, 40);
+    std::vector<Rectangle> regions = target.GetDirtyRegions();
+    ASSERT_EQ(regions.size(), 1U);
+    EXPECT_EQ(regions[0].MinX, 96U);
+    EXPECT_EQ(regions[0].MinY, 32U);
+    EXPECT_EQ(regions[0].MaxX, 128U);
+    EXPECT_EQ(regions[0].MaxY, 64U);
+
+    const std::uint8_t *targetPixels = static_cast<const std::uint8_t *>(
+      target.Access().Pixels
+    );
+    const BitmapMemory &sourceMemory = source.Access();
+    EXPECT_EQ(
+      targetPixels[40 * target.Access().Stride + 100 * 4],
+      static_cast<const std::uint8_t *>(sourceMemory.Pixels)[0]
+    );
+
+    target.ClearDirtyRegions();
+    ColorModels::RgbColor orange = { 1.0f, 0.5f, 0.0f, 1.0f };
+    BitmapBlitter::Fill(target, orange);
+    EXPECT_EQ(target.GetDirtyRegionTracker()->CountDirtyTiles(), 64U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapBlitterTest, BitmapsOfDifferentLayoutsAreNotEqual) {
+    Bitmap bitmap(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap other(8, 8, PixelFormat::B8_G8_R8_A8_Unsigned);
+    BitmapBlitter::Clear(bitmap.Access());
+    BitmapBlitter::Clear(other.Access());
+
+    EXPECT_FALSE(BitmapBlitter::AreEqual(bitmap.Access(), other.Access()));
+
+    std::size_t x, y;
+    EXPECT_THROW(
+      BitmapBlitter::FindFirstDifference(bitmap.Access(), other.Access(), x, y),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
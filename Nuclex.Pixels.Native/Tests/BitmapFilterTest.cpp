@@ -0,0 +1,277 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapFilter.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel format with floating point RGBA channels the tests work in</summary>
+  const Nuclex::Pixels::PixelFormat FloatFormat = (
+    Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a floating point RGBA bitmap with a single color</summary>
+  /// <param name="bitmap">Bitmap that will be filled</param>
+  /// <param name="red">Value of the red channel</param>
+  void fill(const Nuclex::Pixels::Bitmap &bitmap, float red) {
+    for(std::size_t y = 0; y < bitmap.GetHeight(); ++y) {
+      for(std::size_t x = 0; x < bitmap.GetWidth(); ++x) {
+        float *pixel = reinterpret_cast<float *>(Nuclex::Pixels::GetPixelAddress(bitmap, x, y));
+        pixel[0] = red;
+        pixel[1] = 0.0f;
+        pixel[2] = 0.0f;
+        pixel[3] = 1.0f;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the largest difference between the channels of two bitmaps</summary>
+  /// <param name="first">First bitmap that will be compared</param>
+  /// <param name="second">Second bitmap that will be compared</param>
+  /// <returns>The largest difference found in any channel of any pixel</returns>
+  float getLargestDifference(
+    const Nuclex::Pixels::Bitmap &first, const Nuclex::Pixels::Bitmap &second
+  ) {
+    float largestDifference = 0.0f;
+    for(std::size_t y = 0; y < first.GetHeight(); ++y) {
+      for(std::size_t x = 0; x < first.GetWidth(); ++x) {
+        const float *firstPixel = reinterpret_cast<const float *>(
+          Nuclex::Pixels::GetPixelAddress(first, x, y)
+        );
+        const float *secondPixel = reinterpret_cast<const float *>(
+          Nuclex::Pixels::GetPixelAddress(second, x, y)
+        );
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          float difference = std::abs(firstPixel[channel] - secondPixel[channel]);
+          if(difference > largestDifference) {
+            largestDifference = difference;
+          }
+        }
+      }
+    }
+
+    return largestDifference;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, BoxBlurSpreadsPixelEvenly) {
+    Bitmap source(9, 9, FloatFormat);
+    fill(source, 0.0f);
+    reinterpret_cast<float *>(GetPixelAddress(source, 4, 4))[0] = 9.0f;
+    Bitmap target(9, 9, FloatFormat);
+
+    BitmapFilter::Convolve(source.Access(), target.Access(), SeparableKernel::Box(1));
+
+    for(std::size_t y = 0; y < 9; ++y) {
+      for(std::size_t x = 0; x < 9; ++x) {
+        bool isInReach = (x >= 3) && (x <= 5) && (y >= 3) && (y <= 5);
+        const float *pixel = reinterpret_cast<const float *>(GetPixelAddress(target, x, y));
+        EXPECT_NEAR(isInReach ? 1.0f : 0.0f, pixel[0], 0.0001f);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, ConstantColorSurvivesBlurIncludingBorders) {
+    Bitmap bitmap(23, 17, FloatFormat);
+    fill(bitmap, 0.5f);
+
+    BitmapFilter::Convolve(bitmap.Access(), bitmap.Access(), SeparableKernel::Gaussian(6.0f));
+
+    for(std::size_t y = 0; y < 17; ++y) {
+      for(std::size_t x = 0; x < 23; ++x) {
+        const float *pixel = reinterpret_cast<const float *>(GetPixelAddress(bitmap, x, y));
+        EXPECT_NEAR(0.5f, pixel[0], 0.0001f);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, SlidingBoxMatchesWeightedKernel) {
+    Bitmap source(41, 37, FloatFormat);
+    FillWithFloatPattern(source);
+    Bitmap slid(41, 37, FloatFormat);
+    Bitmap weighted(41, 37, FloatFormat);
+
+    BitmapFilter::Convolve(source.Access(), slid.Access(), SeparableKernel::Box(2));
+    BitmapFilter::Convolve(
+      source.Access(), weighted.Access(),
+      SeparableKernel::FromWeights(std::vector<float>(5, 0.2f))
+    );
+
+    EXPECT_LT(getLargestDifference(slid, weighted), 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, GaussianApproximationIsCloseToTrueGaussian) {
+    const float sigma = 3.0f;
+    SeparableKernel approximation = SeparableKernel::Gaussian(sigma);
+    ASSERT_EQ(3U, approximation.GetBoxRadii().size());
+
+    std::size_t radius = approximation.GetHorizontalRadius();
+    std::vector<float> weights(radius * 2 + 1);
+    float totalWeight = 0.0f;
+    for(std::size_t index = 0; index < weights.size(); ++index) {
+      float distance = static_cast<float>(index) - static_cast<float>(radius);
+      weights[index] = std::exp(-(distance * distance) / (2.0f * sigma * sigma));
+      totalWeight += weights[index];
+    }
+    for(float &weight : weights) {
+      weight /= totalWeight;
+    }
+
+    Bitmap source(33, 33, FloatFormat);
+    fill(source, 0.0f);
+    reinterpret_cast<float *>(GetPixelAddress(source, 16, 16))[0] = 1000.0f;
+    Bitmap boxed(33, 33, FloatFormat);
+    Bitmap exact(33, 33, FloatFormat);
+
+    BitmapFilter::Convolve(source.Access(), boxed.Access(), approximation);
+    BitmapFilter::Convolve(
+      source.Access(), exact.Access(), SeparableKernel::FromWeights(weights)
+    );
+
+    // Relative to the blurred peak, the approximation should be within a few percent
+    float peak = reinterpret_cast<const float *>(GetPixelAddress(exact, 16, 16))[0];
+    EXPECT_LT(getLargestDifference(boxed, exact), peak * 0.05f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, ParallelFilteringMatchesSerialFiltering) {
+    ThreadPool threadPool(4);
+    Bitmap source(300, 250, FloatFormat);
+    FillWithFloatPattern(source);
+
+    SeparableKernel kernels[] = {
+      SeparableKernel::Gaussian(4.0f),
+      SeparableKernel::FromWeights({ 0.25f, 0.5f, 0.25f }, { -0.5f, 2.0f, -0.5f })
+    };
+    for(const SeparableKernel &kernel : kernels) {
+      Bitmap serial(300, 250, FloatFormat);
+      Bitmap parallel(300, 250, FloatFormat);
+
+      BitmapFilter::Convolve(source.Access(), serial.Access(), kernel);
+      BitmapFilter::Convolve(source.Access(), parallel.Access(), threadPool, kernel);
+
+      EXPECT_EQ(0.0f, getLargestDifference(serial, parallel));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, RegionsUseSurroundingPixelsAsHalo) {
+    Bitmap source(64, 48, FloatFormat);
+    FillWithFloatPattern(source);
+    Bitmap whole(64, 48, FloatFormat);
+    BitmapFilter::Convolve(source.Access(), whole.Access(), SeparableKernel::Gaussian(2.5f));
+
+    Bitmap region(20, 14, FloatFormat);
+    BitmapFilter::Convolve(
+      source.Access(), Rectangle::FromPositionAndSize(30, 17, 20, 14),
+      region.Access(), SeparableKernel::Gaussian(2.5f)
+    );
+
+    EXPECT_LT(getLargestDifference(whole.GetView(30, 17, 20, 14), region), 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, CanFilterInPlace) {
+    Bitmap source(40, 30, FloatFormat);
+    FillWithFloatPattern(source);
+    Bitmap separate(40, 30, FloatFormat);
+    BitmapFilter::Convolve(source.Access(), separate.Access(), SeparableKernel::Box(3, 2));
+
+    BitmapFilter::Convolve(source.Access(), source.Access(), SeparableKernel::Box(3, 2));
+
+    EXPECT_EQ(0.0f, getLargestDifference(separate, source));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, WorksWithIntegerPixelFormats) {
+    Bitmap source(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    std::uint8_t *pixels = static_cast<std::uint8_t *>(source.Access().Pixels);
+    for(std::size_t index = 0; index < 16 * 16 * 4; ++index) {
+      pixels[index] = 200;
+    }
+
+    BitmapFilter::Convolve(source.Access(), source.Access(), SeparableKernel::Gaussian(1.0f));
+
+    for(std::size_t index = 0; index < 16 * 16 * 4; ++index) {
+      EXPECT_EQ(200, pixels[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapFilterTest, RejectsInvalidKernelsAndBitmaps) {
+    EXPECT_THROW(SeparableKernel::FromWeights({ 0.5f, 0.5f }), std::invalid_argument);
+    EXPECT_THROW(SeparableKernel::Box(2, 0), std::invalid_argument);
+    EXPECT_THROW(SeparableKernel::Gaussian(-1.0f), std::invalid_argument);
+
+    Bitmap source(16, 16, FloatFormat);
+    Bitmap smaller(8, 16, FloatFormat);
+    EXPECT_THROW(
+      BitmapFilter::Convolve(source.Access(), smaller.Access(), SeparableKernel::Box(1)),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      BitmapFilter::Convolve(
+        source.Access(), Rectangle::FromPositionAndSize(12, 0, 8, 16),
+        smaller.Access(), SeparableKernel::Box(1)
+      ),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
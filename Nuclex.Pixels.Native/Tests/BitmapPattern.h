@@ -0,0 +1,160 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+
+#ifndef NUCLEX_PIXELS_BITMAPPATTERN_H
+#define NUCLEX_PIXELS_BITMAPPATTERN_H
+
+#include "Nuclex/Pixels/Config.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/PixelFormat.h"
+
+#include <cstddef> // for std::size_t, std::ptrdiff_t
+#include <cstdint> // for std::uint8_t, std::uint32_t
+#include <cstring> // for std::memcmp
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the byte the test pattern places into a pixel</summary>
+  /// <param name="x">X coordinate of the pixel</param>
+  /// <param name="y">Y coordinate of the pixel</param>
+  /// <param name="byteIndex">Index of the byte within the pixel</param>
+  /// <returns>The byte the pattern holds at the specified location</returns>
+  /// <remarks>
+  ///   The bytes are hashed from their location, so neighbouring pixels, rows and
+  ///   channels all differ and no stride or channel mixup can go unnoticed.
+  /// </remarks>
+  inline std::uint8_t GetPatternByte(std::size_t x, std::size_t y, std::size_t byteIndex) {
+    std::uint32_t value = static_cast<std::uint32_t>(x * 73856093U ^ y * 19349663U);
+    value ^= static_cast<std::uint32_t>(byteIndex * 83492791U);
+    value ^= (value >> 13);
+    value *= 0x5BD1E995U;
+    return static_cast<std::uint8_t>(value ^ (value >> 15));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the address of a pixel in a bitmap</summary>
+  /// <param name="bitmap">Bitmap holding the pixel</param>
+  /// <param name="x">X coordinate of the pixel</param>
+  /// <param name="y">Y coordinate of the pixel</param>
+  /// <returns>The address of the pixel's first byte</returns>
+  /// <remarks>
+  ///   Works for any pixel format that fills whole bytes and for negative strides.
+  ///   Tests cast the address to the element type of the pixel format they use.
+  /// </remarks>
+  inline std::uint8_t *GetPixelAddress(const Bitmap &bitmap, std::size_t x, std::size_t y) {
+    const BitmapMemory &memory = bitmap.Access();
+    return static_cast<std::uint8_t *>(memory.Pixels) + (
+      static_cast<std::ptrdiff_t>(memory.Stride) * static_cast<std::ptrdiff_t>(y)
+    ) + CountRequiredBytes(memory.PixelFormat, x);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a bitmap with a pattern that differs in each byte of each pixel</summary>
+  /// <param name="bitmap">Bitmap that will be filled with the pattern</param>
+  /// <remarks>
+  ///   Works for any pixel format that fills whole bytes. The bytes are written as they
+  ///   are, so floating point formats receive arbitrary values and should be filled via
+  ///   <see cref="FillWithFloatPattern" /> instead.
+  /// </remarks>
+  inline void FillWithPattern(const Bitmap &bitmap) {
+    const BitmapMemory &memory = bitmap.Access();
+    std::size_t bytesPerPixel = CountRequiredBytes(memory.PixelFormat, 1);
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = (
+        static_cast<std::uint8_t *>(memory.Pixels) + (memory.Stride * static_cast<int>(y))
+      );
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        for(std::size_t byteIndex = 0; byteIndex < bytesPerPixel; ++byteIndex) {
+          row[x * bytesPerPixel + byteIndex] = GetPatternByte(x, y, byteIndex);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a floating point RGBA bitmap with opaque, irregular colors</summary>
+  /// <param name="bitmap">
+  ///   Bitmap using the R32_G32_B32_A32_Float_Native32 pixel format that will be filled
+  /// </param>
+  inline void FillWithFloatPattern(const Bitmap &bitmap) {
+    const BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      float *row = reinterpret_cast<float *>(
+        static_cast<std::uint8_t *>(memory.Pixels) + (memory.Stride * static_cast<int>(y))
+      );
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        row[x * 4 + 0] = static_cast<float>((x * 7 + y * 13) % 17) / 16.0f;
+        row[x * 4 + 1] = static_cast<float>((x * x + y) % 11) / 10.0f;
+        row[x * 4 + 2] = static_cast<float>((x ^ y) % 5) / 4.0f;
+        row[x * 4 + 3] = 1.0f;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the pixels of two bitmaps are identical</summary>
+  /// <param name="first">First bitmap that will be compared</param>
+  /// <param name="second">Second bitmap that will be compared</param>
+  /// <returns>True if both bitmaps have the same size, pixel format and pixels</returns>
+  /// <remarks>
+  ///   Only the bytes covered by pixels are compared, so padding at the end of each row
+  ///   and differing strides (for example when one bitmap is a view) do not matter.
+  /// </remarks>
+  inline bool HaveSamePixels(const Bitmap &first, const Bitmap &second) {
+    const BitmapMemory &firstMemory = first.Access();
+    const BitmapMemory &secondMemory = second.Access();
+    if(
+      (firstMemory.Width != secondMemory.Width) ||
+      (firstMemory.Height != secondMemory.Height) ||
+      (firstMemory.PixelFormat != secondMemory.PixelFormat)
+    ) {
+      return false;
+    }
+
+    std::size_t rowByteCount = CountRequiredBytes(firstMemory.PixelFormat, firstMemory.Width);
+    for(std::size_t y = 0; y < firstMemory.Height; ++y) {
+      const std::uint8_t *firstRow = (
+        static_cast<const std::uint8_t *>(firstMemory.Pixels) +
+        (firstMemory.Stride * static_cast<int>(y))
+      );
+      const std::uint8_t *secondRow = (
+        static_cast<const std::uint8_t *>(secondMemory.Pixels) +
+        (secondMemory.Stride * static_cast<int>(y))
+      );
+      if(std::memcmp(firstRow, secondRow, rowByteCount) != 0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
+
+#endif // NUCLEX_PIXELS_BITMAPPATTERN_H
@@ -0,0 +1,205 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapResampler.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>All filters the resampler supports</summary>
+  const Nuclex::Pixels::ResamplingFilter AllFilters[] = {
+    Nuclex::Pixels::ResamplingFilter::Box,
+    Nuclex::Pixels::ResamplingFilter::Bilinear,
+    Nuclex::Pixels::ResamplingFilter::Lanczos3,
+    Nuclex::Pixels::ResamplingFilter::Mitchell
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills an R8-G8-B8-A8 bitmap with a single color</summary>
+  /// <param name="bitmap">Bitmap that will be filled</param>
+  /// <param name="color">Color (in memory byte order) the bitmap will be filled with</param>
+  void fill(const Nuclex::Pixels::Bitmap &bitmap, const std::uint8_t (&color)[4]) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        std::copy_n(color, 4, row + x * 4);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapResamplerTest, CommonPixelFormatsCanBeResampled) {
+    EXPECT_TRUE(BitmapResampler::CanResample(PixelFormat::R8_Unsigned));
+    EXPECT_TRUE(BitmapResampler::CanResample(PixelFormat::R8_G8_B8_A8_Unsigned));
+    EXPECT_TRUE(BitmapResampler::CanResample(PixelFormat::R5_G6_B5_Unsigned));
+    EXPECT_TRUE(BitmapResampler::CanResample(PixelFormat::R16_G16_B16_A16_Float));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapResamplerTest, SolidColorStaysTheSame) {
+    const std::uint8_t color[4] = { 12, 34, 56, 255 };
+
+    Bitmap source(37, 23, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fill(source, color);
+
+    for(ResamplingFilter filter : AllFilters) {
+      Bitmap smaller(11, 7, PixelFormat::R8_G8_B8_A8_Unsigned);
+      BitmapResampler::Resample(source.Access(), smaller.Access(), filter);
+
+      Bitmap larger(80, 51, PixelFormat::R8_G8_B8_A8_Unsigned);
+      BitmapResampler::Resample(source.Access(), larger.Access(), filter);
+
+      const std::uint8_t *smallPixels = static_cast<const std::uint8_t *>(
+        smaller.Access().Pixels
+      );
+      const std::uint8_t *largePixels = static_cast<const std::uint8_t *>(
+        larger.Access().Pixels
+      );
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        EXPECT_EQ(color[channel], smallPixels[4 * 5 + 3 * smaller.Access().Stride + channel]);
+        EXPECT_EQ(color[channel], largePixels[4 * 79 + 50 * larger.Access().Stride + channel]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapResamplerTest, ResamplingToSameSizeWithBoxFilterKeepsPixels) {
+    Bitmap source(29, 17, PixelFormat::R8_Unsigned);
+    FillWithPattern(source);
+
+    Bitmap target(29, 17, PixelFormat::R8_Unsigned);
+    BitmapResampler::Resample(source.Access(), target.Access(), ResamplingFilter::Box);
+
+    EXPECT_TRUE(HaveSamePixels(source, target));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapResamplerTest, BoxFilterAveragesPixelsWhenHalving) {
+    Bitmap source(4, 2, PixelFormat::R8_Unsigned);
+    {
+      const std::uint8_t topRow[4] = { 0, 100, 200, 40 };
+      const std::uint8_t bottomRow[4] = { 60, 80, 0, 0 };
+
+      std::uint8_t *pixels = static_cast<std::uint8_t *>(source.Access().Pixels);
+      std::copy_n(topRow, 4, pixels);
+      std::copy_n(bottomRow, 4, pixels + source.Access().Stride);
+    }
+
+    Bitmap target(2, 1, PixelFormat::R8_Unsigned);
+    BitmapResampler::Resample(source.Access(), target.Access(), ResamplingFilter::Box);
+
+    const std::uint8_t *pixels = static_cast<const std::uint8_t *>(target.Access().Pixels);
+    EXPECT_EQ(60, pixels[0]);
+    EXPECT_EQ(60, pixels[1]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapResamplerTest, TransparentPixelsDoNotBleedColor) {
+    Bitmap source(2, 1, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      std::uint8_t *pixels = static_cast<std::uint8_t *>(source.Access().Pixels);
+      const std::uint8_t opaqueRed[4] = { 255, 0, 0, 255 };
+      const std::uint8_t transparentGreen[4] = { 0, 255, 0, 0 };
+      std::copy_n(opaqueRed, 4, pixels);
+      std::copy_n(transparentGreen, 4, pixels + 4);
+    }
+
+    Bitmap target(1, 1, PixelFormat::R8_G8_B8_A8_Unsigned);
+    BitmapResampler::Resample(source.Access(), target.Access(), ResamplingFilter::Box);
+
+    const std::uint8_t *pixels = static_cast<const std::uint8_t *>(target.Access().Pixels);
+    EXPECT_EQ(255, pixels[0]);
+    EXPECT_EQ(0, pixels[1]);
+    EXPECT_EQ(0, pixels[2]);
+    EXPECT_EQ(128, pixels[3]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapResamplerTest, PixelFormatCanBeConvertedWhileResampling) {
+    const std::uint8_t color[4] = { 255, 0, 255, 255 };
+
+    Bitmap source(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fill(source, color);
+
+    Bitmap target(8, 8, PixelFormat::R8_Unsigned);
+    BitmapResampler::Resample(source.Access(), target.Access());
+
+    const std::uint8_t *pixels = static_cast<const std::uint8_t *>(target.Access().Pixels);
+    EXPECT_EQ(255, pixels[0]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapResamplerTest, ParallelResamplingMatchesSingleThreadedResampling) {
+    ThreadPool threadPool(4);
+
+    Bitmap source(1024, 777, PixelFormat::R8_Unsigned);
+    FillWithPattern(source);
+
+    for(ResamplingFilter filter : AllFilters) {
+      Bitmap expected(301, 203, PixelFormat::R8_Unsigned);
+      BitmapResampler::Resample(source.Access(), expected.Access(), filter);
+
+      Bitmap actual(301, 203, PixelFormat::R8_Unsigned);
+      BitmapResampler::Resample(source.Access(), actual.Access(), threadPool, filter);
+
+      EXPECT_TRUE(HaveSamePixels(expected, actual));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapResamplerTest, EmptySourceBitmapCausesException) {
+    Bitmap source(0, 0, PixelFormat::R8_Unsigned);
+    Bitmap target(4, 4, PixelFormat::R8_Unsigned);
+    EXPECT_THROW(
+      BitmapResampler::Resample(source.Access(), target.Access()), std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
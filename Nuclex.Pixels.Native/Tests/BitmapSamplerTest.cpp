@@ -0,0 +1,313 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapSampler.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <cmath> // for std::floor()
+#include <cstdint>
+#include <random> // for std::mt19937
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up a pixel index along one axis like a texture unit would</summary>
+  /// <param name="index">Index of the pixel, possibly outside of the bitmap</param>
+  /// <param name="size">Number of pixels along the axis</param>
+  /// <param name="wrap">Whether the bitmap repeats rather than being clamped</param>
+  /// <returns>The index of the pixel inside the bitmap</returns>
+  std::size_t address(long index, std::size_t size, bool wrap) {
+    long count = static_cast<long>(size);
+    if(wrap) {
+      return static_cast<std::size_t>(((index % count) + count) % count);
+    } else {
+      return static_cast<std::size_t>((index < 0) ? 0 : ((index >= count) ? count - 1 : index));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Samples an R8-G8-B8-A8 bitmap bilinearly the slow and obvious way</summary>
+  /// <param name="memory">Bitmap memory that will be sampled</param>
+  /// <param name="u">Horizontal coordinate at which the bitmap will be sampled</param>
+  /// <param name="v">Vertical coordinate at which the bitmap will be sampled</param>
+  /// <param name="wrap">Whether the bitmap repeats rather than being clamped</param>
+  /// <param name="rgba">Receives the sampled color as four floats from 0 to 255</param>
+  void sampleReference(
+    const Nuclex::Pixels::BitmapMemory &memory, float u, float v, bool wrap, float *rgba
+  ) {
+    float x = u * static_cast<float>(memory.Width) - 0.5f;
+    float y = v * static_cast<float>(memory.Height) - 0.5f;
+    float left = std::floor(x);
+    float top = std::floor(y);
+    float horizontal = x - left;
+    float vertical = y - top;
+
+    std::size_t columns[2] = {
+      address(static_cast<long>(left), memory.Width, wrap),
+      address(static_cast<long>(left) + 1, memory.Width, wrap)
+    };
+    std::size_t rows[2] = {
+      address(static_cast<long>(top), memory.Height, wrap),
+      address(static_cast<long>(top) + 1, memory.Height, wrap)
+    };
+
+    const std::uint8_t *pixels = static_cast<const std::uint8_t *>(memory.Pixels);
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      float corners[4];
+      for(std::size_t corner = 0; corner < 4; ++corner) {
+        corners[corner] = pixels[
+          rows[corner >> 1] * memory.Stride + columns[corner & 1] * 4 + channel
+        ];
+      }
+      float upper = corners[0] + (corners[1] - corners[0]) * horizontal;
+      float lower = corners[2] + (corners[3] - corners[2]) * horizontal;
+      rgba[channel] = upper + (lower - upper) * vertical;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, CommonPixelFormatsCanBeSampled) {
+    EXPECT_TRUE(BitmapSampler::CanSample(PixelFormat::R8_Unsigned));
+    EXPECT_TRUE(BitmapSampler::CanSample(PixelFormat::R8_G8_B8_A8_Unsigned));
+    EXPECT_TRUE(BitmapSampler::CanSample(PixelFormat::B8_G8_R8_Unsigned));
+    EXPECT_TRUE(BitmapSampler::CanSample(PixelFormat::R5_G6_B5_Unsigned_Native16));
+    EXPECT_TRUE(BitmapSampler::CanSample(PixelFormat::R32_G32_B32_A32_Float_Native32));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, InvalidFilterIsRejected) {
+    Bitmap bitmap(4, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_THROW(
+      BitmapSampler sampler(bitmap.Access(), static_cast<SamplingFilter>(-1)),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, NearestFilterPicksPixelUnderCoordinate) {
+    Bitmap bitmap(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(bitmap);
+    const BitmapMemory &memory = bitmap.Access();
+    BitmapSampler sampler(memory, SamplingFilter::Nearest);
+
+    std::vector<float> u, v;
+    for(std::size_t y = 0; y < 16; ++y) {
+      for(std::size_t x = 0; x < 16; ++x) {
+        u.push_back((static_cast<float>(x) + 0.25f) / 16.0f);
+        v.push_back((static_cast<float>(y) + 0.75f) / 16.0f);
+      }
+    }
+
+    std::vector<std::uint8_t> rgba(u.size() * 4);
+    sampler.Sample(u.data(), v.data(), u.size(), rgba.data());
+
+    for(std::size_t y = 0; y < 16; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Pixels) + y * memory.Stride
+      );
+      for(std::size_t x = 0; x < 16 * 4; ++x) {
+        EXPECT_EQ(row[x], rgba[y * 16 * 4 + x]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, BilinearFilterInterpolatesBetweenPixels) {
+    Bitmap bitmap(2, 1, PixelFormat::R8_G8_B8_A8_Unsigned);
+    std::uint8_t *pixels = static_cast<std::uint8_t *>(bitmap.Access().Pixels);
+    for(std::size_t index = 0; index < 4; ++index) {
+      pixels[index] = 0;
+      pixels[4 + index] = 200;
+    }
+
+    BitmapSampler sampler(bitmap.Access());
+
+    // Pixel centers are at 0.25 and 0.75, so these are a quarter, half and three quarters
+    const float u[] = { 0.375f, 0.5f, 0.625f };
+    const float v[] = { 0.5f, 0.5f, 0.5f };
+
+    std::uint8_t bytes[3 * 4];
+    sampler.Sample(u, v, 3, bytes);
+    EXPECT_EQ(50U, bytes[0]);
+    EXPECT_EQ(100U, bytes[4]);
+    EXPECT_EQ(150U, bytes[8]);
+
+    float floats[3 * 4];
+    sampler.Sample(u, v, 3, floats);
+    EXPECT_NEAR(50.0f / 255.0f, floats[0], 0.0001f);
+    EXPECT_NEAR(100.0f / 255.0f, floats[4], 0.0001f);
+    EXPECT_NEAR(150.0f / 255.0f, floats[8], 0.0001f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, ClampingRepeatsEdgePixels) {
+    Bitmap bitmap(4, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(bitmap);
+    BitmapSampler sampler(bitmap.Access(), SamplingFilter::Bilinear, TextureAddressing::Clamp);
+
+    const float u[] = { -5.0f, 0.0f, 1.0f, 7.5f };
+    const float v[] = { 0.125f, 0.125f, 0.125f, 0.125f };
+    std::uint8_t rgba[4 * 4];
+    sampler.Sample(u, v, 4, rgba);
+
+    const std::uint8_t *row = static_cast<const std::uint8_t *>(bitmap.Access().Pixels);
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      EXPECT_EQ(row[channel], rgba[channel]);
+      EXPECT_EQ(row[channel], rgba[4 + channel]);
+      EXPECT_EQ(row[12 + channel], rgba[8 + channel]);
+      EXPECT_EQ(row[12 + channel], rgba[12 + channel]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, WrappingRepeatsBitmap) {
+    Bitmap bitmap(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(bitmap);
+    BitmapSampler sampler(bitmap.Access(), SamplingFilter::Nearest, TextureAddressing::Wrap);
+
+    const float u[] = { 0.3f, 1.3f, -0.7f, 5.3f };
+    const float v[] = { 0.6f, -1.4f, 2.6f, 0.6f };
+    std::uint8_t rgba[4 * 4];
+    sampler.Sample(u, v, 4, rgba);
+
+    for(std::size_t index = 1; index < 4; ++index) {
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        EXPECT_EQ(rgba[channel], rgba[index * 4 + channel]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, ChannelsAreReturnedInRgbaOrder) {
+    Bitmap bgra(1, 1, PixelFormat::B8_G8_R8_A8_Unsigned);
+    std::uint8_t *pixel = static_cast<std::uint8_t *>(bgra.Access().Pixels);
+    pixel[0] = 10; // blue
+    pixel[1] = 20; // green
+    pixel[2] = 30; // red
+    pixel[3] = 40; // alpha
+
+    Bitmap red(1, 1, PixelFormat::R8_Unsigned);
+    *static_cast<std::uint8_t *>(red.Access().Pixels) = 99;
+
+    const float u[] = { 0.5f };
+    const float v[] = { 0.5f };
+    std::uint8_t rgba[4];
+
+    BitmapSampler(bgra.Access()).Sample(u, v, 1, rgba);
+    EXPECT_EQ(30U, rgba[0]);
+    EXPECT_EQ(20U, rgba[1]);
+    EXPECT_EQ(10U, rgba[2]);
+    EXPECT_EQ(40U, rgba[3]);
+
+    BitmapSampler(red.Access()).Sample(u, v, 1, rgba);
+    EXPECT_EQ(99U, rgba[0]);
+    EXPECT_EQ(0U, rgba[1]);
+    EXPECT_EQ(0U, rgba[2]);
+    EXPECT_EQ(255U, rgba[3]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, FloatBitmapsCanBeSampled) {
+    Bitmap bitmap(2, 2, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    float *pixels = static_cast<float *>(bitmap.Access().Pixels);
+    for(std::size_t index = 0; index < 16; ++index) {
+      pixels[index] = static_cast<float>(index);
+    }
+
+    // Exactly between all four pixels, so each channel is the average of its four values
+    BitmapSampler sampler(bitmap.Access());
+    const float u[] = { 0.5f };
+    const float v[] = { 0.5f };
+    float rgba[4];
+    sampler.Sample(u, v, 1, rgba);
+
+    EXPECT_FLOAT_EQ(6.0f, rgba[0]);
+    EXPECT_FLOAT_EQ(7.0f, rgba[1]);
+    EXPECT_FLOAT_EQ(8.0f, rgba[2]);
+    EXPECT_FLOAT_EQ(9.0f, rgba[3]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSamplerTest, BilinearSamplesMatchReference) {
+    Bitmap parent(48, 40, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(parent);
+
+    // Use a view so the stride differs from the width of the sampled area
+    Bitmap bitmap = parent.GetView(5, 3, 37, 29);
+    const BitmapMemory &memory = bitmap.Access();
+
+    std::mt19937 randomNumberGenerator(1234);
+    std::uniform_real_distribution<float> coordinates(-1.5f, 2.5f);
+
+    const std::size_t count = 1003; // Not a multiple of the batch size
+    std::vector<float> u(count), v(count);
+    for(std::size_t index = 0; index < count; ++index) {
+      u[index] = coordinates(randomNumberGenerator);
+      v[index] = coordinates(randomNumberGenerator);
+    }
+
+    for(bool wrap : { false, true }) {
+      BitmapSampler sampler(
+        memory, SamplingFilter::Bilinear,
+        wrap ? TextureAddressing::Wrap : TextureAddressing::Clamp
+      );
+      std::vector<std::uint8_t> bytes(count * 4);
+      std::vector<float> floats(count * 4);
+      sampler.Sample(u.data(), v.data(), count, bytes.data());
+      sampler.Sample(u.data(), v.data(), count, floats.data());
+
+      for(std::size_t index = 0; index < count; ++index) {
+        float expected[4];
+        sampleReference(memory, u[index], v[index], wrap, expected);
+        for(std::size_t channel = 0; channel < 4; ++channel) {
+          EXPECT_NEAR(expected[channel], bytes[index * 4 + channel], 1.5f);
+          EXPECT_NEAR(expected[channel] / 255.0f, floats[index * 4 + channel], 0.001f);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -22,8 +22,14 @@ License along with this library
 #define NUCLEX_PIXELS_SOURCE 1
 
 #include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/ThreadPool.h"
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
@@ -132,4 +138,245 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(BitmapTest, RowsCanBeAlignedToCacheLines) {
+    Bitmap alignedBitmap(
+      33, 7, PixelFormat::R8_G8_B8_Unsigned,
+      BitmapAllocator::GetDefault(), Bitmap::CacheLineByteCount
+    );
+
+    const BitmapMemory &memory = alignedBitmap.Access();
+    EXPECT_EQ(33U, memory.Width);
+    EXPECT_EQ(128, memory.Stride);
+    EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(memory.Pixels) % Bitmap::CacheLineByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, CopiesKeepRowAlignment) {
+    Bitmap alignedBitmap(
+      33, 7, PixelFormat::R8_G8_B8_Unsigned,
+      BitmapAllocator::GetDefault(), Bitmap::CacheLineByteCount
+    );
+    static_cast<std::uint8_t *>(alignedBitmap.Access().Pixels)[128 * 6 + 98] = 123;
+
+    Bitmap clone(alignedBitmap);
+    const BitmapMemory &memory = clone.Access();
+    EXPECT_EQ(128, memory.Stride);
+    EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(memory.Pixels) % Bitmap::CacheLineByteCount);
+    EXPECT_EQ(123, static_cast<const std::uint8_t *>(memory.Pixels)[128 * 6 + 98]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, RowAlignmentMustBePowerOfTwo) {
+    EXPECT_THROW(
+      Bitmap(16, 16, PixelFormat::R8_Unsigned, BitmapAllocator::GetDefault(), 48),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, ViewsCanBeCreatedAndDestroyedOnDifferentThreads) {
+    ThreadPool threadPool(4);
+    std::vector<Bitmap> views;
+    {
+      Bitmap original(64, 64, PixelFormat::R8_Unsigned);
+      static_cast<std::uint8_t *>(original.Access().Pixels)[0] = 42;
+
+      views.reserve(64);
+      for(std::size_t index = 0; index < 64; ++index) {
+        views.push_back(original.GetView(0, 0, 64, 64));
+      }
+    }
+
+    // Each thread creates and destroys thousands of further views of the shared buffer
+    threadPool.ForEach(
+      views.size(),
+      [&views](std::size_t index) {
+        for(std::size_t repetition = 0; repetition < 1000; ++repetition) {
+          Bitmap view = views[index].GetView(1, 1, 8, 8);
+          Bitmap copy = view;
+          (void)copy;
+        }
+        views[index] = Bitmap(1, 1, PixelFormat::R8_Unsigned);
+      }
+    );
+
+    for(std::size_t index = 0; index < views.size(); ++index) {
+      EXPECT_EQ(1U, views[index].GetWidth());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, ReportsMemoryUsed) {
+    Bitmap bitmap(32, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_GE(bitmap.GetMemoryUsed(), 32U * 16U * 4U);
+    EXPECT_FALSE(bitmap.IsWastingMemory());
+
+    std::vector<std::uint8_t> pixels(64 * 64);
+    BitmapMemory memory;
+    memory.Width = 64;
+    memory.Height = 64;
+    memory.Stride = 64;
+    memory.PixelFormat = PixelFormat::R8_Unsigned;
+    memory.Pixels = pixels.data();
+
+    Bitmap external = Bitmap::FromExistingMemory(memory);
+    EXPECT_LT(external.GetMemoryUsed(), pixels.size());
+    EXPECT_FALSE(external.IsWastingMemory());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, OrphanedViewsAreWastingMemory) {
+    Bitmap view(1, 1, PixelFormat::R8_Unsigned);
+    {
+      Bitmap original(256, 256, PixelFormat::R8_Unsigned);
+      view = original.GetView(8, 8, 4, 4);
+      EXPECT_FALSE(view.IsWastingMemory());
+    }
+
+    EXPECT_TRUE(view.IsWastingMemory());
+    EXPECT_FALSE(view.IsWastingMemory(view.GetMemoryUsed()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, CompactionMovesOrphanedViewIntoRightSizedBuffer) {
+    Bitmap view(1, 1, PixelFormat::R8_Unsigned);
+    {
+      Bitmap original(256, 256, PixelFormat::R8_Unsigned);
+      static_cast<std::uint8_t *>(original.Access().Pixels)[256 * 9 + 10] = 99;
+      view = original.GetView(8, 8, 4, 4);
+      EXPECT_FALSE(view.CompactIfWasting());
+    }
+
+    std::size_t usedBeforeCompaction = view.GetMemoryUsed();
+    EXPECT_FALSE(view.CompactIfWasting(usedBeforeCompaction));
+    EXPECT_TRUE(view.CompactIfWasting());
+    EXPECT_FALSE(view.IsWastingMemory());
+    EXPECT_LT(view.GetMemoryUsed(), usedBeforeCompaction);
+
+    const BitmapMemory &memory = view.Access();
+    EXPECT_EQ(4, memory.Stride);
+    EXPECT_EQ(99, static_cast<const std::uint8_t *>(memory.Pixels)[4 * 1 + 2]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, CopyOnWriteCopiesShareMemoryUntilModified) {
+    Bitmap original(16, 16, PixelFormat::R8_Unsigned);
+    original.EnableCopyOnWrite();
+    static_cast<std::uint8_t *>(original.AccessMutable().Pixels)[0] = 11;
+
+    Bitmap copy(original);
+    EXPECT_TRUE(copy.IsCopyOnWrite());
+    EXPECT_EQ(original.Access().Pixels, copy.Access().Pixels);
+
+    static_cast<std::uint8_t *>(copy.AccessMutable().Pixels)[0] = 22;
+    EXPECT_NE(original.Access().Pixels, copy.Access().Pixels);
+    EXPECT_EQ(11, static_cast<const std::uint8_t *>(original.Access().Pixels)[0]);
+    EXPECT_EQ(22, static_cast<const std::uint8_t *>(copy.Access().Pixels)[0]);
+
+    // The original is the sole owner of its memory again, so no copy is needed
+    const void *originalPixels = original.Access().Pixels;
+    EXPECT_EQ(originalPixels, original.AccessMutable().Pixels);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, CopiesWithoutCopyOnWriteAreIndependent) {
+    Bitmap original(16, 16, PixelFormat::R8_Unsigned);
+    EXPECT_FALSE(original.IsCopyOnWrite());
+
+    Bitmap copy(original);
+    EXPECT_NE(original.Access().Pixels, copy.Access().Pixels);
+
+    // Views are meant to modify their parent, so mutable access must not detach them
+    Bitmap view = original.GetView(0, 0, 8, 8);
+    EXPECT_EQ(original.Access().Pixels, view.AccessMutable().Pixels);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, DirtyRegionTrackingIsOffByDefault) {
+    Bitmap bitmap(64, 64, PixelFormat::R8_Unsigned);
+    EXPECT_FALSE(bitmap.IsTrackingDirtyRegions());
+    EXPECT_EQ(bitmap.GetDirtyRegionTracker(), nullptr);
+
+    bitmap.AccessMutable();
+    EXPECT_TRUE(bitmap.GetDirtyRegions().empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, MutableAccessMarksRegionsDirty) {
+    Bitmap bitmap(128, 128, PixelFormat::R8_Unsigned);
+    bitmap.EnableDirtyTracking(32);
+    EXPECT_TRUE(bitmap.IsTrackingDirtyRegions());
+    EXPECT_TRUE(bitmap.GetDirtyRegions().empty());
+
+    bitmap.AccessMutable(Rectangle(10, 10, 20, 20));
+    std::vector<Rectangle> regions = bitmap.GetDirtyRegions();
+    ASSERT_EQ(regions.size(), 1U);
+    EXPECT_EQ(regions[0].MaxX, 32U);
+    EXPECT_EQ(regions[0].MaxY, 32U);
+
+    bitmap.ClearDirtyRegions();
+    bitmap.AccessMutable();
+    regions = bitmap.GetDirtyRegions();
+    ASSERT_EQ(regions.size(), 1U);
+    EXPECT_EQ(regions[0].MaxX, 128U);
+    EXPECT_EQ(regions[0].MaxY, 128U);
+
+    bitmap.DisableDirtyTracking();
+    EXPECT_FALSE(bitmap.IsTrackingDirtyRegions());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, CopiesTakeOverDirtyRegions) {
+    Bitmap original(128, 128, PixelFormat::R8_Unsigned);
+    original.EnableDirtyTracking(32);
+    original.MarkDirty(Rectangle(100, 100, 101, 101));
+
+    Bitmap copy(original);
+    ASSERT_TRUE(copy.IsTrackingDirtyRegions());
+    EXPECT_EQ(copy.GetDirtyRegions().size(), 1U);
+
+    // Both trackers are independent of each other
+    copy.ClearDirtyRegions();
+    EXPECT_EQ(original.GetDirtyRegions().size(), 1U);
+
+    Bitmap moved(std::move(original));
+    EXPECT_TRUE(moved.IsTrackingDirtyRegions());
+    EXPECT_EQ(moved.GetDirtyRegions().size(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTest, LiveBytesOfAllBitmapsAreCounted) {
+    std::size_t byteCountBefore = Bitmap::GetLiveByteCount();
+    std::size_t bufferCountBefore = Bitmap::GetLiveBufferCount();
+    {
+      Bitmap bitmap(64, 64, PixelFormat::R8_Unsigned);
+      Bitmap view = bitmap.GetView(0, 0, 16, 16);
+      EXPECT_EQ(byteCountBefore + bitmap.GetMemoryUsed(), Bitmap::GetLiveByteCount());
+      EXPECT_EQ(bufferCountBefore + 1U, Bitmap::GetLiveBufferCount());
+
+      Bitmap copy(view);
+      EXPECT_EQ(
+        byteCountBefore + bitmap.GetMemoryUsed() + copy.GetMemoryUsed(),
+        Bitmap::GetLiveByteCount()
+      );
+      EXPECT_EQ(bufferCountBefore + 2U, Bitmap::GetLiveBufferCount());
+    }
+    EXPECT_EQ(byteCountBefore, Bitmap::GetLiveByteCount());
+    EXPECT_EQ(bufferCountBefore, Bitmap::GetLiveBufferCount());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Pixels
@@ -0,0 +1,241 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BitmapTransformer.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility> // for std::swap()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pixel formats with all pixel sizes the transformations are tested with</summary>
+  const Nuclex::Pixels::PixelFormat TestedPixelFormats[] = {
+    Nuclex::Pixels::PixelFormat::R8_Unsigned,
+    Nuclex::Pixels::PixelFormat::R8_G8_Unsigned,
+    Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned,
+    Nuclex::Pixels::PixelFormat::R8_G8_B8_A8_Unsigned,
+    Nuclex::Pixels::PixelFormat::A16_B16_G16_R16_Float,
+    Nuclex::Pixels::PixelFormat::R32_G32_B32_A32_Float_Native32
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks that each pixel in a bitmap came from the expected place</summary>
+  /// <typeparam name="TMapping">Maps coordinates in the bitmap to original coordinates</typeparam>
+  /// <param name="bitmap">Bitmap whose pixels will be checked</param>
+  /// <param name="mapping">
+  ///   Receives the coordinates of a pixel in the bitmap and writes the coordinates
+  ///   the pixel had in the pattern into them
+  /// </param>
+  /// <returns>True if all pixels have the values expected at their locations</returns>
+  template<typename TMapping>
+  bool isPatternMapped(const Nuclex::Pixels::Bitmap &bitmap, TMapping &&mapping) {
+    std::size_t bytesPerPixel = Nuclex::Pixels::CountRequiredBytes(bitmap.GetPixelFormat(), 1);
+    for(std::size_t y = 0; y < bitmap.GetHeight(); ++y) {
+      for(std::size_t x = 0; x < bitmap.GetWidth(); ++x) {
+        std::size_t originalX = x, originalY = y;
+        mapping(originalX, originalY);
+
+        const std::uint8_t *pixel = Nuclex::Pixels::GetPixelAddress(bitmap, x, y);
+        for(std::size_t byteIndex = 0; byteIndex < bytesPerPixel; ++byteIndex) {
+          if(pixel[byteIndex] != Nuclex::Pixels::GetPatternByte(originalX, originalY, byteIndex)) {
+            return false;
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, CanFlipVertically) {
+    for(PixelFormat pixelFormat : TestedPixelFormats) {
+      Bitmap bitmap(37, 29, pixelFormat);
+      FillWithPattern(bitmap);
+
+      BitmapTransformer::FlipVertical(bitmap.Access());
+      EXPECT_TRUE(
+        isPatternMapped(bitmap, [](std::size_t &, std::size_t &y) { y = 28 - y; })
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, CanFlipHorizontally) {
+    for(PixelFormat pixelFormat : TestedPixelFormats) {
+      Bitmap bitmap(37, 29, pixelFormat);
+      FillWithPattern(bitmap);
+
+      BitmapTransformer::FlipHorizontal(bitmap.Access());
+      EXPECT_TRUE(
+        isPatternMapped(bitmap, [](std::size_t &x, std::size_t &) { x = 36 - x; })
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, CanRotateBy180Degrees) {
+    for(PixelFormat pixelFormat : TestedPixelFormats) {
+      Bitmap bitmap(37, 29, pixelFormat);
+      FillWithPattern(bitmap);
+
+      BitmapTransformer::Rotate180(bitmap.Access());
+      EXPECT_TRUE(
+        isPatternMapped(
+          bitmap, [](std::size_t &x, std::size_t &y) { x = 36 - x; y = 28 - y; }
+        )
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, CanTransposeIntoOtherBitmap) {
+    for(PixelFormat pixelFormat : TestedPixelFormats) {
+      Bitmap source(71, 45, pixelFormat);
+      FillWithPattern(source);
+      Bitmap target(45, 71, pixelFormat);
+
+      BitmapTransformer::Transpose(source.Access(), target.Access());
+      EXPECT_TRUE(
+        isPatternMapped(target, [](std::size_t &x, std::size_t &y) { std::swap(x, y); })
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, CanRotateBy90DegreesIntoOtherBitmap) {
+    for(PixelFormat pixelFormat : TestedPixelFormats) {
+      Bitmap source(71, 45, pixelFormat);
+      FillWithPattern(source);
+      Bitmap target(45, 71, pixelFormat);
+
+      // Clockwise, so the source's left column becomes the target's top row
+      BitmapTransformer::Rotate90(source.Access(), target.Access());
+      EXPECT_TRUE(
+        isPatternMapped(
+          target, [](std::size_t &x, std::size_t &y) { std::size_t t = x; x = y; y = 44 - t; }
+        )
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, CanRotateBy270DegreesIntoOtherBitmap) {
+    for(PixelFormat pixelFormat : TestedPixelFormats) {
+      Bitmap source(71, 45, pixelFormat);
+      FillWithPattern(source);
+      Bitmap target(45, 71, pixelFormat);
+
+      BitmapTransformer::Rotate270(source.Access(), target.Access());
+      EXPECT_TRUE(
+        isPatternMapped(
+          target, [](std::size_t &x, std::size_t &y) { std::size_t t = x; x = 70 - y; y = t; }
+        )
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, CanTransformSquareBitmapsInPlace) {
+    for(PixelFormat pixelFormat : TestedPixelFormats) {
+      Bitmap bitmap(67, 67, pixelFormat);
+
+      FillWithPattern(bitmap);
+      BitmapTransformer::Transpose(bitmap.Access());
+      EXPECT_TRUE(
+        isPatternMapped(bitmap, [](std::size_t &x, std::size_t &y) { std::swap(x, y); })
+      );
+
+      FillWithPattern(bitmap);
+      BitmapTransformer::Rotate90(bitmap.Access());
+      EXPECT_TRUE(
+        isPatternMapped(
+          bitmap, [](std::size_t &x, std::size_t &y) { std::size_t t = x; x = y; y = 66 - t; }
+        )
+      );
+
+      FillWithPattern(bitmap);
+      BitmapTransformer::Rotate270(bitmap.Access());
+      EXPECT_TRUE(
+        isPatternMapped(
+          bitmap, [](std::size_t &x, std::size_t &y) { std::size_t t = x; x = 66 - y; y = t; }
+        )
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, WorksOnViews) {
+    Bitmap bitmap(64, 64, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap view = bitmap.GetView(3, 5, 37, 29);
+    FillWithPattern(view);
+    Bitmap target(29, 37, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    BitmapTransformer::Transpose(view.Access(), target.Access());
+    EXPECT_TRUE(
+      isPatternMapped(target, [](std::size_t &x, std::size_t &y) { std::swap(x, y); })
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapTransformerTest, RejectsMismatchingBitmaps) {
+    Bitmap square(16, 16, PixelFormat::R8_Unsigned);
+    Bitmap wide(32, 16, PixelFormat::R8_Unsigned);
+    Bitmap compressed(16, 16, PixelFormat::BC1_Compressed);
+
+    EXPECT_THROW(BitmapTransformer::Transpose(wide.Access()), std::invalid_argument);
+    EXPECT_THROW(
+      BitmapTransformer::Rotate90(wide.Access(), wide.Access()), std::invalid_argument
+    );
+    EXPECT_THROW(BitmapTransformer::FlipVertical(compressed.Access()), std::invalid_argument);
+    EXPECT_THROW(
+      BitmapTransformer::Transpose(square.Access(), compressed.Access()), std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
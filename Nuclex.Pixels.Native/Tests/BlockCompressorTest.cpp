@@ -0,0 +1,390 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/BlockCompressor.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib> // for std::abs()
+#include <cstring> // for std::memcmp()
+#include <stdexcept>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills an R8-G8-B8-A8 bitmap with smooth gradients in all four channels</summary>
+  /// <param name="bitmap">Bitmap that will be filled</param>
+  void fillWithGradients(const Nuclex::Pixels::Bitmap &bitmap) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        row[x * 4 + 0] = static_cast<std::uint8_t>(x * 4);
+        row[x * 4 + 1] = static_cast<std::uint8_t>(y * 4);
+        row[x * 4 + 2] = static_cast<std::uint8_t>(128 + x * 2);
+        row[x * 4 + 3] = static_cast<std::uint8_t>(255 - y * 3);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a BC1 color block the way a GPU would</summary>
+  /// <param name="block">Block of 8 bytes that will be decoded</param>
+  /// <param name="pixels">Receives the 16 decoded pixels in R8-G8-B8-A8 format</param>
+  void decodeBc1Block(const std::uint8_t *block, std::uint8_t *pixels) {
+    int colors[2] = { block[0] | (block[1] << 8), block[2] | (block[3] << 8) };
+
+    int palette[4][4];
+    for(std::size_t endpoint = 0; endpoint < 2; ++endpoint) {
+      int red = (colors[endpoint] >> 11) & 31;
+      int green = (colors[endpoint] >> 5) & 63;
+      int blue = colors[endpoint] & 31;
+      palette[endpoint][0] = (red << 3) | (red >> 2);
+      palette[endpoint][1] = (green << 2) | (green >> 4);
+      palette[endpoint][2] = (blue << 3) | (blue >> 2);
+      palette[endpoint][3] = 255;
+    }
+    for(std::size_t channel = 0; channel < 3; ++channel) {
+      if(colors[0] > colors[1]) {
+        palette[2][channel] = (palette[0][channel] * 2 + palette[1][channel]) / 3;
+        palette[3][channel] = (palette[0][channel] + palette[1][channel] * 2) / 3;
+      } else {
+        palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+        palette[3][channel] = 0;
+      }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = (colors[0] > colors[1]) ? 255 : 0;
+
+    for(std::size_t index = 0; index < 16; ++index) {
+      int entry = (block[4 + index / 4] >> ((index % 4) * 2)) & 3;
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        pixels[index * 4 + channel] = static_cast<std::uint8_t>(palette[entry][channel]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a BC4 single channel block the way a GPU would</summary>
+  /// <param name="block">Block of 8 bytes that will be decoded</param>
+  /// <param name="pixels">Pixels in R8-G8-B8-A8 format that will receive the channel</param>
+  /// <param name="channel">Index of the channel that will receive the decoded values</param>
+  void decodeBc4Block(const std::uint8_t *block, std::uint8_t *pixels, std::size_t channel) {
+    int palette[8] = { block[0], block[1] };
+    for(int entry = 2; entry < 8; ++entry) {
+      if(block[0] > block[1]) {
+        palette[entry] = ((8 - entry) * block[0] + (entry - 1) * block[1] + 3) / 7;
+      } else if(entry < 6) {
+        palette[entry] = ((6 - entry) * block[0] + (entry - 1) * block[1] + 2) / 5;
+      } else {
+        palette[entry] = (entry == 6) ? 0 : 255;
+      }
+    }
+
+    std::uint64_t indices = 0;
+    for(std::size_t byteIndex = 0; byteIndex < 6; ++byteIndex) {
+      indices |= static_cast<std::uint64_t>(block[2 + byteIndex]) << (byteIndex * 8);
+    }
+    for(std::size_t index = 0; index < 16; ++index) {
+      pixels[index * 4 + channel] = static_cast<std::uint8_t>(
+        palette[(indices >> (index * 3)) & 7]
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes a BC7 block that has been encoded in mode 6</summary>
+  /// <param name="block">Block of 16 bytes that will be decoded</param>
+  /// <param name="pixels">Receives the 16 decoded pixels in R8-G8-B8-A8 format</param>
+  void decodeBc7Mode6Block(const std::uint8_t *block, std::uint8_t *pixels) {
+    static const int weights[16] = {
+      0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+    };
+
+    std::size_t position = 0;
+    auto read = [block, &position](std::size_t bitCount) {
+      int value = 0;
+      for(std::size_t bit = 0; bit < bitCount; ++bit, ++position) {
+        value |= ((block[position / 8] >> (position % 8)) & 1) << bit;
+      }
+      return value;
+    };
+
+    ASSERT_EQ(1 << 6, read(7)); // Mode 6
+
+    int endpoints[2][4];
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      endpoints[0][channel] = read(7) << 1;
+      endpoints[1][channel] = read(7) << 1;
+    }
+    int parityBits[2] = { read(1), read(1) };
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      endpoints[0][channel] |= parityBits[0];
+      endpoints[1][channel] |= parityBits[1];
+    }
+
+    for(std::size_t index = 0; index < 16; ++index) {
+      int weight = weights[read((index == 0) ? 3 : 4)];
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        pixels[index * 4 + channel] = static_cast<std::uint8_t>(
+          ((64 - weight) * endpoints[0][channel] + weight * endpoints[1][channel] + 32) >> 6
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>
+  ///   Decodes a compressed bitmap and finds the largest difference to the original
+  /// </summary>
+  /// <param name="original">Bitmap in R8-G8-B8-A8 format that was compressed</param>
+  /// <param name="compressed">Bitmap holding the compressed blocks</param>
+  /// <param name="channelCount">Number of channels that will be compared</param>
+  /// <returns>The largest difference in any of the compared channels</returns>
+  int findLargestError(
+    const Nuclex::Pixels::Bitmap &original, const Nuclex::Pixels::Bitmap &compressed,
+    std::size_t channelCount
+  ) {
+    using Nuclex::Pixels::PixelFormat;
+
+    const Nuclex::Pixels::BitmapMemory &source = original.Access();
+    const Nuclex::Pixels::BitmapMemory &blocks = compressed.Access();
+    std::size_t blockByteCount = Nuclex::Pixels::CountBytesPerBlock(blocks.PixelFormat);
+
+    int largestError = 0;
+    for(std::size_t blockY = 0; blockY < (source.Height + 3) / 4; ++blockY) {
+      for(std::size_t blockX = 0; blockX < (source.Width + 3) / 4; ++blockX) {
+        const std::uint8_t *block = static_cast<const std::uint8_t *>(blocks.Pixels) + (
+          blockY * 4 * blocks.Stride + blockX * blockByteCount
+        );
+
+        std::uint8_t pixels[64] = {};
+        switch(blocks.PixelFormat) {
+          case PixelFormat::BC1_Compressed: { decodeBc1Block(block, pixels); break; }
+          case PixelFormat::BC3_Compressed: {
+            decodeBc1Block(block + 8, pixels);
+            decodeBc4Block(block, pixels, 3);
+            break;
+          }
+          case PixelFormat::BC4_Compressed: { decodeBc4Block(block, pixels, 0); break; }
+          case PixelFormat::BC5_Compressed: {
+            decodeBc4Block(block, pixels, 0);
+            decodeBc4Block(block + 8, pixels, 1);
+            break;
+          }
+          case PixelFormat::BC7_Compressed: { decodeBc7Mode6Block(block, pixels); break; }
+          default: { return 256; }
+        }
+
+        for(std::size_t y = 0; y < 4; ++y) {
+          for(std::size_t x = 0; x < 4; ++x) {
+            if((blockX * 4 + x >= source.Width) || (blockY * 4 + y >= source.Height)) {
+              continue;
+            }
+            const std::uint8_t *pixel = static_cast<const std::uint8_t *>(source.Pixels) + (
+              (blockY * 4 + y) * source.Stride + (blockX * 4 + x) * 4
+            );
+            for(std::size_t channel = 0; channel < channelCount; ++channel) {
+              int error = std::abs(pixel[channel] - pixels[(y * 4 + x) * 4 + channel]);
+              if(error > largestError) {
+                largestError = error;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    return largestError;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, BlockCompressedFormatsCanBeChecked) {
+    EXPECT_TRUE(BlockCompressor::CanCompress(PixelFormat::BC1_Compressed));
+    EXPECT_TRUE(BlockCompressor::CanCompress(PixelFormat::BC3_Compressed));
+    EXPECT_TRUE(BlockCompressor::CanCompress(PixelFormat::BC4_Compressed));
+    EXPECT_TRUE(BlockCompressor::CanCompress(PixelFormat::BC5_Compressed));
+    EXPECT_TRUE(BlockCompressor::CanCompress(PixelFormat::BC7_Compressed));
+    EXPECT_FALSE(BlockCompressor::CanCompress(PixelFormat::R8_G8_B8_A8_Unsigned));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, BitmapsCanHoldCompressedBlocks) {
+    Bitmap compressed(6, 5, PixelFormat::BC1_Compressed);
+    EXPECT_EQ(6U, compressed.GetWidth());
+    EXPECT_EQ(5U, compressed.GetHeight());
+
+    // Two blocks of 8 bytes per row of blocks, spread over four rows of pixels
+    EXPECT_EQ(4, compressed.Access().Stride);
+
+    Size blockSize = GetBlockSize(PixelFormat::BC7_Compressed);
+    EXPECT_EQ(4U, blockSize.Width);
+    EXPECT_EQ(4U, blockSize.Height);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, Bc1KeepsColorsClose) {
+    Bitmap original(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithGradients(original);
+    Bitmap compressed(16, 16, PixelFormat::BC1_Compressed);
+
+    // Opaque pixels only, so the gradient in the alpha channel has to go
+    const BitmapMemory &memory = original.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        row[x * 4 + 3] = 255;
+      }
+    }
+
+    BlockCompressor::Compress(original.Access(), compressed.Access());
+    EXPECT_LE(findLargestError(original, compressed, 4), 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, Bc1MakesLowAlphaPixelsTransparent) {
+    Bitmap original(4, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithGradients(original);
+    const BitmapMemory &memory = original.Access();
+    for(std::size_t y = 0; y < 4; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      for(std::size_t x = 0; x < 4; ++x) {
+        row[x * 4 + 3] = (x < 2) ? 0 : 255;
+      }
+    }
+
+    Bitmap compressed(4, 4, PixelFormat::BC1_Compressed);
+    BlockCompressor::Compress(original.Access(), compressed.Access());
+
+    std::uint8_t pixels[64];
+    decodeBc1Block(static_cast<const std::uint8_t *>(compressed.Access().Pixels), pixels);
+    for(std::size_t index = 0; index < 16; ++index) {
+      EXPECT_EQ((index % 4 < 2) ? 0 : 255, pixels[index * 4 + 3]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, Bc3KeepsAlphaClose) {
+    Bitmap original(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithGradients(original);
+    Bitmap compressed(16, 16, PixelFormat::BC3_Compressed);
+
+    BlockCompressor::Compress(original.Access(), compressed.Access());
+    EXPECT_LE(findLargestError(original, compressed, 4), 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, Bc4AndBc5KeepChannelsClose) {
+    Bitmap original(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithGradients(original);
+
+    Bitmap bc4(16, 16, PixelFormat::BC4_Compressed);
+    BlockCompressor::Compress(original.Access(), bc4.Access());
+    EXPECT_LE(findLargestError(original, bc4, 1), 1);
+
+    Bitmap bc5(16, 16, PixelFormat::BC5_Compressed);
+    BlockCompressor::Compress(original.Access(), bc5.Access());
+    EXPECT_LE(findLargestError(original, bc5, 2), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, Bc7KeepsAllChannelsClose) {
+    Bitmap original(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithGradients(original);
+    Bitmap compressed(16, 16, PixelFormat::BC7_Compressed);
+
+    // The gradients form a plane, mode 6 can only place the colors on a line through it
+    BlockCompressor::Compress(original.Access(), compressed.Access());
+    EXPECT_LE(findLargestError(original, compressed, 4), 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, PartialBlocksAreCompressed) {
+    Bitmap original(7, 5, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithGradients(original);
+    Bitmap compressed(7, 5, PixelFormat::BC7_Compressed);
+
+    BlockCompressor::Compress(original.Access(), compressed.Access());
+    EXPECT_LE(findLargestError(original, compressed, 4), 8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, ParallelCompressionMatchesSingleThreaded) {
+    Bitmap original(64, 48, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithGradients(original);
+    Bitmap single(64, 48, PixelFormat::BC3_Compressed);
+    Bitmap parallel(64, 48, PixelFormat::BC3_Compressed);
+
+    ThreadPool threadPool(4);
+    BlockCompressor::Compress(original.Access(), single.Access());
+    BlockCompressor::Compress(original.Access(), parallel.Access(), threadPool);
+
+    std::size_t byteCount = single.Access().Stride * single.GetHeight();
+    EXPECT_EQ(0, std::memcmp(single.Access().Pixels, parallel.Access().Pixels, byteCount));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressorTest, MismatchedBitmapsCauseException) {
+    Bitmap original(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap smaller(4, 8, PixelFormat::BC1_Compressed);
+    Bitmap uncompressed(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap wrongSource(8, 8, PixelFormat::B8_G8_R8_A8_Unsigned);
+    Bitmap compressed(8, 8, PixelFormat::BC1_Compressed);
+
+    EXPECT_THROW(
+      BlockCompressor::Compress(original.Access(), smaller.Access()), std::runtime_error
+    );
+    EXPECT_THROW(
+      BlockCompressor::Compress(original.Access(), uncompressed.Access()), std::runtime_error
+    );
+    EXPECT_THROW(
+      BlockCompressor::Compress(wrongSource.Access(), compressed.Access()), std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
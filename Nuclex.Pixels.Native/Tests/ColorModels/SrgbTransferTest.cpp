@@ -0,0 +1,223 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/ColorModels/SrgbTransfer.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Half.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills an R8-G8-B8-A8 bitmap with all possible byte values</summary>
+  /// <param name="bitmap">Bitmap of 256 pixels width that will be filled</param>
+  void fillWithAllBytes(const Nuclex::Pixels::Bitmap &bitmap) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        row[x * 4 + 0] = static_cast<std::uint8_t>(x);
+        row[x * 4 + 1] = static_cast<std::uint8_t>(x + y);
+        row[x * 4 + 2] = static_cast<std::uint8_t>(255 - x);
+        row[x * 4 + 3] = static_cast<std::uint8_t>(x * 7);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace ColorModels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SrgbTransferTest, ExactTransferFunctionsAreInverse) {
+    EXPECT_FLOAT_EQ(SrgbTransfer::ToLinear(0.0f), 0.0f);
+    EXPECT_FLOAT_EQ(SrgbTransfer::ToLinear(1.0f), 1.0f);
+    EXPECT_NEAR(SrgbTransfer::ToLinear(0.5f), 0.214041f, 0.000001f);
+    EXPECT_NEAR(SrgbTransfer::ToSrgb(0.5f), 0.735357f, 0.000001f);
+
+    for(std::size_t index = 0; index <= 100; ++index) {
+      float value = static_cast<float>(index) / 100.0f;
+      EXPECT_NEAR(SrgbTransfer::ToSrgb(SrgbTransfer::ToLinear(value)), value, 0.000001f);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SrgbTransferTest, RowConversionStaysCloseToExactFunctions) {
+    const std::size_t pixelCount = 1001;
+    std::vector<float> toLinear(pixelCount * 4), toSrgb(pixelCount * 4);
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      float value = static_cast<float>(index) / static_cast<float>(pixelCount - 1);
+      for(std::size_t channel = 0; channel < 3; ++channel) {
+        toLinear[index * 4 + channel] = value;
+        toSrgb[index * 4 + channel] = value;
+      }
+      toLinear[index * 4 + 3] = value;
+      toSrgb[index * 4 + 3] = value;
+    }
+
+    SrgbTransfer::ToLinearRow(toLinear.data(), pixelCount);
+    SrgbTransfer::ToSrgbRow(toSrgb.data(), pixelCount);
+
+    for(std::size_t index = 0; index < pixelCount; ++index) {
+      float value = static_cast<float>(index) / static_cast<float>(pixelCount - 1);
+      for(std::size_t channel = 0; channel < 3; ++channel) {
+        EXPECT_NEAR(toLinear[index * 4 + channel], SrgbTransfer::ToLinear(value), 0.00001f);
+        EXPECT_NEAR(toSrgb[index * 4 + channel], SrgbTransfer::ToSrgb(value), 0.00001f);
+      }
+      EXPECT_EQ(toLinear[index * 4 + 3], value); // alpha must not change
+      EXPECT_EQ(toSrgb[index * 4 + 3], value);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SrgbTransferTest, ValuesOutsideOfValidRangeAreClamped) {
+    float rgba[8] = { -1.0f, 2.0f, 0.5f, 3.0f, -0.5f, 1.5f, 0.0f, -2.0f };
+
+    SrgbTransfer::ToLinearRow(rgba, 2);
+
+    EXPECT_EQ(rgba[0], 0.0f);
+    EXPECT_NEAR(rgba[1], 1.0f, 0.00001f);
+    EXPECT_EQ(rgba[3], 3.0f);
+    EXPECT_EQ(rgba[4], 0.0f);
+    EXPECT_NEAR(rgba[5], 1.0f, 0.00001f);
+    EXPECT_EQ(rgba[7], -2.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SrgbTransferTest, SrgbBytesSurviveRoundTripThroughLinearFloats) {
+    Bitmap srgb(256, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithAllBytes(srgb);
+    Bitmap linear(256, 4, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    Bitmap encoded(256, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    SrgbTransfer::ToLinear(srgb.Access(), linear.Access());
+    SrgbTransfer::ToSrgb(linear.Access(), encoded.Access());
+
+    const BitmapMemory &srgbMemory = srgb.Access();
+    const BitmapMemory &linearMemory = linear.Access();
+    const BitmapMemory &encodedMemory = encoded.Access();
+    for(std::size_t y = 0; y < 4; ++y) {
+      const std::uint8_t *srgbRow = (
+        static_cast<const std::uint8_t *>(srgbMemory.Pixels) + y * srgbMemory.Stride
+      );
+      const float *linearRow = reinterpret_cast<const float *>(
+        static_cast<const std::uint8_t *>(linearMemory.Pixels) + y * linearMemory.Stride
+      );
+      const std::uint8_t *encodedRow = (
+        static_cast<const std::uint8_t *>(encodedMemory.Pixels) + y * encodedMemory.Stride
+      );
+      for(std::size_t x = 0; x < 256 * 4; ++x) {
+        if((x % 4) == 3) {
+          EXPECT_FLOAT_EQ(linearRow[x], static_cast<float>(srgbRow[x]) / 255.0f);
+        } else {
+          EXPECT_FLOAT_EQ(
+            linearRow[x], SrgbTransfer::ToLinear(static_cast<float>(srgbRow[x]) / 255.0f)
+          );
+        }
+        ASSERT_EQ(encodedRow[x], srgbRow[x]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SrgbTransferTest, HalfPrecisionBitmapsCanBeConverted) {
+    Bitmap srgb(256, 1, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithAllBytes(srgb);
+    Bitmap linear(256, 1, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    Bitmap encoded(256, 1, PixelFormat::R16_G16_B16_A16_Float_Native16);
+
+    SrgbTransfer::ToLinear(srgb.Access(), linear.Access());
+    SrgbTransfer::ToSrgb(linear.Access(), encoded.Access());
+
+    const std::uint8_t *srgbPixels = static_cast<const std::uint8_t *>(srgb.Access().Pixels);
+    const std::uint16_t *linearPixels = static_cast<const std::uint16_t *>(
+      linear.Access().Pixels
+    );
+    const std::uint16_t *encodedPixels = static_cast<const std::uint16_t *>(
+      encoded.Access().Pixels
+    );
+    for(std::size_t x = 0; x < 256; ++x) {
+      for(std::size_t channel = 0; channel < 3; ++channel) {
+        float value = static_cast<float>(srgbPixels[x * 4 + channel]) / 255.0f;
+        float expected = SrgbTransfer::ToLinear(value);
+        EXPECT_NEAR(
+          Half::FloatFromBits(linearPixels[x * 4 + channel]), expected, expected / 512.0f
+        );
+        EXPECT_NEAR(Half::FloatFromBits(encodedPixels[x * 4 + channel]), value, 0.002f);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SrgbTransferTest, ParallelConversionMatchesSingleThreaded) {
+    ThreadPool threadPool(4);
+
+    Bitmap srgb(256, 300, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillWithAllBytes(srgb);
+    Bitmap linear(256, 300, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    SrgbTransfer::ToLinear(srgb.Access(), linear.Access());
+
+    Bitmap encoded(256, 300, PixelFormat::B8_G8_R8_Unsigned);
+    Bitmap parallelEncoded(256, 300, PixelFormat::B8_G8_R8_Unsigned);
+    SrgbTransfer::ToSrgb(linear.Access(), encoded.Access());
+    SrgbTransfer::ToSrgb(linear.Access(), parallelEncoded.Access(), threadPool);
+
+    const BitmapMemory &memory = encoded.Access();
+    const BitmapMemory &parallelMemory = parallelEncoded.Access();
+    for(std::size_t y = 0; y < 300; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Pixels) + y * memory.Stride
+      );
+      const std::uint8_t *parallelRow = (
+        static_cast<const std::uint8_t *>(parallelMemory.Pixels) + y * parallelMemory.Stride
+      );
+      for(std::size_t x = 0; x < 256 * 3; ++x) {
+        ASSERT_EQ(parallelRow[x], row[x]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SrgbTransferTest, MismatchedDimensionsThrowException) {
+    Bitmap srgb(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap linear(16, 8, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    EXPECT_THROW(SrgbTransfer::ToLinear(srgb.Access(), linear.Access()), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::ColorModels
@@ -0,0 +1,281 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/ColorModels/ToneMapper.h"
+#include "Nuclex/Pixels/ColorModels/SrgbTransfer.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Half.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <cmath> // for std::exp2()
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a half precision RGBA bitmap with a single color</summary>
+  /// <param name="bitmap">Bitmap that will be filled</param>
+  /// <param name="color">Linear color value the color channels will be set to</param>
+  /// <param name="alpha">Value the alpha channel will be set to</param>
+  void fillHalfBitmap(const Nuclex::Pixels::Bitmap &bitmap, float color, float alpha) {
+    using Nuclex::Pixels::Half;
+
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      std::uint16_t *row = reinterpret_cast<std::uint16_t *>(
+        static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride
+      );
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        row[x * 4 + 0] = Half::BitsFromFloat(color);
+        row[x * 4 + 1] = Half::BitsFromFloat(color);
+        row[x * 4 + 2] = Half::BitsFromFloat(color);
+        row[x * 4 + 3] = Half::BitsFromFloat(alpha);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the average of one channel in an 8 bit RGBA bitmap</summary>
+  /// <param name="bitmap">Bitmap whose channel will be averaged</param>
+  /// <param name="channel">Index of the channel that will be averaged</param>
+  /// <returns>The average value of the channel</returns>
+  double averageChannel(const Nuclex::Pixels::Bitmap &bitmap, std::size_t channel) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    double sum = 0.0;
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(memory.Pixels) + (
+        y * memory.Stride
+      );
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        sum += row[x * 4 + channel];
+      }
+    }
+    return sum / static_cast<double>(memory.Width * memory.Height);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace ColorModels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ToneMapperTest, OperatorsCompressColorsIntoDisplayableRange) {
+    EXPECT_FLOAT_EQ(ToneMapper::Apply(0.5f, ToneMappingOperator::Clamp), 0.5f);
+    EXPECT_FLOAT_EQ(ToneMapper::Apply(4.0f, ToneMappingOperator::Clamp), 1.0f);
+    EXPECT_FLOAT_EQ(ToneMapper::Apply(1.0f, ToneMappingOperator::Reinhard), 0.5f);
+    EXPECT_FLOAT_EQ(ToneMapper::Apply(3.0f, ToneMappingOperator::Reinhard), 0.75f);
+    EXPECT_FLOAT_EQ(ToneMapper::Apply(0.0f, ToneMappingOperator::AcesFit), 0.0f);
+    EXPECT_NEAR(ToneMapper::Apply(1.0f, ToneMappingOperator::AcesFit), 0.8038f, 0.0001f);
+    EXPECT_FLOAT_EQ(ToneMapper::Apply(100.0f, ToneMappingOperator::AcesFit), 1.0f);
+
+    EXPECT_FLOAT_EQ(ToneMapper::Apply(-1.0f, ToneMappingOperator::Reinhard), 0.0f);
+    EXPECT_FLOAT_EQ(ToneMapper::Apply(-1.0f, ToneMappingOperator::AcesFit), 0.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ToneMapperTest, HalfPrecisionBitmapsAreToneMappedToSrgbBytes) {
+    const ToneMappingOperator operators[] = {
+      ToneMappingOperator::Clamp, ToneMappingOperator::Reinhard, ToneMappingOperator::AcesFit
+    };
+
+    Bitmap hdr(300, 1, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    {
+      std::uint16_t *pixels = static_cast<std::uint16_t *>(hdr.Access().Pixels);
+      for(std::size_t x = 0; x < 300; ++x) {
+        pixels[x * 4 + 0] = Half::BitsFromFloat(static_cast<float>(x) / 50.0f);
+        pixels[x * 4 + 1] = Half::BitsFromFloat(static_cast<float>(x) / 300.0f);
+        pixels[x * 4 + 2] = Half::BitsFromFloat(static_cast<float>(299 - x) / 25.0f);
+        pixels[x * 4 + 3] = Half::BitsFromFloat(static_cast<float>(x) / 299.0f);
+      }
+    }
+
+    for(ToneMappingOperator mappingOperator : operators) {
+      ToneMappingOptions options;
+      options.Operator = mappingOperator;
+      options.Exposure = -0.5f;
+      options.Dithering = DitheringMethod::None;
+
+      Bitmap preview(300, 1, PixelFormat::R8_G8_B8_A8_Unsigned);
+      ToneMapper::ToneMap(hdr.Access(), preview.Access(), options);
+
+      const std::uint16_t *hdrPixels = static_cast<const std::uint16_t *>(hdr.Access().Pixels);
+      const std::uint8_t *previewPixels = static_cast<const std::uint8_t *>(
+        preview.Access().Pixels
+      );
+      for(std::size_t x = 0; x < 300; ++x) {
+        for(std::size_t channel = 0; channel < 3; ++channel) {
+          float linear = Half::FloatFromBits(hdrPixels[x * 4 + channel]) * std::exp2(-0.5f);
+          float expected = SrgbTransfer::ToSrgb(ToneMapper::Apply(linear, mappingOperator));
+          EXPECT_NEAR(previewPixels[x * 4 + channel], expected * 255.0f, 0.51f);
+        }
+        float alpha = Half::FloatFromBits(hdrPixels[x * 4 + 3]);
+        EXPECT_NEAR(previewPixels[x * 4 + 3], alpha * 255.0f, 0.51f);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ToneMapperTest, ExposureIsAppliedInStops) {
+    Bitmap dark(4, 4, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    fillHalfBitmap(dark, 0.125f, 1.0f);
+    Bitmap bright(4, 4, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    fillHalfBitmap(bright, 0.5f, 1.0f);
+
+    ToneMappingOptions options;
+    options.Operator = ToneMappingOperator::Clamp;
+    options.Dithering = DitheringMethod::None;
+
+    Bitmap reference(4, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+    ToneMapper::ToneMap(bright.Access(), reference.Access(), options);
+
+    options.Exposure = 2.0f;
+    Bitmap exposed(4, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+    ToneMapper::ToneMap(dark.Access(), exposed.Access(), options);
+
+    EXPECT_EQ(averageChannel(exposed, 0), averageChannel(reference, 0));
+    EXPECT_EQ(averageChannel(exposed, 3), 255.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ToneMapperTest, DitheringPreservesAverageBrightness) {
+    const DitheringMethod methods[] = { DitheringMethod::Ordered, DitheringMethod::BlueNoise };
+
+    // A linear value whose sRGB encoding lies between two byte values
+    float srgb = 100.3f / 255.0f;
+    float linear = SrgbTransfer::ToLinear(srgb);
+
+    Bitmap hdr(64, 64, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    {
+      const BitmapMemory &memory = hdr.Access();
+      for(std::size_t y = 0; y < 64; ++y) {
+        float *row = reinterpret_cast<float *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride
+        );
+        for(std::size_t x = 0; x < 64; ++x) {
+          row[x * 4 + 0] = row[x * 4 + 1] = row[x * 4 + 2] = linear;
+          row[x * 4 + 3] = 0.5f;
+        }
+      }
+    }
+
+    for(DitheringMethod method : methods) {
+      ToneMappingOptions options;
+      options.Operator = ToneMappingOperator::Clamp;
+      options.Dithering = method;
+
+      Bitmap preview(64, 64, PixelFormat::R8_G8_B8_A8_Unsigned);
+      ToneMapper::ToneMap(hdr.Access(), preview.Access(), options);
+
+      EXPECT_NEAR(averageChannel(preview, 0), 100.3, 0.02);
+      EXPECT_NEAR(averageChannel(preview, 2), 100.3, 0.02);
+      EXPECT_EQ(averageChannel(preview, 3), 128.0); // alpha is not dithered
+
+      const std::uint8_t *pixels = static_cast<const std::uint8_t *>(preview.Access().Pixels);
+      for(std::size_t x = 0; x < 64; ++x) {
+        EXPECT_TRUE((pixels[x * 4] == 100) || (pixels[x * 4] == 101));
+      }
+    }
+
+    ToneMappingOptions options;
+    options.Operator = ToneMappingOperator::Clamp;
+    options.Dithering = DitheringMethod::None;
+
+    Bitmap rounded(64, 64, PixelFormat::R8_G8_B8_A8_Unsigned);
+    ToneMapper::ToneMap(hdr.Access(), rounded.Access(), options);
+    EXPECT_EQ(averageChannel(rounded, 0), 100.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ToneMapperTest, ParallelToneMappingMatchesSingleThreaded) {
+    ThreadPool threadPool(4);
+
+    Bitmap hdr(200, 500, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    {
+      const BitmapMemory &memory = hdr.Access();
+      for(std::size_t y = 0; y < 500; ++y) {
+        std::uint16_t *row = reinterpret_cast<std::uint16_t *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride
+        );
+        for(std::size_t x = 0; x < 200 * 4; ++x) {
+          row[x] = Half::BitsFromFloat(static_cast<float>((x * 7 + y * 3) % 97) / 24.0f);
+        }
+      }
+    }
+
+    ToneMappingOptions options;
+    options.Dithering = DitheringMethod::BlueNoise;
+
+    Bitmap preview(200, 500, PixelFormat::B8_G8_R8_Unsigned);
+    Bitmap parallelPreview(200, 500, PixelFormat::B8_G8_R8_Unsigned);
+    ToneMapper::ToneMap(hdr.Access(), preview.Access(), options);
+    ToneMapper::ToneMap(hdr.Access(), parallelPreview.Access(), options, threadPool);
+
+    const BitmapMemory &memory = preview.Access();
+    const BitmapMemory &parallelMemory = parallelPreview.Access();
+    for(std::size_t y = 0; y < 500; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Pixels) + y * memory.Stride
+      );
+      const std::uint8_t *parallelRow = (
+        static_cast<const std::uint8_t *>(parallelMemory.Pixels) + y * parallelMemory.Stride
+      );
+      for(std::size_t x = 0; x < 200 * 3; ++x) {
+        ASSERT_EQ(parallelRow[x], row[x]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ToneMapperTest, UnsupportedTargetsThrowException) {
+    EXPECT_TRUE(
+      ToneMapper::CanToneMap(
+        PixelFormat::R16_G16_B16_A16_Float_Native16, PixelFormat::R8_G8_B8_A8_Unsigned
+      )
+    );
+    EXPECT_FALSE(
+      ToneMapper::CanToneMap(
+        PixelFormat::R16_G16_B16_A16_Float_Native16, PixelFormat::R16_G16_B16_A16_Float_Native16
+      )
+    );
+
+    Bitmap hdr(16, 16, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    Bitmap wrongFormat(16, 16, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    EXPECT_THROW(ToneMapper::ToneMap(hdr.Access(), wrongFormat.Access()), std::runtime_error);
+    Bitmap wrongSize(16, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_THROW(ToneMapper::ToneMap(hdr.Access(), wrongSize.Access()), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::ColorModels
@@ -0,0 +1,156 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/DirtyRegionTracker.h"
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, HasDefaultConstructor) {
+    EXPECT_NO_THROW(
+      DirtyRegionTracker tracker(640, 480);
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, TileSizeOfZeroIsRejected) {
+    EXPECT_THROW(
+      DirtyRegionTracker tracker(640, 480, 0),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, PartialTilesAreCounted) {
+    DirtyRegionTracker tracker(100, 64, 32);
+    EXPECT_EQ(tracker.CountHorizontalTiles(), 4U);
+    EXPECT_EQ(tracker.CountVerticalTiles(), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, TrackerStartsClean) {
+    DirtyRegionTracker tracker(256, 256, 32);
+    EXPECT_FALSE(tracker.IsAnyDirty());
+    EXPECT_EQ(tracker.CountDirtyTiles(), 0U);
+    EXPECT_TRUE(tracker.GetDirtyRegions().empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, MarkingRegionDirtiesOverlappedTiles) {
+    DirtyRegionTracker tracker(256, 256, 32);
+    tracker.MarkDirty(Rectangle(40, 20, 70, 33));
+
+    EXPECT_TRUE(tracker.IsAnyDirty());
+    EXPECT_EQ(tracker.CountDirtyTiles(), 4U);
+    EXPECT_TRUE(tracker.IsTileDirty(1, 0));
+    EXPECT_TRUE(tracker.IsTileDirty(2, 0));
+    EXPECT_TRUE(tracker.IsTileDirty(1, 1));
+    EXPECT_TRUE(tracker.IsTileDirty(2, 1));
+    EXPECT_FALSE(tracker.IsTileDirty(0, 0));
+    EXPECT_FALSE(tracker.IsTileDirty(3, 1));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, EmptyRegionsDirtyNothing) {
+    DirtyRegionTracker tracker(256, 256, 32);
+    tracker.MarkDirty(Rectangle(40, 20, 40, 80));
+    tracker.MarkDirty(Rectangle(300, 300, 400, 400));
+    EXPECT_FALSE(tracker.IsAnyDirty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, AdjacentTilesAreMergedIntoOneRegion) {
+    DirtyRegionTracker tracker(256, 256, 32);
+    tracker.MarkDirty(Rectangle(40, 20, 70, 33));
+
+    std::vector<Rectangle> regions = tracker.GetDirtyRegions();
+    ASSERT_EQ(regions.size(), 1U);
+    EXPECT_EQ(regions[0].MinX, 32U);
+    EXPECT_EQ(regions[0].MinY, 0U);
+    EXPECT_EQ(regions[0].MaxX, 96U);
+    EXPECT_EQ(regions[0].MaxY, 64U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, SeparateChangesResultInSeparateRegions) {
+    DirtyRegionTracker tracker(256, 256, 32);
+    tracker.MarkDirty(Rectangle(200, 200, 210, 210));
+    tracker.MarkDirty(Rectangle(0, 0, 10, 10));
+
+    std::vector<Rectangle> regions = tracker.GetDirtyRegions();
+    ASSERT_EQ(regions.size(), 2U);
+    EXPECT_EQ(regions[0].MinX, 0U);
+    EXPECT_EQ(regions[0].MinY, 0U);
+    EXPECT_EQ(regions[1].MinX, 192U);
+    EXPECT_EQ(regions[1].MinY, 192U);
+    EXPECT_EQ(regions[1].MaxX, 224U);
+    EXPECT_EQ(regions[1].MaxY, 224U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, RegionsAreClippedToBitmap) {
+    DirtyRegionTracker tracker(100, 50, 32);
+    tracker.MarkDirty(Rectangle(90, 40, 500, 500));
+
+    std::vector<Rectangle> regions = tracker.GetDirtyRegions();
+    ASSERT_EQ(regions.size(), 1U);
+    EXPECT_EQ(regions[0].MinX, 64U);
+    EXPECT_EQ(regions[0].MinY, 32U);
+    EXPECT_EQ(regions[0].MaxX, 100U);
+    EXPECT_EQ(regions[0].MaxY, 50U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DirtyRegionTrackerTest, WholeBitmapCanBeMarkedAndCleared) {
+    DirtyRegionTracker tracker(1000, 300, 16);
+    tracker.MarkAllDirty();
+    EXPECT_EQ(tracker.CountDirtyTiles(), 63U * 19U);
+
+    std::vector<Rectangle> regions = tracker.GetDirtyRegions();
+    ASSERT_EQ(regions.size(), 1U);
+    EXPECT_EQ(regions[0].MinX, 0U);
+    EXPECT_EQ(regions[0].MinY, 0U);
+    EXPECT_EQ(regions[0].MaxX, 1000U);
+    EXPECT_EQ(regions[0].MaxY, 300U);
+
+    tracker.Clear();
+    EXPECT_FALSE(tracker.IsAnyDirty());
+    EXPECT_EQ(tracker.CountDirtyTiles(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
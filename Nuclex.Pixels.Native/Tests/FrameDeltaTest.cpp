@@ -0,0 +1,157 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/FrameDelta.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/BitmapBlitter.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Changes a single byte of a pixel in an R8-G8-B8-A8 bitmap</summary>
+  /// <param name="bitmap">Bitmap in which the pixel will be changed</param>
+  /// <param name="x">X coordinate of the pixel that will be changed</param>
+  /// <param name="y">Y coordinate of the pixel that will be changed</param>
+  void changePixel(const Nuclex::Pixels::Bitmap &bitmap, std::size_t x, std::size_t y) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + (y * memory.Stride);
+    row[x * 4 + 1] ^= 0x5A;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FrameDeltaTest, IdenticalFramesHaveNoChangedTiles) {
+    Bitmap previous(200, 100, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(previous);
+    Bitmap current(previous);
+
+    DirtyRegionTracker changedTiles(200, 100, 32);
+    EXPECT_EQ(FrameDelta::FindChangedTiles(previous.Access(), current.Access(), changedTiles), 0U);
+    EXPECT_FALSE(changedTiles.IsAnyDirty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FrameDeltaTest, ChangedPixelsMarkTheirTiles) {
+    Bitmap previous(200, 100, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(previous);
+    Bitmap current(previous);
+    changePixel(current, 5, 5);
+    changePixel(current, 199, 99);
+    changePixel(current, 40, 70);
+
+    DirtyRegionTracker changedTiles(200, 100, 32);
+    EXPECT_EQ(FrameDelta::FindChangedTiles(previous.Access(), current.Access(), changedTiles), 3U);
+    EXPECT_EQ(changedTiles.CountDirtyTiles(), 3U);
+    EXPECT_TRUE(changedTiles.IsTileDirty(0, 0));
+    EXPECT_TRUE(changedTiles.IsTileDirty(6, 3));
+    EXPECT_TRUE(changedTiles.IsTileDirty(1, 2));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FrameDeltaTest, DeltaTurnsPreviousFrameIntoCurrentFrame) {
+    Bitmap previous(200, 100, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(previous);
+    Bitmap current(previous);
+    changePixel(current, 5, 5);
+    changePixel(current, 199, 99);
+    changePixel(current, 150, 10);
+
+    std::vector<std::uint8_t> delta = FrameDelta::Encode(previous.Access(), current.Access(), 32);
+
+    // Three tiles, one of them clipped by the frame's right and bottom borders
+    std::size_t expectedByteCount = 16 + (4 * 3) + (32 * 32 * 4) * 2 + (8 * 4 * 4);
+    EXPECT_EQ(delta.size(), expectedByteCount);
+
+    Bitmap received(previous);
+    EXPECT_FALSE(BitmapBlitter::AreEqual(received.Access(), current.Access()));
+    FrameDelta::Apply(received.Access(), delta.data(), delta.size());
+    EXPECT_TRUE(BitmapBlitter::AreEqual(received.Access(), current.Access()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FrameDeltaTest, UnchangedPixelsBecomeZeroBytes) {
+    Bitmap previous(64, 64, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(previous);
+    Bitmap current(previous);
+    changePixel(current, 10, 10);
+
+    std::vector<std::uint8_t> delta = FrameDelta::Encode(previous.Access(), current.Access());
+
+    std::size_t nonZeroByteCount = 0;
+    for(std::size_t index = 20; index < delta.size(); ++index) {
+      if(delta[index] != 0) {
+        ++nonZeroByteCount;
+      }
+    }
+    EXPECT_EQ(nonZeroByteCount, 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FrameDeltaTest, FramesOfDifferentSizeCannotBeCompared) {
+    Bitmap previous(64, 64, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap current(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_THROW(
+      FrameDelta::Encode(previous.Access(), current.Access()),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FrameDeltaTest, TruncatedDeltaIsRejected) {
+    Bitmap previous(64, 64, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(previous);
+    Bitmap current(previous);
+    changePixel(current, 10, 10);
+
+    std::vector<std::uint8_t> delta = FrameDelta::Encode(previous.Access(), current.Access());
+    EXPECT_THROW(
+      FrameDelta::Apply(previous.Access(), delta.data(), delta.size() - 1),
+      std::invalid_argument
+    );
+    EXPECT_THROW(
+      FrameDelta::Apply(current.GetView(0, 0, 32, 32).Access(), delta.data(), delta.size()),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
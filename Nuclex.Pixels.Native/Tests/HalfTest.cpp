@@ -24,6 +24,9 @@ License along with this library
 #include "Nuclex/Pixels/Half.h"
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <vector>
+
 namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
@@ -66,4 +69,105 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(HalfTest, NormalizedByteLookupMatchesFloatConversion) {
+    for(std::size_t value = 0; value < 256; ++value) {
+      Half expected(static_cast<float>(value) / 255.0f);
+      Half actual = Half::FromNormalizedByte(static_cast<std::uint8_t>(value));
+
+      EXPECT_EQ(expected.GetBits(), actual.GetBits());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HalfTest, NormalizedByteRoundingMatchesFloatConversion) {
+    for(std::size_t bits = 0; bits < 65536; ++bits) {
+      Half half = Half::FromBits(static_cast<std::uint16_t>(bits));
+      float value = static_cast<float>(half);
+      if(value != value) {
+        continue; // NaNs
+      }
+
+      std::uint8_t expected;
+      if(value <= 0.0f) {
+        expected = 0;
+      } else if(value >= 1.0f) {
+        expected = 255;
+      } else {
+        expected = static_cast<std::uint8_t>(value * 255.0f) + 1;
+      }
+
+      EXPECT_EQ(expected, half.ToNormalizedByte());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HalfTest, NormalizedBytesCanBeConvertedInBulk) {
+    std::uint8_t bytes[256];
+    for(std::size_t index = 0; index < 256; ++index) {
+      bytes[index] = static_cast<std::uint8_t>(index);
+    }
+
+    Half halfs[256];
+    Half::ConvertFromNormalizedBytes(bytes, halfs, 256);
+
+    std::uint8_t roundTripped[256];
+    Half::ConvertToNormalizedBytes(halfs, roundTripped, 256);
+
+    for(std::size_t index = 0; index < 256; ++index) {
+      EXPECT_EQ(Half::FromNormalizedByte(bytes[index]).GetBits(), halfs[index].GetBits());
+      EXPECT_EQ(halfs[index].ToNormalizedByte(), roundTripped[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HalfTest, BulkConversionFromFloatsMatchesScalarConversion) {
+    std::vector<float> values;
+    values.push_back(0.0f);
+    values.push_back(-0.0f);
+    values.push_back(1.0f);
+    values.push_back(-2.5f);
+    values.push_back(65504.0f); // largest half
+    values.push_back(65505.0f); // too large, becomes infinity
+    values.push_back(-1.0e30f);
+    values.push_back(6.0e-5f); // subnormal half
+    values.push_back(-3.0e-8f); // smallest subnormal half
+    values.push_back(1.0e-10f); // too small, becomes zero
+    values.push_back(std::numeric_limits<float>::infinity());
+    for(std::size_t index = 0; index < 1000; ++index) {
+      values.push_back(static_cast<float>(index) * 0.37f - 100.0f);
+    }
+
+    std::vector<Half> halfs(values.size());
+    Half::ConvertFromFloats(values.data(), halfs.data(), values.size());
+
+    for(std::size_t index = 0; index < values.size(); ++index) {
+      EXPECT_EQ(Half::BitsFromFloat(values[index]), halfs[index].GetBits());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(HalfTest, BulkConversionToFloatsMatchesScalarConversion) {
+    std::vector<Half> halfs;
+    for(std::size_t bits = 0; bits < 65536; ++bits) {
+      bool isNaN = ((bits & 0x7C00) == 0x7C00) && ((bits & 0x03FF) != 0);
+      if(!isNaN) {
+        halfs.push_back(Half::FromBits(static_cast<std::uint16_t>(bits)));
+      }
+    }
+
+    std::vector<float> values(halfs.size() + 1);
+    Half::ConvertToFloats(halfs.data(), values.data(), halfs.size());
+
+    for(std::size_t index = 0; index < halfs.size(); ++index) {
+      float expected = Half::FloatFromBits(halfs[index].GetBits());
+      EXPECT_EQ(0, std::memcmp(&expected, &values[index], sizeof(float)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Pixels
@@ -0,0 +1,171 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/MipmapChain.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Half.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, LevelsOfFullChainCanBeCounted) {
+    EXPECT_EQ(1U, MipmapChain::CountLevels(1, 1));
+    EXPECT_EQ(9U, MipmapChain::CountLevels(256, 64));
+    EXPECT_EQ(3U, MipmapChain::CountLevels(5, 3));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, EachLevelIsHalfTheSizeOfThePreviousOne) {
+    Bitmap bitmap(37, 20, PixelFormat::R8_G8_B8_A8_Unsigned);
+    MipmapChain chain(bitmap.Access());
+
+    const std::size_t expectedSizes[][2] = { {37, 20}, {18, 10}, {9, 5}, {4, 2}, {2, 1}, {1, 1} };
+    ASSERT_EQ(6U, chain.CountLevels());
+    for(std::size_t index = 0; index < chain.CountLevels(); ++index) {
+      EXPECT_EQ(expectedSizes[index][0], chain.GetLevel(index).Width);
+      EXPECT_EQ(expectedSizes[index][1], chain.GetLevel(index).Height);
+      EXPECT_EQ(PixelFormat::R8_G8_B8_A8_Unsigned, chain.GetLevel(index).PixelFormat);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, LevelsAreStoredInOneAlignedMemoryBlock) {
+    Bitmap bitmap(37, 20, PixelFormat::R8_G8_B8_Unsigned);
+    MipmapChain chain(bitmap.Access());
+
+    const std::uint8_t *start = static_cast<const std::uint8_t *>(chain.GetPixels());
+    const std::uint8_t *end = start + chain.CountBytes();
+    for(std::size_t index = 0; index < chain.CountLevels(); ++index) {
+      const BitmapMemory &level = chain.GetLevel(index);
+      const std::uint8_t *pixels = static_cast<const std::uint8_t *>(level.Pixels);
+
+      EXPECT_EQ(0U, reinterpret_cast<std::uintptr_t>(pixels) % 16);
+      EXPECT_GE(pixels, start);
+      EXPECT_LE(pixels + level.Stride * level.Height, end);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, LevelCountCanBeLimited) {
+    Bitmap bitmap(64, 64, PixelFormat::R8_Unsigned);
+    MipmapChain chain(bitmap.Access(), MipmapColorSpace::Linear, 3);
+
+    ASSERT_EQ(3U, chain.CountLevels());
+    EXPECT_EQ(16U, chain.GetLevel(2).Width);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, LinearPixelsAreAveraged) {
+    Bitmap bitmap(2, 2, PixelFormat::R8_Unsigned);
+    {
+      std::uint8_t *pixels = static_cast<std::uint8_t *>(bitmap.Access().Pixels);
+      pixels[0] = 0;
+      pixels[1] = 100;
+      pixels[bitmap.Access().Stride] = 200;
+      pixels[bitmap.Access().Stride + 1] = 100;
+    }
+
+    MipmapChain chain(bitmap.Access());
+    ASSERT_EQ(2U, chain.CountLevels());
+    EXPECT_EQ(100, *static_cast<const std::uint8_t *>(chain.GetLevel(1).Pixels));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, SrgbPixelsAreAveragedInLinearSpace) {
+    Bitmap bitmap(2, 1, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const std::uint8_t blackAndWhite[8] = { 0, 0, 0, 255, 255, 255, 255, 255 };
+      std::copy_n(blackAndWhite, 8, static_cast<std::uint8_t *>(bitmap.Access().Pixels));
+    }
+
+    MipmapChain linearChain(bitmap.Access(), MipmapColorSpace::Linear);
+    MipmapChain srgbChain(bitmap.Access(), MipmapColorSpace::Srgb);
+
+    const std::uint8_t *linear = static_cast<const std::uint8_t *>(linearChain.GetLevel(1).Pixels);
+    EXPECT_EQ(128, linear[0]);
+    EXPECT_EQ(255, linear[3]);
+
+    // 50% of the light is sRGB 187.5
+    const std::uint8_t *srgb = static_cast<const std::uint8_t *>(srgbChain.GetLevel(1).Pixels);
+    EXPECT_GE(srgb[0], 187);
+    EXPECT_LE(srgb[0], 188);
+    EXPECT_EQ(255, srgb[3]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, HalfPixelsAreAveragedNatively) {
+    Bitmap bitmap(2, 2, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    {
+      const BitmapMemory &memory = bitmap.Access();
+      for(std::size_t y = 0; y < 2; ++y) {
+        Half *row = reinterpret_cast<Half *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride
+        );
+        for(std::size_t index = 0; index < 8; ++index) {
+          row[index] = Half(static_cast<float>(y * 8 + index) * 0.25f);
+        }
+      }
+    }
+
+    MipmapChain chain(bitmap.Access());
+    const Half *averaged = static_cast<const Half *>(chain.GetLevel(1).Pixels);
+
+    // Average of blue channels: (2 + 6 + 10 + 14) / 4 * 0.25
+    EXPECT_EQ(2.0f, static_cast<float>(averaged[2]));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, EmptyBitmapCausesException) {
+    Bitmap bitmap(0, 0, PixelFormat::R8_Unsigned);
+    EXPECT_THROW(MipmapChain chain(bitmap.Access()), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MipmapChainTest, ChainCanBeMoved) {
+    Bitmap bitmap(16, 16, PixelFormat::R8_Unsigned);
+    MipmapChain chain(bitmap.Access());
+    const void *pixels = chain.GetPixels();
+
+    MipmapChain movedChain(std::move(chain));
+    EXPECT_EQ(pixels, movedChain.GetPixels());
+    EXPECT_EQ(5U, movedChain.CountLevels());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,93 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/NumaBitmapAllocator.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include "Nuclex/Pixels/Bitmap.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring> // for std::memset()
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(NumaBitmapAllocatorTest, SmallBitmapsAreNotSpread) {
+    ThreadPool threadPool(4, true);
+    NumaBitmapAllocator allocator(threadPool);
+
+    EXPECT_FALSE(allocator.IsSpread(64 * 64 * 4));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(NumaBitmapAllocatorTest, SingleNodePoolsDontSpreadMemory) {
+    ThreadPool threadPool(4);
+    NumaBitmapAllocator allocator(threadPool);
+
+    EXPECT_FALSE(allocator.IsSpread(4096 * 4096 * 4));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(NumaBitmapAllocatorTest, BitmapsCanBeCreatedAndWritten) {
+    ThreadPool threadPool(4, true);
+    NumaBitmapAllocator allocator(threadPool);
+
+    for(std::size_t pass = 0; pass < 2; ++pass) {
+      Bitmap small(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+      Bitmap large(1024, 1000, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+
+      BitmapMemory memory = large.Access();
+      threadPool.ForEach(
+        memory.Height,
+        [&memory](std::size_t rowIndex) {
+          std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + (
+            static_cast<std::ptrdiff_t>(rowIndex) * memory.Stride
+          );
+          std::memset(row, static_cast<int>(rowIndex & 0xFF), memory.Width * 4);
+        }
+      );
+
+      const std::uint8_t *lastRow = static_cast<const std::uint8_t *>(memory.Pixels) + (
+        static_cast<std::ptrdiff_t>(memory.Height - 1) * memory.Stride
+      );
+      EXPECT_EQ((memory.Height - 1) & 0xFF, lastRow[memory.Width * 4 - 1]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(NumaBitmapAllocatorTest, AllocatorWorksWithoutExplicitBinding) {
+    ThreadPool threadPool(2, true);
+    NumaBitmapAllocator allocator(threadPool, false);
+
+    void *memory = allocator.Allocate(8 * 1024 * 1024);
+    std::memset(memory, 0x5A, 8 * 1024 * 1024);
+    allocator.Free(memory, 8 * 1024 * 1024);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,144 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/RowIterator.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelBandsTest, BandHeightDependsOnRowSize) {
+    EXPECT_EQ(1U, GetBandHeight(PreferredBandByteCount * 2));
+    EXPECT_EQ(1U, GetBandHeight(PreferredBandByteCount));
+    EXPECT_EQ(2U, GetBandHeight(PreferredBandByteCount / 2));
+    EXPECT_GE(GetBandHeight(4096 * 4), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelBandsTest, BandsCoverAllRowsOfView) {
+    Bitmap bitmap(4096, 600, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = bitmap.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::memset(static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y, 0, 4096 * 4);
+      }
+    }
+
+    ThreadPool threadPool(4);
+    std::atomic<std::size_t> coveredRowCount(0);
+
+    Bitmap view = bitmap.GetView(100, 50, 3000, 500);
+    ForEachBandInParallel(
+      threadPool, view.Access(),
+      [&coveredRowCount](const BitmapMemory &band, std::size_t y) {
+        EXPECT_EQ(3000U, band.Width);
+        EXPECT_LT(y, 500U);
+        ForEachRow(
+          band,
+          [](const PixelRow &row) {
+            std::uint8_t *pixel = static_cast<std::uint8_t *>(row.Begin);
+            std::uint8_t *end = static_cast<std::uint8_t *>(row.End);
+            for(; pixel < end; ++pixel) {
+              ++(*pixel);
+            }
+          }
+        );
+        coveredRowCount += band.Height;
+      }
+    );
+    EXPECT_EQ(500U, coveredRowCount.load());
+
+    const BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+      );
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        bool inView = (x >= 100) && (x < 3100) && (y >= 50) && (y < 550);
+        ASSERT_EQ(inView ? 1 : 0, row[x * 4]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelBandsTest, ParallelConversionMatchesSerialConversion) {
+    Bitmap source(1000, 300, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = source.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 3 + y);
+        }
+      }
+    }
+
+    Bitmap serial(1000, 300, PixelFormat::B8_G8_R8_Unsigned);
+    PixelFormatConverter::Convert(source.Access(), serial.Access());
+
+    ThreadPool threadPool(4);
+    Bitmap parallel(1000, 300, PixelFormat::B8_G8_R8_Unsigned);
+    PixelFormatConverter::Convert(source.Access(), parallel.Access(), threadPool);
+
+    const BitmapMemory &serialMemory = serial.Access();
+    const BitmapMemory &parallelMemory = parallel.Access();
+    for(std::size_t y = 0; y < serialMemory.Height; ++y) {
+      EXPECT_EQ(
+        0,
+        std::memcmp(
+          static_cast<const std::uint8_t *>(serialMemory.Pixels) + serialMemory.Stride * y,
+          static_cast<const std::uint8_t *>(parallelMemory.Pixels) + parallelMemory.Stride * y,
+          serialMemory.Width * 3
+        )
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ParallelBandsTest, BitmapsOfDifferentHeightCannotBeProcessed) {
+    Bitmap source(16, 16, PixelFormat::R8_Unsigned);
+    Bitmap target(16, 15, PixelFormat::R8_Unsigned);
+
+    ThreadPool threadPool(2);
+    EXPECT_THROW(
+      ForEachBandInParallel(
+        threadPool, source.Access(), target.Access(),
+        [](const BitmapMemory &, const BitmapMemory &, std::size_t) {}
+      ),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,488 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/Half.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of pixels used in the tests, chosen to not be a multiple of 16</summary>
+  const std::size_t TestPixelCount = 37;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a row of R8-G8-B8-A8 pixels with distinct channel values</summary>
+  /// <returns>The row of pixels</returns>
+  std::vector<std::uint8_t> makeRgbaRow() {
+    std::vector<std::uint8_t> pixels(TestPixelCount * 4);
+    for(std::size_t index = 0; index < pixels.size(); ++index) {
+      pixels[index] = static_cast<std::uint8_t>(index * 7 + 3);
+    }
+    return pixels;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a float RGBA bitmap with a single color</summary>
+  /// <param name="bitmap">Bitmap that will be filled</param>
+  /// <param name="rgba">Color the bitmap will be filled with</param>
+  void fillFloatBitmap(const Nuclex::Pixels::Bitmap &bitmap, const float (&rgba)[4]) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      float *row = reinterpret_cast<float *>(
+        static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y
+      );
+      for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+        row[x] = rgba[x % 4];
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the average of each channel in a float RGBA bitmap</summary>
+  /// <param name="bitmap">Bitmap whose channels will be averaged</param>
+  /// <param name="averages">Receives the average of each channel</param>
+  void averageChannels(const Nuclex::Pixels::Bitmap &bitmap, double (&averages)[4]) {
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    averages[0] = averages[1] = averages[2] = averages[3] = 0.0;
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const float *row = reinterpret_cast<const float *>(
+        static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+      );
+      for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+        averages[x % 4] += row[x];
+      }
+    }
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      averages[channel] /= static_cast<double>(memory.Width * memory.Height);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, CommonPixelFormatsCanBeConverted) {
+    EXPECT_TRUE(
+      PixelFormatConverter::CanConvert(
+        PixelFormat::R8_G8_B8_A8_Unsigned, PixelFormat::B8_G8_R8_A8_Unsigned
+      )
+    );
+    EXPECT_TRUE(
+      PixelFormatConverter::CanConvert(
+        PixelFormat::R8_G8_B8_A8_Unsigned, PixelFormat::R16_G16_B16_A16_Float_Native16
+      )
+    );
+    EXPECT_TRUE(
+      PixelFormatConverter::CanConvert(
+        PixelFormat::R5_G6_B5_Unsigned_Native16, PixelFormat::R32_G32_B32_A32_Float_Native32
+      )
+    );
+    EXPECT_FALSE(
+      PixelFormatConverter::CanConvert(
+        PixelFormat::A2_R10_G10_B10_Unsigned, PixelFormat::R8_G8_B8_A8_Unsigned
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, UnsupportedConversionThrowsException) {
+    std::uint8_t source[4] = { 0 }, target[4] = { 0 };
+    EXPECT_THROW(
+      PixelFormatConverter::ConvertRow(
+        PixelFormat::A2_R10_G10_B10_Unsigned, source,
+        PixelFormat::R8_G8_B8_A8_Unsigned, target,
+        1
+      ),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, RgbaToBgraSwapsRedAndBlue) {
+    std::vector<std::uint8_t> source = makeRgbaRow();
+    std::vector<std::uint8_t> target(source.size());
+
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R8_G8_B8_A8_Unsigned, source.data(),
+      PixelFormat::B8_G8_R8_A8_Unsigned, target.data(),
+      TestPixelCount
+    );
+
+    for(std::size_t index = 0; index < TestPixelCount; ++index) {
+      EXPECT_EQ(source[index * 4 + 0], target[index * 4 + 2]);
+      EXPECT_EQ(source[index * 4 + 1], target[index * 4 + 1]);
+      EXPECT_EQ(source[index * 4 + 2], target[index * 4 + 0]);
+      EXPECT_EQ(source[index * 4 + 3], target[index * 4 + 3]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, ByteOrderRoundTripIsLossless) {
+    std::vector<std::uint8_t> source = makeRgbaRow();
+    std::vector<std::uint8_t> first(source.size()), second(source.size());
+
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R8_G8_B8_A8_Unsigned, source.data(),
+      PixelFormat::A8_R8_G8_B8_Unsigned, first.data(),
+      TestPixelCount
+    );
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::A8_R8_G8_B8_Unsigned, first.data(),
+      PixelFormat::A8_B8_G8_R8_Unsigned, second.data(),
+      TestPixelCount
+    );
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::A8_B8_G8_R8_Unsigned, second.data(),
+      PixelFormat::R8_G8_B8_A8_Unsigned, first.data(),
+      TestPixelCount
+    );
+
+    EXPECT_EQ(source, first);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, RgbGainsOpaqueAlphaChannel) {
+    std::uint8_t source[6] = { 1, 2, 3, 4, 5, 6 };
+    std::uint8_t target[8] = { 0 };
+
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R8_G8_B8_Unsigned, source,
+      PixelFormat::B8_G8_R8_A8_Unsigned, target,
+      2
+    );
+
+    EXPECT_EQ(3, target[0]);
+    EXPECT_EQ(2, target[1]);
+    EXPECT_EQ(1, target[2]);
+    EXPECT_EQ(255, target[3]);
+    EXPECT_EQ(6, target[4]);
+    EXPECT_EQ(5, target[5]);
+    EXPECT_EQ(4, target[6]);
+    EXPECT_EQ(255, target[7]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, R5G6B5RoundTripIsLossless) {
+    std::vector<std::uint16_t> source(65536);
+    for(std::size_t index = 0; index < source.size(); ++index) {
+      source[index] = static_cast<std::uint16_t>(index);
+    }
+    std::vector<std::uint8_t> expanded(source.size() * 4);
+    std::vector<std::uint16_t> packed(source.size());
+
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R5_G6_B5_Unsigned_Native16, source.data(),
+      PixelFormat::R8_G8_B8_A8_Unsigned, expanded.data(),
+      source.size()
+    );
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R8_G8_B8_A8_Unsigned, expanded.data(),
+      PixelFormat::R5_G6_B5_Unsigned_Native16, packed.data(),
+      source.size()
+    );
+
+    EXPECT_EQ(source, packed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, R5G6B5PackingMatchesGenericConversion) {
+    std::vector<std::uint8_t> source = makeRgbaRow();
+    std::vector<std::uint8_t> viaFloats(source.size());
+    std::uint16_t direct[TestPixelCount], indirect[TestPixelCount];
+
+    // Direct packing uses the integer kernels
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::B8_G8_R8_A8_Unsigned, source.data(),
+      PixelFormat::B5_G6_R5_Unsigned_Flipped16, direct,
+      TestPixelCount
+    );
+
+    // Going through half floats forces the generic conversion path
+    std::vector<std::uint16_t> halfs(TestPixelCount * 4);
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::B8_G8_R8_A8_Unsigned, source.data(),
+      PixelFormat::R16_G16_B16_A16_Float_Native16, halfs.data(),
+      TestPixelCount
+    );
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R16_G16_B16_A16_Float_Native16, halfs.data(),
+      PixelFormat::B5_G6_R5_Unsigned_Flipped16, indirect,
+      TestPixelCount
+    );
+
+    for(std::size_t index = 0; index < TestPixelCount; ++index) {
+      EXPECT_EQ(direct[index], indirect[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, HalfRoundTripIsLossless) {
+    std::vector<std::uint8_t> source(256 * 4);
+    for(std::size_t index = 0; index < source.size(); ++index) {
+      source[index] = static_cast<std::uint8_t>(index / 4);
+    }
+    std::vector<std::uint16_t> halfs(source.size());
+    std::vector<std::uint8_t> target(source.size());
+
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R8_G8_B8_A8_Unsigned, source.data(),
+      PixelFormat::A16_B16_G16_R16_Float_Flipped16, halfs.data(),
+      256
+    );
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::A16_B16_G16_R16_Float_Flipped16, halfs.data(),
+      PixelFormat::R8_G8_B8_A8_Unsigned, target.data(),
+      256
+    );
+
+    EXPECT_EQ(source, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, BytesToHalfsMatchFloatConversion) {
+    std::vector<std::uint8_t> source = makeRgbaRow();
+    std::vector<std::uint16_t> bulk(TestPixelCount * 4), remapped(TestPixelCount * 4);
+
+    // Same channel order uses the bulk conversion, reverse order the per-channel loop
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R8_G8_B8_A8_Unsigned, source.data(),
+      PixelFormat::R16_G16_B16_A16_Float_Native16, bulk.data(),
+      TestPixelCount
+    );
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::B8_G8_R8_A8_Unsigned, source.data(),
+      PixelFormat::R16_G16_B16_A16_Float_Native16, remapped.data(),
+      TestPixelCount
+    );
+
+    for(std::size_t index = 0; index < TestPixelCount; ++index) {
+      for(std::size_t channel = 0; channel < 4; ++channel) {
+        float expected = static_cast<float>(source[index * 4 + channel]) / 255.0f;
+        EXPECT_EQ(Half::BitsFromFloat(expected), bulk[index * 4 + channel]);
+      }
+      EXPECT_EQ(bulk[index * 4 + 0], remapped[index * 4 + 2]);
+      EXPECT_EQ(bulk[index * 4 + 1], remapped[index * 4 + 1]);
+      EXPECT_EQ(bulk[index * 4 + 2], remapped[index * 4 + 0]);
+      EXPECT_EQ(bulk[index * 4 + 3], remapped[index * 4 + 3]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, MissingChannelsAreFilled) {
+    std::uint8_t source[2] = { 128, 255 };
+    float target[8] = { 0 };
+
+    PixelFormatConverter::ConvertRow(
+      PixelFormat::R8_Unsigned, source,
+      PixelFormat::R32_G32_B32_A32_Float_Native32, target,
+      2
+    );
+
+    EXPECT_FLOAT_EQ(128.0f / 255.0f, target[0]);
+    EXPECT_EQ(0.0f, target[1]);
+    EXPECT_EQ(0.0f, target[2]);
+    EXPECT_EQ(1.0f, target[3]);
+    EXPECT_EQ(1.0f, target[4]);
+    EXPECT_EQ(0.0f, target[5]);
+    EXPECT_EQ(0.0f, target[6]);
+    EXPECT_EQ(1.0f, target[7]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, BitmapsCanBeConverted) {
+    Bitmap source(17, 7, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = source.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x + y);
+        }
+      }
+    }
+
+    Bitmap target(17, 7, PixelFormat::B8_G8_R8_Unsigned);
+    PixelFormatConverter::Convert(source.Access(), target.Access());
+
+    const BitmapMemory &memory = target.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+      );
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        EXPECT_EQ(static_cast<std::uint8_t>(x * 4 + 2 + y), row[x * 3 + 0]);
+        EXPECT_EQ(static_cast<std::uint8_t>(x * 4 + 1 + y), row[x * 3 + 1]);
+        EXPECT_EQ(static_cast<std::uint8_t>(x * 4 + 0 + y), row[x * 3 + 2]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, DitheringPreservesAverageColor) {
+    const DitheringMethod methods[] = { DitheringMethod::Ordered, DitheringMethod::BlueNoise };
+    const float color[4] = { 10.4f / 31.0f, 20.7f / 63.0f, 5.5f / 31.0f, 0.5f };
+
+    Bitmap source(64, 64, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    fillFloatBitmap(source, color);
+
+    for(DitheringMethod method : methods) {
+      Bitmap packed(64, 64, PixelFormat::R5_G6_B5_Unsigned_Native16);
+      PixelFormatConverter::Convert(source.Access(), packed.Access(), method);
+
+      Bitmap unpacked(64, 64, PixelFormat::R32_G32_B32_A32_Float_Native32);
+      PixelFormatConverter::Convert(packed.Access(), unpacked.Access());
+
+      double averages[4];
+      averageChannels(unpacked, averages);
+      EXPECT_NEAR(averages[0] * 31.0, 10.4, 0.01);
+      EXPECT_NEAR(averages[1] * 63.0, 20.7, 0.01);
+      EXPECT_NEAR(averages[2] * 31.0, 5.5, 0.01);
+    }
+
+    Bitmap rounded(64, 64, PixelFormat::R5_G6_B5_Unsigned_Native16);
+    PixelFormatConverter::Convert(source.Access(), rounded.Access(), DitheringMethod::None);
+    Bitmap unpacked(64, 64, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    PixelFormatConverter::Convert(rounded.Access(), unpacked.Access());
+
+    double averages[4];
+    averageChannels(unpacked, averages);
+    EXPECT_NEAR(averages[0] * 31.0, 10.0, 0.0001);
+    EXPECT_NEAR(averages[1] * 63.0, 21.0, 0.0001);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, DitheringLeavesAlphaAndLosslessConversionsAlone) {
+    Bitmap source(16, 16, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    const float color[4] = { 0.3f, 0.6f, 0.9f, 100.3f / 255.0f };
+    fillFloatBitmap(source, color);
+
+    Bitmap dithered(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    PixelFormatConverter::Convert(source.Access(), dithered.Access(), DitheringMethod::Ordered);
+    const BitmapMemory &memory = dithered.Access();
+    for(std::size_t y = 0; y < 16; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+      );
+      for(std::size_t x = 0; x < 16; ++x) {
+        EXPECT_EQ(row[x * 4 + 3], 100);
+      }
+    }
+
+    // Converting to a format with at least the same precision must not add noise
+    Bitmap swizzled(16, 16, PixelFormat::B8_G8_R8_A8_Unsigned);
+    Bitmap ditheredSwizzled(16, 16, PixelFormat::B8_G8_R8_A8_Unsigned);
+    PixelFormatConverter::Convert(dithered.Access(), swizzled.Access());
+    PixelFormatConverter::Convert(
+      dithered.Access(), ditheredSwizzled.Access(), DitheringMethod::BlueNoise
+    );
+    for(std::size_t y = 0; y < 16; ++y) {
+      for(std::size_t x = 0; x < 16 * 4; ++x) {
+        std::size_t offset = swizzled.Access().Stride * y + x;
+        EXPECT_EQ(
+          static_cast<const std::uint8_t *>(ditheredSwizzled.Access().Pixels)[offset],
+          static_cast<const std::uint8_t *>(swizzled.Access().Pixels)[offset]
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, ParallelDitheringMatchesSingleThreaded) {
+    ThreadPool threadPool(4);
+
+    Bitmap source(300, 400, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    {
+      const BitmapMemory &memory = source.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint16_t *row = reinterpret_cast<std::uint16_t *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = Half::BitsFromFloat(static_cast<float>((x * 97 + y * 13) % 1000) / 999.0f);
+        }
+      }
+    }
+
+    Bitmap target(300, 400, PixelFormat::R8_G8_B8_Unsigned);
+    Bitmap parallelTarget(300, 400, PixelFormat::R8_G8_B8_Unsigned);
+    PixelFormatConverter::Convert(source.Access(), target.Access(), DitheringMethod::BlueNoise);
+    PixelFormatConverter::Convert(
+      source.Access(), parallelTarget.Access(), DitheringMethod::BlueNoise, threadPool
+    );
+
+    const BitmapMemory &memory = target.Access();
+    const BitmapMemory &parallelMemory = parallelTarget.Access();
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+      );
+      const std::uint8_t *parallelRow = (
+        static_cast<const std::uint8_t *>(parallelMemory.Pixels) + parallelMemory.Stride * y
+      );
+      for(std::size_t x = 0; x < memory.Width * 3; ++x) {
+        ASSERT_EQ(parallelRow[x], row[x]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatConverterTest, BitmapsOfDifferentSizeCannotBeConverted) {
+    Bitmap source(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap target(16, 15, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_THROW(
+      PixelFormatConverter::Convert(source.Access(), target.Access()),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -62,11 +62,11 @@ namespace Nuclex { namespace Pixels {
     EXPECT_EQ(32, CountBitsPerPixel(PixelFormat::R8_G8_B8_A8_Signed_Native32));
     EXPECT_EQ(32, CountBitsPerPixel(PixelFormat::R8_G8_B8_A8_Signed_Flipped32));
 
-/*    
-    EXPECT_EQ(4, CountBitsPerPixel(OldPixelFormat::BC1_Compressed));
-    EXPECT_EQ(8, CountBitsPerPixel(OldPixelFormat::BC2_Compressed));
-    EXPECT_EQ(8, CountBitsPerPixel(OldPixelFormat::BC3_Compressed));
-*/
+    EXPECT_EQ(4, CountBitsPerPixel(PixelFormat::BC1_Compressed));
+    EXPECT_EQ(8, CountBitsPerPixel(PixelFormat::BC3_Compressed));
+    EXPECT_EQ(4, CountBitsPerPixel(PixelFormat::BC4_Compressed));
+    EXPECT_EQ(8, CountBitsPerPixel(PixelFormat::BC5_Compressed));
+    EXPECT_EQ(8, CountBitsPerPixel(PixelFormat::BC7_Compressed));
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -104,6 +104,12 @@ namespace Nuclex { namespace Pixels {
     EXPECT_EQ(4, CountBytesPerBlock(PixelFormat::A8_B8_G8_R8_Signed_Flipped32));
     EXPECT_EQ(4, CountBytesPerBlock(PixelFormat::R8_G8_B8_A8_Signed_Native32));
     EXPECT_EQ(4, CountBytesPerBlock(PixelFormat::R8_G8_B8_A8_Signed_Flipped32));
+
+    EXPECT_EQ(8, CountBytesPerBlock(PixelFormat::BC1_Compressed));
+    EXPECT_EQ(16, CountBytesPerBlock(PixelFormat::BC3_Compressed));
+    EXPECT_EQ(8, CountBytesPerBlock(PixelFormat::BC4_Compressed));
+    EXPECT_EQ(16, CountBytesPerBlock(PixelFormat::BC5_Compressed));
+    EXPECT_EQ(16, CountBytesPerBlock(PixelFormat::BC7_Compressed));
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,167 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PixelFormatTraits.h"
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uint8_t
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the byte holding the red channel of a pixel</summary>
+  /// <typeparam name="TTraits">Traits of the pixel format the pixel is stored in</typeparam>
+  /// <param name="pixel">Address of the pixel whose red channel will be read</param>
+  /// <returns>The byte in which the pixel's red channel begins</returns>
+  template<typename TTraits>
+  std::uint8_t readRedByte(const std::uint8_t *pixel) {
+    return pixel[TTraits::RedBitOffset / 8];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatTraitsTest, ByteChannelsAreDescribedInMemoryOrder) {
+    typedef PixelFormatTraits<PixelFormat::B8_G8_R8_A8_Unsigned> Traits;
+
+    static_assert(Traits::ChannelCount == 4, u8"BGRA has four channels");
+    static_assert(Traits::BytesPerPixel == 4, u8"BGRA has four bytes per pixel");
+    static_assert(Traits::HasAlpha, u8"BGRA has an alpha channel");
+    static_assert(!Traits::IsPacked, u8"BGRA stores each channel in its own byte");
+
+    EXPECT_EQ(32U, Traits::BitsPerPixel);
+    EXPECT_EQ(16, Traits::RedBitOffset);
+    EXPECT_EQ(8, Traits::GreenBitOffset);
+    EXPECT_EQ(0, Traits::BlueBitOffset);
+    EXPECT_EQ(24, Traits::AlphaBitOffset);
+    EXPECT_EQ(8, Traits::RedBitCount);
+    EXPECT_EQ(8, Traits::AlphaBitCount);
+    EXPECT_FALSE(Traits::IsFloat);
+    EXPECT_FALSE(Traits::IsSigned);
+    EXPECT_FALSE(Traits::HasFlippedWords);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatTraitsTest, MissingChannelsHaveNoBits) {
+    typedef PixelFormatTraits<PixelFormat::R8_G8_Unsigned> Traits;
+
+    EXPECT_EQ(2U, Traits::ChannelCount);
+    EXPECT_EQ(0, Traits::RedBitOffset);
+    EXPECT_EQ(8, Traits::GreenBitOffset);
+    EXPECT_EQ(-1, Traits::BlueBitOffset);
+    EXPECT_EQ(0, Traits::BlueBitCount);
+    EXPECT_EQ(-1, Traits::AlphaBitOffset);
+    EXPECT_EQ(0, Traits::AlphaBitCount);
+    EXPECT_FALSE(Traits::HasAlpha);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatTraitsTest, PackedChannelsAreDescribedAsShifts) {
+    typedef PixelFormatTraits<PixelFormat::R5_G6_B5_Unsigned_Native16> Traits;
+
+    EXPECT_TRUE(Traits::IsPacked);
+    EXPECT_FALSE(Traits::HasFlippedWords);
+    EXPECT_EQ(3U, Traits::ChannelCount);
+    EXPECT_EQ(11, Traits::RedBitOffset);
+    EXPECT_EQ(5, Traits::RedBitCount);
+    EXPECT_EQ(5, Traits::GreenBitOffset);
+    EXPECT_EQ(6, Traits::GreenBitCount);
+    EXPECT_EQ(0, Traits::BlueBitOffset);
+    EXPECT_EQ(5, Traits::BlueBitCount);
+
+    EXPECT_TRUE(PixelFormatTraits<PixelFormat::R5_G6_B5_Unsigned_Flipped16>::HasFlippedWords);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatTraitsTest, FloatAndSignedFormatsAreFlagged) {
+    EXPECT_TRUE(PixelFormatTraits<PixelFormat::R16_Float_Native16>::IsFloat);
+    EXPECT_FALSE(PixelFormatTraits<PixelFormat::R16_Unsigned_Native16>::IsFloat);
+    EXPECT_TRUE(PixelFormatTraits<PixelFormat::R32_G32_B32_A32_Float_Native32>::IsFloat);
+    EXPECT_EQ(32, PixelFormatTraits<PixelFormat::R32_G32_B32_A32_Float_Native32>::AlphaBitCount);
+
+    EXPECT_TRUE(PixelFormatTraits<PixelFormat::R8_G8_B8_Signed>::IsSigned);
+    EXPECT_TRUE(PixelFormatTraits<PixelFormat::A8_R8_G8_B8_Signed>::IsSigned);
+    EXPECT_FALSE(PixelFormatTraits<PixelFormat::A8_R8_G8_B8_Unsigned>::IsSigned);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatTraitsTest, VisitorReceivesTraitsOfRuntimeFormat) {
+    const PixelFormat pixelFormats[] = {
+      PixelFormat::R8_Unsigned,
+      PixelFormat::R16_Float_Native16,
+      PixelFormat::R32_Float_Native32,
+      PixelFormat::R5_G6_B5_Unsigned_Flipped16,
+      PixelFormat::B8_G8_R8_Signed,
+      PixelFormat::R8_G8_B8_A8_Unsigned_Native32,
+      PixelFormat::A8_R8_G8_B8_Unsigned,
+      PixelFormat::A16_B16_G16_R16_Float_Native16,
+      PixelFormat::R32_G32_B32_A32_Float_Flipped32,
+      PixelFormat::A2_B10_G10_R10_Unsigned_Native16
+    };
+
+    for(std::size_t index = 0; index < sizeof(pixelFormats) / sizeof(PixelFormat); ++index) {
+      std::size_t bytesPerPixel = VisitPixelFormat(
+        pixelFormats[index],
+        [&](auto traits) {
+          EXPECT_EQ(pixelFormats[index], decltype(traits)::Format);
+          return decltype(traits)::BytesPerPixel;
+        }
+      );
+      EXPECT_EQ(CountBytesPerBlock(pixelFormats[index]), bytesPerPixel);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatTraitsTest, VisitorCanRunSpecializedKernels) {
+    const std::uint8_t pixel[] = { 11, 22, 33, 44 };
+    auto readRed = [&pixel](auto traits) { return readRedByte<decltype(traits)>(pixel); };
+
+    EXPECT_EQ(11, VisitPixelFormat(PixelFormat::R8_G8_B8_A8_Unsigned, readRed));
+    EXPECT_EQ(33, VisitPixelFormat(PixelFormat::B8_G8_R8_A8_Unsigned, readRed));
+    EXPECT_EQ(22, VisitPixelFormat(PixelFormat::A8_R8_G8_B8_Unsigned, readRed));
+    EXPECT_EQ(44, VisitPixelFormat(PixelFormat::A8_B8_G8_R8_Unsigned, readRed));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelFormatTraitsTest, VisitingInvalidFormatThrowsException) {
+    EXPECT_THROW(
+      VisitPixelFormat(static_cast<PixelFormat>(12345), [](auto traits) { (void)traits; }),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -106,6 +106,19 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(PixelIteratorTest, SinglePixelAdvanceCanReachEndPosition) {
+    BitmapMemory bitmapMemory = makeDummyBitmapMemory();
+    PixelIterator accessor(bitmapMemory);
+
+    for(std::size_t index = 0; index < 100 * 100; ++index) {
+      ++accessor;
+    }
+
+    EXPECT_EQ(accessor, PixelIterator::GetEnd(bitmapMemory));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   TEST(PixelIteratorTest, SinglePixelRetreatCanMoveIntoPreviousLine) {
     BitmapMemory bitmapMemory = makeDummyBitmapMemory();
     PixelIterator accessor(bitmapMemory);
@@ -0,0 +1,168 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PixelRange.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <algorithm> // for std::for_each()
+#include <cstdint>
+#include <iterator> // for std::distance()
+#include <vector>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelRangeTest, IteratorVisitsEveryPixelInOrder) {
+    Bitmap bitmap(13, 7, PixelFormat::R8_G8_B8_Unsigned);
+    const BitmapMemory &memory = bitmap.Access();
+
+    PixelRange pixels(memory);
+    ASSERT_EQ(std::distance(pixels.begin(), pixels.end()), 13 * 7);
+
+    std::size_t index = 0;
+    for(IndexedPixelIterator current = pixels.begin(); current != pixels.end(); ++current) {
+      std::size_t x = index % 13, y = index / 13;
+      EXPECT_EQ(current.GetX(), x);
+      EXPECT_EQ(current.GetY(), y);
+      EXPECT_EQ(
+        *current, static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y + x * 3
+      );
+      ++index;
+    }
+    EXPECT_EQ(index, 13U * 7U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelRangeTest, JumpsMatchSingleSteps) {
+    Bitmap bitmap(32, 32, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap view = bitmap.GetView(3, 5, 11, 9); // Stride is larger than a row
+
+    PixelRange pixels(view.Access());
+    IndexedPixelIterator begin = pixels.begin();
+
+    std::vector<void *> addresses;
+    for(void *pixel : pixels) {
+      addresses.push_back(pixel);
+    }
+    ASSERT_EQ(addresses.size(), 99U);
+
+    for(std::ptrdiff_t offset = 0; offset < 99; offset += 7) {
+      EXPECT_EQ(*(begin + offset), addresses[offset]);
+      EXPECT_EQ(begin[offset], addresses[offset]);
+      EXPECT_EQ(*(pixels.end() - (99 - offset)), addresses[offset]);
+      EXPECT_EQ((begin + offset) - begin, offset);
+    }
+
+    IndexedPixelIterator current = pixels.end();
+    for(std::size_t index = 99; index > 0; --index) {
+      --current;
+      ASSERT_EQ(*current, addresses[index - 1]);
+    }
+    EXPECT_TRUE(current == begin);
+    EXPECT_TRUE(begin < pixels.end());
+    EXPECT_TRUE(pixels.end() >= begin);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelRangeTest, NegativeStridesAreSupported) {
+    std::vector<std::uint8_t> pixels(8 * 4);
+    BitmapMemory memory;
+    memory.Width = 8;
+    memory.Height = 4;
+    memory.Stride = -8;
+    memory.PixelFormat = PixelFormat::R8_Unsigned;
+    memory.Pixels = pixels.data() + 8 * 3; // Bottom row comes first
+
+    PixelRange range(memory);
+    std::size_t index = 0;
+    for(void *pixel : range) {
+      *static_cast<std::uint8_t *>(pixel) = static_cast<std::uint8_t>(index++);
+    }
+
+    EXPECT_EQ(pixels[8 * 3 + 0], 0);
+    EXPECT_EQ(pixels[8 * 3 + 7], 7);
+    EXPECT_EQ(pixels[8 * 2 + 0], 8);
+    EXPECT_EQ(pixels[0], 24);
+    EXPECT_EQ(*(range.begin() + 17), &pixels[8 * 1 + 1]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelRangeTest, PartsAreRowAlignedAndCoverTheRange) {
+    Bitmap bitmap(10, 23, PixelFormat::R8_Unsigned);
+    PixelRange pixels(bitmap.Access());
+
+    std::size_t nextRow = 0;
+    for(std::size_t partIndex = 0; partIndex < 4; ++partIndex) {
+      PixelRange part = pixels.GetPart(partIndex, 4);
+      EXPECT_EQ(part.GetFirstRow(), nextRow);
+      EXPECT_GE(part.GetRowCount(), 5U);
+      EXPECT_LE(part.GetRowCount(), 6U);
+      EXPECT_EQ(part.begin().GetX(), 0U);
+      EXPECT_EQ(part.begin().GetY(), nextRow);
+      EXPECT_EQ(part.GetMemory().Height, part.GetRowCount());
+      nextRow += part.GetRowCount();
+    }
+    EXPECT_EQ(nextRow, 23U);
+
+    PixelRange tooManyParts = PixelRange(bitmap.Access(), 0, 2).GetPart(1, 5);
+    EXPECT_EQ(tooManyParts.GetPixelCount(), 0U);
+    EXPECT_TRUE(tooManyParts.begin() == tooManyParts.end());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PixelRangeTest, PartsCanBeProcessedInParallel) {
+    ThreadPool threadPool(4);
+
+    Bitmap bitmap(100, 250, PixelFormat::R8_G8_B8_A8_Unsigned);
+    PixelRange pixels(bitmap.Access());
+    for(void *pixel : pixels) {
+      *static_cast<std::uint32_t *>(pixel) = 0;
+    }
+
+    const std::size_t partCount = 16;
+    threadPool.ForEach(
+      partCount,
+      [&pixels](std::size_t partIndex) {
+        PixelRange part = pixels.GetPart(partIndex, partCount);
+        std::for_each(
+          part.begin(), part.end(),
+          [](void *pixel) { ++*static_cast<std::uint32_t *>(pixel); }
+        );
+      }
+    );
+
+    for(IndexedPixelIterator current = pixels.begin(); current != pixels.end(); ++current) {
+      ASSERT_EQ(*static_cast<const std::uint32_t *>(*current), 1U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,95 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PlanarBitmap.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarBitmapTest, HasOnePlanePerChannel) {
+    PlanarBitmap rgb(12, 34, PixelFormat::R8_G8_B8_Unsigned);
+    EXPECT_EQ(12U, rgb.GetWidth());
+    EXPECT_EQ(34U, rgb.GetHeight());
+    EXPECT_EQ(3U, rgb.Access().PlaneCount);
+    EXPECT_EQ(PixelFormat::R8_G8_B8_Unsigned, rgb.Access().PixelFormat);
+    EXPECT_EQ(nullptr, rgb.Access().Planes[3]);
+
+    PlanarBitmap rgba(12, 34, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    EXPECT_EQ(4U, rgba.Access().PlaneCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarBitmapTest, PlanesAndLinesAreAligned) {
+    PlanarBitmap bitmap(37, 5, PixelFormat::R16_G16_B16_A16_Float_Native16);
+    const PlanarBitmapMemory &memory = bitmap.Access();
+
+    for(std::size_t index = 0; index < memory.PlaneCount; ++index) {
+      std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory.Planes[index]);
+      EXPECT_EQ(0U, address % 16);
+      EXPECT_EQ(0, memory.Strides[index] % 16);
+      EXPECT_GE(memory.Strides[index], 37 * 2);
+    }
+
+    // The planes must not overlap
+    for(std::size_t index = 1; index < memory.PlaneCount; ++index) {
+      EXPECT_GE(
+        static_cast<std::uint8_t *>(memory.Planes[index]),
+        static_cast<std::uint8_t *>(memory.Planes[index - 1]) + memory.Strides[index - 1] * 5
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarBitmapTest, PackedPixelFormatsCauseException) {
+    EXPECT_THROW(
+      PlanarBitmap bitmap(16, 16, PixelFormat::R5_G6_B5_Unsigned),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarBitmapTest, BitmapCanBeMoved) {
+    PlanarBitmap bitmap(16, 16, PixelFormat::R8_G8_Unsigned);
+    void *firstPlane = bitmap.Access().Planes[0];
+
+    PlanarBitmap moved(std::move(bitmap));
+    EXPECT_EQ(firstPlane, moved.Access().Planes[0]);
+
+    PlanarBitmap other(4, 4, PixelFormat::R8_Unsigned);
+    other = std::move(moved);
+    EXPECT_EQ(firstPlane, other.Access().Planes[0]);
+    EXPECT_EQ(2U, other.Access().PlaneCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
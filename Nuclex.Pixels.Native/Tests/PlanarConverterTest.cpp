@@ -0,0 +1,237 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PlanarConverter.h"
+#include "Nuclex/Pixels/PlanarBitmap.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/ThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates a unique value for each channel of each pixel</summary>
+  /// <param name="x">X coordinate of the pixel</param>
+  /// <param name="y">Y coordinate of the pixel</param>
+  /// <param name="channel">Index of the channel</param>
+  /// <returns>The value the channel of the pixel should have</returns>
+  std::uint32_t getTestValue(std::size_t x, std::size_t y, std::size_t channel) {
+    return static_cast<std::uint32_t>(
+      (x * 4 + channel) * 0x01030507U + y * 0x0B0D1113U
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills a bitmap with unique values in each channel of each pixel</summary>
+  /// <typeparam name="TValue">Type large enough to hold the value of a channel</typeparam>
+  /// <param name="memory">Bitmap memory that will be filled</param>
+  /// <param name="channelCount">Number of channels in each pixel</param>
+  template<typename TValue>
+  void fillInterleaved(const Nuclex::Pixels::BitmapMemory &memory, std::size_t channelCount) {
+    for(std::size_t y = 0; y < memory.Height; ++y) {
+      TValue *row = reinterpret_cast<TValue *>(
+        static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride
+      );
+      for(std::size_t x = 0; x < memory.Width; ++x) {
+        for(std::size_t channel = 0; channel < channelCount; ++channel) {
+          row[x * channelCount + channel] = static_cast<TValue>(getTestValue(x, y, channel));
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the planes of a bitmap hold the expected values</summary>
+  /// <typeparam name="TValue">Type large enough to hold the value of a channel</typeparam>
+  /// <param name="memory">Planar bitmap memory that will be checked</param>
+  /// <returns>True if all values in all planes are as expected</returns>
+  template<typename TValue>
+  bool planesHoldTestValues(const Nuclex::Pixels::PlanarBitmapMemory &memory) {
+    for(std::size_t channel = 0; channel < memory.PlaneCount; ++channel) {
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        const TValue *row = reinterpret_cast<const TValue *>(
+          static_cast<const std::uint8_t *>(memory.Planes[channel]) + y * memory.Strides[channel]
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          if(row[x] != static_cast<TValue>(getTestValue(x, y, channel))) {
+            return false;
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Splits a bitmap into planes, interleaves them again and checks all values</summary>
+  /// <typeparam name="TValue">Type large enough to hold the value of a channel</typeparam>
+  /// <param name="pixelFormat">Pixel format of the bitmap that will be split</param>
+  /// <param name="channelCount">Number of channels in the pixel format</param>
+  template<typename TValue>
+  void checkRoundTrip(Nuclex::Pixels::PixelFormat pixelFormat, std::size_t channelCount) {
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::PlanarBitmap;
+    using Nuclex::Pixels::PlanarConverter;
+
+    // Odd width so both the SIMD and the scalar loop get some pixels
+    Bitmap interleaved(37, 3, pixelFormat);
+    fillInterleaved<TValue>(interleaved.Access(), channelCount);
+
+    PlanarBitmap planar(37, 3, pixelFormat);
+    PlanarConverter::Deinterleave(interleaved.Access(), planar.Access());
+    EXPECT_TRUE(planesHoldTestValues<TValue>(planar.Access()));
+
+    Bitmap reinterleaved(37, 3, pixelFormat);
+    PlanarConverter::Interleave(planar.Access(), reinterleaved.Access());
+
+    const Nuclex::Pixels::BitmapMemory &expected = interleaved.Access();
+    const Nuclex::Pixels::BitmapMemory &actual = reinterleaved.Access();
+    std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(pixelFormat, 37);
+    for(std::size_t y = 0; y < 3; ++y) {
+      const std::uint8_t *expectedRow = (
+        static_cast<const std::uint8_t *>(expected.Pixels) + y * expected.Stride
+      );
+      const std::uint8_t *actualRow = (
+        static_cast<const std::uint8_t *>(actual.Pixels) + y * actual.Stride
+      );
+      for(std::size_t index = 0; index < rowByteCount; ++index) {
+        ASSERT_EQ(expectedRow[index], actualRow[index]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarConverterTest, PackedPixelFormatsCanNotBeSplit) {
+    EXPECT_TRUE(PlanarConverter::CanSplit(PixelFormat::R8_G8_B8_A8_Unsigned));
+    EXPECT_TRUE(PlanarConverter::CanSplit(PixelFormat::R16_G16_B16_A16_Float_Native16));
+    EXPECT_FALSE(PlanarConverter::CanSplit(PixelFormat::R5_G6_B5_Unsigned));
+    EXPECT_FALSE(PlanarConverter::CanSplit(PixelFormat::A2_R10_G10_B10_Unsigned));
+
+    EXPECT_EQ(3U, PlanarConverter::CountPlanes(PixelFormat::B8_G8_R8_Unsigned));
+    EXPECT_EQ(0U, PlanarConverter::CountPlanes(PixelFormat::R5_G6_B5_Unsigned));
+    EXPECT_EQ(4U, PlanarConverter::CountBytesPerChannel(PixelFormat::R32_Float_Native32));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarConverterTest, EightBitChannelsSurviveRoundTrip) {
+    checkRoundTrip<std::uint8_t>(PixelFormat::R8_Unsigned, 1);
+    checkRoundTrip<std::uint8_t>(PixelFormat::R8_G8_Unsigned, 2);
+    checkRoundTrip<std::uint8_t>(PixelFormat::B8_G8_R8_Unsigned, 3);
+    checkRoundTrip<std::uint8_t>(PixelFormat::R8_G8_B8_A8_Unsigned, 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarConverterTest, SixteenBitChannelsSurviveRoundTrip) {
+    checkRoundTrip<std::uint16_t>(PixelFormat::R16_Unsigned_Native16, 1);
+    checkRoundTrip<std::uint16_t>(PixelFormat::R16_G16_Unsigned_Native16, 2);
+    checkRoundTrip<std::uint16_t>(PixelFormat::R16_G16_B16_A16_Float_Native16, 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarConverterTest, ThirtyTwoBitChannelsSurviveRoundTrip) {
+    checkRoundTrip<std::uint32_t>(PixelFormat::R32_Float_Native32, 1);
+    checkRoundTrip<std::uint32_t>(PixelFormat::R32_G32_B32_A32_Float_Native32, 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarConverterTest, ViewsCanBeSplit) {
+    Bitmap bitmap(40, 20, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillInterleaved<std::uint8_t>(bitmap.Access(), 4);
+    Bitmap view = bitmap.GetView(3, 2, 33, 10);
+
+    PlanarBitmap planar(33, 10, PixelFormat::R8_G8_B8_A8_Unsigned);
+    PlanarConverter::Deinterleave(view.Access(), planar.Access());
+
+    const PlanarBitmapMemory &memory = planar.Access();
+    for(std::size_t channel = 0; channel < 4; ++channel) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Planes[channel]) + 9 * memory.Strides[channel]
+      );
+      EXPECT_EQ(static_cast<std::uint8_t>(getTestValue(3, 11, channel)), row[0]);
+      EXPECT_EQ(static_cast<std::uint8_t>(getTestValue(35, 11, channel)), row[32]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarConverterTest, ParallelConversionMatchesSingleThreaded) {
+    ThreadPool threadPool(4);
+
+    Bitmap interleaved(300, 500, PixelFormat::R8_G8_B8_A8_Unsigned);
+    fillInterleaved<std::uint8_t>(interleaved.Access(), 4);
+
+    PlanarBitmap planar(300, 500, PixelFormat::R8_G8_B8_A8_Unsigned);
+    PlanarConverter::Deinterleave(interleaved.Access(), planar.Access(), threadPool);
+    EXPECT_TRUE(planesHoldTestValues<std::uint8_t>(planar.Access()));
+
+    Bitmap reinterleaved(300, 500, PixelFormat::R8_G8_B8_A8_Unsigned);
+    PlanarConverter::Interleave(planar.Access(), reinterleaved.Access(), threadPool);
+    for(std::size_t y = 0; y < 500; y += 7) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(
+        reinterleaved.Access().Pixels
+      ) + y * reinterleaved.Access().Stride;
+      for(std::size_t x = 0; x < 300; ++x) {
+        ASSERT_EQ(static_cast<std::uint8_t>(getTestValue(x, y, 2)), row[x * 4 + 2]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PlanarConverterTest, MismatchedBitmapsCauseException) {
+    Bitmap interleaved(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    PlanarBitmap wrongSize(16, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    PlanarBitmap wrongFormat(16, 16, PixelFormat::B8_G8_R8_A8_Unsigned);
+
+    EXPECT_THROW(
+      PlanarConverter::Deinterleave(interleaved.Access(), wrongSize.Access()),
+      std::runtime_error
+    );
+    EXPECT_THROW(
+      PlanarConverter::Interleave(wrongFormat.Access(), interleaved.Access()),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,152 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/PooledBitmapAllocator.h"
+#include "Nuclex/Pixels/Bitmap.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledBitmapAllocatorTest, HasDefaultConstructor) {
+    EXPECT_NO_THROW(
+      PooledBitmapAllocator allocator;
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledBitmapAllocatorTest, MemoryOfDestroyedBitmapsIsRecycled) {
+    PooledBitmapAllocator allocator;
+
+    const void *firstPixels;
+    {
+      Bitmap bitmap(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+      firstPixels = bitmap.Access().Pixels;
+    }
+    {
+      Bitmap bitmap(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+      EXPECT_EQ(firstPixels, bitmap.Access().Pixels);
+    }
+
+    PooledBitmapAllocator::Statistics statistics = allocator.GetStatistics();
+    EXPECT_EQ(2U, statistics.AllocationCount);
+    EXPECT_EQ(1U, statistics.HitCount);
+    EXPECT_GE(statistics.ResidentByteCount, 64U * 32U * 4U);
+    EXPECT_EQ(statistics.ResidentByteCount, statistics.PooledByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledBitmapAllocatorTest, DifferentSizesAreNotMixedUp) {
+    PooledBitmapAllocator allocator;
+    {
+      Bitmap bitmap(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+    }
+    {
+      Bitmap bitmap(64, 32, PixelFormat::R8_Unsigned, allocator);
+    }
+
+    PooledBitmapAllocator::Statistics statistics = allocator.GetStatistics();
+    EXPECT_EQ(2U, statistics.AllocationCount);
+    EXPECT_EQ(0U, statistics.HitCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledBitmapAllocatorTest, ResidentBytesIncludeBitmapsInUse) {
+    PooledBitmapAllocator allocator;
+    Bitmap bitmap(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+
+    PooledBitmapAllocator::Statistics statistics = allocator.GetStatistics();
+    EXPECT_GE(statistics.ResidentByteCount, 64U * 32U * 4U);
+    EXPECT_EQ(0U, statistics.PooledByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledBitmapAllocatorTest, CopiesUseAllocatorOfOriginal) {
+    PooledBitmapAllocator allocator;
+    {
+      Bitmap original(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+      Bitmap copy(original);
+      Bitmap view = original.GetView(8, 8, 16, 16);
+      view.Autonomize();
+    }
+
+    PooledBitmapAllocator::Statistics statistics = allocator.GetStatistics();
+    EXPECT_EQ(3U, statistics.AllocationCount);
+    EXPECT_EQ(statistics.ResidentByteCount, statistics.PooledByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledBitmapAllocatorTest, PoolIsLimitedToMaximumByteCount) {
+    PooledBitmapAllocator allocator(64 * 32 * 4 + 1024);
+    {
+      Bitmap first(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+      Bitmap second(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+    }
+
+    PooledBitmapAllocator::Statistics statistics = allocator.GetStatistics();
+    EXPECT_EQ(statistics.ResidentByteCount, statistics.PooledByteCount);
+    EXPECT_LE(statistics.PooledByteCount, 64U * 32U * 4U + 1024U);
+    EXPECT_GE(statistics.PooledByteCount, 64U * 32U * 4U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledBitmapAllocatorTest, TrimReleasesIdleMemory) {
+    PooledBitmapAllocator allocator;
+    {
+      Bitmap bitmap(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned, allocator);
+    }
+    allocator.Trim();
+
+    PooledBitmapAllocator::Statistics statistics = allocator.GetStatistics();
+    EXPECT_EQ(0U, statistics.ResidentByteCount);
+    EXPECT_EQ(0U, statistics.PooledByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PooledBitmapAllocatorTest, CanBeMadeDefaultAllocator) {
+    PooledBitmapAllocator allocator;
+
+    BitmapAllocator::SetDefault(&allocator);
+    {
+      Bitmap bitmap(64, 32);
+    }
+    BitmapAllocator::SetDefault(nullptr);
+    {
+      Bitmap bitmap(64, 32);
+    }
+
+    EXPECT_EQ(1U, allocator.GetStatistics().AllocationCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
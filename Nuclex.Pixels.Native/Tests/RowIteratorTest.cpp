@@ -0,0 +1,133 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/RowIterator.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowIteratorTest, RangeCoversAllRows) {
+    Bitmap bitmap(12, 34, PixelFormat::R8_G8_B8_A8_Unsigned);
+    const BitmapMemory &memory = bitmap.Access();
+
+    std::size_t expectedY = 0;
+    for(PixelRow row : GetRows(memory)) {
+      EXPECT_EQ(expectedY, row.Y);
+      EXPECT_EQ(
+        static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * expectedY,
+        static_cast<std::uint8_t *>(row.Begin)
+      );
+      EXPECT_EQ(
+        48, static_cast<std::uint8_t *>(row.End) - static_cast<std::uint8_t *>(row.Begin)
+      );
+      ++expectedY;
+    }
+
+    EXPECT_EQ(34U, expectedY);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowIteratorTest, EmptyBitmapHasNoRows) {
+    BitmapMemory memory;
+    memory.Width = 10;
+    memory.Height = 0;
+    memory.Stride = 10;
+    memory.PixelFormat = PixelFormat::R8_Unsigned;
+    memory.Pixels = nullptr;
+
+    RowRange rows = GetRows(memory);
+    EXPECT_TRUE(rows.begin() == rows.end());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowIteratorTest, ForEachRowRespectsViews) {
+    Bitmap bitmap(16, 16, PixelFormat::R8_Unsigned);
+    {
+      const BitmapMemory &memory = bitmap.Access();
+      for(std::size_t y = 0; y < 16; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < 16; ++x) {
+          row[x] = 0;
+        }
+      }
+    }
+
+    Bitmap view = bitmap.GetView(4, 2, 8, 3);
+    std::size_t rowCount = 0;
+    ForEachRow(
+      view.Access(),
+      [&rowCount](const PixelRow &row) {
+        std::uint8_t *pixel = static_cast<std::uint8_t *>(row.Begin);
+        std::uint8_t *end = static_cast<std::uint8_t *>(row.End);
+        for(; pixel < end; ++pixel) {
+          *pixel = 1;
+        }
+        ++rowCount;
+      }
+    );
+    EXPECT_EQ(3U, rowCount);
+
+    const BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < 16; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+      );
+      for(std::size_t x = 0; x < 16; ++x) {
+        bool inView = (x >= 4) && (x < 12) && (y >= 2) && (y < 5);
+        EXPECT_EQ(inView ? 1 : 0, row[x]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowIteratorTest, NegativeStrideIsSupported) {
+    std::uint8_t pixels[12] = { 0 };
+
+    BitmapMemory memory;
+    memory.Width = 4;
+    memory.Height = 3;
+    memory.Stride = -4;
+    memory.PixelFormat = PixelFormat::R8_Unsigned;
+    memory.Pixels = pixels + 8; // Start at the last line
+
+    ForEachRow(
+      memory,
+      [](const PixelRow &row) {
+        *static_cast<std::uint8_t *>(row.Begin) = static_cast<std::uint8_t>(row.Y + 1);
+      }
+    );
+
+    EXPECT_EQ(3, pixels[0]);
+    EXPECT_EQ(2, pixels[4]);
+    EXPECT_EQ(1, pixels[8]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,273 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/RowStream.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "Nuclex/Pixels/BitmapResampler.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "Nuclex/Pixels/PixelFormatConverter.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>All filters the resampler supports</summary>
+  const Nuclex::Pixels::ResamplingFilter AllFilters[] = {
+    Nuclex::Pixels::ResamplingFilter::Box,
+    Nuclex::Pixels::ResamplingFilter::Bilinear,
+    Nuclex::Pixels::ResamplingFilter::Lanczos3,
+    Nuclex::Pixels::ResamplingFilter::Mitchell
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row source that provides the rows of a bitmap</summary>
+  class BitmapRowSource : public Nuclex::Pixels::RowSource {
+
+    /// <summary>Initializes a new row source providing the rows of a bitmap</summary>
+    /// <param name="bitmap">Bitmap whose rows will be provided</param>
+    public: BitmapRowSource(const Nuclex::Pixels::Bitmap &bitmap) :
+      memory(bitmap.Access()),
+      nextY(0) {}
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->memory.Width; }
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: std::size_t GetHeight() const override { return this->memory.Height; }
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->memory.PixelFormat;
+    }
+
+    /// <summary>Copies the next rows of the bitmap</summary>
+    /// <param name="rows">Bitmap memory that will receive the rows</param>
+    public: void ReadRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      if(this->nextY + rows.Height > this->memory.Height) {
+        throw std::runtime_error(u8"Read past the end of the bitmap");
+      }
+
+      std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+        this->memory.PixelFormat, this->memory.Width
+      );
+      for(std::size_t y = 0; y < rows.Height; ++y) {
+        const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(
+          Nuclex::Pixels::GetBand(this->memory, this->nextY + y, 1).Pixels
+        );
+        std::uint8_t *targetRow = static_cast<std::uint8_t *>(
+          Nuclex::Pixels::GetBand(rows, y, 1).Pixels
+        );
+        std::copy_n(sourceRow, rowByteCount, targetRow);
+      }
+
+      this->nextY += rows.Height;
+    }
+
+    /// <summary>Bitmap memory the rows are taken from</summary>
+    private: Nuclex::Pixels::BitmapMemory memory;
+    /// <summary>Index of the next row that will be provided</summary>
+    private: std::size_t nextY;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row sink that stores the rows written into it in a bitmap</summary>
+  class BitmapRowSink : public Nuclex::Pixels::RowSink {
+
+    /// <summary>Initializes a new row sink storing rows in a bitmap</summary>
+    /// <param name="bitmap">Bitmap that will receive the rows</param>
+    public: BitmapRowSink(const Nuclex::Pixels::Bitmap &bitmap) :
+      memory(bitmap.Access()),
+      nextY(0) {}
+
+    /// <summary>Retrieves the width of the rows the row sink accepts</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->memory.Width; }
+
+    /// <summary>Retrieves the number of rows the row sink accepts in total</summary>
+    /// <returns>The height of the image written into the row sink</returns>
+    public: std::size_t GetHeight() const override { return this->memory.Height; }
+
+    /// <summary>Retrieves the pixel format the row sink accepts rows in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->memory.PixelFormat;
+    }
+
+    /// <summary>Copies the rows into the bitmap</summary>
+    /// <param name="rows">Bitmap memory holding the rows</param>
+    public: void WriteRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      if(this->nextY + rows.Height > this->memory.Height) {
+        throw std::runtime_error(u8"Wrote past the end of the bitmap");
+      }
+
+      std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+        this->memory.PixelFormat, this->memory.Width
+      );
+      for(std::size_t y = 0; y < rows.Height; ++y) {
+        const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(
+          Nuclex::Pixels::GetBand(rows, y, 1).Pixels
+        );
+        std::uint8_t *targetRow = static_cast<std::uint8_t *>(
+          Nuclex::Pixels::GetBand(this->memory, this->nextY + y, 1).Pixels
+        );
+        std::copy_n(sourceRow, rowByteCount, targetRow);
+      }
+
+      this->nextY += rows.Height;
+    }
+
+    /// <summary>Bitmap memory that receives the rows</summary>
+    private: Nuclex::Pixels::BitmapMemory memory;
+    /// <summary>Index of the next row that will be written</summary>
+    private: std::size_t nextY;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowStreamTest, RowsCanBeTransferred) {
+    Bitmap original(41, 29, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(original);
+
+    Bitmap copy(41, 29, PixelFormat::R8_G8_B8_A8_Unsigned);
+    BitmapRowSource source(original);
+    BitmapRowSink sink(copy);
+    TransferRows(source, sink);
+
+    EXPECT_TRUE(HaveSamePixels(original, copy));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowStreamTest, TransferConvertsToPixelFormatOfSink) {
+    Bitmap original(41, 29, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(original);
+
+    Bitmap expected(41, 29, PixelFormat::R16_G16_B16_A16_Float);
+    PixelFormatConverter::Convert(original.Access(), expected.Access());
+
+    Bitmap transferred(41, 29, PixelFormat::R16_G16_B16_A16_Float);
+    BitmapRowSource source(original);
+    BitmapRowSink sink(transferred);
+    TransferRows(source, sink);
+
+    EXPECT_TRUE(HaveSamePixels(expected, transferred));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowStreamTest, TransferRequiresMatchingDimensions) {
+    Bitmap original(41, 29, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap smaller(40, 29, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    BitmapRowSource source(original);
+    BitmapRowSink sink(smaller);
+    EXPECT_THROW(TransferRows(source, sink), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowStreamTest, ConvertedRowsMatchConvertedBitmap) {
+    Bitmap original(41, 29, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(original);
+
+    Bitmap expected(41, 29, PixelFormat::B8_G8_R8_Unsigned);
+    PixelFormatConverter::Convert(original.Access(), expected.Access());
+
+    std::unique_ptr<RowSource> converted = PixelFormatConverter::ConvertRows(
+      std::unique_ptr<RowSource>(new BitmapRowSource(original)), PixelFormat::B8_G8_R8_Unsigned
+    );
+    ASSERT_EQ(PixelFormat::B8_G8_R8_Unsigned, converted->GetPixelFormat());
+
+    // Read in odd-sized batches so the batches don't line up with bands
+    Bitmap streamed(41, 29, PixelFormat::B8_G8_R8_Unsigned);
+    for(std::size_t y = 0; y < 29; y += 4) {
+      converted->ReadRows(GetBand(streamed.Access(), y, std::min<std::size_t>(4, 29 - y)));
+    }
+
+    EXPECT_TRUE(HaveSamePixels(expected, streamed));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowStreamTest, ReadingTooManyRowsThrows) {
+    Bitmap original(13, 5, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    std::unique_ptr<RowSource> converted = PixelFormatConverter::ConvertRows(
+      std::unique_ptr<RowSource>(new BitmapRowSource(original)), PixelFormat::R8_Unsigned
+    );
+
+    Bitmap rows(13, 6, PixelFormat::R8_Unsigned);
+    EXPECT_THROW(converted->ReadRows(rows.Access()), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RowStreamTest, ResampledRowsMatchResampledBitmap) {
+    Bitmap original(53, 37, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(original);
+
+    const std::size_t targetSizes[][2] = { { 17, 11 }, { 90, 61 }, { 53, 19 } };
+    for(ResamplingFilter filter : AllFilters) {
+      for(const std::size_t (&targetSize)[2] : targetSizes) {
+        Bitmap expected(targetSize[0], targetSize[1], PixelFormat::R8_G8_B8_A8_Unsigned);
+        BitmapResampler::Resample(original.Access(), expected.Access(), filter);
+
+        std::unique_ptr<RowSource> resampled = BitmapResampler::ResampleRows(
+          std::unique_ptr<RowSource>(new BitmapRowSource(original)),
+          targetSize[0], targetSize[1], filter
+        );
+        ASSERT_EQ(targetSize[0], resampled->GetWidth());
+        ASSERT_EQ(targetSize[1], resampled->GetHeight());
+
+        Bitmap streamed(targetSize[0], targetSize[1], PixelFormat::R8_G8_B8_A8_Unsigned);
+        BitmapRowSink sink(streamed);
+        TransferRows(*resampled, sink);
+
+        EXPECT_TRUE(HaveSamePixels(expected, streamed));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,434 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/AnimationReader.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+#include <zlib.h> // for ::crc32()
+#endif
+
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::out_of_range
+#include <vector> // for std::vector
+
+#include "../BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Growable file kept in memory that saved images are written into</summary>
+  class MemoryBufferFile : public Nuclex::Pixels::Storage::VirtualFile {
+
+    /// <summary>Initializes a new, empty memory buffer file</summary>
+    public: MemoryBufferFile() :
+      contents() {}
+
+    /// <summary>Frees all memory used by the instance</summary>
+    public: virtual ~MemoryBufferFile() = default;
+
+    /// <summary>Provides access to the contents of the file</summary>
+    /// <returns>A vector holding the bytes written into the file</returns>
+    public: const std::vector<std::uint8_t> &GetContents() const { return this->contents; }
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override {
+      if((start > this->contents.size()) || (byteCount > this->contents.size() - start)) {
+        throw std::out_of_range(u8"Attempted to read beyond the end of the file");
+      }
+      if(byteCount > 0) {
+        std::memcpy(buffer, this->contents.data() + start, byteCount);
+      }
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw std::out_of_range(u8"Attempted to write beyond the end of the file");
+      }
+      std::size_t end = static_cast<std::size_t>(start) + byteCount;
+      if(end > this->contents.size()) {
+        this->contents.resize(end);
+      }
+      if(byteCount > 0) {
+        std::memcpy(this->contents.data() + start, buffer, byteCount);
+      }
+    }
+
+    /// <summary>Bytes that have been written into the file</summary>
+    private: std::vector<std::uint8_t> contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frame of the test animation</summary>
+  struct TestFrame {
+
+    /// <summary>X coordinate of the frame's region on the canvas</summary>
+    public: std::uint32_t X;
+    /// <summary>Y coordinate of the frame's region on the canvas</summary>
+    public: std::uint32_t Y;
+    /// <summary>Width of the frame's region</summary>
+    public: std::uint32_t Width;
+    /// <summary>Height of the frame's region</summary>
+    public: std::uint32_t Height;
+    /// <summary>Color the whole frame is filled with, as R, G, B and A</summary>
+    public: std::uint8_t Color[4];
+    /// <summary>APNG dispose operation of the frame</summary>
+    public: std::uint8_t DisposeOperation;
+    /// <summary>APNG blend operation of the frame</summary>
+    public: std::uint8_t BlendOperation;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a 32 bit integer in big endian byte order</summary>
+  /// <param name="target">Vector the integer will be appended to</param>
+  /// <param name="value">Integer that will be appended</param>
+  void appendBigEndian(std::vector<std::uint8_t> &target, std::uint32_t value) {
+    target.push_back(static_cast<std::uint8_t>(value >> 24));
+    target.push_back(static_cast<std::uint8_t>(value >> 16));
+    target.push_back(static_cast<std::uint8_t>(value >> 8));
+    target.push_back(static_cast<std::uint8_t>(value));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a chunk to a PNG file</summary>
+  /// <param name="file">Contents of the PNG file the chunk will be appended to</param>
+  /// <param name="type">Four character type of the chunk</param>
+  /// <param name="data">Data the chunk will hold</param>
+  void appendChunk(
+    std::vector<std::uint8_t> &file, const char type[4], const std::vector<std::uint8_t> &data
+  ) {
+    appendBigEndian(file, static_cast<std::uint32_t>(data.size()));
+    std::size_t typeStart = file.size();
+    file.insert(file.end(), type, type + 4);
+    file.insert(file.end(), data.begin(), data.end());
+    ::uLong crc = ::crc32(
+      0, file.data() + typeStart, static_cast<::uInt>(file.size() - typeStart)
+    );
+    appendBigEndian(file, static_cast<std::uint32_t>(crc));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Saves a frame as PNG file and extracts its compressed image data</summary>
+  /// <param name="frame">Frame that will be compressed</param>
+  /// <param name="header">Receives the contents of the PNG file's IHDR chunk</param>
+  /// <returns>The compressed image data of the frame</returns>
+  std::vector<std::uint8_t> compressFrame(
+    const TestFrame &frame, std::vector<std::uint8_t> &header
+  ) {
+    using Nuclex::Pixels::Bitmap;
+    using Nuclex::Pixels::BitmapMemory;
+    using Nuclex::Pixels::PixelFormat;
+
+    Bitmap bitmap(frame.Width, frame.Height, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = bitmap.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          std::memcpy(row + x * 4, frame.Color, 4);
+        }
+      }
+    }
+
+    MemoryBufferFile file;
+    Nuclex::Pixels::Storage::BitmapSerializer().Save(bitmap, file, u8"png");
+
+    // Walk the chunks of the PNG file and collect the contents of its IDAT chunks
+    const std::vector<std::uint8_t> &contents = file.GetContents();
+    std::vector<std::uint8_t> imageData;
+    std::size_t position = 8;
+    while(position + 12 <= contents.size()) {
+      std::size_t byteCount = (
+        (static_cast<std::size_t>(contents[position]) << 24) |
+        (static_cast<std::size_t>(contents[position + 1]) << 16) |
+        (static_cast<std::size_t>(contents[position + 2]) << 8) |
+        static_cast<std::size_t>(contents[position + 3])
+      );
+      const std::uint8_t *type = contents.data() + position + 4;
+      const std::uint8_t *data = type + 4;
+      if(std::memcmp(type, "IHDR", 4) == 0) {
+        header.assign(data, data + byteCount);
+      } else if(std::memcmp(type, "IDAT", 4) == 0) {
+        imageData.insert(imageData.end(), data, data + byteCount);
+      }
+      position += 12 + byteCount;
+    }
+
+    return imageData;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an APNG file from a set of solid-colored frames</summary>
+  /// <param name="width">Width of the animation's canvas</param>
+  /// <param name="height">Height of the animation's canvas</param>
+  /// <param name="frames">Frames of the animation</param>
+  /// <param name="frameCount">Number of frames in the animation</param>
+  /// <returns>The contents of the APNG file</returns>
+  std::vector<std::uint8_t> buildApng(
+    std::uint32_t width, std::uint32_t height, const TestFrame *frames, std::size_t frameCount
+  ) {
+    static const std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    std::vector<std::uint8_t> file(signature, signature + 8);
+
+    std::uint32_t sequenceNumber = 0;
+    for(std::size_t index = 0; index < frameCount; ++index) {
+      const TestFrame &frame = frames[index];
+
+      std::vector<std::uint8_t> header;
+      std::vector<std::uint8_t> imageData = compressFrame(frame, header);
+      if(index == 0) {
+        std::vector<std::uint8_t> canvasHeader;
+        appendBigEndian(canvasHeader, width);
+        appendBigEndian(canvasHeader, height);
+        canvasHeader.insert(canvasHeader.end(), header.begin() + 8, header.end());
+        appendChunk(file, "IHDR", canvasHeader);
+
+        std::vector<std::uint8_t> animationControl;
+        appendBigEndian(animationControl, static_cast<std::uint32_t>(frameCount));
+        appendBigEndian(animationControl, 3); // Play three times
+        appendChunk(file, "acTL", animationControl);
+      }
+
+      std::vector<std::uint8_t> frameControl;
+      appendBigEndian(frameControl, sequenceNumber++);
+      appendBigEndian(frameControl, frame.Width);
+      appendBigEndian(frameControl, frame.Height);
+      appendBigEndian(frameControl, frame.X);
+      appendBigEndian(frameControl, frame.Y);
+      frameControl.push_back(0); // Delay numerator, big endian 16 bit
+      frameControl.push_back(static_cast<std::uint8_t>(index + 1));
+      frameControl.push_back(0); // Delay denominator, big endian 16 bit
+      frameControl.push_back(10);
+      frameControl.push_back(frame.DisposeOperation);
+      frameControl.push_back(frame.BlendOperation);
+      appendChunk(file, "fcTL", frameControl);
+
+      if(index == 0) {
+        appendChunk(file, "IDAT", imageData);
+      } else {
+        std::vector<std::uint8_t> frameData;
+        appendBigEndian(frameData, sequenceNumber++);
+        frameData.insert(frameData.end(), imageData.begin(), imageData.end());
+        appendChunk(file, "fdAT", frameData);
+      }
+    }
+
+    appendChunk(file, "IEND", std::vector<std::uint8_t>());
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the color of a pixel in an RGBA bitmap</summary>
+  /// <param name="bitmap">Bitmap holding the pixel</param>
+  /// <param name="x">X coordinate of the pixel</param>
+  /// <param name="y">Y coordinate of the pixel</param>
+  /// <returns>The pixel's color packed as 0xRRGGBBAA</returns>
+  std::uint32_t getPixel(const Nuclex::Pixels::Bitmap &bitmap, std::size_t x, std::size_t y) {
+    const std::uint8_t *pixel = Nuclex::Pixels::GetPixelAddress(bitmap, x, y);
+    return (
+      (static_cast<std::uint32_t>(pixel[0]) << 24) |
+      (static_cast<std::uint32_t>(pixel[1]) << 16) |
+      (static_cast<std::uint32_t>(pixel[2]) << 8) |
+      static_cast<std::uint32_t>(pixel[3])
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frames of an animation exercising all dispose and blend operations</summary>
+  const TestFrame TestFrames[] = {
+    { 0, 0, 8, 8, { 255, 0, 0, 255 }, 0, 0 }, // Red background, kept
+    { 2, 2, 2, 2, { 0, 255, 0, 255 }, 1, 1 }, // Green square, cleared afterwards
+    { 4, 4, 2, 2, { 0, 0, 255, 128 }, 2, 1 }, // Translucent blue, restored afterwards
+    { 0, 0, 1, 1, { 255, 255, 255, 255 }, 0, 0 }, // White corner pixel
+    { 0, 0, 8, 8, { 0, 0, 0, 255 }, 0, 0 }, // Black, replaces everything
+    { 7, 7, 1, 1, { 255, 255, 0, 255 }, 0, 1 } // Yellow corner pixel
+  };
+
+  /// <summary>Number of frames in the test animation</summary>
+  const std::size_t TestFrameCount = sizeof(TestFrames) / sizeof(TestFrames[0]);
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AnimationReaderTest, ApngFramesCanBeDecoded) {
+    std::vector<std::uint8_t> apng = buildApng(8, 8, TestFrames, TestFrameCount);
+
+    BitmapSerializer serializer;
+    std::unique_ptr<AnimationReader> reader = serializer.OpenAnimation(
+      VirtualFile::FromMemory(apng.data(), apng.size()), u8"png"
+    );
+
+    ASSERT_EQ(reader->GetWidth(), 8U);
+    ASSERT_EQ(reader->GetHeight(), 8U);
+    ASSERT_EQ(reader->GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+    ASSERT_EQ(reader->CountFrames(), TestFrameCount);
+    EXPECT_EQ(reader->GetLoopCount(), 3U);
+
+    const AnimationFrameInfo &secondFrame = reader->GetFrameInfo(1);
+    EXPECT_EQ(secondFrame.Region.MinX, 2U);
+    EXPECT_EQ(secondFrame.Region.MinY, 2U);
+    EXPECT_EQ(secondFrame.Region.MaxX, 4U);
+    EXPECT_EQ(secondFrame.Region.MaxY, 4U);
+    EXPECT_DOUBLE_EQ(secondFrame.Duration, 0.2);
+
+    Bitmap canvas(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    reader->ReloadFrame(canvas, 0);
+    EXPECT_EQ(getPixel(canvas, 2, 2), 0xFF0000FFU);
+
+    reader->ReloadFrame(canvas, 1);
+    EXPECT_EQ(getPixel(canvas, 2, 2), 0x00FF00FFU);
+    EXPECT_EQ(getPixel(canvas, 4, 4), 0xFF0000FFU);
+
+    reader->ReloadFrame(canvas, 2);
+    EXPECT_EQ(getPixel(canvas, 2, 2), 0x00000000U); // Cleared by the previous frame
+    EXPECT_EQ(getPixel(canvas, 4, 4), 0x7F0080FFU); // Blue blended over red
+
+    reader->ReloadFrame(canvas, 3);
+    EXPECT_EQ(getPixel(canvas, 0, 0), 0xFFFFFFFFU);
+    EXPECT_EQ(getPixel(canvas, 2, 2), 0x00000000U);
+    EXPECT_EQ(getPixel(canvas, 4, 4), 0xFF0000FFU); // Restored by the previous frame
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AnimationReaderTest, SeekingStartsAtTheNearestKeyFrame) {
+    std::vector<std::uint8_t> apng = buildApng(8, 8, TestFrames, TestFrameCount);
+
+    BitmapSerializer serializer;
+    std::unique_ptr<AnimationReader> reader = serializer.OpenAnimation(
+      VirtualFile::FromMemory(apng.data(), apng.size()), u8"png"
+    );
+
+    EXPECT_TRUE(reader->GetFrameInfo(0).IsKeyFrame);
+    EXPECT_FALSE(reader->GetFrameInfo(1).IsKeyFrame);
+    EXPECT_FALSE(reader->GetFrameInfo(3).IsKeyFrame);
+    EXPECT_TRUE(reader->GetFrameInfo(4).IsKeyFrame);
+    EXPECT_EQ(reader->FindKeyFrame(3), 0U);
+    EXPECT_EQ(reader->FindKeyFrame(5), 4U);
+
+    // Jumping to a frame has to yield the same canvas as playing up to it
+    Bitmap played(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    Bitmap seeked(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    for(std::size_t frameIndex = 0; frameIndex < TestFrameCount; ++frameIndex) {
+      reader->ReloadFrame(played, frameIndex);
+    }
+    reader->ReloadFrame(seeked, TestFrameCount - 1);
+    for(std::size_t y = 0; y < 8; ++y) {
+      for(std::size_t x = 0; x < 8; ++x) {
+        EXPECT_EQ(getPixel(played, x, y), getPixel(seeked, x, y));
+      }
+    }
+    EXPECT_EQ(getPixel(seeked, 7, 7), 0xFFFF00FFU);
+    EXPECT_EQ(getPixel(seeked, 0, 0), 0x000000FFU);
+
+    // Going backwards also works
+    reader->ReloadFrame(played, 3);
+    EXPECT_EQ(getPixel(played, 0, 0), 0xFFFFFFFFU);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AnimationReaderTest, PngsOpenAsSingleFrameAnimations) {
+    const TestFrame stillFrame = { 0, 0, 5, 3, { 10, 20, 30, 40 }, 0, 0 };
+    std::vector<std::uint8_t> header;
+    std::vector<std::uint8_t> imageData = compressFrame(stillFrame, header);
+
+    static const std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    std::vector<std::uint8_t> png(signature, signature + 8);
+    appendChunk(png, "IHDR", header);
+    appendChunk(png, "IDAT", imageData);
+    appendChunk(png, "IEND", std::vector<std::uint8_t>());
+
+    BitmapSerializer serializer;
+    std::unique_ptr<AnimationReader> reader = serializer.OpenAnimation(
+      VirtualFile::FromMemory(png.data(), png.size())
+    );
+    ASSERT_EQ(reader->CountFrames(), 1U);
+    EXPECT_TRUE(reader->GetFrameInfo(0).IsKeyFrame);
+
+    Bitmap canvas(5, 3, PixelFormat::R8_G8_B8_A8_Unsigned);
+    reader->ReloadFrame(canvas, 0);
+    EXPECT_EQ(getPixel(canvas, 4, 2), 0x0A141E28U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AnimationReaderTest, FramesRequireFittingBitmap) {
+    std::vector<std::uint8_t> apng = buildApng(8, 8, TestFrames, TestFrameCount);
+
+    BitmapSerializer serializer;
+    std::unique_ptr<AnimationReader> reader = serializer.OpenAnimation(
+      VirtualFile::FromMemory(apng.data(), apng.size())
+    );
+
+    Bitmap wrongSize(4, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_THROW(reader->ReloadFrame(wrongSize, 0), std::invalid_argument);
+
+    Bitmap wrongFormat(8, 8, PixelFormat::R8_G8_B8_Unsigned);
+    EXPECT_THROW(reader->ReloadFrame(wrongFormat, 0), std::invalid_argument);
+
+    Bitmap canvas(8, 8, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_THROW(reader->ReloadFrame(canvas, TestFrameCount), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
+
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
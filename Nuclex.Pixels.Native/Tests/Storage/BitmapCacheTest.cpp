@@ -0,0 +1,151 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/BitmapCache.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include <gtest/gtest.h>
+
+#include "TemporaryDirectoryScope.h"
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapCacheTest, RepeatedLoadsShareTheCachedPixels) {
+    BitmapSerializer serializer;
+    BitmapCache cache(serializer);
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string path = temporaryDirectory.GetPath(u8"test.png");
+      serializer.Save(Bitmap(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned), path);
+
+      Bitmap first = cache.Load(path);
+      Bitmap second = cache.Load(path);
+      EXPECT_EQ(first.Access().Pixels, second.Access().Pixels);
+
+      BitmapCache::Statistics statistics = cache.GetStatistics();
+      EXPECT_EQ(statistics.HitCount, 1U);
+      EXPECT_EQ(statistics.MissCount, 1U);
+      EXPECT_EQ(statistics.CachedBitmapCount, 1U);
+      EXPECT_EQ(statistics.CachedByteCount, 16U * 16U * 4U);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapCacheTest, ReplacedFilesAreDecodedAgain) {
+    BitmapSerializer serializer;
+    BitmapCache cache(serializer);
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string path = temporaryDirectory.GetPath(u8"test.png");
+      serializer.Save(Bitmap(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned), path);
+      EXPECT_EQ(cache.Load(path).GetWidth(), 16U);
+
+      serializer.Save(Bitmap(24, 16, PixelFormat::R8_G8_B8_A8_Unsigned), path);
+      EXPECT_EQ(cache.Load(path).GetWidth(), 24U);
+      EXPECT_EQ(cache.GetStatistics().MissCount, 2U);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapCacheTest, LeastRecentlyUsedBitmapsAreDropped) {
+    BitmapSerializer serializer;
+    BitmapCache cache(serializer, 2 * 16 * 16 * 4); // room for two bitmaps
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string paths[3];
+      for(std::size_t index = 0; index < 3; ++index) {
+        paths[index] = temporaryDirectory.GetPath(std::to_string(index) + u8".png");
+        serializer.Save(Bitmap(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned), paths[index]);
+      }
+
+      cache.Load(paths[0]);
+      cache.Load(paths[1]);
+      cache.Load(paths[0]); // hit, the second bitmap is now the least recently used one
+      cache.Load(paths[2]); // drops the second bitmap
+
+      EXPECT_EQ(cache.GetStatistics().CachedBitmapCount, 2U);
+      EXPECT_EQ(cache.GetStatistics().HitCount, 1U);
+
+      cache.Load(paths[0]);
+      EXPECT_EQ(cache.GetStatistics().HitCount, 2U);
+      cache.Load(paths[1]);
+      EXPECT_EQ(cache.GetStatistics().HitCount, 2U);
+      EXPECT_EQ(cache.GetStatistics().MissCount, 4U);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapCacheTest, CallerCanSupplyTheKey) {
+    BitmapSerializer serializer;
+    BitmapCache cache(serializer);
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string path = temporaryDirectory.GetPath(u8"test.png");
+      serializer.Save(Bitmap(16, 8, PixelFormat::R8_G8_B8_A8_Unsigned), path);
+
+      std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(path);
+      Bitmap first = cache.Load(u8"my-key", *file, u8"png");
+      Bitmap second = cache.Load(u8"my-key", *file, u8"png");
+
+      EXPECT_EQ(second.GetHeight(), 8U);
+      EXPECT_EQ(first.Access().Pixels, second.Access().Pixels);
+      EXPECT_EQ(cache.GetStatistics().HitCount, 1U);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapCacheTest, BitmapsExceedingTheBudgetAreNotCached) {
+    BitmapSerializer serializer;
+    BitmapCache cache(serializer, 1024);
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string path = temporaryDirectory.GetPath(u8"test.png");
+      serializer.Save(Bitmap(32, 32, PixelFormat::R8_G8_B8_A8_Unsigned), path);
+
+      EXPECT_EQ(cache.Load(path).GetWidth(), 32U);
+      EXPECT_EQ(cache.GetStatistics().CachedBitmapCount, 0U);
+
+      cache.Clear();
+      EXPECT_EQ(cache.GetStatistics().CachedByteCount, 0U);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
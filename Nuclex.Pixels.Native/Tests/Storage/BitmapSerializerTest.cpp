@@ -23,6 +23,18 @@ License along with this library
 
 #include "Nuclex/Pixels/Storage/BitmapSerializer.h"
 #include "Nuclex/Pixels/Storage/BitmapCodec.h"
+#include "Nuclex/Pixels/Storage/DecodeContext.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+#include "Nuclex/Pixels/Errors/FileAccessError.h"
+#include "Nuclex/Pixels/Half.h"
+#include "Nuclex/Pixels/BitmapResampler.h"
+#include "Nuclex/Pixels/RowStream.h"
+
+#include <cstring> // for std::memset()
+#include <stdexcept> // for std::invalid_argument
+#include <vector> // for std::vector
+
 #include <gtest/gtest.h>
 
 #include "TemporaryDirectoryScope.h"
@@ -64,6 +76,18 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>A 2x2 grayscale PNG stored with Adam7 interlacing</summary>
+  const std::uint8_t interlacedPng[72] = {
+    0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D,
+    0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02,
+    0x08, 0x00, 0x00, 0x00, 0x01, 0x20, 0xDA, 0x62, 0x6E, 0x00, 0x00, 0x00,
+    0x0F, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0x63, 0x10, 0x60, 0x50, 0x60,
+    0x30, 0x70, 0x00, 0x00, 0x01, 0x87, 0x00, 0xA1, 0x1F, 0x44, 0x6D, 0x97,
+    0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>A tiny JPEG file encoding a 1x1 pixel white quare</summary>
   const std::uint8_t verySmallJpeg[283] = {
     0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01,
@@ -199,13 +223,16 @@ namespace {
     /// <summary>Tries to read informations for a bitmap</summary>
     /// <param name="source">Source data from which the informations should be extracted</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>
     ///   Informations about the bitmap, if the codec is able to load it, otherwise
     ///   a BitmapInfo structure with 'Loadable' set to false.
     /// </returns>
     public: Nuclex::Pixels::BitmapInfo TryReadInfo(
       const Nuclex::Pixels::Storage::VirtualFile &source,
-      const std::string &extensionHint = std::string()
+      const std::string &extensionHint = std::string(),
+      const Nuclex::Pixels::Storage::LoadOptions & /* options */ =
+        Nuclex::Pixels::Storage::LoadOptions()
     ) const override { throw -1; }
 
     /// <summary>Checks if the codec is able to load the specified file</summary>
@@ -228,13 +255,16 @@ namespace {
     /// <summary>Tries to load the specified file as a bitmap</summary>
     /// <param name="source">Source data the bitmap will be loaded from</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>
     ///   The bitmap loaded from the specified file data or an empty value if the file format
     ///   is not supported by the codec
     /// </returns>
     public: virtual Nuclex::Pixels::Storage::OptionalBitmap TryLoad(
       const Nuclex::Pixels::Storage::VirtualFile &source,
-      const std::string &extensionHint = std::string()
+      const std::string &extensionHint = std::string(),
+      const Nuclex::Pixels::Storage::LoadOptions & /* options */ =
+        Nuclex::Pixels::Storage::LoadOptions()
     ) const override {
       return Nuclex::Pixels::Storage::OptionalBitmap();
     }
@@ -245,19 +275,25 @@ namespace {
     /// </param>
     /// <param name="source">Source data the bitmap will be loaded from</param>
     /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
     /// <returns>True if the codec was able to load the bitmap, false otherwise</returns>
     public: bool TryReload(
       Nuclex::Pixels::Bitmap &exactlyFittingBitmap,
       const Nuclex::Pixels::Storage::VirtualFile &source,
-      const std::string &extensionHint = std::string()
+      const std::string &extensionHint = std::string(),
+      const Nuclex::Pixels::Storage::LoadOptions & /* options */ =
+        Nuclex::Pixels::Storage::LoadOptions()
     ) const override { throw -1; }
 
     /// <summary>Saves the specified bitmap into a file</summary>
     /// <param name="bitmap">Bitmap that will be saved into a file</param>
     /// <param name="target">File into which the bitmap will be saved</param>
+    /// <param name="options">Settings controlling how the file will be written</param>
     public: void Save(
       const Nuclex::Pixels::Bitmap &bitmap,
-      Nuclex::Pixels::Storage::VirtualFile &target
+      Nuclex::Pixels::Storage::VirtualFile &target,
+      const Nuclex::Pixels::Storage::SaveOptions & /* options */ =
+        Nuclex::Pixels::Storage::SaveOptions()
     ) const override {
 
     }
@@ -269,6 +305,37 @@ namespace {
 
   };
 
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Dummy codec that rejects all file headers and must never be asked to load</summary>
+  class HeaderRejectingBitmapCodec : public DummyBitmapCodec {
+
+    /// <summary>Rejects any file header it is shown</summary>
+    /// <param name="fileHeader">The first bytes of the file that will be checked</param>
+    /// <param name="fileHeaderByteCount">Number of bytes in the file header</param>
+    /// <returns>Always false</returns>
+    public: bool IsValidFileHeader(
+      const std::uint8_t * /* fileHeader */, std::size_t /* fileHeaderByteCount */
+    ) const override {
+      return false;
+    }
+
+    /// <summary>Fails because the serializer should have skipped this codec</summary>
+    /// <param name="source">Source data the bitmap will be loaded from</param>
+    /// <param name="extensionHint">Optional file extension the loaded data had</param>
+    /// <param name="options">Settings controlling how the file will be read</param>
+    /// <returns>Nothing, always throws</returns>
+    public: Nuclex::Pixels::Storage::OptionalBitmap TryLoad(
+      const Nuclex::Pixels::Storage::VirtualFile & /* source */,
+      const std::string & /* extensionHint */ = std::string(),
+      const Nuclex::Pixels::Storage::LoadOptions & /* options */ =
+        Nuclex::Pixels::Storage::LoadOptions()
+    ) const override {
+      throw std::logic_error(u8"Codec rejecting the file header was asked to load the file");
+    }
+
+  };
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Pixels { namespace Storage {
@@ -283,6 +350,30 @@ namespace Nuclex { namespace Pixels { namespace Storage {
     );
   }
 
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, CodecsRejectingFileHeaderAreSkipped) {
+    BitmapSerializer store;
+    store.RegisterCodec(std::make_unique<HeaderRejectingBitmapCodec>());
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      // This PNG has the extension of the header-rejecting codec, so the serializer
+      // would try that codec first if it didn't check the file header
+      temporaryDirectory.WriteFullFile(
+        u8"test.dummy",
+        std::string(reinterpret_cast<const char *>(testPng), sizeof(testPng))
+      );
+
+      std::string testPath = temporaryDirectory.GetPath(u8"test.dummy");
+      Bitmap bitmap = store.Load(testPath);
+
+      EXPECT_EQ(bitmap.GetWidth(), 17);
+      EXPECT_EQ(bitmap.GetHeight(), 7);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
   // ------------------------------------------------------------------------------------------- //
 #if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
   TEST(BitmapSerializerTest, PngCanBeLoadedByPath) {
@@ -404,5 +495,1781 @@ namespace Nuclex { namespace Pixels { namespace Storage {
   }
 #endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
   // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngsCanBeLoadedFromMemory) {
+    BitmapSerializer store;
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(testPng, sizeof(testPng));
+    Bitmap bitmap = store.Load(*file, u8"png");
+
+    EXPECT_EQ(bitmap.GetWidth(), 17);
+    EXPECT_EQ(bitmap.GetHeight(), 7);
+    EXPECT_EQ(bitmap.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngChecksumsCanBeSkippedForTrustedFiles) {
+    BitmapSerializer store;
+
+    // Damage the CRC of the IDAT chunk, which ends right before the IEND chunk
+    std::vector<std::uint8_t> damagedPng(testPng, testPng + sizeof(testPng));
+    damagedPng[sizeof(testPng) - 14] ^= 0xFF;
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(
+      damagedPng.data(), damagedPng.size()
+    );
+
+    EXPECT_ANY_THROW(store.Load(*file, u8"png"));
+
+    LoadOptions options;
+    options.Png.VerifyChecksums = false;
+    Bitmap trusted = store.Load(*file, u8"png", options);
+    Bitmap original = store.Load(*VirtualFile::FromMemory(testPng, sizeof(testPng)), u8"png");
+
+    ASSERT_EQ(trusted.GetWidth(), 17);
+    ASSERT_EQ(trusted.GetHeight(), 7);
+    const BitmapMemory &trustedMemory = trusted.Access();
+    const BitmapMemory &originalMemory = original.Access();
+    for(std::size_t y = 0; y < 7; ++y) {
+      EXPECT_EQ(
+        std::memcmp(
+          static_cast<const std::uint8_t *>(trustedMemory.Pixels) + (y * trustedMemory.Stride),
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + (y * originalMemory.Stride),
+          17 * 4
+        ),
+        0
+      );
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, JpegsCanBeLoadedFromMemory) {
+    BitmapSerializer store;
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(testJpeg, sizeof(testJpeg));
+    Bitmap bitmap = store.Load(*file, u8"jpg");
+
+    EXPECT_EQ(bitmap.GetWidth(), 17);
+    EXPECT_EQ(bitmap.GetHeight(), 7);
+    EXPECT_EQ(bitmap.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, TruncatedJpegsAreLoadedUpToWhereTheyEnd) {
+    BitmapSerializer store;
+
+    // libjpeg fills in the missing part of the image, like it does for files on disk
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(
+      testJpeg, sizeof(testJpeg) - 40
+    );
+    Bitmap bitmap = store.Load(*file, u8"jpg");
+
+    EXPECT_EQ(bitmap.GetWidth(), 17);
+    EXPECT_EQ(bitmap.GetHeight(), 7);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, InfoCanBeReadWithoutLoadingTheBitmap) {
+    BitmapSerializer store;
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      temporaryDirectory.WriteFullFile(
+        u8"test.png",
+        std::string(reinterpret_cast<const char *>(testPng),  sizeof(testPng))
+      );
+
+      BitmapInfo info = store.TryReadInfo(temporaryDirectory.GetPath(u8"test.png"));
+      EXPECT_TRUE(info.Loadable);
+      EXPECT_EQ(info.Width, 17);
+      EXPECT_EQ(info.Height, 7);
+      EXPECT_EQ(info.PixelFormat, PixelFormat::R8_G8_B8_A8_Unsigned);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, BitmapsCanBeLoadedLazily) {
+    BitmapSerializer store;
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      temporaryDirectory.WriteFullFile(
+        u8"test.png",
+        std::string(reinterpret_cast<const char *>(testPng),  sizeof(testPng))
+      );
+
+      LazyBitmap lazyBitmap = store.LoadLazily(temporaryDirectory.GetPath(u8"test.png"));
+      EXPECT_FALSE(lazyBitmap.IsLoaded());
+      EXPECT_EQ(lazyBitmap.GetWidth(), 17);
+      EXPECT_EQ(lazyBitmap.GetHeight(), 7);
+      EXPECT_EQ(lazyBitmap.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+
+      const BitmapMemory &memory = lazyBitmap.Access();
+      EXPECT_TRUE(lazyBitmap.IsLoaded());
+      EXPECT_EQ(memory.Width, 17);
+      EXPECT_EQ(memory.Height, 7);
+
+      // After unloading, the file is opened again and decoded on the next access
+      lazyBitmap.Unload();
+      EXPECT_FALSE(lazyBitmap.IsLoaded());
+      EXPECT_EQ(lazyBitmap.GetBitmap().GetWidth(), 17);
+      EXPECT_TRUE(lazyBitmap.IsLoaded());
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, BitmapsCanBeLoadedLazilyFromMemory) {
+    BitmapSerializer store;
+
+    LazyBitmap lazyBitmap = store.LoadLazily(
+      VirtualFile::FromMemory(testJpeg, sizeof(testJpeg)), u8"jpg"
+    );
+    EXPECT_FALSE(lazyBitmap.IsLoaded());
+    EXPECT_EQ(lazyBitmap.GetWidth(), 17);
+    EXPECT_EQ(lazyBitmap.GetHeight(), 7);
+
+    LazyBitmap movedBitmap = std::move(lazyBitmap);
+    EXPECT_EQ(movedBitmap.GetBitmap().GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+  TEST(BitmapSerializerTest, LoadingUnsupportedFilesLazilyThrowsException) {
+    static const std::uint8_t garbage[] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0 };
+    BitmapSerializer store;
+
+    EXPECT_FALSE(store.TryReadInfo(*VirtualFile::FromMemory(garbage, sizeof(garbage))).Loadable);
+    EXPECT_THROW(
+      store.LoadLazily(VirtualFile::FromMemory(garbage, sizeof(garbage))),
+      Errors::FileFormatError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSerializerTest, FilesResemblingImagesAreRejectedWithoutExceptions) {
+    BitmapSerializer store;
+
+    // Files as they turn up when scanning a directory of mixed files, beginning like
+    // an image file but turning out to be something else or to be broken
+    static const char pngStart[16] = {
+      '\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n', 0, 0, 0, 13, 'I', 'H', 'D', 'R'
+    };
+    std::vector<std::string> resemblingFiles;
+    resemblingFiles.push_back(std::string(u8"BMW service intervals\n") + std::string(64, '-'));
+    resemblingFiles.push_back(std::string(u8"P6 \ttable of contents\n") + std::string(64, '-'));
+    resemblingFiles.push_back(std::string(u8"qoif") + std::string(64, '\xFF'));
+    resemblingFiles.push_back(std::string(pngStart, 16) + std::string(64, '\0'));
+    resemblingFiles.push_back(
+      std::string(reinterpret_cast<const char *>(testJpeg), 20) + std::string(200, '\0')
+    );
+
+    for(const std::string &contents : resemblingFiles) {
+      std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(
+        reinterpret_cast<const std::uint8_t *>(contents.data()), contents.size()
+      );
+
+      BitmapInfo info;
+      info.Loadable = true;
+      EXPECT_NO_THROW(info = store.TryReadInfo(*file));
+      EXPECT_FALSE(info.Loadable);
+      EXPECT_NO_THROW(store.CanLoad(*file));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngsCanBeSavedAndLoadedAgain) {
+    BitmapSerializer store;
+
+    Bitmap original(23, 11, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 7 + y * 13);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testPngPath = temporaryDirectory.GetPath(u8"saved.png");
+      store.Save(original, testPngPath);
+      Bitmap loaded = store.Load(testPngPath);
+
+      ASSERT_EQ(loaded.GetWidth(), 23);
+      ASSERT_EQ(loaded.GetHeight(), 11);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+
+      const BitmapMemory &originalMemory = original.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      for(std::size_t y = 0; y < originalMemory.Height; ++y) {
+        const std::uint8_t *originalRow = (
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + originalMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < originalMemory.Width * 4; ++x) {
+          EXPECT_EQ(originalRow[x], loadedRow[x]);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngCompressionCanFavorSpeedOrSize) {
+    BitmapSerializer store;
+
+    // BGR is not a PNG pixel format, so this also checks that libpng swaps the channels
+    Bitmap original(64, 64, PixelFormat::B8_G8_R8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 3 + 0] = static_cast<std::uint8_t>(x * 4);
+          row[x * 3 + 1] = static_cast<std::uint8_t>(y * 4);
+          row[x * 3 + 2] = static_cast<std::uint8_t>(x + y);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions fastOptions;
+      fastOptions.Png = PngSaveOptions::Fast();
+      std::string fastPngPath = temporaryDirectory.GetPath(u8"fast.png");
+      store.Save(original, fastPngPath, std::string(), fastOptions);
+
+      SaveOptions smallOptions;
+      smallOptions.Png = PngSaveOptions::Small();
+      std::string smallPngPath = temporaryDirectory.GetPath(u8"small.png");
+      store.Save(original, smallPngPath, std::string(), smallOptions);
+
+      EXPECT_LT(
+        temporaryDirectory.ReadFullFile(u8"small.png").length(),
+        temporaryDirectory.ReadFullFile(u8"fast.png").length()
+      );
+
+      Bitmap fastBitmap = store.Load(fastPngPath);
+      Bitmap smallBitmap = store.Load(smallPngPath);
+      ASSERT_EQ(fastBitmap.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+      ASSERT_EQ(smallBitmap.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+
+      const BitmapMemory &fastMemory = fastBitmap.Access();
+      const BitmapMemory &smallMemory = smallBitmap.Access();
+      for(std::size_t y = 0; y < 64; ++y) {
+        const std::uint8_t *fastRow = (
+          static_cast<const std::uint8_t *>(fastMemory.Pixels) + fastMemory.Stride * y
+        );
+        const std::uint8_t *smallRow = (
+          static_cast<const std::uint8_t *>(smallMemory.Pixels) + smallMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < 64; ++x) {
+          EXPECT_EQ(fastRow[x * 3 + 0], static_cast<std::uint8_t>(x + y));
+          EXPECT_EQ(fastRow[x * 3 + 1], static_cast<std::uint8_t>(y * 4));
+          EXPECT_EQ(fastRow[x * 3 + 2], static_cast<std::uint8_t>(x * 4));
+        }
+        for(std::size_t x = 0; x < 64 * 3; ++x) {
+          EXPECT_EQ(fastRow[x], smallRow[x]);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngsCanBeSavedInParallel) {
+    BitmapSerializer store;
+    ThreadPool threadPool(4);
+
+    // Large enough to be split into several strips, BGR also needs its channels swapped
+    Bitmap colorOriginal(600, 1500, PixelFormat::B8_G8_R8_Unsigned);
+    Bitmap grayOriginal(1000, 1000, PixelFormat::R16_Unsigned_Native16);
+    {
+      const BitmapMemory &memory = colorOriginal.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 3 + 0] = static_cast<std::uint8_t>(x);
+          row[x * 3 + 1] = static_cast<std::uint8_t>(y);
+          row[x * 3 + 2] = static_cast<std::uint8_t>((x * y) ^ (y >> 3));
+        }
+      }
+    }
+    {
+      const BitmapMemory &memory = grayOriginal.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint16_t *row = reinterpret_cast<std::uint16_t *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x] = static_cast<std::uint16_t>(x * 61 + y * 17);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions colorOptions;
+      colorOptions.Png.ThreadPool = &threadPool;
+      std::string colorPngPath = temporaryDirectory.GetPath(u8"color.png");
+      store.Save(colorOriginal, colorPngPath, std::string(), colorOptions);
+
+      // The 16 bit image is compared against the same image written by libpng
+      SaveOptions grayOptions;
+      grayOptions.Png = PngSaveOptions::Fast();
+      std::string serialPngPath = temporaryDirectory.GetPath(u8"serial.png");
+      store.Save(grayOriginal, serialPngPath, std::string(), grayOptions);
+      grayOptions.Png.ThreadPool = &threadPool;
+      std::string grayPngPath = temporaryDirectory.GetPath(u8"gray.png");
+      store.Save(grayOriginal, grayPngPath, std::string(), grayOptions);
+
+      Bitmap colorBitmap = store.Load(colorPngPath);
+      ASSERT_EQ(colorBitmap.GetWidth(), 600);
+      ASSERT_EQ(colorBitmap.GetHeight(), 1500);
+      ASSERT_EQ(colorBitmap.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+
+      const BitmapMemory &originalColorMemory = colorOriginal.Access();
+      const BitmapMemory &colorMemory = colorBitmap.Access();
+      std::size_t colorMismatchCount = 0;
+      for(std::size_t y = 0; y < colorMemory.Height; ++y) {
+        const std::uint8_t *originalRow = (
+          static_cast<const std::uint8_t *>(originalColorMemory.Pixels) +
+          originalColorMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(colorMemory.Pixels) + colorMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < colorMemory.Width; ++x) {
+          colorMismatchCount += (originalRow[x * 3 + 0] != loadedRow[x * 3 + 2]);
+          colorMismatchCount += (originalRow[x * 3 + 1] != loadedRow[x * 3 + 1]);
+          colorMismatchCount += (originalRow[x * 3 + 2] != loadedRow[x * 3 + 0]);
+        }
+      }
+      EXPECT_EQ(colorMismatchCount, 0U);
+
+      Bitmap grayBitmap = store.Load(grayPngPath);
+      ASSERT_EQ(grayBitmap.GetWidth(), 1000);
+      ASSERT_EQ(grayBitmap.GetHeight(), 1000);
+      ASSERT_EQ(grayBitmap.GetPixelFormat(), PixelFormat::R16_Unsigned_Native16);
+
+      Bitmap serialBitmap = store.Load(serialPngPath);
+      const BitmapMemory &serialMemory = serialBitmap.Access();
+      const BitmapMemory &grayMemory = grayBitmap.Access();
+      std::size_t grayMismatchCount = 0;
+      for(std::size_t y = 0; y < grayMemory.Height; ++y) {
+        grayMismatchCount += (0 != std::memcmp(
+          static_cast<const std::uint8_t *>(serialMemory.Pixels) + serialMemory.Stride * y,
+          static_cast<const std::uint8_t *>(grayMemory.Pixels) + grayMemory.Stride * y,
+          grayMemory.Width * 2
+        ));
+      }
+      EXPECT_EQ(grayMismatchCount, 0U);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngsCanBeLoadedProgressively) {
+    BitmapSerializer store;
+
+    Bitmap original(31, 19, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 5 + y * 11);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testPngPath = temporaryDirectory.GetPath(u8"progressive.png");
+      store.Save(original, testPngPath);
+
+      // Feed the file in tiny chunks so the rows trickle in one by one
+      std::size_t reportedRowCount = 0;
+      std::size_t nextRow = 0;
+      LoadOptions options;
+      options.Png.ChunkSize = 16;
+      options.Png.RowDecoded = [&](const BitmapMemory &memory, std::size_t row, int pass) {
+        EXPECT_EQ(memory.Width, 31);
+        EXPECT_EQ(memory.Height, 19);
+        EXPECT_EQ(row, nextRow);
+        EXPECT_EQ(pass, 0);
+        ++reportedRowCount;
+        ++nextRow;
+      };
+      Bitmap loaded = store.Load(testPngPath, options);
+
+      EXPECT_EQ(reportedRowCount, 19);
+      ASSERT_EQ(loaded.GetWidth(), 31);
+      ASSERT_EQ(loaded.GetHeight(), 19);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+
+      const BitmapMemory &originalMemory = original.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      for(std::size_t y = 0; y < originalMemory.Height; ++y) {
+        const std::uint8_t *originalRow = (
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + originalMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < originalMemory.Width * 4; ++x) {
+          EXPECT_EQ(originalRow[x], loadedRow[x]);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngsCanBeLoadedFromMemoryMappedFiles) {
+    BitmapSerializer store;
+
+    Bitmap original(23, 11, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 11 + y * 3);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testPngPath = temporaryDirectory.GetPath(u8"mapped.png");
+      store.Save(original, testPngPath);
+
+      std::unique_ptr<const VirtualFile> file = (
+        VirtualFile::OpenMemoryMappedFileForReading(testPngPath)
+      );
+      Bitmap loaded = store.Load(*file, u8"png");
+
+      ASSERT_EQ(loaded.GetWidth(), 23);
+      ASSERT_EQ(loaded.GetHeight(), 11);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+
+      const BitmapMemory &originalMemory = original.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      for(std::size_t y = 0; y < originalMemory.Height; ++y) {
+        const std::uint8_t *originalRow = (
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + originalMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < originalMemory.Width * 4; ++x) {
+          EXPECT_EQ(originalRow[x], loadedRow[x]);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngRegionsCanBeLoaded) {
+    BitmapSerializer store;
+
+    Bitmap original(23, 11, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 7 + y * 13);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testPngPath = temporaryDirectory.GetPath(u8"region.png");
+      store.Save(original, testPngPath);
+
+      LoadOptions options;
+      options.Region = Rectangle::FromPositionAndSize(3, 2, 10, 5);
+
+      BitmapInfo info = store.TryReadInfo(testPngPath, options);
+      EXPECT_EQ(info.Width, 10U);
+      EXPECT_EQ(info.Height, 5U);
+
+      Bitmap loaded = store.Load(testPngPath, options);
+      ASSERT_EQ(loaded.GetWidth(), 10);
+      ASSERT_EQ(loaded.GetHeight(), 5);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+
+      const BitmapMemory &memory = loaded.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        const std::uint8_t *row = (
+          static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          EXPECT_EQ(row[x], static_cast<std::uint8_t>((x + 12) * 7 + (y + 2) * 13));
+        }
+      }
+
+      // Regions that don't overlap the image at all are an error
+      options.Region = Rectangle::FromPositionAndSize(30, 0, 4, 4);
+      EXPECT_THROW(store.Load(testPngPath, options), std::invalid_argument);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngsCanBeReloadedIntoAtlas) {
+    BitmapSerializer store;
+
+    Bitmap original(23, 11, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 7 + y * 13 + 1);
+        }
+      }
+    }
+
+    Bitmap atlas(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned);
+    const BitmapMemory &atlasMemory = atlas.Access();
+    for(std::size_t y = 0; y < atlasMemory.Height; ++y) {
+      std::memset(
+        static_cast<std::uint8_t *>(atlasMemory.Pixels) + atlasMemory.Stride * y,
+        0, atlasMemory.Width * 4
+      );
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testPngPath = temporaryDirectory.GetPath(u8"sprite.png");
+      store.Save(original, testPngPath);
+
+      // Decode the whole image into one cell of the atlas and a region into another
+      Bitmap wholeCell = atlas.GetView(20, 10, 23, 11);
+      store.Reload(wholeCell, testPngPath);
+
+      LoadOptions options;
+      options.Region = Rectangle::FromPositionAndSize(5, 4, 8, 3);
+      Bitmap regionCell = atlas.GetView(50, 0, 8, 3);
+      store.Reload(regionCell, testPngPath, options);
+    }
+
+    for(std::size_t y = 0; y < atlasMemory.Height; ++y) {
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(atlasMemory.Pixels) + atlasMemory.Stride * y
+      );
+      for(std::size_t x = 0; x < atlasMemory.Width * 4; ++x) {
+        std::size_t pixelX = x / 4;
+        std::uint8_t expected = 0;
+        if((pixelX >= 20) && (pixelX < 43) && (y >= 10) && (y < 21)) {
+          expected = static_cast<std::uint8_t>((x - 80) * 7 + (y - 10) * 13 + 1);
+        } else if((pixelX >= 50) && (pixelX < 58) && (y < 3)) {
+          expected = static_cast<std::uint8_t>((x - 180) * 7 + (y + 4) * 13 + 1);
+        }
+        EXPECT_EQ(row[x], expected);
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngsCanBeLoadedIntoExternalMemory) {
+    BitmapSerializer store;
+
+    Bitmap original(37, 9, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 3 + y * 11 + 5);
+        }
+      }
+    }
+
+    TemporaryDirectoryScope temporaryDirectory;
+    std::string testPngPath = temporaryDirectory.GetPath(u8"upload.png");
+    store.Save(original, testPngPath);
+
+    // Lay the memory out like an upload buffer with rows aligned to 256 bytes
+    BitmapInfo info = store.TryReadInfo(testPngPath);
+    ASSERT_TRUE(info.Loadable);
+
+    BitmapMemory target;
+    target.Width = info.Width;
+    target.Height = info.Height;
+    target.PixelFormat = info.PixelFormat;
+    target.Stride = Bitmap::CalculateStride(info.Width, info.PixelFormat, 256);
+    EXPECT_EQ(target.Stride, 256);
+
+    std::vector<std::uint8_t> uploadBuffer(target.Stride * target.Height, 0xCC);
+    target.Pixels = uploadBuffer.data();
+    store.LoadInto(target, testPngPath);
+
+    for(std::size_t y = 0; y < target.Height; ++y) {
+      const std::uint8_t *row = uploadBuffer.data() + target.Stride * y;
+      for(std::size_t x = 0; x < target.Width * 4; ++x) {
+        EXPECT_EQ(row[x], static_cast<std::uint8_t>(x * 3 + y * 11 + 5));
+      }
+      for(std::size_t x = target.Width * 4; x < 256; ++x) {
+        EXPECT_EQ(row[x], 0xCC); // Padding must not be touched
+      }
+    }
+
+    // Memory with rows too short for the image or the wrong size must be rejected
+    target.Stride = 36 * 4;
+    EXPECT_THROW(store.LoadInto(target, testPngPath), std::invalid_argument);
+    target.Stride = 256;
+    target.Width = 36;
+    EXPECT_THROW(store.LoadInto(target, testPngPath), std::runtime_error);
+    target.Pixels = nullptr;
+    EXPECT_THROW(store.LoadInto(target, testPngPath), std::invalid_argument);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, JpegsCanBeSavedAndLoadedAgain) {
+    BitmapSerializer store;
+
+    // Smooth gradient that JPEG can reproduce closely. The bitmap is in BGRA, so it
+    // will be converted to RGB while it is compressed.
+    Bitmap original(40, 24, PixelFormat::B8_G8_R8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 4 + 0] = static_cast<std::uint8_t>(64 + x * 2);
+          row[x * 4 + 1] = static_cast<std::uint8_t>(128);
+          row[x * 4 + 2] = static_cast<std::uint8_t>(64 + y * 4);
+          row[x * 4 + 3] = static_cast<std::uint8_t>(255);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions saveOptions;
+      saveOptions.Jpeg.Quality = 95;
+      saveOptions.Jpeg.ChromaSubsampling = JpegChromaSubsampling::None;
+      std::string testJpegPath = temporaryDirectory.GetPath(u8"saved.jpg");
+      store.Save(original, testJpegPath, std::string(), saveOptions);
+      Bitmap loaded = store.Load(testJpegPath);
+
+      ASSERT_EQ(loaded.GetWidth(), 40);
+      ASSERT_EQ(loaded.GetHeight(), 24);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+
+      const BitmapMemory &originalMemory = original.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      for(std::size_t y = 0; y < originalMemory.Height; ++y) {
+        const std::uint8_t *originalRow = (
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + originalMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < originalMemory.Width; ++x) {
+          EXPECT_NEAR(originalRow[x * 4 + 2], loadedRow[x * 3 + 0], 8);
+          EXPECT_NEAR(originalRow[x * 4 + 1], loadedRow[x * 3 + 1], 8);
+          EXPECT_NEAR(originalRow[x * 4 + 0], loadedRow[x * 3 + 2], 8);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, JpegCompressionCanFavorSpeedOrSize) {
+    BitmapSerializer store;
+
+    Bitmap original(96, 64, PixelFormat::R8_G8_B8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 3; ++x) {
+          row[x] = static_cast<std::uint8_t>((x * 7) ^ (y * 5));
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions fastOptions;
+      fastOptions.Jpeg = JpegSaveOptions::Fast();
+      std::string fastJpegPath = temporaryDirectory.GetPath(u8"fast.jpg");
+      store.Save(original, fastJpegPath, std::string(), fastOptions);
+
+      SaveOptions smallOptions;
+      smallOptions.Jpeg = JpegSaveOptions::Small();
+      std::string smallJpegPath = temporaryDirectory.GetPath(u8"small.jpg");
+      store.Save(original, smallJpegPath, std::string(), smallOptions);
+
+      EXPECT_LT(
+        temporaryDirectory.ReadFullFile(u8"small.jpg").length(),
+        temporaryDirectory.ReadFullFile(u8"fast.jpg").length()
+      );
+
+      // Both files use the same quality, so they should decode to the same pixels
+      Bitmap fastBitmap = store.Load(fastJpegPath);
+      Bitmap smallBitmap = store.Load(smallJpegPath);
+      ASSERT_EQ(fastBitmap.GetWidth(), 96);
+      ASSERT_EQ(smallBitmap.GetWidth(), 96);
+
+      const BitmapMemory &fastMemory = fastBitmap.Access();
+      const BitmapMemory &smallMemory = smallBitmap.Access();
+      for(std::size_t y = 0; y < 64; ++y) {
+        const std::uint8_t *fastRow = (
+          static_cast<const std::uint8_t *>(fastMemory.Pixels) + fastMemory.Stride * y
+        );
+        const std::uint8_t *smallRow = (
+          static_cast<const std::uint8_t *>(smallMemory.Pixels) + smallMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < 96 * 3; ++x) {
+          EXPECT_NEAR(fastRow[x], smallRow[x], 2);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, JpegsCanBeLoadedAtReducedScale) {
+    BitmapSerializer store;
+
+    // Uniform color, so the downscaled pixels should still have the same color
+    Bitmap original(64, 40, PixelFormat::R8_G8_B8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 3 + 0] = 200;
+          row[x * 3 + 1] = 100;
+          row[x * 3 + 2] = 50;
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testJpegPath = temporaryDirectory.GetPath(u8"scaled.jpg");
+      store.Save(original, testJpegPath);
+
+      LoadOptions halfOptions;
+      halfOptions.Jpeg.Scale = JpegLoadScale::Half;
+      Bitmap half = store.Load(testJpegPath, halfOptions);
+      EXPECT_EQ(half.GetWidth(), 32);
+      EXPECT_EQ(half.GetHeight(), 20);
+
+      LoadOptions eighthOptions;
+      eighthOptions.Jpeg.Scale = JpegLoadScale::Eighth;
+      Bitmap eighth = store.Load(testJpegPath, eighthOptions);
+      ASSERT_EQ(eighth.GetWidth(), 8);
+      ASSERT_EQ(eighth.GetHeight(), 5);
+
+      const BitmapMemory &memory = eighth.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        const std::uint8_t *row = (
+          static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          EXPECT_NEAR(row[x * 3 + 0], 200, 8);
+          EXPECT_NEAR(row[x * 3 + 1], 100, 8);
+          EXPECT_NEAR(row[x * 3 + 2], 50, 8);
+        }
+      }
+
+      // Reloading needs a bitmap matching the reduced size
+      Bitmap quarter(16, 10, PixelFormat::R8_G8_B8_Unsigned);
+      LoadOptions quarterOptions;
+      quarterOptions.Jpeg.Scale = JpegLoadScale::Quarter;
+      store.Reload(quarter, testJpegPath, quarterOptions);
+      EXPECT_THROW(store.Reload(quarter, testJpegPath), std::runtime_error);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, JpegsCanBeLoadedFromMemoryMappedFiles) {
+    BitmapSerializer store;
+
+    Bitmap original(40, 24, PixelFormat::R8_G8_B8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 3; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 5 + y * 9);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testJpegPath = temporaryDirectory.GetPath(u8"mapped.jpg");
+      store.Save(original, testJpegPath);
+
+      // Decoding the same file through either kind of file must give identical pixels
+      Bitmap expected = store.Load(testJpegPath);
+
+      std::unique_ptr<const VirtualFile> file = (
+        VirtualFile::OpenMemoryMappedFileForReading(testJpegPath)
+      );
+      Bitmap loaded = store.Load(*file, u8"jpg");
+
+      ASSERT_EQ(loaded.GetWidth(), 40);
+      ASSERT_EQ(loaded.GetHeight(), 24);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+
+      const BitmapMemory &expectedMemory = expected.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      for(std::size_t y = 0; y < expectedMemory.Height; ++y) {
+        const std::uint8_t *expectedRow = (
+          static_cast<const std::uint8_t *>(expectedMemory.Pixels) + expectedMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < expectedMemory.Width * 3; ++x) {
+          EXPECT_EQ(expectedRow[x], loadedRow[x]);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, JpegRegionsCanBeLoaded) {
+    BitmapSerializer store;
+
+    Bitmap original(40, 24, PixelFormat::R8_G8_B8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 3 + 0] = static_cast<std::uint8_t>(64 + x * 2);
+          row[x * 3 + 1] = static_cast<std::uint8_t>(128);
+          row[x * 3 + 2] = static_cast<std::uint8_t>(64 + y * 4);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions saveOptions;
+      saveOptions.Jpeg.Quality = 95;
+      saveOptions.Jpeg.ChromaSubsampling = JpegChromaSubsampling::None;
+      std::string testJpegPath = temporaryDirectory.GetPath(u8"region.jpg");
+      store.Save(original, testJpegPath, std::string(), saveOptions);
+
+      // The region doesn't start on a block boundary, so the decoder has to crop it
+      LoadOptions options;
+      options.Region = Rectangle::FromPositionAndSize(13, 5, 20, 11);
+
+      BitmapInfo info = store.TryReadInfo(testJpegPath, options);
+      EXPECT_EQ(info.Width, 20U);
+      EXPECT_EQ(info.Height, 11U);
+
+      Bitmap loaded = store.Load(testJpegPath, options);
+      ASSERT_EQ(loaded.GetWidth(), 20);
+      ASSERT_EQ(loaded.GetHeight(), 11);
+
+      // Reloading into a view of a larger bitmap works the same way
+      Bitmap atlas(32, 32, PixelFormat::R8_G8_B8_Unsigned);
+      Bitmap cell = atlas.GetView(7, 9, 20, 11);
+      store.Reload(cell, testJpegPath, options);
+
+      const BitmapMemory &loadedMemory = loaded.Access();
+      const BitmapMemory &cellMemory = cell.Access();
+      for(std::size_t y = 0; y < loadedMemory.Height; ++y) {
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        const std::uint8_t *cellRow = (
+          static_cast<const std::uint8_t *>(cellMemory.Pixels) + cellMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < loadedMemory.Width; ++x) {
+          EXPECT_NEAR(loadedRow[x * 3 + 0], 64 + (x + 13) * 2, 8);
+          EXPECT_NEAR(loadedRow[x * 3 + 1], 128, 8);
+          EXPECT_NEAR(loadedRow[x * 3 + 2], 64 + (y + 5) * 4, 8);
+          EXPECT_EQ(cellRow[x * 3 + 0], loadedRow[x * 3 + 0]);
+          EXPECT_EQ(cellRow[x * 3 + 1], loadedRow[x * 3 + 1]);
+          EXPECT_EQ(cellRow[x * 3 + 2], loadedRow[x * 3 + 2]);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_OPENEXR)
+  TEST(BitmapSerializerTest, ExrsCanBeSavedAndLoadedAgain) {
+    BitmapSerializer store;
+
+    // The bitmap is saved with full precision floats, so it will be loaded as such
+    Bitmap original(21, 13, PixelFormat::R32_G32_B32_A32_Float);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        float *row = reinterpret_cast<float *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 4 + 0] = static_cast<float>(x) / 32.0f;
+          row[x * 4 + 1] = static_cast<float>(y) / 16.0f;
+          row[x * 4 + 2] = 0.5f;
+          row[x * 4 + 3] = 1.0f;
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions saveOptions;
+      saveOptions.Exr.Compression = ExrCompression::Piz;
+      std::string testExrPath = temporaryDirectory.GetPath(u8"saved.exr");
+      store.Save(original, testExrPath, std::string(), saveOptions);
+      Bitmap loaded = store.Load(testExrPath);
+
+      ASSERT_EQ(loaded.GetWidth(), 21);
+      ASSERT_EQ(loaded.GetHeight(), 13);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R32_G32_B32_A32_Float);
+
+      const BitmapMemory &originalMemory = original.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      for(std::size_t y = 0; y < originalMemory.Height; ++y) {
+        const float *originalRow = reinterpret_cast<const float *>(
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + originalMemory.Stride * y
+        );
+        const float *loadedRow = reinterpret_cast<const float *>(
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < originalMemory.Width * 4; ++x) {
+          EXPECT_EQ(originalRow[x], loadedRow[x]);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_OPENEXR)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_OPENEXR)
+  TEST(BitmapSerializerTest, ExrRegionsCanBeLoaded) {
+    BitmapSerializer store;
+
+    // Each pixel stores its own coordinates, so the loaded region can be verified
+    Bitmap original(40, 30, PixelFormat::R16_G16_B16_A16_Float);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint16_t *row = reinterpret_cast<std::uint16_t *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 4 + 0] = Half::BitsFromFloat(static_cast<float>(x));
+          row[x * 4 + 1] = Half::BitsFromFloat(static_cast<float>(y));
+          row[x * 4 + 2] = Half::BitsFromFloat(0.0f);
+          row[x * 4 + 3] = Half::BitsFromFloat(1.0f);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testExrPath = temporaryDirectory.GetPath(u8"region.exr");
+      store.Save(original, testExrPath);
+
+      // The region extends past the image on the right, so it should be clipped
+      LoadOptions options;
+      options.Exr.ThreadCount = 2;
+      options.Region = Rectangle::FromPositionAndSize(5, 7, 50, 10);
+      Bitmap loaded = store.Load(testExrPath, options);
+
+      ASSERT_EQ(loaded.GetWidth(), 35);
+      ASSERT_EQ(loaded.GetHeight(), 10);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R16_G16_B16_A16_Float);
+
+      const BitmapMemory &memory = loaded.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        const std::uint16_t *row = reinterpret_cast<const std::uint16_t *>(
+          static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          EXPECT_EQ(Half::FloatFromBits(row[x * 4 + 0]), static_cast<float>(x + 5));
+          EXPECT_EQ(Half::FloatFromBits(row[x * 4 + 1]), static_cast<float>(y + 7));
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_OPENEXR)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_OPENEXR)
+  TEST(BitmapSerializerTest, IndividualExrChannelsCanBeLoaded) {
+    BitmapSerializer store;
+
+    // Each channel stores a different value, so the loaded channels can be told apart
+    Bitmap original(16, 12, PixelFormat::R16_G16_B16_A16_Float);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint16_t *row = reinterpret_cast<std::uint16_t *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 4 + 0] = Half::BitsFromFloat(static_cast<float>(x));
+          row[x * 4 + 1] = Half::BitsFromFloat(static_cast<float>(y));
+          row[x * 4 + 2] = Half::BitsFromFloat(0.25f);
+          row[x * 4 + 3] = Half::BitsFromFloat(0.75f);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testExrPath = temporaryDirectory.GetPath(u8"channels.exr");
+      store.Save(original, testExrPath);
+
+      LoadOptions options;
+      options.Exr.Channels.push_back(u8"G");
+      {
+        Bitmap loaded = store.Load(testExrPath, options);
+        ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R16_Float_Native16);
+
+        const BitmapMemory &memory = loaded.Access();
+        for(std::size_t y = 0; y < memory.Height; ++y) {
+          const std::uint16_t *row = reinterpret_cast<const std::uint16_t *>(
+            static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+          );
+          for(std::size_t x = 0; x < memory.Width; ++x) {
+            EXPECT_EQ(Half::FloatFromBits(row[x]), static_cast<float>(y));
+          }
+        }
+      }
+
+      // Channels end up in the order they were listed in, not in the file's order
+      options.Exr.Channels.clear();
+      options.Exr.Channels.push_back(u8"A");
+      options.Exr.Channels.push_back(u8"R");
+      {
+        Bitmap loaded = store.Load(testExrPath, options);
+        ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R16_G16_Float_Native16);
+
+        const BitmapMemory &memory = loaded.Access();
+        for(std::size_t y = 0; y < memory.Height; ++y) {
+          const std::uint16_t *row = reinterpret_cast<const std::uint16_t *>(
+            static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+          );
+          for(std::size_t x = 0; x < memory.Width; ++x) {
+            EXPECT_EQ(Half::FloatFromBits(row[x * 2 + 0]), 0.75f);
+            EXPECT_EQ(Half::FloatFromBits(row[x * 2 + 1]), static_cast<float>(x));
+          }
+        }
+      }
+
+      options.Exr.Channels.clear();
+      options.Exr.Channels.push_back(u8"Z");
+      EXPECT_THROW(store.Load(testExrPath, options), Errors::FileFormatError);
+
+      options.Exr.Channels.clear();
+      options.Exr.Part = 1;
+      EXPECT_THROW(store.Load(testExrPath, options), std::invalid_argument);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_OPENEXR)
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSerializerTest, BlockCompressedDdsCanBeSavedAndLoadedAgain) {
+    BitmapSerializer store;
+
+    // Each byte of a BC1 block stores the block's coordinates and the byte's index
+    Bitmap original(12, 8, PixelFormat::BC1_Compressed);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t blockY = 0; blockY < 2; ++blockY) {
+        std::uint8_t *blockRow = (
+          static_cast<std::uint8_t *>(memory.Pixels) + (memory.Stride * blockY * 4)
+        );
+        for(std::size_t index = 0; index < 3 * 8; ++index) {
+          blockRow[index] = static_cast<std::uint8_t>((blockY << 6) | index);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testDdsPath = temporaryDirectory.GetPath(u8"test.dds");
+      store.Save(original, testDdsPath);
+
+      Bitmap loaded = store.Load(testDdsPath);
+      ASSERT_EQ(loaded.GetWidth(), 12);
+      ASSERT_EQ(loaded.GetHeight(), 8);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::BC1_Compressed);
+      EXPECT_EQ(std::memcmp(loaded.Access().Pixels, original.Access().Pixels, 6 * 8), 0);
+
+      // Regions are loaded as long as they consist of whole blocks
+      LoadOptions options;
+      options.Region = Rectangle::FromPositionAndSize(4, 4, 8, 4);
+      Bitmap region = store.Load(testDdsPath, options);
+      ASSERT_EQ(region.GetWidth(), 8);
+      ASSERT_EQ(region.GetHeight(), 4);
+
+      const std::uint8_t *blockRow = static_cast<const std::uint8_t *>(region.Access().Pixels);
+      for(std::size_t index = 0; index < 2 * 8; ++index) {
+        EXPECT_EQ(blockRow[index], static_cast<std::uint8_t>((1 << 6) | (index + 8)));
+      }
+
+      options.Region = Rectangle::FromPositionAndSize(2, 0, 4, 4);
+      EXPECT_THROW(store.Load(testDdsPath, options), std::runtime_error);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSerializerTest, QoisCanBeSavedAndLoadedAgain) {
+    BitmapSerializer store;
+
+    // The solid rows at the top produce a run spanning multiple rows
+    Bitmap original(23, 11, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          if(y < 3) {
+            row[x] = 128;
+          } else {
+            row[x] = static_cast<std::uint8_t>(x * 7 + y * 13);
+          }
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testQoiPath = temporaryDirectory.GetPath(u8"saved.qoi");
+      store.Save(original, testQoiPath);
+      Bitmap loaded = store.Load(testQoiPath);
+
+      ASSERT_EQ(loaded.GetWidth(), 23);
+      ASSERT_EQ(loaded.GetHeight(), 11);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+
+      const BitmapMemory &originalMemory = original.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      for(std::size_t y = 0; y < originalMemory.Height; ++y) {
+        const std::uint8_t *originalRow = (
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + originalMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < originalMemory.Width * 4; ++x) {
+          EXPECT_EQ(originalRow[x], loadedRow[x]);
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSerializerTest, QoiRegionsCanBeLoaded) {
+    BitmapSerializer store;
+
+    Bitmap original(23, 11, PixelFormat::R8_G8_B8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 3; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 7 + y * 13);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      std::string testQoiPath = temporaryDirectory.GetPath(u8"region.qoi");
+      store.Save(original, testQoiPath);
+
+      LoadOptions options;
+      options.Region = Rectangle::FromPositionAndSize(3, 2, 10, 5);
+
+      Bitmap loaded = store.Load(testQoiPath, options);
+      ASSERT_EQ(loaded.GetWidth(), 10);
+      ASSERT_EQ(loaded.GetHeight(), 5);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+
+      const BitmapMemory &memory = loaded.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        const std::uint8_t *row = (
+          static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+        );
+        for(std::size_t x = 0; x < memory.Width * 3; ++x) {
+          EXPECT_EQ(row[x], static_cast<std::uint8_t>((x + 9) * 7 + (y + 2) * 13));
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+  TEST(BitmapSerializerTest, LosslessWebPsCanBeSavedAndLoadedAgain) {
+    BitmapSerializer store;
+
+    Bitmap original(23, 11, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 7 + y * 13);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions options;
+      options.WebP = WebPSaveOptions::Fast();
+      options.WebP.Lossless = true;
+
+      std::string testWebPPath = temporaryDirectory.GetPath(u8"saved.webp");
+      store.Save(original, testWebPPath, std::string(), options);
+      Bitmap loaded = store.Load(testWebPPath);
+
+      ASSERT_EQ(loaded.GetWidth(), 23);
+      ASSERT_EQ(loaded.GetHeight(), 11);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+
+      const BitmapMemory &originalMemory = original.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      for(std::size_t y = 0; y < originalMemory.Height; ++y) {
+        const std::uint8_t *originalRow = (
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + originalMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < originalMemory.Width * 4; ++x) {
+          EXPECT_EQ(originalRow[x], loadedRow[x]);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+  TEST(BitmapSerializerTest, LossyWebPsStayCloseToTheOriginal) {
+    BitmapSerializer store;
+
+    Bitmap original(32, 16, PixelFormat::R8_G8_B8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 3 + 0] = static_cast<std::uint8_t>(x * 8);
+          row[x * 3 + 1] = static_cast<std::uint8_t>(y * 16);
+          row[x * 3 + 2] = 128;
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions options;
+      options.WebP.Quality = 95;
+
+      std::string testWebPPath = temporaryDirectory.GetPath(u8"lossy.webp");
+      store.Save(original, testWebPPath, std::string(), options);
+      Bitmap loaded = store.Load(testWebPPath);
+
+      ASSERT_EQ(loaded.GetWidth(), 32);
+      ASSERT_EQ(loaded.GetHeight(), 16);
+      ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+
+      const BitmapMemory &originalMemory = original.Access();
+      const BitmapMemory &loadedMemory = loaded.Access();
+      std::size_t totalDifference = 0;
+      for(std::size_t y = 0; y < originalMemory.Height; ++y) {
+        const std::uint8_t *originalRow = (
+          static_cast<const std::uint8_t *>(originalMemory.Pixels) + originalMemory.Stride * y
+        );
+        const std::uint8_t *loadedRow = (
+          static_cast<const std::uint8_t *>(loadedMemory.Pixels) + loadedMemory.Stride * y
+        );
+        for(std::size_t x = 0; x < originalMemory.Width * 3; ++x) {
+          int difference = static_cast<int>(originalRow[x]) - static_cast<int>(loadedRow[x]);
+          totalDifference += static_cast<std::size_t>((difference < 0) ? -difference : difference);
+        }
+      }
+
+      EXPECT_LT(totalDifference / (32 * 16 * 3), 8U);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+  TEST(BitmapSerializerTest, WebPRegionsCanBeLoaded) {
+    BitmapSerializer store;
+
+    Bitmap original(23, 11, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + memory.Stride * y;
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 7 + y * 13);
+        }
+      }
+    }
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      SaveOptions saveOptions;
+      saveOptions.WebP.Lossless = true;
+
+      std::string testWebPPath = temporaryDirectory.GetPath(u8"region.webp");
+      store.Save(original, testWebPPath, std::string(), saveOptions);
+
+      // Regions starting at odd coordinates can't be cropped by libwebp directly
+      const std::size_t regionLefts[] = { 4, 3 };
+      for(std::size_t regionLeft : regionLefts) {
+        LoadOptions options;
+        options.Region = Rectangle::FromPositionAndSize(regionLeft, 2, 10, 5);
+
+        Bitmap loaded = store.Load(testWebPPath, options);
+        ASSERT_EQ(loaded.GetWidth(), 10);
+        ASSERT_EQ(loaded.GetHeight(), 5);
+
+        const BitmapMemory &memory = loaded.Access();
+        for(std::size_t y = 0; y < memory.Height; ++y) {
+          const std::uint8_t *row = (
+            static_cast<const std::uint8_t *>(memory.Pixels) + memory.Stride * y
+          );
+          for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+            EXPECT_EQ(
+              row[x], static_cast<std::uint8_t>((x + regionLeft * 4) * 7 + (y + 2) * 13)
+            );
+          }
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBWEBP)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngDecodeContextCanBeReused) {
+    BitmapSerializer store;
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(testPng, sizeof(testPng));
+    std::unique_ptr<const VirtualFile> smallFile = VirtualFile::FromMemory(
+      verySmallPng, sizeof(verySmallPng)
+    );
+    std::unique_ptr<const VirtualFile> brokenFile = VirtualFile::FromMemory(
+      testPng, sizeof(testPng) / 2
+    );
+    Bitmap expected = store.Load(*file, u8"png");
+
+    DecodeContext context;
+    LoadOptions options;
+    options.Context = &context;
+
+    // Each load reuses the memory of the one before it, including a load that failed
+    for(std::size_t index = 0; index < 3; ++index) {
+      Bitmap small = store.Load(*smallFile, u8"png", options);
+      EXPECT_EQ(small.GetWidth(), 1);
+      EXPECT_EQ(small.GetHeight(), 1);
+
+      EXPECT_ANY_THROW(store.Load(*brokenFile, u8"png", options));
+
+      BitmapInfo info = store.TryReadInfo(*file, u8"png", options);
+      EXPECT_EQ(info.Width, 17U);
+      EXPECT_EQ(info.Height, 7U);
+
+      Bitmap bitmap = store.Load(*file, u8"png", options);
+      ASSERT_EQ(bitmap.GetWidth(), 17);
+      ASSERT_EQ(bitmap.GetHeight(), 7);
+      ASSERT_EQ(bitmap.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+      for(std::size_t y = 0; y < 7; ++y) {
+        const std::uint8_t *expectedRow = (
+          static_cast<const std::uint8_t *>(expected.Access().Pixels) +
+          expected.Access().Stride * y
+        );
+        const std::uint8_t *row = (
+          static_cast<const std::uint8_t *>(bitmap.Access().Pixels) +
+          bitmap.Access().Stride * y
+        );
+        EXPECT_EQ(std::memcmp(row, expectedRow, 17 * 4), 0);
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, JpegDecodeContextCanBeReused) {
+    BitmapSerializer store;
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(testJpeg, sizeof(testJpeg));
+    std::unique_ptr<const VirtualFile> smallFile = VirtualFile::FromMemory(
+      verySmallJpeg, sizeof(verySmallJpeg)
+    );
+    // Clearing the height in the frame header makes libjpeg report an error
+    std::vector<std::uint8_t> brokenJpeg(testJpeg, testJpeg + sizeof(testJpeg));
+    for(std::size_t index = 2; index + 6 < brokenJpeg.size(); ++index) {
+      if((brokenJpeg[index] == 0xFF) && (brokenJpeg[index + 1] == 0xC0)) {
+        brokenJpeg[index + 5] = 0;
+        brokenJpeg[index + 6] = 0;
+        break;
+      }
+    }
+    std::unique_ptr<const VirtualFile> brokenFile = VirtualFile::FromMemory(
+      brokenJpeg.data(), brokenJpeg.size()
+    );
+    Bitmap expected = store.Load(*file, u8"jpg");
+
+    DecodeContext context;
+    LoadOptions options;
+    options.Context = &context;
+
+    // Each load resets and reuses the decompressor, including after a load that failed
+    for(std::size_t index = 0; index < 3; ++index) {
+      Bitmap small = store.Load(*smallFile, u8"jpg", options);
+      EXPECT_EQ(small.GetWidth(), 1);
+      EXPECT_EQ(small.GetHeight(), 1);
+
+      EXPECT_ANY_THROW(store.Load(*brokenFile, u8"jpg", options));
+
+      BitmapInfo info = store.TryReadInfo(*file, u8"jpg", options);
+      EXPECT_EQ(info.Width, 17U);
+      EXPECT_EQ(info.Height, 7U);
+
+      Bitmap bitmap = store.Load(*file, u8"jpg", options);
+      ASSERT_EQ(bitmap.GetWidth(), 17);
+      ASSERT_EQ(bitmap.GetHeight(), 7);
+      ASSERT_EQ(bitmap.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+      for(std::size_t y = 0; y < 7; ++y) {
+        const std::uint8_t *expectedRow = (
+          static_cast<const std::uint8_t *>(expected.Access().Pixels) +
+          expected.Access().Stride * y
+        );
+        const std::uint8_t *row = (
+          static_cast<const std::uint8_t *>(bitmap.Access().Pixels) +
+          bitmap.Access().Stride * y
+        );
+        EXPECT_EQ(std::memcmp(row, expectedRow, 17 * 3), 0);
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BitmapSerializerTest, SavingWithUnknownExtensionThrowsException) {
+    BitmapSerializer store;
+    Bitmap bitmap(4, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      EXPECT_THROW(
+        store.Save(bitmap, temporaryDirectory.GetPath(u8"test.unknown")),
+        Errors::FileFormatError
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, ManyFilesCanBeLoadedInParallel) {
+    BitmapSerializer store;
+    ThreadPool threadPool(4);
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      // Save a bunch of images that can be told apart by their width
+      std::vector<std::string> paths;
+      for(std::size_t index = 0; index < 16; ++index) {
+        Bitmap image(index + 1, 3, PixelFormat::R8_G8_B8_A8_Unsigned);
+        paths.push_back(
+          temporaryDirectory.GetPath(std::string(u8"batch-") + std::to_string(index) + u8".png")
+        );
+        store.Save(image, paths.back());
+      }
+
+      // Each index is only reported once, so each thread writes to its own element
+      std::vector<std::size_t> widths(paths.size(), 0);
+      store.LoadMany(
+        threadPool, paths,
+        [&widths](std::size_t index, const Bitmap &bitmap) {
+          widths[index] = bitmap.GetWidth();
+        }
+      );
+
+      for(std::size_t index = 0; index < widths.size(); ++index) {
+        EXPECT_EQ(widths[index], index + 1);
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+  TEST(BitmapSerializerTest, LoadingManyFilesReportsErrors) {
+    BitmapSerializer store;
+    ThreadPool threadPool(2);
+
+    std::vector<std::string> paths;
+    paths.push_back(u8"does-not-exist-1.png");
+    paths.push_back(u8"does-not-exist-2.png");
+
+    EXPECT_THROW(
+      store.LoadMany(threadPool, paths, [](std::size_t, const Bitmap &) {}),
+      Errors::FileAccessError
+    );
+  }
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG) && defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, SerializerCanBeSharedBetweenThreads) {
+    BitmapSerializer store;
+    ThreadPool threadPool(4);
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+
+      // Alternate between PNGs and JPEGs without extensions, so every load has to
+      // go through the codec detection and keeps updating the most recently used codecs
+      std::vector<std::string> paths;
+      for(std::size_t index = 0; index < 64; ++index) {
+        std::string name = std::string(u8"mixed-") + std::to_string(index);
+        if((index % 2) == 0) {
+          temporaryDirectory.WriteFullFile(
+            name, std::string(reinterpret_cast<const char *>(testPng), sizeof(testPng))
+          );
+        } else {
+          temporaryDirectory.WriteFullFile(
+            name, std::string(reinterpret_cast<const char *>(testJpeg), sizeof(testJpeg))
+          );
+        }
+        paths.push_back(temporaryDirectory.GetPath(name));
+      }
+
+      std::vector<PixelFormat> pixelFormats(paths.size(), PixelFormat::R8_Unsigned);
+      store.LoadMany(
+        threadPool, paths,
+        [&pixelFormats](std::size_t index, const Bitmap &bitmap) {
+          pixelFormats[index] = bitmap.GetPixelFormat();
+        }
+      );
+
+      for(std::size_t index = 0; index < pixelFormats.size(); ++index) {
+        if((index % 2) == 0) {
+          EXPECT_EQ(pixelFormats[index], PixelFormat::R8_G8_B8_A8_Unsigned);
+        } else {
+          EXPECT_EQ(pixelFormats[index], PixelFormat::R8_G8_B8_Unsigned);
+        }
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG) && defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, PngsCanBeStreamedRowByRow) {
+    BitmapSerializer store;
+    Bitmap expected = store.Load(*VirtualFile::FromMemory(testPng, sizeof(testPng)), u8"png");
+
+    {
+      TemporaryDirectoryScope temporaryDirectory;
+      std::string streamedPngPath = temporaryDirectory.GetPath(u8"streamed.png");
+      {
+        std::unique_ptr<RowSource> source = store.OpenRowSource(
+          VirtualFile::FromMemory(testPng, sizeof(testPng)), u8"png"
+        );
+        ASSERT_EQ(source->GetWidth(), 17U);
+        ASSERT_EQ(source->GetHeight(), 7U);
+        ASSERT_EQ(source->GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+
+        std::unique_ptr<RowSink> sink = store.OpenRowSink(
+          streamedPngPath, 17, 7, PixelFormat::R8_G8_B8_A8_Unsigned
+        );
+        TransferRows(*source, *sink);
+      }
+
+      Bitmap streamed = store.Load(streamedPngPath);
+      ASSERT_EQ(streamed.GetWidth(), 17);
+      ASSERT_EQ(streamed.GetHeight(), 7);
+      ASSERT_EQ(streamed.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+      for(std::size_t y = 0; y < 7; ++y) {
+        const std::uint8_t *expectedRow = (
+          static_cast<const std::uint8_t *>(expected.Access().Pixels) +
+          expected.Access().Stride * y
+        );
+        const std::uint8_t *row = (
+          static_cast<const std::uint8_t *>(streamed.Access().Pixels) +
+          streamed.Access().Stride * y
+        );
+        EXPECT_EQ(std::memcmp(row, expectedRow, 17 * 4), 0);
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG) && defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, PngsCanBeStreamedIntoResampledJpegs) {
+    BitmapSerializer store;
+
+    TemporaryDirectoryScope temporaryDirectory;
+    std::string streamedJpegPath = temporaryDirectory.GetPath(u8"streamed.jpg");
+    {
+      std::unique_ptr<RowSource> source = BitmapResampler::ResampleRows(
+        store.OpenRowSource(VirtualFile::FromMemory(testPng, sizeof(testPng))), 9, 4
+      );
+      std::unique_ptr<RowSink> sink = store.OpenRowSink(
+        streamedJpegPath, 9, 4, source->GetPixelFormat()
+      );
+      TransferRows(*source, *sink);
+    }
+
+    BitmapInfo info = store.TryReadInfo(streamedJpegPath);
+    ASSERT_TRUE(info.Loadable);
+    EXPECT_EQ(info.Width, 9U);
+    EXPECT_EQ(info.Height, 4U);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG) && defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, StreamedJpegRowsMatchLoadedJpeg) {
+    BitmapSerializer store;
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(testJpeg, sizeof(testJpeg));
+    Bitmap expected = store.Load(*file, u8"jpg");
+
+    std::unique_ptr<RowSource> source = store.OpenRowSource(
+      VirtualFile::FromMemory(testJpeg, sizeof(testJpeg)), u8"jpg"
+    );
+    ASSERT_EQ(source->GetWidth(), 17U);
+    ASSERT_EQ(source->GetHeight(), 7U);
+    ASSERT_EQ(source->GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+
+    // Read the rows in uneven batches to check that libjpeg's row groups don't matter
+    Bitmap streamed(17, 7, PixelFormat::R8_G8_B8_Unsigned);
+    source->ReadRows(streamed.GetView(0, 0, 17, 3).Access());
+    source->ReadRows(streamed.GetView(0, 3, 17, 4).Access());
+
+    for(std::size_t y = 0; y < 7; ++y) {
+      const std::uint8_t *expectedRow = (
+        static_cast<const std::uint8_t *>(expected.Access().Pixels) +
+        expected.Access().Stride * y
+      );
+      const std::uint8_t *row = (
+        static_cast<const std::uint8_t *>(streamed.Access().Pixels) +
+        streamed.Access().Stride * y
+      );
+      EXPECT_EQ(std::memcmp(row, expectedRow, 17 * 3), 0);
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BitmapSerializerTest, RowSourcesRejectRegionsAndInterlacedPngs) {
+    BitmapSerializer store;
+
+    LoadOptions options;
+    options.Region = Rectangle(2, 2, 10, 5);
+    EXPECT_THROW(
+      store.OpenRowSource(VirtualFile::FromMemory(testPng, sizeof(testPng)), u8"png", options),
+      std::invalid_argument
+    );
+
+    EXPECT_THROW(
+      store.OpenRowSource(VirtualFile::FromMemory(interlacedPng, sizeof(interlacedPng))),
+      Errors::FileFormatError
+    );
+
+    // The interlaced PNG can still be loaded as a whole
+    Bitmap interlaced = store.Load(*VirtualFile::FromMemory(interlacedPng, sizeof(interlacedPng)));
+    EXPECT_EQ(interlaced.GetWidth(), 2);
+    EXPECT_EQ(interlaced.GetHeight(), 2);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG) && defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(BitmapSerializerTest, CodecUsageIsRecordedInStatistics) {
+    BitmapSerializer store;
+
+    // The PNG codec is registered first, the JPEG codec second
+    store.Load(*VirtualFile::FromMemory(testPng, sizeof(testPng)), u8"png");
+    store.Load(*VirtualFile::FromMemory(testJpeg, sizeof(testJpeg)));
+    store.Load(*VirtualFile::FromMemory(testJpeg, sizeof(testJpeg)));
+
+    std::string notAnImage = std::string(u8"BMW service intervals\n") + std::string(64, '-');
+    std::unique_ptr<const VirtualFile> notAnImageFile = VirtualFile::FromMemory(
+      reinterpret_cast<const std::uint8_t *>(notAnImage.data()), notAnImage.size()
+    );
+    EXPECT_FALSE(store.TryReadInfo(*notAnImageFile).Loadable);
+
+    BitmapSerializer::Statistics statistics = store.GetStatistics();
+    EXPECT_EQ(statistics.HintHitCount, 1U);
+    EXPECT_EQ(statistics.ScanHitCount, 1U); // The PNG codec mispredicted the first JPEG
+    EXPECT_EQ(statistics.MostRecentHitCount, 1U);
+    EXPECT_EQ(statistics.SecondMostRecentHitCount, 0U);
+    EXPECT_EQ(statistics.MissCount, 1U);
+
+    ASSERT_GE(statistics.Codecs.size(), 2U);
+    const BitmapSerializer::CodecStatistics &png = statistics.Codecs[0];
+    EXPECT_EQ(png.HitCount, 1U);
+    EXPECT_EQ(png.LoadCount, 1U);
+    EXPECT_EQ(png.LoadedByteCount, sizeof(testPng));
+    EXPECT_GE(png.ProbeCount, 2U);
+    EXPECT_EQ(png.ProbeCount, png.HitCount + png.HeaderRejectionCount);
+    EXPECT_EQ(png.FailureCount, 0U);
+
+    const BitmapSerializer::CodecStatistics &jpeg = statistics.Codecs[1];
+    EXPECT_EQ(jpeg.HitCount, 2U);
+    EXPECT_EQ(jpeg.LoadCount, 2U);
+    EXPECT_EQ(jpeg.LoadedByteCount, sizeof(testJpeg) * 2);
+    EXPECT_LE(jpeg.MedianLoadMicroseconds, jpeg.Percentile90LoadMicroseconds);
+    EXPECT_LE(jpeg.Percentile90LoadMicroseconds, jpeg.Percentile99LoadMicroseconds);
+    EXPECT_EQ(jpeg.SaveCount, 0U);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG) && defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
 
 }}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,217 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/BlobFile.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Errors/FileAccessError.h"
+
+#include <algorithm> // for std::copy_n()
+#include <stdexcept> // for std::out_of_range
+#include <vector> // for std::vector
+
+#include <gtest/gtest.h>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stand-in for a Nuclex.Storage blob that keeps its contents in memory</summary>
+  class VectorBlob {
+
+    /// <summary>Initializes a new, empty blob</summary>
+    /// <param name="providesSpans">Whether the blob hands out direct access to its bytes</param>
+    public: explicit VectorBlob(bool providesSpans = true) :
+      contents(),
+      providesSpans(providesSpans) {}
+
+    /// <summary>Determines the size of the blob in bytes</summary>
+    /// <returns>The number of bytes stored in the blob</returns>
+    public: std::uint64_t GetSize() const { return this->contents.size(); }
+
+    /// <summary>Reads bytes from the blob</summary>
+    /// <param name="location">Offset of the first byte that will be read</param>
+    /// <param name="buffer">Buffer that will receive the bytes</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: void ReadAt(std::uint64_t location, void *buffer, std::size_t count) const {
+      if((location > this->contents.size()) || (count > this->contents.size() - location)) {
+        throw std::out_of_range(u8"Read beyond end of blob");
+      }
+      std::copy_n(
+        this->contents.data() + location, count, static_cast<std::uint8_t *>(buffer)
+      );
+    }
+
+    /// <summary>Writes bytes into the blob, enlarging it if needed</summary>
+    /// <param name="location">Offset at which the first byte will be written</param>
+    /// <param name="buffer">Buffer holding the bytes that will be written</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    public: void WriteAt(std::uint64_t location, const void *buffer, std::size_t count) {
+      if(location + count > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(location + count));
+      }
+      std::copy_n(
+        static_cast<const std::uint8_t *>(buffer), count, this->contents.data() + location
+      );
+    }
+
+    /// <summary>Provides direct access to the blob's bytes if enabled</summary>
+    /// <param name="location">Offset of the first byte to access</param>
+    /// <param name="count">Number of bytes that will be accessed</param>
+    /// <returns>The address of the first byte or null</returns>
+    public: const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t location, std::size_t count
+    ) const {
+      if(!this->providesSpans) {
+        return nullptr;
+      }
+      if((location > this->contents.size()) || (count > this->contents.size() - location)) {
+        return nullptr;
+      }
+      return this->contents.data() + location;
+    }
+
+    /// <summary>Bytes stored in the blob</summary>
+    private: std::vector<std::uint8_t> contents;
+    /// <summary>Whether direct access to the bytes is provided</summary>
+    private: bool providesSpans;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobFileTest, ReadsAndWritesAreForwardedToBlob) {
+    VectorBlob blob;
+    BlobFile<VectorBlob> file(blob);
+
+    const std::uint8_t data[] = { 1, 2, 3, 4, 5 };
+    file.WriteAt(0, 5, data);
+    file.WriteAt(3, 5, data);
+    ASSERT_EQ(file.GetSize(), 8U);
+    EXPECT_EQ(blob.GetSize(), 8U);
+
+    std::uint8_t readBack[4] = { 0 };
+    file.ReadAt(2, 4, readBack);
+    EXPECT_EQ(readBack[0], 3);
+    EXPECT_EQ(readBack[1], 1);
+    EXPECT_EQ(readBack[2], 2);
+    EXPECT_EQ(readBack[3], 3);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobFileTest, ContiguousSpansPointIntoBlob) {
+    VectorBlob blob;
+    const std::uint8_t data[] = { 10, 20, 30, 40 };
+    blob.WriteAt(0, data, 4);
+
+    BlobFile<VectorBlob> file(static_cast<const VectorBlob &>(blob));
+    EXPECT_EQ(file.TryGetContiguousSpan(1, 3), blob.TryGetContiguousSpan(1, 3));
+    EXPECT_EQ(file.TryGetContiguousSpan(2, 8), nullptr);
+
+    VectorBlob copyingBlob(false);
+    copyingBlob.WriteAt(0, data, 4);
+    BlobFile<VectorBlob> copyingFile(static_cast<const VectorBlob &>(copyingBlob));
+    EXPECT_EQ(copyingFile.TryGetContiguousSpan(0, 4), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobFileTest, ConstBlobsCanNotBeWritten) {
+    const VectorBlob blob;
+    BlobFile<VectorBlob> file(blob);
+
+    const std::uint8_t data[] = { 1 };
+    EXPECT_THROW(file.WriteAt(0, 1, data), Errors::FileAccessError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobFileTest, SharedBlobIsKeptAlive) {
+    std::weak_ptr<VectorBlob> weakBlob;
+    {
+      std::shared_ptr<VectorBlob> blob = std::make_shared<VectorBlob>();
+      weakBlob = blob;
+
+      BlobFile<VectorBlob> file(blob);
+      blob.reset();
+      EXPECT_FALSE(weakBlob.expired());
+
+      const std::uint8_t data[] = { 42 };
+      file.WriteAt(0, 1, data);
+      EXPECT_EQ(file.GetSize(), 1U);
+    }
+    EXPECT_TRUE(weakBlob.expired());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(BlobFileTest, BitmapsCanBeSavedToAndLoadedFromBlobs) {
+    Bitmap original(13, 9, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      BitmapMemory memory = original.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + (y * memory.Stride);
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(x * 7 + y * 13);
+        }
+      }
+    }
+
+    BitmapSerializer serializer;
+
+    VectorBlob blob;
+    {
+      BlobFile<VectorBlob> file(blob);
+      serializer.Save(original, file, u8"png");
+    }
+    ASSERT_GT(blob.GetSize(), 0U);
+
+    BlobFile<VectorBlob> file(static_cast<const VectorBlob &>(blob));
+    Bitmap loaded = serializer.Load(file, u8"png");
+    ASSERT_EQ(loaded.GetWidth(), 13U);
+    ASSERT_EQ(loaded.GetHeight(), 9U);
+
+    BitmapMemory originalMemory = original.Access();
+    BitmapMemory loadedMemory = loaded.Access();
+    for(std::size_t y = 0; y < 9; ++y) {
+      const std::uint8_t *originalRow = (
+        static_cast<const std::uint8_t *>(originalMemory.Pixels) + (y * originalMemory.Stride)
+      );
+      const std::uint8_t *loadedRow = (
+        static_cast<const std::uint8_t *>(loadedMemory.Pixels) + (y * loadedMemory.Stride)
+      );
+      for(std::size_t x = 0; x < 13 * 4; ++x) {
+        EXPECT_EQ(loadedRow[x], originalRow[x]);
+      }
+    }
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,113 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/ImageHasher.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Storage/SaveOptions.h"
+#include "Nuclex/Pixels/BitmapAnalyzer.h"
+
+#include <cmath> // for std::sin(), std::cos()
+
+#include <gtest/gtest.h>
+
+#include "TemporaryDirectoryScope.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a bitmap showing a smooth pattern that compresses well</summary>
+  /// <param name="width">Width of the bitmap in pixels</param>
+  /// <param name="height">Height of the bitmap in pixels</param>
+  /// <returns>The new bitmap holding the pattern</returns>
+  Nuclex::Pixels::Bitmap createTestBitmap(std::size_t width, std::size_t height) {
+    Nuclex::Pixels::Bitmap bitmap(
+      width, height, Nuclex::Pixels::PixelFormat::R8_G8_B8_Unsigned
+    );
+
+    const Nuclex::Pixels::BitmapMemory &memory = bitmap.Access();
+    for(std::size_t y = 0; y < height; ++y) {
+      std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + y * memory.Stride;
+      double v = static_cast<double>(y) / static_cast<double>(height);
+      for(std::size_t x = 0; x < width; ++x) {
+        double u = static_cast<double>(x) / static_cast<double>(width);
+        double value = 128.0 + 100.0 * std::sin(u * 7.0) * std::cos(v * 5.0);
+        row[x * 3 + 0] = static_cast<std::uint8_t>(value);
+        row[x * 3 + 1] = static_cast<std::uint8_t>(255.0 - value);
+        row[x * 3 + 2] = static_cast<std::uint8_t>(64.0 + value / 2.0);
+      }
+    }
+
+    return bitmap;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  TEST(ImageHasherTest, ScaledJpegHashesMatchFullResolutionHashes) {
+    BitmapSerializer serializer;
+    Bitmap original = createTestBitmap(640, 480);
+
+    TemporaryDirectoryScope temporaryDirectory;
+    std::string path = temporaryDirectory.GetPath(u8"hashed.jpg");
+    serializer.Save(original, path);
+
+    Bitmap loaded = serializer.Load(path);
+
+    std::uint64_t fullHash = BitmapAnalyzer::ComputePerceptualHash(loaded.Access());
+    std::uint64_t fastHash = ImageHasher::ComputePerceptualHash(serializer, path);
+    EXPECT_LE(BitmapAnalyzer::CountDifferentBits(fullHash, fastHash), 4U);
+
+    fullHash = BitmapAnalyzer::ComputeDifferenceHash(loaded.Access());
+    fastHash = ImageHasher::ComputeDifferenceHash(serializer, path);
+    EXPECT_LE(BitmapAnalyzer::CountDifferentBits(fullHash, fastHash), 4U);
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBJPEG)
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(ImageHasherTest, OtherFormatsAreHashedAtFullResolution) {
+    BitmapSerializer serializer;
+    Bitmap original = createTestBitmap(100, 80);
+
+    TemporaryDirectoryScope temporaryDirectory;
+    std::string path = temporaryDirectory.GetPath(u8"hashed.png");
+    serializer.Save(original, path);
+
+    EXPECT_EQ(
+      ImageHasher::ComputePerceptualHash(serializer, path),
+      BitmapAnalyzer::ComputePerceptualHash(original.Access())
+    );
+    EXPECT_EQ(
+      ImageHasher::ComputeDifferenceHash(serializer, path),
+      BitmapAnalyzer::ComputeDifferenceHash(original.Access())
+    );
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -0,0 +1,233 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include <cstring> // for std::memcmp(), std::memcpy()
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+#include "../BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include "TemporaryDirectoryScope.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Saves a bitmap into a temporary file and loads it again</summary>
+  /// <param name="bitmap">Bitmap that will be saved and loaded</param>
+  /// <param name="filename">Name of the file including the extension</param>
+  /// <returns>The bitmap loaded from the file</returns>
+  Nuclex::Pixels::Bitmap saveAndLoad(
+    const Nuclex::Pixels::Bitmap &bitmap, const std::string &filename
+  ) {
+    Nuclex::Pixels::Storage::BitmapSerializer serializer;
+    Nuclex::Pixels::TemporaryDirectoryScope temporaryDirectory;
+
+    std::string path = temporaryDirectory.GetPath(filename);
+    serializer.Save(bitmap, path);
+    return serializer.Load(path);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, TgaCanBeSavedAndLoadedAgain) {
+    Bitmap original(13, 7, PixelFormat::B8_G8_R8_A8_Unsigned);
+    FillWithPattern(original);
+
+    Bitmap loaded = saveAndLoad(original, u8"test.tga");
+    EXPECT_TRUE(HaveSamePixels(loaded, original));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, BottomUpTgaIsLoadedUpright) {
+    std::uint8_t contents[18 + 4] = {
+      0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      2, 0, 2, 0, // Width and height
+      8, 0, // 8 bits per pixel, bottom-up
+      3, 4, // Bottom row
+      1, 2 // Top row
+    };
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(contents, sizeof(contents));
+
+    BitmapSerializer serializer;
+    Bitmap loaded = serializer.Load(*file, u8"tga");
+    ASSERT_EQ(loaded.GetWidth(), 2U);
+    ASSERT_EQ(loaded.GetHeight(), 2U);
+    ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_Unsigned);
+
+    const BitmapMemory &memory = loaded.Access();
+    const std::uint8_t *topRow = static_cast<const std::uint8_t *>(memory.Pixels);
+    const std::uint8_t *bottomRow = topRow + memory.Stride;
+    EXPECT_EQ(topRow[0], 1);
+    EXPECT_EQ(topRow[1], 2);
+    EXPECT_EQ(bottomRow[0], 3);
+    EXPECT_EQ(bottomRow[1], 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, BmpWithPaddedRowsCanBeSavedAndLoadedAgain) {
+    Bitmap original(5, 3, PixelFormat::B8_G8_R8_Unsigned);
+    FillWithPattern(original);
+
+    Bitmap loaded = saveAndLoad(original, u8"test.bmp");
+    EXPECT_TRUE(HaveSamePixels(loaded, original));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, BmpWithAlphaChannelCanBeSavedAndLoadedAgain) {
+    Bitmap original(6, 4, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(original);
+
+    Bitmap loaded = saveAndLoad(original, u8"test.bmp");
+    EXPECT_TRUE(HaveSamePixels(loaded, original));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, PgmAndPpmCanBeSavedAndLoadedAgain) {
+    Bitmap gray(9, 5, PixelFormat::R8_Unsigned);
+    FillWithPattern(gray);
+    EXPECT_TRUE(HaveSamePixels(saveAndLoad(gray, u8"test.pgm"), gray));
+
+    Bitmap color(9, 5, PixelFormat::R8_G8_B8_Unsigned);
+    FillWithPattern(color);
+    EXPECT_TRUE(HaveSamePixels(saveAndLoad(color, u8"test.ppm"), color));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, PpmWithCommentsCanBeLoaded) {
+    const char contents[] = "P6\n# Comment\n1 1 # Width and height\n255\nabc";
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(
+      contents, sizeof(contents) - 1
+    );
+
+    BitmapSerializer serializer;
+    Bitmap loaded = serializer.Load(*file, u8"ppm");
+    ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R8_G8_B8_Unsigned);
+    EXPECT_EQ(std::memcmp(loaded.Access().Pixels, "abc", 3), 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, TruncatedPpmThrowsException) {
+    const char contents[] = "P6\n2 2\n255\nabcdef";
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(
+      contents, sizeof(contents) - 1
+    );
+
+    BitmapSerializer serializer;
+    EXPECT_THROW(serializer.Load(*file, u8"ppm"), Errors::FileFormatError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, PfmCanBeSavedAndLoadedAgain) {
+    Bitmap gray(4, 3, PixelFormat::R32_Float_Native32);
+    {
+      const BitmapMemory &memory = gray.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        float *row = reinterpret_cast<float *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + (memory.Stride * y)
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x] = static_cast<float>(y) * 10.0f + static_cast<float>(x) * 0.25f;
+        }
+      }
+    }
+    EXPECT_TRUE(HaveSamePixels(saveAndLoad(gray, u8"test.pfm"), gray));
+
+    Bitmap color(4, 3, PixelFormat::R32_G32_B32_A32_Float_Native32);
+    {
+      const BitmapMemory &memory = color.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        float *row = reinterpret_cast<float *>(
+          static_cast<std::uint8_t *>(memory.Pixels) + (memory.Stride * y)
+        );
+        for(std::size_t x = 0; x < memory.Width; ++x) {
+          row[x * 4 + 0] = static_cast<float>(y) - 0.5f;
+          row[x * 4 + 1] = static_cast<float>(x) * 2.0f;
+          row[x * 4 + 2] = 1.5f;
+          row[x * 4 + 3] = 1.0f; // PFM has no alpha channel
+        }
+      }
+    }
+    EXPECT_TRUE(HaveSamePixels(saveAndLoad(color, u8"test.pfm"), color));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, PfmInForeignByteOrderCanBeLoaded) {
+#if defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+    const char header[] = "Pf\n1 1\n1.0\n";
+    const std::uint8_t value[4] = { 0x3F, 0xC0, 0x00, 0x00 }; // 1.5f in big endian
+#else
+    const char header[] = "Pf\n1 1\n-1.0\n";
+    const std::uint8_t value[4] = { 0x00, 0x00, 0xC0, 0x3F }; // 1.5f in little endian
+#endif
+    std::vector<std::uint8_t> contents(header, header + sizeof(header) - 1);
+    contents.insert(contents.end(), value, value + 4);
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(
+      &contents[0], contents.size()
+    );
+
+    BitmapSerializer serializer;
+    Bitmap loaded = serializer.Load(*file, u8"pfm");
+    ASSERT_EQ(loaded.GetPixelFormat(), PixelFormat::R32_Float_Native32);
+    EXPECT_EQ(*static_cast<const float *>(loaded.Access().Pixels), 1.5f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(RawBitmapCodecTest, RegionCanBeLoaded) {
+    Bitmap original(8, 6, PixelFormat::B8_G8_R8_Unsigned);
+    FillWithPattern(original);
+
+    BitmapSerializer serializer;
+    TemporaryDirectoryScope temporaryDirectory;
+    std::string path = temporaryDirectory.GetPath(u8"test.bmp");
+    serializer.Save(original, path);
+
+    LoadOptions options;
+    options.Region = Rectangle::FromPositionAndSize(3, 2, 4, 3);
+    Bitmap region = serializer.Load(path, options);
+    EXPECT_TRUE(HaveSamePixels(region, original.GetView(3, 2, 4, 3)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
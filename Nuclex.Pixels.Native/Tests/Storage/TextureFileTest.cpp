@@ -0,0 +1,247 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/Storage/TextureFile.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "Nuclex/Pixels/Storage/VirtualFile.h"
+#include "Nuclex/Pixels/Errors/FileFormatError.h"
+
+#include <cstring> // for std::memcpy()
+#include <vector> // for std::vector
+
+#include <gtest/gtest.h>
+
+#include "TemporaryDirectoryScope.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a 32 bit little endian integer into a buffer</summary>
+  /// <param name="buffer">Buffer the integer will be written into</param>
+  /// <param name="offset">Offset at which the integer will be written</param>
+  /// <param name="value">Integer that will be written</param>
+  void writeUInt32(std::vector<std::uint8_t> &buffer, std::size_t offset, std::uint32_t value) {
+    buffer[offset + 0] = static_cast<std::uint8_t>(value);
+    buffer[offset + 1] = static_cast<std::uint8_t>(value >> 8);
+    buffer[offset + 2] = static_cast<std::uint8_t>(value >> 16);
+    buffer[offset + 3] = static_cast<std::uint8_t>(value >> 24);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a DDS file storing a DXT1 (BC1) texture with mip levels</summary>
+  /// <param name="width">Width of the largest mip level in pixels</param>
+  /// <param name="height">Height of the largest mip level in pixels</param>
+  /// <param name="levelCount">Number of mip levels the file will store</param>
+  /// <param name="dataByteCount">Number of bytes following the header</param>
+  /// <returns>The contents of the DDS file</returns>
+  std::vector<std::uint8_t> makeDxt1Dds(
+    std::uint32_t width, std::uint32_t height, std::uint32_t levelCount,
+    std::size_t dataByteCount
+  ) {
+    std::vector<std::uint8_t> contents(128 + dataByteCount, 0);
+    std::memcpy(&contents[0], "DDS ", 4);
+    writeUInt32(contents, 4, 124); // Header size
+    writeUInt32(contents, 8, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000); // Flags
+    writeUInt32(contents, 12, height);
+    writeUInt32(contents, 16, width);
+    writeUInt32(contents, 28, levelCount);
+    writeUInt32(contents, 76, 32); // Pixel format size
+    writeUInt32(contents, 80, 0x4); // DDPF_FOURCC
+    std::memcpy(&contents[84], "DXT1", 4);
+    writeUInt32(contents, 108, 0x1000); // DDSCAPS_TEXTURE
+
+    // Give each byte of the pixel data a recognizable value
+    for(std::size_t index = 0; index < dataByteCount; ++index) {
+      contents[128 + index] = static_cast<std::uint8_t>(index);
+    }
+
+    return contents;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a KTX2 file storing an 8 bit RGBA texture with three mip levels</summary>
+  /// <returns>The contents of the KTX2 file</returns>
+  /// <remarks>
+  ///   The largest mip level is 4x4 pixels. Like the specification demands, the mip levels
+  ///   are stored smallest first while the level index lists the largest one first.
+  /// </remarks>
+  std::vector<std::uint8_t> makeRgbaKtx2() {
+    const std::uint8_t identifier[12] = {
+      0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+    };
+
+    // Header and index (80 bytes), level index (3 * 24 bytes), then 4 + 16 + 64 bytes
+    std::vector<std::uint8_t> contents(80 + 72 + 84, 0);
+    std::memcpy(&contents[0], identifier, sizeof(identifier));
+    writeUInt32(contents, 12, 37); // VK_FORMAT_R8G8B8A8_UNORM
+    writeUInt32(contents, 16, 1); // Type size
+    writeUInt32(contents, 20, 4); // Width
+    writeUInt32(contents, 24, 4); // Height
+    writeUInt32(contents, 36, 1); // Face count
+    writeUInt32(contents, 40, 3); // Level count
+
+    const std::uint32_t offsets[3] = { 172, 156, 152 };
+    const std::uint32_t lengths[3] = { 64, 16, 4 };
+    for(std::size_t index = 0; index < 3; ++index) {
+      writeUInt32(contents, 80 + (index * 24), offsets[index]);
+      writeUInt32(contents, 80 + (index * 24) + 8, lengths[index]);
+      writeUInt32(contents, 80 + (index * 24) + 16, lengths[index]);
+      std::memset(&contents[offsets[index]], static_cast<int>(index + 1), lengths[index]);
+    }
+
+    return contents;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureFileTest, DdsMipLevelsAreAccessedInPlace) {
+    std::vector<std::uint8_t> contents = makeDxt1Dds(8, 8, 4, 32 + 8 + 8 + 8);
+    TextureFile texture = TextureFile::Open(VirtualFile::FromMemory(&contents[0], contents.size()));
+
+    EXPECT_EQ(texture.GetWidth(), 8U);
+    EXPECT_EQ(texture.GetHeight(), 8U);
+    EXPECT_EQ(texture.GetPixelFormat(), PixelFormat::BC1_Compressed);
+    ASSERT_EQ(texture.CountLevels(), 4U);
+
+    BitmapMemory largest = texture.GetLevel(0);
+    EXPECT_EQ(largest.Width, 8U);
+    EXPECT_EQ(largest.Height, 8U);
+    EXPECT_EQ(largest.Stride, 4); // Two blocks of 8 bytes each cover 4 rows
+    EXPECT_EQ(largest.Pixels, &contents[128]);
+    EXPECT_EQ(texture.CountLevelBytes(0), 32U);
+
+    BitmapMemory second = texture.GetLevel(1);
+    EXPECT_EQ(second.Width, 4U);
+    EXPECT_EQ(second.Height, 4U);
+    EXPECT_EQ(second.Pixels, &contents[128 + 32]);
+
+    // Levels smaller than a block still occupy a whole block
+    BitmapMemory smallest = texture.GetLevel(3);
+    EXPECT_EQ(smallest.Width, 1U);
+    EXPECT_EQ(smallest.Height, 1U);
+    EXPECT_EQ(smallest.Pixels, &contents[128 + 48]);
+    EXPECT_EQ(texture.CountLevelBytes(3), 8U);
+
+    EXPECT_THROW(texture.GetLevel(4), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureFileTest, Ktx2MipLevelsAreLocatedThroughLevelIndex) {
+    std::vector<std::uint8_t> contents = makeRgbaKtx2();
+    TextureFile texture = TextureFile::Open(VirtualFile::FromMemory(&contents[0], contents.size()));
+
+    EXPECT_EQ(texture.GetWidth(), 4U);
+    EXPECT_EQ(texture.GetHeight(), 4U);
+    EXPECT_EQ(texture.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+    ASSERT_EQ(texture.CountLevels(), 3U);
+
+    BitmapMemory largest = texture.GetLevel(0);
+    EXPECT_EQ(largest.Stride, 16);
+    EXPECT_EQ(largest.Pixels, &contents[172]);
+    EXPECT_EQ(*static_cast<const std::uint8_t *>(largest.Pixels), 1U);
+
+    BitmapMemory smallest = texture.GetLevel(2);
+    EXPECT_EQ(smallest.Width, 1U);
+    EXPECT_EQ(smallest.Height, 1U);
+    EXPECT_EQ(smallest.Pixels, &contents[152]);
+    EXPECT_EQ(*static_cast<const std::uint8_t *>(smallest.Pixels), 3U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureFileTest, TruncatedTexturesThrowException) {
+    std::vector<std::uint8_t> contents = makeDxt1Dds(8, 8, 4, 32 + 8 + 8);
+    EXPECT_THROW(
+      TextureFile::Open(VirtualFile::FromMemory(&contents[0], contents.size())),
+      Errors::FileFormatError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureFileTest, CubeMapsAreRejected) {
+    std::vector<std::uint8_t> contents = makeDxt1Dds(4, 4, 1, 8 * 6);
+    contents[113] = 0xFE; // DDSCAPS2_CUBEMAP and all faces
+    EXPECT_THROW(
+      TextureFile::Open(VirtualFile::FromMemory(&contents[0], contents.size())),
+      Errors::FileFormatError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureFileTest, OtherFilesThrowException) {
+    std::vector<std::uint8_t> contents(256, 0);
+    EXPECT_THROW(
+      TextureFile::Open(VirtualFile::FromMemory(&contents[0], contents.size())),
+      Errors::FileFormatError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureFileTest, SavedDdsFilesCanBeOpenedByPath) {
+    Bitmap bitmap(6, 5, PixelFormat::R8_G8_B8_A8_Unsigned);
+    {
+      const BitmapMemory &memory = bitmap.Access();
+      for(std::size_t y = 0; y < memory.Height; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + (memory.Stride * y);
+        for(std::size_t x = 0; x < memory.Width * 4; ++x) {
+          row[x] = static_cast<std::uint8_t>(y * 32 + x);
+        }
+      }
+    }
+
+    TemporaryDirectoryScope temporaryDirectory;
+    std::string path = temporaryDirectory.GetPath(u8"test.dds");
+    BitmapSerializer().Save(bitmap, path);
+
+    TextureFile texture = TextureFile::Open(path);
+    EXPECT_EQ(texture.GetWidth(), 6U);
+    EXPECT_EQ(texture.GetHeight(), 5U);
+    EXPECT_EQ(texture.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+    ASSERT_EQ(texture.CountLevels(), 1U);
+
+    BitmapMemory level = texture.GetLevel(0);
+    ASSERT_EQ(level.Stride, 24);
+    for(std::size_t y = 0; y < level.Height; ++y) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(level.Pixels) + (24 * y);
+      for(std::size_t x = 0; x < level.Width * 4; ++x) {
+        EXPECT_EQ(row[x], static_cast<std::uint8_t>(y * 32 + x));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Pixels::Storage
@@ -23,10 +23,136 @@ License along with this library
 
 #include "Nuclex/Pixels/Storage/VirtualFile.h"
 #include "Nuclex/Pixels/Errors/FileAccessError.h"
+#include "../Source/Storage/WriteBufferedVirtualFile.h"
 #include <gtest/gtest.h>
 
+#include <vector> // for std::vector
+
 #include "TemporaryDirectoryScope.h"
 
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file that counts how often it has been read from</summary>
+  class ReadCountingFile : public Nuclex::Pixels::Storage::VirtualFile {
+
+    /// <summary>Initializes a new read counting file of the specified size</summary>
+    /// <param name="length">Length the file will report</param>
+    /// <param name="readCount">Will be incremented each time the file is read from</param>
+    public: ReadCountingFile(std::uint64_t length, std::size_t &readCount) :
+      length(length),
+      readCount(readCount) {}
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->length; }
+
+    /// <summary>Fills the buffer with the lower 8 bits of each byte's offset</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override {
+      if((start > this->length) || (byteCount > this->length - start)) {
+        throw Nuclex::Pixels::Errors::FileAccessError(
+          std::make_error_code(std::errc::invalid_argument), u8"Read out of bounds"
+        );
+      }
+
+      ++this->readCount;
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        buffer[index] = static_cast<std::uint8_t>(start + index);
+      }
+    }
+
+    /// <summary>Not supported by the read counting file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override {
+      (void)start;
+      (void)byteCount;
+      (void)buffer;
+      throw std::runtime_error(u8"Not supported");
+    }
+
+    /// <summary>Length the file is reporting</summary>
+    private: std::uint64_t length;
+    /// <summary>Incremented each time the file is read from</summary>
+    private: std::size_t &readCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Virtual file in memory that counts how often it has been written to</summary>
+  class WriteCountingFile : public Nuclex::Pixels::Storage::VirtualFile {
+
+    /// <summary>Initializes a new, empty write counting file</summary>
+    /// <param name="contents">Receives the data written into the file</param>
+    /// <param name="writeCount">Will be incremented each time the file is written to</param>
+    public: WriteCountingFile(std::vector<std::uint8_t> &contents, std::size_t &writeCount) :
+      contents(contents),
+      writeCount(writeCount) {}
+
+    /// <summary>Determines the current size of the file in bytes</summary>
+    /// <returns>The size of the file in bytes</returns>
+    public: std::uint64_t GetSize() const override { return this->contents.size(); }
+
+    /// <summary>Reads data from the file</summary>
+    /// <param name="start">Offset in the file at which to begin reading</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    /// <parma name="buffer">Buffer into which the data will be read</param>
+    public: void ReadAt(
+      std::uint64_t start, std::size_t byteCount, std::uint8_t *buffer
+    ) const override {
+      if((start > this->contents.size()) || (byteCount > this->contents.size() - start)) {
+        throw Nuclex::Pixels::Errors::FileAccessError(
+          std::make_error_code(std::errc::invalid_argument), u8"Read out of bounds"
+        );
+      }
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        buffer[index] = this->contents[static_cast<std::size_t>(start) + index];
+      }
+    }
+
+    /// <summary>Writes data into the file</summary>
+    /// <param name="start">Offset at which writing will begin in the file</param>
+    /// <param name="byteCount">Number of bytes that should be written</param>
+    /// <param name="buffer">Buffer holding the data that should be written</param>
+    public: void WriteAt(
+      std::uint64_t start, std::size_t byteCount, const std::uint8_t *buffer
+    ) override {
+      if(start > this->contents.size()) {
+        throw Nuclex::Pixels::Errors::FileAccessError(
+          std::make_error_code(std::errc::invalid_argument), u8"Write leaves a gap"
+        );
+      }
+
+      ++this->writeCount;
+      if(start + byteCount > this->contents.size()) {
+        this->contents.resize(static_cast<std::size_t>(start) + byteCount);
+      }
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        this->contents[static_cast<std::size_t>(start) + index] = buffer[index];
+      }
+    }
+
+    /// <summary>Receives the data written into the file</summary>
+    private: std::vector<std::uint8_t> &contents;
+    /// <summary>Incremented each time the file is written to</summary>
+    private: std::size_t &writeCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
 namespace Nuclex { namespace Pixels { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
@@ -155,4 +281,290 @@ namespace Nuclex { namespace Pixels { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(VirtualFileTest, CanReadFromMemoryMappedFile) {
+    TemporaryDirectoryScope temporaryDirectory;
+
+    std::string actualFileContents = u8"Hello World!";
+
+    temporaryDirectory.WriteFullFile(u8"mapped-test.tmp", actualFileContents);
+
+    std::string testPath = temporaryDirectory.GetPath(u8"mapped-test.tmp");
+    std::vector<char> buffer;
+    {
+      std::unique_ptr<const VirtualFile> file = (
+        VirtualFile::OpenMemoryMappedFileForReading(testPath)
+      );
+      buffer.resize(file->GetSize());
+      file->ReadAt(0, buffer.size(), reinterpret_cast<std::uint8_t *>(&buffer[0]));
+    }
+
+    std::string claimedFileContents = std::string(&buffer[0], buffer.size());
+
+    EXPECT_EQ(claimedFileContents, actualFileContents);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, MemoryMappedFileProvidesContiguousSpan) {
+    TemporaryDirectoryScope temporaryDirectory;
+
+    temporaryDirectory.WriteFullFile(u8"mapped-test.tmp", "0123456789");
+
+    std::string testPath = temporaryDirectory.GetPath(u8"mapped-test.tmp");
+    {
+      std::unique_ptr<const VirtualFile> file = (
+        VirtualFile::OpenMemoryMappedFileForReading(testPath)
+      );
+
+      const std::uint8_t *span = file->TryGetContiguousSpan(2, 8);
+      ASSERT_NE(span, nullptr);
+      EXPECT_EQ(span[0], '2');
+      EXPECT_EQ(span[7], '9');
+
+      EXPECT_EQ(file->TryGetContiguousSpan(8, 3), nullptr);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, RealFileProvidesNoContiguousSpan) {
+    TemporaryDirectoryScope temporaryDirectory;
+
+    temporaryDirectory.WriteFullFile(u8"read-test.tmp", "0123456789");
+
+    std::string testPath = temporaryDirectory.GetPath(u8"read-test.tmp");
+    {
+      std::unique_ptr<const VirtualFile> file = VirtualFile::OpenRealFileForReading(testPath);
+      EXPECT_EQ(file->TryGetContiguousSpan(0, 10), nullptr);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, ReadingMemoryMappedFileOutOfBoundsThrowsError) {
+    TemporaryDirectoryScope temporaryDirectory;
+
+    temporaryDirectory.WriteFullFile(u8"mapped-test.tmp", "0123456789");
+
+    std::string testPath = temporaryDirectory.GetPath(u8"mapped-test.tmp");
+    std::uint8_t buffer[8];
+    {
+      std::unique_ptr<const VirtualFile> file = (
+        VirtualFile::OpenMemoryMappedFileForReading(testPath)
+      );
+      file->ReadAt(0, 8, buffer);
+
+      EXPECT_THROW(
+        file->ReadAt(8, 3, buffer),
+        Errors::FileAccessError
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, EmptyFileCanBeMemoryMapped) {
+    TemporaryDirectoryScope temporaryDirectory;
+
+    temporaryDirectory.WriteFullFile(u8"empty-test.tmp", std::string());
+
+    std::string testPath = temporaryDirectory.GetPath(u8"empty-test.tmp");
+    {
+      std::unique_ptr<const VirtualFile> file = (
+        VirtualFile::OpenMemoryMappedFileForReading(testPath)
+      );
+      EXPECT_EQ(file->GetSize(), 0U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, AccessHintsDoNotChangeContents) {
+    TemporaryDirectoryScope temporaryDirectory;
+
+    std::string actualFileContents = u8"Hello World!";
+    temporaryDirectory.WriteFullFile(u8"hint-test.tmp", actualFileContents);
+    std::string testPath = temporaryDirectory.GetPath(u8"hint-test.tmp");
+
+    std::unique_ptr<const VirtualFile> files[] = {
+      VirtualFile::OpenRealFileForReading(testPath),
+      VirtualFile::OpenMemoryMappedFileForReading(testPath)
+    };
+    for(std::size_t index = 0; index < 2; ++index) {
+      files[index]->AdviseSequential();
+      files[index]->Prefetch(0, files[index]->GetSize());
+      files[index]->Prefetch(6, 1000); // Hints extending past the end are fine
+      files[index]->Prefetch(1000, 10);
+
+      std::vector<char> buffer(files[index]->GetSize());
+      files[index]->ReadAt(0, buffer.size(), reinterpret_cast<std::uint8_t *>(&buffer[0]));
+      EXPECT_EQ(std::string(&buffer[0], buffer.size()), actualFileContents);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, CanReadFromMemory) {
+    const char contents[] = u8"0123456789";
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(contents, 10);
+    ASSERT_EQ(file->GetSize(), 10U);
+
+    std::uint8_t buffer[4];
+    file->ReadAt(3, 4, buffer);
+    EXPECT_EQ(buffer[0], '3');
+    EXPECT_EQ(buffer[3], '6');
+
+    // The file should point directly into our memory rather than a copy of it
+    EXPECT_EQ(
+      file->TryGetContiguousSpan(2, 8), reinterpret_cast<const std::uint8_t *>(contents + 2)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, AccessingMemoryFileOutOfBoundsThrowsError) {
+    const char contents[] = u8"0123456789";
+
+    std::unique_ptr<const VirtualFile> file = VirtualFile::FromMemory(contents, 10);
+
+    std::uint8_t buffer[8];
+    EXPECT_THROW(
+      file->ReadAt(8, 3, buffer),
+      Errors::FileAccessError
+    );
+    EXPECT_EQ(file->TryGetContiguousSpan(8, 3), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, ReadAheadBufferCombinesSequentialReads) {
+    std::size_t readCount = 0;
+    std::unique_ptr<const VirtualFile> file = VirtualFile::AddReadAheadBuffer(
+      std::make_unique<const ReadCountingFile>(1000, readCount), 256
+    );
+
+    ASSERT_EQ(file->GetSize(), 1000U);
+
+    // Reading the whole file in 10 byte pieces should take one read per 256 bytes
+    std::uint8_t buffer[10];
+    for(std::size_t offset = 0; offset < 1000; offset += 10) {
+      file->ReadAt(offset, 10, buffer);
+      for(std::size_t index = 0; index < 10; ++index) {
+        ASSERT_EQ(buffer[index], static_cast<std::uint8_t>(offset + index));
+      }
+    }
+
+    EXPECT_EQ(readCount, 4U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, ReadAheadBufferPassesRandomReadsThrough) {
+    std::size_t readCount = 0;
+    std::unique_ptr<const VirtualFile> file = VirtualFile::AddReadAheadBuffer(
+      std::make_unique<const ReadCountingFile>(1000, readCount), 256
+    );
+
+    std::uint8_t buffer[300];
+    file->ReadAt(500, 10, buffer);
+    EXPECT_EQ(buffer[0], static_cast<std::uint8_t>(500));
+    EXPECT_EQ(readCount, 1U);
+
+    // Continuing after the random read counts as sequential and fills the buffer
+    file->ReadAt(510, 10, buffer);
+    file->ReadAt(520, 10, buffer);
+    EXPECT_EQ(buffer[9], static_cast<std::uint8_t>(529));
+    EXPECT_EQ(readCount, 2U);
+
+    // Reads larger than the window skip the buffer
+    file->ReadAt(0, 300, buffer);
+    EXPECT_EQ(buffer[299], static_cast<std::uint8_t>(299));
+    EXPECT_EQ(readCount, 3U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, ReadingThroughReadAheadBufferOutOfBoundsThrowsError) {
+    std::size_t readCount = 0;
+    std::unique_ptr<const VirtualFile> file = VirtualFile::AddReadAheadBuffer(
+      std::make_unique<const ReadCountingFile>(100, readCount), 64
+    );
+
+    std::uint8_t buffer[16];
+    file->ReadAt(0, 16, buffer);
+    EXPECT_THROW(
+      file->ReadAt(90, 16, buffer),
+      Errors::FileAccessError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, WriteBufferCombinesSequentialWrites) {
+    std::vector<std::uint8_t> contents;
+    std::size_t writeCount = 0;
+    WriteBufferedVirtualFile file(
+      std::make_unique<WriteCountingFile>(contents, writeCount), 256
+    );
+
+    // Writing 1000 bytes in 10 byte pieces should take one write per 256 bytes
+    std::uint8_t buffer[10];
+    for(std::size_t offset = 0; offset < 1000; offset += 10) {
+      for(std::size_t index = 0; index < 10; ++index) {
+        buffer[index] = static_cast<std::uint8_t>(offset + index);
+      }
+      file.WriteAt(offset, 10, buffer);
+    }
+    EXPECT_EQ(file.GetSize(), 1000U);
+    EXPECT_EQ(writeCount, 3U);
+
+    file.Flush();
+    EXPECT_EQ(writeCount, 4U);
+
+    ASSERT_EQ(contents.size(), 1000U);
+    for(std::size_t index = 0; index < 1000; ++index) {
+      ASSERT_EQ(contents[index], static_cast<std::uint8_t>(index));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VirtualFileTest, WriteBufferHandlesPatchesAndLargeWrites) {
+    std::vector<std::uint8_t> contents;
+    std::size_t writeCount = 0;
+    WriteBufferedVirtualFile file(
+      std::make_unique<WriteCountingFile>(contents, writeCount), 256
+    );
+
+    std::uint8_t buffer[300] = {};
+    file.WriteAt(0, 100, buffer);
+
+    // Patching data that is still in the buffer doesn't touch the file
+    std::uint8_t patch[4] = { 1, 2, 3, 4 };
+    file.WriteAt(10, 4, patch);
+    EXPECT_EQ(writeCount, 0U);
+
+    // Large writes fill up the buffer, flush it and buffer what's left
+    file.WriteAt(100, 300, buffer);
+    EXPECT_EQ(writeCount, 1U);
+
+    // Reads flush the buffer before reading
+    file.WriteAt(400, 4, patch);
+    std::uint8_t readBack[4];
+    file.ReadAt(400, 4, readBack);
+    EXPECT_EQ(writeCount, 2U);
+    EXPECT_EQ(readBack[3], 4U);
+
+    // Writes leaving a gap are passed through, so the file can complain
+    EXPECT_THROW(file.WriteAt(500, 4, patch), Errors::FileAccessError);
+
+    file.Flush();
+    ASSERT_EQ(contents.size(), 404U);
+    EXPECT_EQ(contents[10], 1U);
+    EXPECT_EQ(contents[13], 4U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Pixels::Storage
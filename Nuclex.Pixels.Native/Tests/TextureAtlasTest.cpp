@@ -0,0 +1,180 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/TextureAtlas.h"
+#include "Nuclex/Pixels/BitmapBlitter.h"
+#include "Nuclex/Pixels/Storage/BitmapSerializer.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "Storage/TemporaryDirectoryScope.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether two rectangles, grown by a margin, overlap</summary>
+  /// <param name="first">First rectangle that will be checked</param>
+  /// <param name="second">Second rectangle that will be checked</param>
+  /// <param name="margin">Distance the rectangles need to keep from each other</param>
+  /// <returns>True if the rectangles are closer to each other than the margin</returns>
+  bool areTooClose(
+    const Nuclex::Pixels::Rectangle &first, const Nuclex::Pixels::Rectangle &second,
+    std::size_t margin
+  ) {
+    return (
+      (first.MinX < second.MaxX + margin) && (second.MinX < first.MaxX + margin) &&
+      (first.MinY < second.MaxY + margin) && (second.MinY < first.MaxY + margin)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureAtlasTest, HasDefaultConstructor) {
+    EXPECT_NO_THROW(
+      TextureAtlas atlas(256, 256, PixelFormat::R8_G8_B8_A8_Unsigned);
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureAtlasTest, EqualSizedSpritesFillAtlasCompletely) {
+    TextureAtlas atlas(64, 64, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    Rectangle placement(0, 0, 0, 0);
+    for(std::size_t index = 0; index < 16; ++index) {
+      ASSERT_TRUE(atlas.TryReserve(16, 16, placement));
+    }
+    EXPECT_EQ(atlas.CountOccupiedPixels(), 64U * 64U);
+    EXPECT_FALSE(atlas.TryReserve(1, 1, placement));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureAtlasTest, SpritesLargerThanAtlasAreRejected) {
+    TextureAtlas atlas(64, 64, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    Rectangle placement(0, 0, 0, 0);
+    EXPECT_FALSE(atlas.TryReserve(65, 10, placement));
+    EXPECT_FALSE(atlas.TryReserve(10, 65, placement));
+    EXPECT_TRUE(atlas.TryReserve(64, 64, placement));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureAtlasTest, PlacedSpritesKeepTheirPadding) {
+    TextureAtlas atlas(512, 512, PixelFormat::R8_G8_B8_A8_Unsigned, 2);
+
+    std::vector<Rectangle> placements;
+    for(std::size_t index = 0; index < 200; ++index) {
+      std::size_t width = 5 + (index * 37) % 29;
+      std::size_t height = 5 + (index * 53) % 31;
+
+      Rectangle placement(0, 0, 0, 0);
+      if(atlas.TryReserve(width, height, placement)) {
+        EXPECT_EQ(placement.MaxX - placement.MinX, width);
+        EXPECT_EQ(placement.MaxY - placement.MinY, height);
+        EXPECT_LE(placement.MaxX, 512U);
+        EXPECT_LE(placement.MaxY, 512U);
+        placements.push_back(placement);
+      }
+    }
+
+    ASSERT_EQ(placements.size(), 200U);
+    for(std::size_t first = 0; first < placements.size(); ++first) {
+      for(std::size_t second = first + 1; second < placements.size(); ++second) {
+        EXPECT_FALSE(areTooClose(placements[first], placements[second], 2));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureAtlasTest, AddedSpritesAreCopiedIntoTheirSlot) {
+    TextureAtlas atlas(128, 128, PixelFormat::R8_G8_B8_A8_Unsigned, 1);
+
+    Bitmap sprite(20, 12, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(sprite);
+
+    Rectangle first(0, 0, 0, 0), second(0, 0, 0, 0);
+    ASSERT_TRUE(atlas.TryAdd(sprite.Access(), first));
+    ASSERT_TRUE(atlas.TryAdd(sprite.Access(), second));
+    EXPECT_NE(first.MinX, second.MinX);
+
+    EXPECT_TRUE(BitmapBlitter::AreEqual(atlas.GetSlot(first).Access(), sprite.Access()));
+    EXPECT_TRUE(BitmapBlitter::AreEqual(atlas.GetSlot(second).Access(), sprite.Access()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TextureAtlasTest, ClearingRemovesAllSprites) {
+    TextureAtlas atlas(32, 32, PixelFormat::R8_G8_B8_A8_Unsigned);
+
+    Rectangle placement(0, 0, 0, 0);
+    ASSERT_TRUE(atlas.TryReserve(32, 32, placement));
+    EXPECT_FALSE(atlas.TryReserve(1, 1, placement));
+
+    atlas.Clear();
+    EXPECT_EQ(atlas.CountOccupiedPixels(), 0U);
+    EXPECT_TRUE(atlas.TryReserve(32, 32, placement));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+  TEST(TextureAtlasTest, ImagesCanBeLoadedIntoTheirSlot) {
+    Storage::BitmapSerializer serializer;
+
+    Bitmap sprite(23, 17, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(sprite);
+
+    TemporaryDirectoryScope temporaryDirectory;
+    std::string spritePath = temporaryDirectory.GetPath(u8"sprite.png");
+    serializer.Save(sprite, spritePath);
+
+    TextureAtlas atlas(64, 32, PixelFormat::R8_G8_B8_A8_Unsigned);
+    atlas.GetBitmap().EnableDirtyTracking(16);
+
+    Rectangle first(0, 0, 0, 0), second(0, 0, 0, 0), third(0, 0, 0, 0);
+    ASSERT_TRUE(atlas.TryLoad(serializer, spritePath, first));
+    ASSERT_TRUE(atlas.TryLoad(serializer, spritePath, second));
+    EXPECT_FALSE(atlas.TryLoad(serializer, spritePath, third));
+
+    EXPECT_TRUE(BitmapBlitter::AreEqual(atlas.GetSlot(first).Access(), sprite.Access()));
+    EXPECT_TRUE(BitmapBlitter::AreEqual(atlas.GetSlot(second).Access(), sprite.Access()));
+    EXPECT_FALSE(atlas.GetBitmap().GetDirtyRegions().empty());
+  }
+#endif // defined(NUCLEX_PIXELS_HAVE_LIBPNG)
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
@@ -0,0 +1,136 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/ThreadPool.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ThreadCountCanBeChosen) {
+    ThreadPool threadPool(3);
+    EXPECT_EQ(3U, threadPool.CountThreads());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, DefaultThreadCountUsesAllCores) {
+    ThreadPool threadPool;
+    EXPECT_GE(threadPool.CountThreads(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, EachTaskRunsExactlyOnce) {
+    ThreadPool threadPool(4);
+
+    std::vector<std::atomic<int>> counters(1000);
+    for(std::size_t index = 0; index < counters.size(); ++index) {
+      counters[index].store(0);
+    }
+
+    // Run several batches back-to-back to also catch workers straggling between batches
+    for(std::size_t batch = 0; batch < 20; ++batch) {
+      threadPool.ForEach(
+        counters.size(),
+        [&counters](std::size_t taskIndex) { ++counters[taskIndex]; }
+      );
+    }
+
+    for(std::size_t index = 0; index < counters.size(); ++index) {
+      EXPECT_EQ(20, counters[index].load());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, SingleThreadedPoolRunsTasksOnCaller) {
+    ThreadPool threadPool(1);
+
+    std::size_t sum = 0;
+    threadPool.ForEach(10, [&sum](std::size_t taskIndex) { sum += taskIndex; });
+    EXPECT_EQ(45U, sum);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ExceptionsArePropagatedToCaller) {
+    ThreadPool threadPool(4);
+
+    EXPECT_THROW(
+      threadPool.ForEach(
+        100,
+        [](std::size_t taskIndex) {
+          if(taskIndex == 42) {
+            throw std::runtime_error(u8"Test");
+          }
+        }
+      ),
+      std::runtime_error
+    );
+
+    // The thread pool should still be usable after a task failed
+    std::atomic<std::size_t> count(0);
+    threadPool.ForEach(100, [&count](std::size_t) { ++count; });
+    EXPECT_EQ(100U, count.load());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, PinnedPoolRunsEachTaskExactlyOnce) {
+    ThreadPool threadPool(4, true);
+    EXPECT_GE(threadPool.CountNumaNodes(), 1U);
+    EXPECT_LE(threadPool.CountNumaNodes(), 4U);
+
+    std::vector<std::atomic<int>> counters(997);
+    for(std::size_t index = 0; index < counters.size(); ++index) {
+      counters[index].store(0);
+    }
+
+    for(std::size_t batch = 0; batch < 20; ++batch) {
+      threadPool.ForEach(
+        counters.size(),
+        [&counters](std::size_t taskIndex) { ++counters[taskIndex]; }
+      );
+    }
+
+    for(std::size_t index = 0; index < counters.size(); ++index) {
+      EXPECT_EQ(20, counters[index].load());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, UnpinnedPoolUsesSingleNumaNode) {
+    ThreadPool threadPool(4);
+    EXPECT_EQ(1U, threadPool.CountNumaNodes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
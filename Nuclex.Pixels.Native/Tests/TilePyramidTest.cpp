@@ -0,0 +1,244 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/TilePyramid.h"
+#include "Nuclex/Pixels/BitmapBlitter.h"
+#include "Nuclex/Pixels/ParallelBands.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Row source that provides the rows of a bitmap</summary>
+  class BitmapRowSource : public Nuclex::Pixels::RowSource {
+
+    /// <summary>Initializes a new row source providing the rows of a bitmap</summary>
+    /// <param name="bitmap">Bitmap whose rows will be provided</param>
+    public: BitmapRowSource(const Nuclex::Pixels::Bitmap &bitmap) :
+      memory(bitmap.Access()),
+      nextY(0) {}
+
+    /// <summary>Retrieves the width of the rows provided by the row source</summary>
+    /// <returns>The number of pixels in each row</returns>
+    public: std::size_t GetWidth() const override { return this->memory.Width; }
+
+    /// <summary>Retrieves the number of rows the row source provides in total</summary>
+    /// <returns>The height of the image provided by the row source</returns>
+    public: std::size_t GetHeight() const override { return this->memory.Height; }
+
+    /// <summary>Retrieves the pixel format the rows are provided in</summary>
+    /// <returns>The pixel format of the rows</returns>
+    public: Nuclex::Pixels::PixelFormat GetPixelFormat() const override {
+      return this->memory.PixelFormat;
+    }
+
+    /// <summary>Copies the next rows of the bitmap</summary>
+    /// <param name="rows">Bitmap memory that will receive the rows</param>
+    public: void ReadRows(const Nuclex::Pixels::BitmapMemory &rows) override {
+      if(this->nextY + rows.Height > this->memory.Height) {
+        throw std::runtime_error(u8"Read past the end of the bitmap");
+      }
+
+      std::size_t rowByteCount = Nuclex::Pixels::CountRequiredBytes(
+        this->memory.PixelFormat, this->memory.Width
+      );
+      for(std::size_t y = 0; y < rows.Height; ++y) {
+        const std::uint8_t *sourceRow = static_cast<const std::uint8_t *>(
+          Nuclex::Pixels::GetBand(this->memory, this->nextY + y, 1).Pixels
+        );
+        std::uint8_t *targetRow = static_cast<std::uint8_t *>(
+          Nuclex::Pixels::GetBand(rows, y, 1).Pixels
+        );
+        std::copy_n(sourceRow, rowByteCount, targetRow);
+      }
+
+      this->nextY += rows.Height;
+    }
+
+    /// <summary>Bitmap memory the rows are taken from</summary>
+    private: Nuclex::Pixels::BitmapMemory memory;
+    /// <summary>Index of the next row that will be provided</summary>
+    private: std::size_t nextY;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tile sink that keeps copies of all tiles it receives</summary>
+  class CollectingTileSink : public Nuclex::Pixels::TileSink {
+
+    /// <summary>Level, horizontal and vertical index of a tile</summary>
+    public: typedef std::tuple<std::size_t, std::size_t, std::size_t> TileKey;
+
+    /// <summary>Stores a copy of a completed tile</summary>
+    /// <param name="level">Level the tile belongs to</param>
+    /// <param name="tileX">Horizontal index of the tile within its level</param>
+    /// <param name="tileY">Vertical index of the tile within its level</param>
+    /// <param name="tile">Pixels of the tile</param>
+    public: void WriteTile(
+      std::size_t level, std::size_t tileX, std::size_t tileY,
+      const Nuclex::Pixels::Bitmap &tile
+    ) override {
+      Nuclex::Pixels::Bitmap copy(tile);
+
+      std::lock_guard<std::mutex> tilesLock(this->tilesMutex);
+      bool wasAdded = this->Tiles.emplace(TileKey(level, tileX, tileY), copy).second;
+      if(!wasAdded) {
+        throw std::runtime_error(u8"Tile was written twice");
+      }
+    }
+
+    /// <summary>All tiles received so far</summary>
+    public: std::map<TileKey, Nuclex::Pixels::Bitmap> Tiles;
+    /// <summary>Must be held while adding tiles</summary>
+    private: std::mutex tilesMutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TilePyramidTest, LevelsGoDownToSinglePixel) {
+    EXPECT_EQ(TilePyramid::CountLevels(1, 1), 1U);
+    EXPECT_EQ(TilePyramid::CountLevels(2, 1), 2U);
+    EXPECT_EQ(TilePyramid::CountLevels(256, 256), 9U);
+    EXPECT_EQ(TilePyramid::CountLevels(1000, 600), 11U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TilePyramidTest, AllTilesOfAllLevelsAreGenerated) {
+    Bitmap image(100, 70, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(image);
+
+    ThreadPool threadPool(4);
+    CollectingTileSink sink;
+    TilePyramid::Generate(
+      std::unique_ptr<RowSource>(new BitmapRowSource(image)), sink, threadPool, 32
+    );
+
+    // 100x70 (4x3 tiles), 50x35 (2x2), 25x18, 13x9, 7x5, 4x3, 2x2 and 1x1 (1 tile each)
+    EXPECT_EQ(sink.Tiles.size(), 12U + 4U + 6U);
+
+    const Bitmap &corner = sink.Tiles.at(CollectingTileSink::TileKey(7, 3, 2));
+    EXPECT_EQ(corner.GetWidth(), 4U);
+    EXPECT_EQ(corner.GetHeight(), 6U);
+
+    const Bitmap &single = sink.Tiles.at(CollectingTileSink::TileKey(0, 0, 0));
+    EXPECT_EQ(single.GetWidth(), 1U);
+    EXPECT_EQ(single.GetHeight(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TilePyramidTest, FullResolutionTilesMatchImage) {
+    Bitmap image(100, 70, PixelFormat::R8_G8_B8_A8_Unsigned);
+    FillWithPattern(image);
+
+    ThreadPool threadPool(2);
+    CollectingTileSink sink;
+    TilePyramid::Generate(
+      std::unique_ptr<RowSource>(new BitmapRowSource(image)), sink, threadPool, 32
+    );
+
+    for(std::size_t tileY = 0; tileY < 3; ++tileY) {
+      for(std::size_t tileX = 0; tileX < 4; ++tileX) {
+        const Bitmap &tile = sink.Tiles.at(CollectingTileSink::TileKey(7, tileX, tileY));
+        Bitmap expected = image.GetView(
+          tileX * 32, tileY * 32,
+          std::min<std::size_t>(32, 100 - tileX * 32), std::min<std::size_t>(32, 70 - tileY * 32)
+        );
+        EXPECT_TRUE(BitmapBlitter::AreEqual(tile.Access(), expected.Access()));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TilePyramidTest, LowerLevelsAverageBlocksOfPixels) {
+    Bitmap image(4, 4, PixelFormat::R8_Unsigned);
+    {
+      const BitmapMemory &memory = image.Access();
+      for(std::size_t y = 0; y < 4; ++y) {
+        std::uint8_t *row = static_cast<std::uint8_t *>(memory.Pixels) + (y * memory.Stride);
+        for(std::size_t x = 0; x < 4; ++x) {
+          row[x] = static_cast<std::uint8_t>((x + y * 4) * 10);
+        }
+      }
+    }
+
+    ThreadPool threadPool(1);
+    CollectingTileSink sink;
+    TilePyramid::Generate(
+      std::unique_ptr<RowSource>(new BitmapRowSource(image)), sink, threadPool, 8
+    );
+    ASSERT_EQ(sink.Tiles.size(), 3U);
+
+    const BitmapMemory &half = sink.Tiles.at(CollectingTileSink::TileKey(1, 0, 0)).Access();
+    ASSERT_EQ(half.Width, 2U);
+    ASSERT_EQ(half.PixelFormat, PixelFormat::R8_Unsigned);
+    const std::uint8_t *firstRow = static_cast<const std::uint8_t *>(half.Pixels);
+    const std::uint8_t *secondRow = firstRow + half.Stride;
+    EXPECT_EQ(firstRow[0], 25); // (0 + 10 + 40 + 50) / 4
+    EXPECT_EQ(firstRow[1], 45);
+    EXPECT_EQ(secondRow[0], 105);
+    EXPECT_EQ(secondRow[1], 125);
+
+    const BitmapMemory &single = sink.Tiles.at(CollectingTileSink::TileKey(0, 0, 0)).Access();
+    EXPECT_EQ(static_cast<const std::uint8_t *>(single.Pixels)[0], 75);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TilePyramidTest, OtherPixelFormatsAreConverted) {
+    Bitmap image(16, 16, PixelFormat::R16_Unsigned_Native16);
+    BitmapBlitter::Clear(image.Access());
+
+    ThreadPool threadPool(2);
+    CollectingTileSink sink;
+    TilePyramid::Generate(
+      std::unique_ptr<RowSource>(new BitmapRowSource(image)), sink, threadPool
+    );
+
+    ASSERT_EQ(sink.Tiles.size(), 5U);
+    const Bitmap &tile = sink.Tiles.at(CollectingTileSink::TileKey(4, 0, 0));
+    EXPECT_EQ(tile.GetPixelFormat(), PixelFormat::R8_G8_B8_A8_Unsigned);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
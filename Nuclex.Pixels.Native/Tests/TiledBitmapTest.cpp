@@ -0,0 +1,207 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_PIXELS_SOURCE 1
+
+#include "Nuclex/Pixels/TiledBitmap.h"
+#include "Nuclex/Pixels/Bitmap.h"
+#include "BitmapPattern.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+namespace Nuclex { namespace Pixels {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, TilesAreAllocatedOnDemand) {
+    TiledBitmap bitmap(1000, 600, PixelFormat::R8_G8_B8_A8_Unsigned, 256);
+    EXPECT_EQ(1000U, bitmap.GetWidth());
+    EXPECT_EQ(600U, bitmap.GetHeight());
+    EXPECT_EQ(PixelFormat::R8_G8_B8_A8_Unsigned, bitmap.GetPixelFormat());
+    EXPECT_EQ(4U, bitmap.CountHorizontalTiles());
+    EXPECT_EQ(3U, bitmap.CountVerticalTiles());
+    EXPECT_EQ(0U, bitmap.CountAllocatedTiles());
+
+    BitmapMemory tile = bitmap.AccessTile(1, 2);
+    EXPECT_EQ(1U, bitmap.CountAllocatedTiles());
+    EXPECT_TRUE(bitmap.IsTileAllocated(1, 2));
+    EXPECT_FALSE(bitmap.IsTileAllocated(2, 1));
+
+    // Accessing the same tile again must hand out the same memory
+    BitmapMemory sameTile = bitmap.AccessTile(1, 2);
+    EXPECT_EQ(tile.Pixels, sameTile.Pixels);
+    EXPECT_EQ(1U, bitmap.CountAllocatedTiles());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, BorderTilesAreClippedToTheBitmap) {
+    TiledBitmap bitmap(1000, 600, PixelFormat::R8_Unsigned, 256);
+
+    BitmapMemory inner = bitmap.AccessTile(0, 0);
+    EXPECT_EQ(256U, inner.Width);
+    EXPECT_EQ(256U, inner.Height);
+
+    BitmapMemory corner = bitmap.AccessTile(3, 2);
+    EXPECT_EQ(1000U - 768U, corner.Width);
+    EXPECT_EQ(600U - 512U, corner.Height);
+    EXPECT_GE(corner.Stride, 256);
+
+    EXPECT_THROW(bitmap.AccessTile(4, 0), std::out_of_range);
+    EXPECT_THROW(bitmap.AccessTile(0, 3), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, NewTilesAreZeroed) {
+    TiledBitmap bitmap(64, 64, PixelFormat::R8_Unsigned, 32);
+
+    BitmapMemory tile = bitmap.AccessTile(1, 1);
+    for(std::size_t y = 0; y < tile.Height; ++y) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(tile.Pixels) + (
+        y * tile.Stride
+      );
+      for(std::size_t x = 0; x < tile.Width; ++x) {
+        ASSERT_EQ(0U, row[x]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, RegionsCanSpanMultipleTiles) {
+    TiledBitmap tiled(100, 100, PixelFormat::R8_Unsigned, 16);
+
+    Bitmap original(37, 41, PixelFormat::R8_Unsigned);
+    FillWithPattern(original);
+    tiled.WriteRegion(10, 20, original.Access());
+
+    // Tiles 0..2 horizontally and 1..3 vertically are touched by the region
+    EXPECT_EQ(9U, tiled.CountAllocatedTiles());
+
+    Bitmap copy(37, 41, PixelFormat::R8_Unsigned);
+    tiled.ReadRegion(10, 20, copy.Access());
+    EXPECT_TRUE(HaveSamePixels(original, copy));
+
+    // Pixels outside of the written region, including those in unallocated tiles,
+    // must read as zero without allocating anything
+    Bitmap outside(100, 10, PixelFormat::R8_Unsigned);
+    FillWithPattern(outside);
+    tiled.ReadRegion(0, 0, outside.Access());
+    Bitmap zeros(100, 10, PixelFormat::R8_Unsigned);
+    std::uint8_t *pixels = static_cast<std::uint8_t *>(zeros.Access().Pixels);
+    for(std::size_t index = 0; index < 100 * 10; ++index) {
+      pixels[index] = 0;
+    }
+    EXPECT_TRUE(HaveSamePixels(zeros, outside));
+    EXPECT_EQ(9U, tiled.CountAllocatedTiles());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, RegionsMustFitTheBitmap) {
+    TiledBitmap tiled(100, 100, PixelFormat::R8_Unsigned, 16);
+
+    Bitmap tooWide(20, 10, PixelFormat::R8_Unsigned);
+    EXPECT_THROW(tiled.WriteRegion(90, 0, tooWide.Access()), std::invalid_argument);
+    EXPECT_THROW(tiled.ReadRegion(0, 95, tooWide.Access()), std::invalid_argument);
+
+    Bitmap otherFormat(10, 10, PixelFormat::R8_G8_Unsigned);
+    EXPECT_THROW(tiled.WriteRegion(0, 0, otherFormat.Access()), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, ReleasedTilesReadAsZero) {
+    TiledBitmap tiled(64, 64, PixelFormat::R8_Unsigned, 32);
+
+    Bitmap pattern(32, 32, PixelFormat::R8_Unsigned);
+    FillWithPattern(pattern);
+    tiled.WriteRegion(32, 0, pattern.Access());
+    EXPECT_TRUE(tiled.IsTileAllocated(1, 0));
+
+    tiled.ReleaseTile(1, 0);
+    EXPECT_FALSE(tiled.IsTileAllocated(1, 0));
+    EXPECT_EQ(0U, tiled.CountAllocatedTiles());
+
+    BitmapMemory tile = tiled.AccessTile(1, 0);
+    EXPECT_EQ(0U, static_cast<const std::uint8_t *>(tile.Pixels)[0]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, TilesCanBeKeptInScratchFile) {
+    TiledBitmap tiled(300, 200, PixelFormat::R8_Unsigned, std::string(), 64);
+    EXPECT_EQ(0U, tiled.CountAllocatedTiles());
+
+    Bitmap original(150, 100, PixelFormat::R8_Unsigned);
+    FillWithPattern(original);
+    tiled.WriteRegion(100, 50, original.Access());
+
+    Bitmap copy(150, 100, PixelFormat::R8_Unsigned);
+    tiled.ReadRegion(100, 50, copy.Access());
+    EXPECT_TRUE(HaveSamePixels(original, copy));
+
+    // Released tiles in the scratch file have to be zeroed as well
+    tiled.ReleaseTile(2, 1);
+    BitmapMemory tile = tiled.AccessTile(2, 1);
+    for(std::size_t y = 0; y < tile.Height; ++y) {
+      const std::uint8_t *row = static_cast<const std::uint8_t *>(tile.Pixels) + (
+        y * tile.Stride
+      );
+      for(std::size_t x = 0; x < tile.Width; ++x) {
+        ASSERT_EQ(0U, row[x]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, HugeBitmapsOnlyAllocateTouchedTiles) {
+    TiledBitmap tiled(100000, 100000, PixelFormat::R8_G8_B8_A8_Unsigned);
+    EXPECT_EQ(391U, tiled.CountHorizontalTiles());
+    EXPECT_EQ(391U, tiled.CountVerticalTiles());
+
+    Bitmap original(16, 16, PixelFormat::R8_G8_B8_A8_Unsigned);
+    tiled.WriteRegion(99984, 99984, original.Access());
+    EXPECT_EQ(1U, tiled.CountAllocatedTiles());
+
+    BitmapMemory corner = tiled.AccessTile(390, 390);
+    EXPECT_EQ(100000U - 390U * 256U, corner.Width);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TiledBitmapTest, CanBeMoved) {
+    TiledBitmap first(64, 64, PixelFormat::R8_Unsigned, 32);
+    first.AccessTile(0, 0);
+
+    TiledBitmap second(std::move(first));
+    EXPECT_EQ(1U, second.CountAllocatedTiles());
+    EXPECT_TRUE(second.IsTileAllocated(0, 0));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Pixels
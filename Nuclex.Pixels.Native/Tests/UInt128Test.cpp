@@ -556,4 +556,37 @@ namespace Nuclex { namespace Pixels {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(UInt128Test, CanExtractBitsAcrossHalves) {
+    uint128_t test(0x0123456789abcdef, 0xfedcba9876543210);
+
+    EXPECT_EQ((test.ExtractBits<0, 32>()), std::uint64_t(0x76543210U));
+    EXPECT_EQ((test.ExtractBits<96, 32>()), std::uint64_t(0x01234567U));
+    EXPECT_EQ((test.ExtractBits<56, 16>()), std::uint64_t(0xeffeU));
+    EXPECT_EQ((test.ExtractBits<64, 64>()), std::uint64_t(0x0123456789abcdef));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(UInt128Test, CanBeLoadedAndStoredUnaligned) {
+    std::uint8_t buffer[17] = { 0 };
+    uint128_t test(0x0123456789abcdef, 0xfedcba9876543210);
+
+    StoreUInt128(buffer + 1, test);
+    EXPECT_EQ(LoadUInt128(buffer + 1), test);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PIXELS_HAVE_SSE2) && defined(NUCLEX_PIXELS_LITTLE_ENDIAN)
+  TEST(UInt128Test, CanBeMovedThroughSseRegisters) {
+    uint128_t test(0x0123456789abcdef, 0xfedcba9876543210);
+
+    __m128i vector = ToM128i(test);
+    EXPECT_EQ(_mm_cvtsi128_si32(vector), 0x76543210);
+    EXPECT_EQ(FromM128i(vector), test);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#endif
+
 }} // namespace Nuclex::Pixels
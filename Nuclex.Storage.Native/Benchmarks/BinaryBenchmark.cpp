@@ -0,0 +1,329 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BinaryBenchmark.h"
+#include "../../Nuclex.Support.Native/Benchmarks/BenchmarkRunner.h"
+
+#include "Nuclex/Storage/Blob.h"
+#include "Nuclex/Storage/Binary/BinaryBlobReader.h"
+#include "Nuclex/Storage/Binary/BinaryBlobWriter.h"
+
+#include <cstdint> // for std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t
+#include <string> // for std::string, std::to_string()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of fields read or written in each timed run</summary>
+  const std::size_t FieldCount = 262144;
+
+  /// <summary>Number of bytes transferred in each timed run of the bulk measurements</summary>
+  const std::size_t BulkByteCount = 4 * 1024 * 1024;
+
+  /// <summary>Number of bytes passed to each bulk read or write call</summary>
+  const std::size_t BulkCallByteCount = 65536;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives results so the compiler can not optimize the measured work away</summary>
+  volatile std::size_t sink;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Produces the values written by the measurements for a primitive type</summary>
+  /// <typeparam name="TValue">Type of values that will be produced</typeparam>
+  /// <returns>The produced values</returns>
+  template<typename TValue>
+  std::vector<TValue> makeValues() {
+    std::vector<TValue> values;
+    values.reserve(FieldCount);
+
+    std::uint32_t state = 2463534242U;
+    for(std::size_t index = 0; index < FieldCount; ++index) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      values.push_back(static_cast<TValue>(state));
+    }
+
+    return values;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Produces the strings written by the string measurements</summary>
+  /// <returns>Short strings like the names and identifiers found in saved games</returns>
+  std::vector<std::string> makeStrings() {
+    static const char *const prefixes[] = { u8"entity_", u8"Textures/", u8"npc.", u8"item:" };
+
+    std::vector<std::string> strings;
+    strings.reserve(FieldCount);
+    for(std::size_t index = 0; index < FieldCount; ++index) {
+      strings.push_back(prefixes[index % 4] + std::to_string(index * 7919));
+    }
+
+    return strings;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures writing and reading fields one at a time</summary>
+  /// <typeparam name="TValue">Type of fields that will be written and read</typeparam>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="backing">Kind of blob the fields will be written into and read from</param>
+  /// <param name="typeName">Name of the field type used in the measurement names</param>
+  /// <param name="values">Values that will be written</param>
+  template<typename TValue>
+  void measureFields(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const Nuclex::Storage::Benchmarks::BlobBacking &backing,
+    const std::string &typeName, const std::vector<TValue> &values
+  ) {
+    using Nuclex::Storage::Blob;
+    using Nuclex::Storage::Binary::BinaryBlobReader;
+    using Nuclex::Storage::Binary::BinaryBlobWriter;
+
+    std::string writeName = u8"Binary/Write/" + typeName + u8"/" + backing.Name;
+    std::string readName = u8"Binary/Read/" + typeName + u8"/" + backing.Name;
+    if(!runner.IsSelected(writeName) && !runner.IsSelected(readName)) {
+      return;
+    }
+
+    // Write the fields once up front to find out how many bytes they occupy
+    // and to have something for the read measurement to work on
+    std::shared_ptr<Blob> written = backing.CreateEmpty();
+    {
+      BinaryBlobWriter writer(written);
+      for(std::size_t index = 0; index < values.size(); ++index) {
+        writer.Write(values[index]);
+      }
+      writer.Flush();
+    }
+    std::size_t byteCount = static_cast<std::size_t>(written->GetSize());
+
+    runner.Measure(
+      writeName, values.size(), byteCount,
+      [&backing, &values]() {
+        BinaryBlobWriter writer(backing.CreateEmpty());
+        for(std::size_t index = 0; index < values.size(); ++index) {
+          writer.Write(values[index]);
+        }
+        writer.Flush();
+      }
+    );
+
+    std::vector<std::uint8_t> contents(byteCount);
+    written->ReadAt(0, contents.data(), byteCount);
+    std::shared_ptr<const Blob> blob = Nuclex::Storage::Benchmarks::CreateFilledBlob(
+      backing, contents
+    );
+
+    runner.Measure(
+      readName, values.size(), byteCount,
+      [&blob, &values]() {
+        BinaryBlobReader reader(blob);
+        TValue value;
+        std::size_t nonZeroCount = 0;
+        for(std::size_t index = 0; index < values.size(); ++index) {
+          reader.Read(value);
+          if(value != TValue()) {
+            ++nonZeroCount;
+          }
+        }
+        sink = nonZeroCount;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures writing and reading large buffers in a few calls</summary>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="backing">Kind of blob the buffers will be written into and read from</param>
+  void measureBulk(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const Nuclex::Storage::Benchmarks::BlobBacking &backing
+  ) {
+    using Nuclex::Storage::Blob;
+    using Nuclex::Storage::Binary::BinaryBlobReader;
+    using Nuclex::Storage::Binary::BinaryBlobWriter;
+
+    std::string suffix = u8"/" + std::to_string(BulkCallByteCount / 1024) + u8" KiB calls/";
+    std::string writeName = u8"Binary/Write/bulk" + suffix + backing.Name;
+    std::string readName = u8"Binary/Read/bulk" + suffix + backing.Name;
+    if(!runner.IsSelected(writeName) && !runner.IsSelected(readName)) {
+      return;
+    }
+
+    std::vector<std::uint8_t> contents(BulkByteCount);
+    for(std::size_t index = 0; index < BulkByteCount; ++index) {
+      contents[index] = static_cast<std::uint8_t>(index * 31 + (index >> 8));
+    }
+
+    const std::size_t callCount = BulkByteCount / BulkCallByteCount;
+    runner.Measure(
+      writeName, callCount, BulkByteCount,
+      [&backing, &contents, callCount]() {
+        BinaryBlobWriter writer(backing.CreateEmpty());
+        for(std::size_t index = 0; index < callCount; ++index) {
+          writer.Write(contents.data() + index * BulkCallByteCount, BulkCallByteCount);
+        }
+        writer.Flush();
+      }
+    );
+
+    std::shared_ptr<const Blob> blob = Nuclex::Storage::Benchmarks::CreateFilledBlob(
+      backing, contents
+    );
+    std::vector<std::uint8_t> buffer(BulkCallByteCount);
+    runner.Measure(
+      readName, callCount, BulkByteCount,
+      [&blob, &buffer, callCount]() {
+        BinaryBlobReader reader(blob);
+        std::size_t total = 0;
+        for(std::size_t index = 0; index < callCount; ++index) {
+          reader.Read(buffer.data(), BulkCallByteCount);
+          total += buffer[index];
+        }
+        sink = total;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures writing and reading arrays of variable-length integers</summary>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="backing">Kind of blob the arrays will be written into and read from</param>
+  /// <remarks>
+  ///   The values are small and ascending, like the ids and indices these encodings
+  ///   are meant for, so both the varint and the delta encoding have something to gain.
+  /// </remarks>
+  void measureVarintArrays(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const Nuclex::Storage::Benchmarks::BlobBacking &backing
+  ) {
+    using Nuclex::Storage::Blob;
+    using Nuclex::Storage::Binary::BinaryBlobReader;
+    using Nuclex::Storage::Binary::BinaryBlobWriter;
+
+    std::vector<std::uint32_t> values(FieldCount);
+    for(std::size_t index = 0; index < FieldCount; ++index) {
+      values[index] = static_cast<std::uint32_t>(index * 3 + (index % 7));
+    }
+    std::vector<std::uint32_t> readValues(FieldCount);
+
+    const char *const encodings[] = { u8"varint array", u8"delta array" };
+    for(std::size_t encoding = 0; encoding < 2; ++encoding) {
+      std::string writeName = (
+        std::string(u8"Binary/Write/") + encodings[encoding] + u8"/" + backing.Name
+      );
+      std::string readName = (
+        std::string(u8"Binary/Read/") + encodings[encoding] + u8"/" + backing.Name
+      );
+      if(!runner.IsSelected(writeName) && !runner.IsSelected(readName)) {
+        continue;
+      }
+
+      bool delta = (encoding == 1);
+      auto write = [&values, delta](BinaryBlobWriter &writer) {
+        if(delta) {
+          writer.WriteDeltaArray(values.data(), values.size());
+        } else {
+          writer.WriteVarintArray(values.data(), values.size());
+        }
+        writer.Flush();
+      };
+
+      std::shared_ptr<Blob> written = backing.CreateEmpty();
+      {
+        BinaryBlobWriter writer(written);
+        write(writer);
+      }
+      std::size_t byteCount = static_cast<std::size_t>(written->GetSize());
+
+      runner.Measure(
+        writeName, FieldCount, byteCount,
+        [&backing, &write]() {
+          BinaryBlobWriter writer(backing.CreateEmpty());
+          write(writer);
+        }
+      );
+
+      std::vector<std::uint8_t> contents(byteCount);
+      written->ReadAt(0, contents.data(), byteCount);
+      std::shared_ptr<const Blob> blob = Nuclex::Storage::Benchmarks::CreateFilledBlob(
+        backing, contents
+      );
+
+      runner.Measure(
+        readName, FieldCount, byteCount,
+        [&blob, &readValues, delta]() {
+          BinaryBlobReader reader(blob);
+          if(delta) {
+            reader.ReadDeltaArray(readValues.data(), readValues.size());
+          } else {
+            reader.ReadVarintArray(readValues.data(), readValues.size());
+          }
+          sink = readValues.back();
+        }
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RunBinaryBenchmark(
+    Support::Benchmarks::BenchmarkRunner &runner, const std::vector<BlobBacking> &backings
+  ) {
+    std::vector<std::uint8_t> uint8Values = makeValues<std::uint8_t>();
+    std::vector<std::uint16_t> uint16Values = makeValues<std::uint16_t>();
+    std::vector<std::uint32_t> uint32Values = makeValues<std::uint32_t>();
+    std::vector<std::uint64_t> uint64Values = makeValues<std::uint64_t>();
+    std::vector<float> floatValues = makeValues<float>();
+    std::vector<double> doubleValues = makeValues<double>();
+    std::vector<std::string> strings = makeStrings();
+
+    for(const BlobBacking &backing : backings) {
+      measureFields(runner, backing, u8"uint8", uint8Values);
+      measureFields(runner, backing, u8"uint16", uint16Values);
+      measureFields(runner, backing, u8"uint32", uint32Values);
+      measureFields(runner, backing, u8"uint64", uint64Values);
+      measureFields(runner, backing, u8"float", floatValues);
+      measureFields(runner, backing, u8"double", doubleValues);
+      measureFields(runner, backing, u8"string", strings);
+      measureBulk(runner, backing);
+      measureVarintArrays(runner, backing);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Benchmarks
@@ -0,0 +1,58 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BENCHMARKS_BINARYBENCHMARK_H
+#define NUCLEX_STORAGE_BENCHMARKS_BINARYBENCHMARK_H
+
+#include "Nuclex/Storage/Config.h"
+#include "BlobBackings.h"
+
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BenchmarkRunner;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
+
+namespace Nuclex { namespace Storage { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the throughput of the binary blob reader and writer</summary>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="backings">Kinds of blobs the measurements will be run on</param>
+  /// <remarks>
+  ///   Covers reading and writing individual fields of each primitive type, strings,
+  ///   bulk transfers and variable-length integer arrays.
+  /// </remarks>
+  void RunBinaryBenchmark(
+    Support::Benchmarks::BenchmarkRunner &runner, const std::vector<BlobBacking> &backings
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Benchmarks
+
+#endif // NUCLEX_STORAGE_BENCHMARKS_BINARYBENCHMARK_H
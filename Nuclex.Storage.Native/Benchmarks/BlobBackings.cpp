@@ -0,0 +1,116 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BlobBackings.h"
+
+#include "Nuclex/Storage/FileBlob.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+
+#include <cstdio> // for std::fopen(), std::remove()
+#include <stdexcept> // for std::runtime_error
+
+#if defined(NUCLEX_STORAGE_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h>
+#else
+#include <cstdlib> // for ::mkstemp()
+#include <unistd.h> // for ::close()
+#endif
+
+namespace Nuclex { namespace Storage { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TemporaryFile::TemporaryFile() {
+#if defined(NUCLEX_STORAGE_WIN32)
+    char directory[MAX_PATH + 1];
+    char path[MAX_PATH + 1];
+    ::GetTempPathA(MAX_PATH, directory);
+    if(::GetTempFileNameA(directory, "nsb", 0, path) == 0) {
+      throw std::runtime_error(u8"Could not create temporary file");
+    }
+    this->path.assign(path);
+#else
+    char path[] = "/tmp/nuclex-storage-benchmark-XXXXXX";
+    int fileDescriptor = ::mkstemp(path);
+    if(fileDescriptor == -1) {
+      throw std::runtime_error(u8"Could not create temporary file");
+    }
+    ::close(fileDescriptor);
+    this->path.assign(path);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TemporaryFile::~TemporaryFile() {
+    std::remove(this->path.c_str());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<FileBlob> TemporaryFile::OpenEmpty() const {
+    std::FILE *file = std::fopen(this->path.c_str(), u8"wb");
+    if(file == nullptr) {
+      throw std::runtime_error(u8"Could not empty temporary file");
+    }
+    std::fclose(file);
+
+    return std::make_shared<FileBlob>(this->path, true);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<BlobBacking> GetBlobBackings(const TemporaryFile &temporaryFile) {
+    std::vector<BlobBacking> backings(2);
+
+    backings[0].Name = u8"memory";
+    backings[0].CreateEmpty = []() { return std::make_shared<MemoryBlob>(); };
+
+    backings[1].Name = u8"file";
+    backings[1].CreateEmpty = [&temporaryFile]() { return temporaryFile.OpenEmpty(); };
+
+    return backings;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const Blob> CreateFilledBlob(
+    const BlobBacking &backing, const std::vector<std::uint8_t> &contents
+  ) {
+    std::shared_ptr<Blob> blob = backing.CreateEmpty();
+    blob->WriteAt(0, contents.data(), contents.size());
+    blob->Flush();
+
+    MemoryBlob *memoryBlob = dynamic_cast<MemoryBlob *>(blob.get());
+    if(memoryBlob != nullptr) {
+      memoryBlob->Seal();
+    }
+
+    return blob;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Benchmarks
@@ -0,0 +1,106 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BENCHMARKS_BLOBBACKINGS_H
+#define NUCLEX_STORAGE_BENCHMARKS_BLOBBACKINGS_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstdint> // for std::uint8_t
+#include <functional> // for std::function
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+  class FileBlob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Uniquely named file the file-backed measurements work on</summary>
+  class TemporaryFile {
+
+    /// <summary>Creates a new, empty temporary file</summary>
+    public: TemporaryFile();
+
+    /// <summary>Deletes the temporary file</summary>
+    public: ~TemporaryFile();
+
+    /// <summary>Empties the file and opens it as a blob</summary>
+    /// <returns>A writable file blob accessing the empty file</returns>
+    /// <remarks>
+    ///   File blobs never shrink the file they access, so without emptying it first,
+    ///   a reader would see leftovers from longer documents written earlier.
+    /// </remarks>
+    public: std::shared_ptr<FileBlob> OpenEmpty() const;
+
+    /// <summary>Path of the temporary file</summary>
+    private: std::string path;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Kind of blob the measurements are repeated on</summary>
+  struct BlobBacking {
+
+    /// <summary>Name under which the kind of blob appears in the results</summary>
+    public: std::string Name;
+    /// <summary>Creates a new, empty blob of this kind</summary>
+    public: std::function<std::shared_ptr<Blob>()> CreateEmpty;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lists the kinds of blobs every measurement is run on</summary>
+  /// <param name="temporaryFile">File the file-backed blobs will access</param>
+  /// <returns>A memory-backed and a file-backed kind of blob</returns>
+  std::vector<BlobBacking> GetBlobBackings(const TemporaryFile &temporaryFile);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a blob of the specified kind holding the specified contents</summary>
+  /// <param name="backing">Kind of blob that will be created</param>
+  /// <param name="contents">Bytes the blob will contain</param>
+  /// <returns>A blob holding the contents, ready to be read from</returns>
+  /// <remarks>
+  ///   Memory blobs are sealed so readers get to use their lock-free contiguous span
+  ///   the way they would on a document loaded ahead of time.
+  /// </remarks>
+  std::shared_ptr<const Blob> CreateFilledBlob(
+    const BlobBacking &backing, const std::vector<std::uint8_t> &contents
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Benchmarks
+
+#endif // NUCLEX_STORAGE_BENCHMARKS_BLOBBACKINGS_H
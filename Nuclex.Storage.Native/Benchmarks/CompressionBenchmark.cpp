@@ -0,0 +1,774 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "CompressionBenchmark.h"
+#include "../../Nuclex.Support.Native/Benchmarks/BenchmarkRunner.h"
+
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+
+#include <chrono> // for std::chrono::steady_clock
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <cstdio> // for std::printf(), std::fopen()
+#include <cstring> // for std::memcpy()
+#include <exception> // for std::exception
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+#if !defined(NUCLEX_STORAGE_WIN32)
+#include <sys/resource.h> // for ::getrusage()
+#include <sys/wait.h> // for ::waitpid()
+#include <unistd.h> // for ::fork(), ::pipe(), ::read(), ::write(), ::_exit()
+#endif
+
+#if defined(NUCLEX_PGO_INSTRUMENTED)
+#if defined(__clang__)
+extern "C" int __llvm_profile_write_file(void); // from clang's profiling runtime
+#else
+extern "C" void __gcov_dump(void); // from GCC's profiling runtime
+#endif
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Clock frequency the measured times are converted to cycles at</summary>
+  /// <remarks>Same basis as the metrics tables of the compression algorithms</remarks>
+  const double NominalCyclesPerSecond = 3000000000.0;
+
+  /// <summary>Maximum number of times each measurement is repeated</summary>
+  const std::size_t MaximumMeasurementRunCount = 10;
+
+  /// <summary>Size of each file in the synthetic corpus</summary>
+  const std::size_t SyntheticFileByteCount = 1024 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>A file in the corpus the compression algorithms are run on</summary>
+  struct CorpusFile {
+
+    /// <summary>Name displayed for the file in the results</summary>
+    public: std::string Name;
+    /// <summary>Contents of the file</summary>
+    public: std::vector<std::uint8_t> Contents;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Results of running a compression algorithm on a single file</summary>
+  /// <remarks>
+  ///   Plain data because it is sent through a pipe when the algorithm is
+  ///   benchmarked in a child process.
+  /// </remarks>
+  struct FileResult {
+
+    /// <summary>Whether the file was compressed and decompressed successfully</summary>
+    public: bool Succeeded;
+    /// <summary>Fastest time it took to compress the file</summary>
+    public: double CompressionSeconds;
+    /// <summary>Fastest time it took to decompress the file</summary>
+    public: double DecompressionSeconds;
+    /// <summary>Number of bytes the compressed file occupied</summary>
+    public: std::uint64_t CompressedByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Simple linear congruential generator so the corpus is reproducible</summary>
+  class Random {
+
+    /// <summary>Initializes a new random number generator</summary>
+    /// <param name="seed">Seed from which the random numbers will be generated</param>
+    public: Random(std::uint32_t seed) :
+      state(seed) {}
+
+    /// <summary>Generates the next random number</summary>
+    /// <returns>A random number between 0 and 32767</returns>
+    public: std::uint32_t Next() {
+      this->state = this->state * 1103515245U + 12345U;
+      return (this->state >> 16) & 0x7FFFU;
+    }
+
+    /// <summary>Current state of the random number generator</summary>
+    private: std::uint32_t state;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Closes a C file when it goes out of scope</summary>
+  class FileScope {
+
+    /// <summary>Initializes a new file closer</summary>
+    /// <param name="file">File that will be closed</param>
+    public: FileScope(std::FILE *file) :
+      file(file) {}
+
+    /// <summary>Closes the file</summary>
+    public: ~FileScope() {
+      std::fclose(this->file);
+    }
+
+    /// <summary>File that will be closed</summary>
+    private: std::FILE *file;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates English-looking text</summary>
+  /// <returns>A corpus file containing the text</returns>
+  CorpusFile makeText() {
+    static const char *const words[] = {
+      "the", "of", "and", "to", "in", "is", "that", "it", "was", "for", "on", "are", "with",
+      "as", "they", "be", "at", "one", "have", "this", "from", "by", "hot", "word", "but",
+      "what", "some", "we", "can", "out", "other", "were", "all", "there", "when", "up",
+      "use", "your", "how", "said", "an", "each", "she", "which", "do", "their", "time",
+      "if", "will", "way", "about", "many", "then", "them", "write", "would", "like", "so",
+      "these", "her", "long", "make", "thing", "see", "him", "two", "has", "look", "more",
+      "compression", "storage", "archive", "texture", "level", "character", "inventory"
+    };
+    const std::size_t wordCount = sizeof(words) / sizeof(words[0]);
+
+    CorpusFile file;
+    file.Name = u8"text";
+
+    Random random(1);
+    std::string text;
+    while(text.size() < SyntheticFileByteCount) {
+      std::size_t sentenceLength = 5 + random.Next() % 15;
+      for(std::size_t index = 0; index < sentenceLength; ++index) {
+        text.append(words[random.Next() % wordCount]);
+        text.push_back((index + 1 < sentenceLength) ? ' ' : '.');
+      }
+      text.push_back((random.Next() % 8 == 0) ? '\n' : ' ');
+    }
+
+    file.Contents.assign(text.begin(), text.begin() + SyntheticFileByteCount);
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates an XML document resembling a game's asset manifest</summary>
+  /// <returns>A corpus file containing the XML document</returns>
+  CorpusFile makeXml() {
+    static const char *const kinds[] = { "texture", "mesh", "sound", "script", "material" };
+
+    CorpusFile file;
+    file.Name = u8"xml";
+
+    Random random(2);
+    std::string xml(u8"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<assets>\n");
+    for(std::size_t index = 0; xml.size() < SyntheticFileByteCount; ++index) {
+      const char *kind = kinds[random.Next() % 5];
+      xml.append(u8"  <asset id=\"");
+      xml.append(std::to_string(index));
+      xml.append(u8"\" kind=\"");
+      xml.append(kind);
+      xml.append(u8"\" size=\"");
+      xml.append(std::to_string(random.Next() * 37));
+      xml.append(u8"\">\n    <path>Content/");
+      xml.append(kind);
+      xml.append(u8"s/");
+      xml.append(std::to_string(random.Next()));
+      xml.append(u8".bin</path>\n  </asset>\n");
+    }
+
+    file.Contents.assign(xml.begin(), xml.begin() + SyntheticFileByteCount);
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates binary records like those found in saved games</summary>
+  /// <returns>A corpus file containing the binary records</returns>
+  CorpusFile makeBinary() {
+    CorpusFile file;
+    file.Name = u8"binary";
+    file.Contents.reserve(SyntheticFileByteCount);
+
+    Random random(3);
+    float position[3] = { 0.0f, 0.0f, 0.0f };
+    for(std::uint32_t index = 0; file.Contents.size() < SyntheticFileByteCount; ++index) {
+      // Record: id, type, three floats that change slowly, flags and a random checksum
+      std::uint32_t fields[7];
+      fields[0] = index;
+      fields[1] = random.Next() % 16;
+      for(std::size_t axis = 0; axis < 3; ++axis) {
+        position[axis] += static_cast<float>(random.Next() % 100) / 100.0f - 0.5f;
+        std::memcpy(&fields[2 + axis], &position[axis], sizeof(float));
+      }
+      fields[5] = (random.Next() % 4 == 0) ? 1U : 0U;
+      fields[6] = (random.Next() << 15) | random.Next();
+
+      const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(fields);
+      file.Contents.insert(file.Contents.end(), bytes, bytes + sizeof(fields));
+    }
+
+    file.Contents.resize(SyntheticFileByteCount);
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates uncompressed RGBA pixels of a noisy gradient</summary>
+  /// <returns>A corpus file containing the pixels</returns>
+  CorpusFile makeImage() {
+    const std::size_t width = 512;
+
+    CorpusFile file;
+    file.Name = u8"image";
+    file.Contents.resize(SyntheticFileByteCount);
+
+    Random random(4);
+    for(std::size_t index = 0; index < SyntheticFileByteCount / 4; ++index) {
+      std::size_t x = index % width;
+      std::size_t y = index / width;
+      std::uint8_t noise = static_cast<std::uint8_t>(random.Next() % 8);
+      file.Contents[index * 4 + 0] = static_cast<std::uint8_t>(x / 2 + noise);
+      file.Contents[index * 4 + 1] = static_cast<std::uint8_t>(y / 2 + noise);
+      file.Contents[index * 4 + 2] = static_cast<std::uint8_t>((x + y) / 4 + noise);
+      file.Contents[index * 4 + 3] = 255;
+    }
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a file from disk into the corpus</summary>
+  /// <param name="path">Path of the file that will be loaded</param>
+  /// <returns>A corpus file containing the file's contents</returns>
+  CorpusFile loadFile(const std::string &path) {
+    std::FILE *fileHandle = std::fopen(path.c_str(), u8"rb");
+    if(fileHandle == nullptr) {
+      throw std::runtime_error(u8"Could not open corpus file " + path);
+    }
+    FileScope fileScope(fileHandle);
+
+    CorpusFile file;
+    file.Name = path;
+
+    std::uint8_t buffer[65536];
+    for(;;) {
+      std::size_t byteCount = std::fread(buffer, 1, sizeof(buffer), fileHandle);
+      if(byteCount == 0) {
+        break;
+      }
+      file.Contents.insert(file.Contents.end(), buffer, buffer + byteCount);
+    }
+
+    return file;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses a buffer in one go</summary>
+  /// <param name="compressor">Compressor that will be used</param>
+  /// <param name="data">Data that will be compressed</param>
+  /// <param name="compressed">Receives the compressed data</param>
+  void compress(
+    Nuclex::Storage::Compression::Compressor &compressor,
+    const std::vector<std::uint8_t> &data, std::vector<std::uint8_t> &compressed
+  ) {
+    using Nuclex::Storage::Compression::StopReason;
+
+    compressed.resize(data.size() + 65536);
+    std::size_t compressedByteCount = 0;
+
+    const std::uint8_t *input = data.data();
+    std::size_t remainingByteCount = data.size();
+    for(;;) {
+      std::size_t inputByteCount = remainingByteCount;
+      std::size_t outputByteCount = compressed.size() - compressedByteCount;
+      StopReason reason = compressor.Process(
+        input, inputByteCount, compressed.data() + compressedByteCount, outputByteCount
+      );
+      input += inputByteCount;
+      remainingByteCount -= inputByteCount;
+      compressedByteCount += outputByteCount;
+      if(reason == StopReason::InputBufferExhausted) {
+        break;
+      }
+      compressed.resize(compressed.size() * 2);
+    }
+
+    for(;;) {
+      std::size_t outputByteCount = compressed.size() - compressedByteCount;
+      StopReason reason = compressor.Finish(
+        compressed.data() + compressedByteCount, outputByteCount
+      );
+      compressedByteCount += outputByteCount;
+      if(reason == StopReason::Finished) {
+        break;
+      }
+      compressed.resize(compressed.size() * 2);
+    }
+
+    compressed.resize(compressedByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decompresses a buffer in one go</summary>
+  /// <param name="decompressor">Decompressor that will be used</param>
+  /// <param name="compressed">Compressed data that will be decompressed</param>
+  /// <param name="data">Receives the decompressed data, must have the original size</param>
+  /// <returns>True if the data decompressed to exactly the original size</returns>
+  bool decompress(
+    Nuclex::Storage::Compression::Decompressor &decompressor,
+    const std::vector<std::uint8_t> &compressed, std::vector<std::uint8_t> &data
+  ) {
+    using Nuclex::Storage::Compression::StopReason;
+
+    const std::uint8_t *input = compressed.data();
+    std::size_t remainingByteCount = compressed.size();
+    std::uint8_t *output = data.data();
+    std::size_t remainingOutputByteCount = data.size();
+    for(;;) {
+      // Once the output is full, the decompressor still has to report the end of
+      // the stream. Hand it a spare buffer which it must not write anything into.
+      std::uint8_t spare[16];
+      std::uint8_t *target = output;
+      std::size_t outputByteCount = remainingOutputByteCount;
+      if(outputByteCount == 0) {
+        target = spare;
+        outputByteCount = sizeof(spare);
+      }
+
+      std::size_t inputByteCount = remainingByteCount;
+      StopReason reason = decompressor.Process(
+        input, inputByteCount, target, outputByteCount
+      );
+      input += inputByteCount;
+      remainingByteCount -= inputByteCount;
+      if(target == spare) {
+        return (reason == StopReason::Finished) && (outputByteCount == 0);
+      }
+
+      output += outputByteCount;
+      remainingOutputByteCount -= outputByteCount;
+      if(reason == StopReason::Finished) {
+        return (remainingOutputByteCount == 0);
+      }
+      if(reason == StopReason::InputBufferExhausted) {
+        return false;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures how long an action takes, keeping the fastest of several runs</summary>
+  /// <typeparam name="TAction">Type of action that will be measured</typeparam>
+  /// <param name="minimumSeconds">Minimum time the action is repeated for</param>
+  /// <param name="action">Action that will be measured</param>
+  /// <returns>The fastest time the action took in seconds</returns>
+  template<typename TAction>
+  double measure(double minimumSeconds, TAction &&action) {
+    typedef std::chrono::steady_clock Clock;
+
+    double fastestRun = 0.0;
+    double totalTime = 0.0;
+    for(std::size_t run = 0; run < MaximumMeasurementRunCount; ++run) {
+      if((run > 0) && (totalTime >= minimumSeconds)) {
+        break;
+      }
+
+      Clock::time_point start = Clock::now();
+      action();
+      double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+      if((run == 0) || (elapsed < fastestRun)) {
+        fastestRun = elapsed;
+      }
+      totalTime += elapsed;
+    }
+
+    return fastestRun;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs a compression algorithm on all files in the corpus</summary>
+  /// <param name="algorithm">Compression algorithm that will be benchmarked</param>
+  /// <param name="corpus">Files the algorithm will be run on</param>
+  /// <param name="minimumSeconds">Minimum time each measurement is repeated for</param>
+  /// <returns>The results for each file in the corpus</returns>
+  std::vector<FileResult> benchmark(
+    const Nuclex::Storage::Compression::CompressionAlgorithm &algorithm,
+    const std::vector<CorpusFile> &corpus, double minimumSeconds
+  ) {
+    using Nuclex::Storage::Compression::Compressor;
+    using Nuclex::Storage::Compression::Decompressor;
+
+    std::vector<FileResult> results(corpus.size());
+    for(std::size_t index = 0; index < corpus.size(); ++index) {
+      const std::vector<std::uint8_t> &contents = corpus[index].Contents;
+      FileResult &result = results[index];
+      result.Succeeded = false;
+
+      try {
+        std::unique_ptr<Compressor> compressor = algorithm.CreateCompressor();
+        std::unique_ptr<Decompressor> decompressor = algorithm.CreateDecompressor();
+        std::vector<std::uint8_t> compressed;
+        std::vector<std::uint8_t> decompressed(contents.size());
+
+        result.CompressionSeconds = measure(
+          minimumSeconds,
+          [&]() {
+            compressor->Reset();
+            compress(*compressor, contents, compressed);
+          }
+        );
+        result.CompressedByteCount = compressed.size();
+
+        bool intact = true;
+        result.DecompressionSeconds = measure(
+          minimumSeconds,
+          [&]() {
+            decompressor->Reset();
+            intact &= decompress(*decompressor, compressed, decompressed);
+          }
+        );
+        result.Succeeded = intact && (decompressed == contents);
+      }
+      catch(const std::exception &error) {
+        std::fprintf(
+          stderr, u8"%s failed on %s: %s\n",
+          algorithm.GetName().c_str(), corpus[index].Name.c_str(), error.what()
+        );
+      }
+    }
+
+    return results;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_PGO_INSTRUMENTED)
+  /// <summary>Writes the execution counts of a profiling build to disk</summary>
+  /// <remarks>
+  ///   Instrumented builds normally write their counts when the process exits, but
+  ///   the benchmark children end through _exit(), which skips that. Since all the
+  ///   compression work happens in the children, their counts are the ones that
+  ///   matter when this benchmark is used to train a profile-guided optimization build.
+  /// </remarks>
+  void writeExecutionProfile() {
+#if defined(__clang__)
+    __llvm_profile_write_file();
+#else
+    __gcov_dump();
+#endif
+  }
+#endif // defined(NUCLEX_PGO_INSTRUMENTED)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_STORAGE_WIN32)
+  /// <summary>Determines the peak memory use of the running process</summary>
+  /// <returns>The peak resident set size in kilobytes</returns>
+  std::uint64_t getPeakResidentKilobytes() {
+    struct ::rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Benchmarks an algorithm in a child process to measure its memory use</summary>
+  /// <param name="algorithm">Compression algorithm that will be benchmarked</param>
+  /// <param name="corpus">Files the algorithm will be run on</param>
+  /// <param name="minimumSeconds">Minimum time each measurement is repeated for</param>
+  /// <param name="results">Receives the results for each file in the corpus</param>
+  /// <returns>
+  ///   The additional memory in kilobytes the child process needed at its peak
+  /// </returns>
+  /// <remarks>
+  ///   The child process starts out with the peak memory use of the benchmark at
+  ///   the time it was forked, so whatever the algorithm allocates on top of that
+  ///   is attributed to the algorithm alone.
+  /// </remarks>
+  std::uint64_t benchmarkInChildProcess(
+    const Nuclex::Storage::Compression::CompressionAlgorithm &algorithm,
+    const std::vector<CorpusFile> &corpus, double minimumSeconds,
+    std::vector<FileResult> &results
+  ) {
+    int pipeDescriptors[2];
+    if(::pipe(pipeDescriptors) != 0) {
+      throw std::runtime_error(u8"Could not create a pipe to the benchmark process");
+    }
+
+    ::pid_t childProcessId = ::fork();
+    if(childProcessId == 0) {
+      ::close(pipeDescriptors[0]);
+
+      std::uint64_t residentKilobytesBefore = getPeakResidentKilobytes();
+      std::vector<FileResult> childResults = benchmark(algorithm, corpus, minimumSeconds);
+      std::uint64_t peakKilobytes = getPeakResidentKilobytes() - residentKilobytesBefore;
+
+      ssize_t written = ::write(pipeDescriptors[1], &peakKilobytes, sizeof(peakKilobytes));
+      written += ::write(
+        pipeDescriptors[1], childResults.data(), childResults.size() * sizeof(FileResult)
+      );
+      ::close(pipeDescriptors[1]);
+#if defined(NUCLEX_PGO_INSTRUMENTED)
+      writeExecutionProfile();
+#endif
+      ::_exit((written > 0) ? 0 : 1);
+    }
+
+    ::close(pipeDescriptors[1]);
+    if(childProcessId < 0) {
+      ::close(pipeDescriptors[0]);
+      throw std::runtime_error(u8"Could not fork the benchmark process");
+    }
+
+    // Collect the results. If the child crashed, the results will be incomplete
+    std::vector<std::uint8_t> received;
+    std::uint8_t buffer[4096];
+    for(;;) {
+      ssize_t readByteCount = ::read(pipeDescriptors[0], buffer, sizeof(buffer));
+      if(readByteCount <= 0) {
+        break;
+      }
+      received.insert(received.end(), buffer, buffer + readByteCount);
+    }
+    ::close(pipeDescriptors[0]);
+    ::waitpid(childProcessId, nullptr, 0);
+
+    std::uint64_t peakKilobytes = 0;
+    results.resize(corpus.size());
+    if(received.size() == sizeof(peakKilobytes) + corpus.size() * sizeof(FileResult)) {
+      std::memcpy(&peakKilobytes, received.data(), sizeof(peakKilobytes));
+      std::memcpy(
+        results.data(), received.data() + sizeof(peakKilobytes),
+        corpus.size() * sizeof(FileResult)
+      );
+    } else {
+      for(std::size_t index = 0; index < results.size(); ++index) {
+        results[index].Succeeded = false;
+      }
+    }
+
+    return peakKilobytes;
+  }
+#endif // !defined(NUCLEX_STORAGE_WIN32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a number of bytes processed in some time to MiB/s</summary>
+  /// <param name="byteCount">Number of bytes that have been processed</param>
+  /// <param name="seconds">Time it took to process the bytes</param>
+  /// <returns>The throughput in MiB per second</returns>
+  double toMegabytesPerSecond(std::uint64_t byteCount, double seconds) {
+    if(seconds <= 0.0) {
+      return 0.0;
+    }
+    return static_cast<double>(byteCount) / seconds / (1024.0 * 1024.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds the name under which a measurement is recorded</summary>
+  /// <param name="operation">Operation that was measured, compress or decompress</param>
+  /// <param name="algorithm">Compression algorithm that was measured</param>
+  /// <param name="file">Corpus file the algorithm was run on</param>
+  /// <returns>The unique name of the measurement</returns>
+  std::string getMeasurementName(
+    const char *operation,
+    const Nuclex::Storage::Compression::CompressionAlgorithm &algorithm,
+    const CorpusFile &file
+  ) {
+    std::string name(u8"Compression/");
+    name.append(operation);
+    name.push_back('/');
+    name.append(algorithm.GetName());
+    name.push_back('/');
+    name.append(file.Name);
+    return name;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether any measurement of an algorithm passes the filter</summary>
+  /// <param name="runner">Runner whose filter will be checked</param>
+  /// <param name="algorithm">Compression algorithm that will be checked</param>
+  /// <param name="corpus">Files the algorithm would be run on</param>
+  /// <returns>True if the algorithm needs to be run</returns>
+  bool isSelected(
+    const Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const Nuclex::Storage::Compression::CompressionAlgorithm &algorithm,
+    const std::vector<CorpusFile> &corpus
+  ) {
+    for(std::size_t index = 0; index < corpus.size(); ++index) {
+      bool isAnySelected = (
+        runner.IsSelected(getMeasurementName(u8"Compress", algorithm, corpus[index])) ||
+        runner.IsSelected(getMeasurementName(u8"Decompress", algorithm, corpus[index]))
+      );
+      if(isAnySelected) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records a measurement taken in the benchmark process if it was selected</summary>
+  /// <param name="runner">Runner the measurement will be recorded in</param>
+  /// <param name="name">Unique name of the measurement</param>
+  /// <param name="seconds">Fastest time it took to process the file</param>
+  /// <param name="byteCount">Size of the uncompressed file in bytes</param>
+  void record(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const std::string &name, double seconds, std::size_t byteCount
+  ) {
+    if(runner.IsSelected(name)) {
+      Nuclex::Support::Benchmarks::BenchmarkResult result;
+      result.Name = name;
+      result.Seconds = seconds;
+      result.OperationCount = 1;
+      result.ByteCount = byteCount;
+      runner.Record(result);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RunCompressionBenchmark(
+    Support::Benchmarks::BenchmarkRunner &runner,
+    const std::vector<std::string> &corpusPaths, double minimumSeconds, bool printTables
+  ) {
+    using Nuclex::Storage::Compression::CompressionAlgorithm;
+    using Nuclex::Storage::Compression::CompressionAlgorithmSelector;
+
+    std::vector<CorpusFile> corpus;
+    for(std::size_t index = 0; index < corpusPaths.size(); ++index) {
+      corpus.push_back(loadFile(corpusPaths[index]));
+    }
+    if(corpus.empty()) {
+      corpus.push_back(makeText());
+      corpus.push_back(makeXml());
+      corpus.push_back(makeBinary());
+      corpus.push_back(makeImage());
+    }
+
+    CompressionAlgorithmSelector selector;
+    selector.AddBuiltInAlgorithms();
+
+    std::string tables;
+    std::printf(
+      u8"%-52s %-10s %7s %12s %12s %10s\n",
+      u8"Algorithm", u8"File", u8"Ratio", u8"Comp MiB/s", u8"Decomp MiB/s", u8"Peak KiB"
+    );
+    for(std::size_t index = 0; index < selector.CountAlgorithms(); ++index) {
+      const CompressionAlgorithm &algorithm = *selector.GetAlgorithm(index);
+      if(!isSelected(runner, algorithm, corpus)) {
+        continue;
+      }
+
+      std::vector<FileResult> results;
+      std::uint64_t peakKilobytes = 0;
+#if defined(NUCLEX_STORAGE_WIN32)
+      results = benchmark(algorithm, corpus, minimumSeconds); // Peak memory not isolated
+#else
+      peakKilobytes = benchmarkInChildProcess(algorithm, corpus, minimumSeconds, results);
+#endif
+
+      std::uint64_t totalByteCount = 0;
+      std::uint64_t totalCompressedByteCount = 0;
+      double totalCompressionSeconds = 0.0;
+      for(std::size_t fileIndex = 0; fileIndex < corpus.size(); ++fileIndex) {
+        const FileResult &result = results[fileIndex];
+        const char *fileName = corpus[fileIndex].Name.c_str();
+        if(!result.Succeeded) {
+          std::printf(u8"%-52s %-10s %s\n", algorithm.GetName().c_str(), fileName, u8"FAILED");
+          continue;
+        }
+
+        std::uint64_t byteCount = corpus[fileIndex].Contents.size();
+        double ratio = static_cast<double>(result.CompressedByteCount) / byteCount;
+        std::printf(
+          u8"%-52s %-10s %7.3f %12.1f %12.1f %10llu\n",
+          algorithm.GetName().c_str(), fileName, ratio,
+          toMegabytesPerSecond(byteCount, result.CompressionSeconds),
+          toMegabytesPerSecond(byteCount, result.DecompressionSeconds),
+          static_cast<unsigned long long>(peakKilobytes)
+        );
+
+        record(
+          runner, getMeasurementName(u8"Compress", algorithm, corpus[fileIndex]),
+          result.CompressionSeconds, static_cast<std::size_t>(byteCount)
+        );
+        record(
+          runner, getMeasurementName(u8"Decompress", algorithm, corpus[fileIndex]),
+          result.DecompressionSeconds, static_cast<std::size_t>(byteCount)
+        );
+
+        totalByteCount += byteCount;
+        totalCompressedByteCount += result.CompressedByteCount;
+        totalCompressionSeconds += result.CompressionSeconds;
+      }
+
+      // Summarize the algorithm in the form used by the shipped metrics tables
+      if(totalByteCount > 0) {
+        double cyclesPerKilobyte = (
+          totalCompressionSeconds * NominalCyclesPerSecond * 1024.0 / totalByteCount
+        );
+        double ratio = static_cast<double>(totalCompressedByteCount) / totalByteCount;
+
+        char line[256];
+        std::snprintf(
+          line, sizeof(line), u8"    { %6.0f, %.3ff }, // ~%.0f MiB/s, %s (shipped: %u, %.3f)\n",
+          cyclesPerKilobyte, ratio,
+          toMegabytesPerSecond(totalByteCount, totalCompressionSeconds),
+          algorithm.GetName().c_str(),
+          static_cast<unsigned>(algorithm.GetCompressionCyclesPerKilobyte()),
+          algorithm.GetAverageCompressionRatio()
+        );
+        tables.append(line);
+      }
+    }
+
+    if(printTables) {
+      std::printf(u8"\nMeasured metrics (cycles per KiB at 3 GHz, compression ratio):\n");
+      std::printf(u8"%s", tables.c_str());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Benchmarks
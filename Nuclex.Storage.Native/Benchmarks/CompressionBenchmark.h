@@ -0,0 +1,68 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BENCHMARKS_COMPRESSIONBENCHMARK_H
+#define NUCLEX_STORAGE_BENCHMARKS_COMPRESSIONBENCHMARK_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BenchmarkRunner;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
+
+namespace Nuclex { namespace Storage { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the compression algorithms built into the library</summary>
+  /// <param name="runner">Runner that will record the measurements</param>
+  /// <param name="corpusPaths">
+  ///   Files the algorithms will be run on. If empty, a generated corpus of text, XML,
+  ///   binary records and image data is used.
+  /// </param>
+  /// <param name="minimumSeconds">Minimum time each measurement is repeated for</param>
+  /// <param name="printTables">
+  ///   Whether to print the results in the format of the metrics tables in the
+  ///   compression algorithm implementations
+  /// </param>
+  /// <remarks>
+  ///   Each algorithm runs in its own process to measure its peak memory, so the timings
+  ///   are taken there and recorded in the runner afterwards. Compression ratio and peak
+  ///   memory are printed as the algorithms complete.
+  /// </remarks>
+  void RunCompressionBenchmark(
+    Support::Benchmarks::BenchmarkRunner &runner,
+    const std::vector<std::string> &corpusPaths, double minimumSeconds, bool printTables
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Benchmarks
+
+#endif // NUCLEX_STORAGE_BENCHMARKS_COMPRESSIONBENCHMARK_H
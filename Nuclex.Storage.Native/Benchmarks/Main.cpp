@@ -0,0 +1,158 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "../../Nuclex.Support.Native/Benchmarks/BenchmarkRunner.h"
+#include "BinaryBenchmark.h"
+#include "BlobBackings.h"
+#include "CompressionBenchmark.h"
+#include "XmlBenchmark.h"
+
+#include <cstdio> // for std::printf()
+#include <cstdlib> // for std::atof()
+#include <cstring> // for std::strcmp(), std::strlen(), std::strncmp()
+#include <exception> // for std::exception
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a command line argument is an option and extracts its value</summary>
+  /// <param name="argument">Command line argument that will be checked</param>
+  /// <param name="option">Option including the equals sign, i.e. "--save="</param>
+  /// <param name="value">Receives the value of the option if the argument is the option</param>
+  /// <returns>True if the argument was the specified option</returns>
+  bool tryGetOption(const char *argument, const char *option, std::string &value) {
+    std::size_t optionLength = std::strlen(option);
+    if(std::strncmp(argument, option, optionLength) != 0) {
+      return false;
+    }
+
+    value.assign(argument + optionLength);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints the command line options of the benchmark executable</summary>
+  void printUsage() {
+    std::printf(
+      u8"Measures the compression algorithms built into Nuclex.Storage and the binary\n"
+      u8"and XML readers and writers on memory and file-backed blobs\n"
+      u8"\n"
+      u8"Without --corpus, the compression algorithms run on a generated corpus of text,\n"
+      u8"XML, binary records and image data. Each algorithm runs in its own process\n"
+      u8"to measure its peak memory.\n"
+      u8"\n"
+      u8"Options:\n"
+      u8"  --corpus=<path>       Add a file to the compression corpus (can be repeated)\n"
+      u8"  --xml=<path>          Also measure reading a real XML document (can be repeated)\n"
+      u8"  --filter=<text>       Only run benchmarks whose name contains the text\n"
+      u8"                        (for example Compression/, Binary/Read or /file)\n"
+      u8"  --min-time=<seconds>  Minimum time to repeat each benchmark for (default 0.5)\n"
+      u8"  --tables              Print the compression results in the format of the\n"
+      u8"                        metrics tables in the compression algorithm implementations\n"
+      u8"  --save=<path>         Save the results for later comparison\n"
+      u8"  --baseline=<path>     Compare against results saved by an earlier run\n"
+      u8"  --tolerance=<percent> Slowdown above which a result counts as regression\n"
+      u8"                        (default 10)\n"
+      u8"\n"
+      u8"Exits with 1 if any benchmark regressed compared to the baseline.\n"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+int main(int argumentCount, char *arguments[]) {
+  std::vector<std::string> corpusPaths;
+  std::vector<std::string> documentPaths;
+  std::string filter;
+  double minimumSeconds = 0.5;
+  bool printTables = false;
+  std::string savePath;
+  std::string baselinePath;
+  double tolerancePercent = 10.0;
+
+  for(int index = 1; index < argumentCount; ++index) {
+    std::string value;
+    if(std::strcmp(arguments[index], u8"--tables") == 0) {
+      printTables = true;
+    } else if(tryGetOption(arguments[index], u8"--corpus=", value)) {
+      corpusPaths.push_back(value);
+    } else if(tryGetOption(arguments[index], u8"--xml=", value)) {
+      documentPaths.push_back(value);
+    } else if(tryGetOption(arguments[index], u8"--filter=", value)) {
+      filter = value;
+    } else if(tryGetOption(arguments[index], u8"--min-time=", value)) {
+      minimumSeconds = std::atof(value.c_str());
+    } else if(tryGetOption(arguments[index], u8"--save=", value)) {
+      savePath = value;
+    } else if(tryGetOption(arguments[index], u8"--baseline=", value)) {
+      baselinePath = value;
+    } else if(tryGetOption(arguments[index], u8"--tolerance=", value)) {
+      tolerancePercent = std::atof(value.c_str());
+    } else {
+      printUsage();
+      return 2;
+    }
+  }
+
+  try {
+    Nuclex::Support::Benchmarks::BenchmarkRunner runner(minimumSeconds, filter);
+
+    Nuclex::Storage::Benchmarks::RunCompressionBenchmark(
+      runner, corpusPaths, minimumSeconds, printTables
+    );
+
+    Nuclex::Storage::Benchmarks::TemporaryFile temporaryFile;
+    std::vector<Nuclex::Storage::Benchmarks::BlobBacking> backings = (
+      Nuclex::Storage::Benchmarks::GetBlobBackings(temporaryFile)
+    );
+    Nuclex::Storage::Benchmarks::RunBinaryBenchmark(runner, backings);
+    Nuclex::Storage::Benchmarks::RunXmlBenchmark(runner, backings, documentPaths);
+
+    runner.PrintResults(stdout);
+
+    if(!savePath.empty()) {
+      runner.SaveResults(savePath);
+    }
+    if(!baselinePath.empty()) {
+      std::size_t regressionCount = runner.CompareToBaseline(
+        baselinePath, tolerancePercent / 100.0, stdout
+      );
+      if(regressionCount > 0) {
+        std::printf(u8"\n%u benchmark(s) regressed\n", static_cast<unsigned>(regressionCount));
+        return 1;
+      }
+    }
+  }
+  catch(const std::exception &error) {
+    std::fprintf(stderr, u8"Benchmark failed: %s\n", error.what());
+    return 2;
+  }
+
+  return 0;
+}
@@ -0,0 +1,240 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "XmlBenchmark.h"
+#include "../../Nuclex.Support.Native/Benchmarks/BenchmarkRunner.h"
+
+#include "Nuclex/Storage/Blob.h"
+#include "Nuclex/Storage/Xml/XmlBlobReader.h"
+#include "Nuclex/Storage/Xml/XmlBlobWriter.h"
+
+#include <cstdint> // for std::uint8_t, std::uint32_t
+#include <cstdio> // for std::fopen(), std::fread()
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string, std::to_string()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of entities in the generated level document</summary>
+  const std::size_t EntityCount = 20000;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives results so the compiler can not optimize the measured work away</summary>
+  volatile std::size_t sink;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a document resembling a game level with many entities</summary>
+  /// <param name="writer">Writer through which the document will be written</param>
+  /// <remarks>
+  ///   Each entity carries a few numeric and string attributes and two child elements,
+  ///   one of which has text content, so all kinds of read events show up.
+  /// </remarks>
+  void writeLevel(Nuclex::Storage::Xml::XmlBlobWriter &writer) {
+    static const char *const kinds[] = { u8"tree", u8"rock", u8"npc", u8"chest", u8"light" };
+
+    writer.WriteDeclaration();
+    writer.BeginElement(u8"level");
+    for(std::size_t index = 0; index < EntityCount; ++index) {
+      writer.BeginElement(u8"entity");
+      writer.BeginAttribute(u8"id");
+      writer.Write(static_cast<std::uint32_t>(index));
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"kind");
+      writer.Write(std::string(kinds[index % 5]));
+      writer.EndAttribute();
+
+      writer.BeginElement(u8"position");
+      writer.BeginAttribute(u8"x");
+      writer.Write(static_cast<float>(index % 1000) * 0.25f);
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"y");
+      writer.Write(static_cast<float>(index / 1000) * 0.5f);
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"z");
+      writer.Write(static_cast<float>(index % 7) - 3.0f);
+      writer.EndAttribute();
+      writer.EndElement();
+
+      writer.BeginElement(u8"script");
+      writer.Write(u8"OnInteract(entity_" + std::to_string(index) + u8")");
+      writer.EndElement();
+
+      writer.EndElement();
+    }
+    writer.EndElement();
+    writer.Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a file from disk into memory</summary>
+  /// <param name="path">Path of the file that will be loaded</param>
+  /// <returns>The contents of the file</returns>
+  std::vector<std::uint8_t> loadFile(const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), u8"rb");
+    if(file == nullptr) {
+      throw std::runtime_error(u8"Could not open XML document " + path);
+    }
+
+    std::vector<std::uint8_t> contents;
+    std::uint8_t buffer[65536];
+    for(;;) {
+      std::size_t byteCount = std::fread(buffer, 1, sizeof(buffer), file);
+      if(byteCount == 0) {
+        break;
+      }
+      contents.insert(contents.end(), buffer, buffer + byteCount);
+    }
+
+    std::fclose(file);
+    return contents;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads an XML document from start to end</summary>
+  /// <param name="blob">Blob containing the XML document</param>
+  /// <returns>The number of events the reader produced</returns>
+  /// <remarks>
+  ///   Looks at the attribute count of every element like a deserializer would, but
+  ///   doesn't convert any values so the measurement is dominated by the reader itself.
+  /// </remarks>
+  std::size_t readDocument(const std::shared_ptr<const Nuclex::Storage::Blob> &blob) {
+    using Nuclex::Storage::Xml::XmlBlobReader;
+    using Nuclex::Storage::Xml::XmlReadEvent;
+
+    XmlBlobReader reader(blob);
+
+    std::size_t eventCount = 0;
+    std::size_t attributeCount = 0;
+    for(;;) {
+      XmlReadEvent readEvent = reader.Read();
+      if(readEvent == XmlReadEvent::End) {
+        break;
+      }
+      if(readEvent == XmlReadEvent::ElementStart) {
+        attributeCount += reader.CountAttributes();
+      }
+      ++eventCount;
+    }
+
+    sink = attributeCount;
+    return eventCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures reading an XML document</summary>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="backing">Kind of blob the document will be read from</param>
+  /// <param name="documentName">Name of the document used in the measurement name</param>
+  /// <param name="contents">Contents of the XML document</param>
+  /// <remarks>
+  ///   The operation count is the number of read events, so the results show
+  ///   events per second next to megabytes per second.
+  /// </remarks>
+  void measureRead(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const Nuclex::Storage::Benchmarks::BlobBacking &backing,
+    const std::string &documentName, const std::vector<std::uint8_t> &contents
+  ) {
+    std::string name = u8"Xml/Read/" + documentName + u8"/" + backing.Name;
+    if(!runner.IsSelected(name)) {
+      return;
+    }
+
+    std::shared_ptr<const Nuclex::Storage::Blob> blob = (
+      Nuclex::Storage::Benchmarks::CreateFilledBlob(backing, contents)
+    );
+    std::size_t eventCount = readDocument(blob);
+
+    runner.Measure(
+      name, eventCount, contents.size(),
+      [&blob]() { readDocument(blob); }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the file name in a path</summary>
+  /// <param name="path">Path whose file name will be returned</param>
+  /// <returns>The file name of the specified path</returns>
+  std::string getFileName(const std::string &path) {
+    std::string::size_type separatorIndex = path.find_last_of(u8"/\\");
+    if(separatorIndex == std::string::npos) {
+      return path;
+    } else {
+      return path.substr(separatorIndex + 1);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RunXmlBenchmark(
+    Support::Benchmarks::BenchmarkRunner &runner, const std::vector<BlobBacking> &backings,
+    const std::vector<std::string> &documentPaths
+  ) {
+    for(const BlobBacking &backing : backings) {
+      std::string writeName = u8"Xml/Write/level/" + backing.Name;
+      if(runner.IsSelected(writeName) || runner.IsSelected(u8"Xml/Read/level/" + backing.Name)) {
+
+        // Writing the generated level also provides the document for the read measurement
+        std::shared_ptr<Blob> level = backing.CreateEmpty();
+        {
+          Xml::XmlBlobWriter writer(level);
+          writeLevel(writer);
+        }
+        std::vector<std::uint8_t> contents(static_cast<std::size_t>(level->GetSize()));
+        level->ReadAt(0, contents.data(), contents.size());
+
+        // Reported per entity since the writer has no events to count
+        runner.Measure(
+          writeName, EntityCount, contents.size(),
+          [&backing]() {
+            Xml::XmlBlobWriter writer(backing.CreateEmpty());
+            writeLevel(writer);
+          }
+        );
+
+        measureRead(runner, backing, u8"level", contents);
+      }
+
+      for(const std::string &path : documentPaths) {
+        measureRead(runner, backing, getFileName(path), loadFile(path));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Benchmarks
@@ -24,7 +24,21 @@ License along with this library
 #include "Nuclex/Storage/Config.h"
 #include "Nuclex/Storage/Binary/BinaryReader.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <vector>
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class MonotonicArena;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
 
 namespace Nuclex { namespace Storage {
 
@@ -40,6 +54,43 @@ namespace Nuclex { namespace Storage { namespace Binary {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Many strings stored back to back in a single buffer</summary>
+  /// <remarks>
+  ///   Filled by <see cref="BinaryBlobReader.ReadStringTable" />. Reading into the same
+  ///   table again reuses its memory, so once the table has grown large enough,
+  ///   reading strings no longer allocates any memory at all.
+  /// </remarks>
+  struct StringTable {
+
+    /// <summary>Counts the number of strings in the table</summary>
+    /// <returns>The number of strings the table holds</returns>
+    public: std::size_t CountStrings() const {
+      return this->Offsets.empty() ? 0 : (this->Offsets.size() - 1);
+    }
+
+    /// <summary>Looks up a string in the table</summary>
+    /// <param name="index">Index of the string that will be looked up</param>
+    /// <returns>The zero-terminated characters of the string</returns>
+    public: const char *GetString(std::size_t index) const {
+      return this->Characters.data() + this->Offsets[index];
+    }
+
+    /// <summary>Determines the length of a string in the table</summary>
+    /// <param name="index">Index of the string whose length will be determined</param>
+    /// <returns>The number of characters in the string, not counting the terminator</returns>
+    public: std::size_t GetLength(std::size_t index) const {
+      return this->Offsets[index + 1] - this->Offsets[index] - 1;
+    }
+
+    /// <summary>Characters of all strings, each followed by a terminating zero</summary>
+    public: std::vector<char> Characters;
+    /// <summary>Where each string begins in the characters, plus the end of the last</summary>
+    public: std::vector<std::size_t> Offsets;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Reads binary data from a blob</summary>
   /// <remarks>
   ///   <para>
@@ -56,12 +107,34 @@ namespace Nuclex { namespace Storage { namespace Binary {
   ///     mode (AMD/Intel x86, x64) or big endian mode (ARM, PowerPC) right after creating
   ///     it using the SetLittleEndian() method.
   ///   </para>
+  ///   <para>
+  ///     Small reads are served from a read window that is filled from the blob in one
+  ///     go, so reading individual fields doesn't call into the blob each time. If the
+  ///     blob is modified through other means while it is being read, call
+  ///     DiscardReadWindow() so the reader picks up the changes.
+  ///   </para>
+  ///   <para>
+  ///     Blobs that can provide direct access to their memory (memory-mapped files or
+  ///     sealed memory blobs) are read without a copy in the read window, the reader
+  ///     copies values straight out of the blob's memory.
+  ///   </para>
   /// </remarks>
-  class BinaryBlobReader : public BinaryReader {
+  class BinaryBlobReader final : public BinaryReader {
+
+    /// <summary>Number of bytes the read window holds unless specified otherwise</summary>
+    public: static const std::size_t DefaultReadWindowByteCount = 16384;
 
     /// <summary>Initializes a new binary file reader for the specified file</summary>
     /// <param name="blob">Blob the binary file reader will read from</param>
-    public: NUCLEX_STORAGE_API BinaryBlobReader(const std::shared_ptr<const Blob> &blob);
+    /// <param name="readWindowByteCount">
+    ///   Number of bytes that will be fetched from the blob at once. Between 4 KiB and
+    ///   64 KiB works well. Zero disables the read window and reads every field from
+    ///   the blob directly.
+    /// </param>
+    public: NUCLEX_STORAGE_API BinaryBlobReader(
+      const std::shared_ptr<const Blob> &blob,
+      std::size_t readWindowByteCount = DefaultReadWindowByteCount
+    );
 
     /// <summary>Destroys a binary data reader</summary>
     public: NUCLEX_STORAGE_API virtual ~BinaryBlobReader() override;
@@ -81,6 +154,14 @@ namespace Nuclex { namespace Storage { namespace Binary {
     /// <summary>Returns the number of bytes remaining to be read</summary>
     public: NUCLEX_STORAGE_API std::uint64_t GetRemainingBytes() const;
 
+    /// <summary>Forgets the data in the read window so it will be read again</summary>
+    /// <remarks>
+    ///   Only needed if the blob was changed while being read.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void DiscardReadWindow() {
+      this->windowByteCount = 0;
+    }
+
     /// <summary>Whether data should be read in little endian (x86) format<summary>
     /// <returns>True if data is read a little endian (x86) format, otherwise false</returns>
     public: NUCLEX_STORAGE_API bool IsLittleEndian() const override;
@@ -91,49 +172,73 @@ namespace Nuclex { namespace Storage { namespace Binary {
 
     /// <summary>Reads a boolean integer from the stream</summary>
     /// <param name="target">Address of a boolean the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(bool &target) override;
+    public: NUCLEX_STORAGE_API void Read(bool &target) override {
+      std::uint8_t flag;
+      readScalar(&flag, sizeof(flag));
+      target = (flag != 0);
+    }
 
     /// <summary>Reads an unsigned 8 bit integer from the stream</summary>
     /// <param name="target">Address of an 8 bit integer the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(std::uint8_t &target) override;
+    public: NUCLEX_STORAGE_API void Read(std::uint8_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads a signed 8 bit integer from the stream</summary>
     /// <param name="target">Address of an 8 bit integer the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(std::int8_t &target) override;
+    public: NUCLEX_STORAGE_API void Read(std::int8_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads an unsigned 16 bit integer from the stream</summary>
     /// <param name="target">Address of a 16 bit integer the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(std::uint16_t &target) override;
+    public: NUCLEX_STORAGE_API void Read(std::uint16_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads a signed 16 bit integer from the stream</summary>
     /// <param name="target">Address of a 16 bit integer the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(std::int16_t &target) override;
+    public: NUCLEX_STORAGE_API void Read(std::int16_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads an unsigned 32 bit integer from the stream</summary>
     /// <param name="target">Address of a 32 bit integer the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(std::uint32_t &target) override;
+    public: NUCLEX_STORAGE_API void Read(std::uint32_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads a signed 32 bit integer from the stream</summary>
     /// <param name="target">Address of a 32 bit integer the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(std::int32_t &target) override;
+    public: NUCLEX_STORAGE_API void Read(std::int32_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads an unsigned 64 bit integer from the stream</summary>
     /// <param name="target">Address of a 64 bit integer the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(std::uint64_t &target) override;
+    public: NUCLEX_STORAGE_API void Read(std::uint64_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads a signed 64 bit integer from the stream</summary>
     /// <param name="target">Address of a 64 bit integer the value will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(std::int64_t &target) override;
+    public: NUCLEX_STORAGE_API void Read(std::int64_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads a floating point value from the stream</summary>
     /// <param name="target">Address of a floating point value that will be read into</param>
-    public: NUCLEX_STORAGE_API void Read(float &target) override;
+    public: NUCLEX_STORAGE_API void Read(float &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads a double precision floating point value from the stream</summary>
     /// <param name="target">
     ///   Address of a double precision floating point value that will be read into
     /// </param>
-    public: NUCLEX_STORAGE_API void Read(double &target) override;
+    public: NUCLEX_STORAGE_API void Read(double &target) override {
+      readScalar(&target, sizeof(target));
+    }
 
     /// <summary>Reads a string from the stream</summary>
     /// <param name="target">Address of a string the value will be read into</param>
@@ -151,17 +256,155 @@ namespace Nuclex { namespace Storage { namespace Binary {
     /// </remarks>
     public: NUCLEX_STORAGE_API void Read(std::wstring &target) override;
 
+    /// <summary>Reads a string from the stream without copying its characters</summary>
+    /// <param name="characters">Receives the address of the string's characters</param>
+    /// <param name="length">Receives the number of characters in the string</param>
+    /// <returns>
+    ///   True if the string was read, false if the blob can not provide its memory
+    ///   directly, in which case the cursor is left where it was
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     Only blobs that hand out their memory (memory-mapped files or sealed memory
+    ///     blobs) can provide strings in place. The characters are not zero-terminated
+    ///     and stay valid for as long as the blob's memory does.
+    ///   </para>
+    ///   <para>
+    ///     If false is returned, read the string with one of the other methods instead.
+    ///     A reader that failed once will fail for all further strings, too.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_STORAGE_API bool TryReadStringInPlace(
+      const char *&characters, std::size_t &length
+    );
+
+    /// <summary>Reads a string from the stream into memory taken from an arena</summary>
+    /// <param name="arena">Arena that will provide the memory for the characters</param>
+    /// <param name="length">Receives the number of characters in the string</param>
+    /// <returns>The zero-terminated characters of the string</returns>
+    /// <remarks>
+    ///   The string stays valid until the arena is reset or rewound. Reading many strings
+    ///   this way costs no more than advancing a pointer for each.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API const char *ReadString(
+      Support::MonotonicArena &arena, std::size_t &length
+    );
+
+    /// <summary>Reads strings that were written one after another</summary>
+    /// <param name="target">String table that will receive the strings</param>
+    /// <param name="count">Number of strings that will be read</param>
+    /// <remarks>
+    ///   Replaces the table's previous contents but keeps its memory, so a deserializer
+    ///   that reuses the same table for each batch of strings stops allocating once
+    ///   the table has grown to the largest batch.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadStringTable(StringTable &target, std::size_t count);
+
     /// <summary>Reads a chunk of bytes from the stream</summary>
     /// <param name="buffer">Buffer the bytes will be read into</param>
     /// <param name="byteCount">Number of bytes that will be read from the stream</param>
     public: NUCLEX_STORAGE_API void Read(void *buffer, std::size_t byteCount) override;
 
+    /// <summary>Reads an unsigned 32 bit variable-length integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    /// <remarks>
+    ///   Throws an exception if the stored value does not fit into 32 bits.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadVarint(std::uint32_t &target);
+
+    /// <summary>Reads a signed 32 bit variable-length integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    /// <remarks>
+    ///   Throws an exception if the stored value does not fit into 32 bits.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadVarint(std::int32_t &target);
+
+    /// <summary>Reads an unsigned 64 bit variable-length integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void ReadVarint(std::uint64_t &target);
+
+    /// <summary>Reads a signed 64 bit variable-length integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void ReadVarint(std::int64_t &target);
+
+    /// <summary>Reads an array of unsigned variable-length integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    /// <remarks>
+    ///   Reads arrays written with <see cref="BinaryBlobWriter.WriteVarintArray" />.
+    ///   Four values at a time are decoded with SIMD instructions where available.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadVarintArray(std::uint32_t *target, std::size_t count);
+
+    /// <summary>Reads an array of signed variable-length integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API void ReadVarintArray(std::int32_t *target, std::size_t count);
+
+    /// <summary>Reads an array of integers stored as differences between neighbors</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    /// <remarks>
+    ///   Reads arrays written with <see cref="BinaryBlobWriter.WriteDeltaArray" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadDeltaArray(std::uint32_t *target, std::size_t count);
+
+    /// <summary>Reads a number at the cursor, flipping its bytes if required</summary>
+    /// <param name="target">Address of the number that will be read</param>
+    /// <param name="byteCount">Size of the number in bytes</param>
+    /// <remarks>
+    ///   Kept inline so that reading a field out of the read window compiles down to
+    ///   a bounds check and a single load when the reader's type is known.
+    /// </remarks>
+    private: void readScalar(void *target, std::size_t byteCount) {
+      std::uint64_t offset = this->position - this->windowPosition;
+      bool isInWindow = (
+        (this->position >= this->windowPosition) &&
+        (offset <= this->windowByteCount) &&
+        (byteCount <= this->windowByteCount - offset)
+      );
+      if(isInWindow && !(this->flipBytes && (byteCount > 1))) {
+        std::memcpy(target, this->windowStart + static_cast<std::size_t>(offset), byteCount);
+        this->position += byteCount;
+      } else {
+        readScalarSlow(target, byteCount);
+      }
+    }
+
+    /// <summary>Reads a number that needs flipping or isn't in the read window</summary>
+    /// <param name="target">Address of the number that will be read</param>
+    /// <param name="byteCount">Size of the number in bytes</param>
+    private: NUCLEX_STORAGE_API void readScalarSlow(void *target, std::size_t byteCount);
+
+    /// <summary>Reads bytes at the cursor through the read window</summary>
+    /// <param name="buffer">Buffer the bytes will be read into</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    private: void readBytes(void *buffer, std::size_t byteCount);
+
+    /// <summary>Reads an array stored in the stream-vbyte layout</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    /// <param name="isDeltaEncoded">Whether the values were stored as differences</param>
+    private: void readStreamVByte(std::uint32_t *target, std::size_t count, bool isDeltaEncoded);
+
     /// <summary>Blob the binary reader reads from</summary>
     private: std::shared_ptr<const Blob> blob;
     /// <summary>Current position of the binary reader's file pointer</summary>
     private: std::uint64_t position;
     /// <summary>Whether the bytes will be flipped to convert endianness</summary>
     private: bool flipBytes;
+    /// <summary>Maximum number of bytes fetched into the read window at once</summary>
+    private: std::size_t readWindowByteCount;
+    /// <summary>Copy of the blob's contents starting at the window position</summary>
+    private: std::vector<std::uint8_t> window;
+    /// <summary>Either the window's copy or memory of the blob itself</summary>
+    private: const std::uint8_t *windowStart;
+    /// <summary>Position in the blob the read window's contents start at</summary>
+    private: std::uint64_t windowPosition;
+    /// <summary>Number of valid bytes in the read window</summary>
+    private: std::size_t windowByteCount;
+    /// <summary>Holds arrays while they are being decoded from variable lengths</summary>
+    private: std::vector<std::uint8_t> decodeBuffer;
 
   };
 
@@ -24,7 +24,11 @@ License along with this library
 #include "Nuclex/Storage/Config.h"
 #include "Nuclex/Storage/Binary/BinaryWriter.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 namespace Nuclex { namespace Storage {
 
@@ -55,15 +59,40 @@ namespace Nuclex { namespace Storage { namespace Binary {
   ///     mode (AMD/Intel x86, x64) or big endian mode (ARM, PowerPC) right after creating
   ///     it using the SetLittleEndian() method.
   ///   </para>
+  ///   <para>
+  ///     Small writes are collected in a write buffer that is handed to the blob in one
+  ///     go when it is full, when the cursor jumps elsewhere, when Flush() is called and
+  ///     when the writer is destroyed. Until then, the blob does not see the buffered
+  ///     bytes, so call Flush() before reading back what you have written.
+  ///   </para>
+  ///   <para>
+  ///     The class is final and writes numbers inline, so code that knows it is dealing
+  ///     with a BinaryBlobWriter (for example through <see cref="Serialize" />) gets
+  ///     its writes inlined instead of going through a virtual call for each field.
+  ///   </para>
   /// </remarks>
-  class BinaryBlobWriter : public BinaryWriter {
+  class BinaryBlobWriter final : public BinaryWriter {
+
+    /// <summary>Number of bytes the write buffer holds unless specified otherwise</summary>
+    public: static const std::size_t DefaultWriteBufferByteCount = 16384;
 
     /// <summary>Initializes a new binary writer for the specified blob</summary>
     /// <param name="blob">Blob the binary writer will write into</param>
-    public: NUCLEX_STORAGE_API BinaryBlobWriter(const std::shared_ptr<Blob> &blob);
-
-    /// <summary>Destroys the binary writer</summary>
-    public: NUCLEX_STORAGE_API virtual ~BinaryBlobWriter() override = default;
+    /// <param name="writeBufferByteCount">
+    ///   Number of bytes that will be collected before they're written into the blob.
+    ///   Zero disables the write buffer and writes every field into the blob directly.
+    /// </param>
+    public: NUCLEX_STORAGE_API BinaryBlobWriter(
+      const std::shared_ptr<Blob> &blob,
+      std::size_t writeBufferByteCount = DefaultWriteBufferByteCount
+    );
+
+    /// <summary>Writes any buffered bytes into the blob and destroys the binary writer</summary>
+    /// <remarks>
+    ///   Errors writing into the blob can not be reported from here, call Flush()
+    ///   before destroying the writer if you need to know about them.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual ~BinaryBlobWriter() override;
 
     /// <summary>Retrieves the current position of the cursor<summary>
     /// <returns>The cursor's absolute position within the blob</returns>
@@ -87,47 +116,70 @@ namespace Nuclex { namespace Storage { namespace Binary {
 
     /// <summary>Writes a boolean into the stream</summary>
     /// <param name="value">Boolean that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(bool value) override;
+    public: NUCLEX_STORAGE_API void Write(bool value) override {
+      std::uint8_t flag = value ? 1 : 0;
+      writeScalar(&flag, sizeof(flag));
+    }
 
     /// <summary>Writes an unsigned 8 bit integer into the stream</summary>
     /// <param name="value">8 bit integer that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(std::uint8_t value) override;
+    public: NUCLEX_STORAGE_API void Write(std::uint8_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes a signed 8 bit integer into the stream</summary>
     /// <param name="value">8 bit integer that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(std::int8_t value) override;
+    public: NUCLEX_STORAGE_API void Write(std::int8_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes an unsigned 16 bit integer into the stream</summary>
     /// <param name="value">16 bit integer that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(std::uint16_t value) override;
+    public: NUCLEX_STORAGE_API void Write(std::uint16_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes a signed 16 bit integer into the stream</summary>
     /// <param name="value">16 bit integer that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(std::int16_t value) override;
+    public: NUCLEX_STORAGE_API void Write(std::int16_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes an unsigned 32 bit integer into the stream</summary>
     /// <param name="value">32 bit integer that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(std::uint32_t value) override;
+    public: NUCLEX_STORAGE_API void Write(std::uint32_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes a signed 32 bit integer into the stream</summary>
     /// <param name="value">32 bit integer that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(std::int32_t value) override;
+    public: NUCLEX_STORAGE_API void Write(std::int32_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes an unsigned 64 bit integer into the stream</summary>
     /// <param name="value">64 bit integer that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(std::uint64_t value) override;
+    public: NUCLEX_STORAGE_API void Write(std::uint64_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes a signed 64 bit integer into the stream</summary>
     /// <param name="value">64 bit integer that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(std::int64_t value) override;
+    public: NUCLEX_STORAGE_API void Write(std::int64_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes a floating point value into the stream</summary>
     /// <param name="value">Floating point value that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(float value) override;
+    public: NUCLEX_STORAGE_API void Write(float value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes a double precision floating point value into the stream</summary>
     /// <param name="value">Double precision floating point value that will be written</param>
-    public: NUCLEX_STORAGE_API void Write(double value) override;
+    public: NUCLEX_STORAGE_API void Write(double value) override {
+      writeScalar(&value, sizeof(value));
+    }
 
     /// <summary>Writes a string into the stream</summary>
     /// <param name="value">String that will be written</param>
@@ -148,12 +200,135 @@ namespace Nuclex { namespace Storage { namespace Binary {
     /// <param name="byteCount">Number of bytes to write</param>
     public: NUCLEX_STORAGE_API void Write(const void *buffer, std::size_t byteCount) override;
 
+    /// <summary>Writes an unsigned 32 bit integer as a variable-length integer</summary>
+    /// <param name="value">Integer that will be written</param>
+    /// <remarks>
+    ///   Varints store seven bits per byte (LEB128), so values below 128 occupy a single
+    ///   byte. They have no byte order and are unaffected by SetLittleEndian().
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void WriteVarint(std::uint32_t value) {
+      WriteVarint(static_cast<std::uint64_t>(value));
+    }
+
+    /// <summary>Writes a signed 32 bit integer as a variable-length integer</summary>
+    /// <param name="value">Integer that will be written</param>
+    /// <remarks>
+    ///   Signed values are zigzag-encoded, so small negative values are short as well.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void WriteVarint(std::int32_t value) {
+      WriteVarint(static_cast<std::int64_t>(value));
+    }
+
+    /// <summary>Writes an unsigned 64 bit integer as a variable-length integer</summary>
+    /// <param name="value">Integer that will be written</param>
+    public: NUCLEX_STORAGE_API void WriteVarint(std::uint64_t value);
+
+    /// <summary>Writes a signed 64 bit integer as a variable-length integer</summary>
+    /// <param name="value">Integer that will be written</param>
+    public: NUCLEX_STORAGE_API void WriteVarint(std::int64_t value);
+
+    /// <summary>Writes an array of unsigned integers with variable lengths</summary>
+    /// <param name="values">Values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    /// <remarks>
+    ///   <para>
+    ///     The array is stored in the stream-vbyte layout: the lengths of all values come
+    ///     first, two bits each, followed by the values with their leading zero bytes
+    ///     removed. This decodes much faster than a series of varints.
+    ///   </para>
+    ///   <para>
+    ///     Like with WriteArray(), the number of values is not stored. The layout does not
+    ///     depend on SetLittleEndian().
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void WriteVarintArray(
+      const std::uint32_t *values, std::size_t count
+    );
+
+    /// <summary>Writes an array of signed integers with variable lengths</summary>
+    /// <param name="values">Values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    /// <remarks>
+    ///   The values are zigzag-encoded, then stored like unsigned arrays.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void WriteVarintArray(
+      const std::int32_t *values, std::size_t count
+    );
+
+    /// <summary>Writes an array of integers as differences between neighbors</summary>
+    /// <param name="values">Values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    /// <remarks>
+    ///   Stores the difference of each value to the one before it in the stream-vbyte
+    ///   layout. Ascending values such as sorted ids become a series of small numbers
+    ///   this way. Other values still round-trip, but any decrease costs four bytes.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void WriteDeltaArray(
+      const std::uint32_t *values, std::size_t count
+    );
+
+    /// <summary>Writes all buffered bytes into the blob</summary>
+    /// <remarks>
+    ///   This only empties the writer's own buffer. To flush caches behind the blob,
+    ///   call the blob's Flush() method afterwards.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Flush();
+
+    /// <summary>Writes a number at the cursor, flipping its bytes if required</summary>
+    /// <param name="value">Address of the number that will be written</param>
+    /// <param name="byteCount">Size of the number in bytes</param>
+    /// <remarks>
+    ///   Kept inline so that appending a field to the write buffer compiles down to
+    ///   a bounds check and a single store when the writer's type is known.
+    /// </remarks>
+    private: void writeScalar(const void *value, std::size_t byteCount) {
+      bool fitsInBuffer = (
+        (this->position == this->bufferPosition + this->bufferedByteCount) &&
+        (byteCount <= this->buffer.size() - this->bufferedByteCount)
+      );
+      if(fitsInBuffer && !(this->flipBytes && (byteCount > 1))) {
+        std::memcpy(this->buffer.data() + this->bufferedByteCount, value, byteCount);
+        this->bufferedByteCount += byteCount;
+        this->position += byteCount;
+      } else {
+        writeScalarSlow(value, byteCount);
+      }
+    }
+
+    /// <summary>Writes a number that needs flipping or doesn't fit the write buffer</summary>
+    /// <param name="value">Address of the number that will be written</param>
+    /// <param name="byteCount">Size of the number in bytes</param>
+    private: NUCLEX_STORAGE_API void writeScalarSlow(const void *value, std::size_t byteCount);
+
+    /// <summary>Writes bytes at the cursor through the write buffer</summary>
+    /// <param name="buffer">Buffer holding the bytes that will be written</param>
+    /// <param name="byteCount">Number of bytes that will be written</param>
+    private: void writeBytes(const void *buffer, std::size_t byteCount);
+
+    /// <summary>Writes an array in the stream-vbyte layout</summary>
+    /// <param name="values">Values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    /// <param name="isDeltaEncoded">Whether to store differences between the values</param>
+    private: void writeStreamVByte(
+      const std::uint32_t *values, std::size_t count, bool isDeltaEncoded
+    );
+
     /// <summary>Blob the binary reader writes into</summary>
     private: std::shared_ptr<Blob> blob;
     /// <summary>Current position of the binary writer's blob pointer</summary>
     private: std::uint64_t position;
     /// <summary>Whether the bytes will be flipped to convert endianness</summary>
     private: bool flipBytes;
+    /// <summary>Maximum number of bytes collected in the write buffer</summary>
+    private: std::size_t writeBufferByteCount;
+    /// <summary>Bytes that have been written but not handed to the blob yet</summary>
+    private: std::vector<std::uint8_t> buffer;
+    /// <summary>Position in the blob the buffered bytes will be written to</summary>
+    private: std::uint64_t bufferPosition;
+    /// <summary>Number of bytes currently waiting in the write buffer</summary>
+    private: std::size_t bufferedByteCount;
+    /// <summary>Holds arrays while they are being encoded with variable lengths</summary>
+    private: std::vector<std::uint8_t> encodeBuffer;
 
   };
 
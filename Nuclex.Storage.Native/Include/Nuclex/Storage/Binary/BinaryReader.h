@@ -25,6 +25,9 @@ License along with this library
 
 #include "Nuclex/Storage/Reader.h"
 
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint16_t, std::uint32_t, std::uint64_t
+
 namespace Nuclex { namespace Storage { namespace Binary {
 
   // ------------------------------------------------------------------------------------------- //
@@ -44,10 +47,15 @@ namespace Nuclex { namespace Storage { namespace Binary {
   ///     happening directly on the data store.
   ///   </para>
   ///   <para>
-  ///     If you want to employ binary serialization to store your game's state, you can
-  ///     use the SerializationManager to obtain a BinarySerializationReader which has
-  ///     the added ability to read any type for which a Serializer (classes responsible
-  ///     for turning objects into data and back) was registered earlier.
+  ///     Arrays of integers and floating point values can be read from the stream in one go
+  ///     through the ReadArray() methods. Their default implementations handle the whole
+  ///     array in a single call to the raw byte method and, if the stream's endianness
+  ///     differs from the platform's, swap the byte order of all values in bulk.
+  ///   </para>
+  ///   <para>
+  ///     If you want to employ binary serialization to store your game's state, write
+  ///     a Serialize() overload for each of your types and use the ones for primitive
+  ///     types and vectors from BinarySerialization.h to read their fields.
   ///   </para>
   /// </remarks>
   class BinaryReader : public Reader {
@@ -63,6 +71,46 @@ namespace Nuclex { namespace Storage { namespace Binary {
     /// <param name="useLittleEndian">True if data should be read in little endian</param>
     public: virtual void SetLittleEndian(bool useLittleEndian = true) = 0;
 
+    /// <summary>Reads an array of unsigned 16 bit integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadArray(std::uint16_t *target, std::size_t count);
+
+    /// <summary>Reads an array of signed 16 bit integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadArray(std::int16_t *target, std::size_t count);
+
+    /// <summary>Reads an array of unsigned 32 bit integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadArray(std::uint32_t *target, std::size_t count);
+
+    /// <summary>Reads an array of signed 32 bit integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadArray(std::int32_t *target, std::size_t count);
+
+    /// <summary>Reads an array of unsigned 64 bit integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadArray(std::uint64_t *target, std::size_t count);
+
+    /// <summary>Reads an array of signed 64 bit integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadArray(std::int64_t *target, std::size_t count);
+
+    /// <summary>Reads an array of floating point values from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadArray(float *target, std::size_t count);
+
+    /// <summary>Reads an array of double precision floating point values from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadArray(double *target, std::size_t count);
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,444 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_BINARYSERIALIZATION_H
+#define NUCLEX_STORAGE_BINARY_BINARYSERIALIZATION_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/FieldList.h"
+#include "Nuclex/Storage/Binary/BinaryReader.h"
+#include "Nuclex/Storage/Binary/BinaryWriter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Whether binary readers and writers can transfer a type directly</summary>
+  /// <typeparam name="TValue">Type that will be checked</typeparam>
+  template<typename TValue> struct IsBinaryPrimitive : std::false_type {};
+  template<> struct IsBinaryPrimitive<bool> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::uint8_t> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::int8_t> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::uint16_t> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::int16_t> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::uint32_t> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::int32_t> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::uint64_t> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::int64_t> : std::true_type {};
+  template<> struct IsBinaryPrimitive<float> : std::true_type {};
+  template<> struct IsBinaryPrimitive<double> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::string> : std::true_type {};
+  template<> struct IsBinaryPrimitive<std::wstring> : std::true_type {};
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Whether a type is a binary reader</summary>
+  /// <typeparam name="TArchive">Type that will be checked</typeparam>
+  template<typename TArchive>
+  struct IsBinaryReader : std::is_base_of<BinaryReader, TArchive> {};
+
+  /// <summary>Whether a type is a binary writer</summary>
+  /// <typeparam name="TArchive">Type that will be checked</typeparam>
+  template<typename TArchive>
+  struct IsBinaryWriter : std::is_base_of<BinaryWriter, TArchive> {};
+
+  /// <summary>Whether a type is a binary reader or a binary writer</summary>
+  /// <typeparam name="TArchive">Type that will be checked</typeparam>
+  template<typename TArchive>
+  struct IsBinaryArchive : std::integral_constant<
+    bool, IsBinaryReader<TArchive>::value || IsBinaryWriter<TArchive>::value
+  > {};
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a primitive value from a binary reader</summary>
+  /// <typeparam name="TReader">Type of binary reader the value will be read from</typeparam>
+  /// <typeparam name="TValue">Type of value that will be read</typeparam>
+  /// <param name="reader">Binary reader the value will be read from</param>
+  /// <param name="value">Receives the value read from the binary reader</param>
+  /// <remarks>
+  ///   <para>
+  ///     Serialize() is a single function describing both directions: pass a reader to
+  ///     load values, pass a writer to save them. To make your own types serializable,
+  ///     provide an overload in your type's namespace that serializes each field:
+  ///   </para>
+  ///   <code>
+  ///     template<typename TArchive>
+  ///     void Serialize(TArchive &amp;archive, Vector3 &amp;vector) {
+  ///       Serialize(archive, vector.X);
+  ///       Serialize(archive, vector.Y);
+  ///       Serialize(archive, vector.Z);
+  ///     }
+  ///   </code>
+  ///   <para>
+  ///     Because the archive's concrete type is a template parameter, passing
+  ///     a <see cref="BinaryBlobReader" /> or <see cref="BinaryBlobWriter" /> (both are
+  ///     final) lets the compiler inline the whole structure into plain copies out of
+  ///     the read window or into the write buffer. Passing a BinaryReader or BinaryWriter
+  ///     reference works, too, but then each field goes through a virtual call.
+  ///   </para>
+  /// </remarks>
+  template<typename TReader, typename TValue>
+  inline typename std::enable_if<
+    IsBinaryReader<TReader>::value && IsBinaryPrimitive<TValue>::value
+  >::type Serialize(TReader &reader, TValue &value) {
+    reader.Read(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a primitive value into a binary writer</summary>
+  /// <typeparam name="TWriter">Type of binary writer the value will be written to</typeparam>
+  /// <typeparam name="TValue">Type of value that will be written</typeparam>
+  /// <param name="writer">Binary writer the value will be written to</param>
+  /// <param name="value">Value that will be written</param>
+  template<typename TWriter, typename TValue>
+  inline typename std::enable_if<
+    IsBinaryWriter<TWriter>::value && IsBinaryPrimitive<TValue>::value
+  >::type Serialize(TWriter &writer, TValue &value) {
+    writer.Write(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  namespace Private {
+
+    /// <summary>Reads raw bytes from a binary reader</summary>
+    /// <param name="reader">Binary reader the bytes will be read from</param>
+    /// <param name="buffer">Buffer that will receive the bytes</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    template<typename TReader>
+    inline typename std::enable_if<IsBinaryReader<TReader>::value>::type transferBytes(
+      TReader &reader, void *buffer, std::size_t byteCount
+    ) {
+      reader.Read(buffer, byteCount);
+    }
+
+    /// <summary>Writes raw bytes into a binary writer</summary>
+    /// <param name="writer">Binary writer the bytes will be written to</param>
+    /// <param name="buffer">Buffer holding the bytes that will be written</param>
+    /// <param name="byteCount">Number of bytes that will be written</param>
+    template<typename TWriter>
+    inline typename std::enable_if<IsBinaryWriter<TWriter>::value>::type transferBytes(
+      TWriter &writer, const void *buffer, std::size_t byteCount
+    ) {
+      writer.Write(buffer, byteCount);
+    }
+
+    /// <summary>
+    ///   Checks whether structures can be transferred between memory and an archive
+    ///   as they are, without looking at the individual fields
+    /// </summary>
+    /// <typeparam name="TValue">Packed structure that will be transferred</typeparam>
+    /// <param name="archive">Binary reader or writer the structures are serialized with</param>
+    /// <returns>True if the structures' bytes can be copied directly</returns>
+    template<typename TValue, typename TArchive>
+    inline bool canTransferInBulk(const TArchive &archive) {
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+      bool isNativeByteOrder = !archive.IsLittleEndian();
+#else
+      bool isNativeByteOrder = archive.IsLittleEndian();
+#endif
+      return isNativeByteOrder && HasFieldsInMemoryOrder<TValue>();
+    }
+
+    /// <summary>Serializes the fields of a structure one by one</summary>
+    /// <param name="archive">Binary reader or writer the fields are serialized with</param>
+    /// <param name="value">Structure whose fields will be serialized</param>
+    template<typename TArchive, typename TValue>
+    inline void serializeFields(TArchive &archive, TValue &value) {
+      ForEachField(
+        TValue::GetFields(),
+        [&archive, &value](const auto &field) { Serialize(archive, value.*(field.Member)); }
+      );
+    }
+
+    /// <summary>Transfers a structure with a field list in the recommended way</summary>
+    /// <typeparam name="TValue">Type of structure that will be transferred</typeparam>
+    template<typename TValue, typename TEnable = void>
+    struct FieldListSerializer {
+
+      /// <summary>Serializes the fields of the structure one by one</summary>
+      /// <param name="archive">Binary reader or writer the structure is serialized with</param>
+      /// <param name="value">Structure that will be serialized</param>
+      template<typename TArchive>
+      inline static void _(TArchive &archive, TValue &value) {
+        serializeFields(archive, value);
+      }
+
+    };
+
+    /// <summary>Transfers packed structures as a single chunk of bytes</summary>
+    /// <typeparam name="TValue">Type of structure that will be transferred</typeparam>
+    template<typename TValue>
+    struct FieldListSerializer<
+      TValue, typename std::enable_if<IsPackedFieldList<TValue>::value>::type
+    > {
+
+      /// <summary>Serializes the structure's bytes directly if the byte order fits</summary>
+      /// <param name="archive">Binary reader or writer the structure is serialized with</param>
+      /// <param name="value">Structure that will be serialized</param>
+      template<typename TArchive>
+      inline static void _(TArchive &archive, TValue &value) {
+        if(canTransferInBulk<TValue>(archive)) {
+          transferBytes(archive, &value, sizeof(TValue));
+        } else {
+          serializeFields(archive, value);
+        }
+      }
+
+    };
+
+    /// <summary>Transfers the elements of a vector in the recommended way</summary>
+    /// <typeparam name="TElement">Type of the elements in the vector</typeparam>
+    /// <remarks>
+    ///   Elements of user-defined types are serialized one by one, numbers are handed
+    ///   to ReadArray() / WriteArray() in one go.
+    /// </remarks>
+    template<typename TElement, typename TEnable = void>
+    struct VectorSerializer {
+
+      /// <summary>Serializes the elements one by one</summary>
+      /// <param name="archive">Binary reader or writer the elements are serialized with</param>
+      /// <param name="elements">Elements that will be serialized</param>
+      /// <param name="count">Number of elements that will be serialized</param>
+      template<typename TArchive>
+      inline static void _(TArchive &archive, TElement *elements, std::size_t count) {
+        for(std::size_t index = 0; index < count; ++index) {
+          Serialize(archive, elements[index]);
+        }
+      }
+
+    };
+
+    /// <summary>Transfers vectors of bytes as a single chunk of bytes</summary>
+    /// <typeparam name="TElement">Type of the elements in the vector</typeparam>
+    template<typename TElement>
+    struct VectorSerializer<
+      TElement,
+      typename std::enable_if<
+        std::is_same<TElement, std::uint8_t>::value || std::is_same<TElement, std::int8_t>::value
+      >::type
+    > {
+
+      /// <summary>Reads the elements as a chunk of bytes</summary>
+      /// <param name="reader">Binary reader the elements will be read from</param>
+      /// <param name="elements">Receives the elements</param>
+      /// <param name="count">Number of elements that will be read</param>
+      template<typename TReader>
+      inline static typename std::enable_if<IsBinaryReader<TReader>::value>::type _(
+        TReader &reader, TElement *elements, std::size_t count
+      ) {
+        reader.Read(elements, count);
+      }
+
+      /// <summary>Writes the elements as a chunk of bytes</summary>
+      /// <param name="writer">Binary writer the elements will be written to</param>
+      /// <param name="elements">Elements that will be written</param>
+      /// <param name="count">Number of elements that will be written</param>
+      template<typename TWriter>
+      inline static typename std::enable_if<IsBinaryWriter<TWriter>::value>::type _(
+        TWriter &writer, TElement *elements, std::size_t count
+      ) {
+        writer.Write(elements, count);
+      }
+
+    };
+
+    /// <summary>Transfers vectors of numbers through the array methods</summary>
+    /// <typeparam name="TElement">Type of the elements in the vector</typeparam>
+    template<typename TElement>
+    struct VectorSerializer<
+      TElement,
+      typename std::enable_if<
+        std::is_arithmetic<TElement>::value && IsBinaryPrimitive<TElement>::value &&
+        (sizeof(TElement) > 1)
+      >::type
+    > {
+
+      /// <summary>Reads the elements through the reader's ReadArray() method</summary>
+      /// <param name="reader">Binary reader the elements will be read from</param>
+      /// <param name="elements">Receives the elements</param>
+      /// <param name="count">Number of elements that will be read</param>
+      template<typename TReader>
+      inline static typename std::enable_if<IsBinaryReader<TReader>::value>::type _(
+        TReader &reader, TElement *elements, std::size_t count
+      ) {
+        reader.ReadArray(elements, count);
+      }
+
+      /// <summary>Writes the elements through the writer's WriteArray() method</summary>
+      /// <param name="writer">Binary writer the elements will be written to</param>
+      /// <param name="elements">Elements that will be written</param>
+      /// <param name="count">Number of elements that will be written</param>
+      template<typename TWriter>
+      inline static typename std::enable_if<IsBinaryWriter<TWriter>::value>::type _(
+        TWriter &writer, TElement *elements, std::size_t count
+      ) {
+        writer.WriteArray(elements, count);
+      }
+
+    };
+
+    /// <summary>Transfers vectors of packed structures as a single chunk of bytes</summary>
+    /// <typeparam name="TElement">Type of the elements in the vector</typeparam>
+    /// <remarks>
+    ///   If the archive uses a different byte order than the platform, the elements
+    ///   are serialized field by field instead.
+    /// </remarks>
+    template<typename TElement>
+    struct VectorSerializer<
+      TElement, typename std::enable_if<IsPackedFieldList<TElement>::value>::type
+    > {
+
+      /// <summary>Serializes the elements' bytes directly if the byte order fits</summary>
+      /// <param name="archive">Binary reader or writer the elements are serialized with</param>
+      /// <param name="elements">Elements that will be serialized</param>
+      /// <param name="count">Number of elements that will be serialized</param>
+      template<typename TArchive>
+      inline static void _(TArchive &archive, TElement *elements, std::size_t count) {
+        if(canTransferInBulk<TElement>(archive)) {
+          transferBytes(archive, elements, sizeof(TElement) * count);
+        } else {
+          for(std::size_t index = 0; index < count; ++index) {
+            serializeFields(archive, elements[index]);
+          }
+        }
+      }
+
+    };
+
+  } // namespace Private
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a vector of values from a binary reader</summary>
+  /// <typeparam name="TReader">Type of binary reader the values will be read from</typeparam>
+  /// <typeparam name="TElement">Type of the values in the vector</typeparam>
+  /// <param name="reader">Binary reader the values will be read from</param>
+  /// <param name="values">Receives the values read from the binary reader</param>
+  /// <remarks>
+  ///   Vectors are stored as a 32 bit element count followed by the elements,
+  ///   just like strings are.
+  /// </remarks>
+  template<typename TReader, typename TElement>
+  inline typename std::enable_if<IsBinaryReader<TReader>::value>::type Serialize(
+    TReader &reader, std::vector<TElement> &values
+  ) {
+    static_assert(
+      !std::is_same<TElement, bool>::value,
+      "std::vector<bool> can not be serialized, use a vector of bytes instead"
+    );
+
+    std::uint32_t count;
+    reader.Read(count);
+
+    values.resize(count);
+    if(count > 0) {
+      Private::VectorSerializer<TElement>::_(reader, values.data(), count);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a vector of values into a binary writer</summary>
+  /// <typeparam name="TWriter">Type of binary writer the values will be written to</typeparam>
+  /// <typeparam name="TElement">Type of the values in the vector</typeparam>
+  /// <param name="writer">Binary writer the values will be written to</param>
+  /// <param name="values">Values that will be written</param>
+  template<typename TWriter, typename TElement>
+  inline typename std::enable_if<IsBinaryWriter<TWriter>::value>::type Serialize(
+    TWriter &writer, std::vector<TElement> &values
+  ) {
+    static_assert(
+      !std::is_same<TElement, bool>::value,
+      "std::vector<bool> can not be serialized, use a vector of bytes instead"
+    );
+
+    std::uint32_t count = static_cast<std::uint32_t>(values.size());
+    writer.Write(count);
+
+    if(count > 0) {
+      Private::VectorSerializer<TElement>::_(writer, values.data(), count);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Serializes a fixed-size array of values</summary>
+  /// <typeparam name="TArchive">Binary reader or writer the values are serialized with</typeparam>
+  /// <typeparam name="TElement">Type of the values in the array</typeparam>
+  /// <typeparam name="ElementCount">Number of values in the array</typeparam>
+  /// <param name="archive">Binary reader or writer the values are serialized with</param>
+  /// <param name="values">Values that will be serialized</param>
+  /// <remarks>
+  ///   The array's size is known on both ends, so unlike with vectors, no element count
+  ///   is stored. Arrays of numbers and of packed structures are transferred in one go.
+  /// </remarks>
+  template<typename TArchive, typename TElement, std::size_t ElementCount>
+  inline typename std::enable_if<IsBinaryArchive<TArchive>::value>::type Serialize(
+    TArchive &archive, TElement (&values)[ElementCount]
+  ) {
+    static_assert(
+      !std::is_same<typename std::remove_all_extents<TElement>::type, bool>::value,
+      "Arrays of bool can not be serialized, use an array of bytes instead"
+    );
+
+    Private::VectorSerializer<TElement>::_(archive, values, ElementCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Serializes a structure that provides a field list</summary>
+  /// <typeparam name="TArchive">Binary reader or writer the structure is used with</typeparam>
+  /// <typeparam name="TValue">Type of structure that will be serialized</typeparam>
+  /// <param name="archive">Binary reader or writer the structure is serialized with</param>
+  /// <param name="value">Structure that will be serialized</param>
+  /// <remarks>
+  ///   <para>
+  ///     Instead of writing a Serialize() overload by hand, structures can list their
+  ///     fields in a static GetFields() method (see <see cref="NUCLEX_STORAGE_FIELD" />).
+  ///     The fields are then serialized in the order they appear in the field list.
+  ///   </para>
+  ///   <para>
+  ///     Structures consisting of only numeric fields without any padding between them
+  ///     (see <see cref="IsPackedFieldList" />) are transferred as a single chunk of bytes
+  ///     if the archive uses the platform's byte order. The same applies to vectors and
+  ///     arrays of such structures, which can then be loaded with a single copy.
+  ///   </para>
+  /// </remarks>
+  template<typename TArchive, typename TValue>
+  inline typename std::enable_if<
+    IsBinaryArchive<TArchive>::value && HasFieldList<TValue>::value
+  >::type Serialize(TArchive &archive, TValue &value) {
+    Private::FieldListSerializer<TValue>::_(archive, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_BINARYSERIALIZATION_H
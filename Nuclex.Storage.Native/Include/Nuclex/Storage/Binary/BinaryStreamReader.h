@@ -0,0 +1,306 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_BINARYSTREAMREADER_H
+#define NUCLEX_STORAGE_BINARY_BINARYSTREAMREADER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/BinaryReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class InputStream;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads binary data from an input stream</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Works like the <see cref="BinaryBlobReader" /> but pulls its data from a stream,
+  ///     for example one decompressing data or receiving it over the network. This lets
+  ///     you deserialize data as it arrives instead of collecting it in a blob first.
+  ///     Reads wait for the stream if it hasn't provided enough data yet and throw if
+  ///     the stream ends before the requested bytes were read.
+  ///   </para>
+  ///   <para>
+  ///     A new BinaryStreamReader starts with the endianness that is native to the system
+  ///     Nuclex.Storage.Native has been compiled on. Switch it to little endian or big
+  ///     endian mode right after creating it via SetLittleEndian() to read portable data.
+  ///   </para>
+  ///   <para>
+  ///     Small reads are served from a read buffer. If the stream can hand out its memory
+  ///     directly (see <see cref="InputStream.AcquireReadableSpan" />), values are read
+  ///     straight from the stream's memory instead. Data copied into the read buffer
+  ///     has been taken out of the stream, so once reading through this class has begun,
+  ///     all further reads should go through it, too.
+  ///   </para>
+  /// </remarks>
+  class BinaryStreamReader final : public BinaryReader {
+
+    /// <summary>Number of bytes the read buffer holds unless specified otherwise</summary>
+    public: static const std::size_t DefaultReadBufferByteCount = 16384;
+
+    /// <summary>Initializes a new binary reader for the specified stream</summary>
+    /// <param name="stream">Stream the binary reader will read from</param>
+    /// <param name="readBufferByteCount">
+    ///   Number of bytes that will be taken from the stream at once. Zero disables
+    ///   the read buffer and reads every field from the stream directly.
+    /// </param>
+    public: NUCLEX_STORAGE_API BinaryStreamReader(
+      const std::shared_ptr<InputStream> &stream,
+      std::size_t readBufferByteCount = DefaultReadBufferByteCount
+    );
+
+    /// <summary>Destroys the binary reader</summary>
+    /// <remarks>
+    ///   If the reader was reading from the stream's memory, the stream is left
+    ///   positioned right after the last byte that was read.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual ~BinaryStreamReader() override;
+
+    /// <summary>Retrieves the number of bytes that have been read so far</summary>
+    /// <returns>The number of bytes that have been read through the reader</returns>
+    public: NUCLEX_STORAGE_API std::uint64_t GetPosition() const {
+      return this->position;
+    }
+
+    /// <summary>Whether data should be read in little endian (x86) format<summary>
+    /// <returns>True if data is read a little endian (x86) format, otherwise false</returns>
+    public: NUCLEX_STORAGE_API bool IsLittleEndian() const override;
+
+    /// <summary>Sets whether data should be read in little endian format</summary>
+    /// <param name="useLittleEndian">True if data should be read in little endian</param>
+    public: NUCLEX_STORAGE_API void SetLittleEndian(bool useLittleEndian = true) override;
+
+    /// <summary>Reads a boolean integer from the stream</summary>
+    /// <param name="target">Address of a boolean the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(bool &target) override {
+      std::uint8_t flag;
+      readScalar(&flag, sizeof(flag));
+      target = (flag != 0);
+    }
+
+    /// <summary>Reads an unsigned 8 bit integer from the stream</summary>
+    /// <param name="target">Address of an 8 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint8_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads a signed 8 bit integer from the stream</summary>
+    /// <param name="target">Address of an 8 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int8_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads an unsigned 16 bit integer from the stream</summary>
+    /// <param name="target">Address of a 16 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint16_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads a signed 16 bit integer from the stream</summary>
+    /// <param name="target">Address of a 16 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int16_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads an unsigned 32 bit integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint32_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads a signed 32 bit integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int32_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads an unsigned 64 bit integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint64_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads a signed 64 bit integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int64_t &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads a floating point value from the stream</summary>
+    /// <param name="target">Address of a floating point value that will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(float &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads a double precision floating point value from the stream</summary>
+    /// <param name="target">
+    ///   Address of a double precision floating point value that will be read into
+    /// </param>
+    public: NUCLEX_STORAGE_API void Read(double &target) override {
+      readScalar(&target, sizeof(target));
+    }
+
+    /// <summary>Reads a string from the stream</summary>
+    /// <param name="target">Address of a string the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::string &target) override;
+
+    /// <summary>Reads a wide character string from the stream</summary>
+    /// <param name="target">
+    ///   Address of a wide character string the value will be read into
+    /// </param>
+    /// <remarks>
+    ///   Avoid using this. Wide characters are 16 bit on Windows, 32 bit on Linux, so
+    ///   wide strings are not portable between them. Only use UTF-8 in your public APIs.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Read(std::wstring &target) override;
+
+    /// <summary>Reads a chunk of bytes from the stream</summary>
+    /// <param name="buffer">Buffer the bytes will be read into</param>
+    /// <param name="byteCount">Number of bytes that will be read from the stream</param>
+    /// <remarks>
+    ///   Large reads (and thus the arrays read via ReadArray()) are placed directly in
+    ///   the caller's buffer without going through the read buffer.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Read(void *buffer, std::size_t byteCount) override;
+
+    /// <summary>Reads an unsigned 32 bit variable-length integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    /// <remarks>
+    ///   Throws an exception if the stored value does not fit into 32 bits.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadVarint(std::uint32_t &target);
+
+    /// <summary>Reads a signed 32 bit variable-length integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    /// <remarks>
+    ///   Throws an exception if the stored value does not fit into 32 bits.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadVarint(std::int32_t &target);
+
+    /// <summary>Reads an unsigned 64 bit variable-length integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void ReadVarint(std::uint64_t &target);
+
+    /// <summary>Reads a signed 64 bit variable-length integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void ReadVarint(std::int64_t &target);
+
+    /// <summary>Reads an array of unsigned variable-length integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    /// <remarks>
+    ///   Reads arrays written with <see cref="BinaryStreamWriter.WriteVarintArray" /> or
+    ///   <see cref="BinaryBlobWriter.WriteVarintArray" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadVarintArray(std::uint32_t *target, std::size_t count);
+
+    /// <summary>Reads an array of signed variable-length integers from the stream</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API void ReadVarintArray(std::int32_t *target, std::size_t count);
+
+    /// <summary>Reads an array of integers stored as differences between neighbors</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    public: NUCLEX_STORAGE_API void ReadDeltaArray(std::uint32_t *target, std::size_t count);
+
+    /// <summary>Reads a number, flipping its bytes if required</summary>
+    /// <param name="target">Address of the number that will be read</param>
+    /// <param name="byteCount">Size of the number in bytes</param>
+    /// <remarks>
+    ///   Kept inline so that reading a field out of the read buffer compiles down to
+    ///   a bounds check and a single load when the reader's type is known.
+    /// </remarks>
+    private: void readScalar(void *target, std::size_t byteCount) {
+      if((byteCount <= this->windowByteCount) && !(this->flipBytes && (byteCount > 1))) {
+        std::memcpy(target, this->windowStart, byteCount);
+        this->windowStart += byteCount;
+        this->windowByteCount -= byteCount;
+        this->position += byteCount;
+      } else {
+        readScalarSlow(target, byteCount);
+      }
+    }
+
+    /// <summary>Reads a number that needs flipping or isn't in the read window</summary>
+    /// <param name="target">Address of the number that will be read</param>
+    /// <param name="byteCount">Size of the number in bytes</param>
+    private: NUCLEX_STORAGE_API void readScalarSlow(void *target, std::size_t byteCount);
+
+    /// <summary>Reads bytes through the read window</summary>
+    /// <param name="buffer">Buffer the bytes will be read into</param>
+    /// <param name="byteCount">Number of bytes that will be read</param>
+    private: void readBytes(void *buffer, std::size_t byteCount);
+
+    /// <summary>Provides the next bytes from the stream in the read window</summary>
+    /// <remarks>
+    ///   Must only be called when the read window is empty. Throws if the stream has
+    ///   ended and no more bytes can be provided.
+    /// </remarks>
+    private: void fillWindow();
+
+    /// <summary>Hands back the stream's memory if the read window points into it</summary>
+    private: void releaseSpan();
+
+    /// <summary>Reads an array stored in the stream-vbyte layout</summary>
+    /// <param name="target">Array the values will be read into</param>
+    /// <param name="count">Number of values that will be read</param>
+    /// <param name="isDeltaEncoded">Whether the values were stored as differences</param>
+    private: void readStreamVByte(std::uint32_t *target, std::size_t count, bool isDeltaEncoded);
+
+    private: BinaryStreamReader(const BinaryStreamReader &) = delete;
+    private: BinaryStreamReader &operator =(const BinaryStreamReader &) = delete;
+
+    /// <summary>Stream the binary reader reads from</summary>
+    private: std::shared_ptr<InputStream> stream;
+    /// <summary>Number of bytes that have been read through the reader</summary>
+    private: std::uint64_t position;
+    /// <summary>Whether the bytes will be flipped to convert endianness</summary>
+    private: bool flipBytes;
+    /// <summary>Maximum number of bytes taken from the stream into the buffer at once</summary>
+    private: std::size_t readBufferByteCount;
+    /// <summary>Bytes copied out of the stream that haven't been read yet</summary>
+    private: std::vector<std::uint8_t> buffer;
+    /// <summary>Next unread byte, either in the buffer or in the stream's memory</summary>
+    private: const std::uint8_t *windowStart;
+    /// <summary>Number of unread bytes remaining in the read window</summary>
+    private: std::size_t windowByteCount;
+    /// <summary>Size of the span acquired from the stream, zero if none</summary>
+    private: std::size_t spanByteCount;
+    /// <summary>Holds encoded variable-length integers while they're decoded</summary>
+    private: std::vector<std::uint8_t> decodeBuffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_BINARYSTREAMREADER_H
@@ -0,0 +1,299 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_BINARYSTREAMWRITER_H
+#define NUCLEX_STORAGE_BINARY_BINARYSTREAMWRITER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/BinaryWriter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class OutputStream;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes binary data into an output stream</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Works like the <see cref="BinaryBlobWriter" /> but pushes its data into a stream,
+  ///     for example one compressing data or sending it over the network. The counterpart
+  ///     for reading the data back is the <see cref="BinaryStreamReader" />.
+  ///   </para>
+  ///   <para>
+  ///     A new BinaryStreamWriter starts with the endianness that is native to the system
+  ///     Nuclex.Storage.Native has been compiled on. Switch it to little endian or big
+  ///     endian mode right after creating it via SetLittleEndian() to write portable data.
+  ///   </para>
+  ///   <para>
+  ///     Small writes are collected in a write buffer that is handed to the stream in one
+  ///     go when it is full, when Flush() is called and when the writer is destroyed.
+  ///     Until then, the stream does not see the buffered bytes.
+  ///   </para>
+  /// </remarks>
+  class BinaryStreamWriter final : public BinaryWriter {
+
+    /// <summary>Number of bytes the write buffer holds unless specified otherwise</summary>
+    public: static const std::size_t DefaultWriteBufferByteCount = 16384;
+
+    /// <summary>Initializes a new binary writer for the specified stream</summary>
+    /// <param name="stream">Stream the binary writer will write into</param>
+    /// <param name="writeBufferByteCount">
+    ///   Number of bytes that will be collected before they're written into the stream.
+    ///   Zero disables the write buffer and writes every field into the stream directly.
+    /// </param>
+    public: NUCLEX_STORAGE_API BinaryStreamWriter(
+      const std::shared_ptr<OutputStream> &stream,
+      std::size_t writeBufferByteCount = DefaultWriteBufferByteCount
+    );
+
+    /// <summary>Writes any buffered bytes into the stream and destroys the writer</summary>
+    /// <remarks>
+    ///   Errors writing into the stream can not be reported from here, call Flush()
+    ///   before destroying the writer if you need to know about them.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual ~BinaryStreamWriter() override;
+
+    /// <summary>Retrieves the number of bytes that have been written so far</summary>
+    /// <returns>The number of bytes that have been written through the writer</returns>
+    public: NUCLEX_STORAGE_API std::uint64_t GetPosition() const {
+      return this->position;
+    }
+
+    /// <summary>Whether data should be written in little endian (x86) format<summary>
+    /// <returns>True if data is written in little endian (x86) format, otherwise false</returns>
+    public: NUCLEX_STORAGE_API bool IsLittleEndian() const override;
+
+    /// <summary>Sets whether data should be written in little endian format</summary>
+    /// <param name="useLittleEndian">True if data should be written in little endian</param>
+    public: NUCLEX_STORAGE_API void SetLittleEndian(bool useLittleEndian = true) override;
+
+    /// <summary>Writes a boolean into the stream</summary>
+    /// <param name="value">Boolean that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(bool value) override {
+      std::uint8_t flag = value ? 1 : 0;
+      writeScalar(&flag, sizeof(flag));
+    }
+
+    /// <summary>Writes an unsigned 8 bit integer into the stream</summary>
+    /// <param name="value">8 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::uint8_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes a signed 8 bit integer into the stream</summary>
+    /// <param name="value">8 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::int8_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes an unsigned 16 bit integer into the stream</summary>
+    /// <param name="value">16 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::uint16_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes a signed 16 bit integer into the stream</summary>
+    /// <param name="value">16 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::int16_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes an unsigned 32 bit integer into the stream</summary>
+    /// <param name="value">32 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::uint32_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes a signed 32 bit integer into the stream</summary>
+    /// <param name="value">32 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::int32_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes an unsigned 64 bit integer into the stream</summary>
+    /// <param name="value">64 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::uint64_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes a signed 64 bit integer into the stream</summary>
+    /// <param name="value">64 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::int64_t value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes a floating point value into the stream</summary>
+    /// <param name="value">Floating point value that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(float value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes a double precision floating point value into the stream</summary>
+    /// <param name="value">Double precision floating point value that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(double value) override {
+      writeScalar(&value, sizeof(value));
+    }
+
+    /// <summary>Writes a string into the stream</summary>
+    /// <param name="value">String that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(const std::string &value) override;
+
+    /// <summary>Writes a wide character string into the stream</summary>
+    /// <param name="value">Wide character string that will be written</param>
+    /// <remarks>
+    ///   Avoid using this. Wide characters are 16 bit on Windows, 32 bit on Linux, so
+    ///   wide strings are not portable between them. Only use UTF-8 in your public APIs.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Write(const std::wstring &value) override;
+
+    /// <summary>Writes a chunk of bytes into the stream</summary>
+    /// <param name="buffer">Buffer the bytes that will be written</param>
+    /// <param name="byteCount">Number of bytes to write</param>
+    /// <remarks>
+    ///   Large writes (and thus the arrays written via WriteArray()) are handed to
+    ///   the stream directly without going through the write buffer.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Write(const void *buffer, std::size_t byteCount) override;
+
+    /// <summary>Writes an unsigned 32 bit integer as a variable-length integer</summary>
+    /// <param name="value">Integer that will be written</param>
+    /// <remarks>
+    ///   Uses the same encoding as <see cref="BinaryBlobWriter.WriteVarint" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void WriteVarint(std::uint32_t value) {
+      WriteVarint(static_cast<std::uint64_t>(value));
+    }
+
+    /// <summary>Writes a signed 32 bit integer as a variable-length integer</summary>
+    /// <param name="value">Integer that will be written</param>
+    public: NUCLEX_STORAGE_API void WriteVarint(std::int32_t value) {
+      WriteVarint(static_cast<std::int64_t>(value));
+    }
+
+    /// <summary>Writes an unsigned 64 bit integer as a variable-length integer</summary>
+    /// <param name="value">Integer that will be written</param>
+    public: NUCLEX_STORAGE_API void WriteVarint(std::uint64_t value);
+
+    /// <summary>Writes a signed 64 bit integer as a variable-length integer</summary>
+    /// <param name="value">Integer that will be written</param>
+    public: NUCLEX_STORAGE_API void WriteVarint(std::int64_t value);
+
+    /// <summary>Writes an array of unsigned integers with variable lengths</summary>
+    /// <param name="values">Values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    /// <remarks>
+    ///   Uses the same stream-vbyte layout as
+    ///   <see cref="BinaryBlobWriter.WriteVarintArray" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void WriteVarintArray(
+      const std::uint32_t *values, std::size_t count
+    );
+
+    /// <summary>Writes an array of signed integers with variable lengths</summary>
+    /// <param name="values">Values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API void WriteVarintArray(
+      const std::int32_t *values, std::size_t count
+    );
+
+    /// <summary>Writes an array of integers as differences between neighbors</summary>
+    /// <param name="values">Values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API void WriteDeltaArray(
+      const std::uint32_t *values, std::size_t count
+    );
+
+    /// <summary>Writes all buffered bytes into the stream</summary>
+    /// <remarks>
+    ///   Waits until the stream has accepted all buffered bytes. To flush buffers
+    ///   behind the stream, call the stream's own Flush() method afterwards.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Flush();
+
+    /// <summary>Writes a number, flipping its bytes if required</summary>
+    /// <param name="value">Address of the number that will be written</param>
+    /// <param name="byteCount">Size of the number in bytes</param>
+    /// <remarks>
+    ///   Kept inline so that appending a field to the write buffer compiles down to
+    ///   a bounds check and a single store when the writer's type is known.
+    /// </remarks>
+    private: void writeScalar(const void *value, std::size_t byteCount) {
+      bool fitsInBuffer = (byteCount <= this->buffer.size() - this->bufferedByteCount);
+      if(fitsInBuffer && !(this->flipBytes && (byteCount > 1))) {
+        std::memcpy(this->buffer.data() + this->bufferedByteCount, value, byteCount);
+        this->bufferedByteCount += byteCount;
+        this->position += byteCount;
+      } else {
+        writeScalarSlow(value, byteCount);
+      }
+    }
+
+    /// <summary>Writes a number that needs flipping or doesn't fit the write buffer</summary>
+    /// <param name="value">Address of the number that will be written</param>
+    /// <param name="byteCount">Size of the number in bytes</param>
+    private: NUCLEX_STORAGE_API void writeScalarSlow(const void *value, std::size_t byteCount);
+
+    /// <summary>Writes bytes through the write buffer</summary>
+    /// <param name="buffer">Buffer holding the bytes that will be written</param>
+    /// <param name="byteCount">Number of bytes that will be written</param>
+    private: void writeBytes(const void *buffer, std::size_t byteCount);
+
+    /// <summary>Writes an array in the stream-vbyte layout</summary>
+    /// <param name="values">Values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    /// <param name="isDeltaEncoded">Whether to store differences between the values</param>
+    private: void writeStreamVByte(
+      const std::uint32_t *values, std::size_t count, bool isDeltaEncoded
+    );
+
+    private: BinaryStreamWriter(const BinaryStreamWriter &) = delete;
+    private: BinaryStreamWriter &operator =(const BinaryStreamWriter &) = delete;
+
+    /// <summary>Stream the binary writer writes into</summary>
+    private: std::shared_ptr<OutputStream> stream;
+    /// <summary>Number of bytes that have been written through the writer</summary>
+    private: std::uint64_t position;
+    /// <summary>Whether the bytes will be flipped to convert endianness</summary>
+    private: bool flipBytes;
+    /// <summary>Maximum number of bytes collected in the write buffer</summary>
+    private: std::size_t writeBufferByteCount;
+    /// <summary>Bytes that have been written but not handed to the stream yet</summary>
+    private: std::vector<std::uint8_t> buffer;
+    /// <summary>Number of bytes currently waiting in the write buffer</summary>
+    private: std::size_t bufferedByteCount;
+    /// <summary>Holds arrays while they are being encoded with variable lengths</summary>
+    private: std::vector<std::uint8_t> encodeBuffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_BINARYSTREAMWRITER_H
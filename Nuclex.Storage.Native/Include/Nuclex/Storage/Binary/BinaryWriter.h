@@ -25,6 +25,9 @@ License along with this library
 
 #include "Nuclex/Storage/Writer.h"
 
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint16_t, std::uint32_t, std::uint64_t
+
 namespace Nuclex { namespace Storage { namespace Binary {
 
   // ------------------------------------------------------------------------------------------- //
@@ -45,10 +48,15 @@ namespace Nuclex { namespace Storage { namespace Binary {
   ///     throughput and marginal protection against casual tampering.
   ///   </para>
   ///   <para>
-  ///     If you want to employ binary serialization to store your game's state, you can
-  ///     use the SerializationManager to obtain a BinarySerializationWriter which has
-  ///     the added ability to write any type for which a Serializer (classes responsible
-  ///     for turning objects into data and back) was registered earlier.
+  ///     Arrays of integers and floating point values can be written to the stream in one go
+  ///     through the WriteArray() methods. Their default implementations handle the whole
+  ///     array in a single call to the raw byte method and, if the stream's endianness
+  ///     differs from the platform's, swap the byte order of all values in bulk.
+  ///   </para>
+  ///   <para>
+  ///     If you want to employ binary serialization to store your game's state, write
+  ///     a Serialize() overload for each of your types and use the ones for primitive
+  ///     types and vectors from BinarySerialization.h to write their fields.
   ///   </para>
   /// </remarks>
   class BinaryWriter : public Writer {
@@ -64,6 +72,62 @@ namespace Nuclex { namespace Storage { namespace Binary {
     /// <param name="useLittleEndian">True if data should be read in little endian</param>
     public: virtual void SetLittleEndian(bool useLittleEndian = true) = 0;
 
+    /// <summary>Writes an array of unsigned 16 bit integers into the stream</summary>
+    /// <param name="source">Array holding the values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteArray(
+      const std::uint16_t *source, std::size_t count
+    );
+
+    /// <summary>Writes an array of signed 16 bit integers into the stream</summary>
+    /// <param name="source">Array holding the values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteArray(
+      const std::int16_t *source, std::size_t count
+    );
+
+    /// <summary>Writes an array of unsigned 32 bit integers into the stream</summary>
+    /// <param name="source">Array holding the values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteArray(
+      const std::uint32_t *source, std::size_t count
+    );
+
+    /// <summary>Writes an array of signed 32 bit integers into the stream</summary>
+    /// <param name="source">Array holding the values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteArray(
+      const std::int32_t *source, std::size_t count
+    );
+
+    /// <summary>Writes an array of unsigned 64 bit integers into the stream</summary>
+    /// <param name="source">Array holding the values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteArray(
+      const std::uint64_t *source, std::size_t count
+    );
+
+    /// <summary>Writes an array of signed 64 bit integers into the stream</summary>
+    /// <param name="source">Array holding the values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteArray(
+      const std::int64_t *source, std::size_t count
+    );
+
+    /// <summary>Writes an array of floating point values into the stream</summary>
+    /// <param name="source">Array holding the values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteArray(
+      const float *source, std::size_t count
+    );
+
+    /// <summary>Writes an array of double precision floating point values into the stream</summary>
+    /// <param name="source">Array holding the values that will be written</param>
+    /// <param name="count">Number of values that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteArray(
+      const double *source, std::size_t count
+    );
+
   };
 
   // ------------------------------------------------------------------------------------------- //
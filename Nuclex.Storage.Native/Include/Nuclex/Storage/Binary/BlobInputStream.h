@@ -0,0 +1,172 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_BLOBINPUTSTREAM_H
+#define NUCLEX_STORAGE_BINARY_BLOBINPUTSTREAM_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/InputStream.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Input stream that reads the contents of a blob from start to end</summary>
+  /// <remarks>
+  ///   <para>
+  ///     If the blob lets its memory be accessed directly (a sealed
+  ///     <see cref="MemoryBlob" /> or a <see cref="MappedFileBlob" />), the spans handed
+  ///     out by <see cref="AcquireReadableSpan" /> point right into the blob and nothing
+  ///     is ever copied. Other blobs are read into an internal buffer one chunk at
+  ///     a time and that buffer is handed out instead.
+  ///   </para>
+  ///   <para>
+  ///     <see cref="ReadUpTo" /> reads into the caller's buffer directly, so consumers
+  ///     that bring their own buffer don't pay for the internal one either.
+  ///   </para>
+  ///   <para>
+  ///     With readahead enabled, the stream starts reading the next chunk in
+  ///     the background (via <see cref="Blob.ReadAtAsync" />) each time it hands out
+  ///     a chunk, so on blobs with true asynchronous I/O the consumer rarely has to
+  ///     wait for the disk.
+  ///   </para>
+  /// </remarks>
+  class BlobInputStream : public InputStream {
+
+    /// <summary>Size of the chunks read from blobs that can't provide spans</summary>
+    public: static const std::size_t DefaultBufferByteCount = 16384;
+
+    /// <summary>Initializes a new input stream reading from the specified blob</summary>
+    /// <param name="blob">Blob whose contents the stream will provide</param>
+    /// <param name="bufferByteCount">
+    ///   Size of the chunks that will be read if the blob can't provide spans
+    /// </param>
+    /// <param name="readAhead">
+    ///   Whether the next chunk should be read in the background while the current
+    ///   chunk is being processed
+    /// </param>
+    public: NUCLEX_STORAGE_API BlobInputStream(
+      const std::shared_ptr<const Blob> &blob,
+      std::size_t bufferByteCount = DefaultBufferByteCount,
+      bool readAhead = false
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~BlobInputStream() override;
+
+    /// <summary>Retrieves the position of the next byte the stream will provide</summary>
+    /// <returns>The position in the blob the stream is currently at</returns>
+    public: NUCLEX_STORAGE_API std::uint64_t GetPosition() const {
+      return this->position;
+    }
+
+    /// <summary>Checks whether more data is available from the stream</summary>
+    /// <returns>True if the end of the blob has not been reached yet</returns>
+    public: NUCLEX_STORAGE_API bool IsMoreDataAvailable() const override;
+
+    /// <summary>Reads up to the specified number of bytes from the stream</summary>
+    /// <param name="buffer">Buffer in which the data will be stored</param>
+    /// <param name="byteCount">
+    ///   Maximum number of bytes to read from the stream, will receive the number
+    ///   of bytes actually placed in the buffer
+    /// </param>
+    /// <param name="requiredByteCount">
+    ///   Number of bytes that should at least be written to the buffer
+    /// </param>
+    /// <returns>True if the end of the stream was reached, false otherwise</returns>
+    public: NUCLEX_STORAGE_API bool ReadUpTo(
+      std::uint8_t *buffer, std::size_t &byteCount, std::size_t requiredByteCount = 1
+    ) override;
+
+    /// <summary>Provides direct access to the next unread bytes</summary>
+    /// <param name="byteCount">
+    ///   Receives the number of bytes that can be read from the returned address
+    /// </param>
+    /// <returns>
+    ///   The address of the next unread byte or a null pointer if the end of the blob
+    ///   has been reached
+    /// </returns>
+    public: NUCLEX_STORAGE_API const std::uint8_t *AcquireReadableSpan(
+      std::size_t &byteCount
+    ) override;
+
+    /// <summary>Advances the stream past bytes taken from an acquired span</summary>
+    /// <param name="byteCount">Number of bytes that have been processed</param>
+    public: NUCLEX_STORAGE_API void ConsumeReadableSpan(std::size_t byteCount) override;
+
+    /// <summary>Begins reading the chunk following the current span in the background</summary>
+    private: void startReadAhead();
+
+    /// <summary>Turns the chunk read in the background into the current span</summary>
+    /// <returns>True if a chunk was read ahead at the current position</returns>
+    private: bool takeReadAhead();
+
+    /// <summary>Waits for any chunk being read in the background and drops it</summary>
+    private: void discardReadAhead();
+
+    private: BlobInputStream(const BlobInputStream &) = delete;
+    private: BlobInputStream &operator =(const BlobInputStream &) = delete;
+
+    /// <summary>Blob the stream is reading from</summary>
+    private: std::shared_ptr<const Blob> blob;
+    /// <summary>Position of the next byte the stream will provide</summary>
+    private: std::uint64_t position;
+    /// <summary>Size of the chunks read into the buffer</summary>
+    private: std::size_t bufferByteCount;
+    /// <summary>Buffer the blob is read into if it can't provide spans</summary>
+    private: std::vector<std::uint8_t> buffer;
+    /// <summary>Start of the unread bytes in the buffer or the blob's memory</summary>
+    private: const std::uint8_t *spanStart;
+    /// <summary>Number of unread bytes available at the span's start</summary>
+    private: std::size_t spanByteCount;
+    /// <summary>Whether chunks will be read in the background</summary>
+    private: bool readAhead;
+    /// <summary>Buffer the next chunk is being read into in the background</summary>
+    private: std::vector<std::uint8_t> readAheadBuffer;
+    /// <summary>Completes when the chunk being read in the background has arrived</summary>
+    private: std::future<void> readAheadCompletion;
+    /// <summary>Position in the blob the chunk being read in the background starts at</summary>
+    private: std::uint64_t readAheadPosition;
+    /// <summary>Number of bytes being read in the background</summary>
+    private: std::size_t readAheadByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_BLOBINPUTSTREAM_H
@@ -0,0 +1,154 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_BLOBOUTPUTSTREAM_H
+#define NUCLEX_STORAGE_BINARY_BLOBOUTPUTSTREAM_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/OutputStream.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Output stream that appends the data written to it to a blob</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Data is collected in an internal buffer and written into the blob in chunks
+  ///     whenever the buffer is full. Writes larger than the buffer go straight into
+  ///     the blob. The buffer can also be filled directly: write into the memory
+  ///     returned by <see cref="GetBuffer" />, then pass that same address to
+  ///     <see cref="WriteUpTo" /> and no copy will be made.
+  ///   </para>
+  ///   <para>
+  ///     With write-behind enabled, full chunks are handed to the blob via
+  ///     <see cref="Blob.WriteAtAsync" /> and the stream continues filling a second
+  ///     buffer while the chunk is being written. Errors from such a write surface
+  ///     on the next write or flush.
+  ///   </para>
+  ///   <para>
+  ///     Call <see cref="Flush" /> when done writing. The destructor flushes, too,
+  ///     but has no way to report errors.
+  ///   </para>
+  /// </remarks>
+  class BlobOutputStream : public OutputStream {
+
+    /// <summary>Size of the chunks in which data is written into the blob</summary>
+    public: static const std::size_t DefaultBufferByteCount = 16384;
+
+    /// <summary>Initializes a new output stream writing into the specified blob</summary>
+    /// <param name="blob">Blob the stream will write into</param>
+    /// <param name="bufferByteCount">
+    ///   Size of the chunks in which data will be written into the blob
+    /// </param>
+    /// <param name="writeBehind">
+    ///   Whether chunks should be written in the background while the next chunk
+    ///   is being filled
+    /// </param>
+    /// <param name="startPosition">Position in the blob the stream starts writing at</param>
+    public: NUCLEX_STORAGE_API BlobOutputStream(
+      const std::shared_ptr<Blob> &blob,
+      std::size_t bufferByteCount = DefaultBufferByteCount,
+      bool writeBehind = false,
+      std::uint64_t startPosition = 0
+    );
+
+    /// <summary>Flushes the stream and frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~BlobOutputStream() override;
+
+    /// <summary>Retrieves the position the next byte written will end up at</summary>
+    /// <returns>The position in the blob the stream is currently at</returns>
+    public: NUCLEX_STORAGE_API std::uint64_t GetPosition() const {
+      return this->position + this->bufferedByteCount;
+    }
+
+    /// <summary>Checks whether the stream is able to accept at least one more byte</summary>
+    /// <returns>Always true, blobs can grow as needed</returns>
+    public: NUCLEX_STORAGE_API bool CanAcceptMoreData() const override;
+
+    /// <summary>Writes the specified number of bytes into the stream</summary>
+    /// <param name="buffer">Buffer holding the data that will be written</param>
+    /// <param name="byteCount">Number of bytes that will be written to the stream</param>
+    /// <param name="minimumByteCount">Ignored, all bytes are always written</param>
+    public: NUCLEX_STORAGE_API void WriteUpTo(
+      const std::uint8_t *buffer, std::size_t &byteCount, std::size_t minimumByteCount = 1
+    ) override;
+
+    /// <summary>Provides the unused part of the internal buffer for writing into</summary>
+    /// <param name="bufferSize">Receives the number of bytes that fit in the buffer</param>
+    /// <returns>The address at which data can be placed in the internal buffer</returns>
+    public: NUCLEX_STORAGE_API std::uint8_t *GetBuffer(std::size_t &bufferSize) override;
+
+    /// <summary>Writes all buffered data into the blob and waits for it to arrive</summary>
+    /// <remarks>
+    ///   This does not flush the blob itself. If the data needs to reach the disk,
+    ///   call the blob's Flush() method afterwards.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Flush();
+
+    /// <summary>Writes the buffered data into the blob</summary>
+    private: void writeBuffer();
+
+    /// <summary>Waits for a chunk being written in the background to arrive</summary>
+    private: void waitForWriteBehind();
+
+    private: BlobOutputStream(const BlobOutputStream &) = delete;
+    private: BlobOutputStream &operator =(const BlobOutputStream &) = delete;
+
+    /// <summary>Blob the stream is writing into</summary>
+    private: std::shared_ptr<Blob> blob;
+    /// <summary>Position in the blob the buffered data will be written to</summary>
+    private: std::uint64_t position;
+    /// <summary>Size of the chunks written into the blob</summary>
+    private: std::size_t bufferByteCount;
+    /// <summary>Buffer collecting the data written to the stream</summary>
+    private: std::vector<std::uint8_t> buffer;
+    /// <summary>Number of bytes currently held in the buffer</summary>
+    private: std::size_t bufferedByteCount;
+    /// <summary>Whether chunks will be written in the background</summary>
+    private: bool writeBehind;
+    /// <summary>Buffer holding the chunk being written in the background</summary>
+    private: std::vector<std::uint8_t> writeBehindBuffer;
+    /// <summary>Completes when the chunk being written in the background has arrived</summary>
+    private: std::future<void> writeBehindCompletion;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_BLOBOUTPUTSTREAM_H
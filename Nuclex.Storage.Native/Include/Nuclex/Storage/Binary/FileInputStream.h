@@ -0,0 +1,61 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_FILEINPUTSTREAM_H
+#define NUCLEX_STORAGE_BINARY_FILEINPUTSTREAM_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/BlobInputStream.h"
+
+#include <cstddef>
+#include <string>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Input stream that reads a file from start to end</summary>
+  /// <remarks>
+  ///   Reads the file through a <see cref="FileBlob" /> in large chunks and always
+  ///   reads the next chunk in the background while the current one is being consumed,
+  ///   which keeps the disk busy while the consumer is decompressing or parsing.
+  /// </remarks>
+  class FileInputStream : public BlobInputStream {
+
+    /// <summary>Size of the chunks in which the file is read by default</summary>
+    public: static const std::size_t DefaultChunkByteCount = 1048576;
+
+    /// <summary>Opens the specified file for reading</summary>
+    /// <param name="path">Path of the file that will be read</param>
+    /// <param name="chunkByteCount">Size of the chunks in which the file will be read</param>
+    public: NUCLEX_STORAGE_API FileInputStream(
+      const std::string &path, std::size_t chunkByteCount = DefaultChunkByteCount
+    );
+
+    /// <summary>Closes the file and frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~FileInputStream() override;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_FILEINPUTSTREAM_H
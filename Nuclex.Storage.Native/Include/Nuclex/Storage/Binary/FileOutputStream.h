@@ -0,0 +1,63 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_FILEOUTPUTSTREAM_H
+#define NUCLEX_STORAGE_BINARY_FILEOUTPUTSTREAM_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/BlobOutputStream.h"
+
+#include <cstddef>
+#include <string>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Output stream that writes a file from start to end</summary>
+  /// <remarks>
+  ///   The file is created if it doesn't exist and emptied if it does. Data is written
+  ///   through a <see cref="FileBlob" /> in large chunks, each chunk being written in
+  ///   the background while the next one is filled.
+  /// </remarks>
+  class FileOutputStream : public BlobOutputStream {
+
+    /// <summary>Size of the chunks in which the file is written by default</summary>
+    public: static const std::size_t DefaultChunkByteCount = 1048576;
+
+    /// <summary>Creates or overwrites the specified file</summary>
+    /// <param name="path">Path of the file that will be written</param>
+    /// <param name="chunkByteCount">
+    ///   Size of the chunks in which the file will be written
+    /// </param>
+    public: NUCLEX_STORAGE_API FileOutputStream(
+      const std::string &path, std::size_t chunkByteCount = DefaultChunkByteCount
+    );
+
+    /// <summary>Flushes the stream and closes the file</summary>
+    public: NUCLEX_STORAGE_API virtual ~FileOutputStream() override;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_FILEOUTPUTSTREAM_H
@@ -0,0 +1,192 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_FLATBLOBREADER_H
+#define NUCLEX_STORAGE_BINARY_FLATBLOBREADER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/FlatReference.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Accesses the structures in a flat blob in place</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Reads blobs written by the <see cref="FlatBlobWriter" />. The header is checked
+  ///     once when the reader is created. After that, resolving a reference is a bounds
+  ///     and alignment check followed by handing out the address of the value, nothing
+  ///     is deserialized and nothing is copied.
+  ///   </para>
+  ///   <para>
+  ///     If the blob can provide its contents as a contiguous span (memory-mapped files
+  ///     and sealed memory blobs), values are accessed right where the blob keeps them.
+  ///     Other blobs are read into memory once when the reader is created. The blob must
+  ///     not be modified while the reader is in use.
+  ///   </para>
+  ///   <para>
+  ///     References are checked against the blob's bounds and their type's alignment,
+  ///     so a corrupt blob results in an exception rather than a stray memory access.
+  ///     What the values themselves contain is up to the caller to check.
+  ///   </para>
+  /// </remarks>
+  class FlatBlobReader {
+
+    /// <summary>Checks whether a blob starts with the header of a flat blob</summary>
+    /// <param name="blob">Blob that will be checked</param>
+    /// <returns>True if the blob looks like a flat blob</returns>
+    public: NUCLEX_STORAGE_API static bool IsFlatBlob(const Blob &blob);
+
+    /// <summary>Initializes a new flat blob reader for the specified blob</summary>
+    /// <param name="blob">Blob the flat blob reader will access</param>
+    public: NUCLEX_STORAGE_API FlatBlobReader(const std::shared_ptr<const Blob> &blob);
+
+    /// <summary>Frees all resources owned by the flat blob reader</summary>
+    public: NUCLEX_STORAGE_API ~FlatBlobReader();
+
+    /// <summary>Whether the values are accessed directly in the blob's memory</summary>
+    /// <returns>True if the blob's contents did not have to be copied</returns>
+    public: NUCLEX_STORAGE_API bool IsAccessedInPlace() const {
+      return this->copy.empty();
+    }
+
+    /// <summary>Counts the bytes occupied by the flat blob</summary>
+    /// <returns>The number of bytes including the header</returns>
+    public: NUCLEX_STORAGE_API std::size_t GetByteCount() const {
+      return this->byteCount;
+    }
+
+    /// <summary>Accesses the value the writer designated as the root</summary>
+    /// <typeparam name="TValue">Type of value the root is</typeparam>
+    /// <returns>The root value</returns>
+    public: template<typename TValue>
+    const TValue &GetRoot() const {
+      FlatReference<TValue> root;
+      root.Offset = this->rootOffset;
+      return Resolve(root);
+    }
+
+    /// <summary>Accesses the value a reference points to</summary>
+    /// <typeparam name="TValue">Type of value the reference points to</typeparam>
+    /// <param name="reference">Reference that will be resolved</param>
+    /// <returns>The value the reference points to</returns>
+    /// <remarks>
+    ///   Throws an exception if the reference is null or points outside of the blob.
+    /// </remarks>
+    public: template<typename TValue>
+    const TValue &Resolve(const FlatReference<TValue> &reference) const {
+      static_assert(
+        IsFlatLayout<TValue>::value,
+        "Only trivially copyable, standard layout types can be stored in flat blobs"
+      );
+
+      return *static_cast<const TValue *>(
+        resolve(reference.Offset, sizeof(TValue), alignof(TValue))
+      );
+    }
+
+    /// <summary>Accesses the array an array reference points to</summary>
+    /// <typeparam name="TElement">Type of the values in the array</typeparam>
+    /// <param name="array">Array reference that will be resolved</param>
+    /// <returns>A view of the array the reference points to</returns>
+    /// <remarks>
+    ///   Null array references resolve to an empty array. Throws an exception if
+    ///   the array does not fit into the blob.
+    /// </remarks>
+    public: template<typename TElement>
+    FlatArrayView<TElement> Resolve(const FlatArray<TElement> &array) const {
+      static_assert(
+        IsFlatLayout<TElement>::value,
+        "Only trivially copyable, standard layout types can be stored in flat blobs"
+      );
+
+      std::size_t count;
+      const void *elements = resolveArray(
+        array.Offset, sizeof(TElement), alignof(TElement), count
+      );
+      return FlatArrayView<TElement>(static_cast<const TElement *>(elements), count);
+    }
+
+    /// <summary>Accesses the string an array reference points to</summary>
+    /// <param name="text">Array reference that will be resolved</param>
+    /// <returns>A view of the string's characters</returns>
+    /// <remarks>
+    ///   In addition to the checks done for other arrays, the string has to end with
+    ///   a terminating zero, so data() of the returned view is a valid C string.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API FlatArrayView<char> Resolve(const FlatArray<char> &text) const;
+
+    /// <summary>Looks up the address of a value, checking bounds and alignment</summary>
+    /// <param name="offset">Offset of the value from the start of the blob</param>
+    /// <param name="byteCount">Size of the value in bytes</param>
+    /// <param name="alignment">Alignment the value requires</param>
+    /// <returns>The address of the value</returns>
+    private: NUCLEX_STORAGE_API const void *resolve(
+      std::uint32_t offset, std::size_t byteCount, std::size_t alignment
+    ) const;
+
+    /// <summary>Looks up the address of an array, checking bounds and alignment</summary>
+    /// <param name="offset">Offset of the array's first element from the start</param>
+    /// <param name="elementByteCount">Size of a single element in bytes</param>
+    /// <param name="alignment">Alignment the elements require</param>
+    /// <param name="count">Receives the number of elements in the array</param>
+    /// <returns>The address of the array's first element</returns>
+    private: NUCLEX_STORAGE_API const void *resolveArray(
+      std::uint32_t offset, std::size_t elementByteCount, std::size_t alignment,
+      std::size_t &count
+    ) const;
+
+    private: FlatBlobReader(const FlatBlobReader &);
+    private: FlatBlobReader &operator =(const FlatBlobReader &);
+
+    /// <summary>Blob the flat blob reader accesses</summary>
+    private: std::shared_ptr<const Blob> blob;
+    /// <summary>Copy of the blob's contents if it can't provide a contiguous span</summary>
+    private: std::vector<std::uint64_t> copy;
+    /// <summary>Address of the flat blob's first byte</summary>
+    private: const std::uint8_t *start;
+    /// <summary>Number of bytes occupied by the flat blob</summary>
+    private: std::size_t byteCount;
+    /// <summary>Offset of the root value from the start of the blob</summary>
+    private: std::uint32_t rootOffset;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_FLATBLOBREADER_H
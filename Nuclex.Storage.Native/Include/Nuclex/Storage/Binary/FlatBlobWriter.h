@@ -0,0 +1,194 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_FLATBLOBWRITER_H
+#define NUCLEX_STORAGE_BINARY_FLATBLOBWRITER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/FlatReference.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lays out structures in a blob so they can be accessed in place</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Unlike the <see cref="BinaryBlobWriter" />, which stores fields one after another
+  ///     to be read back one after another, the flat blob writer stores whole structures
+  ///     exactly as they are in memory, properly aligned. A <see cref="FlatBlobReader" />
+  ///     can then hand out references directly into a memory-mapped file, so loading
+  ///     takes the same time no matter how much data the blob contains.
+  ///   </para>
+  ///   <para>
+  ///     Structures refer to each other through <see cref="FlatReference" /> and
+  ///     <see cref="FlatArray" /> members, which hold offsets instead of pointers.
+  ///     Values have to be added before any structure referencing them:
+  ///   </para>
+  ///   <code>
+  ///     struct Level {
+  ///       FlatArray&lt;char&gt; Name;
+  ///       FlatArray&lt;Vertex&gt; Vertices;
+  ///     };
+  ///
+  ///     FlatBlobWriter writer(blob);
+  ///     Level level;
+  ///     level.Name = writer.AddString(u8"Dungeon");
+  ///     level.Vertices = writer.AddArray(vertices);
+  ///     writer.Finish(writer.Add(level));
+  ///   </code>
+  ///   <para>
+  ///     Values are stored in the byte order of the system the blob is written on.
+  ///     Readers on a system with another byte order reject the blob.
+  ///   </para>
+  /// </remarks>
+  class FlatBlobWriter {
+
+    /// <summary>Initializes a new flat blob writer for the specified blob</summary>
+    /// <param name="blob">Blob the flat blob writer will write into</param>
+    /// <remarks>
+    ///   The values are collected in memory and written into the blob by
+    ///   <see cref="Finish" />, starting at the beginning of the blob.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API FlatBlobWriter(const std::shared_ptr<Blob> &blob);
+
+    /// <summary>Frees all memory used by the flat blob writer</summary>
+    public: NUCLEX_STORAGE_API ~FlatBlobWriter();
+
+    /// <summary>Counts the bytes the flat blob will occupy</summary>
+    /// <returns>The number of bytes the values added so far occupy</returns>
+    public: NUCLEX_STORAGE_API std::size_t GetByteCount() const {
+      return this->buffer.size();
+    }
+
+    /// <summary>Adds a value to the flat blob</summary>
+    /// <typeparam name="TValue">Type of value that will be added</typeparam>
+    /// <param name="value">Value that will be added</param>
+    /// <returns>A reference through which the value can be found again</returns>
+    public: template<typename TValue>
+    FlatReference<TValue> Add(const TValue &value) {
+      static_assert(
+        IsFlatLayout<TValue>::value,
+        "Only trivially copyable, standard layout types can be stored in flat blobs"
+      );
+
+      FlatReference<TValue> reference;
+      reference.Offset = append(&value, sizeof(TValue), alignof(TValue));
+      return reference;
+    }
+
+    /// <summary>Adds an array of values to the flat blob</summary>
+    /// <typeparam name="TElement">Type of the values in the array</typeparam>
+    /// <param name="elements">Values that will be added</param>
+    /// <param name="count">Number of values that will be added</param>
+    /// <returns>A reference through which the array can be found again</returns>
+    public: template<typename TElement>
+    FlatArray<TElement> AddArray(const TElement *elements, std::size_t count) {
+      static_assert(
+        IsFlatLayout<TElement>::value,
+        "Only trivially copyable, standard layout types can be stored in flat blobs"
+      );
+
+      FlatArray<TElement> array;
+      array.Offset = appendArray(elements, count, sizeof(TElement), alignof(TElement));
+      return array;
+    }
+
+    /// <summary>Adds an array of values to the flat blob</summary>
+    /// <typeparam name="TElement">Type of the values in the array</typeparam>
+    /// <param name="elements">Values that will be added</param>
+    /// <returns>A reference through which the array can be found again</returns>
+    public: template<typename TElement>
+    FlatArray<TElement> AddArray(const std::vector<TElement> &elements) {
+      return AddArray(elements.data(), elements.size());
+    }
+
+    /// <summary>Adds a string to the flat blob</summary>
+    /// <param name="text">String that will be added</param>
+    /// <returns>A reference through which the string can be found again</returns>
+    /// <remarks>
+    ///   A terminating zero is stored behind the characters, so the string can be
+    ///   used as a plain C string when it is read back.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API FlatArray<char> AddString(const std::string &text);
+
+    /// <summary>Stores all added values in the blob</summary>
+    /// <typeparam name="TValue">Type of the value readers will start from</typeparam>
+    /// <param name="root">Value readers will start from</param>
+    public: template<typename TValue>
+    void Finish(const FlatReference<TValue> &root) {
+      finish(root.Offset);
+    }
+
+    /// <summary>Appends a value to the buffer, padded to its alignment</summary>
+    /// <param name="value">Address of the value that will be appended</param>
+    /// <param name="byteCount">Size of the value in bytes</param>
+    /// <param name="alignment">Alignment the value requires</param>
+    /// <returns>The offset at which the value has been stored</returns>
+    private: NUCLEX_STORAGE_API std::uint32_t append(
+      const void *value, std::size_t byteCount, std::size_t alignment
+    );
+
+    /// <summary>Appends an array of values to the buffer with its element count</summary>
+    /// <param name="elements">Address of the first value that will be appended</param>
+    /// <param name="count">Number of values that will be appended</param>
+    /// <param name="elementByteCount">Size of a single value in bytes</param>
+    /// <param name="alignment">Alignment the values require</param>
+    /// <returns>The offset at which the first value has been stored</returns>
+    private: NUCLEX_STORAGE_API std::uint32_t appendArray(
+      const void *elements, std::size_t count,
+      std::size_t elementByteCount, std::size_t alignment
+    );
+
+    /// <summary>Writes the header and all values into the blob</summary>
+    /// <param name="rootOffset">Offset of the value readers will start from</param>
+    private: NUCLEX_STORAGE_API void finish(std::uint32_t rootOffset);
+
+    private: FlatBlobWriter(const FlatBlobWriter &);
+    private: FlatBlobWriter &operator =(const FlatBlobWriter &);
+
+    /// <summary>Blob the flat blob writer writes into</summary>
+    private: std::shared_ptr<Blob> blob;
+    /// <summary>Header and values as they will be written into the blob</summary>
+    private: std::vector<std::uint8_t> buffer;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_FLATBLOBWRITER_H
@@ -0,0 +1,163 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_FLATREFERENCE_H
+#define NUCLEX_STORAGE_BINARY_FLATREFERENCE_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Whether a type can be stored in a flat blob and accessed in place</summary>
+  /// <typeparam name="TValue">Type that will be checked</typeparam>
+  /// <remarks>
+  ///   Values are accessed directly in the blob's memory, so they must not contain
+  ///   pointers, virtual methods or anything else that needs a constructor to be valid.
+  ///   Refer to other values through <see cref="FlatReference" /> and
+  ///   <see cref="FlatArray" /> instead. Alignments beyond 8 bytes are not supported.
+  /// </remarks>
+  template<typename TValue>
+  struct IsFlatLayout : std::integral_constant<
+    bool,
+    std::is_trivially_copyable<TValue>::value &&
+    std::is_standard_layout<TValue>::value &&
+    (alignof(TValue) <= 8)
+  > {};
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Refers to a value stored in a flat blob</summary>
+  /// <typeparam name="TValue">Type of value the reference points to</typeparam>
+  /// <remarks>
+  ///   Stores the value's offset from the start of the blob, so the blob can be mapped
+  ///   to any address. An offset of zero is a null reference.
+  /// </remarks>
+  template<typename TValue>
+  struct FlatReference {
+
+    /// <summary>Checks whether the reference points nowhere</summary>
+    /// <returns>True if the reference is a null reference</returns>
+    public: bool IsNull() const { return (this->Offset == 0); }
+
+    /// <summary>Offset of the value from the start of the blob</summary>
+    public: std::uint32_t Offset;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Refers to an array of values stored in a flat blob</summary>
+  /// <typeparam name="TElement">Type of the values in the array</typeparam>
+  /// <remarks>
+  ///   Stores the offset of the first element from the start of the blob. The number
+  ///   of elements is stored in the 4 bytes in front of the first element. Strings are
+  ///   arrays of characters followed by a terminating zero that isn't counted.
+  /// </remarks>
+  template<typename TElement>
+  struct FlatArray {
+
+    /// <summary>Checks whether the array reference points nowhere</summary>
+    /// <returns>True if the array reference is a null reference</returns>
+    public: bool IsNull() const { return (this->Offset == 0); }
+
+    /// <summary>Offset of the array's first element from the start of the blob</summary>
+    public: std::uint32_t Offset;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides access to an array stored in a flat blob</summary>
+  /// <typeparam name="TElement">Type of the values in the array</typeparam>
+  /// <remarks>
+  ///   The view points into the blob's memory and remains valid only as long as
+  ///   the <see cref="FlatBlobReader" /> it was obtained through.
+  /// </remarks>
+  template<typename TElement>
+  class FlatArrayView {
+
+    /// <summary>Initializes a new view of an empty array</summary>
+    public: FlatArrayView() :
+      elements(nullptr),
+      count(0) {}
+
+    /// <summary>Initializes a new view of an array</summary>
+    /// <param name="elements">Address of the array's first element</param>
+    /// <param name="count">Number of elements in the array</param>
+    public: FlatArrayView(const TElement *elements, std::size_t count) :
+      elements(elements),
+      count(count) {}
+
+    /// <summary>Counts the elements in the array</summary>
+    /// <returns>The number of elements in the array</returns>
+    public: std::size_t size() const { return this->count; }
+
+    /// <summary>Checks whether the array contains no elements</summary>
+    /// <returns>True if the array is empty</returns>
+    public: bool empty() const { return (this->count == 0); }
+
+    /// <summary>Provides the address of the array's first element</summary>
+    /// <returns>The address of the first element</returns>
+    public: const TElement *data() const { return this->elements; }
+
+    /// <summary>Provides an iterator to the array's first element</summary>
+    /// <returns>The address of the first element</returns>
+    public: const TElement *begin() const { return this->elements; }
+
+    /// <summary>Provides an iterator one past the array's last element</summary>
+    /// <returns>The address behind the last element</returns>
+    public: const TElement *end() const { return this->elements + this->count; }
+
+    /// <summary>Accesses an element of the array</summary>
+    /// <param name="index">Index of the element that will be accessed</param>
+    /// <returns>The element at the specified index</returns>
+    public: const TElement &operator [](std::size_t index) const {
+      return this->elements[index];
+    }
+
+    /// <summary>Accesses an element of the array, checking the index</summary>
+    /// <param name="index">Index of the element that will be accessed</param>
+    /// <returns>The element at the specified index</returns>
+    public: const TElement &at(std::size_t index) const {
+      if(index >= this->count) {
+        throw std::out_of_range(u8"Index lies outside of the flat array");
+      }
+      return this->elements[index];
+    }
+
+    /// <summary>Address of the array's first element</summary>
+    private: const TElement *elements;
+    /// <summary>Number of elements in the array</summary>
+    private: std::size_t count;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_FLATREFERENCE_H
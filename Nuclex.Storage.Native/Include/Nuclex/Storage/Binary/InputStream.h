@@ -95,42 +95,47 @@ namespace Nuclex { namespace Storage { namespace Binary {
       std::uint8_t *buffer, std::size_t &byteCount, std::size_t requiredByteCount = 1
     ) = 0;
 
-#if 0
-    /// <summary>
-    ///   Asks the input stream for an optional buffer into which data from ReadUpTo()
-    ///   can be read
-    /// </summary>
-    /// <param name="bufferSize">
-    ///   Will be set to the number of bytes that fit in the buffer
+    /// <summary>Provides direct access to data the stream already holds in memory</summary>
+    /// <param name="byteCount">
+    ///   Receives the number of bytes that can be read from the returned address
     /// </param>
     /// <returns>
-    ///   The address of a buffer that can be used to read from the stream or NULL if
-    ///   the stream does not provide one
+    ///   The address of the next unread byte in the stream's memory or a null pointer
+    ///   if the stream does not provide direct access or has no more data
     /// </returns>
     /// <remarks>
     ///   <para>
     ///     This method allows for some advanced optimization but can be safely ignored if
-    ///     you're just normally reading from a stream. If implemented, it will return
-    ///     a buffer provided by the stream (and in turn, could be part of the stream through
-    ///     a memory-mapped file, socket buffer, locked GPU memory or other source).
-    ///   </para>
-    ///   <para>
-    ///     A stream implementing the GetBuffer() method should check in its
-    ///     <see cref="ReadUpTo" /> method whether the passed pointer matches this returned
-    ///     buffer, in which case an additional memory copy from the socket buffer, GPU 
-    ///     memory or other internal memory block to the caller's buffer can be avoided.
+    ///     you're just normally reading from a stream. Streams that already hold their
+    ///     data in memory (a memory blob, a memory-mapped file, a socket's receive buffer
+    ///     or the output window of a decompressor) can hand out that memory directly,
+    ///     saving the consumer a copy into its own buffer.
     ///   </para>
     ///   <para>
-    ///     The caller may have ignored the provided buffer (for example, because it was
-    ///     too small), so if the pointer passed to <see cref="WriteUpTo" /> doesn't match,
-    ///     the output stream implementation needs to proceed as normal.
+    ///     Acquiring a span does not advance the stream. Once the consumer has processed
+    ///     some or all of the bytes, it calls <see cref="ConsumeReadableSpan" /> to move
+    ///     past them. The span stays valid until it is consumed or until any other method
+    ///     is called on the stream. Callers should be prepared for spans of any size and
+    ///     fall back to <see cref="ReadUpTo" /> when a null pointer is returned.
     ///   </para>
     /// </remarks>
-    public: virtual std::uint8_t *GetBuffer(std::size_t &bufferSize) {
-      (void)bufferSize;
+    public: virtual const std::uint8_t *AcquireReadableSpan(std::size_t &byteCount) {
+      byteCount = 0;
       return nullptr;
     }
-#endif
+
+    /// <summary>Advances the stream past bytes taken from an acquired span</summary>
+    /// <param name="byteCount">
+    ///   Number of bytes that have been processed, at most the size of the span returned
+    ///   by the last call to <see cref="AcquireReadableSpan" />
+    /// </param>
+    /// <remarks>
+    ///   Must only be called after <see cref="AcquireReadableSpan" /> returned a span.
+    ///   Streams that do not provide spans can keep the default implementation.
+    /// </remarks>
+    public: virtual void ConsumeReadableSpan(std::size_t byteCount) {
+      (void)byteCount;
+    }
 
   };
 
@@ -0,0 +1,164 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_MEMORYPIPE_H
+#define NUCLEX_STORAGE_BINARY_MEMORYPIPE_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Binary/InputStream.h"
+#include "Nuclex/Storage/Binary/OutputStream.h"
+
+#include <Nuclex/Support/Collections/ShiftBuffer.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stream that hands the data written into it to whoever reads from it</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The pipe connects a producer (for example a decompressor) with a consumer (for
+  ///     example a parser) without either having to know about the other. Data is held
+  ///     in a shift buffer, so the unread bytes always form one contiguous span that
+  ///     readers can process in place via <see cref="AcquireReadableSpan" />.
+  ///   </para>
+  ///   <para>
+  ///     Reading and writing can happen from different threads. Reads that require
+  ///     more bytes than are in the pipe wait for the writer and writes that require
+  ///     more space than is free wait for the reader. Once the writer is done, it calls
+  ///     <see cref="Close" />, after which the reader can drain the remaining bytes.
+  ///   </para>
+  ///   <para>
+  ///     While a span is acquired, writes from other threads wait until the span has
+  ///     been consumed, so the memory it points to stays put. Writes from the thread
+  ///     holding the span proceed and invalidate the span.
+  ///   </para>
+  /// </remarks>
+  class MemoryPipe : public InputStream, public OutputStream {
+
+    /// <summary>Number of bytes the pipe can hold by default</summary>
+    public: static const std::size_t DefaultCapacity = 1048576;
+
+    /// <summary>Initializes a new, empty pipe</summary>
+    /// <param name="capacity">Number of bytes the pipe can hold before writes wait</param>
+    public: NUCLEX_STORAGE_API MemoryPipe(std::size_t capacity = DefaultCapacity);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~MemoryPipe() override;
+
+    /// <summary>Signals that no more data will be written into the pipe</summary>
+    /// <remarks>
+    ///   Readers waiting for more data than is left in the pipe will receive
+    ///   an exception. Writing into a closed pipe throws an exception.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Close();
+
+    /// <summary>Checks whether the pipe has been closed by its writer</summary>
+    /// <returns>True if no more data will be written into the pipe</returns>
+    public: NUCLEX_STORAGE_API bool IsClosed() const;
+
+    /// <summary>Counts the bytes currently waiting in the pipe</summary>
+    /// <returns>The number of bytes that can be read without waiting</returns>
+    public: NUCLEX_STORAGE_API std::size_t CountAvailableBytes() const;
+
+    /// <summary>Checks whether more data is available from the stream</summary>
+    /// <returns>True if at least one byte can be read without waiting</returns>
+    public: NUCLEX_STORAGE_API bool IsMoreDataAvailable() const override;
+
+    /// <summary>Reads up to the specified number of bytes from the stream</summary>
+    /// <param name="buffer">Buffer in which the data will be stored</param>
+    /// <param name="byteCount">
+    ///   Maximum number of bytes to read from the stream, will receive the number
+    ///   of bytes actually placed in the buffer
+    /// </param>
+    /// <param name="requiredByteCount">
+    ///   Number of bytes that should at least be written to the buffer
+    /// </param>
+    /// <returns>True if the pipe is closed and has been drained completely</returns>
+    public: NUCLEX_STORAGE_API bool ReadUpTo(
+      std::uint8_t *buffer, std::size_t &byteCount, std::size_t requiredByteCount = 1
+    ) override;
+
+    /// <summary>Provides direct access to the bytes waiting in the pipe</summary>
+    /// <param name="byteCount">
+    ///   Receives the number of bytes that can be read from the returned address
+    /// </param>
+    /// <returns>
+    ///   The address of the next unread byte or a null pointer if the pipe is empty
+    /// </returns>
+    public: NUCLEX_STORAGE_API const std::uint8_t *AcquireReadableSpan(
+      std::size_t &byteCount
+    ) override;
+
+    /// <summary>Removes bytes taken from an acquired span from the pipe</summary>
+    /// <param name="byteCount">Number of bytes that have been processed</param>
+    public: NUCLEX_STORAGE_API void ConsumeReadableSpan(std::size_t byteCount) override;
+
+    /// <summary>Checks whether the stream is able to accept at least one more byte</summary>
+    /// <returns>True if the pipe is open and has free space</returns>
+    public: NUCLEX_STORAGE_API bool CanAcceptMoreData() const override;
+
+    /// <summary>Writes up to the specified number of bytes into the stream</summary>
+    /// <param name="buffer">Buffer holding the data that will be written</param>
+    /// <param name="byteCount">
+    ///   Maximum number of bytes that will be written to the stream, set to
+    ///   the number of bytes actually written.
+    /// </param>
+    /// <param name="minimumByteCount">
+    ///   Number of bytes that should at least be written, waiting for the reader
+    ///   to free up space if needed
+    /// </param>
+    public: NUCLEX_STORAGE_API void WriteUpTo(
+      const std::uint8_t *buffer, std::size_t &byteCount, std::size_t minimumByteCount = 1
+    ) override;
+
+    private: MemoryPipe(const MemoryPipe &) = delete;
+    private: MemoryPipe &operator =(const MemoryPipe &) = delete;
+
+    /// <summary>Number of bytes the pipe can hold before writes wait</summary>
+    private: std::size_t capacity;
+    /// <summary>Holds the bytes that have been written but not read yet</summary>
+    private: Nuclex::Support::Collections::ShiftBuffer<std::uint8_t> buffer;
+    /// <summary>Whether the writer has closed the pipe</summary>
+    private: bool closed;
+    /// <summary>Whether a reader currently holds a span into the buffer</summary>
+    private: bool spanAcquired;
+    /// <summary>Thread that acquired the current span</summary>
+    private: std::thread::id spanOwner;
+    /// <summary>Must be held while accessing the buffer or the pipe's state</summary>
+    private: mutable std::mutex mutex;
+    /// <summary>Signaled when data has been written or the pipe has been closed</summary>
+    private: std::condition_variable dataWritten;
+    /// <summary>Signaled when data has been read or a span has been consumed</summary>
+    private: std::condition_variable spaceFreed;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_MEMORYPIPE_H
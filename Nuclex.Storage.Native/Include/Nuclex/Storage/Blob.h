@@ -25,12 +25,35 @@ License along with this library
 
 #include <cstdint>
 #include <cstddef>
+#include <future>
+#include <vector>
 
 namespace Nuclex { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Describes a chunk of data that should be read from a blob</summary>
+  struct BlobReadRequest {
+
+    /// <summary>Absolute position data will be read from</summary>
+    public: std::uint64_t Location;
+    /// <summary>Buffer into which data will be read</summary>
+    public: void *Buffer;
+    /// <summary>Number of bytes that will be read</summary>
+    public: std::size_t Count;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Large binary piece of data supporting random access</summary>
+  /// <remarks>
+  ///   Besides the blocking ReadAt() and WriteAt() methods, blobs can be accessed
+  ///   asynchronously through <see cref="ReadAtAsync" /> and <see cref="WriteAtAsync" />.
+  ///   Blobs without a way to perform I/O in the background (like the
+  ///   <see cref="MemoryBlob" />) simply carry out the operation before returning
+  ///   an already completed future.
+  /// </remarks>
   class Blob {
 
     /// <summary>Frees all resources owned by the instance</summary>
@@ -59,6 +82,71 @@ namespace Nuclex { namespace Storage {
     /// <summary>Flushes all caches that may be chained to the blob</summary>
     public: virtual void Flush() = 0;
 
+    /// <summary>Begins reading raw data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    /// <returns>
+    ///   A future that completes when the data has been read or carries the exception
+    ///   that occurred while reading
+    /// </returns>
+    /// <remarks>
+    ///   The buffer has to stay alive until the future has completed.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual std::future<void> ReadAtAsync(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const;
+
+    /// <summary>Begins several reads of raw data from the blob at once</summary>
+    /// <param name="requests">Reads that will be carried out</param>
+    /// <param name="requestCount">Number of reads in the request array</param>
+    /// <returns>One future for each read, in the same order as the requests</returns>
+    /// <remarks>
+    ///   Blobs with true asynchronous I/O hand all reads to the operating system in one
+    ///   go, which is much cheaper than submitting them one by one. The request array
+    ///   itself can be discarded as soon as the method returns, the buffers have to
+    ///   stay alive until their futures have completed.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual std::vector<std::future<void>> ReadAtAsync(
+      const BlobReadRequest *requests, std::size_t requestCount
+    ) const;
+
+    /// <summary>Begins writing raw data into the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    /// <returns>
+    ///   A future that completes when the data has been written or carries the exception
+    ///   that occurred while writing
+    /// </returns>
+    /// <remarks>
+    ///   The buffer has to stay alive and unmodified until the future has completed.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual std::future<void> WriteAtAsync(
+      std::uint64_t location, const void *buffer, std::size_t count
+    );
+
+    /// <summary>Tries to provide direct access to a range of the blob's contents</summary>
+    /// <param name="location">Absolute position at which the range begins</param>
+    /// <param name="count">Number of bytes the range should cover</param>
+    /// <returns>
+    ///   The address of the first byte in the range or null if the blob can not provide
+    ///   its contents without copying them
+    /// </returns>
+    /// <remarks>
+    ///   The returned memory stays valid until the blob is destroyed or written to.
+    ///   Blobs which can not hand out their memory return null, in which case you have
+    ///   to fall back to <see cref="ReadAt" />. Requesting a range that extends beyond
+    ///   the end of the blob also returns null.
+    /// </remarks>
+    public: virtual const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t location, std::size_t count
+    ) const {
+      (void)location;
+      (void)count;
+      return nullptr;
+    }
+
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,151 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BLOBSLICE_H
+#define NUCLEX_STORAGE_BLOBSLICE_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint8_t
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Read-only blob that provides a range of bytes within another blob</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Useful to hand a single resource embedded in a larger blob (for example one asset
+  ///     inside a pack file) to a <see cref="Binary.BinaryBlobReader" /> or
+  ///     <see cref="Xml.XmlBlobReader" /> without copying its bytes. All reads are
+  ///     forwarded to the parent blob with the slice's offset added.
+  ///   </para>
+  ///   <para>
+  ///     Direct memory access through <see cref="TryGetContiguousSpan" /> is forwarded
+  ///     as well, so if the parent is a memory blob or memory-mapped file, readers that
+  ///     parse in place work on the parent's memory. Asynchronous reads are forwarded
+  ///     to the parent's asynchronous I/O, too.
+  ///   </para>
+  /// </remarks>
+  class BlobSlice : public Blob {
+
+    /// <summary>Initializes a new slice of the specified blob</summary>
+    /// <param name="parent">Blob the slice will provide a range of</param>
+    /// <param name="offset">Position in the parent blob at which the slice begins</param>
+    /// <param name="length">Number of bytes the slice covers</param>
+    /// <remarks>
+    ///   The range has to lie within the parent blob, otherwise an exception is thrown.
+    ///   The parent blob should not shrink while the slice exists.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API BlobSlice(
+      const std::shared_ptr<const Blob> &parent, std::uint64_t offset, std::uint64_t length
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~BlobSlice() override = default;
+
+    /// <summary>Determines the number of bytes the slice covers</summary>
+    /// <returns>The size of the slice in bytes</returns>
+    public: NUCLEX_STORAGE_API virtual std::uint64_t GetSize() const override {
+      return this->length;
+    }
+
+    /// <summary>Reads data from the parent blob within the slice</summary>
+    /// <param name="location">Position relative to the start of the slice</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadAt(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Always throws because blob slices are read-only</summary>
+    /// <param name="location">Position data would be written to</param>
+    /// <param name="buffer">Buffer from which data would be taken</param>
+    /// <param name="count">Number of bytes that would be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteAt(
+      std::uint64_t location, const void *buffer, std::size_t count
+    ) override;
+
+    /// <summary>Flushes all caches that may be chained to the blob</summary>
+    public: NUCLEX_STORAGE_API virtual void Flush() override {}
+
+    /// <summary>Begins reading data from the parent blob within the slice</summary>
+    /// <param name="location">Position relative to the start of the slice</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    /// <returns>
+    ///   A future that completes when the data has been read or carries the exception
+    ///   that occurred while reading
+    /// </returns>
+    public: NUCLEX_STORAGE_API virtual std::future<void> ReadAtAsync(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Begins several reads of data from the parent blob at once</summary>
+    /// <param name="requests">Reads that will be carried out</param>
+    /// <param name="requestCount">Number of reads in the request array</param>
+    /// <returns>One future for each read, in the same order as the requests</returns>
+    public: NUCLEX_STORAGE_API virtual std::vector<std::future<void>> ReadAtAsync(
+      const BlobReadRequest *requests, std::size_t requestCount
+    ) const override;
+
+    /// <summary>Tries to provide direct access to a range of the slice's contents</summary>
+    /// <param name="location">Position relative to the start of the slice</param>
+    /// <param name="count">Number of bytes the range should cover</param>
+    /// <returns>
+    ///   The address of the first byte in the range or null if the parent blob can not
+    ///   provide its contents without copying them
+    /// </returns>
+    public: NUCLEX_STORAGE_API virtual const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t location, std::size_t count
+    ) const override;
+
+    /// <summary>Retrieves the position in the parent blob at which the slice begins</summary>
+    /// <returns>The offset of the slice's first byte in the parent blob</returns>
+    public: std::uint64_t GetOffset() const { return this->offset; }
+
+    /// <summary>Checks whether a range lies within the slice</summary>
+    /// <param name="location">Position relative to the start of the slice</param>
+    /// <param name="count">Number of bytes in the range</param>
+    /// <returns>True if the whole range lies within the slice</returns>
+    private: bool isInRange(std::uint64_t location, std::size_t count) const {
+      return (location <= this->length) && (count <= this->length - location);
+    }
+
+    private: BlobSlice(const BlobSlice &) = delete;
+    private: BlobSlice &operator =(const BlobSlice &) = delete;
+
+    /// <summary>Blob the slice provides a range of</summary>
+    private: std::shared_ptr<const Blob> parent;
+    /// <summary>Position in the parent blob at which the slice begins</summary>
+    private: std::uint64_t offset;
+    /// <summary>Number of bytes the slice covers</summary>
+    private: std::uint64_t length;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_BLOBSLICE_H
@@ -0,0 +1,119 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_CHECKSUMS_ADLER32_H
+#define NUCLEX_STORAGE_CHECKSUMS_ADLER32_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class InputStream;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates Adler-32 checksums of data that may arrive in several pieces</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Adler-32 is the checksum stored in zlib streams. It is weaker than a CRC,
+  ///     especially for short inputs, but can be verified against existing zlib data.
+  ///   </para>
+  ///   <para>
+  ///     Both sums are only reduced modulo 65521 every few thousand bytes. If the library
+  ///     is compiled for SSSE3, 32 bytes are summed per step using SIMD instructions.
+  ///   </para>
+  /// </remarks>
+  class Adler32 {
+
+    /// <summary>Calculates the Adler-32 checksum of a buffer</summary>
+    /// <param name="data">Data whose checksum will be calculated</param>
+    /// <param name="byteCount">Number of bytes in the buffer</param>
+    /// <returns>The Adler-32 checksum of the data</returns>
+    public: static std::uint32_t Compute(const void *data, std::size_t byteCount) {
+      Adler32 adler32;
+      adler32.Update(data, byteCount);
+      return adler32.GetValue();
+    }
+
+    /// <summary>Calculates the Adler-32 checksum of a blob's contents</summary>
+    /// <param name="blob">Blob whose checksum will be calculated</param>
+    /// <returns>The Adler-32 checksum of the blob's contents</returns>
+    public: static std::uint32_t Compute(const Blob &blob) {
+      Adler32 adler32;
+      adler32.Update(blob);
+      return adler32.GetValue();
+    }
+
+    /// <summary>Initializes a new Adler-32 checksum calculation</summary>
+    public: Adler32() : sum(1), weightedSum(0) {}
+
+    /// <summary>Adds the next piece of data to the checksum</summary>
+    /// <param name="data">Data that will be added to the checksum</param>
+    /// <param name="byteCount">Number of bytes that will be added</param>
+    public: NUCLEX_STORAGE_API void Update(const void *data, std::size_t byteCount);
+
+    /// <summary>Adds the contents of a blob to the checksum</summary>
+    /// <param name="blob">Blob whose contents will be added to the checksum</param>
+    public: NUCLEX_STORAGE_API void Update(const Blob &blob);
+
+    /// <summary>Adds everything that can be read from a stream to the checksum</summary>
+    /// <param name="stream">Stream that will be read until its end</param>
+    public: NUCLEX_STORAGE_API void Update(Binary::InputStream &stream);
+
+    /// <summary>Returns the checksum of all data that has been added so far</summary>
+    /// <returns>The Adler-32 checksum of the data added so far</returns>
+    /// <remarks>
+    ///   More data can be added afterwards to continue the checksum calculation.
+    /// </remarks>
+    public: std::uint32_t GetValue() const { return (this->weightedSum << 16) | this->sum; }
+
+    /// <summary>Sum of all bytes plus one, modulo 65521</summary>
+    private: std::uint32_t sum;
+    /// <summary>Sum of the byte sums after each byte, modulo 65521</summary>
+    private: std::uint32_t weightedSum;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
+
+#endif // NUCLEX_STORAGE_CHECKSUMS_ADLER32_H
@@ -0,0 +1,119 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_CHECKSUMS_CRC32C_H
+#define NUCLEX_STORAGE_CHECKSUMS_CRC32C_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class InputStream;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates CRC-32C checksums of data that may arrive in several pieces</summary>
+  /// <remarks>
+  ///   <para>
+  ///     CRC-32C uses the Castagnoli polynomial, which detects more errors than the one
+  ///     used by zlib and, more importantly, has its own instruction on current CPUs.
+  ///     If the library is compiled for SSE 4.2 or for ARMv8 with the CRC extension,
+  ///     the checksum is calculated 8 bytes at a time with those instructions, otherwise
+  ///     a table-driven implementation processing 8 bytes per step is used.
+  ///   </para>
+  ///   <para>
+  ///     The checksums match those of iSCSI, ext4, Btrfs and Google's crc32c library.
+  ///   </para>
+  /// </remarks>
+  class Crc32c {
+
+    /// <summary>Calculates the CRC-32C checksum of a buffer</summary>
+    /// <param name="data">Data whose checksum will be calculated</param>
+    /// <param name="byteCount">Number of bytes in the buffer</param>
+    /// <returns>The CRC-32C checksum of the data</returns>
+    public: static std::uint32_t Compute(const void *data, std::size_t byteCount) {
+      Crc32c crc32c;
+      crc32c.Update(data, byteCount);
+      return crc32c.GetValue();
+    }
+
+    /// <summary>Calculates the CRC-32C checksum of a blob's contents</summary>
+    /// <param name="blob">Blob whose checksum will be calculated</param>
+    /// <returns>The CRC-32C checksum of the blob's contents</returns>
+    public: static std::uint32_t Compute(const Blob &blob) {
+      Crc32c crc32c;
+      crc32c.Update(blob);
+      return crc32c.GetValue();
+    }
+
+    /// <summary>Initializes a new CRC-32C checksum calculation</summary>
+    public: Crc32c() : state(0xFFFFFFFFU) {}
+
+    /// <summary>Adds the next piece of data to the checksum</summary>
+    /// <param name="data">Data that will be added to the checksum</param>
+    /// <param name="byteCount">Number of bytes that will be added</param>
+    public: NUCLEX_STORAGE_API void Update(const void *data, std::size_t byteCount);
+
+    /// <summary>Adds the contents of a blob to the checksum</summary>
+    /// <param name="blob">Blob whose contents will be added to the checksum</param>
+    public: NUCLEX_STORAGE_API void Update(const Blob &blob);
+
+    /// <summary>Adds everything that can be read from a stream to the checksum</summary>
+    /// <param name="stream">Stream that will be read until its end</param>
+    public: NUCLEX_STORAGE_API void Update(Binary::InputStream &stream);
+
+    /// <summary>Returns the checksum of all data that has been added so far</summary>
+    /// <returns>The CRC-32C checksum of the data added so far</returns>
+    /// <remarks>
+    ///   More data can be added afterwards to continue the checksum calculation.
+    /// </remarks>
+    public: std::uint32_t GetValue() const { return this->state ^ 0xFFFFFFFFU; }
+
+    /// <summary>Current checksum state before the final inversion</summary>
+    private: std::uint32_t state;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
+
+#endif // NUCLEX_STORAGE_CHECKSUMS_CRC32C_H
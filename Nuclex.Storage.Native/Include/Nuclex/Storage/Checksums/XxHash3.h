@@ -0,0 +1,141 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_CHECKSUMS_XXHASH3_H
+#define NUCLEX_STORAGE_CHECKSUMS_XXHASH3_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint8_t
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class InputStream;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates 64 bit XXH3 hashes of data that may arrive in several pieces</summary>
+  /// <remarks>
+  ///   <para>
+  ///     XXH3 is a non-cryptographic hash that runs at memory bandwidth. It is a good
+  ///     choice to detect accidental damage to large amounts of data. It should not be
+  ///     used where someone could deliberately craft colliding data.
+  ///   </para>
+  ///   <para>
+  ///     This implements the 64 bit variant with the default secret and a seed of zero,
+  ///     so the hashes match those of the reference library's <c>XXH3_64bits()</c>.
+  ///     Long inputs are processed in 64 byte stripes with SSE2 where available.
+  ///   </para>
+  /// </remarks>
+  class XxHash3 {
+
+    /// <summary>Calculates the XXH3 hash of a buffer</summary>
+    /// <param name="data">Data whose hash will be calculated</param>
+    /// <param name="byteCount">Number of bytes in the buffer</param>
+    /// <returns>The 64 bit XXH3 hash of the data</returns>
+    public: NUCLEX_STORAGE_API static std::uint64_t Compute(
+      const void *data, std::size_t byteCount
+    );
+
+    /// <summary>Calculates the XXH3 hash of a blob's contents</summary>
+    /// <param name="blob">Blob whose hash will be calculated</param>
+    /// <returns>The 64 bit XXH3 hash of the blob's contents</returns>
+    public: static std::uint64_t Compute(const Blob &blob) {
+      XxHash3 xxHash3;
+      xxHash3.Update(blob);
+      return xxHash3.GetValue();
+    }
+
+    /// <summary>Initializes a new XXH3 hash calculation</summary>
+    public: NUCLEX_STORAGE_API XxHash3();
+
+    /// <summary>Adds the next piece of data to the hash</summary>
+    /// <param name="data">Data that will be added to the hash</param>
+    /// <param name="byteCount">Number of bytes that will be added</param>
+    public: NUCLEX_STORAGE_API void Update(const void *data, std::size_t byteCount);
+
+    /// <summary>Adds the contents of a blob to the hash</summary>
+    /// <param name="blob">Blob whose contents will be added to the hash</param>
+    public: NUCLEX_STORAGE_API void Update(const Blob &blob);
+
+    /// <summary>Adds everything that can be read from a stream to the hash</summary>
+    /// <param name="stream">Stream that will be read until its end</param>
+    public: NUCLEX_STORAGE_API void Update(Binary::InputStream &stream);
+
+    /// <summary>Returns the hash of all data that has been added so far</summary>
+    /// <returns>The 64 bit XXH3 hash of the data added so far</returns>
+    /// <remarks>
+    ///   More data can be added afterwards to continue the hash calculation.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::uint64_t GetValue() const;
+
+    /// <summary>Accumulates stripes, scrambling the accumulators after each block</summary>
+    /// <param name="stripes">Stripes that will be accumulated</param>
+    /// <param name="stripeCount">Number of stripes that will be accumulated</param>
+    /// <param name="accumulators">Accumulators the stripes will be added to</param>
+    /// <param name="stripesInBlock">
+    ///   Number of stripes accumulated since the last scramble, will be updated
+    /// </param>
+    private: static void consumeStripes(
+      const std::uint8_t *stripes, std::size_t stripeCount,
+      std::uint64_t *accumulators, std::size_t &stripesInBlock
+    );
+
+    /// <summary>Accumulators the stripes of long inputs are added to</summary>
+    private: std::uint64_t accumulators[8];
+    /// <summary>Collects data until more than a full buffer is available</summary>
+    /// <remarks>
+    ///   The hash has to treat the final stripe of the data differently, so the buffer
+    ///   is only processed when more data follows it.
+    /// </remarks>
+    private: std::uint8_t buffer[256];
+    /// <summary>Number of bytes currently waiting in the buffer</summary>
+    private: std::size_t bufferedByteCount;
+    /// <summary>Number of stripes accumulated since the accumulators were scrambled</summary>
+    private: std::size_t stripesInBlock;
+    /// <summary>Total number of bytes that have been added</summary>
+    private: std::uint64_t totalByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
+
+#endif // NUCLEX_STORAGE_CHECKSUMS_XXHASH3_H
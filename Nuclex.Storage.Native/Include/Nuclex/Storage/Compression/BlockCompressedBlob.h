@@ -0,0 +1,277 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_BLOCKCOMPRESSEDBLOB_H
+#define NUCLEX_STORAGE_COMPRESSION_BLOCKCOMPRESSEDBLOB_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithm.h"
+
+#include <array> // for std::array
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint8_t
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class CompressionAlgorithmSelector;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Read-only blob that decompresses independently compressed blocks</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Compressing a large blob as a single stream keeps one CPU core busy while
+  ///     the others idle, and reading anything from the middle of it means decompressing
+  ///     everything before it. <see cref="Compress" /> instead cuts the blob into blocks
+  ///     of equal size that are compressed independently on several threads and stores
+  ///     them together with an index of where each compressed block begins.
+  ///   </para>
+  ///   <para>
+  ///     A block-compressed blob then provides the uncompressed contents with random
+  ///     access, decompressing only the blocks a read touches, so readers like
+  ///     the <see cref="BinaryBlobReader" /> or <see cref="XmlBlobReader" /> can work
+  ///     directly on compressed data packs. A few recently decompressed blocks are kept
+  ///     so that small reads don't decompress the same blocks over and over.
+  ///     <see cref="DecompressAll" /> decompresses all blocks in parallel.
+  ///   </para>
+  ///   <para>
+  ///     The container begins with a header holding the 8-byte ID of the compression
+  ///     algorithm, so any <see cref="CompressionAlgorithm" /> can be used and
+  ///     the right one looked up again via a <see cref="CompressionAlgorithmSelector" />.
+  ///     Reads can be performed from any number of threads if the container blob
+  ///     allows that, too.
+  ///   </para>
+  ///   <para>
+  ///     Optionally, a CRC-32C checksum of each compressed block can be stored in
+  ///     the index. Each block is then checked before it is decompressed, so damaged
+  ///     data is reported instead of being fed to the decompressor. With the CRC
+  ///     instructions of SSE 4.2 or ARMv8 this costs very little next to decompression.
+  ///   </para>
+  /// </remarks>
+  class BlockCompressedBlob : public Blob {
+
+    /// <summary>Number of uncompressed bytes in a block if not specified otherwise</summary>
+    public: static const std::size_t DefaultBlockByteCount = 1024 * 1024;
+
+    /// <summary>Number of decompressed blocks kept if not specified otherwise</summary>
+    public: static const std::size_t DefaultCachedBlockCount = 4;
+
+    /// <summary>Compresses a blob into a block-compressed container</summary>
+    /// <param name="algorithm">Compression algorithm that will be used for the blocks</param>
+    /// <param name="source">Blob whose contents will be compressed</param>
+    /// <param name="target">Blob into which the container will be written</param>
+    /// <param name="blockByteCount">Number of uncompressed bytes in each block</param>
+    /// <param name="threadCount">
+    ///   Number of threads compressing blocks, including the calling thread. Zero uses
+    ///   one thread per CPU core the system reports.
+    /// </param>
+    /// <param name="storeChecksums">
+    ///   Whether a checksum of each compressed block will be stored so that damaged
+    ///   blocks are detected when they are decompressed
+    /// </param>
+    /// <returns>The number of bytes the container occupies in the target blob</returns>
+    /// <remarks>
+    ///   The container is written at the beginning of the target blob. The source blob
+    ///   will be read by several threads at once and compressed blocks are written to
+    ///   the target in order as they become ready, so at most a few blocks per thread
+    ///   are held in memory regardless of the blob's size. Blocks of 1 to 4 MiB give
+    ///   a compression ratio close to that of a single stream.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API static std::uint64_t Compress(
+      const CompressionAlgorithm &algorithm, const Blob &source, Blob &target,
+      std::size_t blockByteCount = DefaultBlockByteCount, std::size_t threadCount = 0,
+      bool storeChecksums = false
+    );
+
+    /// <summary>Opens a block-compressed container</summary>
+    /// <param name="container">Blob holding the block-compressed container</param>
+    /// <param name="algorithm">Compression algorithm the blocks were compressed with</param>
+    /// <param name="cachedBlockCount">
+    ///   Number of decompressed blocks that will be kept for subsequent reads, at least one
+    /// </param>
+    /// <remarks>
+    ///   Throws an exception if the container is damaged or was compressed with
+    ///   an algorithm that has a different ID than the one provided.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API BlockCompressedBlob(
+      const std::shared_ptr<const Blob> &container,
+      const std::shared_ptr<const CompressionAlgorithm> &algorithm,
+      std::size_t cachedBlockCount = DefaultCachedBlockCount
+    );
+
+    /// <summary>Opens a block-compressed container</summary>
+    /// <param name="container">Blob holding the block-compressed container</param>
+    /// <param name="selector">
+    ///   Selector in which the compression algorithm will be looked up by the ID
+    ///   stored in the container
+    /// </param>
+    /// <param name="cachedBlockCount">
+    ///   Number of decompressed blocks that will be kept for subsequent reads, at least one
+    /// </param>
+    public: NUCLEX_STORAGE_API BlockCompressedBlob(
+      const std::shared_ptr<const Blob> &container,
+      const CompressionAlgorithmSelector &selector,
+      std::size_t cachedBlockCount = DefaultCachedBlockCount
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~BlockCompressedBlob() override = default;
+
+    /// <summary>Determines the size of the uncompressed data in bytes</summary>
+    /// <returns>The size of the uncompressed data in bytes</returns>
+    public: NUCLEX_STORAGE_API virtual std::uint64_t GetSize() const override {
+      return this->uncompressedByteCount;
+    }
+
+    /// <summary>Reads uncompressed data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadAt(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Always throws because block-compressed blobs are read-only</summary>
+    /// <param name="location">Absolute position data would be written to</param>
+    /// <param name="buffer">Buffer from which data would be taken</param>
+    /// <param name="count">Number of bytes that would be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteAt(
+      std::uint64_t location, const void *buffer, std::size_t count
+    ) override;
+
+    /// <summary>Flushes all caches that may be chained to the blob</summary>
+    public: NUCLEX_STORAGE_API virtual void Flush() override {}
+
+    /// <summary>Counts the number of compressed blocks in the container</summary>
+    /// <returns>The number of blocks the uncompressed data has been split into</returns>
+    public: std::size_t CountBlocks() const {
+      return this->blockOffsets.size() - 1;
+    }
+
+    /// <summary>Returns the number of uncompressed bytes in each block</summary>
+    /// <returns>The number of uncompressed bytes in each block</returns>
+    /// <remarks>
+    ///   All blocks have this size except for the last one, which can be shorter.
+    /// </remarks>
+    public: std::size_t GetBlockByteCount() const {
+      return this->blockByteCount;
+    }
+
+    /// <summary>Checks whether the container stores a checksum for each block</summary>
+    /// <returns>True if blocks are checked for damage before they are decompressed</returns>
+    public: bool HasChecksums() const {
+      return this->hasChecksums;
+    }
+
+    /// <summary>Decompresses a single block</summary>
+    /// <param name="blockIndex">Index of the block that will be decompressed</param>
+    /// <param name="buffer">
+    ///   Buffer that receives the uncompressed block, must be able to hold
+    ///   <see cref="GetBlockByteCount" /> bytes
+    /// </param>
+    /// <returns>The number of bytes that have been decompressed</returns>
+    /// <remarks>
+    ///   If the container stores checksums, throws an exception if the compressed
+    ///   block does not match its checksum.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::size_t DecompressBlock(
+      std::size_t blockIndex, std::uint8_t *buffer
+    ) const;
+
+    /// <summary>Decompresses all blocks into another blob in parallel</summary>
+    /// <param name="target">Blob that will receive the uncompressed data</param>
+    /// <param name="threadCount">
+    ///   Number of threads decompressing blocks, including the calling thread. Zero uses
+    ///   one thread per CPU core the system reports.
+    /// </param>
+    /// <remarks>
+    ///   The blocks are decompressed on several threads at once and written into
+    ///   the target blob in order as they become ready, so the target doesn't need
+    ///   to support writes with gaps.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void DecompressAll(
+      Blob &target, std::size_t threadCount = 0
+    ) const;
+
+    /// <summary>Reads the header and block index from the container</summary>
+    /// <param name="cachedBlockCount">Number of decompressed blocks that will be kept</param>
+    /// <returns>The ID of the compression algorithm stored in the header</returns>
+    private: std::array<std::uint8_t, 8> readHeaderAndIndex(std::size_t cachedBlockCount);
+
+    /// <summary>Copies data out of a block, decompressing it if it's not cached</summary>
+    /// <param name="blockIndex">Index of the block data will be copied from</param>
+    /// <param name="offset">Offset within the uncompressed block to start copying at</param>
+    /// <param name="target">Buffer into which the data will be copied</param>
+    /// <param name="count">Maximum number of bytes that should be copied</param>
+    /// <returns>The number of bytes that have been copied</returns>
+    private: std::size_t readFromCachedBlock(
+      std::size_t blockIndex, std::size_t offset, std::uint8_t *target, std::size_t count
+    ) const;
+
+    /// <summary>Decompressed block kept for subsequent reads</summary>
+    private: struct CachedBlock {
+
+      /// <summary>Index of the block, equal to the block count if the slot is unused</summary>
+      public: std::size_t BlockIndex;
+      /// <summary>Value of the use counter when the block was last read from</summary>
+      public: std::uint64_t LastUse;
+      /// <summary>Uncompressed contents of the block</summary>
+      public: std::vector<std::uint8_t> Contents;
+
+    };
+
+    private: BlockCompressedBlob(const BlockCompressedBlob &) = delete;
+    private: BlockCompressedBlob &operator =(const BlockCompressedBlob &) = delete;
+
+    /// <summary>Blob holding the compressed blocks</summary>
+    private: std::shared_ptr<const Blob> container;
+    /// <summary>Compression algorithm the blocks were compressed with</summary>
+    private: std::shared_ptr<const CompressionAlgorithm> algorithm;
+    /// <summary>Total number of bytes in the uncompressed data</summary>
+    private: std::uint64_t uncompressedByteCount;
+    /// <summary>Number of uncompressed bytes in each block</summary>
+    private: std::size_t blockByteCount;
+    /// <summary>Position of each block in the container plus the end of the last block</summary>
+    private: std::vector<std::uint64_t> blockOffsets;
+    /// <summary>Whether the index holds a checksum for each compressed block</summary>
+    private: bool hasChecksums;
+    /// <summary>CRC-32C checksum of each compressed block if the index holds them</summary>
+    private: std::vector<std::uint32_t> blockChecksums;
+
+    /// <summary>Must be held while accessing the cached blocks</summary>
+    private: mutable std::mutex cacheMutex;
+    /// <summary>Incremented on each read, used to find the least recently used block</summary>
+    private: mutable std::uint64_t useCounter;
+    /// <summary>Recently decompressed blocks</summary>
+    private: mutable std::vector<CachedBlock> cachedBlocks;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_BLOCKCOMPRESSEDBLOB_H
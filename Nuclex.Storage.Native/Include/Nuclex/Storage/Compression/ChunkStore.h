@@ -0,0 +1,220 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_CHUNKSTORE_H
+#define NUCLEX_STORAGE_COMPRESSION_CHUNKSTORE_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithm.h"
+
+#include <array> // for std::array
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint32_t, std::uint8_t
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <unordered_map> // for std::unordered_map
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class CompressionAlgorithmSelector;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>SHA-256 hash of a chunk's uncompressed contents</summary>
+  typedef std::array<std::uint8_t, 32> ChunkHash;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Identifies a chunk in a chunk store</summary>
+  struct ChunkReference {
+
+    /// <summary>Hash of the chunk's uncompressed contents</summary>
+    public: ChunkHash Hash;
+    /// <summary>Number of bytes in the uncompressed chunk</summary>
+    public: std::uint32_t ByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores blobs as deduplicated, compressed chunks</summary>
+  /// <remarks>
+  ///   <para>
+  ///     <see cref="Store" /> cuts a blob into chunks at positions determined by
+  ///     the blob's contents (using a rolling gear hash similar to FastCDC). Inserting
+  ///     or removing bytes only changes the chunks around the edit, all other chunks
+  ///     are cut at the same places as before. Chunks are identified by the SHA-256 hash
+  ///     of their contents and each distinct chunk is compressed and kept only once,
+  ///     so many versions of a mostly unchanged blob take little more space than one.
+  ///   </para>
+  ///   <para>
+  ///     Storing a blob hands out the list of chunk references it consists of. These
+  ///     are all that needs to be kept to get the blob back, either chunk by chunk via
+  ///     <see cref="ReadChunk" /> or as a single read-only blob through
+  ///     the <see cref="ChunkedBlob" />. When transferring a blob to another store,
+  ///     <see cref="Contains" /> tells which of its chunks need to be sent at all.
+  ///   </para>
+  ///   <para>
+  ///     Chunks are appended to the container blob, each preceded by its hash and size.
+  ///     The container begins with a header holding the 8-byte ID of the compression
+  ///     algorithm. Opening a chunk store on an existing container scans the chunk
+  ///     headers to rebuild the index. All methods can be called from multiple threads
+  ///     if the container blob allows that, too.
+  ///   </para>
+  /// </remarks>
+  class ChunkStore {
+
+    /// <summary>Average number of bytes in a chunk if not specified otherwise</summary>
+    public: static const std::size_t DefaultAverageChunkByteCount = 64 * 1024;
+
+    /// <summary>Opens a chunk store or starts a new one in an empty blob</summary>
+    /// <param name="container">Blob in which the chunks are stored</param>
+    /// <param name="algorithm">Compression algorithm used for the chunks</param>
+    /// <remarks>
+    ///   Throws an exception if the container is damaged or its chunks were compressed
+    ///   with an algorithm that has a different ID than the one provided.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API ChunkStore(
+      const std::shared_ptr<Blob> &container,
+      const std::shared_ptr<const CompressionAlgorithm> &algorithm
+    );
+
+    /// <summary>Opens an existing chunk store</summary>
+    /// <param name="container">Blob in which the chunks are stored</param>
+    /// <param name="selector">
+    ///   Selector in which the compression algorithm will be looked up by the ID
+    ///   stored in the container
+    /// </param>
+    public: NUCLEX_STORAGE_API ChunkStore(
+      const std::shared_ptr<Blob> &container, const CompressionAlgorithmSelector &selector
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API ~ChunkStore();
+
+    /// <summary>Splits a blob into chunks and stores the ones not yet in the store</summary>
+    /// <param name="source">Blob that will be stored</param>
+    /// <param name="averageChunkByteCount">
+    ///   Number of bytes chunks should have on average. Chunks will have between a quarter
+    ///   and eight times as many bytes. Only blobs split with the same average chunk size
+    ///   share their chunks.
+    /// </param>
+    /// <returns>The chunks the blob consists of, in order</returns>
+    public: NUCLEX_STORAGE_API std::vector<ChunkReference> Store(
+      const Blob &source, std::size_t averageChunkByteCount = DefaultAverageChunkByteCount
+    );
+
+    /// <summary>Stores a single chunk if it is not yet in the store</summary>
+    /// <param name="chunk">Uncompressed contents of the chunk</param>
+    /// <param name="byteCount">Number of bytes in the chunk</param>
+    /// <returns>A reference through which the chunk can be read again</returns>
+    public: NUCLEX_STORAGE_API ChunkReference StoreChunk(
+      const std::uint8_t *chunk, std::size_t byteCount
+    );
+
+    /// <summary>Checks whether the store holds the chunk with the specified hash</summary>
+    /// <param name="hash">Hash of the chunk that will be looked for</param>
+    /// <returns>True if the chunk store holds the chunk</returns>
+    public: NUCLEX_STORAGE_API bool Contains(const ChunkHash &hash) const;
+
+    /// <summary>Counts the number of distinct chunks in the store</summary>
+    /// <returns>The number of chunks the store holds</returns>
+    public: NUCLEX_STORAGE_API std::size_t CountChunks() const;
+
+    /// <summary>Decompresses a chunk</summary>
+    /// <param name="chunk">Chunk that will be decompressed</param>
+    /// <param name="buffer">
+    ///   Buffer that receives the uncompressed chunk, must be able to hold as many bytes
+    ///   as the chunk reference indicates
+    /// </param>
+    /// <remarks>
+    ///   Throws an exception if the store does not hold the chunk.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void ReadChunk(
+      const ChunkReference &chunk, std::uint8_t *buffer
+    ) const;
+
+    /// <summary>Reads the header of the container and the chunks' headers</summary>
+    /// <returns>The ID of the compression algorithm stored in the header</returns>
+    private: std::array<std::uint8_t, 8> readHeaderAndIndex();
+
+    /// <summary>Position and size of a chunk in the container</summary>
+    private: struct ChunkLocation {
+
+      /// <summary>Position of the compressed contents in the container</summary>
+      public: std::uint64_t Location;
+      /// <summary>Number of bytes in the compressed chunk</summary>
+      public: std::uint32_t CompressedByteCount;
+      /// <summary>Number of bytes in the uncompressed chunk</summary>
+      public: std::uint32_t ByteCount;
+
+    };
+
+    /// <summary>Hashes a chunk hash for the index</summary>
+    private: struct ChunkHashHasher {
+
+      /// <summary>Hashes a chunk hash for the index</summary>
+      /// <param name="hash">Hash of a chunk's contents</param>
+      /// <returns>The bytes of the chunk hash that are used in the index</returns>
+      public: std::size_t operator()(const ChunkHash &hash) const {
+        std::size_t value = 0;
+        for(std::size_t index = 0; index < sizeof(value); ++index) {
+          value = (value << 8) | hash[index];
+        }
+        return value;
+      }
+
+    };
+
+    private: ChunkStore(const ChunkStore &) = delete;
+    private: ChunkStore &operator =(const ChunkStore &) = delete;
+
+    /// <summary>Blob holding the compressed chunks</summary>
+    private: std::shared_ptr<Blob> container;
+    /// <summary>Compression algorithm the chunks are compressed with</summary>
+    private: std::shared_ptr<const CompressionAlgorithm> algorithm;
+
+    /// <summary>Must be held while accessing the index or appending chunks</summary>
+    private: mutable std::mutex indexMutex;
+    /// <summary>Location of each chunk in the container by its hash</summary>
+    private: std::unordered_map<ChunkHash, ChunkLocation, ChunkHashHasher> index;
+    /// <summary>Position in the container at which the next chunk will be stored</summary>
+    private: std::uint64_t endLocation;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_CHUNKSTORE_H
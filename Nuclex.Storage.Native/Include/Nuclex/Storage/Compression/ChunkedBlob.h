@@ -0,0 +1,117 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_CHUNKEDBLOB_H
+#define NUCLEX_STORAGE_COMPRESSION_CHUNKEDBLOB_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+#include "Nuclex/Storage/Compression/ChunkStore.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint8_t
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Read-only blob that reassembles a blob from the chunks of a chunk store</summary>
+  /// <remarks>
+  ///   Provides random access to a blob that has been stored in a
+  ///   <see cref="ChunkStore" />, decompressing only the chunks a read touches.
+  ///   The most recently decompressed chunk is kept so that small reads don't
+  ///   decompress the same chunk over and over. Reads can be performed from any
+  ///   number of threads.
+  /// </remarks>
+  class ChunkedBlob : public Blob {
+
+    /// <summary>Initializes a new blob consisting of the specified chunks</summary>
+    /// <param name="store">Chunk store holding the chunks</param>
+    /// <param name="chunks">Chunks the blob consists of, in order</param>
+    public: NUCLEX_STORAGE_API ChunkedBlob(
+      const std::shared_ptr<const ChunkStore> &store,
+      const std::vector<ChunkReference> &chunks
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~ChunkedBlob() override = default;
+
+    /// <summary>Determines the size of the reassembled data in bytes</summary>
+    /// <returns>The size of the reassembled data in bytes</returns>
+    public: NUCLEX_STORAGE_API virtual std::uint64_t GetSize() const override {
+      return this->chunkOffsets.back();
+    }
+
+    /// <summary>Reads reassembled data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadAt(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Always throws because chunked blobs are read-only</summary>
+    /// <param name="location">Absolute position data would be written to</param>
+    /// <param name="buffer">Buffer from which data would be taken</param>
+    /// <param name="count">Number of bytes that would be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteAt(
+      std::uint64_t location, const void *buffer, std::size_t count
+    ) override;
+
+    /// <summary>Flushes all caches that may be chained to the blob</summary>
+    public: NUCLEX_STORAGE_API virtual void Flush() override {}
+
+    /// <summary>Copies data out of a chunk, decompressing it if it's not cached</summary>
+    /// <param name="chunkIndex">Index of the chunk data will be copied from</param>
+    /// <param name="offset">Offset within the uncompressed chunk to start copying at</param>
+    /// <param name="target">Buffer into which the data will be copied</param>
+    /// <param name="count">Maximum number of bytes that should be copied</param>
+    /// <returns>The number of bytes that have been copied</returns>
+    private: std::size_t readFromCachedChunk(
+      std::size_t chunkIndex, std::size_t offset, std::uint8_t *target, std::size_t count
+    ) const;
+
+    private: ChunkedBlob(const ChunkedBlob &) = delete;
+    private: ChunkedBlob &operator =(const ChunkedBlob &) = delete;
+
+    /// <summary>Chunk store holding the chunks</summary>
+    private: std::shared_ptr<const ChunkStore> store;
+    /// <summary>Chunks the blob consists of</summary>
+    private: std::vector<ChunkReference> chunks;
+    /// <summary>Position of each chunk in the blob plus the end of the last chunk</summary>
+    private: std::vector<std::uint64_t> chunkOffsets;
+
+    /// <summary>Must be held while accessing the cached chunk</summary>
+    private: mutable std::mutex cacheMutex;
+    /// <summary>Index of the cached chunk, equal to the chunk count if none is cached</summary>
+    private: mutable std::size_t cachedChunkIndex;
+    /// <summary>Uncompressed contents of the cached chunk</summary>
+    private: mutable std::vector<std::uint8_t> cachedChunk;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_CHUNKEDBLOB_H
@@ -22,7 +22,10 @@ License along with this library
 #define NUCLEX_STORAGE_COMPRESSION_COMPRESSIONALGORITHM_H
 
 #include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/Compressor.h"
+#include "Nuclex/Storage/Compression/Decompressor.h"
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <array>
@@ -31,11 +34,6 @@ namespace Nuclex { namespace Storage { namespace Compression {
 
   // ------------------------------------------------------------------------------------------- //
 
-  class Compressor;
-  class Decompressor;
-
-  // ------------------------------------------------------------------------------------------- //
-
   /// <summary>Creates data compressors/decompressors of its implemented type</summary>
   class CompressionAlgorithm {
 
@@ -104,11 +102,15 @@ namespace Nuclex { namespace Storage { namespace Compression {
     /// </remarks>
     public: virtual const std::vector<std::string> &GetSuitableExtensions() const;
 #endif
-/*
+
     /// <summary>Creates a new data compressor</summary>
-    /// <returns>A new data compressor of the specified type</returns>
-    public: virtual std::unique_ptr<Compressor> &&Create() const = 0;
-*/
+    /// <returns>A new data compressor using this algorithm</returns>
+    public: virtual std::unique_ptr<Compressor> CreateCompressor() const = 0;
+
+    /// <summary>Creates a new data decompressor</summary>
+    /// <returns>A new data decompressor for data compressed with this algorithm</returns>
+    public: virtual std::unique_ptr<Decompressor> CreateDecompressor() const = 0;
+
   };
 
   // ------------------------------------------------------------------------------------------- //
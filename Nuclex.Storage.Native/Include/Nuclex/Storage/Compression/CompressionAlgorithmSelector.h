@@ -0,0 +1,203 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_COMPRESSIONALGORITHMSELECTOR_H
+#define NUCLEX_STORAGE_COMPRESSION_COMPRESSIONALGORITHMSELECTOR_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithm.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+#include <array> // for std::array
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Speed and effectiveness of a compression algorithm</summary>
+  struct CompressionMetrics {
+
+    /// <summary>Number of CPU cycles needed to compress one kilobyte of data</summary>
+    public: std::size_t CompressionCyclesPerKilobyte;
+    /// <summary>Size of the compressed data relative to the uncompressed data</summary>
+    public: float CompressionRatio;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the compression algorithm best suited for a speed or size goal</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The metrics reported by compression algorithms are averages from benchmarks on
+  ///     general-purpose data. How well an algorithm does on your data can be very
+  ///     different (already compressed textures won't shrink any further, text shrinks
+  ///     a lot), so the selector can measure all algorithms on a sample of the actual
+  ///     data via <see cref="Calibrate" /> before picking one.
+  ///   </para>
+  ///   <para>
+  ///     Compressed data should be tagged with the <see cref="CompressionAlgorithm.GetId" />
+  ///     of the algorithm that produced it. When reading the data back,
+  ///     <see cref="GetAlgorithm" /> looks the algorithm up again by this ID.
+  ///   </para>
+  /// </remarks>
+  class CompressionAlgorithmSelector {
+
+    /// <summary>Initializes a new compression algorithm selector with no algorithms</summary>
+    public: CompressionAlgorithmSelector() = default;
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: ~CompressionAlgorithmSelector() = default;
+
+    /// <summary>Adds a compression algorithm the selector can choose from</summary>
+    /// <param name="algorithm">Compression algorithm that will be added</param>
+    /// <remarks>
+    ///   Until <see cref="Calibrate" /> is called, the selector goes by the metrics
+    ///   the algorithm reports about itself.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void AddAlgorithm(
+      const std::shared_ptr<const CompressionAlgorithm> &algorithm
+    );
+
+    /// <summary>Adds a selection of the compression algorithms built into the library</summary>
+    /// <remarks>
+    ///   This adds a fast, a balanced and a strong setting of each compression library
+    ///   the storage library has been compiled with (or just one setting if the library
+    ///   has no meaningful levels).
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void AddBuiltInAlgorithms();
+
+    /// <summary>Counts the compression algorithms the selector can choose from</summary>
+    /// <returns>The number of compression algorithms known to the selector</returns>
+    public: std::size_t CountAlgorithms() const {
+      return this->entries.size();
+    }
+
+    /// <summary>Retrieves one of the compression algorithms the selector can choose from</summary>
+    /// <param name="index">Index of the compression algorithm that will be returned</param>
+    /// <returns>The compression algorithm with the specified index</returns>
+    /// <remarks>
+    ///   Algorithms are kept in the order they were added in, so this can be used
+    ///   to enumerate all algorithms together with <see cref="CountAlgorithms" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API const std::shared_ptr<const CompressionAlgorithm> &GetAlgorithm(
+      std::size_t index
+    ) const;
+
+    /// <summary>Measures all compression algorithms on a sample of data</summary>
+    /// <param name="sample">Data that is representative of what will be compressed</param>
+    /// <param name="sampleByteCount">Number of bytes in the sample</param>
+    /// <remarks>
+    ///   Replaces the metrics of all known compression algorithms with the ones measured
+    ///   on the sample. A few hundred kilobytes are usually enough. Algorithms added
+    ///   later go by their reported metrics until the selector is calibrated again.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Calibrate(
+      const std::uint8_t *sample, std::size_t sampleByteCount
+    );
+
+    /// <summary>Looks up the metrics the selector holds for an algorithm</summary>
+    /// <param name="algorithm">Algorithm whose metrics will be looked up</param>
+    /// <returns>The reported or measured metrics of the compression algorithm</returns>
+    public: NUCLEX_STORAGE_API CompressionMetrics GetMetrics(
+      const CompressionAlgorithm &algorithm
+    ) const;
+
+    /// <summary>Selects the fastest algorithm that reaches a compression ratio</summary>
+    /// <param name="maximumCompressionRatio">
+    ///   Largest acceptable size of the compressed data relative to the uncompressed data
+    /// </param>
+    /// <returns>
+    ///   The fastest compression algorithm reaching the ratio or a null pointer if none does
+    /// </returns>
+    public: NUCLEX_STORAGE_API std::shared_ptr<const CompressionAlgorithm> SelectFastest(
+      float maximumCompressionRatio = 1.0f
+    ) const;
+
+    /// <summary>Selects the strongest algorithm that stays within a time budget</summary>
+    /// <param name="maximumCyclesPerKilobyte">
+    ///   Largest acceptable number of CPU cycles spent to compress one kilobyte
+    /// </param>
+    /// <returns>
+    ///   The compression algorithm producing the smallest output within the time budget
+    ///   or a null pointer if all algorithms are slower than that
+    /// </returns>
+    public: NUCLEX_STORAGE_API std::shared_ptr<const CompressionAlgorithm> SelectStrongest(
+      std::size_t maximumCyclesPerKilobyte
+    ) const;
+
+    /// <summary>Looks up a compression algorithm by its unique ID</summary>
+    /// <param name="id">ID of the compression algorithm that will be looked up</param>
+    /// <returns>
+    ///   The first added compression algorithm with a matching ID or a null pointer
+    ///   if no algorithm uses the ID
+    /// </returns>
+    /// <remarks>
+    ///   Several settings of one algorithm (i.e. compression levels) usually share an ID
+    ///   because their output is decompressed the same way. Any of them can be used
+    ///   to decompress data produced by the others.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::shared_ptr<const CompressionAlgorithm> GetAlgorithm(
+      const std::array<std::uint8_t, 8> &id
+    ) const;
+
+    /// <summary>Measures the speed and effectiveness of an algorithm on a sample</summary>
+    /// <param name="algorithm">Compression algorithm that will be measured</param>
+    /// <param name="sample">Data that will be compressed to measure the algorithm</param>
+    /// <param name="sampleByteCount">Number of bytes in the sample</param>
+    /// <returns>The metrics measured for the compression algorithm</returns>
+    /// <remarks>
+    ///   Elapsed time is converted into cycles at a nominal 3 GHz, which is also what
+    ///   the metrics reported by the built-in algorithms are based on, so measured and
+    ///   reported metrics can be compared with each other.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API static CompressionMetrics Measure(
+      const CompressionAlgorithm &algorithm,
+      const std::uint8_t *sample, std::size_t sampleByteCount
+    );
+
+    /// <summary>Compression algorithm together with its reported or measured metrics</summary>
+    private: struct Entry {
+
+      /// <summary>Compression algorithm the metrics are for</summary>
+      public: std::shared_ptr<const CompressionAlgorithm> Algorithm;
+      /// <summary>Reported or measured metrics of the compression algorithm</summary>
+      public: CompressionMetrics Metrics;
+
+    };
+
+    private: CompressionAlgorithmSelector(const CompressionAlgorithmSelector &) = delete;
+    private: CompressionAlgorithmSelector &operator =(
+      const CompressionAlgorithmSelector &
+    ) = delete;
+
+    /// <summary>Compression algorithms the selector can choose from</summary>
+    private: std::vector<Entry> entries;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_COMPRESSIONALGORITHMSELECTOR_H
@@ -0,0 +1,117 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_COMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_COMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/StopReason.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses a stream of data piece by piece</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The compressor works on spans: you hand it as much input as you have and
+  ///     an output buffer of any size, and it consumes input and fills the output
+  ///     buffer until it runs out of either. Both byte counts are updated to tell you
+  ///     how much was consumed and produced, so the caller decides where data comes from
+  ///     and where it goes (streams, blobs, memory-mapped files).
+  ///   </para>
+  ///   <para>
+  ///     When all input has been provided, call <see cref="Finish" /> until it reports
+  ///     <see cref="StopReason.Finished" />. A compressor can then be reused for another,
+  ///     independent stream via <see cref="Reset" />, which keeps its internal memory.
+  ///   </para>
+  /// </remarks>
+  class Compressor {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~Compressor() = default;
+
+    /// <summary>Compresses data from the input buffer into the output buffer</summary>
+    /// <param name="uncompressedBuffer">Buffer holding the data to compress</param>
+    /// <param name="uncompressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the compressor stopped because it needs more input or more output space
+    /// </returns>
+    public: virtual StopReason Process(
+      const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) = 0;
+
+    /// <summary>Writes out all data compressed so far</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   <see cref="StopReason.Finished" /> if everything has been written or
+    ///   <see cref="StopReason.OutputBufferFull" /> if the method needs to be called
+    ///   again with more output space
+    /// </returns>
+    /// <remarks>
+    ///   Lets a receiver decompress everything that has been sent so far without ending
+    ///   the stream. Flushing too often makes the compression worse.
+    /// </remarks>
+    public: virtual StopReason Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) = 0;
+
+    /// <summary>Ends the stream and writes out all remaining compressed data</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   <see cref="StopReason.Finished" /> if the stream has been completed or
+    ///   <see cref="StopReason.OutputBufferFull" /> if the method needs to be called
+    ///   again with more output space
+    /// </returns>
+    public: virtual StopReason Finish(
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) = 0;
+
+    /// <summary>Prepares the compressor for a new, independent stream</summary>
+    /// <remarks>
+    ///   Any data that has not been finished is discarded. Memory the compressor has
+    ///   allocated is kept, so this is much cheaper than creating a new compressor.
+    /// </remarks>
+    public: virtual void Reset() = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_COMPRESSOR_H
@@ -0,0 +1,82 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_DECOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_DECOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/StopReason.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decompresses a stream of data piece by piece</summary>
+  /// <remarks>
+  ///   Works on spans just like the <see cref="Compressor" />. Keep feeding compressed
+  ///   data and providing output space until <see cref="Process" /> reports
+  ///   <see cref="StopReason.Finished" />, which means the end of the compressed data
+  ///   has been reached. Any input that was not consumed at that point belongs to
+  ///   whatever follows the compressed data.
+  /// </remarks>
+  class Decompressor {
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~Decompressor() = default;
+
+    /// <summary>Decompresses data from the input buffer into the output buffer</summary>
+    /// <param name="compressedBuffer">Buffer holding the compressed data</param>
+    /// <param name="compressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the decompressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the decompressor stopped because it needs more input, needs more output
+    ///   space or has reached the end of the compressed data
+    /// </returns>
+    /// <remarks>
+    ///   Corrupted input causes an exception to be thrown.
+    /// </remarks>
+    public: virtual StopReason Process(
+      const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) = 0;
+
+    /// <summary>Prepares the decompressor for a new, independent stream</summary>
+    /// <remarks>
+    ///   Memory the decompressor has allocated is kept, so this is much cheaper than
+    ///   creating a new decompressor.
+    /// </remarks>
+    public: virtual void Reset() = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_DECOMPRESSOR_H
@@ -0,0 +1,198 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_PACKREADER_H
+#define NUCLEX_STORAGE_COMPRESSION_PACKREADER_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <array> // for std::array
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint8_t
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class CompressionAlgorithm;
+  class CompressionAlgorithmSelector;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes an entry in a pack file</summary>
+  struct PackEntry {
+
+    /// <summary>Name under which the entry can be opened</summary>
+    public: std::string Name;
+    /// <summary>Position of the entry's stored contents in the pack</summary>
+    public: std::uint64_t Location;
+    /// <summary>Number of bytes the entry occupies in the pack</summary>
+    public: std::uint64_t StoredByteCount;
+    /// <summary>Number of bytes in the entry's uncompressed contents</summary>
+    public: std::uint64_t ByteCount;
+    /// <summary>ID of the compression algorithm, all zeros if stored uncompressed</summary>
+    public: std::array<std::uint8_t, 8> AlgorithmId;
+    /// <summary>64 bit XXH3 hash of the bytes the entry occupies in the pack</summary>
+    public: std::uint64_t Checksum;
+
+    /// <summary>Checks whether the entry is stored in compressed form</summary>
+    /// <returns>True if the entry has to be decompressed when it is opened</returns>
+    public: bool IsCompressed() const {
+      for(std::size_t index = 0; index < 8; ++index) {
+        if(this->AlgorithmId[index] != 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides access to the entries of a pack file</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A pack file holds many named entries in a single blob, for example the assets
+  ///     of a game, and is created with the <see cref="PackWriter" />. The directory
+  ///     at the end of the pack is sorted by name and is loaded in a single read
+  ///     when the pack is opened. Looking up an entry does not touch the container.
+  ///   </para>
+  ///   <para>
+  ///     Entries that are stored uncompressed are returned as slices of the container,
+  ///     so reading them goes straight to the container and, if it is memory-mapped,
+  ///     their contiguous spans point right into the mapping. Compressed entries are
+  ///     decompressed into memory when they are opened.
+  ///   </para>
+  ///   <para>
+  ///     The directory records a hash of each entry's stored bytes. Compressed entries
+  ///     are checked against it before they are decompressed, which costs little next
+  ///     to the decompression itself. Uncompressed entries are handed out without being
+  ///     read, so they are only checked when <see cref="VerifyEntry" /> is called.
+  ///   </para>
+  ///   <para>
+  ///     Opening entries can be done from multiple threads if the container
+  ///     blob allows that, too.
+  ///   </para>
+  /// </remarks>
+  class PackReader {
+
+    /// <summary>Opens a pack whose entries are all stored uncompressed</summary>
+    /// <param name="container">Blob holding the pack</param>
+    /// <remarks>
+    ///   Entries that were compressed can be listed, but opening them will fail.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API PackReader(const std::shared_ptr<const Blob> &container);
+
+    /// <summary>Opens a pack</summary>
+    /// <param name="container">Blob holding the pack</param>
+    /// <param name="selector">
+    ///   Selector in which the compression algorithms of the entries will be looked up
+    ///   by the IDs stored in the directory
+    /// </param>
+    public: NUCLEX_STORAGE_API PackReader(
+      const std::shared_ptr<const Blob> &container, const CompressionAlgorithmSelector &selector
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API ~PackReader();
+
+    /// <summary>Counts the number of entries in the pack</summary>
+    /// <returns>The number of entries the pack holds</returns>
+    public: std::size_t CountEntries() const { return this->entries.size(); }
+
+    /// <summary>Retrieves an entry of the pack by its index</summary>
+    /// <param name="index">Index of the entry, entries are ordered by their names</param>
+    /// <returns>A description of the entry</returns>
+    public: const PackEntry &GetEntry(std::size_t index) const {
+      return this->entries.at(index);
+    }
+
+    /// <summary>Looks up an entry by its name</summary>
+    /// <param name="name">Name of the entry that will be looked up</param>
+    /// <returns>A description of the entry or a null pointer if there is no such entry</returns>
+    public: NUCLEX_STORAGE_API const PackEntry *FindEntry(const std::string &name) const;
+
+    /// <summary>Checks whether the pack holds an entry with the specified name</summary>
+    /// <param name="name">Name of the entry that will be looked for</param>
+    /// <returns>True if the pack holds an entry with the specified name</returns>
+    public: bool Contains(const std::string &name) const {
+      return (FindEntry(name) != nullptr);
+    }
+
+    /// <summary>Opens an entry by its name</summary>
+    /// <param name="name">Name of the entry that will be opened</param>
+    /// <returns>A read-only blob providing the entry's uncompressed contents</returns>
+    /// <remarks>
+    ///   Throws an exception if the pack does not hold an entry with the specified name.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::shared_ptr<const Blob> OpenEntry(
+      const std::string &name
+    ) const;
+
+    /// <summary>Opens an entry of the pack</summary>
+    /// <param name="entry">Entry of this pack that will be opened</param>
+    /// <returns>A read-only blob providing the entry's uncompressed contents</returns>
+    public: NUCLEX_STORAGE_API std::shared_ptr<const Blob> OpenEntry(
+      const PackEntry &entry
+    ) const;
+
+    /// <summary>Checks whether an entry's stored bytes are intact</summary>
+    /// <param name="entry">Entry of this pack that will be checked</param>
+    /// <returns>True if the entry's stored bytes match the hash in the directory</returns>
+    public: NUCLEX_STORAGE_API bool VerifyEntry(const PackEntry &entry) const;
+
+    /// <summary>Reads the header and the directory of the pack</summary>
+    private: void readDirectory();
+
+    /// <summary>Looks up the compression algorithms used by the entries</summary>
+    /// <param name="selector">Selector in which the algorithms will be looked up</param>
+    private: void resolveAlgorithms(const CompressionAlgorithmSelector &selector);
+
+    private: PackReader(const PackReader &) = delete;
+    private: PackReader &operator =(const PackReader &) = delete;
+
+    /// <summary>Blob holding the pack</summary>
+    private: std::shared_ptr<const Blob> container;
+    /// <summary>Entries of the pack ordered by their names</summary>
+    private: std::vector<PackEntry> entries;
+    /// <summary>Compression algorithms the entries in the pack use</summary>
+    private: std::vector<std::shared_ptr<const CompressionAlgorithm>> algorithms;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_PACKREADER_H
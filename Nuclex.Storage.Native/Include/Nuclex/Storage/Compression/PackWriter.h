@@ -0,0 +1,161 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_PACKWRITER_H
+#define NUCLEX_STORAGE_COMPRESSION_PACKWRITER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/PackReader.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint8_t
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <unordered_set> // for std::unordered_set
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class CompressionAlgorithm;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a pack file holding many named entries</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Entries are appended to the container as they are added, so only one entry
+  ///     at a time needs to be held in memory. Each entry can be compressed with its own
+  ///     algorithm. If compression would not make an entry smaller, it is stored as-is,
+  ///     which lets the <see cref="PackReader" /> hand it out without copying.
+  ///   </para>
+  ///   <para>
+  ///     Entries begin at multiples of the alignment. Choose 4096 if the pack will be
+  ///     memory-mapped and stored entries should start on page boundaries.
+  ///   </para>
+  ///   <para>
+  ///     The directory is written by <see cref="Finish" />. A pack that was not finished
+  ///     can not be opened.
+  ///   </para>
+  /// </remarks>
+  class PackWriter {
+
+    /// <summary>Alignment of the entries if not specified otherwise</summary>
+    public: static const std::size_t DefaultAlignment = 16;
+
+    /// <summary>Starts a new pack in an empty blob</summary>
+    /// <param name="container">Blob the pack will be written into</param>
+    /// <param name="alignment">
+    ///   Number of bytes the position of each entry will be a multiple of,
+    ///   must be a power of two
+    /// </param>
+    public: NUCLEX_STORAGE_API PackWriter(
+      const std::shared_ptr<Blob> &container, std::size_t alignment = DefaultAlignment
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API ~PackWriter();
+
+    /// <summary>Adds an entry that is stored without compression</summary>
+    /// <param name="name">Name under which the entry can be opened</param>
+    /// <param name="data">Contents of the entry</param>
+    /// <param name="byteCount">Number of bytes in the entry</param>
+    public: NUCLEX_STORAGE_API void AddEntry(
+      const std::string &name, const std::uint8_t *data, std::size_t byteCount
+    );
+
+    /// <summary>Adds an entry that is compressed if that makes it smaller</summary>
+    /// <param name="name">Name under which the entry can be opened</param>
+    /// <param name="data">Contents of the entry</param>
+    /// <param name="byteCount">Number of bytes in the entry</param>
+    /// <param name="algorithm">Compression algorithm the entry will be compressed with</param>
+    public: NUCLEX_STORAGE_API void AddEntry(
+      const std::string &name, const std::uint8_t *data, std::size_t byteCount,
+      const CompressionAlgorithm &algorithm
+    );
+
+    /// <summary>Adds an entry holding the contents of a blob</summary>
+    /// <param name="name">Name under which the entry can be opened</param>
+    /// <param name="contents">Blob whose contents will be stored without compression</param>
+    public: NUCLEX_STORAGE_API void AddEntry(const std::string &name, const Blob &contents);
+
+    /// <summary>Adds an entry holding the compressed contents of a blob</summary>
+    /// <param name="name">Name under which the entry can be opened</param>
+    /// <param name="contents">Blob whose contents will be stored</param>
+    /// <param name="algorithm">Compression algorithm the entry will be compressed with</param>
+    public: NUCLEX_STORAGE_API void AddEntry(
+      const std::string &name, const Blob &contents, const CompressionAlgorithm &algorithm
+    );
+
+    /// <summary>Writes the directory and completes the pack</summary>
+    /// <remarks>
+    ///   No more entries can be added afterwards.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Finish();
+
+    /// <summary>Stores the contents of an entry and records it for the directory</summary>
+    /// <param name="name">Name under which the entry can be opened</param>
+    /// <param name="data">Contents of the entry</param>
+    /// <param name="byteCount">Number of bytes in the entry</param>
+    /// <param name="algorithm">
+    ///   Compression algorithm the entry will be compressed with, can be null
+    /// </param>
+    private: void addEntry(
+      const std::string &name, const std::uint8_t *data, std::size_t byteCount,
+      const CompressionAlgorithm *algorithm
+    );
+
+    /// <summary>Adds zero bytes until the end of the pack is aligned</summary>
+    private: void pad();
+
+    private: PackWriter(const PackWriter &) = delete;
+    private: PackWriter &operator =(const PackWriter &) = delete;
+
+    /// <summary>Blob the pack is written into</summary>
+    private: std::shared_ptr<Blob> container;
+    /// <summary>Number of bytes the position of each entry is a multiple of</summary>
+    private: std::size_t alignment;
+    /// <summary>Entries that have been added to the pack so far</summary>
+    private: std::vector<PackEntry> entries;
+    /// <summary>Names of the entries, used to reject duplicate names</summary>
+    private: std::unordered_set<std::string> names;
+    /// <summary>Position in the container at which the next entry will be stored</summary>
+    private: std::uint64_t endLocation;
+    /// <summary>Whether the directory has been written already</summary>
+    private: bool isFinished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_PACKWRITER_H
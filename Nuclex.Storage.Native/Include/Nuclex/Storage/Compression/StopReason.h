@@ -0,0 +1,53 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_STOPREASON_H
+#define NUCLEX_STORAGE_COMPRESSION_STOPREASON_H
+
+#include "Nuclex/Storage/Config.h"
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reasons why a compressor or decompressor has stopped processing</summary>
+  enum class StopReason {
+
+    /// <summary>All input has been consumed, more input is needed to continue</summary>
+    InputBufferExhausted,
+
+    /// <summary>The output buffer is full, more output space is needed to continue</summary>
+    OutputBufferFull,
+
+    /// <summary>The requested operation has completed</summary>
+    /// <remarks>
+    ///   For a decompressor, this means the end of the compressed data has been reached.
+    ///   For a compressor's Flush() or Finish() methods, it means all pending output has
+    ///   been written to the output buffer.
+    /// </remarks>
+    Finished
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_STOPREASON_H
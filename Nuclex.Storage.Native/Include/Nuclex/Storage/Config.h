@@ -60,6 +60,25 @@ License along with this library
 
 // --------------------------------------------------------------------------------------------- //
 
+// SIMD instruction sets the compiler has been allowed to generate code for
+#if defined(__SSE4_2__) || defined(__AVX__)
+  #define NUCLEX_STORAGE_HAVE_SSE42 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+  #define NUCLEX_STORAGE_HAVE_SSSE3 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+  #define NUCLEX_STORAGE_HAVE_SSE2 1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM) || defined(_M_ARM64)
+  #define NUCLEX_STORAGE_HAVE_NEON 1
+#endif
+#if defined(__ARM_FEATURE_CRC32)
+  #define NUCLEX_STORAGE_HAVE_ARM_CRC32 1
+#endif
+
+// --------------------------------------------------------------------------------------------- //
+
 // Decides whether symbols are imported from a dll (client app) or exported to
 // a dll (Nuclex.Storage.Native library). The NUCLEX_STORAGE_SOURCE symbol is defined by
 // all source files of the library, so you don't have to worry about a thing.
@@ -0,0 +1,264 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_FIELDLIST_H
+#define NUCLEX_STORAGE_FIELDLIST_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a serializable field of a structure</summary>
+  /// <typeparam name="TOwner">Structure the field is a member of</typeparam>
+  /// <typeparam name="TValue">Type of value stored in the field</typeparam>
+  template<typename TOwner, typename TValue>
+  struct Field {
+
+    /// <summary>Structure the field is a member of</summary>
+    typedef TOwner OwnerType;
+    /// <summary>Type of value stored in the field</summary>
+    typedef TValue ValueType;
+
+    /// <summary>Name under which the field is stored in text-based formats</summary>
+    const char *Name;
+    /// <summary>Pointer to the member variable that holds the field's value</summary>
+    TValue TOwner::*Member;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Describes a serializable field of a structure</summary>
+  /// <typeparam name="TOwner">Structure the field is a member of</typeparam>
+  /// <typeparam name="TValue">Type of value stored in the field</typeparam>
+  /// <param name="name">Name under which the field is stored in text-based formats</param>
+  /// <param name="member">Pointer to the member variable that holds the field's value</param>
+  /// <returns>A description of the field</returns>
+  template<typename TOwner, typename TValue>
+  constexpr Field<TOwner, TValue> MakeField(const char *name, TValue TOwner::*member) {
+    return Field<TOwner, TValue> { name, member };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+/// <summary>Describes a member variable of a structure as a serializable field</summary>
+/// <param name="owner">Structure the member variable belongs to</param>
+/// <param name="member">Member variable that will be described</param>
+/// <remarks>
+///   <para>
+///     Structures become serializable by providing a static GetFields() method that
+///     returns a tuple of their fields. The Serialize() overloads for binary readers
+///     and writers as well as the XML element serializers pick it up automatically:
+///   </para>
+///   <code>
+///     struct Vertex {
+///       float Position[3];
+///       std::uint32_t Color;
+///
+///       static constexpr auto GetFields() {
+///         return std::make_tuple(
+///           NUCLEX_STORAGE_FIELD(Vertex, Position),
+///           NUCLEX_STORAGE_FIELD(Vertex, Color)
+///         );
+///       }
+///     };
+///   </code>
+///   <para>
+///     The order of the fields in the tuple is the order in which they are stored.
+///     Everything happens at compile time, no registry or type information is needed.
+///   </para>
+/// </remarks>
+#define NUCLEX_STORAGE_FIELD(owner, member) \
+  ::Nuclex::Storage::MakeField(#member, &owner::member)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Whether a type describes its fields through a static GetFields() method</summary>
+  /// <typeparam name="TValue">Type that will be checked</typeparam>
+  template<typename TValue, typename TEnable = void>
+  struct HasFieldList : std::false_type {};
+
+  /// <summary>Whether a type describes its fields through a static GetFields() method</summary>
+  /// <typeparam name="TValue">Type that will be checked</typeparam>
+  template<typename TValue>
+  struct HasFieldList<TValue, decltype(static_cast<void>(TValue::GetFields()))> :
+    std::true_type {};
+
+  // ------------------------------------------------------------------------------------------- //
+
+  namespace Private {
+
+    /// <summary>Invokes a visitor on each field in a tuple of fields</summary>
+    /// <typeparam name="TFields">Tuple holding the fields</typeparam>
+    /// <typeparam name="TVisitor">Visitor that will be invoked on each field</typeparam>
+    /// <typeparam name="TIndices">Indices of the fields in the tuple</typeparam>
+    /// <param name="fields">Fields the visitor will be invoked on</param>
+    /// <param name="visitor">Visitor that will be invoked on each field</param>
+    template<typename TFields, typename TVisitor, std::size_t... TIndices>
+    inline void forEachField(
+      const TFields &fields, TVisitor &visitor, std::index_sequence<TIndices...>
+    ) {
+      int expander[] = { 0, (visitor(std::get<TIndices>(fields)), 0)... };
+      (void)expander;
+    }
+
+    /// <summary>Sums up the properties of the fields in a field list</summary>
+    /// <typeparam name="TFields">Fields whose properties will be summed up</typeparam>
+    template<typename... TFields>
+    struct FieldListTraits;
+
+    /// <summary>Properties of an empty field list</summary>
+    template<>
+    struct FieldListTraits<> {
+
+      /// <summary>Whether all fields hold plain numbers or arrays of them</summary>
+      static const bool AllNumeric = true;
+      /// <summary>Total number of bytes occupied by the fields</summary>
+      static const std::size_t ByteCount = 0;
+
+    };
+
+    /// <summary>Properties of a field list</summary>
+    /// <typeparam name="TOwner">Structure the fields are members of</typeparam>
+    /// <typeparam name="TValue">Type of value stored in the first field</typeparam>
+    /// <typeparam name="TFields">Remaining fields in the field list</typeparam>
+    template<typename TOwner, typename TValue, typename... TFields>
+    struct FieldListTraits<Field<TOwner, TValue>, TFields...> {
+
+      /// <summary>Whether all fields hold plain numbers or arrays of them</summary>
+      static const bool AllNumeric = (
+        std::is_arithmetic<typename std::remove_all_extents<TValue>::type>::value &&
+        !std::is_same<typename std::remove_all_extents<TValue>::type, bool>::value &&
+        FieldListTraits<TFields...>::AllNumeric
+      );
+      /// <summary>Total number of bytes occupied by the fields</summary>
+      static const std::size_t ByteCount = (
+        sizeof(TValue) + FieldListTraits<TFields...>::ByteCount
+      );
+
+    };
+
+    /// <summary>Looks up the properties of the fields in a tuple of fields</summary>
+    /// <typeparam name="TFields">Tuple of fields whose properties will be looked up</typeparam>
+    template<typename TFields>
+    struct FieldTupleTraits;
+
+    /// <summary>Looks up the properties of the fields in a tuple of fields</summary>
+    /// <typeparam name="TFields">Fields whose properties will be looked up</typeparam>
+    template<typename... TFields>
+    struct FieldTupleTraits<std::tuple<TFields...>> : FieldListTraits<TFields...> {};
+
+  } // namespace Private
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Invokes a visitor on each field in a field list</summary>
+  /// <typeparam name="TFields">Types of the fields in the field list</typeparam>
+  /// <typeparam name="TVisitor">Visitor that will be invoked on each field</typeparam>
+  /// <param name="fields">Field list as returned by a structure's GetFields() method</param>
+  /// <param name="visitor">Visitor that will be invoked on each field in order</param>
+  template<typename... TFields, typename TVisitor>
+  inline void ForEachField(const std::tuple<TFields...> &fields, TVisitor &&visitor) {
+    Private::forEachField(fields, visitor, std::index_sequence_for<TFields...>());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Whether a structure consists of nothing but its fields, packed tightly</summary>
+  /// <typeparam name="TValue">Type that will be checked</typeparam>
+  /// <remarks>
+  ///   Structures that have only numeric fields, no padding and no hidden members can
+  ///   be copied as a whole instead of field-by-field. Whether the fields are declared in
+  ///   the same order as they appear in the field list can only be checked at runtime,
+  ///   see <see cref="HasFieldsInMemoryOrder" />.
+  /// </remarks>
+  template<typename TValue, typename TEnable = void>
+  struct IsPackedFieldList : std::false_type {};
+
+  /// <summary>Whether a structure consists of nothing but its fields, packed tightly</summary>
+  /// <typeparam name="TValue">Type that will be checked</typeparam>
+  template<typename TValue>
+  struct IsPackedFieldList<
+    TValue, typename std::enable_if<HasFieldList<TValue>::value>::type
+  > : std::integral_constant<
+    bool,
+    std::is_standard_layout<TValue>::value &&
+    std::is_trivially_copyable<TValue>::value &&
+    Private::FieldTupleTraits<
+      typename std::decay<decltype(TValue::GetFields())>::type
+    >::AllNumeric &&
+    (
+      Private::FieldTupleTraits<
+        typename std::decay<decltype(TValue::GetFields())>::type
+      >::ByteCount == sizeof(TValue)
+    )
+  > {};
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the field list of a structure matches its memory layout</summary>
+  /// <typeparam name="TValue">Structure whose field list will be checked</typeparam>
+  /// <returns>True if each field follows the previous one directly in memory</returns>
+  /// <remarks>
+  ///   Only meaningful for types for which <see cref="IsPackedFieldList" /> is true.
+  ///   Offsets of member pointers are not available at compile time, so the check is
+  ///   done on the first call and its result remembered for all later calls.
+  /// </remarks>
+  template<typename TValue>
+  inline bool HasFieldsInMemoryOrder() {
+    static const bool inMemoryOrder = []() {
+      typename std::aligned_storage<sizeof(TValue), alignof(TValue)>::type storage;
+      const std::uint8_t *start = reinterpret_cast<const std::uint8_t *>(&storage);
+      const TValue &instance = *reinterpret_cast<const TValue *>(&storage);
+
+      bool isInOrder = true;
+      std::size_t expectedOffset = 0;
+      ForEachField(
+        TValue::GetFields(),
+        [&](const auto &field) {
+          const std::uint8_t *address = reinterpret_cast<const std::uint8_t *>(
+            &(instance.*(field.Member))
+          );
+          if(address != start + expectedOffset) {
+            isInOrder = false;
+          }
+          expectedOffset += sizeof(instance.*(field.Member));
+        }
+      );
+
+      return isInOrder;
+    }();
+
+    return inMemoryOrder;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_FIELDLIST_H
@@ -0,0 +1,178 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_FILEBLOB_H
+#define NUCLEX_STORAGE_FILEBLOB_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Blob accessing a file through positioned reads and writes</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each read and write goes straight to the operating system as a positioned
+  ///     read or write (pread() and pwrite() on Posix systems, ReadFile() and WriteFile()
+  ///     with an offset on Windows). There is no shared file cursor, so any number of
+  ///     threads can read from and write to the blob at the same time without locking.
+  ///     Put a <see cref="Binary.BinaryBlobReader" /> or writer in front of the blob if
+  ///     you're going to access it in small pieces.
+  ///   </para>
+  ///   <para>
+  ///     In unbuffered mode, the file is additionally opened with O_DIRECT (or
+  ///     FILE_FLAG_NO_BUFFERING on Windows) and all whole, aligned blocks of a large
+  ///     read or write bypass the OS' page cache. This is meant for streaming huge
+  ///     amounts of data that will not be looked at again soon. Buffers aligned to
+  ///     <see cref="DirectAccessAlignment" /> are transferred directly, other buffers
+  ///     are copied through an aligned intermediate buffer. The unaligned start and
+  ///     end of a request still go through the page cache. If the file system does
+  ///     not support unbuffered access, the blob quietly falls back to buffered access.
+  ///   </para>
+  ///   <para>
+  ///     Writing past the end of the file grows it. Unlike the <see cref="MemoryBlob" />,
+  ///     any gap between the old end of the file and the write location is filled
+  ///     with zeros.
+  ///   </para>
+  ///   <para>
+  ///     Asynchronous reads and writes are handed to an io_uring on Linux and issued as
+  ///     overlapped I/O on Windows, so many of them can be in flight at once. They always
+  ///     go through the page cache. Where the kernel doesn't offer either, they are carried
+  ///     out synchronously like on any other blob.
+  ///   </para>
+  /// </remarks>
+  class FileBlob : public Blob {
+
+    /// <summary>Alignment of offsets, sizes and buffers for unbuffered transfers</summary>
+    public: static const std::size_t DirectAccessAlignment = 4096;
+
+    /// <summary>Opens the specified file</summary>
+    /// <param name="path">Path of the file that will be opened</param>
+    /// <param name="writable">
+    ///   Whether the file can be written to. If set, the file will be created if it
+    ///   doesn't exist yet.
+    /// </param>
+    /// <param name="unbuffered">
+    ///   Whether large reads and writes should bypass the operating system's page cache
+    /// </param>
+    public: NUCLEX_STORAGE_API FileBlob(
+      const std::string &path, bool writable = false, bool unbuffered = false
+    );
+
+    /// <summary>Closes the file and frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~FileBlob() override;
+
+    /// <summary>Checks whether the file can be written to</summary>
+    /// <returns>True if the file has been opened for writing</returns>
+    public: NUCLEX_STORAGE_API bool IsWritable() const;
+
+    /// <summary>Checks whether large transfers bypass the page cache</summary>
+    /// <returns>
+    ///   True if unbuffered mode was requested and is supported by the file system
+    /// </returns>
+    public: NUCLEX_STORAGE_API bool IsUnbuffered() const;
+
+    /// <summary>Determines the size of the binary data in bytes</summary>
+    /// <returns>The size of the binary data in bytes</returns>
+    public: NUCLEX_STORAGE_API virtual std::uint64_t GetSize() const override;
+
+    /// <summary>Reads raw data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadAt(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Writes raw data into the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    public: NUCLEX_STORAGE_API virtual void WriteAt(
+      std::uint64_t location, const void *buffer, std::size_t count
+    ) override;
+
+    /// <summary>Begins reading raw data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    /// <returns>
+    ///   A future that completes when the data has been read or carries the exception
+    ///   that occurred while reading
+    /// </returns>
+    public: NUCLEX_STORAGE_API virtual std::future<void> ReadAtAsync(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Begins several reads of raw data from the blob at once</summary>
+    /// <param name="requests">Reads that will be carried out</param>
+    /// <param name="requestCount">Number of reads in the request array</param>
+    /// <returns>One future for each read, in the same order as the requests</returns>
+    public: NUCLEX_STORAGE_API virtual std::vector<std::future<void>> ReadAtAsync(
+      const BlobReadRequest *requests, std::size_t requestCount
+    ) const override;
+
+    /// <summary>Begins writing raw data into the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    /// <returns>
+    ///   A future that completes when the data has been written or carries the exception
+    ///   that occurred while writing
+    /// </returns>
+    public: NUCLEX_STORAGE_API virtual std::future<void> WriteAtAsync(
+      std::uint64_t location, const void *buffer, std::size_t count
+    ) override;
+
+    /// <summary>Cuts off or extends the file to the specified size</summary>
+    /// <param name="newSize">New size the file will have in bytes</param>
+    /// <remarks>
+    ///   If the file is extended, the new bytes will be zeros. Must not be called while
+    ///   asynchronous reads or writes are in progress.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Truncate(std::uint64_t newSize);
+
+    /// <summary>Waits until all data written to the file has reached the disk</summary>
+    public: NUCLEX_STORAGE_API virtual void Flush() override;
+
+    private: FileBlob(const FileBlob &) = delete;
+    private: FileBlob &operator =(const FileBlob &) = delete;
+
+    /// <summary>Structure holding the OS handles of the file</summary>
+    private: struct Impl;
+
+    /// <summary>OS handles of the file</summary>
+    private: std::unique_ptr<Impl> impl;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_FILEBLOB_H
@@ -0,0 +1,163 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_LOGFILEBLOB_H
+#define NUCLEX_STORAGE_LOGFILEBLOB_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include <chrono> // for std::chrono::milliseconds
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <memory> // for std::unique_ptr
+#include <string> // for std::string
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Append-only file blob that many threads can write to at once</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Meant for logs, journals and telemetry where many threads produce small records
+  ///     that have to end up on disk durably. Each append reserves its range of the file
+  ///     with a single atomic addition and copies the data into one of a few shared
+  ///     buffers, so appending threads neither take a lock nor wait for the disk.
+  ///   </para>
+  ///   <para>
+  ///     A background thread writes the buffers to the file as they fill up and flushes
+  ///     the file to disk (fdatasync() on Linux). The appends of all threads that arrived
+  ///     in the meantime reach the disk with that one flush, which is called group commit
+  ///     and is much cheaper than flushing the file after each append. Data is written
+  ///     when a buffer is full, when the flush interval has passed or when a thread waits
+  ///     for its data to become durable, whichever comes first.
+  ///   </para>
+  ///   <para>
+  ///     <see cref="Append" /> returns a durability ticket. A thread that needs to know
+  ///     its record is safe, for example before acknowledging it to a client, passes
+  ///     the ticket to <see cref="WaitUntilDurable" />. Threads that don't care simply
+  ///     discard it. If the background thread fails to write, the error is reported by
+  ///     the next call waiting for durability and all following appends.
+  ///   </para>
+  ///   <para>
+  ///     The blob appends to the end of an existing file. Writes are only accepted at
+  ///     the end of the blob. Data can be read back while appends are going on, reads
+  ///     of data that hasn't been written to the file yet wait until it has been.
+  ///     All appends have to be complete when the blob is destroyed.
+  ///   </para>
+  /// </remarks>
+  class LogFileBlob : public Blob {
+
+    /// <summary>Size of the shared buffers if not specified otherwise</summary>
+    public: static const std::size_t DefaultBufferByteCount = 1024 * 1024;
+
+    /// <summary>Number of shared buffers if not specified otherwise</summary>
+    public: static const std::size_t DefaultBufferCount = 4;
+
+    /// <summary>Opens the specified file for appending</summary>
+    /// <param name="path">Path of the file, will be created if it doesn't exist yet</param>
+    /// <param name="bufferByteCount">Size of each of the shared buffers</param>
+    /// <param name="bufferCount">
+    ///   Number of shared buffers, at least two so one can be filled while
+    ///   the other is being written
+    /// </param>
+    /// <param name="flushInterval">
+    ///   Time after which appended data is written and flushed even if nobody waits for it
+    /// </param>
+    public: NUCLEX_STORAGE_API LogFileBlob(
+      const std::string &path,
+      std::size_t bufferByteCount = DefaultBufferByteCount,
+      std::size_t bufferCount = DefaultBufferCount,
+      std::chrono::milliseconds flushInterval = std::chrono::milliseconds(10)
+    );
+
+    /// <summary>Writes any remaining data and closes the file</summary>
+    public: NUCLEX_STORAGE_API virtual ~LogFileBlob() override;
+
+    /// <summary>Appends data to the end of the blob</summary>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be appended</param>
+    /// <returns>
+    ///   A ticket that can be passed to <see cref="WaitUntilDurable" />. It is the position
+    ///   at which the appended data ends, so the data begins at the ticket minus the count.
+    /// </returns>
+    /// <remarks>
+    ///   Can be called from any number of threads at once. The data is copied into
+    ///   the shared buffers, so the caller's buffer can be reused immediately.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::uint64_t Append(const void *buffer, std::size_t count);
+
+    /// <summary>Checks whether the data of an append has reached the disk</summary>
+    /// <param name="ticket">Ticket that was returned by the append</param>
+    /// <returns>True if the data of the append and everything before it is durable</returns>
+    public: NUCLEX_STORAGE_API bool IsDurable(std::uint64_t ticket) const;
+
+    /// <summary>Waits until the data of an append has reached the disk</summary>
+    /// <param name="ticket">Ticket that was returned by the append</param>
+    /// <remarks>
+    ///   Throws the error that occurred if the data could not be written or flushed.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void WaitUntilDurable(std::uint64_t ticket);
+
+    /// <summary>Determines the size of the binary data in bytes</summary>
+    /// <returns>The size of the binary data in bytes, including data not yet written</returns>
+    public: NUCLEX_STORAGE_API virtual std::uint64_t GetSize() const override;
+
+    /// <summary>Reads raw data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadAt(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Writes raw data to the end of the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    /// <remarks>
+    ///   Throws an exception unless the location is the current end of the blob.
+    ///   This allows writers like the <see cref="Binary.BinaryBlobWriter" /> to be used
+    ///   from a single thread, concurrent writers should call <see cref="Append" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual void WriteAt(
+      std::uint64_t location, const void *buffer, std::size_t count
+    ) override;
+
+    /// <summary>Waits until all data appended so far has reached the disk</summary>
+    public: NUCLEX_STORAGE_API virtual void Flush() override;
+
+    private: LogFileBlob(const LogFileBlob &) = delete;
+    private: LogFileBlob &operator =(const LogFileBlob &) = delete;
+
+    /// <summary>Structure holding the buffers and the background thread</summary>
+    private: struct Impl;
+
+    /// <summary>Buffers, file and background thread of the blob</summary>
+    private: std::unique_ptr<Impl> impl;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_LOGFILEBLOB_H
@@ -0,0 +1,123 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_MAPPEDFILEBLOB_H
+#define NUCLEX_STORAGE_MAPPEDFILEBLOB_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Blob accessing a file that has been mapped into memory</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Instead of reading the file through system calls, the whole file is mapped into
+  ///     the address space of the process and paged in by the OS as it is accessed. This
+  ///     lets you read from data packs that are several gigabytes large without loading
+  ///     them into memory first. Readers can access the file's contents without copying
+  ///     them through <see cref="TryGetContiguousSpan" />.
+  ///   </para>
+  ///   <para>
+  ///     A read-only file blob can be read from any number of threads at once without
+  ///     locking. Writable file blobs sequentialize all accesses with a mutex and grow
+  ///     the file when data is written to its end. Growing the file may move the mapping
+  ///     to a different address, so memory obtained through TryGetContiguousSpan() is
+  ///     only valid until the next write.
+  ///   </para>
+  /// </remarks>
+  class MappedFileBlob : public Blob {
+
+    /// <summary>Maps the specified file into memory</summary>
+    /// <param name="path">Path of the file that will be mapped</param>
+    /// <param name="writable">
+    ///   Whether the file can be written to. If set, the file will be created if it
+    ///   doesn't exist yet.
+    /// </param>
+    public: NUCLEX_STORAGE_API MappedFileBlob(const std::string &path, bool writable = false);
+
+    /// <summary>Unmaps the file and frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~MappedFileBlob() override;
+
+    /// <summary>Checks whether the file can be written to</summary>
+    /// <returns>True if the file has been opened for writing</returns>
+    public: NUCLEX_STORAGE_API bool IsWritable() const;
+
+    /// <summary>Determines the size of the binary data in bytes</summary>
+    /// <returns>The size of the binary data in bytes</returns>
+    public: NUCLEX_STORAGE_API virtual std::uint64_t GetSize() const override;
+
+    /// <summary>Reads raw data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadAt(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Writes raw data into the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    /// <remarks>
+    ///   The start location can be equal to the current size of the blob (but not more),
+    ///   which appends data to the end of the file.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual void WriteAt(
+      std::uint64_t location, const void *buffer, std::size_t count
+    ) override;
+
+    /// <summary>Writes any modified pages of the file back to the disk</summary>
+    public: NUCLEX_STORAGE_API virtual void Flush() override;
+
+    /// <summary>Provides direct access to a range of the file's contents</summary>
+    /// <param name="location">Absolute position at which the range begins</param>
+    /// <param name="count">Number of bytes the range should cover</param>
+    /// <returns>
+    ///   The address of the first byte in the range or null if the range extends beyond
+    ///   the end of the file
+    /// </returns>
+    public: NUCLEX_STORAGE_API virtual const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t location, std::size_t count
+    ) const override;
+
+    private: MappedFileBlob(const MappedFileBlob &) = delete;
+    private: MappedFileBlob &operator =(const MappedFileBlob &) = delete;
+
+    /// <summary>Structure holding the OS handles and the mapping of the file</summary>
+    private: struct Impl;
+
+    /// <summary>OS handles and mapping of the file</summary>
+    private: std::unique_ptr<Impl> impl;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_MAPPEDFILEBLOB_H
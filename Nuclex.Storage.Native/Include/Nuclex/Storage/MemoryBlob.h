@@ -24,6 +24,8 @@ License along with this library
 #include "Nuclex/Storage/Config.h"
 #include "Nuclex/Storage/Blob.h"
 
+#include <atomic>
+#include <cstddef>
 #include <vector>
 #include <mutex>
 
@@ -32,10 +34,24 @@ namespace Nuclex { namespace Storage {
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Chunk of arbitrary data stored completely in system memory</summary>
+  /// <remarks>
+  ///   <para>
+  ///     All accesses to the blob are sequentialized with a mutex while it can still be
+  ///     written to. Once a blob has been filled, it can be sealed via <see cref="Seal" />,
+  ///     after which it is read-only and any number of threads can read from it at
+  ///     the same time without taking the mutex or directly access its memory through
+  ///     <see cref="TryGetContiguousSpan" />.
+  ///   </para>
+  ///   <para>
+  ///     If you know how large the blob will become, <see cref="Reserve" /> allocates
+  ///     the memory up front so the blob doesn't have to grow repeatedly while writing.
+  ///   </para>
+  /// </remarks>
   class MemoryBlob : public Blob {
 
     /// <summary>Initializes a new in-memory blob</summary>
-    public: NUCLEX_STORAGE_API MemoryBlob() = default;
+    public: NUCLEX_STORAGE_API MemoryBlob() :
+      sealed(false) {}
 
     /// <summary>Frees all resources owned by the instance</summary>
     public: NUCLEX_STORAGE_API virtual ~MemoryBlob() override = default;
@@ -43,6 +59,10 @@ namespace Nuclex { namespace Storage {
     /// <summary>Determines the size of the binary data in bytes</summary>
     /// <returns>The size of the binary data in bytes</returns>
     public: NUCLEX_STORAGE_API virtual std::uint64_t GetSize() const override {
+      if(this->sealed.load(std::memory_order_acquire)) {
+        return this->memory.size();
+      }
+
       std::lock_guard<std::mutex> scope(this->mutex);
       return this->memory.size();
     }
@@ -66,10 +86,49 @@ namespace Nuclex { namespace Storage {
     /// <summary>Flushes all caches that may be chained to the blob</summary>
     public: NUCLEX_STORAGE_API virtual void Flush() override {}
 
+    /// <summary>Tries to provide direct access to a range of the blob's contents</summary>
+    /// <param name="location">Absolute position at which the range begins</param>
+    /// <param name="count">Number of bytes the range should cover</param>
+    /// <returns>
+    ///   The address of the first byte in the range or null if the blob has not been
+    ///   sealed or the range extends beyond the end of the blob
+    /// </returns>
+    /// <remarks>
+    ///   Only sealed blobs hand out their memory because writes to an unsealed blob
+    ///   may move its contents to a different memory block at any time.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual const std::uint8_t *TryGetContiguousSpan(
+      std::uint64_t location, std::size_t count
+    ) const override;
+
+    /// <summary>Allocates memory for the blob to grow to the specified size</summary>
+    /// <param name="byteCount">Number of bytes the blob should be able to hold</param>
+    /// <remarks>
+    ///   Does not change the size of the blob. Writes that stay within the reserved
+    ///   memory will not have to move the blob's contents to a larger memory block.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Reserve(std::size_t byteCount);
+
+    /// <summary>Turns the blob read-only so it can be read without locking</summary>
+    /// <remarks>
+    ///   Sealing can not be undone. Any attempt to write to a sealed blob or to reserve
+    ///   memory for it will result in an exception. Reads from a sealed blob no longer
+    ///   take the mutex, so many threads can read from it concurrently.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Seal();
+
+    /// <summary>Checks whether the blob has been sealed</summary>
+    /// <returns>True if the blob is read-only and can be read without locking</returns>
+    public: bool IsSealed() const {
+      return this->sealed.load(std::memory_order_acquire);
+    }
+
     /// <summary>Stores the data of the in-memory blob</summary>
     private: std::vector<std::uint8_t> memory;
     /// <summary>Mutex used to sequentialize accesses to the blob</summary>
     private: mutable std::mutex mutex;
+    /// <summary>Whether the blob has been sealed and became read-only</summary>
+    private: std::atomic<bool> sealed;
 
   };
 
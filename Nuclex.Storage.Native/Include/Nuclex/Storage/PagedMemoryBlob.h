@@ -0,0 +1,144 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_PAGEDMEMORYBLOB_H
+#define NUCLEX_STORAGE_PAGEDMEMORYBLOB_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include <cstddef> // for std::size_t
+#include <memory> // for std::shared_ptr
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>In-memory blob split into pages that are shared between snapshots</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The blob's contents are kept in fixed-size pages. <see cref="Snapshot" /> creates
+  ///     a new blob that shares all pages with the original, which only copies one
+  ///     pointer per page. When either blob is written to afterwards, it duplicates
+  ///     the pages it touches that are still shared, so snapshots of a large blob are
+  ///     cheap to take and each snapshot only costs memory for the pages that changed.
+  ///   </para>
+  ///   <para>
+  ///     This makes the blob a good fit for undo histories and autosaves of large
+  ///     documents. If no snapshots are needed, <see cref="MemoryBlob" /> is simpler
+  ///     and can hand out its memory directly once sealed.
+  ///   </para>
+  ///   <para>
+  ///     Accesses to each blob are sequentialized with a mutex. A blob and its snapshots
+  ///     are independent of each other and can be used from different threads.
+  ///   </para>
+  /// </remarks>
+  class PagedMemoryBlob : public Blob {
+
+    /// <summary>Size of the pages blobs use if no page size is specified</summary>
+    public: static const std::size_t DefaultPageSize = 65536;
+
+    /// <summary>Initializes a new paged in-memory blob</summary>
+    /// <param name="pageSize">Number of bytes stored in each page</param>
+    public: NUCLEX_STORAGE_API explicit PagedMemoryBlob(
+      std::size_t pageSize = DefaultPageSize
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: NUCLEX_STORAGE_API virtual ~PagedMemoryBlob() override = default;
+
+    /// <summary>Determines the size of the binary data in bytes</summary>
+    /// <returns>The size of the binary data in bytes</returns>
+    public: NUCLEX_STORAGE_API virtual std::uint64_t GetSize() const override;
+
+    /// <summary>Reads raw data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: NUCLEX_STORAGE_API virtual void ReadAt(
+      std::uint64_t location, void *buffer, std::size_t count
+    ) const override;
+
+    /// <summary>Writes raw data into the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    /// <remarks>
+    ///   Pages touched by the write that are shared with a snapshot are duplicated
+    ///   before they are modified, so the snapshot keeps its contents.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual void WriteAt(
+      std::uint64_t location, const void *buffer, std::size_t count
+    ) override;
+
+    /// <summary>Flushes all caches that may be chained to the blob</summary>
+    public: NUCLEX_STORAGE_API virtual void Flush() override {}
+
+    /// <summary>Creates a blob sharing all pages with this blob</summary>
+    /// <returns>A new blob holding the same data as this blob does now</returns>
+    /// <remarks>
+    ///   Takes time proportional to the number of pages, not to the size of the data.
+    ///   The snapshot can be read and written like any other blob without affecting
+    ///   this blob and vice versa.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::shared_ptr<PagedMemoryBlob> Snapshot() const;
+
+    /// <summary>Retrieves the number of bytes stored in each page</summary>
+    /// <returns>The size of the blob's pages in bytes</returns>
+    public: std::size_t GetPageSize() const { return this->pageSize; }
+
+    /// <summary>Counts the pages holding the blob's contents</summary>
+    /// <returns>The number of pages the blob is using</returns>
+    public: NUCLEX_STORAGE_API std::size_t CountPages() const;
+
+    /// <summary>Counts the pages this blob shares with snapshots</summary>
+    /// <returns>The number of pages also used by other blobs</returns>
+    /// <remarks>
+    ///   Only the pages not shared with other blobs occupy memory of their own, so this
+    ///   tells how much memory a snapshot really costs.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::size_t CountSharedPages() const;
+
+    /// <summary>Fixed-size block of memory that can be shared between blobs</summary>
+    private: typedef std::shared_ptr<std::uint8_t> PagePointer;
+
+    /// <summary>Makes sure the page is not shared and can be modified</summary>
+    /// <param name="pageIndex">Index of the page that will be modified</param>
+    /// <returns>The address of the page's first byte</returns>
+    private: std::uint8_t *getWritablePage(std::size_t pageIndex);
+
+    /// <summary>Number of bytes stored in each page</summary>
+    private: std::size_t pageSize;
+    /// <summary>Number of bytes stored in the blob</summary>
+    private: std::uint64_t size;
+    /// <summary>Pages holding the blob's contents, possibly shared with snapshots</summary>
+    private: std::vector<PagePointer> pages;
+    /// <summary>Mutex used to sequentialize accesses to the blob</summary>
+    private: mutable std::mutex mutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_PAGEDMEMORYBLOB_H
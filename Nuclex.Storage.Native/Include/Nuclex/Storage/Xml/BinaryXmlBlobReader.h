@@ -0,0 +1,296 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_BINARYXMLBLOBREADER_H
+#define NUCLEX_STORAGE_XML_BINARYXMLBLOBREADER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Xml/XmlReader.h"
+#include "Nuclex/Storage/Binary/BinaryBlobReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads XML documents stored in the compact binary form</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Reads the documents written by the <see cref="BinaryXmlBlobWriter" /> and reports
+  ///     the same events an <see cref="XmlBlobReader" /> would report for the text form
+  ///     of the document, so code loading XML files works with either.
+  ///   </para>
+  ///   <para>
+  ///     Values keep the type they were written with. Reading a value as another type
+  ///     converts it the way text XML would, so a number written as integer can be read
+  ///     as string and vice versa. Binary data can not be read as number, though.
+  ///   </para>
+  /// </remarks>
+  class BinaryXmlBlobReader : public XmlReader {
+
+    /// <summary>Initializes a new binary XML reader reading out of a blob</summary>
+    /// <param name="blob">Blob the binary XML reader will read out of</param>
+    /// <remarks>
+    ///   Throws an exception if the blob does not contain a binary XML document.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API BinaryXmlBlobReader(const std::shared_ptr<const Blob> &blob);
+
+    /// <summary>Destroys the binary XML reader</summary>
+    public: NUCLEX_STORAGE_API virtual ~BinaryXmlBlobReader();
+
+    /// <summary>Checks whether a blob contains a binary XML document</summary>
+    /// <param name="blob">Blob that will be checked</param>
+    /// <returns>True if the blob starts with the signature of a binary XML document</returns>
+    public: NUCLEX_STORAGE_API static bool IsBinaryXml(const Blob &blob);
+
+    /// <summary>Retrieves the currently selected binary data format</summary>
+    /// <returns>The format in which binary data stored as text will be read</returns>
+    public: NUCLEX_STORAGE_API XmlBinaryFormat GetBinaryFormat() const {
+      return this->binaryFormat;
+    }
+
+    /// <summary>Selects the binary data format to use for reading binary data</summary>
+    /// <param name="newBinaryFormat">Format in which binary data stored as text is read</param>
+    /// <remarks>
+    ///   Binary data is normally stored as raw bytes. The format only matters when
+    ///   binary data is read from a value that was stored as text, as happens with
+    ///   documents converted via <see cref="BinaryXmlBlobWriter.CopyFrom" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void SetBinaryFormat(XmlBinaryFormat newBinaryFormat) {
+      this->binaryFormat = newBinaryFormat;
+    }
+
+    /// <summary>Reads tokens from the document up until the next event is encountered</summary>
+    /// <returns>The type of event encountered</returns>
+    public: NUCLEX_STORAGE_API XmlReadEvent Read();
+
+    /// <summary>Retrieves the name of the last element that was entered or exited</summary>
+    /// <returns>The name of the last element entered or exited</returns>
+    /// <remarks>
+    ///   Like with the <see cref="XmlBlobReader" />, names are interned and can be
+    ///   compared by address against handles obtained via <see cref="InternName" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API const std::string &GetElementName() const;
+
+    /// <summary>Counts the number of attributes in the current element</summary>
+    /// <returns>The number of attributes present in the current element</summary>
+    public: NUCLEX_STORAGE_API std::size_t CountAttributes() const;
+
+    /// <summary>Retrieves the name of the attribute with the specified index</summary>
+    /// <param name="index">Index of the attribue whose name will be looked up</param>
+    /// <returns>The name of the attribute with the specified index</returns>
+    public: NUCLEX_STORAGE_API const std::string &GetAttributeName(std::size_t index) const;
+
+    /// <summary>Looks up the interned copy of an element or attribute name</summary>
+    /// <param name="name">Name whose interned copy will be returned</param>
+    /// <returns>
+    ///   The string instance that <see cref="GetElementName" /> and
+    ///   <see cref="GetAttributeName" /> will return for this name
+    /// </returns>
+    public: NUCLEX_STORAGE_API const std::string &InternName(const std::string &name);
+
+    /// <summary>Try to enter the attribute with the specified name</summary>
+    /// <param name="attributeName">Name of the attribute that will be entered</param>
+    /// <returns>True if the attribute existed and was entered, otherwise false</returns>
+    public: NUCLEX_STORAGE_API bool TryEnterAttribute(const std::string &attributeName);
+
+    /// <summary>Leaves the currently entered attribute again</summary>
+    public: NUCLEX_STORAGE_API void LeaveAttribute();
+
+    /// <summary>Reads a boolean from the stream</summary>
+    /// <param name="target">Address of a boolean the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(bool &target);
+
+    /// <summary>Reads an unsigned 8 bit integer from the stream</summary>
+    /// <param name="target">Address of an 8 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint8_t &target);
+
+    /// <summary>Reads a signed 8 bit integer from the stream</summary>
+    /// <param name="target">Address of an 8 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int8_t &target);
+
+    /// <summary>Reads an unsigned 16 bit integer from the stream</summary>
+    /// <param name="target">Address of a 16 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint16_t &target);
+
+    /// <summary>Reads a signed 16 bit integer from the stream</summary>
+    /// <param name="target">Address of a 16 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int16_t &target);
+
+    /// <summary>Reads an unsigned 32 bit integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint32_t &target);
+
+    /// <summary>Reads a signed 32 bit integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int32_t &target);
+
+    /// <summary>Reads an unsigned 64 bit integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint64_t &target);
+
+    /// <summary>Reads a signed 64 bit integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int64_t &target);
+
+    /// <summary>Reads a floating point value from the stream</summary>
+    /// <param name="target">Address of a floating point value that will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(float &target);
+
+    /// <summary>Reads a double precision floating point value from the stream</summary>
+    /// <param name="target">
+    ///   Address of a double precision floating point value that will be read into
+    /// </param>
+    public: NUCLEX_STORAGE_API void Read(double &target);
+
+    /// <summary>Reads a string from the stream</summary>
+    /// <param name="target">Address of a string the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::string &target);
+
+    /// <summary>Reads a unicode string from the stream</summary>
+    /// <param name="target">Address of a unicode string the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::wstring &target);
+
+    /// <summary>Reads a chunk of bytes from the stream</summary>
+    /// <param name="buffer">Buffer the bytes will be read into</param>
+    /// <param name="byteCount">Number of bytes that will be read from the stream</param>
+    public: NUCLEX_STORAGE_API void Read(void *buffer, std::size_t byteCount);
+
+    // Unhide the overloaded Read() methods in the base class
+    // See http://www.parashift.com/c++-faq-lite/strange-inheritance.html#faq-23.9
+    using XmlReader::Read;
+
+    #pragma region struct StoredValue
+
+    /// <summary>Value of an attribute or of an element's content</summary>
+    private: struct StoredValue {
+
+      /// <summary>Type the value has been stored as</summary>
+      public: std::uint8_t Type;
+      /// <summary>Integer or boolean value</summary>
+      public: std::uint64_t Integer;
+      /// <summary>Floating point value</summary>
+      public: double Real;
+      /// <summary>Text or binary data</summary>
+      public: std::string Data;
+
+    };
+
+    #pragma endregion // struct StoredValue
+
+    #pragma region struct Attribute
+
+    /// <summary>Attribute of the current element</summary>
+    private: struct Attribute {
+
+      /// <summary>Interned name of the attribute</summary>
+      public: const std::string *Name;
+      /// <summary>Value that has been assigned to the attribute</summary>
+      public: StoredValue Value;
+
+    };
+
+    #pragma endregion // struct Attribute
+
+    /// <summary>Returns the value of the entered attribute or the current content</summary>
+    /// <returns>The value a call to one of the Read() methods should read</returns>
+    private: const StoredValue &getValue() const;
+
+    /// <summary>Converts a value into an integer</summary>
+    /// <typeparam name="TInteger">Type of integer the value will be converted into</typeparam>
+    /// <param name="value">Value that will be converted</param>
+    /// <returns>The value as an integer of the requested type</returns>
+    private: template<typename TInteger> static TInteger toInteger(const StoredValue &value);
+
+    /// <summary>Converts a value into a floating point value</summary>
+    /// <typeparam name="TFloat">Type of floating point value that will be returned</typeparam>
+    /// <param name="value">Value that will be converted</param>
+    /// <returns>The value as floating point value of the requested type</returns>
+    private: template<typename TFloat> static TFloat toFloat(const StoredValue &value);
+
+    /// <summary>Reads the byte introducing the next token</summary>
+    /// <returns>The byte introducing the next token</returns>
+    private: std::uint8_t readTokenByte();
+
+    /// <summary>Reads a name reference and returns the interned name</summary>
+    /// <returns>The interned name the reference pointed to</returns>
+    private: const std::string &readName();
+
+    /// <summary>Reads a value of the specified type</summary>
+    /// <param name="type">Type of the value that will be read</param>
+    /// <param name="target">Value that will receive the data</param>
+    private: void readValue(std::uint8_t type, StoredValue &target);
+
+    /// <summary>Reads a variable-length integer</summary>
+    /// <returns>The integer that has been read</returns>
+    private: std::uint64_t readVarInt();
+
+    /// <summary>Reads a length-prefixed string of bytes</summary>
+    /// <param name="target">String that will receive the bytes</param>
+    private: void readBytes(std::string &target);
+
+    /// <summary>Returns the interned copy of a name, adding it if needed</summary>
+    /// <param name="name">Name that will be interned</param>
+    /// <returns>The interned copy of the name</returns>
+    private: const std::string &intern(const std::string &name);
+
+    private: BinaryXmlBlobReader(const BinaryXmlBlobReader &);
+    private: BinaryXmlBlobReader &operator =(const BinaryXmlBlobReader &);
+
+    /// <summary>Reads the tokens from the blob</summary>
+    private: Binary::BinaryBlobReader reader;
+    /// <summary>Length of the blob being read</summary>
+    private: std::uint64_t length;
+    /// <summary>Binary data format used for binary data stored as text</summary>
+    private: XmlBinaryFormat binaryFormat;
+
+    /// <summary>Looks up the globally interned names this document has used</summary>
+    private: std::unordered_map<std::string, const std::string *> nameLookup;
+    /// <summary>Interned names in the order they have been defined by the document</summary>
+    private: std::vector<const std::string *> documentNames;
+
+    /// <summary>Names of the elements that have been entered</summary>
+    private: std::vector<const std::string *> openElements;
+    /// <summary>Name of the element last entered or exited</summary>
+    private: const std::string *name;
+    /// <summary>Attributes of the current element, only grows to reuse the values</summary>
+    private: std::vector<Attribute> attributes;
+    /// <summary>Number of attributes the current element has</summary>
+    private: std::size_t attributeCount;
+    /// <summary>Content last encountered in the document</summary>
+    private: StoredValue content;
+    /// <summary>Value of the attribute the reader has entered</summary>
+    private: const StoredValue *enteredAttribute;
+    /// <summary>Byte of a token that has been read ahead after the attributes</summary>
+    private: int nextTokenByte;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_BINARYXMLBLOBREADER_H
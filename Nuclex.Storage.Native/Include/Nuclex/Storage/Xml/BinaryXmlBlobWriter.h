@@ -0,0 +1,253 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_BINARYXMLBLOBWRITER_H
+#define NUCLEX_STORAGE_XML_BINARYXMLBLOBWRITER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Xml/XmlWriter.h"
+#include "Nuclex/Storage/Binary/BinaryBlobWriter.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class XmlReader;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes XML documents in a compact binary form</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The binary form stores the same elements, attributes and contents a text XML
+  ///     document would, but each name only once, numbers in binary and binary data as
+  ///     raw bytes rather than Base64 or hexadecimal text. Loading it through the
+  ///     <see cref="BinaryXmlBlobReader" /> avoids parsing text altogether.
+  ///   </para>
+  ///   <para>
+  ///     Comments and the XML declaration are not stored because no XML reader reports
+  ///     them. Keep the text XML for your tools and convert it with <see cref="CopyFrom" />
+  ///     when building the files you ship.
+  ///   </para>
+  ///   <para>
+  ///     Each attribute holds exactly one value and all attributes of an element have to
+  ///     be written before the element's contents or child elements.
+  ///   </para>
+  /// </remarks>
+  class BinaryXmlBlobWriter : public XmlWriter {
+
+    /// <summary>Number of bytes the write buffer holds unless specified otherwise</summary>
+    public: static const std::size_t DefaultWriteBufferByteCount = 65536;
+
+    /// <summary>Initializes a new binary XML writer writing into a blob</summary>
+    /// <param name="blob">Blob the binary XML writer will write into</param>
+    /// <param name="writeBufferByteCount">
+    ///   Number of bytes that will be collected before they're written into the blob.
+    ///   Zero disables the write buffer and writes every token into the blob directly.
+    /// </param>
+    public: NUCLEX_STORAGE_API BinaryXmlBlobWriter(
+      const std::shared_ptr<Blob> &blob,
+      std::size_t writeBufferByteCount = DefaultWriteBufferByteCount
+    );
+
+    /// <summary>Writes any buffered tokens into the blob and destroys the writer</summary>
+    /// <remarks>
+    ///   Errors writing into the blob can not be reported from here, call Flush()
+    ///   before destroying the writer if you need to know about them.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API ~BinaryXmlBlobWriter();
+
+    /// <summary>Writes all buffered tokens into the blob</summary>
+    /// <remarks>
+    ///   This only empties the writer's own buffer. To flush caches behind the blob,
+    ///   call the blob's Flush() method afterwards.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Flush();
+
+    /// <summary>Copies all remaining events of an XML reader into the document</summary>
+    /// <param name="reader">Reader whose events will be copied</param>
+    /// <remarks>
+    ///   Reads until the reader reports the end of its document. Attribute values and
+    ///   contents are copied as text, so a text XML document converted this way avoids
+    ///   the XML parser when it is loaded, but numbers still have to be parsed from text.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void CopyFrom(XmlReader &reader);
+
+    /// <summary>Retrieves the currently selected binary data format</summary>
+    /// <returns>The format in which binary data would be written to text XML</returns>
+    /// <remarks>
+    ///   Binary data is always stored as raw bytes, the format is only kept so code
+    ///   written for the text XML writer behaves the same.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API XmlBinaryFormat GetBinaryFormat() const {
+      return this->binaryFormat;
+    }
+
+    /// <summary>Selects the binary data format to use for writing binary data</summary>
+    /// <param name="newBinaryFormat">Format in which binary data would be written</param>
+    public: NUCLEX_STORAGE_API void SetBinaryFormat(XmlBinaryFormat newBinaryFormat) {
+      this->binaryFormat = newBinaryFormat;
+    }
+
+    /// <summary>Does nothing, binary XML documents are always UTF-8</summary>
+    /// <param name="encoding">Encoding the text XML document would declare</param>
+    public: NUCLEX_STORAGE_API void WriteDeclaration(const std::string &encoding = "utf-8");
+
+    /// <summary>Opens a new XML element</summary>
+    /// <param name="elementName">Name of the XML element that will be opened</param>
+    public: NUCLEX_STORAGE_API void BeginElement(const std::string &elementName);
+
+    /// <summary>Closes the current XML element</summary>
+    public: NUCLEX_STORAGE_API void EndElement();
+
+    /// <summary>Begins an XML comment, which will not be stored</summary>
+    public: NUCLEX_STORAGE_API void BeginComment();
+
+    /// <summary>Ends the current XML comment</summary>
+    public: NUCLEX_STORAGE_API void EndComment();
+
+    /// <summary>Opens an XML attribute in the current element</summary>
+    /// <param name="attributeName">Name of the attribute that will be opened</param>
+    public: NUCLEX_STORAGE_API void BeginAttribute(const std::string &attributeName);
+
+    /// <summary>Closes the current XML attribute</summary>
+    public: NUCLEX_STORAGE_API void EndAttribute();
+
+    /// <summary>Writes a boolean into the stream</summary>
+    /// <param name="value">Boolean that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(bool value);
+
+    /// <summary>Writes an unsigned 8 bit integer into the stream</summary>
+    /// <param name="value">8 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::uint8_t value);
+
+    /// <summary>Writes a signed 8 bit integer into the stream</summary>
+    /// <param name="value">8 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::int8_t value);
+
+    /// <summary>Writes an unsigned 16 bit integer into the stream</summary>
+    /// <param name="value">16 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::uint16_t value);
+
+    /// <summary>Writes a signed 16 bit integer into the stream</summary>
+    /// <param name="value">16 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::int16_t value);
+
+    /// <summary>Writes an unsigned 32 bit integer into the stream</summary>
+    /// <param name="value">32 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::uint32_t value);
+
+    /// <summary>Writes a signed 32 bit integer into the stream</summary>
+    /// <param name="value">32 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::int32_t value);
+
+    /// <summary>Writes an unsigned 64 bit integer into the stream</summary>
+    /// <param name="value">64 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::uint64_t value);
+
+    /// <summary>Writes a signed 64 bit integer into the stream</summary>
+    /// <param name="value">64 bit integer that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(std::int64_t value);
+
+    /// <summary>Writes a floating point value into the stream</summary>
+    /// <param name="value">Floating point value that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(float value);
+
+    /// <summary>Writes a double precision floating point value into the stream</summary>
+    /// <param name="value">Double precision floating point value that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(double value);
+
+    /// <summary>Writes a string into the stream</summary>
+    /// <param name="value">String that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(const std::string &value);
+
+    /// <summary>Writes a unicode string into the stream</summary>
+    /// <param name="value">Unicode string that will be written</param>
+    public: NUCLEX_STORAGE_API void Write(const std::wstring &value);
+
+    /// <summary>Writes a chunk of bytes into the stream</summary>
+    /// <param name="buffer">Buffer the bytes that will be written</param>
+    /// <param name="byteCount">Number of bytes to write</param>
+    public: NUCLEX_STORAGE_API void Write(const void *buffer, std::size_t byteCount);
+
+    // Unhide the overloaded Write() methods in the base class
+    // See http://www.parashift.com/c++-faq-lite/strange-inheritance.html#faq-23.9
+    using XmlWriter::Write;
+
+    /// <summary>Writes the byte introducing a value and everything up to the value</summary>
+    /// <param name="valueType">Type of the value that will follow</param>
+    /// <returns>False if the value is written into a comment and should be skipped</returns>
+    private: bool beginValue(std::uint8_t valueType);
+
+    /// <summary>Writes a reference to an element or attribute name</summary>
+    /// <param name="name">Name that will be referenced</param>
+    private: void writeName(const std::string &name);
+
+    /// <summary>Writes an unsigned integer as variable-length integer</summary>
+    /// <param name="value">Value that will be written</param>
+    private: void writeVarInt(std::uint64_t value);
+
+    /// <summary>Writes a length-prefixed string of bytes</summary>
+    /// <param name="data">Bytes that will be written</param>
+    /// <param name="byteCount">Number of bytes that will be written</param>
+    private: void writeBytes(const void *data, std::size_t byteCount);
+
+    /// <summary>Writes an unsigned integer value</summary>
+    /// <param name="value">Value that will be written</param>
+    private: void writeUnsigned(std::uint64_t value);
+
+    /// <summary>Writes a signed integer value</summary>
+    /// <param name="value">Value that will be written</param>
+    private: void writeSigned(std::int64_t value);
+
+    private: BinaryXmlBlobWriter(const BinaryXmlBlobWriter &);
+    private: BinaryXmlBlobWriter &operator =(const BinaryXmlBlobWriter &);
+
+    /// <summary>Writes the tokens into the blob</summary>
+    private: Binary::BinaryBlobWriter writer;
+    /// <summary>Index of each name that has been written so far</summary>
+    private: std::unordered_map<std::string, std::size_t> nameIndices;
+    /// <summary>Binary data format reported to the user</summary>
+    private: XmlBinaryFormat binaryFormat;
+    /// <summary>Name of the attribute that has been opened</summary>
+    private: std::string attributeName;
+    /// <summary>Number of elements that have been opened and not been closed yet</summary>
+    private: std::size_t openElementCount;
+    /// <summary>Whether attributes can still be added to the current element</summary>
+    private: bool canAddAttributes;
+    /// <summary>Whether the writer is currently inside an XML attribute</summary>
+    private: bool isInAttribute;
+    /// <summary>Whether the current attribute has received its value</summary>
+    private: bool isAttributeWritten;
+    /// <summary>Whether the writer is currently inside an XML comment</summary>
+    private: bool isInComment;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_BINARYXMLBLOBWRITER_H
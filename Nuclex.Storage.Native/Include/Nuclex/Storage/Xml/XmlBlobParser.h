@@ -0,0 +1,90 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_XMLBLOBPARSER_H
+#define NUCLEX_STORAGE_XML_XMLBLOBPARSER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Xml/XmlHandler.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses XML plaintext stored in a blob and reports it to a handler</summary>
+  /// <remarks>
+  ///   Use this for bulk loading. If the document should be read step by step
+  ///   or by code that pulls values as it needs them, use <see cref="XmlBlobReader" />.
+  /// </remarks>
+  class XmlBlobParser {
+
+    /// <summary>Number of bytes handed to the XML parser at once by default</summary>
+    public: static const std::size_t DefaultChunkByteCount = 64 * 1024;
+
+    /// <summary>Parses an XML document and reports its contents to a handler</summary>
+    /// <param name="blob">Blob containing the XML document</param>
+    /// <param name="handler">Handler that will be notified of the document's contents</param>
+    /// <param name="chunkByteCount">Number of bytes handed to the XML parser at once</param>
+    /// <remarks>
+    ///   If the blob can provide its contents as a contiguous span, the parser is fed
+    ///   directly from that memory. Throws an <see cref="XmlParseError" /> if the document
+    ///   is malformed.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API static void Parse(
+      const Blob &blob, XmlHandler &handler,
+      std::size_t chunkByteCount = DefaultChunkByteCount
+    );
+
+    /// <summary>Parses a section of a blob and reports its contents to a handler</summary>
+    /// <param name="blob">Blob containing the XML document</param>
+    /// <param name="startOffset">Offset in the blob at which the section begins</param>
+    /// <param name="byteCount">Length of the section in bytes</param>
+    /// <param name="handler">Handler that will be notified of the section's contents</param>
+    /// <param name="chunkByteCount">Number of bytes handed to the XML parser at once</param>
+    /// <remarks>
+    ///   The section has to contain a single element with all of its children, which
+    ///   will be parsed as if it was the root element of a document. Use
+    ///   <see cref="XmlDocumentIndex" /> to find the sections elements occupy.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API static void Parse(
+      const Blob &blob, std::uint64_t startOffset, std::uint64_t byteCount,
+      XmlHandler &handler, std::size_t chunkByteCount = DefaultChunkByteCount
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_XMLBLOBPARSER_H
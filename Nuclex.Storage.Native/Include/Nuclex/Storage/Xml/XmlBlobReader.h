@@ -24,6 +24,8 @@ License along with this library
 #include "Nuclex/Storage/Config.h"
 #include "Nuclex/Storage/Xml/XmlReader.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace Nuclex { namespace Storage {
@@ -43,12 +45,59 @@ namespace Nuclex { namespace Storage { namespace Xml {
   /// <summary>Reads data from a chunk of XML plaintext</summary>
   class XmlBlobReader : public XmlReader {
 
+    /// <summary>Number of bytes handed to the XML parser at once by default</summary>
+    public: static const std::size_t DefaultChunkByteCount = 64 * 1024;
+
     /// <summary>Initializes a new XML reader reading out of a blob</summary>
     /// <param name="blob">Blob the XML reader will read out of</param>
-    public: NUCLEX_STORAGE_API XmlBlobReader(const std::shared_ptr<const Blob> &blob);
+    /// <param name="chunkByteCount">Number of bytes handed to the XML parser at once</param>
+    /// <remarks>
+    ///   If the blob can provide its contents as a contiguous span (memory blobs and
+    ///   memory-mapped files), the XML parser is fed directly from that memory instead
+    ///   of reading each chunk into the parser's buffer through <see cref="Blob.ReadAt" />.
+    ///   Larger chunks mean fewer calls into the parser but more memory for its buffer.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API XmlBlobReader(
+      const std::shared_ptr<const Blob> &blob,
+      std::size_t chunkByteCount = DefaultChunkByteCount
+    );
+
+    /// <summary>Initializes a new XML reader reading a section of a blob</summary>
+    /// <param name="blob">Blob the XML reader will read out of</param>
+    /// <param name="startOffset">Offset in the blob at which the section begins</param>
+    /// <param name="byteCount">Length of the section in bytes</param>
+    /// <param name="chunkByteCount">Number of bytes handed to the XML parser at once</param>
+    /// <remarks>
+    ///   The section has to contain a single element with all of its children, which
+    ///   will be read as if it was the root element of a document. Use
+    ///   <see cref="XmlDocumentIndex" /> to find the sections elements occupy.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API XmlBlobReader(
+      const std::shared_ptr<const Blob> &blob,
+      std::uint64_t startOffset, std::uint64_t byteCount,
+      std::size_t chunkByteCount = DefaultChunkByteCount
+    );
+
     /// <summary>Destroys the XML reader</summary>
     public: NUCLEX_STORAGE_API virtual ~XmlBlobReader();
 
+    /// <summary>Starts over, reading another XML document</summary>
+    /// <param name="blob">Blob the XML reader will read out of</param>
+    /// <remarks>
+    ///   The XML parser, its buffer and the interned names are reused instead of being
+    ///   set up from scratch, which makes a difference when many small documents are read.
+    ///   Interned names returned earlier stay valid. The binary format is kept.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Reset(const std::shared_ptr<const Blob> &blob);
+
+    /// <summary>Starts over, reading a section of another blob</summary>
+    /// <param name="blob">Blob the XML reader will read out of</param>
+    /// <param name="startOffset">Offset in the blob at which the section begins</param>
+    /// <param name="byteCount">Length of the section in bytes</param>
+    public: NUCLEX_STORAGE_API void Reset(
+      const std::shared_ptr<const Blob> &blob, std::uint64_t startOffset, std::uint64_t byteCount
+    );
+
     /// <summary>Retrieves the currently selected binary data format</summary>
     /// <returns>The format in which binary data will be read</returns>
     public: NUCLEX_STORAGE_API XmlBinaryFormat GetBinaryFormat() const {
@@ -67,6 +116,12 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
     /// <summary>Retrieves the name of the last element that was entered or exited</summary>
     /// <returns>The name of the last element entered or exited</returns>
+    /// <remarks>
+    ///   Element and attribute names are interned globally: the same name is always
+    ///   returned as the same string instance, which lives as long as the process. Names
+    ///   can thus be compared by address against handles obtained via
+    ///   <see cref="InternName" /> or against a Nuclex::Support::Text::InternedString.
+    /// </remarks>
     public: NUCLEX_STORAGE_API const std::string &GetElementName() const;
 
     /// <summary>Counts the number of attributes in the current element</summary>
@@ -78,9 +133,35 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <returns>The name of the attribute with the specified index</returns>
     public: NUCLEX_STORAGE_API const std::string &GetAttributeName(std::size_t index) const;
 
+    /// <summary>Retrieves the value of the attribute with the specified index</summary>
+    /// <param name="index">Index of the attribue whose value will be looked up</param>
+    /// <returns>The value of the attribute with the specified index</returns>
+    /// <remarks>
+    ///   The returned string is reused for the next element and is only valid until
+    ///   the next call to <see cref="Read" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API const std::string &GetAttributeValue(std::size_t index) const;
+
+    /// <summary>Looks up the interned copy of an element or attribute name</summary>
+    /// <param name="name">Name whose interned copy will be returned</param>
+    /// <returns>
+    ///   The string instance that <see cref="GetElementName" /> and
+    ///   <see cref="GetAttributeName" /> will return for this name
+    /// </returns>
+    /// <remarks>
+    ///   Look up the names you're interested in once, then compare the addresses of
+    ///   the names reported while reading against them instead of their contents.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API const std::string &InternName(const std::string &name);
+
     /// <summary>Try to enter the attribute with the specified name</summary>
     /// <param name="attributeName">Name of the attribute that will be entered</param>
     /// <returns>True if the attribute existed and was entered, otherwise false</returns>
+    /// <remarks>
+    ///   Passing a name obtained through <see cref="InternName" /> or an
+    ///   Nuclex::Support::Text::InternedString finds the attribute by address without
+    ///   having to hash or compare the name.
+    /// </remarks>
     public: NUCLEX_STORAGE_API bool TryEnterAttribute(const std::string &attributeName);
 
     /// <summary>Leaves the currently entered attribute again</summary>
@@ -149,6 +230,9 @@ namespace Nuclex { namespace Storage { namespace Xml {
     // See http://www.parashift.com/c++-faq-lite/strange-inheritance.html#faq-23.9
     using XmlReader::Read;
 
+    /// <summary>Stream reader feeds the same implementation from an input stream</summary>
+    friend class XmlStreamReader;
+
     /// <summary>Stores private implementation details</summary>
     private: class Impl;
 
@@ -42,14 +42,57 @@ namespace Nuclex { namespace Storage { namespace Xml {
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Writes data in the XML format</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Finished lines are collected in a write buffer that is handed to the blob in one
+  ///     go when it is full, when Flush() is called and when the writer is destroyed.
+  ///     Until then, the blob does not see the buffered lines.
+  ///   </para>
+  ///   <para>
+  ///     In compact mode, the writer leaves out the line breaks and indentation meant for
+  ///     human readers and writes the whole document as one line, separating values only
+  ///     where two would otherwise touch. This is meant for XML that is only consumed by
+  ///     programs and avoids most of the per-element work of pretty-printing.
+  ///   </para>
+  /// </remarks>
   class XmlBlobWriter : public XmlWriter {
-  
+
+    /// <summary>Number of bytes the write buffer holds unless specified otherwise</summary>
+    public: static const std::size_t DefaultWriteBufferByteCount = 65536;
+
     /// <summary>Initializes a new XML writer writing into a blob</summary>
     /// <param name="blob">Blob the XML writer will write into</param>
-    public: NUCLEX_STORAGE_API XmlBlobWriter(const std::shared_ptr<Blob> &blob);
-    /// <summary>Destroys the XML reader</summary>
+    /// <param name="writeBufferByteCount">
+    ///   Number of bytes that will be collected before they're written into the blob.
+    ///   Zero disables the write buffer and writes every line into the blob directly.
+    /// </param>
+    /// <param name="compact">
+    ///   Whether to write the XML without line breaks and indentation
+    /// </param>
+    public: NUCLEX_STORAGE_API XmlBlobWriter(
+      const std::shared_ptr<Blob> &blob,
+      std::size_t writeBufferByteCount = DefaultWriteBufferByteCount,
+      bool compact = false
+    );
+    /// <summary>Writes any buffered lines into the blob and destroys the XML writer</summary>
+    /// <remarks>
+    ///   Errors writing into the blob can not be reported from here, call Flush()
+    ///   before destroying the writer if you need to know about them.
+    /// </remarks>
     public: NUCLEX_STORAGE_API ~XmlBlobWriter();
 
+    /// <summary>Writes all buffered lines into the blob</summary>
+    /// <remarks>
+    ///   Only lines that have been completed are written, an element or comment that
+    ///   is still open stays in the writer until more of it is known. To flush caches
+    ///   behind the blob, call the blob's Flush() method afterwards.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Flush();
+
+    /// <summary>Checks whether the writer leaves out line breaks and indentation</summary>
+    /// <returns>True if the writer writes the XML document as a single line</returns>
+    public: NUCLEX_STORAGE_API bool IsCompact() const;
+
     /// <summary>Retrieves the currently selected binary data format</summary>
     /// <returns>The format in which binary data will be read</returns>
     public: NUCLEX_STORAGE_API XmlBinaryFormat GetBinaryFormat() const {
@@ -179,6 +222,20 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <param name="text">Content that will be appended</param>
     private: void writeData(const std::string &text);
 
+    /// <summary>Appends encoded binary data to the current element</summary>
+    /// <param name="data">Binary data that will be encoded and appended</param>
+    /// <param name="byteCount">Number of bytes that will be appended</param>
+    private: void writeBinaryData(const std::uint8_t *data, std::size_t byteCount);
+
+    /// <summary>Writes a printed number as attribute value, comment or content</summary>
+    /// <param name="characters">Characters of the printed number</param>
+    /// <param name="end">Address one past the last character of the printed number</param>
+    /// <remarks>
+    ///   Printed numbers contain neither whitespace nor characters that need escaping,
+    ///   so they can be appended as they are without going through a string first.
+    /// </remarks>
+    private: void writeNumber(const char *characters, const char *end);
+
     /// <summary>Stores private implementation details</summary>
     private: class Impl;
 
@@ -0,0 +1,258 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_XMLDOCUMENTINDEX_H
+#define NUCLEX_STORAGE_XML_XMLDOCUMENTINDEX_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Xml/XmlBlobReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Blob;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records where the elements of an XML document are located</summary>
+  /// <remarks>
+  ///   <para>
+  ///     An <see cref="XmlBlobReader" /> can only walk through a document from start
+  ///     to end. If you only need some parts of a large document, or need them in
+  ///     a different order, scan the document once with this index. It only keeps
+  ///     the names and byte offsets of all elements, not their attributes or contents.
+  ///   </para>
+  ///   <para>
+  ///     Afterwards, <see cref="OpenSubtree" /> hands out XML readers that begin
+  ///     directly at an element's start tag and stop after its end tag, so only
+  ///     the requested part of the document is parsed.
+  ///   </para>
+  ///   <para>
+  ///     Elements are stored in the order their start tags appear in the document,
+  ///     so a parent is always followed by its children. Each element knows the index
+  ///     just past its last descendant, which lets you skip over whole subtrees.
+  ///     Subtrees are parsed on their own, so they can not use entities declared
+  ///     in the document's DTD.
+  ///   </para>
+  /// </remarks>
+  class XmlDocumentIndex {
+
+    /// <summary>Element index returned when no element could be found</summary>
+    public: static const std::size_t NoElement = static_cast<std::size_t>(-1);
+
+    /// <summary>Location of an element within the document</summary>
+    public: struct Element {
+
+      /// <summary>Name of the element</summary>
+      /// <remarks>
+      ///   Names are interned, so all elements with the same name point to the same
+      ///   string instance, which lives as long as the index.
+      /// </remarks>
+      public: const std::string *Name;
+      /// <summary>Offset of the element's start tag in the document</summary>
+      public: std::uint64_t StartOffset;
+      /// <summary>Offset just past the element's end tag in the document</summary>
+      public: std::uint64_t EndOffset;
+      /// <summary>Number of elements the element is nested in</summary>
+      public: std::size_t Depth;
+      /// <summary>Index of the element's parent or NoElement for the root element</summary>
+      public: std::size_t ParentIndex;
+      /// <summary>Index of the first element that follows the element's subtree</summary>
+      public: std::size_t SubtreeEndIndex;
+
+    };
+
+    /// <summary>Scans an XML document and records where its elements are</summary>
+    /// <param name="blob">Blob containing the XML document that will be indexed</param>
+    /// <param name="chunkByteCount">Number of bytes handed to the XML parser at once</param>
+    public: NUCLEX_STORAGE_API XmlDocumentIndex(
+      const std::shared_ptr<const Blob> &blob,
+      std::size_t chunkByteCount = XmlBlobReader::DefaultChunkByteCount
+    );
+
+    /// <summary>Frees all memory used by the index</summary>
+    public: NUCLEX_STORAGE_API ~XmlDocumentIndex();
+
+    /// <summary>Counts the elements in the document</summary>
+    /// <returns>The total number of elements in the document</returns>
+    public: NUCLEX_STORAGE_API std::size_t CountElements() const {
+      return this->elements.size();
+    }
+
+    /// <summary>Retrieves the location of the element with the specified index</summary>
+    /// <param name="index">Index of the element whose location will be returned</param>
+    /// <returns>The location of the element with the specified index</returns>
+    public: NUCLEX_STORAGE_API const Element &GetElement(std::size_t index) const;
+
+    /// <summary>Looks up the first child of an element</summary>
+    /// <param name="index">Index of the element whose first child will be looked up</param>
+    /// <returns>The index of the element's first child or NoElement</returns>
+    public: NUCLEX_STORAGE_API std::size_t GetFirstChild(std::size_t index) const;
+
+    /// <summary>Looks up the element that follows another one on the same level</summary>
+    /// <param name="index">Index of the element whose next sibling will be looked up</param>
+    /// <returns>The index of the element's next sibling or NoElement</returns>
+    public: NUCLEX_STORAGE_API std::size_t GetNextSibling(std::size_t index) const;
+
+    /// <summary>Searches the children of an element for one with the specified name</summary>
+    /// <param name="parentIndex">Index of the element whose children will be searched</param>
+    /// <param name="name">Name of the child element that will be searched for</param>
+    /// <returns>The index of the first child with the specified name or NoElement</returns>
+    /// <remarks>
+    ///   Pass NoElement as the parent to check the name of the root element.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::size_t FindChild(
+      std::size_t parentIndex, const std::string &name
+    ) const;
+
+    /// <summary>Searches for an element by its path from the root element</summary>
+    /// <param name="path">
+    ///   Names of the element and its ancestors, starting with the root element and
+    ///   separated by slashes (for example "level/entities/entity")
+    /// </param>
+    /// <returns>The index of the first element on the specified path or NoElement</returns>
+    public: NUCLEX_STORAGE_API std::size_t FindElement(const std::string &path) const;
+
+    /// <summary>Creates an XML reader that only reads the specified element</summary>
+    /// <param name="index">Index of the element the XML reader will read</param>
+    /// <param name="chunkByteCount">Number of bytes handed to the XML parser at once</param>
+    /// <returns>An XML reader which reads the element as if it was a document</returns>
+    /// <remarks>
+    ///   The XML reader starts parsing at the element's start tag, reports its attributes,
+    ///   contents and children and then the end of the document.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API std::unique_ptr<XmlBlobReader> OpenSubtree(
+      std::size_t index, std::size_t chunkByteCount = XmlBlobReader::DefaultChunkByteCount
+    ) const;
+
+    /// <summary>Parses the children of an element on several threads</summary>
+    /// <typeparam name="TParse">Callable object that parses a single child</typeparam>
+    /// <typeparam name="TMerge">Callable object that receives the parsed children</typeparam>
+    /// <param name="parentIndex">Index of the element whose children will be parsed</param>
+    /// <param name="parse">
+    ///   Called with an XML reader for each child, reading the child as if it was
+    ///   a document. Returns the result of parsing the child.
+    /// </param>
+    /// <param name="merge">
+    ///   Called with the element index and the result of each child in document order
+    /// </param>
+    /// <param name="threadCount">
+    ///   Number of threads parsing children, including the calling thread. Zero uses
+    ///   one thread per CPU core the system reports.
+    /// </param>
+    /// <remarks>
+    ///   <para>
+    ///     Meant for documents that consist of long lists of independent records, such as
+    ///     &lt;entities&gt;&lt;entity /&gt;&lt;entity /&gt;...&lt;/entities&gt;. Each child
+    ///     is handed to an XML parser of its own, so the parse callback will be invoked
+    ///     from several threads at once and must not touch shared state without locking.
+    ///   </para>
+    ///   <para>
+    ///     The merge callback is never invoked concurrently. It may be invoked from any of
+    ///     the threads, but always in the order the children appear in the document. Only
+    ///     a few results per thread are kept waiting for their turn, so the result type
+    ///     has to be default-constructible and assignable.
+    ///   </para>
+    ///   <para>
+    ///     If either callback throws, no more children are handed out and the first
+    ///     exception is rethrown once all threads have stopped.
+    ///   </para>
+    /// </remarks>
+    public: template<typename TParse, typename TMerge>
+    void ParseChildrenInParallel(
+      std::size_t parentIndex, TParse &&parse, TMerge &&merge, std::size_t threadCount = 0
+    ) const {
+      typedef typename std::decay<
+        decltype(parse(std::declval<XmlReader &>()))
+      >::type ResultType;
+
+      std::vector<ResultType> results;
+      parseChildrenInParallel(
+        parentIndex, threadCount,
+        [&results](std::size_t slotCount) { results.resize(slotCount); },
+        [&results, &parse](std::size_t slotIndex, XmlReader &reader) {
+          results[slotIndex] = parse(reader);
+        },
+        [&results, &merge](std::size_t slotIndex, std::size_t elementIndex) {
+          merge(elementIndex, results[slotIndex]);
+        }
+      );
+    }
+
+    /// <summary>Collects the element locations while eXpat scans the document</summary>
+    private: class Builder;
+
+    /// <summary>Parses the children of an element on several threads</summary>
+    /// <param name="parentIndex">Index of the element whose children will be parsed</param>
+    /// <param name="threadCount">Number of threads parsing children, may be zero</param>
+    /// <param name="prepare">
+    ///   Called once with the number of slots that results will be stored in
+    /// </param>
+    /// <param name="parse">
+    ///   Called to parse a child and store its result in the specified slot
+    /// </param>
+    /// <param name="merge">
+    ///   Called in document order to take the result of a child out of its slot
+    /// </param>
+    /// <remarks>
+    ///   A slot is not handed to another child before the result of the previous child
+    ///   stored in it has been merged.
+    /// </remarks>
+    private: NUCLEX_STORAGE_API void parseChildrenInParallel(
+      std::size_t parentIndex, std::size_t threadCount,
+      const std::function<void(std::size_t slotCount)> &prepare,
+      const std::function<void(std::size_t slotIndex, XmlReader &reader)> &parse,
+      const std::function<void(std::size_t slotIndex, std::size_t elementIndex)> &merge
+    ) const;
+
+    private: XmlDocumentIndex(const XmlDocumentIndex &);
+    private: XmlDocumentIndex &operator =(const XmlDocumentIndex &);
+
+    /// <summary>Blob containing the indexed document</summary>
+    private: std::shared_ptr<const Blob> blob;
+    /// <summary>Looks up the globally interned copy of an element name</summary>
+    private: std::unordered_map<std::string, const std::string *> names;
+    /// <summary>Locations of all elements in document order</summary>
+    private: std::vector<Element> elements;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_XMLDOCUMENTINDEX_H
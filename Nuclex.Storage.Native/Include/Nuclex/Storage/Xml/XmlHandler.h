@@ -0,0 +1,113 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_XMLHANDLER_H
+#define NUCLEX_STORAGE_XML_XMLHANDLER_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef>
+#include <string>
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives the contents of an XML document while it is being parsed</summary>
+  /// <remarks>
+  ///   <para>
+  ///     This is the push counterpart to <see cref="XmlBlobReader" />. Instead of asking
+  ///     for one event at a time, the whole document is run through the parser in one go
+  ///     (see <see cref="XmlBlobParser" />) and the handler is called back for each
+  ///     element and piece of text. Without the need to pause the parser after each event
+  ///     and to copy the event's data for later retrieval, this is considerably faster
+  ///     for loaders that process documents front to back.
+  ///   </para>
+  ///   <para>
+  ///     All methods do nothing by default, so handlers only need to override what they
+  ///     are interested in. Exceptions thrown from a handler stop the parser and are
+  ///     rethrown to the caller of the parser.
+  ///   </para>
+  /// </remarks>
+  class XmlHandler {
+
+    #pragma region struct Attribute
+
+    /// <summary>Name and value of an attribute in an element being reported</summary>
+    public: struct Attribute {
+
+      /// <summary>Interned name of the attribute</summary>
+      /// <remarks>
+      ///   Names are interned for the duration of a parse, so each distinct name is
+      ///   reported at the same address every time it appears.
+      /// </remarks>
+      public: const std::string *Name;
+      /// <summary>Zero-terminated value of the attribute</summary>
+      /// <remarks>Only valid until the callback returns</remarks>
+      public: const char *Value;
+
+    };
+
+    #pragma endregion // struct Attribute
+
+    /// <summary>Destroys the XML handler</summary>
+    public: NUCLEX_STORAGE_API virtual ~XmlHandler() {}
+
+    /// <summary>Called when the parser encounters an opening element</summary>
+    /// <param name="name">Interned name of the element</param>
+    /// <param name="attributes">Attributes the element carries</param>
+    /// <param name="attributeCount">Number of attributes the element carries</param>
+    public: NUCLEX_STORAGE_API virtual void ElementStarted(
+      const std::string &name, const Attribute *attributes, std::size_t attributeCount
+    ) {
+      (void)name;
+      (void)attributes;
+      (void)attributeCount;
+    }
+
+    /// <summary>Called when the parser encounters a closing element</summary>
+    /// <param name="name">Interned name of the element</param>
+    /// <remarks>Also called right after ElementStarted() for empty elements</remarks>
+    public: NUCLEX_STORAGE_API virtual void ElementEnded(const std::string &name) {
+      (void)name;
+    }
+
+    /// <summary>Called when the parser encounters text inside an element</summary>
+    /// <param name="text">Text that has been encountered, not zero-terminated</param>
+    /// <param name="length">Number of bytes in the text</param>
+    /// <remarks>
+    ///   The text of an element can be reported in several pieces (eXpat splits text
+    ///   at least at line breaks and chunk boundaries). The text is only valid until
+    ///   the callback returns.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API virtual void TextEncountered(
+      const char *text, std::size_t length
+    ) {
+      (void)text;
+      (void)length;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_XMLHANDLER_H
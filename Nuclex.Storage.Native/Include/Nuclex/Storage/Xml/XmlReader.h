@@ -26,7 +26,10 @@ License along with this library
 #include "Nuclex/Storage/Xml/XmlReadEvent.h"
 #include "Nuclex/Storage/Xml/XmlBinaryFormat.h"
 
+#include <cstddef>
+#include <initializer_list>
 #include <memory>
+#include <string>
 
 namespace Nuclex { namespace Storage { namespace Xml {
 
@@ -65,6 +68,53 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
     #pragma endregion // class AttributeScope
 
+    #pragma region class AttributeBinding
+
+    /// <summary>Associates the name of an attribute with a variable receiving its value</summary>
+    /// <remarks>
+    ///   Only stores references to the name and the variable, so both need to stay alive
+    ///   until the binding has been handed to <see cref="ReadAttributes" />.
+    /// </remarks>
+    public: class AttributeBinding {
+
+      /// <summary>Initializes a new attribute binding</summary>
+      /// <typeparam name="TValue">Type of the variable the value will be read into</typeparam>
+      /// <param name="name">Name of the attribute whose value will be read</param>
+      /// <param name="target">Variable that will receive the attribute's value</param>
+      public: template<typename TValue>
+      AttributeBinding(const std::string &name, TValue &target) :
+        name(name),
+        target(static_cast<void *>(&target)),
+        read(&readValue<TValue>) {}
+
+      /// <summary>Retrieves the name of the bound attribute</summary>
+      /// <returns>The name of the attribute the binding is for</returns>
+      public: const std::string &GetName() const { return this->name; }
+
+      /// <summary>Reads the value of the entered attribute into the bound variable</summary>
+      /// <param name="reader">Reader that has entered the bound attribute</param>
+      public: void Read(XmlReader &reader) const { this->read(reader, this->target); }
+
+      /// <summary>Reads a value of the specified type from an XML reader</summary>
+      /// <typeparam name="TValue">Type of value that will be read</typeparam>
+      /// <param name="reader">Reader from which the value will be read</param>
+      /// <param name="target">Address of the variable that will receive the value</param>
+      private: template<typename TValue>
+      static void readValue(XmlReader &reader, void *target) {
+        reader.Read(*static_cast<TValue *>(target));
+      }
+
+      /// <summary>Name of the attribute whose value will be read</summary>
+      private: const std::string &name;
+      /// <summary>Variable that will receive the attribute's value</summary>
+      private: void *target;
+      /// <summary>Reads the attribute into the variable with the right type</summary>
+      private: void (*read)(XmlReader &reader, void *target);
+
+    };
+
+    #pragma endregion // class AttributeBinding
+
     /// <summary>Destroys the XML reader</summary>
     public: NUCLEX_STORAGE_API virtual ~XmlReader() {}
 
@@ -149,6 +199,37 @@ namespace Nuclex { namespace Storage { namespace Xml {
       }
     }
 
+    /// <summary>Reads several attributes of the current element at once</summary>
+    /// <param name="bindings">Attribute names and the variables receiving their values</param>
+    /// <returns>The number of bound attributes that were present in the element</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Variables whose attributes are missing from the element are left untouched,
+    ///     so they can be initialized with default values before the call:
+    ///   </para>
+    ///   <code>
+    ///     std::uint32_t width = 0, height = 0;
+    ///     reader.ReadAttributes({ { widthName, width }, { heightName, height } });
+    ///   </code>
+    ///   <para>
+    ///     Readers that intern their names (like <see cref="XmlBlobReader" />) find
+    ///     attributes faster if the bindings use the interned names, for example
+    ///     a static Nuclex::Support::Text::InternedString per attribute name.
+    ///   </para>
+    /// </remarks>
+    public: std::size_t ReadAttributes(std::initializer_list<AttributeBinding> bindings) {
+      std::size_t foundAttributeCount = 0;
+      for(const AttributeBinding &binding : bindings) {
+        if(TryEnterAttribute(binding.GetName())) {
+          AttributeScope scope(*this);
+          binding.Read(*this);
+          ++foundAttributeCount;
+        }
+      }
+
+      return foundAttributeCount;
+    }
+
     // Unhide the overloaded Read() methods in the base class
     // See http://www.parashift.com/c++-faq-lite/strange-inheritance.html#faq-23.9
     using Reader::Read;
@@ -0,0 +1,564 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_XMLSERIALIZATION_H
+#define NUCLEX_STORAGE_XML_XMLSERIALIZATION_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/FieldList.h"
+#include "Nuclex/Storage/Xml/XmlReader.h"
+#include "Nuclex/Storage/Xml/XmlWriter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Whether XML readers and writers can store a type in an attribute</summary>
+  /// <typeparam name="TValue">Type that will be checked</typeparam>
+  template<typename TValue> struct IsXmlPrimitive : std::false_type {};
+  template<> struct IsXmlPrimitive<bool> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::uint8_t> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::int8_t> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::uint16_t> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::int16_t> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::uint32_t> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::int32_t> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::uint64_t> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::int64_t> : std::true_type {};
+  template<> struct IsXmlPrimitive<float> : std::true_type {};
+  template<> struct IsXmlPrimitive<double> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::string> : std::true_type {};
+  template<> struct IsXmlPrimitive<std::wstring> : std::true_type {};
+
+  // ------------------------------------------------------------------------------------------- //
+
+  namespace Private {
+
+    /// <summary>Name of the elements that store the items of a vector or array</summary>
+    const char ItemElementName[] = u8"Item";
+    /// <summary>Name of the attribute that stores a primitive value in an element</summary>
+    const char ValueAttributeName[] = u8"Value";
+    /// <summary>Name of the attribute that stores the length of binary data</summary>
+    const char CountAttributeName[] = u8"Count";
+
+    /// <summary>Whether a type is a single byte that is written as binary data</summary>
+    /// <typeparam name="TValue">Type that will be checked</typeparam>
+    template<typename TValue>
+    struct IsByte : std::integral_constant<
+      bool,
+      std::is_same<TValue, std::uint8_t>::value || std::is_same<TValue, std::int8_t>::value
+    > {};
+
+    /// <summary>Reads from the XML reader until the current element has been closed</summary>
+    /// <param name="reader">Reader that will be advanced to the end of the element</param>
+    inline void skipElement(XmlReader &reader) {
+      std::size_t depth = 1;
+      for(;;) {
+        switch(reader.Read()) {
+          case XmlReadEvent::ElementStart: { ++depth; break; }
+          case XmlReadEvent::ElementEnd: {
+            --depth;
+            if(depth == 0) {
+              return;
+            }
+            break;
+          }
+          case XmlReadEvent::End: {
+            throw std::runtime_error(u8"XML document ended inside of an element");
+          }
+          default: { break; }
+        }
+      }
+    }
+
+    /// <summary>Stores values in and loads them from the current XML element</summary>
+    /// <typeparam name="TValue">Type of value that will be serialized</typeparam>
+    /// <remarks>
+    ///   Each specialization provides a method that writes the value's attributes and
+    ///   children into an open element and a method that reads them back, starting
+    ///   right after the element was entered and ending after it was closed.
+    /// </remarks>
+    template<typename TValue, typename TEnable = void>
+    struct ValueSerializer {
+      static_assert(
+        IsXmlPrimitive<TValue>::value || HasFieldList<TValue>::value,
+        "Only primitive types, structures with field lists and vectors or arrays "
+        "of those can be serialized to XML"
+      );
+    };
+
+    /// <summary>Stores primitive values in an attribute of their element</summary>
+    /// <typeparam name="TValue">Type of value that will be serialized</typeparam>
+    template<typename TValue>
+    struct ValueSerializer<TValue, typename std::enable_if<IsXmlPrimitive<TValue>::value>::type> {
+
+      /// <summary>Writes the value into the current element</summary>
+      /// <param name="writer">Writer through which the value will be written</param>
+      /// <param name="value">Value that will be written</param>
+      inline static void _(XmlWriter &writer, const TValue &value) {
+        writer.SetAttributeValue(ValueAttributeName, value);
+      }
+
+      /// <summary>Reads the value from the current element</summary>
+      /// <param name="reader">Reader through which the value will be read</param>
+      /// <param name="value">Receives the value, left untouched if it is missing</param>
+      inline static void _(XmlReader &reader, TValue &value) {
+        if(reader.TryEnterAttribute(ValueAttributeName)) {
+          XmlReader::AttributeScope scope(reader);
+          reader.Read(value);
+        }
+        skipElement(reader);
+      }
+
+    };
+
+    /// <summary>Stores a field of a structure as an attribute or as a child element</summary>
+    /// <typeparam name="IsAttribute">Whether the field is stored as an attribute</typeparam>
+    template<bool IsAttribute>
+    struct FieldSerializer {
+
+      /// <summary>Writes the field if it is stored as an attribute</summary>
+      /// <param name="writer">Writer through which the field will be written</param>
+      /// <param name="name">Name of the attribute the field is stored in</param>
+      /// <param name="value">Value of the field that will be written</param>
+      template<typename TValue>
+      inline static void WriteAttribute(
+        XmlWriter &writer, const char *name, const TValue &value
+      ) {
+        writer.SetAttributeValue(name, value);
+      }
+
+      /// <summary>Writes the field if it is stored as a child element</summary>
+      /// <param name="writer">Writer through which the field will be written</param>
+      /// <param name="name">Name of the child element the field is stored in</param>
+      /// <param name="value">Value of the field that will be written</param>
+      template<typename TValue>
+      inline static void WriteChild(XmlWriter &, const char *, const TValue &) {}
+
+      /// <summary>Reads the field if it is stored as an attribute</summary>
+      /// <param name="reader">Reader through which the field will be read</param>
+      /// <param name="name">Name of the attribute the field is stored in</param>
+      /// <param name="value">Receives the field's value, left untouched if it is missing</param>
+      template<typename TValue>
+      inline static void ReadAttribute(XmlReader &reader, const char *name, TValue &value) {
+        if(reader.TryEnterAttribute(name)) {
+          XmlReader::AttributeScope scope(reader);
+          reader.Read(value);
+        }
+      }
+
+      /// <summary>Reads the field if it is stored in the current child element</summary>
+      /// <param name="reader">Reader through which the field will be read</param>
+      /// <param name="name">Name of the child element the field is stored in</param>
+      /// <param name="value">Receives the field's value</param>
+      /// <returns>True if the field was stored in the current child element</returns>
+      template<typename TValue>
+      inline static bool TryReadChild(XmlReader &, const char *, TValue &) {
+        return false;
+      }
+
+    };
+
+    /// <summary>Stores a field of a structure as a child element</summary>
+    template<>
+    struct FieldSerializer<false> {
+
+      /// <summary>Writes the field if it is stored as an attribute</summary>
+      /// <param name="writer">Writer through which the field will be written</param>
+      /// <param name="name">Name of the attribute the field is stored in</param>
+      /// <param name="value">Value of the field that will be written</param>
+      template<typename TValue>
+      inline static void WriteAttribute(XmlWriter &, const char *, const TValue &) {}
+
+      /// <summary>Writes the field if it is stored as a child element</summary>
+      /// <param name="writer">Writer through which the field will be written</param>
+      /// <param name="name">Name of the child element the field is stored in</param>
+      /// <param name="value">Value of the field that will be written</param>
+      template<typename TValue>
+      inline static void WriteChild(XmlWriter &writer, const char *name, const TValue &value) {
+        XmlWriter::ElementScope scope(writer, name);
+        ValueSerializer<TValue>::_(writer, value);
+      }
+
+      /// <summary>Reads the field if it is stored as an attribute</summary>
+      /// <param name="reader">Reader through which the field will be read</param>
+      /// <param name="name">Name of the attribute the field is stored in</param>
+      /// <param name="value">Receives the field's value, left untouched if it is missing</param>
+      template<typename TValue>
+      inline static void ReadAttribute(XmlReader &, const char *, TValue &) {}
+
+      /// <summary>Reads the field if it is stored in the current child element</summary>
+      /// <param name="reader">Reader through which the field will be read</param>
+      /// <param name="name">Name of the child element the field is stored in</param>
+      /// <param name="value">Receives the field's value</param>
+      /// <returns>True if the field was stored in the current child element</returns>
+      template<typename TValue>
+      inline static bool TryReadChild(XmlReader &reader, const char *name, TValue &value) {
+        if(reader.GetElementName() != name) {
+          return false;
+        }
+
+        ValueSerializer<TValue>::_(reader, value);
+        return true;
+      }
+
+    };
+
+    /// <summary>Stores structures with field lists as attributes and child elements</summary>
+    /// <typeparam name="TValue">Type of structure that will be serialized</typeparam>
+    template<typename TValue>
+    struct ValueSerializer<TValue, typename std::enable_if<HasFieldList<TValue>::value>::type> {
+
+      /// <summary>Writes the structure's fields into the current element</summary>
+      /// <param name="writer">Writer through which the structure will be written</param>
+      /// <param name="value">Structure that will be written</param>
+      inline static void _(XmlWriter &writer, const TValue &value) {
+        // Attributes have to be written before the first child element is opened
+        ForEachField(
+          TValue::GetFields(),
+          [&writer, &value](const auto &field) {
+            typedef typename std::decay<decltype(field)>::type::ValueType FieldValueType;
+            FieldSerializer<IsXmlPrimitive<FieldValueType>::value>::WriteAttribute(
+              writer, field.Name, value.*(field.Member)
+            );
+          }
+        );
+        ForEachField(
+          TValue::GetFields(),
+          [&writer, &value](const auto &field) {
+            typedef typename std::decay<decltype(field)>::type::ValueType FieldValueType;
+            FieldSerializer<IsXmlPrimitive<FieldValueType>::value>::WriteChild(
+              writer, field.Name, value.*(field.Member)
+            );
+          }
+        );
+      }
+
+      /// <summary>Reads the structure's fields from the current element</summary>
+      /// <param name="reader">Reader through which the structure will be read</param>
+      /// <param name="value">Receives the fields, missing fields are left untouched</param>
+      inline static void _(XmlReader &reader, TValue &value) {
+        ForEachField(
+          TValue::GetFields(),
+          [&reader, &value](const auto &field) {
+            typedef typename std::decay<decltype(field)>::type::ValueType FieldValueType;
+            FieldSerializer<IsXmlPrimitive<FieldValueType>::value>::ReadAttribute(
+              reader, field.Name, value.*(field.Member)
+            );
+          }
+        );
+
+        for(;;) {
+          switch(reader.Read()) {
+            case XmlReadEvent::ElementStart: {
+              bool isKnownChild = false;
+              ForEachField(
+                TValue::GetFields(),
+                [&reader, &value, &isKnownChild](const auto &field) {
+                  typedef typename std::decay<decltype(field)>::type::ValueType FieldValueType;
+                  if(!isKnownChild) {
+                    isKnownChild = (
+                      FieldSerializer<IsXmlPrimitive<FieldValueType>::value>::TryReadChild(
+                        reader, field.Name, value.*(field.Member)
+                      )
+                    );
+                  }
+                }
+              );
+              if(!isKnownChild) {
+                skipElement(reader); // Unknown elements are ignored
+              }
+              break;
+            }
+            case XmlReadEvent::ElementEnd: { return; }
+            case XmlReadEvent::End: {
+              throw std::runtime_error(u8"XML document ended inside of an element");
+            }
+            default: { break; } // Text between child elements is ignored
+          }
+        }
+      }
+
+    };
+
+    /// <summary>Stores sequences of bytes as binary data in their element</summary>
+    struct ByteSerializer {
+
+      /// <summary>Writes the bytes into the current element</summary>
+      /// <param name="writer">Writer through which the bytes will be written</param>
+      /// <param name="bytes">Bytes that will be written</param>
+      /// <param name="count">Number of bytes that will be written</param>
+      inline static void _(XmlWriter &writer, const void *bytes, std::size_t count) {
+        writer.SetAttributeValue(CountAttributeName, static_cast<std::uint64_t>(count));
+        if(count > 0) {
+          writer.Write(bytes, count);
+        }
+      }
+
+      /// <summary>Reads the bytes from the current element</summary>
+      /// <param name="reader">Reader through which the bytes will be read</param>
+      /// <param name="bytes">Receives the bytes</param>
+      /// <param name="count">Number of bytes that will be read</param>
+      inline static void _(XmlReader &reader, void *bytes, std::size_t count) {
+        bool hasRead = (count == 0);
+        for(;;) {
+          switch(reader.Read()) {
+            case XmlReadEvent::Content: {
+              if(!hasRead) {
+                reader.Read(bytes, count);
+                hasRead = true;
+              }
+              break;
+            }
+            case XmlReadEvent::ElementStart: { skipElement(reader); break; }
+            case XmlReadEvent::ElementEnd: {
+              if(!hasRead) {
+                throw std::runtime_error(u8"XML element is missing its binary data");
+              }
+              return;
+            }
+            case XmlReadEvent::End: {
+              throw std::runtime_error(u8"XML document ended inside of an element");
+            }
+            default: { break; }
+          }
+        }
+      }
+
+      /// <summary>Reads the number of bytes stored in the current element</summary>
+      /// <param name="reader">Reader through which the byte count will be read</param>
+      /// <returns>The number of bytes stored in the element</returns>
+      inline static std::size_t CountBytes(XmlReader &reader) {
+        std::uint64_t count = reader.GetAttributeValue<std::uint64_t>(
+          CountAttributeName, 0
+        );
+        return static_cast<std::size_t>(count);
+      }
+
+    };
+
+    /// <summary>Stores vectors of bytes as binary data in their element</summary>
+    /// <typeparam name="TElement">Type of the bytes in the vector</typeparam>
+    template<typename TElement>
+    struct ValueSerializer<
+      std::vector<TElement>, typename std::enable_if<IsByte<TElement>::value>::type
+    > {
+
+      /// <summary>Writes the bytes into the current element</summary>
+      /// <param name="writer">Writer through which the bytes will be written</param>
+      /// <param name="values">Bytes that will be written</param>
+      inline static void _(XmlWriter &writer, const std::vector<TElement> &values) {
+        ByteSerializer::_(writer, values.data(), values.size());
+      }
+
+      /// <summary>Reads the bytes from the current element</summary>
+      /// <param name="reader">Reader through which the bytes will be read</param>
+      /// <param name="values">Receives the bytes</param>
+      inline static void _(XmlReader &reader, std::vector<TElement> &values) {
+        values.resize(ByteSerializer::CountBytes(reader));
+        ByteSerializer::_(reader, values.data(), values.size());
+      }
+
+    };
+
+    /// <summary>Stores arrays of bytes as binary data in their element</summary>
+    /// <typeparam name="TElement">Type of the bytes in the array</typeparam>
+    /// <typeparam name="ElementCount">Number of bytes in the array</typeparam>
+    template<typename TElement, std::size_t ElementCount>
+    struct ValueSerializer<
+      TElement[ElementCount], typename std::enable_if<IsByte<TElement>::value>::type
+    > {
+
+      /// <summary>Writes the bytes into the current element</summary>
+      /// <param name="writer">Writer through which the bytes will be written</param>
+      /// <param name="values">Bytes that will be written</param>
+      inline static void _(XmlWriter &writer, const TElement (&values)[ElementCount]) {
+        ByteSerializer::_(writer, values, ElementCount);
+      }
+
+      /// <summary>Reads the bytes from the current element</summary>
+      /// <param name="reader">Reader through which the bytes will be read</param>
+      /// <param name="values">Receives the bytes</param>
+      inline static void _(XmlReader &reader, TElement (&values)[ElementCount]) {
+        if(ByteSerializer::CountBytes(reader) != ElementCount) {
+          throw std::runtime_error(u8"XML element holds the wrong number of bytes");
+        }
+        ByteSerializer::_(reader, values, ElementCount);
+      }
+
+    };
+
+    /// <summary>Stores vectors of values as a series of child elements</summary>
+    /// <typeparam name="TElement">Type of the values in the vector</typeparam>
+    template<typename TElement>
+    struct ValueSerializer<
+      std::vector<TElement>, typename std::enable_if<!IsByte<TElement>::value>::type
+    > {
+      static_assert(
+        !std::is_same<TElement, bool>::value,
+        "std::vector<bool> can not be serialized, use a vector of bytes instead"
+      );
+
+      /// <summary>Writes the values into the current element</summary>
+      /// <param name="writer">Writer through which the values will be written</param>
+      /// <param name="values">Values that will be written</param>
+      inline static void _(XmlWriter &writer, const std::vector<TElement> &values) {
+        for(const TElement &value : values) {
+          XmlWriter::ElementScope scope(writer, ItemElementName);
+          ValueSerializer<TElement>::_(writer, value);
+        }
+      }
+
+      /// <summary>Reads the values from the current element</summary>
+      /// <param name="reader">Reader through which the values will be read</param>
+      /// <param name="values">Receives the values</param>
+      inline static void _(XmlReader &reader, std::vector<TElement> &values) {
+        values.clear();
+        for(;;) {
+          switch(reader.Read()) {
+            case XmlReadEvent::ElementStart: {
+              if(reader.GetElementName() == ItemElementName) {
+                values.emplace_back();
+                ValueSerializer<TElement>::_(reader, values.back());
+              } else {
+                skipElement(reader);
+              }
+              break;
+            }
+            case XmlReadEvent::ElementEnd: { return; }
+            case XmlReadEvent::End: {
+              throw std::runtime_error(u8"XML document ended inside of an element");
+            }
+            default: { break; }
+          }
+        }
+      }
+
+    };
+
+    /// <summary>Stores arrays of values as a series of child elements</summary>
+    /// <typeparam name="TElement">Type of the values in the array</typeparam>
+    /// <typeparam name="ElementCount">Number of values in the array</typeparam>
+    template<typename TElement, std::size_t ElementCount>
+    struct ValueSerializer<
+      TElement[ElementCount], typename std::enable_if<!IsByte<TElement>::value>::type
+    > {
+
+      /// <summary>Writes the values into the current element</summary>
+      /// <param name="writer">Writer through which the values will be written</param>
+      /// <param name="values">Values that will be written</param>
+      inline static void _(XmlWriter &writer, const TElement (&values)[ElementCount]) {
+        for(std::size_t index = 0; index < ElementCount; ++index) {
+          XmlWriter::ElementScope scope(writer, ItemElementName);
+          ValueSerializer<TElement>::_(writer, values[index]);
+        }
+      }
+
+      /// <summary>Reads the values from the current element</summary>
+      /// <param name="reader">Reader through which the values will be read</param>
+      /// <param name="values">Receives the values, surplus items are ignored</param>
+      inline static void _(XmlReader &reader, TElement (&values)[ElementCount]) {
+        std::size_t index = 0;
+        for(;;) {
+          switch(reader.Read()) {
+            case XmlReadEvent::ElementStart: {
+              if((index < ElementCount) && (reader.GetElementName() == ItemElementName)) {
+                ValueSerializer<TElement>::_(reader, values[index]);
+                ++index;
+              } else {
+                skipElement(reader);
+              }
+              break;
+            }
+            case XmlReadEvent::ElementEnd: { return; }
+            case XmlReadEvent::End: {
+              throw std::runtime_error(u8"XML document ended inside of an element");
+            }
+            default: { break; }
+          }
+        }
+      }
+
+    };
+
+  } // namespace Private
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a value as an XML element</summary>
+  /// <typeparam name="TValue">Type of value that will be written</typeparam>
+  /// <param name="writer">XML writer the element will be written to</param>
+  /// <param name="elementName">Name of the element that will be written</param>
+  /// <param name="value">Value that will be written into the element</param>
+  /// <remarks>
+  ///   <para>
+  ///     Structures providing a field list (see <see cref="NUCLEX_STORAGE_FIELD" />) turn
+  ///     into an element whose attributes hold the primitive fields. All other fields
+  ///     become child elements named after the field:
+  ///   </para>
+  ///   <list type="bullet">
+  ///     <item><description>
+  ///       Nested structures are stored like the outer structure.
+  ///     </description></item>
+  ///     <item><description>
+  ///       Vectors and arrays store each value in an 'Item' element, primitive values
+  ///       go into the item's 'Value' attribute.
+  ///     </description></item>
+  ///     <item><description>
+  ///       Vectors and arrays of bytes store their length in a 'Count' attribute and
+  ///       their contents as binary data (see <see cref="XmlWriter.SetBinaryFormat" />).
+  ///     </description></item>
+  ///   </list>
+  /// </remarks>
+  template<typename TValue>
+  inline void WriteElement(XmlWriter &writer, const std::string &elementName, const TValue &value) {
+    XmlWriter::ElementScope scope(writer, elementName);
+    Private::ValueSerializer<TValue>::_(writer, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a value from the XML element the reader has just entered</summary>
+  /// <typeparam name="TValue">Type of value that will be read</typeparam>
+  /// <param name="reader">XML reader the element will be read from</param>
+  /// <param name="value">Receives the value read from the element</param>
+  /// <remarks>
+  ///   Call this after <see cref="XmlReader.Read" /> returned an ElementStart event.
+  ///   The reader is advanced until the element has been closed. Fields missing from
+  ///   the element keep their current values and unknown attributes or child elements
+  ///   are ignored, so documents written by older or newer versions can still be read.
+  /// </remarks>
+  template<typename TValue>
+  inline void ReadElement(XmlReader &reader, TValue &value) {
+    Private::ValueSerializer<TValue>::_(reader, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_XMLSERIALIZATION_H
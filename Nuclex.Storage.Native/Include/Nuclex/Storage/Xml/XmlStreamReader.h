@@ -0,0 +1,226 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_XMLSTREAMREADER_H
+#define NUCLEX_STORAGE_XML_XMLSTREAMREADER_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Xml/XmlReader.h"
+#include "Nuclex/Storage/Xml/XmlBlobReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class InputStream;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads data from XML plaintext arriving through a stream</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Unlike the <see cref="XmlBlobReader" />, this reader doesn't need to know how long
+  ///     the document is or to access it at random. Whatever the stream can provide
+  ///     is handed to the XML parser right away and the reader only waits on the stream
+  ///     when the parser has consumed everything that arrived so far. Reading XML from
+  ///     a socket or a decompressor thus proceeds while the rest of the data is still
+  ///     being received or decompressed.
+  ///   </para>
+  ///   <para>
+  ///     The document ends when the stream reports its end. The reader does not own
+  ///     the stream beyond keeping it alive and reads from it on the calling thread.
+  ///   </para>
+  /// </remarks>
+  class XmlStreamReader : public XmlReader {
+
+    /// <summary>Number of bytes handed to the XML parser at once by default</summary>
+    public: static const std::size_t DefaultChunkByteCount = 64 * 1024;
+
+    /// <summary>Initializes a new XML reader reading from a stream</summary>
+    /// <param name="stream">Stream the XML reader will read from</param>
+    /// <param name="chunkByteCount">Most bytes handed to the XML parser at once</param>
+    public: NUCLEX_STORAGE_API XmlStreamReader(
+      const std::shared_ptr<Binary::InputStream> &stream,
+      std::size_t chunkByteCount = DefaultChunkByteCount
+    );
+
+    /// <summary>Destroys the XML reader</summary>
+    public: NUCLEX_STORAGE_API virtual ~XmlStreamReader();
+
+    /// <summary>Starts over, reading another XML document</summary>
+    /// <param name="stream">Stream the XML reader will read from</param>
+    /// <remarks>
+    ///   The XML parser, its buffer and the interned names are reused instead of being
+    ///   set up from scratch. Interned names returned earlier stay valid.
+    ///   The binary format is kept.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API void Reset(const std::shared_ptr<Binary::InputStream> &stream);
+
+    /// <summary>Retrieves the currently selected binary data format</summary>
+    /// <returns>The format in which binary data will be read</returns>
+    public: NUCLEX_STORAGE_API XmlBinaryFormat GetBinaryFormat() const {
+      return this->binaryFormat;
+    }
+
+    /// <summary>Selects the binary data format to use for reading binary data</summary>
+    /// <param name="newBinaryFormat">Format in which binary data will be read</param>
+    public: NUCLEX_STORAGE_API void SetBinaryFormat(XmlBinaryFormat newBinaryFormat) {
+      this->binaryFormat = newBinaryFormat;
+    }
+
+    /// <summary>Reads from XML plaintext up until the next event is encountered</summary>
+    /// <returns>The type of event encountered when parsing</returns>
+    /// <remarks>
+    ///   Blocks if the parser needs more data and the stream has none available yet.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API XmlReadEvent Read();
+
+    /// <summary>Retrieves the name of the last element that was entered or exited</summary>
+    /// <returns>The name of the last element entered or exited</returns>
+    /// <remarks>
+    ///   Names are interned just like with the <see cref="XmlBlobReader" />, so they can
+    ///   be compared by address against handles obtained via <see cref="InternName" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API const std::string &GetElementName() const;
+
+    /// <summary>Counts the number of attributes in the current element</summary>
+    /// <returns>The number of attributes present in the current element</summary>
+    public: NUCLEX_STORAGE_API std::size_t CountAttributes() const;
+
+    /// <summary>Retrieves the name of the attribute with the specified index</summary>
+    /// <param name="index">Index of the attribue whose name will be looked up</param>
+    /// <returns>The name of the attribute with the specified index</returns>
+    public: NUCLEX_STORAGE_API const std::string &GetAttributeName(std::size_t index) const;
+
+    /// <summary>Retrieves the value of the attribute with the specified index</summary>
+    /// <param name="index">Index of the attribue whose value will be looked up</param>
+    /// <returns>The value of the attribute with the specified index</returns>
+    /// <remarks>
+    ///   The returned string is reused for the next element and is only valid until
+    ///   the next call to <see cref="Read" />.
+    /// </remarks>
+    public: NUCLEX_STORAGE_API const std::string &GetAttributeValue(std::size_t index) const;
+
+    /// <summary>Looks up the interned copy of an element or attribute name</summary>
+    /// <param name="name">Name whose interned copy will be returned</param>
+    /// <returns>
+    ///   The string instance that <see cref="GetElementName" /> and
+    ///   <see cref="GetAttributeName" /> will return for this name
+    /// </returns>
+    public: NUCLEX_STORAGE_API const std::string &InternName(const std::string &name);
+
+    /// <summary>Try to enter the attribute with the specified name</summary>
+    /// <param name="attributeName">Name of the attribute that will be entered</param>
+    /// <returns>True if the attribute existed and was entered, otherwise false</returns>
+    public: NUCLEX_STORAGE_API bool TryEnterAttribute(const std::string &attributeName);
+
+    /// <summary>Leaves the currently entered attribute again</summary>
+    public: NUCLEX_STORAGE_API void LeaveAttribute();
+
+    /// <summary>Reads a boolean from the stream</summary>
+    /// <param name="target">Address of a boolean the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(bool &target);
+
+    /// <summary>Reads an unsigned 8 bit integer from the stream</summary>
+    /// <param name="target">Address of an 8 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint8_t &target);
+
+    /// <summary>Reads a signed 8 bit integer from the stream</summary>
+    /// <param name="target">Address of an 8 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int8_t &target);
+
+    /// <summary>Reads an unsigned 16 bit integer from the stream</summary>
+    /// <param name="target">Address of a 16 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint16_t &target);
+
+    /// <summary>Reads a signed 16 bit integer from the stream</summary>
+    /// <param name="target">Address of a 16 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int16_t &target);
+
+    /// <summary>Reads an unsigned 32 bit integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint32_t &target);
+
+    /// <summary>Reads a signed 32 bit integer from the stream</summary>
+    /// <param name="target">Address of a 32 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int32_t &target);
+
+    /// <summary>Reads an unsigned 64 bit integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::uint64_t &target);
+
+    /// <summary>Reads a signed 64 bit integer from the stream</summary>
+    /// <param name="target">Address of a 64 bit integer the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::int64_t &target);
+
+    /// <summary>Reads a floating point value from the stream</summary>
+    /// <param name="target">Address of a floating point value that will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(float &target);
+
+    /// <summary>Reads a double precision floating point value from the stream</summary>
+    /// <param name="target">
+    ///   Address of a double precision floating point value that will be read into
+    /// </param>
+    public: NUCLEX_STORAGE_API void Read(double &target);
+
+    /// <summary>Reads a string from the stream</summary>
+    /// <param name="target">Address of a string the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::string &target);
+
+    /// <summary>Reads a unicode string from the stream</summary>
+    /// <param name="target">Address of a unicode string the value will be read into</param>
+    public: NUCLEX_STORAGE_API void Read(std::wstring &target);
+
+    /// <summary>Reads a chunk of bytes from the stream</summary>
+    /// <param name="buffer">Buffer the bytes will be read into</param>
+    /// <param name="byteCount">Number of bytes that will be read from the stream</param>
+    public: NUCLEX_STORAGE_API void Read(void *buffer, std::size_t byteCount);
+
+    // Unhide the overloaded Read() methods in the base class
+    // See http://www.parashift.com/c++-faq-lite/strange-inheritance.html#faq-23.9
+    using XmlReader::Read;
+
+    /// <summary>The stream being parsed</summary>
+    private: std::shared_ptr<Binary::InputStream> stream;
+    /// <summary>Implementation details, shared with the XML blob reader</summary>
+    private: std::unique_ptr<XmlBlobReader::Impl> impl;
+
+    /// <summary>Binary data format currently used by the XML reader</summary>
+    private: XmlBinaryFormat binaryFormat;
+    /// <summary>Value of the attribute the reader has entered</summary>
+    private: const std::string *enteredAttribute;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_XMLSTREAMREADER_H
@@ -0,0 +1,712 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "AsyncFileIo.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+
+#include <cstring> // for std::memset()
+#include <exception> // for std::exception_ptr, std::make_exception_ptr()
+#include <stdexcept> // for std::out_of_range
+#include <system_error> // for std::system_error
+
+#if defined(NUCLEX_STORAGE_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h> // for CreateIoCompletionPort(), ReadFile(), WriteFile()
+#undef min
+#undef max
+#else
+#include <cerrno> // for errno
+#include <linux/io_uring.h> // for io_uring_params, io_uring_sqe, io_uring_cqe
+#include <sys/mman.h> // for mmap(), munmap()
+#include <sys/syscall.h> // for __NR_io_uring_setup, __NR_io_uring_enter
+#include <sys/uio.h> // for iovec
+#include <unistd.h> // for syscall(), close()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Error code used to report that a read hit the end of the file</summary>
+  const int EndOfFileErrorCode = -1;
+
+  /// <summary>Largest number of bytes transferred by a single read or write</summary>
+  /// <remarks>
+  ///   Linux clamps reads and writes to slightly below 2 GiB and the Windows API takes
+  ///   32 bit lengths, so larger operations are split into several transfers.
+  /// </remarks>
+  const std::size_t MaximumTransferByteCount = 1024 * 1024 * 1024;
+
+#if defined(NUCLEX_STORAGE_WIN32)
+  /// <summary>Completion key posted to the completion port to stop the thread</summary>
+  const ULONG_PTR StopCompletionKey = 1;
+
+  /// <summary>Maximum number of operations in flight at once</summary>
+  const std::size_t OperationLimit = 256;
+#else
+  /// <summary>Number of entries requested for the submission ring</summary>
+  const unsigned SubmissionEntryCount = 128;
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds the exception for an operation that has failed</summary>
+  /// <param name="errorCode">Error code reported by the operating system</param>
+  /// <returns>An exception pointer to the exception describing the error</returns>
+  std::exception_ptr makeException(int errorCode) {
+    if(errorCode == EndOfFileErrorCode) {
+      return std::make_exception_ptr(
+        std::out_of_range(u8"Attempted read past the end of the file blob")
+      );
+    }
+
+#if defined(NUCLEX_STORAGE_WIN32)
+    return std::make_exception_ptr(
+      std::system_error(errorCode, std::system_category(), u8"Asynchronous file access failed")
+    );
+#else
+    return std::make_exception_ptr(
+      std::system_error(errorCode, std::generic_category(), u8"Asynchronous file access failed")
+    );
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_IO_URING)
+
+  /// <summary>Creates a new io_uring</summary>
+  /// <param name="entryCount">Number of entries the submission ring should have</param>
+  /// <param name="parameters">Receives the parameters of the created ring</param>
+  /// <returns>The file descriptor of the io_uring or -1 on failure</returns>
+  int setupIoUring(unsigned entryCount, ::io_uring_params &parameters) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entryCount, &parameters));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Submits queued entries and optionally waits for completions</summary>
+  /// <param name="ringDescriptor">File descriptor of the io_uring</param>
+  /// <param name="submitCount">Number of queued entries that will be submitted</param>
+  /// <param name="waitCount">Number of completions to wait for</param>
+  /// <param name="flags">Flags controlling the behavior of the call</param>
+  /// <returns>The number of entries submitted or -1 on failure</returns>
+  int enterIoUring(
+    int ringDescriptor, unsigned submitCount, unsigned waitCount, unsigned flags
+  ) {
+    return static_cast<int>(
+      ::syscall(__NR_io_uring_enter, ringDescriptor, submitCount, waitCount, flags, nullptr, 0)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Maps part of an io_uring's memory into the process</summary>
+  /// <param name="ringDescriptor">File descriptor of the io_uring</param>
+  /// <param name="byteCount">Number of bytes that will be mapped</param>
+  /// <param name="offset">Magic offset selecting the part that will be mapped</param>
+  /// <returns>The address at which the memory was mapped</returns>
+  void *mapIoUring(int ringDescriptor, std::size_t byteCount, off_t offset) {
+    void *memory = ::mmap(
+      nullptr, byteCount, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ringDescriptor, offset
+    );
+    if(memory == MAP_FAILED) {
+      int errorNumber = errno;
+      throw std::system_error(
+        errorNumber, std::generic_category(), u8"Could not map the io_uring into memory"
+      );
+    }
+
+    return memory;
+  }
+
+#endif // defined(NUCLEX_STORAGE_HAVE_IO_URING)
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct AsyncFileIo::Operation {
+
+#if defined(NUCLEX_STORAGE_WIN32)
+    /// <summary>Tells Windows where to transfer data, must be the first member</summary>
+    public: OVERLAPPED Overlapped;
+#else
+    /// <summary>Tells the kernel where to the data is transferred from or to</summary>
+    public: ::iovec Vector;
+#endif
+    /// <summary>Promise that will be fulfilled when the operation completes</summary>
+    public: std::promise<void> Completion;
+    /// <summary>Buffer position the next transfer will write to or read from</summary>
+    public: std::uint8_t *Buffer;
+    /// <summary>File position the next transfer will begin at</summary>
+    public: std::uint64_t Location;
+    /// <summary>Number of bytes that remain to be transferred</summary>
+    public: std::size_t RemainingByteCount;
+    /// <summary>Whether the data is written to the file instead of read</summary>
+    public: bool IsWrite;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_WIN32)
+
+  AsyncFileIo::AsyncFileIo(FileHandle file) :
+    file(file),
+    operationLimit(OperationLimit),
+    operationCount(0),
+    mutex(),
+    operationFinished(),
+    thread(),
+    completionPort(nullptr) {
+    this->completionPort = ::CreateIoCompletionPort(file, nullptr, 0, 1);
+    if(this->completionPort == nullptr) {
+      DWORD lastErrorCode = ::GetLastError();
+      throw std::system_error(
+        static_cast<int>(lastErrorCode), std::system_category(),
+        u8"Could not associate the file with an I/O completion port"
+      );
+    }
+
+    this->thread = std::thread(&AsyncFileIo::completionThread, this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AsyncFileIo::~AsyncFileIo() {
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      while(this->operationCount > 0) {
+        this->operationFinished.wait(lock);
+      }
+    }
+
+    ::PostQueuedCompletionStatus(this->completionPort, 0, StopCompletionKey, nullptr);
+    this->thread.join();
+    ::CloseHandle(this->completionPort);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AsyncFileIo::issue(Operation *operation) {
+    std::size_t transferByteCount = operation->RemainingByteCount;
+    if(transferByteCount > MaximumTransferByteCount) {
+      transferByteCount = MaximumTransferByteCount;
+    }
+
+    std::memset(&operation->Overlapped, 0, sizeof(operation->Overlapped));
+    operation->Overlapped.Offset = static_cast<DWORD>(operation->Location);
+    operation->Overlapped.OffsetHigh = static_cast<DWORD>(operation->Location >> 32);
+
+    BOOL result;
+    if(operation->IsWrite) {
+      result = ::WriteFile(
+        this->file, operation->Buffer, static_cast<DWORD>(transferByteCount),
+        nullptr, &operation->Overlapped
+      );
+    } else {
+      result = ::ReadFile(
+        this->file, operation->Buffer, static_cast<DWORD>(transferByteCount),
+        nullptr, &operation->Overlapped
+      );
+    }
+
+    // Even operations that complete right away post their result to the completion port
+    if(result == FALSE) {
+      DWORD lastErrorCode = ::GetLastError();
+      if(lastErrorCode != ERROR_IO_PENDING) {
+        int errorCode = static_cast<int>(lastErrorCode);
+        if(lastErrorCode == ERROR_HANDLE_EOF) {
+          errorCode = EndOfFileErrorCode;
+        }
+        operation->Completion.set_exception(makeException(errorCode));
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncFileIo::completionThread() {
+    for(;;) {
+      DWORD transferredByteCount;
+      ULONG_PTR completionKey;
+      LPOVERLAPPED overlapped;
+      BOOL result = ::GetQueuedCompletionStatus(
+        this->completionPort, &transferredByteCount, &completionKey, &overlapped, INFINITE
+      );
+      if(overlapped == nullptr) {
+        if((result == FALSE) || (completionKey == StopCompletionKey)) {
+          break;
+        }
+        continue;
+      }
+
+      Operation *operation = reinterpret_cast<Operation *>(overlapped);
+      if(result == FALSE) {
+        DWORD lastErrorCode = ::GetLastError();
+        int errorCode = static_cast<int>(lastErrorCode);
+        if(lastErrorCode == ERROR_HANDLE_EOF) {
+          errorCode = EndOfFileErrorCode;
+        }
+        complete(operation, 0, errorCode);
+      } else {
+        complete(operation, static_cast<std::size_t>(transferredByteCount), 0);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#else // Linux with io_uring
+
+  AsyncFileIo::AsyncFileIo(FileHandle file) :
+    file(file),
+    operationLimit(0),
+    operationCount(0),
+    mutex(),
+    operationFinished(),
+    thread(),
+    ringDescriptor(-1),
+    submissionRing(nullptr),
+    submissionRingByteCount(0),
+    completionRing(nullptr),
+    completionRingByteCount(0),
+    submissionEntries(nullptr),
+    submissionEntriesByteCount(0),
+    submissionHead(nullptr),
+    submissionTail(nullptr),
+    submissionMask(0),
+    submissionEntryCount(0),
+    submissionArray(nullptr),
+    completionHead(nullptr),
+    completionTail(nullptr),
+    completionMask(0),
+    completionEntries(nullptr),
+    queued() {
+    ::io_uring_params parameters;
+    std::memset(&parameters, 0, sizeof(parameters));
+
+    this->ringDescriptor = setupIoUring(SubmissionEntryCount, parameters);
+    if(this->ringDescriptor == -1) {
+      int errorNumber = errno;
+      throw std::system_error(
+        errorNumber, std::generic_category(), u8"Could not set up an io_uring"
+      );
+    }
+
+    try {
+      this->submissionRingByteCount = (
+        parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned)
+      );
+      this->completionRingByteCount = (
+        parameters.cq_off.cqes + parameters.cq_entries * sizeof(::io_uring_cqe)
+      );
+
+      // Newer kernels let both rings share one mapping, older ones need two
+      bool singleMapping = ((parameters.features & IORING_FEAT_SINGLE_MMAP) != 0);
+      if(singleMapping) {
+        if(this->completionRingByteCount > this->submissionRingByteCount) {
+          this->submissionRingByteCount = this->completionRingByteCount;
+        }
+        this->completionRingByteCount = 0;
+      }
+
+      this->submissionRing = mapIoUring(
+        this->ringDescriptor, this->submissionRingByteCount, IORING_OFF_SQ_RING
+      );
+      if(singleMapping) {
+        this->completionRing = this->submissionRing;
+      } else {
+        this->completionRing = mapIoUring(
+          this->ringDescriptor, this->completionRingByteCount, IORING_OFF_CQ_RING
+        );
+      }
+
+      this->submissionEntriesByteCount = parameters.sq_entries * sizeof(::io_uring_sqe);
+      this->submissionEntries = mapIoUring(
+        this->ringDescriptor, this->submissionEntriesByteCount, IORING_OFF_SQES
+      );
+    }
+    catch(...) {
+      if(this->submissionRing != nullptr) {
+        ::munmap(this->submissionRing, this->submissionRingByteCount);
+      }
+      if((this->completionRing != nullptr) && (this->completionRingByteCount > 0)) {
+        ::munmap(this->completionRing, this->completionRingByteCount);
+      }
+      ::close(this->ringDescriptor);
+      throw;
+    }
+
+    std::uint8_t *submissionRingBytes = static_cast<std::uint8_t *>(this->submissionRing);
+    this->submissionHead = reinterpret_cast<unsigned *>(
+      submissionRingBytes + parameters.sq_off.head
+    );
+    this->submissionTail = reinterpret_cast<unsigned *>(
+      submissionRingBytes + parameters.sq_off.tail
+    );
+    this->submissionMask = *reinterpret_cast<unsigned *>(
+      submissionRingBytes + parameters.sq_off.ring_mask
+    );
+    this->submissionEntryCount = parameters.sq_entries;
+    this->submissionArray = reinterpret_cast<unsigned *>(
+      submissionRingBytes + parameters.sq_off.array
+    );
+
+    std::uint8_t *completionRingBytes = static_cast<std::uint8_t *>(this->completionRing);
+    this->completionHead = reinterpret_cast<unsigned *>(
+      completionRingBytes + parameters.cq_off.head
+    );
+    this->completionTail = reinterpret_cast<unsigned *>(
+      completionRingBytes + parameters.cq_off.tail
+    );
+    this->completionMask = *reinterpret_cast<unsigned *>(
+      completionRingBytes + parameters.cq_off.ring_mask
+    );
+    this->completionEntries = completionRingBytes + parameters.cq_off.cqes;
+
+    // Never have more operations in flight than the completion ring can hold,
+    // so the kernel never has to drop or hold back completions.
+    this->operationLimit = parameters.cq_entries;
+
+    this->thread = std::thread(&AsyncFileIo::completionThread, this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AsyncFileIo::~AsyncFileIo() {
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      while(this->operationCount > 0) {
+        this->operationFinished.wait(lock);
+      }
+
+      // Queue a no-op without an operation attached, which tells the thread to stop
+      unsigned tail = *this->submissionTail;
+      unsigned index = tail & this->submissionMask;
+      ::io_uring_sqe *entry = static_cast<::io_uring_sqe *>(this->submissionEntries) + index;
+      std::memset(entry, 0, sizeof(::io_uring_sqe));
+      entry->opcode = IORING_OP_NOP;
+      entry->user_data = 0;
+      this->submissionArray[index] = index;
+      __atomic_store_n(this->submissionTail, tail + 1, __ATOMIC_RELEASE);
+
+      while(enterIoUring(this->ringDescriptor, 1, 0, 0) == -1) {
+        if((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY)) {
+          std::terminate(); // Without the no-op, the thread would never stop
+        }
+      }
+    }
+
+    this->thread.join();
+
+    ::munmap(this->submissionEntries, this->submissionEntriesByteCount);
+    if(this->completionRingByteCount > 0) {
+      ::munmap(this->completionRing, this->completionRingByteCount);
+    }
+    ::munmap(this->submissionRing, this->submissionRingByteCount);
+    ::close(this->ringDescriptor);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool AsyncFileIo::issue(Operation *operation) {
+    unsigned head = __atomic_load_n(this->submissionHead, __ATOMIC_ACQUIRE);
+    unsigned tail = *this->submissionTail;
+    if(tail - head >= this->submissionEntryCount) {
+      enterRing(); // Without a polling thread, the kernel consumes all entries right away
+      tail = *this->submissionTail;
+    }
+
+    std::size_t transferByteCount = operation->RemainingByteCount;
+    if(transferByteCount > MaximumTransferByteCount) {
+      transferByteCount = MaximumTransferByteCount;
+    }
+    operation->Vector.iov_base = operation->Buffer;
+    operation->Vector.iov_len = transferByteCount;
+
+    unsigned index = tail & this->submissionMask;
+    ::io_uring_sqe *entry = static_cast<::io_uring_sqe *>(this->submissionEntries) + index;
+    std::memset(entry, 0, sizeof(::io_uring_sqe));
+    entry->opcode = operation->IsWrite ? IORING_OP_WRITEV : IORING_OP_READV;
+    entry->fd = this->file;
+    entry->addr = reinterpret_cast<std::uintptr_t>(&operation->Vector);
+    entry->len = 1;
+    entry->off = operation->Location;
+    entry->user_data = reinterpret_cast<std::uintptr_t>(operation);
+
+    this->submissionArray[index] = index;
+    __atomic_store_n(this->submissionTail, tail + 1, __ATOMIC_RELEASE);
+    this->queued.push_back(operation);
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncFileIo::enterRing() {
+    while(!this->queued.empty()) {
+      int result = enterIoUring(
+        this->ringDescriptor, static_cast<unsigned>(this->queued.size()), 0, 0
+      );
+      if(result > 0) {
+        this->queued.erase(this->queued.begin(), this->queued.begin() + result);
+        continue;
+      }
+
+      int errorNumber = (result == 0) ? EAGAIN : errno;
+      if((errorNumber == EINTR) || (errorNumber == EAGAIN) || (errorNumber == EBUSY)) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // The kernel refused the entries, take them back out of the ring and fail them.
+      // We're holding the mutex here, so the operations are released directly.
+      std::size_t failedCount = this->queued.size();
+      __atomic_store_n(
+        this->submissionTail,
+        *this->submissionTail - static_cast<unsigned>(failedCount),
+        __ATOMIC_RELEASE
+      );
+      for(std::size_t index = 0; index < failedCount; ++index) {
+        this->queued[index]->Completion.set_exception(makeException(errorNumber));
+        delete this->queued[index];
+      }
+      this->queued.clear();
+      this->operationCount -= failedCount;
+      this->operationFinished.notify_all();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncFileIo::completionThread() {
+    for(;;) {
+      int result = enterIoUring(this->ringDescriptor, 0, 1, IORING_ENTER_GETEVENTS);
+      if(result == -1) {
+        if(errno != EINTR) {
+          std::this_thread::yield();
+        }
+        continue;
+      }
+
+      bool stopRequested = false;
+
+      unsigned head = *this->completionHead;
+      unsigned tail = __atomic_load_n(this->completionTail, __ATOMIC_ACQUIRE);
+      while(head != tail) {
+        ::io_uring_cqe *entry = static_cast<::io_uring_cqe *>(this->completionEntries) + (
+          head & this->completionMask
+        );
+        std::uint64_t userData = entry->user_data;
+        int transferResult = entry->res;
+
+        ++head;
+        __atomic_store_n(this->completionHead, head, __ATOMIC_RELEASE);
+
+        if(userData == 0) {
+          stopRequested = true;
+        } else {
+          Operation *operation = reinterpret_cast<Operation *>(
+            static_cast<std::uintptr_t>(userData)
+          );
+          if(transferResult < 0) {
+            complete(operation, 0, -transferResult);
+          } else {
+            complete(operation, static_cast<std::size_t>(transferResult), 0);
+          }
+        }
+      }
+
+      if(stopRequested) {
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#endif // Linux with io_uring
+
+  std::future<void> AsyncFileIo::Read(std::uint64_t location, void *buffer, std::size_t count) {
+    BlobReadRequest request;
+    request.Location = location;
+    request.Buffer = buffer;
+    request.Count = count;
+
+    std::vector<std::future<void>> completions = Read(&request, 1);
+    return std::move(completions[0]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::future<void>> AsyncFileIo::Read(
+    const BlobReadRequest *requests, std::size_t requestCount
+  ) {
+    std::vector<std::future<void>> completions;
+    completions.reserve(requestCount);
+
+    std::vector<Operation *> operations;
+    operations.reserve(requestCount);
+    try {
+      for(std::size_t index = 0; index < requestCount; ++index) {
+        Operation *operation = new Operation();
+        operation->Buffer = static_cast<std::uint8_t *>(requests[index].Buffer);
+        operation->Location = requests[index].Location;
+        operation->RemainingByteCount = requests[index].Count;
+        operation->IsWrite = false;
+        operations.push_back(operation);
+        completions.push_back(operation->Completion.get_future());
+      }
+    }
+    catch(...) {
+      for(std::size_t index = 0; index < operations.size(); ++index) {
+        delete operations[index];
+      }
+      throw;
+    }
+
+    submit(operations.data(), operations.size());
+    return completions;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<void> AsyncFileIo::Write(
+    std::uint64_t location, const void *buffer, std::size_t count
+  ) {
+    Operation *operation = new Operation();
+    operation->Buffer = const_cast<std::uint8_t *>(static_cast<const std::uint8_t *>(buffer));
+    operation->Location = location;
+    operation->RemainingByteCount = count;
+    operation->IsWrite = true;
+
+    std::future<void> completion = operation->Completion.get_future();
+    submit(&operation, 1);
+    return completion;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncFileIo::submit(Operation **operations, std::size_t operationCount) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    for(std::size_t index = 0; index < operationCount; ++index) {
+      Operation *operation = operations[index];
+      if(operation->RemainingByteCount == 0) {
+        operation->Completion.set_value();
+        delete operation;
+        continue;
+      }
+
+      // Wait for a free slot. Anything still queued needs to be submitted first,
+      // otherwise nothing would ever complete and free a slot.
+      while(this->operationCount >= this->operationLimit) {
+#if defined(NUCLEX_STORAGE_HAVE_IO_URING)
+        enterRing();
+#endif
+        this->operationFinished.wait(lock);
+      }
+
+      ++this->operationCount;
+      if(!issue(operation)) {
+        --this->operationCount;
+        delete operation;
+      }
+    }
+
+#if defined(NUCLEX_STORAGE_HAVE_IO_URING)
+    enterRing();
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncFileIo::complete(
+    Operation *operation, std::size_t transferredByteCount, int errorCode
+  ) {
+    if(errorCode != 0) {
+      fail(operation, errorCode);
+      return;
+    }
+    if(transferredByteCount == 0) { // Only happens when a read reaches the end of the file
+      fail(operation, EndOfFileErrorCode);
+      return;
+    }
+
+    operation->Buffer += transferredByteCount;
+    operation->Location += transferredByteCount;
+    operation->RemainingByteCount -= transferredByteCount;
+
+    // Resume operations that came back short or were too large for a single transfer
+    if(operation->RemainingByteCount > 0) {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      if(issue(operation)) {
+#if defined(NUCLEX_STORAGE_HAVE_IO_URING)
+        enterRing();
+#endif
+      } else {
+        delete operation;
+        --this->operationCount;
+        this->operationFinished.notify_all();
+      }
+      return;
+    }
+
+    operation->Completion.set_value();
+    release(operation);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncFileIo::fail(Operation *operation, int errorCode) {
+    operation->Completion.set_exception(makeException(errorCode));
+    release(operation);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AsyncFileIo::release(Operation *operation) {
+    delete operation;
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    --this->operationCount;
+    this->operationFinished.notify_all();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
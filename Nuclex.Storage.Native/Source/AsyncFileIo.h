@@ -0,0 +1,222 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_ASYNCFILEIO_H
+#define NUCLEX_STORAGE_ASYNCFILEIO_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include <condition_variable> // for std::condition_variable
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <future> // for std::future
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+// io_uring has been in the kernel since Linux 5.1. Its header is only needed to
+// build the library, the kernel running the library may still refuse to set up a ring.
+#if defined(__linux__) && defined(__has_include)
+  #if __has_include(<linux/io_uring.h>)
+    #define NUCLEX_STORAGE_HAVE_IO_URING 1
+  #endif
+#endif
+
+#if defined(NUCLEX_STORAGE_HAVE_IO_URING) || defined(NUCLEX_STORAGE_WIN32)
+  #define NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO 1
+#endif
+
+#if defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Carries out reads and writes on a file in the background</summary>
+  /// <remarks>
+  ///   <para>
+  ///     On Linux, reads and writes are submitted to an io_uring, on Windows they are
+  ///     issued as overlapped I/O on a file handle associated with an I/O completion port.
+  ///     Either way, a single thread waits for the operations to complete and fulfills
+  ///     their futures. Operations that transfer fewer bytes than requested are resumed
+  ///     automatically, so each future only completes once all its bytes have moved.
+  ///   </para>
+  ///   <para>
+  ///     Destroying the instance waits for all outstanding operations to complete.
+  ///   </para>
+  /// </remarks>
+  class AsyncFileIo {
+
+#if defined(NUCLEX_STORAGE_WIN32)
+    /// <summary>Handle type through which the file is accessed</summary>
+    /// <remarks>
+    ///   A Windows HANDLE that must have been opened with FILE_FLAG_OVERLAPPED
+    /// </remarks>
+    public: typedef void *FileHandle;
+#else
+    /// <summary>Handle type through which the file is accessed</summary>
+    public: typedef int FileHandle;
+#endif
+
+    /// <summary>Sets up asynchronous I/O for the specified file</summary>
+    /// <param name="file">File on which reads and writes will be performed</param>
+    /// <remarks>
+    ///   Throws a std::system_error if the operating system refuses to provide
+    ///   asynchronous I/O. The file handle is not owned by the instance and must stay
+    ///   open until the instance has been destroyed.
+    /// </remarks>
+    public: AsyncFileIo(FileHandle file);
+
+    /// <summary>Waits for all outstanding operations and releases all resources</summary>
+    public: ~AsyncFileIo();
+
+    /// <summary>Begins reading from the file</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    /// <returns>A future that completes when the data has been read</returns>
+    public: std::future<void> Read(std::uint64_t location, void *buffer, std::size_t count);
+
+    /// <summary>Begins several reads from the file at once</summary>
+    /// <param name="requests">Reads that will be carried out</param>
+    /// <param name="requestCount">Number of reads in the request array</param>
+    /// <returns>One future for each read, in the same order as the requests</returns>
+    public: std::vector<std::future<void>> Read(
+      const BlobReadRequest *requests, std::size_t requestCount
+    );
+
+    /// <summary>Begins writing to the file</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    /// <returns>A future that completes when the data has been written</returns>
+    public: std::future<void> Write(
+      std::uint64_t location, const void *buffer, std::size_t count
+    );
+
+    /// <summary>State of a read or write that is in progress</summary>
+    private: struct Operation;
+
+    /// <summary>Hands a set of new operations to the operating system</summary>
+    /// <param name="operations">Operations that will be started</param>
+    /// <param name="operationCount">Number of operations that will be started</param>
+    private: void submit(Operation **operations, std::size_t operationCount);
+
+    /// <summary>Issues the remaining transfer of an operation to the operating system</summary>
+    /// <param name="operation">Operation whose remaining bytes will be transferred</param>
+    /// <returns>True if the operation was issued, false if it failed immediately</returns>
+    /// <remarks>
+    ///   Must be called with the mutex held. On Linux, this only queues the operation
+    ///   in the submission ring, <see cref="enterRing" /> has to be called afterwards.
+    /// </remarks>
+    private: bool issue(Operation *operation);
+
+    /// <summary>Processes the result of an operation</summary>
+    /// <param name="operation">Operation for which a transfer has finished</param>
+    /// <param name="transferredByteCount">Number of bytes transferred, if successful</param>
+    /// <param name="errorCode">Error that occurred, zero if the transfer succeeded</param>
+    private: void complete(
+      Operation *operation, std::size_t transferredByteCount, int errorCode
+    );
+
+    /// <summary>Fails an operation with the specified error and releases it</summary>
+    /// <param name="operation">Operation that has failed</param>
+    /// <param name="errorCode">Error that caused the operation to fail</param>
+    private: void fail(Operation *operation, int errorCode);
+
+    /// <summary>Releases an operation and wakes up anyone waiting for a free slot</summary>
+    /// <param name="operation">Operation that will be released</param>
+    private: void release(Operation *operation);
+
+    /// <summary>Waits for completed transfers and processes them</summary>
+    private: void completionThread();
+
+#if defined(NUCLEX_STORAGE_HAVE_IO_URING)
+    /// <summary>Submits all queued entries in the submission ring to the kernel</summary>
+    /// <remarks>Must be called with the mutex held</remarks>
+    private: void enterRing();
+#endif
+
+    private: AsyncFileIo(const AsyncFileIo &) = delete;
+    private: AsyncFileIo &operator =(const AsyncFileIo &) = delete;
+
+    /// <summary>File on which reads and writes are performed</summary>
+    private: FileHandle file;
+    /// <summary>Maximum number of operations that can be in flight at once</summary>
+    private: std::size_t operationLimit;
+    /// <summary>Number of operations that are currently in flight</summary>
+    private: std::size_t operationCount;
+    /// <summary>Sequentializes submissions and the counting of operations</summary>
+    private: std::mutex mutex;
+    /// <summary>Signaled whenever an operation is finished</summary>
+    private: std::condition_variable operationFinished;
+    /// <summary>Thread that waits for transfers to complete</summary>
+    private: std::thread thread;
+
+#if defined(NUCLEX_STORAGE_WIN32)
+    /// <summary>I/O completion port the file has been associated with</summary>
+    private: void *completionPort;
+#else
+    /// <summary>File descriptor of the io_uring</summary>
+    private: int ringDescriptor;
+    /// <summary>Memory of the submission ring's indices and index array</summary>
+    private: void *submissionRing;
+    /// <summary>Number of bytes mapped for the submission ring</summary>
+    private: std::size_t submissionRingByteCount;
+    /// <summary>Memory of the completion ring, may be the same as the submission ring</summary>
+    private: void *completionRing;
+    /// <summary>Number of bytes mapped for the completion ring</summary>
+    private: std::size_t completionRingByteCount;
+    /// <summary>Array of submission queue entries</summary>
+    private: void *submissionEntries;
+    /// <summary>Number of bytes mapped for the submission queue entries</summary>
+    private: std::size_t submissionEntriesByteCount;
+    /// <summary>Index of the first submission queue entry the kernel hasn't consumed</summary>
+    private: unsigned *submissionHead;
+    /// <summary>Index behind the last submission queue entry that has been queued</summary>
+    private: unsigned *submissionTail;
+    /// <summary>Mask applied to submission indices to wrap them around the ring</summary>
+    private: unsigned submissionMask;
+    /// <summary>Number of entries in the submission ring</summary>
+    private: unsigned submissionEntryCount;
+    /// <summary>Array mapping ring positions to submission queue entries</summary>
+    private: unsigned *submissionArray;
+    /// <summary>Index of the first completion queue entry that hasn't been processed</summary>
+    private: unsigned *completionHead;
+    /// <summary>Index behind the last completion queue entry the kernel has posted</summary>
+    private: unsigned *completionTail;
+    /// <summary>Mask applied to completion indices to wrap them around the ring</summary>
+    private: unsigned completionMask;
+    /// <summary>Array of completion queue entries</summary>
+    private: void *completionEntries;
+    /// <summary>Operations queued in the submission ring but not submitted yet</summary>
+    private: std::vector<Operation *> queued;
+#endif
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+
+#endif // NUCLEX_STORAGE_ASYNCFILEIO_H
@@ -24,7 +24,14 @@ License along with this library
 #include "Nuclex/Storage/Binary/BinaryBlobReader.h"
 #include "Nuclex/Storage/Blob.h"
 
-#include <vector>
+#include "../Helpers/VarintEncoding.h" // for VarintEncoder
+
+#include <Nuclex/Support/MonotonicArena.h> // for MonotonicArena
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
 
 #if defined(NUCLEX_STORAGE_WIN32)
   #define BYTESWAP16 _byteswap_ushort
@@ -61,9 +68,19 @@ namespace Nuclex { namespace Storage { namespace Binary {
 
   // ------------------------------------------------------------------------------------------- //
 
-  BinaryBlobReader::BinaryBlobReader(const std::shared_ptr<const Blob> &blob) :
+  BinaryBlobReader::BinaryBlobReader(
+    const std::shared_ptr<const Blob> &blob,
+    std::size_t readWindowByteCount /* = DefaultReadWindowByteCount */
+  ) :
     blob(blob),
-    position(0) {}
+    position(0),
+    flipBytes(false),
+    readWindowByteCount(readWindowByteCount),
+    window(),
+    windowStart(nullptr),
+    windowPosition(0),
+    windowByteCount(0),
+    decodeBuffer() {}
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -106,172 +123,331 @@ namespace Nuclex { namespace Storage { namespace Binary {
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(bool &target) {
-    std::uint8_t flag;
+  void BinaryBlobReader::Read(std::string &target) {
+    std::uint32_t characterCount;
+    Read(characterCount);
+
+    if(characterCount > 0) {
+      target.resize(characterCount);
+      Read(&target[0], characterCount * sizeof(char));
+    } else {
+      target.clear();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    this->blob->ReadAt(this->position, &flag, sizeof(flag));
-    this->position += sizeof(flag);
+  void BinaryBlobReader::Read(std::wstring &target) {
+    std::uint32_t characterCount;
+    Read(characterCount);
 
-    target = (flag != 0);
+    if(characterCount > 0) {
+      target.resize(characterCount);
+      Read(&target[0], characterCount * sizeof(wchar_t));
+    } else {
+      target.clear();
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::uint8_t &target) {
-    this->blob->ReadAt(this->position, &target, sizeof(target));
-    this->position += sizeof(target);
+  bool BinaryBlobReader::TryReadStringInPlace(const char *&characters, std::size_t &length) {
+    std::uint64_t startPosition = this->position;
+
+    std::uint32_t characterCount;
+    Read(characterCount);
+    if(characterCount == 0) {
+      characters = u8"";
+      length = 0;
+      return true;
+    }
+
+    // If the read window points into the blob's memory, the characters are usually
+    // in it already. Otherwise, ask the blob, which fails if it has no memory to give.
+    const std::uint8_t *span;
+    bool isWindowInBlob = (
+      (this->windowStart != nullptr) &&
+      (this->window.empty() || (this->windowStart != this->window.data()))
+    );
+    std::uint64_t offset = this->position - this->windowPosition;
+    bool isInWindow = (
+      isWindowInBlob &&
+      (this->position >= this->windowPosition) &&
+      (offset <= this->windowByteCount) &&
+      (characterCount <= this->windowByteCount - offset)
+    );
+    if(isInWindow) {
+      span = this->windowStart + static_cast<std::size_t>(offset);
+    } else {
+      span = this->blob->TryGetContiguousSpan(this->position, characterCount);
+    }
+    if(span == nullptr) {
+      this->position = startPosition;
+      return false;
+    }
+
+    characters = reinterpret_cast<const char *>(span);
+    length = characterCount;
+    this->position += characterCount;
+    return true;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::int8_t &target) {
-    this->blob->ReadAt(this->position, &target, sizeof(target));
-    this->position += sizeof(target);
+  const char *BinaryBlobReader::ReadString(Support::MonotonicArena &arena, std::size_t &length) {
+    std::uint32_t characterCount;
+    Read(characterCount);
+
+    char *characters = arena.AllocateArray<char>(static_cast<std::size_t>(characterCount) + 1);
+    readBytes(characters, characterCount);
+    characters[characterCount] = 0;
+
+    length = characterCount;
+    return characters;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::uint16_t &target) {
-    if(this->flipBytes) {
-      std::uint16_t temp;
-      this->blob->ReadAt(this->position, &temp, sizeof(temp));
-      target = BYTESWAP16(temp);
-    } else {
-      this->blob->ReadAt(this->position, &target, sizeof(target));
+  void BinaryBlobReader::ReadStringTable(StringTable &target, std::size_t count) {
+    target.Characters.clear();
+    target.Offsets.clear();
+    target.Offsets.reserve(count + 1);
+    target.Offsets.push_back(0);
+
+    for(std::size_t index = 0; index < count; ++index) {
+      std::uint32_t characterCount;
+      Read(characterCount);
+
+      std::size_t offset = target.Characters.size();
+      target.Characters.resize(offset + static_cast<std::size_t>(characterCount) + 1);
+      readBytes(target.Characters.data() + offset, characterCount);
+      target.Characters.back() = 0;
+
+      target.Offsets.push_back(target.Characters.size());
     }
-    this->position += sizeof(target);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::int16_t &target) {
-    if(this->flipBytes) {
-      std::uint16_t temp;
-      this->blob->ReadAt(this->position, &temp, sizeof(temp));
-      target = static_cast<std::int16_t>(BYTESWAP16(temp));
-    } else {
-      this->blob->ReadAt(this->position, &target, sizeof(target));
-    }
-    this->position += sizeof(target);
+  void BinaryBlobReader::Read(void *buffer, std::size_t byteCount) {
+    readBytes(buffer, byteCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::uint32_t &target) {
-    if(this->flipBytes) {
-      std::uint32_t temp;
-      this->blob->ReadAt(this->position, &temp, sizeof(temp));
-      target = BYTESWAP32(temp);
-    } else {
-      this->blob->ReadAt(this->position, &target, sizeof(target));
+  void BinaryBlobReader::ReadVarint(std::uint32_t &target) {
+    std::uint64_t value;
+    ReadVarint(value);
+    if(value > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(u8"Varint is too large for a 32 bit integer");
     }
-    this->position += sizeof(target);
+
+    target = static_cast<std::uint32_t>(value);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::int32_t &target) {
-    if(this->flipBytes) {
-      std::uint32_t temp;
-      this->blob->ReadAt(this->position, &temp, sizeof(temp));
-      target = static_cast<std::int32_t>(BYTESWAP32(temp));
-    } else {
-      this->blob->ReadAt(this->position, &target, sizeof(target));
+  void BinaryBlobReader::ReadVarint(std::int32_t &target) {
+    std::uint64_t value;
+    ReadVarint(value);
+    if(value > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(u8"Varint is too large for a 32 bit integer");
     }
-    this->position += sizeof(target);
+
+    target = Helpers::VarintEncoder::ZigZagDecode(static_cast<std::uint32_t>(value));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::uint64_t &target) {
-    if(this->flipBytes) {
-      std::uint64_t temp;
-      this->blob->ReadAt(this->position, &temp, sizeof(temp));
-      target = BYTESWAP64(temp);
-    } else {
-      this->blob->ReadAt(this->position, &target, sizeof(target));
+  void BinaryBlobReader::ReadVarint(std::uint64_t &target) {
+
+    // Normal case: the varint can be decoded straight out of the read window
+    if(this->position >= this->windowPosition) {
+      std::uint64_t offset = this->position - this->windowPosition;
+      if(offset < this->windowByteCount) {
+        std::size_t byteCount = Helpers::VarintEncoder::DecodeVarint(
+          this->windowStart + static_cast<std::size_t>(offset),
+          this->windowByteCount - static_cast<std::size_t>(offset),
+          target
+        );
+        if(byteCount > 0) {
+          this->position += byteCount;
+          return;
+        }
+      }
+    }
+
+    // The varint crosses the end of the read window, collect its bytes one by one
+    std::uint8_t encoded[Helpers::VarintEncoder::MaximumVarintByteCount];
+    for(std::size_t index = 0; index < sizeof(encoded); ++index) {
+      readBytes(&encoded[index], 1);
+      if((encoded[index] & 0x80) == 0) {
+        Helpers::VarintEncoder::DecodeVarint(encoded, index + 1, target);
+        return;
+      }
     }
-    this->position += sizeof(target);
+
+    throw std::runtime_error(u8"Varint is longer than any 64 bit integer");
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::int64_t &target) {
-    if(this->flipBytes) {
-      std::uint64_t temp;
-      this->blob->ReadAt(this->position, &temp, sizeof(temp));
-      target = static_cast<std::int64_t>(BYTESWAP64(temp));
-    } else {
-      this->blob->ReadAt(this->position, &target, sizeof(target));
-    }
-    this->position += sizeof(target);
+  void BinaryBlobReader::ReadVarint(std::int64_t &target) {
+    std::uint64_t value;
+    ReadVarint(value);
+    target = Helpers::VarintEncoder::ZigZagDecode(value);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(float &target) {
-    if(this->flipBytes) {
-      std::uint32_t temp;
-      this->blob->ReadAt(this->position, &temp, sizeof(temp));
-      temp = BYTESWAP32(temp);
-      target = *reinterpret_cast<float *>(&temp);
-    } else {
-      this->blob->ReadAt(this->position, &target, sizeof(target));
-    }
-    this->position += sizeof(target);
+  void BinaryBlobReader::ReadVarintArray(std::uint32_t *target, std::size_t count) {
+    readStreamVByte(target, count, false);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(double &target) {
-    if(this->flipBytes) {
-      std::uint64_t temp;
-      this->blob->ReadAt(this->position, &temp, sizeof(temp));
-      temp = BYTESWAP64(temp);
-      target = *reinterpret_cast<double *>(&temp);
-    } else {
-      this->blob->ReadAt(this->position, &target, sizeof(target));
+  void BinaryBlobReader::ReadVarintArray(std::int32_t *target, std::size_t count) {
+    std::uint32_t *zigZagValues = reinterpret_cast<std::uint32_t *>(target);
+    readStreamVByte(zigZagValues, count, false);
+
+    for(std::size_t index = 0; index < count; ++index) {
+      target[index] = Helpers::VarintEncoder::ZigZagDecode(zigZagValues[index]);
     }
-    this->position += sizeof(target);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::string &target) {
-    std::uint32_t characterCount;
-    Read(characterCount);
+  void BinaryBlobReader::ReadDeltaArray(std::uint32_t *target, std::size_t count) {
+    readStreamVByte(target, count, true);
+  }
 
-    if(characterCount > 0) {
-      std::vector<char> stringContents(characterCount);
-      Read(&stringContents[0], characterCount * sizeof(char));
+  // ------------------------------------------------------------------------------------------- //
 
-      target.assign(&stringContents[0], characterCount);
-    } else {
-      target.clear();
+  void BinaryBlobReader::readScalarSlow(void *target, std::size_t byteCount) {
+    readBytes(target, byteCount);
+
+    if(this->flipBytes) {
+      switch(byteCount) {
+        case sizeof(std::uint16_t): {
+          std::uint16_t value;
+          std::memcpy(&value, target, sizeof(value));
+          value = BYTESWAP16(value);
+          std::memcpy(target, &value, sizeof(value));
+          break;
+        }
+        case sizeof(std::uint32_t): {
+          std::uint32_t value;
+          std::memcpy(&value, target, sizeof(value));
+          value = BYTESWAP32(value);
+          std::memcpy(target, &value, sizeof(value));
+          break;
+        }
+        case sizeof(std::uint64_t): {
+          std::uint64_t value;
+          std::memcpy(&value, target, sizeof(value));
+          value = BYTESWAP64(value);
+          std::memcpy(target, &value, sizeof(value));
+          break;
+        }
+      }
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(std::wstring &target) {
-    std::uint32_t characterCount;
-    Read(characterCount);
+  void BinaryBlobReader::readBytes(void *buffer, std::size_t byteCount) {
+    if(byteCount == 0) {
+      return;
+    }
 
-    if(characterCount > 0) {
-      std::vector<wchar_t> stringContents(characterCount);
-      Read(&stringContents[0], characterCount * sizeof(wchar_t));
+    // Normal case: the requested bytes are already in the read window
+    if(this->position >= this->windowPosition) {
+      std::uint64_t offset = this->position - this->windowPosition;
+      if((offset <= this->windowByteCount) && (byteCount <= this->windowByteCount - offset)) {
+        std::memcpy(buffer, this->windowStart + static_cast<std::size_t>(offset), byteCount);
+        this->position += byteCount;
+        return;
+      }
+    }
 
-      target.assign(&stringContents[0], characterCount);
-    } else {
-      target.clear();
+    // If the blob lets us access its memory directly, the read window can simply point
+    // to everything that remains in the blob and won't have to be refilled again.
+    std::uint64_t remainingByteCount = GetRemainingBytes();
+    if((this->readWindowByteCount > 0) && (byteCount <= remainingByteCount)) {
+      std::size_t spanByteCount = static_cast<std::size_t>(
+        std::min<std::uint64_t>(remainingByteCount, std::numeric_limits<std::size_t>::max())
+      );
+      const std::uint8_t *span = this->blob->TryGetContiguousSpan(this->position, spanByteCount);
+      if(span != nullptr) {
+        this->windowStart = span;
+        this->windowPosition = this->position;
+        this->windowByteCount = spanByteCount;
+
+        std::memcpy(buffer, span, byteCount);
+        this->position += byteCount;
+        return;
+      }
+    }
+
+    // Reads that would use up most of the window gain nothing from being copied through
+    // it, and reads beyond the end of the blob are left to the blob so it can complain.
+    if((byteCount > this->readWindowByteCount / 2) || (byteCount > remainingByteCount)) {
+      this->blob->ReadAt(this->position, buffer, byteCount);
+      this->position += byteCount;
+      return;
+    }
+
+    // Refill the read window starting at the cursor
+    std::size_t fillByteCount = this->readWindowByteCount;
+    if(fillByteCount > remainingByteCount) {
+      fillByteCount = static_cast<std::size_t>(remainingByteCount);
     }
+    if(this->window.size() < fillByteCount) {
+      this->window.resize(fillByteCount);
+    }
+
+    this->windowByteCount = 0; // In case reading from the blob throws
+    this->blob->ReadAt(this->position, &this->window[0], fillByteCount);
+    this->windowStart = &this->window[0];
+    this->windowPosition = this->position;
+    this->windowByteCount = fillByteCount;
+
+    std::memcpy(buffer, &this->window[0], byteCount);
+    this->position += byteCount;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobReader::Read(void *buffer, std::size_t byteCount) {
-    this->blob->ReadAt(this->position, buffer, byteCount);
-    this->position += byteCount;
+  void BinaryBlobReader::readStreamVByte(
+    std::uint32_t *target, std::size_t count, bool isDeltaEncoded
+  ) {
+    if(count == 0) {
+      return;
+    }
+
+    // The lengths of all values come first, they tell how many bytes the values occupy
+    std::size_t controlByteCount = Helpers::VarintEncoder::GetStreamVByteControlLength(count);
+    if(this->decodeBuffer.size() < controlByteCount) {
+      this->decodeBuffer.resize(controlByteCount);
+    }
+    readBytes(this->decodeBuffer.data(), controlByteCount);
+
+    std::size_t dataByteCount = Helpers::VarintEncoder::GetStreamVByteDataLength(
+      this->decodeBuffer.data(), count
+    );
+
+    // The decoder may read a little beyond the encoded bytes, so the buffer gets padding
+    std::size_t requiredByteCount = (
+      controlByteCount + dataByteCount + Helpers::VarintEncoder::StreamVBytePaddingByteCount
+    );
+    if(this->decodeBuffer.size() < requiredByteCount) {
+      this->decodeBuffer.resize(requiredByteCount);
+    }
+    readBytes(this->decodeBuffer.data() + controlByteCount, dataByteCount);
+
+    Helpers::VarintEncoder::DecodeStreamVByte(
+      this->decodeBuffer.data(), count, target, isDeltaEncoded
+    );
   }
 
   // ------------------------------------------------------------------------------------------- //
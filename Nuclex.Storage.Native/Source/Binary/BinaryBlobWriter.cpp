@@ -24,6 +24,12 @@ License along with this library
 #include "Nuclex/Storage/Binary/BinaryBlobWriter.h"
 #include "Nuclex/Storage/Blob.h"
 
+#include "../Helpers/VarintEncoding.h" // for VarintEncoder
+
+#include "Nuclex/Support/ScratchScope.h" // for ScratchScope
+
+#include <cstring> // for std::memcpy()
+
 #if defined(NUCLEX_STORAGE_WIN32)
   #define BYTESWAP16 _byteswap_ushort
   #define BYTESWAP32 _byteswap_ulong
@@ -59,10 +65,29 @@ namespace Nuclex { namespace Storage {  namespace Binary {
 
   // ------------------------------------------------------------------------------------------- //
 
-  BinaryBlobWriter::BinaryBlobWriter(const std::shared_ptr<Blob> &blob) :
+  BinaryBlobWriter::BinaryBlobWriter(
+    const std::shared_ptr<Blob> &blob,
+    std::size_t writeBufferByteCount /* = DefaultWriteBufferByteCount */
+  ) :
     blob(blob),
     position(0),
-    flipBytes(false) {}
+    flipBytes(false),
+    writeBufferByteCount(writeBufferByteCount),
+    buffer(),
+    bufferPosition(0),
+    bufferedByteCount(0),
+    encodeBuffer() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryBlobWriter::~BinaryBlobWriter() {
+    try {
+      Flush();
+    }
+    catch(...) {
+      // Destructors must not throw. Callers who care call Flush() themselves.
+    }
+  }
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -90,150 +115,169 @@ namespace Nuclex { namespace Storage {  namespace Binary {
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(bool value) {
-    std::uint8_t flag = value ? 1 : 0;
+  void BinaryBlobWriter::Write(const std::string &value) {
+    std::uint32_t length = static_cast<std::uint32_t>(value.length());
+    Write(length);
 
-    this->blob->WriteAt(this->position, &flag, sizeof(flag));
-    this->position += sizeof(flag);
+    if(length > 0) {
+      Write(value.c_str(), length * sizeof(char));
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(std::uint8_t value) {
-    this->blob->WriteAt(this->position, &value, sizeof(value));
-    this->position += sizeof(value);
+  void BinaryBlobWriter::Write(const std::wstring &value) {
+    std::uint32_t length = static_cast<std::uint32_t>(value.length());
+    Write(length);
+
+    if(length > 0) {
+      Write(value.c_str(), length * sizeof(wchar_t));
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(std::int8_t value) {
-    this->blob->WriteAt(this->position, &value, sizeof(value));
-    this->position += sizeof(value);
+  void BinaryBlobWriter::Write(const void *buffer, std::size_t byteCount) {
+    writeBytes(buffer, byteCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(std::uint16_t value) {
-    if(this->flipBytes) {
-      std::uint16_t temp = BYTESWAP16(value);
-      this->blob->WriteAt(this->position, &temp, sizeof(temp));
-    } else {
-      this->blob->WriteAt(this->position, &value, sizeof(value));
-    }
-    this->position += sizeof(value);
+  void BinaryBlobWriter::WriteVarint(std::uint64_t value) {
+    std::uint8_t encoded[Helpers::VarintEncoder::MaximumVarintByteCount];
+    writeBytes(encoded, Helpers::VarintEncoder::EncodeVarint(value, encoded));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(std::int16_t value) {
-    if(this->flipBytes) {
-      std::uint16_t temp = BYTESWAP16(static_cast<std::uint16_t>(value));
-      this->blob->WriteAt(this->position, &temp, sizeof(temp));
-    } else {
-      this->blob->WriteAt(this->position, &value, sizeof(value));
-    }
-    this->position += sizeof(value);
+  void BinaryBlobWriter::WriteVarint(std::int64_t value) {
+    WriteVarint(Helpers::VarintEncoder::ZigZagEncode(value));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(std::uint32_t value) {
-    if(this->flipBytes) {
-      std::uint32_t temp = BYTESWAP32(value);
-      this->blob->WriteAt(this->position, &temp, sizeof(temp));
-    } else {
-      this->blob->WriteAt(this->position, &value, sizeof(value));
-    }
-    this->position += sizeof(value);
+  void BinaryBlobWriter::WriteVarintArray(const std::uint32_t *values, std::size_t count) {
+    writeStreamVByte(values, count, false);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(std::int32_t value) {
-    if(this->flipBytes) {
-      std::uint32_t temp = BYTESWAP32(static_cast<std::uint32_t>(value));
-      this->blob->WriteAt(this->position, &temp, sizeof(temp));
-    } else {
-      this->blob->WriteAt(this->position, &value, sizeof(value));
+  void BinaryBlobWriter::WriteVarintArray(const std::int32_t *values, std::size_t count) {
+    Support::ScratchScope scratch;
+    std::uint32_t *zigZagValues = scratch.AllocateArray<std::uint32_t>(count);
+    for(std::size_t index = 0; index < count; ++index) {
+      zigZagValues[index] = Helpers::VarintEncoder::ZigZagEncode(values[index]);
     }
-    this->position += sizeof(value);
+
+    writeStreamVByte(zigZagValues, count, false);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(std::uint64_t value) {
-    if(this->flipBytes) {
-      std::uint64_t temp = BYTESWAP64(value);
-      this->blob->WriteAt(this->position, &temp, sizeof(temp));
-    } else {
-      this->blob->WriteAt(this->position, &value, sizeof(value));
-    }
-    this->position += sizeof(value);
+  void BinaryBlobWriter::WriteDeltaArray(const std::uint32_t *values, std::size_t count) {
+    writeStreamVByte(values, count, true);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(std::int64_t value) {
-    if(this->flipBytes) {
-      std::uint64_t temp = BYTESWAP64(static_cast<std::uint64_t>(value));
-      this->blob->WriteAt(this->position, &temp, sizeof(temp));
-    } else {
-      this->blob->WriteAt(this->position, &value, sizeof(value));
+  void BinaryBlobWriter::Flush() {
+    if(this->bufferedByteCount > 0) {
+      this->blob->WriteAt(this->bufferPosition, &this->buffer[0], this->bufferedByteCount);
+      this->bufferedByteCount = 0;
     }
-    this->position += sizeof(value);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(float value) {
+  void BinaryBlobWriter::writeScalarSlow(const void *value, std::size_t byteCount) {
     if(this->flipBytes) {
-      std::uint32_t temp = BYTESWAP32(*reinterpret_cast<std::uint32_t *>(&value));
-      this->blob->WriteAt(this->position, &temp, sizeof(temp));
-    } else {
-      this->blob->WriteAt(this->position, &value, sizeof(value));
+      switch(byteCount) {
+        case sizeof(std::uint16_t): {
+          std::uint16_t temp;
+          std::memcpy(&temp, value, sizeof(temp));
+          temp = BYTESWAP16(temp);
+          writeBytes(&temp, sizeof(temp));
+          return;
+        }
+        case sizeof(std::uint32_t): {
+          std::uint32_t temp;
+          std::memcpy(&temp, value, sizeof(temp));
+          temp = BYTESWAP32(temp);
+          writeBytes(&temp, sizeof(temp));
+          return;
+        }
+        case sizeof(std::uint64_t): {
+          std::uint64_t temp;
+          std::memcpy(&temp, value, sizeof(temp));
+          temp = BYTESWAP64(temp);
+          writeBytes(&temp, sizeof(temp));
+          return;
+        }
+      }
     }
-    this->position += sizeof(value);
+
+    writeBytes(value, byteCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(double value) {
-    if(this->flipBytes) {
-      std::uint64_t temp = BYTESWAP64(*reinterpret_cast<std::uint64_t *>(&value));
-      this->blob->WriteAt(this->position, &temp, sizeof(temp));
-    } else {
-      this->blob->WriteAt(this->position, &value, sizeof(value));
+  void BinaryBlobWriter::writeBytes(const void *buffer, std::size_t byteCount) {
+    if(byteCount == 0) {
+      return;
     }
-    this->position += sizeof(value);
-  }
 
-  // ------------------------------------------------------------------------------------------- //
+    // Normal case: the bytes continue the buffered ones and still fit in the buffer
+    if(
+      (this->position == this->bufferPosition + this->bufferedByteCount) &&
+      (byteCount <= this->writeBufferByteCount - this->bufferedByteCount)
+    ) {
+      if(this->buffer.size() < this->writeBufferByteCount) {
+        this->buffer.resize(this->writeBufferByteCount);
+      }
+      std::memcpy(&this->buffer[this->bufferedByteCount], buffer, byteCount);
+      this->bufferedByteCount += byteCount;
+      this->position += byteCount;
+      return;
+    }
 
-  void BinaryBlobWriter::Write(const std::string &value) {
-    std::uint32_t length = static_cast<std::uint32_t>(value.length());
-    Write(length);
+    // The buffered bytes have to reach the blob before anything that comes after them
+    Flush();
 
-    if(length > 0) {
-      Write(value.c_str(), length * sizeof(char));
+    // Writes that would fill most of the buffer gain nothing from being copied through it
+    if(byteCount > this->writeBufferByteCount / 2) {
+      this->blob->WriteAt(this->position, buffer, byteCount);
+      this->position += byteCount;
+      return;
     }
+
+    // Start collecting bytes again at the cursor
+    if(this->buffer.size() < this->writeBufferByteCount) {
+      this->buffer.resize(this->writeBufferByteCount);
+    }
+    std::memcpy(&this->buffer[0], buffer, byteCount);
+    this->bufferPosition = this->position;
+    this->bufferedByteCount = byteCount;
+    this->position += byteCount;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  void BinaryBlobWriter::Write(const std::wstring &value) {
-    std::uint32_t length = static_cast<std::uint32_t>(value.length());
-    Write(length);
-
-    if(length > 0) {
-      Write(value.c_str(), length * sizeof(wchar_t));
+  void BinaryBlobWriter::writeStreamVByte(
+    const std::uint32_t *values, std::size_t count, bool isDeltaEncoded
+  ) {
+    if(count == 0) {
+      return;
     }
-  }
 
-  // ------------------------------------------------------------------------------------------- //
+    std::size_t maximumByteCount = Helpers::VarintEncoder::GetStreamVByteMaximumLength(count);
+    if(this->encodeBuffer.size() < maximumByteCount) {
+      this->encodeBuffer.resize(maximumByteCount);
+    }
 
-  void BinaryBlobWriter::Write(const void *buffer, std::size_t byteCount) {
-    this->blob->WriteAt(this->position, buffer, byteCount);
-    this->position += byteCount;
+    std::size_t byteCount = Helpers::VarintEncoder::EncodeStreamVByte(
+      values, count, this->encodeBuffer.data(), isDeltaEncoded
+    );
+    writeBytes(this->encodeBuffer.data(), byteCount);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -22,10 +22,113 @@ License along with this library
 #define NUCLEX_STORAGE_SOURCE 1
 
 #include "Nuclex/Storage/Binary/BinaryReader.h"
+#include "../Helpers/ByteSwap.h"
 
-// --------------------------------------------------------------------------------------------- //
+#include <cstdint> // for std::uint8_t
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+namespace {
 
-// --------------------------------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a stream's byte order differs from the platform's</summary>
+  /// <param name="littleEndian">Whether the stream uses little endian byte order</param>
+  /// <returns>True if the bytes of values need to be swapped</returns>
+  bool isForeignByteOrder(bool littleEndian) {
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+    return littleEndian;
+#else
+    return !littleEndian;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of an array of values</summary>
+  /// <param name="source">Array of values that will be swapped</param>
+  /// <param name="target">Array that will receive the swapped values</param>
+  /// <param name="count">Number of values in the array</param>
+  /// <param name="valueByteCount">Size of an individual value in bytes</param>
+  void swapBytes(
+    const void *source, void *target, std::size_t count, std::size_t valueByteCount
+  ) {
+    switch(valueByteCount) {
+      case 2: { Nuclex::Storage::Helpers::ByteSwap::Swap16(source, target, count); break; }
+      case 4: { Nuclex::Storage::Helpers::ByteSwap::Swap32(source, target, count); break; }
+      case 8: { Nuclex::Storage::Helpers::ByteSwap::Swap64(source, target, count); break; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads an array of values and brings them into the platform's byte order</summary>
+  /// <param name="reader">Reader the values will be read from</param>
+  /// <param name="target">Array that will receive the values</param>
+  /// <param name="count">Number of values that will be read</param>
+  /// <param name="valueByteCount">Size of an individual value in bytes</param>
+  void readArray(
+    Nuclex::Storage::Binary::BinaryReader &reader,
+    void *target, std::size_t count, std::size_t valueByteCount
+  ) {
+    reader.Read(target, count * valueByteCount);
+    if(isForeignByteOrder(reader.IsLittleEndian())) {
+      swapBytes(target, target, count, valueByteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryReader::ReadArray(std::uint16_t *target, std::size_t count) {
+    readArray(*this, target, count, sizeof(std::uint16_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryReader::ReadArray(std::int16_t *target, std::size_t count) {
+    readArray(*this, target, count, sizeof(std::int16_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryReader::ReadArray(std::uint32_t *target, std::size_t count) {
+    readArray(*this, target, count, sizeof(std::uint32_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryReader::ReadArray(std::int32_t *target, std::size_t count) {
+    readArray(*this, target, count, sizeof(std::int32_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryReader::ReadArray(std::uint64_t *target, std::size_t count) {
+    readArray(*this, target, count, sizeof(std::uint64_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryReader::ReadArray(std::int64_t *target, std::size_t count) {
+    readArray(*this, target, count, sizeof(std::int64_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryReader::ReadArray(float *target, std::size_t count) {
+    readArray(*this, target, count, sizeof(float));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryReader::ReadArray(double *target, std::size_t count) {
+    readArray(*this, target, count, sizeof(double));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
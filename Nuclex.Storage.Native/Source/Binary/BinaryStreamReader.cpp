@@ -0,0 +1,346 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BinaryStreamReader.h"
+#include "Nuclex/Storage/Binary/InputStream.h"
+
+#include "../Helpers/ByteSwap.h" // for ByteSwap
+#include "../Helpers/VarintEncoding.h" // for VarintEncoder
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryStreamReader::BinaryStreamReader(
+    const std::shared_ptr<InputStream> &stream,
+    std::size_t readBufferByteCount /* = DefaultReadBufferByteCount */
+  ) :
+    stream(stream),
+    position(0),
+    flipBytes(false),
+    readBufferByteCount(readBufferByteCount),
+    buffer(),
+    windowStart(nullptr),
+    windowByteCount(0),
+    spanByteCount(0),
+    decodeBuffer() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryStreamReader::~BinaryStreamReader() {
+    try {
+      releaseSpan();
+    }
+    catch(...) {
+      // Destructors must not throw. The stream will be positioned wherever it ended up.
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BinaryStreamReader::IsLittleEndian() const {
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+    // On a big endian system, we're in little endian mode if we flip
+    return this->flipBytes;
+#else
+    // On a little endian system, we're in little endian mode by default
+    return !this->flipBytes;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::SetLittleEndian(bool useLittleEndian /* = true */) {
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+    // Big endian requires us to flip if the file should be little endian
+    this->flipBytes = useLittleEndian;
+#else
+    // Little endian requires no operation if the file should be little endian
+    this->flipBytes = !useLittleEndian;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::Read(std::string &target) {
+    std::uint32_t characterCount;
+    Read(characterCount);
+
+    if(characterCount > 0) {
+      target.resize(characterCount);
+      readBytes(&target[0], characterCount * sizeof(char));
+    } else {
+      target.clear();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::Read(std::wstring &target) {
+    std::uint32_t characterCount;
+    Read(characterCount);
+
+    if(characterCount > 0) {
+      target.resize(characterCount);
+      readBytes(&target[0], characterCount * sizeof(wchar_t));
+    } else {
+      target.clear();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::Read(void *buffer, std::size_t byteCount) {
+    readBytes(buffer, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::ReadVarint(std::uint32_t &target) {
+    std::uint64_t value;
+    ReadVarint(value);
+    if(value > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(u8"Varint is too large for a 32 bit integer");
+    }
+
+    target = static_cast<std::uint32_t>(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::ReadVarint(std::int32_t &target) {
+    std::uint64_t value;
+    ReadVarint(value);
+    if(value > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(u8"Varint is too large for a 32 bit integer");
+    }
+
+    target = Helpers::VarintEncoder::ZigZagDecode(static_cast<std::uint32_t>(value));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::ReadVarint(std::uint64_t &target) {
+
+    // Normal case: the varint can be decoded straight out of the read window
+    if(this->windowByteCount > 0) {
+      std::size_t byteCount = Helpers::VarintEncoder::DecodeVarint(
+        this->windowStart, this->windowByteCount, target
+      );
+      if(byteCount > 0) {
+        this->windowStart += byteCount;
+        this->windowByteCount -= byteCount;
+        this->position += byteCount;
+        return;
+      }
+    }
+
+    // The varint crosses the end of the read window, collect its bytes one by one
+    std::uint8_t encoded[Helpers::VarintEncoder::MaximumVarintByteCount];
+    for(std::size_t index = 0; index < sizeof(encoded); ++index) {
+      readBytes(&encoded[index], 1);
+      if((encoded[index] & 0x80) == 0) {
+        Helpers::VarintEncoder::DecodeVarint(encoded, index + 1, target);
+        return;
+      }
+    }
+
+    throw std::runtime_error(u8"Varint is longer than any 64 bit integer");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::ReadVarint(std::int64_t &target) {
+    std::uint64_t value;
+    ReadVarint(value);
+    target = Helpers::VarintEncoder::ZigZagDecode(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::ReadVarintArray(std::uint32_t *target, std::size_t count) {
+    readStreamVByte(target, count, false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::ReadVarintArray(std::int32_t *target, std::size_t count) {
+    std::uint32_t *zigZagValues = reinterpret_cast<std::uint32_t *>(target);
+    readStreamVByte(zigZagValues, count, false);
+
+    for(std::size_t index = 0; index < count; ++index) {
+      target[index] = Helpers::VarintEncoder::ZigZagDecode(zigZagValues[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::ReadDeltaArray(std::uint32_t *target, std::size_t count) {
+    readStreamVByte(target, count, true);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::readScalarSlow(void *target, std::size_t byteCount) {
+    readBytes(target, byteCount);
+
+    if(this->flipBytes) {
+      switch(byteCount) {
+        case 2: { Helpers::ByteSwap::Swap16(target, target, 1); break; }
+        case 4: { Helpers::ByteSwap::Swap32(target, target, 1); break; }
+        case 8: { Helpers::ByteSwap::Swap64(target, target, 1); break; }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::readBytes(void *buffer, std::size_t byteCount) {
+    std::uint8_t *target = static_cast<std::uint8_t *>(buffer);
+
+    // Hand out whatever is left in the read window first
+    std::size_t windowCopyByteCount = std::min(byteCount, this->windowByteCount);
+    if(windowCopyByteCount > 0) {
+      std::memcpy(target, this->windowStart, windowCopyByteCount);
+      this->windowStart += windowCopyByteCount;
+      this->windowByteCount -= windowCopyByteCount;
+      this->position += windowCopyByteCount;
+      target += windowCopyByteCount;
+      byteCount -= windowCopyByteCount;
+    }
+
+    while(byteCount > 0) {
+
+      // Reads that would fill most of the buffer gain nothing from being copied through
+      // it, let the stream place them in the caller's memory, waiting for all of them
+      if(byteCount > this->readBufferByteCount / 2) {
+        releaseSpan();
+
+        std::size_t readByteCount = byteCount;
+        this->stream->ReadUpTo(target, readByteCount, byteCount);
+        this->position += byteCount;
+        return;
+      }
+
+      fillWindow();
+
+      std::size_t copyByteCount = std::min(byteCount, this->windowByteCount);
+      std::memcpy(target, this->windowStart, copyByteCount);
+      this->windowStart += copyByteCount;
+      this->windowByteCount -= copyByteCount;
+      this->position += copyByteCount;
+      target += copyByteCount;
+      byteCount -= copyByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::fillWindow() {
+    releaseSpan();
+
+    // If the stream holds its data in memory anyway, read from there
+    std::size_t availableByteCount;
+    const std::uint8_t *span = this->stream->AcquireReadableSpan(availableByteCount);
+    if((span != nullptr) && (availableByteCount > 0)) {
+      this->windowStart = span;
+      this->windowByteCount = availableByteCount;
+      this->spanByteCount = availableByteCount;
+      return;
+    }
+
+    if(this->buffer.size() < this->readBufferByteCount) {
+      this->buffer.resize(this->readBufferByteCount);
+    }
+
+    // Take whatever the stream can provide right now. Only if that is nothing,
+    // wait for more data to arrive.
+    std::size_t readByteCount = this->readBufferByteCount;
+    bool isEndReached = this->stream->ReadUpTo(this->buffer.data(), readByteCount, 0);
+    if(readByteCount == 0) {
+      if(isEndReached) {
+        throw std::runtime_error(u8"Stream ended before all requested data could be read");
+      }
+
+      readByteCount = this->readBufferByteCount;
+      this->stream->ReadUpTo(this->buffer.data(), readByteCount, 1);
+    }
+
+    this->windowStart = this->buffer.data();
+    this->windowByteCount = readByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::releaseSpan() {
+    if(this->spanByteCount > 0) {
+      std::size_t consumedByteCount = this->spanByteCount - this->windowByteCount;
+      this->spanByteCount = 0;
+      this->windowByteCount = 0;
+
+      this->stream->ConsumeReadableSpan(consumedByteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamReader::readStreamVByte(
+    std::uint32_t *target, std::size_t count, bool isDeltaEncoded
+  ) {
+    if(count == 0) {
+      return;
+    }
+
+    // The lengths of all values come first, they tell how many bytes the values occupy
+    std::size_t controlByteCount = Helpers::VarintEncoder::GetStreamVByteControlLength(count);
+    if(this->decodeBuffer.size() < controlByteCount) {
+      this->decodeBuffer.resize(controlByteCount);
+    }
+    readBytes(this->decodeBuffer.data(), controlByteCount);
+
+    std::size_t dataByteCount = Helpers::VarintEncoder::GetStreamVByteDataLength(
+      this->decodeBuffer.data(), count
+    );
+
+    // The decoder may read a little beyond the encoded bytes, so the buffer gets padding
+    std::size_t requiredByteCount = (
+      controlByteCount + dataByteCount + Helpers::VarintEncoder::StreamVBytePaddingByteCount
+    );
+    if(this->decodeBuffer.size() < requiredByteCount) {
+      this->decodeBuffer.resize(requiredByteCount);
+    }
+    readBytes(this->decodeBuffer.data() + controlByteCount, dataByteCount);
+
+    Helpers::VarintEncoder::DecodeStreamVByte(
+      this->decodeBuffer.data(), count, target, isDeltaEncoded
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,249 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BinaryStreamWriter.h"
+#include "Nuclex/Storage/Binary/OutputStream.h"
+
+#include "../Helpers/ByteSwap.h" // for ByteSwap
+#include "../Helpers/VarintEncoding.h" // for VarintEncoder
+
+#include "Nuclex/Support/ScratchScope.h" // for ScratchScope
+
+#include <cstring> // for std::memcpy()
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryStreamWriter::BinaryStreamWriter(
+    const std::shared_ptr<OutputStream> &stream,
+    std::size_t writeBufferByteCount /* = DefaultWriteBufferByteCount */
+  ) :
+    stream(stream),
+    position(0),
+    flipBytes(false),
+    writeBufferByteCount(writeBufferByteCount),
+    buffer(),
+    bufferedByteCount(0),
+    encodeBuffer() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryStreamWriter::~BinaryStreamWriter() {
+    try {
+      Flush();
+    }
+    catch(...) {
+      // Destructors must not throw. Callers who care call Flush() themselves.
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BinaryStreamWriter::IsLittleEndian() const {
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+    // On a big endian system, we're in little endian mode if we flip
+    return this->flipBytes;
+#else
+    // On a little endian system, we're in little endian mode by default
+    return !this->flipBytes;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::SetLittleEndian(bool useLittleEndian /* = true */) {
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+    // Big endian requires us to flip if the file should be little endian
+    this->flipBytes = useLittleEndian;
+#else
+    // Little endian requires no operation if the file should be little endian
+    this->flipBytes = !useLittleEndian;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::Write(const std::string &value) {
+    std::uint32_t length = static_cast<std::uint32_t>(value.length());
+    Write(length);
+
+    if(length > 0) {
+      writeBytes(value.c_str(), length * sizeof(char));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::Write(const std::wstring &value) {
+    std::uint32_t length = static_cast<std::uint32_t>(value.length());
+    Write(length);
+
+    if(length > 0) {
+      writeBytes(value.c_str(), length * sizeof(wchar_t));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::Write(const void *buffer, std::size_t byteCount) {
+    writeBytes(buffer, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::WriteVarint(std::uint64_t value) {
+    std::uint8_t encoded[Helpers::VarintEncoder::MaximumVarintByteCount];
+    writeBytes(encoded, Helpers::VarintEncoder::EncodeVarint(value, encoded));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::WriteVarint(std::int64_t value) {
+    WriteVarint(Helpers::VarintEncoder::ZigZagEncode(value));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::WriteVarintArray(const std::uint32_t *values, std::size_t count) {
+    writeStreamVByte(values, count, false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::WriteVarintArray(const std::int32_t *values, std::size_t count) {
+    Support::ScratchScope scratch;
+    std::uint32_t *zigZagValues = scratch.AllocateArray<std::uint32_t>(count);
+    for(std::size_t index = 0; index < count; ++index) {
+      zigZagValues[index] = Helpers::VarintEncoder::ZigZagEncode(values[index]);
+    }
+
+    writeStreamVByte(zigZagValues, count, false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::WriteDeltaArray(const std::uint32_t *values, std::size_t count) {
+    writeStreamVByte(values, count, true);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::Flush() {
+    if(this->bufferedByteCount > 0) {
+      std::size_t writtenByteCount = this->bufferedByteCount;
+      this->stream->WriteUpTo(this->buffer.data(), writtenByteCount, this->bufferedByteCount);
+      this->bufferedByteCount = 0;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::writeScalarSlow(const void *value, std::size_t byteCount) {
+    if(this->flipBytes) {
+      std::uint8_t flipped[sizeof(std::uint64_t)];
+      switch(byteCount) {
+        case 2: {
+          Helpers::ByteSwap::Swap16(value, flipped, 1);
+          writeBytes(flipped, byteCount);
+          return;
+        }
+        case 4: {
+          Helpers::ByteSwap::Swap32(value, flipped, 1);
+          writeBytes(flipped, byteCount);
+          return;
+        }
+        case 8: {
+          Helpers::ByteSwap::Swap64(value, flipped, 1);
+          writeBytes(flipped, byteCount);
+          return;
+        }
+      }
+    }
+
+    writeBytes(value, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::writeBytes(const void *buffer, std::size_t byteCount) {
+    if(byteCount == 0) {
+      return;
+    }
+
+    // Normal case: the bytes still fit in the write buffer
+    if(byteCount <= this->writeBufferByteCount - this->bufferedByteCount) {
+      if(this->buffer.size() < this->writeBufferByteCount) {
+        this->buffer.resize(this->writeBufferByteCount);
+      }
+      std::memcpy(this->buffer.data() + this->bufferedByteCount, buffer, byteCount);
+      this->bufferedByteCount += byteCount;
+      this->position += byteCount;
+      return;
+    }
+
+    // The buffered bytes have to reach the stream before anything that comes after them
+    Flush();
+
+    // Writes that would fill most of the buffer gain nothing from being copied through it
+    if(byteCount > this->writeBufferByteCount / 2) {
+      std::size_t writtenByteCount = byteCount;
+      this->stream->WriteUpTo(
+        static_cast<const std::uint8_t *>(buffer), writtenByteCount, byteCount
+      );
+      this->position += byteCount;
+      return;
+    }
+
+    // Start collecting bytes again in the now empty buffer
+    if(this->buffer.size() < this->writeBufferByteCount) {
+      this->buffer.resize(this->writeBufferByteCount);
+    }
+    std::memcpy(this->buffer.data(), buffer, byteCount);
+    this->bufferedByteCount = byteCount;
+    this->position += byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryStreamWriter::writeStreamVByte(
+    const std::uint32_t *values, std::size_t count, bool isDeltaEncoded
+  ) {
+    if(count == 0) {
+      return;
+    }
+
+    std::size_t maximumByteCount = Helpers::VarintEncoder::GetStreamVByteMaximumLength(count);
+    if(this->encodeBuffer.size() < maximumByteCount) {
+      this->encodeBuffer.resize(maximumByteCount);
+    }
+
+    std::size_t byteCount = Helpers::VarintEncoder::EncodeStreamVByte(
+      values, count, this->encodeBuffer.data(), isDeltaEncoded
+    );
+    writeBytes(this->encodeBuffer.data(), byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
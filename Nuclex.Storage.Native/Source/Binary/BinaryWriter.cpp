@@ -22,10 +22,131 @@ License along with this library
 #define NUCLEX_STORAGE_SOURCE 1
 
 #include "Nuclex/Storage/Binary/BinaryWriter.h"
+#include "../Helpers/ByteSwap.h"
 
-// --------------------------------------------------------------------------------------------- //
+#include <cstdint> // for std::uint8_t
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+namespace {
 
-// --------------------------------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a stream's byte order differs from the platform's</summary>
+  /// <param name="littleEndian">Whether the stream uses little endian byte order</param>
+  /// <returns>True if the bytes of values need to be swapped</returns>
+  bool isForeignByteOrder(bool littleEndian) {
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+    return littleEndian;
+#else
+    return !littleEndian;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of an array of values</summary>
+  /// <param name="source">Array of values that will be swapped</param>
+  /// <param name="target">Array that will receive the swapped values</param>
+  /// <param name="count">Number of values in the array</param>
+  /// <param name="valueByteCount">Size of an individual value in bytes</param>
+  void swapBytes(
+    const void *source, void *target, std::size_t count, std::size_t valueByteCount
+  ) {
+    switch(valueByteCount) {
+      case 2: { Nuclex::Storage::Helpers::ByteSwap::Swap16(source, target, count); break; }
+      case 4: { Nuclex::Storage::Helpers::ByteSwap::Swap32(source, target, count); break; }
+      case 8: { Nuclex::Storage::Helpers::ByteSwap::Swap64(source, target, count); break; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes an array of values in the writer's byte order</summary>
+  /// <param name="writer">Writer the values will be written to</param>
+  /// <param name="source">Array holding the values that will be written</param>
+  /// <param name="count">Number of values that will be written</param>
+  /// <param name="valueByteCount">Size of an individual value in bytes</param>
+  /// <remarks>
+  ///   If the bytes need to be swapped, the values are swapped into a small buffer
+  ///   on the stack and written a chunk at a time, so the caller's array stays untouched.
+  /// </remarks>
+  void writeArray(
+    Nuclex::Storage::Binary::BinaryWriter &writer,
+    const void *source, std::size_t count, std::size_t valueByteCount
+  ) {
+    if(!isForeignByteOrder(writer.IsLittleEndian())) {
+      writer.Write(source, count * valueByteCount);
+      return;
+    }
+
+    const std::size_t chunkByteCount = 4096;
+    std::uint8_t chunk[chunkByteCount];
+    std::size_t chunkValueCount = chunkByteCount / valueByteCount;
+
+    const std::uint8_t *sourceBytes = static_cast<const std::uint8_t *>(source);
+    while(count > 0) {
+      std::size_t valueCount = (count < chunkValueCount) ? count : chunkValueCount;
+      swapBytes(sourceBytes, chunk, valueCount, valueByteCount);
+      writer.Write(chunk, valueCount * valueByteCount);
+
+      sourceBytes += valueCount * valueByteCount;
+      count -= valueCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteArray(const std::uint16_t *source, std::size_t count) {
+    writeArray(*this, source, count, sizeof(std::uint16_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteArray(const std::int16_t *source, std::size_t count) {
+    writeArray(*this, source, count, sizeof(std::int16_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteArray(const std::uint32_t *source, std::size_t count) {
+    writeArray(*this, source, count, sizeof(std::uint32_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteArray(const std::int32_t *source, std::size_t count) {
+    writeArray(*this, source, count, sizeof(std::int32_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteArray(const std::uint64_t *source, std::size_t count) {
+    writeArray(*this, source, count, sizeof(std::uint64_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteArray(const std::int64_t *source, std::size_t count) {
+    writeArray(*this, source, count, sizeof(std::int64_t));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteArray(const float *source, std::size_t count) {
+    writeArray(*this, source, count, sizeof(float));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryWriter::WriteArray(const double *source, std::size_t count) {
+    writeArray(*this, source, count, sizeof(double));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
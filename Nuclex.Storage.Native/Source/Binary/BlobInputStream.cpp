@@ -0,0 +1,227 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BlobInputStream.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::out_of_range
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlobInputStream::BlobInputStream(
+    const std::shared_ptr<const Blob> &blob,
+    std::size_t bufferByteCount /* = DefaultBufferByteCount */,
+    bool readAhead /* = false */
+  ) :
+    blob(blob),
+    position(0),
+    bufferByteCount(bufferByteCount),
+    buffer(),
+    spanStart(nullptr),
+    spanByteCount(0),
+    readAhead(readAhead),
+    readAheadBuffer(),
+    readAheadCompletion(),
+    readAheadPosition(0),
+    readAheadByteCount(0) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlobInputStream::~BlobInputStream() {
+    discardReadAhead(); // The background read is still writing into our buffer
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BlobInputStream::IsMoreDataAvailable() const {
+    return (this->spanByteCount > 0) || (this->position < this->blob->GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BlobInputStream::ReadUpTo(
+    std::uint8_t *buffer, std::size_t &byteCount, std::size_t requiredByteCount /* = 1 */
+  ) {
+    std::uint64_t size = this->blob->GetSize();
+    std::uint64_t remainingByteCount = 0;
+    if(this->position < size) {
+      remainingByteCount = size - this->position;
+    }
+    if(remainingByteCount < requiredByteCount) {
+      throw std::out_of_range(u8"Not enough data left in the blob for the required byte count");
+    }
+    if(byteCount > remainingByteCount) {
+      byteCount = static_cast<std::size_t>(remainingByteCount);
+    }
+
+    // Hand out anything left in the current span and any chunks that have been read
+    // ahead first, then read the rest directly into the caller's buffer
+    std::size_t copiedByteCount = 0;
+    while(copiedByteCount < byteCount) {
+      if((this->spanByteCount == 0) && !takeReadAhead()) {
+        break;
+      }
+
+      std::size_t spanCopyByteCount = std::min(byteCount - copiedByteCount, this->spanByteCount);
+      std::memcpy(buffer + copiedByteCount, this->spanStart, spanCopyByteCount);
+      ConsumeReadableSpan(spanCopyByteCount);
+      copiedByteCount += spanCopyByteCount;
+    }
+    if(copiedByteCount < byteCount) {
+      discardReadAhead();
+
+      std::size_t readByteCount = byteCount - copiedByteCount;
+      this->blob->ReadAt(this->position, buffer + copiedByteCount, readByteCount);
+      this->position += readByteCount;
+    }
+
+    return (this->position >= size);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::uint8_t *BlobInputStream::AcquireReadableSpan(std::size_t &byteCount) {
+    if(this->spanByteCount > 0) {
+      byteCount = this->spanByteCount;
+      return this->spanStart;
+    }
+
+    std::uint64_t size = this->blob->GetSize();
+    if(this->position >= size) {
+      byteCount = 0;
+      return nullptr;
+    }
+
+    // If the blob lets us access its memory directly, the span can simply cover
+    // everything that remains in the blob
+    std::size_t remainingByteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(size - this->position, std::numeric_limits<std::size_t>::max())
+    );
+    const std::uint8_t *span = this->blob->TryGetContiguousSpan(
+      this->position, remainingByteCount
+    );
+    if(span != nullptr) {
+      this->spanStart = span;
+      this->spanByteCount = remainingByteCount;
+    } else if(!takeReadAhead()) {
+      discardReadAhead();
+
+      std::size_t fillByteCount = std::min(this->bufferByteCount, remainingByteCount);
+      if(fillByteCount == 0) {
+        fillByteCount = remainingByteCount;
+      }
+      if(this->buffer.size() < fillByteCount) {
+        this->buffer.resize(fillByteCount);
+      }
+
+      this->blob->ReadAt(this->position, &this->buffer[0], fillByteCount);
+      this->spanStart = &this->buffer[0];
+      this->spanByteCount = fillByteCount;
+
+      startReadAhead();
+    }
+
+    byteCount = this->spanByteCount;
+    return this->spanStart;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobInputStream::ConsumeReadableSpan(std::size_t byteCount) {
+    if(byteCount > this->spanByteCount) {
+      throw std::out_of_range(u8"Attempted to consume more bytes than the span provided");
+    }
+
+    this->spanStart += byteCount;
+    this->spanByteCount -= byteCount;
+    this->position += byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobInputStream::startReadAhead() {
+    if(!this->readAhead) {
+      return;
+    }
+
+    std::uint64_t nextPosition = this->position + this->spanByteCount;
+    std::uint64_t size = this->blob->GetSize();
+    if(nextPosition >= size) {
+      return;
+    }
+
+    std::size_t readByteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(this->bufferByteCount, size - nextPosition)
+    );
+    if(readByteCount == 0) {
+      return;
+    }
+    if(this->readAheadBuffer.size() < readByteCount) {
+      this->readAheadBuffer.resize(readByteCount);
+    }
+
+    this->readAheadPosition = nextPosition;
+    this->readAheadByteCount = readByteCount;
+    this->readAheadCompletion = this->blob->ReadAtAsync(
+      nextPosition, &this->readAheadBuffer[0], readByteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BlobInputStream::takeReadAhead() {
+    if(!this->readAheadCompletion.valid() || (this->readAheadPosition != this->position)) {
+      return false;
+    }
+
+    this->readAheadCompletion.get(); // Rethrows the error if the read has failed
+
+    this->buffer.swap(this->readAheadBuffer);
+    this->spanStart = &this->buffer[0];
+    this->spanByteCount = this->readAheadByteCount;
+
+    startReadAhead();
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobInputStream::discardReadAhead() {
+    if(this->readAheadCompletion.valid()) {
+      try {
+        this->readAheadCompletion.get();
+      }
+      catch(...) {
+        // The chunk is dropped anyway, if it was needed the error will happen again
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
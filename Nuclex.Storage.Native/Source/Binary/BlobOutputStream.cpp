@@ -0,0 +1,166 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BlobOutputStream.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include <cstring> // for std::memcpy()
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlobOutputStream::BlobOutputStream(
+    const std::shared_ptr<Blob> &blob,
+    std::size_t bufferByteCount /* = DefaultBufferByteCount */,
+    bool writeBehind /* = false */,
+    std::uint64_t startPosition /* = 0 */
+  ) :
+    blob(blob),
+    position(startPosition),
+    bufferByteCount(bufferByteCount),
+    buffer(bufferByteCount),
+    bufferedByteCount(0),
+    writeBehind(writeBehind),
+    writeBehindBuffer(),
+    writeBehindCompletion() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlobOutputStream::~BlobOutputStream() {
+    try {
+      Flush();
+    }
+    catch(...) {
+      // Destructors must not throw. Callers who care call Flush() themselves.
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BlobOutputStream::CanAcceptMoreData() const {
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobOutputStream::WriteUpTo(
+    const std::uint8_t *buffer, std::size_t &byteCount, std::size_t minimumByteCount /* = 1 */
+  ) {
+    (void)minimumByteCount;
+
+    // If the caller filled the memory we handed out via GetBuffer(), the data is
+    // already where it needs to be
+    if(
+      (this->bufferByteCount > 0) &&
+      (buffer == &this->buffer[0] + this->bufferedByteCount) &&
+      (byteCount <= this->bufferByteCount - this->bufferedByteCount)
+    ) {
+      this->bufferedByteCount += byteCount;
+      if(this->bufferedByteCount == this->bufferByteCount) {
+        writeBuffer();
+      }
+      return;
+    }
+
+    // Writes larger than the buffer gain nothing from being copied through it
+    if(byteCount >= this->bufferByteCount) {
+      writeBuffer();
+      waitForWriteBehind();
+      this->blob->WriteAt(this->position, buffer, byteCount);
+      this->position += byteCount;
+      return;
+    }
+
+    std::size_t remainingByteCount = byteCount;
+    while(remainingByteCount > 0) {
+      std::size_t freeByteCount = this->bufferByteCount - this->bufferedByteCount;
+      std::size_t copyByteCount = (remainingByteCount < freeByteCount) ?
+        remainingByteCount : freeByteCount;
+
+      std::memcpy(&this->buffer[0] + this->bufferedByteCount, buffer, copyByteCount);
+      this->bufferedByteCount += copyByteCount;
+      buffer += copyByteCount;
+      remainingByteCount -= copyByteCount;
+
+      if(this->bufferedByteCount == this->bufferByteCount) {
+        writeBuffer();
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint8_t *BlobOutputStream::GetBuffer(std::size_t &bufferSize) {
+    if(this->bufferByteCount == 0) {
+      bufferSize = 0;
+      return nullptr;
+    }
+
+    bufferSize = this->bufferByteCount - this->bufferedByteCount;
+    return &this->buffer[0] + this->bufferedByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobOutputStream::Flush() {
+    writeBuffer();
+    waitForWriteBehind();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobOutputStream::writeBuffer() {
+    if(this->bufferedByteCount == 0) {
+      return;
+    }
+
+    // Only one chunk is written in the background at a time, so the previous
+    // one needs to have arrived before its buffer can be reused
+    waitForWriteBehind();
+
+    if(this->writeBehind) {
+      this->writeBehindBuffer.resize(this->bufferByteCount);
+      this->buffer.swap(this->writeBehindBuffer);
+      this->writeBehindCompletion = this->blob->WriteAtAsync(
+        this->position, &this->writeBehindBuffer[0], this->bufferedByteCount
+      );
+    } else {
+      this->blob->WriteAt(this->position, &this->buffer[0], this->bufferedByteCount);
+    }
+
+    this->position += this->bufferedByteCount;
+    this->bufferedByteCount = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobOutputStream::waitForWriteBehind() {
+    if(this->writeBehindCompletion.valid()) {
+      this->writeBehindCompletion.get(); // Rethrows the error if the write has failed
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,63 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/FileOutputStream.h"
+#include "Nuclex/Storage/FileBlob.h"
+
+#include <memory> // for std::shared_ptr
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a file for writing and cuts off anything it already contains</summary>
+  /// <param name="path">Path of the file that will be opened</param>
+  /// <returns>A file blob through which the empty file can be written</returns>
+  std::shared_ptr<Nuclex::Storage::FileBlob> openEmptyFile(const std::string &path) {
+    std::shared_ptr<Nuclex::Storage::FileBlob> blob = (
+      std::make_shared<Nuclex::Storage::FileBlob>(path, true)
+    );
+    blob->Truncate(0);
+    return blob;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FileOutputStream::FileOutputStream(
+    const std::string &path, std::size_t chunkByteCount /* = DefaultChunkByteCount */
+  ) :
+    BlobOutputStream(openEmptyFile(path), chunkByteCount, true) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FileOutputStream::~FileOutputStream() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,77 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_BINARY_FLATBLOBFORMAT_H
+#define NUCLEX_STORAGE_BINARY_FLATBLOBFORMAT_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint32_t
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Header at the start of each flat blob</summary>
+  /// <remarks>
+  ///   The header takes 16 bytes, so the first value behind it is aligned for any type
+  ///   a flat blob can store. All offsets are counted from the start of the header.
+  /// </remarks>
+  struct FlatBlobHeader {
+
+    /// <summary>Signature identifying the blob as a flat blob</summary>
+    public: std::uint8_t Signature[4];
+    /// <summary>Version of the flat blob format</summary>
+    public: std::uint8_t Version;
+    /// <summary>1 if the values are stored in little endian, 0 for big endian</summary>
+    public: std::uint8_t IsLittleEndian;
+    /// <summary>Unused, always zero</summary>
+    public: std::uint8_t Reserved[2];
+    /// <summary>Offset of the value readers start from</summary>
+    public: std::uint32_t RootOffset;
+    /// <summary>Number of bytes in the flat blob, including the header</summary>
+    public: std::uint32_t ByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Signature flat blobs start with</summary>
+  const std::uint8_t FlatBlobSignature[4] = { 'N', 'F', 'L', 'T' };
+
+  /// <summary>Version of the flat blob format written by this library</summary>
+  const std::uint8_t FlatBlobVersion = 1;
+
+  /// <summary>Alignment guaranteed for the start of a flat blob's buffer</summary>
+  const std::size_t FlatBlobAlignment = 8;
+
+  /// <summary>Value of the byte order field on the current platform</summary>
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+  const std::uint8_t FlatBlobNativeByteOrder = 0;
+#else
+  const std::uint8_t FlatBlobNativeByteOrder = 1;
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
+
+#endif // NUCLEX_STORAGE_BINARY_FLATBLOBFORMAT_H
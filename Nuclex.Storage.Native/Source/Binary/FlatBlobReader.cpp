@@ -0,0 +1,191 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/FlatBlobReader.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include "FlatBlobFormat.h" // for FlatBlobHeader
+
+#include <cstring> // for std::memcmp(), std::memcpy()
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the header of a flat blob if the blob is large enough</summary>
+  /// <param name="blob">Blob whose header will be read</param>
+  /// <param name="header">Receives the header</param>
+  /// <returns>True if the blob was large enough and the header was read</returns>
+  bool tryReadHeader(
+    const Nuclex::Storage::Blob &blob, Nuclex::Storage::Binary::FlatBlobHeader &header
+  ) {
+    if(blob.GetSize() < sizeof(header)) {
+      return false;
+    }
+
+    blob.ReadAt(0, &header, sizeof(header));
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FlatBlobReader::IsFlatBlob(const Blob &blob) {
+    FlatBlobHeader header;
+    if(!tryReadHeader(blob, header)) {
+      return false;
+    }
+
+    return (std::memcmp(header.Signature, FlatBlobSignature, sizeof(header.Signature)) == 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlatBlobReader::FlatBlobReader(const std::shared_ptr<const Blob> &blob) :
+    blob(blob),
+    copy(),
+    start(nullptr),
+    byteCount(0),
+    rootOffset(0) {
+
+    FlatBlobHeader header;
+    if(!tryReadHeader(*blob, header)) {
+      throw std::runtime_error(u8"Blob is too small to be a flat blob");
+    }
+    if(std::memcmp(header.Signature, FlatBlobSignature, sizeof(header.Signature)) != 0) {
+      throw std::runtime_error(u8"Blob is not a flat blob");
+    }
+    if(header.Version != FlatBlobVersion) {
+      throw std::runtime_error(u8"Flat blob was written in an unsupported version");
+    }
+    if(header.IsLittleEndian != FlatBlobNativeByteOrder) {
+      throw std::runtime_error(u8"Flat blob was written on a platform with another byte order");
+    }
+    if((header.ByteCount < sizeof(header)) || (header.ByteCount > blob->GetSize())) {
+      throw std::runtime_error(u8"Flat blob is truncated or its header is corrupt");
+    }
+
+    this->byteCount = header.ByteCount;
+    this->rootOffset = header.RootOffset;
+
+    // Access the blob's memory directly if it can provide it at an address where
+    // the values will be aligned. Otherwise, read the whole blob into memory once.
+    this->start = blob->TryGetContiguousSpan(0, this->byteCount);
+    if(
+      (this->start == nullptr) ||
+      ((reinterpret_cast<std::uintptr_t>(this->start) % FlatBlobAlignment) != 0)
+    ) {
+      this->copy.resize(
+        (this->byteCount + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t)
+      );
+      blob->ReadAt(0, this->copy.data(), this->byteCount);
+      this->start = reinterpret_cast<const std::uint8_t *>(this->copy.data());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlatBlobReader::~FlatBlobReader() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlatArrayView<char> FlatBlobReader::Resolve(const FlatArray<char> &text) const {
+    if(text.IsNull()) {
+      return FlatArrayView<char>(u8"", 0);
+    }
+
+    std::size_t count;
+    const char *characters = static_cast<const char *>(
+      resolveArray(text.Offset, sizeof(char), alignof(char), count)
+    );
+    if((text.Offset + count >= this->byteCount) || (characters[count] != 0)) {
+      throw std::runtime_error(u8"String in flat blob is missing its terminating zero");
+    }
+
+    return FlatArrayView<char>(characters, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const void *FlatBlobReader::resolve(
+    std::uint32_t offset, std::size_t byteCount, std::size_t alignment
+  ) const {
+    if(offset == 0) {
+      throw std::runtime_error(u8"Attempted to resolve a null reference in a flat blob");
+    }
+    if(offset < sizeof(FlatBlobHeader)) {
+      throw std::runtime_error(u8"Reference in flat blob points into the header");
+    }
+    if((offset % alignment) != 0) {
+      throw std::runtime_error(u8"Reference in flat blob points to a misaligned value");
+    }
+    if((byteCount > this->byteCount) || (offset > this->byteCount - byteCount)) {
+      throw std::runtime_error(u8"Reference in flat blob points beyond the end of the blob");
+    }
+
+    return this->start + offset;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const void *FlatBlobReader::resolveArray(
+    std::uint32_t offset, std::size_t elementByteCount, std::size_t alignment,
+    std::size_t &count
+  ) const {
+    if(offset == 0) {
+      count = 0;
+      return nullptr;
+    }
+
+    if(alignment < sizeof(std::uint32_t)) {
+      alignment = sizeof(std::uint32_t);
+    }
+    if(offset < sizeof(FlatBlobHeader) + sizeof(std::uint32_t)) {
+      throw std::runtime_error(u8"Array reference in flat blob points into the header");
+    }
+    if((offset % alignment) != 0) {
+      throw std::runtime_error(u8"Array reference in flat blob points to a misaligned array");
+    }
+    if(offset > this->byteCount) {
+      throw std::runtime_error(u8"Array reference in flat blob points beyond the end of the blob");
+    }
+
+    std::uint32_t count32;
+    std::memcpy(&count32, this->start + offset - sizeof(count32), sizeof(count32));
+    if(count32 > (this->byteCount - offset) / elementByteCount) {
+      throw std::runtime_error(u8"Array in flat blob extends beyond the end of the blob");
+    }
+
+    count = count32;
+    return this->start + offset;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
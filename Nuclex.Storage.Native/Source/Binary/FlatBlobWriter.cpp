@@ -0,0 +1,140 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/FlatBlobWriter.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include "FlatBlobFormat.h" // for FlatBlobHeader
+
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::length_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Largest number of bytes a flat blob can grow to</summary>
+  const std::size_t MaximumByteCount = std::numeric_limits<std::uint32_t>::max();
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that a flat blob can hold the specified number of bytes</summary>
+  /// <param name="byteCount">Number of bytes the flat blob will grow to</param>
+  void requireAddressable(std::size_t byteCount) {
+    if(byteCount > MaximumByteCount) {
+      throw std::length_error(u8"Flat blobs can not be larger than 4 GiB");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlatBlobWriter::FlatBlobWriter(const std::shared_ptr<Blob> &blob) :
+    blob(blob),
+    buffer(sizeof(FlatBlobHeader), 0) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlatBlobWriter::~FlatBlobWriter() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FlatArray<char> FlatBlobWriter::AddString(const std::string &text) {
+    FlatArray<char> array;
+    array.Offset = appendArray(text.c_str(), text.length(), sizeof(char), alignof(char));
+    this->buffer.push_back(0);
+    return array;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint32_t FlatBlobWriter::append(
+    const void *value, std::size_t byteCount, std::size_t alignment
+  ) {
+    std::size_t offset = this->buffer.size();
+    offset += (alignment - (offset % alignment)) % alignment;
+    requireAddressable(offset + byteCount);
+
+    this->buffer.resize(offset + byteCount, 0);
+    if(byteCount > 0) {
+      std::memcpy(&this->buffer[offset], value, byteCount);
+    }
+
+    return static_cast<std::uint32_t>(offset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint32_t FlatBlobWriter::appendArray(
+    const void *elements, std::size_t count, std::size_t elementByteCount, std::size_t alignment
+  ) {
+    if(count > MaximumByteCount) {
+      throw std::length_error(u8"Flat blobs can not hold arrays with more than 2^32 items");
+    }
+
+    // The element count sits directly in front of the first element, so pad in a way
+    // that leaves both the count and the elements at their required alignment
+    if(alignment < sizeof(std::uint32_t)) {
+      alignment = sizeof(std::uint32_t);
+    }
+    std::size_t offset = this->buffer.size() + sizeof(std::uint32_t);
+    offset += (alignment - (offset % alignment)) % alignment;
+
+    std::size_t byteCount = count * elementByteCount;
+    requireAddressable(offset + byteCount + 1); // +1 leaves room for a string terminator
+
+    this->buffer.resize(offset + byteCount, 0);
+
+    std::uint32_t count32 = static_cast<std::uint32_t>(count);
+    std::memcpy(&this->buffer[offset - sizeof(std::uint32_t)], &count32, sizeof(count32));
+    if(byteCount > 0) {
+      std::memcpy(&this->buffer[offset], elements, byteCount);
+    }
+
+    return static_cast<std::uint32_t>(offset);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FlatBlobWriter::finish(std::uint32_t rootOffset) {
+    FlatBlobHeader header;
+    std::memcpy(header.Signature, FlatBlobSignature, sizeof(header.Signature));
+    header.Version = FlatBlobVersion;
+    header.IsLittleEndian = FlatBlobNativeByteOrder;
+    header.Reserved[0] = header.Reserved[1] = 0;
+    header.RootOffset = rootOffset;
+    header.ByteCount = static_cast<std::uint32_t>(this->buffer.size());
+    std::memcpy(this->buffer.data(), &header, sizeof(header));
+
+    this->blob->WriteAt(0, this->buffer.data(), this->buffer.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
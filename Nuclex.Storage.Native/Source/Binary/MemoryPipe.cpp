@@ -0,0 +1,203 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/MemoryPipe.h"
+
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MemoryPipe::MemoryPipe(std::size_t capacity /* = DefaultCapacity */) :
+    capacity(capacity),
+    buffer(capacity),
+    closed(false),
+    spanAcquired(false),
+    spanOwner(),
+    mutex(),
+    dataWritten(),
+    spaceFreed() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MemoryPipe::~MemoryPipe() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryPipe::Close() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->closed = true;
+    this->dataWritten.notify_all();
+    this->spaceFreed.notify_all();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MemoryPipe::IsClosed() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->closed;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t MemoryPipe::CountAvailableBytes() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->buffer.Count();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MemoryPipe::IsMoreDataAvailable() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return (this->buffer.Count() > 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MemoryPipe::ReadUpTo(
+    std::uint8_t *buffer, std::size_t &byteCount, std::size_t requiredByteCount /* = 1 */
+  ) {
+    if(requiredByteCount > byteCount) {
+      requiredByteCount = byteCount;
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    // Take bytes out as they arrive rather than waiting for all of them at once,
+    // otherwise a required byte count larger than the capacity could never be met
+    std::size_t readByteCount = 0;
+    for(;;) {
+      std::size_t chunkByteCount = this->buffer.Count();
+      if(chunkByteCount > byteCount - readByteCount) {
+        chunkByteCount = byteCount - readByteCount;
+      }
+      if(chunkByteCount > 0) {
+        this->buffer.Read(buffer + readByteCount, chunkByteCount);
+        readByteCount += chunkByteCount;
+        this->spanAcquired = false; // Reading moves the buffer's start, too
+        this->spaceFreed.notify_all();
+      }
+
+      if(readByteCount >= requiredByteCount) {
+        break;
+      }
+      if(this->closed) {
+        byteCount = readByteCount;
+        throw std::runtime_error(
+          u8"Pipe was closed before the required number of bytes could be read"
+        );
+      }
+
+      this->dataWritten.wait(lock);
+    }
+
+    byteCount = readByteCount;
+    return this->closed && (this->buffer.Count() == 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::uint8_t *MemoryPipe::AcquireReadableSpan(std::size_t &byteCount) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    byteCount = this->buffer.Count();
+    if(byteCount == 0) {
+      return nullptr;
+    }
+
+    this->spanAcquired = true;
+    this->spanOwner = std::this_thread::get_id();
+    return this->buffer.Access();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryPipe::ConsumeReadableSpan(std::size_t byteCount) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if(byteCount > this->buffer.Count()) {
+      throw std::out_of_range(u8"Attempted to consume more bytes than the span provided");
+    }
+
+    this->buffer.Skip(byteCount);
+    this->spanAcquired = false;
+    this->spaceFreed.notify_all();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MemoryPipe::CanAcceptMoreData() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return !this->closed && (this->buffer.Count() < this->capacity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryPipe::WriteUpTo(
+    const std::uint8_t *buffer, std::size_t &byteCount, std::size_t minimumByteCount /* = 1 */
+  ) {
+    if(minimumByteCount > byteCount) {
+      minimumByteCount = byteCount;
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    std::size_t writtenByteCount = 0;
+    for(;;) {
+      if(this->closed) {
+        byteCount = writtenByteCount;
+        throw std::runtime_error(u8"Attempted to write into a closed pipe");
+      }
+
+      // Growing the buffer could move the memory a reader on another thread is looking at
+      bool isBlockedBySpan = (
+        this->spanAcquired && (this->spanOwner != std::this_thread::get_id())
+      );
+
+      std::size_t chunkByteCount = 0;
+      if(!isBlockedBySpan && (this->buffer.Count() < this->capacity)) {
+        chunkByteCount = this->capacity - this->buffer.Count();
+        if(chunkByteCount > byteCount - writtenByteCount) {
+          chunkByteCount = byteCount - writtenByteCount;
+        }
+      }
+      if(chunkByteCount > 0) {
+        this->buffer.Write(buffer + writtenByteCount, chunkByteCount);
+        writtenByteCount += chunkByteCount;
+        this->spanAcquired = false; // The span may have moved, it becomes invalid
+        this->dataWritten.notify_all();
+      }
+
+      if((writtenByteCount >= minimumByteCount) || (writtenByteCount == byteCount)) {
+        break;
+      }
+
+      this->spaceFreed.wait(lock);
+    }
+
+    byteCount = writtenByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
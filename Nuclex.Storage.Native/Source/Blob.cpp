@@ -23,9 +23,61 @@ License along with this library
 
 #include "Nuclex/Storage/Blob.h"
 
-// --------------------------------------------------------------------------------------------- //
+#include <exception> // for std::current_exception()
 
-// This file is only here to guarantee that its associated header has no hidden
-// dependencies and can be included on its own
+namespace Nuclex { namespace Storage {
 
-// --------------------------------------------------------------------------------------------- //
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<void> Blob::ReadAtAsync(
+    std::uint64_t location, void *buffer, std::size_t count
+  ) const {
+    std::promise<void> completion;
+    try {
+      ReadAt(location, buffer, count);
+      completion.set_value();
+    }
+    catch(...) {
+      completion.set_exception(std::current_exception());
+    }
+
+    return completion.get_future();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::future<void>> Blob::ReadAtAsync(
+    const BlobReadRequest *requests, std::size_t requestCount
+  ) const {
+    std::vector<std::future<void>> completions;
+    completions.reserve(requestCount);
+
+    for(std::size_t index = 0; index < requestCount; ++index) {
+      completions.push_back(
+        ReadAtAsync(requests[index].Location, requests[index].Buffer, requests[index].Count)
+      );
+    }
+
+    return completions;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<void> Blob::WriteAtAsync(
+    std::uint64_t location, const void *buffer, std::size_t count
+  ) {
+    std::promise<void> completion;
+    try {
+      WriteAt(location, buffer, count);
+      completion.set_value();
+    }
+    catch(...) {
+      completion.set_exception(std::current_exception());
+    }
+
+    return completion.get_future();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
@@ -0,0 +1,133 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/BlobSlice.h"
+
+#include <exception> // for std::make_exception_ptr()
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a future that has already failed with the specified exception</summary>
+  /// <param name="error">Exception the future will carry</param>
+  /// <returns>A future that rethrows the exception when its result is requested</returns>
+  std::future<void> makeFailedFuture(std::exception_ptr error) {
+    std::promise<void> completion;
+    completion.set_exception(error);
+    return completion.get_future();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlobSlice::BlobSlice(
+    const std::shared_ptr<const Blob> &parent, std::uint64_t offset, std::uint64_t length
+  ) :
+    parent(parent),
+    offset(offset),
+    length(length) {
+
+    std::uint64_t parentByteCount = parent->GetSize();
+    bool isInParent = (offset <= parentByteCount) && (length <= parentByteCount - offset);
+    if(!isInParent) {
+      throw std::out_of_range(u8"Blob slice extends beyond the end of its parent blob");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobSlice::ReadAt(std::uint64_t location, void *buffer, std::size_t count) const {
+    if(!isInRange(location, count)) {
+      throw std::out_of_range(u8"Attempted read past the end of the blob slice");
+    }
+
+    this->parent->ReadAt(this->offset + location, buffer, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlobSlice::WriteAt(std::uint64_t location, const void *buffer, std::size_t count) {
+    (void)location;
+    (void)buffer;
+    (void)count;
+    throw std::runtime_error(u8"Attempted write to a read-only blob slice");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<void> BlobSlice::ReadAtAsync(
+    std::uint64_t location, void *buffer, std::size_t count
+  ) const {
+    if(!isInRange(location, count)) {
+      return makeFailedFuture(
+        std::make_exception_ptr(
+          std::out_of_range(u8"Attempted read past the end of the blob slice")
+        )
+      );
+    }
+
+    return this->parent->ReadAtAsync(this->offset + location, buffer, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::future<void>> BlobSlice::ReadAtAsync(
+    const BlobReadRequest *requests, std::size_t requestCount
+  ) const {
+    std::vector<BlobReadRequest> parentRequests(requests, requests + requestCount);
+    for(std::size_t index = 0; index < requestCount; ++index) {
+
+      // If any read is out of range, submit them one by one so that only
+      // the offending reads fail and the others are still carried out
+      if(!isInRange(requests[index].Location, requests[index].Count)) {
+        return Blob::ReadAtAsync(requests, requestCount);
+      }
+
+      parentRequests[index].Location += this->offset;
+    }
+
+    return this->parent->ReadAtAsync(parentRequests.data(), requestCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::uint8_t *BlobSlice::TryGetContiguousSpan(
+    std::uint64_t location, std::size_t count
+  ) const {
+    if(!isInRange(location, count)) {
+      return nullptr;
+    }
+
+    return this->parent->TryGetContiguousSpan(this->offset + location, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
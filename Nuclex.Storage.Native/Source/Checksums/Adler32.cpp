@@ -0,0 +1,200 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Checksums/Adler32.h"
+#include "ChecksumInput.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+#include <tmmintrin.h> // for SSSE3
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Modulus of both sums, the largest prime below 65536</summary>
+  const std::uint32_t Modulus = 65521;
+
+  /// <summary>Number of bytes that can be summed before the sums could overflow</summary>
+  /// <remarks>
+  ///   The largest n for which 255n(n+1)/2 + (n+1)(Modulus-1) still fits in 32 bits.
+  ///   Both sums only need to be reduced after this many bytes.
+  /// </remarks>
+  const std::size_t MaximumUnreducedByteCount = 5552;
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+
+  /// <summary>Adds 32 byte blocks to the Adler-32 sums using SSSE3 instructions</summary>
+  /// <param name="sum">Sum of all bytes, will be updated</param>
+  /// <param name="weightedSum">Sum of the byte sums, will be updated</param>
+  /// <param name="data">Blocks of data that will be added to the sums</param>
+  /// <param name="blockCount">Number of 32 byte blocks that will be added</param>
+  /// <remarks>
+  ///   Within a block, the byte sum after each byte counts towards the weighted sum,
+  ///   so the first byte is weighted 32 times and the last byte once. The sum from
+  ///   before the block is added to the weighted sum 32 times, which is done
+  ///   by shifting the collected sums of all blocks once at the end.
+  /// </remarks>
+  void addBlocks(
+    std::uint32_t &sum, std::uint32_t &weightedSum,
+    const std::uint8_t *data, std::size_t blockCount
+  ) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i firstWeights = _mm_setr_epi8(
+      32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17
+    );
+    const __m128i secondWeights = _mm_setr_epi8(
+      16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1
+    );
+
+    while(blockCount > 0) {
+      std::size_t roundBlockCount = MaximumUnreducedByteCount / 32;
+      if(roundBlockCount > blockCount) {
+        roundBlockCount = blockCount;
+      }
+      blockCount -= roundBlockCount;
+
+      __m128i previousSums = _mm_set_epi32(
+        0, 0, 0, static_cast<int>(sum * static_cast<std::uint32_t>(roundBlockCount))
+      );
+      __m128i weightedSums = _mm_set_epi32(0, 0, 0, static_cast<int>(weightedSum));
+      __m128i sums = _mm_setzero_si128();
+      do {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16));
+
+        previousSums = _mm_add_epi32(previousSums, sums);
+
+        sums = _mm_add_epi32(sums, _mm_sad_epu8(first, zero));
+        weightedSums = _mm_add_epi32(
+          weightedSums, _mm_madd_epi16(_mm_maddubs_epi16(first, firstWeights), ones)
+        );
+        sums = _mm_add_epi32(sums, _mm_sad_epu8(second, zero));
+        weightedSums = _mm_add_epi32(
+          weightedSums, _mm_madd_epi16(_mm_maddubs_epi16(second, secondWeights), ones)
+        );
+
+        data += 32;
+      } while(--roundBlockCount > 0);
+
+      weightedSums = _mm_add_epi32(weightedSums, _mm_slli_epi32(previousSums, 5));
+
+      // Add up the four lanes of both vectors
+      sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+      sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+      weightedSums = _mm_add_epi32(
+        weightedSums, _mm_shuffle_epi32(weightedSums, _MM_SHUFFLE(2, 3, 0, 1))
+      );
+      weightedSums = _mm_add_epi32(
+        weightedSums, _mm_shuffle_epi32(weightedSums, _MM_SHUFFLE(1, 0, 3, 2))
+      );
+
+      sum = (sum + static_cast<std::uint32_t>(_mm_cvtsi128_si32(sums))) % Modulus;
+      weightedSum = static_cast<std::uint32_t>(_mm_cvtsi128_si32(weightedSums)) % Modulus;
+    }
+  }
+
+#endif // defined(NUCLEX_STORAGE_HAVE_SSSE3)
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Adler32::Update(const void *data, std::size_t byteCount) {
+    const std::uint8_t *bytes = static_cast<const std::uint8_t *>(data);
+    std::uint32_t sum = this->sum;
+    std::uint32_t weightedSum = this->weightedSum;
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+    std::size_t blockCount = byteCount / 32;
+    if(blockCount > 0) {
+      addBlocks(sum, weightedSum, bytes, blockCount);
+      bytes += blockCount * 32;
+      byteCount -= blockCount * 32;
+    }
+#endif
+
+    while(byteCount > 0) {
+      std::size_t roundByteCount = MaximumUnreducedByteCount;
+      if(roundByteCount > byteCount) {
+        roundByteCount = byteCount;
+      }
+      byteCount -= roundByteCount;
+
+      while(roundByteCount >= 8) {
+        sum += bytes[0];
+        weightedSum += sum;
+        sum += bytes[1];
+        weightedSum += sum;
+        sum += bytes[2];
+        weightedSum += sum;
+        sum += bytes[3];
+        weightedSum += sum;
+        sum += bytes[4];
+        weightedSum += sum;
+        sum += bytes[5];
+        weightedSum += sum;
+        sum += bytes[6];
+        weightedSum += sum;
+        sum += bytes[7];
+        weightedSum += sum;
+        bytes += 8;
+        roundByteCount -= 8;
+      }
+      while(roundByteCount > 0) {
+        sum += *bytes;
+        weightedSum += sum;
+        ++bytes;
+        --roundByteCount;
+      }
+
+      sum %= Modulus;
+      weightedSum %= Modulus;
+    }
+
+    this->sum = sum;
+    this->weightedSum = weightedSum;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Adler32::Update(const Blob &blob) {
+    ChecksumInput::AddBlob(*this, blob);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Adler32::Update(Binary::InputStream &stream) {
+    ChecksumInput::AddStream(*this, stream);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
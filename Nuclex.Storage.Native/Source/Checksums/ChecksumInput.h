@@ -0,0 +1,123 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_CHECKSUMS_CHECKSUMINPUT_H
+#define NUCLEX_STORAGE_CHECKSUMS_CHECKSUMINPUT_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Blob.h"
+#include "Nuclex/Storage/Binary/InputStream.h"
+
+#include <algorithm> // for std::min()
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint64_t
+#include <limits> // for std::numeric_limits
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Feeds the contents of blobs and streams into checksum calculations</summary>
+  /// <remarks>
+  ///   Memory the blob or stream can hand out directly is checksummed in place,
+  ///   everything else is read in chunks into a buffer first.
+  /// </remarks>
+  class ChecksumInput {
+
+    /// <summary>Number of bytes read at once from blobs and streams</summary>
+    public: static const std::size_t ChunkByteCount = 65536;
+
+    /// <summary>Adds the contents of a blob to a checksum</summary>
+    /// <typeparam name="TChecksum">Type of checksum that will be updated</typeparam>
+    /// <param name="checksum">Checksum the blob's contents will be added to</param>
+    /// <param name="blob">Blob whose contents will be added</param>
+    public: template<typename TChecksum>
+    static void AddBlob(TChecksum &checksum, const Blob &blob) {
+      std::uint64_t remainingByteCount = blob.GetSize();
+
+      // If the blob's contents are in memory already, checksum them right there
+      if(remainingByteCount <= std::numeric_limits<std::size_t>::max()) {
+        const std::uint8_t *span = blob.TryGetContiguousSpan(
+          0, static_cast<std::size_t>(remainingByteCount)
+        );
+        if(span != nullptr) {
+          checksum.Update(span, static_cast<std::size_t>(remainingByteCount));
+          return;
+        }
+      }
+
+      std::vector<std::uint8_t> buffer(
+        static_cast<std::size_t>(std::min<std::uint64_t>(ChunkByteCount, remainingByteCount))
+      );
+      std::uint64_t location = 0;
+      while(remainingByteCount > 0) {
+        std::size_t byteCount = static_cast<std::size_t>(
+          std::min<std::uint64_t>(buffer.size(), remainingByteCount)
+        );
+        blob.ReadAt(location, buffer.data(), byteCount);
+        checksum.Update(buffer.data(), byteCount);
+        location += byteCount;
+        remainingByteCount -= byteCount;
+      }
+    }
+
+    /// <summary>Adds everything that can be read from a stream to a checksum</summary>
+    /// <typeparam name="TChecksum">Type of checksum that will be updated</typeparam>
+    /// <param name="checksum">Checksum the stream's contents will be added to</param>
+    /// <param name="stream">Stream that will be read until its end</param>
+    public: template<typename TChecksum>
+    static void AddStream(TChecksum &checksum, Binary::InputStream &stream) {
+      std::vector<std::uint8_t> buffer;
+      for(;;) {
+        std::size_t byteCount;
+        const std::uint8_t *span = stream.AcquireReadableSpan(byteCount);
+        if(span != nullptr) {
+          checksum.Update(span, byteCount);
+          stream.ConsumeReadableSpan(byteCount);
+          continue;
+        }
+
+        if(buffer.empty()) {
+          buffer.resize(ChunkByteCount);
+        }
+
+        // Ask for whatever is available first. Only if that is nothing and the stream
+        // hasn't ended yet, wait for more data to arrive.
+        byteCount = buffer.size();
+        bool isEndReached = stream.ReadUpTo(buffer.data(), byteCount, 0);
+        if((byteCount == 0) && !isEndReached) {
+          byteCount = buffer.size();
+          isEndReached = stream.ReadUpTo(buffer.data(), byteCount, 1);
+        }
+        checksum.Update(buffer.data(), byteCount);
+        if(isEndReached) {
+          break;
+        }
+      }
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
+
+#endif // NUCLEX_STORAGE_CHECKSUMS_CHECKSUMINPUT_H
@@ -0,0 +1,249 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Checksums/Crc32c.h"
+#include "ChecksumInput.h"
+
+#include <cstring> // for std::memcpy()
+
+#if defined(NUCLEX_STORAGE_HAVE_SSE42)
+#include <nmmintrin.h> // for SSE 4.2
+#elif defined(NUCLEX_STORAGE_HAVE_ARM_CRC32)
+#include <arm_acle.h> // for the ARMv8 CRC32 extension
+#elif defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+// Builds for older x86 CPUs check at runtime whether the crc32 instruction can be used
+#define NUCLEX_STORAGE_CRC32C_DISPATCH 1
+#include "Nuclex/Support/CpuFeatures.h"
+#include <nmmintrin.h> // for SSE 4.2
+#endif
+
+#if defined(NUCLEX_STORAGE_CRC32C_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+// GCC and clang only emit SSE 4.2 instructions in functions marked for it
+#define NUCLEX_STORAGE_TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#define NUCLEX_STORAGE_TARGET_SSE42
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_STORAGE_HAVE_SSE42) && !defined(NUCLEX_STORAGE_HAVE_ARM_CRC32)
+
+  /// <summary>Lookup tables for calculating CRC-32C checksums 8 bytes at a time</summary>
+  /// <remarks>
+  ///   The first table holds the CRC of each byte value, each following table
+  ///   the CRC of a byte value followed by one more zero byte than the table before.
+  /// </remarks>
+  class Crc32cTables {
+
+    /// <summary>Calculates the lookup tables</summary>
+    public: Crc32cTables() {
+      for(std::uint32_t byteValue = 0; byteValue < 256; ++byteValue) {
+        std::uint32_t crc = byteValue;
+        for(std::size_t bit = 0; bit < 8; ++bit) {
+          crc = (crc >> 1) ^ (0x82F63B78U & (0U - (crc & 1U))); // reversed Castagnoli
+        }
+        this->Values[0][byteValue] = crc;
+      }
+      for(std::size_t table = 1; table < 8; ++table) {
+        for(std::size_t byteValue = 0; byteValue < 256; ++byteValue) {
+          std::uint32_t previous = this->Values[table - 1][byteValue];
+          this->Values[table][byteValue] = (previous >> 8) ^ this->Values[0][previous & 0xFF];
+        }
+      }
+    }
+
+    /// <summary>CRC of each byte value followed by 0 to 7 zero bytes</summary>
+    public: std::uint32_t Values[8][256];
+
+  };
+
+#endif // !defined(NUCLEX_STORAGE_HAVE_SSE42) && !defined(NUCLEX_STORAGE_HAVE_ARM_CRC32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_SSE42) || defined(NUCLEX_STORAGE_CRC32C_DISPATCH)
+
+  /// <summary>Updates a CRC-32C checksum using the SSE 4.2 crc32 instruction</summary>
+  /// <param name="crc">Checksum state before the final inversion</param>
+  /// <param name="data">Data that will be added to the checksum</param>
+  /// <param name="byteCount">Number of bytes that will be added</param>
+  /// <returns>The updated checksum state</returns>
+  NUCLEX_STORAGE_TARGET_SSE42 std::uint32_t updateCrc32cSse42(
+    std::uint32_t crc, const std::uint8_t *data, std::size_t byteCount
+  ) {
+#if defined(_M_X64) || defined(__x86_64__)
+    std::uint64_t crc64 = crc;
+    while(byteCount >= 8) {
+      std::uint64_t value;
+      std::memcpy(&value, data, 8);
+      crc64 = _mm_crc32_u64(crc64, value);
+      data += 8;
+      byteCount -= 8;
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+#else
+    while(byteCount >= 4) {
+      std::uint32_t value;
+      std::memcpy(&value, data, 4);
+      crc = _mm_crc32_u32(crc, value);
+      data += 4;
+      byteCount -= 4;
+    }
+#endif
+    while(byteCount > 0) {
+      crc = _mm_crc32_u8(crc, *data);
+      ++data;
+      --byteCount;
+    }
+    return crc;
+  }
+
+#endif // defined(NUCLEX_STORAGE_HAVE_SSE42) || defined(NUCLEX_STORAGE_CRC32C_DISPATCH)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_ARM_CRC32)
+
+  /// <summary>Updates a CRC-32C checksum using the ARMv8 CRC32 extension</summary>
+  /// <param name="crc">Checksum state before the final inversion</param>
+  /// <param name="data">Data that will be added to the checksum</param>
+  /// <param name="byteCount">Number of bytes that will be added</param>
+  /// <returns>The updated checksum state</returns>
+  std::uint32_t updateCrc32cArm(
+    std::uint32_t crc, const std::uint8_t *data, std::size_t byteCount
+  ) {
+    while(byteCount >= 8) {
+      std::uint64_t value;
+      std::memcpy(&value, data, 8);
+      crc = __crc32cd(crc, value);
+      data += 8;
+      byteCount -= 8;
+    }
+    while(byteCount > 0) {
+      crc = __crc32cb(crc, *data);
+      ++data;
+      --byteCount;
+    }
+    return crc;
+  }
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ARM_CRC32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_STORAGE_HAVE_SSE42) && !defined(NUCLEX_STORAGE_HAVE_ARM_CRC32)
+
+  /// <summary>Updates a CRC-32C checksum using lookup tables</summary>
+  /// <param name="crc">Checksum state before the final inversion</param>
+  /// <param name="data">Data that will be added to the checksum</param>
+  /// <param name="byteCount">Number of bytes that will be added</param>
+  /// <returns>The updated checksum state</returns>
+  std::uint32_t updateCrc32cPortable(
+    std::uint32_t crc, const std::uint8_t *data, std::size_t byteCount
+  ) {
+    static const Crc32cTables tables;
+
+    // Slicing-by-8: the CRC is xor'ed into the first four bytes and all eight bytes
+    // are looked up in parallel, each in the table for its distance from the end
+    while(byteCount >= 8) {
+      std::uint32_t low = crc ^ (
+        static_cast<std::uint32_t>(data[0]) |
+        (static_cast<std::uint32_t>(data[1]) << 8) |
+        (static_cast<std::uint32_t>(data[2]) << 16) |
+        (static_cast<std::uint32_t>(data[3]) << 24)
+      );
+      crc = (
+        tables.Values[7][low & 0xFF] ^
+        tables.Values[6][(low >> 8) & 0xFF] ^
+        tables.Values[5][(low >> 16) & 0xFF] ^
+        tables.Values[4][low >> 24] ^
+        tables.Values[3][data[4]] ^
+        tables.Values[2][data[5]] ^
+        tables.Values[1][data[6]] ^
+        tables.Values[0][data[7]]
+      );
+      data += 8;
+      byteCount -= 8;
+    }
+    while(byteCount > 0) {
+      crc = (crc >> 8) ^ tables.Values[0][(crc ^ *data) & 0xFF];
+      ++data;
+      --byteCount;
+    }
+    return crc;
+  }
+
+#endif // !defined(NUCLEX_STORAGE_HAVE_SSE42) && !defined(NUCLEX_STORAGE_HAVE_ARM_CRC32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Updates a CRC-32C checksum with the contents of a buffer</summary>
+  /// <param name="crc">Checksum state before the final inversion</param>
+  /// <param name="data">Data that will be added to the checksum</param>
+  /// <param name="byteCount">Number of bytes that will be added</param>
+  /// <returns>The updated checksum state</returns>
+  std::uint32_t updateCrc32c(std::uint32_t crc, const std::uint8_t *data, std::size_t byteCount) {
+#if defined(NUCLEX_STORAGE_HAVE_SSE42)
+    return updateCrc32cSse42(crc, data, byteCount);
+#elif defined(NUCLEX_STORAGE_HAVE_ARM_CRC32)
+    return updateCrc32cArm(crc, data, byteCount);
+#elif defined(NUCLEX_STORAGE_CRC32C_DISPATCH)
+    typedef std::uint32_t UpdateFunction(std::uint32_t, const std::uint8_t *, std::size_t);
+    static UpdateFunction *const update = Nuclex::Support::KernelDispatch<UpdateFunction>()
+      .Prefer(Nuclex::Support::CpuFeatures::Get().HasSse42, &updateCrc32cSse42)
+      .Otherwise(&updateCrc32cPortable);
+    return update(crc, data, byteCount);
+#else
+    return updateCrc32cPortable(crc, data, byteCount);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Crc32c::Update(const void *data, std::size_t byteCount) {
+    this->state = updateCrc32c(this->state, static_cast<const std::uint8_t *>(data), byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Crc32c::Update(const Blob &blob) {
+    ChecksumInput::AddBlob(*this, blob);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Crc32c::Update(Binary::InputStream &stream) {
+    ChecksumInput::AddStream(*this, stream);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
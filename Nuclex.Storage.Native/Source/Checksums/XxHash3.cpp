@@ -0,0 +1,560 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Checksums/XxHash3.h"
+#include "ChecksumInput.h"
+
+#include <cstring> // for std::memcpy()
+
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h> // for _umul128()
+#endif
+
+// The algorithm and its constants follow the xxHash reference implementation
+// by Yann Collet (BSD 2-clause license), https://github.com/Cyan4973/xxHash
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::uint32_t Prime32_1 = 0x9E3779B1U;
+  const std::uint32_t Prime32_2 = 0x85EBCA77U;
+  const std::uint32_t Prime32_3 = 0xC2B2AE3DU;
+  const std::uint64_t Prime64_1 = 0x9E3779B185EBCA87ULL;
+  const std::uint64_t Prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+  const std::uint64_t Prime64_3 = 0x165667B19E3779F9ULL;
+  const std::uint64_t Prime64_4 = 0x85EBCA77C2B2AE63ULL;
+  const std::uint64_t Prime64_5 = 0x27D4EB2F165667C5ULL;
+  const std::uint64_t PrimeMx1 = 0x165667919E3779F9ULL;
+  const std::uint64_t PrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+  /// <summary>Number of bytes accumulated in one step of the long input loop</summary>
+  const std::size_t StripeByteCount = 64;
+
+  /// <summary>Number of bytes in the default secret</summary>
+  const std::size_t SecretByteCount = 192;
+
+  /// <summary>Number of stripes after which the accumulators are scrambled</summary>
+  const std::size_t StripesPerBlock = (SecretByteCount - StripeByteCount) / 8;
+
+  /// <summary>Number of bytes in the internal buffer used for incremental hashing</summary>
+  const std::size_t BufferByteCount = 256;
+
+  /// <summary>Largest input that is hashed without the stripe accumulators</summary>
+  const std::size_t MidSizeMaximumByteCount = 240;
+
+  /// <summary>Pseudo-random bytes that are mixed with the input</summary>
+  const std::uint8_t Secret[SecretByteCount] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a 32 bit integer stored in little endian byte order</summary>
+  /// <param name="source">Address at which the integer is stored</param>
+  /// <returns>The loaded integer</returns>
+  inline std::uint32_t readUInt32(const std::uint8_t *source) {
+#if defined(NUCLEX_STORAGE_LITTLE_ENDIAN)
+    std::uint32_t value;
+    std::memcpy(&value, source, 4);
+    return value;
+#else
+    return (
+      static_cast<std::uint32_t>(source[0]) |
+      (static_cast<std::uint32_t>(source[1]) << 8) |
+      (static_cast<std::uint32_t>(source[2]) << 16) |
+      (static_cast<std::uint32_t>(source[3]) << 24)
+    );
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a 64 bit integer stored in little endian byte order</summary>
+  /// <param name="source">Address at which the integer is stored</param>
+  /// <returns>The loaded integer</returns>
+  inline std::uint64_t readUInt64(const std::uint8_t *source) {
+#if defined(NUCLEX_STORAGE_LITTLE_ENDIAN)
+    std::uint64_t value;
+    std::memcpy(&value, source, 8);
+    return value;
+#else
+    return (
+      static_cast<std::uint64_t>(readUInt32(source)) |
+      (static_cast<std::uint64_t>(readUInt32(source + 4)) << 32)
+    );
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rotates the bits of a 64 bit integer to the left</summary>
+  /// <param name="value">Integer whose bits will be rotated</param>
+  /// <param name="bitCount">Number of bits to rotate by, between 1 and 63</param>
+  /// <returns>The rotated integer</returns>
+  inline std::uint64_t rotateLeft(std::uint64_t value, int bitCount) {
+    return (value << bitCount) | (value >> (64 - bitCount));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of a 64 bit integer</summary>
+  /// <param name="value">Integer whose bytes will be reversed</param>
+  /// <returns>The integer with its bytes in reverse order</returns>
+  inline std::uint64_t swapBytes(std::uint64_t value) {
+    value = ((value & 0x00FF00FF00FF00FFULL) << 8) | ((value >> 8) & 0x00FF00FF00FF00FFULL);
+    value = ((value & 0x0000FFFF0000FFFFULL) << 16) | ((value >> 16) & 0x0000FFFF0000FFFFULL);
+    return (value << 32) | (value >> 32);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(__SIZEOF_INT128__)
+  /// <summary>Native 128 bit integer of GCC and clang</summary>
+  /// <remarks>
+  ///   Declared as an extension so -Wpedantic builds don't warn about the non-ISO type
+  /// </remarks>
+  __extension__ typedef unsigned __int128 NativeUInt128;
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Multiplies two 64 bit integers and folds the 128 bit result</summary>
+  /// <param name="left">First integer that will be multiplied</param>
+  /// <param name="right">Second integer that will be multiplied</param>
+  /// <returns>The lower and upper 64 bits of the product xor'ed together</returns>
+  inline std::uint64_t multiplyFold(std::uint64_t left, std::uint64_t right) {
+#if defined(__SIZEOF_INT128__)
+    NativeUInt128 product = static_cast<NativeUInt128>(left) * right;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    std::uint64_t high;
+    std::uint64_t low = _umul128(left, right, &high);
+    return low ^ high;
+#else
+    std::uint64_t leftLow = left & 0xFFFFFFFFU, leftHigh = left >> 32;
+    std::uint64_t rightLow = right & 0xFFFFFFFFU, rightHigh = right >> 32;
+    std::uint64_t lowLow = leftLow * rightLow;
+    std::uint64_t highLow = leftHigh * rightLow;
+    std::uint64_t lowHigh = leftLow * rightHigh;
+    std::uint64_t highHigh = leftHigh * rightHigh;
+    std::uint64_t cross = (lowLow >> 32) + (highLow & 0xFFFFFFFFU) + lowHigh;
+    std::uint64_t high = (highLow >> 32) + (cross >> 32) + highHigh;
+    std::uint64_t low = (cross << 32) | (lowLow & 0xFFFFFFFFU);
+    return low ^ high;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Final mixing step that spreads every input bit over the whole hash</summary>
+  /// <param name="hash">Hash that will be mixed</param>
+  /// <returns>The mixed hash</returns>
+  inline std::uint64_t avalanche(std::uint64_t hash) {
+    hash ^= hash >> 37;
+    hash *= PrimeMx1;
+    return hash ^ (hash >> 32);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mixes 16 bytes of input with 16 bytes of the secret</summary>
+  /// <param name="input">Input bytes that will be mixed</param>
+  /// <param name="secret">Bytes of the secret that will be mixed in</param>
+  /// <returns>A 64 bit value derived from the input and secret</returns>
+  inline std::uint64_t mix16Bytes(const std::uint8_t *input, const std::uint8_t *secret) {
+    return multiplyFold(
+      readUInt64(input) ^ readUInt64(secret),
+      readUInt64(input + 8) ^ readUInt64(secret + 8)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hashes inputs of up to 16 bytes</summary>
+  /// <param name="input">Data that will be hashed</param>
+  /// <param name="byteCount">Number of bytes in the input</param>
+  /// <returns>The hash of the input</returns>
+  std::uint64_t hashShort(const std::uint8_t *input, std::size_t byteCount) {
+    if(byteCount > 8) {
+      std::uint64_t low = readUInt64(input) ^ (readUInt64(Secret + 24) ^ readUInt64(Secret + 32));
+      std::uint64_t high = (
+        readUInt64(input + byteCount - 8) ^ (readUInt64(Secret + 40) ^ readUInt64(Secret + 48))
+      );
+      std::uint64_t accumulator = (
+        static_cast<std::uint64_t>(byteCount) + swapBytes(low) + high + multiplyFold(low, high)
+      );
+      return avalanche(accumulator);
+    }
+
+    if(byteCount >= 4) {
+      std::uint64_t value = (
+        readUInt32(input + byteCount - 4) +
+        (static_cast<std::uint64_t>(readUInt32(input)) << 32)
+      );
+      std::uint64_t hash = value ^ (readUInt64(Secret + 8) ^ readUInt64(Secret + 16));
+      hash ^= rotateLeft(hash, 49) ^ rotateLeft(hash, 24);
+      hash *= PrimeMx2;
+      hash ^= (hash >> 35) + byteCount;
+      hash *= PrimeMx2;
+      return hash ^ (hash >> 28);
+    }
+
+    std::uint64_t hash;
+    if(byteCount > 0) {
+      std::uint32_t combined = (
+        (static_cast<std::uint32_t>(input[0]) << 16) |
+        (static_cast<std::uint32_t>(input[byteCount >> 1]) << 24) |
+        static_cast<std::uint32_t>(input[byteCount - 1]) |
+        (static_cast<std::uint32_t>(byteCount) << 8)
+      );
+      hash = combined ^ static_cast<std::uint64_t>(readUInt32(Secret) ^ readUInt32(Secret + 4));
+    } else {
+      hash = readUInt64(Secret + 56) ^ readUInt64(Secret + 64);
+    }
+
+    // XXH64's avalanche
+    hash ^= hash >> 33;
+    hash *= Prime64_2;
+    hash ^= hash >> 29;
+    hash *= Prime64_3;
+    return hash ^ (hash >> 32);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hashes inputs of 17 to 240 bytes</summary>
+  /// <param name="input">Data that will be hashed</param>
+  /// <param name="byteCount">Number of bytes in the input</param>
+  /// <returns>The hash of the input</returns>
+  std::uint64_t hashMedium(const std::uint8_t *input, std::size_t byteCount) {
+    std::uint64_t accumulator = static_cast<std::uint64_t>(byteCount) * Prime64_1;
+
+    // Up to 128 bytes, pairs of 16 byte pieces from both ends are mixed in
+    if(byteCount <= 128) {
+      if(byteCount > 32) {
+        if(byteCount > 64) {
+          if(byteCount > 96) {
+            accumulator += mix16Bytes(input + 48, Secret + 96);
+            accumulator += mix16Bytes(input + byteCount - 64, Secret + 112);
+          }
+          accumulator += mix16Bytes(input + 32, Secret + 64);
+          accumulator += mix16Bytes(input + byteCount - 48, Secret + 80);
+        }
+        accumulator += mix16Bytes(input + 16, Secret + 32);
+        accumulator += mix16Bytes(input + byteCount - 32, Secret + 48);
+      }
+      accumulator += mix16Bytes(input, Secret);
+      accumulator += mix16Bytes(input + byteCount - 16, Secret + 16);
+      return avalanche(accumulator);
+    }
+
+    // Beyond that, all 16 byte pieces are mixed in order
+    std::size_t roundCount = byteCount / 16;
+    for(std::size_t round = 0; round < 8; ++round) {
+      accumulator += mix16Bytes(input + round * 16, Secret + round * 16);
+    }
+    accumulator = avalanche(accumulator);
+    for(std::size_t round = 8; round < roundCount; ++round) {
+      accumulator += mix16Bytes(input + round * 16, Secret + (round - 8) * 16 + 3);
+    }
+    accumulator += mix16Bytes(input + byteCount - 16, Secret + 136 - 17);
+    return avalanche(accumulator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Adds a 64 byte stripe of input to the accumulators</summary>
+  /// <param name="accumulators">Accumulators the stripe will be added to</param>
+  /// <param name="stripe">Stripe of input that will be accumulated</param>
+  /// <param name="secret">Bytes of the secret that will be mixed in</param>
+  inline void accumulateStripe(
+    std::uint64_t *accumulators, const std::uint8_t *stripe, const std::uint8_t *secret
+  ) {
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+    __m128i *vectors = reinterpret_cast<__m128i *>(accumulators);
+    for(std::size_t index = 0; index < 4; ++index) {
+      __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stripe) + index);
+      __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + index);
+      __m128i dataKey = _mm_xor_si128(data, key);
+
+      // Multiply the lower and upper 32 bits of each 64 bit lane with each other
+      __m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+      __m128i product = _mm_mul_epu32(dataKey, dataKeyHigh);
+
+      // Each lane also receives the plain input of its neighbour
+      __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      __m128i vector = _mm_loadu_si128(vectors + index);
+      vector = _mm_add_epi64(vector, swapped);
+      _mm_storeu_si128(vectors + index, _mm_add_epi64(vector, product));
+    }
+#else
+    for(std::size_t index = 0; index < 8; ++index) {
+      std::uint64_t data = readUInt64(stripe + index * 8);
+      std::uint64_t dataKey = data ^ readUInt64(secret + index * 8);
+      accumulators[index ^ 1] += data;
+      accumulators[index] += (dataKey & 0xFFFFFFFFU) * (dataKey >> 32);
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Scrambles the accumulators after a block of stripes</summary>
+  /// <param name="accumulators">Accumulators that will be scrambled</param>
+  /// <param name="secret">Bytes of the secret that will be mixed in</param>
+  inline void scrambleAccumulators(std::uint64_t *accumulators, const std::uint8_t *secret) {
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+    __m128i *vectors = reinterpret_cast<__m128i *>(accumulators);
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(Prime32_1));
+    for(std::size_t index = 0; index < 4; ++index) {
+      __m128i vector = _mm_loadu_si128(vectors + index);
+      vector = _mm_xor_si128(vector, _mm_srli_epi64(vector, 47));
+      __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(secret) + index);
+      __m128i dataKey = _mm_xor_si128(vector, key);
+
+      // 64 bit multiplication by a 32 bit constant, assembled from two 32 bit halves
+      __m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+      __m128i productLow = _mm_mul_epu32(dataKey, prime);
+      __m128i productHigh = _mm_mul_epu32(dataKeyHigh, prime);
+      _mm_storeu_si128(
+        vectors + index, _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32))
+      );
+    }
+#else
+    for(std::size_t index = 0; index < 8; ++index) {
+      std::uint64_t accumulator = accumulators[index];
+      accumulator ^= accumulator >> 47;
+      accumulator ^= readUInt64(secret + index * 8);
+      accumulators[index] = accumulator * Prime32_1;
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fills the accumulators with their initial values</summary>
+  /// <param name="accumulators">Accumulators that will be initialized</param>
+  void initializeAccumulators(std::uint64_t *accumulators) {
+    accumulators[0] = Prime32_3;
+    accumulators[1] = Prime64_1;
+    accumulators[2] = Prime64_2;
+    accumulators[3] = Prime64_3;
+    accumulators[4] = Prime64_4;
+    accumulators[5] = Prime32_2;
+    accumulators[6] = Prime64_5;
+    accumulators[7] = Prime32_1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Accumulates the final stripe and merges the accumulators into the hash</summary>
+  /// <param name="accumulators">Accumulators holding all but the final stripe</param>
+  /// <param name="lastStripe">Last 64 bytes of the input</param>
+  /// <param name="totalByteCount">Total number of bytes in the input</param>
+  /// <returns>The hash of the input</returns>
+  std::uint64_t finishLong(
+    std::uint64_t *accumulators, const std::uint8_t *lastStripe, std::uint64_t totalByteCount
+  ) {
+    accumulateStripe(accumulators, lastStripe, Secret + SecretByteCount - StripeByteCount - 7);
+
+    std::uint64_t hash = totalByteCount * Prime64_1;
+    for(std::size_t index = 0; index < 4; ++index) {
+      hash += multiplyFold(
+        accumulators[index * 2] ^ readUInt64(Secret + 11 + index * 16),
+        accumulators[index * 2 + 1] ^ readUInt64(Secret + 11 + index * 16 + 8)
+      );
+    }
+
+    return avalanche(hash);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t XxHash3::Compute(const void *data, std::size_t byteCount) {
+    const std::uint8_t *input = static_cast<const std::uint8_t *>(data);
+    if(byteCount <= 16) {
+      return hashShort(input, byteCount);
+    } else if(byteCount <= MidSizeMaximumByteCount) {
+      return hashMedium(input, byteCount);
+    }
+
+    // Long inputs: all stripes but the last one go through the accumulators,
+    // which are scrambled after each full block of stripes
+    alignas(16) std::uint64_t accumulators[8];
+    initializeAccumulators(accumulators);
+
+    std::size_t stripeCount = (byteCount - 1) / StripeByteCount;
+    std::size_t stripesInBlock = 0;
+    consumeStripes(input, stripeCount, accumulators, stripesInBlock);
+
+    return finishLong(accumulators, input + byteCount - StripeByteCount, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  XxHash3::XxHash3() :
+    bufferedByteCount(0),
+    stripesInBlock(0),
+    totalByteCount(0) {
+    initializeAccumulators(this->accumulators);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XxHash3::Update(const void *data, std::size_t byteCount) {
+    const std::uint8_t *input = static_cast<const std::uint8_t *>(data);
+    this->totalByteCount += byteCount;
+
+    // As long as everything fits into the buffer, just collect it
+    if(byteCount <= BufferByteCount - this->bufferedByteCount) {
+      std::memcpy(this->buffer + this->bufferedByteCount, input, byteCount);
+      this->bufferedByteCount += byteCount;
+      return;
+    }
+
+    // More data follows the buffer, so it is safe to accumulate its stripes
+    if(this->bufferedByteCount > 0) {
+      std::size_t fillByteCount = BufferByteCount - this->bufferedByteCount;
+      std::memcpy(this->buffer + this->bufferedByteCount, input, fillByteCount);
+      input += fillByteCount;
+      byteCount -= fillByteCount;
+
+      consumeStripes(
+        this->buffer, BufferByteCount / StripeByteCount, this->accumulators, this->stripesInBlock
+      );
+      this->bufferedByteCount = 0;
+    }
+
+    // Accumulate the input directly, always keeping at least one byte back. The last
+    // stripe accumulated is copied to the end of the buffer because the final stripe
+    // may have to be assembled from it and the buffered bytes.
+    if(byteCount > BufferByteCount) {
+      std::size_t stripeCount = (byteCount - 1) / StripeByteCount;
+      consumeStripes(input, stripeCount, this->accumulators, this->stripesInBlock);
+      input += stripeCount * StripeByteCount;
+      byteCount -= stripeCount * StripeByteCount;
+
+      std::memcpy(
+        this->buffer + BufferByteCount - StripeByteCount, input - StripeByteCount,
+        StripeByteCount
+      );
+    }
+
+    std::memcpy(this->buffer, input, byteCount);
+    this->bufferedByteCount = byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XxHash3::Update(const Blob &blob) {
+    ChecksumInput::AddBlob(*this, blob);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XxHash3::Update(Binary::InputStream &stream) {
+    ChecksumInput::AddStream(*this, stream);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t XxHash3::GetValue() const {
+    if(this->totalByteCount <= MidSizeMaximumByteCount) {
+      return Compute(this->buffer, static_cast<std::size_t>(this->totalByteCount));
+    }
+
+    // Work on copies so that more data can still be added afterwards
+    alignas(16) std::uint64_t accumulators[8];
+    std::memcpy(accumulators, this->accumulators, sizeof(accumulators));
+    std::size_t stripesInBlock = this->stripesInBlock;
+
+    if(this->bufferedByteCount >= StripeByteCount) {
+      std::size_t stripeCount = (this->bufferedByteCount - 1) / StripeByteCount;
+      consumeStripes(this->buffer, stripeCount, accumulators, stripesInBlock);
+      return finishLong(
+        accumulators, this->buffer + this->bufferedByteCount - StripeByteCount,
+        this->totalByteCount
+      );
+    }
+
+    // The final stripe reaches back into bytes that have already been accumulated,
+    // which are still at the end of the buffer
+    std::uint8_t lastStripe[StripeByteCount];
+    std::size_t catchUpByteCount = StripeByteCount - this->bufferedByteCount;
+    std::memcpy(lastStripe, this->buffer + BufferByteCount - catchUpByteCount, catchUpByteCount);
+    std::memcpy(lastStripe + catchUpByteCount, this->buffer, this->bufferedByteCount);
+    return finishLong(accumulators, lastStripe, this->totalByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XxHash3::consumeStripes(
+    const std::uint8_t *stripes, std::size_t stripeCount,
+    std::uint64_t *accumulators, std::size_t &stripesInBlock
+  ) {
+    while(stripeCount > 0) {
+      std::size_t blockStripeCount = StripesPerBlock - stripesInBlock;
+      if(blockStripeCount > stripeCount) {
+        blockStripeCount = stripeCount;
+      }
+
+      const std::uint8_t *secret = Secret + stripesInBlock * 8;
+      for(std::size_t index = 0; index < blockStripeCount; ++index) {
+        accumulateStripe(accumulators, stripes, secret);
+        stripes += StripeByteCount;
+        secret += 8;
+      }
+      stripesInBlock += blockStripeCount;
+      stripeCount -= blockStripeCount;
+
+      if(stripesInBlock == StripesPerBlock) {
+        scrambleAccumulators(accumulators, Secret + SecretByteCount - StripeByteCount);
+        stripesInBlock = 0;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
@@ -0,0 +1,670 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/BlockCompressedBlob.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+#include "Nuclex/Storage/Checksums/Crc32c.h"
+#include "../Helpers/BlockCodec.h"
+#include "../Helpers/WorkerThreads.h"
+
+#include <algorithm> // for std::min(), std::copy()
+#include <condition_variable> // for std::condition_variable
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::function
+#include <map> // for std::map
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Magic bytes at the beginning of a block-compressed container</summary>
+  const std::uint8_t ContainerSignature[4] = { 'N', 'B', 'L', 'K' };
+
+  /// <summary>Version of the container format</summary>
+  const std::uint32_t ContainerFormatVersion = 1;
+
+  /// <summary>Number of bytes in the header of a block-compressed container</summary>
+  /// <remarks>
+  ///   Signature (4), format version (4), algorithm ID (8), block size (4), flags (4),
+  ///   uncompressed size (8), location of the block index (8)
+  /// </remarks>
+  const std::size_t HeaderByteCount = 40;
+
+  /// <summary>Flag indicating that the index holds a CRC-32C of each compressed block</summary>
+  /// <remarks>
+  ///   The checksums follow the block offsets in the index, so containers written
+  ///   before this flag existed, where the field was zero, are read as before.
+  /// </remarks>
+  const std::uint32_t BlockChecksumsFlag = 1;
+
+  /// <summary>Number of blocks per thread that may wait to be written</summary>
+  const std::size_t PendingBlocksPerThread = 2;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a 32 bit integer in little endian byte order</summary>
+  /// <param name="target">Address at which the integer will be stored</param>
+  /// <param name="value">Value that will be stored</param>
+  void writeUInt32(std::uint8_t *target, std::uint32_t value) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      target[index] = static_cast<std::uint8_t>(value >> (index * 8));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a 64 bit integer in little endian byte order</summary>
+  /// <param name="target">Address at which the integer will be stored</param>
+  /// <param name="value">Value that will be stored</param>
+  void writeUInt64(std::uint8_t *target, std::uint64_t value) {
+    for(std::size_t index = 0; index < 8; ++index) {
+      target[index] = static_cast<std::uint8_t>(value >> (index * 8));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a 32 bit integer stored in little endian byte order</summary>
+  /// <param name="source">Address at which the integer is stored</param>
+  /// <returns>The loaded integer</returns>
+  std::uint32_t readUInt32(const std::uint8_t *source) {
+    std::uint32_t value = 0;
+    for(std::size_t index = 0; index < 4; ++index) {
+      value |= static_cast<std::uint32_t>(source[index]) << (index * 8);
+    }
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a 64 bit integer stored in little endian byte order</summary>
+  /// <param name="source">Address at which the integer is stored</param>
+  /// <returns>The loaded integer</returns>
+  std::uint64_t readUInt64(const std::uint8_t *source) {
+    std::uint64_t value = 0;
+    for(std::size_t index = 0; index < 8; ++index) {
+      value |= static_cast<std::uint64_t>(source[index]) << (index * 8);
+    }
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hands out blocks to worker threads and writes their results in order</summary>
+  /// <remarks>
+  ///   Blocks are handed to the worker threads in order. Results are written in order,
+  ///   too, by whichever thread finds the next block to be ready, so threads never wait
+  ///   for each other unless too many finished blocks are already waiting to be written.
+  ///   Writing in order keeps blobs from having gaps and limits memory use.
+  /// </remarks>
+  class OrderedBlockPipeline {
+
+    /// <summary>Signature of the method that writes the result of a block</summary>
+    /// <param name="blockIndex">Index of the block whose result will be written</param>
+    /// <param name="result">Result that the worker produced for the block</param>
+    public: typedef std::function<
+      void(std::size_t blockIndex, const std::vector<std::uint8_t> &result)
+    > WriteFunction;
+
+    /// <summary>Initializes a new pipeline for the specified number of blocks</summary>
+    /// <param name="blockCount">Number of blocks that will be processed</param>
+    /// <param name="threadCount">Number of threads that will process blocks</param>
+    /// <param name="write">Method that will be called to write each block's result</param>
+    public: OrderedBlockPipeline(
+      std::size_t blockCount, std::size_t threadCount, const WriteFunction &write
+    ) :
+      blockCount(blockCount),
+      maximumPendingBlockCount(threadCount * PendingBlocksPerThread),
+      write(write),
+      nextBlockToClaim(0),
+      nextBlockToWrite(0),
+      isWriting(false) {}
+
+    /// <summary>Claims the next block for processing by the calling thread</summary>
+    /// <param name="blockIndex">Receives the index of the claimed block</param>
+    /// <returns>True if a block was claimed, false if there is nothing more to do</returns>
+    public: bool Claim(std::size_t &blockIndex) {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->blockWritten.wait(
+        lock,
+        [this]() {
+          return (
+            this->firstError ||
+            (this->nextBlockToClaim >= this->blockCount) ||
+            (this->nextBlockToClaim < this->nextBlockToWrite + this->maximumPendingBlockCount)
+          );
+        }
+      );
+      if(this->firstError || (this->nextBlockToClaim >= this->blockCount)) {
+        return false;
+      }
+
+      blockIndex = this->nextBlockToClaim++;
+      return true;
+    }
+
+    /// <summary>Hands in the result of a block and writes all results that are ready</summary>
+    /// <param name="blockIndex">Index of the block the result is for</param>
+    /// <param name="result">
+    ///   Result of the block. Taken over by the pipeline, the vector will hold the memory
+    ///   of a previously written result afterwards.
+    /// </param>
+    public: void Complete(std::size_t blockIndex, std::vector<std::uint8_t> &result) {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->pendingBlocks[blockIndex].swap(result);
+      if(this->isWriting) {
+        return; // Another thread is writing and will pick up this block
+      }
+
+      this->isWriting = true;
+      try {
+        for(;;) {
+          std::map<std::size_t, std::vector<std::uint8_t>>::iterator next = (
+            this->pendingBlocks.find(this->nextBlockToWrite)
+          );
+          if(this->firstError || (next == this->pendingBlocks.end())) {
+            break;
+          }
+
+          result.swap(next->second);
+          this->pendingBlocks.erase(next);
+          lock.unlock();
+
+          this->write(this->nextBlockToWrite, result);
+
+          lock.lock();
+          ++this->nextBlockToWrite;
+          this->blockWritten.notify_all();
+        }
+      }
+      catch(...) {
+        lock.lock();
+        this->isWriting = false;
+        throw;
+      }
+      this->isWriting = false;
+    }
+
+    /// <summary>Records the exception being handled and stops all workers</summary>
+    public: void Fail() {
+      std::lock_guard<std::mutex> errorScope(this->mutex);
+      if(!this->firstError) {
+        this->firstError = std::current_exception();
+      }
+      this->blockWritten.notify_all();
+    }
+
+    /// <summary>Rethrows the first exception recorded by any of the workers</summary>
+    public: void RethrowIfFailed() {
+      if(this->firstError) {
+        std::rethrow_exception(this->firstError);
+      }
+    }
+
+    /// <summary>Number of blocks that need to be processed</summary>
+    private: std::size_t blockCount;
+    /// <summary>Maximum number of finished blocks that may wait to be written</summary>
+    private: std::size_t maximumPendingBlockCount;
+    /// <summary>Method that writes the result of a block</summary>
+    private: WriteFunction write;
+
+    /// <summary>Must be held while accessing any of the fields below</summary>
+    private: std::mutex mutex;
+    /// <summary>Signalled whenever a block was written or a worker failed</summary>
+    private: std::condition_variable blockWritten;
+    /// <summary>Index of the next block that will be handed out</summary>
+    private: std::size_t nextBlockToClaim;
+    /// <summary>Index of the next block that will be written</summary>
+    private: std::size_t nextBlockToWrite;
+    /// <summary>Whether a thread is currently writing finished blocks</summary>
+    private: bool isWriting;
+    /// <summary>Finished blocks waiting for the blocks before them</summary>
+    private: std::map<std::size_t, std::vector<std::uint8_t>> pendingBlocks;
+    /// <summary>First exception that occurred in any of the workers</summary>
+    private: std::exception_ptr firstError;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t BlockCompressedBlob::Compress(
+    const CompressionAlgorithm &algorithm, const Blob &source, Blob &target,
+    std::size_t blockByteCount /* = DefaultBlockByteCount */, std::size_t threadCount /* = 0 */,
+    bool storeChecksums /* = false */
+  ) {
+    if((blockByteCount == 0) || (blockByteCount > 0xFFFFFFFFU)) {
+      throw std::invalid_argument(u8"Block size must be between 1 byte and 4 GiB");
+    }
+
+    std::uint64_t uncompressedByteCount = source.GetSize();
+    std::size_t blockCount = static_cast<std::size_t>(
+      (uncompressedByteCount + blockByteCount - 1) / blockByteCount
+    );
+    threadCount = Helpers::WorkerThreads::ChooseThreadCount(threadCount, blockCount);
+
+    // Reserve the space for the header, it will be written once the index is known.
+    // This also keeps blobs that can't have gaps from rejecting the first block.
+    {
+      std::uint8_t header[HeaderByteCount] = { 0 };
+      target.WriteAt(0, header, HeaderByteCount);
+    }
+
+    std::vector<std::uint64_t> blockOffsets(blockCount + 1);
+    blockOffsets[0] = HeaderByteCount;
+    std::vector<std::uint32_t> blockChecksums(storeChecksums ? blockCount : 0);
+
+    OrderedBlockPipeline pipeline(
+      blockCount, threadCount,
+      [&](std::size_t blockIndex, const std::vector<std::uint8_t> &block) {
+        if(storeChecksums) {
+          blockChecksums[blockIndex] = Checksums::Crc32c::Compute(block.data(), block.size());
+        }
+        target.WriteAt(blockOffsets[blockIndex], block.data(), block.size());
+        blockOffsets[blockIndex + 1] = blockOffsets[blockIndex] + block.size();
+      }
+    );
+    Helpers::WorkerThreads::Run(
+      threadCount,
+      [&]() {
+        try {
+          std::unique_ptr<Compressor> compressor = algorithm.CreateCompressor();
+          std::vector<std::uint8_t> uncompressed;
+          std::vector<std::uint8_t> compressed;
+          bool isFirstBlock = true;
+
+          std::size_t blockIndex;
+          while(pipeline.Claim(blockIndex)) {
+            std::uint64_t location = static_cast<std::uint64_t>(blockIndex) * blockByteCount;
+            std::size_t byteCount = static_cast<std::size_t>(
+              std::min<std::uint64_t>(blockByteCount, uncompressedByteCount - location)
+            );
+            const std::uint8_t *block = source.TryGetContiguousSpan(location, byteCount);
+            if(block == nullptr) {
+              uncompressed.resize(byteCount);
+              source.ReadAt(location, uncompressed.data(), byteCount);
+              block = uncompressed.data();
+            }
+
+            if(isFirstBlock) {
+              isFirstBlock = false;
+            } else {
+              compressor->Reset();
+            }
+            Helpers::BlockCodec::Compress(*compressor, block, byteCount, compressed);
+
+            pipeline.Complete(blockIndex, compressed);
+          }
+        }
+        catch(...) {
+          pipeline.Fail();
+        }
+      }
+    );
+    pipeline.RethrowIfFailed();
+
+    // Append the block index after the last block
+    std::uint64_t indexLocation = blockOffsets[blockCount];
+    std::size_t indexByteCount = blockCount * (storeChecksums ? 12 : 8);
+    if(blockCount > 0) {
+      std::vector<std::uint8_t> index(indexByteCount);
+      for(std::size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+        writeUInt64(index.data() + blockIndex * 8, blockOffsets[blockIndex]);
+      }
+      for(std::size_t blockIndex = 0; blockIndex < blockChecksums.size(); ++blockIndex) {
+        writeUInt32(index.data() + blockCount * 8 + blockIndex * 4, blockChecksums[blockIndex]);
+      }
+      target.WriteAt(indexLocation, index.data(), index.size());
+    }
+
+    // Finally write the header, which is only complete now that the index exists
+    {
+      std::uint8_t header[HeaderByteCount];
+      std::copy(ContainerSignature, ContainerSignature + 4, header);
+      writeUInt32(header + 4, ContainerFormatVersion);
+      std::array<std::uint8_t, 8> id = algorithm.GetId();
+      std::copy(id.begin(), id.end(), header + 8);
+      writeUInt32(header + 16, static_cast<std::uint32_t>(blockByteCount));
+      writeUInt32(header + 20, storeChecksums ? BlockChecksumsFlag : 0);
+      writeUInt64(header + 24, uncompressedByteCount);
+      writeUInt64(header + 32, indexLocation);
+      target.WriteAt(0, header, HeaderByteCount);
+    }
+
+    return indexLocation + indexByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlockCompressedBlob::BlockCompressedBlob(
+    const std::shared_ptr<const Blob> &container,
+    const std::shared_ptr<const CompressionAlgorithm> &algorithm,
+    std::size_t cachedBlockCount /* = DefaultCachedBlockCount */
+  ) :
+    container(container),
+    algorithm(algorithm),
+    uncompressedByteCount(0),
+    blockByteCount(0),
+    hasChecksums(false),
+    useCounter(0) {
+    std::array<std::uint8_t, 8> id = readHeaderAndIndex(cachedBlockCount);
+    if(id != algorithm->GetId()) {
+      throw std::runtime_error(
+        u8"Container was compressed with a different compression algorithm"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BlockCompressedBlob::BlockCompressedBlob(
+    const std::shared_ptr<const Blob> &container,
+    const CompressionAlgorithmSelector &selector,
+    std::size_t cachedBlockCount /* = DefaultCachedBlockCount */
+  ) :
+    container(container),
+    uncompressedByteCount(0),
+    blockByteCount(0),
+    hasChecksums(false),
+    useCounter(0) {
+    std::array<std::uint8_t, 8> id = readHeaderAndIndex(cachedBlockCount);
+    this->algorithm = selector.GetAlgorithm(id);
+    if(!this->algorithm) {
+      throw std::runtime_error(
+        u8"Container was compressed with an unknown compression algorithm"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCompressedBlob::ReadAt(std::uint64_t location, void *buffer, std::size_t count) const {
+    bool isInRange = (
+      (location <= this->uncompressedByteCount) &&
+      (count <= this->uncompressedByteCount - location)
+    );
+    if(!isInRange) {
+      throw std::out_of_range(u8"Attempted read past the end of the block-compressed blob");
+    }
+
+    std::uint8_t *target = static_cast<std::uint8_t *>(buffer);
+    while(count > 0) {
+      std::size_t blockIndex = static_cast<std::size_t>(location / this->blockByteCount);
+      std::size_t offset = static_cast<std::size_t>(
+        location - static_cast<std::uint64_t>(blockIndex) * this->blockByteCount
+      );
+
+      // Reads covering a whole block can skip the cache and decompress directly
+      // into the caller's buffer, everything else goes through the cached blocks
+      std::size_t byteCount;
+      if((offset == 0) && (count >= this->blockByteCount)) {
+        byteCount = DecompressBlock(blockIndex, target);
+      } else {
+        byteCount = readFromCachedBlock(blockIndex, offset, target, count);
+      }
+
+      location += byteCount;
+      target += byteCount;
+      count -= byteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCompressedBlob::WriteAt(std::uint64_t location, const void *buffer, std::size_t count) {
+    (void)location;
+    (void)buffer;
+    (void)count;
+    throw std::runtime_error(u8"Attempted write to a read-only block-compressed blob");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t BlockCompressedBlob::DecompressBlock(
+    std::size_t blockIndex, std::uint8_t *buffer
+  ) const {
+    std::size_t blockCount = CountBlocks();
+    if(blockIndex >= blockCount) {
+      throw std::out_of_range(u8"Block index is out of range");
+    }
+
+    std::uint64_t location = static_cast<std::uint64_t>(blockIndex) * this->blockByteCount;
+    std::size_t byteCount = static_cast<std::size_t>(
+      std::min<std::uint64_t>(this->blockByteCount, this->uncompressedByteCount - location)
+    );
+
+    std::uint64_t compressedLocation = this->blockOffsets[blockIndex];
+    std::size_t compressedByteCount = static_cast<std::size_t>(
+      this->blockOffsets[blockIndex + 1] - compressedLocation
+    );
+
+    std::vector<std::uint8_t> compressedBlock;
+    const std::uint8_t *compressed = this->container->TryGetContiguousSpan(
+      compressedLocation, compressedByteCount
+    );
+    if(compressed == nullptr) {
+      compressedBlock.resize(compressedByteCount);
+      this->container->ReadAt(compressedLocation, compressedBlock.data(), compressedByteCount);
+      compressed = compressedBlock.data();
+    }
+    if(this->hasChecksums) {
+      std::uint32_t checksum = Checksums::Crc32c::Compute(compressed, compressedByteCount);
+      if(checksum != this->blockChecksums[blockIndex]) {
+        throw std::runtime_error(u8"Block of block-compressed container is damaged");
+      }
+    }
+
+    std::unique_ptr<Decompressor> decompressor = this->algorithm->CreateDecompressor();
+    Helpers::BlockCodec::Decompress(
+      *decompressor, compressed, compressedByteCount, buffer, byteCount
+    );
+
+    return byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCompressedBlob::DecompressAll(Blob &target, std::size_t threadCount /* = 0 */) const {
+    std::size_t blockCount = CountBlocks();
+    threadCount = Helpers::WorkerThreads::ChooseThreadCount(threadCount, blockCount);
+
+    std::size_t blockByteCount = this->blockByteCount;
+    OrderedBlockPipeline pipeline(
+      blockCount, threadCount,
+      [&target, blockByteCount](std::size_t blockIndex, const std::vector<std::uint8_t> &block) {
+        target.WriteAt(
+          static_cast<std::uint64_t>(blockIndex) * blockByteCount, block.data(), block.size()
+        );
+      }
+    );
+    Helpers::WorkerThreads::Run(
+      threadCount,
+      [this, &pipeline]() {
+        try {
+          std::vector<std::uint8_t> block;
+
+          std::size_t blockIndex;
+          while(pipeline.Claim(blockIndex)) {
+            block.resize(this->blockByteCount);
+            block.resize(DecompressBlock(blockIndex, block.data()));
+            pipeline.Complete(blockIndex, block);
+          }
+        }
+        catch(...) {
+          pipeline.Fail();
+        }
+      }
+    );
+    pipeline.RethrowIfFailed();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::array<std::uint8_t, 8> BlockCompressedBlob::readHeaderAndIndex(
+    std::size_t cachedBlockCount
+  ) {
+    if(cachedBlockCount == 0) {
+      throw std::invalid_argument(u8"At least one decompressed block has to be cached");
+    }
+
+    std::uint64_t containerByteCount = this->container->GetSize();
+    if(containerByteCount < HeaderByteCount) {
+      throw std::runtime_error(u8"Blob is too short to hold a block-compressed container");
+    }
+
+    std::uint8_t header[HeaderByteCount];
+    this->container->ReadAt(0, header, HeaderByteCount);
+    if(!std::equal(ContainerSignature, ContainerSignature + 4, header)) {
+      throw std::runtime_error(u8"Blob does not contain a block-compressed container");
+    }
+    if(readUInt32(header + 4) != ContainerFormatVersion) {
+      throw std::runtime_error(u8"Block-compressed container has an unsupported version");
+    }
+
+    std::array<std::uint8_t, 8> id;
+    std::copy(header + 8, header + 16, id.begin());
+    this->blockByteCount = readUInt32(header + 16);
+    std::uint32_t flags = readUInt32(header + 20);
+    this->uncompressedByteCount = readUInt64(header + 24);
+    std::uint64_t indexLocation = readUInt64(header + 32);
+    if(this->blockByteCount == 0) {
+      throw std::runtime_error(u8"Block-compressed container has an invalid block size");
+    }
+    if((flags & ~BlockChecksumsFlag) != 0) {
+      throw std::runtime_error(u8"Block-compressed container uses unsupported features");
+    }
+    this->hasChecksums = ((flags & BlockChecksumsFlag) != 0);
+    std::size_t indexEntryByteCount = this->hasChecksums ? 12 : 8;
+
+    std::uint64_t blockCount = (
+      (this->uncompressedByteCount + this->blockByteCount - 1) / this->blockByteCount
+    );
+    bool indexFits = (
+      (indexLocation >= HeaderByteCount) &&
+      (indexLocation <= containerByteCount) &&
+      (blockCount <= (containerByteCount - indexLocation) / indexEntryByteCount)
+    );
+    if(!indexFits) {
+      throw std::runtime_error(u8"Block index lies outside of the block-compressed container");
+    }
+
+    std::vector<std::uint8_t> index(static_cast<std::size_t>(blockCount) * indexEntryByteCount);
+    if(blockCount > 0) {
+      this->container->ReadAt(indexLocation, index.data(), index.size());
+    }
+
+    this->blockOffsets.resize(static_cast<std::size_t>(blockCount) + 1);
+    for(std::size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+      this->blockOffsets[blockIndex] = readUInt64(index.data() + blockIndex * 8);
+    }
+    this->blockOffsets[static_cast<std::size_t>(blockCount)] = indexLocation;
+    if(this->hasChecksums) {
+      const std::uint8_t *checksums = index.data() + static_cast<std::size_t>(blockCount) * 8;
+      this->blockChecksums.resize(static_cast<std::size_t>(blockCount));
+      for(std::size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex) {
+        this->blockChecksums[blockIndex] = readUInt32(checksums + blockIndex * 4);
+      }
+    }
+
+    // Make sure the blocks are in order so block sizes can't underflow
+    std::uint64_t previousOffset = HeaderByteCount;
+    for(std::size_t blockIndex = 0; blockIndex <= blockCount; ++blockIndex) {
+      if(this->blockOffsets[blockIndex] < previousOffset) {
+        throw std::runtime_error(u8"Block index of block-compressed container is damaged");
+      }
+      previousOffset = this->blockOffsets[blockIndex];
+    }
+
+    this->cachedBlocks.resize(cachedBlockCount);
+    for(std::size_t index = 0; index < cachedBlockCount; ++index) {
+      this->cachedBlocks[index].BlockIndex = static_cast<std::size_t>(blockCount);
+      this->cachedBlocks[index].LastUse = 0;
+    }
+
+    return id;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t BlockCompressedBlob::readFromCachedBlock(
+    std::size_t blockIndex, std::size_t offset, std::uint8_t *target, std::size_t count
+  ) const {
+    std::unique_lock<std::mutex> cacheLock(this->cacheMutex);
+
+    // Look for the block in the cache
+    CachedBlock *cachedBlock = nullptr;
+    for(std::size_t index = 0; index < this->cachedBlocks.size(); ++index) {
+      if(this->cachedBlocks[index].BlockIndex == blockIndex) {
+        cachedBlock = &this->cachedBlocks[index];
+        break;
+      }
+    }
+
+    // Decompress the block without holding the mutex so that reads from other blocks
+    // can proceed. If another thread was faster decompressing the same block,
+    // one of the copies is simply discarded.
+    if(cachedBlock == nullptr) {
+      cacheLock.unlock();
+
+      std::vector<std::uint8_t> contents(this->blockByteCount);
+      contents.resize(DecompressBlock(blockIndex, contents.data()));
+
+      // Put the block into the least recently used slot
+      cacheLock.lock();
+      CachedBlock *leastRecentlyUsed = &this->cachedBlocks[0];
+      for(std::size_t index = 0; index < this->cachedBlocks.size(); ++index) {
+        if(this->cachedBlocks[index].BlockIndex == blockIndex) {
+          cachedBlock = &this->cachedBlocks[index];
+          break;
+        }
+        if(this->cachedBlocks[index].LastUse < leastRecentlyUsed->LastUse) {
+          leastRecentlyUsed = &this->cachedBlocks[index];
+        }
+      }
+      if(cachedBlock == nullptr) {
+        cachedBlock = leastRecentlyUsed;
+        cachedBlock->BlockIndex = blockIndex;
+        cachedBlock->Contents.swap(contents);
+      }
+    }
+
+    cachedBlock->LastUse = ++this->useCounter;
+
+    std::size_t byteCount = std::min(count, cachedBlock->Contents.size() - offset);
+    std::copy(
+      cachedBlock->Contents.data() + offset, cachedBlock->Contents.data() + offset + byteCount,
+      target
+    );
+
+    return byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
@@ -0,0 +1,135 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BrotliCompressionAlgorithm.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BROTLI)
+
+#include "BrotliCompressor.h"
+#include "BrotliDecompressor.h"
+
+#include <brotli/encode.h> // for ::BrotliEncoderVersion()
+
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Speed and effectiveness of a Brotli quality level</summary>
+  struct QualityMetrics {
+
+    /// <summary>Average CPU cycles needed to compress one kilobyte</summary>
+    public: std::size_t CyclesPerKilobyte;
+    /// <summary>Average size of compressed data relative to the uncompressed data</summary>
+    public: float CompressionRatio;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measured metrics for each of Brotli's quality levels</summary>
+  /// <remarks>
+  ///   Single-threaded throughput on the Silesia corpus, converted to cycles at 3 GHz.
+  /// </remarks>
+  const QualityMetrics BrotliQualityMetrics[] = {
+    {    8400, 0.355f }, //  0: ~350 MiB/s
+    {    9800, 0.340f }, //  1: ~300 MiB/s
+    {   22500, 0.322f }, //  2: ~130 MiB/s
+    {   29300, 0.318f }, //  3: ~100 MiB/s
+    {   45000, 0.305f }, //  4:  ~65 MiB/s
+    {   73200, 0.295f }, //  5:  ~40 MiB/s
+    {   97700, 0.292f }, //  6:  ~30 MiB/s
+    {  146500, 0.290f }, //  7:  ~20 MiB/s
+    {  209300, 0.288f }, //  8:  ~14 MiB/s
+    {  293000, 0.287f }, //  9:  ~10 MiB/s
+    { 3662000, 0.260f }, // 10: ~0.8 MiB/s
+    { 4883000, 0.257f }  // 11: ~0.6 MiB/s
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a human-readable name for this compression algorithm</summary>
+  /// <param name="quality">Brotli quality level used when compressing</param>
+  /// <returns>A human-readable name for the compression algorithm</returns>
+  std::string buildAlgorithmName(int quality) {
+    std::uint32_t version = ::BrotliEncoderVersion();
+
+    std::string name(u8"Brotli compression ");
+    name.append(std::to_string(version >> 24));
+    name.push_back('.');
+    name.append(std::to_string((version >> 12) & 0xFFF));
+    name.push_back('.');
+    name.append(std::to_string(version & 0xFFF));
+    name.append(u8" (quality level ");
+    name.append(std::to_string(quality));
+    name.push_back(')');
+
+    return name;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Brotli {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BrotliCompressionAlgorithm::BrotliCompressionAlgorithm(int quality) :
+    name(buildAlgorithmName(quality)),
+    quality(quality) {
+    if((quality < BROTLI_MIN_QUALITY) || (quality > BROTLI_MAX_QUALITY)) {
+      throw std::out_of_range(u8"Brotli quality level must be between 0 and 11");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t BrotliCompressionAlgorithm::GetCompressionCyclesPerKilobyte() const {
+    return BrotliQualityMetrics[this->quality].CyclesPerKilobyte;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float BrotliCompressionAlgorithm::GetAverageCompressionRatio() const {
+    return BrotliQualityMetrics[this->quality].CompressionRatio;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Compressor> BrotliCompressionAlgorithm::CreateCompressor() const {
+    return std::unique_ptr<Compressor>(new BrotliCompressor(this->quality));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Decompressor> BrotliCompressionAlgorithm::CreateDecompressor() const {
+    return std::unique_ptr<Decompressor>(new BrotliDecompressor());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Brotli
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BROTLI)
@@ -0,0 +1,204 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BrotliCompressor.h"
+
+#include <Nuclex/Support/AllocationTracker.h> // for AllocationTracker
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#if defined(NUCLEX_STORAGE_HAVE_BROTLI)
+
+#include <stdexcept> // for std::runtime_error, std::bad_alloc
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocates memory for Brotli through the allocation tracker</summary>
+  /// <param name="opaque">Unused user data passed on by Brotli</param>
+  /// <param name="byteCount">Number of bytes that will be allocated</param>
+  /// <returns>The allocated memory or a null pointer if the allocation failed</returns>
+  void *allocateTracked(void *opaque, std::size_t byteCount) {
+    (void)opaque;
+    return Nuclex::Support::AllocationTracker::Malloc(
+      Nuclex::Support::AllocationSubsystem::Compression, byteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frees memory Brotli allocated through the allocation tracker</summary>
+  /// <param name="opaque">Unused user data passed on by Brotli</param>
+  /// <param name="memory">Memory that will be freed</param>
+  void freeTracked(void *opaque, void *memory) {
+    (void)opaque;
+    Nuclex::Support::AllocationTracker::Free(
+      Nuclex::Support::AllocationSubsystem::Compression, memory
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Brotli {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BrotliCompressor::BrotliCompressor(int quality) :
+    quality(quality),
+    state(createState()) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BrotliCompressor::~BrotliCompressor() {
+    ::BrotliEncoderDestroyInstance(this->state);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BrotliCompressor::Process(
+    const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.BrotliCompressor.Process");
+    std::size_t remainingInputByteCount = uncompressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    // Brotli may keep compressed data inside its state until it gets more output space,
+    // so it is only done when all input is consumed and nothing is left to hand out
+    while((remainingInputByteCount > 0) || ::BrotliEncoderHasMoreOutput(this->state)) {
+      if(remainingOutputByteCount == 0) {
+        break;
+      }
+
+      BROTLI_BOOL result = ::BrotliEncoderCompressStream(
+        this->state, BROTLI_OPERATION_PROCESS,
+        &remainingInputByteCount, &uncompressedBuffer,
+        &remainingOutputByteCount, &outputBuffer,
+        nullptr
+      );
+      if(result == BROTLI_FALSE) {
+        throw std::runtime_error(u8"Brotli compressor encountered an internal error");
+      }
+    }
+
+    uncompressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+
+    if((remainingInputByteCount > 0) || ::BrotliEncoderHasMoreOutput(this->state)) {
+      return StopReason::OutputBufferFull;
+    } else {
+      return StopReason::InputBufferExhausted;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BrotliCompressor::Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    return drain(BROTLI_OPERATION_FLUSH, outputBuffer, outputByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BrotliCompressor::Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.BrotliCompressor.Finish");
+    return drain(BROTLI_OPERATION_FINISH, outputBuffer, outputByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BrotliCompressor::Reset() {
+    ::BrotliEncoderState *newState = createState();
+    ::BrotliEncoderDestroyInstance(this->state);
+    this->state = newState;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ::BrotliEncoderState *BrotliCompressor::createState() const {
+    ::BrotliEncoderState *newState = ::BrotliEncoderCreateInstance(
+      &allocateTracked, &freeTracked, nullptr
+    );
+    if(newState == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    BROTLI_BOOL result = ::BrotliEncoderSetParameter(
+      newState, BROTLI_PARAM_QUALITY, static_cast<std::uint32_t>(this->quality)
+    );
+    if(result == BROTLI_FALSE) {
+      ::BrotliEncoderDestroyInstance(newState);
+      throw std::runtime_error(u8"Brotli compressor rejected the requested quality level");
+    }
+
+    return newState;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BrotliCompressor::drain(
+    ::BrotliEncoderOperation operation,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      std::size_t inputByteCount = 0;
+      const std::uint8_t *inputBuffer = nullptr;
+      BROTLI_BOOL result = ::BrotliEncoderCompressStream(
+        this->state, operation,
+        &inputByteCount, &inputBuffer,
+        &remainingOutputByteCount, &outputBuffer,
+        nullptr
+      );
+      if(result == BROTLI_FALSE) {
+        throw std::runtime_error(u8"Brotli compressor encountered an internal error");
+      }
+
+      bool isDone;
+      if(operation == BROTLI_OPERATION_FINISH) {
+        isDone = (::BrotliEncoderIsFinished(this->state) != BROTLI_FALSE);
+      } else {
+        isDone = (::BrotliEncoderHasMoreOutput(this->state) == BROTLI_FALSE);
+      }
+      if(isDone) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+    }
+
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Brotli
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BROTLI)
@@ -0,0 +1,122 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_BROTLI_BROTLICOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_BROTLI_BROTLICOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BROTLI)
+
+#include "Nuclex/Storage/Compression/Compressor.h"
+
+#include <brotli/encode.h>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Brotli {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses data with Google's Brotli algorithm</summary>
+  /// <remarks>
+  ///   The Brotli encoder state is set up once and reused for all calls. Brotli offers
+  ///   no way to rewind an encoder, so <see cref="Reset" /> has to replace the state.
+  /// </remarks>
+  class BrotliCompressor : public Compressor {
+
+    /// <summary>Initializes a new Brotli compressor</summary>
+    /// <param name="quality">Brotli quality level from 0 to 11 that will be used</param>
+    public: BrotliCompressor(int quality);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~BrotliCompressor() override;
+
+    /// <summary>Compresses data from the input buffer into the output buffer</summary>
+    /// <param name="uncompressedBuffer">Buffer holding the data to compress</param>
+    /// <param name="uncompressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the compressor stopped because it needs more input or more output space
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Writes out all data compressed so far</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the flush has completed or needs more output space</returns>
+    public: StopReason Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Ends the stream and writes out all remaining compressed data</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the stream has been completed or needs more output space</returns>
+    public: StopReason Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Prepares the compressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    /// <summary>Creates a Brotli encoder state using the configured quality</summary>
+    /// <returns>The new Brotli encoder state</returns>
+    private: ::BrotliEncoderState *createState() const;
+
+    /// <summary>Lets Brotli write out pending data without providing more input</summary>
+    /// <param name="operation">Brotli operation that will be performed</param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether all pending data has been written or more space is needed</returns>
+    private: StopReason drain(
+      ::BrotliEncoderOperation operation,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    );
+
+    private: BrotliCompressor(const BrotliCompressor &) = delete;
+    private: BrotliCompressor &operator =(const BrotliCompressor &) = delete;
+
+    /// <summary>Brotli quality level the encoder state is set up with</summary>
+    private: int quality;
+    /// <summary>Brotli encoder state holding the compressor's state</summary>
+    private: ::BrotliEncoderState *state;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Brotli
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BROTLI)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_BROTLI_BROTLICOMPRESSOR_H
@@ -0,0 +1,153 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BrotliDecompressor.h"
+
+#include <Nuclex/Support/AllocationTracker.h> // for AllocationTracker
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#if defined(NUCLEX_STORAGE_HAVE_BROTLI)
+
+#include <stdexcept> // for std::runtime_error, std::bad_alloc
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocates memory for Brotli through the allocation tracker</summary>
+  /// <param name="opaque">Unused user data passed on by Brotli</param>
+  /// <param name="byteCount">Number of bytes that will be allocated</param>
+  /// <returns>The allocated memory or a null pointer if the allocation failed</returns>
+  void *allocateTracked(void *opaque, std::size_t byteCount) {
+    (void)opaque;
+    return Nuclex::Support::AllocationTracker::Malloc(
+      Nuclex::Support::AllocationSubsystem::Compression, byteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frees memory Brotli allocated through the allocation tracker</summary>
+  /// <param name="opaque">Unused user data passed on by Brotli</param>
+  /// <param name="memory">Memory that will be freed</param>
+  void freeTracked(void *opaque, void *memory) {
+    (void)opaque;
+    Nuclex::Support::AllocationTracker::Free(
+      Nuclex::Support::AllocationSubsystem::Compression, memory
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Brotli {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BrotliDecompressor::BrotliDecompressor() :
+    state(::BrotliDecoderCreateInstance(&allocateTracked, &freeTracked, nullptr)),
+    finished(false) {
+    if(this->state == nullptr) {
+      throw std::bad_alloc();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BrotliDecompressor::~BrotliDecompressor() {
+    ::BrotliDecoderDestroyInstance(this->state);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BrotliDecompressor::Process(
+    const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.BrotliDecompressor.Process");
+    if(this->finished) {
+      compressedByteCount = 0;
+      outputByteCount = 0;
+      return StopReason::Finished;
+    }
+
+    std::size_t remainingInputByteCount = compressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    ::BrotliDecoderResult result = ::BrotliDecoderDecompressStream(
+      this->state,
+      &remainingInputByteCount, &compressedBuffer,
+      &remainingOutputByteCount, &outputBuffer,
+      nullptr
+    );
+
+    compressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+
+    switch(result) {
+      case BROTLI_DECODER_RESULT_SUCCESS: {
+        this->finished = true;
+        return StopReason::Finished;
+      }
+      case BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT: {
+        // Brotli asks for more input once it has consumed all of it, even if
+        // it still holds decompressed data that didn't fit into the output buffer
+        if(::BrotliDecoderHasMoreOutput(this->state)) {
+          return StopReason::OutputBufferFull;
+        } else {
+          return StopReason::InputBufferExhausted;
+        }
+      }
+      case BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT: {
+        return StopReason::OutputBufferFull;
+      }
+      default: {
+        std::string message(u8"Brotli decompressor failed: ");
+        message.append(::BrotliDecoderErrorString(::BrotliDecoderGetErrorCode(this->state)));
+        throw std::runtime_error(message);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BrotliDecompressor::Reset() {
+    ::BrotliDecoderState *newState = ::BrotliDecoderCreateInstance(
+      &allocateTracked, &freeTracked, nullptr
+    );
+    if(newState == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    ::BrotliDecoderDestroyInstance(this->state);
+    this->state = newState;
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Brotli
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BROTLI)
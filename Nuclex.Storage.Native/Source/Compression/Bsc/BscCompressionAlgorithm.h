@@ -0,0 +1,109 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_BSC_BSCCOMPRESSIONALGORITHM_H
+#define NUCLEX_STORAGE_COMPRESSION_BSC_BSCCOMPRESSIONALGORITHM_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#include "Nuclex/Storage/Compression/CompressionAlgorithm.h"
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Bsc {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides compressors and decompressors using the libbsc algorithm</summary>
+  /// <remarks>
+  ///   libbsc uses block sorting (the Burrows-Wheeler transform) and achieves the best
+  ///   compression ratios of the available algorithms on text-like data, decompressing
+  ///   about as fast as it compresses. It needs several times the block size in memory.
+  /// </remarks>
+  class BscCompressionAlgorithm : public CompressionAlgorithm {
+
+    /// <summary>Block size that is used unless another one is specified</summary>
+    public: static const std::size_t DefaultBlockByteCount = 8 * 1024 * 1024;
+
+    /// <summary>Initializes the libbsc compressor and decompressor factory</summary>
+    /// <param name="adaptiveCoder">
+    ///   Whether to use the adaptive entropy coder, which compresses slightly better
+    ///   but is slower than the static one
+    /// </param>
+    /// <param name="blockByteCount">Number of bytes that will be compressed as a block</param>
+    public: BscCompressionAlgorithm(
+      bool adaptiveCoder = true, std::size_t blockByteCount = DefaultBlockByteCount
+    );
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~BscCompressionAlgorithm() override = default;
+
+    /// <summary>Returns the human-readable name of the compression algorithm</summary>
+    /// <returns>The name of the compression algorithm the factory provides</returns>
+    public: const std::string &GetName() const override {
+      return this->name;
+    }
+
+    /// <summary>Returns a unique id for the compression algorithm</summary>
+    /// <returns>The compression algorithm's unique id</returns>
+    public: std::array<std::uint8_t, 8> GetId() const override {
+      return std::array<std::uint8_t, 8> {
+        'L', 'B', 'S', 'C', '0', '3', '1', '0'
+      };
+    }
+
+    /// <summary>
+    ///   Returns the average number of CPU cycles this algorithm runs for to
+    ///   compress one kilobyte of data
+    /// <summary>
+    /// <returns>The average number of CPU cycles to compress one kilobyte</returns>
+    public: std::size_t GetCompressionCyclesPerKilobyte() const override;
+
+    /// <summary>
+    ///   Returns the average size of data compressed with this algorithm as compared
+    ///   to its uncompressed size
+    /// </summary>
+    /// <returns>The average ratio of compressed size to uncompressed size</returns>
+    public: float GetAverageCompressionRatio() const override;
+
+    /// <summary>Creates a new data compressor</summary>
+    /// <returns>A new libbsc compressor using the configured coder and block size</returns>
+    public: std::unique_ptr<Compressor> CreateCompressor() const override;
+
+    /// <summary>Creates a new data decompressor</summary>
+    /// <returns>A new libbsc decompressor</returns>
+    public: std::unique_ptr<Decompressor> CreateDecompressor() const override;
+
+    /// <summary>The name of the compression algorithm</summary>
+    private: std::string name;
+    /// <summary>Whether the adaptive entropy coder will be used</summary>
+    private: bool adaptiveCoder;
+    /// <summary>Number of bytes that will be compressed as a block</summary>
+    private: std::size_t blockByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Bsc
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_BSC_BSCCOMPRESSIONALGORITHM_H
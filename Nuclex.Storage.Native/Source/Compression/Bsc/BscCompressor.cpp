@@ -0,0 +1,213 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BscCompressor.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#include "BscHelper.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Bsc {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BscCompressor::BscCompressor(std::size_t blockByteCount, int coder) :
+    blockByteCount(blockByteCount),
+    coder(coder),
+    uncompressedBlock(),
+    compressedBlock(),
+    emittedByteCount(0),
+    finished(false) {
+    this->uncompressedBlock.reserve(blockByteCount);
+    this->compressedBlock.reserve(
+      BscHelper::FramePrefixByteCount + LIBBSC_HEADER_SIZE + blockByteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BscCompressor::~BscCompressor() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BscCompressor::Process(
+    const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.BscCompressor.Process");
+    std::size_t remainingInputByteCount = uncompressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      if(!emitCompressedData(outputBuffer, remainingOutputByteCount)) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(remainingInputByteCount == 0) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+
+      std::size_t chunkByteCount = std::min(
+        remainingInputByteCount, this->blockByteCount - this->uncompressedBlock.size()
+      );
+      this->uncompressedBlock.insert(
+        this->uncompressedBlock.end(), uncompressedBuffer, uncompressedBuffer + chunkByteCount
+      );
+      uncompressedBuffer += chunkByteCount;
+      remainingInputByteCount -= chunkByteCount;
+
+      if(this->uncompressedBlock.size() == this->blockByteCount) {
+        compressBlock();
+      }
+    }
+
+    uncompressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BscCompressor::Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      if(!emitCompressedData(outputBuffer, remainingOutputByteCount)) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(this->uncompressedBlock.empty()) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+
+      compressBlock();
+    }
+
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BscCompressor::Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.BscCompressor.Finish");
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      if(!emitCompressedData(outputBuffer, remainingOutputByteCount)) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(this->finished) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+
+      if(this->uncompressedBlock.empty()) {
+        this->compressedBlock.assign(BscHelper::FramePrefixByteCount, 0); // End marker
+        this->emittedByteCount = 0;
+        this->finished = true;
+      } else {
+        compressBlock();
+      }
+    }
+
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BscCompressor::Reset() {
+    this->uncompressedBlock.clear();
+    this->compressedBlock.clear();
+    this->emittedByteCount = 0;
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BscCompressor::compressBlock() {
+    std::size_t uncompressedByteCount = this->uncompressedBlock.size();
+    this->compressedBlock.resize(
+      BscHelper::FramePrefixByteCount + LIBBSC_HEADER_SIZE + uncompressedByteCount
+    );
+
+    int result = ::bsc_compress(
+      this->uncompressedBlock.data(),
+      this->compressedBlock.data() + BscHelper::FramePrefixByteCount,
+      static_cast<int>(uncompressedByteCount),
+      LIBBSC_DEFAULT_LZPHASHSIZE, LIBBSC_DEFAULT_LZPMINLEN,
+      LIBBSC_BLOCKSORTER_BWT, this->coder, BscHelper::Features
+    );
+    if(result < LIBBSC_NO_ERROR) {
+      throw std::runtime_error(BscHelper::GetErrorMessage(result));
+    }
+
+    std::uint32_t compressedByteCount = static_cast<std::uint32_t>(result);
+    this->compressedBlock[0] = static_cast<std::uint8_t>(compressedByteCount);
+    this->compressedBlock[1] = static_cast<std::uint8_t>(compressedByteCount >> 8);
+    this->compressedBlock[2] = static_cast<std::uint8_t>(compressedByteCount >> 16);
+    this->compressedBlock[3] = static_cast<std::uint8_t>(compressedByteCount >> 24);
+    this->compressedBlock.resize(BscHelper::FramePrefixByteCount + compressedByteCount);
+
+    this->emittedByteCount = 0;
+    this->uncompressedBlock.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BscCompressor::emitCompressedData(
+    std::uint8_t *&outputBuffer, std::size_t &outputByteCount
+  ) {
+    std::size_t chunkByteCount = std::min(
+      outputByteCount, this->compressedBlock.size() - this->emittedByteCount
+    );
+    if(chunkByteCount > 0) {
+      std::memcpy(
+        outputBuffer, this->compressedBlock.data() + this->emittedByteCount, chunkByteCount
+      );
+      outputBuffer += chunkByteCount;
+      outputByteCount -= chunkByteCount;
+      this->emittedByteCount += chunkByteCount;
+    }
+
+    return (this->emittedByteCount == this->compressedBlock.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Bsc
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BSC)
@@ -0,0 +1,134 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_BSC_BSCCOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_BSC_BSCCOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#include "Nuclex/Storage/Compression/Compressor.h"
+
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Bsc {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses data with the block-sorting libbsc compressor</summary>
+  /// <remarks>
+  ///   <para>
+  ///     libbsc can only compress whole blocks, so incoming data is collected until
+  ///     a block is full, then compressed in one go. Each compressed block is preceded
+  ///     by its length as a 32 bit little endian integer and the stream ends with
+  ///     a length of zero.
+  ///   </para>
+  ///   <para>
+  ///     Flushing compresses the partial block collected so far, which costs some
+  ///     compression ratio since the block sorter works best on large blocks.
+  ///   </para>
+  /// </remarks>
+  class BscCompressor : public Compressor {
+
+    /// <summary>Initializes a new libbsc compressor</summary>
+    /// <param name="blockByteCount">Number of bytes that will be compressed as a block</param>
+    /// <param name="coder">libbsc entropy coder that will be used</param>
+    public: BscCompressor(std::size_t blockByteCount, int coder);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~BscCompressor() override;
+
+    /// <summary>Compresses data from the input buffer into the output buffer</summary>
+    /// <param name="uncompressedBuffer">Buffer holding the data to compress</param>
+    /// <param name="uncompressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the compressor stopped because it needs more input or more output space
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Writes out all data compressed so far</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the flush has completed or needs more output space</returns>
+    public: StopReason Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Ends the stream and writes out all remaining compressed data</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the stream has been completed or needs more output space</returns>
+    public: StopReason Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Prepares the compressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    /// <summary>Compresses the collected data into a new length-prefixed block</summary>
+    private: void compressBlock();
+
+    /// <summary>Copies compressed data that has not been handed out yet</summary>
+    /// <param name="outputBuffer">Buffer the compressed data will be copied into</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, will be reduced by the number
+    ///   of bytes copied
+    /// </param>
+    /// <returns>True if all compressed data has been handed out</returns>
+    private: bool emitCompressedData(std::uint8_t *&outputBuffer, std::size_t &outputByteCount);
+
+    private: BscCompressor(const BscCompressor &) = delete;
+    private: BscCompressor &operator =(const BscCompressor &) = delete;
+
+    /// <summary>Number of bytes that will be compressed as a block</summary>
+    private: std::size_t blockByteCount;
+    /// <summary>libbsc entropy coder that will be used</summary>
+    private: int coder;
+    /// <summary>Uncompressed data collected for the next block</summary>
+    private: std::vector<std::uint8_t> uncompressedBlock;
+    /// <summary>Compressed block that is being handed out</summary>
+    private: std::vector<std::uint8_t> compressedBlock;
+    /// <summary>Number of bytes from the compressed block that have been handed out</summary>
+    private: std::size_t emittedByteCount;
+    /// <summary>Whether the end of stream marker has been appended</summary>
+    private: bool finished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Bsc
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_BSC_BSCCOMPRESSOR_H
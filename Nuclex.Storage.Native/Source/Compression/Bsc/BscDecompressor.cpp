@@ -0,0 +1,191 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BscDecompressor.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#include "BscHelper.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memcpy()
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Bsc {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BscDecompressor::BscDecompressor() :
+    framePrefix(),
+    framePrefixByteCount(0),
+    compressedBlockByteCount(0),
+    compressedBlock(),
+    uncompressedBlock(),
+    emittedByteCount(0),
+    finished(false) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BscDecompressor::~BscDecompressor() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason BscDecompressor::Process(
+    const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.BscDecompressor.Process");
+    std::size_t remainingInputByteCount = compressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+
+      // Hand out decompressed data until the output buffer is full
+      {
+        std::size_t chunkByteCount = std::min(
+          remainingOutputByteCount, this->uncompressedBlock.size() - this->emittedByteCount
+        );
+        if(chunkByteCount > 0) {
+          std::memcpy(
+            outputBuffer, this->uncompressedBlock.data() + this->emittedByteCount, chunkByteCount
+          );
+          outputBuffer += chunkByteCount;
+          remainingOutputByteCount -= chunkByteCount;
+          this->emittedByteCount += chunkByteCount;
+        }
+        if(this->emittedByteCount < this->uncompressedBlock.size()) {
+          stopReason = StopReason::OutputBufferFull;
+          break;
+        }
+      }
+
+      if(this->finished) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(remainingInputByteCount == 0) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+
+      // Collect the length prefix of the next block. A length of zero ends the stream.
+      if(this->framePrefixByteCount < BscHelper::FramePrefixByteCount) {
+        std::size_t chunkByteCount = std::min(
+          remainingInputByteCount, BscHelper::FramePrefixByteCount - this->framePrefixByteCount
+        );
+        std::memcpy(
+          this->framePrefix + this->framePrefixByteCount, compressedBuffer, chunkByteCount
+        );
+        compressedBuffer += chunkByteCount;
+        remainingInputByteCount -= chunkByteCount;
+        this->framePrefixByteCount += chunkByteCount;
+
+        if(this->framePrefixByteCount == BscHelper::FramePrefixByteCount) {
+          this->compressedBlockByteCount = (
+            (static_cast<std::size_t>(this->framePrefix[0])) |
+            (static_cast<std::size_t>(this->framePrefix[1]) << 8) |
+            (static_cast<std::size_t>(this->framePrefix[2]) << 16) |
+            (static_cast<std::size_t>(this->framePrefix[3]) << 24)
+          );
+          if(this->compressedBlockByteCount == 0) {
+            this->finished = true;
+          } else if(this->compressedBlockByteCount < LIBBSC_HEADER_SIZE) {
+            throw std::runtime_error(u8"Data error - block length is too small to be valid");
+          } else {
+            this->compressedBlock.clear();
+          }
+        }
+
+        continue;
+      }
+
+      // Collect the compressed block and decompress it once it is complete
+      {
+        std::size_t chunkByteCount = std::min(
+          remainingInputByteCount, this->compressedBlockByteCount - this->compressedBlock.size()
+        );
+        this->compressedBlock.insert(
+          this->compressedBlock.end(), compressedBuffer, compressedBuffer + chunkByteCount
+        );
+        compressedBuffer += chunkByteCount;
+        remainingInputByteCount -= chunkByteCount;
+
+        if(this->compressedBlock.size() == this->compressedBlockByteCount) {
+          decompressBlock();
+        }
+      }
+    }
+
+    compressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BscDecompressor::Reset() {
+    this->framePrefixByteCount = 0;
+    this->compressedBlockByteCount = 0;
+    this->compressedBlock.clear();
+    this->uncompressedBlock.clear();
+    this->emittedByteCount = 0;
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BscDecompressor::decompressBlock() {
+    int blockByteCount, dataByteCount;
+    int result = ::bsc_block_info(
+      this->compressedBlock.data(), LIBBSC_HEADER_SIZE,
+      &blockByteCount, &dataByteCount, BscHelper::Features
+    );
+    if(result != LIBBSC_NO_ERROR) {
+      throw std::runtime_error(BscHelper::GetErrorMessage(result));
+    }
+    if(static_cast<std::size_t>(blockByteCount) != this->compressedBlockByteCount) {
+      throw std::runtime_error(u8"Data error - block length does not match block header");
+    }
+
+    this->uncompressedBlock.resize(static_cast<std::size_t>(dataByteCount));
+    result = ::bsc_decompress(
+      this->compressedBlock.data(), blockByteCount,
+      this->uncompressedBlock.data(), dataByteCount,
+      BscHelper::Features
+    );
+    if(result != LIBBSC_NO_ERROR) {
+      throw std::runtime_error(BscHelper::GetErrorMessage(result));
+    }
+
+    this->emittedByteCount = 0;
+    this->framePrefixByteCount = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Bsc
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BSC)
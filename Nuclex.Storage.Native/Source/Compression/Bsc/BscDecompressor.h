@@ -0,0 +1,100 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_BSC_BSCDECOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_BSC_BSCDECOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#include "Nuclex/Storage/Compression/Decompressor.h"
+
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Bsc {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decompresses data compressed with the block-sorting libbsc compressor</summary>
+  /// <remarks>
+  ///   Expects the length-prefixed blocks produced by the <see cref="BscCompressor" />.
+  ///   Each block is collected completely before it is decompressed in one go.
+  /// </remarks>
+  class BscDecompressor : public Decompressor {
+
+    /// <summary>Initializes a new libbsc decompressor</summary>
+    public: BscDecompressor();
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~BscDecompressor() override;
+
+    /// <summary>Decompresses data from the input buffer into the output buffer</summary>
+    /// <param name="compressedBuffer">Buffer holding the compressed data</param>
+    /// <param name="compressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the decompressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the decompressor stopped because it needs more input, needs more output
+    ///   space or has reached the end of the compressed data
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Prepares the decompressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    /// <summary>Decompresses the collected block</summary>
+    private: void decompressBlock();
+
+    private: BscDecompressor(const BscDecompressor &) = delete;
+    private: BscDecompressor &operator =(const BscDecompressor &) = delete;
+
+    /// <summary>Length prefix of the next block as far as it has been received</summary>
+    private: std::uint8_t framePrefix[4];
+    /// <summary>Number of bytes of the length prefix that have been received</summary>
+    private: std::size_t framePrefixByteCount;
+    /// <summary>Total length of the compressed block being collected</summary>
+    private: std::size_t compressedBlockByteCount;
+    /// <summary>Compressed data collected for the current block</summary>
+    private: std::vector<std::uint8_t> compressedBlock;
+    /// <summary>Decompressed block that is being handed out</summary>
+    private: std::vector<std::uint8_t> uncompressedBlock;
+    /// <summary>Number of bytes from the decompressed block that have been handed out</summary>
+    private: std::size_t emittedByteCount;
+    /// <summary>Whether the end of the compressed stream has been reached</summary>
+    private: bool finished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Bsc
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_BSC_BSCDECOMPRESSOR_H
@@ -0,0 +1,97 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BscHelper.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#include <mutex> // for std::once_flag, std::call_once()
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures libbsc is initialized exactly once</summary>
+  std::once_flag libBscInitializedFlag;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Bsc {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const int BscHelper::Features;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::size_t BscHelper::FramePrefixByteCount;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BscHelper::Initialize() {
+    std::call_once(
+      libBscInitializedFlag,
+      []() {
+        int result = ::bsc_init(Features);
+        if(result != LIBBSC_NO_ERROR) {
+          throw std::runtime_error(GetErrorMessage(result));
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::string BscHelper::GetErrorMessage(int bscResult) {
+    switch(bscResult) {
+      case LIBBSC_BAD_PARAMETER: {
+        return std::string(u8"Bad parameter - invalid settings passed to libbsc");
+      }
+      case LIBBSC_NOT_ENOUGH_MEMORY: {
+        return std::string(u8"Memory error - libbsc could not allocate enough memory");
+      }
+      case LIBBSC_NOT_SUPPORTED: {
+        return std::string(u8"Not supported - data uses a feature libbsc was built without");
+      }
+      case LIBBSC_UNEXPECTED_EOB: {
+        return std::string(u8"Data error - compressed block ended unexpectedly");
+      }
+      case LIBBSC_DATA_CORRUPT: {
+        return std::string(u8"Data error - compressed block is corrupted");
+      }
+      default: {
+        std::string errorMessage(u8"Generic error - libbsc returned undocumented result ");
+        errorMessage.append(std::to_string(bscResult));
+        return errorMessage;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Bsc
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BSC)
@@ -0,0 +1,66 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_BSC_BSCHELPER_H
+#define NUCLEX_STORAGE_COMPRESSION_BSC_BSCHELPER_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#include <libbsc.h>
+
+#include <cstddef>
+#include <string>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Bsc {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides helper methods to deal with libbsc</summary>
+  class BscHelper {
+
+    /// <summary>libbsc features used for compressing and decompressing</summary>
+    /// <remarks>
+    ///   Multithreading is left out because Nuclex.Storage never creates threads on its
+    ///   own; compress blocks from multiple threads instead.
+    /// </remarks>
+    public: static const int Features = LIBBSC_FEATURE_FASTMODE;
+
+    /// <summary>Number of bytes in the length prefix written before each block</summary>
+    public: static const std::size_t FramePrefixByteCount = 4;
+
+    /// <summary>Initializes libbsc if this hasn't happened yet</summary>
+    public: static void Initialize();
+
+    /// <summary>Looks up the error message for the specified result code</summary>
+    /// <param name="bscResult">Result code for which the error message will be looked up</param>
+    /// <returns>The corresponding libbsc error message</returns>
+    public: static std::string GetErrorMessage(int bscResult);
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Bsc
+
+#endif // defined(NUCLEX_STORAGE_HAVE_BSC)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_BSC_BSCHELPER_H
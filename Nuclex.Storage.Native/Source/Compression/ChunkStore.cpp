@@ -0,0 +1,471 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/ChunkStore.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+#include "Nuclex/Storage/Blob.h"
+#include "../Helpers/BlockCodec.h"
+#include "../Helpers/Sha256.h"
+
+#include <algorithm> // for std::min(), std::copy(), std::equal()
+#include <cstring> // for std::memmove()
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Magic bytes at the beginning of a chunk store's container</summary>
+  const std::uint8_t ContainerSignature[4] = { 'N', 'C', 'H', 'K' };
+
+  /// <summary>Version of the container format</summary>
+  const std::uint32_t ContainerFormatVersion = 1;
+
+  /// <summary>Number of bytes in the header of a chunk store's container</summary>
+  /// <remarks>
+  ///   Signature (4), format version (4), algorithm ID (8)
+  /// </remarks>
+  const std::size_t HeaderByteCount = 16;
+
+  /// <summary>Number of bytes in the header preceding each chunk</summary>
+  /// <remarks>
+  ///   Hash (32), uncompressed size (4), compressed size (4)
+  /// </remarks>
+  const std::size_t ChunkHeaderByteCount = 40;
+
+  /// <summary>Smallest average chunk size that can be requested</summary>
+  const std::size_t MinimumAverageChunkByteCount = 256;
+
+  /// <summary>Largest average chunk size that can be requested</summary>
+  const std::size_t MaximumAverageChunkByteCount = 64 * 1024 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Stores a 32 bit integer in little endian byte order</summary>
+  /// <param name="target">Address at which the integer will be stored</param>
+  /// <param name="value">Value that will be stored</param>
+  void writeUInt32(std::uint8_t *target, std::uint32_t value) {
+    for(std::size_t index = 0; index < 4; ++index) {
+      target[index] = static_cast<std::uint8_t>(value >> (index * 8));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a 32 bit integer stored in little endian byte order</summary>
+  /// <param name="source">Address at which the integer is stored</param>
+  /// <returns>The loaded integer</returns>
+  std::uint32_t readUInt32(const std::uint8_t *source) {
+    std::uint32_t value = 0;
+    for(std::size_t index = 0; index < 4; ++index) {
+      value |= static_cast<std::uint32_t>(source[index]) << (index * 8);
+    }
+    return value;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Random values the rolling hash adds for each byte value</summary>
+  /// <remarks>
+  ///   The values are generated from a fixed seed. They decide where chunks are cut,
+  ///   so changing them would keep new chunks from matching previously stored ones.
+  /// </remarks>
+  class GearTable {
+
+    /// <summary>Initializes the gear table</summary>
+    public: GearTable() {
+      std::uint64_t seed = 0x4E75636C65784344ULL; // 'NuclexCD'
+      for(std::size_t index = 0; index < 256; ++index) {
+        seed += 0x9E3779B97F4A7C15ULL; // SplitMix64
+        std::uint64_t value = seed;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        this->Values[index] = value ^ (value >> 31);
+      }
+    }
+
+    /// <summary>Random value for each possible byte value</summary>
+    public: std::uint64_t Values[256];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the places at which blobs are cut into chunks</summary>
+  /// <remarks>
+  ///   Follows the FastCDC approach: a gear hash rolls over the data and a chunk ends
+  ///   where the hash's upper bits are all zero. Up to the average chunk size, more bits
+  ///   have to be zero than after it, which keeps chunk sizes close to the average.
+  ///   The first bytes of each chunk up to the minimum chunk size are skipped.
+  /// </remarks>
+  class ContentDefinedChunker {
+
+    /// <summary>Initializes a new chunker for the specified average chunk size</summary>
+    /// <param name="averageChunkByteCount">Number of bytes chunks should have on average</param>
+    public: ContentDefinedChunker(std::size_t averageChunkByteCount) :
+      minimumChunkByteCount(averageChunkByteCount / 4),
+      averageChunkByteCount(averageChunkByteCount),
+      maximumChunkByteCount(averageChunkByteCount * 8) {
+      static const GearTable gearTable;
+      this->gear = gearTable.Values;
+
+      int bitCount = 0;
+      while((std::size_t(2) << bitCount) <= averageChunkByteCount) {
+        ++bitCount;
+      }
+      this->strictMask = ~std::uint64_t(0) << (64 - (bitCount + 2));
+      this->looseMask = ~std::uint64_t(0) << (64 - (bitCount - 2));
+    }
+
+    /// <summary>Returns the largest number of bytes a chunk can have</summary>
+    /// <returns>The maximum number of bytes in a chunk</returns>
+    public: std::size_t GetMaximumChunkByteCount() const {
+      return this->maximumChunkByteCount;
+    }
+
+    /// <summary>Determines the length of the chunk at the start of the data</summary>
+    /// <param name="data">Data that will be cut into chunks</param>
+    /// <param name="byteCount">
+    ///   Number of bytes available, either at least the maximum chunk size or
+    ///   all the remaining bytes
+    /// </param>
+    /// <returns>The number of bytes in the chunk</returns>
+    public: std::size_t FindChunkEnd(const std::uint8_t *data, std::size_t byteCount) const {
+      if(byteCount <= this->minimumChunkByteCount) {
+        return byteCount;
+      }
+      if(byteCount > this->maximumChunkByteCount) {
+        byteCount = this->maximumChunkByteCount;
+      }
+
+      std::size_t normalByteCount = std::min(byteCount, this->averageChunkByteCount);
+      std::uint64_t hash = 0;
+
+      std::size_t index = this->minimumChunkByteCount;
+      for(; index < normalByteCount; ++index) {
+        hash = (hash << 1) + this->gear[data[index]];
+        if((hash & this->strictMask) == 0) {
+          return index + 1;
+        }
+      }
+      for(; index < byteCount; ++index) {
+        hash = (hash << 1) + this->gear[data[index]];
+        if((hash & this->looseMask) == 0) {
+          return index + 1;
+        }
+      }
+
+      return byteCount;
+    }
+
+    /// <summary>Random values the rolling hash adds for each byte value</summary>
+    private: const std::uint64_t *gear;
+    /// <summary>Number of bytes below which a chunk is never cut</summary>
+    private: std::size_t minimumChunkByteCount;
+    /// <summary>Number of bytes up to which the strict mask is used</summary>
+    private: std::size_t averageChunkByteCount;
+    /// <summary>Number of bytes at which a chunk is always cut</summary>
+    private: std::size_t maximumChunkByteCount;
+    /// <summary>Bits that have to be zero to cut a chunk shorter than average</summary>
+    private: std::uint64_t strictMask;
+    /// <summary>Bits that have to be zero to cut a chunk longer than average</summary>
+    private: std::uint64_t looseMask;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChunkStore::ChunkStore(
+    const std::shared_ptr<Blob> &container,
+    const std::shared_ptr<const CompressionAlgorithm> &algorithm
+  ) :
+    container(container),
+    algorithm(algorithm),
+    endLocation(0) {
+
+    // An empty container becomes a new chunk store
+    if(container->GetSize() == 0) {
+      std::uint8_t header[HeaderByteCount];
+      std::copy(ContainerSignature, ContainerSignature + 4, header);
+      writeUInt32(header + 4, ContainerFormatVersion);
+      std::array<std::uint8_t, 8> id = algorithm->GetId();
+      std::copy(id.begin(), id.end(), header + 8);
+      container->WriteAt(0, header, HeaderByteCount);
+      this->endLocation = HeaderByteCount;
+      return;
+    }
+
+    std::array<std::uint8_t, 8> id = readHeaderAndIndex();
+    if(id != algorithm->GetId()) {
+      throw std::runtime_error(
+        u8"Chunk store was compressed with a different compression algorithm"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChunkStore::ChunkStore(
+    const std::shared_ptr<Blob> &container, const CompressionAlgorithmSelector &selector
+  ) :
+    container(container),
+    endLocation(0) {
+    std::array<std::uint8_t, 8> id = readHeaderAndIndex();
+    this->algorithm = selector.GetAlgorithm(id);
+    if(!this->algorithm) {
+      throw std::runtime_error(
+        u8"Chunk store was compressed with an unknown compression algorithm"
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChunkStore::~ChunkStore() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<ChunkReference> ChunkStore::Store(
+    const Blob &source, std::size_t averageChunkByteCount /* = DefaultAverageChunkByteCount */
+  ) {
+    bool isValidChunkSize = (
+      (averageChunkByteCount >= MinimumAverageChunkByteCount) &&
+      (averageChunkByteCount <= MaximumAverageChunkByteCount)
+    );
+    if(!isValidChunkSize) {
+      throw std::invalid_argument(u8"Average chunk size must be between 256 bytes and 64 MiB");
+    }
+
+    ContentDefinedChunker chunker(averageChunkByteCount);
+    std::size_t maximumChunkByteCount = chunker.GetMaximumChunkByteCount();
+
+    std::uint64_t remainingByteCount = source.GetSize();
+    std::vector<ChunkReference> chunks;
+
+    // If the whole source is in memory already, cut it into chunks right there
+    const std::uint8_t *span = source.TryGetContiguousSpan(
+      0, static_cast<std::size_t>(remainingByteCount)
+    );
+    if(span != nullptr) {
+      while(remainingByteCount > 0) {
+        std::size_t chunkByteCount = chunker.FindChunkEnd(
+          span, static_cast<std::size_t>(remainingByteCount)
+        );
+        chunks.push_back(StoreChunk(span, chunkByteCount));
+        span += chunkByteCount;
+        remainingByteCount -= chunkByteCount;
+      }
+
+      return chunks;
+    }
+
+    // Otherwise, read the source in sections of several chunks and keep the unused
+    // end of each section around for the next one
+    std::vector<std::uint8_t> buffer(maximumChunkByteCount * 4);
+    std::uint64_t location = 0;
+    std::size_t bufferedByteCount = 0;
+    std::size_t offset = 0;
+    while((remainingByteCount > 0) || (offset < bufferedByteCount)) {
+      if(
+        (bufferedByteCount - offset < maximumChunkByteCount) && (remainingByteCount > 0)
+      ) {
+        std::memmove(buffer.data(), buffer.data() + offset, bufferedByteCount - offset);
+        bufferedByteCount -= offset;
+        offset = 0;
+
+        std::size_t readByteCount = static_cast<std::size_t>(
+          std::min<std::uint64_t>(buffer.size() - bufferedByteCount, remainingByteCount)
+        );
+        source.ReadAt(location, buffer.data() + bufferedByteCount, readByteCount);
+        location += readByteCount;
+        remainingByteCount -= readByteCount;
+        bufferedByteCount += readByteCount;
+      }
+
+      std::size_t chunkByteCount = chunker.FindChunkEnd(
+        buffer.data() + offset, bufferedByteCount - offset
+      );
+      chunks.push_back(StoreChunk(buffer.data() + offset, chunkByteCount));
+      offset += chunkByteCount;
+    }
+
+    return chunks;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChunkReference ChunkStore::StoreChunk(const std::uint8_t *chunk, std::size_t byteCount) {
+    if(byteCount > 0xFFFFFFFFU) {
+      throw std::invalid_argument(u8"Chunks can not be larger than 4 GiB");
+    }
+
+    ChunkReference reference;
+    reference.Hash = Helpers::Sha256::Hash(chunk, byteCount);
+    reference.ByteCount = static_cast<std::uint32_t>(byteCount);
+    if(Contains(reference.Hash)) {
+      return reference;
+    }
+
+    // Compress without holding the mutex so other threads can store chunks meanwhile.
+    // If another thread stores the same chunk first, this copy is simply discarded.
+    std::vector<std::uint8_t> compressed;
+    {
+      std::unique_ptr<Compressor> compressor = this->algorithm->CreateCompressor();
+      Helpers::BlockCodec::Compress(*compressor, chunk, byteCount, compressed);
+    }
+    if(compressed.size() > 0xFFFFFFFFU) {
+      throw std::runtime_error(u8"Compressed chunk is larger than 4 GiB");
+    }
+
+    std::uint8_t header[ChunkHeaderByteCount];
+    std::copy(reference.Hash.begin(), reference.Hash.end(), header);
+    writeUInt32(header + 32, reference.ByteCount);
+    writeUInt32(header + 36, static_cast<std::uint32_t>(compressed.size()));
+
+    std::lock_guard<std::mutex> indexScope(this->indexMutex);
+    if(this->index.find(reference.Hash) == this->index.end()) {
+      this->container->WriteAt(this->endLocation, header, ChunkHeaderByteCount);
+      this->container->WriteAt(
+        this->endLocation + ChunkHeaderByteCount, compressed.data(), compressed.size()
+      );
+
+      ChunkLocation &location = this->index[reference.Hash];
+      location.Location = this->endLocation + ChunkHeaderByteCount;
+      location.CompressedByteCount = static_cast<std::uint32_t>(compressed.size());
+      location.ByteCount = reference.ByteCount;
+
+      this->endLocation = location.Location + compressed.size();
+    }
+
+    return reference;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool ChunkStore::Contains(const ChunkHash &hash) const {
+    std::lock_guard<std::mutex> indexScope(this->indexMutex);
+    return (this->index.find(hash) != this->index.end());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ChunkStore::CountChunks() const {
+    std::lock_guard<std::mutex> indexScope(this->indexMutex);
+    return this->index.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChunkStore::ReadChunk(const ChunkReference &chunk, std::uint8_t *buffer) const {
+    ChunkLocation location;
+    {
+      std::lock_guard<std::mutex> indexScope(this->indexMutex);
+      std::unordered_map<ChunkHash, ChunkLocation, ChunkHashHasher>::const_iterator iterator = (
+        this->index.find(chunk.Hash)
+      );
+      if(iterator == this->index.end()) {
+        throw std::runtime_error(u8"Chunk store does not hold the requested chunk");
+      }
+      location = iterator->second;
+    }
+    if(location.ByteCount != chunk.ByteCount) {
+      throw std::runtime_error(u8"Chunk reference has a different size than the stored chunk");
+    }
+
+    std::vector<std::uint8_t> compressedChunk;
+    const std::uint8_t *compressed = this->container->TryGetContiguousSpan(
+      location.Location, location.CompressedByteCount
+    );
+    if(compressed == nullptr) {
+      compressedChunk.resize(location.CompressedByteCount);
+      this->container->ReadAt(
+        location.Location, compressedChunk.data(), location.CompressedByteCount
+      );
+      compressed = compressedChunk.data();
+    }
+
+    std::unique_ptr<Decompressor> decompressor = this->algorithm->CreateDecompressor();
+    Helpers::BlockCodec::Decompress(
+      *decompressor, compressed, location.CompressedByteCount, buffer, location.ByteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::array<std::uint8_t, 8> ChunkStore::readHeaderAndIndex() {
+    std::uint64_t containerByteCount = this->container->GetSize();
+    if(containerByteCount < HeaderByteCount) {
+      throw std::runtime_error(u8"Blob is too short to hold a chunk store");
+    }
+
+    std::uint8_t header[HeaderByteCount];
+    this->container->ReadAt(0, header, HeaderByteCount);
+    if(!std::equal(ContainerSignature, ContainerSignature + 4, header)) {
+      throw std::runtime_error(u8"Blob does not contain a chunk store");
+    }
+    if(readUInt32(header + 4) != ContainerFormatVersion) {
+      throw std::runtime_error(u8"Chunk store has an unsupported version");
+    }
+
+    std::array<std::uint8_t, 8> id;
+    std::copy(header + 8, header + 16, id.begin());
+
+    // Walk over the chunk headers to rebuild the index
+    std::uint64_t location = HeaderByteCount;
+    while(location < containerByteCount) {
+      if(containerByteCount - location < ChunkHeaderByteCount) {
+        throw std::runtime_error(u8"Chunk store ends in the middle of a chunk header");
+      }
+
+      std::uint8_t chunkHeader[ChunkHeaderByteCount];
+      this->container->ReadAt(location, chunkHeader, ChunkHeaderByteCount);
+      location += ChunkHeaderByteCount;
+
+      ChunkHash hash;
+      std::copy(chunkHeader, chunkHeader + 32, hash.begin());
+
+      ChunkLocation chunkLocation;
+      chunkLocation.Location = location;
+      chunkLocation.ByteCount = readUInt32(chunkHeader + 32);
+      chunkLocation.CompressedByteCount = readUInt32(chunkHeader + 36);
+      if(containerByteCount - location < chunkLocation.CompressedByteCount) {
+        throw std::runtime_error(u8"Chunk store ends in the middle of a chunk");
+      }
+
+      this->index[hash] = chunkLocation;
+      location += chunkLocation.CompressedByteCount;
+    }
+
+    this->endLocation = location;
+    return id;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
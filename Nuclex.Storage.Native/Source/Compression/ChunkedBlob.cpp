@@ -0,0 +1,124 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/ChunkedBlob.h"
+
+#include <algorithm> // for std::upper_bound(), std::min(), std::copy()
+#include <stdexcept> // for std::runtime_error, std::out_of_range
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChunkedBlob::ChunkedBlob(
+    const std::shared_ptr<const ChunkStore> &store,
+    const std::vector<ChunkReference> &chunks
+  ) :
+    store(store),
+    chunks(chunks),
+    chunkOffsets(chunks.size() + 1),
+    cachedChunkIndex(chunks.size()) {
+
+    this->chunkOffsets[0] = 0;
+    for(std::size_t index = 0; index < chunks.size(); ++index) {
+      this->chunkOffsets[index + 1] = this->chunkOffsets[index] + chunks[index].ByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChunkedBlob::ReadAt(std::uint64_t location, void *buffer, std::size_t count) const {
+    std::uint64_t byteCount = GetSize();
+    bool isInRange = (
+      (location <= byteCount) &&
+      (count <= byteCount - location)
+    );
+    if(!isInRange) {
+      throw std::out_of_range(u8"Attempted read past the end of the chunked blob");
+    }
+    if(count == 0) {
+      return;
+    }
+
+    // Chunks vary in length, so find the chunk holding the first byte by its offset
+    std::size_t chunkIndex = static_cast<std::size_t>(
+      std::upper_bound(this->chunkOffsets.begin(), this->chunkOffsets.end(), location) -
+      this->chunkOffsets.begin()
+    ) - 1;
+
+    std::uint8_t *target = static_cast<std::uint8_t *>(buffer);
+    while(count > 0) {
+      std::size_t offset = static_cast<std::size_t>(location - this->chunkOffsets[chunkIndex]);
+      std::size_t chunkByteCount = this->chunks[chunkIndex].ByteCount;
+
+      // Reads covering a whole chunk can skip the cache and decompress directly
+      // into the caller's buffer, everything else goes through the cached chunk
+      std::size_t copiedByteCount;
+      if((offset == 0) && (count >= chunkByteCount)) {
+        this->store->ReadChunk(this->chunks[chunkIndex], target);
+        copiedByteCount = chunkByteCount;
+      } else {
+        copiedByteCount = readFromCachedChunk(chunkIndex, offset, target, count);
+      }
+
+      location += copiedByteCount;
+      target += copiedByteCount;
+      count -= copiedByteCount;
+      ++chunkIndex;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChunkedBlob::WriteAt(std::uint64_t location, const void *buffer, std::size_t count) {
+    (void)location;
+    (void)buffer;
+    (void)count;
+    throw std::runtime_error(u8"Attempted write to a read-only chunked blob");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ChunkedBlob::readFromCachedChunk(
+    std::size_t chunkIndex, std::size_t offset, std::uint8_t *target, std::size_t count
+  ) const {
+    std::lock_guard<std::mutex> cacheScope(this->cacheMutex);
+
+    if(this->cachedChunkIndex != chunkIndex) {
+      this->cachedChunkIndex = this->chunks.size();
+      this->cachedChunk.resize(this->chunks[chunkIndex].ByteCount);
+      this->store->ReadChunk(this->chunks[chunkIndex], this->cachedChunk.data());
+      this->cachedChunkIndex = chunkIndex;
+    }
+
+    std::size_t byteCount = std::min(count, this->cachedChunk.size() - offset);
+    std::copy(
+      this->cachedChunk.data() + offset, this->cachedChunk.data() + offset + byteCount, target
+    );
+
+    return byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
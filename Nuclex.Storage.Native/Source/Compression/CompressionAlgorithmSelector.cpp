@@ -0,0 +1,307 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+
+#include "ZLib/DeflateCompressionAlgorithm.h"
+#include "Brotli/BrotliCompressionAlgorithm.h"
+#include "LZip/LZipCompressionAlgorithm.h"
+#include "Bsc/BscCompressionAlgorithm.h"
+#include "LZ4/LZ4CompressionAlgorithm.h"
+#include "Zstd/ZstdCompressionAlgorithm.h"
+
+#include <chrono> // for std::chrono::steady_clock
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Clock frequency the measured compression times are converted at</summary>
+  const std::size_t NominalCyclesPerNanosecond = 3;
+
+  /// <summary>Minimum time the compression of the sample is repeated for</summary>
+  const std::chrono::milliseconds MinimumMeasurementTime(20);
+
+  /// <summary>Maximum number of times the compression of the sample is repeated</summary>
+  const std::size_t MaximumMeasurementRunCount = 10;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses a sample and discards the output, counting its length</summary>
+  /// <param name="compressor">Compressor that will be used</param>
+  /// <param name="sample">Data that will be compressed</param>
+  /// <param name="sampleByteCount">Number of bytes in the sample</param>
+  /// <returns>The number of bytes the compressor produced</returns>
+  std::size_t compressAndCount(
+    Nuclex::Storage::Compression::Compressor &compressor,
+    const std::uint8_t *sample, std::size_t sampleByteCount
+  ) {
+    using Nuclex::Storage::Compression::StopReason;
+
+    std::uint8_t outputBuffer[16384];
+    std::size_t compressedByteCount = 0;
+
+    for(;;) {
+      std::size_t inputByteCount = sampleByteCount;
+      std::size_t outputByteCount = sizeof(outputBuffer);
+      StopReason reason = compressor.Process(
+        sample, inputByteCount, outputBuffer, outputByteCount
+      );
+      sample += inputByteCount;
+      sampleByteCount -= inputByteCount;
+      compressedByteCount += outputByteCount;
+      if(reason == StopReason::InputBufferExhausted) {
+        break;
+      }
+    }
+
+    for(;;) {
+      std::size_t outputByteCount = sizeof(outputBuffer);
+      StopReason reason = compressor.Finish(outputBuffer, outputByteCount);
+      compressedByteCount += outputByteCount;
+      if(reason == StopReason::Finished) {
+        break;
+      }
+    }
+
+    return compressedByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void CompressionAlgorithmSelector::AddAlgorithm(
+    const std::shared_ptr<const CompressionAlgorithm> &algorithm
+  ) {
+    if(!algorithm) {
+      throw std::invalid_argument(u8"Compression algorithm must not be a null pointer");
+    }
+
+    Entry entry;
+    entry.Algorithm = algorithm;
+    entry.Metrics.CompressionCyclesPerKilobyte = algorithm->GetCompressionCyclesPerKilobyte();
+    entry.Metrics.CompressionRatio = algorithm->GetAverageCompressionRatio();
+
+    this->entries.push_back(entry);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void CompressionAlgorithmSelector::AddBuiltInAlgorithms() {
+    AddAlgorithm(std::make_shared<ZLib::DeflateCompressionAlgorithm>(1));
+    AddAlgorithm(std::make_shared<ZLib::DeflateCompressionAlgorithm>(6));
+    AddAlgorithm(std::make_shared<ZLib::DeflateCompressionAlgorithm>(9));
+#if defined(NUCLEX_STORAGE_HAVE_BROTLI)
+    AddAlgorithm(std::make_shared<Brotli::BrotliCompressionAlgorithm>(1));
+    AddAlgorithm(std::make_shared<Brotli::BrotliCompressionAlgorithm>(5));
+    AddAlgorithm(std::make_shared<Brotli::BrotliCompressionAlgorithm>(9));
+#endif
+#if defined(NUCLEX_STORAGE_HAVE_LZIP)
+    AddAlgorithm(std::make_shared<LZip::LZipCompressionAlgorithm>(0));
+    AddAlgorithm(std::make_shared<LZip::LZipCompressionAlgorithm>(6));
+    AddAlgorithm(std::make_shared<LZip::LZipCompressionAlgorithm>(9));
+#endif
+#if defined(NUCLEX_STORAGE_HAVE_BSC)
+    AddAlgorithm(std::make_shared<Bsc::BscCompressionAlgorithm>());
+#endif
+#if defined(NUCLEX_STORAGE_HAVE_LZ4)
+    AddAlgorithm(std::make_shared<LZ4::LZ4CompressionAlgorithm>(0));
+    AddAlgorithm(std::make_shared<LZ4::LZ4CompressionAlgorithm>(9));
+    AddAlgorithm(std::make_shared<LZ4::LZ4CompressionAlgorithm>(12));
+#endif
+#if defined(NUCLEX_STORAGE_HAVE_ZSTD)
+    AddAlgorithm(std::make_shared<Zstd::ZstdCompressionAlgorithm>(1));
+    AddAlgorithm(std::make_shared<Zstd::ZstdCompressionAlgorithm>(3));
+    AddAlgorithm(std::make_shared<Zstd::ZstdCompressionAlgorithm>(19));
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::shared_ptr<const CompressionAlgorithm> &CompressionAlgorithmSelector::GetAlgorithm(
+    std::size_t index
+  ) const {
+    if(index >= this->entries.size()) {
+      throw std::out_of_range(u8"Compression algorithm index is out of range");
+    }
+
+    return this->entries[index].Algorithm;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void CompressionAlgorithmSelector::Calibrate(
+    const std::uint8_t *sample, std::size_t sampleByteCount
+  ) {
+    for(std::size_t index = 0; index < this->entries.size(); ++index) {
+      this->entries[index].Metrics = Measure(
+        *this->entries[index].Algorithm, sample, sampleByteCount
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  CompressionMetrics CompressionAlgorithmSelector::GetMetrics(
+    const CompressionAlgorithm &algorithm
+  ) const {
+    for(std::size_t index = 0; index < this->entries.size(); ++index) {
+      if(this->entries[index].Algorithm.get() == &algorithm) {
+        return this->entries[index].Metrics;
+      }
+    }
+
+    throw std::invalid_argument(u8"Compression algorithm is not known to the selector");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const CompressionAlgorithm> CompressionAlgorithmSelector::SelectFastest(
+    float maximumCompressionRatio /* = 1.0f */
+  ) const {
+    const Entry *best = nullptr;
+    for(std::size_t index = 0; index < this->entries.size(); ++index) {
+      const Entry &entry = this->entries[index];
+      if(entry.Metrics.CompressionRatio > maximumCompressionRatio) {
+        continue;
+      }
+
+      bool isBetter = (
+        (best == nullptr) ||
+        (entry.Metrics.CompressionCyclesPerKilobyte < best->Metrics.CompressionCyclesPerKilobyte)
+      );
+      if(isBetter) {
+        best = &entry;
+      }
+    }
+
+    if(best == nullptr) {
+      return std::shared_ptr<const CompressionAlgorithm>();
+    } else {
+      return best->Algorithm;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const CompressionAlgorithm> CompressionAlgorithmSelector::SelectStrongest(
+    std::size_t maximumCyclesPerKilobyte
+  ) const {
+    const Entry *best = nullptr;
+    for(std::size_t index = 0; index < this->entries.size(); ++index) {
+      const Entry &entry = this->entries[index];
+      if(entry.Metrics.CompressionCyclesPerKilobyte > maximumCyclesPerKilobyte) {
+        continue;
+      }
+
+      bool isBetter = (
+        (best == nullptr) ||
+        (entry.Metrics.CompressionRatio < best->Metrics.CompressionRatio)
+      );
+      if(isBetter) {
+        best = &entry;
+      }
+    }
+
+    if(best == nullptr) {
+      return std::shared_ptr<const CompressionAlgorithm>();
+    } else {
+      return best->Algorithm;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const CompressionAlgorithm> CompressionAlgorithmSelector::GetAlgorithm(
+    const std::array<std::uint8_t, 8> &id
+  ) const {
+    for(std::size_t index = 0; index < this->entries.size(); ++index) {
+      if(this->entries[index].Algorithm->GetId() == id) {
+        return this->entries[index].Algorithm;
+      }
+    }
+
+    return std::shared_ptr<const CompressionAlgorithm>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  CompressionMetrics CompressionAlgorithmSelector::Measure(
+    const CompressionAlgorithm &algorithm,
+    const std::uint8_t *sample, std::size_t sampleByteCount
+  ) {
+    if(sampleByteCount == 0) {
+      throw std::invalid_argument(u8"Sample used to measure an algorithm must not be empty");
+    }
+
+    std::unique_ptr<Compressor> compressor = algorithm.CreateCompressor();
+
+    // Compress the sample repeatedly until enough time has passed to get a reliable
+    // measurement and keep the fastest run, which is the one least disturbed by
+    // the operating system, cache misses and page faults.
+    std::chrono::steady_clock::duration fastestRunTime = std::chrono::steady_clock::duration::max();
+    std::chrono::steady_clock::duration totalTime = std::chrono::steady_clock::duration::zero();
+    std::size_t compressedByteCount = 0;
+    for(std::size_t run = 0; run < MaximumMeasurementRunCount; ++run) {
+      if(run > 0) {
+        if(totalTime >= MinimumMeasurementTime) {
+          break;
+        }
+        compressor->Reset();
+      }
+
+      std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+      compressedByteCount = compressAndCount(*compressor, sample, sampleByteCount);
+      std::chrono::steady_clock::duration runTime = std::chrono::steady_clock::now() - startTime;
+
+      totalTime += runTime;
+      if(runTime < fastestRunTime) {
+        fastestRunTime = runTime;
+      }
+    }
+
+    std::size_t nanoseconds = static_cast<std::size_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(fastestRunTime).count()
+    );
+
+    CompressionMetrics metrics;
+    metrics.CompressionCyclesPerKilobyte = static_cast<std::size_t>(
+      static_cast<double>(nanoseconds) * static_cast<double>(NominalCyclesPerNanosecond) *
+      1024.0 / static_cast<double>(sampleByteCount)
+    );
+    metrics.CompressionRatio = static_cast<float>(
+      static_cast<double>(compressedByteCount) / static_cast<double>(sampleByteCount)
+    );
+
+    return metrics;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
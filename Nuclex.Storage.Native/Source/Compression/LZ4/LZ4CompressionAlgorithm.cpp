@@ -0,0 +1,131 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "LZ4CompressionAlgorithm.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_LZ4)
+
+#include "LZ4Compressor.h"
+#include "LZ4Decompressor.h"
+
+#include <lz4.h> // for ::LZ4_versionString()
+
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Speed and effectiveness of an LZ4 compression level</summary>
+  struct LevelMetrics {
+
+    /// <summary>Average CPU cycles needed to compress one kilobyte</summary>
+    public: std::size_t CyclesPerKilobyte;
+    /// <summary>Average size of compressed data relative to the uncompressed data</summary>
+    public: float CompressionRatio;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measured metrics for each of LZ4's compression levels</summary>
+  /// <remarks>
+  ///   Single-threaded throughput on the Silesia corpus, converted to cycles at 3 GHz.
+  ///   Decompression runs at around 4 GiB/s for all levels.
+  /// </remarks>
+  const LevelMetrics LZ4LevelMetrics[] = {
+    {   3900, 0.477f }, //  0: ~750 MiB/s, fast compressor
+    {   3900, 0.477f }, //  1: ~750 MiB/s, fast compressor
+    {   3900, 0.477f }, //  2: ~750 MiB/s, fast compressor
+    {  26600, 0.394f }, //  3: ~110 MiB/s, high compression from here on
+    {  41900, 0.383f }, //  4:  ~70 MiB/s
+    {  53300, 0.380f }, //  5:  ~55 MiB/s
+    {  65100, 0.379f }, //  6:  ~45 MiB/s
+    {  73200, 0.378f }, //  7:  ~40 MiB/s
+    {  81400, 0.377f }, //  8:  ~36 MiB/s
+    {  88800, 0.377f }, //  9:  ~33 MiB/s
+    { 195300, 0.377f }, // 10:  ~15 MiB/s
+    { 244100, 0.376f }, // 11:  ~12 MiB/s
+    { 266300, 0.376f }  // 12:  ~11 MiB/s
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a human-readable name for this compression algorithm</summary>
+  /// <param name="level">Compression level used when compressing</param>
+  /// <returns>A human-readable name for the compression algorithm</returns>
+  std::string buildAlgorithmName(int level) {
+    std::string name(u8"LZ4 compression ");
+    name.append(::LZ4_versionString());
+    name.append(u8" (compression level ");
+    name.append(std::to_string(level));
+    name.push_back(')');
+
+    return name;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZ4 {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZ4CompressionAlgorithm::LZ4CompressionAlgorithm(int level) :
+    name(buildAlgorithmName(level)),
+    level(level) {
+    if((level < 0) || (level > 12)) {
+      throw std::out_of_range(u8"LZ4 compression level must be between 0 and 12");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t LZ4CompressionAlgorithm::GetCompressionCyclesPerKilobyte() const {
+    return LZ4LevelMetrics[this->level].CyclesPerKilobyte;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float LZ4CompressionAlgorithm::GetAverageCompressionRatio() const {
+    return LZ4LevelMetrics[this->level].CompressionRatio;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Compressor> LZ4CompressionAlgorithm::CreateCompressor() const {
+    return std::unique_ptr<Compressor>(new LZ4Compressor(this->level));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Decompressor> LZ4CompressionAlgorithm::CreateDecompressor() const {
+    return std::unique_ptr<Decompressor>(new LZ4Decompressor());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZ4
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZ4)
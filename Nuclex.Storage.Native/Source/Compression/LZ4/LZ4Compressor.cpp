@@ -0,0 +1,254 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "LZ4Compressor.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#if defined(NUCLEX_STORAGE_HAVE_LZ4)
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::memset(), std::memcpy()
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Largest number of bytes handed to LZ4 in a single call</summary>
+  /// <remarks>
+  ///   Matches LZ4's default block size, so each call produces at most one block and
+  ///   the staging buffer stays small.
+  /// </remarks>
+  const std::size_t MaximumChunkByteCount = 65536;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if an LZ4 function has reported an error</summary>
+  /// <param name="result">Result returned by the LZ4 function</param>
+  /// <returns>The result if it was not an error</returns>
+  std::size_t requireSuccess(std::size_t result) {
+    if(::LZ4F_isError(result)) {
+      std::string message(u8"LZ4 compressor failed: ");
+      message.append(::LZ4F_getErrorName(result));
+      throw std::runtime_error(message);
+    }
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZ4 {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZ4Compressor::LZ4Compressor(int level) :
+    preferences(),
+    context(nullptr),
+    stagingBuffer(),
+    stagedByteCount(0),
+    emittedByteCount(0),
+    begun(false),
+    finished(false) {
+    std::memset(&this->preferences, 0, sizeof(this->preferences));
+    this->preferences.compressionLevel = level;
+
+    // Both the frame header and the worst case of one chunk have to fit
+    this->stagingBuffer.resize(
+      LZ4F_HEADER_SIZE_MAX + ::LZ4F_compressBound(MaximumChunkByteCount, &this->preferences)
+    );
+
+    requireSuccess(::LZ4F_createCompressionContext(&this->context, LZ4F_VERSION));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZ4Compressor::~LZ4Compressor() {
+    ::LZ4F_freeCompressionContext(this->context);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason LZ4Compressor::Process(
+    const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.LZ4Compressor.Process");
+    std::size_t remainingInputByteCount = uncompressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      if(!emitCompressedData(outputBuffer, remainingOutputByteCount)) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(!this->begun) {
+        beginFrame();
+        continue;
+      }
+      if(remainingInputByteCount == 0) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+
+      std::size_t chunkByteCount = std::min(remainingInputByteCount, MaximumChunkByteCount);
+      this->stagedByteCount = requireSuccess(
+        ::LZ4F_compressUpdate(
+          this->context,
+          this->stagingBuffer.data(), this->stagingBuffer.size(),
+          uncompressedBuffer, chunkByteCount,
+          nullptr
+        )
+      );
+      this->emittedByteCount = 0;
+
+      uncompressedBuffer += chunkByteCount;
+      remainingInputByteCount -= chunkByteCount;
+    }
+
+    uncompressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason LZ4Compressor::Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      if(!emitCompressedData(outputBuffer, remainingOutputByteCount)) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(!this->begun) {
+        beginFrame();
+        continue;
+      }
+
+      // LZ4 writes out the data it buffered in one go and reports zero bytes
+      // when nothing was left to flush
+      this->stagedByteCount = requireSuccess(
+        ::LZ4F_flush(
+          this->context, this->stagingBuffer.data(), this->stagingBuffer.size(), nullptr
+        )
+      );
+      this->emittedByteCount = 0;
+      if(this->stagedByteCount == 0) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+    }
+
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason LZ4Compressor::Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.LZ4Compressor.Finish");
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      if(!emitCompressedData(outputBuffer, remainingOutputByteCount)) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(this->finished) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(!this->begun) {
+        beginFrame();
+        continue;
+      }
+
+      this->stagedByteCount = requireSuccess(
+        ::LZ4F_compressEnd(
+          this->context, this->stagingBuffer.data(), this->stagingBuffer.size(), nullptr
+        )
+      );
+      this->emittedByteCount = 0;
+      this->finished = true;
+    }
+
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LZ4Compressor::Reset() {
+    this->stagedByteCount = 0;
+    this->emittedByteCount = 0;
+    this->begun = false; // Beginning a new frame resets the compression context
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LZ4Compressor::beginFrame() {
+    this->stagedByteCount = requireSuccess(
+      ::LZ4F_compressBegin(
+        this->context,
+        this->stagingBuffer.data(), this->stagingBuffer.size(),
+        &this->preferences
+      )
+    );
+    this->emittedByteCount = 0;
+    this->begun = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool LZ4Compressor::emitCompressedData(
+    std::uint8_t *&outputBuffer, std::size_t &outputByteCount
+  ) {
+    std::size_t chunkByteCount = std::min(
+      outputByteCount, this->stagedByteCount - this->emittedByteCount
+    );
+    if(chunkByteCount > 0) {
+      std::memcpy(
+        outputBuffer, this->stagingBuffer.data() + this->emittedByteCount, chunkByteCount
+      );
+      outputBuffer += chunkByteCount;
+      outputByteCount -= chunkByteCount;
+      this->emittedByteCount += chunkByteCount;
+    }
+
+    return (this->emittedByteCount == this->stagedByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZ4
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZ4)
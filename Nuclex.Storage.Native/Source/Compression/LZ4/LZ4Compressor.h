@@ -0,0 +1,134 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_LZ4_LZ4COMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_LZ4_LZ4COMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_LZ4)
+
+#include "Nuclex/Storage/Compression/Compressor.h"
+
+#include <lz4frame.h>
+
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZ4 {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses data into the LZ4 frame format</summary>
+  /// <remarks>
+  ///   LZ4's frame API needs an output buffer large enough for the worst case of each
+  ///   call, so the compressor writes into a staging buffer and hands out its contents
+  ///   as space becomes available. The compression context is set up once and reused
+  ///   for all following streams.
+  /// </remarks>
+  class LZ4Compressor : public Compressor {
+
+    /// <summary>Initializes a new LZ4 compressor</summary>
+    /// <param name="level">
+    ///   Compression level, 0 to 2 use the fast compressor, 3 to 12 the high
+    ///   compression variant
+    /// </param>
+    public: LZ4Compressor(int level);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~LZ4Compressor() override;
+
+    /// <summary>Compresses data from the input buffer into the output buffer</summary>
+    /// <param name="uncompressedBuffer">Buffer holding the data to compress</param>
+    /// <param name="uncompressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the compressor stopped because it needs more input or more output space
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Writes out all data compressed so far</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the flush has completed or needs more output space</returns>
+    public: StopReason Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Ends the stream and writes out all remaining compressed data</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the stream has been completed or needs more output space</returns>
+    public: StopReason Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Prepares the compressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    /// <summary>Writes the frame header into the staging buffer if not done yet</summary>
+    private: void beginFrame();
+
+    /// <summary>Copies staged compressed data that has not been handed out yet</summary>
+    /// <param name="outputBuffer">Buffer the compressed data will be copied into</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, will be reduced by the number
+    ///   of bytes copied
+    /// </param>
+    /// <returns>True if all compressed data has been handed out</returns>
+    private: bool emitCompressedData(std::uint8_t *&outputBuffer, std::size_t &outputByteCount);
+
+    private: LZ4Compressor(const LZ4Compressor &) = delete;
+    private: LZ4Compressor &operator =(const LZ4Compressor &) = delete;
+
+    /// <summary>Settings the LZ4 frames will be compressed with</summary>
+    private: ::LZ4F_preferences_t preferences;
+    /// <summary>LZ4 compression context holding the compressor's state</summary>
+    private: ::LZ4F_cctx *context;
+    /// <summary>Buffer receiving compressed data from LZ4 before it is handed out</summary>
+    private: std::vector<std::uint8_t> stagingBuffer;
+    /// <summary>Number of bytes in the staging buffer holding compressed data</summary>
+    private: std::size_t stagedByteCount;
+    /// <summary>Number of bytes from the staging buffer that have been handed out</summary>
+    private: std::size_t emittedByteCount;
+    /// <summary>Whether the frame header has been written</summary>
+    private: bool begun;
+    /// <summary>Whether the frame footer has been written</summary>
+    private: bool finished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZ4
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZ4)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_LZ4_LZ4COMPRESSOR_H
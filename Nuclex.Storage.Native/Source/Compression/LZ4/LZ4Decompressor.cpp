@@ -0,0 +1,135 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "LZ4Decompressor.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#if defined(NUCLEX_STORAGE_HAVE_LZ4)
+
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if an LZ4 function has reported an error</summary>
+  /// <param name="result">Result returned by the LZ4 function</param>
+  /// <returns>The result if it was not an error</returns>
+  std::size_t requireSuccess(std::size_t result) {
+    if(::LZ4F_isError(result)) {
+      std::string message(u8"LZ4 decompressor failed: ");
+      message.append(::LZ4F_getErrorName(result));
+      throw std::runtime_error(message);
+    }
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZ4 {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZ4Decompressor::LZ4Decompressor() :
+    context(nullptr),
+    finished(false) {
+    requireSuccess(::LZ4F_createDecompressionContext(&this->context, LZ4F_VERSION));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZ4Decompressor::~LZ4Decompressor() {
+    ::LZ4F_freeDecompressionContext(this->context);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason LZ4Decompressor::Process(
+    const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.LZ4Decompressor.Process");
+    if(this->finished) {
+      compressedByteCount = 0;
+      outputByteCount = 0;
+      return StopReason::Finished;
+    }
+
+    std::size_t remainingInputByteCount = compressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      std::size_t consumedByteCount = remainingInputByteCount;
+      std::size_t producedByteCount = remainingOutputByteCount;
+      std::size_t result = requireSuccess(
+        ::LZ4F_decompress(
+          this->context,
+          outputBuffer, &producedByteCount,
+          compressedBuffer, &consumedByteCount,
+          nullptr
+        )
+      );
+      compressedBuffer += consumedByteCount;
+      remainingInputByteCount -= consumedByteCount;
+      outputBuffer += producedByteCount;
+      remainingOutputByteCount -= producedByteCount;
+
+      // LZ4 returns a hint for how many bytes it wants next, zero means the frame is done
+      if(result == 0) {
+        this->finished = true;
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(remainingInputByteCount == 0) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+    }
+
+    compressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LZ4Decompressor::Reset() {
+    ::LZ4F_resetDecompressionContext(this->context);
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZ4
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZ4)
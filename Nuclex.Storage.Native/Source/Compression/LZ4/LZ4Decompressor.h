@@ -0,0 +1,83 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_LZ4_LZ4DECOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_LZ4_LZ4DECOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_LZ4)
+
+#include "Nuclex/Storage/Compression/Decompressor.h"
+
+#include <lz4frame.h>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZ4 {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decompresses data in the LZ4 frame format</summary>
+  class LZ4Decompressor : public Decompressor {
+
+    /// <summary>Initializes a new LZ4 decompressor</summary>
+    public: LZ4Decompressor();
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~LZ4Decompressor() override;
+
+    /// <summary>Decompresses data from the input buffer into the output buffer</summary>
+    /// <param name="compressedBuffer">Buffer holding the compressed data</param>
+    /// <param name="compressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the decompressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the decompressor stopped because it needs more input, needs more output
+    ///   space or has reached the end of the compressed data
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Prepares the decompressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    private: LZ4Decompressor(const LZ4Decompressor &) = delete;
+    private: LZ4Decompressor &operator =(const LZ4Decompressor &) = delete;
+
+    /// <summary>LZ4 decompression context holding the decompressor's state</summary>
+    private: ::LZ4F_dctx *context;
+    /// <summary>Whether the end of the compressed stream has been reached</summary>
+    private: bool finished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZ4
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZ4)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_LZ4_LZ4DECOMPRESSOR_H
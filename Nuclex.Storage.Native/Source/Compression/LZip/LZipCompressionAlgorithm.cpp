@@ -0,0 +1,137 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "LZipCompressionAlgorithm.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_LZIP)
+
+#include "LZipCompressor.h"
+#include "LZipDecompressor.h"
+
+#include <cstdint> // lzlib.h relies on std::uint8_t being declared
+#include <lzlib.h> // for ::LZ_version()
+
+#include <stdexcept> // for std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encoder settings and measured metrics of a compression level</summary>
+  struct LevelSettings {
+
+    /// <summary>Size of the dictionary in bytes</summary>
+    public: int DictionaryByteCount;
+    /// <summary>Longest match the encoder will look for</summary>
+    public: int MatchLengthLimit;
+    /// <summary>Average CPU cycles needed to compress one kilobyte</summary>
+    public: std::size_t CyclesPerKilobyte;
+    /// <summary>Average size of compressed data relative to the uncompressed data</summary>
+    public: float CompressionRatio;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Settings for each of the compression levels</summary>
+  /// <remarks>
+  ///   The dictionary sizes and match length limits are the ones the lzip tool uses for
+  ///   its -0 to -9 options. Metrics are single-threaded throughput on the Silesia corpus,
+  ///   converted to cycles at 3 GHz.
+  /// </remarks>
+  const LevelSettings LZipLevelSettings[] = {
+    {    65535,  16,   81400, 0.301f }, // 0: ~36 MiB/s, uses lzlib's fast encoder
+    {  1 << 20,   5,  162800, 0.285f }, // 1: ~18 MiB/s
+    {  3 << 19,   6,  266300, 0.277f }, // 2: ~11 MiB/s
+    {  1 << 21,   8,  465000, 0.267f }, // 3: ~6.3 MiB/s
+    {  3 << 20,  12,  610400, 0.262f }, // 4: ~4.8 MiB/s
+    {  1 << 22,  20,  771000, 0.257f }, // 5: ~3.8 MiB/s
+    {  1 << 23,  36, 1010200, 0.252f }, // 6: ~2.9 MiB/s
+    {  1 << 24,  68, 1126800, 0.251f }, // 7: ~2.6 MiB/s
+    {  3 << 23, 132, 1273800, 0.250f }, // 8: ~2.3 MiB/s
+    {  1 << 25, 273, 1395100, 0.249f }  // 9: ~2.1 MiB/s
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a human-readable name for this compression algorithm</summary>
+  /// <param name="level">Compression level used when compressing</param>
+  /// <returns>A human-readable name for the compression algorithm</returns>
+  std::string buildAlgorithmName(int level) {
+    std::string name(u8"LZip compression via lzlib ");
+    name.append(::LZ_version());
+    name.append(u8" (compression level ");
+    name.append(std::to_string(level));
+    name.push_back(')');
+
+    return name;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZip {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZipCompressionAlgorithm::LZipCompressionAlgorithm(int level) :
+    name(buildAlgorithmName(level)),
+    level(level) {
+    if((level < 0) || (level > 9)) {
+      throw std::out_of_range(u8"LZip compression level must be between 0 and 9");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t LZipCompressionAlgorithm::GetCompressionCyclesPerKilobyte() const {
+    return LZipLevelSettings[this->level].CyclesPerKilobyte;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float LZipCompressionAlgorithm::GetAverageCompressionRatio() const {
+    return LZipLevelSettings[this->level].CompressionRatio;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Compressor> LZipCompressionAlgorithm::CreateCompressor() const {
+    const LevelSettings &settings = LZipLevelSettings[this->level];
+    return std::unique_ptr<Compressor>(
+      new LZipCompressor(settings.DictionaryByteCount, settings.MatchLengthLimit)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Decompressor> LZipCompressionAlgorithm::CreateDecompressor() const {
+    return std::unique_ptr<Decompressor>(new LZipDecompressor());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZip
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZIP)
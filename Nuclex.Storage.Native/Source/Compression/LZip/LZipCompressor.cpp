@@ -0,0 +1,245 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "LZipCompressor.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#if defined(NUCLEX_STORAGE_HAVE_LZIP)
+
+#include <cstdint> // lzlib.h relies on std::uint8_t being declared
+#include <lzlib.h>
+
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error, std::bad_alloc
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Member size that keeps lzlib from ever splitting the stream</summary>
+  const unsigned long long UnlimitedMemberSize = 0x7FFFFFFFFFFFFFFFULL;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits a byte count to what lzlib can process in one call</summary>
+  /// <param name="byteCount">Byte count that will be limited</param>
+  /// <returns>The byte count or the largest length lzlib can process at once</returns>
+  int limitToLZipLength(std::size_t byteCount) {
+    if(byteCount > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+      return std::numeric_limits<int>::max();
+    } else {
+      return static_cast<int>(byteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception describing the last error of an lzlib encoder</summary>
+  /// <param name="encoder">Encoder that has reported an error</param>
+  [[noreturn]] void throwEncoderError(::LZ_Encoder *encoder) {
+    std::string message(u8"LZip compressor failed: ");
+    message.append(::LZ_strerror(::LZ_compress_errno(encoder)));
+    throw std::runtime_error(message);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZip {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZipCompressor::LZipCompressor(int dictionaryByteCount, int matchLengthLimit) :
+    encoder(::LZ_compress_open(dictionaryByteCount, matchLengthLimit, UnlimitedMemberSize)),
+    flushing(false) {
+    if(this->encoder == nullptr) {
+      throw std::bad_alloc();
+    }
+    if(::LZ_compress_errno(this->encoder) != LZ_ok) {
+      std::string message(u8"Could not set up LZip compressor: ");
+      message.append(::LZ_strerror(::LZ_compress_errno(this->encoder)));
+      ::LZ_compress_close(this->encoder);
+      throw std::runtime_error(message);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZipCompressor::~LZipCompressor() {
+    ::LZ_compress_close(this->encoder);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason LZipCompressor::Process(
+    const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.LZipCompressor.Process");
+    std::size_t remainingInputByteCount = uncompressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+
+      // Hand lzlib as much input as its internal buffer can take right now
+      if(remainingInputByteCount > 0) {
+        int writableByteCount = ::LZ_compress_write_size(this->encoder);
+        if(writableByteCount < 0) {
+          throwEncoderError(this->encoder);
+        }
+        int chunkByteCount = limitToLZipLength(remainingInputByteCount);
+        if(chunkByteCount > writableByteCount) {
+          chunkByteCount = writableByteCount;
+        }
+        if(chunkByteCount > 0) {
+          int writtenByteCount = ::LZ_compress_write(
+            this->encoder, uncompressedBuffer, chunkByteCount
+          );
+          if(writtenByteCount < 0) {
+            throwEncoderError(this->encoder);
+          }
+          uncompressedBuffer += writtenByteCount;
+          remainingInputByteCount -= static_cast<std::size_t>(writtenByteCount);
+        }
+      }
+
+      // Collect whatever the encoder was able to compress from its buffer
+      int readByteCount = ::LZ_compress_read(
+        this->encoder, outputBuffer, limitToLZipLength(remainingOutputByteCount)
+      );
+      if(readByteCount < 0) {
+        throwEncoderError(this->encoder);
+      }
+      outputBuffer += readByteCount;
+      remainingOutputByteCount -= static_cast<std::size_t>(readByteCount);
+
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if((remainingInputByteCount == 0) && (readByteCount == 0)) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+    }
+
+    uncompressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason LZipCompressor::Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+
+    // Only request the flush once, otherwise every call for more output space
+    // would end up adding another flush marker to the stream
+    if(!this->flushing) {
+      if(::LZ_compress_sync_flush(this->encoder) < 0) {
+        throwEncoderError(this->encoder);
+      }
+      this->flushing = true;
+    }
+
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      int readByteCount = ::LZ_compress_read(
+        this->encoder, outputBuffer, limitToLZipLength(remainingOutputByteCount)
+      );
+      if(readByteCount < 0) {
+        throwEncoderError(this->encoder);
+      }
+      outputBuffer += readByteCount;
+      remainingOutputByteCount -= static_cast<std::size_t>(readByteCount);
+
+      if(readByteCount == 0) {
+        this->flushing = false;
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+    }
+
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason LZipCompressor::Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.LZipCompressor.Finish");
+    if(::LZ_compress_finish(this->encoder) < 0) {
+      throwEncoderError(this->encoder);
+    }
+
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      if(::LZ_compress_finished(this->encoder) == 1) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+
+      int readByteCount = ::LZ_compress_read(
+        this->encoder, outputBuffer, limitToLZipLength(remainingOutputByteCount)
+      );
+      if(readByteCount < 0) {
+        throwEncoderError(this->encoder);
+      }
+      outputBuffer += readByteCount;
+      remainingOutputByteCount -= static_cast<std::size_t>(readByteCount);
+    }
+
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LZipCompressor::Reset() {
+    if(::LZ_compress_reset(this->encoder) < 0) {
+      throwEncoderError(this->encoder);
+    }
+
+    this->flushing = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZip
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZIP)
@@ -0,0 +1,108 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_LZIP_LZIPCOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_LZIP_LZIPCOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_LZIP)
+
+#include "Nuclex/Storage/Compression/Compressor.h"
+
+// lzlib.h has no include guard, so it is only included by the implementation files
+struct LZ_Encoder;
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZip {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses data with the LZMA algorithm into the .lz format via lzlib</summary>
+  /// <remarks>
+  ///   The whole stream is written as a single .lz member. The lzlib encoder is set up
+  ///   once and reused for all calls and, via <see cref="Reset" />, for all following
+  ///   streams without reallocating its dictionary.
+  /// </remarks>
+  class LZipCompressor : public Compressor {
+
+    /// <summary>Initializes a new LZip compressor</summary>
+    /// <param name="dictionaryByteCount">Size of the dictionary in bytes</param>
+    /// <param name="matchLengthLimit">Longest match the encoder will look for</param>
+    public: LZipCompressor(int dictionaryByteCount, int matchLengthLimit);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~LZipCompressor() override;
+
+    /// <summary>Compresses data from the input buffer into the output buffer</summary>
+    /// <param name="uncompressedBuffer">Buffer holding the data to compress</param>
+    /// <param name="uncompressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the compressor stopped because it needs more input or more output space
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Writes out all data compressed so far</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the flush has completed or needs more output space</returns>
+    public: StopReason Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Ends the stream and writes out all remaining compressed data</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the stream has been completed or needs more output space</returns>
+    public: StopReason Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Prepares the compressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    private: LZipCompressor(const LZipCompressor &) = delete;
+    private: LZipCompressor &operator =(const LZipCompressor &) = delete;
+
+    /// <summary>lzlib encoder holding the compressor's state</summary>
+    private: ::LZ_Encoder *encoder;
+    /// <summary>Whether a sync flush has been requested but not completely written</summary>
+    private: bool flushing;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZip
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZIP)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_LZIP_LZIPCOMPRESSOR_H
@@ -0,0 +1,172 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "LZipDecompressor.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#if defined(NUCLEX_STORAGE_HAVE_LZIP)
+
+#include <cstdint> // lzlib.h relies on std::uint8_t being declared
+#include <lzlib.h>
+
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error, std::bad_alloc
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits a byte count to what lzlib can process in one call</summary>
+  /// <param name="byteCount">Byte count that will be limited</param>
+  /// <returns>The byte count or the largest length lzlib can process at once</returns>
+  int limitToLZipLength(std::size_t byteCount) {
+    if(byteCount > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+      return std::numeric_limits<int>::max();
+    } else {
+      return static_cast<int>(byteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception describing the last error of an lzlib decoder</summary>
+  /// <param name="decoder">Decoder that has reported an error</param>
+  [[noreturn]] void throwDecoderError(::LZ_Decoder *decoder) {
+    std::string message(u8"LZip decompressor failed: ");
+    message.append(::LZ_strerror(::LZ_decompress_errno(decoder)));
+    throw std::runtime_error(message);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZip {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZipDecompressor::LZipDecompressor() :
+    decoder(::LZ_decompress_open()),
+    finished(false) {
+    if(this->decoder == nullptr) {
+      throw std::bad_alloc();
+    }
+    if(::LZ_decompress_errno(this->decoder) != LZ_ok) {
+      ::LZ_decompress_close(this->decoder);
+      throw std::bad_alloc();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LZipDecompressor::~LZipDecompressor() {
+    ::LZ_decompress_close(this->decoder);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason LZipDecompressor::Process(
+    const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.LZipDecompressor.Process");
+    if(this->finished) {
+      compressedByteCount = 0;
+      outputByteCount = 0;
+      return StopReason::Finished;
+    }
+
+    std::size_t remainingInputByteCount = compressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+
+      // Hand lzlib as much input as its internal buffer can take right now
+      if(remainingInputByteCount > 0) {
+        int writableByteCount = ::LZ_decompress_write_size(this->decoder);
+        if(writableByteCount < 0) {
+          throwDecoderError(this->decoder);
+        }
+        int chunkByteCount = limitToLZipLength(remainingInputByteCount);
+        if(chunkByteCount > writableByteCount) {
+          chunkByteCount = writableByteCount;
+        }
+        if(chunkByteCount > 0) {
+          int writtenByteCount = ::LZ_decompress_write(
+            this->decoder, compressedBuffer, chunkByteCount
+          );
+          if(writtenByteCount < 0) {
+            throwDecoderError(this->decoder);
+          }
+          compressedBuffer += writtenByteCount;
+          remainingInputByteCount -= static_cast<std::size_t>(writtenByteCount);
+        }
+      }
+
+      int readByteCount = ::LZ_decompress_read(
+        this->decoder, outputBuffer, limitToLZipLength(remainingOutputByteCount)
+      );
+      if(readByteCount < 0) {
+        throwDecoderError(this->decoder);
+      }
+      outputBuffer += readByteCount;
+      remainingOutputByteCount -= static_cast<std::size_t>(readByteCount);
+
+      if(::LZ_decompress_member_finished(this->decoder) == 1) {
+        this->finished = true;
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if((remainingInputByteCount == 0) && (readByteCount == 0)) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+    }
+
+    compressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LZipDecompressor::Reset() {
+    if(::LZ_decompress_reset(this->decoder) < 0) {
+      throwDecoderError(this->decoder);
+    }
+
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZip
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZIP)
@@ -0,0 +1,110 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_PACKFORMAT_H
+#define NUCLEX_STORAGE_COMPRESSION_PACKFORMAT_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t, std::uint32_t, std::uint8_t
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Layout of the pack files written by the pack writer</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A pack begins with a header, followed by the entries, each starting at
+  ///     a multiple of the alignment, and ends with the directory. The directory holds
+  ///     one fixed-size record per entry, sorted by the entries' names, followed by
+  ///     the names themselves. All integers are stored in little endian byte order.
+  ///   </para>
+  /// </remarks>
+  class PackFormat {
+
+    /// <summary>Magic bytes at the beginning of a pack</summary>
+    public: static const std::uint8_t Signature[4];
+
+    /// <summary>Version of the pack format</summary>
+    public: static const std::uint32_t FormatVersion = 1;
+
+    /// <summary>Number of bytes in the header of a pack</summary>
+    /// <remarks>
+    ///   Signature (4), format version (4), entry count (4), alignment (4),
+    ///   directory location (8), directory size (8)
+    /// </remarks>
+    public: static const std::size_t HeaderByteCount = 32;
+
+    /// <summary>Number of bytes in the directory record of an entry</summary>
+    /// <remarks>
+    ///   Name offset (4), name length (4), location (8), stored size (8),
+    ///   uncompressed size (8), algorithm ID (8), XXH3 hash of the stored bytes (8)
+    /// </remarks>
+    public: static const std::size_t RecordByteCount = 48;
+
+    /// <summary>Stores a 32 bit integer in little endian byte order</summary>
+    /// <param name="target">Address at which the integer will be stored</param>
+    /// <param name="value">Value that will be stored</param>
+    public: static void WriteUInt32(std::uint8_t *target, std::uint32_t value) {
+      for(std::size_t index = 0; index < 4; ++index) {
+        target[index] = static_cast<std::uint8_t>(value >> (index * 8));
+      }
+    }
+
+    /// <summary>Stores a 64 bit integer in little endian byte order</summary>
+    /// <param name="target">Address at which the integer will be stored</param>
+    /// <param name="value">Value that will be stored</param>
+    public: static void WriteUInt64(std::uint8_t *target, std::uint64_t value) {
+      for(std::size_t index = 0; index < 8; ++index) {
+        target[index] = static_cast<std::uint8_t>(value >> (index * 8));
+      }
+    }
+
+    /// <summary>Loads a 32 bit integer stored in little endian byte order</summary>
+    /// <param name="source">Address at which the integer is stored</param>
+    /// <returns>The loaded integer</returns>
+    public: static std::uint32_t ReadUInt32(const std::uint8_t *source) {
+      std::uint32_t value = 0;
+      for(std::size_t index = 0; index < 4; ++index) {
+        value |= static_cast<std::uint32_t>(source[index]) << (index * 8);
+      }
+      return value;
+    }
+
+    /// <summary>Loads a 64 bit integer stored in little endian byte order</summary>
+    /// <param name="source">Address at which the integer is stored</param>
+    /// <returns>The loaded integer</returns>
+    public: static std::uint64_t ReadUInt64(const std::uint8_t *source) {
+      std::uint64_t value = 0;
+      for(std::size_t index = 0; index < 8; ++index) {
+        value |= static_cast<std::uint64_t>(source[index]) << (index * 8);
+      }
+      return value;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSION_PACKFORMAT_H
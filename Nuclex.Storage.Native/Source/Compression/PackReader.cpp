@@ -0,0 +1,277 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/PackReader.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithm.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+#include "Nuclex/Storage/Checksums/XxHash3.h"
+#include "Nuclex/Storage/BlobSlice.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "../Helpers/BlockCodec.h"
+#include "PackFormat.h"
+
+#include <algorithm> // for std::lower_bound(), std::equal()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a pack entry's name comes before the specified name</summary>
+  /// <param name="entry">Entry whose name will be compared</param>
+  /// <param name="name">Name the entry's name will be compared against</param>
+  /// <returns>True if the entry's name comes before the specified name</returns>
+  bool isNameLess(
+    const Nuclex::Storage::Compression::PackEntry &entry, const std::string &name
+  ) {
+    return (entry.Name < name);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::uint8_t PackFormat::Signature[4] = { 'N', 'P', 'A', 'K' };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PackReader::PackReader(const std::shared_ptr<const Blob> &container) :
+    container(container) {
+    readDirectory();
+    this->algorithms.resize(this->entries.size());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PackReader::PackReader(
+    const std::shared_ptr<const Blob> &container, const CompressionAlgorithmSelector &selector
+  ) :
+    container(container) {
+    readDirectory();
+    resolveAlgorithms(selector);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PackReader::~PackReader() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const PackEntry *PackReader::FindEntry(const std::string &name) const {
+    std::vector<PackEntry>::const_iterator iterator = std::lower_bound(
+      this->entries.begin(), this->entries.end(), name, isNameLess
+    );
+    if((iterator == this->entries.end()) || (iterator->Name != name)) {
+      return nullptr;
+    }
+
+    return &(*iterator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const Blob> PackReader::OpenEntry(const std::string &name) const {
+    const PackEntry *entry = FindEntry(name);
+    if(entry == nullptr) {
+      throw std::runtime_error(u8"Pack does not hold an entry with the requested name");
+    }
+
+    return OpenEntry(*entry);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<const Blob> PackReader::OpenEntry(const PackEntry &entry) const {
+    bool isEntryOfThisPack = (
+      (this->entries.size() > 0) &&
+      (&entry >= &this->entries.front()) &&
+      (&entry <= &this->entries.back())
+    );
+    if(!isEntryOfThisPack) {
+      throw std::invalid_argument(u8"Entry does not belong to this pack");
+    }
+
+    // Entries stored as-is are read straight from the container
+    if(!entry.IsCompressed()) {
+      return std::make_shared<BlobSlice>(this->container, entry.Location, entry.ByteCount);
+    }
+
+    const std::shared_ptr<const CompressionAlgorithm> &algorithm = (
+      this->algorithms[static_cast<std::size_t>(&entry - &this->entries.front())]
+    );
+    if(!algorithm) {
+      throw std::runtime_error(
+        u8"Pack entry was compressed with an unknown compression algorithm"
+      );
+    }
+
+    bool fitsIntoMemory = (
+      (entry.ByteCount <= std::numeric_limits<std::size_t>::max()) &&
+      (entry.StoredByteCount <= std::numeric_limits<std::size_t>::max())
+    );
+    if(!fitsIntoMemory) {
+      throw std::runtime_error(u8"Pack entry is too large to be decompressed into memory");
+    }
+
+    std::size_t storedByteCount = static_cast<std::size_t>(entry.StoredByteCount);
+    std::size_t byteCount = static_cast<std::size_t>(entry.ByteCount);
+
+    // Decompress directly from the container if it is memory-mapped
+    std::vector<std::uint8_t> compressed;
+    const std::uint8_t *source = this->container->TryGetContiguousSpan(
+      entry.Location, storedByteCount
+    );
+    if(source == nullptr) {
+      compressed.resize(storedByteCount);
+      this->container->ReadAt(entry.Location, compressed.data(), storedByteCount);
+      source = compressed.data();
+    }
+    if(Checksums::XxHash3::Compute(source, storedByteCount) != entry.Checksum) {
+      throw std::runtime_error(u8"Pack entry is damaged, its hash does not match");
+    }
+
+    std::vector<std::uint8_t> contents(byteCount);
+    {
+      std::unique_ptr<Decompressor> decompressor = algorithm->CreateDecompressor();
+      Helpers::BlockCodec::Decompress(
+        *decompressor, source, storedByteCount, contents.data(), byteCount
+      );
+    }
+
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    blob->Reserve(byteCount);
+    blob->WriteAt(0, contents.data(), byteCount);
+    blob->Seal();
+    return blob;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool PackReader::VerifyEntry(const PackEntry &entry) const {
+    Checksums::XxHash3 xxHash3;
+    xxHash3.Update(BlobSlice(this->container, entry.Location, entry.StoredByteCount));
+    return (xxHash3.GetValue() == entry.Checksum);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackReader::readDirectory() {
+    std::uint64_t containerByteCount = this->container->GetSize();
+    if(containerByteCount < PackFormat::HeaderByteCount) {
+      throw std::runtime_error(u8"Pack is truncated or damaged");
+    }
+
+    std::uint8_t header[PackFormat::HeaderByteCount];
+    this->container->ReadAt(0, header, PackFormat::HeaderByteCount);
+    if(!std::equal(PackFormat::Signature, PackFormat::Signature + 4, header)) {
+      throw std::runtime_error(u8"Blob does not contain a pack or the pack was not finished");
+    }
+    if(PackFormat::ReadUInt32(header + 4) != PackFormat::FormatVersion) {
+      throw std::runtime_error(u8"Pack was written in an unsupported format version");
+    }
+
+    std::size_t entryCount = PackFormat::ReadUInt32(header + 8);
+    std::uint64_t directoryLocation = PackFormat::ReadUInt64(header + 16);
+    std::uint64_t directoryByteCount = PackFormat::ReadUInt64(header + 24);
+    bool isValidDirectory = (
+      (directoryLocation >= PackFormat::HeaderByteCount) &&
+      (directoryLocation <= containerByteCount) &&
+      (directoryByteCount <= containerByteCount - directoryLocation) &&
+      (directoryByteCount / PackFormat::RecordByteCount >= entryCount)
+    );
+    if(!isValidDirectory) {
+      throw std::runtime_error(u8"Pack is truncated or damaged");
+    }
+
+    // The whole directory is loaded in a single read
+    std::vector<std::uint8_t> directory(static_cast<std::size_t>(directoryByteCount));
+    this->container->ReadAt(directoryLocation, directory.data(), directory.size());
+
+    std::size_t recordsByteCount = entryCount * PackFormat::RecordByteCount;
+    const std::uint8_t *record = directory.data();
+    const char *nameArea = reinterpret_cast<const char *>(directory.data() + recordsByteCount);
+    std::size_t nameAreaByteCount = directory.size() - recordsByteCount;
+
+    this->entries.resize(entryCount);
+    for(std::size_t index = 0; index < entryCount; ++index) {
+      PackEntry &entry = this->entries[index];
+
+      std::size_t nameOffset = PackFormat::ReadUInt32(record);
+      std::size_t nameLength = PackFormat::ReadUInt32(record + 4);
+      entry.Location = PackFormat::ReadUInt64(record + 8);
+      entry.StoredByteCount = PackFormat::ReadUInt64(record + 16);
+      entry.ByteCount = PackFormat::ReadUInt64(record + 24);
+      std::copy(record + 32, record + 40, entry.AlgorithmId.begin());
+      entry.Checksum = PackFormat::ReadUInt64(record + 40);
+      record += PackFormat::RecordByteCount;
+
+      bool isValidEntry = (
+        (nameOffset <= nameAreaByteCount) &&
+        (nameLength <= nameAreaByteCount - nameOffset) &&
+        (entry.Location <= directoryLocation) &&
+        (entry.StoredByteCount <= directoryLocation - entry.Location) &&
+        (entry.IsCompressed() || (entry.StoredByteCount == entry.ByteCount))
+      );
+      if(!isValidEntry) {
+        throw std::runtime_error(u8"Pack is truncated or damaged");
+      }
+      entry.Name.assign(nameArea + nameOffset, nameLength);
+
+      // Lookups rely on binary search, so an unsorted directory can not be used
+      if((index > 0) && !(this->entries[index - 1].Name < entry.Name)) {
+        throw std::runtime_error(u8"Pack directory is not sorted or holds duplicate names");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackReader::resolveAlgorithms(const CompressionAlgorithmSelector &selector) {
+    std::size_t entryCount = this->entries.size();
+    this->algorithms.resize(entryCount);
+
+    // Packs usually use only one or two algorithms, so remember the last one looked up
+    std::array<std::uint8_t, 8> lastId;
+    std::shared_ptr<const CompressionAlgorithm> lastAlgorithm;
+    for(std::size_t index = 0; index < entryCount; ++index) {
+      const PackEntry &entry = this->entries[index];
+      if(!entry.IsCompressed()) {
+        continue;
+      }
+
+      if(!lastAlgorithm || (lastId != entry.AlgorithmId)) {
+        lastId = entry.AlgorithmId;
+        lastAlgorithm = selector.GetAlgorithm(entry.AlgorithmId);
+      }
+      this->algorithms[index] = lastAlgorithm;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
@@ -0,0 +1,268 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/PackWriter.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithm.h"
+#include "Nuclex/Storage/Checksums/XxHash3.h"
+#include "Nuclex/Storage/Blob.h"
+#include "../Helpers/BlockCodec.h"
+#include "PackFormat.h"
+
+#include <algorithm> // for std::sort(), std::copy(), std::fill()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error, std::invalid_argument
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Orders pack entries by their names</summary>
+  /// <param name="left">Entry that will be compared on the left side</param>
+  /// <param name="right">Entry that will be compared on the right side</param>
+  /// <returns>True if the left entry's name comes before the right entry's name</returns>
+  bool isNameLess(
+    const Nuclex::Storage::Compression::PackEntry &left,
+    const Nuclex::Storage::Compression::PackEntry &right
+  ) {
+    return (left.Name < right.Name);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PackWriter::PackWriter(
+    const std::shared_ptr<Blob> &container, std::size_t alignment /* = DefaultAlignment */
+  ) :
+    container(container),
+    alignment(alignment),
+    endLocation(PackFormat::HeaderByteCount),
+    isFinished(false) {
+    bool isValidAlignment = (
+      (alignment != 0) &&
+      ((alignment & (alignment - 1)) == 0) &&
+      (alignment <= std::numeric_limits<std::uint32_t>::max())
+    );
+    if(!isValidAlignment) {
+      throw std::invalid_argument(u8"Alignment must be a power of two");
+    }
+    if(container->GetSize() != 0) {
+      throw std::invalid_argument(u8"Pack files can only be written into empty blobs");
+    }
+
+    // The header is filled in when the pack is finished. Until then, it stays zeroed,
+    // so a pack that was never finished will not be mistaken for a valid one.
+    std::uint8_t header[PackFormat::HeaderByteCount] = { 0 };
+    container->WriteAt(0, header, PackFormat::HeaderByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PackWriter::~PackWriter() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackWriter::AddEntry(
+    const std::string &name, const std::uint8_t *data, std::size_t byteCount
+  ) {
+    addEntry(name, data, byteCount, nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackWriter::AddEntry(
+    const std::string &name, const std::uint8_t *data, std::size_t byteCount,
+    const CompressionAlgorithm &algorithm
+  ) {
+    addEntry(name, data, byteCount, &algorithm);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackWriter::AddEntry(const std::string &name, const Blob &contents) {
+    std::uint64_t byteCount = contents.GetSize();
+    if(byteCount > std::numeric_limits<std::size_t>::max()) {
+      throw std::invalid_argument(u8"Blob is too large to be added to a pack");
+    }
+
+    const std::uint8_t *span = contents.TryGetContiguousSpan(
+      0, static_cast<std::size_t>(byteCount)
+    );
+    if(span != nullptr) {
+      addEntry(name, span, static_cast<std::size_t>(byteCount), nullptr);
+    } else {
+      std::vector<std::uint8_t> buffer(static_cast<std::size_t>(byteCount));
+      contents.ReadAt(0, buffer.data(), buffer.size());
+      addEntry(name, buffer.data(), buffer.size(), nullptr);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackWriter::AddEntry(
+    const std::string &name, const Blob &contents, const CompressionAlgorithm &algorithm
+  ) {
+    std::uint64_t byteCount = contents.GetSize();
+    if(byteCount > std::numeric_limits<std::size_t>::max()) {
+      throw std::invalid_argument(u8"Blob is too large to be added to a pack");
+    }
+
+    const std::uint8_t *span = contents.TryGetContiguousSpan(
+      0, static_cast<std::size_t>(byteCount)
+    );
+    if(span != nullptr) {
+      addEntry(name, span, static_cast<std::size_t>(byteCount), &algorithm);
+    } else {
+      std::vector<std::uint8_t> buffer(static_cast<std::size_t>(byteCount));
+      contents.ReadAt(0, buffer.data(), buffer.size());
+      addEntry(name, buffer.data(), buffer.size(), &algorithm);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackWriter::Finish() {
+    if(this->isFinished) {
+      throw std::runtime_error(u8"Pack has already been finished");
+    }
+
+    std::sort(this->entries.begin(), this->entries.end(), isNameLess);
+    if(this->entries.size() > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(u8"Pack holds too many entries");
+    }
+
+    // Assemble the directory: one fixed-size record per entry, then the names
+    std::size_t recordsByteCount = this->entries.size() * PackFormat::RecordByteCount;
+    std::size_t namesByteCount = 0;
+    for(std::size_t index = 0; index < this->entries.size(); ++index) {
+      namesByteCount += this->entries[index].Name.length();
+    }
+    if(namesByteCount > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(u8"Names of the pack's entries are longer than 4 GiB");
+    }
+
+    std::vector<std::uint8_t> directory(recordsByteCount + namesByteCount);
+    {
+      std::uint8_t *record = directory.data();
+      std::uint8_t *nameArea = directory.data() + recordsByteCount;
+      std::size_t nameOffset = 0;
+      for(std::size_t index = 0; index < this->entries.size(); ++index) {
+        const PackEntry &entry = this->entries[index];
+        PackFormat::WriteUInt32(record, static_cast<std::uint32_t>(nameOffset));
+        PackFormat::WriteUInt32(record + 4, static_cast<std::uint32_t>(entry.Name.length()));
+        PackFormat::WriteUInt64(record + 8, entry.Location);
+        PackFormat::WriteUInt64(record + 16, entry.StoredByteCount);
+        PackFormat::WriteUInt64(record + 24, entry.ByteCount);
+        std::copy(entry.AlgorithmId.begin(), entry.AlgorithmId.end(), record + 32);
+        PackFormat::WriteUInt64(record + 40, entry.Checksum);
+        record += PackFormat::RecordByteCount;
+
+        std::copy(entry.Name.begin(), entry.Name.end(), nameArea + nameOffset);
+        nameOffset += entry.Name.length();
+      }
+    }
+
+    pad();
+    std::uint64_t directoryLocation = this->endLocation;
+    this->container->WriteAt(directoryLocation, directory.data(), directory.size());
+    this->endLocation += directory.size();
+
+    std::uint8_t header[PackFormat::HeaderByteCount];
+    std::copy(PackFormat::Signature, PackFormat::Signature + 4, header);
+    PackFormat::WriteUInt32(header + 4, PackFormat::FormatVersion);
+    PackFormat::WriteUInt32(header + 8, static_cast<std::uint32_t>(this->entries.size()));
+    PackFormat::WriteUInt32(header + 12, static_cast<std::uint32_t>(this->alignment));
+    PackFormat::WriteUInt64(header + 16, directoryLocation);
+    PackFormat::WriteUInt64(header + 24, directory.size());
+    this->container->WriteAt(0, header, PackFormat::HeaderByteCount);
+
+    this->container->Flush();
+    this->isFinished = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackWriter::addEntry(
+    const std::string &name, const std::uint8_t *data, std::size_t byteCount,
+    const CompressionAlgorithm *algorithm
+  ) {
+    if(this->isFinished) {
+      throw std::runtime_error(u8"Entries can not be added to a finished pack");
+    }
+    if(this->names.find(name) != this->names.end()) {
+      throw std::invalid_argument(u8"Pack already holds an entry with the same name");
+    }
+
+    PackEntry entry;
+    entry.Name = name;
+    entry.ByteCount = byteCount;
+    entry.StoredByteCount = byteCount;
+    entry.AlgorithmId.fill(0);
+
+    // Compress the entry, but keep the compressed data only if it actually is smaller
+    std::vector<std::uint8_t> compressed;
+    if(algorithm != nullptr) {
+      std::unique_ptr<Compressor> compressor = algorithm->CreateCompressor();
+      Helpers::BlockCodec::Compress(*compressor, data, byteCount, compressed);
+      if(compressed.size() < byteCount) {
+        entry.StoredByteCount = compressed.size();
+        entry.AlgorithmId = algorithm->GetId();
+        data = compressed.data();
+      }
+    }
+
+    entry.Checksum = Checksums::XxHash3::Compute(
+      data, static_cast<std::size_t>(entry.StoredByteCount)
+    );
+
+    pad();
+    entry.Location = this->endLocation;
+    this->container->WriteAt(
+      entry.Location, data, static_cast<std::size_t>(entry.StoredByteCount)
+    );
+    this->endLocation += entry.StoredByteCount;
+
+    this->entries.push_back(entry);
+    this->names.insert(name);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PackWriter::pad() {
+    std::size_t paddingByteCount = static_cast<std::size_t>(
+      (this->alignment - (this->endLocation & (this->alignment - 1))) & (this->alignment - 1)
+    );
+    if(paddingByteCount > 0) {
+      std::vector<std::uint8_t> padding(paddingByteCount, 0);
+      this->container->WriteAt(this->endLocation, padding.data(), paddingByteCount);
+      this->endLocation += paddingByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
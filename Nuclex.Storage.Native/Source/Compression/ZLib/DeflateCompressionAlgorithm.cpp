@@ -22,13 +22,49 @@ License along with this library
 #define NUCLEX_STORAGE_SOURCE 1
 
 #include "DeflateCompressionAlgorithm.h"
+#include "DeflateCompressor.h"
+#include "DeflateDecompressor.h"
 
 #include <zlib.h>
 
+#include <stdexcept> // for std::out_of_range
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Speed and effectiveness of a deflate compression level</summary>
+  struct LevelMetrics {
+
+    /// <summary>Average CPU cycles needed to compress one kilobyte</summary>
+    public: std::size_t CyclesPerKilobyte;
+    /// <summary>Average size of compressed data relative to the uncompressed data</summary>
+    public: float CompressionRatio;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measured metrics for each of ZLib's compression levels</summary>
+  /// <remarks>
+  ///   Single-threaded throughput on the Silesia corpus, converted to cycles at 3 GHz.
+  ///   Decompression runs at around 300 MiB/s for all levels.
+  /// </remarks>
+  const LevelMetrics DeflateLevelMetrics[] = {
+    {   1000, 1.000f }, // 0: stored blocks only
+    {  29300, 0.366f }, // 1: ~100 MiB/s
+    {  32600, 0.355f }, // 2:  ~90 MiB/s
+    {  39100, 0.349f }, // 3:  ~75 MiB/s
+    {  48800, 0.335f }, // 4:  ~60 MiB/s
+    {  65100, 0.327f }, // 5:  ~45 MiB/s
+    {  97700, 0.323f }, // 6:  ~30 MiB/s, ZLib's default
+    { 122100, 0.322f }, // 7:  ~24 MiB/s
+    { 195300, 0.321f }, // 8:  ~15 MiB/s
+    { 244100, 0.321f }  // 9:  ~12 MiB/s
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Builds a human-readable name for this compression algorithm</summary>
   /// <param name="level">ZLib compression level used when compressing</param>
   /// <returns>A human-readable name for the compression algorithm</returns>
@@ -61,7 +97,43 @@ namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
 
   DeflateCompressionAlgorithm::DeflateCompressionAlgorithm(int level) :
     name(buildAlgorithmName(level)),
-    level(level) {}
+    level(level) {
+    if((level < Z_DEFAULT_COMPRESSION) || (level > Z_BEST_COMPRESSION)) {
+      throw std::out_of_range(u8"Deflate compression level must be between -1 and 9");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t DeflateCompressionAlgorithm::GetCompressionCyclesPerKilobyte() const {
+    if(this->level == Z_DEFAULT_COMPRESSION) {
+      return DeflateLevelMetrics[6].CyclesPerKilobyte;
+    } else {
+      return DeflateLevelMetrics[this->level].CyclesPerKilobyte;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float DeflateCompressionAlgorithm::GetAverageCompressionRatio() const {
+    if(this->level == Z_DEFAULT_COMPRESSION) {
+      return DeflateLevelMetrics[6].CompressionRatio;
+    } else {
+      return DeflateLevelMetrics[this->level].CompressionRatio;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Compressor> DeflateCompressionAlgorithm::CreateCompressor() const {
+    return std::unique_ptr<Compressor>(new DeflateCompressor(this->level));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Decompressor> DeflateCompressionAlgorithm::CreateDecompressor() const {
+    return std::unique_ptr<Decompressor>(new DeflateDecompressor());
+  }
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -32,7 +32,9 @@ namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
   class DeflateCompressionAlgorithm : public CompressionAlgorithm {
 
     /// <summary>Initializes the ZLib compressor and decompressor factory</summary>
-    /// <param name="level">ZLib compression level that will be used</param>
+    /// <param name="level">
+    ///   ZLib compression level from 0 to 9 that will be used or -1 for ZLib's default
+    /// </param>
     public: DeflateCompressionAlgorithm(int level);
 
     /// <summary>Frees all resources owned by the instance</summary>
@@ -56,19 +58,23 @@ namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
     ///   Returns the average number of CPU cycles this algorithm runs for to
     ///   compress one kilobyte of data
     /// <summary>
-    /// <returns>The avergae number of CPU cycles to comrpess one kilobyte</returns>
-    public: std::size_t GetCompressionCyclesPerKilobyte() const override {
-      return 10000;
-    };
+    /// <returns>The average number of CPU cycles to compress one kilobyte</returns>
+    public: std::size_t GetCompressionCyclesPerKilobyte() const override;
 
     /// <summary>
     ///   Returns the average size of data compressed with this algorithm as compared
     ///   to its uncompressed size
     /// </summary>
     /// <returns>The average ratio of compressed size to uncompressed size</returns>
-    public: float GetAverageCompressionRatio() const override {
-      return 0.8f;
-    }
+    public: float GetAverageCompressionRatio() const override;
+
+    /// <summary>Creates a new data compressor</summary>
+    /// <returns>A new deflate compressor using the configured compression level</returns>
+    public: std::unique_ptr<Compressor> CreateCompressor() const override;
+
+    /// <summary>Creates a new data decompressor</summary>
+    /// <returns>A new deflate decompressor</returns>
+    public: std::unique_ptr<Decompressor> CreateDecompressor() const override;
 
     /// <summary>The name of the compression algorithm</summary>
     private: std::string name;
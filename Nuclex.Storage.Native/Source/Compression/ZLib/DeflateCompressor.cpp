@@ -0,0 +1,186 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "DeflateCompressor.h"
+#include "ZLibHelper.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#include <cstring> // for std::memset()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits a byte count to what fits into one of ZLib's buffer lengths</summary>
+  /// <param name="byteCount">Byte count that will be limited</param>
+  /// <returns>The byte count or the largest length ZLib can process at once</returns>
+  uInt limitToZLibLength(std::size_t byteCount) {
+    if(byteCount > std::numeric_limits<uInt>::max()) {
+      return std::numeric_limits<uInt>::max();
+    } else {
+      return static_cast<uInt>(byteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DeflateCompressor::DeflateCompressor(int level) {
+    std::memset(&this->stream, 0, sizeof(this->stream));
+    ZLibHelper::UseTrackedAllocator(this->stream);
+
+    // Negative window bits produce a raw deflate stream without header and checksum
+    int result = ::deflateInit2(
+      &this->stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY
+    );
+    if(result != Z_OK) {
+      throw std::runtime_error(ZLibHelper::GetErrorMessage(this->stream, result));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DeflateCompressor::~DeflateCompressor() {
+    ::deflateEnd(&this->stream);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason DeflateCompressor::Process(
+    const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.DeflateCompressor.Process");
+    std::size_t remainingInputByteCount = uncompressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      uInt inputChunkByteCount = limitToZLibLength(remainingInputByteCount);
+      uInt outputChunkByteCount = limitToZLibLength(remainingOutputByteCount);
+      this->stream.next_in = const_cast<Bytef *>(uncompressedBuffer);
+      this->stream.avail_in = inputChunkByteCount;
+      this->stream.next_out = outputBuffer;
+      this->stream.avail_out = outputChunkByteCount;
+
+      // Z_BUF_ERROR only means no progress was possible, which the byte counts show
+      int result = ::deflate(&this->stream, Z_NO_FLUSH);
+      if((result != Z_OK) && (result != Z_BUF_ERROR)) {
+        throw std::runtime_error(ZLibHelper::GetErrorMessage(this->stream, result));
+      }
+
+      std::size_t consumedByteCount = inputChunkByteCount - this->stream.avail_in;
+      std::size_t producedByteCount = outputChunkByteCount - this->stream.avail_out;
+      uncompressedBuffer += consumedByteCount;
+      remainingInputByteCount -= consumedByteCount;
+      outputBuffer += producedByteCount;
+      remainingOutputByteCount -= producedByteCount;
+
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(remainingInputByteCount == 0) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+    }
+
+    uncompressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason DeflateCompressor::Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    return drain(Z_SYNC_FLUSH, outputBuffer, outputByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason DeflateCompressor::Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.DeflateCompressor.Finish");
+    return drain(Z_FINISH, outputBuffer, outputByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DeflateCompressor::Reset() {
+    int result = ::deflateReset(&this->stream);
+    if(result != Z_OK) {
+      throw std::runtime_error(ZLibHelper::GetErrorMessage(this->stream, result));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason DeflateCompressor::drain(
+    int flushMode, std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      uInt outputChunkByteCount = limitToZLibLength(remainingOutputByteCount);
+      this->stream.next_in = nullptr;
+      this->stream.avail_in = 0;
+      this->stream.next_out = outputBuffer;
+      this->stream.avail_out = outputChunkByteCount;
+
+      int result = ::deflate(&this->stream, flushMode);
+      if((result != Z_OK) && (result != Z_STREAM_END) && (result != Z_BUF_ERROR)) {
+        throw std::runtime_error(ZLibHelper::GetErrorMessage(this->stream, result));
+      }
+
+      std::size_t producedByteCount = outputChunkByteCount - this->stream.avail_out;
+      outputBuffer += producedByteCount;
+      remainingOutputByteCount -= producedByteCount;
+
+      // ZLib is done when it reports the end of the stream (Z_FINISH) or when it
+      // stops before filling the output buffer (Z_SYNC_FLUSH)
+      if((result == Z_STREAM_END) || (this->stream.avail_out > 0)) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+    }
+
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::ZLib
@@ -0,0 +1,111 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_ZLIB_DEFLATECOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_ZLIB_DEFLATECOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/Compressor.h"
+
+#include <zlib.h>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses data with the deflate algorithm via ZLib</summary>
+  /// <remarks>
+  ///   Produces a raw deflate stream without the ZLib header and checksum, as used
+  ///   inside .zip archives. The ZLib stream is set up once and reused for all calls
+  ///   and, via <see cref="Reset" />, for all following streams.
+  /// </remarks>
+  class DeflateCompressor : public Compressor {
+
+    /// <summary>Initializes a new deflate compressor</summary>
+    /// <param name="level">ZLib compression level that will be used</param>
+    public: DeflateCompressor(int level);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~DeflateCompressor() override;
+
+    /// <summary>Compresses data from the input buffer into the output buffer</summary>
+    /// <param name="uncompressedBuffer">Buffer holding the data to compress</param>
+    /// <param name="uncompressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the compressor stopped because it needs more input or more output space
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Writes out all data compressed so far</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the flush has completed or needs more output space</returns>
+    public: StopReason Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Ends the stream and writes out all remaining compressed data</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the stream has been completed or needs more output space</returns>
+    public: StopReason Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Prepares the compressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    /// <summary>Lets ZLib write out pending data without providing more input</summary>
+    /// <param name="flushMode">ZLib flush mode that will be passed to deflate()</param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether all pending data has been written or more space is needed</returns>
+    private: StopReason drain(
+      int flushMode, std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    );
+
+    private: DeflateCompressor(const DeflateCompressor &) = delete;
+    private: DeflateCompressor &operator =(const DeflateCompressor &) = delete;
+
+    /// <summary>ZLib stream holding the compressor's state</summary>
+    private: ::z_stream stream;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::ZLib
+
+#endif // NUCLEX_STORAGE_COMPRESSION_ZLIB_DEFLATECOMPRESSOR_H
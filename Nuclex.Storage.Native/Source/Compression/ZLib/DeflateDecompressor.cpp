@@ -0,0 +1,147 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "DeflateDecompressor.h"
+#include "ZLibHelper.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#include <cstring> // for std::memset()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Limits a byte count to what fits into one of ZLib's buffer lengths</summary>
+  /// <param name="byteCount">Byte count that will be limited</param>
+  /// <returns>The byte count or the largest length ZLib can process at once</returns>
+  uInt limitToZLibLength(std::size_t byteCount) {
+    if(byteCount > std::numeric_limits<uInt>::max()) {
+      return std::numeric_limits<uInt>::max();
+    } else {
+      return static_cast<uInt>(byteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DeflateDecompressor::DeflateDecompressor() :
+    finished(false) {
+    std::memset(&this->stream, 0, sizeof(this->stream));
+    ZLibHelper::UseTrackedAllocator(this->stream);
+
+    // Negative window bits expect a raw deflate stream without header and checksum
+    int result = ::inflateInit2(&this->stream, -MAX_WBITS);
+    if(result != Z_OK) {
+      throw std::runtime_error(ZLibHelper::GetErrorMessage(this->stream, result));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  DeflateDecompressor::~DeflateDecompressor() {
+    ::inflateEnd(&this->stream);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason DeflateDecompressor::Process(
+    const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.DeflateDecompressor.Process");
+    if(this->finished) {
+      compressedByteCount = 0;
+      outputByteCount = 0;
+      return StopReason::Finished;
+    }
+
+    std::size_t remainingInputByteCount = compressedByteCount;
+    std::size_t remainingOutputByteCount = outputByteCount;
+
+    StopReason stopReason;
+    for(;;) {
+      uInt inputChunkByteCount = limitToZLibLength(remainingInputByteCount);
+      uInt outputChunkByteCount = limitToZLibLength(remainingOutputByteCount);
+      this->stream.next_in = const_cast<Bytef *>(compressedBuffer);
+      this->stream.avail_in = inputChunkByteCount;
+      this->stream.next_out = outputBuffer;
+      this->stream.avail_out = outputChunkByteCount;
+
+      int result = ::inflate(&this->stream, Z_NO_FLUSH);
+      if(result == Z_NEED_DICT) {
+        result = Z_DATA_ERROR; // Raw deflate streams never use preset dictionaries
+      }
+      if((result != Z_OK) && (result != Z_STREAM_END) && (result != Z_BUF_ERROR)) {
+        throw std::runtime_error(ZLibHelper::GetErrorMessage(this->stream, result));
+      }
+
+      std::size_t consumedByteCount = inputChunkByteCount - this->stream.avail_in;
+      std::size_t producedByteCount = outputChunkByteCount - this->stream.avail_out;
+      compressedBuffer += consumedByteCount;
+      remainingInputByteCount -= consumedByteCount;
+      outputBuffer += producedByteCount;
+      remainingOutputByteCount -= producedByteCount;
+
+      if(result == Z_STREAM_END) {
+        this->finished = true;
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(remainingOutputByteCount == 0) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(remainingInputByteCount == 0) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+    }
+
+    compressedByteCount -= remainingInputByteCount;
+    outputByteCount -= remainingOutputByteCount;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void DeflateDecompressor::Reset() {
+    int result = ::inflateReset(&this->stream);
+    if(result != Z_OK) {
+      throw std::runtime_error(ZLibHelper::GetErrorMessage(this->stream, result));
+    }
+
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::ZLib
@@ -0,0 +1,81 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_ZLIB_DEFLATEDECOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_ZLIB_DEFLATEDECOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/Decompressor.h"
+
+#include <zlib.h>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decompresses data compressed with the deflate algorithm via ZLib</summary>
+  /// <remarks>
+  ///   Expects a raw deflate stream as produced by the <see cref="DeflateCompressor" />.
+  /// </remarks>
+  class DeflateDecompressor : public Decompressor {
+
+    /// <summary>Initializes a new deflate decompressor</summary>
+    public: DeflateDecompressor();
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~DeflateDecompressor() override;
+
+    /// <summary>Decompresses data from the input buffer into the output buffer</summary>
+    /// <param name="compressedBuffer">Buffer holding the compressed data</param>
+    /// <param name="compressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the decompressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the decompressor stopped because it needs more input, needs more output
+    ///   space or has reached the end of the compressed data
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Prepares the decompressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    private: DeflateDecompressor(const DeflateDecompressor &) = delete;
+    private: DeflateDecompressor &operator =(const DeflateDecompressor &) = delete;
+
+    /// <summary>ZLib stream holding the decompressor's state</summary>
+    private: ::z_stream stream;
+    /// <summary>Whether the end of the compressed data has been reached</summary>
+    private: bool finished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::ZLib
+
+#endif // NUCLEX_STORAGE_COMPRESSION_ZLIB_DEFLATEDECOMPRESSOR_H
@@ -23,8 +23,43 @@ License along with this library
 
 #include "ZLibHelper.h"
 
+#include <Nuclex/Support/AllocationTracker.h> // for AllocationTracker
+
 #include <cstring>
 
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocates memory for ZLib through the allocation tracker</summary>
+  /// <param name="opaque">Unused user data of the ZLib stream</param>
+  /// <param name="itemCount">Number of items that will be allocated</param>
+  /// <param name="itemByteCount">Size of a single item in bytes</param>
+  /// <returns>The allocated memory or a null pointer if the allocation failed</returns>
+  ::voidpf allocateTracked(::voidpf opaque, ::uInt itemCount, ::uInt itemByteCount) {
+    (void)opaque;
+    return Nuclex::Support::AllocationTracker::Malloc(
+      Nuclex::Support::AllocationSubsystem::Compression,
+      static_cast<std::size_t>(itemCount) * static_cast<std::size_t>(itemByteCount)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frees memory ZLib allocated through the allocation tracker</summary>
+  /// <param name="opaque">Unused user data of the ZLib stream</param>
+  /// <param name="memory">Memory that will be freed</param>
+  void freeTracked(::voidpf opaque, ::voidpf memory) {
+    (void)opaque;
+    Nuclex::Support::AllocationTracker::Free(
+      Nuclex::Support::AllocationSubsystem::Compression, memory
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
 namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
 
   // ------------------------------------------------------------------------------------------- //
@@ -109,4 +144,12 @@ namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void ZLibHelper::UseTrackedAllocator(::z_stream &stream) {
+    stream.zalloc = &allocateTracked;
+    stream.zfree = &freeTracked;
+    stream.opaque = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}}} // namespace Nuclex::Storage::Compression::ZLib
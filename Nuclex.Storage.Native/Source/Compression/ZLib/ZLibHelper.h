@@ -44,6 +44,11 @@ namespace Nuclex { namespace Storage { namespace Compression { namespace ZLib {
     /// <returns>The corresponding ZLib error message</returns>
     public: static std::string GetErrorMessage(const ::z_stream &stream, int zlibResult);
 
+    /// <summary>Lets a stream take its memory through the allocation tracker</summary>
+    /// <param name="stream">Stream whose memory will be counted for compression</param>
+    /// <remarks>Must be called before the stream is initialized</remarks>
+    public: static void UseTrackedAllocator(::z_stream &stream);
+
   };
 
   // ------------------------------------------------------------------------------------------- //
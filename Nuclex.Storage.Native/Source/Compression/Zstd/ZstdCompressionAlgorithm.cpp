@@ -0,0 +1,223 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "ZstdCompressionAlgorithm.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#include "ZstdCompressor.h"
+#include "ZstdDecompressor.h"
+
+#include <zdict.h> // for ::ZDICT_trainFromBuffer()
+
+#include <stdexcept> // for std::out_of_range, std::runtime_error, std::bad_alloc
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Speed and effectiveness of a Zstandard compression level</summary>
+  struct LevelMetrics {
+
+    /// <summary>Average CPU cycles needed to compress one kilobyte</summary>
+    public: std::size_t CyclesPerKilobyte;
+    /// <summary>Average size of compressed data relative to the uncompressed data</summary>
+    public: float CompressionRatio;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measured metrics for each of Zstandard's compression levels</summary>
+  /// <remarks>
+  ///   Single-threaded throughput on the Silesia corpus, converted to cycles at 3 GHz.
+  ///   Decompression runs at around 1.2 GiB/s for all levels.
+  /// </remarks>
+  const LevelMetrics ZstdLevelMetrics[] = {
+    {    6200, 0.348f }, //  1: ~470 MiB/s
+    {    7900, 0.330f }, //  2: ~370 MiB/s
+    {   10900, 0.315f }, //  3: ~270 MiB/s
+    {   12200, 0.311f }, //  4: ~240 MiB/s
+    {   25500, 0.303f }, //  5: ~115 MiB/s
+    {   30800, 0.296f }, //  6:  ~95 MiB/s
+    {   41900, 0.289f }, //  7:  ~70 MiB/s
+    {   53300, 0.285f }, //  8:  ~55 MiB/s
+    {   65100, 0.283f }, //  9:  ~45 MiB/s
+    {   83700, 0.281f }, // 10:  ~35 MiB/s
+    {  108500, 0.280f }, // 11:  ~27 MiB/s
+    {  146500, 0.279f }, // 12:  ~20 MiB/s
+    {  244100, 0.277f }, // 13:  ~12 MiB/s
+    {  293000, 0.275f }, // 14:  ~10 MiB/s
+    {  366200, 0.273f }, // 15:   ~8 MiB/s
+    {  488300, 0.260f }, // 16:   ~6 MiB/s
+    {  651000, 0.256f }, // 17: ~4.5 MiB/s
+    {  837100, 0.252f }, // 18: ~3.5 MiB/s
+    { 1046300, 0.250f }, // 19: ~2.8 MiB/s
+    { 1220700, 0.244f }, // 20: ~2.4 MiB/s
+    { 1464800, 0.238f }, // 21: ~2.0 MiB/s
+    { 1723400, 0.233f }  // 22: ~1.7 MiB/s
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a human-readable name for this compression algorithm</summary>
+  /// <param name="level">Compression level used when compressing</param>
+  /// <param name="withDictionary">Whether a dictionary is used</param>
+  /// <returns>A human-readable name for the compression algorithm</returns>
+  std::string buildAlgorithmName(int level, bool withDictionary) {
+    std::string name(u8"Zstandard compression ");
+    name.append(::ZSTD_versionString());
+    name.append(u8" (compression level ");
+    name.append(std::to_string(level));
+    if(withDictionary) {
+      name.append(u8" with dictionary");
+    }
+    name.push_back(')');
+
+    return name;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Ensures that a compression level is supported by Zstandard</summary>
+  /// <param name="level">Compression level that will be checked</param>
+  void requireValidLevel(int level) {
+    if((level < 1) || (level > 22)) {
+      throw std::out_of_range(u8"Zstandard compression level must be between 1 and 22");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Zstd {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ZstdCompressionAlgorithm::ZstdCompressionAlgorithm(int level) :
+    name(buildAlgorithmName(level, false)),
+    level(level),
+    compressionDictionary(),
+    decompressionDictionary() {
+    requireValidLevel(level);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ZstdCompressionAlgorithm::ZstdCompressionAlgorithm(
+    int level, const std::vector<std::uint8_t> &dictionary
+  ) :
+    name(buildAlgorithmName(level, true)),
+    level(level),
+    compressionDictionary(),
+    decompressionDictionary() {
+    requireValidLevel(level);
+
+    // Both digested dictionaries copy the dictionary contents, so the caller's
+    // vector doesn't need to stay around
+    this->compressionDictionary.reset(
+      ::ZSTD_createCDict(dictionary.data(), dictionary.size(), level), &::ZSTD_freeCDict
+    );
+    if(!this->compressionDictionary) {
+      throw std::bad_alloc();
+    }
+    this->decompressionDictionary.reset(
+      ::ZSTD_createDDict(dictionary.data(), dictionary.size()), &::ZSTD_freeDDict
+    );
+    if(!this->decompressionDictionary) {
+      throw std::bad_alloc();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::uint8_t> ZstdCompressionAlgorithm::TrainDictionary(
+    const std::vector<std::vector<std::uint8_t>> &samples,
+    std::size_t maximumDictionaryByteCount
+  ) {
+
+    // Zstandard wants all samples concatenated into one buffer
+    std::vector<std::uint8_t> sampleBuffer;
+    std::vector<std::size_t> sampleByteCounts;
+    {
+      std::size_t totalByteCount = 0;
+      for(const std::vector<std::uint8_t> &sample : samples) {
+        totalByteCount += sample.size();
+      }
+
+      sampleBuffer.reserve(totalByteCount);
+      sampleByteCounts.reserve(samples.size());
+      for(const std::vector<std::uint8_t> &sample : samples) {
+        sampleBuffer.insert(sampleBuffer.end(), sample.begin(), sample.end());
+        sampleByteCounts.push_back(sample.size());
+      }
+    }
+
+    std::vector<std::uint8_t> dictionary(maximumDictionaryByteCount);
+    std::size_t result = ::ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(),
+      sampleBuffer.data(), sampleByteCounts.data(),
+      static_cast<unsigned>(sampleByteCounts.size())
+    );
+    if(::ZDICT_isError(result)) {
+      std::string message(u8"Could not train Zstandard dictionary: ");
+      message.append(::ZDICT_getErrorName(result));
+      throw std::runtime_error(message);
+    }
+
+    dictionary.resize(result);
+    return dictionary;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ZstdCompressionAlgorithm::GetCompressionCyclesPerKilobyte() const {
+    return ZstdLevelMetrics[this->level - 1].CyclesPerKilobyte;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  float ZstdCompressionAlgorithm::GetAverageCompressionRatio() const {
+    return ZstdLevelMetrics[this->level - 1].CompressionRatio;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Compressor> ZstdCompressionAlgorithm::CreateCompressor() const {
+    return std::unique_ptr<Compressor>(
+      new ZstdCompressor(this->level, this->compressionDictionary)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<Decompressor> ZstdCompressionAlgorithm::CreateDecompressor() const {
+    return std::unique_ptr<Decompressor>(new ZstdDecompressor(this->decompressionDictionary));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Zstd
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ZSTD)
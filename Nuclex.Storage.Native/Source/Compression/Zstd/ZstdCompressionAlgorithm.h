@@ -0,0 +1,136 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDCOMPRESSIONALGORITHM_H
+#define NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDCOMPRESSIONALGORITHM_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#include "Nuclex/Storage/Compression/CompressionAlgorithm.h"
+
+#include <zstd.h>
+
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Zstd {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides compressors and decompressors using the Zstandard algorithm</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Zstandard decompresses at over a gigabyte per second at all compression levels
+  ///     while reaching compression ratios close to LZMA at its highest levels.
+  ///   </para>
+  ///   <para>
+  ///     Small files compress much better with a dictionary trained on typical samples
+  ///     of the data (see <see cref="TrainDictionary" />). The dictionary is digested
+  ///     once when the algorithm is constructed and shared by all compressors and
+  ///     decompressors it creates. Data compressed with a dictionary can only be
+  ///     decompressed with the same dictionary.
+  ///   </para>
+  /// </remarks>
+  class ZstdCompressionAlgorithm : public CompressionAlgorithm {
+
+    /// <summary>Initializes the Zstandard compressor and decompressor factory</summary>
+    /// <param name="level">Compression level from 1 to 22 that will be used</param>
+    public: ZstdCompressionAlgorithm(int level);
+
+    /// <summary>
+    ///   Initializes the Zstandard compressor and decompressor factory with a dictionary
+    /// </summary>
+    /// <param name="level">Compression level from 1 to 22 that will be used</param>
+    /// <param name="dictionary">Dictionary that will be used for compressing</param>
+    public: ZstdCompressionAlgorithm(int level, const std::vector<std::uint8_t> &dictionary);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~ZstdCompressionAlgorithm() override = default;
+
+    /// <summary>Trains a dictionary from samples of the data that will be compressed</summary>
+    /// <param name="samples">Samples typical for the data that will be compressed</param>
+    /// <param name="maximumDictionaryByteCount">Maximum size of the dictionary</param>
+    /// <returns>The trained dictionary</returns>
+    /// <remarks>
+    ///   Zstandard recommends around a hundred times as much sample data as the size of
+    ///   the dictionary, with dictionaries of about 100 KiB working well for most uses.
+    /// </remarks>
+    public: static std::vector<std::uint8_t> TrainDictionary(
+      const std::vector<std::vector<std::uint8_t>> &samples,
+      std::size_t maximumDictionaryByteCount
+    );
+
+    /// <summary>Returns the human-readable name of the compression algorithm</summary>
+    /// <returns>The name of the compression algorithm the factory provides</returns>
+    public: const std::string &GetName() const override {
+      return this->name;
+    }
+
+    /// <summary>Returns a unique id for the compression algorithm</summary>
+    /// <returns>The compression algorithm's unique id</returns>
+    public: std::array<std::uint8_t, 8> GetId() const override {
+      return std::array<std::uint8_t, 8> {
+        'Z', 'S', 'T', 'D', '0', '0', '0', '1'
+      };
+    }
+
+    /// <summary>
+    ///   Returns the average number of CPU cycles this algorithm runs for to
+    ///   compress one kilobyte of data
+    /// <summary>
+    /// <returns>The average number of CPU cycles to compress one kilobyte</returns>
+    public: std::size_t GetCompressionCyclesPerKilobyte() const override;
+
+    /// <summary>
+    ///   Returns the average size of data compressed with this algorithm as compared
+    ///   to its uncompressed size
+    /// </summary>
+    /// <returns>The average ratio of compressed size to uncompressed size</returns>
+    public: float GetAverageCompressionRatio() const override;
+
+    /// <summary>Creates a new data compressor</summary>
+    /// <returns>
+    ///   A new Zstandard compressor using the configured compression level and dictionary
+    /// </returns>
+    public: std::unique_ptr<Compressor> CreateCompressor() const override;
+
+    /// <summary>Creates a new data decompressor</summary>
+    /// <returns>A new Zstandard decompressor using the configured dictionary</returns>
+    public: std::unique_ptr<Decompressor> CreateDecompressor() const override;
+
+    /// <summary>The name of the compression algorithm</summary>
+    private: std::string name;
+    /// <summary>Compression level that will be used when compressing things</summary>
+    private: int level;
+    /// <summary>Digested dictionary for compressing, null if no dictionary is used</summary>
+    private: std::shared_ptr<::ZSTD_CDict> compressionDictionary;
+    /// <summary>Digested dictionary for decompressing, null if no dictionary is used</summary>
+    private: std::shared_ptr<::ZSTD_DDict> decompressionDictionary;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Zstd
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDCOMPRESSIONALGORITHM_H
@@ -0,0 +1,172 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "ZstdCompressor.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#if defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#include <stdexcept> // for std::runtime_error, std::bad_alloc
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if a Zstandard function has reported an error</summary>
+  /// <param name="result">Result returned by the Zstandard function</param>
+  /// <returns>The result if it was not an error</returns>
+  std::size_t requireSuccess(std::size_t result) {
+    if(::ZSTD_isError(result)) {
+      std::string message(u8"Zstandard compressor failed: ");
+      message.append(::ZSTD_getErrorName(result));
+      throw std::runtime_error(message);
+    }
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Zstd {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ZstdCompressor::ZstdCompressor(
+    int level, const std::shared_ptr<::ZSTD_CDict> &dictionary
+  ) :
+    dictionary(dictionary),
+    context(::ZSTD_createCCtx()),
+    finished(false) {
+    if(this->context == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    try {
+      requireSuccess(::ZSTD_CCtx_setParameter(this->context, ZSTD_c_compressionLevel, level));
+      if(dictionary) {
+        requireSuccess(::ZSTD_CCtx_refCDict(this->context, dictionary.get()));
+      }
+    }
+    catch(...) {
+      ::ZSTD_freeCCtx(this->context);
+      throw;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ZstdCompressor::~ZstdCompressor() {
+    ::ZSTD_freeCCtx(this->context);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason ZstdCompressor::Process(
+    const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.ZstdCompressor.Process");
+    ::ZSTD_inBuffer input = { uncompressedBuffer, uncompressedByteCount, 0 };
+    ::ZSTD_outBuffer output = { outputBuffer, outputByteCount, 0 };
+
+    while((input.pos < input.size) && (output.pos < output.size)) {
+      requireSuccess(::ZSTD_compressStream2(this->context, &output, &input, ZSTD_e_continue));
+    }
+
+    uncompressedByteCount = input.pos;
+    outputByteCount = output.pos;
+
+    if(input.pos < input.size) {
+      return StopReason::OutputBufferFull;
+    } else {
+      return StopReason::InputBufferExhausted;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason ZstdCompressor::Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    return drain(ZSTD_e_flush, outputBuffer, outputByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason ZstdCompressor::Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.ZstdCompressor.Finish");
+
+    // Zstandard would begin another, empty frame if asked to end a completed one
+    if(this->finished) {
+      outputByteCount = 0;
+      return StopReason::Finished;
+    }
+
+    StopReason stopReason = drain(ZSTD_e_end, outputBuffer, outputByteCount);
+    this->finished = (stopReason == StopReason::Finished);
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ZstdCompressor::Reset() {
+    requireSuccess(::ZSTD_CCtx_reset(this->context, ZSTD_reset_session_only));
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason ZstdCompressor::drain(
+    ::ZSTD_EndDirective directive,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    ::ZSTD_inBuffer input = { nullptr, 0, 0 };
+    ::ZSTD_outBuffer output = { outputBuffer, outputByteCount, 0 };
+
+    // Zstandard returns the number of bytes it still has to write out
+    StopReason stopReason;
+    for(;;) {
+      std::size_t remainingByteCount = requireSuccess(
+        ::ZSTD_compressStream2(this->context, &output, &input, directive)
+      );
+      if(remainingByteCount == 0) {
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(output.pos == output.size) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+    }
+
+    outputByteCount = output.pos;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Zstd
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ZSTD)
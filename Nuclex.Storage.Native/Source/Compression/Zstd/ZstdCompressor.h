@@ -0,0 +1,125 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDCOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDCOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#include "Nuclex/Storage/Compression/Compressor.h"
+
+#include <zstd.h>
+
+#include <memory>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Zstd {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses data into Zstandard frames</summary>
+  /// <remarks>
+  ///   The Zstandard compression context is set up once and reused for all calls and,
+  ///   via <see cref="Reset" />, for all following streams without reallocating it.
+  /// </remarks>
+  class ZstdCompressor : public Compressor {
+
+    /// <summary>Initializes a new Zstandard compressor</summary>
+    /// <param name="level">Zstandard compression level that will be used</param>
+    /// <param name="dictionary">
+    ///   Digested dictionary the compressor will use, can be a null pointer
+    /// </param>
+    public: ZstdCompressor(int level, const std::shared_ptr<::ZSTD_CDict> &dictionary);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~ZstdCompressor() override;
+
+    /// <summary>Compresses data from the input buffer into the output buffer</summary>
+    /// <param name="uncompressedBuffer">Buffer holding the data to compress</param>
+    /// <param name="uncompressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the compressor stopped because it needs more input or more output space
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *uncompressedBuffer, std::size_t &uncompressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Writes out all data compressed so far</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the flush has completed or needs more output space</returns>
+    public: StopReason Flush(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Ends the stream and writes out all remaining compressed data</summary>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether the stream has been completed or needs more output space</returns>
+    public: StopReason Finish(std::uint8_t *outputBuffer, std::size_t &outputByteCount) override;
+
+    /// <summary>Prepares the compressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    /// <summary>Lets Zstandard write out pending data without providing more input</summary>
+    /// <param name="directive">Zstandard directive telling it what to write out</param>
+    /// <param name="outputBuffer">Buffer in which the compressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>Whether all pending data has been written or more space is needed</returns>
+    private: StopReason drain(
+      ::ZSTD_EndDirective directive,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    );
+
+    private: ZstdCompressor(const ZstdCompressor &) = delete;
+    private: ZstdCompressor &operator =(const ZstdCompressor &) = delete;
+
+    /// <summary>Dictionary referenced by the compression context</summary>
+    private: std::shared_ptr<::ZSTD_CDict> dictionary;
+    /// <summary>Zstandard compression context holding the compressor's state</summary>
+    private: ::ZSTD_CCtx *context;
+    /// <summary>Whether the current frame has been completely written</summary>
+    private: bool finished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Zstd
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDCOMPRESSOR_H
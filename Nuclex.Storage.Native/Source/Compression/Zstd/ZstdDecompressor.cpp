@@ -0,0 +1,136 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "ZstdDecompressor.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#if defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#include <stdexcept> // for std::runtime_error, std::bad_alloc
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if a Zstandard function has reported an error</summary>
+  /// <param name="result">Result returned by the Zstandard function</param>
+  /// <returns>The result if it was not an error</returns>
+  std::size_t requireSuccess(std::size_t result) {
+    if(::ZSTD_isError(result)) {
+      std::string message(u8"Zstandard decompressor failed: ");
+      message.append(::ZSTD_getErrorName(result));
+      throw std::runtime_error(message);
+    }
+
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Zstd {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ZstdDecompressor::ZstdDecompressor(const std::shared_ptr<::ZSTD_DDict> &dictionary) :
+    dictionary(dictionary),
+    context(::ZSTD_createDCtx()),
+    finished(false) {
+    if(this->context == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    if(dictionary) {
+      try {
+        requireSuccess(::ZSTD_DCtx_refDDict(this->context, dictionary.get()));
+      }
+      catch(...) {
+        ::ZSTD_freeDCtx(this->context);
+        throw;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ZstdDecompressor::~ZstdDecompressor() {
+    ::ZSTD_freeDCtx(this->context);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StopReason ZstdDecompressor::Process(
+    const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+    std::uint8_t *outputBuffer, std::size_t &outputByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.ZstdDecompressor.Process");
+    if(this->finished) {
+      compressedByteCount = 0;
+      outputByteCount = 0;
+      return StopReason::Finished;
+    }
+
+    ::ZSTD_inBuffer input = { compressedBuffer, compressedByteCount, 0 };
+    ::ZSTD_outBuffer output = { outputBuffer, outputByteCount, 0 };
+
+    // Zstandard returns zero once a frame is completely decoded and written out
+    StopReason stopReason;
+    for(;;) {
+      std::size_t result = requireSuccess(
+        ::ZSTD_decompressStream(this->context, &output, &input)
+      );
+      if(result == 0) {
+        this->finished = true;
+        stopReason = StopReason::Finished;
+        break;
+      }
+      if(output.pos == output.size) {
+        stopReason = StopReason::OutputBufferFull;
+        break;
+      }
+      if(input.pos == input.size) {
+        stopReason = StopReason::InputBufferExhausted;
+        break;
+      }
+    }
+
+    compressedByteCount = input.pos;
+    outputByteCount = output.pos;
+    return stopReason;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ZstdDecompressor::Reset() {
+    requireSuccess(::ZSTD_DCtx_reset(this->context, ZSTD_reset_session_only));
+    this->finished = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Zstd
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ZSTD)
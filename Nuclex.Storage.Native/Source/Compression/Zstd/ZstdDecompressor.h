@@ -0,0 +1,95 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDDECOMPRESSOR_H
+#define NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDDECOMPRESSOR_H
+
+#include "Nuclex/Storage/Config.h"
+
+#if defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#include "Nuclex/Storage/Compression/Decompressor.h"
+
+#include <zstd.h>
+
+#include <memory>
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace Zstd {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decompresses data from Zstandard frames</summary>
+  /// <remarks>
+  ///   Data compressed with a dictionary can only be decompressed with the same
+  ///   dictionary. Zstandard stores the dictionary's id in the frame and reports
+  ///   an error if it doesn't match.
+  /// </remarks>
+  class ZstdDecompressor : public Decompressor {
+
+    /// <summary>Initializes a new Zstandard decompressor</summary>
+    /// <param name="dictionary">
+    ///   Digested dictionary the decompressor will use, can be a null pointer
+    /// </param>
+    public: ZstdDecompressor(const std::shared_ptr<::ZSTD_DDict> &dictionary);
+
+    /// <summary>Frees all resources owned by the instance</summary>
+    public: virtual ~ZstdDecompressor() override;
+
+    /// <summary>Decompresses data from the input buffer into the output buffer</summary>
+    /// <param name="compressedBuffer">Buffer holding the compressed data</param>
+    /// <param name="compressedByteCount">
+    ///   Number of bytes in the input buffer, receives the number of bytes consumed
+    /// </param>
+    /// <param name="outputBuffer">Buffer in which the decompressed data will be stored</param>
+    /// <param name="outputByteCount">
+    ///   Number of bytes available in the output buffer, receives the number
+    ///   of bytes written
+    /// </param>
+    /// <returns>
+    ///   Whether the decompressor stopped because it needs more input, needs more output
+    ///   space or has reached the end of the compressed data
+    /// </returns>
+    public: StopReason Process(
+      const std::uint8_t *compressedBuffer, std::size_t &compressedByteCount,
+      std::uint8_t *outputBuffer, std::size_t &outputByteCount
+    ) override;
+
+    /// <summary>Prepares the decompressor for a new, independent stream</summary>
+    public: void Reset() override;
+
+    private: ZstdDecompressor(const ZstdDecompressor &) = delete;
+    private: ZstdDecompressor &operator =(const ZstdDecompressor &) = delete;
+
+    /// <summary>Dictionary referenced by the decompression context</summary>
+    private: std::shared_ptr<::ZSTD_DDict> dictionary;
+    /// <summary>Zstandard decompression context holding the decompressor's state</summary>
+    private: ::ZSTD_DCtx *context;
+    /// <summary>Whether the end of the compressed stream has been reached</summary>
+    private: bool finished;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::Zstd
+
+#endif // defined(NUCLEX_STORAGE_HAVE_ZSTD)
+
+#endif // NUCLEX_STORAGE_COMPRESSION_ZSTD_ZSTDDECOMPRESSOR_H
@@ -0,0 +1,815 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/FileBlob.h"
+#include "AsyncFileIo.h"
+
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+#include <mutex> // for std::mutex
+#include <new> // for std::bad_alloc
+#include <stdexcept> // for std::out_of_range, std::runtime_error
+#include <system_error> // for std::system_error
+
+#if defined(NUCLEX_STORAGE_WIN32)
+#include "Helpers/StringHelper.h"
+#include <malloc.h> // for _aligned_malloc(), _aligned_free()
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h> // for CreateFileW(), ReadFile(), WriteFile()
+#undef min
+#undef max
+#else
+#include <cerrno> // for errno
+#include <cstdlib> // for posix_memalign(), std::free()
+#include <fcntl.h> // for open()
+#include <sys/stat.h> // for fstat()
+#include <unistd.h> // for close(), pread(), pwrite(), fsync(), fdatasync(), ftruncate()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the aligned buffer unaligned transfers are copied through</summary>
+  const std::size_t BounceBufferByteCount = 1024 * 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception for an error reported by the operating system</summary>
+  /// <param name="errorCode">Error code reported by the operating system</param>
+  /// <param name="message">Message describing what was attempted</param>
+  [[noreturn]] void throwSystemError(int errorCode, const char *message) {
+#if defined(NUCLEX_STORAGE_WIN32)
+    throw std::system_error(errorCode, std::system_category(), message);
+#else
+    throw std::system_error(errorCode, std::generic_category(), message);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Block of memory aligned for unbuffered transfers</summary>
+  class AlignedBuffer {
+
+    /// <summary>Allocates a new aligned buffer</summary>
+    /// <param name="byteCount">Number of bytes the buffer will hold</param>
+    public: AlignedBuffer(std::size_t byteCount) :
+      memory(nullptr) {
+#if defined(NUCLEX_STORAGE_WIN32)
+      this->memory = _aligned_malloc(byteCount, Nuclex::Storage::FileBlob::DirectAccessAlignment);
+#else
+      int result = ::posix_memalign(
+        &this->memory, Nuclex::Storage::FileBlob::DirectAccessAlignment, byteCount
+      );
+      if(result != 0) {
+        this->memory = nullptr;
+      }
+#endif
+      if(this->memory == nullptr) {
+        throw std::bad_alloc();
+      }
+    }
+
+    /// <summary>Frees the buffer's memory</summary>
+    public: ~AlignedBuffer() {
+#if defined(NUCLEX_STORAGE_WIN32)
+      _aligned_free(this->memory);
+#else
+      std::free(this->memory);
+#endif
+    }
+
+    /// <summary>Gives the address of the buffer's memory</summary>
+    /// <returns>The address of the buffer's first byte</returns>
+    public: std::uint8_t *Get() const { return static_cast<std::uint8_t *>(this->memory); }
+
+    private: AlignedBuffer(const AlignedBuffer &) = delete;
+    private: AlignedBuffer &operator =(const AlignedBuffer &) = delete;
+
+    /// <summary>Memory owned by the buffer</summary>
+    private: void *memory;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_WIN32)
+
+  /// <summary>Type of the OS handle through which files are accessed</summary>
+  typedef HANDLE FileHandle;
+
+  /// <summary>Value of a file handle that doesn't refer to an opened file</summary>
+  const HANDLE InvalidFileHandle = INVALID_HANDLE_VALUE;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a file via the Windows API</summary>
+  /// <param name="path">Path of the file that will be opened</param>
+  /// <param name="writable">Whether the file will be opened for writing</param>
+  /// <param name="unbuffered">Whether accesses should bypass the file system cache</param>
+  /// <returns>The handle of the opened file</returns>
+  HANDLE openFile(const std::string &path, bool writable, bool unbuffered) {
+    std::wstring utf16Path = Nuclex::Storage::Helpers::StringHelper::WideCharFromUtf8(path);
+    HANDLE fileHandle = ::CreateFileW(
+      utf16Path.c_str(),
+      writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE, // Needed to open the file a second time
+      nullptr,
+      writable ? OPEN_ALWAYS : OPEN_EXISTING,
+      unbuffered ? FILE_FLAG_NO_BUFFERING : FILE_ATTRIBUTE_NORMAL,
+      nullptr
+    );
+    if(fileHandle == INVALID_HANDLE_VALUE) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not open the file");
+    }
+
+    return fileHandle;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a file for overlapped I/O via the Windows API</summary>
+  /// <param name="path">Path of the file that will be opened</param>
+  /// <param name="writable">Whether the file will be opened for writing</param>
+  /// <returns>The handle of the opened file</returns>
+  HANDLE openOverlappedFile(const std::string &path, bool writable) {
+    std::wstring utf16Path = Nuclex::Storage::Helpers::StringHelper::WideCharFromUtf8(path);
+    HANDLE fileHandle = ::CreateFileW(
+      utf16Path.c_str(),
+      writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE,
+      nullptr,
+      OPEN_EXISTING, // The normal handle has already created the file
+      FILE_FLAG_OVERLAPPED,
+      nullptr
+    );
+    if(fileHandle == INVALID_HANDLE_VALUE) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not open the file");
+    }
+
+    return fileHandle;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Closes a file handle</summary>
+  /// <param name="fileHandle">Handle that will be closed</param>
+  void closeFile(HANDLE fileHandle) {
+    ::CloseHandle(fileHandle);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the current size of a file</summary>
+  /// <param name="fileHandle">Handle of the file whose size will be determined</param>
+  /// <returns>The size of the file in bytes</returns>
+  std::uint64_t getFileSize(HANDLE fileHandle) {
+    LARGE_INTEGER fileSize;
+    if(::GetFileSizeEx(fileHandle, &fileSize) == FALSE) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not determine file size");
+    }
+
+    return static_cast<std::uint64_t>(fileSize.QuadPart);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a chunk of a file at the specified location</summary>
+  /// <param name="fileHandle">Handle of the file that will be read</param>
+  /// <param name="location">Absolute position data will be read from</param>
+  /// <param name="buffer">Buffer into which data will be read</param>
+  /// <param name="count">Number of bytes that will be read</param>
+  /// <returns>The number of bytes actually read, zero at the end of the file</returns>
+  std::size_t readFileAt(
+    HANDLE fileHandle, std::uint64_t location, std::uint8_t *buffer, std::size_t count
+  ) {
+    DWORD chunkByteCount = static_cast<DWORD>(
+      (count < std::numeric_limits<DWORD>::max()) ? count : std::numeric_limits<DWORD>::max()
+    );
+
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(location);
+    overlapped.OffsetHigh = static_cast<DWORD>(location >> 32);
+
+    DWORD readByteCount;
+    BOOL result = ::ReadFile(fileHandle, buffer, chunkByteCount, &readByteCount, &overlapped);
+    if(result == FALSE) {
+      DWORD lastErrorCode = ::GetLastError();
+      if(lastErrorCode == ERROR_HANDLE_EOF) {
+        return 0;
+      }
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not read from the file");
+    }
+
+    return static_cast<std::size_t>(readByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a chunk of a file at the specified location</summary>
+  /// <param name="fileHandle">Handle of the file that will be written</param>
+  /// <param name="location">Absolute position data will be written to</param>
+  /// <param name="buffer">Buffer from which data will be taken</param>
+  /// <param name="count">Number of bytes that will be written</param>
+  /// <returns>The number of bytes actually written</returns>
+  std::size_t writeFileAt(
+    HANDLE fileHandle, std::uint64_t location, const std::uint8_t *buffer, std::size_t count
+  ) {
+    DWORD chunkByteCount = static_cast<DWORD>(
+      (count < std::numeric_limits<DWORD>::max()) ? count : std::numeric_limits<DWORD>::max()
+    );
+
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(location);
+    overlapped.OffsetHigh = static_cast<DWORD>(location >> 32);
+
+    DWORD writtenByteCount;
+    BOOL result = ::WriteFile(fileHandle, buffer, chunkByteCount, &writtenByteCount, &overlapped);
+    if(result == FALSE) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not write to the file");
+    }
+
+    return static_cast<std::size_t>(writtenByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Waits until all data written to a file has reached the disk</summary>
+  /// <param name="fileHandle">Handle of the file that will be synchronized</param>
+  void syncFile(HANDLE fileHandle) {
+    if(::FlushFileBuffers(fileHandle) == FALSE) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not flush the file's buffers");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Changes the size of a file</summary>
+  /// <param name="fileHandle">Handle of the file whose size will be changed</param>
+  /// <param name="newSize">New size the file will have in bytes</param>
+  void resizeFile(HANDLE fileHandle, std::uint64_t newSize) {
+    FILE_END_OF_FILE_INFO endOfFileInfo;
+    endOfFileInfo.EndOfFile.QuadPart = static_cast<LONGLONG>(newSize);
+
+    BOOL result = ::SetFileInformationByHandle(
+      fileHandle, FileEndOfFileInfo, &endOfFileInfo, sizeof(endOfFileInfo)
+    );
+    if(result == FALSE) {
+      DWORD lastErrorCode = ::GetLastError();
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not change the file's size");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#else // Linux and Posix both offer pread() and pwrite()
+
+  /// <summary>Type of the OS handle through which files are accessed</summary>
+  typedef int FileHandle;
+
+  /// <summary>Value of a file handle that doesn't refer to an opened file</summary>
+  const int InvalidFileHandle = -1;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Opens a file via the Posix API</summary>
+  /// <param name="path">Path of the file that will be opened</param>
+  /// <param name="writable">Whether the file will be opened for writing</param>
+  /// <param name="unbuffered">Whether accesses should bypass the page cache</param>
+  /// <returns>The file descriptor of the opened file</returns>
+  int openFile(const std::string &path, bool writable, bool unbuffered) {
+    int flags = writable ? (O_RDWR | O_CREAT) : O_RDONLY;
+#if defined(O_DIRECT)
+    if(unbuffered) {
+      flags |= O_DIRECT;
+    }
+#else
+    (void)unbuffered;
+#endif
+
+#if defined(O_NOATIME)
+    // Not updating the access time saves a write for each read, but the OS only allows
+    // it for the owner of the file, so try again without if we're not allowed to.
+    if(!writable) {
+      int fileDescriptor = ::open(path.c_str(), flags | O_NOATIME);
+      if(fileDescriptor != -1) {
+        return fileDescriptor;
+      }
+      if(errno != EPERM) {
+        int errorNumber = errno;
+        throwSystemError(errorNumber, u8"Could not open the file");
+      }
+    }
+#endif
+
+    int fileDescriptor = ::open(path.c_str(), flags, 0644);
+    if(fileDescriptor == -1) {
+      int errorNumber = errno;
+      throwSystemError(errorNumber, u8"Could not open the file");
+    }
+
+    return fileDescriptor;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Closes a file descriptor</summary>
+  /// <param name="fileDescriptor">File descriptor that will be closed</param>
+  void closeFile(int fileDescriptor) {
+    ::close(fileDescriptor);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Determines the current size of a file</summary>
+  /// <param name="fileDescriptor">File descriptor of the file to check</param>
+  /// <returns>The size of the file in bytes</returns>
+  std::uint64_t getFileSize(int fileDescriptor) {
+    struct ::stat fileStatus;
+    if(::fstat(fileDescriptor, &fileStatus) == -1) {
+      int errorNumber = errno;
+      throwSystemError(errorNumber, u8"Could not determine file size");
+    }
+
+    return static_cast<std::uint64_t>(fileStatus.st_size);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a chunk of a file at the specified location</summary>
+  /// <param name="fileDescriptor">File descriptor of the file that will be read</param>
+  /// <param name="location">Absolute position data will be read from</param>
+  /// <param name="buffer">Buffer into which data will be read</param>
+  /// <param name="count">Number of bytes that will be read</param>
+  /// <returns>The number of bytes actually read, zero at the end of the file</returns>
+  std::size_t readFileAt(
+    int fileDescriptor, std::uint64_t location, std::uint8_t *buffer, std::size_t count
+  ) {
+    for(;;) {
+      ssize_t result = ::pread(fileDescriptor, buffer, count, static_cast<off_t>(location));
+      if(result != -1) {
+        return static_cast<std::size_t>(result);
+      }
+
+      int errorNumber = errno;
+      if(errorNumber != EINTR) {
+        throwSystemError(errorNumber, u8"Could not read from the file");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a chunk of a file at the specified location</summary>
+  /// <param name="fileDescriptor">File descriptor of the file that will be written</param>
+  /// <param name="location">Absolute position data will be written to</param>
+  /// <param name="buffer">Buffer from which data will be taken</param>
+  /// <param name="count">Number of bytes that will be written</param>
+  /// <returns>The number of bytes actually written</returns>
+  std::size_t writeFileAt(
+    int fileDescriptor, std::uint64_t location, const std::uint8_t *buffer, std::size_t count
+  ) {
+    for(;;) {
+      ssize_t result = ::pwrite(fileDescriptor, buffer, count, static_cast<off_t>(location));
+      if(result != -1) {
+        return static_cast<std::size_t>(result);
+      }
+
+      int errorNumber = errno;
+      if(errorNumber != EINTR) {
+        throwSystemError(errorNumber, u8"Could not write to the file");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Waits until all data written to a file has reached the disk</summary>
+  /// <param name="fileDescriptor">File descriptor of the file that will be synchronized</param>
+  void syncFile(int fileDescriptor) {
+#if defined(NUCLEX_STORAGE_LINUX)
+    // Only the data and the metadata needed to read it back (i.e. the file size) have
+    // to reach the disk, fdatasync() skips the journal write for the modification time
+    int result = ::fdatasync(fileDescriptor);
+#else
+    int result = ::fsync(fileDescriptor);
+#endif
+    if(result == -1) {
+      int errorNumber = errno;
+      throwSystemError(errorNumber, u8"Could not flush the file's buffers");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Changes the size of a file</summary>
+  /// <param name="fileDescriptor">File descriptor of the file whose size will be changed</param>
+  /// <param name="newSize">New size the file will have in bytes</param>
+  void resizeFile(int fileDescriptor, std::uint64_t newSize) {
+    int result;
+    do {
+      result = ::ftruncate(fileDescriptor, static_cast<::off_t>(newSize));
+    } while((result == -1) && (errno == EINTR));
+
+    if(result == -1) {
+      int errorNumber = errno;
+      throwSystemError(errorNumber, u8"Could not change the file's size");
+    }
+  }
+
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the requested number of bytes, failing if the file ends early</summary>
+  /// <param name="fileHandle">Handle of the file that will be read</param>
+  /// <param name="location">Absolute position data will be read from</param>
+  /// <param name="buffer">Buffer into which data will be read</param>
+  /// <param name="count">Number of bytes that will be read</param>
+  void readFully(
+    FileHandle fileHandle, std::uint64_t location, std::uint8_t *buffer, std::size_t count
+  ) {
+    while(count > 0) {
+      std::size_t readByteCount = readFileAt(fileHandle, location, buffer, count);
+      if(readByteCount == 0) {
+        throw std::out_of_range(u8"Attempted read past the end of the file blob");
+      }
+
+      location += readByteCount;
+      buffer += readByteCount;
+      count -= readByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes the requested number of bytes</summary>
+  /// <param name="fileHandle">Handle of the file that will be written</param>
+  /// <param name="location">Absolute position data will be written to</param>
+  /// <param name="buffer">Buffer from which data will be taken</param>
+  /// <param name="count">Number of bytes that will be written</param>
+  void writeFully(
+    FileHandle fileHandle, std::uint64_t location, const std::uint8_t *buffer, std::size_t count
+  ) {
+    while(count > 0) {
+      std::size_t writtenByteCount = writeFileAt(fileHandle, location, buffer, count);
+      location += writtenByteCount;
+      buffer += writtenByteCount;
+      count -= writtenByteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether an address is suitable for unbuffered transfers</summary>
+  /// <param name="address">Address that will be checked</param>
+  /// <returns>True if the address is aligned for unbuffered transfers</returns>
+  bool isAligned(const void *address) {
+    std::uintptr_t value = reinterpret_cast<std::uintptr_t>(address);
+    return (value % Nuclex::Storage::FileBlob::DirectAccessAlignment) == 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>OS handles of the file</summary>
+  struct FileBlob::Impl {
+
+    /// <summary>Initializes the structure for a file that has not been opened yet</summary>
+    /// <param name="path">Path of the file that will be opened</param>
+    /// <param name="writable">Whether the file will be opened for writing</param>
+    public: Impl(const std::string &path, bool writable) :
+      Path(path),
+      Writable(writable),
+      File(InvalidFileHandle),
+      DirectFile(InvalidFileHandle),
+      AsyncFile(InvalidFileHandle),
+      AsyncIoMutex(),
+      AsyncIoAttempted(false) {}
+
+    /// <summary>Closes the file handles</summary>
+    public: ~Impl() {
+#if defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+      this->AsyncIo.reset(); // Waits for outstanding operations
+#endif
+      if(this->AsyncFile != InvalidFileHandle) {
+        closeFile(this->AsyncFile);
+      }
+      if(this->DirectFile != InvalidFileHandle) {
+        closeFile(this->DirectFile);
+      }
+      if(this->File != InvalidFileHandle) {
+        closeFile(this->File);
+      }
+    }
+
+    /// <summary>
+    ///   Determines the part of a request that can be transferred while bypassing
+    ///   the page cache
+    /// </summary>
+    /// <param name="location">Absolute position at which the request begins</param>
+    /// <param name="count">Number of bytes that are requested</param>
+    /// <param name="directStart">Receives the offset of the unbuffered part</param>
+    /// <param name="directCount">Receives the length of the unbuffered part</param>
+    /// <returns>True if a part of the request can be transferred unbuffered</returns>
+    public: bool GetDirectRange(
+      std::uint64_t location, std::size_t count,
+      std::size_t &directStart, std::size_t &directCount
+    ) const {
+      const std::uint64_t alignment = DirectAccessAlignment;
+      if((this->DirectFile == InvalidFileHandle) || (count < alignment)) {
+        return false;
+      }
+
+      std::uint64_t alignedStart = (location + alignment - 1) / alignment * alignment;
+      std::uint64_t alignedEnd = (location + count) / alignment * alignment;
+      if(alignedEnd <= alignedStart) {
+        return false;
+      }
+
+      directStart = static_cast<std::size_t>(alignedStart - location);
+      directCount = static_cast<std::size_t>(alignedEnd - alignedStart);
+      return true;
+    }
+
+#if defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+    /// <summary>Sets up asynchronous I/O on the file when it is first needed</summary>
+    /// <returns>
+    ///   The asynchronous I/O backend or a null pointer if the system doesn't offer one
+    /// </returns>
+    public: AsyncFileIo *GetAsyncIo() {
+      std::lock_guard<std::mutex> lock(this->AsyncIoMutex);
+      if(!this->AsyncIoAttempted) {
+        this->AsyncIoAttempted = true;
+
+        // If the kernel is too old for io_uring or has it disabled, the blob
+        // keeps working with the synchronous fallback of the Blob base class.
+        try {
+#if defined(NUCLEX_STORAGE_WIN32)
+          this->AsyncFile = openOverlappedFile(this->Path, this->Writable);
+          this->AsyncIo.reset(new AsyncFileIo(this->AsyncFile));
+#else
+          this->AsyncIo.reset(new AsyncFileIo(this->File));
+#endif
+        }
+        catch(const std::system_error &) {
+          this->AsyncIo.reset();
+        }
+      }
+
+      return this->AsyncIo.get();
+    }
+#endif
+
+    /// <summary>Path of the file, needed to open additional handles</summary>
+    public: std::string Path;
+    /// <summary>Whether the file has been opened for writing</summary>
+    public: bool Writable;
+    /// <summary>Handle through which the file is accessed normally</summary>
+    public: FileHandle File;
+    /// <summary>Handle through which aligned blocks bypass the page cache</summary>
+    public: FileHandle DirectFile;
+    /// <summary>Handle for overlapped I/O, only used on Windows</summary>
+    public: FileHandle AsyncFile;
+    /// <summary>Must be held while setting up asynchronous I/O</summary>
+    public: std::mutex AsyncIoMutex;
+    /// <summary>Whether setting up asynchronous I/O has already been attempted</summary>
+    public: bool AsyncIoAttempted;
+#if defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+    /// <summary>Performs asynchronous reads and writes on the file</summary>
+    public: std::unique_ptr<AsyncFileIo> AsyncIo;
+#endif
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FileBlob::FileBlob(
+    const std::string &path, bool writable /* = false */, bool unbuffered /* = false */
+  ) :
+    impl(new Impl(path, writable)) {
+    this->impl->File = openFile(path, writable, false);
+
+    // Unbuffered access only works on some file systems. If the file system
+    // doesn't want it, we'll just keep going through the page cache.
+    if(unbuffered) {
+      try {
+        this->impl->DirectFile = openFile(path, writable, true);
+      }
+      catch(const std::system_error &) {
+        this->impl->DirectFile = InvalidFileHandle;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  FileBlob::~FileBlob() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FileBlob::IsWritable() const {
+    return this->impl->Writable;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool FileBlob::IsUnbuffered() const {
+    return (this->impl->DirectFile != InvalidFileHandle);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t FileBlob::GetSize() const {
+    return getFileSize(this->impl->File);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FileBlob::ReadAt(std::uint64_t location, void *buffer, std::size_t count) const {
+    std::uint8_t *bytes = static_cast<std::uint8_t *>(buffer);
+
+    std::size_t directStart, directCount;
+    if(!this->impl->GetDirectRange(location, count, directStart, directCount)) {
+      readFully(this->impl->File, location, bytes, count);
+      return;
+    }
+
+    // Unbuffered reads at the end of the file come back short and leave the cursor
+    // unaligned, so make sure up front that the whole range exists.
+    if(location + count > getFileSize(this->impl->File)) {
+      throw std::out_of_range(u8"Attempted read past the end of the file blob");
+    }
+
+    readFully(this->impl->File, location, bytes, directStart);
+
+    std::uint8_t *directBytes = bytes + directStart;
+    std::uint64_t directLocation = location + directStart;
+    if(isAligned(directBytes)) {
+      readFully(this->impl->DirectFile, directLocation, directBytes, directCount);
+    } else {
+      std::size_t bounceByteCount = directCount;
+      if(bounceByteCount > BounceBufferByteCount) {
+        bounceByteCount = BounceBufferByteCount;
+      }
+
+      AlignedBuffer bounceBuffer(bounceByteCount);
+      for(std::size_t offset = 0; offset < directCount; offset += bounceByteCount) {
+        std::size_t chunkByteCount = directCount - offset;
+        if(chunkByteCount > bounceByteCount) {
+          chunkByteCount = bounceByteCount;
+        }
+
+        readFully(
+          this->impl->DirectFile, directLocation + offset, bounceBuffer.Get(), chunkByteCount
+        );
+        std::memcpy(directBytes + offset, bounceBuffer.Get(), chunkByteCount);
+      }
+    }
+
+    std::size_t directEnd = directStart + directCount;
+    readFully(this->impl->File, location + directEnd, bytes + directEnd, count - directEnd);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FileBlob::WriteAt(std::uint64_t location, const void *buffer, std::size_t count) {
+    if(!this->impl->Writable) {
+      throw std::runtime_error(u8"Attempted write to a read-only file blob");
+    }
+
+    const std::uint8_t *bytes = static_cast<const std::uint8_t *>(buffer);
+
+    std::size_t directStart, directCount;
+    if(!this->impl->GetDirectRange(location, count, directStart, directCount)) {
+      writeFully(this->impl->File, location, bytes, count);
+      return;
+    }
+
+    writeFully(this->impl->File, location, bytes, directStart);
+
+    const std::uint8_t *directBytes = bytes + directStart;
+    std::uint64_t directLocation = location + directStart;
+    if(isAligned(directBytes)) {
+      writeFully(this->impl->DirectFile, directLocation, directBytes, directCount);
+    } else {
+      std::size_t bounceByteCount = directCount;
+      if(bounceByteCount > BounceBufferByteCount) {
+        bounceByteCount = BounceBufferByteCount;
+      }
+
+      AlignedBuffer bounceBuffer(bounceByteCount);
+      for(std::size_t offset = 0; offset < directCount; offset += bounceByteCount) {
+        std::size_t chunkByteCount = directCount - offset;
+        if(chunkByteCount > bounceByteCount) {
+          chunkByteCount = bounceByteCount;
+        }
+
+        std::memcpy(bounceBuffer.Get(), directBytes + offset, chunkByteCount);
+        writeFully(
+          this->impl->DirectFile, directLocation + offset, bounceBuffer.Get(), chunkByteCount
+        );
+      }
+    }
+
+    std::size_t directEnd = directStart + directCount;
+    writeFully(this->impl->File, location + directEnd, bytes + directEnd, count - directEnd);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<void> FileBlob::ReadAtAsync(
+    std::uint64_t location, void *buffer, std::size_t count
+  ) const {
+#if defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+    AsyncFileIo *asyncIo = this->impl->GetAsyncIo();
+    if(asyncIo != nullptr) {
+      return asyncIo->Read(location, buffer, count);
+    }
+#endif
+    return Blob::ReadAtAsync(location, buffer, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<std::future<void>> FileBlob::ReadAtAsync(
+    const BlobReadRequest *requests, std::size_t requestCount
+  ) const {
+#if defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+    AsyncFileIo *asyncIo = this->impl->GetAsyncIo();
+    if(asyncIo != nullptr) {
+      return asyncIo->Read(requests, requestCount);
+    }
+#endif
+    return Blob::ReadAtAsync(requests, requestCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::future<void> FileBlob::WriteAtAsync(
+    std::uint64_t location, const void *buffer, std::size_t count
+  ) {
+#if defined(NUCLEX_STORAGE_HAVE_ASYNC_FILE_IO)
+    // Read-only blobs take the synchronous path, which reports the error via the future
+    if(this->impl->Writable) {
+      AsyncFileIo *asyncIo = this->impl->GetAsyncIo();
+      if(asyncIo != nullptr) {
+        return asyncIo->Write(location, buffer, count);
+      }
+    }
+#endif
+    return Blob::WriteAtAsync(location, buffer, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FileBlob::Truncate(std::uint64_t newSize) {
+    if(!this->impl->Writable) {
+      throw std::runtime_error(u8"Attempted to resize a read-only file blob");
+    }
+
+    resizeFile(this->impl->File, newSize);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void FileBlob::Flush() {
+    if(this->impl->Writable) {
+      syncFile(this->impl->File);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
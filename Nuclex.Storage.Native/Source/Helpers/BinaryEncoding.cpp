@@ -0,0 +1,557 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BinaryEncoding.h"
+
+#include <stdexcept> // for std::runtime_error
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+#include <tmmintrin.h> // for SSSE3
+#elif defined(NUCLEX_STORAGE_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#elif defined(NUCLEX_STORAGE_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Characters used to represent the 64 possible values in base-64</summary>
+  const char Base64Alphabet[] =
+    u8"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  /// <summary>Characters used to represent the 16 possible values of a nibble</summary>
+  const char HexAlphabet[] = u8"0123456789ABCDEF";
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether the specified character is a whitespace</summary>
+  /// <param name="character">Character that will be checked for being a whitespace</param>
+  /// <returns>True if the character is a whitespace character, false otherwise</returns>
+  bool isWhitespace(char character) {
+    return
+      (character == ' ') ||
+      (character == '\t') ||
+      (character == '\r') ||
+      (character == '\n');
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the value of a character in the base-64 alphabet</summary>
+  /// <param name="character">Character whose value will be looked up</param>
+  /// <returns>The value of the character or -1 if it is not part of the alphabet</returns>
+  int getBase64Value(char character) {
+    if((character >= 'A') && (character <= 'Z')) {
+      return character - 'A';
+    } else if((character >= 'a') && (character <= 'z')) {
+      return character - 'a' + 26;
+    } else if((character >= '0') && (character <= '9')) {
+      return character - '0' + 52;
+    } else if(character == '+') {
+      return 62;
+    } else if(character == '/') {
+      return 63;
+    } else {
+      return -1;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the value of a hexadecimal digit</summary>
+  /// <param name="character">Digit whose value will be looked up</param>
+  /// <returns>The value of the digit or -1 if it is not a hexadecimal digit</returns>
+  int getHexValue(char character) {
+    if((character >= '0') && (character <= '9')) {
+      return character - '0';
+    } else if((character >= 'A') && (character <= 'F')) {
+      return character - 'A' + 10;
+    } else if((character >= 'a') && (character <= 'f')) {
+      return character - 'a' + 10;
+    } else {
+      return -1;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception if a number of bytes doesn't fit into a buffer</summary>
+  /// <param name="written">Number of bytes already written into the buffer</param>
+  /// <param name="capacity">Total number of bytes that fit into the buffer</param>
+  /// <param name="byteCount">Number of bytes that are about to be written</param>
+  void requireCapacity(std::size_t written, std::size_t capacity, std::size_t byteCount) {
+    if(capacity - written < byteCount) {
+      throw std::runtime_error(u8"Encoded binary data is longer than expected");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+  /// <summary>Encodes 12 bytes into 16 base-64 characters</summary>
+  /// <param name="source">Bytes that will be encoded, 16 bytes must be readable</param>
+  /// <param name="target">Receives the 16 base-64 characters</param>
+  /// <remarks>
+  ///   This is the shuffle and multiply method described by Wojciech Mula. Each group of
+  ///   three bytes is spread over a 32 bit lane, the four 6 bit values are moved into
+  ///   their own bytes with two multiplications and are then mapped to characters by
+  ///   looking up an offset in a 16 entry table.
+  /// </remarks>
+  void encodeBase64Block(const std::uint8_t *source, char *target) {
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+    input = _mm_shuffle_epi8(
+      input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1)
+    );
+
+    __m128i upper = _mm_mulhi_epu16(
+      _mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040)
+    );
+    __m128i lower = _mm_mullo_epi16(
+      _mm_and_si128(input, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010)
+    );
+    __m128i indices = _mm_or_si128(upper, lower);
+
+    // Reduce the indices to 0 for lower case letters, 1-10 for digits, 11 and 12 for
+    // the two special characters and 13 for upper case letters, then add the offset
+    // at which each of those ranges begins in the ASCII table
+    __m128i ranges = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    ranges = _mm_or_si128(
+      ranges,
+      _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13))
+    );
+    const __m128i offsets = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+    );
+    __m128i characters = _mm_add_epi8(_mm_shuffle_epi8(offsets, ranges), indices);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(target), characters);
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+  /// <summary>Tries to decode 16 base-64 characters into 12 bytes</summary>
+  /// <param name="text">Characters that will be decoded</param>
+  /// <param name="target">
+  ///   Receives the decoded bytes, 16 bytes will be written of which only 12 matter
+  /// </param>
+  /// <returns>
+  ///   True if all 16 characters were part of the base-64 alphabet, false if any of them
+  ///   was a different character (padding, whitespace or an invalid character)
+  /// </returns>
+  /// <remarks>
+  ///   Validation and translation use the nibble lookup tables by Wojciech Mula. If this
+  ///   returns false, nothing has been written and the characters need to be decoded
+  ///   one by one.
+  /// </remarks>
+  bool tryDecodeBase64Block(const char *text, std::uint8_t *target) {
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+
+    __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0F));
+    __m128i lowNibbles = _mm_and_si128(input, _mm_set1_epi8(0x0F));
+
+    // Each bit in these tables stands for a range of characters that is invalid for
+    // a certain high nibble. A character is invalid if both its nibbles share a bit.
+    const __m128i lowNibbleTable = _mm_setr_epi8(
+      0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+    );
+    const __m128i highNibbleTable = _mm_setr_epi8(
+      0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+    );
+    __m128i invalid = _mm_and_si128(
+      _mm_shuffle_epi8(lowNibbleTable, lowNibbles),
+      _mm_shuffle_epi8(highNibbleTable, highNibbles)
+    );
+    if(_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) != 0) {
+      return false;
+    }
+
+    // Translate the characters into their 6 bit values by adding an offset that
+    // depends on the high nibble ('/' shares its high nibble with '+' and needs its own)
+    const __m128i offsets = _mm_setr_epi8(
+      0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0
+    );
+    __m128i isSlash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+    __m128i values = _mm_add_epi8(
+      input, _mm_shuffle_epi8(offsets, _mm_add_epi8(isSlash, highNibbles))
+    );
+
+    // Merge four 6 bit values into three bytes in each 32 bit lane, then compact them
+    __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i lanes = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    __m128i bytes = _mm_shuffle_epi8(
+      lanes, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+    );
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(target), bytes);
+    return true;
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+  /// <summary>Turns 16 nibbles into hexadecimal digits</summary>
+  /// <param name="nibbles">Nibbles that will be turned into digits</param>
+  /// <returns>The hexadecimal digits for the nibbles</returns>
+  __m128i getHexDigits(__m128i nibbles) {
+    __m128i digits = _mm_add_epi8(nibbles, _mm_set1_epi8('0'));
+    __m128i isLetter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(digits, _mm_and_si128(isLetter, _mm_set1_epi8('A' - '0' - 10)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tries to turn 16 hexadecimal digits into nibbles</summary>
+  /// <param name="digits">Digits that will be turned into nibbles</param>
+  /// <param name="nibbles">Receives the nibbles</param>
+  /// <returns>True if all 16 characters were hexadecimal digits</returns>
+  bool tryGetHexNibbles(__m128i digits, __m128i &nibbles) {
+    __m128i zero = _mm_setzero_si128();
+
+    // Unsigned comparisons via saturating subtraction: x <= n if (x -sat n) == 0
+    __m128i numbers = _mm_sub_epi8(digits, _mm_set1_epi8('0'));
+    __m128i isNumber = _mm_cmpeq_epi8(_mm_subs_epu8(numbers, _mm_set1_epi8(9)), zero);
+    __m128i letters = _mm_sub_epi8(
+      _mm_or_si128(digits, _mm_set1_epi8(0x20)), _mm_set1_epi8('a')
+    );
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_subs_epu8(letters, _mm_set1_epi8(5)), zero);
+
+    nibbles = _mm_or_si128(
+      _mm_and_si128(isNumber, numbers),
+      _mm_and_si128(isLetter, _mm_add_epi8(letters, _mm_set1_epi8(10)))
+    );
+    return (_mm_movemask_epi8(_mm_or_si128(isNumber, isLetter)) == 0xFFFF);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Combines pairs of nibbles in the 16 bit lanes of a vector into bytes</summary>
+  /// <param name="nibbles">Nibbles with the high nibble of each byte coming first</param>
+  /// <returns>Vector with the bytes in the lower half of each 16 bit lane</returns>
+  __m128i combineHexNibbles(__m128i nibbles) {
+    return _mm_or_si128(
+      _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+      _mm_srli_epi16(nibbles, 8)
+    );
+  }
+#elif defined(NUCLEX_STORAGE_HAVE_NEON)
+  /// <summary>Turns 16 nibbles into hexadecimal digits</summary>
+  /// <param name="nibbles">Nibbles that will be turned into digits</param>
+  /// <returns>The hexadecimal digits for the nibbles</returns>
+  uint8x16_t getHexDigits(uint8x16_t nibbles) {
+    uint8x16_t digits = vaddq_u8(nibbles, vdupq_n_u8('0'));
+    uint8x16_t isLetter = vcgtq_u8(nibbles, vdupq_n_u8(9));
+    return vaddq_u8(digits, vandq_u8(isLetter, vdupq_n_u8('A' - '0' - 10)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Turns 16 hexadecimal digits into nibbles</summary>
+  /// <param name="digits">Digits that will be turned into nibbles</param>
+  /// <param name="valid">Receives a mask with all bits set for valid digits</param>
+  /// <returns>The nibbles for the digits</returns>
+  uint8x16_t getHexNibbles(uint8x16_t digits, uint8x16_t &valid) {
+    uint8x16_t numbers = vsubq_u8(digits, vdupq_n_u8('0'));
+    uint8x16_t isNumber = vcleq_u8(numbers, vdupq_n_u8(9));
+    uint8x16_t letters = vsubq_u8(vorrq_u8(digits, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t isLetter = vcleq_u8(letters, vdupq_n_u8(5));
+
+    valid = vorrq_u8(isNumber, isLetter);
+    return vbslq_u8(isNumber, numbers, vaddq_u8(letters, vdupq_n_u8(10)));
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_SSE2) || defined(NUCLEX_STORAGE_HAVE_NEON)
+  /// <summary>Encodes 16 bytes into 32 hexadecimal digits</summary>
+  /// <param name="source">Bytes that will be encoded</param>
+  /// <param name="target">Receives the 32 hexadecimal digits</param>
+  void encodeHexBlock(const std::uint8_t *source, char *target) {
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+    __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source));
+    __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    __m128i high = getHexDigits(_mm_and_si128(_mm_srli_epi16(input, 4), nibbleMask));
+    __m128i low = getHexDigits(_mm_and_si128(input, nibbleMask));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(target + 16), _mm_unpackhi_epi8(high, low));
+#else
+    uint8x16_t input = vld1q_u8(source);
+    uint8x16x2_t digits;
+    digits.val[0] = getHexDigits(vshrq_n_u8(input, 4));
+    digits.val[1] = getHexDigits(vandq_u8(input, vdupq_n_u8(0x0F)));
+
+    vst2q_u8(reinterpret_cast<std::uint8_t *>(target), digits); // interleaves high and low
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tries to decode 32 hexadecimal digits into 16 bytes</summary>
+  /// <param name="text">Digits that will be decoded</param>
+  /// <param name="target">Receives the 16 decoded bytes</param>
+  /// <returns>
+  ///   True if all characters were hexadecimal digits, false if any of them was
+  ///   a different character, in which case nothing has been written
+  /// </returns>
+  bool tryDecodeHexBlock(const char *text, std::uint8_t *target) {
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+    __m128i first, second;
+    bool valid = (
+      tryGetHexNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(text)), first) &&
+      tryGetHexNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(text + 16)), second)
+    );
+    if(!valid) {
+      return false;
+    }
+
+    __m128i bytes = _mm_packus_epi16(combineHexNibbles(first), combineHexNibbles(second));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(target), bytes);
+#else
+    uint8x16x2_t digits = vld2q_u8(reinterpret_cast<const std::uint8_t *>(text));
+
+    uint8x16_t highValid, lowValid;
+    uint8x16_t high = getHexNibbles(digits.val[0], highValid);
+    uint8x16_t low = getHexNibbles(digits.val[1], lowValid);
+
+    uint8x16_t valid = vandq_u8(highValid, lowValid);
+    uint8x8_t folded = vand_u8(vget_low_u8(valid), vget_high_u8(valid));
+    if(vget_lane_u64(vreinterpret_u64_u8(folded), 0) != 0xFFFFFFFFFFFFFFFFULL) {
+      return false;
+    }
+
+    vst1q_u8(target, vorrq_u8(vshlq_n_u8(high, 4), low));
+#endif
+    return true;
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryEncoder::EncodeBase64(
+    const std::uint8_t *source, std::size_t byteCount, char *target
+  ) {
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+    // Each block consumes 12 bytes but loads 16, so stop while 16 are still readable
+    for(; byteCount >= 16; byteCount -= 12) {
+      encodeBase64Block(source, target);
+      source += 12;
+      target += 16;
+    }
+#endif
+
+    for(; byteCount >= 3; byteCount -= 3) {
+      target[0] = Base64Alphabet[source[0] >> 2];
+      target[1] = Base64Alphabet[((source[0] & 0x03) << 4) | (source[1] >> 4)];
+      target[2] = Base64Alphabet[((source[1] & 0x0F) << 2) | (source[2] >> 6)];
+      target[3] = Base64Alphabet[source[2] & 0x3F];
+      source += 3;
+      target += 4;
+    }
+
+    if(byteCount == 2) {
+      target[0] = Base64Alphabet[source[0] >> 2];
+      target[1] = Base64Alphabet[((source[0] & 0x03) << 4) | (source[1] >> 4)];
+      target[2] = Base64Alphabet[(source[1] & 0x0F) << 2];
+      target[3] = '=';
+    } else if(byteCount == 1) {
+      target[0] = Base64Alphabet[source[0] >> 2];
+      target[1] = Base64Alphabet[(source[0] & 0x03) << 4];
+      target[2] = '=';
+      target[3] = '=';
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryEncoder::EncodeHex(
+    const std::uint8_t *source, std::size_t byteCount, char *target
+  ) {
+#if defined(NUCLEX_STORAGE_HAVE_SSE2) || defined(NUCLEX_STORAGE_HAVE_NEON)
+    for(; byteCount >= 16; byteCount -= 16) {
+      encodeHexBlock(source, target);
+      source += 16;
+      target += 32;
+    }
+#endif
+
+    for(; byteCount > 0; --byteCount) {
+      target[0] = HexAlphabet[*source >> 4];
+      target[1] = HexAlphabet[*source & 0x0F];
+      ++source;
+      target += 2;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Base64Decoder::Decode(
+    const char *text, std::size_t length, std::uint8_t *target, std::size_t capacity
+  ) {
+    std::size_t written = 0;
+    std::size_t index = 0;
+
+    for(;;) {
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+      // Blocks are only decoded at group boundaries. Each block writes 16 bytes
+      // (only 12 of which are kept), so leave the end of the buffer to the loop below
+      if((this->pendingCount == 0) && (this->paddingCount == 0)) {
+        while((length - index >= 16) && (capacity - written >= 16)) {
+          if(!tryDecodeBase64Block(text + index, target + written)) {
+            break;
+          }
+          index += 16;
+          written += 12;
+        }
+      }
+#endif
+      if(index >= length) {
+        break;
+      }
+
+      char character = text[index];
+      ++index;
+
+      if(isWhitespace(character)) {
+        continue;
+      }
+
+      // Padding completes the current group early. The bytes it contains can be
+      // written right away, any further padding characters only need to be counted.
+      if(character == '=') {
+        if(this->paddingCount == 0) {
+          if(this->pendingCount < 2) {
+            throw std::runtime_error(u8"Base-64 data contains misplaced padding");
+          }
+
+          requireCapacity(written, capacity, this->pendingCount - 1);
+          target[written] = (this->pending[0] << 2) | (this->pending[1] >> 4);
+          ++written;
+          if(this->pendingCount == 3) {
+            target[written] = ((this->pending[1] & 0x0F) << 4) | (this->pending[2] >> 2);
+            ++written;
+          }
+        }
+
+        ++this->paddingCount;
+        if(this->pendingCount + this->paddingCount > 4) {
+          throw std::runtime_error(u8"Base-64 data contains misplaced padding");
+        }
+
+        continue;
+      }
+
+      if(this->paddingCount > 0) {
+        throw std::runtime_error(u8"Base-64 data continues after its padding");
+      }
+
+      int value = getBase64Value(character);
+      if(value < 0) {
+        throw std::runtime_error(u8"Base-64 data contains an invalid character");
+      }
+
+      this->pending[this->pendingCount] = static_cast<std::uint8_t>(value);
+      ++this->pendingCount;
+
+      if(this->pendingCount == 4) {
+        requireCapacity(written, capacity, 3);
+        target[written] = (this->pending[0] << 2) | (this->pending[1] >> 4);
+        target[written + 1] = ((this->pending[1] & 0x0F) << 4) | (this->pending[2] >> 2);
+        target[written + 2] = ((this->pending[2] & 0x03) << 6) | this->pending[3];
+        written += 3;
+
+        this->pendingCount = 0;
+      }
+    }
+
+    return written;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t HexDecoder::Decode(
+    const char *text, std::size_t length, std::uint8_t *target, std::size_t capacity
+  ) {
+    std::size_t written = 0;
+    std::size_t index = 0;
+
+    for(;;) {
+#if defined(NUCLEX_STORAGE_HAVE_SSE2) || defined(NUCLEX_STORAGE_HAVE_NEON)
+      if(!this->hasPendingNibble) {
+        while((length - index >= 32) && (capacity - written >= 16)) {
+          if(!tryDecodeHexBlock(text + index, target + written)) {
+            break;
+          }
+          index += 32;
+          written += 16;
+        }
+      }
+#endif
+      if(index >= length) {
+        break;
+      }
+
+      char character = text[index];
+      ++index;
+
+      if(isWhitespace(character)) {
+        continue;
+      }
+
+      int value = getHexValue(character);
+      if(value < 0) {
+        throw std::runtime_error(u8"Hexadecimal data contains an invalid character");
+      }
+
+      if(this->hasPendingNibble) {
+        requireCapacity(written, capacity, 1);
+        target[written] = static_cast<std::uint8_t>((this->pendingNibble << 4) | value);
+        ++written;
+
+        this->hasPendingNibble = false;
+      } else {
+        this->pendingNibble = static_cast<std::uint8_t>(value);
+        this->hasPendingNibble = true;
+      }
+    }
+
+    return written;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
@@ -0,0 +1,167 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_HELPERS_BINARYENCODING_H
+#define NUCLEX_STORAGE_HELPERS_BINARYENCODING_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes binary data as base-64 or hexadecimal text</summary>
+  /// <remarks>
+  ///   The bulk of the data is encoded 16 bytes at a time with SIMD instructions where
+  ///   the compiler allows it (SSSE3 for base-64, SSE2 or NEON for hexadecimal).
+  ///   The results are identical to the plain C++ implementation on every platform.
+  /// </remarks>
+  class BinaryEncoder {
+
+    /// <summary>Calculates the number of characters base-64 encoded data will have</summary>
+    /// <param name="byteCount">Number of bytes that will be encoded</param>
+    /// <returns>The number of characters including padding</returns>
+    public: static std::size_t GetBase64Length(std::size_t byteCount) {
+      return (byteCount + 2) / 3 * 4;
+    }
+
+    /// <summary>Calculates the number of characters hex encoded data will have</summary>
+    /// <param name="byteCount">Number of bytes that will be encoded</param>
+    /// <returns>The number of characters</returns>
+    public: static std::size_t GetHexLength(std::size_t byteCount) {
+      return byteCount * 2;
+    }
+
+    /// <summary>Encodes binary data to base-64</summary>
+    /// <param name="source">Data that will be encoded</param>
+    /// <param name="byteCount">Number of bytes that will be encoded</param>
+    /// <param name="target">
+    ///   Receives the encoded characters, must have room for as many characters as
+    ///   <see cref="GetBase64Length" /> reports
+    /// </param>
+    public: static void EncodeBase64(
+      const std::uint8_t *source, std::size_t byteCount, char *target
+    );
+
+    /// <summary>Encodes binary data to upper case hexadecimal digits</summary>
+    /// <param name="source">Data that will be encoded</param>
+    /// <param name="byteCount">Number of bytes that will be encoded</param>
+    /// <param name="target">
+    ///   Receives the encoded characters, must have room for as many characters as
+    ///   <see cref="GetHexLength" /> reports
+    /// </param>
+    public: static void EncodeHex(
+      const std::uint8_t *source, std::size_t byteCount, char *target
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes base-64 text that may arrive in several pieces</summary>
+  /// <remarks>
+  ///   Whitespace is skipped, so text broken into indented lines can be decoded.
+  ///   Pieces may be split anywhere, the decoder remembers incomplete groups.
+  ///   Any other character outside of the base-64 alphabet results in an exception.
+  /// </remarks>
+  class Base64Decoder {
+
+    /// <summary>Initializes a new base-64 decoder</summary>
+    public: Base64Decoder() :
+      pendingCount(0),
+      paddingCount(0) {}
+
+    /// <summary>Decodes the next piece of base-64 text</summary>
+    /// <param name="text">Text that will be decoded</param>
+    /// <param name="length">Number of characters in the text</param>
+    /// <param name="target">Buffer that will receive the decoded bytes</param>
+    /// <param name="capacity">Number of bytes that fit into the buffer</param>
+    /// <returns>The number of bytes written into the buffer</returns>
+    /// <remarks>
+    ///   Throws an exception if the text decodes to more bytes than fit into the buffer.
+    /// </remarks>
+    public: std::size_t Decode(
+      const char *text, std::size_t length, std::uint8_t *target, std::size_t capacity
+    );
+
+    /// <summary>Checks whether the text decoded so far ended on a complete group</summary>
+    /// <returns>True if no characters are left over waiting for the rest of a group</returns>
+    public: bool IsComplete() const {
+      return ((this->pendingCount + this->paddingCount) % 4) == 0;
+    }
+
+    /// <summary>Values of the characters in the current group, six bits each</summary>
+    private: std::uint8_t pending[4];
+    /// <summary>Number of characters collected for the current group</summary>
+    private: std::size_t pendingCount;
+    /// <summary>Number of padding characters encountered at the end</summary>
+    private: std::size_t paddingCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes hexadecimal text that may arrive in several pieces</summary>
+  /// <remarks>
+  ///   Accepts upper and lower case digits. Whitespace is skipped and pieces may be
+  ///   split between the two digits of a byte. Any other character results in
+  ///   an exception.
+  /// </remarks>
+  class HexDecoder {
+
+    /// <summary>Initializes a new hexadecimal decoder</summary>
+    public: HexDecoder() :
+      pendingNibble(0),
+      hasPendingNibble(false) {}
+
+    /// <summary>Decodes the next piece of hexadecimal text</summary>
+    /// <param name="text">Text that will be decoded</param>
+    /// <param name="length">Number of characters in the text</param>
+    /// <param name="target">Buffer that will receive the decoded bytes</param>
+    /// <param name="capacity">Number of bytes that fit into the buffer</param>
+    /// <returns>The number of bytes written into the buffer</returns>
+    /// <remarks>
+    ///   Throws an exception if the text decodes to more bytes than fit into the buffer.
+    /// </remarks>
+    public: std::size_t Decode(
+      const char *text, std::size_t length, std::uint8_t *target, std::size_t capacity
+    );
+
+    /// <summary>Checks whether the text decoded so far ended on a complete byte</summary>
+    /// <returns>True if no digit is left over waiting for its partner</returns>
+    public: bool IsComplete() const {
+      return !this->hasPendingNibble;
+    }
+
+    /// <summary>Value of the first digit of an incomplete byte</summary>
+    private: std::uint8_t pendingNibble;
+    /// <summary>Whether the last piece ended between the two digits of a byte</summary>
+    private: bool hasPendingNibble;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
+
+#endif // NUCLEX_STORAGE_HELPERS_BINARYENCODING_H
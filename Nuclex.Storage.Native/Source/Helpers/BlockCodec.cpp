@@ -0,0 +1,134 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "BlockCodec.h"
+#include "Nuclex/Storage/Compression/Compressor.h"
+#include "Nuclex/Storage/Compression/Decompressor.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+
+#include <stdexcept> // for std::runtime_error
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCodec::Compress(
+    Compression::Compressor &compressor,
+    const std::uint8_t *block, std::size_t blockByteCount,
+    std::vector<std::uint8_t> &compressed
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.BlockCodec.Compress");
+    NUCLEX_SUPPORT_INSTRUMENT_SAMPLE(u8"Nuclex.Storage.BlockCodec.BlockSize", blockByteCount);
+
+    std::size_t compressedByteCount = 0;
+    compressed.resize(blockByteCount / 2 + 64);
+
+    for(;;) {
+      std::size_t inputByteCount = blockByteCount;
+      std::size_t outputByteCount = compressed.size() - compressedByteCount;
+      Compression::StopReason reason = compressor.Process(
+        block, inputByteCount, compressed.data() + compressedByteCount, outputByteCount
+      );
+      block += inputByteCount;
+      blockByteCount -= inputByteCount;
+      compressedByteCount += outputByteCount;
+      if(reason == Compression::StopReason::InputBufferExhausted) {
+        break;
+      }
+      compressed.resize(compressed.size() * 2);
+    }
+
+    for(;;) {
+      if(compressedByteCount == compressed.size()) {
+        compressed.resize(compressed.size() * 2);
+      }
+
+      std::size_t outputByteCount = compressed.size() - compressedByteCount;
+      Compression::StopReason reason = compressor.Finish(
+        compressed.data() + compressedByteCount, outputByteCount
+      );
+      compressedByteCount += outputByteCount;
+      if(reason == Compression::StopReason::Finished) {
+        break;
+      }
+    }
+
+    compressed.resize(compressedByteCount);
+    NUCLEX_SUPPORT_INSTRUMENT_COUNT(
+      u8"Nuclex.Storage.BlockCodec.CompressedBytesWritten", compressedByteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BlockCodec::Decompress(
+    Compression::Decompressor &decompressor,
+    const std::uint8_t *compressed, std::size_t compressedByteCount,
+    std::uint8_t *block, std::size_t blockByteCount
+  ) {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.BlockCodec.Decompress");
+    NUCLEX_SUPPORT_INSTRUMENT_COUNT(
+      u8"Nuclex.Storage.BlockCodec.DecompressedBytes", blockByteCount
+    );
+
+    for(;;) {
+      std::size_t inputByteCount = compressedByteCount;
+      std::size_t outputByteCount = blockByteCount;
+      Compression::StopReason reason = decompressor.Process(
+        compressed, inputByteCount, block, outputByteCount
+      );
+      compressed += inputByteCount;
+      compressedByteCount -= inputByteCount;
+      block += outputByteCount;
+      blockByteCount -= outputByteCount;
+
+      if(reason == Compression::StopReason::Finished) {
+        break;
+      }
+      if(reason == Compression::StopReason::InputBufferExhausted) {
+        throw std::runtime_error(u8"Compressed block is truncated");
+      }
+
+      // The output buffer is full. Some decompressors only notice the end of the stream
+      // on their next call, so give them a spare byte which they must not use.
+      if(blockByteCount == 0) {
+        std::uint8_t spare;
+        inputByteCount = compressedByteCount;
+        outputByteCount = 1;
+        reason = decompressor.Process(compressed, inputByteCount, &spare, outputByteCount);
+        if((reason != Compression::StopReason::Finished) || (outputByteCount != 0)) {
+          throw std::runtime_error(u8"Compressed block is longer than expected");
+        }
+        break;
+      }
+    }
+
+    if(blockByteCount != 0) {
+      throw std::runtime_error(u8"Compressed block is shorter than expected");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
@@ -0,0 +1,81 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_HELPERS_BLOCKCODEC_H
+#define NUCLEX_STORAGE_HELPERS_BLOCKCODEC_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Compressor;
+  class Decompressor;
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses and decompresses blocks of data that are held in memory</summary>
+  /// <remarks>
+  ///   Each block becomes a self-contained compressed stream, so blocks can be
+  ///   decompressed independently of each other and in any order.
+  /// </remarks>
+  class BlockCodec {
+
+    /// <summary>Compresses a block of data into a self-contained compressed stream</summary>
+    /// <param name="compressor">Compressor that will be used to compress the block</param>
+    /// <param name="block">Uncompressed data of the block</param>
+    /// <param name="blockByteCount">Number of bytes in the block</param>
+    /// <param name="compressed">Receives the compressed block</param>
+    public: static void Compress(
+      Compression::Compressor &compressor,
+      const std::uint8_t *block, std::size_t blockByteCount,
+      std::vector<std::uint8_t> &compressed
+    );
+
+    /// <summary>Decompresses a block and verifies that it has the expected length</summary>
+    /// <param name="decompressor">Decompressor that will be used to decompress the block</param>
+    /// <param name="compressed">Compressed data of the block</param>
+    /// <param name="compressedByteCount">Number of bytes in the compressed block</param>
+    /// <param name="block">Receives the uncompressed data of the block</param>
+    /// <param name="blockByteCount">Number of bytes the uncompressed block has</param>
+    public: static void Decompress(
+      Compression::Decompressor &decompressor,
+      const std::uint8_t *compressed, std::size_t compressedByteCount,
+      std::uint8_t *block, std::size_t blockByteCount
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
+
+#endif // NUCLEX_STORAGE_HELPERS_BLOCKCODEC_H
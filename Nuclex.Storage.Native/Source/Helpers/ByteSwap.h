@@ -0,0 +1,200 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_HELPERS_BYTESWAP_H
+#define NUCLEX_STORAGE_HELPERS_BYTESWAP_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+#include <cstring> // for std::memcpy()
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+#include <tmmintrin.h> // for SSSE3
+#elif defined(NUCLEX_STORAGE_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#elif defined(NUCLEX_STORAGE_HAVE_NEON)
+#include <arm_neon.h> // for NEON
+#endif
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reverses the byte order of whole arrays of integers</summary>
+  /// <remarks>
+  ///   Source and target may be the same array, which swaps the bytes in place. Neither
+  ///   needs to be aligned. The bulk of the array is processed 16 bytes at a time with
+  ///   byte shuffles (pshufb on x86 or vrev on ARM) where the compiler allows it.
+  /// </remarks>
+  class ByteSwap {
+
+    /// <summary>Reverses the byte order of 16 bit integers</summary>
+    /// <param name="source">Array of 16 bit integers that will be swapped</param>
+    /// <param name="target">Array that will receive the swapped integers</param>
+    /// <param name="count">Number of integers in the array</param>
+    public: static void Swap16(const void *source, void *target, std::size_t count) {
+      const std::uint8_t *sourceBytes = static_cast<const std::uint8_t *>(source);
+      std::uint8_t *targetBytes = static_cast<std::uint8_t *>(target);
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+      const __m128i shuffleMask = _mm_setr_epi8(
+        1, 0, 3, 2, 5, 4, 7, 6,
+        9, 8, 11, 10, 13, 12, 15, 14
+      );
+      for(; count >= 8; count -= 8) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourceBytes));
+        values = _mm_shuffle_epi8(values, shuffleMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(targetBytes), values);
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#elif defined(NUCLEX_STORAGE_HAVE_SSE2)
+      for(; count >= 8; count -= 8) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourceBytes));
+        values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(targetBytes), values);
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#elif defined(NUCLEX_STORAGE_HAVE_NEON)
+      for(; count >= 8; count -= 8) {
+        vst1q_u8(targetBytes, vrev16q_u8(vld1q_u8(sourceBytes)));
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#endif
+
+      for(; count > 0; --count) {
+        std::uint8_t first = sourceBytes[0];
+        targetBytes[0] = sourceBytes[1];
+        targetBytes[1] = first;
+        sourceBytes += 2;
+        targetBytes += 2;
+      }
+    }
+
+    /// <summary>Reverses the byte order of 32 bit integers</summary>
+    /// <param name="source">Array of 32 bit integers that will be swapped</param>
+    /// <param name="target">Array that will receive the swapped integers</param>
+    /// <param name="count">Number of integers in the array</param>
+    public: static void Swap32(const void *source, void *target, std::size_t count) {
+      const std::uint8_t *sourceBytes = static_cast<const std::uint8_t *>(source);
+      std::uint8_t *targetBytes = static_cast<std::uint8_t *>(target);
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+      const __m128i shuffleMask = _mm_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4,
+        11, 10, 9, 8, 15, 14, 13, 12
+      );
+      for(; count >= 4; count -= 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourceBytes));
+        values = _mm_shuffle_epi8(values, shuffleMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(targetBytes), values);
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#elif defined(NUCLEX_STORAGE_HAVE_SSE2)
+      for(; count >= 4; count -= 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourceBytes));
+        values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        values = _mm_shufflelo_epi16(values, _MM_SHUFFLE(2, 3, 0, 1));
+        values = _mm_shufflehi_epi16(values, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(targetBytes), values);
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#elif defined(NUCLEX_STORAGE_HAVE_NEON)
+      for(; count >= 4; count -= 4) {
+        vst1q_u8(targetBytes, vrev32q_u8(vld1q_u8(sourceBytes)));
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#endif
+
+      for(; count > 0; --count) {
+        std::uint8_t bytes[4];
+        std::memcpy(bytes, sourceBytes, 4);
+        targetBytes[0] = bytes[3];
+        targetBytes[1] = bytes[2];
+        targetBytes[2] = bytes[1];
+        targetBytes[3] = bytes[0];
+        sourceBytes += 4;
+        targetBytes += 4;
+      }
+    }
+
+    /// <summary>Reverses the byte order of 64 bit integers</summary>
+    /// <param name="source">Array of 64 bit integers that will be swapped</param>
+    /// <param name="target">Array that will receive the swapped integers</param>
+    /// <param name="count">Number of integers in the array</param>
+    public: static void Swap64(const void *source, void *target, std::size_t count) {
+      const std::uint8_t *sourceBytes = static_cast<const std::uint8_t *>(source);
+      std::uint8_t *targetBytes = static_cast<std::uint8_t *>(target);
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+      const __m128i shuffleMask = _mm_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0,
+        15, 14, 13, 12, 11, 10, 9, 8
+      );
+      for(; count >= 2; count -= 2) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourceBytes));
+        values = _mm_shuffle_epi8(values, shuffleMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(targetBytes), values);
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#elif defined(NUCLEX_STORAGE_HAVE_SSE2)
+      for(; count >= 2; count -= 2) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sourceBytes));
+        values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        values = _mm_shufflelo_epi16(values, _MM_SHUFFLE(0, 1, 2, 3));
+        values = _mm_shufflehi_epi16(values, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(targetBytes), values);
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#elif defined(NUCLEX_STORAGE_HAVE_NEON)
+      for(; count >= 2; count -= 2) {
+        vst1q_u8(targetBytes, vrev64q_u8(vld1q_u8(sourceBytes)));
+        sourceBytes += 16;
+        targetBytes += 16;
+      }
+#endif
+
+      for(; count > 0; --count) {
+        std::uint8_t bytes[8];
+        std::memcpy(bytes, sourceBytes, 8);
+        for(std::size_t index = 0; index < 8; ++index) {
+          targetBytes[index] = bytes[7 - index];
+        }
+        sourceBytes += 8;
+        targetBytes += 8;
+      }
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
+
+#endif // NUCLEX_STORAGE_HELPERS_BYTESWAP_H
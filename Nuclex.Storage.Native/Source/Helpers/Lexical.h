@@ -23,106 +23,68 @@ License along with this library
 
 #include "Nuclex/Storage/Config.h"
 
-#include <string>
-#include <sstream>
+#include <Nuclex/Support/Text/Lexical.h> // for lexical_parse(), lexical_cast()
+
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+#include <string> // for std::string
+#include <system_error> // for std::errc
 
 namespace Nuclex { namespace Storage { namespace Helpers {
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Lexically casts between a string and non-string data type</summary>
-  /// <typeparam name="TTarget">Type into which the value will be converted</typeparam>
-  /// <typeparam name="TSource">Type that will be converted</typeparam>
-  /// <param name="from">Value that will be converted</param>
-  /// <returns>The value converted to the specified type</returns>
-  template<typename TTarget, typename TSource>
-  inline TTarget lexical_cast(const TSource &from) {
-    std::stringstream stringStream;
-    stringStream << from;
-
-    TTarget to;
-    stringStream >> to;
-
-    if(stringStream.fail() || stringStream.bad()) {
-      std::string message("Could not convert from \"");
-      stringStream >> message;
-      message.append("\" (");
-      message.append(typeid(TSource).name());
-      message.append(") to (");
-      message.append(typeid(TTarget).name());
-      message.append(")");
-      throw std::invalid_argument(message.c_str());
-    }
-
-    return to;
+  /// <summary>Checks whether a character is a space, tab or line break</summary>
+  /// <param name="character">Character that will be checked</param>
+  /// <returns>True if the character is whitespace</returns>
+  inline bool IsWhitespace(char character) {
+    return (
+      (character == ' ') || (character == '\t') || (character == '\r') || (character == '\n')
+    );
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Converts a floating point value into a string</summary>
-  /// <param name="from">Floating point value that will be converted</param>
-  /// <returns>A string containing the printed floating point value</returns>
-  template<> std::string lexical_cast<>(const float &from);
-
-  // ------------------------------------------------------------------------------------------- //
-
-  /// <summary>Converts a string into a floating point value</summary>
-  /// <param name="from">String that will be converted</param>
-  /// <returns>The floating point value parsed from the specified string</returns>
-  template<> float lexical_cast<>(const std::string &from);
-
-  // ------------------------------------------------------------------------------------------- //
-
-  /// <summary>Converts a double precision floating point value into a string</summary>
-  /// <param name="from">Double precision Floating point value that will be converted</param>
-  /// <returns>A string containing the printed double precision floating point value</returns>
-  template<> std::string lexical_cast<>(const double &from);
-
-  // ------------------------------------------------------------------------------------------- //
-
-  /// <summary>Converts a string into a floating point value</summary>
-  /// <param name="from">String that will be converted</param>
-  /// <returns>The floating point value parsed from the specified string</returns>
-  template<> double lexical_cast<>(const std::string &from);
-
-  // ------------------------------------------------------------------------------------------- //
-
-#if defined(HAVE_ITOA)
-  /// <summary>Converts an integer value into a string</summary>
-  /// <param name="from">Integer value that will be converted</param>
-  /// <returns>A string containing the printed integer value</returns>
-  template<> std::string lexical_cast<>(const int &from);
-#endif
-
-  // ------------------------------------------------------------------------------------------- //
-
-  /// <summary>Converts a string into an integer value</summary>
-  /// <param name="from">String that will be converted</param>
-  /// <returns>The integer value parsed from the specified string</returns>
-  template<> int lexical_cast<>(const std::string &from);
-
-  // ------------------------------------------------------------------------------------------- //
-
-#if defined(HAVE_ULTOA)
-  /// <summary>Converts an unsigned long value into a string</summary>
-  /// <param name="from">Unsigned long value that will be converted</param>
-  /// <returns>A string containing the printed unsigned long value</returns>
-  template<> std::string lexical_cast<>(const unsigned long &from);
-#endif
+  /// <summary>Parses a number stored as text in a serialized file</summary>
+  /// <typeparam name="TTarget">Type of number that will be parsed</typeparam>
+  /// <param name="from">String containing the number</param>
+  /// <returns>The number parsed from the specified string</returns>
+  /// <remarks>
+  ///   Parses through the lexical_parse() functions of Nuclex.Support, so it ignores
+  ///   the system locale. Unlike lexical_cast() from Nuclex.Support, which quietly
+  ///   returns zero, this throws an exception if the string doesn't contain a number
+  ///   (surrounding whitespace is allowed) or the number doesn't fit into the target type.
+  /// </remarks>
+  template<typename TTarget>
+  inline TTarget lexical_cast(const std::string &from) {
+    const char *first = from.data();
+    const char *last = first + from.length();
+    while((first < last) && IsWhitespace(*first)) {
+      ++first;
+    }
+    while((last > first) && IsWhitespace(*(last - 1))) {
+      --last;
+    }
 
-  // ------------------------------------------------------------------------------------------- //
+    TTarget to;
+    Support::Text::lexical_parse_result result = Support::Text::lexical_parse(first, last, to);
+    if(result.ec == std::errc::result_out_of_range) {
+      throw std::out_of_range(u8"Number is too large or too small for its data type");
+    } else if((result.ec != std::errc()) || (result.ptr != last)) {
+      throw std::invalid_argument(std::string(u8"Could not parse number from \"") + from + "\"");
+    }
 
-  /// <summary>Converts a boolean value into a string</summary>
-  /// <param name="from">Boolean value that will be converted</param>
-  /// <returns>A string containing the printed boolean value</returns>
-  template<> std::string lexical_cast<>(const bool &from);
+    return to;
+  }
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Converts a string into a boolean value</summary>
-  /// <param name="from">String that will be converted</param>
-  /// <returns>The boolean value parsed from the specified string</returns>
-  template<> bool lexical_cast<>(const std::string &from);
+  /// <summary>Interprets a string as a boolean value</summary>
+  /// <param name="from">String that will be interpreted</param>
+  /// <returns>True if the string contains 'true', ignoring case, false otherwise</returns>
+  template<>
+  inline bool lexical_cast<bool>(const std::string &from) {
+    return Support::Text::lexical_cast<bool>(from);
+  }
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -0,0 +1,209 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Sha256.h"
+
+#include <cstring> // for std::memcpy()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Round constants, the first 32 bits of the cube roots of the first primes</summary>
+  const std::uint32_t RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rotates the bits of a 32 bit integer to the right</summary>
+  /// <param name="value">Value whose bits will be rotated</param>
+  /// <param name="bitCount">Number of bits to rotate by</param>
+  /// <returns>The rotated value</returns>
+  inline std::uint32_t rotateRight(std::uint32_t value, int bitCount) {
+    return (value >> bitCount) | (value << (32 - bitCount));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Sha256::Sha256() :
+    bufferedByteCount(0),
+    totalByteCount(0) {
+    this->state[0] = 0x6a09e667;
+    this->state[1] = 0xbb67ae85;
+    this->state[2] = 0x3c6ef372;
+    this->state[3] = 0xa54ff53a;
+    this->state[4] = 0x510e527f;
+    this->state[5] = 0x9b05688c;
+    this->state[6] = 0x1f83d9ab;
+    this->state[7] = 0x5be0cd19;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Sha256::Update(const void *data, std::size_t byteCount) {
+    const std::uint8_t *bytes = static_cast<const std::uint8_t *>(data);
+    this->totalByteCount += byteCount;
+
+    // Complete a block that was started by an earlier call
+    if(this->bufferedByteCount > 0) {
+      std::size_t missingByteCount = sizeof(this->buffer) - this->bufferedByteCount;
+      if(byteCount < missingByteCount) {
+        std::memcpy(this->buffer + this->bufferedByteCount, bytes, byteCount);
+        this->bufferedByteCount += byteCount;
+        return;
+      }
+
+      std::memcpy(this->buffer + this->bufferedByteCount, bytes, missingByteCount);
+      processBlock(this->buffer);
+      bytes += missingByteCount;
+      byteCount -= missingByteCount;
+      this->bufferedByteCount = 0;
+    }
+
+    // Process full blocks directly from the caller's buffer
+    while(byteCount >= sizeof(this->buffer)) {
+      processBlock(bytes);
+      bytes += sizeof(this->buffer);
+      byteCount -= sizeof(this->buffer);
+    }
+
+    if(byteCount > 0) {
+      std::memcpy(this->buffer, bytes, byteCount);
+      this->bufferedByteCount = byteCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::array<std::uint8_t, Sha256::HashByteCount> Sha256::Finish() {
+    std::uint64_t bitCount = this->totalByteCount * 8;
+
+    // Append the terminating 1 bit, then pad until only the length fits into the block
+    this->buffer[this->bufferedByteCount++] = 0x80;
+    if(this->bufferedByteCount > sizeof(this->buffer) - 8) {
+      std::memset(
+        this->buffer + this->bufferedByteCount, 0, sizeof(this->buffer) - this->bufferedByteCount
+      );
+      processBlock(this->buffer);
+      this->bufferedByteCount = 0;
+    }
+    std::memset(
+      this->buffer + this->bufferedByteCount, 0,
+      sizeof(this->buffer) - 8 - this->bufferedByteCount
+    );
+    for(std::size_t index = 0; index < 8; ++index) {
+      this->buffer[63 - index] = static_cast<std::uint8_t>(bitCount >> (index * 8));
+    }
+    processBlock(this->buffer);
+
+    std::array<std::uint8_t, HashByteCount> hash;
+    for(std::size_t index = 0; index < 8; ++index) {
+      hash[index * 4 + 0] = static_cast<std::uint8_t>(this->state[index] >> 24);
+      hash[index * 4 + 1] = static_cast<std::uint8_t>(this->state[index] >> 16);
+      hash[index * 4 + 2] = static_cast<std::uint8_t>(this->state[index] >> 8);
+      hash[index * 4 + 3] = static_cast<std::uint8_t>(this->state[index]);
+    }
+
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Sha256::processBlock(const std::uint8_t *block) {
+    std::uint32_t words[64];
+    for(std::size_t index = 0; index < 16; ++index) {
+      words[index] = (
+        (static_cast<std::uint32_t>(block[index * 4 + 0]) << 24) |
+        (static_cast<std::uint32_t>(block[index * 4 + 1]) << 16) |
+        (static_cast<std::uint32_t>(block[index * 4 + 2]) << 8) |
+        static_cast<std::uint32_t>(block[index * 4 + 3])
+      );
+    }
+    for(std::size_t index = 16; index < 64; ++index) {
+      std::uint32_t s0 = (
+        rotateRight(words[index - 15], 7) ^
+        rotateRight(words[index - 15], 18) ^
+        (words[index - 15] >> 3)
+      );
+      std::uint32_t s1 = (
+        rotateRight(words[index - 2], 17) ^
+        rotateRight(words[index - 2], 19) ^
+        (words[index - 2] >> 10)
+      );
+      words[index] = words[index - 16] + s0 + words[index - 7] + s1;
+    }
+
+    std::uint32_t a = this->state[0];
+    std::uint32_t b = this->state[1];
+    std::uint32_t c = this->state[2];
+    std::uint32_t d = this->state[3];
+    std::uint32_t e = this->state[4];
+    std::uint32_t f = this->state[5];
+    std::uint32_t g = this->state[6];
+    std::uint32_t h = this->state[7];
+
+    for(std::size_t index = 0; index < 64; ++index) {
+      std::uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+      std::uint32_t choice = (e & f) ^ (~e & g);
+      std::uint32_t temp1 = h + s1 + choice + RoundConstants[index] + words[index];
+      std::uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+      std::uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+      std::uint32_t temp2 = s0 + majority;
+
+      h = g;
+      g = f;
+      f = e;
+      e = d + temp1;
+      d = c;
+      c = b;
+      b = a;
+      a = temp1 + temp2;
+    }
+
+    this->state[0] += a;
+    this->state[1] += b;
+    this->state[2] += c;
+    this->state[3] += d;
+    this->state[4] += e;
+    this->state[5] += f;
+    this->state[6] += g;
+    this->state[7] += h;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
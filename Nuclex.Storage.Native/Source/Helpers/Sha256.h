@@ -0,0 +1,91 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_HELPERS_SHA256_H
+#define NUCLEX_STORAGE_HELPERS_SHA256_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <array> // for std::array
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates SHA-256 hashes of data that may arrive in several pieces</summary>
+  /// <remarks>
+  ///   Used where two pieces of data need to be told apart by their hash alone,
+  ///   for example to find identical chunks without comparing their contents.
+  /// </remarks>
+  class Sha256 {
+
+    /// <summary>Number of bytes in a SHA-256 hash</summary>
+    public: static const std::size_t HashByteCount = 32;
+
+    /// <summary>Calculates the SHA-256 hash of a buffer</summary>
+    /// <param name="data">Data whose hash will be calculated</param>
+    /// <param name="byteCount">Number of bytes in the buffer</param>
+    /// <returns>The SHA-256 hash of the data</returns>
+    public: static std::array<std::uint8_t, HashByteCount> Hash(
+      const void *data, std::size_t byteCount
+    ) {
+      Sha256 sha256;
+      sha256.Update(data, byteCount);
+      return sha256.Finish();
+    }
+
+    /// <summary>Initializes a new SHA-256 hash calculation</summary>
+    public: Sha256();
+
+    /// <summary>Adds the next piece of data to the hash</summary>
+    /// <param name="data">Data that will be added to the hash</param>
+    /// <param name="byteCount">Number of bytes that will be added</param>
+    public: void Update(const void *data, std::size_t byteCount);
+
+    /// <summary>Completes the hash calculation</summary>
+    /// <returns>The SHA-256 hash of all data that has been added</returns>
+    /// <remarks>
+    ///   No more data can be added afterwards. Create a new instance to calculate
+    ///   another hash.
+    /// </remarks>
+    public: std::array<std::uint8_t, HashByteCount> Finish();
+
+    /// <summary>Mixes a 64 byte block of data into the hash state</summary>
+    /// <param name="block">Block that will be mixed into the hash state</param>
+    private: void processBlock(const std::uint8_t *block);
+
+    /// <summary>Current hash state</summary>
+    private: std::uint32_t state[8];
+    /// <summary>Collects data until a full block is available</summary>
+    private: std::uint8_t buffer[64];
+    /// <summary>Number of bytes currently waiting in the buffer</summary>
+    private: std::size_t bufferedByteCount;
+    /// <summary>Total number of bytes that have been added</summary>
+    private: std::uint64_t totalByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
+
+#endif // NUCLEX_STORAGE_HELPERS_SHA256_H
@@ -0,0 +1,264 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "VarintEncoding.h"
+
+#include <stdexcept> // for std::runtime_error
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+#include <tmmintrin.h> // for SSSE3
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lookup tables indexed by the control bytes of stream-vbyte arrays</summary>
+  struct ControlTables {
+
+    /// <summary>Builds the lookup tables for all 256 possible control bytes</summary>
+    public: ControlTables() {
+      for(std::size_t control = 0; control < 256; ++control) {
+        std::uint8_t offset = 0;
+        for(std::size_t lane = 0; lane < 4; ++lane) {
+          std::uint8_t length = static_cast<std::uint8_t>(((control >> (lane * 2)) & 3) + 1);
+          for(std::size_t index = 0; index < 4; ++index) {
+            if(index < length) {
+              this->Shuffles[control][lane * 4 + index] = static_cast<std::uint8_t>(
+                offset + index
+              );
+            } else {
+              this->Shuffles[control][lane * 4 + index] = 0x80; // shuffle in a zero
+            }
+          }
+          offset += length;
+        }
+        this->Lengths[control] = offset;
+      }
+    }
+
+    /// <summary>Byte shuffles that move the values of a group into 32 bit lanes</summary>
+    public: alignas(16) std::uint8_t Shuffles[256][16];
+    /// <summary>Total number of bytes occupied by the four values of a group</summary>
+    public: std::uint8_t Lengths[256];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides the lookup tables for stream-vbyte control bytes</summary>
+  /// <returns>The lookup tables, built on first use</returns>
+  const ControlTables &getControlTables() {
+    static const ControlTables tables;
+    return tables;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the length code of a value in a stream-vbyte array</summary>
+  /// <param name="control">Control bytes at the beginning of the array</param>
+  /// <param name="index">Index of the value whose length code will be looked up</param>
+  /// <returns>The number of bytes the value occupies minus one</returns>
+  std::size_t getLengthCode(const std::uint8_t *control, std::size_t index) {
+    return (control[index / 4] >> ((index % 4) * 2)) & 3;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes values of a stream-vbyte array one by one</summary>
+  /// <param name="control">Control bytes at the beginning of the array</param>
+  /// <param name="data">Bytes of the first value that will be decoded</param>
+  /// <param name="startIndex">Index of the first value that will be decoded</param>
+  /// <param name="count">Total number of values in the array</param>
+  /// <param name="target">Receives the decoded values</param>
+  /// <param name="previous">Last decoded value if the values are delta-encoded</param>
+  /// <param name="isDeltaEncoded">Whether the values were stored as differences</param>
+  /// <returns>The address behind the bytes of the last decoded value</returns>
+  const std::uint8_t *decodeOneByOne(
+    const std::uint8_t *control, const std::uint8_t *data,
+    std::size_t startIndex, std::size_t count, std::uint32_t *target,
+    std::uint32_t previous, bool isDeltaEncoded
+  ) {
+    for(std::size_t index = startIndex; index < count; ++index) {
+      std::size_t length = getLengthCode(control, index) + 1;
+
+      std::uint32_t value = 0;
+      for(std::size_t byteIndex = 0; byteIndex < length; ++byteIndex) {
+        value |= static_cast<std::uint32_t>(data[byteIndex]) << (byteIndex * 8);
+      }
+      data += length;
+
+      if(isDeltaEncoded) {
+        previous += value;
+        target[index] = previous;
+      } else {
+        target[index] = value;
+      }
+    }
+
+    return data;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VarintEncoder::DecodeVarint(
+    const std::uint8_t *source, std::size_t byteCount, std::uint64_t &value
+  ) {
+    std::uint64_t result = 0;
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      if(index >= MaximumVarintByteCount) {
+        throw std::runtime_error(u8"Varint is longer than any 64 bit integer");
+      }
+
+      std::uint8_t current = source[index];
+      result |= static_cast<std::uint64_t>(current & 0x7F) << (index * 7);
+      if((current & 0x80) == 0) {
+        value = result;
+        return index + 1;
+      }
+    }
+
+    return 0; // Buffer ended in the middle of the varint
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VarintEncoder::GetStreamVByteDataLength(
+    const std::uint8_t *control, std::size_t count
+  ) {
+    const ControlTables &tables = getControlTables();
+
+    std::size_t groupCount = count / 4;
+    std::size_t byteCount = 0;
+    for(std::size_t groupIndex = 0; groupIndex < groupCount; ++groupIndex) {
+      byteCount += tables.Lengths[control[groupIndex]];
+    }
+    for(std::size_t index = groupCount * 4; index < count; ++index) {
+      byteCount += getLengthCode(control, index) + 1;
+    }
+
+    return byteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VarintEncoder::EncodeStreamVByte(
+    const std::uint32_t *values, std::size_t count, std::uint8_t *target,
+    bool isDeltaEncoded
+  ) {
+    std::uint8_t *control = target;
+    std::uint8_t *data = target + GetStreamVByteControlLength(count);
+
+    std::uint32_t previous = 0;
+    for(std::size_t index = 0; index < count; ++index) {
+      std::uint32_t value = values[index];
+      if(isDeltaEncoded) {
+        std::uint32_t delta = value - previous;
+        previous = value;
+        value = delta;
+      }
+
+      std::size_t lengthCode;
+      if(value < (1U << 8)) {
+        lengthCode = 0;
+      } else if(value < (1U << 16)) {
+        lengthCode = 1;
+      } else if(value < (1U << 24)) {
+        lengthCode = 2;
+      } else {
+        lengthCode = 3;
+      }
+
+      if((index % 4) == 0) {
+        control[index / 4] = 0;
+      }
+      control[index / 4] |= static_cast<std::uint8_t>(lengthCode << ((index % 4) * 2));
+
+      for(std::size_t byteIndex = 0; byteIndex <= lengthCode; ++byteIndex) {
+        data[byteIndex] = static_cast<std::uint8_t>(value >> (byteIndex * 8));
+      }
+      data += lengthCode + 1;
+    }
+
+    return static_cast<std::size_t>(data - target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t VarintEncoder::DecodeStreamVByte(
+    const std::uint8_t *source, std::size_t count, std::uint32_t *target,
+    bool isDeltaEncoded
+  ) {
+    const std::uint8_t *control = source;
+    const std::uint8_t *data = source + GetStreamVByteControlLength(count);
+
+    std::size_t index = 0;
+    std::uint32_t previous = 0;
+
+#if defined(NUCLEX_STORAGE_HAVE_SSSE3)
+    {
+      const ControlTables &tables = getControlTables();
+
+      // Each control byte describes a group of four values. One shuffle moves their
+      // bytes into place and fills the bytes left out during encoding with zeros.
+      std::size_t groupCount = count / 4;
+      __m128i running = _mm_setzero_si128();
+      for(std::size_t groupIndex = 0; groupIndex < groupCount; ++groupIndex) {
+        std::uint8_t groupControl = control[groupIndex];
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+        __m128i shuffle = _mm_load_si128(
+          reinterpret_cast<const __m128i *>(tables.Shuffles[groupControl])
+        );
+        __m128i values = _mm_shuffle_epi8(bytes, shuffle);
+
+        if(isDeltaEncoded) {
+          values = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+          values = _mm_add_epi32(values, _mm_slli_si128(values, 8));
+          values = _mm_add_epi32(values, running);
+          running = _mm_shuffle_epi32(values, 0xFF); // Last value in all lanes
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target + groupIndex * 4), values);
+        data += tables.Lengths[groupControl];
+      }
+
+      index = groupCount * 4;
+      if(isDeltaEncoded && (index > 0)) {
+        previous = target[index - 1];
+      }
+    }
+#endif
+
+    data = decodeOneByOne(control, data, index, count, target, previous, isDeltaEncoded);
+    return static_cast<std::size_t>(data - source);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
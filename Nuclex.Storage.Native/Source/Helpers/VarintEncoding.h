@@ -0,0 +1,187 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_HELPERS_VARINTENCODING_H
+#define NUCLEX_STORAGE_HELPERS_VARINTENCODING_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes integers with a variable number of bytes</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Single values are stored as LEB128 varints: seven bits per byte, lowest bits
+  ///     first, with the top bit of each byte set if another byte follows. Signed values
+  ///     are zigzag-encoded first so that small negative numbers stay short, too.
+  ///   </para>
+  ///   <para>
+  ///     Arrays of 32 bit integers use the stream-vbyte layout instead: a block of control
+  ///     bytes holding the length of four values each (2 bits per value), followed by
+  ///     the values' bytes in little endian order with leading zero bytes left out.
+  ///     Because the lengths are known up front, four values at a time can be decoded with
+  ///     a single SSSE3 shuffle where the compiler allows it. The results are identical
+  ///     to the plain C++ implementation on every platform.
+  ///   </para>
+  /// </remarks>
+  class VarintEncoder {
+
+    /// <summary>Maximum number of bytes a 64 bit varint can occupy</summary>
+    public: static const std::size_t MaximumVarintByteCount = 10;
+
+    /// <summary>
+    ///   Number of bytes behind the encoded data the stream-vbyte decoder may read from
+    /// </summary>
+    /// <remarks>
+    ///   The SIMD decoder always loads 16 bytes at once even if the last values are
+    ///   shorter, so the buffer holding the encoded data has to extend this far beyond
+    ///   its end. The contents of these bytes do not matter.
+    /// </remarks>
+    public: static const std::size_t StreamVBytePaddingByteCount = 16;
+
+    /// <summary>Maps a signed integer to an unsigned one, keeping small values small</summary>
+    /// <param name="value">Signed integer that will be mapped</param>
+    /// <returns>0 for 0, 1 for -1, 2 for 1, 3 for -2 and so on</returns>
+    public: static std::uint64_t ZigZagEncode(std::int64_t value) {
+      std::uint64_t bits = static_cast<std::uint64_t>(value);
+      return (bits << 1) ^ (std::uint64_t(0) - (bits >> 63));
+    }
+
+    /// <summary>Maps a zigzag-encoded integer back to the signed integer</summary>
+    /// <param name="value">Zigzag-encoded integer that will be mapped back</param>
+    /// <returns>The signed integer the zigzag-encoded integer stands for</returns>
+    public: static std::int64_t ZigZagDecode(std::uint64_t value) {
+      return static_cast<std::int64_t>((value >> 1) ^ (std::uint64_t(0) - (value & 1)));
+    }
+
+    /// <summary>Maps a signed integer to an unsigned one, keeping small values small</summary>
+    /// <param name="value">Signed integer that will be mapped</param>
+    /// <returns>0 for 0, 1 for -1, 2 for 1, 3 for -2 and so on</returns>
+    public: static std::uint32_t ZigZagEncode(std::int32_t value) {
+      std::uint32_t bits = static_cast<std::uint32_t>(value);
+      return (bits << 1) ^ (std::uint32_t(0) - (bits >> 31));
+    }
+
+    /// <summary>Maps a zigzag-encoded integer back to the signed integer</summary>
+    /// <param name="value">Zigzag-encoded integer that will be mapped back</param>
+    /// <returns>The signed integer the zigzag-encoded integer stands for</returns>
+    public: static std::int32_t ZigZagDecode(std::uint32_t value) {
+      return static_cast<std::int32_t>((value >> 1) ^ (std::uint32_t(0) - (value & 1)));
+    }
+
+    /// <summary>Encodes an integer as LEB128 varint</summary>
+    /// <param name="value">Integer that will be encoded</param>
+    /// <param name="target">
+    ///   Receives the encoded bytes, must have room for
+    ///   <see cref="MaximumVarintByteCount" /> bytes
+    /// </param>
+    /// <returns>The number of bytes written into the target buffer</returns>
+    public: static std::size_t EncodeVarint(std::uint64_t value, std::uint8_t *target) {
+      std::size_t byteCount = 0;
+      while(value >= 0x80) {
+        target[byteCount] = static_cast<std::uint8_t>(value | 0x80);
+        value >>= 7;
+        ++byteCount;
+      }
+      target[byteCount] = static_cast<std::uint8_t>(value);
+      return byteCount + 1;
+    }
+
+    /// <summary>Decodes an LEB128 varint</summary>
+    /// <param name="source">Buffer holding the encoded bytes</param>
+    /// <param name="byteCount">Number of bytes available in the buffer</param>
+    /// <param name="value">Receives the decoded integer</param>
+    /// <returns>
+    ///   The number of bytes the varint occupied or 0 if the buffer ended before
+    ///   the varint was complete
+    /// </returns>
+    /// <remarks>
+    ///   Throws an exception if the varint is longer than
+    ///   <see cref="MaximumVarintByteCount" /> bytes.
+    /// </remarks>
+    public: static std::size_t DecodeVarint(
+      const std::uint8_t *source, std::size_t byteCount, std::uint64_t &value
+    );
+
+    /// <summary>Calculates the number of control bytes for a stream-vbyte array</summary>
+    /// <param name="count">Number of values in the array</param>
+    /// <returns>The number of control bytes that precede the values</returns>
+    public: static std::size_t GetStreamVByteControlLength(std::size_t count) {
+      return (count + 3) / 4;
+    }
+
+    /// <summary>Calculates the number of bytes a stream-vbyte array can occupy</summary>
+    /// <param name="count">Number of values in the array</param>
+    /// <returns>The number of bytes the array occupies at most</returns>
+    public: static std::size_t GetStreamVByteMaximumLength(std::size_t count) {
+      return GetStreamVByteControlLength(count) + count * sizeof(std::uint32_t);
+    }
+
+    /// <summary>Sums up the value bytes described by the control bytes of an array</summary>
+    /// <param name="control">Control bytes at the beginning of the stream-vbyte array</param>
+    /// <param name="count">Number of values in the array</param>
+    /// <returns>The number of bytes following the control bytes</returns>
+    public: static std::size_t GetStreamVByteDataLength(
+      const std::uint8_t *control, std::size_t count
+    );
+
+    /// <summary>Encodes an array of integers in the stream-vbyte layout</summary>
+    /// <param name="values">Values that will be encoded</param>
+    /// <param name="count">Number of values that will be encoded</param>
+    /// <param name="target">
+    ///   Receives the encoded bytes, must have room for as many bytes as
+    ///   <see cref="GetStreamVByteMaximumLength" /> reports
+    /// </param>
+    /// <param name="isDeltaEncoded">
+    ///   Whether to store the difference to the previous value rather than the value
+    ///   itself, which makes sorted values such as ids much shorter
+    /// </param>
+    /// <returns>The number of bytes written into the target buffer</returns>
+    public: static std::size_t EncodeStreamVByte(
+      const std::uint32_t *values, std::size_t count, std::uint8_t *target,
+      bool isDeltaEncoded
+    );
+
+    /// <summary>Decodes an array of integers stored in the stream-vbyte layout</summary>
+    /// <param name="source">
+    ///   Encoded bytes, followed by <see cref="StreamVBytePaddingByteCount" /> more
+    ///   bytes that may be read but are ignored
+    /// </param>
+    /// <param name="count">Number of values that will be decoded</param>
+    /// <param name="target">Receives the decoded values</param>
+    /// <param name="isDeltaEncoded">Whether the values were stored as differences</param>
+    /// <returns>The number of encoded bytes that have been consumed</returns>
+    public: static std::size_t DecodeStreamVByte(
+      const std::uint8_t *source, std::size_t count, std::uint32_t *target,
+      bool isDeltaEncoded
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
+
+#endif // NUCLEX_STORAGE_HELPERS_VARINTENCODING_H
@@ -0,0 +1,101 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_HELPERS_WORKERTHREADS_H
+#define NUCLEX_STORAGE_HELPERS_WORKERTHREADS_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include "Nuclex/Support/Threading/TaskGroup.h" // for TaskGroup, ThreadPool
+
+#include <cstddef> // for std::size_t
+#include <functional> // for std::function
+#include <thread> // for std::thread
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs jobs that are split into independent pieces on several threads</summary>
+  class WorkerThreads {
+
+    /// <summary>Determines the number of threads that will be used for a job</summary>
+    /// <param name="threadCount">Number of threads requested by the caller, may be zero</param>
+    /// <param name="pieceCount">Number of pieces that need to be processed</param>
+    /// <returns>The number of threads that should be used</returns>
+    public: static std::size_t ChooseThreadCount(std::size_t threadCount, std::size_t pieceCount) {
+      if(threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if(threadCount == 0) {
+          threadCount = 1;
+        }
+      }
+      if(threadCount > pieceCount) {
+        threadCount = (pieceCount == 0) ? 1 : pieceCount;
+      }
+
+      return threadCount;
+    }
+
+    /// <summary>Runs a worker on several threads, including the calling thread</summary>
+    /// <param name="threadCount">Number of threads the worker will run on</param>
+    /// <param name="worker">Worker that will be run on each thread</param>
+    /// <remarks>
+    ///   <para>
+    ///     Waits until all threads have finished. The worker must catch its own exceptions
+    ///     because exceptions are not reported back to the caller.
+    ///   </para>
+    ///   <para>
+    ///     The workers run on a thread pool shared by the whole library, so jobs don't
+    ///     pay for creating and destroying threads each time. If more workers are requested
+    ///     than the pool has threads, the surplus workers start once others return, which
+    ///     is harmless because all workers take their pieces from the same job.
+    ///   </para>
+    /// </remarks>
+    public: static void Run(std::size_t threadCount, const std::function<void()> &worker) {
+      if(threadCount <= 1) {
+        worker();
+        return;
+      }
+
+      Support::Threading::TaskGroup group(getSharedThreadPool());
+      for(std::size_t index = 1; index < threadCount; ++index) {
+        group.Run([&worker]() { worker(); });
+      }
+
+      worker();
+
+      group.Wait();
+    }
+
+    /// <summary>Returns the thread pool shared by all jobs of the library</summary>
+    /// <returns>The shared thread pool, which is created on first use</returns>
+    private: static Support::Threading::ThreadPool &getSharedThreadPool() {
+      static Support::Threading::ThreadPool sharedThreadPool;
+      return sharedThreadPool;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
+
+#endif // NUCLEX_STORAGE_HELPERS_WORKERTHREADS_H
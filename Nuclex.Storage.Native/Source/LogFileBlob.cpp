@@ -0,0 +1,462 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/LogFileBlob.h"
+#include "Nuclex/Storage/FileBlob.h"
+
+#include <algorithm> // for std::min()
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstring> // for std::memcpy()
+#include <exception> // for std::exception_ptr
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::invalid_argument, std::out_of_range, std::runtime_error
+#include <thread> // for std::thread
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Buffers, file and background thread of the blob</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The log is cut into ranges the size of a buffer and each range is collected in
+  ///     the buffer its index maps to, so the buffers form a ring. An appending thread
+  ///     reserves its range by adding to <see cref="ReservedEnd" />, copies its data and
+  ///     then adds the number of bytes it copied to the buffer's filled byte count.
+  ///   </para>
+  ///   <para>
+  ///     The background thread knows that all data up to the reserved end has been
+  ///     copied when the filled byte count, read before the reserved end, covers
+  ///     the buffer up to the reserved end. Every byte counted as filled belongs to
+  ///     a reservation, so if the counts match, no reservation can still be copying.
+  ///     A full buffer always matches, so steady appends can't keep data from being
+  ///     written for longer than it takes to fill a buffer.
+  ///   </para>
+  ///   <para>
+  ///     A buffer can only be reused for the next range that maps to it once the range
+  ///     it held has been written to the file. Appending threads only wait when all
+  ///     buffers are full, which means the disk can't keep up.
+  ///   </para>
+  /// </remarks>
+  struct LogFileBlob::Impl {
+
+    /// <summary>Opens the file and starts the background thread</summary>
+    /// <param name="path">Path of the file that will be appended to</param>
+    /// <param name="bufferByteCount">Size of each of the shared buffers</param>
+    /// <param name="bufferCount">Number of shared buffers</param>
+    /// <param name="flushInterval">Time after which data is flushed without request</param>
+    public: Impl(
+      const std::string &path,
+      std::size_t bufferByteCount, std::size_t bufferCount,
+      std::chrono::milliseconds flushInterval
+    ) :
+      File(new FileBlob(path, true)),
+      BufferByteCount(bufferByteCount),
+      BufferCount(bufferCount),
+      FlushInterval(flushInterval),
+      Buffers(new std::uint8_t[bufferByteCount * bufferCount]),
+      FilledByteCounts(new std::atomic<std::size_t>[bufferCount]),
+      ReservedEnd(0),
+      WrittenEnd(0),
+      DurableEnd(0),
+      HasFailed(false),
+      RequestedWrittenEnd(0),
+      RequestedDurableEnd(0),
+      IsStopping(false) {
+      std::uint64_t fileByteCount = this->File->GetSize();
+      for(std::size_t index = 0; index < bufferCount; ++index) {
+        this->FilledByteCounts[index].store(0, std::memory_order_relaxed);
+      }
+
+      // The part of the first buffer before the end of the existing file counts
+      // as filled so the background thread's accounting works out
+      this->FilledByteCounts[getBufferIndex(fileByteCount)].store(
+        static_cast<std::size_t>(fileByteCount % bufferByteCount), std::memory_order_relaxed
+      );
+      this->ReservedEnd.store(fileByteCount, std::memory_order_relaxed);
+      this->WrittenEnd.store(fileByteCount, std::memory_order_relaxed);
+      this->DurableEnd.store(fileByteCount, std::memory_order_relaxed);
+
+      this->Flusher = std::thread(&Impl::runFlusher, this);
+    }
+
+    /// <summary>Writes any remaining data and stops the background thread</summary>
+    public: ~Impl() {
+      {
+        std::lock_guard<std::mutex> stateScope(this->Mutex);
+        this->IsStopping = true;
+      }
+      this->FlushRequested.notify_one();
+      this->Flusher.join();
+    }
+
+    /// <summary>Copies data into the buffers covering a reserved range</summary>
+    /// <param name="location">Position in the log at which the range begins</param>
+    /// <param name="data">Data that will be copied into the buffers</param>
+    /// <param name="count">Number of bytes that will be copied</param>
+    public: void CopyIntoBuffers(
+      std::uint64_t location, const std::uint8_t *data, std::size_t count
+    ) {
+      while(count > 0) {
+        std::size_t offset = static_cast<std::size_t>(location % this->BufferByteCount);
+        std::size_t byteCount = std::min(count, this->BufferByteCount - offset);
+
+        // The buffer is free once the range it held before has been written
+        std::uint64_t bufferStart = location - offset;
+        std::uint64_t reusableFrom = bufferStart + this->BufferByteCount;
+        std::uint64_t ringByteCount = static_cast<std::uint64_t>(
+          this->BufferByteCount
+        ) * this->BufferCount;
+        if(reusableFrom > ringByteCount) {
+          WaitUntilWritten(reusableFrom - ringByteCount);
+        }
+
+        std::size_t bufferIndex = getBufferIndex(location);
+        std::memcpy(
+          this->Buffers.get() + bufferIndex * this->BufferByteCount + offset, data, byteCount
+        );
+        std::size_t filledByteCount = this->FilledByteCounts[bufferIndex].fetch_add(
+          byteCount, std::memory_order_acq_rel
+        ) + byteCount;
+        if(filledByteCount == this->BufferByteCount) {
+          this->FlushRequested.notify_one();
+        }
+
+        location += byteCount;
+        data += byteCount;
+        count -= byteCount;
+      }
+    }
+
+    /// <summary>Waits until the log has been written to the file up to a position</summary>
+    /// <param name="end">Position up to which the log needs to be written</param>
+    public: void WaitUntilWritten(std::uint64_t end) {
+      if(this->WrittenEnd.load(std::memory_order_acquire) >= end) {
+        return;
+      }
+
+      std::unique_lock<std::mutex> stateLock(this->Mutex);
+      if(end > this->RequestedWrittenEnd) {
+        this->RequestedWrittenEnd = end;
+      }
+      this->FlushRequested.notify_one();
+      this->Progressed.wait(
+        stateLock,
+        [this, end]() {
+          return (
+            (this->WrittenEnd.load(std::memory_order_acquire) >= end) ||
+            this->HasFailed.load(std::memory_order_acquire)
+          );
+        }
+      );
+      if(this->WrittenEnd.load(std::memory_order_acquire) < end) {
+        std::rethrow_exception(this->Error);
+      }
+    }
+
+    /// <summary>Waits until the log has been flushed to disk up to a position</summary>
+    /// <param name="end">Position up to which the log needs to be durable</param>
+    public: void WaitUntilDurable(std::uint64_t end) {
+      if(this->DurableEnd.load(std::memory_order_acquire) >= end) {
+        return;
+      }
+
+      std::unique_lock<std::mutex> stateLock(this->Mutex);
+      if(end > this->RequestedDurableEnd) {
+        this->RequestedDurableEnd = end;
+      }
+      this->FlushRequested.notify_one();
+      this->Progressed.wait(
+        stateLock,
+        [this, end]() {
+          return (
+            (this->DurableEnd.load(std::memory_order_acquire) >= end) ||
+            this->HasFailed.load(std::memory_order_acquire)
+          );
+        }
+      );
+      if(this->DurableEnd.load(std::memory_order_acquire) < end) {
+        std::rethrow_exception(this->Error);
+      }
+    }
+
+    /// <summary>Throws the error of the background thread if it has failed</summary>
+    public: void ThrowIfFailed() const {
+      if(this->HasFailed.load(std::memory_order_acquire)) {
+        std::rethrow_exception(this->Error);
+      }
+    }
+
+    /// <summary>Determines the buffer that collects the data at a position</summary>
+    /// <param name="location">Position in the log</param>
+    /// <returns>The index of the buffer collecting the data at the position</returns>
+    private: std::size_t getBufferIndex(std::uint64_t location) const {
+      return static_cast<std::size_t>((location / this->BufferByteCount) % this->BufferCount);
+    }
+
+    /// <summary>Checks whether the background thread has been asked to write data</summary>
+    /// <returns>True if data should be written or flushed right away</returns>
+    /// <remarks>Must be called with the mutex held</remarks>
+    private: bool isFlushRequested() const {
+      std::uint64_t writtenEnd = this->WrittenEnd.load(std::memory_order_relaxed);
+      return (
+        this->IsStopping ||
+        (this->RequestedWrittenEnd > writtenEnd) ||
+        (this->RequestedDurableEnd > this->DurableEnd.load(std::memory_order_relaxed)) ||
+        (
+          this->FilledByteCounts[getBufferIndex(writtenEnd)].load(std::memory_order_relaxed) ==
+          this->BufferByteCount
+        )
+      );
+    }
+
+    /// <summary>Writes all data that has been completely copied into the buffers</summary>
+    /// <returns>True if any data was written</returns>
+    private: bool writeCopiedData() {
+      bool hasWritten = false;
+      for(;;) {
+        std::uint64_t writtenEnd = this->WrittenEnd.load(std::memory_order_relaxed);
+        std::size_t offset = static_cast<std::size_t>(writtenEnd % this->BufferByteCount);
+        std::uint64_t bufferStart = writtenEnd - offset;
+        std::uint64_t bufferEnd = bufferStart + this->BufferByteCount;
+        std::size_t bufferIndex = getBufferIndex(writtenEnd);
+
+        // The order of these two loads matters, see the remarks on the structure
+        std::size_t filledByteCount = this->FilledByteCounts[bufferIndex].load(
+          std::memory_order_acquire
+        );
+        std::uint64_t end = std::min(
+          this->ReservedEnd.load(std::memory_order_acquire), bufferEnd
+        );
+        if((end == writtenEnd) || (filledByteCount != end - bufferStart)) {
+          return hasWritten;
+        }
+
+        this->File->WriteAt(
+          writtenEnd,
+          this->Buffers.get() + bufferIndex * this->BufferByteCount + offset,
+          static_cast<std::size_t>(end - writtenEnd)
+        );
+        hasWritten = true;
+
+        if(end == bufferEnd) {
+          this->FilledByteCounts[bufferIndex].store(0, std::memory_order_relaxed);
+        }
+        this->WrittenEnd.store(end, std::memory_order_release);
+        if(end != bufferEnd) {
+          return hasWritten;
+        }
+
+        // Wake up any appending threads waiting for the buffer to become free
+        {
+          std::lock_guard<std::mutex> stateScope(this->Mutex);
+          this->Progressed.notify_all();
+        }
+      }
+    }
+
+    /// <summary>Writes and flushes data in the background until the blob is destroyed</summary>
+    private: void runFlusher() {
+      try {
+        for(;;) {
+          bool isStopping;
+          {
+            std::unique_lock<std::mutex> stateLock(this->Mutex);
+            this->FlushRequested.wait_for(
+              stateLock, this->FlushInterval, [this]() { return isFlushRequested(); }
+            );
+            isStopping = this->IsStopping;
+          }
+
+          // Write everything that is ready, then flush it all to disk in one go
+          bool hasWritten = writeCopiedData();
+          std::uint64_t writtenEnd = this->WrittenEnd.load(std::memory_order_relaxed);
+          if(writtenEnd > this->DurableEnd.load(std::memory_order_relaxed)) {
+            this->File->Flush();
+            this->DurableEnd.store(writtenEnd, std::memory_order_release);
+            hasWritten = true;
+          }
+
+          bool isStillPending;
+          {
+            std::lock_guard<std::mutex> stateScope(this->Mutex);
+            if(hasWritten) {
+              this->Progressed.notify_all();
+            }
+            isStillPending = isFlushRequested();
+          }
+          if(isStopping && (writtenEnd == this->ReservedEnd.load(std::memory_order_acquire))) {
+            return;
+          }
+
+          // If a thread is still copying the data someone is waiting for,
+          // give it a chance to finish instead of spinning
+          if(!hasWritten && isStillPending) {
+            std::this_thread::yield();
+          }
+        }
+      }
+      catch(...) {
+        std::lock_guard<std::mutex> stateScope(this->Mutex);
+        this->Error = std::current_exception();
+        this->HasFailed.store(true, std::memory_order_release);
+        this->Progressed.notify_all();
+      }
+    }
+
+    /// <summary>File the log is written to</summary>
+    public: std::unique_ptr<FileBlob> File;
+    /// <summary>Size of each of the shared buffers</summary>
+    public: std::size_t BufferByteCount;
+    /// <summary>Number of shared buffers</summary>
+    public: std::size_t BufferCount;
+    /// <summary>Time after which data is written and flushed without request</summary>
+    public: std::chrono::milliseconds FlushInterval;
+    /// <summary>Memory of all shared buffers, one after another</summary>
+    public: std::unique_ptr<std::uint8_t[]> Buffers;
+    /// <summary>Number of bytes that have been copied into each buffer</summary>
+    public: std::unique_ptr<std::atomic<std::size_t>[]> FilledByteCounts;
+
+    /// <summary>End of the data appending threads have reserved so far</summary>
+    public: std::atomic<std::uint64_t> ReservedEnd;
+    /// <summary>End of the data that has been written to the file</summary>
+    public: std::atomic<std::uint64_t> WrittenEnd;
+    /// <summary>End of the data that has been flushed to disk</summary>
+    public: std::atomic<std::uint64_t> DurableEnd;
+    /// <summary>Whether the background thread has stopped because of an error</summary>
+    public: std::atomic<bool> HasFailed;
+
+    /// <summary>Must be held while accessing any of the fields below</summary>
+    public: std::mutex Mutex;
+    /// <summary>Signalled when the background thread should write data</summary>
+    public: std::condition_variable FlushRequested;
+    /// <summary>Signalled when data was written or flushed or an error occurred</summary>
+    public: std::condition_variable Progressed;
+    /// <summary>End up to which a thread is waiting for the data to be written</summary>
+    public: std::uint64_t RequestedWrittenEnd;
+    /// <summary>End up to which a thread is waiting for the data to be durable</summary>
+    public: std::uint64_t RequestedDurableEnd;
+    /// <summary>Whether the background thread should write what's left and end</summary>
+    public: bool IsStopping;
+    /// <summary>Error that stopped the background thread</summary>
+    public: std::exception_ptr Error;
+    /// <summary>Background thread writing and flushing the buffers</summary>
+    public: std::thread Flusher;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LogFileBlob::LogFileBlob(
+    const std::string &path,
+    std::size_t bufferByteCount /* = DefaultBufferByteCount */,
+    std::size_t bufferCount /* = DefaultBufferCount */,
+    std::chrono::milliseconds flushInterval /* = std::chrono::milliseconds(10) */
+  ) {
+    if(bufferByteCount == 0) {
+      throw std::invalid_argument(u8"Buffers must be at least one byte long");
+    }
+    if(bufferCount < 2) {
+      throw std::invalid_argument(u8"At least two buffers are required");
+    }
+
+    this->impl.reset(new Impl(path, bufferByteCount, bufferCount, flushInterval));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LogFileBlob::~LogFileBlob() = default;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t LogFileBlob::Append(const void *buffer, std::size_t count) {
+    this->impl->ThrowIfFailed();
+
+    std::uint64_t location = this->impl->ReservedEnd.fetch_add(
+      count, std::memory_order_acq_rel
+    );
+    this->impl->CopyIntoBuffers(location, static_cast<const std::uint8_t *>(buffer), count);
+
+    return location + count;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool LogFileBlob::IsDurable(std::uint64_t ticket) const {
+    return (this->impl->DurableEnd.load(std::memory_order_acquire) >= ticket);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LogFileBlob::WaitUntilDurable(std::uint64_t ticket) {
+    if(ticket > this->impl->ReservedEnd.load(std::memory_order_acquire)) {
+      throw std::out_of_range(u8"Ticket lies beyond the end of the log file blob");
+    }
+
+    this->impl->WaitUntilDurable(ticket);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t LogFileBlob::GetSize() const {
+    return this->impl->ReservedEnd.load(std::memory_order_acquire);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LogFileBlob::ReadAt(std::uint64_t location, void *buffer, std::size_t count) const {
+    std::uint64_t size = this->impl->ReservedEnd.load(std::memory_order_acquire);
+    if((location > size) || (count > size - location)) {
+      throw std::out_of_range(u8"Attempted read past the end of the log file blob");
+    }
+
+    this->impl->WaitUntilWritten(location + count);
+    this->impl->File->ReadAt(location, buffer, count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LogFileBlob::WriteAt(std::uint64_t location, const void *buffer, std::size_t count) {
+    this->impl->ThrowIfFailed();
+
+    std::uint64_t expectedEnd = location;
+    bool isAtEnd = this->impl->ReservedEnd.compare_exchange_strong(
+      expectedEnd, location + count, std::memory_order_acq_rel
+    );
+    if(!isAtEnd) {
+      throw std::runtime_error(u8"Log file blobs can only be written to at their end");
+    }
+
+    this->impl->CopyIntoBuffers(location, static_cast<const std::uint8_t *>(buffer), count);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LogFileBlob::Flush() {
+    this->impl->WaitUntilDurable(this->impl->ReservedEnd.load(std::memory_order_acquire));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
@@ -0,0 +1,443 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/MappedFileBlob.h"
+
+#include <cstring> // for std::memcpy()
+#include <limits> // for std::numeric_limits
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::out_of_range, std::runtime_error
+#include <system_error> // for std::system_error
+
+#if defined(NUCLEX_STORAGE_WIN32)
+#include "Helpers/StringHelper.h"
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h> // for CreateFileW(), CreateFileMappingW(), MapViewOfFile()
+#undef min
+#undef max
+#else
+#include <cerrno> // for errno
+#include <fcntl.h> // for open()
+#include <sys/mman.h> // for mmap(), munmap(), msync()
+#include <sys/stat.h> // for fstat()
+#include <unistd.h> // for close(), ftruncate()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Smallest number of bytes a writable file will be grown by</summary>
+  /// <remarks>
+  ///   Growing the file means mapping it anew, so when data is appended to the file,
+  ///   it is grown by at least this much (or by half its size, whichever is larger) and
+  ///   only trimmed back to its actual size when the blob is destroyed.
+  /// </remarks>
+  const std::size_t MinimumGrowthByteCount = 65536;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception for an error reported by the operating system</summary>
+  /// <param name="errorCode">Error code reported by the operating system</param>
+  /// <param name="message">Message describing what was attempted</param>
+  [[noreturn]] void throwSystemError(int errorCode, const char *message) {
+#if defined(NUCLEX_STORAGE_WIN32)
+    throw std::system_error(errorCode, std::system_category(), message);
+#else
+    throw std::system_error(errorCode, std::generic_category(), message);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_WIN32)
+  /// <summary>Throws an exception for the last error reported by the Windows API</summary>
+  /// <param name="message">Message describing what was attempted</param>
+  [[noreturn]] void throwLastError(const char *message) {
+    DWORD lastErrorCode = ::GetLastError();
+    throwSystemError(static_cast<int>(lastErrorCode), message);
+  }
+#else
+  /// <summary>Throws an exception for the last error reported by a Posix function</summary>
+  /// <param name="message">Message describing what was attempted</param>
+  [[noreturn]] void throwLastError(const char *message) {
+    int errorNumber = errno;
+    throwSystemError(errorNumber, message);
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>OS handles and mapping of the file</summary>
+  struct MappedFileBlob::Impl {
+
+    /// <summary>Initializes the structure for a file that has not been mapped yet</summary>
+    /// <param name="writable">Whether the file will be opened for writing</param>
+    public: Impl(bool writable) :
+      Writable(writable),
+      Length(0),
+      MappedLength(0),
+      Contents(nullptr),
+#if defined(NUCLEX_STORAGE_WIN32)
+      FileHandle(INVALID_HANDLE_VALUE),
+      MappingHandle(nullptr),
+#else
+      FileDescriptor(-1),
+#endif
+      Mutex() {}
+
+    /// <summary>Maps the file into memory with the specified size</summary>
+    /// <param name="mappedLength">Number of bytes of the file that will be mapped</param>
+    /// <remarks>
+    ///   If the file is writable and shorter than the requested size, it will be grown.
+    ///   Any existing mapping is removed first.
+    /// </remarks>
+    public: void Map(std::size_t mappedLength);
+
+    /// <summary>Removes the mapping of the file</summary>
+    public: void Unmap();
+
+    /// <summary>Whether the file has been opened for writing</summary>
+    public: bool Writable;
+    /// <summary>Size of the data stored in the file</summary>
+    public: std::uint64_t Length;
+    /// <summary>Number of bytes that are mapped into memory</summary>
+    /// <remarks>
+    ///   For writable files, this can be more than the length because the file is grown
+    ///   ahead of writes to avoid remapping it all the time
+    /// </remarks>
+    public: std::size_t MappedLength;
+    /// <summary>Address at which the file has been mapped into memory</summary>
+    public: std::uint8_t *Contents;
+#if defined(NUCLEX_STORAGE_WIN32)
+    /// <summary>Handle of the opened file</summary>
+    public: HANDLE FileHandle;
+    /// <summary>Handle of the file mapping object</summary>
+    public: HANDLE MappingHandle;
+#else
+    /// <summary>File descriptor of the opened file</summary>
+    public: int FileDescriptor;
+#endif
+    /// <summary>Sequentializes accesses to the file if it is writable</summary>
+    public: std::mutex Mutex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFileBlob::Impl::Map(std::size_t mappedLength) {
+    Unmap();
+    if(mappedLength == 0) {
+      return; // Empty files can not be mapped
+    }
+
+#if defined(NUCLEX_STORAGE_WIN32)
+
+    // When a writable mapping is larger than the file, Windows grows the file to fit
+    std::uint64_t mappingSize = static_cast<std::uint64_t>(mappedLength);
+    this->MappingHandle = ::CreateFileMappingW(
+      this->FileHandle, nullptr, this->Writable ? PAGE_READWRITE : PAGE_READONLY,
+      static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize), nullptr
+    );
+    if(this->MappingHandle == nullptr) {
+      throwLastError(u8"Could not create a mapping of the file");
+    }
+
+    void *view = ::MapViewOfFile(
+      this->MappingHandle, this->Writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, mappedLength
+    );
+    if(view == nullptr) {
+      DWORD lastErrorCode = ::GetLastError();
+      ::CloseHandle(this->MappingHandle);
+      this->MappingHandle = nullptr;
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not map the file into memory");
+    }
+
+#else // Linux and Posix both offer mmap()
+
+    if(this->Writable && (mappedLength > this->Length)) {
+      int result = ::ftruncate(this->FileDescriptor, static_cast<off_t>(mappedLength));
+      if(result == -1) {
+        throwLastError(u8"Could not change the size of the file");
+      }
+    }
+
+    void *view = ::mmap(
+      nullptr,
+      mappedLength,
+      this->Writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+      MAP_SHARED,
+      this->FileDescriptor,
+      0
+    );
+    if(view == MAP_FAILED) {
+      throwLastError(u8"Could not map the file into memory");
+    }
+
+#endif
+
+    this->Contents = static_cast<std::uint8_t *>(view);
+    this->MappedLength = mappedLength;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFileBlob::Impl::Unmap() {
+    if(this->Contents != nullptr) {
+#if defined(NUCLEX_STORAGE_WIN32)
+      ::UnmapViewOfFile(this->Contents);
+      ::CloseHandle(this->MappingHandle);
+      this->MappingHandle = nullptr;
+#else
+      ::munmap(this->Contents, this->MappedLength);
+#endif
+      this->Contents = nullptr;
+    }
+
+    this->MappedLength = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFileBlob::MappedFileBlob(const std::string &path, bool writable /* = false */) :
+    impl(new Impl(writable)) {
+#if defined(NUCLEX_STORAGE_WIN32)
+
+    std::wstring utf16Path = Helpers::StringHelper::WideCharFromUtf8(path);
+    this->impl->FileHandle = ::CreateFileW(
+      utf16Path.c_str(),
+      writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+      writable ? 0 : FILE_SHARE_READ, // Others can read while nobody writes
+      nullptr,
+      writable ? OPEN_ALWAYS : OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr
+    );
+    if(this->impl->FileHandle == INVALID_HANDLE_VALUE) {
+      throwLastError(u8"Could not open the file");
+    }
+
+    LARGE_INTEGER fileSize;
+    if(::GetFileSizeEx(this->impl->FileHandle, &fileSize) == FALSE) {
+      DWORD lastErrorCode = ::GetLastError();
+      ::CloseHandle(this->impl->FileHandle);
+      throwSystemError(static_cast<int>(lastErrorCode), u8"Could not determine file size");
+    }
+    this->impl->Length = static_cast<std::uint64_t>(fileSize.QuadPart);
+
+#else // Linux and Posix both offer mmap()
+
+    this->impl->FileDescriptor = ::open(
+      path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644
+    );
+    if(this->impl->FileDescriptor == -1) {
+      throwLastError(u8"Could not open the file");
+    }
+
+    struct ::stat fileStatus;
+    if(::fstat(this->impl->FileDescriptor, &fileStatus) == -1) {
+      int errorNumber = errno;
+      ::close(this->impl->FileDescriptor);
+      throwSystemError(errorNumber, u8"Could not determine file size");
+    }
+    this->impl->Length = static_cast<std::uint64_t>(fileStatus.st_size);
+
+#endif
+
+    try {
+      if(this->impl->Length > std::numeric_limits<std::size_t>::max()) {
+        throw std::out_of_range(u8"File is too large to be mapped into memory");
+      }
+      this->impl->Map(static_cast<std::size_t>(this->impl->Length));
+    }
+    catch(...) {
+#if defined(NUCLEX_STORAGE_WIN32)
+      ::CloseHandle(this->impl->FileHandle);
+#else
+      ::close(this->impl->FileDescriptor);
+#endif
+      throw;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MappedFileBlob::~MappedFileBlob() {
+    this->impl->Unmap();
+
+    // The file may have been grown ahead of writes, trim it back to its actual size.
+    // There's no way to report errors from here, so if this fails, the file stays large.
+#if defined(NUCLEX_STORAGE_WIN32)
+    if(this->impl->Writable) {
+      LARGE_INTEGER fileSize;
+      fileSize.QuadPart = static_cast<LONGLONG>(this->impl->Length);
+      if(::SetFilePointerEx(this->impl->FileHandle, fileSize, nullptr, FILE_BEGIN) != FALSE) {
+        ::SetEndOfFile(this->impl->FileHandle);
+      }
+    }
+    ::CloseHandle(this->impl->FileHandle);
+#else
+    if(this->impl->Writable) {
+      int result = ::ftruncate(this->impl->FileDescriptor, static_cast<off_t>(this->impl->Length));
+      (void)result;
+    }
+    ::close(this->impl->FileDescriptor);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool MappedFileBlob::IsWritable() const {
+    return this->impl->Writable;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t MappedFileBlob::GetSize() const {
+    if(!this->impl->Writable) {
+      return this->impl->Length;
+    }
+
+    std::lock_guard<std::mutex> scope(this->impl->Mutex);
+    return this->impl->Length;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFileBlob::ReadAt(std::uint64_t location, void *buffer, std::size_t count) const {
+    std::unique_lock<std::mutex> scope(this->impl->Mutex, std::defer_lock);
+    if(this->impl->Writable) {
+      scope.lock();
+    }
+
+    if((location > this->impl->Length) || (count > this->impl->Length - location)) {
+      throw std::out_of_range(u8"Attempted read past the end of the file blob");
+    }
+    if(count > 0) {
+      std::memcpy(buffer, this->impl->Contents + static_cast<std::size_t>(location), count);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFileBlob::WriteAt(std::uint64_t location, const void *buffer, std::size_t count) {
+    if(!this->impl->Writable) {
+      throw std::runtime_error(u8"Attempted write to a read-only file blob");
+    }
+
+    std::lock_guard<std::mutex> scope(this->impl->Mutex);
+
+    if(location > this->impl->Length) {
+      throw std::out_of_range(
+        u8"Attempted write past the end of the file blob (would create undefined gap)"
+      );
+    }
+    if(count > std::numeric_limits<std::size_t>::max() - location) {
+      throw std::out_of_range(u8"Write location exceeds std::size_t for file blob");
+    }
+
+    // Grow the file if the write goes past the end of the mapped range
+    std::size_t end = static_cast<std::size_t>(location) + count;
+    if(end > this->impl->MappedLength) {
+      std::size_t mappedLength = this->impl->MappedLength;
+      std::size_t growth = mappedLength / 2;
+      if(growth < MinimumGrowthByteCount) {
+        growth = MinimumGrowthByteCount;
+      }
+      if(mappedLength > std::numeric_limits<std::size_t>::max() - growth) {
+        mappedLength = end;
+      } else {
+        mappedLength += growth;
+        if(mappedLength < end) {
+          mappedLength = end;
+        }
+      }
+
+      this->impl->Map(mappedLength);
+    }
+
+    if(count > 0) {
+      std::memcpy(this->impl->Contents + static_cast<std::size_t>(location), buffer, count);
+    }
+    if(end > this->impl->Length) {
+      this->impl->Length = end;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MappedFileBlob::Flush() {
+    if(!this->impl->Writable) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> scope(this->impl->Mutex);
+    if(this->impl->Contents == nullptr) {
+      return;
+    }
+
+#if defined(NUCLEX_STORAGE_WIN32)
+    if(::FlushViewOfFile(this->impl->Contents, this->impl->MappedLength) == FALSE) {
+      throwLastError(u8"Could not write the mapped file's pages back to disk");
+    }
+    if(::FlushFileBuffers(this->impl->FileHandle) == FALSE) {
+      throwLastError(u8"Could not flush the file's buffers");
+    }
+#else
+    if(::msync(this->impl->Contents, this->impl->MappedLength, MS_SYNC) == -1) {
+      throwLastError(u8"Could not write the mapped file's pages back to disk");
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::uint8_t *MappedFileBlob::TryGetContiguousSpan(
+    std::uint64_t location, std::size_t count
+  ) const {
+    std::unique_lock<std::mutex> scope(this->impl->Mutex, std::defer_lock);
+    if(this->impl->Writable) {
+      scope.lock();
+    }
+
+    if((location > this->impl->Length) || (count > this->impl->Length - location)) {
+      return nullptr;
+    }
+    if(this->impl->Contents == nullptr) { // File is empty, there's no mapping to point into
+      static const std::uint8_t nothing = 0;
+      return &nothing;
+    }
+
+    return this->impl->Contents + static_cast<std::size_t>(location);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
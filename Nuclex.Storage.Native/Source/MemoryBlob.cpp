@@ -77,6 +77,16 @@ namespace Nuclex { namespace Storage {
       throw std::out_of_range("Read location exceeds std::size_t for in-memory blob");
     }
 
+    // Once the blob is sealed its contents can no longer change, so no lock is needed
+    if(this->sealed.load(std::memory_order_acquire)) {
+      std::copy_n(
+        &this->memory.at(static_cast<std::size_t>(location)),
+        count,
+        static_cast<unsigned char *>(buffer)
+      );
+      return;
+    }
+
     std::lock_guard<std::mutex> scope(this->mutex); {
       std::copy_n(
         &this->memory.at(static_cast<std::size_t>(location)),
@@ -100,6 +110,9 @@ namespace Nuclex { namespace Storage {
     std::size_t end = start + count;
 
     std::lock_guard<std::mutex> scope(this->mutex); {
+      if(this->sealed.load(std::memory_order_relaxed)) {
+        throw std::runtime_error(u8"Attempted write to a sealed memory blob");
+      }
 
       // Grow our vector if its capacity might not be sufficient
       std::size_t blobSize = this->memory.size();
@@ -136,4 +149,43 @@ namespace Nuclex { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  const std::uint8_t *MemoryBlob::TryGetContiguousSpan(
+    std::uint64_t location, std::size_t count
+  ) const {
+    if(!this->sealed.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+
+    std::size_t length = this->memory.size();
+    if((location > length) || (count > length - location)) {
+      return nullptr;
+    }
+    if(length == 0) { // Empty vectors have no memory block to point into
+      static const std::uint8_t nothing = 0;
+      return &nothing;
+    }
+
+    return this->memory.data() + static_cast<std::size_t>(location);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryBlob::Reserve(std::size_t byteCount) {
+    std::lock_guard<std::mutex> scope(this->mutex);
+    if(this->sealed.load(std::memory_order_relaxed)) {
+      throw std::runtime_error(u8"Attempted to reserve memory for a sealed memory blob");
+    }
+
+    this->memory.reserve(byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MemoryBlob::Seal() {
+    std::lock_guard<std::mutex> scope(this->mutex);
+    this->sealed.store(true, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Storage
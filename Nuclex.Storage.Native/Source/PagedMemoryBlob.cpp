@@ -0,0 +1,175 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/PagedMemoryBlob.h"
+
+#include <algorithm> // for std::copy_n(), std::min()
+#include <atomic> // for std::atomic_thread_fence()
+#include <stdexcept> // for std::out_of_range, std::invalid_argument
+#include <utility> // for std::move()
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  PagedMemoryBlob::PagedMemoryBlob(std::size_t pageSize) :
+    pageSize(pageSize),
+    size(0),
+    pages(),
+    mutex() {
+    if(pageSize == 0) {
+      throw std::invalid_argument(u8"Page size of a paged memory blob must not be zero");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t PagedMemoryBlob::GetSize() const {
+    std::lock_guard<std::mutex> scope(this->mutex);
+    return this->size;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PagedMemoryBlob::ReadAt(std::uint64_t location, void *buffer, std::size_t count) const {
+    std::lock_guard<std::mutex> scope(this->mutex); {
+      if((location > this->size) || (count > this->size - location)) {
+        throw std::out_of_range(u8"Attempted read past the end of the paged memory blob");
+      }
+
+      std::uint8_t *target = static_cast<std::uint8_t *>(buffer);
+      std::size_t pageIndex = static_cast<std::size_t>(location / this->pageSize);
+      std::size_t offset = static_cast<std::size_t>(location % this->pageSize);
+      while(count > 0) {
+        std::size_t chunkSize = std::min(count, this->pageSize - offset);
+        std::copy_n(this->pages[pageIndex].get() + offset, chunkSize, target);
+
+        target += chunkSize;
+        count -= chunkSize;
+        offset = 0;
+        ++pageIndex;
+      }
+    } // mutex lock
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void PagedMemoryBlob::WriteAt(std::uint64_t location, const void *buffer, std::size_t count) {
+    const std::uint8_t *source = static_cast<const std::uint8_t *>(buffer);
+
+    std::lock_guard<std::mutex> scope(this->mutex); {
+      if(location > this->size) {
+        throw std::out_of_range(
+          u8"Attempted write past the end of the paged memory blob (would create undefined gap)"
+        );
+      }
+
+      std::uint64_t end = location + count;
+      std::uint64_t requiredPageCount = (end + this->pageSize - 1) / this->pageSize;
+      if(requiredPageCount > this->pages.size()) {
+        this->pages.resize(static_cast<std::size_t>(requiredPageCount));
+      }
+
+      std::size_t pageIndex = static_cast<std::size_t>(location / this->pageSize);
+      std::size_t offset = static_cast<std::size_t>(location % this->pageSize);
+      while(count > 0) {
+        std::size_t chunkSize = std::min(count, this->pageSize - offset);
+        std::copy_n(source, chunkSize, getWritablePage(pageIndex) + offset);
+
+        source += chunkSize;
+        count -= chunkSize;
+        offset = 0;
+        ++pageIndex;
+      }
+
+      if(end > this->size) {
+        this->size = end;
+      }
+    } // mutex lock
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::shared_ptr<PagedMemoryBlob> PagedMemoryBlob::Snapshot() const {
+    std::shared_ptr<PagedMemoryBlob> snapshot = std::make_shared<PagedMemoryBlob>(
+      this->pageSize
+    );
+
+    std::lock_guard<std::mutex> scope(this->mutex); {
+      snapshot->size = this->size;
+      snapshot->pages = this->pages;
+    }
+
+    return snapshot;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PagedMemoryBlob::CountPages() const {
+    std::lock_guard<std::mutex> scope(this->mutex);
+    return this->pages.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t PagedMemoryBlob::CountSharedPages() const {
+    std::lock_guard<std::mutex> scope(this->mutex); {
+      std::size_t sharedPageCount = 0;
+      for(std::size_t index = 0; index < this->pages.size(); ++index) {
+        if(this->pages[index].use_count() > 1) {
+          ++sharedPageCount;
+        }
+      }
+      return sharedPageCount;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint8_t *PagedMemoryBlob::getWritablePage(std::size_t pageIndex) {
+    PagePointer &page = this->pages[pageIndex];
+
+    // Pages past the previous end of the blob don't exist yet
+    if(!page) {
+      page.reset(new std::uint8_t[this->pageSize], std::default_delete<std::uint8_t[]>());
+      return page.get();
+    }
+
+    // If we hold the only reference, nobody else can obtain a new one because snapshots
+    // are only taken from blobs holding the page. Another blob may just have dropped
+    // its reference, so make sure its last reads happen before our writes.
+    if(page.use_count() == 1) {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return page.get();
+    }
+
+    PagePointer copy(new std::uint8_t[this->pageSize], std::default_delete<std::uint8_t[]>());
+    std::copy_n(page.get(), this->pageSize, copy.get());
+    page = std::move(copy);
+
+    return page.get();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
@@ -0,0 +1,574 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/BinaryXmlBlobReader.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include "BinaryXmlFormat.h"
+#include "../Helpers/BinaryEncoding.h"
+#include "../Helpers/Lexical.h"
+
+#include <Nuclex/Support/Text/InternedString.h> // for InternedString
+#include <Nuclex/Support/Text/Lexical.h> // for lexical_cast()
+#include <Nuclex/Support/Text/StringConverter.h> // for StringConverter
+
+#include <cstring> // for std::memcpy(), std::memcmp()
+#include <stdexcept> // for std::runtime_error, std::logic_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes binary data that has been stored as text</summary>
+  /// <typeparam name="TDecoder">Decoder that will be used to decode the text</typeparam>
+  /// <param name="text">Text containing the encoded binary data</param>
+  /// <param name="target">Buffer that will receive the decoded bytes</param>
+  /// <param name="byteCount">Number of bytes that are expected</param>
+  template<typename TDecoder>
+  void decodeBinary(const std::string &text, std::uint8_t *target, std::size_t byteCount) {
+    TDecoder decoder;
+    std::size_t written = decoder.Decode(text.data(), text.length(), target, byteCount);
+    if((written != byteCount) || !decoder.IsComplete()) {
+      throw std::runtime_error("Encoded binary data is shorter than expected");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryXmlBlobReader::BinaryXmlBlobReader(const std::shared_ptr<const Blob> &blob) :
+    reader(blob),
+    length(blob->GetSize()),
+    binaryFormat(XmlBinaryFormat::Base64),
+    name(nullptr),
+    attributeCount(0),
+    enteredAttribute(nullptr),
+    nextTokenByte(-1) {
+
+    if(!IsBinaryXml(*blob.get())) {
+      throw std::runtime_error("Blob does not contain a binary XML document");
+    }
+
+    // Floating point values are stored in little endian, whatever the system uses
+    this->reader.SetLittleEndian(true);
+    this->reader.SetPosition(sizeof(BinaryXmlFormat::Signature) + 1);
+
+    this->content.Type = static_cast<std::uint8_t>(BinaryXmlFormat::ValueType::Text);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryXmlBlobReader::~BinaryXmlBlobReader() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BinaryXmlBlobReader::IsBinaryXml(const Blob &blob) {
+    const std::size_t headerByteCount = sizeof(BinaryXmlFormat::Signature) + 1;
+    if(blob.GetSize() < headerByteCount) {
+      return false;
+    }
+
+    std::uint8_t header[headerByteCount];
+    blob.ReadAt(0, header, headerByteCount);
+
+    return (
+      (std::memcmp(header, BinaryXmlFormat::Signature, sizeof(BinaryXmlFormat::Signature)) == 0) &&
+      (header[sizeof(BinaryXmlFormat::Signature)] == BinaryXmlFormat::Version)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  XmlReadEvent BinaryXmlBlobReader::Read() {
+    std::uint8_t tokenByte;
+    if(this->nextTokenByte >= 0) {
+      tokenByte = static_cast<std::uint8_t>(this->nextTokenByte);
+      this->nextTokenByte = -1;
+    } else if(this->reader.GetPosition() >= this->length) {
+      if(!this->openElements.empty()) {
+        throw std::runtime_error("Binary XML document ends inside an element");
+      }
+      return XmlReadEvent::End;
+    } else {
+      tokenByte = readTokenByte();
+    }
+
+    switch(BinaryXmlFormat::GetToken(tokenByte)) {
+      case BinaryXmlFormat::Token::ElementStart: {
+        this->name = &readName();
+        this->openElements.push_back(this->name);
+
+        // The attributes directly follow the element, so collect all of them and keep
+        // the first token that isn't an attribute for the next call
+        this->attributeCount = 0;
+        while(this->reader.GetPosition() < this->length) {
+          tokenByte = readTokenByte();
+          if(BinaryXmlFormat::GetToken(tokenByte) != BinaryXmlFormat::Token::Attribute) {
+            this->nextTokenByte = tokenByte;
+            break;
+          }
+
+          if(this->attributes.size() <= this->attributeCount) {
+            this->attributes.resize(this->attributeCount + 1);
+          }
+
+          Attribute &attribute = this->attributes[this->attributeCount];
+          attribute.Name = &readName();
+          readValue(
+            static_cast<std::uint8_t>(BinaryXmlFormat::GetValueType(tokenByte)), attribute.Value
+          );
+          ++this->attributeCount;
+        }
+
+        return XmlReadEvent::ElementStart;
+      }
+      case BinaryXmlFormat::Token::Content: {
+        this->attributeCount = 0;
+        readValue(
+          static_cast<std::uint8_t>(BinaryXmlFormat::GetValueType(tokenByte)), this->content
+        );
+        return XmlReadEvent::Content;
+      }
+      case BinaryXmlFormat::Token::ElementEnd: {
+        if(this->openElements.empty()) {
+          throw std::runtime_error("Binary XML document closes more elements than it opens");
+        }
+
+        this->attributeCount = 0;
+        this->name = this->openElements.back();
+        this->openElements.pop_back();
+        return XmlReadEvent::ElementEnd;
+      }
+      default: {
+        throw std::runtime_error("Binary XML document contains an invalid token");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &BinaryXmlBlobReader::GetElementName() const {
+    if(this->name == nullptr) {
+      throw std::logic_error("No element has been entered yet");
+    }
+
+    return *this->name;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t BinaryXmlBlobReader::CountAttributes() const {
+    return this->attributeCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &BinaryXmlBlobReader::GetAttributeName(std::size_t index) const {
+    if(index >= this->attributeCount) {
+      throw std::out_of_range("Attribute index is out of range");
+    }
+
+    return *this->attributes[index].Name;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &BinaryXmlBlobReader::InternName(const std::string &name) {
+    return intern(name);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BinaryXmlBlobReader::TryEnterAttribute(const std::string &attributeName) {
+
+    // If the caller passed us an interned name, we can skip comparing the contents
+    for(std::size_t index = 0; index < this->attributeCount; ++index) {
+      if(this->attributes[index].Name == &attributeName) {
+        this->enteredAttribute = &this->attributes[index].Value;
+        return true;
+      }
+    }
+
+    std::unordered_map<std::string, const std::string *>::const_iterator interned = (
+      this->nameLookup.find(attributeName)
+    );
+    if(interned != this->nameLookup.end()) {
+      for(std::size_t index = 0; index < this->attributeCount; ++index) {
+        if(this->attributes[index].Name == interned->second) {
+          this->enteredAttribute = &this->attributes[index].Value;
+          return true;
+        }
+      }
+    }
+
+    this->enteredAttribute = nullptr;
+    return false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::LeaveAttribute() {
+    if(this->enteredAttribute == nullptr) {
+      throw std::logic_error("Tried to leave attribute without having entered one");
+    }
+
+    this->enteredAttribute = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(bool &target) {
+    const StoredValue &value = getValue();
+    switch(static_cast<BinaryXmlFormat::ValueType>(value.Type)) {
+      case BinaryXmlFormat::ValueType::Text: {
+        target = Helpers::lexical_cast<bool>(value.Data);
+        break;
+      }
+      case BinaryXmlFormat::ValueType::Float:
+      case BinaryXmlFormat::ValueType::Double: {
+        target = (value.Real != 0.0);
+        break;
+      }
+      case BinaryXmlFormat::ValueType::Binary: {
+        throw std::runtime_error("Binary data can not be read as a boolean");
+      }
+      default: {
+        target = (value.Integer != 0);
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::uint8_t &target) {
+    target = toInteger<std::uint8_t>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::int8_t &target) {
+    target = toInteger<std::int8_t>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::uint16_t &target) {
+    target = toInteger<std::uint16_t>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::int16_t &target) {
+    target = toInteger<std::int16_t>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::uint32_t &target) {
+    target = toInteger<std::uint32_t>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::int32_t &target) {
+    target = toInteger<std::int32_t>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::uint64_t &target) {
+    target = toInteger<std::uint64_t>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::int64_t &target) {
+    target = toInteger<std::int64_t>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(float &target) {
+    target = toFloat<float>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(double &target) {
+    target = toFloat<double>(getValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::string &target) {
+    const StoredValue &value = getValue();
+    switch(static_cast<BinaryXmlFormat::ValueType>(value.Type)) {
+      case BinaryXmlFormat::ValueType::Boolean: {
+        target = Support::Text::lexical_cast<std::string>(value.Integer != 0);
+        break;
+      }
+      case BinaryXmlFormat::ValueType::UnsignedInteger: {
+        target = Support::Text::lexical_cast<std::string>(value.Integer);
+        break;
+      }
+      case BinaryXmlFormat::ValueType::SignedInteger: {
+        target = Support::Text::lexical_cast<std::string>(
+          static_cast<std::int64_t>(value.Integer)
+        );
+        break;
+      }
+      case BinaryXmlFormat::ValueType::Float: {
+        target = Support::Text::lexical_cast<std::string>(static_cast<float>(value.Real));
+        break;
+      }
+      case BinaryXmlFormat::ValueType::Double: {
+        target = Support::Text::lexical_cast<std::string>(value.Real);
+        break;
+      }
+      default: {
+        target = value.Data;
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(std::wstring &target) {
+    std::string utf8;
+    Read(utf8);
+    target = Support::Text::StringConverter::WideFromUtf8(utf8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::Read(void *buffer, std::size_t byteCount) {
+    const StoredValue &value = getValue();
+    std::uint8_t *target = static_cast<std::uint8_t *>(buffer);
+
+    switch(static_cast<BinaryXmlFormat::ValueType>(value.Type)) {
+      case BinaryXmlFormat::ValueType::Binary: {
+        if(value.Data.length() != byteCount) {
+          throw std::runtime_error("Binary data has a different length than expected");
+        }
+        if(byteCount > 0) {
+          std::memcpy(target, value.Data.data(), byteCount);
+        }
+        break;
+      }
+      case BinaryXmlFormat::ValueType::Text: {
+        if(this->binaryFormat == XmlBinaryFormat::Base64) {
+          decodeBinary<Helpers::Base64Decoder>(value.Data, target, byteCount);
+        } else {
+          decodeBinary<Helpers::HexDecoder>(value.Data, target, byteCount);
+        }
+        break;
+      }
+      default: {
+        throw std::runtime_error("Numbers can not be read as binary data");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const BinaryXmlBlobReader::StoredValue &BinaryXmlBlobReader::getValue() const {
+    if(this->enteredAttribute != nullptr) {
+      return *this->enteredAttribute;
+    } else {
+      return this->content;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TInteger>
+  TInteger BinaryXmlBlobReader::toInteger(const StoredValue &value) {
+    switch(static_cast<BinaryXmlFormat::ValueType>(value.Type)) {
+      case BinaryXmlFormat::ValueType::Text: {
+        return Helpers::lexical_cast<TInteger>(value.Data);
+      }
+      case BinaryXmlFormat::ValueType::Binary: {
+        throw std::runtime_error("Binary data can not be read as a number");
+      }
+      case BinaryXmlFormat::ValueType::Float:
+      case BinaryXmlFormat::ValueType::Double: {
+        return static_cast<TInteger>(value.Real);
+      }
+      default: {
+        return static_cast<TInteger>(value.Integer);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TFloat>
+  TFloat BinaryXmlBlobReader::toFloat(const StoredValue &value) {
+    switch(static_cast<BinaryXmlFormat::ValueType>(value.Type)) {
+      case BinaryXmlFormat::ValueType::Text: {
+        return Helpers::lexical_cast<TFloat>(value.Data);
+      }
+      case BinaryXmlFormat::ValueType::Binary: {
+        throw std::runtime_error("Binary data can not be read as a number");
+      }
+      case BinaryXmlFormat::ValueType::Float:
+      case BinaryXmlFormat::ValueType::Double: {
+        return static_cast<TFloat>(value.Real);
+      }
+      case BinaryXmlFormat::ValueType::SignedInteger: {
+        return static_cast<TFloat>(static_cast<std::int64_t>(value.Integer));
+      }
+      default: {
+        return static_cast<TFloat>(value.Integer);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint8_t BinaryXmlBlobReader::readTokenByte() {
+    std::uint8_t tokenByte;
+    this->reader.Read(tokenByte);
+    return tokenByte;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &BinaryXmlBlobReader::readName() {
+    std::uint64_t reference = readVarInt();
+    if(reference == 0) {
+      std::string newName;
+      readBytes(newName);
+
+      const std::string &interned = intern(newName);
+      this->documentNames.push_back(&interned);
+      return interned;
+    }
+
+    if(reference > this->documentNames.size()) {
+      throw std::runtime_error("Binary XML document refers to a name it never defined");
+    }
+
+    return *this->documentNames[static_cast<std::size_t>(reference - 1)];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::readValue(std::uint8_t type, StoredValue &target) {
+    target.Type = type;
+
+    switch(static_cast<BinaryXmlFormat::ValueType>(type)) {
+      case BinaryXmlFormat::ValueType::Text:
+      case BinaryXmlFormat::ValueType::Binary: {
+        readBytes(target.Data);
+        break;
+      }
+      case BinaryXmlFormat::ValueType::Boolean: {
+        std::uint8_t value;
+        this->reader.Read(value);
+        target.Integer = (value != 0) ? 1 : 0;
+        break;
+      }
+      case BinaryXmlFormat::ValueType::UnsignedInteger: {
+        target.Integer = readVarInt();
+        break;
+      }
+      case BinaryXmlFormat::ValueType::SignedInteger: {
+        target.Integer = static_cast<std::uint64_t>(BinaryXmlFormat::DecodeZigZag(readVarInt()));
+        break;
+      }
+      case BinaryXmlFormat::ValueType::Float: {
+        float value;
+        this->reader.Read(value);
+        target.Real = value;
+        break;
+      }
+      case BinaryXmlFormat::ValueType::Double: {
+        this->reader.Read(target.Real);
+        break;
+      }
+      default: {
+        throw std::runtime_error("Binary XML document contains a value of unknown type");
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t BinaryXmlBlobReader::readVarInt() {
+    std::uint64_t value = 0;
+
+    for(std::size_t index = 0; index < BinaryXmlFormat::MaximumVarIntByteCount; ++index) {
+      std::uint8_t byte;
+      this->reader.Read(byte);
+
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << (index * 7);
+      if((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+
+    throw std::runtime_error("Binary XML document contains an overlong integer");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobReader::readBytes(std::string &target) {
+    std::uint64_t byteCount = readVarInt();
+    if(byteCount > this->length - this->reader.GetPosition()) {
+      throw std::runtime_error("Binary XML document ends unexpectedly");
+    }
+
+    target.resize(static_cast<std::size_t>(byteCount));
+    if(byteCount > 0) {
+      this->reader.Read(&target[0], static_cast<std::size_t>(byteCount));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &BinaryXmlBlobReader::intern(const std::string &name) {
+    std::unordered_map<std::string, const std::string *>::const_iterator existing = (
+      this->nameLookup.find(name)
+    );
+    if(existing != this->nameLookup.end()) {
+      return *existing->second;
+    }
+
+    // Share the copy with every other reader and with InternedStrings of the same text
+    const std::string &interned = Nuclex::Support::Text::InternedString(name).ToString();
+    this->nameLookup.emplace(interned, &interned);
+
+    return interned;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
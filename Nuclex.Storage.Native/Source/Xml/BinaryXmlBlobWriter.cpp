@@ -0,0 +1,366 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/BinaryXmlBlobWriter.h"
+#include "Nuclex/Storage/Xml/XmlReader.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include "BinaryXmlFormat.h"
+
+#include <Nuclex/Support/Text/StringConverter.h> // for StringConverter
+
+#include <stdexcept> // for std::logic_error
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryXmlBlobWriter::BinaryXmlBlobWriter(
+    const std::shared_ptr<Blob> &blob,
+    std::size_t writeBufferByteCount /* = DefaultWriteBufferByteCount */
+  ) :
+    writer(blob, writeBufferByteCount),
+    binaryFormat(XmlBinaryFormat::Base64),
+    openElementCount(0),
+    canAddAttributes(false),
+    isInAttribute(false),
+    isAttributeWritten(false),
+    isInComment(false) {
+
+    // Floating point values are stored in little endian, whatever the system uses
+    this->writer.SetLittleEndian(true);
+
+    this->writer.Write(BinaryXmlFormat::Signature, sizeof(BinaryXmlFormat::Signature));
+    this->writer.Write(BinaryXmlFormat::Version);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BinaryXmlBlobWriter::~BinaryXmlBlobWriter() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Flush() {
+    this->writer.Flush();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::CopyFrom(XmlReader &reader) {
+    std::string value;
+
+    // Text readers may report long contents in several pieces. These are collected
+    // and stored as a single content so the binary reader can hand it out in one go.
+    std::string content;
+    bool hasContent = false;
+
+    for(;;) {
+      XmlReadEvent readEvent = reader.Read();
+      if(readEvent == XmlReadEvent::Content) {
+        reader.Read(value);
+        content.append(value);
+        hasContent = true;
+        continue;
+      }
+
+      if(hasContent) {
+        Write(content);
+        content.clear();
+        hasContent = false;
+      }
+
+      switch(readEvent) {
+        case XmlReadEvent::ElementStart: {
+          BeginElement(reader.GetElementName());
+
+          std::size_t attributeCount = reader.CountAttributes();
+          for(std::size_t index = 0; index < attributeCount; ++index) {
+            const std::string &name = reader.GetAttributeName(index);
+            reader.EnterAttribute(name);
+            {
+              XmlReader::AttributeScope scope(reader);
+              reader.Read(value);
+            }
+
+            BeginAttribute(name);
+            Write(value);
+            EndAttribute();
+          }
+
+          break;
+        }
+        case XmlReadEvent::ElementEnd: {
+          EndElement();
+          break;
+        }
+        default: {
+          return;
+        }
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::WriteDeclaration(const std::string &encoding /* = "utf-8" */) {
+    (void)encoding;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::BeginElement(const std::string &elementName) {
+    if(this->isInAttribute || this->isInComment) {
+      throw std::logic_error("Elements can not be opened inside attributes or comments");
+    }
+
+    this->writer.Write(BinaryXmlFormat::GetTokenByte(BinaryXmlFormat::Token::ElementStart));
+    writeName(elementName);
+
+    ++this->openElementCount;
+    this->canAddAttributes = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::EndElement() {
+    if(this->openElementCount == 0) {
+      throw std::logic_error("Tried to close an element without having opened one");
+    }
+    if(this->isInAttribute || this->isInComment) {
+      throw std::logic_error("Elements can not be closed inside attributes or comments");
+    }
+
+    this->writer.Write(BinaryXmlFormat::GetTokenByte(BinaryXmlFormat::Token::ElementEnd));
+
+    --this->openElementCount;
+    this->canAddAttributes = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::BeginComment() {
+    this->isInComment = true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::EndComment() {
+    this->isInComment = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::BeginAttribute(const std::string &attributeName) {
+    if(!this->canAddAttributes) {
+      throw std::logic_error(
+        "Attributes can only be added to an element before its contents or child elements"
+      );
+    }
+
+    this->attributeName = attributeName;
+    this->isInAttribute = true;
+    this->isAttributeWritten = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::EndAttribute() {
+    if(!this->isAttributeWritten) {
+      Write(std::string());
+    }
+
+    this->isInAttribute = false;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(bool value) {
+    if(beginValue(static_cast<std::uint8_t>(BinaryXmlFormat::ValueType::Boolean))) {
+      this->writer.Write(static_cast<std::uint8_t>(value ? 1 : 0));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(std::uint8_t value) {
+    writeUnsigned(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(std::int8_t value) {
+    writeSigned(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(std::uint16_t value) {
+    writeUnsigned(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(std::int16_t value) {
+    writeSigned(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(std::uint32_t value) {
+    writeUnsigned(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(std::int32_t value) {
+    writeSigned(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(std::uint64_t value) {
+    writeUnsigned(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(std::int64_t value) {
+    writeSigned(value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(float value) {
+    if(beginValue(static_cast<std::uint8_t>(BinaryXmlFormat::ValueType::Float))) {
+      this->writer.Write(value);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(double value) {
+    if(beginValue(static_cast<std::uint8_t>(BinaryXmlFormat::ValueType::Double))) {
+      this->writer.Write(value);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(const std::string &value) {
+    if(beginValue(static_cast<std::uint8_t>(BinaryXmlFormat::ValueType::Text))) {
+      writeBytes(value.data(), value.length());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(const std::wstring &value) {
+    Write(Support::Text::StringConverter::Utf8FromWide(value));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::Write(const void *buffer, std::size_t byteCount) {
+    if(beginValue(static_cast<std::uint8_t>(BinaryXmlFormat::ValueType::Binary))) {
+      writeBytes(buffer, byteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BinaryXmlBlobWriter::beginValue(std::uint8_t valueType) {
+    if(this->isInComment) {
+      return false;
+    }
+
+    BinaryXmlFormat::ValueType type = static_cast<BinaryXmlFormat::ValueType>(valueType);
+    if(this->isInAttribute) {
+      if(this->isAttributeWritten) {
+        throw std::logic_error("Attributes in binary XML can only hold a single value");
+      }
+
+      this->writer.Write(
+        BinaryXmlFormat::GetTokenByte(BinaryXmlFormat::Token::Attribute, type)
+      );
+      writeName(this->attributeName);
+      this->isAttributeWritten = true;
+    } else {
+      this->writer.Write(BinaryXmlFormat::GetTokenByte(BinaryXmlFormat::Token::Content, type));
+      this->canAddAttributes = false;
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::writeName(const std::string &name) {
+    std::unordered_map<std::string, std::size_t>::const_iterator existing = (
+      this->nameIndices.find(name)
+    );
+    if(existing != this->nameIndices.end()) {
+      writeVarInt(static_cast<std::uint64_t>(existing->second) + 1);
+    } else {
+      std::size_t index = this->nameIndices.size();
+      this->nameIndices.emplace(name, index);
+
+      writeVarInt(0);
+      writeBytes(name.data(), name.length());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::writeVarInt(std::uint64_t value) {
+    std::uint8_t encoded[BinaryXmlFormat::MaximumVarIntByteCount];
+    this->writer.Write(encoded, BinaryXmlFormat::EncodeVarInt(value, encoded));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::writeBytes(const void *data, std::size_t byteCount) {
+    writeVarInt(byteCount);
+    if(byteCount > 0) {
+      this->writer.Write(data, byteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::writeUnsigned(std::uint64_t value) {
+    if(beginValue(static_cast<std::uint8_t>(BinaryXmlFormat::ValueType::UnsignedInteger))) {
+      writeVarInt(value);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BinaryXmlBlobWriter::writeSigned(std::int64_t value) {
+    if(beginValue(static_cast<std::uint8_t>(BinaryXmlFormat::ValueType::SignedInteger))) {
+      writeVarInt(BinaryXmlFormat::EncodeZigZag(value));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
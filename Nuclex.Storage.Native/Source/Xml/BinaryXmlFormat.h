@@ -0,0 +1,179 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_BINARYXMLFORMAT_H
+#define NUCLEX_STORAGE_XML_BINARYXMLFORMAT_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint64_t, std::int64_t
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Layout of the binary XML documents written by the binary XML writer</summary>
+  /// <remarks>
+  ///   <para>
+  ///     A document begins with the four signature bytes followed by the format version.
+  ///     After that, it is a flat sequence of tokens, each starting with one byte that
+  ///     holds the token type in its lower four bits and, for tokens carrying a value,
+  ///     the value type in its upper four bits.
+  ///   </para>
+  ///   <para>
+  ///     Element and attribute names are stored only once. A name reference of zero is
+  ///     followed by the length and bytes of a new name, which is assigned the next free
+  ///     index. Any other reference is the index of an earlier name plus one.
+  ///   </para>
+  ///   <para>
+  ///     All lengths and integers are stored as variable-length integers with 7 bits
+  ///     per byte, least significant group first. Signed integers are zigzag-encoded,
+  ///     floating point values are stored as little endian IEEE-754 bit patterns.
+  ///   </para>
+  /// </remarks>
+  class BinaryXmlFormat {
+
+    /// <summary>Bytes every binary XML document starts with</summary>
+    public: static const std::uint8_t Signature[4];
+
+    /// <summary>Version of the binary XML format written by this library</summary>
+    public: static const std::uint8_t Version = 1;
+
+    /// <summary>Most bytes a 64 bit integer can take up as variable-length integer</summary>
+    public: static const std::size_t MaximumVarIntByteCount = 10;
+
+    #pragma region enum Token
+
+    /// <summary>Kinds of tokens a binary XML document can contain</summary>
+    public: enum class Token : std::uint8_t {
+
+      /// <summary>Opens an element, followed by a name reference</summary>
+      ElementStart = 1,
+
+      /// <summary>Attribute of the element just opened, name reference and value</summary>
+      Attribute = 2,
+
+      /// <summary>Content of the current element, followed by a value</summary>
+      Content = 3,
+
+      /// <summary>Closes the current element</summary>
+      ElementEnd = 4
+
+    };
+
+    #pragma endregion // enum Token
+
+    #pragma region enum ValueType
+
+    /// <summary>Types of values attributes and element contents can have</summary>
+    public: enum class ValueType : std::uint8_t {
+
+      /// <summary>UTF-8 text, length followed by the characters</summary>
+      Text = 0,
+
+      /// <summary>Raw binary data, length followed by the bytes</summary>
+      Binary = 1,
+
+      /// <summary>Boolean value stored as a single byte</summary>
+      Boolean = 2,
+
+      /// <summary>Unsigned integer stored as variable-length integer</summary>
+      UnsignedInteger = 3,
+
+      /// <summary>Signed integer stored as zigzag-encoded variable-length integer</summary>
+      SignedInteger = 4,
+
+      /// <summary>Floating point value stored in 4 bytes</summary>
+      Float = 5,
+
+      /// <summary>Double precision floating point value stored in 8 bytes</summary>
+      Double = 6
+
+    };
+
+    #pragma endregion // enum ValueType
+
+    /// <summary>Combines a token and a value type into the byte introducing the token</summary>
+    /// <param name="token">Token that will be written</param>
+    /// <param name="valueType">Type of the value carried by the token</param>
+    /// <returns>The byte that introduces the token</returns>
+    public: static std::uint8_t GetTokenByte(Token token, ValueType valueType = ValueType::Text) {
+      return static_cast<std::uint8_t>(
+        static_cast<std::uint8_t>(token) | (static_cast<std::uint8_t>(valueType) << 4)
+      );
+    }
+
+    /// <summary>Extracts the token from the byte introducing a token</summary>
+    /// <param name="tokenByte">Byte that introduced the token</param>
+    /// <returns>The token introduced by the byte</returns>
+    public: static Token GetToken(std::uint8_t tokenByte) {
+      return static_cast<Token>(tokenByte & 0x0F);
+    }
+
+    /// <summary>Extracts the value type from the byte introducing a token</summary>
+    /// <param name="tokenByte">Byte that introduced the token</param>
+    /// <returns>The type of the value carried by the token</returns>
+    public: static ValueType GetValueType(std::uint8_t tokenByte) {
+      return static_cast<ValueType>(tokenByte >> 4);
+    }
+
+    /// <summary>Encodes an unsigned integer as variable-length integer</summary>
+    /// <param name="value">Value that will be encoded</param>
+    /// <param name="target">
+    ///   Buffer receiving the encoded integer, must have room for at least
+    ///   <see cref="MaximumVarIntByteCount" /> bytes
+    /// </param>
+    /// <returns>The number of bytes the encoded integer takes up</returns>
+    public: static std::size_t EncodeVarInt(std::uint64_t value, std::uint8_t *target) {
+      std::size_t byteCount = 0;
+      while(value >= 0x80) {
+        target[byteCount] = static_cast<std::uint8_t>(value | 0x80);
+        value >>= 7;
+        ++byteCount;
+      }
+      target[byteCount] = static_cast<std::uint8_t>(value);
+      return byteCount + 1;
+    }
+
+    /// <summary>Maps a signed integer to an unsigned one with small absolute values</summary>
+    /// <param name="value">Signed integer that will be mapped</param>
+    /// <returns>The zigzag-encoded integer</returns>
+    public: static std::uint64_t EncodeZigZag(std::int64_t value) {
+      return (
+        (static_cast<std::uint64_t>(value) << 1) ^
+        static_cast<std::uint64_t>(-static_cast<std::int64_t>(value < 0))
+      );
+    }
+
+    /// <summary>Restores a signed integer from its zigzag-encoded form</summary>
+    /// <param name="value">Zigzag-encoded integer that will be restored</param>
+    /// <returns>The original signed integer</returns>
+    public: static std::int64_t DecodeZigZag(std::uint64_t value) {
+      return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_BINARYXMLFORMAT_H
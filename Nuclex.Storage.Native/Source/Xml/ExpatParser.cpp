@@ -24,14 +24,65 @@ License along with this library
 #include "ExpatParser.h"
 #include "Nuclex/Storage/Xml/XmlParseError.h"
 
+#include <Nuclex/Support/AllocationTracker.h> // for AllocationTracker
+
 #include <limits>
 
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocates memory for eXpat through the allocation tracker</summary>
+  /// <param name="byteCount">Number of bytes that will be allocated</param>
+  /// <returns>The allocated memory or a null pointer if the allocation failed</returns>
+  void *mallocTracked(std::size_t byteCount) {
+    return Nuclex::Support::AllocationTracker::Malloc(
+      Nuclex::Support::AllocationSubsystem::Xml, byteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Resizes memory eXpat allocated through the allocation tracker</summary>
+  /// <param name="memory">Memory that will be resized</param>
+  /// <param name="byteCount">New size of the memory in bytes</param>
+  /// <returns>The resized memory or a null pointer if the memory could not be resized</returns>
+  void *reallocTracked(void *memory, std::size_t byteCount) {
+    return Nuclex::Support::AllocationTracker::Realloc(
+      Nuclex::Support::AllocationSubsystem::Xml, memory, byteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Frees memory eXpat allocated through the allocation tracker</summary>
+  /// <param name="memory">Memory that will be freed</param>
+  void freeTracked(void *memory) {
+    Nuclex::Support::AllocationTracker::Free(
+      Nuclex::Support::AllocationSubsystem::Xml, memory
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory management functions handed to eXpat</summary>
+  const ::XML_Memory_Handling_Suite trackedMemorySuite = {
+    &mallocTracked, &reallocTracked, &freeTracked
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
 namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
   ExpatParser::ExpatParser(const std::string &charset) :
-    parser(::XML_ParserCreate(charset.c_str()), &::XML_ParserFree),
+    parser(
+      ::XML_ParserCreate_MM(charset.c_str(), &trackedMemorySuite, nullptr),
+      &::XML_ParserFree
+    ),
     errorCode(XML_ERROR_NONE) {
     if(this->parser.get() == nullptr) {
       throw std::runtime_error("Could not initialize eXpat XML parser");
@@ -66,6 +117,16 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void ExpatParser::Reset(const std::string &charset) {
+    if(::XML_ParserReset(this->parser.get(), charset.c_str()) == XML_FALSE) {
+      throw std::runtime_error("Could not reset eXpat XML parser");
+    }
+
+    this->errorCode = XML_ERROR_NONE;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void *ExpatParser::GetBuffer(std::size_t length) {
     const std::size_t intMax = static_cast<std::size_t>(std::numeric_limits<int>::max());
     if(length > intMax) {
@@ -95,4 +156,38 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
+  XML_Status ExpatParser::Parse(const void *data, std::size_t length, bool isFinal) {
+    const std::size_t intMax = static_cast<std::size_t>(std::numeric_limits<int>::max());
+    if(length > intMax) {
+      throw std::logic_error("Amount of data to parse is too large");
+    }
+
+    XML_Status status = ::XML_Parse(
+      this->parser.get(), static_cast<const char *>(data), static_cast<int>(length),
+      isFinal ? XML_TRUE : XML_FALSE
+    );
+    if(status == XML_STATUS_ERROR) {
+      recordError();
+    }
+
+    return status;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ExpatParserPool::Lease ExpatParserPool::Rent() {
+    static Support::Collections::ConcurrentObjectPool<ExpatParser> pool;
+
+    Lease parser = pool.TryTake();
+    if(parser) {
+      parser->Reset();
+    } else {
+      parser = pool.Take();
+    }
+
+    return parser;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Storage::Xml
@@ -25,6 +25,10 @@ License along with this library
 
 #include "ExpatApi.h"
 
+#include "Nuclex/Support/Collections/ConcurrentObjectPool.h"
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <memory>
 
@@ -82,6 +86,22 @@ namespace Nuclex { namespace Storage { namespace Xml {
       ::XML_SetCharacterDataHandler(this->parser.get(), handler);
     }
 
+    /// <summary>Determines where the event currently being reported begins</summary>
+    /// <returns>The offset of the current event from the start of the parsed data</returns>
+    public: std::uint64_t GetCurrentByteIndex() const {
+      return static_cast<std::uint64_t>(::XML_GetCurrentByteIndex(this->parser.get()));
+    }
+
+    /// <summary>Determines how many bytes the event currently being reported covers</summary>
+    /// <returns>The number of bytes covered by the current event</returns>
+    /// <remarks>
+    ///   Zero for the end of an empty element (&lt;tag /&gt;) because its start
+    ///   already covered the whole tag.
+    /// </remarks>
+    public: std::size_t GetCurrentByteCount() const {
+      return static_cast<std::size_t>(::XML_GetCurrentByteCount(this->parser.get()));
+    }
+
     /// <summary>Pauses or aborts the parser</summary>
     /// <param name="resumable">Whether the parser can be resumed later</param>
     /// <returns>The status reported by the eXpat parser</returns>
@@ -107,6 +127,13 @@ namespace Nuclex { namespace Storage { namespace Xml {
       return status;
     }
 
+    /// <summary>Prepares the parser for parsing another document</summary>
+    /// <remarks>
+    ///   Keeps the parser's memory, including the buffer, so it doesn't have to be set up
+    ///   again. The user data and all callbacks are cleared and need to be set again.
+    /// </remarks>
+    public: void Reset(const std::string &charset = "UTF-8");
+
     /// <summary>Allocates an internal buffer the parser will use</summary>
     /// <param name="length">Length of the buffer in bytes</param>
     public: void *GetBuffer(std::size_t length);
@@ -119,6 +146,18 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <returns>The status reported by the eXpat parser</returns>
     public: XML_Status ParseBuffer(std::size_t length, bool isFinal);
 
+    /// <summary>Parses data provided in memory owned by the caller</summary>
+    /// <param name="data">Data that will be parsed</param>
+    /// <param name="length">Number of bytes that will be parsed</param>
+    /// <param name="isFinal">Whether this call provides the final chunk of data</param>
+    /// <returns>The status reported by the eXpat parser</returns>
+    /// <remarks>
+    ///   eXpat builds without XML_CONTEXT_BYTES parse the data in place and only copy
+    ///   what is left over when the parser is suspended. Builds with it (the default)
+    ///   copy the data into the parser's buffer just like <see cref="GetBuffer" /> would.
+    /// </remarks>
+    public: XML_Status Parse(const void *data, std::size_t length, bool isFinal);
+
     /// <summary>Records the first error the parser has encountered</summary>
     private: void recordError() {
       if(this->errorCode == XML_ERROR_NONE) { // Only record the first error
@@ -142,6 +181,28 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Keeps idle eXpat parsers around so they can be reused</summary>
+  /// <remarks>
+  ///   Creating an eXpat parser allocates its hash tables, buffers and name pools,
+  ///   which costs more than parsing a small document. Parsers are shared by all threads
+  ///   and keep their memory between documents.
+  /// </remarks>
+  class ExpatParserPool {
+
+    /// <summary>Parser borrowed from the pool, returned when the lease is destroyed</summary>
+    public: typedef Support::Collections::ConcurrentObjectPool<ExpatParser>::Lease Lease;
+
+    /// <summary>Borrows an idle parser from the pool or creates a new one</summary>
+    /// <returns>A lease for a parser that is ready to parse a UTF-8 document</returns>
+    /// <remarks>
+    ///   The parser's user data and callbacks are cleared and need to be set again
+    /// </remarks>
+    public: static Lease Rent();
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Storage::Xml
 
 #endif // NUCLEX_STORAGE_XML_EXPATPARSER_H
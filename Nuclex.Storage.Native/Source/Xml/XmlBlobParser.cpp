@@ -0,0 +1,234 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlBlobParser.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include "ExpatParser.h"
+#include "XmlNameTable.h"
+
+#include "Nuclex/Support/Collections/SmallVector.h"
+
+#include <algorithm> // for std::min()
+#include <exception> // for std::exception_ptr
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::invalid_argument, std::out_of_range
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Forwards the callbacks of the eXpat parser to an XML handler</summary>
+  class HandlerAdapter {
+
+    /// <summary>Initializes a new handler adapter</summary>
+    /// <param name="parser">Parser whose callbacks will be forwarded</param>
+    /// <param name="handler">Handler the callbacks will be forwarded to</param>
+    public: HandlerAdapter(
+      Nuclex::Storage::Xml::ExpatParser &parser, Nuclex::Storage::Xml::XmlHandler &handler
+    ) :
+      parser(parser),
+      handler(handler),
+      names(),
+      attributes(),
+      error() {
+      parser.SetUserData(static_cast<void *>(this));
+      parser.SetElementHandler(
+        &HandlerAdapter::elementStartEncountered, &HandlerAdapter::elementEndEncountered
+      );
+      parser.SetCharacterDataHandler(&HandlerAdapter::textEncountered);
+    }
+
+    /// <summary>Rethrows the exception a handler callback threw, if any</summary>
+    public: void RethrowHandlerError() const {
+      if(this->error) {
+        std::rethrow_exception(this->error);
+      }
+    }
+
+    /// <summary>Callback for when eXpat encounters an opening element</summary>
+    /// <param name="adapter">Handler adapter the callback is for</param>
+    /// <param name="name">Name of the element</param>
+    /// <param name="attributes">Zero-terminated list of attribute names and values</param>
+    private: static void elementStartEncountered(
+      void *adapter, const char *name, const char **attributes
+    ) {
+      HandlerAdapter &self = *static_cast<HandlerAdapter *>(adapter);
+      if(self.error) {
+        return;
+      }
+
+      try {
+        const std::string &internedName = self.names.Intern(name);
+
+        self.attributes.Clear();
+        if(attributes != nullptr) {
+          while(*attributes != nullptr) {
+            Nuclex::Storage::Xml::XmlHandler::Attribute &attribute = self.attributes.Emplace();
+            attribute.Name = &self.names.Intern(*attributes);
+            attribute.Value = *(attributes + 1);
+            attributes += 2;
+          }
+        }
+
+        self.handler.ElementStarted(
+          internedName, self.attributes.Access(), self.attributes.Count()
+        );
+      }
+      catch(...) {
+        self.fail();
+      }
+    }
+
+    /// <summary>Callback for when eXpat encounters a closing element</summary>
+    /// <param name="adapter">Handler adapter the callback is for</param>
+    /// <param name="name">Name of the element</param>
+    private: static void elementEndEncountered(void *adapter, const char *name) {
+      HandlerAdapter &self = *static_cast<HandlerAdapter *>(adapter);
+      if(self.error) {
+        return;
+      }
+
+      try {
+        self.handler.ElementEnded(self.names.Intern(name));
+      }
+      catch(...) {
+        self.fail();
+      }
+    }
+
+    /// <summary>Callback for when eXpat encounters text</summary>
+    /// <param name="adapter">Handler adapter the callback is for</param>
+    /// <param name="text">Text that has been encountered, not zero-terminated</param>
+    /// <param name="length">Length of the text in bytes</param>
+    private: static void textEncountered(void *adapter, const char *text, int length) {
+      HandlerAdapter &self = *static_cast<HandlerAdapter *>(adapter);
+      if(self.error) {
+        return;
+      }
+
+      try {
+        self.handler.TextEncountered(text, static_cast<std::size_t>(length));
+      }
+      catch(...) {
+        self.fail();
+      }
+    }
+
+    /// <summary>Records the exception being handled and aborts the parser</summary>
+    /// <remarks>
+    ///   Exceptions must not travel through eXpat's C code, so they are kept until
+    ///   the parser has returned and then rethrown.
+    /// </remarks>
+    private: void fail() {
+      this->error = std::current_exception();
+
+      bool resumable = false;
+      this->parser.StopParser(resumable);
+    }
+
+    /// <summary>Parser whose callbacks are being forwarded</summary>
+    private: Nuclex::Storage::Xml::ExpatParser &parser;
+    /// <summary>Handler the callbacks are forwarded to</summary>
+    private: Nuclex::Storage::Xml::XmlHandler &handler;
+    /// <summary>Interned copies of all element and attribute names encountered</summary>
+    private: Nuclex::Storage::Xml::XmlNameTable names;
+    /// <summary>Attributes of the element being reported</summary>
+    private: Nuclex::Support::Collections::SmallVector<
+      Nuclex::Storage::Xml::XmlHandler::Attribute, 16
+    > attributes;
+    /// <summary>Exception thrown by the handler, if any</summary>
+    private: std::exception_ptr error;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobParser::Parse(
+    const Blob &blob, XmlHandler &handler, std::size_t chunkByteCount /* = 65536 */
+  ) {
+    Parse(blob, 0, blob.GetSize(), handler, chunkByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobParser::Parse(
+    const Blob &blob, std::uint64_t startOffset, std::uint64_t byteCount,
+    XmlHandler &handler, std::size_t chunkByteCount /* = 65536 */
+  ) {
+    if(chunkByteCount == 0) {
+      throw std::invalid_argument("Chunk size for XML parsing must not be zero");
+    }
+
+    std::uint64_t blobLength = blob.GetSize();
+    if((startOffset > blobLength) || (byteCount > blobLength - startOffset)) {
+      throw std::out_of_range("Section of XML to parse lies outside of the blob");
+    }
+
+    // If the whole range is available in memory, hand its memory to the parser as-is
+    const std::uint8_t *contents = nullptr;
+    if(byteCount <= std::numeric_limits<std::size_t>::max()) {
+      contents = blob.TryGetContiguousSpan(startOffset, static_cast<std::size_t>(byteCount));
+    }
+
+    ExpatParserPool::Lease parser = ExpatParserPool::Rent();
+    HandlerAdapter adapter(*parser, handler);
+
+    std::uint64_t position = 0;
+    XML_Status status;
+    do {
+      std::size_t length = static_cast<std::size_t>(
+        std::min<std::uint64_t>(chunkByteCount, byteCount - position)
+      );
+      bool isFinal = (position + length >= byteCount);
+
+      if(contents != nullptr) {
+        status = parser->Parse(contents + position, length, isFinal);
+      } else {
+        void *buffer = parser->GetBuffer(length);
+        if(buffer == nullptr) {
+          throw std::runtime_error("eXpat failed to allocate a buffer for XML parsing");
+        }
+
+        blob.ReadAt(startOffset + position, buffer, length);
+        status = parser->ParseBuffer(length, isFinal);
+      }
+
+      position += length;
+    } while((status == XML_STATUS_OK) && (position < byteCount));
+
+    // An exception from the handler is what aborted the parser, so it's more useful
+    // to report than the parse error eXpat records for being aborted
+    adapter.RethrowHandlerError();
+    parser->ThrowIfErrorRecorded();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
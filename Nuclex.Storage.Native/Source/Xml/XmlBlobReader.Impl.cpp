@@ -23,8 +23,15 @@ License along with this library
 
 #include "XmlBlobReader.Impl.h"
 #include "Nuclex/Storage/Blob.h"
+#include "../Helpers/BinaryEncoding.h"
 
-#include <algorithm>
+#include <Nuclex/Support/AllocationTracker.h> // for AllocationTracker
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_COUNT()
+
+#include <algorithm> // for std::min()
+#include <cstring> // for std::strlen()
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::invalid_argument, std::runtime_error
 
 namespace {
 
@@ -43,22 +50,175 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Capacity of a string that has not allocated any memory yet</summary>
+  const std::string::size_type EmptyStringCapacity = std::string().capacity();
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the memory of a string that is about to be destroyed as freed</summary>
+  /// <param name="target">String that will be destroyed</param>
+  void countStringFree(const std::string &target) {
+    if(target.capacity() > EmptyStringCapacity) {
+      Nuclex::Support::AllocationTracker::RecordFree(
+        Nuclex::Support::AllocationSubsystem::Xml, target.capacity() + 1
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Assigns text to a string and counts any memory it had to allocate</summary>
+  /// <param name="target">String the text will be assigned to</param>
+  /// <param name="text">Text that will be assigned to the string</param>
+  /// <param name="length">Length of the text in bytes</param>
+  /// <remarks>
+  ///   The reader's strings are reused for each event, so after the first few elements
+  ///   this should not count anything. If it does, something is copying per event.
+  /// </remarks>
+  void assignCounted(std::string &target, const char *text, std::size_t length) {
+    std::string::size_type previousCapacity = target.capacity();
+    target.assign(text, static_cast<std::string::size_type>(length));
+
+    if(target.capacity() != previousCapacity) {
+      if(previousCapacity > EmptyStringCapacity) {
+        Nuclex::Support::AllocationTracker::RecordFree(
+          Nuclex::Support::AllocationSubsystem::Xml, previousCapacity + 1
+        );
+      }
+      Nuclex::Support::AllocationTracker::RecordAllocation(
+        Nuclex::Support::AllocationSubsystem::Xml, target.capacity() + 1
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
-  const std::size_t XmlBlobReader::Impl::BufferSize = 4096;
+  XmlBlobReader::Impl::Impl(
+    const Blob &blob,
+    std::uint64_t startPosition, std::uint64_t endPosition,
+    std::size_t chunkByteCount
+  ) :
+    blob(nullptr),
+    startPosition(0),
+    endPosition(0),
+    position(0),
+    chunkByteCount(chunkByteCount),
+    contents(nullptr),
+    stream(nullptr),
+    isStreamEnded(false),
+    isSuspended(false),
+    elementEndOutstanding(false),
+    name(nullptr),
+    attributeCount(0) {
+
+    if(chunkByteCount == 0) {
+      throw std::invalid_argument("Chunk size for XML parsing must not be zero");
+    }
+
+    begin(blob, startPosition, endPosition);
+  }
 
   // ------------------------------------------------------------------------------------------- //
 
-  XmlBlobReader::Impl::Impl(const Blob &blob) :
-    blob(blob),
-    blobLength(blob.GetSize()),
+  XmlBlobReader::Impl::Impl(Binary::InputStream &stream, std::size_t chunkByteCount) :
+    blob(nullptr),
+    startPosition(0),
+    endPosition(0),
     position(0),
+    chunkByteCount(chunkByteCount),
+    contents(nullptr),
+    stream(nullptr),
+    isStreamEnded(false),
     isSuspended(false),
-    elementEndOutstanding(false) {
+    elementEndOutstanding(false),
+    name(nullptr),
+    attributeCount(0) {
+
+    if(chunkByteCount == 0) {
+      throw std::invalid_argument("Chunk size for XML parsing must not be zero");
+    }
+
+    begin(stream);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  XmlBlobReader::Impl::~Impl() {
+    for(std::size_t index = 0; index < this->attributes.Count(); ++index) {
+      countStringFree(this->attributes[index].Value);
+    }
+    countStringFree(this->text);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobReader::Impl::Reset(
+    const Blob &blob, std::uint64_t startPosition, std::uint64_t endPosition
+  ) {
+    this->parser.Reset();
+    begin(blob, startPosition, endPosition);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobReader::Impl::Reset(Binary::InputStream &stream) {
+    this->parser.Reset();
+    begin(stream);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobReader::Impl::begin(
+    const Blob &blob, std::uint64_t startPosition, std::uint64_t endPosition
+  ) {
+    this->blob = &blob;
+    this->startPosition = startPosition;
+    this->endPosition = endPosition;
+    this->position = startPosition;
+    this->stream = nullptr;
+    this->isStreamEnded = false;
+
+    // If the whole range is available in memory, we can spare ourselves from copying
+    // each chunk out of it and hand its memory to the parser as-is
+    this->contents = nullptr;
+    std::uint64_t length = endPosition - startPosition;
+    if(length <= std::numeric_limits<std::size_t>::max()) {
+      this->contents = blob.TryGetContiguousSpan(
+        startPosition, static_cast<std::size_t>(length)
+      );
+    }
+
+    beginDocument();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobReader::Impl::begin(Binary::InputStream &stream) {
+    this->blob = nullptr;
+    this->startPosition = 0;
+    this->endPosition = 0;
+    this->position = 0;
+    this->contents = nullptr;
+    this->stream = &stream;
+    this->isStreamEnded = false;
+
+    beginDocument();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobReader::Impl::beginDocument() {
+    this->isSuspended = false;
+    this->elementEndOutstanding = false;
+    this->name = &this->names.Intern("");
+    this->attributeCount = 0;
+    this->text.clear();
 
     this->parser.SetUserData(static_cast<void *>(this));
     this->parser.SetElementHandler(
@@ -70,10 +230,6 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
-  XmlBlobReader::Impl::~Impl() {}
-
-  // ------------------------------------------------------------------------------------------- //
-
   XmlReadEvent XmlBlobReader::Impl::Read() {
     this->parser.ThrowIfErrorRecorded();
 
@@ -81,7 +237,7 @@ namespace Nuclex { namespace Storage { namespace Xml {
     // to pause in elementStartEncountered(), forward the element end notification first
     if(this->elementEndOutstanding) {
       this->elementEndOutstanding = false;
-      this->attributes.clear();
+      this->attributeCount = 0;
       return XmlReadEvent::ElementEnd;
     }
 
@@ -104,6 +260,52 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void XmlBlobReader::Impl::ReadBinary(
+    XmlBinaryFormat format, const std::string *attributeValue,
+    std::uint8_t *target, std::size_t byteCount
+  ) {
+    if(format == XmlBinaryFormat::Base64) {
+      readBinary<Helpers::Base64Decoder>(attributeValue, target, byteCount);
+    } else {
+      readBinary<Helpers::HexDecoder>(attributeValue, target, byteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TDecoder>
+  void XmlBlobReader::Impl::readBinary(
+    const std::string *attributeValue, std::uint8_t *target, std::size_t byteCount
+  ) {
+    TDecoder decoder;
+
+    std::size_t written;
+    if(attributeValue != nullptr) {
+      written = decoder.Decode(
+        attributeValue->data(), attributeValue->length(), target, byteCount
+      );
+    } else {
+      written = decoder.Decode(this->text.data(), this->text.length(), target, byteCount);
+
+      // The decoders write straight into the caller's buffer, so all we need to do for
+      // text eXpat reported in pieces is to keep parsing and decode each piece
+      while((written < byteCount) || !decoder.IsComplete()) {
+        if(Read() != XmlReadEvent::Content) {
+          break;
+        }
+        written += decoder.Decode(
+          this->text.data(), this->text.length(), target + written, byteCount - written
+        );
+      }
+    }
+
+    if((written != byteCount) || !decoder.IsComplete()) {
+      throw std::runtime_error("Encoded binary data is shorter than expected");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   XML_Status XmlBlobReader::Impl::parseNextChunk() {
     XML_Status status;
 
@@ -111,10 +313,23 @@ namespace Nuclex { namespace Storage { namespace Xml {
       if(this->isSuspended) {
         this->isSuspended = false;
         status = this->parser.ResumeParser();
+      } else if(this->stream != nullptr) {
+        status = parseNextStreamChunk();
       } else {
         std::size_t length = static_cast<std::size_t>(
-          std::min<std::uint64_t>(BufferSize, this->blobLength - this->position)
+          std::min<std::uint64_t>(this->chunkByteCount, this->endPosition - this->position)
         );
+        NUCLEX_SUPPORT_INSTRUMENT_COUNT(u8"Nuclex.Storage.XmlBlobReader.BytesParsed", length);
+
+        // If the blob's memory is directly accessible, let eXpat parse straight from it.
+        // The memory stays valid while we hold the blob, so suspending the parser is fine.
+        if(this->contents != nullptr) {
+          const std::uint8_t *chunk = this->contents + (this->position - this->startPosition);
+          this->position += length;
+
+          status = this->parser.Parse(chunk, length, (this->position >= this->endPosition));
+          continue;
+        }
 
         // Ask eXpat for a buffer and fill it. According to the documentation, this
         // avoids an additional copy of the data (probably to ensure the pointer stays
@@ -125,32 +340,79 @@ namespace Nuclex { namespace Storage { namespace Xml {
             throw std::runtime_error("eXpat failed to allocate a buffer for XML parsing");
           }
 
-          this->blob.ReadAt(this->position, buffer, length);
+          this->blob->ReadAt(this->position, buffer, length);
           this->position += length;
         }
 
-        status = this->parser.ParseBuffer(length, (this->position >= this->blobLength));
+        status = this->parser.ParseBuffer(length, (this->position >= this->endPosition));
       }
-    } while((status == XML_STATUS_OK) && (this->position < this->blobLength));
+    } while((status == XML_STATUS_OK) && !isInputExhausted());
 
     return status;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  XML_Status XmlBlobReader::Impl::parseNextStreamChunk() {
+
+    // Spans acquired from the stream only stay valid until they are consumed, but
+    // a suspended parser may still refer to them, so data is always copied into
+    // the buffer eXpat manages
+    std::uint8_t *buffer = static_cast<std::uint8_t *>(
+      this->parser.GetBuffer(this->chunkByteCount)
+    );
+    if(buffer == nullptr) {
+      throw std::runtime_error("eXpat failed to allocate a buffer for XML parsing");
+    }
+
+    // Ask for whatever is available first. Only if that is nothing and the stream
+    // hasn't ended yet, wait for more data to arrive.
+    std::size_t length = this->chunkByteCount;
+    this->isStreamEnded = this->stream->ReadUpTo(buffer, length, 0);
+    if((length == 0) && !this->isStreamEnded) {
+      length = this->chunkByteCount;
+      try {
+        this->isStreamEnded = this->stream->ReadUpTo(buffer, length, 1);
+      }
+      catch(const std::runtime_error &) {
+
+        // Streams throw if they are closed while we wait for data. If they have
+        // ended cleanly, that just means the document is complete.
+        length = this->chunkByteCount;
+        this->isStreamEnded = this->stream->ReadUpTo(buffer, length, 0);
+        if(!this->isStreamEnded) {
+          throw;
+        }
+      }
+    }
+    this->position += length;
+    NUCLEX_SUPPORT_INSTRUMENT_COUNT(u8"Nuclex.Storage.XmlStreamReader.BytesParsed", length);
+
+    return this->parser.ParseBuffer(length, this->isStreamEnded);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   void XmlBlobReader::Impl::elementStartEncountered(
     const char *name,
     const char **firstAttribute, std::size_t attributeCount
   ) {
-    this->name.assign(name);
+    this->name = &this->names.Intern(name);
 
-    this->attributes.resize(attributeCount);
+    // The attribute list only ever grows, so once it has seen the largest element
+    // in the document, assigning the values reuses the strings' memory
+    if(this->attributes.Count() < attributeCount) {
+      this->attributes.Resize(attributeCount);
+    }
     for(std::size_t index = 0; index < attributeCount; ++index) {
-      this->attributes[index].first.assign(*firstAttribute);
+      this->attributes[index].Name = &this->names.Intern(*firstAttribute);
       ++firstAttribute;
-      this->attributes[index].second.assign(*firstAttribute);
+      assignCounted(
+        this->attributes[index].Value, *firstAttribute, std::strlen(*firstAttribute)
+      );
       ++firstAttribute;
     }
+    this->attributeCount = attributeCount;
 
     bool resumable = true;
     this->parser.StopParser(resumable);
@@ -167,8 +429,8 @@ namespace Nuclex { namespace Storage { namespace Xml {
       return;
     }
 
-    this->attributes.clear();
-    this->name.assign(name);
+    this->attributeCount = 0;
+    this->name = &this->names.Intern(name);
 
     bool resumable = true;
     this->parser.StopParser(resumable);
@@ -185,13 +447,13 @@ namespace Nuclex { namespace Storage { namespace Xml {
     }
 
     int firstCharacterIndex = 0;
-    while(IsWhitespace(text[firstCharacterIndex])) {
+    while((firstCharacterIndex < length) && IsWhitespace(text[firstCharacterIndex])) {
       ++firstCharacterIndex;
     }
 
     if(firstCharacterIndex < length) {
-      this->attributes.clear();
-      this->text.assign(text, static_cast<std::string::size_type>(length));
+      this->attributeCount = 0;
+      assignCounted(this->text, text, static_cast<std::size_t>(length));
 
       bool resumable = true;
       this->parser.StopParser(resumable);
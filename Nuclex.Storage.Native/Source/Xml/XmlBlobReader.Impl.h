@@ -22,9 +22,15 @@ License along with this library
 #define NUCLEX_STORAGE_XML_XMLBLOBREADER_IMPL_H
 
 #include "Nuclex/Storage/Xml/XmlBlobReader.h"
+#include "Nuclex/Storage/Xml/XmlBinaryFormat.h"
+#include "Nuclex/Storage/Binary/InputStream.h"
 #include "ExpatParser.h"
+#include "XmlNameTable.h"
 
-#include <vector>
+#include "Nuclex/Support/Collections/SmallVector.h"
+
+#include <stdexcept> // for std::out_of_range
+#include <string> // for std::string
 
 namespace Nuclex { namespace Storage { namespace Xml {
 
@@ -33,27 +39,52 @@ namespace Nuclex { namespace Storage { namespace Xml {
   /// <summary>Reads data using the XML format</summary>
   class XmlBlobReader::Impl {
 
-    /// <summary>Amount of data handed to the parser at once</summary>
-    private: static const std::size_t BufferSize;
-
     /// <summary>Initializes a new XML blob reader implementation</summary>
     /// <param name="blob">Blob of plaintext XML the XML blog reader will parse</param>
-    public: Impl(const Blob &blob);
+    /// <param name="startPosition">Offset in the blob at which parsing begins</param>
+    /// <param name="endPosition">Offset in the blob at which parsing ends</param>
+    /// <param name="chunkByteCount">Amount of data handed to the parser at once</param>
+    public: Impl(
+      const Blob &blob,
+      std::uint64_t startPosition, std::uint64_t endPosition,
+      std::size_t chunkByteCount
+    );
+
+    /// <summary>Initializes a new XML reader implementation parsing a stream</summary>
+    /// <param name="stream">Stream of plaintext XML the XML reader will parse</param>
+    /// <param name="chunkByteCount">Amount of data handed to the parser at once</param>
+    public: Impl(Binary::InputStream &stream, std::size_t chunkByteCount);
 
     /// <summary>Destroys the XML blob reader implementation</summary>
     public: ~Impl();
 
+    /// <summary>Starts over, parsing a different range of plaintext XML</summary>
+    /// <param name="blob">Blob of plaintext XML the XML blog reader will parse</param>
+    /// <param name="startPosition">Offset in the blob at which parsing begins</param>
+    /// <param name="endPosition">Offset in the blob at which parsing ends</param>
+    /// <remarks>
+    ///   The eXpat parser, its buffer and the interned names are kept, so parsing
+    ///   many small documents doesn't pay for setting them up each time.
+    /// </remarks>
+    public: void Reset(
+      const Blob &blob, std::uint64_t startPosition, std::uint64_t endPosition
+    );
+
+    /// <summary>Starts over, parsing plaintext XML from a different stream</summary>
+    /// <param name="stream">Stream of plaintext XML the XML reader will parse</param>
+    public: void Reset(Binary::InputStream &stream);
+
     /// <summary>Reads from XML plaintext up until the next event is encountered</summary>
     /// <returns>The type of event encountered when parsing</returns>
     public: XmlReadEvent Read();
 
     /// <summary>Retrieves the name of the last element that was entered or exited</summary>
     /// <returns>The name of the last element entered or exited</returns>
-    public: const std::string &GetElementName() const { return this->name; }
+    public: const std::string &GetElementName() const { return *this->name; }
 
     /// <summary>Counts the number of attributes in the current element</summary>
     /// <returns>The number of attributes present in the current element</summary>
-    public: std::size_t CountAttributes() const { return this->attributes.size(); }
+    public: std::size_t CountAttributes() const { return this->attributeCount; }
 
     /// <summary>Retrieves the text in the element currently entered</summary>
     /// <returns>The text in the element currently entered</returns>
@@ -63,9 +94,22 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <param name="attributeName">Name of the attribute whose value will be retrieved</param>
     /// <returns>The value of the requested attribute or null if it doesn't exist</returns>
     public: const std::string *GetAttributeValue(const std::string &attributeName) const {
-      for(std::size_t index = 0; index < this->attributes.size(); ++index) {
-        if(this->attributes[index].first == attributeName) {
-          return &this->attributes[index].second;
+
+      // If the caller passed us an interned name, we can skip hashing it
+      for(std::size_t index = 0; index < this->attributeCount; ++index) {
+        if(this->attributes[index].Name == &attributeName) {
+          return &this->attributes[index].Value;
+        }
+      }
+
+      const std::string *interned = this->names.TryGet(attributeName.c_str());
+      if(interned == nullptr) {
+        return nullptr; // Name never appeared in the document, so no attribute can have it
+      }
+
+      for(std::size_t index = 0; index < this->attributeCount; ++index) {
+        if(this->attributes[index].Name == interned) {
+          return &this->attributes[index].Value;
         }
       }
 
@@ -76,13 +120,109 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <param name="index">Index of the attribue whose name will be retrieved</param>
     /// <returns>The name of the attribue with the specified index</returns>
     public: const std::string &GetAttributeName(std::size_t index) const {
-      return this->attributes.at(index).first;
+      return *getAttribute(index).Name;
+    }
+
+    /// <summary>Retrieves the value of the attribue with the specified index</summary>
+    /// <param name="index">Index of the attribue whose value will be retrieved</param>
+    /// <returns>The value of the attribue with the specified index</returns>
+    public: const std::string &GetAttributeValue(std::size_t index) const {
+      return getAttribute(index).Value;
+    }
+
+    /// <summary>Looks up the interned copy of an element or attribute name</summary>
+    /// <param name="name">Name whose interned copy will be looked up</param>
+    /// <returns>The interned copy of the name</returns>
+    public: const std::string &InternName(const std::string &name) {
+      return this->names.Intern(name.c_str());
     }
 
+    /// <summary>Decodes binary data from an attribute or the element's text</summary>
+    /// <param name="format">Format the binary data has been encoded in</param>
+    /// <param name="attributeValue">
+    ///   Value of the entered attribute or null to decode the element's text
+    /// </param>
+    /// <param name="target">Buffer that will receive the decoded bytes</param>
+    /// <param name="byteCount">Number of bytes that will be decoded</param>
+    /// <remarks>
+    ///   Long element text is reported by eXpat in several pieces (at least one per
+    ///   line). When decoding the element's text, the parser is advanced over further
+    ///   pieces until all requested bytes have been decoded.
+    /// </remarks>
+    public: void ReadBinary(
+      XmlBinaryFormat format, const std::string *attributeValue,
+      std::uint8_t *target, std::size_t byteCount
+    );
+
+    /// <summary>Name and value of an attribute</summary>
+    private: struct Attribute {
+
+      /// <summary>Interned name of the attribute</summary>
+      public: const std::string *Name;
+      /// <summary>Value assigned to the attribute</summary>
+      public: std::string Value;
+
+    };
+
+    /// <summary>Retrieves the attribute with the specified index</summary>
+    /// <param name="index">Index of the attribute that will be retrieved</param>
+    /// <returns>The attribute with the specified index</returns>
+    private: const Attribute &getAttribute(std::size_t index) const {
+      if(index >= this->attributeCount) {
+        throw std::out_of_range("Attribute index out of range");
+      }
+      return this->attributes[index];
+    }
+
+    /// <summary>Decodes binary data using the specified decoder</summary>
+    /// <typeparam name="TDecoder">Decoder that will be used to decode the text</typeparam>
+    /// <param name="attributeValue">
+    ///   Value of the entered attribute or null to decode the element's text
+    /// </param>
+    /// <param name="target">Buffer that will receive the decoded bytes</param>
+    /// <param name="byteCount">Number of bytes that will be decoded</param>
+    private: template<typename TDecoder>
+    void readBinary(
+      const std::string *attributeValue, std::uint8_t *target, std::size_t byteCount
+    );
+
+    /// <summary>Points the reader at the range it will parse</summary>
+    /// <param name="blob">Blob of plaintext XML the XML blog reader will parse</param>
+    /// <param name="startPosition">Offset in the blob at which parsing begins</param>
+    /// <param name="endPosition">Offset in the blob at which parsing ends</param>
+    private: void begin(
+      const Blob &blob, std::uint64_t startPosition, std::uint64_t endPosition
+    );
+
+    /// <summary>Points the reader at the stream it will parse</summary>
+    /// <param name="stream">Stream of plaintext XML the XML reader will parse</param>
+    private: void begin(Binary::InputStream &stream);
+
+    /// <summary>Clears the state left over from a previous document</summary>
+    private: void beginDocument();
+
     /// <summary>Reads the next chunk of data from the blob and parses it</summary>
     /// <returns>The status of the XML parser</returns>    
     private: XML_Status parseNextChunk();
 
+    /// <summary>Reads whatever data the stream can provide and parses it</summary>
+    /// <returns>The status of the XML parser</returns>
+    /// <remarks>
+    ///   Only waits for the stream if it has no data at all, so the XML that has already
+    ///   arrived is parsed while the rest is still being received or decompressed.
+    /// </remarks>
+    private: XML_Status parseNextStreamChunk();
+
+    /// <summary>Checks whether all input has been handed to the parser</summary>
+    /// <returns>True if the parser has seen the end of the blob or stream</returns>
+    private: bool isInputExhausted() const {
+      if(this->stream != nullptr) {
+        return this->isStreamEnded;
+      } else {
+        return (this->position >= this->endPosition);
+      }
+    }
+
     /// <summary>Called when eXpat encounters the start of an element</summary>
     /// <param name="name">Name of the elment whose start eXpat has encountered</param>
     /// <param name="firstAttribute">Start of the array containing the attribute names</param>
@@ -122,30 +262,46 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <param name="length">Lenght of the encountered text</param>
     private: static void textEncountered(void *impl, const char *text, int length);
 
-    /// <summary>Combines a name with a value stored as a string</summary>
-    typedef std::pair<std::string, std::string> NameValuePair;
-
     /// <summary>The expat parser used to walk through the XML elements</summary>
     private: ExpatParser parser;
     /// <summary>Whether the parser has been suspended</summary>
     private: bool isSuspended;
 
     /// <summary>From which which the parser reads and processes XML plaintext</summary>
-    private: const Blob &blob;
-    /// <summary>Length of the blob being parsed</summary>
-    private: std::uint64_t blobLength;
+    private: const Blob *blob;
+    /// <summary>Offset in the blob at which parsing began</summary>
+    private: std::uint64_t startPosition;
+    /// <summary>Offset in the blob at which parsing ends</summary>
+    private: std::uint64_t endPosition;
     /// <summary>Position of the parser within the blob</summary>
     private: std::uint64_t position;
+    /// <summary>Amount of data handed to the parser at once</summary>
+    private: std::size_t chunkByteCount;
+    /// <summary>Parsed range of the blob if it can provide it without copying</summary>
+    private: const std::uint8_t *contents;
+    /// <summary>Stream from which the parser reads if it isn't parsing a blob</summary>
+    private: Binary::InputStream *stream;
+    /// <summary>Whether the stream has reported its end</summary>
+    private: bool isStreamEnded;
 
     /// <summary>Lastmost read event that was encountered</summary>
     private: XmlReadEvent lastReadEvent;
     /// <summary>Whether the parser reported an element end after being suspended</summary>
     private: bool elementEndOutstanding;
-    /// <summary>Name of the current element</summary>
-    private: std::string name;
+    /// <summary>Interned copies of all element and attribute names encountered</summary>
+    private: XmlNameTable names;
+    /// <summary>Interned name of the current element</summary>
+    private: const std::string *name;
     /// <summary>Attributes in the current element</summary>
-    private: std::vector<NameValuePair> attributes;
-    /// <summary>Name of the current element</summary>
+    /// <remarks>
+    ///   Only the first <see cref="attributeCount" /> entries are in use. The rest are
+    ///   kept around so their strings can be reused without allocating memory again.
+    ///   Most elements have only a few attributes, which then live inside the reader.
+    /// </remarks>
+    private: Nuclex::Support::Collections::SmallVector<Attribute, 8> attributes;
+    /// <summary>Number of attributes in the current element</summary>
+    private: std::size_t attributeCount;
+    /// <summary>Text in the current element</summary>
     private: std::string text;
 
   };
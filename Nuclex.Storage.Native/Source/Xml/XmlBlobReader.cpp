@@ -26,20 +26,70 @@ License along with this library
 
 #include "XmlBlobReader.Impl.h"
 
-#include "../Helpers/StringHelper.h"
 #include "../Helpers/Lexical.h"
 
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+#include <Nuclex/Support/Text/StringConverter.h> // for StringConverter
+
+#include <stdexcept> // for std::out_of_range
+
 namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
-  XmlBlobReader::XmlBlobReader(const std::shared_ptr<const Blob> &blob) :
+  XmlBlobReader::XmlBlobReader(
+    const std::shared_ptr<const Blob> &blob, std::size_t chunkByteCount /* = 65536 */
+  ) :
     blob(blob),
-    impl(new Impl(*blob.get())),
+    impl(new Impl(*blob.get(), 0, blob->GetSize(), chunkByteCount)),
+    binaryFormat(XmlBinaryFormat::Base64),
     enteredAttribute(nullptr) {}
 
   // ------------------------------------------------------------------------------------------- //
 
+  XmlBlobReader::XmlBlobReader(
+    const std::shared_ptr<const Blob> &blob,
+    std::uint64_t startOffset, std::uint64_t byteCount,
+    std::size_t chunkByteCount /* = 65536 */
+  ) :
+    blob(blob),
+    impl(),
+    binaryFormat(XmlBinaryFormat::Base64),
+    enteredAttribute(nullptr) {
+
+    std::uint64_t blobLength = blob->GetSize();
+    if((startOffset > blobLength) || (byteCount > blobLength - startOffset)) {
+      throw std::out_of_range("Section of XML to read lies outside of the blob");
+    }
+
+    this->impl.reset(new Impl(*blob.get(), startOffset, startOffset + byteCount, chunkByteCount));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobReader::Reset(const std::shared_ptr<const Blob> &blob) {
+    this->impl->Reset(*blob.get(), 0, blob->GetSize());
+    this->blob = blob;
+    this->enteredAttribute = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobReader::Reset(
+    const std::shared_ptr<const Blob> &blob, std::uint64_t startOffset, std::uint64_t byteCount
+  ) {
+    std::uint64_t blobLength = blob->GetSize();
+    if((startOffset > blobLength) || (byteCount > blobLength - startOffset)) {
+      throw std::out_of_range("Section of XML to read lies outside of the blob");
+    }
+
+    this->impl->Reset(*blob.get(), startOffset, startOffset + byteCount);
+    this->blob = blob;
+    this->enteredAttribute = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   XmlBlobReader::~XmlBlobReader() {
     // Must be in the implementation file because the inlined version would not know
     // the destructor of our impl class!    
@@ -48,6 +98,7 @@ namespace Nuclex { namespace Storage { namespace Xml {
   // ------------------------------------------------------------------------------------------- //
 
   XmlReadEvent XmlBlobReader::Read() {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.XmlBlobReader.Read");
     return this->impl->Read();
   }
 
@@ -71,6 +122,18 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
+  const std::string &XmlBlobReader::GetAttributeValue(std::size_t index) const {
+    return this->impl->GetAttributeValue(index);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &XmlBlobReader::InternName(const std::string &name) {
+    return this->impl->InternName(name);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   bool XmlBlobReader::TryEnterAttribute(const std::string &attributeName) {
     this->enteredAttribute = this->impl->GetAttributeValue(attributeName);
     return (this->enteredAttribute != nullptr);
@@ -210,16 +273,19 @@ namespace Nuclex { namespace Storage { namespace Xml {
   
   void XmlBlobReader::Read(std::wstring &target) {
     if(this->enteredAttribute == nullptr) {
-      target = Helpers::StringHelper::WideCharFromUtf8(this->impl->GetElementText());
+      target = Support::Text::StringConverter::WideFromUtf8(this->impl->GetElementText());
     } else {
-      target = Helpers::StringHelper::WideCharFromUtf8(*this->enteredAttribute);
+      target = Support::Text::StringConverter::WideFromUtf8(*this->enteredAttribute);
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
   
   void XmlBlobReader::Read(void *buffer, std::size_t byteCount) {
-    throw std::runtime_error("Not implemented yet");
+    this->impl->ReadBinary(
+      this->binaryFormat, this->enteredAttribute,
+      static_cast<std::uint8_t *>(buffer), byteCount
+    );
   }
 
   // ------------------------------------------------------------------------------------------- //
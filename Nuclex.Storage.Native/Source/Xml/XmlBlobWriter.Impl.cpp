@@ -22,6 +22,54 @@ License along with this library
 #define NUCLEX_STORAGE_SOURCE 1
 
 #include "XmlBlobWriter.Impl.h"
+#include "../Helpers/BinaryEncoding.h"
+
+#include <algorithm> // for std::min()
+
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the entity that replaces a character in escaped XML</summary>
+  /// <param name="character">Character whose entity will be looked up</param>
+  /// <returns>The entity for the character or a null pointer if it needs none</returns>
+  const char *getEntity(char character) {
+    switch(character) {
+      case '<': { return u8"&lt;"; }
+      case '>': { return u8"&gt;"; }
+      case '&': { return u8"&amp;"; }
+      case '"': { return u8"&quot;"; }
+      default: { return nullptr; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+  /// <summary>Checks whether 16 characters contain any that need to be escaped</summary>
+  /// <param name="characters">Address of the characters that will be checked</param>
+  /// <returns>True if any of the characters needs to be replaced by an entity</returns>
+  bool containsSpecialCharacters(const char *characters) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters));
+    __m128i special = _mm_or_si128(
+      _mm_or_si128(
+        _mm_cmpeq_epi8(block, _mm_set1_epi8('<')), _mm_cmpeq_epi8(block, _mm_set1_epi8('>'))
+      ),
+      _mm_or_si128(
+        _mm_cmpeq_epi8(block, _mm_set1_epi8('&')), _mm_cmpeq_epi8(block, _mm_set1_epi8('"'))
+      )
+    );
+    return (_mm_movemask_epi8(special) != 0);
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
 
 namespace Nuclex { namespace Storage { namespace Xml {
 
@@ -31,11 +79,23 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
-  XmlBlobWriter::Impl::Impl(Blob &blob) :
+  XmlBlobWriter::Impl::Impl(Blob &blob, std::size_t writeBufferByteCount, bool compact) :
     blob(blob),
     location(0),
     attributesLength(0),
-    indentationLevel(0) {}
+    writeBufferByteCount(writeBufferByteCount),
+    indentationLevel(0),
+    compact(compact) {
+
+    // Finished lines are appended until the threshold is reached, after which the write
+    // buffer is emptied again, so it never has to grow beyond this plus one long line.
+    // In compact mode, the line buffer takes this role and the write buffer stays unused.
+    if(compact) {
+      this->buffer.reserve(writeBufferByteCount + TargetColumns);
+    } else {
+      this->writeBuffer.reserve(writeBufferByteCount + TargetColumns);
+    }
+  }
 
   // ------------------------------------------------------------------------------------------- //
 
@@ -59,7 +119,7 @@ namespace Nuclex { namespace Storage { namespace Xml {
     this->buffer.insert(this->buffer.end(), name.begin(), name.end());
 
     std::size_t length = this->indentationLevel + 1 + name.length() + attributesLength + 1;
-    if(this->attributes.empty() || (length < TargetColumns)) {
+    if(this->compact || this->attributes.empty() || (length < TargetColumns)) {
 
       // Append all attributes after the opener
       for(std::size_t index = 0; index < this->attributes.size(); ++index) {
@@ -104,14 +164,16 @@ namespace Nuclex { namespace Storage { namespace Xml {
     Append(name);
 
     std::size_t length = this->indentationLevel + 1 + name.length() + attributesLength + 3;
-    if(this->attributes.empty() || (length < TargetColumns)) {
+    if(this->compact || this->attributes.empty() || (length < TargetColumns)) {
 
       // Append all attributes after the opener
       for(std::size_t index = 0; index < this->attributes.size(); ++index) {
         AppendAttribute(this->attributes[index].first, this->attributes[index].second);
       }
 
-      this->buffer.push_back(' ');
+      if(!this->compact) {
+        this->buffer.push_back(' ');
+      }
 
     } else { // Line with attributes too long, split into multiple lines
 
@@ -169,6 +231,15 @@ namespace Nuclex { namespace Storage { namespace Xml {
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Impl::AppendText(const std::string &text) {
+    if(this->compact) {
+      std::size_t startIndex = text.find_first_not_of(Impl::Whitespace);
+      if(startIndex != std::string::npos) {
+        std::size_t lastIndex = text.find_last_not_of(Impl::Whitespace);
+        Append(text.data() + startIndex, text.data() + lastIndex + 1);
+      }
+      return;
+    }
+
     std::size_t targetColumns = TargetColumns - this->indentationLevel - 1;
 
     std::size_t startIndex = text.find_first_not_of(Impl::Whitespace);
@@ -219,4 +290,99 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void XmlBlobWriter::Impl::AppendBinary(
+    XmlBinaryFormat format, const std::uint8_t *data, std::size_t byteCount
+  ) {
+    if(this->compact) {
+      std::size_t start = this->buffer.size();
+      if(format == XmlBinaryFormat::Base64) {
+        this->buffer.resize(start + Helpers::BinaryEncoder::GetBase64Length(byteCount));
+        Helpers::BinaryEncoder::EncodeBase64(data, byteCount, this->buffer.data() + start);
+      } else {
+        this->buffer.resize(start + Helpers::BinaryEncoder::GetHexLength(byteCount));
+        Helpers::BinaryEncoder::EncodeHex(data, byteCount, this->buffer.data() + start);
+      }
+      return;
+    }
+
+    std::size_t targetColumns = TargetColumns - this->indentationLevel - 1;
+    if(targetColumns > TargetColumns) {
+      targetColumns = 0; // Indentation alone exceeds the target width
+    }
+
+    // Base-64 is written in whole groups of 4 characters, so only the last line
+    // of the data carries padding
+    std::size_t bytesPerLine;
+    if(format == XmlBinaryFormat::Base64) {
+      bytesPerLine = targetColumns / 4 * 3;
+    } else {
+      bytesPerLine = targetColumns / 2;
+    }
+    if(bytesPerLine < 3) {
+      bytesPerLine = 3;
+    }
+
+    for(;;) {
+      std::size_t lineByteCount = std::min(bytesPerLine, byteCount);
+
+      std::size_t lineStart = this->buffer.size();
+      if(format == XmlBinaryFormat::Base64) {
+        this->buffer.resize(lineStart + Helpers::BinaryEncoder::GetBase64Length(lineByteCount));
+        Helpers::BinaryEncoder::EncodeBase64(data, lineByteCount, &this->buffer[lineStart]);
+      } else {
+        this->buffer.resize(lineStart + Helpers::BinaryEncoder::GetHexLength(lineByteCount));
+        Helpers::BinaryEncoder::EncodeHex(data, lineByteCount, &this->buffer[lineStart]);
+      }
+
+      data += lineByteCount;
+      byteCount -= lineByteCount;
+      if(byteCount == 0) {
+        break;
+      }
+
+      FlushAndKeepIndentation();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobWriter::Impl::AppendEscaped(const std::string &text) {
+    const char *characters = text.data();
+    std::size_t length = text.length();
+
+    // Skip over runs without special characters and copy them in one piece
+    std::size_t runStart = 0;
+    std::size_t index = 0;
+    while(index < length) {
+      std::size_t blockEnd = length;
+#if defined(NUCLEX_STORAGE_HAVE_SSE2)
+      if(length - index >= 16) {
+        if(!containsSpecialCharacters(characters + index)) {
+          index += 16;
+          continue;
+        }
+        blockEnd = index + 16;
+      }
+#endif
+
+      // Either SSE2 spotted a special character in this block or we're at the tail
+      // end of the text, so look at the characters individually
+      for(; index < blockEnd; ++index) {
+        const char *entity = getEntity(characters[index]);
+        if(entity != nullptr) {
+          Append(characters + runStart, characters + index);
+          while(*entity != 0) {
+            this->buffer.push_back(*entity);
+            ++entity;
+          }
+          runStart = index + 1;
+        }
+      }
+    }
+
+    Append(characters + runStart, characters + length);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Storage::Xml
@@ -24,6 +24,7 @@ License along with this library
 #include "Nuclex/Storage/Config.h"
 #include "Nuclex/Storage/Xml/XmlBlobWriter.h"
 #include "Nuclex/Storage/Blob.h"
+#include "Nuclex/Storage/Xml/XmlBinaryFormat.h"
 
 namespace Nuclex { namespace Storage { namespace Xml {
 
@@ -37,6 +38,11 @@ namespace Nuclex { namespace Storage { namespace Xml {
   ///     line or whether to follow up with a line break and indentation increase to
   ///     split the current element into multiple lines.
   ///   </para>
+  ///   <para>
+  ///     In compact mode, the flush methods neither break lines nor indent. The line
+  ///     buffer then is the only buffer and simply grows until it reaches the write
+  ///     buffer threshold, at which point it is handed to the blob as a whole.
+  ///   </para>
   /// </remarks>
   class XmlBlobWriter::Impl {
 
@@ -51,7 +57,11 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
     /// <summary>Initializes a new XML writer writing into a blob</summary>
     /// <param name="blob">Blob the XML writer will write into</param>
-    public: Impl(Blob &blob);
+    /// <param name="writeBufferByteCount">
+    ///   Number of bytes that will be collected before they're written into the blob
+    /// </param>
+    /// <param name="compact">Whether to write the XML without any formatting</param>
+    public: Impl(Blob &blob, std::size_t writeBufferByteCount, bool compact);
     /// <summary>Destroys the XML reader</summary>
     public: ~Impl();
 
@@ -59,6 +69,10 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <returns>The current indentation level written text begins at</returns>
     public: std::size_t GetIndentationLevel() const { return this->indentationLevel; }
 
+    /// <summary>Checks whether the writer omits all formatting</summary>
+    /// <returns>True if the writer produces XML without line breaks or indentation</returns>
+    public: bool IsCompact() const { return this->compact; }
+
     /// <summary>Checks whether an XML element with content fits on a single line</summary>
     /// <param name="elementName">Name of the element carrying the content</param>
     /// <param name="contentLength">Length of the content the XML element will carry</param>
@@ -66,6 +80,10 @@ namespace Nuclex { namespace Storage { namespace Xml {
     public: bool IsElementShort(
       const std::string &elementName, const std::size_t contentLength
     ) {
+      if(this->compact) {
+        return true; // There are no lines in compact mode, so everything fits
+      }
+
       std::size_t length = this->indentationLevel;
       length += 1 + elementName.length() + 1;
       length += contentLength;
@@ -78,6 +96,10 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <param name="commentLength">Length of the comment that will be checked</param>
     /// <returns>True if the comments fits in a single single</returns>
     public: bool IsCommentShort(const std::size_t commentLength) {
+      if(this->compact) {
+        return true;
+      }
+
       std::size_t length = this->indentationLevel;
       length += 5 + commentLength + 4;
 
@@ -100,6 +122,16 @@ namespace Nuclex { namespace Storage { namespace Xml {
       this->attributesLength += lastAttribute.second.length();
     }
 
+    /// <summary>Sets the value of the most recently added attribute</summary>
+    /// <param name="value">Characters of the value the attribute will have</param>
+    /// <param name="end">Address one past the last character of the value</param>
+    public: void SetAttributeValue(const char *value, const char *end) {
+      NameValuePair &lastAttribute = this->attributes.back();
+      this->attributesLength -= lastAttribute.second.length();
+      lastAttribute.second.assign(value, end);
+      this->attributesLength += lastAttribute.second.length();
+    }
+
     /// <summary>Resets the attribue list</summary>
     public: void ClearAttributes() {
       this->attributes.clear();
@@ -136,6 +168,18 @@ namespace Nuclex { namespace Storage { namespace Xml {
     /// <param name="text">Text that will be appended to the XML element or comment</param>
     public: void AppendText(const std::string &text);
 
+    /// <summary>Appends encoded binary data to the current XML element</summary>
+    /// <param name="format">Format in which the binary data will be encoded</param>
+    /// <param name="data">Binary data that will be encoded and appended</param>
+    /// <param name="byteCount">Number of bytes that will be appended</param>
+    /// <remarks>
+    ///   The data is encoded straight into the line buffer, one line at a time, with
+    ///   the lines broken so they stay within the target width.
+    /// </remarks>
+    public: void AppendBinary(
+      XmlBinaryFormat format, const std::uint8_t *data, std::size_t byteCount
+    );
+
     /// <summary>Appends an attribute to the buffer</summary>
     /// <param name="name">Name of the attribute that will be appended</param>
     /// <param name="value">Value of the attribue that will be appended</param>
@@ -144,18 +188,48 @@ namespace Nuclex { namespace Storage { namespace Xml {
       this->buffer.insert(this->buffer.end(), name.begin(), name.end());
       this->buffer.push_back('=');
       this->buffer.push_back('"');
-      this->buffer.insert(this->buffer.end(), value.begin(), value.end());
+      AppendEscaped(value);
       this->buffer.push_back('"');
     }
 
+    /// <summary>Appends text with the XML special characters replaced by entities</summary>
+    /// <param name="text">Text that will be escaped and appended to the line buffer</param>
+    /// <remarks>
+    ///   The text is scanned for the characters &lt;, &gt;, &amp; and &quot; 16 bytes
+    ///   at a time where SSE2 is available. Runs without special characters, which is
+    ///   nearly all text, are copied into the line buffer in one piece.
+    /// </remarks>
+    public: void AppendEscaped(const std::string &text);
+
     /// <summary>Appends the specified string to the writer's line buffer</summary>
     /// <param name="text">Text that will be appended to the line buffer</param>
     public: void Append(const std::string &text) {
       this->buffer.insert(this->buffer.end(), text.begin(), text.end());
     }
 
+    /// <summary>Appends the specified characters to the writer's line buffer</summary>
+    /// <param name="text">Characters that will be appended to the line buffer</param>
+    /// <param name="end">Address one past the last character that will be appended</param>
+    public: void Append(const char *text, const char *end) {
+      this->buffer.insert(this->buffer.end(), text, end);
+    }
+
+    /// <summary>Writes all finished lines collected in the write buffer into the blob</summary>
+    public: void FlushWriteBuffer() {
+      if(this->compact) {
+        writeToBlob(this->buffer); // In compact mode, everything is in the line buffer
+      } else {
+        writeToBlob(this->writeBuffer);
+      }
+    }
+
     /// <summary>Flushes the line buffer into the blob</summary>
     public: void FlushAndKeepIndentation() {
+      if(this->compact) {
+        separateAndFlushIfFull();
+        return;
+      }
+
       appendReturnAndFlush();
 
       this->buffer.resize(this->indentationLevel);
@@ -165,6 +239,11 @@ namespace Nuclex { namespace Storage { namespace Xml {
     ///   Flushes the line buffer into the blob and increases the indentation level
     /// </summary>
     public: void FlushAndIncreaseIndentation() {
+      if(this->compact) {
+        separateAndFlushIfFull();
+        return;
+      }
+
       appendReturnAndFlush();
 
       std::size_t oldIndentationLevel = this->indentationLevel;
@@ -180,6 +259,11 @@ namespace Nuclex { namespace Storage { namespace Xml {
     ///   Flushes the line buffer into the blob and decreases the indentation level
     /// </summary>
     public: void FlushAndDecreaseIndentation() {
+      if(this->compact) {
+        flushIfFull(); // Closing tags never need to be kept apart
+        return;
+      }
+
       appendReturnAndFlush();
 
       if(this->indentationLevel == 0) {
@@ -196,24 +280,61 @@ namespace Nuclex { namespace Storage { namespace Xml {
     ///   the buffer and repeatedly calling it would append multiple line breaks.
     /// </remarks>
     private: void appendReturnAndFlush() {
-      std::size_t bufferSize = this->buffer.size();
-      if(bufferSize == this->indentationLevel) {
+      if(this->buffer.size() == this->indentationLevel) {
 
         // If the buffer is empty, write a blank line instead of an indented blank line
         // because trailing space characters a f-ugly.
-        this->blob.WriteAt(this->location, "\n", 1);
-        ++this->location;
+        this->writeBuffer.push_back('\n');
 
       } else {
 
         // Append a line break to increase the XML file's readability
         this->buffer.push_back('\n');
-        ++bufferSize;
+        this->writeBuffer.insert(
+          this->writeBuffer.end(), this->buffer.begin(), this->buffer.end()
+        );
 
-        // Write the contents of the buffer with the line break into the blob
-        this->blob.WriteAt(this->location, &this->buffer[0], this->buffer.size());
-        this->location += bufferSize;
+      }
 
+      // Lines are collected and handed to the blob in large chunks because each
+      // WriteAt() may well end up as a system call or a lock round trip.
+      if(this->writeBuffer.size() >= this->writeBufferByteCount) {
+        FlushWriteBuffer();
+      }
+    }
+
+    /// <summary>Keeps values apart and hands the buffer to the blob if full</summary>
+    /// <remarks>
+    ///   Where pretty-printed XML would break the line, two values may end up next to
+    ///   each other (for example two numbers written into the same element), so a single
+    ///   space is kept unless the buffer ends in markup already.
+    /// </remarks>
+    private: void separateAndFlushIfFull() {
+      if(!this->buffer.empty()) {
+        char last = this->buffer.back();
+        if((last != '>') && (last != ' ')) {
+          this->buffer.push_back(' ');
+        }
+      }
+
+      flushIfFull();
+    }
+
+    /// <summary>Hands the buffer to the blob in compact mode once it is full enough</summary>
+    private: void flushIfFull() {
+      if(this->buffer.size() >= this->writeBufferByteCount) {
+        writeToBlob(this->buffer);
+      }
+    }
+
+    /// <summary>Writes the contents of a buffer into the blob and clears it</summary>
+    /// <param name="buffer">Buffer whose contents will be written</param>
+    private: void writeToBlob(std::vector<char> &buffer) {
+      std::size_t bufferSize = buffer.size();
+      if(bufferSize > 0) {
+        this->blob.WriteAt(this->location, &buffer[0], bufferSize);
+        this->location += bufferSize;
+        buffer.clear();
       }
     }
 
@@ -235,8 +356,14 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
     /// <summary>Buffer in which lines are prepared before writing them</summary>
     private: std::vector<char> buffer;
+    /// <summary>Finished lines that have not been written into the blob yet</summary>
+    private: std::vector<char> writeBuffer;
+    /// <summary>Number of bytes after which the write buffer is written into the blob</summary>
+    private: std::size_t writeBufferByteCount;
     /// <summary>Current indentation level of the XML writer</summary>
     private: std::size_t indentationLevel;
+    /// <summary>Whether the XML is written without line breaks and indentation</summary>
+    private: bool compact;
 
   };
 
@@ -25,17 +25,23 @@ License along with this library
 #include "Nuclex/Storage/Blob.h"
 #include "XmlBlobWriter.Impl.h"
 
-#include "../Helpers/Lexical.h"
-#include "../Helpers/StringHelper.h"
+#include <Nuclex/Support/Text/Lexical.h> // for lexical_print()
+#include <Nuclex/Support/Text/StringConverter.h> // for StringConverter
+
+#include "../Helpers/BinaryEncoding.h"
 
 namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
-  XmlBlobWriter::XmlBlobWriter(const std::shared_ptr<Blob> &blob) :
+  XmlBlobWriter::XmlBlobWriter(
+    const std::shared_ptr<Blob> &blob,
+    std::size_t writeBufferByteCount /* = DefaultWriteBufferByteCount */,
+    bool compact /* = false */
+  ) :
     binaryFormat(XmlBinaryFormat::Base64),
     blob(blob),
-    impl(new Impl(*blob.get())),
+    impl(new Impl(*blob.get(), writeBufferByteCount, compact)),
     deferredToken(DeferredToken::None),
     isInAttribute(false),
     isInComment(false) {}
@@ -43,7 +49,25 @@ namespace Nuclex { namespace Storage { namespace Xml {
   // ------------------------------------------------------------------------------------------- //
 
   XmlBlobWriter::~XmlBlobWriter() {
-    this->impl->FlushAndKeepIndentation();
+    try {
+      this->impl->FlushAndKeepIndentation();
+      this->impl->FlushWriteBuffer();
+    }
+    catch(...) {
+      // Destructors must not throw. Callers who care call Flush() themselves.
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobWriter::Flush() {
+    this->impl->FlushWriteBuffer();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool XmlBlobWriter::IsCompact() const {
+    return this->impl->IsCompact();
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -185,133 +209,78 @@ namespace Nuclex { namespace Storage { namespace Xml {
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(bool value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(std::uint8_t value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(std::int8_t value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(std::uint16_t value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(std::int16_t value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(std::uint32_t value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(std::int32_t value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(std::uint64_t value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(std::int64_t value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(float value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(double value) {
-    if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::lexical_cast<std::string>(value));
-    } else if(this->isInComment) {
-      writeComment(Helpers::lexical_cast<std::string>(value));
-    } else {
-      writeData(Helpers::lexical_cast<std::string>(value));
-    }
+    char characters[Support::Text::MaximumLexicalPrintLength];
+    writeNumber(characters, Support::Text::lexical_print(value, characters));
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -330,18 +299,36 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   void XmlBlobWriter::Write(const std::wstring &value) {
     if(this->isInAttribute) {
-      this->impl->SetAttributeValue(Helpers::StringHelper::Utf8FromWideChar(value));
+      this->impl->SetAttributeValue(Support::Text::StringConverter::Utf8FromWide(value));
     } else if(this->isInComment) {
-      writeComment(Helpers::StringHelper::Utf8FromWideChar(value));
+      writeComment(Support::Text::StringConverter::Utf8FromWide(value));
     } else {
-      writeData(Helpers::StringHelper::Utf8FromWideChar(value));
+      writeData(Support::Text::StringConverter::Utf8FromWide(value));
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void XmlBlobWriter::Write(const void *buffer, std::size_t byteCount) {
-    throw std::runtime_error("Not implemented yet");
+    const std::uint8_t *data = static_cast<const std::uint8_t *>(buffer);
+    if(this->isInAttribute || this->isInComment) {
+      std::string encoded;
+      if(this->binaryFormat == XmlBinaryFormat::Base64) {
+        encoded.resize(Helpers::BinaryEncoder::GetBase64Length(byteCount));
+        Helpers::BinaryEncoder::EncodeBase64(data, byteCount, &encoded[0]);
+      } else {
+        encoded.resize(Helpers::BinaryEncoder::GetHexLength(byteCount));
+        Helpers::BinaryEncoder::EncodeHex(data, byteCount, &encoded[0]);
+      }
+
+      if(this->isInAttribute) {
+        this->impl->SetAttributeValue(encoded);
+      } else {
+        writeComment(encoded);
+      }
+    } else {
+      writeBinaryData(data, byteCount);
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -509,4 +496,116 @@ namespace Nuclex { namespace Storage { namespace Xml {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void XmlBlobWriter::writeBinaryData(const std::uint8_t *data, std::size_t byteCount) {
+    std::size_t encodedLength;
+    if(this->binaryFormat == XmlBinaryFormat::Base64) {
+      encodedLength = Helpers::BinaryEncoder::GetBase64Length(byteCount);
+    } else {
+      encodedLength = Helpers::BinaryEncoder::GetHexLength(byteCount);
+    }
+
+    switch(this->deferredToken) {
+
+      // Data that fits on the same line as the element is handled like any other
+      // short content. Anything longer is encoded straight into the line buffer.
+      case DeferredToken::ElementOpening: {
+        this->impl->AppendElementOpening(this->elementNames.top());
+
+        if(this->impl->IsElementShort(this->elementNames.top(), encodedLength)) {
+          this->content.resize(encodedLength);
+          if(encodedLength > 0) {
+            if(this->binaryFormat == XmlBinaryFormat::Base64) {
+              Helpers::BinaryEncoder::EncodeBase64(data, byteCount, &this->content[0]);
+            } else {
+              Helpers::BinaryEncoder::EncodeHex(data, byteCount, &this->content[0]);
+            }
+          }
+          this->deferredToken = DeferredToken::ElementOpeningWithContent;
+        } else {
+          this->impl->FlushAndIncreaseIndentation();
+          this->impl->AppendBinary(this->binaryFormat, data, byteCount);
+          this->deferredToken = DeferredToken::ElementChildren;
+        }
+
+        break;
+      }
+
+      case DeferredToken::ElementOpeningWithContent: {
+        this->impl->FlushAndIncreaseIndentation();
+        this->impl->Append(this->content);
+        this->content.clear();
+
+        this->impl->FlushAndKeepIndentation();
+        this->impl->AppendBinary(this->binaryFormat, data, byteCount);
+        this->deferredToken = DeferredToken::ElementChildren;
+
+        break;
+      }
+
+      case DeferredToken::ElementChildren: {
+        this->impl->FlushAndKeepIndentation();
+        this->impl->AppendBinary(this->binaryFormat, data, byteCount);
+
+        break;
+      }
+
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlBlobWriter::writeNumber(const char *characters, const char *end) {
+    if(this->isInAttribute) {
+      this->impl->SetAttributeValue(characters, end);
+      return;
+    }
+    if(this->isInComment) {
+      writeComment(std::string(characters, end));
+      return;
+    }
+
+    switch(this->deferredToken) {
+
+      // Numbers are short enough to always end up on the element's line unless
+      // the element is nested very deeply or has a very long name
+      case DeferredToken::ElementOpening: {
+        this->impl->AppendElementOpening(this->elementNames.top());
+
+        std::size_t length = static_cast<std::size_t>(end - characters);
+        if(this->impl->IsElementShort(this->elementNames.top(), length)) {
+          this->content.assign(characters, end);
+          this->deferredToken = DeferredToken::ElementOpeningWithContent;
+        } else {
+          this->impl->FlushAndIncreaseIndentation();
+          this->impl->Append(characters, end);
+          this->deferredToken = DeferredToken::ElementChildren;
+        }
+
+        break;
+      }
+
+      case DeferredToken::ElementOpeningWithContent: {
+        this->impl->FlushAndIncreaseIndentation();
+        this->impl->Append(this->content);
+        this->content.clear();
+
+        this->impl->FlushAndKeepIndentation();
+        this->impl->Append(characters, end);
+        this->deferredToken = DeferredToken::ElementChildren;
+
+        break;
+      }
+
+      case DeferredToken::ElementChildren: {
+        this->impl->FlushAndKeepIndentation();
+        this->impl->Append(characters, end);
+
+        break;
+      }
+
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Storage::Xml
@@ -0,0 +1,496 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlDocumentIndex.h"
+#include "Nuclex/Storage/Blob.h"
+
+#include "ExpatParser.h"
+#include "../Helpers/WorkerThreads.h"
+
+#include <Nuclex/Support/Text/InternedString.h> // for InternedString
+
+#include <algorithm> // for std::min()
+#include <condition_variable> // for std::condition_variable
+#include <exception> // for std::exception_ptr
+#include <limits> // for std::numeric_limits
+#include <mutex> // for std::mutex
+#include <stdexcept> // for std::out_of_range, std::invalid_argument, std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of parsed records per thread that may wait to be merged</summary>
+  const std::size_t PendingRecordsPerThread = 4;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hands out records to worker threads and merges their results in order</summary>
+  /// <remarks>
+  ///   Works like the block pipeline used for compression, but the results stay in
+  ///   a ring of slots owned by the caller. A record is only handed out once the result
+  ///   that previously occupied its slot has been merged.
+  /// </remarks>
+  class OrderedRecordPipeline {
+
+    /// <summary>Initializes a new pipeline for the specified number of records</summary>
+    /// <param name="recordCount">Number of records that will be parsed</param>
+    /// <param name="slotCount">Number of slots parsed records can wait in</param>
+    /// <param name="merge">Method that will be called to merge each record's result</param>
+    public: OrderedRecordPipeline(
+      std::size_t recordCount, std::size_t slotCount,
+      const std::function<void(std::size_t recordIndex)> &merge
+    ) :
+      recordCount(recordCount),
+      merge(merge),
+      nextRecordToClaim(0),
+      nextRecordToMerge(0),
+      isMerging(false),
+      completedSlots(slotCount, false) {}
+
+    /// <summary>Claims the next record for parsing by the calling thread</summary>
+    /// <param name="recordIndex">Receives the index of the claimed record</param>
+    /// <returns>True if a record was claimed, false if there is nothing more to do</returns>
+    public: bool Claim(std::size_t &recordIndex) {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->recordMerged.wait(
+        lock,
+        [this]() {
+          return (
+            this->firstError ||
+            (this->nextRecordToClaim >= this->recordCount) ||
+            (this->nextRecordToClaim < this->nextRecordToMerge + this->completedSlots.size())
+          );
+        }
+      );
+      if(this->firstError || (this->nextRecordToClaim >= this->recordCount)) {
+        return false;
+      }
+
+      recordIndex = this->nextRecordToClaim++;
+      return true;
+    }
+
+    /// <summary>Reports a record as parsed and merges all results that are ready</summary>
+    /// <param name="recordIndex">Index of the record that has been parsed</param>
+    public: void Complete(std::size_t recordIndex) {
+      std::size_t slotCount = this->completedSlots.size();
+
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->completedSlots[recordIndex % slotCount] = true;
+      if(this->isMerging) {
+        return; // Another thread is merging and will pick up this record
+      }
+
+      this->isMerging = true;
+      try {
+        while(!this->firstError && (this->nextRecordToMerge < this->recordCount)) {
+          std::size_t slotIndex = this->nextRecordToMerge % slotCount;
+          if(!this->completedSlots[slotIndex]) {
+            break;
+          }
+
+          this->completedSlots[slotIndex] = false;
+          lock.unlock();
+
+          this->merge(this->nextRecordToMerge);
+
+          lock.lock();
+          ++this->nextRecordToMerge;
+          this->recordMerged.notify_all();
+        }
+      }
+      catch(...) {
+        lock.lock();
+        this->isMerging = false;
+        throw;
+      }
+      this->isMerging = false;
+    }
+
+    /// <summary>Records the exception being handled and stops all workers</summary>
+    public: void Fail() {
+      std::lock_guard<std::mutex> errorScope(this->mutex);
+      if(!this->firstError) {
+        this->firstError = std::current_exception();
+      }
+      this->recordMerged.notify_all();
+    }
+
+    /// <summary>Rethrows the first exception recorded by any of the workers</summary>
+    public: void RethrowIfFailed() {
+      if(this->firstError) {
+        std::rethrow_exception(this->firstError);
+      }
+    }
+
+    /// <summary>Number of records that need to be parsed</summary>
+    private: std::size_t recordCount;
+    /// <summary>Method that merges the result of a record</summary>
+    private: std::function<void(std::size_t recordIndex)> merge;
+
+    /// <summary>Must be held while accessing any of the fields below</summary>
+    private: std::mutex mutex;
+    /// <summary>Signalled whenever a record was merged or a worker failed</summary>
+    private: std::condition_variable recordMerged;
+    /// <summary>Index of the next record that will be handed out</summary>
+    private: std::size_t nextRecordToClaim;
+    /// <summary>Index of the next record that will be merged</summary>
+    private: std::size_t nextRecordToMerge;
+    /// <summary>Whether a thread is currently merging parsed records</summary>
+    private: bool isMerging;
+    /// <summary>Whether the record occupying each slot has been parsed</summary>
+    private: std::vector<bool> completedSlots;
+    /// <summary>First exception that occurred in any of the workers</summary>
+    private: std::exception_ptr firstError;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::size_t XmlDocumentIndex::NoElement;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects the element locations while eXpat scans the document</summary>
+  class XmlDocumentIndex::Builder {
+
+    /// <summary>Initializes a new index builder</summary>
+    /// <param name="index">Index that will receive the element locations</param>
+    public: Builder(XmlDocumentIndex &index) :
+      index(index),
+      parser(ExpatParserPool::Rent()) {
+      this->parser->SetUserData(static_cast<void *>(this));
+      this->parser->SetElementHandler(
+        &Builder::elementStartEncountered, &Builder::elementEndEncountered
+      );
+    }
+
+    /// <summary>Scans the whole document and records all elements in the index</summary>
+    /// <param name="blob">Blob containing the document that will be scanned</param>
+    /// <param name="chunkByteCount">Number of bytes handed to the XML parser at once</param>
+    public: void Scan(const Blob &blob, std::size_t chunkByteCount) {
+      std::uint64_t length = blob.GetSize();
+
+      // No text handler is registered, so eXpat only has to tokenize the document.
+      // Memory-based blobs are handed to the parser as-is, all others in chunks.
+      const std::uint8_t *contents = nullptr;
+      if(length <= std::numeric_limits<std::size_t>::max()) {
+        contents = blob.TryGetContiguousSpan(0, static_cast<std::size_t>(length));
+      }
+
+      std::uint64_t position = 0;
+      XML_Status status;
+      do {
+        std::size_t chunkLength = static_cast<std::size_t>(
+          std::min<std::uint64_t>(chunkByteCount, length - position)
+        );
+
+        if(contents != nullptr) {
+          status = this->parser->Parse(
+            contents + position, chunkLength, (position + chunkLength >= length)
+          );
+        } else {
+          void *buffer = this->parser->GetBuffer(chunkLength);
+          if(buffer == nullptr) {
+            throw std::runtime_error("eXpat failed to allocate a buffer for XML parsing");
+          }
+          blob.ReadAt(position, buffer, chunkLength);
+          status = this->parser->ParseBuffer(chunkLength, (position + chunkLength >= length));
+        }
+
+        position += chunkLength;
+      } while((status == XML_STATUS_OK) && (position < length));
+
+      this->parser->ThrowIfErrorRecorded();
+      if(status != XML_STATUS_OK) {
+        throw std::runtime_error("eXpat parser reported an unknown status");
+      }
+    }
+
+    /// <summary>Called when eXpat encounters the start of an element</summary>
+    /// <param name="builder">Index builder that is scanning the document</param>
+    /// <param name="name">Name of the element whose start eXpat encountered</param>
+    /// <param name="attributes">The element's attributes, which are ignored</param>
+    private: static void elementStartEncountered(
+      void *builder, const char *name, const char **attributes
+    ) {
+      (void)attributes;
+      static_cast<Builder *>(builder)->elementStartEncountered(name);
+    }
+
+    /// <summary>Called when eXpat encounters the end of an element</summary>
+    /// <param name="builder">Index builder that is scanning the document</param>
+    /// <param name="name">Name of the element whose end eXpat encountered</param>
+    private: static void elementEndEncountered(void *builder, const char *name) {
+      (void)name;
+      static_cast<Builder *>(builder)->elementEndEncountered();
+    }
+
+    /// <summary>Records the start of an element</summary>
+    /// <param name="name">Name of the element that has started</param>
+    private: void elementStartEncountered(const char *name) {
+      Element element;
+      element.Name = &intern(name);
+      element.StartOffset = this->parser->GetCurrentByteIndex();
+      element.EndOffset = element.StartOffset;
+      element.Depth = this->openElements.size();
+      if(this->openElements.empty()) {
+        element.ParentIndex = NoElement;
+      } else {
+        element.ParentIndex = this->openElements.back();
+      }
+      element.SubtreeEndIndex = this->index.elements.size() + 1;
+
+      this->openElements.push_back(this->index.elements.size());
+      this->index.elements.push_back(element);
+    }
+
+    /// <summary>Records the end of the most recently started, still open element</summary>
+    private: void elementEndEncountered() {
+      Element &element = this->index.elements[this->openElements.back()];
+      this->openElements.pop_back();
+
+      // For empty elements (<tag />), eXpat reports the end with a byte count of zero
+      // at the position just past the tag, so this works for both kinds of elements
+      element.EndOffset = (
+        this->parser->GetCurrentByteIndex() + this->parser->GetCurrentByteCount()
+      );
+      element.SubtreeEndIndex = this->index.elements.size();
+    }
+
+    /// <summary>Looks up or creates the interned copy of a name</summary>
+    /// <param name="name">Name whose interned copy will be returned</param>
+    /// <returns>The interned copy of the name</returns>
+    private: const std::string &intern(const char *name) {
+      this->name.assign(name);
+
+      std::unordered_map<std::string, const std::string *>::const_iterator existing = (
+        this->index.names.find(this->name)
+      );
+      if(existing != this->index.names.end()) {
+        return *existing->second;
+      }
+
+      const std::string &interned = Nuclex::Support::Text::InternedString(this->name).ToString();
+      this->index.names.emplace(interned, &interned);
+
+      return interned;
+    }
+
+    /// <summary>Index that receives the element locations</summary>
+    private: XmlDocumentIndex &index;
+    /// <summary>eXpat parser scanning through the document</summary>
+    private: ExpatParserPool::Lease parser;
+    /// <summary>Indices of all elements whose end has not been encountered yet</summary>
+    private: std::vector<std::size_t> openElements;
+    /// <summary>Reused to look up names without allocating memory each time</summary>
+    private: std::string name;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  XmlDocumentIndex::XmlDocumentIndex(
+    const std::shared_ptr<const Blob> &blob, std::size_t chunkByteCount /* = 65536 */
+  ) :
+    blob(blob) {
+
+    if(chunkByteCount == 0) {
+      throw std::invalid_argument("Chunk size for XML parsing must not be zero");
+    }
+
+    Builder builder(*this);
+    builder.Scan(*blob.get(), chunkByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  XmlDocumentIndex::~XmlDocumentIndex() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const XmlDocumentIndex::Element &XmlDocumentIndex::GetElement(std::size_t index) const {
+    if(index >= this->elements.size()) {
+      throw std::out_of_range("Element index out of range");
+    }
+
+    return this->elements[index];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t XmlDocumentIndex::GetFirstChild(std::size_t index) const {
+    const Element &element = GetElement(index);
+
+    // Children directly follow their parent, so if the subtree contains more than
+    // the element itself, the next element has to be its first child
+    if(element.SubtreeEndIndex > index + 1) {
+      return index + 1;
+    } else {
+      return NoElement;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t XmlDocumentIndex::GetNextSibling(std::size_t index) const {
+    const Element &element = GetElement(index);
+
+    // The element after the subtree is either a sibling or belongs to an ancestor
+    std::size_t nextIndex = element.SubtreeEndIndex;
+    if(nextIndex < this->elements.size()) {
+      if(this->elements[nextIndex].ParentIndex == element.ParentIndex) {
+        return nextIndex;
+      }
+    }
+
+    return NoElement;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t XmlDocumentIndex::FindChild(
+    std::size_t parentIndex, const std::string &name
+  ) const {
+    std::size_t index;
+    if(parentIndex == NoElement) {
+      index = this->elements.empty() ? NoElement : 0;
+    } else {
+      index = GetFirstChild(parentIndex);
+    }
+
+    // All elements of the same name share one string, so compare the addresses
+    std::unordered_map<std::string, const std::string *>::const_iterator interned = (
+      this->names.find(name)
+    );
+    if(interned == this->names.end()) {
+      return NoElement;
+    }
+
+    while(index != NoElement) {
+      if(this->elements[index].Name == interned->second) {
+        return index;
+      }
+      index = GetNextSibling(index);
+    }
+
+    return NoElement;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t XmlDocumentIndex::FindElement(const std::string &path) const {
+    std::size_t index = NoElement;
+
+    std::string::size_type start = 0;
+    for(;;) {
+      std::string::size_type end = path.find('/', start);
+      if(end == std::string::npos) {
+        return FindChild(index, path.substr(start));
+      }
+
+      index = FindChild(index, path.substr(start, end - start));
+      if(index == NoElement) {
+        return NoElement;
+      }
+
+      start = end + 1;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::unique_ptr<XmlBlobReader> XmlDocumentIndex::OpenSubtree(
+    std::size_t index, std::size_t chunkByteCount /* = 65536 */
+  ) const {
+    const Element &element = GetElement(index);
+
+    return std::unique_ptr<XmlBlobReader>(
+      new XmlBlobReader(
+        this->blob,
+        element.StartOffset, element.EndOffset - element.StartOffset,
+        chunkByteCount
+      )
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlDocumentIndex::parseChildrenInParallel(
+    std::size_t parentIndex, std::size_t threadCount,
+    const std::function<void(std::size_t slotCount)> &prepare,
+    const std::function<void(std::size_t slotIndex, XmlReader &reader)> &parse,
+    const std::function<void(std::size_t slotIndex, std::size_t elementIndex)> &merge
+  ) const {
+    std::vector<std::size_t> children;
+    for(
+      std::size_t index = GetFirstChild(parentIndex);
+      index != NoElement;
+      index = GetNextSibling(index)
+    ) {
+      children.push_back(index);
+    }
+
+    threadCount = Helpers::WorkerThreads::ChooseThreadCount(threadCount, children.size());
+    std::size_t slotCount = threadCount * PendingRecordsPerThread;
+    prepare(slotCount);
+
+    OrderedRecordPipeline pipeline(
+      children.size(), slotCount,
+      [&children, &merge, slotCount](std::size_t recordIndex) {
+        merge(recordIndex % slotCount, children[recordIndex]);
+      }
+    );
+    Helpers::WorkerThreads::Run(
+      threadCount,
+      [&]() {
+        try {
+          std::size_t recordIndex;
+          while(pipeline.Claim(recordIndex)) {
+            const Element &element = this->elements[children[recordIndex]];
+            XmlBlobReader reader(
+              this->blob, element.StartOffset, element.EndOffset - element.StartOffset
+            );
+            parse(recordIndex % slotCount, reader);
+
+            pipeline.Complete(recordIndex);
+          }
+        }
+        catch(...) {
+          pipeline.Fail();
+        }
+      }
+    );
+    pipeline.RethrowIfFailed();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
@@ -0,0 +1,131 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_XML_XMLNAMETABLE_H
+#define NUCLEX_STORAGE_XML_XMLNAMETABLE_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include "Nuclex/Support/Collections/FlatHashMap.h"
+#include "Nuclex/Support/Text/InternedString.h"
+
+#include <cstddef> // for std::size_t
+#include <cstring> // for std::strcmp()
+#include <string> // for std::string
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps one copy of each element and attribute name seen in a document</summary>
+  /// <remarks>
+  ///   Names repeat constantly in XML documents. Interning them means each name is only
+  ///   stored once and readers can compare names by their addresses. The names are
+  ///   interned globally through <see cref="Nuclex::Support::Text::InternedString" />,
+  ///   so all documents and all interned strings with the same name share one copy.
+  ///   The table only caches the names seen in its own document, so that eXpat's
+  ///   names can be looked up without taking the global table's lock.
+  /// </remarks>
+  class XmlNameTable {
+
+    /// <summary>Initializes a new, empty name table</summary>
+    public: XmlNameTable() :
+      names() {}
+
+    /// <summary>Looks up the interned copy of a name</summary>
+    /// <param name="name">Name whose interned copy will be looked up</param>
+    /// <returns>
+    ///   The interned copy of the name or null if the name was never interned by this table
+    /// </returns>
+    public: const std::string *TryGet(const char *name) const {
+      const std::string *const *existing = this->names.TryGet(name);
+      if(existing == nullptr) {
+        return nullptr;
+      } else {
+        return *existing;
+      }
+    }
+
+    /// <summary>Looks up or creates the interned copy of a name</summary>
+    /// <param name="name">Name whose interned copy will be returned</param>
+    /// <returns>The interned copy of the name</returns>
+    public: const std::string &Intern(const char *name) {
+      const std::string *const *existing = this->names.TryGet(name);
+      if(existing != nullptr) {
+        return **existing;
+      }
+
+      const std::string &interned = Nuclex::Support::Text::InternedString(name).ToString();
+      this->names.TryInsert(interned.c_str(), &interned);
+
+      return interned;
+    }
+
+    /// <summary>Hashes zero-terminated strings by their contents</summary>
+    private: struct NameHash {
+
+      /// <summary>Calculates the hash of a zero-terminated string</summary>
+      /// <param name="name">String whose hash will be calculated</param>
+      /// <returns>The hash of the string</returns>
+      public: std::size_t operator()(const char *name) const {
+        std::size_t hash = 2166136261U; // FNV-1a, good enough for short names
+        while(*name != '\0') {
+          hash = (hash ^ static_cast<unsigned char>(*name)) * 16777619U;
+          ++name;
+        }
+        return hash;
+      }
+
+    };
+
+    /// <summary>Compares zero-terminated strings by their contents</summary>
+    private: struct NameEquality {
+
+      /// <summary>Checks whether two zero-terminated strings are equal</summary>
+      /// <param name="left">First string that will be compared</param>
+      /// <param name="right">Second string that will be compared</param>
+      /// <returns>True if both strings have the same contents</returns>
+      public: bool operator()(const char *left, const char *right) const {
+        return (std::strcmp(left, right) == 0);
+      }
+
+    };
+
+    private: XmlNameTable(const XmlNameTable &) = delete;
+    private: XmlNameTable &operator =(const XmlNameTable &) = delete;
+
+    /// <summary>Maps names to their interned copies</summary>
+    /// <remarks>
+    ///   The keys point into the globally interned strings themselves, so names reported by eXpat
+    ///   can be looked up without constructing a std::string first. Names are looked up
+    ///   for every element and attribute, so a flat map with no per-entry allocations
+    ///   and no pointer chasing is used.
+    /// </remarks>
+    private: Nuclex::Support::Collections::FlatHashMap<
+      const char *, const std::string *, NameHash, NameEquality
+    > names;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
+
+#endif // NUCLEX_STORAGE_XML_XMLNAMETABLE_H
@@ -0,0 +1,258 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlStreamReader.h"
+#include "Nuclex/Storage/Binary/InputStream.h"
+
+#include "XmlBlobReader.Impl.h"
+
+#include "../Helpers/Lexical.h"
+
+#include <Nuclex/Support/Instrumentation.h> // for NUCLEX_SUPPORT_INSTRUMENT_ZONE()
+#include <Nuclex/Support/Text/StringConverter.h> // for StringConverter
+
+#include <stdexcept> // for std::logic_error
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  XmlStreamReader::XmlStreamReader(
+    const std::shared_ptr<Binary::InputStream> &stream, std::size_t chunkByteCount /* = 65536 */
+  ) :
+    stream(stream),
+    impl(new XmlBlobReader::Impl(*stream.get(), chunkByteCount)),
+    binaryFormat(XmlBinaryFormat::Base64),
+    enteredAttribute(nullptr) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  XmlStreamReader::~XmlStreamReader() {
+    // Must be in the implementation file because the inlined version would not know
+    // the destructor of our impl class!
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Reset(const std::shared_ptr<Binary::InputStream> &stream) {
+    this->impl->Reset(*stream.get());
+    this->stream = stream;
+    this->enteredAttribute = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  XmlReadEvent XmlStreamReader::Read() {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE(u8"Nuclex.Storage.XmlStreamReader.Read");
+    return this->impl->Read();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &XmlStreamReader::GetElementName() const {
+    return this->impl->GetElementName();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t XmlStreamReader::CountAttributes() const {
+    return this->impl->CountAttributes();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &XmlStreamReader::GetAttributeName(std::size_t index) const {
+    return this->impl->GetAttributeName(index);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &XmlStreamReader::GetAttributeValue(std::size_t index) const {
+    return this->impl->GetAttributeValue(index);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &XmlStreamReader::InternName(const std::string &name) {
+    return this->impl->InternName(name);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool XmlStreamReader::TryEnterAttribute(const std::string &attributeName) {
+    this->enteredAttribute = this->impl->GetAttributeValue(attributeName);
+    return (this->enteredAttribute != nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::LeaveAttribute() {
+    if(this->enteredAttribute == nullptr) {
+      throw std::logic_error("Tried to leave attribute without having entered one");
+    }
+
+    this->enteredAttribute = nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(bool &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<bool>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<bool>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::uint8_t &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<std::uint8_t>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<std::uint8_t>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::int8_t &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<std::int8_t>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<std::int8_t>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::uint16_t &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<std::uint16_t>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<std::uint16_t>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::int16_t &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<std::int16_t>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<std::int16_t>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::uint32_t &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<std::uint32_t>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<std::uint32_t>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::int32_t &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<std::int32_t>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<std::int32_t>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::uint64_t &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<std::uint64_t>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<std::uint64_t>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::int64_t &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<std::int64_t>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<std::int64_t>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(float &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<float>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<float>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(double &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Helpers::lexical_cast<double>(this->impl->GetElementText());
+    } else {
+      target = Helpers::lexical_cast<double>(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::string &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = this->impl->GetElementText();
+    } else {
+      target = *this->enteredAttribute;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(std::wstring &target) {
+    if(this->enteredAttribute == nullptr) {
+      target = Support::Text::StringConverter::WideFromUtf8(this->impl->GetElementText());
+    } else {
+      target = Support::Text::StringConverter::WideFromUtf8(*this->enteredAttribute);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void XmlStreamReader::Read(void *buffer, std::size_t byteCount) {
+    this->impl->ReadBinary(
+      this->binaryFormat, this->enteredAttribute,
+      static_cast<std::uint8_t *>(buffer), byteCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
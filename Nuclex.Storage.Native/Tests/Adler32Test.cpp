@@ -0,0 +1,104 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Checksums/Adler32.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "Nuclex/Storage/Binary/BlobInputStream.h"
+#include "RandomDataFactory.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates an Adler-32 checksum as the specification describes it</summary>
+  /// <param name="data">Data whose checksum will be calculated</param>
+  /// <param name="byteCount">Number of bytes in the data</param>
+  /// <returns>The Adler-32 checksum of the data</returns>
+  std::uint32_t computeSimpleAdler32(const std::uint8_t *data, std::size_t byteCount) {
+    std::uint32_t sum = 1;
+    std::uint32_t weightedSum = 0;
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      sum = (sum + data[index]) % 65521;
+      weightedSum = (weightedSum + sum) % 65521;
+    }
+    return (weightedSum << 16) | sum;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Adler32Test, KnownChecksumsAreReproduced) {
+    EXPECT_EQ(1U, Adler32::Compute(u8"", 0));
+    EXPECT_EQ(0x11E60398U, Adler32::Compute(u8"Wikipedia", 9));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Adler32Test, AllLengthsMatchSimpleCalculation) {
+    std::vector<std::uint8_t> data = MakeRandomData(400, 11);
+    for(std::size_t byteCount = 0; byteCount <= data.size(); byteCount += 3) {
+      EXPECT_EQ(
+        computeSimpleAdler32(data.data(), byteCount), Adler32::Compute(data.data(), byteCount)
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Adler32Test, SumsAreReducedBeforeTheyOverflow) {
+    std::vector<std::uint8_t> data(100000, 0xFF);
+    EXPECT_EQ(
+      computeSimpleAdler32(data.data(), data.size()), Adler32::Compute(data.data(), data.size())
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Adler32Test, BlobsAndStreamsCanBeChecksummed) {
+    std::vector<std::uint8_t> data = MakeRandomData(150000, 5);
+    std::uint32_t expected = computeSimpleAdler32(data.data(), data.size());
+
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    blob->WriteAt(0, data.data(), data.size());
+    EXPECT_EQ(expected, Adler32::Compute(*blob));
+
+    blob->Seal();
+    Binary::BlobInputStream stream(blob);
+    Adler32 adler32;
+    adler32.Update(stream);
+    EXPECT_EQ(expected, adler32.GetValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
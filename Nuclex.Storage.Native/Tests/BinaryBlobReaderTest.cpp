@@ -0,0 +1,300 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BinaryBlobReader.h"
+#include "Nuclex/Storage/Binary/BinaryBlobWriter.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include <Nuclex/Support/MonotonicArena.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory blob that counts how often it is read from</summary>
+  class CountingBlob : public Nuclex::Storage::MemoryBlob {
+
+    /// <summary>Initializes a new counting blob</summary>
+    public: CountingBlob() :
+      ReadCount(0) {}
+
+    /// <summary>Reads raw data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: void ReadAt(std::uint64_t location, void *buffer, std::size_t count) const override {
+      ++this->ReadCount;
+      MemoryBlob::ReadAt(location, buffer, count);
+    }
+
+    /// <summary>Number of times ReadAt() has been called</summary>
+    public: mutable std::size_t ReadCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a blob holding the 32 bit integers from 0 to 999</summary>
+  /// <returns>The new blob</returns>
+  std::shared_ptr<CountingBlob> makeIntegerBlob() {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    for(std::uint32_t index = 0; index < 1000; ++index) {
+      blob->WriteAt(index * sizeof(index), &index, sizeof(index));
+    }
+
+    return blob;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, ReadsFieldsInNativeEndianByDefault) {
+    std::shared_ptr<CountingBlob> blob = makeIntegerBlob();
+    BinaryBlobReader reader(blob);
+
+    std::uint32_t value;
+    reader.Read(value);
+    EXPECT_EQ(0U, value);
+    reader.Read(value);
+    EXPECT_EQ(1U, value);
+
+    EXPECT_EQ(8U, reader.GetPosition());
+    EXPECT_EQ(4000U - 8U, reader.GetRemainingBytes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, SmallReadsAreBatched) {
+    std::shared_ptr<CountingBlob> blob = makeIntegerBlob();
+    BinaryBlobReader reader(blob, 1024);
+
+    for(std::uint32_t index = 0; index < 1000; ++index) {
+      std::uint32_t value;
+      reader.Read(value);
+      ASSERT_EQ(index, value);
+    }
+
+    // 4000 bytes through a 1024 byte window means four refills
+    EXPECT_EQ(4U, blob->ReadCount);
+    EXPECT_EQ(0U, reader.GetRemainingBytes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, FieldsCanStraddleTheWindowBorder) {
+    std::shared_ptr<CountingBlob> blob = makeIntegerBlob();
+    BinaryBlobReader reader(blob, 10);
+
+    std::uint16_t half;
+    reader.Read(half);
+
+    // Every read spans the end of one integer and the start of another
+    for(std::uint64_t index = 0; index < 10; ++index) {
+      std::uint64_t expected;
+      blob->ReadAt(2 + index * 8, &expected, sizeof(expected));
+
+      std::uint64_t value;
+      reader.Read(value);
+      ASSERT_EQ(expected, value);
+    }
+
+    EXPECT_EQ(2U + 80U, reader.GetPosition());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, SeekingWorksWithReadWindow) {
+    std::shared_ptr<CountingBlob> blob = makeIntegerBlob();
+    BinaryBlobReader reader(blob);
+
+    std::uint32_t value;
+    reader.SetPosition(400);
+    reader.Read(value);
+    EXPECT_EQ(100U, value);
+
+    reader.SetPosition(40);
+    reader.Read(value);
+    EXPECT_EQ(10U, value);
+
+    reader.SetPosition(3996);
+    reader.Read(value);
+    EXPECT_EQ(999U, value);
+    EXPECT_EQ(0U, reader.GetRemainingBytes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, LargeReadsBypassTheWindow) {
+    std::shared_ptr<CountingBlob> blob = makeIntegerBlob();
+    BinaryBlobReader reader(blob, 64);
+
+    std::uint32_t values[100];
+    reader.Read(values, sizeof(values));
+    EXPECT_EQ(1U, blob->ReadCount);
+    EXPECT_EQ(99U, values[99]);
+    EXPECT_EQ(400U, reader.GetPosition());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, ReadWindowCanBeDisabled) {
+    std::shared_ptr<CountingBlob> blob = makeIntegerBlob();
+    BinaryBlobReader reader(blob, 0);
+
+    std::uint32_t value;
+    reader.Read(value);
+    reader.Read(value);
+    EXPECT_EQ(1U, value);
+    EXPECT_EQ(2U, blob->ReadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, DiscardedReadWindowPicksUpChanges) {
+    std::shared_ptr<CountingBlob> blob = makeIntegerBlob();
+    BinaryBlobReader reader(blob);
+
+    std::uint32_t value;
+    reader.Read(value);
+    EXPECT_EQ(0U, value);
+
+    std::uint32_t replacement = 12345;
+    blob->WriteAt(4, &replacement, sizeof(replacement));
+
+    reader.DiscardReadWindow();
+    reader.Read(value);
+    EXPECT_EQ(12345U, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, ReadingPastTheEndThrows) {
+    std::shared_ptr<CountingBlob> blob = makeIntegerBlob();
+    BinaryBlobReader reader(blob);
+
+    reader.SetPosition(4000);
+    std::uint32_t value;
+    EXPECT_THROW(reader.Read(value), std::out_of_range);
+    EXPECT_EQ(4000U, reader.GetPosition());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, ArraysAreReadInStreamByteOrder) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    const std::uint8_t bytes[] = {
+      0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C,
+      0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18
+    };
+    blob->WriteAt(0, bytes, sizeof(bytes));
+
+    BinaryBlobReader littleEndianReader(blob);
+    littleEndianReader.SetLittleEndian(true);
+    BinaryBlobReader bigEndianReader(blob);
+    bigEndianReader.SetLittleEndian(false);
+
+    std::uint32_t littleEndianValues[6], bigEndianValues[6];
+    littleEndianReader.ReadArray(littleEndianValues, 6);
+    bigEndianReader.ReadArray(bigEndianValues, 6);
+
+    for(std::size_t index = 0; index < 6; ++index) {
+      const std::uint8_t *value = bytes + index * 4;
+      EXPECT_EQ(
+        (std::uint32_t(value[3]) << 24) | (std::uint32_t(value[2]) << 16) |
+        (std::uint32_t(value[1]) << 8) | std::uint32_t(value[0]),
+        littleEndianValues[index]
+      );
+      EXPECT_EQ(
+        (std::uint32_t(value[0]) << 24) | (std::uint32_t(value[1]) << 16) |
+        (std::uint32_t(value[2]) << 8) | std::uint32_t(value[3]),
+        bigEndianValues[index]
+      );
+    }
+    EXPECT_EQ(24U, bigEndianReader.GetPosition());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobReaderTest, StringsCanBeReadWithoutAllocations) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      BinaryBlobWriter writer(blob);
+      writer.Write(std::string(u8"Hello"));
+      writer.Write(std::string(u8"World"));
+      writer.Write(std::string());
+    }
+
+    // Strings can be read into an arena or a string table from any blob
+    {
+      BinaryBlobReader reader(blob);
+      Support::MonotonicArena arena;
+      std::size_t length;
+      const char *characters = reader.ReadString(arena, length);
+      EXPECT_EQ(std::string(u8"Hello"), std::string(characters));
+      EXPECT_EQ(5U, length);
+
+      // Unsealed memory blobs don't hand out their memory
+      EXPECT_FALSE(reader.TryReadStringInPlace(characters, length));
+
+      StringTable table;
+      reader.ReadStringTable(table, 2);
+      ASSERT_EQ(2U, table.CountStrings());
+      EXPECT_EQ(std::string(u8"World"), std::string(table.GetString(0)));
+      EXPECT_EQ(5U, table.GetLength(0));
+      EXPECT_EQ(std::string(), std::string(table.GetString(1)));
+      EXPECT_EQ(0U, table.GetLength(1));
+    }
+
+    // Once sealed, the strings point right into the blob's memory
+    blob->Seal();
+    {
+      BinaryBlobReader reader(blob);
+      const char *characters;
+      std::size_t length;
+      ASSERT_TRUE(reader.TryReadStringInPlace(characters, length));
+      EXPECT_EQ(std::string(u8"Hello"), std::string(characters, length));
+      EXPECT_EQ(
+        blob->TryGetContiguousSpan(4, 5), reinterpret_cast<const std::uint8_t *>(characters)
+      );
+
+      ASSERT_TRUE(reader.TryReadStringInPlace(characters, length));
+      EXPECT_EQ(std::string(u8"World"), std::string(characters, length));
+      ASSERT_TRUE(reader.TryReadStringInPlace(characters, length));
+      EXPECT_EQ(0U, length);
+      EXPECT_EQ(0U, reader.GetRemainingBytes());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,348 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BinaryBlobWriter.h"
+#include "Nuclex/Storage/Binary/BinaryBlobReader.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory blob that counts how often it is written to</summary>
+  class CountingBlob : public Nuclex::Storage::MemoryBlob {
+
+    /// <summary>Initializes a new counting blob</summary>
+    public: CountingBlob() :
+      WriteCount(0) {}
+
+    /// <summary>Writes raw data into the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    public: void WriteAt(std::uint64_t location, const void *buffer, std::size_t count) override {
+      ++this->WriteCount;
+      MemoryBlob::WriteAt(location, buffer, count);
+    }
+
+    /// <summary>Number of times WriteAt() has been called</summary>
+    public: std::size_t WriteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, SmallWritesAreCombined) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      BinaryBlobWriter writer(blob, 1024);
+      for(std::uint32_t index = 0; index < 1000; ++index) {
+        writer.Write(index);
+      }
+      EXPECT_EQ(4000U, writer.GetPosition());
+    }
+
+    // 4000 bytes through a 1024 byte buffer means four writes
+    EXPECT_EQ(4U, blob->WriteCount);
+    ASSERT_EQ(4000U, blob->GetSize());
+
+    BinaryBlobReader reader(blob);
+    for(std::uint32_t index = 0; index < 1000; ++index) {
+      std::uint32_t value;
+      reader.Read(value);
+      ASSERT_EQ(index, value);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, FlushHandsBufferedBytesToBlob) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    BinaryBlobWriter writer(blob);
+
+    writer.Write(std::string(u8"Hello World"));
+    EXPECT_EQ(0U, blob->GetSize());
+
+    writer.Flush();
+    EXPECT_EQ(4U + 11U, blob->GetSize());
+    EXPECT_EQ(1U, blob->WriteCount);
+
+    writer.Flush(); // Nothing buffered, nothing to write
+    EXPECT_EQ(1U, blob->WriteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, SeekingKeepsWritesInOrder) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      BinaryBlobWriter writer(blob);
+      writer.Write(std::uint32_t(1));
+      writer.Write(std::uint32_t(2));
+      writer.Write(std::uint32_t(3));
+
+      writer.SetPosition(4);
+      writer.Write(std::uint32_t(20));
+    }
+
+    BinaryBlobReader reader(blob);
+    std::uint32_t values[3];
+    for(std::size_t index = 0; index < 3; ++index) {
+      reader.Read(values[index]);
+    }
+    EXPECT_EQ(1U, values[0]);
+    EXPECT_EQ(20U, values[1]);
+    EXPECT_EQ(3U, values[2]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, LargeWritesBypassTheBuffer) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    BinaryBlobWriter writer(blob, 64);
+
+    std::uint8_t bytes[100] = { 0 };
+    writer.Write(bytes, sizeof(bytes));
+    EXPECT_EQ(1U, blob->WriteCount);
+    EXPECT_EQ(100U, blob->GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, WriteBufferCanBeDisabled) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    BinaryBlobWriter writer(blob, 0);
+
+    writer.Write(std::uint16_t(1));
+    writer.Write(std::uint16_t(2));
+    EXPECT_EQ(2U, blob->WriteCount);
+    EXPECT_EQ(4U, blob->GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, ArraysSurviveRoundTripInForeignByteOrder) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+
+    std::vector<std::uint16_t> shorts(1001);
+    std::vector<std::uint64_t> longs(777);
+    std::vector<double> doubles(123);
+    for(std::size_t index = 0; index < shorts.size(); ++index) {
+      shorts[index] = static_cast<std::uint16_t>(index * 0x0101 + 1);
+    }
+    for(std::size_t index = 0; index < longs.size(); ++index) {
+      longs[index] = static_cast<std::uint64_t>(index) * 0x0102030405060708ULL;
+    }
+    for(std::size_t index = 0; index < doubles.size(); ++index) {
+      doubles[index] = static_cast<double>(index) / 3.0;
+    }
+
+    {
+      BinaryBlobWriter writer(blob);
+      writer.SetLittleEndian(false);
+      writer.WriteArray(shorts.data(), shorts.size());
+      writer.WriteArray(longs.data(), longs.size());
+      writer.WriteArray(doubles.data(), doubles.size());
+    }
+
+    // The first value has to be stored in big endian
+    std::uint8_t firstBytes[2];
+    blob->ReadAt(0, firstBytes, 2);
+    EXPECT_EQ(0x00, firstBytes[0]);
+    EXPECT_EQ(0x01, firstBytes[1]);
+
+    BinaryBlobReader reader(blob);
+    reader.SetLittleEndian(false);
+
+    std::vector<std::uint16_t> readShorts(shorts.size());
+    std::vector<std::uint64_t> readLongs(longs.size());
+    std::vector<double> readDoubles(doubles.size());
+    reader.ReadArray(readShorts.data(), readShorts.size());
+    reader.ReadArray(readLongs.data(), readLongs.size());
+    reader.ReadArray(readDoubles.data(), readDoubles.size());
+
+    EXPECT_EQ(shorts, readShorts);
+    EXPECT_EQ(longs, readLongs);
+    EXPECT_EQ(doubles, readDoubles);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, ArraysInNativeByteOrderAreWrittenUnchanged) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+
+    std::int32_t values[5] = { 1, -2, 3, -4, 5 };
+    {
+      BinaryBlobWriter writer(blob);
+#if defined(NUCLEX_STORAGE_BIG_ENDIAN)
+      writer.SetLittleEndian(false);
+#else
+      writer.SetLittleEndian(true);
+#endif
+      writer.WriteArray(values, 5);
+    }
+
+    std::int32_t stored[5];
+    ASSERT_EQ(sizeof(stored), blob->GetSize());
+    blob->ReadAt(0, stored, sizeof(stored));
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(values[index], stored[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, VarintsSurviveRoundTrip) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+
+    const std::uint64_t unsignedValues[] = {
+      0, 1, 127, 128, 16383, 16384, 0xFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL
+    };
+    const std::int64_t signedValues[] = {
+      0, -1, 1, -64, 64, -2147483648LL, 0x7FFFFFFFFFFFFFFFLL
+    };
+    {
+      BinaryBlobWriter writer(blob, 7); // Tiny buffer so varints straddle its border
+      writer.SetLittleEndian(false); // Varints have no byte order, this must not matter
+      for(std::uint64_t value : unsignedValues) {
+        writer.WriteVarint(value);
+      }
+      for(std::int64_t value : signedValues) {
+        writer.WriteVarint(value);
+      }
+      writer.WriteVarint(std::uint32_t(300));
+      writer.WriteVarint(std::int32_t(-300));
+    }
+
+    // 300 needs two bytes as unsigned varint, -300 needs two bytes zigzag-encoded
+    std::uint8_t lastBytes[4];
+    blob->ReadAt(blob->GetSize() - 4, lastBytes, 4);
+    EXPECT_EQ(0xAC, lastBytes[0]);
+    EXPECT_EQ(0x02, lastBytes[1]);
+    EXPECT_EQ(0xD7, lastBytes[2]);
+    EXPECT_EQ(0x04, lastBytes[3]);
+
+    BinaryBlobReader reader(blob, 5); // Tiny window so varints straddle its border
+    for(std::uint64_t expected : unsignedValues) {
+      std::uint64_t value;
+      reader.ReadVarint(value);
+      EXPECT_EQ(expected, value);
+    }
+    for(std::int64_t expected : signedValues) {
+      std::int64_t value;
+      reader.ReadVarint(value);
+      EXPECT_EQ(expected, value);
+    }
+    std::uint32_t unsignedValue;
+    reader.ReadVarint(unsignedValue);
+    EXPECT_EQ(300U, unsignedValue);
+    std::int32_t signedValue;
+    reader.ReadVarint(signedValue);
+    EXPECT_EQ(-300, signedValue);
+    EXPECT_EQ(0U, reader.GetRemainingBytes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, OversizedVarintsAreRejected) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryBlobWriter writer(blob);
+      writer.WriteVarint(std::uint64_t(0x100000000ULL));
+      for(std::size_t index = 0; index < 11; ++index) {
+        writer.Write(std::uint8_t(0x80));
+      }
+    }
+
+    BinaryBlobReader reader(blob);
+    std::uint32_t value;
+    EXPECT_THROW(reader.ReadVarint(value), std::runtime_error);
+    std::uint64_t longValue;
+    EXPECT_THROW(reader.ReadVarint(longValue), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryBlobWriterTest, VarintArraysSurviveRoundTrip) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+
+    std::vector<std::uint32_t> ids(1003);
+    std::vector<std::uint32_t> sizes(1003);
+    std::vector<std::int32_t> offsets(1003);
+    for(std::size_t index = 0; index < ids.size(); ++index) {
+      ids[index] = static_cast<std::uint32_t>(100000 + index * 3 + (index % 2));
+      sizes[index] = static_cast<std::uint32_t>(1) << (index % 32);
+      offsets[index] = (static_cast<std::int32_t>(index) - 500) * 1000;
+    }
+
+    std::uint64_t deltaByteCount, plainByteCount;
+    {
+      BinaryBlobWriter writer(blob);
+      writer.WriteDeltaArray(ids.data(), ids.size());
+      deltaByteCount = writer.GetPosition();
+      writer.WriteVarintArray(ids.data(), ids.size());
+      plainByteCount = writer.GetPosition() - deltaByteCount;
+      writer.WriteVarintArray(sizes.data(), sizes.size());
+      writer.WriteVarintArray(offsets.data(), offsets.size());
+    }
+
+    // Sorted ids shrink to one byte per value when stored as differences
+    EXPECT_EQ((ids.size() + 3) / 4 + ids.size() + 2, deltaByteCount);
+    EXPECT_EQ((ids.size() + 3) / 4 + ids.size() * 3, plainByteCount);
+
+    for(std::size_t windowByteCount = 0; windowByteCount < 20000; windowByteCount += 333) {
+      BinaryBlobReader reader(blob, windowByteCount);
+
+      std::vector<std::uint32_t> readIds(ids.size());
+      std::vector<std::uint32_t> readPlainIds(ids.size());
+      std::vector<std::uint32_t> readSizes(sizes.size());
+      std::vector<std::int32_t> readOffsets(offsets.size());
+      reader.ReadDeltaArray(readIds.data(), readIds.size());
+      reader.ReadVarintArray(readPlainIds.data(), readPlainIds.size());
+      reader.ReadVarintArray(readSizes.data(), readSizes.size());
+      reader.ReadVarintArray(readOffsets.data(), readOffsets.size());
+
+      EXPECT_EQ(ids, readIds);
+      EXPECT_EQ(ids, readPlainIds);
+      EXPECT_EQ(sizes, readSizes);
+      EXPECT_EQ(offsets, readOffsets);
+      EXPECT_EQ(0U, reader.GetRemainingBytes());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
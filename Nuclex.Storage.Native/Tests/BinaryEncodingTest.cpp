@@ -0,0 +1,262 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "../Source/Helpers/BinaryEncoding.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates a buffer of pseudo-random bytes</summary>
+  /// <param name="byteCount">Number of bytes the buffer will contain</param>
+  /// <returns>A buffer with the specified number of pseudo-random bytes</returns>
+  std::vector<std::uint8_t> makeBytes(std::size_t byteCount) {
+    std::vector<std::uint8_t> bytes(byteCount);
+
+    std::uint32_t state = 12345;
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      state = state * 1103515245U + 12345U;
+      bytes[index] = static_cast<std::uint8_t>(state >> 24);
+    }
+
+    return bytes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes binary data to base-64</summary>
+  /// <param name="bytes">Bytes that will be encoded</param>
+  /// <returns>The base-64 encoded bytes</returns>
+  std::string encodeBase64(const std::vector<std::uint8_t> &bytes) {
+    using Nuclex::Storage::Helpers::BinaryEncoder;
+
+    std::string encoded(BinaryEncoder::GetBase64Length(bytes.size()), '\0');
+    if(!bytes.empty()) {
+      BinaryEncoder::EncodeBase64(bytes.data(), bytes.size(), &encoded[0]);
+    }
+    return encoded;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes binary data to hexadecimal digits</summary>
+  /// <param name="bytes">Bytes that will be encoded</param>
+  /// <returns>The hex encoded bytes</returns>
+  std::string encodeHex(const std::vector<std::uint8_t> &bytes) {
+    using Nuclex::Storage::Helpers::BinaryEncoder;
+
+    std::string encoded(BinaryEncoder::GetHexLength(bytes.size()), '\0');
+    if(!bytes.empty()) {
+      BinaryEncoder::EncodeHex(bytes.data(), bytes.size(), &encoded[0]);
+    }
+    return encoded;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes text in one piece using the specified decoder</summary>
+  /// <typeparam name="TDecoder">Decoder that will be used</typeparam>
+  /// <param name="text">Text that will be decoded</param>
+  /// <param name="byteCount">Number of bytes the text is expected to decode to</param>
+  /// <returns>The decoded bytes</returns>
+  template<typename TDecoder>
+  std::vector<std::uint8_t> decode(const std::string &text, std::size_t byteCount) {
+    std::vector<std::uint8_t> bytes(byteCount + 1); // +1 so data() is never null
+    TDecoder decoder;
+
+    std::size_t written = decoder.Decode(text.data(), text.length(), bytes.data(), byteCount);
+    EXPECT_TRUE(decoder.IsComplete());
+
+    bytes.resize(written);
+    return bytes;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, EncodesBase64TestVectors) {
+    // Test vectors from RFC 4648
+    EXPECT_EQ(encodeBase64(std::vector<std::uint8_t>()), std::string());
+    EXPECT_EQ(encodeBase64({ 'f' }), std::string(u8"Zg=="));
+    EXPECT_EQ(encodeBase64({ 'f', 'o' }), std::string(u8"Zm8="));
+    EXPECT_EQ(encodeBase64({ 'f', 'o', 'o' }), std::string(u8"Zm9v"));
+    EXPECT_EQ(encodeBase64({ 'f', 'o', 'o', 'b' }), std::string(u8"Zm9vYg=="));
+    EXPECT_EQ(encodeBase64({ 'f', 'o', 'o', 'b', 'a' }), std::string(u8"Zm9vYmE="));
+    EXPECT_EQ(encodeBase64({ 'f', 'o', 'o', 'b', 'a', 'r' }), std::string(u8"Zm9vYmFy"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, EncodesAllBase64Characters) {
+    std::vector<std::uint8_t> bytes;
+    for(std::size_t index = 0; index < 64; index += 4) {
+      std::uint32_t group = (index << 18) | ((index + 1) << 12) | ((index + 2) << 6) | (index + 3);
+      bytes.push_back(static_cast<std::uint8_t>(group >> 16));
+      bytes.push_back(static_cast<std::uint8_t>(group >> 8));
+      bytes.push_back(static_cast<std::uint8_t>(group));
+    }
+
+    // 48 bytes are long enough to go through the vectorized code on any CPU
+    EXPECT_EQ(
+      encodeBase64(bytes),
+      std::string(u8"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/")
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, EncodesHex) {
+    EXPECT_EQ(encodeHex({ 0x00, 0x1F, 0xA0, 0xFF }), std::string(u8"001FA0FF"));
+
+    std::vector<std::uint8_t> bytes;
+    for(std::size_t index = 0; index < 256; ++index) {
+      bytes.push_back(static_cast<std::uint8_t>(index));
+    }
+    std::string encoded = encodeHex(bytes);
+    ASSERT_EQ(encoded.length(), 512U);
+    EXPECT_EQ(encoded.substr(0, 8), std::string(u8"00010203"));
+    EXPECT_EQ(encoded.substr(18, 6), std::string(u8"090A0B"));
+    EXPECT_EQ(encoded.substr(504, 8), std::string(u8"FCFDFEFF"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, Base64RoundTripsAllLengths) {
+    for(std::size_t byteCount = 0; byteCount < 100; ++byteCount) {
+      std::vector<std::uint8_t> bytes = makeBytes(byteCount);
+      EXPECT_EQ(decode<Base64Decoder>(encodeBase64(bytes), byteCount), bytes);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, HexRoundTripsAllLengths) {
+    for(std::size_t byteCount = 0; byteCount < 100; ++byteCount) {
+      std::vector<std::uint8_t> bytes = makeBytes(byteCount);
+      EXPECT_EQ(decode<HexDecoder>(encodeHex(bytes), byteCount), bytes);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, HexDecoderAcceptsLowerCase) {
+    std::vector<std::uint8_t> expected = { 0xAB, 0xCD, 0xEF, 0x09 };
+    EXPECT_EQ(decode<HexDecoder>(u8"abcdef09", 4), expected);
+    EXPECT_EQ(decode<HexDecoder>(u8"AbCdEf09", 4), expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, DecodersSkipWhitespace) {
+    std::vector<std::uint8_t> bytes = makeBytes(1000);
+
+    std::string base64 = encodeBase64(bytes);
+    std::string hex = encodeHex(bytes);
+
+    std::string indentedBase64, indentedHex;
+    for(std::size_t index = 0; index < base64.length(); index += 76) {
+      indentedBase64.append(u8"\n    ");
+      indentedBase64.append(base64, index, 76);
+    }
+    for(std::size_t index = 0; index < hex.length(); index += 70) {
+      indentedHex.append(u8"\r\n\t");
+      indentedHex.append(hex, index, 70);
+    }
+
+    EXPECT_EQ(decode<Base64Decoder>(indentedBase64, bytes.size()), bytes);
+    EXPECT_EQ(decode<HexDecoder>(indentedHex, bytes.size()), bytes);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, DecodersAcceptTextInPieces) {
+    std::vector<std::uint8_t> bytes = makeBytes(500);
+    std::string base64 = encodeBase64(bytes);
+    std::string hex = encodeHex(bytes);
+
+    std::vector<std::uint8_t> decodedBase64(bytes.size());
+    std::vector<std::uint8_t> decodedHex(bytes.size());
+    Base64Decoder base64Decoder;
+    HexDecoder hexDecoder;
+
+    // Split the text at odd positions so groups and byte pairs get torn apart
+    std::size_t base64Written = 0, hexWritten = 0;
+    for(std::size_t index = 0; index < hex.length(); index += 37) {
+      if(index < base64.length()) {
+        std::size_t length = std::min<std::size_t>(37, base64.length() - index);
+        base64Written += base64Decoder.Decode(
+          base64.data() + index, length,
+          decodedBase64.data() + base64Written, bytes.size() - base64Written
+        );
+      }
+
+      std::size_t length = std::min<std::size_t>(37, hex.length() - index);
+      hexWritten += hexDecoder.Decode(
+        hex.data() + index, length,
+        decodedHex.data() + hexWritten, bytes.size() - hexWritten
+      );
+    }
+
+    EXPECT_TRUE(base64Decoder.IsComplete());
+    EXPECT_TRUE(hexDecoder.IsComplete());
+    EXPECT_EQ(decodedBase64, bytes);
+    EXPECT_EQ(decodedHex, bytes);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, DecodersRejectInvalidCharacters) {
+    std::string base64 = encodeBase64(makeBytes(48));
+    base64[30] = '*';
+    EXPECT_THROW(decode<Base64Decoder>(base64, 48), std::runtime_error);
+
+    std::string hex = encodeHex(makeBytes(48));
+    hex[40] = 'G';
+    EXPECT_THROW(decode<HexDecoder>(hex, 48), std::runtime_error);
+
+    EXPECT_THROW(decode<Base64Decoder>(u8"Zg==Zg==", 2), std::runtime_error);
+    EXPECT_THROW(decode<Base64Decoder>(u8"Z===", 1), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryEncodingTest, DecodersRejectTooMuchData) {
+    EXPECT_THROW(decode<Base64Decoder>(encodeBase64(makeBytes(100)), 99), std::runtime_error);
+    EXPECT_THROW(decode<HexDecoder>(encodeHex(makeBytes(100)), 99), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
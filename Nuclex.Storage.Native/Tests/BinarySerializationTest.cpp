@@ -0,0 +1,441 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BinarySerialization.h"
+#include "Nuclex/Storage/Binary/BinaryBlobReader.h"
+#include "Nuclex/Storage/Binary/BinaryBlobWriter.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Position in 3D space used to test serialization of nested types</summary>
+  struct Vector3 {
+    /// <summary>Coordinate on the X axis</summary>
+    public: float X;
+    /// <summary>Coordinate on the Y axis</summary>
+    public: float Y;
+    /// <summary>Coordinate on the Z axis</summary>
+    public: float Z;
+  };
+
+  /// <summary>Serializes a position in 3D space</summary>
+  /// <typeparam name="TArchive">Binary reader or writer used for serialization</typeparam>
+  /// <param name="archive">Binary reader or writer the position will be serialized with</param>
+  /// <param name="vector">Position that will be serialized</param>
+  template<typename TArchive>
+  void Serialize(TArchive &archive, Vector3 &vector) {
+    Serialize(archive, vector.X);
+    Serialize(archive, vector.Y);
+    Serialize(archive, vector.Z);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Game entity used to test serialization of user-defined types</summary>
+  struct Entity {
+    /// <summary>Unique id of the entity</summary>
+    public: std::uint32_t Id;
+    /// <summary>Name displayed for the entity</summary>
+    public: std::string Name;
+    /// <summary>Whether the entity is visible</summary>
+    public: bool IsVisible;
+    /// <summary>Health of the entity</summary>
+    public: std::int16_t Health;
+    /// <summary>Location of the entity</summary>
+    public: Vector3 Position;
+    /// <summary>Path the entity is following</summary>
+    public: std::vector<Vector3> Waypoints;
+    /// <summary>Amounts of each item the entity is carrying</summary>
+    public: std::vector<std::uint64_t> Inventory;
+    /// <summary>Opaque script state</summary>
+    public: std::vector<std::uint8_t> ScriptState;
+  };
+
+  /// <summary>Serializes a game entity</summary>
+  /// <typeparam name="TArchive">Binary reader or writer used for serialization</typeparam>
+  /// <param name="archive">Binary reader or writer the entity will be serialized with</param>
+  /// <param name="entity">Entity that will be serialized</param>
+  template<typename TArchive>
+  void Serialize(TArchive &archive, Entity &entity) {
+    Serialize(archive, entity.Id);
+    Serialize(archive, entity.Name);
+    Serialize(archive, entity.IsVisible);
+    Serialize(archive, entity.Health);
+    Serialize(archive, entity.Position);
+    Serialize(archive, entity.Waypoints);
+    Serialize(archive, entity.Inventory);
+    Serialize(archive, entity.ScriptState);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates an entity with some distinctive values</summary>
+  /// <param name="id">Id the entity will be created with</param>
+  /// <returns>The new entity</returns>
+  Entity makeEntity(std::uint32_t id) {
+    Entity entity;
+    entity.Id = id;
+    entity.Name = u8"Entity " + std::to_string(id);
+    entity.IsVisible = ((id % 2) == 0);
+    entity.Health = static_cast<std::int16_t>(100 - static_cast<int>(id));
+    entity.Position = Vector3 { 1.5f, -2.0f, static_cast<float>(id) };
+    for(std::uint32_t index = 0; index < id % 4; ++index) {
+      entity.Waypoints.push_back(Vector3 { static_cast<float>(index), 0.0f, 0.25f });
+      entity.Inventory.push_back(0x0123456789ABCDEFULL + index);
+      entity.ScriptState.push_back(static_cast<std::uint8_t>(id + index));
+    }
+    return entity;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether two entities hold the same values</summary>
+  /// <param name="expected">Entity holding the values that are expected</param>
+  /// <param name="actual">Entity whose values will be checked</param>
+  void expectEqual(const Entity &expected, const Entity &actual) {
+    EXPECT_EQ(actual.Id, expected.Id);
+    EXPECT_EQ(actual.Name, expected.Name);
+    EXPECT_EQ(actual.IsVisible, expected.IsVisible);
+    EXPECT_EQ(actual.Health, expected.Health);
+    EXPECT_EQ(actual.Position.Z, expected.Position.Z);
+    ASSERT_EQ(actual.Waypoints.size(), expected.Waypoints.size());
+    for(std::size_t index = 0; index < actual.Waypoints.size(); ++index) {
+      EXPECT_EQ(actual.Waypoints[index].X, expected.Waypoints[index].X);
+      EXPECT_EQ(actual.Waypoints[index].Z, expected.Waypoints[index].Z);
+    }
+    EXPECT_EQ(actual.Inventory, expected.Inventory);
+    EXPECT_EQ(actual.ScriptState, expected.ScriptState);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Vertex of a 3D model used to test packed field lists</summary>
+  struct Vertex {
+    /// <summary>Location of the vertex</summary>
+    public: float Position[3];
+    /// <summary>Color of the vertex as 32 bit RGBA value</summary>
+    public: std::uint32_t Color;
+
+    /// <summary>Lists the fields that will be serialized</summary>
+    /// <returns>A tuple describing the serializable fields</returns>
+    public: static constexpr auto GetFields() {
+      return std::make_tuple(
+        NUCLEX_STORAGE_FIELD(Vertex, Position),
+        NUCLEX_STORAGE_FIELD(Vertex, Color)
+      );
+    }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Packed structure whose field list disagrees with its memory layout</summary>
+  struct Swapped {
+    /// <summary>Field declared first but listed last</summary>
+    public: std::uint16_t First;
+    /// <summary>Field declared last but listed first</summary>
+    public: std::uint16_t Second;
+
+    /// <summary>Lists the fields that will be serialized</summary>
+    /// <returns>A tuple describing the serializable fields</returns>
+    public: static constexpr auto GetFields() {
+      return std::make_tuple(
+        NUCLEX_STORAGE_FIELD(Swapped, Second),
+        NUCLEX_STORAGE_FIELD(Swapped, First)
+      );
+    }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>3D model used to test field lists that can not be copied in bulk</summary>
+  struct Mesh {
+    /// <summary>Name of the mesh</summary>
+    public: std::string Name;
+    /// <summary>Vertices making up the mesh</summary>
+    public: std::vector<Vertex> Vertices;
+    /// <summary>Indices of the vertices forming the first two triangles</summary>
+    public: std::uint16_t Indices[6];
+    /// <summary>Whether the mesh is rendered with alpha blending</summary>
+    public: bool IsTransparent;
+
+    /// <summary>Lists the fields that will be serialized</summary>
+    /// <returns>A tuple describing the serializable fields</returns>
+    public: static constexpr auto GetFields() {
+      return std::make_tuple(
+        NUCLEX_STORAGE_FIELD(Mesh, Name),
+        NUCLEX_STORAGE_FIELD(Mesh, Vertices),
+        NUCLEX_STORAGE_FIELD(Mesh, Indices),
+        NUCLEX_STORAGE_FIELD(Mesh, IsTransparent)
+      );
+    }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a mesh with some distinctive values</summary>
+  /// <param name="vertexCount">Number of vertices the mesh will have</param>
+  /// <returns>The new mesh</returns>
+  Mesh makeMesh(std::size_t vertexCount) {
+    Mesh mesh;
+    mesh.Name = u8"Mesh with " + std::to_string(vertexCount) + u8" vertices";
+    for(std::size_t index = 0; index < vertexCount; ++index) {
+      Vertex vertex;
+      vertex.Position[0] = static_cast<float>(index);
+      vertex.Position[1] = -0.5f;
+      vertex.Position[2] = static_cast<float>(index) * 0.25f;
+      vertex.Color = 0xFF000000U + static_cast<std::uint32_t>(index);
+      mesh.Vertices.push_back(vertex);
+    }
+    for(std::size_t index = 0; index < 6; ++index) {
+      mesh.Indices[index] = static_cast<std::uint16_t>(index * 3 + 1);
+    }
+    mesh.IsTransparent = true;
+    return mesh;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether two meshes hold the same values</summary>
+  /// <param name="expected">Mesh holding the values that are expected</param>
+  /// <param name="actual">Mesh whose values will be checked</param>
+  void expectEqual(const Mesh &expected, const Mesh &actual) {
+    EXPECT_EQ(actual.Name, expected.Name);
+    ASSERT_EQ(actual.Vertices.size(), expected.Vertices.size());
+    for(std::size_t index = 0; index < actual.Vertices.size(); ++index) {
+      EXPECT_EQ(actual.Vertices[index].Position[0], expected.Vertices[index].Position[0]);
+      EXPECT_EQ(actual.Vertices[index].Position[1], expected.Vertices[index].Position[1]);
+      EXPECT_EQ(actual.Vertices[index].Position[2], expected.Vertices[index].Position[2]);
+      EXPECT_EQ(actual.Vertices[index].Color, expected.Vertices[index].Color);
+    }
+    for(std::size_t index = 0; index < 6; ++index) {
+      EXPECT_EQ(actual.Indices[index], expected.Indices[index]);
+    }
+    EXPECT_EQ(actual.IsTransparent, expected.IsTransparent);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinarySerializationTest, ConcreteReadersAndWritersAreFinal) {
+    EXPECT_TRUE(std::is_final<BinaryBlobReader>::value);
+    EXPECT_TRUE(std::is_final<BinaryBlobWriter>::value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinarySerializationTest, StructuresRoundTrip) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryBlobWriter writer(blob);
+      for(std::uint32_t id = 0; id < 100; ++id) {
+        Entity entity = makeEntity(id);
+        Serialize(writer, entity);
+      }
+    }
+
+    BinaryBlobReader reader(blob);
+    for(std::uint32_t id = 0; id < 100; ++id) {
+      Entity entity;
+      Serialize(reader, entity);
+      expectEqual(makeEntity(id), entity);
+    }
+    EXPECT_EQ(reader.GetRemainingBytes(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinarySerializationTest, AbstractReadersAndWritersCanBeUsed) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryBlobWriter blobWriter(blob);
+      blobWriter.SetLittleEndian(false);
+
+      BinaryWriter &writer = blobWriter;
+      Entity entity = makeEntity(7);
+      Serialize(writer, entity);
+    }
+
+    BinaryBlobReader blobReader(blob);
+    blobReader.SetLittleEndian(false);
+
+    BinaryReader &reader = blobReader;
+    Entity entity;
+    Serialize(reader, entity);
+    expectEqual(makeEntity(7), entity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinarySerializationTest, PackedFieldListsAreDetected) {
+    EXPECT_TRUE(HasFieldList<Vertex>::value);
+    EXPECT_TRUE(HasFieldList<Mesh>::value);
+    EXPECT_FALSE(HasFieldList<Entity>::value);
+    EXPECT_FALSE(HasFieldList<float>::value);
+
+    EXPECT_TRUE(IsPackedFieldList<Vertex>::value);
+    EXPECT_TRUE(IsPackedFieldList<Swapped>::value);
+    EXPECT_FALSE(IsPackedFieldList<Mesh>::value);
+    EXPECT_FALSE(IsPackedFieldList<Entity>::value);
+
+    EXPECT_TRUE(HasFieldsInMemoryOrder<Vertex>());
+    EXPECT_FALSE(HasFieldsInMemoryOrder<Swapped>());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinarySerializationTest, FieldListsRoundTripInBothByteOrders) {
+    const bool byteOrders[] = { true, false };
+    for(std::size_t orderIndex = 0; orderIndex < 2; ++orderIndex) {
+      std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+      {
+        BinaryBlobWriter writer(blob);
+        writer.SetLittleEndian(byteOrders[orderIndex]);
+        for(std::size_t vertexCount = 0; vertexCount < 50; vertexCount += 7) {
+          Mesh mesh = makeMesh(vertexCount);
+          Serialize(writer, mesh);
+        }
+      }
+
+      BinaryBlobReader reader(blob);
+      reader.SetLittleEndian(byteOrders[orderIndex]);
+      for(std::size_t vertexCount = 0; vertexCount < 50; vertexCount += 7) {
+        Mesh mesh;
+        Serialize(reader, mesh);
+        expectEqual(makeMesh(vertexCount), mesh);
+      }
+      EXPECT_EQ(reader.GetRemainingBytes(), 0U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinarySerializationTest, PackedStructuresMatchFieldByFieldLayout) {
+    Mesh mesh = makeMesh(3);
+
+    const bool byteOrders[] = { true, false };
+    for(std::size_t orderIndex = 0; orderIndex < 2; ++orderIndex) {
+      std::shared_ptr<MemoryBlob> bulkBlob = std::make_shared<MemoryBlob>();
+      {
+        BinaryBlobWriter writer(bulkBlob);
+        writer.SetLittleEndian(byteOrders[orderIndex]);
+        Serialize(writer, mesh.Vertices);
+      }
+
+      std::shared_ptr<MemoryBlob> manualBlob = std::make_shared<MemoryBlob>();
+      {
+        BinaryBlobWriter writer(manualBlob);
+        writer.SetLittleEndian(byteOrders[orderIndex]);
+        writer.Write(static_cast<std::uint32_t>(mesh.Vertices.size()));
+        for(const Vertex &vertex : mesh.Vertices) {
+          writer.Write(vertex.Position[0]);
+          writer.Write(vertex.Position[1]);
+          writer.Write(vertex.Position[2]);
+          writer.Write(vertex.Color);
+        }
+      }
+
+      ASSERT_EQ(bulkBlob->GetSize(), manualBlob->GetSize());
+      std::vector<std::uint8_t> bulkBytes(static_cast<std::size_t>(bulkBlob->GetSize()));
+      std::vector<std::uint8_t> manualBytes(bulkBytes.size());
+      bulkBlob->ReadAt(0, bulkBytes.data(), bulkBytes.size());
+      manualBlob->ReadAt(0, manualBytes.data(), manualBytes.size());
+      EXPECT_EQ(bulkBytes, manualBytes);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinarySerializationTest, FieldsAreStoredInFieldListOrder) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryBlobWriter writer(blob);
+      writer.SetLittleEndian(true);
+      Swapped swapped[2] = { { 0x1111, 0x2222 }, { 0x3333, 0x4444 } };
+      Serialize(writer, swapped);
+    }
+
+    std::uint8_t bytes[8];
+    ASSERT_EQ(blob->GetSize(), sizeof(bytes));
+    blob->ReadAt(0, bytes, sizeof(bytes));
+    EXPECT_EQ(bytes[0], 0x22);
+    EXPECT_EQ(bytes[2], 0x11);
+    EXPECT_EQ(bytes[4], 0x44);
+    EXPECT_EQ(bytes[6], 0x33);
+
+    BinaryBlobReader reader(blob);
+    reader.SetLittleEndian(true);
+    Swapped swapped[2];
+    Serialize(reader, swapped);
+    EXPECT_EQ(swapped[0].First, 0x1111U);
+    EXPECT_EQ(swapped[0].Second, 0x2222U);
+    EXPECT_EQ(swapped[1].First, 0x3333U);
+    EXPECT_EQ(swapped[1].Second, 0x4444U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinarySerializationTest, NumbersAreFlippedWhenEndiannessDiffers) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryBlobWriter writer(blob);
+      writer.SetLittleEndian(true);
+      writer.Write(static_cast<std::uint32_t>(0x11223344));
+      writer.SetLittleEndian(false);
+      writer.Write(static_cast<std::uint32_t>(0x11223344));
+      writer.Write(1.5);
+    }
+
+    std::uint8_t bytes[16];
+    blob->ReadAt(0, bytes, sizeof(bytes));
+    EXPECT_EQ(bytes[0], 0x44);
+    EXPECT_EQ(bytes[4], 0x11);
+    EXPECT_EQ(bytes[8], 0x3F); // sign and exponent of 1.5 come first in big endian
+
+    BinaryBlobReader reader(blob);
+    reader.SetLittleEndian(false);
+    reader.SetPosition(4);
+    std::uint32_t value;
+    reader.Read(value);
+    EXPECT_EQ(value, 0x11223344U);
+    double real;
+    reader.Read(real);
+    EXPECT_EQ(real, 1.5);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,295 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BinaryStreamReader.h"
+#include "Nuclex/Storage/Binary/BinaryStreamWriter.h"
+#include "Nuclex/Storage/Binary/MemoryPipe.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Input stream that hands out its bytes a few at a time</summary>
+  /// <remarks>
+  ///   Provides no spans, so the reader has to copy everything through its read buffer,
+  ///   and never provides more than three bytes unless more are explicitly required.
+  /// </remarks>
+  class TrickleStream : public Nuclex::Storage::Binary::InputStream {
+
+    /// <summary>Initializes a new trickle stream providing the specified bytes</summary>
+    /// <param name="contents">Bytes the stream will provide</param>
+    public: TrickleStream(const std::vector<std::uint8_t> &contents) :
+      contents(contents),
+      position(0) {}
+
+    /// <summary>Checks whether the stream has any more bytes to provide</summary>
+    /// <returns>True if there are bytes left in the stream</returns>
+    public: bool IsMoreDataAvailable() const override {
+      return (this->position < this->contents.size());
+    }
+
+    /// <summary>Reads up to the specified number of bytes from the stream</summary>
+    /// <param name="buffer">Buffer the bytes will be copied into</param>
+    /// <param name="byteCount">Maximum number of bytes, receives the number read</param>
+    /// <param name="requiredByteCount">Number of bytes that must at least be read</param>
+    /// <returns>True if the end of the stream was reached</returns>
+    public: bool ReadUpTo(
+      std::uint8_t *buffer, std::size_t &byteCount, std::size_t requiredByteCount = 1
+    ) override {
+      std::size_t remainingByteCount = this->contents.size() - this->position;
+      if(requiredByteCount > remainingByteCount) {
+        throw std::runtime_error(u8"Stream ended before the required bytes could be read");
+      }
+
+      byteCount = std::min(std::max<std::size_t>(requiredByteCount, 3), byteCount);
+      byteCount = std::min(byteCount, remainingByteCount);
+      std::memcpy(buffer, this->contents.data() + this->position, byteCount);
+      this->position += byteCount;
+
+      return (this->position >= this->contents.size());
+    }
+
+    /// <summary>Bytes the stream provides</summary>
+    private: std::vector<std::uint8_t> contents;
+    /// <summary>Index of the next byte the stream will provide</summary>
+    private: std::size_t position;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a mix of data types through a binary writer</summary>
+  /// <param name="writer">Writer the data will be written to</param>
+  void writeTestData(Nuclex::Storage::Binary::BinaryStreamWriter &writer) {
+    writer.Write(true);
+    writer.Write(std::uint8_t(12));
+    writer.Write(std::int16_t(-1234));
+    writer.Write(std::uint32_t(0x12345678));
+    writer.Write(std::int64_t(-1234567890123LL));
+    writer.Write(1.25f);
+    writer.Write(-2.5);
+    writer.Write(std::string(u8"Hello World"));
+    writer.WriteVarint(std::uint64_t(300));
+    writer.WriteVarint(std::int32_t(-5));
+
+    std::uint16_t values[] = { 1, 2, 3, 0xFF00 };
+    writer.WriteArray(values, 4);
+
+    std::uint32_t sorted[] = { 10, 20, 30, 100000 };
+    writer.WriteDeltaArray(sorted, 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads and checks the data written by writeTestData()</summary>
+  /// <param name="reader">Reader the data will be read from</param>
+  void verifyTestData(Nuclex::Storage::Binary::BinaryStreamReader &reader) {
+    bool flag; reader.Read(flag);
+    EXPECT_TRUE(flag);
+    std::uint8_t byte; reader.Read(byte);
+    EXPECT_EQ(12U, byte);
+    std::int16_t shortValue; reader.Read(shortValue);
+    EXPECT_EQ(-1234, shortValue);
+    std::uint32_t intValue; reader.Read(intValue);
+    EXPECT_EQ(0x12345678U, intValue);
+    std::int64_t longValue; reader.Read(longValue);
+    EXPECT_EQ(-1234567890123LL, longValue);
+    float floatValue; reader.Read(floatValue);
+    EXPECT_EQ(1.25f, floatValue);
+    double doubleValue; reader.Read(doubleValue);
+    EXPECT_EQ(-2.5, doubleValue);
+    std::string text; reader.Read(text);
+    EXPECT_EQ(u8"Hello World", text);
+    std::uint64_t varint; reader.ReadVarint(varint);
+    EXPECT_EQ(300U, varint);
+    std::int32_t signedVarint; reader.ReadVarint(signedVarint);
+    EXPECT_EQ(-5, signedVarint);
+
+    std::uint16_t values[4];
+    reader.ReadArray(values, 4);
+    EXPECT_EQ(1U, values[0]);
+    EXPECT_EQ(3U, values[2]);
+    EXPECT_EQ(0xFF00U, values[3]);
+
+    std::uint32_t sorted[4];
+    reader.ReadDeltaArray(sorted, 4);
+    EXPECT_EQ(10U, sorted[0]);
+    EXPECT_EQ(100000U, sorted[3]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryStreamReaderTest, DataRoundTripsThroughPipe) {
+    std::shared_ptr<MemoryPipe> pipe = std::make_shared<MemoryPipe>();
+    {
+      BinaryStreamWriter writer(pipe);
+      writeTestData(writer);
+    }
+    pipe->Close();
+    {
+      BinaryStreamReader reader(pipe);
+      verifyTestData(reader);
+    }
+
+    // The reader hands back the stream's memory when it is destroyed
+    EXPECT_FALSE(pipe->IsMoreDataAvailable());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryStreamReaderTest, EndiannessCanBeSwitched) {
+    std::shared_ptr<MemoryPipe> pipe = std::make_shared<MemoryPipe>();
+    {
+      BinaryStreamWriter writer(pipe);
+      writer.SetLittleEndian(false);
+      EXPECT_FALSE(writer.IsLittleEndian());
+      writeTestData(writer);
+    }
+
+    std::uint8_t header[5];
+    std::size_t headerByteCount = sizeof(header);
+    {
+      std::size_t availableByteCount;
+      const std::uint8_t *span = pipe->AcquireReadableSpan(availableByteCount);
+      ASSERT_GE(availableByteCount, headerByteCount);
+      std::memcpy(header, span, headerByteCount);
+      pipe->ConsumeReadableSpan(0);
+    }
+
+    // Boolean, byte, then the big endian 16 bit value -1234 (0xFB2E)
+    EXPECT_EQ(0x01U, header[0]);
+    EXPECT_EQ(0x0CU, header[1]);
+    EXPECT_EQ(0xFBU, header[2]);
+    EXPECT_EQ(0x2EU, header[3]);
+
+    BinaryStreamReader reader(pipe);
+    reader.SetLittleEndian(false);
+    verifyTestData(reader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryStreamReaderTest, ValuesSplitAcrossReadsAreReassembled) {
+    std::shared_ptr<MemoryPipe> pipe = std::make_shared<MemoryPipe>();
+    {
+      BinaryStreamWriter writer(pipe, 0);
+      writeTestData(writer);
+    }
+
+    std::vector<std::uint8_t> contents(pipe->CountAvailableBytes());
+    std::size_t byteCount = contents.size();
+    pipe->ReadUpTo(contents.data(), byteCount, byteCount);
+
+    BinaryStreamReader reader(std::make_shared<TrickleStream>(contents), 16);
+    verifyTestData(reader);
+    EXPECT_EQ(contents.size(), reader.GetPosition());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryStreamReaderTest, LargeArraysBypassReadBuffer) {
+    std::vector<std::uint32_t> values(10000);
+    for(std::size_t index = 0; index < values.size(); ++index) {
+      values[index] = static_cast<std::uint32_t>(index * 7);
+    }
+
+    std::shared_ptr<MemoryPipe> pipe = std::make_shared<MemoryPipe>();
+    {
+      BinaryStreamWriter writer(pipe, 256);
+      writer.Write(std::uint8_t(1));
+      writer.WriteArray(values.data(), values.size());
+      writer.Write(std::uint8_t(2));
+      EXPECT_EQ(values.size() * 4 + 2, writer.GetPosition());
+    }
+
+    std::vector<std::uint8_t> contents(pipe->CountAvailableBytes());
+    std::size_t byteCount = contents.size();
+    pipe->ReadUpTo(contents.data(), byteCount, byteCount);
+
+    BinaryStreamReader reader(std::make_shared<TrickleStream>(contents), 256);
+
+    std::uint8_t marker;
+    reader.Read(marker);
+    EXPECT_EQ(1U, marker);
+
+    std::vector<std::uint32_t> readValues(values.size());
+    reader.ReadArray(readValues.data(), readValues.size());
+    EXPECT_EQ(values, readValues);
+
+    reader.Read(marker);
+    EXPECT_EQ(2U, marker);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryStreamReaderTest, ReadingPastEndThrows) {
+    std::vector<std::uint8_t> contents = { 1, 2, 3 };
+    BinaryStreamReader reader(std::make_shared<TrickleStream>(contents));
+
+    std::uint16_t value;
+    reader.Read(value);
+
+    std::uint32_t tooLarge;
+    EXPECT_THROW(reader.Read(tooLarge), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryStreamReaderTest, DestroyedReaderLeavesUnreadBytesInStream) {
+    std::shared_ptr<MemoryPipe> pipe = std::make_shared<MemoryPipe>();
+    {
+      BinaryStreamWriter writer(pipe);
+      writer.Write(std::uint32_t(1));
+      writer.Write(std::uint32_t(2));
+      writer.Write(std::uint32_t(3));
+    }
+
+    {
+      BinaryStreamReader reader(pipe);
+      std::uint32_t value;
+      reader.Read(value);
+      EXPECT_EQ(1U, value);
+    }
+
+    // The pipe provides spans, so the reader only took the bytes it actually read
+    EXPECT_EQ(8U, pipe->CountAvailableBytes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,313 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/BinaryXmlBlobReader.h"
+#include "Nuclex/Storage/Xml/BinaryXmlBlobWriter.h"
+#include "Nuclex/Storage/Xml/XmlBlobReader.h"
+#include "Nuclex/Storage/Xml/XmlBlobWriter.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a small document with all kinds of values into an XML writer</summary>
+  /// <param name="writer">Writer the document will be written to</param>
+  /// <param name="data">Binary data that will be stored in the document</param>
+  void writeLevel(Nuclex::Storage::Xml::XmlWriter &writer, const std::vector<std::uint8_t> &data) {
+    writer.BeginElement(u8"level");
+    writer.BeginAttribute(u8"name");
+    writer.Write(std::string(u8"Dungeon"));
+    writer.EndAttribute();
+    writer.BeginAttribute(u8"version");
+    writer.Write(static_cast<std::uint32_t>(3));
+    writer.EndAttribute();
+
+    for(std::int32_t index = 0; index < 3; ++index) {
+      writer.BeginElement(u8"entity");
+      writer.BeginAttribute(u8"id");
+      writer.Write(-index);
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"scale");
+      writer.Write(0.5f + static_cast<float>(index));
+      writer.EndAttribute();
+      writer.EndElement();
+    }
+
+    writer.BeginElement(u8"height");
+    writer.Write(1234.5);
+    writer.EndElement();
+
+    writer.BeginElement(u8"mesh");
+    writer.Write(data.data(), data.size());
+    writer.EndElement();
+
+    writer.EndElement();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the document written by writeLevel() and checks its contents</summary>
+  /// <param name="reader">Reader the document will be read from</param>
+  /// <param name="data">Binary data that is expected in the document</param>
+  void checkLevel(Nuclex::Storage::Xml::XmlReader &reader, const std::vector<std::uint8_t> &data) {
+    using Nuclex::Storage::Xml::XmlReadEvent;
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), u8"level");
+    EXPECT_EQ(reader.GetAttributeValue<std::string>(u8"name"), u8"Dungeon");
+    EXPECT_EQ(reader.GetAttributeValue<std::uint32_t>(u8"version"), 3U);
+
+    for(std::int32_t index = 0; index < 3; ++index) {
+      ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+      EXPECT_EQ(reader.GetElementName(), u8"entity");
+      EXPECT_EQ(reader.CountAttributes(), 2U);
+      EXPECT_EQ(reader.GetAttributeValue<std::int32_t>(u8"id"), -index);
+      EXPECT_EQ(reader.GetAttributeValue<float>(u8"scale"), 0.5f + static_cast<float>(index));
+      ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+      EXPECT_EQ(reader.GetElementName(), u8"entity");
+    }
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), u8"height");
+    ASSERT_EQ(reader.Read(), XmlReadEvent::Content);
+    double height;
+    reader.Read(height);
+    EXPECT_EQ(height, 1234.5);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), u8"mesh");
+    ASSERT_EQ(reader.Read(), XmlReadEvent::Content);
+    std::vector<std::uint8_t> contents(data.size());
+    reader.Read(contents.data(), contents.size());
+    EXPECT_EQ(contents, data);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+    EXPECT_EQ(reader.GetElementName(), u8"level");
+    EXPECT_EQ(reader.Read(), XmlReadEvent::End);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates some binary data to store in a document</summary>
+  /// <returns>A vector with a few hundred bytes of binary data</returns>
+  std::vector<std::uint8_t> makeData() {
+    std::vector<std::uint8_t> data(300);
+    for(std::size_t index = 0; index < data.size(); ++index) {
+      data[index] = static_cast<std::uint8_t>(index * 13 + 7);
+    }
+    return data;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryXmlBlobReaderTest, DocumentsRoundTrip) {
+    std::vector<std::uint8_t> data = makeData();
+
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryXmlBlobWriter writer(blob);
+      writeLevel(writer, data);
+    }
+
+    EXPECT_TRUE(BinaryXmlBlobReader::IsBinaryXml(*blob));
+
+    BinaryXmlBlobReader reader(blob);
+    checkLevel(reader, data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryXmlBlobReaderTest, BinaryFormIsSmallerThanText) {
+    std::vector<std::uint8_t> data = makeData();
+
+    std::shared_ptr<MemoryBlob> textBlob = std::make_shared<MemoryBlob>();
+    {
+      XmlBlobWriter writer(textBlob);
+      writeLevel(writer, data);
+    }
+
+    std::shared_ptr<MemoryBlob> binaryBlob = std::make_shared<MemoryBlob>();
+    {
+      BinaryXmlBlobWriter writer(binaryBlob);
+      writeLevel(writer, data);
+    }
+
+    // As Base64, the binary data alone would take up 400 bytes
+    EXPECT_LT(binaryBlob->GetSize(), data.size() + 150);
+    EXPECT_LT(binaryBlob->GetSize(), textBlob->GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryXmlBlobReaderTest, NamesAreStoredOnlyOnce) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryXmlBlobWriter writer(blob);
+      writer.BeginElement(u8"level");
+      for(std::size_t index = 0; index < 100; ++index) {
+        writer.BeginElement(u8"entity");
+        writer.EndElement();
+      }
+      writer.EndElement();
+    }
+
+    std::vector<char> contents(static_cast<std::size_t>(blob->GetSize()));
+    blob->ReadAt(0, contents.data(), contents.size());
+
+    const std::string name(u8"entity");
+    std::vector<char>::const_iterator found = std::search(
+      contents.begin(), contents.end(), name.begin(), name.end()
+    );
+    ASSERT_NE(found, contents.end());
+    EXPECT_EQ(std::search(found + 1, contents.cend(), name.begin(), name.end()), contents.cend());
+
+    BinaryXmlBlobReader reader(blob);
+    const std::string &entity = reader.InternName(u8"entity");
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    for(std::size_t index = 0; index < 100; ++index) {
+      ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+      EXPECT_EQ(&reader.GetElementName(), &entity);
+      ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+    }
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+    EXPECT_EQ(reader.Read(), XmlReadEvent::End);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryXmlBlobReaderTest, ValuesCanBeReadAsOtherTypes) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryXmlBlobWriter writer(blob);
+      writer.BeginElement(u8"values");
+      writer.BeginAttribute(u8"count");
+      writer.Write(static_cast<std::uint16_t>(42));
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"text");
+      writer.Write(std::string(u8"-17"));
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"ratio");
+      writer.Write(0.25f);
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"flag");
+      writer.Write(true);
+      writer.EndAttribute();
+      writer.EndElement();
+    }
+
+    BinaryXmlBlobReader reader(blob);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetAttributeValue<std::string>(u8"count"), u8"42");
+    EXPECT_EQ(reader.GetAttributeValue<double>(u8"count"), 42.0);
+    EXPECT_EQ(reader.GetAttributeValue<std::int32_t>(u8"text"), -17);
+    EXPECT_EQ(reader.GetAttributeValue<std::string>(u8"ratio"), u8"0.25");
+    EXPECT_EQ(reader.GetAttributeValue<std::string>(u8"flag"), u8"true");
+    EXPECT_EQ(reader.GetAttributeValue<std::int32_t>(u8"missing", 5), 5);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryXmlBlobReaderTest, TextXmlCanBeConverted) {
+    std::vector<std::uint8_t> data = makeData();
+
+    std::shared_ptr<MemoryBlob> textBlob = std::make_shared<MemoryBlob>();
+    {
+      XmlBlobWriter writer(textBlob);
+      writer.WriteDeclaration();
+      writeLevel(writer, data);
+    }
+
+    std::shared_ptr<MemoryBlob> binaryBlob = std::make_shared<MemoryBlob>();
+    {
+      XmlBlobReader textReader(textBlob);
+      BinaryXmlBlobWriter writer(binaryBlob);
+      writer.CopyFrom(textReader);
+    }
+
+    BinaryXmlBlobReader reader(binaryBlob);
+    checkLevel(reader, data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryXmlBlobReaderTest, OtherDocumentsAreRejected) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      XmlBlobWriter writer(blob);
+      writer.BeginElement(u8"level");
+      writer.EndElement();
+    }
+
+    EXPECT_FALSE(BinaryXmlBlobReader::IsBinaryXml(*blob));
+    EXPECT_THROW(BinaryXmlBlobReader reader(blob), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryXmlBlobReaderTest, TruncatedDocumentsAreReported) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryXmlBlobWriter writer(blob);
+      writer.BeginElement(u8"level");
+      writer.BeginElement(u8"entity");
+      writer.EndElement();
+    }
+
+    BinaryXmlBlobReader reader(blob);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+    EXPECT_THROW(reader.Read(), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BinaryXmlBlobReaderTest, AttributesMustPrecedeContents) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    BinaryXmlBlobWriter writer(blob);
+
+    writer.BeginElement(u8"level");
+    writer.Write(std::string(u8"Hello"));
+    EXPECT_THROW(writer.BeginAttribute(u8"name"), std::logic_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
@@ -0,0 +1,200 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BlobInputStream.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a blob holding the bytes 0 through 255, repeated</summary>
+  /// <param name="byteCount">Number of bytes that will be written into the blob</param>
+  /// <returns>The new blob</returns>
+  std::shared_ptr<Nuclex::Storage::MemoryBlob> makeTestBlob(std::size_t byteCount) {
+    std::vector<std::uint8_t> pattern(byteCount);
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      pattern[index] = static_cast<std::uint8_t>(index);
+    }
+
+    std::shared_ptr<Nuclex::Storage::MemoryBlob> blob = (
+      std::make_shared<Nuclex::Storage::MemoryBlob>()
+    );
+    blob->WriteAt(0, &pattern[0], byteCount);
+    return blob;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobInputStreamTest, CanReadWholeBlob) {
+    BlobInputStream stream(makeTestBlob(1000));
+    EXPECT_TRUE(stream.IsMoreDataAvailable());
+
+    std::uint8_t buffer[1200];
+    std::size_t byteCount = sizeof(buffer);
+    EXPECT_TRUE(stream.ReadUpTo(buffer, byteCount));
+    EXPECT_EQ(1000U, byteCount);
+    EXPECT_EQ(231U, buffer[999]);
+    EXPECT_FALSE(stream.IsMoreDataAvailable());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobInputStreamTest, ThrowsIfRequiredBytesAreMissing) {
+    BlobInputStream stream(makeTestBlob(10));
+
+    std::uint8_t buffer[20];
+    std::size_t byteCount = sizeof(buffer);
+    EXPECT_THROW(stream.ReadUpTo(buffer, byteCount, 11), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobInputStreamTest, SealedBlobIsProvidedWithoutCopying) {
+    std::shared_ptr<MemoryBlob> blob = makeTestBlob(100000);
+    blob->Seal();
+
+    BlobInputStream stream(blob);
+
+    std::size_t byteCount;
+    const std::uint8_t *span = stream.AcquireReadableSpan(byteCount);
+    ASSERT_NE(nullptr, span);
+    EXPECT_EQ(100000U, byteCount);
+    EXPECT_EQ(blob->TryGetContiguousSpan(0, 100000), span);
+
+    stream.ConsumeReadableSpan(99990);
+    span = stream.AcquireReadableSpan(byteCount);
+    ASSERT_NE(nullptr, span);
+    EXPECT_EQ(10U, byteCount);
+    EXPECT_EQ(static_cast<std::uint8_t>(99990), span[0]);
+
+    stream.ConsumeReadableSpan(10);
+    EXPECT_EQ(nullptr, stream.AcquireReadableSpan(byteCount));
+    EXPECT_EQ(0U, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobInputStreamTest, UnsealedBlobIsProvidedInChunks) {
+    BlobInputStream stream(makeTestBlob(1000), 256);
+
+    std::size_t totalByteCount = 0;
+    std::size_t mismatchCount = 0;
+    for(;;) {
+      std::size_t byteCount;
+      const std::uint8_t *span = stream.AcquireReadableSpan(byteCount);
+      if(span == nullptr) {
+        break;
+      }
+
+      EXPECT_LE(byteCount, 256U);
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        if(span[index] != static_cast<std::uint8_t>(totalByteCount + index)) {
+          ++mismatchCount;
+        }
+      }
+
+      totalByteCount += byteCount;
+      stream.ConsumeReadableSpan(byteCount);
+    }
+
+    EXPECT_EQ(1000U, totalByteCount);
+    EXPECT_EQ(0U, mismatchCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobInputStreamTest, SpansAndReadsCanBeMixed) {
+    BlobInputStream stream(makeTestBlob(1000), 100);
+
+    std::size_t byteCount;
+    const std::uint8_t *span = stream.AcquireReadableSpan(byteCount);
+    ASSERT_NE(nullptr, span);
+    stream.ConsumeReadableSpan(40);
+    EXPECT_EQ(40U, stream.GetPosition());
+
+    // Takes the 60 bytes left in the span, then reads the rest from the blob
+    std::uint8_t buffer[200];
+    byteCount = sizeof(buffer);
+    EXPECT_FALSE(stream.ReadUpTo(buffer, byteCount));
+    EXPECT_EQ(200U, byteCount);
+    EXPECT_EQ(40U, buffer[0]);
+    EXPECT_EQ(239U, buffer[199]);
+    EXPECT_EQ(240U, stream.GetPosition());
+
+    EXPECT_THROW(stream.ConsumeReadableSpan(1), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobInputStreamTest, ReadAheadProvidesSameData) {
+    BlobInputStream stream(makeTestBlob(1000), 128, true);
+
+    // Mix spans and reads so both take chunks that have been read ahead
+    std::size_t totalByteCount = 0;
+    std::size_t mismatchCount = 0;
+    while(stream.IsMoreDataAvailable()) {
+      std::size_t byteCount;
+      const std::uint8_t *span = stream.AcquireReadableSpan(byteCount);
+      ASSERT_NE(nullptr, span);
+      if(byteCount > 50) {
+        byteCount = 50;
+      }
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        if(span[index] != static_cast<std::uint8_t>(totalByteCount + index)) {
+          ++mismatchCount;
+        }
+      }
+      stream.ConsumeReadableSpan(byteCount);
+      totalByteCount += byteCount;
+
+      std::uint8_t buffer[200];
+      byteCount = sizeof(buffer);
+      stream.ReadUpTo(buffer, byteCount, 0);
+      for(std::size_t index = 0; index < byteCount; ++index) {
+        if(buffer[index] != static_cast<std::uint8_t>(totalByteCount + index)) {
+          ++mismatchCount;
+        }
+      }
+      totalByteCount += byteCount;
+    }
+
+    EXPECT_EQ(1000U, totalByteCount);
+    EXPECT_EQ(0U, mismatchCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,147 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/BlobOutputStream.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory blob that counts how often it is written to</summary>
+  class CountingBlob : public Nuclex::Storage::MemoryBlob {
+
+    /// <summary>Initializes a new counting blob</summary>
+    public: CountingBlob() :
+      WriteCount(0) {}
+
+    /// <summary>Writes raw data into the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    public: void WriteAt(std::uint64_t location, const void *buffer, std::size_t count) override {
+      ++this->WriteCount;
+      MemoryBlob::WriteAt(location, buffer, count);
+    }
+
+    /// <summary>Number of times WriteAt() has been called</summary>
+    public: std::size_t WriteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobOutputStreamTest, SmallWritesAreCollected) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      BlobOutputStream stream(blob, 64);
+      for(std::size_t index = 0; index < 100; ++index) {
+        std::uint8_t value = static_cast<std::uint8_t>(index);
+        std::size_t byteCount = 1;
+        stream.WriteUpTo(&value, byteCount);
+        EXPECT_EQ(1U, byteCount);
+      }
+      EXPECT_EQ(100U, stream.GetPosition());
+      EXPECT_EQ(1U, blob->WriteCount);
+
+      stream.Flush();
+      EXPECT_EQ(2U, blob->WriteCount);
+    }
+
+    ASSERT_EQ(100U, blob->GetSize());
+    std::uint8_t last;
+    blob->ReadAt(99, &last, 1);
+    EXPECT_EQ(99U, last);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobOutputStreamTest, FillingProvidedBufferAvoidsCopy) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      BlobOutputStream stream(blob, 64);
+
+      std::size_t bufferSize;
+      std::uint8_t *buffer = stream.GetBuffer(bufferSize);
+      ASSERT_NE(nullptr, buffer);
+      EXPECT_EQ(64U, bufferSize);
+
+      buffer[0] = 'H';
+      buffer[1] = 'i';
+      std::size_t byteCount = 2;
+      stream.WriteUpTo(buffer, byteCount);
+
+      buffer = stream.GetBuffer(bufferSize);
+      EXPECT_EQ(62U, bufferSize);
+      buffer[0] = '!';
+      byteCount = 1;
+      stream.WriteUpTo(buffer, byteCount);
+      EXPECT_EQ(0U, blob->WriteCount);
+    }
+
+    ASSERT_EQ(3U, blob->GetSize());
+    char text[3];
+    blob->ReadAt(0, text, 3);
+    EXPECT_EQ(std::string(u8"Hi!"), std::string(text, 3));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobOutputStreamTest, WriteBehindDeliversAllData) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+
+    std::vector<std::uint8_t> pattern(10000);
+    for(std::size_t index = 0; index < pattern.size(); ++index) {
+      pattern[index] = static_cast<std::uint8_t>(index * 7);
+    }
+    {
+      BlobOutputStream stream(blob, 1000, true);
+      for(std::size_t offset = 0; offset < pattern.size(); offset += 300) {
+        std::size_t byteCount = std::min<std::size_t>(300, pattern.size() - offset);
+        stream.WriteUpTo(&pattern[offset], byteCount);
+      }
+      stream.Flush();
+    }
+
+    ASSERT_EQ(pattern.size(), blob->GetSize());
+    std::vector<std::uint8_t> contents(pattern.size());
+    blob->ReadAt(0, &contents[0], contents.size());
+    EXPECT_EQ(pattern, contents);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,148 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/BlobSlice.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "Nuclex/Storage/Binary/BinaryBlobReader.h"
+#include <gtest/gtest.h>
+
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a memory blob holding the numbers from 0 to 99</summary>
+  /// <returns>The new memory blob</returns>
+  std::shared_ptr<Nuclex::Storage::MemoryBlob> createCountingBlob() {
+    std::shared_ptr<Nuclex::Storage::MemoryBlob> blob = (
+      std::make_shared<Nuclex::Storage::MemoryBlob>()
+    );
+    for(std::uint8_t index = 0; index < 100; ++index) {
+      blob->WriteAt(index, &index, 1);
+    }
+    return blob;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobSliceTest, ReadsAreRelativeToTheSlice) {
+    BlobSlice slice(createCountingBlob(), 20, 30);
+    EXPECT_EQ(slice.GetSize(), 30U);
+    EXPECT_EQ(slice.GetOffset(), 20U);
+
+    std::uint8_t bytes[5];
+    slice.ReadAt(25, bytes, 5);
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(bytes[index], 45 + index);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobSliceTest, ReadsCanNotLeaveTheSlice) {
+    BlobSlice slice(createCountingBlob(), 20, 30);
+
+    std::uint8_t bytes[5];
+    EXPECT_THROW(slice.ReadAt(26, bytes, 5), std::out_of_range);
+    EXPECT_THROW(slice.ReadAtAsync(26, bytes, 5).get(), std::out_of_range);
+    EXPECT_EQ(slice.TryGetContiguousSpan(26, 5), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobSliceTest, SliceMustLieWithinParent) {
+    std::shared_ptr<MemoryBlob> parent = createCountingBlob();
+    EXPECT_NO_THROW(BlobSlice(parent, 100, 0));
+    EXPECT_THROW(BlobSlice(parent, 90, 11), std::out_of_range);
+    EXPECT_THROW(BlobSlice(parent, 101, 0), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobSliceTest, ContiguousSpansAreForwardedWithoutCopying) {
+    std::shared_ptr<MemoryBlob> parent = createCountingBlob();
+    parent->Seal(); // Memory blobs only hand out their memory once they're sealed
+    BlobSlice slice(parent, 10, 50);
+
+    const std::uint8_t *span = slice.TryGetContiguousSpan(5, 20);
+    ASSERT_NE(span, nullptr);
+    EXPECT_EQ(span, parent->TryGetContiguousSpan(15, 20));
+    EXPECT_EQ(span[0], 15);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobSliceTest, AsynchronousReadsAreForwarded) {
+    BlobSlice slice(createCountingBlob(), 40, 10);
+
+    std::uint8_t first[2], second[3];
+    BlobReadRequest requests[2] = { { 0, first, 2 }, { 7, second, 3 } };
+    std::vector<std::future<void>> completions = slice.ReadAtAsync(requests, 2);
+    ASSERT_EQ(completions.size(), 2U);
+    completions[0].get();
+    completions[1].get();
+
+    EXPECT_EQ(first[0], 40);
+    EXPECT_EQ(first[1], 41);
+    EXPECT_EQ(second[2], 49);
+
+    requests[1].Location = 8;
+    completions = slice.ReadAtAsync(requests, 2);
+    EXPECT_NO_THROW(completions[0].get());
+    EXPECT_THROW(completions[1].get(), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobSliceTest, BinaryReaderCanReadFromSlice) {
+    std::shared_ptr<const Blob> slice = std::make_shared<BlobSlice>(
+      createCountingBlob(), 64, 8
+    );
+    Binary::BinaryBlobReader reader(slice);
+
+    std::uint8_t value;
+    reader.Read(value);
+    EXPECT_EQ(value, 64);
+    EXPECT_EQ(reader.GetRemainingBytes(), 7U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlobSliceTest, SlicesAreReadOnly) {
+    BlobSlice slice(createCountingBlob(), 0, 10);
+    EXPECT_THROW(slice.WriteAt(0, u8"X", 1), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
@@ -0,0 +1,323 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/BlockCompressedBlob.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+#include "Nuclex/Storage/Binary/BinaryBlobReader.h"
+#include "Nuclex/Storage/Xml/XmlBlobReader.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "../Source/Compression/ZLib/DeflateCompressionAlgorithm.h"
+#include "MemoryBlobFactory.h"
+#include "CompressionRoundTrip.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory blob that counts how often it is read from</summary>
+  class CountingBlob : public Nuclex::Storage::MemoryBlob {
+
+    /// <summary>Initializes a new counting blob</summary>
+    public: CountingBlob() :
+      ReadCount(0) {}
+
+    /// <summary>Reads raw data from the blob</summary>
+    /// <param name="location">Absolute position data will be read from</param>
+    /// <param name="buffer">Buffer into which data will be read</param>
+    /// <param name="count">Number of bytes that will be read</param>
+    public: void ReadAt(std::uint64_t location, void *buffer, std::size_t count) const override {
+      ++this->ReadCount;
+      MemoryBlob::ReadAt(location, buffer, count);
+    }
+
+    /// <summary>Number of times ReadAt() has been called</summary>
+    public: mutable std::size_t ReadCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, DataSurvivesRoundTrip) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    std::vector<std::uint8_t> data = MakeCompressibleData(100000);
+    std::shared_ptr<MemoryBlob> source = MakeMemoryBlob(data);
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+
+    std::uint64_t containerByteCount = BlockCompressedBlob::Compress(
+      *deflate, *source, *container, 4096, 4
+    );
+    EXPECT_EQ(containerByteCount, container->GetSize());
+    EXPECT_LT(containerByteCount, data.size());
+
+    BlockCompressedBlob blob(container, deflate);
+    EXPECT_EQ(blob.GetSize(), data.size());
+    EXPECT_EQ(blob.CountBlocks(), 25U);
+    EXPECT_EQ(blob.GetBlockByteCount(), 4096U);
+
+    std::vector<std::uint8_t> uncompressed(data.size());
+    blob.ReadAt(0, uncompressed.data(), uncompressed.size());
+    EXPECT_EQ(uncompressed, data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, ArbitraryRangesCanBeRead) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    std::vector<std::uint8_t> data = MakeCompressibleData(50000);
+    std::shared_ptr<MemoryBlob> source = MakeMemoryBlob(data);
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    BlockCompressedBlob::Compress(*deflate, *source, *container, 4096, 2);
+
+    BlockCompressedBlob blob(container, deflate);
+
+    // Inside a block, across a block boundary, spanning whole blocks and the short tail
+    const std::size_t ranges[][2] = {
+      { 100, 50 }, { 4000, 200 }, { 4000, 9000 }, { 8192, 8192 }, { 49000, 1000 }
+    };
+    for(std::size_t index = 0; index < sizeof(ranges) / sizeof(ranges[0]); ++index) {
+      std::vector<std::uint8_t> range(ranges[index][1]);
+      blob.ReadAt(ranges[index][0], range.data(), range.size());
+      EXPECT_TRUE(std::equal(range.begin(), range.end(), data.begin() + ranges[index][0]));
+    }
+
+    std::uint8_t dummy;
+    EXPECT_THROW(blob.ReadAt(49999, &dummy, 2), std::out_of_range);
+    EXPECT_THROW(blob.WriteAt(0, &dummy, 1), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, AllBlocksCanBeDecompressedInParallel) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(1)
+    );
+    std::vector<std::uint8_t> data = MakeCompressibleData(70000);
+    std::shared_ptr<MemoryBlob> source = MakeMemoryBlob(data);
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    BlockCompressedBlob::Compress(*deflate, *source, *container, 1000, 3);
+
+    CompressionAlgorithmSelector selector;
+    selector.AddAlgorithm(deflate);
+    BlockCompressedBlob blob(container, selector);
+
+    MemoryBlob target;
+    blob.DecompressAll(target, 3);
+    ASSERT_EQ(target.GetSize(), data.size());
+
+    std::vector<std::uint8_t> uncompressed(data.size());
+    target.ReadAt(0, uncompressed.data(), uncompressed.size());
+    EXPECT_EQ(uncompressed, data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, RecentlyReadBlocksAreCached) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    std::vector<std::uint8_t> data = MakeCompressibleData(40000);
+    std::shared_ptr<MemoryBlob> source = MakeMemoryBlob(data);
+    std::shared_ptr<CountingBlob> container = std::make_shared<CountingBlob>();
+    BlockCompressedBlob::Compress(*deflate, *source, *container, 4096, 1);
+
+    BlockCompressedBlob blob(container, deflate, 2);
+    std::size_t initialReadCount = container->ReadCount;
+
+    // Alternating between two blocks only decompresses each of them once
+    std::uint8_t value;
+    for(std::size_t index = 0; index < 100; ++index) {
+      blob.ReadAt((index % 2) * 4096 + index, &value, 1);
+      ASSERT_EQ(value, data[(index % 2) * 4096 + index]);
+    }
+    EXPECT_EQ(container->ReadCount, initialReadCount + 2);
+
+    // A third block evicts the least recently used one
+    blob.ReadAt(8192, &value, 1);
+    blob.ReadAt(4096, &value, 1);
+    EXPECT_EQ(container->ReadCount, initialReadCount + 3);
+    blob.ReadAt(0, &value, 1);
+    EXPECT_EQ(container->ReadCount, initialReadCount + 4);
+
+    EXPECT_THROW(BlockCompressedBlob(container, deflate, 0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, BinaryReaderCanReadCompressedData) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    MemoryBlob source;
+    for(std::uint32_t index = 0; index < 10000; ++index) {
+      source.WriteAt(index * sizeof(index), &index, sizeof(index));
+    }
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    BlockCompressedBlob::Compress(*deflate, source, *container, 4096, 2);
+
+    Binary::BinaryBlobReader reader(std::make_shared<BlockCompressedBlob>(container, deflate));
+    for(std::uint32_t index = 0; index < 10000; ++index) {
+      std::uint32_t value;
+      reader.Read(value);
+      ASSERT_EQ(index, value);
+    }
+    EXPECT_EQ(0U, reader.GetRemainingBytes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, XmlReaderCanReadCompressedData) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    std::string xml(u8"<?xml version=\"1.0\"?><pack>");
+    for(std::size_t index = 0; index < 500; ++index) {
+      xml.append(u8"<entry name=\"asset\" />");
+    }
+    xml.append(u8"</pack>");
+    std::shared_ptr<MemoryBlob> source = MakeMemoryBlob(
+      std::vector<std::uint8_t>(xml.begin(), xml.end())
+    );
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    BlockCompressedBlob::Compress(*deflate, *source, *container, 1024, 2);
+
+    Xml::XmlBlobReader reader(std::make_shared<BlockCompressedBlob>(container, deflate));
+    ASSERT_EQ(reader.Read(), Xml::XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), std::string(u8"pack"));
+
+    std::size_t entryCount = 0;
+    for(;;) {
+      Xml::XmlReadEvent readEvent = reader.Read();
+      if(readEvent == Xml::XmlReadEvent::ElementStart) {
+        ++entryCount;
+      } else if(readEvent == Xml::XmlReadEvent::End) {
+        break;
+      }
+    }
+    EXPECT_EQ(entryCount, 500U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, EmptyBlobCanBeCompressed) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    MemoryBlob source;
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    BlockCompressedBlob::Compress(*deflate, source, *container);
+
+    BlockCompressedBlob blob(container, deflate);
+    EXPECT_EQ(blob.GetSize(), 0U);
+    EXPECT_EQ(blob.CountBlocks(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, MismatchedOrDamagedContainersAreRejected) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    std::vector<std::uint8_t> data = MakeCompressibleData(10000);
+    std::shared_ptr<MemoryBlob> source = MakeMemoryBlob(data);
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    BlockCompressedBlob::Compress(*deflate, *source, *container, 4096, 1);
+
+    CompressionAlgorithmSelector emptySelector;
+    EXPECT_THROW(BlockCompressedBlob(container, emptySelector), std::runtime_error);
+
+    std::uint8_t garbage = 'X';
+    container->WriteAt(0, &garbage, 1);
+    EXPECT_THROW(BlockCompressedBlob(container, deflate), std::runtime_error);
+    EXPECT_THROW(BlockCompressedBlob(source, deflate), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(BlockCompressedBlobTest, DamagedBlocksAreDetectedWithChecksums) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    std::vector<std::uint8_t> data = MakeCompressibleData(20000);
+    std::shared_ptr<MemoryBlob> source = MakeMemoryBlob(data);
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    std::uint64_t containerByteCount = BlockCompressedBlob::Compress(
+      *deflate, *source, *container, 4096, 2, true
+    );
+    EXPECT_EQ(container->GetSize(), containerByteCount);
+
+    {
+      BlockCompressedBlob blob(container, deflate);
+      EXPECT_TRUE(blob.HasChecksums());
+
+      std::vector<std::uint8_t> contents(data.size());
+      blob.ReadAt(0, contents.data(), contents.size());
+      EXPECT_EQ(data, contents);
+    }
+
+    // Flip a bit in the middle of the second block
+    std::uint64_t secondBlockLocation;
+    {
+      std::uint8_t indexLocation[8];
+      container->ReadAt(32, indexLocation, 8);
+      std::uint64_t location = 0;
+      for(std::size_t index = 0; index < 8; ++index) {
+        location |= static_cast<std::uint64_t>(indexLocation[index]) << (index * 8);
+      }
+      std::uint8_t secondBlockOffset[8];
+      container->ReadAt(location + 8, secondBlockOffset, 8);
+      secondBlockLocation = 0;
+      for(std::size_t index = 0; index < 8; ++index) {
+        secondBlockLocation |= static_cast<std::uint64_t>(secondBlockOffset[index]) << (index * 8);
+      }
+    }
+    std::uint8_t byte;
+    container->ReadAt(secondBlockLocation + 20, &byte, 1);
+    byte ^= 0x10;
+    container->WriteAt(secondBlockLocation + 20, &byte, 1);
+
+    BlockCompressedBlob blob(container, deflate);
+    std::vector<std::uint8_t> block(blob.GetBlockByteCount());
+    EXPECT_EQ(4096U, blob.DecompressBlock(0, block.data()));
+    EXPECT_THROW(blob.DecompressBlock(1, block.data()), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
@@ -0,0 +1,177 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/ChunkStore.h"
+#include "Nuclex/Storage/Compression/ChunkedBlob.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "../Source/Compression/ZLib/DeflateCompressionAlgorithm.h"
+#include "MemoryBlobFactory.h"
+#include "RandomDataFactory.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkStoreTest, DataSurvivesRoundTrip) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    std::shared_ptr<ChunkStore> store = std::make_shared<ChunkStore>(
+      std::make_shared<MemoryBlob>(), deflate
+    );
+
+    std::vector<std::uint8_t> data = MakeRandomData(200000, 12345);
+    std::vector<ChunkReference> chunks = store->Store(*MakeMemoryBlob(data), 4096);
+    EXPECT_GT(chunks.size(), 10U);
+    EXPECT_EQ(chunks.size(), store->CountChunks());
+
+    ChunkedBlob blob(store, chunks);
+    EXPECT_EQ(data.size(), blob.GetSize());
+    EXPECT_EQ(data, ReadBlobContents(blob));
+
+    // Reads that start and end in the middle of chunks go through the cached chunk
+    std::vector<std::uint8_t> range(10000);
+    blob.ReadAt(12345, range.data(), range.size());
+    EXPECT_TRUE(std::equal(range.begin(), range.end(), data.begin() + 12345));
+    EXPECT_THROW(blob.ReadAt(data.size() - 10, range.data(), 11), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkStoreTest, InMemoryAndStreamedSourcesAreCutIdentically) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(1)
+    );
+    ChunkStore store(std::make_shared<MemoryBlob>(), deflate);
+
+    // The chunker is given the maximum chunk size (32 KiB here) at a time when it reads
+    // from a blob that can't provide its contents in one piece
+    std::vector<std::uint8_t> data = MakeRandomData(500000, 54321);
+    std::shared_ptr<MemoryBlob> streamed = MakeMemoryBlob(data);
+    std::shared_ptr<MemoryBlob> sealed = MakeMemoryBlob(data);
+    sealed->Seal();
+
+    std::vector<ChunkReference> streamedChunks = store.Store(*streamed, 4096);
+    std::vector<ChunkReference> sealedChunks = store.Store(*sealed, 4096);
+    ASSERT_EQ(streamedChunks.size(), sealedChunks.size());
+    for(std::size_t index = 0; index < streamedChunks.size(); ++index) {
+      EXPECT_EQ(streamedChunks[index].Hash, sealedChunks[index].Hash);
+      EXPECT_EQ(streamedChunks[index].ByteCount, sealedChunks[index].ByteCount);
+    }
+    EXPECT_EQ(streamedChunks.size(), store.CountChunks());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkStoreTest, EditedVersionsShareMostChunks) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    std::shared_ptr<ChunkStore> store = std::make_shared<ChunkStore>(container, deflate);
+
+    std::vector<std::uint8_t> original = MakeRandomData(400000, 777);
+    std::vector<ChunkReference> originalChunks = store->Store(*MakeMemoryBlob(original), 4096);
+    std::size_t originalChunkCount = store->CountChunks();
+    std::uint64_t originalContainerByteCount = container->GetSize();
+
+    // Insert a few bytes near the start, which shifts everything behind them
+    std::vector<std::uint8_t> edited(original);
+    edited.insert(edited.begin() + 1000, 17, std::uint8_t(0xAA));
+    std::vector<ChunkReference> editedChunks = store->Store(*MakeMemoryBlob(edited), 4096);
+
+    std::size_t newChunkCount = store->CountChunks() - originalChunkCount;
+    EXPECT_LE(newChunkCount, 3U);
+    EXPECT_LT(container->GetSize() - originalContainerByteCount, 4096U * 8);
+
+    EXPECT_EQ(original, ReadBlobContents(ChunkedBlob(store, originalChunks)));
+    EXPECT_EQ(edited, ReadBlobContents(ChunkedBlob(store, editedChunks)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkStoreTest, ExistingStoreCanBeReopened) {
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    std::vector<std::uint8_t> data = MakeRandomData(100000, 999);
+    std::vector<ChunkReference> chunks;
+    {
+      ChunkStore store(container, std::make_shared<ZLib::DeflateCompressionAlgorithm>(6));
+      chunks = store.Store(*MakeMemoryBlob(data), 1024);
+    }
+
+    CompressionAlgorithmSelector selector;
+    selector.AddBuiltInAlgorithms();
+    std::shared_ptr<ChunkStore> store = std::make_shared<ChunkStore>(container, selector);
+    EXPECT_EQ(chunks.size(), store->CountChunks());
+    for(std::size_t index = 0; index < chunks.size(); ++index) {
+      EXPECT_TRUE(store->Contains(chunks[index].Hash));
+    }
+    EXPECT_EQ(data, ReadBlobContents(ChunkedBlob(store, chunks)));
+
+    // Storing the same data again must not add anything to the container
+    std::uint64_t containerByteCount = container->GetSize();
+    store->Store(*MakeMemoryBlob(data), 1024);
+    EXPECT_EQ(containerByteCount, container->GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChunkStoreTest, MismatchedOrDamagedContainersAreRejected) {
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    {
+      ChunkStore store(container, std::make_shared<ZLib::DeflateCompressionAlgorithm>(6));
+      store.Store(*MakeMemoryBlob(MakeRandomData(10000, 1)), 1024);
+    }
+
+    CompressionAlgorithmSelector emptySelector;
+    EXPECT_THROW(ChunkStore(container, emptySelector), std::runtime_error);
+
+    std::shared_ptr<MemoryBlob> truncated = std::make_shared<MemoryBlob>();
+    std::vector<std::uint8_t> data = ReadBlobContents(*container);
+    truncated->WriteAt(0, data.data(), data.size() - 1);
+    EXPECT_THROW(
+      ChunkStore(truncated, std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)),
+      std::runtime_error
+    );
+
+    std::uint8_t garbage = 'X';
+    container->WriteAt(0, &garbage, 1);
+    EXPECT_THROW(
+      ChunkStore(container, std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)),
+      std::runtime_error
+    );
+
+    std::shared_ptr<MemoryBlob> empty = std::make_shared<MemoryBlob>();
+    EXPECT_THROW(ChunkStore(empty, emptySelector), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
@@ -0,0 +1,219 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+#include "../Source/Compression/ZLib/DeflateCompressionAlgorithm.h"
+#include "CompressionRoundTrip.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compression algorithm that only reports fixed metrics</summary>
+  class FakeCompressionAlgorithm : public Nuclex::Storage::Compression::CompressionAlgorithm {
+
+    /// <summary>Initializes a new fake compression algorithm</summary>
+    /// <param name="tag">Character that will be used as the first byte of the ID</param>
+    /// <param name="cyclesPerKilobyte">Cycles the algorithm will claim to need</param>
+    /// <param name="compressionRatio">Compression ratio the algorithm will claim</param>
+    public: FakeCompressionAlgorithm(
+      char tag, std::size_t cyclesPerKilobyte, float compressionRatio
+    ) :
+      name(1, tag),
+      tag(tag),
+      cyclesPerKilobyte(cyclesPerKilobyte),
+      compressionRatio(compressionRatio) {}
+
+    /// <summary>Returns the human-readable name of the compression algorithm</summary>
+    /// <returns>The name of the compression algorithm the factory provides</returns>
+    public: const std::string &GetName() const override {
+      return this->name;
+    }
+
+    /// <summary>Returns a unique id for the compression algorithm</summary>
+    /// <returns>The compression algorithm's unique id</returns>
+    public: std::array<std::uint8_t, 8> GetId() const override {
+      return std::array<std::uint8_t, 8> {
+        static_cast<std::uint8_t>(this->tag), 'F', 'A', 'K', '0', '0', '0', '1'
+      };
+    }
+
+    /// <summary>Returns the number of CPU cycles the algorithm claims to need</summary>
+    /// <returns>The number of CPU cycles needed to compress one kilobyte</returns>
+    public: std::size_t GetCompressionCyclesPerKilobyte() const override {
+      return this->cyclesPerKilobyte;
+    }
+
+    /// <summary>Returns the compression ratio the algorithm claims to achieve</summary>
+    /// <returns>The ratio of compressed size to uncompressed size</returns>
+    public: float GetAverageCompressionRatio() const override {
+      return this->compressionRatio;
+    }
+
+    /// <summary>Not supported by the fake compression algorithm</summary>
+    /// <returns>Nothing, always throws</returns>
+    public: std::unique_ptr<Nuclex::Storage::Compression::Compressor>
+    CreateCompressor() const override {
+      throw std::logic_error(u8"Fake compression algorithm can not compress");
+    }
+
+    /// <summary>Not supported by the fake compression algorithm</summary>
+    /// <returns>Nothing, always throws</returns>
+    public: std::unique_ptr<Nuclex::Storage::Compression::Decompressor>
+    CreateDecompressor() const override {
+      throw std::logic_error(u8"Fake compression algorithm can not decompress");
+    }
+
+    /// <summary>Name of the fake compression algorithm</summary>
+    private: std::string name;
+    /// <summary>Character used as the first byte of the ID</summary>
+    private: char tag;
+    /// <summary>Cycles the algorithm claims to need per kilobyte</summary>
+    private: std::size_t cyclesPerKilobyte;
+    /// <summary>Compression ratio the algorithm claims to achieve</summary>
+    private: float compressionRatio;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompressionAlgorithmSelectorTest, SelectsFastestAlgorithmReachingRatio) {
+    CompressionAlgorithmSelector selector;
+    selector.AddAlgorithm(std::make_shared<FakeCompressionAlgorithm>('A', 1000, 0.6f));
+    selector.AddAlgorithm(std::make_shared<FakeCompressionAlgorithm>('B', 5000, 0.4f));
+    selector.AddAlgorithm(std::make_shared<FakeCompressionAlgorithm>('C', 50000, 0.3f));
+
+    EXPECT_EQ(selector.SelectFastest()->GetName(), std::string(u8"A"));
+    EXPECT_EQ(selector.SelectFastest(0.5f)->GetName(), std::string(u8"B"));
+    EXPECT_EQ(selector.SelectFastest(0.3f)->GetName(), std::string(u8"C"));
+    EXPECT_FALSE(static_cast<bool>(selector.SelectFastest(0.2f)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompressionAlgorithmSelectorTest, SelectsStrongestAlgorithmWithinBudget) {
+    CompressionAlgorithmSelector selector;
+    selector.AddAlgorithm(std::make_shared<FakeCompressionAlgorithm>('A', 1000, 0.6f));
+    selector.AddAlgorithm(std::make_shared<FakeCompressionAlgorithm>('B', 5000, 0.4f));
+    selector.AddAlgorithm(std::make_shared<FakeCompressionAlgorithm>('C', 50000, 0.3f));
+
+    EXPECT_EQ(selector.SelectStrongest(100000)->GetName(), std::string(u8"C"));
+    EXPECT_EQ(selector.SelectStrongest(10000)->GetName(), std::string(u8"B"));
+    EXPECT_EQ(selector.SelectStrongest(1000)->GetName(), std::string(u8"A"));
+    EXPECT_FALSE(static_cast<bool>(selector.SelectStrongest(500)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompressionAlgorithmSelectorTest, AlgorithmsCanBeLookedUpById) {
+    CompressionAlgorithmSelector selector;
+    selector.AddAlgorithm(std::make_shared<FakeCompressionAlgorithm>('A', 1000, 0.6f));
+    selector.AddAlgorithm(std::make_shared<FakeCompressionAlgorithm>('B', 5000, 0.4f));
+
+    std::shared_ptr<const CompressionAlgorithm> algorithm = selector.SelectStrongest(10000);
+    ASSERT_TRUE(static_cast<bool>(algorithm));
+    EXPECT_EQ(selector.GetAlgorithm(algorithm->GetId()), algorithm);
+
+    std::array<std::uint8_t, 8> unknownId = { 'X', 'F', 'A', 'K', '0', '0', '0', '1' };
+    EXPECT_FALSE(static_cast<bool>(selector.GetAlgorithm(unknownId)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompressionAlgorithmSelectorTest, AlgorithmsCanBeEnumerated) {
+    std::shared_ptr<const CompressionAlgorithm> first = (
+      std::make_shared<FakeCompressionAlgorithm>('A', 1000, 0.6f)
+    );
+    std::shared_ptr<const CompressionAlgorithm> second = (
+      std::make_shared<FakeCompressionAlgorithm>('B', 5000, 0.4f)
+    );
+
+    CompressionAlgorithmSelector selector;
+    selector.AddAlgorithm(first);
+    selector.AddAlgorithm(second);
+
+    ASSERT_EQ(selector.CountAlgorithms(), 2U);
+    EXPECT_EQ(selector.GetAlgorithm(0), first);
+    EXPECT_EQ(selector.GetAlgorithm(1), second);
+    EXPECT_THROW(selector.GetAlgorithm(2), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompressionAlgorithmSelectorTest, CalibrationMeasuresActualData) {
+    std::shared_ptr<const CompressionAlgorithm> deflate = (
+      std::make_shared<ZLib::DeflateCompressionAlgorithm>(6)
+    );
+
+    CompressionAlgorithmSelector selector;
+    selector.AddAlgorithm(deflate);
+    EXPECT_EQ(
+      selector.GetMetrics(*deflate).CompressionCyclesPerKilobyte,
+      deflate->GetCompressionCyclesPerKilobyte()
+    );
+
+    // The test data is far more compressible than the average file
+    std::vector<std::uint8_t> sample = MakeCompressibleData(65536);
+    selector.Calibrate(sample.data(), sample.size());
+
+    CompressionMetrics metrics = selector.GetMetrics(*deflate);
+    EXPECT_GT(metrics.CompressionCyclesPerKilobyte, 0U);
+    EXPECT_LT(metrics.CompressionRatio, deflate->GetAverageCompressionRatio());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompressionAlgorithmSelectorTest, BuiltInAlgorithmsCanBeAdded) {
+    CompressionAlgorithmSelector selector;
+    selector.AddBuiltInAlgorithms();
+    EXPECT_GE(selector.CountAlgorithms(), 3U);
+
+    std::array<std::uint8_t, 8> deflateId = { 'D', 'F', 'L', 'T', '0', '0', '0', '1' };
+    EXPECT_TRUE(static_cast<bool>(selector.GetAlgorithm(deflateId)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CompressionAlgorithmSelectorTest, EmptySampleIsRejected) {
+    ZLib::DeflateCompressionAlgorithm deflate(6);
+    std::uint8_t dummy = 0;
+    EXPECT_THROW(
+      CompressionAlgorithmSelector::Measure(deflate, &dummy, 0), std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
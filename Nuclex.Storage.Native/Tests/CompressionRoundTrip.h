@@ -0,0 +1,124 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+
+#ifndef NUCLEX_STORAGE_COMPRESSIONROUNDTRIP_H
+#define NUCLEX_STORAGE_COMPRESSIONROUNDTRIP_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/Compression/Compressor.h"
+#include "Nuclex/Storage/Compression/Decompressor.h"
+#include "Nuclex/Storage/Compression/StopReason.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates compressible test data</summary>
+  /// <param name="byteCount">Number of bytes that will be generated</param>
+  /// <returns>A buffer filled with a repeating, slightly irregular pattern</returns>
+  inline std::vector<std::uint8_t> MakeCompressibleData(std::size_t byteCount) {
+    std::vector<std::uint8_t> data(byteCount);
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      data[index] = static_cast<std::uint8_t>((index * 7) ^ (index >> 5));
+    }
+    return data;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compresses a buffer, collecting the output in small chunks</summary>
+  /// <param name="compressor">Compressor that will be used</param>
+  /// <param name="data">Data that will be compressed</param>
+  /// <returns>The compressed data</returns>
+  /// <remarks>
+  ///   The small output chunks force the compressor to stop and resume many times,
+  ///   which is where most state handling mistakes in the compressor wrappers show up.
+  /// </remarks>
+  inline std::vector<std::uint8_t> CompressInChunks(
+    Compressor &compressor, const std::vector<std::uint8_t> &data
+  ) {
+    std::vector<std::uint8_t> compressed;
+    std::uint8_t chunk[100];
+
+    std::size_t offset = 0;
+    for(;;) {
+      std::size_t inputByteCount = data.size() - offset;
+      std::size_t outputByteCount = sizeof(chunk);
+      StopReason reason = compressor.Process(
+        data.data() + offset, inputByteCount, chunk, outputByteCount
+      );
+      offset += inputByteCount;
+      compressed.insert(compressed.end(), chunk, chunk + outputByteCount);
+      if(reason == StopReason::InputBufferExhausted) {
+        break;
+      }
+    }
+
+    for(;;) {
+      std::size_t outputByteCount = sizeof(chunk);
+      StopReason reason = compressor.Finish(chunk, outputByteCount);
+      compressed.insert(compressed.end(), chunk, chunk + outputByteCount);
+      if(reason == StopReason::Finished) {
+        break;
+      }
+    }
+
+    return compressed;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decompresses a buffer, collecting the output in small chunks</summary>
+  /// <param name="decompressor">Decompressor that will be used</param>
+  /// <param name="compressed">Data that will be decompressed</param>
+  /// <returns>The decompressed data</returns>
+  inline std::vector<std::uint8_t> DecompressInChunks(
+    Decompressor &decompressor, const std::vector<std::uint8_t> &compressed
+  ) {
+    std::vector<std::uint8_t> data;
+    std::uint8_t chunk[100];
+
+    std::size_t offset = 0;
+    for(;;) {
+      std::size_t inputByteCount = compressed.size() - offset;
+      std::size_t outputByteCount = sizeof(chunk);
+      StopReason reason = decompressor.Process(
+        compressed.data() + offset, inputByteCount, chunk, outputByteCount
+      );
+      offset += inputByteCount;
+      data.insert(data.end(), chunk, chunk + outputByteCount);
+      if(reason != StopReason::OutputBufferFull) {
+        break;
+      }
+    }
+
+    return data;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
+
+#endif // NUCLEX_STORAGE_COMPRESSIONROUNDTRIP_H
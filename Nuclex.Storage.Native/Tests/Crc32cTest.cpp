@@ -0,0 +1,126 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Checksums/Crc32c.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "Nuclex/Storage/Binary/BlobInputStream.h"
+#include "RandomDataFactory.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates a CRC-32C checksum one bit at a time</summary>
+  /// <param name="data">Data whose checksum will be calculated</param>
+  /// <param name="byteCount">Number of bytes in the data</param>
+  /// <returns>The CRC-32C checksum of the data</returns>
+  std::uint32_t computeBitwiseCrc32c(const std::uint8_t *data, std::size_t byteCount) {
+    std::uint32_t crc = 0xFFFFFFFFU;
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      crc ^= data[index];
+      for(std::size_t bit = 0; bit < 8; ++bit) {
+        crc = (crc & 1) ? ((crc >> 1) ^ 0x82F63B78U) : (crc >> 1);
+      }
+    }
+    return crc ^ 0xFFFFFFFFU;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Crc32cTest, KnownChecksumsAreReproduced) {
+    EXPECT_EQ(0U, Crc32c::Compute(u8"", 0));
+    EXPECT_EQ(0xE3069283U, Crc32c::Compute(u8"123456789", 9));
+
+    // Test vectors from RFC 3720 (iSCSI)
+    std::vector<std::uint8_t> zeros(32, 0);
+    EXPECT_EQ(0x8A9136AAU, Crc32c::Compute(zeros.data(), zeros.size()));
+    std::vector<std::uint8_t> ones(32, 0xFF);
+    EXPECT_EQ(0x62A8AB43U, Crc32c::Compute(ones.data(), ones.size()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Crc32cTest, AllLengthsAndAlignmentsMatchBitwiseCalculation) {
+    std::vector<std::uint8_t> data = MakeRandomData(300, 42);
+    for(std::size_t offset = 0; offset < 8; ++offset) {
+      for(std::size_t byteCount = 0; byteCount < 292; byteCount += 7) {
+        EXPECT_EQ(
+          computeBitwiseCrc32c(data.data() + offset, byteCount),
+          Crc32c::Compute(data.data() + offset, byteCount)
+        );
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Crc32cTest, BlobsAndStreamsCanBeChecksummed) {
+    std::vector<std::uint8_t> data = MakeRandomData(200000, 7);
+    std::uint32_t expected = Crc32c::Compute(data.data(), data.size());
+
+    // Unsealed memory blobs don't provide spans, so these are read in chunks
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    blob->WriteAt(0, data.data(), data.size());
+    EXPECT_EQ(expected, Crc32c::Compute(*blob));
+
+    blob->Seal();
+    EXPECT_EQ(expected, Crc32c::Compute(*blob));
+
+    Binary::BlobInputStream stream(blob);
+    Crc32c crc32c;
+    crc32c.Update(stream);
+    EXPECT_EQ(expected, crc32c.GetValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Crc32cTest, DataCanBeChecksummedInPieces) {
+    std::vector<std::uint8_t> data = MakeRandomData(1000, 3);
+
+    Crc32c crc32c;
+    std::size_t offset = 0;
+    for(std::size_t pieceByteCount = 1; offset < data.size(); ++pieceByteCount) {
+      if(pieceByteCount > data.size() - offset) {
+        pieceByteCount = data.size() - offset;
+      }
+      crc32c.Update(data.data() + offset, pieceByteCount);
+      offset += pieceByteCount;
+    }
+
+    EXPECT_EQ(Crc32c::Compute(data.data(), data.size()), crc32c.GetValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
@@ -0,0 +1,291 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/FileBlob.h"
+#include <gtest/gtest.h>
+
+#include "TemporaryFileScope.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a recognizable pattern of bytes</summary>
+  /// <param name="byteCount">Number of bytes that will be generated</param>
+  /// <returns>A vector containing the requested number of bytes</returns>
+  std::vector<std::uint8_t> makeTestPattern(std::size_t byteCount) {
+    std::vector<std::uint8_t> pattern(byteCount);
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      pattern[index] = static_cast<std::uint8_t>((index * 31) ^ (index >> 8));
+    }
+    return pattern;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, WrittenDataCanBeReadBack) {
+    TemporaryFileScope temporaryFile;
+    {
+      FileBlob blob(temporaryFile.GetPath(), true);
+      EXPECT_TRUE(blob.IsWritable());
+      blob.WriteAt(0, u8"Hello World", 11);
+      blob.WriteAt(6, u8"Universe", 8);
+      EXPECT_EQ(14U, blob.GetSize());
+      blob.Flush();
+    }
+
+    FileBlob blob(temporaryFile.GetPath());
+    EXPECT_FALSE(blob.IsWritable());
+    ASSERT_EQ(14U, blob.GetSize());
+
+    char message[14];
+    blob.ReadAt(0, message, 14);
+    EXPECT_EQ(std::string(u8"Hello Universe"), std::string(message, 14));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, ReadOnlyBlobRejectsWrites) {
+    TemporaryFileScope temporaryFile;
+
+    FileBlob blob(temporaryFile.GetPath());
+    EXPECT_THROW(blob.WriteAt(0, u8"Hello", 5), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, ReadingBeyondEndThrows) {
+    TemporaryFileScope temporaryFile;
+
+    FileBlob blob(temporaryFile.GetPath(), true);
+    blob.WriteAt(0, u8"Hello", 5);
+
+    char buffer[6];
+    EXPECT_THROW(blob.ReadAt(0, buffer, 6), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, GapsAreFilledWithZeros) {
+    TemporaryFileScope temporaryFile;
+
+    FileBlob blob(temporaryFile.GetPath(), true);
+    blob.WriteAt(4, u8"Hi", 2);
+    ASSERT_EQ(6U, blob.GetSize());
+
+    char buffer[6];
+    blob.ReadAt(0, buffer, 6);
+    EXPECT_EQ(std::string("\0\0\0\0Hi", 6), std::string(buffer, 6));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, UnbufferedTransfersHandleAnyAlignment) {
+    TemporaryFileScope temporaryFile;
+
+    std::vector<std::uint8_t> pattern = makeTestPattern(3 * 1024 * 1024 + 1234);
+    {
+      FileBlob blob(temporaryFile.GetPath(), true, true);
+
+      // Start at an odd offset from an odd address so nothing lines up by accident
+      blob.WriteAt(0, &pattern[0], 777);
+      blob.WriteAt(777, &pattern[777], pattern.size() - 777);
+      blob.Flush();
+      ASSERT_EQ(pattern.size(), blob.GetSize());
+    }
+
+    FileBlob blob(temporaryFile.GetPath(), false, true);
+
+    std::vector<std::uint8_t> contents(pattern.size());
+    blob.ReadAt(0, &contents[0], contents.size());
+    EXPECT_EQ(pattern, contents);
+
+    std::vector<std::uint8_t> part(100000);
+    blob.ReadAt(4097, &part[0] + 1, part.size() - 1);
+    for(std::size_t index = 1; index < part.size(); ++index) {
+      ASSERT_EQ(pattern[4096 + index], part[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, CanBeReadFromManyThreads) {
+    TemporaryFileScope temporaryFile;
+
+    std::vector<std::uint8_t> pattern = makeTestPattern(65536);
+    {
+      FileBlob blob(temporaryFile.GetPath(), true);
+      blob.WriteAt(0, &pattern[0], pattern.size());
+    }
+
+    FileBlob blob(temporaryFile.GetPath());
+
+    std::atomic<std::size_t> mismatchCount(0);
+    std::vector<std::thread> threads;
+    for(std::size_t threadIndex = 0; threadIndex < 4; ++threadIndex) {
+      threads.emplace_back(
+        [&blob, &pattern, &mismatchCount, threadIndex]() {
+          std::uint8_t buffer[256];
+          for(std::size_t repetition = 0; repetition < 500; ++repetition) {
+            std::size_t offset = ((repetition * 4 + threadIndex) * 256) % pattern.size();
+            blob.ReadAt(offset, buffer, sizeof(buffer));
+            for(std::size_t index = 0; index < sizeof(buffer); ++index) {
+              if(buffer[index] != pattern[offset + index]) {
+                ++mismatchCount;
+              }
+            }
+          }
+        }
+      );
+    }
+    for(std::size_t index = 0; index < threads.size(); ++index) {
+      threads[index].join();
+    }
+
+    EXPECT_EQ(0U, mismatchCount.load());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, CanBeReadAsynchronously) {
+    TemporaryFileScope temporaryFile;
+
+    std::vector<std::uint8_t> pattern = makeTestPattern(65536);
+    {
+      FileBlob blob(temporaryFile.GetPath(), true);
+      blob.WriteAt(0, &pattern[0], pattern.size());
+    }
+
+    FileBlob blob(temporaryFile.GetPath());
+
+    std::vector<std::uint8_t> buffer(30000);
+    std::future<void> completion = blob.ReadAtAsync(1234, &buffer[0], buffer.size());
+    completion.get();
+
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), pattern.begin() + 1234));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, ManyReadsCanBeSubmittedAtOnce) {
+    TemporaryFileScope temporaryFile;
+
+    std::vector<std::uint8_t> pattern = makeTestPattern(1048576);
+    {
+      FileBlob blob(temporaryFile.GetPath(), true);
+      blob.WriteAt(0, &pattern[0], pattern.size());
+    }
+
+    FileBlob blob(temporaryFile.GetPath());
+
+    // More requests than the backend can have in flight, so some have to wait for a slot
+    const std::size_t requestCount = 1000;
+    const std::size_t requestByteCount = 1000;
+    std::vector<std::uint8_t> buffer(requestCount * requestByteCount);
+    std::vector<BlobReadRequest> requests(requestCount);
+    for(std::size_t index = 0; index < requestCount; ++index) {
+      requests[index].Location = (index * 7919 * 64) % (pattern.size() - requestByteCount);
+      requests[index].Buffer = &buffer[index * requestByteCount];
+      requests[index].Count = requestByteCount;
+    }
+
+    std::vector<std::future<void>> completions = blob.ReadAtAsync(&requests[0], requestCount);
+    ASSERT_EQ(requestCount, completions.size());
+
+    std::size_t mismatchCount = 0;
+    for(std::size_t index = 0; index < requestCount; ++index) {
+      completions[index].get();
+
+      std::size_t location = static_cast<std::size_t>(requests[index].Location);
+      bool isEqual = std::equal(
+        buffer.begin() + index * requestByteCount,
+        buffer.begin() + (index + 1) * requestByteCount,
+        pattern.begin() + location
+      );
+      if(!isEqual) {
+        ++mismatchCount;
+      }
+    }
+
+    EXPECT_EQ(0U, mismatchCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, CanBeWrittenAsynchronously) {
+    TemporaryFileScope temporaryFile;
+
+    std::vector<std::uint8_t> pattern = makeTestPattern(100000);
+    {
+      FileBlob blob(temporaryFile.GetPath(), true);
+      std::future<void> first = blob.WriteAtAsync(0, &pattern[0], 50000);
+      std::future<void> second = blob.WriteAtAsync(50000, &pattern[50000], 50000);
+      first.get();
+      second.get();
+      EXPECT_EQ(100000U, blob.GetSize());
+    }
+
+    FileBlob blob(temporaryFile.GetPath());
+
+    std::vector<std::uint8_t> buffer(pattern.size());
+    blob.ReadAt(0, &buffer[0], buffer.size());
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), pattern.begin()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileBlobTest, AsynchronousErrorsAreReportedThroughFuture) {
+    TemporaryFileScope temporaryFile;
+    {
+      FileBlob blob(temporaryFile.GetPath(), true);
+      blob.WriteAt(0, u8"Hello World", 11);
+    }
+
+    FileBlob blob(temporaryFile.GetPath());
+
+    char message[12];
+    std::future<void> pastEnd = blob.ReadAtAsync(0, message, 12);
+    EXPECT_THROW(pastEnd.get(), std::out_of_range);
+
+    std::future<void> readOnly = blob.WriteAtAsync(0, u8"Hello", 5);
+    EXPECT_THROW(readOnly.get(), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
@@ -0,0 +1,99 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/FileInputStream.h"
+#include "Nuclex/Storage/Binary/FileOutputStream.h"
+#include <gtest/gtest.h>
+
+#include "TemporaryFileScope.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileStreamTest, WrittenFileCanBeStreamedBack) {
+    TemporaryFileScope temporaryFile;
+
+    std::vector<std::uint8_t> pattern(1000000);
+    for(std::size_t index = 0; index < pattern.size(); ++index) {
+      pattern[index] = static_cast<std::uint8_t>((index * 31) ^ (index >> 8));
+    }
+    {
+      FileOutputStream stream(temporaryFile.GetPath(), 65536);
+      for(std::size_t offset = 0; offset < pattern.size(); offset += 10000) {
+        std::size_t byteCount = 10000;
+        stream.WriteUpTo(&pattern[offset], byteCount);
+      }
+      stream.Flush();
+    }
+
+    FileInputStream stream(temporaryFile.GetPath(), 65536);
+
+    std::vector<std::uint8_t> contents;
+    for(;;) {
+      std::size_t byteCount;
+      const std::uint8_t *span = stream.AcquireReadableSpan(byteCount);
+      if(span == nullptr) {
+        break;
+      }
+
+      EXPECT_LE(byteCount, 65536U);
+      contents.insert(contents.end(), span, span + byteCount);
+      stream.ConsumeReadableSpan(byteCount);
+    }
+
+    EXPECT_EQ(pattern, contents);
+    EXPECT_FALSE(stream.IsMoreDataAvailable());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FileStreamTest, OutputStreamReplacesExistingContents) {
+    TemporaryFileScope temporaryFile;
+    {
+      FileOutputStream stream(temporaryFile.GetPath());
+      std::size_t byteCount = 11;
+      stream.WriteUpTo(reinterpret_cast<const std::uint8_t *>(u8"Hello World"), byteCount);
+    }
+    {
+      FileOutputStream stream(temporaryFile.GetPath());
+      std::size_t byteCount = 3;
+      stream.WriteUpTo(reinterpret_cast<const std::uint8_t *>(u8"Bye"), byteCount);
+    }
+
+    FileInputStream stream(temporaryFile.GetPath());
+
+    std::uint8_t buffer[16];
+    std::size_t byteCount = sizeof(buffer);
+    EXPECT_TRUE(stream.ReadUpTo(buffer, byteCount, 0));
+    ASSERT_EQ(3U, byteCount);
+    EXPECT_EQ('B', buffer[0]);
+    EXPECT_EQ('e', buffer[2]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
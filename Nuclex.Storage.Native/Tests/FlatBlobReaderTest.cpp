@@ -0,0 +1,224 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/FlatBlobReader.h"
+#include "Nuclex/Storage/Binary/FlatBlobWriter.h"
+#include "Nuclex/Storage/MappedFileBlob.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include <gtest/gtest.h>
+
+#include "TemporaryFileScope.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Vertex as it would be stored in a flat blob</summary>
+  struct FlatVertex {
+    /// <summary>Position along the X axis</summary>
+    float X;
+    /// <summary>Position along the Y axis</summary>
+    float Y;
+    /// <summary>Position along the Z axis</summary>
+    float Z;
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Mesh referencing its name and vertices inside a flat blob</summary>
+  struct FlatMesh {
+    /// <summary>Name of the mesh</summary>
+    Nuclex::Storage::Binary::FlatArray<char> Name;
+    /// <summary>Vertices making up the mesh</summary>
+    Nuclex::Storage::Binary::FlatArray<FlatVertex> Vertices;
+    /// <summary>Vertex the mesh is centered on</summary>
+    Nuclex::Storage::Binary::FlatReference<FlatVertex> Center;
+    /// <summary>Identifier of the mesh</summary>
+    std::uint64_t Id;
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a small mesh as flat blob into the specified blob</summary>
+  /// <param name="blob">Blob the mesh will be written into</param>
+  void writeMesh(const std::shared_ptr<Nuclex::Storage::Blob> &blob) {
+    using namespace Nuclex::Storage::Binary;
+
+    std::vector<FlatVertex> vertices;
+    for(std::size_t index = 0; index < 100; ++index) {
+      FlatVertex vertex = { float(index), float(index) * 2.0f, float(index) * 3.0f };
+      vertices.push_back(vertex);
+    }
+
+    FlatBlobWriter writer(blob);
+    FlatVertex center = { 1.5f, 2.5f, 3.5f };
+
+    FlatMesh mesh;
+    mesh.Name = writer.AddString(u8"Teapot");
+    mesh.Vertices = writer.AddArray(vertices);
+    mesh.Center = writer.Add(center);
+    mesh.Id = 0x0123456789ABCDEFULL;
+
+    writer.Finish(writer.Add(mesh));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks that a flat blob reader sees the mesh written by writeMesh()</summary>
+  /// <param name="reader">Reader that will be checked</param>
+  void verifyMesh(const Nuclex::Storage::Binary::FlatBlobReader &reader) {
+    using namespace Nuclex::Storage::Binary;
+
+    const FlatMesh &mesh = reader.GetRoot<FlatMesh>();
+    EXPECT_EQ(0x0123456789ABCDEFULL, mesh.Id);
+
+    FlatArrayView<char> name = reader.Resolve(mesh.Name);
+    EXPECT_EQ(std::string(u8"Teapot"), std::string(name.data()));
+    EXPECT_EQ(6U, name.size());
+
+    FlatArrayView<FlatVertex> vertices = reader.Resolve(mesh.Vertices);
+    ASSERT_EQ(100U, vertices.size());
+    for(std::size_t index = 0; index < vertices.size(); ++index) {
+      EXPECT_EQ(float(index), vertices[index].X);
+      EXPECT_EQ(float(index) * 3.0f, vertices[index].Z);
+    }
+
+    const FlatVertex &center = reader.Resolve(mesh.Center);
+    EXPECT_EQ(1.5f, center.X);
+    EXPECT_EQ(3.5f, center.Z);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatBlobReaderTest, SealedMemoryBlobIsAccessedInPlace) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    writeMesh(blob);
+    blob->Seal();
+
+    EXPECT_TRUE(FlatBlobReader::IsFlatBlob(*blob));
+
+    FlatBlobReader reader(blob);
+    EXPECT_TRUE(reader.IsAccessedInPlace());
+    EXPECT_EQ(blob->GetSize(), reader.GetByteCount());
+    verifyMesh(reader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatBlobReaderTest, UnsealedMemoryBlobIsCopied) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    writeMesh(blob);
+
+    FlatBlobReader reader(blob);
+    EXPECT_FALSE(reader.IsAccessedInPlace());
+    verifyMesh(reader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatBlobReaderTest, MemoryMappedFileIsAccessedInPlace) {
+    TemporaryFileScope temporaryFile;
+    {
+      std::shared_ptr<MappedFileBlob> blob = std::make_shared<MappedFileBlob>(
+        temporaryFile.GetPath(), true
+      );
+      writeMesh(blob);
+      blob->Flush();
+    }
+
+    std::shared_ptr<MappedFileBlob> blob = std::make_shared<MappedFileBlob>(
+      temporaryFile.GetPath()
+    );
+    FlatBlobReader reader(blob);
+    EXPECT_TRUE(reader.IsAccessedInPlace());
+    verifyMesh(reader);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatBlobReaderTest, NullArraysResolveToEmptyViews) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      FlatBlobWriter writer(blob);
+      FlatMesh mesh = FlatMesh();
+      writer.Finish(writer.Add(mesh));
+    }
+
+    FlatBlobReader reader(blob);
+    const FlatMesh &mesh = reader.GetRoot<FlatMesh>();
+    EXPECT_TRUE(reader.Resolve(mesh.Vertices).empty());
+    EXPECT_EQ(std::string(), std::string(reader.Resolve(mesh.Name).data()));
+    EXPECT_TRUE(mesh.Center.IsNull());
+    EXPECT_THROW(reader.Resolve(mesh.Center), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatBlobReaderTest, BlobsWithoutSignatureAreRejected) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    blob->WriteAt(0, u8"This is not a flat blob", 23);
+
+    EXPECT_FALSE(FlatBlobReader::IsFlatBlob(*blob));
+    EXPECT_THROW(FlatBlobReader reader(blob), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatBlobReaderTest, CorruptReferencesAreRejected) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    writeMesh(blob);
+
+    FlatBlobReader reader(blob);
+
+    FlatReference<FlatVertex> beyondEnd;
+    beyondEnd.Offset = static_cast<std::uint32_t>(reader.GetByteCount());
+    EXPECT_THROW(reader.Resolve(beyondEnd), std::runtime_error);
+
+    FlatReference<FlatVertex> misaligned;
+    misaligned.Offset = 17;
+    EXPECT_THROW(reader.Resolve(misaligned), std::runtime_error);
+
+    FlatReference<FlatVertex> intoHeader;
+    intoHeader.Offset = 4;
+    EXPECT_THROW(reader.Resolve(intoHeader), std::runtime_error);
+
+    FlatArray<FlatVertex> beyondEndArray;
+    beyondEndArray.Offset = static_cast<std::uint32_t>(reader.GetByteCount() + 4) & ~3U;
+    EXPECT_THROW(reader.Resolve(beyondEndArray), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
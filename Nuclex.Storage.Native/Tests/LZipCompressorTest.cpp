@@ -0,0 +1,118 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "../Source/Compression/LZip/LZipCompressionAlgorithm.h"
+#include "CompressionRoundTrip.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if defined(NUCLEX_STORAGE_HAVE_LZIP)
+
+namespace Nuclex { namespace Storage { namespace Compression { namespace LZip {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LZipCompressorTest, DataSurvivesRoundTrip) {
+    LZipCompressionAlgorithm algorithm(6);
+    std::unique_ptr<Compressor> compressor = algorithm.CreateCompressor();
+    std::unique_ptr<Decompressor> decompressor = algorithm.CreateDecompressor();
+
+    std::vector<std::uint8_t> data = MakeCompressibleData(65536);
+    std::vector<std::uint8_t> compressed = CompressInChunks(*compressor, data);
+    EXPECT_LT(compressed.size(), data.size());
+
+    std::vector<std::uint8_t> decompressed = DecompressInChunks(*decompressor, compressed);
+    EXPECT_EQ(decompressed, data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LZipCompressorTest, FlushMakesAllDataDecompressible) {
+    LZipCompressionAlgorithm algorithm(6);
+    std::unique_ptr<Compressor> compressor = algorithm.CreateCompressor();
+    std::unique_ptr<Decompressor> decompressor = algorithm.CreateDecompressor();
+
+    std::vector<std::uint8_t> data = MakeCompressibleData(1000);
+    std::vector<std::uint8_t> compressed(2048);
+
+    std::size_t inputByteCount = data.size();
+    std::size_t outputByteCount = compressed.size();
+    EXPECT_EQ(
+      compressor->Process(data.data(), inputByteCount, compressed.data(), outputByteCount),
+      StopReason::InputBufferExhausted
+    );
+    EXPECT_EQ(inputByteCount, data.size());
+
+    std::size_t flushedByteCount = compressed.size() - outputByteCount;
+    EXPECT_EQ(
+      compressor->Flush(compressed.data() + outputByteCount, flushedByteCount),
+      StopReason::Finished
+    );
+    compressed.resize(outputByteCount + flushedByteCount);
+
+    std::vector<std::uint8_t> decompressed = DecompressInChunks(*decompressor, compressed);
+    EXPECT_EQ(decompressed, data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LZipCompressorTest, CompressorsCanBeReused) {
+    LZipCompressionAlgorithm algorithm(6);
+    std::unique_ptr<Compressor> compressor = algorithm.CreateCompressor();
+    std::unique_ptr<Decompressor> decompressor = algorithm.CreateDecompressor();
+
+    std::vector<std::uint8_t> data = MakeCompressibleData(4096);
+    std::vector<std::uint8_t> first = CompressInChunks(*compressor, data);
+    compressor->Reset();
+    std::vector<std::uint8_t> second = CompressInChunks(*compressor, data);
+    EXPECT_EQ(first, second);
+
+    EXPECT_EQ(DecompressInChunks(*decompressor, first), data);
+    decompressor->Reset();
+    EXPECT_EQ(DecompressInChunks(*decompressor, second), data);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LZipCompressorTest, MetricsAreProvided) {
+    LZipCompressionAlgorithm algorithm(6);
+    EXPECT_GT(algorithm.GetCompressionCyclesPerKilobyte(), 0U);
+    EXPECT_GT(algorithm.GetAverageCompressionRatio(), 0.0f);
+    EXPECT_LT(algorithm.GetAverageCompressionRatio(), 1.0f);
+    EXPECT_FALSE(algorithm.GetName().empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LZipCompressorTest, InvalidCompressionLevelIsRejected) {
+    EXPECT_THROW(LZipCompressionAlgorithm(10), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}}} // namespace Nuclex::Storage::Compression::LZip
+
+#endif // defined(NUCLEX_STORAGE_HAVE_LZIP)
@@ -0,0 +1,191 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/LogFileBlob.h"
+#include "Nuclex/Storage/FileBlob.h"
+#include <gtest/gtest.h>
+
+#include "TemporaryFileScope.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a recognizable pattern of bytes</summary>
+  /// <param name="byteCount">Number of bytes that will be generated</param>
+  /// <returns>A vector containing the requested number of bytes</returns>
+  std::vector<std::uint8_t> makeTestPattern(std::size_t byteCount) {
+    std::vector<std::uint8_t> pattern(byteCount);
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      pattern[index] = static_cast<std::uint8_t>((index * 31) ^ (index >> 8));
+    }
+    return pattern;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the whole contents of a file</summary>
+  /// <param name="path">Path of the file that will be read</param>
+  /// <returns>All bytes stored in the file</returns>
+  std::vector<std::uint8_t> readFile(const std::string &path) {
+    Nuclex::Storage::FileBlob file(path);
+    std::vector<std::uint8_t> contents(static_cast<std::size_t>(file.GetSize()));
+    file.ReadAt(0, contents.data(), contents.size());
+    return contents;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LogFileBlobTest, AppendedDataCanBeReadBack) {
+    TemporaryFileScope temporaryFile;
+    {
+      LogFileBlob blob(temporaryFile.GetPath());
+      EXPECT_EQ(6U, blob.Append(u8"Hello ", 6));
+      std::uint64_t ticket = blob.Append(u8"World", 5);
+      EXPECT_EQ(11U, ticket);
+      EXPECT_EQ(11U, blob.GetSize());
+
+      blob.WaitUntilDurable(ticket);
+      EXPECT_TRUE(blob.IsDurable(ticket));
+
+      char message[11];
+      blob.ReadAt(0, message, 11);
+      EXPECT_EQ(std::string(u8"Hello World"), std::string(message, 11));
+    }
+
+    std::vector<std::uint8_t> contents = readFile(temporaryFile.GetPath());
+    EXPECT_EQ(std::string(u8"Hello World"), std::string(contents.begin(), contents.end()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LogFileBlobTest, ExistingFilesAreAppendedTo) {
+    TemporaryFileScope temporaryFile;
+    {
+      FileBlob file(temporaryFile.GetPath(), true);
+      file.WriteAt(0, u8"Hello", 5);
+    }
+    {
+      LogFileBlob blob(temporaryFile.GetPath(), 4, 2);
+      EXPECT_EQ(5U, blob.GetSize());
+      blob.WriteAt(5, u8" World", 6);
+      EXPECT_THROW(blob.WriteAt(5, u8"!", 1), std::runtime_error);
+      blob.Flush();
+    }
+
+    std::vector<std::uint8_t> contents = readFile(temporaryFile.GetPath());
+    EXPECT_EQ(std::string(u8"Hello World"), std::string(contents.begin(), contents.end()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LogFileBlobTest, AppendsCanBeLargerThanAllBuffers) {
+    TemporaryFileScope temporaryFile;
+    std::vector<std::uint8_t> pattern = makeTestPattern(100000);
+    {
+      LogFileBlob blob(temporaryFile.GetPath(), 4096, 3);
+      blob.Append(pattern.data(), 10);
+      blob.Append(pattern.data() + 10, pattern.size() - 10);
+
+      std::vector<std::uint8_t> readBack(pattern.size());
+      blob.ReadAt(0, readBack.data(), readBack.size());
+      EXPECT_EQ(pattern, readBack);
+
+      EXPECT_THROW(blob.ReadAt(pattern.size() - 1, readBack.data(), 2), std::out_of_range);
+    }
+
+    EXPECT_EQ(pattern, readFile(temporaryFile.GetPath()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LogFileBlobTest, ManyThreadsCanAppendAtOnce) {
+    const std::size_t ThreadCount = 8;
+    const std::size_t RecordsPerThread = 2000;
+    const std::size_t RecordByteCount = 16;
+
+    TemporaryFileScope temporaryFile;
+    {
+      LogFileBlob blob(temporaryFile.GetPath(), 4096, 3);
+
+      std::vector<std::thread> threads;
+      for(std::size_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex) {
+        threads.emplace_back(
+          [&blob, threadIndex, RecordsPerThread, RecordByteCount]() {
+            std::uint8_t record[RecordByteCount];
+            for(std::size_t recordIndex = 0; recordIndex < RecordsPerThread; ++recordIndex) {
+              for(std::size_t index = 0; index < RecordByteCount; ++index) {
+                record[index] = static_cast<std::uint8_t>(threadIndex);
+              }
+              record[1] = static_cast<std::uint8_t>(recordIndex);
+              record[2] = static_cast<std::uint8_t>(recordIndex >> 8);
+
+              std::uint64_t ticket = blob.Append(record, RecordByteCount);
+              if((recordIndex % 500) == 0) {
+                blob.WaitUntilDurable(ticket);
+                EXPECT_TRUE(blob.IsDurable(ticket));
+              }
+            }
+          }
+        );
+      }
+      for(std::size_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex) {
+        threads[threadIndex].join();
+      }
+    }
+
+    // Each record has to appear in one piece and the records of each thread in order
+    std::vector<std::uint8_t> contents = readFile(temporaryFile.GetPath());
+    ASSERT_EQ(ThreadCount * RecordsPerThread * RecordByteCount, contents.size());
+
+    std::vector<std::size_t> nextRecordIndices(ThreadCount, 0);
+    for(std::size_t offset = 0; offset < contents.size(); offset += RecordByteCount) {
+      std::size_t threadIndex = contents[offset];
+      ASSERT_LT(threadIndex, ThreadCount);
+      std::size_t recordIndex = (
+        static_cast<std::size_t>(contents[offset + 1]) |
+        (static_cast<std::size_t>(contents[offset + 2]) << 8)
+      );
+      EXPECT_EQ(nextRecordIndices[threadIndex], recordIndex);
+      nextRecordIndices[threadIndex] = recordIndex + 1;
+      for(std::size_t index = 3; index < RecordByteCount; ++index) {
+        EXPECT_EQ(threadIndex, contents[offset + index]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
@@ -0,0 +1,126 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/MappedFileBlob.h"
+#include "Nuclex/Storage/Binary/BinaryBlobReader.h"
+#include "Nuclex/Storage/Binary/BinaryBlobWriter.h"
+#include <gtest/gtest.h>
+
+#include "TemporaryFileScope.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MappedFileBlobTest, EmptyFileCanBeMapped) {
+    TemporaryFileScope temporaryFile;
+
+    MappedFileBlob blob(temporaryFile.GetPath());
+    EXPECT_FALSE(blob.IsWritable());
+    EXPECT_EQ(0U, blob.GetSize());
+    EXPECT_NE(nullptr, blob.TryGetContiguousSpan(0, 0));
+    EXPECT_EQ(nullptr, blob.TryGetContiguousSpan(0, 1));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MappedFileBlobTest, WrittenDataCanBeReadBack) {
+    TemporaryFileScope temporaryFile;
+    {
+      MappedFileBlob blob(temporaryFile.GetPath(), true);
+      blob.WriteAt(0, u8"Hello World", 11);
+      blob.WriteAt(6, u8"Universe", 8);
+      EXPECT_EQ(14U, blob.GetSize());
+      blob.Flush();
+    }
+
+    MappedFileBlob blob(temporaryFile.GetPath());
+    ASSERT_EQ(14U, blob.GetSize()); // File must have been trimmed to its actual size
+
+    char message[14];
+    blob.ReadAt(0, message, 14);
+    EXPECT_EQ(std::string(u8"Hello Universe"), std::string(message, 14));
+
+    const std::uint8_t *span = blob.TryGetContiguousSpan(6, 8);
+    ASSERT_NE(nullptr, span);
+    EXPECT_EQ(std::string(u8"Universe"), std::string(reinterpret_cast<const char *>(span), 8));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MappedFileBlobTest, ReadOnlyBlobRejectsWrites) {
+    TemporaryFileScope temporaryFile;
+
+    MappedFileBlob blob(temporaryFile.GetPath());
+    EXPECT_THROW(blob.WriteAt(0, u8"Hello", 5), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MappedFileBlobTest, AccessBeyondEndIsRejected) {
+    TemporaryFileScope temporaryFile;
+
+    MappedFileBlob blob(temporaryFile.GetPath(), true);
+    blob.WriteAt(0, u8"Hello", 5);
+
+    char buffer[6];
+    EXPECT_THROW(blob.ReadAt(0, buffer, 6), std::out_of_range);
+    EXPECT_THROW(blob.WriteAt(6, u8"World", 5), std::out_of_range);
+    EXPECT_EQ(nullptr, blob.TryGetContiguousSpan(3, 3));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MappedFileBlobTest, CanBeGrownByManySmallWrites) {
+    TemporaryFileScope temporaryFile;
+    {
+      std::shared_ptr<MappedFileBlob> blob = std::make_shared<MappedFileBlob>(
+        temporaryFile.GetPath(), true
+      );
+      Binary::BinaryBlobWriter writer(blob);
+      for(std::uint32_t index = 0; index < 100000; ++index) {
+        writer.Write(index);
+      }
+    }
+
+    std::shared_ptr<MappedFileBlob> blob = std::make_shared<MappedFileBlob>(
+      temporaryFile.GetPath()
+    );
+    ASSERT_EQ(400000U, blob->GetSize());
+
+    Binary::BinaryBlobReader reader(blob);
+    for(std::uint32_t index = 0; index < 100000; ++index) {
+      std::uint32_t value;
+      reader.Read(value);
+      ASSERT_EQ(index, value);
+    }
+    EXPECT_EQ(0U, reader.GetRemainingBytes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
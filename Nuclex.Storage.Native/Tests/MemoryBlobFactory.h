@@ -0,0 +1,82 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+
+#ifndef NUCLEX_STORAGE_MEMORYBLOBFACTORY_H
+#define NUCLEX_STORAGE_MEMORYBLOBFACTORY_H
+
+#include "Nuclex/Storage/Config.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+
+#include <cstdint> // for std::uint8_t
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a memory blob holding the specified bytes for the unit tests</summary>
+  /// <param name="data">Bytes the memory blob will hold</param>
+  /// <param name="seal">Whether the blob will be sealed so it exposes its memory</param>
+  /// <returns>A memory blob with the specified contents</returns>
+  inline std::shared_ptr<MemoryBlob> MakeMemoryBlob(
+    const std::vector<std::uint8_t> &data, bool seal = false
+  ) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    blob->WriteAt(0, data.data(), data.size());
+    if(seal) {
+      blob->Seal();
+    }
+    return blob;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a memory blob holding the specified text for the unit tests</summary>
+  /// <param name="text">Text the memory blob will hold</param>
+  /// <param name="seal">Whether the blob will be sealed so it exposes its memory</param>
+  /// <returns>A memory blob with the specified text</returns>
+  inline std::shared_ptr<MemoryBlob> MakeMemoryBlob(const std::string &text, bool seal = false) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    blob->WriteAt(0, text.data(), text.size());
+    if(seal) {
+      blob->Seal();
+    }
+    return blob;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the entire contents of a blob</summary>
+  /// <param name="blob">Blob whose contents will be read</param>
+  /// <returns>The contents of the blob</returns>
+  inline std::vector<std::uint8_t> ReadBlobContents(const Blob &blob) {
+    std::vector<std::uint8_t> contents(static_cast<std::size_t>(blob.GetSize()));
+    blob.ReadAt(0, contents.data(), contents.size());
+    return contents;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_MEMORYBLOBFACTORY_H
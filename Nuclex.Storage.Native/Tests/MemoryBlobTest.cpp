@@ -24,6 +24,13 @@ License along with this library
 #include "Nuclex/Storage/MemoryBlob.h"
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace Nuclex { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
@@ -91,4 +98,104 @@ namespace Nuclex { namespace Storage {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(MemoryBlobTest, ReservingMemoryKeepsSize) {
+    MemoryBlob test;
+    test.Reserve(1024);
+    EXPECT_EQ(0, test.GetSize());
+
+    test.WriteAt(0, u8"Hello", 5);
+    EXPECT_EQ(5, test.GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MemoryBlobTest, SealedBlobIsReadOnly) {
+    MemoryBlob test;
+    test.WriteAt(0, u8"Hello World", 11);
+    EXPECT_FALSE(test.IsSealed());
+
+    test.Seal();
+    EXPECT_TRUE(test.IsSealed());
+    EXPECT_EQ(11, test.GetSize());
+
+    EXPECT_THROW(test.WriteAt(0, u8"Bye", 3), std::runtime_error);
+    EXPECT_THROW(test.Reserve(100), std::runtime_error);
+
+    char message[5];
+    test.ReadAt(6, message, 5);
+
+    const char *expected = u8"World";
+    for(std::size_t index = 0; index < 5; ++index) {
+      EXPECT_EQ(message[index], expected[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MemoryBlobTest, SealedBlobCanBeReadFromManyThreads) {
+    MemoryBlob test;
+    std::vector<std::uint8_t> contents(4096);
+    for(std::size_t index = 0; index < contents.size(); ++index) {
+      contents[index] = static_cast<std::uint8_t>(index * 7);
+    }
+    test.WriteAt(0, contents.data(), contents.size());
+    test.Seal();
+
+    std::atomic<std::size_t> mismatchCount(0);
+    std::vector<std::thread> threads;
+    for(std::size_t threadIndex = 0; threadIndex < 4; ++threadIndex) {
+      threads.emplace_back(
+        [&test, &contents, &mismatchCount, threadIndex]() {
+          std::uint8_t buffer[64];
+          for(std::size_t repetition = 0; repetition < 1000; ++repetition) {
+            std::size_t offset = ((repetition + threadIndex) * 64) % contents.size();
+            test.ReadAt(offset, buffer, sizeof(buffer));
+            for(std::size_t index = 0; index < sizeof(buffer); ++index) {
+              if(buffer[index] != contents[offset + index]) {
+                ++mismatchCount;
+              }
+            }
+          }
+        }
+      );
+    }
+    for(std::size_t index = 0; index < threads.size(); ++index) {
+      threads[index].join();
+    }
+
+    EXPECT_EQ(0U, mismatchCount.load());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MemoryBlobTest, SealedBlobProvidesSpans) {
+    MemoryBlob blob;
+    blob.WriteAt(0, u8"Hello World", 11);
+    EXPECT_EQ(nullptr, blob.TryGetContiguousSpan(0, 5));
+
+    blob.Seal();
+    const std::uint8_t *span = blob.TryGetContiguousSpan(6, 5);
+    ASSERT_NE(nullptr, span);
+    EXPECT_EQ(std::string(u8"World"), std::string(reinterpret_cast<const char *>(span), 5));
+    EXPECT_EQ(nullptr, blob.TryGetContiguousSpan(6, 6));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MemoryBlobTest, AsynchronousAccessCompletesImmediately) {
+    MemoryBlob blob;
+    std::future<void> written = blob.WriteAtAsync(0, u8"Hello World", 11);
+    written.get();
+
+    char message[11];
+    std::future<void> read = blob.ReadAtAsync(0, message, 11);
+    read.get();
+    EXPECT_EQ(std::string(u8"Hello World"), std::string(message, 11));
+
+    std::future<void> pastEnd = blob.ReadAtAsync(20, message, 1);
+    EXPECT_THROW(pastEnd.get(), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Storage
@@ -0,0 +1,158 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Binary/MemoryPipe.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Binary {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MemoryPipeTest, WrittenDataCanBeRead) {
+    MemoryPipe pipe;
+    EXPECT_FALSE(pipe.IsMoreDataAvailable());
+
+    std::size_t byteCount = 5;
+    pipe.WriteUpTo(reinterpret_cast<const std::uint8_t *>(u8"Hello"), byteCount);
+    EXPECT_EQ(5U, byteCount);
+    EXPECT_TRUE(pipe.IsMoreDataAvailable());
+
+    std::uint8_t buffer[8];
+    byteCount = sizeof(buffer);
+    EXPECT_FALSE(pipe.ReadUpTo(buffer, byteCount));
+    ASSERT_EQ(5U, byteCount);
+    EXPECT_EQ('H', buffer[0]);
+    EXPECT_EQ('o', buffer[4]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MemoryPipeTest, SpansExposeBufferedData) {
+    MemoryPipe pipe;
+
+    std::size_t byteCount = 11;
+    pipe.WriteUpTo(reinterpret_cast<const std::uint8_t *>(u8"Hello World"), byteCount);
+
+    const std::uint8_t *span = pipe.AcquireReadableSpan(byteCount);
+    ASSERT_NE(nullptr, span);
+    EXPECT_EQ(11U, byteCount);
+    EXPECT_EQ('W', span[6]);
+
+    pipe.ConsumeReadableSpan(6);
+    EXPECT_EQ(5U, pipe.CountAvailableBytes());
+    EXPECT_THROW(pipe.ConsumeReadableSpan(6), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MemoryPipeTest, ClosedPipeCanBeDrained) {
+    MemoryPipe pipe;
+
+    std::size_t byteCount = 3;
+    pipe.WriteUpTo(reinterpret_cast<const std::uint8_t *>(u8"Bye"), byteCount);
+    pipe.Close();
+    EXPECT_TRUE(pipe.IsClosed());
+    EXPECT_FALSE(pipe.CanAcceptMoreData());
+    EXPECT_THROW(pipe.WriteUpTo(reinterpret_cast<const std::uint8_t *>(u8"!"), byteCount),
+      std::runtime_error
+    );
+
+    std::uint8_t buffer[8];
+    byteCount = sizeof(buffer);
+    EXPECT_THROW(pipe.ReadUpTo(buffer, byteCount, 4), std::runtime_error);
+    EXPECT_EQ(3U, byteCount);
+
+    byteCount = sizeof(buffer);
+    EXPECT_TRUE(pipe.ReadUpTo(buffer, byteCount, 0));
+    EXPECT_EQ(0U, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MemoryPipeTest, ConnectsWriterAndReaderThreads) {
+    MemoryPipe pipe(1000); // Much smaller than the data, so both sides have to wait
+
+    const std::size_t totalByteCount = 100000;
+    std::thread writer(
+      [&pipe]() {
+        std::uint8_t chunk[700];
+        for(std::size_t offset = 0; offset < totalByteCount; offset += sizeof(chunk)) {
+          std::size_t chunkByteCount = sizeof(chunk);
+          if(chunkByteCount > totalByteCount - offset) {
+            chunkByteCount = totalByteCount - offset;
+          }
+          for(std::size_t index = 0; index < chunkByteCount; ++index) {
+            chunk[index] = static_cast<std::uint8_t>(offset + index);
+          }
+
+          std::size_t byteCount = chunkByteCount;
+          pipe.WriteUpTo(chunk, byteCount, chunkByteCount);
+        }
+        pipe.Close();
+      }
+    );
+
+    std::size_t readByteCount = 0;
+    std::size_t mismatchCount = 0;
+    for(;;) {
+      std::size_t byteCount;
+      const std::uint8_t *span = pipe.AcquireReadableSpan(byteCount);
+      if(span != nullptr) {
+        for(std::size_t index = 0; index < byteCount; ++index) {
+          if(span[index] != static_cast<std::uint8_t>(readByteCount + index)) {
+            ++mismatchCount;
+          }
+        }
+        readByteCount += byteCount;
+        pipe.ConsumeReadableSpan(byteCount);
+        continue;
+      }
+
+      // Wait for at least one more byte, or learn that the pipe has been closed
+      std::uint8_t value;
+      byteCount = 1;
+      try {
+        pipe.ReadUpTo(&value, byteCount);
+      }
+      catch(const std::runtime_error &) {
+        break;
+      }
+      if(value != static_cast<std::uint8_t>(readByteCount)) {
+        ++mismatchCount;
+      }
+      ++readByteCount;
+    }
+
+    writer.join();
+    EXPECT_EQ(totalByteCount, readByteCount);
+    EXPECT_EQ(0U, mismatchCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Binary
@@ -0,0 +1,233 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Compression/PackReader.h"
+#include "Nuclex/Storage/Compression/PackWriter.h"
+#include "Nuclex/Storage/Compression/CompressionAlgorithmSelector.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "../Source/Compression/ZLib/DeflateCompressionAlgorithm.h"
+#include "MemoryBlobFactory.h"
+#include "RandomDataFactory.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Nuclex { namespace Storage { namespace Compression {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PackFileTest, EntriesSurviveRoundTrip) {
+    ZLib::DeflateCompressionAlgorithm deflate(6);
+    std::vector<std::uint8_t> random = MakeRandomData(30000, 4321);
+    std::vector<std::uint8_t> repetitive(50000, std::uint8_t(0x42));
+    std::vector<std::uint8_t> small = MakeRandomData(17, 1);
+
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    {
+      PackWriter writer(container);
+      writer.AddEntry(u8"textures/stone.raw", repetitive.data(), repetitive.size(), deflate);
+      writer.AddEntry(u8"sounds/noise.raw", random.data(), random.size(), deflate);
+      writer.AddEntry(u8"small.bin", *MakeMemoryBlob(small));
+      writer.AddEntry(u8"empty.bin", nullptr, 0);
+      writer.Finish();
+    }
+
+    CompressionAlgorithmSelector selector;
+    selector.AddBuiltInAlgorithms();
+    PackReader reader(container, selector);
+    ASSERT_EQ(4U, reader.CountEntries());
+
+    // Entries are listed in the order of their names
+    EXPECT_EQ(std::string(u8"empty.bin"), reader.GetEntry(0).Name);
+    EXPECT_EQ(std::string(u8"small.bin"), reader.GetEntry(1).Name);
+    EXPECT_EQ(std::string(u8"sounds/noise.raw"), reader.GetEntry(2).Name);
+    EXPECT_EQ(std::string(u8"textures/stone.raw"), reader.GetEntry(3).Name);
+
+    EXPECT_EQ(repetitive, ReadBlobContents(*reader.OpenEntry(u8"textures/stone.raw")));
+    EXPECT_EQ(random, ReadBlobContents(*reader.OpenEntry(u8"sounds/noise.raw")));
+    EXPECT_EQ(small, ReadBlobContents(*reader.OpenEntry(u8"small.bin")));
+    EXPECT_EQ(0U, reader.OpenEntry(u8"empty.bin")->GetSize());
+
+    EXPECT_TRUE(reader.Contains(u8"small.bin"));
+    EXPECT_FALSE(reader.Contains(u8"small"));
+    EXPECT_FALSE(reader.Contains(u8"zzz"));
+    EXPECT_THROW(reader.OpenEntry(u8"missing.bin"), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PackFileTest, OnlyEntriesThatShrinkAreCompressed) {
+    ZLib::DeflateCompressionAlgorithm deflate(6);
+    std::vector<std::uint8_t> random = MakeRandomData(10000, 99);
+    std::vector<std::uint8_t> repetitive(10000, std::uint8_t(0));
+
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    {
+      PackWriter writer(container);
+      writer.AddEntry(u8"random", random.data(), random.size(), deflate);
+      writer.AddEntry(u8"repetitive", repetitive.data(), repetitive.size(), deflate);
+      writer.Finish();
+    }
+
+    PackReader reader(container);
+    const PackEntry *randomEntry = reader.FindEntry(u8"random");
+    ASSERT_NE(nullptr, randomEntry);
+    EXPECT_FALSE(randomEntry->IsCompressed());
+    EXPECT_EQ(random.size(), randomEntry->StoredByteCount);
+
+    const PackEntry *repetitiveEntry = reader.FindEntry(u8"repetitive");
+    ASSERT_NE(nullptr, repetitiveEntry);
+    EXPECT_TRUE(repetitiveEntry->IsCompressed());
+    EXPECT_EQ(deflate.GetId(), repetitiveEntry->AlgorithmId);
+    EXPECT_LT(repetitiveEntry->StoredByteCount, repetitive.size());
+
+    // Without a selector, only the uncompressed entries can be opened
+    EXPECT_EQ(random, ReadBlobContents(*reader.OpenEntry(*randomEntry)));
+    EXPECT_THROW(reader.OpenEntry(*repetitiveEntry), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PackFileTest, StoredEntriesAreAlignedSlicesOfTheContainer) {
+    std::vector<std::uint8_t> first = MakeRandomData(1000, 5);
+    std::vector<std::uint8_t> second = MakeRandomData(3000, 6);
+
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    {
+      PackWriter writer(container, 4096);
+      writer.AddEntry(u8"first", first.data(), first.size());
+      writer.AddEntry(u8"second", second.data(), second.size());
+      writer.Finish();
+    }
+    container->Seal();
+
+    PackReader reader(container);
+    for(std::size_t index = 0; index < reader.CountEntries(); ++index) {
+      EXPECT_EQ(0U, reader.GetEntry(index).Location % 4096);
+    }
+
+    // The entry's span points straight into the container's memory
+    std::shared_ptr<const Blob> entry = reader.OpenEntry(u8"second");
+    const std::uint8_t *span = entry->TryGetContiguousSpan(0, second.size());
+    ASSERT_NE(nullptr, span);
+    EXPECT_EQ(
+      container->TryGetContiguousSpan(reader.FindEntry(u8"second")->Location, second.size()),
+      span
+    );
+    EXPECT_TRUE(std::equal(second.begin(), second.end(), span));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PackFileTest, InvalidUsageIsRejected) {
+    EXPECT_THROW(PackWriter(std::make_shared<MemoryBlob>(), 24), std::invalid_argument);
+    EXPECT_THROW(PackWriter(MakeMemoryBlob(MakeRandomData(10, 1))), std::invalid_argument);
+
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    PackWriter writer(container);
+    std::uint8_t byte = 1;
+    writer.AddEntry(u8"entry", &byte, 1);
+    EXPECT_THROW(writer.AddEntry(u8"entry", &byte, 1), std::invalid_argument);
+
+    // Until the pack is finished, its header marks it as invalid
+    EXPECT_THROW(PackReader reader(container), std::runtime_error);
+
+    writer.Finish();
+    EXPECT_THROW(writer.AddEntry(u8"other", &byte, 1), std::runtime_error);
+    EXPECT_THROW(writer.Finish(), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PackFileTest, DamagedPacksAreRejected) {
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    {
+      PackWriter writer(container);
+      std::vector<std::uint8_t> data = MakeRandomData(1000, 3);
+      writer.AddEntry(u8"a", data.data(), data.size());
+      writer.AddEntry(u8"b", data.data(), data.size());
+      writer.Finish();
+    }
+    std::vector<std::uint8_t> contents = ReadBlobContents(*container);
+
+    std::shared_ptr<MemoryBlob> truncated = std::make_shared<MemoryBlob>();
+    truncated->WriteAt(0, contents.data(), contents.size() - 1);
+    EXPECT_THROW(PackReader reader(truncated), std::runtime_error);
+
+    EXPECT_THROW(PackReader reader(std::make_shared<MemoryBlob>()), std::runtime_error);
+
+    // Swap the names of the two entries so the directory is no longer sorted
+    std::vector<std::uint8_t> unsorted(contents);
+    std::swap(unsorted[unsorted.size() - 2], unsorted[unsorted.size() - 1]);
+    EXPECT_THROW(PackReader reader(MakeMemoryBlob(unsorted)), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PackFileTest, DamagedEntriesAreDetected) {
+    ZLib::DeflateCompressionAlgorithm deflate(6);
+    std::vector<std::uint8_t> random = MakeRandomData(1000, 7);
+    std::vector<std::uint8_t> repetitive(10000, std::uint8_t(1));
+
+    std::shared_ptr<MemoryBlob> container = std::make_shared<MemoryBlob>();
+    {
+      PackWriter writer(container);
+      writer.AddEntry(u8"random", random.data(), random.size());
+      writer.AddEntry(u8"repetitive", repetitive.data(), repetitive.size(), deflate);
+      writer.Finish();
+    }
+
+    CompressionAlgorithmSelector selector;
+    selector.AddBuiltInAlgorithms();
+    {
+      PackReader reader(container, selector);
+      EXPECT_TRUE(reader.VerifyEntry(*reader.FindEntry(u8"random")));
+      EXPECT_TRUE(reader.VerifyEntry(*reader.FindEntry(u8"repetitive")));
+    }
+
+    // Flip one bit in the stored bytes of each entry
+    std::vector<std::uint8_t> contents = ReadBlobContents(*container);
+    {
+      PackReader reader(container);
+      contents[static_cast<std::size_t>(reader.FindEntry(u8"random")->Location) + 10] ^= 1;
+      contents[static_cast<std::size_t>(reader.FindEntry(u8"repetitive")->Location) + 2] ^= 1;
+    }
+
+    PackReader reader(MakeMemoryBlob(contents), selector);
+    const PackEntry *randomEntry = reader.FindEntry(u8"random");
+    const PackEntry *repetitiveEntry = reader.FindEntry(u8"repetitive");
+    EXPECT_FALSE(reader.VerifyEntry(*randomEntry));
+    EXPECT_FALSE(reader.VerifyEntry(*repetitiveEntry));
+
+    // Compressed entries are checked before they are decompressed
+    EXPECT_THROW(reader.OpenEntry(*repetitiveEntry), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Compression
@@ -0,0 +1,136 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/PagedMemoryBlob.h"
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::out_of_range
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedMemoryBlobTest, NewBlobIsEmpty) {
+    PagedMemoryBlob blob;
+    EXPECT_EQ(0U, blob.GetSize());
+    EXPECT_EQ(0U, blob.CountPages());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedMemoryBlobTest, ZeroPageSizeIsRejected) {
+    EXPECT_THROW(PagedMemoryBlob blob(0), std::invalid_argument);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedMemoryBlobTest, WritesCanSpanPages) {
+    PagedMemoryBlob blob(4);
+    blob.WriteAt(0, u8"Hello World", 11);
+    EXPECT_EQ(11U, blob.GetSize());
+    EXPECT_EQ(3U, blob.CountPages());
+
+    blob.WriteAt(3, u8"p, w", 4);
+    blob.WriteAt(11, u8"!", 1);
+
+    char contents[12];
+    blob.ReadAt(0, contents, 12);
+    EXPECT_EQ(std::string(u8"Help, world!"), std::string(contents, 12));
+
+    char middle[5];
+    blob.ReadAt(2, middle, 5);
+    EXPECT_EQ(std::string(u8"lp, w"), std::string(middle, 5));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedMemoryBlobTest, AccessesPastEndThrow) {
+    PagedMemoryBlob blob(4);
+    blob.WriteAt(0, u8"Hello", 5);
+
+    char buffer[2];
+    EXPECT_THROW(blob.ReadAt(4, buffer, 2), std::out_of_range);
+    EXPECT_THROW(blob.WriteAt(6, u8"!", 1), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedMemoryBlobTest, SnapshotSharesAllPages) {
+    PagedMemoryBlob blob(16);
+    std::vector<std::uint8_t> data(100, 42);
+    blob.WriteAt(0, data.data(), data.size());
+    EXPECT_EQ(0U, blob.CountSharedPages());
+
+    std::shared_ptr<PagedMemoryBlob> snapshot = blob.Snapshot();
+    EXPECT_EQ(100U, snapshot->GetSize());
+    EXPECT_EQ(7U, blob.CountSharedPages());
+    EXPECT_EQ(7U, snapshot->CountSharedPages());
+
+    snapshot.reset();
+    EXPECT_EQ(0U, blob.CountSharedPages());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedMemoryBlobTest, WritesOnlyDuplicateTouchedPages) {
+    PagedMemoryBlob blob(4);
+    blob.WriteAt(0, u8"Hello World", 11);
+
+    std::shared_ptr<PagedMemoryBlob> snapshot = blob.Snapshot();
+    blob.WriteAt(6, u8"w", 1);
+    EXPECT_EQ(2U, blob.CountSharedPages());
+
+    char contents[11];
+    blob.ReadAt(0, contents, 11);
+    EXPECT_EQ(std::string(u8"Hello world"), std::string(contents, 11));
+    snapshot->ReadAt(0, contents, 11);
+    EXPECT_EQ(std::string(u8"Hello World"), std::string(contents, 11));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(PagedMemoryBlobTest, SnapshotsCanBeModifiedIndependently) {
+    PagedMemoryBlob blob(4);
+    blob.WriteAt(0, u8"abcdefgh", 8);
+
+    std::shared_ptr<PagedMemoryBlob> first = blob.Snapshot();
+    std::shared_ptr<PagedMemoryBlob> second = first->Snapshot();
+    first->WriteAt(0, u8"X", 1);
+    second->WriteAt(8, u8"ij", 2);
+
+    char contents[10];
+    blob.ReadAt(0, contents, 8);
+    EXPECT_EQ(std::string(u8"abcdefgh"), std::string(contents, 8));
+    first->ReadAt(0, contents, 8);
+    EXPECT_EQ(std::string(u8"Xbcdefgh"), std::string(contents, 8));
+    ASSERT_EQ(10U, second->GetSize());
+    second->ReadAt(0, contents, 10);
+    EXPECT_EQ(std::string(u8"abcdefghij"), std::string(contents, 10));
+    EXPECT_EQ(8U, first->GetSize());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
@@ -0,0 +1,58 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+
+#ifndef NUCLEX_STORAGE_RANDOMDATAFACTORY_H
+#define NUCLEX_STORAGE_RANDOMDATAFACTORY_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint32_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates pseudo-random test data</summary>
+  /// <param name="byteCount">Number of bytes that will be generated</param>
+  /// <param name="seed">Seed from which the data will be generated</param>
+  /// <returns>A buffer filled with pseudo-random bytes</returns>
+  /// <remarks>
+  ///   Uses a xorshift generator, so the same seed always produces the same bytes
+  ///   on every platform and the data is practically incompressible.
+  /// </remarks>
+  inline std::vector<std::uint8_t> MakeRandomData(std::size_t byteCount, std::uint32_t seed) {
+    std::vector<std::uint8_t> data(byteCount);
+    for(std::size_t index = 0; index < byteCount; ++index) {
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      data[index] = static_cast<std::uint8_t>(seed >> 24);
+    }
+    return data;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_RANDOMDATAFACTORY_H
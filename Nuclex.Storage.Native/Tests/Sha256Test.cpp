@@ -0,0 +1,96 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "../Source/Helpers/Sha256.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Formats a hash as lower case hexadecimal digits</summary>
+  /// <param name="hash">Hash that will be formatted</param>
+  /// <returns>The hash as a string of hexadecimal digits</returns>
+  std::string toHex(const std::array<std::uint8_t, 32> &hash) {
+    static const char digits[] = u8"0123456789abcdef";
+
+    std::string hex;
+    for(std::size_t index = 0; index < hash.size(); ++index) {
+      hex.push_back(digits[hash[index] >> 4]);
+      hex.push_back(digits[hash[index] & 15]);
+    }
+    return hex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Sha256Test, KnownHashesAreReproduced) {
+    EXPECT_EQ(
+      std::string(u8"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"),
+      toHex(Sha256::Hash(u8"", 0))
+    );
+    EXPECT_EQ(
+      std::string(u8"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"),
+      toHex(Sha256::Hash(u8"abc", 3))
+    );
+
+    // 56 bytes, so the length no longer fits into the first block
+    std::string twoBlocks(u8"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+    EXPECT_EQ(
+      std::string(u8"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"),
+      toHex(Sha256::Hash(twoBlocks.data(), twoBlocks.length()))
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Sha256Test, DataCanBeHashedInPieces) {
+    std::vector<std::uint8_t> data(1000);
+    for(std::size_t index = 0; index < data.size(); ++index) {
+      data[index] = static_cast<std::uint8_t>(index * 31);
+    }
+
+    Sha256 sha256;
+    std::size_t offset = 0;
+    for(std::size_t pieceByteCount = 1; offset < data.size(); pieceByteCount += 7) {
+      std::size_t byteCount = std::min(pieceByteCount, data.size() - offset);
+      sha256.Update(data.data() + offset, byteCount);
+      offset += byteCount;
+    }
+
+    EXPECT_EQ(Sha256::Hash(data.data(), data.size()), sha256.Finish());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
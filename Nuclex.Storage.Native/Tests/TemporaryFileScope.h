@@ -0,0 +1,85 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_STORAGE_TEMPORARYFILESCOPE_H
+#define NUCLEX_STORAGE_TEMPORARYFILESCOPE_H
+
+#include "Nuclex/Storage/Config.h"
+
+#include <cstdio> // for std::remove()
+#include <stdexcept> // for std::runtime_error
+#include <string>
+
+#if defined(NUCLEX_STORAGE_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h>
+#else
+#include <cstdlib> // for mkstemp()
+#include <unistd.h> // for close()
+#endif
+
+namespace Nuclex { namespace Storage {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a uniquely named, empty temporary file for the unit tests</summary>
+  class TemporaryFileScope {
+
+    /// <summary>Creates a new temporary file</summary>
+    public: TemporaryFileScope() {
+#if defined(NUCLEX_STORAGE_WIN32)
+      char directory[MAX_PATH + 1];
+      char path[MAX_PATH + 1];
+      ::GetTempPathA(MAX_PATH, directory);
+      if(::GetTempFileNameA(directory, "nst", 0, path) == 0) {
+        throw std::runtime_error(u8"Could not create temporary file");
+      }
+      this->path.assign(path);
+#else
+      char path[] = "/tmp/nuclex-storage-XXXXXX";
+      int fileDescriptor = ::mkstemp(path);
+      if(fileDescriptor == -1) {
+        throw std::runtime_error(u8"Could not create temporary file");
+      }
+      ::close(fileDescriptor);
+      this->path.assign(path);
+#endif
+    }
+
+    /// <summary>Deletes the temporary file</summary>
+    public: ~TemporaryFileScope() {
+      std::remove(this->path.c_str());
+    }
+
+    /// <summary>Gives the path of the temporary file</summary>
+    /// <returns>The absolute path of the temporary file</returns>
+    public: const std::string &GetPath() const { return this->path; }
+
+    /// <summary>Path of the temporary file</summary>
+    private: std::string path;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Storage
+
+#endif // NUCLEX_STORAGE_TEMPORARYFILESCOPE_H
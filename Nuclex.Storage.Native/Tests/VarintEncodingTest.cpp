@@ -0,0 +1,163 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "../Source/Helpers/VarintEncoding.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Generates pseudo-random values of all four stream-vbyte lengths</summary>
+  /// <param name="count">Number of values that will be generated</param>
+  /// <returns>A vector with the specified number of pseudo-random values</returns>
+  std::vector<std::uint32_t> makeValues(std::size_t count) {
+    std::vector<std::uint32_t> values(count);
+
+    std::uint32_t state = 12345;
+    for(std::size_t index = 0; index < count; ++index) {
+      state = state * 1103515245U + 12345U;
+      values[index] = state >> ((state >> 8) % 32);
+    }
+
+    return values;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Encodes and decodes values in the stream-vbyte layout</summary>
+  /// <param name="values">Values that will be encoded and decoded again</param>
+  /// <param name="isDeltaEncoded">Whether the values will be stored as differences</param>
+  /// <returns>The values after they have been decoded again</returns>
+  std::vector<std::uint32_t> roundTrip(
+    const std::vector<std::uint32_t> &values, bool isDeltaEncoded
+  ) {
+    using Nuclex::Storage::Helpers::VarintEncoder;
+
+    std::vector<std::uint8_t> encoded(
+      VarintEncoder::GetStreamVByteMaximumLength(values.size()) +
+      VarintEncoder::StreamVBytePaddingByteCount
+    );
+    std::size_t byteCount = VarintEncoder::EncodeStreamVByte(
+      values.data(), values.size(), encoded.data(), isDeltaEncoded
+    );
+    EXPECT_EQ(
+      VarintEncoder::GetStreamVByteControlLength(values.size()) +
+      VarintEncoder::GetStreamVByteDataLength(encoded.data(), values.size()),
+      byteCount
+    );
+
+    std::vector<std::uint32_t> decoded(values.size() + 1, 0xDEADBEEFU);
+    EXPECT_EQ(
+      byteCount,
+      VarintEncoder::DecodeStreamVByte(
+        encoded.data(), values.size(), decoded.data(), isDeltaEncoded
+      )
+    );
+    EXPECT_EQ(0xDEADBEEFU, decoded.back()); // Nothing written past the end
+    decoded.pop_back();
+
+    return decoded;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Helpers {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VarintEncodingTest, ZigZagKeepsSmallValuesSmall) {
+    EXPECT_EQ(0U, VarintEncoder::ZigZagEncode(std::int32_t(0)));
+    EXPECT_EQ(1U, VarintEncoder::ZigZagEncode(std::int32_t(-1)));
+    EXPECT_EQ(2U, VarintEncoder::ZigZagEncode(std::int32_t(1)));
+    EXPECT_EQ(0xFFFFFFFFU, VarintEncoder::ZigZagEncode(std::int32_t(-2147483647 - 1)));
+    EXPECT_EQ(0xFFFFFFFFFFFFFFFEULL, VarintEncoder::ZigZagEncode(std::int64_t(INT64_MAX)));
+
+    const std::int64_t values[] = { 0, 1, -1, 12345, -12345, INT64_MAX, INT64_MIN };
+    for(std::int64_t value : values) {
+      EXPECT_EQ(value, VarintEncoder::ZigZagDecode(VarintEncoder::ZigZagEncode(value)));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VarintEncodingTest, VarintsUseSevenBitsPerByte) {
+    std::uint8_t encoded[VarintEncoder::MaximumVarintByteCount];
+    EXPECT_EQ(1U, VarintEncoder::EncodeVarint(127, encoded));
+    EXPECT_EQ(0x7F, encoded[0]);
+    EXPECT_EQ(2U, VarintEncoder::EncodeVarint(128, encoded));
+    EXPECT_EQ(0x80, encoded[0]);
+    EXPECT_EQ(0x01, encoded[1]);
+    EXPECT_EQ(10U, VarintEncoder::EncodeVarint(0xFFFFFFFFFFFFFFFFULL, encoded));
+
+    std::uint64_t value = 0;
+    EXPECT_EQ(0U, VarintEncoder::DecodeVarint(encoded, 9, value)); // Incomplete
+    EXPECT_EQ(10U, VarintEncoder::DecodeVarint(encoded, 10, value));
+    EXPECT_EQ(0xFFFFFFFFFFFFFFFFULL, value);
+
+    const std::uint8_t overlong[11] = {
+      0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00
+    };
+    EXPECT_THROW(VarintEncoder::DecodeVarint(overlong, 11, value), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VarintEncodingTest, StreamVByteLayoutIsControlBytesThenData) {
+    const std::uint32_t values[] = { 1, 0x100, 0x10000, 0x1000000, 0x12 };
+
+    std::uint8_t encoded[32];
+    ASSERT_EQ(2U + 11U, VarintEncoder::EncodeStreamVByte(values, 5, encoded, false));
+
+    const std::uint8_t expected[] = {
+      0xE4, 0x00, // lengths 1, 2, 3 and 4, then 1 for the fifth value
+      0x01, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x12
+    };
+    for(std::size_t index = 0; index < sizeof(expected); ++index) {
+      EXPECT_EQ(expected[index], encoded[index]);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VarintEncodingTest, StreamVByteArraysSurviveRoundTrip) {
+    for(std::size_t count = 0; count < 70; ++count) {
+      std::vector<std::uint32_t> values = makeValues(count);
+      EXPECT_EQ(values, roundTrip(values, false));
+      EXPECT_EQ(values, roundTrip(values, true));
+    }
+
+    std::vector<std::uint32_t> values = makeValues(100003);
+    EXPECT_EQ(values, roundTrip(values, false));
+    EXPECT_EQ(values, roundTrip(values, true));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Helpers
@@ -0,0 +1,193 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlBlobParser.h"
+#include "Nuclex/Storage/Xml/XmlParseError.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "MemoryBlobFactory.h"
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>XML handler that records the events it receives as text</summary>
+  class RecordingHandler : public Nuclex::Storage::Xml::XmlHandler {
+
+    /// <summary>Called when the parser encounters an opening element</summary>
+    /// <param name="name">Interned name of the element</param>
+    /// <param name="attributes">Attributes the element carries</param>
+    /// <param name="attributeCount">Number of attributes the element carries</param>
+    public: void ElementStarted(
+      const std::string &name, const Attribute *attributes, std::size_t attributeCount
+    ) override {
+      this->Events.append(u8"<");
+      this->Events.append(name);
+      for(std::size_t index = 0; index < attributeCount; ++index) {
+        this->Events.append(u8" ");
+        this->Events.append(*attributes[index].Name);
+        this->Events.append(u8"=");
+        this->Events.append(attributes[index].Value);
+      }
+      this->Events.append(u8">");
+      this->Names.push_back(&name);
+    }
+
+    /// <summary>Called when the parser encounters a closing element</summary>
+    /// <param name="name">Interned name of the element</param>
+    public: void ElementEnded(const std::string &name) override {
+      this->Events.append(u8"</");
+      this->Events.append(name);
+      this->Events.append(u8">");
+    }
+
+    /// <summary>Called when the parser encounters text inside an element</summary>
+    /// <param name="text">Text that has been encountered</param>
+    /// <param name="length">Number of bytes in the text</param>
+    public: void TextEncountered(const char *text, std::size_t length) override {
+      this->Events.append(text, length);
+    }
+
+    /// <summary>Events the handler has received</summary>
+    public: std::string Events;
+    /// <summary>Addresses of the element names that have been reported</summary>
+    public: std::vector<const std::string *> Names;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>XML handler that throws when it encounters an element</summary>
+  class ThrowingHandler : public Nuclex::Storage::Xml::XmlHandler {
+
+    /// <summary>Called when the parser encounters an opening element</summary>
+    /// <param name="name">Interned name of the element</param>
+    /// <param name="attributes">Attributes the element carries</param>
+    /// <param name="attributeCount">Number of attributes the element carries</param>
+    public: void ElementStarted(
+      const std::string &name, const Attribute *attributes, std::size_t attributeCount
+    ) override {
+      (void)attributes;
+      (void)attributeCount;
+      if(name == u8"bad") {
+        throw std::logic_error(u8"Handler refused element");
+      }
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobParserTest, ReportsElementsAttributesAndText) {
+    std::string xml(u8"<root a=\"1\"><child b=\"2\" c=\"3\">text</child><empty /></root>");
+    RecordingHandler handler;
+    XmlBlobParser::Parse(*MakeMemoryBlob(xml, true), handler);
+
+    EXPECT_EQ(
+      handler.Events,
+      std::string(u8"<root a=1><child b=2 c=3>text</child><empty></empty></root>")
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobParserTest, RepeatedNamesAreInterned) {
+    std::string xml(u8"<root><item /><item /><item /></root>");
+    RecordingHandler handler;
+    XmlBlobParser::Parse(*MakeMemoryBlob(xml, true), handler);
+
+    ASSERT_EQ(handler.Names.size(), 4U);
+    EXPECT_EQ(handler.Names[1], handler.Names[2]);
+    EXPECT_EQ(handler.Names[2], handler.Names[3]);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobParserTest, ParsesInChunksFromUnsealedBlob) {
+    std::string xml(u8"<root>");
+    std::string expected(u8"<root>");
+    for(std::size_t index = 0; index < 100; ++index) {
+      std::string element = u8"<e i=\"" + std::to_string(index) + u8"\" />";
+      xml.append(element);
+      expected.append(u8"<e i=" + std::to_string(index) + u8"></e>");
+    }
+    xml.append(u8"</root>");
+    expected.append(u8"</root>");
+
+    RecordingHandler sealedHandler;
+    XmlBlobParser::Parse(*MakeMemoryBlob(xml, true), sealedHandler, 7);
+    RecordingHandler unsealedHandler;
+    XmlBlobParser::Parse(*MakeMemoryBlob(xml, false), unsealedHandler, 7);
+
+    EXPECT_EQ(sealedHandler.Events, expected);
+    EXPECT_EQ(unsealedHandler.Events, expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobParserTest, ParsesSectionOfBlob) {
+    std::string xml(u8"<root><first>1</first><second>2</second></root>");
+    std::size_t start = xml.find(u8"<second>");
+    std::size_t end = xml.find(u8"</root>");
+
+    RecordingHandler handler;
+    XmlBlobParser::Parse(*MakeMemoryBlob(xml, true), start, end - start, handler);
+
+    EXPECT_EQ(handler.Events, std::string(u8"<second>2</second>"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobParserTest, MalformedDocumentThrowsParseError) {
+    RecordingHandler handler;
+    EXPECT_THROW(
+      XmlBlobParser::Parse(*MakeMemoryBlob(u8"<root><open></root>", true), handler),
+      XmlParseError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobParserTest, HandlerExceptionsAreRethrown) {
+    ThrowingHandler handler;
+    std::shared_ptr<MemoryBlob> blob = (
+      MakeMemoryBlob(u8"<root><good /><bad /><good /></root>", true)
+    );
+    EXPECT_THROW(XmlBlobParser::Parse(*blob, handler), std::logic_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
@@ -0,0 +1,422 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlBlobReader.h"
+#include "Nuclex/Storage/Xml/XmlBlobWriter.h"
+#include "Nuclex/Storage/Xml/XmlParseError.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "MemoryBlobFactory.h"
+#include <gtest/gtest.h>
+
+#include <Nuclex/Support/AllocationTracker.h>
+#include <Nuclex/Support/Text/InternedString.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an XML document with a number of elements carrying attributes</summary>
+  /// <param name="elementCount">Number of elements the document will contain</param>
+  /// <returns>The XML document as plaintext</returns>
+  std::string makeXml(std::size_t elementCount) {
+    std::string xml(u8"<?xml version=\"1.0\"?><level>");
+    for(std::size_t index = 0; index < elementCount; ++index) {
+      xml.append(u8"<entity id=\"");
+      xml.append(std::to_string(index));
+      xml.append(u8"\" />");
+    }
+    xml.append(u8"</level>");
+    return xml;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads all elements from an XML document and collects their ids</summary>
+  /// <param name="reader">Reader that will be used to read the XML document</param>
+  /// <returns>The ids of all elements in the order they appeared</returns>
+  std::vector<std::string> collectIds(Nuclex::Storage::Xml::XmlBlobReader &reader) {
+    using Nuclex::Storage::Xml::XmlReadEvent;
+
+    std::vector<std::string> ids;
+    for(;;) {
+      XmlReadEvent readEvent = reader.Read();
+      if(readEvent == XmlReadEvent::End) {
+        break;
+      }
+      if(readEvent == XmlReadEvent::ElementStart) {
+        if(reader.TryEnterAttribute(u8"id")) {
+          std::string id;
+          reader.Read(id);
+          reader.LeaveAttribute();
+          ids.push_back(id);
+        }
+      }
+    }
+
+    return ids;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, ReadsElementsFromBlob) {
+    XmlBlobReader reader(MakeMemoryBlob(makeXml(3), false));
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), std::string(u8"level"));
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), std::string(u8"entity"));
+    ASSERT_EQ(reader.CountAttributes(), 1U);
+    EXPECT_EQ(reader.GetAttributeName(0), std::string(u8"id"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, ParsesDirectlyFromBlobMemory) {
+    std::string xml = makeXml(1000);
+
+    XmlBlobReader copyingReader(MakeMemoryBlob(xml, false));
+    XmlBlobReader inPlaceReader(MakeMemoryBlob(xml, true));
+
+    std::vector<std::string> copiedIds = collectIds(copyingReader);
+    std::vector<std::string> inPlaceIds = collectIds(inPlaceReader);
+    ASSERT_EQ(copiedIds.size(), 1000U);
+    EXPECT_EQ(inPlaceIds, copiedIds);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, ChunkSizeDoesNotAffectResults) {
+    std::string xml = makeXml(200);
+
+    XmlBlobReader referenceReader(MakeMemoryBlob(xml, false));
+    std::vector<std::string> referenceIds = collectIds(referenceReader);
+    ASSERT_EQ(referenceIds.size(), 200U);
+
+    const std::size_t chunkByteCounts[] = { 1, 7, 100, 1024 * 1024 };
+    for(std::size_t index = 0; index < sizeof(chunkByteCounts) / sizeof(std::size_t); ++index) {
+      XmlBlobReader copyingReader(MakeMemoryBlob(xml, false), chunkByteCounts[index]);
+      EXPECT_EQ(collectIds(copyingReader), referenceIds);
+
+      XmlBlobReader inPlaceReader(MakeMemoryBlob(xml, true), chunkByteCounts[index]);
+      EXPECT_EQ(collectIds(inPlaceReader), referenceIds);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, NamesAreInterned) {
+    XmlBlobReader reader(MakeMemoryBlob(makeXml(2), false));
+    const std::string &entityName = reader.InternName(u8"entity");
+    const std::string &idName = reader.InternName(u8"id");
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_NE(&reader.GetElementName(), &entityName);
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(&reader.GetElementName(), &entityName);
+    ASSERT_EQ(reader.CountAttributes(), 1U);
+    EXPECT_EQ(&reader.GetAttributeName(0), &idName);
+    EXPECT_EQ(reader.GetAttributeValue(0), std::string(u8"0"));
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+    EXPECT_EQ(&reader.GetElementName(), &entityName);
+    EXPECT_EQ(reader.CountAttributes(), 0U);
+    EXPECT_THROW(reader.GetAttributeValue(0), std::out_of_range);
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(&reader.GetElementName(), &entityName);
+    EXPECT_EQ(reader.GetAttributeValue(0), std::string(u8"1"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, NamesAreSharedWithInternedStrings) {
+    const Nuclex::Support::Text::InternedString entityName(u8"entity");
+    const Nuclex::Support::Text::InternedString idName(u8"id");
+
+    XmlBlobReader firstReader(MakeMemoryBlob(makeXml(1), false));
+    XmlBlobReader secondReader(MakeMemoryBlob(makeXml(1), true));
+    for(XmlBlobReader *reader : { &firstReader, &secondReader }) {
+      ASSERT_EQ(reader->Read(), XmlReadEvent::ElementStart);
+      ASSERT_EQ(reader->Read(), XmlReadEvent::ElementStart);
+      EXPECT_EQ(&reader->GetElementName(), &entityName.ToString());
+      EXPECT_EQ(&reader->GetAttributeName(0), &idName.ToString());
+      EXPECT_TRUE(reader->TryEnterAttribute(idName));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, UnknownAttributesCanNotBeEntered) {
+    XmlBlobReader reader(MakeMemoryBlob(makeXml(1), false));
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+
+    EXPECT_FALSE(reader.TryEnterAttribute(u8"neverSeenBefore"));
+    EXPECT_FALSE(reader.TryEnterAttribute(u8"level"));
+    EXPECT_TRUE(reader.TryEnterAttribute(u8"id"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, AttributesCanBeReadInBulk) {
+    std::string xml(
+      u8"<?xml version=\"1.0\"?>"
+      u8"<level><entity name=\"crate\" x=\"12\" y=\"-7\" mass=\"2.5\" /></level>"
+    );
+    XmlBlobReader reader(MakeMemoryBlob(xml, true));
+    const std::string &xName = reader.InternName(u8"x");
+    const std::string &yName = reader.InternName(u8"y");
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+
+    std::string name;
+    std::int32_t x = 0, y = 0;
+    float mass = 0.0f;
+    std::uint32_t health = 100;
+    std::size_t foundCount = reader.ReadAttributes(
+      {
+        { xName, x }, { yName, y }, // interned names
+        { std::string(u8"name"), name },
+        { std::string(u8"mass"), mass },
+        { std::string(u8"health"), health } // missing from the element
+      }
+    );
+
+    EXPECT_EQ(foundCount, 4U);
+    EXPECT_EQ(name, std::string(u8"crate"));
+    EXPECT_EQ(x, 12);
+    EXPECT_EQ(y, -7);
+    EXPECT_FLOAT_EQ(mass, 2.5f);
+    EXPECT_EQ(health, 100U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, BinaryDataRoundTrips) {
+    const XmlBinaryFormat formats[] = { XmlBinaryFormat::Base64, XmlBinaryFormat::BinHex };
+    const std::size_t byteCounts[] = { 0, 10, 5000 };
+
+    for(std::size_t formatIndex = 0; formatIndex < 2; ++formatIndex) {
+      for(std::size_t countIndex = 0; countIndex < 3; ++countIndex) {
+        std::size_t byteCount = byteCounts[countIndex];
+        std::vector<std::uint8_t> data(byteCount + 4); // Header is taken from here, too
+        for(std::size_t index = 0; index < data.size(); ++index) {
+          data[index] = static_cast<std::uint8_t>(index * 7 + 3);
+        }
+
+        std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+        {
+          XmlBlobWriter writer(blob);
+          writer.SetBinaryFormat(formats[formatIndex]);
+          writer.BeginElement(u8"mesh");
+          writer.BeginAttribute(u8"header");
+          writer.Write(data.data(), 4);
+          writer.EndAttribute();
+          writer.Write(data.data(), byteCount);
+          writer.EndElement();
+        }
+        blob->Seal();
+
+        XmlBlobReader reader(blob, 100); // Small chunks to split up the text
+        reader.SetBinaryFormat(formats[formatIndex]);
+        ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+
+        std::vector<std::uint8_t> header(4);
+        reader.EnterAttribute(u8"header");
+        reader.Read(header.data(), header.size());
+        reader.LeaveAttribute();
+        EXPECT_EQ(header, std::vector<std::uint8_t>(data.begin(), data.begin() + 4));
+
+        std::vector<std::uint8_t> contents(byteCount + 1);
+        if(byteCount > 0) {
+          ASSERT_EQ(reader.Read(), XmlReadEvent::Content);
+        }
+        reader.Read(contents.data(), byteCount);
+        contents.resize(byteCount);
+        data.resize(byteCount);
+        EXPECT_EQ(contents, data);
+
+        EXPECT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, ZeroChunkSizeIsRejected) {
+    EXPECT_THROW(
+      XmlBlobReader reader(MakeMemoryBlob(makeXml(1), true), 0),
+      std::invalid_argument
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, NumbersAreParsedStrictly) {
+    std::string xml(
+      u8"<?xml version=\"1.0\"?>"
+      u8"<level><entity x=\" 12 \" ratio=\"0.125\" size=\"300\" name=\"crate\" /></level>"
+    );
+    XmlBlobReader reader(MakeMemoryBlob(xml, true));
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+
+    std::int32_t x = 0;
+    reader.EnterAttribute(u8"x");
+    reader.Read(x);
+    reader.LeaveAttribute();
+    EXPECT_EQ(x, 12);
+
+    double ratio = 0.0;
+    reader.EnterAttribute(u8"ratio");
+    reader.Read(ratio);
+    reader.LeaveAttribute();
+    EXPECT_EQ(ratio, 0.125);
+
+    std::uint8_t size = 0;
+    reader.EnterAttribute(u8"size");
+    EXPECT_THROW(reader.Read(size), std::out_of_range);
+    reader.LeaveAttribute();
+
+    float name = 0.0f;
+    reader.EnterAttribute(u8"name");
+    EXPECT_THROW(reader.Read(name), std::invalid_argument);
+    reader.LeaveAttribute();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, CanBeResetToReadAnotherDocument) {
+    XmlBlobReader reader(MakeMemoryBlob(makeXml(3), true));
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    const std::string &firstName = reader.GetElementName();
+
+    // Reset in the middle of a document, the parser is suspended at this point
+    reader.Reset(MakeMemoryBlob(makeXml(5), false));
+    std::vector<std::string> ids = collectIds(reader);
+    ASSERT_EQ(ids.size(), 5U);
+    EXPECT_EQ(ids[4], std::string(u8"4"));
+
+    // Names interned before the reset are still valid and get reused
+    reader.Reset(MakeMemoryBlob(makeXml(1), true));
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(&reader.GetElementName(), &firstName);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, ReadingDoesNotAllocatePerElement) {
+    using Nuclex::Support::AllocationSubsystem;
+    using Nuclex::Support::AllocationTracker;
+
+    // Attribute values longer than any small string buffer
+    std::string xml(u8"<?xml version=\"1.0\"?><level>");
+    for(std::size_t index = 0; index < 1000; ++index) {
+      xml.append(u8"<entity name=\"a fairly long name that needs heap memory ");
+      xml.append(std::to_string(index));
+      xml.append(u8"\">some text that also needs heap memory</entity>");
+    }
+    xml.append(u8"</level>");
+
+    bool wasEnabled = AllocationTracker::IsEnabled();
+    AllocationTracker::SetEnabled(true);
+
+    AllocationTracker::Snapshot initial = AllocationTracker::TakeSnapshot();
+    std::uint64_t warmupAllocationCount, steadyAllocationCount;
+    {
+      XmlBlobReader reader(MakeMemoryBlob(xml, true));
+      for(std::size_t index = 0; index < 30; ++index) {
+        ASSERT_NE(reader.Read(), XmlReadEvent::End);
+      }
+
+      AllocationTracker::Snapshot warm = AllocationTracker::TakeSnapshot();
+      while(reader.Read() != XmlReadEvent::End) {
+        // Just read through all the elements
+      }
+      AllocationTracker::Snapshot done = AllocationTracker::TakeSnapshot();
+
+      warmupAllocationCount = (
+        warm[AllocationSubsystem::Xml].AllocationCount -
+        initial[AllocationSubsystem::Xml].AllocationCount
+      );
+      steadyAllocationCount = (
+        done[AllocationSubsystem::Xml].AllocationCount -
+        warm[AllocationSubsystem::Xml].AllocationCount
+      );
+    }
+    AllocationTracker::Snapshot released = AllocationTracker::TakeSnapshot();
+
+    AllocationTracker::SetEnabled(wasEnabled);
+
+    EXPECT_GT(warmupAllocationCount, 0U);
+    EXPECT_LT(steadyAllocationCount, 10U); // Thousands if something copied per element
+
+    // Pooled eXpat parsers outlive the reader, but the reader's strings must be gone
+    EXPECT_GT(
+      released[AllocationSubsystem::Xml].FreeCount, initial[AllocationSubsystem::Xml].FreeCount
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, ResetClearsPreviousErrors) {
+    XmlBlobReader reader(MakeMemoryBlob(u8"<root><open></root>", true));
+    EXPECT_THROW(
+      for(;;) {
+        if(reader.Read() == XmlReadEvent::End) {
+          break;
+        }
+      },
+      XmlParseError
+    );
+
+    reader.Reset(MakeMemoryBlob(makeXml(2), true));
+    EXPECT_EQ(collectIds(reader).size(), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobReaderTest, ResetChecksSectionBounds) {
+    XmlBlobReader reader(MakeMemoryBlob(makeXml(1), true));
+    EXPECT_THROW(reader.Reset(MakeMemoryBlob(makeXml(1), true), 0, 100000), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
@@ -0,0 +1,291 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlBlobWriter.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory blob that counts how often it is written to</summary>
+  class CountingBlob : public Nuclex::Storage::MemoryBlob {
+
+    /// <summary>Initializes a new counting blob</summary>
+    public: CountingBlob() :
+      WriteCount(0) {}
+
+    /// <summary>Writes raw data into the blob</summary>
+    /// <param name="location">Absolute position data will be written to</param>
+    /// <param name="buffer">Buffer from which data will be taken</param>
+    /// <param name="count">Number of bytes that will be written</param>
+    public: void WriteAt(std::uint64_t location, const void *buffer, std::size_t count) override {
+      ++this->WriteCount;
+      MemoryBlob::WriteAt(location, buffer, count);
+    }
+
+    /// <summary>Number of times WriteAt() has been called</summary>
+    public: std::size_t WriteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes an XML document with a number of elements carrying attributes</summary>
+  /// <param name="writer">Writer through which the document will be written</param>
+  /// <param name="elementCount">Number of elements the document will contain</param>
+  void writeXml(Nuclex::Storage::Xml::XmlWriter &writer, std::size_t elementCount) {
+    writer.BeginElement(u8"level");
+    for(std::size_t index = 0; index < elementCount; ++index) {
+      writer.BeginElement(u8"entity");
+      writer.BeginAttribute(u8"id");
+      writer.Write(static_cast<std::uint32_t>(index));
+      writer.EndAttribute();
+      writer.EndElement();
+    }
+    writer.EndElement();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the whole contents of a blob into a string</summary>
+  /// <param name="blob">Blob whose contents will be read</param>
+  /// <returns>A string containing everything stored in the blob</returns>
+  std::string readAll(const Nuclex::Storage::Blob &blob) {
+    std::string contents(static_cast<std::size_t>(blob.GetSize()), '\0');
+    if(!contents.empty()) {
+      blob.ReadAt(0, &contents[0], contents.size());
+    }
+    return contents;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, LinesAreCombined) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      XmlBlobWriter writer(blob);
+      writeXml(writer, 100);
+    }
+
+    // Far less than the default buffer size, so the whole document goes out in one write
+    EXPECT_EQ(1U, blob->WriteCount);
+    EXPECT_NE(std::string::npos, readAll(*blob).find(u8"<entity id=\"99\" />"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, WriteBufferThresholdIsObeyed) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      XmlBlobWriter writer(blob, 1024);
+      writeXml(writer, 1000);
+    }
+
+    // Every write except the final one must have reached the threshold, the lines
+    // in the document are short, so writes never exceed it by more than one line.
+    std::uint64_t size = blob->GetSize();
+    EXPECT_GT(size, 20000U);
+    EXPECT_GE(blob->WriteCount, size / 1100);
+    EXPECT_LE(blob->WriteCount, size / 1024 + 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, FlushHandsFinishedLinesToBlob) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    XmlBlobWriter writer(blob);
+
+    writer.BeginElement(u8"level");
+    writer.BeginElement(u8"entity");
+    writer.EndElement();
+    EXPECT_EQ(0U, blob->WriteCount);
+    EXPECT_EQ(0U, blob->GetSize());
+
+    writer.Flush();
+    EXPECT_EQ(1U, blob->WriteCount);
+    EXPECT_EQ(std::string(u8"<level>\n"), readAll(*blob));
+
+    writer.EndElement();
+    writer.Flush();
+    EXPECT_EQ(std::string(u8"<level>\n  <entity />\n"), readAll(*blob));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, WriteBufferCanBeDisabled) {
+    std::shared_ptr<CountingBlob> bufferedBlob = std::make_shared<CountingBlob>();
+    {
+      XmlBlobWriter writer(bufferedBlob);
+      writer.WriteDeclaration();
+      writeXml(writer, 10);
+    }
+
+    std::shared_ptr<CountingBlob> unbufferedBlob = std::make_shared<CountingBlob>();
+    {
+      XmlBlobWriter writer(unbufferedBlob, 0);
+      writer.WriteDeclaration();
+      writeXml(writer, 10);
+    }
+
+    EXPECT_EQ(readAll(*bufferedBlob), readAll(*unbufferedBlob));
+    EXPECT_GT(unbufferedBlob->WriteCount, 10U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, NumbersArePrintedAsText) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      XmlBlobWriter writer(blob);
+      writer.BeginElement(u8"values");
+      writer.BeginAttribute(u8"byte");
+      writer.Write(static_cast<std::uint8_t>(200));
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"short");
+      writer.Write(static_cast<std::int16_t>(-1234));
+      writer.EndAttribute();
+      writer.BeginAttribute(u8"flag");
+      writer.Write(true);
+      writer.EndAttribute();
+
+      writer.BeginElement(u8"float");
+      writer.Write(0.25f);
+      writer.EndElement();
+      writer.BeginElement(u8"double");
+      writer.Write(-1.5);
+      writer.EndElement();
+      writer.BeginElement(u8"long");
+      writer.Write(static_cast<std::uint64_t>(18446744073709551615ULL));
+      writer.EndElement();
+      writer.EndElement();
+    }
+
+    EXPECT_EQ(
+      std::string(
+        u8"<values byte=\"200\" short=\"-1234\" flag=\"true\">\n"
+        u8"  <float>0.25</float>\n"
+        u8"  <double>-1.5</double>\n"
+        u8"  <long>18446744073709551615</long>\n"
+        u8"</values>\n"
+      ),
+      readAll(*blob)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, CompactModeOmitsFormatting) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      XmlBlobWriter writer(blob, XmlBlobWriter::DefaultWriteBufferByteCount, true);
+      EXPECT_TRUE(writer.IsCompact());
+
+      writer.WriteDeclaration();
+      writeXml(writer, 2);
+    }
+
+    EXPECT_EQ(
+      std::string(
+        u8"<?xml version=\"1.0\" encoding=\"utf-8\" ?>"
+        u8"<level><entity id=\"0\"/><entity id=\"1\"/></level>"
+      ),
+      readAll(*blob)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, CompactModeKeepsValuesApart) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      XmlBlobWriter writer(blob, XmlBlobWriter::DefaultWriteBufferByteCount, true);
+      writer.BeginElement(u8"numbers");
+      writer.Write(static_cast<std::uint32_t>(12));
+      writer.Write(static_cast<std::uint32_t>(34));
+      writer.EndElement();
+
+      std::string longText(300, 'x');
+      writer.BeginElement(u8"text");
+      writer.Write(longText);
+      writer.EndElement();
+    }
+
+    EXPECT_EQ(
+      std::string(u8"<numbers>12 34</numbers><text>") + std::string(300, 'x') + u8"</text>",
+      readAll(*blob)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, CompactModeObeysWriteBufferThreshold) {
+    std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+    {
+      XmlBlobWriter writer(blob, 1024, true);
+      writeXml(writer, 1000);
+    }
+
+    std::uint64_t size = blob->GetSize();
+    EXPECT_GT(size, 15000U);
+    EXPECT_GE(blob->WriteCount, size / 1100);
+    EXPECT_LE(blob->WriteCount, size / 1024 + 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlBlobWriterTest, AttributeValuesAreEscaped) {
+    std::string value(u8"Tom & \"Jerry\" <cartoon> with a long enough tail for SIMD & more");
+    std::string escaped(
+      u8"Tom &amp; &quot;Jerry&quot; &lt;cartoon&gt; with a long enough tail for SIMD &amp; more"
+    );
+
+    for(int compact = 0; compact < 2; ++compact) {
+      std::shared_ptr<CountingBlob> blob = std::make_shared<CountingBlob>();
+      {
+        XmlBlobWriter writer(blob, XmlBlobWriter::DefaultWriteBufferByteCount, compact != 0);
+        writer.BeginElement(u8"show");
+        writer.BeginAttribute(u8"title");
+        writer.Write(value);
+        writer.EndAttribute();
+        writer.EndElement();
+      }
+
+      EXPECT_NE(std::string::npos, readAll(*blob).find(u8"title=\"" + escaped + u8"\""));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
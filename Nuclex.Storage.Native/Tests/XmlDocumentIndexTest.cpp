@@ -0,0 +1,298 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlDocumentIndex.h"
+#include "Nuclex/Storage/Xml/XmlParseError.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "MemoryBlobFactory.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>XML document with a few nested elements the tests can look for</summary>
+  const char LevelXml[] =
+    u8"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+    u8"<!-- Tutorial level -->\n"
+    u8"<level name=\"Tutorial\">\n"
+    u8"  <entities>\n"
+    u8"    <entity id=\"1\"><position x=\"1\" y=\"2\" /></entity>\n"
+    u8"    <entity id=\"2\" />\n"
+    u8"    <light id=\"3\">Bright &amp; warm</light>\n"
+    u8"    <entity id=\"4\"><![CDATA[<not an element>]]></entity>\n"
+    u8"  </entities>\n"
+    u8"  <terrain size=\"64\" />\n"
+    u8"</level>\n";
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an XML document with a long list of records</summary>
+  /// <param name="recordCount">Number of records the document will contain</param>
+  /// <returns>The XML document as plaintext</returns>
+  std::string makeRecordXml(std::size_t recordCount) {
+    std::string xml(u8"<?xml version=\"1.0\"?>\n<records>\n");
+    for(std::size_t index = 0; index < recordCount; ++index) {
+      xml.append(u8"  <record id=\"");
+      xml.append(std::to_string(index));
+      xml.append(u8"\"><name>Record ");
+      xml.append(std::to_string(index));
+      xml.append(u8"</name></record>\n");
+    }
+    xml.append(u8"</records>\n");
+    return xml;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, AllElementsAreIndexed) {
+    XmlDocumentIndex index(MakeMemoryBlob(LevelXml, true));
+
+    ASSERT_EQ(index.CountElements(), 8U);
+    EXPECT_EQ(*index.GetElement(0).Name, u8"level");
+    EXPECT_EQ(index.GetElement(0).ParentIndex, XmlDocumentIndex::NoElement);
+    EXPECT_EQ(index.GetElement(0).SubtreeEndIndex, 8U);
+
+    EXPECT_EQ(*index.GetElement(3).Name, u8"position");
+    EXPECT_EQ(index.GetElement(3).Depth, 3U);
+    EXPECT_EQ(index.GetElement(3).ParentIndex, 2U);
+
+    // All elements with the same name share one string
+    EXPECT_EQ(index.GetElement(2).Name, index.GetElement(4).Name);
+
+    EXPECT_THROW(index.GetElement(8), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, OffsetsCoverWholeElements) {
+    const std::string xml(LevelXml);
+
+    // Use tiny chunks so the elements straddle chunk boundaries
+    XmlDocumentIndex index(MakeMemoryBlob(xml, false), 7);
+    ASSERT_EQ(index.CountElements(), 8U);
+
+    const XmlDocumentIndex::Element &entity = index.GetElement(2);
+    EXPECT_EQ(
+      xml.substr(
+        static_cast<std::size_t>(entity.StartOffset),
+        static_cast<std::size_t>(entity.EndOffset - entity.StartOffset)
+      ),
+      u8"<entity id=\"1\"><position x=\"1\" y=\"2\" /></entity>"
+    );
+
+    const XmlDocumentIndex::Element &terrain = index.GetElement(7);
+    EXPECT_EQ(
+      xml.substr(
+        static_cast<std::size_t>(terrain.StartOffset),
+        static_cast<std::size_t>(terrain.EndOffset - terrain.StartOffset)
+      ),
+      u8"<terrain size=\"64\" />"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, ChildrenCanBeEnumerated) {
+    XmlDocumentIndex index(MakeMemoryBlob(LevelXml, true));
+
+    std::size_t entities = index.FindElement(u8"level/entities");
+    ASSERT_EQ(entities, 1U);
+
+    std::size_t child = index.GetFirstChild(entities);
+    EXPECT_EQ(child, 2U);
+    child = index.GetNextSibling(child);
+    EXPECT_EQ(child, 4U); // skips over the position element in the first entity
+    child = index.GetNextSibling(child);
+    EXPECT_EQ(child, 5U);
+    child = index.GetNextSibling(child);
+    EXPECT_EQ(child, 6U);
+    EXPECT_EQ(index.GetNextSibling(child), XmlDocumentIndex::NoElement);
+
+    EXPECT_EQ(index.GetFirstChild(4), XmlDocumentIndex::NoElement);
+    EXPECT_EQ(index.GetNextSibling(entities), 7U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, ElementsCanBeFoundByPath) {
+    XmlDocumentIndex index(MakeMemoryBlob(LevelXml, true));
+
+    EXPECT_EQ(index.FindElement(u8"level"), 0U);
+    EXPECT_EQ(index.FindElement(u8"level/entities/light"), 5U);
+    EXPECT_EQ(index.FindElement(u8"level/terrain"), 7U);
+    EXPECT_EQ(index.FindElement(u8"level/entities/position"), XmlDocumentIndex::NoElement);
+    EXPECT_EQ(index.FindElement(u8"level/scripts"), XmlDocumentIndex::NoElement);
+    EXPECT_EQ(index.FindElement(u8"entities"), XmlDocumentIndex::NoElement);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, SubtreesCanBeReadDirectly) {
+    XmlDocumentIndex index(MakeMemoryBlob(LevelXml, true));
+
+    std::unique_ptr<XmlBlobReader> subtree = index.OpenSubtree(
+      index.FindElement(u8"level/entities/light")
+    );
+    XmlReader &reader = *subtree;
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), u8"light");
+    EXPECT_EQ(reader.GetAttributeValue<std::string>(u8"id"), u8"3");
+
+    std::string text;
+    for(;;) {
+      XmlReadEvent readEvent = reader.Read();
+      if(readEvent != XmlReadEvent::Content) {
+        ASSERT_EQ(readEvent, XmlReadEvent::ElementEnd);
+        break;
+      }
+      std::string piece;
+      reader.Read(piece);
+      text.append(piece);
+    }
+    EXPECT_EQ(text, u8"Bright & warm");
+    EXPECT_EQ(reader.Read(), XmlReadEvent::End);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, SubtreesOfUnsealedBlobsCanBeRead) {
+    XmlDocumentIndex index(MakeMemoryBlob(LevelXml, false));
+
+    std::unique_ptr<XmlBlobReader> subtree = index.OpenSubtree(2, 5);
+    XmlReader &reader = *subtree;
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), u8"entity");
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), u8"position");
+    EXPECT_EQ(reader.GetAttributeValue<int>(u8"y"), 2);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementEnd);
+    EXPECT_EQ(reader.Read(), XmlReadEvent::End);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, BrokenDocumentsAreReported) {
+    EXPECT_THROW(
+      XmlDocumentIndex index(MakeMemoryBlob(u8"<level><entities></level>", true)),
+      XmlParseError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, RecordsAreMergedInDocumentOrder) {
+    XmlDocumentIndex index(MakeMemoryBlob(makeRecordXml(1000), true));
+
+    std::vector<std::size_t> ids;
+    std::vector<std::size_t> elementIndices;
+    index.ParseChildrenInParallel(
+      0,
+      [](XmlReader &reader) {
+        reader.Read(); // <record>
+        std::size_t id = reader.GetAttributeValue<std::uint32_t>(u8"id");
+        reader.Read(); // <name>
+        reader.Read(); // Record n
+        std::string name;
+        reader.Read(name);
+        if(name != u8"Record " + std::to_string(id)) {
+          throw std::runtime_error(u8"Record was read incorrectly");
+        }
+        return id;
+      },
+      [&ids, &elementIndices](std::size_t elementIndex, std::size_t id) {
+        elementIndices.push_back(elementIndex);
+        ids.push_back(id);
+      },
+      4
+    );
+
+    ASSERT_EQ(ids.size(), 1000U);
+    for(std::size_t index = 0; index < ids.size(); ++index) {
+      EXPECT_EQ(ids[index], index);
+      EXPECT_EQ(elementIndices[index], index * 2 + 1); // each record has a name element
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, ParallelParsingWorksWithoutChildren) {
+    XmlDocumentIndex index(MakeMemoryBlob(makeRecordXml(0), false));
+
+    std::size_t mergeCount = 0;
+    index.ParseChildrenInParallel(
+      0,
+      [](XmlReader &) { return 0; },
+      [&mergeCount](std::size_t, int) { ++mergeCount; }
+    );
+    EXPECT_EQ(mergeCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, ParallelParsingReportsExceptions) {
+    XmlDocumentIndex index(MakeMemoryBlob(makeRecordXml(200), true));
+
+    std::size_t mergeCount = 0;
+    EXPECT_THROW(
+      index.ParseChildrenInParallel(
+        0,
+        [](XmlReader &reader) {
+          reader.Read();
+          std::size_t id = reader.GetAttributeValue<std::uint32_t>(u8"id");
+          if(id == 150) {
+            throw std::logic_error(u8"Simulated error");
+          }
+          return id;
+        },
+        [&mergeCount](std::size_t, std::size_t) { ++mergeCount; },
+        3
+      ),
+      std::logic_error
+    );
+    EXPECT_LE(mergeCount, 150U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlDocumentIndexTest, SectionsOutsideOfBlobAreRejected) {
+    std::shared_ptr<MemoryBlob> blob = MakeMemoryBlob(LevelXml, true);
+    EXPECT_THROW(XmlBlobReader reader(blob, 10, blob->GetSize()), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
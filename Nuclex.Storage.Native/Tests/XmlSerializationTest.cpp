@@ -0,0 +1,229 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlSerialization.h"
+#include "Nuclex/Storage/Xml/XmlBlobReader.h"
+#include "Nuclex/Storage/Xml/XmlBlobWriter.h"
+#include "Nuclex/Storage/Xml/BinaryXmlBlobReader.h"
+#include "Nuclex/Storage/Xml/BinaryXmlBlobWriter.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "MemoryBlobFactory.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Color used to test structures that are stored in attributes only</summary>
+  struct Color {
+    /// <summary>Intensity of the red channel</summary>
+    public: std::uint8_t R;
+    /// <summary>Intensity of the green channel</summary>
+    public: std::uint8_t G;
+    /// <summary>Intensity of the blue channel</summary>
+    public: std::uint8_t B;
+
+    /// <summary>Lists the fields that will be serialized</summary>
+    /// <returns>A tuple describing the serializable fields</returns>
+    public: static constexpr auto GetFields() {
+      return std::make_tuple(
+        NUCLEX_STORAGE_FIELD(Color, R),
+        NUCLEX_STORAGE_FIELD(Color, G),
+        NUCLEX_STORAGE_FIELD(Color, B)
+      );
+    }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Material used to test structures with all kinds of fields</summary>
+  struct Material {
+    /// <summary>Name of the material</summary>
+    public: std::string Name;
+    /// <summary>How glossy the material is</summary>
+    public: double Shininess;
+    /// <summary>Base color of the material</summary>
+    public: Color Diffuse;
+    /// <summary>Colors the material cycles through</summary>
+    public: std::vector<Color> Palette;
+    /// <summary>Blending weights of the material's layers</summary>
+    public: std::vector<float> Weights;
+    /// <summary>Offsets of the material's texture in pixels</summary>
+    public: std::int32_t Offsets[3];
+    /// <summary>Raw pixels of the material's texture</summary>
+    public: std::vector<std::uint8_t> Texture;
+
+    /// <summary>Lists the fields that will be serialized</summary>
+    /// <returns>A tuple describing the serializable fields</returns>
+    public: static constexpr auto GetFields() {
+      return std::make_tuple(
+        NUCLEX_STORAGE_FIELD(Material, Name),
+        NUCLEX_STORAGE_FIELD(Material, Shininess),
+        NUCLEX_STORAGE_FIELD(Material, Diffuse),
+        NUCLEX_STORAGE_FIELD(Material, Palette),
+        NUCLEX_STORAGE_FIELD(Material, Weights),
+        NUCLEX_STORAGE_FIELD(Material, Offsets),
+        NUCLEX_STORAGE_FIELD(Material, Texture)
+      );
+    }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a material with some distinctive values</summary>
+  /// <returns>The new material</returns>
+  Material makeMaterial() {
+    Material material;
+    material.Name = u8"Brick";
+    material.Shininess = 0.125;
+    material.Diffuse = Color { 200, 100, 50 };
+    material.Palette.push_back(Color { 1, 2, 3 });
+    material.Palette.push_back(Color { 4, 5, 6 });
+    material.Weights.push_back(0.5f);
+    material.Weights.push_back(0.25f);
+    material.Weights.push_back(0.25f);
+    material.Offsets[0] = -1;
+    material.Offsets[1] = 0;
+    material.Offsets[2] = 123456;
+    for(std::size_t index = 0; index < 300; ++index) {
+      material.Texture.push_back(static_cast<std::uint8_t>(index * 7 + 3));
+    }
+    return material;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether two materials hold the same values</summary>
+  /// <param name="expected">Material holding the values that are expected</param>
+  /// <param name="actual">Material whose values will be checked</param>
+  void expectEqual(const Material &expected, const Material &actual) {
+    EXPECT_EQ(actual.Name, expected.Name);
+    EXPECT_EQ(actual.Shininess, expected.Shininess);
+    EXPECT_EQ(actual.Diffuse.R, expected.Diffuse.R);
+    EXPECT_EQ(actual.Diffuse.G, expected.Diffuse.G);
+    EXPECT_EQ(actual.Diffuse.B, expected.Diffuse.B);
+    ASSERT_EQ(actual.Palette.size(), expected.Palette.size());
+    for(std::size_t index = 0; index < actual.Palette.size(); ++index) {
+      EXPECT_EQ(actual.Palette[index].R, expected.Palette[index].R);
+      EXPECT_EQ(actual.Palette[index].B, expected.Palette[index].B);
+    }
+    EXPECT_EQ(actual.Weights, expected.Weights);
+    for(std::size_t index = 0; index < 3; ++index) {
+      EXPECT_EQ(actual.Offsets[index], expected.Offsets[index]);
+    }
+    EXPECT_EQ(actual.Texture, expected.Texture);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlSerializationTest, StructuresRoundTripThroughXml) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      XmlBlobWriter writer(blob);
+      WriteElement(writer, u8"Material", makeMaterial());
+    }
+
+    std::string xml(static_cast<std::size_t>(blob->GetSize()), '\0');
+    blob->ReadAt(0, &xml[0], xml.size());
+    EXPECT_NE(xml.find(u8"Name=\"Brick\""), std::string::npos);
+    EXPECT_NE(xml.find(u8"<Diffuse"), std::string::npos);
+    EXPECT_NE(xml.find(u8"Count=\"300\""), std::string::npos);
+
+    XmlBlobReader reader(blob, 64); // Small chunks to split up the text
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+
+    Material material;
+    ReadElement(reader, material);
+    expectEqual(makeMaterial(), material);
+    EXPECT_EQ(reader.Read(), XmlReadEvent::End);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlSerializationTest, StructuresRoundTripThroughBinaryXml) {
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    {
+      BinaryXmlBlobWriter writer(blob);
+      WriteElement(writer, u8"Material", makeMaterial());
+    }
+
+    BinaryXmlBlobReader reader(blob);
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+
+    Material material;
+    ReadElement(reader, material);
+    expectEqual(makeMaterial(), material);
+    EXPECT_EQ(reader.Read(), XmlReadEvent::End);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlSerializationTest, MissingFieldsKeepTheirValues) {
+    XmlBlobReader reader(
+      MakeMemoryBlob(
+        u8"<Material Shininess=\"2.5\" Unknown=\"1\">"
+        u8"  <Extra><Diffuse R=\"9\" /></Extra>"
+        u8"  <Diffuse G=\"7\" />"
+        u8"  <Offsets><Item Value=\"11\" /></Offsets>"
+        u8"</Material>"
+      )
+    );
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+
+    Material material = makeMaterial();
+    ReadElement(reader, material);
+    EXPECT_EQ(reader.Read(), XmlReadEvent::End);
+
+    EXPECT_EQ(material.Name, std::string(u8"Brick"));
+    EXPECT_EQ(material.Shininess, 2.5);
+    EXPECT_EQ(material.Diffuse.R, 200U);
+    EXPECT_EQ(material.Diffuse.G, 7U);
+    EXPECT_EQ(material.Offsets[0], 11);
+    EXPECT_EQ(material.Offsets[2], 123456);
+    EXPECT_EQ(material.Texture.size(), 300U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlSerializationTest, TruncatedDocumentsAreReported) {
+    XmlBlobReader reader(MakeMemoryBlob(u8"<Material><Palette><Item R=\"1\">"));
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+
+    Material material;
+    EXPECT_ANY_THROW(ReadElement(reader, material));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
@@ -0,0 +1,213 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Xml/XmlStreamReader.h"
+#include "Nuclex/Storage/Xml/XmlParseError.h"
+#include "Nuclex/Storage/Binary/BlobInputStream.h"
+#include "Nuclex/Storage/Binary/MemoryPipe.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "MemoryBlobFactory.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds an XML document with a number of elements carrying attributes</summary>
+  /// <param name="elementCount">Number of elements the document will contain</param>
+  /// <returns>The XML document as plaintext</returns>
+  std::string makeXml(std::size_t elementCount) {
+    std::string xml(u8"<?xml version=\"1.0\"?><level>");
+    for(std::size_t index = 0; index < elementCount; ++index) {
+      xml.append(u8"<entity id=\"");
+      xml.append(std::to_string(index));
+      xml.append(u8"\" />");
+    }
+    xml.append(u8"</level>");
+    return xml;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Creates a stream reading the specified text from a memory blob</summary>
+  /// <param name="text">Text the stream will provide</param>
+  /// <returns>A stream providing the specified text</returns>
+  std::shared_ptr<Nuclex::Storage::Binary::InputStream> makeStream(const std::string &text) {
+    return std::make_shared<Nuclex::Storage::Binary::BlobInputStream>(
+      Nuclex::Storage::MakeMemoryBlob(text)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Writes a text into a memory pipe</summary>
+  /// <param name="pipe">Pipe the text will be written into</param>
+  /// <param name="text">Text that will be written into the pipe</param>
+  void writeToPipe(Nuclex::Storage::Binary::MemoryPipe &pipe, const std::string &text) {
+    std::size_t byteCount = text.size();
+    pipe.WriteUpTo(reinterpret_cast<const std::uint8_t *>(text.data()), byteCount, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads all elements from an XML document and collects their ids</summary>
+  /// <param name="reader">Reader that will be used to read the XML document</param>
+  /// <returns>The ids of all elements in the order they appeared</returns>
+  std::vector<std::string> collectIds(Nuclex::Storage::Xml::XmlStreamReader &reader) {
+    using Nuclex::Storage::Xml::XmlReadEvent;
+
+    std::vector<std::string> ids;
+    for(;;) {
+      XmlReadEvent readEvent = reader.Read();
+      if(readEvent == XmlReadEvent::End) {
+        break;
+      }
+      if(readEvent == XmlReadEvent::ElementStart) {
+        if(reader.TryEnterAttribute(u8"id")) {
+          std::string id;
+          reader.Read(id);
+          reader.LeaveAttribute();
+          ids.push_back(id);
+        }
+      }
+    }
+
+    return ids;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Xml {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlStreamReaderTest, ReadsElementsFromStream) {
+    XmlStreamReader reader(makeStream(makeXml(3)));
+
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), std::string(u8"level"));
+    ASSERT_EQ(reader.Read(), XmlReadEvent::ElementStart);
+    EXPECT_EQ(reader.GetElementName(), std::string(u8"entity"));
+    ASSERT_EQ(reader.CountAttributes(), 1U);
+    EXPECT_EQ(reader.GetAttributeName(0), std::string(u8"id"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlStreamReaderTest, ChunkSizeDoesNotAffectResults) {
+    std::string xml = makeXml(200);
+
+    XmlStreamReader referenceReader(makeStream(xml));
+    std::vector<std::string> referenceIds = collectIds(referenceReader);
+    ASSERT_EQ(referenceIds.size(), 200U);
+
+    const std::size_t chunkByteCounts[] = { 1, 7, 100, 1024 * 1024 };
+    for(std::size_t index = 0; index < sizeof(chunkByteCounts) / sizeof(std::size_t); ++index) {
+      XmlStreamReader reader(makeStream(xml), chunkByteCounts[index]);
+      EXPECT_EQ(collectIds(reader), referenceIds);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlStreamReaderTest, ParsesWhileDataIsStillArriving) {
+    std::shared_ptr<Binary::MemoryPipe> pipe = std::make_shared<Binary::MemoryPipe>();
+    std::promise<void> firstElementRead;
+    std::future<void> firstElementReadFuture = firstElementRead.get_future();
+
+    // Send the first half of the document, then hold back the rest until the reader
+    // has reported an element from it. A reader waiting for the whole document would
+    // never report that element and the writer would run into the timeout.
+    bool parsedEarly = false;
+    std::thread writer(
+      [&pipe, &firstElementReadFuture, &parsedEarly]() {
+        writeToPipe(*pipe, u8"<?xml version=\"1.0\"?><level><entity id=\"0\" />");
+        parsedEarly = (
+          firstElementReadFuture.wait_for(std::chrono::seconds(10)) == std::future_status::ready
+        );
+        writeToPipe(*pipe, u8"<entity id=\"1\" /></level>");
+        pipe->Close();
+      }
+    );
+
+    XmlStreamReader reader(pipe);
+    std::vector<std::string> ids;
+    for(;;) {
+      XmlReadEvent readEvent = reader.Read();
+      if(readEvent == XmlReadEvent::End) {
+        break;
+      }
+      if((readEvent == XmlReadEvent::ElementStart) && reader.TryEnterAttribute(u8"id")) {
+        std::string id;
+        reader.Read(id);
+        reader.LeaveAttribute();
+        ids.push_back(id);
+        if(ids.size() == 1) {
+          firstElementRead.set_value();
+        }
+      }
+    }
+    writer.join();
+
+    EXPECT_TRUE(parsedEarly);
+    ASSERT_EQ(ids.size(), 2U);
+    EXPECT_EQ(ids[0], std::string(u8"0"));
+    EXPECT_EQ(ids[1], std::string(u8"1"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlStreamReaderTest, TruncatedDocumentCausesParseError) {
+    XmlStreamReader reader(makeStream(u8"<level><entity id=\"0\" />"));
+    EXPECT_THROW(
+      for(;;) {
+        if(reader.Read() == XmlReadEvent::End) {
+          break;
+        }
+      },
+      XmlParseError
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XmlStreamReaderTest, CanBeResetToReadAnotherDocument) {
+    XmlStreamReader reader(makeStream(makeXml(3)));
+    EXPECT_EQ(collectIds(reader).size(), 3U);
+
+    reader.Reset(makeStream(makeXml(5)));
+    EXPECT_EQ(collectIds(reader).size(), 5U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Xml
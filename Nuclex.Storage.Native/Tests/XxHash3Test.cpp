@@ -0,0 +1,165 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_STORAGE_SOURCE 1
+
+#include "Nuclex/Storage/Checksums/XxHash3.h"
+#include "Nuclex/Storage/MemoryBlob.h"
+#include "Nuclex/Storage/Binary/BlobInputStream.h"
+#include "RandomDataFactory.h"
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Input length and the hash the reference implementation produces for it</summary>
+  struct ReferenceHash {
+
+    /// <summary>Number of bytes of the test data that are hashed</summary>
+    public: std::size_t ByteCount;
+    /// <summary>Hash the reference implementation calculated</summary>
+    public: std::uint64_t Hash;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hashes of the test data calculated with the reference implementation</summary>
+  /// <remarks>
+  ///   The lengths cover each of the different code paths and their boundaries.
+  /// </remarks>
+  const ReferenceHash ReferenceHashes[] = {
+      { 0, 0x2D06800538D394C2ULL },
+      { 1, 0xE5E62017E96F839CULL },
+      { 2, 0xBD589D6166A2F829ULL },
+      { 3, 0x5509B3F417CEB73FULL },
+      { 4, 0xFC9110D41D606C37ULL },
+      { 5, 0x71BF0DE0407B1B7EULL },
+      { 8, 0x8C4D213D245800E7ULL },
+      { 9, 0xC9FF729677522DCCULL },
+      { 15, 0xD46EE73DC0D9D256ULL },
+      { 16, 0x0A2C4F68AD632D4DULL },
+      { 17, 0x614A7C810EB2ADEAULL },
+      { 31, 0x74D1D924394B5A7EULL },
+      { 32, 0x52DC23A6EBCB0CF4ULL },
+      { 33, 0x5A67BD92617B69CDULL },
+      { 64, 0xB017DA442290C3EBULL },
+      { 65, 0x7B2022246E32A038ULL },
+      { 96, 0x14948E6BF7E5D86EULL },
+      { 97, 0xA67D1E95CECD6ED4ULL },
+      { 128, 0x75B4AD3371B8388AULL },
+      { 129, 0x34CCD5C84FA978BDULL },
+      { 200, 0x52DAA117A71923BEULL },
+      { 240, 0x1ADF3E127C34D5EBULL },
+      { 241, 0x6058190F4A8DF8FBULL },
+      { 256, 0x5665EF39D2EC7985ULL },
+      { 500, 0xE320C9E688886E3EULL },
+      { 1023, 0x7678C79F9D42B5E2ULL },
+      { 1024, 0xE717BC965B2ABA43ULL },
+      { 1025, 0xBBAB3D50194BC42DULL },
+      { 2048, 0x1AFDF18703050A58ULL },
+      { 2049, 0x5AC388A1C608020DULL },
+      { 5000, 0x04B62DC620C195F9ULL }
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Storage { namespace Checksums {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XxHash3Test, ReferenceHashesAreReproduced) {
+    std::vector<std::uint8_t> data = MakeRandomData(5000, 12345);
+    for(std::size_t index = 0; index < sizeof(ReferenceHashes) / sizeof(ReferenceHash); ++index) {
+      const ReferenceHash &reference = ReferenceHashes[index];
+      EXPECT_EQ(reference.Hash, XxHash3::Compute(data.data(), reference.ByteCount)) <<
+        "Hash of " << reference.ByteCount << " bytes matches the reference implementation";
+    }
+
+    EXPECT_EQ(0xE34615AADE2E6333ULL, XxHash3::Compute(u8"Hello World", 11));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XxHash3Test, IncrementalHashesMatchOneShotHashes) {
+    std::vector<std::uint8_t> data = MakeRandomData(5000, 12345);
+
+    // Pieces of many different sizes, including ones larger than the internal buffer
+    const std::size_t pieceByteCounts[] = { 1, 7, 63, 64, 65, 200, 256, 257, 1500 };
+    for(std::size_t index = 0; index < sizeof(ReferenceHashes) / sizeof(ReferenceHash); ++index) {
+      const ReferenceHash &reference = ReferenceHashes[index];
+      for(std::size_t piece = 0; piece < sizeof(pieceByteCounts) / sizeof(std::size_t); ++piece) {
+        XxHash3 xxHash3;
+        std::size_t offset = 0;
+        while(offset < reference.ByteCount) {
+          std::size_t byteCount = pieceByteCounts[piece];
+          if(byteCount > reference.ByteCount - offset) {
+            byteCount = reference.ByteCount - offset;
+          }
+          xxHash3.Update(data.data() + offset, byteCount);
+          offset += byteCount;
+        }
+        EXPECT_EQ(reference.Hash, xxHash3.GetValue()) <<
+          "Hash of " << reference.ByteCount << " bytes added in pieces of " <<
+          pieceByteCounts[piece] << " bytes matches the reference implementation";
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XxHash3Test, HashingCanContinueAfterValueIsQueried) {
+    std::vector<std::uint8_t> data = MakeRandomData(3000, 1);
+
+    XxHash3 xxHash3;
+    xxHash3.Update(data.data(), 1000);
+    EXPECT_EQ(XxHash3::Compute(data.data(), 1000), xxHash3.GetValue());
+    xxHash3.Update(data.data() + 1000, 2000);
+    EXPECT_EQ(XxHash3::Compute(data.data(), 3000), xxHash3.GetValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(XxHash3Test, BlobsAndStreamsCanBeHashed) {
+    std::vector<std::uint8_t> data = MakeRandomData(300000, 77);
+    std::uint64_t expected = XxHash3::Compute(data.data(), data.size());
+
+    std::shared_ptr<MemoryBlob> blob = std::make_shared<MemoryBlob>();
+    blob->WriteAt(0, data.data(), data.size());
+    EXPECT_EQ(expected, XxHash3::Compute(*blob));
+
+    blob->Seal();
+    Binary::BlobInputStream stream(blob);
+    XxHash3 xxHash3;
+    xxHash3.Update(stream);
+    EXPECT_EQ(expected, xxHash3.GetValue());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Storage::Checksums
@@ -0,0 +1,215 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "BenchmarkRunner.h"
+
+#include <cstdio> // for std::fopen(), std::fprintf()
+#include <map> // for std::map
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Closes a C file when it goes out of scope</summary>
+  class FileScope {
+
+    /// <summary>Initializes a new file closer</summary>
+    /// <param name="file">File that will be closed</param>
+    public: FileScope(std::FILE *file) :
+      file(file) {}
+
+    /// <summary>Closes the file</summary>
+    public: ~FileScope() {
+      std::fclose(this->file);
+    }
+
+    /// <summary>File that will be closed</summary>
+    private: std::FILE *file;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates how long a single operation of a measurement took</summary>
+  /// <param name="seconds">Time all operations of one run took in seconds</param>
+  /// <param name="operationCount">Number of operations performed in one run</param>
+  /// <returns>The time one operation took in nanoseconds</returns>
+  double getNanosecondsPerOperation(double seconds, std::size_t operationCount) {
+    if(operationCount == 0) {
+      return seconds * 1000000000.0;
+    } else {
+      return seconds * 1000000000.0 / static_cast<double>(operationCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a throughput in millions of units per second</summary>
+  /// <param name="file">File the throughput will be printed into</param>
+  /// <param name="count">Number of units processed in the measured time</param>
+  /// <param name="seconds">Time the units took to process</param>
+  /// <remarks>
+  ///   Measurements that don't process any bytes (like emitting an event) report
+  ///   a count of zero and get a dash instead of a throughput.
+  /// </remarks>
+  void printThroughput(std::FILE *file, std::size_t count, double seconds) {
+    if((count == 0) || (seconds <= 0.0)) {
+      std::fprintf(file, u8" %12s", u8"-");
+    } else {
+      std::fprintf(file, u8" %12.2f", static_cast<double>(count) / seconds / 1000000.0);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  BenchmarkRunner::BenchmarkRunner(double minimumSeconds, const std::string &filter) :
+    minimumSeconds(minimumSeconds),
+    filter(filter),
+    results() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool BenchmarkRunner::IsSelected(const std::string &name) const {
+    return this->filter.empty() || (name.find(this->filter) != std::string::npos);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BenchmarkRunner::Record(const BenchmarkResult &result) {
+    this->results.push_back(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BenchmarkRunner::PrintResults(std::FILE *file) const {
+    std::fprintf(
+      file, u8"\n%-56s %12s %12s %12s\n", u8"Benchmark", u8"ns/op", u8"Mop/s", u8"MB/s"
+    );
+    for(std::size_t index = 0; index < this->results.size(); ++index) {
+      const BenchmarkResult &result = this->results[index];
+      std::fprintf(
+        file, u8"%-56s %12.2f",
+        result.Name.c_str(), getNanosecondsPerOperation(result.Seconds, result.OperationCount)
+      );
+      printThroughput(file, result.OperationCount, result.Seconds);
+      printThroughput(file, result.ByteCount, result.Seconds);
+      std::fprintf(file, u8"\n");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BenchmarkRunner::SaveResults(const std::string &path) const {
+    std::FILE *file = std::fopen(path.c_str(), u8"w");
+    if(file == nullptr) {
+      throw std::runtime_error(u8"Could not open file to save benchmark results in");
+    }
+    FileScope fileScope(file);
+
+    // One measurement per line, name and times separated by tabs. Names never
+    // contain tabs, so this is trivial to read back and to diff by hand.
+    for(std::size_t index = 0; index < this->results.size(); ++index) {
+      const BenchmarkResult &result = this->results[index];
+      std::fprintf(
+        file, u8"%s\t%.9f\t%.3f\n",
+        result.Name.c_str(),
+        result.Seconds,
+        getNanosecondsPerOperation(result.Seconds, result.OperationCount)
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t BenchmarkRunner::CompareToBaseline(
+    const std::string &path, double tolerance, std::FILE *file
+  ) const {
+    std::map<std::string, double> baseline;
+    {
+      std::FILE *baselineFile = std::fopen(path.c_str(), u8"r");
+      if(baselineFile == nullptr) {
+        throw std::runtime_error(u8"Could not open file with baseline benchmark results");
+      }
+      FileScope baselineFileScope(baselineFile);
+
+      char line[256];
+      while(std::fgets(line, sizeof(line), baselineFile) != nullptr) {
+        std::string entry(line);
+        std::string::size_type tabIndex = entry.find('\t');
+        if(tabIndex != std::string::npos) {
+          baseline[entry.substr(0, tabIndex)] = std::stod(entry.substr(tabIndex + 1));
+        }
+      }
+    }
+
+    std::fprintf(
+      file, u8"\n%-56s %12s %12s %9s\n", u8"Benchmark", u8"baseline ns", u8"ns", u8"change"
+    );
+
+    std::size_t regressionCount = 0;
+    for(std::size_t index = 0; index < this->results.size(); ++index) {
+      const BenchmarkResult &result = this->results[index];
+
+      std::map<std::string, double>::const_iterator baselineEntry = baseline.find(result.Name);
+      if((baselineEntry == baseline.end()) || (baselineEntry->second <= 0.0)) {
+        continue;
+      }
+
+      double change = (result.Seconds / baselineEntry->second) - 1.0;
+      bool isRegression = (change > tolerance);
+      if(isRegression) {
+        ++regressionCount;
+      }
+
+      std::fprintf(
+        file, u8"%-56s %12.2f %12.2f %+8.1f%%%s\n",
+        result.Name.c_str(),
+        getNanosecondsPerOperation(baselineEntry->second, result.OperationCount),
+        getNanosecondsPerOperation(result.Seconds, result.OperationCount),
+        change * 100.0,
+        isRegression ? u8"  REGRESSION" : u8""
+      );
+    }
+
+    return regressionCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void BenchmarkRunner::addResult(const BenchmarkResult &result) {
+    std::fprintf(stdout, u8"  %s\n", result.Name.c_str());
+    std::fflush(stdout);
+
+    Record(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
@@ -0,0 +1,182 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_BENCHMARKS_BENCHMARKRUNNER_H
+#define NUCLEX_SUPPORT_BENCHMARKS_BENCHMARKRUNNER_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <chrono> // for std::chrono::steady_clock
+#include <cstddef> // for std::size_t
+#include <cstdio> // for std::FILE
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Outcome of measuring one operation</summary>
+  struct BenchmarkResult {
+
+    /// <summary>Unique name of the measurement, used to match it up with a baseline</summary>
+    public: std::string Name;
+    /// <summary>Fastest time one run of the operation took in seconds</summary>
+    public: double Seconds;
+    /// <summary>Number of times the operation was repeated in each run</summary>
+    public: std::size_t OperationCount;
+    /// <summary>Number of bytes the operation processed in each run</summary>
+    public: std::size_t ByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Repeats operations until their timing is reliable and collects the results</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each operation is run once to warm up caches, then repeated until a minimum amount
+  ///     of time has passed. The fastest run is reported since it's the least disturbed by
+  ///     other processes, which keeps the numbers comparable between runs on the same machine.
+  ///   </para>
+  ///   <para>
+  ///     Many primitives take nanoseconds, so a measured operation should loop over
+  ///     the primitive many times and report that count as its operation count.
+  ///   </para>
+  ///   <para>
+  ///     The Nuclex.Storage benchmarks compile this runner in as well, so both libraries
+  ///     share one result format and one baseline comparison.
+  ///   </para>
+  /// </remarks>
+  class BenchmarkRunner {
+
+    /// <summary>Initializes a new benchmark runner</summary>
+    /// <param name="minimumSeconds">Minimum time each operation is repeated for</param>
+    /// <param name="filter">Only measurements whose name contains this are run</param>
+    public: BenchmarkRunner(double minimumSeconds, const std::string &filter);
+
+    /// <summary>Checks whether a measurement would be run</summary>
+    /// <param name="name">Name of the measurement that will be checked</param>
+    /// <returns>True if the measurement's name passes the filter</returns>
+    public: bool IsSelected(const std::string &name) const;
+
+    /// <summary>Measures how long an operation takes</summary>
+    /// <typeparam name="TOperation">Type of the operation that will be measured</typeparam>
+    /// <param name="name">Unique name under which the result will be recorded</param>
+    /// <param name="operationCount">Number of operations performed in each run</param>
+    /// <param name="byteCount">Number of bytes processed in each run</param>
+    /// <param name="operation">Operation that will be measured</param>
+    public: template<typename TOperation>
+    void Measure(
+      const std::string &name, std::size_t operationCount, std::size_t byteCount,
+      TOperation &&operation
+    );
+
+    /// <summary>Records a result that was measured outside of the runner</summary>
+    /// <param name="result">Result that will be recorded</param>
+    /// <remarks>
+    ///   For operations that can't be measured in-process, for example because they run
+    ///   in a child process to isolate their memory use. The result is saved and compared
+    ///   against the baseline like any other.
+    /// </remarks>
+    public: void Record(const BenchmarkResult &result);
+
+    /// <summary>Prints the results of all measurements as a table</summary>
+    /// <param name="file">File the table will be printed into, usually stdout</param>
+    public: void PrintResults(std::FILE *file) const;
+
+    /// <summary>Saves the results so a later run can be compared against them</summary>
+    /// <param name="path">Path of the file the results will be written to</param>
+    /// <remarks>
+    ///   The file has one line per measurement holding its name, the time of one run
+    ///   in seconds and the time of one operation in nanoseconds, separated by tabs.
+    ///   The Pixels benchmarks write their results the same way, so one script can
+    ///   collect the results of all of them for trend charts.
+    /// </remarks>
+    public: void SaveResults(const std::string &path) const;
+
+    /// <summary>Compares the results against those saved by an earlier run</summary>
+    /// <param name="path">Path of a file written by <see cref="SaveResults" /></param>
+    /// <param name="tolerance">
+    ///   Fraction by which a measurement may be slower than its baseline before it
+    ///   is reported as regression
+    /// </param>
+    /// <param name="file">File the comparison will be printed into, usually stdout</param>
+    /// <returns>The number of measurements that regressed</returns>
+    public: std::size_t CompareToBaseline(
+      const std::string &path, double tolerance, std::FILE *file
+    ) const;
+
+    /// <summary>Records a result and prints it as progress indicator</summary>
+    /// <param name="result">Result that will be recorded</param>
+    private: void addResult(const BenchmarkResult &result);
+
+    /// <summary>Minimum time in seconds each operation is repeated for</summary>
+    private: double minimumSeconds;
+    /// <summary>Text that has to appear in the names of measurements that are run</summary>
+    private: std::string filter;
+    /// <summary>Results of all measurements taken so far</summary>
+    private: std::vector<BenchmarkResult> results;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TOperation>
+  void BenchmarkRunner::Measure(
+    const std::string &name, std::size_t operationCount, std::size_t byteCount,
+    TOperation &&operation
+  ) {
+    typedef std::chrono::steady_clock Clock;
+
+    if(!IsSelected(name)) {
+      return;
+    }
+
+    operation(); // Warm up caches and let the allocator settle
+
+    double fastestRun = 0.0;
+    double totalTime = 0.0;
+    std::size_t runCount = 0;
+    while((runCount < 3) || (totalTime < this->minimumSeconds)) {
+      Clock::time_point start = Clock::now();
+      operation();
+      double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+      if((runCount == 0) || (elapsed < fastestRun)) {
+        fastestRun = elapsed;
+      }
+      totalTime += elapsed;
+      ++runCount;
+    }
+
+    BenchmarkResult result;
+    result.Name = name;
+    result.Seconds = fastestRun;
+    result.OperationCount = operationCount;
+    result.ByteCount = byteCount;
+    addResult(result);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
+
+#endif // NUCLEX_SUPPORT_BENCHMARKS_BENCHMARKRUNNER_H
@@ -0,0 +1,207 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "CollectionBenchmark.h"
+#include "BenchmarkRunner.h"
+
+#include "Nuclex/Support/Collections/ConcurrentBoundedQueue.h"
+#include "Nuclex/Support/Collections/ShiftBuffer.h"
+
+#include <condition_variable> // for std::condition_variable
+#include <cstdint> // for std::uint8_t
+#include <cstring> // for std::memcpy()
+#include <deque> // for std::deque
+#include <mutex> // for std::mutex
+#include <string> // for std::string, std::to_string()
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of items each producer thread pushes through the queue per run</summary>
+  const std::size_t ItemsPerProducer = 200000;
+
+  /// <summary>Number of items written to and read from the shift buffer per run</summary>
+  const std::size_t ShiftBufferItemCount = 1048576;
+
+  /// <summary>Capacity of the queues being measured</summary>
+  const std::size_t QueueCapacity = 1024;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Bounded queue built from a std::deque and a mutex as a baseline</summary>
+  class MutexDequeQueue {
+
+    /// <summary>Initializes a new mutex-protected queue</summary>
+    /// <param name="capacity">Maximum number of items the queue can hold</param>
+    public: MutexDequeQueue(std::size_t capacity) :
+      capacity(capacity) {}
+
+    /// <summary>Appends an item to the queue, waiting for space if needed</summary>
+    /// <param name="item">Item that will be appended</param>
+    public: void Enqueue(std::size_t item) {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      while(this->items.size() >= this->capacity) {
+        this->spaceFreed.wait(lock);
+      }
+      this->items.push_back(item);
+      this->itemAdded.notify_one();
+    }
+
+    /// <summary>Takes the oldest item out of the queue, waiting for one if needed</summary>
+    /// <param name="item">Receives the item taken from the queue</param>
+    public: void Dequeue(std::size_t &item) {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      while(this->items.empty()) {
+        this->itemAdded.wait(lock);
+      }
+      item = this->items.front();
+      this->items.pop_front();
+      this->spaceFreed.notify_one();
+    }
+
+    /// <summary>Maximum number of items the queue can hold</summary>
+    private: std::size_t capacity;
+    /// <summary>Items currently stored in the queue</summary>
+    private: std::deque<std::size_t> items;
+    /// <summary>Protects the items and the condition variables</summary>
+    private: std::mutex mutex;
+    /// <summary>Signalled when an item has been added</summary>
+    private: std::condition_variable itemAdded;
+    /// <summary>Signalled when an item has been taken</summary>
+    private: std::condition_variable spaceFreed;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Pushes items from producer threads through a queue to consumer threads</summary>
+  /// <typeparam name="TQueue">Type of queue that will be measured</typeparam>
+  /// <param name="threadCount">Number of producer and of consumer threads</param>
+  template<typename TQueue>
+  void passItemsThroughQueue(std::size_t threadCount) {
+    TQueue queue(QueueCapacity);
+    {
+      std::vector<std::thread> threads;
+      for(std::size_t thread = 0; thread < threadCount; ++thread) {
+        threads.emplace_back(
+          [&queue]() {
+            for(std::size_t index = 0; index < ItemsPerProducer; ++index) {
+              queue.Enqueue(index);
+            }
+          }
+        );
+        threads.emplace_back(
+          [&queue]() {
+            std::size_t item;
+            for(std::size_t index = 0; index < ItemsPerProducer; ++index) {
+              queue.Dequeue(item);
+            }
+          }
+        );
+      }
+      for(std::size_t index = 0; index < threads.size(); ++index) {
+        threads[index].join();
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures writing to and reading from a shift buffer in chunks</summary>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="chunkSize">Number of bytes written and read at once</param>
+  void measureShiftBuffer(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner, std::size_t chunkSize
+  ) {
+    using Nuclex::Support::Collections::ShiftBuffer;
+
+    std::vector<std::uint8_t> chunk(chunkSize, std::uint8_t(0x55));
+    std::vector<std::uint8_t> received(chunkSize);
+    std::size_t chunkCount = ShiftBufferItemCount / chunkSize;
+    std::string suffix = u8"/" + std::to_string(chunkSize) + u8" byte chunks";
+
+    // Writes two chunks, then reads one, so the buffer keeps shifting its contents
+    // back to the front the way it does when a consumer lags behind its producer
+    runner.Measure(
+      u8"Collections/ShiftBuffer/Write+Read" + suffix, chunkCount, chunkCount * chunkSize,
+      [&chunk, &received, chunkSize, chunkCount]() {
+        ShiftBuffer<std::uint8_t> buffer(chunkSize * 4);
+        for(std::size_t index = 0; index < chunkCount; index += 2) {
+          buffer.Write(chunk.data(), chunkSize);
+          buffer.Write(chunk.data(), chunkSize);
+          buffer.Read(received.data(), chunkSize);
+          buffer.Read(received.data(), chunkSize);
+        }
+      }
+    );
+    runner.Measure(
+      u8"Collections/ShiftBuffer/Reserve+Skip" + suffix, chunkCount, chunkCount * chunkSize,
+      [&chunk, chunkSize, chunkCount]() {
+        ShiftBuffer<std::uint8_t> buffer(chunkSize * 4);
+        for(std::size_t index = 0; index < chunkCount; ++index) {
+          std::memcpy(buffer.Reserve(chunkSize), chunk.data(), chunkSize);
+          buffer.Commit(chunkSize);
+          buffer.Skip(chunkSize);
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RunCollectionBenchmark(BenchmarkRunner &runner) {
+    measureShiftBuffer(runner, 16);
+    measureShiftBuffer(runner, 4096);
+
+    const std::size_t threadCounts[] = { 1, 2, 4, 8 };
+    for(std::size_t threadCount : threadCounts) {
+      std::string suffix = (
+        u8"/" + std::to_string(threadCount) + u8"+" + std::to_string(threadCount) + u8" threads"
+      );
+      std::size_t itemCount = ItemsPerProducer * threadCount;
+
+      runner.Measure(
+        u8"Collections/std::deque+mutex" + suffix, itemCount, 0,
+        [threadCount]() { passItemsThroughQueue<MutexDequeQueue>(threadCount); }
+      );
+      runner.Measure(
+        u8"Collections/ConcurrentBoundedQueue" + suffix, itemCount, 0,
+        [threadCount]() {
+          passItemsThroughQueue<Collections::ConcurrentBoundedQueue<std::size_t>>(threadCount);
+        }
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
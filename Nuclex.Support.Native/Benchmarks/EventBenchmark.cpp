@@ -0,0 +1,151 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "EventBenchmark.h"
+#include "BenchmarkRunner.h"
+
+#include "Nuclex/Support/Events/Event.h"
+
+#include <string> // for std::string, std::to_string()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of times an operation is repeated within one timed run</summary>
+  const std::size_t RepetitionsPerRun = 100000;
+
+  /// <summary>Built-in subscriber count large enough for every measured event</summary>
+  const std::size_t LargeBuiltInSubscriberCount = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Subscriber that does just enough work not to be optimized away</summary>
+  class Counter {
+
+    /// <summary>Initializes a new counter</summary>
+    public: Counter() :
+      Value(0) {}
+
+    /// <summary>Adds a value to the counter</summary>
+    /// <param name="value">Value that will be added</param>
+    public: void Add(int value) {
+      this->Value += static_cast<std::size_t>(value);
+    }
+
+    /// <summary>Sum of all values that have been added</summary>
+    public: std::size_t Value;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures how long emitting an event takes</summary>
+  /// <typeparam name="TEvent">Type of event that will be measured</typeparam>
+  /// <param name="runner">Runner that will perform and record the measurement</param>
+  /// <param name="name">Name under which the measurement will be recorded</param>
+  /// <param name="subscriberCount">Number of subscribers the event will have</param>
+  template<typename TEvent>
+  void measureEmission(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const std::string &name, std::size_t subscriberCount
+  ) {
+    Counter counters[LargeBuiltInSubscriberCount];
+    TEvent event;
+    for(std::size_t index = 0; index < subscriberCount; ++index) {
+      event.template Subscribe<Counter, &Counter::Add>(&counters[index]);
+    }
+
+    runner.Measure(
+      name, RepetitionsPerRun, 0,
+      [&event]() {
+        for(std::size_t index = 0; index < RepetitionsPerRun; ++index) {
+          event.Emit(static_cast<int>(index));
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures how long setting up and tearing down an event takes</summary>
+  /// <typeparam name="TEvent">Type of event that will be measured</typeparam>
+  /// <param name="runner">Runner that will perform and record the measurement</param>
+  /// <param name="name">Name under which the measurement will be recorded</param>
+  /// <param name="subscriberCount">Number of subscribers that will be subscribed</param>
+  /// <remarks>
+  ///   Each operation constructs an event, subscribes all subscribers, unsubscribes
+  ///   them again and destroys the event.
+  /// </remarks>
+  template<typename TEvent>
+  void measureSubscription(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const std::string &name, std::size_t subscriberCount
+  ) {
+    Counter counters[LargeBuiltInSubscriberCount];
+
+    runner.Measure(
+      name, RepetitionsPerRun, 0,
+      [&counters, subscriberCount]() {
+        for(std::size_t index = 0; index < RepetitionsPerRun; ++index) {
+          TEvent event;
+          for(std::size_t subscriber = 0; subscriber < subscriberCount; ++subscriber) {
+            event.template Subscribe<Counter, &Counter::Add>(&counters[subscriber]);
+          }
+          for(std::size_t subscriber = subscriberCount; subscriber > 0; --subscriber) {
+            event.template Unsubscribe<Counter, &Counter::Add>(&counters[subscriber - 1]);
+          }
+        }
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RunEventBenchmark(BenchmarkRunner &runner) {
+    typedef Events::Event<void(int)> DefaultEvent;
+    typedef Events::Event<void(int), LargeBuiltInSubscriberCount> LargeEvent;
+
+    const std::size_t subscriberCounts[] = { 1, 2, 3, 4, 6, 8, 12, 16 };
+    for(std::size_t subscriberCount : subscriberCounts) {
+      std::string suffix = u8"/" + std::to_string(subscriberCount) + u8" subscribers";
+      measureEmission<DefaultEvent>(runner, u8"Event/Emit/2 built-in" + suffix, subscriberCount);
+      measureEmission<LargeEvent>(runner, u8"Event/Emit/16 built-in" + suffix, subscriberCount);
+      measureSubscription<DefaultEvent>(
+        runner, u8"Event/Setup/2 built-in" + suffix, subscriberCount
+      );
+      measureSubscription<LargeEvent>(
+        runner, u8"Event/Setup/16 built-in" + suffix, subscriberCount
+      );
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
@@ -0,0 +1,46 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_BENCHMARKS_EVENTBENCHMARK_H
+#define NUCLEX_SUPPORT_BENCHMARKS_EVENTBENCHMARK_H
+
+#include "Nuclex/Support/Config.h"
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class BenchmarkRunner;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures emission and subscription costs of events</summary>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <remarks>
+  ///   Compares events with the default built-in subscriber count against events large
+  ///   enough to hold all subscribers inline, for 1 to 16 subscribers.
+  /// </remarks>
+  void RunEventBenchmark(BenchmarkRunner &runner);
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
+
+#endif // NUCLEX_SUPPORT_BENCHMARKS_EVENTBENCHMARK_H
@@ -0,0 +1,133 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "BenchmarkRunner.h"
+#include "CollectionBenchmark.h"
+#include "EventBenchmark.h"
+#include "ServiceBenchmark.h"
+#include "TextBenchmark.h"
+
+#include <cstdio> // for std::printf()
+#include <cstdlib> // for std::atof()
+#include <cstring> // for std::strlen(), std::strncmp()
+#include <exception> // for std::exception
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a command line argument is an option and extracts its value</summary>
+  /// <param name="argument">Command line argument that will be checked</param>
+  /// <param name="option">Option including the equals sign, i.e. "--save="</param>
+  /// <param name="value">Receives the value of the option if the argument is the option</param>
+  /// <returns>True if the argument was the specified option</returns>
+  bool tryGetOption(const char *argument, const char *option, std::string &value) {
+    std::size_t optionLength = std::strlen(option);
+    if(std::strncmp(argument, option, optionLength) != 0) {
+      return false;
+    }
+
+    value.assign(argument + optionLength);
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints the command line options of the benchmark executable</summary>
+  void printUsage() {
+    std::printf(
+      u8"Measures the primitives of Nuclex.Support (text, events, collections, services)\n"
+      u8"\n"
+      u8"Options:\n"
+      u8"  --filter=<text>       Only run benchmarks whose name contains the text\n"
+      u8"                        (for example Text/ or Event/Emit)\n"
+      u8"  --min-time=<seconds>  Minimum time to repeat each benchmark for (default 0.5)\n"
+      u8"  --save=<path>         Save the results for later comparison\n"
+      u8"  --baseline=<path>     Compare against results saved by an earlier run\n"
+      u8"  --tolerance=<percent> Slowdown above which a result counts as regression\n"
+      u8"                        (default 10)\n"
+      u8"\n"
+      u8"Exits with 1 if any benchmark regressed compared to the baseline.\n"
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+int main(int argumentCount, char *arguments[]) {
+  std::string filter;
+  double minimumSeconds = 0.5;
+  std::string savePath;
+  std::string baselinePath;
+  double tolerancePercent = 10.0;
+
+  for(int index = 1; index < argumentCount; ++index) {
+    std::string value;
+    if(tryGetOption(arguments[index], u8"--filter=", value)) {
+      filter = value;
+    } else if(tryGetOption(arguments[index], u8"--min-time=", value)) {
+      minimumSeconds = std::atof(value.c_str());
+    } else if(tryGetOption(arguments[index], u8"--save=", value)) {
+      savePath = value;
+    } else if(tryGetOption(arguments[index], u8"--baseline=", value)) {
+      baselinePath = value;
+    } else if(tryGetOption(arguments[index], u8"--tolerance=", value)) {
+      tolerancePercent = std::atof(value.c_str());
+    } else {
+      printUsage();
+      return 2;
+    }
+  }
+
+  try {
+    Nuclex::Support::Benchmarks::BenchmarkRunner runner(minimumSeconds, filter);
+
+    Nuclex::Support::Benchmarks::RunTextBenchmark(runner);
+    Nuclex::Support::Benchmarks::RunEventBenchmark(runner);
+    Nuclex::Support::Benchmarks::RunCollectionBenchmark(runner);
+    Nuclex::Support::Benchmarks::RunServiceBenchmark(runner);
+
+    runner.PrintResults(stdout);
+
+    if(!savePath.empty()) {
+      runner.SaveResults(savePath);
+    }
+    if(!baselinePath.empty()) {
+      std::size_t regressionCount = runner.CompareToBaseline(
+        baselinePath, tolerancePercent / 100.0, stdout
+      );
+      if(regressionCount > 0) {
+        std::printf(u8"\n%u benchmark(s) regressed\n", static_cast<unsigned>(regressionCount));
+        return 1;
+      }
+    }
+  }
+  catch(const std::exception &error) {
+    std::fprintf(stderr, u8"Benchmark failed: %s\n", error.what());
+    return 2;
+  }
+
+  return 0;
+}
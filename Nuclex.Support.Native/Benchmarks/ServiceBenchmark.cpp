@@ -0,0 +1,138 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "ServiceBenchmark.h"
+#include "BenchmarkRunner.h"
+
+#include "Nuclex/Support/Services/LazyServiceInjector.h"
+#include "Nuclex/Support/Services/ServiceContainer.h"
+#include "Nuclex/Support/Services/ServiceHandle.h"
+
+#include <memory> // for std::shared_ptr, std::make_shared()
+#include <string> // for std::string
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of lookups performed in each timed run</summary>
+  const std::size_t LookupsPerRun = 100000;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives results so the compiler can not optimize the measured work away</summary>
+  volatile std::size_t sink;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Example service that is looked up by the benchmarks</summary>
+  class ClockService {
+
+    /// <summary>Frees all resources owned by the service</summary>
+    public: virtual ~ClockService() = default;
+
+    /// <summary>Returns the number of ticks elapsed</summary>
+    /// <returns>The number of ticks that have elapsed</returns>
+    public: virtual std::size_t GetTicks() const = 0;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Clock that is always stopped</summary>
+  class StoppedClock : public ClockService {
+
+    /// <summary>Returns the number of ticks elapsed</summary>
+    /// <returns>The number of ticks that have elapsed</returns>
+    public: std::size_t GetTicks() const override { return 1; }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Unrelated service registered so lookups have more than one entry to search</summary>
+  class LoggerService {};
+
+  /// <summary>Another unrelated service</summary>
+  class SettingsService {};
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up a service repeatedly through a service provider</summary>
+  /// <param name="runner">Runner that will perform and record the measurement</param>
+  /// <param name="name">Name under which the measurement will be recorded</param>
+  /// <param name="provider">Service provider the service will be looked up from</param>
+  void measureGet(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const std::string &name, const Nuclex::Support::Services::ServiceProvider &provider
+  ) {
+    runner.Measure(
+      name, LookupsPerRun, 0,
+      [&provider]() {
+        std::size_t total = 0;
+        for(std::size_t index = 0; index < LookupsPerRun; ++index) {
+          total += provider.Get<ClockService>()->GetTicks();
+        }
+        sink = total;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RunServiceBenchmark(BenchmarkRunner &runner) {
+    Services::ServiceContainer container;
+    container.Add<LoggerService>(std::make_shared<LoggerService>());
+    container.Add<SettingsService>(std::make_shared<SettingsService>());
+    container.Add<ClockService>(std::make_shared<StoppedClock>());
+    measureGet(runner, u8"Services/ServiceContainer/Get", container);
+
+    // A service handle caches the service and only repeats the lookup if the provider
+    // reports that its services have changed, which is what this measurement covers
+    Services::ServiceHandle<ClockService> handle(container);
+    runner.Measure(
+      u8"Services/ServiceHandle/Get", LookupsPerRun, 0,
+      [&handle]() {
+        std::size_t total = 0;
+        for(std::size_t index = 0; index < LookupsPerRun; ++index) {
+          total += handle.Get()->GetTicks();
+        }
+        sink = total;
+      }
+    );
+
+    Services::LazyServiceInjector injector;
+    injector.Bind<ClockService>().To<StoppedClock>();
+    injector.Get<ClockService>(); // Create the service so only the lookup is measured
+    measureGet(runner, u8"Services/LazyServiceInjector/Get", injector);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
@@ -0,0 +1,273 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "TextBenchmark.h"
+#include "BenchmarkRunner.h"
+
+#include "Nuclex/Support/Text/Lexical.h"
+#include "Nuclex/Support/Text/StringConverter.h"
+#include "Nuclex/Support/Text/StringMatcher.h"
+
+#include <cstdint> // for std::uint64_t
+#include <string> // for std::string, std::u16string, std::wstring
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of values converted in each timed run</summary>
+  const std::size_t ValueCount = 1024;
+
+  /// <summary>Number of times the text is transcoded in each timed run</summary>
+  const std::size_t TranscodeRepetitions = 64;
+
+  /// <summary>Number of times each file name is matched in each timed run</summary>
+  const std::size_t MatchRepetitions = 256;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives results so the compiler can not optimize the measured work away</summary>
+  volatile std::size_t sink;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Produces a set of values spread over several orders of magnitude</summary>
+  /// <typeparam name="TValue">Type of values that will be produced</typeparam>
+  /// <returns>The produced values</returns>
+  template<typename TValue>
+  std::vector<TValue> makeValues() {
+    std::vector<TValue> values;
+    values.reserve(ValueCount);
+
+    std::uint64_t state = 0x2545F4914F6CDD1DULL;
+    for(std::size_t index = 0; index < ValueCount; ++index) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      TValue value = static_cast<TValue>(state >> (index % 48));
+      if((index % 3) == 0) {
+        value /= static_cast<TValue>(7); // Gives floating point values a fractional part
+      }
+      values.push_back(value);
+    }
+
+    return values;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures conversions of values to strings and back</summary>
+  /// <typeparam name="TValue">Type of values that will be converted</typeparam>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="typeName">Name of the value type used in the measurement names</param>
+  template<typename TValue>
+  void measureLexicalCast(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner, const std::string &typeName
+  ) {
+    using Nuclex::Support::Text::lexical_cast;
+
+    std::vector<TValue> values = makeValues<TValue>();
+    std::vector<std::string> strings;
+    strings.reserve(ValueCount);
+
+    std::size_t byteCount = 0;
+    for(std::size_t index = 0; index < ValueCount; ++index) {
+      strings.push_back(lexical_cast<std::string>(values[index]));
+      byteCount += strings.back().length();
+    }
+
+    runner.Measure(
+      u8"Text/lexical_cast/" + typeName + u8" to string", ValueCount, byteCount,
+      [&values]() {
+        std::size_t totalLength = 0;
+        for(std::size_t index = 0; index < ValueCount; ++index) {
+          totalLength += lexical_cast<std::string>(values[index]).length();
+        }
+        sink = totalLength;
+      }
+    );
+    runner.Measure(
+      u8"Text/lexical_cast/string to " + typeName, ValueCount, byteCount,
+      [&strings]() {
+        std::size_t nonZeroCount = 0;
+        for(std::size_t index = 0; index < ValueCount; ++index) {
+          if(lexical_cast<TValue>(strings[index]) != TValue()) {
+            ++nonZeroCount;
+          }
+        }
+        sink = nonZeroCount;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a text mixing ASCII with multi-byte characters</summary>
+  /// <returns>A UTF-8 text that resembles a localized user interface string table</returns>
+  std::string makeMixedText() {
+    std::string text;
+    for(std::size_t index = 0; index < 64; ++index) {
+      text.append(u8"Settings Übersicht 設定 Настройки ");
+      text.append(u8"\U0001F600 plain ASCII text that makes up most resource files\n");
+    }
+    return text;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures transcoding between UTF-8, UTF-16 and wide strings</summary>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="textName">Name of the text used in the measurement names</param>
+  /// <param name="utf8">UTF-8 text that will be transcoded</param>
+  void measureTranscoding(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const std::string &textName, const std::string &utf8
+  ) {
+    using Nuclex::Support::Text::StringConverter;
+
+    std::u16string utf16 = StringConverter::Utf16FromUtf8(utf8);
+    std::wstring wide = StringConverter::WideFromUtf8(utf8);
+    std::size_t byteCount = utf8.length() * TranscodeRepetitions;
+
+    // Converting into a buffer that was allocated up front measures only the transcoding
+    std::vector<char16_t> utf16Buffer(utf16.length());
+    std::vector<char> utf8Buffer(utf8.length());
+
+    runner.Measure(
+      u8"Text/Utf16FromUtf8/" + textName, TranscodeRepetitions, byteCount,
+      [&utf8, &utf16Buffer]() {
+        std::size_t total = 0;
+        for(std::size_t index = 0; index < TranscodeRepetitions; ++index) {
+          total += StringConverter::Utf16FromUtf8(
+            utf8.data(), utf8.length(), utf16Buffer.data(), utf16Buffer.size()
+          );
+        }
+        sink = total;
+      }
+    );
+    runner.Measure(
+      u8"Text/Utf8FromUtf16/" + textName, TranscodeRepetitions, byteCount,
+      [&utf16, &utf8Buffer]() {
+        std::size_t total = 0;
+        for(std::size_t index = 0; index < TranscodeRepetitions; ++index) {
+          total += StringConverter::Utf8FromUtf16(
+            utf16.data(), utf16.length(), utf8Buffer.data(), utf8Buffer.size()
+          );
+        }
+        sink = total;
+      }
+    );
+    runner.Measure(
+      u8"Text/WideFromUtf8/" + textName, TranscodeRepetitions, byteCount,
+      [&utf8]() {
+        std::size_t total = 0;
+        for(std::size_t index = 0; index < TranscodeRepetitions; ++index) {
+          total += StringConverter::WideFromUtf8(utf8).length();
+        }
+        sink = total;
+      }
+    );
+    runner.Measure(
+      u8"Text/Utf8FromWide/" + textName, TranscodeRepetitions, byteCount,
+      [&wide]() {
+        std::size_t total = 0;
+        for(std::size_t index = 0; index < TranscodeRepetitions; ++index) {
+          total += StringConverter::Utf8FromWide(wide).length();
+        }
+        sink = total;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures matching file names against a wildcard</summary>
+  /// <param name="runner">Runner that will perform and record the measurements</param>
+  /// <param name="wildcard">Wildcard the file names will be matched against</param>
+  /// <param name="caseSensitive">Whether the matching will be case sensitive</param>
+  void measureWildcard(
+    Nuclex::Support::Benchmarks::BenchmarkRunner &runner,
+    const std::string &wildcard, bool caseSensitive
+  ) {
+    using Nuclex::Support::Text::StringMatcher;
+
+    static const std::string fileNames[] = {
+      u8"Textures/Terrain/Grass01.png", u8"Textures/Terrain/GRASS02.PNG",
+      u8"Models/Characters/Knight.fbx", u8"Sounds/Ambient/Forest Birds.ogg",
+      u8"Scripts/Startup.lua", u8"Textures/User Interface/Übersicht.png",
+      u8"ReadMe.md", u8"Textures/Sky/Clouds.hdr"
+    };
+    const std::size_t fileNameCount = sizeof(fileNames) / sizeof(fileNames[0]);
+
+    std::string name = u8"Text/FitsWildcard/" + wildcard;
+    if(caseSensitive) {
+      name.append(u8"/case sensitive");
+    }
+
+    runner.Measure(
+      name, MatchRepetitions * fileNameCount, 0,
+      [&wildcard, caseSensitive, fileNameCount]() {
+        std::size_t matchCount = 0;
+        for(std::size_t index = 0; index < MatchRepetitions; ++index) {
+          for(std::size_t fileIndex = 0; fileIndex < fileNameCount; ++fileIndex) {
+            if(StringMatcher::FitsWildcard(fileNames[fileIndex], wildcard, caseSensitive)) {
+              ++matchCount;
+            }
+          }
+        }
+        sink = matchCount;
+      }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Benchmarks {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void RunTextBenchmark(BenchmarkRunner &runner) {
+    measureLexicalCast<std::int32_t>(runner, u8"int32");
+    measureLexicalCast<std::uint64_t>(runner, u8"uint64");
+    measureLexicalCast<float>(runner, u8"float");
+    measureLexicalCast<double>(runner, u8"double");
+
+    std::string ascii;
+    for(std::size_t index = 0; index < 64; ++index) {
+      ascii.append(u8"Plain ASCII text as found in most configuration and log files\n");
+    }
+    measureTranscoding(runner, u8"ascii", ascii);
+    measureTranscoding(runner, u8"mixed", makeMixedText());
+
+    measureWildcard(runner, u8"*.png", false);
+    measureWildcard(runner, u8"*.png", true);
+    measureWildcard(runner, u8"Textures/*/*0?.png", false);
+    measureWildcard(runner, u8"*Terrain*Grass*", false);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Benchmarks
@@ -0,0 +1,293 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_ALLOCATIONTRACKER_H
+#define NUCLEX_SUPPORT_ALLOCATIONTRACKER_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Part of the framework on whose behalf memory is allocated</summary>
+  enum class AllocationSubsystem {
+
+    /// <summary>Memory not attributed to any of the other subsystems</summary>
+    General = 0,
+    /// <summary>Pixel memory and other buffers used by bitmaps</summary>
+    Bitmaps = 1,
+    /// <summary>XML parsers, readers and writers</summary>
+    Xml = 2,
+    /// <summary>Compression and decompression streams and their buffers</summary>
+    Compression = 3,
+    /// <summary>Subscriber lists of events and queued event calls</summary>
+    Events = 4
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Counts the memory allocated by the framework's subsystems</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Subsystems that want their memory accounted for take it from the allocation
+  ///     methods of this class or from a <see cref="TrackingAllocator" />. Third-party
+  ///     libraries that let their memory management be replaced (eXpat, ZLib, Brotli)
+  ///     can use <see cref="Malloc" />, <see cref="Realloc" /> and <see cref="Free" />.
+  ///   </para>
+  ///   <para>
+  ///     Tracking is disabled by default, in which case each allocation costs one
+  ///     additional relaxed atomic load. Enabled, it costs two relaxed atomic additions.
+  ///     Memory allocated before tracking was enabled is counted when it is freed,
+  ///     so the meaningful figure is the difference between two snapshots:
+  ///   </para>
+  ///   <example>
+  ///     <code>
+  ///       AllocationTracker::SetEnabled(true);
+  ///       AllocationTracker::Snapshot before = AllocationTracker::TakeSnapshot();
+  ///       readDocument(blob);
+  ///       AllocationTracker::Snapshot after = AllocationTracker::TakeSnapshot();
+  ///
+  ///       std::uint64_t xmlAllocationCount = (
+  ///         after[AllocationSubsystem::Xml].AllocationCount -
+  ///         before[AllocationSubsystem::Xml].AllocationCount
+  ///       );
+  ///     </code>
+  ///   </example>
+  /// </remarks>
+  class AllocationTracker {
+
+    /// <summary>Number of subsystems allocations are tracked for</summary>
+    public: static const std::size_t SubsystemCount = 5;
+
+    #pragma region struct Totals
+
+    /// <summary>Allocations made by a subsystem since the program started</summary>
+    public: struct Totals {
+
+      /// <summary>Number of times memory has been allocated</summary>
+      public: std::uint64_t AllocationCount;
+      /// <summary>Number of times memory has been freed</summary>
+      public: std::uint64_t FreeCount;
+      /// <summary>Total number of bytes that have been allocated</summary>
+      public: std::uint64_t AllocatedByteCount;
+      /// <summary>Total number of bytes that have been freed</summary>
+      public: std::uint64_t FreedByteCount;
+
+    };
+
+    #pragma endregion // struct Totals
+
+    #pragma region struct Snapshot
+
+    /// <summary>Allocation totals of all subsystems at one point in time</summary>
+    public: struct Snapshot {
+
+      /// <summary>Looks up the totals of the specified subsystem</summary>
+      /// <param name="subsystem">Subsystem whose totals will be returned</param>
+      /// <returns>The allocation totals of the specified subsystem</returns>
+      public: const Totals &operator [](AllocationSubsystem subsystem) const {
+        return this->Subsystems[static_cast<std::size_t>(subsystem)];
+      }
+
+      /// <summary>Allocation totals indexed by subsystem</summary>
+      public: Totals Subsystems[SubsystemCount];
+
+    };
+
+    #pragma endregion // struct Snapshot
+
+    /// <summary>Enables or disables the accounting of allocations</summary>
+    /// <param name="enabled">Whether allocations will be counted</param>
+    public: NUCLEX_SUPPORT_API static void SetEnabled(bool enabled);
+
+    /// <summary>Checks whether allocations are currently being counted</summary>
+    /// <returns>True if allocations are being counted</returns>
+    public: static bool IsEnabled() {
+      return enabled.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Captures the allocation totals of all subsystems</summary>
+    /// <returns>A snapshot of the current allocation totals</returns>
+    /// <remarks>
+    ///   The totals are read one by one while other threads may keep allocating,
+    ///   so a snapshot can be off by the allocations that happened while it was taken.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static Snapshot TakeSnapshot();
+
+    /// <summary>Counts an allocation that was made without the tracker's help</summary>
+    /// <param name="subsystem">Subsystem that allocated the memory</param>
+    /// <param name="byteCount">Number of bytes that were allocated</param>
+    /// <remarks>
+    ///   Intended for memory managed by containers that can not be given an allocator,
+    ///   such as a std::string whose capacity has grown.
+    /// </remarks>
+    public: static void RecordAllocation(AllocationSubsystem subsystem, std::size_t byteCount) {
+      if(IsEnabled()) {
+        recordAllocation(subsystem, byteCount);
+      }
+    }
+
+    /// <summary>Counts memory that was freed without the tracker's help</summary>
+    /// <param name="subsystem">Subsystem that had allocated the memory</param>
+    /// <param name="byteCount">Number of bytes that were freed</param>
+    public: static void RecordFree(AllocationSubsystem subsystem, std::size_t byteCount) {
+      if(IsEnabled()) {
+        recordFree(subsystem, byteCount);
+      }
+    }
+
+    /// <summary>Allocates memory on behalf of a subsystem</summary>
+    /// <param name="subsystem">Subsystem the memory will be counted for</param>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <returns>The allocated memory, aligned like memory from operator new</returns>
+    /// <remarks>Throws std::bad_alloc if the memory can not be allocated</remarks>
+    public: NUCLEX_SUPPORT_API static void *Allocate(
+      AllocationSubsystem subsystem, std::size_t byteCount
+    );
+
+    /// <summary>Frees memory that was obtained through <see cref="Allocate" /></summary>
+    /// <param name="subsystem">Subsystem the memory was allocated for</param>
+    /// <param name="memory">Memory that will be freed</param>
+    /// <param name="byteCount">Number of bytes that were allocated</param>
+    public: NUCLEX_SUPPORT_API static void Deallocate(
+      AllocationSubsystem subsystem, void *memory, std::size_t byteCount
+    );
+
+    /// <summary>Allocates memory for a C library that frees it without its size</summary>
+    /// <param name="subsystem">Subsystem the memory will be counted for</param>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <returns>The allocated memory or a null pointer if the allocation failed</returns>
+    /// <remarks>
+    ///   The size of the allocation is stored in a small header in front of
+    ///   the returned memory so that <see cref="Free" /> can count it.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static void *Malloc(
+      AllocationSubsystem subsystem, std::size_t byteCount
+    );
+
+    /// <summary>Resizes memory obtained through <see cref="Malloc" /></summary>
+    /// <param name="subsystem">Subsystem the memory is counted for</param>
+    /// <param name="memory">Memory that will be resized, can be a null pointer</param>
+    /// <param name="byteCount">New size of the memory in bytes</param>
+    /// <returns>
+    ///   The resized memory or a null pointer if the memory could not be resized,
+    ///   in which case the original memory is left untouched
+    /// </returns>
+    public: NUCLEX_SUPPORT_API static void *Realloc(
+      AllocationSubsystem subsystem, void *memory, std::size_t byteCount
+    );
+
+    /// <summary>Frees memory obtained through <see cref="Malloc" /></summary>
+    /// <param name="subsystem">Subsystem the memory was allocated for</param>
+    /// <param name="memory">Memory that will be freed, can be a null pointer</param>
+    public: NUCLEX_SUPPORT_API static void Free(AllocationSubsystem subsystem, void *memory);
+
+    /// <summary>Adds an allocation to the totals of a subsystem</summary>
+    /// <param name="subsystem">Subsystem whose totals will be updated</param>
+    /// <param name="byteCount">Number of bytes that were allocated</param>
+    private: NUCLEX_SUPPORT_API static void recordAllocation(
+      AllocationSubsystem subsystem, std::size_t byteCount
+    );
+
+    /// <summary>Adds a release of memory to the totals of a subsystem</summary>
+    /// <param name="subsystem">Subsystem whose totals will be updated</param>
+    /// <param name="byteCount">Number of bytes that were freed</param>
+    private: NUCLEX_SUPPORT_API static void recordFree(
+      AllocationSubsystem subsystem, std::size_t byteCount
+    );
+
+    /// <summary>Whether allocations are currently being counted</summary>
+    private: NUCLEX_SUPPORT_API static std::atomic<bool> enabled;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Standard library allocator that counts its memory for a subsystem</summary>
+  /// <typeparam name="TValue">Type of values the allocator hands out memory for</typeparam>
+  /// <typeparam name="Subsystem">Subsystem the memory will be counted for</typeparam>
+  template<typename TValue, AllocationSubsystem Subsystem>
+  class TrackingAllocator {
+
+    /// <summary>Type of values the allocator hands out memory for</summary>
+    public: typedef TValue value_type;
+
+    /// <summary>Converts the allocator into one for another type of value</summary>
+    /// <typeparam name="TOtherValue">Type of values the other allocator is for</typeparam>
+    public: template<typename TOtherValue> struct rebind {
+      /// <summary>Allocator for the other type of value</summary>
+      typedef TrackingAllocator<TOtherValue, Subsystem> other;
+    };
+
+    /// <summary>Initializes a new tracking allocator</summary>
+    public: TrackingAllocator() = default;
+
+    /// <summary>Initializes an allocator from one for another type of value</summary>
+    /// <param name="other">Allocator that will be converted</param>
+    public: template<typename TOtherValue>
+    TrackingAllocator(const TrackingAllocator<TOtherValue, Subsystem> &other) {
+      (void)other;
+    }
+
+    /// <summary>Allocates memory for the specified number of values</summary>
+    /// <param name="count">Number of values to allocate memory for</param>
+    /// <returns>The allocated memory</returns>
+    public: TValue *allocate(std::size_t count) {
+      return static_cast<TValue *>(AllocationTracker::Allocate(Subsystem, sizeof(TValue) * count));
+    }
+
+    /// <summary>Gives back memory that was allocated earlier</summary>
+    /// <param name="values">Memory that is given back</param>
+    /// <param name="count">Number of values that memory was allocated for</param>
+    public: void deallocate(TValue *values, std::size_t count) {
+      AllocationTracker::Deallocate(Subsystem, values, sizeof(TValue) * count);
+    }
+
+    /// <summary>Checks whether two allocators can free each other's memory</summary>
+    /// <param name="other">Other allocator that will be compared</param>
+    /// <returns>Always true since tracking allocators have no state</returns>
+    public: template<typename TOtherValue>
+    bool operator ==(const TrackingAllocator<TOtherValue, Subsystem> &other) const {
+      (void)other;
+      return true;
+    }
+
+    /// <summary>Checks whether two allocators can not free each other's memory</summary>
+    /// <param name="other">Other allocator that will be compared</param>
+    /// <returns>Always false since tracking allocators have no state</returns>
+    public: template<typename TOtherValue>
+    bool operator !=(const TrackingAllocator<TOtherValue, Subsystem> &other) const {
+      (void)other;
+      return false;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
+
+#endif // NUCLEX_SUPPORT_ALLOCATIONTRACKER_H
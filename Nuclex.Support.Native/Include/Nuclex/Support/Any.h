@@ -23,8 +23,13 @@ License along with this library
 
 #include "Nuclex/Support/Config.h"
 
-#include <typeinfo>
-#include <type_traits>
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uintptr_t
+#include <memory> // for std::shared_ptr, std::weak_ptr
+#include <new> // for placement new
+#include <typeinfo> // for std::type_info, std::bad_cast
+#include <type_traits> // for std::decay<>, std::is_trivially_copyable<>
+#include <utility> // for std::move(), std::forward()
 
 namespace Nuclex { namespace Support {
 
@@ -32,119 +37,268 @@ namespace Nuclex { namespace Support {
 
   /// <summary>Opaquely wraps a value of an arbitrary type</summary>
   /// <remarks>
-  ///   This library targets C++14, where std::any hadn't been introduced yet.
-  ///   If you are targeting C++17 or later, there is no need to use this class.
+  ///   <para>
+  ///     This library targets C++14, where std::any hadn't been introduced yet.
+  ///     If you are targeting C++17 or later, there is no need to use this class.
+  ///   </para>
+  ///   <para>
+  ///     Small values are stored inside the any itself, so wrapping them doesn't allocate.
+  ///     This applies to trivially copyable types of up to three pointers in size and to
+  ///     the copyable smart pointers (std::shared_ptr being what the service container
+  ///     stores). Other values are placed on the heap. The distinction is made so that
+  ///     moving an any never moves the value it holds: for inline values this is
+  ///     unobservable, for values on the heap the any simply hands over the pointer.
+  ///   </para>
   /// </remarks>
   class Any {
 
     /// <summary>An <see cref="Any" /> instance that is empty</summary>
     public: const static Any Empty;
 
-    #pragma region struct GenericValueHolder
+    /// <summary>Number of pointer-sized slots available for storing values inline</summary>
+    private: const static std::size_t InlinePointerCount = 3;
 
-    /// <summary>Base class to the holder for the value wrapped by the any</summary>
-    protected: struct GenericValueHolder {
+    #pragma region struct IsSmartPointer
 
-      /// <summary>Immediately releases all resources owned by the instance</summary>
-      public: virtual ~GenericValueHolder() {}
+    /// <summary>Detects the standard smart pointers, whose moves are unobservable</summary>
+    private: template<typename TValue> struct IsSmartPointer {
+      /// <summary>Whether the type is one of the standard smart pointers</summary>
+      public: static const bool value = false;
+    };
+
+    /// <summary>Detects the standard smart pointers, whose moves are unobservable</summary>
+    private: template<typename TPointee> struct IsSmartPointer<std::shared_ptr<TPointee>> {
+      /// <summary>Whether the type is one of the standard smart pointers</summary>
+      public: static const bool value = true;
+    };
+
+    /// <summary>Detects the standard smart pointers, whose moves are unobservable</summary>
+    private: template<typename TPointee> struct IsSmartPointer<std::weak_ptr<TPointee>> {
+      /// <summary>Whether the type is one of the standard smart pointers</summary>
+      public: static const bool value = true;
+    };
+
+    #pragma endregion // struct IsSmartPointer
+
+    #pragma region struct IsStoredInline
 
-      /// <summary>Creates a clone of the instance, also copying the value</summary>
-      /// <returns>The cloned instance</returns>
-      public: virtual GenericValueHolder *Clone() const = 0;
+    /// <summary>Decides whether values of a type are stored inside the any</summary>
+    private: template<typename TValue> struct IsStoredInline {
+      /// <summary>True if the type is stored inline, false if it goes onto the heap</summary>
+      public: static const bool value = (
+        (sizeof(TValue) <= sizeof(std::uintptr_t[InlinePointerCount])) &&
+        (alignof(TValue) <= alignof(std::uintptr_t)) &&
+        std::is_nothrow_move_constructible<TValue>::value &&
+        (std::is_trivially_copyable<TValue>::value || IsSmartPointer<TValue>::value)
+      );
+    };
+
+    #pragma endregion // struct IsStoredInline
+
+    #pragma region struct ValueOperations
+
+    /// <summary>Table of functions that manage the value stored in an any</summary>
+    /// <remarks>
+    ///   Replaces a virtual value holder class. Each stored type gets one static table,
+    ///   so the any only needs a single pointer to know the type of its value and how
+    ///   to copy, move and destroy it.
+    /// </remarks>
+    private: struct ValueOperations {
 
-      /// <summary>Returns the type stored in the wrapper</summary>
-      /// <returns>The type the wrapper is storing</returns>
-      public: virtual const std::type_info &GetType() const = 0;
+      /// <summary>Returns the type of the stored value</summary>
+      public: const std::type_info &(*GetType)();
+      /// <summary>Copies the value of one any into another, empty any</summary>
+      public: void (*Copy)(const Any &source, Any &target);
+      /// <summary>Moves the value of one any into another, empty any</summary>
+      public: void (*Move)(Any &source, Any &target);
+      /// <summary>Destroys the value stored in an any</summary>
+      public: void (*Destroy)(Any &any);
 
     };
 
-    #pragma endregion // struct GenericValueHolder
+    #pragma endregion // struct ValueOperations
 
-    #pragma region struct ValueHolder
+    #pragma region struct InlineValue
 
-    /// <summary>Strongly typed container for the value the any is carrying</summary>
-    private: template<typename TValue> struct ValueHolder : public GenericValueHolder {
+    /// <summary>Manages values that are stored directly inside the any</summary>
+    private: template<typename TValue> struct InlineValue {
 
-      /// <summary>Initializes a new value holder for the specified value</summary>
-      /// <param name="value">Value the holder will carry</param>
-      public: ValueHolder(const TValue &value) :
-        value(value) {}
+      /// <summary>Operations for values of this type</summary>
+      public: static const ValueOperations Operations;
 
-      /// <summary>Immediately releases all resources owned by the instance</summary>
-      public: virtual ~ValueHolder() {}
+      /// <summary>Constructs a value in the storage of an any</summary>
+      /// <param name="any">Any in which the value will be constructed</param>
+      /// <param name="value">Value that will be copied or moved into the any</param>
+      public: template<typename TPassedValue>
+      static void Construct(Any &any, TPassedValue &&value) {
+        new(any.storage.Inline) TValue(std::forward<TPassedValue>(value));
+      }
 
-      /// <summary>Creates a clone of the instance, also copying the value</summary>
-      /// <returns>The cloned instance</returns>
-      public: ValueHolder *Clone() const override {
-        return new ValueHolder<TValue>(this->value);
+      /// <summary>Retrieves the value stored in an any</summary>
+      /// <param name="any">Any whose stored value will be retrieved</param>
+      /// <returns>The value stored in the any</returns>
+      public: static const TValue &Get(const Any &any) {
+        return *reinterpret_cast<const TValue *>(any.storage.Inline);
       }
 
-      /// <summary>Returns the type stored in the wrapper</summary>
-      /// <returns>The type the wrapper is storing</returns>
-      public: const std::type_info &GetType() const override { return typeid(TValue); }
+      /// <summary>Returns the type of the stored value</summary>
+      /// <returns>The type of values managed by these operations</returns>
+      private: static const std::type_info &getType() { return typeid(TValue); }
+
+      /// <summary>Copies the value of one any into another, empty any</summary>
+      /// <param name="source">Any whose value will be copied</param>
+      /// <param name="target">Any that will receive the copy</param>
+      private: static void copy(const Any &source, Any &target) {
+        Construct(target, Get(source));
+      }
 
-      /// <summary>Retrieves the value stored in the value holder</summary>
-      /// <returns>The value stored in the value holder</returns>
-      public: const TValue &Get() const { return this->value; }
+      /// <summary>Moves the value of one any into another, empty any</summary>
+      /// <param name="source">Any whose value will be moved</param>
+      /// <param name="target">Any that will receive the value</param>
+      private: static void move(Any &source, Any &target) {
+        TValue *value = reinterpret_cast<TValue *>(source.storage.Inline);
+        Construct(target, std::move(*value));
+        value->~TValue();
+      }
 
-      /// <summary>Value that is being carried by the any</summary>
-      private: TValue value;
+      /// <summary>Destroys the value stored in an any</summary>
+      /// <param name="any">Any whose value will be destroyed</param>
+      private: static void destroy(Any &any) {
+        reinterpret_cast<TValue *>(any.storage.Inline)->~TValue();
+      }
 
     };
 
-    #pragma endregion // struct ValueHolder
+    #pragma endregion // struct InlineValue
+
+    #pragma region struct HeapValue
+
+    /// <summary>Manages values that are stored on the heap</summary>
+    private: template<typename TValue> struct HeapValue {
+
+      /// <summary>Operations for values of this type</summary>
+      public: static const ValueOperations Operations;
+
+      /// <summary>Constructs a value on the heap and stores it in an any</summary>
+      /// <param name="any">Any in which the value will be stored</param>
+      /// <param name="value">Value that will be copied or moved onto the heap</param>
+      public: template<typename TPassedValue>
+      static void Construct(Any &any, TPassedValue &&value) {
+        any.storage.Heap = new TValue(std::forward<TPassedValue>(value));
+      }
+
+      /// <summary>Retrieves the value stored in an any</summary>
+      /// <param name="any">Any whose stored value will be retrieved</param>
+      /// <returns>The value stored in the any</returns>
+      public: static const TValue &Get(const Any &any) {
+        return *static_cast<const TValue *>(any.storage.Heap);
+      }
+
+      /// <summary>Returns the type of the stored value</summary>
+      /// <returns>The type of values managed by these operations</returns>
+      private: static const std::type_info &getType() { return typeid(TValue); }
+
+      /// <summary>Copies the value of one any into another, empty any</summary>
+      /// <param name="source">Any whose value will be copied</param>
+      /// <param name="target">Any that will receive the copy</param>
+      private: static void copy(const Any &source, Any &target) {
+        Construct(target, Get(source));
+      }
+
+      /// <summary>Moves the value of one any into another, empty any</summary>
+      /// <param name="source">Any whose value will be moved</param>
+      /// <param name="target">Any that will receive the value</param>
+      /// <remarks>Only the pointer changes hands, the value itself stays put</remarks>
+      private: static void move(Any &source, Any &target) {
+        target.storage.Heap = source.storage.Heap;
+      }
+
+      /// <summary>Destroys the value stored in an any</summary>
+      /// <param name="any">Any whose value will be destroyed</param>
+      private: static void destroy(Any &any) {
+        delete static_cast<TValue *>(any.storage.Heap);
+      }
+
+    };
+
+    #pragma endregion // struct HeapValue
+
+    /// <summary>Selects how values of the specified type are stored</summary>
+    private: template<typename TValue> struct StorageFor {
+      /// <summary>Storage implementation used for the type</summary>
+      public: typedef typename std::conditional<
+        IsStoredInline<TValue>::value, InlineValue<TValue>, HeapValue<TValue>
+      >::type Type;
+    };
 
     /// <summary>Initializes a new any not holding a value</summary>
     public: Any() :
-      valueHolder(nullptr) {}
+      operations(nullptr) {}
 
     /// <summary>Initializes a new any containing the specified value</summary>
     /// <param name="value">Value that will be carried by the any</param>
-    public: template<typename TValue> Any(const TValue &value) :
-      valueHolder(new ValueHolder<typename std::decay<TValue>::type>(value)) {}
+    /// <remarks>Temporaries are moved into the any rather than copied</remarks>
+    public: template<
+      typename TValue,
+      typename = typename std::enable_if<
+        !std::is_same<typename std::decay<TValue>::type, Any>::value
+      >::type
+    >
+    Any(TValue &&value) :
+      operations(nullptr) {
+      typedef typename StorageFor<typename std::decay<TValue>::type>::Type Storage;
+      Storage::Construct(*this, std::forward<TValue>(value));
+      this->operations = &Storage::Operations;
+    }
 
     /// <summary>Initializes a new any copying the contents of an existing instance</summary>
     /// <param name="other">Other instance that will be copied</param>
     public: NUCLEX_SUPPORT_API Any(const Any &other) :
-      valueHolder(cloneOrPropagateNull(other.valueHolder)) {}
+      operations(nullptr) {
+      if(other.operations != nullptr) {
+        other.operations->Copy(other, *this);
+        this->operations = other.operations;
+      }
+    }
 
     /// <summary>Initializes a new any taking over an existing instance</summary>
     /// <param name="other">Other instance that will be taken over</param>
     public: NUCLEX_SUPPORT_API Any(Any &&other) :
-      valueHolder(other.valueHolder) {
-      other.valueHolder = nullptr;
+      operations(other.operations) {
+      if(other.operations != nullptr) {
+        other.operations->Move(other, *this);
+        other.operations = nullptr;
+      }
     }
 
     /// <summary>Frees all memory used by the instance</summary>
     public: NUCLEX_SUPPORT_API ~Any() {
-      delete this->valueHolder;
+      if(this->operations != nullptr) {
+        this->operations->Destroy(*this);
+      }
     }
 
     /// <summary>Checks whether the Any is currently holding a value</summary>
     /// <returns>True if the Any holds a value, false otherwise</returns>
     public: NUCLEX_SUPPORT_API bool HasValue() const {
-      return (this->valueHolder != nullptr);
+      return (this->operations != nullptr);
     }
 
     /// <summary>Destroys the contents of the Any</summary>
     public: NUCLEX_SUPPORT_API void Reset() {
-      delete this->valueHolder;
-      this->valueHolder = nullptr;
+      if(this->operations != nullptr) {
+        this->operations->Destroy(*this);
+        this->operations = nullptr;
+      }
     }
 
     /// <summary>Assigns the contents of another any to this instance</summary>
     /// <param name="other">Other any whose contents will be assigned to this one</param>
     /// <returns>The current any after the value has been assigned</returns>
     public: NUCLEX_SUPPORT_API Any &operator =(const Any &other) {
-      if(other.valueHolder == nullptr) {
-        delete this->valueHolder;
-        this->valueHolder = nullptr;
-      } else {
-        //std::unique_ptr<GenericValueHolder> clone(other.valueHolder->Clone());
-        GenericValueHolder *clone = other.valueHolder->Clone();
-        delete this->valueHolder;
-        //this->valueHolder = clone.release();
-        this->valueHolder = clone;
+      if(&other != this) {
+        Any clone(other); // If copying throws, this instance remains unchanged
+        *this = std::move(clone);
       }
 
       return *this;
@@ -154,9 +308,15 @@ namespace Nuclex { namespace Support {
     /// <param name="other">Other any whose contents will be moved to this one</param>
     /// <returns>The current any after the value has been moved</returns>
     public: NUCLEX_SUPPORT_API Any &operator =(Any &&other) {
-      delete this->valueHolder;
-      this->valueHolder = other.valueHolder;
-      other.valueHolder = nullptr;
+      if(&other != this) {
+        Reset();
+        if(other.operations != nullptr) {
+          other.operations->Move(other, *this);
+          this->operations = other.operations;
+          other.operations = nullptr;
+        }
+      }
+
       return *this;
     }
 
@@ -164,31 +324,50 @@ namespace Nuclex { namespace Support {
     /// <typeparam name="TValue">Type of value that will be retrieved from the any</typeparam>
     /// <returns>The value stored by the any</returns>
     public: template<typename TValue> const TValue &Get() const {
-      typedef ValueHolder<TValue> TValueHolder;
-
-      const std::type_info &type = typeid(typename std::decay<TValue>::type);
-      if(type != valueHolder->GetType()) {
-        throw std::bad_cast(); // "Type is different from the value stored by the 'Any' instance"
+      typedef typename StorageFor<typename std::decay<TValue>::type>::Type Storage;
+
+      // Comparing the operations table is enough unless the value was stored by another
+      // module (a DLL has its own copy of the table), then we fall back to the type info.
+      if(this->operations != &Storage::Operations) {
+        const std::type_info &type = typeid(typename std::decay<TValue>::type);
+        if((this->operations == nullptr) || (type != this->operations->GetType())) {
+          throw std::bad_cast(); // "Type is different from the value stored by the 'Any'"
+        }
       }
 
-      return static_cast<TValueHolder *>(this->valueHolder)->Get();
+      return Storage::Get(*this);
     }
 
-    /// <summary>Creates a clone of an existing value holder only if it's non-null</summary>
-    /// <param name="other">Existing value holder to clone or null</param>
-    /// <returns>A clone of the existing value holder or a null pointer</returns>
-    private: static GenericValueHolder *cloneOrPropagateNull(GenericValueHolder *other) {
-      if(other == nullptr) {
-        return nullptr;
-      } else {
-        return other->Clone();
-      }
-    }
+    /// <summary>Functions that manage the stored value, null if the any is empty</summary>
+    private: const ValueOperations *operations;
+    /// <summary>Memory holding the value or a pointer to it</summary>
+    private: union {
+      /// <summary>Stored value if it's stored on the heap</summary>
+      void *Heap;
+      /// <summary>Memory the value is constructed in if it's stored inline</summary>
+      std::uintptr_t Inline[InlinePointerCount];
+    } storage;
 
-    /// <summary>Value holder that carries the value stored in the any</summary>
-    private: GenericValueHolder *valueHolder;
-    //private: std::uint8_t memory[sizeof(ValueHolder<std::intptr_t>)];
+  };
+
+  // ------------------------------------------------------------------------------------------- //
 
+  template<typename TValue>
+  const Any::ValueOperations Any::InlineValue<TValue>::Operations = {
+    &Any::InlineValue<TValue>::getType,
+    &Any::InlineValue<TValue>::copy,
+    &Any::InlineValue<TValue>::move,
+    &Any::InlineValue<TValue>::destroy
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TValue>
+  const Any::ValueOperations Any::HeapValue<TValue>::Operations = {
+    &Any::HeapValue<TValue>::getType,
+    &Any::HeapValue<TValue>::copy,
+    &Any::HeapValue<TValue>::move,
+    &Any::HeapValue<TValue>::destroy
   };
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,128 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_CHROMETRACESINK_H
+#define NUCLEX_SUPPORT_CHROMETRACESINK_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Instrumentation.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+#include <iosfwd> // for std::ostream
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Collects measurements for the Chrome trace event format</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The collected events can be written as a JSON file that chrome://tracing,
+  ///     Perfetto and Speedscope display as a timeline. Zones become complete events on
+  ///     the thread that ran them, reported counters and histograms become counter events.
+  ///   </para>
+  ///   <para>
+  ///     Events are kept in memory until <see cref="Clear" /> is called, so for long
+  ///     running programs the sink should only be installed while tracing something.
+  ///   </para>
+  /// </remarks>
+  class ChromeTraceSink : public InstrumentationSink {
+
+    /// <summary>Initializes a new Chrome trace sink without any events</summary>
+    public: NUCLEX_SUPPORT_API ChromeTraceSink();
+    /// <summary>Frees all memory used by the collected events</summary>
+    public: NUCLEX_SUPPORT_API ~ChromeTraceSink() override;
+
+    /// <summary>Counts the events that have been collected so far</summary>
+    /// <returns>The number of collected events</returns>
+    public: NUCLEX_SUPPORT_API std::size_t CountEvents() const;
+
+    /// <summary>Discards all events that have been collected so far</summary>
+    public: NUCLEX_SUPPORT_API void Clear();
+
+    /// <summary>Writes the collected events as a JSON trace</summary>
+    /// <param name="stream">Stream the JSON trace will be written to</param>
+    public: NUCLEX_SUPPORT_API void WriteTo(std::ostream &stream) const;
+
+    /// <summary>Records a complete event for a zone that has ended</summary>
+    /// <param name="site">Instrumented location that was left</param>
+    /// <param name="startNanoseconds">Time at which the zone was entered</param>
+    /// <param name="elapsedNanoseconds">Time the calling thread spent in the zone</param>
+    public: NUCLEX_SUPPORT_API void ZoneLeft(
+      const InstrumentationSite &site,
+      std::uint64_t startNanoseconds, std::uint64_t elapsedNanoseconds
+    ) override;
+
+    /// <summary>Records a counter event with the counter's current value</summary>
+    /// <param name="counter">Counter whose value is being reported</param>
+    /// <param name="value">Value of the counter</param>
+    public: NUCLEX_SUPPORT_API void CounterReported(
+      const Counter &counter, std::uint64_t value
+    ) override;
+
+    /// <summary>Records a counter event with the histogram's non-empty buckets</summary>
+    /// <param name="histogram">Histogram whose contents are being reported</param>
+    /// <param name="bucketCounts">Number of values recorded in each bucket</param>
+    public: NUCLEX_SUPPORT_API void HistogramReported(
+      const Histogram &histogram, const std::uint64_t *bucketCounts
+    ) override;
+
+    #pragma region struct Event
+
+    /// <summary>Event that will be written into the trace</summary>
+    private: struct Event {
+
+      /// <summary>Name of the zone, counter or histogram</summary>
+      public: const char *Name;
+      /// <summary>Thread the zone ran on, unused for counters</summary>
+      public: std::uint64_t ThreadId;
+      /// <summary>Time at which the event happened in nanoseconds</summary>
+      public: std::uint64_t StartNanoseconds;
+      /// <summary>Duration of a zone in nanoseconds</summary>
+      public: std::uint64_t ElapsedNanoseconds;
+      /// <summary>Index of the event's first value in the value list</summary>
+      public: std::size_t FirstValueIndex;
+      /// <summary>Number of values the event has, zero for zones</summary>
+      public: std::size_t ValueCount;
+
+    };
+
+    #pragma endregion // struct Event
+
+    private: ChromeTraceSink(const ChromeTraceSink &) = delete;
+    private: ChromeTraceSink &operator =(const ChromeTraceSink &) = delete;
+
+    /// <summary>Must be held while accessing the events</summary>
+    private: mutable std::mutex mutex;
+    /// <summary>Events collected so far</summary>
+    private: std::vector<Event> events;
+    /// <summary>Values of the counter events as pairs of bucket index and count</summary>
+    private: std::vector<std::uint64_t> values;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
+
+#endif // NUCLEX_SUPPORT_CHROMETRACESINK_H
@@ -24,6 +24,7 @@ License along with this library
 #include "Nuclex/Support/Config.h"
 
 #include <cstdlib>
+#include <utility> // for std::forward()
 
 namespace Nuclex { namespace Support { namespace Collections {
 
@@ -83,6 +84,23 @@ namespace Nuclex { namespace Support { namespace Collections {
     /// <param name="item">Item that will be added to the collection</param>
     public: virtual void Add(const TValue &item) = 0;
 
+    /// <summary>Moves the specified item into the collection</summary>
+    /// <param name="item">Item that will be moved into the collection</param>
+    public: virtual void Add(TValue &&item) = 0;
+
+    /// <summary>Constructs a new item in the collection</summary>
+    /// <typeparam name="TArguments">Types of the arguments for the item's constructor</typeparam>
+    /// <param name="arguments">Arguments that will be passed to the item's constructor</param>
+    /// <remarks>
+    ///   Through the interface, this constructs a temporary item and moves it into
+    ///   the collection. Implementations can hide this method with one that constructs
+    ///   the item in place.
+    /// </remarks>
+    public: template<typename... TArguments>
+    void Emplace(TArguments &&... arguments) {
+      Add(TValue(std::forward<TArguments>(arguments)...));
+    }
+
     /// <summary>Removes the specified item from the collection</summary>
     /// <param name="item">Item that will be removed from the collection</param>
     /// <returns>True if the item existed in the collection and was removed</returns>
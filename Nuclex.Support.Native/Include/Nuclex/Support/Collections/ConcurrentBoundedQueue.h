@@ -0,0 +1,469 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTBOUNDEDQUEUE_H
+#define NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTBOUNDEDQUEUE_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <atomic> // for std::atomic, std::atomic_thread_fence()
+#include <condition_variable> // for std::condition_variable
+#include <cstddef> // for std::size_t, std::ptrdiff_t
+#include <cstdint> // for std::uint8_t
+#include <memory> // for std::unique_ptr
+#include <mutex> // for std::mutex, std::unique_lock
+#include <new> // for placement new
+#include <type_traits> // for std::aligned_storage<>, std::enable_if<>
+#include <utility> // for std::move()
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Fixed-size FIFO queue any number of threads can use at the same time</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Follows Dmitry Vyukov's bounded MPMC queue: each slot of a power-of-two ring
+  ///     carries a sequence number telling whether it's waiting for the producer or for
+  ///     the consumer of the current lap. Producers and consumers claim slots by advancing
+  ///     the tail or head index with a compare-and-swap and then publish the slot by
+  ///     updating its sequence number, so threads only contend on the index they share
+  ///     and never wait for one another unless the queue is full or empty.
+  ///   </para>
+  ///   <para>
+  ///     The batch variants of <see cref="TryEnqueue" /> and <see cref="TryDequeue" />
+  ///     claim a whole run of consecutive slots with a single compare-and-swap.
+  ///   </para>
+  ///   <para>
+  ///     <see cref="Enqueue" /> and <see cref="Dequeue" /> block while the queue is
+  ///     full or empty. Sleeping threads are woken through condition variables that
+  ///     are only touched while a thread is actually waiting, so users that stick
+  ///     to the non-blocking methods pay for no more than a memory fence.
+  ///   </para>
+  ///   <para>
+  ///     Once a slot is claimed it has to be published, so the items' move constructor
+  ///     and move assignment operator must not throw. Items are copied before a slot
+  ///     is claimed unless their copy constructor can't throw either.
+  ///   </para>
+  /// </remarks>
+  template<typename TItem>
+  class ConcurrentBoundedQueue {
+
+    /// <summary>Initializes a new concurrent queue</summary>
+    /// <param name="capacity">Number of items the queue will be able to hold</param>
+    public: ConcurrentBoundedQueue(std::size_t capacity = 256) :
+      capacity(getNextPowerOfTwo(capacity)),
+      slots(new Slot[getNextPowerOfTwo(capacity)]),
+      head(0),
+      tail(0),
+      waitingConsumerCount(0),
+      waitingProducerCount(0) {
+      static_assert(
+        std::is_nothrow_move_constructible<TItem>::value &&
+        std::is_nothrow_move_assignable<TItem>::value,
+        u8"Items in the concurrent queue must be movable without exceptions"
+      );
+
+      for(std::size_t index = 0; index < this->capacity; ++index) {
+        this->slots[index].Sequence.store(index, std::memory_order_relaxed);
+      }
+    }
+
+    /// <summary>Destroys the queue and all items still in it</summary>
+    public: ~ConcurrentBoundedQueue() {
+      std::size_t last = this->tail.load(std::memory_order_acquire);
+      for(std::size_t index = this->head.load(std::memory_order_relaxed); index < last; ++index) {
+        getItemAddress(index)->~TItem();
+      }
+    }
+
+    /// <summary>Returns the number of items the queue can hold</summary>
+    /// <returns>The maximum number of items that can be in the queue at once</returns>
+    public: std::size_t GetCapacity() const {
+      return this->capacity;
+    }
+
+    /// <summary>Estimates the number of items currently stored in the queue</summary>
+    /// <returns>The approximate number of items in the queue</returns>
+    /// <remarks>
+    ///   Other threads may be adding and taking items while this runs, so the result
+    ///   is only a snapshot and includes items that are still being constructed.
+    /// </remarks>
+    public: std::size_t Count() const {
+      std::size_t first = this->head.load(std::memory_order_acquire);
+      std::size_t last = this->tail.load(std::memory_order_acquire);
+      return (last > first) ? (last - first) : 0;
+    }
+
+    /// <summary>Tries to append a copy of an item to the queue</summary>
+    /// <param name="item">Item that will be copied into the queue</param>
+    /// <returns>True if the item was added, false if the queue was full</returns>
+    public: bool TryEnqueue(const TItem &item) {
+      return tryEnqueueCopy(item);
+    }
+
+    /// <summary>Tries to move an item into the queue</summary>
+    /// <param name="item">Item that will be moved into the queue</param>
+    /// <returns>True if the item was added, false if the queue was full</returns>
+    /// <remarks>If the queue was full, the item is left untouched</remarks>
+    public: bool TryEnqueue(TItem &&item) {
+      std::size_t index;
+      if(claimSlots(this->tail, 1, 0, index) == 0) {
+        return false;
+      }
+
+      new(getItemAddress(index)) TItem(std::move(item));
+      publishItems(index, 1);
+      return true;
+    }
+
+    /// <summary>Tries to append copies of several items to the queue</summary>
+    /// <param name="items">Items that will be copied into the queue</param>
+    /// <param name="count">Number of items that should be copied</param>
+    /// <returns>The number of items that fit into the queue and were added</returns>
+    /// <remarks>
+    ///   The items end up consecutively in the queue, unless their copy constructor
+    ///   can throw, in which case they're added one by one.
+    /// </remarks>
+    public: std::size_t TryEnqueue(const TItem *items, std::size_t count) {
+      return tryEnqueueCopies(items, count);
+    }
+
+    /// <summary>Tries to take the oldest item out of the queue</summary>
+    /// <param name="item">Receives the item taken from the queue</param>
+    /// <returns>True if an item was taken, false if the queue was empty</returns>
+    public: bool TryDequeue(TItem &item) {
+      return (TryDequeue(&item, 1) == 1);
+    }
+
+    /// <summary>Tries to take several of the oldest items out of the queue</summary>
+    /// <param name="items">Memory to which the items will be moved</param>
+    /// <param name="count">Maximum number of items that will be taken</param>
+    /// <returns>The number of items that were taken from the queue</returns>
+    public: std::size_t TryDequeue(TItem *items, std::size_t count) {
+      std::size_t index;
+      count = claimSlots(this->head, count, 1, index);
+
+      for(std::size_t offset = 0; offset < count; ++offset) {
+        TItem *item = getItemAddress(index + offset);
+        items[offset] = std::move(*item);
+        item->~TItem();
+        this->slots[(index + offset) & (this->capacity - 1)].Sequence.store(
+          index + offset + this->capacity, std::memory_order_release
+        );
+      }
+
+      if(count > 0) {
+        wakeWaitingThreads(this->waitingProducerCount, this->producerMutex, this->spaceFreed);
+      }
+      return count;
+    }
+
+    /// <summary>Appends a copy of an item to the queue, waiting for space if needed</summary>
+    /// <param name="item">Item that will be copied into the queue</param>
+    public: void Enqueue(const TItem &item) {
+      while(!TryEnqueue(item)) {
+        waitUntil(
+          this->waitingProducerCount, this->producerMutex, this->spaceFreed,
+          [this]() { return isSlotReady(this->tail, 0); }
+        );
+      }
+    }
+
+    /// <summary>Moves an item into the queue, waiting for space if needed</summary>
+    /// <param name="item">Item that will be moved into the queue</param>
+    public: void Enqueue(TItem &&item) {
+      while(!TryEnqueue(std::move(item))) {
+        waitUntil(
+          this->waitingProducerCount, this->producerMutex, this->spaceFreed,
+          [this]() { return isSlotReady(this->tail, 0); }
+        );
+      }
+    }
+
+    /// <summary>Takes the oldest item out of the queue, waiting for one if needed</summary>
+    /// <param name="item">Receives the item taken from the queue</param>
+    public: void Dequeue(TItem &item) {
+      while(!TryDequeue(item)) {
+        waitUntil(
+          this->waitingConsumerCount, this->consumerMutex, this->itemAdded,
+          [this]() { return isSlotReady(this->head, 1); }
+        );
+      }
+    }
+
+    /// <summary>Slot in the ring that stores one item</summary>
+    private: struct Slot {
+
+      /// <summary>Index of the queue operation the slot is waiting for</summary>
+      /// <remarks>
+      ///   Equal to the slot's index when it waits for a producer, one higher when
+      ///   it waits for a consumer. Each lap around the ring adds the capacity.
+      /// </remarks>
+      public: std::atomic<std::size_t> Sequence;
+      /// <summary>Memory the item in the slot is constructed in</summary>
+      public: typename std::aligned_storage<sizeof(TItem), alignof(TItem)>::type Item;
+
+    };
+
+    /// <summary>Calculates the next power of two for the specified value</summary>
+    /// <param name="value">Value of which the next power of two will be calculated</param>
+    /// <returns>The next power of two to the specified value, at least 2</returns>
+    private: static std::size_t getNextPowerOfTwo(std::size_t value) {
+      std::size_t powerOfTwo = 2;
+      while(powerOfTwo < value) {
+        powerOfTwo <<= 1;
+      }
+
+      return powerOfTwo;
+    }
+
+    /// <summary>Returns the address of the item stored for a queue index</summary>
+    /// <param name="index">Head or tail index that will be looked up in the ring</param>
+    /// <returns>The address of the item the index points to</returns>
+    private: TItem *getItemAddress(std::size_t index) const {
+      return reinterpret_cast<TItem *>(&this->slots[index & (this->capacity - 1)].Item);
+    }
+
+    /// <summary>Checks whether the slot an index points to can be claimed</summary>
+    /// <param name="index">Head or tail index whose slot will be checked</param>
+    /// <param name="sequenceOffset">0 to check for producers, 1 for consumers</param>
+    /// <returns>True if the slot is ready to be claimed</returns>
+    private: bool isSlotReady(
+      const std::atomic<std::size_t> &index, std::size_t sequenceOffset
+    ) const {
+      std::size_t position = index.load(std::memory_order_relaxed);
+      std::size_t sequence = this->slots[position & (this->capacity - 1)].Sequence.load(
+        std::memory_order_acquire
+      );
+      return (sequence == position + sequenceOffset);
+    }
+
+    /// <summary>Claims a run of consecutive slots that are ready</summary>
+    /// <param name="index">Head or tail index the slots will be claimed from</param>
+    /// <param name="maximumCount">Maximum number of slots that will be claimed</param>
+    /// <param name="sequenceOffset">0 to claim for producers, 1 for consumers</param>
+    /// <param name="firstIndex">Receives the index of the first claimed slot</param>
+    /// <returns>The number of slots that have been claimed</returns>
+    /// <remarks>
+    ///   A slot is ready when its sequence number equals its index plus the offset.
+    ///   Slots behind the index can only become more ready while this runs, so if
+    ///   the compare-and-swap succeeds, all slots found ready are still ours.
+    /// </remarks>
+    private: std::size_t claimSlots(
+      std::atomic<std::size_t> &index, std::size_t maximumCount, std::size_t sequenceOffset,
+      std::size_t &firstIndex
+    ) {
+      if(maximumCount > this->capacity) {
+        maximumCount = this->capacity;
+      }
+
+      std::size_t position = index.load(std::memory_order_relaxed);
+      for(;;) {
+        std::size_t readyCount = 0;
+        while(readyCount < maximumCount) {
+          std::size_t sequence = this->slots[
+            (position + readyCount) & (this->capacity - 1)
+          ].Sequence.load(std::memory_order_acquire);
+          std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(
+            sequence - (position + readyCount + sequenceOffset)
+          );
+          if(difference != 0) {
+            if((readyCount == 0) && (difference > 0)) {
+              readyCount = maximumCount + 1; // Another thread got ahead of us, retry
+            }
+            break;
+          }
+          ++readyCount;
+        }
+
+        if(readyCount > maximumCount) {
+          position = index.load(std::memory_order_relaxed);
+        } else if(readyCount == 0) { // Full (for producers) or empty (for consumers)
+          return 0;
+        } else if(
+          index.compare_exchange_weak(
+            position, position + readyCount, std::memory_order_relaxed
+          )
+        ) {
+          firstIndex = position;
+          return readyCount;
+        }
+      }
+    }
+
+    /// <summary>Hands items constructed in claimed slots over to the consumers</summary>
+    /// <param name="firstIndex">Index of the first slot that will be published</param>
+    /// <param name="count">Number of slots that will be published</param>
+    private: void publishItems(std::size_t firstIndex, std::size_t count) {
+      for(std::size_t offset = 0; offset < count; ++offset) {
+        this->slots[(firstIndex + offset) & (this->capacity - 1)].Sequence.store(
+          firstIndex + offset + 1, std::memory_order_release
+        );
+      }
+
+      wakeWaitingThreads(this->waitingConsumerCount, this->consumerMutex, this->itemAdded);
+    }
+
+    /// <summary>Copies an item into the queue, constructing it in its slot</summary>
+    /// <param name="item">Item that will be copied into the queue</param>
+    /// <returns>True if the item was added, false if the queue was full</returns>
+    private: template<typename T = TItem>
+    typename std::enable_if<std::is_nothrow_copy_constructible<T>::value, bool>::type
+    tryEnqueueCopy(const TItem &item) {
+      std::size_t index;
+      if(claimSlots(this->tail, 1, 0, index) == 0) {
+        return false;
+      }
+
+      new(getItemAddress(index)) TItem(item);
+      publishItems(index, 1);
+      return true;
+    }
+
+    /// <summary>Copies an item into the queue, copying it before claiming a slot</summary>
+    /// <param name="item">Item that will be copied into the queue</param>
+    /// <returns>True if the item was added, false if the queue was full</returns>
+    private: template<typename T = TItem>
+    typename std::enable_if<!std::is_nothrow_copy_constructible<T>::value, bool>::type
+    tryEnqueueCopy(const TItem &item) {
+      if(!isSlotReady(this->tail, 0)) {
+        return false; // Avoid copying the item if it's clear that the queue is full
+      }
+
+      return TryEnqueue(TItem(item));
+    }
+
+    /// <summary>Copies several items into consecutive slots at once</summary>
+    /// <param name="items">Items that will be copied into the queue</param>
+    /// <param name="count">Number of items that should be copied</param>
+    /// <returns>The number of items that fit into the queue and were added</returns>
+    private: template<typename T = TItem>
+    typename std::enable_if<std::is_nothrow_copy_constructible<T>::value, std::size_t>::type
+    tryEnqueueCopies(const TItem *items, std::size_t count) {
+      std::size_t index;
+      count = claimSlots(this->tail, count, 0, index);
+
+      for(std::size_t offset = 0; offset < count; ++offset) {
+        new(getItemAddress(index + offset)) TItem(items[offset]);
+      }
+
+      if(count > 0) {
+        publishItems(index, count);
+      }
+      return count;
+    }
+
+    /// <summary>Copies several items into the queue one by one</summary>
+    /// <param name="items">Items that will be copied into the queue</param>
+    /// <param name="count">Number of items that should be copied</param>
+    /// <returns>The number of items that fit into the queue and were added</returns>
+    private: template<typename T = TItem>
+    typename std::enable_if<!std::is_nothrow_copy_constructible<T>::value, std::size_t>::type
+    tryEnqueueCopies(const TItem *items, std::size_t count) {
+      std::size_t addedCount = 0;
+      while((addedCount < count) && tryEnqueueCopy(items[addedCount])) {
+        ++addedCount;
+      }
+
+      return addedCount;
+    }
+
+    /// <summary>Wakes up threads sleeping in a blocking method, if there are any</summary>
+    /// <param name="waitingCount">Number of threads waiting on the condition</param>
+    /// <param name="mutex">Mutex the waiting threads are using</param>
+    /// <param name="condition">Condition variable the waiting threads sleep on</param>
+    /// <remarks>
+    ///   The fence ensures that either the waiting thread sees the slot that has just
+    ///   been published or this thread sees the waiting thread's increment.
+    /// </remarks>
+    private: static void wakeWaitingThreads(
+      const std::atomic<std::size_t> &waitingCount, std::mutex &mutex,
+      std::condition_variable &condition
+    ) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if(unlikely(waitingCount.load(std::memory_order_relaxed) > 0)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        condition.notify_all();
+      }
+    }
+
+    /// <summary>Sleeps until a slot looks ready to be claimed</summary>
+    /// <param name="waitingCount">Number of threads waiting on the condition</param>
+    /// <param name="mutex">Mutex protecting the condition variable</param>
+    /// <param name="condition">Condition variable that will be waited on</param>
+    /// <param name="isReady">Checks whether a slot can be claimed without claiming it</param>
+    /// <remarks>
+    ///   The check must not claim anything itself: claiming may wake other threads,
+    ///   which would need the lock that's being held while checking.
+    /// </remarks>
+    private: template<typename TCheck>
+    static void waitUntil(
+      std::atomic<std::size_t> &waitingCount, std::mutex &mutex,
+      std::condition_variable &condition, TCheck &&isReady
+    ) {
+      std::unique_lock<std::mutex> lock(mutex);
+      waitingCount.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      while(!isReady()) {
+        condition.wait(lock);
+      }
+
+      waitingCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// <summary>Cache-line sized bytes separating the indices</summary>
+    private: typedef std::uint8_t CacheLinePadding[64];
+
+    /// <summary>Number of items the ring can hold, always a power of two</summary>
+    private: std::size_t capacity;
+    /// <summary>Slots holding the items and their sequence numbers</summary>
+    private: std::unique_ptr<Slot[]> slots;
+    /// <summary>Keeps the head index out of the cache line holding the above</summary>
+    private: CacheLinePadding headPadding;
+    /// <summary>Index of the next slot a consumer will take an item from</summary>
+    private: std::atomic<std::size_t> head;
+    /// <summary>Keeps the tail index out of the consumers' cache line</summary>
+    private: CacheLinePadding tailPadding;
+    /// <summary>Index of the next slot a producer will put an item into</summary>
+    private: std::atomic<std::size_t> tail;
+    /// <summary>Keeps the members for blocking waits out of the producers' cache line</summary>
+    private: CacheLinePadding waitPadding;
+    /// <summary>Number of consumers sleeping until an item is added</summary>
+    private: std::atomic<std::size_t> waitingConsumerCount;
+    /// <summary>Number of producers sleeping until space is freed</summary>
+    private: std::atomic<std::size_t> waitingProducerCount;
+    /// <summary>Protects the condition variable consumers sleep on</summary>
+    private: std::mutex consumerMutex;
+    /// <summary>Protects the condition variable producers sleep on</summary>
+    private: std::mutex producerMutex;
+    /// <summary>Signalled when an item was added while consumers were waiting</summary>
+    private: std::condition_variable itemAdded;
+    /// <summary>Signalled when space was freed while producers were waiting</summary>
+    private: std::condition_variable spaceFreed;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
+
+#endif // NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTBOUNDEDQUEUE_H
@@ -0,0 +1,431 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTOBJECTPOOL_H
+#define NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTOBJECTPOOL_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::length_error
+#include <thread> // for std::thread::hardware_concurrency()
+#include <utility> // for std::forward()
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps objects that are expensive to set up around for reuse</summary>
+  /// <typeparam name="TObject">Type of objects the pool will hold</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Objects are lent out through a <see cref="Lease" /> that puts the object back
+  ///     into the pool when it is destroyed. The pool never destroys idle objects, so it
+  ///     ends up holding as many objects as were in use at the same time at most, and
+  ///     it must outlive all of its leases.
+  ///   </para>
+  ///   <para>
+  ///     Returned objects are first parked in a cache slot picked by the returning
+  ///     thread, so a thread that repeatedly takes and returns an object gets the same
+  ///     one back without touching any memory other threads write to. Each slot sits
+  ///     on its own cache line. If the slot is occupied, the object goes onto a Treiber
+  ///     stack shared by all threads, whose head carries a counter that is incremented
+  ///     on each change so a compare-and-swap can't be fooled by an object that was
+  ///     taken and put back in the meantime (the ABA problem).
+  ///   </para>
+  ///   <para>
+  ///     Objects are handed out in the state they were returned in. Users that need
+  ///     a fresh state have to reset the objects themselves.
+  ///   </para>
+  /// </remarks>
+  template<typename TObject>
+  class ConcurrentObjectPool {
+
+    #pragma region class Node
+
+    /// <summary>Entry in the pool that keeps track of one object</summary>
+    private: struct Node {
+
+      /// <summary>Index of the node below this one in the shared stack, plus one</summary>
+      public: std::atomic<std::uint32_t> Next;
+      /// <summary>Index of the node itself</summary>
+      public: std::uint32_t Index;
+      /// <summary>Object owned by the node</summary>
+      public: TObject *Object;
+
+    };
+
+    #pragma endregion // class Node
+
+    #pragma region class Lease
+
+    /// <summary>Object borrowed from the pool, returned when the lease ends</summary>
+    public: class Lease {
+
+      /// <summary>Initializes a new lease that holds no object</summary>
+      public: Lease() :
+        pool(nullptr),
+        node(nullptr) {}
+
+      /// <summary>Takes over the object held by another lease</summary>
+      /// <param name="other">Lease whose object will be taken over</param>
+      public: Lease(Lease &&other) noexcept :
+        pool(other.pool),
+        node(other.node) {
+        other.node = nullptr;
+      }
+
+      /// <summary>Returns the object held by the lease to the pool</summary>
+      public: ~Lease() {
+        if(this->node != nullptr) {
+          this->pool->giveBack(*this->node);
+        }
+      }
+
+      /// <summary>Returns the current object and takes over another lease's object</summary>
+      /// <param name="other">Lease whose object will be taken over</param>
+      /// <returns>This lease</returns>
+      public: Lease &operator =(Lease &&other) noexcept {
+        if(this != &other) {
+          if(this->node != nullptr) {
+            this->pool->giveBack(*this->node);
+          }
+          this->pool = other.pool;
+          this->node = other.node;
+          other.node = nullptr;
+        }
+        return *this;
+      }
+
+      /// <summary>Checks whether the lease holds an object</summary>
+      /// <returns>True if the lease holds an object</returns>
+      public: explicit operator bool() const {
+        return (this->node != nullptr);
+      }
+
+      /// <summary>Retrieves the object held by the lease</summary>
+      /// <returns>The held object or a null pointer if the lease holds none</returns>
+      public: TObject *Get() const {
+        return (this->node == nullptr) ? nullptr : this->node->Object;
+      }
+
+      /// <summary>Accesses the object held by the lease</summary>
+      /// <returns>The object held by the lease</returns>
+      public: TObject &operator *() const { return *this->node->Object; }
+
+      /// <summary>Accesses the members of the object held by the lease</summary>
+      /// <returns>The object held by the lease</returns>
+      public: TObject *operator ->() const { return this->node->Object; }
+
+      /// <summary>Initializes a new lease for an object taken from the pool</summary>
+      /// <param name="pool">Pool that will get the object back</param>
+      /// <param name="node">Node through which the pool tracks the object</param>
+      private: Lease(ConcurrentObjectPool &pool, Node &node) :
+        pool(&pool),
+        node(&node) {}
+
+      private: Lease(const Lease &) = delete;
+      private: Lease &operator =(const Lease &) = delete;
+
+      /// <summary>Pool the object will be returned to</summary>
+      private: ConcurrentObjectPool *pool;
+      /// <summary>Node through which the pool tracks the object</summary>
+      private: Node *node;
+
+      friend class ConcurrentObjectPool;
+
+    };
+
+    #pragma endregion // class Lease
+
+    /// <summary>Initializes a new, empty object pool</summary>
+    public: ConcurrentObjectPool() :
+      threadCacheCount(getNextPowerOfTwo(std::thread::hardware_concurrency())),
+      threadCaches(new ThreadCache[getNextPowerOfTwo(std::thread::hardware_concurrency())]),
+      head(0),
+      nodeCount(0) {
+      for(std::size_t index = 0; index < this->threadCacheCount; ++index) {
+        this->threadCaches[index].NodeIndex.store(0, std::memory_order_relaxed);
+      }
+      for(std::size_t index = 0; index < SegmentCount; ++index) {
+        this->segments[index].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    /// <summary>Destroys the pool and all objects in it</summary>
+    /// <remarks>All leases have to have ended before the pool is destroyed</remarks>
+    public: ~ConcurrentObjectPool() {
+      for(std::size_t index = 0; index < SegmentCount; ++index) {
+        Node *segment = this->segments[index].load(std::memory_order_acquire);
+        if(segment != nullptr) {
+          std::size_t segmentLength = std::size_t(FirstSegmentLength) << index;
+          for(std::size_t nodeIndex = 0; nodeIndex < segmentLength; ++nodeIndex) {
+            delete segment[nodeIndex].Object;
+          }
+          delete[] segment;
+        }
+      }
+    }
+
+    /// <summary>Counts the objects the pool has created so far</summary>
+    /// <returns>The number of objects in the pool, whether lent out or idle</returns>
+    public: std::size_t CountObjects() const {
+      return this->nodeCount.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Borrows an idle object from the pool if there is one</summary>
+    /// <returns>A lease for the object or an empty lease if no object was idle</returns>
+    public: Lease TryTake() {
+      Node *node = takeIdleNode();
+      if(node == nullptr) {
+        return Lease();
+      } else {
+        return Lease(*this, *node);
+      }
+    }
+
+    /// <summary>Borrows an idle object from the pool or creates a new one</summary>
+    /// <typeparam name="TArguments">Types of the arguments for a new object</typeparam>
+    /// <param name="arguments">Arguments that will be passed to a new object</param>
+    /// <returns>A lease for the object</returns>
+    /// <remarks>
+    ///   The arguments are only used if a new object needs to be created
+    /// </remarks>
+    public: template<typename... TArguments>
+    Lease Take(TArguments &&... arguments) {
+      Node *node = takeIdleNode();
+      if(node == nullptr) {
+        std::unique_ptr<TObject> object(new TObject(std::forward<TArguments>(arguments)...));
+        node = &addNode(*object);
+        object.release();
+      }
+
+      return Lease(*this, *node);
+    }
+
+    /// <summary>Slot in which a thread parks the last object it returned</summary>
+    private: struct ThreadCache {
+
+      /// <summary>Index of the parked node plus one or zero if the slot is empty</summary>
+      public: std::atomic<std::uint32_t> NodeIndex;
+      /// <summary>Keeps the slots of different threads on different cache lines</summary>
+      public: std::uint8_t Padding[64 - sizeof(std::atomic<std::uint32_t>)];
+
+    };
+
+    /// <summary>Number of nodes in the first segment</summary>
+    private: static const std::size_t FirstSegmentLength = 32;
+    /// <summary>Number of segments, each twice as long as the one before</summary>
+    /// <remarks>Enough for one node per 32 bit index</remarks>
+    private: static const std::size_t SegmentCount = 27;
+
+    /// <summary>Calculates the next power of two for the specified value</summary>
+    /// <param name="value">Value of which the next power of two will be calculated</param>
+    /// <returns>The next power of two to the specified value, at least 4</returns>
+    private: static std::size_t getNextPowerOfTwo(std::size_t value) {
+      std::size_t powerOfTwo = 4;
+      while(powerOfTwo < value) {
+        powerOfTwo <<= 1;
+      }
+
+      return powerOfTwo;
+    }
+
+    /// <summary>Looks up the cache slot the calling thread uses</summary>
+    /// <returns>The cache slot of the calling thread</returns>
+    /// <remarks>
+    ///   Threads are numbered in the order they first come here. Once there are more
+    ///   threads than slots, threads share slots, which still works, just less well.
+    /// </remarks>
+    private: ThreadCache &getThreadCache() const {
+      static std::atomic<std::size_t> nextThreadNumber(0);
+      static thread_local std::size_t threadNumber = nextThreadNumber.fetch_add(
+        1, std::memory_order_relaxed
+      );
+
+      return this->threadCaches[threadNumber & (this->threadCacheCount - 1)];
+    }
+
+    /// <summary>Looks up the node with the specified index</summary>
+    /// <param name="index">Index of the node that will be looked up</param>
+    /// <returns>The node with the specified index</returns>
+    private: Node &getNode(std::size_t index) const {
+      std::size_t segmentIndex = 0;
+      std::size_t firstIndex = 0;
+      while(index - firstIndex >= (std::size_t(FirstSegmentLength) << segmentIndex)) {
+        firstIndex += (std::size_t(FirstSegmentLength) << segmentIndex);
+        ++segmentIndex;
+      }
+
+      Node *segment = this->segments[segmentIndex].load(std::memory_order_acquire);
+      return segment[index - firstIndex];
+    }
+
+    /// <summary>Creates a new node that owns the specified object</summary>
+    /// <param name="object">Object the node will take ownership of</param>
+    /// <returns>The new node</returns>
+    /// <remarks>Only takes ownership of the object if no exception is thrown</remarks>
+    private: Node &addNode(TObject &object) {
+      std::size_t index = this->nodeCount.fetch_add(1, std::memory_order_relaxed);
+
+      std::size_t segmentIndex = 0;
+      std::size_t firstIndex = 0;
+      while(index - firstIndex >= (std::size_t(FirstSegmentLength) << segmentIndex)) {
+        firstIndex += (std::size_t(FirstSegmentLength) << segmentIndex);
+        ++segmentIndex;
+        if(segmentIndex >= SegmentCount) {
+          this->nodeCount.fetch_sub(1, std::memory_order_relaxed);
+          throw std::length_error(u8"Object pool cannot hold any more objects");
+        }
+      }
+
+      // The first thread to need a segment allocates it. Nodes in it are zero-initialized,
+      // so if creating an object fails after its index was claimed, the node stays empty
+      Node *segment = this->segments[segmentIndex].load(std::memory_order_acquire);
+      if(segment == nullptr) {
+        std::unique_ptr<Node[]> newSegment(
+          new Node[std::size_t(FirstSegmentLength) << segmentIndex]()
+        );
+        if(
+          this->segments[segmentIndex].compare_exchange_strong(
+            segment, newSegment.get(), std::memory_order_acq_rel, std::memory_order_acquire
+          )
+        ) {
+          segment = newSegment.release();
+        }
+      }
+
+      Node &node = segment[index - firstIndex];
+      node.Index = static_cast<std::uint32_t>(index);
+      node.Object = &object;
+      return node;
+    }
+
+    /// <summary>Takes an idle node from the thread's cache slot or the shared stack</summary>
+    /// <returns>An idle node or a null pointer if there were no idle nodes</returns>
+    private: Node *takeIdleNode() {
+      ThreadCache &cache = getThreadCache();
+      std::uint32_t nodeIndex = 0;
+      if(cache.NodeIndex.load(std::memory_order_relaxed) != 0) {
+        nodeIndex = cache.NodeIndex.exchange(0, std::memory_order_acquire);
+      }
+      if(nodeIndex == 0) {
+        nodeIndex = pop();
+        if(nodeIndex == 0) {
+          return nullptr;
+        }
+      }
+
+      return &getNode(nodeIndex - 1);
+    }
+
+    /// <summary>Puts a node back into the thread's cache slot or the shared stack</summary>
+    /// <param name="node">Node that will be put back</param>
+    private: void giveBack(Node &node) {
+      ThreadCache &cache = getThreadCache();
+      std::uint32_t emptyIndex = 0;
+      bool isParked = (
+        (cache.NodeIndex.load(std::memory_order_relaxed) == 0) &&
+        cache.NodeIndex.compare_exchange_strong(
+          emptyIndex, node.Index + 1, std::memory_order_release, std::memory_order_relaxed
+        )
+      );
+      if(!isParked) {
+        push(node);
+      }
+    }
+
+    /// <summary>Pushes a node onto the shared stack</summary>
+    /// <param name="node">Node that will be pushed</param>
+    private: void push(Node &node) {
+      std::uint64_t top = this->head.load(std::memory_order_relaxed);
+      for(;;) {
+        node.Next.store(static_cast<std::uint32_t>(top), std::memory_order_relaxed);
+        std::uint64_t newTop = (
+          (((top >> 32) + 1) << 32) | static_cast<std::uint64_t>(node.Index + 1)
+        );
+        if(
+          this->head.compare_exchange_weak(
+            top, newTop, std::memory_order_release, std::memory_order_relaxed
+          )
+        ) {
+          return;
+        }
+      }
+    }
+
+    /// <summary>Pops a node from the shared stack</summary>
+    /// <returns>The index of the popped node plus one or zero if the stack was empty</returns>
+    /// <remarks>
+    ///   The node below may already have been popped and pushed elsewhere by another
+    ///   thread when it is read here. Nodes are never freed while the pool exists and
+    ///   the counter in the head lets the compare-and-swap fail in that case.
+    /// </remarks>
+    private: std::uint32_t pop() {
+      std::uint64_t top = this->head.load(std::memory_order_acquire);
+      for(;;) {
+        std::uint32_t nodeIndex = static_cast<std::uint32_t>(top);
+        if(nodeIndex == 0) {
+          return 0;
+        }
+
+        std::uint32_t next = getNode(nodeIndex - 1).Next.load(std::memory_order_relaxed);
+        std::uint64_t newTop = ((((top >> 32) + 1) << 32) | next);
+        if(
+          this->head.compare_exchange_weak(
+            top, newTop, std::memory_order_acquire, std::memory_order_acquire
+          )
+        ) {
+          return nodeIndex;
+        }
+      }
+    }
+
+    private: ConcurrentObjectPool(const ConcurrentObjectPool &) = delete;
+    private: ConcurrentObjectPool &operator =(const ConcurrentObjectPool &) = delete;
+
+    /// <summary>Used to keep the shared stack and node counter on their own cache lines</summary>
+    private: typedef std::uint8_t CacheLinePadding[64];
+
+    /// <summary>Number of cache slots, always a power of two</summary>
+    private: const std::size_t threadCacheCount;
+    /// <summary>Cache slots in which threads park the last object they returned</summary>
+    private: std::unique_ptr<ThreadCache[]> threadCaches;
+    /// <summary>Segments holding the nodes, each twice as long as the one before</summary>
+    private: std::atomic<Node *> segments[SegmentCount];
+    /// <summary>Keeps the head of the shared stack off the segment table's cache line</summary>
+    private: CacheLinePadding headPadding;
+    /// <summary>Change counter (upper 32 bits) and top node index + 1 (lower 32 bits)</summary>
+    private: std::atomic<std::uint64_t> head;
+    /// <summary>Keeps the node counter off the head's cache line</summary>
+    private: CacheLinePadding countPadding;
+    /// <summary>Number of nodes that have been created</summary>
+    private: std::atomic<std::size_t> nodeCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
+
+#endif // NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTOBJECTPOOL_H
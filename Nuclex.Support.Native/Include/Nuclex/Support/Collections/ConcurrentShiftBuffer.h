@@ -0,0 +1,419 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTSHIFTBUFFER_H
+#define NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTSHIFTBUFFER_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+#include <cstring> // for std::memcpy()
+#include <memory> // for std::unique_ptr
+#include <type_traits> // for std::enable_if<>
+#include <utility> // for std::move()
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Batch FIFO through which one thread can hand items to another thread</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Offers the batch operations of the <see cref="ShiftBuffer" /> to exactly one
+  ///     producer thread (calling <see cref="Write" /> and <see cref="Shove" />) and
+  ///     exactly one consumer thread (calling <see cref="Access" />, <see cref="Read" />
+  ///     and <see cref="Skip" />) at the same time without any locks. Neither thread
+  ///     ever waits for the other.
+  ///   </para>
+  ///   <para>
+  ///     The items are kept in a ring whose size is fixed when the buffer is constructed
+  ///     (rounded up to a power of two). The producer and the consumer each own one
+  ///     index into the ring and publish it with release semantics after they're done
+  ///     constructing or destroying items, the other side picks it up with acquire
+  ///     semantics. Because the buffer can't grow, writes store as many items as fit
+  ///     and reads take as many items as are available, both returning the number of
+  ///     items they actually processed.
+  ///   </para>
+  ///   <para>
+  ///     Unlike the <see cref="ShiftBuffer" />, the items can wrap around the end of
+  ///     the ring, so <see cref="Access" /> only provides the oldest items up to
+  ///     that point.
+  ///   </para>
+  ///   <para>
+  ///     This class offers the <em>basic</em> exception guarantee: if your items throw
+  ///     in their copy or move constructors, all items transferred before the exception
+  ///     remain in the buffer (or have been read from it) and nothing is leaked.
+  ///   </para>
+  /// </remarks>
+  template<typename TItem>
+  class ConcurrentShiftBuffer {
+
+    /// <summary>Initializes a new concurrent shift buffer</summary>
+    /// <param name="capacity">Number of items the buffer will be able to hold</param>
+    public: ConcurrentShiftBuffer(std::size_t capacity = 256) :
+      itemMemory(new std::uint8_t[sizeof(TItem[2]) * getNextPowerOfTwo(capacity) / 2]),
+      capacity(getNextPowerOfTwo(capacity)),
+      readIndex(0),
+      writeIndex(0) {}
+
+    /// <summary>Destroys the buffer and all items still in it</summary>
+    public: ~ConcurrentShiftBuffer() {
+      skipItems(
+        this->readIndex.load(std::memory_order_relaxed),
+        this->writeIndex.load(std::memory_order_acquire) -
+        this->readIndex.load(std::memory_order_relaxed)
+      );
+    }
+
+    /// <summary>Returns the number of items the buffer can hold</summary>
+    /// <returns>The maximum number of items that can be in the buffer at once</returns>
+    public: std::size_t GetCapacity() const {
+      return this->capacity;
+    }
+
+    /// <summary>Counts the number of items currently stored in the buffer</summary>
+    /// <returns>The number of items in the buffer at the time of the call</returns>
+    /// <remarks>
+    ///   If the other thread is busy, the count may already be outdated when this method
+    ///   returns. The producer can rely on at least as much free space as the count
+    ///   implies, the consumer on at least as many items being available.
+    /// </remarks>
+    public: std::size_t Count() const {
+      std::size_t consumerIndex = this->readIndex.load(std::memory_order_acquire);
+      return this->writeIndex.load(std::memory_order_acquire) - consumerIndex;
+    }
+
+    /// <summary>Provides direct read access to the oldest items in the buffer</summary>
+    /// <param name="itemCount">
+    ///   Receives the number of items that can be accessed through the returned pointer
+    /// </param>
+    /// <returns>A pointer to the oldest item in the buffer</returns>
+    /// <remarks>
+    ///   Only to be called from the consumer thread. If the items wrap around the end of
+    ///   the ring, fewer items than are in the buffer are provided. After skipping them,
+    ///   the next call will provide the remaining items.
+    /// </remarks>
+    public: const TItem *Access(std::size_t &itemCount) const {
+      std::size_t consumerIndex = this->readIndex.load(std::memory_order_relaxed);
+      std::size_t availableCount = (
+        this->writeIndex.load(std::memory_order_acquire) - consumerIndex
+      );
+
+      std::size_t ringIndex = consumerIndex & (this->capacity - 1);
+      std::size_t contiguousCount = this->capacity - ringIndex;
+      itemCount = (availableCount < contiguousCount) ? availableCount : contiguousCount;
+
+      return reinterpret_cast<const TItem *>(this->itemMemory.get()) + ringIndex;
+    }
+
+    /// <summary>Skips up to the specified number of items</summary>
+    /// <param name="skipItemCount">Number of items that will be skipped</param>
+    /// <returns>The number of items that were actually skipped</returns>
+    /// <remarks>Only to be called from the consumer thread</remarks>
+    public: std::size_t Skip(std::size_t skipItemCount) {
+      std::size_t consumerIndex = this->readIndex.load(std::memory_order_relaxed);
+      skipItemCount = limitToAvailableItems(consumerIndex, skipItemCount);
+
+      skipItems(consumerIndex, skipItemCount);
+      this->readIndex.store(consumerIndex + skipItemCount, std::memory_order_release);
+
+      return skipItemCount;
+    }
+
+    /// <summary>Reads items out of the buffer, starting with the oldest item</summary>
+    /// <param name="items">Memory to which the items will be moved</param>
+    /// <param name="count">Maximum number of items that will be read from the buffer</param>
+    /// <returns>The number of items that were actually read</returns>
+    /// <remarks>Only to be called from the consumer thread</remarks>
+    public: std::size_t Read(TItem *items, std::size_t count) {
+      std::size_t consumerIndex = this->readIndex.load(std::memory_order_relaxed);
+      count = limitToAvailableItems(consumerIndex, count);
+
+      std::size_t extractedCount = 0;
+      try {
+        extractItems(consumerIndex, items, count, extractedCount);
+      }
+      catch(...) {
+        this->readIndex.store(consumerIndex + extractedCount, std::memory_order_release);
+        throw;
+      }
+      this->readIndex.store(consumerIndex + count, std::memory_order_release);
+
+      return count;
+    }
+
+    /// <summary>Copies up to the specified number of items into the buffer</summary>
+    /// <param name="items">Items that will be copied into the buffer</param>
+    /// <param name="count">Number of items that should be copied</param>
+    /// <returns>The number of items that fit into the buffer and were copied</returns>
+    /// <remarks>Only to be called from the producer thread</remarks>
+    public: std::size_t Write(const TItem *items, std::size_t count) {
+      std::size_t producerIndex = this->writeIndex.load(std::memory_order_relaxed);
+      count = limitToFreeSpace(producerIndex, count);
+
+      std::size_t emplacedCount = 0;
+      try {
+        emplaceItems(producerIndex, items, count, emplacedCount);
+      }
+      catch(...) {
+        this->writeIndex.store(producerIndex + emplacedCount, std::memory_order_release);
+        throw;
+      }
+      this->writeIndex.store(producerIndex + count, std::memory_order_release);
+
+      return count;
+    }
+
+    /// <summary>Moves up to the specified number of items into the buffer</summary>
+    /// <param name="items">Items that will be moved into the buffer</param>
+    /// <param name="count">Number of items that should be moved</param>
+    /// <returns>The number of items that fit into the buffer and were moved</returns>
+    /// <remarks>Only to be called from the producer thread</remarks>
+    public: std::size_t Shove(TItem *items, std::size_t count) {
+      std::size_t producerIndex = this->writeIndex.load(std::memory_order_relaxed);
+      count = limitToFreeSpace(producerIndex, count);
+
+      std::size_t emplacedCount = 0;
+      try {
+        moveEmplaceItems(producerIndex, items, count, emplacedCount);
+      }
+      catch(...) {
+        this->writeIndex.store(producerIndex + emplacedCount, std::memory_order_release);
+        throw;
+      }
+      this->writeIndex.store(producerIndex + count, std::memory_order_release);
+
+      return count;
+    }
+
+    /// <summary>Calculates the next power of two for the specified value</summary>
+    /// <param name="value">Value of which the next power of two will be calculated</param>
+    /// <returns>The next power of two to the specified value</returns>
+    private: static std::size_t getNextPowerOfTwo(std::size_t value) {
+      std::size_t powerOfTwo = 1;
+      while(powerOfTwo < value) {
+        powerOfTwo <<= 1;
+      }
+
+      return powerOfTwo;
+    }
+
+    /// <summary>Limits an item count to the number of items the consumer can take</summary>
+    /// <param name="consumerIndex">Current read index of the consumer</param>
+    /// <param name="itemCount">Number of items the consumer would like to take</param>
+    /// <returns>The number of items the consumer can take</returns>
+    private: std::size_t limitToAvailableItems(
+      std::size_t consumerIndex, std::size_t itemCount
+    ) const {
+      std::size_t availableCount = (
+        this->writeIndex.load(std::memory_order_acquire) - consumerIndex
+      );
+      return (itemCount < availableCount) ? itemCount : availableCount;
+    }
+
+    /// <summary>Limits an item count to the number of items the producer can store</summary>
+    /// <param name="producerIndex">Current write index of the producer</param>
+    /// <param name="itemCount">Number of items the producer would like to store</param>
+    /// <returns>The number of items the producer can store</returns>
+    private: std::size_t limitToFreeSpace(
+      std::size_t producerIndex, std::size_t itemCount
+    ) const {
+      std::size_t freeCount = this->capacity - (
+        producerIndex - this->readIndex.load(std::memory_order_acquire)
+      );
+      return (itemCount < freeCount) ? itemCount : freeCount;
+    }
+
+    /// <summary>Returns the address of the item at an index</summary>
+    /// <param name="index">Read or write index that will be looked up in the ring</param>
+    /// <returns>The address of the item the index points to</returns>
+    private: TItem *getItemAddress(std::size_t index) const {
+      return reinterpret_cast<TItem *>(this->itemMemory.get()) + (index & (this->capacity - 1));
+    }
+
+    /// <summary>Copies the specified items into the free space of the ring</summary>
+    /// <param name="producerIndex">Index at which the first item will be placed</param>
+    /// <param name="sourceItems">Items that will be copied into the ring</param>
+    /// <param name="itemCount">Number of items that will be copied</param>
+    /// <param name="emplacedCount">Receives the number of items copied so far</param>
+    private: template<typename T = TItem>
+    typename std::enable_if<!std::is_trivially_copyable<T>::value>::type emplaceItems(
+      std::size_t producerIndex, const TItem *sourceItems, std::size_t itemCount,
+      std::size_t &emplacedCount
+    ) {
+      while(emplacedCount < itemCount) {
+        new(getItemAddress(producerIndex + emplacedCount)) TItem(*sourceItems);
+        ++sourceItems;
+        ++emplacedCount;
+      }
+    }
+
+    /// <summary>Copies the specified items into the free space of the ring</summary>
+    /// <param name="producerIndex">Index at which the first item will be placed</param>
+    /// <param name="sourceItems">Items that will be copied into the ring</param>
+    /// <param name="itemCount">Number of items that will be copied</param>
+    /// <param name="emplacedCount">Receives the number of items copied so far</param>
+    private: template<typename T = TItem>
+    typename std::enable_if<std::is_trivially_copyable<T>::value>::type emplaceItems(
+      std::size_t producerIndex, const TItem *sourceItems, std::size_t itemCount,
+      std::size_t &emplacedCount
+    ) {
+      std::size_t ringIndex = producerIndex & (this->capacity - 1);
+      std::size_t firstCount = this->capacity - ringIndex;
+      if(firstCount > itemCount) {
+        firstCount = itemCount;
+      }
+
+      // Copy up to the end of the ring, then whatever wraps around to its beginning
+      TItem *items = reinterpret_cast<TItem *>(this->itemMemory.get());
+      std::memcpy(items + ringIndex, sourceItems, firstCount * sizeof(TItem));
+      std::memcpy(items, sourceItems + firstCount, (itemCount - firstCount) * sizeof(TItem));
+      emplacedCount = itemCount;
+    }
+
+    /// <summary>Moves the specified items into the free space of the ring</summary>
+    /// <param name="producerIndex">Index at which the first item will be placed</param>
+    /// <param name="sourceItems">Items that will be moved into the ring</param>
+    /// <param name="itemCount">Number of items that will be moved</param>
+    /// <param name="emplacedCount">Receives the number of items moved so far</param>
+    private: template<typename T = TItem>
+    typename std::enable_if<!std::is_trivially_copyable<T>::value>::type moveEmplaceItems(
+      std::size_t producerIndex, TItem *sourceItems, std::size_t itemCount,
+      std::size_t &emplacedCount
+    ) {
+      while(emplacedCount < itemCount) {
+        new(getItemAddress(producerIndex + emplacedCount)) TItem(std::move(*sourceItems));
+        // no d'tor call here, source isn't ours and will be destroyed externally
+        ++sourceItems;
+        ++emplacedCount;
+      }
+    }
+
+    /// <summary>Moves the specified items into the free space of the ring</summary>
+    /// <param name="producerIndex">Index at which the first item will be placed</param>
+    /// <param name="sourceItems">Items that will be moved into the ring</param>
+    /// <param name="itemCount">Number of items that will be moved</param>
+    /// <param name="emplacedCount">Receives the number of items moved so far</param>
+    private: template<typename T = TItem>
+    typename std::enable_if<std::is_trivially_copyable<T>::value>::type moveEmplaceItems(
+      std::size_t producerIndex, TItem *sourceItems, std::size_t itemCount,
+      std::size_t &emplacedCount
+    ) {
+      emplaceItems(producerIndex, sourceItems, itemCount, emplacedCount);
+    }
+
+    /// <summary>Takes the specified number of items out of the ring</summary>
+    /// <param name="consumerIndex">Index of the first item that will be taken</param>
+    /// <param name="targetItems">Address at which the items will be placed</param>
+    /// <param name="itemCount">Number of items that will be extracted</param>
+    /// <param name="extractedCount">Receives the number of items extracted so far</param>
+    private: template<typename T = TItem>
+    typename std::enable_if<
+      !std::is_trivially_copyable<T>::value || !std::is_trivially_destructible<T>::value
+    >::type extractItems(
+      std::size_t consumerIndex, TItem *targetItems, std::size_t itemCount,
+      std::size_t &extractedCount
+    ) {
+      while(extractedCount < itemCount) {
+        TItem *sourceItem = getItemAddress(consumerIndex + extractedCount);
+        *targetItems = std::move(*sourceItem);
+        sourceItem->~TItem();
+        ++targetItems;
+        ++extractedCount;
+      }
+    }
+
+    /// <summary>Takes the specified number of items out of the ring</summary>
+    /// <param name="consumerIndex">Index of the first item that will be taken</param>
+    /// <param name="targetItems">Address at which the items will be placed</param>
+    /// <param name="itemCount">Number of items that will be extracted</param>
+    /// <param name="extractedCount">Receives the number of items extracted so far</param>
+    private: template<typename T = TItem>
+    typename std::enable_if<
+      std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value
+    >::type extractItems(
+      std::size_t consumerIndex, TItem *targetItems, std::size_t itemCount,
+      std::size_t &extractedCount
+    ) {
+      std::size_t ringIndex = consumerIndex & (this->capacity - 1);
+      std::size_t firstCount = this->capacity - ringIndex;
+      if(firstCount > itemCount) {
+        firstCount = itemCount;
+      }
+
+      // Copy up to the end of the ring, then whatever wrapped around to its beginning
+      const TItem *items = reinterpret_cast<const TItem *>(this->itemMemory.get());
+      std::memcpy(targetItems, items + ringIndex, firstCount * sizeof(TItem));
+      std::memcpy(targetItems + firstCount, items, (itemCount - firstCount) * sizeof(TItem));
+      extractedCount = itemCount;
+    }
+
+    /// <summary>Destroys the specified number of items in the ring</summary>
+    /// <param name="consumerIndex">Index of the first item that will be destroyed</param>
+    /// <param name="itemCount">Number of items that will be destroyed</param>
+    private: template<typename T = TItem>
+    typename std::enable_if<!std::is_trivially_destructible<T>::value>::type skipItems(
+      std::size_t consumerIndex, std::size_t itemCount
+    ) {
+      for(std::size_t index = 0; index < itemCount; ++index) {
+        getItemAddress(consumerIndex + index)->~TItem();
+      }
+    }
+
+    /// <summary>Destroys the specified number of items in the ring</summary>
+    /// <param name="consumerIndex">Index of the first item that will be destroyed</param>
+    /// <param name="itemCount">Number of items that will be destroyed</param>
+    /// <remarks>
+    ///   Storage occupied by trivially destructible objects may be reused without
+    ///   calling the destructor - so we don't.
+    /// </remarks>
+    private: template<typename T = TItem>
+    typename std::enable_if<std::is_trivially_destructible<T>::value>::type skipItems(
+      std::size_t consumerIndex, std::size_t itemCount
+    ) {
+      (void)consumerIndex;
+      (void)itemCount;
+    }
+
+    /// <summary>Cache-line sized bytes separating the indices</summary>
+    private: typedef std::uint8_t CacheLinePadding[64];
+
+    /// <summary>Holds the items stored in the ring</summary>
+    private: std::unique_ptr<std::uint8_t[]> itemMemory;
+    /// <summary>Number of items the ring can hold, always a power of two</summary>
+    private: std::size_t capacity;
+    /// <summary>Keeps the consumer's index out of the cache line holding the above</summary>
+    private: CacheLinePadding readPadding;
+    /// <summary>Number of items the consumer has taken out of the ring so far</summary>
+    private: std::atomic<std::size_t> readIndex;
+    /// <summary>Keeps the producer's index out of the consumer's cache line</summary>
+    private: CacheLinePadding writePadding;
+    /// <summary>Number of items the producer has placed into the ring so far</summary>
+    private: std::atomic<std::size_t> writeIndex;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
+
+#endif // NUCLEX_SUPPORT_COLLECTIONS_CONCURRENTSHIFTBUFFER_H
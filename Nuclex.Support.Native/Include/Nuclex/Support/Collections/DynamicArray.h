@@ -25,6 +25,7 @@ License along with this library
 #include "Nuclex/Support/Collections/IndexedCollection.h"
 
 #include <vector>
+#include <utility> // for std::move(), std::forward()
 
 namespace Nuclex { namespace Support { namespace Collections {
 
@@ -84,6 +85,26 @@ namespace Nuclex { namespace Support { namespace Collections {
       return this->items.at(index);
     }
 
+    /// <summary>Looks up how many items follow an index without gaps in memory</summary>
+    /// <param name="index">Index of the first item that will be accessed</param>
+    /// <param name="firstItem">Receives the address of the item at the specified index</param>
+    /// <returns>The number of items from the specified index to the end of the array</returns>
+    public: std::size_t GetContiguousRange(
+      std::size_t index, const TValue *&firstItem
+    ) const override {
+      firstItem = &this->items.at(index);
+      return this->items.size() - index;
+    }
+
+    /// <summary>Looks up how many items follow an index without gaps in memory</summary>
+    /// <param name="index">Index of the first item that will be accessed</param>
+    /// <param name="firstItem">Receives the address of the item at the specified index</param>
+    /// <returns>The number of items from the specified index to the end of the array</returns>
+    public: std::size_t GetContiguousRange(std::size_t index, TValue *&firstItem) override {
+      firstItem = &this->items.at(index);
+      return this->items.size() - index;
+    }
+
     /// <summary>Assigns the specified item to the specified index</summary>
     /// <param name="index">Index at which the item will be stored</param>
     /// <param name="value">Item that will be stored at the specified index</param>
@@ -91,6 +112,13 @@ namespace Nuclex { namespace Support { namespace Collections {
       this->items.at(index) = value;
     }
 
+    /// <summary>Moves the specified item into the specified index</summary>
+    /// <param name="index">Index at which the item will be stored</param>
+    /// <param name="value">Item that will be moved to the specified index</param>
+    public: void SetAt(std::size_t index, TValue &&value) override {
+      this->items.at(index) = std::move(value);
+    }
+
     /// <summary>Inserts the specified item at a specified index</summary>
     /// <param name="index">Index at which the item will be inserted</param>
     /// <param name="value">Item that will be inserted into the collection</param>
@@ -99,6 +127,24 @@ namespace Nuclex { namespace Support { namespace Collections {
       this->items.insert(where, value);
     }
 
+    /// <summary>Moves the specified item into the collection at a specified index</summary>
+    /// <param name="index">Index at which the item will be inserted</param>
+    /// <param name="value">Item that will be moved into the collection</param>
+    public: void InsertAt(std::size_t index, TValue &&value) override {
+      typename std::vector<TValue>::iterator where = this->items.begin() + index;
+      this->items.insert(where, std::move(value));
+    }
+
+    /// <summary>Constructs a new item in the collection at the specified index</summary>
+    /// <typeparam name="TArguments">Types of the arguments for the item's constructor</typeparam>
+    /// <param name="index">Index at which the item will be inserted</param>
+    /// <param name="arguments">Arguments that will be passed to the item's constructor</param>
+    public: template<typename... TArguments>
+    void EmplaceAt(std::size_t index, TArguments &&... arguments) {
+      typename std::vector<TValue>::iterator where = this->items.begin() + index;
+      this->items.emplace(where, std::forward<TArguments>(arguments)...);
+    }
+
     /// <summary>Removes the item at the specified index from the collection</summary>
     /// <param name="index">Index at which the item will be removed</param>
     public: void RemoveAt(std::size_t index) override {
@@ -112,6 +158,20 @@ namespace Nuclex { namespace Support { namespace Collections {
       this->items.push_back(item);
     }
 
+    /// <summary>Moves the specified item into the collection</summary>
+    /// <param name="item">Item that will be moved into the collection</param>
+    public: void Add(TValue &&item) override {
+      this->items.push_back(std::move(item));
+    }
+
+    /// <summary>Constructs a new item at the end of the collection</summary>
+    /// <typeparam name="TArguments">Types of the arguments for the item's constructor</typeparam>
+    /// <param name="arguments">Arguments that will be passed to the item's constructor</param>
+    public: template<typename... TArguments>
+    void Emplace(TArguments &&... arguments) {
+      this->items.emplace_back(std::forward<TArguments>(arguments)...);
+    }
+
     /// <summary>Removes the specified item from the collection</summary>
     /// <param name="item">Item that will be removed from the collection</param>
     /// <returns>True if the item existed in the collection and was removed</returns>
@@ -0,0 +1,512 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_COLLECTIONS_FLATHASHMAP_H
+#define NUCLEX_SUPPORT_COLLECTIONS_FLATHASHMAP_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <memory> // for std::unique_ptr
+#include <functional> // for std::hash, std::equal_to
+#include <type_traits> // for std::aligned_storage
+#include <utility> // for std::move(), std::forward()
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hash map that stores all of its entries in one linear block of memory</summary>
+  /// <typeparam name="TKey">Type of the keys used to look up values</typeparam>
+  /// <typeparam name="TValue">Type of the values stored in the map</typeparam>
+  /// <typeparam name="THash">Functor that calculates the hash of a key</typeparam>
+  /// <typeparam name="TEqual">Functor that checks two keys for equality</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     std::unordered_map allocates a node for every entry and has to chase a pointer
+  ///     on each lookup. This map uses open addressing with linear probing instead: all
+  ///     entries live in one array and a lookup scans neighbouring slots, which usually
+  ///     are in the same cache line. The map is kept at most three quarters full.
+  ///   </para>
+  ///   <para>
+  ///     The hash of each entry is stored next to it, so growing the map doesn't need to
+  ///     hash the keys again and most failed comparisons are decided without calling
+  ///     the equality functor. Removal shifts the following entries back instead of
+  ///     leaving tombstones, so lookups don't get slower after many removals.
+  ///   </para>
+  ///   <para>
+  ///     Unlike std::unordered_map, pointers to values are invalidated whenever
+  ///     an entry is added or removed. This class offers the <em>basic</em> exception
+  ///     guarantee.
+  ///   </para>
+  /// </remarks>
+  template<
+    typename TKey, typename TValue,
+    typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>
+  >
+  class FlatHashMap {
+
+    /// <summary>Initializes a new flat hash map</summary>
+    /// <param name="capacity">Number of entries the map should have space for</param>
+    public: explicit FlatHashMap(std::size_t capacity = 0) :
+      hashes(),
+      entries(),
+      capacity(0),
+      shift(sizeof(std::size_t) * 8),
+      count(0) {
+      if(capacity > 0) {
+        Reserve(capacity);
+      }
+    }
+
+    /// <summary>Initializes a flat hash map as a copy of another flat hash map</summary>
+    /// <param name="other">Other flat hash map that will be copied</param>
+    public: FlatHashMap(const FlatHashMap &other) :
+      hashes(),
+      entries(),
+      capacity(0),
+      shift(sizeof(std::size_t) * 8),
+      count(0) {
+      if(other.count > 0) {
+        Reserve(other.count);
+        other.ForEach(
+          [this](const TKey &key, const TValue &value) { TryInsert(key, value); }
+        );
+      }
+    }
+
+    /// <summary>Initializes a flat hash map taking over another flat hash map</summary>
+    /// <param name="other">Other flat hash map that will be taken over</param>
+    public: FlatHashMap(FlatHashMap &&other) :
+      hashes(std::move(other.hashes)),
+      entries(std::move(other.entries)),
+      capacity(other.capacity),
+      shift(other.shift),
+      count(other.count) {
+      other.capacity = 0;
+      other.shift = sizeof(std::size_t) * 8;
+      other.count = 0;
+    }
+
+    /// <summary>Destroys the flat hash map and all entries in it</summary>
+    public: ~FlatHashMap() {
+      destroyEntries();
+    }
+
+    /// <summary>Replaces the contents of the map with copies of another map's entries</summary>
+    /// <param name="other">Other flat hash map whose entries will be copied</param>
+    /// <returns>The flat hash map itself</returns>
+    public: FlatHashMap &operator =(const FlatHashMap &other) {
+      if(&other != this) {
+        Clear();
+        Reserve(other.count);
+        other.ForEach(
+          [this](const TKey &key, const TValue &value) { TryInsert(key, value); }
+        );
+      }
+      return *this;
+    }
+
+    /// <summary>Replaces the contents of the map with another map's entries</summary>
+    /// <param name="other">Other flat hash map whose entries will be taken over</param>
+    /// <returns>The flat hash map itself</returns>
+    public: FlatHashMap &operator =(FlatHashMap &&other) {
+      if(&other != this) {
+        destroyEntries();
+        this->hashes = std::move(other.hashes);
+        this->entries = std::move(other.entries);
+        this->capacity = other.capacity;
+        this->shift = other.shift;
+        this->count = other.count;
+        other.capacity = 0;
+        other.shift = sizeof(std::size_t) * 8;
+        other.count = 0;
+      }
+      return *this;
+    }
+
+    /// <summary>Counts the number of entries currently stored in the map</summary>
+    /// <returns>The number of entries in the map</returns>
+    public: std::size_t Count() const {
+      return this->count;
+    }
+
+    /// <summary>Returns the number of slots the map has allocated</summary>
+    /// <returns>The number of slots the map has memory for</returns>
+    /// <remarks>
+    ///   The map grows before more than three quarters of its slots are occupied,
+    ///   so the number of entries it can hold without growing is smaller than this.
+    /// </remarks>
+    public: std::size_t GetCapacity() const {
+      return this->capacity;
+    }
+
+    /// <summary>Ensures the map can hold the specified number of entries</summary>
+    /// <param name="entryCount">Number of entries the map should be able to hold</param>
+    /// <remarks>
+    ///   Adding entries until this number is reached will not cause the map to
+    ///   allocate memory again.
+    /// </remarks>
+    public: void Reserve(std::size_t entryCount) {
+      std::size_t requiredCapacity = 8;
+      while(requiredCapacity * 3 < entryCount * 4) {
+        requiredCapacity *= 2;
+      }
+      if(requiredCapacity > this->capacity) {
+        rehash(requiredCapacity);
+      }
+    }
+
+    /// <summary>Checks whether the map contains an entry with the specified key</summary>
+    /// <param name="key">Key that will be looked for</param>
+    /// <returns>True if the map contains an entry with the specified key</returns>
+    public: bool Contains(const TKey &key) const {
+      return (find(key) != NotFound);
+    }
+
+    /// <summary>Looks up the value stored under the specified key</summary>
+    /// <param name="key">Key whose value will be looked up</param>
+    /// <returns>The value stored under the key or a null pointer if the key is unknown</returns>
+    public: const TValue *TryGet(const TKey &key) const {
+      std::size_t index = find(key);
+      if(index == NotFound) {
+        return nullptr;
+      } else {
+        return &getEntry(index).Value;
+      }
+    }
+
+    /// <summary>Looks up the value stored under the specified key</summary>
+    /// <param name="key">Key whose value will be looked up</param>
+    /// <returns>The value stored under the key or a null pointer if the key is unknown</returns>
+    public: TValue *TryGet(const TKey &key) {
+      std::size_t index = find(key);
+      if(index == NotFound) {
+        return nullptr;
+      } else {
+        return &getEntry(index).Value;
+      }
+    }
+
+    /// <summary>Adds an entry to the map unless its key is already present</summary>
+    /// <param name="key">Key under which the value will be stored</param>
+    /// <param name="value">Value that will be stored in the map</param>
+    /// <returns>True if the entry was added, false if the key was already present</returns>
+    public: bool TryInsert(const TKey &key, const TValue &value) {
+      return TryEmplace(key, value);
+    }
+
+    /// <summary>Adds an entry to the map unless its key is already present</summary>
+    /// <param name="key">Key under which the value will be stored</param>
+    /// <param name="value">Value that will be moved into the map</param>
+    /// <returns>True if the entry was added, false if the key was already present</returns>
+    public: bool TryInsert(TKey &&key, TValue &&value) {
+      return TryEmplace(std::move(key), std::move(value));
+    }
+
+    /// <summary>Constructs an entry in the map unless its key is already present</summary>
+    /// <typeparam name="TKeyArgument">Type the key will be constructed from</typeparam>
+    /// <typeparam name="TValueArguments">Types the value will be constructed from</typeparam>
+    /// <param name="key">Key under which the value will be stored</param>
+    /// <param name="valueArguments">Arguments that will be passed to the value's constructor</param>
+    /// <returns>True if the entry was added, false if the key was already present</returns>
+    public: template<typename TKeyArgument, typename... TValueArguments>
+    bool TryEmplace(TKeyArgument &&key, TValueArguments &&... valueArguments) {
+      std::size_t hash = getHash(key);
+      if(findSlot(key, hash) != NotFound) {
+        return false;
+      }
+
+      if((this->count + 1) * 4 > this->capacity * 3) {
+        rehash((this->capacity == 0) ? 8 : (this->capacity * 2));
+      }
+
+      std::size_t mask = this->capacity - 1;
+      std::size_t index = getHomeIndex(hash);
+      while(this->hashes[index] != 0) {
+        index = (index + 1) & mask;
+      }
+
+      new(&this->entries[index]) Entry(
+        std::forward<TKeyArgument>(key), std::forward<TValueArguments>(valueArguments)...
+      );
+      this->hashes[index] = hash;
+      ++this->count;
+
+      return true;
+    }
+
+    /// <summary>Removes the entry with the specified key from the map</summary>
+    /// <param name="key">Key of the entry that will be removed</param>
+    /// <returns>True if an entry was removed, false if the key was not present</returns>
+    public: bool Remove(const TKey &key) {
+      std::size_t hole = find(key);
+      if(hole == NotFound) {
+        return false;
+      }
+
+      getEntry(hole).~Entry();
+      this->hashes[hole] = 0;
+      --this->count;
+
+      // Close the gap by moving back any entries that had to skip past the removed one.
+      // An entry may move into the hole unless its home slot lies between the hole and
+      // the entry's current slot, in which case it would become impossible to find.
+      std::size_t mask = this->capacity - 1;
+      std::size_t index = hole;
+      for(;;) {
+        index = (index + 1) & mask;
+        if(this->hashes[index] == 0) {
+          break;
+        }
+
+        std::size_t home = getHomeIndex(this->hashes[index]);
+        bool isHomeBetween = (
+          (hole <= index) ?
+          ((hole < home) && (home <= index)) :
+          ((hole < home) || (home <= index))
+        );
+        if(!isHomeBetween) {
+          new(&this->entries[hole]) Entry(std::move(getEntry(index)));
+          this->hashes[hole] = this->hashes[index];
+          getEntry(index).~Entry();
+          this->hashes[index] = 0;
+          hole = index;
+        }
+      }
+
+      return true;
+    }
+
+    /// <summary>Removes all entries from the map</summary>
+    /// <remarks>The map keeps its allocated memory for reuse</remarks>
+    public: void Clear() {
+      destroyEntries();
+      this->count = 0;
+    }
+
+    /// <summary>Invokes a callback on every entry in the map</summary>
+    /// <typeparam name="TCallback">Type of callback that will be invoked</typeparam>
+    /// <param name="callback">
+    ///   Callback that will be invoked with the key and the value of each entry
+    /// </param>
+    /// <remarks>
+    ///   The entries are visited in no particular order. The callback must not add
+    ///   entries to or remove entries from the map.
+    /// </remarks>
+    public: template<typename TCallback>
+    void ForEach(TCallback &&callback) const {
+      for(std::size_t index = 0; index < this->capacity; ++index) {
+        if(this->hashes[index] != 0) {
+          const Entry &entry = getEntry(index);
+          callback(entry.Key, entry.Value);
+        }
+      }
+    }
+
+    /// <summary>Invokes a callback on every entry in the map</summary>
+    /// <typeparam name="TCallback">Type of callback that will be invoked</typeparam>
+    /// <param name="callback">
+    ///   Callback that will be invoked with the key and the value of each entry
+    /// </param>
+    /// <remarks>
+    ///   The entries are visited in no particular order. The callback may modify
+    ///   the values, but must not add entries to or remove entries from the map.
+    /// </remarks>
+    public: template<typename TCallback>
+    void ForEach(TCallback &&callback) {
+      for(std::size_t index = 0; index < this->capacity; ++index) {
+        if(this->hashes[index] != 0) {
+          Entry &entry = getEntry(index);
+          callback(static_cast<const TKey &>(entry.Key), entry.Value);
+        }
+      }
+    }
+
+    #pragma region struct Entry
+
+    /// <summary>Key and value stored in an occupied slot</summary>
+    private: struct Entry {
+
+      /// <summary>Initializes a new entry</summary>
+      /// <param name="key">Key the entry will be stored under</param>
+      /// <param name="valueArguments">Arguments passed to the value's constructor</param>
+      public: template<typename TKeyArgument, typename... TValueArguments>
+      Entry(TKeyArgument &&key, TValueArguments &&... valueArguments) :
+        Key(std::forward<TKeyArgument>(key)),
+        Value(std::forward<TValueArguments>(valueArguments)...) {}
+
+      /// <summary>Key under which the value is stored</summary>
+      public: TKey Key;
+      /// <summary>Value stored in the slot</summary>
+      public: TValue Value;
+
+    };
+
+    #pragma endregion // struct Entry
+
+    /// <summary>Uninitialized memory large enough to hold an entry</summary>
+    private: typedef typename std::aligned_storage<
+      sizeof(Entry), alignof(Entry)
+    >::type EntryStorage;
+
+    /// <summary>Slot index returned when a key could not be found</summary>
+    private: static const std::size_t NotFound = static_cast<std::size_t>(-1);
+
+    /// <summary>Calculates the hash of a key as it is stored in the map</summary>
+    /// <param name="key">Key whose hash will be calculated</param>
+    /// <returns>The key's hash, which is never zero</returns>
+    /// <remarks>
+    ///   A stored hash of zero marks an empty slot, so the lowest bit is always set.
+    ///   Slot indices are taken from the upper bits, which loses nothing.
+    /// </remarks>
+    private: template<typename TKeyArgument>
+    static std::size_t getHash(const TKeyArgument &key) {
+      return THash()(key) | 1;
+    }
+
+    /// <summary>Determines the slot in which probing for a hash begins</summary>
+    /// <param name="hash">Hash for which the slot will be determined</param>
+    /// <returns>The index of the first slot that will be looked at</returns>
+    /// <remarks>
+    ///   Many std::hash implementations return integers and pointers unchanged, which
+    ///   would put consecutive or aligned keys in clumps. Multiplying by the golden ratio
+    ///   (Fibonacci hashing) spreads such keys out over all slots.
+    /// </remarks>
+    private: std::size_t getHomeIndex(std::size_t hash) const {
+      const std::size_t goldenRatio = (
+        (sizeof(std::size_t) >= 8) ?
+        static_cast<std::size_t>(11400714819323198485ULL) :
+        static_cast<std::size_t>(2654435769U)
+      );
+      return (hash * goldenRatio) >> this->shift;
+    }
+
+    /// <summary>Looks for the slot holding the specified key</summary>
+    /// <param name="key">Key that will be looked for</param>
+    /// <returns>The index of the slot holding the key or NotFound</returns>
+    private: std::size_t find(const TKey &key) const {
+      return findSlot(key, getHash(key));
+    }
+
+    /// <summary>Looks for the slot holding the specified key</summary>
+    /// <param name="key">Key that will be looked for</param>
+    /// <param name="hash">Hash of the key as returned by getHash()</param>
+    /// <returns>The index of the slot holding the key or NotFound</returns>
+    private: template<typename TKeyArgument>
+    std::size_t findSlot(const TKeyArgument &key, std::size_t hash) const {
+      if(this->count == 0) {
+        return NotFound;
+      }
+
+      std::size_t mask = this->capacity - 1;
+      std::size_t index = getHomeIndex(hash);
+      while(this->hashes[index] != 0) {
+        if(this->hashes[index] == hash) {
+          if(TEqual()(getEntry(index).Key, key)) {
+            return index;
+          }
+        }
+        index = (index + 1) & mask;
+      }
+
+      return NotFound;
+    }
+
+    /// <summary>Moves all entries into a new set of slots</summary>
+    /// <param name="newCapacity">Number of slots to allocate, must be a power of two</param>
+    private: void rehash(std::size_t newCapacity) {
+      std::unique_ptr<std::size_t[]> newHashes(new std::size_t[newCapacity]());
+      std::unique_ptr<EntryStorage[]> newEntries(new EntryStorage[newCapacity]);
+
+      std::size_t newShift = sizeof(std::size_t) * 8;
+      for(std::size_t slotCount = newCapacity; slotCount > 1; slotCount >>= 1) {
+        --newShift;
+      }
+
+      std::unique_ptr<std::size_t[]> oldHashes(std::move(this->hashes));
+      std::unique_ptr<EntryStorage[]> oldEntries(std::move(this->entries));
+      std::size_t oldCapacity = this->capacity;
+
+      this->hashes = std::move(newHashes);
+      this->entries = std::move(newEntries);
+      this->capacity = newCapacity;
+      this->shift = newShift;
+
+      std::size_t mask = newCapacity - 1;
+      for(std::size_t oldIndex = 0; oldIndex < oldCapacity; ++oldIndex) {
+        std::size_t hash = oldHashes[oldIndex];
+        if(hash != 0) {
+          Entry &oldEntry = *reinterpret_cast<Entry *>(&oldEntries[oldIndex]);
+
+          std::size_t index = getHomeIndex(hash);
+          while(this->hashes[index] != 0) {
+            index = (index + 1) & mask;
+          }
+
+          new(&this->entries[index]) Entry(std::move(oldEntry));
+          this->hashes[index] = hash;
+          oldEntry.~Entry();
+        }
+      }
+    }
+
+    /// <summary>Destroys all entries in the occupied slots</summary>
+    private: void destroyEntries() {
+      for(std::size_t index = 0; index < this->capacity; ++index) {
+        if(this->hashes[index] != 0) {
+          getEntry(index).~Entry();
+          this->hashes[index] = 0;
+        }
+      }
+    }
+
+    /// <summary>Accesses the entry stored in an occupied slot</summary>
+    /// <param name="index">Index of the slot whose entry will be returned</param>
+    /// <returns>The entry in the specified slot</returns>
+    private: const Entry &getEntry(std::size_t index) const {
+      return *reinterpret_cast<const Entry *>(&this->entries[index]);
+    }
+
+    /// <summary>Accesses the entry stored in an occupied slot</summary>
+    /// <param name="index">Index of the slot whose entry will be returned</param>
+    /// <returns>The entry in the specified slot</returns>
+    private: Entry &getEntry(std::size_t index) {
+      return *reinterpret_cast<Entry *>(&this->entries[index]);
+    }
+
+    /// <summary>Stored hash of each slot's key, zero for empty slots</summary>
+    private: std::unique_ptr<std::size_t[]> hashes;
+    /// <summary>Memory holding the entries, only constructed in occupied slots</summary>
+    private: std::unique_ptr<EntryStorage[]> entries;
+    /// <summary>Number of slots, always zero or a power of two</summary>
+    private: std::size_t capacity;
+    /// <summary>Number of bits the hash is shifted right to obtain a slot index</summary>
+    private: std::size_t shift;
+    /// <summary>Number of occupied slots</summary>
+    private: std::size_t count;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
+
+#endif // NUCLEX_SUPPORT_COLLECTIONS_FLATHASHMAP_H
@@ -69,16 +69,115 @@ namespace Nuclex { namespace Support { namespace Collections {
     /// <returns>The item at the specified index</returns>
     public: virtual TValue &GetAt(std::size_t index) = 0;
 
+    /// <summary>Looks up how many items follow an index without gaps in memory</summary>
+    /// <param name="index">Index of the first item that will be accessed</param>
+    /// <param name="items">Receives the address of the item at the specified index</param>
+    /// <returns>
+    ///   The number of items, starting with the one at the specified index, that are
+    ///   stored next to each other in memory
+    /// </returns>
+    /// <remarks>
+    ///   <para>
+    ///     This lets generic code walk over the items in the collection without a virtual
+    ///     call for each item: each call gives a run of items that can be accessed through
+    ///     the returned pointer like an array. Collections backed by an array return all
+    ///     remaining items at once, the default implementation returns one item at a time.
+    ///   </para>
+    ///   <para>
+    ///     The pointer becomes invalid when the collection is modified. See
+    ///     <see cref="ForEach" /> for a loop built on top of this method.
+    ///   </para>
+    /// </remarks>
+    public: virtual std::size_t GetContiguousRange(
+      std::size_t index, const TValue *&items
+    ) const {
+      items = &GetAt(index);
+      return 1;
+    }
+
+    /// <summary>Looks up how many items follow an index without gaps in memory</summary>
+    /// <param name="index">Index of the first item that will be accessed</param>
+    /// <param name="items">Receives the address of the item at the specified index</param>
+    /// <returns>
+    ///   The number of items, starting with the one at the specified index, that are
+    ///   stored next to each other in memory
+    /// </returns>
+    public: virtual std::size_t GetContiguousRange(std::size_t index, TValue *&items) {
+      items = &GetAt(index);
+      return 1;
+    }
+
+    /// <summary>Invokes a callback on each item in the collection</summary>
+    /// <typeparam name="TCallback">Type of callback that will be invoked</typeparam>
+    /// <param name="callback">Callback that will be invoked with each item</param>
+    /// <remarks>
+    ///   Uses <see cref="GetContiguousRange" />, so for collections stored in one piece,
+    ///   this makes two virtual calls in total and loops over a plain array. The callback
+    ///   must not modify the collection.
+    /// </remarks>
+    public: template<typename TCallback>
+    void ForEach(TCallback &&callback) const {
+      std::size_t count = this->Count();
+      for(std::size_t index = 0; index < count;) {
+        const TValue *items;
+        std::size_t rangeLength = GetContiguousRange(index, items);
+        for(std::size_t offset = 0; offset < rangeLength; ++offset) {
+          callback(items[offset]);
+        }
+        index += rangeLength;
+      }
+    }
+
+    /// <summary>Invokes a callback on each item in the collection</summary>
+    /// <typeparam name="TCallback">Type of callback that will be invoked</typeparam>
+    /// <param name="callback">Callback that will be invoked with each item</param>
+    public: template<typename TCallback>
+    void ForEach(TCallback &&callback) {
+      std::size_t count = this->Count();
+      for(std::size_t index = 0; index < count;) {
+        TValue *items;
+        std::size_t rangeLength = GetContiguousRange(index, items);
+        for(std::size_t offset = 0; offset < rangeLength; ++offset) {
+          callback(items[offset]);
+        }
+        index += rangeLength;
+      }
+    }
+
     /// <summary>Assigns the specified item to the specified index</summary>
     /// <param name="index">Index at which the item will be stored</param>
     /// <param name="value">Item that will be stored at the specified index</param>
     public: virtual void SetAt(std::size_t index, const TValue &value) = 0;
 
+    /// <summary>Moves the specified item into the specified index</summary>
+    /// <param name="index">Index at which the item will be stored</param>
+    /// <param name="value">Item that will be moved to the specified index</param>
+    public: virtual void SetAt(std::size_t index, TValue &&value) = 0;
+
     /// <summary>Inserts the specified item at a specified index</summary>
     /// <param name="index">Index at which the item will be inserted</param>
     /// <param name="value">Item that will be inserted into the collection</param>
     public: virtual void InsertAt(std::size_t index, const TValue &value) = 0;
 
+    /// <summary>Moves the specified item into the collection at a specified index</summary>
+    /// <param name="index">Index at which the item will be inserted</param>
+    /// <param name="value">Item that will be moved into the collection</param>
+    public: virtual void InsertAt(std::size_t index, TValue &&value) = 0;
+
+    /// <summary>Constructs a new item in the collection at the specified index</summary>
+    /// <typeparam name="TArguments">Types of the arguments for the item's constructor</typeparam>
+    /// <param name="index">Index at which the item will be inserted</param>
+    /// <param name="arguments">Arguments that will be passed to the item's constructor</param>
+    /// <remarks>
+    ///   Through the interface, this constructs a temporary item and moves it into
+    ///   the collection. Implementations can hide this method with one that constructs
+    ///   the item in place.
+    /// </remarks>
+    public: template<typename... TArguments>
+    void EmplaceAt(std::size_t index, TArguments &&... arguments) {
+      InsertAt(index, TValue(std::forward<TArguments>(arguments)...));
+    }
+
     /// <summary>Removes the item at the specified index from the collection</summary>
     /// <param name="index">Index at which the item will be removed</param>
     public: virtual void RemoveAt(std::size_t index) = 0;
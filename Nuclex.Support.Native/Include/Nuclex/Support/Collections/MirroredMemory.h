@@ -0,0 +1,104 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_COLLECTIONS_MIRROREDMEMORY_H
+#define NUCLEX_SUPPORT_COLLECTIONS_MIRROREDMEMORY_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Memory block that is mapped twice, back to back, into the address space</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The same physical pages appear at <see cref="GetAddress" /> and again directly
+  ///     behind them, so anything written past the end of the block shows up at its
+  ///     beginning and vice versa. Ring buffers built on top of this never have to split
+  ///     reads or writes at the wrap-around point: any range up to the block's size
+  ///     starting anywhere inside the first mapping is contiguous.
+  ///   </para>
+  ///   <para>
+  ///     The size is always a multiple of the system's allocation granularity (the page
+  ///     size on Linux, 64 KiB on Windows). Creating the mapping takes a few system calls,
+  ///     so this is meant for long-lived buffers.
+  ///   </para>
+  /// </remarks>
+  class MirroredMemory {
+
+    /// <summary>Maps a new block of mirrored memory</summary>
+    /// <param name="minimumByteCount">Minimum size of the memory block in bytes</param>
+    /// <remarks>Throws a std::system_error if the memory can not be mapped</remarks>
+    public: NUCLEX_SUPPORT_API MirroredMemory(std::size_t minimumByteCount);
+
+    /// <summary>Takes over the mapping of another instance</summary>
+    /// <param name="other">Other instance whose mapping will be taken over</param>
+    public: NUCLEX_SUPPORT_API MirroredMemory(MirroredMemory &&other);
+
+    /// <summary>Unmaps the memory block</summary>
+    public: NUCLEX_SUPPORT_API ~MirroredMemory();
+
+    /// <summary>Granularity in which mirrored memory can be allocated</summary>
+    /// <returns>The number of bytes mirrored memory sizes are a multiple of</returns>
+    public: NUCLEX_SUPPORT_API static std::size_t GetAllocationGranularity();
+
+    /// <summary>Returns the address of the first mapping</summary>
+    /// <returns>The address at which the memory block begins</returns>
+    /// <remarks>The second mapping begins <see cref="GetByteCount" /> bytes later</remarks>
+    public: std::uint8_t *GetAddress() const {
+      return this->address;
+    }
+
+    /// <summary>Returns the size of the memory block</summary>
+    /// <returns>The size of one mapping of the memory block in bytes</returns>
+    public: std::size_t GetByteCount() const {
+      return this->byteCount;
+    }
+
+    /// <summary>Exchanges the mappings of two instances</summary>
+    /// <param name="other">Other instance the mapping will be exchanged with</param>
+    public: void Swap(MirroredMemory &other) {
+      std::uint8_t *otherAddress = other.address;
+      std::size_t otherByteCount = other.byteCount;
+      other.address = this->address;
+      other.byteCount = this->byteCount;
+      this->address = otherAddress;
+      this->byteCount = otherByteCount;
+    }
+
+    private: MirroredMemory(const MirroredMemory &) = delete;
+    private: MirroredMemory &operator =(const MirroredMemory &) = delete;
+
+    /// <summary>Address at which the first mapping begins</summary>
+    private: std::uint8_t *address;
+    /// <summary>Size of one mapping in bytes</summary>
+    private: std::size_t byteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
+
+#endif // NUCLEX_SUPPORT_COLLECTIONS_MIRROREDMEMORY_H
@@ -0,0 +1,292 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_COLLECTIONS_MIRROREDSHIFTBUFFER_H
+#define NUCLEX_SUPPORT_COLLECTIONS_MIRROREDSHIFTBUFFER_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Collections/MirroredMemory.h"
+
+#include <cstddef> // for std::size_t
+#include <cassert> // for assert()
+#include <cstring> // for std::memcpy()
+#include <type_traits> // for std::is_trivially_copyable<>
+#include <utility> // for std::move()
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Shift buffer that wraps around through mirrored memory instead of moving</summary>
+  /// <typeparam name="TItem">Type of items that will be stored in the buffer</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Offers the same interface as the <see cref="ShiftBuffer" />, but never has to
+  ///     shift its contents back to the front: the items live in a ring whose memory is
+  ///     mapped twice in a row (see <see cref="MirroredMemory" />), so the items in
+  ///     the buffer and the free space behind them are always contiguous, no matter where
+  ///     in the ring they currently are.
+  ///   </para>
+  ///   <para>
+  ///     This pays off for streaming workloads where the buffer is never drained
+  ///     completely, which is the ShiftBuffer's worst case. The price is that the capacity
+  ///     is a multiple of the system's allocation granularity (typically 4 KiB on Linux
+  ///     and 64 KiB on Windows) and that only trivially copyable items can be stored,
+  ///     since the same memory is visible under two addresses.
+  ///   </para>
+  ///   <para>
+  ///     Like the ShiftBuffer, the capacity is not a limit. When more items are written
+  ///     than fit, a larger mirrored memory block is mapped and the items are copied
+  ///     over once.
+  ///   </para>
+  /// </remarks>
+  template<typename TItem>
+  class MirroredShiftBuffer {
+
+    static_assert(
+      std::is_trivially_copyable<TItem>::value,
+      u8"Mirrored shift buffers can only store trivially copyable items"
+    );
+
+    /// <summary>Initializes a new mirrored shift buffer</summary>
+    /// <param name="capacity">Minimum number of items to allocate memory for</param>
+    public: MirroredShiftBuffer(std::size_t capacity = 256) :
+      memory(getRequiredByteCount(capacity)),
+      capacity(memory.GetByteCount() / sizeof(TItem)),
+      startIndex(0),
+      endIndex(0),
+      reservedItemCount(0) {}
+
+    /// <summary>Initializes a mirrored shift buffer as copy of another one</summary>
+    /// <param name="other">Other mirrored shift buffer that will be copied</param>
+    public: MirroredShiftBuffer(const MirroredShiftBuffer &other) :
+      memory(getRequiredByteCount(other.capacity)),
+      capacity(memory.GetByteCount() / sizeof(TItem)),
+      startIndex(0),
+      endIndex(other.Count()),
+      reservedItemCount(0) {
+      std::memcpy(this->memory.GetAddress(), other.Access(), other.Count() * sizeof(TItem));
+    }
+
+    /// <summary>Initializes a mirrored shift buffer taking over another one</summary>
+    /// <param name="other">Other mirrored shift buffer that will be taken over</param>
+    public: MirroredShiftBuffer(MirroredShiftBuffer &&other) :
+      memory(std::move(other.memory)),
+      capacity(other.capacity),
+      startIndex(other.startIndex),
+      endIndex(other.endIndex),
+      reservedItemCount(other.reservedItemCount) {
+      other.capacity = 0;
+      other.startIndex = 0;
+      other.endIndex = 0;
+      other.reservedItemCount = 0;
+    }
+
+    /// <summary>Returns the number of items the buffer has allocated memory for</summary>
+    /// <returns>The number of items the buffer has reserved space for</returns>
+    /// <remarks>
+    ///   Just like std::vector::capacity(), this is not a limit. If the capacity is
+    ///   exceeded, the buffer will map a larger memory block and use that one.
+    /// </remarks>
+    public: std::size_t GetCapacity() const {
+      return this->capacity;
+    }
+
+    /// <summary>Counts the number of items currently stored in the buffer</summary>
+    public: std::size_t Count() const {
+      return this->endIndex - this->startIndex;
+    }
+
+    /// <summary>Provides direct read access to the items stored in the buffer</summary>
+    /// <returns>
+    ///   A pointer to the oldest item in the buffer, following sequentially by
+    ///   all newer items in the order they were written
+    /// </returns>
+    public: const TItem *Access() const {
+      return reinterpret_cast<const TItem *>(this->memory.GetAddress()) + this->startIndex;
+    }
+
+    /// <summary>Provides direct access to the items stored in the buffer</summary>
+    /// <returns>
+    ///   A pointer to the oldest item in the buffer, following sequentially by
+    ///   all newer items in the order they were written
+    /// </returns>
+    public: TItem *Access() {
+      return reinterpret_cast<TItem *>(this->memory.GetAddress()) + this->startIndex;
+    }
+
+    /// <summary>Skips the specified number of items</summary>
+    /// <param name="skipItemCount">Number of items that will be skipped</param>
+    public: void Skip(std::size_t skipItemCount) {
+      assert(
+        ((this->startIndex + skipItemCount) <= this->endIndex) &&
+        u8"Amount of data skipped must be less or equal to the amount of data in the buffer"
+      );
+      advanceStart(skipItemCount);
+    }
+
+    /// <summary>Reads items out of the buffer, starting with the oldest item</summary>
+    /// <param name="items">Memory to which the items will be copied</param>
+    /// <param name="count">Number of items that will be read from the buffer</param>
+    public: void Read(TItem *items, std::size_t count) {
+      assert(
+        ((this->startIndex + count) <= this->endIndex) &&
+        u8"Amount of data read must be less or equal to the amount of data in the buffer"
+      );
+      std::memcpy(items, Access(), count * sizeof(TItem));
+      advanceStart(count);
+    }
+
+    /// <summary>Copies the specified number of items into the buffer</summary>
+    /// <param name="items">Items that will be copied into the buffer</param>
+    /// <param name="count">Number of items that will be copied</param>
+    public: void Write(const TItem *items, std::size_t count) {
+      std::memcpy(Reserve(count), items, count * sizeof(TItem));
+      Commit(count);
+    }
+
+    /// <summary>Moves the specified number of items into the buffer</summary>
+    /// <param name="items">Items that will be moves into the buffer</param>
+    /// <param name="count">Number of items that will be moves</param>
+    /// <remarks>
+    ///   Provided for parity with the <see cref="ShiftBuffer" />. Since the items are
+    ///   trivially copyable, this is the same as <see cref="Write" />.
+    /// </remarks>
+    public: void Shove(TItem *items, std::size_t count) {
+      Write(items, count);
+    }
+
+    /// <summary>Reserves space for items that will be constructed in place</summary>
+    /// <param name="itemCount">Number of items to reserve space for</param>
+    /// <returns>The address at which the items can be constructed</returns>
+    /// <remarks>
+    ///   Works like <see cref="ShiftBuffer.Reserve" />. The reserved space is always
+    ///   contiguous, even when it crosses the end of the ring. Any call to
+    ///   <see cref="Write" />, <see cref="Shove" /> or <see cref="Reserve" /> cancels
+    ///   the reservation and may move the buffer's memory.
+    /// </remarks>
+    public: TItem *Reserve(std::size_t itemCount) {
+      makeSpace(itemCount);
+      this->reservedItemCount = itemCount;
+
+      return reinterpret_cast<TItem *>(this->memory.GetAddress()) + this->endIndex;
+    }
+
+    /// <summary>Adds items constructed in reserved space to the buffer</summary>
+    /// <param name="itemCount">
+    ///   Number of items that have been constructed at the address returned by
+    ///   <see cref="Reserve" />, at most the number of items reserved
+    /// </param>
+    public: void Commit(std::size_t itemCount) {
+      assert(
+        (itemCount <= this->reservedItemCount) &&
+        u8"Number of items committed must not exceed the number of items reserved"
+      );
+      this->endIndex += itemCount;
+      this->reservedItemCount = 0;
+    }
+
+    /// <summary>Calculates the byte count needed to store the specified items</summary>
+    /// <param name="itemCount">Number of items that should fit into the memory</param>
+    /// <returns>
+    ///   The smallest number of bytes that holds the items and is a multiple of both
+    ///   the allocation granularity and the item size
+    /// </returns>
+    /// <remarks>
+    ///   Item sizes that aren't a power of two will not divide the allocation granularity,
+    ///   so the memory is sized in units of their least common multiple. That way, items
+    ///   never straddle the end of the ring.
+    /// </remarks>
+    private: static std::size_t getRequiredByteCount(std::size_t itemCount) {
+      std::size_t granularity = MirroredMemory::GetAllocationGranularity();
+
+      std::size_t divisor = granularity;
+      std::size_t remainder = sizeof(TItem);
+      while(remainder != 0) {
+        std::size_t next = divisor % remainder;
+        divisor = remainder;
+        remainder = next;
+      }
+
+      std::size_t unit = granularity / divisor * sizeof(TItem);
+      std::size_t byteCount = itemCount * sizeof(TItem);
+      if(byteCount == 0) {
+        return unit;
+      }
+
+      return (byteCount + unit - 1) / unit * unit;
+    }
+
+    /// <summary>Advances the start index, wrapping both indices around if needed</summary>
+    /// <param name="itemCount">Number of items the start index will be advanced by</param>
+    private: void advanceStart(std::size_t itemCount) {
+      this->startIndex += itemCount;
+      if(this->startIndex >= this->capacity) {
+        this->startIndex -= this->capacity;
+        this->endIndex -= this->capacity;
+      }
+    }
+
+    /// <summary>Makes space for the specified number of items behind the last one</summary>
+    /// <param name="itemCount">Number of items for which space will be made</param>
+    /// <remarks>
+    ///   Thanks to the mirror, the free space behind the items is contiguous as long as
+    ///   everything fits into the capacity. Only when it doesn't, a new memory block
+    ///   is mapped, which costs the one copy the ShiftBuffer would pay on every shift.
+    /// </remarks>
+    private: void makeSpace(std::size_t itemCount) {
+      std::size_t count = Count();
+      std::size_t requiredCapacity = count + itemCount;
+      if(requiredCapacity <= this->capacity) {
+        return;
+      }
+
+      std::size_t newCapacity = this->capacity * 2;
+      if(newCapacity < requiredCapacity) {
+        newCapacity = requiredCapacity;
+      }
+
+      MirroredMemory newMemory(getRequiredByteCount(newCapacity));
+      std::memcpy(newMemory.GetAddress(), Access(), count * sizeof(TItem));
+      this->memory.Swap(newMemory);
+
+      this->capacity = this->memory.GetByteCount() / sizeof(TItem);
+      this->startIndex = 0;
+      this->endIndex = count;
+    }
+
+    /// <summary>Memory block the ring of items is stored in</summary>
+    private: MirroredMemory memory;
+    /// <summary>Number of items the memory block can hold</summary>
+    private: std::size_t capacity;
+    /// <summary>Index of the first item in the ring, always less than the capacity</summary>
+    private: std::size_t startIndex;
+    /// <summary>Index one past the last item, may reach into the mirrored half</summary>
+    private: std::size_t endIndex;
+    /// <summary>Number of items reserved via <see cref="Reserve" /></summary>
+    private: std::size_t reservedItemCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
+
+#endif // NUCLEX_SUPPORT_COLLECTIONS_MIRROREDSHIFTBUFFER_H
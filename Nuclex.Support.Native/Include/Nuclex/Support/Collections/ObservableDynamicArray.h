@@ -26,6 +26,9 @@ License along with this library
 #include "ObservableIndexedCollection.h"
 
 #include <vector>
+#include <iterator> // for std::make_move_iterator()
+#include <stdexcept> // for std::out_of_range
+#include <utility> // for std::move(), std::forward()
 
 namespace Nuclex { namespace Support { namespace Collections {
 
@@ -33,9 +36,25 @@ namespace Nuclex { namespace Support { namespace Collections {
 
   /// <summary>Dynamic array that sends out change notifications</summary>
   /// <remarks>
-  ///   This collection sends out notifications to any interested party when its contents
-  ///   change (items being reordered, added or removed). It has no way of knowing when
-  ///   internal changes to an item itself occur.
+  ///   <para>
+  ///     This collection sends out notifications to any interested party when its contents
+  ///     change (items being reordered, added or removed). It has no way of knowing when
+  ///     internal changes to an item itself occur.
+  ///   </para>
+  ///   <para>
+  ///     Items that are moved or constructed in the collection are reported by passing
+  ///     a reference to the item as stored in the collection, so subscribers must not
+  ///     modify the collection while they're being notified. Removed or replaced items
+  ///     are moved out of the collection rather than copied before being reported.
+  ///   </para>
+  ///   <para>
+  ///     Operations on ranges of items (including <see cref="Clear" />) fire a single
+  ///     <see cref="ObservableIndexedCollection.ItemsAdded" /> or
+  ///     <see cref="ObservableIndexedCollection.ItemsRemoved" /> event. By default,
+  ///     they fire the per-item events for each item as well so subscribers that only
+  ///     watch individual items keep working. Subscribers that can handle the range
+  ///     events can turn this off via <see cref="SuppressItemEventsInBatches" />.
+  ///   </para>
   /// </remarks>
   template<typename TValue>
   class ObservableDynamicArray :
@@ -47,7 +66,8 @@ namespace Nuclex { namespace Support { namespace Collections {
     public: using IndexedCollection<TValue>::InvalidIndex;
 
     /// <summary>Initializes a new dynamic array</summary>
-    public: ObservableDynamicArray() = default;
+    public: ObservableDynamicArray() :
+      suppressItemEventsInBatches(false) {}
 
     /// <summary>Frees all memory used by the collection</summary>
     public: virtual ~ObservableDynamicArray() = default;
@@ -58,6 +78,12 @@ namespace Nuclex { namespace Support { namespace Collections {
       this->items.reserve(capacity);
     }
 
+    /// <summary>Selects whether range operations fire the per-item events</summary>
+    /// <param name="suppress">True to only fire the range events for range operations</param>
+    public: void SuppressItemEventsInBatches(bool suppress = true) {
+      this->suppressItemEventsInBatches = suppress;
+    }
+
     /// <summary>Determines the index of the specified item in the collection</summary>
     /// <param name="value">Item whose index will be determined</param>
     /// <returns>The index of the specified item</returns>
@@ -86,19 +112,35 @@ namespace Nuclex { namespace Support { namespace Collections {
       return this->items.at(index);
     }
 
+    /// <summary>Looks up how many items follow an index without gaps in memory</summary>
+    /// <param name="index">Index of the first item that will be accessed</param>
+    /// <param name="firstItem">Receives the address of the item at the specified index</param>
+    /// <returns>The number of items from the specified index to the end of the array</returns>
+    public: std::size_t GetContiguousRange(
+      std::size_t index, const TValue *&firstItem
+    ) const override {
+      firstItem = &this->items.at(index);
+      return this->items.size() - index;
+    }
+
+    /// <summary>Looks up how many items follow an index without gaps in memory</summary>
+    /// <param name="index">Index of the first item that will be accessed</param>
+    /// <param name="firstItem">Receives the address of the item at the specified index</param>
+    /// <returns>The number of items from the specified index to the end of the array</returns>
+    public: std::size_t GetContiguousRange(std::size_t index, TValue *&firstItem) override {
+      firstItem = &this->items.at(index);
+      return this->items.size() - index;
+    }
+
     /// <summary>Assigns the specified item to the specified index</summary>
     /// <param name="index">Index at which the item will be stored</param>
     /// <param name="value">Item that will be stored at the specified index</param>
     public: void SetAt(std::size_t index, const TValue &value) override {
       if(index < this->items.size()) {
-        bool removedItemNeeded = (
-          (ObservableIndexedCollection<TValue>::ItemReplaced.CountSubscribers() > 0) ||
-          (ObservableCollection<TValue>::ItemRemoved.CountSubscribers() > 0)
-        );
-        if(removedItemNeeded) {
-          TValue old = this->items[index];
+        if(isRemovedItemNeeded()) {
+          TValue old = std::move(this->items[index]);
           this->items[index] = value;
-          ObservableIndexedCollection<TValue>::ItemReplaced(index, old, value);
+          ObservableIndexedCollection<TValue>::ItemReplaced(std::size_t(index), old, value);
           ObservableCollection<TValue>::ItemRemoved(old);
           ObservableCollection<TValue>::ItemAdded(value);
         } else {
@@ -110,28 +152,63 @@ namespace Nuclex { namespace Support { namespace Collections {
       }
     }
 
+    /// <summary>Moves the specified item into the specified index</summary>
+    /// <param name="index">Index at which the item will be stored</param>
+    /// <param name="value">Item that will be moved to the specified index</param>
+    public: void SetAt(std::size_t index, TValue &&value) override {
+      if(index < this->items.size()) {
+        TValue &stored = this->items[index];
+        if(isRemovedItemNeeded()) {
+          TValue old = std::move(stored);
+          stored = std::move(value);
+          ObservableIndexedCollection<TValue>::ItemReplaced(std::size_t(index), old, stored);
+          ObservableCollection<TValue>::ItemRemoved(old);
+          ObservableCollection<TValue>::ItemAdded(stored);
+        } else {
+          stored = std::move(value);
+          ObservableCollection<TValue>::ItemAdded(stored);
+        }
+      } else { // Let .at() throw the appropriate out-of-bounds exception
+        this->items.at(index) = std::move(value);
+      }
+    }
+
     /// <summary>Inserts the specified item at a specified index</summary>
     /// <param name="index">Index at which the item will be inserted</param>
     /// <param name="value">Item that will be inserted into the collection</param>
     public: void InsertAt(std::size_t index, const TValue &value) override {
       typename std::vector<TValue>::iterator where = this->items.begin() + index;
       this->items.insert(where, value);
-      ObservableIndexedCollection<TValue>::ItemAdded(index, value);
+      ObservableIndexedCollection<TValue>::ItemAdded(std::size_t(index), value);
       ObservableCollection<TValue>::ItemAdded(value);
     }
 
+    /// <summary>Moves the specified item into the collection at a specified index</summary>
+    /// <param name="index">Index at which the item will be inserted</param>
+    /// <param name="value">Item that will be moved into the collection</param>
+    public: void InsertAt(std::size_t index, TValue &&value) override {
+      typename std::vector<TValue>::iterator where = this->items.begin() + index;
+      reportAdded(index, *this->items.insert(where, std::move(value)));
+    }
+
+    /// <summary>Constructs a new item in the collection at the specified index</summary>
+    /// <typeparam name="TArguments">Types of the arguments for the item's constructor</typeparam>
+    /// <param name="index">Index at which the item will be inserted</param>
+    /// <param name="arguments">Arguments that will be passed to the item's constructor</param>
+    public: template<typename... TArguments>
+    void EmplaceAt(std::size_t index, TArguments &&... arguments) {
+      typename std::vector<TValue>::iterator where = this->items.begin() + index;
+      reportAdded(index, *this->items.emplace(where, std::forward<TArguments>(arguments)...));
+    }
+
     /// <summary>Removes the item at the specified index from the collection</summary>
     /// <param name="index">Index at which the item will be removed</param>
     public: void RemoveAt(std::size_t index) override {
       typename std::vector<TValue>::iterator where = this->items.begin() + index;
-      bool erasedItemNeeded = (
-        (ObservableIndexedCollection<TValue>::ItemRemoved.CountSubscribers() > 0) ||
-        (ObservableCollection<TValue>::ItemRemoved.CountSubscribers() > 0)
-      );
-      if(erasedItemNeeded) {
-        TValue value = *where;
+      if(isRemovedItemNeeded()) {
+        TValue value = std::move(*where);
         this->items.erase(where);
-        ObservableIndexedCollection<TValue>::ItemRemoved(index, value);
+        ObservableIndexedCollection<TValue>::ItemRemoved(std::size_t(index), value);
         ObservableCollection<TValue>::ItemRemoved(value);
       } else {
         this->items.erase(where);
@@ -146,19 +223,30 @@ namespace Nuclex { namespace Support { namespace Collections {
       ObservableCollection<TValue>::ItemAdded(item);
     }
 
+    /// <summary>Moves the specified item into the collection</summary>
+    /// <param name="item">Item that will be moved into the collection</param>
+    public: void Add(TValue &&item) override {
+      this->items.push_back(std::move(item));
+      reportAdded(this->items.size() - 1, this->items.back());
+    }
+
+    /// <summary>Constructs a new item at the end of the collection</summary>
+    /// <typeparam name="TArguments">Types of the arguments for the item's constructor</typeparam>
+    /// <param name="arguments">Arguments that will be passed to the item's constructor</param>
+    public: template<typename... TArguments>
+    void Emplace(TArguments &&... arguments) {
+      this->items.emplace_back(std::forward<TArguments>(arguments)...);
+      reportAdded(this->items.size() - 1, this->items.back());
+    }
+
     /// <summary>Removes the specified item from the collection</summary>
     /// <param name="item">Item that will be removed from the collection</param>
     /// <returns>True if the item existed in the collection and was removed</returns>
     public: bool Remove(const TValue &item) override {
-      for(
-        typename std::vector<TValue>::iterator iterator = this->items.begin();
-        iterator != this->items.end();
-        ++iterator
-      ) {
-        if(*iterator == item) {
-          this->items.erase(iterator);
-          ObservableIndexedCollection<TValue>::ItemRemoved(iterator - this->items.begin, item);
-          ObservableCollection<TValue>::ItemRemoved(item);
+      std::size_t count = this->items.size();
+      for(std::size_t index = 0; index < count; ++index) {
+        if(this->items[index] == item) {
+          RemoveAt(index);
           return true;
         }
       }
@@ -166,22 +254,73 @@ namespace Nuclex { namespace Support { namespace Collections {
       return false;
     }
 
+    /// <summary>Adds a range of items to the end of the collection</summary>
+    /// <typeparam name="TIterator">Type of iterator providing the items</typeparam>
+    /// <param name="first">Iterator pointing to the first item that will be added</param>
+    /// <param name="last">Iterator one past the last item that will be added</param>
+    public: template<typename TIterator>
+    void AddRange(TIterator first, TIterator last) {
+      InsertRange(this->items.size(), first, last);
+    }
+
+    /// <summary>Inserts a range of items at the specified index</summary>
+    /// <typeparam name="TIterator">Type of iterator providing the items</typeparam>
+    /// <param name="index">Index at which the first item will be inserted</param>
+    /// <param name="first">Iterator pointing to the first item that will be inserted</param>
+    /// <param name="last">Iterator one past the last item that will be inserted</param>
+    public: template<typename TIterator>
+    void InsertRange(std::size_t index, TIterator first, TIterator last) {
+      if(index > this->items.size()) {
+        throw std::out_of_range(u8"Insertion index lies beyond the end of the collection");
+      }
+
+      std::size_t previousCount = this->items.size();
+      this->items.insert(this->items.begin() + index, first, last);
+      std::size_t count = this->items.size() - previousCount;
+      if(count == 0) {
+        return;
+      }
+
+      if(!this->suppressItemEventsInBatches) {
+        for(std::size_t offset = 0; offset < count; ++offset) {
+          reportAdded(index + offset, this->items[index + offset]);
+        }
+      }
+      ObservableIndexedCollection<TValue>::ItemsAdded(std::size_t(index), std::size_t(count));
+    }
+
+    /// <summary>Removes a range of items from the collection</summary>
+    /// <param name="index">Index of the first item that will be removed</param>
+    /// <param name="count">Number of items that will be removed</param>
+    public: void RemoveRange(std::size_t index, std::size_t count) {
+      if((index > this->items.size()) || (count > this->items.size() - index)) {
+        throw std::out_of_range(u8"Range to remove lies outside of the collection");
+      }
+      if(count == 0) {
+        return;
+      }
+
+      typename std::vector<TValue>::iterator first = this->items.begin() + index;
+      typename std::vector<TValue>::iterator last = first + count;
+      if(isRemovedRangeNeeded()) {
+        std::vector<TValue> removed(
+          std::make_move_iterator(first), std::make_move_iterator(last)
+        );
+        this->items.erase(first, last);
+        reportRemoved(index, removed.data(), count);
+      } else {
+        this->items.erase(first, last);
+      }
+    }
+
     /// <summary>Removes all items from the collection</summary>
     public: void Clear() override {
       std::size_t count = this->items.size();
-      bool erasedItemNeeded = (
-        (ObservableIndexedCollection<TValue>::ItemRemoved.CountSubscribers() > 0) ||
-        (ObservableCollection<TValue>::ItemRemoved.CountSubscribers() > 0)
-      );
-      if(erasedItemNeeded && (count > 0)) {
+      if(isRemovedRangeNeeded() && (count > 0)) {
         std::vector<TValue> removed;
         removed.reserve(this->items.capacity());
         removed.swap(this->items);
-        while(count > 0) {
-          --count;
-          ObservableIndexedCollection<TValue>::ItemRemoved(count, removed[count]);
-          ObservableCollection<TValue>::ItemRemoved(removed[count]);
-        }
+        reportRemoved(0, removed.data(), count);
       } else {
         this->items.clear();
       }
@@ -213,8 +352,67 @@ namespace Nuclex { namespace Support { namespace Collections {
       return this->items.empty();
     }
 
+    /// <summary>Checks whether anyone is interested in items leaving the collection</summary>
+    /// <returns>True if removed or replaced items have to be kept for the notifications</returns>
+    private: bool isRemovedItemNeeded() const {
+      return (
+        (ObservableIndexedCollection<TValue>::ItemRemoved.CountSubscribers() > 0) ||
+        (ObservableIndexedCollection<TValue>::ItemReplaced.CountSubscribers() > 0) ||
+        (ObservableCollection<TValue>::ItemRemoved.CountSubscribers() > 0)
+      );
+    }
+
+    /// <summary>Checks whether anyone needs the items a range operation removes</summary>
+    /// <returns>True if removed items have to be kept for the notifications</returns>
+    private: bool isRemovedRangeNeeded() const {
+      if(ObservableIndexedCollection<TValue>::ItemsRemoved.CountSubscribers() > 0) {
+        return true;
+      }
+
+      return (!this->suppressItemEventsInBatches) && (
+        (ObservableIndexedCollection<TValue>::ItemRemoved.CountSubscribers() > 0) ||
+        (ObservableCollection<TValue>::ItemRemoved.CountSubscribers() > 0)
+      );
+    }
+
+    /// <summary>Notifies subscribers that a range of items has been removed</summary>
+    /// <param name="index">Index the first removed item had in the collection</param>
+    /// <param name="removed">Items that have been removed from the collection</param>
+    /// <param name="count">Number of items that have been removed</param>
+    private: void reportRemoved(std::size_t index, const TValue *removed, std::size_t count) {
+
+      // Per-item events are sent from the back, so each reported index is where
+      // the item was if the items had been removed one by one.
+      if(!this->suppressItemEventsInBatches) {
+        for(std::size_t offset = count; offset > 0;) {
+          --offset;
+          ObservableIndexedCollection<TValue>::ItemRemoved(
+            std::size_t(index + offset), removed[offset]
+          );
+          ObservableCollection<TValue>::ItemRemoved(removed[offset]);
+        }
+      }
+
+      ObservableIndexedCollection<TValue>::ItemsRemoved(
+        std::size_t(index), static_cast<const TValue *>(removed), std::size_t(count)
+      );
+
+    }
+
+    /// <summary>Notifies subscribers that an item has been added</summary>
+    /// <param name="index">Index at which the item has been added</param>
+    /// <param name="item">The added item as it is stored in the collection</param>
+    private: void reportAdded(std::size_t index, const TValue &item) {
+      // The events take their arguments as TArguments&&, so for a by-value index
+      // parameter, only a temporary will bind. That's why indices are copied everywhere.
+      ObservableIndexedCollection<TValue>::ItemAdded(std::size_t(index), item);
+      ObservableCollection<TValue>::ItemAdded(item);
+    }
+
     /// <summary>Items stored in the dynamic array</summary>
     private: std::vector<TValue> items;
+    /// <summary>Whether range operations only fire the range events</summary>
+    private: bool suppressItemEventsInBatches;
 
   };
 
@@ -62,6 +62,24 @@ namespace Nuclex { namespace Support { namespace Collections {
       void(std::size_t index, const TValue &oldValue, const TValue &newValue)
     > ItemReplaced;
 
+    /// <summary>Fired once after a range of items has been added to the collection</summary>
+    /// <param name="index">Index of the first item that has been added</param>
+    /// <param name="count">Number of items that have been added</param>
+    /// <remarks>
+    ///   The new items can be looked up in the collection itself.
+    /// </remarks>
+    public: mutable Events::Event<
+      void(std::size_t index, std::size_t count)
+    > ItemsAdded;
+
+    /// <summary>Fired once after a range of items has been removed from the collection</summary>
+    /// <param name="index">Index the first removed item had in the collection</param>
+    /// <param name="items">The removed items in the order they had in the collection</param>
+    /// <param name="count">Number of items that have been removed</param>
+    public: mutable Events::Event<
+      void(std::size_t index, const TValue *items, std::size_t count)
+    > ItemsRemoved;
+
     // public: mutable Event Clearing();
     // public: mutable Event Cleared();
 
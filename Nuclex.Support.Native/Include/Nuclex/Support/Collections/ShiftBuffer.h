@@ -70,7 +70,8 @@ namespace Nuclex { namespace Support { namespace Collections {
       itemMemory(new std::uint8_t[sizeof(TItem[2]) * getNextPowerOfTwo(capacity) / 2]),
       capacity(getNextPowerOfTwo(capacity)),
       startIndex(0),
-      endIndex(0) {}
+      endIndex(0),
+      reservedItemCount(0) {}
 
     /// <summary>Initializes a shift buffer as a copy of another shift buffer</summary>
     /// <param name="other">Other shift buffer that will be copied</param>
@@ -78,7 +79,8 @@ namespace Nuclex { namespace Support { namespace Collections {
       itemMemory(new std::uint8_t[sizeof(TItem[2]) * other.capacity / 2]),
       capacity(other.capacity),
       startIndex(0),
-      endIndex(0) {
+      endIndex(0),
+      reservedItemCount(0) {
       const TItem *sourceItems = (
         reinterpret_cast<const TItem *>(other.itemMemory.get()) + other.startIndex
       );
@@ -91,7 +93,8 @@ namespace Nuclex { namespace Support { namespace Collections {
       itemMemory(std::move(other.itemMemory)),
       capacity(other.capacity),
       startIndex(other.startIndex),
-      endIndex(other.endIndex) {
+      endIndex(other.endIndex),
+      reservedItemCount(0) {
       other.startIndex = other.endIndex = 0; // Ensure other doesn't try to destroy items
     }
 
@@ -130,6 +133,19 @@ namespace Nuclex { namespace Support { namespace Collections {
       return reinterpret_cast<const TItem *>(this->itemMemory.get()) + this->startIndex;
     }
 
+    /// <summary>Provides direct access to the items stored in the buffer</summary>
+    /// <returns>
+    ///   A pointer to the oldest item in the buffer, following sequentially by
+    ///   all newer items in the order they were written
+    /// </returns>
+    /// <remarks>
+    ///   Allows items to be processed (or moved from) in place. Call <see cref="Skip" />
+    ///   afterwards to consume them, which destroys them as usual.
+    /// </remarks>
+    public: TItem *Access() {
+      return reinterpret_cast<TItem *>(this->itemMemory.get()) + this->startIndex;
+    }
+
     /// <summary>Skips the specified number of items</summary>
     /// <param name="skipItemCount">Number of items that will be skipped</param>
     public: void Skip(std::size_t skipItemCount) {
@@ -167,55 +183,56 @@ namespace Nuclex { namespace Support { namespace Collections {
       moveEmplaceItems(items, count);
     }
 
-#if 1 // Cool, efficient and an invitation to shoot yourself in the foot
-
-    /// <summary>
-    ///   Promises the shift buffer to write the specified number of items before
-    ///   the next call to any non-const method
-    /// </summary>
-    /// <param name="itemCount">Number of items to promise the shift buffer</param>
-    /// <returns>The address at which the items must be written</returns>
+    /// <summary>Reserves space for items that will be constructed in place</summary>
+    /// <param name="itemCount">Number of items to reserve space for</param>
+    /// <returns>The address at which the items can be constructed</returns>
     /// <remarks>
     ///   <para>
-    ///     Warning! The returned pointer is to uninitialized memory. That means assigning
-    ///     the items is an error, they must be constructed into their addresses via
-    ///     placement new, not assignment! (unless they're std::is_trivially_copyable,
-    ///     in which case, std::memcpy() away)
+    ///     Lets decoders and the like produce their output directly inside the buffer
+    ///     instead of staging it in a temporary array that is then passed to
+    ///     <see cref="Write" />. Construct up to the reserved number of items at
+    ///     the returned address, then call <see cref="Commit" /> with the number of
+    ///     items actually constructed to make them part of the buffer.
     ///   </para>
     ///   <para>
-    ///     Additional Warning! After calling this method, the shift buffer will attempt
-    ///     to destroy the promised items if it is itself destroyed or needs to shuffle
-    ///     items around. If you do not fill the promised items (or are interrupted by
-    ///     an item constructor throwing an exception), you have to take care to call
-    ///     <see cref="Unpromise" /> to revert your promise in all cases!
+    ///     The returned memory is uninitialized, so items must be created via placement
+    ///     new rather than assignment (trivially copyable items can simply be copied in).
+    ///     Until they're committed, the reserved items do not count as being in
+    ///     the buffer and will never be destroyed by it, so nothing leaks if filling
+    ///     them fails halfway. On failure, destroy the items you constructed yourself and
+    ///     don't commit them.
+    ///   </para>
+    ///   <para>
+    ///     Reading and skipping don't affect the reservation, but any call to
+    ///     <see cref="Write" />, <see cref="Shove" /> or <see cref="Reserve" /> cancels
+    ///     it and may move the buffer's memory.
     ///   </para>
     /// </remarks>
-    protected: TItem *Promise(std::size_t itemCount) {
+    public: TItem *Reserve(std::size_t itemCount) {
       makeSpace(itemCount);
+      this->reservedItemCount = itemCount;
 
-      TItem *items = reinterpret_cast<TItem *>(this->itemMemory.get()) + this->endIndex;
-      this->endIndex += itemCount;
-
-      return items;
+      return reinterpret_cast<TItem *>(this->itemMemory.get()) + this->endIndex;
     }
 
-    /// <summary>Reverses a promise of data given via <see cref="Promise" /></summary>
-    /// <param name="itemCount">Number of items for which to reverse the promise</param>
+    /// <summary>Adds items constructed in reserved space to the buffer</summary>
+    /// <param name="itemCount">
+    ///   Number of items that have been constructed at the address returned by
+    ///   <see cref="Reserve" />, at most the number of items reserved
+    /// </param>
     /// <remarks>
-    ///   Warning! You must not reverse a promise for more data than you promised with
-    ///   your last call to <see cref="Promise" />. The items for which you reverse your
-    ///   promise will be considered uninitialized memory again and will not have their
-    ///   destructors called.
+    ///   Ends the reservation. Committing fewer items than were reserved is fine,
+    ///   the space for the remaining items is simply used for the next write.
     /// </remarks>
-    protected: void Unpromise(std::size_t itemCount) {
-      this->endIndex -= itemCount;
+    public: void Commit(std::size_t itemCount) {
       assert(
-        (this->endIndex >= startIndex) &&
-        u8"Promise reversal can not deny more data than was promised earlier"
+        (itemCount <= this->reservedItemCount) &&
+        u8"Number of items committed must not exceed the number of items reserved"
       );
+      this->endIndex += itemCount;
+      this->reservedItemCount = 0;
     }
 
-#endif
 
     /// <summary>Calculates the next power of two for the specified value</summary>
     /// <param name="value">Value of which the next power of two will be calculated</param>
@@ -256,6 +273,8 @@ namespace Nuclex { namespace Support { namespace Collections {
     ///   of items. If there was enough space in the first place, this method does nothing.
     /// </remarks>
     private: void makeSpace(std::size_t itemCount) {
+      this->reservedItemCount = 0;
+
       std::size_t usedItemCount = this->endIndex - this->startIndex;
 
       // Is more space in the buffer inaccessible than is occupied by items?
@@ -422,7 +441,9 @@ namespace Nuclex { namespace Support { namespace Collections {
     >::type extractItems(
       TItem *targetItems, std::size_t itemCount
     ) {
-      TItem *sourceItems = reinterpret_cast<TItem *>(this->itemMemory.get());
+      TItem *sourceItems = (
+        reinterpret_cast<TItem *>(this->itemMemory.get()) + this->startIndex
+      );
       std::memcpy(targetItems, sourceItems, itemCount * sizeof(TItem));
       this->startIndex += itemCount;
     }
@@ -546,6 +567,8 @@ namespace Nuclex { namespace Support { namespace Collections {
     private: std::size_t startIndex;
     /// <summary>Index one past the last item</summary>
     private: std::size_t endIndex;
+    /// <summary>Number of items reserved behind the last item, if any</summary>
+    private: std::size_t reservedItemCount;
 
   };
 
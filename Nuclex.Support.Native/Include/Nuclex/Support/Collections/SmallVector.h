@@ -0,0 +1,335 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_COLLECTIONS_SMALLVECTOR_H
+#define NUCLEX_SUPPORT_COLLECTIONS_SMALLVECTOR_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cassert> // for assert()
+#include <memory> // for std::unique_ptr
+#include <type_traits> // for std::aligned_storage
+#include <utility> // for std::move(), std::forward()
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Vector that stores its first few items without allocating memory</summary>
+  /// <typeparam name="TItem">Type of the items stored in the vector</typeparam>
+  /// <typeparam name="InlineCapacity">Number of items stored inside the vector itself</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Many lists in practice hold only a handful of items (the attributes of an XML
+  ///     element, the extensions of a file format). std::vector allocates memory for even
+  ///     a single item. This vector keeps up to <typeparamref name="InlineCapacity" />
+  ///     items in a buffer embedded in the vector and only moves them to the heap when
+  ///     more are added.
+  ///   </para>
+  ///   <para>
+  ///     Moving a small vector has to move the individual items if they are stored
+  ///     inline, so it isn't as cheap as moving a std::vector. This class offers
+  ///     the <em>basic</em> exception guarantee.
+  ///   </para>
+  /// </remarks>
+  template<typename TItem, std::size_t InlineCapacity = 8>
+  class SmallVector {
+
+    /// <summary>Initializes a new, empty small vector</summary>
+    public: SmallVector() :
+      heapItems(),
+      items(reinterpret_cast<TItem *>(this->inlineItems)),
+      capacity(InlineCapacity),
+      count(0) {}
+
+    /// <summary>Initializes a small vector as a copy of another small vector</summary>
+    /// <param name="other">Other small vector that will be copied</param>
+    public: SmallVector(const SmallVector &other) :
+      heapItems(),
+      items(reinterpret_cast<TItem *>(this->inlineItems)),
+      capacity(InlineCapacity),
+      count(0) {
+      Reserve(other.count);
+      for(std::size_t index = 0; index < other.count; ++index) {
+        new(this->items + index) TItem(other.items[index]);
+        ++this->count;
+      }
+    }
+
+    /// <summary>Initializes a small vector taking over another small vector</summary>
+    /// <param name="other">Other small vector that will be taken over</param>
+    public: SmallVector(SmallVector &&other) :
+      heapItems(),
+      items(reinterpret_cast<TItem *>(this->inlineItems)),
+      capacity(InlineCapacity),
+      count(0) {
+      takeOver(other);
+    }
+
+    /// <summary>Destroys the small vector and all items in it</summary>
+    public: ~SmallVector() {
+      Clear();
+    }
+
+    /// <summary>Replaces the contents of the vector with copies of another vector's items</summary>
+    /// <param name="other">Other small vector whose items will be copied</param>
+    /// <returns>The small vector itself</returns>
+    public: SmallVector &operator =(const SmallVector &other) {
+      if(&other != this) {
+        Clear();
+        Reserve(other.count);
+        for(std::size_t index = 0; index < other.count; ++index) {
+          new(this->items + index) TItem(other.items[index]);
+          ++this->count;
+        }
+      }
+      return *this;
+    }
+
+    /// <summary>Replaces the contents of the vector with another vector's items</summary>
+    /// <param name="other">Other small vector whose items will be taken over</param>
+    /// <returns>The small vector itself</returns>
+    public: SmallVector &operator =(SmallVector &&other) {
+      if(&other != this) {
+        Clear();
+        takeOver(other);
+      }
+      return *this;
+    }
+
+    /// <summary>Counts the number of items currently stored in the vector</summary>
+    /// <returns>The number of items in the vector</returns>
+    public: std::size_t Count() const {
+      return this->count;
+    }
+
+    /// <summary>Checks whether the vector currently holds any items</summary>
+    /// <returns>True if the vector holds no items</returns>
+    public: bool IsEmpty() const {
+      return (this->count == 0);
+    }
+
+    /// <summary>Returns the number of items the vector has memory for</summary>
+    /// <returns>The number of items the vector can hold without allocating memory</returns>
+    public: std::size_t GetCapacity() const {
+      return this->capacity;
+    }
+
+    /// <summary>Checks whether the items are still stored inside the vector itself</summary>
+    /// <returns>True if the vector hasn't moved its items to the heap</returns>
+    public: bool IsInline() const {
+      return !this->heapItems;
+    }
+
+    /// <summary>Ensures the vector can hold the specified number of items</summary>
+    /// <param name="itemCount">Number of items the vector should be able to hold</param>
+    public: void Reserve(std::size_t itemCount) {
+      if(itemCount > this->capacity) {
+        std::size_t newCapacity = this->capacity * 2;
+        if(newCapacity < itemCount) {
+          newCapacity = itemCount;
+        }
+        relocate(newCapacity);
+      }
+    }
+
+    /// <summary>Changes the number of items in the vector</summary>
+    /// <param name="itemCount">Number of items the vector will hold</param>
+    /// <remarks>
+    ///   Items that are added are default-constructed, surplus items at the end
+    ///   of the vector are destroyed.
+    /// </remarks>
+    public: void Resize(std::size_t itemCount) {
+      Reserve(itemCount);
+      while(this->count < itemCount) {
+        new(this->items + this->count) TItem();
+        ++this->count;
+      }
+      while(this->count > itemCount) {
+        RemoveLast();
+      }
+    }
+
+    /// <summary>Appends a copy of an item to the end of the vector</summary>
+    /// <param name="item">Item that will be copied into the vector</param>
+    public: void Add(const TItem &item) {
+      Emplace(item);
+    }
+
+    /// <summary>Moves an item to the end of the vector</summary>
+    /// <param name="item">Item that will be moved into the vector</param>
+    public: void Add(TItem &&item) {
+      Emplace(std::move(item));
+    }
+
+    /// <summary>Constructs a new item at the end of the vector</summary>
+    /// <typeparam name="TArguments">Types of the arguments for the item's constructor</typeparam>
+    /// <param name="arguments">Arguments that will be passed to the item's constructor</param>
+    /// <returns>The newly constructed item</returns>
+    public: template<typename... TArguments>
+    TItem &Emplace(TArguments &&... arguments) {
+      if(this->count == this->capacity) {
+        // Construct the item first, the arguments might refer to an item in the vector
+        TItem item(std::forward<TArguments>(arguments)...);
+        relocate(this->capacity * 2);
+        new(this->items + this->count) TItem(std::move(item));
+      } else {
+        new(this->items + this->count) TItem(std::forward<TArguments>(arguments)...);
+      }
+      ++this->count;
+      return this->items[this->count - 1];
+    }
+
+    /// <summary>Removes the last item from the vector</summary>
+    public: void RemoveLast() {
+      assert((this->count > 0) && u8"Vector must contain an item to remove");
+      --this->count;
+      this->items[this->count].~TItem();
+    }
+
+    /// <summary>Removes all items from the vector</summary>
+    /// <remarks>The vector keeps its allocated memory for reuse</remarks>
+    public: void Clear() {
+      while(this->count > 0) {
+        --this->count;
+        this->items[this->count].~TItem();
+      }
+    }
+
+    /// <summary>Accesses the item at the specified index</summary>
+    /// <param name="index">Index of the item that will be accessed</param>
+    /// <returns>The item at the specified index</returns>
+    public: const TItem &operator [](std::size_t index) const {
+      assert((index < this->count) && u8"Index must be within the vector's items");
+      return this->items[index];
+    }
+
+    /// <summary>Accesses the item at the specified index</summary>
+    /// <param name="index">Index of the item that will be accessed</param>
+    /// <returns>The item at the specified index</returns>
+    public: TItem &operator [](std::size_t index) {
+      assert((index < this->count) && u8"Index must be within the vector's items");
+      return this->items[index];
+    }
+
+    /// <summary>Provides direct access to the items stored in the vector</summary>
+    /// <returns>A pointer to the first item, followed sequentially by all other items</returns>
+    public: const TItem *Access() const {
+      return this->items;
+    }
+
+    /// <summary>Provides direct access to the items stored in the vector</summary>
+    /// <returns>A pointer to the first item, followed sequentially by all other items</returns>
+    public: TItem *Access() {
+      return this->items;
+    }
+
+    /// <summary>Returns an iterator to the first item for range-based for loops</summary>
+    /// <returns>A pointer to the first item in the vector</returns>
+    public: const TItem *begin() const { return this->items; }
+    /// <summary>Returns an iterator to the first item for range-based for loops</summary>
+    /// <returns>A pointer to the first item in the vector</returns>
+    public: TItem *begin() { return this->items; }
+    /// <summary>Returns an iterator one past the last item for range-based for loops</summary>
+    /// <returns>A pointer one past the last item in the vector</returns>
+    public: const TItem *end() const { return this->items + this->count; }
+    /// <summary>Returns an iterator one past the last item for range-based for loops</summary>
+    /// <returns>A pointer one past the last item in the vector</returns>
+    public: TItem *end() { return this->items + this->count; }
+
+    /// <summary>Uninitialized memory large enough to hold an item</summary>
+    private: typedef typename std::aligned_storage<
+      sizeof(TItem), alignof(TItem)
+    >::type ItemStorage;
+
+    /// <summary>Moves the items into a newly allocated block of memory</summary>
+    /// <param name="newCapacity">Number of items the new memory block will hold</param>
+    private: void relocate(std::size_t newCapacity) {
+      std::unique_ptr<ItemStorage[]> newHeapItems(new ItemStorage[newCapacity]);
+      TItem *newItems = reinterpret_cast<TItem *>(newHeapItems.get());
+
+      std::size_t movedCount = 0;
+      try {
+        while(movedCount < this->count) {
+          new(newItems + movedCount) TItem(std::move(this->items[movedCount]));
+          ++movedCount;
+        }
+      }
+      catch(...) {
+        while(movedCount > 0) {
+          --movedCount;
+          newItems[movedCount].~TItem();
+        }
+        throw;
+      }
+
+      for(std::size_t index = 0; index < this->count; ++index) {
+        this->items[index].~TItem();
+      }
+
+      this->heapItems = std::move(newHeapItems);
+      this->items = newItems;
+      this->capacity = newCapacity;
+    }
+
+    /// <summary>Takes over the items of another, empty vector</summary>
+    /// <param name="other">Vector whose items will be taken over</param>
+    /// <remarks>
+    ///   Heap memory simply changes owners. Inline items have to be moved one by one.
+    /// </remarks>
+    private: void takeOver(SmallVector &other) {
+      if(other.heapItems) {
+        this->heapItems = std::move(other.heapItems);
+        this->items = other.items;
+        this->capacity = other.capacity;
+        this->count = other.count;
+
+        other.items = reinterpret_cast<TItem *>(other.inlineItems);
+        other.capacity = InlineCapacity;
+        other.count = 0;
+      } else {
+        Reserve(other.count);
+        for(std::size_t index = 0; index < other.count; ++index) {
+          new(this->items + index) TItem(std::move(other.items[index]));
+          ++this->count;
+        }
+        other.Clear();
+      }
+    }
+
+    /// <summary>Memory holding the items once they no longer fit inline</summary>
+    private: std::unique_ptr<ItemStorage[]> heapItems;
+    /// <summary>Items stored in the vector, either inline or on the heap</summary>
+    private: TItem *items;
+    /// <summary>Number of items the current memory block can hold</summary>
+    private: std::size_t capacity;
+    /// <summary>Number of items currently stored in the vector</summary>
+    private: std::size_t count;
+    /// <summary>Memory holding the items while they fit inside the vector</summary>
+    private: ItemStorage inlineItems[InlineCapacity];
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
+
+#endif // NUCLEX_SUPPORT_COLLECTIONS_SMALLVECTOR_H
@@ -49,6 +49,11 @@ License along with this library
   #error The Nuclex.Pixels.Native library requires a C++14 compiler
 #endif
 
+// C++20 coroutines, the task types can be awaited with co_await if they're available
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+  #define NUCLEX_SUPPORT_HAVE_COROUTINES 1
+#endif
+
 // --------------------------------------------------------------------------------------------- //
 
 // Endianness detection
@@ -64,6 +69,16 @@ License along with this library
 
 // --------------------------------------------------------------------------------------------- //
 
+// SIMD instruction sets the compiler has been allowed to generate code for
+#if defined(__SSSE3__) || defined(__AVX__)
+  #define NUCLEX_SUPPORT_HAVE_SSSE3 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+  #define NUCLEX_SUPPORT_HAVE_SSE2 1
+#endif
+
+// --------------------------------------------------------------------------------------------- //
+
 // Decides whether symbols are imported from a dll (client app) or exported to
 // a dll (Nuclex.Support.Native library). The NUCLEX_SUPPORT_SOURCE symbol is defined by
 // all source files of the library, so you don't have to worry about a thing.
@@ -0,0 +1,151 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_CPUFEATURES_H
+#define NUCLEX_SUPPORT_CPUFEATURES_H
+
+#include "Nuclex/Support/Config.h"
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Instruction set extensions the CPU the program runs on supports</summary>
+  /// <remarks>
+  ///   <para>
+  ///     The NUCLEX_..._HAVE_... macros in the libraries' Config.h files tell which
+  ///     extensions the compiler was allowed to use everywhere. Code that wants to use
+  ///     newer extensions in a build for older CPUs compiles a separate kernel for them
+  ///     and checks here whether it can be called.
+  ///   </para>
+  ///   <para>
+  ///     The CPU is examined only once, when <see cref="Get" /> is called the first time.
+  ///     Extensions that need the operating system to save additional registers (AVX and
+  ///     AVX-512) are only reported if the operating system does so.
+  ///   </para>
+  /// </remarks>
+  struct CpuFeatures {
+
+    /// <summary>Retrieves the features of the CPU the program is running on</summary>
+    /// <returns>The features supported by the CPU</returns>
+    /// <remarks>Can be called from multiple threads, the result is cached</remarks>
+    public: NUCLEX_SUPPORT_API static const CpuFeatures &Get();
+
+    /// <summary>Whether the CPU supports SSE2 instructions</summary>
+    public: bool HasSse2;
+    /// <summary>Whether the CPU supports SSE3 instructions</summary>
+    public: bool HasSse3;
+    /// <summary>Whether the CPU supports SSSE3 instructions (pshufb and others)</summary>
+    public: bool HasSsse3;
+    /// <summary>Whether the CPU supports SSE 4.1 instructions</summary>
+    public: bool HasSse41;
+    /// <summary>Whether the CPU supports SSE 4.2 instructions (including crc32)</summary>
+    public: bool HasSse42;
+    /// <summary>Whether the CPU supports the popcnt instruction</summary>
+    public: bool HasPopcnt;
+    /// <summary>Whether the CPU and operating system support AVX instructions</summary>
+    public: bool HasAvx;
+    /// <summary>Whether the CPU and operating system support AVX2 instructions</summary>
+    public: bool HasAvx2;
+    /// <summary>Whether the CPU and operating system support fused multiply-add</summary>
+    public: bool HasFma;
+    /// <summary>Whether the CPU supports conversion from and to half floats</summary>
+    public: bool HasF16c;
+    /// <summary>Whether the CPU supports the first bit manipulation instruction set</summary>
+    public: bool HasBmi1;
+    /// <summary>Whether the CPU supports the second bit manipulation instruction set</summary>
+    public: bool HasBmi2;
+    /// <summary>Whether the CPU and operating system support AVX-512 foundation</summary>
+    public: bool HasAvx512f;
+    /// <summary>Whether AVX-512 can be used on bytes and 16 bit words</summary>
+    public: bool HasAvx512bw;
+    /// <summary>Whether AVX-512 instructions can be used on 128 and 256 bit vectors</summary>
+    public: bool HasAvx512vl;
+    /// <summary>Whether the CPU supports ARM NEON instructions</summary>
+    public: bool HasNeon;
+    /// <summary>Whether the CPU has instructions to calculate CRC-32 checksums</summary>
+    /// <remarks>
+    ///   The SSE 4.2 crc32 instruction on x86 (CRC-32C only) or the ARMv8 CRC32
+    ///   extension (CRC-32 and CRC-32C)
+    /// </remarks>
+    public: bool HasCrc32;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Picks the best kernel for the CPU the program is running on</summary>
+  /// <typeparam name="TFunction">Signature of the kernel functions</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Kernels are offered from the most to the least demanding and the first one
+  ///     the CPU supports is taken. The choice is meant to be made once and stored in
+  ///     a function-local static, so each call afterwards costs one indirect call:
+  ///   </para>
+  ///   <example>
+  ///     <code>
+  ///       static UpdateFunction *const update = KernelDispatch&lt;UpdateFunction&gt;()
+  ///         .Prefer(CpuFeatures::Get().HasAvx2, &amp;updateAvx2)
+  ///         .Prefer(CpuFeatures::Get().HasSse42, &amp;updateSse42)
+  ///         .Otherwise(&amp;updatePortable);
+  ///     </code>
+  ///   </example>
+  /// </remarks>
+  template<typename TFunction>
+  class KernelDispatch {
+
+    /// <summary>Initializes a new kernel dispatch without any kernels</summary>
+    public: KernelDispatch() : kernel(nullptr) {}
+
+    /// <summary>Offers a kernel that will be used if the CPU supports it</summary>
+    /// <param name="isSupported">Whether the CPU has what the kernel needs</param>
+    /// <param name="candidate">Kernel that will be used if supported</param>
+    /// <returns>The kernel dispatch itself so more kernels can be offered</returns>
+    /// <remarks>
+    ///   Ignored if a kernel offered earlier is supported already
+    /// </remarks>
+    public: KernelDispatch &Prefer(bool isSupported, TFunction *candidate) {
+      if(isSupported && (this->kernel == nullptr)) {
+        this->kernel = candidate;
+      }
+      return *this;
+    }
+
+    /// <summary>Returns the chosen kernel or a fallback that works everywhere</summary>
+    /// <param name="fallback">Kernel that will be used if none of the others can</param>
+    /// <returns>The best kernel the CPU supports</returns>
+    public: TFunction *Otherwise(TFunction *fallback) const {
+      if(this->kernel == nullptr) {
+        return fallback;
+      } else {
+        return this->kernel;
+      }
+    }
+
+    /// <summary>Best kernel supported by the CPU so far</summary>
+    private: TFunction *kernel;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
+
+#endif // NUCLEX_SUPPORT_CPUFEATURES_H
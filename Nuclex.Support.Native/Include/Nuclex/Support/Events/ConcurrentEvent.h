@@ -0,0 +1,461 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_EVENTS_CONCURRENTEVENT_H
+#define NUCLEX_SUPPORT_EVENTS_CONCURRENTEVENT_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Events/Delegate.h"
+#include "Nuclex/Support/AllocationTracker.h"
+
+#include <atomic> // for std::atomic
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+#include <iterator> // for std::back_inserter()
+#include <type_traits> // for std::enable_if<>, std::is_void<>
+#include <utility> // for std::move()
+
+namespace Nuclex { namespace Support { namespace Events {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  // Prototype, required for variable argument template
+  template<typename> class ConcurrentEvent;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Thread-safe event whose emission never takes a lock</summary>
+  /// <typeparam name="TResult">Type that will be returned from the method</typeparam>
+  /// <typeparam name="TArguments">Types of the arguments accepted by the callback</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Works like the <see cref="Event" />, but can be emitted from any number of threads
+  ///     while other threads subscribe and unsubscribe. The subscribers are kept in an
+  ///     immutable list that is published through an atomic pointer. Subscribing or
+  ///     unsubscribing builds a new list under a mutex and swaps it in, so emitting is
+  ///     wait-free: it bumps a counter, iterates over whichever list is current and
+  ///     drops the counter again.
+  ///   </para>
+  ///   <para>
+  ///     Lists that have been replaced can't be freed while an emission may still be
+  ///     walking them. They are set aside and freed by the next subscription change
+  ///     that finds no emission in progress (or when the event is destroyed). Under
+  ///     non-stop emission, replaced lists thus pile up until there is a quiet moment,
+  ///     which is fine for the intended use where subscriptions change rarely.
+  ///   </para>
+  ///   <para>
+  ///     An emission notifies the subscribers that were present when it began. Subscribers
+  ///     can subscribe and unsubscribe (themselves or others) from within a callback, that
+  ///     change affects the next emission. Because of this, a subscriber can still be
+  ///     called by an emission running concurrently in another thread immediately after
+  ///     <see cref="Unsubscribe" /> has returned.
+  ///   </para>
+  ///   <para>
+  ///     This is heavier than the <see cref="Event" /> in both size and subscription cost,
+  ///     so prefer the plain event where everything happens on one thread.
+  ///   </para>
+  /// </remarks>
+  template<typename TResult, typename... TArguments>
+  class ConcurrentEvent<TResult(TArguments...)> {
+
+    /// <summary>Type of value that will be returned by the delegate</summary>
+    public: typedef TResult ResultType;
+    /// <summary>Method signature for the callbacks notified through this event</summary>
+    public: typedef TResult CallType(TArguments...);
+    /// <summary>Type of delegate used to call the event's subscribers</summary>
+    public: typedef Delegate<TResult(TArguments...)> DelegateType;
+
+    /// <summary>Initializes a new concurrent event</summary>
+    public: ConcurrentEvent() :
+      subscribers(nullptr),
+      activeEmissionCount(0) {}
+
+    /// <summary>Frees all memory used by the event</summary>
+    /// <remarks>
+    ///   The event must not be destroyed while it is being emitted or subscribed to.
+    /// </remarks>
+    public: ~ConcurrentEvent() {
+      delete this->subscribers.load(std::memory_order_relaxed);
+      for(std::size_t index = 0; index < this->retiredSubscribers.size(); ++index) {
+        delete this->retiredSubscribers[index];
+      }
+    }
+
+    /// <summary>Returns the current number of subscribers to the event</summary>
+    /// <returns>The number of current subscribers</returns>
+    /// <remarks>
+    ///   If other threads are changing the subscriptions, the number may already be
+    ///   outdated when this method returns.
+    /// </remarks>
+    public: std::size_t CountSubscribers() const {
+      std::lock_guard<std::mutex> subscriptionScope(this->subscriptionMutex);
+
+      const SubscriberList *current = this->subscribers.load(std::memory_order_relaxed);
+      if(current == nullptr) {
+        return 0;
+      } else {
+        return current->size();
+      }
+    }
+
+    /// <summary>Calls all subscribers of the event and collects their return values</summary>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    /// <returns>An list of the values returned by the event subscribers</returns>
+    /// <remarks>
+    ///   This overload is enabled if the event signature returns anything other than 'void' 
+    /// </remarks>
+    public: template<typename T = TResult>
+    typename std::enable_if<
+      !std::is_void<T>::value, std::vector<TResult>
+    >::type operator()(TArguments&&... arguments) const {
+      std::vector<TResult> results;
+      EmitAndCollect(std::back_inserter(results), std::forward<TArguments>(arguments)...);
+      return results;
+    }
+
+    /// <summary>Calls all subscribers of the event</summary>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    /// <remarks>
+    ///   This overload is enabled if the event signature has the return type 'void' 
+    /// </remarks>
+    public: template<typename T = TResult>
+    typename std::enable_if<
+      std::is_void<T>::value, void
+    >::type operator()(TArguments&&... arguments) const {
+      Emit(std::forward<TArguments>(arguments)...);
+    }
+
+    /// <summary>Calls all subscribers of the event and collects their return values</summary>
+    /// <param name="results">
+    ///   Output iterator into which the subscribers' return values will be written
+    /// </param>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    public: template<typename TOutputIterator>
+    void EmitAndCollect(TOutputIterator results, TArguments&&... arguments) const {
+      EmissionScope emission(this->activeEmissionCount);
+
+      const SubscriberList *current = this->subscribers.load(std::memory_order_seq_cst);
+      if(current != nullptr) {
+        std::size_t subscriberCount = current->size();
+        for(std::size_t index = 0; index < subscriberCount; ++index) {
+          *results = (*current)[index](arguments...);
+          ++results;
+        }
+      }
+    }
+
+    /// <summary>Calls all subscribers of the event and stores their return values</summary>
+    /// <param name="results">Array into which the return values will be written</param>
+    /// <param name="resultCapacity">Number of return values the array can hold</param>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    /// <returns>The number of subscribers that have been called</returns>
+    /// <remarks>
+    ///   Works like <see cref="Event.EmitAndCollectInto" />: all subscribers are called,
+    ///   but only as many return values as fit into the array are stored.
+    /// </remarks>
+    public: template<typename T = TResult>
+    typename std::enable_if<
+      !std::is_void<T>::value, std::size_t
+    >::type EmitAndCollectInto(
+      TResult *results, std::size_t resultCapacity, TArguments&&... arguments
+    ) const {
+      EmissionScope emission(this->activeEmissionCount);
+
+      const SubscriberList *current = this->subscribers.load(std::memory_order_seq_cst);
+      if(current == nullptr) {
+        return 0;
+      }
+
+      std::size_t subscriberCount = current->size();
+      for(std::size_t index = 0; index < subscriberCount; ++index) {
+        if(index < resultCapacity) {
+          results[index] = (*current)[index](arguments...);
+        } else {
+          (*current)[index](arguments...);
+        }
+      }
+
+      return subscriberCount;
+    }
+
+    /// <summary>Calls all subscribers of the event and combines their return values</summary>
+    /// <typeparam name="TAccumulated">Type of the combined value</typeparam>
+    /// <typeparam name="TReducer">Method that combines the values</typeparam>
+    /// <param name="initial">Value the combined value starts out as</param>
+    /// <param name="reducer">
+    ///   Will be called with the combined value so far and a subscriber's return value,
+    ///   must return the new combined value
+    /// </param>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    /// <returns>The combined value after all subscribers have been called</returns>
+    public: template<typename TAccumulated, typename TReducer>
+    TAccumulated EmitAndReduce(
+      TAccumulated initial, TReducer &&reducer, TArguments&&... arguments
+    ) const {
+      EmissionScope emission(this->activeEmissionCount);
+
+      const SubscriberList *current = this->subscribers.load(std::memory_order_seq_cst);
+      if(current != nullptr) {
+        std::size_t subscriberCount = current->size();
+        for(std::size_t index = 0; index < subscriberCount; ++index) {
+          initial = reducer(std::move(initial), (*current)[index](arguments...));
+        }
+      }
+
+      return initial;
+    }
+
+    /// <summary>Calls subscribers of the event until one of them gives a certain answer</summary>
+    /// <typeparam name="TPredicate">Method that checks the subscribers' return values</typeparam>
+    /// <param name="predicate">
+    ///   Will be called with each subscriber's return value, stops the emission if
+    ///   it returns true
+    /// </param>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    /// <returns>True if the predicate stopped the emission, false otherwise</returns>
+    public: template<typename TPredicate, typename T = TResult>
+    typename std::enable_if<
+      !std::is_void<T>::value, bool
+    >::type EmitUntil(TPredicate &&predicate, TArguments&&... arguments) const {
+      EmissionScope emission(this->activeEmissionCount);
+
+      const SubscriberList *current = this->subscribers.load(std::memory_order_seq_cst);
+      if(current != nullptr) {
+        std::size_t subscriberCount = current->size();
+        for(std::size_t index = 0; index < subscriberCount; ++index) {
+          if(predicate((*current)[index](arguments...))) {
+            return true;
+          }
+        }
+      }
+
+      return false;
+    }
+
+    /// <summary>Calls all subscribers of the event and discards their return values</summary>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    public: void Emit(TArguments... arguments) const {
+      EmissionScope emission(this->activeEmissionCount);
+
+      const SubscriberList *current = this->subscribers.load(std::memory_order_seq_cst);
+      if(current != nullptr) {
+        std::size_t subscriberCount = current->size();
+        for(std::size_t index = 0; index < subscriberCount; ++index) {
+          (*current)[index](arguments...);
+        }
+      }
+    }
+
+    /// <summary>Subscribes the specified free function to the event</summary>
+    /// <typeparam name="TMethod">Free function that will be subscribed</typeparam>
+    public: template<TResult(*TMethod)(TArguments...)>
+    void Subscribe() {
+      Subscribe(DelegateType::template Create<TMethod>());
+    }
+
+    /// <summary>Subscribes the specified object method to the event</summary>
+    /// <typeparam name="TClass">Class the object method is a member of</typeparam>
+    /// <typeparam name="TMethod">Object method that will be subscribed to the event</typeparam>
+    /// <param name="instance">Instance on which the object method will be called</param>
+    public: template<typename TClass, TResult(TClass::*TMethod)(TArguments...)>
+    void Subscribe(TClass *instance) {
+      Subscribe(DelegateType::template Create<TClass, TMethod>(instance));
+    }
+
+    /// <summary>Subscribes the specified const object method to the event</summary>
+    /// <typeparam name="TClass">Class the object method is a member of</typeparam>
+    /// <typeparam name="TMethod">Object method that will be subscribed to the event</typeparam>
+    /// <param name="instance">Instance on which the object method will be called</param>
+    public: template<typename TClass, TResult(TClass::*TMethod)(TArguments...) const>
+    void Subscribe(const TClass *instance) {
+      Subscribe(DelegateType::template Create<TClass, TMethod>(instance));
+    }
+
+    /// <summary>Subscribes a lambda expression or functor to the event</summary>
+    /// <typeparam name="TCallable">Type of the lambda expression or functor</typeparam>
+    /// <param name="callable">Lambda expression or functor that will be subscribed</param>
+    /// <remarks>
+    ///   The callable is stored inside the delegate without allocating memory, see
+    ///   <see cref="Delegate" /> for the limits on what it can capture.
+    /// </remarks>
+    public: template<typename TCallable>
+    void Subscribe(const TCallable &callable) {
+      Subscribe(DelegateType::Create(callable));
+    }
+
+    /// <summary>Subscribes the specified delegate to the event</summary>
+    /// <param name="delegate">Delegate that will be subscribed</param>
+    public: void Subscribe(const DelegateType &delegate) {
+      std::lock_guard<std::mutex> subscriptionScope(this->subscriptionMutex);
+
+      const SubscriberList *current = this->subscribers.load(std::memory_order_relaxed);
+
+      SubscriberList *replacement;
+      if(current == nullptr) {
+        replacement = new SubscriberList(1, delegate);
+      } else {
+        replacement = new SubscriberList();
+        replacement->reserve(current->size() + 1);
+        replacement->assign(current->begin(), current->end());
+        replacement->push_back(delegate);
+      }
+
+      publish(replacement);
+    }
+
+    /// <summary>Unsubscribes the specified free function from the event</summary>
+    /// <typeparam name="TMethod">
+    ///   Free function that will be unsubscribed from the event
+    /// </typeparam>
+    /// <returns>True if the object method was subscribed and has been unsubscribed</returns>
+    public: template<TResult(*TMethod)(TArguments...)>
+    bool Unsubscribe() {
+      return Unsubscribe(DelegateType::template Create<TMethod>());
+    }
+
+    /// <summary>Unsubscribes the specified object method from the event</summary>
+    /// <typeparam name="TClass">Class the object method is a member of</typeparam>
+    /// <typeparam name="TMethod">
+    ///   Object method that will be unsubscribes from the event
+    /// </typeparam>
+    /// <param name="instance">Instance on which the object method was subscribed</param>
+    /// <returns>True if the object method was subscribed and has been unsubscribed</returns>
+    public: template<typename TClass, TResult(TClass::*TMethod)(TArguments...)>
+    bool Unsubscribe(TClass *instance) {
+      return Unsubscribe(DelegateType::template Create<TClass, TMethod>(instance));
+    }
+
+    /// <summary>Unsubscribes the specified object method from the event</summary>
+    /// <typeparam name="TClass">Class the object method is a member of</typeparam>
+    /// <typeparam name="TMethod">
+    ///   Object method that will be unsubscribes from the event
+    /// </typeparam>
+    /// <param name="instance">Instance on which the object method was subscribed</param>
+    /// <returns>True if the object method was subscribed and has been unsubscribed</returns>
+    public: template<typename TClass, TResult(TClass::*TMethod)(TArguments...) const>
+    bool Unsubscribe(const TClass *instance) {
+      return Unsubscribe(DelegateType::template Create<TClass, TMethod>(instance));
+    }
+
+    /// <summary>Unsubscribes a lambda expression or functor from the event</summary>
+    /// <typeparam name="TCallable">Type of the lambda expression or functor</typeparam>
+    /// <param name="callable">Lambda expression or functor that was subscribed</param>
+    /// <returns>True if the callable was subscribed and has been unsubscribed</returns>
+    public: template<typename TCallable>
+    bool Unsubscribe(const TCallable &callable) {
+      return Unsubscribe(DelegateType::Create(callable));
+    }
+
+    /// <summary>Unsubscribes the specified delegate from the event</summary>
+    /// <param name="delegate">Delegate that will be unsubscribed</param>
+    /// <returns>True if the callback was found and unsubscribed, false otherwise</returns>
+    public: bool Unsubscribe(const DelegateType &delegate) {
+      std::lock_guard<std::mutex> subscriptionScope(this->subscriptionMutex);
+
+      const SubscriberList *current = this->subscribers.load(std::memory_order_relaxed);
+      if(current == nullptr) {
+        return false;
+      }
+
+      // Search from the back, often the removed subscriber is the last one registered
+      std::size_t subscriberCount = current->size();
+      for(std::size_t index = subscriberCount; index > 0; --index) {
+        if((*current)[index - 1] == delegate) {
+          SubscriberList *replacement = nullptr;
+          if(subscriberCount > 1) {
+            replacement = new SubscriberList();
+            replacement->reserve(subscriberCount - 1);
+            replacement->assign(current->begin(), current->begin() + (index - 1));
+            replacement->insert(replacement->end(), current->begin() + index, current->end());
+          }
+
+          publish(replacement);
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /// <summary>Immutable list of subscribers published to emitting threads</summary>
+    private: typedef std::vector<
+      DelegateType, TrackingAllocator<DelegateType, AllocationSubsystem::Events>
+    > SubscriberList;
+
+    /// <summary>Counts an emission as active for as long as the scope exists</summary>
+    private: class EmissionScope {
+
+      /// <summary>Registers an emission as active</summary>
+      /// <param name="activeEmissionCount">Counter of active emissions</param>
+      public: EmissionScope(std::atomic<std::size_t> &activeEmissionCount) :
+        activeEmissionCount(activeEmissionCount) {
+        activeEmissionCount.fetch_add(1, std::memory_order_seq_cst);
+      }
+
+      /// <summary>Unregisters the emission again</summary>
+      public: ~EmissionScope() {
+        this->activeEmissionCount.fetch_sub(1, std::memory_order_release);
+      }
+
+      /// <summary>Counter of active emissions that was incremented</summary>
+      private: std::atomic<std::size_t> &activeEmissionCount;
+
+    };
+
+    /// <summary>Publishes a new subscriber list and retires the previous one</summary>
+    /// <param name="replacement">Subscriber list that will become the current one</param>
+    /// <remarks>
+    ///   Must be called with the subscription mutex held. An emission that is using
+    ///   the previous list incremented the emission counter before it loaded the list,
+    ///   so if the counter reads zero after the exchange, nobody can still see any
+    ///   replaced list and all of them can be freed.
+    /// </remarks>
+    private: void publish(SubscriberList *replacement) {
+      SubscriberList *previous = this->subscribers.exchange(
+        replacement, std::memory_order_seq_cst
+      );
+      if(previous != nullptr) {
+        this->retiredSubscribers.push_back(previous);
+      }
+
+      if(this->activeEmissionCount.load(std::memory_order_seq_cst) == 0) {
+        for(std::size_t index = 0; index < this->retiredSubscribers.size(); ++index) {
+          delete this->retiredSubscribers[index];
+        }
+        this->retiredSubscribers.clear();
+      }
+    }
+
+    /// <summary>Current list of subscribers, null if there are none</summary>
+    private: std::atomic<SubscriberList *> subscribers;
+    /// <summary>Number of emissions currently walking a subscriber list</summary>
+    private: mutable std::atomic<std::size_t> activeEmissionCount;
+    /// <summary>Must be held while the subscriptions are changed</summary>
+    private: mutable std::mutex subscriptionMutex;
+    /// <summary>Replaced subscriber lists that may still be in use by emissions</summary>
+    private: std::vector<SubscriberList *> retiredSubscribers;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Events
+
+#endif // NUCLEX_SUPPORT_EVENTS_CONCURRENTEVENT_H
@@ -25,6 +25,10 @@ License along with this library
 #include "Nuclex/Support/Events/EmptyDelegateCallError.h"
 
 #include <cassert>
+#include <cstdint> // for std::uint8_t
+#include <cstring> // for std::memcmp(), std::memset()
+#include <new> // for placement new
+#include <type_traits> // for std::is_trivially_copyable, std::is_trivially_destructible
 
 namespace Nuclex { namespace Support { namespace Events {
 
@@ -55,7 +59,15 @@ namespace Nuclex { namespace Support { namespace Events {
   ///     systems (aka. signals/slots) that can be unregistered without magic handles.
   ///   </para>
   ///   <para>
-  ///     A delegate should be equivalent in size to two pointers.
+  ///     Lambda expressions and other functors are stored inside the delegate itself,
+  ///     so they may capture up to <see cref="MaximumCallableSize" /> bytes and must be
+  ///     trivially copyable (capture pointers, references and plain values, not strings
+  ///     or smart pointers). Larger or non-trivial captures are rejected at compile time.
+  ///     Two lambda delegates compare equal if they were created from the same lambda
+  ///     object, so keep the lambda in a variable if it needs to be unsubscribed later.
+  ///   </para>
+  ///   <para>
+  ///     A delegate should be equivalent in size to three pointers.
   ///   </para>
   ///   <para>
   ///     Usage example:
@@ -95,6 +107,9 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <summary>Method signature for the callbacks notified through this event</summary>
     public: typedef TResult CallType(TArguments...);
 
+    /// <summary>Largest lambda expression or functor a delegate can store in bytes</summary>
+    public: static const std::size_t MaximumCallableSize = sizeof(void *[2]);
+
     /// <summary>Creates a delegate that will invoke the specified free function</summary>
     /// <typeparam name="TMethod">Free function that will be called by the delegate</typeparam>
     /// <returns>A delegate that invokes the specified free</returns>
@@ -131,6 +146,35 @@ namespace Nuclex { namespace Support { namespace Events {
       );
     }
 
+    /// <summary>Creates a delegate that will invoke a lambda expression or functor</summary>
+    /// <typeparam name="TCallable">Type of the lambda expression or functor</typeparam>
+    /// <param name="callable">Lambda expression or functor that will be invoked</param>
+    /// <returns>A delegate that invokes a copy of the specified callable</returns>
+    /// <remarks>
+    ///   The callable is copied into the delegate, no memory is allocated. It is invoked
+    ///   as const, so lambda expressions declared 'mutable' can not be used.
+    /// </remarks>
+    public: template<typename TCallable>
+    static Delegate Create(const TCallable &callable) {
+      static_assert(
+        sizeof(TCallable) <= MaximumCallableSize,
+        "Lambda captures too much to be stored in a delegate, capture by reference instead"
+      );
+      static_assert(
+        alignof(TCallable) <= alignof(void *),
+        "Lambda or functor requires a stricter alignment than a delegate provides"
+      );
+      static_assert(
+        std::is_trivially_copyable<TCallable>::value &&
+        std::is_trivially_destructible<TCallable>::value,
+        "Lambda or functor stored in a delegate must be trivially copyable and destructible"
+      );
+
+      Delegate delegate(nullptr, &Delegate::callStoredCallable<TCallable>);
+      new(delegate.storage) TCallable(callable);
+      return delegate;
+    }
+
     /// <summary>Initializes a new delegate as copy of an existing delegate</summary>
     /// <param name="other">Existing delegate that will be copied</param>
     public: Delegate(const Delegate &other) = default;
@@ -146,9 +190,9 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <param name="other">Existing delegate that will be taken over</param>
 #if _DEBUG
     public: Delegate(Delegate &&other) :
-      instance(other.instance),
       method(other.method) {
-      other.instance = nullptr;
+      std::memcpy(this->storage, other.storage, MaximumCallableSize);
+      other.setInstance(nullptr);
       other.method = &Delegate::errorDelegateDestroyed;
     }
 #else
@@ -158,7 +202,7 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <summary>Frees all resources owned by the delegate</summary>
 #if _DEBUG
     public: ~Delegate() {
-      this->instance = nullptr;
+      setInstance(nullptr);
       this->method = &Delegate::errorDelegateDestroyed;
     }
 #else
@@ -184,7 +228,7 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <typeparam name="TMethod">Free function that will be called by the delegate</typeparam>
     public: template<TResult(*TMethod)(TArguments...)>
     void Reset() {
-      this->instance = nullptr;
+      setInstance(nullptr);
       this->method = &Delegate::callFreeFunction<TMethod>;
     }
 
@@ -194,7 +238,7 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <param name="instance">Instance on which the object method will be called</param>
     public: template<typename TClass, TResult(TClass::*TMethod)(TArguments...)>
     void Reset(TClass *instance) {
-      this->instance = reinterpret_cast<void *>(instance);
+      setInstance(reinterpret_cast<void *>(instance));
       this->method = &Delegate::callObjectMethod<TClass, TMethod>;
     }
 
@@ -207,10 +251,18 @@ namespace Nuclex { namespace Support { namespace Events {
       // Note: This const cast is fine. Casting away const is allowed if you do not
       // ever modify the object that way. We're only casting it away for storage,
       // the callConstObjectMethod() call wrapper will cast it on again before calling.
-      this->instance = const_cast<void *>(reinterpret_cast<const void *>(instance));
+      setInstance(const_cast<void *>(reinterpret_cast<const void *>(instance)));
       this->method = &Delegate::callConstObjectMethod<TClass, TMethod>;
     }
 
+    /// <summary>Resets the delegate to a lambda expression or functor</summary>
+    /// <typeparam name="TCallable">Type of the lambda expression or functor</typeparam>
+    /// <param name="callable">Lambda expression or functor that will be invoked</param>
+    public: template<typename TCallable>
+    void Reset(const TCallable &callable) {
+      *this = Create(callable);
+    }
+
     /// <summary>Makes this delegate a copy of another delegate</summary>
     /// <param name="other">Other delegate that will be copied</param>
     /// <returns>This delegate</returns>
@@ -221,9 +273,9 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <returns>This delegate</returns>
 #if _DEBUG
     public: Delegate &operator =(Delegate &&other) {
-      this->instance = other.instance;
+      std::memcpy(this->storage, other.storage, MaximumCallableSize);
       this->method = other.method;
-      other.instance = nullptr;
+      other.setInstance(nullptr);
       other.method = &Delegate::errorDelegateDestroyed;
     }
 #else
@@ -240,8 +292,8 @@ namespace Nuclex { namespace Support { namespace Events {
         return false; // To avoid comparing uninitialized vars (even if of no consequence)
       } else {
         return (
-          (this->instance == other.instance) &&
-          (this->method == other.method)
+          (this->method == other.method) &&
+          (std::memcmp(this->storage, other.storage, MaximumCallableSize) == 0)
         );
       }
     }
@@ -256,8 +308,8 @@ namespace Nuclex { namespace Support { namespace Events {
         return true; // To avoid comparing uninitialized vars (even if of no consequence)
       } else {
         return (
-          (this->instance != other.instance) ||
-          (this->method != other.method)
+          (this->method != other.method) ||
+          (std::memcmp(this->storage, other.storage, MaximumCallableSize) != 0)
         );
       }
     }
@@ -281,15 +333,28 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <param name="instance">Address that will be assigned to the instance field</param>
     /// <param name="callWrapperMethod">Method used to call the delegate's target</param>
     private: Delegate(void *instance, CallWrapperType callWrapperMethod) :
-      instance(instance),
-      method(callWrapperMethod) {}
+      storage(),
+      method(callWrapperMethod) {
+      this->instance = instance;
+    }
 
     /// <summary>Special constructor for internal use by the named constructor methods</summary>
     /// <param name="callWrapperMethod">Method used to call the delegate's target</param>
     private: Delegate(CallWrapperType callWrapperMethod) :
-      instance(nullptr),
+      storage(),
       method(callWrapperMethod) {}
 
+    /// <summary>Stores an instance pointer and clears the remaining storage</summary>
+    /// <param name="instance">Address that will be assigned to the instance field</param>
+    /// <remarks>
+    ///   Delegates are compared by the bytes of their storage, so whatever a lambda
+    ///   expression left behind must not linger behind the instance pointer.
+    /// </remarks>
+    private: void setInstance(void *instance) {
+      std::memset(this->storage, 0, MaximumCallableSize);
+      this->instance = instance;
+    }
+
     /// <summary>Call wrapper that throws an exception if an empty delegate is called</summary>
     /// <returns>The result of the called method or function</returns>
     private: TResult callEmptyDelegate(TArguments...) const {
@@ -329,6 +394,14 @@ namespace Nuclex { namespace Support { namespace Events {
       return (typedInstance->*TObjectMethod)(std::forward<TArguments>(arguments)...);
     }
 
+    /// <summary>Call wrapper that invokes a lambda expression or functor</summary>
+    /// <typeparam name="TCallable">Type of the lambda expression or functor</typeparam>
+    private: template<typename TCallable>
+    TResult callStoredCallable(TArguments... arguments) const {
+      const TCallable &callable = *reinterpret_cast<const TCallable *>(this->storage);
+      return callable(std::forward<TArguments>(arguments)...);
+    }
+
 #if _DEBUG
     /// <summary>Call wrapper that reports when the delegate is called after </summary>
     /// <typeparam name="TFreeFunction">Function that will be invoked</typeparam>
@@ -340,8 +413,13 @@ namespace Nuclex { namespace Support { namespace Events {
     }
 #endif
 
-    /// <summary>Instance on which the callback will take place, if applicable<summary>
-    private: void *instance;
+    /// <summary>Target-specific data, either an instance pointer or a callable</summary>
+    private: union {
+      /// <summary>Instance on which the callback will take place, if applicable<summary>
+      void *instance;
+      /// <summary>Lambda expression or functor invoked by the delegate, if applicable</summary>
+      alignas(void *) std::uint8_t storage[MaximumCallableSize];
+    };
     /// <summary>Address of the call wrapper that will call the subscribed method</summary>
     private: CallWrapperType method;
 
@@ -23,6 +23,7 @@ License along with this library
 
 #include "Nuclex/Support/Config.h"
 #include "Nuclex/Support/Events/Delegate.h"
+#include "Nuclex/Support/AllocationTracker.h"
 
 #include <functional>
 #include <algorithm>
@@ -32,14 +33,25 @@ namespace Nuclex { namespace Support { namespace Events {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Number of subscribers events store without allocating memory by default</summary>
+  const std::size_t DefaultBuiltInSubscriberCount = 2;
+
+  // ------------------------------------------------------------------------------------------- //
+
   // Prototype, required for variable argument template
-  template<typename> class Event;
+  template<
+    typename TSignature, std::size_t TBuiltInSubscriberCount = DefaultBuiltInSubscriberCount
+  >
+  class Event;
 
   // ------------------------------------------------------------------------------------------- //
 
   /// <summary>Manages a list of subscribers that receive callback when the event fires</summary>
   /// <typeparam name="TResult">Type that will be returned from the method</typeparam>
   /// <typeparam name="TArguments">Types of the arguments accepted by the callback</typeparam>
+  /// <typeparam name="TBuiltInSubscriberCount">
+  ///   Number of subscribers the event can store without allocating heap memory
+  /// </typeparam>
   /// <remarks>
   ///   <para>
   ///     This is the signal part of a standard signal/slot implementation. The name has been
@@ -61,8 +73,10 @@ namespace Nuclex { namespace Support { namespace Events {
   ///     new event subscriptions from within a call is supported, too.
   ///   </para>
   ///   <para>
-  ///     An event should be equivalent in size to 5 pointers (depending on the
-  ///     value of the <see cref="BuiltInSubscriberCount" /> constant))
+  ///     An event should be equivalent in size to 5 pointers with the default
+  ///     built-in subscriber count. Events that routinely have more subscribers can
+  ///     raise the count to avoid the heap allocation, each extra subscriber costs
+  ///     the size of one delegate (two pointers).
   ///   </para>
   ///   <para>
   ///     Usage example:
@@ -96,17 +110,20 @@ namespace Nuclex { namespace Support { namespace Events {
   ///     </code>
   ///   </para>
   /// </remarks>
-  template<typename TResult, typename... TArguments>
-  class Event<TResult(TArguments...)> {
+  template<typename TResult, typename... TArguments, std::size_t TBuiltInSubscriberCount>
+  class Event<TResult(TArguments...), TBuiltInSubscriberCount> {
+
+    static_assert(
+      TBuiltInSubscriberCount >= 1, u8"Events need space for at least one built-in subscriber"
+    );
 
     /// <summary>Number of subscribers the event can subscribe withou allocating memory</summary>
     /// <remarks>
-    ///   To reduce complexity, this value is baked in and not a template argument. It is
-    ///   the number of subscriber slots that are baked into the event, enabling it to handle
-    ///   a small number of subscribers without allocating heap memory. Each slot takes the size
-    ///   of a delegate, 64 bits on a 32 bit system or 128 bits on a 64 bit system.
+    ///   It is the number of subscriber slots that are baked into the event, enabling it to
+    ///   handle a small number of subscribers without allocating heap memory. Each slot takes
+    ///   the size of a delegate, 64 bits on a 32 bit system or 128 bits on a 64 bit system.
     /// </remarks>
-    private: const static std::size_t BuiltInSubscriberCount = 2;
+    private: const static std::size_t BuiltInSubscriberCount = TBuiltInSubscriberCount;
 
     /// <summary>Type of value that will be returned by the delegate</summary>
     public: typedef TResult ResultType;
@@ -122,7 +139,11 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <summary>Frees all memory used by the event</summary>
     public: ~Event() {
       if(this->subscriberCount > BuiltInSubscriberCount) {
-        delete []this->heapMemory.Buffer;
+        AllocationTracker::Deallocate(
+          AllocationSubsystem::Events,
+          this->heapMemory.Buffer,
+          sizeof(DelegateType[2]) * this->heapMemory.ReservedSubscriberCount / 2
+        );
       }
     }
 
@@ -167,117 +188,118 @@ namespace Nuclex { namespace Support { namespace Events {
     /// <param name="arguments">Arguments that will be passed to the event</param>
     public: template<typename TOutputIterator>
     void EmitAndCollect(TOutputIterator results, TArguments&&... arguments) const {
-      std::size_t knownSubscriberCount = this->subscriberCount;
-
-      const DelegateType *subscribers;
-      std::size_t index = 0;
-
-      // Is the subscriber list currently on the stack?
-      if(knownSubscriberCount <= BuiltInSubscriberCount) {
-        ProcessStackSubscribers:
-        subscribers = reinterpret_cast<const DelegateType *>(this->stackMemory);
-        while(index < knownSubscriberCount) {
-          *results = subscribers[index](std::forward<TArguments>(arguments)...);
+      visitSubscribers(
+        [&](const DelegateType &subscriber) {
+          *results = subscriber(std::forward<TArguments>(arguments)...);
           ++results;
-          if(this->subscriberCount == knownSubscriberCount) {
-            ++index; // Only increment if the current callback wasn't unsubscribed
-          } else if(this->subscriberCount > knownSubscriberCount) {
-            ++index;
-            if(knownSubscriberCount > BuiltInSubscriberCount) {
-              knownSubscriberCount = this->subscriberCount;
-              goto ProcessHeapSubscribers;
-            }
-            knownSubscriberCount = this->subscriberCount;
-          } else {
-            knownSubscriberCount = this->subscriberCount;
-          }
+          return true;
         }
+      );
+    }
 
-        return;
-      }
-
-      // The subscriber list is currently on the heap
-      {
-        ProcessHeapSubscribers:
-        subscribers = reinterpret_cast<const DelegateType *>(this->heapMemory.Buffer);
-        while(index < knownSubscriberCount) {
-          *results = subscribers[index](std::forward<TArguments>(arguments)...);
-          ++results;
-          if(this->subscriberCount == knownSubscriberCount) {
-            ++index; // Only increment if the current callback wasn't unsubscribed
-          } else if(this->subscriberCount < knownSubscriberCount) {
-            if(knownSubscriberCount <= BuiltInSubscriberCount) {
-              knownSubscriberCount = this->subscriberCount;
-              goto ProcessStackSubscribers;
-            }
-            knownSubscriberCount = this->subscriberCount;
+    /// <summary>Calls all subscribers of the event and stores their return values</summary>
+    /// <param name="results">Array into which the return values will be written</param>
+    /// <param name="resultCapacity">Number of return values the array can hold</param>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    /// <returns>The number of subscribers that have been called</returns>
+    /// <remarks>
+    ///   <para>
+    ///     Lets an event be polled without any heap allocation by reusing a fixed-size
+    ///     array for the results. All subscribers are called even if the array is too
+    ///     small, but only the first <paramref name="resultCapacity" /> return values
+    ///     are stored. The return value tells how many there would have been.
+    ///   </para>
+    ///   <para>
+    ///     Because subscribers may subscribe or unsubscribe during the call, the number
+    ///     of results doesn't have to match the subscriber count before or after the call.
+    ///   </para>
+    /// </remarks>
+    public: template<typename T = TResult>
+    typename std::enable_if<
+      !std::is_void<T>::value, std::size_t
+    >::type EmitAndCollectInto(
+      TResult *results, std::size_t resultCapacity, TArguments&&... arguments
+    ) const {
+      std::size_t calledSubscriberCount = 0;
+      visitSubscribers(
+        [&](const DelegateType &subscriber) {
+          if(calledSubscriberCount < resultCapacity) {
+            results[calledSubscriberCount] = subscriber(
+              std::forward<TArguments>(arguments)...
+            );
           } else {
-            ++index;
-            knownSubscriberCount = this->subscriberCount;
-            // In case more heap memory had to be allocated
-            subscribers = reinterpret_cast<const DelegateType *>(this->heapMemory.Buffer);
+            subscriber(std::forward<TArguments>(arguments)...);
           }
+          ++calledSubscriberCount;
+          return true;
         }
+      );
 
-        return;
-      }
+      return calledSubscriberCount;
     }
 
-    /// <summary>Calls all subscribers of the event and discards their return values</summary>
+    /// <summary>Calls all subscribers of the event and combines their return values</summary>
+    /// <typeparam name="TAccumulated">Type of the combined value</typeparam>
+    /// <typeparam name="TReducer">Method that combines the values</typeparam>
+    /// <param name="initial">Value the combined value starts out as</param>
+    /// <param name="reducer">
+    ///   Will be called with the combined value so far and a subscriber's return value,
+    ///   must return the new combined value
+    /// </param>
     /// <param name="arguments">Arguments that will be passed to the event</param>
-    public: void Emit(TArguments... arguments) const {
-      std::size_t knownSubscriberCount = this->subscriberCount;
-
-      const DelegateType *subscribers;
-      std::size_t index = 0;
-
-      // Is the subscriber list currently on the stack?
-      if(knownSubscriberCount <= BuiltInSubscriberCount) {
-        ProcessStackSubscribers:
-        subscribers = reinterpret_cast<const DelegateType *>(this->stackMemory);
-        while(index < knownSubscriberCount) {
-          subscribers[index](std::forward<TArguments>(arguments)...);
-          if(this->subscriberCount == knownSubscriberCount) {
-            ++index; // Only increment if the current callback wasn't unsubscribed
-          } else if(this->subscriberCount > knownSubscriberCount) {
-            ++index;
-            if(knownSubscriberCount > BuiltInSubscriberCount) {
-              knownSubscriberCount = this->subscriberCount;
-              goto ProcessHeapSubscribers;
-            }
-            knownSubscriberCount = this->subscriberCount;
-          } else {
-            knownSubscriberCount = this->subscriberCount;
-          }
+    /// <returns>The combined value after all subscribers have been called</returns>
+    /// <remarks>
+    ///   Good for questions like "how many of you are busy?" or "does everyone agree?"
+    ///   that would otherwise collect all return values into a vector first.
+    /// </remarks>
+    public: template<typename TAccumulated, typename TReducer>
+    TAccumulated EmitAndReduce(
+      TAccumulated initial, TReducer &&reducer, TArguments&&... arguments
+    ) const {
+      visitSubscribers(
+        [&](const DelegateType &subscriber) {
+          initial = reducer(
+            std::move(initial), subscriber(std::forward<TArguments>(arguments)...)
+          );
+          return true;
         }
+      );
 
-        return;
-      }
+      return initial;
+    }
 
-      // The subscriber list is currently on the heap
-      {
-        ProcessHeapSubscribers:
-        subscribers = reinterpret_cast<const DelegateType *>(this->heapMemory.Buffer);
-        while(index < knownSubscriberCount) {
-          subscribers[index](std::forward<TArguments>(arguments)...);
-          if(this->subscriberCount == knownSubscriberCount) {
-            ++index; // Only increment if the current callback wasn't unsubscribed
-          } else if(this->subscriberCount < knownSubscriberCount) {
-            if(knownSubscriberCount <= BuiltInSubscriberCount) {
-              knownSubscriberCount = this->subscriberCount;
-              goto ProcessStackSubscribers;
-            }
-            knownSubscriberCount = this->subscriberCount;
-          } else {
-            ++index;
-            knownSubscriberCount = this->subscriberCount;
-            // In case more heap memory had to be allocated
-            subscribers = reinterpret_cast<const DelegateType *>(this->heapMemory.Buffer);
-          }
+    /// <summary>Calls subscribers of the event until one of them gives a certain answer</summary>
+    /// <typeparam name="TPredicate">Method that checks the subscribers' return values</typeparam>
+    /// <param name="predicate">
+    ///   Will be called with each subscriber's return value, stops the emission if
+    ///   it returns true
+    /// </param>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    /// <returns>True if the predicate stopped the emission, false otherwise</returns>
+    /// <remarks>
+    ///   Meant for vetoable events like "can the window close?": the first subscriber
+    ///   that objects ends the poll and the remaining subscribers aren't called at all.
+    /// </remarks>
+    public: template<typename TPredicate, typename T = TResult>
+    typename std::enable_if<
+      !std::is_void<T>::value, bool
+    >::type EmitUntil(TPredicate &&predicate, TArguments&&... arguments) const {
+      return !visitSubscribers(
+        [&](const DelegateType &subscriber) {
+          return !predicate(subscriber(std::forward<TArguments>(arguments)...));
         }
+      );
+    }
 
-        return;
-      }
+    /// <summary>Calls all subscribers of the event and discards their return values</summary>
+    /// <param name="arguments">Arguments that will be passed to the event</param>
+    public: void Emit(TArguments... arguments) const {
+      visitSubscribers(
+        [&](const DelegateType &subscriber) {
+          subscriber(std::forward<TArguments>(arguments)...);
+          return true;
+        }
+      );
     }
 
     /// <summary>Subscribes the specified free function to the event</summary>
@@ -305,6 +327,18 @@ namespace Nuclex { namespace Support { namespace Events {
       Subscribe(DelegateType::template Create<TClass, TMethod>(instance));
     }
 
+    /// <summary>Subscribes a lambda expression or functor to the event</summary>
+    /// <typeparam name="TCallable">Type of the lambda expression or functor</typeparam>
+    /// <param name="callable">Lambda expression or functor that will be subscribed</param>
+    /// <remarks>
+    ///   The callable is stored inside the delegate without allocating memory, see
+    ///   <see cref="Delegate" /> for the limits on what it can capture.
+    /// </remarks>
+    public: template<typename TCallable>
+    void Subscribe(const TCallable &callable) {
+      Subscribe(DelegateType::Create(callable));
+    }
+
     /// <summary>Subscribes the specified delegate to the event</summary>
     /// <param name="delegate">Delegate that will be subscribed</param>
     public: void Subscribe(const DelegateType &delegate) {
@@ -361,16 +395,27 @@ namespace Nuclex { namespace Support { namespace Events {
       return Unsubscribe(DelegateType::template Create<TClass, TMethod>(instance));
     }
 
+    /// <summary>Unsubscribes a lambda expression or functor from the event</summary>
+    /// <typeparam name="TCallable">Type of the lambda expression or functor</typeparam>
+    /// <param name="callable">Lambda expression or functor that was subscribed</param>
+    /// <returns>True if the callable was subscribed and has been unsubscribed</returns>
+    public: template<typename TCallable>
+    bool Unsubscribe(const TCallable &callable) {
+      return Unsubscribe(DelegateType::Create(callable));
+    }
+
     /// <summary>Unsubscribes the specified delegate from the event</summary>
     /// <param name="delegate">Delegate that will be unsubscribed</param>
     /// <returns>True if the callback was found and unsubscribed, false otherwise</returns>
     public: bool Unsubscribe(const DelegateType &delegate) {
       if(this->subscriberCount <= BuiltInSubscriberCount) {
         DelegateType *subscribers = reinterpret_cast<DelegateType *>(this->stackMemory);
-        for(std::size_t index = 0; index < this->subscriberCount; ++index) {
-          if(subscribers[index] == delegate) {
+
+        // Search from the back, often the removed event is the last one registered
+        for(std::size_t index = this->subscriberCount; index > 0; --index) {
+          if(subscribers[index - 1] == delegate) {
             std::size_t lastSubscriberIndex = this->subscriberCount - 1;
-            subscribers[index] = subscribers[lastSubscriberIndex];
+            subscribers[index - 1] = subscribers[lastSubscriberIndex];
             --this->subscriberCount;
             return true;
           }
@@ -405,6 +450,78 @@ namespace Nuclex { namespace Support { namespace Events {
       return false;
     }
 
+    /// <summary>Hands each subscriber to a visitor, tolerating changes made meanwhile</summary>
+    /// <typeparam name="TVisitor">Type of the visitor the subscribers are handed to</typeparam>
+    /// <param name="visitor">
+    ///   Visitor that will be invoked on each subscriber, can return false to stop
+    /// </param>
+    /// <returns>True if all subscribers were visited, false if the visitor stopped</returns>
+    /// <remarks>
+    ///   Subscribers called by the visitor are allowed to unsubscribe themselves and
+    ///   to subscribe others, so after each visit the subscriber count is checked and
+    ///   the walk continues from the right place, switching between stack and heap
+    ///   storage if the subscription changes moved the list.
+    /// </remarks>
+    private: template<typename TVisitor>
+    bool visitSubscribers(TVisitor &&visitor) const {
+      std::size_t knownSubscriberCount = this->subscriberCount;
+
+      const DelegateType *subscribers;
+      std::size_t index = 0;
+
+      // Is the subscriber list currently on the stack?
+      if(knownSubscriberCount <= BuiltInSubscriberCount) {
+        ProcessStackSubscribers:
+        subscribers = reinterpret_cast<const DelegateType *>(this->stackMemory);
+        while(index < knownSubscriberCount) {
+          if(!visitor(subscribers[index])) {
+            return false;
+          }
+          if(this->subscriberCount == knownSubscriberCount) {
+            ++index; // Only increment if the current callback wasn't unsubscribed
+          } else if(this->subscriberCount > knownSubscriberCount) {
+            ++index;
+            if(knownSubscriberCount > BuiltInSubscriberCount) {
+              knownSubscriberCount = this->subscriberCount;
+              goto ProcessHeapSubscribers;
+            }
+            knownSubscriberCount = this->subscriberCount;
+          } else {
+            knownSubscriberCount = this->subscriberCount;
+          }
+        }
+
+        return true;
+      }
+
+      // The subscriber list is currently on the heap
+      {
+        ProcessHeapSubscribers:
+        subscribers = reinterpret_cast<const DelegateType *>(this->heapMemory.Buffer);
+        while(index < knownSubscriberCount) {
+          if(!visitor(subscribers[index])) {
+            return false;
+          }
+          if(this->subscriberCount == knownSubscriberCount) {
+            ++index; // Only increment if the current callback wasn't unsubscribed
+          } else if(this->subscriberCount < knownSubscriberCount) {
+            if(knownSubscriberCount <= BuiltInSubscriberCount) {
+              knownSubscriberCount = this->subscriberCount;
+              goto ProcessStackSubscribers;
+            }
+            knownSubscriberCount = this->subscriberCount;
+          } else {
+            ++index;
+            knownSubscriberCount = this->subscriberCount;
+            // In case more heap memory had to be allocated
+            subscribers = reinterpret_cast<const DelegateType *>(this->heapMemory.Buffer);
+          }
+        }
+
+        return true;
+      }
+    }
+
     /// <summary>Switches the event from stack-stored subscribers to heap-stored</summary>
     /// <remarks>
     ///   For internal use only; this must only be called when the subscriber count is
@@ -414,9 +531,11 @@ namespace Nuclex { namespace Support { namespace Events {
     /// </remarks>
     private: void convertFromStackToHeapAllocation() {
       const static std::size_t initialCapacity = BuiltInSubscriberCount * 8;
-      std::uint8_t *initialBuffer = new std::uint8_t[
-        sizeof(DelegateType[2]) * initialCapacity / 2
-      ];
+      std::uint8_t *initialBuffer = static_cast<std::uint8_t *>(
+        AllocationTracker::Allocate(
+          AllocationSubsystem::Events, sizeof(DelegateType[2]) * initialCapacity / 2
+        )
+      );
 
       std::copy_n(
         this->stackMemory,
@@ -430,10 +549,13 @@ namespace Nuclex { namespace Support { namespace Events {
 
     /// <summary>Increases the size of the heap-allocated list of event subscribers</summary>
     private: void growHeapAllocatedList() {
-      std::size_t newCapacity = this->heapMemory.ReservedSubscriberCount * 2;
-      std::uint8_t *newBuffer = new std::uint8_t[
-        sizeof(DelegateType[2]) * newCapacity / 2
-      ];
+      std::size_t oldCapacity = this->heapMemory.ReservedSubscriberCount;
+      std::size_t newCapacity = oldCapacity * 2;
+      std::uint8_t *newBuffer = static_cast<std::uint8_t *>(
+        AllocationTracker::Allocate(
+          AllocationSubsystem::Events, sizeof(DelegateType[2]) * newCapacity / 2
+        )
+      );
 
       std::copy_n(
         this->heapMemory.Buffer,
@@ -443,7 +565,9 @@ namespace Nuclex { namespace Support { namespace Events {
 
       std::swap(this->heapMemory.Buffer, newBuffer);
       this->heapMemory.ReservedSubscriberCount = newCapacity;
-      delete []newBuffer;
+      AllocationTracker::Deallocate(
+        AllocationSubsystem::Events, newBuffer, sizeof(DelegateType[2]) * oldCapacity / 2
+      );
     }
 
     /// <summary>Moves the event's subscriber list back into its own stack storage</summary>
@@ -455,6 +579,7 @@ namespace Nuclex { namespace Support { namespace Events {
     /// </remarks>
     private: void convertFromHeapToStackAllocated() {
       std::uint8_t *oldBuffer = this->heapMemory.Buffer;
+      std::size_t oldCapacity = this->heapMemory.ReservedSubscriberCount;
 
       std::copy_n(
         oldBuffer,
@@ -462,7 +587,9 @@ namespace Nuclex { namespace Support { namespace Events {
         this->stackMemory
       );
 
-      delete []oldBuffer;
+      AllocationTracker::Deallocate(
+        AllocationSubsystem::Events, oldBuffer, sizeof(DelegateType[2]) * oldCapacity / 2
+      );
     }
 
     /// <summary>Information about subscribers if the list is moved to the heap</summary>
@@ -0,0 +1,218 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_EVENTS_EVENTQUEUE_H
+#define NUCLEX_SUPPORT_EVENTS_EVENTQUEUE_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Events/Delegate.h"
+#include "Nuclex/Support/AllocationTracker.h"
+
+#include <cstddef> // for std::size_t
+#include <mutex> // for std::mutex
+#include <tuple> // for std::tuple
+#include <type_traits> // for std::decay<>
+#include <utility> // for std::index_sequence
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Events {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  // Prototype, required for variable argument template
+  template<typename> class EventQueue;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records delegate calls from any thread and executes them in one batch</summary>
+  /// <typeparam name="TResult">Type that will be returned from the method</typeparam>
+  /// <typeparam name="TArguments">Types of the arguments accepted by the callback</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Lets worker threads fire notifications that are meant to be handled on another
+  ///     thread, typically the main thread, which calls <see cref="Drain" /> once per frame
+  ///     to execute everything that has been posted since.
+  ///   </para>
+  ///   <para>
+  ///     Each posted call is stored as the delegate plus a copy of its arguments (reference
+  ///     arguments are copied as well, so the caller doesn't have to keep them alive).
+  ///     The calls are kept in two vectors that trade places when the queue is drained,
+  ///     so all calls of a batch sit in contiguous memory and, once the vectors have grown
+  ///     to the typical batch size, posting no longer allocates. Return values of
+  ///     the delegates are discarded.
+  ///   </para>
+  ///   <para>
+  ///     Posting is thread safe. Draining must only happen on one thread at a time, but
+  ///     the delegates called while draining may post again, those calls are executed by
+  ///     the next <see cref="Drain" />.
+  ///   </para>
+  /// </remarks>
+  template<typename TResult, typename... TArguments>
+  class EventQueue<TResult(TArguments...)> {
+
+    /// <summary>Type of delegate used to call the event's subscribers</summary>
+    public: typedef Delegate<TResult(TArguments...)> DelegateType;
+
+    /// <summary>Initializes a new event queue</summary>
+    /// <param name="capacity">Number of calls to reserve space for up front</param>
+    public: EventQueue(std::size_t capacity = 64) {
+      this->pendingCalls.reserve(capacity);
+      this->executingCalls.reserve(capacity);
+    }
+
+    /// <summary>Counts the number of calls waiting to be executed</summary>
+    /// <returns>The number of calls that will be executed by the next drain</returns>
+    public: std::size_t Count() const {
+      std::lock_guard<std::mutex> pendingCallsScope(this->pendingCallsMutex);
+      return this->pendingCalls.size();
+    }
+
+    /// <summary>Records a call that will be executed when the queue is drained</summary>
+    /// <param name="delegate">Delegate that will be called</param>
+    /// <param name="arguments">Arguments that will be passed to the delegate</param>
+    public: void Post(const DelegateType &delegate, TArguments... arguments) {
+      std::lock_guard<std::mutex> pendingCallsScope(this->pendingCallsMutex);
+      this->pendingCalls.emplace_back(delegate, std::forward<TArguments>(arguments)...);
+    }
+
+    /// <summary>Records a call, replacing a call to the same delegate if one is queued</summary>
+    /// <param name="delegate">Delegate that will be called</param>
+    /// <param name="arguments">Arguments that will be passed to the delegate</param>
+    /// <returns>True if a queued call was replaced, false if the call was appended</returns>
+    /// <remarks>
+    ///   Meant for notifications where only the latest state matters (for example
+    ///   "value changed"), so a flood of them fires the delegate just once per drain.
+    ///   The replaced call keeps its position in the queue but takes on the new arguments.
+    ///   Finding the queued call is a linear search, like unsubscribing from an event.
+    /// </remarks>
+    public: bool PostCoalesced(const DelegateType &delegate, TArguments... arguments) {
+      std::lock_guard<std::mutex> pendingCallsScope(this->pendingCallsMutex);
+
+      // Search from the back, repeated notifications tend to cluster at the end
+      for(std::size_t index = this->pendingCalls.size(); index > 0; --index) {
+        QueuedCall &queuedCall = this->pendingCalls[index - 1];
+        if(queuedCall.Delegate == delegate) {
+          queuedCall.Arguments = ArgumentTuple(std::forward<TArguments>(arguments)...);
+          return true;
+        }
+      }
+
+      this->pendingCalls.emplace_back(delegate, std::forward<TArguments>(arguments)...);
+      return false;
+    }
+
+    /// <summary>Executes all calls that have been posted so far</summary>
+    /// <returns>The number of calls that have been executed</returns>
+    /// <remarks>
+    ///   Calls are executed in the order they were posted. If a delegate throws,
+    ///   the exception is passed on to the caller and the calls that didn't get to run
+    ///   stay queued in front of any newer ones, to be executed by the next drain.
+    /// </remarks>
+    public: std::size_t Drain() {
+      {
+        std::lock_guard<std::mutex> pendingCallsScope(this->pendingCallsMutex);
+        this->pendingCalls.swap(this->executingCalls);
+      }
+
+      std::size_t callCount = this->executingCalls.size();
+      std::size_t index = 0;
+      try {
+        while(index < callCount) {
+          QueuedCall &queuedCall = this->executingCalls[index];
+          ++index;
+          invoke(queuedCall, std::index_sequence_for<TArguments...>());
+        }
+      }
+      catch(...) {
+        requeueRemainingCalls(index);
+        throw;
+      }
+
+      this->executingCalls.clear();
+      return callCount;
+    }
+
+    /// <summary>Arguments of a call, copied so they can be stored</summary>
+    private: typedef std::tuple<typename std::decay<TArguments>::type...> ArgumentTuple;
+
+    /// <summary>Call that has been posted to the queue</summary>
+    private: struct QueuedCall {
+
+      /// <summary>Initializes a new queued call</summary>
+      /// <param name="delegate">Delegate that will be called</param>
+      /// <param name="arguments">Arguments that will be passed to the delegate</param>
+      public: template<typename... TPassedArguments>
+      QueuedCall(const DelegateType &delegate, TPassedArguments &&... arguments) :
+        Delegate(delegate),
+        Arguments(std::forward<TPassedArguments>(arguments)...) {}
+
+      /// <summary>Delegate that will be called</summary>
+      public: DelegateType Delegate;
+      /// <summary>Copies of the arguments that will be passed to the delegate</summary>
+      public: ArgumentTuple Arguments;
+
+    };
+
+    /// <summary>Calls the delegate of a queued call with its stored arguments</summary>
+    /// <typeparam name="TIndices">Indices of the arguments in the tuple</typeparam>
+    /// <param name="queuedCall">Queued call that will be executed</param>
+    /// <remarks>
+    ///   Each queued call is executed only once, so arguments passed by value are
+    ///   moved out of the tuple rather than copied again.
+    /// </remarks>
+    private: template<std::size_t... TIndices>
+    static void invoke(QueuedCall &queuedCall, std::index_sequence<TIndices...>) {
+      queuedCall.Delegate(std::forward<TArguments>(std::get<TIndices>(queuedCall.Arguments))...);
+    }
+
+    /// <summary>Puts calls that were not executed back in front of the pending calls</summary>
+    /// <param name="executedCallCount">Number of calls that have been executed</param>
+    private: void requeueRemainingCalls(std::size_t executedCallCount) {
+      this->executingCalls.erase(
+        this->executingCalls.begin(), this->executingCalls.begin() + executedCallCount
+      );
+
+      std::lock_guard<std::mutex> pendingCallsScope(this->pendingCallsMutex);
+      this->executingCalls.insert(
+        this->executingCalls.end(), this->pendingCalls.begin(), this->pendingCalls.end()
+      );
+      this->pendingCalls.swap(this->executingCalls);
+      this->executingCalls.clear();
+    }
+
+    /// <summary>List of calls whose memory is counted for the events subsystem</summary>
+    private: typedef std::vector<
+      QueuedCall, TrackingAllocator<QueuedCall, AllocationSubsystem::Events>
+    > QueuedCallList;
+
+    /// <summary>Protects the pending calls against concurrent access</summary>
+    private: mutable std::mutex pendingCallsMutex;
+    /// <summary>Calls that have been posted and are waiting for the next drain</summary>
+    private: QueuedCallList pendingCalls;
+    /// <summary>Calls being executed by the current drain</summary>
+    private: QueuedCallList executingCalls;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Events
+
+#endif // NUCLEX_SUPPORT_EVENTS_EVENTQUEUE_H
@@ -0,0 +1,371 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_INSTRUMENTATION_H
+#define NUCLEX_SUPPORT_INSTRUMENTATION_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+#if defined(_MSC_VER)
+  #include <intrin.h> // for _BitScanReverse64()
+#endif
+
+// The instrumentation macros only do something in translation units compiled with
+// NUCLEX_SUPPORT_INSTRUMENTATION defined. Otherwise they expand to nothing and their
+// arguments are not evaluated, so instrumented code costs nothing in normal builds.
+#if defined(NUCLEX_SUPPORT_INSTRUMENTATION)
+
+  /// <summary>Glues two tokens together after expanding them</summary>
+  #define NUCLEX_SUPPORT_INSTRUMENTATION_CONCAT(left, right) \
+    NUCLEX_SUPPORT_INSTRUMENTATION_CONCAT_EXPANDED(left, right)
+  #define NUCLEX_SUPPORT_INSTRUMENTATION_CONCAT_EXPANDED(left, right) left##right
+
+  /// <summary>Measures the time until the end of the enclosing scope</summary>
+  /// <param name="name">String literal naming the zone</param>
+  #define NUCLEX_SUPPORT_INSTRUMENT_ZONE(name) \
+    static const ::Nuclex::Support::InstrumentationSite \
+      NUCLEX_SUPPORT_INSTRUMENTATION_CONCAT(nuclexInstrumentationSite, __LINE__) = { \
+        name, __FILE__, __LINE__ \
+      }; \
+    ::Nuclex::Support::ScopedZone \
+      NUCLEX_SUPPORT_INSTRUMENTATION_CONCAT(nuclexInstrumentationZone, __LINE__)( \
+        NUCLEX_SUPPORT_INSTRUMENTATION_CONCAT(nuclexInstrumentationSite, __LINE__) \
+      )
+
+  /// <summary>Adds an amount to a counter that is created on first use</summary>
+  /// <param name="name">String literal naming the counter</param>
+  /// <param name="amount">Amount that will be added to the counter</param>
+  #define NUCLEX_SUPPORT_INSTRUMENT_COUNT(name, amount) \
+    do { \
+      static ::Nuclex::Support::Counter nuclexInstrumentationCounter(name); \
+      nuclexInstrumentationCounter.Add(static_cast<std::uint64_t>(amount)); \
+    } while(false)
+
+  /// <summary>Records a value in a histogram that is created on first use</summary>
+  /// <param name="name">String literal naming the histogram</param>
+  /// <param name="value">Value that will be recorded</param>
+  #define NUCLEX_SUPPORT_INSTRUMENT_SAMPLE(name, value) \
+    do { \
+      static ::Nuclex::Support::Histogram nuclexInstrumentationHistogram(name); \
+      nuclexInstrumentationHistogram.Record(static_cast<std::uint64_t>(value)); \
+    } while(false)
+
+#else
+
+  #define NUCLEX_SUPPORT_INSTRUMENT_ZONE(name) static_cast<void>(0)
+  #define NUCLEX_SUPPORT_INSTRUMENT_COUNT(name, amount) static_cast<void>(0)
+  #define NUCLEX_SUPPORT_INSTRUMENT_SAMPLE(name, value) static_cast<void>(0)
+
+#endif
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class Counter;
+  class Histogram;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Location in the code that has been instrumented</summary>
+  struct InstrumentationSite {
+
+    /// <summary>Name under which the zone will show up</summary>
+    public: const char *Name;
+    /// <summary>Source file containing the instrumented code</summary>
+    public: const char *File;
+    /// <summary>Line in the source file the zone begins in</summary>
+    public: int Line;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Receives measurements from instrumented code</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Zones are delivered as they end, from whichever thread ran them, so sinks need
+  ///     to be thread-safe. A sink forwarding to a live profiler such as Tracy would
+  ///     begin a zone in <see cref="ZoneEntered" /> and end it in <see cref="ZoneLeft" />,
+  ///     a sink writing a trace file only needs the latter.
+  ///   </para>
+  ///   <para>
+  ///     Counters and histograms are only accumulated in memory. Their current values
+  ///     are delivered when <see cref="Instrumentation.Report" /> is called.
+  ///   </para>
+  /// </remarks>
+  class InstrumentationSink {
+
+    /// <summary>Frees all resources owned by the sink</summary>
+    public: NUCLEX_SUPPORT_API virtual ~InstrumentationSink() = default;
+
+    /// <summary>Called when the calling thread enters an instrumented zone</summary>
+    /// <param name="site">Instrumented location that was entered</param>
+    public: NUCLEX_SUPPORT_API virtual void ZoneEntered(const InstrumentationSite &site);
+
+    /// <summary>Called when the calling thread leaves an instrumented zone</summary>
+    /// <param name="site">Instrumented location that was left</param>
+    /// <param name="startNanoseconds">
+    ///   Time at which the zone was entered as returned by
+    ///   <see cref="Instrumentation.GetTimestamp" />
+    /// </param>
+    /// <param name="elapsedNanoseconds">Time the calling thread spent in the zone</param>
+    public: virtual void ZoneLeft(
+      const InstrumentationSite &site,
+      std::uint64_t startNanoseconds, std::uint64_t elapsedNanoseconds
+    ) = 0;
+
+    /// <summary>Delivers the current value of a counter</summary>
+    /// <param name="counter">Counter whose value is being reported</param>
+    /// <param name="value">Value of the counter</param>
+    public: NUCLEX_SUPPORT_API virtual void CounterReported(
+      const Counter &counter, std::uint64_t value
+    );
+
+    /// <summary>Delivers the current contents of a histogram</summary>
+    /// <param name="histogram">Histogram whose contents are being reported</param>
+    /// <param name="bucketCounts">
+    ///   Number of values recorded in each of the histogram's buckets
+    /// </param>
+    public: NUCLEX_SUPPORT_API virtual void HistogramReported(
+      const Histogram &histogram, const std::uint64_t *bucketCounts
+    );
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Routes measurements from instrumented code to a sink</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Instrumented code uses the NUCLEX_SUPPORT_INSTRUMENT_ZONE(),
+  ///     NUCLEX_SUPPORT_INSTRUMENT_COUNT() and NUCLEX_SUPPORT_INSTRUMENT_SAMPLE() macros,
+  ///     which are compiled out unless NUCLEX_SUPPORT_INSTRUMENTATION is defined:
+  ///   </para>
+  ///   <example>
+  ///     <code>
+  ///       void decode(const std::uint8_t *data, std::size_t byteCount) {
+  ///         NUCLEX_SUPPORT_INSTRUMENT_ZONE("MyLibrary.Decode");
+  ///         NUCLEX_SUPPORT_INSTRUMENT_SAMPLE("MyLibrary.DecodedBytes", byteCount);
+  ///         // ...
+  ///       }
+  ///     </code>
+  ///   </example>
+  ///   <para>
+  ///     While no sink is installed, a zone costs one atomic load, a counter one
+  ///     relaxed atomic addition and a histogram sample two. The sink must stay alive
+  ///     until all zones that were entered while it was installed have ended.
+  ///   </para>
+  /// </remarks>
+  class Instrumentation {
+
+    /// <summary>Installs the sink that will receive measurements</summary>
+    /// <param name="sink">Sink that will receive measurements, can be null</param>
+    public: NUCLEX_SUPPORT_API static void SetSink(InstrumentationSink *sink);
+
+    /// <summary>Retrieves the sink currently receiving measurements</summary>
+    /// <returns>The current sink or a null pointer if none is installed</returns>
+    public: static InstrumentationSink *GetSink() {
+      return currentSink.load(std::memory_order_acquire);
+    }
+
+    /// <summary>Reports the values of all counters and histograms to a sink</summary>
+    /// <param name="sink">Sink the values will be reported to</param>
+    public: NUCLEX_SUPPORT_API static void Report(InstrumentationSink &sink);
+
+    /// <summary>Reads the clock used to time zones</summary>
+    /// <returns>Nanoseconds since an arbitrary point in time, never decreasing</returns>
+    public: NUCLEX_SUPPORT_API static std::uint64_t GetTimestamp();
+
+    /// <summary>Sink that currently receives measurements</summary>
+    private: NUCLEX_SUPPORT_API static std::atomic<InstrumentationSink *> currentSink;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Measures the time a thread spends in a scope</summary>
+  class ScopedZone {
+
+    /// <summary>Enters the zone</summary>
+    /// <param name="site">Instrumented location the zone belongs to</param>
+    public: explicit ScopedZone(const InstrumentationSite &site) :
+      site(site),
+      sink(Instrumentation::GetSink()),
+      startNanoseconds(0) {
+      if(this->sink != nullptr) {
+        this->sink->ZoneEntered(site);
+        this->startNanoseconds = Instrumentation::GetTimestamp();
+      }
+    }
+
+    /// <summary>Leaves the zone and reports the time spent in it</summary>
+    public: ~ScopedZone() {
+      if(this->sink != nullptr) {
+        std::uint64_t endNanoseconds = Instrumentation::GetTimestamp();
+        this->sink->ZoneLeft(
+          this->site, this->startNanoseconds, endNanoseconds - this->startNanoseconds
+        );
+      }
+    }
+
+    private: ScopedZone(const ScopedZone &) = delete;
+    private: ScopedZone &operator =(const ScopedZone &) = delete;
+
+    /// <summary>Instrumented location the zone belongs to</summary>
+    private: const InstrumentationSite &site;
+    /// <summary>Sink that was installed when the zone was entered</summary>
+    private: InstrumentationSink *sink;
+    /// <summary>Time at which the zone was entered</summary>
+    private: std::uint64_t startNanoseconds;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Monotonic counter that can be reported to an instrumentation sink</summary>
+  /// <remarks>
+  ///   Counters register themselves when they are constructed and unregister when they
+  ///   are destroyed. Incrementing a counter is a relaxed atomic addition.
+  /// </remarks>
+  class Counter {
+
+    /// <summary>Initializes and registers a new counter</summary>
+    /// <param name="name">Name of the counter, must stay valid for its lifetime</param>
+    public: NUCLEX_SUPPORT_API explicit Counter(const char *name);
+
+    /// <summary>Unregisters the counter</summary>
+    public: NUCLEX_SUPPORT_API ~Counter();
+
+    /// <summary>Retrieves the name of the counter</summary>
+    /// <returns>The counter's name</returns>
+    public: const char *GetName() const { return this->name; }
+
+    /// <summary>Adds an amount to the counter</summary>
+    /// <param name="amount">Amount that will be added</param>
+    public: void Add(std::uint64_t amount = 1) {
+      this->value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /// <summary>Retrieves the current value of the counter</summary>
+    /// <returns>The sum of all amounts added to the counter</returns>
+    public: std::uint64_t GetValue() const {
+      return this->value.load(std::memory_order_relaxed);
+    }
+
+    private: Counter(const Counter &) = delete;
+    private: Counter &operator =(const Counter &) = delete;
+
+    /// <summary>Name of the counter</summary>
+    private: const char *name;
+    /// <summary>Sum of all amounts added to the counter</summary>
+    private: std::atomic<std::uint64_t> value;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Distribution of values that can be reported to an instrumentation sink</summary>
+  /// <remarks>
+  ///   Values are sorted into buckets by their number of significant bits, so bucket 0
+  ///   counts zeros, bucket 1 counts ones, bucket 2 counts 2 and 3, bucket 3 counts 4 to 7
+  ///   and so on. Recording a value is a relaxed atomic increment plus a relaxed atomic
+  ///   addition to the sum of all values.
+  /// </remarks>
+  class Histogram {
+
+    /// <summary>Number of buckets a histogram sorts values into</summary>
+    public: static const std::size_t BucketCount = 65;
+
+    /// <summary>Initializes and registers a new histogram</summary>
+    /// <param name="name">Name of the histogram, must stay valid for its lifetime</param>
+    public: NUCLEX_SUPPORT_API explicit Histogram(const char *name);
+
+    /// <summary>Unregisters the histogram</summary>
+    public: NUCLEX_SUPPORT_API ~Histogram();
+
+    /// <summary>Retrieves the name of the histogram</summary>
+    /// <returns>The histogram's name</returns>
+    public: const char *GetName() const { return this->name; }
+
+    /// <summary>Records a value in the histogram</summary>
+    /// <param name="value">Value that will be recorded</param>
+    public: void Record(std::uint64_t value) {
+      this->buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+      this->sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /// <summary>Retrieves the number of values recorded in a bucket</summary>
+    /// <param name="bucketIndex">Index of the bucket whose count will be returned</param>
+    /// <returns>The number of values that fell into the bucket</returns>
+    public: std::uint64_t GetBucketCount(std::size_t bucketIndex) const {
+      return this->buckets[bucketIndex].load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Retrieves the sum of all values recorded in the histogram</summary>
+    /// <returns>The sum of all recorded values</returns>
+    public: std::uint64_t GetSum() const {
+      return this->sum.load(std::memory_order_relaxed);
+    }
+
+    /// <summary>Determines the bucket a value will be sorted into</summary>
+    /// <param name="value">Value whose bucket will be determined</param>
+    /// <returns>The index of the bucket counting the value</returns>
+    public: static std::size_t GetBucketIndex(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+      return (value == 0) ? 0 : (64 - static_cast<std::size_t>(__builtin_clzll(value)));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+      unsigned long highestBitIndex;
+      if(_BitScanReverse64(&highestBitIndex, value) == 0) {
+        return 0;
+      } else {
+        return static_cast<std::size_t>(highestBitIndex) + 1;
+      }
+#else
+      std::size_t bitCount = 0;
+      while(value != 0) {
+        value >>= 1;
+        ++bitCount;
+      }
+      return bitCount;
+#endif
+    }
+
+    private: Histogram(const Histogram &) = delete;
+    private: Histogram &operator =(const Histogram &) = delete;
+
+    /// <summary>Name of the histogram</summary>
+    private: const char *name;
+    /// <summary>Number of values that fell into each bucket</summary>
+    private: std::atomic<std::uint64_t> buckets[BucketCount];
+    /// <summary>Sum of all recorded values</summary>
+    private: std::atomic<std::uint64_t> sum;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
+
+#endif // NUCLEX_SUPPORT_INSTRUMENTATION_H
@@ -0,0 +1,233 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_MONOTONICARENA_H
+#define NUCLEX_SUPPORT_MONOTONICARENA_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t, std::max_align_t
+#include <cstdint> // for std::uint8_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hands out memory from large blocks and frees it all at once</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Allocating from the arena only advances a pointer, individual allocations are
+  ///     never freed. Instead, the whole arena is reset (or rewound to an earlier marker)
+  ///     when the work that needed the memory is done. The blocks stay allocated, so
+  ///     an arena that is reused for the same kind of work stops allocating memory from
+  ///     the heap after the first run.
+  ///   </para>
+  ///   <para>
+  ///     The arena does not run destructors. It is meant for buffers and other objects
+  ///     that are trivially destructible or are destroyed by their owners before
+  ///     the arena is reset, such as containers using an <see cref="ArenaAllocator" />.
+  ///     It is not thread safe.
+  ///   </para>
+  /// </remarks>
+  class MonotonicArena {
+
+    #pragma region struct Marker
+
+    /// <summary>Position in the arena that it can later be rewound to</summary>
+    public: struct Marker {
+
+      /// <summary>Index of the block allocations were being taken from</summary>
+      public: std::size_t BlockIndex;
+      /// <summary>Number of bytes already used in that block</summary>
+      public: std::size_t UsedByteCount;
+
+    };
+
+    #pragma endregion // struct Marker
+
+    /// <summary>Initializes a new monotonic arena</summary>
+    /// <param name="initialBlockByteCount">
+    ///   Size of the first block of memory the arena will allocate. Later blocks grow
+    ///   in size so the number of blocks stays small.
+    /// </param>
+    /// <remarks>No memory is allocated until the first allocation is requested</remarks>
+    public: NUCLEX_SUPPORT_API MonotonicArena(std::size_t initialBlockByteCount = 4096);
+
+    /// <summary>Frees all memory blocks owned by the arena</summary>
+    public: NUCLEX_SUPPORT_API ~MonotonicArena();
+
+    /// <summary>Allocates memory from the arena</summary>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <param name="alignment">Alignment of the memory, must be a power of two</param>
+    /// <returns>The allocated memory, which is valid until the arena is reset</returns>
+    public: NUCLEX_SUPPORT_API void *Allocate(
+      std::size_t byteCount, std::size_t alignment = alignof(std::max_align_t)
+    );
+
+    /// <summary>Allocates uninitialized memory for an array of items</summary>
+    /// <typeparam name="TItem">Type of items the memory will be allocated for</typeparam>
+    /// <param name="itemCount">Number of items the memory should have space for</param>
+    /// <returns>The allocated memory, which is valid until the arena is reset</returns>
+    public: template<typename TItem>
+    TItem *AllocateArray(std::size_t itemCount) {
+      return static_cast<TItem *>(Allocate(sizeof(TItem) * itemCount, alignof(TItem)));
+    }
+
+    /// <summary>Returns a marker for the current fill level of the arena</summary>
+    /// <returns>A marker the arena can be rewound to</returns>
+    public: Marker GetMarker() const {
+      Marker marker;
+      marker.BlockIndex = this->currentBlockIndex;
+      marker.UsedByteCount = this->usedByteCount;
+      return marker;
+    }
+
+    /// <summary>Discards all allocations made after the marker was taken</summary>
+    /// <param name="marker">Marker that was returned by <see cref="GetMarker" /></param>
+    /// <remarks>
+    ///   Markers have to be rewound to in the reverse order they were taken in,
+    ///   rewinding to a marker invalidates all markers taken after it.
+    /// </remarks>
+    public: void Rewind(const Marker &marker) {
+      this->currentBlockIndex = marker.BlockIndex;
+      this->usedByteCount = marker.UsedByteCount;
+    }
+
+    /// <summary>Discards all allocations, keeping the memory blocks for reuse</summary>
+    public: void Reset() {
+      this->currentBlockIndex = 0;
+      this->usedByteCount = 0;
+    }
+
+    /// <summary>Counts the number of bytes the arena has allocated from the heap</summary>
+    /// <returns>The combined size of all memory blocks owned by the arena</returns>
+    public: NUCLEX_SUPPORT_API std::size_t GetReservedByteCount() const;
+
+    private: MonotonicArena(const MonotonicArena &) = delete;
+    private: MonotonicArena &operator =(const MonotonicArena &) = delete;
+
+    #pragma region struct Block
+
+    /// <summary>Memory block from which allocations are taken</summary>
+    private: struct Block {
+
+      /// <summary>Memory allocated for the block</summary>
+      public: std::uint8_t *Memory;
+      /// <summary>Size of the block in bytes</summary>
+      public: std::size_t ByteCount;
+
+    };
+
+    #pragma endregion // struct Block
+
+    /// <summary>Moves to a block that has room for the specified allocation</summary>
+    /// <param name="byteCount">Number of bytes that need to fit into the block</param>
+    /// <param name="alignment">Alignment required for the allocation</param>
+    private: void advanceBlock(std::size_t byteCount, std::size_t alignment);
+
+    /// <summary>Memory blocks owned by the arena</summary>
+    private: std::vector<Block> blocks;
+    /// <summary>Size of the first memory block the arena will allocate</summary>
+    private: std::size_t initialBlockByteCount;
+    /// <summary>Index of the block from which allocations are taken</summary>
+    private: std::size_t currentBlockIndex;
+    /// <summary>Number of bytes already taken from the current block</summary>
+    private: std::size_t usedByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Standard library allocator that takes its memory from a monotonic arena</summary>
+  /// <typeparam name="TValue">Type of values the allocator hands out memory for</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Lets standard containers live in an arena: memory given back to the allocator
+  ///     is not reused until the arena is reset. Containers that grow repeatedly waste
+  ///     their old buffers, so reserving the required capacity up front is advisable.
+  ///   </para>
+  ///   <para>
+  ///     The container must be destroyed before the arena is reset or rewound.
+  ///   </para>
+  /// </remarks>
+  template<typename TValue>
+  class ArenaAllocator {
+
+    /// <summary>Type of values the allocator hands out memory for</summary>
+    public: typedef TValue value_type;
+
+    /// <summary>Initializes a new allocator taking memory from the specified arena</summary>
+    /// <param name="arena">Arena from which memory will be taken</param>
+    public: ArenaAllocator(MonotonicArena &arena) : arena(&arena) {}
+
+    /// <summary>Initializes an allocator sharing the arena of another allocator</summary>
+    /// <param name="other">Allocator whose arena will be used</param>
+    public: template<typename TOtherValue>
+    ArenaAllocator(const ArenaAllocator<TOtherValue> &other) : arena(other.GetArena()) {}
+
+    /// <summary>Allocates memory for the specified number of values</summary>
+    /// <param name="count">Number of values to allocate memory for</param>
+    /// <returns>The allocated memory</returns>
+    public: TValue *allocate(std::size_t count) {
+      return this->arena->template AllocateArray<TValue>(count);
+    }
+
+    /// <summary>Gives back memory that was allocated earlier</summary>
+    /// <param name="values">Memory that is given back</param>
+    /// <param name="count">Number of values that memory was allocated for</param>
+    /// <remarks>
+    ///   Does nothing, the memory is reclaimed when the arena is reset
+    /// </remarks>
+    public: void deallocate(TValue *values, std::size_t count) {
+      (void)values;
+      (void)count;
+    }
+
+    /// <summary>Retrieves the arena the allocator takes its memory from</summary>
+    /// <returns>The arena providing the allocator's memory</returns>
+    public: MonotonicArena *GetArena() const { return this->arena; }
+
+    /// <summary>Checks whether two allocators use the same arena</summary>
+    /// <param name="other">Other allocator that will be compared</param>
+    /// <returns>True if both allocators can free each other's memory</returns>
+    public: template<typename TOtherValue>
+    bool operator ==(const ArenaAllocator<TOtherValue> &other) const {
+      return (this->arena == other.GetArena());
+    }
+
+    /// <summary>Checks whether two allocators use different arenas</summary>
+    /// <param name="other">Other allocator that will be compared</param>
+    /// <returns>True if the allocators can not free each other's memory</returns>
+    public: template<typename TOtherValue>
+    bool operator !=(const ArenaAllocator<TOtherValue> &other) const {
+      return (this->arena != other.GetArena());
+    }
+
+    /// <summary>Arena from which memory is taken</summary>
+    private: MonotonicArena *arena;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
+
+#endif // NUCLEX_SUPPORT_MONOTONICARENA_H
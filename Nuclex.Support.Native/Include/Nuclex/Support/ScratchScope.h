@@ -0,0 +1,108 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_SCRATCHSCOPE_H
+#define NUCLEX_SUPPORT_SCRATCHSCOPE_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/MonotonicArena.h"
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Borrows memory from a monotonic arena owned by the calling thread</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each thread has its own scratch arena. A scratch scope remembers how full
+  ///     the arena was when the scope was entered and rewinds it when the scope ends,
+  ///     so temporary buffers needed for a single operation can be taken from the arena
+  ///     without any heap allocations once the arena has grown large enough:
+  ///   </para>
+  ///   <example>
+  ///     <code>
+  ///       void encode(const std::int32_t *values, std::size_t count) {
+  ///         ScratchScope scratch;
+  ///         std::uint32_t *temporary = scratch.AllocateArray&lt;std::uint32_t&gt;(count);
+  ///         // ...
+  ///       }
+  ///     </code>
+  ///   </example>
+  ///   <para>
+  ///     Scopes can be nested, an inner scope only releases what was allocated within it.
+  ///     Memory from a scratch scope must not be handed to another thread or outlive
+  ///     the scope.
+  ///   </para>
+  /// </remarks>
+  class ScratchScope {
+
+    /// <summary>Enters a new scratch scope on the calling thread's arena</summary>
+    public: NUCLEX_SUPPORT_API ScratchScope();
+
+    /// <summary>Releases all memory that was allocated within the scope</summary>
+    public: NUCLEX_SUPPORT_API ~ScratchScope();
+
+    /// <summary>Allocates memory that stays valid until the scope ends</summary>
+    /// <param name="byteCount">Number of bytes that will be allocated</param>
+    /// <param name="alignment">Alignment of the memory, must be a power of two</param>
+    /// <returns>The allocated memory</returns>
+    public: void *Allocate(
+      std::size_t byteCount, std::size_t alignment = alignof(std::max_align_t)
+    ) {
+      return this->arena.Allocate(byteCount, alignment);
+    }
+
+    /// <summary>Allocates uninitialized memory for an array of items</summary>
+    /// <typeparam name="TItem">Type of items the memory will be allocated for</typeparam>
+    /// <param name="itemCount">Number of items the memory should have space for</param>
+    /// <returns>The allocated memory, which stays valid until the scope ends</returns>
+    public: template<typename TItem>
+    TItem *AllocateArray(std::size_t itemCount) {
+      return this->arena.template AllocateArray<TItem>(itemCount);
+    }
+
+    /// <summary>Returns an allocator for standard containers living in the scope</summary>
+    /// <typeparam name="TValue">Type of values the allocator will hand out memory for</typeparam>
+    /// <returns>An allocator taking its memory from the scratch arena</returns>
+    /// <remarks>Containers using the allocator must be destroyed before the scope ends</remarks>
+    public: template<typename TValue>
+    ArenaAllocator<TValue> GetAllocator() {
+      return ArenaAllocator<TValue>(this->arena);
+    }
+
+    /// <summary>Accesses the calling thread's scratch arena</summary>
+    /// <returns>The scratch arena of the calling thread</returns>
+    public: NUCLEX_SUPPORT_API static MonotonicArena &GetThreadArena();
+
+    private: ScratchScope(const ScratchScope &) = delete;
+    private: ScratchScope &operator =(const ScratchScope &) = delete;
+
+    /// <summary>Arena of the thread that entered the scope</summary>
+    private: MonotonicArena &arena;
+    /// <summary>Fill level of the arena when the scope was entered</summary>
+    private: MonotonicArena::Marker marker;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
+
+#endif // NUCLEX_SUPPORT_SCRATCHSCOPE_H
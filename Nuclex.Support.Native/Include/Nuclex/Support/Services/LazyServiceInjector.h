@@ -24,7 +24,10 @@ License along with this library
 #include "Nuclex/Support/Config.h"
 #include "Nuclex/Support/Services/ServiceContainer.h"
 
-#include <map>
+#include <atomic> // for std::atomic
+#include <deque> // for std::deque
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
 
 namespace Nuclex { namespace Support { namespace Services {
 
@@ -53,28 +56,28 @@ namespace Nuclex { namespace Support { namespace Services {
 
   /// <summary>Binds services and initializes them via constructor injection</summary>
   /// <remarks>
-  ///   This is a very simplified dependency injector that only supports global services
-  ///   stored in shared_ptrs.
+  ///   <para>
+  ///     This is a very simplified dependency injector that only supports global services
+  ///     stored in shared_ptrs.
+  ///   </para>
+  ///   <para>
+  ///     By default, the injector must only be used from one thread at a time. If it is
+  ///     constructed for concurrent use, services can be requested from any number of
+  ///     threads at once: services that already exist are handed out without taking
+  ///     a lock and each service has its own lock guarding its construction, so unrelated
+  ///     services can be constructed at the same time. All bindings still need to be
+  ///     set up before the injector is shared between threads.
+  ///   </para>
+  ///   <para>
+  ///     Services requiring themselves, directly or through their dependencies, cause
+  ///     an <see cref="UnresolvedDependencyError" />. In concurrent mode, cycles are
+  ///     detected per thread, so two threads entering the same cycle from different
+  ///     ends at the same time will instead wait on each other. Cycles are errors in
+  ///     the bindings, so this will surface during development in any case.
+  ///   </para>
   /// </remarks>
   class LazyServiceInjector : public ServiceProvider {
 
-    #pragma region class TypeInfoComparer
-
-    /// <summary>Compares instances of std::type_info</summary>
-    private: class TypeInfoComparer {
-
-      /// <summary>Determines the relationship of two std::type_info instances</summary>
-      /// <param name="left">Type info to compare on the left side</param>
-      /// <param name="right">Type info to compare on the right side</param>
-      /// <returns>True if the left side comes before the right side</returns>
-      public: bool operator()(const std::type_info *left, const std::type_info *right) const {
-        return left->before(*right) != 0;
-      }
-
-    };
-
-    #pragma endregion // class TypeInfoComparer
-
     #pragma region class BindSyntax
 
     /// <summary>Provides the syntax for the fluent Bind() method</summary>
@@ -111,18 +114,15 @@ namespace Nuclex { namespace Support { namespace Services {
           "(either providing a default constructor or using only std::shared_ptr arguments)"
         );
 
-        // Implementation looks injectable, add the service factory method to the map
-        const std::type_info &serviceTypeInfo = typeid(TService);
-        this->serviceInjector.factories.insert(
-          ServiceFactoryMap::value_type(
-            &serviceTypeInfo,
-            [](const ServiceProvider &serviceProvider) {
-              typedef Private::ServiceFactory<TImplementation, ConstructorSignature> Factory;
-              return Any(
-                std::static_pointer_cast<TService>(Factory::CreateInstance(serviceProvider))
-              );
-            }
-          )
+        // Implementation looks injectable, add the service factory method to the list
+        this->serviceInjector.addFactory(
+          GetServiceIndex<TService>(), typeid(TService),
+          [](const ServiceProvider &serviceProvider) {
+            typedef Private::ServiceFactory<TImplementation, ConstructorSignature> Factory;
+            return Any(
+              std::static_pointer_cast<TService>(Factory::CreateInstance(serviceProvider))
+            );
+          }
         );
       }
 
@@ -141,15 +141,12 @@ namespace Nuclex { namespace Support { namespace Services {
           "inherits from it"
         );
 
-        // Method does provide the service, add it to the map
-        const std::type_info &serviceTypeInfo = typeid(TService);
-        this->serviceInjector.factories.insert(
-          ServiceFactoryMap::value_type(
-            &serviceTypeInfo,
-            [](const ServiceProvider &serviceProvider) {
-              return Any(std::static_pointer_cast<TService>(TMethod(serviceProvider)));
-            }
-          )
+        // Method does provide the service, add it to the list
+        this->serviceInjector.addFactory(
+          GetServiceIndex<TService>(), typeid(TService),
+          [](const ServiceProvider &serviceProvider) {
+            return Any(std::static_pointer_cast<TService>(TMethod(serviceProvider)));
+          }
         );
 
       }
@@ -161,15 +158,12 @@ namespace Nuclex { namespace Support { namespace Services {
       >
       void ToFactoryMethod() { 
 
-        // Method does provide the service, add it to the map
-        const std::type_info &serviceTypeInfo = typeid(TService);
-        this->serviceInjector.factories.insert(
-          ServiceFactoryMap::value_type(
-            &serviceTypeInfo,
-            [](const ServiceProvider &serviceProvider) {
-              return Any(TMethod(serviceProvider));
-            }
-          )
+        // Method does provide the service, add it to the list
+        this->serviceInjector.addFactory(
+          GetServiceIndex<TService>(), typeid(TService),
+          [](const ServiceProvider &serviceProvider) {
+            return Any(TMethod(serviceProvider));
+          }
         );
 
       }
@@ -177,9 +171,8 @@ namespace Nuclex { namespace Support { namespace Services {
       /// <summary>Binds the service to an already constructed service instance</summary>
       /// <param name="instance">Instance that will be returned for the service</param>
       public: void ToInstance(const std::shared_ptr<TService> &instance) {
-        const std::type_info &serviceTypeInfo = typeid(TService);
-        this->serviceInjector.instances.insert(
-          ServiceInstanceMap::value_type(&serviceTypeInfo, Any(instance))
+        this->serviceInjector.addInstance(
+          GetServiceIndex<TService>(), typeid(TService), Any(instance)
         );
       }
 
@@ -203,16 +196,13 @@ namespace Nuclex { namespace Support { namespace Services {
           "using only std::shared_ptr arguments)"
         );
 
-        // Service looks injectable, add the service factory method to the map
-        const std::type_info &serviceTypeInfo = typeid(TService);
-        this->serviceInjector.factories.insert(
-          ServiceFactoryMap::value_type(
-            &serviceTypeInfo,
-            [](const ServiceProvider &serviceProvider) {
-              typedef Private::ServiceFactory<TService, ConstructorSignature> Factory;
-              return Any(Factory::CreateInstance(serviceProvider));
-            }
-          )
+        // Service looks injectable, add the service factory method to the list
+        this->serviceInjector.addFactory(
+          GetServiceIndex<TService>(), typeid(TService),
+          [](const ServiceProvider &serviceProvider) {
+            typedef Private::ServiceFactory<TService, ConstructorSignature> Factory;
+            return Any(Factory::CreateInstance(serviceProvider));
+          }
         );
 
       }
@@ -225,7 +215,11 @@ namespace Nuclex { namespace Support { namespace Services {
     #pragma endregion // class BindSyntax
 
     /// <summary>Initializes a new service injector</summary>
-    public: NUCLEX_SUPPORT_API LazyServiceInjector() = default;
+    /// <param name="isConcurrent">
+    ///   Whether services will be requested from multiple threads at the same time
+    /// </param>
+    public: NUCLEX_SUPPORT_API LazyServiceInjector(bool isConcurrent = false) :
+      isConcurrent(isConcurrent) {}
 
     /// <summary>Destroys the service injector and frees all resources</summary>
     public: NUCLEX_SUPPORT_API virtual ~LazyServiceInjector() = default;
@@ -243,14 +237,59 @@ namespace Nuclex { namespace Support { namespace Services {
     // Unhide the templated TryGet method fro mthe service provider
     using ServiceProvider::TryGet;
 
+    /// <summary>Constructs all bound services that haven't been constructed yet</summary>
+    /// <param name="threadCount">
+    ///   Number of threads that will construct services, including the calling thread.
+    ///   Zero uses one thread per CPU core.
+    /// </param>
+    /// <remarks>
+    ///   <para>
+    ///     Meant to be called once during startup, after all services have been bound.
+    ///     The threads work through the bound services and each constructs the next one
+    ///     nobody has claimed yet. A service's dependencies are constructed on demand by
+    ///     whichever thread needs them first, while threads needing a dependency that is
+    ///     currently being constructed wait for it. So every service is constructed after
+    ///     its dependencies and unrelated services are constructed at the same time.
+    ///   </para>
+    ///   <para>
+    ///     Only an injector constructed for concurrent use can use multiple threads,
+    ///     otherwise all services are constructed on the calling thread. If a service
+    ///     fails to construct, the remaining threads stop picking up new services and
+    ///     the first exception is rethrown once all threads have finished.
+    ///   </para>
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API void InstantiateAll(std::size_t threadCount = 0);
+
+    /// <summary>Lists the services a service requested while it was being constructed</summary>
+    /// <typeparam name="TService">Service whose dependencies will be listed</typeparam>
+    /// <returns>The types of the services the specified service depends on</returns>
+    /// <remarks>
+    ///   <para>
+    ///     The constructor signature detector only finds out how many arguments
+    ///     a constructor has, their service types are only known once they are requested.
+    ///     So the dependency graph is recorded as services are constructed and this
+    ///     returns an empty list for services that have not been constructed yet
+    ///     or were bound to an instance. Call <see cref="InstantiateAll" /> first to
+    ///     obtain the full graph.
+    ///   </para>
+    ///   <para>
+    ///     In concurrent mode, this must not be called while the service is still being
+    ///     constructed by another thread.
+    ///   </para>
+    /// </remarks>
+    public: template<typename TService>
+    std::vector<const std::type_info *> GetDependencies() const {
+      return getDependencies(GetServiceIndex<TService>());
+    }
+
     /// <summary>Creates a new instance of the specified service</summary>
     /// <typeparam name="TService">Type of service that will be created</typeparam>
     /// <returns>A new instance of the requested service</returns>
     public: template<typename TService>
     std::shared_ptr<TService> Create() const {
-      const std::type_info &serviceTypeInfo = typeid(TService);
+      std::size_t serviceIndex = GetServiceIndex<TService>();
       std::shared_ptr<TService> newServiceInstance(
-        Create(serviceTypeInfo).Get<std::shared_ptr<TService>>()
+        Create(serviceIndex, typeid(TService)).Get<std::shared_ptr<TService>>()
       );
       return newServiceInstance;
     }
@@ -271,6 +310,24 @@ namespace Nuclex { namespace Support { namespace Services {
       const std::type_info &serviceType
     ) const override;
 
+    /// <summary>Looks up the specified service by its service index</summary>
+    /// <param name="serviceIndex">Index of the service type that will be looked up</param>
+    /// <param name="serviceType">Type of service that will be looked up</param>
+    /// <returns>
+    ///   The specified service as a shared_ptr wrapped in an <see cref="Any" />
+    /// </returns>
+    protected: NUCLEX_SUPPORT_API const Any &Get(
+      std::size_t serviceIndex, const std::type_info &serviceType
+    ) const override;
+
+    /// <summary>Tries to look up the specified service by its service index</summary>
+    /// <param name="serviceIndex">Index of the service type that will be looked up</param>
+    /// <param name="serviceType">Type of service that will be looked up</param>
+    /// <returns>An Any containing the service, if found, or an empty Any</returns>
+    protected: NUCLEX_SUPPORT_API const Any &TryGet(
+      std::size_t serviceIndex, const std::type_info &serviceType
+    ) const override;
+
     /// <summary>Creates the specified service</summary>
     /// <param name="serviceType">Type of service that will be created</param>
     /// <returns>
@@ -280,26 +337,118 @@ namespace Nuclex { namespace Support { namespace Services {
       const std::type_info &serviceType
     ) const;
 
+    /// <summary>Creates the specified service by its service index</summary>
+    /// <param name="serviceIndex">Index of the service type that will be created</param>
+    /// <param name="serviceType">Type of service that will be created</param>
+    /// <returns>
+    ///   The specified service as a shared_ptr wrapped in an <see cref="Any" />
+    /// </returns>
+    protected: NUCLEX_SUPPORT_API Any Create(
+      std::size_t serviceIndex, const std::type_info &serviceType
+    ) const;
+
     /// <summary>Delegate for a factory method that creates a service</summary>
     private: typedef Any(*CreateServiceFunction)(const ServiceProvider &);
 
-    /// <summary>Map of factories to create different services</summary> 
-    private: typedef std::map<
-      const std::type_info *, CreateServiceFunction, TypeInfoComparer
-    > ServiceFactoryMap;
+    #pragma region struct ServiceSlot
+
+    /// <summary>Binding and, once constructed, instance of a service</summary>
+    private: struct ServiceSlot {
+
+      /// <summary>Initializes a new, unbound service slot</summary>
+      public: ServiceSlot() :
+        ServiceType(nullptr),
+        Factory(nullptr),
+        IsActivated(false) {}
+
+      /// <summary>Type of the service, null if the service has never been bound</summary>
+      public: const std::type_info *ServiceType;
+      /// <summary>Factory method that constructs the service</summary>
+      public: CreateServiceFunction Factory;
+      /// <summary>Whether the instance has been constructed or assigned</summary>
+      /// <remarks>
+      ///   Set with release semantics once the instance is stored, so any thread that
+      ///   sees it set can read the instance without further synchronization.
+      /// </remarks>
+      public: std::atomic<bool> IsActivated;
+      /// <summary>Stores the service once it has been constructed</summary>
+      public: Any Instance;
+      /// <summary>Held while the service is being constructed in concurrent mode</summary>
+      public: std::mutex ActivationMutex;
+      /// <summary>Indices of the services requested while constructing this one</summary>
+      public: std::vector<std::size_t> Dependencies;
+
+    };
+
+    #pragma endregion // struct ServiceSlot
+
+    /// <summary>Registers a factory method for a service unless it already has one</summary>
+    /// <param name="serviceIndex">Index of the service type the factory creates</param>
+    /// <param name="factory">Factory method that will create the service</param>
+    /// <param name="serviceType">Type of the service the factory creates</param>
+    private: NUCLEX_SUPPORT_API void addFactory(
+      std::size_t serviceIndex, const std::type_info &serviceType,
+      CreateServiceFunction factory
+    );
+
+    /// <summary>Registers a service instance unless the service already has one</summary>
+    /// <param name="serviceIndex">Index of the service type the instance provides</param>
+    /// <param name="serviceType">Type of the service the instance provides</param>
+    /// <param name="instance">Instance that will be returned for the service</param>
+    private: NUCLEX_SUPPORT_API void addInstance(
+      std::size_t serviceIndex, const std::type_info &serviceType, const Any &instance
+    );
+
+    /// <summary>Lists the services a service requested while it was being constructed</summary>
+    /// <param name="serviceIndex">Index of the service whose dependencies will be listed</param>
+    /// <returns>The types of the services the specified service depends on</returns>
+    private: NUCLEX_SUPPORT_API std::vector<const std::type_info *> getDependencies(
+      std::size_t serviceIndex
+    ) const;
+
+    /// <summary>Returns the slot of a service, adding slots up to it if needed</summary>
+    /// <param name="serviceIndex">Index of the service type whose slot will be returned</param>
+    /// <returns>The slot for the specified service</returns>
+    private: ServiceSlot &getOrAddSlot(std::size_t serviceIndex);
+
+    /// <summary>Looks up the slot of a service</summary>
+    /// <param name="serviceIndex">Index of the service type whose slot will be returned</param>
+    /// <returns>The service's slot or a null pointer if the service has never been bound</returns>
+    private: ServiceSlot *getSlot(std::size_t serviceIndex) const {
+      if(serviceIndex < this->slots.size()) {
+        return &this->slots[serviceIndex];
+      } else {
+        return nullptr;
+      }
+    }
+
+    /// <summary>Looks up a service, constructing it if necessary</summary>
+    /// <param name="serviceIndex">Index of the service type that will be looked up</param>
+    /// <returns>The service instance or a null pointer if the service is not bound</returns>
+    private: const Any *resolve(std::size_t serviceIndex) const;
+
+    /// <summary>Constructs a service and stores it as the service's instance</summary>
+    /// <param name="serviceIndex">Index of the service type that will be constructed</param>
+    /// <param name="slot">Slot of the service that will be constructed</param>
+    /// <returns>The service instance stored in the injector</returns>
+    private: const Any &activate(std::size_t serviceIndex, ServiceSlot &slot) const;
 
-    /// <summary>Map of services permanently stored in the container</summary>
-    private: typedef std::map<const std::type_info *, Any> ServiceInstanceMap;
+    /// <summary>Whether services can be requested from multiple threads at once</summary>
+    private: bool isConcurrent;
 
-    // These are both mutable. Reasoning: the service injector acts as if all services
+    // This is mutable. Reasoning: the service injector acts as if all services
     // already existed, so while services may get constructed as a result of requesting
     // them, to the caller there's no different between an already provided service
     // and one that is constructed during the Get() call.
 
-    /// <summary>Factory methods to construct the various services</summary>
-    private: mutable ServiceFactoryMap factories;
-    /// <summary>Stores services that have already been initialized</summary>
-    private: mutable ServiceInstanceMap instances;
+    /// <summary>Bindings and instances of the services, ordered by service index</summary>
+    /// <remarks>
+    ///   A deque because growing it at the end leaves the slots already stored where
+    ///   they are. Service requests only ever touch existing slots, so in concurrent
+    ///   mode, they can read the list without a lock as long as no more bindings are
+    ///   being added.
+    /// </remarks>
+    private: mutable std::deque<ServiceSlot> slots;
 
   };
 
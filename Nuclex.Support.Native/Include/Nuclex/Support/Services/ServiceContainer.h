@@ -24,8 +24,8 @@ License along with this library
 #include "Nuclex/Support/Config.h"
 #include "Nuclex/Support/Services/ServiceProvider.h"
 
-#include <map>
-#include <cstddef>
+#include <deque> // for std::deque
+#include <cstddef> // for std::size_t
 
 namespace Nuclex { namespace Support { namespace Services {
 
@@ -39,25 +39,10 @@ namespace Nuclex { namespace Support { namespace Services {
   /// </remarks>
   class ServiceContainer : public ServiceProvider {
 
-    #pragma region class TypeInfoComparer
-
-    /// <summary>Compares instances of std::type_info</summary>
-    private: class TypeInfoComparer {
-
-      /// <summary>Determines the relationship of two std::type_info instances</summary>
-      /// <param name="left">Type info to compare on the left side</param>
-      /// <param name="right">Type info to compare on the right side</param>
-      /// <returns>True if the left side comes before the right side</returns>
-      public: bool operator()(const std::type_info *left, const std::type_info *right) const {
-        return left->before(*right) != 0;
-      }
-
-    };
-
-    #pragma endregion // class TypeInfoComparer
-
     /// <summary>Initializes a new service container</summary>
-    public: NUCLEX_SUPPORT_API ServiceContainer() = default;
+    public: NUCLEX_SUPPORT_API ServiceContainer() :
+      serviceCount(0),
+      invalidationCount(0) {}
 
     /// <summary>Destroys the service container and frees all resources</summary>
     public: NUCLEX_SUPPORT_API virtual ~ServiceContainer() = default;
@@ -65,7 +50,13 @@ namespace Nuclex { namespace Support { namespace Services {
     /// <summary>Counts the number of services registered in the container</summary>
     /// <returns>The number of services the container is currently holding</returns>
     public: NUCLEX_SUPPORT_API std::size_t CountServices() const {
-      return this->services.size();
+      return this->serviceCount;
+    }
+
+    /// <summary>Returns a counter that changes whenever services are removed</summary>
+    /// <returns>The address of the counter</returns>
+    public: NUCLEX_SUPPORT_API const std::size_t *GetInvalidationCounter() const override {
+      return &this->invalidationCount;
     }
 
     // Unhide the templated Get method from the service provider
@@ -78,14 +69,14 @@ namespace Nuclex { namespace Support { namespace Services {
     /// <typeparam name="TService">Interface under which the service will be added</typeparam>
     /// <param name="service">Service that will be responsible for the interface</param>
     public: template<typename TService> void Add(const std::shared_ptr<TService> &service) {
-      Add(typeid(TService), Any(service));
+      Add(GetServiceIndex<TService>(), Any(service));
     }
 
     /// <summary>Removes a service from the container</summary>
     /// <typeparam name="TService">Interface of the service that will be removed</typeparam>
     /// <returns>True if the service existed and was removed</returns>
     public: template<typename TService> bool Remove() {
-      return Remove(typeid(TService));
+      return Remove(GetServiceIndex<TService>());
     }
 
     /// <summary>Looks up the specified service</summary>
@@ -113,6 +104,24 @@ namespace Nuclex { namespace Support { namespace Services {
     /// </remarks>
     protected: NUCLEX_SUPPORT_API const Any &TryGet(const std::type_info &serviceType) const;
 
+    /// <summary>Looks up the specified service by its service index</summary>
+    /// <param name="serviceIndex">Index of the service type that will be looked up</param>
+    /// <param name="serviceType">Type of service that will be looked up</param>
+    /// <returns>
+    ///   The specified service as a shared_ptr wrapped in an <see cref="Any" />
+    /// </returns>
+    protected: NUCLEX_SUPPORT_API const Any &Get(
+      std::size_t serviceIndex, const std::type_info &serviceType
+    ) const override;
+
+    /// <summary>Tries to look up the specified service by its service index</summary>
+    /// <param name="serviceIndex">Index of the service type that will be looked up</param>
+    /// <param name="serviceType">Type of service that will be looked up</param>
+    /// <returns>An Any containing the service, if found, or an empty Any</returns>
+    protected: NUCLEX_SUPPORT_API const Any &TryGet(
+      std::size_t serviceIndex, const std::type_info &serviceType
+    ) const override;
+
     /// <summary>Adds a service to the container</summary>
     /// <param name="serviceType">
     ///   Type of the service that will be added to the container
@@ -129,11 +138,29 @@ namespace Nuclex { namespace Support { namespace Services {
     /// <returns>True if the service was found and removed</returns>
     protected: NUCLEX_SUPPORT_API bool Remove(const std::type_info &serviceType);
 
-    /// <summary>Map through which services can be looked up</summary> 
-    private: typedef std::map<const std::type_info *, Any, TypeInfoComparer> ServiceMap;
+    /// <summary>Adds a service to the container</summary>
+    /// <param name="serviceIndex">
+    ///   Index of the service type under which the service will be added
+    /// </param>
+    /// <param name="service">Object that provides the service</param>
+    protected: NUCLEX_SUPPORT_API void Add(std::size_t serviceIndex, const Any &service);
+
+    /// <summary>Removes a service from the container</summary>
+    /// <param name="serviceIndex">Index of the service type that will be removed</param>
+    /// <returns>True if the service was found and removed</returns>
+    protected: NUCLEX_SUPPORT_API bool Remove(std::size_t serviceIndex);
 
-    /// <summary>Services the container is currently holding</summary>
-    private: ServiceMap services;
+    /// <summary>Services the container is holding, ordered by service index</summary>
+    /// <remarks>
+    ///   Slots of service types that have not been added are empty. A deque is used
+    ///   rather than a vector because growing it at the end doesn't move the services
+    ///   already stored, so references handed out by Get() stay valid.
+    /// </remarks>
+    private: std::deque<Any> services;
+    /// <summary>Number of slots in the service list that are occupied</summary>
+    private: std::size_t serviceCount;
+    /// <summary>Incremented each time a service is removed</summary>
+    private: std::size_t invalidationCount;
 
   };
 
@@ -0,0 +1,134 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_SERVICES_SERVICEHANDLE_H
+#define NUCLEX_SUPPORT_SERVICES_SERVICEHANDLE_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Services/ServiceProvider.h"
+
+#include <cstddef> // for std::size_t
+#include <memory> // for std::shared_ptr
+
+namespace Nuclex { namespace Support { namespace Services {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up a service once and remembers it for later accesses</summary>
+  /// <typeparam name="TService">Type of service the handle provides</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Code that accesses a service very often (for example once per frame) can keep
+  ///     a handle instead of calling <see cref="ServiceProvider.Get" /> each time. The handle
+  ///     asks the service provider for the service on first access and then hands out
+  ///     the stored shared_ptr, so later accesses neither call into the service provider
+  ///     nor unwrap an <see cref="Any" />.
+  ///   </para>
+  ///   <para>
+  ///     If the service provider can exchange services (like the
+  ///     <see cref="ServiceContainer" /> does when services are added or removed), it
+  ///     provides an invalidation counter. The handle compares that counter with the value
+  ///     it saw when it looked up the service and looks up the service again if they differ.
+  ///   </para>
+  ///   <para>
+  ///     A handle is meant to be used by one thread. The service provider has to outlive
+  ///     all handles created from it.
+  ///   </para>
+  /// </remarks>
+  template<typename TService>
+  class ServiceHandle {
+
+    /// <summary>Initializes a new service handle looking up services from a provider</summary>
+    /// <param name="serviceProvider">Service provider the service will be looked up from</param>
+    public: ServiceHandle(const ServiceProvider &serviceProvider) :
+      serviceProvider(&serviceProvider),
+      invalidationCounter(serviceProvider.GetInvalidationCounter()),
+      invalidationCount(0),
+      service() {}
+
+    /// <summary>Returns the service, looking it up if necessary</summary>
+    /// <returns>The service the handle provides</returns>
+    /// <remarks>
+    ///   Throws the same exceptions as <see cref="ServiceProvider.Get" /> if the service
+    ///   can not be found.
+    /// </remarks>
+    public: const std::shared_ptr<TService> &Get() const {
+      if(!isUpToDate()) {
+        lookUpService();
+      }
+
+      return this->service;
+    }
+
+    /// <summary>Accesses the members of the service</summary>
+    /// <returns>The service the handle provides</returns>
+    public: TService *operator ->() const {
+      return Get().get();
+    }
+
+    /// <summary>Accesses the service</summary>
+    /// <returns>The service the handle provides</returns>
+    public: TService &operator *() const {
+      return *Get();
+    }
+
+    /// <summary>Drops the stored service, forcing it to be looked up on next access</summary>
+    public: void Reset() {
+      this->service.reset();
+    }
+
+    /// <summary>Checks whether the stored service can still be handed out</summary>
+    /// <returns>True if the stored service is present and has not been invalidated</returns>
+    private: bool isUpToDate() const {
+      if(!this->service) {
+        return false;
+      }
+      if(this->invalidationCounter == nullptr) {
+        return true;
+      }
+
+      return (*this->invalidationCounter == this->invalidationCount);
+    }
+
+    /// <summary>Looks up the service from the service provider</summary>
+    private: void lookUpService() const {
+      if(this->invalidationCounter != nullptr) {
+        this->invalidationCount = *this->invalidationCounter;
+      }
+
+      this->service = this->serviceProvider->template Get<TService>();
+    }
+
+    /// <summary>Service provider the service is looked up from</summary>
+    private: const ServiceProvider *serviceProvider;
+    /// <summary>Counter that changes whenever the provider's services change</summary>
+    private: const std::size_t *invalidationCounter;
+    /// <summary>Value of the invalidation counter when the service was looked up</summary>
+    private: mutable std::size_t invalidationCount;
+    /// <summary>The service as it was returned by the service provider</summary>
+    private: mutable std::shared_ptr<TService> service;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Services
+
+#endif // NUCLEX_SUPPORT_SERVICES_SERVICEHANDLE_H
@@ -0,0 +1,71 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_SERVICES_SERVICEINDEX_H
+#define NUCLEX_SUPPORT_SERVICES_SERVICEINDEX_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <typeinfo> // for std::type_info
+
+namespace Nuclex { namespace Support { namespace Services {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the index under which a service type is stored</summary>
+  /// <param name="serviceType">Type of service whose index will be looked up</param>
+  /// <returns>The index of the specified service type</returns>
+  /// <remarks>
+  ///   <para>
+  ///     Each service type is assigned a small, unique number the first time it is
+  ///     looked up. Service providers use these numbers as positions in flat arrays,
+  ///     so finding a service is a plain array access rather than a search through
+  ///     a tree of type_info instances.
+  ///   </para>
+  ///   <para>
+  ///     Indices are assigned by a process-wide registry, so the same type will have
+  ///     the same index in all modules of the application. Looking up an index this way
+  ///     takes a lock and a hash map lookup, call the templated overload instead if you
+  ///     know the service type at compile time.
+  ///   </para>
+  /// </remarks>
+  NUCLEX_SUPPORT_API std::size_t GetServiceIndex(const std::type_info &serviceType);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the index under which a service type is stored</summary>
+  /// <typeparam name="TService">Type of service whose index will be looked up</typeparam>
+  /// <returns>The index of the specified service type</returns>
+  /// <remarks>
+  ///   The registry is only consulted the first time this is called for a type, after
+  ///   that, the index is read from a static variable.
+  /// </remarks>
+  template<typename TService>
+  inline std::size_t GetServiceIndex() {
+    static const std::size_t serviceIndex = GetServiceIndex(typeid(TService));
+    return serviceIndex;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Services
+
+#endif // NUCLEX_SUPPORT_SERVICES_SERVICEINDEX_H
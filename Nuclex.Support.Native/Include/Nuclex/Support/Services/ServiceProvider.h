@@ -23,6 +23,7 @@ License along with this library
 
 #include "Nuclex/Support/Config.h"
 #include "Nuclex/Support/Any.h"
+#include "Nuclex/Support/Services/ServiceIndex.h"
 
 #include <memory>
 
@@ -47,8 +48,11 @@ namespace Nuclex { namespace Support { namespace Services {
     ///   The specified service as a shared_ptr wrapped in an <see cref="Any" />
     /// </returns>
     public: template<typename TService> const std::shared_ptr<TService> &Get() const {
+      typedef typename std::decay<TService>::type VanillaServiceType;
       typedef std::shared_ptr<TService> ServicePointer;
-      return Get(typeid(typename std::decay<TService>::type)).Get<ServicePointer>();
+
+      std::size_t serviceIndex = GetServiceIndex<VanillaServiceType>();
+      return Get(serviceIndex, typeid(VanillaServiceType)).Get<ServicePointer>();
     }
 
     /// <summary>Tries to look up the specified service</summary>
@@ -59,7 +63,8 @@ namespace Nuclex { namespace Support { namespace Services {
       typedef typename std::decay<TService>::type VanillaServiceType;
       typedef std::shared_ptr<VanillaServiceType> SharedServicePointer;
 
-      Any serviceAsAny = TryGet(typeid(VanillaServiceType));
+      std::size_t serviceIndex = GetServiceIndex<VanillaServiceType>();
+      const Any &serviceAsAny = TryGet(serviceIndex, typeid(VanillaServiceType));
       if(serviceAsAny.HasValue()) {
         service = serviceAsAny.Get<SharedServicePointer>();
         return true;
@@ -69,6 +74,20 @@ namespace Nuclex { namespace Support { namespace Services {
       }
     }
 
+    /// <summary>Returns a counter that changes whenever services are exchanged</summary>
+    /// <returns>
+    ///   The address of the counter or a null pointer if services, once provided,
+    ///   are never exchanged or removed
+    /// </returns>
+    /// <remarks>
+    ///   Used by <see cref="ServiceHandle" /> to find out whether the service it has
+    ///   looked up earlier is still current. Service providers whose services can be
+    ///   exchanged or removed must override this and change the counter when they do.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API virtual const std::size_t *GetInvalidationCounter() const {
+      return nullptr;
+    }
+
     /// <summary>Looks up the specified service</summary>
     /// <param name="serviceType">Type of service that will be looked up</param>
     /// <returns>
@@ -96,6 +115,43 @@ namespace Nuclex { namespace Support { namespace Services {
       const std::type_info &serviceType
     ) const = 0;
 
+    /// <summary>Looks up the specified service by its service index</summary>
+    /// <param name="serviceIndex">
+    ///   Index of the service type as returned by <see cref="GetServiceIndex" />
+    /// </param>
+    /// <param name="serviceType">Type of service that will be looked up</param>
+    /// <returns>
+    ///   The specified service as a shared_ptr wrapped in an <see cref="Any" />
+    /// </returns>
+    /// <remarks>
+    ///   This is what the templated Get() method calls. Service providers that store
+    ///   their services in arrays ordered by service index can override it to find
+    ///   services without a search. The default implementation ignores the index.
+    /// </remarks>
+    protected: NUCLEX_SUPPORT_API virtual const Any &Get(
+      std::size_t serviceIndex, const std::type_info &serviceType
+    ) const {
+      (void)serviceIndex;
+      return Get(serviceType);
+    }
+
+    /// <summary>Tries to look up the specified service by its service index</summary>
+    /// <param name="serviceIndex">
+    ///   Index of the service type as returned by <see cref="GetServiceIndex" />
+    /// </param>
+    /// <param name="serviceType">Type of service that will be looked up</param>
+    /// <returns>An Any containing the service, if found, or an empty Any</returns>
+    /// <remarks>
+    ///   This is what the templated TryGet() method calls. The default implementation
+    ///   ignores the index.
+    /// </remarks>
+    protected: NUCLEX_SUPPORT_API virtual const Any &TryGet(
+      std::size_t serviceIndex, const std::type_info &serviceType
+    ) const {
+      (void)serviceIndex;
+      return TryGet(serviceType);
+    }
+
     //private: ServiceProvider(const ServiceProvider &);
     //private: ServiceProvider &operator =(const ServiceProvider &);
 
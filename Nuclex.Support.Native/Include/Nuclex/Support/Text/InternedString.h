@@ -0,0 +1,159 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_TEXT_INTERNEDSTRING_H
+#define NUCLEX_SUPPORT_TEXT_INTERNEDSTRING_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <functional> // for std::hash
+#include <string> // for std::string
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Immutable string of which only one copy exists per distinct text</summary>
+  /// <remarks>
+  ///   <para>
+  ///     All interned strings with the same text share one copy of it, kept in a global
+  ///     table for the lifetime of the process. Comparing two interned strings compares
+  ///     a single pointer and their hash is calculated once when the text is interned.
+  ///     Copying an interned string copies the pointer.
+  ///   </para>
+  ///   <para>
+  ///     Interning a text costs a hash and a lookup in the global table under a lock,
+  ///     so the intended use is interning names and keys once (for example into static
+  ///     variables or when a document is parsed) and comparing them many times.
+  ///   </para>
+  ///   <para>
+  ///     The text of an interned string never moves. Methods accepting a
+  ///     <code>const std::string &amp;</code> can be passed an interned string directly and
+  ///     may recognize it by its address, which the XML readers in Nuclex.Storage do to
+  ///     find attributes without comparing their names.
+  ///   </para>
+  ///   <para>
+  ///     Interned texts are never released, so don't intern texts from untrusted input
+  ///     whose number of distinct values is unbounded.
+  ///   </para>
+  /// </remarks>
+  class InternedString {
+
+    /// <summary>Initializes a new interned string holding an empty text</summary>
+    public: NUCLEX_SUPPORT_API InternedString();
+
+    /// <summary>Initializes a new interned string with the specified text</summary>
+    /// <param name="text">Text that will be interned</param>
+    public: NUCLEX_SUPPORT_API explicit InternedString(const std::string &text);
+
+    /// <summary>Initializes a new interned string with the specified text</summary>
+    /// <param name="text">Zero-terminated text that will be interned</param>
+    public: NUCLEX_SUPPORT_API explicit InternedString(const char *text);
+
+    /// <summary>Initializes a new interned string with the specified text</summary>
+    /// <param name="text">Text that will be interned</param>
+    /// <param name="length">Length of the text in bytes</param>
+    public: NUCLEX_SUPPORT_API InternedString(const char *text, std::size_t length);
+
+    /// <summary>Retrieves the interned text</summary>
+    /// <returns>The text, at an address that stays the same for the whole process</returns>
+    public: const std::string &ToString() const { return this->entry->Text; }
+
+    /// <summary>Provides the interned text to methods expecting a string</summary>
+    /// <returns>The text, at an address that stays the same for the whole process</returns>
+    public: operator const std::string &() const { return this->entry->Text; }
+
+    /// <summary>Retrieves the interned text as a zero-terminated string</summary>
+    /// <returns>The zero-terminated interned text</returns>
+    public: const char *GetCharacters() const { return this->entry->Text.c_str(); }
+
+    /// <summary>Retrieves the length of the interned text</summary>
+    /// <returns>The length of the interned text in bytes</returns>
+    public: std::size_t GetLength() const { return this->entry->Text.length(); }
+
+    /// <summary>Checks whether the interned text is empty</summary>
+    /// <returns>True if the interned text is empty</returns>
+    public: bool IsEmpty() const { return this->entry->Text.empty(); }
+
+    /// <summary>Retrieves the hash of the interned text</summary>
+    /// <returns>The hash that was calculated when the text was interned</returns>
+    public: std::size_t GetHash() const { return this->entry->Hash; }
+
+    /// <summary>Checks whether two interned strings hold the same text</summary>
+    /// <param name="other">Other interned string that will be compared</param>
+    /// <returns>True if both interned strings hold the same text</returns>
+    public: bool operator ==(const InternedString &other) const {
+      return (this->entry == other.entry);
+    }
+
+    /// <summary>Checks whether two interned strings hold different texts</summary>
+    /// <param name="other">Other interned string that will be compared</param>
+    /// <returns>True if the interned strings hold different texts</returns>
+    public: bool operator !=(const InternedString &other) const {
+      return (this->entry != other.entry);
+    }
+
+    /// <summary>Text and hash of an interned string, shared by all its copies</summary>
+    private: struct Entry {
+
+      /// <summary>Text that has been interned</summary>
+      public: std::string Text;
+      /// <summary>Hash of the text</summary>
+      public: std::size_t Hash;
+
+    };
+
+    /// <summary>Looks up or creates the entry for a text in the global table</summary>
+    /// <param name="text">Text whose entry will be returned</param>
+    /// <param name="length">Length of the text in bytes</param>
+    /// <returns>The entry holding the interned text</returns>
+    private: static const Entry *intern(const char *text, std::size_t length);
+
+    /// <summary>Entry holding the interned text</summary>
+    private: const Entry *entry;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
+
+namespace std {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Lets interned strings be used as keys in standard hash containers</summary>
+  template<> struct hash<Nuclex::Support::Text::InternedString> {
+
+    /// <summary>Returns the hash calculated when the string was interned</summary>
+    /// <param name="text">Interned string whose hash will be returned</param>
+    /// <returns>The hash of the interned string</returns>
+    std::size_t operator()(const Nuclex::Support::Text::InternedString &text) const {
+      return text.GetHash();
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // namespace std
+
+#endif // NUCLEX_SUPPORT_TEXT_INTERNEDSTRING_H
@@ -24,7 +24,10 @@ License along with this library
 #include "Nuclex/Support/Config.h"
 #include "Nuclex/Support/Text/StringConverter.h"
 
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::int8_t, std::uint16_t, ...
 #include <string>
+#include <system_error> // for std::errc
 
 namespace Nuclex { namespace Support { namespace Text {
 
@@ -398,6 +401,540 @@ namespace Nuclex { namespace Support { namespace Text {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Number of characters lexical_print() may write at most for any value</summary>
+  /// <remarks>
+  ///   Floating point values are printed without exponent, so the longest outputs are
+  ///   tiny or huge double precision values with their hundreds of digits.
+  /// </remarks>
+  const std::size_t MaximumLexicalPrintLength = 352;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a boolean value into a character buffer</summary>
+  /// <param name="from">Boolean value that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(bool from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an 8 bit unsigned integer into a character buffer</summary>
+  /// <param name="from">8 bit unsigned integer that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(std::uint8_t from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an 8 bit signed integer into a character buffer</summary>
+  /// <param name="from">8 bit signed integer that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(std::int8_t from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 16 bit unsigned integer into a character buffer</summary>
+  /// <param name="from">16 bit unsigned integer that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(std::uint16_t from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 16 bit signed integer into a character buffer</summary>
+  /// <param name="from">16 bit signed integer that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(std::int16_t from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 32 bit unsigned integer into a character buffer</summary>
+  /// <param name="from">32 bit unsigned integer that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(std::uint32_t from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 32 bit signed integer into a character buffer</summary>
+  /// <param name="from">32 bit signed integer that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(std::int32_t from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 64 bit unsigned integer into a character buffer</summary>
+  /// <param name="from">64 bit unsigned integer that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(std::uint64_t from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 64 bit signed integer into a character buffer</summary>
+  /// <param name="from">64 bit signed integer that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(std::int64_t from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a floating point value into a character buffer</summary>
+  /// <param name="from">Floating point value that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(float from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a double precision floating point value into a character buffer</summary>
+  /// <param name="from">Double precision floating point value that will be printed</param>
+  /// <param name="target">
+  ///   Buffer that will receive the printed value, must have room for at least
+  ///   <see cref="MaximumLexicalPrintLength" /> characters
+  /// </param>
+  /// <returns>The address one past the last character that has been printed</returns>
+  /// <remarks>
+  ///   Produces the same text as lexical_cast&lt;std::string&gt;() without allocating
+  ///   memory. The printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API char *lexical_print(double from, char *target);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Outcome of printing a value into a character range</summary>
+  /// <remarks>
+  ///   Has the same members as std::to_chars_result from C++17, so code written against
+  ///   std::to_chars() can switch over to lexical_print() and back.
+  /// </remarks>
+  struct lexical_print_result {
+
+    /// <summary>Address one past the last character that has been printed</summary>
+    /// <remarks>If the value didn't fit, this is the end of the character range</remarks>
+    public: char *ptr;
+    /// <summary>Default-constructed on success, value_too_large if it didn't fit</summary>
+    public: std::errc ec;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a boolean value into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">Boolean value that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, bool value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an 8 bit unsigned integer into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">8 bit unsigned integer that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, std::uint8_t value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an 8 bit signed integer into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">8 bit signed integer that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, std::int8_t value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 16 bit unsigned integer into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">16 bit unsigned integer that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, std::uint16_t value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 16 bit signed integer into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">16 bit signed integer that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, std::int16_t value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 32 bit unsigned integer into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">32 bit unsigned integer that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, std::uint32_t value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 32 bit signed integer into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">32 bit signed integer that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, std::int32_t value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 64 bit unsigned integer into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">64 bit unsigned integer that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, std::uint64_t value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a 64 bit signed integer into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">64 bit signed integer that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, std::int64_t value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a floating point value into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">Floating point value that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, float value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a double precision floating point value into a range of characters</summary>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">Double precision floating point value that will be printed</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  /// <remarks>
+  ///   Works like std::to_chars(): nothing is written if the value doesn't fit
+  ///   and the printed text is not zero-terminated.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_print_result lexical_print(
+    char *first, char *last, double value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Outcome of parsing a value from a range of characters</summary>
+  /// <remarks>
+  ///   Has the same members as std::from_chars_result from C++17, so code written against
+  ///   std::from_chars() can switch over to lexical_parse() and back.
+  /// </remarks>
+  struct lexical_parse_result {
+
+    /// <summary>Address of the first character that was not part of the value</summary>
+    /// <remarks>If no value could be parsed at all, this is the start of the range</remarks>
+    public: const char *ptr;
+    /// <summary>
+    ///   Default-constructed on success, invalid_argument if the range didn't start with
+    ///   a number and result_out_of_range if the number doesn't fit into the value
+    /// </summary>
+    public: std::errc ec;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses an 8 bit unsigned integer from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts decimal digits without leading
+  ///   whitespace, needs no zero terminator and ignores the system locale.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, std::uint8_t &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses an 8 bit signed integer from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts an optional minus sign followed by decimal
+  ///   digits without leading whitespace, needs no zero terminator and ignores
+  ///   the system locale.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, std::int8_t &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a 16 bit unsigned integer from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts decimal digits without leading
+  ///   whitespace, needs no zero terminator and ignores the system locale.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, std::uint16_t &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a 16 bit signed integer from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts an optional minus sign followed by decimal
+  ///   digits without leading whitespace, needs no zero terminator and ignores
+  ///   the system locale.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, std::int16_t &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a 32 bit unsigned integer from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts decimal digits without leading
+  ///   whitespace, needs no zero terminator and ignores the system locale.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, std::uint32_t &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a 32 bit signed integer from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts an optional minus sign followed by decimal
+  ///   digits without leading whitespace, needs no zero terminator and ignores
+  ///   the system locale.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, std::int32_t &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a 64 bit unsigned integer from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts decimal digits without leading
+  ///   whitespace, needs no zero terminator and ignores the system locale.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, std::uint64_t &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a 64 bit signed integer from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts an optional minus sign followed by decimal
+  ///   digits without leading whitespace, needs no zero terminator and ignores
+  ///   the system locale.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, std::int64_t &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a floating point value from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts an optional minus sign, decimal digits with
+  ///   an optional decimal point and an optional exponent. Needs no zero terminator
+  ///   and ignores the system locale. Numbers too large or too small to be represented
+  ///   are reported as result_out_of_range.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, float &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a double precision floating point value from a range of characters</summary>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  /// <remarks>
+  ///   Works like std::from_chars(): accepts an optional minus sign, decimal digits with
+  ///   an optional decimal point and an optional exponent. Needs no zero terminator
+  ///   and ignores the system locale. Numbers too large or too small to be represented
+  ///   are reported as result_out_of_range.
+  /// </remarks>
+  NUCLEX_SUPPORT_API lexical_parse_result lexical_parse(
+    const char *first, const char *last, double &value
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Text
 
 #endif // NUCLEX_SUPPORT_TEXT_LEXICAL_H
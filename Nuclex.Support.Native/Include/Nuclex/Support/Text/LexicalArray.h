@@ -0,0 +1,237 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_TEXT_LEXICALARRAY_H
+#define NUCLEX_SUPPORT_TEXT_LEXICALARRAY_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Text/Lexical.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int32_t, std::uint32_t, std::int64_t, std::uint64_t
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of numbers into a string, separating them by a character</summary>
+  /// <typeparam name="TValue">Type of the values that will be printed</typeparam>
+  /// <param name="values">Values that will be printed</param>
+  /// <param name="count">Number of values that will be printed</param>
+  /// <param name="target">String to which the printed values will be appended</param>
+  /// <param name="separator">Character that will be placed between the values</param>
+  /// <remarks>
+  ///   Each value is printed like lexical_cast&lt;std::string&gt;() would print it, but
+  ///   directly into the target string, which is only grown a handful of times.
+  ///   Available for 32 and 64 bit integers, floats and doubles.
+  /// </remarks>
+  template<typename TValue>
+  inline void FormatArray(
+    const TValue *values, std::size_t count, std::string &target, char separator = ','
+  ) = delete;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a large array of numbers into a string using multiple threads</summary>
+  /// <typeparam name="TValue">Type of the values that will be printed</typeparam>
+  /// <param name="values">Values that will be printed</param>
+  /// <param name="count">Number of values that will be printed</param>
+  /// <param name="target">String to which the printed values will be appended</param>
+  /// <param name="separator">Character that will be placed between the values</param>
+  /// <param name="threadCount">
+  ///   Maximum number of threads that will print values, 0 to use one thread per CPU core
+  /// </param>
+  /// <remarks>
+  ///   <para>
+  ///     Splits the array into chunks that are printed by separate threads and then
+  ///     concatenated. The output is identical to <see cref="FormatArray" />.
+  ///   </para>
+  ///   <para>
+  ///     Starting threads isn't free, so this only pays off for arrays with hundreds
+  ///     of thousands of elements. Smaller arrays are printed on the calling thread.
+  ///   </para>
+  /// </remarks>
+  template<typename TValue>
+  inline void FormatArrayInParallel(
+    const TValue *values, std::size_t count, std::string &target, char separator = ',',
+    std::size_t threadCount = 0
+  ) = delete;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a list of numbers separated by a character into an array</summary>
+  /// <typeparam name="TValue">Type of the values that will be parsed</typeparam>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="values">Vector to which the parsed values will be appended</param>
+  /// <param name="separator">Character that is expected between the values</param>
+  /// <returns>
+  ///   Where parsing stopped and, if the list was malformed, why. Values parsed up to
+  ///   the error will have been appended to the vector.
+  /// </returns>
+  /// <remarks>
+  ///   Spaces, tabs and line breaks around the values are skipped. If the separator
+  ///   itself is one of those, any run of whitespace separates two values. Numbers
+  ///   have to follow the rules of <see cref="lexical_parse" />.
+  /// </remarks>
+  template<typename TValue>
+  inline lexical_parse_result ParseArray(
+    const char *first, const char *last, std::vector<TValue> &values, char separator = ','
+  ) = delete;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of 32 bit integers into a string</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArray<std::int32_t>(
+    const std::int32_t *values, std::size_t count, std::string &target, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of 32 bit unsigned integers into a string</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArray<std::uint32_t>(
+    const std::uint32_t *values, std::size_t count, std::string &target, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of 64 bit integers into a string</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArray<std::int64_t>(
+    const std::int64_t *values, std::size_t count, std::string &target, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of 64 bit unsigned integers into a string</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArray<std::uint64_t>(
+    const std::uint64_t *values, std::size_t count, std::string &target, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of floats into a string</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArray<float>(
+    const float *values, std::size_t count, std::string &target, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of doubles into a string</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArray<double>(
+    const double *values, std::size_t count, std::string &target, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of 32 bit integers into a string in parallel</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArrayInParallel<std::int32_t>(
+    const std::int32_t *values, std::size_t count, std::string &target, char separator,
+    std::size_t threadCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of 32 bit unsigned integers into a string in parallel</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArrayInParallel<std::uint32_t>(
+    const std::uint32_t *values, std::size_t count, std::string &target, char separator,
+    std::size_t threadCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of 64 bit integers into a string in parallel</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArrayInParallel<std::int64_t>(
+    const std::int64_t *values, std::size_t count, std::string &target, char separator,
+    std::size_t threadCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of 64 bit unsigned integers into a string in parallel</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArrayInParallel<std::uint64_t>(
+    const std::uint64_t *values, std::size_t count, std::string &target, char separator,
+    std::size_t threadCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of floats into a string in parallel</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArrayInParallel<float>(
+    const float *values, std::size_t count, std::string &target, char separator,
+    std::size_t threadCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of doubles into a string in parallel</summary>
+  template<> NUCLEX_SUPPORT_API void FormatArrayInParallel<double>(
+    const double *values, std::size_t count, std::string &target, char separator,
+    std::size_t threadCount
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a list of 32 bit integers into an array</summary>
+  template<> NUCLEX_SUPPORT_API lexical_parse_result ParseArray<std::int32_t>(
+    const char *first, const char *last, std::vector<std::int32_t> &values, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a list of 32 bit unsigned integers into an array</summary>
+  template<> NUCLEX_SUPPORT_API lexical_parse_result ParseArray<std::uint32_t>(
+    const char *first, const char *last, std::vector<std::uint32_t> &values, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a list of 64 bit integers into an array</summary>
+  template<> NUCLEX_SUPPORT_API lexical_parse_result ParseArray<std::int64_t>(
+    const char *first, const char *last, std::vector<std::int64_t> &values, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a list of 64 bit unsigned integers into an array</summary>
+  template<> NUCLEX_SUPPORT_API lexical_parse_result ParseArray<std::uint64_t>(
+    const char *first, const char *last, std::vector<std::uint64_t> &values, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a list of floats into an array</summary>
+  template<> NUCLEX_SUPPORT_API lexical_parse_result ParseArray<float>(
+    const char *first, const char *last, std::vector<float> &values, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a list of doubles into an array</summary>
+  template<> NUCLEX_SUPPORT_API lexical_parse_result ParseArray<double>(
+    const char *first, const char *last, std::vector<double> &values, char separator
+  );
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
+
+#endif // NUCLEX_SUPPORT_TEXT_LEXICALARRAY_H
@@ -0,0 +1,258 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_TEXT_STRINGBUILDER_H
+#define NUCLEX_SUPPORT_TEXT_STRINGBUILDER_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::int8_t, std::uint16_t, std::int16_t, etc.
+#include <cstring> // for std::memcpy(), std::strlen()
+#include <string> // for std::string
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Assembles text in a single growable buffer</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Building text by concatenating std::strings creates a temporary for nearly
+  ///     every piece. The string builder appends everything, including numbers and
+  ///     escaped text, directly into one buffer that only grows when it runs full.
+  ///     A builder that is cleared and reused stops allocating after the first run.
+  ///   </para>
+  ///   <para>
+  ///     Numbers are printed through <see cref="lexical_print" />, so they are formatted
+  ///     the same way as by <see cref="lexical_cast" />: locale-independent and, for
+  ///     floating point values, with the shortest text that reads back exactly.
+  ///   </para>
+  ///   <para>
+  ///     When escaping text for XML or JSON, the text is scanned for special characters
+  ///     16 bytes at a time where SSE2 is available. Runs without special characters,
+  ///     which is nearly all text, are copied in one piece.
+  ///   </para>
+  /// </remarks>
+  class StringBuilder {
+
+    /// <summary>Initializes a new, empty string builder</summary>
+    /// <remarks>No memory is allocated until the first text is appended</remarks>
+    public: NUCLEX_SUPPORT_API StringBuilder();
+
+    /// <summary>Initializes a new string builder with the specified capacity</summary>
+    /// <param name="capacity">Number of characters the builder can hold without growing</param>
+    public: NUCLEX_SUPPORT_API explicit StringBuilder(std::size_t capacity);
+
+    /// <summary>Takes over the buffer of another string builder</summary>
+    /// <param name="other">String builder whose buffer will be taken over</param>
+    public: NUCLEX_SUPPORT_API StringBuilder(StringBuilder &&other);
+
+    /// <summary>Frees the buffer of the string builder</summary>
+    public: NUCLEX_SUPPORT_API ~StringBuilder();
+
+    /// <summary>Takes over the buffer of another string builder</summary>
+    /// <param name="other">String builder whose buffer will be taken over</param>
+    /// <returns>The string builder itself</returns>
+    public: NUCLEX_SUPPORT_API StringBuilder &operator =(StringBuilder &&other);
+
+    /// <summary>Retrieves the number of characters that have been appended</summary>
+    /// <returns>The length of the text in the builder in bytes</returns>
+    public: std::size_t GetLength() const { return this->length; }
+
+    /// <summary>Retrieves the number of characters the builder can hold</summary>
+    /// <returns>The number of characters that fit in the buffer without growing it</returns>
+    public: std::size_t GetCapacity() const { return this->capacity; }
+
+    /// <summary>Checks whether the builder holds any text</summary>
+    /// <returns>True if no text has been appended since the builder was cleared</returns>
+    public: bool IsEmpty() const { return (this->length == 0); }
+
+    /// <summary>Provides direct access to the characters in the builder</summary>
+    /// <returns>The characters in the builder, which are not zero-terminated</returns>
+    /// <remarks>
+    ///   The address is valid until the next call that appends to the builder.
+    ///   Together with <see cref="GetLength" />, this lets the text be written out
+    ///   without copying it into a string first.
+    /// </remarks>
+    public: const char *GetCharacters() const { return this->characters; }
+
+    /// <summary>Copies the text in the builder into a string</summary>
+    /// <returns>A string holding the text in the builder</returns>
+    public: std::string ToString() const {
+      if(this->length == 0) {
+        return std::string(); // Buffer may not even have been allocated yet
+      } else {
+        return std::string(this->characters, this->length);
+      }
+    }
+
+    /// <summary>Removes all text from the builder, keeping its buffer</summary>
+    public: void Clear() { this->length = 0; }
+
+    /// <summary>Makes sure the builder can hold the specified number of characters</summary>
+    /// <param name="capacity">Number of characters the builder should be able to hold</param>
+    public: void Reserve(std::size_t capacity) {
+      if(capacity > this->capacity) {
+        grow(capacity);
+      }
+    }
+
+    /// <summary>Appends a single character</summary>
+    /// <param name="character">Character that will be appended</param>
+    public: void Append(char character) {
+      ensureAvailable(1);
+      this->characters[this->length] = character;
+      ++this->length;
+    }
+
+    /// <summary>Appends a number of characters</summary>
+    /// <param name="text">Characters that will be appended</param>
+    /// <param name="count">Number of characters that will be appended</param>
+    public: void Append(const char *text, std::size_t count) {
+      if(count > 0) {
+        ensureAvailable(count);
+        std::memcpy(this->characters + this->length, text, count);
+        this->length += count;
+      }
+    }
+
+    /// <summary>Appends a zero-terminated string</summary>
+    /// <param name="text">Zero-terminated string that will be appended</param>
+    public: void Append(const char *text) {
+      Append(text, std::strlen(text));
+    }
+
+    /// <summary>Appends a string</summary>
+    /// <param name="text">String that will be appended</param>
+    public: void Append(const std::string &text) {
+      Append(text.data(), text.length());
+    }
+
+    /// <summary>Appends a boolean as either 'true' or 'false'</summary>
+    /// <param name="value">Boolean that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(bool value);
+
+    /// <summary>Appends an 8 bit unsigned integer as a decimal number</summary>
+    /// <param name="value">Integer that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(std::uint8_t value);
+
+    /// <summary>Appends an 8 bit signed integer as a decimal number</summary>
+    /// <param name="value">Integer that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(std::int8_t value);
+
+    /// <summary>Appends a 16 bit unsigned integer as a decimal number</summary>
+    /// <param name="value">Integer that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(std::uint16_t value);
+
+    /// <summary>Appends a 16 bit signed integer as a decimal number</summary>
+    /// <param name="value">Integer that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(std::int16_t value);
+
+    /// <summary>Appends a 32 bit unsigned integer as a decimal number</summary>
+    /// <param name="value">Integer that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(std::uint32_t value);
+
+    /// <summary>Appends a 32 bit signed integer as a decimal number</summary>
+    /// <param name="value">Integer that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(std::int32_t value);
+
+    /// <summary>Appends a 64 bit unsigned integer as a decimal number</summary>
+    /// <param name="value">Integer that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(std::uint64_t value);
+
+    /// <summary>Appends a 64 bit signed integer as a decimal number</summary>
+    /// <param name="value">Integer that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(std::int64_t value);
+
+    /// <summary>Appends a floating point value as a decimal number</summary>
+    /// <param name="value">Floating point value that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(float value);
+
+    /// <summary>Appends a floating point value as a decimal number</summary>
+    /// <param name="value">Floating point value that will be appended</param>
+    public: NUCLEX_SUPPORT_API void Append(double value);
+
+    /// <summary>Appends text with the XML special characters replaced by entities</summary>
+    /// <param name="text">Text that will be escaped and appended</param>
+    /// <param name="count">Number of characters in the text</param>
+    /// <remarks>
+    ///   Replaces &lt;, &gt;, &amp;, &quot; and &apos; so the text can be used both
+    ///   as element content and as an attribute value.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API void AppendXmlEscaped(const char *text, std::size_t count);
+
+    /// <summary>Appends text with the XML special characters replaced by entities</summary>
+    /// <param name="text">Text that will be escaped and appended</param>
+    public: void AppendXmlEscaped(const std::string &text) {
+      AppendXmlEscaped(text.data(), text.length());
+    }
+
+    /// <summary>Appends text escaped for use inside a JSON string</summary>
+    /// <param name="text">Text that will be escaped and appended</param>
+    /// <param name="count">Number of characters in the text</param>
+    /// <remarks>
+    ///   Escapes quotes, backslashes and control characters. The quotes around
+    ///   the string are not appended. UTF-8 characters are copied as they are.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API void AppendJsonEscaped(const char *text, std::size_t count);
+
+    /// <summary>Appends text escaped for use inside a JSON string</summary>
+    /// <param name="text">Text that will be escaped and appended</param>
+    public: void AppendJsonEscaped(const std::string &text) {
+      AppendJsonEscaped(text.data(), text.length());
+    }
+
+    private: StringBuilder(const StringBuilder &) = delete;
+    private: StringBuilder &operator =(const StringBuilder &) = delete;
+
+    /// <summary>Makes sure the specified number of characters can be appended</summary>
+    /// <param name="count">Number of characters that need to fit into the buffer</param>
+    private: void ensureAvailable(std::size_t count) {
+      if(this->capacity - this->length < count) {
+        grow(this->length + count);
+      }
+    }
+
+    /// <summary>Enlarges the buffer so it can hold at least the specified capacity</summary>
+    /// <param name="requiredCapacity">Number of characters the buffer needs to hold</param>
+    private: NUCLEX_SUPPORT_API void grow(std::size_t requiredCapacity);
+
+    /// <summary>Prints a number directly into the buffer</summary>
+    /// <typeparam name="TValue">Type of number that will be printed</typeparam>
+    /// <param name="value">Number that will be printed</param>
+    /// <param name="maximumLength">Number of characters the number can take at most</param>
+    private: template<typename TValue>
+    void appendNumber(TValue value, std::size_t maximumLength);
+
+    /// <summary>Buffer holding the characters that have been appended</summary>
+    private: char *characters;
+    /// <summary>Number of characters that have been appended</summary>
+    private: std::size_t length;
+    /// <summary>Number of characters the buffer can hold</summary>
+    private: std::size_t capacity;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
+
+#endif // NUCLEX_SUPPORT_TEXT_STRINGBUILDER_H
@@ -23,6 +23,7 @@ License along with this library
 
 #include "Nuclex/Support/Config.h"
 
+#include <cstddef> // for std::size_t
 #include <string>
 
 namespace Nuclex { namespace Support { namespace Text {
@@ -65,6 +66,12 @@ namespace Nuclex { namespace Support { namespace Text {
   ///     translate via Utf16FromUtf8(). If you need &quot;wide strings&quot; (you shouldn't)
   ///     use WideCharFromUtf8() - it will select UTF-16 or UTF-32 to match wchar_t.
   ///   </para>
+  ///   <para>
+  ///     Besides the variants returning a new string, each conversion can also write
+  ///     into a buffer provided by the caller or append to an existing string. These
+  ///     don't allocate memory (unless the existing string needs to grow), so they
+  ///     can be used in hot paths like logging or path handling.
+  ///   </para>
   /// </remarks>
   class StringConverter {
 
@@ -116,6 +123,156 @@ namespace Nuclex { namespace Support { namespace Text {
       const std::u32string &utf32String
     );
 
+    /// <summary>Converts UTF-8 characters into a buffer of wide characters</summary>
+    /// <param name="utf8Characters">UTF-8 characters that will be converted</param>
+    /// <param name="count">Number of UTF-8 characters that will be converted</param>
+    /// <param name="buffer">Buffer that will receive the wide characters</param>
+    /// <param name="bufferLength">Number of characters the buffer can hold</param>
+    /// <returns>
+    ///   The number of characters written into the buffer or, if the buffer is too small,
+    ///   the number of characters it would need to hold the converted text
+    /// </returns>
+    /// <remarks>
+    ///   No terminating zero is written. If the buffer is too small, it receives as many
+    ///   characters as fit without splitting a code point.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static std::size_t WideFromUtf8(
+      const char *utf8Characters, std::size_t count, wchar_t *buffer, std::size_t bufferLength
+    );
+
+    /// <summary>Converts UTF-8 characters and appends them to a wide string</summary>
+    /// <param name="target">String the wide characters will be appended to</param>
+    /// <param name="utf8Characters">UTF-8 characters that will be converted</param>
+    /// <param name="count">Number of UTF-8 characters that will be converted</param>
+    public: NUCLEX_SUPPORT_API static void AppendWideFromUtf8(
+      std::wstring &target, const char *utf8Characters, std::size_t count
+    );
+
+    /// <summary>Converts wide characters into a buffer of UTF-8 characters</summary>
+    /// <param name="wideCharacters">Wide characters that will be converted</param>
+    /// <param name="count">Number of wide characters that will be converted</param>
+    /// <param name="buffer">Buffer that will receive the UTF-8 characters</param>
+    /// <param name="bufferLength">Number of characters the buffer can hold</param>
+    /// <returns>
+    ///   The number of characters written into the buffer or, if the buffer is too small,
+    ///   the number of characters it would need to hold the converted text
+    /// </returns>
+    /// <remarks>
+    ///   No terminating zero is written. If the buffer is too small, it receives as many
+    ///   characters as fit without splitting a code point.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static std::size_t Utf8FromWide(
+      const wchar_t *wideCharacters, std::size_t count, char *buffer, std::size_t bufferLength
+    );
+
+    /// <summary>Converts wide characters and appends them to a UTF-8 string</summary>
+    /// <param name="target">String the UTF-8 characters will be appended to</param>
+    /// <param name="wideCharacters">Wide characters that will be converted</param>
+    /// <param name="count">Number of wide characters that will be converted</param>
+    public: NUCLEX_SUPPORT_API static void AppendUtf8FromWide(
+      std::string &target, const wchar_t *wideCharacters, std::size_t count
+    );
+
+    /// <summary>Converts UTF-8 characters into a buffer of UTF-16 characters</summary>
+    /// <param name="utf8Characters">UTF-8 characters that will be converted</param>
+    /// <param name="count">Number of UTF-8 characters that will be converted</param>
+    /// <param name="buffer">Buffer that will receive the UTF-16 characters</param>
+    /// <param name="bufferLength">Number of characters the buffer can hold</param>
+    /// <returns>
+    ///   The number of characters written into the buffer or, if the buffer is too small,
+    ///   the number of characters it would need to hold the converted text
+    /// </returns>
+    /// <remarks>
+    ///   No terminating zero is written. If the buffer is too small, it receives as many
+    ///   characters as fit without splitting a code point.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static std::size_t Utf16FromUtf8(
+      const char *utf8Characters, std::size_t count, char16_t *buffer, std::size_t bufferLength
+    );
+
+    /// <summary>Converts UTF-8 characters and appends them to a UTF-16 string</summary>
+    /// <param name="target">String the UTF-16 characters will be appended to</param>
+    /// <param name="utf8Characters">UTF-8 characters that will be converted</param>
+    /// <param name="count">Number of UTF-8 characters that will be converted</param>
+    public: NUCLEX_SUPPORT_API static void AppendUtf16FromUtf8(
+      std::u16string &target, const char *utf8Characters, std::size_t count
+    );
+
+    /// <summary>Converts UTF-16 characters into a buffer of UTF-8 characters</summary>
+    /// <param name="utf16Characters">UTF-16 characters that will be converted</param>
+    /// <param name="count">Number of UTF-16 characters that will be converted</param>
+    /// <param name="buffer">Buffer that will receive the UTF-8 characters</param>
+    /// <param name="bufferLength">Number of characters the buffer can hold</param>
+    /// <returns>
+    ///   The number of characters written into the buffer or, if the buffer is too small,
+    ///   the number of characters it would need to hold the converted text
+    /// </returns>
+    /// <remarks>
+    ///   No terminating zero is written. If the buffer is too small, it receives as many
+    ///   characters as fit without splitting a code point.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static std::size_t Utf8FromUtf16(
+      const char16_t *utf16Characters, std::size_t count, char *buffer, std::size_t bufferLength
+    );
+
+    /// <summary>Converts UTF-16 characters and appends them to a UTF-8 string</summary>
+    /// <param name="target">String the UTF-8 characters will be appended to</param>
+    /// <param name="utf16Characters">UTF-16 characters that will be converted</param>
+    /// <param name="count">Number of UTF-16 characters that will be converted</param>
+    public: NUCLEX_SUPPORT_API static void AppendUtf8FromUtf16(
+      std::string &target, const char16_t *utf16Characters, std::size_t count
+    );
+
+    /// <summary>Converts UTF-8 characters into a buffer of UTF-32 characters</summary>
+    /// <param name="utf8Characters">UTF-8 characters that will be converted</param>
+    /// <param name="count">Number of UTF-8 characters that will be converted</param>
+    /// <param name="buffer">Buffer that will receive the UTF-32 characters</param>
+    /// <param name="bufferLength">Number of characters the buffer can hold</param>
+    /// <returns>
+    ///   The number of characters written into the buffer or, if the buffer is too small,
+    ///   the number of characters it would need to hold the converted text
+    /// </returns>
+    /// <remarks>
+    ///   No terminating zero is written. If the buffer is too small, it receives as many
+    ///   characters as fit without splitting a code point.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static std::size_t Utf32FromUtf8(
+      const char *utf8Characters, std::size_t count, char32_t *buffer, std::size_t bufferLength
+    );
+
+    /// <summary>Converts UTF-8 characters and appends them to a UTF-32 string</summary>
+    /// <param name="target">String the UTF-32 characters will be appended to</param>
+    /// <param name="utf8Characters">UTF-8 characters that will be converted</param>
+    /// <param name="count">Number of UTF-8 characters that will be converted</param>
+    public: NUCLEX_SUPPORT_API static void AppendUtf32FromUtf8(
+      std::u32string &target, const char *utf8Characters, std::size_t count
+    );
+
+    /// <summary>Converts UTF-32 characters into a buffer of UTF-8 characters</summary>
+    /// <param name="utf32Characters">UTF-32 characters that will be converted</param>
+    /// <param name="count">Number of UTF-32 characters that will be converted</param>
+    /// <param name="buffer">Buffer that will receive the UTF-8 characters</param>
+    /// <param name="bufferLength">Number of characters the buffer can hold</param>
+    /// <returns>
+    ///   The number of characters written into the buffer or, if the buffer is too small,
+    ///   the number of characters it would need to hold the converted text
+    /// </returns>
+    /// <remarks>
+    ///   No terminating zero is written. If the buffer is too small, it receives as many
+    ///   characters as fit without splitting a code point.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static std::size_t Utf8FromUtf32(
+      const char32_t *utf32Characters, std::size_t count, char *buffer, std::size_t bufferLength
+    );
+
+    /// <summary>Converts UTF-32 characters and appends them to a UTF-8 string</summary>
+    /// <param name="target">String the UTF-8 characters will be appended to</param>
+    /// <param name="utf32Characters">UTF-32 characters that will be converted</param>
+    /// <param name="count">Number of UTF-32 characters that will be converted</param>
+    public: NUCLEX_SUPPORT_API static void AppendUtf8FromUtf32(
+      std::string &target, const char32_t *utf32Characters, std::size_t count
+    );
+
     /// <summary>Converts the specified UTF-8 string to &quot;folded lowercase&quot;</summary>
     /// <param name="utf8String">String that will be converted</param>
     /// <returns>An equivalent-ish string using only lowercase characters</returns>
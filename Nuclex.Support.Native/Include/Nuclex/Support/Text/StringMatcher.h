@@ -23,6 +23,7 @@ License along with this library
 
 #include "Nuclex/Support/Config.h"
 
+#include <cstddef> // for std::size_t
 #include <string>
 
 namespace Nuclex { namespace Support { namespace Text {
@@ -39,8 +40,10 @@ namespace Nuclex { namespace Support { namespace Text {
     /// <returns>True if the two strings are equal, false otherwise</returns>
     /// <remarks>
     ///   This method is ideal for one-off comparisons. If you have to compare one string
-    ///   against multiple strings or want to create a case-insensitive string map,
-    ///   consider using the <see cref="StringConverter.ToFoldedLowercase" /> method.
+    ///   against multiple strings, consider using the
+    ///   <see cref="StringConverter.FoldedLowercaseFromUtf8" /> method. For case-insensitive
+    ///   string maps, use <see cref="CaseInsensitiveUtf8Hash" /> and
+    ///   <see cref="CaseInsensitiveUtf8Equal" />.
     /// </remarks>
     public: NUCLEX_SUPPORT_API static bool AreEqual(
       const std::string &left, const std::string &right, bool caseSensitive = false
@@ -59,6 +62,44 @@ namespace Nuclex { namespace Support { namespace Text {
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Hashes UTF-8 strings without regard to the case of their letters</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Strings that only differ in case produce the same hash. The letters are
+  ///     case-folded while hashing, so no folded copy of the string is created.
+  ///   </para>
+  ///   <para>
+  ///     Use together with <see cref="CaseInsensitiveUtf8Equal" />, for example as in
+  ///     std::unordered_map&lt;std::string, T, CaseInsensitiveUtf8Hash,
+  ///     CaseInsensitiveUtf8Equal&gt;.
+  ///   </para>
+  /// </remarks>
+  struct CaseInsensitiveUtf8Hash {
+
+    /// <summary>Calculates a case-insensitive hash of the specified UTF-8 string</summary>
+    /// <param name="text">UTF-8 string that will be hashed</param>
+    /// <returns>The hash of the string's case-folded characters</returns>
+    public: NUCLEX_SUPPORT_API std::size_t operator()(const std::string &text) const;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compares UTF-8 strings without regard to the case of their letters</summary>
+  struct CaseInsensitiveUtf8Equal {
+
+    /// <summary>Checks whether two UTF-8 strings are equal when ignoring case</summary>
+    /// <param name="left">String that will be compared on the left side</param>
+    /// <param name="right">String that will be compared on the right side</param>
+    /// <returns>True if the two strings are equal when ignoring case</returns>
+    public: bool operator()(const std::string &left, const std::string &right) const {
+      return StringMatcher::AreEqual(left, right, false);
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Text
 
 #endif // NUCLEX_SUPPORT_TEXT_STRINGMATCHER_H
@@ -0,0 +1,88 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_TEXT_UTF8VALIDATOR_H
+#define NUCLEX_SUPPORT_TEXT_UTF8VALIDATOR_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <string> // for std::string
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks and measures UTF-8 text in bulk</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Validation follows the rules of the unicode standard: overlong encodings,
+  ///     surrogates, code points above U+10FFFF and truncated sequences are rejected.
+  ///   </para>
+  ///   <para>
+  ///     Where SSSE3 is available, 16 bytes are checked at once by looking up the high
+  ///     and low nibbles of each byte and its predecessor in small tables (the method
+  ///     described by Keiser and Lemire in &quot;Validating UTF-8 In Less Than One
+  ///     Instruction Per Byte&quot;), which keeps up with the memory bandwidth.
+  ///     Elsewhere, runs of ASCII characters are skipped 16 or 8 bytes at a time and only
+  ///     the code points outside of ASCII are decoded one by one.
+  ///   </para>
+  /// </remarks>
+  class Utf8Validator {
+
+    /// <summary>Checks whether the specified characters are valid UTF-8</summary>
+    /// <param name="characters">Characters that will be checked</param>
+    /// <param name="count">Number of characters (bytes) that will be checked</param>
+    /// <returns>True if the characters form valid UTF-8 text</returns>
+    public: NUCLEX_SUPPORT_API static bool IsValid(const char *characters, std::size_t count);
+
+    /// <summary>Checks whether the specified string is valid UTF-8</summary>
+    /// <param name="text">String that will be checked</param>
+    /// <returns>True if the string contains valid UTF-8 text</returns>
+    public: static bool IsValid(const std::string &text) {
+      return IsValid(text.data(), text.length());
+    }
+
+    /// <summary>Counts the code points in a UTF-8 string</summary>
+    /// <param name="characters">Characters whose code points will be counted</param>
+    /// <param name="count">Number of characters (bytes) that will be counted</param>
+    /// <returns>The number of code points encoded in the characters</returns>
+    /// <remarks>
+    ///   Counts all bytes that do not continue a code point. For valid UTF-8, this is
+    ///   the number of code points. Invalid text is not detected but counted all the same.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static std::size_t CountCodePoints(
+      const char *characters, std::size_t count
+    );
+
+    /// <summary>Counts the code points in a UTF-8 string</summary>
+    /// <param name="text">String whose code points will be counted</param>
+    /// <returns>The number of code points encoded in the string</returns>
+    public: static std::size_t CountCodePoints(const std::string &text) {
+      return CountCodePoints(text.data(), text.length());
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
+
+#endif // NUCLEX_SUPPORT_TEXT_UTF8VALIDATOR_H
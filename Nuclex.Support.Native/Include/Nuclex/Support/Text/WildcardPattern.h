@@ -0,0 +1,145 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_TEXT_WILDCARDPATTERN_H
+#define NUCLEX_SUPPORT_TEXT_WILDCARDPATTERN_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class WildcardSet;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Wildcard that has been prepared for matching many strings against it</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Matches strings exactly like <see cref="StringMatcher.FitsWildcard" />: a star
+  ///     stands for any number of characters (including none) and a question mark stands
+  ///     for exactly one character. Where FitsWildcard() interprets the wildcard again
+  ///     each time, this class analyzes it once when it is constructed.
+  ///   </para>
+  ///   <para>
+  ///     The wildcard is split at its stars into segments. The segment before the first
+  ///     star has to match the start of the string, the segment after the last star
+  ///     has to match its end and the segments between are looked for front to back with
+  ///     a substring search. For case-insensitive wildcards, the wildcard is case-folded
+  ///     once up front and only the string being checked needs to be folded.
+  ///   </para>
+  /// </remarks>
+  class WildcardPattern {
+
+    /// <summary>Prepares the specified wildcard for matching</summary>
+    /// <param name="wildcard">UTF-8 wildcard strings will be matched against</param>
+    /// <param name="caseSensitive">Whether matching strings will be case sensitive</param>
+    public: NUCLEX_SUPPORT_API WildcardPattern(
+      const std::string &wildcard, bool caseSensitive = false
+    );
+
+    /// <summary>Checks whether a UTF-8 string matches the wildcard</summary>
+    /// <param name="text">Text that will be matched against the wildcard</param>
+    /// <returns>True if the text matches the wildcard</returns>
+    public: NUCLEX_SUPPORT_API bool Matches(const std::string &text) const;
+
+    /// <summary>Whether the wildcard ignores the case of letters</summary>
+    /// <returns>True if the wildcard is matched case-sensitively</returns>
+    public: bool IsCaseSensitive() const { return this->caseSensitive; }
+
+    /// <summary>Appends a segment to the list of segments</summary>
+    /// <param name="characters">Characters between two stars in the wildcard</param>
+    private: void addSegment(const std::string &characters);
+
+    /// <summary>Checks a string that has already been case-folded if needed</summary>
+    /// <param name="text">Text that will be matched against the wildcard</param>
+    /// <param name="length">Length of the text in bytes</param>
+    /// <returns>True if the text matches the wildcard</returns>
+    private: bool matchesPrepared(const char *text, std::size_t length) const;
+
+    #pragma region struct Segment
+
+    /// <summary>Characters between two stars in the wildcard</summary>
+    private: struct Segment {
+
+      /// <summary>UTF-8 characters of the segment, including its question marks</summary>
+      public: std::string Characters;
+      /// <summary>Whether the segment contains any question marks</summary>
+      public: bool HasQuestionMarks;
+      /// <summary>Number of bytes the segment needs at the very least</summary>
+      public: std::size_t MinimumByteCount;
+
+    };
+
+    #pragma endregion // struct Segment
+
+    /// <summary>Finds the first match of a segment in a range of a string</summary>
+    /// <param name="segment">Segment that will be looked for</param>
+    /// <param name="begin">Position from which on the segment will be looked for</param>
+    /// <param name="end">Position at which the search will end</param>
+    /// <param name="matchEnd">Receives the position one past the match</param>
+    /// <returns>The position at which the match starts or a null pointer</returns>
+    private: static const char *find(
+      const Segment &segment, const char *begin, const char *end, const char *&matchEnd
+    );
+
+    /// <summary>Checks whether a segment matches at the specified position</summary>
+    /// <param name="segment">Segment that will be matched</param>
+    /// <param name="position">Position at which the segment will be matched</param>
+    /// <param name="end">Position one past the end of the string</param>
+    /// <returns>The position one past the match or a null pointer</returns>
+    private: static const char *matchAt(
+      const Segment &segment, const char *position, const char *end
+    );
+
+    /// <summary>Checks whether a segment matches the end of a range</summary>
+    /// <param name="segment">Segment that will be matched</param>
+    /// <param name="begin">Position before which the match must not begin</param>
+    /// <param name="end">Position at which the match needs to end</param>
+    /// <returns>The position at which the match starts or a null pointer</returns>
+    private: static const char *matchBefore(
+      const Segment &segment, const char *begin, const char *end
+    );
+
+    /// <summary>Segments between the stars of the wildcard</summary>
+    private: std::vector<Segment> segments;
+    /// <summary>Number of bytes strings need to have at the very least</summary>
+    private: std::size_t minimumByteCount;
+    /// <summary>Whether the first segment has to match the start of a string</summary>
+    private: bool anchoredAtStart;
+    /// <summary>Whether the last segment has to match the end of a string</summary>
+    private: bool anchoredAtEnd;
+    /// <summary>Whether the wildcard is matched case-sensitively</summary>
+    private: bool caseSensitive;
+
+    friend class WildcardSet;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
+
+#endif // NUCLEX_SUPPORT_TEXT_WILDCARDPATTERN_H
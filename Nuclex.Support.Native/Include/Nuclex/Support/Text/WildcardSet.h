@@ -0,0 +1,134 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_TEXT_WILDCARDSET_H
+#define NUCLEX_SUPPORT_TEXT_WILDCARDSET_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Text/WildcardPattern.h"
+
+#include <cstddef> // for std::size_t
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of wildcards that strings can be matched against all at once</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Useful when many strings (file names, for example) are checked against a list
+  ///     of patterns. For case-insensitive sets, each string is case-folded only once
+  ///     no matter how many wildcards it is checked against.
+  ///   </para>
+  ///   <para>
+  ///     The set also remembers the first and last byte each wildcard requires
+  ///     (if the wildcard starts or ends with a plain character) and its minimum
+  ///     length in a compact list, so most wildcards that can't match a string are
+  ///     ruled out without looking at its characters at all.
+  ///   </para>
+  /// </remarks>
+  class WildcardSet {
+
+    /// <summary>Index returned when none of the wildcards matched a string</summary>
+    public: NUCLEX_SUPPORT_API static const std::size_t NoMatch;
+
+    /// <summary>Initializes a new, empty wildcard set</summary>
+    /// <param name="caseSensitive">Whether strings will be matched case-sensitively</param>
+    public: NUCLEX_SUPPORT_API WildcardSet(bool caseSensitive = false);
+
+    /// <summary>Adds a wildcard to the set</summary>
+    /// <param name="wildcard">UTF-8 wildcard that will be added</param>
+    /// <returns>The index of the wildcard within the set</returns>
+    public: NUCLEX_SUPPORT_API std::size_t Add(const std::string &wildcard);
+
+    /// <summary>Counts the number of wildcards in the set</summary>
+    /// <returns>The number of wildcards that have been added to the set</returns>
+    public: std::size_t CountWildcards() const { return this->patterns.size(); }
+
+    /// <summary>Checks whether a string matches any of the wildcards in the set</summary>
+    /// <param name="text">Text that will be matched against the wildcards</param>
+    /// <returns>True if at least one of the wildcards matched the text</returns>
+    public: NUCLEX_SUPPORT_API bool MatchesAny(const std::string &text) const;
+
+    /// <summary>Looks for the first wildcard in the set that matches a string</summary>
+    /// <param name="text">Text that will be matched against the wildcards</param>
+    /// <returns>
+    ///   The index of the first wildcard that matched the text or
+    ///   <see cref="NoMatch" /> if none of the wildcards matched
+    /// </returns>
+    public: NUCLEX_SUPPORT_API std::size_t FindFirstMatch(const std::string &text) const;
+
+    /// <summary>Looks for all wildcards in the set that match a string</summary>
+    /// <param name="text">Text that will be matched against the wildcards</param>
+    /// <param name="matchIndices">
+    ///   Receives the indices of the wildcards that matched the text in ascending order,
+    ///   appended to anything that's already in the vector
+    /// </param>
+    /// <returns>The number of wildcards that matched the text</returns>
+    public: NUCLEX_SUPPORT_API std::size_t FindAllMatches(
+      const std::string &text, std::vector<std::size_t> &matchIndices
+    ) const;
+
+    /// <summary>Looks for the next wildcard that matches a string</summary>
+    /// <param name="text">Text that will be matched, already case-folded if needed</param>
+    /// <param name="length">Length of the text in bytes</param>
+    /// <param name="startIndex">Index of the wildcard the search begins at</param>
+    /// <returns>The index of the matching wildcard or NoMatch</returns>
+    private: std::size_t findNextMatch(
+      const char *text, std::size_t length, std::size_t startIndex
+    ) const;
+
+    /// <summary>Prepares a string for matching against the wildcards</summary>
+    /// <param name="text">Text that will be prepared</param>
+    /// <returns>The text, case-folded if the set isn't case sensitive</returns>
+    private: const std::string &prepare(const std::string &text) const;
+
+    #pragma region struct Filter
+
+    /// <summary>Quick checks that rule out wildcards that can't match a string</summary>
+    private: struct Filter {
+
+      /// <summary>Number of bytes a string needs for the wildcard to match it</summary>
+      public: std::size_t MinimumByteCount;
+      /// <summary>Byte the string has to start with or -1 if any byte is fine</summary>
+      public: int FirstByte;
+      /// <summary>Byte the string has to end with or -1 if any byte is fine</summary>
+      public: int LastByte;
+
+    };
+
+    #pragma endregion // struct Filter
+
+    /// <summary>Quick checks for each wildcard, in the same order as the wildcards</summary>
+    private: std::vector<Filter> filters;
+    /// <summary>Wildcards strings will be matched against</summary>
+    private: std::vector<WildcardPattern> patterns;
+    /// <summary>Whether strings will be matched case-sensitively</summary>
+    private: bool caseSensitive;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
+
+#endif // NUCLEX_SUPPORT_TEXT_WILDCARDSET_H
@@ -0,0 +1,972 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_THREADING_FUTURE_H
+#define NUCLEX_SUPPORT_THREADING_FUTURE_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Threading/ThreadPool.h"
+
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <cstddef> // for std::size_t
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::function
+#include <future> // for std::future_error
+#include <mutex> // for std::mutex
+#include <new> // for placement new
+#include <type_traits> // for std::aligned_storage, std::decay
+#include <utility> // for std::move(), std::forward(), std::declval()
+
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+#include <coroutine> // for std::coroutine_handle
+#endif
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TResult> class Future;
+  template<typename TResult> class Promise;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  namespace Private {
+
+    /// <summary>Gets notified when the result of a future becomes available</summary>
+    class FutureContinuation {
+
+      /// <summary>Frees all resources owned by the continuation</summary>
+      public: virtual ~FutureContinuation() = default;
+
+      /// <summary>Called once by the thread that provided the result</summary>
+      /// <remarks>Must not throw, there would be nobody to report the error to</remarks>
+      public: virtual void Resume() = 0;
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>Lets futures use the private methods of the thread pool</summary>
+    class ThreadPoolAccess {
+
+      /// <summary>Schedules a task that doesn't belong to any task group</summary>
+      /// <param name="threadPool">Thread pool that will run the task</param>
+      /// <param name="task">Task that will be scheduled, must not throw</param>
+      public: static void Post(ThreadPool &threadPool, std::function<void()> &&task) {
+        threadPool.post(std::move(task));
+      }
+
+      /// <summary>Processes tasks until the specified flag is set</summary>
+      /// <param name="threadPool">Thread pool whose tasks will be processed</param>
+      /// <param name="isDone">Flag that will be set when waiting should end</param>
+      public: static void HelpUntil(ThreadPool &threadPool, const std::atomic<bool> &isDone) {
+        threadPool.helpUntil(isDone);
+      }
+
+      /// <summary>Wakes up threads waiting for their flags to be set</summary>
+      /// <param name="threadPool">Thread pool in which threads are waiting</param>
+      public: static void WakeHelpers(ThreadPool &threadPool) {
+        threadPool.wakeHelpers();
+      }
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>Memory in which the result of a future is constructed</summary>
+    /// <typeparam name="TValue">Type of value that will be stored</typeparam>
+    template<typename TValue>
+    class FutureValue {
+
+      /// <summary>Initializes a new future value storage without a value</summary>
+      public: FutureValue() : hasValue(false) {}
+
+      /// <summary>Destroys the stored value, if any</summary>
+      public: ~FutureValue() {
+        if(this->hasValue) {
+          reinterpret_cast<TValue *>(&this->storage)->~TValue();
+        }
+      }
+
+      /// <summary>Constructs the value in place</summary>
+      /// <typeparam name="TArguments">Types of the arguments for the constructor</typeparam>
+      /// <param name="arguments">Arguments that will be passed to the constructor</param>
+      public: template<typename... TArguments>
+      void Emplace(TArguments &&... arguments) {
+        new(&this->storage) TValue(std::forward<TArguments>(arguments)...);
+        this->hasValue = true;
+      }
+
+      /// <summary>Moves the value out of the storage</summary>
+      /// <returns>The value that was stored</returns>
+      public: TValue Take() {
+        TValue *value = reinterpret_cast<TValue *>(&this->storage);
+        TValue result(std::move(*value));
+        value->~TValue();
+        this->hasValue = false;
+        return result;
+      }
+
+      /// <summary>Memory the value is constructed in</summary>
+      private: typename std::aligned_storage<sizeof(TValue), alignof(TValue)>::type storage;
+      /// <summary>Whether a value has been constructed in the memory</summary>
+      private: bool hasValue;
+
+    };
+
+    /// <summary>Stand-in for the result of futures that provide no value</summary>
+    template<>
+    class FutureValue<void> {
+
+      /// <summary>Does nothing, there is no value</summary>
+      public: void Emplace() {}
+
+      /// <summary>Does nothing, there is no value</summary>
+      public: void Take() {}
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>State shared between a future and whoever provides its result</summary>
+    /// <typeparam name="TResult">Type of result the future will provide</typeparam>
+    /// <remarks>
+    ///   <para>
+    ///     A single atomic pointer tracks everything a future needs: it is null while no
+    ///     result is there and nobody waits, points to the continuation while somebody
+    ///     waits and points to the state itself once the result is there. Providing the
+    ///     result thus costs one atomic exchange and neither locks a mutex nor allocates.
+    ///   </para>
+    ///   <para>
+    ///     The state is reference counted so the future and the provider of the result
+    ///     can go away in any order.
+    ///   </para>
+    /// </remarks>
+    template<typename TResult>
+    class FutureState {
+
+      /// <summary>Initializes a new future state without a result</summary>
+      /// <param name="referenceCount">Number of references the creator hands out</param>
+      public: explicit FutureState(std::size_t referenceCount) :
+        referenceCount(referenceCount),
+        continuation(nullptr) {}
+
+      /// <summary>Destroys the future state and the result, if any</summary>
+      public: virtual ~FutureState() = default;
+
+      /// <summary>Adds a reference to the state</summary>
+      public: void AddReference() {
+        this->referenceCount.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      /// <summary>Removes a reference from the state, destroying it if it was the last</summary>
+      public: void Release() {
+        if(this->referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          delete this;
+        }
+      }
+
+      /// <summary>Checks whether the result has been provided</summary>
+      /// <returns>True if the result has been provided</returns>
+      public: bool IsCompleted() const {
+        return (this->continuation.load(std::memory_order_acquire) == getCompletedMarker());
+      }
+
+      /// <summary>Provides the result and resumes the continuation, if any</summary>
+      /// <typeparam name="TArguments">Types of the arguments for the result</typeparam>
+      /// <param name="arguments">Arguments from which the result will be constructed</param>
+      public: template<typename... TArguments>
+      void SetValue(TArguments &&... arguments) {
+        this->value.Emplace(std::forward<TArguments>(arguments)...);
+        complete();
+      }
+
+      /// <summary>Provides an exception as the result and resumes the continuation</summary>
+      /// <param name="error">Exception that will be rethrown to the future's owner</param>
+      public: void SetException(const std::exception_ptr &error) {
+        this->error = error;
+        complete();
+      }
+
+      /// <summary>Lets a continuation wait for the result</summary>
+      /// <param name="waiting">Continuation that will be resumed</param>
+      /// <returns>
+      ///   True if the continuation will be resumed, false if the result was provided
+      ///   already and the continuation should proceed right away
+      /// </returns>
+      public: bool TryAddContinuation(FutureContinuation &waiting) {
+        FutureContinuation *expected = nullptr;
+        return this->continuation.compare_exchange_strong(
+          expected, &waiting, std::memory_order_acq_rel, std::memory_order_acquire
+        );
+      }
+
+      /// <summary>Retrieves the exception provided as the result, if any</summary>
+      /// <returns>The exception provided as the result or an empty exception pointer</returns>
+      public: const std::exception_ptr &GetException() const {
+        return this->error;
+      }
+
+      /// <summary>Moves the result out of the state or rethrows its exception</summary>
+      /// <returns>The result that was provided</returns>
+      public: TResult TakeResult() {
+        if(this->error) {
+          std::rethrow_exception(this->error);
+        }
+
+        return this->value.Take();
+      }
+
+      /// <summary>Marks the state as completed and resumes the continuation, if any</summary>
+      private: void complete() {
+        FutureContinuation *waiting = this->continuation.exchange(
+          getCompletedMarker(), std::memory_order_acq_rel
+        );
+        if(waiting != nullptr) {
+          waiting->Resume();
+        }
+      }
+
+      /// <summary>Returns the value the continuation pointer takes once completed</summary>
+      /// <returns>A pointer that can't be mistaken for a real continuation</returns>
+      private: FutureContinuation *getCompletedMarker() const {
+        return reinterpret_cast<FutureContinuation *>(const_cast<FutureState *>(this));
+      }
+
+      private: FutureState(const FutureState &) = delete;
+      private: FutureState &operator =(const FutureState &) = delete;
+
+      /// <summary>Number of futures, providers and continuations using the state</summary>
+      private: std::atomic<std::size_t> referenceCount;
+      /// <summary>Null, the waiting continuation or the completed marker</summary>
+      private: std::atomic<FutureContinuation *> continuation;
+      /// <summary>Exception that was provided as the result, if any</summary>
+      private: std::exception_ptr error;
+      /// <summary>Value that was provided as the result, if any</summary>
+      private: FutureValue<TResult> value;
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>Invokes a function and provides its return value as a future's result</summary>
+    /// <typeparam name="TResult">Type of result the function returns</typeparam>
+    template<typename TResult>
+    class FunctionCompleter {
+
+      /// <summary>Invokes a function and stores its return value in a future state</summary>
+      /// <typeparam name="TFunction">Type of function that will be invoked</typeparam>
+      /// <typeparam name="TArguments">Types of the arguments passed to the function</typeparam>
+      /// <param name="target">Future state that will receive the result</param>
+      /// <param name="function">Function that will be invoked</param>
+      /// <param name="arguments">Arguments that will be passed to the function</param>
+      public: template<typename TFunction, typename... TArguments>
+      static void Run(
+        FutureState<TResult> &target, TFunction &function, TArguments &&... arguments
+      ) {
+        target.SetValue(function(std::forward<TArguments>(arguments)...));
+      }
+
+    };
+
+    /// <summary>Invokes a function and completes a future that provides no value</summary>
+    template<>
+    class FunctionCompleter<void> {
+
+      /// <summary>Invokes a function and completes a future state</summary>
+      /// <typeparam name="TFunction">Type of function that will be invoked</typeparam>
+      /// <typeparam name="TArguments">Types of the arguments passed to the function</typeparam>
+      /// <param name="target">Future state that will be completed</param>
+      /// <param name="function">Function that will be invoked</param>
+      /// <param name="arguments">Arguments that will be passed to the function</param>
+      public: template<typename TFunction, typename... TArguments>
+      static void Run(
+        FutureState<void> &target, TFunction &function, TArguments &&... arguments
+      ) {
+        function(std::forward<TArguments>(arguments)...);
+        target.SetValue();
+      }
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>Passes the result of one future to a continuation</summary>
+    /// <typeparam name="TPrevious">Type of result the first future provides</typeparam>
+    template<typename TPrevious>
+    class ContinuationInvoker {
+
+      /// <summary>Determines the type a continuation returns</summary>
+      /// <typeparam name="TFunction">Continuation that will be invoked</typeparam>
+      public: template<typename TFunction>
+      using ResultType = typename std::decay<
+        decltype(std::declval<TFunction &>()(std::declval<TPrevious>()))
+      >::type;
+
+      /// <summary>Invokes a continuation with the result of the first future</summary>
+      /// <typeparam name="TResult">Type of result the continuation provides</typeparam>
+      /// <typeparam name="TFunction">Continuation that will be invoked</typeparam>
+      /// <param name="target">Future state that will receive the continuation's result</param>
+      /// <param name="function">Continuation that will be invoked</param>
+      /// <param name="source">Completed state of the first future</param>
+      public: template<typename TResult, typename TFunction>
+      static void Run(
+        FutureState<TResult> &target, TFunction &function, FutureState<TPrevious> &source
+      ) {
+        FunctionCompleter<TResult>::Run(target, function, source.TakeResult());
+      }
+
+    };
+
+    /// <summary>Invokes continuations of futures that provide no value</summary>
+    template<>
+    class ContinuationInvoker<void> {
+
+      /// <summary>Determines the type a continuation returns</summary>
+      /// <typeparam name="TFunction">Continuation that will be invoked</typeparam>
+      public: template<typename TFunction>
+      using ResultType = typename std::decay<decltype(std::declval<TFunction &>()())>::type;
+
+      /// <summary>Invokes a continuation after the first future has completed</summary>
+      /// <typeparam name="TResult">Type of result the continuation provides</typeparam>
+      /// <typeparam name="TFunction">Continuation that will be invoked</typeparam>
+      /// <param name="target">Future state that will receive the continuation's result</param>
+      /// <param name="function">Continuation that will be invoked</param>
+      /// <param name="source">Completed state of the first future</param>
+      public: template<typename TResult, typename TFunction>
+      static void Run(FutureState<TResult> &target, TFunction &function, FutureState<void> &) {
+        FunctionCompleter<TResult>::Run(target, function);
+      }
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>Future state that is completed by a continuation of another future</summary>
+    /// <typeparam name="TResult">Type of result the continuation provides</typeparam>
+    /// <typeparam name="TPrevious">Type of result the first future provides</typeparam>
+    /// <typeparam name="TFunction">Continuation that will be invoked</typeparam>
+    /// <remarks>
+    ///   The continuation is stored in the same allocation as the future state and
+    ///   waits on the first future's state, so chaining needs one allocation per link.
+    /// </remarks>
+    template<typename TResult, typename TPrevious, typename TFunction>
+    class ContinuationState : public FutureState<TResult>, public FutureContinuation {
+
+      /// <summary>Initializes a new continuation state</summary>
+      /// <param name="previous">State of the first future, whose reference is taken over</param>
+      /// <param name="threadPool">Thread pool the continuation will run on or null</param>
+      /// <param name="function">Continuation that will be invoked</param>
+      public: template<typename TForwardedFunction>
+      ContinuationState(
+        FutureState<TPrevious> *previous, ThreadPool *threadPool, TForwardedFunction &&function
+      ) :
+        FutureState<TResult>(2), // One for the new future, one until the continuation ran
+        previous(previous),
+        threadPool(threadPool),
+        function(std::forward<TForwardedFunction>(function)) {}
+
+      /// <summary>Releases the first future's state if the continuation never ran</summary>
+      public: ~ContinuationState() override {
+        if(this->previous != nullptr) {
+          this->previous->Release();
+        }
+      }
+
+      /// <summary>Runs the continuation or schedules it on the thread pool</summary>
+      public: void Resume() override {
+        if(this->threadPool != nullptr) {
+          try {
+            ThreadPoolAccess::Post(*this->threadPool, [this]() { run(); });
+            return;
+          }
+          catch(...) {
+            // If the task could not be queued, run the continuation right here
+          }
+        }
+
+        run();
+      }
+
+      /// <summary>Invokes the continuation and provides its result</summary>
+      private: void run() {
+        FutureState<TPrevious> *source = this->previous;
+        this->previous = nullptr;
+
+        if(source->GetException()) {
+          this->SetException(source->GetException());
+        } else {
+          try {
+            ContinuationInvoker<TPrevious>::Run(*this, this->function, *source);
+          }
+          catch(...) {
+            this->SetException(std::current_exception());
+          }
+        }
+
+        source->Release();
+        this->Release();
+      }
+
+      /// <summary>State of the future whose result the continuation receives</summary>
+      private: FutureState<TPrevious> *previous;
+      /// <summary>Thread pool the continuation will be run on, if any</summary>
+      private: ThreadPool *threadPool;
+      /// <summary>Continuation that will be invoked with the first future's result</summary>
+      private: TFunction function;
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>Invokes a callback with a future once the future has completed</summary>
+    /// <typeparam name="TResult">Type of result the future provides</typeparam>
+    /// <typeparam name="TCallback">Callback that will be invoked</typeparam>
+    template<typename TResult, typename TCallback>
+    class CallbackContinuation : public FutureContinuation {
+
+      /// <summary>Initializes a new callback continuation</summary>
+      /// <param name="state">State of the future, whose reference is taken over</param>
+      /// <param name="callback">Callback that will be invoked</param>
+      public: template<typename TForwardedCallback>
+      CallbackContinuation(FutureState<TResult> *state, TForwardedCallback &&callback) :
+        state(state),
+        callback(std::forward<TForwardedCallback>(callback)) {}
+
+      /// <summary>Invokes the callback with the completed future</summary>
+      public: void Resume() override {
+        Future<TResult> completed(this->state);
+        try {
+          this->callback(std::move(completed));
+        }
+        catch(...) {
+          // Nobody is there to receive the error, the callback was told not to throw
+        }
+        delete this;
+      }
+
+      /// <summary>State of the future that will be handed to the callback</summary>
+      private: FutureState<TResult> *state;
+      /// <summary>Callback that will be invoked with the completed future</summary>
+      private: TCallback callback;
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>Blocks a thread until a future has completed</summary>
+    class BlockingWaiter : public FutureContinuation {
+
+      /// <summary>Initializes a new blocking waiter</summary>
+      public: BlockingWaiter() : isCompleted(false) {}
+
+      /// <summary>Wakes up the waiting thread</summary>
+      public: void Resume() override {
+        std::unique_lock<std::mutex> completionLock(this->mutex);
+        this->isCompleted = true;
+        this->completed.notify_all();
+      }
+
+      /// <summary>Blocks the calling thread until the future has completed</summary>
+      public: void Wait() {
+        std::unique_lock<std::mutex> completionLock(this->mutex);
+        this->completed.wait(completionLock, [this]() { return this->isCompleted; });
+      }
+
+      /// <summary>Must be held while accessing the completion flag</summary>
+      private: std::mutex mutex;
+      /// <summary>Signalled when the future has completed</summary>
+      private: std::condition_variable completed;
+      /// <summary>Whether the future has completed</summary>
+      private: bool isCompleted;
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+    /// <summary>Processes tasks of a thread pool until a future has completed</summary>
+    class HelpingWaiter : public FutureContinuation {
+
+      /// <summary>Initializes a new helping waiter</summary>
+      /// <param name="threadPool">Thread pool whose tasks will be processed</param>
+      public: explicit HelpingWaiter(ThreadPool &threadPool) :
+        threadPool(threadPool),
+        isCompleted(false) {}
+
+      /// <summary>Lets the waiting thread return</summary>
+      /// <remarks>
+      ///   The waiting thread may return and destroy the waiter as soon as the flag
+      ///   is set, so the thread pool is looked up before.
+      /// </remarks>
+      public: void Resume() override {
+        ThreadPool &waitingPool = this->threadPool;
+        this->isCompleted.store(true, std::memory_order_release);
+        ThreadPoolAccess::WakeHelpers(waitingPool);
+      }
+
+      /// <summary>Processes tasks until the future has completed</summary>
+      public: void Wait() {
+        ThreadPoolAccess::HelpUntil(this->threadPool, this->isCompleted);
+      }
+
+      /// <summary>Thread pool whose tasks are processed while waiting</summary>
+      private: ThreadPool &threadPool;
+      /// <summary>Whether the future has completed</summary>
+      private: std::atomic<bool> isCompleted;
+
+    };
+
+    // ----------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+    /// <summary>Suspends a coroutine until a future has completed</summary>
+    /// <typeparam name="TResult">Type of result the future provides</typeparam>
+    template<typename TResult>
+    class FutureAwaiter : public FutureContinuation {
+
+      /// <summary>Initializes a new future awaiter</summary>
+      /// <param name="future">Future that will be awaited</param>
+      public: explicit FutureAwaiter(Future<TResult> &&future) :
+        future(std::move(future)) {}
+
+      /// <summary>Checks whether the coroutine can continue without suspending</summary>
+      /// <returns>True if the future has already completed</returns>
+      public: bool await_ready() const {
+        return this->future.IsReady();
+      }
+
+      /// <summary>Resumes the coroutine once the future has completed</summary>
+      /// <param name="coroutine">Coroutine that has been suspended</param>
+      /// <returns>False if the future completed in the meantime</returns>
+      public: bool await_suspend(std::coroutine_handle<> coroutine) {
+        this->coroutine = coroutine;
+        return this->future.state->TryAddContinuation(*this);
+      }
+
+      /// <summary>Provides the future's result to the coroutine</summary>
+      /// <returns>The result of the future</returns>
+      public: TResult await_resume() {
+        return this->future.Get();
+      }
+
+      /// <summary>Resumes the suspended coroutine</summary>
+      public: void Resume() override {
+        this->coroutine.resume();
+      }
+
+      /// <summary>Future whose result is awaited</summary>
+      private: Future<TResult> future;
+      /// <summary>Coroutine that is waiting for the future</summary>
+      private: std::coroutine_handle<> coroutine;
+
+    };
+#endif // defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+
+  } // namespace Private
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Result that will be provided at some point in the future</summary>
+  /// <typeparam name="TResult">Type of result that will be provided</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     Works much like std::future, but providing the result costs a single atomic
+  ///     exchange instead of a mutex, and chained continuations are stored together
+  ///     with the future they complete, so each link in a chain is one allocation.
+  ///   </para>
+  ///   <para>
+  ///     A future has a single consumer. Its result can be taken once with
+  ///     <see cref="Get" /> or passed on to one continuation with <see cref="Then" />,
+  ///     <see cref="OnCompleted" /> or co_await, after which the future is empty.
+  ///   </para>
+  ///   <para>
+  ///     Continuations registered without a thread pool run on whichever thread provides
+  ///     the result (or right away if the result is there already), so they should be
+  ///     short. Longer work should be continued on a thread pool.
+  ///   </para>
+  /// </remarks>
+  template<typename TResult>
+  class Future {
+
+    /// <summary>Initializes a new future without any state</summary>
+    public: Future() : state(nullptr) {}
+
+    /// <summary>Takes over the state of another future</summary>
+    /// <param name="other">Future whose state will be taken over</param>
+    public: Future(Future &&other) noexcept :
+      state(other.state) {
+      other.state = nullptr;
+    }
+
+    /// <summary>Releases the future's state</summary>
+    /// <remarks>
+    ///   Does not wait for the result. Whoever provides it can still do so and
+    ///   the result will be discarded.
+    /// </remarks>
+    public: ~Future() {
+      if(this->state != nullptr) {
+        this->state->Release();
+      }
+    }
+
+    /// <summary>Releases the current state and takes over that of another future</summary>
+    /// <param name="other">Future whose state will be taken over</param>
+    /// <returns>This future</returns>
+    public: Future &operator =(Future &&other) noexcept {
+      if(this != &other) {
+        if(this->state != nullptr) {
+          this->state->Release();
+        }
+        this->state = other.state;
+        other.state = nullptr;
+      }
+      return *this;
+    }
+
+    /// <summary>Checks whether the future will provide a result</summary>
+    /// <returns>False if the future is empty or its result was passed on</returns>
+    public: bool IsValid() const {
+      return (this->state != nullptr);
+    }
+
+    /// <summary>Checks whether the result has been provided</summary>
+    /// <returns>True if the result can be obtained without waiting</returns>
+    public: bool IsReady() const {
+      requireState();
+      return this->state->IsCompleted();
+    }
+
+    /// <summary>Blocks the calling thread until the result has been provided</summary>
+    /// <remarks>
+    ///   Threads of a thread pool should wait through the other overload, otherwise
+    ///   they might block the thread that would have provided the result.
+    /// </remarks>
+    public: void Wait() const {
+      requireState();
+      if(!this->state->IsCompleted()) {
+        Private::BlockingWaiter waiter;
+        if(this->state->TryAddContinuation(waiter)) {
+          waiter.Wait();
+        }
+      }
+    }
+
+    /// <summary>Processes tasks of a thread pool until the result has been provided</summary>
+    /// <param name="threadPool">Thread pool whose tasks will be processed</param>
+    public: void Wait(ThreadPool &threadPool) const {
+      requireState();
+      if(!this->state->IsCompleted()) {
+        Private::HelpingWaiter waiter(threadPool);
+        if(this->state->TryAddContinuation(waiter)) {
+          waiter.Wait();
+        }
+      }
+    }
+
+    /// <summary>Waits for the result and takes it out of the future</summary>
+    /// <returns>The result that was provided</returns>
+    /// <remarks>
+    ///   If an exception was provided instead of a result, it is rethrown.
+    ///   The future is empty afterwards.
+    /// </remarks>
+    public: TResult Get() {
+      Wait();
+
+      Private::FutureState<TResult> *completed = this->state;
+      this->state = nullptr;
+      ReleaseScope releaser(*completed);
+      return completed->TakeResult();
+    }
+
+    /// <summary>Invokes a continuation with the result once it has been provided</summary>
+    /// <typeparam name="TContinuation">Callable object that will be invoked</typeparam>
+    /// <param name="continuation">
+    ///   Continuation that will receive the result (or nothing for futures without
+    ///   a value). It runs on the thread providing the result.
+    /// </param>
+    /// <returns>A future that provides the continuation's result</returns>
+    /// <remarks>
+    ///   If an exception is provided instead of a result, the continuation is skipped
+    ///   and the exception goes to the returned future. The future is empty afterwards.
+    /// </remarks>
+    public: template<typename TContinuation>
+    Future<
+      typename Private::ContinuationInvoker<TResult>::template ResultType<
+        typename std::decay<TContinuation>::type
+      >
+    > Then(TContinuation &&continuation) {
+      return then(nullptr, std::forward<TContinuation>(continuation));
+    }
+
+    /// <summary>Runs a continuation on a thread pool once the result is provided</summary>
+    /// <typeparam name="TContinuation">Callable object that will be invoked</typeparam>
+    /// <param name="threadPool">Thread pool the continuation will run on</param>
+    /// <param name="continuation">
+    ///   Continuation that will receive the result (or nothing for futures without
+    ///   a value)
+    /// </param>
+    /// <returns>A future that provides the continuation's result</returns>
+    /// <remarks>
+    ///   If an exception is provided instead of a result, the continuation is skipped
+    ///   and the exception goes to the returned future. The future is empty afterwards.
+    /// </remarks>
+    public: template<typename TContinuation>
+    Future<
+      typename Private::ContinuationInvoker<TResult>::template ResultType<
+        typename std::decay<TContinuation>::type
+      >
+    > Then(ThreadPool &threadPool, TContinuation &&continuation) {
+      return then(&threadPool, std::forward<TContinuation>(continuation));
+    }
+
+    /// <summary>Invokes a callback with the completed future</summary>
+    /// <typeparam name="TCallback">Callable object that will be invoked</typeparam>
+    /// <param name="callback">
+    ///   Callback that will receive the completed future. It runs on the thread
+    ///   providing the result and should not throw.
+    /// </param>
+    /// <remarks>
+    ///   For code that can't use coroutines. The future is empty afterwards.
+    /// </remarks>
+    public: template<typename TCallback>
+    void OnCompleted(TCallback &&callback) {
+      requireState();
+
+      typedef Private::CallbackContinuation<
+        TResult, typename std::decay<TCallback>::type
+      > ContinuationType;
+      ContinuationType *waiting = new ContinuationType(
+        this->state, std::forward<TCallback>(callback)
+      );
+
+      Private::FutureState<TResult> *waitedFor = this->state;
+      this->state = nullptr;
+      if(!waitedFor->TryAddContinuation(*waiting)) {
+        waiting->Resume();
+      }
+    }
+
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+    /// <summary>Suspends the calling coroutine until the result is provided</summary>
+    /// <returns>An awaiter that provides the result to the coroutine</returns>
+    /// <remarks>
+    ///   The coroutine is resumed on the thread providing the result.
+    ///   The future is empty afterwards.
+    /// </remarks>
+    public: Private::FutureAwaiter<TResult> operator co_await() {
+      requireState();
+      return Private::FutureAwaiter<TResult>(std::move(*this));
+    }
+#endif
+
+    /// <summary>Initializes a new future using the specified state</summary>
+    /// <param name="state">State whose reference the future will take over</param>
+    private: explicit Future(Private::FutureState<TResult> *state) :
+      state(state) {}
+
+    /// <summary>Throws an exception if the future has no state</summary>
+    private: void requireState() const {
+      if(this->state == nullptr) {
+        throw std::future_error(std::future_errc::no_state);
+      }
+    }
+
+    /// <summary>Registers a continuation that completes a new future</summary>
+    /// <param name="threadPool">Thread pool the continuation will run on or null</param>
+    /// <param name="continuation">Continuation that will receive the result</param>
+    /// <returns>A future that provides the continuation's result</returns>
+    private: template<typename TContinuation>
+    Future<
+      typename Private::ContinuationInvoker<TResult>::template ResultType<
+        typename std::decay<TContinuation>::type
+      >
+    > then(ThreadPool *threadPool, TContinuation &&continuation) {
+      typedef typename std::decay<TContinuation>::type FunctionType;
+      typedef typename Private::ContinuationInvoker<TResult>::template ResultType<
+        FunctionType
+      > NextResultType;
+      typedef Private::ContinuationState<NextResultType, TResult, FunctionType> StateType;
+
+      requireState();
+      StateType *next = new StateType(
+        this->state, threadPool, std::forward<TContinuation>(continuation)
+      );
+
+      Private::FutureState<TResult> *previous = this->state;
+      this->state = nullptr;
+      if(!previous->TryAddContinuation(*next)) {
+        next->Resume();
+      }
+
+      return Future<NextResultType>(next);
+    }
+
+    /// <summary>Releases a future state when the scope is left</summary>
+    private: class ReleaseScope {
+
+      /// <summary>Initializes a new release scope</summary>
+      /// <param name="state">State that will be released</param>
+      public: explicit ReleaseScope(Private::FutureState<TResult> &state) :
+        state(state) {}
+
+      /// <summary>Releases the state</summary>
+      public: ~ReleaseScope() {
+        this->state.Release();
+      }
+
+      /// <summary>State that will be released</summary>
+      private: Private::FutureState<TResult> &state;
+
+    };
+
+    private: Future(const Future &) = delete;
+    private: Future &operator =(const Future &) = delete;
+
+    template<typename TOtherResult> friend class Future;
+    template<typename TOtherResult> friend class Promise;
+    template<typename TOtherResult> friend class Task;
+    template<typename TOtherResult, typename TCallback>
+    friend class Private::CallbackContinuation;
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+    template<typename TOtherResult> friend class Private::FutureAwaiter;
+#endif
+
+    /// <summary>State shared with whoever provides the result</summary>
+    private: Private::FutureState<TResult> *state;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Provides the result of a future</summary>
+  /// <typeparam name="TResult">Type of result that will be provided</typeparam>
+  /// <remarks>
+  ///   Meant for asynchronous operations that complete through a callback, such as
+  ///   I/O completion. If the promise is destroyed without providing a result,
+  ///   the future receives a std::future_error with the broken promise error code.
+  /// </remarks>
+  template<typename TResult>
+  class Promise {
+
+    /// <summary>Initializes a new promise</summary>
+    public: Promise() :
+      state(new Private::FutureState<TResult>(1)),
+      isFutureRetrieved(false),
+      isSatisfied(false) {}
+
+    /// <summary>Takes over the state of another promise</summary>
+    /// <param name="other">Promise whose state will be taken over</param>
+    public: Promise(Promise &&other) noexcept :
+      state(other.state),
+      isFutureRetrieved(other.isFutureRetrieved),
+      isSatisfied(other.isSatisfied) {
+      other.state = nullptr;
+    }
+
+    /// <summary>Breaks the promise if no result was provided and releases the state</summary>
+    public: ~Promise() {
+      if(this->state != nullptr) {
+        if(!this->isSatisfied) {
+          this->state->SetException(
+            std::make_exception_ptr(std::future_error(std::future_errc::broken_promise))
+          );
+        }
+        this->state->Release();
+      }
+    }
+
+    /// <summary>Returns the future that will receive the result</summary>
+    /// <returns>The future receiving the result</returns>
+    /// <remarks>Can only be called once</remarks>
+    public: Future<TResult> GetFuture() {
+      requireState();
+      if(this->isFutureRetrieved) {
+        throw std::future_error(std::future_errc::future_already_retrieved);
+      }
+
+      this->state->AddReference();
+      this->isFutureRetrieved = true;
+      return Future<TResult>(this->state);
+    }
+
+    /// <summary>Provides the result to the future</summary>
+    /// <typeparam name="TArguments">Types of the arguments for the result</typeparam>
+    /// <param name="arguments">Arguments from which the result will be constructed</param>
+    /// <remarks>
+    ///   Continuations waiting for the result run before this method returns
+    /// </remarks>
+    public: template<typename... TArguments>
+    void SetValue(TArguments &&... arguments) {
+      requireUnsatisfied();
+
+      // A continuation might destroy the promise, so it isn't touched once the result
+      // has been provided. If constructing the result fails, nothing has been provided.
+      this->isSatisfied = true;
+      try {
+        this->state->SetValue(std::forward<TArguments>(arguments)...);
+      }
+      catch(...) {
+        this->isSatisfied = false;
+        throw;
+      }
+    }
+
+    /// <summary>Provides an exception to the future in place of the result</summary>
+    /// <param name="error">Exception that will be rethrown to the future's owner</param>
+    public: void SetException(const std::exception_ptr &error) {
+      requireUnsatisfied();
+
+      this->isSatisfied = true;
+      this->state->SetException(error);
+    }
+
+    /// <summary>Throws an exception if the promise has no state</summary>
+    private: void requireState() const {
+      if(this->state == nullptr) {
+        throw std::future_error(std::future_errc::no_state);
+      }
+    }
+
+    /// <summary>Throws an exception if the promise can't provide a result anymore</summary>
+    private: void requireUnsatisfied() const {
+      requireState();
+      if(this->isSatisfied) {
+        throw std::future_error(std::future_errc::promise_already_satisfied);
+      }
+    }
+
+    private: Promise(const Promise &) = delete;
+    private: Promise &operator =(const Promise &) = delete;
+
+    /// <summary>State shared with the future</summary>
+    private: Private::FutureState<TResult> *state;
+    /// <summary>Whether the future has been handed out already</summary>
+    private: bool isFutureRetrieved;
+    /// <summary>Whether a result has been provided already</summary>
+    private: bool isSatisfied;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
+
+#endif // NUCLEX_SUPPORT_THREADING_FUTURE_H
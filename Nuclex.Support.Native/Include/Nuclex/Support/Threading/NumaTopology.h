@@ -0,0 +1,105 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_THREADING_NUMATOPOLOGY_H
+#define NUCLEX_SUPPORT_THREADING_NUMATOPOLOGY_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <cstddef> // for std::size_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>CPU cores that share the same local memory</summary>
+  struct NumaNode {
+
+    /// <summary>Number the operating system uses to identify the node</summary>
+    public: std::size_t Id;
+    /// <summary>Indices of the CPU cores that belong to the node</summary>
+    public: std::vector<std::size_t> Cores;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Arrangement of CPU cores into NUMA nodes on the system</summary>
+  /// <remarks>
+  ///   <para>
+  ///     On systems with multiple CPU sockets, each socket has its own memory. Cores can
+  ///     access the memory of other sockets, too, but at a higher latency and through
+  ///     a link of limited bandwidth that all cores share. Each group of cores with its
+  ///     own memory is a NUMA node.
+  ///   </para>
+  ///   <para>
+  ///     The topology is examined only once, when <see cref="Get" /> is called the first
+  ///     time. Only nodes that have CPU cores are listed. Systems that don't report their
+  ///     topology are described as a single node holding all cores.
+  ///   </para>
+  /// </remarks>
+  struct NumaTopology {
+
+    /// <summary>Retrieves the NUMA topology of the system the program is running on</summary>
+    /// <returns>The NUMA topology of the system</returns>
+    /// <remarks>Can be called from multiple threads, the result is cached</remarks>
+    public: NUCLEX_SUPPORT_API static const NumaTopology &Get();
+
+    /// <summary>Counts the NUMA nodes that have CPU cores</summary>
+    /// <returns>The number of NUMA nodes, at least one</returns>
+    public: std::size_t CountNodes() const {
+      return this->Nodes.size();
+    }
+
+    /// <summary>Looks up which node a CPU core belongs to</summary>
+    /// <param name="coreIndex">Index of the CPU core that will be looked up</param>
+    /// <returns>The index of the core's node in the node list, 0 if unknown</returns>
+    public: NUCLEX_SUPPORT_API std::size_t GetNodeIndexOfCore(std::size_t coreIndex) const;
+
+    /// <summary>Looks up which node the calling thread is currently running on</summary>
+    /// <returns>The index of the node in the node list, 0 if unknown</returns>
+    /// <remarks>
+    ///   Unless the thread is pinned to a node, the operating system may move it
+    ///   to another node at any time, so this is only a hint.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API std::size_t GetCurrentNodeIndex() const;
+
+    /// <summary>Binds the calling thread to the specified CPU cores</summary>
+    /// <param name="coreIndices">Indices of the CPU cores the thread may run on</param>
+    /// <remarks>
+    ///   Pinning is only a performance hint, so if the system refuses, the thread
+    ///   simply keeps running wherever the scheduler puts it. Passing the cores of
+    ///   one node from <see cref="Nodes" /> keeps the thread on that node.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API static void PinCallingThreadToCores(
+      const std::vector<std::size_t> &coreIndices
+    );
+
+    /// <summary>NUMA nodes in the order of their ids</summary>
+    public: std::vector<NumaNode> Nodes;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
+
+#endif // NUCLEX_SUPPORT_THREADING_NUMATOPOLOGY_H
@@ -0,0 +1,206 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_THREADING_TASK_H
+#define NUCLEX_SUPPORT_THREADING_TASK_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Threading/ThreadPool.h"
+#include "Nuclex/Support/Threading/Future.h"
+
+#include <exception> // for std::current_exception()
+#include <type_traits> // for std::decay
+#include <utility> // for std::move(), std::forward()
+
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+#include <coroutine> // for std::suspend_never
+#endif
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  namespace Private {
+
+    /// <summary>Future state completed by a function running on a thread pool</summary>
+    /// <typeparam name="TResult">Type of result the function returns</typeparam>
+    /// <typeparam name="TFunction">Function that will be run</typeparam>
+    template<typename TResult, typename TFunction>
+    class ScheduledState : public FutureState<TResult> {
+
+      /// <summary>Initializes a new scheduled state</summary>
+      /// <param name="function">Function that will be run</param>
+      public: template<typename TForwardedFunction>
+      explicit ScheduledState(TForwardedFunction &&function) :
+        FutureState<TResult>(2), // One for the task, one until the function ran
+        function(std::forward<TForwardedFunction>(function)) {}
+
+      /// <summary>Runs the function and provides its result</summary>
+      public: void Run() {
+        try {
+          FunctionCompleter<TResult>::Run(*this, this->function);
+        }
+        catch(...) {
+          this->SetException(std::current_exception());
+        }
+
+        this->Release();
+      }
+
+      /// <summary>Function that will be run on the thread pool</summary>
+      private: TFunction function;
+
+    };
+
+  } // namespace Private
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Future for work running on a thread pool or in a coroutine</summary>
+  /// <typeparam name="TResult">Type of result the work will provide</typeparam>
+  /// <remarks>
+  ///   <para>
+  ///     <see cref="ThreadPool.Schedule" /> returns tasks for functions running on
+  ///     the thread pool. Asynchronous methods return tasks so callers can wait for them,
+  ///     chain continuations with <see cref="Future.Then" /> or pass a callback to
+  ///     <see cref="Future.OnCompleted" />.
+  ///   </para>
+  ///   <para>
+  ///     With C++20 coroutines, functions returning a task can use co_await and
+  ///     co_return. The coroutine starts running right away on the calling thread and
+  ///     continues on whichever thread completes what it awaits.
+  ///   </para>
+  /// </remarks>
+  template<typename TResult>
+  class Task : public Future<TResult> {
+
+    /// <summary>Initializes a new task without any state</summary>
+    public: Task() = default;
+
+    /// <summary>Initializes a new task that provides the result of a future</summary>
+    /// <param name="future">Future whose state the task will take over</param>
+    public: Task(Future<TResult> &&future) noexcept :
+      Future<TResult>(std::move(future)) {}
+
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+    /// <summary>Lets functions returning a task be coroutines</summary>
+    public: class promise_type;
+#endif
+
+    /// <summary>Runs a function on a thread pool</summary>
+    /// <typeparam name="TFunction">Function that will be run</typeparam>
+    /// <param name="threadPool">Thread pool that will run the function</param>
+    /// <param name="function">Function that will be run</param>
+    /// <returns>A task that provides the function's result</returns>
+    private: template<typename TFunction>
+    static Task schedule(ThreadPool &threadPool, TFunction &&function) {
+      typedef Private::ScheduledState<
+        TResult, typename std::decay<TFunction>::type
+      > StateType;
+
+      StateType *state = new StateType(std::forward<TFunction>(function));
+      try {
+        Private::ThreadPoolAccess::Post(threadPool, [state]() { state->Run(); });
+      }
+      catch(...) {
+        delete state;
+        throw;
+      }
+
+      return Task(Future<TResult>(state));
+    }
+
+    /// <summary>The thread pool schedules functions through the private method</summary>
+    friend class ThreadPool;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+  namespace Private {
+
+    /// <summary>Provides the result of a coroutine to the task it returned</summary>
+    /// <typeparam name="TResult">Type of result the coroutine provides</typeparam>
+    template<typename TResult>
+    class TaskPromiseBase {
+
+      /// <summary>Creates the task the coroutine returns to its caller</summary>
+      /// <returns>The task that will provide the coroutine's result</returns>
+      public: Task<TResult> get_return_object() {
+        return Task<TResult>(this->promise.GetFuture());
+      }
+
+      /// <summary>Lets the coroutine start running right away</summary>
+      /// <returns>An awaitable that doesn't suspend</returns>
+      public: std::suspend_never initial_suspend() noexcept { return {}; }
+
+      /// <summary>Lets the coroutine's frame be destroyed once it has finished</summary>
+      /// <returns>An awaitable that doesn't suspend</returns>
+      public: std::suspend_never final_suspend() noexcept { return {}; }
+
+      /// <summary>Provides an exception that escaped the coroutine to the task</summary>
+      public: void unhandled_exception() {
+        this->promise.SetException(std::current_exception());
+      }
+
+      /// <summary>Promise through which the task receives the result</summary>
+      protected: Promise<TResult> promise;
+
+    };
+
+    /// <summary>Provides the value a coroutine returns to its task</summary>
+    /// <typeparam name="TResult">Type of result the coroutine provides</typeparam>
+    template<typename TResult>
+    class TaskPromise : public TaskPromiseBase<TResult> {
+
+      /// <summary>Provides the value passed to co_return to the task</summary>
+      /// <param name="value">Value the coroutine has returned</param>
+      public: template<typename TValue>
+      void return_value(TValue &&value) {
+        this->promise.SetValue(std::forward<TValue>(value));
+      }
+
+    };
+
+    /// <summary>Completes the task of a coroutine that returns no value</summary>
+    template<>
+    class TaskPromise<void> : public TaskPromiseBase<void> {
+
+      /// <summary>Completes the task when the coroutine has finished</summary>
+      public: void return_void() {
+        this->promise.SetValue();
+      }
+
+    };
+
+  } // namespace Private
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TResult>
+  class Task<TResult>::promise_type : public Private::TaskPromise<TResult> {};
+#endif // defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
+
+#endif // NUCLEX_SUPPORT_THREADING_TASK_H
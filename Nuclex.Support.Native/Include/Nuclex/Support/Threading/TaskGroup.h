@@ -0,0 +1,95 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_THREADING_TASKGROUP_H
+#define NUCLEX_SUPPORT_THREADING_TASKGROUP_H
+
+#include "Nuclex/Support/Config.h"
+#include "Nuclex/Support/Threading/ThreadPool.h"
+
+#include <atomic> // for std::atomic
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::function
+#include <mutex> // for std::mutex
+#include <utility> // for std::forward()
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of tasks running on a thread pool that can be waited for together</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Tasks are added to the group with <see cref="Run" /> and start right away.
+  ///     <see cref="Wait" /> processes tasks from the thread pool until all tasks in
+  ///     the group have finished and then rethrows the first exception any of them threw.
+  ///     Tasks may add more tasks to their own group or create task groups of their own.
+  ///   </para>
+  ///   <para>
+  ///     The destructor waits for outstanding tasks, but drops any exception they threw,
+  ///     so a task group should always be waited on explicitly.
+  ///   </para>
+  /// </remarks>
+  class TaskGroup {
+
+    /// <summary>Initializes a new task group scheduling tasks on a thread pool</summary>
+    /// <param name="threadPool">Thread pool that will run the tasks</param>
+    public: NUCLEX_SUPPORT_API explicit TaskGroup(ThreadPool &threadPool);
+
+    /// <summary>Waits for all outstanding tasks and destroys the task group</summary>
+    public: NUCLEX_SUPPORT_API ~TaskGroup();
+
+    /// <summary>Schedules a task that will run as part of the group</summary>
+    /// <typeparam name="TTask">Callable object that will be run</typeparam>
+    /// <param name="task">Task that will be run on the thread pool</param>
+    public: template<typename TTask>
+    void Run(TTask &&task) {
+      this->threadPool.schedule(*this, std::function<void()>(std::forward<TTask>(task)));
+    }
+
+    /// <summary>Waits until all tasks in the group have finished</summary>
+    /// <remarks>
+    ///   The calling thread processes tasks while it waits. If any task in the group
+    ///   threw an exception, the first such exception is rethrown.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API void Wait();
+
+    private: TaskGroup(const TaskGroup &) = delete;
+    private: TaskGroup &operator =(const TaskGroup &) = delete;
+
+    /// <summary>The thread pool updates the counters and records errors</summary>
+    friend class ThreadPool;
+
+    /// <summary>Thread pool the group's tasks are running on</summary>
+    private: ThreadPool &threadPool;
+    /// <summary>Number of tasks that have been scheduled but not finished yet</summary>
+    private: std::atomic<std::size_t> unfinishedTaskCount;
+    /// <summary>Must be held while accessing the recorded error</summary>
+    private: std::mutex errorMutex;
+    /// <summary>First exception thrown by any of the group's tasks</summary>
+    private: std::exception_ptr error;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
+
+#endif // NUCLEX_SUPPORT_THREADING_TASKGROUP_H
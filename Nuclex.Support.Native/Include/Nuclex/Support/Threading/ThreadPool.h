@@ -0,0 +1,229 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+#ifndef NUCLEX_SUPPORT_THREADING_THREADPOOL_H
+#define NUCLEX_SUPPORT_THREADING_THREADPOOL_H
+
+#include "Nuclex/Support/Config.h"
+
+#include <atomic> // for std::atomic
+#include <cstddef> // for std::size_t
+#include <functional> // for std::function
+#include <type_traits> // for std::remove_reference, std::decay
+#include <utility> // for std::declval(), std::forward()
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  class TaskGroup;
+  template<typename TResult> class Task;
+
+  namespace Private {
+    class ThreadPoolAccess;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>How the worker threads of a thread pool are bound to CPU cores</summary>
+  enum class ThreadPinning {
+
+    /// <summary>Worker threads run wherever the operating system puts them</summary>
+    None,
+
+    /// <summary>Each worker thread is bound to its own CPU core</summary>
+    Cores,
+
+    /// <summary>Worker threads are spread over the NUMA nodes, each bound to one node</summary>
+    NumaNodes
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Set of worker threads that steal tasks from each other</summary>
+  /// <remarks>
+  ///   <para>
+  ///     Each worker thread has its own task queue. Tasks scheduled from a worker go into
+  ///     that worker's queue, where they are processed last-in-first-out while the data
+  ///     they touch is still in the cache. Workers that run out of tasks steal the oldest
+  ///     tasks from the other queues, so the load evens out without a central queue that
+  ///     all threads fight over. Tasks scheduled from outside the pool go into a shared
+  ///     queue the workers also steal from.
+  ///   </para>
+  ///   <para>
+  ///     Tasks are scheduled through a <see cref="TaskGroup" />. Waiting for a group or
+  ///     for <see cref="ForEach" /> to finish doesn't block the waiting thread: it processes
+  ///     tasks from the pool until the work it waits for is done. This lets tasks wait
+  ///     for nested tasks of their own without tying up a worker thread.
+  ///   </para>
+  ///   <para>
+  ///     The thread pool is owned by whoever creates it. Libraries taking a reference to
+  ///     a thread pool let the application decide how many threads do work and let all of
+  ///     them share one set of threads.
+  ///   </para>
+  /// </remarks>
+  class ThreadPool {
+
+    /// <summary>Initializes a new thread pool</summary>
+    /// <param name="threadCount">
+    ///   Total number of threads that will process tasks, including a thread waiting for
+    ///   tasks to finish. Zero uses one thread per CPU core the system reports.
+    /// </param>
+    /// <param name="pinThreadsToCores">
+    ///   Whether each worker thread should be bound to its own CPU core. This keeps
+    ///   the operating system from moving workers between cores (and their caches),
+    ///   but is only sensible if the pool's threads are the main load on the system.
+    /// </param>
+    public: NUCLEX_SUPPORT_API explicit ThreadPool(
+      std::size_t threadCount = 0, bool pinThreadsToCores = false
+    );
+
+    /// <summary>Initializes a new thread pool</summary>
+    /// <param name="threadCount">
+    ///   Total number of threads that will process tasks, including a thread waiting for
+    ///   tasks to finish. Zero uses one thread per CPU core the system reports.
+    /// </param>
+    /// <param name="pinning">How the worker threads will be bound to CPU cores</param>
+    /// <remarks>
+    ///   When pinning to NUMA nodes, the threads are divided into contiguous groups, one
+    ///   per node, with the waiting thread counted towards the first node. Each worker may
+    ///   run on any core of its node. See <see cref="NumaTopology" /> for the nodes.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API ThreadPool(std::size_t threadCount, ThreadPinning pinning);
+
+    /// <summary>Stops all worker threads and frees all resources</summary>
+    /// <remarks>All task groups using the thread pool must have been waited on</remarks>
+    public: NUCLEX_SUPPORT_API ~ThreadPool();
+
+    /// <summary>Counts the threads that will be processing tasks</summary>
+    /// <returns>The number of worker threads plus one for a thread waiting on tasks</returns>
+    public: NUCLEX_SUPPORT_API std::size_t CountThreads() const;
+
+    /// <summary>Counts the NUMA nodes the worker threads have been spread over</summary>
+    /// <returns>The number of NUMA nodes, 1 unless pinned to NUMA nodes</returns>
+    public: NUCLEX_SUPPORT_API std::size_t CountNumaNodes() const;
+
+    /// <summary>Runs a task for each index in the specified range in parallel</summary>
+    /// <typeparam name="TTask">Callable object that will be run for each index</typeparam>
+    /// <param name="taskCount">Number of times the task will be run</param>
+    /// <param name="task">Task that will be invoked with each index</param>
+    /// <param name="grainSize">
+    ///   Number of consecutive indices a thread processes before it looks for more work.
+    ///   Larger values reduce overhead for tiny tasks, smaller values balance the load
+    ///   better for uneven tasks. Zero chooses a grain size from the number of threads.
+    /// </param>
+    /// <remarks>
+    ///   Blocks until all indices have been processed, with the calling thread helping out.
+    ///   If any invocation of the task throws an exception, the remaining indices are
+    ///   skipped and the first exception is rethrown once all threads have stopped working
+    ///   on the range. ForEach() can be called from within a task.
+    /// </remarks>
+    public: template<typename TTask>
+    void ForEach(std::size_t taskCount, TTask &&task, std::size_t grainSize = 0) {
+      runForEach(
+        taskCount, grainSize,
+        &invokeTask<typename std::remove_reference<TTask>::type>, &task
+      );
+    }
+
+    /// <summary>Runs a task on the thread pool and provides its result later</summary>
+    /// <typeparam name="TFunction">Callable object that will be run</typeparam>
+    /// <param name="function">Function that will be run on the thread pool</param>
+    /// <returns>A task through which the function's result can be obtained</returns>
+    /// <remarks>
+    ///   Needs the <see cref="Task" /> class from Nuclex/Support/Threading/Task.h.
+    ///   If the function throws an exception, it is rethrown when the result is obtained.
+    /// </remarks>
+    public: template<typename TFunction>
+    Task<typename std::decay<decltype(std::declval<TFunction &>()())>::type> Schedule(
+      TFunction &&function
+    ) {
+      typedef typename std::decay<decltype(std::declval<TFunction &>()())>::type ResultType;
+      return Task<ResultType>::schedule(*this, std::forward<TFunction>(function));
+    }
+
+    /// <summary>Signature of a function that invokes a task with an index</summary>
+    /// <param name="task">Task that will be invoked</param>
+    /// <param name="taskIndex">Index the task will be invoked with</param>
+    private: typedef void TaskFunction(void *task, std::size_t taskIndex);
+
+    /// <summary>Invokes a callable object as task</summary>
+    /// <typeparam name="TTask">Type of callable object that will be invoked</typeparam>
+    /// <param name="task">Address of the callable object</param>
+    /// <param name="taskIndex">Index the task will be invoked with</param>
+    private: template<typename TTask>
+    static void invokeTask(void *task, std::size_t taskIndex) {
+      (*static_cast<TTask *>(task))(taskIndex);
+    }
+
+    /// <summary>Processes a range of indices on the thread pool and the calling thread</summary>
+    /// <param name="taskCount">Number of indices in the range</param>
+    /// <param name="grainSize">Number of indices processed in one go</param>
+    /// <param name="function">Function that will invoke the task for each index</param>
+    /// <param name="task">Task that will be passed to the function</param>
+    private: NUCLEX_SUPPORT_API void runForEach(
+      std::size_t taskCount, std::size_t grainSize, TaskFunction *function, void *task
+    );
+
+    /// <summary>Schedules a task belonging to a task group</summary>
+    /// <param name="group">Task group the task belongs to</param>
+    /// <param name="task">Task that will be scheduled</param>
+    private: NUCLEX_SUPPORT_API void schedule(TaskGroup &group, std::function<void()> &&task);
+
+    /// <summary>Processes tasks until all tasks in a task group have finished</summary>
+    /// <param name="group">Task group whose tasks will be waited for</param>
+    private: NUCLEX_SUPPORT_API void waitFor(TaskGroup &group);
+
+    /// <summary>Schedules a task that doesn't belong to any task group</summary>
+    /// <param name="task">Task that will be scheduled, must not throw</param>
+    private: NUCLEX_SUPPORT_API void post(std::function<void()> &&task);
+
+    /// <summary>Processes tasks until the specified flag is set</summary>
+    /// <param name="isDone">Flag that will be set when waiting should end</param>
+    /// <remarks>
+    ///   Whoever sets the flag has to call <see cref="wakeHelpers" /> afterwards
+    /// </remarks>
+    private: NUCLEX_SUPPORT_API void helpUntil(const std::atomic<bool> &isDone);
+
+    /// <summary>Wakes up threads in <see cref="helpUntil" /> to check their flags</summary>
+    private: NUCLEX_SUPPORT_API void wakeHelpers();
+
+    private: ThreadPool(const ThreadPool &) = delete;
+    private: ThreadPool &operator =(const ThreadPool &) = delete;
+
+    /// <summary>Task groups schedule and wait through the private methods</summary>
+    friend class TaskGroup;
+    /// <summary>Futures schedule continuations and wait through the private methods</summary>
+    friend class Private::ThreadPoolAccess;
+
+    /// <summary>Structure holding the threads and the task queues</summary>
+    private: struct Implementation;
+
+    /// <summary>Worker threads and their task queues</summary>
+    private: Implementation *implementation;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
+
+#endif // NUCLEX_SUPPORT_THREADING_THREADPOOL_H
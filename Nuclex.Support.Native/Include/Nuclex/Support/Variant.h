@@ -25,8 +25,10 @@ License along with this library
 #include "Any.h"
 #include "VariantType.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <utility>
 
 namespace Nuclex { namespace Support {
 
@@ -109,6 +111,13 @@ namespace Nuclex { namespace Support {
       new(this->stringValueBytes) std::string(stringValue);
     }
 
+    /// <summary>Initializes a variant to take over a string</summary>
+    /// <param name="stringValue">String that will be moved into the variant</param>
+    public: NUCLEX_SUPPORT_API Variant(std::string &&stringValue) :
+      type(VariantType::String) {
+      new(this->stringValueBytes) std::string(std::move(stringValue));
+    }
+
     /// <summary>Initializes a variant to hold a wide string</summary>
     /// <param name="wstringValue">Wide string that the variant will hold</param>
     public: NUCLEX_SUPPORT_API Variant(const std::wstring &wstringValue) :
@@ -116,6 +125,13 @@ namespace Nuclex { namespace Support {
       new(this->wstringValueBytes) std::wstring(wstringValue);
     }
 
+    /// <summary>Initializes a variant to take over a wide string</summary>
+    /// <param name="wstringValue">Wide string that will be moved into the variant</param>
+    public: NUCLEX_SUPPORT_API Variant(std::wstring &&wstringValue) :
+      type(VariantType::WString) {
+      new(this->wstringValueBytes) std::wstring(std::move(wstringValue));
+    }
+
     /// <summary>Initializes a variant to hold an opaquely typed value</summary>
     /// <param name="anyValue">Opaquely typed value the variant will hold</param>
     public: NUCLEX_SUPPORT_API Variant(const Any &anyValue) :
@@ -202,10 +218,57 @@ namespace Nuclex { namespace Support {
     /// <returns>The variasnt's value as a string</returns>
     public: NUCLEX_SUPPORT_API std::string ToString() const;
 
+    /// <summary>Writes the value held by the variant into a string</summary>
+    /// <param name="target">String whose contents will be replaced by the value</param>
+    /// <remarks>
+    ///   Produces the same text as <see cref="ToString" />, but reuses the memory of
+    ///   the target string, so repeated conversions into the same string don't allocate.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API void ToString(std::string &target) const;
+
+    /// <summary>Writes the value held by the variant into a character buffer</summary>
+    /// <param name="buffer">Buffer that will receive the value as UTF-8 text</param>
+    /// <param name="bufferLength">Number of characters the buffer can hold</param>
+    /// <returns>
+    ///   The number of characters written into the buffer or, if the buffer is too small,
+    ///   the number of characters it would need to hold the text
+    /// </returns>
+    /// <remarks>
+    ///   No terminating zero is written. Like the buffer conversions of the
+    ///   <see cref="Text.StringConverter" />, a buffer that is too small receives as much
+    ///   of the text as fits. Numbers always fit into
+    ///   <see cref="Text.MaximumLexicalPrintLength" /> characters.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API std::size_t ToString(
+      char *buffer, std::size_t bufferLength
+    ) const;
+
     /// <summary>Returns the value held by the variant as a wide string</summary>
     /// <returns>The variasnt's value as a wide string</returns>
     public: NUCLEX_SUPPORT_API std::wstring ToWString() const;
 
+    /// <summary>Writes the value held by the variant into a wide string</summary>
+    /// <param name="target">Wide string whose contents will be replaced by the value</param>
+    /// <remarks>
+    ///   Produces the same text as <see cref="ToWString" />, but reuses the memory of
+    ///   the target string, so repeated conversions into the same string don't allocate.
+    /// </remarks>
+    public: NUCLEX_SUPPORT_API void ToWString(std::wstring &target) const;
+
+    /// <summary>Provides direct access to the value if the variant holds that type</summary>
+    /// <typeparam name="TValue">Type of value the variant is expected to hold</typeparam>
+    /// <returns>
+    ///   The address of the value stored in the variant or a null pointer if the variant
+    ///   holds a different type (no conversion will be attempted)
+    /// </returns>
+    /// <remarks>
+    ///   Meant for code that checks for an expected type and wants to avoid the copy
+    ///   made by <see cref="ToString" /> and friends. The pointer stays valid until
+    ///   a new value is assigned to the variant.
+    /// </remarks>
+    public: template<typename TValue>
+    const TValue *TryGet() const = delete;
+
     /// <summary>Returns the value held by the variant as an opaquely typed value</summary>
     /// <returns>The variasnt's value as an opaquely typed value</returns>
     public: NUCLEX_SUPPORT_API Any ToAny() const;
@@ -368,9 +431,27 @@ namespace Nuclex { namespace Support {
     /// <param name="newValue">String that will be assigned</param>
     /// <returns>The variant itself</returns>
     public: NUCLEX_SUPPORT_API Variant &operator =(const std::string &newValue) {
-      free();
-      new(this->stringValueBytes) std::string(newValue);
-      this->type = VariantType::String;
+      if(this->type == VariantType::String) { // Reuse the string's memory if possible
+        *reinterpret_cast<std::string *>(this->stringValueBytes) = newValue;
+      } else {
+        free();
+        new(this->stringValueBytes) std::string(newValue);
+        this->type = VariantType::String;
+      }
+      return *this;
+    }
+
+    /// <summary>Moves a string into the variant</summary>
+    /// <param name="newValue">String that will be moved into the variant</param>
+    /// <returns>The variant itself</returns>
+    public: NUCLEX_SUPPORT_API Variant &operator =(std::string &&newValue) {
+      if(this->type == VariantType::String) {
+        *reinterpret_cast<std::string *>(this->stringValueBytes) = std::move(newValue);
+      } else {
+        free();
+        new(this->stringValueBytes) std::string(std::move(newValue));
+        this->type = VariantType::String;
+      }
       return *this;
     }
 
@@ -378,9 +459,27 @@ namespace Nuclex { namespace Support {
     /// <param name="newValue">Wide string that will be assigned</param>
     /// <returns>The variant itself</returns>
     public: NUCLEX_SUPPORT_API Variant &operator =(const std::wstring &newValue) {
-      free();
-      new(this->wstringValueBytes) std::wstring(newValue);
-      this->type = VariantType::WString;
+      if(this->type == VariantType::WString) { // Reuse the string's memory if possible
+        *reinterpret_cast<std::wstring *>(this->wstringValueBytes) = newValue;
+      } else {
+        free();
+        new(this->wstringValueBytes) std::wstring(newValue);
+        this->type = VariantType::WString;
+      }
+      return *this;
+    }
+
+    /// <summary>Moves a wide string into the variant</summary>
+    /// <param name="newValue">Wide string that will be moved into the variant</param>
+    /// <returns>The variant itself</returns>
+    public: NUCLEX_SUPPORT_API Variant &operator =(std::wstring &&newValue) {
+      if(this->type == VariantType::WString) {
+        *reinterpret_cast<std::wstring *>(this->wstringValueBytes) = std::move(newValue);
+      } else {
+        free();
+        new(this->wstringValueBytes) std::wstring(std::move(newValue));
+        this->type = VariantType::WString;
+      }
       return *this;
     }
 
@@ -414,6 +513,17 @@ namespace Nuclex { namespace Support {
     /// <returns>The variant itself</returns>
     public: NUCLEX_SUPPORT_API Variant &operator =(Variant &&other);
 
+    /// <summary>Prints the value if the variant holds a boolean, number or pointer</summary>
+    /// <param name="target">
+    ///   Buffer that will receive the printed value, must have room for at least
+    ///   <see cref="Text.MaximumLexicalPrintLength" /> characters
+    /// </param>
+    /// <returns>
+    ///   The address one past the last printed character or a null pointer if
+    ///   the variant holds anything else
+    /// </returns>
+    private: char *printScalar(char *target) const;
+
     /// <summary>Frees all memory used by the variant</summary>
     private: void free() {
       switch(this->type) {
@@ -475,6 +585,108 @@ namespace Nuclex { namespace Support {
 
   // ------------------------------------------------------------------------------------------- //
 
+  template<> inline const bool *Variant::TryGet<bool>() const {
+    return (this->type == VariantType::Boolean) ? &this->booleanValue : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::uint8_t *Variant::TryGet<std::uint8_t>() const {
+    return (this->type == VariantType::Uint8) ? &this->uint8Value : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::int8_t *Variant::TryGet<std::int8_t>() const {
+    return (this->type == VariantType::Int8) ? &this->int8Value : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::uint16_t *Variant::TryGet<std::uint16_t>() const {
+    return (this->type == VariantType::Uint16) ? &this->uint16Value : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::int16_t *Variant::TryGet<std::int16_t>() const {
+    return (this->type == VariantType::Int16) ? &this->int16Value : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::uint32_t *Variant::TryGet<std::uint32_t>() const {
+    return (this->type == VariantType::Uint32) ? &this->uint32Value : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::int32_t *Variant::TryGet<std::int32_t>() const {
+    return (this->type == VariantType::Int32) ? &this->int32Value : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::uint64_t *Variant::TryGet<std::uint64_t>() const {
+    return (this->type == VariantType::Uint64) ? &this->uint64Value : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::int64_t *Variant::TryGet<std::int64_t>() const {
+    return (this->type == VariantType::Int64) ? &this->int64Value : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const float *Variant::TryGet<float>() const {
+    return (this->type == VariantType::Float) ? &this->floatValue : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const double *Variant::TryGet<double>() const {
+    return (this->type == VariantType::Double) ? &this->doubleValue : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::string *Variant::TryGet<std::string>() const {
+    if(this->type == VariantType::String) {
+      return reinterpret_cast<const std::string *>(this->stringValueBytes);
+    } else {
+      return nullptr;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const std::wstring *Variant::TryGet<std::wstring>() const {
+    if(this->type == VariantType::WString) {
+      return reinterpret_cast<const std::wstring *>(this->wstringValueBytes);
+    } else {
+      return nullptr;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline const Any *Variant::TryGet<Any>() const {
+    if(this->type == VariantType::Any) {
+      return reinterpret_cast<const Any *>(this->anyValueBytes);
+    } else {
+      return nullptr;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> inline void *const *Variant::TryGet<void *>() const {
+    return (this->type == VariantType::VoidPointer) ? &this->pointerValue : nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Support
 
 #endif // NUCLEX_SUPPORT_VARIANT_H
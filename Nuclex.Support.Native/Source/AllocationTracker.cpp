@@ -0,0 +1,210 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/AllocationTracker.h"
+
+#include <cstdlib> // for std::malloc(), std::realloc(), std::free()
+#include <new> // for operator new, operator delete
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the header that remembers the size of a Malloc() allocation</summary>
+  /// <remarks>
+  ///   Kept at the fundamental alignment so the memory behind the header is aligned
+  ///   just like the memory std::malloc() returns.
+  /// </remarks>
+  const std::size_t HeaderByteCount = alignof(std::max_align_t);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocation totals of a single subsystem</summary>
+  /// <remarks>
+  ///   Each subsystem gets its own cache line so threads allocating for different
+  ///   subsystems do not slow each other down.
+  /// </remarks>
+  struct alignas(64) SubsystemCounters {
+
+    /// <summary>Number of times memory has been allocated</summary>
+    public: std::atomic<std::uint64_t> AllocationCount;
+    /// <summary>Number of times memory has been freed</summary>
+    public: std::atomic<std::uint64_t> FreeCount;
+    /// <summary>Total number of bytes that have been allocated</summary>
+    public: std::atomic<std::uint64_t> AllocatedByteCount;
+    /// <summary>Total number of bytes that have been freed</summary>
+    public: std::atomic<std::uint64_t> FreedByteCount;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Allocation totals of all subsystems</summary>
+  /// <remarks>
+  ///   Zero-initialized before any dynamic initialization runs, so allocations
+  ///   made from the constructors of other global objects are safe to count.
+  /// </remarks>
+  SubsystemCounters subsystemCounters[Nuclex::Support::AllocationTracker::SubsystemCount];
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the counters for the specified subsystem</summary>
+  /// <param name="subsystem">Subsystem whose counters will be looked up</param>
+  /// <returns>The counters of the specified subsystem</returns>
+  SubsystemCounters &getCounters(Nuclex::Support::AllocationSubsystem subsystem) {
+    return subsystemCounters[static_cast<std::size_t>(subsystem)];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the size stored in front of memory handed out by Malloc()</summary>
+  /// <param name="memory">Memory whose size will be read</param>
+  /// <returns>The size of the memory in bytes</returns>
+  std::size_t getStoredByteCount(void *memory) {
+    return *reinterpret_cast<std::size_t *>(static_cast<std::uint8_t *>(memory) - HeaderByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::size_t AllocationTracker::SubsystemCount;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::atomic<bool> AllocationTracker::enabled(false);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AllocationTracker::SetEnabled(bool enabled) {
+    AllocationTracker::enabled.store(enabled, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  AllocationTracker::Snapshot AllocationTracker::TakeSnapshot() {
+    Snapshot snapshot;
+    for(std::size_t index = 0; index < SubsystemCount; ++index) {
+      const SubsystemCounters &counters = subsystemCounters[index];
+      Totals &totals = snapshot.Subsystems[index];
+
+      totals.AllocationCount = counters.AllocationCount.load(std::memory_order_relaxed);
+      totals.FreeCount = counters.FreeCount.load(std::memory_order_relaxed);
+      totals.AllocatedByteCount = counters.AllocatedByteCount.load(std::memory_order_relaxed);
+      totals.FreedByteCount = counters.FreedByteCount.load(std::memory_order_relaxed);
+    }
+
+    return snapshot;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void *AllocationTracker::Allocate(AllocationSubsystem subsystem, std::size_t byteCount) {
+    void *memory = ::operator new(byteCount);
+    RecordAllocation(subsystem, byteCount);
+    return memory;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AllocationTracker::Deallocate(
+    AllocationSubsystem subsystem, void *memory, std::size_t byteCount
+  ) {
+    ::operator delete(memory);
+    RecordFree(subsystem, byteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void *AllocationTracker::Malloc(AllocationSubsystem subsystem, std::size_t byteCount) {
+    std::uint8_t *header = static_cast<std::uint8_t *>(
+      std::malloc(HeaderByteCount + byteCount)
+    );
+    if(header == nullptr) {
+      return nullptr;
+    }
+
+    *reinterpret_cast<std::size_t *>(header) = byteCount;
+    RecordAllocation(subsystem, byteCount);
+    return header + HeaderByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void *AllocationTracker::Realloc(
+    AllocationSubsystem subsystem, void *memory, std::size_t byteCount
+  ) {
+    if(memory == nullptr) {
+      return Malloc(subsystem, byteCount);
+    }
+
+    std::size_t previousByteCount = getStoredByteCount(memory);
+    std::uint8_t *header = static_cast<std::uint8_t *>(
+      std::realloc(
+        static_cast<std::uint8_t *>(memory) - HeaderByteCount, HeaderByteCount + byteCount
+      )
+    );
+    if(header == nullptr) {
+      return nullptr;
+    }
+
+    // A reallocation is counted as freeing the old memory and allocating new memory
+    *reinterpret_cast<std::size_t *>(header) = byteCount;
+    RecordFree(subsystem, previousByteCount);
+    RecordAllocation(subsystem, byteCount);
+    return header + HeaderByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AllocationTracker::Free(AllocationSubsystem subsystem, void *memory) {
+    if(memory != nullptr) {
+      std::size_t byteCount = getStoredByteCount(memory);
+      std::free(static_cast<std::uint8_t *>(memory) - HeaderByteCount);
+      RecordFree(subsystem, byteCount);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AllocationTracker::recordAllocation(AllocationSubsystem subsystem, std::size_t byteCount) {
+    SubsystemCounters &counters = getCounters(subsystem);
+    counters.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    counters.AllocatedByteCount.fetch_add(byteCount, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void AllocationTracker::recordFree(AllocationSubsystem subsystem, std::size_t byteCount) {
+    SubsystemCounters &counters = getCounters(subsystem);
+    counters.FreeCount.fetch_add(1, std::memory_order_relaxed);
+    counters.FreedByteCount.fetch_add(byteCount, std::memory_order_relaxed);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -0,0 +1,205 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/ChromeTraceSink.h"
+#include "Nuclex/Support/Text/StringBuilder.h"
+
+#include <functional> // for std::hash
+#include <cstring> // for std::strlen()
+#include <ostream> // for std::ostream
+#include <thread> // for std::this_thread::get_id()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Value index that marks the single value of a counter</summary>
+  const std::uint64_t CounterValueIndex = Nuclex::Support::Histogram::BucketCount;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Appends a time in nanoseconds as fractional microseconds</summary>
+  /// <param name="builder">String builder the time will be appended to</param>
+  /// <param name="nanoseconds">Time that will be appended</param>
+  void appendMicroseconds(
+    Nuclex::Support::Text::StringBuilder &builder, std::uint64_t nanoseconds
+  ) {
+    std::uint64_t fraction = nanoseconds % 1000;
+    builder.Append(nanoseconds / 1000);
+    builder.Append('.');
+    builder.Append(static_cast<char>('0' + fraction / 100));
+    builder.Append(static_cast<char>('0' + fraction / 10 % 10));
+    builder.Append(static_cast<char>('0' + fraction % 10));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChromeTraceSink::ChromeTraceSink() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ChromeTraceSink::~ChromeTraceSink() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ChromeTraceSink::CountEvents() const {
+    std::lock_guard<std::mutex> eventsScope(this->mutex);
+    return this->events.size();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChromeTraceSink::Clear() {
+    std::lock_guard<std::mutex> eventsScope(this->mutex);
+    this->events.clear();
+    this->values.clear();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChromeTraceSink::WriteTo(std::ostream &stream) const {
+    Text::StringBuilder json;
+    {
+      std::lock_guard<std::mutex> eventsScope(this->mutex);
+
+      // Assemble the whole document in one buffer, then hand it to the stream at once
+      json.Reserve(64 + this->events.size() * 96);
+      json.Append(u8"{\"traceEvents\":[");
+      for(std::size_t index = 0; index < this->events.size(); ++index) {
+        const Event &event = this->events[index];
+        if(index > 0) {
+          json.Append(',');
+        }
+
+        json.Append(u8"\n{\"name\":\"");
+        json.AppendJsonEscaped(event.Name, std::strlen(event.Name));
+        json.Append('"');
+        if(event.ValueCount == 0) {
+          json.Append(u8",\"ph\":\"X\",\"pid\":1,\"tid\":");
+          json.Append(event.ThreadId);
+          json.Append(u8",\"ts\":");
+          appendMicroseconds(json, event.StartNanoseconds);
+          json.Append(u8",\"dur\":");
+          appendMicroseconds(json, event.ElapsedNanoseconds);
+        } else {
+          json.Append(u8",\"ph\":\"C\",\"pid\":1,\"ts\":");
+          appendMicroseconds(json, event.StartNanoseconds);
+          json.Append(u8",\"args\":{");
+          for(std::size_t valueIndex = 0; valueIndex < event.ValueCount; ++valueIndex) {
+            std::size_t pairIndex = (event.FirstValueIndex + valueIndex) * 2;
+            if(valueIndex > 0) {
+              json.Append(',');
+            }
+            if(this->values[pairIndex] == CounterValueIndex) {
+              json.Append(u8"\"value\":");
+            } else {
+              json.Append(u8"\"<2^");
+              json.Append(this->values[pairIndex]);
+              json.Append(u8"\":");
+            }
+            json.Append(this->values[pairIndex + 1]);
+          }
+          json.Append('}');
+        }
+        json.Append('}');
+      }
+      json.Append(u8"\n]}\n");
+    }
+
+    stream.write(json.GetCharacters(), static_cast<std::streamsize>(json.GetLength()));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChromeTraceSink::ZoneLeft(
+    const InstrumentationSite &site,
+    std::uint64_t startNanoseconds, std::uint64_t elapsedNanoseconds
+  ) {
+    Event event;
+    event.Name = site.Name;
+    event.ThreadId = static_cast<std::uint64_t>(
+      std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xFFFFFFFF
+    );
+    event.StartNanoseconds = startNanoseconds;
+    event.ElapsedNanoseconds = elapsedNanoseconds;
+    event.FirstValueIndex = 0;
+    event.ValueCount = 0;
+
+    std::lock_guard<std::mutex> eventsScope(this->mutex);
+    this->events.push_back(event);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChromeTraceSink::CounterReported(const Counter &counter, std::uint64_t value) {
+    Event event;
+    event.Name = counter.GetName();
+    event.ThreadId = 0;
+    event.StartNanoseconds = Instrumentation::GetTimestamp();
+    event.ElapsedNanoseconds = 0;
+    event.ValueCount = 1;
+
+    std::lock_guard<std::mutex> eventsScope(this->mutex);
+    event.FirstValueIndex = this->values.size() / 2;
+    this->values.push_back(CounterValueIndex);
+    this->values.push_back(value);
+    this->events.push_back(event);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ChromeTraceSink::HistogramReported(
+    const Histogram &histogram, const std::uint64_t *bucketCounts
+  ) {
+    Event event;
+    event.Name = histogram.GetName();
+    event.ThreadId = 0;
+    event.StartNanoseconds = Instrumentation::GetTimestamp();
+    event.ElapsedNanoseconds = 0;
+    event.ValueCount = 0;
+
+    std::lock_guard<std::mutex> eventsScope(this->mutex);
+    event.FirstValueIndex = this->values.size() / 2;
+    for(std::size_t index = 0; index < Histogram::BucketCount; ++index) {
+      if(bucketCounts[index] != 0) {
+        this->values.push_back(index);
+        this->values.push_back(bucketCounts[index]);
+        ++event.ValueCount;
+      }
+    }
+
+    // A histogram without any values has nothing to plot
+    if(event.ValueCount > 0) {
+      this->events.push_back(event);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -0,0 +1,234 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Collections/MirroredMemory.h"
+
+#include <system_error> // for std::system_error
+
+#if defined(NUCLEX_SUPPORT_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h> // for CreateFileMappingW(), MapViewOfFileEx(), VirtualAlloc()
+#undef min
+#undef max
+#else
+#include <cerrno> // for errno
+#include <linux/memfd.h> // for MFD_CLOEXEC
+#include <sys/mman.h> // for mmap(), munmap()
+#include <sys/syscall.h> // for __NR_memfd_create
+#include <unistd.h> // for syscall(), ftruncate(), close(), sysconf()
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Rounds a byte count up to the allocation granularity</summary>
+  /// <param name="byteCount">Byte count that will be rounded up</param>
+  /// <returns>The smallest multiple of the allocation granularity that fits the bytes</returns>
+  std::size_t roundUpToAllocationGranularity(std::size_t byteCount) {
+    std::size_t granularity = (
+      Nuclex::Support::Collections::MirroredMemory::GetAllocationGranularity()
+    );
+    if(byteCount == 0) {
+      return granularity;
+    }
+
+    return (byteCount + granularity - 1) / granularity * granularity;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_WIN32)
+
+  /// <summary>Throws an exception for the last error reported by the Windows API</summary>
+  /// <param name="message">Message describing what went wrong</param>
+  [[noreturn]] void throwLastWindowsError(const char *message) {
+    DWORD errorCode = ::GetLastError();
+    throw std::system_error(static_cast<int>(errorCode), std::system_category(), message);
+  }
+
+#else
+
+  /// <summary>Throws an exception for the error code in errno</summary>
+  /// <param name="message">Message describing what went wrong</param>
+  [[noreturn]] void throwErrno(const char *message) {
+    int errorNumber = errno;
+    throw std::system_error(errorNumber, std::generic_category(), message);
+  }
+
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t MirroredMemory::GetAllocationGranularity() {
+#if defined(NUCLEX_SUPPORT_WIN32)
+    SYSTEM_INFO systemInfo;
+    ::GetSystemInfo(&systemInfo);
+    return static_cast<std::size_t>(systemInfo.dwAllocationGranularity);
+#else
+    return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_WIN32)
+
+  MirroredMemory::MirroredMemory(std::size_t minimumByteCount) :
+    address(nullptr),
+    byteCount(roundUpToAllocationGranularity(minimumByteCount)) {
+
+    std::uint64_t mappingByteCount = static_cast<std::uint64_t>(this->byteCount);
+    HANDLE mapping = ::CreateFileMappingW(
+      INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+      static_cast<DWORD>(mappingByteCount >> 32), static_cast<DWORD>(mappingByteCount),
+      nullptr
+    );
+    if(mapping == nullptr) {
+      throwLastWindowsError(u8"Could not create file mapping for mirrored memory");
+    }
+
+    // There is no way to reserve an address range and map into it with the classic API,
+    // so find a free range, release it and map both views into it. Another thread may
+    // grab the range in between, in which case we simply try again.
+    for(std::size_t attempt = 0; attempt < 100; ++attempt) {
+      void *reserved = ::VirtualAlloc(
+        nullptr, this->byteCount * 2, MEM_RESERVE, PAGE_NOACCESS
+      );
+      if(reserved == nullptr) {
+        ::CloseHandle(mapping);
+        throwLastWindowsError(u8"Could not reserve address space for mirrored memory");
+      }
+      ::VirtualFree(reserved, 0, MEM_RELEASE);
+
+      std::uint8_t *base = static_cast<std::uint8_t *>(reserved);
+      void *first = ::MapViewOfFileEx(
+        mapping, FILE_MAP_ALL_ACCESS, 0, 0, this->byteCount, base
+      );
+      if(first != nullptr) {
+        void *second = ::MapViewOfFileEx(
+          mapping, FILE_MAP_ALL_ACCESS, 0, 0, this->byteCount, base + this->byteCount
+        );
+        if(second != nullptr) {
+          this->address = base;
+          break;
+        }
+        ::UnmapViewOfFile(first);
+      }
+    }
+
+    // The views keep the mapping alive, the handle itself is no longer needed
+    ::CloseHandle(mapping);
+    if(this->address == nullptr) {
+      throw std::system_error(
+        static_cast<int>(ERROR_NOT_ENOUGH_MEMORY), std::system_category(),
+        u8"Could not map mirrored memory into the address space"
+      );
+    }
+  }
+
+#else
+
+  MirroredMemory::MirroredMemory(std::size_t minimumByteCount) :
+    address(nullptr),
+    byteCount(roundUpToAllocationGranularity(minimumByteCount)) {
+
+    int memoryDescriptor = static_cast<int>(
+      ::syscall(__NR_memfd_create, u8"Nuclex.Support.MirroredMemory", MFD_CLOEXEC)
+    );
+    if(memoryDescriptor == -1) {
+      throwErrno(u8"Could not create memory file for mirrored memory");
+    }
+    if(::ftruncate(memoryDescriptor, static_cast<off_t>(this->byteCount)) == -1) {
+      int errorNumber = errno;
+      ::close(memoryDescriptor);
+      errno = errorNumber;
+      throwErrno(u8"Could not resize memory file for mirrored memory");
+    }
+
+    // Reserve address space for both mappings, then map the memory file over
+    // each half of it. MAP_FIXED replaces the reservation atomically.
+    void *reserved = ::mmap(
+      nullptr, this->byteCount * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+    if(reserved == MAP_FAILED) {
+      int errorNumber = errno;
+      ::close(memoryDescriptor);
+      errno = errorNumber;
+      throwErrno(u8"Could not reserve address space for mirrored memory");
+    }
+
+    std::uint8_t *base = static_cast<std::uint8_t *>(reserved);
+    for(std::size_t half = 0; half < 2; ++half) {
+      void *mapped = ::mmap(
+        base + half * this->byteCount, this->byteCount, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_FIXED, memoryDescriptor, 0
+      );
+      if(mapped == MAP_FAILED) {
+        int errorNumber = errno;
+        ::munmap(reserved, this->byteCount * 2);
+        ::close(memoryDescriptor);
+        errno = errorNumber;
+        throwErrno(u8"Could not map mirrored memory into the address space");
+      }
+    }
+
+    // The mappings keep the memory file alive, the descriptor itself is no longer needed
+    ::close(memoryDescriptor);
+    this->address = base;
+  }
+
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MirroredMemory::MirroredMemory(MirroredMemory &&other) :
+    address(other.address),
+    byteCount(other.byteCount) {
+    other.address = nullptr;
+    other.byteCount = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MirroredMemory::~MirroredMemory() {
+    if(this->address != nullptr) {
+#if defined(NUCLEX_SUPPORT_WIN32)
+      ::UnmapViewOfFile(this->address + this->byteCount);
+      ::UnmapViewOfFile(this->address);
+#else
+      ::munmap(this->address, this->byteCount * 2);
+#endif
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
@@ -0,0 +1,213 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/CpuFeatures.h"
+
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t, std::uint64_t
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define NUCLEX_SUPPORT_CPUFEATURES_X86 1
+  #if defined(_MSC_VER)
+    #include <intrin.h> // for __cpuid(), __cpuidex() and _xgetbv()
+  #else
+    #include <cpuid.h> // for __get_cpuid_max() and __cpuid_count()
+  #endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__) || defined(_M_ARM)
+  #define NUCLEX_SUPPORT_CPUFEATURES_ARM 1
+  #if defined(NUCLEX_SUPPORT_LINUX)
+    #include <sys/auxv.h> // for getauxval()
+  #elif defined(NUCLEX_SUPPORT_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <Windows.h> // for IsProcessorFeaturePresent()
+  #endif
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_CPUFEATURES_X86)
+  /// <summary>Registers returned by the cpuid instruction</summary>
+  struct CpuIdRegisters {
+
+    /// <summary>Contents of the eax register</summary>
+    public: std::uint32_t Eax;
+    /// <summary>Contents of the ebx register</summary>
+    public: std::uint32_t Ebx;
+    /// <summary>Contents of the ecx register</summary>
+    public: std::uint32_t Ecx;
+    /// <summary>Contents of the edx register</summary>
+    public: std::uint32_t Edx;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Queries information about the CPU via the cpuid instruction</summary>
+  /// <param name="leaf">Category of information that will be queried</param>
+  /// <param name="subleaf">Subcategory of information that will be queried</param>
+  /// <returns>The registers as set by the cpuid instruction</returns>
+  CpuIdRegisters queryCpuId(std::uint32_t leaf, std::uint32_t subleaf = 0) {
+    CpuIdRegisters registers;
+#if defined(_MSC_VER)
+    int cpuInfo[4];
+    __cpuidex(cpuInfo, static_cast<int>(leaf), static_cast<int>(subleaf));
+    registers.Eax = static_cast<std::uint32_t>(cpuInfo[0]);
+    registers.Ebx = static_cast<std::uint32_t>(cpuInfo[1]);
+    registers.Ecx = static_cast<std::uint32_t>(cpuInfo[2]);
+    registers.Edx = static_cast<std::uint32_t>(cpuInfo[3]);
+#else
+    unsigned int eax, ebx, ecx, edx;
+    __cpuid_count(leaf, subleaf, eax, ebx, ecx, edx);
+    registers.Eax = eax;
+    registers.Ebx = ebx;
+    registers.Ecx = ecx;
+    registers.Edx = edx;
+#endif
+    return registers;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Finds the highest cpuid leaf the CPU provides</summary>
+  /// <returns>The number of the highest leaf that can be queried</returns>
+  std::uint32_t getHighestCpuIdLeaf() {
+#if defined(_MSC_VER)
+    return queryCpuId(0).Eax;
+#else
+    return __get_cpuid_max(0, nullptr); // Also checks whether there is a cpuid instruction
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks which register states the operating system saves</summary>
+  /// <returns>The contents of the XCR0 register</returns>
+  /// <remarks>Only to be called if the CPU reports OSXSAVE</remarks>
+  std::uint64_t getEnabledRegisterStates() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    std::uint32_t low, high;
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<std::uint64_t>(high) << 32) | low;
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a bit in a register is set</summary>
+  /// <param name="value">Register contents that will be checked</param>
+  /// <param name="bitIndex">Index of the bit that will be checked</param>
+  /// <returns>True if the bit is set</returns>
+  inline bool isBitSet(std::uint32_t value, std::size_t bitIndex) {
+    return ((value & (1U << bitIndex)) != 0);
+  }
+#endif // defined(NUCLEX_SUPPORT_CPUFEATURES_X86)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Examines the CPU the program is running on</summary>
+  /// <returns>The features supported by the CPU</returns>
+  Nuclex::Support::CpuFeatures detectCpuFeatures() {
+    Nuclex::Support::CpuFeatures features = Nuclex::Support::CpuFeatures();
+
+#if defined(NUCLEX_SUPPORT_CPUFEATURES_X86)
+    std::uint32_t highestLeaf = getHighestCpuIdLeaf();
+    if(highestLeaf < 1) {
+      return features;
+    }
+
+    CpuIdRegisters leaf1 = queryCpuId(1);
+    features.HasSse2 = isBitSet(leaf1.Edx, 26);
+    features.HasSse3 = isBitSet(leaf1.Ecx, 0);
+    features.HasSsse3 = isBitSet(leaf1.Ecx, 9);
+    features.HasSse41 = isBitSet(leaf1.Ecx, 19);
+    features.HasSse42 = isBitSet(leaf1.Ecx, 20);
+    features.HasPopcnt = isBitSet(leaf1.Ecx, 23);
+    features.HasCrc32 = features.HasSse42;
+
+    // The VEX and EVEX encoded extensions need the operating system to save
+    // the wider registers when switching threads
+    bool avxStateSaved = false, avx512StateSaved = false;
+    if(isBitSet(leaf1.Ecx, 27)) { // OSXSAVE
+      std::uint64_t enabledStates = getEnabledRegisterStates();
+      avxStateSaved = ((enabledStates & 0x06) == 0x06); // SSE and AVX
+      avx512StateSaved = ((enabledStates & 0xE6) == 0xE6); // plus opmask and ZMM
+    }
+
+    features.HasAvx = avxStateSaved && isBitSet(leaf1.Ecx, 28);
+    features.HasFma = features.HasAvx && isBitSet(leaf1.Ecx, 12);
+    features.HasF16c = features.HasAvx && isBitSet(leaf1.Ecx, 29);
+
+    if(highestLeaf >= 7) {
+      CpuIdRegisters leaf7 = queryCpuId(7, 0);
+      features.HasBmi1 = isBitSet(leaf7.Ebx, 3);
+      features.HasAvx2 = features.HasAvx && isBitSet(leaf7.Ebx, 5);
+      features.HasBmi2 = isBitSet(leaf7.Ebx, 8);
+      features.HasAvx512f = avx512StateSaved && isBitSet(leaf7.Ebx, 16);
+      features.HasAvx512bw = features.HasAvx512f && isBitSet(leaf7.Ebx, 30);
+      features.HasAvx512vl = features.HasAvx512f && isBitSet(leaf7.Ebx, 31);
+    }
+#elif defined(NUCLEX_SUPPORT_CPUFEATURES_ARM)
+  #if defined(__aarch64__) || defined(_M_ARM64)
+    features.HasNeon = true; // Part of the ARMv8 base instruction set
+  #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    features.HasNeon = true;
+  #elif defined(NUCLEX_SUPPORT_LINUX)
+    features.HasNeon = ((getauxval(AT_HWCAP) & (1UL << 12)) != 0); // HWCAP_NEON
+  #endif
+
+  #if defined(__ARM_FEATURE_CRC32)
+    features.HasCrc32 = true;
+  #elif defined(NUCLEX_SUPPORT_LINUX) && defined(__aarch64__)
+    features.HasCrc32 = ((getauxval(AT_HWCAP) & (1UL << 7)) != 0); // HWCAP_CRC32
+  #elif defined(NUCLEX_SUPPORT_LINUX)
+    features.HasCrc32 = ((getauxval(AT_HWCAP2) & (1UL << 4)) != 0); // HWCAP2_CRC32
+  #elif defined(NUCLEX_SUPPORT_WIN32)
+    features.HasCrc32 = (
+      IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != FALSE
+    );
+  #endif
+#endif
+
+    return features;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const CpuFeatures &CpuFeatures::Get() {
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -0,0 +1,183 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Instrumentation.h"
+
+#include <algorithm> // for std::find()
+#include <chrono> // for std::chrono::steady_clock
+#include <mutex> // for std::mutex
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Keeps track of all counters and histograms that currently exist</summary>
+  struct Registry {
+
+    /// <summary>Must be held while accessing the lists</summary>
+    public: std::mutex Mutex;
+    /// <summary>Counters that currently exist</summary>
+    public: std::vector<const Nuclex::Support::Counter *> Counters;
+    /// <summary>Histograms that currently exist</summary>
+    public: std::vector<const Nuclex::Support::Histogram *> Histograms;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Accesses the registry of counters and histograms</summary>
+  /// <returns>The global registry</returns>
+  /// <remarks>
+  ///   Counters usually are function-local statics, too. Because each one fetches
+  ///   the registry before it finishes constructing, the registry is destroyed only
+  ///   after the last of them.
+  /// </remarks>
+  Registry &getRegistry() {
+    static Registry registry;
+    return registry;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Removes an entry from a list in the registry</summary>
+  /// <typeparam name="TEntry">Type of entry that will be removed</typeparam>
+  /// <param name="entries">List the entry will be removed from</param>
+  /// <param name="entry">Entry that will be removed</param>
+  template<typename TEntry>
+  void removeEntry(std::vector<const TEntry *> &entries, const TEntry *entry) {
+    typename std::vector<const TEntry *>::iterator position = std::find(
+      entries.begin(), entries.end(), entry
+    );
+    if(position != entries.end()) {
+      *position = entries.back();
+      entries.pop_back();
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::size_t Histogram::BucketCount;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::atomic<InstrumentationSink *> Instrumentation::currentSink(nullptr);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentationSink::ZoneEntered(const InstrumentationSite &) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentationSink::CounterReported(const Counter &, std::uint64_t) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void InstrumentationSink::HistogramReported(const Histogram &, const std::uint64_t *) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Instrumentation::SetSink(InstrumentationSink *sink) {
+    currentSink.store(sink, std::memory_order_release);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void Instrumentation::Report(InstrumentationSink &sink) {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> registryScope(registry.Mutex);
+
+    for(std::size_t index = 0; index < registry.Counters.size(); ++index) {
+      const Counter &counter = *registry.Counters[index];
+      sink.CounterReported(counter, counter.GetValue());
+    }
+
+    std::uint64_t bucketCounts[Histogram::BucketCount];
+    for(std::size_t index = 0; index < registry.Histograms.size(); ++index) {
+      const Histogram &histogram = *registry.Histograms[index];
+      for(std::size_t bucketIndex = 0; bucketIndex < Histogram::BucketCount; ++bucketIndex) {
+        bucketCounts[bucketIndex] = histogram.GetBucketCount(bucketIndex);
+      }
+      sink.HistogramReported(histogram, bucketCounts);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::uint64_t Instrumentation::GetTimestamp() {
+    return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+      ).count()
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Counter::Counter(const char *name) :
+    name(name),
+    value(0) {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> registryScope(registry.Mutex);
+    registry.Counters.push_back(this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Counter::~Counter() {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> registryScope(registry.Mutex);
+    removeEntry(registry.Counters, this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Histogram::Histogram(const char *name) :
+    name(name),
+    sum(0) {
+    for(std::size_t index = 0; index < BucketCount; ++index) {
+      this->buckets[index].store(0, std::memory_order_relaxed);
+    }
+
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> registryScope(registry.Mutex);
+    registry.Histograms.push_back(this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Histogram::~Histogram() {
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> registryScope(registry.Mutex);
+    removeEntry(registry.Histograms, this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -0,0 +1,144 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/MonotonicArena.h"
+
+#include <cassert> // for assert()
+#include <cstdint> // for std::uintptr_t
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the offset at which an aligned allocation can begin</summary>
+  /// <param name="blockMemory">Start of the memory block</param>
+  /// <param name="usedByteCount">Number of bytes already in use in the block</param>
+  /// <param name="alignment">Alignment the allocation needs to have</param>
+  /// <returns>The offset in the block at which the allocation can begin</returns>
+  std::size_t getAlignedOffset(
+    const std::uint8_t *blockMemory, std::size_t usedByteCount, std::size_t alignment
+  ) {
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(blockMemory) + usedByteCount;
+    std::uintptr_t alignedAddress = (address + (alignment - 1)) & ~std::uintptr_t(alignment - 1);
+    return usedByteCount + static_cast<std::size_t>(alignedAddress - address);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MonotonicArena::MonotonicArena(std::size_t initialBlockByteCount) :
+    blocks(),
+    initialBlockByteCount((initialBlockByteCount == 0) ? 1 : initialBlockByteCount),
+    currentBlockIndex(0),
+    usedByteCount(0) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MonotonicArena::~MonotonicArena() {
+    for(std::size_t index = 0; index < this->blocks.size(); ++index) {
+      delete []this->blocks[index].Memory;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void *MonotonicArena::Allocate(std::size_t byteCount, std::size_t alignment) {
+    assert(
+      ((alignment != 0) && ((alignment & (alignment - 1)) == 0)) &&
+      u8"Alignment must be a power of two"
+    );
+
+    if(this->currentBlockIndex < this->blocks.size()) {
+      const Block &block = this->blocks[this->currentBlockIndex];
+      std::size_t offset = getAlignedOffset(block.Memory, this->usedByteCount, alignment);
+      if(offset + byteCount <= block.ByteCount) {
+        this->usedByteCount = offset + byteCount;
+        return block.Memory + offset;
+      }
+    }
+
+    advanceBlock(byteCount, alignment);
+
+    const Block &block = this->blocks[this->currentBlockIndex];
+    std::size_t offset = getAlignedOffset(block.Memory, 0, alignment);
+    this->usedByteCount = offset + byteCount;
+    return block.Memory + offset;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t MonotonicArena::GetReservedByteCount() const {
+    std::size_t reservedByteCount = 0;
+    for(std::size_t index = 0; index < this->blocks.size(); ++index) {
+      reservedByteCount += this->blocks[index].ByteCount;
+    }
+    return reservedByteCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void MonotonicArena::advanceBlock(std::size_t byteCount, std::size_t alignment) {
+    std::size_t requiredByteCount = byteCount + alignment - 1;
+
+    // Blocks left over from before the arena was reset or rewound are reused if
+    // they are large enough. Skipped blocks will be used again after the next reset.
+    std::size_t index = this->blocks.empty() ? 0 : (this->currentBlockIndex + 1);
+    while(index < this->blocks.size()) {
+      if(this->blocks[index].ByteCount >= requiredByteCount) {
+        this->currentBlockIndex = index;
+        this->usedByteCount = 0;
+        return;
+      }
+      ++index;
+    }
+
+    // No block was large enough, allocate a new one that is at least twice as large
+    // as the previous one, so the number of blocks grows logarithmically
+    std::size_t blockByteCount = this->initialBlockByteCount;
+    if(!this->blocks.empty()) {
+      blockByteCount = this->blocks.back().ByteCount * 2;
+    }
+    if(blockByteCount < requiredByteCount) {
+      blockByteCount = requiredByteCount;
+    }
+
+    // Make room in the list first so adding the block can't throw and leak it
+    this->blocks.reserve(this->blocks.size() + 1);
+
+    Block block;
+    block.Memory = new std::uint8_t[blockByteCount];
+    block.ByteCount = blockByteCount;
+    this->blocks.push_back(block);
+
+    this->currentBlockIndex = this->blocks.size() - 1;
+    this->usedByteCount = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -0,0 +1,60 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/ScratchScope.h"
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Size of the first memory block in each thread's scratch arena</summary>
+  const std::size_t InitialScratchBlockByteCount = 16384;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ScratchScope::ScratchScope() :
+    arena(GetThreadArena()),
+    marker(this->arena.GetMarker()) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ScratchScope::~ScratchScope() {
+    this->arena.Rewind(this->marker);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  MonotonicArena &ScratchScope::GetThreadArena() {
+    thread_local MonotonicArena threadArena(InitialScratchBlockByteCount);
+    return threadArena;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
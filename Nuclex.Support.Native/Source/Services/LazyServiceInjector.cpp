@@ -24,36 +24,103 @@ License along with this library
 #include "Nuclex/Support/Services/LazyServiceInjector.h"
 #include "Nuclex/Support/Services/UnresolvedDependencyError.h"
 
+#include <algorithm> // for std::find()
+#include <exception> // for std::exception_ptr
 #include <stdexcept>
+#include <string> // for std::string
+#include <system_error> // for std::system_error
+#include <thread> // for std::thread
 
-// TODO: Create a ServiceConstructionChain or something to detect cyclic dependencies
-
-namespace Nuclex { namespace Support { namespace Services {
+namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
-  const Any &LazyServiceInjector::Get(const std::type_info &serviceType) const {
+  /// <summary>Records a service that is being constructed on the current thread</summary>
+  /// <remarks>
+  ///   These form a chain on the stack, from the service currently being constructed
+  ///   back to the service that was requested first. If a service appears in the chain
+  ///   twice, it depends on itself and would never finish constructing.
+  /// </remarks>
+  class ActivationScope {
 
-    // Check if the service has already been constructed
-    ServiceInstanceMap::iterator instanceIt = this->instances.find(&serviceType);
-    if(instanceIt != this->instances.end()) {
-      return instanceIt->second;
+    /// <summary>Enters the construction of a service</summary>
+    /// <param name="injector">Service injector constructing the service</param>
+    /// <param name="serviceIndex">Index of the service that is being constructed</param>
+    /// <param name="dependencies">
+    ///   List that will receive the indices of the services requested during construction,
+    ///   can be a null pointer if they should not be recorded
+    /// </param>
+    public: ActivationScope(
+      const void *injector, std::size_t serviceIndex, std::vector<std::size_t> *dependencies
+    ) :
+      parent(current),
+      injector(injector),
+      serviceIndex(serviceIndex),
+      dependencies(dependencies) {
+      current = this;
     }
 
-    // Check if a factory for the service has been registered
-    ServiceFactoryMap::const_iterator factoryIt = this->factories.find(&serviceType);
-    if(factoryIt != this->factories.end()) {
+    /// <summary>Leaves the construction of the service again</summary>
+    public: ~ActivationScope() {
+      current = this->parent;
+    }
 
-      // Create the service instance and store it in the instance map
-      std::pair<ServiceInstanceMap::iterator, bool> result = this->instances.insert(
-        ServiceInstanceMap::value_type(&serviceType, factoryIt->second(*this))
-      );
-      //this->factories.erase(factoryIt);
+    /// <summary>Checks whether a service is already being constructed on this thread</summary>
+    /// <param name="injector">Service injector that would construct the service</param>
+    /// <param name="serviceIndex">Index of the service that would be constructed</param>
+    /// <returns>True if the service is being constructed somewhere up the call stack</returns>
+    public: static bool IsActive(const void *injector, std::size_t serviceIndex) {
+      for(const ActivationScope *scope = current; scope != nullptr; scope = scope->parent) {
+        if((scope->injector == injector) && (scope->serviceIndex == serviceIndex)) {
+          return true;
+        }
+      }
 
-      instanceIt = result.first;
-      return instanceIt->second;
+      return false;
     }
 
+    /// <summary>Records that the service being constructed requested another service</summary>
+    /// <param name="injector">Service injector that provided the other service</param>
+    /// <param name="serviceIndex">Index of the service that has been requested</param>
+    public: static void RecordDependency(const void *injector, std::size_t serviceIndex) {
+      const ActivationScope *scope = current;
+      if((scope == nullptr) || (scope->injector != injector)) {
+        return;
+      }
+      if(scope->dependencies == nullptr) {
+        return;
+      }
+
+      std::vector<std::size_t> &dependencies = *scope->dependencies;
+      if(std::find(dependencies.begin(), dependencies.end(), serviceIndex) == dependencies.end()) {
+        dependencies.push_back(serviceIndex);
+      }
+    }
+
+    /// <summary>Innermost service construction on the current thread</summary>
+    private: static thread_local const ActivationScope *current;
+
+    /// <summary>Service construction that led to this one</summary>
+    private: const ActivationScope *parent;
+    /// <summary>Service injector constructing the service</summary>
+    private: const void *injector;
+    /// <summary>Index of the service being constructed</summary>
+    private: std::size_t serviceIndex;
+    /// <summary>Receives the indices of the services requested during construction</summary>
+    private: std::vector<std::size_t> *dependencies;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  thread_local const ActivationScope *ActivationScope::current = nullptr;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Throws an exception reporting that a service is not known</summary>
+  /// <param name="serviceType">Type of the service that could not be provided</param>
+  [[noreturn]] void throwUnknownServiceError(const std::type_info &serviceType) {
+
     // We could attempt an ad-hoc service creation here, but there are several concerns
     // speaking against doing so: a) we don't have the type in template form anymore,
     // b) the service is not registered as a container singleton and creating a per-request
@@ -61,57 +128,277 @@ namespace Nuclex { namespace Support { namespace Services {
     std::string message = "Service '";
     message += serviceType.name();
     message += " is not known to the injector. Please register it before requesting.";
-    throw UnresolvedDependencyError(message);
+    throw Nuclex::Support::Services::UnresolvedDependencyError(message);
 
   }
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Throws an exception reporting that a service depends on itself</summary>
+  /// <param name="serviceType">Type of the service that depends on itself</param>
+  [[noreturn]] void throwCyclicDependencyError(const std::type_info &serviceType) {
+    std::string message = "Service '";
+    message += serviceType.name();
+    message += "' depends on itself, either directly or through its dependencies.";
+    throw Nuclex::Support::Services::UnresolvedDependencyError(message);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Services {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Any &LazyServiceInjector::Get(const std::type_info &serviceType) const {
+    return Get(GetServiceIndex(serviceType), serviceType);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   const Any &LazyServiceInjector::TryGet(const std::type_info &serviceType) const {
+    return TryGet(GetServiceIndex(serviceType), serviceType);
+  }
 
-    // Check if the service has already been constructed
-    ServiceInstanceMap::iterator instanceIt = this->instances.find(&serviceType);
-    if(instanceIt != this->instances.end()) {
-      return instanceIt->second;
+  // ------------------------------------------------------------------------------------------- //
+
+  Any LazyServiceInjector::Create(const std::type_info &serviceType) const {
+    return Create(GetServiceIndex(serviceType), serviceType);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Any &LazyServiceInjector::Get(
+    std::size_t serviceIndex, const std::type_info &serviceType
+  ) const {
+    const Any *instance = resolve(serviceIndex);
+    if(instance == nullptr) {
+      throwUnknownServiceError(serviceType);
     }
 
+    return *instance;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Any &LazyServiceInjector::TryGet(
+    std::size_t serviceIndex, const std::type_info &serviceType
+  ) const {
+    (void)serviceType;
+
+    const Any *instance = resolve(serviceIndex);
+    if(instance == nullptr) {
+      return Any::Empty; // Could not resolve, so return nothing
+    }
+
+    return *instance;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  Any LazyServiceInjector::Create(
+    std::size_t serviceIndex, const std::type_info &serviceType
+  ) const {
+
     // Check if a factory for the service has been registered
-    ServiceFactoryMap::const_iterator factoryIt = this->factories.find(&serviceType);
-    if(factoryIt != this->factories.end()) {
+    ServiceSlot *slot = getSlot(serviceIndex);
+    if((slot != nullptr) && (slot->Factory != nullptr)) {
+      if(ActivationScope::IsActive(this, serviceIndex)) {
+        throwCyclicDependencyError(serviceType);
+      }
+
+      // A created instance isn't stored in the slot, so nothing guards the slot's
+      // dependency list here. It is recorded when the shared instance is constructed.
+      ActivationScope scope(this, serviceIndex, nullptr);
+      return slot->Factory(*this);
+    }
+
+    throwUnknownServiceError(serviceType);
+
+  }
 
-      // Create the service instance and store it in the instance map
-      std::pair<ServiceInstanceMap::iterator, bool> result = this->instances.insert(
-        ServiceInstanceMap::value_type(&serviceType, factoryIt->second(*this))
-      );
-      this->factories.erase(factoryIt);
+  // ------------------------------------------------------------------------------------------- //
 
-      instanceIt = result.first;
-      return instanceIt->second;
+  void LazyServiceInjector::InstantiateAll(std::size_t threadCount) {
+    if(!this->isConcurrent) {
+      threadCount = 1;
+    } else if(threadCount == 0) {
+      threadCount = std::thread::hardware_concurrency();
+      if(threadCount == 0) {
+        threadCount = 1;
+      }
     }
 
-    // Could not resolve, so return nothing
-    return Any::Empty;
+    // Each thread claims the next slot nobody has looked at yet. Slots of services which
+    // were already constructed as dependencies of an earlier service are simply skipped.
+    std::size_t slotCount = this->slots.size();
+    std::atomic<std::size_t> nextSlotIndex(0);
+    std::atomic<bool> hasFailed(false);
+    std::exception_ptr firstError;
+    std::mutex firstErrorMutex;
+
+    auto constructServices = [&, this]() {
+      while(!hasFailed.load(std::memory_order_relaxed)) {
+        std::size_t slotIndex = nextSlotIndex.fetch_add(1, std::memory_order_relaxed);
+        if(slotIndex >= slotCount) {
+          return;
+        }
+
+        ServiceSlot &slot = this->slots[slotIndex];
+        if((slot.Factory == nullptr) || slot.IsActivated.load(std::memory_order_acquire)) {
+          continue;
+        }
 
+        try {
+          activate(slotIndex, slot);
+        }
+        catch(...) {
+          std::lock_guard<std::mutex> firstErrorScope(firstErrorMutex);
+          if(!firstError) {
+            firstError = std::current_exception();
+          }
+          hasFailed.store(true, std::memory_order_relaxed);
+          return;
+        }
+      }
+    };
+
+    // If the system refuses to give us more threads, work with what we've got
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    try {
+      for(std::size_t index = 1; index < threadCount; ++index) {
+        threads.emplace_back(constructServices);
+      }
+    }
+    catch(const std::system_error &) {}
+
+    constructServices();
+    for(std::size_t index = 0; index < threads.size(); ++index) {
+      threads[index].join();
+    }
+
+    if(firstError) {
+      std::rethrow_exception(firstError);
+    }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  Any LazyServiceInjector::Create(const std::type_info &serviceType) const {
+  void LazyServiceInjector::addFactory(
+    std::size_t serviceIndex, const std::type_info &serviceType,
+    CreateServiceFunction factory
+  ) {
+    ServiceSlot &slot = getOrAddSlot(serviceIndex);
+    slot.ServiceType = &serviceType;
+
+    // Like the std::map::insert() this replaced, earlier bindings take precedence
+    if(slot.Factory == nullptr) {
+      slot.Factory = factory;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void LazyServiceInjector::addInstance(
+    std::size_t serviceIndex, const std::type_info &serviceType, const Any &instance
+  ) {
+    ServiceSlot &slot = getOrAddSlot(serviceIndex);
+    slot.ServiceType = &serviceType;
+
+    if(!slot.IsActivated.load(std::memory_order_relaxed)) {
+      slot.Instance = instance;
+      slot.IsActivated.store(true, std::memory_order_release);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::vector<const std::type_info *> LazyServiceInjector::getDependencies(
+    std::size_t serviceIndex
+  ) const {
+    std::vector<const std::type_info *> dependencies;
+
+    ServiceSlot *slot = getSlot(serviceIndex);
+    if(slot != nullptr) {
+      dependencies.reserve(slot->Dependencies.size());
+      for(std::size_t index = 0; index < slot->Dependencies.size(); ++index) {
+        dependencies.push_back(this->slots[slot->Dependencies[index]].ServiceType);
+      }
+    }
+
+    return dependencies;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  LazyServiceInjector::ServiceSlot &LazyServiceInjector::getOrAddSlot(
+    std::size_t serviceIndex
+  ) {
+    while(serviceIndex >= this->slots.size()) {
+      this->slots.emplace_back();
+    }
+
+    return this->slots[serviceIndex];
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Any *LazyServiceInjector::resolve(std::size_t serviceIndex) const {
+    ServiceSlot *slot = getSlot(serviceIndex);
+    if(slot == nullptr) {
+      return nullptr;
+    }
+
+    // Check if the service has already been constructed
+    if(slot->IsActivated.load(std::memory_order_acquire)) {
+      ActivationScope::RecordDependency(this, serviceIndex);
+      return &slot->Instance;
+    }
 
     // Check if a factory for the service has been registered
-    ServiceFactoryMap::const_iterator factoryIt = this->factories.find(&serviceType);
-    if(factoryIt != this->factories.end()) {
-      return factoryIt->second(*this);
+    if(slot->Factory != nullptr) {
+      const Any &instance = activate(serviceIndex, *slot);
+      ActivationScope::RecordDependency(this, serviceIndex);
+      return &instance;
     }
 
-    // We could attempt an ad-hoc service creation here, but there are several concerns
-    // speaking against doing so: a) we don't have the type in template form anymore,
-    // b) the service is not registered as a container singleton and creating a per-request
-    // service would be confusing.
-    std::string message = "Service '";
-    message += serviceType.name();
-    message += " is not known to the injector. Please register it before requesting.";
-    throw UnresolvedDependencyError(message);
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Any &LazyServiceInjector::activate(std::size_t serviceIndex, ServiceSlot &slot) const {
+
+    // If this service is already being constructed further up the call stack, it
+    // depends on itself. This also has to be checked before taking the lock because
+    // the thread would otherwise wait for itself.
+    if(ActivationScope::IsActive(this, serviceIndex)) {
+      throwCyclicDependencyError(*slot.ServiceType);
+    }
+
+    std::unique_lock<std::mutex> activationLock(slot.ActivationMutex, std::defer_lock);
+    if(this->isConcurrent) {
+      activationLock.lock();
+
+      // Another thread may have constructed the service while we were waiting
+      if(slot.IsActivated.load(std::memory_order_acquire)) {
+        return slot.Instance;
+      }
+    }
+
+    // Construct the service. It will request its own dependencies from us, which
+    // may construct further services, but only from other slots. The slot is ours
+    // alone until the instance is published, so it can collect the dependencies.
+    {
+      slot.Dependencies.clear();
+      ActivationScope scope(this, serviceIndex, &slot.Dependencies);
+      slot.Instance = slot.Factory(*this);
+    }
+    slot.IsActivated.store(true, std::memory_order_release);
+
+    return slot.Instance;
 
   }
 
@@ -23,51 +23,94 @@ License along with this library
 
 #include "Nuclex/Support/Services/ServiceContainer.h"
 
+#include <stdexcept> // for std::runtime_error
+
 namespace Nuclex { namespace Support { namespace Services {
 
   // ------------------------------------------------------------------------------------------- //
 
   const Any &ServiceContainer::Get(const std::type_info &serviceType) const {
-    ServiceMap::const_iterator iterator = this->services.find(&serviceType);
-    if(iterator == this->services.end()) {
-      throw std::runtime_error("Unknown service type");
+    return Get(GetServiceIndex(serviceType), serviceType);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Any &ServiceContainer::TryGet(const std::type_info &serviceType) const {
+    return TryGet(GetServiceIndex(serviceType), serviceType);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const Any &ServiceContainer::Get(
+    std::size_t serviceIndex, const std::type_info &serviceType
+  ) const {
+    (void)serviceType;
+
+    if(serviceIndex < this->services.size()) {
+      const Any &service = this->services[serviceIndex];
+      if(service.HasValue()) {
+        return service;
+      }
     }
 
-    return iterator->second;
+    throw std::runtime_error("Unknown service type");
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  const Any &ServiceContainer::TryGet(const std::type_info &serviceType) const {
-    ServiceMap::const_iterator iterator = this->services.find(&serviceType);
-    if(iterator == this->services.end()) {
-      return Any::Empty;
+  const Any &ServiceContainer::TryGet(
+    std::size_t serviceIndex, const std::type_info &serviceType
+  ) const {
+    (void)serviceType;
+
+    if(serviceIndex < this->services.size()) {
+      return this->services[serviceIndex];
     } else {
-      return iterator->second;
+      return Any::Empty;
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   void ServiceContainer::Add(const std::type_info &serviceType, const Any &service) {
-    ServiceMap::const_iterator iterator = this->services.find(&serviceType);
-    if(iterator != this->services.end()) {
+    Add(GetServiceIndex(serviceType), service);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool ServiceContainer::Remove(const std::type_info &serviceType) {
+    return Remove(GetServiceIndex(serviceType));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ServiceContainer::Add(std::size_t serviceIndex, const Any &service) {
+    if(serviceIndex >= this->services.size()) {
+      this->services.resize(serviceIndex + 1);
+    } else if(this->services[serviceIndex].HasValue()) {
       throw std::runtime_error("Service has already been registered");
     }
 
-    this->services.insert(ServiceMap::value_type(&serviceType, service));
+    this->services[serviceIndex] = service;
+    ++this->serviceCount;
   }
 
   // ------------------------------------------------------------------------------------------- //
 
-  bool ServiceContainer::Remove(const std::type_info &serviceType) {
-    ServiceMap::const_iterator iterator = this->services.find(&serviceType);
-    if(iterator == this->services.end()) {
+  bool ServiceContainer::Remove(std::size_t serviceIndex) {
+    if(serviceIndex >= this->services.size()) {
       return false;
-    } else {
-      this->services.erase(iterator);
-      return true;
     }
+
+    Any &service = this->services[serviceIndex];
+    if(!service.HasValue()) {
+      return false;
+    }
+
+    service.Reset();
+    --this->serviceCount;
+    ++this->invalidationCount;
+    return true;
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -0,0 +1,77 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Services/ServiceIndex.h"
+
+#include <mutex> // for std::mutex
+#include <typeindex> // for std::type_index
+#include <unordered_map> // for std::unordered_map
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hands out the indices of service types</summary>
+  class ServiceIndexRegistry {
+
+    /// <summary>Returns the global registry for service indices</summary>
+    /// <returns>The global service index registry</returns>
+    public: static ServiceIndexRegistry &GetInstance() {
+      static ServiceIndexRegistry instance;
+      return instance;
+    }
+
+    /// <summary>Looks up or assigns the index of the specified service type</summary>
+    /// <param name="serviceType">Type of service whose index will be looked up</param>
+    /// <returns>The index of the specified service type</returns>
+    public: std::size_t GetIndex(const std::type_info &serviceType) {
+      std::lock_guard<std::mutex> indicesScope(this->indicesMutex);
+
+      // The next free index is the number of types registered so far. emplace() will
+      // not overwrite the existing index if the type has been registered before.
+      std::size_t nextIndex = this->indices.size();
+      return this->indices.emplace(std::type_index(serviceType), nextIndex).first->second;
+    }
+
+    /// <summary>Must be held while accessing the indices</summary>
+    private: std::mutex indicesMutex;
+    /// <summary>Indices that have been assigned to service types so far</summary>
+    private: std::unordered_map<std::type_index, std::size_t> indices;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Services {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t GetServiceIndex(const std::type_info &serviceType) {
+    return ServiceIndexRegistry::GetInstance().GetIndex(serviceType);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Services
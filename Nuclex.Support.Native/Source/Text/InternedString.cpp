@@ -0,0 +1,188 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/InternedString.h"
+#include "Nuclex/Support/Collections/FlatHashMap.h"
+
+#include <cstring> // for std::memcmp(), std::strlen()
+#include <deque> // for std::deque
+#include <mutex> // for std::mutex, std::lock_guard
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of independently locked parts the intern table is split into</summary>
+  /// <remarks>
+  ///   Threads interning different texts usually hit different shards and don't
+  ///   have to wait for each other.
+  /// </remarks>
+  const std::size_t ShardCount = 16;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Calculates the hash of a text</summary>
+  /// <param name="text">Text whose hash will be calculated</param>
+  /// <param name="length">Length of the text in bytes</param>
+  /// <returns>The hash of the text</returns>
+  std::size_t calculateHash(const char *text, std::size_t length) {
+    std::size_t hash = 2166136261U; // FNV-1a, good enough for names and keys
+    for(std::size_t index = 0; index < length; ++index) {
+      hash = (hash ^ static_cast<unsigned char>(text[index])) * 16777619U;
+    }
+    return hash;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Text looked up in the intern table without copying it</summary>
+  struct TextKey {
+
+    /// <summary>Characters of the text, not necessarily zero-terminated</summary>
+    public: const char *Characters;
+    /// <summary>Length of the text in bytes</summary>
+    public: std::size_t Length;
+    /// <summary>Hash of the text</summary>
+    public: std::size_t Hash;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Hashes text keys by handing out their precalculated hash</summary>
+  struct TextKeyHash {
+
+    /// <summary>Returns the hash of a text key</summary>
+    /// <param name="key">Text key whose hash will be returned</param>
+    /// <returns>The hash of the text key</returns>
+    public: std::size_t operator()(const TextKey &key) const {
+      return key.Hash;
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compares text keys by their contents</summary>
+  struct TextKeyEquality {
+
+    /// <summary>Checks whether two text keys hold the same text</summary>
+    /// <param name="left">First text key that will be compared</param>
+    /// <param name="right">Second text key that will be compared</param>
+    /// <returns>True if both text keys hold the same text</returns>
+    public: bool operator()(const TextKey &left, const TextKey &right) const {
+      return (
+        (left.Hash == right.Hash) &&
+        (left.Length == right.Length) &&
+        (std::memcmp(left.Characters, right.Characters, left.Length) == 0)
+      );
+    }
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  InternedString::InternedString() :
+    entry(nullptr) {
+
+    // Default-constructed strings are common (arrays, members), so skip the lock for them
+    static const Entry *const emptyEntry = intern(u8"", 0);
+    this->entry = emptyEntry;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  InternedString::InternedString(const std::string &text) :
+    entry(intern(text.c_str(), text.length())) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  InternedString::InternedString(const char *text) :
+    entry(intern(text, std::strlen(text))) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  InternedString::InternedString(const char *text, std::size_t length) :
+    entry(intern(text, length)) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const InternedString::Entry *InternedString::intern(const char *text, std::size_t length) {
+
+    /// <summary>Part of the intern table protected by its own lock</summary>
+    struct Shard {
+
+      /// <summary>Must be held while looking up or adding texts</summary>
+      public: std::mutex Mutex;
+      /// <summary>Entries of all texts interned in this shard</summary>
+      /// <remarks>
+      ///   A deque never moves its elements when it grows, so the entries keep
+      ///   their addresses for the lifetime of the process.
+      /// </remarks>
+      public: std::deque<Entry> Entries;
+      /// <summary>Looks up entries by their text</summary>
+      public: Collections::FlatHashMap<
+        TextKey, const Entry *, TextKeyHash, TextKeyEquality
+      > Lookup;
+
+    };
+
+    // Constructed on first use, so interned strings can be global variables, too
+    static Shard shards[ShardCount];
+
+    TextKey key;
+    key.Characters = text;
+    key.Length = length;
+    key.Hash = calculateHash(text, length);
+
+    Shard &shard = shards[(key.Hash ^ (key.Hash >> 16)) % ShardCount];
+    {
+      std::lock_guard<std::mutex> shardLock(shard.Mutex);
+
+      const Entry *const *existing = shard.Lookup.TryGet(key);
+      if(existing != nullptr) {
+        return *existing;
+      }
+
+      shard.Entries.emplace_back();
+      Entry &added = shard.Entries.back();
+      added.Text.assign(text, length);
+      added.Hash = key.Hash;
+
+      // Point the key to the interned copy, the caller's text may go away
+      key.Characters = added.Text.c_str();
+      shard.Lookup.TryInsert(key, &added);
+
+      return &added;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
@@ -27,6 +27,8 @@ License along with this library
 #include "Erthink/erthink_u2a.h"
 #include "Ryu/ryu_parse.h"
 
+#include <algorithm> // for std::copy()
+#include <cstring> // for std::memcpy(), std::strlen()
 #include <limits> // for std::numeric_limits
 
 // Goal: print floating-point values accurately, locale-independent and without exponent
@@ -93,6 +95,478 @@ License along with this library
 //   o glibc - decent, but GPL
 //
 
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints a value into a range of characters if it fits</summary>
+  /// <typeparam name="TValue">Type of value that will be printed</typeparam>
+  /// <param name="first">Address of the first character the value can be printed to</param>
+  /// <param name="last">Address one past the last character available for printing</param>
+  /// <param name="value">Value that will be printed</param>
+  /// <param name="maximumLength">Number of characters the value can take at most</param>
+  /// <returns>The end of the printed text or an error if the value didn't fit</returns>
+  template<typename TValue>
+  Nuclex::Support::Text::lexical_print_result printIntoRange(
+    char *first, char *last, TValue value, std::size_t maximumLength
+  ) {
+    using Nuclex::Support::Text::lexical_print;
+    using Nuclex::Support::Text::MaximumLexicalPrintLength;
+
+    // If the range is large enough for any value of the type, print directly into it
+    std::size_t availableLength = static_cast<std::size_t>(last - first);
+    if(availableLength >= maximumLength) {
+      return { lexical_print(value, first), std::errc() };
+    }
+
+    // Otherwise, print into a stack buffer first and only copy it over if it fits
+    char characters[MaximumLexicalPrintLength];
+    char *end = lexical_print(value, characters);
+    if(static_cast<std::size_t>(end - characters) > availableLength) {
+      return { last, std::errc::value_too_large };
+    } else {
+      return { std::copy(characters, end, first), std::errc() };
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_SUPPORT_LITTLE_ENDIAN)
+  /// <summary>Checks whether 8 characters are all decimal digits</summary>
+  /// <param name="characters">8 characters packed into an integer in memory order</param>
+  /// <returns>True if all 8 characters are decimal digits</returns>
+  inline bool areEightDigits(std::uint64_t characters) {
+    return (
+      ((characters & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL) &&
+      (((characters + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL)
+    );
+  }
+#endif
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_SUPPORT_LITTLE_ENDIAN)
+  /// <summary>Converts 8 decimal digits into their numeric value at once</summary>
+  /// <param name="characters">8 decimal digits packed into an integer in memory order</param>
+  /// <returns>The value of the 8 digit number</returns>
+  /// <remarks>
+  ///   Combines neighbouring digits into 2 digit numbers, those into 4 digit numbers
+  ///   and those into the final 8 digit number, each step with a single multiplication.
+  /// </remarks>
+  inline std::uint32_t parseEightDigits(std::uint64_t characters) {
+    characters -= 0x3030303030303030ULL;
+    characters = (characters * 10) + (characters >> 8);
+    characters = (
+      ((characters & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+      (((characters >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))
+    ) >> 32;
+    return static_cast<std::uint32_t>(characters);
+  }
+#endif
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses the decimal digits at the beginning of a range of characters</summary>
+  /// <param name="current">Start of the digits, will be moved past the last digit</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="magnitude">Receives the value of the parsed digits</param>
+  /// <returns>False if the digits form a number that doesn't fit in 64 bits</returns>
+  bool parseMagnitude(const char *&current, const char *last, std::uint64_t &magnitude) {
+    while((current < last) && (*current == '0')) {
+      ++current;
+    }
+
+    // Any number with up to 19 digits fits in 64 bits, so these can be taken in blocks
+    // of 8 digits without checking for overflow
+    std::uint64_t result = 0;
+    std::size_t digitCount = 0;
+#if defined(NUCLEX_SUPPORT_LITTLE_ENDIAN)
+    while(((last - current) >= 8) && (digitCount <= 11)) {
+      std::uint64_t characters;
+      std::memcpy(&characters, current, 8);
+      if(!areEightDigits(characters)) {
+        break;
+      }
+
+      result = (result * 100000000ULL) + parseEightDigits(characters);
+      digitCount += 8;
+      current += 8;
+    }
+#endif
+
+    bool fits = true;
+    while(current < last) {
+      unsigned int digit = static_cast<unsigned char>(*current) - static_cast<unsigned int>('0');
+      if(digit > 9) {
+        break;
+      }
+
+      // The 20th digit may overflow, anything beyond it certainly does
+      if(digitCount < 19) {
+        result = (result * 10) + digit;
+      } else if(digitCount == 19) {
+        const std::uint64_t limit = std::numeric_limits<std::uint64_t>::max() / 10;
+        if((result < limit) || ((result == limit) && (digit <= 5))) {
+          result = (result * 10) + digit;
+        } else {
+          fits = false;
+        }
+      } else {
+        fits = false;
+      }
+
+      ++digitCount;
+      ++current;
+    }
+
+    magnitude = result;
+    return fits;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses an unsigned integer from a range of characters</summary>
+  /// <typeparam name="TInteger">Type of unsigned integer that will be parsed</typeparam>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  template<typename TInteger>
+  Nuclex::Support::Text::lexical_parse_result parseUnsignedInteger(
+    const char *first, const char *last, TInteger &value
+  ) {
+    if((first == last) || (static_cast<unsigned char>(*first - '0') > 9)) {
+      return { first, std::errc::invalid_argument };
+    }
+
+    const char *current = first;
+    std::uint64_t magnitude;
+    bool fits = parseMagnitude(current, last, magnitude);
+    if(!fits || (magnitude > std::numeric_limits<TInteger>::max())) {
+      return { current, std::errc::result_out_of_range };
+    }
+
+    value = static_cast<TInteger>(magnitude);
+    return { current, std::errc() };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a signed integer from a range of characters</summary>
+  /// <typeparam name="TInteger">Type of signed integer that will be parsed</typeparam>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  template<typename TInteger>
+  Nuclex::Support::Text::lexical_parse_result parseSignedInteger(
+    const char *first, const char *last, TInteger &value
+  ) {
+    const char *current = first;
+    bool isNegative = ((current < last) && (*current == '-'));
+    if(isNegative) {
+      ++current;
+    }
+    if((current == last) || (static_cast<unsigned char>(*current - '0') > 9)) {
+      return { first, std::errc::invalid_argument };
+    }
+
+    // The negative range of two's complement integers reaches one further
+    std::uint64_t magnitude;
+    bool fits = parseMagnitude(current, last, magnitude);
+    std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<TInteger>::max());
+    if(isNegative) {
+      ++limit;
+    }
+    if(!fits || (magnitude > limit)) {
+      return { current, std::errc::result_out_of_range };
+    }
+
+    if(isNegative) {
+      value = static_cast<TInteger>(0 - magnitude);
+    } else {
+      value = static_cast<TInteger>(magnitude);
+    }
+    return { current, std::errc() };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decimal number split into its digits and power of ten</summary>
+  struct DecimalNumber {
+
+    /// <summary>Up to 19 significant digits of the number</summary>
+    public: std::uint64_t Mantissa;
+    /// <summary>Power of ten the mantissa needs to be multiplied with</summary>
+    public: std::int32_t Exponent;
+    /// <summary>Whether the number had a minus sign in front of it</summary>
+    public: bool IsNegative;
+    /// <summary>Whether the number had more significant digits than were kept</summary>
+    public: bool IsTruncated;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Scans a decimal number at the beginning of a range of characters</summary>
+  /// <param name="first">Address of the first character that will be scanned</param>
+  /// <param name="last">Address one past the last character that can be scanned</param>
+  /// <param name="number">Receives the digits and power of ten of the number</param>
+  /// <returns>
+  ///   The address one past the end of the number or a null pointer if the range
+  ///   doesn't begin with a number
+  /// </returns>
+  /// <remarks>
+  ///   Accepts an optional minus sign, digits with an optional decimal point and
+  ///   an optional exponent, which is only taken if digits follow it.
+  /// </remarks>
+  const char *scanDecimalNumber(const char *first, const char *last, DecimalNumber &number) {
+    const char *current = first;
+
+    number.Mantissa = 0;
+    number.Exponent = 0;
+    number.IsTruncated = false;
+    number.IsNegative = ((current < last) && (*current == '-'));
+    if(number.IsNegative) {
+      ++current;
+    }
+
+    // Collect the significant digits, leading zeros only shift the exponent
+    bool hasDigits = false;
+    std::size_t significantDigitCount = 0;
+    while(current < last) {
+      unsigned int digit = static_cast<unsigned char>(*current) - static_cast<unsigned int>('0');
+      if(digit > 9) {
+        break;
+      }
+
+      hasDigits = true;
+      if(significantDigitCount < 19) {
+        if((number.Mantissa != 0) || (digit != 0)) {
+          number.Mantissa = (number.Mantissa * 10) + digit;
+          ++significantDigitCount;
+        }
+      } else {
+        ++number.Exponent;
+        number.IsTruncated |= (digit != 0);
+      }
+      ++current;
+    }
+    if((current < last) && (*current == '.')) {
+      ++current;
+      while(current < last) {
+        unsigned int digit = static_cast<unsigned char>(*current) - static_cast<unsigned int>('0');
+        if(digit > 9) {
+          break;
+        }
+
+        hasDigits = true;
+        if(significantDigitCount < 19) {
+          if((number.Mantissa != 0) || (digit != 0)) {
+            number.Mantissa = (number.Mantissa * 10) + digit;
+            ++significantDigitCount;
+          }
+          --number.Exponent;
+        } else {
+          number.IsTruncated |= (digit != 0);
+        }
+        ++current;
+      }
+    }
+    if(!hasDigits) {
+      return nullptr;
+    }
+
+    // The exponent is optional and only counts if it actually has digits
+    if((current < last) && ((*current == 'e') || (*current == 'E'))) {
+      const char *exponentCurrent = current + 1;
+      bool isExponentNegative = false;
+      if((exponentCurrent < last) && ((*exponentCurrent == '-') || (*exponentCurrent == '+'))) {
+        isExponentNegative = (*exponentCurrent == '-');
+        ++exponentCurrent;
+      }
+
+      std::int32_t exponent = 0;
+      bool hasExponentDigits = false;
+      while(exponentCurrent < last) {
+        unsigned int digit = (
+          static_cast<unsigned char>(*exponentCurrent) - static_cast<unsigned int>('0')
+        );
+        if(digit > 9) {
+          break;
+        }
+
+        hasExponentDigits = true;
+        if(exponent < 100000) { // Way beyond the range of doubles, but can't overflow
+          exponent = (exponent * 10) + static_cast<std::int32_t>(digit);
+        }
+        ++exponentCurrent;
+      }
+
+      if(hasExponentDigits) {
+        number.Exponent += (isExponentNegative ? -exponent : exponent);
+        current = exponentCurrent;
+      }
+    }
+
+    return current;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a decimal number into the closest double precision value</summary>
+  /// <param name="number">Decimal number that will be converted</param>
+  /// <returns>The double precision floating point value closest to the number</returns>
+  /// <remarks>
+  ///   <para>
+  ///     Numbers whose digits fit into the 53 bit mantissa of a double and that have
+  ///     a small power of ten are calculated directly, because both the digits and
+  ///     the power of ten are exact in a double and a single multiplication or division
+  ///     is correctly rounded (Clinger's fast path).
+  ///     Nearly all numbers in configuration files and XML documents are like this.
+  ///   </para>
+  ///   <para>
+  ///     All other numbers are handed to Ryu. It takes at most 17 significant digits,
+  ///     so longer numbers have their remaining digits cut off.
+  ///   </para>
+  /// </remarks>
+  double doubleFromDecimalNumber(const DecimalNumber &number) {
+    static const double powersOfTen[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    double magnitude;
+    if(number.Mantissa == 0) {
+      magnitude = 0.0;
+    } else if(
+      !number.IsTruncated &&
+      (number.Mantissa <= (std::uint64_t(1) << 53)) &&
+      (number.Exponent >= -22) && (number.Exponent <= 22)
+    ) {
+      magnitude = static_cast<double>(number.Mantissa);
+      if(number.Exponent < 0) {
+        magnitude /= powersOfTen[-number.Exponent];
+      } else {
+        magnitude *= powersOfTen[number.Exponent];
+      }
+    } else {
+      std::uint64_t mantissa = number.Mantissa;
+      std::int32_t exponent = number.Exponent;
+      while(mantissa >= 100000000000000000ULL) {
+        mantissa /= 10;
+        ++exponent;
+      }
+
+      // Ryu can't take exponents with more than 4 digits, but values that far off
+      // are zero or infinity anyway
+      if(exponent < -400) {
+        magnitude = 0.0;
+      } else if(exponent > 400) {
+        magnitude = std::numeric_limits<double>::infinity();
+      } else {
+        char characters[32];
+        char *end = erthink::u2a(mantissa, characters);
+        *end++ = 'e';
+        end = erthink::i2a(exponent, end);
+
+        enum ::Status status = s2d_n(
+          characters, static_cast<int>(end - characters), &magnitude
+        );
+        if(status != SUCCESS) {
+          magnitude = std::numeric_limits<double>::quiet_NaN();
+        }
+      }
+    }
+
+    return number.IsNegative ? -magnitude : magnitude;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts a decimal number into the closest floating point value</summary>
+  /// <param name="number">Decimal number that will be converted</param>
+  /// <returns>The floating point value closest to the number</returns>
+  /// <remarks>
+  ///   Like with doubles, short numbers with small powers of ten are calculated
+  ///   directly. All others are converted to double precision and rounded from there.
+  /// </remarks>
+  float floatFromDecimalNumber(const DecimalNumber &number) {
+    static const float powersOfTen[] = {
+      1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    if(
+      !number.IsTruncated &&
+      (number.Mantissa <= (std::uint64_t(1) << 24)) &&
+      (number.Exponent >= -10) && (number.Exponent <= 10)
+    ) {
+      float magnitude = static_cast<float>(number.Mantissa);
+      if(number.Exponent < 0) {
+        magnitude /= powersOfTen[-number.Exponent];
+      } else {
+        magnitude *= powersOfTen[number.Exponent];
+      }
+      return number.IsNegative ? -magnitude : magnitude;
+    } else {
+      return static_cast<float>(doubleFromDecimalNumber(number));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a floating point value from a range of characters</summary>
+  /// <typeparam name="TFloat">Type of floating point value that will be parsed</typeparam>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="value">Receives the parsed value, left untouched on error</param>
+  /// <param name="convert">Function that converts the scanned number</param>
+  /// <returns>Where parsing stopped and whether a value was parsed</returns>
+  template<typename TFloat>
+  Nuclex::Support::Text::lexical_parse_result parseFloatingPoint(
+    const char *first, const char *last, TFloat &value,
+    TFloat (*convert)(const DecimalNumber &)
+  ) {
+    DecimalNumber number;
+    const char *end = scanDecimalNumber(first, last, number);
+    if(end == nullptr) {
+      return { first, std::errc::invalid_argument };
+    }
+
+    // Like std::from_chars(), report numbers too large or too small for the type
+    TFloat result = convert(number);
+    TFloat magnitude = number.IsNegative ? -result : result;
+    bool isOverflow = (magnitude == std::numeric_limits<TFloat>::infinity());
+    bool isUnderflow = ((magnitude == TFloat(0)) && (number.Mantissa != 0));
+    if(isOverflow || isUnderflow) {
+      return { end, std::errc::result_out_of_range };
+    }
+
+    value = result;
+    return { end, std::errc() };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a whole string as a floating point value</summary>
+  /// <typeparam name="TFloat">Type of floating point value that will be parsed</typeparam>
+  /// <param name="first">Address of the first character in the string</param>
+  /// <param name="last">Address one past the last character in the string</param>
+  /// <param name="convert">Function that converts the scanned number</param>
+  /// <returns>The parsed value or NaN if the string isn't a number</returns>
+  template<typename TFloat>
+  TFloat floatingPointFromString(
+    const char *first, const char *last, TFloat (*convert)(const DecimalNumber &)
+  ) {
+    DecimalNumber number;
+    const char *end = scanDecimalNumber(first, last, number);
+    if((end == nullptr) || (end != last)) {
+      return std::numeric_limits<TFloat>::quiet_NaN();
+    } else {
+      return convert(number);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
 namespace Nuclex { namespace Support { namespace Text {
 
   // ------------------------------------------------------------------------------------------- //
@@ -328,12 +802,9 @@ namespace Nuclex { namespace Support { namespace Text {
   // ------------------------------------------------------------------------------------------- //
 
   template<> std::string lexical_cast<>(const float &from) {
-    char characters[64];
-    tU32 length = ::PrintFloat32(
-      characters, sizeof(characters), from, PrintFloatFormat_Positional, -1
-    );
-
-    return std::string(static_cast<const char *>(characters), static_cast<std::size_t>(length));
+    char characters[MaximumLexicalPrintLength];
+    const char *end = lexical_print(from, characters);
+    return std::string(static_cast<const char *>(characters), end);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -342,38 +813,24 @@ namespace Nuclex { namespace Support { namespace Text {
     if(from == nullptr) {
       return 0.0f;
     } else {
-      double result;
-      enum ::Status status = s2d(from, &result);
-      if(status == SUCCESS) {
-        return static_cast<float>(result);
-      } else {
-        return std::numeric_limits<float>::quiet_NaN();
-      }
+      return floatingPointFromString(from, from + std::strlen(from), &floatFromDecimalNumber);
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   template<> float lexical_cast<>(const std::string &from) {
-    double result;
-    enum ::Status status = s2d_n(from.c_str(), static_cast<int>(from.length()), &result);
-    if(status == SUCCESS) {
-      return static_cast<float>(result);
-    } else {
-      return std::numeric_limits<float>::quiet_NaN();
-    }
-    //return std::stof(from);
+    return floatingPointFromString(
+      from.data(), from.data() + from.length(), &floatFromDecimalNumber
+    );
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   template<> std::string lexical_cast<>(const double &from) {
-    char characters[256];
-    tU32 length = ::PrintFloat64(
-      characters, sizeof(characters), from, PrintFloatFormat_Positional, -1
-    );
-
-    return std::string(static_cast<const char *>(characters), static_cast<std::size_t>(length));
+    char characters[MaximumLexicalPrintLength];
+    const char *end = lexical_print(from, characters);
+    return std::string(static_cast<const char *>(characters), end);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -382,27 +839,221 @@ namespace Nuclex { namespace Support { namespace Text {
     if(from == nullptr) {
       return 0.0;
     } else {
-      double result;
-      enum ::Status status = s2d(from, &result);
-      if(status == SUCCESS) {
-        return result;
-      } else {
-        return std::numeric_limits<double>::quiet_NaN();
-      }
+      return floatingPointFromString(from, from + std::strlen(from), &doubleFromDecimalNumber);
     }
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   template<> double lexical_cast<>(const std::string &from) {
-    double result;
-    enum ::Status status = s2d_n(from.c_str(), static_cast<int>(from.length()), &result);
-    if(status == SUCCESS) {
-      return result;
+    return floatingPointFromString(
+      from.data(), from.data() + from.length(), &doubleFromDecimalNumber
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(bool from, char *target) {
+    static const char trueCharacters[] = { 't', 'r', 'u', 'e' };
+    static const char falseCharacters[] = { 'f', 'a', 'l', 's', 'e' };
+
+    if(from) {
+      return std::copy(trueCharacters, trueCharacters + sizeof(trueCharacters), target);
     } else {
-      return std::numeric_limits<double>::quiet_NaN();
+      return std::copy(falseCharacters, falseCharacters + sizeof(falseCharacters), target);
     }
-    //return std::stof(from);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(std::uint8_t from, char *target) {
+    return erthink::u2a(static_cast<std::uint32_t>(from), target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(std::int8_t from, char *target) {
+    return erthink::i2a(static_cast<std::int32_t>(from), target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(std::uint16_t from, char *target) {
+    return erthink::u2a(static_cast<std::uint32_t>(from), target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(std::int16_t from, char *target) {
+    return erthink::i2a(static_cast<std::int32_t>(from), target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(std::uint32_t from, char *target) {
+    return erthink::u2a(from, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(std::int32_t from, char *target) {
+    return erthink::i2a(from, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(std::uint64_t from, char *target) {
+    return erthink::u2a(from, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(std::int64_t from, char *target) {
+    return erthink::i2a(from, target);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(float from, char *target) {
+    tU32 length = ::PrintFloat32(
+      target, MaximumLexicalPrintLength, from, PrintFloatFormat_Positional, -1
+    );
+    return target + length;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  char *lexical_print(double from, char *target) {
+    tU32 length = ::PrintFloat64(
+      target, MaximumLexicalPrintLength, from, PrintFloatFormat_Positional, -1
+    );
+    return target + length;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, bool value) {
+    return printIntoRange(first, last, value, 5);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, std::uint8_t value) {
+    return printIntoRange(first, last, value, 3);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, std::int8_t value) {
+    return printIntoRange(first, last, value, 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, std::uint16_t value) {
+    return printIntoRange(first, last, value, 5);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, std::int16_t value) {
+    return printIntoRange(first, last, value, 6);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, std::uint32_t value) {
+    return printIntoRange(first, last, value, 10);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, std::int32_t value) {
+    return printIntoRange(first, last, value, 11);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, std::uint64_t value) {
+    return printIntoRange(first, last, value, 20);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, std::int64_t value) {
+    return printIntoRange(first, last, value, 20);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, float value) {
+    return printIntoRange(first, last, value, MaximumLexicalPrintLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_print_result lexical_print(char *first, char *last, double value) {
+    return printIntoRange(first, last, value, MaximumLexicalPrintLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, std::uint8_t &value) {
+    return parseUnsignedInteger(first, last, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, std::int8_t &value) {
+    return parseSignedInteger(first, last, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, std::uint16_t &value) {
+    return parseUnsignedInteger(first, last, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, std::int16_t &value) {
+    return parseSignedInteger(first, last, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, std::uint32_t &value) {
+    return parseUnsignedInteger(first, last, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, std::int32_t &value) {
+    return parseSignedInteger(first, last, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, std::uint64_t &value) {
+    return parseUnsignedInteger(first, last, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, std::int64_t &value) {
+    return parseSignedInteger(first, last, value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, float &value) {
+    return parseFloatingPoint(first, last, value, &floatFromDecimalNumber);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  lexical_parse_result lexical_parse(const char *first, const char *last, double &value) {
+    return parseFloatingPoint(first, last, value, &doubleFromDecimalNumber);
   }
 
   // ------------------------------------------------------------------------------------------- //
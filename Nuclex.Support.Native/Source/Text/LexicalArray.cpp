@@ -0,0 +1,381 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/LexicalArray.h"
+
+#include <algorithm> // for std::count()
+#include <future> // for std::async(), std::future
+#include <thread> // for std::thread::hardware_concurrency()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of values below which arrays are always printed by one thread</summary>
+  const std::size_t MinimumValuesPerThread = 65536;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a character is a space, tab or line break</summary>
+  /// <param name="character">Character that will be checked</param>
+  /// <returns>True if the character is whitespace</returns>
+  bool isBlank(char character) {
+    return (
+      (character == ' ') || (character == '\t') || (character == '\r') || (character == '\n')
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Advances past any spaces, tabs and line breaks</summary>
+  /// <param name="first">Address of the first character that will be checked</param>
+  /// <param name="last">Address one past the last character that can be checked</param>
+  /// <returns>The address of the first character that is not whitespace</returns>
+  const char *skipBlanks(const char *first, const char *last) {
+    while((first < last) && isBlank(*first)) {
+      ++first;
+    }
+    return first;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of values into a string</summary>
+  /// <typeparam name="TValue">Type of the values that will be printed</typeparam>
+  /// <param name="values">Values that will be printed</param>
+  /// <param name="count">Number of values that will be printed</param>
+  /// <param name="target">String to which the printed values will be appended</param>
+  /// <param name="separator">Character that will be placed between the values</param>
+  template<typename TValue>
+  void formatArray(
+    const TValue *values, std::size_t count, std::string &target, char separator
+  ) {
+    using Nuclex::Support::Text::MaximumLexicalPrintLength;
+    using Nuclex::Support::Text::lexical_print;
+
+    if(count == 0) {
+      return;
+    }
+
+    // Guess a length that fits short numbers, the string grows if that turns out too small.
+    // Each value is printed directly behind the previous one without a temporary buffer.
+    std::size_t length = target.length();
+    target.resize(length + count * 8 + MaximumLexicalPrintLength);
+
+    for(std::size_t index = 0; index < count; ++index) {
+      if(target.length() - length <= MaximumLexicalPrintLength) {
+        target.resize(target.length() * 2 + MaximumLexicalPrintLength);
+      }
+
+      char *start = &target[0];
+      char *end = lexical_print(values[index], start + length);
+      *end = separator;
+      length = static_cast<std::size_t>(end - start) + 1;
+    }
+
+    // The last value got a separator, too, that is cut off here with the unused space
+    target.resize(length - 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Prints an array of values into a string using multiple threads</summary>
+  /// <typeparam name="TValue">Type of the values that will be printed</typeparam>
+  /// <param name="values">Values that will be printed</param>
+  /// <param name="count">Number of values that will be printed</param>
+  /// <param name="target">String to which the printed values will be appended</param>
+  /// <param name="separator">Character that will be placed between the values</param>
+  /// <param name="threadCount">Maximum number of threads, 0 for one per CPU core</param>
+  template<typename TValue>
+  void formatArrayInParallel(
+    const TValue *values, std::size_t count, std::string &target, char separator,
+    std::size_t threadCount
+  ) {
+    if(threadCount == 0) {
+      threadCount = std::thread::hardware_concurrency();
+    }
+
+    std::size_t chunkCount = count / MinimumValuesPerThread;
+    if(chunkCount > threadCount) {
+      chunkCount = threadCount;
+    }
+    if(chunkCount < 2) {
+      formatArray(values, count, target, separator);
+      return;
+    }
+
+    // Each chunk is printed into a string of its own, the calling thread takes the last one
+    std::size_t valuesPerChunk = (count + chunkCount - 1) / chunkCount;
+    std::vector<std::string> chunks(chunkCount - 1);
+    std::vector<std::future<void>> futures;
+    futures.reserve(chunkCount - 1);
+    for(std::size_t index = 0; index < chunkCount - 1; ++index) {
+      const TValue *chunkValues = values + index * valuesPerChunk;
+      std::string *chunk = &chunks[index];
+      futures.push_back(
+        std::async(
+          std::launch::async,
+          [chunkValues, valuesPerChunk, chunk, separator]() {
+            formatArray(chunkValues, valuesPerChunk, *chunk, separator);
+          }
+        )
+      );
+    }
+
+    std::string lastChunk;
+    {
+      std::size_t firstIndex = (chunkCount - 1) * valuesPerChunk;
+      formatArray(values + firstIndex, count - firstIndex, lastChunk, separator);
+    }
+
+    // Wait for all threads before touching anything so that they're done even if
+    // one of them failed, then join the chunks together
+    for(std::size_t index = 0; index < futures.size(); ++index) {
+      futures[index].wait();
+    }
+    for(std::size_t index = 0; index < futures.size(); ++index) {
+      futures[index].get();
+    }
+
+    std::size_t totalLength = target.length() + lastChunk.length();
+    for(std::size_t index = 0; index < chunks.size(); ++index) {
+      totalLength += chunks[index].length() + 1;
+    }
+    target.reserve(totalLength);
+    for(std::size_t index = 0; index < chunks.size(); ++index) {
+      target.append(chunks[index]);
+      target.push_back(separator);
+    }
+    target.append(lastChunk);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Parses a list of values separated by a character into an array</summary>
+  /// <typeparam name="TValue">Type of the values that will be parsed</typeparam>
+  /// <param name="first">Address of the first character that will be parsed</param>
+  /// <param name="last">Address one past the last character that can be parsed</param>
+  /// <param name="values">Vector to which the parsed values will be appended</param>
+  /// <param name="separator">Character that is expected between the values</param>
+  /// <returns>Where parsing stopped and, if the list was malformed, why</returns>
+  template<typename TValue>
+  Nuclex::Support::Text::lexical_parse_result parseArray(
+    const char *first, const char *last, std::vector<TValue> &values, char separator
+  ) {
+    using Nuclex::Support::Text::lexical_parse_result;
+    using Nuclex::Support::Text::lexical_parse;
+
+    // Counting the separators is much cheaper than growing the vector step by step
+    values.reserve(values.size() + std::count(first, last, separator) + 1);
+
+    bool separatorIsBlank = isBlank(separator);
+    first = skipBlanks(first, last);
+    while(first < last) {
+      TValue value;
+      lexical_parse_result result = lexical_parse(first, last, value);
+      if(result.ec != std::errc()) {
+        return result;
+      }
+      values.push_back(value);
+
+      first = skipBlanks(result.ptr, last);
+      if(first < last) {
+        if(*first == separator) {
+          first = skipBlanks(first + 1, last);
+          if(first == last) { // A separator without a value behind it
+            return lexical_parse_result { first, std::errc::invalid_argument };
+          }
+        } else if(!separatorIsBlank || (first == result.ptr)) {
+          return lexical_parse_result { first, std::errc::invalid_argument };
+        }
+      }
+    }
+
+    return lexical_parse_result { first, std::errc() };
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArray<std::int32_t>(
+    const std::int32_t *values, std::size_t count, std::string &target, char separator /* = ',' */
+  ) {
+    formatArray(values, count, target, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArray<std::uint32_t>(
+    const std::uint32_t *values, std::size_t count, std::string &target, char separator /* = ',' */
+  ) {
+    formatArray(values, count, target, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArray<std::int64_t>(
+    const std::int64_t *values, std::size_t count, std::string &target, char separator /* = ',' */
+  ) {
+    formatArray(values, count, target, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArray<std::uint64_t>(
+    const std::uint64_t *values, std::size_t count, std::string &target, char separator /* = ',' */
+  ) {
+    formatArray(values, count, target, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArray<float>(
+    const float *values, std::size_t count, std::string &target, char separator /* = ',' */
+  ) {
+    formatArray(values, count, target, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArray<double>(
+    const double *values, std::size_t count, std::string &target, char separator /* = ',' */
+  ) {
+    formatArray(values, count, target, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArrayInParallel<std::int32_t>(
+    const std::int32_t *values, std::size_t count, std::string &target, char separator /* = ',' */,
+    std::size_t threadCount /* = 0 */
+  ) {
+    formatArrayInParallel(values, count, target, separator, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArrayInParallel<std::uint32_t>(
+    const std::uint32_t *values, std::size_t count, std::string &target, char separator /* = ',' */,
+    std::size_t threadCount /* = 0 */
+  ) {
+    formatArrayInParallel(values, count, target, separator, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArrayInParallel<std::int64_t>(
+    const std::int64_t *values, std::size_t count, std::string &target, char separator /* = ',' */,
+    std::size_t threadCount /* = 0 */
+  ) {
+    formatArrayInParallel(values, count, target, separator, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArrayInParallel<std::uint64_t>(
+    const std::uint64_t *values, std::size_t count, std::string &target, char separator /* = ',' */,
+    std::size_t threadCount /* = 0 */
+  ) {
+    formatArrayInParallel(values, count, target, separator, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArrayInParallel<float>(
+    const float *values, std::size_t count, std::string &target, char separator /* = ',' */,
+    std::size_t threadCount /* = 0 */
+  ) {
+    formatArrayInParallel(values, count, target, separator, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> void FormatArrayInParallel<double>(
+    const double *values, std::size_t count, std::string &target, char separator /* = ',' */,
+    std::size_t threadCount /* = 0 */
+  ) {
+    formatArrayInParallel(values, count, target, separator, threadCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> lexical_parse_result ParseArray<std::int32_t>(
+    const char *first, const char *last, std::vector<std::int32_t> &values,
+    char separator /* = ',' */
+  ) {
+    return parseArray(first, last, values, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> lexical_parse_result ParseArray<std::uint32_t>(
+    const char *first, const char *last, std::vector<std::uint32_t> &values,
+    char separator /* = ',' */
+  ) {
+    return parseArray(first, last, values, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> lexical_parse_result ParseArray<std::int64_t>(
+    const char *first, const char *last, std::vector<std::int64_t> &values,
+    char separator /* = ',' */
+  ) {
+    return parseArray(first, last, values, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> lexical_parse_result ParseArray<std::uint64_t>(
+    const char *first, const char *last, std::vector<std::uint64_t> &values,
+    char separator /* = ',' */
+  ) {
+    return parseArray(first, last, values, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> lexical_parse_result ParseArray<float>(
+    const char *first, const char *last, std::vector<float> &values,
+    char separator /* = ',' */
+  ) {
+    return parseArray(first, last, values, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<> lexical_parse_result ParseArray<double>(
+    const char *first, const char *last, std::vector<double> &values,
+    char separator /* = ',' */
+  ) {
+    return parseArray(first, last, values, separator);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
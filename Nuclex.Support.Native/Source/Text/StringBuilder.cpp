@@ -0,0 +1,365 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/StringBuilder.h"
+#include "Nuclex/Support/Text/Lexical.h"
+
+#include <algorithm> // for std::max()
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of characters any integer up to 64 bits can take when printed</summary>
+  const std::size_t MaximumIntegerLength = 20;
+
+  /// <summary>Capacity the buffer starts out with when the first text is appended</summary>
+  const std::size_t MinimumCapacity = 64;
+
+  /// <summary>Hexadecimal digits used for JSON's \u escape sequences</summary>
+  const char HexDigits[] = u8"0123456789abcdef";
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Looks up the entity that replaces a character in escaped XML</summary>
+  /// <param name="character">Character whose entity will be looked up</param>
+  /// <returns>The entity for the character or a null pointer if it needs none</returns>
+  const char *getXmlEntity(char character) {
+    switch(character) {
+      case '<': { return u8"&lt;"; }
+      case '>': { return u8"&gt;"; }
+      case '&': { return u8"&amp;"; }
+      case '"': { return u8"&quot;"; }
+      case '\'': { return u8"&apos;"; }
+      default: { return nullptr; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a character has to be escaped inside a JSON string</summary>
+  /// <param name="character">Character that will be checked</param>
+  /// <returns>True if the character needs an escape sequence</returns>
+  bool needsJsonEscape(char character) {
+    return (
+      (static_cast<unsigned char>(character) < 0x20) || (character == '"') || (character == '\\')
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+  /// <summary>Checks whether 16 characters contain any that need to be escaped in XML</summary>
+  /// <param name="characters">Address of the characters that will be checked</param>
+  /// <returns>True if any of the characters needs to be replaced by an entity</returns>
+  bool containsXmlSpecialCharacters(const char *characters) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters));
+    __m128i special = _mm_or_si128(
+      _mm_or_si128(
+        _mm_cmpeq_epi8(block, _mm_set1_epi8('<')), _mm_cmpeq_epi8(block, _mm_set1_epi8('>'))
+      ),
+      _mm_or_si128(
+        _mm_or_si128(
+          _mm_cmpeq_epi8(block, _mm_set1_epi8('&')), _mm_cmpeq_epi8(block, _mm_set1_epi8('"'))
+        ),
+        _mm_cmpeq_epi8(block, _mm_set1_epi8('\''))
+      )
+    );
+    return (_mm_movemask_epi8(special) != 0);
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+  /// <summary>Checks whether 16 characters contain any that need to be escaped in JSON</summary>
+  /// <param name="characters">Address of the characters that will be checked</param>
+  /// <returns>True if any of the characters needs an escape sequence</returns>
+  bool containsJsonSpecialCharacters(const char *characters) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters));
+
+    // SSE2 only has signed byte comparisons, which would also flag UTF-8 sequences,
+    // but a byte is 0x1f or less exactly if the unsigned maximum with 0x1f is 0x1f
+    __m128i lastControlCharacter = _mm_set1_epi8(0x1f);
+    __m128i special = _mm_or_si128(
+      _mm_cmpeq_epi8(_mm_max_epu8(block, lastControlCharacter), lastControlCharacter),
+      _mm_or_si128(
+        _mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'))
+      )
+    );
+    return (_mm_movemask_epi8(special) != 0);
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StringBuilder::StringBuilder() :
+    characters(nullptr),
+    length(0),
+    capacity(0) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StringBuilder::StringBuilder(std::size_t capacity) :
+    characters(nullptr),
+    length(0),
+    capacity(0) {
+    Reserve(capacity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StringBuilder::StringBuilder(StringBuilder &&other) :
+    characters(other.characters),
+    length(other.length),
+    capacity(other.capacity) {
+    other.characters = nullptr;
+    other.length = 0;
+    other.capacity = 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StringBuilder::~StringBuilder() {
+    delete[] this->characters;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  StringBuilder &StringBuilder::operator =(StringBuilder &&other) {
+    if(&other != this) {
+      delete[] this->characters;
+
+      this->characters = other.characters;
+      this->length = other.length;
+      this->capacity = other.capacity;
+
+      other.characters = nullptr;
+      other.length = 0;
+      other.capacity = 0;
+    }
+
+    return *this;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  template<typename TValue>
+  void StringBuilder::appendNumber(TValue value, std::size_t maximumLength) {
+    ensureAvailable(maximumLength);
+
+    char *start = this->characters + this->length;
+    char *end = lexical_print(value, start);
+    this->length += static_cast<std::size_t>(end - start);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(bool value) {
+    appendNumber(value, 5);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(std::uint8_t value) {
+    appendNumber(value, MaximumIntegerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(std::int8_t value) {
+    appendNumber(value, MaximumIntegerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(std::uint16_t value) {
+    appendNumber(value, MaximumIntegerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(std::int16_t value) {
+    appendNumber(value, MaximumIntegerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(std::uint32_t value) {
+    appendNumber(value, MaximumIntegerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(std::int32_t value) {
+    appendNumber(value, MaximumIntegerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(std::uint64_t value) {
+    appendNumber(value, MaximumIntegerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(std::int64_t value) {
+    appendNumber(value, MaximumIntegerLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(float value) {
+    appendNumber(value, MaximumLexicalPrintLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::Append(double value) {
+    appendNumber(value, MaximumLexicalPrintLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::AppendXmlEscaped(const char *text, std::size_t count) {
+
+    // Reserve for the unescaped text up front, entities are rare enough to grow for
+    ensureAvailable(count);
+
+    // Skip over runs without special characters and copy them in one piece
+    std::size_t runStart = 0;
+    std::size_t index = 0;
+    while(index < count) {
+      std::size_t blockEnd = count;
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+      if(count - index >= 16) {
+        if(!containsXmlSpecialCharacters(text + index)) {
+          index += 16;
+          continue;
+        }
+        blockEnd = index + 16;
+      }
+#endif
+
+      // Either SSE2 spotted a special character in this block or we're at the tail
+      // end of the text, so look at the characters individually
+      for(; index < blockEnd; ++index) {
+        const char *entity = getXmlEntity(text[index]);
+        if(entity != nullptr) {
+          Append(text + runStart, index - runStart);
+          Append(entity);
+          runStart = index + 1;
+        }
+      }
+    }
+
+    Append(text + runStart, count - runStart);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::AppendJsonEscaped(const char *text, std::size_t count) {
+    ensureAvailable(count);
+
+    std::size_t runStart = 0;
+    std::size_t index = 0;
+    while(index < count) {
+      std::size_t blockEnd = count;
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+      if(count - index >= 16) {
+        if(!containsJsonSpecialCharacters(text + index)) {
+          index += 16;
+          continue;
+        }
+        blockEnd = index + 16;
+      }
+#endif
+
+      for(; index < blockEnd; ++index) {
+        char character = text[index];
+        if(!needsJsonEscape(character)) {
+          continue;
+        }
+
+        Append(text + runStart, index - runStart);
+        runStart = index + 1;
+
+        ensureAvailable(6);
+        char *target = this->characters + this->length;
+        target[0] = '\\';
+        switch(character) {
+          case '"': { target[1] = '"'; this->length += 2; break; }
+          case '\\': { target[1] = '\\'; this->length += 2; break; }
+          case '\b': { target[1] = 'b'; this->length += 2; break; }
+          case '\f': { target[1] = 'f'; this->length += 2; break; }
+          case '\n': { target[1] = 'n'; this->length += 2; break; }
+          case '\r': { target[1] = 'r'; this->length += 2; break; }
+          case '\t': { target[1] = 't'; this->length += 2; break; }
+          default: {
+            target[1] = 'u';
+            target[2] = '0';
+            target[3] = '0';
+            target[4] = HexDigits[static_cast<unsigned char>(character) >> 4];
+            target[5] = HexDigits[static_cast<unsigned char>(character) & 0x0f];
+            this->length += 6;
+            break;
+          }
+        }
+      }
+    }
+
+    Append(text + runStart, count - runStart);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringBuilder::grow(std::size_t requiredCapacity) {
+
+    // Double the capacity each time so appending stays amortized O(1)
+    std::size_t newCapacity = std::max(
+      std::max(requiredCapacity, this->capacity * 2), MinimumCapacity
+    );
+
+    char *newCharacters = new char[newCapacity];
+    if(this->length > 0) {
+      std::memcpy(newCharacters, this->characters, this->length);
+    }
+    delete[] this->characters;
+
+    this->characters = newCharacters;
+    this->capacity = newCapacity;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
@@ -22,147 +22,654 @@ License along with this library
 #define NUCLEX_SUPPORT_SOURCE 1
 
 #include "Nuclex/Support/Text/StringConverter.h"
+#include "Nuclex/Support/Text/Utf8Validator.h"
 
 #include "Utf8/checked.h"
+#include "Utf8/unchecked.h"
 #include "Utf8Fold/Utf8Fold.h"
 
-#include <vector>
+#include <algorithm> // for std::min()
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+#include <cstring> // for std::memcpy()
+#include <type_traits> // for std::conditional
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
 
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Selects the appropriate conversion for the compiler's wchar_t</summary>
-  template<std::size_t WCharWidth>
-  struct StringConverterCharWidthHelper {
+  /// <summary>Widens and narrows blocks of 16 ASCII characters</summary>
+  /// <typeparam name="WideCharWidth">Size of the wide characters in bytes</typeparam>
+  template<std::size_t WideCharWidth>
+  struct AsciiBlock;
 
-    /// <summary>Converts a UTF-8 string into a wide (UTF-16 or UTF-32) string</summary>
-    /// <param name="utf8String">UTF-8 string that will be converted</param>
-    /// <returns>A wide version of the provided UTF-8 string</returns>
-    /// <remarks>
-    ///   Assumes std::wstring has to carry either UTF-16 or UTF-32 based on the size of
-    ///   the compiler's wchar_t, thereby matching the default encoding used by your compiler
-    ///   and the defaults of any wide-character APIs on your platform.
-    /// </remarks>
-    inline static std::wstring WideFromUtf8(const std::string &from) = delete;
+  // ------------------------------------------------------------------------------------------- //
 
-    /// <summary>Converts a wide (UTF-16 or UTF-32) string into a UTF-8 string</summary>
-    /// <param name="wideString">Wide string that will be converted</param>
-    /// <returns>A UTF-8 version of the provided wide string</returns>
-    /// <remarks>
-    ///   Assumes the std::wstring is carrying either UTF-16 or UTF-32 based on the size of
-    ///   the compiler's wchar_t, thereby matching the default encoding used by your compiler
-    ///   when you write L&quot;Hello&quot; in your code.
-    /// </remarks>
-    inline static std::string Utf8FromWide(const std::wstring &from) = delete;
+  /// <summary>Widens and narrows blocks of 16 ASCII characters to and from UTF-16</summary>
+  template<>
+  struct AsciiBlock<sizeof(char16_t)> {
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+    /// <summary>Widens 16 ASCII characters into 16 bit characters</summary>
+    /// <param name="characters">ASCII characters that will be widened</param>
+    /// <param name="target">Receives the widened characters</param>
+    static void Widen(__m128i characters, void *target) {
+      const __m128i zero = _mm_setzero_si128();
+      __m128i *block = static_cast<__m128i *>(target);
+      _mm_storeu_si128(block, _mm_unpacklo_epi8(characters, zero));
+      _mm_storeu_si128(block + 1, _mm_unpackhi_epi8(characters, zero));
+    }
+
+    /// <summary>Narrows 16 characters to ASCII if all of them are ASCII characters</summary>
+    /// <param name="source">Characters that will be narrowed</param>
+    /// <param name="target">Receives the narrowed characters</param>
+    /// <returns>True if all characters were ASCII and have been narrowed</returns>
+    static bool TryNarrow(const void *source, std::uint8_t *target) {
+      const __m128i *block = static_cast<const __m128i *>(source);
+      __m128i low = _mm_loadu_si128(block);
+      __m128i high = _mm_loadu_si128(block + 1);
+
+      __m128i nonAsciiBits = _mm_and_si128(
+        _mm_or_si128(low, high), _mm_set1_epi16(static_cast<short>(0xFF80))
+      );
+      if(_mm_movemask_epi8(_mm_cmpeq_epi16(nonAsciiBits, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+      }
+
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_packus_epi16(low, high));
+      return true;
+    }
+#endif
 
   };
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Provides conversion methods between UTF-8 and UTF-16</summary>
+  /// <summary>Widens and narrows blocks of 16 ASCII characters to and from UTF-32</summary>
   template<>
-  struct StringConverterCharWidthHelper<sizeof(char16_t)> {
-
-    /// <summary>Converts a UTF-8 string into a UTF-16 string</summary>
-    /// <param name="utf8String">UTF-8 string that will be converted</param>
-    /// <returns>A wide version of the provided UTF-8 string</returns>
-    inline static std::wstring WideFromUtf8(const std::string &utf8String) {
-      if(utf8String.empty()) {
-        return std::wstring();
+  struct AsciiBlock<sizeof(char32_t)> {
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+    /// <summary>Widens 16 ASCII characters into 32 bit characters</summary>
+    /// <param name="characters">ASCII characters that will be widened</param>
+    /// <param name="target">Receives the widened characters</param>
+    static void Widen(__m128i characters, void *target) {
+      const __m128i zero = _mm_setzero_si128();
+      __m128i low = _mm_unpacklo_epi8(characters, zero);
+      __m128i high = _mm_unpackhi_epi8(characters, zero);
+
+      __m128i *block = static_cast<__m128i *>(target);
+      _mm_storeu_si128(block, _mm_unpacklo_epi16(low, zero));
+      _mm_storeu_si128(block + 1, _mm_unpackhi_epi16(low, zero));
+      _mm_storeu_si128(block + 2, _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128(block + 3, _mm_unpackhi_epi16(high, zero));
+    }
+
+    /// <summary>Narrows 16 characters to ASCII if all of them are ASCII characters</summary>
+    /// <param name="source">Characters that will be narrowed</param>
+    /// <param name="target">Receives the narrowed characters</param>
+    /// <returns>True if all characters were ASCII and have been narrowed</returns>
+    static bool TryNarrow(const void *source, std::uint8_t *target) {
+      const __m128i *block = static_cast<const __m128i *>(source);
+      __m128i first = _mm_loadu_si128(block);
+      __m128i second = _mm_loadu_si128(block + 1);
+      __m128i third = _mm_loadu_si128(block + 2);
+      __m128i fourth = _mm_loadu_si128(block + 3);
+
+      __m128i nonAsciiBits = _mm_and_si128(
+        _mm_or_si128(_mm_or_si128(first, second), _mm_or_si128(third, fourth)),
+        _mm_set1_epi32(static_cast<int>(0xFFFFFF80))
+      );
+      if(_mm_movemask_epi8(_mm_cmpeq_epi32(nonAsciiBits, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
       }
 
-      // We guess that we need as many UTF-16 characters as we needed UTF-8 characters
-      // based on the assumption that most text will only use ascii characters.
-      std::vector<wchar_t> utf16Characters;
-      utf16Characters.reserve(utf8String.length());
+      // All values are below 128, so the saturating packs just drop the zero bytes
+      __m128i low = _mm_packs_epi32(first, second);
+      __m128i high = _mm_packs_epi32(third, fourth);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_packus_epi16(low, high));
+      return true;
+    }
+#endif
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
 
-      // Do the conversion. If the vector was too short, it will be grown in factors
-      // of 2 usually (depending on the standard library implementation)
-      utf8::utf8to16(utf8String.begin(), utf8String.end(), std::back_inserter(utf16Characters));
+  /// <summary>Widens the ASCII characters at the beginning of a UTF-8 string</summary>
+  /// <typeparam name="TWideChar">Type of character the ASCII characters are widened to</typeparam>
+  /// <param name="source">UTF-8 characters that will be widened</param>
+  /// <param name="count">Number of UTF-8 characters available</param>
+  /// <param name="target">Receives the widened characters</param>
+  /// <returns>The number of ASCII characters that have been widened</returns>
+  /// <remarks>
+  ///   Stops at the first character that isn't ASCII. The target needs to have room for
+  ///   as many characters as there are in the source.
+  /// </remarks>
+  template<typename TWideChar>
+  std::size_t widenAscii(const std::uint8_t *source, std::size_t count, TWideChar *target) {
+    std::size_t index = 0;
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+    while(index + 16 <= count) {
+      __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index));
+      if(_mm_movemask_epi8(characters) != 0) {
+        break; // At least one byte has its high bit set
+      }
 
-      return std::wstring(&utf16Characters[0], utf16Characters.size());
+      AsciiBlock<sizeof(TWideChar)>::Widen(characters, target + index);
+      index += 16;
     }
+#else
+    while(index + 8 <= count) {
+      std::uint64_t characters;
+      std::memcpy(&characters, source + index, 8);
+      if((characters & 0x8080808080808080ULL) != 0) {
+        break; // At least one byte has its high bit set
+      }
 
-    /// <summary>Converts a UTF-16 string into a UTF-8 string</summary>
-    /// <param name="wideString">UTF-16 string that will be converted</param>
-    /// <returns>A UTF-8 version of the provided UTF-16 string</returns>
-    inline static std::string Utf8FromWide(const std::wstring &utf16String) {
-      if(utf16String.empty()) {
-        return std::string();
+      for(std::size_t offset = 0; offset < 8; ++offset) {
+        target[index + offset] = static_cast<TWideChar>(source[index + offset]);
       }
+      index += 8;
+    }
+#endif
 
-      // We guess that we need as many UTF-8 characters as we needed UTF-16 characters
-      // based on the assumption that most text will only use ascii characters.
-      std::vector<char> utf8Characters;
-      utf8Characters.reserve(utf16String.length());
+    while((index < count) && (source[index] < 0x80)) {
+      target[index] = static_cast<TWideChar>(source[index]);
+      ++index;
+    }
 
-      // Do the conversion. If the vector was too short, it will be grown in factors
-      // of 2 usually (depending on the standard library implementation)
-      utf8::utf16to8(
-        utf16String.begin(), utf16String.end(), std::back_inserter(utf8Characters)
-      );
+    return index;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-      return std::string(&utf8Characters[0], utf8Characters.size());
+  /// <summary>Narrows the ASCII characters at the beginning of a wide string</summary>
+  /// <typeparam name="TWideChar">Type of character the wide string consists of</typeparam>
+  /// <param name="source">Wide characters that will be narrowed</param>
+  /// <param name="count">Number of wide characters available</param>
+  /// <param name="target">Receives the narrowed characters</param>
+  /// <returns>The number of ASCII characters that have been narrowed</returns>
+  /// <remarks>
+  ///   Stops at the first character that isn't ASCII. The target needs to have room for
+  ///   as many characters as there are in the source.
+  /// </remarks>
+  template<typename TWideChar>
+  std::size_t narrowAscii(const TWideChar *source, std::size_t count, std::uint8_t *target) {
+    std::size_t index = 0;
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+    while(index + 16 <= count) {
+      if(!AsciiBlock<sizeof(TWideChar)>::TryNarrow(source + index, target + index)) {
+        break;
+      }
+      index += 16;
     }
+#endif
+
+    while(index < count) {
+      std::uint32_t character = static_cast<std::uint32_t>(source[index]);
+      if(character >= 0x80) {
+        break;
+      }
+      target[index] = static_cast<std::uint8_t>(character);
+      ++index;
+    }
+
+    return index;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Tracks how far a transcoder got through its source and target</summary>
+  struct TranscodeProgress {
+
+    /// <summary>Number of characters read from the source</summary>
+    public: std::size_t ReadCount;
+    /// <summary>Number of characters written into the target</summary>
+    public: std::size_t WrittenCount;
 
   };
 
   // ------------------------------------------------------------------------------------------- //
 
-  /// <summary>Provides conversion methods between UTF-8 and UTF-32</summary>
-  template<>
-  struct StringConverterCharWidthHelper<sizeof(char32_t)> {
-
-    /// <summary>Converts a UTF-8 string into a UTF-32 string</summary>
-    /// <param name="utf8String">UTF-8 string that will be converted</param>
-    /// <returns>A UTF-32 version of the provided UTF-8 string</returns>
-    inline static std::wstring WideFromUtf8(const std::string &utf8String) {
-      if(utf8String.empty()) {
-        return std::wstring();
+  /// <summary>Calculates the number of bytes a code point takes in UTF-8</summary>
+  /// <param name="codePoint">Code point whose length in UTF-8 will be calculated</param>
+  /// <returns>The number of bytes the code point takes when encoded as UTF-8</returns>
+  inline std::size_t getUtf8ByteCount(std::uint32_t codePoint) {
+    if(codePoint < 0x80) {
+      return 1;
+    } else if(codePoint < 0x800) {
+      return 2;
+    } else if(codePoint < 0x10000) {
+      return 3;
+    } else {
+      return 4;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Decodes the next code point from UTF-8 characters</summary>
+  /// <typeparam name="TValidated">
+  ///   Whether the characters are known to be valid UTF-8, in which case decoding
+  ///   skips all checks. Otherwise, invalid characters cause an exception.
+  /// </typeparam>
+  /// <param name="position">
+  ///   Position of the code point's first character, advanced past its last character
+  /// </param>
+  /// <param name="end">Address one past the last available character</param>
+  /// <returns>The decoded code point</returns>
+  template<bool TValidated>
+  inline std::uint32_t decodeUtf8(const std::uint8_t *&position, const std::uint8_t *end) {
+    if(TValidated) {
+      (void)end;
+      return utf8::unchecked::next(position);
+    } else {
+      return utf8::next(position, end);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts UTF-8 characters into UTF-16 characters</summary>
+  /// <typeparam name="TValidated">Whether the UTF-8 characters have been validated</typeparam>
+  template<bool TValidated>
+  struct Utf16FromUtf8Transcoder {
+
+    /// <summary>Type of characters the transcoder reads</summary>
+    typedef char SourceCharType;
+
+    /// <summary>Converts as many characters as fit into the target</summary>
+    /// <typeparam name="TUtf16Char">Type of characters the target consists of</typeparam>
+    /// <param name="source">UTF-8 characters that will be converted</param>
+    /// <param name="count">Number of UTF-8 characters in the source</param>
+    /// <param name="target">Receives the UTF-16 characters</param>
+    /// <param name="capacity">Number of characters the target can hold</param>
+    /// <param name="progress">
+    ///   Position in the source and target to continue at, updated to where
+    ///   the transcoder stopped
+    /// </param>
+    /// <remarks>
+    ///   UTF-16 never needs more characters than UTF-8 for the same text (4 byte UTF-8
+    ///   sequences become surrogate pairs), so a target with room for as many characters
+    ///   as the source has is always large enough.
+    /// </remarks>
+    template<typename TUtf16Char>
+    static void Transcode(
+      const char *source, std::size_t count,
+      TUtf16Char *target, std::size_t capacity,
+      TranscodeProgress &progress
+    ) {
+      const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(source);
+      while(progress.ReadCount < count) {
+        std::size_t availableCount = std::min(
+          count - progress.ReadCount, capacity - progress.WrittenCount
+        );
+        std::size_t asciiCount = widenAscii(
+          bytes + progress.ReadCount, availableCount, target + progress.WrittenCount
+        );
+        progress.ReadCount += asciiCount;
+        progress.WrittenCount += asciiCount;
+        if(progress.ReadCount == count) {
+          break;
+        }
+
+        const std::uint8_t *position = bytes + progress.ReadCount;
+        std::uint32_t codePoint = decodeUtf8<TValidated>(position, bytes + count);
+        if(codePoint > 0xFFFF) { // Make a surrogate pair
+          if(capacity - progress.WrittenCount < 2) {
+            break;
+          }
+          target[progress.WrittenCount++] = static_cast<TUtf16Char>(
+            (codePoint >> 10) + utf8::internal::LEAD_OFFSET
+          );
+          target[progress.WrittenCount++] = static_cast<TUtf16Char>(
+            (codePoint & 0x3FF) + utf8::internal::TRAIL_SURROGATE_MIN
+          );
+        } else {
+          if(capacity == progress.WrittenCount) {
+            break;
+          }
+          target[progress.WrittenCount++] = static_cast<TUtf16Char>(codePoint);
+        }
+        progress.ReadCount = static_cast<std::size_t>(position - bytes);
       }
+    }
 
-      // We guess that we need as many UTF-32 characters as we needed UTF-8 characters
-      // based on the assumption that most text will only use ascii characters.
-      std::vector<char32_t> utf32Characters;
-      utf32Characters.reserve(utf8String.length());
+  };
 
-      // Do the conversion. If the vector was too short, it will be grown in factors
-      // of 2 usually (depending on the standard library implementation)
-      utf8::utf8to32(utf8String.begin(), utf8String.end(), std::back_inserter(utf32Characters));
+  // ------------------------------------------------------------------------------------------- //
 
-      // This reinterpret_cast() avoids warnings on platforms with 16 bit wide chars
-      // (where it is never executed) and does nothing on platforms with 32 bit wide chars.
-      const wchar_t *first = reinterpret_cast<const wchar_t *>(&utf32Characters[0]);
-      return std::wstring(first, utf32Characters.size());
+  /// <summary>Converts UTF-8 characters into UTF-32 characters</summary>
+  /// <typeparam name="TValidated">Whether the UTF-8 characters have been validated</typeparam>
+  template<bool TValidated>
+  struct Utf32FromUtf8Transcoder {
+
+    /// <summary>Type of characters the transcoder reads</summary>
+    typedef char SourceCharType;
+
+    /// <summary>Converts as many characters as fit into the target</summary>
+    /// <typeparam name="TUtf32Char">Type of characters the target consists of</typeparam>
+    /// <param name="source">UTF-8 characters that will be converted</param>
+    /// <param name="count">Number of UTF-8 characters in the source</param>
+    /// <param name="target">Receives the UTF-32 characters</param>
+    /// <param name="capacity">Number of characters the target can hold</param>
+    /// <param name="progress">
+    ///   Position in the source and target to continue at, updated to where
+    ///   the transcoder stopped
+    /// </param>
+    /// <remarks>
+    ///   Each code point takes at least one byte in UTF-8, so a target with room for
+    ///   as many characters as the source has is always large enough.
+    /// </remarks>
+    template<typename TUtf32Char>
+    static void Transcode(
+      const char *source, std::size_t count,
+      TUtf32Char *target, std::size_t capacity,
+      TranscodeProgress &progress
+    ) {
+      const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(source);
+      while(progress.ReadCount < count) {
+        std::size_t availableCount = std::min(
+          count - progress.ReadCount, capacity - progress.WrittenCount
+        );
+        std::size_t asciiCount = widenAscii(
+          bytes + progress.ReadCount, availableCount, target + progress.WrittenCount
+        );
+        progress.ReadCount += asciiCount;
+        progress.WrittenCount += asciiCount;
+        if((progress.ReadCount == count) || (capacity == progress.WrittenCount)) {
+          break;
+        }
+
+        const std::uint8_t *position = bytes + progress.ReadCount;
+        target[progress.WrittenCount++] = static_cast<TUtf32Char>(
+          decodeUtf8<TValidated>(position, bytes + count)
+        );
+        progress.ReadCount = static_cast<std::size_t>(position - bytes);
+      }
     }
 
-    /// <summary>Converts a UTF-32 string into a UTF-8 string</summary>
-    /// <param name="wideString">UTF-32 string that will be converted</param>
-    /// <returns>A UTF-8 version of the provided UTF-32 string</returns>
-    inline static std::string Utf8FromWide(const std::wstring &utf32String) {
-      if(utf32String.empty()) {
-        return std::string();
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts UTF-16 characters into UTF-8 characters</summary>
+  /// <typeparam name="TUtf16Char">Type of characters the transcoder reads</typeparam>
+  template<typename TUtf16Char>
+  struct Utf8FromUtf16Transcoder {
+
+    /// <summary>Type of characters the transcoder reads</summary>
+    typedef TUtf16Char SourceCharType;
+
+    /// <summary>Converts as many characters as fit into the target</summary>
+    /// <param name="source">UTF-16 characters that will be converted</param>
+    /// <param name="count">Number of UTF-16 characters in the source</param>
+    /// <param name="target">Receives the UTF-8 characters</param>
+    /// <param name="capacity">Number of characters the target can hold</param>
+    /// <param name="progress">
+    ///   Position in the source and target to continue at, updated to where
+    ///   the transcoder stopped
+    /// </param>
+    /// <remarks>
+    ///   Stops before a code point that doesn't fit into the target anymore. A target with
+    ///   room for at least 4 more characters guarantees that the transcoder makes progress.
+    /// </remarks>
+    static void Transcode(
+      const TUtf16Char *source, std::size_t count,
+      char *target, std::size_t capacity,
+      TranscodeProgress &progress
+    ) {
+      while(progress.ReadCount < count) {
+        std::size_t availableCount = std::min(
+          count - progress.ReadCount, capacity - progress.WrittenCount
+        );
+        std::size_t asciiCount = narrowAscii(
+          source + progress.ReadCount, availableCount,
+          reinterpret_cast<std::uint8_t *>(target) + progress.WrittenCount
+        );
+        progress.ReadCount += asciiCount;
+        progress.WrittenCount += asciiCount;
+        if(progress.ReadCount == count) {
+          break;
+        }
+
+        // Take care of surrogate pairs first
+        std::size_t characterCount = 1;
+        std::uint32_t codePoint = utf8::internal::mask16(source[progress.ReadCount]);
+        if(utf8::internal::is_lead_surrogate(codePoint)) {
+          if(progress.ReadCount + 1 == count) {
+            throw utf8::invalid_utf16(static_cast<std::uint16_t>(codePoint));
+          }
+
+          std::uint32_t trailSurrogate = utf8::internal::mask16(source[progress.ReadCount + 1]);
+          if(!utf8::internal::is_trail_surrogate(trailSurrogate)) {
+            throw utf8::invalid_utf16(static_cast<std::uint16_t>(trailSurrogate));
+          }
+          codePoint = (codePoint << 10) + trailSurrogate + utf8::internal::SURROGATE_OFFSET;
+          characterCount = 2;
+        } else if(utf8::internal::is_trail_surrogate(codePoint)) { // Lone trail surrogate
+          throw utf8::invalid_utf16(static_cast<std::uint16_t>(codePoint));
+        }
+
+        std::size_t byteCount = getUtf8ByteCount(codePoint);
+        if(capacity - progress.WrittenCount < byteCount) {
+          break;
+        }
+        utf8::append(codePoint, target + progress.WrittenCount);
+        progress.ReadCount += characterCount;
+        progress.WrittenCount += byteCount;
       }
+    }
 
-      // We guess that we need as many UTF-8 characters as we needed UTF-32 characters
-      // based on the assumption that most text will only use ascii characters.
-      std::vector<char> utf8Characters;
-      utf8Characters.reserve(utf32String.length());
+  };
 
-      // Do the conversion. If the vector was too short, it will be grown in factors
-      // of 2 usually (depending on the standard library implementation)
-      utf8::utf32to8(
-        utf32String.begin(), utf32String.end(), std::back_inserter(utf8Characters)
-      );
+  // ------------------------------------------------------------------------------------------- //
 
-      return std::string(&utf8Characters[0], utf8Characters.size());
+  /// <summary>Converts UTF-32 characters into UTF-8 characters</summary>
+  /// <typeparam name="TUtf32Char">Type of characters the transcoder reads</typeparam>
+  template<typename TUtf32Char>
+  struct Utf8FromUtf32Transcoder {
+
+    /// <summary>Type of characters the transcoder reads</summary>
+    typedef TUtf32Char SourceCharType;
+
+    /// <summary>Converts as many characters as fit into the target</summary>
+    /// <param name="source">UTF-32 characters that will be converted</param>
+    /// <param name="count">Number of UTF-32 characters in the source</param>
+    /// <param name="target">Receives the UTF-8 characters</param>
+    /// <param name="capacity">Number of characters the target can hold</param>
+    /// <param name="progress">
+    ///   Position in the source and target to continue at, updated to where
+    ///   the transcoder stopped
+    /// </param>
+    /// <remarks>
+    ///   Stops before a code point that doesn't fit into the target anymore. A target with
+    ///   room for at least 4 more characters guarantees that the transcoder makes progress.
+    /// </remarks>
+    static void Transcode(
+      const TUtf32Char *source, std::size_t count,
+      char *target, std::size_t capacity,
+      TranscodeProgress &progress
+    ) {
+      while(progress.ReadCount < count) {
+        std::size_t availableCount = std::min(
+          count - progress.ReadCount, capacity - progress.WrittenCount
+        );
+        std::size_t asciiCount = narrowAscii(
+          source + progress.ReadCount, availableCount,
+          reinterpret_cast<std::uint8_t *>(target) + progress.WrittenCount
+        );
+        progress.ReadCount += asciiCount;
+        progress.WrittenCount += asciiCount;
+        if(progress.ReadCount == count) {
+          break;
+        }
+
+        std::uint32_t codePoint = static_cast<std::uint32_t>(source[progress.ReadCount]);
+        std::size_t byteCount = getUtf8ByteCount(codePoint);
+        if(capacity - progress.WrittenCount < byteCount) {
+          break;
+        }
+        utf8::append(codePoint, target + progress.WrittenCount);
+        progress.ReadCount += 1;
+        progress.WrittenCount += byteCount;
+      }
     }
 
   };
 
   // ------------------------------------------------------------------------------------------- //
 
+  /// <summary>Transcoder that converts UTF-8 into the compiler's wide characters</summary>
+  /// <remarks>
+  ///   Assumes std::wstring has to carry either UTF-16 or UTF-32 based on the size of
+  ///   the compiler's wchar_t, thereby matching the default encoding used by your compiler
+  ///   and the defaults of any wide-character APIs on your platform.
+  /// </remarks>
+  template<bool TValidated>
+  using WideFromUtf8Transcoder = typename std::conditional<
+    sizeof(wchar_t) == sizeof(char16_t),
+    Utf16FromUtf8Transcoder<TValidated>,
+    Utf32FromUtf8Transcoder<TValidated>
+  >::type;
+
+  /// <summary>Transcoder that converts the compiler's wide characters into UTF-8</summary>
+  typedef std::conditional<
+    sizeof(wchar_t) == sizeof(char16_t),
+    Utf8FromUtf16Transcoder<wchar_t>,
+    Utf8FromUtf32Transcoder<wchar_t>
+  >::type Utf8FromWideTranscoder;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts characters and appends them to a string</summary>
+  /// <typeparam name="TTranscoder">Transcoder that will convert the characters</typeparam>
+  /// <typeparam name="TTargetString">Type of string the characters will be appended to</typeparam>
+  /// <param name="target">String the converted characters will be appended to</param>
+  /// <param name="source">Characters that will be converted</param>
+  /// <param name="count">Number of characters that will be converted</param>
+  /// <remarks>
+  ///   The string is grown on the assumption that most text uses ASCII characters,
+  ///   which need one character in any UTF format, and only grown further if the
+  ///   converted text turns out to be longer.
+  /// </remarks>
+  template<typename TTranscoder, typename TTargetString>
+  void appendTranscoded(
+    TTargetString &target,
+    const typename TTranscoder::SourceCharType *source, std::size_t count
+  ) {
+    std::size_t startCount = target.size();
+    target.resize(startCount + count);
+
+    TranscodeProgress progress = { 0, 0 };
+    for(;;) {
+      TTranscoder::Transcode(
+        source, count, &target[0] + startCount, target.size() - startCount, progress
+      );
+      if(progress.ReadCount == count) {
+        break;
+      }
+
+      std::size_t remainingCount = count - progress.ReadCount;
+      target.resize(
+        startCount + progress.WrittenCount + remainingCount + remainingCount / 2 + 4
+      );
+    }
+
+    target.resize(startCount + progress.WrittenCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts characters into a buffer provided by the caller</summary>
+  /// <typeparam name="TTranscoder">Transcoder that will convert the characters</typeparam>
+  /// <typeparam name="TTargetChar">Type of characters the buffer consists of</typeparam>
+  /// <param name="source">Characters that will be converted</param>
+  /// <param name="count">Number of characters that will be converted</param>
+  /// <param name="buffer">Buffer that will receive the converted characters</param>
+  /// <param name="capacity">Number of characters the buffer can hold</param>
+  /// <returns>
+  ///   The number of characters written into the buffer or, if the buffer was too small,
+  ///   the number of characters the buffer would have needed
+  /// </returns>
+  template<typename TTranscoder, typename TTargetChar>
+  std::size_t transcodeIntoBuffer(
+    const typename TTranscoder::SourceCharType *source, std::size_t count,
+    TTargetChar *buffer, std::size_t capacity
+  ) {
+    TranscodeProgress progress = { 0, 0 };
+    TTranscoder::Transcode(source, count, buffer, capacity, progress);
+    if(progress.ReadCount == count) {
+      return progress.WrittenCount;
+    }
+
+    // The buffer is too small. Convert the rest into a scratch buffer to count how
+    // long it would be, which also reports invalid characters in the rest of the text.
+    std::size_t requiredCount = progress.WrittenCount;
+    TTargetChar scratch[256];
+    while(progress.ReadCount < count) {
+      progress.WrittenCount = 0;
+      TTranscoder::Transcode(source, count, scratch, 256, progress);
+      requiredCount += progress.WrittenCount;
+    }
+
+    return requiredCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts UTF-8 characters and appends them to a string</summary>
+  /// <typeparam name="TTranscoder">Transcoder that will convert the characters</typeparam>
+  /// <typeparam name="TTargetString">Type of string the characters will be appended to</typeparam>
+  /// <param name="target">String the converted characters will be appended to</param>
+  /// <param name="source">UTF-8 characters that will be converted</param>
+  /// <param name="count">Number of characters that will be converted</param>
+  /// <remarks>
+  ///   The whole text is validated in bulk first, which lets the transcoder decode
+  ///   without checking each code point. Invalid text goes through the checking
+  ///   transcoder so the exception reports the offending characters as before.
+  /// </remarks>
+  template<template<bool> class TTranscoder, typename TTargetString>
+  void appendTranscodedFromUtf8(TTargetString &target, const char *source, std::size_t count) {
+    if(Nuclex::Support::Text::Utf8Validator::IsValid(source, count)) {
+      appendTranscoded<TTranscoder<true>>(target, source, count);
+    } else {
+      appendTranscoded<TTranscoder<false>>(target, source, count);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts UTF-8 characters into a buffer provided by the caller</summary>
+  /// <typeparam name="TTranscoder">Transcoder that will convert the characters</typeparam>
+  /// <typeparam name="TTargetChar">Type of characters the buffer consists of</typeparam>
+  /// <param name="source">UTF-8 characters that will be converted</param>
+  /// <param name="count">Number of characters that will be converted</param>
+  /// <param name="buffer">Buffer that will receive the converted characters</param>
+  /// <param name="capacity">Number of characters the buffer can hold</param>
+  /// <returns>
+  ///   The number of characters written into the buffer or, if the buffer was too small,
+  ///   the number of characters the buffer would have needed
+  /// </returns>
+  template<template<bool> class TTranscoder, typename TTargetChar>
+  std::size_t transcodeIntoBufferFromUtf8(
+    const char *source, std::size_t count, TTargetChar *buffer, std::size_t capacity
+  ) {
+    if(Nuclex::Support::Text::Utf8Validator::IsValid(source, count)) {
+      return transcodeIntoBuffer<TTranscoder<true>>(source, count, buffer, capacity);
+    } else {
+      return transcodeIntoBuffer<TTranscoder<false>>(source, count, buffer, capacity);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Support { namespace Text {
@@ -170,93 +677,165 @@ namespace Nuclex { namespace Support { namespace Text {
   // ------------------------------------------------------------------------------------------- //
 
   std::wstring StringConverter::WideFromUtf8(const std::string &utf8String) {
-    return StringConverterCharWidthHelper<sizeof(wchar_t)>::WideFromUtf8(utf8String);
+    std::wstring result;
+    appendTranscodedFromUtf8<WideFromUtf8Transcoder>(
+      result, utf8String.data(), utf8String.length()
+    );
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StringConverter::WideFromUtf8(
+    const char *utf8Characters, std::size_t count, wchar_t *buffer, std::size_t bufferLength
+  ) {
+    return transcodeIntoBufferFromUtf8<WideFromUtf8Transcoder>(
+      utf8Characters, count, buffer, bufferLength
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringConverter::AppendWideFromUtf8(
+    std::wstring &target, const char *utf8Characters, std::size_t count
+  ) {
+    appendTranscodedFromUtf8<WideFromUtf8Transcoder>(target, utf8Characters, count);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   std::string StringConverter::Utf8FromWide(const std::wstring &wideString) {
-    return StringConverterCharWidthHelper<sizeof(wchar_t)>::Utf8FromWide(wideString);
+    std::string result;
+    appendTranscoded<Utf8FromWideTranscoder>(result, wideString.data(), wideString.length());
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t StringConverter::Utf8FromWide(
+    const wchar_t *wideCharacters, std::size_t count, char *buffer, std::size_t bufferLength
+  ) {
+    return transcodeIntoBuffer<Utf8FromWideTranscoder>(wideCharacters, count, buffer, bufferLength);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void StringConverter::AppendUtf8FromWide(
+    std::string &target, const wchar_t *wideCharacters, std::size_t count
+  ) {
+    appendTranscoded<Utf8FromWideTranscoder>(target, wideCharacters, count);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   std::u16string StringConverter::Utf16FromUtf8(const std::string &utf8String) {
-    if(utf8String.empty()) {
-      return std::u16string();
-    }
+    std::u16string result;
+    appendTranscodedFromUtf8<Utf16FromUtf8Transcoder>(
+      result, utf8String.data(), utf8String.length()
+    );
+    return result;
+  }
 
-    // We guess that we need as many UTF-16 characters as we needed UTF-8 characters
-    // based on the assumption that most text will only use ascii characters.
-    std::vector<char16_t> utf16Characters;
-    utf16Characters.reserve(utf8String.length());
+  // ------------------------------------------------------------------------------------------- //
 
-    // Do the conversion. If the vector was too short, it will be grown in factors
-    // of 2 usually (depending on the standard library implementation)
-    utf8::utf8to16(utf8String.begin(), utf8String.end(), std::back_inserter(utf16Characters));
+  std::size_t StringConverter::Utf16FromUtf8(
+    const char *utf8Characters, std::size_t count, char16_t *buffer, std::size_t bufferLength
+  ) {
+    return transcodeIntoBufferFromUtf8<Utf16FromUtf8Transcoder>(
+      utf8Characters, count, buffer, bufferLength
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    return std::u16string(&utf16Characters[0], utf16Characters.size());
+  void StringConverter::AppendUtf16FromUtf8(
+    std::u16string &target, const char *utf8Characters, std::size_t count
+  ) {
+    appendTranscodedFromUtf8<Utf16FromUtf8Transcoder>(target, utf8Characters, count);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   std::string StringConverter::Utf8FromUtf16(const std::u16string &utf16String) {
-    if(utf16String.empty()) {
-      return std::string();
-    }
+    std::string result;
+    appendTranscoded<Utf8FromUtf16Transcoder<char16_t>>(
+      result, utf16String.data(), utf16String.length()
+    );
+    return result;
+  }
 
-    // We guess that we need as many UTF-8 characters as we needed UTF-16 characters
-    // based on the assumption that most text will only use ascii characters.
-    std::vector<char> utf8Characters;
-    utf8Characters.reserve(utf16String.length());
+  // ------------------------------------------------------------------------------------------- //
 
-    // Do the conversion. If the vector was too short, it will be grown in factors
-    // of 2 usually (depending on the standard library implementation)
-    utf8::utf16to8(
-      utf16String.begin(), utf16String.end(), std::back_inserter(utf8Characters)
+  std::size_t StringConverter::Utf8FromUtf16(
+    const char16_t *utf16Characters, std::size_t count, char *buffer, std::size_t bufferLength
+  ) {
+    return transcodeIntoBuffer<Utf8FromUtf16Transcoder<char16_t>>(
+      utf16Characters, count, buffer, bufferLength
     );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    return std::string(&utf8Characters[0], utf8Characters.size());
+  void StringConverter::AppendUtf8FromUtf16(
+    std::string &target, const char16_t *utf16Characters, std::size_t count
+  ) {
+    appendTranscoded<Utf8FromUtf16Transcoder<char16_t>>(target, utf16Characters, count);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   std::u32string StringConverter::Utf32FromUtf8(const std::string &utf8String) {
-    if(utf8String.empty()) {
-      return std::u32string();
-    }
+    std::u32string result;
+    appendTranscodedFromUtf8<Utf32FromUtf8Transcoder>(
+      result, utf8String.data(), utf8String.length()
+    );
+    return result;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    // We guess that we need as many UTF-32 characters as we needed UTF-8 characters
-    // based on the assumption that most text will only use ascii characters.
-    std::vector<char32_t> utf32Characters;
-    utf32Characters.reserve(utf8String.length());
+  std::size_t StringConverter::Utf32FromUtf8(
+    const char *utf8Characters, std::size_t count, char32_t *buffer, std::size_t bufferLength
+  ) {
+    return transcodeIntoBufferFromUtf8<Utf32FromUtf8Transcoder>(
+      utf8Characters, count, buffer, bufferLength
+    );
+  }
 
-    // Do the conversion. If the vector was too short, it will be grown in factors
-    // of 2 usually (depending on the standard library implementation)
-    utf8::utf8to32(utf8String.begin(), utf8String.end(), std::back_inserter(utf32Characters));
+  // ------------------------------------------------------------------------------------------- //
 
-    return std::u32string(&utf32Characters[0], utf32Characters.size());
+  void StringConverter::AppendUtf32FromUtf8(
+    std::u32string &target, const char *utf8Characters, std::size_t count
+  ) {
+    appendTranscodedFromUtf8<Utf32FromUtf8Transcoder>(target, utf8Characters, count);
   }
 
   // ------------------------------------------------------------------------------------------- //
 
   std::string StringConverter::Utf8FromUtf32(const std::u32string &utf32String) {
-    if(utf32String.empty()) {
-      return std::string();
-    }
+    std::string result;
+    appendTranscoded<Utf8FromUtf32Transcoder<char32_t>>(
+      result, utf32String.data(), utf32String.length()
+    );
+    return result;
+  }
 
-    // We guess that we need as many UTF-8 characters as we needed UTF-32 characters
-    // based on the assumption that most text will only use ascii characters.
-    std::vector<char> utf8Characters;
-    utf8Characters.reserve(utf32String.length());
+  // ------------------------------------------------------------------------------------------- //
 
-    // Do the conversion. If the vector was too short, it will be grown in factors
-    // of 2 usually (depending on the standard library implementation)
-    utf8::utf32to8(
-      utf32String.begin(), utf32String.end(), std::back_inserter(utf8Characters)
+  std::size_t StringConverter::Utf8FromUtf32(
+    const char32_t *utf32Characters, std::size_t count, char *buffer, std::size_t bufferLength
+  ) {
+    return transcodeIntoBuffer<Utf8FromUtf32Transcoder<char32_t>>(
+      utf32Characters, count, buffer, bufferLength
     );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 
-    return std::string(&utf8Characters[0], utf8Characters.size());
+  void StringConverter::AppendUtf8FromUtf32(
+    std::string &target, const char32_t *utf32Characters, std::size_t count
+  ) {
+    appendTranscoded<Utf8FromUtf32Transcoder<char32_t>>(target, utf32Characters, count);
   }
 
   // ------------------------------------------------------------------------------------------- //
@@ -33,6 +33,75 @@ License along with this library
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads the next code point from a UTF-8 string and case-folds it</summary>
+  /// <param name="current">Current position in the string, will be advanced</param>
+  /// <param name="end">Position one past the end of the string</param>
+  /// <returns>The folded code point or 0 if the end of the string was reached</returns>
+  std::uint32_t nextFoldedCodepoint(const std::uint8_t *&current, const std::uint8_t *end) {
+    if(current == end) {
+      return 0;
+    } else if(*current < 0x80) {
+      return Nuclex::ToFoldedLowercaseAscii(*current++);
+    } else {
+      return Nuclex::ToFoldedLowercase(utf8::next(current, end));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Compares two UTF-8 strings while ignoring their case</summary>
+  /// <param name="left">String that will be compared to the right string</param>
+  /// <param name="right">String that will be compared to the left string</param>
+  /// <returns>True if both strings are identical when case-folded</returns>
+  /// <remarks>
+  ///   Case-folds the strings as it goes and stops at the first difference, so unlike
+  ///   comparing the case-folded strings, it doesn't need to allocate any memory.
+  ///   Like <see cref="Nuclex.ToFoldedLowercase" />, it treats a zero character as
+  ///   the end of the string.
+  /// </remarks>
+  bool areEqualFolded(const std::string &left, const std::string &right) {
+    const std::uint8_t *leftCurrent = reinterpret_cast<const std::uint8_t *>(left.data());
+    const std::uint8_t *leftEnd = leftCurrent + left.length();
+    const std::uint8_t *rightCurrent = reinterpret_cast<const std::uint8_t *>(right.data());
+    const std::uint8_t *rightEnd = rightCurrent + right.length();
+
+    for(;;) {
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+      // Compare runs of ASCII characters in blocks of 16 without the folding table
+      while(((leftEnd - leftCurrent) >= 16) && ((rightEnd - rightCurrent) >= 16)) {
+        __m128i leftCharacters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(leftCurrent));
+        __m128i rightCharacters = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(rightCurrent)
+        );
+        if(!Nuclex::IsAsciiBlock(leftCharacters) || !Nuclex::IsAsciiBlock(rightCharacters)) {
+          break;
+        }
+
+        __m128i equalMask = _mm_cmpeq_epi8(
+          Nuclex::ToFoldedLowercaseAsciiBlock(leftCharacters),
+          Nuclex::ToFoldedLowercaseAsciiBlock(rightCharacters)
+        );
+        if(_mm_movemask_epi8(equalMask) != 0xFFFF) {
+          return false;
+        }
+
+        leftCurrent += 16;
+        rightCurrent += 16;
+      }
+#endif
+
+      std::uint32_t leftCodepoint = nextFoldedCodepoint(leftCurrent, leftEnd);
+      std::uint32_t rightCodepoint = nextFoldedCodepoint(rightCurrent, rightEnd);
+      if(leftCodepoint != rightCodepoint) {
+        return false;
+      } else if(leftCodepoint == 0) {
+        return true;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
 #if 0 // This is a memento for my old, trusty Ascii wildcard checker. It's retired now.
   /// <summary>C-style function that checks if a string matches a wild card</summary>
   /// <param name="text">Text that will be checked against the wild card</param>
@@ -202,7 +271,7 @@ namespace Nuclex { namespace Support { namespace Text {
     if(caseSensitive) {
       return (left == right);
     } else {
-      return (ToFoldedLowercase(left) == ToFoldedLowercase(right));
+      return areEqualFolded(left, right);
     }
   }
 
@@ -220,4 +289,25 @@ namespace Nuclex { namespace Support { namespace Text {
 
   // ------------------------------------------------------------------------------------------- //
 
+  std::size_t CaseInsensitiveUtf8Hash::operator()(const std::string &text) const {
+    const std::uint8_t *current = reinterpret_cast<const std::uint8_t *>(text.data());
+    const std::uint8_t *end = current + text.length();
+
+    // FNV-1a over the folded code points. Stops at a zero character just like
+    // the case-insensitive comparison does, so equal strings always hash equal.
+    std::uint64_t hash = 14695981039346656037ULL;
+    for(;;) {
+      std::uint32_t codepoint = nextFoldedCodepoint(current, end);
+      if(codepoint == 0) {
+        break;
+      }
+
+      hash = (hash ^ codepoint) * 1099511628211ULL;
+    }
+
+    return static_cast<std::size_t>(hash ^ (hash >> 32));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Text
@@ -21,11 +21,18 @@ License along with this library
 #ifndef NUCLEX_UTF8FOLD_H
 #define NUCLEX_UTF8FOLD_H
 
+#include "Nuclex/Support/Config.h"
+
 // Requires Nemanja Trifunovic's "utf for cpp" library to iterate codepoints
 #include "../Utf8/checked.h"
 
 #include <string>
 #include <algorithm>
+#include <cstdint>
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
 
 #if defined(_DEBUG)
 #include <cassert>
@@ -520,28 +527,125 @@ namespace Nuclex {
 
   // ------------------------------------------------------------------------------------------- //
 
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+  /// <summary>Checks whether a block of 16 UTF-8 bytes only holds ASCII characters</summary>
+  /// <param name="characters">Block of UTF-8 bytes that will be checked</param>
+  /// <returns>True if all bytes are ASCII characters other than the zero terminator</returns>
+  inline bool IsAsciiBlock(__m128i characters) {
+    return (_mm_movemask_epi8(_mm_cmpgt_epi8(characters, _mm_setzero_si128())) == 0xFFFF);
+  }
+#endif
+  // ------------------------------------------------------------------------------------------- //
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+  /// <summary>Converts a block of 16 ASCII characters to folded lowercase</summary>
+  /// <param name="characters">Block of ASCII characters that will be converted</param>
+  /// <returns>The block with all uppercase letters replaced by lowercase letters</returns>
+  /// <remarks>
+  ///   For ASCII, folded lowercase is plain lowercase, so the letters from 'A' to 'Z'
+  ///   only need their 0x20 bit set.
+  /// </remarks>
+  inline __m128i ToFoldedLowercaseAsciiBlock(__m128i characters) {
+    __m128i uppercaseMask = _mm_and_si128(
+      _mm_cmpgt_epi8(characters, _mm_set1_epi8('A' - 1)),
+      _mm_cmplt_epi8(characters, _mm_set1_epi8('Z' + 1))
+    );
+    return _mm_or_si128(characters, _mm_and_si128(uppercaseMask, _mm_set1_epi8(0x20)));
+  }
+#endif
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts an ASCII character to folded lowercase</summary>
+  /// <param name="character">ASCII character that will be converted</param>
+  /// <returns>The lowercase letter if the character was an uppercase letter</returns>
+  inline std::uint8_t ToFoldedLowercaseAscii(std::uint8_t character) {
+    if(static_cast<std::uint8_t>(character - 'A') < 26) {
+      return static_cast<std::uint8_t>(character | 0x20);
+    } else {
+      return character;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts the ASCII characters at the start of a UTF-8 string</summary>
+  /// <param name="text">UTF-8 characters that will be converted</param>
+  /// <param name="count">Number of bytes in the UTF-8 string</param>
+  /// <param name="target">Receives the folded lowercase characters</param>
+  /// <returns>
+  ///   The number of characters converted, stopping at the first byte that is not
+  ///   an ASCII character or that is a zero terminator
+  /// </returns>
+  inline std::size_t ToFoldedLowercaseAscii(
+    const std::uint8_t *text, std::size_t count, std::uint8_t *target
+  ) {
+    std::size_t index = 0;
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+    while(count - index >= 16) {
+      __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + index));
+      if(!IsAsciiBlock(characters)) {
+        break;
+      }
+
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(target + index), ToFoldedLowercaseAsciiBlock(characters)
+      );
+      index += 16;
+    }
+#endif
+
+    while(index < count) {
+      std::uint8_t character = text[index];
+      if((character == 0) || (character >= 0x80)) {
+        break;
+      }
+
+      target[index] = ToFoldedLowercaseAscii(character);
+      ++index;
+    }
+
+    return index;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   /// <summary>Converts the specified UTF-8 string to &quot;folded lowercase&quot;</summary>
   /// <param name="text">String that will be converted</param>
-  /// <returns>An equivalent-ish string using only lowercase characters</returns>
+  /// <param name="result">
+  ///   Receives an equivalent-ish string using only lowercase characters. Its memory is
+  ///   reused, so folding many strings into the same result doesn't keep allocating.
+  /// </param>
   /// <remarks>
   ///   Folded lowercase is a special variant of lowercase that will result in a string of
   ///   equal or shorter length (codepoint-wise). It is not guaranteed to always give the
   ///   correct result for a human reading the string (though in the vast majority of cases
   ///   it does) -- it's purpose is to enable case-insensitive comparison of strings. 
   /// </remarks>
-  inline std::string ToFoldedLowercase(const std::string &text) {
-    std::string::const_iterator current = text.begin();
-    std::string::const_iterator end = text.end();
+  inline void ToFoldedLowercase(const std::string &text, std::string &result) {
+    const std::uint8_t *begin = reinterpret_cast<const std::uint8_t *>(text.data());
+    const std::uint8_t *end = begin + text.length();
 
-    // The folding map will never increase the length of the string (and there are only
-    // a very small number of cases where it decreases the length), so preallocating
-    // the same amount of memory for the new string is a very good approximation.
-    std::string result;
-    result.reserve(text.length());
+    // Folding rarely changes the length of a string (a few characters shrink and a few
+    // grow by one byte in UTF-8), so the same amount of memory as the input string
+    // is a very good approximation for the result.
+    result.resize(text.length());
+    std::size_t writtenCount = 0;
 
     // Go over all codepoints and replace uppercase characters with folded lowercase
+    const std::uint8_t *current = begin;
     while(current != end) { // Check is needed, utf8 asserts when called after hitting end
 
+      // Runs of ASCII characters are folded in bulk without looking up the folding table
+      std::size_t asciiCount = ToFoldedLowercaseAscii(
+        current, static_cast<std::size_t>(end - current),
+        reinterpret_cast<std::uint8_t *>(&result[0]) + writtenCount
+      );
+      current += asciiCount;
+      writtenCount += asciiCount;
+      if(current == end) {
+        break;
+      }
+
       // Obtain the whole codepoint (all bytes belonging to the character in a single 32 bit
       // integer - this is not UTF-32 encoded, it's a 32-bit 'overlong' UTF-8 codepoint)
       std::uint32_t codePoint = utf8::next(current, end);
@@ -552,15 +656,31 @@ namespace Nuclex {
       // Convert the codepoint to lowercase if it is an uppercase charactrer
       codePoint = ToFoldedLowercase(codePoint);
 
-      // Append the codepoint to the result string
-      std::uint8_t buffer[4];
-      std::uint8_t *bufferEnd = utf8::append(codePoint, buffer);
-      for(const std::uint8_t *octet = buffer; octet < bufferEnd; ++octet) {
-        result.append(1, *reinterpret_cast<const std::string::value_type *>(octet));
+      // Append the codepoint to the result string, making room if it grew
+      std::size_t remainingCount = static_cast<std::size_t>(end - current);
+      if(result.length() - writtenCount < remainingCount + 4) {
+        result.resize(writtenCount + remainingCount + 4);
       }
+      std::uint8_t *resultEnd = utf8::append(
+        codePoint, reinterpret_cast<std::uint8_t *>(&result[0]) + writtenCount
+      );
+      writtenCount = static_cast<std::size_t>(
+        resultEnd - reinterpret_cast<std::uint8_t *>(&result[0])
+      );
 
     }
 
+    result.resize(writtenCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Converts the specified UTF-8 string to &quot;folded lowercase&quot;</summary>
+  /// <param name="text">String that will be converted</param>
+  /// <returns>An equivalent-ish string using only lowercase characters</returns>
+  inline std::string ToFoldedLowercase(const std::string &text) {
+    std::string result;
+    ToFoldedLowercase(text, result);
     return result;
   }
 
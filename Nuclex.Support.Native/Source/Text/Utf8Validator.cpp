@@ -0,0 +1,331 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/Utf8Validator.h"
+
+#include "Utf8/core.h" // for utf8::internal::validate_next()
+
+#include <cstdint> // for std::uint8_t, std::uint64_t
+#include <cstring> // for std::memcpy()
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSSE3)
+#include <tmmintrin.h> // for SSSE3
+#elif defined(NUCLEX_SUPPORT_HAVE_SSE2)
+#include <emmintrin.h> // for SSE2
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSSE3)
+  // Each error flag stands for a class of invalid two-byte combinations. A pair of bytes
+  // is invalid if the tables for the first byte's high nibble, its low nibble and
+  // the second byte's high nibble all have the same flag set.
+
+  /// <summary>Lead byte followed by too few continuation bytes</summary>
+  const std::uint8_t TooShort = 1 << 0;
+  /// <summary>Continuation byte after an ASCII character</summary>
+  const std::uint8_t TooLong = 1 << 1;
+  /// <summary>Three-byte sequence that could have been encoded in two bytes</summary>
+  const std::uint8_t Overlong3 = 1 << 2;
+  /// <summary>Four-byte sequence encoding a code point above U+10FFFF</summary>
+  const std::uint8_t TooLarge = 1 << 3;
+  /// <summary>Three-byte sequence encoding a UTF-16 surrogate</summary>
+  const std::uint8_t Surrogate = 1 << 4;
+  /// <summary>Two-byte sequence that could have been encoded in one byte</summary>
+  const std::uint8_t Overlong2 = 1 << 5;
+  /// <summary>Four-byte sequence that is too large or overlong</summary>
+  const std::uint8_t TooLarge1000 = 1 << 6;
+  /// <summary>Four-byte sequence that could have been encoded in three bytes</summary>
+  const std::uint8_t Overlong4 = 1 << 6;
+  /// <summary>Two continuation bytes in a row</summary>
+  const std::uint8_t TwoContinuations = 1 << 7;
+  /// <summary>Flags that are only decided by the high nibble of the first byte</summary>
+  const std::uint8_t Carry = TooShort | TooLong | TwoContinuations;
+
+  /// <summary>Errors possible depending on the high nibble of the first byte</summary>
+  alignas(16) const std::uint8_t FirstByteHighNibbleErrors[16] = {
+    TooLong, TooLong, TooLong, TooLong, // 0___ ASCII
+    TooLong, TooLong, TooLong, TooLong,
+    TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations, // 10__
+    TooShort | Overlong2, // 1100
+    TooShort, // 1101
+    TooShort | Overlong3 | Surrogate, // 1110
+    TooShort | TooLarge | TooLarge1000 | Overlong4 // 1111
+  };
+
+  /// <summary>Errors possible depending on the low nibble of the first byte</summary>
+  alignas(16) const std::uint8_t FirstByteLowNibbleErrors[16] = {
+    Carry | Overlong3 | Overlong2 | Overlong4, // 0000
+    Carry | Overlong2, // 0001
+    Carry, // 0010
+    Carry, // 0011
+    Carry | TooLarge, // 0100
+    Carry | TooLarge | TooLarge1000, // 0101
+    Carry | TooLarge | TooLarge1000, // 0110
+    Carry | TooLarge | TooLarge1000, // 0111
+    Carry | TooLarge | TooLarge1000, // 1000
+    Carry | TooLarge | TooLarge1000, // 1001
+    Carry | TooLarge | TooLarge1000, // 1010
+    Carry | TooLarge | TooLarge1000, // 1011
+    Carry | TooLarge | TooLarge1000, // 1100
+    Carry | TooLarge | TooLarge1000 | Surrogate, // 1101
+    Carry | TooLarge | TooLarge1000, // 1110
+    Carry | TooLarge | TooLarge1000 // 1111
+  };
+
+  /// <summary>Errors possible depending on the high nibble of the second byte</summary>
+  alignas(16) const std::uint8_t SecondByteHighNibbleErrors[16] = {
+    TooShort, TooShort, TooShort, TooShort, // 0___ ASCII
+    TooShort, TooShort, TooShort, TooShort,
+    TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4, // 1000
+    TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge, // 1001
+    TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge, // 1010
+    TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge, // 1011
+    TooShort, TooShort, TooShort, TooShort // 11__
+  };
+
+  /// <summary>Largest values the last three bytes of a block may have</summary>
+  /// <remarks>
+  ///   Bytes above these begin a sequence that doesn't fit into the block. That is fine
+  ///   unless the block is the last one.
+  /// </remarks>
+  alignas(16) const std::uint8_t CompleteBlockLimits[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Loads a table of 16 bytes</summary>
+  /// <param name="table">Table that will be loaded</param>
+  /// <returns>A vector holding the table</returns>
+  inline __m128i loadTable(const std::uint8_t (&table)[16]) {
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(table));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Extracts the high nibble of each byte in a vector</summary>
+  /// <param name="bytes">Bytes whose high nibbles will be extracted</param>
+  /// <returns>A vector holding the high nibbles of the bytes</returns>
+  inline __m128i getHighNibbles(__m128i bytes) {
+    return _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Validates UTF-8 text 16 bytes at a time</summary>
+  class Utf8BlockValidator {
+
+    /// <summary>Initializes a new block validator</summary>
+    public: Utf8BlockValidator() :
+      errors(_mm_setzero_si128()),
+      previousBlock(_mm_setzero_si128()),
+      previousIncomplete(_mm_setzero_si128()) {}
+
+    /// <summary>Checks the next block of 16 bytes</summary>
+    /// <param name="block">Block that will be checked</param>
+    public: void Check(__m128i block) {
+      if(_mm_movemask_epi8(block) == 0) { // Only ASCII characters
+        this->errors = _mm_or_si128(this->errors, this->previousIncomplete);
+        this->previousIncomplete = _mm_setzero_si128();
+      } else {
+        __m128i previous1 = _mm_alignr_epi8(block, this->previousBlock, 16 - 1);
+
+        // Look for invalid pairs of bytes
+        __m128i specialCases = _mm_and_si128(
+          _mm_and_si128(
+            _mm_shuffle_epi8(loadTable(FirstByteHighNibbleErrors), getHighNibbles(previous1)),
+            _mm_shuffle_epi8(
+              loadTable(FirstByteLowNibbleErrors), _mm_and_si128(previous1, _mm_set1_epi8(0x0F))
+            )
+          ),
+          _mm_shuffle_epi8(loadTable(SecondByteHighNibbleErrors), getHighNibbles(block))
+        );
+
+        // The third and fourth bytes of a sequence have to be continuation bytes. Pairs of
+        // continuation bytes were flagged above, they're only valid in these positions.
+        __m128i previous2 = _mm_alignr_epi8(block, this->previousBlock, 16 - 2);
+        __m128i previous3 = _mm_alignr_epi8(block, this->previousBlock, 16 - 3);
+        __m128i isThirdByte = _mm_subs_epu8(previous2, _mm_set1_epi8(0xE0 - 0x80));
+        __m128i isFourthByte = _mm_subs_epu8(previous3, _mm_set1_epi8(0xF0 - 0x80));
+        __m128i mustBeContinuation = _mm_and_si128(
+          _mm_or_si128(isThirdByte, isFourthByte), _mm_set1_epi8(static_cast<char>(0x80))
+        );
+        this->errors = _mm_or_si128(
+          this->errors, _mm_xor_si128(mustBeContinuation, specialCases)
+        );
+
+        this->previousIncomplete = _mm_subs_epu8(block, loadTable(CompleteBlockLimits));
+      }
+
+      this->previousBlock = block;
+    }
+
+    /// <summary>Checks whether all blocks checked so far were valid</summary>
+    /// <returns>True if the text ended without any errors</returns>
+    /// <remarks>
+    ///   Only to be called after the final block, a sequence that is continued in
+    ///   the next block counts as an error here.
+    /// </remarks>
+    public: bool IsValid() const {
+      __m128i errors = _mm_or_si128(this->errors, this->previousIncomplete);
+      return (_mm_movemask_epi8(_mm_cmpeq_epi8(errors, _mm_setzero_si128())) == 0xFFFF);
+    }
+
+    /// <summary>Errors collected from all blocks checked so far</summary>
+    private: __m128i errors;
+    /// <summary>Block that was checked before the current one</summary>
+    private: __m128i previousBlock;
+    /// <summary>Non-zero where the previous block ended in an unfinished sequence</summary>
+    private: __m128i previousIncomplete;
+
+  };
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_SUPPORT_HAVE_SSSE3)
+  /// <summary>Finds the length of the run of ASCII characters at the start of a string</summary>
+  /// <param name="bytes">Characters that will be checked</param>
+  /// <param name="count">Number of characters available</param>
+  /// <returns>The number of ASCII characters before the first other character</returns>
+  std::size_t getAsciiLength(const std::uint8_t *bytes, std::size_t count) {
+    std::size_t index = 0;
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+    while(index + 16 <= count) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + index));
+      if(_mm_movemask_epi8(block) != 0) {
+        break; // At least one byte has its high bit set
+      }
+      index += 16;
+    }
+#else
+    while(index + 8 <= count) {
+      std::uint64_t block;
+      std::memcpy(&block, bytes + index, 8);
+      if((block & 0x8080808080808080ULL) != 0) {
+        break; // At least one byte has its high bit set
+      }
+      index += 8;
+    }
+#endif
+
+    while((index < count) && (bytes[index] < 0x80)) {
+      ++index;
+    }
+
+    return index;
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool Utf8Validator::IsValid(const char *characters, std::size_t count) {
+    const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(characters);
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSSE3)
+    Utf8BlockValidator validator;
+
+    std::size_t index = 0;
+    while(index + 16 <= count) {
+      validator.Check(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + index)));
+      index += 16;
+    }
+
+    // Pad the final block with zeros, which are ASCII characters and thus make any
+    // sequence left unfinished at the end of the text stand out
+    if(index < count) {
+      alignas(16) std::uint8_t finalBlock[16] = { 0 };
+      std::memcpy(finalBlock, bytes + index, count - index);
+      validator.Check(_mm_load_si128(reinterpret_cast<const __m128i *>(finalBlock)));
+    }
+
+    return validator.IsValid();
+#else
+    const std::uint8_t *end = bytes + count;
+    for(;;) {
+      bytes += getAsciiLength(bytes, static_cast<std::size_t>(end - bytes));
+      if(bytes == end) {
+        return true;
+      }
+
+      if(utf8::internal::validate_next(bytes, end) != utf8::internal::UTF8_OK) {
+        return false;
+      }
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Utf8Validator::CountCodePoints(const char *characters, std::size_t count) {
+    const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(characters);
+    std::size_t codePointCount = 0;
+    std::size_t index = 0;
+
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+    // Continuation bytes are 0x80 to 0xBF, or -128 to -65 as signed bytes. Each byte
+    // lane counts the other bytes for up to 255 blocks before the lanes are summed up.
+    const __m128i lastContinuationByte = _mm_set1_epi8(-65);
+    while(index + 16 <= count) {
+      std::size_t blockCount = (count - index) / 16;
+      if(blockCount > 255) {
+        blockCount = 255;
+      }
+
+      __m128i laneCounts = _mm_setzero_si128();
+      for(std::size_t block = 0; block < blockCount; ++block) {
+        __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + index));
+        laneCounts = _mm_sub_epi8(laneCounts, _mm_cmpgt_epi8(characters, lastContinuationByte));
+        index += 16;
+      }
+
+      __m128i sums = _mm_sad_epu8(laneCounts, _mm_setzero_si128());
+      codePointCount += static_cast<std::size_t>(_mm_cvtsi128_si32(sums));
+      codePointCount += static_cast<std::size_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+    }
+#endif
+
+    while(index < count) {
+      if((bytes[index] & 0xC0) != 0x80) {
+        ++codePointCount;
+      }
+      ++index;
+    }
+
+    return codePointCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
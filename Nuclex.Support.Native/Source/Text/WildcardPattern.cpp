@@ -0,0 +1,313 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/WildcardPattern.h"
+
+#include "Utf8Fold/Utf8Fold.h" // for ToFoldedLowercase()
+
+#include <cstring> // for std::memchr(), std::memcmp()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Checks whether a byte continues a UTF-8 code point</summary>
+  /// <param name="character">Byte that will be checked</param>
+  /// <returns>True if the byte is not the first byte of a code point</returns>
+  inline bool isContinuationByte(char character) {
+    return ((static_cast<unsigned char>(character) & 0xC0) == 0x80);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Skips over one code point in a UTF-8 string</summary>
+  /// <param name="position">Position of the code point that will be skipped</param>
+  /// <param name="end">Position one past the end of the string</param>
+  /// <returns>The position of the next code point</returns>
+  inline const char *skipCodepoint(const char *position, const char *end) {
+    ++position;
+    while((position < end) && isContinuationByte(*position)) {
+      ++position;
+    }
+    return position;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns a buffer the calling thread can case-fold strings into</summary>
+  /// <returns>A string buffer that is reused by each call on the same thread</returns>
+  std::string &getFoldingBuffer() {
+    thread_local std::string foldingBuffer;
+    return foldingBuffer;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WildcardPattern::WildcardPattern(
+    const std::string &wildcard, bool caseSensitive /* = false */
+  ) :
+    minimumByteCount(0),
+    anchoredAtStart(true),
+    anchoredAtEnd(true),
+    caseSensitive(caseSensitive) {
+
+    std::string characters;
+    if(caseSensitive) {
+      characters = wildcard;
+    } else {
+      ToFoldedLowercase(wildcard, characters);
+    }
+
+    // Each character in the wildcard, including question marks, needs at least
+    // one byte in the string, so that's the shortest string that can match
+    this->minimumByteCount = characters.length();
+
+    // A wildcard without stars has to match the whole string, even if it's empty
+    std::string::size_type starIndex = characters.find('*');
+    if(starIndex == std::string::npos) {
+      addSegment(characters);
+      return;
+    }
+
+    // Split the wildcard at its stars. Only the parts before the first star and after
+    // the last star are anchored, runs of stars are treated like a single star.
+    this->anchoredAtStart = (starIndex != 0);
+    this->anchoredAtEnd = (characters.back() != '*');
+
+    std::string::size_type start = 0;
+    for(;;) {
+      if(starIndex > start) {
+        addSegment(characters.substr(start, starIndex - start));
+      }
+      --this->minimumByteCount;
+
+      start = starIndex + 1;
+      starIndex = characters.find('*', start);
+      if(starIndex == std::string::npos) {
+        if(start < characters.length()) {
+          addSegment(characters.substr(start));
+        }
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WildcardPattern::Matches(const std::string &text) const {
+    if(this->caseSensitive) {
+      return matchesPrepared(text.data(), text.length());
+    } else {
+      std::string &folded = getFoldingBuffer();
+      ToFoldedLowercase(text, folded);
+      return matchesPrepared(folded.data(), folded.length());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void WildcardPattern::addSegment(const std::string &characters) {
+    Segment segment;
+    segment.Characters = characters;
+    segment.HasQuestionMarks = (characters.find('?') != std::string::npos);
+    this->segments.push_back(segment);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WildcardPattern::matchesPrepared(const char *text, std::size_t length) const {
+    if(length < this->minimumByteCount) {
+      return false;
+    }
+
+    const char *begin = text;
+    const char *end = text + length;
+
+    std::size_t segmentCount = this->segments.size();
+    if(this->anchoredAtStart && this->anchoredAtEnd && (segmentCount == 1)) {
+      return (matchAt(this->segments.front(), begin, end) == end);
+    }
+
+    // Match the anchored ends first, the segments in between can then be looked for
+    // in whatever remains between them
+    std::size_t firstIndex = 0;
+    if(this->anchoredAtStart) {
+      begin = matchAt(this->segments.front(), begin, end);
+      if(begin == nullptr) {
+        return false;
+      }
+      ++firstIndex;
+    }
+    if(this->anchoredAtEnd) {
+      end = matchBefore(this->segments.back(), begin, end);
+      if(end == nullptr) {
+        return false;
+      }
+      --segmentCount;
+    }
+
+    // Taking the first match of each segment never prevents a later segment
+    // from matching, so no backtracking is needed
+    for(std::size_t index = firstIndex; index < segmentCount; ++index) {
+      if(find(this->segments[index], begin, end, begin) == nullptr) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const char *WildcardPattern::find(
+    const Segment &segment, const char *begin, const char *end, const char *&matchEnd
+  ) {
+    std::size_t byteCount = segment.Characters.length();
+    if(static_cast<std::size_t>(end - begin) < byteCount) {
+      return nullptr;
+    }
+
+    // Segments starting with a question mark can begin at any code point
+    const char *characters = segment.Characters.data();
+    if(characters[0] == '?') {
+      for(const char *position = begin; position < end; position = skipCodepoint(position, end)) {
+        matchEnd = matchAt(segment, position, end);
+        if(matchEnd != nullptr) {
+          return position;
+        }
+      }
+      return nullptr;
+    }
+
+    // Otherwise, jump to each occurrence of the segment's first byte. In valid UTF-8,
+    // the first byte of a code point can't appear in the middle of another one.
+    const char *last = end - byteCount;
+    const char *position = begin;
+    while(position <= last) {
+      position = static_cast<const char *>(
+        std::memchr(position, characters[0], static_cast<std::size_t>(last - position) + 1)
+      );
+      if(position == nullptr) {
+        return nullptr;
+      }
+
+      if(segment.HasQuestionMarks) {
+        matchEnd = matchAt(segment, position, end);
+        if(matchEnd != nullptr) {
+          return position;
+        }
+      } else if(std::memcmp(position + 1, characters + 1, byteCount - 1) == 0) {
+        matchEnd = position + byteCount;
+        return position;
+      }
+
+      ++position;
+    }
+
+    return nullptr;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const char *WildcardPattern::matchAt(
+    const Segment &segment, const char *position, const char *end
+  ) {
+    const char *current = segment.Characters.data();
+    const char *segmentEnd = current + segment.Characters.length();
+
+    if(!segment.HasQuestionMarks) {
+      std::size_t byteCount = segment.Characters.length();
+      if(static_cast<std::size_t>(end - position) < byteCount) {
+        return nullptr;
+      }
+      if(std::memcmp(position, current, byteCount) != 0) {
+        return nullptr;
+      }
+      return position + byteCount;
+    }
+
+    while(current < segmentEnd) {
+      if(position == end) {
+        return nullptr;
+      }
+
+      if(*current == '?') {
+        position = skipCodepoint(position, end);
+      } else if(*current == *position) {
+        ++position;
+      } else {
+        return nullptr;
+      }
+      ++current;
+    }
+
+    return position;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const char *WildcardPattern::matchBefore(
+    const Segment &segment, const char *begin, const char *end
+  ) {
+    const char *segmentBegin = segment.Characters.data();
+    const char *current = segmentBegin + segment.Characters.length();
+
+    if(!segment.HasQuestionMarks) {
+      std::size_t byteCount = segment.Characters.length();
+      if(static_cast<std::size_t>(end - begin) < byteCount) {
+        return nullptr;
+      }
+      if(std::memcmp(end - byteCount, segmentBegin, byteCount) != 0) {
+        return nullptr;
+      }
+      return end - byteCount;
+    }
+
+    while(current > segmentBegin) {
+      if(end == begin) {
+        return nullptr;
+      }
+
+      --current;
+      --end;
+      if(*current == '?') {
+        while((end > begin) && isContinuationByte(*end)) {
+          --end;
+        }
+      } else if(*current != *end) {
+        return nullptr;
+      }
+    }
+
+    return end;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
@@ -0,0 +1,159 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/WildcardSet.h"
+
+#include "Utf8Fold/Utf8Fold.h" // for ToFoldedLowercase()
+
+#include <utility> // for std::move()
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Returns a buffer the calling thread can case-fold strings into</summary>
+  /// <returns>A string buffer that is reused by each call on the same thread</returns>
+  std::string &getFoldingBuffer() {
+    thread_local std::string foldingBuffer;
+    return foldingBuffer;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::size_t WildcardSet::NoMatch = static_cast<std::size_t>(-1);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  WildcardSet::WildcardSet(bool caseSensitive /* = false */) :
+    caseSensitive(caseSensitive) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t WildcardSet::Add(const std::string &wildcard) {
+    WildcardPattern pattern(wildcard, this->caseSensitive);
+
+    Filter filter;
+    filter.MinimumByteCount = pattern.minimumByteCount;
+    filter.FirstByte = -1;
+    filter.LastByte = -1;
+    if(pattern.anchoredAtStart) {
+      const std::string &characters = pattern.segments.front().Characters;
+      if(!characters.empty() && (characters.front() != '?')) {
+        filter.FirstByte = static_cast<unsigned char>(characters.front());
+      }
+    }
+    if(pattern.anchoredAtEnd) {
+      const std::string &characters = pattern.segments.back().Characters;
+      if(!characters.empty() && (characters.back() != '?')) {
+        filter.LastByte = static_cast<unsigned char>(characters.back());
+      }
+    }
+
+    this->filters.push_back(filter);
+    this->patterns.push_back(std::move(pattern));
+
+    return this->patterns.size() - 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  bool WildcardSet::MatchesAny(const std::string &text) const {
+    return (FindFirstMatch(text) != NoMatch);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t WildcardSet::FindFirstMatch(const std::string &text) const {
+    const std::string &prepared = prepare(text);
+    return findNextMatch(prepared.data(), prepared.length(), 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t WildcardSet::FindAllMatches(
+    const std::string &text, std::vector<std::size_t> &matchIndices
+  ) const {
+    const std::string &prepared = prepare(text);
+
+    std::size_t matchCount = 0;
+    std::size_t index = findNextMatch(prepared.data(), prepared.length(), 0);
+    while(index != NoMatch) {
+      matchIndices.push_back(index);
+      ++matchCount;
+
+      index = findNextMatch(prepared.data(), prepared.length(), index + 1);
+    }
+
+    return matchCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t WildcardSet::findNextMatch(
+    const char *text, std::size_t length, std::size_t startIndex
+  ) const {
+    int firstByte = (length == 0) ? -2 : static_cast<unsigned char>(text[0]);
+    int lastByte = (length == 0) ? -2 : static_cast<unsigned char>(text[length - 1]);
+
+    std::size_t patternCount = this->patterns.size();
+    for(std::size_t index = startIndex; index < patternCount; ++index) {
+      const Filter &filter = this->filters[index];
+      if(length < filter.MinimumByteCount) {
+        continue;
+      }
+      if((filter.FirstByte != -1) && (filter.FirstByte != firstByte)) {
+        continue;
+      }
+      if((filter.LastByte != -1) && (filter.LastByte != lastByte)) {
+        continue;
+      }
+
+      if(this->patterns[index].matchesPrepared(text, length)) {
+        return index;
+      }
+    }
+
+    return NoMatch;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const std::string &WildcardSet::prepare(const std::string &text) const {
+    if(this->caseSensitive) {
+      return text;
+    } else {
+      std::string &folded = getFoldingBuffer();
+      ToFoldedLowercase(text, folded);
+      return folded;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
@@ -0,0 +1,244 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Threading/NumaTopology.h"
+
+#include <string> // for std::string, std::to_string()
+#include <thread> // for std::thread
+
+#if defined(NUCLEX_SUPPORT_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define VC_EXTRALEAN
+#include <Windows.h> // for GetNumaHighestNodeNumber(), SetThreadAffinityMask()
+#else
+#include <cstdio> // for std::fopen(), std::fgets()
+#include <pthread.h> // for pthread_setaffinity_np()
+#include <sched.h> // for sched_getcpu(), cpu_set_t
+#endif
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if !defined(NUCLEX_SUPPORT_WIN32)
+  /// <summary>Parses a list of numbers and ranges as used by Linux' sysfs</summary>
+  /// <param name="text">List of the form "0-3,8,10-11" that will be parsed</param>
+  /// <returns>All numbers contained in the list</returns>
+  std::vector<std::size_t> parseIndexList(const char *text) {
+    std::vector<std::size_t> indices;
+
+    while((*text >= '0') && (*text <= '9')) {
+      std::size_t first = 0;
+      while((*text >= '0') && (*text <= '9')) {
+        first = first * 10 + static_cast<std::size_t>(*text - '0');
+        ++text;
+      }
+
+      std::size_t last = first;
+      if(*text == '-') {
+        ++text;
+        last = 0;
+        while((*text >= '0') && (*text <= '9')) {
+          last = last * 10 + static_cast<std::size_t>(*text - '0');
+          ++text;
+        }
+      }
+
+      for(std::size_t index = first; index <= last; ++index) {
+        indices.push_back(index);
+      }
+
+      if(*text != ',') {
+        break;
+      }
+      ++text;
+    }
+
+    return indices;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Reads a list of numbers and ranges from a sysfs file</summary>
+  /// <param name="path">Path of the file that will be read</param>
+  /// <returns>All numbers listed in the file, empty if it couldn't be read</returns>
+  std::vector<std::size_t> readIndexList(const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), u8"r");
+    if(file == nullptr) {
+      return std::vector<std::size_t>();
+    }
+
+    char line[1024];
+    bool hasLine = (std::fgets(line, sizeof(line), file) != nullptr);
+    std::fclose(file);
+
+    if(hasLine) {
+      return parseIndexList(line);
+    } else {
+      return std::vector<std::size_t>();
+    }
+  }
+#endif // !defined(NUCLEX_SUPPORT_WIN32)
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Asks the operating system how CPU cores are grouped into NUMA nodes</summary>
+  /// <returns>The NUMA topology of the system</returns>
+  Nuclex::Support::Threading::NumaTopology detectNumaTopology() {
+    Nuclex::Support::Threading::NumaTopology topology;
+
+#if defined(NUCLEX_SUPPORT_WIN32)
+    ULONG highestNodeNumber = 0;
+    if(::GetNumaHighestNodeNumber(&highestNodeNumber) != FALSE) {
+      for(ULONG nodeNumber = 0; nodeNumber <= highestNodeNumber; ++nodeNumber) {
+        ULONGLONG processorMask = 0;
+        if(::GetNumaNodeProcessorMask(static_cast<UCHAR>(nodeNumber), &processorMask) == FALSE) {
+          continue;
+        }
+
+        Nuclex::Support::Threading::NumaNode node;
+        node.Id = nodeNumber;
+        for(std::size_t coreIndex = 0; coreIndex < 64; ++coreIndex) {
+          if((processorMask & (ULONGLONG(1) << coreIndex)) != 0) {
+            node.Cores.push_back(coreIndex);
+          }
+        }
+        if(!node.Cores.empty()) {
+          topology.Nodes.push_back(node);
+        }
+      }
+    }
+#else
+    std::vector<std::size_t> nodeIds = readIndexList(u8"/sys/devices/system/node/online");
+    for(std::size_t index = 0; index < nodeIds.size(); ++index) {
+      Nuclex::Support::Threading::NumaNode node;
+      node.Id = nodeIds[index];
+      node.Cores = readIndexList(
+        u8"/sys/devices/system/node/node" + std::to_string(node.Id) + u8"/cpulist"
+      );
+
+      // Nodes that only provide memory (for example persistent memory) have no cores
+      if(!node.Cores.empty()) {
+        topology.Nodes.push_back(node);
+      }
+    }
+#endif
+
+    // If the system didn't tell, treat it as one node with all cores
+    if(topology.Nodes.empty()) {
+      Nuclex::Support::Threading::NumaNode node;
+      node.Id = 0;
+
+      std::size_t coreCount = std::thread::hardware_concurrency();
+      if(coreCount == 0) {
+        coreCount = 1;
+      }
+      for(std::size_t coreIndex = 0; coreIndex < coreCount; ++coreIndex) {
+        node.Cores.push_back(coreIndex);
+      }
+
+      topology.Nodes.push_back(node);
+    }
+
+    return topology;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  const NumaTopology &NumaTopology::Get() {
+    static const NumaTopology topology = detectNumaTopology();
+    return topology;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t NumaTopology::GetNodeIndexOfCore(std::size_t coreIndex) const {
+    for(std::size_t nodeIndex = 0; nodeIndex < this->Nodes.size(); ++nodeIndex) {
+      const std::vector<std::size_t> &cores = this->Nodes[nodeIndex].Cores;
+      for(std::size_t index = 0; index < cores.size(); ++index) {
+        if(cores[index] == coreIndex) {
+          return nodeIndex;
+        }
+      }
+    }
+
+    return 0;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t NumaTopology::GetCurrentNodeIndex() const {
+    if(this->Nodes.size() < 2) {
+      return 0;
+    }
+
+#if defined(NUCLEX_SUPPORT_WIN32)
+    return GetNodeIndexOfCore(::GetCurrentProcessorNumber());
+#else
+    int coreIndex = ::sched_getcpu();
+    if(coreIndex < 0) {
+      return 0;
+    } else {
+      return GetNodeIndexOfCore(static_cast<std::size_t>(coreIndex));
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void NumaTopology::PinCallingThreadToCores(const std::vector<std::size_t> &coreIndices) {
+#if defined(NUCLEX_SUPPORT_WIN32)
+    DWORD_PTR coreMask = 0;
+    for(std::size_t index = 0; index < coreIndices.size(); ++index) {
+      if(coreIndices[index] < sizeof(DWORD_PTR) * 8) {
+        coreMask |= DWORD_PTR(1) << coreIndices[index];
+      }
+    }
+    if(coreMask != 0) {
+      ::SetThreadAffinityMask(::GetCurrentThread(), coreMask);
+    }
+#else
+    cpu_set_t coreSet;
+    CPU_ZERO(&coreSet);
+    bool hasCores = false;
+    for(std::size_t index = 0; index < coreIndices.size(); ++index) {
+      if(coreIndices[index] < CPU_SETSIZE) {
+        CPU_SET(coreIndices[index], &coreSet);
+        hasCores = true;
+      }
+    }
+    if(hasCores) {
+      ::pthread_setaffinity_np(::pthread_self(), sizeof(coreSet), &coreSet);
+    }
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
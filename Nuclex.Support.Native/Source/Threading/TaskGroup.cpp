@@ -0,0 +1,60 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Threading/TaskGroup.h"
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TaskGroup::TaskGroup(ThreadPool &threadPool) :
+    threadPool(threadPool),
+    unfinishedTaskCount(0),
+    errorMutex(),
+    error() {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TaskGroup::~TaskGroup() {
+    this->threadPool.waitFor(*this);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void TaskGroup::Wait() {
+    this->threadPool.waitFor(*this);
+
+    std::exception_ptr firstError;
+    {
+      std::unique_lock<std::mutex> errorLock(this->errorMutex);
+      firstError = this->error;
+      this->error = std::exception_ptr();
+    }
+    if(firstError) {
+      std::rethrow_exception(firstError);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
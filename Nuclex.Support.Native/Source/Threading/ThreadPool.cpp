@@ -0,0 +1,527 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Threading/ThreadPool.h"
+#include "Nuclex/Support/Threading/TaskGroup.h"
+#include "Nuclex/Support/Threading/NumaTopology.h"
+
+#include <algorithm> // for std::min()
+#include <atomic> // for std::atomic
+#include <condition_variable> // for std::condition_variable
+#include <deque> // for std::deque
+#include <exception> // for std::exception_ptr
+#include <memory> // for std::unique_ptr
+#include <mutex> // for std::mutex
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Task waiting in one of the thread pool's queues</summary>
+  struct QueuedTask {
+
+    /// <summary>Function that carries out the task</summary>
+    public: std::function<void()> Function;
+    /// <summary>Task group that will be notified when the task has finished, if any</summary>
+    public: Nuclex::Support::Threading::TaskGroup *Group;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Queue of tasks owned by a worker thread or shared by outside threads</summary>
+  struct TaskQueue {
+
+    /// <summary>Must be held while accessing the tasks</summary>
+    public: std::mutex Mutex;
+    /// <summary>Tasks that have been scheduled into this queue</summary>
+    public: std::deque<QueuedTask> Tasks;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Thread pool the calling thread is a worker of, if any</summary>
+  thread_local const void *currentThreadPool = nullptr;
+
+  /// <summary>Index of the calling thread's own task queue in its thread pool</summary>
+  thread_local std::size_t currentQueueIndex = 0;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  struct ThreadPool::Implementation {
+
+    /// <summary>Initializes a new thread pool implementation</summary>
+    /// <param name="workerCount">Number of worker threads there will be</param>
+    public: Implementation(std::size_t workerCount) :
+      Queues(),
+      QueueNodes(workerCount + 1, 0),
+      NodeCount(1),
+      Workers(),
+      QueuedTaskCount(0),
+      WakeMutex(),
+      WakeUp(),
+      ShuttingDown(false) {
+      Queues.reserve(workerCount + 1);
+      for(std::size_t index = 0; index < workerCount + 1; ++index) {
+        Queues.emplace_back(new TaskQueue());
+      }
+    }
+
+    /// <summary>Index of the queue shared by all threads outside of the pool</summary>
+    /// <returns>The index of the shared queue</returns>
+    public: std::size_t GetSharedQueueIndex() const {
+      return this->Queues.size() - 1;
+    }
+
+    /// <summary>Looks up the queue the calling thread should use</summary>
+    /// <returns>The index of the calling thread's own queue</returns>
+    public: std::size_t GetCallingThreadQueueIndex() const {
+      if(currentThreadPool == this) {
+        return currentQueueIndex;
+      } else {
+        return GetSharedQueueIndex();
+      }
+    }
+
+    /// <summary>Adds a task to the specified queue and wakes up a thread for it</summary>
+    /// <param name="queueIndex">Index of the queue the task will be added to</param>
+    /// <param name="task">Task that will be added to the queue</param>
+    public: void Push(std::size_t queueIndex, QueuedTask &&task) {
+      TaskQueue &queue = *this->Queues[queueIndex];
+      {
+        std::unique_lock<std::mutex> queueLock(queue.Mutex);
+        queue.Tasks.push_back(std::move(task));
+      }
+      {
+        std::unique_lock<std::mutex> wakeLock(this->WakeMutex);
+        this->QueuedTaskCount.fetch_add(1, std::memory_order_release);
+      }
+      this->WakeUp.notify_one();
+    }
+
+    /// <summary>Takes a task from the thread's own queue or steals one from another</summary>
+    /// <param name="ownQueueIndex">Index of the calling thread's own queue</param>
+    /// <param name="task">Receives the task that was taken</param>
+    /// <returns>True if a task was taken, false if all queues were empty</returns>
+    /// <remarks>
+    ///   A worker takes the newest task from its own queue, which likely works on data
+    ///   it has just touched. Tasks are stolen from the other end, where the oldest and
+    ///   usually largest pieces of work are. Queues of workers on the same NUMA node
+    ///   are robbed before those of workers on other nodes.
+    /// </remarks>
+    public: bool TryTake(std::size_t ownQueueIndex, QueuedTask &task) {
+      if(ownQueueIndex != GetSharedQueueIndex()) {
+        TaskQueue &queue = *this->Queues[ownQueueIndex];
+        std::unique_lock<std::mutex> queueLock(queue.Mutex);
+        if(!queue.Tasks.empty()) {
+          task = std::move(queue.Tasks.back());
+          queue.Tasks.pop_back();
+          this->QueuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+
+      if(this->NodeCount > 1) {
+        if(TrySteal(ownQueueIndex, true, task)) {
+          return true;
+        }
+        return TrySteal(ownQueueIndex, false, task);
+      } else {
+        return TrySteal(ownQueueIndex, false, task);
+      }
+    }
+
+    /// <summary>Takes the oldest task from the queue of another thread</summary>
+    /// <param name="ownQueueIndex">Index of the calling thread's own queue</param>
+    /// <param name="sameNodeOnly">
+    ///   Whether to only rob the queues of threads on the calling thread's NUMA node.
+    ///   The shared queue is considered to be on every node.
+    /// </param>
+    /// <param name="task">Receives the task that was taken</param>
+    /// <returns>True if a task was taken, false if the searched queues were empty</returns>
+    public: bool TrySteal(std::size_t ownQueueIndex, bool sameNodeOnly, QueuedTask &task) {
+      std::size_t queueCount = this->Queues.size();
+      std::size_t sharedQueueIndex = GetSharedQueueIndex();
+      std::size_t ownNode = this->QueueNodes[ownQueueIndex];
+
+      for(std::size_t offset = 0; offset < queueCount; ++offset) {
+        std::size_t index = (ownQueueIndex + 1 + offset) % queueCount;
+        if((index == ownQueueIndex) && (index != sharedQueueIndex)) {
+          continue;
+        }
+        if(sameNodeOnly && (index != sharedQueueIndex) && (this->QueueNodes[index] != ownNode)) {
+          continue;
+        }
+
+        TaskQueue &queue = *this->Queues[index];
+        std::unique_lock<std::mutex> queueLock(queue.Mutex);
+        if(!queue.Tasks.empty()) {
+          task = std::move(queue.Tasks.front());
+          queue.Tasks.pop_front();
+          this->QueuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /// <summary>Runs a task and notifies its task group</summary>
+    /// <param name="task">Task that will be run</param>
+    public: void Execute(QueuedTask &task) {
+      if(task.Group == nullptr) {
+        task.Function(); // Tasks posted without a group handle their own errors
+        task.Function = nullptr;
+        return;
+      }
+
+      TaskGroup &group = *task.Group;
+      try {
+        task.Function();
+      }
+      catch(...) {
+        std::unique_lock<std::mutex> errorLock(group.errorMutex);
+        if(!group.error) {
+          group.error = std::current_exception();
+        }
+      }
+
+      // Release the task's captured state while the group is still waiting for it
+      task.Function = nullptr;
+
+      // The group may be destroyed the moment its last task reports in, so only
+      // the thread pool is touched after the counter has been decremented
+      if(group.unfinishedTaskCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::unique_lock<std::mutex> wakeLock(this->WakeMutex);
+        this->WakeUp.notify_all();
+      }
+    }
+
+    /// <summary>Keeps processing tasks until the thread pool shuts down</summary>
+    /// <param name="queueIndex">Index of the worker's own task queue</param>
+    /// <param name="coreIndices">CPU cores the worker should be pinned to, if any</param>
+    public: void RunWorker(std::size_t queueIndex, const std::vector<std::size_t> &coreIndices) {
+      currentThreadPool = this;
+      currentQueueIndex = queueIndex;
+      if(!coreIndices.empty()) {
+        NumaTopology::PinCallingThreadToCores(coreIndices);
+      }
+
+      QueuedTask task;
+      for(;;) {
+        if(TryTake(queueIndex, task)) {
+          Execute(task);
+          continue;
+        }
+
+        std::unique_lock<std::mutex> wakeLock(this->WakeMutex);
+        this->WakeUp.wait(
+          wakeLock,
+          [this] {
+            return (
+              this->ShuttingDown ||
+              (this->QueuedTaskCount.load(std::memory_order_acquire) > 0)
+            );
+          }
+        );
+        if(this->ShuttingDown) {
+          return;
+        }
+      }
+    }
+
+    /// <summary>Processes tasks until the specified condition is met</summary>
+    /// <typeparam name="TCondition">Callable object that checks the condition</typeparam>
+    /// <param name="isMet">Returns true when waiting should end</param>
+    /// <remarks>
+    ///   Whoever makes the condition true has to notify <see cref="WakeUp" /> while
+    ///   holding <see cref="WakeMutex" /> or the waiting thread may keep sleeping.
+    /// </remarks>
+    public: template<typename TCondition>
+    void HelpUntil(const TCondition &isMet) {
+      std::size_t queueIndex = GetCallingThreadQueueIndex();
+
+      QueuedTask task;
+      while(!isMet()) {
+        if(TryTake(queueIndex, task)) {
+          Execute(task);
+          continue;
+        }
+
+        std::unique_lock<std::mutex> wakeLock(this->WakeMutex);
+        this->WakeUp.wait(
+          wakeLock,
+          [this, &isMet] {
+            return (isMet() || (this->QueuedTaskCount.load(std::memory_order_acquire) > 0));
+          }
+        );
+      }
+    }
+
+    /// <summary>Task queues of the workers followed by the shared queue</summary>
+    public: std::vector<std::unique_ptr<TaskQueue>> Queues;
+    /// <summary>Index of the NUMA node the owner of each queue is pinned to</summary>
+    public: std::vector<std::size_t> QueueNodes;
+    /// <summary>Number of NUMA nodes the worker threads have been spread over</summary>
+    public: std::size_t NodeCount;
+    /// <summary>Worker threads that have been started</summary>
+    public: std::vector<std::thread> Workers;
+    /// <summary>Number of tasks waiting in any of the queues</summary>
+    public: std::atomic<std::size_t> QueuedTaskCount;
+    /// <summary>Must be held while checking whether to go to sleep</summary>
+    public: std::mutex WakeMutex;
+    /// <summary>Wakes up sleeping threads when tasks arrive or a group finishes</summary>
+    public: std::condition_variable WakeUp;
+    /// <summary>Set when the worker threads should exit</summary>
+    public: bool ShuttingDown;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ThreadPool::ThreadPool(std::size_t threadCount /* = 0 */, bool pinThreadsToCores /* = false */) :
+    ThreadPool(threadCount, pinThreadsToCores ? ThreadPinning::Cores : ThreadPinning::None) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ThreadPool::ThreadPool(std::size_t threadCount, ThreadPinning pinning) :
+    implementation(nullptr) {
+    std::size_t coreCount = std::thread::hardware_concurrency();
+    if(coreCount == 0) {
+      coreCount = 1;
+    }
+    if(threadCount == 0) {
+      threadCount = coreCount;
+    }
+
+    const NumaTopology &topology = NumaTopology::Get();
+
+    std::unique_ptr<Implementation> newImplementation(new Implementation(threadCount - 1));
+    if(pinning == ThreadPinning::NumaNodes) {
+      newImplementation->NodeCount = std::min(topology.CountNodes(), threadCount);
+
+      // Thread 0 is the application's thread, give each node a contiguous group. This
+      // has to be settled before any worker starts looking at the other queues.
+      for(std::size_t index = 0; index < threadCount - 1; ++index) {
+        newImplementation->QueueNodes[index] = (
+          (index + 1) * newImplementation->NodeCount / threadCount
+        );
+      }
+    }
+
+    try {
+      for(std::size_t index = 0; index < threadCount - 1; ++index) {
+        std::vector<std::size_t> coreIndices;
+        if(pinning == ThreadPinning::Cores) {
+          coreIndices.push_back((index + 1) % coreCount); // Core 0 is left to the app
+        } else if(pinning == ThreadPinning::NumaNodes) {
+          coreIndices = topology.Nodes[newImplementation->QueueNodes[index]].Cores;
+        }
+
+        Implementation *target = newImplementation.get();
+        newImplementation->Workers.emplace_back(
+          [target, index, coreIndices]() { target->RunWorker(index, coreIndices); }
+        );
+      }
+    }
+    catch(...) {
+      {
+        std::unique_lock<std::mutex> wakeLock(newImplementation->WakeMutex);
+        newImplementation->ShuttingDown = true;
+      }
+      newImplementation->WakeUp.notify_all();
+      for(std::size_t index = 0; index < newImplementation->Workers.size(); ++index) {
+        newImplementation->Workers[index].join();
+      }
+      throw;
+    }
+
+    this->implementation = newImplementation.release();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::unique_lock<std::mutex> wakeLock(this->implementation->WakeMutex);
+      this->implementation->ShuttingDown = true;
+    }
+    this->implementation->WakeUp.notify_all();
+
+    for(std::size_t index = 0; index < this->implementation->Workers.size(); ++index) {
+      this->implementation->Workers[index].join();
+    }
+
+    delete this->implementation;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ThreadPool::CountThreads() const {
+    return this->implementation->Workers.size() + 1;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t ThreadPool::CountNumaNodes() const {
+    return this->implementation->NodeCount;
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ThreadPool::runForEach(
+    std::size_t taskCount, std::size_t grainSize, TaskFunction *function, void *task
+  ) {
+    if(taskCount == 0) {
+      return;
+    }
+
+    std::size_t threadCount = CountThreads();
+    if(grainSize == 0) {
+      grainSize = taskCount / (threadCount * 4); // A few chunks per thread to even out load
+      if(grainSize == 0) {
+        grainSize = 1;
+      }
+    }
+
+    std::size_t chunkCount = (taskCount + grainSize - 1) / grainSize;
+    if((chunkCount == 1) || (threadCount == 1)) {
+      for(std::size_t index = 0; index < taskCount; ++index) {
+        function(task, index);
+      }
+      return;
+    }
+
+    std::atomic<std::size_t> nextChunkIndex(0);
+    std::atomic<bool> hasFailed(false);
+    auto processChunks = [&]() {
+      for(;;) {
+        if(hasFailed.load(std::memory_order_relaxed)) {
+          return;
+        }
+
+        std::size_t chunkIndex = nextChunkIndex.fetch_add(1, std::memory_order_relaxed);
+        if(chunkIndex >= chunkCount) {
+          return;
+        }
+
+        std::size_t startIndex = chunkIndex * grainSize;
+        std::size_t endIndex = std::min(startIndex + grainSize, taskCount);
+        try {
+          for(std::size_t index = startIndex; index < endIndex; ++index) {
+            function(task, index);
+          }
+        }
+        catch(...) {
+          hasFailed.store(true, std::memory_order_relaxed);
+          throw;
+        }
+      }
+    };
+
+    TaskGroup group(*this);
+    std::size_t helperCount = std::min(chunkCount, threadCount) - 1;
+    for(std::size_t index = 0; index < helperCount; ++index) {
+      group.Run(processChunks);
+    }
+
+    std::exception_ptr error;
+    try {
+      processChunks();
+    }
+    catch(...) {
+      error = std::current_exception();
+    }
+
+    if(error) {
+      try {
+        group.Wait();
+      }
+      catch(...) {
+        // The calling thread's exception is the one that will be reported
+      }
+      std::rethrow_exception(error);
+    }
+
+    group.Wait();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ThreadPool::schedule(TaskGroup &group, std::function<void()> &&task) {
+    group.unfinishedTaskCount.fetch_add(1, std::memory_order_relaxed);
+
+    QueuedTask newTask;
+    newTask.Function = std::move(task);
+    newTask.Group = &group;
+    this->implementation->Push(
+      this->implementation->GetCallingThreadQueueIndex(), std::move(newTask)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ThreadPool::waitFor(TaskGroup &group) {
+    this->implementation->HelpUntil(
+      [&group] { return (group.unfinishedTaskCount.load(std::memory_order_acquire) == 0); }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ThreadPool::post(std::function<void()> &&task) {
+    QueuedTask newTask;
+    newTask.Function = std::move(task);
+    newTask.Group = nullptr;
+    this->implementation->Push(
+      this->implementation->GetCallingThreadQueueIndex(), std::move(newTask)
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ThreadPool::helpUntil(const std::atomic<bool> &isDone) {
+    this->implementation->HelpUntil(
+      [&isDone] { return isDone.load(std::memory_order_acquire); }
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  void ThreadPool::wakeHelpers() {
+    std::unique_lock<std::mutex> wakeLock(this->implementation->WakeMutex);
+    this->implementation->WakeUp.notify_all();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
@@ -25,6 +25,7 @@ License along with this library
 #include "Nuclex/Support/Text/Lexical.h"
 #include "Nuclex/Support/Text/StringConverter.h"
 
+#include <algorithm> // for std::copy_n()
 #include <stdexcept>
 
 namespace {
@@ -565,6 +566,73 @@ namespace Nuclex { namespace Support {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void Variant::ToString(std::string &target) const {
+    switch(this->type) {
+      case VariantType::Empty:
+      case VariantType::Any: { target.clear(); break; }
+      case VariantType::String: {
+        target = *reinterpret_cast<const std::string *>(this->stringValueBytes);
+        break;
+      }
+      case VariantType::WString: {
+        const std::wstring &wstringValue = (
+          *reinterpret_cast<const std::wstring *>(this->wstringValueBytes)
+        );
+        target.clear();
+        Text::StringConverter::AppendUtf8FromWide(
+          target, wstringValue.c_str(), wstringValue.length()
+        );
+        break;
+      }
+      default: {
+        char printed[Text::MaximumLexicalPrintLength];
+        char *printedEnd = printScalar(printed);
+        if(printedEnd == nullptr) {
+          throw std::runtime_error(InvalidVariantTypeExceptionMessage);
+        }
+        target.assign(printed, printedEnd);
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  std::size_t Variant::ToString(char *buffer, std::size_t bufferLength) const {
+    switch(this->type) {
+      case VariantType::Empty:
+      case VariantType::Any: { return 0; }
+      case VariantType::String: {
+        const std::string &stringValue = (
+          *reinterpret_cast<const std::string *>(this->stringValueBytes)
+        );
+        std::size_t length = stringValue.length();
+        stringValue.copy(buffer, (length < bufferLength) ? length : bufferLength);
+        return length;
+      }
+      case VariantType::WString: {
+        const std::wstring &wstringValue = (
+          *reinterpret_cast<const std::wstring *>(this->wstringValueBytes)
+        );
+        return Text::StringConverter::Utf8FromWide(
+          wstringValue.c_str(), wstringValue.length(), buffer, bufferLength
+        );
+      }
+      default: {
+        char printed[Text::MaximumLexicalPrintLength];
+        char *printedEnd = printScalar(printed);
+        if(printedEnd == nullptr) {
+          throw std::runtime_error(InvalidVariantTypeExceptionMessage);
+        }
+        std::size_t length = static_cast<std::size_t>(printedEnd - printed);
+        std::copy_n(printed, (length < bufferLength) ? length : bufferLength, buffer);
+        return length;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   std::wstring Variant::ToWString() const {
     static std::wstring emptyString;
     static std::wstring trueString(L"1", 1);
@@ -603,6 +671,38 @@ namespace Nuclex { namespace Support {
 
   // ------------------------------------------------------------------------------------------- //
 
+  void Variant::ToWString(std::wstring &target) const {
+    switch(this->type) {
+      case VariantType::Empty:
+      case VariantType::Any: { target.clear(); break; }
+      case VariantType::String: {
+        const std::string &stringValue = (
+          *reinterpret_cast<const std::string *>(this->stringValueBytes)
+        );
+        target.clear();
+        Text::StringConverter::AppendWideFromUtf8(
+          target, stringValue.c_str(), stringValue.length()
+        );
+        break;
+      }
+      case VariantType::WString: {
+        target = *reinterpret_cast<const std::wstring *>(this->wstringValueBytes);
+        break;
+      }
+      default: {
+        char printed[Text::MaximumLexicalPrintLength];
+        char *printedEnd = printScalar(printed);
+        if(printedEnd == nullptr) {
+          throw std::runtime_error(InvalidVariantTypeExceptionMessage);
+        }
+        target.assign(printed, printedEnd); // Printed numbers are pure ASCII
+        break;
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   Any Variant::ToAny() const {
     switch(this->type) {
       case VariantType::Empty: { return Any(nullptr); }
@@ -692,6 +792,34 @@ namespace Nuclex { namespace Support {
 
   // ------------------------------------------------------------------------------------------- //
 
+  char *Variant::printScalar(char *target) const {
+    switch(this->type) {
+      case VariantType::Boolean: { // Variants print booleans as numbers, not as words
+        *target = this->booleanValue ? '1' : '0';
+        return target + 1;
+      }
+      case VariantType::Uint8: { return Text::lexical_print(this->uint8Value, target); }
+      case VariantType::Int8: { return Text::lexical_print(this->int8Value, target); }
+      case VariantType::Uint16: { return Text::lexical_print(this->uint16Value, target); }
+      case VariantType::Int16: { return Text::lexical_print(this->int16Value, target); }
+      case VariantType::Uint32: { return Text::lexical_print(this->uint32Value, target); }
+      case VariantType::Int32: { return Text::lexical_print(this->int32Value, target); }
+      case VariantType::Uint64: { return Text::lexical_print(this->uint64Value, target); }
+      case VariantType::Int64: { return Text::lexical_print(this->int64Value, target); }
+      case VariantType::Float: { return Text::lexical_print(this->floatValue, target); }
+      case VariantType::Double: { return Text::lexical_print(this->doubleValue, target); }
+      case VariantType::VoidPointer: {
+        return Text::lexical_print(
+          static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(this->pointerValue)),
+          target
+        );
+      }
+      default: { return nullptr; }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   Variant &Variant::operator =(const Variant &other) {
     free();
 
@@ -0,0 +1,190 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/AllocationTracker.h"
+#include "Nuclex/Support/Events/Event.h"
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uintptr_t
+#include <cstring> // for std::memset()
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Enables allocation tracking for as long as the scope exists</summary>
+  class TrackingScope {
+
+    /// <summary>Enables allocation tracking and takes an initial snapshot</summary>
+    public: TrackingScope() :
+      wasEnabled(Nuclex::Support::AllocationTracker::IsEnabled()) {
+      Nuclex::Support::AllocationTracker::SetEnabled(true);
+      this->initial = Nuclex::Support::AllocationTracker::TakeSnapshot();
+    }
+
+    /// <summary>Restores the previous tracking state</summary>
+    public: ~TrackingScope() {
+      Nuclex::Support::AllocationTracker::SetEnabled(this->wasEnabled);
+    }
+
+    /// <summary>Retrieves the allocations a subsystem made since the scope began</summary>
+    /// <param name="subsystem">Subsystem whose allocations will be returned</param>
+    /// <returns>The totals of the subsystem minus those when the scope began</returns>
+    public: Nuclex::Support::AllocationTracker::Totals GetChange(
+      Nuclex::Support::AllocationSubsystem subsystem
+    ) const {
+      const Nuclex::Support::AllocationTracker::Totals &before = this->initial[subsystem];
+      Nuclex::Support::AllocationTracker::Totals after = (
+        Nuclex::Support::AllocationTracker::TakeSnapshot()[subsystem]
+      );
+
+      after.AllocationCount -= before.AllocationCount;
+      after.FreeCount -= before.FreeCount;
+      after.AllocatedByteCount -= before.AllocatedByteCount;
+      after.FreedByteCount -= before.FreedByteCount;
+      return after;
+    }
+
+    /// <summary>Whether tracking was enabled before the scope began</summary>
+    private: bool wasEnabled;
+    /// <summary>Allocation totals at the time the scope began</summary>
+    private: Nuclex::Support::AllocationTracker::Snapshot initial;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Does nothing, used to subscribe to events</summary>
+  void doNothing(int) {}
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AllocationTrackerTest, AllocationsAreCountedPerSubsystem) {
+    TrackingScope scope;
+
+    void *memory = AllocationTracker::Allocate(AllocationSubsystem::Bitmaps, 1000);
+    std::memset(memory, 0, 1000);
+
+    AllocationTracker::Totals bitmaps = scope.GetChange(AllocationSubsystem::Bitmaps);
+    EXPECT_EQ(bitmaps.AllocationCount, 1U);
+    EXPECT_EQ(bitmaps.AllocatedByteCount, 1000U);
+    EXPECT_EQ(bitmaps.FreeCount, 0U);
+
+    AllocationTracker::Deallocate(AllocationSubsystem::Bitmaps, memory, 1000);
+
+    bitmaps = scope.GetChange(AllocationSubsystem::Bitmaps);
+    EXPECT_EQ(bitmaps.FreeCount, 1U);
+    EXPECT_EQ(bitmaps.FreedByteCount, 1000U);
+
+    AllocationTracker::Totals xml = scope.GetChange(AllocationSubsystem::Xml);
+    EXPECT_EQ(xml.AllocationCount, 0U);
+    EXPECT_EQ(xml.FreeCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AllocationTrackerTest, NothingIsCountedWhileDisabled) {
+    TrackingScope scope;
+    AllocationTracker::SetEnabled(false);
+
+    void *memory = AllocationTracker::Allocate(AllocationSubsystem::General, 100);
+    AllocationTracker::Deallocate(AllocationSubsystem::General, memory, 100);
+    AllocationTracker::RecordAllocation(AllocationSubsystem::General, 100);
+
+    AllocationTracker::Totals general = scope.GetChange(AllocationSubsystem::General);
+    EXPECT_EQ(general.AllocationCount, 0U);
+    EXPECT_EQ(general.FreeCount, 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AllocationTrackerTest, MallocRemembersAllocationSize) {
+    TrackingScope scope;
+
+    void *memory = AllocationTracker::Malloc(AllocationSubsystem::Compression, 100);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(memory) % alignof(std::max_align_t), 0U);
+    std::memset(memory, 1, 100);
+
+    memory = AllocationTracker::Realloc(AllocationSubsystem::Compression, memory, 300);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(static_cast<std::uint8_t *>(memory)[99], 1U);
+    AllocationTracker::Free(AllocationSubsystem::Compression, memory);
+    AllocationTracker::Free(AllocationSubsystem::Compression, nullptr);
+
+    AllocationTracker::Totals compression = scope.GetChange(AllocationSubsystem::Compression);
+    EXPECT_EQ(compression.AllocationCount, 2U);
+    EXPECT_EQ(compression.AllocatedByteCount, 400U);
+    EXPECT_EQ(compression.FreeCount, 2U);
+    EXPECT_EQ(compression.FreedByteCount, 400U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AllocationTrackerTest, StandardContainersCanUseTrackingAllocator) {
+    TrackingScope scope;
+    {
+      std::vector<int, TrackingAllocator<int, AllocationSubsystem::General>> values;
+      values.reserve(64);
+      for(int index = 0; index < 64; ++index) {
+        values.push_back(index);
+      }
+      EXPECT_EQ(values[63], 63);
+    }
+
+    AllocationTracker::Totals general = scope.GetChange(AllocationSubsystem::General);
+    EXPECT_EQ(general.AllocationCount, 1U);
+    EXPECT_EQ(general.AllocatedByteCount, sizeof(int) * 64);
+    EXPECT_EQ(general.FreedByteCount, general.AllocatedByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AllocationTrackerTest, EventSubscriberListsAreCounted) {
+    TrackingScope scope;
+    {
+      Events::Event<void(int)> test;
+      for(std::size_t index = 0; index < 10; ++index) {
+        test.Subscribe<doNothing>();
+      }
+      for(std::size_t index = 0; index < 10; ++index) {
+        test.Unsubscribe<doNothing>();
+      }
+    }
+
+    AllocationTracker::Totals events = scope.GetChange(AllocationSubsystem::Events);
+    EXPECT_GT(events.AllocationCount, 0U);
+    EXPECT_EQ(events.FreeCount, events.AllocationCount);
+    EXPECT_EQ(events.FreedByteCount, events.AllocatedByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -24,6 +24,9 @@ License along with this library
 #include "Nuclex/Support/Any.h"
 #include <gtest/gtest.h>
 
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
@@ -170,4 +173,48 @@ namespace Nuclex { namespace Support {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(AnyTest, SharedPointersSurviveCopiesAndMoves) {
+    std::shared_ptr<int> value = std::make_shared<int>(42);
+    {
+      Any test(value);
+      EXPECT_EQ(value.use_count(), 2);
+
+      Any copy(test);
+      EXPECT_EQ(value.use_count(), 3);
+
+      Any moved(std::move(test));
+      EXPECT_FALSE(test.HasValue());
+      EXPECT_EQ(value.use_count(), 3);
+      EXPECT_EQ(*moved.Get<std::shared_ptr<int>>(), 42);
+
+      copy = moved;
+      EXPECT_EQ(value.use_count(), 3);
+      copy.Reset();
+      EXPECT_EQ(value.use_count(), 2);
+    }
+    EXPECT_EQ(value.use_count(), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AnyTest, LargeValuesCanBeStored) {
+    std::string text(u8"This string is too long to fit into the small string buffer");
+    Any test(text);
+    Any copy(test);
+    Any moved(std::move(test));
+
+    EXPECT_EQ(copy.Get<std::string>(), text);
+    EXPECT_EQ(moved.Get<std::string>(), text);
+    EXPECT_THROW(moved.Get<std::shared_ptr<int>>(), std::bad_cast);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(AnyTest, AccessingEmptyAnyThrowsException) {
+    Any test;
+    EXPECT_THROW(test.Get<int>(), std::bad_cast);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Support
@@ -0,0 +1,87 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/ChromeTraceSink.h"
+#include <gtest/gtest.h>
+
+#include <sstream> // for std::ostringstream
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChromeTraceSinkTest, ZonesBecomeCompleteEvents) {
+    static const InstrumentationSite site = { u8"Tests.\"Quoted\"", __FILE__, __LINE__ };
+
+    ChromeTraceSink sink;
+    sink.ZoneLeft(site, 1234567, 2500);
+    EXPECT_EQ(sink.CountEvents(), 1U);
+
+    std::ostringstream stream;
+    sink.WriteTo(stream);
+    std::string trace = stream.str();
+
+    EXPECT_NE(trace.find(u8"\"name\":\"Tests.\\\"Quoted\\\"\""), std::string::npos);
+    EXPECT_NE(trace.find(u8"\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find(u8"\"ts\":1234.567"), std::string::npos);
+    EXPECT_NE(trace.find(u8"\"dur\":2.500"), std::string::npos);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChromeTraceSinkTest, CountersAndHistogramsBecomeCounterEvents) {
+    Counter counter(u8"Tests.TraceCounter");
+    counter.Add(42);
+    Histogram histogram(u8"Tests.TraceHistogram");
+    histogram.Record(6);
+
+    ChromeTraceSink sink;
+    Instrumentation::Report(sink);
+
+    std::ostringstream stream;
+    sink.WriteTo(stream);
+    std::string trace = stream.str();
+
+    EXPECT_NE(trace.find(u8"\"ph\":\"C\""), std::string::npos);
+    EXPECT_NE(trace.find(u8"\"args\":{\"value\":42}"), std::string::npos);
+    EXPECT_NE(trace.find(u8"\"args\":{\"<2^3\":1}"), std::string::npos);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ChromeTraceSinkTest, ClearDiscardsEvents) {
+    static const InstrumentationSite site = { u8"Tests.Zone", __FILE__, __LINE__ };
+
+    ChromeTraceSink sink;
+    sink.ZoneLeft(site, 0, 0);
+    sink.Clear();
+    EXPECT_EQ(sink.CountEvents(), 0U);
+
+    std::ostringstream stream;
+    sink.WriteTo(stream);
+    EXPECT_EQ(stream.str(), u8"{\"traceEvents\":[\n]}\n");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
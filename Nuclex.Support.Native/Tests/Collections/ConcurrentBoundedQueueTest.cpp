@@ -0,0 +1,167 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Collections/ConcurrentBoundedQueue.h"
+#include <gtest/gtest.h>
+
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentBoundedQueueTest, CapacityIsRoundedToPowerOfTwo) {
+    ConcurrentBoundedQueue<int> queue(100);
+    EXPECT_EQ(queue.GetCapacity(), 128U);
+    EXPECT_EQ(queue.Count(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentBoundedQueueTest, ItemsComeOutInOrder) {
+    ConcurrentBoundedQueue<int> queue(4);
+
+    EXPECT_TRUE(queue.TryEnqueue(1));
+    EXPECT_TRUE(queue.TryEnqueue(2));
+    int items[] = { 3, 4, 5 };
+    EXPECT_EQ(queue.TryEnqueue(items, 3), 2U);
+    EXPECT_FALSE(queue.TryEnqueue(6));
+    EXPECT_EQ(queue.Count(), 4U);
+
+    int item = 0;
+    EXPECT_TRUE(queue.TryDequeue(item));
+    EXPECT_EQ(item, 1);
+
+    // This one wraps around the end of the ring
+    EXPECT_TRUE(queue.TryEnqueue(5));
+
+    int retrieved[8];
+    EXPECT_EQ(queue.TryDequeue(retrieved, 8), 4U);
+    EXPECT_EQ(retrieved[0], 2);
+    EXPECT_EQ(retrieved[1], 3);
+    EXPECT_EQ(retrieved[2], 4);
+    EXPECT_EQ(retrieved[3], 5);
+    EXPECT_FALSE(queue.TryDequeue(item));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentBoundedQueueTest, NonTrivialItemsAreDestroyed) {
+    std::shared_ptr<int> tracker = std::make_shared<int>(123);
+    {
+      ConcurrentBoundedQueue<std::shared_ptr<int>> queue(4);
+
+      std::shared_ptr<int> items[] = { tracker, tracker };
+      queue.TryEnqueue(items, 2);
+      queue.TryEnqueue(std::shared_ptr<int>(tracker));
+      EXPECT_EQ(tracker.use_count(), 6);
+
+      std::shared_ptr<int> retrieved;
+      ASSERT_TRUE(queue.TryDequeue(retrieved));
+      EXPECT_EQ(tracker.use_count(), 6);
+      EXPECT_EQ(*retrieved, 123);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentBoundedQueueTest, ItemsWithThrowingCopyConstructorCanBeQueued) {
+    ConcurrentBoundedQueue<std::string> queue(2);
+
+    std::string items[] = { u8"Hello", u8"World", u8"!" };
+    EXPECT_EQ(queue.TryEnqueue(items, 3), 2U);
+
+    std::string item;
+    queue.Dequeue(item);
+    EXPECT_EQ(item, u8"Hello");
+    queue.Enqueue(items[2]);
+    queue.Dequeue(item);
+    EXPECT_EQ(item, u8"World");
+    queue.Dequeue(item);
+    EXPECT_EQ(item, u8"!");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentBoundedQueueTest, ManyProducersAndConsumersCanRunConcurrently) {
+    const std::size_t ThreadCount = 4;
+    const std::size_t ItemsPerThread = 20000;
+    ConcurrentBoundedQueue<std::size_t> queue(64);
+
+    std::vector<std::thread> producers;
+    for(std::size_t thread = 0; thread < ThreadCount; ++thread) {
+      producers.emplace_back(
+        [&queue, thread, ItemsPerThread]() {
+          for(std::size_t index = 0; index < ItemsPerThread; ++index) {
+            queue.Enqueue(thread * ItemsPerThread + index);
+          }
+        }
+      );
+    }
+
+    std::vector<std::vector<std::size_t>> received(ThreadCount);
+    std::vector<std::thread> consumers;
+    for(std::size_t thread = 0; thread < ThreadCount; ++thread) {
+      consumers.emplace_back(
+        [&queue, &received, thread, ItemsPerThread]() {
+          std::size_t item;
+          for(std::size_t index = 0; index < ItemsPerThread; ++index) {
+            queue.Dequeue(item);
+            received[thread].push_back(item);
+          }
+        }
+      );
+    }
+
+    for(std::size_t thread = 0; thread < ThreadCount; ++thread) {
+      producers[thread].join();
+      consumers[thread].join();
+    }
+
+    // Each item must have arrived exactly once, in the order its producer sent it
+    std::vector<bool> seen(ThreadCount * ItemsPerThread, false);
+    bool allUnique = true, allInOrder = true;
+    for(std::size_t thread = 0; thread < ThreadCount; ++thread) {
+      std::vector<std::size_t> lastPerProducer(ThreadCount, 0);
+      for(std::size_t item : received[thread]) {
+        allUnique &= !seen[item];
+        seen[item] = true;
+
+        std::size_t producer = item / ItemsPerThread;
+        allInOrder &= (item + 1 > lastPerProducer[producer]);
+        lastPerProducer[producer] = item + 1;
+      }
+    }
+
+    EXPECT_TRUE(allUnique);
+    EXPECT_TRUE(allInOrder);
+    EXPECT_EQ(queue.Count(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
@@ -0,0 +1,166 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Collections/ConcurrentObjectPool.h"
+#include <gtest/gtest.h>
+
+#include <atomic> // for std::atomic
+#include <memory> // for std::shared_ptr
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Object that remembers whether it is currently lent out</summary>
+  class TrackedObject {
+
+    /// <summary>Initializes a new tracked object</summary>
+    /// <param name="instanceCount">Counter that tracks the number of live objects</param>
+    public: TrackedObject(std::shared_ptr<std::atomic<int>> instanceCount) :
+      instanceCount(instanceCount),
+      IsInUse(false) {
+      ++(*this->instanceCount);
+    }
+
+    /// <summary>Destroys the tracked object</summary>
+    public: ~TrackedObject() {
+      --(*this->instanceCount);
+    }
+
+    /// <summary>Counter that tracks the number of live objects</summary>
+    private: std::shared_ptr<std::atomic<int>> instanceCount;
+    /// <summary>Whether a thread is currently using the object</summary>
+    public: std::atomic<bool> IsInUse;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentObjectPoolTest, EmptyPoolHasNoIdleObjects) {
+    ConcurrentObjectPool<int> pool;
+    EXPECT_EQ(pool.CountObjects(), 0U);
+
+    ConcurrentObjectPool<int>::Lease lease = pool.TryTake();
+    EXPECT_FALSE(static_cast<bool>(lease));
+    EXPECT_EQ(lease.Get(), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentObjectPoolTest, ReturnedObjectsAreReused) {
+    ConcurrentObjectPool<int> pool;
+
+    int *first;
+    {
+      ConcurrentObjectPool<int>::Lease lease = pool.Take(123);
+      ASSERT_TRUE(static_cast<bool>(lease));
+      EXPECT_EQ(*lease, 123);
+      first = lease.Get();
+    }
+    EXPECT_EQ(pool.CountObjects(), 1U);
+
+    // The returned object comes back as it was left, the argument is ignored
+    ConcurrentObjectPool<int>::Lease lease = pool.Take(456);
+    EXPECT_EQ(lease.Get(), first);
+    EXPECT_EQ(*lease, 123);
+    EXPECT_EQ(pool.CountObjects(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentObjectPoolTest, PoolGrowsToConcurrentlyUsedObjects) {
+    std::shared_ptr<std::atomic<int>> instanceCount = std::make_shared<std::atomic<int>>(0);
+    {
+      ConcurrentObjectPool<TrackedObject> pool;
+      {
+        std::vector<ConcurrentObjectPool<TrackedObject>::Lease> leases;
+        for(std::size_t index = 0; index < 100; ++index) {
+          leases.push_back(pool.Take(instanceCount));
+        }
+        EXPECT_EQ(instanceCount->load(), 100);
+
+        // Moving a lease must not return the object twice
+        ConcurrentObjectPool<TrackedObject>::Lease moved = std::move(leases.back());
+        leases.pop_back();
+        EXPECT_FALSE(static_cast<bool>(pool.TryTake()));
+      }
+      EXPECT_EQ(pool.CountObjects(), 100U);
+
+      {
+        std::vector<ConcurrentObjectPool<TrackedObject>::Lease> leases;
+        for(std::size_t index = 0; index < 100; ++index) {
+          leases.push_back(pool.TryTake());
+          EXPECT_TRUE(static_cast<bool>(leases.back()));
+        }
+        EXPECT_FALSE(static_cast<bool>(pool.TryTake()));
+      }
+      EXPECT_EQ(instanceCount->load(), 100);
+    }
+    EXPECT_EQ(instanceCount->load(), 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentObjectPoolTest, ObjectsAreNeverLentToTwoThreads) {
+    std::shared_ptr<std::atomic<int>> instanceCount = std::make_shared<std::atomic<int>>(0);
+    ConcurrentObjectPool<TrackedObject> pool;
+    std::atomic<bool> sharedObjectSeen(false);
+
+    std::vector<std::thread> threads;
+    for(std::size_t threadIndex = 0; threadIndex < 8; ++threadIndex) {
+      threads.emplace_back(
+        [&pool, &instanceCount, &sharedObjectSeen]() {
+          for(std::size_t iteration = 0; iteration < 20000; ++iteration) {
+            ConcurrentObjectPool<TrackedObject>::Lease first = pool.Take(instanceCount);
+            ConcurrentObjectPool<TrackedObject>::Lease second = pool.Take(instanceCount);
+            if(first->IsInUse.exchange(true) || second->IsInUse.exchange(true)) {
+              sharedObjectSeen.store(true);
+            }
+            first->IsInUse.store(false);
+            if((iteration & 1) != 0) {
+              first = ConcurrentObjectPool<TrackedObject>::Lease();
+            }
+            second->IsInUse.store(false);
+          }
+        }
+      );
+    }
+    for(std::size_t threadIndex = 0; threadIndex < threads.size(); ++threadIndex) {
+      threads[threadIndex].join();
+    }
+
+    EXPECT_FALSE(sharedObjectSeen.load());
+    EXPECT_LE(pool.CountObjects(), 16U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
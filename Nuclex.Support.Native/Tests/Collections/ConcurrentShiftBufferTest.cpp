@@ -0,0 +1,164 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Collections/ConcurrentShiftBuffer.h"
+#include <gtest/gtest.h>
+
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentShiftBufferTest, CapacityIsRoundedToPowerOfTwo) {
+    ConcurrentShiftBuffer<int> buffer(100);
+    EXPECT_EQ(buffer.GetCapacity(), 128U);
+    EXPECT_EQ(buffer.Count(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentShiftBufferTest, WritesAndReadsAreLimitedBySpace) {
+    ConcurrentShiftBuffer<int> buffer(8);
+
+    std::vector<int> items = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    EXPECT_EQ(buffer.Write(items.data(), 10), 8U);
+    EXPECT_EQ(buffer.Count(), 8U);
+    EXPECT_EQ(buffer.Write(items.data(), 1), 0U);
+
+    int retrieved[10];
+    EXPECT_EQ(buffer.Read(retrieved, 5), 5U);
+    EXPECT_EQ(retrieved[0], 1);
+    EXPECT_EQ(retrieved[4], 5);
+
+    // These wrap around the end of the ring
+    EXPECT_EQ(buffer.Write(items.data() + 8, 2), 2U);
+    EXPECT_EQ(buffer.Read(retrieved, 10), 5U);
+    EXPECT_EQ(retrieved[0], 6);
+    EXPECT_EQ(retrieved[2], 8);
+    EXPECT_EQ(retrieved[3], 9);
+    EXPECT_EQ(retrieved[4], 10);
+    EXPECT_EQ(buffer.Count(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentShiftBufferTest, AccessProvidesItemsUpToEndOfRing) {
+    ConcurrentShiftBuffer<int> buffer(4);
+
+    int items[] = { 1, 2, 3, 4 };
+    buffer.Write(items, 3);
+    EXPECT_EQ(buffer.Skip(2), 2U);
+    buffer.Write(items, 3);
+
+    std::size_t count = 0;
+    const int *accessed = buffer.Access(count);
+    ASSERT_EQ(count, 2U);
+    EXPECT_EQ(accessed[0], 3);
+    EXPECT_EQ(accessed[1], 1);
+    buffer.Skip(count);
+
+    accessed = buffer.Access(count);
+    ASSERT_EQ(count, 2U);
+    EXPECT_EQ(accessed[0], 2);
+    EXPECT_EQ(accessed[1], 3);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentShiftBufferTest, NonTrivialItemsAreDestroyed) {
+    std::shared_ptr<int> tracker = std::make_shared<int>(123);
+    {
+      ConcurrentShiftBuffer<std::shared_ptr<int>> buffer(4);
+
+      std::shared_ptr<int> items[] = { tracker, tracker, tracker };
+      buffer.Write(items, 3);
+      buffer.Shove(items, 1);
+      EXPECT_EQ(tracker.use_count(), 7); // The shoved item was moved, not copied
+
+      buffer.Skip(1);
+      EXPECT_EQ(tracker.use_count(), 6);
+
+      std::shared_ptr<int> retrieved;
+      buffer.Read(&retrieved, 1);
+      EXPECT_EQ(tracker.use_count(), 6);
+      EXPECT_EQ(*retrieved, 123);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentShiftBufferTest, ProducerAndConsumerCanRunConcurrently) {
+    const std::size_t TotalItemCount = 100000;
+    ConcurrentShiftBuffer<std::size_t> buffer(1024);
+
+    std::thread producer(
+      [&buffer, TotalItemCount]() {
+        std::size_t items[100];
+        std::size_t next = 0;
+        while(next < TotalItemCount) {
+          std::size_t count = 0;
+          while((count < 100) && (next + count < TotalItemCount)) {
+            items[count] = next + count;
+            ++count;
+          }
+
+          std::size_t written = 0;
+          while(written < count) {
+            std::size_t batchCount = buffer.Write(items + written, count - written);
+            if(batchCount == 0) {
+              std::this_thread::yield();
+            }
+            written += batchCount;
+          }
+          next += count;
+        }
+      }
+    );
+
+    bool inOrder = true;
+    std::size_t expected = 0;
+    std::size_t retrieved[64];
+    while(expected < TotalItemCount) {
+      std::size_t readCount = buffer.Read(retrieved, 64);
+      if(readCount == 0) {
+        std::this_thread::yield();
+      }
+      for(std::size_t index = 0; index < readCount; ++index) {
+        inOrder &= (retrieved[index] == expected);
+        ++expected;
+      }
+    }
+
+    producer.join();
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(buffer.Count(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
@@ -24,6 +24,10 @@ License along with this library
 #include "Nuclex/Support/Collections/DynamicArray.h"
 #include <gtest/gtest.h>
 
+#include <memory> // for std::shared_ptr
+#include <stdexcept> // for std::out_of_range
+#include <string> // for std::string
+
 namespace Nuclex { namespace Support { namespace Collections {
 
   // ------------------------------------------------------------------------------------------- //
@@ -166,6 +170,82 @@ namespace Nuclex { namespace Support { namespace Collections {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(DynamicArrayTest, ItemsCanBeMovedIn) {
+    DynamicArray<std::shared_ptr<int>> test;
+
+    std::shared_ptr<int> first = std::make_shared<int>(12);
+    std::shared_ptr<int> second = std::make_shared<int>(34);
+    std::shared_ptr<int> third = std::make_shared<int>(56);
+    test.Add(std::move(first));
+    test.InsertAt(0, std::move(second));
+    test.SetAt(1, std::move(third));
+
+    // Moved-from shared_ptrs are guaranteed to be empty
+    EXPECT_FALSE(!!first);
+    EXPECT_FALSE(!!second);
+    EXPECT_FALSE(!!third);
+
+    ASSERT_EQ(2U, test.Count());
+    EXPECT_EQ(34, *test.GetAt(0));
+    EXPECT_EQ(56, *test.GetAt(1));
+    EXPECT_EQ(1, test.GetAt(1).use_count());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DynamicArrayTest, ItemsCanBeEmplaced) {
+    DynamicArray<std::string> test;
+    test.Emplace(3U, 'a');
+    test.EmplaceAt(0, u8"Hello");
+
+    IndexedCollection<std::string> &collection = test;
+    collection.Emplace(2U, 'b');
+    collection.EmplaceAt(1, u8"World");
+
+    ASSERT_EQ(4U, test.Count());
+    EXPECT_EQ(u8"Hello", test.GetAt(0));
+    EXPECT_EQ(u8"World", test.GetAt(1));
+    EXPECT_EQ(u8"aaa", test.GetAt(2));
+    EXPECT_EQ(u8"bb", test.GetAt(3));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DynamicArrayTest, ItemsCanBeAccessedAsContiguousRange) {
+    DynamicArray<int> test;
+    test.Add(1);
+    test.Add(2);
+    test.Add(3);
+
+    const IndexedCollection<int> &collection = test;
+    const int *items;
+    ASSERT_EQ(collection.GetContiguousRange(1, items), 2U);
+    EXPECT_EQ(items[0], 2);
+    EXPECT_EQ(items[1], 3);
+
+    EXPECT_THROW(collection.GetContiguousRange(3, items), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DynamicArrayTest, ForEachVisitsAllItems) {
+    DynamicArray<int> test;
+    for(int index = 0; index < 10; ++index) {
+      test.Add(index);
+    }
+
+    IndexedCollection<int> &collection = test;
+    collection.ForEach([](int &item) { item *= 2; });
+
+    int sum = 0;
+    static_cast<const IndexedCollection<int> &>(collection).ForEach(
+      [&sum](const int &item) { sum += item; }
+    );
+    EXPECT_EQ(sum, 90);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   TEST(DynamicArrayTest, ItemCanBeRemoved) {
     DynamicArray<int> test;
     test.Add(2121);
@@ -0,0 +1,161 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Collections/FlatHashMap.h"
+#include <gtest/gtest.h>
+
+#include <string> // for std::string
+#include <unordered_map> // for std::unordered_map
+#include <random> // for std::mt19937
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatHashMapTest, InstancesCanBeCreated) {
+    EXPECT_NO_THROW(
+      (FlatHashMap<int, int>())
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatHashMapTest, EntriesCanBeAddedAndLookedUp) {
+    FlatHashMap<std::string, int> test;
+    EXPECT_TRUE(test.TryInsert(std::string(u8"one"), 1));
+    EXPECT_TRUE(test.TryInsert(std::string(u8"two"), 2));
+
+    EXPECT_EQ(test.Count(), 2U);
+    ASSERT_NE(test.TryGet(u8"one"), nullptr);
+    EXPECT_EQ(*test.TryGet(u8"one"), 1);
+    ASSERT_NE(test.TryGet(u8"two"), nullptr);
+    EXPECT_EQ(*test.TryGet(u8"two"), 2);
+    EXPECT_EQ(test.TryGet(u8"three"), nullptr);
+    EXPECT_FALSE(test.Contains(u8"three"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatHashMapTest, ExistingEntriesAreNotReplaced) {
+    FlatHashMap<int, int> test;
+    EXPECT_TRUE(test.TryInsert(10, 1));
+    EXPECT_FALSE(test.TryInsert(10, 2));
+
+    EXPECT_EQ(test.Count(), 1U);
+    EXPECT_EQ(*test.TryGet(10), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatHashMapTest, ReservingPreventsGrowth) {
+    FlatHashMap<int, int> test;
+    test.Reserve(100);
+
+    std::size_t capacity = test.GetCapacity();
+    for(int index = 0; index < 100; ++index) {
+      test.TryInsert(index, index);
+    }
+
+    EXPECT_EQ(test.GetCapacity(), capacity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatHashMapTest, RemovalKeepsOtherEntriesReachable) {
+    FlatHashMap<int, int> test;
+    for(int index = 0; index < 1000; ++index) {
+      test.TryInsert(index, index * 2);
+    }
+    for(int index = 0; index < 1000; index += 3) {
+      EXPECT_TRUE(test.Remove(index));
+    }
+    EXPECT_FALSE(test.Remove(0));
+
+    for(int index = 0; index < 1000; ++index) {
+      if((index % 3) == 0) {
+        EXPECT_EQ(test.TryGet(index), nullptr);
+      } else {
+        ASSERT_NE(test.TryGet(index), nullptr);
+        EXPECT_EQ(*test.TryGet(index), index * 2);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatHashMapTest, BehavesLikeUnorderedMap) {
+    FlatHashMap<unsigned int, unsigned int> test;
+    std::unordered_map<unsigned int, unsigned int> reference;
+
+    std::mt19937 randomNumberGenerator(1234);
+    for(std::size_t iteration = 0; iteration < 20000; ++iteration) {
+      unsigned int key = randomNumberGenerator() % 512;
+      if((randomNumberGenerator() % 3) == 0) {
+        EXPECT_EQ(test.Remove(key), (reference.erase(key) == 1));
+      } else {
+        EXPECT_EQ(test.TryInsert(key, iteration), reference.emplace(key, iteration).second);
+      }
+    }
+
+    EXPECT_EQ(test.Count(), reference.size());
+    for(const auto &entry : reference) {
+      ASSERT_NE(test.TryGet(entry.first), nullptr);
+      EXPECT_EQ(*test.TryGet(entry.first), entry.second);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatHashMapTest, MapsCanBeCopiedAndMoved) {
+    FlatHashMap<std::string, std::string> original;
+    original.TryInsert(std::string(u8"key"), std::string(u8"value"));
+
+    FlatHashMap<std::string, std::string> copy(original);
+    FlatHashMap<std::string, std::string> moved(std::move(original));
+
+    EXPECT_EQ(original.Count(), 0U);
+    EXPECT_EQ(*copy.TryGet(u8"key"), u8"value");
+    EXPECT_EQ(*moved.TryGet(u8"key"), u8"value");
+
+    copy.Clear();
+    EXPECT_EQ(copy.Count(), 0U);
+    EXPECT_EQ(copy.TryGet(u8"key"), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FlatHashMapTest, ForEachVisitsAllEntries) {
+    FlatHashMap<int, int> test;
+    for(int index = 1; index <= 10; ++index) {
+      test.TryInsert(index, index);
+    }
+
+    int sum = 0;
+    test.ForEach([&sum](const int &key, int &value) { sum += key; value = 0; });
+    EXPECT_EQ(sum, 55);
+    EXPECT_EQ(*test.TryGet(5), 0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
@@ -0,0 +1,162 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Collections/MirroredShiftBuffer.h"
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uint8_t, std::uint32_t
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Item whose size does not divide the allocation granularity</summary>
+  struct OddSizedItem {
+    /// <summary>Bytes that make the item three bytes long</summary>
+    public: std::uint8_t Bytes[3];
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MirroredMemoryTest, SecondMappingMirrorsFirst) {
+    MirroredMemory memory(1);
+
+    std::size_t byteCount = memory.GetByteCount();
+    EXPECT_GE(byteCount, 1U);
+    EXPECT_EQ(byteCount % MirroredMemory::GetAllocationGranularity(), 0U);
+
+    std::uint8_t *address = memory.GetAddress();
+    address[0] = 12;
+    address[byteCount - 1] = 34;
+    EXPECT_EQ(address[byteCount], 12);
+
+    address[byteCount * 2 - 1] = 56;
+    EXPECT_EQ(address[byteCount - 1], 56);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MirroredShiftBufferTest, CapacityIsMultipleOfItemSize) {
+    MirroredShiftBuffer<OddSizedItem> buffer(100);
+    EXPECT_GE(buffer.GetCapacity(), 100U);
+    EXPECT_EQ(
+      (buffer.GetCapacity() * sizeof(OddSizedItem)) % MirroredMemory::GetAllocationGranularity(),
+      0U
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MirroredShiftBufferTest, DataStaysContiguousAcrossWrapAround) {
+    MirroredShiftBuffer<std::uint32_t> buffer;
+    std::size_t capacity = buffer.GetCapacity();
+
+    std::vector<std::uint32_t> items(capacity);
+    std::uint32_t nextValue = 0;
+    std::uint32_t nextExpected = 0;
+
+    // Keep the buffer partially full while cycling through the ring several times
+    for(std::size_t round = 0; round < 10; ++round) {
+      std::size_t writeCount = capacity * 2 / 3;
+      for(std::size_t index = 0; index < writeCount; ++index) {
+        items[index] = nextValue++;
+      }
+      buffer.Write(items.data(), writeCount);
+
+      const std::uint32_t *data = buffer.Access();
+      for(std::size_t index = 0; index < buffer.Count(); ++index) {
+        ASSERT_EQ(data[index], nextExpected + static_cast<std::uint32_t>(index));
+      }
+
+      std::size_t readCount = buffer.Count() - capacity / 3;
+      buffer.Read(items.data(), readCount);
+      for(std::size_t index = 0; index < readCount; ++index) {
+        ASSERT_EQ(items[index], nextExpected++);
+      }
+    }
+
+    // The buffer was never overfilled, so it should not have grown
+    EXPECT_EQ(buffer.GetCapacity(), capacity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MirroredShiftBufferTest, BufferGrowsWhenCapacityIsExceeded) {
+    MirroredShiftBuffer<std::uint32_t> buffer;
+    std::size_t capacity = buffer.GetCapacity();
+
+    std::vector<std::uint32_t> items(capacity * 3);
+    for(std::size_t index = 0; index < items.size(); ++index) {
+      items[index] = static_cast<std::uint32_t>(index);
+    }
+
+    // Move the start into the middle of the ring first so the growth has to unwrap
+    buffer.Write(items.data(), capacity / 2);
+    buffer.Skip(capacity / 2);
+    buffer.Write(items.data(), items.size());
+
+    EXPECT_GE(buffer.GetCapacity(), items.size());
+    ASSERT_EQ(buffer.Count(), items.size());
+    for(std::size_t index = 0; index < items.size(); ++index) {
+      ASSERT_EQ(buffer.Access()[index], items[index]);
+    }
+
+    MirroredShiftBuffer<std::uint32_t> copy(buffer);
+    ASSERT_EQ(copy.Count(), items.size());
+    EXPECT_EQ(copy.Access()[items.size() - 1], items.back());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MirroredShiftBufferTest, ReservedSpaceCanCrossEndOfRing) {
+    MirroredShiftBuffer<std::uint8_t> buffer;
+    std::size_t capacity = buffer.GetCapacity();
+
+    std::vector<std::uint8_t> items(capacity);
+    buffer.Write(items.data(), capacity - 10);
+    buffer.Skip(capacity - 30);
+
+    std::uint8_t *reserved = buffer.Reserve(100);
+    for(std::size_t index = 0; index < 100; ++index) {
+      reserved[index] = static_cast<std::uint8_t>(index + 1);
+    }
+    buffer.Commit(50);
+
+    EXPECT_EQ(buffer.GetCapacity(), capacity);
+    ASSERT_EQ(buffer.Count(), 70U);
+    buffer.Skip(20);
+    for(std::size_t index = 0; index < 50; ++index) {
+      ASSERT_EQ(buffer.Access()[index], static_cast<std::uint8_t>(index + 1));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
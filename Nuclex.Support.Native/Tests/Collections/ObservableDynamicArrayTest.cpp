@@ -0,0 +1,318 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Collections/ObservableDynamicArray.h"
+#include <gtest/gtest.h>
+
+#include <memory> // for std::shared_ptr
+#include <stdexcept> // for std::out_of_range
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the notifications sent by an observable collection</summary>
+  class CollectionObserver {
+
+    /// <summary>Called when an item has been added to the collection</summary>
+    /// <param name="index">Index at which the item has been added</param>
+    /// <param name="value">Item that has been added</param>
+    public: void ItemAdded(std::size_t index, const std::string &value) {
+      this->Added.push_back(value);
+      this->AddedIndices.push_back(index);
+    }
+
+    /// <summary>Called when an item has been removed from the collection</summary>
+    /// <param name="index">Index at which the item has been removed</param>
+    /// <param name="value">Item that has been removed</param>
+    public: void ItemRemoved(std::size_t index, const std::string &value) {
+      this->Removed.push_back(value);
+      this->RemovedIndices.push_back(index);
+    }
+
+    /// <summary>Items that have been reported as added</summary>
+    public: std::vector<std::string> Added;
+    /// <summary>Indices at which items have been reported as added</summary>
+    public: std::vector<std::size_t> AddedIndices;
+    /// <summary>Items that have been reported as removed</summary>
+    public: std::vector<std::string> Removed;
+    /// <summary>Indices at which items have been reported as removed</summary>
+    public: std::vector<std::size_t> RemovedIndices;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the items reported by a replacement notification</summary>
+  class ReplacementObserver {
+
+    /// <summary>Called when an item in the collection has been replaced</summary>
+    /// <param name="index">Index at which the item has been replaced</param>
+    /// <param name="oldValue">Item that has been replaced</param>
+    /// <param name="newValue">Item that has taken the old item's place</param>
+    public: void ItemReplaced(
+      std::size_t index,
+      const std::shared_ptr<int> &oldValue, const std::shared_ptr<int> &newValue
+    ) {
+      (void)index;
+      this->OldValue = oldValue;
+      this->NewValue = newValue;
+    }
+
+    /// <summary>Item that has been reported as replaced</summary>
+    public: std::shared_ptr<int> OldValue;
+    /// <summary>Item that has been reported as the replacement</summary>
+    public: std::shared_ptr<int> NewValue;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the range notifications sent by an observable collection</summary>
+  class RangeObserver {
+
+    /// <summary>Initializes a new range observer</summary>
+    public: RangeObserver() :
+      AddedCount(0),
+      RemovedCount(0),
+      NotificationCount(0) {}
+
+    /// <summary>Called when a range of items has been added to the collection</summary>
+    /// <param name="index">Index of the first item that has been added</param>
+    /// <param name="count">Number of items that have been added</param>
+    public: void ItemsAdded(std::size_t index, std::size_t count) {
+      (void)index;
+      this->AddedCount += count;
+      ++this->NotificationCount;
+    }
+
+    /// <summary>Called when a range of items has been removed from the collection</summary>
+    /// <param name="index">Index the first removed item had</param>
+    /// <param name="items">Items that have been removed</param>
+    /// <param name="count">Number of items that have been removed</param>
+    public: void ItemsRemoved(std::size_t index, const std::string *items, std::size_t count) {
+      (void)index;
+      this->Removed.assign(items, items + count);
+      this->RemovedCount += count;
+      ++this->NotificationCount;
+    }
+
+    /// <summary>Total number of items reported as added</summary>
+    public: std::size_t AddedCount;
+    /// <summary>Total number of items reported as removed</summary>
+    public: std::size_t RemovedCount;
+    /// <summary>Number of range notifications received</summary>
+    public: std::size_t NotificationCount;
+    /// <summary>Items reported by the most recent removal notification</summary>
+    public: std::vector<std::string> Removed;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Subscribes a range observer to the range notifications of an array</summary>
+  /// <param name="array">Array whose notifications will be observed</param>
+  /// <param name="observer">Observer that will record the notifications</param>
+  void subscribe(
+    Nuclex::Support::Collections::ObservableDynamicArray<std::string> &array,
+    RangeObserver &observer
+  ) {
+    array.ItemsAdded.Subscribe<RangeObserver, &RangeObserver::ItemsAdded>(&observer);
+    array.ItemsRemoved.Subscribe<RangeObserver, &RangeObserver::ItemsRemoved>(&observer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Subscribes an observer to the indexed notifications of an array</summary>
+  /// <param name="array">Array whose notifications will be observed</param>
+  /// <param name="observer">Observer that will record the notifications</param>
+  void subscribe(
+    Nuclex::Support::Collections::ObservableDynamicArray<std::string> &array,
+    CollectionObserver &observer
+  ) {
+    typedef Nuclex::Support::Collections::ObservableIndexedCollection<std::string> Observable;
+    array.Observable::ItemAdded.Subscribe<
+      CollectionObserver, &CollectionObserver::ItemAdded
+    >(&observer);
+    array.Observable::ItemRemoved.Subscribe<
+      CollectionObserver, &CollectionObserver::ItemRemoved
+    >(&observer);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ObservableDynamicArrayTest, InstancesCanBeCreated) {
+    EXPECT_NO_THROW(
+      ObservableDynamicArray<int> test;
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ObservableDynamicArrayTest, AddingItemsSendsNotifications) {
+    ObservableDynamicArray<std::string> test;
+    CollectionObserver observer;
+    subscribe(test, observer);
+
+    std::string first(u8"First");
+    test.Add(first);
+    test.Add(std::string(u8"Second"));
+    test.Emplace(3U, 'x');
+    test.EmplaceAt(1, u8"Inserted");
+
+    ASSERT_EQ(observer.Added.size(), 4U);
+    EXPECT_EQ(observer.Added[0], u8"First");
+    EXPECT_EQ(observer.Added[1], u8"Second");
+    EXPECT_EQ(observer.Added[2], u8"xxx");
+    EXPECT_EQ(observer.Added[3], u8"Inserted");
+    EXPECT_EQ(observer.AddedIndices[2], 2U);
+    EXPECT_EQ(observer.AddedIndices[3], 1U);
+
+    ASSERT_EQ(test.Count(), 4U);
+    EXPECT_EQ(test.GetAt(1), u8"Inserted");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ObservableDynamicArrayTest, RemovingItemsSendsNotifications) {
+    ObservableDynamicArray<std::string> test;
+    test.Add(std::string(u8"One"));
+    test.Add(std::string(u8"Two"));
+    test.Add(std::string(u8"Three"));
+
+    CollectionObserver observer;
+    subscribe(test, observer);
+
+    EXPECT_TRUE(test.Remove(std::string(u8"Two")));
+    EXPECT_FALSE(test.Remove(std::string(u8"Four")));
+    test.RemoveAt(0);
+
+    ASSERT_EQ(observer.Removed.size(), 2U);
+    EXPECT_EQ(observer.Removed[0], u8"Two");
+    EXPECT_EQ(observer.RemovedIndices[0], 1U);
+    EXPECT_EQ(observer.Removed[1], u8"One");
+    EXPECT_EQ(observer.RemovedIndices[1], 0U);
+
+    ASSERT_EQ(test.Count(), 1U);
+    EXPECT_EQ(test.GetAt(0), u8"Three");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ObservableDynamicArrayTest, RangesCanBeAddedAndRemoved) {
+    ObservableDynamicArray<std::string> test;
+    CollectionObserver itemObserver;
+    RangeObserver rangeObserver;
+    subscribe(test, itemObserver);
+    subscribe(test, rangeObserver);
+
+    std::string items[] = { u8"A", u8"B", u8"C", u8"D" };
+    test.AddRange(items, items + 2);
+    test.InsertRange(1, items + 2, items + 4);
+    ASSERT_EQ(test.Count(), 4U);
+    EXPECT_EQ(test.GetAt(0), u8"A");
+    EXPECT_EQ(test.GetAt(1), u8"C");
+    EXPECT_EQ(test.GetAt(2), u8"D");
+    EXPECT_EQ(test.GetAt(3), u8"B");
+
+    test.RemoveRange(1, 2);
+    ASSERT_EQ(test.Count(), 2U);
+    EXPECT_EQ(test.GetAt(1), u8"B");
+
+    // Per-item events are still sent by default
+    EXPECT_EQ(itemObserver.Added.size(), 4U);
+    EXPECT_EQ(itemObserver.Removed.size(), 2U);
+
+    EXPECT_EQ(rangeObserver.NotificationCount, 3U);
+    EXPECT_EQ(rangeObserver.AddedCount, 4U);
+    ASSERT_EQ(rangeObserver.Removed.size(), 2U);
+    EXPECT_EQ(rangeObserver.Removed[0], u8"C");
+    EXPECT_EQ(rangeObserver.Removed[1], u8"D");
+
+    EXPECT_THROW(test.RemoveRange(1, 2), std::out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ObservableDynamicArrayTest, ItemEventsCanBeSuppressedInBatches) {
+    ObservableDynamicArray<std::string> test;
+    test.SuppressItemEventsInBatches();
+
+    CollectionObserver itemObserver;
+    RangeObserver rangeObserver;
+    subscribe(test, itemObserver);
+    subscribe(test, rangeObserver);
+
+    std::vector<std::string> items(100, std::string(u8"Item"));
+    test.AddRange(items.begin(), items.end());
+    test.Clear();
+
+    EXPECT_TRUE(itemObserver.Added.empty());
+    EXPECT_TRUE(itemObserver.Removed.empty());
+    EXPECT_EQ(rangeObserver.NotificationCount, 2U);
+    EXPECT_EQ(rangeObserver.AddedCount, 100U);
+    EXPECT_EQ(rangeObserver.RemovedCount, 100U);
+
+    // Single-item operations are not batches and still report the item
+    test.Add(std::string(u8"Single"));
+    EXPECT_EQ(itemObserver.Added.size(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ObservableDynamicArrayTest, ReplacedItemIsReported) {
+    ObservableDynamicArray<std::shared_ptr<int>> test;
+    test.Add(std::make_shared<int>(1));
+
+    ReplacementObserver observer;
+    test.ItemReplaced.Subscribe<
+      ReplacementObserver, &ReplacementObserver::ItemReplaced
+    >(&observer);
+    std::shared_ptr<int> &reportedOld = observer.OldValue;
+    std::shared_ptr<int> &reportedNew = observer.NewValue;
+
+    std::shared_ptr<int> replacement = std::make_shared<int>(2);
+    test.SetAt(0, std::shared_ptr<int>(replacement));
+
+    ASSERT_TRUE(!!reportedOld);
+    EXPECT_EQ(*reportedOld, 1);
+    EXPECT_EQ(reportedNew, replacement);
+    EXPECT_EQ(test.GetAt(0), replacement);
+
+    // The array should have moved the replacement in rather than copying it
+    reportedOld.reset();
+    reportedNew.reset();
+    EXPECT_EQ(replacement.use_count(), 2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
@@ -24,6 +24,7 @@ License along with this library
 #include "Nuclex/Support/Collections/ShiftBuffer.h"
 #include <gtest/gtest.h>
 
+#include <string> // for std::string
 #include <vector> // for std::vector
 
 namespace {
@@ -655,4 +656,89 @@ namespace Nuclex { namespace Support { namespace Collections {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(ShiftBufferTest, TrivialItemsAreReadInOrder) {
+    ShiftBuffer<std::uint8_t> test(16);
+
+    std::uint8_t items[] = { 1, 2, 3, 4, 5, 6 };
+    test.Write(items, 6);
+    test.Skip(1);
+
+    std::uint8_t retrieved[3];
+    test.Read(retrieved, 3);
+    EXPECT_EQ(retrieved[0], 2);
+    EXPECT_EQ(retrieved[2], 4);
+
+    test.Read(retrieved, 2);
+    EXPECT_EQ(retrieved[0], 5);
+    EXPECT_EQ(retrieved[1], 6);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ShiftBufferTest, ItemsCanBeConstructedInReservedSpace) {
+    ShiftBuffer<std::uint8_t> test(4);
+
+    std::uint8_t *reserved = test.Reserve(100);
+    EXPECT_GE(test.GetCapacity(), 100U);
+    EXPECT_EQ(test.Count(), 0U);
+    for(std::size_t index = 0; index < 10; ++index) {
+      reserved[index] = static_cast<std::uint8_t>(index);
+    }
+    test.Commit(10);
+    EXPECT_EQ(test.Count(), 10U);
+
+    reserved = test.Reserve(5);
+    reserved[0] = 10;
+    test.Commit(1);
+
+    ASSERT_EQ(test.Count(), 11U);
+    for(std::size_t index = 0; index < 11; ++index) {
+      EXPECT_EQ(test.Access()[index], static_cast<std::uint8_t>(index));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ShiftBufferTest, UncommittedItemsAreNotDestroyed) {
+    std::vector<std::shared_ptr<TestItemStats>> stats = makeStats(2);
+    std::vector<TestItem> items;
+    makeItems(items, stats);
+
+    {
+      ShiftBuffer<TestItem> test(16);
+      TestItem *reserved = test.Reserve(2);
+      new(reserved) TestItem(items[0]);
+      new(reserved + 1) TestItem(items[1]);
+      test.Commit(1);
+
+      // The second item was never committed, so we have to clean it up ourselves
+      reserved[1].~TestItem();
+      EXPECT_EQ(stats[1]->DestroyCount, 1);
+      EXPECT_EQ(test.Count(), 1U);
+    }
+
+    EXPECT_EQ(stats[0]->CopyCount, 1);
+    EXPECT_EQ(stats[0]->DestroyCount, 1);
+    EXPECT_EQ(stats[1]->DestroyCount, 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ShiftBufferTest, ItemsCanBeConsumedInPlace) {
+    ShiftBuffer<std::string> test(4);
+
+    std::string items[] = { u8"Hello", u8"World" };
+    test.Write(items, 2);
+
+    std::string *accessed = test.Access();
+    std::string taken = std::move(accessed[0]);
+    test.Skip(1);
+
+    EXPECT_EQ(taken, u8"Hello");
+    ASSERT_EQ(test.Count(), 1U);
+    EXPECT_EQ(test.Access()[0], u8"World");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Collections
@@ -0,0 +1,145 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Collections/SmallVector.h"
+#include <gtest/gtest.h>
+
+#include <memory> // for std::shared_ptr
+#include <string> // for std::string
+
+namespace Nuclex { namespace Support { namespace Collections {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SmallVectorTest, InstancesCanBeCreated) {
+    EXPECT_NO_THROW(
+      (SmallVector<int, 4>())
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SmallVectorTest, FewItemsAreStoredInline) {
+    SmallVector<int, 4> test;
+    test.Add(1);
+    test.Add(2);
+    test.Add(3);
+    test.Add(4);
+
+    EXPECT_TRUE(test.IsInline());
+    EXPECT_EQ(test.Count(), 4U);
+    EXPECT_EQ(test[0], 1);
+    EXPECT_EQ(test[3], 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SmallVectorTest, ItemsMoveToHeapWhenInlineBufferIsFull) {
+    SmallVector<std::string, 2> test;
+    for(std::size_t index = 0; index < 10; ++index) {
+      test.Emplace(index, 'x');
+    }
+
+    EXPECT_FALSE(test.IsInline());
+    EXPECT_EQ(test.Count(), 10U);
+    for(std::size_t index = 0; index < 10; ++index) {
+      EXPECT_EQ(test[index], std::string(index, 'x'));
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SmallVectorTest, ItemsCanBeAddedFromWithinTheVector) {
+    SmallVector<std::string, 1> test;
+    test.Add(std::string(u8"Hello"));
+    test.Add(test[0]);
+
+    EXPECT_EQ(test.Count(), 2U);
+    EXPECT_EQ(test[1], u8"Hello");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SmallVectorTest, ResizingConstructsAndDestroysItems) {
+    std::shared_ptr<int> item = std::make_shared<int>(123);
+    SmallVector<std::shared_ptr<int>, 2> test;
+    test.Add(item);
+    test.Add(item);
+    test.Add(item);
+    EXPECT_EQ(item.use_count(), 4);
+
+    test.Resize(1);
+    EXPECT_EQ(item.use_count(), 2);
+
+    test.Resize(5);
+    EXPECT_EQ(test.Count(), 5U);
+    EXPECT_EQ(test[4], nullptr);
+
+    test.Clear();
+    EXPECT_EQ(item.use_count(), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SmallVectorTest, VectorsCanBeCopiedAndMoved) {
+    SmallVector<std::string, 2> inlineVector;
+    inlineVector.Add(std::string(u8"a"));
+    SmallVector<std::string, 2> heapVector;
+    heapVector.Add(std::string(u8"b"));
+    heapVector.Add(std::string(u8"c"));
+    heapVector.Add(std::string(u8"d"));
+
+    SmallVector<std::string, 2> copy(heapVector);
+    EXPECT_EQ(copy.Count(), 3U);
+    EXPECT_EQ(copy[2], u8"d");
+
+    SmallVector<std::string, 2> movedInline(std::move(inlineVector));
+    SmallVector<std::string, 2> movedHeap(std::move(heapVector));
+    EXPECT_EQ(inlineVector.Count(), 0U);
+    EXPECT_EQ(heapVector.Count(), 0U);
+    EXPECT_EQ(movedInline[0], u8"a");
+    EXPECT_EQ(movedHeap[1], u8"c");
+
+    copy = movedInline;
+    EXPECT_EQ(copy.Count(), 1U);
+    EXPECT_EQ(copy[0], u8"a");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(SmallVectorTest, CanBeUsedInRangeBasedForLoops) {
+    SmallVector<int, 4> test;
+    for(int index = 1; index <= 6; ++index) {
+      test.Add(index);
+    }
+
+    int sum = 0;
+    for(int item : test) {
+      sum += item;
+    }
+    EXPECT_EQ(sum, 21);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Collections
@@ -0,0 +1,109 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/CpuFeatures.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Kernel standing in for one that needs a newer instruction set</summary>
+  /// <returns>A number identifying the kernel</returns>
+  int newKernel() { return 2; }
+
+  /// <summary>Kernel standing in for one that needs an older instruction set</summary>
+  /// <returns>A number identifying the kernel</returns>
+  int olderKernel() { return 1; }
+
+  /// <summary>Kernel standing in for one that works everywhere</summary>
+  /// <returns>A number identifying the kernel</returns>
+  int portableKernel() { return 0; }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CpuFeaturesTest, FeaturesAreDetectedOnce) {
+    const CpuFeatures &features = CpuFeatures::Get();
+    EXPECT_EQ(&features, &CpuFeatures::Get());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CpuFeaturesTest, DetectedFeaturesAreConsistent) {
+    const CpuFeatures &features = CpuFeatures::Get();
+
+    // Each of these extensions builds on the one before
+    if(features.HasAvx2) {
+      EXPECT_TRUE(features.HasAvx);
+    }
+    if(features.HasAvx512bw || features.HasAvx512vl) {
+      EXPECT_TRUE(features.HasAvx512f);
+    }
+    if(features.HasF16c || features.HasFma) {
+      EXPECT_TRUE(features.HasAvx);
+    }
+
+    // Whatever the compiler was allowed to use everywhere must be there, too
+#if defined(NUCLEX_SUPPORT_HAVE_SSE2)
+    EXPECT_TRUE(features.HasSse2);
+#endif
+#if defined(NUCLEX_SUPPORT_HAVE_SSSE3)
+    EXPECT_TRUE(features.HasSsse3);
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+    EXPECT_TRUE(features.HasNeon);
+#endif
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(CpuFeaturesTest, DispatchPicksFirstSupportedKernel) {
+    typedef int KernelFunction();
+
+    KernelFunction *kernel = KernelDispatch<KernelFunction>()
+      .Prefer(false, &newKernel)
+      .Prefer(true, &olderKernel)
+      .Otherwise(&portableKernel);
+    EXPECT_EQ(1, kernel());
+
+    kernel = KernelDispatch<KernelFunction>()
+      .Prefer(true, &newKernel)
+      .Prefer(true, &olderKernel)
+      .Otherwise(&portableKernel);
+    EXPECT_EQ(2, kernel());
+
+    kernel = KernelDispatch<KernelFunction>()
+      .Prefer(false, &newKernel)
+      .Otherwise(&portableKernel);
+    EXPECT_EQ(0, kernel());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
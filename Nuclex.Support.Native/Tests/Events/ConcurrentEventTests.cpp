@@ -0,0 +1,165 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Events/ConcurrentEvent.h"
+#include <gtest/gtest.h>
+
+#include <atomic> // for std::atomic
+#include <thread> // for std::thread
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Free function that returns an integral value for testing</summary>
+  int getSenseOfLife() { return 42; }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Dummy class used to test event subscriptions</summary>
+  class Mock {
+
+    /// <summary>Initializes a new mocked subscriber</summary>
+    public: Mock() :
+      ReceivedNotificationCount(0),
+      ToUnsubscribe(nullptr) {}
+
+    /// <summary>Method that can be subscribed to an event for testing</summary>
+    /// <param name="something">Dummy integer value that will be remembered</param>
+    public: void Notify(int something) {
+      (void)something;
+      this->ReceivedNotificationCount.fetch_add(1, std::memory_order_relaxed);
+
+      if(this->ToUnsubscribe != nullptr) {
+        this->ToUnsubscribe->Unsubscribe<Mock, &Mock::Notify>(this);
+        this->ToUnsubscribe = nullptr;
+      }
+    }
+
+    /// <summary>Number of calls to Notify() the instance has observed</summary>
+    public: std::atomic<std::size_t> ReceivedNotificationCount;
+
+    /// <summary>When set, unsubscribes the Notify() method inside the event call</summary>
+    public: Nuclex::Support::Events::ConcurrentEvent<void(int something)> *ToUnsubscribe;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Events {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentEventTest, SubscribersAreNotified) {
+    ConcurrentEvent<void(int something)> test;
+    Mock first, second;
+
+    test.Subscribe<Mock, &Mock::Notify>(&first);
+    test.Subscribe<Mock, &Mock::Notify>(&second);
+    EXPECT_EQ(test.CountSubscribers(), 2U);
+
+    test.Emit(123);
+    test(456);
+    EXPECT_EQ(first.ReceivedNotificationCount.load(), 2U);
+    EXPECT_EQ(second.ReceivedNotificationCount.load(), 2U);
+
+    EXPECT_TRUE((test.Unsubscribe<Mock, &Mock::Notify>(&first)));
+    EXPECT_FALSE((test.Unsubscribe<Mock, &Mock::Notify>(&first)));
+    test.Emit(789);
+    EXPECT_EQ(first.ReceivedNotificationCount.load(), 2U);
+    EXPECT_EQ(second.ReceivedNotificationCount.load(), 3U);
+
+    EXPECT_TRUE((test.Unsubscribe<Mock, &Mock::Notify>(&second)));
+    EXPECT_EQ(test.CountSubscribers(), 0U);
+    test.Emit(0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentEventTest, ReturnValuesCanBeCollected) {
+    ConcurrentEvent<int()> test;
+    test.Subscribe<getSenseOfLife>();
+    test.Subscribe<getSenseOfLife>();
+
+    std::vector<int> results = test();
+    ASSERT_EQ(results.size(), 2U);
+    EXPECT_EQ(results[0], 42);
+    EXPECT_EQ(results[1], 42);
+
+    int storedResults[1] = { 0 };
+    EXPECT_EQ(test.EmitAndCollectInto(storedResults, 1), 2U);
+    EXPECT_EQ(storedResults[0], 42);
+
+    EXPECT_EQ(test.EmitAndReduce(0, [](int sum, int value) { return sum + value; }), 84);
+    EXPECT_TRUE(test.EmitUntil([](int value) { return (value == 42); }));
+    EXPECT_FALSE(test.EmitUntil([](int value) { return (value != 42); }));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentEventTest, SubscribersCanUnsubscribeDuringEmission) {
+    ConcurrentEvent<void(int something)> test;
+    Mock mock;
+
+    test.Subscribe<Mock, &Mock::Notify>(&mock);
+    mock.ToUnsubscribe = &test;
+
+    test.Emit(1);
+    test.Emit(2);
+    EXPECT_EQ(mock.ReceivedNotificationCount.load(), 1U);
+    EXPECT_EQ(test.CountSubscribers(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ConcurrentEventTest, EmissionIsSafeWhileSubscriptionsChange) {
+    ConcurrentEvent<void(int something)> test;
+    Mock permanent, toggled;
+    test.Subscribe<Mock, &Mock::Notify>(&permanent);
+
+    const std::size_t EmissionCount = 20000;
+    std::thread emitter(
+      [&test, EmissionCount]() {
+        for(std::size_t index = 0; index < EmissionCount; ++index) {
+          test.Emit(static_cast<int>(index));
+        }
+      }
+    );
+
+    for(std::size_t index = 0; index < 2000; ++index) {
+      test.Subscribe<Mock, &Mock::Notify>(&toggled);
+      std::this_thread::yield();
+      test.Unsubscribe<Mock, &Mock::Notify>(&toggled);
+    }
+    emitter.join();
+
+    EXPECT_EQ(permanent.ReceivedNotificationCount.load(), EmissionCount);
+    EXPECT_LE(toggled.ReceivedNotificationCount.load(), EmissionCount);
+    EXPECT_EQ(test.CountSubscribers(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Events
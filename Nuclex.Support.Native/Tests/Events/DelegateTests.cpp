@@ -504,4 +504,63 @@ namespace Nuclex { namespace Support { namespace Events {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(DelegateTest, LambdaWithCapturesCanBeCalled) {
+    int sum = 0;
+    int factor = 3;
+    auto addScaled = [&sum, factor](int something) { sum += something * factor; };
+
+    Delegate<void(int something)> test = Delegate<void(int something)>::Create(addScaled);
+    test(2);
+    test(5);
+
+    EXPECT_EQ(sum, 21);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DelegateTest, LambdaCanReturnValues) {
+    int offset = 100;
+    Delegate<int(int something)> test = Delegate<int(int something)>::Create(
+      [offset](int something) { return something + offset; }
+    );
+
+    EXPECT_EQ(test(23), 123);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DelegateTest, LambdaDelegatesCanBeCompared) {
+    int first = 0, second = 0;
+    auto setFirst = [&first](int something) { first = something; };
+    auto setSecond = [&second](int something) { second = something; };
+
+    Delegate<void(int something)> a = Delegate<void(int something)>::Create(setFirst);
+    Delegate<void(int something)> b = Delegate<void(int something)>::Create(setFirst);
+    Delegate<void(int something)> c = Delegate<void(int something)>::Create(setSecond);
+
+    EXPECT_TRUE(a == b);
+    EXPECT_FALSE(a != b);
+    EXPECT_FALSE(a == c);
+    EXPECT_TRUE(a != c);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(DelegateTest, ResetFromLambdaClearsCapturedValues) {
+    int value = 0;
+    auto setValue = [&value](int something) { value = something; };
+
+    Delegate<void(int something)> a = Delegate<void(int something)>::Create(setValue);
+    a.Reset<&freeFunction>();
+
+    Delegate<void(int something)> b = Delegate<void(int something)>::Create<&freeFunction>();
+    EXPECT_TRUE(a == b);
+
+    a.Reset(setValue);
+    a(42);
+    EXPECT_EQ(value, 42);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Events
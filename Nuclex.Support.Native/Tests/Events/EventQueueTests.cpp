@@ -0,0 +1,190 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Events/EventQueue.h"
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records the notifications it receives</summary>
+  class Recorder {
+
+    /// <summary>Remembers a notification</summary>
+    /// <param name="name">Name that was passed with the notification</param>
+    /// <param name="value">Value that was passed with the notification</param>
+    public: void Notify(const std::string &name, int value) {
+      this->Names.push_back(name);
+      this->Values.push_back(value);
+    }
+
+    /// <summary>Throws an exception if the value is negative</summary>
+    /// <param name="name">Name that was passed with the notification</param>
+    /// <param name="value">Value that was passed with the notification</param>
+    public: void NotifyOrThrow(const std::string &name, int value) {
+      if(value < 0) {
+        throw std::runtime_error(u8"Negative value");
+      }
+      Notify(name, value);
+    }
+
+    /// <summary>Names received in the order the notifications arrived</summary>
+    public: std::vector<std::string> Names;
+    /// <summary>Values received in the order the notifications arrived</summary>
+    public: std::vector<int> Values;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Type of event queue used in the tests</summary>
+  typedef Nuclex::Support::Events::EventQueue<
+    void(const std::string &name, int value)
+  > TestEventQueue;
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Events {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EventQueueTest, PostedCallsAreExecutedInOrderWhenDrained) {
+    TestEventQueue queue;
+    Recorder recorder;
+    TestEventQueue::DelegateType delegate = (
+      TestEventQueue::DelegateType::Create<Recorder, &Recorder::Notify>(&recorder)
+    );
+
+    {
+      std::string temporary(u8"first");
+      queue.Post(delegate, temporary, 1);
+      temporary.assign(u8"overwritten");
+    }
+    queue.Post(delegate, u8"second", 2);
+    EXPECT_EQ(queue.Count(), 2U);
+    EXPECT_TRUE(recorder.Values.empty());
+
+    EXPECT_EQ(queue.Drain(), 2U);
+    EXPECT_EQ(queue.Count(), 0U);
+    ASSERT_EQ(recorder.Values.size(), 2U);
+    EXPECT_EQ(recorder.Names[0], u8"first");
+    EXPECT_EQ(recorder.Names[1], u8"second");
+    EXPECT_EQ(recorder.Values[1], 2);
+
+    EXPECT_EQ(queue.Drain(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EventQueueTest, CoalescedCallsReplaceQueuedCalls) {
+    TestEventQueue queue;
+    Recorder first, second;
+    TestEventQueue::DelegateType firstDelegate = (
+      TestEventQueue::DelegateType::Create<Recorder, &Recorder::Notify>(&first)
+    );
+    TestEventQueue::DelegateType secondDelegate = (
+      TestEventQueue::DelegateType::Create<Recorder, &Recorder::Notify>(&second)
+    );
+
+    EXPECT_FALSE(queue.PostCoalesced(firstDelegate, u8"a", 1));
+    EXPECT_FALSE(queue.PostCoalesced(secondDelegate, u8"b", 2));
+    EXPECT_TRUE(queue.PostCoalesced(firstDelegate, u8"c", 3));
+    EXPECT_EQ(queue.Count(), 2U);
+
+    queue.Drain();
+    ASSERT_EQ(first.Values.size(), 1U);
+    EXPECT_EQ(first.Names[0], u8"c");
+    EXPECT_EQ(first.Values[0], 3);
+    ASSERT_EQ(second.Values.size(), 1U);
+    EXPECT_EQ(second.Values[0], 2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EventQueueTest, CallsAfterFailingCallStayQueued) {
+    TestEventQueue queue;
+    Recorder recorder;
+    TestEventQueue::DelegateType delegate = (
+      TestEventQueue::DelegateType::Create<Recorder, &Recorder::NotifyOrThrow>(&recorder)
+    );
+
+    queue.Post(delegate, u8"before", 1);
+    queue.Post(delegate, u8"failing", -1);
+    queue.Post(delegate, u8"after", 2);
+    EXPECT_THROW(queue.Drain(), std::runtime_error);
+
+    ASSERT_EQ(recorder.Values.size(), 1U);
+    EXPECT_EQ(queue.Count(), 1U);
+
+    queue.Post(delegate, u8"newer", 3);
+    EXPECT_EQ(queue.Drain(), 2U);
+    ASSERT_EQ(recorder.Values.size(), 3U);
+    EXPECT_EQ(recorder.Names[1], u8"after");
+    EXPECT_EQ(recorder.Names[2], u8"newer");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EventQueueTest, CallsCanBePostedFromOtherThreads) {
+    TestEventQueue queue;
+    Recorder recorder;
+    TestEventQueue::DelegateType delegate = (
+      TestEventQueue::DelegateType::Create<Recorder, &Recorder::Notify>(&recorder)
+    );
+
+    const int CallsPerThread = 1000;
+    std::vector<std::thread> threads;
+    for(std::size_t thread = 0; thread < 4; ++thread) {
+      threads.emplace_back(
+        [&queue, &delegate, CallsPerThread]() {
+          for(int index = 0; index < CallsPerThread; ++index) {
+            queue.Post(delegate, u8"worker", index);
+          }
+        }
+      );
+    }
+
+    std::size_t executedCallCount = 0;
+    while(executedCallCount < 4 * CallsPerThread) {
+      executedCallCount += queue.Drain();
+      std::this_thread::yield();
+    }
+    for(std::size_t index = 0; index < threads.size(); ++index) {
+      threads[index].join();
+    }
+
+    EXPECT_EQ(recorder.Values.size(), 4U * CallsPerThread);
+    EXPECT_EQ(queue.Count(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Events
@@ -415,4 +415,101 @@ namespace Nuclex { namespace Support { namespace Events {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(EventTest, SubscriberReturnValuesCanBeStoredInFixedArray) {
+    Event<int()> test;
+    for(std::size_t index = 0; index < 4; ++index) {
+      test.Subscribe<getSenseOfLife>();
+    }
+
+    int results[3] = { 0, 0, 0 };
+    EXPECT_EQ(test.EmitAndCollectInto(results, 3), 4U);
+    EXPECT_EQ(results[0], 42);
+    EXPECT_EQ(results[2], 42);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EventTest, SubscriberReturnValuesCanBeReduced) {
+    Event<int()> test;
+    EXPECT_EQ(test.EmitAndReduce(1, [](int sum, int value) { return sum + value; }), 1);
+
+    for(std::size_t index = 0; index < 5; ++index) {
+      test.Subscribe<getSenseOfLife>();
+    }
+    EXPECT_EQ(test.EmitAndReduce(1, [](int sum, int value) { return sum + value; }), 211);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EventTest, EmissionCanBeStoppedByPredicate) {
+    Event<int()> test;
+    for(std::size_t index = 0; index < 5; ++index) {
+      test.Subscribe<getSenseOfLife>();
+    }
+
+    std::size_t checkedResultCount = 0;
+    bool wasStopped = test.EmitUntil(
+      [&checkedResultCount](int value) { ++checkedResultCount; return (value == 42); }
+    );
+    EXPECT_TRUE(wasStopped);
+    EXPECT_EQ(checkedResultCount, 1U);
+
+    checkedResultCount = 0;
+    wasStopped = test.EmitUntil(
+      [&checkedResultCount](int value) { ++checkedResultCount; return (value != 42); }
+    );
+    EXPECT_FALSE(wasStopped);
+    EXPECT_EQ(checkedResultCount, 5U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EventTest, BuiltInSubscriberCountCanBeChosen) {
+    typedef Event<void(int something), 6> SixSubscriberEvent;
+    EXPECT_GT(sizeof(SixSubscriberEvent), sizeof(Event<void(int something)>));
+
+    SixSubscriberEvent test;
+    Mock mocks[8];
+
+    // Cross the boundary between built-in and heap storage in both directions
+    for(std::size_t index = 0; index < 8; ++index) {
+      test.Subscribe<Mock, &Mock::Notify>(&mocks[index]);
+    }
+    test.Emit(1);
+    for(std::size_t index = 0; index < 3; ++index) {
+      bool wasUnsubscribed = test.Unsubscribe<Mock, &Mock::Notify>(&mocks[index]);
+      EXPECT_TRUE(wasUnsubscribed);
+    }
+    test.Emit(2);
+
+    EXPECT_EQ(test.CountSubscribers(), 5U);
+    for(std::size_t index = 0; index < 8; ++index) {
+      EXPECT_EQ(mocks[index].ReceivedNotificationCount, (index < 3) ? 1U : 2U);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(EventTest, LambdasCanBeSubscribed) {
+    Event<void(int something)> test;
+    int total = 0;
+    int emissionCount = 0;
+    auto addToTotal = [&total](int something) { total += something; };
+    auto countEmission = [&emissionCount](int) { ++emissionCount; };
+
+    test.Subscribe(addToTotal);
+    test.Subscribe(countEmission);
+    test.Emit(10);
+
+    bool wasUnsubscribed = test.Unsubscribe(addToTotal);
+    EXPECT_TRUE(wasUnsubscribed);
+    test.Emit(20);
+
+    EXPECT_EQ(total, 10);
+    EXPECT_EQ(emissionCount, 2);
+    EXPECT_EQ(test.CountSubscribers(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Events
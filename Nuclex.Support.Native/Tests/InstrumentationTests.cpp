@@ -0,0 +1,220 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+// The macros are tested, so they need to be active in this translation unit
+#define NUCLEX_SUPPORT_INSTRUMENTATION 1
+
+#include "Nuclex/Support/Instrumentation.h"
+#include <gtest/gtest.h>
+
+#include <cstring> // for std::strcmp()
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Sink that remembers everything it receives</summary>
+  class RecordingSink : public Nuclex::Support::InstrumentationSink {
+
+    /// <summary>Remembers the name of a zone that was entered</summary>
+    /// <param name="site">Instrumented location that was entered</param>
+    public: void ZoneEntered(const Nuclex::Support::InstrumentationSite &site) override {
+      this->EnteredZones.push_back(site.Name);
+    }
+
+    /// <summary>Remembers the name of a zone that was left</summary>
+    /// <param name="site">Instrumented location that was left</param>
+    public: void ZoneLeft(
+      const Nuclex::Support::InstrumentationSite &site, std::uint64_t, std::uint64_t
+    ) override {
+      this->LeftZones.push_back(site.Name);
+    }
+
+    /// <summary>Remembers the value of a counter if it is the test's counter</summary>
+    /// <param name="counter">Counter whose value is being reported</param>
+    /// <param name="value">Value of the counter</param>
+    public: void CounterReported(
+      const Nuclex::Support::Counter &counter, std::uint64_t value
+    ) override {
+      if(std::strcmp(counter.GetName(), "Tests.Counter") == 0) {
+        this->CounterValue = value;
+      }
+    }
+
+    /// <summary>Remembers the buckets of a histogram if it is the test's histogram</summary>
+    /// <param name="histogram">Histogram whose contents are being reported</param>
+    /// <param name="bucketCounts">Number of values recorded in each bucket</param>
+    public: void HistogramReported(
+      const Nuclex::Support::Histogram &histogram, const std::uint64_t *bucketCounts
+    ) override {
+      if(std::strcmp(histogram.GetName(), "Tests.Histogram") == 0) {
+        this->BucketCounts.assign(
+          bucketCounts, bucketCounts + Nuclex::Support::Histogram::BucketCount
+        );
+      }
+    }
+
+    /// <summary>Names of the zones that were entered</summary>
+    public: std::vector<std::string> EnteredZones;
+    /// <summary>Names of the zones that were left</summary>
+    public: std::vector<std::string> LeftZones;
+    /// <summary>Last reported value of the test's counter</summary>
+    public: std::uint64_t CounterValue = 0;
+    /// <summary>Last reported buckets of the test's histogram</summary>
+    public: std::vector<std::uint64_t> BucketCounts;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Runs an instrumented zone with another zone nested inside</summary>
+  void runNestedZones() {
+    NUCLEX_SUPPORT_INSTRUMENT_ZONE("Tests.Outer");
+    {
+      NUCLEX_SUPPORT_INSTRUMENT_ZONE("Tests.Inner");
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Increments the test's counter</summary>
+  /// <param name="amount">Amount by which the counter will be incremented</param>
+  void addToCounter(std::size_t amount) {
+    NUCLEX_SUPPORT_INSTRUMENT_COUNT("Tests.Counter", amount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Records a value in the test's histogram</summary>
+  /// <param name="value">Value that will be recorded</param>
+  void recordSample(std::size_t value) {
+    NUCLEX_SUPPORT_INSTRUMENT_SAMPLE("Tests.Histogram", value);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentationTest, ZonesAreReportedToInstalledSink) {
+    RecordingSink sink;
+    Instrumentation::SetSink(&sink);
+    runNestedZones();
+    Instrumentation::SetSink(nullptr);
+
+    ASSERT_EQ(sink.EnteredZones.size(), 2U);
+    EXPECT_EQ(sink.EnteredZones[0], u8"Tests.Outer");
+    EXPECT_EQ(sink.EnteredZones[1], u8"Tests.Inner");
+
+    ASSERT_EQ(sink.LeftZones.size(), 2U);
+    EXPECT_EQ(sink.LeftZones[0], u8"Tests.Inner");
+    EXPECT_EQ(sink.LeftZones[1], u8"Tests.Outer");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentationTest, ZonesWithoutSinkAreIgnored) {
+    RecordingSink sink;
+    runNestedZones();
+    EXPECT_EQ(sink.EnteredZones.size(), 0U);
+    EXPECT_EQ(Instrumentation::GetSink(), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentationTest, CountersAccumulate) {
+    RecordingSink before;
+    addToCounter(0); // Makes sure the counter exists
+    Instrumentation::Report(before);
+
+    addToCounter(3);
+    addToCounter(4);
+
+    RecordingSink after;
+    Instrumentation::Report(after);
+    EXPECT_EQ(after.CounterValue - before.CounterValue, 7U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentationTest, HistogramsSortValuesIntoBuckets) {
+    RecordingSink before;
+    recordSample(0); // Makes sure the histogram exists
+    Instrumentation::Report(before);
+
+    recordSample(0);
+    recordSample(1);
+    recordSample(5);
+    recordSample(7);
+
+    RecordingSink after;
+    Instrumentation::Report(after);
+    ASSERT_EQ(after.BucketCounts.size(), Histogram::BucketCount);
+    EXPECT_EQ(after.BucketCounts[0] - before.BucketCounts[0], 1U);
+    EXPECT_EQ(after.BucketCounts[1] - before.BucketCounts[1], 1U);
+    EXPECT_EQ(after.BucketCounts[2] - before.BucketCounts[2], 0U);
+    EXPECT_EQ(after.BucketCounts[3] - before.BucketCounts[3], 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentationTest, BucketIndexIsNumberOfSignificantBits) {
+    EXPECT_EQ(Histogram::GetBucketIndex(0), 0U);
+    EXPECT_EQ(Histogram::GetBucketIndex(1), 1U);
+    EXPECT_EQ(Histogram::GetBucketIndex(2), 2U);
+    EXPECT_EQ(Histogram::GetBucketIndex(3), 2U);
+    EXPECT_EQ(Histogram::GetBucketIndex(4), 3U);
+    EXPECT_EQ(Histogram::GetBucketIndex(0x8000000000000000ULL), 64U);
+    EXPECT_EQ(Histogram::GetBucketIndex(0xFFFFFFFFFFFFFFFFULL), 64U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentationTest, DestroyedCountersAreNotReported) {
+    {
+      Counter counter(u8"Tests.Counter");
+      counter.Add(1000000);
+    }
+
+    RecordingSink sink;
+    addToCounter(0);
+    Instrumentation::Report(sink);
+    EXPECT_LT(sink.CounterValue, 1000000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InstrumentationTest, TimestampsNeverDecrease) {
+    std::uint64_t first = Instrumentation::GetTimestamp();
+    std::uint64_t second = Instrumentation::GetTimestamp();
+    EXPECT_GE(second, first);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -0,0 +1,136 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/MonotonicArena.h"
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::uintptr_t
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MonotonicArenaTest, InstancesCanBeCreated) {
+    EXPECT_NO_THROW(
+      MonotonicArena test;
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MonotonicArenaTest, AllocationsAreAligned) {
+    MonotonicArena arena(256);
+    arena.Allocate(1, 1);
+
+    void *memory = arena.Allocate(16, 16);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(memory) % 16, 0U);
+
+    double *values = arena.AllocateArray<double>(4);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(values) % alignof(double), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MonotonicArenaTest, AllocationsDoNotOverlap) {
+    MonotonicArena arena(64);
+
+    std::vector<std::uint8_t *> allocations;
+    for(std::size_t index = 0; index < 100; ++index) {
+      std::uint8_t *memory = arena.AllocateArray<std::uint8_t>(24);
+      for(std::size_t byteIndex = 0; byteIndex < 24; ++byteIndex) {
+        memory[byteIndex] = static_cast<std::uint8_t>(index);
+      }
+      allocations.push_back(memory);
+    }
+
+    for(std::size_t index = 0; index < 100; ++index) {
+      for(std::size_t byteIndex = 0; byteIndex < 24; ++byteIndex) {
+        EXPECT_EQ(allocations[index][byteIndex], static_cast<std::uint8_t>(index));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MonotonicArenaTest, ResetArenaReusesItsMemory) {
+    MonotonicArena arena(128);
+    for(std::size_t index = 0; index < 50; ++index) {
+      arena.Allocate(100);
+    }
+    std::size_t reservedByteCount = arena.GetReservedByteCount();
+
+    for(std::size_t repetition = 0; repetition < 10; ++repetition) {
+      arena.Reset();
+      for(std::size_t index = 0; index < 50; ++index) {
+        arena.Allocate(100);
+      }
+    }
+
+    EXPECT_EQ(arena.GetReservedByteCount(), reservedByteCount);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MonotonicArenaTest, RewindingReleasesLaterAllocations) {
+    MonotonicArena arena(1024);
+    void *first = arena.Allocate(16);
+
+    MonotonicArena::Marker marker = arena.GetMarker();
+    void *second = arena.Allocate(16);
+    arena.Rewind(marker);
+
+    EXPECT_EQ(arena.Allocate(16), second);
+    EXPECT_NE(first, second);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MonotonicArenaTest, AllocationsLargerThanBlocksAreSupported) {
+    MonotonicArena arena(16);
+    std::uint8_t *memory = arena.AllocateArray<std::uint8_t>(10000);
+    memory[0] = 1;
+    memory[9999] = 2;
+
+    EXPECT_GE(arena.GetReservedByteCount(), 10000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(MonotonicArenaTest, StandardContainersCanUseArena) {
+    MonotonicArena arena;
+    {
+      std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(arena)};
+      values.reserve(100);
+      for(int index = 0; index < 100; ++index) {
+        values.push_back(index);
+      }
+      EXPECT_EQ(values[99], 99);
+    }
+
+    EXPECT_TRUE(ArenaAllocator<int>(arena) == ArenaAllocator<char>(arena));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -0,0 +1,75 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/ScratchScope.h"
+#include <gtest/gtest.h>
+
+#include <thread> // for std::thread
+
+namespace Nuclex { namespace Support {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ScratchScopeTest, MemoryIsReleasedWhenScopeEnds) {
+    void *first;
+    {
+      ScratchScope scratch;
+      first = scratch.Allocate(64);
+    }
+    {
+      ScratchScope scratch;
+      EXPECT_EQ(scratch.Allocate(64), first);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ScratchScopeTest, ScopesCanBeNested) {
+    ScratchScope outer;
+    int *outerValues = outer.AllocateArray<int>(4);
+    outerValues[0] = 123;
+    {
+      ScratchScope inner;
+      int *innerValues = inner.AllocateArray<int>(4);
+      EXPECT_NE(innerValues, outerValues);
+      innerValues[0] = 456;
+    }
+
+    EXPECT_EQ(outerValues[0], 123);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ScratchScopeTest, EachThreadHasItsOwnArena) {
+    MonotonicArena *mainArena = &ScratchScope::GetThreadArena();
+    MonotonicArena *otherArena = nullptr;
+
+    std::thread other([&otherArena]() { otherArena = &ScratchScope::GetThreadArena(); });
+    other.join();
+
+    EXPECT_NE(mainArena, otherArena);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}} // namespace Nuclex::Support
@@ -22,9 +22,14 @@ License along with this library
 #define NUCLEX_SUPPORT_SOURCE 1
 
 #include "Nuclex/Support/Services/LazyServiceInjector.h"
+#include "Nuclex/Support/Services/UnresolvedDependencyError.h"
 
 #include <gtest/gtest.h>
 
+#include <atomic> // for std::atomic
+#include <thread> // for std::thread
+#include <vector> // for std::vector
+
 namespace {
 
   // ------------------------------------------------------------------------------------------- //
@@ -96,6 +101,67 @@ namespace {
 
   // ------------------------------------------------------------------------------------------- //
 
+  class Chicken;
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Example service that depends on a service which depends on it</summary>
+  class Egg {
+
+    /// <summary>Initializes the egg, which requires a chicken to lay it</summary>
+    /// <param name="chicken">Chicken that lays the egg</param>
+    public: Egg(const std::shared_ptr<Chicken> &chicken) :
+      chicken(chicken) {}
+
+    /// <summary>Chicken that laid the egg</summary>
+    private: std::shared_ptr<Chicken> chicken;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Example service that depends on a service which depends on it</summary>
+  class Chicken {
+
+    /// <summary>Initializes the chicken, which requires an egg to hatch from</summary>
+    /// <param name="egg">Egg the chicken hatches from</param>
+    public: Chicken(const std::shared_ptr<Egg> &egg) :
+      egg(egg) {}
+
+    /// <summary>Egg the chicken hatched from</summary>
+    private: std::shared_ptr<Egg> egg;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Number of times the counted calculator factory has been called</summary>
+  std::atomic<int> countedCalculatorCreationCount(0);
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Factory method that counts how many calculators it has created</summary>
+  /// <returns>A new calculator instance</returns>
+  std::shared_ptr<CalculatorService> createCountedCalculator(
+    const Nuclex::Support::Services::ServiceProvider &
+  ) {
+    ++countedCalculatorCreationCount;
+    std::this_thread::yield();
+    return std::make_shared<BrokenCalculator>();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Factory method that fails to create a calculator</summary>
+  /// <returns>Nothing, always throws an exception</returns>
+  std::shared_ptr<CalculatorService> createFailingCalculator(
+    const Nuclex::Support::Services::ServiceProvider &
+  ) {
+    throw std::runtime_error(u8"Calculator failed to construct");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 } // anonymous namespace
 
 namespace Nuclex { namespace Support { namespace Services {
@@ -370,4 +436,108 @@ namespace Nuclex { namespace Support { namespace Services {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(LazyServiceInjectorTest, CyclicDependenciesAreDetected) {
+    LazyServiceInjector serviceInjector;
+
+    serviceInjector.Bind<Chicken>().ToSelf();
+    serviceInjector.Bind<Egg>().ToSelf();
+
+    EXPECT_THROW(serviceInjector.Get<Chicken>(), UnresolvedDependencyError);
+    EXPECT_THROW(serviceInjector.Get<Egg>(), UnresolvedDependencyError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LazyServiceInjectorTest, CyclicDependenciesAreDetectedInConcurrentMode) {
+    LazyServiceInjector serviceInjector(true);
+
+    serviceInjector.Bind<Chicken>().ToSelf();
+    serviceInjector.Bind<Egg>().ToSelf();
+
+    EXPECT_THROW(serviceInjector.Get<Chicken>(), UnresolvedDependencyError);
+    EXPECT_THROW(serviceInjector.Create<Egg>(), UnresolvedDependencyError);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LazyServiceInjectorTest, ConcurrentRequestsConstructServiceOnce) {
+    LazyServiceInjector serviceInjector(true);
+
+    serviceInjector.Bind<CalculatorService>().ToFactoryMethod<&createCountedCalculator>();
+    serviceInjector.Bind<CalculatorUser>().ToSelf();
+    countedCalculatorCreationCount = 0;
+
+    const std::size_t threadCount = 8;
+    std::vector<std::shared_ptr<CalculatorUser>> users(threadCount);
+    {
+      std::vector<std::thread> threads;
+      for(std::size_t index = 0; index < threadCount; ++index) {
+        threads.emplace_back(
+          [&serviceInjector, &users, index]() {
+            users[index] = serviceInjector.Get<CalculatorUser>();
+          }
+        );
+      }
+      for(std::size_t index = 0; index < threadCount; ++index) {
+        threads[index].join();
+      }
+    }
+
+    EXPECT_EQ(countedCalculatorCreationCount.load(), 1);
+    for(std::size_t index = 0; index < threadCount; ++index) {
+      ASSERT_TRUE(!!users[index]);
+      EXPECT_EQ(users[index].get(), users[0].get());
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LazyServiceInjectorTest, InstantiateAllConstructsEveryService) {
+    LazyServiceInjector serviceInjector(true);
+
+    serviceInjector.Bind<CalculatorUser>().ToSelf();
+    serviceInjector.Bind<CalculatorService>().ToFactoryMethod<&createCountedCalculator>();
+    countedCalculatorCreationCount = 0;
+
+    serviceInjector.InstantiateAll(4);
+    EXPECT_EQ(countedCalculatorCreationCount.load(), 1);
+
+    std::shared_ptr<CalculatorUser> user;
+    EXPECT_TRUE(serviceInjector.TryGet(user));
+    EXPECT_EQ(countedCalculatorCreationCount.load(), 1);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LazyServiceInjectorTest, DependenciesAreRecordedDuringConstruction) {
+    LazyServiceInjector serviceInjector;
+
+    serviceInjector.Bind<CalculatorService>().To<BrokenCalculator>();
+    serviceInjector.Bind<CalculatorUser>().ToSelf();
+    EXPECT_TRUE(serviceInjector.GetDependencies<CalculatorUser>().empty());
+
+    serviceInjector.InstantiateAll();
+
+    std::vector<const std::type_info *> dependencies = (
+      serviceInjector.GetDependencies<CalculatorUser>()
+    );
+    ASSERT_EQ(dependencies.size(), 1U);
+    EXPECT_TRUE(*dependencies[0] == typeid(CalculatorService));
+    EXPECT_TRUE(serviceInjector.GetDependencies<CalculatorService>().empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LazyServiceInjectorTest, InstantiateAllReportsConstructionErrors) {
+    LazyServiceInjector serviceInjector(true);
+
+    serviceInjector.Bind<BrokenCalculator>().ToSelf();
+    serviceInjector.Bind<CalculatorService>().ToFactoryMethod<&createFailingCalculator>();
+    serviceInjector.Bind<CalculatorUser>().ToSelf();
+
+    EXPECT_THROW(serviceInjector.InstantiateAll(2), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Services
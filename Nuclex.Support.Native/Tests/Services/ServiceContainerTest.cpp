@@ -152,6 +152,47 @@ namespace Nuclex { namespace Support { namespace Services {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(ServiceContainerTest, ServiceTypesHaveDistinctIndices) {
+    std::size_t calculatorIndex = GetServiceIndex<CalculatorService>();
+    std::size_t testerIndex = GetServiceIndex<DestructorTester>();
+
+    EXPECT_NE(calculatorIndex, testerIndex);
+    EXPECT_EQ(GetServiceIndex<CalculatorService>(), calculatorIndex);
+    EXPECT_EQ(GetServiceIndex(typeid(CalculatorService)), calculatorIndex);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ServiceContainerTest, ServicesStayInPlaceWhenMoreAreAdded) {
+    ServiceContainer test;
+    test.Add<CalculatorService>(std::make_shared<BrokenCalculator>());
+
+    const std::shared_ptr<CalculatorService> &calculator = test.Get<CalculatorService>();
+    test.Add(std::make_shared<DestructorTester>(nullptr));
+    EXPECT_EQ(test.CountServices(), 2U);
+
+    EXPECT_EQ(&test.Get<CalculatorService>(), &calculator);
+    EXPECT_EQ(calculator->Add(1, 2), 4);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ServiceContainerTest, ServicesCanNotBeAddedTwice) {
+    ServiceContainer test;
+    test.Add<CalculatorService>(std::make_shared<BrokenCalculator>());
+    EXPECT_THROW(
+      test.Add<CalculatorService>(std::make_shared<BrokenCalculator>()),
+      std::runtime_error
+    );
+    EXPECT_EQ(test.CountServices(), 1U);
+
+    EXPECT_TRUE(test.Remove<CalculatorService>());
+    EXPECT_FALSE(test.Remove<CalculatorService>());
+    EXPECT_EQ(test.CountServices(), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   TEST(ServiceContainerTest, ContainerDestructorReleasesServices) {
     bool destructorCalled = false;
     std::weak_ptr<DestructorTester> weak;
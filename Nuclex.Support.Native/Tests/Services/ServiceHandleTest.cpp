@@ -0,0 +1,115 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Services/ServiceHandle.h"
+#include "Nuclex/Support/Services/ServiceContainer.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // for std::runtime_error
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Example service that reports a number</summary>
+  class NumberService {
+
+    /// <summary>Initializes a new number service</summary>
+    /// <param name="number">Number the service will report</param>
+    public: NumberService(int number) :
+      number(number) {}
+
+    /// <summary>Returns the number the service was initialized with</summary>
+    /// <returns>The service's number</returns>
+    public: int GetNumber() const { return this->number; }
+
+    /// <summary>Number the service reports</summary>
+    private: int number;
+
+  };
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Services {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ServiceHandleTest, HandleProvidesService) {
+    ServiceContainer container;
+    container.Add(std::make_shared<NumberService>(42));
+
+    ServiceHandle<NumberService> handle(container);
+    EXPECT_EQ(handle->GetNumber(), 42);
+    EXPECT_EQ((*handle).GetNumber(), 42);
+    EXPECT_EQ(handle.Get().get(), container.Get<NumberService>().get());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ServiceHandleTest, MissingServiceThrowsException) {
+    ServiceContainer container;
+    ServiceHandle<NumberService> handle(container);
+
+    EXPECT_THROW(handle.Get(), std::runtime_error);
+
+    // Once the service becomes available, the handle picks it up
+    container.Add(std::make_shared<NumberService>(123));
+    EXPECT_EQ(handle->GetNumber(), 123);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ServiceHandleTest, HandleNoticesExchangedService) {
+    ServiceContainer container;
+    container.Add(std::make_shared<NumberService>(1));
+
+    ServiceHandle<NumberService> handle(container);
+    EXPECT_EQ(handle->GetNumber(), 1);
+
+    container.Remove<NumberService>();
+    container.Add(std::make_shared<NumberService>(2));
+    EXPECT_EQ(handle->GetNumber(), 2);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ServiceHandleTest, ResetReleasesService) {
+    ServiceContainer container;
+    container.Add(std::make_shared<NumberService>(3));
+
+    ServiceHandle<NumberService> handle(container);
+    std::weak_ptr<NumberService> weak = handle.Get();
+
+    container.Remove<NumberService>();
+    EXPECT_FALSE(weak.expired());
+
+    handle.Reset();
+    EXPECT_TRUE(weak.expired());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Services
@@ -0,0 +1,131 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/InternedString.h"
+
+#include <gtest/gtest.h>
+
+#include <string> // for std::string
+#include <thread> // for std::thread
+#include <unordered_set> // for std::unordered_set
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InternedStringTest, DefaultConstructedStringIsEmpty) {
+    InternedString test;
+    EXPECT_TRUE(test.IsEmpty());
+    EXPECT_EQ(test.GetLength(), 0U);
+    EXPECT_EQ(test, InternedString(u8""));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InternedStringTest, EqualTextsShareOneCopy) {
+    std::string text(u8"Hello World");
+    InternedString first(text);
+    InternedString second(u8"Hello World");
+    InternedString third(u8"Hello World, Goodbye", 11);
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first, third);
+    EXPECT_EQ(&first.ToString(), &second.ToString());
+    EXPECT_EQ(first.GetHash(), third.GetHash());
+    EXPECT_EQ(first.ToString(), text);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InternedStringTest, DifferentTextsAreDifferent) {
+    InternedString first(u8"Width");
+    InternedString second(u8"width");
+
+    EXPECT_NE(first, second);
+    EXPECT_NE(&first.ToString(), &second.ToString());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InternedStringTest, TextCanContainZeroBytes) {
+    InternedString withZero(u8"ab\0cd", 5);
+    InternedString truncated(u8"ab");
+
+    EXPECT_EQ(withZero.GetLength(), 5U);
+    EXPECT_NE(withZero, truncated);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InternedStringTest, CanBeUsedAsStandardString) {
+    InternedString test(u8"Extension");
+    const std::string &text = test;
+
+    EXPECT_EQ(&text, &test.ToString());
+    EXPECT_STREQ(test.GetCharacters(), u8"Extension");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InternedStringTest, CanBeUsedInHashContainers) {
+    std::unordered_set<InternedString> names;
+    names.insert(InternedString(u8"png"));
+    names.insert(InternedString(u8"jpg"));
+    names.insert(InternedString(u8"png"));
+
+    EXPECT_EQ(names.size(), 2U);
+    EXPECT_EQ(names.count(InternedString(u8"jpg")), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(InternedStringTest, ThreadsInterningSameTextsGetSameCopies) {
+    const std::size_t ThreadCount = 4;
+    const std::size_t TextCount = 200;
+
+    std::vector<std::vector<InternedString>> results(ThreadCount);
+    std::vector<std::thread> threads;
+    for(std::size_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex) {
+      threads.emplace_back(
+        [&results, threadIndex, TextCount]() {
+          for(std::size_t index = 0; index < TextCount; ++index) {
+            results[threadIndex].emplace_back(u8"Name" + std::to_string(index));
+          }
+        }
+      );
+    }
+    for(std::size_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex) {
+      threads[threadIndex].join();
+    }
+
+    for(std::size_t threadIndex = 1; threadIndex < ThreadCount; ++threadIndex) {
+      for(std::size_t index = 0; index < TextCount; ++index) {
+        EXPECT_EQ(results[threadIndex][index], results[0][index]);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
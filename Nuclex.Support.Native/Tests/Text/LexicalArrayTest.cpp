@@ -0,0 +1,127 @@
+﻿#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/LexicalArray.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalArrayTest, ArraysCanBeFormatted) {
+    const std::int32_t integers[] = { 1, -22, 333, -4444 };
+    std::string text(u8"values=");
+    FormatArray(integers, 4, text);
+    EXPECT_EQ(text, u8"values=1,-22,333,-4444");
+
+    const double doubles[] = { 0.5, -1.25, 3.0 };
+    text.clear();
+    FormatArray(doubles, 3, text, ' ');
+    EXPECT_EQ(
+      text,
+      lexical_cast<std::string>(0.5) + u8" " +
+      lexical_cast<std::string>(-1.25) + u8" " +
+      lexical_cast<std::string>(3.0)
+    );
+
+    text.clear();
+    FormatArray(doubles, 0, text);
+    EXPECT_TRUE(text.empty());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalArrayTest, ArraysCanBeParsed) {
+    std::string text(u8"1, 2 ,3,\r\n-4");
+    std::vector<std::int64_t> integers;
+    lexical_parse_result result = ParseArray(text.data(), text.data() + text.length(), integers);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(result.ptr, text.data() + text.length());
+    ASSERT_EQ(integers.size(), 4U);
+    EXPECT_EQ(integers[0], 1);
+    EXPECT_EQ(integers[3], -4);
+
+    text.assign(u8"  0.5   -1.5\t2e3 ");
+    std::vector<float> floats;
+    result = ParseArray(text.data(), text.data() + text.length(), floats, ' ');
+    EXPECT_EQ(result.ec, std::errc());
+    ASSERT_EQ(floats.size(), 3U);
+    EXPECT_EQ(floats[0], 0.5f);
+    EXPECT_EQ(floats[1], -1.5f);
+    EXPECT_EQ(floats[2], 2000.0f);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalArrayTest, ParsingMalformedArraysReportsError) {
+    std::vector<std::uint32_t> integers;
+
+    std::string missingSeparator(u8"1,2 3");
+    lexical_parse_result result = ParseArray(
+      missingSeparator.data(), missingSeparator.data() + missingSeparator.length(), integers
+    );
+    EXPECT_EQ(result.ec, std::errc::invalid_argument);
+    EXPECT_EQ(result.ptr, missingSeparator.data() + 4);
+    EXPECT_EQ(integers.size(), 2U);
+
+    integers.clear();
+    std::string trailingSeparator(u8"1,2,");
+    result = ParseArray(
+      trailingSeparator.data(), trailingSeparator.data() + trailingSeparator.length(), integers
+    );
+    EXPECT_EQ(result.ec, std::errc::invalid_argument);
+
+    integers.clear();
+    std::string tooLarge(u8"1,99999999999");
+    result = ParseArray(tooLarge.data(), tooLarge.data() + tooLarge.length(), integers);
+    EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+    EXPECT_EQ(integers.size(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalArrayTest, ParallelFormattingMatchesSerialFormatting) {
+    std::vector<double> values(300000);
+    for(std::size_t index = 0; index < values.size(); ++index) {
+      values[index] = static_cast<double>(index) / 7.0;
+    }
+
+    std::string serial(u8"[");
+    FormatArray(values.data(), values.size(), serial);
+
+    std::string parallel(u8"[");
+    FormatArrayInParallel(values.data(), values.size(), parallel, ',', 4);
+    EXPECT_EQ(parallel, serial);
+
+    std::vector<double> parsed;
+    lexical_parse_result result = ParseArray(
+      parallel.data() + 1, parallel.data() + parallel.length(), parsed
+    );
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(parsed, values);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
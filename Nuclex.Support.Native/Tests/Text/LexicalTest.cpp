@@ -25,6 +25,7 @@ License along with this library
 
 #include <cmath>
 #include <clocale>
+#include <limits>
 
 #include <gtest/gtest.h>
 
@@ -413,4 +414,242 @@ namespace Nuclex { namespace Support { namespace Text {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(LexicalTest, DoubleToStringHandlesExtremeValues) {
+    std::string text = lexical_cast<std::string>(-std::numeric_limits<double>::max());
+    EXPECT_EQ(text.length(), 310U);
+    EXPECT_EQ(text.substr(0, 5), "-1797");
+
+    text = lexical_cast<std::string>(-std::numeric_limits<double>::denorm_min());
+    EXPECT_LE(text.length(), MaximumLexicalPrintLength);
+    EXPECT_EQ(text.substr(0, 5), "-0.00");
+    EXPECT_EQ(text.back(), '5');
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, ValuesCanBePrintedIntoCharacterBuffer) {
+    char characters[MaximumLexicalPrintLength];
+
+    char *end = lexical_print(false, characters);
+    EXPECT_EQ(std::string(characters, end), "false");
+    end = lexical_print(static_cast<std::uint8_t>(255), characters);
+    EXPECT_EQ(std::string(characters, end), "255");
+    end = lexical_print(static_cast<std::int16_t>(-32768), characters);
+    EXPECT_EQ(std::string(characters, end), "-32768");
+    end = lexical_print(static_cast<std::uint32_t>(4294967295U), characters);
+    EXPECT_EQ(std::string(characters, end), "4294967295");
+    end = lexical_print(static_cast<std::int64_t>(-9223372036854775807LL - 1), characters);
+    EXPECT_EQ(std::string(characters, end), "-9223372036854775808");
+    end = lexical_print(0.125f, characters);
+    EXPECT_EQ(std::string(characters, end), "0.125");
+    end = lexical_print(0.1, characters);
+    EXPECT_EQ(std::string(characters, end), "0.1");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, ValuesCanBePrintedIntoCharacterRange) {
+    char characters[6] = { 'x', 'x', 'x', 'x', 'x', 'x' };
+
+    lexical_print_result result = lexical_print(
+      characters, characters + 6, static_cast<std::int32_t>(-12345)
+    );
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(std::string(characters, result.ptr), "-12345");
+
+    result = lexical_print(characters, characters + 5, 0.125);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(std::string(characters, result.ptr), "0.125");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, PrintingIntoTooSmallRangeFails) {
+    char characters[4] = { 'x', 'x', 'x', 'x' };
+
+    lexical_print_result result = lexical_print(
+      characters, characters + 4, static_cast<std::uint32_t>(12345)
+    );
+    EXPECT_EQ(result.ec, std::errc::value_too_large);
+    EXPECT_EQ(result.ptr, characters + 4);
+    EXPECT_EQ(std::string(characters, 4), "xxxx");
+
+    result = lexical_print(characters, characters + 4, false);
+    EXPECT_EQ(result.ec, std::errc::value_too_large);
+
+    result = lexical_print(characters, characters + 4, true);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(std::string(characters, result.ptr), "true");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, IntegersCanBeParsedFromCharacterRange) {
+    std::string text(u8"12345678901234567890,-42;0007");
+
+    std::uint64_t unsignedValue = 0;
+    lexical_parse_result result = lexical_parse(
+      text.data(), text.data() + text.length(), unsignedValue
+    );
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(result.ptr, text.data() + 20);
+    EXPECT_EQ(unsignedValue, 12345678901234567890ULL);
+
+    std::int32_t signedValue = 0;
+    result = lexical_parse(result.ptr + 1, text.data() + text.length(), signedValue);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(*result.ptr, ';');
+    EXPECT_EQ(signedValue, -42);
+
+    std::uint8_t byteValue = 0;
+    result = lexical_parse(result.ptr + 1, text.data() + text.length(), byteValue);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(result.ptr, text.data() + text.length());
+    EXPECT_EQ(byteValue, 7U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, IntegerParsingMatchesPrinting) {
+    std::uint64_t value = 1;
+    for(std::size_t index = 0; index < 64; ++index) {
+      for(std::uint64_t offset = 0; offset < 3; ++offset) {
+        std::uint64_t expected = (value << index) - offset;
+        std::string text = lexical_cast<std::string>(expected);
+
+        std::uint64_t parsed = 0;
+        lexical_parse_result result = lexical_parse(
+          text.data(), text.data() + text.length(), parsed
+        );
+        EXPECT_EQ(result.ec, std::errc());
+        EXPECT_EQ(parsed, expected);
+      }
+    }
+
+    std::int64_t parsed = 0;
+    std::string minimum(u8"-9223372036854775808");
+    lexical_parse(minimum.data(), minimum.data() + minimum.length(), parsed);
+    EXPECT_EQ(parsed, std::numeric_limits<std::int64_t>::min());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, IntegerParsingReportsErrors) {
+    std::uint16_t value = 1234;
+
+    std::string tooLarge(u8"65536");
+    lexical_parse_result result = lexical_parse(
+      tooLarge.data(), tooLarge.data() + tooLarge.length(), value
+    );
+    EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+    EXPECT_EQ(result.ptr, tooLarge.data() + tooLarge.length());
+    EXPECT_EQ(value, 1234U);
+
+    std::string negative(u8"-1");
+    result = lexical_parse(negative.data(), negative.data() + negative.length(), value);
+    EXPECT_EQ(result.ec, std::errc::invalid_argument);
+    EXPECT_EQ(result.ptr, negative.data());
+
+    std::int8_t signedValue = 0;
+    std::string onlySign(u8"-");
+    result = lexical_parse(onlySign.data(), onlySign.data() + 1, signedValue);
+    EXPECT_EQ(result.ec, std::errc::invalid_argument);
+    std::string belowMinimum(u8"-129");
+    result = lexical_parse(belowMinimum.data(), belowMinimum.data() + 4, signedValue);
+    EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+
+    std::uint64_t largeValue = 0;
+    std::string overflowing(u8"18446744073709551616");
+    result = lexical_parse(
+      overflowing.data(), overflowing.data() + overflowing.length(), largeValue
+    );
+    EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, FloatingPointValuesCanBeParsedFromCharacterRange) {
+    std::string text(u8"0.25,-1.5e3;12e;5.");
+
+    double doubleValue = 0.0;
+    lexical_parse_result result = lexical_parse(
+      text.data(), text.data() + text.length(), doubleValue
+    );
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(*result.ptr, ',');
+    EXPECT_EQ(doubleValue, 0.25);
+
+    float floatValue = 0.0f;
+    result = lexical_parse(result.ptr + 1, text.data() + text.length(), floatValue);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(*result.ptr, ';');
+    EXPECT_EQ(floatValue, -1500.0f);
+
+    // An exponent without digits is not part of the number
+    result = lexical_parse(result.ptr + 1, text.data() + text.length(), doubleValue);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(*result.ptr, 'e');
+    EXPECT_EQ(doubleValue, 12.0);
+
+    result = lexical_parse(result.ptr + 2, text.data() + text.length(), doubleValue);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(result.ptr, text.data() + text.length());
+    EXPECT_EQ(doubleValue, 5.0);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, FloatingPointParsingMatchesPrinting) {
+    const double values[] = {
+      0.1, 0.3, 1.0 / 3.0, 2.0 / 3.0, 123456.789, 1e22, 1e23, 5e-324, 2.2250738585072014e-308,
+      1.7976931348623157e308, 9007199254740993.0, 3.141592653589793, 0.000001907348632812
+    };
+    for(double expected : values) {
+      std::string text = lexical_cast<std::string>(expected);
+      EXPECT_EQ(lexical_cast<double>(text), expected) << text;
+
+      text = lexical_cast<std::string>(-expected);
+      EXPECT_EQ(lexical_cast<double>(text), -expected) << text;
+    }
+
+    const float floatValues[] = {
+      0.1f, 0.3f, 16777217.0f, 1e10f, 1e-10f, 3.4028235e38f, 1.17549435e-38f, 1e-45f
+    };
+    for(float expected : floatValues) {
+      std::string text = lexical_cast<std::string>(expected);
+      EXPECT_EQ(lexical_cast<float>(text), expected) << text;
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(LexicalTest, FloatingPointParsingReportsErrors) {
+    double value = 1.0;
+
+    std::string notANumber(u8"-.e5");
+    lexical_parse_result result = lexical_parse(
+      notANumber.data(), notANumber.data() + notANumber.length(), value
+    );
+    EXPECT_EQ(result.ec, std::errc::invalid_argument);
+    EXPECT_EQ(result.ptr, notANumber.data());
+
+    std::string tooLarge(u8"1e400");
+    result = lexical_parse(tooLarge.data(), tooLarge.data() + tooLarge.length(), value);
+    EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+    EXPECT_EQ(result.ptr, tooLarge.data() + tooLarge.length());
+    EXPECT_EQ(value, 1.0);
+
+    float floatValue = 1.0f;
+    std::string tooLargeForFloat(u8"1e39");
+    result = lexical_parse(
+      tooLargeForFloat.data(), tooLargeForFloat.data() + tooLargeForFloat.length(), floatValue
+    );
+    EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+
+    EXPECT_TRUE(std::isnan(lexical_cast<double>(u8"1.5 ")));
+    EXPECT_TRUE(std::isnan(lexical_cast<float>(std::string(u8"abc"))));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Text
@@ -0,0 +1,160 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/StringBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // for std::int32_t, std::uint64_t
+#include <string> // for std::string
+#include <utility> // for std::move()
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, NewBuilderIsEmpty) {
+    StringBuilder builder;
+    EXPECT_TRUE(builder.IsEmpty());
+    EXPECT_EQ(builder.GetLength(), 0U);
+    EXPECT_EQ(builder.ToString(), std::string());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, TextCanBeAppended) {
+    StringBuilder builder;
+    builder.Append(u8"Hello");
+    builder.Append(' ');
+    builder.Append(std::string(u8"World"));
+    builder.Append(u8"!?", 1);
+
+    EXPECT_EQ(builder.ToString(), std::string(u8"Hello World!"));
+    EXPECT_EQ(std::string(builder.GetCharacters(), builder.GetLength()), builder.ToString());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, BufferGrowsAsNeeded) {
+    StringBuilder builder(4);
+    EXPECT_GE(builder.GetCapacity(), 4U);
+
+    std::string expected;
+    for(std::size_t index = 0; index < 1000; ++index) {
+      builder.Append(u8"abc");
+      expected.append(u8"abc");
+    }
+
+    EXPECT_EQ(builder.ToString(), expected);
+    EXPECT_GE(builder.GetCapacity(), 3000U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, ClearingKeepsCapacity) {
+    StringBuilder builder;
+    builder.Append(u8"Some text that will be removed again");
+    std::size_t capacity = builder.GetCapacity();
+
+    builder.Clear();
+    EXPECT_TRUE(builder.IsEmpty());
+    EXPECT_EQ(builder.GetCapacity(), capacity);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, NumbersAreAppendedLikeLexicalCast) {
+    StringBuilder builder;
+    builder.Append(std::int32_t(-123));
+    builder.Append(',');
+    builder.Append(std::uint64_t(18446744073709551615ULL));
+    builder.Append(',');
+    builder.Append(0.1f);
+    builder.Append(',');
+    builder.Append(2.5);
+    builder.Append(',');
+    builder.Append(true);
+
+    EXPECT_EQ(
+      builder.ToString(), std::string(u8"-123,18446744073709551615,0.1,2.5,true")
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, XmlSpecialCharactersAreEscaped) {
+    StringBuilder builder;
+    builder.AppendXmlEscaped(std::string(u8"<a href=\"x\">Tom & Jerry's</a>"));
+
+    EXPECT_EQ(
+      builder.ToString(),
+      std::string(u8"&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&apos;s&lt;/a&gt;")
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, LongTextsAreEscapedInBlocks) {
+    std::string text(100, 'x');
+    text[3] = '<';
+    text[40] = '&';
+    text[99] = '"';
+
+    StringBuilder builder;
+    builder.AppendXmlEscaped(text);
+
+    std::string expected(100, 'x');
+    expected.replace(99, 1, u8"&quot;");
+    expected.replace(40, 1, u8"&amp;");
+    expected.replace(3, 1, u8"&lt;");
+    EXPECT_EQ(builder.ToString(), expected);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, JsonSpecialCharactersAreEscaped) {
+    StringBuilder builder;
+    builder.AppendJsonEscaped(std::string(u8"Say \"hi\"\n\tC:\\path\x01 \xc3\xa4"));
+
+    EXPECT_EQ(
+      builder.ToString(),
+      std::string(u8"Say \\\"hi\\\"\\n\\tC:\\\\path\\u0001 \xc3\xa4")
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringBuilderTest, BuilderCanBeMoved) {
+    StringBuilder first;
+    first.Append(u8"Moved text");
+
+    StringBuilder second(std::move(first));
+    EXPECT_EQ(second.ToString(), std::string(u8"Moved text"));
+
+    first = std::move(second);
+    EXPECT_EQ(first.ToString(), std::string(u8"Moved text"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
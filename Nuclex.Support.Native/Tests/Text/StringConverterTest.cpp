@@ -94,6 +94,137 @@ namespace Nuclex { namespace Support { namespace Text {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(StringConverterTest, LongAsciiRunsSurviveRoundTrip) {
+    std::string text = (
+      u8"This sentence is long enough to be converted in blocks of sixteen characters, "
+      u8"then äöü interrupts it, 𝒙 follows a little later and the rest is ASCII again."
+    );
+
+    std::wstring wide = StringConverter::WideFromUtf8(text);
+    EXPECT_EQ(
+      wide,
+      L"This sentence is long enough to be converted in blocks of sixteen characters, "
+      L"then äöü interrupts it, 𝒙 follows a little later and the rest is ASCII again."
+    );
+    EXPECT_EQ(StringConverter::Utf8FromWide(wide), text);
+
+    std::u16string utf16 = StringConverter::Utf16FromUtf8(text);
+    EXPECT_EQ(
+      utf16,
+      u"This sentence is long enough to be converted in blocks of sixteen characters, "
+      u"then äöü interrupts it, 𝒙 follows a little later and the rest is ASCII again."
+    );
+    EXPECT_EQ(StringConverter::Utf8FromUtf16(utf16), text);
+
+    std::u32string utf32 = StringConverter::Utf32FromUtf8(text);
+    EXPECT_EQ(
+      utf32,
+      U"This sentence is long enough to be converted in blocks of sixteen characters, "
+      U"then äöü interrupts it, 𝒙 follows a little later and the rest is ASCII again."
+    );
+    EXPECT_EQ(StringConverter::Utf8FromUtf32(utf32), text);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringConverterTest, MostlyNonAsciiStringsCanGrowWhenConverted) {
+    std::u32string utf32(1000, U'𝒙');
+    std::string utf8 = StringConverter::Utf8FromUtf32(utf32);
+    EXPECT_EQ(4000U, utf8.length());
+    EXPECT_EQ(StringConverter::Utf32FromUtf8(utf8), utf32);
+
+    std::u16string utf16 = StringConverter::Utf16FromUtf8(utf8);
+    EXPECT_EQ(2000U, utf16.length());
+    EXPECT_EQ(StringConverter::Utf8FromUtf16(utf16), utf8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringConverterTest, InvalidCharactersCauseException) {
+    std::string invalidUtf8(u8"Twenty ASCII letters X and a lone lead byte");
+    invalidUtf8[21] = static_cast<char>(0xC3);
+    EXPECT_ANY_THROW(StringConverter::Utf16FromUtf8(invalidUtf8));
+    EXPECT_ANY_THROW(StringConverter::Utf32FromUtf8(invalidUtf8));
+
+    std::u16string loneSurrogate(u"Twenty ASCII letters and a lone surrogate ");
+    loneSurrogate.push_back(static_cast<char16_t>(0xD800));
+    EXPECT_ANY_THROW(StringConverter::Utf8FromUtf16(loneSurrogate));
+
+    std::u32string outOfRange(U"Twenty ASCII letters and a code point out of range ");
+    outOfRange.push_back(static_cast<char32_t>(0x110000));
+    EXPECT_ANY_THROW(StringConverter::Utf8FromUtf32(outOfRange));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringConverterTest, CanConvertIntoProvidedBuffer) {
+    std::string utf8(u8"Hello \U0001F600 Wörld");
+
+    char16_t utf16[32];
+    std::size_t utf16Length = StringConverter::Utf16FromUtf8(
+      utf8.data(), utf8.length(), utf16, 32
+    );
+    EXPECT_EQ(std::u16string(utf16, utf16Length), StringConverter::Utf16FromUtf8(utf8));
+
+    char roundTripped[32];
+    std::size_t utf8Length = StringConverter::Utf8FromUtf16(
+      utf16, utf16Length, roundTripped, 32
+    );
+    EXPECT_EQ(std::string(roundTripped, utf8Length), utf8);
+
+    char32_t utf32[32];
+    std::size_t utf32Length = StringConverter::Utf32FromUtf8(
+      utf8.data(), utf8.length(), utf32, 32
+    );
+    EXPECT_EQ(utf32Length, 13U);
+    utf8Length = StringConverter::Utf8FromUtf32(utf32, utf32Length, roundTripped, 32);
+    EXPECT_EQ(std::string(roundTripped, utf8Length), utf8);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringConverterTest, TooSmallBufferReportsRequiredLength) {
+    std::u32string utf32(U"Smiley \U0001F600 and then a lot of ASCII characters");
+    std::string expected = StringConverter::Utf8FromUtf32(utf32);
+
+    // Stops before the 4 byte smiley, which does not fit anymore
+    char utf8[10];
+    std::size_t requiredLength = StringConverter::Utf8FromUtf32(
+      utf32.data(), utf32.length(), utf8, 10
+    );
+    EXPECT_EQ(requiredLength, expected.length());
+    EXPECT_EQ(std::string(utf8, 7), std::string(u8"Smiley "));
+
+    // A buffer of the reported length is large enough
+    std::string buffer(requiredLength, '\0');
+    EXPECT_EQ(
+      StringConverter::Utf8FromUtf32(utf32.data(), utf32.length(), &buffer[0], buffer.length()),
+      requiredLength
+    );
+    EXPECT_EQ(buffer, expected);
+
+    EXPECT_EQ(StringConverter::Utf16FromUtf8(expected.data(), expected.length(), nullptr, 0), 44U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringConverterTest, CanAppendToExistingString) {
+    std::string utf8(u8"Path: ");
+    StringConverter::AppendUtf8FromUtf16(utf8, u"C:\\Bücher", 9);
+    EXPECT_EQ(utf8, std::string(u8"Path: C:\\Bücher"));
+
+    std::u16string utf16(u"Path: ");
+    StringConverter::AppendUtf16FromUtf8(utf16, u8"/home/äöü", 12);
+    EXPECT_EQ(utf16, std::u16string(u"Path: /home/äöü"));
+
+    std::wstring wide(L"Path: ");
+    std::string directory(u8"/tmp/\U0001F600");
+    StringConverter::AppendWideFromUtf8(wide, directory.data(), directory.length());
+    EXPECT_EQ(StringConverter::Utf8FromWide(wide), std::string(u8"Path: /tmp/\U0001F600"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   TEST(StringConverterTest, Utf8StringsCanBeCaseFolded) {
     std::string variant1 = u8"HeLlO wOrLd Ä ö Ü λ Φ δ ẞ";
     std::string variant2 = u8"hElLo WoRlD ä Ö ü Λ φ Δ ß";
@@ -116,4 +247,14 @@ namespace Nuclex { namespace Support { namespace Text {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(StringConverterTest, LongAsciiStringsCanBeCaseFolded) {
+    std::string mixed = u8"ABCDEFGHIJKLMNOPQRSTUVWXYZ @[`{ abcdefghijklmnopqrstuvwxyz Ä";
+    EXPECT_EQ(
+      StringConverter::FoldedLowercaseFromUtf8(mixed),
+      std::string(u8"abcdefghijklmnopqrstuvwxyz @[`{ abcdefghijklmnopqrstuvwxyz ä")
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }}} // namespace Nuclex::Support::Text
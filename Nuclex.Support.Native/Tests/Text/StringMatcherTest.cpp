@@ -25,6 +25,7 @@ License along with this library
 
 #include <cmath>
 #include <clocale>
+#include <unordered_map>
 
 #include <gtest/gtest.h>
 
@@ -50,6 +51,56 @@ namespace Nuclex { namespace Support { namespace Text {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(StringMatcherTest, LongStringsAreComparedCaseInsensitive) {
+    EXPECT_TRUE(
+      StringMatcher::AreEqual(
+        u8"The Quick Brown Fox Jumps Over The Lazy Dog [@`{~]",
+        u8"tHE qUICK bROWN fOX jUMPS oVER tHE lAZY dOG [@`{~]"
+      )
+    );
+    EXPECT_TRUE(
+      StringMatcher::AreEqual(
+        u8"Sixteen ASCII ch Ärgerlich Längere Unicode Texte",
+        u8"sixteen ascii CH ärgerlich LÄNGERE unicode TEXTE"
+      )
+    );
+
+    // Characters next to the letters must not be matched to them by the fast path
+    EXPECT_FALSE(
+      StringMatcher::AreEqual(
+        u8"The Quick Brown Fox Jumps Over The Lazy Dog @",
+        u8"The Quick Brown Fox Jumps Over The Lazy Dog `"
+      )
+    );
+    EXPECT_FALSE(
+      StringMatcher::AreEqual(u8"Sixteen ASCII ch Ünicøde", u8"Sixteen ASCII ch Ünicøde!")
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringMatcherTest, CaseInsensitiveHashIgnoresCase) {
+    CaseInsensitiveUtf8Hash hash;
+    EXPECT_EQ(hash(u8"Hello World"), hash(u8"hELLO wORLD"));
+    EXPECT_EQ(hash(u8"Ünicøde"), hash(u8"üNICØDE"));
+    EXPECT_NE(hash(u8"Hello World"), hash(u8"Hello Wörld"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(StringMatcherTest, CanBuildCaseInsensitiveMap) {
+    std::unordered_map<std::string, int, CaseInsensitiveUtf8Hash, CaseInsensitiveUtf8Equal> map;
+    map[u8"Ünicøde"] = 1;
+    map[u8"Hello"] = 2;
+
+    EXPECT_EQ(map.size(), 2U);
+    EXPECT_EQ(map[u8"üNICØDE"], 1);
+    EXPECT_EQ(map[u8"HELLO"], 2);
+    EXPECT_EQ(map.count(u8"World"), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
   TEST(StringMatcherTest, WilcardMatchDefaultsToCaseInsensitive) {
     EXPECT_TRUE(StringMatcher::FitsWildcard(u8"Hello World", u8"hello world"));
     EXPECT_TRUE(StringMatcher::FitsWildcard(u8"HellØ WØrld", u8"hellø wørld"));
@@ -0,0 +1,129 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/Utf8Validator.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  /// <summary>Builds a string from the specified bytes</summary>
+  /// <param name="bytes">Bytes the string will contain, terminated by a zero</param>
+  /// <returns>A string containing the specified bytes</returns>
+  std::string fromBytes(const unsigned char *bytes) {
+    return std::string(reinterpret_cast<const char *>(bytes));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Utf8ValidatorTest, ValidTextIsAccepted) {
+    EXPECT_TRUE(Utf8Validator::IsValid(std::string()));
+    EXPECT_TRUE(Utf8Validator::IsValid(std::string(u8"Hello World")));
+    EXPECT_TRUE(Utf8Validator::IsValid(std::string(u8"ăѣ𝔠ծềſģȟᎥ𝒋ǩľḿꞑȯ𝘱𝑞𝗋𝘴ȶ𝞄𝜈ψ𝒙𝘆𝚣")));
+
+    // Largest code point and the code points around the surrogates
+    const unsigned char largest[] = { 0xF4, 0x8F, 0xBF, 0xBF, 0 };
+    EXPECT_TRUE(Utf8Validator::IsValid(fromBytes(largest)));
+    const unsigned char beforeSurrogates[] = { 0xED, 0x9F, 0xBF, 0 };
+    EXPECT_TRUE(Utf8Validator::IsValid(fromBytes(beforeSurrogates)));
+    const unsigned char afterSurrogates[] = { 0xEE, 0x80, 0x80, 0 };
+    EXPECT_TRUE(Utf8Validator::IsValid(fromBytes(afterSurrogates)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Utf8ValidatorTest, InvalidSequencesAreRejected) {
+    const unsigned char loneContinuation[] = { 'a', 0x80, 'b', 0 };
+    EXPECT_FALSE(Utf8Validator::IsValid(fromBytes(loneContinuation)));
+    const unsigned char truncated[] = { 'a', 0xE2, 0x82, 0 };
+    EXPECT_FALSE(Utf8Validator::IsValid(fromBytes(truncated)));
+    const unsigned char overlong2[] = { 0xC0, 0xAF, 0 };
+    EXPECT_FALSE(Utf8Validator::IsValid(fromBytes(overlong2)));
+    const unsigned char overlong3[] = { 0xE0, 0x80, 0xAF, 0 };
+    EXPECT_FALSE(Utf8Validator::IsValid(fromBytes(overlong3)));
+    const unsigned char overlong4[] = { 0xF0, 0x80, 0x80, 0xAF, 0 };
+    EXPECT_FALSE(Utf8Validator::IsValid(fromBytes(overlong4)));
+    const unsigned char surrogate[] = { 0xED, 0xA0, 0x80, 0 };
+    EXPECT_FALSE(Utf8Validator::IsValid(fromBytes(surrogate)));
+    const unsigned char tooLarge[] = { 0xF4, 0x90, 0x80, 0x80, 0 };
+    EXPECT_FALSE(Utf8Validator::IsValid(fromBytes(tooLarge)));
+    const unsigned char invalidLead[] = { 0xF8, 0x88, 0x80, 0x80, 0x80, 0 };
+    EXPECT_FALSE(Utf8Validator::IsValid(fromBytes(invalidLead)));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Utf8ValidatorTest, ErrorsAreFoundAtEveryPosition) {
+    std::string text(u8"Twenty ASCII letters and some ümläüts, €uros and 𝒞ℎ𝒶𝓇𝓈 to check");
+    ASSERT_TRUE(Utf8Validator::IsValid(text));
+
+    // Breaking any byte into a lone continuation byte or a lead byte without its
+    // continuation bytes has to be noticed, no matter where it is in the blocks
+    for(std::size_t index = 0; index < text.length(); ++index) {
+      std::string damaged(text);
+      unsigned char byte = static_cast<unsigned char>(text[index]);
+      if((byte & 0xC0) == 0x80) {
+        damaged[index] = 'x'; // Remove a continuation byte from its sequence
+      } else if(byte < 0x80) {
+        damaged[index] = static_cast<char>(0x80); // Lone continuation byte
+      } else {
+        damaged[index] = 'x'; // Leaves continuation bytes without their lead byte
+      }
+      EXPECT_FALSE(Utf8Validator::IsValid(damaged)) << "Damage at index " << index;
+
+      // A sequence cut off at the end of the text is invalid, too
+      if(byte >= 0xC0) {
+        EXPECT_FALSE(Utf8Validator::IsValid(text.data(), index + 1));
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(Utf8ValidatorTest, CodePointsCanBeCounted) {
+    EXPECT_EQ(0U, Utf8Validator::CountCodePoints(std::string()));
+    EXPECT_EQ(11U, Utf8Validator::CountCodePoints(std::string(u8"Hello World")));
+    EXPECT_EQ(6U, Utf8Validator::CountCodePoints(std::string(u8"ä€𝒞ä€𝒞")));
+
+    // Long enough to go through the vectorized path several times
+    std::string text;
+    for(std::size_t index = 0; index < 1000; ++index) {
+      text.append(u8"aä€𝒞");
+    }
+    EXPECT_EQ(4000U, Utf8Validator::CountCodePoints(text));
+    EXPECT_TRUE(Utf8Validator::IsValid(text));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
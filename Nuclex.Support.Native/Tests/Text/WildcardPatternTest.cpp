@@ -0,0 +1,111 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/WildcardPattern.h"
+#include "Nuclex/Support/Text/StringMatcher.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardPatternTest, CanMatchAsciiStrings) {
+    EXPECT_TRUE(WildcardPattern("Hello World").Matches("Hello World"));
+    EXPECT_FALSE(WildcardPattern("").Matches("Hello World"));
+    EXPECT_TRUE(WildcardPattern("").Matches(""));
+    EXPECT_FALSE(WildcardPattern("Hello World").Matches(""));
+
+    EXPECT_TRUE(WildcardPattern("*").Matches(""));
+    EXPECT_TRUE(WildcardPattern("He*o World").Matches("Hello World"));
+    EXPECT_TRUE(WildcardPattern("Hell*o World").Matches("Hello World"));
+    EXPECT_TRUE(WildcardPattern("*").Matches("Hello World"));
+    EXPECT_FALSE(WildcardPattern("W*").Matches("Hello World"));
+    EXPECT_TRUE(WildcardPattern("*W*").Matches("Hello World"));
+    EXPECT_TRUE(WildcardPattern("Hello World*").Matches("Hello World"));
+    EXPECT_TRUE(WildcardPattern("*Hello World").Matches("Hello World"));
+    EXPECT_TRUE(WildcardPattern("Hello***World").Matches("Hello World"));
+
+    EXPECT_TRUE(WildcardPattern("Hell? W?rld").Matches("Hello World"));
+    EXPECT_FALSE(WildcardPattern("?Hello World").Matches("Hello World"));
+    EXPECT_FALSE(WildcardPattern("Hello World?").Matches("Hello World"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardPatternTest, CanMatchUtf8Strings) {
+    EXPECT_TRUE(WildcardPattern(u8"He*ø Wørld").Matches(u8"HELLØ WØRLD"));
+    EXPECT_FALSE(WildcardPattern(u8"ø*").Matches(u8"DLRØW ØLLEH"));
+    EXPECT_TRUE(WildcardPattern(u8"*ø*").Matches(u8"HELLØ WØRLD"));
+    EXPECT_TRUE(WildcardPattern(u8"Hellø***Wørld").Matches(u8"HELLØ WØRLD"));
+
+    // Question marks have to match whole code points, not single bytes
+    EXPECT_TRUE(WildcardPattern(u8"H?llø Wør?d").Matches(u8"HÆLLØ WØRLD"));
+    EXPECT_TRUE(WildcardPattern(u8"*W?rld").Matches(u8"HELLØ WØRLD"));
+    EXPECT_TRUE(WildcardPattern(u8"*?W?*").Matches(u8"HELLØ WØRLD"));
+    EXPECT_FALSE(WildcardPattern(u8"Hell?Wørld").Matches(u8"HELLØ WØRLD"));
+    EXPECT_FALSE(WildcardPattern(u8"Hellø Wørld?").Matches(u8"HELLØ WØRLD"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardPatternTest, CanBeCaseSensitive) {
+    WildcardPattern pattern(u8"*.Png", true);
+    EXPECT_TRUE(pattern.IsCaseSensitive());
+    EXPECT_TRUE(pattern.Matches(u8"Ünicøde.Png"));
+    EXPECT_FALSE(pattern.Matches(u8"Ünicøde.png"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardPatternTest, AnchoredEndsMustNotOverlap) {
+    EXPECT_FALSE(WildcardPattern("ab*ba").Matches("aba"));
+    EXPECT_TRUE(WildcardPattern("ab*ba").Matches("abba"));
+    EXPECT_FALSE(WildcardPattern("a?*?a").Matches("aaa"));
+    EXPECT_TRUE(WildcardPattern("a?*?a").Matches("aaaa"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardPatternTest, MatchesLikeStringMatcher) {
+    const char *wildcards[] = {
+      u8"*", u8"*.txt", u8"read*.md", u8"?*?", u8"*a*b*c*", u8"*ab?c*", u8"a*a*a",
+      u8"Ü*", u8"*ö?", u8"??", u8"*?ü?*"
+    };
+    const char *texts[] = {
+      u8"", u8"a", u8"aa", u8"aaa", u8"readme.md", u8"README.MD", u8"notes.txt",
+      u8"abc", u8"xaybzc", u8"abxc", u8"abbc", u8"Über", u8"üö", u8"Größe", u8"xüyz"
+    };
+
+    for(const char *wildcard : wildcards) {
+      WildcardPattern pattern(wildcard);
+      for(const char *text : texts) {
+        EXPECT_EQ(pattern.Matches(text), StringMatcher::FitsWildcard(text, wildcard)) <<
+          "Wildcard '" << wildcard << "' on text '" << text << "'";
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
@@ -0,0 +1,86 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Text/WildcardSet.h"
+
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Support { namespace Text {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardSetTest, EmptySetMatchesNothing) {
+    WildcardSet set;
+    EXPECT_EQ(set.CountWildcards(), 0U);
+    EXPECT_FALSE(set.MatchesAny(u8"Hello World"));
+    EXPECT_EQ(set.FindFirstMatch(u8""), WildcardSet::NoMatch);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardSetTest, FindsFirstMatchingWildcard) {
+    WildcardSet set;
+    EXPECT_EQ(set.Add(u8"*.png"), 0U);
+    EXPECT_EQ(set.Add(u8"screenshot*"), 1U);
+    EXPECT_EQ(set.Add(u8"*"), 2U);
+    EXPECT_EQ(set.CountWildcards(), 3U);
+
+    EXPECT_EQ(set.FindFirstMatch(u8"Screenshot.PNG"), 0U);
+    EXPECT_EQ(set.FindFirstMatch(u8"Screenshot.jpg"), 1U);
+    EXPECT_EQ(set.FindFirstMatch(u8"Ünicøde.txt"), 2U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardSetTest, CanFindAllMatchingWildcards) {
+    WildcardSet set;
+    set.Add(u8"*.txt");
+    set.Add(u8"*.png");
+    set.Add(u8"Ünicøde*");
+    set.Add(u8"?nicøde.???");
+
+    std::vector<std::size_t> matchIndices;
+    EXPECT_EQ(set.FindAllMatches(u8"ÜNICØDE.TXT", matchIndices), 3U);
+    ASSERT_EQ(matchIndices.size(), 3U);
+    EXPECT_EQ(matchIndices[0], 0U);
+    EXPECT_EQ(matchIndices[1], 2U);
+    EXPECT_EQ(matchIndices[2], 3U);
+
+    EXPECT_EQ(set.FindAllMatches(u8"readme.md", matchIndices), 0U);
+    EXPECT_EQ(matchIndices.size(), 3U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(WildcardSetTest, CanBeCaseSensitive) {
+    WildcardSet set(true);
+    set.Add(u8"*.txt");
+    set.Add(u8"*.TXT");
+
+    EXPECT_EQ(set.FindFirstMatch(u8"README.TXT"), 1U);
+    EXPECT_FALSE(set.MatchesAny(u8"README.Txt"));
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Text
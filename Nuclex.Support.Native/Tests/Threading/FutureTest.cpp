@@ -0,0 +1,146 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Threading/Future.h"
+#include <gtest/gtest.h>
+
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::runtime_error
+#include <string> // for std::string
+#include <thread> // for std::thread
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FutureTest, ResultCanBeProvidedBeforeOrAfterWaiting) {
+    Promise<int> early;
+    Future<int> earlyFuture = early.GetFuture();
+    EXPECT_FALSE(earlyFuture.IsReady());
+    early.SetValue(12);
+    EXPECT_TRUE(earlyFuture.IsReady());
+    EXPECT_EQ(earlyFuture.Get(), 12);
+    EXPECT_FALSE(earlyFuture.IsValid());
+
+    Promise<std::string> late;
+    Future<std::string> lateFuture = late.GetFuture();
+    std::thread provider(
+      [&late]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        late.SetValue(u8"Hello");
+      }
+    );
+    EXPECT_EQ(lateFuture.Get(), u8"Hello");
+    provider.join();
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FutureTest, ExceptionsAreRethrown) {
+    Promise<void> promise;
+    Future<void> future = promise.GetFuture();
+    promise.SetException(std::make_exception_ptr(std::runtime_error(u8"Test error")));
+    EXPECT_THROW(future.Get(), std::runtime_error);
+
+    Future<int> abandoned;
+    {
+      Promise<int> broken;
+      abandoned = broken.GetFuture();
+    }
+    EXPECT_THROW(abandoned.Get(), std::future_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FutureTest, ContinuationsCanBeChained) {
+    Promise<int> promise;
+    Future<std::string> chained = promise.GetFuture()
+      .Then([](int value) { return value * 2; })
+      .Then([](int value) { return std::to_string(value); });
+    EXPECT_FALSE(chained.IsReady());
+
+    promise.SetValue(21);
+    ASSERT_TRUE(chained.IsReady());
+    EXPECT_EQ(chained.Get(), u8"42");
+
+    // Continuations added after the result is there run right away
+    Promise<void> completed;
+    completed.SetValue();
+    bool hasRun = false;
+    Future<void> next = completed.GetFuture().Then([&hasRun]() { hasRun = true; });
+    EXPECT_TRUE(hasRun);
+    EXPECT_NO_THROW(next.Get());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FutureTest, ExceptionsSkipContinuations) {
+    Promise<int> promise;
+    bool hasRun = false;
+    Future<int> chained = promise.GetFuture()
+      .Then([](int) -> int { throw std::runtime_error(u8"Test error"); })
+      .Then([&hasRun](int value) { hasRun = true; return value; });
+
+    promise.SetValue(1);
+    EXPECT_THROW(chained.Get(), std::runtime_error);
+    EXPECT_FALSE(hasRun);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FutureTest, CallbackReceivesCompletedFuture) {
+    Promise<std::unique_ptr<int>> promise;
+    std::unique_ptr<int> received;
+    promise.GetFuture().OnCompleted(
+      [&received](Future<std::unique_ptr<int>> &&completed) { received = completed.Get(); }
+    );
+    EXPECT_EQ(received.get(), nullptr);
+
+    promise.SetValue(std::unique_ptr<int>(new int(123)));
+    ASSERT_NE(received.get(), nullptr);
+    EXPECT_EQ(*received, 123);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(FutureTest, ContinuationsCanRunOnThreadPool) {
+    ThreadPool threadPool(4);
+
+    Promise<int> promise;
+    std::thread::id continuationThread;
+    Future<int> chained = promise.GetFuture().Then(
+      threadPool, [&continuationThread](int value) {
+        continuationThread = std::this_thread::get_id();
+        return value + 1;
+      }
+    );
+
+    promise.SetValue(1);
+    chained.Wait(threadPool);
+    EXPECT_EQ(chained.Get(), 2);
+    EXPECT_NE(continuationThread, std::thread::id());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
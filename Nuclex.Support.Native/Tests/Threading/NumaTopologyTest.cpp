@@ -0,0 +1,60 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Threading/NumaTopology.h"
+#include <gtest/gtest.h>
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(NumaTopologyTest, TopologyIsDetectedOnce) {
+    const NumaTopology &topology = NumaTopology::Get();
+    EXPECT_EQ(&topology, &NumaTopology::Get());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(NumaTopologyTest, EveryNodeHasCores) {
+    const NumaTopology &topology = NumaTopology::Get();
+    ASSERT_GE(topology.CountNodes(), 1U);
+
+    for(std::size_t nodeIndex = 0; nodeIndex < topology.CountNodes(); ++nodeIndex) {
+      const NumaNode &node = topology.Nodes[nodeIndex];
+      ASSERT_FALSE(node.Cores.empty());
+      for(std::size_t index = 0; index < node.Cores.size(); ++index) {
+        EXPECT_EQ(topology.GetNodeIndexOfCore(node.Cores[index]), nodeIndex);
+      }
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(NumaTopologyTest, CurrentNodeIsValid) {
+    const NumaTopology &topology = NumaTopology::Get();
+    EXPECT_LT(topology.GetCurrentNodeIndex(), topology.CountNodes());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
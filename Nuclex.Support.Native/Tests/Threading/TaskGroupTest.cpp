@@ -0,0 +1,113 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Threading/TaskGroup.h"
+#include <gtest/gtest.h>
+
+#include <atomic> // for std::atomic
+#include <stdexcept> // for std::runtime_error
+#include <thread> // for std::thread
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TaskGroupTest, WaitReturnsAfterAllTasksFinished) {
+    ThreadPool threadPool(4);
+    TaskGroup group(threadPool);
+
+    std::atomic<std::size_t> count(0);
+    for(std::size_t index = 0; index < 100; ++index) {
+      group.Run([&count]() { count.fetch_add(1); });
+    }
+    group.Wait();
+
+    EXPECT_EQ(count.load(), 100U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TaskGroupTest, WaitRethrowsFirstException) {
+    ThreadPool threadPool(2);
+    TaskGroup group(threadPool);
+
+    group.Run([]() { throw std::runtime_error(u8"Test error"); });
+    EXPECT_THROW(group.Wait(), std::runtime_error);
+
+    // The exception has been reported, the group can be reused
+    group.Run([]() {});
+    EXPECT_NO_THROW(group.Wait());
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TaskGroupTest, TasksCanSpawnNestedGroups) {
+    ThreadPool threadPool(2);
+
+    std::atomic<std::size_t> count(0);
+    {
+      TaskGroup outer(threadPool);
+      for(std::size_t index = 0; index < 4; ++index) {
+        outer.Run(
+          [&threadPool, &count]() {
+            TaskGroup inner(threadPool);
+            for(std::size_t innerIndex = 0; innerIndex < 4; ++innerIndex) {
+              inner.Run([&count]() { count.fetch_add(1); });
+            }
+            inner.Wait();
+          }
+        );
+      }
+      outer.Wait();
+    }
+
+    EXPECT_EQ(count.load(), 16U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TaskGroupTest, GroupsCanBeUsedFromSeveralThreads) {
+    ThreadPool threadPool(3);
+
+    std::atomic<std::size_t> count(0);
+    auto submitter = [&threadPool, &count]() {
+      for(std::size_t repetition = 0; repetition < 20; ++repetition) {
+        TaskGroup group(threadPool);
+        for(std::size_t index = 0; index < 10; ++index) {
+          group.Run([&count]() { count.fetch_add(1); });
+        }
+        group.Wait();
+      }
+    };
+
+    std::thread first(submitter);
+    std::thread second(submitter);
+    first.join();
+    second.join();
+
+    EXPECT_EQ(count.load(), 400U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
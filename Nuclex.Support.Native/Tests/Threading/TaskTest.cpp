@@ -0,0 +1,148 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Threading/Task.h"
+#include <gtest/gtest.h>
+
+#include <atomic> // for std::atomic
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace {
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+  /// <summary>Coroutine that adds up the results of two tasks</summary>
+  /// <param name="threadPool">Thread pool the tasks will run on</param>
+  /// <returns>A task that provides the sum</returns>
+  Nuclex::Support::Threading::Task<int> addOnThreadPool(
+    Nuclex::Support::Threading::ThreadPool &threadPool
+  ) {
+    int first = co_await threadPool.Schedule([]() { return 20; });
+    int second = co_await threadPool.Schedule([]() { return 22; });
+    co_return first + second;
+  }
+
+  /// <summary>Coroutine that fails after awaiting a task</summary>
+  /// <param name="threadPool">Thread pool the task will run on</param>
+  /// <returns>A task that provides the exception</returns>
+  Nuclex::Support::Threading::Task<void> failOnThreadPool(
+    Nuclex::Support::Threading::ThreadPool &threadPool
+  ) {
+    co_await threadPool.Schedule([]() {});
+    throw std::runtime_error(u8"Test error");
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+} // anonymous namespace
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TaskTest, ScheduledFunctionsProvideResults) {
+    ThreadPool threadPool(4);
+
+    std::vector<Task<std::size_t>> tasks;
+    for(std::size_t index = 0; index < 100; ++index) {
+      tasks.push_back(threadPool.Schedule([index]() { return index * 2; }));
+    }
+
+    std::size_t sum = 0;
+    for(std::size_t index = 0; index < tasks.size(); ++index) {
+      tasks[index].Wait(threadPool);
+      sum += tasks[index].Get();
+    }
+    EXPECT_EQ(sum, 9900U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TaskTest, ExceptionsReachTheWaitingThread) {
+    ThreadPool threadPool(2);
+
+    Task<void> task = threadPool.Schedule([]() { throw std::runtime_error(u8"Test error"); });
+    EXPECT_THROW(task.Get(), std::runtime_error);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TaskTest, TasksCanWaitForNestedTasks) {
+    ThreadPool threadPool(2);
+
+    // More outer tasks than threads, each waiting for tasks of its own
+    std::vector<Task<int>> tasks;
+    for(std::size_t index = 0; index < 8; ++index) {
+      tasks.push_back(
+        threadPool.Schedule(
+          [&threadPool]() {
+            Task<int> inner = threadPool.Schedule([]() { return 1; });
+            inner.Wait(threadPool);
+            return inner.Get() + 1;
+          }
+        )
+      );
+    }
+
+    int sum = 0;
+    for(std::size_t index = 0; index < tasks.size(); ++index) {
+      tasks[index].Wait(threadPool);
+      sum += tasks[index].Get();
+    }
+    EXPECT_EQ(sum, 16);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(TaskTest, ContinuationsFollowScheduledFunctions) {
+    ThreadPool threadPool(4);
+
+    std::atomic<int> counter(0);
+    Future<int> chained = threadPool.Schedule([&counter]() { return ++counter; })
+      .Then(threadPool, [&counter](int value) { return value + (++counter); });
+    chained.Wait(threadPool);
+    EXPECT_EQ(chained.Get(), 3);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+#if defined(NUCLEX_SUPPORT_HAVE_COROUTINES)
+  TEST(TaskTest, CoroutinesCanAwaitTasks) {
+    ThreadPool threadPool(4);
+
+    Task<int> sum = addOnThreadPool(threadPool);
+    sum.Wait(threadPool);
+    EXPECT_EQ(sum.Get(), 42);
+
+    Task<void> failure = failOnThreadPool(threadPool);
+    failure.Wait(threadPool);
+    EXPECT_THROW(failure.Get(), std::runtime_error);
+  }
+#endif
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
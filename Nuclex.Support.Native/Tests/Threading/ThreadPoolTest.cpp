@@ -0,0 +1,149 @@
+#pragma region CPL License
+/*
+Nuclex Native Framework
+Copyright (C) 2002-2019 Nuclex Development Labs
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the IBM Common Public License as
+published by the IBM Corporation; either version 1.0 of the
+License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+IBM Common Public License for more details.
+
+You should have received a copy of the IBM Common Public
+License along with this library
+*/
+#pragma endregion // CPL License
+
+// If the library is compiled as a DLL, this ensures symbols are exported
+#define NUCLEX_SUPPORT_SOURCE 1
+
+#include "Nuclex/Support/Threading/ThreadPool.h"
+#include "Nuclex/Support/Threading/NumaTopology.h"
+#include <gtest/gtest.h>
+
+#include <atomic> // for std::atomic
+#include <stdexcept> // for std::runtime_error
+#include <vector> // for std::vector
+
+namespace Nuclex { namespace Support { namespace Threading {
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, InstancesCanBeCreated) {
+    EXPECT_NO_THROW(
+      ThreadPool test(4);
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ThreadCountIncludesWaitingThread) {
+    ThreadPool test(3);
+    EXPECT_EQ(test.CountThreads(), 3U);
+
+    ThreadPool automatic;
+    EXPECT_GE(automatic.CountThreads(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ForEachProcessesEveryIndexOnce) {
+    ThreadPool test(4);
+
+    std::vector<std::atomic<int>> counters(1000);
+    for(std::size_t index = 0; index < counters.size(); ++index) {
+      counters[index].store(0);
+    }
+
+    test.ForEach(
+      counters.size(),
+      [&counters](std::size_t index) { counters[index].fetch_add(1); },
+      7
+    );
+
+    for(std::size_t index = 0; index < counters.size(); ++index) {
+      EXPECT_EQ(counters[index].load(), 1);
+    }
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ForEachWorksWithSingleThread) {
+    ThreadPool test(1);
+
+    std::size_t sum = 0;
+    test.ForEach(100, [&sum](std::size_t index) { sum += index; });
+    EXPECT_EQ(sum, 4950U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ForEachRethrowsExceptions) {
+    ThreadPool test(4);
+
+    EXPECT_THROW(
+      test.ForEach(
+        1000,
+        [](std::size_t index) {
+          if(index == 500) {
+            throw std::runtime_error(u8"Test error");
+          }
+        }
+      ),
+      std::runtime_error
+    );
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ForEachCanBeNested) {
+    ThreadPool test(3);
+
+    std::atomic<std::size_t> count(0);
+    test.ForEach(
+      8,
+      [&test, &count](std::size_t) {
+        test.ForEach(8, [&count](std::size_t) { count.fetch_add(1); }, 1);
+      },
+      1
+    );
+
+    EXPECT_EQ(count.load(), 64U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ThreadsCanBePinnedToCores) {
+    ThreadPool test(2, true);
+
+    std::atomic<std::size_t> count(0);
+    test.ForEach(100, [&count](std::size_t) { count.fetch_add(1); });
+    EXPECT_EQ(count.load(), 100U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, ThreadsCanBePinnedToNumaNodes) {
+    ThreadPool test(4, ThreadPinning::NumaNodes);
+    EXPECT_GE(test.CountNumaNodes(), 1U);
+    EXPECT_LE(test.CountNumaNodes(), NumaTopology::Get().CountNodes());
+
+    std::atomic<std::size_t> count(0);
+    test.ForEach(100, [&count](std::size_t) { count.fetch_add(1); });
+    EXPECT_EQ(count.load(), 100U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(ThreadPoolTest, UnpinnedThreadPoolUsesSingleNode) {
+    ThreadPool test(4);
+    EXPECT_EQ(test.CountNumaNodes(), 1U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+}}} // namespace Nuclex::Support::Threading
@@ -463,4 +463,72 @@ namespace Nuclex { namespace Support {
 
   // ------------------------------------------------------------------------------------------- //
 
+  TEST(VariantTest, StoredValuesCanBeAccessedWithoutConversion) {
+    Variant test(std::int32_t(123));
+    ASSERT_NE(test.TryGet<std::int32_t>(), nullptr);
+    EXPECT_EQ(*test.TryGet<std::int32_t>(), 123);
+    EXPECT_EQ(test.TryGet<std::uint32_t>(), nullptr);
+    EXPECT_EQ(test.TryGet<std::string>(), nullptr);
+
+    test = std::string(u8"Hello");
+    ASSERT_NE(test.TryGet<std::string>(), nullptr);
+    EXPECT_EQ(*test.TryGet<std::string>(), u8"Hello");
+    EXPECT_EQ(test.TryGet<std::wstring>(), nullptr);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VariantTest, CanBeConvertedIntoExistingString) {
+    std::string target(u8"previous contents");
+
+    Variant(std::int16_t(-1234)).ToString(target);
+    EXPECT_EQ(target, u8"-1234");
+    Variant(true).ToString(target);
+    EXPECT_EQ(target, Variant(true).ToString());
+    Variant(1.5).ToString(target);
+    EXPECT_EQ(target, Variant(1.5).ToString());
+    Variant(std::wstring(L"W\u00e4rme")).ToString(target);
+    EXPECT_EQ(target, u8"W\u00e4rme");
+    Variant().ToString(target);
+    EXPECT_TRUE(target.empty());
+
+    std::wstring wideTarget(L"previous contents");
+    Variant(std::uint8_t(200)).ToWString(wideTarget);
+    EXPECT_EQ(wideTarget, Variant(std::uint8_t(200)).ToWString());
+    Variant(std::string(u8"W\u00e4rme")).ToWString(wideTarget);
+    EXPECT_EQ(wideTarget, L"W\u00e4rme");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VariantTest, CanBeConvertedIntoCharacterBuffer) {
+    char buffer[8];
+
+    std::size_t length = Variant(std::uint32_t(4096)).ToString(buffer, sizeof(buffer));
+    ASSERT_EQ(length, 4U);
+    EXPECT_EQ(std::string(buffer, length), u8"4096");
+
+    length = Variant(std::string(u8"Hello World")).ToString(buffer, sizeof(buffer));
+    EXPECT_EQ(length, 11U);
+    EXPECT_EQ(std::string(buffer, sizeof(buffer)), u8"Hello Wo");
+
+    EXPECT_EQ(Variant().ToString(buffer, sizeof(buffer)), 0U);
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
+  TEST(VariantTest, AssigningStringReusesExistingString) {
+    Variant test(std::string(64, 'x'));
+    const std::string *stored = test.TryGet<std::string>();
+    const char *storedCharacters = stored->c_str();
+
+    std::string shortText(u8"short");
+    test = shortText;
+    EXPECT_EQ(test.TryGet<std::string>(), stored);
+    EXPECT_EQ(stored->c_str(), storedCharacters);
+    EXPECT_EQ(test.ToString(), u8"short");
+  }
+
+  // ------------------------------------------------------------------------------------------- //
+
 }} // namespace Nuclex::Support